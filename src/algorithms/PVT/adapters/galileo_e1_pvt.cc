@@ -35,6 +35,7 @@
 #include <boost/math/common_factor_rt.hpp>
 #include <glog/logging.h>
 #include "configuration_interface.h"
+#include "track_file_writer.h"
 
 
 using google::LogMessage;
@@ -60,6 +61,8 @@ GalileoE1Pvt::GalileoE1Pvt(ConfigurationInterface* configuration,
     // moving average depth parameters
     int averaging_depth = configuration->property(role + ".averaging_depth", 10);
     bool flag_averaging = configuration->property(role + ".flag_averaging", false);
+    // average the ECEF coordinates instead of latitude, longitude and height
+    bool flag_averaging_ecef = configuration->property(role + ".flag_averaging_ecef", false);
 
     // output rate
     int output_rate_ms = configuration->property(role + ".output_rate_ms", 500);
@@ -88,12 +91,51 @@ GalileoE1Pvt::GalileoE1Pvt(ConfigurationInterface* configuration,
             rtcm_msg_rate_ms[k] = rtcm_MSM_rate_ms;
         }
 
+    // Positioning engine: Least Squares per epoch, or recursive Kalman filter
+    std::string positioning_engine = configuration->property(role + ".positioning_engine", std::string("Least_Squares"));
+    bool flag_kalman_filter = (positioning_engine.compare("Kalman") == 0);
+    if (!flag_kalman_filter && positioning_engine.compare("Least_Squares") != 0)
+        {
+            LOG(WARNING) << role << ".positioning_engine=" << positioning_engine << " is not valid, using Least_Squares";
+        }
+
+    // RAIM: fault detection and exclusion of the Least Squares fixes
+    bool flag_raim = configuration->property(role + ".raim", false);
+    double raim_pfa = configuration->property(role + ".raim_pfa", 1e-5);
+    double raim_sigma_m = configuration->property(role + ".raim_sigma_m", 5.0);
+    int raim_max_exclusions = configuration->property(role + ".raim_max_exclusions", 1);
+
+    // Output writer: the KML, GeoJSON, NMEA, RINEX and RTCM outputs are queued
+    // to a dedicated thread, so that a slow file or port does not stall the PVT
+    unsigned int output_queue_depth = configuration->property(role + ".output_queue_depth", 64);
+    std::string output_overflow_policy_name = configuration->property(role + ".output_overflow_policy", std::string("drop"));
+    Pvt_Output_Writer::Overflow_Policy output_overflow_policy = Pvt_Output_Writer::DROP;
+    if (!Pvt_Output_Writer::policy_from_name(output_overflow_policy_name, output_overflow_policy))
+        {
+            LOG(WARNING) << role << ".output_overflow_policy=" << output_overflow_policy_name << " is not valid, using drop";
+        }
+
+    // Output file rotation: none, hourly or daily, with optional gzip of the closed files
+    std::string rotation_period_name = configuration->property(role + ".rotation_period", std::string("none"));
+    Pvt_File_Rotation::Period rotation_period = Pvt_File_Rotation::NONE;
+    if (!Pvt_File_Rotation::period_from_name(rotation_period_name, rotation_period))
+        {
+            LOG(WARNING) << role << ".rotation_period=" << rotation_period_name << " is not valid, using none";
+        }
+    bool rotation_compress = configuration->property(role + ".rotation_compress", false);
+    // KML and GeoJSON tracks: time between writes of the buffered positions, 0 writes each one
+    double track_flush_interval_s = configuration->property(role + ".track_flush_interval_s", TRACK_FILE_FLUSH_INTERVAL_S);
+    // RTCM caster: 0 threads keeps the single-threaded server
+    unsigned int rtcm_caster_threads = configuration->property(role + ".rtcm_caster_threads", 0);
+    unsigned int rtcm_caster_queue_depth = configuration->property(role + ".rtcm_caster_queue_depth", 64);
+
     // make PVT object
     pvt_ = galileo_e1_make_pvt_cc(in_streams_,
             dump_,
             dump_filename_,
             averaging_depth,
             flag_averaging,
+            flag_averaging_ecef,
             output_rate_ms,
             display_rate_ms,
             flag_nmea_tty_port,
@@ -104,7 +146,19 @@ GalileoE1Pvt::GalileoE1Pvt(ConfigurationInterface* configuration,
             rtcm_tcp_port,
             rtcm_station_id,
             rtcm_msg_rate_ms,
-            rtcm_dump_devname);
+            rtcm_dump_devname,
+            flag_kalman_filter,
+            flag_raim,
+            raim_pfa,
+            raim_sigma_m,
+            raim_max_exclusions,
+            output_queue_depth,
+            output_overflow_policy,
+            rotation_period,
+            rotation_compress,
+            track_flush_interval_s,
+            rtcm_caster_threads,
+            rtcm_caster_queue_depth);
 
     DLOG(INFO) << "pvt(" << pvt_->unique_id() << ")";
 }
@@ -38,6 +38,7 @@
 #include <boost/math/common_factor_rt.hpp>
 #include <boost/serialization/map.hpp>
 #include "configuration_interface.h"
+#include "track_file_writer.h"
 
 
 using google::LogMessage;
@@ -62,6 +63,8 @@ HybridPvt::HybridPvt(ConfigurationInterface* configuration,
     // moving average depth parameters
     int averaging_depth = configuration->property(role + ".averaging_depth", 10);
     bool flag_averaging = configuration->property(role + ".flag_averaging", false);
+    // average the ECEF coordinates instead of latitude, longitude and height
+    bool flag_averaging_ecef = configuration->property(role + ".flag_averaging_ecef", false);
 
     // output rate
     int output_rate_ms = configuration->property(role + ".output_rate_ms", 500);
@@ -97,6 +100,9 @@ HybridPvt::HybridPvt(ConfigurationInterface* configuration,
         {
             rtcm_msg_rate_ms[k] = rtcm_MT1097_rate_ms;
         }
+    // Navigation solution feedback to the tracking loops
+    bool flag_vector_tracking = configuration->property(role + ".vector_tracking", false);
+
     // getting names from the config file, if available
     // default filename for assistance data
     const std::string eph_default_xml_filename = "./gps_ephemeris.xml";
@@ -110,8 +116,53 @@ HybridPvt::HybridPvt(ConfigurationInterface* configuration,
     //std::string ref_time_xml_filename = configuration_->property("GNSS-SDR.SUPL_gps_ref_time_xml", ref_time_default_xml_filename);
     //std::string ref_location_xml_filename = configuration_->property("GNSS-SDR.SUPL_gps_ref_location_xml", ref_location_default_xml_filename);    
     
+    // Positioning engine: Least Squares per epoch, or recursive Kalman filter
+    std::string positioning_engine = configuration->property(role + ".positioning_engine", std::string("Least_Squares"));
+    bool flag_kalman_filter = (positioning_engine.compare("Kalman") == 0);
+    if (!flag_kalman_filter && positioning_engine.compare("Least_Squares") != 0)
+        {
+            LOG(WARNING) << role << ".positioning_engine=" << positioning_engine << " is not valid, using Least_Squares";
+        }
+
+    // RAIM: fault detection and exclusion of the Least Squares fixes
+    bool flag_raim = configuration->property(role + ".raim", false);
+    double raim_pfa = configuration->property(role + ".raim_pfa", 1e-5);
+    double raim_sigma_m = configuration->property(role + ".raim_sigma_m", 5.0);
+    int raim_max_exclusions = configuration->property(role + ".raim_max_exclusions", 1);
+
+    // Batch solution: windows of epochs with a common clock, for post-processing runs. 0 epochs disables it
+    unsigned int batch_window_epochs = configuration->property(role + ".batch_window_epochs", 0);
+    unsigned int batch_threads = configuration->property(role + ".batch_threads", 1);
+    std::string batch_filename = configuration->property(role + ".batch_filename", std::string("./PVT_batch.dat"));
+
+    // Output writer: the KML, GeoJSON, NMEA, RINEX and RTCM outputs are queued
+    // to a dedicated thread, so that a slow file or port does not stall the PVT
+    unsigned int output_queue_depth = configuration->property(role + ".output_queue_depth", 64);
+    std::string output_overflow_policy_name = configuration->property(role + ".output_overflow_policy", std::string("drop"));
+    Pvt_Output_Writer::Overflow_Policy output_overflow_policy = Pvt_Output_Writer::DROP;
+    if (!Pvt_Output_Writer::policy_from_name(output_overflow_policy_name, output_overflow_policy))
+        {
+            LOG(WARNING) << role << ".output_overflow_policy=" << output_overflow_policy_name << " is not valid, using drop";
+        }
+
+    // Output file rotation: none, hourly or daily, with optional gzip of the closed files
+    std::string rotation_period_name = configuration->property(role + ".rotation_period", std::string("none"));
+    Pvt_File_Rotation::Period rotation_period = Pvt_File_Rotation::NONE;
+    if (!Pvt_File_Rotation::period_from_name(rotation_period_name, rotation_period))
+        {
+            LOG(WARNING) << role << ".rotation_period=" << rotation_period_name << " is not valid, using none";
+        }
+    bool rotation_compress = configuration->property(role + ".rotation_compress", false);
+    // KML and GeoJSON tracks: time between writes of the buffered positions, 0 writes each one
+    double track_flush_interval_s = configuration->property(role + ".track_flush_interval_s", TRACK_FILE_FLUSH_INTERVAL_S);
+    // RTCM caster: 0 threads keeps the single-threaded server
+    unsigned int rtcm_caster_threads = configuration->property(role + ".rtcm_caster_threads", 0);
+    unsigned int rtcm_caster_queue_depth = configuration->property(role + ".rtcm_caster_queue_depth", 64);
+    // Solver thread: the solution of the latest output epoch is computed out of the flowgraph
+    bool flag_solver_thread = configuration->property(role + ".solver_thread", true);
+
     // make PVT object
-    pvt_ = hybrid_make_pvt_cc(in_streams_, dump_, dump_filename_, averaging_depth, flag_averaging, output_rate_ms, display_rate_ms, flag_nmea_tty_port, nmea_dump_filename, nmea_dump_devname, flag_rtcm_server, flag_rtcm_tty_port, rtcm_tcp_port, rtcm_station_id, rtcm_msg_rate_ms, rtcm_dump_devname);
+    pvt_ = hybrid_make_pvt_cc(in_streams_, dump_, dump_filename_, averaging_depth, flag_averaging, flag_averaging_ecef, output_rate_ms, display_rate_ms, flag_nmea_tty_port, nmea_dump_filename, nmea_dump_devname, flag_rtcm_server, flag_rtcm_tty_port, rtcm_tcp_port, rtcm_station_id, rtcm_msg_rate_ms, rtcm_dump_devname, flag_vector_tracking, flag_kalman_filter, flag_raim, raim_pfa, raim_sigma_m, raim_max_exclusions, batch_window_epochs, batch_threads, batch_filename, output_queue_depth, output_overflow_policy, rotation_period, rotation_compress, track_flush_interval_s, rtcm_caster_threads, rtcm_caster_queue_depth, flag_solver_thread);
     DLOG(INFO) << "pvt(" << pvt_->unique_id() << ")";
 }
 
@@ -30,6 +30,7 @@
 
 #include "galileo_e1_pvt_cc.h"
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <boost/date_time/posix_time/posix_time.hpp>
@@ -38,66 +39,49 @@
 #include <gnuradio/io_signature.h>
 #include <glog/logging.h>
 #include "concurrent_map.h"
+#include "gnss_nav_data_store.h"
+#include "gnss_sdr_event_log.h"
+#include "gnss_sdr_parameters.h"
+#include "gnss_sdr_trace.h"
 
 using google::LogMessage;
 
 
 galileo_e1_pvt_cc_sptr galileo_e1_make_pvt_cc(unsigned int nchannels, bool dump, std::string dump_filename, int averaging_depth,
-        bool flag_averaging, int output_rate_ms, int display_rate_ms, bool flag_nmea_tty_port, std::string nmea_dump_filename,
+        bool flag_averaging, bool flag_averaging_ecef, int output_rate_ms, int display_rate_ms, bool flag_nmea_tty_port, std::string nmea_dump_filename,
         std::string nmea_dump_devname, bool flag_rtcm_server, bool flag_rtcm_tty_port, unsigned short rtcm_tcp_port,
-        unsigned short rtcm_station_id, std::map<int,int> rtcm_msg_rate_ms, std::string rtcm_dump_devname)
+        unsigned short rtcm_station_id, std::map<int,int> rtcm_msg_rate_ms, std::string rtcm_dump_devname,
+        bool flag_kalman_filter,
+        bool flag_raim,
+        double raim_pfa,
+        double raim_sigma_m,
+        int raim_max_exclusions,
+        unsigned int output_queue_depth,
+        Pvt_Output_Writer::Overflow_Policy output_overflow_policy,
+        Pvt_File_Rotation::Period rotation_period,
+        bool rotation_compress,
+        double track_flush_interval_s,
+        unsigned int rtcm_caster_threads,
+        unsigned int rtcm_caster_queue_depth)
 {
     return galileo_e1_pvt_cc_sptr(new galileo_e1_pvt_cc(nchannels, dump, dump_filename, averaging_depth,
-            flag_averaging, output_rate_ms, display_rate_ms, flag_nmea_tty_port, nmea_dump_filename, nmea_dump_devname,
-            flag_rtcm_server, flag_rtcm_tty_port, rtcm_tcp_port, rtcm_station_id, rtcm_msg_rate_ms, rtcm_dump_devname));
+            flag_averaging, flag_averaging_ecef, output_rate_ms, display_rate_ms, flag_nmea_tty_port, nmea_dump_filename, nmea_dump_devname,
+            flag_rtcm_server, flag_rtcm_tty_port, rtcm_tcp_port, rtcm_station_id, rtcm_msg_rate_ms, rtcm_dump_devname, flag_kalman_filter,
+            flag_raim, raim_pfa, raim_sigma_m, raim_max_exclusions,
+            output_queue_depth, output_overflow_policy, rotation_period, rotation_compress, track_flush_interval_s, rtcm_caster_threads, rtcm_caster_queue_depth));
 }
 
 
 void galileo_e1_pvt_cc::msg_handler_telemetry(pmt::pmt_t msg)
 {
+    GNSS_SDR_TRACE_SCOPE("galileo_e1_pvt_cc::msg_handler_telemetry");
+    // The telemetry decoders update Gnss_Nav_Data_Store directly, navigation
+    // data still received as a message (e.g., assistance data) is stored too
     try {
-            if( pmt::any_ref(msg).type() == typeid(std::shared_ptr<Galileo_Ephemeris>) )
-                {
-                    // ### Galileo EPHEMERIS ###
-                    std::shared_ptr<Galileo_Ephemeris> galileo_eph;
-                    galileo_eph = boost::any_cast<std::shared_ptr<Galileo_Ephemeris>>(pmt::any_ref(msg));
-                    // insert new ephemeris record
-                    DLOG(INFO) << "Galileo New Ephemeris record inserted in global map with TOW =" << galileo_eph->TOW_5
-                            << ", GALILEO Week Number =" << galileo_eph->WN_5
-                            << " and Ephemeris IOD = " << galileo_eph->IOD_ephemeris;
-                    // update/insert new ephemeris record to the global ephemeris map
-                    d_ls_pvt->galileo_ephemeris_map[galileo_eph->i_satellite_PRN] = *galileo_eph;
-                }
-            else if (pmt::any_ref(msg).type() == typeid(std::shared_ptr<Galileo_Iono>) )
-                {
-                    // ### Galileo IONO ###
-                    std::shared_ptr<Galileo_Iono> galileo_iono;
-                    galileo_iono = boost::any_cast<std::shared_ptr<Galileo_Iono>>(pmt::any_ref(msg));
-                    d_ls_pvt->galileo_iono = *galileo_iono;
-                    DLOG(INFO) << "New IONO record has arrived ";
-                }
-            else if (pmt::any_ref(msg).type() == typeid(std::shared_ptr<Galileo_Utc_Model>) )
-                {
-                    // ### Galileo UTC MODEL ###
-                    std::shared_ptr<Galileo_Utc_Model> galileo_utc_model;
-                    galileo_utc_model = boost::any_cast<std::shared_ptr<Galileo_Utc_Model>>(pmt::any_ref(msg));
-                    d_ls_pvt->galileo_utc_model = *galileo_utc_model;
-                    DLOG(INFO) << "New UTC record has arrived ";
-                }
-            else if (pmt::any_ref(msg).type() == typeid(std::shared_ptr<Galileo_Almanac>) )
-                {
-                    // ### Galileo Almanac ###
-                    std::shared_ptr<Galileo_Almanac> galileo_almanac;
-                    galileo_almanac = boost::any_cast<std::shared_ptr<Galileo_Almanac>>(pmt::any_ref(msg));
-                    // update/insert new ephemeris record to the global ephemeris map
-                    d_ls_pvt->galileo_almanac = *galileo_almanac;
-                    DLOG(INFO) << "New Galileo Almanac has arrived ";
-                }
-            else
+            if (!Gnss_Nav_Data_Store::instance().update(pmt::any_ref(msg)))
                 {
                     LOG(WARNING) << "msg_handler_telemetry unknown object type!";
                 }
-
     }
     catch(boost::bad_any_cast& e)
     {
@@ -106,10 +90,44 @@ void galileo_e1_pvt_cc::msg_handler_telemetry(pmt::pmt_t msg)
 }
 
 
+void galileo_e1_pvt_cc::msg_handler_parameters(pmt::pmt_t msg)
+{
+    GNSS_SDR_TRACE_SCOPE("galileo_e1_pvt_cc::msg_handler_parameters");
+    int output_rate_ms = d_output_rate_ms;
+    int display_rate_ms = d_display_rate_ms;
+    gnss_sdr_get_parameter(msg, "output_rate_ms", output_rate_ms);
+    gnss_sdr_get_parameter(msg, "display_rate_ms", display_rate_ms);
+    if (output_rate_ms <= 0 or display_rate_ms <= 0)
+        {
+            LOG(WARNING) << "PVT: the output and display rates must be positive";
+            return;
+        }
+    if (output_rate_ms != d_output_rate_ms or display_rate_ms != d_display_rate_ms)
+        {
+            d_output_rate_ms = output_rate_ms;
+            d_display_rate_ms = display_rate_ms;
+            LOG(INFO) << "PVT: output rate updated to " << d_output_rate_ms
+                      << " ms, display rate to " << d_display_rate_ms << " ms";
+        }
+}
+
+
 galileo_e1_pvt_cc::galileo_e1_pvt_cc(unsigned int nchannels, bool dump, std::string dump_filename, int averaging_depth,
-        bool flag_averaging, int output_rate_ms, int display_rate_ms, bool flag_nmea_tty_port, std::string nmea_dump_filename, std::string nmea_dump_devname,
+        bool flag_averaging, bool flag_averaging_ecef, int output_rate_ms, int display_rate_ms, bool flag_nmea_tty_port, std::string nmea_dump_filename, std::string nmea_dump_devname,
         bool flag_rtcm_server, bool flag_rtcm_tty_port, unsigned short rtcm_tcp_port,
-        unsigned short rtcm_station_id, std::map<int,int> rtcm_msg_rate_ms, std::string rtcm_dump_devname) :
+        unsigned short rtcm_station_id, std::map<int,int> rtcm_msg_rate_ms, std::string rtcm_dump_devname,
+        bool flag_kalman_filter,
+        bool flag_raim,
+        double raim_pfa,
+        double raim_sigma_m,
+        int raim_max_exclusions,
+        unsigned int output_queue_depth,
+        Pvt_Output_Writer::Overflow_Policy output_overflow_policy,
+        Pvt_File_Rotation::Period rotation_period,
+        bool rotation_compress,
+        double track_flush_interval_s,
+        unsigned int rtcm_caster_threads,
+        unsigned int rtcm_caster_queue_depth) :
     gr::block("galileo_e1_pvt_cc", gr::io_signature::make(nchannels, nchannels,  sizeof(Gnss_Synchro)), gr::io_signature::make(0, 0, sizeof(gr_complex)))
 {
     d_output_rate_ms = output_rate_ms;
@@ -122,17 +140,20 @@ galileo_e1_pvt_cc::galileo_e1_pvt_cc(unsigned int nchannels, bool dump, std::str
     // GPS Ephemeris data message port in
     this->message_port_register_in(pmt::mp("telemetry"));
     this->set_msg_handler(pmt::mp("telemetry"), boost::bind(&galileo_e1_pvt_cc::msg_handler_telemetry, this, _1));
+    // Output rates changed in the configuration file while running
+    this->message_port_register_in(pmt::mp("parameters"));
+    this->set_msg_handler(pmt::mp("parameters"), boost::bind(&galileo_e1_pvt_cc::msg_handler_parameters, this, _1));
 
     //initialize kml_printer
     std::string kml_dump_filename;
     kml_dump_filename = d_dump_filename;
-    d_kml_dump = std::make_shared<Kml_Printer>();
+    d_kml_dump = std::make_shared<Kml_Printer>(track_flush_interval_s);
     d_kml_dump->set_headers(kml_dump_filename);
 
     //initialize geojson_printer
     std::string geojson_dump_filename;
     geojson_dump_filename = d_dump_filename;
-    d_geojson_printer = std::make_shared<GeoJSON_Printer>();
+    d_geojson_printer = std::make_shared<GeoJSON_Printer>(track_flush_interval_s);
     d_geojson_printer->set_headers(geojson_dump_filename);
 
     //initialize nmea_printer
@@ -143,7 +164,7 @@ galileo_e1_pvt_cc::galileo_e1_pvt_cc(unsigned int nchannels, bool dump, std::str
     rtcm_dump_filename = d_dump_filename;
     unsigned short _port = rtcm_tcp_port;
     unsigned short _station_id = rtcm_station_id;
-    d_rtcm_printer = std::make_shared<Rtcm_Printer>(rtcm_dump_filename, flag_rtcm_server, flag_rtcm_tty_port, _port, _station_id, rtcm_dump_devname);
+    d_rtcm_printer = std::make_shared<Rtcm_Printer>(rtcm_dump_filename, flag_rtcm_server, flag_rtcm_tty_port, _port, _station_id, rtcm_dump_devname, true, rtcm_caster_threads, rtcm_caster_queue_depth);
     if(rtcm_msg_rate_ms.find(1045) != rtcm_msg_rate_ms.end())
         {
             d_rtcm_MT1045_rate_ms = rtcm_msg_rate_ms[1045];
@@ -169,6 +190,9 @@ galileo_e1_pvt_cc::galileo_e1_pvt_cc(unsigned int nchannels, bool dump, std::str
 
     d_ls_pvt = std::make_shared<galileo_e1_ls_pvt>(nchannels, dump_ls_pvt_filename, d_dump);
     d_ls_pvt->set_averaging_depth(d_averaging_depth);
+    d_ls_pvt->set_averaging_ecef(flag_averaging_ecef);
+    d_ls_pvt->set_kalman_filter(flag_kalman_filter);
+    d_ls_pvt->set_raim(flag_raim, raim_pfa, raim_sigma_m, raim_max_exclusions);
 
     d_sample_counter = 0;
     d_last_sample_nav_output = 0;
@@ -179,6 +203,11 @@ galileo_e1_pvt_cc::galileo_e1_pvt_cc(unsigned int nchannels, bool dump, std::str
 
     rp = std::make_shared<Rinex_Printer>();
 
+    d_output_writer = std::make_shared<Pvt_Output_Writer>(output_queue_depth, output_overflow_policy);
+    d_file_rotation = std::make_shared<Pvt_File_Rotation>(rotation_period, rotation_compress);
+    d_output_filename = dump_filename;
+    d_nmea_dump_filename = nmea_dump_filename;
+
     d_last_status_print_seg = 0;
 
     // ############# ENABLE DATA FILE LOG #################
@@ -203,7 +232,10 @@ galileo_e1_pvt_cc::galileo_e1_pvt_cc(unsigned int nchannels, bool dump, std::str
 
 
 galileo_e1_pvt_cc::~galileo_e1_pvt_cc()
-{}
+{
+    // write the queued epochs before the printers are destroyed
+    d_output_writer.reset();
+}
 
 
 
@@ -215,21 +247,141 @@ bool galileo_e1_pvt_cc::pseudoranges_pairCompare_min(const std::pair<int,Gnss_Sy
 
 void galileo_e1_pvt_cc::print_receiver_status(Gnss_Synchro** channels_synchronization_data)
 {
-    // Print the current receiver status using std::cout every second
+    // Print the current receiver status every second
     int current_rx_seg = floor(channels_synchronization_data[0][0].Tracking_timestamp_secs);
     if ( current_rx_seg != d_last_status_print_seg)
         {
             d_last_status_print_seg = current_rx_seg;
-            std::cout << "Current input signal time = " << current_rx_seg << " [s]" << std::endl << std::flush;
+            Gnss_Sdr_Event_Log::satellite_event(EVENT_RX_TIME, -1, 0, 0, current_rx_seg);
             //DLOG(INFO) << "GPS L1 C/A Tracking CH " << d_channel <<  ": Satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN)
             //          << ", CN0 = " << d_CN0_SNV_dB_Hz << " [dB-Hz]" << std::endl;
         }
 }
 
 
+void galileo_e1_pvt_cc::rotate_outputs()
+{
+    std::vector<std::string> closed = rp->rotate_files();
+    // the headers and navigation data go again into the new RINEX files
+    b_rinex_header_writen = false;
+    b_rinex_header_updated = false;
+    d_last_sample_nav_output = 0;
+
+    closed.push_back(d_kml_dump->get_filename());
+    d_kml_dump->close_file();
+    d_kml_dump->set_headers(d_output_filename);
+
+    closed.push_back(d_geojson_printer->get_filename());
+    d_geojson_printer->close_file();
+    d_geojson_printer->set_headers(d_output_filename);
+
+    closed.push_back(d_nmea_printer->get_filename());
+    d_nmea_printer->open_file(Pvt_File_Rotation::tagged_filename(d_nmea_dump_filename, time(nullptr)));
+
+    for (std::vector<std::string>::const_iterator it = closed.begin(); it != closed.end(); it++)
+        {
+            d_file_rotation->archive(*it);
+        }
+    LOG(INFO) << "PVT output files rotated";
+}
+
+
+void galileo_e1_pvt_cc::write_outputs(const std::shared_ptr<Output_Epoch>& epoch)
+{
+    if (d_file_rotation->due())
+        {
+            rotate_outputs();
+        }
+
+    // keep track of locking time
+    for (std::map<int,Gnss_Synchro>::iterator it = epoch->pseudoranges.begin(); it != epoch->pseudoranges.end(); it++)
+        {
+            std::map<int,Galileo_Ephemeris>::const_iterator tmp_eph_iter = epoch->nav->galileo_ephemeris_map.find(it->first);
+            if(tmp_eph_iter != epoch->nav->galileo_ephemeris_map.end())
+                {
+                    d_rtcm_printer->lock_time(tmp_eph_iter->second, epoch->rx_time, it->second);
+                }
+        }
+
+    d_kml_dump->print_position(epoch->solution, d_flag_averaging);
+    d_geojson_printer->print_position(epoch->solution, d_flag_averaging);
+    d_nmea_printer->Print_Nmea_Line(epoch->solution, d_flag_averaging);
+
+    if (!b_rinex_header_writen)
+        {
+            std::map<int,Galileo_Ephemeris>::const_iterator galileo_ephemeris_iter;
+            galileo_ephemeris_iter = epoch->nav->galileo_ephemeris_map.begin();
+            if (galileo_ephemeris_iter != epoch->nav->galileo_ephemeris_map.end())
+                {
+                    rp->rinex_obs_header(rp->obsFile, galileo_ephemeris_iter->second, epoch->rx_time);
+                    rp->rinex_nav_header(rp->navGalFile, epoch->nav->galileo_iono, epoch->nav->galileo_utc_model, epoch->nav->galileo_almanac);
+                    b_rinex_header_writen = true; // do not write header anymore
+                }
+        }
+    if(b_rinex_header_writen) // Put here another condition to separate annotations (e.g 30 s)
+        {
+            // Limit the RINEX navigation output rate to 1/6 seg
+            // Notice that the sample counter period is 4ms (for Galileo correlators)
+            if ((epoch->sample_counter - d_last_sample_nav_output) >= 6000)
+                {
+                    rp->log_rinex_nav(rp->navGalFile, epoch->nav->galileo_ephemeris_map);
+                    d_last_sample_nav_output = epoch->sample_counter;
+                }
+            std::map<int, Galileo_Ephemeris>::const_iterator galileo_ephemeris_iter;
+            galileo_ephemeris_iter = epoch->nav->galileo_ephemeris_map.begin();
+            if (galileo_ephemeris_iter != epoch->nav->galileo_ephemeris_map.end())
+                {
+                    rp->log_rinex_obs(rp->obsFile, galileo_ephemeris_iter->second, epoch->rx_time, epoch->pseudoranges);
+                }
+            if (!b_rinex_header_updated && (epoch->nav->galileo_utc_model.A0_6 != 0))
+                {
+                    rp->update_nav_header(rp->navGalFile, epoch->nav->galileo_iono, epoch->nav->galileo_utc_model, epoch->nav->galileo_almanac);
+                    rp->update_obs_header(rp->obsFile, epoch->nav->galileo_utc_model);
+                    b_rinex_header_updated = true;
+                }
+        }
+
+    if(b_rtcm_writing_started)
+        {
+            if((epoch->sample_counter % (d_rtcm_MT1045_rate_ms / 4) ) == 0)
+                {
+                    for(std::map<int,Galileo_Ephemeris>::const_iterator gal_ephemeris_iter = epoch->nav->galileo_ephemeris_map.begin(); gal_ephemeris_iter != epoch->nav->galileo_ephemeris_map.end(); gal_ephemeris_iter++ )
+                        {
+                            d_rtcm_printer->Print_Rtcm_MT1045(gal_ephemeris_iter->second);
+                        }
+                }
+            if((epoch->sample_counter % (d_rtcm_MSM_rate_ms / 4) ) == 0)
+                {
+                    std::map<int,Galileo_Ephemeris>::const_iterator gal_ephemeris_iter;
+                    gal_ephemeris_iter = epoch->nav->galileo_ephemeris_map.begin();
+                    if (gal_ephemeris_iter != epoch->nav->galileo_ephemeris_map.end())
+                        {
+                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_ephemeris_iter->second, epoch->rx_time, epoch->pseudoranges, 0, 0, 0, 0, 0);
+                        }
+                }
+        }
+    if(!b_rtcm_writing_started) // the first time
+        {
+            for(std::map<int,Galileo_Ephemeris>::const_iterator gal_ephemeris_iter = epoch->nav->galileo_ephemeris_map.begin(); gal_ephemeris_iter != epoch->nav->galileo_ephemeris_map.end(); gal_ephemeris_iter++ )
+                {
+                    d_rtcm_printer->Print_Rtcm_MT1045(gal_ephemeris_iter->second);
+                }
+
+            std::map<int,Galileo_Ephemeris>::const_iterator gal_ephemeris_iter = epoch->nav->galileo_ephemeris_map.begin();
+
+            if (gal_ephemeris_iter != epoch->nav->galileo_ephemeris_map.end())
+                {
+                    d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_ephemeris_iter->second, epoch->rx_time, epoch->pseudoranges, 0, 0, 0, 0, 0);
+                }
+            b_rtcm_writing_started = true;
+        }
+}
+
+
 int galileo_e1_pvt_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
         gr_vector_const_void_star &input_items, gr_vector_void_star &output_items  __attribute__((unused)))
 {
+    GNSS_SDR_TRACE_SCOPE("galileo_e1_pvt_cc::general_work");
     d_sample_counter++;
 
     std::map<int,Gnss_Synchro> gnss_pseudoranges_map;
@@ -245,19 +397,16 @@ int galileo_e1_pvt_cc::general_work (int noutput_items __attribute__((unused)),
                 {
                     gnss_pseudoranges_map.insert(std::pair<int,Gnss_Synchro>(in[i][0].PRN, in[i][0])); // store valid pseudoranges in a map
                     d_rx_time = in[i][0].d_TOW_at_current_symbol; // all the channels have the same RX timestamp (common RX time pseudoranges)
-                    if(d_ls_pvt->galileo_ephemeris_map.size() > 0)
-                        {
-                            std::map<int,Galileo_Ephemeris>::iterator tmp_eph_iter = d_ls_pvt->galileo_ephemeris_map.find(in[i][0].PRN);
-                            if(tmp_eph_iter != d_ls_pvt->galileo_ephemeris_map.end())
-                                {
-                                    d_rtcm_printer->lock_time(d_ls_pvt->galileo_ephemeris_map.find(in[i][0].PRN)->second, d_rx_time, in[i][0]); // keep track of locking time
-                                }
-                        }
                 }
         }
 
     // ############ 2 COMPUTE THE PVT ################################
-    if (gnss_pseudoranges_map.size() > 0 and d_ls_pvt->galileo_ephemeris_map.size() > 0)
+    // take the navigation data of this epoch, the output epochs share it without copying
+    if (d_ls_pvt->nav_data->version != Gnss_Nav_Data_Store::instance().version())
+        {
+            d_ls_pvt->nav_data = Gnss_Nav_Data_Store::instance().snapshot();
+        }
+    if (gnss_pseudoranges_map.size() > 0 and d_ls_pvt->nav_data->galileo_ephemeris_map.size() > 0)
         {
             // compute on the fly PVT solution
             if ((d_sample_counter % d_output_rate_ms) == 0)
@@ -267,96 +416,30 @@ int galileo_e1_pvt_cc::general_work (int noutput_items __attribute__((unused)),
 
                     if (pvt_result == true)
                         {
-                            d_kml_dump->print_position(d_ls_pvt, d_flag_averaging);
-                            d_geojson_printer->print_position(d_ls_pvt, d_flag_averaging);
-                            d_nmea_printer->Print_Nmea_Line(d_ls_pvt, d_flag_averaging);
-
-                            if (!b_rinex_header_writen)
-                                {
-                                    std::map<int,Galileo_Ephemeris>::iterator galileo_ephemeris_iter;
-                                    galileo_ephemeris_iter = d_ls_pvt->galileo_ephemeris_map.begin();
-                                    if (galileo_ephemeris_iter != d_ls_pvt->galileo_ephemeris_map.end())
-                                        {
-                                            rp->rinex_obs_header(rp->obsFile, galileo_ephemeris_iter->second, d_rx_time);
-                                            rp->rinex_nav_header(rp->navGalFile, d_ls_pvt->galileo_iono, d_ls_pvt->galileo_utc_model, d_ls_pvt->galileo_almanac);
-                                            b_rinex_header_writen = true; // do not write header anymore
-                                        }
-                                }
-                            if(b_rinex_header_writen) // Put here another condition to separate annotations (e.g 30 s)
-                                {
-                                    // Limit the RINEX navigation output rate to 1/6 seg
-                                    // Notice that d_sample_counter period is 4ms (for Galileo correlators)
-                                    if ((d_sample_counter - d_last_sample_nav_output) >= 6000)
-                                        {
-                                            rp->log_rinex_nav(rp->navGalFile, d_ls_pvt->galileo_ephemeris_map);
-                                            d_last_sample_nav_output = d_sample_counter;
-                                        }
-                                    std::map<int, Galileo_Ephemeris>::iterator galileo_ephemeris_iter;
-                                    galileo_ephemeris_iter = d_ls_pvt->galileo_ephemeris_map.begin();
-                                    if (galileo_ephemeris_iter != d_ls_pvt->galileo_ephemeris_map.end())
-                                        {
-                                            rp->log_rinex_obs(rp->obsFile, galileo_ephemeris_iter->second, d_rx_time, gnss_pseudoranges_map);
-                                        }
-                                    if (!b_rinex_header_updated && (d_ls_pvt->galileo_utc_model.A0_6 != 0))
-                                        {
-                                            rp->update_nav_header(rp->navGalFile, d_ls_pvt->galileo_iono, d_ls_pvt->galileo_utc_model, d_ls_pvt->galileo_almanac);
-                                            rp->update_obs_header(rp->obsFile, d_ls_pvt->galileo_utc_model);
-                                            b_rinex_header_updated = true;
-                                        }
-                                }
-
-                            if(b_rtcm_writing_started)
-                                {
-                                    if((d_sample_counter % (d_rtcm_MT1045_rate_ms / 4) ) == 0)
-                                        {
-                                            for(std::map<int,Galileo_Ephemeris>::iterator gal_ephemeris_iter = d_ls_pvt->galileo_ephemeris_map.begin(); gal_ephemeris_iter != d_ls_pvt->galileo_ephemeris_map.end(); gal_ephemeris_iter++ )
-                                                {
-                                                    d_rtcm_printer->Print_Rtcm_MT1045(gal_ephemeris_iter->second);
-                                                }
-                                        }
-                                    if((d_sample_counter % (d_rtcm_MSM_rate_ms / 4) ) == 0)
-                                        {
-                                            std::map<int,Galileo_Ephemeris>::iterator gal_ephemeris_iter;
-                                            gal_ephemeris_iter = d_ls_pvt->galileo_ephemeris_map.begin();
-                                            if (gal_ephemeris_iter != d_ls_pvt->galileo_ephemeris_map.end())
-                                                {
-                                                    d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_ephemeris_iter->second, d_rx_time, gnss_pseudoranges_map, 0, 0, 0, 0, 0);
-                                                }
-                                        }
-                                }
-                            if(!b_rtcm_writing_started) // the first time
+                            if (d_ls_pvt->b_valid_position)
                                 {
-                                    for(std::map<int,Galileo_Ephemeris>::iterator gal_ephemeris_iter = d_ls_pvt->galileo_ephemeris_map.begin(); gal_ephemeris_iter != d_ls_pvt->galileo_ephemeris_map.end(); gal_ephemeris_iter++ )
-                                        {
-                                            d_rtcm_printer->Print_Rtcm_MT1045(gal_ephemeris_iter->second);
-                                        }
-
-                                    std::map<int,Galileo_Ephemeris>::iterator gal_ephemeris_iter = d_ls_pvt->galileo_ephemeris_map.begin();
-
-                                    if (gal_ephemeris_iter != d_ls_pvt->galileo_ephemeris_map.end())
-                                        {
-                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_ephemeris_iter->second, d_rx_time, gnss_pseudoranges_map, 0, 0, 0, 0, 0);
-                                        }
-                                    b_rtcm_writing_started = true;
+                                    // for the predictions of the satellites in view
+                                    Gnss_Nav_Data_Store::instance().set_rx_position(d_ls_pvt->d_latitude_d,
+                                            d_ls_pvt->d_longitude_d, d_ls_pvt->d_height_m, true, d_rx_time);
                                 }
+                            // what the printers need, they run on the writer thread
+                            std::shared_ptr<Output_Epoch> epoch = std::make_shared<Output_Epoch>();
+                            epoch->solution = std::make_shared<Pvt_Solution>(*d_ls_pvt);
+                            epoch->pseudoranges = gnss_pseudoranges_map;
+                            epoch->nav = d_ls_pvt->nav_data;
+                            epoch->rx_time = d_rx_time;
+                            epoch->sample_counter = d_sample_counter;
+                            d_output_writer->push(std::bind(&galileo_e1_pvt_cc::write_outputs, this, epoch));
                         }
                 }
 
             // DEBUG MESSAGE: Display position in console output
             if (((d_sample_counter % d_display_rate_ms) == 0) and d_ls_pvt->b_valid_position == true)
                 {
-                    std::cout << "Galileo Position at " << boost::posix_time::to_simple_string(d_ls_pvt->d_position_UTC_time)
-                              << " UTC is Lat = " << d_ls_pvt->d_latitude_d << " [deg], Long = " << d_ls_pvt->d_longitude_d
-                              << " [deg], Height= " << d_ls_pvt->d_height_m << " [m]" << std::endl;
-
-                    LOG(INFO) << "Position at " << boost::posix_time::to_simple_string(d_ls_pvt->d_position_UTC_time)
-                              << " UTC is Lat = " << d_ls_pvt->d_latitude_d << " [deg], Long = " << d_ls_pvt->d_longitude_d
-                              << " [deg], Height= " << d_ls_pvt->d_height_m << " [m]";
-
-                    LOG(INFO) << "Dilution of Precision at " << boost::posix_time::to_simple_string(d_ls_pvt->d_position_UTC_time)
-                              << " is HDOP = " << d_ls_pvt->d_HDOP << " VDOP = "
-                              << d_ls_pvt->d_VDOP <<" TDOP = " << d_ls_pvt->d_TDOP
-                              << " GDOP = " << d_ls_pvt->d_GDOP;
+                    Gnss_Sdr_Event_Log::position(d_ls_pvt->d_position_UTC_time, 0, d_ls_pvt->d_latitude_d,
+                            d_ls_pvt->d_longitude_d, d_ls_pvt->d_height_m, 'E', EVENT_TO_CONSOLE | EVENT_TO_LOG);
+                    Gnss_Sdr_Event_Log::dop(d_ls_pvt->d_position_UTC_time, 0, d_ls_pvt->d_HDOP, d_ls_pvt->d_VDOP,
+                            d_ls_pvt->d_TDOP, d_ls_pvt->d_GDOP, EVENT_TO_LOG);
                 }
 
             // MULTIPLEXED FILE RECORDING - Record results to file
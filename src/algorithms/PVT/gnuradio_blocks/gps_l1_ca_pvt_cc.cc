@@ -29,6 +29,7 @@
 
 #include "gps_l1_ca_pvt_cc.h"
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <utility>
@@ -38,8 +39,13 @@
 #include <gnuradio/io_signature.h>
 #include <glog/logging.h>
 #include "concurrent_map.h"
+#include "gnss_nav_data_store.h"
+#include "gnss_sdr_event_log.h"
+#include "gnss_sdr_latency_tracer.h"
+#include "gnss_sdr_parameters.h"
 #include "sbas_telemetry_data.h"
 #include "sbas_ionospheric_correction.h"
+#include "gnss_sdr_trace.h"
 
 using google::LogMessage;
 
@@ -48,6 +54,7 @@ gps_l1_ca_make_pvt_cc(unsigned int nchannels,
         bool dump, std::string dump_filename,
         int averaging_depth,
         bool flag_averaging,
+        bool flag_averaging_ecef,
         int output_rate_ms,
         int display_rate_ms,
         bool flag_nmea_tty_port,
@@ -58,13 +65,26 @@ gps_l1_ca_make_pvt_cc(unsigned int nchannels,
         unsigned short rtcm_tcp_port,
         unsigned short rtcm_station_id,
         std::map<int,int> rtcm_msg_rate_ms,
-        std::string rtcm_dump_devname)
+        std::string rtcm_dump_devname,
+        bool flag_kalman_filter,
+        bool flag_raim,
+        double raim_pfa,
+        double raim_sigma_m,
+        int raim_max_exclusions,
+        unsigned int output_queue_depth,
+        Pvt_Output_Writer::Overflow_Policy output_overflow_policy,
+        Pvt_File_Rotation::Period rotation_period,
+        bool rotation_compress,
+        double track_flush_interval_s,
+        unsigned int rtcm_caster_threads,
+        unsigned int rtcm_caster_queue_depth)
 {
     return gps_l1_ca_pvt_cc_sptr(new gps_l1_ca_pvt_cc(nchannels,
             dump,
             dump_filename,
             averaging_depth,
             flag_averaging,
+            flag_averaging_ecef,
             output_rate_ms,
             display_rate_ms,
             flag_nmea_tty_port,
@@ -75,41 +95,31 @@ gps_l1_ca_make_pvt_cc(unsigned int nchannels,
             rtcm_tcp_port,
             rtcm_station_id,
             rtcm_msg_rate_ms,
-            rtcm_dump_devname));
+            rtcm_dump_devname,
+            flag_kalman_filter,
+            flag_raim,
+            raim_pfa,
+            raim_sigma_m,
+            raim_max_exclusions,
+            output_queue_depth,
+            output_overflow_policy,
+            rotation_period,
+            rotation_compress,
+            track_flush_interval_s,
+            rtcm_caster_threads,
+            rtcm_caster_queue_depth));
 }
 
 
 void gps_l1_ca_pvt_cc::msg_handler_telemetry(pmt::pmt_t msg)
 {
+    GNSS_SDR_TRACE_SCOPE("gps_l1_ca_pvt_cc::msg_handler_telemetry");
     try {
-            if( pmt::any_ref(msg).type() == typeid(std::shared_ptr<Gps_Ephemeris>) )
+            // The telemetry decoders update Gnss_Nav_Data_Store directly, navigation
+            // data still received as a message (e.g., assistance data) is stored too
+            if (Gnss_Nav_Data_Store::instance().update(pmt::any_ref(msg)))
                 {
-                    // ### GPS EPHEMERIS ###
-                    std::shared_ptr<Gps_Ephemeris> gps_eph;
-                    gps_eph = boost::any_cast<std::shared_ptr<Gps_Ephemeris>>(pmt::any_ref(msg));
-                    DLOG(INFO) << "Ephemeris record has arrived from SAT ID "
-                            << gps_eph->i_satellite_PRN << " (Block "
-                            <<  gps_eph->satelliteBlock[gps_eph->i_satellite_PRN] << ")"
-                            << "inserted with Toe="<< gps_eph->d_Toe<<" and GPS Week="
-                            << gps_eph->i_GPS_week;
-                    // update/insert new ephemeris record to the global ephemeris map
-                    d_ls_pvt->gps_ephemeris_map[gps_eph->i_satellite_PRN] = *gps_eph;
-                }
-            else if (pmt::any_ref(msg).type() == typeid(std::shared_ptr<Gps_Iono>) )
-                {
-                    // ### GPS IONO ###
-                    std::shared_ptr<Gps_Iono> gps_iono;
-                    gps_iono = boost::any_cast<std::shared_ptr<Gps_Iono>>(pmt::any_ref(msg));
-                    d_ls_pvt->gps_iono = *gps_iono;
-                    DLOG(INFO) << "New IONO record has arrived ";
-                }
-            else if (pmt::any_ref(msg).type() == typeid(std::shared_ptr<Gps_Utc_Model>) )
-                {
-                    // ### GPS UTC MODEL ###
-                    std::shared_ptr<Gps_Utc_Model> gps_utc_model;
-                    gps_utc_model = boost::any_cast<std::shared_ptr<Gps_Utc_Model>>(pmt::any_ref(msg));
-                    d_ls_pvt->gps_utc_model = *gps_utc_model;
-                    DLOG(INFO) << "New UTC record has arrived ";
+                    DLOG(INFO) << "New navigation data record has arrived";
                 }
             else if (pmt::any_ref(msg).type() == typeid(std::shared_ptr<Sbas_Ionosphere_Correction>) )
                 {
@@ -140,13 +150,14 @@ void gps_l1_ca_pvt_cc::msg_handler_telemetry(pmt::pmt_t msg)
                     // Define the RX time of the SBAS message by using the GPS time.
                     // It has only an effect if there has not been yet a SBAS MT12 available
                     // when the message was received.
+                    std::shared_ptr<const Gnss_Nav_Data> nav = Gnss_Nav_Data_Store::instance().snapshot();
                     if(sbas_raw_msg.get_rx_time_obj().is_related() == false
                             && gnss_pseudoranges_map.size() > 0
-                            && d_ls_pvt->gps_ephemeris_map.size() > 0)
+                            && nav->gps_ephemeris_map.size() > 0)
                         {
                             // doesn't matter which channel/satellite we choose
                             Gnss_Synchro gs = gnss_pseudoranges_map.begin()->second;
-                            Gps_Ephemeris eph = d_ls_pvt->gps_ephemeris_map.begin()->second;
+                            const Gps_Ephemeris & eph = nav->gps_ephemeris_map.begin()->second;
 
                             double relative_rx_time = gs.Tracking_timestamp_secs;
                             int gps_week = eph.i_GPS_week;
@@ -174,15 +185,38 @@ void gps_l1_ca_pvt_cc::msg_handler_telemetry(pmt::pmt_t msg)
 }
 
 
+void gps_l1_ca_pvt_cc::msg_handler_parameters(pmt::pmt_t msg)
+{
+    GNSS_SDR_TRACE_SCOPE("gps_l1_ca_pvt_cc::msg_handler_parameters");
+    int output_rate_ms = d_output_rate_ms;
+    int display_rate_ms = d_display_rate_ms;
+    gnss_sdr_get_parameter(msg, "output_rate_ms", output_rate_ms);
+    gnss_sdr_get_parameter(msg, "display_rate_ms", display_rate_ms);
+    if (output_rate_ms <= 0 or display_rate_ms <= 0)
+        {
+            LOG(WARNING) << "PVT: the output and display rates must be positive";
+            return;
+        }
+    if (output_rate_ms != d_output_rate_ms or display_rate_ms != d_display_rate_ms)
+        {
+            d_output_rate_ms = output_rate_ms;
+            d_display_rate_ms = display_rate_ms;
+            LOG(INFO) << "PVT: output rate updated to " << d_output_rate_ms
+                      << " ms, display rate to " << d_display_rate_ms << " ms";
+        }
+}
+
+
 std::map<int,Gps_Ephemeris> gps_l1_ca_pvt_cc::get_GPS_L1_ephemeris_map()
 {
-    return d_ls_pvt->gps_ephemeris_map;
+    return Gnss_Nav_Data_Store::instance().snapshot()->gps_ephemeris_map;
 }
 
 gps_l1_ca_pvt_cc::gps_l1_ca_pvt_cc(unsigned int nchannels,
         bool dump, std::string dump_filename,
         int averaging_depth,
         bool flag_averaging,
+        bool flag_averaging_ecef,
         int output_rate_ms,
         int display_rate_ms,
         bool flag_nmea_tty_port,
@@ -193,7 +227,19 @@ gps_l1_ca_pvt_cc::gps_l1_ca_pvt_cc(unsigned int nchannels,
         unsigned short rtcm_tcp_port,
         unsigned short rtcm_station_id,
         std::map<int,int> rtcm_msg_rate_ms,
-        std::string rtcm_dump_devname) :
+        std::string rtcm_dump_devname,
+        bool flag_kalman_filter,
+        bool flag_raim,
+        double raim_pfa,
+        double raim_sigma_m,
+        int raim_max_exclusions,
+        unsigned int output_queue_depth,
+        Pvt_Output_Writer::Overflow_Policy output_overflow_policy,
+        Pvt_File_Rotation::Period rotation_period,
+        bool rotation_compress,
+        double track_flush_interval_s,
+        unsigned int rtcm_caster_threads,
+        unsigned int rtcm_caster_queue_depth) :
              gr::block("gps_l1_ca_pvt_cc", gr::io_signature::make(nchannels, nchannels,  sizeof(Gnss_Synchro)),
              gr::io_signature::make(0, 0, sizeof(gr_complex)) )
 {
@@ -208,17 +254,20 @@ gps_l1_ca_pvt_cc::gps_l1_ca_pvt_cc(unsigned int nchannels,
     this->message_port_register_in(pmt::mp("telemetry"));
     this->set_msg_handler(pmt::mp("telemetry"),
             boost::bind(&gps_l1_ca_pvt_cc::msg_handler_telemetry, this, _1));
+    // Output rates changed in the configuration file while running
+    this->message_port_register_in(pmt::mp("parameters"));
+    this->set_msg_handler(pmt::mp("parameters"), boost::bind(&gps_l1_ca_pvt_cc::msg_handler_parameters, this, _1));
 
     //initialize kml_printer
     std::string kml_dump_filename;
     kml_dump_filename = d_dump_filename;
-    d_kml_printer = std::make_shared<Kml_Printer>();
+    d_kml_printer = std::make_shared<Kml_Printer>(track_flush_interval_s);
     d_kml_printer->set_headers(kml_dump_filename);
 
     //initialize geojson_printer
     std::string geojson_dump_filename;
     geojson_dump_filename = d_dump_filename;
-    d_geojson_printer = std::make_shared<GeoJSON_Printer>();
+    d_geojson_printer = std::make_shared<GeoJSON_Printer>(track_flush_interval_s);
     d_geojson_printer->set_headers(geojson_dump_filename);
 
     //initialize nmea_printer
@@ -229,7 +278,7 @@ gps_l1_ca_pvt_cc::gps_l1_ca_pvt_cc(unsigned int nchannels,
     rtcm_dump_filename = d_dump_filename;
     d_rtcm_tcp_port = rtcm_tcp_port;
     d_rtcm_station_id = rtcm_station_id;
-    d_rtcm_printer = std::make_shared<Rtcm_Printer>(rtcm_dump_filename, flag_rtcm_server, flag_rtcm_tty_port, d_rtcm_tcp_port, d_rtcm_station_id, rtcm_dump_devname);
+    d_rtcm_printer = std::make_shared<Rtcm_Printer>(rtcm_dump_filename, flag_rtcm_server, flag_rtcm_tty_port, d_rtcm_tcp_port, d_rtcm_station_id, rtcm_dump_devname, true, rtcm_caster_threads, rtcm_caster_queue_depth);
     if(rtcm_msg_rate_ms.find(1019) != rtcm_msg_rate_ms.end())
         {
             d_rtcm_MT1019_rate_ms = rtcm_msg_rate_ms[1019];
@@ -255,6 +304,9 @@ gps_l1_ca_pvt_cc::gps_l1_ca_pvt_cc(unsigned int nchannels,
 
     d_ls_pvt = std::make_shared<gps_l1_ca_ls_pvt>((int)nchannels, dump_ls_pvt_filename, d_dump);
     d_ls_pvt->set_averaging_depth(d_averaging_depth);
+    d_ls_pvt->set_averaging_ecef(flag_averaging_ecef);
+    d_ls_pvt->set_kalman_filter(flag_kalman_filter);
+    d_ls_pvt->set_raim(flag_raim, raim_pfa, raim_sigma_m, raim_max_exclusions);
 
     d_sample_counter = 0;
     d_last_sample_nav_output = 0;
@@ -267,6 +319,11 @@ gps_l1_ca_pvt_cc::gps_l1_ca_pvt_cc(unsigned int nchannels,
     b_rinex_sbs_header_writen = false;
     rp = std::make_shared<Rinex_Printer>();
 
+    d_output_writer = std::make_shared<Pvt_Output_Writer>(output_queue_depth, output_overflow_policy);
+    d_file_rotation = std::make_shared<Pvt_File_Rotation>(rotation_period, rotation_compress);
+    d_output_filename = dump_filename;
+    d_nmea_dump_filename = nmea_dump_filename;
+
     // ############# ENABLE DATA FILE LOG #################
     if (d_dump == true)
         {
@@ -288,7 +345,10 @@ gps_l1_ca_pvt_cc::gps_l1_ca_pvt_cc(unsigned int nchannels,
 
 
 gps_l1_ca_pvt_cc::~gps_l1_ca_pvt_cc()
-{}
+{
+    // write the queued epochs before the printers are destroyed
+    d_output_writer.reset();
+}
 
 
 bool pseudoranges_pairCompare_min(const std::pair<int,Gnss_Synchro>& a, const std::pair<int,Gnss_Synchro>& b)
@@ -299,21 +359,143 @@ bool pseudoranges_pairCompare_min(const std::pair<int,Gnss_Synchro>& a, const st
 
 void gps_l1_ca_pvt_cc::print_receiver_status(Gnss_Synchro** channels_synchronization_data)
 {
-    // Print the current receiver status using std::cout every second
+    // Print the current receiver status every second
     int current_rx_seg = floor(channels_synchronization_data[0][0].Tracking_timestamp_secs);
     if ( current_rx_seg!= d_last_status_print_seg)
         {
             d_last_status_print_seg = current_rx_seg;
-            std::cout << "Current input signal time = " << current_rx_seg << " [s]" << std::endl << std::flush;
+            Gnss_Sdr_Event_Log::satellite_event(EVENT_RX_TIME, -1, 0, 0, current_rx_seg);
             //DLOG(INFO) << "GPS L1 C/A Tracking CH " << d_channel <<  ": Satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN)
             //          << ", CN0 = " << d_CN0_SNV_dB_Hz << " [dB-Hz]" << std::endl;
         }
 }
 
 
+void gps_l1_ca_pvt_cc::rotate_outputs()
+{
+    std::vector<std::string> closed = rp->rotate_files();
+    // the headers and navigation data go again into the new RINEX files
+    b_rinex_header_writen = false;
+    b_rinex_header_updated = false;
+    d_last_sample_nav_output = 0;
+
+    closed.push_back(d_kml_printer->get_filename());
+    d_kml_printer->close_file();
+    d_kml_printer->set_headers(d_output_filename);
+
+    closed.push_back(d_geojson_printer->get_filename());
+    d_geojson_printer->close_file();
+    d_geojson_printer->set_headers(d_output_filename);
+
+    closed.push_back(d_nmea_printer->get_filename());
+    d_nmea_printer->open_file(Pvt_File_Rotation::tagged_filename(d_nmea_dump_filename, time(nullptr)));
+
+    for (std::vector<std::string>::const_iterator it = closed.begin(); it != closed.end(); it++)
+        {
+            d_file_rotation->archive(*it);
+        }
+    LOG(INFO) << "PVT output files rotated";
+}
+
+
+void gps_l1_ca_pvt_cc::write_outputs(const std::shared_ptr<Output_Epoch>& epoch)
+{
+    if (d_file_rotation->due())
+        {
+            rotate_outputs();
+        }
+
+    // keep track of locking time
+    for (std::map<int,Gnss_Synchro>::iterator it = epoch->pseudoranges.begin(); it != epoch->pseudoranges.end(); it++)
+        {
+            std::map<int,Gps_Ephemeris>::const_iterator tmp_eph_iter = epoch->nav->gps_ephemeris_map.find(it->first);
+            if(tmp_eph_iter != epoch->nav->gps_ephemeris_map.end())
+                {
+                    d_rtcm_printer->lock_time(tmp_eph_iter->second, epoch->rx_time, it->second);
+                }
+        }
+
+    d_kml_printer->print_position(epoch->solution, d_flag_averaging);
+    d_geojson_printer->print_position(epoch->solution, d_flag_averaging);
+    d_nmea_printer->Print_Nmea_Line(epoch->solution, d_flag_averaging);
+    Gnss_Sdr_Latency_Tracer::record("nmea", epoch->signal_time_s);
+
+    if (!b_rinex_header_writen)
+        {
+            std::map<int,Gps_Ephemeris>::const_iterator gps_ephemeris_iter;
+            gps_ephemeris_iter = epoch->nav->gps_ephemeris_map.begin();
+            if (gps_ephemeris_iter != epoch->nav->gps_ephemeris_map.end())
+                {
+                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, epoch->rx_time);
+                    rp->rinex_nav_header(rp->navFile, epoch->nav->gps_iono, epoch->nav->gps_utc_model);
+                    b_rinex_header_writen = true; // do not write header anymore
+                }
+        }
+    if(b_rinex_header_writen) // Put here another condition to separate annotations (e.g 30 s)
+        {
+            // Limit the RINEX navigation output rate to 1/6 seg
+            // Notice that the sample counter period is 1ms (for GPS correlators)
+            if ((epoch->sample_counter - d_last_sample_nav_output) >= 6000)
+                {
+                    rp->log_rinex_nav(rp->navFile, epoch->nav->gps_ephemeris_map);
+                    d_last_sample_nav_output = epoch->sample_counter;
+                }
+            std::map<int,Gps_Ephemeris>::const_iterator gps_ephemeris_iter;
+            gps_ephemeris_iter = epoch->nav->gps_ephemeris_map.begin();
+            if (gps_ephemeris_iter != epoch->nav->gps_ephemeris_map.end())
+                {
+                    rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, epoch->rx_time, epoch->pseudoranges);
+                }
+            if (!b_rinex_header_updated && (epoch->nav->gps_utc_model.d_A0 != 0))
+                {
+                    rp->update_obs_header(rp->obsFile, epoch->nav->gps_utc_model);
+                    rp->update_nav_header(rp->navFile, epoch->nav->gps_utc_model, epoch->nav->gps_iono);
+                    b_rinex_header_updated = true;
+                }
+        }
+    if(b_rtcm_writing_started)
+        {
+            if((epoch->sample_counter % d_rtcm_MT1019_rate_ms) == 0)
+                {
+                    for(std::map<int,Gps_Ephemeris>::const_iterator gps_ephemeris_iter = epoch->nav->gps_ephemeris_map.begin(); gps_ephemeris_iter != epoch->nav->gps_ephemeris_map.end(); gps_ephemeris_iter++ )
+                        {
+                            d_rtcm_printer->Print_Rtcm_MT1019(gps_ephemeris_iter->second);
+                        }
+                }
+            if((epoch->sample_counter % d_rtcm_MSM_rate_ms) == 0)
+                {
+                    std::map<int,Gps_Ephemeris>::const_iterator gps_ephemeris_iter;
+                    gps_ephemeris_iter = epoch->nav->gps_ephemeris_map.begin();
+                    if (gps_ephemeris_iter != epoch->nav->gps_ephemeris_map.end())
+                        {
+                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_ephemeris_iter->second, {}, {}, epoch->rx_time, epoch->pseudoranges, 0, 0, 0, 0, 0);
+                            Gnss_Sdr_Latency_Tracer::record("rtcm", epoch->signal_time_s);
+                        }
+                }
+        }
+
+    if(!b_rtcm_writing_started) // the first time
+        {
+            for(std::map<int,Gps_Ephemeris>::const_iterator gps_ephemeris_iter = epoch->nav->gps_ephemeris_map.begin(); gps_ephemeris_iter != epoch->nav->gps_ephemeris_map.end(); gps_ephemeris_iter++ )
+                {
+                    d_rtcm_printer->Print_Rtcm_MT1019(gps_ephemeris_iter->second);
+                }
+
+            std::map<int,Gps_Ephemeris>::const_iterator gps_ephemeris_iter = epoch->nav->gps_ephemeris_map.begin();
+
+            if (gps_ephemeris_iter != epoch->nav->gps_ephemeris_map.end())
+                {
+                    d_rtcm_printer->Print_Rtcm_MSM(7, gps_ephemeris_iter->second, {}, {}, epoch->rx_time, epoch->pseudoranges, 0, 0, 0, 0, 0);
+                }
+            b_rtcm_writing_started = true;
+        }
+}
+
+
 int gps_l1_ca_pvt_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
         gr_vector_const_void_star &input_items, gr_vector_void_star &output_items __attribute__((unused)))
 {
+    GNSS_SDR_TRACE_SCOPE("gps_l1_ca_pvt_cc::general_work");
     gnss_pseudoranges_map.clear();
     d_sample_counter++;
     Gnss_Synchro **in = (Gnss_Synchro **)  &input_items[0]; //Get the input pointer
@@ -327,19 +509,16 @@ int gps_l1_ca_pvt_cc::general_work (int noutput_items __attribute__((unused)), g
                 {
                     gnss_pseudoranges_map.insert(std::pair<int,Gnss_Synchro>(in[i][0].PRN, in[i][0])); // store valid pseudoranges in a map
                     d_rx_time = in[i][0].d_TOW_at_current_symbol; // all the channels have the same RX timestamp (common RX time pseudoranges)
-                    if(d_ls_pvt->gps_ephemeris_map.size() > 0)
-                        {
-                            std::map<int,Gps_Ephemeris>::iterator tmp_eph_iter = d_ls_pvt->gps_ephemeris_map.find(in[i][0].PRN);
-                            if(tmp_eph_iter != d_ls_pvt->gps_ephemeris_map.end())
-                                {
-                                    d_rtcm_printer->lock_time(d_ls_pvt->gps_ephemeris_map.find(in[i][0].PRN)->second, d_rx_time, in[i][0]); // keep track of locking time
-                                }
-                        }
                 }
         }
 
     // ############ 2 COMPUTE THE PVT ################################
-    if (gnss_pseudoranges_map.size() > 0 and d_ls_pvt->gps_ephemeris_map.size() > 0)
+    // take the navigation data of this epoch, the output epochs share it without copying
+    if (d_ls_pvt->nav_data->version != Gnss_Nav_Data_Store::instance().version())
+        {
+            d_ls_pvt->nav_data = Gnss_Nav_Data_Store::instance().snapshot();
+        }
+    if (gnss_pseudoranges_map.size() > 0 and d_ls_pvt->nav_data->gps_ephemeris_map.size() > 0)
         {
             // compute on the fly PVT solution
             //mod 8/4/2012 Set the PVT computation rate in this block
@@ -349,95 +528,36 @@ int gps_l1_ca_pvt_cc::general_work (int noutput_items __attribute__((unused)), g
                     pvt_result = d_ls_pvt->get_PVT(gnss_pseudoranges_map, d_rx_time, d_flag_averaging);
                     if (pvt_result == true)
                         {
-                            d_kml_printer->print_position(d_ls_pvt, d_flag_averaging);
-                            d_geojson_printer->print_position(d_ls_pvt, d_flag_averaging);
-                            d_nmea_printer->Print_Nmea_Line(d_ls_pvt, d_flag_averaging);
-
-                            if (!b_rinex_header_writen)
-                                {
-                                    std::map<int,Gps_Ephemeris>::iterator gps_ephemeris_iter;
-                                    gps_ephemeris_iter = d_ls_pvt->gps_ephemeris_map.begin();
-                                    if (gps_ephemeris_iter != d_ls_pvt->gps_ephemeris_map.end())
-                                        {
-                                            rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, d_rx_time);
-                                            rp->rinex_nav_header(rp->navFile, d_ls_pvt->gps_iono, d_ls_pvt->gps_utc_model);
-                                            b_rinex_header_writen = true; // do not write header anymore
-                                        }
-                                }
-                            if(b_rinex_header_writen) // Put here another condition to separate annotations (e.g 30 s)
+                            if (d_ls_pvt->b_valid_position)
                                 {
-                                    // Limit the RINEX navigation output rate to 1/6 seg
-                                    // Notice that d_sample_counter period is 1ms (for GPS correlators)
-                                    if ((d_sample_counter - d_last_sample_nav_output) >= 6000)
-                                        {
-                                            rp->log_rinex_nav(rp->navFile, d_ls_pvt->gps_ephemeris_map);
-                                            d_last_sample_nav_output = d_sample_counter;
-                                        }
-                                    std::map<int,Gps_Ephemeris>::iterator gps_ephemeris_iter;
-                                    gps_ephemeris_iter = d_ls_pvt->gps_ephemeris_map.begin();
-                                    if (gps_ephemeris_iter != d_ls_pvt->gps_ephemeris_map.end())
-                                        {
-                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, d_rx_time, gnss_pseudoranges_map);
-                                        }
-                                    if (!b_rinex_header_updated && (d_ls_pvt->gps_utc_model.d_A0 != 0))
-                                        {
-                                            rp->update_obs_header(rp->obsFile, d_ls_pvt->gps_utc_model);
-                                            rp->update_nav_header(rp->navFile, d_ls_pvt->gps_utc_model, d_ls_pvt->gps_iono);
-                                            b_rinex_header_updated = true;
-                                        }
+                                    // for the predictions of the satellites in view
+                                    Gnss_Nav_Data_Store::instance().set_rx_position(d_ls_pvt->d_latitude_d,
+                                            d_ls_pvt->d_longitude_d, d_ls_pvt->d_height_m, true, d_rx_time);
                                 }
-                            if(b_rtcm_writing_started)
+                            // what the printers need, they run on the writer thread
+                            std::shared_ptr<Output_Epoch> epoch = std::make_shared<Output_Epoch>();
+                            epoch->solution = std::make_shared<Pvt_Solution>(*d_ls_pvt);
+                            epoch->pseudoranges = gnss_pseudoranges_map;
+                            epoch->nav = d_ls_pvt->nav_data;
+                            epoch->rx_time = d_rx_time;
+                            epoch->sample_counter = d_sample_counter;
+                            epoch->signal_time_s = 0.0;
+                            for (std::map<int,Gnss_Synchro>::const_iterator it = gnss_pseudoranges_map.begin(); it != gnss_pseudoranges_map.end(); ++it)
                                 {
-                                    if((d_sample_counter % d_rtcm_MT1019_rate_ms) == 0)
-                                        {
-                                            for(std::map<int,Gps_Ephemeris>::iterator gps_ephemeris_iter = d_ls_pvt->gps_ephemeris_map.begin(); gps_ephemeris_iter != d_ls_pvt->gps_ephemeris_map.end(); gps_ephemeris_iter++ )
-                                                {
-                                                    d_rtcm_printer->Print_Rtcm_MT1019(gps_ephemeris_iter->second);
-                                                }
-                                        }
-                                    if((d_sample_counter % d_rtcm_MSM_rate_ms) == 0)
-                                        {
-                                            std::map<int,Gps_Ephemeris>::iterator gps_ephemeris_iter;
-                                            gps_ephemeris_iter = d_ls_pvt->gps_ephemeris_map.begin();
-                                            if (gps_ephemeris_iter != d_ls_pvt->gps_ephemeris_map.end())
-                                                {
-                                                    d_rtcm_printer->Print_Rtcm_MSM(7, gps_ephemeris_iter->second, {}, {}, d_rx_time, gnss_pseudoranges_map, 0, 0, 0, 0, 0);
-                                                }
-                                        }
-                                }
-
-                            if(!b_rtcm_writing_started) // the first time
-                                {
-                                    for(std::map<int,Gps_Ephemeris>::iterator gps_ephemeris_iter = d_ls_pvt->gps_ephemeris_map.begin(); gps_ephemeris_iter != d_ls_pvt->gps_ephemeris_map.end(); gps_ephemeris_iter++ )
-                                        {
-                                            d_rtcm_printer->Print_Rtcm_MT1019(gps_ephemeris_iter->second);
-                                        }
-
-                                    std::map<int,Gps_Ephemeris>::iterator gps_ephemeris_iter = d_ls_pvt->gps_ephemeris_map.begin();
-
-                                    if (gps_ephemeris_iter != d_ls_pvt->gps_ephemeris_map.end())
-                                        {
-                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_ephemeris_iter->second, {}, {}, d_rx_time, gnss_pseudoranges_map, 0, 0, 0, 0, 0);
-                                        }
-                                    b_rtcm_writing_started = true;
+                                    epoch->signal_time_s = std::max(epoch->signal_time_s, it->second.Tracking_timestamp_secs);
                                 }
+                            Gnss_Sdr_Latency_Tracer::record("pvt", epoch->signal_time_s);
+                            d_output_writer->push(std::bind(&gps_l1_ca_pvt_cc::write_outputs, this, epoch));
                         }
                 }
 
             // DEBUG MESSAGE: Display position in console output
             if (((d_sample_counter % d_display_rate_ms) == 0) and d_ls_pvt->b_valid_position == true)
                 {
-                    std::cout << "Position at " << boost::posix_time::to_simple_string(d_ls_pvt->d_position_UTC_time)
-                              << " UTC is Lat = " << d_ls_pvt->d_latitude_d << " [deg], Long = " << d_ls_pvt->d_longitude_d
-                              << " [deg], Height= " << d_ls_pvt->d_height_m << " [m]" << std::endl;
-
-                    LOG(INFO) << "Position at " << boost::posix_time::to_simple_string(d_ls_pvt->d_position_UTC_time)
-                              << " UTC is Lat = " << d_ls_pvt->d_latitude_d << " [deg], Long = " << d_ls_pvt->d_longitude_d
-                              << " [deg], Height= " << d_ls_pvt->d_height_m << " [m]";
-
-                    LOG(INFO) << "Dilution of Precision at " << boost::posix_time::to_simple_string(d_ls_pvt->d_position_UTC_time)
-                              << " is HDOP = " << d_ls_pvt->d_HDOP << " VDOP = "
-                              << d_ls_pvt->d_VDOP <<" TDOP = " << d_ls_pvt->d_TDOP << " GDOP = " << d_ls_pvt->d_GDOP;
+                    Gnss_Sdr_Event_Log::position(d_ls_pvt->d_position_UTC_time, 0, d_ls_pvt->d_latitude_d,
+                            d_ls_pvt->d_longitude_d, d_ls_pvt->d_height_m, 0, EVENT_TO_CONSOLE | EVENT_TO_LOG);
+                    Gnss_Sdr_Event_Log::dop(d_ls_pvt->d_position_UTC_time, 0, d_ls_pvt->d_HDOP, d_ls_pvt->d_VDOP,
+                            d_ls_pvt->d_TDOP, d_ls_pvt->d_GDOP, EVENT_TO_LOG);
                 }
             // MULTIPLEXED FILE RECORDING - Record results to file
             if(d_dump == true)
@@ -39,6 +39,8 @@
 #include "geojson_printer.h"
 #include "rtcm_printer.h"
 #include "gps_l1_ca_ls_pvt.h"
+#include "pvt_output_writer.h"
+#include "pvt_file_rotation.h"
 
 
 class gps_l1_ca_pvt_cc;
@@ -50,6 +52,7 @@ gps_l1_ca_pvt_cc_sptr gps_l1_ca_make_pvt_cc(unsigned int n_channels,
                                             std::string dump_filename,
                                             int averaging_depth,
                                             bool flag_averaging,
+                                            bool flag_averaging_ecef,
                                             int output_rate_ms,
                                             int display_rate_ms,
                                             bool flag_nmea_tty_port,
@@ -60,7 +63,19 @@ gps_l1_ca_pvt_cc_sptr gps_l1_ca_make_pvt_cc(unsigned int n_channels,
                                             unsigned short rtcm_tcp_port,
                                             unsigned short rtcm_station_id,
                                             std::map<int,int> rtcm_msg_rate_ms,
-                                            std::string rtcm_dump_devname
+                                            std::string rtcm_dump_devname,
+                                            bool flag_kalman_filter,
+                                            bool flag_raim,
+                                            double raim_pfa,
+                                            double raim_sigma_m,
+                                            int raim_max_exclusions,
+                                            unsigned int output_queue_depth,
+                                            Pvt_Output_Writer::Overflow_Policy output_overflow_policy,
+                                            Pvt_File_Rotation::Period rotation_period,
+                                            bool rotation_compress,
+                                            double track_flush_interval_s,
+                                            unsigned int rtcm_caster_threads,
+                                            unsigned int rtcm_caster_queue_depth
 );
 
 /*!
@@ -74,6 +89,7 @@ private:
                                                        std::string dump_filename,
                                                        int averaging_depth,
                                                        bool flag_averaging,
+                                                       bool flag_averaging_ecef,
                                                        int output_rate_ms,
                                                        int display_rate_ms,
                                                        bool flag_nmea_tty_port,
@@ -84,12 +100,25 @@ private:
                                                        unsigned short rtcm_tcp_port,
                                                        unsigned short rtcm_station_id,
                                                        std::map<int,int> rtcm_msg_rate_ms,
-                                                       std::string rtcm_dump_devname);
+                                                       std::string rtcm_dump_devname,
+                                                       bool flag_kalman_filter,
+                                                       bool flag_raim,
+                                                       double raim_pfa,
+                                                       double raim_sigma_m,
+                                                       int raim_max_exclusions,
+                                                       unsigned int output_queue_depth,
+                                                       Pvt_Output_Writer::Overflow_Policy output_overflow_policy,
+                                                       Pvt_File_Rotation::Period rotation_period,
+                                                       bool rotation_compress,
+                                                       double track_flush_interval_s,
+                                                       unsigned int rtcm_caster_threads,
+                                                       unsigned int rtcm_caster_queue_depth);
     gps_l1_ca_pvt_cc(unsigned int nchannels,
                      bool dump,
                      std::string dump_filename,
                      int averaging_depth,
                      bool flag_averaging,
+                     bool flag_averaging_ecef,
                      int output_rate_ms,
                      int display_rate_ms,
                      bool flag_nmea_tty_port,
@@ -100,9 +129,22 @@ private:
                      unsigned short rtcm_tcp_port,
                      unsigned short rtcm_station_id,
                      std::map<int,int> rtcm_msg_rate_ms,
-                     std::string rtcm_dump_devname);
+                     std::string rtcm_dump_devname,
+                     bool flag_kalman_filter,
+                     bool flag_raim,
+                     double raim_pfa,
+                     double raim_sigma_m,
+                     int raim_max_exclusions,
+                     unsigned int output_queue_depth,
+                     Pvt_Output_Writer::Overflow_Policy output_overflow_policy,
+                     Pvt_File_Rotation::Period rotation_period,
+                     bool rotation_compress,
+                     double track_flush_interval_s,
+                     unsigned int rtcm_caster_threads,
+                     unsigned int rtcm_caster_queue_depth);
 
     void msg_handler_telemetry(pmt::pmt_t msg);
+    void msg_handler_parameters(pmt::pmt_t msg);
 
     bool d_dump;
     bool b_rinex_header_writen;
@@ -137,6 +179,30 @@ private:
 
     std::map<int,Gnss_Synchro> gnss_pseudoranges_map;
 
+    /*!
+     * \brief Solution and navigation data of an output epoch, written by
+     * the output writer thread while the block goes on
+     */
+    struct Output_Epoch
+    {
+        std::shared_ptr<Pvt_Solution> solution;
+        std::map<int,Gnss_Synchro> pseudoranges;
+        std::shared_ptr<const Gnss_Nav_Data> nav;  // shared snapshot, not a copy
+        double rx_time;
+        long unsigned int sample_counter;
+        double signal_time_s;  // of the newest samples in the pseudoranges, see Gnss_Sdr_Latency_Tracer
+    };
+    // KML, GeoJSON, NMEA, RINEX and RTCM outputs. The RINEX and RTCM
+    // state flags are only used by the writer thread.
+    void write_outputs(const std::shared_ptr<Output_Epoch>& epoch);
+    std::shared_ptr<Pvt_Output_Writer> d_output_writer;
+
+    // Closes the output files and opens new ones, see Pvt_File_Rotation
+    void rotate_outputs();
+    std::shared_ptr<Pvt_File_Rotation> d_file_rotation;
+    std::string d_output_filename;
+    std::string d_nmea_dump_filename;
+
 public:
 
     /*!
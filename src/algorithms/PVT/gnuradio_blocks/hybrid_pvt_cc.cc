@@ -30,6 +30,7 @@
 
 #include "hybrid_pvt_cc.h"
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <boost/date_time/posix_time/posix_time.hpp>
@@ -38,6 +39,10 @@
 #include <gnuradio/io_signature.h>
 #include <glog/logging.h>
 #include "concurrent_map.h"
+#include "gnss_nav_data_store.h"
+#include "gnss_sdr_event_log.h"
+#include "gnss_sdr_parameters.h"
+#include "gnss_sdr_trace.h"
 
 using google::LogMessage;
 
@@ -47,6 +52,7 @@ hybrid_make_pvt_cc(unsigned int nchannels,
         std::string dump_filename,
         int averaging_depth,
         bool flag_averaging,
+        bool flag_averaging_ecef,
         int output_rate_ms,
         int display_rate_ms,
         bool flag_nmea_tty_port,
@@ -57,13 +63,31 @@ hybrid_make_pvt_cc(unsigned int nchannels,
         unsigned short rtcm_tcp_port,
         unsigned short rtcm_station_id,
         std::map<int,int> rtcm_msg_rate_ms,
-        std::string rtcm_dump_devname)
+        std::string rtcm_dump_devname,
+        bool flag_vector_tracking,
+        bool flag_kalman_filter,
+        bool flag_raim,
+        double raim_pfa,
+        double raim_sigma_m,
+        int raim_max_exclusions,
+        unsigned int batch_window_epochs,
+        unsigned int batch_threads,
+        std::string batch_filename,
+        unsigned int output_queue_depth,
+        Pvt_Output_Writer::Overflow_Policy output_overflow_policy,
+        Pvt_File_Rotation::Period rotation_period,
+        bool rotation_compress,
+        double track_flush_interval_s,
+        unsigned int rtcm_caster_threads,
+        unsigned int rtcm_caster_queue_depth,
+        bool flag_solver_thread)
 {
     return hybrid_pvt_cc_sptr(new hybrid_pvt_cc(nchannels,
             dump,
             dump_filename,
             averaging_depth,
             flag_averaging,
+            flag_averaging_ecef,
             output_rate_ms,
             display_rate_ms,
             flag_nmea_tty_port,
@@ -74,85 +98,37 @@ hybrid_make_pvt_cc(unsigned int nchannels,
             rtcm_tcp_port,
             rtcm_station_id,
             rtcm_msg_rate_ms,
-            rtcm_dump_devname));
+            rtcm_dump_devname,
+            flag_vector_tracking,
+            flag_kalman_filter,
+            flag_raim,
+            raim_pfa,
+            raim_sigma_m,
+            raim_max_exclusions,
+            batch_window_epochs,
+            batch_threads,
+            batch_filename,
+            output_queue_depth,
+            output_overflow_policy,
+            rotation_period,
+            rotation_compress,
+            track_flush_interval_s,
+            rtcm_caster_threads,
+            rtcm_caster_queue_depth,
+            flag_solver_thread));
 }
 
 
 void hybrid_pvt_cc::msg_handler_telemetry(pmt::pmt_t msg)
 {
+    GNSS_SDR_TRACE_SCOPE("hybrid_pvt_cc::msg_handler_telemetry");
+    // The telemetry decoders update Gnss_Nav_Data_Store directly, navigation
+    // data still received as a message (e.g., assistance data) is stored too
     try {
-            if( pmt::any_ref(msg).type() == typeid(std::shared_ptr<Gps_Ephemeris>) )
-                {
-                    // ### GPS EPHEMERIS ###
-                    std::shared_ptr<Gps_Ephemeris> gps_eph;
-                    gps_eph = boost::any_cast<std::shared_ptr<Gps_Ephemeris>>(pmt::any_ref(msg));
-                    DLOG(INFO) << "Ephemeris record has arrived from SAT ID "
-                            << gps_eph->i_satellite_PRN << " (Block "
-                            <<  gps_eph->satelliteBlock[gps_eph->i_satellite_PRN] << ")"
-                            << "inserted with Toe="<< gps_eph->d_Toe<<" and GPS Week="
-                            << gps_eph->i_GPS_week;
-                    // update/insert new ephemeris record to the global ephemeris map
-                    d_ls_pvt->gps_ephemeris_map[gps_eph->i_satellite_PRN] = *gps_eph;
-                }
-            else if (pmt::any_ref(msg).type() == typeid(std::shared_ptr<Gps_Iono>) )
-                {
-                    // ### GPS IONO ###
-                    std::shared_ptr<Gps_Iono> gps_iono;
-                    gps_iono = boost::any_cast<std::shared_ptr<Gps_Iono>>(pmt::any_ref(msg));
-                    d_ls_pvt->gps_iono = *gps_iono;
-                    DLOG(INFO) << "New IONO record has arrived ";
-                }
-            else if (pmt::any_ref(msg).type() == typeid(std::shared_ptr<Gps_Utc_Model>) )
-                {
-                    // ### GPS UTC MODEL ###
-                    std::shared_ptr<Gps_Utc_Model> gps_utc_model;
-                    gps_utc_model = boost::any_cast<std::shared_ptr<Gps_Utc_Model>>(pmt::any_ref(msg));
-                    d_ls_pvt->gps_utc_model = *gps_utc_model;
-                    DLOG(INFO) << "New UTC record has arrived ";
-                }
-
-            if( pmt::any_ref(msg).type() == typeid(std::shared_ptr<Galileo_Ephemeris>) )
-                {
-                    // ### Galileo EPHEMERIS ###
-                    std::shared_ptr<Galileo_Ephemeris> galileo_eph;
-                    galileo_eph = boost::any_cast<std::shared_ptr<Galileo_Ephemeris>>(pmt::any_ref(msg));
-                    // insert new ephemeris record
-                    DLOG(INFO) << "Galileo New Ephemeris record inserted in global map with TOW =" << galileo_eph->TOW_5
-                            << ", GALILEO Week Number =" << galileo_eph->WN_5
-                            << " and Ephemeris IOD = " << galileo_eph->IOD_ephemeris;
-                    // update/insert new ephemeris record to the global ephemeris map
-                    d_ls_pvt->galileo_ephemeris_map[galileo_eph->i_satellite_PRN] = *galileo_eph;
-                }
-            else if (pmt::any_ref(msg).type() == typeid(std::shared_ptr<Galileo_Iono>) )
-                {
-                    // ### Galileo IONO ###
-                    std::shared_ptr<Galileo_Iono> galileo_iono;
-                    galileo_iono = boost::any_cast<std::shared_ptr<Galileo_Iono>>(pmt::any_ref(msg));
-                    d_ls_pvt->galileo_iono = *galileo_iono;
-                    DLOG(INFO) << "New IONO record has arrived ";
-                }
-            else if (pmt::any_ref(msg).type() == typeid(std::shared_ptr<Galileo_Utc_Model>) )
-                {
-                    // ### Galileo UTC MODEL ###
-                    std::shared_ptr<Galileo_Utc_Model> galileo_utc_model;
-                    galileo_utc_model = boost::any_cast<std::shared_ptr<Galileo_Utc_Model>>(pmt::any_ref(msg));
-                    d_ls_pvt->galileo_utc_model = *galileo_utc_model;
-                    DLOG(INFO) << "New UTC record has arrived ";
-                }
-            else if (pmt::any_ref(msg).type() == typeid(std::shared_ptr<Galileo_Almanac>) )
-                {
-                    // ### Galileo Almanac ###
-                    std::shared_ptr<Galileo_Almanac> galileo_almanac;
-                    galileo_almanac = boost::any_cast<std::shared_ptr<Galileo_Almanac>>(pmt::any_ref(msg));
-                    // update/insert new ephemeris record to the global ephemeris map
-                    d_ls_pvt->galileo_almanac = *galileo_almanac;
-                    DLOG(INFO) << "New Galileo Almanac has arrived ";
-                }
-            else
+            if (!Gnss_Nav_Data_Store::instance().update(pmt::any_ref(msg)))
                 {
                     LOG(WARNING) << "msg_handler_telemetry unknown object type!";
                 }
-
     }
     catch(boost::bad_any_cast& e)
     {
@@ -161,17 +137,99 @@ void hybrid_pvt_cc::msg_handler_telemetry(pmt::pmt_t msg)
 }
 
 
+void hybrid_pvt_cc::msg_handler_parameters(pmt::pmt_t msg)
+{
+    GNSS_SDR_TRACE_SCOPE("hybrid_pvt_cc::msg_handler_parameters");
+    int output_rate_ms = d_output_rate_ms;
+    int display_rate_ms = d_display_rate_ms;
+    gnss_sdr_get_parameter(msg, "output_rate_ms", output_rate_ms);
+    gnss_sdr_get_parameter(msg, "display_rate_ms", display_rate_ms);
+    if (output_rate_ms <= 0 or display_rate_ms <= 0)
+        {
+            LOG(WARNING) << "PVT: the output and display rates must be positive";
+            return;
+        }
+    if (output_rate_ms != d_output_rate_ms or display_rate_ms != d_display_rate_ms)
+        {
+            d_output_rate_ms = output_rate_ms;
+            d_display_rate_ms = display_rate_ms;
+            LOG(INFO) << "PVT: output rate updated to " << d_output_rate_ms
+                      << " ms, display rate to " << d_display_rate_ms << " ms";
+        }
+}
+
+
+void hybrid_pvt_cc::publish_vector_tracking_aiding()
+{
+    std::map<int,double>::iterator prediction_iter;
+    std::map<int,Gnss_Synchro>::iterator gnss_pseudoranges_iter;
+    for(prediction_iter = d_ls_pvt->d_predicted_range_rate_m_s.begin();
+            prediction_iter != d_ls_pvt->d_predicted_range_rate_m_s.end();
+            prediction_iter++)
+        {
+            gnss_pseudoranges_iter = gnss_pseudoranges_map.find(prediction_iter->first);
+            if (gnss_pseudoranges_iter == gnss_pseudoranges_map.end()) continue;
+            // the tracking blocks match the prediction with their own channel and
+            // satellite, and extrapolate it from the receiver sample time stamp
+            pmt::pmt_t msg = pmt::make_dict();
+            msg = pmt::dict_add(msg, pmt::mp("channel"), pmt::from_long(prediction_iter->first));
+            msg = pmt::dict_add(msg, pmt::mp("prn"), pmt::from_long(gnss_pseudoranges_iter->second.PRN));
+            msg = pmt::dict_add(msg, pmt::mp("timestamp_s"), pmt::from_double(gnss_pseudoranges_iter->second.Tracking_timestamp_secs));
+            msg = pmt::dict_add(msg, pmt::mp("range_rate_m_s"), pmt::from_double(prediction_iter->second));
+            this->message_port_pub(pmt::mp("vector_tracking"), msg);
+        }
+}
+
+
+void hybrid_pvt_cc::publish_beam_steering()
+{
+    std::map<int,double>::iterator azimuth_iter;
+    std::map<int,double>::iterator elevation_iter;
+    for(azimuth_iter = d_ls_pvt->d_los_azimuth_d.begin();
+            azimuth_iter != d_ls_pvt->d_los_azimuth_d.end();
+            azimuth_iter++)
+        {
+            elevation_iter = d_ls_pvt->d_los_elevation_d.find(azimuth_iter->first);
+            if (elevation_iter == d_ls_pvt->d_los_elevation_d.end()) continue;
+            // the beam steering stage of an antenna array points the beam of
+            // each channel to its satellite
+            pmt::pmt_t msg = pmt::make_dict();
+            msg = pmt::dict_add(msg, pmt::mp("channel"), pmt::from_long(azimuth_iter->first));
+            msg = pmt::dict_add(msg, pmt::mp("azimuth_deg"), pmt::from_double(azimuth_iter->second));
+            msg = pmt::dict_add(msg, pmt::mp("elevation_deg"), pmt::from_double(elevation_iter->second));
+            this->message_port_pub(pmt::mp("beam_steering"), msg);
+        }
+}
+
+
 std::map<int,Gps_Ephemeris> hybrid_pvt_cc::get_GPS_L1_ephemeris_map()
 {
-    return d_ls_pvt->gps_ephemeris_map;
+    return Gnss_Nav_Data_Store::instance().snapshot()->gps_ephemeris_map;
 }
 
 
 hybrid_pvt_cc::hybrid_pvt_cc(unsigned int nchannels, bool dump, std::string dump_filename,
-        int averaging_depth, bool flag_averaging, int output_rate_ms, int display_rate_ms, bool flag_nmea_tty_port,
+        int averaging_depth, bool flag_averaging, bool flag_averaging_ecef, int output_rate_ms, int display_rate_ms, bool flag_nmea_tty_port,
         std::string nmea_dump_filename, std::string nmea_dump_devname,
         bool flag_rtcm_server, bool flag_rtcm_tty_port, unsigned short rtcm_tcp_port,
-        unsigned short rtcm_station_id, std::map<int,int> rtcm_msg_rate_ms, std::string rtcm_dump_devname) :
+        unsigned short rtcm_station_id, std::map<int,int> rtcm_msg_rate_ms, std::string rtcm_dump_devname,
+        bool flag_vector_tracking,
+        bool flag_kalman_filter,
+        bool flag_raim,
+        double raim_pfa,
+        double raim_sigma_m,
+        int raim_max_exclusions,
+        unsigned int batch_window_epochs,
+        unsigned int batch_threads,
+        std::string batch_filename,
+        unsigned int output_queue_depth,
+        Pvt_Output_Writer::Overflow_Policy output_overflow_policy,
+        Pvt_File_Rotation::Period rotation_period,
+        bool rotation_compress,
+        double track_flush_interval_s,
+        unsigned int rtcm_caster_threads,
+        unsigned int rtcm_caster_queue_depth,
+        bool flag_solver_thread) :
                 gr::block("hybrid_pvt_cc", gr::io_signature::make(nchannels, nchannels,  sizeof(Gnss_Synchro)),
                 gr::io_signature::make(0, 0, sizeof(gr_complex)))
 
@@ -186,17 +244,27 @@ hybrid_pvt_cc::hybrid_pvt_cc(unsigned int nchannels, bool dump, std::string dump
     // GPS Ephemeris data message port in
     this->message_port_register_in(pmt::mp("telemetry"));
     this->set_msg_handler(pmt::mp("telemetry"), boost::bind(&hybrid_pvt_cc::msg_handler_telemetry, this, _1));
+    // Output rates changed in the configuration file while running
+    this->message_port_register_in(pmt::mp("parameters"));
+    this->set_msg_handler(pmt::mp("parameters"), boost::bind(&hybrid_pvt_cc::msg_handler_parameters, this, _1));
+
+    // Navigation solution feedback to the tracking loops (vector tracking)
+    d_flag_vector_tracking = flag_vector_tracking;
+    this->message_port_register_out(pmt::mp("vector_tracking"));
+
+    // Line of sight of each channel, for the beam steering of antenna arrays
+    this->message_port_register_out(pmt::mp("beam_steering"));
 
     //initialize kml_printer
     std::string kml_dump_filename;
     kml_dump_filename = d_dump_filename;
-    d_kml_dump = std::make_shared<Kml_Printer>();
+    d_kml_dump = std::make_shared<Kml_Printer>(track_flush_interval_s);
     d_kml_dump->set_headers(kml_dump_filename);
 
     //initialize geojson_printer
     std::string geojson_dump_filename;
     geojson_dump_filename = d_dump_filename;
-    d_geojson_printer = std::make_shared<GeoJSON_Printer>();
+    d_geojson_printer = std::make_shared<GeoJSON_Printer>(track_flush_interval_s);
     d_geojson_printer->set_headers(geojson_dump_filename);
 
     //initialize nmea_printer
@@ -205,7 +273,7 @@ hybrid_pvt_cc::hybrid_pvt_cc(unsigned int nchannels, bool dump, std::string dump
     //initialize rtcm_printer
     std::string rtcm_dump_filename;
     rtcm_dump_filename = d_dump_filename;
-    d_rtcm_printer = std::make_shared<Rtcm_Printer>(rtcm_dump_filename, flag_rtcm_server, flag_rtcm_tty_port, rtcm_tcp_port, rtcm_station_id, rtcm_dump_devname);
+    d_rtcm_printer = std::make_shared<Rtcm_Printer>(rtcm_dump_filename, flag_rtcm_server, flag_rtcm_tty_port, rtcm_tcp_port, rtcm_station_id, rtcm_dump_devname, true, rtcm_caster_threads, rtcm_caster_queue_depth);
     if(rtcm_msg_rate_ms.find(1019) != rtcm_msg_rate_ms.end())
         {
             d_rtcm_MT1019_rate_ms = rtcm_msg_rate_ms[1019];
@@ -247,6 +315,10 @@ hybrid_pvt_cc::hybrid_pvt_cc(unsigned int nchannels, bool dump, std::string dump
 
     d_ls_pvt = std::make_shared<hybrid_ls_pvt>((int)nchannels, dump_ls_pvt_filename, d_dump);
     d_ls_pvt->set_averaging_depth(d_averaging_depth);
+    d_ls_pvt->set_averaging_ecef(flag_averaging_ecef);
+    d_ls_pvt->set_kalman_filter(flag_kalman_filter);
+    d_ls_pvt->set_raim(flag_raim, raim_pfa, raim_sigma_m, raim_max_exclusions);
+    d_ls_pvt->set_batch(batch_window_epochs, batch_threads, batch_filename);
 
     d_sample_counter = 0;
     d_last_sample_nav_output = 0;
@@ -256,6 +328,13 @@ hybrid_pvt_cc::hybrid_pvt_cc(unsigned int nchannels, bool dump, std::string dump
     b_rinex_header_updated = false;
     rp = std::make_shared<Rinex_Printer>();
 
+    d_output_writer = std::make_shared<Pvt_Output_Writer>(output_queue_depth, output_overflow_policy);
+    d_solver = std::make_shared<Pvt_Solver_Thread>(flag_solver_thread);
+    d_last_display_sample = 0;
+    d_file_rotation = std::make_shared<Pvt_File_Rotation>(rotation_period, rotation_compress);
+    d_output_filename = dump_filename;
+    d_nmea_dump_filename = nmea_dump_filename;
+
     d_last_status_print_seg = 0;
 
     // ############# ENABLE DATA FILE LOG #################
@@ -280,7 +359,11 @@ hybrid_pvt_cc::hybrid_pvt_cc(unsigned int nchannels, bool dump, std::string dump
 
 
 hybrid_pvt_cc::~hybrid_pvt_cc()
-{}
+{
+    // solve the pending epoch, then write the queued ones before the printers are destroyed
+    d_solver.reset();
+    d_output_writer.reset();
+}
 
 
 
@@ -292,269 +375,330 @@ bool hybrid_pvt_cc::pseudoranges_pairCompare_min(const std::pair<int,Gnss_Synchr
 
 void hybrid_pvt_cc::print_receiver_status(Gnss_Synchro** channels_synchronization_data)
 {
-    // Print the current receiver status using std::cout every second
+    // Print the current receiver status every second
     int current_rx_seg = floor(channels_synchronization_data[0][0].Tracking_timestamp_secs);
     if ( current_rx_seg != d_last_status_print_seg)
         {
             d_last_status_print_seg = current_rx_seg;
-            std::cout << "Current input signal time = " << current_rx_seg << " [s]" << std::endl << std::flush;
+            Gnss_Sdr_Event_Log::satellite_event(EVENT_RX_TIME, -1, 0, 0, current_rx_seg);
             //DLOG(INFO) << "GPS L1 C/A Tracking CH " << d_channel <<  ": Satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN)
             //          << ", CN0 = " << d_CN0_SNV_dB_Hz << " [dB-Hz]" << std::endl;
         }
 }
 
 
-int hybrid_pvt_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
-        gr_vector_const_void_star &input_items, gr_vector_void_star &output_items __attribute__((unused)))
+void hybrid_pvt_cc::rotate_outputs()
 {
-    d_sample_counter++;
+    std::vector<std::string> closed = rp->rotate_files();
+    // the headers and navigation data go again into the new RINEX files
+    b_rinex_header_writen = false;
+    b_rinex_header_updated = false;
+    d_last_sample_nav_output = 0;
+
+    closed.push_back(d_kml_dump->get_filename());
+    d_kml_dump->close_file();
+    d_kml_dump->set_headers(d_output_filename);
+
+    closed.push_back(d_geojson_printer->get_filename());
+    d_geojson_printer->close_file();
+    d_geojson_printer->set_headers(d_output_filename);
+
+    closed.push_back(d_nmea_printer->get_filename());
+    d_nmea_printer->open_file(Pvt_File_Rotation::tagged_filename(d_nmea_dump_filename, time(nullptr)));
+
+    for (std::vector<std::string>::const_iterator it = closed.begin(); it != closed.end(); it++)
+        {
+            d_file_rotation->archive(*it);
+        }
+    LOG(INFO) << "PVT output files rotated";
+}
+
+
+void hybrid_pvt_cc::write_outputs(const std::shared_ptr<Output_Epoch>& epoch)
+{
+    if (d_file_rotation->due())
+        {
+            rotate_outputs();
+        }
+
     bool arrived_galileo_almanac = false;
     unsigned int gps_channel = 0;
     unsigned int gal_channel = 0;
 
-    gnss_pseudoranges_map.clear();
-
-    Gnss_Synchro **in = (Gnss_Synchro **)  &input_items[0]; //Get the input pointer
+    // keep track of locking time
+    for (std::map<int,Gnss_Synchro>::iterator it = epoch->pseudoranges.begin(); it != epoch->pseudoranges.end(); it++)
+        {
+            std::map<int,Gps_Ephemeris>::const_iterator tmp_gps_eph_iter = epoch->nav->gps_ephemeris_map.find(it->second.PRN);
+            if(tmp_gps_eph_iter != epoch->nav->gps_ephemeris_map.end())
+                {
+                    d_rtcm_printer->lock_time(tmp_gps_eph_iter->second, epoch->rx_time, it->second);
+                }
+            std::map<int,Galileo_Ephemeris>::const_iterator tmp_gal_eph_iter = epoch->nav->galileo_ephemeris_map.find(it->second.PRN);
+            if(tmp_gal_eph_iter != epoch->nav->galileo_ephemeris_map.end())
+                {
+                    d_rtcm_printer->lock_time(tmp_gal_eph_iter->second, epoch->rx_time, it->second);
+                }
+        }
 
-    print_receiver_status(in);
+    d_kml_dump->print_position(epoch->solution, d_flag_averaging);
+    d_geojson_printer->print_position(epoch->solution, d_flag_averaging);
+    d_nmea_printer->Print_Nmea_Line(epoch->solution, d_flag_averaging);
 
-    // ############ 1. READ PSEUDORANGES ####
-    for (unsigned int i = 0; i < d_nchannels; i++)
+    if (!b_rinex_header_writen) //  & we have utc data in nav message!
         {
-            if (in[i][0].Flag_valid_pseudorange == true)
+            std::map<int, Galileo_Ephemeris>::const_iterator galileo_ephemeris_iter;
+            galileo_ephemeris_iter = epoch->nav->galileo_ephemeris_map.begin();
+            std::map<int, Gps_Ephemeris>::const_iterator gps_ephemeris_iter;
+            gps_ephemeris_iter = epoch->nav->gps_ephemeris_map.begin();
+            if ((galileo_ephemeris_iter != epoch->nav->galileo_ephemeris_map.end()) && (gps_ephemeris_iter != epoch->nav->gps_ephemeris_map.end()) )
                 {
-                    gnss_pseudoranges_map.insert(std::pair<int,Gnss_Synchro>(i, in[i][0])); // store valid pseudoranges in a map.
-                    //d_rx_time = in[i][0].d_TOW_at_current_symbol; // all the channels have the same RX timestamp (common RX time pseudoranges)
-                    d_TOW_at_curr_symbol_constellation = in[i][0].d_TOW_at_current_symbol; // d_TOW_at_current_symbol not corrected by delta t (just for debug)
-                    d_rx_time = in[i][0].d_TOW_hybrid_at_current_symbol; // hybrid rx time, all the channels have the same RX timestamp (common RX time pseudoranges)
-                    if(d_ls_pvt->gps_ephemeris_map.size() > 0)
+                    if (arrived_galileo_almanac)
                         {
-                            std::map<int,Gps_Ephemeris>::iterator tmp_eph_iter = d_ls_pvt->gps_ephemeris_map.find(in[i][0].PRN);
-                            if(tmp_eph_iter != d_ls_pvt->gps_ephemeris_map.end())
-                                {
-                                    d_rtcm_printer->lock_time(d_ls_pvt->gps_ephemeris_map.find(in[i][0].PRN)->second, d_rx_time, in[i][0]); // keep track of locking time
-                                }
-                        }
-                    if(d_ls_pvt->galileo_ephemeris_map.size() > 0)
-                        {
-                            std::map<int,Galileo_Ephemeris>::iterator tmp_eph_iter = d_ls_pvt->galileo_ephemeris_map.find(in[i][0].PRN);
-                            if(tmp_eph_iter != d_ls_pvt->galileo_ephemeris_map.end())
-                                {
-                                    d_rtcm_printer->lock_time(d_ls_pvt->galileo_ephemeris_map.find(in[i][0].PRN)->second, d_rx_time, in[i][0]); // keep track of locking time
-                                }
+                            rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, galileo_ephemeris_iter->second, epoch->rx_time);
+                            rp->rinex_nav_header(rp->navMixFile,  epoch->nav->gps_iono,  epoch->nav->gps_utc_model, epoch->nav->galileo_iono, epoch->nav->galileo_utc_model, epoch->nav->galileo_almanac);
+                            b_rinex_header_writen = true; // do not write header anymore
                         }
                 }
         }
-
-    // ############ 2 COMPUTE THE PVT ################################
-    // ToDo: relax this condition because the receiver should work even with NO GALILEO SATELLITES
-    //if (gnss_pseudoranges_map.size() > 0 and d_ls_pvt->galileo_ephemeris_map.size() > 0 and d_ls_pvt->gps_ephemeris_map.size() > 0)
-    if (gnss_pseudoranges_map.size() > 0)
+    if(b_rinex_header_writen) // Put here another condition to separate annotations (e.g 30 s)
         {
-            //std::cout << "Both GPS and Galileo ephemeris map have been filled " << std::endl;
-            // compute on the fly PVT solution
-            if ((d_sample_counter % d_output_rate_ms) == 0)
+            // Limit the RINEX navigation output rate to 1/6 seg
+            // Notice that the sample counter period is 4ms (for Galileo correlators)
+            if ((epoch->sample_counter - d_last_sample_nav_output) >= 6000)
+                {
+                    rp->log_rinex_nav(rp->navMixFile, epoch->nav->gps_ephemeris_map, epoch->nav->galileo_ephemeris_map);
+                    d_last_sample_nav_output = epoch->sample_counter;
+                }
+            std::map<int, Galileo_Ephemeris>::const_iterator galileo_ephemeris_iter;
+            galileo_ephemeris_iter = epoch->nav->galileo_ephemeris_map.begin();
+            std::map<int, Gps_Ephemeris>::const_iterator gps_ephemeris_iter;
+            gps_ephemeris_iter = epoch->nav->gps_ephemeris_map.begin();
+            if ((galileo_ephemeris_iter != epoch->nav->galileo_ephemeris_map.end()) && (gps_ephemeris_iter != epoch->nav->gps_ephemeris_map.end())  )
                 {
-                    bool pvt_result;
-                    pvt_result = d_ls_pvt->get_PVT(gnss_pseudoranges_map, d_rx_time, d_flag_averaging);
+                    rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, galileo_ephemeris_iter->second, epoch->rx_time, epoch->pseudoranges);
+                }
+            if (!b_rinex_header_updated && (epoch->nav->gps_utc_model.d_A0 != 0))
+                {
+                    rp->update_obs_header(rp->obsFile, epoch->nav->gps_utc_model);
+                    rp->update_nav_header(rp->navMixFile, epoch->nav->gps_iono,  epoch->nav->gps_utc_model, epoch->nav->galileo_iono, epoch->nav->galileo_utc_model, epoch->nav->galileo_almanac);
+                    b_rinex_header_updated = true;
+                }
+        }
 
-                    if (pvt_result == true)
+    if(b_rtcm_writing_started)
+        {
+            if(((epoch->sample_counter % (d_rtcm_MT1019_rate_ms / 4)) == 0) && (d_rtcm_MT1019_rate_ms != 0))
+                {
+                    for(std::map<int,Gps_Ephemeris>::const_iterator gps_ephemeris_iter = epoch->nav->gps_ephemeris_map.begin(); gps_ephemeris_iter != epoch->nav->gps_ephemeris_map.end(); gps_ephemeris_iter++ )
                         {
-                            d_kml_dump->print_position(d_ls_pvt, d_flag_averaging);
-                            d_geojson_printer->print_position(d_ls_pvt, d_flag_averaging);
-                            d_nmea_printer->Print_Nmea_Line(d_ls_pvt, d_flag_averaging);
-
-                            if (!b_rinex_header_writen) //  & we have utc data in nav message!
+                            d_rtcm_printer->Print_Rtcm_MT1019(gps_ephemeris_iter->second);
+                        }
+                }
+            if(((epoch->sample_counter % (d_rtcm_MT1045_rate_ms / 4)) == 0) && (d_rtcm_MT1045_rate_ms != 0))
+                {
+                    for(std::map<int,Galileo_Ephemeris>::const_iterator gal_ephemeris_iter = epoch->nav->galileo_ephemeris_map.begin(); gal_ephemeris_iter != epoch->nav->galileo_ephemeris_map.end(); gal_ephemeris_iter++ )
+                        {
+                            d_rtcm_printer->Print_Rtcm_MT1045(gal_ephemeris_iter->second);
+                        }
+                }
+            if(((epoch->sample_counter % (d_rtcm_MT1097_rate_ms / 4) ) == 0) || ((epoch->sample_counter % (d_rtcm_MT1077_rate_ms / 4) ) == 0))
+                {
+                    std::map<int,Gnss_Synchro>::iterator gnss_pseudoranges_iter;
+                    std::map<int,Gps_Ephemeris>::const_iterator gps_ephemeris_iter;
+                    gps_ephemeris_iter = epoch->nav->gps_ephemeris_map.end();
+                    std::map<int,Galileo_Ephemeris>::const_iterator gal_ephemeris_iter;
+                    gal_ephemeris_iter = epoch->nav->galileo_ephemeris_map.end();
+                    unsigned int i = 0;
+                    for (gnss_pseudoranges_iter = epoch->pseudoranges.begin(); gnss_pseudoranges_iter != epoch->pseudoranges.end(); gnss_pseudoranges_iter++)
+                        {
+                            std::string system(&gnss_pseudoranges_iter->second.System, 1);
+                            if(gps_channel == 0)
                                 {
-                                    std::map<int, Galileo_Ephemeris>::iterator galileo_ephemeris_iter;
-                                    galileo_ephemeris_iter = d_ls_pvt->galileo_ephemeris_map.begin();
-                                    std::map<int, Gps_Ephemeris>::iterator gps_ephemeris_iter;
-                                    gps_ephemeris_iter = d_ls_pvt->gps_ephemeris_map.begin();
-                                    if ((galileo_ephemeris_iter != d_ls_pvt->galileo_ephemeris_map.end()) && (gps_ephemeris_iter != d_ls_pvt->gps_ephemeris_map.end()) )
+                                    if(system.compare("G") == 0)
                                         {
-                                            if (arrived_galileo_almanac)
+                                            // This is a channel with valid GPS signal
+                                            gps_ephemeris_iter = epoch->nav->gps_ephemeris_map.find(gnss_pseudoranges_iter->second.PRN);
+                                            if (gps_ephemeris_iter != epoch->nav->gps_ephemeris_map.end())
                                                 {
-                                                    rp->rinex_obs_header(rp->obsFile, gps_ephemeris_iter->second, galileo_ephemeris_iter->second, d_rx_time);
-                                                    rp->rinex_nav_header(rp->navMixFile,  d_ls_pvt->gps_iono,  d_ls_pvt->gps_utc_model, d_ls_pvt->galileo_iono, d_ls_pvt->galileo_utc_model, d_ls_pvt->galileo_almanac);
-                                                    b_rinex_header_writen = true; // do not write header anymore
+                                                    gps_channel = i;
                                                 }
                                         }
                                 }
-                            if(b_rinex_header_writen) // Put here another condition to separate annotations (e.g 30 s)
+                            if(gal_channel == 0)
                                 {
-                                    // Limit the RINEX navigation output rate to 1/6 seg
-                                    // Notice that d_sample_counter period is 4ms (for Galileo correlators)
-                                    if ((d_sample_counter - d_last_sample_nav_output) >= 6000)
-                                        {
-                                            rp->log_rinex_nav(rp->navMixFile, d_ls_pvt->gps_ephemeris_map, d_ls_pvt->galileo_ephemeris_map);
-                                            d_last_sample_nav_output = d_sample_counter;
-                                        }
-                                    std::map<int, Galileo_Ephemeris>::iterator galileo_ephemeris_iter;
-                                    galileo_ephemeris_iter = d_ls_pvt->galileo_ephemeris_map.begin();
-                                    std::map<int, Gps_Ephemeris>::iterator gps_ephemeris_iter;
-                                    gps_ephemeris_iter = d_ls_pvt->gps_ephemeris_map.begin();
-                                    if ((galileo_ephemeris_iter != d_ls_pvt->galileo_ephemeris_map.end()) && (gps_ephemeris_iter != d_ls_pvt->gps_ephemeris_map.end())  )
+                                    if(system.compare("E") == 0)
                                         {
-                                            rp->log_rinex_obs(rp->obsFile, gps_ephemeris_iter->second, galileo_ephemeris_iter->second, d_rx_time, gnss_pseudoranges_map);
-                                        }
-                                    if (!b_rinex_header_updated && (d_ls_pvt->gps_utc_model.d_A0 != 0))
-                                        {
-                                            rp->update_obs_header(rp->obsFile, d_ls_pvt->gps_utc_model);
-                                            rp->update_nav_header(rp->navMixFile, d_ls_pvt->gps_iono,  d_ls_pvt->gps_utc_model, d_ls_pvt->galileo_iono, d_ls_pvt->galileo_utc_model, d_ls_pvt->galileo_almanac);
-                                            b_rinex_header_updated = true;
-                                        }
-                                }
-
-                            if(b_rtcm_writing_started)
-                                {
-                                    if(((d_sample_counter % (d_rtcm_MT1019_rate_ms / 4)) == 0) && (d_rtcm_MT1019_rate_ms != 0))
-                                        {
-                                            for(std::map<int,Gps_Ephemeris>::iterator gps_ephemeris_iter = d_ls_pvt->gps_ephemeris_map.begin(); gps_ephemeris_iter != d_ls_pvt->gps_ephemeris_map.end(); gps_ephemeris_iter++ )
-                                                {
-                                                    d_rtcm_printer->Print_Rtcm_MT1019(gps_ephemeris_iter->second);
-                                                }
-                                        }
-                                    if(((d_sample_counter % (d_rtcm_MT1045_rate_ms / 4)) == 0) && (d_rtcm_MT1045_rate_ms != 0))
-                                        {
-                                            for(std::map<int,Galileo_Ephemeris>::iterator gal_ephemeris_iter = d_ls_pvt->galileo_ephemeris_map.begin(); gal_ephemeris_iter != d_ls_pvt->galileo_ephemeris_map.end(); gal_ephemeris_iter++ )
+                                            gal_ephemeris_iter = epoch->nav->galileo_ephemeris_map.find(gnss_pseudoranges_iter->second.PRN);
+                                            if (gal_ephemeris_iter != epoch->nav->galileo_ephemeris_map.end())
                                                 {
-                                                    d_rtcm_printer->Print_Rtcm_MT1045(gal_ephemeris_iter->second);
+                                                    gal_channel = i;
                                                 }
                                         }
-                                    if(((d_sample_counter % (d_rtcm_MT1097_rate_ms / 4) ) == 0) || ((d_sample_counter % (d_rtcm_MT1077_rate_ms / 4) ) == 0))
-                                        {
-                                            std::map<int,Gnss_Synchro>::iterator gnss_pseudoranges_iter;
-                                            std::map<int,Gps_Ephemeris>::iterator gps_ephemeris_iter;
-                                            gps_ephemeris_iter = d_ls_pvt->gps_ephemeris_map.end();
-                                            std::map<int,Galileo_Ephemeris>::iterator gal_ephemeris_iter;
-                                            gal_ephemeris_iter = d_ls_pvt->galileo_ephemeris_map.end();
-                                            unsigned int i = 0;
-                                            for (gnss_pseudoranges_iter = gnss_pseudoranges_map.begin(); gnss_pseudoranges_iter != gnss_pseudoranges_map.end(); gnss_pseudoranges_iter++)
-                                                {
-                                                    std::string system(&gnss_pseudoranges_iter->second.System, 1);
-                                                    if(gps_channel == 0)
-                                                        {
-                                                            if(system.compare("G") == 0)
-                                                                {
-                                                                    // This is a channel with valid GPS signal
-                                                                    gps_ephemeris_iter = d_ls_pvt->gps_ephemeris_map.find(gnss_pseudoranges_iter->second.PRN);
-                                                                    if (gps_ephemeris_iter != d_ls_pvt->gps_ephemeris_map.end())
-                                                                        {
-                                                                            gps_channel = i;
-                                                                        }
-                                                                }
-                                                        }
-                                                    if(gal_channel == 0)
-                                                        {
-                                                            if(system.compare("E") == 0)
-                                                                {
-                                                                    gal_ephemeris_iter = d_ls_pvt->galileo_ephemeris_map.find(gnss_pseudoranges_iter->second.PRN);
-                                                                    if (gal_ephemeris_iter != d_ls_pvt->galileo_ephemeris_map.end())
-                                                                        {
-                                                                            gal_channel = i;
-                                                                        }
-                                                                }
-                                                        }
-                                                    i++;
-                                                }
-                                            if(((d_sample_counter % (d_rtcm_MT1097_rate_ms / 4) ) == 0) && (d_rtcm_MT1097_rate_ms != 0) )
-                                                {
+                                }
+                            i++;
+                        }
+                    if(((epoch->sample_counter % (d_rtcm_MT1097_rate_ms / 4) ) == 0) && (d_rtcm_MT1097_rate_ms != 0) )
+                        {
 
-                                                    if (gal_ephemeris_iter != d_ls_pvt->galileo_ephemeris_map.end())
-                                                        {
-                                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_ephemeris_iter->second, d_rx_time, gnss_pseudoranges_map, 0, 0, 0, 0, 0);
-                                                        }
-                                                }
-                                            if(((d_sample_counter % (d_rtcm_MT1077_rate_ms / 4) ) == 0) && (d_rtcm_MT1077_rate_ms != 0) )
-                                                {
-                                                    if (gps_ephemeris_iter != d_ls_pvt->gps_ephemeris_map.end())
-                                                        {
-                                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_ephemeris_iter->second, {}, {}, d_rx_time, gnss_pseudoranges_map, 0, 0, 0, 0, 0);
-                                                        }
-                                                }
-                                        }
+                            if (gal_ephemeris_iter != epoch->nav->galileo_ephemeris_map.end())
+                                {
+                                    d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_ephemeris_iter->second, epoch->rx_time, epoch->pseudoranges, 0, 0, 0, 0, 0);
                                 }
-                            if(!b_rtcm_writing_started) // the first time
+                        }
+                    if(((epoch->sample_counter % (d_rtcm_MT1077_rate_ms / 4) ) == 0) && (d_rtcm_MT1077_rate_ms != 0) )
+                        {
+                            if (gps_ephemeris_iter != epoch->nav->gps_ephemeris_map.end())
                                 {
-                                    if(d_rtcm_MT1019_rate_ms != 0) // allows deactivating messages by setting rate = 0
-                                        {
-                                            for(std::map<int,Gps_Ephemeris>::iterator gps_ephemeris_iter = d_ls_pvt->gps_ephemeris_map.begin(); gps_ephemeris_iter != d_ls_pvt->gps_ephemeris_map.end(); gps_ephemeris_iter++ )
-                                                {
-                                                    d_rtcm_printer->Print_Rtcm_MT1019(gps_ephemeris_iter->second);
-                                                }
-                                        }
-                                    if(d_rtcm_MT1045_rate_ms != 0)
-                                        {
-                                            for(std::map<int,Galileo_Ephemeris>::iterator gal_ephemeris_iter = d_ls_pvt->galileo_ephemeris_map.begin(); gal_ephemeris_iter != d_ls_pvt->galileo_ephemeris_map.end(); gal_ephemeris_iter++ )
-                                                {
-                                                    d_rtcm_printer->Print_Rtcm_MT1045(gal_ephemeris_iter->second);
-                                                }
-                                        }
-
-                                    std::map<int,Gnss_Synchro>::iterator gnss_pseudoranges_iter;
-                                    std::map<int,Gps_Ephemeris>::iterator gps_ephemeris_iter;
-                                    gps_ephemeris_iter = d_ls_pvt->gps_ephemeris_map.end();
-                                    std::map<int,Galileo_Ephemeris>::iterator gal_ephemeris_iter;
-                                    gal_ephemeris_iter = d_ls_pvt->galileo_ephemeris_map.end();
-                                    unsigned int i = 0;
-                                    for (gnss_pseudoranges_iter = gnss_pseudoranges_map.begin(); gnss_pseudoranges_iter != gnss_pseudoranges_map.end(); gnss_pseudoranges_iter++)
-                                        {
-                                            std::string system(&gnss_pseudoranges_iter->second.System, 1);
-                                            if(gps_channel == 0)
-                                                {
-                                                    if(system.compare("G") == 0)
-                                                        {
-                                                            // This is a channel with valid GPS signal
-                                                            gps_ephemeris_iter = d_ls_pvt->gps_ephemeris_map.find(gnss_pseudoranges_iter->second.PRN);
-                                                            if (gps_ephemeris_iter != d_ls_pvt->gps_ephemeris_map.end())
-                                                                {
-                                                                    gps_channel = i;
-                                                                }
-                                                        }
-                                                }
-                                            if(gal_channel == 0)
-                                                {
-                                                    if(system.compare("E") == 0)
-                                                        {
-                                                            gal_ephemeris_iter = d_ls_pvt->galileo_ephemeris_map.find(gnss_pseudoranges_iter->second.PRN);
-                                                            if (gal_ephemeris_iter != d_ls_pvt->galileo_ephemeris_map.end())
-                                                                {
-                                                                    gal_channel = i;
-                                                                }
-                                                        }
-                                                }
-                                            i++;
-                                        }
+                                    d_rtcm_printer->Print_Rtcm_MSM(7, gps_ephemeris_iter->second, {}, {}, epoch->rx_time, epoch->pseudoranges, 0, 0, 0, 0, 0);
+                                }
+                        }
+                }
+        }
+    if(!b_rtcm_writing_started) // the first time
+        {
+            if(d_rtcm_MT1019_rate_ms != 0) // allows deactivating messages by setting rate = 0
+                {
+                    for(std::map<int,Gps_Ephemeris>::const_iterator gps_ephemeris_iter = epoch->nav->gps_ephemeris_map.begin(); gps_ephemeris_iter != epoch->nav->gps_ephemeris_map.end(); gps_ephemeris_iter++ )
+                        {
+                            d_rtcm_printer->Print_Rtcm_MT1019(gps_ephemeris_iter->second);
+                        }
+                }
+            if(d_rtcm_MT1045_rate_ms != 0)
+                {
+                    for(std::map<int,Galileo_Ephemeris>::const_iterator gal_ephemeris_iter = epoch->nav->galileo_ephemeris_map.begin(); gal_ephemeris_iter != epoch->nav->galileo_ephemeris_map.end(); gal_ephemeris_iter++ )
+                        {
+                            d_rtcm_printer->Print_Rtcm_MT1045(gal_ephemeris_iter->second);
+                        }
+                }
 
-                                    if (gps_ephemeris_iter != d_ls_pvt->gps_ephemeris_map.end() && (d_rtcm_MT1077_rate_ms != 0))
+            std::map<int,Gnss_Synchro>::iterator gnss_pseudoranges_iter;
+            std::map<int,Gps_Ephemeris>::const_iterator gps_ephemeris_iter;
+            gps_ephemeris_iter = epoch->nav->gps_ephemeris_map.end();
+            std::map<int,Galileo_Ephemeris>::const_iterator gal_ephemeris_iter;
+            gal_ephemeris_iter = epoch->nav->galileo_ephemeris_map.end();
+            unsigned int i = 0;
+            for (gnss_pseudoranges_iter = epoch->pseudoranges.begin(); gnss_pseudoranges_iter != epoch->pseudoranges.end(); gnss_pseudoranges_iter++)
+                {
+                    std::string system(&gnss_pseudoranges_iter->second.System, 1);
+                    if(gps_channel == 0)
+                        {
+                            if(system.compare("G") == 0)
+                                {
+                                    // This is a channel with valid GPS signal
+                                    gps_ephemeris_iter = epoch->nav->gps_ephemeris_map.find(gnss_pseudoranges_iter->second.PRN);
+                                    if (gps_ephemeris_iter != epoch->nav->gps_ephemeris_map.end())
                                         {
-                                            d_rtcm_printer->Print_Rtcm_MSM(7, gps_ephemeris_iter->second, {}, {}, d_rx_time, gnss_pseudoranges_map, 0, 0, 0, 0, 0);
+                                            gps_channel = i;
                                         }
-
-                                    if (gal_ephemeris_iter != d_ls_pvt->galileo_ephemeris_map.end() && (d_rtcm_MT1097_rate_ms != 0) )
+                                }
+                        }
+                    if(gal_channel == 0)
+                        {
+                            if(system.compare("E") == 0)
+                                {
+                                    gal_ephemeris_iter = epoch->nav->galileo_ephemeris_map.find(gnss_pseudoranges_iter->second.PRN);
+                                    if (gal_ephemeris_iter != epoch->nav->galileo_ephemeris_map.end())
                                         {
-                                            d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_ephemeris_iter->second, d_rx_time, gnss_pseudoranges_map, 0, 0, 0, 0, 0);
+                                            gal_channel = i;
                                         }
-                                    b_rtcm_writing_started = true;
                                 }
                         }
+                    i++;
+                }
+
+            if (gps_ephemeris_iter != epoch->nav->gps_ephemeris_map.end() && (d_rtcm_MT1077_rate_ms != 0))
+                {
+                    d_rtcm_printer->Print_Rtcm_MSM(7, gps_ephemeris_iter->second, {}, {}, epoch->rx_time, epoch->pseudoranges, 0, 0, 0, 0, 0);
+                }
+
+            if (gal_ephemeris_iter != epoch->nav->galileo_ephemeris_map.end() && (d_rtcm_MT1097_rate_ms != 0) )
+                {
+                    d_rtcm_printer->Print_Rtcm_MSM(7, {}, {}, gal_ephemeris_iter->second, epoch->rx_time, epoch->pseudoranges, 0, 0, 0, 0, 0);
+                }
+            b_rtcm_writing_started = true;
+        }
+}
+
+
+void hybrid_pvt_cc::solve_epoch(const std::map<int,Gnss_Synchro>& pseudoranges, double rx_time, long unsigned int sample_counter)
+{
+    // take the navigation data of this epoch, the output epochs share it without copying
+    if (d_ls_pvt->nav_data->version != Gnss_Nav_Data_Store::instance().version())
+        {
+            d_ls_pvt->nav_data = Gnss_Nav_Data_Store::instance().snapshot();
+        }
+    bool pvt_result;
+    pvt_result = d_ls_pvt->get_PVT(pseudoranges, rx_time, d_flag_averaging);
+
+    if (pvt_result == true)
+        {
+            if (d_ls_pvt->b_valid_position)
+                {
+                    // for the predictions of the satellites in view
+                    Gnss_Nav_Data_Store::instance().set_rx_position(d_ls_pvt->d_latitude_d,
+                            d_ls_pvt->d_longitude_d, d_ls_pvt->d_height_m, true, rx_time);
                 }
+            if (d_flag_vector_tracking and d_ls_pvt->b_valid_velocity)
+                {
+                    publish_vector_tracking_aiding();
+                }
+            publish_beam_steering();
+            // what the printers need, they run on the writer thread
+            std::shared_ptr<Output_Epoch> epoch = std::make_shared<Output_Epoch>();
+            epoch->solution = std::make_shared<Pvt_Solution>(*d_ls_pvt);
+            epoch->pseudoranges = pseudoranges;
+            epoch->nav = d_ls_pvt->nav_data;
+            epoch->rx_time = rx_time;
+            epoch->sample_counter = sample_counter;
+            d_output_writer->push(std::bind(&hybrid_pvt_cc::write_outputs, this, epoch));
+        }
 
-            // DEBUG MESSAGE: Display position in console output
-            if (((d_sample_counter % d_display_rate_ms) == 0) and d_ls_pvt->b_valid_position == true)
+    // DEBUG MESSAGE: Display position in console output
+    if ((sample_counter - d_last_display_sample >= static_cast<long unsigned int>(d_display_rate_ms)) and d_ls_pvt->b_valid_position == true)
+        {
+            d_last_display_sample = sample_counter;
+            Gnss_Sdr_Event_Log::position(d_ls_pvt->d_position_UTC_time, d_ls_pvt->d_valid_observations, d_ls_pvt->d_latitude_d,
+                    d_ls_pvt->d_longitude_d, d_ls_pvt->d_height_m, 0, EVENT_TO_CONSOLE | EVENT_TO_LOG);
+            Gnss_Sdr_Event_Log::dop(d_ls_pvt->d_position_UTC_time, d_ls_pvt->d_valid_observations, d_ls_pvt->d_HDOP, d_ls_pvt->d_VDOP,
+                    d_ls_pvt->d_TDOP, d_ls_pvt->d_GDOP, EVENT_TO_CONSOLE);
+        }
+}
+
+
+int hybrid_pvt_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
+        gr_vector_const_void_star &input_items, gr_vector_void_star &output_items __attribute__((unused)))
+{
+    GNSS_SDR_TRACE_SCOPE("hybrid_pvt_cc::general_work");
+    d_sample_counter++;
+
+    gnss_pseudoranges_map.clear();
+
+    Gnss_Synchro **in = (Gnss_Synchro **)  &input_items[0]; //Get the input pointer
+
+    print_receiver_status(in);
+
+    // ############ 1. READ PSEUDORANGES ####
+    for (unsigned int i = 0; i < d_nchannels; i++)
+        {
+            if (in[i][0].Flag_valid_pseudorange == true)
+                {
+                    gnss_pseudoranges_map.insert(std::pair<int,Gnss_Synchro>(i, in[i][0])); // store valid pseudoranges in a map.
+                    //d_rx_time = in[i][0].d_TOW_at_current_symbol; // all the channels have the same RX timestamp (common RX time pseudoranges)
+                    d_TOW_at_curr_symbol_constellation = in[i][0].d_TOW_at_current_symbol; // d_TOW_at_current_symbol not corrected by delta t (just for debug)
+                    d_rx_time = in[i][0].d_TOW_hybrid_at_current_symbol; // hybrid rx time, all the channels have the same RX timestamp (common RX time pseudoranges)
+                }
+        }
+
+    // ############ 2 COMPUTE THE PVT ################################
+    // ToDo: relax this condition because the receiver should work even with NO GALILEO SATELLITES
+    //if (gnss_pseudoranges_map.size() > 0 and d_ls_pvt->galileo_ephemeris_map.size() > 0 and d_ls_pvt->gps_ephemeris_map.size() > 0)
+    if (gnss_pseudoranges_map.size() > 0)
+        {
+            // compute on the fly PVT solution, on the solver thread, which
+            // drops this epoch if the next one arrives before it starts
+            if ((d_sample_counter % d_output_rate_ms) == 0)
                 {
-                    std::cout << "Position at " << boost::posix_time::to_simple_string(d_ls_pvt->d_position_UTC_time)
-                    << " UTC using "<< d_ls_pvt->d_valid_observations<<" observations is Lat = " << d_ls_pvt->d_latitude_d << " [deg], Long = " << d_ls_pvt->d_longitude_d
-                    << " [deg], Height= " << d_ls_pvt->d_height_m << " [m]" << std::endl;
-
-                    LOG(INFO) << "Position at " << boost::posix_time::to_simple_string(d_ls_pvt->d_position_UTC_time)
-                    << " UTC using "<< d_ls_pvt->d_valid_observations<<" observations is Lat = " << d_ls_pvt->d_latitude_d << " [deg], Long = " << d_ls_pvt->d_longitude_d
-                    << " [deg], Height= " << d_ls_pvt->d_height_m << " [m]";
-
-                    std::cout << "Dilution of Precision at " << boost::posix_time::to_simple_string(d_ls_pvt->d_position_UTC_time)
-                    << " UTC using "<< d_ls_pvt->d_valid_observations<<" observations is HDOP = " << d_ls_pvt->d_HDOP << " VDOP = "
-                    << d_ls_pvt->d_VDOP <<" TDOP = " << d_ls_pvt->d_TDOP
-                    << " GDOP = " << d_ls_pvt->d_GDOP << std::endl;
+                    d_solver->submit(std::bind(&hybrid_pvt_cc::solve_epoch, this, gnss_pseudoranges_map, d_rx_time, d_sample_counter));
                 }
 
             // MULTIPLEXED FILE RECORDING - Record results to file
@@ -0,0 +1,412 @@
+/*!
+ * \file batch_ls_pvt.cc
+ * \brief Least Squares positions of a window of epochs solved at once, with
+ *  a receiver clock common to the window, for post-processing runs
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "batch_ls_pvt.h"
+#include <algorithm>
+#include <cmath>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include "GPS_L1_CA.h"
+#include "ls_pvt.h"
+#include "pvt_corrections_cache.h"
+#include "pvt_solution.h"
+
+namespace
+{
+// Shared unknowns of a window: clock at the first epoch, drift, offset of the second clock
+const int BATCH_MAX_SHARED = 3;
+}
+
+
+Batch_Ls_Pvt::Batch_Ls_Pvt(unsigned int window_epochs, unsigned int threads, const solution_handler& handler)
+{
+    d_window_epochs = std::max(window_epochs, 1u);
+    d_threads = std::max(threads, 1u);
+    d_handler = handler;
+    d_open = false;
+    d_epoch.rx_time = 0.0;
+    d_epoch.has_initial = false;
+    d_windows = 0;
+}
+
+
+void Batch_Ls_Pvt::begin_epoch(double rx_time)
+{
+    d_open = true;
+    d_epoch.rx_time = rx_time;
+    d_epoch.has_initial = false;
+    d_epoch.satpos.clear();
+    d_epoch.obs.clear();
+    d_epoch.weight.clear();
+    d_epoch.clock.clear();
+}
+
+
+void Batch_Ls_Pvt::add_observation(const double * satpos, double obs, double w, int clock)
+{
+    if (!d_open) return;
+    d_epoch.satpos.insert(d_epoch.satpos.end(), satpos, satpos + 3);
+    d_epoch.obs.push_back(obs);
+    d_epoch.weight.push_back(w);
+    d_epoch.clock.push_back(clock);
+}
+
+
+void Batch_Ls_Pvt::exclude_observation(int i)
+{
+    if (d_open && i >= 0 && i < static_cast<int>(d_epoch.weight.size()))
+        {
+            d_epoch.weight[i] = 0.0;
+        }
+}
+
+
+void Batch_Ls_Pvt::end_epoch(const double * initial)
+{
+    if (!d_open) return;
+    d_open = false;
+    d_epoch.has_initial = (initial != 0);
+    for (int j = 0; j < 4; j++)
+        {
+            d_epoch.initial[j] = initial != 0 ? initial[j] : 0.0;
+        }
+    if (!d_window.empty())
+        {
+            const double gap = d_epoch.rx_time - d_window.back().rx_time;
+            if (gap <= 0.0 || gap > BATCH_LS_PVT_MAX_GAP_S)
+                {
+                    close_window();
+                }
+        }
+    d_window.push_back(d_epoch);
+    if (d_window.size() >= d_window_epochs)
+        {
+            close_window();
+        }
+}
+
+
+void Batch_Ls_Pvt::discard_epoch()
+{
+    d_open = false;
+}
+
+
+void Batch_Ls_Pvt::finish()
+{
+    d_open = false;
+    close_window();
+    solve_pending();
+}
+
+
+void Batch_Ls_Pvt::close_window()
+{
+    if (d_window.empty()) return;
+    d_pending.push_back(std::vector<Epoch>());
+    d_pending.back().swap(d_window);
+    if (d_pending.size() >= d_threads)
+        {
+            solve_pending();
+        }
+}
+
+
+void Batch_Ls_Pvt::solve_pending()
+{
+    std::vector<std::vector<Batch_Ls_Pvt_Solution> > solutions(d_pending.size());
+    if (d_pending.size() == 1)
+        {
+            solve_window(d_pending[0], solutions[0]);
+        }
+    else if (d_pending.size() > 1)
+        {
+            boost::thread_group workers;
+            for (unsigned int w = 0; w < d_pending.size(); w++)
+                {
+                    workers.create_thread(boost::bind(&Batch_Ls_Pvt::solve_window, boost::cref(d_pending[w]), boost::ref(solutions[w])));
+                }
+            workers.join_all();
+        }
+    for (unsigned int w = 0; w < solutions.size(); w++)
+        {
+            for (unsigned int k = 0; k < solutions[w].size(); k++)
+                {
+                    if (d_handler) d_handler(solutions[w][k]);
+                }
+            d_windows++;
+        }
+    d_pending.clear();
+}
+
+
+void Batch_Ls_Pvt::solve_window(const std::vector<Epoch> & window, std::vector<Batch_Ls_Pvt_Solution> & solutions)
+{
+    const int nepochs = window.size();
+    solutions.assign(nepochs, Batch_Ls_Pvt_Solution());
+    for (int k = 0; k < nepochs; k++)
+        {
+            solutions[k].rx_time = window[k].rx_time;
+            solutions[k].valid = false;
+        }
+    if (nepochs == 0) return;
+    const double t0 = window[0].rx_time;
+
+    //=== Initialization =======================================================
+    // Epochs without a solution of their own start from the nearest one
+    std::vector<double> pos(3 * nepochs, 0.0);
+    std::vector<int> has_pos(nepochs, 0);
+    int last = -1;
+    for (int k = 0; k < nepochs; k++)
+        {
+            if (window[k].has_initial) last = k;
+            if (last < 0) continue;
+            std::copy(window[last].initial, window[last].initial + 3, &pos[3 * k]);
+            has_pos[k] = 1;
+        }
+    if (last < 0) return;
+    for (int k = nepochs - 1; k >= 0; k--)
+        {
+            if (window[k].has_initial) last = k;
+            if (has_pos[k]) continue;
+            std::copy(window[last].initial, window[last].initial + 3, &pos[3 * k]);
+        }
+
+    // Clock line through the per-epoch clocks
+    double g[BATCH_MAX_SHARED] = {0.0, 0.0, 0.0};
+    double st = 0.0, st2 = 0.0, sc = 0.0, stc = 0.0;
+    int nclocks = 0;
+    for (int k = 0; k < nepochs; k++)
+        {
+            if (!window[k].has_initial) continue;
+            const double t = window[k].rx_time - t0;
+            st += t;
+            st2 += t * t;
+            sc += window[k].initial[3];
+            stc += t * window[k].initial[3];
+            nclocks++;
+        }
+    const double det = nclocks * st2 - st * st;
+    g[1] = (nclocks > 1 && det > 0.0) ? (nclocks * stc - st * sc) / det : 0.0;
+    g[0] = (sc - g[1] * st) / nclocks;
+
+    // The offset of the second clock is only solved with both systems in the window
+    bool first_system = false;
+    bool second_system = false;
+    int max_obs = 0;
+    std::vector<int> usable(nepochs, 0);
+    for (int k = 0; k < nepochs; k++)
+        {
+            int weighted = 0;
+            for (unsigned int i = 0; i < window[k].obs.size(); i++)
+                {
+                    if (window[k].weight[i] <= 0.0) continue;
+                    weighted++;
+                    if (window[k].clock[i] == 1) second_system = true; else first_system = true;
+                }
+            usable[k] = weighted >= 3 ? 1 : 0;
+            solutions[k].observations = weighted;
+            max_obs = std::max(max_obs, static_cast<int>(window[k].obs.size()));
+        }
+    const int ng = (first_system && second_system) ? 3 : 2;
+
+    //=== Gauss-Newton iterations on the block-arrow normal equations ==========
+    const int nmbOfIterations = 10;
+    std::vector<double> los(3 * max_obs);
+    std::vector<double> az(max_obs);
+    std::vector<double> el(max_obs);
+    std::vector<double> range(max_obs);
+    std::vector<double> trop(max_obs);
+    std::vector<double> L(9 * nepochs);                   // factor of the position block of each epoch
+    std::vector<double> y(3 * nepochs);                   // N_k^-1 u_k
+    std::vector<double> Z(3 * BATCH_MAX_SHARED * nepochs); // N_k^-1 C_k, by columns
+    Pvt_Corrections_Cache corrections;
+    Pvt_Solution geodesy;
+    bool solved = false;
+    for (int iter = 0; iter < nmbOfIterations; iter++)
+        {
+            double S[BATCH_MAX_SHARED * BATCH_MAX_SHARED] = {};  // Schur complement of the clock terms
+            double s[BATCH_MAX_SHARED] = {};
+            int epochs_used = 0;
+            for (int k = 0; k < nepochs; k++)
+                {
+                    if (!usable[k]) continue;
+                    const Epoch & e = window[k];
+                    const int m = e.obs.size();
+                    double * p = &pos[3 * k];
+                    const double t = e.rx_time - t0;
+
+                    //--- Correct satellite positions (due to earth rotation) ------
+                    for (int i = 0; i < m; i++)
+                        {
+                            const double * X = &e.satpos[3 * i];
+                            const double rho2 = (X[0] - p[0]) * (X[0] - p[0]) +
+                                                (X[1] - p[1]) * (X[1] - p[1]) +
+                                                (X[2] - p[2]) * (X[2] - p[2]);
+                            const double omegatau = OMEGA_EARTH_DOT * std::sqrt(rho2) / GPS_C_m_s;
+                            const double cos_omegatau = std::cos(omegatau);
+                            const double sin_omegatau = std::sin(omegatau);
+                            los[3 * i] = cos_omegatau * X[0] + sin_omegatau * X[1] - p[0];
+                            los[3 * i + 1] = -sin_omegatau * X[0] + cos_omegatau * X[1] - p[1];
+                            los[3 * i + 2] = X[2] - p[2];
+                        }
+                    if (corrections.stale(p))
+                        {
+                            double dphi, dlambda, h;
+                            geodesy.togeod(&dphi, &dlambda, &h, 6378137.0, 298.257223563, p[0], p[1], p[2]);
+                            corrections.set_receiver(p, dphi, dlambda, h);
+                        }
+                    corrections.evaluate(los.data(), m, az.data(), el.data(), range.data(), trop.data());
+
+                    //--- Normal equations of the epoch ----------------------------
+                    double N[9] = {};
+                    double C[3 * BATCH_MAX_SHARED] = {};  // row-major, 3 x ng
+                    double u[3] = {};
+                    double G[BATCH_MAX_SHARED * BATCH_MAX_SHARED] = {};
+                    double v[BATCH_MAX_SHARED] = {};
+                    for (int i = 0; i < m; i++)
+                        {
+                            const double w2 = e.weight[i] * e.weight[i];
+                            if (w2 <= 0.0) continue;
+                            const bool second_clock = (ng == 3 && e.clock[i] == 1);
+                            const double tr = trop[i] > 50.0 ? 0.0 : trop[i];
+                            const double omc = e.obs[i] - range[i] - g[0] - g[1] * t - (second_clock ? g[2] : 0.0) - tr;
+                            double a[3];
+                            for (int j = 0; j < 3; j++)
+                                {
+                                    a[j] = -los[3 * i + j] / range[i];
+                                }
+                            const double b[BATCH_MAX_SHARED] = {1.0, t, second_clock ? 1.0 : 0.0};
+                            for (int j = 0; j < 3; j++)
+                                {
+                                    u[j] += w2 * a[j] * omc;
+                                    for (int l = 0; l <= j; l++)
+                                        {
+                                            N[j * 3 + l] += w2 * a[j] * a[l];
+                                        }
+                                    for (int l = 0; l < ng; l++)
+                                        {
+                                            C[j * ng + l] += w2 * a[j] * b[l];
+                                        }
+                                }
+                            for (int j = 0; j < ng; j++)
+                                {
+                                    v[j] += w2 * b[j] * omc;
+                                    for (int l = 0; l < ng; l++)
+                                        {
+                                            G[j * ng + l] += w2 * b[j] * b[l];
+                                        }
+                                }
+                        }
+
+                    //--- Eliminate the position of the epoch ----------------------
+                    double * Lk = &L[9 * k];
+                    std::copy(N, N + 9, Lk);
+                    if (!Ls_Pvt::cholesky_decompose(Lk, 3))
+                        {
+                            usable[k] = 0;
+                            continue;
+                        }
+                    double * yk = &y[3 * k];
+                    std::copy(u, u + 3, yk);
+                    Ls_Pvt::cholesky_solve(Lk, yk, 3);
+                    double * Zk = &Z[3 * BATCH_MAX_SHARED * k];
+                    for (int l = 0; l < ng; l++)
+                        {
+                            double * z = &Zk[3 * l];
+                            for (int j = 0; j < 3; j++)
+                                {
+                                    z[j] = C[j * ng + l];
+                                }
+                            Ls_Pvt::cholesky_solve(Lk, z, 3);
+                        }
+                    for (int j = 0; j < ng; j++)
+                        {
+                            double cy = 0.0;
+                            for (int r = 0; r < 3; r++)
+                                {
+                                    cy += C[r * ng + j] * yk[r];
+                                }
+                            s[j] += v[j] - cy;
+                            for (int l = 0; l <= j; l++)
+                                {
+                                    double cz = 0.0;
+                                    for (int r = 0; r < 3; r++)
+                                        {
+                                            cz += C[r * ng + j] * Zk[3 * l + r];
+                                        }
+                                    S[j * ng + l] += G[j * ng + l] - cz;
+                                }
+                        }
+                    epochs_used++;
+                }
+
+            //--- Clock terms, then the positions ----------------------------------
+            solved = epochs_used > 0 && Ls_Pvt::cholesky_decompose(S, ng);
+            if (!solved) break;
+            Ls_Pvt::cholesky_solve(S, s, ng);
+            double norm_x = 0.0;
+            for (int j = 0; j < ng; j++)
+                {
+                    g[j] += s[j];
+                    norm_x = std::max(norm_x, std::fabs(s[j]));
+                }
+            for (int k = 0; k < nepochs; k++)
+                {
+                    if (!usable[k]) continue;
+                    const double * Zk = &Z[3 * BATCH_MAX_SHARED * k];
+                    for (int r = 0; r < 3; r++)
+                        {
+                            double dx = y[3 * k + r];
+                            for (int l = 0; l < ng; l++)
+                                {
+                                    dx -= Zk[3 * l + r] * s[l];
+                                }
+                            pos[3 * k + r] += dx;
+                            norm_x = std::max(norm_x, std::fabs(dx));
+                        }
+                }
+            if (norm_x < 1e-4)
+                {
+                    break;
+                }
+        }
+
+    for (int k = 0; k < nepochs; k++)
+        {
+            Batch_Ls_Pvt_Solution & sol = solutions[k];
+            std::copy(&pos[3 * k], &pos[3 * k] + 3, sol.pos);
+            sol.clock_m = g[0] + g[1] * (window[k].rx_time - t0);
+            sol.clock_drift_m_s = g[1];
+            sol.isb_m = ng == 3 ? g[2] : 0.0;
+            sol.valid = solved && usable[k];
+        }
+}
@@ -0,0 +1,154 @@
+/*!
+ * \file batch_ls_pvt.h
+ * \brief Least Squares positions of a window of epochs solved at once, with
+ *  a receiver clock common to the window, for post-processing runs
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_BATCH_LS_PVT_H_
+#define GNSS_SDR_BATCH_LS_PVT_H_
+
+#include <functional>
+#include <vector>
+
+//! Longest time between two epochs of the same window [s]
+#define BATCH_LS_PVT_MAX_GAP_S 10.0
+
+//! Position of an epoch of a window
+struct Batch_Ls_Pvt_Solution
+{
+    double rx_time;          //!< Receiver time of the epoch [s]
+    double pos[3];           //!< Receiver ECEF position [m]
+    double clock_m;          //!< Receiver clock offset at rx_time [m]
+    double clock_drift_m_s;  //!< Receiver clock drift of the window [m/s]
+    double isb_m;            //!< Offset of the clock of the second system [m], 0 if not solved
+    int observations;        //!< Observations used
+    bool valid;
+};
+
+
+/*!
+ * \brief Receiver positions of the epochs of a window, solved together.
+ *
+ * Each epoch keeps its own position, while the receiver clock follows a
+ * straight line over the window, c(t) = c0 + drift (t - t0), plus the
+ * offset of a second system if there is one. The window has 3 unknowns per
+ * epoch and at most 3 shared ones, instead of 4 or 5 per epoch, so epochs
+ * with only three satellites are solved too, and the clock noise of the
+ * per-epoch fixes no longer reaches the positions. The clock model holds
+ * for windows shorter than the stability of the receiver oscillator.
+ *
+ * The normal matrix of a window is block-arrow shaped: a 3x3 block per
+ * epoch, coupled only through the clock terms. Each Gauss-Newton iteration
+ * factors the epoch blocks, reduces the clock terms to their Schur
+ * complement, solves it and substitutes back, so it costs O(epochs) instead
+ * of O(epochs^3). The Earth rotation and the troposphere are corrected as
+ * in Ls_Pvt::leastSquarePos().
+ *
+ * Epochs are stored with begin_epoch(), add_observation() and end_epoch().
+ * A window ends after window_epochs epochs, or at a gap longer than
+ * BATCH_LS_PVT_MAX_GAP_S. Once threads windows are complete, they are
+ * solved in parallel, one thread each, and their solutions are given to
+ * the handler in epoch order, in the thread that stored the last epoch.
+ * finish() solves the remaining epochs.
+ */
+class Batch_Ls_Pvt
+{
+public:
+    typedef std::function<void(const Batch_Ls_Pvt_Solution&)> solution_handler;
+
+    Batch_Ls_Pvt(unsigned int window_epochs, unsigned int threads, const solution_handler& handler);
+
+    //! Starts an epoch at the receiver time rx_time [s]. An epoch not ended is discarded.
+    void begin_epoch(double rx_time);
+
+    /*!
+     * \brief Adds an observation to the epoch
+     *
+     * \param[in] satpos  Satellite position in ECEF system [m]
+     * \param[in] obs     Pseudorange corrected with the satellite clock [m]
+     * \param[in] w       Weight, as in Ls_Pvt::add_observation()
+     * \param[in] clock   Receiver clock of the observation: 0, or 1 for the second system
+     */
+    void add_observation(const double * satpos, double obs, double w, int clock);
+
+    //! Leaves out the observation i of the epoch, e.g. excluded by RAIM
+    void exclude_observation(int i);
+
+    /*!
+     * \brief Stores the epoch
+     *
+     * \param[in] initial  Per-epoch solution [X, Y, Z, dt] [m] the window
+     *                     starts from, or 0 to start from the nearest epoch
+     *                     of the window that has one
+     */
+    void end_epoch(const double * initial);
+
+    //! Drops the epoch
+    void discard_epoch();
+
+    //! Solves the stored epochs, including an incomplete window
+    void finish();
+
+    //! Windows solved
+    unsigned long long windows() const
+    {
+        return d_windows;
+    }
+
+    struct Epoch
+    {
+        double rx_time;
+        double initial[4];
+        bool has_initial;
+        std::vector<double> satpos;  // X, Y, Z of each observation [m]
+        std::vector<double> obs;
+        std::vector<double> weight;
+        std::vector<int> clock;
+    };
+
+    /*!
+     * \brief Solves a window of epochs, which must have at least one initial
+     * solution. solutions gets one element per epoch.
+     */
+    static void solve_window(const std::vector<Epoch> & window, std::vector<Batch_Ls_Pvt_Solution> & solutions);
+
+private:
+    void close_window();
+    void solve_pending();
+
+    unsigned int d_window_epochs;
+    unsigned int d_threads;
+    solution_handler d_handler;
+    bool d_open;                              // an epoch has begun and not ended
+    Epoch d_epoch;
+    std::vector<Epoch> d_window;
+    std::vector<std::vector<Epoch> > d_pending;  // complete windows not solved yet
+    unsigned long long d_windows;
+};
+
+#endif /* GNSS_SDR_BATCH_LS_PVT_H_ */
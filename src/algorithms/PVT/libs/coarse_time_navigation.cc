@@ -0,0 +1,218 @@
+/*!
+ * \file coarse_time_navigation.cc
+ * \brief Position and time of a snapshot of a few milliseconds of signal,
+ * from the code phases and the ephemeris (coarse-time navigation)
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "coarse_time_navigation.h"
+#include <cmath>
+#include <glog/logging.h>
+#include "ls_pvt.h"
+#include "gnss_sdr_trace.h"
+
+using google::LogMessage;
+
+namespace
+{
+const int MAX_ITERATIONS = 20;
+const double CONVERGENCE_M = 1e-3;
+}
+
+
+Coarse_Time_Navigation::Coarse_Time_Navigation(double code_period_s)
+{
+    d_code_period_s = code_period_s;
+    d_tow_s = 0.0;
+    d_time_offset_s = 0.0;
+    d_residual_rms_m = 0.0;
+}
+
+
+void Coarse_Time_Navigation::clear_observations()
+{
+    d_ephemeris.clear();
+    d_code_phase_s.clear();
+}
+
+
+void Coarse_Time_Navigation::add_observation(const Gps_Ephemeris & ephemeris, double code_phase_s)
+{
+    d_ephemeris.push_back(ephemeris);
+    d_code_phase_s.push_back(code_phase_s);
+}
+
+
+double Coarse_Time_Navigation::predict(int i, const double * pos, double tow_s, double * los, double & range_rate)
+{
+    Gps_Ephemeris & eph = d_ephemeris[i];
+    // The code period starts at tow_s + code phase, and left the satellite one travel time before
+    const double rx_time = tow_s + d_code_phase_s[i];
+    double travel_time = GPS_STARTOFFSET_ms / 1000.0;
+    double sat[3] = {0.0, 0.0, 0.0};
+    double sv_clock_s = 0.0;
+    double range = 0.0;
+    for (int k = 0; k < 3; k++)
+        {
+            double tx_time = rx_time - travel_time;
+            sv_clock_s = eph.sv_clock_drift(tx_time);
+            eph.satellitePosition(tx_time - sv_clock_s);
+            // Earth rotation during the travel time
+            const double omegatau = OMEGA_EARTH_DOT * travel_time;
+            sat[0] = std::cos(omegatau) * eph.d_satpos_X + std::sin(omegatau) * eph.d_satpos_Y;
+            sat[1] = -std::sin(omegatau) * eph.d_satpos_X + std::cos(omegatau) * eph.d_satpos_Y;
+            sat[2] = eph.d_satpos_Z;
+            range = std::sqrt((sat[0] - pos[0]) * (sat[0] - pos[0]) + (sat[1] - pos[1]) * (sat[1] - pos[1])
+                    + (sat[2] - pos[2]) * (sat[2] - pos[2]));
+            travel_time = range / GPS_C_m_s;
+        }
+    for (int j = 0; j < 3; j++)
+        {
+            los[j] = (sat[j] - pos[j]) / range;
+        }
+
+    // Range rate from the satellite positions one second apart, in the same frame
+    const double omegatau = OMEGA_EARTH_DOT * travel_time;
+    eph.satellitePosition(rx_time - travel_time - sv_clock_s + 1.0);
+    const double later[3] = {std::cos(omegatau) * eph.d_satpos_X + std::sin(omegatau) * eph.d_satpos_Y,
+            -std::sin(omegatau) * eph.d_satpos_X + std::cos(omegatau) * eph.d_satpos_Y,
+            eph.d_satpos_Z};
+    range_rate = 0.0;
+    for (int j = 0; j < 3; j++)
+        {
+            range_rate += los[j] * (later[j] - sat[j]);
+        }
+    return range - GPS_C_m_s * sv_clock_s;
+}
+
+
+bool Coarse_Time_Navigation::solve(const double * approx_pos_m, double approx_tow_s)
+{
+    GNSS_SDR_TRACE_SCOPE("Coarse_Time_Navigation::solve");
+    b_valid_position = false;
+    const int n = num_observations();
+    if (n < 4)
+        {
+            return false;
+        }
+    const int unknowns = (n >= 5) ? 5 : 4;
+    const double code_length_m = d_code_period_s * GPS_C_m_s;
+
+    double pos[3] = {approx_pos_m[0], approx_pos_m[1], approx_pos_m[2]};
+    double tow_s = approx_tow_s;
+    double clock_m = 0.0;
+    std::vector<double> los(3 * n);
+    std::vector<double> range_rate(n);
+    std::vector<double> predicted(n);
+
+    // Integer code periods: the one of the highest satellite puts its pseudorange
+    // next to its predicted range, and the others follow the predicted differences
+    // (the geocentric vertical is close enough to rank the elevations)
+    const double pos_norm = std::sqrt(pos[0] * pos[0] + pos[1] * pos[1] + pos[2] * pos[2]);
+    int reference = 0;
+    double reference_sin_el = -2.0;
+    for (int i = 0; i < n; i++)
+        {
+            predicted[i] = predict(i, pos, tow_s, &los[3 * i], range_rate[i]);
+            const double sin_el = (los[3 * i] * pos[0] + los[3 * i + 1] * pos[1] + los[3 * i + 2] * pos[2]) / pos_norm;
+            if (sin_el > reference_sin_el)
+                {
+                    reference_sin_el = sin_el;
+                    reference = i;
+                }
+        }
+    std::vector<double> pseudorange(n);
+    const double reference_fraction_m = d_code_phase_s[reference] * GPS_C_m_s;
+    const double reference_periods = std::round((predicted[reference] - reference_fraction_m) / code_length_m);
+    for (int i = 0; i < n; i++)
+        {
+            const double fraction_m = d_code_phase_s[i] * GPS_C_m_s;
+            const double periods = reference_periods + std::round(((predicted[i] - predicted[reference]) - (fraction_m - reference_fraction_m)) / code_length_m);
+            pseudorange[i] = fraction_m + periods * code_length_m;
+        }
+
+    // Gauss-Newton on position, clock and time
+    bool converged = false;
+    std::vector<double> residual(n);
+    for (int iteration = 0; iteration < MAX_ITERATIONS && !converged; iteration++)
+        {
+            double N[25] = {};
+            double b[5] = {};
+            for (int i = 0; i < n; i++)
+                {
+                    if (iteration > 0)
+                        {
+                            predicted[i] = predict(i, pos, tow_s, &los[3 * i], range_rate[i]);
+                        }
+                    residual[i] = pseudorange[i] - predicted[i] - clock_m;
+                    const double h[5] = {-los[3 * i], -los[3 * i + 1], -los[3 * i + 2], 1.0, range_rate[i]};
+                    for (int r = 0; r < unknowns; r++)
+                        {
+                            b[r] += h[r] * residual[i];
+                            for (int c = 0; c <= r; c++)
+                                {
+                                    N[r * unknowns + c] += h[r] * h[c];
+                                }
+                        }
+                }
+            if (!Ls_Pvt::cholesky_decompose(N, unknowns))
+                {
+                    DLOG(INFO) << "Singular geometry in the coarse-time solution";
+                    return false;
+                }
+            Ls_Pvt::cholesky_solve(N, b, unknowns);
+            for (int j = 0; j < 3; j++)
+                {
+                    pos[j] += b[j];
+                }
+            clock_m += b[3];
+            double time_step_m = 0.0;
+            if (unknowns == 5)
+                {
+                    tow_s += b[4];
+                    time_step_m = std::fabs(b[4]) * 1000.0;  // about the fastest range rate
+                }
+            converged = std::sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2]) + std::fabs(b[3]) + time_step_m < CONVERGENCE_M;
+        }
+
+    double sum2 = 0.0;
+    for (int i = 0; i < n; i++)
+        {
+            sum2 += residual[i] * residual[i];
+        }
+    d_residual_rms_m = std::sqrt(sum2 / static_cast<double>(n));
+    d_tow_s = tow_s;
+    d_time_offset_s = tow_s - approx_tow_s;
+    d_rx_dt_m = clock_m / GPS_C_m_s;
+    d_valid_observations = n;
+    cart2geo(pos[0], pos[1], pos[2], 4);
+    DLOG(INFO) << "Coarse-time solution of " << n << " satellites: " << d_latitude_d << ", " << d_longitude_d
+               << ", " << d_height_m << " [m], time offset " << d_time_offset_s << " [s], residual RMS "
+               << d_residual_rms_m << " [m]";
+    b_valid_position = converged && d_residual_rms_m < COARSE_TIME_MAX_RESIDUAL_M;
+    return b_valid_position;
+}
@@ -0,0 +1,121 @@
+/*!
+ * \file coarse_time_navigation.h
+ * \brief Position and time of a snapshot of a few milliseconds of signal,
+ * from the code phases and the ephemeris (coarse-time navigation)
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The code phases of a snapshot only give the pseudoranges modulo one code
+ * period (about 300 km for GPS L1 C/A), and the time of transmission is
+ * not decoded. The integer number of code periods of each satellite is
+ * taken from the ranges predicted at an approximate position and time, and
+ * the error of that time is solved as a fifth unknown, through the range
+ * rates of the satellites:
+ *
+ * F. van Diggelen, A-GPS: Assisted GPS, GNSS, and SBAS, Artech House, 2009,
+ * chapter 4.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_COARSE_TIME_NAVIGATION_H_
+#define GNSS_SDR_COARSE_TIME_NAVIGATION_H_
+
+#include <vector>
+#include "GPS_L1_CA.h"
+#include "gps_ephemeris.h"
+#include "pvt_solution.h"
+
+//! Largest post-fit residual RMS of a valid solution, above which an integer is taken as wrong [m]
+#define COARSE_TIME_MAX_RESIDUAL_M 500.0
+
+/*!
+ * \brief Coarse-time navigation solution of GPS L1 C/A code phases
+ *
+ * The approximate position must be within about 100 km of the receiver,
+ * and the approximate time within about a minute, so that the predicted
+ * ranges fix the integer code periods. With five or more satellites the
+ * time is solved along with the position and the receiver clock; with four,
+ * the time is taken as exact.
+ */
+class Coarse_Time_Navigation : public Pvt_Solution
+{
+public:
+    Coarse_Time_Navigation(double code_period_s = GPS_L1_CA_CODE_PERIOD);
+
+    void clear_observations();
+
+    /*!
+     * \brief Adds a satellite of the snapshot
+     * \param[in] ephemeris     Ephemeris of the satellite
+     * \param[in] code_phase_s  Time from the first sample of the snapshot to the
+     *                          start of a code period of the satellite, in [0, code period) [s]
+     */
+    void add_observation(const Gps_Ephemeris & ephemeris, double code_phase_s);
+
+    int num_observations() const
+    {
+        return static_cast<int>(d_ephemeris.size());
+    }
+
+    /*!
+     * \brief Solves the position, the receiver clock and the time of the snapshot
+     * \param[in] approx_pos_m   Approximate ECEF position of the receiver [m]
+     * \param[in] approx_tow_s   Approximate GPS time of week of the first sample [s]
+     * \return true if the solution converged with consistent residuals
+     */
+    bool solve(const double * approx_pos_m, double approx_tow_s);
+
+    //! GPS time of week of the first sample of the snapshot [s]
+    double tow_s() const
+    {
+        return d_tow_s;
+    }
+
+    //! Correction of the approximate time given to solve() [s]
+    double time_offset_s() const
+    {
+        return d_time_offset_s;
+    }
+
+    //! Post-fit residual RMS [m]
+    double residual_rms_m() const
+    {
+        return d_residual_rms_m;
+    }
+
+private:
+    // Pseudorange of observation i without the receiver clock, and its
+    // derivatives with respect to the position and the time
+    double predict(int i, const double * pos, double tow_s, double * los, double & range_rate);
+
+    double d_code_period_s;
+    std::vector<Gps_Ephemeris> d_ephemeris;
+    std::vector<double> d_code_phase_s;
+    double d_tow_s;
+    double d_time_offset_s;
+    double d_residual_rms_m;
+};
+
+#endif
@@ -35,12 +35,16 @@
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include "ls_pvt.h"
+#include "binary_dump_writer.h"
 #include "galileo_navigation_message.h"
+#include "gnss_nav_data_store.h"
 #include "gnss_synchro.h"
 #include "galileo_ephemeris.h"
 #include "galileo_utc_model.h"
+#include "satellite_orbit_batch.h"
 
 
 /*!
@@ -57,10 +61,8 @@ public:
     int d_nchannels;  //!< Number of available channels for positioning
 
     Galileo_Navigation_Message* d_ephemeris;
-    std::map<int,Galileo_Ephemeris> galileo_ephemeris_map; //!< Map storing new Galileo_Ephemeris
-    Galileo_Utc_Model galileo_utc_model;
-    Galileo_Iono galileo_iono;
-    Galileo_Almanac galileo_almanac;
+    // navigation data used by get_PVT, a snapshot of Gnss_Nav_Data_Store set by the PVT block
+    std::shared_ptr<const Gnss_Nav_Data> nav_data;
 
     double d_galileo_current_time;
 
@@ -68,7 +70,10 @@ public:
     bool d_flag_averaging;
 
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Binary_Dump_Writer d_dump_file;
+
+private:
+    Satellite_Orbit_Batch d_orbits;  // orbits and clocks of the satellites of an epoch
 };
 
 #endif
@@ -31,12 +31,13 @@
 
 
 #include "geojson_printer.h"
+#include "gnss_sdr_trace.h"
+#include <algorithm>
 #include <ctime>
-#include <iomanip>
 #include <sstream>
 #include <glog/logging.h>
 
-GeoJSON_Printer::GeoJSON_Printer()
+GeoJSON_Printer::GeoJSON_Printer(double flush_interval_s) : geojson_file(flush_interval_s)
 {
     first_pos = true;
 }
@@ -99,29 +100,21 @@ bool GeoJSON_Printer::set_headers(std::string filename, bool time_tag_name)
             filename_ = filename + ".geojson";
         }
 
-    geojson_file.open(filename_.c_str());
-
     first_pos = true;
-    if (geojson_file.is_open())
+    std::stringstream header;
+    header << "{" << std::endl;
+    header << "  \"type\":  \"Feature\"," << std::endl;
+    header << "  \"properties\": {" << std::endl;
+    header << "       \"name\": \"Locations generated by GNSS-SDR\" " << std::endl;
+    header << "   }," << std::endl;
+    header << "  \"geometry\": {" << std::endl;
+    header << "      \"type\": \"MultiPoint\"," << std::endl;
+    header << "      \"coordinates\": [" << std::endl;
+    const std::string trailer = "\n       ]\n   }\n}\n";
+
+    if (geojson_file.open(filename_, header.str(), trailer))
         {
             DLOG(INFO) << "GeoJSON printer writing on " << filename.c_str();
-
-            // Set iostream numeric format and precision
-            geojson_file.setf(geojson_file.fixed, geojson_file.floatfield);
-            geojson_file << std::setprecision(14);
-
-            // Writing the header
-            geojson_file << "{" << std::endl;
-            geojson_file << "  \"type\":  \"Feature\"," << std::endl;
-            geojson_file << "  \"properties\": {" << std::endl;
-            geojson_file << "       \"name\": \"Locations generated by GNSS-SDR\" " << std::endl;
-            geojson_file << "   }," << std::endl;
-
-
-            geojson_file << "  \"geometry\": {" << std::endl;
-            geojson_file << "      \"type\": \"MultiPoint\"," << std::endl;
-            geojson_file << "      \"coordinates\": [" << std::endl;
-
             return true;
         }
     else
@@ -134,6 +127,7 @@ bool GeoJSON_Printer::set_headers(std::string filename, bool time_tag_name)
 
 bool GeoJSON_Printer::print_position(const std::shared_ptr<Pvt_Solution>& position, bool print_average_values)
 {
+    GNSS_SDR_TRACE_SCOPE("GeoJSON_Printer::print_position");
     double latitude;
     double longitude;
     double height;
@@ -155,16 +149,22 @@ bool GeoJSON_Printer::print_position(const std::shared_ptr<Pvt_Solution>& positi
 
     if (geojson_file.is_open())
         {
-            if (first_pos == true)
-                {
-                    geojson_file << "       [" << longitude << ", " << latitude << ", " << height << "]";
-                    first_pos = false;
-                }
-            else
+            char line[160];
+            char * end = line;
+            if (first_pos == false)
                 {
-                    geojson_file << "," << std::endl;
-                    geojson_file << "       [" << longitude << ", " << latitude << ", " << height << "]";
+                    *end++ = ',';
+                    *end++ = '\n';
                 }
+            first_pos = false;
+            end = std::copy_n("       [", 8, end);
+            end = Track_File_Writer::format_fixed(end, longitude, 14);
+            end = std::copy_n(", ", 2, end);
+            end = Track_File_Writer::format_fixed(end, latitude, 14);
+            end = std::copy_n(", ", 2, end);
+            end = Track_File_Writer::format_fixed(end, height, 14);
+            *end++ = ']';
+            geojson_file.append(std::string(line, end));
             return true;
         }
     else
@@ -179,10 +179,7 @@ bool GeoJSON_Printer::close_file()
 {
     if (geojson_file.is_open())
         {
-            geojson_file << std::endl;
-            geojson_file << "       ]" << std::endl;
-            geojson_file << "   }" << std::endl;
-            geojson_file << "}" << std::endl;
+            // the closing brackets are already in the file
             geojson_file.close();
 
             // if nothing is written, erase the file
@@ -33,29 +33,37 @@
 #ifndef GNSS_SDR_GEOJSON_PRINTER_H_
 #define GNSS_SDR_GEOJSON_PRINTER_H_
 
-#include <fstream>
 #include <memory>
 #include <string>
 #include "pvt_solution.h"
+#include "track_file_writer.h"
 
 
 /*!
  * \brief Prints PVT solutions in GeoJSON format file
  *
  * See http://geojson.org/geojson-spec.html
+ *
+ * The positions are written every flush_interval_s seconds, each time
+ * followed by the closing brackets, so the file is valid if the receiver
+ * stops without closing it.
  */
 class GeoJSON_Printer
 {
 private:
-    std::ofstream geojson_file;
+    Track_File_Writer geojson_file;
     bool first_pos;
     std::string filename_;
 public:
-    GeoJSON_Printer();
+    GeoJSON_Printer(double flush_interval_s = TRACK_FILE_FLUSH_INTERVAL_S);
     ~GeoJSON_Printer();
     bool set_headers(std::string filename, bool time_tag_name = true);
     bool print_position(const std::shared_ptr<Pvt_Solution>& position, bool print_average_values);
     bool close_file();
+    std::string get_filename() const
+    {
+        return filename_;
+    }
 };
 
 #endif
@@ -30,6 +30,7 @@
 
 
 #include "gps_l1_ca_ls_pvt.h"
+#include "gnss_sdr_trace.h"
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
@@ -37,7 +38,7 @@
 using google::LogMessage;
 
 
-gps_l1_ca_ls_pvt::gps_l1_ca_ls_pvt(int nchannels, std::string dump_filename, bool flag_dump_to_file) : Ls_Pvt()
+gps_l1_ca_ls_pvt::gps_l1_ca_ls_pvt(int nchannels, std::string dump_filename, bool flag_dump_to_file) : Ls_Pvt(nchannels), d_dump_file("gps_l1_ca_ls_pvt")
 {
     // init empty ephemeris for all the available GNSS channels
     d_nchannels = nchannels;
@@ -46,22 +47,25 @@ gps_l1_ca_ls_pvt::gps_l1_ca_ls_pvt(int nchannels, std::string dump_filename, boo
     d_flag_dump_enabled = flag_dump_to_file;
     d_flag_averaging = false;
     d_GPS_current_time = 0;
+    nav_data = std::make_shared<Gnss_Nav_Data>();
 
     // ############# ENABLE DATA FILE LOG #################
     if (d_flag_dump_enabled == true)
         {
             if (d_dump_file.is_open() == false)
                 {
-                    try
-                    {
-                            d_dump_file.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-                            d_dump_file.open(d_dump_filename.c_str(), std::ios::out | std::ios::binary);
+                    d_dump_file.add_field("time_s", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("x_m", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("y_m", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("z_m", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("clock_offset", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("latitude_deg", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("longitude_deg", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("height_m", BINARY_DUMP_FLOAT64);
+                    if (d_dump_file.open(d_dump_filename))
+                        {
                             LOG(INFO) << "PVT lib dump enabled Log file: " << d_dump_filename.c_str();
-                    }
-                    catch (const std::ifstream::failure &e)
-                    {
-                            LOG(WARNING) << "Exception opening PVT lib dump file " << e.what();
-                    }
+                        }
                 }
         }
 }
@@ -78,13 +82,13 @@ gps_l1_ca_ls_pvt::~gps_l1_ca_ls_pvt()
 
 bool gps_l1_ca_ls_pvt::get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map, double GPS_current_time, bool flag_averaging)
 {
+    GNSS_SDR_TRACE_SCOPE("gps_l1_ca_ls_pvt::get_PVT");
+    const std::map<int,Gps_Ephemeris> & gps_ephemeris_map = nav_data->gps_ephemeris_map;
+    Gps_Utc_Model gps_utc_model = nav_data->gps_utc_model;
     std::map<int,Gnss_Synchro>::iterator gnss_pseudoranges_iter;
-    std::map<int,Gps_Ephemeris>::iterator gps_ephemeris_iter;
-    int valid_pseudoranges = gnss_pseudoranges_map.size();
-
-    arma::mat W = arma::eye(valid_pseudoranges, valid_pseudoranges); //channels weights matrix
-    arma::vec obs = arma::zeros(valid_pseudoranges);                 // pseudoranges observation vector
-    arma::mat satpos = arma::zeros(3, valid_pseudoranges);           //satellite positions matrix
+    std::map<int,Gps_Ephemeris>::const_iterator gps_ephemeris_iter;
+    double satpos[3];   // satellite position
+    double obs;         // corrected pseudorange
 
     int GPS_week = 0;
     double utc = 0;
@@ -97,7 +101,10 @@ bool gps_l1_ca_ls_pvt::get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map,
     // ****** PREPARE THE LEAST SQUARES DATA (SV POSITIONS MATRIX AND OBS VECTORS) ****
     // ********************************************************************************
     int valid_obs = 0; //valid observations counter
-    int obs_counter = 0;
+    clear_observations();
+    const Gps_Ephemeris * ephemeris[SATELLITE_ORBIT_BATCH_SIZE];
+    const Gnss_Synchro * observation[SATELLITE_ORBIT_BATCH_SIZE];
+    d_orbits.clear();
     for(gnss_pseudoranges_iter = gnss_pseudoranges_map.begin();
             gnss_pseudoranges_iter != gnss_pseudoranges_map.end();
             gnss_pseudoranges_iter++)
@@ -106,52 +113,59 @@ bool gps_l1_ca_ls_pvt::get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map,
             gps_ephemeris_iter = gps_ephemeris_map.find(gnss_pseudoranges_iter->first);
             if (gps_ephemeris_iter != gps_ephemeris_map.end())
                 {
-                    /*!
-                     * \todo Place here the satellite CN0 (power level, or weight factor)
-                     */
-                    W(obs_counter, obs_counter) = 1;
-
                     // COMMON RX TIME PVT ALGORITHM MODIFICATION (Like RINEX files)
                     // first estimate of transmit time
                     double Rx_time = GPS_current_time;
                     double Tx_time = Rx_time - gnss_pseudoranges_iter->second.Pseudorange_m / GPS_C_m_s;
-
-                    // 2- compute the clock drift using the clock model (broadcast) for this SV, including relativistic effect
-                    SV_clock_bias_s = gps_ephemeris_iter->second.sv_clock_drift(Tx_time); //- gps_ephemeris_iter->second.d_TGD;
-
-                    // 3- compute the current ECEF position for this SV using corrected TX time
-                    TX_time_corrected_s = Tx_time - SV_clock_bias_s;
-                    gps_ephemeris_iter->second.satellitePosition(TX_time_corrected_s);
-
-                    satpos(0, obs_counter) = gps_ephemeris_iter->second.d_satpos_X;
-                    satpos(1, obs_counter) = gps_ephemeris_iter->second.d_satpos_Y;
-                    satpos(2, obs_counter) = gps_ephemeris_iter->second.d_satpos_Z;
-
-                    // 4- fill the observations vector with the corrected pseudoranges
-                    obs(obs_counter) = gnss_pseudoranges_iter->second.Pseudorange_m + SV_clock_bias_s * GPS_C_m_s;
-                    d_visible_satellites_IDs[valid_obs] = gps_ephemeris_iter->second.i_satellite_PRN;
-                    d_visible_satellites_CN0_dB[valid_obs] = gnss_pseudoranges_iter->second.CN0_dB_hz;
-                    valid_obs++;
-
-                    // SV ECEF DEBUG OUTPUT
-                    DLOG(INFO) << "(new)ECEF satellite SV ID=" << gps_ephemeris_iter->second.i_satellite_PRN
-                            << " X=" << gps_ephemeris_iter->second.d_satpos_X
-                            << " [m] Y=" << gps_ephemeris_iter->second.d_satpos_Y
-                            << " [m] Z=" << gps_ephemeris_iter->second.d_satpos_Z
-                            << " [m] PR_obs=" << obs(obs_counter) << " [m]";
-
-                    // compute the UTC time for this SV (just to print the associated UTC timestamp)
-                    GPS_week = gps_ephemeris_iter->second.i_GPS_week;
-                    utc = gps_utc_model.utc_time(TX_time_corrected_s, GPS_week);
+                    if (!d_orbits.add(gps_ephemeris_iter->second, Tx_time))
+                        {
+                            DLOG(INFO) << "No room for the orbit of SV " << gnss_pseudoranges_iter->first;
+                            continue;
+                        }
+                    ephemeris[d_orbits.size() - 1] = &gps_ephemeris_iter->second;
+                    observation[d_orbits.size() - 1] = &gnss_pseudoranges_iter->second;
                 }
             else // the ephemeris are not available for this SV
                 {
                     // no valid pseudorange for the current SV
-                    W(obs_counter, obs_counter) = 0; // SV de-activated
-                    obs(obs_counter) = 1;            // to avoid algorithm problems (divide by zero)
                     DLOG(INFO) << "No ephemeris data for SV " << gnss_pseudoranges_iter->first;
                 }
-            obs_counter++;
+        }
+
+    // 2- compute the clock drift using the clock model (broadcast) of all the SVs, including relativistic effect,
+    // and their ECEF positions at the corrected TX times
+    d_orbits.compute();
+    for (unsigned int k = 0; k < d_orbits.size(); k++)
+        {
+            const Gps_Ephemeris & gps_ephemeris = *ephemeris[k];
+            SV_clock_bias_s = d_orbits.clock_bias_s(k); //- gps_ephemeris.d_TGD;
+            TX_time_corrected_s = d_orbits.corrected_transmit_time_s(k);
+            d_orbits.position(k, satpos);
+
+            // 3- fill the observations vector with the corrected pseudoranges
+            obs = observation[k]->Pseudorange_m + SV_clock_bias_s * GPS_C_m_s;
+            /*!
+             * \todo Place here the satellite CN0 (power level, or weight factor)
+             */
+            if (!add_observation(satpos, 0, obs, 0.0, 1.0, 0))
+                {
+                    DLOG(INFO) << "No room for the observation of SV " << gps_ephemeris.i_satellite_PRN;
+                    continue;
+                }
+            d_visible_satellites_IDs[valid_obs] = gps_ephemeris.i_satellite_PRN;
+            d_visible_satellites_CN0_dB[valid_obs] = observation[k]->CN0_dB_hz;
+            valid_obs++;
+
+            // SV ECEF DEBUG OUTPUT
+            DLOG(INFO) << "(new)ECEF satellite SV ID=" << gps_ephemeris.i_satellite_PRN
+                    << " X=" << satpos[0]
+                    << " [m] Y=" << satpos[1]
+                    << " [m] Z=" << satpos[2]
+                    << " [m] PR_obs=" << obs << " [m]";
+
+            // compute the UTC time for this SV (just to print the associated UTC timestamp)
+            GPS_week = gps_ephemeris.i_GPS_week;
+            utc = gps_utc_model.utc_time(TX_time_corrected_s, GPS_week);
         }
 
     // ********************************************************************************
@@ -162,12 +176,14 @@ bool gps_l1_ca_ls_pvt::get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map,
 
     if (valid_obs >= 4)
         {
-            arma::vec mypos;
-            DLOG(INFO) << "satpos=" << satpos;
-            DLOG(INFO) << "obs=" << obs;
-            DLOG(INFO) << "W=" << W;
-
-            mypos = leastSquarePos(satpos, obs, W);
+            arma::vec::fixed<LS_PVT_MAX_UNKNOWNS> mypos = solvePosition(GPS_current_time);
+            if (raim_status() == RAIM_FAILED)
+                {
+                    // the integrity of the fix cannot be guaranteed
+                    b_valid_position = false;
+                    reset_kalman_filter();
+                    return false;
+                }
             DLOG(INFO) << "(new)Position at TOW=" << GPS_current_time << " in ECEF (X,Y,Z) = " << mypos;
 
             cart2geo(static_cast<double>(mypos(0)), static_cast<double>(mypos(1)), static_cast<double>(mypos(2)), 4);
@@ -178,6 +194,7 @@ bool gps_l1_ca_ls_pvt::get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map,
             if (d_height_m > 50000)
                 {
                     b_valid_position = false;
+                    reset_kalman_filter();
                     return false;
                 }
             // Compute UTC time and print PVT solution
@@ -198,38 +215,14 @@ bool gps_l1_ca_ls_pvt::get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map,
             if(d_flag_dump_enabled == true)
                 {
                     // MULTIPLEXED FILE RECORDING - Record results to file
-                    try
-                    {
-                            double tmp_double;
-                            //  PVT GPS time
-                            tmp_double = GPS_current_time;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // ECEF User Position East [m]
-                            tmp_double = mypos(0);
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // ECEF User Position North [m]
-                            tmp_double = mypos(1);
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // ECEF User Position Up [m]
-                            tmp_double = mypos(2);
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // User clock offset [s]
-                            tmp_double = mypos(3);
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // GEO user position Latitude [deg]
-                            tmp_double = d_latitude_d;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // GEO user position Longitude [deg]
-                            tmp_double = d_longitude_d;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // GEO user position Height [m]
-                            tmp_double = d_height_m;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                    }
-                    catch (const std::ifstream::failure &e)
-                    {
-                            LOG(WARNING) << "Exception writing PVT LS dump file " << e.what();
-                    }
+                    d_dump_file.write(GPS_current_time);  // PVT GPS time
+                    d_dump_file.write(mypos(0));  // ECEF User Position X [m]
+                    d_dump_file.write(mypos(1));  // ECEF User Position Y [m]
+                    d_dump_file.write(mypos(2));  // ECEF User Position Z [m]
+                    d_dump_file.write(mypos(3));  // User clock offset
+                    d_dump_file.write(d_latitude_d);  // GEO user position Latitude [deg]
+                    d_dump_file.write(d_longitude_d);  // GEO user position Longitude [deg]
+                    d_dump_file.write(d_height_m);  // GEO user position Height [m]
                 }
 
             // MOVING AVERAGE PVT
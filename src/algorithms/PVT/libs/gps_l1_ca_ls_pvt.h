@@ -33,13 +33,17 @@
 
 #include <fstream>
 #include <map>
+#include <memory>
 #include <string>
 #include "ls_pvt.h"
+#include "binary_dump_writer.h"
 #include "GPS_L1_CA.h"
+#include "gnss_nav_data_store.h"
 #include "gnss_synchro.h"
 #include "gps_ephemeris.h"
 #include "gps_navigation_message.h"
 #include "gps_utc_model.h"
+#include "satellite_orbit_batch.h"
 #include "sbas_telemetry_data.h"
 #include "sbas_ionospheric_correction.h"
 #include "sbas_satellite_correction.h"
@@ -60,10 +64,8 @@ public:
 
     Gps_Navigation_Message* d_ephemeris;
 
-    // new ephemeris storage
-    std::map<int,Gps_Ephemeris> gps_ephemeris_map; //!< Map storing new Gps_Ephemeris
-    Gps_Utc_Model gps_utc_model;
-    Gps_Iono gps_iono;
+    // navigation data used by get_PVT, a snapshot of Gnss_Nav_Data_Store set by the PVT block
+    std::shared_ptr<const Gnss_Nav_Data> nav_data;
 
     Sbas_Ionosphere_Correction sbas_iono;
     std::map<int,Sbas_Satellite_Correction> sbas_sat_corr_map;
@@ -75,7 +77,10 @@ public:
     bool d_flag_averaging;
 
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Binary_Dump_Writer d_dump_file;
+
+private:
+    Satellite_Orbit_Batch d_orbits;  // orbits and clocks of the satellites of an epoch
 };
 
 #endif
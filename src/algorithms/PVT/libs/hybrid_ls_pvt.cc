@@ -32,11 +32,14 @@
 #include "hybrid_ls_pvt.h"
 #include <glog/logging.h>
 #include "Galileo_E1.h"
+#include "Galileo_E5a.h"
+#include "GPS_L2C.h"
+#include "gnss_sdr_trace.h"
 
 
 using google::LogMessage;
 
-hybrid_ls_pvt::hybrid_ls_pvt(int nchannels, std::string dump_filename, bool flag_dump_to_file) : Ls_Pvt()
+hybrid_ls_pvt::hybrid_ls_pvt(int nchannels, std::string dump_filename, bool flag_dump_to_file) : Ls_Pvt(nchannels), d_dump_file("hybrid_ls_pvt"), d_batch_file("hybrid_ls_pvt_batch")
 {
     // init empty ephemeris for all the available GNSS channels
     d_nchannels = nchannels;
@@ -49,21 +52,27 @@ hybrid_ls_pvt::hybrid_ls_pvt(int nchannels, std::string dump_filename, bool flag
     d_valid_GAL_obs = 0;
     count_valid_position = 0;
     d_flag_averaging = false;
+    d_rx_vel = arma::zeros(3);
+    d_rx_clock_drift_m_s = 0.0;
+    b_valid_velocity = false;
+    nav_data = std::make_shared<Gnss_Nav_Data>();
     // ############# ENABLE DATA FILE LOG #################
     if (d_flag_dump_enabled == true)
         {
             if (d_dump_file.is_open() == false)
                 {
-                    try
-                    {
-                            d_dump_file.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-                            d_dump_file.open(d_dump_filename.c_str(), std::ios::out | std::ios::binary);
+                    d_dump_file.add_field("time_s", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("x_m", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("y_m", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("z_m", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("clock_offset", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("latitude_deg", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("longitude_deg", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("height_m", BINARY_DUMP_FLOAT64);
+                    if (d_dump_file.open(d_dump_filename))
+                        {
                             LOG(INFO) << "PVT lib dump enabled Log file: " << d_dump_filename.c_str();
-                    }
-                    catch (const std::ifstream::failure &e)
-                    {
-                            LOG(WARNING) << "Exception opening PVT lib dump file " << e.what();
-                    }
+                        }
                 }
         }
 }
@@ -71,22 +80,106 @@ hybrid_ls_pvt::hybrid_ls_pvt(int nchannels, std::string dump_filename, bool flag
 
 hybrid_ls_pvt::~hybrid_ls_pvt()
 {
+    finish_batch();
+    d_batch_file.close();
     d_dump_file.close();
     delete[] d_Gal_ephemeris;
     delete[] d_GPS_ephemeris;
 }
 
 
+void hybrid_ls_pvt::set_batch(unsigned int window_epochs, unsigned int threads, const std::string & batch_filename)
+{
+    finish_batch();
+    d_batch.reset();
+    if (window_epochs == 0)
+        {
+            return;
+        }
+    if (!d_batch_file.is_open())
+        {
+            d_batch_file.add_field("time_s", BINARY_DUMP_FLOAT64);
+            d_batch_file.add_field("x_m", BINARY_DUMP_FLOAT64);
+            d_batch_file.add_field("y_m", BINARY_DUMP_FLOAT64);
+            d_batch_file.add_field("z_m", BINARY_DUMP_FLOAT64);
+            d_batch_file.add_field("clock_offset", BINARY_DUMP_FLOAT64);
+            d_batch_file.add_field("clock_drift", BINARY_DUMP_FLOAT64);
+            d_batch_file.add_field("second_clock_offset", BINARY_DUMP_FLOAT64);
+            d_batch_file.add_field("latitude_deg", BINARY_DUMP_FLOAT64);
+            d_batch_file.add_field("longitude_deg", BINARY_DUMP_FLOAT64);
+            d_batch_file.add_field("height_m", BINARY_DUMP_FLOAT64);
+            d_batch_file.add_field("observations", BINARY_DUMP_INT32);
+            if (!d_batch_file.open(batch_filename))
+                {
+                    LOG(WARNING) << "Cannot open the batch PVT file " << batch_filename;
+                    return;
+                }
+        }
+    d_batch = std::make_shared<Batch_Ls_Pvt>(window_epochs, threads,
+            std::bind(&hybrid_ls_pvt::write_batch_solution, this, std::placeholders::_1));
+    LOG(INFO) << "Batch PVT in windows of " << window_epochs << " epochs, on " << threads
+              << " threads, written to " << batch_filename;
+}
+
+
+void hybrid_ls_pvt::finish_batch()
+{
+    if (d_batch)
+        {
+            d_batch->finish();
+        }
+}
+
+
+void hybrid_ls_pvt::write_batch_solution(const Batch_Ls_Pvt_Solution & solution)
+{
+    if (!solution.valid)
+        {
+            return;
+        }
+    double latitude_d;
+    double longitude_d;
+    double height_m;
+    togeod(&latitude_d, &longitude_d, &height_m, 6378137.0, 298.257223563, solution.pos[0], solution.pos[1], solution.pos[2]);
+    d_batch_file.write(solution.rx_time);
+    d_batch_file.write(solution.pos[0]);
+    d_batch_file.write(solution.pos[1]);
+    d_batch_file.write(solution.pos[2]);
+    d_batch_file.write(solution.clock_m);
+    d_batch_file.write(solution.clock_drift_m_s);
+    d_batch_file.write(solution.isb_m);
+    d_batch_file.write(latitude_d);
+    d_batch_file.write(longitude_d);
+    d_batch_file.write(height_m);
+    d_batch_file.write(static_cast<int>(solution.observations));
+}
+
+
+//! Carrier wavelength of the signal tracked for an observation [m]
+static double carrier_wavelength(const Gnss_Synchro & gnss_synchro)
+{
+    std::string signal = gnss_synchro.Signal;
+    if (signal.compare("2S") == 0) return GPS_C_m_s / GPS_L2_FREQ_HZ;
+    if (signal.compare("5X") == 0) return GPS_C_m_s / Galileo_E5a_FREQ_HZ;
+    return GPS_C_m_s / GPS_L1_FREQ_HZ;
+}
+
+
 bool hybrid_ls_pvt::get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map, double hybrid_current_time, bool flag_averaging)
 {
+    GNSS_SDR_TRACE_SCOPE("hybrid_ls_pvt::get_PVT");
+    const std::map<int,Galileo_Ephemeris> & galileo_ephemeris_map = nav_data->galileo_ephemeris_map;
+    const std::map<int,Gps_Ephemeris> & gps_ephemeris_map = nav_data->gps_ephemeris_map;
+    Galileo_Utc_Model galileo_utc_model = nav_data->galileo_utc_model;
+    Gps_Utc_Model gps_utc_model = nav_data->gps_utc_model;
     std::map<int,Gnss_Synchro>::iterator gnss_pseudoranges_iter;
-    std::map<int,Galileo_Ephemeris>::iterator galileo_ephemeris_iter;
-    std::map<int,Gps_Ephemeris>::iterator gps_ephemeris_iter;
-    int valid_pseudoranges = gnss_pseudoranges_map.size();
-
-    arma::mat W = arma::eye(valid_pseudoranges, valid_pseudoranges); // channels weights matrix
-    arma::vec obs = arma::zeros(valid_pseudoranges);                 // pseudoranges observation vector
-    arma::mat satpos = arma::zeros(3, valid_pseudoranges);           // satellite positions matrix
+    std::map<int,Galileo_Ephemeris>::const_iterator galileo_ephemeris_iter;
+    std::map<int,Gps_Ephemeris>::const_iterator gps_ephemeris_iter;
+    double satpos[3];                       // satellite position
+    double satvel[3];                       // satellite velocity
+    double obs;                             // corrected pseudorange
+    double range_rate;                      // pseudorange rate observation
+    int obs_channel[PVT_MAX_CHANNELS];      // map key of each stored observation
 
     int Galileo_week_number = 0;
     int GPS_week = 0;
@@ -102,118 +195,126 @@ bool hybrid_ls_pvt::get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map, do
     // ****** PREPARE THE LEAST SQUARES DATA (SV POSITIONS MATRIX AND OBS VECTORS) ****
     // ********************************************************************************
     int valid_obs = 0; //valid observations counter
-    int obs_counter = 0;
+    clear_observations();
+    if (d_batch)
+        {
+            d_batch->begin_epoch(hybrid_current_time);
+        }
     int valid_obs_GPS_counter = 0;
     int valid_obs_GALILEO_counter = 0;
+    // ephemeris of each satellite in d_orbits, one of them null
+    const Galileo_Ephemeris * galileo_ephemeris[SATELLITE_ORBIT_BATCH_SIZE];
+    const Gps_Ephemeris * gps_ephemeris[SATELLITE_ORBIT_BATCH_SIZE];
+    std::map<int,Gnss_Synchro>::iterator observation[SATELLITE_ORBIT_BATCH_SIZE];
+    d_orbits.clear();
     for(gnss_pseudoranges_iter = gnss_pseudoranges_map.begin();
             gnss_pseudoranges_iter != gnss_pseudoranges_map.end();
             gnss_pseudoranges_iter++)
         {
+            const unsigned int k = d_orbits.size();
             if(gnss_pseudoranges_iter->second.System == 'E')
                 {
                     // 1 Gal - find the ephemeris for the current GALILEO SV observation. The SV PRN ID is the map key
                     galileo_ephemeris_iter = galileo_ephemeris_map.find(gnss_pseudoranges_iter->second.PRN);
                     if (galileo_ephemeris_iter != galileo_ephemeris_map.end())
                         {
-                            /*!
-                             * \todo Place here the satellite CN0 (power level, or weight factor)
-                             */
-                            W(obs_counter, obs_counter) = 1;
-
                             // COMMON RX TIME PVT ALGORITHM
                             double Rx_time = hybrid_current_time;
                             double Tx_time = Rx_time - gnss_pseudoranges_iter->second.Pseudorange_m / GALILEO_C_m_s;
-
-                            // 2- compute the clock drift using the clock model (broadcast) for this SV
-                            SV_clock_bias_s = galileo_ephemeris_iter->second.sv_clock_drift(Tx_time);
-
-                            // 3- compute the current ECEF position for this SV using corrected TX time
-                            TX_time_corrected_s = Tx_time - SV_clock_bias_s;
-                            galileo_ephemeris_iter->second.satellitePosition(TX_time_corrected_s);
-
-                            satpos(0,obs_counter) = galileo_ephemeris_iter->second.d_satpos_X;
-                            satpos(1,obs_counter) = galileo_ephemeris_iter->second.d_satpos_Y;
-                            satpos(2,obs_counter) = galileo_ephemeris_iter->second.d_satpos_Z;
-
-                            // 5- fill the observations vector with the corrected pseudoranges
-                            obs(obs_counter) = gnss_pseudoranges_iter->second.Pseudorange_m + SV_clock_bias_s * GALILEO_C_m_s;
-                            d_visible_satellites_IDs[valid_obs] = galileo_ephemeris_iter->second.i_satellite_PRN;
-                            d_visible_satellites_CN0_dB[valid_obs] = gnss_pseudoranges_iter->second.CN0_dB_hz;
-                            valid_obs++;
-                            valid_obs_GALILEO_counter ++;
-
-                            Galileo_week_number = galileo_ephemeris_iter->second.WN_5; //for GST
-                            GST = galileo_ephemeris_iter->second.Galileo_System_Time(Galileo_week_number, hybrid_current_time);
-
-                            // SV ECEF DEBUG OUTPUT
-                            DLOG(INFO) << "ECEF satellite SV ID=" << galileo_ephemeris_iter->second.i_satellite_PRN
-                                    << " X=" << galileo_ephemeris_iter->second.d_satpos_X
-                                    << " [m] Y=" << galileo_ephemeris_iter->second.d_satpos_Y
-                                    << " [m] Z=" << galileo_ephemeris_iter->second.d_satpos_Z
-                                    << " [m] PR_obs=" << obs(obs_counter) << " [m]";
+                            if (!d_orbits.add(galileo_ephemeris_iter->second, Tx_time))
+                                {
+                                    DLOG(INFO) << "No room for the orbit of SV " << gnss_pseudoranges_iter->second.PRN;
+                                    continue;
+                                }
+                            galileo_ephemeris[k] = &galileo_ephemeris_iter->second;
+                            gps_ephemeris[k] = 0;
+                            observation[k] = gnss_pseudoranges_iter;
                         }
 
                     else // the ephemeris are not available for this SV
                         {
                             // no valid pseudorange for the current SV
-                            W(obs_counter, obs_counter) = 0; // SV de-activated
-                            obs(obs_counter) = 1;            // to avoid algorithm problems (divide by zero)
                             DLOG(INFO) << "No ephemeris data for SV " << gnss_pseudoranges_iter->second.PRN;
                         }
                 }
 
             else if(gnss_pseudoranges_iter->second.System == 'G')
                 {
-                    //std::cout << "Satellite System: " << gnss_pseudoranges_iter->second.System <<std::endl;
                     // 1 GPS - find the ephemeris for the current GPS SV observation. The SV PRN ID is the map key
                     gps_ephemeris_iter = gps_ephemeris_map.find(gnss_pseudoranges_iter->second.PRN);
                     if (gps_ephemeris_iter != gps_ephemeris_map.end())
                         {
-                            /*!
-                             * \todo Place here the satellite CN0 (power level, or weight factor)
-                             */
-                            W(obs_counter, obs_counter) = 1;
-
                             // COMMON RX TIME PVT ALGORITHM MODIFICATION (Like RINEX files)
                             // first estimate of transmit time
                             double Rx_time = hybrid_current_time;
                             double Tx_time = Rx_time - gnss_pseudoranges_iter->second.Pseudorange_m / GPS_C_m_s;
-
-                            // 2- compute the clock drift using the clock model (broadcast) for this SV
-                            SV_clock_bias_s = gps_ephemeris_iter->second.sv_clock_drift(Tx_time);
-
-                            // 3- compute the current ECEF position for this SV using corrected TX time
-                            TX_time_corrected_s = Tx_time - SV_clock_bias_s;
-                            gps_ephemeris_iter->second.satellitePosition(TX_time_corrected_s);
-
-                            satpos(0, obs_counter) = gps_ephemeris_iter->second.d_satpos_X;
-                            satpos(1, obs_counter) = gps_ephemeris_iter->second.d_satpos_Y;
-                            satpos(2, obs_counter) = gps_ephemeris_iter->second.d_satpos_Z;
-
-                            // 5- fill the observations vector with the corrected pseudorranges
-                            obs(obs_counter) = gnss_pseudoranges_iter->second.Pseudorange_m + SV_clock_bias_s * GPS_C_m_s;
-                            d_visible_satellites_IDs[valid_obs] = gps_ephemeris_iter->second.i_satellite_PRN;
-                            d_visible_satellites_CN0_dB[valid_obs] = gnss_pseudoranges_iter->second.CN0_dB_hz;
-                            valid_obs++;
-                            valid_obs_GPS_counter++;
-                            GPS_week = gps_ephemeris_iter->second.i_GPS_week;
-
-                            // SV ECEF DEBUG OUTPUT
-                            DLOG(INFO) << "(new)ECEF satellite SV ID=" << gps_ephemeris_iter->second.i_satellite_PRN
-                                    << " X=" << gps_ephemeris_iter->second.d_satpos_X
-                                    << " [m] Y=" << gps_ephemeris_iter->second.d_satpos_Y
-                                    << " [m] Z=" << gps_ephemeris_iter->second.d_satpos_Z
-                                    << " [m] PR_obs=" << obs(obs_counter) << " [m]";
+                            if (!d_orbits.add(gps_ephemeris_iter->second, Tx_time))
+                                {
+                                    DLOG(INFO) << "No room for the orbit of SV " << gnss_pseudoranges_iter->second.PRN;
+                                    continue;
+                                }
+                            galileo_ephemeris[k] = 0;
+                            gps_ephemeris[k] = &gps_ephemeris_iter->second;
+                            observation[k] = gnss_pseudoranges_iter;
                         }
                     else // the ephemeris are not available for this SV
                         {
                             // no valid pseudorange for the current SV
-                            W(obs_counter, obs_counter) = 0; // SV de-activated
-                            obs(obs_counter) = 1;            // to avoid algorithm problems (divide by zero)
                             DLOG(INFO) << "No ephemeris data for SV " << gnss_pseudoranges_iter->second.PRN;
                         }
                 }
-            obs_counter++;
+        }
+
+    // 2- compute the clock drift using the clock model (broadcast) of all the SVs, and their
+    // ECEF positions and velocities at the corrected TX times
+    d_orbits.compute();
+    for (unsigned int k = 0; k < d_orbits.size(); k++)
+        {
+            const Gnss_Synchro & gnss_synchro = observation[k]->second;
+            SV_clock_bias_s = d_orbits.clock_bias_s(k);
+            TX_time_corrected_s = d_orbits.corrected_transmit_time_s(k);
+            d_orbits.position(k, satpos);
+            d_orbits.velocity(k, satvel);
+            range_rate = - gnss_synchro.Carrier_Doppler_hz * carrier_wavelength(gnss_synchro);
+
+            // 3- fill the observations vector with the corrected pseudoranges
+            const bool galileo = galileo_ephemeris[k] != 0;
+            obs = gnss_synchro.Pseudorange_m + SV_clock_bias_s * (galileo ? GALILEO_C_m_s : GPS_C_m_s);
+            /*!
+             * \todo Place here the satellite CN0 (power level, or weight factor)
+             */
+            if (!add_observation(satpos, satvel, obs, range_rate, 1.0, galileo ? 1 : 0))
+                {
+                    DLOG(INFO) << "No room for the observation of SV " << gnss_synchro.PRN;
+                    continue;
+                }
+            if (d_batch)
+                {
+                    d_batch->add_observation(satpos, obs, 1.0, galileo ? 1 : 0);
+                }
+            obs_channel[valid_obs] = observation[k]->first;
+            d_visible_satellites_CN0_dB[valid_obs] = gnss_synchro.CN0_dB_hz;
+            if (galileo)
+                {
+                    d_visible_satellites_IDs[valid_obs] = galileo_ephemeris[k]->i_satellite_PRN;
+                    valid_obs_GALILEO_counter++;
+                    Galileo_week_number = galileo_ephemeris[k]->WN_5; //for GST
+                    GST = galileo_ephemeris[k]->Galileo_System_Time(Galileo_week_number, hybrid_current_time);
+                }
+            else
+                {
+                    d_visible_satellites_IDs[valid_obs] = gps_ephemeris[k]->i_satellite_PRN;
+                    valid_obs_GPS_counter++;
+                    GPS_week = gps_ephemeris[k]->i_GPS_week;
+                }
+            valid_obs++;
+
+            // SV ECEF DEBUG OUTPUT
+            DLOG(INFO) << "ECEF satellite SV ID=" << gnss_synchro.System << gnss_synchro.PRN
+                    << " X=" << satpos[0]
+                    << " [m] Y=" << satpos[1]
+                    << " [m] Z=" << satpos[2]
+                    << " [m] PR_obs=" << obs << " [m]";
         }
 
     // ********************************************************************************
@@ -226,13 +327,24 @@ bool hybrid_ls_pvt::get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map, do
 
     if(valid_obs >= 4)
         {
-            arma::vec mypos;
-            DLOG(INFO) << "satpos=" << satpos;
-            DLOG(INFO) << "obs=" << obs;
-            DLOG(INFO) << "W=" << W;
-
-            mypos = leastSquarePos(satpos, obs, W);
+            // With both systems in view, and one more satellite than unknowns,
+            // the Galileo observations get their own receiver clock offset
+            int nclocks = 1;
+            if (valid_obs_GPS_counter > 0 && valid_obs_GALILEO_counter > 0 && valid_obs >= 5)
+                {
+                    nclocks = 2;
+                }
+            arma::vec::fixed<LS_PVT_MAX_UNKNOWNS> mypos = solvePosition(hybrid_current_time, nclocks);
+            if (raim_status() == RAIM_FAILED)
+                {
+                    // the integrity of the fix cannot be guaranteed
+                    if (d_batch) d_batch->discard_epoch();
+                    b_valid_position = false;
+                    reset_kalman_filter();
+                    return false;
+                }
             d_rx_dt_m = mypos(3)/GPS_C_m_s; // Convert RX time offset from meters to seconds
+            DLOG(INFO) << "HYBRID Galileo to GPS receiver clock offset= " << mypos(4) / GPS_C_m_s << " [s]";
             double secondsperweek = 604800.0;
             // Compute GST and Gregorian time
             if( GST != 0.0)
@@ -256,7 +368,10 @@ bool hybrid_ls_pvt::get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map, do
             //ToDo: Find an Observables/PVT random bug with some satellite configurations that gives an erratic PVT solution (i.e. height>50 km)
             if (d_height_m > 50000)
                 {
+                    if (d_batch) d_batch->discard_epoch();
                     b_valid_position = false;
+                    reset_kalman_filter();
+                    b_valid_velocity = false;
                     LOG(INFO) << "Hybrid Position at " << boost::posix_time::to_simple_string(p_time)
                     << " is Lat = " << d_latitude_d << " [deg], Long = " << d_longitude_d
                     << " [deg], Height= " << d_height_m << " [m]" << " RX time offset= " << mypos(3) << " [s]";
@@ -267,45 +382,52 @@ bool hybrid_ls_pvt::get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map, do
             << " is Lat = " << d_latitude_d << " [deg], Long = " << d_longitude_d
             << " [deg], Height= " << d_height_m << " [m]" << " RX time offset= " << d_rx_dt_m << " [s]";
 
+            // ###### Batch solution, from this fix and without the excluded observations ########
+            if (d_batch)
+                {
+                    for (int i = 0; i < num_observations(); i++)
+                        {
+                            if (raim_excluded(i)) d_batch->exclude_observation(i);
+                        }
+                    d_batch->end_epoch(mypos.memptr());
+                }
+
             // ###### Compute DOPs ########
             hybrid_ls_pvt::compute_DOP();
 
+            // ###### Line of sight of each channel ########
+            d_los_azimuth_d.clear();
+            d_los_elevation_d.clear();
+            for (int i = 0; i < num_observations(); i++)
+                {
+                    d_los_azimuth_d[obs_channel[i]] = d_visible_satellites_Az[i];
+                    d_los_elevation_d[obs_channel[i]] = d_visible_satellites_El[i];
+                }
+
+            // ###### Velocity and pseudorange rate predictions ########
+            arma::vec::fixed<4> myvel = kalman_filter() ? kalmanVel() : leastSquareVel(mypos.memptr());
+            d_rx_vel = myvel.subvec(0, 2);
+            d_rx_clock_drift_m_s = myvel(3);
+            b_valid_velocity = true;
+            d_predicted_range_rate_m_s.clear();
+            for (int i = 0; i < num_observations(); i++)
+                {
+                    d_predicted_range_rate_m_s[obs_channel[i]] = predictedRangeRate(i, mypos.memptr(), myvel);
+                }
+            DLOG(INFO) << "HYBRID Velocity in ECEF (VX,VY,VZ) = " << d_rx_vel << " RX clock drift= " << d_rx_clock_drift_m_s << " [m/s]";
+
             // ######## LOG FILE #########
             if(d_flag_dump_enabled == true)
                 {
                     // MULTIPLEXED FILE RECORDING - Record results to file
-                    try
-                    {
-                            double tmp_double;
-                            //  PVT GPS time
-                            tmp_double = hybrid_current_time;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // ECEF User Position East [m]
-                            tmp_double = mypos(0);
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // ECEF User Position North [m]
-                            tmp_double = mypos(1);
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // ECEF User Position Up [m]
-                            tmp_double = mypos(2);
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // User clock offset [s]
-                            tmp_double = mypos(3);
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // GEO user position Latitude [deg]
-                            tmp_double = d_latitude_d;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // GEO user position Longitude [deg]
-                            tmp_double = d_longitude_d;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            // GEO user position Height [m]
-                            tmp_double = d_height_m;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                    }
-                    catch (const std::ifstream::failure& e)
-                    {
-                            LOG(WARNING) << "Exception writing PVT LS dump file " << e.what();
-                    }
+                    d_dump_file.write(hybrid_current_time);  // PVT GPS time
+                    d_dump_file.write(mypos(0));  // ECEF User Position X [m]
+                    d_dump_file.write(mypos(1));  // ECEF User Position Y [m]
+                    d_dump_file.write(mypos(2));  // ECEF User Position Z [m]
+                    d_dump_file.write(mypos(3));  // User clock offset
+                    d_dump_file.write(d_latitude_d);  // GEO user position Latitude [deg]
+                    d_dump_file.write(d_longitude_d);  // GEO user position Longitude [deg]
+                    d_dump_file.write(d_height_m);  // GEO user position Height [m]
                 }
 
             // MOVING AVERAGE PVT
@@ -313,7 +435,10 @@ bool hybrid_ls_pvt::get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map, do
         }
     else
         {
+            // Three satellites still give a position with the clock of the batch window
+            if (d_batch) d_batch->end_epoch(0);
             b_valid_position = false;
+            b_valid_velocity = false;
         }
     return b_valid_position;
 }
@@ -35,15 +35,20 @@
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include "ls_pvt.h"
+#include "batch_ls_pvt.h"
+#include "binary_dump_writer.h"
 #include "galileo_navigation_message.h"
 #include "gps_navigation_message.h"
+#include "gnss_nav_data_store.h"
 #include "gnss_synchro.h"
 #include "galileo_ephemeris.h"
 #include "galileo_utc_model.h"
 #include "gps_ephemeris.h"
 #include "gps_utc_model.h"
+#include "satellite_orbit_batch.h"
 
 
 /*!
@@ -56,6 +61,17 @@ public:
     ~hybrid_ls_pvt();
 
     bool get_PVT(std::map<int,Gnss_Synchro> gnss_pseudoranges_map, double hybrid_current_time, bool flag_averaging);
+
+    /*!
+     * \brief Also solves the epochs in windows of window_epochs epochs with a
+     * Batch_Ls_Pvt, on up to threads threads, and writes their positions to
+     * batch_filename. 0 epochs disables it.
+     */
+    void set_batch(unsigned int window_epochs, unsigned int threads, const std::string & batch_filename);
+
+    //! Solves and writes the epochs left in the batch solution
+    void finish_batch();
+
     int d_nchannels;                                        //!< Number of available channels for positioning
     int d_valid_GPS_obs;                                    //!< Number of valid GPS pseudorange observations (valid GPS satellites) -- used for hybrid configuration
     int d_valid_GAL_obs;                                    //!< Number of valid GALILEO pseudorange observations (valid GALILEO satellites) -- used for hybrid configuration
@@ -63,24 +79,32 @@ public:
     Galileo_Navigation_Message* d_Gal_ephemeris;
     Gps_Navigation_Message* d_GPS_ephemeris;
 
-    std::map<int,Galileo_Ephemeris> galileo_ephemeris_map; //!< Map storing new Galileo_Ephemeris
-    std::map<int,Gps_Ephemeris> gps_ephemeris_map; //!< Map storing new Galileo_Ephemeris
-    Galileo_Utc_Model galileo_utc_model;
-    Galileo_Iono galileo_iono;
-    Galileo_Almanac galileo_almanac;
-
-    Gps_Utc_Model gps_utc_model;
-    Gps_Iono gps_iono;
+    // navigation data used by get_PVT, a snapshot of Gnss_Nav_Data_Store set by the PVT block
+    std::shared_ptr<const Gnss_Nav_Data> nav_data;
 
     double d_galileo_current_time;
 
+    arma::vec d_rx_vel;                                     //!< Receiver ECEF velocity [m/s]
+    double d_rx_clock_drift_m_s;                            //!< Receiver clock drift [m/s]
+    bool b_valid_velocity;
+    std::map<int,double> d_predicted_range_rate_m_s;        //!< Pseudorange rates predicted by the last velocity solution, indexed by channel [m/s]
+    std::map<int,double> d_los_azimuth_d;                   //!< Azimuth of the satellites of the last solution, indexed by channel [deg]
+    std::map<int,double> d_los_elevation_d;                 //!< Elevation of the satellites of the last solution, indexed by channel [deg]
+
     int count_valid_position;
 
     bool d_flag_dump_enabled;
     bool d_flag_averaging;
 
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Binary_Dump_Writer d_dump_file;
+
+private:
+    void write_batch_solution(const Batch_Ls_Pvt_Solution & solution);
+
+    Satellite_Orbit_Batch d_orbits;  // orbits and clocks of the satellites of an epoch
+    std::shared_ptr<Batch_Ls_Pvt> d_batch;  // null if disabled
+    Binary_Dump_Writer d_batch_file;
 };
 
 #endif
@@ -30,6 +30,7 @@
  */
 
 #include "kml_printer.h"
+#include "gnss_sdr_trace.h"
 #include <ctime>
 #include <sstream>
 #include <glog/logging.h>
@@ -87,37 +88,35 @@ bool Kml_Printer::set_headers(std::string filename,  bool time_tag_name)
         {
             kml_filename = filename + ".kml";
         }
-    kml_file.open(kml_filename.c_str());
-    if (kml_file.is_open())
+    std::stringstream header;
+    header << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << std::endl
+           << "<kml xmlns=\"http://www.opengis.net/kml/2.2\">" << std::endl
+           << "    <Document>" << std::endl
+           << "    <name>GNSS Track</name>" << std::endl
+           << "    <description>GNSS-SDR Receiver position log file created at " << asctime (timeinfo)
+           << "    </description>" << std::endl
+           << "<Style id=\"yellowLineGreenPoly\">" << std::endl
+           << " <LineStyle>" << std::endl
+           << "     <color>7f00ffff</color>" << std::endl
+           << "        <width>1</width>" << std::endl
+           << "    </LineStyle>" << std::endl
+           << "<PolyStyle>" << std::endl
+           << "    <color>7f00ff00</color>" << std::endl
+           << "</PolyStyle>" << std::endl
+           << "</Style>" << std::endl
+           << "<Placemark>" << std::endl
+           << "<name>GNSS-SDR PVT</name>" << std::endl
+           << "<description>GNSS-SDR position log</description>" << std::endl
+           << "<styleUrl>#yellowLineGreenPoly</styleUrl>" << std::endl
+           << "<LineString>" << std::endl
+           << "<extrude>0</extrude>" << std::endl
+           << "<tessellate>1</tessellate>" << std::endl
+           << "<altitudeMode>absolute</altitudeMode>" << std::endl
+           << "<coordinates>" << std::endl;
+    const std::string trailer = "</coordinates>\n</LineString>\n</Placemark>\n</Document>\n</kml>";
+    if (kml_file.open(kml_filename, header.str(), trailer))
         {
             DLOG(INFO) << "KML printer writing on " << filename.c_str();
-            // Set iostream numeric format and precision
-            kml_file.setf(kml_file.fixed, kml_file.floatfield);
-            kml_file << std::setprecision(14);
-            kml_file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << std::endl
-                    << "<kml xmlns=\"http://www.opengis.net/kml/2.2\">" << std::endl
-                    << "    <Document>" << std::endl
-                    << "    <name>GNSS Track</name>" << std::endl
-                    << "    <description>GNSS-SDR Receiver position log file created at " << asctime (timeinfo)
-                    << "    </description>" << std::endl
-                    << "<Style id=\"yellowLineGreenPoly\">" << std::endl
-                    << " <LineStyle>" << std::endl
-                    << "     <color>7f00ffff</color>" << std::endl
-                    << "        <width>1</width>" << std::endl
-                    << "    </LineStyle>" << std::endl
-                    << "<PolyStyle>" << std::endl
-                    << "    <color>7f00ff00</color>" << std::endl
-                    << "</PolyStyle>" << std::endl
-                    << "</Style>" << std::endl
-                    << "<Placemark>" << std::endl
-                    << "<name>GNSS-SDR PVT</name>" << std::endl
-                    << "<description>GNSS-SDR position log</description>" << std::endl
-                    << "<styleUrl>#yellowLineGreenPoly</styleUrl>" << std::endl
-                    << "<LineString>" << std::endl
-                    << "<extrude>0</extrude>" << std::endl
-                    << "<tessellate>1</tessellate>" << std::endl
-                    << "<altitudeMode>absolute</altitudeMode>" << std::endl
-                    << "<coordinates>" << std::endl;
             return true;
         }
     else
@@ -130,6 +129,7 @@ bool Kml_Printer::set_headers(std::string filename,  bool time_tag_name)
 
 bool Kml_Printer::print_position(const std::shared_ptr<Pvt_Solution>& position, bool print_average_values)
 {
+    GNSS_SDR_TRACE_SCOPE("Kml_Printer::print_position");
     double latitude;
     double longitude;
     double height;
@@ -153,7 +153,14 @@ bool Kml_Printer::print_position(const std::shared_ptr<Pvt_Solution>& position,
 
     if (kml_file.is_open())
         {
-            kml_file << longitude << "," << latitude << "," << height << std::endl;
+            char line[128];
+            char * end = Track_File_Writer::format_fixed(line, longitude, 14);
+            *end++ = ',';
+            end = Track_File_Writer::format_fixed(end, latitude, 14);
+            *end++ = ',';
+            end = Track_File_Writer::format_fixed(end, height, 14);
+            *end++ = '\n';
+            kml_file.append(std::string(line, end));
             return true;
         }
     else
@@ -167,12 +174,7 @@ bool Kml_Printer::close_file()
 {
     if (kml_file.is_open())
         {
-
-            kml_file << "</coordinates>" << std::endl
-                     << "</LineString>" << std::endl
-                     << "</Placemark>" << std::endl
-                     << "</Document>" << std::endl
-                     << "</kml>";
+            // the closing tags are already in the file
             kml_file.close();
             return true;
         }
@@ -184,7 +186,7 @@ bool Kml_Printer::close_file()
 
 
 
-Kml_Printer::Kml_Printer ()
+Kml_Printer::Kml_Printer (double flush_interval_s) : kml_file(flush_interval_s)
 {
     positions_printed = false;
 }
@@ -33,29 +33,36 @@
 #ifndef GNSS_SDR_KML_PRINTER_H_
 #define GNSS_SDR_KML_PRINTER_H_
 
-#include <iostream>
-#include <fstream>
 #include <memory>
 #include <string>
 #include "pvt_solution.h"
+#include "track_file_writer.h"
 
 /*!
  * \brief Prints PVT information to OGC KML format file (can be viewed with Google Earth)
  *
  * See http://www.opengeospatial.org/standards/kml
+ *
+ * The positions are written every flush_interval_s seconds, each time
+ * followed by the closing tags, so the file is valid if the receiver stops
+ * without closing it.
  */
 class Kml_Printer
 {
 private:
-    std::ofstream kml_file;
+    Track_File_Writer kml_file;
     bool positions_printed;
     std::string kml_filename;
 public:
-    Kml_Printer();
+    Kml_Printer(double flush_interval_s = TRACK_FILE_FLUSH_INTERVAL_S);
     ~Kml_Printer();
     bool set_headers(std::string filename, bool time_tag_name = true);
     bool print_position(const std::shared_ptr<Pvt_Solution>& position, bool print_average_values);
     bool close_file();
+    std::string get_filename() const
+    {
+        return kml_filename;
+    }
 };
 
 #endif
@@ -30,7 +30,8 @@
  */
 
 #include "ls_pvt.h"
-#include <exception>
+#include <algorithm>
+#include <cmath>
 #include "GPS_L1_CA.h"
 #include <gflags/gflags.h>
 #include <glog/logging.h>
@@ -39,119 +40,967 @@
 using google::LogMessage;
 
 
-Ls_Pvt::Ls_Pvt() : Pvt_Solution()
+Ls_Pvt::Ls_Pvt(int max_observations) : Pvt_Solution()
 {
     d_x_m = 0.0;
     d_y_m = 0.0;
     d_z_m = 0.0;
+    // the visible satellites arrays are indexed by observation
+    d_max_obs = std::min(std::max(max_observations, 0), PVT_MAX_CHANNELS);
+    d_nobs = 0;
+    d_satpos.assign(3 * d_max_obs, 0.0);
+    d_satvel.assign(3 * d_max_obs, 0.0);
+    d_obs.assign(d_max_obs, 0.0);
+    d_range_rate.assign(d_max_obs, 0.0);
+    d_weight.assign(d_max_obs, 0.0);
+    d_clock.assign(d_max_obs, 0);
+    d_has_rate.assign(d_max_obs, 0);
+    d_los.assign(3 * d_max_obs, 0.0);
+    d_trop.assign(d_max_obs, 0.0);
+    d_tropo_mask.assign(d_max_obs, 0.0);
+    d_raim_enabled = false;
+    d_raim_sigma_m = 5.0;
+    d_raim_max_exclusions = 1;
+    d_raim_status = RAIM_UNAVAILABLE;
+    d_raim_statistic = 0.0;
+    d_raim_threshold = 0.0;
+    d_raim_chi2.assign(d_max_obs + 1, 0.0);
+    d_raim_a.assign(LS_PVT_MAX_UNKNOWNS * d_max_obs, 0.0);
+    d_raim_res.assign(d_max_obs, 0.0);
+    d_raim_excluded.assign(d_max_obs, 0);
+    d_Q = arma::zeros(4, 4);
+    d_kf_enabled = false;
+    d_kf_initialized = false;
+    d_kf_time = 0.0;
+    for (int j = 0; j < LS_PVT_KF_STATES; j++)
+        {
+            d_kf_x[j] = 0.0;
+        }
+    for (int j = 0; j < LS_PVT_KF_STATES * LS_PVT_KF_STATES; j++)
+        {
+            d_kf_P[j] = 0.0;
+        }
 }
 
-arma::vec Ls_Pvt::leastSquarePos(const arma::mat & satpos, const arma::vec & obs, const arma::mat & w)
+
+void Ls_Pvt::clear_observations()
 {
-    /* Computes the Least Squares Solution.
-     *   Inputs:
-     *       satpos      - Satellites positions in ECEF system: [X; Y; Z;]
-     *       obs         - Observations - the pseudorange measurements to each satellite
-     *       w           - weigths vector
-     *
+    d_nobs = 0;
+}
+
+
+bool Ls_Pvt::add_observation(const double * satpos, const double * satvel, double obs, double range_rate, double w, int clock)
+{
+    if (d_nobs >= d_max_obs)
+        {
+            return false;
+        }
+    for (int j = 0; j < 3; j++)
+        {
+            d_satpos[3 * d_nobs + j] = satpos[j];
+            d_satvel[3 * d_nobs + j] = (satvel != 0) ? satvel[j] : 0.0;
+        }
+    d_obs[d_nobs] = obs;
+    d_range_rate[d_nobs] = range_rate;
+    d_weight[d_nobs] = w;
+    d_clock[d_nobs] = clock;
+    d_has_rate[d_nobs] = (satvel != 0);
+    d_nobs++;
+    return true;
+}
+
+
+bool Ls_Pvt::cholesky_decompose(double * N, int n)
+{
+    for (int j = 0; j < n; j++)
+        {
+            double d = N[j * n + j];
+            for (int k = 0; k < j; k++)
+                {
+                    d -= N[j * n + k] * N[j * n + k];
+                }
+            if (!(d > 0.0))
+                {
+                    return false;
+                }
+            d = sqrt(d);
+            N[j * n + j] = d;
+            for (int i = j + 1; i < n; i++)
+                {
+                    double v = N[i * n + j];
+                    for (int k = 0; k < j; k++)
+                        {
+                            v -= N[i * n + k] * N[j * n + k];
+                        }
+                    N[i * n + j] = v / d;
+                }
+        }
+    return true;
+}
+
+
+void Ls_Pvt::cholesky_solve(const double * L, double * b, int n)
+{
+    // L y = b
+    for (int i = 0; i < n; i++)
+        {
+            double v = b[i];
+            for (int k = 0; k < i; k++)
+                {
+                    v -= L[i * n + k] * b[k];
+                }
+            b[i] = v / L[i * n + i];
+        }
+    // L' x = y
+    for (int i = n - 1; i >= 0; i--)
+        {
+            double v = b[i];
+            for (int k = i + 1; k < n; k++)
+                {
+                    v -= L[k * n + i] * b[k];
+                }
+            b[i] = v / L[i * n + i];
+        }
+}
+
+
+bool Ls_Pvt::cholesky_downdate(double * L, double * v, int n)
+{
+    // One Givens rotation per column removes v from the factor
+    for (int k = 0; k < n; k++)
+        {
+            const double d = L[k * n + k];
+            const double r2 = d * d - v[k] * v[k];
+            if (!(r2 > 0.0))
+                {
+                    return false;
+                }
+            const double r = sqrt(r2);
+            const double c = r / d;
+            const double s = v[k] / d;
+            L[k * n + k] = r;
+            for (int i = k + 1; i < n; i++)
+                {
+                    L[i * n + k] = (L[i * n + k] - s * v[i]) / c;
+                    v[i] = c * v[i] - s * L[i * n + k];
+                }
+        }
+    return true;
+}
+
+
+arma::vec::fixed<LS_PVT_MAX_UNKNOWNS> Ls_Pvt::leastSquarePos(int nclocks)
+{
+    /* Computes the Least Squares Solution of the stored observations.
      *   Returns:
      *       pos         - receiver position and receiver clock error
-     *                   (in ECEF system: [X, Y, Z, dt])
+     *                   (in ECEF system: [X, Y, Z, dt, dt2 - dt])
+     *
+     * Each iteration accumulates the normal equations A'WWA x = A'WW omc,
+     * with W the diagonal weights matrix, and solves them by Cholesky
+     * decomposition.
      */
 
     //=== Initialization =======================================================
-    int nmbOfIterations = 10; // TODO: include in config
-    int nmbOfSatellites;
-    nmbOfSatellites = satpos.n_cols;    //Armadillo
-    arma::vec pos = "0.0 0.0 0.0 0.0";
-    arma::mat A;
-    arma::mat omc;
-    arma::mat az;
-    arma::mat el;
-    A = arma::zeros(nmbOfSatellites, 4);
-    omc = arma::zeros(nmbOfSatellites, 1);
-    az = arma::zeros(1, nmbOfSatellites);
-    el = arma::zeros(1, nmbOfSatellites);
-    arma::mat X = satpos;
-    arma::vec Rot_X;
+    const int nmbOfIterations = 10; // TODO: include in config
+    const int nmbOfSatellites = d_nobs;
+    const int n = (nclocks == 2) ? 5 : 4;
+    double pos[LS_PVT_MAX_UNKNOWNS] = {0.0, 0.0, 0.0, 0.0, 0.0};
+    double N[LS_PVT_MAX_UNKNOWNS * LS_PVT_MAX_UNKNOWNS];  // weighted normal matrix
+    double Q[LS_PVT_MAX_UNKNOWNS * LS_PVT_MAX_UNKNOWNS];  // unweighted, for the DOP
+    double x[LS_PVT_MAX_UNKNOWNS];
+    double a[LS_PVT_MAX_UNKNOWNS];                       // row of the A matrix
     double rho2;
     double traveltime;
-    double trop = 0.0;
+    double trop;
     double dlambda;
     double dphi;
     double h;
-    arma::mat mat_tmp;
-    arma::vec x;
+    bool solved = false;
+    double * los = d_los.data();
 
     //=== Iteratively find receiver position ===================================
     for (int iter = 0; iter < nmbOfIterations; iter++)
         {
+            for (int j = 0; j < n * n; j++)
+                {
+                    N[j] = 0.0;
+                    Q[j] = 0.0;
+                }
+            for (int j = 0; j < n; j++)
+                {
+                    x[j] = 0.0;
+                }
             for (int i = 0; i < nmbOfSatellites; i++)
                 {
+                    const double * X = &d_satpos[3 * i];
                     if (iter == 0)
                         {
                             //--- Initialize variables at the first iteration --------------
-                            Rot_X = X.col(i); //Armadillo
-                            trop = 0.0;
+                            los[3 * i] = X[0];
+                            los[3 * i + 1] = X[1];
+                            los[3 * i + 2] = X[2];
                         }
                     else
                         {
                             //--- Update equations -----------------------------------------
-                            rho2 = (X(0, i) - pos(0)) *
-                                   (X(0, i) - pos(0)) + (X(1, i) - pos(1)) *
-                                   (X(1, i) - pos(1)) + (X(2, i) - pos(2)) *
-                                   (X(2, i) - pos(2));
+                            rho2 = (X[0] - pos[0]) * (X[0] - pos[0]) +
+                                   (X[1] - pos[1]) * (X[1] - pos[1]) +
+                                   (X[2] - pos[2]) * (X[2] - pos[2]);
                             traveltime = sqrt(rho2) / GPS_C_m_s;
 
                             //--- Correct satellite position (do to earth rotation) --------
-                            Rot_X = Ls_Pvt::rotateSatellite(traveltime, X.col(i)); //armadillo
-
-                            //--- Find DOA and range of satellites
-                            Ls_Pvt::topocent(&d_visible_satellites_Az[i],
-                                     &d_visible_satellites_El[i],
-                                     &d_visible_satellites_Distance[i],
-                                     pos.subvec(0,2),
-                                     Rot_X - pos.subvec(0, 2));
-                            if(traveltime < 0.1 && nmbOfSatellites > 3)
-                                {
-                                    //--- Find receiver's height
-                                    Ls_Pvt::togeod(&dphi, &dlambda, &h, 6378137.0, 298.257223563, pos(0), pos(1), pos(2));
-
-                                    //--- Find delay due to troposphere (in meters)
-                                    Ls_Pvt::tropo(&trop, sin(d_visible_satellites_El[i] * GPS_PI / 180.0), h / 1000.0, 1013.0, 293.0, 50.0, 0.0, 0.0, 0.0);
-                                    if(trop > 50.0 ) trop = 0.0;
-                                }
+                            const double omegatau = OMEGA_EARTH_DOT * traveltime;
+                            const double cos_omegatau = cos(omegatau);
+                            const double sin_omegatau = sin(omegatau);
+                            los[3 * i] = cos_omegatau * X[0] + sin_omegatau * X[1] - pos[0];
+                            los[3 * i + 1] = -sin_omegatau * X[0] + cos_omegatau * X[1] - pos[1];
+                            los[3 * i + 2] = X[2] - pos[2];
+                            d_tropo_mask[i] = (traveltime < 0.1 && nmbOfSatellites > 3) ? 1.0 : 0.0;
+                        }
+                }
+            if (iter > 0)
+                {
+                    //--- Find DOA and range of satellites, and the troposphere delay --
+                    if (d_corrections.stale(pos))
+                        {
+                            //--- Find receiver's height
+                            Ls_Pvt::togeod(&dphi, &dlambda, &h, 6378137.0, 298.257223563, pos[0], pos[1], pos[2]);
+                            d_corrections.set_receiver(pos, dphi, dlambda, h);
                         }
+                    d_corrections.evaluate(los, nmbOfSatellites, d_visible_satellites_Az,
+                            d_visible_satellites_El, d_visible_satellites_Distance, d_trop.data());
+                }
+            for (int i = 0; i < nmbOfSatellites; i++)
+                {
+                    trop = 0.0;
+                    if (iter > 0 && d_tropo_mask[i] > 0.0)
+                        {
+                            trop = d_trop[i];
+                            if(trop > 50.0 ) trop = 0.0;
+                        }
+                    const double dX = los[3 * i];
+                    const double dY = los[3 * i + 1];
+                    const double dZ = los[3 * i + 2];
+                    const bool second_clock = (n == 5 && d_clock[i] == 1);
+
                     //--- Apply the corrections ----------------------------------------
-                    omc(i) = (obs(i) - norm(Rot_X - pos.subvec(0, 2), 2) - pos(3) - trop); // Armadillo
+                    const double omc = d_obs[i] - sqrt(dX * dX + dY * dY + dZ * dZ) - pos[3] - (second_clock ? pos[4] : 0.0) - trop;
 
-                    //--- Construct the A matrix ---------------------------------------
-                    //Armadillo
-                    A(i,0) = (-(Rot_X(0) - pos(0))) / obs(i);
-                    A(i,1) = (-(Rot_X(1) - pos(1))) / obs(i);
-                    A(i,2) = (-(Rot_X(2) - pos(2))) / obs(i);
-                    A(i,3) = 1.0;
+                    //--- Construct the row of the A matrix ----------------------------
+                    a[0] = -dX / d_obs[i];
+                    a[1] = -dY / d_obs[i];
+                    a[2] = -dZ / d_obs[i];
+                    a[3] = 1.0;
+                    a[4] = second_clock ? 1.0 : 0.0;
+                    for (int j = 0; j < LS_PVT_MAX_UNKNOWNS; j++)
+                        {
+                            d_raim_a[LS_PVT_MAX_UNKNOWNS * i + j] = a[j];
+                        }
+                    d_raim_res[i] = omc;
+
+                    //--- Accumulate the lower triangle of the normal equations ---------
+                    const double w2 = d_weight[i] * d_weight[i];
+                    for (int j = 0; j < n; j++)
+                        {
+                            x[j] += w2 * a[j] * omc;
+                            for (int k = 0; k <= j; k++)
+                                {
+                                    N[j * n + k] += w2 * a[j] * a[k];
+                                    Q[j * n + k] += a[j] * a[k];
+                                }
+                        }
                 }
 
             //--- Find position update ---------------------------------------------
-            x = arma::solve(w*A, w*omc); // Armadillo
+            if (!Ls_Pvt::cholesky_decompose(N, n))
+                {
+                    DLOG(INFO) << "Singular Least Squares normal matrix";
+                    solved = false;
+                    break;
+                }
+            Ls_Pvt::cholesky_solve(N, x, n);
+            solved = true;
 
             //--- Apply position update --------------------------------------------
-            pos = pos + x;
-            if (arma::norm(x,2) < 1e-4)
+            double norm_x = 0.0;
+            for (int j = 0; j < n; j++)
+                {
+                    pos[j] += x[j];
+                    norm_x += x[j] * x[j];
+                }
+            if (sqrt(norm_x) < 1e-4)
             {
                 break; // exit the loop because we assume that the LS algorithm has converged (err < 0.1 cm)
             }
         }
 
-    try
-    {
-            //-- compute the Dilution Of Precision values
-            d_Q = arma::inv(arma::htrans(A)*A);
-    }
-    catch(std::exception& e)
-    {
-            d_Q = arma::zeros(4,4);
-    }
+    //-- Fault detection and exclusion, with the residuals of the last iteration
+    d_raim_status = RAIM_UNAVAILABLE;
+    if (d_raim_enabled)
+        {
+            for (int i = 0; i < nmbOfSatellites; i++)
+                {
+                    d_raim_excluded[i] = 0;
+                }
+        }
+    if (d_raim_enabled && solved)
+        {
+            for (int i = 0; i < nmbOfSatellites; i++)
+                {
+                    const double * ai = &d_raim_a[LS_PVT_MAX_UNKNOWNS * i];
+                    for (int j = 0; j < n; j++)
+                        {
+                            d_raim_res[i] -= ai[j] * x[j];
+                        }
+                }
+            raim_fde(pos, N, Q, n);
+        }
+
+    //-- compute the Dilution Of Precision values from inv(A'A)
+    if (!solved || !set_dop_matrix(Q, n))
+        {
+            d_Q.zeros();
+        }
+
+    arma::vec::fixed<LS_PVT_MAX_UNKNOWNS> result;
+    for (int j = 0; j < LS_PVT_MAX_UNKNOWNS; j++)
+        {
+            result(j) = pos[j];
+        }
+    return result;
+}
+
+
+arma::vec::fixed<4> Ls_Pvt::leastSquareVel(const double * rx_pos)
+{
+    /* The pseudorange rate to each satellite is the projection of the relative
+     * velocity on the line of sight plus the receiver clock drift:
+     *     range_rate(i) = (satvel(i) - vel) * los(i) + ddt
+     * which is linear in the unknowns once the position is known, so a
+     * single weighted Least Squares step is enough.
+     */
+    const int n = 4;
+    double N[n * n] = {};
+    double x[n] = {};
+    double a[n];
+    for (int i = 0; i < d_nobs; i++)
+        {
+            double los[3];
+            double range = 0.0;
+            for (int j = 0; j < 3; j++)
+                {
+                    los[j] = d_satpos[3 * i + j] - rx_pos[j];
+                    range += los[j] * los[j];
+                }
+            range = sqrt(range);
+            if (range > 0.0)
+                {
+                    for (int j = 0; j < 3; j++) los[j] = los[j] / range;
+                }
+            const double omc = d_range_rate[i] - (d_satvel[3 * i] * los[0] + d_satvel[3 * i + 1] * los[1] + d_satvel[3 * i + 2] * los[2]);
+            a[0] = -los[0];
+            a[1] = -los[1];
+            a[2] = -los[2];
+            a[3] = 1.0;
+            const double w2 = d_weight[i] * d_weight[i];
+            for (int j = 0; j < n; j++)
+                {
+                    x[j] += w2 * a[j] * omc;
+                    for (int k = 0; k <= j; k++)
+                        {
+                            N[j * n + k] += w2 * a[j] * a[k];
+                        }
+                }
+        }
+    arma::vec::fixed<4> vel;
+    if (Ls_Pvt::cholesky_decompose(N, n))
+        {
+            Ls_Pvt::cholesky_solve(N, x, n);
+            for (int j = 0; j < n; j++) vel(j) = x[j];
+        }
+    else
+        {
+            vel.zeros();
+        }
+    return vel;
+}
+
+
+double Ls_Pvt::predictedRangeRate(int i, const double * rx_pos, const arma::vec::fixed<4> & vel) const
+{
+    double los[3];
+    double range = 0.0;
+    for (int j = 0; j < 3; j++)
+        {
+            los[j] = d_satpos[3 * i + j] - rx_pos[j];
+            range += los[j] * los[j];
+        }
+    range = sqrt(range);
+    double range_rate = vel(3);
+    for (int j = 0; j < 3; j++)
+        {
+            range_rate += (d_satvel[3 * i + j] - vel(j)) * los[j] / range;
+        }
+    return range_rate;
+}
+
+
+bool Ls_Pvt::set_dop_matrix(double * Q, int n)
+{
+    double x[LS_PVT_MAX_UNKNOWNS];
+    if (!Ls_Pvt::cholesky_decompose(Q, n))
+        {
+            return false;
+        }
+    for (int k = 0; k < 4; k++)
+        {
+            for (int j = 0; j < n; j++)
+                {
+                    x[j] = (j == k) ? 1.0 : 0.0;
+                }
+            Ls_Pvt::cholesky_solve(Q, x, n);
+            for (int j = 0; j < 4; j++)
+                {
+                    d_Q(j, k) = x[j];
+                }
+        }
+    return true;
+}
+
+
+/*
+ * Kalman filter tuning. The states are
+ *   x = [X, Y, Z, VX, VY, VZ, c dt, c ddt, c (dt2 - dt)] [m, m/s]
+ * with a constant velocity model driven by white acceleration, and the
+ * two-state clock model with white frequency and random walk frequency noise
+ */
+static const double KF_ACCELERATION_PSD = 1.0;      // [m^2/s^3]
+static const double KF_CLOCK_PHASE_PSD = 0.1;       // [m^2/s]
+static const double KF_CLOCK_FREQUENCY_PSD = 0.1;   // [m^2/s^3]
+static const double KF_CLOCK_OFFSET_PSD = 1e-4;     // second system clock offset [m^2/s]
+static const double KF_PSEUDORANGE_SIGMA_M = 5.0;
+static const double KF_RANGE_RATE_SIGMA_M_S = 0.5;
+static const double KF_INNOVATION_GATE = 25.0;      // squared normalized innovation (5 sigma)
+
+// Leverage above which the solution without an observation is not determined
+static const double RAIM_MAX_LEVERAGE = 1.0 - 1e-9;
+
+
+// Survival function of the chi-square distribution with dof degrees of freedom
+static double chi_square_sf(double x, int dof)
+{
+    const double y = x / 2.0;
+    double term;
+    double sum = 0.0;
+    int j;
+    if (dof % 2 == 0)
+        {
+            term = 1.0;   // y^j / j!
+            j = 0;
+        }
+    else
+        {
+            sum = erfc(sqrt(y)) * exp(y);
+            term = sqrt(y) * 2.0 / sqrt(GPS_PI);   // y^(j - 1/2) / gamma(j + 1/2)
+            j = 1;
+        }
+    for (; 2 * j < dof; j++)
+        {
+            sum += term;
+            term *= y / (j + ((dof % 2 == 0) ? 1.0 : 0.5));
+        }
+    return sum * exp(-y);
+}
+
+
+double Ls_Pvt::chi_square_threshold(double pfa, int dof)
+{
+    if (dof < 1)
+        {
+            return 0.0;
+        }
+    // Upper quantile of the standard normal distribution (Abramowitz and
+    // Stegun 26.2.23, error below 4.5e-4) for the Wilson-Hilferty approximation
+    const double t = sqrt(-2.0 * log(pfa));
+    const double z = t - (2.515517 + 0.802853 * t + 0.010328 * t * t) / (1.0 + 1.432788 * t + 0.189269 * t * t + 0.001308 * t * t * t);
+    const double h = 2.0 / (9.0 * dof);
+    const double c = std::max(1.0 - h + z * sqrt(h), 0.1);
+    double x = dof * c * c * c;
+
+    // Newton iterations on the logarithm of the survival function
+    const double log_pdf_norm = -0.5 * dof * log(2.0) - lgamma(0.5 * dof);
+    for (int iter = 0; iter < 6; iter++)
+        {
+            const double sf = chi_square_sf(x, dof);
+            const double pdf = exp(log_pdf_norm + (0.5 * dof - 1.0) * log(x) - 0.5 * x);
+            if (!(sf > 0.0) || !(pdf > 0.0))
+                {
+                    break;
+                }
+            x = std::max(x + (log(sf) - log(pfa)) * sf / pdf, 0.5 * x);
+        }
+    return x;
+}
+
+
+void Ls_Pvt::set_raim(bool enable, double pfa, double sigma_m, int max_exclusions)
+{
+    d_raim_enabled = enable;
+    d_raim_sigma_m = (sigma_m > 0.0) ? sigma_m : 5.0;
+    d_raim_max_exclusions = std::max(max_exclusions, 0);
+    if (!(pfa > 0.0 && pfa < 0.5))
+        {
+            LOG(WARNING) << "RAIM probability of false alarm " << pfa << " is not valid, using 1e-5";
+            pfa = 1e-5;
+        }
+    for (int dof = 0; dof <= d_max_obs; dof++)
+        {
+            d_raim_chi2[dof] = Ls_Pvt::chi_square_threshold(pfa, dof);
+        }
+}
+
+
+void Ls_Pvt::raim_fde(double * pos, double * L, double * Q, int n)
+{
+    /* The test statistic is the weighted sum of squared residuals over the
+     * variance of a unit weight pseudorange, chi-square distributed with
+     * m - n degrees of freedom without faults. Without observation i, it
+     * becomes SSE - w2 r_i^2 / (1 - h_i), with h_i = w2 a_i N^-1 a_i' its
+     * leverage, and the solution moves by -N^-1 a_i' w2 r_i / (1 - h_i).
+     */
+    const double inv_var = 1.0 / (d_raim_sigma_m * d_raim_sigma_m);
+    double u[LS_PVT_MAX_UNKNOWNS];
+    double dx[LS_PVT_MAX_UNKNOWNS];
+    int m = 0;
+    double sse = 0.0;
+    for (int i = 0; i < d_nobs; i++)
+        {
+            const double w2 = d_weight[i] * d_weight[i];
+            if (w2 > 0.0)
+                {
+                    m++;
+                    sse += w2 * d_raim_res[i] * d_raim_res[i];
+                }
+        }
+    sse *= inv_var;
+    if (m - n < 1)
+        {
+            return;
+        }
+    d_raim_status = RAIM_PASSED;
+    double threshold = d_raim_chi2[m - n];
+    int excluded = 0;
+    while (sse > threshold)
+        {
+            d_raim_status = RAIM_FAILED;
+            if (excluded >= d_raim_max_exclusions || m - n < 2)
+                {
+                    break;
+                }
+
+            //--- Observation whose exclusion leaves the smallest statistic --------
+            int best = -1;
+            double best_sse = 0.0;
+            double best_gain = 0.0;
+            for (int i = 0; i < d_nobs; i++)
+                {
+                    const double w2 = d_weight[i] * d_weight[i];
+                    if (!(w2 > 0.0))
+                        {
+                            continue;
+                        }
+                    // h = w2 |L^-1 a'|^2, forward substitution only
+                    const double * ai = &d_raim_a[LS_PVT_MAX_UNKNOWNS * i];
+                    double h = 0.0;
+                    for (int j = 0; j < n; j++)
+                        {
+                            double v = ai[j];
+                            for (int k = 0; k < j; k++)
+                                {
+                                    v -= L[j * n + k] * u[k];
+                                }
+                            u[j] = v / L[j * n + j];
+                            h += u[j] * u[j];
+                        }
+                    h *= w2;
+                    if (h > RAIM_MAX_LEVERAGE)
+                        {
+                            continue;
+                        }
+                    const double gain = w2 * d_raim_res[i] / (1.0 - h);
+                    const double sse_i = sse - gain * d_raim_res[i] * inv_var;
+                    if (best < 0 || sse_i < best_sse)
+                        {
+                            best = i;
+                            best_sse = sse_i;
+                            best_gain = gain;
+                        }
+                }
+            if (best < 0)
+                {
+                    break;
+                }
+
+            //--- Remove it from the solution, the residuals and the factors -------
+            const double * ab = &d_raim_a[LS_PVT_MAX_UNKNOWNS * best];
+            for (int j = 0; j < n; j++)
+                {
+                    dx[j] = ab[j];
+                }
+            Ls_Pvt::cholesky_solve(L, dx, n);
+            for (int j = 0; j < n; j++)
+                {
+                    dx[j] *= -best_gain;
+                    pos[j] += dx[j];
+                }
+            const double wb = d_weight[best];
+            for (int j = 0; j < n; j++)
+                {
+                    u[j] = wb * ab[j];
+                    for (int k = 0; k <= j; k++)
+                        {
+                            Q[j * n + k] -= ab[j] * ab[k];
+                        }
+                }
+            d_weight[best] = 0.0;
+            d_raim_excluded[best] = 1;
+            m--;
+            excluded++;
+            DLOG(INFO) << "RAIM: satellite " << d_visible_satellites_IDs[best] << " excluded, residual= " << d_raim_res[best] << " [m]";
+            if (!Ls_Pvt::cholesky_downdate(L, u, n))
+                {
+                    break;
+                }
+            sse = 0.0;
+            for (int i = 0; i < d_nobs; i++)
+                {
+                    const double * ai = &d_raim_a[LS_PVT_MAX_UNKNOWNS * i];
+                    for (int j = 0; j < n; j++)
+                        {
+                            d_raim_res[i] -= ai[j] * dx[j];
+                        }
+                    sse += d_weight[i] * d_weight[i] * d_raim_res[i] * d_raim_res[i];
+                }
+            sse *= inv_var;
+            threshold = d_raim_chi2[m - n];
+            d_raim_status = RAIM_EXCLUDED;
+        }
+    if (d_raim_status == RAIM_FAILED)
+        {
+            LOG(INFO) << "RAIM: inconsistent fix, test statistic= " << sse << ", threshold= " << threshold;
+        }
+    d_raim_statistic = sse;
+    d_raim_threshold = threshold;
+}
+
+
+void Ls_Pvt::set_kalman_filter(bool enable)
+{
+    d_kf_enabled = enable;
+    d_kf_initialized = false;
+}
+
+
+arma::vec::fixed<LS_PVT_MAX_UNKNOWNS> Ls_Pvt::solvePosition(double rx_time, int nclocks)
+{
+    arma::vec::fixed<LS_PVT_MAX_UNKNOWNS> pos;
+    d_raim_status = RAIM_UNAVAILABLE;
+    if (d_kf_enabled && d_kf_initialized && kalman_update(rx_time))
+        {
+            pos(0) = d_kf_x[0];
+            pos(1) = d_kf_x[1];
+            pos(2) = d_kf_x[2];
+            pos(3) = d_kf_x[6];
+            pos(4) = d_kf_x[8];
+            return pos;
+        }
+    pos = leastSquarePos(nclocks);
+    if (d_kf_enabled)
+        {
+            kalman_init(pos, nclocks, rx_time);
+        }
     return pos;
 }
+
+
+arma::vec::fixed<4> Ls_Pvt::kalmanVel() const
+{
+    arma::vec::fixed<4> vel;
+    vel(0) = d_kf_x[3];
+    vel(1) = d_kf_x[4];
+    vel(2) = d_kf_x[5];
+    vel(3) = d_kf_x[7];
+    return vel;
+}
+
+
+void Ls_Pvt::kalman_init(const arma::vec::fixed<LS_PVT_MAX_UNKNOWNS> & pos, int nclocks, double rx_time)
+{
+    const int n = LS_PVT_KF_STATES;
+    bool rates = false;
+    for (int i = 0; i < d_nobs; i++)
+        {
+            rates = rates || d_has_rate[i];
+        }
+    for (int j = 0; j < n * n; j++)
+        {
+            d_kf_P[j] = 0.0;
+        }
+    d_kf_x[0] = pos(0);
+    d_kf_x[1] = pos(1);
+    d_kf_x[2] = pos(2);
+    d_kf_x[6] = pos(3);
+    d_kf_x[8] = (nclocks == 2) ? pos(4) : 0.0;
+    if (rates)
+        {
+            arma::vec::fixed<4> vel = leastSquareVel(pos.memptr());
+            d_kf_x[3] = vel(0);
+            d_kf_x[4] = vel(1);
+            d_kf_x[5] = vel(2);
+            d_kf_x[7] = vel(3);
+        }
+    else
+        {
+            d_kf_x[3] = 0.0;
+            d_kf_x[4] = 0.0;
+            d_kf_x[5] = 0.0;
+            d_kf_x[7] = 0.0;
+        }
+    const double var_vel = rates ? 1.0 : 100.0;
+    for (int j = 0; j < 3; j++)
+        {
+            d_kf_P[j * n + j] = 100.0;
+            d_kf_P[(j + 3) * n + (j + 3)] = var_vel;
+        }
+    d_kf_P[6 * n + 6] = 100.0;
+    // without rates, the drift is unknown to the clock oscillator accuracy
+    d_kf_P[7 * n + 7] = rates ? 1.0 : 1e6;
+    d_kf_P[8 * n + 8] = (nclocks == 2) ? 100.0 : 1e6;
+    d_kf_time = rx_time;
+    d_kf_initialized = true;
+}
+
+
+void Ls_Pvt::kalman_scalar_update(const double * h, double innovation, double r)
+{
+    // x = x + K innovation, P = P - K h P, with K = P h' / (h P h' + r)
+    const int n = LS_PVT_KF_STATES;
+    double Ph[LS_PVT_KF_STATES];
+    double s = r;
+    for (int i = 0; i < n; i++)
+        {
+            double v = 0.0;
+            for (int k = 0; k < n; k++)
+                {
+                    v += d_kf_P[i * n + k] * h[k];
+                }
+            Ph[i] = v;
+            s += h[i] * v;
+        }
+    for (int i = 0; i < n; i++)
+        {
+            d_kf_x[i] += Ph[i] * innovation / s;
+            for (int k = 0; k < n; k++)
+                {
+                    d_kf_P[i * n + k] -= Ph[i] * Ph[k] / s;
+                }
+        }
+}
+
+
+bool Ls_Pvt::kalman_update(double rx_time)
+{
+    const int n = LS_PVT_KF_STATES;
+    const double dt = rx_time - d_kf_time;
+    if (dt < 0.0 || dt > LS_PVT_KF_MAX_GAP_S || d_nobs < 4)
+        {
+            return false;
+        }
+
+    //=== Prediction: x = F x, P = F P F' + Q ==================================
+    // F is the identity plus dt in the derivative of each position and of the clock
+    static const int rate_of[LS_PVT_KF_STATES] = {3, 4, 5, -1, -1, -1, 7, -1, -1};
+    double P[LS_PVT_KF_STATES * LS_PVT_KF_STATES];
+    for (int i = 0; i < n; i++)
+        {
+            if (rate_of[i] >= 0)
+                {
+                    d_kf_x[i] += dt * d_kf_x[rate_of[i]];
+                }
+        }
+    for (int i = 0; i < n; i++)
+        {
+            for (int k = 0; k < n; k++)
+                {
+                    double v = d_kf_P[i * n + k];
+                    if (rate_of[i] >= 0)
+                        {
+                            v += dt * d_kf_P[rate_of[i] * n + k];
+                        }
+                    if (rate_of[k] >= 0)
+                        {
+                            v += dt * d_kf_P[i * n + rate_of[k]];
+                        }
+                    if (rate_of[i] >= 0 && rate_of[k] >= 0)
+                        {
+                            v += dt * dt * d_kf_P[rate_of[i] * n + rate_of[k]];
+                        }
+                    P[i * n + k] = v;
+                }
+        }
+    for (int j = 0; j < n * n; j++)
+        {
+            d_kf_P[j] = P[j];
+        }
+    const double dt2 = dt * dt;
+    const double dt3 = dt2 * dt;
+    for (int j = 0; j < 3; j++)
+        {
+            d_kf_P[j * n + j] += KF_ACCELERATION_PSD * dt3 / 3.0;
+            d_kf_P[j * n + j + 3] += KF_ACCELERATION_PSD * dt2 / 2.0;
+            d_kf_P[(j + 3) * n + j] += KF_ACCELERATION_PSD * dt2 / 2.0;
+            d_kf_P[(j + 3) * n + j + 3] += KF_ACCELERATION_PSD * dt;
+        }
+    d_kf_P[6 * n + 6] += KF_CLOCK_PHASE_PSD * dt + KF_CLOCK_FREQUENCY_PSD * dt3 / 3.0;
+    d_kf_P[6 * n + 7] += KF_CLOCK_FREQUENCY_PSD * dt2 / 2.0;
+    d_kf_P[7 * n + 6] += KF_CLOCK_FREQUENCY_PSD * dt2 / 2.0;
+    d_kf_P[7 * n + 7] += KF_CLOCK_FREQUENCY_PSD * dt;
+    d_kf_P[8 * n + 8] += KF_CLOCK_OFFSET_PSD * dt;
+
+    //=== Sequential update with each observation ==============================
+    double Q[LS_PVT_MAX_UNKNOWNS * LS_PVT_MAX_UNKNOWNS] = {};
+    double h[LS_PVT_KF_STATES];
+    double a[LS_PVT_MAX_UNKNOWNS];
+    double dphi;
+    double dlambda;
+    double height;
+    int accepted = 0;
+    int nq = 4;
+    double * los_all = d_los.data();
+    for (int i = 0; i < d_nobs; i++)
+        {
+            const double * X = &d_satpos[3 * i];
+
+            //--- Correct satellite position (do to earth rotation) ----------------
+            double rho2 = (X[0] - d_kf_x[0]) * (X[0] - d_kf_x[0]) +
+                          (X[1] - d_kf_x[1]) * (X[1] - d_kf_x[1]) +
+                          (X[2] - d_kf_x[2]) * (X[2] - d_kf_x[2]);
+            const double omegatau = OMEGA_EARTH_DOT * sqrt(rho2) / GPS_C_m_s;
+            const double cos_omegatau = cos(omegatau);
+            const double sin_omegatau = sin(omegatau);
+            los_all[3 * i] = cos_omegatau * X[0] + sin_omegatau * X[1] - d_kf_x[0];
+            los_all[3 * i + 1] = -sin_omegatau * X[0] + cos_omegatau * X[1] - d_kf_x[1];
+            los_all[3 * i + 2] = X[2] - d_kf_x[2];
+        }
+
+    //--- Find DOA and range of satellites, and the troposphere delay --------------
+    if (d_corrections.stale(d_kf_x))
+        {
+            Ls_Pvt::togeod(&dphi, &dlambda, &height, 6378137.0, 298.257223563, d_kf_x[0], d_kf_x[1], d_kf_x[2]);
+            d_corrections.set_receiver(d_kf_x, dphi, dlambda, height);
+        }
+    d_corrections.evaluate(los_all, d_nobs, d_visible_satellites_Az,
+            d_visible_satellites_El, d_visible_satellites_Distance, d_trop.data());
+
+    for (int i = 0; i < d_nobs; i++)
+        {
+            const bool second_clock = (d_clock[i] == 1);
+            const double range = d_visible_satellites_Distance[i];
+            double los[3];
+            for (int j = 0; j < 3; j++)
+                {
+                    los[j] = los_all[3 * i + j] / range;
+                }
+            double trop = d_trop[i];
+            if(trop > 50.0 ) trop = 0.0;
+
+            //--- Pseudorange ------------------------------------------------------
+            for (int j = 0; j < n; j++)
+                {
+                    h[j] = 0.0;
+                }
+            h[0] = -los[0];
+            h[1] = -los[1];
+            h[2] = -los[2];
+            h[6] = 1.0;
+            h[8] = second_clock ? 1.0 : 0.0;
+            const double w2 = d_weight[i] * d_weight[i];
+            if (w2 <= 0.0)
+                {
+                    continue;
+                }
+            const double r = KF_PSEUDORANGE_SIGMA_M * KF_PSEUDORANGE_SIGMA_M / w2;
+            const double innovation = d_obs[i] - range - d_kf_x[6] - (second_clock ? d_kf_x[8] : 0.0) - trop;
+            double s = r;
+            for (int j = 0; j < n; j++)
+                {
+                    for (int k = 0; k < n; k++)
+                        {
+                            s += h[j] * d_kf_P[j * n + k] * h[k];
+                        }
+                }
+            if (innovation * innovation > KF_INNOVATION_GATE * s)
+                {
+                    DLOG(INFO) << "Kalman filter PVT: observation " << i << " rejected, innovation= " << innovation << " [m]";
+                    continue;
+                }
+            kalman_scalar_update(h, innovation, r);
+            accepted++;
+
+            //--- Pseudorange rate -------------------------------------------------
+            if (d_has_rate[i])
+                {
+                    for (int j = 0; j < n; j++)
+                        {
+                            h[j] = 0.0;
+                        }
+                    h[3] = -los[0];
+                    h[4] = -los[1];
+                    h[5] = -los[2];
+                    h[7] = 1.0;
+                    double predicted = d_kf_x[7];
+                    for (int j = 0; j < 3; j++)
+                        {
+                            predicted += (d_satvel[3 * i + j] - d_kf_x[3 + j]) * los[j];
+                        }
+                    kalman_scalar_update(h, d_range_rate[i] - predicted, KF_RANGE_RATE_SIGMA_M_S * KF_RANGE_RATE_SIGMA_M_S / w2);
+                }
+
+            //--- Geometry for the DOP ---------------------------------------------
+            a[0] = -los[0];
+            a[1] = -los[1];
+            a[2] = -los[2];
+            a[3] = 1.0;
+            a[4] = second_clock ? 1.0 : 0.0;
+            if (second_clock) nq = 5;
+            for (int j = 0; j < LS_PVT_MAX_UNKNOWNS; j++)
+                {
+                    for (int k = 0; k <= j; k++)
+                        {
+                            Q[j * LS_PVT_MAX_UNKNOWNS + k] += a[j] * a[k];
+                        }
+                }
+        }
+    d_kf_time = rx_time;
+    if (2 * accepted <= d_nobs || accepted < 4)
+        {
+            LOG(INFO) << "Kalman filter PVT: " << d_nobs - accepted << " of " << d_nobs << " observations rejected, restarting";
+            d_kf_initialized = false;
+            return false;
+        }
+
+    // DOP from the lower triangle, packed to nq x nq
+    for (int j = 0; j < nq; j++)
+        {
+            for (int k = 0; k <= j; k++)
+                {
+                    Q[j * nq + k] = Q[j * LS_PVT_MAX_UNKNOWNS + k];
+                }
+        }
+    if (!set_dop_matrix(Q, nq))
+        {
+            d_Q.zeros();
+        }
+    return true;
+}
@@ -32,22 +32,243 @@
 #ifndef GNSS_SDR_LS_PVT_H_
 #define GNSS_SDR_LS_PVT_H_
 
-
+#include <vector>
+#include "pvt_corrections_cache.h"
 #include "pvt_solution.h"
 
+//! Largest number of unknowns: ECEF position, receiver clock and the offset of a second system clock
+#define LS_PVT_MAX_UNKNOWNS 5
+
+//! Kalman filter states: ECEF position and velocity, receiver clock and drift, second system clock offset
+#define LS_PVT_KF_STATES 9
+
+//! Longest time between Kalman filter epochs before it restarts [s]
+#define LS_PVT_KF_MAX_GAP_S 10.0
+
+//! Result of the RAIM fault detection and exclusion of the last Least Squares fix
+enum Ls_Pvt_Raim_Status
+{
+    RAIM_UNAVAILABLE,   //!< disabled, no fix, or no redundant observation
+    RAIM_PASSED,        //!< the residuals are consistent
+    RAIM_EXCLUDED,      //!< consistent after excluding one or more observations
+    RAIM_FAILED         //!< inconsistent, and no exclusion restores the consistency
+};
+
 /*!
  * \brief Base class for the Least Squares PVT solution
  *
+ * The observations of an epoch are stored with add_observation() in arrays
+ * allocated once at construction, for up to max_observations satellites,
+ * and solved in place: the weights matrix is diagonal, so it is kept as a
+ * vector, and the normal equations (at most 5x5) are solved by Cholesky
+ * decomposition. No memory is allocated per epoch.
+ *
+ * Alternatively, solvePosition() runs an extended Kalman filter that keeps
+ * position, velocity and clocks between epochs, so each epoch costs a single
+ * update with each observation instead of several Least Squares iterations.
+ *
+ * With set_raim(), each Least Squares fix is followed by a fault detection
+ * test on the weighted sum of squared residuals, and by the exclusion of the
+ * observation whose removal best restores the consistency. The exclusions
+ * are evaluated from the factorization of the normal matrix of the fix:
+ * the residual of the solution without observation i follows from its
+ * leverage, and the factor is downdated by rank one once it is removed, so
+ * detection and exclusion cost O(m n^2) instead of one fix per subset.
+ *
+ * The azimuth, elevation and troposphere delay of the satellites are
+ * evaluated for all of them at once, from the receiver terms of a
+ * Pvt_Corrections_Cache that both engines share: the geodetic coordinates
+ * of the receiver are only computed again when it moves.
  */
 class Ls_Pvt : public Pvt_Solution
 {
 public:
-    Ls_Pvt();
+    Ls_Pvt(int max_observations = PVT_MAX_CHANNELS);
+
+    //! Removes the observations of the previous epoch
+    void clear_observations();
+
+    /*!
+     * \brief Adds the observation of a satellite for the next solution
+     *
+     * \param[in] satpos      Satellite position in ECEF system [m]
+     * \param[in] satvel      Satellite velocity in ECEF system [m/s], or 0 if the velocity is not solved
+     * \param[in] obs         Pseudorange corrected with the satellite clock [m]
+     * \param[in] range_rate  Pseudorange rate (minus the Doppler times the wavelength) [m/s]
+     * \param[in] w           Weight, the diagonal element of the weights matrix
+     * \param[in] clock       Receiver clock of the observation: 0, or 1 for the second system of a hybrid solution
+     *
+     * \return false if the solver is full and the observation has been discarded
+     */
+    bool add_observation(const double * satpos, const double * satvel, double obs, double range_rate, double w, int clock);
+
+    //! Number of stored observations
+    int num_observations() const
+    {
+        return d_nobs;
+    }
+
+    /*!
+     * \brief Least Squares receiver position of the stored observations
+     *
+     * \param[in] nclocks  1 for a common receiver clock, 2 to estimate the clock
+     *                     offset of the observations with clock = 1
+     *
+     * \return Receiver position and clocks: [X, Y, Z, dt, dt2 - dt] [m], with d_Q
+     * the (unweighted) covariance of the position and the first clock
+     */
+    arma::vec::fixed<LS_PVT_MAX_UNKNOWNS> leastSquarePos(int nclocks = 1);
+
+    /*!
+     * \brief Least Squares receiver velocity of the stored observations,
+     * at the receiver position rx_pos [m], from their pseudorange rates
+     *
+     * \return Receiver velocity and clock drift: [VX, VY, VZ, ddt] [m/s]
+     */
+    arma::vec::fixed<4> leastSquareVel(const double * rx_pos);
+
+    /*!
+     * \brief Selects the extended Kalman filter engine in solvePosition(),
+     * instead of a Least Squares solution per epoch
+     */
+    void set_kalman_filter(bool enable);
+
+    bool kalman_filter() const
+    {
+        return d_kf_enabled;
+    }
+
+    /*!
+     * \brief Enables the fault detection and exclusion of leastSquarePos()
+     *
+     * \param[in] enable          Tests every Least Squares fix
+     * \param[in] pfa             Probability of false alarm of the test
+     * \param[in] sigma_m         Standard deviation of the error of a pseudorange of weight 1 [m]
+     * \param[in] max_exclusions  Largest number of observations excluded from a fix
+     */
+    void set_raim(bool enable, double pfa, double sigma_m, int max_exclusions);
+
+    Ls_Pvt_Raim_Status raim_status() const
+    {
+        return d_raim_status;
+    }
+
+    //! Weighted sum of squared residuals of the fix over sigma_m^2, after the exclusions
+    double raim_test_statistic() const
+    {
+        return d_raim_statistic;
+    }
+
+    //! Detection threshold of the test statistic of the last fix
+    double raim_threshold() const
+    {
+        return d_raim_threshold;
+    }
+
+    //! True if the stored observation i was excluded from the last fix. Its weight is set to 0.
+    bool raim_excluded(int i) const
+    {
+        return d_raim_excluded[i] != 0;
+    }
+
+    /*!
+     * \brief Upper pfa quantile of the chi-square distribution with dof
+     * degrees of freedom: the Wilson-Hilferty approximation, refined by
+     * Newton iterations on the survival function
+     */
+    static double chi_square_threshold(double pfa, int dof);
+
+    //! Restarts the Kalman filter from a Least Squares solution at the next epoch
+    void reset_kalman_filter()
+    {
+        d_kf_initialized = false;
+    }
+
+    /*!
+     * \brief Receiver position of the stored observations at the receiver time
+     * rx_time [s] with the selected engine: [X, Y, Z, dt, dt2 - dt] [m]
+     *
+     * The Kalman filter propagates its state from the previous epoch and is
+     * updated with each pseudorange and, if the satellite velocity was given,
+     * each pseudorange rate. It starts from a Least Squares solution, and
+     * restarts after a gap of more than LS_PVT_KF_MAX_GAP_S or when most of
+     * the observations fail the innovation test.
+     */
+    arma::vec::fixed<LS_PVT_MAX_UNKNOWNS> solvePosition(double rx_time, int nclocks = 1);
+
+    //! Receiver velocity and clock drift of the Kalman filter: [VX, VY, VZ, ddt] [m/s]
+    arma::vec::fixed<4> kalmanVel() const;
+
+    /*!
+     * \brief Pseudorange rate of the stored observation i predicted by the
+     * velocity solution vel at the receiver position rx_pos [m]
+     */
+    double predictedRangeRate(int i, const double * rx_pos, const arma::vec::fixed<4> & vel) const;
+
+    /*!
+     * \brief Cholesky decomposition N = L L' in place of a symmetric positive
+     * definite n x n matrix (row-major, only the lower triangle is read).
+     * Returns false if N is not positive definite.
+     */
+    static bool cholesky_decompose(double * N, int n);
+
+    /*!
+     * \brief Solves L L' x = b in place, with L from cholesky_decompose()
+     */
+    static void cholesky_solve(const double * L, double * b, int n);
+
+    /*!
+     * \brief Rank-one downdate of a Cholesky factor in place: L L' becomes
+     * L L' - v v'. v is destroyed. Returns false if the result is not
+     * positive definite, in which case L is no longer valid.
+     */
+    static bool cholesky_downdate(double * L, double * v, int n);
 
-    arma::vec leastSquarePos(const arma::mat & satpos, const arma::vec & obs, const arma::mat & w);
     double d_x_m;
     double d_y_m;
     double d_z_m;
+
+private:
+    // d_Q from the lower triangle of the n x n unweighted normal matrix, destroyed
+    bool set_dop_matrix(double * Q, int n);
+    void kalman_init(const arma::vec::fixed<LS_PVT_MAX_UNKNOWNS> & pos, int nclocks, double rx_time);
+    bool kalman_update(double rx_time);
+    // Fault detection and exclusion of the fix pos, with L the factor of the
+    // weighted normal matrix and Q the lower triangle of the unweighted one
+    void raim_fde(double * pos, double * L, double * Q, int n);
+    void kalman_scalar_update(const double * h, double innovation, double r);
+
+    int d_max_obs;
+    int d_nobs;
+    std::vector<double> d_satpos;      // X, Y, Z of each observation [m]
+    std::vector<double> d_satvel;      // VX, VY, VZ of each observation [m/s]
+    std::vector<double> d_obs;
+    std::vector<double> d_range_rate;
+    std::vector<double> d_weight;
+    std::vector<int> d_clock;
+    std::vector<int> d_has_rate;
+
+    Pvt_Corrections_Cache d_corrections;
+    std::vector<double> d_los;         // receiver to rotated satellite of each observation [m]
+    std::vector<double> d_trop;        // troposphere delay of each observation [m]
+    std::vector<double> d_tropo_mask;  // 1 if the troposphere delay of the observation is applied
+
+    bool d_raim_enabled;
+    double d_raim_sigma_m;
+    int d_raim_max_exclusions;
+    Ls_Pvt_Raim_Status d_raim_status;
+    double d_raim_statistic;
+    double d_raim_threshold;
+    std::vector<double> d_raim_chi2;   // detection threshold by degrees of freedom
+    std::vector<double> d_raim_a;      // rows of A of the last iteration, LS_PVT_MAX_UNKNOWNS per observation
+    std::vector<double> d_raim_res;    // residuals of the last iteration [m]
+    std::vector<int> d_raim_excluded;
+
+    bool d_kf_enabled;
+    bool d_kf_initialized;
+    double d_kf_time;
+    double d_kf_x[LS_PVT_KF_STATES];
+    double d_kf_P[LS_PVT_KF_STATES * LS_PVT_KF_STATES];
 };
 
 #endif
@@ -0,0 +1,114 @@
+/*!
+ * \file moving_window_statistics.cc
+ * \brief Mean and covariance of the last samples of a vector, in constant time
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "moving_window_statistics.h"
+#include <algorithm>
+
+
+Moving_Window_Statistics::Moving_Window_Statistics(unsigned int dimension, unsigned int depth)
+{
+    d_dimension = std::max(dimension, 1u);
+    d_depth = 0;
+    reset(depth);
+}
+
+
+void Moving_Window_Statistics::reset(unsigned int depth)
+{
+    d_depth = std::max(depth, 1u);
+    d_count = 0;
+    d_next = 0;
+    const Compensated_Sum zero = {0.0, 0.0};
+    d_ring.assign(d_depth * d_dimension, 0.0);
+    d_reference.assign(d_dimension, 0.0);
+    d_sums.assign(d_dimension, zero);
+    d_products.assign(d_dimension * (d_dimension + 1) / 2, zero);
+}
+
+
+unsigned int Moving_Window_Statistics::product_index(unsigned int i, unsigned int j) const
+{
+    if (i > j) std::swap(i, j);
+    return i * d_dimension - i * (i - 1) / 2 + (j - i);
+}
+
+
+void Moving_Window_Statistics::push(const double* sample)
+{
+    if (d_count == 0)
+        {
+            d_reference.assign(sample, sample + d_dimension);
+        }
+    double* slot = &d_ring[d_next * d_dimension];
+    if (full())
+        {
+            // the oldest sample leaves the window
+            for (unsigned int i = 0; i < d_dimension; i++)
+                {
+                    d_sums[i].add(-slot[i]);
+                    for (unsigned int j = i; j < d_dimension; j++)
+                        {
+                            d_products[product_index(i, j)].add(-slot[i] * slot[j]);
+                        }
+                }
+        }
+    else
+        {
+            d_count++;
+        }
+    for (unsigned int i = 0; i < d_dimension; i++)
+        {
+            slot[i] = sample[i] - d_reference[i];
+        }
+    for (unsigned int i = 0; i < d_dimension; i++)
+        {
+            d_sums[i].add(slot[i]);
+            for (unsigned int j = i; j < d_dimension; j++)
+                {
+                    d_products[product_index(i, j)].add(slot[i] * slot[j]);
+                }
+        }
+    d_next = (d_next + 1) % d_depth;
+}
+
+
+double Moving_Window_Statistics::mean(unsigned int i) const
+{
+    if (d_count == 0) return 0.0;
+    return d_reference[i] + d_sums[i].sum / static_cast<double>(d_count);
+}
+
+
+double Moving_Window_Statistics::covariance(unsigned int i, unsigned int j) const
+{
+    if (d_count < 2) return 0.0;
+    const double n = static_cast<double>(d_count);
+    return (d_products[product_index(i, j)].sum - d_sums[i].sum * d_sums[j].sum / n) / (n - 1.0);
+}
@@ -0,0 +1,104 @@
+/*!
+ * \file moving_window_statistics.h
+ * \brief Mean and covariance of the last samples of a vector, in constant time
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MOVING_WINDOW_STATISTICS_H_
+#define GNSS_SDR_MOVING_WINDOW_STATISTICS_H_
+
+#include <vector>
+
+/*!
+ * \brief Mean and covariance of the last \p depth samples of a vector of
+ * \p dimension components.
+ *
+ * The samples are kept in a ring buffer, and the sums of the components and
+ * of their products are updated when a sample enters or leaves the window,
+ * so push() costs O(dimension^2) whatever the depth. The sums are
+ * Kahan-compensated, and the samples are taken relative to the first one,
+ * so that values such as ECEF coordinates, of some 10^6 m, keep their
+ * centimeter-level variance over long runs.
+ */
+class Moving_Window_Statistics
+{
+public:
+    Moving_Window_Statistics(unsigned int dimension = 3, unsigned int depth = 1);
+
+    //! Empties the window and sets its length
+    void reset(unsigned int depth);
+
+    void push(const double* sample);
+
+    unsigned int depth() const
+    {
+        return d_depth;
+    }
+
+    //! Samples in the window, up to depth()
+    unsigned int size() const
+    {
+        return d_count;
+    }
+
+    bool full() const
+    {
+        return d_count == d_depth;
+    }
+
+    double mean(unsigned int i) const;
+
+    //! Sample covariance (divided by size() - 1) of components i and j, 0 with less than two samples
+    double covariance(unsigned int i, unsigned int j) const;
+
+private:
+    struct Compensated_Sum
+    {
+        double sum;
+        double compensation;
+        void add(double x)
+        {
+            double y = x - compensation;
+            double t = sum + y;
+            compensation = (t - sum) - y;
+            sum = t;
+        }
+    };
+
+    unsigned int product_index(unsigned int i, unsigned int j) const;
+
+    unsigned int d_dimension;
+    unsigned int d_depth;
+    unsigned int d_count;
+    unsigned int d_next;                     // ring buffer slot of the next sample
+    std::vector<double> d_ring;              // samples minus d_reference, depth x dimension
+    std::vector<double> d_reference;         // first sample since reset()
+    std::vector<Compensated_Sum> d_sums;
+    std::vector<Compensated_Sum> d_products; // upper triangle, by rows
+};
+
+#endif /* GNSS_SDR_MOVING_WINDOW_STATISTICS_H_ */
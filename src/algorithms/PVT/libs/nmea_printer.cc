@@ -34,8 +34,13 @@
  */
 
 #include "nmea_printer.h"
+#include "gnss_sdr_trace.h"
+#include <cmath>
+#include <cstdio>
 #include <fcntl.h>
 #include <termios.h>
+#include <unistd.h>
+#include <sys/uio.h>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <glog/logging.h>
 #include <gflags/gflags.h>
@@ -84,6 +89,24 @@ Nmea_Printer::~Nmea_Printer()
 }
 
 
+bool Nmea_Printer::open_file(const std::string & filename)
+{
+    if (nmea_file_descriptor.is_open())
+        {
+            nmea_file_descriptor.close();
+        }
+    nmea_filename = filename;
+    nmea_file_descriptor.open(nmea_filename.c_str(), std::ios::out);
+    if (nmea_file_descriptor.is_open())
+        {
+            DLOG(INFO) << "NMEA printer writing on " << nmea_filename.c_str();
+            return true;
+        }
+    DLOG(INFO) << "NMEA printer can not open " << nmea_filename.c_str();
+    return false;
+}
+
+
 
 
 int Nmea_Printer::init_serial (std::string serial_device)
@@ -133,64 +156,120 @@ void Nmea_Printer::close_serial ()
 }
 
 
-bool Nmea_Printer::Print_Nmea_Line(const std::shared_ptr<Pvt_Solution>& pvt_data, bool print_average_values)
+void Nmea_Buffer::begin(const char* header)
 {
-    std::string GPRMC;
-    std::string GPGGA;
-    std::string GPGSA;
-    std::string GPGSV;
+    clear();
+    if (*header == '$')
+        {
+            d_data[d_size++] = *header++;
+        }
+    append(header);
+}
 
+
+void Nmea_Buffer::append(const char* text)
+{
+    while (*text != '\0')
+        {
+            append(*text++);
+        }
+}
+
+
+void Nmea_Buffer::append(char c)
+{
+    if (d_size < NMEA_BUFFER_SIZE)
+        {
+            d_data[d_size++] = c;
+            d_checksum ^= static_cast<unsigned char>(c);
+        }
+}
+
+
+void Nmea_Buffer::append_padded(const char* text, int length, unsigned int width)
+{
+    for (int i = length; i < static_cast<int>(width); i++)
+        {
+            append('0');
+        }
+    append(text);
+}
+
+
+void Nmea_Buffer::append_int(int value, unsigned int width)
+{
+    char text[16];
+    int length = std::snprintf(text, sizeof(text), "%d", value);
+    append_padded(text, length, width);
+}
+
+
+void Nmea_Buffer::append_fixed(double value, int precision, unsigned int width)
+{
+    char text[64];
+    int length = std::snprintf(text, sizeof(text), "%.*f", precision, value);
+    if (length >= static_cast<int>(sizeof(text)))
+        {
+            length = sizeof(text) - 1;
+        }
+    append_padded(text, length, width);
+}
+
+
+void Nmea_Buffer::end()
+{
+    static const char hex_digits[] = "0123456789abcdef";
+    const unsigned char checksum = d_checksum;
+    append('*');
+    append(hex_digits[checksum >> 4]);
+    append(hex_digits[checksum & 0x0F]);
+    append("\r\n");
+}
+
+
+
+bool Nmea_Printer::Print_Nmea_Line(const std::shared_ptr<Pvt_Solution>& pvt_data, bool print_average_values)
+{
+    GNSS_SDR_TRACE_SCOPE("Nmea_Printer::Print_Nmea_Line");
     // set the new PVT data
     d_PVT_data = pvt_data;
     print_avg_pos = print_average_values;
 
     // generate the NMEA sentences
-
     //GPRMC
-    GPRMC = get_GPRMC();
+    get_GPRMC(d_GPRMC);
     //GPGGA (Global Positioning System Fixed Data)
-    GPGGA = get_GPGGA();
+    get_GPGGA(d_GPGGA);
     //GPGSA
-    GPGSA = get_GPGSA();
+    get_GPGSA(d_GPGSA);
     //GPGSV
-    GPGSV = get_GPGSV();
+    get_GPGSV(d_GPGSV);
+
+    const Nmea_Buffer* sentences[4] = {&d_GPRMC, &d_GPGGA, &d_GPGSA, &d_GPGSV};
 
     // write to log file
     try
     {
-            //GPRMC
-            nmea_file_descriptor << GPRMC;
-            //GPGGA (Global Positioning System Fixed Data)
-            nmea_file_descriptor << GPGGA;
-            //GPGSA
-            nmea_file_descriptor << GPGSA;
-            //GPGSV
-            nmea_file_descriptor << GPGSV;
+            for (int i = 0; i < 4; i++)
+                {
+                    nmea_file_descriptor.write(sentences[i]->data(), sentences[i]->size());
+                }
     }
     catch(std::exception ex)
     {
             DLOG(INFO) << "NMEA printer can not write on output file" << nmea_filename.c_str();;
     }
 
-    //write to serial device
+    //write to serial device, all the sentences of the epoch at once
     if (nmea_dev_descriptor!=-1)
         {
-            if(write(nmea_dev_descriptor, GPRMC.c_str(), GPRMC.length()) == -1)
-                {
-                    DLOG(INFO) << "NMEA printer cannot write on serial device" << nmea_devname.c_str();
-                    return false;
-                }
-            if(write(nmea_dev_descriptor, GPGGA.c_str(), GPGGA.length()) == -1)
+            struct iovec iov[4];
+            for (int i = 0; i < 4; i++)
                 {
-                    DLOG(INFO) << "NMEA printer cannot write on serial device" << nmea_devname.c_str();
-                    return false;
+                    iov[i].iov_base = const_cast<char*>(sentences[i]->data());
+                    iov[i].iov_len = sentences[i]->size();
                 }
-            if(write(nmea_dev_descriptor, GPGSA.c_str(), GPGSA.length()) == -1)
-                {
-                    DLOG(INFO) << "NMEA printer cannot write on serial device" << nmea_devname.c_str();
-                    return false;
-                }
-            if(write(nmea_dev_descriptor, GPGSV.c_str(), GPGSV.length()) == -1)
+            if(writev(nmea_dev_descriptor, iov, 4) == -1)
                 {
                     DLOG(INFO) << "NMEA printer cannot write on serial device" << nmea_devname.c_str();
                     return false;
@@ -201,21 +280,7 @@ bool Nmea_Printer::Print_Nmea_Line(const std::shared_ptr<Pvt_Solution>& pvt_data
 
 
 
-char Nmea_Printer::checkSum(std::string sentence)
-{
-    char check = 0;
-    // iterate over the string, XOR each byte with the total sum:
-    for (unsigned int c = 0; c < sentence.length(); c++)
-        {
-            check = char(check ^ sentence.at(c));
-        }
-    // return the result
-    return check;
-}
-
-
-
-std::string Nmea_Printer::latitude_to_hm(double lat)
+void Nmea_Printer::latitude_to_hm(double lat, Nmea_Buffer & sentence)
 {
     bool north;
     if (lat < 0.0)
@@ -231,29 +296,22 @@ std::string Nmea_Printer::latitude_to_hm(double lat)
     int deg = static_cast<int>(lat);
     double mins = lat - static_cast<double>(deg);
     mins *= 60.0 ;
-    std::ostringstream out_string;
-    out_string.setf(std::ios::fixed, std::ios::floatfield);
-    out_string.fill('0');
-    out_string.width(2);
-    out_string << deg;
-    out_string.width(6);
-    out_string.precision(4);
-    out_string << mins;
+    sentence.append_int(deg, 2);
+    sentence.append_fixed(mins, 4, 6);
 
     if (north == true)
         {
-            out_string << ",N";
+            sentence.append(",N");
         }
     else
         {
-            out_string << ",S";
+            sentence.append(",S");
         }
-    return out_string.str();
 }
 
 
 
-std::string Nmea_Printer::longitude_to_hm(double longitude)
+void Nmea_Printer::longitude_to_hm(double longitude, Nmea_Buffer & sentence)
 {
     bool east;
     if (longitude < 0.0)
@@ -268,33 +326,24 @@ std::string Nmea_Printer::longitude_to_hm(double longitude)
     int deg = static_cast<int>(longitude);
     double mins = longitude - static_cast<double>(deg);
     mins *= 60.0 ;
-    std::ostringstream out_string;
-    out_string.setf(std::ios::fixed, std::ios::floatfield);
-    out_string.width(3);
-    out_string.fill('0');
-    out_string << deg;
-    out_string.width(6);
-    out_string.precision(4);
-    out_string << mins;
+    sentence.append_int(deg, 3);
+    sentence.append_fixed(mins, 4, 6);
 
     if (east == true)
         {
-            out_string << ",E";
+            sentence.append(",E");
         }
     else
         {
-            out_string << ",W";
+            sentence.append(",W");
         }
-    return out_string.str();
 }
 
 
 
-std::string Nmea_Printer::get_UTC_NMEA_time(boost::posix_time::ptime d_position_UTC_time)
+void Nmea_Printer::get_UTC_NMEA_time(const boost::posix_time::ptime & d_position_UTC_time, Nmea_Buffer & sentence)
 {
     //UTC Time: hhmmss.sss
-    std::stringstream sentence_str;
-
     boost::posix_time::time_duration td = d_position_UTC_time.time_of_day();
     int utc_hours;
     int utc_mins;
@@ -306,36 +355,16 @@ std::string Nmea_Printer::get_UTC_NMEA_time(boost::posix_time::ptime d_position_
     utc_seconds = td.seconds();
     utc_milliseconds = td.total_milliseconds() - td.total_seconds()*1000;
 
-    if (utc_hours < 10) sentence_str << "0"; //  two digits for hours
-    sentence_str << utc_hours;
-
-    if (utc_mins < 10) sentence_str << "0"; //  two digits for minutes
-    sentence_str << utc_mins;
-
-    if (utc_seconds < 10) sentence_str << "0"; //  two digits for seconds
-    sentence_str << utc_seconds;
-
-    if (utc_milliseconds < 10)
-        {
-            sentence_str << ".00"; //  three digits for ms
-            sentence_str << utc_milliseconds;
-        }
-    else if (utc_milliseconds < 100)
-        {
-            sentence_str << ".0"; //   three digits for ms
-            sentence_str << utc_milliseconds;
-        }
-    else
-        {
-            sentence_str << "."; //   three digits for ms
-            sentence_str << utc_milliseconds;
-        }
-    return sentence_str.str();
+    sentence.append_int(utc_hours, 2);
+    sentence.append_int(utc_mins, 2);
+    sentence.append_int(utc_seconds, 2);
+    sentence.append('.');
+    sentence.append_int(utc_milliseconds, 3);
 }
 
 
 
-std::string Nmea_Printer::get_GPRMC()
+void Nmea_Printer::get_GPRMC(Nmea_Buffer & sentence)
 {
     // Sample -> $GPRMC,161229.487,A,3723.2475,N,12158.3416,W,0.13,309.62,120598,*10
     bool valid_fix = d_PVT_data->b_valid_position;
@@ -344,55 +373,47 @@ std::string Nmea_Printer::get_GPRMC()
     double speed_over_ground_knots = 0;
     double course_over_ground_deg = 0;
 
-    //boost::posix_time::ptime d_position_UTC_time=boost::posix_time::microsec_clock::universal_time();
-
-    std::stringstream sentence_str;
-
     //GPRMC (RMC-Recommended,Minimum Specific GNSS Data)
-    std::string sentence_header;
-    sentence_header = "$GPRMC,";
-    sentence_str << sentence_header;
+    sentence.begin("$GPRMC,");
 
     //UTC Time: hhmmss.sss
-    sentence_str << get_UTC_NMEA_time(d_PVT_data->d_position_UTC_time);
+    get_UTC_NMEA_time(d_PVT_data->d_position_UTC_time, sentence);
 
     //Status: A: data valid, V: data NOT valid
-
     if (valid_fix == true)
         {
-            sentence_str << ",A";
+            sentence.append(",A");
         }
     else
         {
-            sentence_str << ",V";
+            sentence.append(",V");
         };
 
+    sentence.append(',');
     if (print_avg_pos == true)
         {
             // Latitude ddmm.mmmm,(N or S)
-            sentence_str << "," << latitude_to_hm(d_PVT_data->d_avg_latitude_d);
+            latitude_to_hm(d_PVT_data->d_avg_latitude_d, sentence);
             // longitude dddmm.mmmm,(E or W)
-            sentence_str << "," << longitude_to_hm(d_PVT_data->d_avg_longitude_d);
+            sentence.append(',');
+            longitude_to_hm(d_PVT_data->d_avg_longitude_d, sentence);
         }
     else
         {
             // Latitude ddmm.mmmm,(N or S)
-            sentence_str << "," << latitude_to_hm(d_PVT_data->d_latitude_d);
+            latitude_to_hm(d_PVT_data->d_latitude_d, sentence);
             // longitude dddmm.mmmm,(E or W)
-            sentence_str << "," << longitude_to_hm(d_PVT_data->d_longitude_d);
+            sentence.append(',');
+            longitude_to_hm(d_PVT_data->d_longitude_d, sentence);
         }
 
     //Speed over ground (knots)
-    sentence_str << ",";
-    sentence_str.setf(std::ios::fixed, std::ios::floatfield);
-    sentence_str.precision(2);
-    sentence_str << speed_over_ground_knots;
+    sentence.append(',');
+    sentence.append_fixed(speed_over_ground_knots, 2);
 
     //course over ground (degrees)
-    sentence_str << ",";
-    sentence_str.setf(std::ios::fixed, std::ios::floatfield);
-    sentence_str.precision(2);
-    sentence_str << course_over_ground_deg;
+    sentence.append(',');
+    sentence.append_fixed(course_over_ground_deg, 2);
 
     // Date ddmmyy
     boost::gregorian::date sentence_date = d_PVT_data->d_position_UTC_time.date();
@@ -400,44 +421,26 @@ std::string Nmea_Printer::get_GPRMC()
     unsigned int day = sentence_date.day();
     unsigned int month = sentence_date.month();
 
-    sentence_str << ",";
-    sentence_str.width(2);
-    sentence_str.fill('0');
-    sentence_str << day;
-    sentence_str.width(2);
-    sentence_str.fill('0');
-    sentence_str << month;
-
-    std::stringstream year_strs;
-    year_strs << std::dec << year;
-    sentence_str << std::dec << year_strs.str().substr(2);
+    sentence.append(',');
+    sentence.append_int(day, 2);
+    sentence.append_int(month, 2);
+    sentence.append_int(year % 100, 2);
 
     //Magnetic Variation (degrees)
     // ToDo: Implement magnetic compass
-    sentence_str << ",";
+    sentence.append(',');
 
     //Magnetic Variation (E or W)
     // ToDo: Implement magnetic compass
-    sentence_str << ",";
-
-    // Checksum
-    char checksum;
-    std::string tmpstr;
-    tmpstr = sentence_str.str();
-    checksum = checkSum(tmpstr.substr(1));
-    sentence_str << "*";
-    sentence_str.width(2);
-    sentence_str.fill('0');
-    sentence_str << std::hex << static_cast<int>(checksum);
-
-    // end NMEA sentence
-    sentence_str << "\r\n";
-    return sentence_str.str();
+    sentence.append(',');
+
+    // Checksum and end of NMEA sentence
+    sentence.end();
 }
 
 
 
-std::string Nmea_Printer::get_GPGSA()
+void Nmea_Printer::get_GPGSA(Nmea_Buffer & sentence)
 {
     //$GPGSA,A,3,07,02,26,27,09,04,15, , , , , ,1.8,1.0,1.5*33
     // GSA-GNSS DOP and Active Satellites
@@ -447,16 +450,12 @@ std::string Nmea_Printer::get_GPGSA()
     double hdop = d_PVT_data->d_HDOP;
     double vdop = d_PVT_data->d_VDOP;
 
-    std::stringstream sentence_str;
-    std::string sentence_header;
-    sentence_header = "$GPGSA,";
-    sentence_str << sentence_header;
+    sentence.begin("$GPGSA,");
 
     // mode1:
     // (M) Manual-forced to operate in 2D or 3D mode
     // (A) Automatic-allowed to automatically switch 2D/3D
-    std::string mode1 = "M";
-    sentence_str << mode1;
+    sentence.append('M');
 
     // mode2:
     // 1 fix not available
@@ -464,76 +463,48 @@ std::string Nmea_Printer::get_GPGSA()
     // 3 fix 3D
     if (valid_fix==true)
         {
-            sentence_str << ",3";
+            sentence.append(",3");
         }
     else
         {
-            sentence_str << ",1";
+            sentence.append(",1");
         };
 
     // Used satellites
     for (int i=0; i<12; i++)
         {
-            sentence_str << ",";
+            sentence.append(',');
             if (i < n_sats_used)
                 {
-                    sentence_str.width(2);
-                    sentence_str.fill('0');
-                    sentence_str << d_PVT_data->d_visible_satellites_IDs[i];
+                    sentence.append_int(d_PVT_data->d_visible_satellites_IDs[i], 2);
                 }
         }
 
     // PDOP
-    sentence_str << ",";
-    sentence_str.setf(std::ios::fixed, std::ios::floatfield);
-    sentence_str.width(2);
-    sentence_str.precision(1);
-    sentence_str.fill('0');
-    sentence_str << pdop;
+    sentence.append(',');
+    sentence.append_fixed(pdop, 1, 2);
     //HDOP
-    sentence_str<<",";
-    sentence_str.setf(std::ios::fixed, std::ios::floatfield);
-    sentence_str.width(2);
-    sentence_str.precision(1);
-    sentence_str.fill('0');
-    sentence_str << hdop;
+    sentence.append(',');
+    sentence.append_fixed(hdop, 1, 2);
     //VDOP
-    sentence_str << ",";
-    sentence_str.setf(std::ios::fixed, std::ios::floatfield);
-    sentence_str.width(2);
-    sentence_str.precision(1);
-    sentence_str.fill('0');
-    sentence_str << vdop;
-
-    // Checksum
-    char checksum;
-    std::string tmpstr;
-    tmpstr = sentence_str.str();
-    checksum = checkSum(tmpstr.substr(1));
-    sentence_str << "*";
-    sentence_str.width(2);
-    sentence_str.fill('0');
-    sentence_str << std::hex << static_cast<int>(checksum);
-
-    // end NMEA sentence
-    sentence_str << "\r\n";
-    return sentence_str.str();
+    sentence.append(',');
+    sentence.append_fixed(vdop, 1, 2);
+
+    // Checksum and end of NMEA sentence
+    sentence.end();
 }
 
 
 
 
-std::string Nmea_Printer::get_GPGSV()
+void Nmea_Printer::get_GPGSV(Nmea_Buffer & sentence)
 {
     // GSV-GNSS Satellites in View
     // Notice that NMEA 2.1 only supports 12 channels
     int n_sats_used = d_PVT_data->d_valid_observations;
-    std::stringstream sentence_str;
-    std::stringstream frame_str;
-    std::string sentence_header;
-    sentence_header = "$GPGSV,";
-    char checksum;
-    std::string tmpstr;
+    // All the frames go to the same buffer, each with its own checksum
+    Nmea_Buffer frame;
+    sentence.clear();
 
     // 1st step: How many GPGSV frames we need? (up to 3)
     // Each frame contains up to 4 satellites
@@ -544,45 +515,34 @@ std::string Nmea_Printer::get_GPGSV()
     int current_satellite = 0;
     for (int i=1; i<(n_frames+1); i++)
         {
-            frame_str.str("");
-            frame_str << sentence_header;
+            frame.begin("$GPGSV,");
 
             // number of messages
-            frame_str << n_frames;
+            frame.append_int(n_frames);
 
             // message number
-            frame_str << ",";
-            frame_str << i;
+            frame.append(',');
+            frame.append_int(i);
 
             // total number of satellites in view
-            frame_str << ",";
-            frame_str.width(2);
-            frame_str.fill('0');
-            frame_str << std::dec << n_sats_used;
+            frame.append(',');
+            frame.append_int(n_sats_used, 2);
 
             //satellites info
             for (int j=0; j<4; j++)
                 {
                     // write satellite info
-                    frame_str << ",";
-                    frame_str.width(2);
-                    frame_str.fill('0');
-                    frame_str << std::dec << d_PVT_data->d_visible_satellites_IDs[current_satellite];
-
-                    frame_str << ",";
-                    frame_str.width(2);
-                    frame_str.fill('0');
-                    frame_str << std::dec << static_cast<int>(d_PVT_data->d_visible_satellites_El[current_satellite]);
-
-                    frame_str << ",";
-                    frame_str.width(3);
-                    frame_str.fill('0');
-                    frame_str << std::dec << static_cast<int>(d_PVT_data->d_visible_satellites_Az[current_satellite]);
-
-                    frame_str << ",";
-                    frame_str.width(2);
-                    frame_str.fill('0');
-                    frame_str << std::dec << static_cast<int>(d_PVT_data->d_visible_satellites_CN0_dB[current_satellite]);
+                    frame.append(',');
+                    frame.append_int(d_PVT_data->d_visible_satellites_IDs[current_satellite], 2);
+
+                    frame.append(',');
+                    frame.append_int(static_cast<int>(d_PVT_data->d_visible_satellites_El[current_satellite]), 2);
+
+                    frame.append(',');
+                    frame.append_int(static_cast<int>(d_PVT_data->d_visible_satellites_Az[current_satellite]), 3);
+
+                    frame.append(',');
+                    frame.append_int(static_cast<int>(d_PVT_data->d_visible_satellites_CN0_dB[current_satellite]), 2);
 
                     current_satellite++;
 
@@ -592,21 +552,15 @@ std::string Nmea_Printer::get_GPGSV()
                         }
                 }
 
-            // frame checksum
-            tmpstr = frame_str.str();
-            checksum = checkSum(tmpstr.substr(1));
-            frame_str << "*";
-            frame_str.width(2);
-            frame_str.fill('0');
-            frame_str << std::hex << static_cast<int>(checksum);
-
-            // end NMEA sentence
-            frame_str << "\r\n";
+            // frame checksum and end of NMEA sentence
+            frame.end();
 
             //add frame to sentence
-            sentence_str << frame_str.str();
+            for (size_t k = 0; k < frame.size(); k++)
+                {
+                    sentence.append(frame.data()[k]);
+                }
         }
-    return sentence_str.str();
     //$GPGSV,2,1,07,07,79,048,42,02,51,062,43,26,36,256,42,27,27,138,42*71
 }
 
@@ -614,9 +568,8 @@ std::string Nmea_Printer::get_GPGSV()
 
 
 
-std::string Nmea_Printer::get_GPGGA()
+void Nmea_Printer::get_GPGGA(Nmea_Buffer & sentence)
 {
-    //boost::posix_time::ptime d_position_UTC_time=boost::posix_time::microsec_clock::universal_time();
     bool valid_fix = d_PVT_data->b_valid_position;
     int n_channels = d_PVT_data->d_valid_observations;//d_nchannels
     double hdop = d_PVT_data->d_HDOP;
@@ -631,29 +584,28 @@ std::string Nmea_Printer::get_GPGGA()
             MSL_altitude = d_PVT_data->d_height_m;
         }
 
-    std::stringstream sentence_str;
-
     //GPGGA (Global Positioning System Fixed Data)
-    std::string sentence_header;
-    sentence_header = "$GPGGA,";
-    sentence_str << sentence_header;
+    sentence.begin("$GPGGA,");
 
     //UTC Time: hhmmss.sss
-    sentence_str << get_UTC_NMEA_time(d_PVT_data->d_position_UTC_time);
+    get_UTC_NMEA_time(d_PVT_data->d_position_UTC_time, sentence);
 
+    sentence.append(',');
     if (d_PVT_data->d_flag_averaging == true)
         {
             // Latitude ddmm.mmmm,(N or S)
-            sentence_str << "," << latitude_to_hm(d_PVT_data->d_avg_latitude_d);
+            latitude_to_hm(d_PVT_data->d_avg_latitude_d, sentence);
             // longitude dddmm.mmmm,(E or W)
-            sentence_str << "," << longitude_to_hm(d_PVT_data->d_avg_longitude_d);
+            sentence.append(',');
+            longitude_to_hm(d_PVT_data->d_avg_longitude_d, sentence);
         }
     else
         {
             // Latitude ddmm.mmmm,(N or S)
-            sentence_str << "," << latitude_to_hm(d_PVT_data->d_latitude_d);
+            latitude_to_hm(d_PVT_data->d_latitude_d, sentence);
             // longitude dddmm.mmmm,(E or W)
-            sentence_str << "," << longitude_to_hm(d_PVT_data->d_longitude_d);
+            sentence.append(',');
+            longitude_to_hm(d_PVT_data->d_longitude_d, sentence);
         }
 
     // Position fix indicator
@@ -666,65 +618,40 @@ std::string Nmea_Printer::get_GPGGA()
 
     if (valid_fix == true)
         {
-            sentence_str << ",1";
+            sentence.append(",1");
         }
     else
         {
-            sentence_str << ",0";
+            sentence.append(",0");
         }
 
     // Number of satellites used in PVT
-    sentence_str << ",";
+    sentence.append(',');
     if (n_channels < 10)
         {
-            sentence_str << '0' << n_channels;
-        }
-    else
-        {
-            sentence_str << n_channels;
+            sentence.append('0');
         }
+    sentence.append_int(n_channels);
 
     // HDOP
-    sentence_str << ",";
-    sentence_str.setf(std::ios::fixed, std::ios::floatfield);
-    sentence_str.width(2);
-    sentence_str.precision(1);
-    sentence_str.fill('0');
-    sentence_str << hdop;
+    sentence.append(',');
+    sentence.append_fixed(hdop, 1, 2);
 
     // MSL Altitude
-    sentence_str << ",";
-    sentence_str.precision(1);
-    sentence_str << MSL_altitude;
-    sentence_str << ",M";
+    sentence.append(',');
+    sentence.append_fixed(MSL_altitude, 1);
+    sentence.append(",M");
 
     // Geoid-to-ellipsoid separation. Ellipsoid altitude = MSL Altitude + Geoid Separation.
     // ToDo: Compute this value
-    sentence_str << ",";
-    sentence_str << "0.0";
-    sentence_str << ",M";
+    sentence.append(",0.0,M");
 
     // Age of Diff. Corr.  (Seconds) Null fields when DGPS is not used
     // Diff. Ref. Station ID (0000)
     // ToDo: Implement this fields for Differential GPS
-    sentence_str << ",";
-    sentence_str << "0.0,0000";
-
-    // Checksum
-    char checksum;
-    std::string tmpstr;
-    tmpstr = sentence_str.str();
-    checksum = checkSum(tmpstr.substr(1));
-    sentence_str << "*";
-    sentence_str.width(2);
-    sentence_str.fill('0');
-    sentence_str << std::hex << static_cast<int>(checksum);
-
-    // end NMEA sentence
-    sentence_str << "\r\n";
-    return sentence_str.str();
+    sentence.append(",0.0,0000");
+
+    // Checksum and end of NMEA sentence
+    sentence.end();
     //$GPGGA,104427.591,5920.7009,N,01803.2938,E,1,05,3.3,78.2,M,23.2,M,0.0,0000*4A
 }
-
-
-
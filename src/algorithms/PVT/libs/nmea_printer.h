@@ -37,11 +37,68 @@
 #define GNSS_SDR_NMEA_PRINTER_H_
 
 
+#include <cstddef>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include "pvt_solution.h"
 
+#define NMEA_BUFFER_SIZE 512
+
+/*!
+ * \brief Fixed-size buffer where NMEA sentences are formatted without
+ * allocating memory. The checksum of the current sentence is updated as its
+ * characters are appended, so it needs no second pass over the sentence.
+ * Whatever does not fit in the buffer is dropped.
+ */
+class Nmea_Buffer
+{
+public:
+    Nmea_Buffer()
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        d_size = 0;
+        d_checksum = 0;
+    }
+
+    //! Starts a sentence with header, which includes the leading '$'
+    void begin(const char* header);
+
+    void append(const char* text);
+
+    void append(char c);
+
+    //! Decimal integer, left-filled with '0' up to width characters (sign included)
+    void append_int(int value, unsigned int width = 0);
+
+    //! Fixed-point number with precision decimals, left-filled with '0' up to width characters
+    void append_fixed(double value, int precision, unsigned int width = 0);
+
+    //! Appends the checksum and the line end
+    void end();
+
+    const char* data() const
+    {
+        return d_data;
+    }
+
+    size_t size() const
+    {
+        return d_size;
+    }
+
+private:
+    void append_padded(const char* text, int length, unsigned int width);
+
+    char d_data[NMEA_BUFFER_SIZE];
+    size_t d_size;
+    unsigned char d_checksum;
+};
+
 
 /*!
  * \brief This class provides a implementation of a subset of the NMEA-0183 standard for interfacing
@@ -62,6 +119,17 @@ public:
      */
     bool Print_Nmea_Line(const std::shared_ptr<Pvt_Solution>& position, bool print_average_values);
 
+    /*!
+     * \brief Closes the NMEA log file and goes on writing on filename
+     */
+    bool open_file(const std::string & filename);
+
+    //! Name of the NMEA log file being written
+    std::string get_filename() const
+    {
+        return nmea_filename;
+    }
+
     /*!
      * \brief Default destructor.
      */
@@ -75,15 +143,19 @@ private:
     std::shared_ptr<Pvt_Solution> d_PVT_data;
     int init_serial(std::string serial_device); //serial port control
     void close_serial();
-    std::string get_GPGGA(); // fix data
-    std::string get_GPGSV(); // satellite data
-    std::string get_GPGSA(); // overall satellite reception data
-    std::string get_GPRMC(); // minimum recommended data
-    std::string get_UTC_NMEA_time(boost::posix_time::ptime d_position_UTC_time);
-    std::string longitude_to_hm(double longitude);
-    std::string latitude_to_hm(double lat);
-    char checkSum(std::string sentence);
+    void get_GPGGA(Nmea_Buffer & sentence); // fix data
+    void get_GPGSV(Nmea_Buffer & sentence); // satellite data
+    void get_GPGSA(Nmea_Buffer & sentence); // overall satellite reception data
+    void get_GPRMC(Nmea_Buffer & sentence); // minimum recommended data
+    void get_UTC_NMEA_time(const boost::posix_time::ptime & d_position_UTC_time, Nmea_Buffer & sentence);
+    void longitude_to_hm(double longitude, Nmea_Buffer & sentence);
+    void latitude_to_hm(double lat, Nmea_Buffer & sentence);
     bool print_avg_pos;
+    // Sentences of the current epoch, written with a single writev() to the serial device
+    Nmea_Buffer d_GPRMC;
+    Nmea_Buffer d_GPGGA;
+    Nmea_Buffer d_GPGSA;
+    Nmea_Buffer d_GPGSV;
 };
 
 #endif
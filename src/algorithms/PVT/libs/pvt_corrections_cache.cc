@@ -0,0 +1,199 @@
+/*!
+ * \file pvt_corrections_cache.cc
+ * \brief Line-of-sight geometry and troposphere delay of the satellites of an epoch
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "pvt_corrections_cache.h"
+#include <cmath>
+#include "GPS_L1_CA.h"
+
+namespace
+{
+// Modified Hopfield model, as in Pvt_Solution::tropo()
+const double TROPO_A_E_KM = 6378.137;  // semi-major axis of the earth ellipsoid
+const double TROPO_B0 = 7.839257e-5;
+// Standard atmosphere at the height of the receiver, as given by the solvers
+const double TROPO_P_MB = 1013.0;
+const double TROPO_T_KEL = 293.0;
+const double TROPO_HUMIDITY = 50.0;
+}
+
+
+Pvt_Corrections_Cache::Pvt_Corrections_Cache(double refresh_distance_m)
+{
+    d_refresh2 = refresh_distance_m * refresh_distance_m;
+    d_valid = false;
+    for (int j = 0; j < 3; j++)
+        {
+            d_pos[j] = 0.0;
+            d_east[j] = 0.0;
+            d_north[j] = 0.0;
+            d_up[j] = 0.0;
+        }
+    d_height_km = 0.0;
+    d_tropo_ref[0] = 0.0;
+    d_tropo_ref[1] = 0.0;
+    d_tropo_htop[0] = 0.0;
+    d_tropo_htop[1] = 0.0;
+    d_refreshes = 0;
+}
+
+
+bool Pvt_Corrections_Cache::stale(const double * pos) const
+{
+    if (!d_valid)
+        {
+            return true;
+        }
+    const double dx = pos[0] - d_pos[0];
+    const double dy = pos[1] - d_pos[1];
+    const double dz = pos[2] - d_pos[2];
+    return dx * dx + dy * dy + dz * dz > d_refresh2;
+}
+
+
+void Pvt_Corrections_Cache::set_receiver(const double * pos, double latitude_deg, double longitude_deg, double height_m)
+{
+    const double dtr = GPS_PI / 180.0;
+    const double cl = cos(longitude_deg * dtr);
+    const double sl = sin(longitude_deg * dtr);
+    const double cb = cos(latitude_deg * dtr);
+    const double sb = sin(latitude_deg * dtr);
+    // rows of the transpose of the rotation of Pvt_Solution::topocent()
+    d_east[0] = -sl;
+    d_east[1] = cl;
+    d_east[2] = 0.0;
+    d_north[0] = -sb * cl;
+    d_north[1] = -sb * sl;
+    d_north[2] = cb;
+    d_up[0] = cb * cl;
+    d_up[1] = cb * sl;
+    d_up[2] = sb;
+    for (int j = 0; j < 3; j++)
+        {
+            d_pos[j] = pos[j];
+        }
+
+    d_height_km = height_m / 1000.0;
+    const double tksea = TROPO_T_KEL;
+    // with the measurements at the receiver, the sea level values are those of the model
+    const double e0sea = 0.0611 * TROPO_HUMIDITY * pow(10.0, 7.5 * (TROPO_T_KEL - 273.15) / (237.3 + TROPO_T_KEL - 273.15));
+
+    double refsea = 77.624e-6 / tksea;
+    d_tropo_htop[0] = 1.1385e-5 / refsea;
+    d_tropo_ref[0] = refsea * TROPO_P_MB * pow((d_tropo_htop[0] - d_height_km) / d_tropo_htop[0], 4);
+
+    refsea = (371900.0e-6 / tksea - 12.92e-6) / tksea;
+    d_tropo_htop[1] = 1.1385e-5 * (1255.0 / tksea + 0.05) / refsea;
+    d_tropo_ref[1] = refsea * e0sea * pow((d_tropo_htop[1] - d_height_km) / d_tropo_htop[1], 4);
+
+    d_valid = true;
+    d_refreshes++;
+}
+
+
+double Pvt_Corrections_Cache::troposphere(double sinel) const
+{
+    if (sinel < 0.0) sinel = 0.0;
+    const double cos2 = 1.0 - sinel * sinel;
+    const double r_sta = TROPO_A_E_KM + d_height_km;
+    double delay = 0.0;
+    for (int k = 0; k < 2; k++)
+        {
+            const double r_top = TROPO_A_E_KM + d_tropo_htop[k];
+            const double thickness = d_tropo_htop[k] - d_height_km;
+            double rtop2 = r_top * r_top - r_sta * r_sta * cos2;
+            if (rtop2 < 0.0) rtop2 = 0.0;
+            const double rtop = sqrt(rtop2) - r_sta * sinel;
+            const double a = -sinel / thickness;
+            const double b = -TROPO_B0 * cos2 / thickness;
+            const double a2 = a * a;
+            const double b2 = b * b;
+            // the last two terms vanish with b, at the zenith
+            const double large_b = b2 > 1.0e-35 ? 1.0 : 0.0;
+            const double alpha[8] = { 2.0 * a,
+                    2.0 * a2 + 4.0 * b / 3.0,
+                    a * (a2 + 3.0 * b),
+                    a2 * a2 / 5.0 + 2.4 * a2 * b + 1.2 * b2,
+                    2.0 * a * b * (a2 + 3.0 * b) / 3.0,
+                    b2 * (6.0 * a2 + 4.0 * b) * 1.428571e-1,
+                    large_b * a * b2 * b / 2.0,
+                    large_b * b2 * b2 / 9.0 };
+            // rtop + sum of alpha[i] rtop^(i + 2)
+            double sum = alpha[7];
+            for (int i = 6; i >= 0; i--)
+                {
+                    sum = sum * rtop + alpha[i];
+                }
+            delay += (rtop + sum * rtop * rtop) * d_tropo_ref[k] * 1000.0;
+        }
+    return delay;
+}
+
+
+void Pvt_Corrections_Cache::evaluate(const double * los, int n, double * az_deg, double * el_deg, double * range_m, double * trop_m) const
+{
+    // Local coordinates: east and north go to the angle arrays, the sine of
+    // the elevation to the delay array, until they are replaced
+    for (int i = 0; i < n; i++)
+        {
+            const double * dx = &los[3 * i];
+            const double e = d_east[0] * dx[0] + d_east[1] * dx[1];
+            const double nn = d_north[0] * dx[0] + d_north[1] * dx[1] + d_north[2] * dx[2];
+            const double u = d_up[0] * dx[0] + d_up[1] * dx[1] + d_up[2] * dx[2];
+            const double range = sqrt(dx[0] * dx[0] + dx[1] * dx[1] + dx[2] * dx[2]);
+            az_deg[i] = e;
+            el_deg[i] = nn;
+            range_m[i] = range;
+            trop_m[i] = range > 0.0 ? u / range : 1.0;
+        }
+
+    const double rtd = 180.0 / GPS_PI;
+    for (int i = 0; i < n; i++)
+        {
+            const double e = az_deg[i];
+            const double nn = el_deg[i];
+            const double hor = sqrt(e * e + nn * nn);
+            if (hor < 1.0E-20)
+                {
+                    az_deg[i] = 0.0;
+                    el_deg[i] = 90.0;
+                }
+            else
+                {
+                    az_deg[i] = atan2(e, nn) * rtd;
+                    el_deg[i] = atan2(trop_m[i] * range_m[i], hor) * rtd;
+                    if (az_deg[i] < 0.0) az_deg[i] += 360.0;
+                }
+        }
+
+    for (int i = 0; i < n; i++)
+        {
+            trop_m[i] = troposphere(trop_m[i]);
+        }
+}
@@ -0,0 +1,108 @@
+/*!
+ * \file pvt_corrections_cache.h
+ * \brief Line-of-sight geometry and troposphere delay of the satellites of an epoch
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PVT_CORRECTIONS_CACHE_H_
+#define GNSS_SDR_PVT_CORRECTIONS_CACHE_H_
+
+//! Distance the receiver moves before its geodetic terms are computed again [m]
+#define PVT_CORRECTIONS_REFRESH_M 10.0
+
+/*!
+ * \brief Azimuth, elevation and troposphere delay of all the satellites of
+ * an epoch, from receiver terms kept while the receiver stays close.
+ *
+ * The receiver terms are the rotation from ECEF to the local east, north
+ * and up axes, and the part of the Modified Hopfield troposphere model that
+ * only depends on the height, with the standard atmosphere of the solvers
+ * (1013 mb, 293 K, 50 % humidity). They are computed by set_receiver()
+ * from the geodetic coordinates of a position, and kept until the position
+ * moves more than the refresh distance. The iterations of a solution that
+ * converges, and the following epochs of a receiver that does not move
+ * fast, reuse them, and the geodetic conversion is not repeated for each
+ * satellite and iteration. At 10 m, the elevations are off by less than
+ * 1e-4 degrees and the troposphere delays by a few millimeters.
+ *
+ * evaluate() runs over arrays of satellites. Its first loop, the projection
+ * on the local axes, has neither calls nor branches and is vectorized.
+ */
+class Pvt_Corrections_Cache
+{
+public:
+    Pvt_Corrections_Cache(double refresh_distance_m = PVT_CORRECTIONS_REFRESH_M);
+
+    //! True if set_receiver() has to be called for the ECEF position pos [m]
+    bool stale(const double * pos) const;
+
+    /*!
+     * \brief Computes the receiver terms at the ECEF position pos [m], whose
+     * geodetic coordinates are latitude_deg, longitude_deg and height_m
+     */
+    void set_receiver(const double * pos, double latitude_deg, double longitude_deg, double height_m);
+
+    //! Forgets the receiver terms
+    void invalidate()
+    {
+        d_valid = false;
+    }
+
+    /*!
+     * \brief Geometry and troposphere delay of n satellites
+     *
+     * \param[in]  los      ECEF vectors from the receiver to each satellite, 3 per satellite [m]
+     * \param[out] az_deg   Azimuth from north, clockwise [deg]
+     * \param[out] el_deg   Elevation [deg]
+     * \param[out] range_m  Length of the vector [m]
+     * \param[out] trop_m   Troposphere delay [m], that of the horizon for the satellites below it
+     */
+    void evaluate(const double * los, int n, double * az_deg, double * el_deg, double * range_m, double * trop_m) const;
+
+    //! Troposphere delay at the elevation whose sine is sinel [m]
+    double troposphere(double sinel) const;
+
+    //! Times the receiver terms were computed
+    unsigned long long refreshes() const
+    {
+        return d_refreshes;
+    }
+
+private:
+    double d_refresh2;
+    bool d_valid;
+    double d_pos[3];
+    double d_east[3];
+    double d_north[3];
+    double d_up[3];
+    double d_height_km;
+    double d_tropo_ref[2];   // refractivity at the receiver of the dry and wet components
+    double d_tropo_htop[2];  // height of the top of each component [km]
+    unsigned long long d_refreshes;
+};
+
+#endif /* GNSS_SDR_PVT_CORRECTIONS_CACHE_H_ */
@@ -0,0 +1,196 @@
+/*!
+ * \file pvt_file_rotation.cc
+ * \brief Hourly or daily rotation of the PVT output files, with optional
+ *  gzip compression of the closed files.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "pvt_file_rotation.h"
+#include <cstdio>
+#include <vector>
+#include <zlib.h>
+#include <glog/logging.h>
+
+
+using google::LogMessage;
+
+// Closed files waiting for compression. Rotation happens once per hour at
+// most, so this is only reached if the compression falls far behind.
+#define PVT_FILE_ROTATION_QUEUE_DEPTH 32
+
+
+Pvt_File_Rotation::Pvt_File_Rotation(Period period, bool compress) :
+        d_period(period),
+        d_compress(compress),
+        d_started(false),
+        d_index(0)
+{
+    if (d_compress)
+        {
+            d_compressor = std::unique_ptr<Pvt_Output_Writer>(new Pvt_Output_Writer(PVT_FILE_ROTATION_QUEUE_DEPTH, Pvt_Output_Writer::BLOCK));
+        }
+}
+
+
+bool Pvt_File_Rotation::period_from_name(const std::string & name, Period & period)
+{
+    if (name.compare("none") == 0)
+        {
+            period = NONE;
+            return true;
+        }
+    if (name.compare("hourly") == 0)
+        {
+            period = HOURLY;
+            return true;
+        }
+    if (name.compare("daily") == 0)
+        {
+            period = DAILY;
+            return true;
+        }
+    return false;
+}
+
+
+long Pvt_File_Rotation::period_index(std::time_t now) const
+{
+    struct tm local;
+    localtime_r(&now, &local);
+    // not a count of days, but it changes with every local day
+    const long day = static_cast<long>(local.tm_year) * 366 + local.tm_yday;
+    if (d_period == HOURLY)
+        {
+            return day * 24 + local.tm_hour;
+        }
+    return day;
+}
+
+
+bool Pvt_File_Rotation::due()
+{
+    return due(std::time(nullptr));
+}
+
+
+bool Pvt_File_Rotation::due(std::time_t now)
+{
+    if (d_period == NONE)
+        {
+            return false;
+        }
+    const long index = period_index(now);
+    if (!d_started)
+        {
+            d_started = true;
+            d_index = index;
+            return false;
+        }
+    if (index == d_index)
+        {
+            return false;
+        }
+    d_index = index;
+    return true;
+}
+
+
+void Pvt_File_Rotation::archive(const std::string & filename)
+{
+    if (d_compress && !filename.empty())
+        {
+            d_compressor->push([filename]() { Pvt_File_Rotation::gzip_file(filename); });
+        }
+}
+
+
+void Pvt_File_Rotation::flush()
+{
+    if (d_compress)
+        {
+            d_compressor->flush();
+        }
+}
+
+
+std::string Pvt_File_Rotation::tagged_filename(const std::string & filename, std::time_t now)
+{
+    struct tm local;
+    localtime_r(&now, &local);
+    char tag[72];
+    snprintf(tag, sizeof(tag), "_%02d%02d%02d_%02d%02d%02d", local.tm_year - 100, local.tm_mon + 1,
+            local.tm_mday, local.tm_hour, local.tm_min, local.tm_sec);
+
+    // before the extension, if the last path component has one
+    const std::string::size_type dot = filename.rfind('.');
+    const std::string::size_type slash = filename.rfind('/');
+    if (dot == std::string::npos || dot == 0 || (slash != std::string::npos && dot < slash))
+        {
+            return filename + tag;
+        }
+    return filename.substr(0, dot) + tag + filename.substr(dot);
+}
+
+
+bool Pvt_File_Rotation::gzip_file(const std::string & filename)
+{
+    FILE * in = fopen(filename.c_str(), "rb");
+    if (in == nullptr)
+        {
+            LOG(WARNING) << "Could not open " << filename << " for compression";
+            return false;
+        }
+    const std::string gz_filename = filename + ".gz";
+    gzFile out = gzopen(gz_filename.c_str(), "wb");
+    if (out == nullptr)
+        {
+            LOG(WARNING) << "Could not create " << gz_filename;
+            fclose(in);
+            return false;
+        }
+    std::vector<char> buffer(65536);
+    bool ok = true;
+    size_t n;
+    while (ok && (n = fread(buffer.data(), 1, buffer.size(), in)) > 0)
+        {
+            ok = gzwrite(out, buffer.data(), static_cast<unsigned int>(n)) == static_cast<int>(n);
+        }
+    ok = ok && !ferror(in);
+    fclose(in);
+    ok = (gzclose(out) == Z_OK) && ok;
+    if (!ok)
+        {
+            LOG(WARNING) << "Error compressing " << filename;
+            remove(gz_filename.c_str());
+            return false;
+        }
+    if (remove(filename.c_str()) != 0)
+        {
+            LOG(WARNING) << "Error deleting " << filename << " after compression";
+        }
+    return true;
+}
@@ -0,0 +1,113 @@
+/*!
+ * \file pvt_file_rotation.h
+ * \brief Hourly or daily rotation of the PVT output files, with optional
+ *  gzip compression of the closed files.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * A receiver running for weeks used to write a single RINEX, NMEA, KML and
+ * GeoJSON file per run. With rotation enabled, the PVT blocks close their
+ * output files at every change of local hour or day and open new ones, and
+ * the closed files can be compressed by a background thread so that they
+ * are ready for upload.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PVT_FILE_ROTATION_H_
+#define GNSS_SDR_PVT_FILE_ROTATION_H_
+
+#include <ctime>
+#include <memory>
+#include <string>
+#include "pvt_output_writer.h"
+
+/*!
+ * \brief Decides when the output files are rotated, and compresses the
+ * closed ones in a background thread.
+ *
+ * due() and archive() must be called from the same thread (the PVT output
+ * writer). The destructor waits for the pending compressions.
+ */
+class Pvt_File_Rotation
+{
+public:
+    enum Period
+    {
+        NONE,
+        HOURLY,
+        DAILY
+    };
+
+    Pvt_File_Rotation(Period period, bool compress);
+
+    /*!
+     * \brief Parses "none", "hourly" or "daily" into period. Returns false,
+     * leaving period unchanged, for any other name.
+     */
+    static bool period_from_name(const std::string & name, Period & period);
+
+    Period period() const
+    {
+        return d_period;
+    }
+
+    /*!
+     * \brief Returns true at the first call in a new local hour or day.
+     * The first call only starts the current period.
+     */
+    bool due();
+    bool due(std::time_t now);
+
+    /*!
+     * \brief Schedules the compression of a closed output file, if enabled
+     */
+    void archive(const std::string & filename);
+
+    //! Waits until the scheduled files have been compressed
+    void flush();
+
+    /*!
+     * \brief Inserts the local time of now, as _YYMMDD_HHMMSS, before the
+     * extension of filename
+     */
+    static std::string tagged_filename(const std::string & filename, std::time_t now);
+
+    /*!
+     * \brief Compresses filename into filename.gz and removes it. Returns
+     * false, keeping the original file, on error.
+     */
+    static bool gzip_file(const std::string & filename);
+
+private:
+    long period_index(std::time_t now) const;
+
+    Period d_period;
+    bool d_compress;
+    bool d_started;
+    long d_index;
+    std::unique_ptr<Pvt_Output_Writer> d_compressor;
+};
+
+#endif
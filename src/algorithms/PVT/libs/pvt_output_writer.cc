@@ -0,0 +1,160 @@
+/*!
+ * \file pvt_output_writer.cc
+ * \brief Writer thread that runs the PVT output jobs (KML, GeoJSON, NMEA,
+ *  RINEX and RTCM printers) out of the signal processing flowgraph.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "pvt_output_writer.h"
+#include <exception>
+#include <glog/logging.h>
+
+
+using google::LogMessage;
+
+
+Pvt_Output_Writer::Pvt_Output_Writer(unsigned int depth, Overflow_Policy policy) :
+        d_depth(depth),
+        d_policy(policy),
+        d_jobs(depth),
+        d_head(0),
+        d_tail(0),
+        d_dropped(0),
+        d_written(0),
+        d_stop(false)
+{
+    if (d_depth > 0)
+        {
+            d_thread = boost::thread(&Pvt_Output_Writer::run, this);
+        }
+}
+
+
+Pvt_Output_Writer::~Pvt_Output_Writer()
+{
+    if (d_depth > 0)
+        {
+            d_stop.store(true);
+            d_cond.notify_all();
+            d_thread.join();
+        }
+    if (d_dropped.load() > 0)
+        {
+            LOG(WARNING) << "PVT output: " << d_dropped.load() << " epochs dropped, "
+                         << d_written.load() << " written";
+        }
+}
+
+
+bool Pvt_Output_Writer::policy_from_name(const std::string & name, Overflow_Policy & policy)
+{
+    if (name.compare("drop") == 0)
+        {
+            policy = DROP;
+            return true;
+        }
+    if (name.compare("block") == 0)
+        {
+            policy = BLOCK;
+            return true;
+        }
+    return false;
+}
+
+
+bool Pvt_Output_Writer::push(std::function<void()> job)
+{
+    if (d_depth == 0)
+        {
+            job();
+            d_written++;
+            return true;
+        }
+    const unsigned long long head = d_head.load(std::memory_order_relaxed);
+    while (head - d_tail.load(std::memory_order_acquire) >= d_depth)
+        {
+            if (d_policy == DROP)
+                {
+                    const unsigned long long dropped = ++d_dropped;
+                    if ((dropped & (dropped - 1)) == 0)
+                        {
+                            // 1, 2, 4, 8... so a stalled output does not flood the log
+                            LOG(WARNING) << "PVT output queue full, " << dropped << " epochs dropped";
+                        }
+                    return false;
+                }
+            boost::unique_lock<boost::mutex> lock(d_mutex);
+            d_cond.timed_wait(lock, boost::posix_time::milliseconds(10));
+        }
+    d_jobs[head % d_depth] = std::move(job);
+    d_head.store(head + 1, std::memory_order_release);
+    d_cond.notify_all();
+    return true;
+}
+
+
+void Pvt_Output_Writer::flush()
+{
+    while (d_depth > 0 && d_tail.load(std::memory_order_acquire) != d_head.load(std::memory_order_relaxed))
+        {
+            boost::unique_lock<boost::mutex> lock(d_mutex);
+            d_cond.timed_wait(lock, boost::posix_time::milliseconds(10));
+        }
+}
+
+
+void Pvt_Output_Writer::run()
+{
+    while (true)
+        {
+            const unsigned long long tail = d_tail.load(std::memory_order_relaxed);
+            if (tail == d_head.load(std::memory_order_acquire))
+                {
+                    if (d_stop.load())
+                        {
+                            break;
+                        }
+                    // the producer does not take the mutex, so wake up now and then
+                    boost::unique_lock<boost::mutex> lock(d_mutex);
+                    d_cond.timed_wait(lock, boost::posix_time::milliseconds(10));
+                    continue;
+                }
+            std::function<void()> job;
+            job.swap(d_jobs[tail % d_depth]);
+            d_tail.store(tail + 1, std::memory_order_release);
+            d_cond.notify_all();
+            try
+            {
+                    job();
+            }
+            catch (const std::exception & e)
+            {
+                    LOG(WARNING) << "Exception in the PVT output " << e.what();
+            }
+            d_written++;
+        }
+}
@@ -0,0 +1,117 @@
+/*!
+ * \file pvt_output_writer.h
+ * \brief Writer thread that runs the PVT output jobs (KML, GeoJSON, NMEA,
+ *  RINEX and RTCM printers) out of the signal processing flowgraph.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The PVT blocks used to call the printers inline from general_work(), so a
+ * slow storage device or a stalled serial port or TCP client delayed the
+ * whole flowgraph. The blocks now push a job, holding a copy of the data of
+ * the output epoch, into a bounded single producer, single consumer queue,
+ * and a writer thread runs the jobs in order.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PVT_OUTPUT_WRITER_H_
+#define GNSS_SDR_PVT_OUTPUT_WRITER_H_
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+#include <boost/thread.hpp>
+
+/*!
+ * \brief Bounded queue of output jobs, run by a writer thread.
+ *
+ * push() must always be called from the same thread (the PVT block). When
+ * the queue is full, the new job is dropped and counted (DROP policy) or
+ * push() waits for room (BLOCK policy). A depth of 0 runs each job inline
+ * in push(), as before. The destructor runs the queued jobs and joins the
+ * thread.
+ */
+class Pvt_Output_Writer
+{
+public:
+    enum Overflow_Policy
+    {
+        DROP,
+        BLOCK
+    };
+
+    Pvt_Output_Writer(unsigned int depth, Overflow_Policy policy);
+    ~Pvt_Output_Writer();
+
+    /*!
+     * \brief Parses "drop" or "block" into policy. Returns false, leaving
+     * policy unchanged, for any other name.
+     */
+    static bool policy_from_name(const std::string & name, Overflow_Policy & policy);
+
+    /*!
+     * \brief Queues a job for the writer thread. Returns false if it was dropped.
+     */
+    bool push(std::function<void()> job);
+
+    //! Waits until all the queued jobs have been run
+    void flush();
+
+    unsigned int depth() const
+    {
+        return d_depth;
+    }
+
+    //! Jobs dropped because the queue was full
+    unsigned long long dropped() const
+    {
+        return d_dropped.load();
+    }
+
+    //! Jobs run
+    unsigned long long written() const
+    {
+        return d_written.load();
+    }
+
+private:
+    void run();
+
+    unsigned int d_depth;
+    Overflow_Policy d_policy;
+    std::vector<std::function<void()>> d_jobs;
+    std::atomic<unsigned long long> d_head;     // jobs pushed, written by the producer only
+    std::atomic<unsigned long long> d_tail;     // jobs taken, written by the writer thread only
+    std::atomic<unsigned long long> d_dropped;
+    std::atomic<unsigned long long> d_written;
+    std::atomic<bool> d_stop;
+
+    // only for sleeping while the queue is empty, or full with BLOCK
+    boost::mutex d_mutex;
+    boost::condition_variable d_cond;
+    boost::thread d_thread;
+};
+
+#endif
@@ -56,8 +56,15 @@ Pvt_Solution::Pvt_Solution()
     d_flag_averaging = false;
     b_valid_position = false;
     d_averaging_depth = 0;
+    d_averaging_ecef = false;
     d_valid_observations = 0;
     d_rx_dt_m = 0.0;
+    for (int i = 0; i < 3; i++)
+        {
+            d_rx_pos_m[i] = 0.0;
+            d_avg_pos_m[i] = 0.0;
+        }
+    d_avg_covariance.zeros();
 }
 
 arma::vec Pvt_Solution::rotateSatellite(double const traveltime, const arma::vec & X_sat)
@@ -113,6 +120,9 @@ int Pvt_Solution::cart2geo(double X, double Y, double Z, int elipsoid_selection)
     const double a[5] = {6378388.0, 6378160.0, 6378135.0, 6378137.0, 6378137.0};
     const double f[5] = {1.0 / 297.0, 1.0 / 298.247, 1.0 / 298.26, 1.0 / 298.257222101, 1.0 / 298.257223563};
 
+    d_rx_pos_m[0] = X;
+    d_rx_pos_m[1] = Y;
+    d_rx_pos_m[2] = Z;
     double lambda  = atan2(Y, X);
     double ex2 = (2.0 - f[elipsoid_selection]) * f[elipsoid_selection] / ((1.0 - f[elipsoid_selection]) * (1.0 - f[elipsoid_selection]));
     double c = a[elipsoid_selection] * sqrt(1.0 + ex2);
@@ -491,49 +501,63 @@ int Pvt_Solution::compute_DOP()
 int Pvt_Solution::set_averaging_depth(int depth)
 {
     d_averaging_depth = depth;
+    d_averaging_window.reset(depth);
     return 0;
 }
 
 
+void Pvt_Solution::set_averaging_ecef(bool flag_averaging_ecef)
+{
+    d_averaging_ecef = flag_averaging_ecef;
+    d_averaging_window.reset(d_averaging_depth);
+}
+
+
 int Pvt_Solution::pos_averaging(bool flag_averaring)
 {
     // MOVING AVERAGE PVT
     bool avg = flag_averaring;
     if (avg == true)
         {
-            if (d_hist_longitude_d.size() == (unsigned int)d_averaging_depth)
+            if (d_averaging_ecef)
+                {
+                    d_averaging_window.push(d_rx_pos_m);
+                }
+            else
+                {
+                    const double geo[3] = {d_latitude_d, d_longitude_d, d_height_m};
+                    d_averaging_window.push(geo);
+                }
+            if (d_averaging_window.full())
                 {
-                    // Pop oldest value
-                    d_hist_longitude_d.pop_back();
-                    d_hist_latitude_d.pop_back();
-                    d_hist_height_m.pop_back();
-                    // Push new values
-                    d_hist_longitude_d.push_front(d_longitude_d);
-                    d_hist_latitude_d.push_front(d_latitude_d);
-                    d_hist_height_m.push_front(d_height_m);
-
-                    d_avg_latitude_d = 0.0;
-                    d_avg_longitude_d = 0.0;
-                    d_avg_height_m = 0.0;
-                    for (unsigned int i = 0; i < d_hist_longitude_d.size(); i++)
+                    for (unsigned int i = 0; i < 3; i++)
+                        {
+                            for (unsigned int j = 0; j < 3; j++)
+                                {
+                                    d_avg_covariance(i, j) = d_averaging_window.covariance(i, j);
+                                }
+                        }
+                    if (d_averaging_ecef)
+                        {
+                            for (unsigned int i = 0; i < 3; i++)
+                                {
+                                    d_avg_pos_m[i] = d_averaging_window.mean(i);
+                                }
+                            togeod(&d_avg_latitude_d, &d_avg_longitude_d, &d_avg_height_m, 6378137.0, 298.257223563,
+                                    d_avg_pos_m[0], d_avg_pos_m[1], d_avg_pos_m[2]);
+                            // togeod gives longitudes in [0, 360)
+                            if (d_avg_longitude_d > 180.0) d_avg_longitude_d -= 360.0;
+                        }
+                    else
                         {
-                            d_avg_latitude_d = d_avg_latitude_d + d_hist_latitude_d.at(i);
-                            d_avg_longitude_d = d_avg_longitude_d + d_hist_longitude_d.at(i);
-                            d_avg_height_m  = d_avg_height_m + d_hist_height_m.at(i);
+                            d_avg_latitude_d = d_averaging_window.mean(0);
+                            d_avg_longitude_d = d_averaging_window.mean(1);
+                            d_avg_height_m = d_averaging_window.mean(2);
                         }
-                    d_avg_latitude_d = d_avg_latitude_d / static_cast<double>(d_averaging_depth);
-                    d_avg_longitude_d = d_avg_longitude_d / static_cast<double>(d_averaging_depth);
-                    d_avg_height_m = d_avg_height_m / static_cast<double>(d_averaging_depth);
                     b_valid_position = true;
                 }
             else
                 {
-                    //int current_depth=d_hist_longitude_d.size();
-                    // Push new values
-                    d_hist_longitude_d.push_front(d_longitude_d);
-                    d_hist_latitude_d.push_front(d_latitude_d);
-                    d_hist_height_m.push_front(d_height_m);
-
                     d_avg_latitude_d = d_latitude_d;
                     d_avg_longitude_d = d_longitude_d;
                     d_avg_height_m = d_height_m;
@@ -33,9 +33,9 @@
 #define GNSS_SDR_PVT_SOLUTION_H_
 
 
-#include <deque>
 #include <armadillo>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include "moving_window_statistics.h"
 
 #define PVT_MAX_CHANNELS 24
 
@@ -52,6 +52,7 @@ public:
     double d_longitude_d; //!< RX position Longitude WGS84 [deg]
     double d_height_m; //!< RX position height WGS84 [m]
     double d_rx_dt_m; //!< RX time offset [s]
+    double d_rx_pos_m[3]; //!< RX position ECEF [m], as given to cart2geo
 
     boost::posix_time::ptime d_position_UTC_time;
 
@@ -66,13 +67,14 @@ public:
 
     //averaging
     int d_averaging_depth;    //!< Length of averaging window
-    std::deque<double> d_hist_latitude_d;
-    std::deque<double> d_hist_longitude_d;
-    std::deque<double> d_hist_height_m;
+    bool d_averaging_ecef;    //!< Average the ECEF coordinates instead of latitude, longitude and height
+    Moving_Window_Statistics d_averaging_window;
 
     double d_avg_latitude_d;  //!< Averaged latitude in degrees
     double d_avg_longitude_d; //!< Averaged longitude in degrees
     double d_avg_height_m;    //!< Averaged height [m]
+    double d_avg_pos_m[3];    //!< Averaged ECEF position [m], only with ECEF averaging
+    arma::mat::fixed<3, 3> d_avg_covariance; //!< Covariance of the averaged coordinates: ECEF [m^2], or latitude, longitude [deg] and height [m]
     int pos_averaging(bool flag_averaging);
 
     // DOP estimations
@@ -87,6 +89,7 @@ public:
     bool d_flag_averaging;
 
     int set_averaging_depth(int depth);
+    void set_averaging_ecef(bool flag_averaging_ecef);
 
     arma::vec rotateSatellite(double traveltime, const arma::vec & X_sat);
 
@@ -0,0 +1,151 @@
+/*!
+ * \file pvt_solver_thread.cc
+ * \brief Thread that computes the PVT solution of the latest epoch, out of
+ *  the signal processing flowgraph.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "pvt_solver_thread.h"
+#include <exception>
+#include <glog/logging.h>
+
+
+using google::LogMessage;
+
+
+Pvt_Solver_Thread::Pvt_Solver_Thread(bool enable) :
+        d_enabled(enable),
+        d_has_pending(false),
+        d_busy(false),
+        d_stop(false),
+        d_dropped(0),
+        d_solved(0)
+{
+    if (d_enabled)
+        {
+            d_thread = boost::thread(&Pvt_Solver_Thread::run, this);
+        }
+}
+
+
+Pvt_Solver_Thread::~Pvt_Solver_Thread()
+{
+    if (d_enabled)
+        {
+            {
+                boost::unique_lock<boost::mutex> lock(d_mutex);
+                d_stop = true;
+            }
+            d_cond.notify_all();
+            d_thread.join();
+        }
+    if (d_dropped.load() > 0)
+        {
+            LOG(WARNING) << "PVT solver: " << d_dropped.load() << " epochs dropped, "
+                         << d_solved.load() << " solved";
+        }
+}
+
+
+bool Pvt_Solver_Thread::submit(std::function<void()> job)
+{
+    if (!d_enabled)
+        {
+            job();
+            d_solved++;
+            return true;
+        }
+    bool replaced;
+    {
+        boost::unique_lock<boost::mutex> lock(d_mutex);
+        replaced = d_has_pending;
+        // the replaced job is destroyed out of the lock
+        d_pending.swap(job);
+        d_has_pending = true;
+    }
+    d_cond.notify_all();
+    if (replaced)
+        {
+            const unsigned long long dropped = ++d_dropped;
+            if ((dropped & (dropped - 1)) == 0)
+                {
+                    // 1, 2, 4, 8... so an overloaded solver does not flood the log
+                    LOG(WARNING) << "PVT solver busy, " << dropped << " epochs dropped";
+                }
+        }
+    return !replaced;
+}
+
+
+void Pvt_Solver_Thread::flush()
+{
+    if (!d_enabled)
+        {
+            return;
+        }
+    boost::unique_lock<boost::mutex> lock(d_mutex);
+    while (d_has_pending || d_busy)
+        {
+            d_cond.wait(lock);
+        }
+}
+
+
+void Pvt_Solver_Thread::run()
+{
+    boost::unique_lock<boost::mutex> lock(d_mutex);
+    while (true)
+        {
+            if (!d_has_pending)
+                {
+                    if (d_stop)
+                        {
+                            break;
+                        }
+                    d_cond.wait(lock);
+                    continue;
+                }
+            std::function<void()> job;
+            job.swap(d_pending);
+            d_has_pending = false;
+            d_busy = true;
+            lock.unlock();
+            try
+            {
+                    job();
+            }
+            catch (const std::exception & e)
+            {
+                    LOG(WARNING) << "Exception in the PVT solver " << e.what();
+            }
+            job = nullptr;
+            d_solved++;
+            lock.lock();
+            d_busy = false;
+            d_cond.notify_all();
+        }
+}
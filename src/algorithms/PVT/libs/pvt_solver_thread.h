@@ -0,0 +1,103 @@
+/*!
+ * \file pvt_solver_thread.h
+ * \brief Thread that computes the PVT solution of the latest epoch, out of
+ *  the signal processing flowgraph.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * A PVT block that solves in general_work() holds the scheduler thread for
+ * the whole solution, averaging and publication, so a slow epoch backs up
+ * the observables and, through them, the tracking channels. The block hands
+ * each output epoch to this thread instead, through a single slot: only the
+ * latest epoch waits to be solved, and an epoch still waiting when the next
+ * one arrives is dropped, since a newer solution supersedes it.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PVT_SOLVER_THREAD_H_
+#define GNSS_SDR_PVT_SOLVER_THREAD_H_
+
+#include <atomic>
+#include <functional>
+#include <boost/thread.hpp>
+
+/*!
+ * \brief Latest-value handoff of epoch jobs to a solver thread.
+ *
+ * submit() never waits for the solver: it stores the job in the slot,
+ * replacing (and counting as dropped) a job that has not been started. When
+ * disabled, each job runs inline in submit(), as before. The destructor
+ * runs the pending job and joins the thread.
+ */
+class Pvt_Solver_Thread
+{
+public:
+    explicit Pvt_Solver_Thread(bool enable);
+    ~Pvt_Solver_Thread();
+
+    /*!
+     * \brief Hands a job to the solver thread. Returns false if it replaced
+     * a pending one, which is dropped.
+     */
+    bool submit(std::function<void()> job);
+
+    //! Waits until the pending job, if any, has been run
+    void flush();
+
+    bool enabled() const
+    {
+        return d_enabled;
+    }
+
+    //! Jobs replaced before the solver could start them
+    unsigned long long dropped() const
+    {
+        return d_dropped.load();
+    }
+
+    //! Jobs run
+    unsigned long long solved() const
+    {
+        return d_solved.load();
+    }
+
+private:
+    void run();
+
+    bool d_enabled;
+    std::function<void()> d_pending;
+    bool d_has_pending;
+    bool d_busy;
+    bool d_stop;
+    std::atomic<unsigned long long> d_dropped;
+    std::atomic<unsigned long long> d_solved;
+
+    // the mutex only guards the slot, never a running job
+    boost::mutex d_mutex;
+    boost::condition_variable d_cond;
+    boost::thread d_thread;
+};
+
+#endif
@@ -29,6 +29,7 @@
  */
 
 #include "rinex_printer.h"
+#include "gnss_sdr_trace.h"
 #include <unistd.h>  // for getlogin_r()
 #include <algorithm> // for min and max
 #include <cmath>     // for floor
@@ -235,6 +236,107 @@ void Rinex_Printer::lengthCheck(const std::string& line)
 
 
 
+std::string Rinex_Printer::obs_header_placeholder()
+{
+    // a blank comment, valid RINEX until it is replaced
+    std::string line;
+    line += std::string(60, ' ');
+    line += Rinex_Printer::leftJustify("COMMENT", 20);
+    return line;
+}
+
+
+
+void Rinex_Printer::overwrite_header_lines(std::fstream& out, const std::string& filename, const std::vector<Header_Line>& lines)
+{
+    // the records written so far must reach the file before it is modified
+    out.flush();
+
+    // the output streams are in append mode, so use another one for the in-place writes
+    std::fstream header(filename, std::ios::in | std::ios::out);
+    if (!header.is_open())
+        {
+            LOG(WARNING) << "Could not open " << filename << " to update the RINEX header";
+            return;
+        }
+
+    std::vector<bool> done(lines.size(), false);
+    unsigned int pending = lines.size();
+    std::string line_str;
+    std::streampos line_start = header.tellg();
+    while (pending > 0 && std::getline(header, line_str))
+        {
+            if (line_str.find("END OF HEADER", 59) != std::string::npos)
+                {
+                    break;
+                }
+            const std::streampos next_line = header.tellg();
+            for (unsigned int i = 0; i < lines.size(); i++)
+                {
+                    if (done[i] || line_str.compare(0, lines[i].prefix.length(), lines[i].prefix) != 0
+                            || line_str.find(lines[i].label, 59) == std::string::npos)
+                        {
+                            continue;
+                        }
+                    done[i] = true;
+                    pending--;
+                    if (lines[i].text.length() != line_str.length())
+                        {
+                            LOG(WARNING) << "RINEX header line " << lines[i].label << " not updated: "
+                                    << lines[i].text.length() << " characters instead of " << line_str.length();
+                            break;
+                        }
+                    header.seekp(line_start);
+                    header << lines[i].text;
+                    header.seekg(next_line);
+                    break;
+                }
+            line_start = next_line;
+        }
+    header.close();
+}
+
+
+
+std::vector<std::string> Rinex_Printer::rotate_files()
+{
+    std::vector<std::string> closed;
+    Rinex_Printer::rotate_file(obsFile, obsfilename, "RINEX_FILE_TYPE_OBS", closed);
+    Rinex_Printer::rotate_file(navFile, navfilename, "RINEX_FILE_TYPE_GPS_NAV", closed);
+    Rinex_Printer::rotate_file(navGalFile, navGalfilename, "RINEX_FILE_TYPE_GAL_NAV", closed);
+    Rinex_Printer::rotate_file(navMixFile, navMixfilename, "RINEX_FILE_TYPE_MIXED_NAV", closed);
+    return closed;
+}
+
+
+void Rinex_Printer::rotate_file(std::fstream& out, std::string& filename, const std::string& type, std::vector<std::string>& closed)
+{
+    const long pos = out.tellp();
+    out.close();
+    if (pos == 0)
+        {
+            if(remove(filename.c_str()) != 0) LOG(INFO) << "Error deleting temporary file";
+        }
+    else
+        {
+            closed.push_back(filename);
+        }
+    filename = Rinex_Printer::createFilename(type);
+    out.open(filename, std::ios::out | std::ios::in | std::ios::app);
+}
+
+
+void Rinex_Printer::update_obs_leap_seconds(std::fstream& out, const std::string& leap_seconds_line)
+{
+    // either a previous update or the room left by rinex_obs_header()
+    std::vector<Header_Line> lines;
+    lines.push_back(Header_Line("", "LEAP SECONDS", leap_seconds_line));
+    lines.push_back(Header_Line(obs_header_placeholder().substr(0, 60), "COMMENT", leap_seconds_line));
+    Rinex_Printer::overwrite_header_lines(out, obsfilename, lines);
+}
+
+
+
 std::string Rinex_Printer::createFilename(std::string type)
 {
     const std::string stationName = "GSDR"; // 4-character station name designator
@@ -507,96 +609,50 @@ void Rinex_Printer::rinex_nav_header(std::fstream& out, const Galileo_Iono& iono
 
 void Rinex_Printer::update_nav_header(std::fstream& out, const Galileo_Iono& galileo_iono, const Galileo_Utc_Model& utc_model, const Galileo_Almanac& galileo_almanac)
 {
-    std::vector<std::string> data;
-    std::string line_aux;
-
-    long pos = out.tellp();
-    out.seekp(0);
-    data.clear();
-
-    bool no_more_finds = false;
-    std::string line_str;
+    std::vector<Header_Line> lines(4);
+    std::string line;
 
-    while(!out.eof())
-        {
-            std::getline(out, line_str);
+    line += std::string("GAL ");
+    line += std::string(1, ' ');
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_iono.ai0_5, 10, 2), 12);
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_iono.ai1_5, 10, 2), 12);
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_iono.ai2_5, 10, 2), 12);
+    double zero = 0.0;
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(zero, 10, 2), 12);
+    line += std::string(7, ' ');
+    line += Rinex_Printer::leftJustify("IONOSPHERIC CORR", 20);
+    lines[0] = Header_Line("GAL", "IONOSPHERIC CORR", line);
 
-            if(!no_more_finds)
-                {
-                    line_aux.clear();
+    line.clear();
+    line += std::string("GAUT");
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(utc_model.A0_6, 16, 2), 18);
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(utc_model.A1_6, 15, 2), 16);
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.t0t_6), 7);
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.WNot_6), 5);
+    line += std::string(10, ' ');
+    line += Rinex_Printer::leftJustify("TIME SYSTEM CORR", 20);
+    lines[1] = Header_Line("GAUT", "TIME SYSTEM CORR", line);
 
-                    if ((line_str.find("GAL", 0) != std::string::npos) && (line_str.find("IONOSPHERIC CORR", 59) != std::string::npos))
-                        {
-                            line_aux += std::string("GAL ");
-                            line_aux += std::string(1, ' ');
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_iono.ai0_5, 10, 2), 12);
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_iono.ai1_5, 10, 2), 12);
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_iono.ai2_5, 10, 2), 12);
-                            double zero = 0.0;
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(zero, 10, 2), 12);
-                            line_aux += std::string(7, ' ');
-                            line_aux += Rinex_Printer::leftJustify("IONOSPHERIC CORR", 20);
-                            data.push_back(line_aux);
-                        }
-                    else if ((line_str.find("GAUT", 0) != std::string::npos) && (line_str.find("TIME SYSTEM CORR", 59) != std::string::npos))
-                        {
-                            line_aux += std::string("GAUT");
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(utc_model.A0_6, 16, 2), 18);
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(utc_model.A1_6, 15, 2), 16);
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.t0t_6), 7);
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.WNot_6), 5);
-                            line_aux += std::string(10, ' ');
-                            line_aux += Rinex_Printer::leftJustify("TIME SYSTEM CORR", 20);
-                            data.push_back(line_aux);
-                        }
-                    else if ((line_str.find("GPGA", 0) != std::string::npos) && (line_str.find("TIME SYSTEM CORR", 59) != std::string::npos))
-                        {
-                            line_aux += std::string("GPGA");
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_almanac.A_0G_10, 16, 2), 18);
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_almanac.A_1G_10, 15, 2), 16);
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(galileo_almanac.t_0G_10), 7);
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(galileo_almanac.WN_0G_10), 5);
-                            line_aux += std::string(10, ' ');
-                            line_aux += Rinex_Printer::leftJustify("TIME SYSTEM CORR", 20);
-                            data.push_back(line_aux);
-                        }
-                    else if (line_str.find("LEAP SECONDS", 59) != std::string::npos)
-                        {
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.Delta_tLS_6), 6);
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.Delta_tLSF_6), 6);
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.WN_LSF_6), 6);
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.DN_6), 6);
-                            line_aux += std::string(36, ' ');
-                            line_aux += Rinex_Printer::leftJustify("LEAP SECONDS", 20);
-                            data.push_back(line_aux);
-                        }
-                    else if (line_str.find("END OF HEADER", 59) != std::string::npos)
-                        {
-                            data.push_back(line_str);
-                            no_more_finds = true;
-                        }
-                    else
-                        {
-                            data.push_back(line_str);
-                        }
+    line.clear();
+    line += std::string("GPGA");
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_almanac.A_0G_10, 16, 2), 18);
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_almanac.A_1G_10, 15, 2), 16);
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(galileo_almanac.t_0G_10), 7);
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(galileo_almanac.WN_0G_10), 5);
+    line += std::string(10, ' ');
+    line += Rinex_Printer::leftJustify("TIME SYSTEM CORR", 20);
+    lines[2] = Header_Line("GPGA", "TIME SYSTEM CORR", line);
 
-                }
-            else
-                {
-                    data.push_back(line_str);
-                }
-        }
+    line.clear();
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.Delta_tLS_6), 6);
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.Delta_tLSF_6), 6);
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.WN_LSF_6), 6);
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.DN_6), 6);
+    line += std::string(36, ' ');
+    line += Rinex_Printer::leftJustify("LEAP SECONDS", 20);
+    lines[3] = Header_Line("", "LEAP SECONDS", line);
 
-    out.close();
-    out.open(navGalfilename, std::ios::out | std::ios::trunc);
-    out.seekp(0);
-    for (int i = 0; i < (int) data.size() - 1; i++)
-        {
-            out << data[i] << std::endl;
-        }
-    out.close();
-    out.open(navGalfilename, std::ios::out | std::ios::app);
-    out.seekp(pos);
+    Rinex_Printer::overwrite_header_lines(out, navGalfilename, lines);
     std::cout << "The RINEX Navigation file header has been updated with UTC and IONO info." << std::endl;
 }
 
@@ -604,151 +660,91 @@ void Rinex_Printer::update_nav_header(std::fstream& out, const Galileo_Iono& gal
 
 void Rinex_Printer::update_nav_header(std::fstream& out, const Gps_Utc_Model& utc_model, const Gps_Iono& iono)
 {
-    std::vector<std::string> data;
-    std::string line_aux;
-
-    long pos = out.tellp();
-    out.seekp(0);
-    data.clear();
-
-    bool no_more_finds = false;
-    std::string line_str;
+    std::vector<Header_Line> lines;
+    std::string line;
 
-    while(!out.eof())
+    if (version == 2)
         {
-            std::getline(out, line_str);
+            line += std::string(2, ' ');
+            line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_alpha0, 10, 2), 12);
+            line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_alpha1, 10, 2), 12);
+            line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_alpha2, 10, 2), 12);
+            line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_alpha3, 10, 2), 12);
+            line += std::string(10, ' ');
+            line += Rinex_Printer::leftJustify("ION ALPHA", 20);
+            lines.push_back(Header_Line("", "ION ALPHA", line));
 
-            if(!no_more_finds)
-                {
-                    line_aux.clear();
+            line.clear();
+            line += std::string(2, ' ');
+            line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_beta0, 10, 2), 12);
+            line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_beta1, 10, 2), 12);
+            line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_beta2, 10, 2), 12);
+            line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_beta3, 10, 2), 12);
+            line += std::string(10, ' ');
+            line += Rinex_Printer::leftJustify("ION BETA", 20);
+            lines.push_back(Header_Line("", "ION BETA", line));
 
-                    if (version == 2)
-                        {
-                            if (line_str.find("ION ALPHA", 59) != std::string::npos)
-                                {
-                                    line_aux += std::string(2, ' ');
-                                    line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_alpha0, 10, 2), 12);
-                                    line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_alpha1, 10, 2), 12);
-                                    line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_alpha2, 10, 2), 12);
-                                    line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_alpha3, 10, 2), 12);
-                                    line_aux += std::string(10, ' ');
-                                    line_aux += Rinex_Printer::leftJustify("ION ALPHA", 20);
-                                    data.push_back(line_aux);
-                                }
-                            else if (line_str.find("ION BETA", 59) != std::string::npos)
-                                {
-                                    line_aux += std::string(2, ' ');
-                                    line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_beta0, 10, 2), 12);
-                                    line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_beta1, 10, 2), 12);
-                                    line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_beta2, 10, 2), 12);
-                                    line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_beta3, 10, 2), 12);
-                                    line_aux += std::string(10, ' ');
-                                    line_aux += Rinex_Printer::leftJustify("ION BETA", 20);
-                                    data.push_back(line_aux);
-                                }
-                            else if (line_str.find("DELTA-UTC", 59) != std::string::npos)
-                                {
-                                    line_aux += std::string(3, ' ');
-                                    line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(utc_model.d_A0, 18, 2), 19);
-                                    line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(utc_model.d_A1, 18, 2), 19);
-                                    line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.d_t_OT), 9);
-                                    line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.i_WN_T + 1024), 9); // valid until 2019
-                                    line_aux += std::string(1, ' ');
-                                    line_aux += Rinex_Printer::leftJustify("DELTA-UTC: A0,A1,T,W", 20);
-                                    data.push_back(line_aux);
-                                }
-                            else if (line_str.find("LEAP SECONDS", 59) != std::string::npos)
-                                {
-                                    line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.d_DeltaT_LS), 6);
-                                    line_aux += std::string(54, ' ');
-                                    line_aux += Rinex_Printer::leftJustify("LEAP SECONDS", 20);
-                                    data.push_back(line_aux);
-                                }
-                            else if (line_str.find("END OF HEADER", 59) != std::string::npos)
-                                {
-                                    data.push_back(line_str);
-                                    no_more_finds = true;
-                                }
-                            else
-                                {
-                                    data.push_back(line_str);
-                                }
-                        }
+            line.clear();
+            line += std::string(3, ' ');
+            line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(utc_model.d_A0, 18, 2), 19);
+            line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(utc_model.d_A1, 18, 2), 19);
+            line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.d_t_OT), 9);
+            line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.i_WN_T + 1024), 9); // valid until 2019
+            line += std::string(1, ' ');
+            line += Rinex_Printer::leftJustify("DELTA-UTC: A0,A1,T,W", 20);
+            lines.push_back(Header_Line("", "DELTA-UTC", line));
 
-                    if (version == 3)
-                        {
-                            if (line_str.find("GPSA", 0) != std::string::npos)
-                                {
-                                    line_aux += std::string("GPSA");
-                                    line_aux += std::string(1, ' ');
-                                    line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_alpha0, 10, 2), 12);
-                                    line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_alpha1, 10, 2), 12);
-                                    line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_alpha2, 10, 2), 12);
-                                    line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_alpha3, 10, 2), 12);
-                                    line_aux += std::string(7, ' ');
-                                    line_aux += Rinex_Printer::leftJustify("IONOSPHERIC CORR", 20);
-                                    data.push_back(line_aux);
-                                }
-                            else if (line_str.find("GPSB", 0) != std::string::npos)
-                                {
-                                    line_aux += std::string("GPSB");
-                                    line_aux += std::string(1, ' ');
-                                    line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_beta0, 10, 2), 12);
-                                    line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_beta1, 10, 2), 12);
-                                    line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_beta2, 10, 2), 12);
-                                    line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_beta3, 10, 2), 12);
-                                    line_aux += std::string(7, ' ');
-                                    line_aux += Rinex_Printer::leftJustify("IONOSPHERIC CORR", 20);
-                                    data.push_back(line_aux);
-                                }
-                            else if (line_str.find("GPUT", 0) != std::string::npos)
-                                {
-                                    line_aux += std::string("GPUT");
-                                    line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(utc_model.d_A0, 16, 2), 18);
-                                    line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(utc_model.d_A1, 15, 2), 16);
-                                    line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.d_t_OT), 7);
-                                    line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.i_WN_T + 1024), 5);  // valid until 2019
-                                    line_aux += std::string(10, ' ');
-                                    line_aux += Rinex_Printer::leftJustify("TIME SYSTEM CORR", 20);
-                                    data.push_back(line_aux);
-                                }
-                            else if (line_str.find("LEAP SECONDS", 59) != std::string::npos)
-                                {
-                                    line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.d_DeltaT_LS), 6);
-                                    line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.d_DeltaT_LSF), 6);
-                                    line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.i_WN_LSF), 6);
-                                    line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.i_DN), 6);
-                                    line_aux += std::string(36, ' ');
-                                    line_aux += Rinex_Printer::leftJustify("LEAP SECONDS", 20);
-                                    data.push_back(line_aux);
-                                }
-                            else if (line_str.find("END OF HEADER", 59) != std::string::npos)
-                                {
-                                    data.push_back(line_str);
-                                    no_more_finds = true;
-                                }
-                            else
-                                {
-                                    data.push_back(line_str);
-                                }
-                        }
-                }
-            else
-                {
-                    data.push_back(line_str);
-                }
+            line.clear();
+            line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.d_DeltaT_LS), 6);
+            line += std::string(54, ' ');
+            line += Rinex_Printer::leftJustify("LEAP SECONDS", 20);
+            lines.push_back(Header_Line("", "LEAP SECONDS", line));
         }
 
-    out.close();
-    out.open(navfilename, std::ios::out | std::ios::trunc);
-    out.seekp(0);
-    for (int i = 0; i < (int) data.size() - 1; i++)
+    if (version == 3)
         {
-            out << data[i] << std::endl;
+            line += std::string("GPSA");
+            line += std::string(1, ' ');
+            line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_alpha0, 10, 2), 12);
+            line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_alpha1, 10, 2), 12);
+            line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_alpha2, 10, 2), 12);
+            line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_alpha3, 10, 2), 12);
+            line += std::string(7, ' ');
+            line += Rinex_Printer::leftJustify("IONOSPHERIC CORR", 20);
+            lines.push_back(Header_Line("GPSA", "IONOSPHERIC CORR", line));
+
+            line.clear();
+            line += std::string("GPSB");
+            line += std::string(1, ' ');
+            line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_beta0, 10, 2), 12);
+            line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_beta1, 10, 2), 12);
+            line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_beta2, 10, 2), 12);
+            line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(iono.d_beta3, 10, 2), 12);
+            line += std::string(7, ' ');
+            line += Rinex_Printer::leftJustify("IONOSPHERIC CORR", 20);
+            lines.push_back(Header_Line("GPSB", "IONOSPHERIC CORR", line));
+
+            line.clear();
+            line += std::string("GPUT");
+            line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(utc_model.d_A0, 16, 2), 18);
+            line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(utc_model.d_A1, 15, 2), 16);
+            line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.d_t_OT), 7);
+            line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.i_WN_T + 1024), 5);  // valid until 2019
+            line += std::string(10, ' ');
+            line += Rinex_Printer::leftJustify("TIME SYSTEM CORR", 20);
+            lines.push_back(Header_Line("GPUT", "TIME SYSTEM CORR", line));
+
+            line.clear();
+            line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.d_DeltaT_LS), 6);
+            line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.d_DeltaT_LSF), 6);
+            line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.i_WN_LSF), 6);
+            line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.i_DN), 6);
+            line += std::string(36, ' ');
+            line += Rinex_Printer::leftJustify("LEAP SECONDS", 20);
+            lines.push_back(Header_Line("", "LEAP SECONDS", line));
         }
-    out.close();
-    out.open(navfilename, std::ios::out | std::ios::app);
-    out.seekp(pos);
+
+    Rinex_Printer::overwrite_header_lines(out, navfilename, lines);
     std::cout << "The RINEX Navigation file header has been updated with UTC and IONO info." << std::endl;
 }
 
@@ -934,131 +930,82 @@ void Rinex_Printer::rinex_nav_header(std::fstream& out, const Gps_Iono& iono, co
 
 void Rinex_Printer::update_nav_header(std::fstream& out, const Gps_Iono& gps_iono, const Gps_Utc_Model& gps_utc_model, const Galileo_Iono& galileo_iono, const Galileo_Utc_Model& galileo_utc_model, const Galileo_Almanac& galileo_almanac)
 {
-    std::vector<std::string> data;
-    std::string line_aux;
+    std::vector<Header_Line> lines(7);
+    std::string line;
 
-    long pos = out.tellp();
-    out.seekp(0);
-    data.clear();
+    line += std::string("GPSA");
+    line += std::string(1, ' ');
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(gps_iono.d_alpha0, 10, 2), 12);
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(gps_iono.d_alpha1, 10, 2), 12);
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(gps_iono.d_alpha2, 10, 2), 12);
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(gps_iono.d_alpha3, 10, 2), 12);
+    line += std::string(7, ' ');
+    line += Rinex_Printer::leftJustify("IONOSPHERIC CORR", 20);
+    lines[0] = Header_Line("GPSA", "IONOSPHERIC CORR", line);
 
-    bool no_more_finds = false;
-    std::string line_str;
+    line.clear();
+    line += std::string("GAL ");
+    line += std::string(1, ' ');
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_iono.ai0_5, 10, 2), 12);
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_iono.ai1_5, 10, 2), 12);
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_iono.ai2_5, 10, 2), 12);
+    double zero = 0.0;
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(zero, 10, 2), 12);
+    line += std::string(7, ' ');
+    line += Rinex_Printer::leftJustify("IONOSPHERIC CORR", 20);
+    lines[1] = Header_Line("GAL", "IONOSPHERIC CORR", line);
 
-    while(!out.eof())
-        {
-            std::getline(out, line_str);
+    line.clear();
+    line += std::string("GPSB");
+    line += std::string(1, ' ');
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(gps_iono.d_beta0, 10, 2), 12);
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(gps_iono.d_beta1, 10, 2), 12);
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(gps_iono.d_beta2, 10, 2), 12);
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(gps_iono.d_beta3, 10, 2), 12);
+    line += std::string(7, ' ');
+    line += Rinex_Printer::leftJustify("IONOSPHERIC CORR", 20);
+    lines[2] = Header_Line("GPSB", "IONOSPHERIC CORR", line);
 
-            if(!no_more_finds)
-                {
-                    line_aux.clear();
+    line.clear();
+    line += std::string("GPUT");
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(gps_utc_model.d_A0, 16, 2), 18);
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(gps_utc_model.d_A1, 15, 2), 16);
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(gps_utc_model.d_t_OT), 7);
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(gps_utc_model.i_WN_T + 1024), 5);  // valid until 2019
+    line += std::string(10, ' ');
+    line += Rinex_Printer::leftJustify("TIME SYSTEM CORR", 20);
+    lines[3] = Header_Line("GPUT", "TIME SYSTEM CORR", line);
 
-                    if (line_str.find("GPSA", 0) != std::string::npos)
-                        {
-                            line_aux += std::string("GPSA");
-                            line_aux += std::string(1, ' ');
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(gps_iono.d_alpha0, 10, 2), 12);
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(gps_iono.d_alpha1, 10, 2), 12);
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(gps_iono.d_alpha2, 10, 2), 12);
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(gps_iono.d_alpha3, 10, 2), 12);
-                            line_aux += std::string(7, ' ');
-                            line_aux += Rinex_Printer::leftJustify("IONOSPHERIC CORR", 20);
-                            data.push_back(line_aux);
-                        }
-                    else if ((line_str.find("GAL", 0) != std::string::npos) && (line_str.find("IONOSPHERIC CORR", 59) != std::string::npos))
-                        {
-                            line_aux += std::string("GAL ");
-                            line_aux += std::string(1, ' ');
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_iono.ai0_5, 10, 2), 12);
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_iono.ai1_5, 10, 2), 12);
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_iono.ai2_5, 10, 2), 12);
-                            double zero = 0.0;
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(zero, 10, 2), 12);
-                            line_aux += std::string(7, ' ');
-                            line_aux += Rinex_Printer::leftJustify("IONOSPHERIC CORR", 20);
-                            data.push_back(line_aux);
-                        }
-                    else if ((line_str.find("GPSB", 0) != std::string::npos) && (line_str.find("IONOSPHERIC CORR", 59) != std::string::npos))
-                        {
-                            line_aux += std::string("GPSB");
-                            line_aux += std::string(1, ' ');
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(gps_iono.d_beta0, 10, 2), 12);
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(gps_iono.d_beta1, 10, 2), 12);
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(gps_iono.d_beta2, 10, 2), 12);
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(gps_iono.d_beta3, 10, 2), 12);
-                            line_aux += std::string(7, ' ');
-                            line_aux += Rinex_Printer::leftJustify("IONOSPHERIC CORR", 20);
-                            data.push_back(line_aux);
-                        }
-                    else if ((line_str.find("GPUT", 0) != std::string::npos) && (line_str.find("TIME SYSTEM CORR", 59) != std::string::npos))
-                        {
-                            line_aux += std::string("GPUT");
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(gps_utc_model.d_A0, 16, 2), 18);
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(gps_utc_model.d_A1, 15, 2), 16);
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(gps_utc_model.d_t_OT), 7);
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(gps_utc_model.i_WN_T + 1024), 5);  // valid until 2019
-                            line_aux += std::string(10, ' ');
-                            line_aux += Rinex_Printer::leftJustify("TIME SYSTEM CORR", 20);
-                            data.push_back(line_aux);
-                        }
-                    else if ((line_str.find("GAUT", 0) != std::string::npos) && (line_str.find("TIME SYSTEM CORR", 59) != std::string::npos))
-                        {
-                            line_aux += std::string("GAUT");
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_utc_model.A0_6, 16, 2), 18);
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_utc_model.A1_6, 15, 2), 16);
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(galileo_utc_model.t0t_6), 7);
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(galileo_utc_model.WNot_6), 5);
-                            line_aux += std::string(10, ' ');
-                            line_aux += Rinex_Printer::leftJustify("TIME SYSTEM CORR", 20);
-                            data.push_back(line_aux);
-                        }
-                    else if ((line_str.find("GPGA", 0) != std::string::npos) && (line_str.find("TIME SYSTEM CORR", 59) != std::string::npos))
-                        {
-                            line_aux += std::string("GPGA");
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_almanac.A_0G_10, 16, 2), 18);
-                            line_aux += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_almanac.A_1G_10, 15, 2), 16);
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(galileo_almanac.t_0G_10), 7);
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(galileo_almanac.WN_0G_10), 5);
-                            line_aux += std::string(10, ' ');
-                            line_aux += Rinex_Printer::leftJustify("TIME SYSTEM CORR", 20);
-                            data.push_back(line_aux);
-                        }
-                    else if (line_str.find("LEAP SECONDS", 59) != std::string::npos)
-                        {
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(gps_utc_model.d_DeltaT_LS), 6);
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(gps_utc_model.d_DeltaT_LSF), 6);
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(gps_utc_model.i_WN_LSF), 6);
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(gps_utc_model.i_DN), 6);
-                            line_aux += std::string(36, ' ');
-                            line_aux += Rinex_Printer::leftJustify("LEAP SECONDS", 20);
-                            data.push_back(line_aux);
-                        }
-                    else if (line_str.find("END OF HEADER", 59) != std::string::npos)
-                        {
-                            data.push_back(line_str);
-                            no_more_finds = true;
-                        }
-                    else
-                        {
-                            data.push_back(line_str);
-                        }
+    line.clear();
+    line += std::string("GAUT");
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_utc_model.A0_6, 16, 2), 18);
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_utc_model.A1_6, 15, 2), 16);
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(galileo_utc_model.t0t_6), 7);
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(galileo_utc_model.WNot_6), 5);
+    line += std::string(10, ' ');
+    line += Rinex_Printer::leftJustify("TIME SYSTEM CORR", 20);
+    lines[4] = Header_Line("GAUT", "TIME SYSTEM CORR", line);
 
-                }
-            else
-                {
-                    data.push_back(line_str);
-                }
-        }
+    line.clear();
+    line += std::string("GPGA");
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_almanac.A_0G_10, 16, 2), 18);
+    line += Rinex_Printer::rightJustify(Rinex_Printer::doub2for(galileo_almanac.A_1G_10, 15, 2), 16);
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(galileo_almanac.t_0G_10), 7);
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(galileo_almanac.WN_0G_10), 5);
+    line += std::string(10, ' ');
+    line += Rinex_Printer::leftJustify("TIME SYSTEM CORR", 20);
+    lines[5] = Header_Line("GPGA", "TIME SYSTEM CORR", line);
 
-    out.close();
-    out.open(navMixfilename, std::ios::out | std::ios::trunc);
-    out.seekp(0);
-    for (int i = 0; i < (int) data.size() - 1; i++)
-        {
-            out << data[i] << std::endl;
-        }
-    out.close();
-    out.open(navMixfilename, std::ios::out | std::ios::app);
-    out.seekp(pos);
+    line.clear();
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(gps_utc_model.d_DeltaT_LS), 6);
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(gps_utc_model.d_DeltaT_LSF), 6);
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(gps_utc_model.i_WN_LSF), 6);
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(gps_utc_model.i_DN), 6);
+    line += std::string(36, ' ');
+    line += Rinex_Printer::leftJustify("LEAP SECONDS", 20);
+    lines[6] = Header_Line("", "LEAP SECONDS", line);
+
+    Rinex_Printer::overwrite_header_lines(out, navMixfilename, lines);
     std::cout << "The RINEX Navigation file header has been updated with UTC and IONO info." << std::endl;
 }
 
@@ -1308,6 +1255,7 @@ void Rinex_Printer::rinex_sbs_header(std::fstream& out)
 
 void Rinex_Printer::log_rinex_nav(std::fstream& out, const std::map<int,Gps_Ephemeris>& eph_map)
 {
+    GNSS_SDR_TRACE_SCOPE("Rinex_Printer::log_rinex_nav");
     std::string line;
     std::map<int,Gps_Ephemeris>::const_iterator gps_ephemeris_iter;
 
@@ -1420,7 +1368,7 @@ void Rinex_Printer::log_rinex_nav(std::fstream& out, const std::map<int,Gps_Ephe
                     line += Rinex_Printer::doub2for(gps_ephemeris_iter->second.d_A_f2, 18, 2);
                 }
             Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
+            out << line << '\n';
 
 
             // -------- BROADCAST ORBIT - 1
@@ -1454,7 +1402,7 @@ void Rinex_Printer::log_rinex_nav(std::fstream& out, const std::map<int,Gps_Ephe
                     line += std::string(1, ' ');
                 }
             Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
+            out << line << '\n';
 
 
             // -------- BROADCAST ORBIT - 2
@@ -1479,7 +1427,7 @@ void Rinex_Printer::log_rinex_nav(std::fstream& out, const std::map<int,Gps_Ephe
                     line += std::string(1, ' ');
                 }
             Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
+            out << line << '\n';
 
 
 
@@ -1505,7 +1453,7 @@ void Rinex_Printer::log_rinex_nav(std::fstream& out, const std::map<int,Gps_Ephe
                     line += std::string(1, ' ');
                 }
             Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
+            out << line << '\n';
 
 
 
@@ -1531,7 +1479,7 @@ void Rinex_Printer::log_rinex_nav(std::fstream& out, const std::map<int,Gps_Ephe
                     line += std::string(1, ' ');
                 }
             Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
+            out << line << '\n';
 
 
 
@@ -1558,7 +1506,7 @@ void Rinex_Printer::log_rinex_nav(std::fstream& out, const std::map<int,Gps_Ephe
                     line += std::string(1, ' ');
                 }
             Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
+            out << line << '\n';
 
 
             // -------- BROADCAST ORBIT - 6
@@ -1583,7 +1531,7 @@ void Rinex_Printer::log_rinex_nav(std::fstream& out, const std::map<int,Gps_Ephe
                     line += std::string(1, ' ');
                 }
             Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
+            out << line << '\n';
 
 
             // -------- BROADCAST ORBIT - 7
@@ -1631,14 +1579,16 @@ void Rinex_Printer::log_rinex_nav(std::fstream& out, const std::map<int,Gps_Ephe
                     line += std::string(1, ' ');
                 }
             Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
+            out << line << '\n';
             line.clear();
         }
+    out.flush();
 }
 
 
 void Rinex_Printer::log_rinex_nav(std::fstream& out, const std::map<int, Galileo_Ephemeris>& eph_map)
 {
+    GNSS_SDR_TRACE_SCOPE("Rinex_Printer::log_rinex_nav");
     std::string line;
     std::map<int,Galileo_Ephemeris>::const_iterator galileo_ephemeris_iter;
     line.clear();
@@ -1679,7 +1629,7 @@ void Rinex_Printer::log_rinex_nav(std::fstream& out, const std::map<int, Galileo
             line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.af2_4, 18, 2);
 
             Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
+            out << line << '\n';
 
 
             // -------- BROADCAST ORBIT - 1
@@ -1693,7 +1643,7 @@ void Rinex_Printer::log_rinex_nav(std::fstream& out, const std::map<int, Galileo
             line += std::string(1, ' ');
             line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.M0_1, 18, 2);
             Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
+            out << line << '\n';
 
 
             // -------- BROADCAST ORBIT - 2
@@ -1707,7 +1657,7 @@ void Rinex_Printer::log_rinex_nav(std::fstream& out, const std::map<int, Galileo
             line += std::string(1, ' ');
             line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.A_1, 18, 2);
             Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
+            out << line << '\n';
 
 
             // -------- BROADCAST ORBIT - 3
@@ -1721,7 +1671,7 @@ void Rinex_Printer::log_rinex_nav(std::fstream& out, const std::map<int, Galileo
             line += std::string(1, ' ');
             line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.C_is_4, 18, 2);
             Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
+            out << line << '\n';
 
 
             // -------- BROADCAST ORBIT - 4
@@ -1735,7 +1685,7 @@ void Rinex_Printer::log_rinex_nav(std::fstream& out, const std::map<int, Galileo
             line += std::string(1, ' ');
             line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.OMEGA_dot_3, 18, 2);
             Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
+            out << line << '\n';
 
 
             // -------- BROADCAST ORBIT - 5
@@ -1756,7 +1706,7 @@ void Rinex_Printer::log_rinex_nav(std::fstream& out, const std::map<int, Galileo
             double zero = 0.0;
             line += Rinex_Printer::doub2for(zero, 18, 2);
             Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
+            out << line << '\n';
 
 
             // -------- BROADCAST ORBIT - 6
@@ -1796,7 +1746,7 @@ void Rinex_Printer::log_rinex_nav(std::fstream& out, const std::map<int, Galileo
             line += std::string(1, ' ');
             line += Rinex_Printer::doub2for(galileo_ephemeris_iter->second.BGD_E1E5b_5, 18, 2);
             Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
+            out << line << '\n';
 
 
             // -------- BROADCAST ORBIT - 7
@@ -1810,14 +1760,16 @@ void Rinex_Printer::log_rinex_nav(std::fstream& out, const std::map<int, Galileo
             line += std::string(1, ' ');
             line += std::string(18, ' '); // spare
             Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
+            out << line << '\n';
             line.clear();
         }
+    out.flush();
 }
 
 
 void Rinex_Printer::log_rinex_nav(std::fstream& out, const std::map<int, Gps_Ephemeris>& gps_eph_map, const std::map<int, Galileo_Ephemeris>& galileo_eph_map)
 {
+    GNSS_SDR_TRACE_SCOPE("Rinex_Printer::log_rinex_nav");
     version = 3;
     stringVersion = "3.02";
     Rinex_Printer::log_rinex_nav(out, gps_eph_map);
@@ -1826,84 +1778,23 @@ void Rinex_Printer::log_rinex_nav(std::fstream& out, const std::map<int, Gps_Eph
 
 void Rinex_Printer::update_obs_header(std::fstream& out, const Gps_Utc_Model& utc_model)
 {
-    std::vector<std::string> data;
-    std::string line_aux;
-
-    out.seekp(0);
-    data.clear();
-
-    bool no_more_finds = false;
-    std::string line_str;
-
-    while(!out.eof())
+    std::string line;
+    if (version == 2)
         {
-            std::getline(out, line_str);
-
-            if(!no_more_finds)
-                {
-                    line_aux.clear();
-
-                    if (version == 2)
-                        {
-                            if (line_str.find("TIME OF FIRST OBS", 59) != std::string::npos) // TIME OF FIRST OBS last header annotation might change in the future
-                                {
-                                    data.push_back(line_str);
-                                    line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.d_DeltaT_LS), 6);
-                                    line_aux += std::string(54, ' ');
-                                    line_aux += Rinex_Printer::leftJustify("LEAP SECONDS", 20);
-                                    data.push_back(line_aux);
-                                }
-                            else if (line_str.find("END OF HEADER", 59) != std::string::npos)
-                                {
-                                    data.push_back(line_str);
-                                    no_more_finds = true;
-                                }
-                            else
-                                {
-                                    data.push_back(line_str);
-                                }
-                        }
-
-                    if (version == 3)
-                        {
-                            if (line_str.find("TIME OF FIRST OBS", 59) != std::string::npos)
-                                {
-                                    data.push_back(line_str);
-                                    line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.d_DeltaT_LS), 6);
-                                    line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.d_DeltaT_LSF), 6);
-                                    line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.i_WN_LSF), 6);
-                                    line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.i_DN), 6);
-                                    line_aux += std::string(36, ' ');
-                                    line_aux += Rinex_Printer::leftJustify("LEAP SECONDS", 20);
-                                    data.push_back(line_aux);
-                                }
-                            else if (line_str.find("END OF HEADER", 59) != std::string::npos)
-                                {
-                                    data.push_back(line_str);
-                                    no_more_finds = true;
-                                }
-                            else
-                                {
-                                    data.push_back(line_str);
-                                }
-                        }
-                }
-            else
-                {
-                    data.push_back(line_str);
-                }
+            line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.d_DeltaT_LS), 6);
+            line += std::string(54, ' ');
+            line += Rinex_Printer::leftJustify("LEAP SECONDS", 20);
         }
-
-    out.close();
-    out.open(obsfilename, std::ios::out | std::ios::trunc);
-    out.seekp(0);
-    for (int i = 0; i < (int) data.size() - 1; i++)
+    if (version == 3)
         {
-            out << data[i] << std::endl;
+            line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.d_DeltaT_LS), 6);
+            line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.d_DeltaT_LSF), 6);
+            line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.i_WN_LSF), 6);
+            line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(utc_model.i_DN), 6);
+            line += std::string(36, ' ');
+            line += Rinex_Printer::leftJustify("LEAP SECONDS", 20);
         }
-    out.close();
-    out.open(obsfilename, std::ios::out | std::ios::in | std::ios::app);
-    out.seekp(0, std::ios_base::end);
+    Rinex_Printer::update_obs_leap_seconds(out, line);
 }
 
 
@@ -2157,6 +2048,9 @@ void Rinex_Printer::rinex_obs_header(std::fstream& out, const Gps_Ephemeris& eph
     Rinex_Printer::lengthCheck(line);
     out << line << std::endl;
 
+    // -------- room for the LEAP SECONDS line, see update_obs_header()
+    out << Rinex_Printer::obs_header_placeholder() << std::endl;
+
     // -------- SYS /PHASE SHIFTS
 
     // -------- end of header
@@ -2170,61 +2064,14 @@ void Rinex_Printer::rinex_obs_header(std::fstream& out, const Gps_Ephemeris& eph
 
 void Rinex_Printer::update_obs_header(std::fstream& out, const Galileo_Utc_Model& galileo_utc_model)
 {
-    std::vector<std::string> data;
-    std::string line_aux;
-
-    out.seekp(0);
-    data.clear();
-
-    bool no_more_finds = false;
-    std::string line_str;
-
-    while(!out.eof())
-        {
-            std::getline(out, line_str);
-
-            if(!no_more_finds)
-                {
-                    line_aux.clear();
-
-                    if (line_str.find("TIME OF FIRST OBS", 59) != std::string::npos)
-                        {
-                            data.push_back(line_str);
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(galileo_utc_model.Delta_tLS_6), 6);
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(galileo_utc_model.Delta_tLSF_6), 6);
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(galileo_utc_model.WN_LSF_6), 6);
-                            line_aux += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(galileo_utc_model.DN_6), 6);
-                            line_aux += std::string(36, ' ');
-                            line_aux += Rinex_Printer::leftJustify("LEAP SECONDS", 20);
-                            data.push_back(line_aux);
-                        }
-                    else if (line_str.find("END OF HEADER", 59) != std::string::npos)
-                        {
-                            data.push_back(line_str);
-                            no_more_finds = true;
-                        }
-                    else
-                        {
-                            data.push_back(line_str);
-                        }
-
-                }
-            else
-                {
-                    data.push_back(line_str);
-                }
-        }
-
-    out.close();
-    out.open(obsfilename, std::ios::out | std::ios::trunc);
-    out.seekp(0);
-    for (int i = 0; i < (int) data.size() - 1; i++)
-        {
-            out << data[i] << std::endl;
-        }
-    out.close();
-    out.open(obsfilename, std::ios::out | std::ios::in |std::ios::app);
-    out.seekp(0, std::ios_base::end);
+    std::string line;
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(galileo_utc_model.Delta_tLS_6), 6);
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(galileo_utc_model.Delta_tLSF_6), 6);
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(galileo_utc_model.WN_LSF_6), 6);
+    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(galileo_utc_model.DN_6), 6);
+    line += std::string(36, ' ');
+    line += Rinex_Printer::leftJustify("LEAP SECONDS", 20);
+    Rinex_Printer::update_obs_leap_seconds(out, line);
 }
 
 
@@ -2419,6 +2266,9 @@ void Rinex_Printer::rinex_obs_header(std::fstream& out, const Galileo_Ephemeris&
     Rinex_Printer::lengthCheck(line);
     out << line << std::endl;
 
+    // -------- room for the LEAP SECONDS line, see update_obs_header()
+    out << Rinex_Printer::obs_header_placeholder() << std::endl;
+
     // -------- SYS /PHASE SHIFTS
 
     // -------- end of header
@@ -2651,6 +2501,9 @@ void Rinex_Printer::rinex_obs_header(std::fstream& out, const Gps_Ephemeris& gps
     Rinex_Printer::lengthCheck(line);
     out << line << std::endl;
 
+    // -------- room for the LEAP SECONDS line, see update_obs_header()
+    out << Rinex_Printer::obs_header_placeholder() << std::endl;
+
     // -------- end of header
     line.clear();
     line += std::string(60, ' ');
@@ -2660,25 +2513,114 @@ void Rinex_Printer::rinex_obs_header(std::fstream& out, const Gps_Ephemeris& gps
 }
 
 
+void Rinex_Printer::log_rinex_obs_epoch(std::fstream& out, const boost::posix_time::ptime& p_time, double obs_time, int num_satellites)
+{
+    char line[96];
+    char* p = line;
+    const boost::gregorian::date date = p_time.date();
+    const boost::posix_time::time_duration time_of_day = p_time.time_of_day();
+    *p++ = '>';
+    *p++ = ' ';
+    p = Rinex_Printer::putInt(p, date.year(), 4, '0');
+    *p++ = ' ';
+    p = Rinex_Printer::putInt(p, date.month().as_number(), 2, '0');
+    *p++ = ' ';
+    p = Rinex_Printer::putInt(p, date.day(), 2, '0');
+    *p++ = ' ';
+    p = Rinex_Printer::putInt(p, time_of_day.hours(), 2, '0');
+    *p++ = ' ';
+    p = Rinex_Printer::putInt(p, time_of_day.minutes(), 2, '0');
+    *p++ = ' ';
+    double seconds = fmod(obs_time, 60);
+    // Add extra 0 if seconds are < 10
+    if (seconds < 10)
+        {
+            *p++ = '0';
+        }
+    std::string seconds_string = Rinex_Printer::asString(seconds, 7);
+    p = Rinex_Printer::putRight(p, seconds_string.data(), seconds_string.size(), seconds_string.size());
+    *p++ = ' ';
+    *p++ = ' ';
+    // Epoch flag 0: OK     1: power failure between previous and current epoch   <1: Special event
+    *p++ = '0';
+    //Number of satellites observed in current epoch
+    p = Rinex_Printer::putInt(p, num_satellites, 3);
+
+    // Receiver clock offset (optional)
+    //line += rightJustify(asString(clockOffset, 12), 15);
+
+    while (p < line + 80)
+        {
+            *p++ = ' ';
+        }
+    if (p != line + 80)
+        {
+            Rinex_Printer::lengthCheck(std::string(line, p - line));
+        }
+    *p++ = '\n';
+    out.write(line, p - line);
+}
+
+
+void Rinex_Printer::log_rinex_obs_record(std::fstream& out, const char* sat_system, int sat_number, const Gnss_Synchro& gnss_synchro, double two_pi)
+{
+    char line[96];
+    char* p = line;
+    if (sat_system != 0)
+        {
+            while (*sat_system != '\0')
+                {
+                    *p++ = *sat_system++;
+                }
+            p = Rinex_Printer::putInt(p, sat_number, (sat_number < 100) ? 2 : 3, '0');
+        }
+
+    // Signal Strength Indicator (SSI)
+    int ssi = Rinex_Printer::signalStrength(gnss_synchro.CN0_dB_hz);
+
+    // PSEUDORANGE, PHASE and DOPPLER, each followed by the Loss of lock
+    // indicator (LLI, not included yet) and the signal strength indicator
+    const double observables[3] = {gnss_synchro.Pseudorange_m,
+            gnss_synchro.Carrier_phase_rads / two_pi,
+            gnss_synchro.Carrier_Doppler_hz};
+    for (int i = 0; i < 3; i++)
+        {
+            p = Rinex_Printer::putFixed(p, observables[i], 14, 3);
+            *p++ = ' ';
+            p = Rinex_Printer::putInt(p, ssi, 1);
+        }
+
+    // SIGNAL STRENGTH
+    p = Rinex_Printer::putFixed(p, gnss_synchro.CN0_dB_hz, 14, 3);
+
+    while (p < line + 80)
+        {
+            *p++ = ' ';
+        }
+    *p++ = '\n';
+    out.write(line, p - line);
+}
+
+
 void Rinex_Printer::log_rinex_obs(std::fstream& out, const Gps_Ephemeris& eph, const double obs_time, const std::map<int,Gnss_Synchro>& pseudoranges)
 {
+    GNSS_SDR_TRACE_SCOPE("Rinex_Printer::log_rinex_obs");
     // RINEX observations timestamps are GPS timestamps.
-    std::string line;
-
     boost::posix_time::ptime p_gps_time = Rinex_Printer::compute_GPS_time(eph, obs_time);
-    std::string timestring = boost::posix_time::to_iso_string(p_gps_time);
     //double utc_t = nav_msg.utc_time(nav_msg.sv_clock_correction(obs_time));
     //double gps_t = eph.sv_clock_correction(obs_time);
     double gps_t = obs_time;
-
-    std::string month (timestring, 4, 2);
-    std::string day (timestring, 6, 2);
-    std::string hour (timestring, 9, 2);
-    std::string minutes (timestring, 11, 2);
+    const std::string gps_system = satelliteSystem["GPS"];
+    std::map<int, Gnss_Synchro>::const_iterator pseudoranges_iter;
 
     if (version == 2)
         {
-            line.clear();
+            std::string line;
+            std::string timestring = boost::posix_time::to_iso_string(p_gps_time);
+            std::string month (timestring, 4, 2);
+            std::string day (timestring, 6, 2);
+            std::string hour (timestring, 9, 2);
+            std::string minutes (timestring, 11, 2);
             std::string year (timestring, 2, 2);
             line += std::string(1, ' ');
             line += year;
@@ -2718,7 +2660,6 @@ void Rinex_Printer::log_rinex_obs(std::fstream& out, const Gps_Ephemeris& eph, c
             line += std::string(1, '0');
             //Number of satellites observed in current epoch
             int numSatellitesObserved = 0;
-            std::map<int, Gnss_Synchro>::const_iterator pseudoranges_iter;
             for(pseudoranges_iter = pseudoranges.begin();
                     pseudoranges_iter != pseudoranges.end();
                     pseudoranges_iter++)
@@ -2730,7 +2671,7 @@ void Rinex_Printer::log_rinex_obs(std::fstream& out, const Gps_Ephemeris& eph, c
                     pseudoranges_iter != pseudoranges.end();
                     pseudoranges_iter++)
                 {
-                    line += satelliteSystem["GPS"];
+                    line += gps_system;
                     if (static_cast<int>(pseudoranges_iter->first) < 10) line += std::string(1, '0');
                     line += boost::lexical_cast<std::string>(static_cast<int>(pseudoranges_iter->first));
                 }
@@ -2738,410 +2679,80 @@ void Rinex_Printer::log_rinex_obs(std::fstream& out, const Gps_Ephemeris& eph, c
             //line += rightJustify(asString(clockOffset, 12), 15);
             line += std::string(80 - line.size(), ' ');
             Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
+            out << line << '\n';
 
 
             for(pseudoranges_iter = pseudoranges.begin();
                     pseudoranges_iter != pseudoranges.end();
                     pseudoranges_iter++)
                 {
-                    std::string lineObs;
-                    lineObs.clear();
-                    line.clear();
-                    // GPS L1 PSEUDORANGE
-                    line += std::string(2, ' ');
-                    lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Pseudorange_m, 3), 14);
-
-                    //Loss of lock indicator (LLI)
-                    int lli = 0; // Include in the observation!!
-                    if (lli == 0)
-                        {
-                            lineObs += std::string(1, ' ');
-                        }
-                    else
-                        {
-                            lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<short>(lli), 1);
-                        }
-
-                    // Signal Strength Indicator (SSI)
-                    int ssi = Rinex_Printer::signalStrength(pseudoranges_iter->second.CN0_dB_hz);
-                    lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<int>(ssi), 1);
-                    // GPS L1 CA PHASE
-                    lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Carrier_phase_rads/GPS_TWO_PI, 3), 14);
-                    if (lli == 0)
-                        {
-                            lineObs += std::string(1, ' ');
-                        }
-                    else
-                        {
-                            lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<short>(lli), 1);
-                        }
-                    lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<int>(ssi), 1);
-                    // GPS L1 CA DOPPLER
-                    lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Carrier_Doppler_hz, 3), 14);
-                    if (lli == 0)
-                        {
-                            lineObs += std::string(1, ' ');
-                        }
-                    else
-                        {
-                            lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<short>(lli), 1);
-                        }
-                    lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<int>(ssi), 1);
-                    //GPS L1 SIGNAL STRENGTH
-                    lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.CN0_dB_hz, 3), 14);
-                    if (lineObs.size() < 80) lineObs += std::string(80 - lineObs.size(), ' ');
-                    out << lineObs << std::endl;
+                    Rinex_Printer::log_rinex_obs_record(out, 0, pseudoranges_iter->first, pseudoranges_iter->second, GPS_TWO_PI);
                 }
         }
 
     if (version == 3)
         {
-            std::string year (timestring, 0, 4);
-            line += std::string(1, '>');
-            line += std::string(1, ' ');
-            line += year;
-            line += std::string(1, ' ');
-            line += month;
-            line += std::string(1, ' ');
-            line += day;
-            line += std::string(1, ' ');
-            line += hour;
-            line += std::string(1, ' ');
-            line += minutes;
-
-            line += std::string(1, ' ');
-            double seconds = fmod(gps_t, 60);
-            // Add extra 0 if seconds are < 10
-            if (seconds < 10)
-            {
-                line += std::string(1, '0');
-            }
-            line += Rinex_Printer::asString(seconds, 7);
-            line += std::string(2, ' ');
-            // Epoch flag 0: OK     1: power failure between previous and current epoch   <1: Special event
-            line += std::string(1, '0');
-
-            //Number of satellites observed in current epoch
-            int numSatellitesObserved = 0;
-            std::map<int, Gnss_Synchro>::const_iterator pseudoranges_iter;
+            Rinex_Printer::log_rinex_obs_epoch(out, p_gps_time, gps_t, pseudoranges.size());
             for(pseudoranges_iter = pseudoranges.begin();
                     pseudoranges_iter != pseudoranges.end();
                     pseudoranges_iter++)
                 {
-                    numSatellitesObserved++;
-                }
-            line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(numSatellitesObserved), 3);
-
-
-            // Receiver clock offset (optional)
-            //line += rightJustify(asString(clockOffset, 12), 15);
-
-            line += std::string(80 - line.size(), ' ');
-            Rinex_Printer::lengthCheck(line);
-            out << line << std::endl;
-
-            for(pseudoranges_iter = pseudoranges.begin();
-                    pseudoranges_iter != pseudoranges.end();
-                    pseudoranges_iter++)
-                {
-                    std::string lineObs;
-                    lineObs.clear();
-                    lineObs += satelliteSystem["GPS"];
-                    if (static_cast<int>(pseudoranges_iter->first) < 10) lineObs += std::string(1, '0');
-                    lineObs += boost::lexical_cast<std::string>(static_cast<int>(pseudoranges_iter->first));
-                    //lineObs += std::string(2, ' ');
-                    lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Pseudorange_m, 3), 14);
-
-                    //Loss of lock indicator (LLI)
-                    int lli = 0; // Include in the observation!!
-                    if (lli == 0)
-                        {
-                            lineObs += std::string(1, ' ');
-                        }
-                    else
-                        {
-                            lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<short>(lli), 1);
-                        }
-
-                    // Signal Strength Indicator (SSI)
-                    int ssi = Rinex_Printer::signalStrength(pseudoranges_iter->second.CN0_dB_hz);
-                    lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<int>(ssi), 1);
-
-                    // GPS L1 CA PHASE
-                    lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Carrier_phase_rads/GPS_TWO_PI, 3), 14);
-                    if (lli == 0)
-                        {
-                            lineObs += std::string(1, ' ');
-                        }
-                    else
-                        {
-                            lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<short>(lli), 1);
-                        }
-                    lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<int>(ssi), 1);
-
-                    // GPS L1 CA DOPPLER
-                    lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Carrier_Doppler_hz, 3), 14);
-                    if (lli == 0)
-                        {
-                            lineObs += std::string(1, ' ');
-                        }
-                    else
-                        {
-                            lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<short>(lli), 1);
-                        }
-
-                    lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<int>(ssi), 1);
-
-                    //GPS L1 SIGNAL STRENGTH
-                    lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.CN0_dB_hz, 3), 14);
-
-                    if (lineObs.size() < 80) lineObs += std::string(80 - lineObs.size(), ' ');
-                    out << lineObs << std::endl;
+                    Rinex_Printer::log_rinex_obs_record(out, gps_system.c_str(), pseudoranges_iter->first, pseudoranges_iter->second, GPS_TWO_PI);
                 }
         }
+    out.flush();
 }
 
 
 void Rinex_Printer::log_rinex_obs(std::fstream& out, const Galileo_Ephemeris& eph, double obs_time, const std::map<int,Gnss_Synchro>& pseudoranges)
 {
+    GNSS_SDR_TRACE_SCOPE("Rinex_Printer::log_rinex_obs");
     // RINEX observations timestamps are Galileo timestamps.
     // See http://gage14.upc.es/gLAB/HTML/Observation_Rinex_v3.01.html
 
-    std::string line;
-
     boost::posix_time::ptime p_galileo_time = Rinex_Printer::compute_Galileo_time(eph, obs_time);
-    std::string timestring = boost::posix_time::to_iso_string(p_galileo_time);
     //double utc_t = nav_msg.utc_time(nav_msg.sv_clock_correction(obs_time));
     //double gps_t = eph.sv_clock_correction(obs_time);
     double galileo_t = obs_time;
+    const std::string galileo_system = satelliteSystem["Galileo"];
 
-    std::string month (timestring, 4, 2);
-    std::string day (timestring, 6, 2);
-    std::string hour (timestring, 9, 2);
-    std::string minutes (timestring, 11, 2);
+    Rinex_Printer::log_rinex_obs_epoch(out, p_galileo_time, galileo_t, pseudoranges.size());
 
-    std::string year (timestring, 0, 4);
-    line += std::string(1, '>');
-    line += std::string(1, ' ');
-    line += year;
-    line += std::string(1, ' ');
-    line += month;
-    line += std::string(1, ' ');
-    line += day;
-    line += std::string(1, ' ');
-    line += hour;
-    line += std::string(1, ' ');
-    line += minutes;
-
-    line += std::string(1, ' ');
-    double seconds = fmod(galileo_t, 60);
-    // Add extra 0 if seconds are < 10
-    if (seconds < 10)
-        {
-            line +=std::string(1, '0');
-        }
-    line += Rinex_Printer::asString(seconds, 7);
-    line += std::string(2, ' ');
-    // Epoch flag 0: OK     1: power failure between previous and current epoch   <1: Special event
-    line += std::string(1, '0');
-
-    //Number of satellites observed in current epoch
-    int numSatellitesObserved = 0;
     std::map<int, Gnss_Synchro>::const_iterator pseudoranges_iter;
     for(pseudoranges_iter = pseudoranges.begin();
             pseudoranges_iter != pseudoranges.end();
             pseudoranges_iter++)
         {
-            numSatellitesObserved++;
-        }
-    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(numSatellitesObserved), 3);
-
-    // Receiver clock offset (optional)
-    //line += rightJustify(asString(clockOffset, 12), 15);
-
-    line += std::string(80 - line.size(), ' ');
-    Rinex_Printer::lengthCheck(line);
-    out << line << std::endl;
-
-    for(pseudoranges_iter = pseudoranges.begin();
-            pseudoranges_iter != pseudoranges.end();
-            pseudoranges_iter++)
-        {
-            std::string lineObs;
-            lineObs.clear();
-            lineObs += satelliteSystem["Galileo"];
-            if (static_cast<int>(pseudoranges_iter->first) < 10) lineObs += std::string(1, '0');
-            lineObs += boost::lexical_cast<std::string>(static_cast<int>(pseudoranges_iter->first));
-            //lineObs += std::string(2, ' ');
-            lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Pseudorange_m, 3), 14);
-
-            //Loss of lock indicator (LLI)
-            int lli = 0; // Include in the observation!!
-            if (lli == 0)
-                {
-                    lineObs += std::string(1, ' ');
-                }
-            else
-                {
-                    lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<short>(lli), 1);
-                }
-
-            // Signal Strength Indicator (SSI)
-            int ssi = Rinex_Printer::signalStrength(pseudoranges_iter->second.CN0_dB_hz);
-            lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<int>(ssi), 1);
-
-            // Galileo E1B PHASE
-            lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Carrier_phase_rads / (GALILEO_TWO_PI), 3), 14);
-            if (lli == 0)
-                {
-                    lineObs += std::string(1, ' ');
-                }
-            else
-                {
-                    lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<short>(lli), 1);
-                }
-            lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<int>(ssi), 1);
-
-            // Galileo E1B DOPPLER
-            lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Carrier_Doppler_hz, 3), 14);
-            if (lli == 0)
-                {
-                    lineObs += std::string(1, ' ');
-                }
-            else
-                {
-                    lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<short>(lli), 1);
-                }
-            lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<int>(ssi), 1);
-
-            // Galileo E1B SIGNAL STRENGTH
-            lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.CN0_dB_hz, 3), 14);
-            if (lineObs.size() < 80) lineObs += std::string(80 - lineObs.size(), ' ');
-            out << lineObs << std::endl;
+            Rinex_Printer::log_rinex_obs_record(out, galileo_system.c_str(), pseudoranges_iter->first, pseudoranges_iter->second, GALILEO_TWO_PI);
         }
+    out.flush();
 }
 
 
 void Rinex_Printer::log_rinex_obs(std::fstream& out, const Gps_Ephemeris& gps_eph, const Galileo_Ephemeris& galileo_eph,  double gps_obs_time, const std::map<int,Gnss_Synchro>& pseudoranges)
 {
+    GNSS_SDR_TRACE_SCOPE("Rinex_Printer::log_rinex_obs");
     if(galileo_eph.e_1){} // avoid warning, not needed
-    std::string line;
-
     boost::posix_time::ptime p_gps_time = Rinex_Printer::compute_GPS_time(gps_eph, gps_obs_time);
-    std::string timestring = boost::posix_time::to_iso_string(p_gps_time);
     //double utc_t = nav_msg.utc_time(nav_msg.sv_clock_correction(obs_time));
     //double gps_t = eph.sv_clock_correction(obs_time);
     double gps_t = gps_obs_time;
+    const std::string gps_system = satelliteSystem["GPS"];
+    const std::string galileo_system = satelliteSystem["Galileo"];
 
-    std::string month (timestring, 4, 2);
-    std::string day (timestring, 6, 2);
-    std::string hour (timestring, 9, 2);
-    std::string minutes (timestring, 11, 2);
-
-    std::string year (timestring, 0, 4);
-    line += std::string(1, '>');
-    line += std::string(1, ' ');
-    line += year;
-    line += std::string(1, ' ');
-    line += month;
-    line += std::string(1, ' ');
-    line += day;
-    line += std::string(1, ' ');
-    line += hour;
-    line += std::string(1, ' ');
-    line += minutes;
-
-    line += std::string(1, ' ');
-    double seconds = fmod(gps_t, 60);
-    // Add extra 0 if seconds are < 10
-    if (seconds < 10)
-        {
-            line +=std::string(1, '0');
-        }
-    line += Rinex_Printer::asString(seconds, 7);
-    line += std::string(2, ' ');
-    // Epoch flag 0: OK     1: power failure between previous and current epoch   <1: Special event
-    line += std::string(1, '0');
+    Rinex_Printer::log_rinex_obs_epoch(out, p_gps_time, gps_t, pseudoranges.size());
 
-    //Number of satellites observed in current epoch
-    int numSatellitesObserved = 0;
     std::map<int,Gnss_Synchro>::const_iterator pseudoranges_iter;
     for(pseudoranges_iter = pseudoranges.begin();
             pseudoranges_iter != pseudoranges.end();
             pseudoranges_iter++)
         {
-            numSatellitesObserved++;
-        }
-    line += Rinex_Printer::rightJustify(boost::lexical_cast<std::string>(numSatellitesObserved), 3);
-
-    // Receiver clock offset (optional)
-    //line += rightJustify(asString(clockOffset, 12), 15);
-
-    line += std::string(80 - line.size(), ' ');
-    Rinex_Printer::lengthCheck(line);
-    out << line << std::endl;
-
-    std::string s;
-    for(pseudoranges_iter = pseudoranges.begin();
-            pseudoranges_iter != pseudoranges.end();
-            pseudoranges_iter++)
-        {
-            std::string lineObs;
-            lineObs.clear();
-
-            s.assign(1, pseudoranges_iter->second.System);
-            if(s.compare("G") == 0) lineObs += satelliteSystem["GPS"];
-            if(s.compare("E") == 0) lineObs += satelliteSystem["Galileo"];
-            if (static_cast<int>(pseudoranges_iter->first) < 10) lineObs += std::string(1, '0');
-            lineObs += boost::lexical_cast<std::string>(static_cast<int>(pseudoranges_iter->first));
-            lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Pseudorange_m, 3), 14);
-
-            //Loss of lock indicator (LLI)
-            int lli = 0; // Include in the observation!!
-            if (lli == 0)
-                {
-                    lineObs += std::string(1, ' ');
-                }
-            else
-                {
-                    lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<short>(lli), 1);
-                }
-
-            // Signal Strength Indicator (SSI)
-            int ssi = Rinex_Printer::signalStrength(pseudoranges_iter->second.CN0_dB_hz);
-            lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<int>(ssi), 1);
-
-            // PHASE
-            lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Carrier_phase_rads/GPS_TWO_PI, 3), 14);
-            if (lli == 0)
-                {
-                    lineObs += std::string(1, ' ');
-                }
-            else
-                {
-                    lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<short>(lli), 1);
-                }
-            lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<int>(ssi), 1);
-
-            // DOPPLER
-            lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.Carrier_Doppler_hz, 3), 14);
-            if (lli == 0)
-                {
-                    lineObs += std::string(1, ' ');
-                }
-            else
-                {
-                    lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<short>(lli), 1);
-                }
-            lineObs += Rinex_Printer::rightJustify(Rinex_Printer::asString<int>(ssi), 1);
-
-            // SIGNAL STRENGTH
-            lineObs += Rinex_Printer::rightJustify(asString(pseudoranges_iter->second.CN0_dB_hz, 3), 14);
-
-            if (lineObs.size() < 80) lineObs += std::string(80 - lineObs.size(), ' ');
-            out << lineObs << std::endl;
+            const char* sat_system = "";
+            if (pseudoranges_iter->second.System == 'G') sat_system = gps_system.c_str();
+            if (pseudoranges_iter->second.System == 'E') sat_system = galileo_system.c_str();
+            Rinex_Printer::log_rinex_obs_record(out, sat_system, pseudoranges_iter->first, pseudoranges_iter->second, GPS_TWO_PI);
         }
+    out.flush();
 }
 
 
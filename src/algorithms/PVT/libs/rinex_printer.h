@@ -57,6 +57,11 @@
 #include <sstream>  // for stringstream
 #include <iomanip>  // for setprecision
 #include <map>
+#include <vector>
+#include <cmath>    // for fabs, floor, signbit
+#include <cstdio>   // for snprintf
+#include <cstdlib>  // for strtol
+#include <cstring>  // for memchr, memcpy
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include "gps_navigation_message.h"
 #include "gps_utc_model.h"
@@ -192,6 +197,14 @@ public:
 
     void update_obs_header(std::fstream & out, const Galileo_Utc_Model & galileo_utc_model);
 
+    /*!
+     *  \brief Closes the observation and navigation files and opens new ones,
+     *  named after the current time. The headers must be written again.
+     *  Returns the names of the closed files; the empty ones are removed.
+     *  The SBAS file, written by the PVT block thread, is not rotated.
+     */
+    std::vector<std::string> rotate_files();
+
     std::map<std::string,std::string> satelliteSystem; //<! GPS, GLONASS, SBAS payload, Galileo or Compass
     std::map<std::string,std::string> observationType; //<! PSEUDORANGE, CARRIER_PHASE, DOPPLER, SIGNAL_STRENGTH
     std::map<std::string,std::string> observationCode; //<! GNSS observation descriptors
@@ -229,6 +242,12 @@ private:
     std::string navGalfilename;
     std::string navMixfilename;
 
+    /*
+     * Closes out, keeping its name in closed unless empty, and opens a new
+     * file of the given type
+     */
+    void rotate_file(std::fstream & out, std::string & filename, const std::string & type, std::vector<std::string> & closed);
+
     /*
      * Generates the data for the PGM / RUN BY / DATE line
      */
@@ -239,6 +258,48 @@ private:
      */
     void lengthCheck(const std::string & line);
 
+    /*
+     * Header line to be overwritten: the first line starting with prefix and
+     * labeled label (from column 61) is replaced by text, of the same length
+     */
+    struct Header_Line
+    {
+        std::string prefix;
+        std::string label;
+        std::string text;
+        Header_Line() {}
+        Header_Line(const std::string & p, const std::string & l, const std::string & t) : prefix(p), label(l), text(t) {}
+    };
+
+    /*
+     * Overwrites header lines of a file in place. Only the header is read back,
+     * so the cost does not grow with the number of records already logged.
+     */
+    void overwrite_header_lines(std::fstream & out, const std::string & filename, const std::vector<Header_Line> & lines);
+
+    /*
+     * Blank COMMENT line written after TIME OF FIRST OBS, so that the LEAP
+     * SECONDS line can be set once the UTC model is known
+     */
+    std::string obs_header_placeholder();
+
+    /*
+     * Writes the LEAP SECONDS line of the observation file header
+     */
+    void update_obs_leap_seconds(std::fstream & out, const std::string & leap_seconds_line);
+
+    /*
+     * Writes the epoch record of a RINEX 3 observation file
+     */
+    void log_rinex_obs_epoch(std::fstream & out, const boost::posix_time::ptime & p_time, double obs_time, int num_satellites);
+
+    /*
+     * Writes the pseudorange, carrier phase, Doppler and C/N0 observations of
+     * a satellite. The system identifier (which may be empty) and the two-digit
+     * satellite number start the line, except for RINEX 2 (null sat_system).
+     */
+    void log_rinex_obs_record(std::fstream & out, const char * sat_system, int sat_number, const Gnss_Synchro & gnss_synchro, double two_pi);
+
     /*
      * If the string is bigger than length, truncate it from the right.
      * otherwise, add pad characters to its right.
@@ -252,7 +313,7 @@ private:
      * \param[in] length new desired length of string.
      * \param[in] pad character to pad string with (blank by default).
      * \return a reference to \a s.  */
-    inline std::string & leftJustify(std::string & s,
+    static inline std::string & leftJustify(std::string & s,
             const std::string::size_type length,
             const char pad = ' ');
 
@@ -269,7 +330,7 @@ private:
      * \param[in] length new desired length of string.
      * \param[in] pad character to pad string with (blank by default).
      * \return a reference to \a s.  */
-    inline std::string leftJustify(const std::string & s,
+    static inline std::string leftJustify(const std::string & s,
             const std::string::size_type length,
             const char pad = ' ')
     {
@@ -283,7 +344,7 @@ private:
      * requested length (\a length), it is padded on the left with
      * the pad character (\a pad). The default pad
      * character is a blank. */
-    inline std::string & rightJustify(std::string & s,
+    static inline std::string & rightJustify(std::string & s,
             const std::string::size_type length,
             const char pad = ' ');
 
@@ -293,7 +354,7 @@ private:
      * requested length (\a length), it is padded on the left with
      * the pad character (\a pad). The default pad
      * character is a blank.*/
-    inline std::string rightJustify(const std::string & s,
+    static inline std::string rightJustify(const std::string & s,
             const std::string::size_type length,
             const char pad = ' ')
     {
@@ -311,7 +372,7 @@ private:
      * exponentials above three characters in length.  If false, it removes
      * that check.
      */
-    inline std::string doub2sci(const double & d,
+    static inline std::string doub2sci(const double & d,
             const std::string::size_type length,
             const std::string::size_type expLen,
             const bool showSign = true,
@@ -332,7 +393,7 @@ private:
      * produce an exponential with an E instead of a D, and always have a leading
      * zero.  For example -> 0.87654E-0004 or -0.1234E00005.
      */
-    inline std::string & sci2for(std::string & aStr,
+    static inline std::string & sci2for(std::string & aStr,
             const std::string::size_type startPos = 0,
             const std::string::size_type length = std::string::npos,
             const std::string::size_type expLen = 3,
@@ -351,18 +412,61 @@ private:
      * that check.
      * @return a string containing \a d in FORTRAN notation.
      */
-    inline std::string doub2for(const double & d,
+    static inline std::string doub2for(const double & d,
             const std::string::size_type length,
             const std::string::size_type expLen,
             const bool checkSwitch = true);
 
 
+    friend class Rinex_Printer_Formatting_Test;  // unit tests of the formatting helpers below
+
+    /*
+     * Fixed-width formatting into character buffers, for the observation
+     * and navigation records written at every epoch. The std::string
+     * helpers build several temporaries and a std::stringstream for each
+     * field, these functions give the same characters without allocating.
+     */
+
+    /*
+     * Writes x in fixed notation with the given number of decimal places,
+     * as asString(x, decimals), into buf (at least 24 characters).
+     * @return number of characters written, or -1 for values that are not
+     * handled (non-finite, too large, or too close to a rounding tie).
+     */
+    static inline int fixedChars(char * buf, double x, int decimals);
+
+    /*
+     * Writes the n characters of s right-justified in a field of width
+     * characters, truncated from the left as rightJustify() does.
+     * @return end of the field.
+     */
+    static inline char * putRight(char * p, const char * s, int n, int width, const char pad = ' ');
+
+    /*
+     * rightJustify(asString(x, decimals), width) into p.
+     * @return end of the field.
+     */
+    static inline char * putFixed(char * p, double x, int width, int decimals);
+
+    /*
+     * rightJustify(asString(x), width, pad) into p for an integer.
+     * @return end of the field.
+     */
+    static inline char * putInt(char * p, long x, int width, const char pad = ' ');
+
+    /*
+     * doub2for(d, length, expLen) into p (at most length + 8 characters).
+     * @return end of the field.
+     */
+    static inline char * putFor(char * p, double d, int length, int expLen);
+
+
     /*
      * Convert a string to a double precision floating point number.
      * @param s string containing a number.
      * @return double representation of string.
      */
-    inline double asDouble(const std::string & s)
+    static inline double asDouble(const std::string & s)
     {
         return strtod(s.c_str(), 0);
     }
@@ -375,7 +479,7 @@ private:
      * @param s string containing a number.
      * @return long integer representation of string.
      */
-    inline long asInt(const std::string & s)
+    static inline long asInt(const std::string & s)
     {
         return strtol(s.c_str(), 0, 10);
     }
@@ -387,7 +491,7 @@ private:
      * @param precision the number of decimal places you want displayed.
      * @return string representation of \a x.
      */
-    inline std::string asString(const double x,
+    static inline std::string asString(const double x,
             const std::string::size_type precision = 17);
 
 
@@ -397,7 +501,7 @@ private:
      * @param precision the number of decimal places you want displayed.
      * @return string representation of \a x.
      */
-    inline std::string asString(const long double x,
+    static inline std::string asString(const long double x,
             const std::string::size_type precision = 21);
 
 
@@ -407,7 +511,7 @@ private:
      * @param x object to turn into a string.
      * @return string representation of \a x.
      */
-    template <class X> inline std::string asString(const X x);
+    template <class X> static inline std::string asString(const X x);
 
     inline std::string asFixWidthString(const int x, const int width, char fill_digit);
 };
@@ -462,6 +566,12 @@ inline std::string Rinex_Printer::doub2for(const double & d,
     if (exponentLength < 0) exponentLength = 1;
     if (exponentLength > 3 && checkSwitch) exponentLength = 3;
 
+    if (checkSwitch && length < 40)
+        {
+            char buf[48];
+            return std::string(buf, putFor(buf, d, length, exponentLength) - buf);
+        }
+
     std::string toReturn = doub2sci(d, length, exponentLength, true, checkSwitch);
     sci2for(toReturn, 0, length, exponentLength, checkSwitch);
 
@@ -589,6 +699,164 @@ inline std::string & Rinex_Printer::sci2for(std::string & aStr,
 
 
 
+inline int Rinex_Printer::fixedChars(char * buf, double x, int decimals)
+{
+    static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+    if (decimals < 0 || decimals > 9)
+        {
+            return -1;
+        }
+    const double scaled = std::fabs(x) * pow10[decimals];
+    // up to 2^53 the integer part is exact; also false for NaN
+    if (!(scaled < 9007199254740992.0))
+        {
+            return -1;
+        }
+    const double integral = std::floor(scaled);
+    const double fraction = scaled - integral;
+    // the product may be rounded, leave the ties to the library
+    if (std::fabs(fraction - 0.5) < scaled * 4.5e-16 + 1e-12)
+        {
+            return -1;
+        }
+    unsigned long long v = static_cast<unsigned long long>(integral) + (fraction > 0.5 ? 1 : 0);
+
+    char digits[24];
+    int n = 0;
+    do
+        {
+            digits[n++] = static_cast<char>('0' + v % 10);
+            v /= 10;
+        }
+    while (v > 0 || n <= decimals);
+
+    int length = 0;
+    if (std::signbit(x))
+        {
+            buf[length++] = '-';
+        }
+    while (n > decimals)
+        {
+            buf[length++] = digits[--n];
+        }
+    if (decimals > 0)
+        {
+            buf[length++] = '.';
+            while (n > 0)
+                {
+                    buf[length++] = digits[--n];
+                }
+        }
+    return length;
+}
+
+
+inline char * Rinex_Printer::putRight(char * p, const char * s, int n, int width, const char pad)
+{
+    if (n > width)
+        {
+            s += n - width;
+            n = width;
+        }
+    for (int i = n; i < width; i++)
+        {
+            *p++ = pad;
+        }
+    for (int i = 0; i < n; i++)
+        {
+            *p++ = s[i];
+        }
+    return p;
+}
+
+
+inline char * Rinex_Printer::putFixed(char * p, double x, int width, int decimals)
+{
+    char buf[24];
+    const int n = fixedChars(buf, x, decimals);
+    if (n < 0)
+        {
+            std::string s = rightJustify(asString(x, decimals), width);
+            return putRight(p, s.data(), s.size(), width);
+        }
+    return putRight(p, buf, n, width);
+}
+
+
+inline char * Rinex_Printer::putInt(char * p, long x, int width, const char pad)
+{
+    char digits[24];
+    int n = 0;
+    unsigned long v = (x < 0) ? 0UL - static_cast<unsigned long>(x) : static_cast<unsigned long>(x);
+    do
+        {
+            digits[n++] = static_cast<char>('0' + v % 10);
+            v /= 10;
+        }
+    while (v > 0);
+    if (x < 0)
+        {
+            digits[n++] = '-';
+        }
+    char buf[24];
+    for (int i = 0; i < n; i++)
+        {
+            buf[i] = digits[n - 1 - i];
+        }
+    return putRight(p, buf, n, width, pad);
+}
+
+
+inline char * Rinex_Printer::putFor(char * p, double d, int length, int expLen)
+{
+    // d.ddde+XX from the C library, then rearranged to .dddd, with the
+    // exponent plus one and a 'D', as doub2sci() and sci2for() do
+    const int precision = length - 3 - expLen - 1 - 1;
+    char buf[64];
+    const int n = (precision > 0 && precision < 40) ? snprintf(buf, sizeof(buf), "%.*e", precision, d) : -1;
+    const char * e = (n > 0) ? static_cast<const char *>(memchr(buf, 'e', n)) : 0;
+    if (e == 0 || !std::isfinite(d))
+        {
+            std::string s = doub2sci(d, length, expLen, true, true);
+            sci2for(s, 0, length, expLen, true);
+            memcpy(p, s.data(), s.size());
+            return p + s.size();
+        }
+    const bool negative = (buf[0] == '-');
+    const char * mantissa = buf + (negative ? 1 : 0);
+    if (negative)
+        {
+            *p++ = '-';
+        }
+    else
+        {
+            *p++ = ' ';
+        }
+    *p++ = '.';
+    *p++ = mantissa[0];
+    for (const char * c = mantissa + 2; c < e; c++)
+        {
+            *p++ = *c;
+        }
+    long exponent = strtol(e + 1, 0, 10);
+    if (d != 0.0)
+        {
+            exponent++;
+        }
+    *p++ = 'D';
+    if (exponent < 0)
+        {
+            *p++ = '-';
+            exponent = -exponent;
+        }
+    else
+        {
+            *p++ = '+';
+        }
+    return putInt(p, exponent, expLen, '0');
+}
+
+
 inline std::string asString(const long double x, const std::string::size_type precision)
 {
     std::ostringstream ss;
@@ -599,6 +867,12 @@ inline std::string asString(const long double x, const std::string::size_type pr
 
 inline std::string Rinex_Printer::asString(const double x, const std::string::size_type precision)
 {
+    char buf[24];
+    const int n = fixedChars(buf, x, static_cast<int>(precision));
+    if (n >= 0)
+        {
+            return std::string(buf, n);
+        }
     std::ostringstream ss;
     ss << std::fixed << std::setprecision(precision) << x;
     return ss.str();
@@ -0,0 +1,171 @@
+/*!
+ * \file rinex_stitcher.cc
+ * \brief Merges the RINEX files written by consecutive receiver runs.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "rinex_stitcher.h"
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+
+bool Rinex_Stitcher::read_rinex_3(const std::string & filename, std::vector<std::string> & lines, unsigned int & body)
+{
+    std::ifstream in(filename.c_str());
+    if (!in.is_open())
+        {
+            LOG(WARNING) << "Cannot open the RINEX file " << filename;
+            return false;
+        }
+    lines.clear();
+    std::string line;
+    while (std::getline(in, line))
+        {
+            lines.push_back(line);
+        }
+    if (lines.empty() || lines[0].find("RINEX VERSION / TYPE") == std::string::npos
+            || std::atof(lines[0].substr(0, 9).c_str()) < 3.0)
+        {
+            LOG(WARNING) << filename << " is not a RINEX 3 file";
+            return false;
+        }
+    for (body = 0; body < lines.size(); body++)
+        {
+            if (lines[body].find("END OF HEADER") != std::string::npos)
+                {
+                    body++;
+                    return true;
+                }
+        }
+    LOG(WARNING) << "The header of " << filename << " is not complete";
+    return false;
+}
+
+
+bool Rinex_Stitcher::stitch_observations(const std::vector<std::string> & inputs, const std::string & output)
+{
+    if (inputs.empty())
+        {
+            return false;
+        }
+    std::ofstream out(output.c_str(), std::ios::out | std::ios::trunc);
+    if (!out.is_open())
+        {
+            LOG(WARNING) << "Cannot create the RINEX file " << output;
+            return false;
+        }
+    // "> yyyy mm dd hh mm ss.sssssss": fixed width and zero padded, so the
+    // epochs are in the same order as their strings
+    std::string last_epoch;
+    for (unsigned int i = 0; i < inputs.size(); i++)
+        {
+            std::vector<std::string> lines;
+            unsigned int body;
+            if (!read_rinex_3(inputs[i], lines, body))
+                {
+                    return false;
+                }
+            if (i == 0)
+                {
+                    for (unsigned int l = 0; l < body; l++)
+                        {
+                            out << lines[l] << '\n';
+                        }
+                }
+            bool keep = false;
+            for (unsigned int l = body; l < lines.size(); l++)
+                {
+                    if (!lines[l].empty() && lines[l][0] == '>')
+                        {
+                            const std::string epoch = lines[l].size() > 2 ? lines[l].substr(2, 27) : std::string();
+                            keep = epoch > last_epoch;
+                            if (keep)
+                                {
+                                    last_epoch = epoch;
+                                }
+                        }
+                    if (keep)
+                        {
+                            out << lines[l] << '\n';
+                        }
+                }
+        }
+    out.close();
+    return !out.fail();
+}
+
+
+bool Rinex_Stitcher::stitch_navigation(const std::vector<std::string> & inputs, const std::string & output)
+{
+    if (inputs.empty())
+        {
+            return false;
+        }
+    std::ofstream out(output.c_str(), std::ios::out | std::ios::trunc);
+    if (!out.is_open())
+        {
+            LOG(WARNING) << "Cannot create the RINEX file " << output;
+            return false;
+        }
+    std::set<std::string> written;
+    for (unsigned int i = 0; i < inputs.size(); i++)
+        {
+            std::vector<std::string> lines;
+            unsigned int body;
+            if (!read_rinex_3(inputs[i], lines, body))
+                {
+                    return false;
+                }
+            if (i == 0)
+                {
+                    for (unsigned int l = 0; l < body; l++)
+                        {
+                            out << lines[l] << '\n';
+                        }
+                }
+            // a record starts with the satellite ("G01", "E11"...), its other lines with spaces
+            unsigned int l = body;
+            while (l < lines.size())
+                {
+                    std::string record = lines[l] + '\n';
+                    for (l++; l < lines.size() && (lines[l].empty() || lines[l][0] == ' '); l++)
+                        {
+                            record += lines[l] + '\n';
+                        }
+                    if (written.insert(record).second)
+                        {
+                            out << record;
+                        }
+                }
+        }
+    out.close();
+    return !out.fail();
+}
@@ -0,0 +1,68 @@
+/*!
+ * \file rinex_stitcher.h
+ * \brief Merges the RINEX files written by consecutive receiver runs.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * In batch post-processing mode (see batch_processor.h), a capture is split
+ * into overlapping time segments that are processed by independent
+ * receivers, each one writing its own RINEX files. These functions join
+ * them into a single observation file and a single navigation file per
+ * type. Only RINEX 3 files are supported.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_RINEX_STITCHER_H_
+#define GNSS_SDR_RINEX_STITCHER_H_
+
+#include <string>
+#include <vector>
+
+class Rinex_Stitcher
+{
+public:
+    /*!
+     * \brief Writes the header of the first input file, then the epochs of
+     * all the inputs, in order, skipping those that are not later than the
+     * last epoch written: the start of each segment, which overlaps with
+     * the previous one, is taken from the previous segment. Returns false
+     * if an input cannot be read, is not a RINEX 3 file, or the output
+     * cannot be written.
+     */
+    static bool stitch_observations(const std::vector<std::string> & inputs, const std::string & output);
+
+    /*!
+     * \brief Writes the header of the first input file, then the records
+     * of all the inputs, in order, without repeating the records (the
+     * ephemeris of a satellite) that have already been written.
+     */
+    static bool stitch_navigation(const std::vector<std::string> & inputs, const std::string & output);
+
+private:
+    // Reads the whole file into lines, and the index of the first line after the header
+    static bool read_rinex_3(const std::string & filename, std::vector<std::string> & lines, unsigned int & body);
+};
+
+#endif
@@ -32,6 +32,7 @@
  */
 
 #include "rtcm_printer.h"
+#include "gnss_sdr_trace.h"
 #include <ctime>
 #include <iostream>
 #include <iomanip>
@@ -43,7 +44,7 @@
 using google::LogMessage;
 
 
-Rtcm_Printer::Rtcm_Printer(std::string filename, bool flag_rtcm_server, bool flag_rtcm_tty_port, unsigned short rtcm_tcp_port, unsigned short rtcm_station_id, std::string rtcm_dump_devname, bool time_tag_name)
+Rtcm_Printer::Rtcm_Printer(std::string filename, bool flag_rtcm_server, bool flag_rtcm_tty_port, unsigned short rtcm_tcp_port, unsigned short rtcm_station_id, std::string rtcm_dump_devname, bool time_tag_name, unsigned int rtcm_caster_threads, unsigned int rtcm_caster_queue_depth)
 {
     time_t rawtime;
     struct tm * timeinfo;
@@ -120,7 +121,14 @@ Rtcm_Printer::Rtcm_Printer(std::string filename, bool flag_rtcm_server, bool fla
 
     if(flag_rtcm_server)
         {
-            rtcm->run_server();
+            if (rtcm_caster_threads > 0)
+                {
+                    rtcm->run_caster(rtcm_caster_threads, rtcm_caster_queue_depth);
+                }
+            else
+                {
+                    rtcm->run_server();
+                }
         }
 }
 
@@ -147,6 +155,7 @@ Rtcm_Printer::~Rtcm_Printer()
 
 bool Rtcm_Printer::Print_Rtcm_MT1001(const Gps_Ephemeris& gps_eph, double obs_time, const std::map<int, Gnss_Synchro> & pseudoranges)
 {
+    GNSS_SDR_TRACE_SCOPE("Rtcm_Printer::Print_Rtcm_MT1001");
     std::string m1001 = rtcm->print_MT1001(gps_eph, obs_time, pseudoranges, station_id);
     Rtcm_Printer::Print_Message(m1001);
     return true;
@@ -155,6 +164,7 @@ bool Rtcm_Printer::Print_Rtcm_MT1001(const Gps_Ephemeris& gps_eph, double obs_ti
 
 bool Rtcm_Printer::Print_Rtcm_MT1002(const Gps_Ephemeris& gps_eph, double obs_time, const std::map<int, Gnss_Synchro> & pseudoranges)
 {
+    GNSS_SDR_TRACE_SCOPE("Rtcm_Printer::Print_Rtcm_MT1002");
     std::string m1002 = rtcm->print_MT1002(gps_eph, obs_time, pseudoranges, station_id);
     Rtcm_Printer::Print_Message(m1002);
     return true;
@@ -163,16 +173,51 @@ bool Rtcm_Printer::Print_Rtcm_MT1002(const Gps_Ephemeris& gps_eph, double obs_ti
 
 bool Rtcm_Printer::Print_Rtcm_MT1019(const Gps_Ephemeris & gps_eph)
 {
-    std::string m1019 = rtcm->print_MT1019(gps_eph);
-    Rtcm_Printer::Print_Message(m1019);
+    GNSS_SDR_TRACE_SCOPE("Rtcm_Printer::Print_Rtcm_MT1019");
+    Ephemeris_Message & cached = gps_ephemeris_messages[gps_eph.i_satellite_PRN];
+    if (Print_Ephemeris_Message(cached, gps_eph.i_GPS_week, static_cast<unsigned int>(gps_eph.d_IODE_SF2),
+            static_cast<unsigned int>(gps_eph.d_IODC), gps_eph.d_Toe))
+        {
+            return true;
+        }
+    cached.message = rtcm->print_MT1019(gps_eph);
+    Rtcm_Printer::Print_Message(cached.message);
     return true;
 }
 
 
 bool Rtcm_Printer::Print_Rtcm_MT1045(const Galileo_Ephemeris & gal_eph)
 {
-    std::string m1045 = rtcm->print_MT1045(gal_eph);
-    Rtcm_Printer::Print_Message(m1045);
+    GNSS_SDR_TRACE_SCOPE("Rtcm_Printer::Print_Rtcm_MT1045");
+    Ephemeris_Message & cached = galileo_ephemeris_messages[gal_eph.i_satellite_PRN];
+    if (Print_Ephemeris_Message(cached, static_cast<unsigned int>(gal_eph.WN_5), gal_eph.IOD_nav_1, 0, gal_eph.t0e_1))
+        {
+            return true;
+        }
+    cached.message = rtcm->print_MT1045(gal_eph);
+    Rtcm_Printer::Print_Message(cached.message);
+    return true;
+}
+
+
+bool Rtcm_Printer::Print_Ephemeris_Message(Ephemeris_Message & cached, unsigned int week, unsigned int iod, unsigned int iodc, double toe)
+{
+    // A new issue of data, or the same one uploaded for another week or
+    // reference time, is encoded again by the caller
+    if (cached.message.empty() || cached.week != week || cached.iod != iod || cached.iodc != iodc || cached.toe != toe)
+        {
+            cached.week = week;
+            cached.iod = iod;
+            cached.iodc = iodc;
+            cached.toe = toe;
+            return false;
+        }
+    // as Rtcm does for the messages it encodes
+    if (rtcm->is_server_running())
+        {
+            rtcm->send_message(cached.message);
+        }
+    Rtcm_Printer::Print_Message(cached.message);
     return true;
 }
 
@@ -188,6 +233,7 @@ bool Rtcm_Printer::Print_Rtcm_MSM(unsigned int msm_number, const Gps_Ephemeris &
         bool divergence_free,
         bool more_messages)
 {
+    GNSS_SDR_TRACE_SCOPE("Rtcm_Printer::Print_Rtcm_MSM");
     std::string msm;
     if(msm_number == 1)
         {
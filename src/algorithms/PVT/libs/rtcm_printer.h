@@ -36,6 +36,7 @@
 
 #include <fstream>  // std::ofstream
 #include <iostream> // std::cout
+#include <map>
 #include <memory>   // std::shared_ptr
 #include "rtcm.h"
 
@@ -48,7 +49,7 @@ public:
     /*!
      * \brief Default constructor.
      */
-    Rtcm_Printer(std::string filename, bool flag_rtcm_server, bool flag_rtcm_tty_port, unsigned short rtcm_tcp_port, unsigned short rtcm_station_id, std::string rtcm_dump_filename, bool time_tag_name = true);
+    Rtcm_Printer(std::string filename, bool flag_rtcm_server, bool flag_rtcm_tty_port, unsigned short rtcm_tcp_port, unsigned short rtcm_station_id, std::string rtcm_dump_filename, bool time_tag_name = true, unsigned int rtcm_caster_threads = 0, unsigned int rtcm_caster_queue_depth = 64);
 
     /*!
      * \brief Default destructor.
@@ -87,6 +88,20 @@ private:
     void close_serial ();
     std::shared_ptr<Rtcm> rtcm;
     bool Print_Message(const std::string & message);
+
+    // Encoded ephemeris messages of each satellite, only rebuilt when the
+    // ephemeris they were built from is replaced
+    struct Ephemeris_Message
+    {
+        unsigned int week;
+        unsigned int iod;
+        unsigned int iodc;
+        double toe;
+        std::string message;
+    };
+    std::map<unsigned int, Ephemeris_Message> gps_ephemeris_messages;
+    std::map<unsigned int, Ephemeris_Message> galileo_ephemeris_messages;
+    bool Print_Ephemeris_Message(Ephemeris_Message & cached, unsigned int week, unsigned int iod, unsigned int iodc, double toe);
 };
 
 #endif
@@ -0,0 +1,170 @@
+/*!
+ * \file track_file_writer.cc
+ * \brief Buffered writer of text files made of a header, a growing body and a trailer
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "track_file_writer.h"
+#include <cmath>
+
+namespace
+{
+const double POW10[16] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+        1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+}
+
+
+Track_File_Writer::Track_File_Writer(double flush_interval_s)
+{
+    d_flush_interval_s = flush_interval_s;
+    d_file = nullptr;
+    d_body_end = 0;
+    d_flushes = 0;
+}
+
+
+Track_File_Writer::~Track_File_Writer()
+{
+    close();
+}
+
+
+bool Track_File_Writer::open(const std::string & filename, const std::string & header, const std::string & trailer)
+{
+    close();
+    d_file = std::fopen(filename.c_str(), "wb");
+    if (d_file == nullptr)
+        {
+            return false;
+        }
+    d_pending = header;
+    d_trailer = trailer;
+    d_body_end = 0;
+    d_flushes = 0;
+    return flush();
+}
+
+
+void Track_File_Writer::append(const std::string & text)
+{
+    if (d_file == nullptr)
+        {
+            return;
+        }
+    d_pending += text;
+    const double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - d_last_flush).count();
+    if (elapsed_s >= d_flush_interval_s || d_pending.size() >= TRACK_FILE_MAX_PENDING)
+        {
+            flush();
+        }
+}
+
+
+bool Track_File_Writer::flush()
+{
+    if (d_file == nullptr)
+        {
+            return false;
+        }
+    d_last_flush = std::chrono::steady_clock::now();
+    // the file only grows, so the trailer written last time is always overwritten
+    bool ok = std::fseek(d_file, d_body_end, SEEK_SET) == 0;
+    ok = ok && std::fwrite(d_pending.data(), 1, d_pending.size(), d_file) == d_pending.size();
+    if (ok)
+        {
+            d_body_end += static_cast<long>(d_pending.size());
+            d_pending.clear();
+        }
+    ok = ok && std::fwrite(d_trailer.data(), 1, d_trailer.size(), d_file) == d_trailer.size();
+    ok = (std::fflush(d_file) == 0) && ok;
+    d_flushes++;
+    return ok;
+}
+
+
+bool Track_File_Writer::close()
+{
+    if (d_file == nullptr)
+        {
+            return false;
+        }
+    bool ok = flush();
+    ok = (std::fclose(d_file) == 0) && ok;
+    d_file = nullptr;
+    d_pending.clear();
+    return ok;
+}
+
+
+char * Track_File_Writer::format_fixed(char * out, double value, int decimals)
+{
+    if (decimals < 0) decimals = 0;
+    if (decimals > 15) decimals = 15;
+    if (!(std::fabs(value) < 1e15))
+        {
+            // large values, infinities and NaN
+            return out + std::sprintf(out, "%.*f", decimals, value);
+        }
+    if (std::signbit(value))
+        {
+            *out++ = '-';
+            value = -value;
+        }
+    unsigned long long whole = static_cast<unsigned long long>(value);
+    unsigned long long digits = static_cast<unsigned long long>(std::llround((value - static_cast<double>(whole)) * POW10[decimals]));
+    const unsigned long long one = static_cast<unsigned long long>(POW10[decimals]);
+    if (digits >= one)
+        {
+            digits -= one;
+            whole++;
+        }
+
+    char reversed[20];
+    int n = 0;
+    do
+        {
+            reversed[n++] = static_cast<char>('0' + whole % 10);
+            whole /= 10;
+        }
+    while (whole > 0);
+    while (n > 0)
+        {
+            *out++ = reversed[--n];
+        }
+    if (decimals > 0)
+        {
+            *out++ = '.';
+            for (int k = decimals - 1; k >= 0; k--)
+                {
+                    out[k] = static_cast<char>('0' + digits % 10);
+                    digits /= 10;
+                }
+            out += decimals;
+        }
+    *out = '\0';
+    return out;
+}
@@ -0,0 +1,101 @@
+/*!
+ * \file track_file_writer.h
+ * \brief Buffered writer of text files made of a header, a growing body and a trailer
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_TRACK_FILE_WRITER_H_
+#define GNSS_SDR_TRACK_FILE_WRITER_H_
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+//! Default time between the writes of the buffered positions to the track files [s]
+#define TRACK_FILE_FLUSH_INTERVAL_S 1.0
+
+//! Pending text that is written at once, whatever the flush interval [bytes]
+#define TRACK_FILE_MAX_PENDING 65536
+
+/*!
+ * \brief Writes GIS tracks (KML, GeoJSON) whose body grows between a
+ * fixed header and trailer.
+ *
+ * The appended text is kept in memory and written every flush interval:
+ * the body goes over the previous trailer, and the trailer is written again
+ * after it. The file is complete after every flush, so a receiver that
+ * stops without closing it leaves a valid file with the positions up to the
+ * last flush, and a long session at 10 Hz does not flush the file at every
+ * position. A flush interval of 0 writes every append.
+ */
+class Track_File_Writer
+{
+public:
+    Track_File_Writer(double flush_interval_s = TRACK_FILE_FLUSH_INTERVAL_S);
+    ~Track_File_Writer();
+
+    //! Creates filename with the header and the trailer
+    bool open(const std::string & filename, const std::string & header, const std::string & trailer);
+
+    bool is_open() const
+    {
+        return d_file != nullptr;
+    }
+
+    //! Adds text to the body. It is written at the next flush.
+    void append(const std::string & text);
+
+    //! Writes the pending body and the trailer
+    bool flush();
+
+    //! Flushes and closes the file
+    bool close();
+
+    //! Writes of the file since it was opened
+    unsigned long long flushes() const
+    {
+        return d_flushes;
+    }
+
+    /*!
+     * \brief Writes value with decimals digits after the point (at most 15),
+     * as printf("%.*f"), and returns the end of the text. The last digit
+     * may differ by one. out must hold at least 40 characters.
+     */
+    static char * format_fixed(char * out, double value, int decimals);
+
+private:
+    double d_flush_interval_s;
+    std::FILE * d_file;
+    std::string d_pending;
+    std::string d_trailer;
+    long d_body_end;
+    std::chrono::steady_clock::time_point d_last_flush;
+    unsigned long long d_flushes;
+};
+
+#endif /* GNSS_SDR_TRACK_FILE_WRITER_H_ */
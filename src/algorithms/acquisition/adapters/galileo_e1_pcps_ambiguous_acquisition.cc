@@ -34,6 +34,8 @@
 #include <boost/math/distributions/exponential.hpp>
 #include <glog/logging.h>
 #include "galileo_e1_signal_processing.h"
+#include "fft_code_cache.h"
+#include "gnss_code_bank.h"
 #include "Galileo_E1.h"
 #include "configuration_interface.h"
 
@@ -68,10 +70,16 @@ GalileoE1PcpsAmbiguousAcquisition::GalileoE1PcpsAmbiguousAcquisition(
 
     bit_transition_flag_ = configuration_->property(role + ".bit_transition_flag", false);
     use_CFAR_algorithm_flag_ = configuration_->property(role + ".use_CFAR_algorithm", true); //will be false in future versions
+    fft_zero_padding_ = configuration_->property(role + ".fft_zero_padding", false);
+    dwell_accumulation_ = configuration_->property(role + ".dwell_accumulation", std::string("maximum"));
+    pipelined_ = configuration_->property(role + ".pipelined", false);
 
     max_dwells_ = configuration_->property(role + ".max_dwells", 1);
 
     dump_filename_ = configuration_->property(role + ".dump_filename", default_dump_filename);
+    dump_delay_decimation_ = configuration_->property(role + ".dump_delay_decimation", 1);
+    dump_roi_delays_ = configuration_->property(role + ".dump_roi_delays", 0);
+    dump_roi_doppler_bins_ = configuration_->property(role + ".dump_roi_doppler_bins", 0);
 
     //--- Find number of samples per spreading code (4 ms)  -----------------
     code_length_ = round(fs_in_ / (Galileo_E1_CODE_CHIP_RATE_HZ / Galileo_E1_B_CODE_LENGTH_CHIPS));
@@ -90,19 +98,33 @@ GalileoE1PcpsAmbiguousAcquisition::GalileoE1PcpsAmbiguousAcquisition(
             item_size_ = sizeof(lv_16sc_t);
             acquisition_sc_ = pcps_make_acquisition_sc(sampled_ms_, max_dwells_,
                     doppler_max_, if_, fs_in_, samples_per_ms, code_length_,
-                    bit_transition_flag_, use_CFAR_algorithm_flag_, dump_, dump_filename_);
+                    bit_transition_flag_, use_CFAR_algorithm_flag_, dump_, dump_filename_, item_size_);
             DLOG(INFO) << "acquisition(" << acquisition_sc_->unique_id() << ")";
 
         }else{
                 item_size_ = sizeof(gr_complex);
                 acquisition_cc_ = pcps_make_acquisition_cc(sampled_ms_, max_dwells_,
                         doppler_max_, if_, fs_in_, samples_per_ms, code_length_,
-                        bit_transition_flag_, use_CFAR_algorithm_flag_, dump_, dump_filename_);
+                        bit_transition_flag_, use_CFAR_algorithm_flag_, fft_zero_padding_, dump_, dump_filename_);
                 DLOG(INFO) << "acquisition(" << acquisition_cc_->unique_id() << ")";
+                if (dwell_accumulation_.compare("noncoherent") == 0)
+                    {
+                        acquisition_cc_->set_dwell_accumulation(DWELL_NONCOHERENT);
+                    }
+                else if (dwell_accumulation_.compare("coherent") == 0)
+                    {
+                        acquisition_cc_->set_dwell_accumulation(DWELL_COHERENT);
+                    }
+                acquisition_cc_->set_pipelined(pipelined_);
+                acquisition_cc_->set_dump_options(dump_delay_decimation_, dump_roi_delays_, dump_roi_doppler_bins_);
+        }
+
+    // The gr_complex acquisition reads the sample stream directly
+    if (item_type_.compare("cshort") == 0)
+        {
+            stream_to_vector_ = gr::blocks::stream_to_vector::make(item_size_, vector_length_);
+            DLOG(INFO) << "stream_to_vector(" << stream_to_vector_->unique_id() << ")";
         }
-
-    stream_to_vector_ = gr::blocks::stream_to_vector::make(item_size_, vector_length_);
-    DLOG(INFO) << "stream_to_vector(" << stream_to_vector_->unique_id() << ")";
     
     if (item_type_.compare("cbyte") == 0)
         {
@@ -133,6 +155,9 @@ void GalileoE1PcpsAmbiguousAcquisition::set_channel(unsigned int channel)
     else
         {
             acquisition_cc_->set_channel(channel_);
+            unsigned int rf_channel = configuration_->property("GNSS-SDR.rf_channel_offset", 0u)
+                    + configuration_->property("Channel" + boost::lexical_cast<std::string>(channel_) + ".RF_channel_ID", 0);
+            acquisition_cc_->set_rf_channel(rf_channel);
         }
 }
 
@@ -244,26 +269,46 @@ void GalileoE1PcpsAmbiguousAcquisition::set_local_code()
                     "Acquisition" + boost::lexical_cast<std::string>(channel_)
                     + ".cboc", false);
 
-    std::complex<float> * code = new std::complex<float>[code_length_];
-
-    galileo_e1_code_gen_complex_sampled(code, gnss_synchro_->Signal,
-                    cboc, gnss_synchro_->PRN, fs_in_, 0, false);
+    if (item_type_.compare("cshort") != 0)
+        {
+            // The conjugated code spectrum is shared by all the channels
+            std::string signal = std::string(gnss_synchro_->Signal, 2) + (cboc ? "_cboc" : "");
+            unsigned int prn = gnss_synchro_->PRN;
+            unsigned int code_length = code_length_;
+            unsigned int n_codes = sampled_ms_ / 4;
+            long fs_in = fs_in_;
+            char signal_str[3];
+            std::memcpy(signal_str, gnss_synchro_->Signal, 3);
+            acquisition_cc_->set_local_code_fft(Fft_Code_Cache::instance().get(signal, prn, fs_in_,
+                    acquisition_cc_->fft_size(), acquisition_cc_->fft_code_offset(),
+                    [signal_str, cboc, prn, code_length, n_codes, fs_in](gr_complex* dest) mutable
+                    {
+                        galileo_e1_code_gen_complex_sampled(dest, signal_str, cboc, prn, fs_in, 0, false);
+                        for (unsigned int i = 1; i < n_codes; i++)
+                            {
+                                memcpy(&(dest[i*code_length]), dest, sizeof(gr_complex)*code_length);
+                            }
+                    }));
+            return;
+        }
+
+    std::string signal = std::string(gnss_synchro_->Signal, 2) + (cboc ? "_cboc" : "");
+    unsigned int prn = gnss_synchro_->PRN;
+    long fs_in = fs_in_;
+    char signal_str[3];
+    std::memcpy(signal_str, gnss_synchro_->Signal, 3);
+    std::shared_ptr<const std::complex<float>> code = Gnss_Code_Bank::instance().get(signal, prn, fs_in_, 0, code_length_,
+            [signal_str, cboc, prn, fs_in](gr_complex* dest) mutable
+            {
+                galileo_e1_code_gen_complex_sampled(dest, signal_str, cboc, prn, fs_in, 0, false);
+            });
 
     for (unsigned int i = 0; i < sampled_ms_ / 4; i++)
         {
-            memcpy(&(code_[i*code_length_]), code, sizeof(gr_complex)*code_length_);
+            memcpy(&(code_[i*code_length_]), code.get(), sizeof(gr_complex)*code_length_);
         }
 
-    if (item_type_.compare("cshort") == 0)
-        {
-            acquisition_sc_->set_local_code(code_);
-        }
-    else
-        {
-            acquisition_cc_->set_local_code(code_);
-        }
-
-    delete[] code;
+    acquisition_sc_->set_local_code(code_);
 }
 
 
@@ -318,7 +363,7 @@ void GalileoE1PcpsAmbiguousAcquisition::connect(gr::top_block_sptr top_block)
 {
     if (item_type_.compare("gr_complex") == 0)
         {
-            top_block->connect(stream_to_vector_, 0, acquisition_cc_, 0);
+            // acquisition_cc_ reads the samples in place, nothing to connect
         }
     else if (item_type_.compare("cshort") == 0)
         {
@@ -328,8 +373,7 @@ void GalileoE1PcpsAmbiguousAcquisition::connect(gr::top_block_sptr top_block)
         {
             top_block->connect(cbyte_to_float_x2_, 0, float_to_complex_, 0);
             top_block->connect(cbyte_to_float_x2_, 1, float_to_complex_, 1);
-            top_block->connect(float_to_complex_, 0, stream_to_vector_, 0);
-            top_block->connect(stream_to_vector_, 0, acquisition_cc_, 0);
+            top_block->connect(float_to_complex_, 0, acquisition_cc_, 0);
         }
     else
         {
@@ -342,7 +386,7 @@ void GalileoE1PcpsAmbiguousAcquisition::disconnect(gr::top_block_sptr top_block)
 {
     if (item_type_.compare("gr_complex") == 0)
         {
-            top_block->disconnect(stream_to_vector_, 0, acquisition_cc_, 0);
+            // acquisition_cc_ reads the samples in place, nothing to disconnect
         }
     else if (item_type_.compare("cshort") == 0)
         {
@@ -354,8 +398,7 @@ void GalileoE1PcpsAmbiguousAcquisition::disconnect(gr::top_block_sptr top_block)
             // we just convert cshorts to gr_complex
             top_block->disconnect(cbyte_to_float_x2_, 0, float_to_complex_, 0);
             top_block->disconnect(cbyte_to_float_x2_, 1, float_to_complex_, 1);
-            top_block->disconnect(float_to_complex_, 0, stream_to_vector_, 0);
-            top_block->disconnect(stream_to_vector_, 0, acquisition_cc_, 0);
+            top_block->disconnect(float_to_complex_, 0, acquisition_cc_, 0);
         }
     else
         {
@@ -368,7 +411,7 @@ gr::basic_block_sptr GalileoE1PcpsAmbiguousAcquisition::get_left_block()
 {
     if (item_type_.compare("gr_complex") == 0)
         {
-            return stream_to_vector_;
+            return acquisition_cc_;
         }
     else if (item_type_.compare("cshort") == 0)
         {
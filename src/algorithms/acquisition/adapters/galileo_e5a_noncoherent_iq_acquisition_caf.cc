@@ -38,6 +38,7 @@
 #include "galileo_e5a_noncoherent_iq_acquisition_caf.h"
 #include <boost/lexical_cast.hpp>
 #include <boost/math/distributions/exponential.hpp>
+#include <boost/thread/thread.hpp>
 #include <glog/logging.h>
 #include "galileo_e5_signal_processing.h"
 #include "Galileo_E5a.h"
@@ -82,6 +83,13 @@ GalileoE5aNoncoherentIQAcquisitionCaf::GalileoE5aNoncoherentIQAcquisitionCaf(
     dump_filename_ = configuration_->property(role + ".dump_filename", default_dump_filename);
     bit_transition_flag_ = configuration_->property(role + ".bit_transition_flag", false);
 
+    // Number of threads the Doppler search is split into (0 = one per hardware core)
+    num_threads_ = configuration_->property(role + ".threads", 1);
+    if (num_threads_ == 0)
+        {
+            num_threads_ = boost::thread::hardware_concurrency();
+        }
+
     //--- Find number of samples per spreading code (1ms)-------------------------
     code_length_ = round(fs_in_ / Galileo_E5a_CODE_CHIP_RATE_HZ * Galileo_E5a_CODE_LENGTH_CHIPS);
 
@@ -101,7 +109,7 @@ GalileoE5aNoncoherentIQAcquisitionCaf::GalileoE5aNoncoherentIQAcquisitionCaf(
             item_size_ = sizeof(gr_complex);
             acquisition_cc_ = galileo_e5a_noncoherentIQ_make_acquisition_caf_cc(sampled_ms_, max_dwells_,
                     doppler_max_, if_, fs_in_, code_length_, code_length_, bit_transition_flag_,
-                    dump_, dump_filename_, both_signal_components, CAF_window_hz_,Zero_padding);
+                    num_threads_, dump_, dump_filename_, both_signal_components, CAF_window_hz_,Zero_padding);
         }
     else
         {
@@ -34,9 +34,12 @@
  */
 
 #include "gps_l1_ca_pcps_acquisition.h"
+#include <boost/lexical_cast.hpp>
 #include <boost/math/distributions/exponential.hpp>
 #include <glog/logging.h>
 #include "gps_sdr_signal_processing.h"
+#include "fft_code_cache.h"
+#include "gnss_code_bank.h"
 #include "GPS_L1_CA.h"
 #include "configuration_interface.h"
 
@@ -64,10 +67,17 @@ GpsL1CaPcpsAcquisition::GpsL1CaPcpsAcquisition(
 
     bit_transition_flag_ = configuration_->property(role + ".bit_transition_flag", false);
     use_CFAR_algorithm_flag_=configuration_->property(role + ".use_CFAR_algorithm", true); //will be false in future versions
+    fft_zero_padding_ = configuration_->property(role + ".fft_zero_padding", false);
+    dwell_accumulation_ = configuration_->property(role + ".dwell_accumulation", std::string("maximum"));
+    pipelined_ = configuration_->property(role + ".pipelined", false);
+    acquisition_fs_hz_ = configuration_->property(role + ".acquisition_fs_hz", 0);
 
     max_dwells_ = configuration_->property(role + ".max_dwells", 1);
 
     dump_filename_ = configuration_->property(role + ".dump_filename", default_dump_filename);
+    dump_delay_decimation_ = configuration_->property(role + ".dump_delay_decimation", 1);
+    dump_roi_delays_ = configuration_->property(role + ".dump_roi_delays", 0);
+    dump_roi_doppler_bins_ = configuration_->property(role + ".dump_roi_doppler_bins", 0);
 
     //--- Find number of samples per spreading code -------------------------
     code_length_ = round(fs_in_ / (GPS_L1_CA_CODE_RATE_HZ / GPS_L1_CA_CODE_LENGTH_CHIPS));
@@ -81,29 +91,64 @@ GpsL1CaPcpsAcquisition::GpsL1CaPcpsAcquisition(
 
     code_ = new gr_complex[vector_length_];
 
-    if (item_type_.compare("cshort") == 0 )
-        {
-            item_size_ = sizeof(lv_16sc_t);
+    // Reduced-rate acquisition: the search runs at fs_in_ / decimation_, the
+    // largest divisor of the code period that does not go below acquisition_fs_hz
+    decimation_ = 1;
+    if (acquisition_fs_hz_ > 0 && acquisition_fs_hz_ < fs_in_)
+        {
+            if (item_type_.compare("gr_complex") != 0 || if_ != 0 || bit_transition_flag_)
+                {
+                    LOG(WARNING) << role << ".acquisition_fs_hz requires gr_complex samples at zero IF and bit_transition_flag=false. Ignoring it.";
+                }
+            else
+                {
+                    unsigned int decimation = static_cast<unsigned int>(fs_in_ / acquisition_fs_hz_);
+                    while (decimation > 1 && (code_length_ % decimation != 0 || fs_in_ % decimation != 0))
+                        {
+                            decimation--;
+                        }
+                    decimation_ = decimation;
+                }
+        }
+    acq_code_length_ = code_length_ / decimation_;
+
+    if (item_type_.compare("cshort") == 0 || item_type_.compare("cbyte") == 0)
+        {
+            // 8-bit samples go to the integer implementation as they are
+            item_size_ = (item_type_.compare("cbyte") == 0) ? sizeof(lv_8sc_t) : sizeof(lv_16sc_t);
             acquisition_sc_ = pcps_make_acquisition_sc(sampled_ms_, max_dwells_,
                     doppler_max_, if_, fs_in_, code_length_, code_length_,
-                    bit_transition_flag_, use_CFAR_algorithm_flag_, dump_, dump_filename_);
+                    bit_transition_flag_, use_CFAR_algorithm_flag_, dump_, dump_filename_, item_size_);
             DLOG(INFO) << "acquisition(" << acquisition_sc_->unique_id() << ")";
 
         }else{
                 item_size_ = sizeof(gr_complex);
                 acquisition_cc_ = pcps_make_acquisition_cc(sampled_ms_, max_dwells_,
-                        doppler_max_, if_, fs_in_, code_length_, code_length_,
-                        bit_transition_flag_, use_CFAR_algorithm_flag_, dump_, dump_filename_);
+                        doppler_max_, if_, fs_in_ / decimation_, acq_code_length_, acq_code_length_,
+                        bit_transition_flag_, use_CFAR_algorithm_flag_, fft_zero_padding_, dump_, dump_filename_);
                 DLOG(INFO) << "acquisition(" << acquisition_cc_->unique_id() << ")";
-        }
-
-    stream_to_vector_ = gr::blocks::stream_to_vector::make(item_size_, vector_length_);
-    DLOG(INFO) << "stream_to_vector(" << stream_to_vector_->unique_id() << ")";
-    
-    if (item_type_.compare("cbyte") == 0)
-        {
-            cbyte_to_float_x2_ = make_complex_byte_to_float_x2();
-            float_to_complex_ = gr::blocks::float_to_complex::make();
+                if (decimation_ > 1)
+                    {
+                        acquisition_cc_->set_decimation(decimation_);
+                        DLOG(INFO) << "Acquisition at " << fs_in_ / decimation_ << " Hz, decimation " << decimation_;
+                    }
+                if (dwell_accumulation_.compare("noncoherent") == 0)
+                    {
+                        acquisition_cc_->set_dwell_accumulation(DWELL_NONCOHERENT);
+                    }
+                else if (dwell_accumulation_.compare("coherent") == 0)
+                    {
+                        acquisition_cc_->set_dwell_accumulation(DWELL_COHERENT);
+                    }
+                acquisition_cc_->set_pipelined(pipelined_);
+                acquisition_cc_->set_dump_options(dump_delay_decimation_, dump_roi_delays_, dump_roi_doppler_bins_);
+        }
+
+    // The gr_complex acquisition reads the sample stream directly
+    if (item_type_.compare("cshort") == 0 || item_type_.compare("cbyte") == 0)
+        {
+            stream_to_vector_ = gr::blocks::stream_to_vector::make(item_size_, vector_length_);
+            DLOG(INFO) << "stream_to_vector(" << stream_to_vector_->unique_id() << ")";
         }
 
     channel_ = 0;
@@ -122,13 +167,16 @@ GpsL1CaPcpsAcquisition::~GpsL1CaPcpsAcquisition()
 void GpsL1CaPcpsAcquisition::set_channel(unsigned int channel)
 {
     channel_ = channel;
-    if (item_type_.compare("cshort") == 0)
+    if (item_type_.compare("cshort") == 0 || item_type_.compare("cbyte") == 0)
         {
             acquisition_sc_->set_channel(channel_);
         }
     else
         {
             acquisition_cc_->set_channel(channel_);
+            unsigned int rf_channel = configuration_->property("GNSS-SDR.rf_channel_offset", 0u)
+                    + configuration_->property("Channel" + boost::lexical_cast<std::string>(channel_) + ".RF_channel_ID", 0);
+            acquisition_cc_->set_rf_channel(rf_channel);
         }
 
 }
@@ -150,7 +198,7 @@ void GpsL1CaPcpsAcquisition::set_threshold(float threshold)
     DLOG(INFO) << "Channel " << channel_ << " Threshold = " << threshold_;
 
 
-    if (item_type_.compare("cshort") == 0)
+    if (item_type_.compare("cshort") == 0 || item_type_.compare("cbyte") == 0)
         {
             acquisition_sc_->set_threshold(threshold_);
         }
@@ -165,7 +213,7 @@ void GpsL1CaPcpsAcquisition::set_doppler_max(unsigned int doppler_max)
 {
     doppler_max_ = doppler_max;
 
-    if (item_type_.compare("cshort") == 0)
+    if (item_type_.compare("cshort") == 0 || item_type_.compare("cbyte") == 0)
         {
             acquisition_sc_->set_doppler_max(doppler_max_);
         }
@@ -180,7 +228,7 @@ void GpsL1CaPcpsAcquisition::set_doppler_step(unsigned int doppler_step)
 {
     doppler_step_ = doppler_step;
 
-    if (item_type_.compare("cshort") == 0)
+    if (item_type_.compare("cshort") == 0 || item_type_.compare("cbyte") == 0)
         {
             acquisition_sc_->set_doppler_step(doppler_step_);
         }
@@ -195,7 +243,7 @@ void GpsL1CaPcpsAcquisition::set_gnss_synchro(Gnss_Synchro* gnss_synchro)
 {
     gnss_synchro_ = gnss_synchro;
 
-    if (item_type_.compare("cshort") == 0)
+    if (item_type_.compare("cshort") == 0 || item_type_.compare("cbyte") == 0)
         {
             acquisition_sc_->set_gnss_synchro(gnss_synchro_);
         }
@@ -208,7 +256,7 @@ void GpsL1CaPcpsAcquisition::set_gnss_synchro(Gnss_Synchro* gnss_synchro)
 
 signed int GpsL1CaPcpsAcquisition::mag()
 {
-    if (item_type_.compare("cshort") == 0)
+    if (item_type_.compare("cshort") == 0 || item_type_.compare("cbyte") == 0)
         {
             return acquisition_sc_->mag();
         }
@@ -221,7 +269,7 @@ signed int GpsL1CaPcpsAcquisition::mag()
 
 void GpsL1CaPcpsAcquisition::init()
 {
-    if (item_type_.compare("cshort") == 0)
+    if (item_type_.compare("cshort") == 0 || item_type_.compare("cbyte") == 0)
         {
             acquisition_sc_->init();
         }
@@ -236,33 +284,57 @@ void GpsL1CaPcpsAcquisition::init()
 
 void GpsL1CaPcpsAcquisition::set_local_code()
 {
-
-    std::complex<float>* code = new std::complex<float>[code_length_];
-
-    gps_l1_ca_code_gen_complex_sampled(code, gnss_synchro_->PRN, fs_in_, 0);
+    if (item_type_.compare("cshort") != 0 && item_type_.compare("cbyte") != 0)
+        {
+            // The conjugated code spectrum is shared by all the channels
+            unsigned int prn = gnss_synchro_->PRN;
+            unsigned int code_length = acq_code_length_;
+            unsigned int sampled_ms = sampled_ms_;
+            long fs_in = fs_in_ / decimation_;
+            acquisition_cc_->set_local_code_fft(Fft_Code_Cache::instance().get("1C", prn, fs_in,
+                    acquisition_cc_->fft_size(), acquisition_cc_->fft_code_offset(),
+                    [prn, code_length, sampled_ms, fs_in](gr_complex* dest)
+                    {
+                        gps_l1_ca_code_gen_complex_sampled(dest, prn, fs_in, 0);
+                        for (unsigned int i = 1; i < sampled_ms; i++)
+                            {
+                                memcpy(&(dest[i*code_length]), dest, sizeof(gr_complex)*code_length);
+                            }
+                    }));
+            if (decimation_ > 1)
+                {
+                    // One period at the input rate, for the refinement of the code delay
+                    long fs_full = fs_in_;
+                    acquisition_cc_->set_full_rate_code(Gnss_Code_Bank::instance().get("1C", prn, fs_in_, 0, code_length_,
+                            [prn, fs_full](gr_complex* dest)
+                            {
+                                gps_l1_ca_code_gen_complex_sampled(dest, prn, fs_full, 0);
+                            }), code_length_);
+                }
+            return;
+        }
+
+    unsigned int prn = gnss_synchro_->PRN;
+    long fs_in = fs_in_;
+    std::shared_ptr<const std::complex<float>> code = Gnss_Code_Bank::instance().get("1C", prn, fs_in_, 0, code_length_,
+            [prn, fs_in](gr_complex* dest)
+            {
+                gps_l1_ca_code_gen_complex_sampled(dest, prn, fs_in, 0);
+            });
 
     for (unsigned int i = 0; i < sampled_ms_; i++)
         {
-            memcpy(&(code_[i*code_length_]), code,
+            memcpy(&(code_[i*code_length_]), code.get(),
                     sizeof(gr_complex)*code_length_);
         }
 
-    if (item_type_.compare("cshort") == 0)
-        {
-            acquisition_sc_->set_local_code(code_);
-        }
-    else
-        {
-            acquisition_cc_->set_local_code(code_);
-        }
-
-    delete[] code;
+    acquisition_sc_->set_local_code(code_);
 }
 
 
 void GpsL1CaPcpsAcquisition::reset()
 {
-    if (item_type_.compare("cshort") == 0)
+    if (item_type_.compare("cshort") == 0 || item_type_.compare("cbyte") == 0)
         {
             acquisition_sc_->set_active(true);
         }
@@ -275,7 +347,7 @@ void GpsL1CaPcpsAcquisition::reset()
 
 void GpsL1CaPcpsAcquisition::set_state(int state)
 {
-    if (item_type_.compare("cshort") == 0)
+    if (item_type_.compare("cshort") == 0 || item_type_.compare("cbyte") == 0)
         {
             acquisition_sc_->set_state(state);
         }
@@ -296,10 +368,11 @@ float GpsL1CaPcpsAcquisition::calculate_threshold(float pfa)
             frequency_bins++;
         }
     DLOG(INFO) << "Channel " << channel_ << "  Pfa = " << pfa;
-    unsigned int ncells = vector_length_ * frequency_bins;
+    // The search grid is decimation_ times shorter in reduced-rate acquisition
+    unsigned int ncells = vector_length_ / decimation_ * frequency_bins;
     double exponent = 1 / static_cast<double>(ncells);
     double val = pow(1.0 - pfa, exponent);
-    double lambda = double(vector_length_);
+    double lambda = double(vector_length_ / decimation_);
     boost::math::exponential_distribution<double> mydist (lambda);
     float threshold = (float)quantile(mydist,val);
 
@@ -311,19 +384,12 @@ void GpsL1CaPcpsAcquisition::connect(gr::top_block_sptr top_block)
 {
     if (item_type_.compare("gr_complex") == 0)
         {
-            top_block->connect(stream_to_vector_, 0, acquisition_cc_, 0);
+            // acquisition_cc_ reads the samples in place, nothing to connect
         }
-    else if (item_type_.compare("cshort") == 0)
+    else if (item_type_.compare("cshort") == 0 || item_type_.compare("cbyte") == 0)
         {
             top_block->connect(stream_to_vector_, 0, acquisition_sc_, 0);
         }
-    else if (item_type_.compare("cbyte") == 0)
-        {
-            top_block->connect(cbyte_to_float_x2_, 0, float_to_complex_, 0);
-            top_block->connect(cbyte_to_float_x2_, 1, float_to_complex_, 1);
-            top_block->connect(float_to_complex_, 0, stream_to_vector_, 0);
-            top_block->connect(stream_to_vector_, 0, acquisition_cc_, 0);
-        }
     else
         {
             LOG(WARNING) << item_type_ << " unknown acquisition item type";
@@ -335,21 +401,12 @@ void GpsL1CaPcpsAcquisition::disconnect(gr::top_block_sptr top_block)
 {
     if (item_type_.compare("gr_complex") == 0)
         {
-            top_block->disconnect(stream_to_vector_, 0, acquisition_cc_, 0);
+            // acquisition_cc_ reads the samples in place, nothing to disconnect
         }
-    else if (item_type_.compare("cshort") == 0)
+    else if (item_type_.compare("cshort") == 0 || item_type_.compare("cbyte") == 0)
         {
             top_block->disconnect(stream_to_vector_, 0, acquisition_sc_, 0);
         }
-    else if (item_type_.compare("cbyte") == 0)
-        {
-            // Since a byte-based acq implementation is not available,
-            // we just convert cshorts to gr_complex
-            top_block->disconnect(cbyte_to_float_x2_, 0, float_to_complex_, 0);
-            top_block->disconnect(cbyte_to_float_x2_, 1, float_to_complex_, 1);
-            top_block->disconnect(float_to_complex_, 0, stream_to_vector_, 0);
-            top_block->disconnect(stream_to_vector_, 0, acquisition_cc_, 0);
-        }
     else
         {
             LOG(WARNING) << item_type_ << " unknown acquisition item type";
@@ -361,16 +418,12 @@ gr::basic_block_sptr GpsL1CaPcpsAcquisition::get_left_block()
 {
     if (item_type_.compare("gr_complex") == 0)
         {
-            return stream_to_vector_;
+            return acquisition_cc_;
         }
-    else if (item_type_.compare("cshort") == 0)
+    else if (item_type_.compare("cshort") == 0 || item_type_.compare("cbyte") == 0)
         {
             return stream_to_vector_;
         }
-    else if (item_type_.compare("cbyte") == 0)
-        {
-            return cbyte_to_float_x2_;
-        }
     else
         {
             LOG(WARNING) << item_type_ << " unknown acquisition item type";
@@ -381,7 +434,7 @@ gr::basic_block_sptr GpsL1CaPcpsAcquisition::get_left_block()
 
 gr::basic_block_sptr GpsL1CaPcpsAcquisition::get_right_block()
 {
-    if (item_type_.compare("cshort") == 0)
+    if (item_type_.compare("cshort") == 0 || item_type_.compare("cbyte") == 0)
         {
             return acquisition_sc_;
         }
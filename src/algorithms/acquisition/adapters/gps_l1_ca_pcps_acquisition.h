@@ -38,12 +38,10 @@
 
 #include <string>
 #include <gnuradio/blocks/stream_to_vector.h>
-#include <gnuradio/blocks/float_to_complex.h>
 #include "gnss_synchro.h"
 #include "acquisition_interface.h"
 #include "pcps_acquisition_cc.h"
 #include "pcps_acquisition_sc.h"
-#include "complex_byte_to_float_x2.h"
 #include <volk_gnsssdr/volk_gnsssdr.h>
 
 
@@ -142,14 +140,18 @@ private:
     pcps_acquisition_cc_sptr acquisition_cc_;
     pcps_acquisition_sc_sptr acquisition_sc_;
     gr::blocks::stream_to_vector::sptr stream_to_vector_;
-    gr::blocks::float_to_complex::sptr float_to_complex_;
-    complex_byte_to_float_x2_sptr cbyte_to_float_x2_;
     size_t item_size_;
     std::string item_type_;
     unsigned int vector_length_;
     unsigned int code_length_;
     bool bit_transition_flag_;
     bool use_CFAR_algorithm_flag_;
+    bool fft_zero_padding_;
+    std::string dwell_accumulation_;
+    bool pipelined_;
+    long acquisition_fs_hz_;
+    unsigned int decimation_;        // Input samples per acquisition sample
+    unsigned int acq_code_length_;   // Samples per code period at the acquisition rate
     unsigned int channel_;
     float threshold_;
     unsigned int doppler_max_;
@@ -160,6 +162,9 @@ private:
     long if_;
     bool dump_;
     std::string dump_filename_;
+    unsigned int dump_delay_decimation_;
+    unsigned int dump_roi_delays_;
+    unsigned int dump_roi_doppler_bins_;
     std::complex<float> * code_;
     Gnss_Synchro * gnss_synchro_;
     std::string role_;
@@ -59,6 +59,8 @@ GpsL1CaPcpsAcquisitionFineDoppler::GpsL1CaPcpsAcquisitionFineDoppler(
     doppler_min_ = configuration->property(role + ".doppler_min", -5000);
     sampled_ms_ = configuration->property(role + ".coherent_integration_time_ms", 1);
     max_dwells_= configuration->property(role + ".max_dwells", 1);
+    coarse_doppler_step_ = configuration->property(role + ".coarse_doppler_step", 0);
+    coarse_candidates_ = configuration->property(role + ".coarse_candidates", 3);
  
     //--- Find number of samples per spreading code -------------------------
     vector_length_ = round(fs_in_
@@ -72,6 +74,7 @@ GpsL1CaPcpsAcquisitionFineDoppler::GpsL1CaPcpsAcquisitionFineDoppler(
             acquisition_cc_ = pcps_make_acquisition_fine_doppler_cc(max_dwells_,sampled_ms_,
                     doppler_max_, doppler_min_, if_, fs_in_, vector_length_,
                     dump_, dump_filename_);
+            acquisition_cc_->set_coarse_search(coarse_doppler_step_, coarse_candidates_);
         }
     else
         {
@@ -134,6 +134,8 @@ private:
     int doppler_min_;
     unsigned int sampled_ms_;
     int max_dwells_;
+    unsigned int coarse_doppler_step_;
+    unsigned int coarse_candidates_;
     long fs_in_;
     long if_;
     bool dump_;
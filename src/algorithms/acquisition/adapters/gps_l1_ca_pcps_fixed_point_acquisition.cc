@@ -0,0 +1,227 @@
+/*!
+ * \file gps_l1_ca_pcps_fixed_point_acquisition.cc
+ * \brief Adapts a 16-bit integer PCPS acquisition block to an
+ *  AcquisitionInterface for GPS L1 C/A signals
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gps_l1_ca_pcps_fixed_point_acquisition.h"
+#include <algorithm>
+#include <cstring>
+#include <glog/logging.h>
+#include "gps_sdr_signal_processing.h"
+#include "fft_code_cache.h"
+#include "GPS_L1_CA.h"
+#include "configuration_interface.h"
+
+
+using google::LogMessage;
+
+GpsL1CaPcpsFixedPointAcquisition::GpsL1CaPcpsFixedPointAcquisition(
+        ConfigurationInterface* configuration, std::string role,
+        unsigned int in_streams, unsigned int out_streams) :
+    role_(role), in_streams_(in_streams), out_streams_(out_streams)
+{
+    configuration_ = configuration;
+    std::string default_item_type = "cshort";
+    std::string default_dump_filename = "./data/acquisition.dat";
+
+    DLOG(INFO) << "role " << role;
+
+    item_type_ = configuration_->property(role + ".item_type", default_item_type);
+
+    fs_in_ = configuration_->property("GNSS-SDR.internal_fs_hz", 2048000);
+    if_ = configuration_->property(role + ".if", 0);
+    dump_ = configuration_->property(role + ".dump", false);
+    doppler_max_ = configuration_->property(role + ".doppler_max", 5000);
+    sampled_ms_ = configuration_->property(role + ".coherent_integration_time_ms", 1);
+    max_dwells_ = configuration_->property(role + ".max_dwells", 1);
+
+    dump_filename_ = configuration_->property(role + ".dump_filename", default_dump_filename);
+
+    //--- Find number of samples per spreading code -------------------------
+    code_length_ = round(fs_in_ / (GPS_L1_CA_CODE_RATE_HZ / GPS_L1_CA_CODE_LENGTH_CHIPS));
+
+    vector_length_ = code_length_ * sampled_ms_;
+
+    if (item_type_.compare("cshort") == 0)
+        {
+            item_size_ = sizeof(lv_16sc_t);
+        }
+    else if (item_type_.compare("cbyte") == 0)
+        {
+            // Each byte is widened to a short (scaled by 256), so the
+            // acquisition block always works on lv_16sc_t samples
+            item_size_ = sizeof(lv_8sc_t);
+            char_to_short_ = gr::blocks::char_to_short::make(2);
+        }
+    else
+        {
+            item_size_ = sizeof(lv_16sc_t);
+            LOG(WARNING) << item_type_ << " unknown acquisition item type";
+        }
+
+    acquisition_sc_ = pcps_make_fixed_point_acquisition_sc(sampled_ms_, max_dwells_,
+            doppler_max_, if_, fs_in_, code_length_, code_length_,
+            dump_, dump_filename_);
+    DLOG(INFO) << "acquisition(" << acquisition_sc_->unique_id() << ")";
+
+    stream_to_vector_ = gr::blocks::stream_to_vector::make(sizeof(lv_16sc_t), vector_length_);
+    DLOG(INFO) << "stream_to_vector(" << stream_to_vector_->unique_id() << ")";
+
+    channel_ = 0;
+    threshold_ = 0.0;
+    doppler_step_ = 0;
+    gnss_synchro_ = 0;
+}
+
+
+GpsL1CaPcpsFixedPointAcquisition::~GpsL1CaPcpsFixedPointAcquisition()
+{}
+
+
+void GpsL1CaPcpsFixedPointAcquisition::set_channel(unsigned int channel)
+{
+    channel_ = channel;
+    acquisition_sc_->set_channel(channel_);
+}
+
+
+void GpsL1CaPcpsFixedPointAcquisition::set_threshold(float threshold)
+{
+    threshold_ = threshold;
+
+    DLOG(INFO) << "Channel " << channel_ << " Threshold = " << threshold_;
+
+    acquisition_sc_->set_threshold(threshold_);
+}
+
+
+void GpsL1CaPcpsFixedPointAcquisition::set_doppler_max(unsigned int doppler_max)
+{
+    doppler_max_ = doppler_max;
+    acquisition_sc_->set_doppler_max(doppler_max_);
+}
+
+
+void GpsL1CaPcpsFixedPointAcquisition::set_doppler_step(unsigned int doppler_step)
+{
+    doppler_step_ = doppler_step;
+    acquisition_sc_->set_doppler_step(doppler_step_);
+}
+
+
+void GpsL1CaPcpsFixedPointAcquisition::set_gnss_synchro(Gnss_Synchro* gnss_synchro)
+{
+    gnss_synchro_ = gnss_synchro;
+    acquisition_sc_->set_gnss_synchro(gnss_synchro_);
+}
+
+
+signed int GpsL1CaPcpsFixedPointAcquisition::mag()
+{
+    return acquisition_sc_->mag();
+}
+
+
+void GpsL1CaPcpsFixedPointAcquisition::init()
+{
+    acquisition_sc_->init();
+    set_local_code();
+}
+
+
+void GpsL1CaPcpsFixedPointAcquisition::set_local_code()
+{
+    // The floating point code spectrum is shared with the other GPS L1 C/A
+    // acquisitions, and quantized to Q15 by the block. A zero-padded FFT
+    // takes the code followed by zeros.
+    unsigned int prn = gnss_synchro_->PRN;
+    unsigned int code_length = code_length_;
+    unsigned int sampled_ms = sampled_ms_;
+    unsigned int fft_size = acquisition_sc_->fft_size();
+    long fs_in = fs_in_;
+    acquisition_sc_->set_local_code_fft(Fft_Code_Cache::instance().get("1C", prn, fs_in_,
+            fft_size, 0,
+            [prn, code_length, sampled_ms, fft_size, fs_in](gr_complex* dest)
+            {
+                gps_l1_ca_code_gen_complex_sampled(dest, prn, fs_in, 0);
+                for (unsigned int i = 1; i < sampled_ms; i++)
+                    {
+                        memcpy(&(dest[i*code_length]), dest, sizeof(gr_complex)*code_length);
+                    }
+                std::fill(dest + sampled_ms * code_length, dest + fft_size, gr_complex(0.0, 0.0));
+            }));
+}
+
+
+void GpsL1CaPcpsFixedPointAcquisition::reset()
+{
+    acquisition_sc_->set_active(true);
+}
+
+
+void GpsL1CaPcpsFixedPointAcquisition::set_state(int state)
+{
+    acquisition_sc_->set_state(state);
+}
+
+
+void GpsL1CaPcpsFixedPointAcquisition::connect(gr::top_block_sptr top_block)
+{
+    if (item_type_.compare("cbyte") == 0)
+        {
+            top_block->connect(char_to_short_, 0, stream_to_vector_, 0);
+        }
+    top_block->connect(stream_to_vector_, 0, acquisition_sc_, 0);
+}
+
+
+void GpsL1CaPcpsFixedPointAcquisition::disconnect(gr::top_block_sptr top_block)
+{
+    if (item_type_.compare("cbyte") == 0)
+        {
+            top_block->disconnect(char_to_short_, 0, stream_to_vector_, 0);
+        }
+    top_block->disconnect(stream_to_vector_, 0, acquisition_sc_, 0);
+}
+
+
+gr::basic_block_sptr GpsL1CaPcpsFixedPointAcquisition::get_left_block()
+{
+    if (item_type_.compare("cbyte") == 0)
+        {
+            return char_to_short_;
+        }
+    return stream_to_vector_;
+}
+
+
+gr::basic_block_sptr GpsL1CaPcpsFixedPointAcquisition::get_right_block()
+{
+    return acquisition_sc_;
+}
@@ -31,6 +31,7 @@
 
 #include "gps_l1_ca_pcps_multithread_acquisition.h"
 #include <boost/math/distributions/exponential.hpp>
+#include <boost/thread/thread.hpp>
 #include <glog/logging.h>
 #include "gps_sdr_signal_processing.h"
 #include "GPS_L1_CA.h"
@@ -73,6 +74,13 @@ GpsL1CaPcpsMultithreadAcquisition::GpsL1CaPcpsMultithreadAcquisition(
     dump_filename_ = configuration_->property(role + ".dump_filename",
             default_dump_filename);
 
+    // Number of threads the Doppler search is split into (0 = one per hardware core)
+    num_threads_ = configuration_->property(role + ".threads", 1);
+    if (num_threads_ == 0)
+        {
+            num_threads_ = boost::thread::hardware_concurrency();
+        }
+
     //--- Find number of samples per spreading code -------------------------
     code_length_ = round(fs_in_
             / (GPS_L1_CA_CODE_RATE_HZ / GPS_L1_CA_CODE_LENGTH_CHIPS));
@@ -86,7 +94,7 @@ GpsL1CaPcpsMultithreadAcquisition::GpsL1CaPcpsMultithreadAcquisition(
             item_size_ = sizeof(gr_complex);
             acquisition_cc_ = pcps_make_multithread_acquisition_cc(sampled_ms_, max_dwells_,
                     doppler_max_, if_, fs_in_, code_length_, code_length_,
-                    bit_transition_flag_, dump_, dump_filename_);
+                    bit_transition_flag_, num_threads_, dump_, dump_filename_);
 
             stream_to_vector_ = gr::blocks::stream_to_vector::make(item_size_, vector_length_);
 
@@ -139,6 +139,7 @@ private:
     unsigned int doppler_step_;
     unsigned int sampled_ms_;
     unsigned int max_dwells_;
+    unsigned int num_threads_;
     long fs_in_;
     long if_;
     bool dump_;
@@ -0,0 +1,289 @@
+/*!
+ * \file gps_l1_ca_pcps_shifted_spectrum_acquisition.cc
+ * \brief Adapts a PCPS acquisition block that searches the Doppler grid by
+ *  shifting the input spectrum to an AcquisitionInterface for GPS L1 C/A signals
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gps_l1_ca_pcps_shifted_spectrum_acquisition.h"
+#include <cstring>
+#include <boost/lexical_cast.hpp>
+#include <boost/math/distributions/exponential.hpp>
+#include <glog/logging.h>
+#include "gps_sdr_signal_processing.h"
+#include "fft_code_cache.h"
+#include "GPS_L1_CA.h"
+#include "configuration_interface.h"
+
+
+using google::LogMessage;
+
+GpsL1CaPcpsShiftedSpectrumAcquisition::GpsL1CaPcpsShiftedSpectrumAcquisition(
+        ConfigurationInterface* configuration, std::string role,
+        unsigned int in_streams, unsigned int out_streams) :
+    role_(role), in_streams_(in_streams), out_streams_(out_streams)
+{
+    configuration_ = configuration;
+    std::string default_item_type = "gr_complex";
+    std::string default_dump_filename = "./data/acquisition.dat";
+
+    DLOG(INFO) << "role " << role;
+
+    item_type_ = configuration_->property(role + ".item_type", default_item_type);
+
+    fs_in_ = configuration_->property("GNSS-SDR.internal_fs_hz", 2048000);
+    if_ = configuration_->property(role + ".if", 0);
+    dump_ = configuration_->property(role + ".dump", false);
+    doppler_max_ = configuration_->property(role + ".doppler_max", 5000);
+    sampled_ms_ = configuration_->property(role + ".coherent_integration_time_ms", 1);
+
+    bit_transition_flag_ = configuration_->property(role + ".bit_transition_flag", false);
+    use_CFAR_algorithm_flag_ = configuration_->property(role + ".use_CFAR_algorithm", true);
+
+    max_dwells_ = configuration_->property(role + ".max_dwells", 1);
+
+    dump_filename_ = configuration_->property(role + ".dump_filename", default_dump_filename);
+
+    //--- Find number of samples per spreading code -------------------------
+    code_length_ = round(fs_in_ / (GPS_L1_CA_CODE_RATE_HZ / GPS_L1_CA_CODE_LENGTH_CHIPS));
+
+    vector_length_ = code_length_ * sampled_ms_;
+
+    if( bit_transition_flag_ )
+        {
+            vector_length_ *= 2;
+        }
+
+    item_size_ = sizeof(gr_complex);
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            acquisition_cc_ = pcps_make_shifted_spectrum_acquisition_cc(sampled_ms_, max_dwells_,
+                    doppler_max_, if_, fs_in_, code_length_, code_length_,
+                    bit_transition_flag_, use_CFAR_algorithm_flag_, dump_, dump_filename_);
+
+            stream_to_vector_ = gr::blocks::stream_to_vector::make(item_size_, vector_length_);
+
+            DLOG(INFO) << "stream_to_vector(" << stream_to_vector_->unique_id() << ")";
+            DLOG(INFO) << "acquisition(" << acquisition_cc_->unique_id() << ")";
+        }
+    else
+        {
+            LOG(WARNING) << item_type_ << " unknown acquisition item type";
+        }
+
+    channel_ = 0;
+    threshold_ = 0.0;
+    doppler_step_ = 0;
+    gnss_synchro_ = 0;
+}
+
+
+GpsL1CaPcpsShiftedSpectrumAcquisition::~GpsL1CaPcpsShiftedSpectrumAcquisition()
+{}
+
+
+void GpsL1CaPcpsShiftedSpectrumAcquisition::set_channel(unsigned int channel)
+{
+    channel_ = channel;
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            acquisition_cc_->set_channel(channel_);
+
+            // Channels fed by the same signal conditioner reuse each other's input FFTs
+            bool share_input_spectrum = configuration_->property(role_ + ".share_input_spectrum", true);
+            unsigned int rf_channel = configuration_->property("GNSS-SDR.rf_channel_offset", 0u)
+                    + configuration_->property("Channel" + boost::lexical_cast<std::string>(channel_) + ".RF_channel_ID", 0);
+            acquisition_cc_->set_share_input_spectrum(share_input_spectrum, rf_channel);
+        }
+}
+
+
+void GpsL1CaPcpsShiftedSpectrumAcquisition::set_threshold(float threshold)
+{
+    float pfa = configuration_->property(role_ + ".pfa", 0.0);
+
+    if(pfa == 0.0)
+        {
+            threshold_ = threshold;
+        }
+    else
+        {
+            threshold_ = calculate_threshold(pfa);
+        }
+
+    DLOG(INFO) << "Channel " << channel_ << " Threshold = " << threshold_;
+
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            acquisition_cc_->set_threshold(threshold_);
+        }
+}
+
+
+void GpsL1CaPcpsShiftedSpectrumAcquisition::set_doppler_max(unsigned int doppler_max)
+{
+    doppler_max_ = doppler_max;
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            acquisition_cc_->set_doppler_max(doppler_max_);
+        }
+}
+
+
+void GpsL1CaPcpsShiftedSpectrumAcquisition::set_doppler_step(unsigned int doppler_step)
+{
+    doppler_step_ = doppler_step;
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            acquisition_cc_->set_doppler_step(doppler_step_);
+        }
+}
+
+
+void GpsL1CaPcpsShiftedSpectrumAcquisition::set_gnss_synchro(Gnss_Synchro* gnss_synchro)
+{
+    gnss_synchro_ = gnss_synchro;
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            acquisition_cc_->set_gnss_synchro(gnss_synchro_);
+        }
+}
+
+
+signed int GpsL1CaPcpsShiftedSpectrumAcquisition::mag()
+{
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            return acquisition_cc_->mag();
+        }
+    else
+        {
+            return 0;
+        }
+}
+
+
+void GpsL1CaPcpsShiftedSpectrumAcquisition::init()
+{
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            acquisition_cc_->init();
+        }
+
+    set_local_code();
+}
+
+
+void GpsL1CaPcpsShiftedSpectrumAcquisition::set_local_code()
+{
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            // The conjugated code spectrum is shared with the other PCPS channels
+            unsigned int prn = gnss_synchro_->PRN;
+            unsigned int code_length = code_length_;
+            unsigned int sampled_ms = sampled_ms_;
+            long fs_in = fs_in_;
+            acquisition_cc_->set_local_code_fft(Fft_Code_Cache::instance().get("1C", prn, fs_in_,
+                    acquisition_cc_->fft_size(), bit_transition_flag_ ? acquisition_cc_->fft_size() / 2 : 0,
+                    [prn, code_length, sampled_ms, fs_in](gr_complex* dest)
+                    {
+                        gps_l1_ca_code_gen_complex_sampled(dest, prn, fs_in, 0);
+                        for (unsigned int i = 1; i < sampled_ms; i++)
+                            {
+                                memcpy(&(dest[i*code_length]), dest, sizeof(gr_complex)*code_length);
+                            }
+                    }));
+        }
+}
+
+
+void GpsL1CaPcpsShiftedSpectrumAcquisition::reset()
+{
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            acquisition_cc_->set_active(true);
+        }
+}
+
+
+void GpsL1CaPcpsShiftedSpectrumAcquisition::set_state(int state)
+{
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            acquisition_cc_->set_state(state);
+        }
+}
+
+
+float GpsL1CaPcpsShiftedSpectrumAcquisition::calculate_threshold(float pfa)
+{
+    //Calculate the threshold
+    unsigned int frequency_bins = 0;
+    for (int doppler = (int)(-doppler_max_); doppler <= (int)doppler_max_; doppler += doppler_step_)
+        {
+            frequency_bins++;
+        }
+    DLOG(INFO) << "Channel " << channel_ << "  Pfa = " << pfa;
+    unsigned int ncells = vector_length_ * frequency_bins;
+    double exponent = 1 / static_cast<double>(ncells);
+    double val = pow(1.0 - pfa, exponent);
+    double lambda = double(vector_length_);
+    boost::math::exponential_distribution<double> mydist (lambda);
+    float threshold = (float)quantile(mydist,val);
+
+    return threshold;
+}
+
+
+void GpsL1CaPcpsShiftedSpectrumAcquisition::connect(gr::top_block_sptr top_block)
+{
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            top_block->connect(stream_to_vector_, 0, acquisition_cc_, 0);
+        }
+}
+
+
+void GpsL1CaPcpsShiftedSpectrumAcquisition::disconnect(gr::top_block_sptr top_block)
+{
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            top_block->disconnect(stream_to_vector_, 0, acquisition_cc_, 0);
+        }
+}
+
+
+gr::basic_block_sptr GpsL1CaPcpsShiftedSpectrumAcquisition::get_left_block()
+{
+    return stream_to_vector_;
+}
+
+
+gr::basic_block_sptr GpsL1CaPcpsShiftedSpectrumAcquisition::get_right_block()
+{
+    return acquisition_cc_;
+}
@@ -32,9 +32,12 @@
  */
 
 #include "gps_l2_m_pcps_acquisition.h"
+#include <boost/lexical_cast.hpp>
 #include <boost/math/distributions/exponential.hpp>
 #include <glog/logging.h>
 #include "gps_l2c_signal.h"
+#include "fft_code_cache.h"
+#include "gnss_code_bank.h"
 #include "GPS_L2C.h"
 #include "configuration_interface.h"
 
@@ -62,10 +65,16 @@ GpsL2MPcpsAcquisition::GpsL2MPcpsAcquisition(
 
     bit_transition_flag_ = configuration_->property(role + ".bit_transition_flag", false);
     use_CFAR_algorithm_flag_=configuration_->property(role + ".use_CFAR_algorithm", true); //will be false in future versions
+    fft_zero_padding_ = configuration_->property(role + ".fft_zero_padding", false);
+    dwell_accumulation_ = configuration_->property(role + ".dwell_accumulation", std::string("maximum"));
+    pipelined_ = configuration_->property(role + ".pipelined", false);
 
     max_dwells_ = configuration_->property(role + ".max_dwells", 1);
 
     dump_filename_ = configuration_->property(role + ".dump_filename", default_dump_filename);
+    dump_delay_decimation_ = configuration_->property(role + ".dump_delay_decimation", 1);
+    dump_roi_delays_ = configuration_->property(role + ".dump_roi_delays", 0);
+    dump_roi_doppler_bins_ = configuration_->property(role + ".dump_roi_doppler_bins", 0);
 
     //--- Find number of samples per spreading code -------------------------
     code_length_ = round(static_cast<double>(fs_in_)
@@ -85,19 +94,33 @@ GpsL2MPcpsAcquisition::GpsL2MPcpsAcquisition(
             item_size_ = sizeof(lv_16sc_t);
             acquisition_sc_ = pcps_make_acquisition_sc(1, max_dwells_,
                     doppler_max_, if_, fs_in_, code_length_, code_length_,
-                    bit_transition_flag_, use_CFAR_algorithm_flag_, dump_, dump_filename_);
+                    bit_transition_flag_, use_CFAR_algorithm_flag_, dump_, dump_filename_, item_size_);
             DLOG(INFO) << "acquisition(" << acquisition_sc_->unique_id() << ")";
 
         }else{
                 item_size_ = sizeof(gr_complex);
                 acquisition_cc_ = pcps_make_acquisition_cc(1, max_dwells_,
                         doppler_max_, if_, fs_in_, code_length_, code_length_,
-                        bit_transition_flag_, use_CFAR_algorithm_flag_, dump_, dump_filename_);
+                        bit_transition_flag_, use_CFAR_algorithm_flag_, fft_zero_padding_, dump_, dump_filename_);
                 DLOG(INFO) << "acquisition(" << acquisition_cc_->unique_id() << ")";
+                if (dwell_accumulation_.compare("noncoherent") == 0)
+                    {
+                        acquisition_cc_->set_dwell_accumulation(DWELL_NONCOHERENT);
+                    }
+                else if (dwell_accumulation_.compare("coherent") == 0)
+                    {
+                        acquisition_cc_->set_dwell_accumulation(DWELL_COHERENT);
+                    }
+                acquisition_cc_->set_pipelined(pipelined_);
+                acquisition_cc_->set_dump_options(dump_delay_decimation_, dump_roi_delays_, dump_roi_doppler_bins_);
+        }
+
+    // The gr_complex acquisition reads the sample stream directly
+    if (item_type_.compare("cshort") == 0)
+        {
+            stream_to_vector_ = gr::blocks::stream_to_vector::make(item_size_, vector_length_);
+            DLOG(INFO) << "stream_to_vector(" << stream_to_vector_->unique_id() << ")";
         }
-
-    stream_to_vector_ = gr::blocks::stream_to_vector::make(item_size_, vector_length_);
-    DLOG(INFO) << "stream_to_vector(" << stream_to_vector_->unique_id() << ")";
     
     if (item_type_.compare("cbyte") == 0)
         {
@@ -128,6 +151,9 @@ void GpsL2MPcpsAcquisition::set_channel(unsigned int channel)
     else
         {
             acquisition_cc_->set_channel(channel_);
+            unsigned int rf_channel = configuration_->property("GNSS-SDR.rf_channel_offset", 0u)
+                    + configuration_->property("Channel" + boost::lexical_cast<std::string>(channel_) + ".RF_channel_ID", 0);
+            acquisition_cc_->set_rf_channel(rf_channel);
         }
 }
 
@@ -240,15 +266,28 @@ void GpsL2MPcpsAcquisition::init()
 void GpsL2MPcpsAcquisition::set_local_code()
 {
 
-    gps_l2c_m_code_gen_complex_sampled(code_, gnss_synchro_->PRN, fs_in_);
-    
     if (item_type_.compare("cshort") == 0)
         {
+            unsigned int prn = gnss_synchro_->PRN;
+            long fs_in = fs_in_;
+            Gnss_Code_Bank::instance().copy(code_, "2S", prn, fs_in_, 0, code_length_,
+                    [prn, fs_in](gr_complex* dest)
+                    {
+                        gps_l2c_m_code_gen_complex_sampled(dest, prn, fs_in);
+                    });
             acquisition_sc_->set_local_code(code_);
         }
     else
         {
-            acquisition_cc_->set_local_code(code_);
+            // The conjugated code spectrum is shared by all the channels
+            unsigned int prn = gnss_synchro_->PRN;
+            long fs_in = fs_in_;
+            acquisition_cc_->set_local_code_fft(Fft_Code_Cache::instance().get("2S", prn, fs_in_,
+                    acquisition_cc_->fft_size(), acquisition_cc_->fft_code_offset(),
+                    [prn, fs_in](gr_complex* dest)
+                    {
+                        gps_l2c_m_code_gen_complex_sampled(dest, prn, fs_in);
+                    }));
         }
         
 //    //debug
@@ -315,7 +354,7 @@ void GpsL2MPcpsAcquisition::connect(gr::top_block_sptr top_block)
 {
     if (item_type_.compare("gr_complex") == 0)
         {
-            top_block->connect(stream_to_vector_, 0, acquisition_cc_, 0);
+            // acquisition_cc_ reads the samples in place, nothing to connect
         }
     else if (item_type_.compare("cshort") == 0)
         {
@@ -325,8 +364,7 @@ void GpsL2MPcpsAcquisition::connect(gr::top_block_sptr top_block)
         {
             top_block->connect(cbyte_to_float_x2_, 0, float_to_complex_, 0);
             top_block->connect(cbyte_to_float_x2_, 1, float_to_complex_, 1);
-            top_block->connect(float_to_complex_, 0, stream_to_vector_, 0);
-            top_block->connect(stream_to_vector_, 0, acquisition_cc_, 0);
+            top_block->connect(float_to_complex_, 0, acquisition_cc_, 0);
         }
     else
         {
@@ -339,7 +377,7 @@ void GpsL2MPcpsAcquisition::disconnect(gr::top_block_sptr top_block)
 {
     if (item_type_.compare("gr_complex") == 0)
         {
-            top_block->disconnect(stream_to_vector_, 0, acquisition_cc_, 0);
+            // acquisition_cc_ reads the samples in place, nothing to disconnect
         }
     else if (item_type_.compare("cshort") == 0)
         {
@@ -351,8 +389,7 @@ void GpsL2MPcpsAcquisition::disconnect(gr::top_block_sptr top_block)
             // we just convert cshorts to gr_complex
             top_block->disconnect(cbyte_to_float_x2_, 0, float_to_complex_, 0);
             top_block->disconnect(cbyte_to_float_x2_, 1, float_to_complex_, 1);
-            top_block->disconnect(float_to_complex_, 0, stream_to_vector_, 0);
-            top_block->disconnect(stream_to_vector_, 0, acquisition_cc_, 0);
+            top_block->disconnect(float_to_complex_, 0, acquisition_cc_, 0);
         }
     else
         {
@@ -365,7 +402,7 @@ gr::basic_block_sptr GpsL2MPcpsAcquisition::get_left_block()
 {
     if (item_type_.compare("gr_complex") == 0)
         {
-            return stream_to_vector_;
+            return acquisition_cc_;
         }
     else if (item_type_.compare("cshort") == 0)
         {
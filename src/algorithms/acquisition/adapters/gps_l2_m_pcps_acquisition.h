@@ -148,6 +148,9 @@ private:
     unsigned int code_length_;
     bool bit_transition_flag_;
     bool use_CFAR_algorithm_flag_;
+    bool fft_zero_padding_;
+    std::string dwell_accumulation_;
+    bool pipelined_;
     unsigned int channel_;
     float threshold_;
     unsigned int doppler_max_;
@@ -157,6 +160,9 @@ private:
     long if_;
     bool dump_;
     std::string dump_filename_;
+    unsigned int dump_delay_decimation_;
+    unsigned int dump_roi_delays_;
+    unsigned int dump_roi_doppler_bins_;
     std::complex<float> * code_;
     Gnss_Synchro * gnss_synchro_;
     std::string role_;
@@ -0,0 +1,274 @@
+/*!
+ * \file gps_l2_m_pcps_segmented_acquisition.cc
+ * \brief Adapts a PCPS acquisition block that correlates the code by
+ *  segments to an AcquisitionInterface for GPS L2 M signals
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gps_l2_m_pcps_segmented_acquisition.h"
+#include <vector>
+#include <boost/lexical_cast.hpp>
+#include <boost/math/distributions/gamma.hpp>
+#include <glog/logging.h>
+#include "gps_l2c_signal.h"
+#include "fft_code_cache.h"
+#include "GPS_L2C.h"
+#include "configuration_interface.h"
+
+
+using google::LogMessage;
+
+GpsL2MPcpsSegmentedAcquisition::GpsL2MPcpsSegmentedAcquisition(
+        ConfigurationInterface* configuration, std::string role,
+        unsigned int in_streams, unsigned int out_streams) :
+    role_(role), in_streams_(in_streams), out_streams_(out_streams)
+{
+    configuration_ = configuration;
+    std::string default_item_type = "gr_complex";
+    std::string default_dump_filename = "./data/acquisition.dat";
+
+    DLOG(INFO) << "role " << role;
+
+    item_type_ = configuration_->property(role + ".item_type", default_item_type);
+
+    fs_in_ = configuration_->property("GNSS-SDR.internal_fs_hz", 2048000);
+    if_ = configuration_->property(role + ".if", 0);
+    dump_ = configuration_->property(role + ".dump", false);
+    doppler_max_ = configuration_->property(role + ".doppler_max", 5000);
+    // 4 ms segments by default, for a Doppler step of about 2 / (3 * 4 ms) = 167 Hz
+    segments_ = configuration_->property(role + ".segments", 5);
+
+    use_CFAR_algorithm_flag_ = configuration_->property(role + ".use_CFAR_algorithm", true);
+
+    max_dwells_ = configuration_->property(role + ".max_dwells", 1);
+
+    dump_filename_ = configuration_->property(role + ".dump_filename", default_dump_filename);
+
+    //--- Find number of samples per spreading code -------------------------
+    code_length_ = round(static_cast<double>(fs_in_)
+            / (GPS_L2_M_CODE_RATE_HZ / static_cast<double>(GPS_L2_M_CODE_LENGTH_CHIPS)));
+
+    item_size_ = sizeof(gr_complex);
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            acquisition_cc_ = pcps_make_segmented_acquisition_cc(max_dwells_,
+                    doppler_max_, if_, fs_in_, code_length_, segments_,
+                    use_CFAR_algorithm_flag_, dump_, dump_filename_);
+            segments_ = acquisition_cc_->num_segments();
+
+            DLOG(INFO) << "acquisition(" << acquisition_cc_->unique_id() << ")";
+        }
+    else
+        {
+            LOG(WARNING) << item_type_ << " unknown acquisition item type";
+        }
+
+    channel_ = 0;
+    threshold_ = 0.0;
+    doppler_step_ = 0;
+    gnss_synchro_ = 0;
+}
+
+
+GpsL2MPcpsSegmentedAcquisition::~GpsL2MPcpsSegmentedAcquisition()
+{}
+
+
+void GpsL2MPcpsSegmentedAcquisition::set_channel(unsigned int channel)
+{
+    channel_ = channel;
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            acquisition_cc_->set_channel(channel_);
+        }
+}
+
+
+void GpsL2MPcpsSegmentedAcquisition::set_threshold(float threshold)
+{
+    float pfa = configuration_->property(role_ + ".pfa", 0.0);
+
+    if(pfa == 0.0)
+        {
+            threshold_ = threshold;
+        }
+    else
+        {
+            threshold_ = calculate_threshold(pfa);
+        }
+
+    DLOG(INFO) << "Channel " << channel_ << " Threshold = " << threshold_;
+
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            acquisition_cc_->set_threshold(threshold_);
+        }
+}
+
+
+void GpsL2MPcpsSegmentedAcquisition::set_doppler_max(unsigned int doppler_max)
+{
+    doppler_max_ = doppler_max;
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            acquisition_cc_->set_doppler_max(doppler_max_);
+        }
+}
+
+
+void GpsL2MPcpsSegmentedAcquisition::set_doppler_step(unsigned int doppler_step)
+{
+    doppler_step_ = doppler_step;
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            acquisition_cc_->set_doppler_step(doppler_step_);
+        }
+}
+
+
+void GpsL2MPcpsSegmentedAcquisition::set_gnss_synchro(Gnss_Synchro* gnss_synchro)
+{
+    gnss_synchro_ = gnss_synchro;
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            acquisition_cc_->set_gnss_synchro(gnss_synchro_);
+        }
+}
+
+
+signed int GpsL2MPcpsSegmentedAcquisition::mag()
+{
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            return acquisition_cc_->mag();
+        }
+    else
+        {
+            return 0;
+        }
+}
+
+
+void GpsL2MPcpsSegmentedAcquisition::init()
+{
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            acquisition_cc_->init();
+        }
+
+    set_local_code();
+}
+
+
+void GpsL2MPcpsSegmentedAcquisition::set_local_code()
+{
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            // The conjugated spectra of the code segments are shared by all the channels
+            unsigned int prn = gnss_synchro_->PRN;
+            unsigned int code_length = code_length_;
+            unsigned int segment_length = acquisition_cc_->segment_length();
+            long fs_in = fs_in_;
+            for (unsigned int segment = 0; segment < segments_; segment++)
+                {
+                    std::string signal = "2S_segment_" + boost::lexical_cast<std::string>(segment)
+                            + "_of_" + boost::lexical_cast<std::string>(segments_);
+                    acquisition_cc_->set_local_code_fft(segment, Fft_Code_Cache::instance().get(signal, prn, fs_in_,
+                            acquisition_cc_->fft_size(), segment_length,
+                            [prn, code_length, segment_length, segment, fs_in](gr_complex* dest)
+                            {
+                                std::vector<gr_complex> code(code_length);
+                                gps_l2c_m_code_gen_complex_sampled(code.data(), prn, fs_in);
+                                std::copy(code.begin() + segment * segment_length,
+                                        code.begin() + (segment + 1) * segment_length, dest);
+                            }));
+                }
+        }
+}
+
+
+void GpsL2MPcpsSegmentedAcquisition::reset()
+{
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            acquisition_cc_->set_active(true);
+        }
+}
+
+
+void GpsL2MPcpsSegmentedAcquisition::set_state(int state)
+{
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            acquisition_cc_->set_state(state);
+        }
+}
+
+
+float GpsL2MPcpsSegmentedAcquisition::calculate_threshold(float pfa)
+{
+    //Calculate the threshold
+    unsigned int frequency_bins = 0;
+    for (int doppler = static_cast<int>(-doppler_max_); doppler <= static_cast<int>(doppler_max_); doppler += doppler_step_)
+        {
+            frequency_bins++;
+        }
+    DLOG(INFO) << "Channel " << channel_ << "  Pfa = " << pfa;
+    unsigned int ncells = code_length_ * frequency_bins;
+    double exponent = 1.0 / static_cast<double>(ncells);
+    double val = pow(1.0 - pfa, exponent);
+    // The noise cells are the mean of one exponential variable of mean 1 / L per segment
+    double segment_length = static_cast<double>(code_length_ / segments_);
+    boost::math::gamma_distribution<double> mydist(static_cast<double>(segments_), 1.0 / (segment_length * static_cast<double>(segments_)));
+    float threshold = static_cast<float>(quantile(mydist, val));
+
+    return threshold;
+}
+
+
+void GpsL2MPcpsSegmentedAcquisition::connect(gr::top_block_sptr top_block __attribute__((unused)))
+{
+    // acquisition_cc_ reads the samples in place, nothing to connect
+}
+
+
+void GpsL2MPcpsSegmentedAcquisition::disconnect(gr::top_block_sptr top_block __attribute__((unused)))
+{
+    // acquisition_cc_ reads the samples in place, nothing to disconnect
+}
+
+
+gr::basic_block_sptr GpsL2MPcpsSegmentedAcquisition::get_left_block()
+{
+    return acquisition_cc_;
+}
+
+
+gr::basic_block_sptr GpsL2MPcpsSegmentedAcquisition::get_right_block()
+{
+    return acquisition_cc_;
+}
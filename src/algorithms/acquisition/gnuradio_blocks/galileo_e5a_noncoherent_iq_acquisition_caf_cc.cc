@@ -36,12 +36,19 @@
  */
 
 #include "galileo_e5a_noncoherent_iq_acquisition_caf_cc.h"
+#include <algorithm>
 #include <sstream>
+#include <boost/bind.hpp>
 #include <gnuradio/io_signature.h>
 #include <glog/logging.h>
 #include <volk/volk.h>
 #include <volk_gnsssdr/volk_gnsssdr.h>
+#include "acquisition_assistance.h"
 #include "control_message_factory.h"
+#include "fft_planner.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
+#include "gnss_sdr_task_pool.h"
 
 using google::LogMessage;
 
@@ -51,6 +58,7 @@ galileo_e5a_noncoherentIQ_acquisition_caf_cc_sptr galileo_e5a_noncoherentIQ_make
         unsigned int doppler_max, long freq, long fs_in,
         int samples_per_ms, int samples_per_code,
         bool bit_transition_flag,
+        unsigned int num_threads,
         bool dump,
         std::string dump_filename,
         bool both_signal_components_,
@@ -60,7 +68,7 @@ galileo_e5a_noncoherentIQ_acquisition_caf_cc_sptr galileo_e5a_noncoherentIQ_make
 
     return galileo_e5a_noncoherentIQ_acquisition_caf_cc_sptr(
             new galileo_e5a_noncoherentIQ_acquisition_caf_cc(sampled_ms, max_dwells, doppler_max, freq, fs_in, samples_per_ms,
-                    samples_per_code, bit_transition_flag, dump, dump_filename, both_signal_components_, CAF_window_hz_, Zero_padding_));
+                    samples_per_code, bit_transition_flag, num_threads, dump, dump_filename, both_signal_components_, CAF_window_hz_, Zero_padding_));
 }
 
 galileo_e5a_noncoherentIQ_acquisition_caf_cc::galileo_e5a_noncoherentIQ_acquisition_caf_cc(
@@ -69,6 +77,7 @@ galileo_e5a_noncoherentIQ_acquisition_caf_cc::galileo_e5a_noncoherentIQ_acquisit
         unsigned int doppler_max, long freq, long fs_in,
         int samples_per_ms, int samples_per_code,
         bool bit_transition_flag,
+        unsigned int num_threads,
         bool dump,
         std::string dump_filename,
         bool both_signal_components_,
@@ -89,6 +98,8 @@ galileo_e5a_noncoherentIQ_acquisition_caf_cc::galileo_e5a_noncoherentIQ_acquisit
     d_max_dwells = max_dwells;
     d_well_count = 0;
     d_doppler_max = doppler_max;
+    d_doppler_center = 0;
+    d_doppler_search_max = doppler_max;
     if (Zero_padding_ > 0)
         {
             d_sampled_ms = 1;
@@ -106,49 +117,67 @@ galileo_e5a_noncoherentIQ_acquisition_caf_cc::galileo_e5a_noncoherentIQ_acquisit
     d_both_signal_components = both_signal_components_;
     d_CAF_window_hz = CAF_window_hz_;
 
-    d_inbuffer = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-    d_fft_code_I_A = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-    d_magnitudeIA = static_cast<float*>(volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
+    d_inbuffer = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
+    d_fft_code_I_A = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
 
     if (d_both_signal_components == true)
         {
-            d_fft_code_Q_A = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-            d_magnitudeQA = static_cast<float*>(volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
+            d_fft_code_Q_A = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
         }
     else
         {
             d_fft_code_Q_A = 0;
-            d_magnitudeQA = 0;
         }
     // IF COHERENT INTEGRATION TIME > 1
     if (d_sampled_ms > 1)
         {
-            d_fft_code_I_B = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-            d_magnitudeIB = static_cast<float*>(volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
+            d_fft_code_I_B = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
             if (d_both_signal_components == true)
                 {
-                    d_fft_code_Q_B = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-                    d_magnitudeQB = static_cast<float*>(volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
+                    d_fft_code_Q_B = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
                 }
             else
                 {
                     d_fft_code_Q_B = 0;
-                    d_magnitudeQB = 0;
                 }
         }
     else
         {
             d_fft_code_I_B = 0;
-            d_magnitudeIB = 0;
             d_fft_code_Q_B = 0;
-            d_magnitudeQB = 0;
         }
 
     // Direct FFT
-    d_fft_if = new gr::fft::fft_complex(d_fft_size, true);
+    d_fft_if = new gr::fft::fft_complex(d_fft_size, true, Fft_Planner::instance().threads(d_fft_size));
 
     // Inverse FFT
-    d_ifft = new gr::fft::fft_complex(d_fft_size, false);
+    d_ifft = new gr::fft::fft_complex(d_fft_size, false, Fft_Planner::instance().threads(d_fft_size));
+    Gnss_Sdr_Memory_Accounting::add_fft(d_fft_size, 2);
+
+    // Doppler search workers, each one with its own FFT plans and magnitude buffers
+    d_num_threads = std::max(num_threads, 1u);
+    for (unsigned int worker = 0; worker < d_num_threads; worker++)
+        {
+            if (worker == 0)
+                {
+                    d_worker_fft_if.push_back(d_fft_if);
+                    d_worker_ifft.push_back(d_ifft);
+                }
+            else
+                {
+                    d_worker_fft_if.push_back(new gr::fft::fft_complex(d_fft_size, true));
+                    d_worker_ifft.push_back(new gr::fft::fft_complex(d_fft_size, false));
+                    Gnss_Sdr_Memory_Accounting::add_fft(d_fft_size, 2);
+                }
+            d_worker_magnitude_IA.push_back(static_cast<float*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(float), volk_get_alignment())));
+            d_worker_magnitude_IB.push_back(d_sampled_ms > 1 ?
+                    static_cast<float*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(float), volk_get_alignment())) : 0);
+            d_worker_magnitude_QA.push_back(d_both_signal_components ?
+                    static_cast<float*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(float), volk_get_alignment())) : 0);
+            d_worker_magnitude_QB.push_back((d_sampled_ms > 1 && d_both_signal_components) ?
+                    static_cast<float*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(float), volk_get_alignment())) : 0);
+        }
+    d_doppler_task_id = Gnss_Sdr_Task_Pool::task_id("acquisition_doppler_bins");
 
     // For dumping samples into a file
     d_dump = dump;
@@ -157,55 +186,42 @@ galileo_e5a_noncoherentIQ_acquisition_caf_cc::galileo_e5a_noncoherentIQ_acquisit
     d_doppler_resolution = 0;
     d_threshold = 0;
     d_doppler_step = 250;
-    d_grid_doppler_wipeoffs = 0;
     d_gnss_synchro = 0;
     d_code_phase = 0;
     d_doppler_freq = 0;
     d_test_statistics = 0;
-    d_CAF_vector = 0;
-    d_CAF_vector_I = 0;
-    d_CAF_vector_Q = 0;
     d_channel = 0;
     d_gr_stream_buffer = 0;
 }
 
 galileo_e5a_noncoherentIQ_acquisition_caf_cc::~galileo_e5a_noncoherentIQ_acquisition_caf_cc()
 {
-    if (d_num_doppler_bins > 0)
-        {
-            for (unsigned int i = 0; i < d_num_doppler_bins; i++)
-                {
-                    volk_free(d_grid_doppler_wipeoffs[i]);
-                }
-            delete[] d_grid_doppler_wipeoffs;
-        }
-
-    volk_free(d_inbuffer);
-    volk_free(d_fft_code_I_A);
-    volk_free(d_magnitudeIA);
+    gnss_sdr_volk_free(d_inbuffer);
+    gnss_sdr_volk_free(d_fft_code_I_A);
     if (d_both_signal_components == true)
         {
-            volk_free(d_fft_code_Q_A);
-            volk_free(d_magnitudeQA);
+            gnss_sdr_volk_free(d_fft_code_Q_A);
         }
     // IF INTEGRATION TIME > 1
     if (d_sampled_ms > 1)
         {
-            volk_free(d_fft_code_I_B);
-            volk_free(d_magnitudeIB);
+            gnss_sdr_volk_free(d_fft_code_I_B);
             if (d_both_signal_components == true)
                 {
-                    volk_free(d_fft_code_Q_B);
-                    volk_free(d_magnitudeQB);
+                    gnss_sdr_volk_free(d_fft_code_Q_B);
                 }
         }
-    if (d_CAF_window_hz > 0)
+
+    for (unsigned int worker = 0; worker < d_num_threads; worker++)
         {
-            volk_free(d_CAF_vector);
-            volk_free(d_CAF_vector_I);
-            if (d_both_signal_components == true)
+            gnss_sdr_volk_free(d_worker_magnitude_IA[worker]);
+            if (d_worker_magnitude_IB[worker]) gnss_sdr_volk_free(d_worker_magnitude_IB[worker]);
+            if (d_worker_magnitude_QA[worker]) gnss_sdr_volk_free(d_worker_magnitude_QA[worker]);
+            if (d_worker_magnitude_QB[worker]) gnss_sdr_volk_free(d_worker_magnitude_QB[worker]);
+            if (worker > 0)
                 {
-                    volk_free(d_CAF_vector_Q);
+                    delete d_worker_ifft[worker];
+                    delete d_worker_fft_if[worker];
                 }
         }
 
@@ -282,41 +298,54 @@ void galileo_e5a_noncoherentIQ_acquisition_caf_cc::init()
     d_gnss_synchro->Acq_samplestamp_samples = 0;
     d_mag = 0.0;
     d_input_power = 0.0;
-    const double GALILEO_TWO_PI = 6.283185307179600;
+
+    update_doppler_window(true);
+}
+
+
+void galileo_e5a_noncoherentIQ_acquisition_caf_cc::update_doppler_window(bool force)
+{
+    int doppler_center = 0;
+    unsigned int doppler_search_max = d_doppler_max;
+    if (d_gnss_synchro != 0)
+        {
+            Acquisition_Assistance::doppler_window(*d_gnss_synchro, d_doppler_max, d_doppler_step,
+                    doppler_center, doppler_search_max);
+            // the CAF filter needs its whole window inside the grid
+            unsigned int caf_search_max = d_CAF_window_hz > 0 ? static_cast<unsigned int>(d_CAF_window_hz) : 0;
+            if (doppler_search_max < caf_search_max)
+                {
+                    doppler_search_max = std::min(d_doppler_max, (caf_search_max + d_doppler_step - 1) / d_doppler_step * d_doppler_step);
+                }
+        }
+    if (!force && doppler_center == d_doppler_center && doppler_search_max == d_doppler_search_max)
+        {
+            return;
+        }
+    d_doppler_center = doppler_center;
+    d_doppler_search_max = doppler_search_max;
 
     // Count the number of bins
     d_num_doppler_bins = 0;
-    for (int doppler = static_cast<int>(-d_doppler_max);
-            doppler <= static_cast<int>(d_doppler_max);
+    for (int doppler = static_cast<int>(-d_doppler_search_max);
+            doppler <= static_cast<int>(d_doppler_search_max);
             doppler += d_doppler_step)
         {
             d_num_doppler_bins++;
         }
 
-    // Create the carrier Doppler wipeoff signals
-    d_grid_doppler_wipeoffs = new gr_complex*[d_num_doppler_bins];
-    for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
-        {
-            d_grid_doppler_wipeoffs[doppler_index] = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-            int doppler = -static_cast<int>(d_doppler_max) + d_doppler_step * doppler_index;
-            float phase_step_rad = GALILEO_TWO_PI * (d_freq + doppler) / static_cast<float>(d_fs_in);
-            float _phase[1];
-            _phase[0] = 0;
-            volk_gnsssdr_s32f_sincos_32fc(d_grid_doppler_wipeoffs[doppler_index], - phase_step_rad, _phase, d_fft_size);
-        }
+    // Get the carrier Doppler wipeoff signals, shared with the other channels
+    d_grid_doppler_wipeoffs = Doppler_Grid_Store::instance().get(d_fs_in, d_freq + d_doppler_center,
+            d_fft_size, d_doppler_search_max, d_doppler_step, d_num_doppler_bins);
+
+    d_bin_mag.assign(d_num_doppler_bins, 0.0);
+    d_bin_code_phase.assign(d_num_doppler_bins, 0);
 
     /* CAF Filtering to resolve doppler ambiguity. Phase and quadrature must be processed
      * separately before non-coherent integration */
-    //    if (d_CAF_filter)
-    if (d_CAF_window_hz > 0)
-        {
-            d_CAF_vector = static_cast<float*>(volk_malloc(d_num_doppler_bins * sizeof(float), volk_get_alignment()));
-            d_CAF_vector_I = static_cast<float*>(volk_malloc(d_num_doppler_bins * sizeof(float), volk_get_alignment()));
-            if (d_both_signal_components == true)
-                {
-                    d_CAF_vector_Q = static_cast<float*>(volk_malloc(d_num_doppler_bins * sizeof(float), volk_get_alignment()));
-                }
-        }
+    d_CAF_vector.assign(d_num_doppler_bins, 0.0);
+    d_CAF_vector_I.assign(d_num_doppler_bins, 0.0);
+    d_CAF_vector_Q.assign(d_num_doppler_bins, 0.0);
 }
 
 
@@ -345,10 +374,143 @@ void galileo_e5a_noncoherentIQ_acquisition_caf_cc::set_state(int state)
 
 
 
+void galileo_e5a_noncoherentIQ_acquisition_caf_cc::search_doppler_bins(unsigned int worker)
+{
+#if VOLK_GT_122
+    uint16_t indext = 0;
+    uint16_t indext_IA = 0;
+    uint16_t indext_IB = 0;
+    uint16_t indext_QA = 0;
+    uint16_t indext_QB = 0;
+#else
+    unsigned int indext = 0;
+    unsigned int indext_IA = 0;
+    unsigned int indext_IB = 0;
+    unsigned int indext_QA = 0;
+    unsigned int indext_QB = 0;
+#endif
+    float magt_IA = 0.0;
+    float magt_IB = 0.0;
+    float magt_QA = 0.0;
+    float magt_QB = 0.0;
+    float fft_normalization_factor = static_cast<float>(d_fft_size) * static_cast<float>(d_fft_size);
+    gr::fft::fft_complex* fft_if = d_worker_fft_if[worker];
+    gr::fft::fft_complex* ifft = d_worker_ifft[worker];
+    float* magnitudeIA = d_worker_magnitude_IA[worker];
+    float* magnitudeIB = d_worker_magnitude_IB[worker];
+    float* magnitudeQA = d_worker_magnitude_QA[worker];
+    float* magnitudeQB = d_worker_magnitude_QB[worker];
+
+    // Contiguous chunk of Doppler bins assigned to this worker
+    unsigned int first_bin = (d_num_doppler_bins * worker) / d_num_threads;
+    unsigned int last_bin = (d_num_doppler_bins * (worker + 1)) / d_num_threads;
+
+    for (unsigned int doppler_index = first_bin; doppler_index < last_bin; doppler_index++)
+        {
+            volk_32fc_x2_multiply_32fc(fft_if->get_inbuf(), d_inbuffer,
+                    d_grid_doppler_wipeoffs->wipeoff(doppler_index), d_fft_size);
+
+            // Perform the FFT-based convolution  (parallel time search)
+            // Compute the FFT of the carrier wiped--off incoming signal, once for all the codes
+            fft_if->execute();
+
+            // CODE IA
+            // Multiply carrier wiped--off, Fourier transformed incoming signal
+            // with the local FFT'd code reference using SIMD operations with VOLK library
+            volk_32fc_x2_multiply_32fc(ifft->get_inbuf(),
+                    fft_if->get_outbuf(), d_fft_code_I_A, d_fft_size);
+
+            // compute the inverse FFT
+            ifft->execute();
+
+            // Search maximum
+            volk_32fc_magnitude_squared_32f(magnitudeIA, ifft->get_outbuf(), d_fft_size);
+            volk_32f_index_max_16u(&indext_IA, magnitudeIA, d_fft_size);
+            magt_IA = magnitudeIA[indext_IA];
+
+            if (d_both_signal_components == true)
+                {
+                    // REPEAT FOR ALL CODES. CODE_QA
+                    volk_32fc_x2_multiply_32fc(ifft->get_inbuf(),
+                            fft_if->get_outbuf(), d_fft_code_Q_A, d_fft_size);
+                    ifft->execute();
+                    volk_32fc_magnitude_squared_32f(magnitudeQA, ifft->get_outbuf(), d_fft_size);
+                    volk_32f_index_max_16u(&indext_QA, magnitudeQA, d_fft_size);
+                    magt_QA = magnitudeQA[indext_QA];
+                }
+            if (d_sampled_ms > 1) // If Integration time > 1 code
+                {
+                    // REPEAT FOR ALL CODES. CODE_IB
+                    volk_32fc_x2_multiply_32fc(ifft->get_inbuf(),
+                            fft_if->get_outbuf(), d_fft_code_I_B, d_fft_size);
+                    ifft->execute();
+                    volk_32fc_magnitude_squared_32f(magnitudeIB, ifft->get_outbuf(), d_fft_size);
+                    volk_32f_index_max_16u(&indext_IB, magnitudeIB, d_fft_size);
+                    magt_IB = magnitudeIB[indext_IB];
+
+                    if (d_both_signal_components == true)
+                        {
+                            // REPEAT FOR ALL CODES. CODE_QB
+                            volk_32fc_x2_multiply_32fc(ifft->get_inbuf(),
+                                    fft_if->get_outbuf(), d_fft_code_Q_B, d_fft_size);
+                            ifft->execute();
+                            volk_32fc_magnitude_squared_32f(magnitudeQB, ifft->get_outbuf(), d_fft_size);
+                            volk_32f_index_max_16u(&indext_QB, magnitudeQB, d_fft_size);
+                            magt_QB = magnitudeQB[indext_QB];
+                        }
+                }
+
+            // Keep the best secondary code hypothesis of each component.
+            // If CAF filter to resolve doppler ambiguity is needed,
+            // peak is stored before non-coherent integration.
+            float* magnitudeI = magnitudeIA;
+            if (d_sampled_ms > 1 && magt_IA < magt_IB)
+                {
+                    magnitudeI = magnitudeIB;
+                }
+            d_CAF_vector_I[doppler_index] = std::max(magt_IA, magt_IB);
+            if (d_both_signal_components)
+                {
+                    float* magnitudeQ = magnitudeQA;
+                    if (d_sampled_ms > 1 && magt_QA < magt_QB)
+                        {
+                            magnitudeQ = magnitudeQB;
+                        }
+                    d_CAF_vector_Q[doppler_index] = std::max(magt_QA, magt_QB);
+
+                    // Integrate noncoherently the two best combinations (I² + Q²)
+                    // and store the result in the I channel.
+                    volk_32f_x2_add_32f(magnitudeI, magnitudeI, magnitudeQ, d_fft_size);
+                }
+            volk_32f_index_max_16u(&indext, magnitudeI, d_fft_size);
+
+            // Normalize the maximum value to correct the scale factor introduced by FFTW
+            d_bin_mag[doppler_index] = magnitudeI[indext] / (fft_normalization_factor * fft_normalization_factor);
+            d_bin_code_phase[doppler_index] = indext;
+
+            // Record results to file if required
+            if (d_dump)
+                {
+                    std::stringstream filename;
+                    std::ofstream dump_file;
+                    std::streamsize n = sizeof(float) * (d_fft_size); // noncomplex file write
+                    filename.str("");
+                    filename << "../data/test_statistics_E5a_sat_"
+                            << d_gnss_synchro->PRN << "_doppler_" << d_grid_doppler_wipeoffs->doppler(doppler_index) << ".dat";
+                    dump_file.open(filename.str().c_str(), std::ios::out | std::ios::binary);
+                    dump_file.write((char*)magnitudeI, n);
+                    dump_file.close();
+                }
+        }
+}
+
+
+
 int galileo_e5a_noncoherentIQ_acquisition_caf_cc::general_work(int noutput_items,
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items __attribute__((unused)))
 {
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("galileo_e5a_noncoherentIQ_acquisition_caf_cc::general_work", d_channel, d_gnss_synchro ? d_gnss_synchro->PRN : 0);
     /*
      * By J.Arribas, L.Esteve, M.Molina and M.Sales
      * Acquisition strategy (Kay Borre book + CFAR threshold):
@@ -382,6 +544,7 @@ int galileo_e5a_noncoherentIQ_acquisition_caf_cc::general_work(int noutput_items
                     d_mag = 0.0;
                     d_input_power = 0.0;
                     d_test_statistics = 0.0;
+                    update_doppler_window(false);
                     d_state = 1;
                 }
             d_sample_counter += ninput_items[0]; // sample counter
@@ -426,23 +589,9 @@ int galileo_e5a_noncoherentIQ_acquisition_caf_cc::general_work(int noutput_items
             int doppler;
 #if VOLK_GT_122
             uint16_t indext = 0;
-            uint16_t indext_IA = 0;
-            uint16_t indext_IB = 0;
-            uint16_t indext_QA = 0;
-            uint16_t indext_QB = 0;
 #else
             unsigned int indext = 0;
-            unsigned int indext_IA = 0;
-            unsigned int indext_IB = 0;
-            unsigned int indext_QA = 0;
-            unsigned int indext_QB = 0;
 #endif
-            float magt = 0.0;
-            float magt_IA = 0.0;
-            float magt_IB = 0.0;
-            float magt_QA = 0.0;
-            float magt_QB = 0.0;
-            float fft_normalization_factor = static_cast<float>(d_fft_size) * static_cast<float>(d_fft_size);
             d_input_power = 0.0;
             d_mag = 0.0;
             d_well_count++;
@@ -450,157 +599,27 @@ int galileo_e5a_noncoherentIQ_acquisition_caf_cc::general_work(int noutput_items
             DLOG(INFO) << "Channel: " << d_channel
                     << " , doing acquisition of satellite: " << d_gnss_synchro->System << " "<< d_gnss_synchro->PRN
                     << " ,sample stamp: " << d_sample_counter << ", threshold: "
-                    << d_threshold << ", doppler_max: " << d_doppler_max
+                    << d_threshold << ", doppler search: " << d_doppler_center << " +/- " << d_doppler_search_max
                     << ", doppler_step: " << d_doppler_step;
 
             // 1- Compute the input signal power estimation
-            volk_32fc_magnitude_squared_32f(d_magnitudeIA, d_inbuffer, d_fft_size);
-            volk_32f_accumulator_s32f(&d_input_power, d_magnitudeIA, d_fft_size);
+            volk_32fc_magnitude_squared_32f(d_worker_magnitude_IA[0], d_inbuffer, d_fft_size);
+            volk_32f_accumulator_s32f(&d_input_power, d_worker_magnitude_IA[0], d_fft_size);
             d_input_power /= static_cast<float>(d_fft_size);
 
-            // 2- Doppler frequency search loop
-            for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+            // 2- Doppler frequency search, split in chunks run by the task pool. This thread takes the first chunk.
+            Gnss_Sdr_Task_Group workers(d_doppler_task_id);
+            for (unsigned int worker = 1; worker < d_num_threads; worker++)
                 {
-                    // doppler search steps
-
-                    doppler = -static_cast<int>(d_doppler_max) + d_doppler_step * doppler_index;
-
-                    volk_32fc_x2_multiply_32fc(d_fft_if->get_inbuf(), d_inbuffer,
-                            d_grid_doppler_wipeoffs[doppler_index], d_fft_size);
-
-                    // 3- Perform the FFT-based convolution  (parallel time search)
-                    // Compute the FFT of the carrier wiped--off incoming signal
-                    d_fft_if->execute();
-
-                    // CODE IA
-                    // Multiply carrier wiped--off, Fourier transformed incoming signal
-                    // with the local FFT'd code reference using SIMD operations with VOLK library
-                    volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(),
-                            d_fft_if->get_outbuf(), d_fft_code_I_A, d_fft_size);
-
-                    // compute the inverse FFT
-                    d_ifft->execute();
-
-                    // Search maximum
-                    volk_32fc_magnitude_squared_32f(d_magnitudeIA, d_ifft->get_outbuf(), d_fft_size);
-                    volk_32f_index_max_16u(&indext_IA, d_magnitudeIA, d_fft_size);
-                    // Normalize the maximum value to correct the scale factor introduced by FFTW
-                    magt_IA = d_magnitudeIA[indext_IA] / (fft_normalization_factor * fft_normalization_factor);
-
-                    if (d_both_signal_components == true)
-                        {
-                            // REPEAT FOR ALL CODES. CODE_QA
-                            volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(),
-                                    d_fft_if->get_outbuf(), d_fft_code_Q_A, d_fft_size);
-                            d_ifft->execute();
-                            volk_32fc_magnitude_squared_32f(d_magnitudeQA, d_ifft->get_outbuf(), d_fft_size);
-                            volk_32f_index_max_16u(&indext_QA, d_magnitudeQA, d_fft_size);
-                            magt_QA = d_magnitudeQA[indext_QA] / (fft_normalization_factor * fft_normalization_factor);
-                        }
-                    if (d_sampled_ms > 1) // If Integration time > 1 code
-                        {
-                            // REPEAT FOR ALL CODES. CODE_IB
-                            volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(),
-                                    d_fft_if->get_outbuf(), d_fft_code_I_B, d_fft_size);
-                            d_ifft->execute();
-                            volk_32fc_magnitude_squared_32f(d_magnitudeIB, d_ifft->get_outbuf(), d_fft_size);
-                            volk_32f_index_max_16u(&indext_IB, d_magnitudeIB, d_fft_size);
-                            magt_IB = d_magnitudeIB[indext_IB] / (fft_normalization_factor * fft_normalization_factor);
-
-                            if (d_both_signal_components == true)
-                                {
-                                    // REPEAT FOR ALL CODES. CODE_QB
-                                    volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(),
-                                            d_fft_if->get_outbuf(), d_fft_code_Q_B, d_fft_size);
-                                    d_ifft->execute();
-                                    volk_32fc_magnitude_squared_32f(d_magnitudeQB, d_ifft->get_outbuf(), d_fft_size);
-                                    volk_32f_index_max_16u(&indext_QB, d_magnitudeQB, d_fft_size);
-                                    magt_QB = d_magnitudeIB[indext_QB] / (fft_normalization_factor * fft_normalization_factor);
-                                }
-                        }
+                    workers.run(boost::bind(&galileo_e5a_noncoherentIQ_acquisition_caf_cc::search_doppler_bins, this, worker));
+                }
+            search_doppler_bins(0);
+            workers.wait();
 
-                    // Integrate noncoherently the two best combinations (I² + Q²)
-                    // and store the result in the I channel.
-                    // If CAF filter to resolve doppler ambiguity is needed,
-                    // peak is stored before non-coherent integration.
-                    if (d_sampled_ms > 1) // T_integration > 1 code
-                        {
-                            if (magt_IA >= magt_IB)
-                                {
-                                    // if (d_CAF_filter) {d_CAF_vector_I[doppler_index] = magt_IA;}
-                                    if (d_CAF_window_hz > 0) {d_CAF_vector_I[doppler_index] = d_magnitudeIA[indext_IA];}
-                                    if (d_both_signal_components)
-                                        {
-                                            // Integrate non-coherently I+Q
-                                            if (magt_QA >= magt_QB)
-                                                {
-                                                    // if (d_CAF_filter) {d_CAF_vector_Q[doppler_index] = magt_QA;}
-                                                    if (d_CAF_window_hz > 0) {d_CAF_vector_Q[doppler_index] = d_magnitudeQA[indext_QA];}
-                                                    for (unsigned int i=0; i<d_fft_size; i++)
-                                                        {
-                                                            d_magnitudeIA[i] += d_magnitudeQA[i];
-                                                        }
-                                                }
-                                            else
-                                                {
-                                                    // if (d_CAF_filter) {d_CAF_vector_Q[doppler_index] = magt_QB;}
-                                                    if (d_CAF_window_hz > 0) {d_CAF_vector_Q[doppler_index] = d_magnitudeQB[indext_QB];}
-                                                    for (unsigned int i=0; i<d_fft_size; i++)
-                                                        {
-                                                            d_magnitudeIA[i] += d_magnitudeQB[i];
-                                                        }
-                                                }
-                                        }
-                                    volk_32f_index_max_16u(&indext, d_magnitudeIA, d_fft_size);
-                                    magt = d_magnitudeIA[indext] / (fft_normalization_factor * fft_normalization_factor);
-                                }
-                            else
-                                {
-                                    // if (d_CAF_filter) {d_CAF_vector_I[doppler_index] = magt_IB;}
-                                    if (d_CAF_window_hz > 0) {d_CAF_vector_I[doppler_index] = d_magnitudeIB[indext_IB];}
-                                    if (d_both_signal_components)
-                                        {
-                                            // Integrate non-coherently I+Q
-                                            if (magt_QA >= magt_QB)
-                                                {
-                                                    //if (d_CAF_filter) {d_CAF_vector_Q[doppler_index] = magt_QA;}
-                                                    if (d_CAF_window_hz > 0) {d_CAF_vector_Q[doppler_index] = d_magnitudeQA[indext_QA];}
-                                                    for (unsigned int i=0; i<d_fft_size; i++)
-                                                        {
-                                                            d_magnitudeIB[i] += d_magnitudeQA[i];
-                                                        }
-                                                }
-                                            else
-                                                {
-                                                    // if (d_CAF_filter) {d_CAF_vector_Q[doppler_index] = magt_QB;}
-                                                    if (d_CAF_window_hz > 0) {d_CAF_vector_Q[doppler_index] = d_magnitudeQB[indext_QB];}
-                                                    for (unsigned int i=0; i<d_fft_size; i++)
-                                                        {
-                                                            d_magnitudeIB[i] += d_magnitudeQB[i];
-                                                        }
-                                                }
-                                        }
-                                    volk_32f_index_max_16u(&indext, d_magnitudeIB, d_fft_size);
-                                    magt = d_magnitudeIB[indext] / (fft_normalization_factor * fft_normalization_factor);
-                                }
-                        }
-                    else
-                        {
-                            // if (d_CAF_filter) {d_CAF_vector_I[doppler_index] = magt_IA;}
-                            if (d_CAF_window_hz > 0) {d_CAF_vector_I[doppler_index] = d_magnitudeIA[indext_IA];}
-                            if (d_both_signal_components)
-                                {
-                                    // if (d_CAF_filter) {d_CAF_vector_Q[doppler_index] = magt_QA;}
-                                    if (d_CAF_window_hz > 0) {d_CAF_vector_Q[doppler_index] = d_magnitudeQA[indext_QA];}
-                                    // NON-Coherent integration of only 1 code
-                                    for (unsigned int i=0; i<d_fft_size; i++)
-                                        {
-                                            d_magnitudeIA[i] += d_magnitudeQA[i];
-                                        }
-                                }
-                            volk_32f_index_max_16u(&indext, d_magnitudeIA, d_fft_size);
-                            magt = d_magnitudeIA[indext] / (fft_normalization_factor * fft_normalization_factor);
-                        }
+            // 3- Reduce the per-bin peaks in bin order, as a serial search would do
+            for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+                {
+                    float magt = d_bin_mag[doppler_index];
 
                     // 4- record the maximum peak and the associated synchronization parameters
                     if (d_mag < magt)
@@ -615,48 +634,21 @@ int galileo_e5a_noncoherentIQ_acquisition_caf_cc::general_work(int noutput_items
                             // restarted between consecutive dwells in multidwell operation.
                             if (d_test_statistics < (d_mag / d_input_power) || !d_bit_transition_flag)
                                 {
-                                    d_gnss_synchro->Acq_delay_samples = static_cast<double>(indext % d_samples_per_code);
-                                    d_gnss_synchro->Acq_doppler_hz = static_cast<double>(doppler);
+                                    d_gnss_synchro->Acq_delay_samples = static_cast<double>(d_bin_code_phase[doppler_index] % d_samples_per_code);
+                                    d_gnss_synchro->Acq_doppler_hz = static_cast<double>(d_doppler_center + d_grid_doppler_wipeoffs->doppler(doppler_index));
                                     d_gnss_synchro->Acq_samplestamp_samples = d_sample_counter;
 
                                     // 5- Compute the test statistics and compare to the threshold
                                     d_test_statistics = d_mag / d_input_power;
                                 }
                         }
-
-                    // Record results to file if required
-                    if (d_dump)
-                        {
-                            std::stringstream filename;
-                            std::streamsize n = sizeof(float) * (d_fft_size); // noncomplex file write
-                            filename.str("");
-                            filename << "../data/test_statistics_E5a_sat_"
-                                    << d_gnss_synchro->PRN << "_doppler_" <<  doppler << ".dat";
-                            d_dump_file.open(filename.str().c_str(), std::ios::out | std::ios::binary);
-                            if (d_sampled_ms > 1) // If integration time > 1 code
-                                {
-                                    if (magt_IA >= magt_IB)
-                                        {
-                                            d_dump_file.write((char*)d_magnitudeIA, n);
-                                        }
-                                    else
-                                        {
-                                            d_dump_file.write((char*)d_magnitudeIB, n);
-                                        }
-                                }
-                            else
-                                {
-                                    d_dump_file.write((char*)d_magnitudeIA, n);
-                                }
-                            d_dump_file.close();
-                        }
                 }
             // std::cout << "d_mag " << d_mag << ".d_sample_counter " << d_sample_counter << ". acq delay " << d_gnss_synchro->Acq_delay_samples<< " indext "<< indext << std::endl;
             // 6 OPTIONAL: CAF filter to avoid Doppler ambiguity in bit transition.
             if (d_CAF_window_hz > 0)
                 {
                     int CAF_bins_half;
-                    float* accum = static_cast<float*>(volk_malloc(sizeof(float), volk_get_alignment()));
+                    float* accum = static_cast<float*>(gnss_sdr_volk_malloc(sizeof(float), volk_get_alignment()));
                     CAF_bins_half = d_CAF_window_hz / (2 * d_doppler_step);
                     float weighting_factor;
                     weighting_factor = 0.5 / static_cast<float>(CAF_bins_half);
@@ -736,8 +728,8 @@ int galileo_e5a_noncoherentIQ_acquisition_caf_cc::general_work(int noutput_items
                         }
 
                     // Recompute the maximum doppler peak
-                    volk_32f_index_max_16u(&indext, d_CAF_vector, d_num_doppler_bins);
-                    doppler = -static_cast<int>(d_doppler_max) + d_doppler_step * indext;
+                    volk_32f_index_max_16u(&indext, d_CAF_vector.data(), d_num_doppler_bins);
+                    doppler = d_doppler_center + d_grid_doppler_wipeoffs->doppler(indext);
                     d_gnss_synchro->Acq_doppler_hz = static_cast<double>(doppler);
                     // Dump if required, appended at the end of the file
                     if (d_dump)
@@ -747,10 +739,10 @@ int galileo_e5a_noncoherentIQ_acquisition_caf_cc::general_work(int noutput_items
                             filename.str("");
                             filename << "../data/test_statistics_E5a_sat_" << d_gnss_synchro->PRN << "_CAF.dat";
                             d_dump_file.open(filename.str().c_str(), std::ios::out | std::ios::binary);
-                            d_dump_file.write((char*)d_CAF_vector, n);
+                            d_dump_file.write((char*)d_CAF_vector.data(), n);
                             d_dump_file.close();
                         }
-                    volk_free(accum);
+                    gnss_sdr_volk_free(accum);
                 }
 
             if (d_well_count == d_max_dwells)
@@ -39,11 +39,14 @@
 #define GALILEO_E5A_NONCOHERENT_IQ_ACQUISITION_CAF_CC_H_
 
 #include <fstream>
+#include <memory>
 #include <string>
+#include <vector>
 #include <gnuradio/block.h>
 #include <gnuradio/gr_complex.h>
 #include <gnuradio/fft/fft.h>
 #include "gnss_synchro.h"
+#include "doppler_grid_store.h"
 
 class galileo_e5a_noncoherentIQ_acquisition_caf_cc;
 
@@ -55,6 +58,7 @@ galileo_e5a_noncoherentIQ_make_acquisition_caf_cc(unsigned int sampled_ms,
                          unsigned int doppler_max, long freq, long fs_in,
                          int samples_per_ms, int samples_per_code,
                          bool bit_transition_flag,
+                         unsigned int num_threads,
                          bool dump,
                          std::string dump_filename,
                          bool both_signal_components_,
@@ -66,6 +70,13 @@ galileo_e5a_noncoherentIQ_make_acquisition_caf_cc(unsigned int sampled_ms,
  *
  * Check \ref Navitec2012 "An Open Source Galileo E1 Software Receiver",
  * Algorithm 1, for a pseudocode description of this implementation.
+ *
+ * The input of each Doppler bin is Fourier transformed once and correlated
+ * with the data and pilot codes of both secondary code hypotheses. The bins
+ * are split in contiguous chunks among num_threads tasks of the shared
+ * Gnss_Sdr_Task_Pool, each one with its own FFT plans and magnitude buffers,
+ * and the per-bin peaks are reduced afterwards in bin order, so the result
+ * does not depend on the number of workers.
  */
 class galileo_e5a_noncoherentIQ_acquisition_caf_cc: public gr::block
 {
@@ -77,6 +88,7 @@ private:
             unsigned int doppler_max, long freq, long fs_in,
             int samples_per_ms, int samples_per_code,
             bool bit_transition_flag,
+            unsigned int num_threads,
             bool dump,
             std::string dump_filename,
             bool both_signal_components_,
@@ -89,6 +101,7 @@ private:
             unsigned int doppler_max, long freq, long fs_in,
             int samples_per_ms, int samples_per_code,
             bool bit_transition_flag,
+            unsigned int num_threads,
             bool dump,
             std::string dump_filename,
             bool both_signal_components_,
@@ -99,6 +112,11 @@ private:
             int doppler_offset);
     float estimate_input_power(gr_complex *in );
 
+    void search_doppler_bins(unsigned int worker);
+
+    // Sets the Doppler grid around the window of Acquisition_Assistance, if it changed
+    void update_doppler_window(bool force);
+
     long d_fs_in;
     long d_freq;
     int d_samples_per_ms;
@@ -109,11 +127,13 @@ private:
     std::string d_satellite_str;
     unsigned int d_doppler_max;
     unsigned int d_doppler_step;
+    int d_doppler_center;              // Centre of the Doppler search, from Acquisition_Assistance [Hz]
+    unsigned int d_doppler_search_max; // Half width of the Doppler search, at most d_doppler_max [Hz]
     unsigned int d_max_dwells;
     unsigned int d_well_count;
     unsigned int d_fft_size;
     unsigned long int d_sample_counter;
-    gr_complex** d_grid_doppler_wipeoffs;
+    std::shared_ptr<const Doppler_Grid> d_grid_doppler_wipeoffs;
     unsigned int d_num_doppler_bins;
     gr_complex* d_fft_code_I_A;
     gr_complex* d_fft_code_I_B;
@@ -126,10 +146,6 @@ private:
     unsigned int d_code_phase;
     float d_doppler_freq;
     float d_mag;
-    float* d_magnitudeIA;
-    float* d_magnitudeIB;
-    float* d_magnitudeQA;
-    float* d_magnitudeQB;
     float d_input_power;
     float d_test_statistics;
     bool d_bit_transition_flag;
@@ -140,9 +156,9 @@ private:
     bool d_both_signal_components;
 //    bool d_CAF_filter;
     int d_CAF_window_hz;
-    float* d_CAF_vector;
-    float* d_CAF_vector_I;
-    float* d_CAF_vector_Q;
+    std::vector<float> d_CAF_vector;
+    std::vector<float> d_CAF_vector_I;    // Peak of the best data code hypothesis of each Doppler bin
+    std::vector<float> d_CAF_vector_Q;    // Peak of the best pilot code hypothesis of each Doppler bin
 //    double* d_CAF_vector;
 //    double* d_CAF_vector_I;
 //    double* d_CAF_vector_Q;
@@ -150,6 +166,16 @@ private:
     std::string d_dump_filename;
     unsigned int d_buffer_count;
     unsigned int d_gr_stream_buffer;
+    unsigned int d_num_threads;
+    std::vector<gr::fft::fft_complex*> d_worker_fft_if;   // Worker 0 uses d_fft_if
+    std::vector<gr::fft::fft_complex*> d_worker_ifft;     // Worker 0 uses d_ifft
+    std::vector<float*> d_worker_magnitude_IA;
+    std::vector<float*> d_worker_magnitude_IB;            // Only with more than 1 code
+    std::vector<float*> d_worker_magnitude_QA;            // Only with both signal components
+    std::vector<float*> d_worker_magnitude_QB;
+    unsigned int d_doppler_task_id;                       // for the metrics of the task pool
+    std::vector<float> d_bin_mag;                         // Normalized peak of each Doppler bin
+    std::vector<unsigned int> d_bin_code_phase;           // Position of the peak of each Doppler bin
 
 public:
     /*!
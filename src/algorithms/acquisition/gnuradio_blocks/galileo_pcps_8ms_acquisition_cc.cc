@@ -36,6 +36,9 @@
 #include <volk/volk.h>
 #include <volk_gnsssdr/volk_gnsssdr.h>
 #include "control_message_factory.h"
+#include "fft_planner.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
 
 using google::LogMessage;
 
@@ -77,15 +80,16 @@ galileo_pcps_8ms_acquisition_cc::galileo_pcps_8ms_acquisition_cc(
     d_input_power = 0.0;
     d_num_doppler_bins = 0;
 
-    d_fft_code_A = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-    d_fft_code_B = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-    d_magnitude = static_cast<float*>(volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
+    d_fft_code_A = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
+    d_fft_code_B = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
+    d_magnitude = static_cast<float*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
 
     // Direct FFT
-    d_fft_if = new gr::fft::fft_complex(d_fft_size, true);
+    d_fft_if = new gr::fft::fft_complex(d_fft_size, true, Fft_Planner::instance().threads(d_fft_size));
 
     // Inverse FFT
-    d_ifft = new gr::fft::fft_complex(d_fft_size, false);
+    d_ifft = new gr::fft::fft_complex(d_fft_size, false, Fft_Planner::instance().threads(d_fft_size));
+    Gnss_Sdr_Memory_Accounting::add_fft(d_fft_size, 2);
 
     // For dumping samples into a file
     d_dump = dump;
@@ -108,14 +112,14 @@ galileo_pcps_8ms_acquisition_cc::~galileo_pcps_8ms_acquisition_cc()
         {
             for (unsigned int i = 0; i < d_num_doppler_bins; i++)
                 {
-                    volk_free(d_grid_doppler_wipeoffs[i]);
+                    gnss_sdr_volk_free(d_grid_doppler_wipeoffs[i]);
                 }
             delete[] d_grid_doppler_wipeoffs;
         }
 
-    volk_free(d_fft_code_A);
-    volk_free(d_fft_code_B);
-    volk_free(d_magnitude);
+    gnss_sdr_volk_free(d_fft_code_A);
+    gnss_sdr_volk_free(d_fft_code_B);
+    gnss_sdr_volk_free(d_magnitude);
 
     delete d_ifft;
     delete d_fft_if;
@@ -174,7 +178,7 @@ void galileo_pcps_8ms_acquisition_cc::init()
     d_grid_doppler_wipeoffs = new gr_complex*[d_num_doppler_bins];
     for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
         {
-            d_grid_doppler_wipeoffs[doppler_index] = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
+            d_grid_doppler_wipeoffs[doppler_index] = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
             int doppler = -static_cast<int>(d_doppler_max) + d_doppler_step * doppler_index;
             float phase_step_rad = static_cast<float>(GALILEO_TWO_PI) * (d_freq + doppler) / static_cast<float>(d_fs_in);
             float _phase[1];
@@ -211,6 +215,7 @@ int galileo_pcps_8ms_acquisition_cc::general_work(int noutput_items,
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items __attribute__((unused)))
 {
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("galileo_pcps_8ms_acquisition_cc::general_work", d_channel, d_gnss_synchro ? d_gnss_synchro->PRN : 0);
 
     int acquisition_message = -1; //0=STOP_CHANNEL 1=ACQ_SUCCEES 2=ACQ_FAIL
 
@@ -33,7 +33,9 @@
  */
 
 #include "pcps_acquisition_cc.h"
+#include <algorithm>
 #include <sstream>
+#include <boost/bind.hpp>
 #include <boost/filesystem.hpp>
 #include <gnuradio/io_signature.h>
 #include <glog/logging.h>
@@ -41,6 +43,11 @@
 #include <volk_gnsssdr/volk_gnsssdr.h>
 #include "control_message_factory.h"
 #include "GPS_L1_CA.h" //GPS_TWO_PI
+#include "fft_planner.h"
+#include "gnss_sdr_parameters.h"
+#include "acquisition_assistance.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
 
 
 using google::LogMessage;
@@ -50,12 +57,12 @@ pcps_acquisition_cc_sptr pcps_make_acquisition_cc(
                                  unsigned int doppler_max, long freq, long fs_in,
                                  int samples_per_ms, int samples_per_code,
                                  bool bit_transition_flag, bool use_CFAR_algorithm_flag,
-                                 bool dump,
+                                 bool fft_zero_padding, bool dump,
                                  std::string dump_filename)
 {
     return pcps_acquisition_cc_sptr(
             new pcps_acquisition_cc(sampled_ms, max_dwells, doppler_max, freq, fs_in, samples_per_ms,
-                    samples_per_code, bit_transition_flag, use_CFAR_algorithm_flag, dump, dump_filename));
+                    samples_per_code, bit_transition_flag, use_CFAR_algorithm_flag, fft_zero_padding, dump, dump_filename));
 }
 
 
@@ -64,13 +71,16 @@ pcps_acquisition_cc::pcps_acquisition_cc(
                          unsigned int doppler_max, long freq, long fs_in,
                          int samples_per_ms, int samples_per_code,
                          bool bit_transition_flag, bool use_CFAR_algorithm_flag,
-                         bool dump,
+                         bool fft_zero_padding, bool dump,
                          std::string dump_filename) :
     gr::block("pcps_acquisition_cc",
-    gr::io_signature::make(1, 1, sizeof(gr_complex) * sampled_ms * samples_per_ms * ( bit_transition_flag ? 2 : 1 )),
-    gr::io_signature::make(0, 0, sizeof(gr_complex) * sampled_ms * samples_per_ms * ( bit_transition_flag ? 2 : 1 )) )
+    gr::io_signature::make(1, 1, sizeof(gr_complex)),
+    gr::io_signature::make(0, 0, sizeof(gr_complex)) )
 {
     this->message_port_register_out(pmt::mp("events"));
+    // Threshold changed in the configuration file while running
+    this->message_port_register_in(pmt::mp("parameters"));
+    this->set_msg_handler(pmt::mp("parameters"), boost::bind(&pcps_acquisition_cc::msg_handler_parameters, this, _1));
 
     d_sample_counter = 0;    // SAMPLE COUNTER
     d_active = false;
@@ -87,6 +97,8 @@ pcps_acquisition_cc::pcps_acquisition_cc(
     d_mag = 0;
     d_input_power = 0.0;
     d_num_doppler_bins = 0;
+    d_doppler_center = 0;
+    d_doppler_search_max = doppler_max;
     d_bit_transition_flag = bit_transition_flag;
     d_use_CFAR_algorithm_flag = use_CFAR_algorithm_flag;
     d_threshold = 0.0;
@@ -95,8 +107,21 @@ pcps_acquisition_cc::pcps_acquisition_cc(
     d_test_statistics = 0.0;
     d_channel = 0;
     d_doppler_freq = 0.0;
-
-    //set_relative_rate( 1.0/d_fft_size );
+    d_dwell_accumulation = DWELL_MAXIMUM;
+    d_grid_magnitude = 0;
+    d_grid_correlation = 0;
+    d_grid_size = 0;
+    d_accumulated_power = 0.0;
+    d_pipelined = false;
+    d_in_dwell_count = 0;
+    d_core_working = false;
+    d_stop_worker = false;
+    d_rf_channel = 0;
+    d_ring_window = 0;
+    d_ring_stamp = 0;
+    d_decimation = 1;
+    d_decimated = 0;
+    d_full_rate_code_length = 0;
 
     // COD:
     // Experimenting with the overlap/save technique for handling bit trannsitions
@@ -113,45 +138,86 @@ pcps_acquisition_cc::pcps_acquisition_cc(
             d_fft_size *= 2;
             d_max_dwells = 1; //Activation of d_bit_transition_flag invalidates the value of d_max_dwells
         }
+    d_vector_length = d_fft_size;
+    d_input_length = d_vector_length;
+
+    // The input is the sample stream, read in place instead of through a
+    // stream_to_vector copy. The scheduler calls the block once there is a whole
+    // dwell in its buffer, and sizes the buffer of the upstream block to hold two
+    set_relative_rate(1.0 / static_cast<double>(d_vector_length));
+
+    // Since the correlation is linear when d_bit_transition_flag is set, the
+    // FFT can be zero-padded up to the next length FFTW handles efficiently
+    // (e.g. 16368 -> 16384) without changing the result.
+    if (fft_zero_padding)
+        {
+            if (d_bit_transition_flag)
+                {
+                    d_fft_size = Fft_Planner::fast_size(d_vector_length);
+                    DLOG(INFO) << "FFT zero-padded from " << d_vector_length << " to " << d_fft_size << " samples";
+                }
+            else
+                {
+                    LOG(WARNING) << "FFT zero padding requires bit_transition_flag=true. Ignoring it.";
+                }
+        }
+    d_code_offset = ( d_bit_transition_flag ? d_fft_size - d_vector_length / 2 : 0 );
 
-    d_fft_codes = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-    d_magnitude = static_cast<float*>(volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
+    d_magnitude = static_cast<float*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
 
     // Direct FFT
-    d_fft_if = new gr::fft::fft_complex(d_fft_size, true);
+    d_fft_if = new gr::fft::fft_complex(d_fft_size, true, Fft_Planner::instance().threads(d_fft_size));
 
     // Inverse FFT
-    d_ifft = new gr::fft::fft_complex(d_fft_size, false);
+    d_ifft = new gr::fft::fft_complex(d_fft_size, false, Fft_Planner::instance().threads(d_fft_size));
+    Gnss_Sdr_Memory_Accounting::add_fft(d_fft_size, 2);
 
-    // For dumping samples into a file
+    // For dumping the search grids into a file
     d_dump = dump;
     d_dump_filename = dump_filename;
+    if (d_dump)
+        {
+            d_grid_dump = std::make_shared<Acquisition_Grid_Dump>(1, 0, 0);
+        }
 
     d_gnss_synchro = 0;
-    d_grid_doppler_wipeoffs = 0;
 }
 
 
 pcps_acquisition_cc::~pcps_acquisition_cc()
 {
-    if (d_num_doppler_bins > 0)
+    if (d_pipelined)
         {
-            for (unsigned int i = 0; i < d_num_doppler_bins; i++)
+            {
+                boost::mutex::scoped_lock lock(d_mutex);
+                d_stop_worker = true;
+            }
+            d_dwell_ready.notify_all();
+            d_worker.join();
+            for (unsigned int i = 0; i < d_dwell_buffers.size(); i++)
                 {
-                    volk_free(d_grid_doppler_wipeoffs[i]);
+                    gnss_sdr_volk_gnsssdr_free_huge(d_dwell_buffers[i]);
                 }
-            delete[] d_grid_doppler_wipeoffs;
         }
 
-    volk_free(d_fft_codes);
-    volk_free(d_magnitude);
+    gnss_sdr_volk_free(d_magnitude);
+    gnss_sdr_volk_free(d_ring_window);
+    gnss_sdr_volk_free(d_decimated);
+    gnss_sdr_volk_gnsssdr_free_huge(d_grid_magnitude);
+    gnss_sdr_volk_gnsssdr_free_huge(d_grid_correlation);
 
     delete d_ifft;
     delete d_fft_if;
+}
 
-    if (d_dump)
+
+void pcps_acquisition_cc::msg_handler_parameters(pmt::pmt_t msg)
+{
+    GNSS_SDR_TRACE_SCOPE("pcps_acquisition_cc::msg_handler_parameters");
+    // the next test statistic is compared with the new threshold
+    if (gnss_sdr_get_parameter(msg, "threshold", d_threshold))
         {
-            d_dump_file.close();
+            LOG(INFO) << "Acquisition channel " << d_channel << ": threshold updated to " << d_threshold;
         }
 }
 
@@ -164,9 +230,8 @@ void pcps_acquisition_cc::set_local_code(std::complex<float> * code)
     // where c_i is the local code and there are L zeros and L chips
     if( d_bit_transition_flag )
         {
-            int offset = d_fft_size/2;
-            std::fill_n( d_fft_if->get_inbuf(), offset, gr_complex( 0.0, 0.0 ) );
-            memcpy(d_fft_if->get_inbuf() + offset, code, sizeof(gr_complex) * offset);
+            std::fill_n( d_fft_if->get_inbuf(), d_code_offset, gr_complex( 0.0, 0.0 ) );
+            memcpy(d_fft_if->get_inbuf() + d_code_offset, code, sizeof(gr_complex) * (d_fft_size - d_code_offset));
         } 
     else 
         {
@@ -174,16 +239,11 @@ void pcps_acquisition_cc::set_local_code(std::complex<float> * code)
         }
     
     d_fft_if->execute(); // We need the FFT of local code
-    volk_32fc_conjugate_32fc(d_fft_codes, d_fft_if->get_outbuf(), d_fft_size);
-}
-
 
-void pcps_acquisition_cc::update_local_carrier(gr_complex* carrier_vector, int correlator_length_samples, float freq)
-{
-    float phase_step_rad = GPS_TWO_PI * freq / static_cast<float>(d_fs_in);
-    float _phase[1];
-    _phase[0] = 0;
-    volk_gnsssdr_s32f_sincos_32fc(carrier_vector, - phase_step_rad, _phase, correlator_length_samples);
+    // The previous spectrum may be shared with other channels, so do not overwrite it
+    gr_complex* fft_codes = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
+    volk_32fc_conjugate_32fc(fft_codes, d_fft_if->get_outbuf(), d_fft_size);
+    d_fft_codes = std::shared_ptr<const gr_complex>(fft_codes, [](const gr_complex* p) { gnss_sdr_volk_free(const_cast<gr_complex*>(p)); });
 }
 
 
@@ -201,32 +261,217 @@ void pcps_acquisition_cc::init()
     d_mag = 0.0;
     d_input_power = 0.0;
 
-    d_num_doppler_bins = ceil( static_cast<double>(static_cast<int>(d_doppler_max) - static_cast<int>(-d_doppler_max)) / static_cast<double>(d_doppler_step));
+    d_ring = Gnss_Sample_Ring_Store::instance().get(d_rf_channel);
+    if (d_ring && (d_pipelined || d_ring->capacity() < d_input_length))
+        {
+            if (!d_pipelined) LOG(WARNING) << "The sample ring of RF channel " << d_rf_channel << " is shorter than a dwell, it is not used";
+            d_ring.reset();
+        }
+    if (d_ring && d_ring_window == 0)
+        {
+            d_ring_window = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_input_length * sizeof(gr_complex), volk_get_alignment()));
+        }
+
+    update_doppler_window(true);
+}
 
-    // Create the carrier Doppler wipeoff signals
-    d_grid_doppler_wipeoffs = new gr_complex*[d_num_doppler_bins];
 
-    for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+void pcps_acquisition_cc::update_doppler_window(bool force)
+{
+    int doppler_center = 0;
+    unsigned int doppler_search_max = d_doppler_max;
+    if (d_gnss_synchro != 0)
+        {
+            Acquisition_Assistance::doppler_window(*d_gnss_synchro, d_doppler_max, d_doppler_step,
+                    doppler_center, doppler_search_max, static_cast<double>(d_sample_counter) / (static_cast<double>(d_fs_in) * d_decimation));
+        }
+    if (!force && doppler_center == d_doppler_center && doppler_search_max == d_doppler_search_max)
+        {
+            return;
+        }
+    d_doppler_center = doppler_center;
+    d_doppler_search_max = doppler_search_max;
+
+    d_num_doppler_bins = ceil( static_cast<double>(static_cast<int>(d_doppler_search_max) - static_cast<int>(-d_doppler_search_max)) / static_cast<double>(d_doppler_step));
+
+    // Get the carrier Doppler wipeoff signals, shared with the other channels
+    d_grid_doppler_wipeoffs = Doppler_Grid_Store::instance().get(d_fs_in, d_freq + d_doppler_center,
+            d_vector_length, d_doppler_search_max, d_doppler_step, d_num_doppler_bins);
+
+    allocate_grid();
+}
+
+
+void pcps_acquisition_cc::set_dwell_accumulation(unsigned int mode)
+{
+    if (mode > DWELL_COHERENT)
         {
-            d_grid_doppler_wipeoffs[doppler_index] = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-            int doppler = -static_cast<int>(d_doppler_max) + d_doppler_step * doppler_index;
-            update_local_carrier(d_grid_doppler_wipeoffs[doppler_index], d_fft_size, d_freq + doppler);
+            LOG(WARNING) << "Unknown dwell accumulation mode " << mode << ". Using independent dwells.";
+            mode = DWELL_MAXIMUM;
+        }
+    if (mode != DWELL_MAXIMUM && d_bit_transition_flag)
+        {
+            LOG(WARNING) << "Dwell accumulation is not available with bit_transition_flag=true. Ignoring it.";
+            mode = DWELL_MAXIMUM;
+        }
+    d_dwell_accumulation = mode;
+}
+
+
+void pcps_acquisition_cc::set_dump_options(unsigned int delay_decimation, unsigned int roi_delays, unsigned int roi_doppler_bins)
+{
+    if (d_dump && !d_grid_dump->is_open())
+        {
+            d_grid_dump = std::make_shared<Acquisition_Grid_Dump>(delay_decimation, roi_delays, roi_doppler_bins);
+        }
+}
+
+
+std::string pcps_acquisition_cc::dump_filename() const
+{
+    // One file per channel, with one record per search
+    std::stringstream filename;
+    boost::filesystem::path p = d_dump_filename;
+    filename << p.parent_path().string()
+             << boost::filesystem::path::preferred_separator
+             << p.stem().string()
+             << "_ch_" << d_channel
+             << p.extension().string();
+    DLOG(INFO) << "Writing ACQ out to " << filename.str();
+    return filename.str();
+}
+
+
+void pcps_acquisition_cc::allocate_grid()
+{
+    // The grid is kept between acquisitions, and only reallocated if the search changes
+    unsigned int grid_size = (d_dwell_accumulation == DWELL_MAXIMUM ? 0 : d_num_doppler_bins * d_fft_size);
+    if (grid_size == d_grid_size)
+        {
+            return;
+        }
+
+    gnss_sdr_volk_gnsssdr_free_huge(d_grid_magnitude);
+    gnss_sdr_volk_gnsssdr_free_huge(d_grid_correlation);
+    d_grid_magnitude = 0;
+    d_grid_correlation = 0;
+    if (d_dwell_accumulation == DWELL_NONCOHERENT)
+        {
+            d_grid_magnitude = static_cast<float*>(gnss_sdr_volk_gnsssdr_malloc_huge(grid_size * sizeof(float), volk_get_alignment()));
+        }
+    else if (d_dwell_accumulation == DWELL_COHERENT)
+        {
+            d_grid_correlation = static_cast<gr_complex*>(gnss_sdr_volk_gnsssdr_malloc_huge(grid_size * sizeof(gr_complex), volk_get_alignment()));
+        }
+    d_grid_size = grid_size;
+}
+
+
+void pcps_acquisition_cc::set_pipelined(bool pipelined)
+{
+    if (!pipelined || d_pipelined)
+        {
+            return;
+        }
+    for (unsigned int i = 0; i < d_max_dwells; i++)
+        {
+            d_dwell_buffers.push_back(static_cast<gr_complex*>(gnss_sdr_volk_gnsssdr_malloc_huge(d_input_length * sizeof(gr_complex), volk_get_alignment())));
+        }
+    d_dwell_samplestamps.assign(d_max_dwells, 0);
+    d_pipelined = true;
+    d_worker = boost::thread(&pcps_acquisition_cc::pipeline_worker, this);
+}
+
+
+void pcps_acquisition_cc::set_decimation(unsigned int decimation)
+{
+    if (decimation <= 1 || d_decimation > 1 || d_pipelined)
+        {
+            return;
+        }
+    if (d_bit_transition_flag)
+        {
+            LOG(WARNING) << "Reduced-rate acquisition is not available with bit_transition_flag=true. Ignoring it.";
+            return;
+        }
+    d_decimation = decimation;
+    d_input_length = d_vector_length * d_decimation;
+    d_decimator = std::make_shared<Acquisition_Decimator>(d_decimation, d_input_length);
+    d_decimated = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_vector_length * sizeof(gr_complex), volk_get_alignment()));
+    set_relative_rate(1.0 / static_cast<double>(d_input_length));
+}
+
+
+void pcps_acquisition_cc::pipeline_worker()
+{
+    boost::unique_lock<boost::mutex> lock(d_mutex);
+    while (!d_stop_worker)
+        {
+            if (d_state != 1 || d_well_count >= d_in_dwell_count)
+                {
+                    d_dwell_ready.wait(lock);
+                    continue;
+                }
+
+            // The buffered dwells are not modified until this acquisition ends,
+            // so the block can keep buffering the next ones meanwhile
+            unsigned int dwell = d_well_count;
+            d_core_working = true;
+            lock.unlock();
+            int state = acquisition_core(d_dwell_buffers[dwell], d_dwell_samplestamps[dwell]);
+            lock.lock();
+            d_core_working = false;
+            d_dwell_done.notify_all();
+
+            // The channel may have stopped this acquisition in the meantime
+            if (d_state != 1 || state == 1)
+                {
+                    continue;
+                }
+            int acquisition_message = (state == 2 ? 1 : 2); //1=ACQ_SUCCEES 2=ACQ_FAIL
+            DLOG(INFO) << (state == 2 ? "positive" : "negative") << " acquisition";
+            DLOG(INFO) << "satellite " << d_gnss_synchro->System << " " << d_gnss_synchro->PRN;
+            DLOG(INFO) << "sample_stamp " << d_gnss_synchro->Acq_samplestamp_samples;
+            DLOG(INFO) << "test statistics value " << d_test_statistics;
+            DLOG(INFO) << "test statistics threshold " << d_threshold;
+            DLOG(INFO) << "code phase " << d_gnss_synchro->Acq_delay_samples;
+            DLOG(INFO) << "doppler " << d_gnss_synchro->Acq_doppler_hz;
+            DLOG(INFO) << "magnitude " << d_mag;
+            DLOG(INFO) << "input signal power " << d_input_power;
+            d_active = false;
+            d_state = 0;
+            lock.unlock();
+            this->message_port_pub(pmt::mp("events"), pmt::from_long(acquisition_message));
+            lock.lock();
         }
 }
 
 
 void pcps_acquisition_cc::set_state(int state)
 {
+    boost::unique_lock<boost::mutex> lock(d_mutex, boost::defer_lock);
+    if (d_pipelined)
+        {
+            // Wait for the dwell being searched, so that its result does not mix with the new acquisition
+            lock.lock();
+            while (d_core_working)
+                {
+                    d_dwell_done.wait(lock);
+                }
+        }
     d_state = state;
     if (d_state == 1)
         {
+            update_doppler_window(false);
             d_gnss_synchro->Acq_delay_samples = 0.0;
             d_gnss_synchro->Acq_doppler_hz = 0.0;
             d_gnss_synchro->Acq_samplestamp_samples = 0;
             d_well_count = 0;
             d_mag = 0.0;
             d_input_power = 0.0;
+            d_accumulated_power = 0.0;
             d_test_statistics = 0.0;
+            d_in_dwell_count = 0;
         }
     else if (d_state == 0)
         {}
@@ -237,10 +482,247 @@ void pcps_acquisition_cc::set_state(int state)
 }
 
 
+int pcps_acquisition_cc::acquisition_core(const gr_complex* in, unsigned long int samplestamp)
+{
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("pcps_acquisition_cc::acquisition_core", d_channel, d_gnss_synchro->PRN);
+    // initialize acquisition algorithm
+    int doppler;
+#if VOLK_GT_122
+    uint16_t indext = 0;
+#else
+    unsigned int indext = 0;
+#endif
+    float magt = 0.0;
+
+    // Reduced-rate acquisition: the search runs on the decimated dwell
+    const gr_complex* input = in;
+    if (d_decimation > 1)
+        {
+            d_decimator->decimate(input, d_decimated);
+            in = d_decimated;
+        }
+
+    int effective_fft_size = ( d_bit_transition_flag ? d_vector_length/2 : d_fft_size );
+
+    // Equal to d_fft_size^2 unless the FFT is zero-padded
+    float fft_normalization_factor = static_cast<float>(d_fft_size) * static_cast<float>(d_vector_length);
+
+    d_input_power = 0.0;
+    d_mag = 0.0;
+
+    d_well_count++;
+
+    // The accumulated grids hold d_well_count dwells. Their cells are divided
+    // by this factor so that the noise keeps the scale of a single dwell
+    bool accumulate = (d_dwell_accumulation != DWELL_MAXIMUM) && (d_grid_size > 0);
+    float accumulation_factor = ( accumulate ? static_cast<float>(d_well_count) : 1.0 );
+
+    DLOG(INFO) << "Channel: " << d_channel
+            << " , doing acquisition of satellite: " << d_gnss_synchro->System << " " << d_gnss_synchro->PRN
+            << " ,sample stamp: " << samplestamp << ", threshold: "
+            << d_threshold << ", doppler_max: " << d_doppler_max
+            << ", doppler_step: " << d_doppler_step
+            << ", doppler search: " << d_doppler_center << " +/- " << d_doppler_search_max;
+
+    if (d_use_CFAR_algorithm_flag == true)
+        {
+            // 1- (optional) Compute the input signal power estimation
+            volk_32fc_magnitude_squared_32f(d_magnitude, in, d_vector_length);
+            volk_32f_accumulator_s32f(&d_input_power, d_magnitude, d_vector_length);
+            d_input_power /= static_cast<float>(d_vector_length);
+            if (accumulate)
+                {
+                    d_accumulated_power += d_input_power;
+                    d_input_power = d_accumulated_power / accumulation_factor;
+                }
+        }
+    float dump_peak = -1.0;
+    unsigned int dump_peak_bin = 0;
+    unsigned int dump_peak_delay = 0;
+    if (d_dump)
+        {
+            d_grid_dump->begin(d_num_doppler_bins, effective_fft_size);
+        }
+
+    // 2- Doppler frequency search loop
+    for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+        {
+            GNSS_SDR_TRACE_SCOPE_CHANNEL("pcps_acquisition_cc::doppler_bin", d_channel, d_gnss_synchro->PRN);
+            // doppler search steps
+            doppler = d_doppler_center - static_cast<int>(d_doppler_search_max) + d_doppler_step * doppler_index;
+
+            volk_32fc_x2_multiply_32fc(d_fft_if->get_inbuf(), in,
+                    d_grid_doppler_wipeoffs->wipeoff(doppler_index), d_vector_length);
+            std::fill_n(d_fft_if->get_inbuf() + d_vector_length, d_fft_size - d_vector_length, gr_complex(0.0, 0.0));
+
+            // 3- Perform the FFT-based convolution  (parallel time search)
+            // Compute the FFT of the carrier wiped--off incoming signal
+            d_fft_if->execute();
+
+            // Multiply carrier wiped--off, Fourier transformed incoming signal
+            // with the local FFT'd code reference using SIMD operations with VOLK library
+            volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(),
+                    d_fft_if->get_outbuf(), d_fft_codes.get(), d_fft_size);
+
+            // compute the inverse FFT
+            d_ifft->execute();
+
+            // Search maximum
+            size_t offset = ( d_bit_transition_flag ? effective_fft_size : 0 );
+            float* surface = d_magnitude;
+            if (accumulate && d_dwell_accumulation == DWELL_COHERENT)
+                {
+                    // Rotate the correlation by the phase that a continuous local carrier
+                    // would have reached at the start of this dwell, and add it to the grid
+                    gr_complex* correlation = d_ifft->get_outbuf();
+                    gr_complex* grid = d_grid_correlation + doppler_index * effective_fft_size;
+                    if (d_well_count == 1)
+                        {
+                            memcpy(grid, correlation, sizeof(gr_complex) * effective_fft_size);
+                        }
+                    else
+                        {
+                            double phase = - GPS_TWO_PI * (static_cast<double>(d_freq) + static_cast<double>(doppler))
+                                    * static_cast<double>(d_vector_length) * static_cast<double>(d_well_count - 1) / static_cast<double>(d_fs_in);
+                            gr_complex rotation = gr_complex(cos(phase), sin(phase));
+                            volk_32fc_s32fc_multiply_32fc(correlation, correlation, rotation, effective_fft_size);
+                            volk_32f_x2_add_32f(reinterpret_cast<float*>(grid), reinterpret_cast<float*>(grid),
+                                    reinterpret_cast<float*>(correlation), 2 * effective_fft_size);
+                        }
+                    volk_32fc_magnitude_squared_32f(d_magnitude, grid, effective_fft_size);
+                }
+            else
+                {
+                    volk_32fc_magnitude_squared_32f(d_magnitude, d_ifft->get_outbuf() + offset, effective_fft_size);
+                }
+            if (accumulate && d_dwell_accumulation == DWELL_NONCOHERENT)
+                {
+                    surface = d_grid_magnitude + doppler_index * effective_fft_size;
+                    if (d_well_count == 1)
+                        {
+                            memcpy(surface, d_magnitude, sizeof(float) * effective_fft_size);
+                        }
+                    else
+                        {
+                            volk_32f_x2_add_32f(surface, surface, d_magnitude, effective_fft_size);
+                        }
+                }
+            volk_32f_index_max_16u(&indext, surface, effective_fft_size);
+            magt = surface[indext] / accumulation_factor;
+
+            if (d_use_CFAR_algorithm_flag == true)
+                {
+                    // Normalize the maximum value to correct the scale factor introduced by FFTW
+                    magt = surface[indext] / (accumulation_factor * fft_normalization_factor * fft_normalization_factor);
+                }
+            // 4- record the maximum peak and the associated synchronization parameters
+            if (d_mag < magt)
+                {
+                    d_mag = magt;
+
+                    if (d_use_CFAR_algorithm_flag == false)
+                        {
+                            // Search grid noise floor approximation for this doppler line
+                            volk_32f_accumulator_s32f(&d_input_power, surface, effective_fft_size);
+                            d_input_power = (d_input_power / accumulation_factor - d_mag) / (effective_fft_size - 1);
+                        }
+
+                    // In case that d_bit_transition_flag = true, we compare the potentially
+                    // new maximum test statistics (d_mag/d_input_power) with the value in
+                    // d_test_statistics. When the second dwell is being processed, the value
+                    // of d_mag/d_input_power could be lower than d_test_statistics (i.e,
+                    // the maximum test statistics in the previous dwell is greater than
+                    // current d_mag/d_input_power). Note that d_test_statistics is not
+                    // restarted between consecutive dwells in multidwell operation.
+
+                    if (d_test_statistics < (d_mag / d_input_power) || !d_bit_transition_flag)
+                        {
+                            d_gnss_synchro->Acq_delay_samples = static_cast<double>(indext % d_samples_per_code);
+                            d_gnss_synchro->Acq_doppler_hz = static_cast<double>(doppler);
+                            d_gnss_synchro->Acq_samplestamp_samples = samplestamp;
+
+                            // 5- Compute the test statistics and compare to the threshold
+                            //d_test_statistics = 2 * d_fft_size * d_mag / d_input_power;
+                            d_test_statistics = d_mag / d_input_power;
+                        }
+                }
+
+            // Peak of this search, for the dump
+            if (d_dump)
+                {
+                    memcpy(d_grid_dump->row(doppler_index), surface, sizeof(float) * effective_fft_size);
+                    if (surface[indext] > dump_peak)
+                        {
+                            dump_peak = surface[indext];
+                            dump_peak_bin = doppler_index;
+                            dump_peak_delay = indext;
+                        }
+                }
+        }
+
+    // A new peak in this dwell: its delay, in acquisition samples, is refined at the input rate
+    if (d_decimation > 1 && d_gnss_synchro->Acq_samplestamp_samples == samplestamp)
+        {
+            unsigned int coarse_delay = static_cast<unsigned int>(d_gnss_synchro->Acq_delay_samples) * d_decimation;
+            if (d_full_rate_code && d_full_rate_code_length > 0)
+                {
+                    double carrier_hz = static_cast<double>(d_freq) + d_gnss_synchro->Acq_doppler_hz;
+                    coarse_delay = d_decimator->refine(input, d_full_rate_code.get(), d_full_rate_code_length,
+                            coarse_delay, carrier_hz, static_cast<double>(d_fs_in) * d_decimation);
+                }
+            d_gnss_synchro->Acq_delay_samples = static_cast<double>(coarse_delay);
+        }
+
+    if (d_dump)
+        {
+            Acquisition_Grid_Search search;
+            search.samplestamp = samplestamp;
+            search.prn = d_gnss_synchro->PRN;
+            search.well_count = d_well_count;
+            search.first_doppler_hz = d_doppler_center - static_cast<int>(d_doppler_search_max);
+            search.doppler_step_hz = d_doppler_step;
+            search.peak_doppler_bin = dump_peak_bin;
+            search.peak_delay = dump_peak_delay;
+            search.test_statistic = d_test_statistics;
+            search.threshold = d_threshold;
+            d_grid_dump->end(d_grid_dump->is_open() ? std::string() : dump_filename(), search);
+        }
+
+    int state = 1;
+    if (!d_bit_transition_flag)
+        {
+            if (d_test_statistics > d_threshold)
+                {
+                    state = 2; // Positive acquisition
+                }
+            else if (d_well_count == d_max_dwells)
+                {
+                    state = 3; // Negative acquisition
+                }
+        }
+    else
+        {
+            if (d_well_count == d_max_dwells) // d_max_dwells = 2
+                {
+                    if (d_test_statistics > d_threshold)
+                        {
+                            state = 2; // Positive acquisition
+                        }
+                    else
+                        {
+                            state = 3; // Negative acquisition
+                        }
+                }
+        }
+    return state;
+}
+
+
 int pcps_acquisition_cc::general_work(int noutput_items,
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items __attribute__((unused)))
 {
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("pcps_acquisition_cc::general_work", d_channel, d_gnss_synchro ? d_gnss_synchro->PRN : 0);
     /*
      * By J.Arribas, L.Esteve and M.Molina
      * Acquisition strategy (Kay Borre book + CFAR threshold):
@@ -254,12 +736,25 @@ int pcps_acquisition_cc::general_work(int noutput_items,
 
     int acquisition_message = -1; //0=STOP_CHANNEL 1=ACQ_SUCCEES 2=ACQ_FAIL
 
+    // In pipelined mode the state is shared with the worker
+    boost::unique_lock<boost::mutex> lock(d_mutex, boost::defer_lock);
+    if (d_pipelined)
+        {
+            lock.lock();
+        }
+
     switch (d_state)
     {
     case 0:
         {
             if (d_active)
                 {
+                    // Let the worker finish the last dwell of the previous acquisition
+                    while (d_core_working)
+                        {
+                            d_dwell_done.wait(lock);
+                        }
+                    update_doppler_window(false);
                     //restart acquisition variables
                     d_gnss_synchro->Acq_delay_samples = 0.0;
                     d_gnss_synchro->Acq_doppler_hz = 0.0;
@@ -267,173 +762,79 @@ int pcps_acquisition_cc::general_work(int noutput_items,
                     d_well_count = 0;
                     d_mag = 0.0;
                     d_input_power = 0.0;
+                    d_accumulated_power = 0.0;
                     d_test_statistics = 0.0;
+                    d_in_dwell_count = 0;
 
                     d_state = 1;
                 }
 
-            d_sample_counter += d_fft_size * ninput_items[0]; // sample counter
+            // The input is read in place, so skipping it costs no copy
+            d_sample_counter += ninput_items[0]; // sample counter
             consume_each(ninput_items[0]);
 
-            //DLOG(INFO) << "Consumed " << ninput_items[0] << " items";
-
             break;
         }
 
     case 1:
         {
-            // initialize acquisition algorithm
-            int doppler;
-#if VOLK_GT_122
-            uint16_t indext = 0;
-#else
-            unsigned int indext = 0;
-#endif
-            float magt = 0.0;
-            const gr_complex *in = (const gr_complex *)input_items[0]; //Get the input samples pointer
-
-            int effective_fft_size = ( d_bit_transition_flag ? d_fft_size/2 : d_fft_size );
-
-            float fft_normalization_factor = static_cast<float>(d_fft_size) * static_cast<float>(d_fft_size);
-
-            d_input_power = 0.0;
-            d_mag = 0.0;
-
-            d_sample_counter += d_fft_size; // sample counter
-
-            d_well_count++;
-
-            DLOG(INFO) << "Channel: " << d_channel
-                    << " , doing acquisition of satellite: " << d_gnss_synchro->System << " " << d_gnss_synchro->PRN
-                    << " ,sample stamp: " << d_sample_counter << ", threshold: "
-                    << d_threshold << ", doppler_max: " << d_doppler_max
-                    << ", doppler_step: " << d_doppler_step;
-
-            if (d_use_CFAR_algorithm_flag == true)
+            if (d_pipelined)
                 {
-                    // 1- (optional) Compute the input signal power estimation
-                    volk_32fc_magnitude_squared_32f(d_magnitude, in, d_fft_size);
-                    volk_32f_accumulator_s32f(&d_input_power, d_magnitude, d_fft_size);
-                    d_input_power /= static_cast<float>(d_fft_size);
-                }
-            // 2- Doppler frequency search loop
-            for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
-                {
-                    // doppler search steps
-                    doppler = -static_cast<int>(d_doppler_max) + d_doppler_step * doppler_index;
-
-                    volk_32fc_x2_multiply_32fc(d_fft_if->get_inbuf(), in,
-                            d_grid_doppler_wipeoffs[doppler_index], d_fft_size);
-
-                    // 3- Perform the FFT-based convolution  (parallel time search)
-                    // Compute the FFT of the carrier wiped--off incoming signal
-                    d_fft_if->execute();
-
-                    // Multiply carrier wiped--off, Fourier transformed incoming signal
-                    // with the local FFT'd code reference using SIMD operations with VOLK library
-                    volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(),
-                            d_fft_if->get_outbuf(), d_fft_codes, d_fft_size);
-
-                    // compute the inverse FFT
-                    d_ifft->execute();
-
-                    // Search maximum
-                    size_t offset = ( d_bit_transition_flag ? effective_fft_size : 0 );
-                    volk_32fc_magnitude_squared_32f(d_magnitude, d_ifft->get_outbuf() + offset, effective_fft_size);
-                    volk_32f_index_max_16u(&indext, d_magnitude, effective_fft_size);
-                    magt = d_magnitude[indext];
-
-                    if (d_use_CFAR_algorithm_flag == true)
+                    // Buffer the consecutive dwells of this acquisition, and skip the rest
+                    // of the input until the worker declares the result
+                    const gr_complex *in = (const gr_complex *)input_items[0]; //Get the input samples pointer
+                    int consumed = 0;
+                    bool buffered = false;
+                    while (d_in_dwell_count < d_max_dwells && consumed + static_cast<int>(d_input_length) <= ninput_items[0])
                         {
-                            // Normalize the maximum value to correct the scale factor introduced by FFTW
-                            magt = d_magnitude[indext] / (fft_normalization_factor * fft_normalization_factor);
+                            memcpy(d_dwell_buffers[d_in_dwell_count], in + consumed, sizeof(gr_complex) * d_input_length);
+                            consumed += d_input_length;
+                            d_sample_counter += d_input_length; // sample counter
+                            d_dwell_samplestamps[d_in_dwell_count] = d_sample_counter;
+                            d_in_dwell_count++;
+                            buffered = true;
                         }
-                    // 4- record the maximum peak and the associated synchronization parameters
-                    if (d_mag < magt)
+                    if (d_in_dwell_count >= d_max_dwells)
                         {
-                            d_mag = magt;
-
-                            if (d_use_CFAR_algorithm_flag == false)
-                                {
-                                    // Search grid noise floor approximation for this doppler line
-                                    volk_32f_accumulator_s32f(&d_input_power, d_magnitude, effective_fft_size);
-                                    d_input_power = (d_input_power - d_mag) / (effective_fft_size - 1);
-                                }
-
-                            // In case that d_bit_transition_flag = true, we compare the potentially
-                            // new maximum test statistics (d_mag/d_input_power) with the value in
-                            // d_test_statistics. When the second dwell is being processed, the value
-                            // of d_mag/d_input_power could be lower than d_test_statistics (i.e,
-                            // the maximum test statistics in the previous dwell is greater than
-                            // current d_mag/d_input_power). Note that d_test_statistics is not
-                            // restarted between consecutive dwells in multidwell operation.
-
-                            if (d_test_statistics < (d_mag / d_input_power) || !d_bit_transition_flag)
-                                {
-                                    d_gnss_synchro->Acq_delay_samples = static_cast<double>(indext % d_samples_per_code);
-                                    d_gnss_synchro->Acq_doppler_hz = static_cast<double>(doppler);
-                                    d_gnss_synchro->Acq_samplestamp_samples = d_sample_counter;
-
-                                    // 5- Compute the test statistics and compare to the threshold
-                                    //d_test_statistics = 2 * d_fft_size * d_mag / d_input_power;
-                                    d_test_statistics = d_mag / d_input_power;
-                                }
+                            d_sample_counter += ninput_items[0] - consumed;
+                            consumed = ninput_items[0];
                         }
-
-                    // Record results to file if required
-                    if (d_dump)
+                    if (buffered)
                         {
-                            std::stringstream filename;
-                            std::streamsize n = 2 * sizeof(float) * (d_fft_size); // complex file write
-                            filename.str("");
-
-                            boost::filesystem::path p = d_dump_filename;
-                            filename << p.parent_path().string()
-                                     << boost::filesystem::path::preferred_separator
-                                     << p.stem().string()
-                                     << "_" << d_gnss_synchro->System
-                                     <<"_" << d_gnss_synchro->Signal << "_sat_"
-                                     << d_gnss_synchro->PRN << "_doppler_"
-                                     <<  doppler
-                                     << p.extension().string();
-
-                            DLOG(INFO) << "Writing ACQ out to " << filename.str();
-
-                            d_dump_file.open(filename.str().c_str(), std::ios::out | std::ios::binary);
-                            d_dump_file.write((char*)d_ifft->get_outbuf(), n); //write directly |abs(x)|^2 in this Doppler bin?
-                            d_dump_file.close();
+                            d_dwell_ready.notify_one();
                         }
+                    consume_each(consumed);
+                    break;
                 }
 
-            if (!d_bit_transition_flag)
+            if (d_ring)
                 {
-                    if (d_test_statistics > d_threshold)
+                    // The first dwell is the freshest one of the ring, the next ones follow it.
+                    // If the acquisition fell so far behind that the next dwell was
+                    // overwritten, it goes on with the freshest one
+                    unsigned long int newest = d_ring->newest();
+                    if (d_well_count == 0 || d_ring_stamp + d_ring->capacity() < newest)
                         {
-                            d_state = 2; // Positive acquisition
+                            d_ring_stamp = newest - std::min<unsigned long int>(newest, d_input_length);
                         }
-                    else if (d_well_count == d_max_dwells)
+                    if (d_ring->read(d_ring_stamp, d_ring_window, d_input_length))
                         {
-                            d_state = 3; // Negative acquisition
-                        }
-                }
-            else
-                {
-                    if (d_well_count == d_max_dwells) // d_max_dwells = 2
-                        {
-                            if (d_test_statistics > d_threshold)
-                                {
-                                    d_state = 2; // Positive acquisition
-                                }
-                            else
-                                {
-                                    d_state = 3; // Negative acquisition
-                                }
+                            d_ring_stamp += d_input_length;
+                            d_state = acquisition_core(d_ring_window, d_ring_stamp);
                         }
+                    // The input only paces the block
+                    d_sample_counter += ninput_items[0]; // sample counter
+                    consume_each(ninput_items[0]);
+                    break;
                 }
 
-            consume_each(1);
+            const gr_complex *in = (const gr_complex *)input_items[0]; //Get the input samples pointer
+            d_sample_counter += d_input_length; // sample counter
+            d_state = acquisition_core(in, d_sample_counter);
+
+            consume_each(d_input_length);
 
-            DLOG(INFO) << "Done. Consumed 1 item.";
+            DLOG(INFO) << "Done. Consumed " << d_input_length << " samples.";
 
             break;
         }
@@ -453,7 +854,7 @@ int pcps_acquisition_cc::general_work(int noutput_items,
 
             d_active = false;
             d_state = 0;
-            d_sample_counter += d_fft_size * ninput_items[0]; // sample counter
+            d_sample_counter += ninput_items[0]; // sample counter
             consume_each(ninput_items[0]);
 
             acquisition_message = 1;
@@ -478,7 +879,7 @@ int pcps_acquisition_cc::general_work(int noutput_items,
             d_active = false;
             d_state = 0;
 
-            d_sample_counter += d_fft_size * ninput_items[0]; // sample counter
+            d_sample_counter += ninput_items[0]; // sample counter
             consume_each(ninput_items[0]);
             acquisition_message = 2;
             this->message_port_pub(pmt::mp("events"), pmt::from_long(acquisition_message));
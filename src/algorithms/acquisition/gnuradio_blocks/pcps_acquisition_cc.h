@@ -50,12 +50,20 @@
 #ifndef GNSS_SDR_PCPS_ACQUISITION_CC_H_
 #define GNSS_SDR_PCPS_ACQUISITION_CC_H_
 
-#include <fstream>
+#include <memory>
 #include <string>
+#include <vector>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 #include <gnuradio/block.h>
 #include <gnuradio/gr_complex.h>
 #include <gnuradio/fft/fft.h>
 #include "gnss_synchro.h"
+#include "doppler_grid_store.h"
+#include "gnss_sample_ring.h"
+#include "acquisition_grid_dump.h"
+#include "acquisition_decimator.h"
 
 class pcps_acquisition_cc;
 
@@ -66,9 +74,19 @@ pcps_make_acquisition_cc(unsigned int sampled_ms, unsigned int max_dwells,
                          unsigned int doppler_max, long freq, long fs_in,
                          int samples_per_ms, int samples_per_code,
                          bool bit_transition_flag, bool use_CFAR_algorithm_flag,
-                         bool dump,
+                         bool fft_zero_padding, bool dump,
                          std::string dump_filename);
 
+/*!
+ * \brief Strategies to combine consecutive dwells (see pcps_acquisition_cc::set_dwell_accumulation)
+ */
+enum Dwell_Accumulation
+{
+    DWELL_MAXIMUM = 0,     //!< Each dwell is an independent search (default)
+    DWELL_NONCOHERENT = 1, //!< Magnitudes of the search grid are added across dwells
+    DWELL_COHERENT = 2     //!< Complex correlations of the search grid are added across dwells
+};
+
 /*!
  * \brief This class implements a Parallel Code Phase Search Acquisition.
  *
@@ -83,17 +101,30 @@ private:
             unsigned int doppler_max, long freq, long fs_in,
             int samples_per_ms, int samples_per_code,
             bool bit_transition_flag, bool use_CFAR_algorithm_flag,
-            bool dump,
+            bool fft_zero_padding, bool dump,
             std::string dump_filename);
 
     pcps_acquisition_cc(unsigned int sampled_ms, unsigned int max_dwells,
             unsigned int doppler_max, long freq, long fs_in,
             int samples_per_ms, int samples_per_code,
             bool bit_transition_flag, bool use_CFAR_algorithm_flag,
-            bool dump,
+            bool fft_zero_padding, bool dump,
             std::string dump_filename);
 
-    void update_local_carrier(gr_complex* carrier_vector, int correlator_length_samples, float freq);
+    void allocate_grid();
+    std::string dump_filename() const;
+
+    // Searches one dwell and returns the next state of the block
+    int acquisition_core(const gr_complex* in, unsigned long int samplestamp);
+
+    // Pipelined mode: searches the buffered dwells, see set_pipelined()
+    void pipeline_worker();
+
+    // Takes the carriers of the window from Doppler_Grid_Store and resizes the grid if the window changed
+    void update_doppler_window(bool force);
+
+    // New threshold from the configuration file, see gnss_sdr_parameters.h
+    void msg_handler_parameters(pmt::pmt_t msg);
 
     long d_fs_in;
     long d_freq;
@@ -108,10 +139,14 @@ private:
     unsigned int d_max_dwells;
     unsigned int d_well_count;
     unsigned int d_fft_size;
+    unsigned int d_vector_length;      // Input samples per dwell (d_fft_size unless zero-padded)
+    unsigned int d_code_offset;        // Leading zeros of the local code in the FFT input
     unsigned long int d_sample_counter;
-    gr_complex** d_grid_doppler_wipeoffs;
+    std::shared_ptr<const Doppler_Grid> d_grid_doppler_wipeoffs;
     unsigned int d_num_doppler_bins;
-    gr_complex* d_fft_codes;
+    int d_doppler_center;              // Centre of the Doppler search, from Acquisition_Assistance [Hz]
+    unsigned int d_doppler_search_max; // Half width of the Doppler search, at most d_doppler_max [Hz]
+    std::shared_ptr<const gr_complex> d_fft_codes;
     gr::fft::fft_complex* d_fft_if;
     gr::fft::fft_complex* d_ifft;
     Gnss_Synchro *d_gnss_synchro;
@@ -123,12 +158,37 @@ private:
     float d_test_statistics;
     bool d_bit_transition_flag;
     bool d_use_CFAR_algorithm_flag;
-    std::ofstream d_dump_file;
+    unsigned int d_dwell_accumulation;
+    float* d_grid_magnitude;           // Non-coherent search grid (d_num_doppler_bins x d_fft_size)
+    gr_complex* d_grid_correlation;    // Coherent search grid (d_num_doppler_bins x d_fft_size)
+    unsigned int d_grid_size;          // Cells allocated in the search grid
+    float d_accumulated_power;         // Sum of the input power estimations of the dwells
     bool d_active;
     int d_state;
     bool d_dump;
     unsigned int d_channel;
     std::string d_dump_filename;
+    std::shared_ptr<Acquisition_Grid_Dump> d_grid_dump;  // One record per search, written by the dump I/O thread
+    bool d_pipelined;
+    std::vector<gr_complex*> d_dwell_buffers;             // Copies of the consecutive dwells of one acquisition
+    std::vector<unsigned long int> d_dwell_samplestamps;  // Sample counter at the end of each buffered dwell
+    unsigned int d_in_dwell_count;                        // Dwells buffered in this acquisition
+    bool d_core_working;
+    bool d_stop_worker;
+    boost::mutex d_mutex;                                 // Guards the state shared with the worker
+    boost::condition_variable d_dwell_ready;
+    boost::condition_variable d_dwell_done;
+    boost::thread d_worker;
+    unsigned int d_rf_channel;
+    std::shared_ptr<Gnss_Sample_Ring> d_ring;             // Conditioned samples by stamp, if the flowgraph keeps a ring
+    gr_complex* d_ring_window;                            // Dwell read from d_ring
+    unsigned long int d_ring_stamp;                       // Stamp of the first sample of the next dwell read from d_ring
+    unsigned int d_decimation;                            // Input samples per acquisition sample, see set_decimation()
+    unsigned int d_input_length;                          // Input samples per dwell (d_vector_length times d_decimation)
+    std::shared_ptr<Acquisition_Decimator> d_decimator;
+    gr_complex* d_decimated;                              // Dwell at the acquisition rate
+    std::shared_ptr<const gr_complex> d_full_rate_code;   // One code period at the input rate
+    unsigned int d_full_rate_code_length;
 
 public:
     /*!
@@ -165,6 +225,34 @@ public:
       */
      void set_local_code(std::complex<float> * code);
 
+     /*!
+      * \brief Sets the already conjugated FFT of the local code, typically
+      * obtained from the Fft_Code_Cache shared by all the channels.
+      * \param fft_code - Conjugated spectrum of length fft_size().
+      */
+     void set_local_code_fft(std::shared_ptr<const gr_complex> fft_code)
+     {
+         d_fft_codes = fft_code;
+     }
+
+     /*!
+      * \brief Returns the FFT length used by the block (doubled if
+      * bit_transition_flag is set, and then possibly zero-padded).
+      */
+     unsigned int fft_size()
+     {
+         return d_fft_size;
+     }
+
+     /*!
+      * \brief Returns the number of zeros placed before the local code in the
+      * FFT input (not zero only if bit_transition_flag is set).
+      */
+     unsigned int fft_code_offset()
+     {
+         return d_code_offset;
+     }
+
      /*!
       * \brief Starts acquisition algorithm, turning from standby mode to
       * active mode
@@ -219,6 +307,77 @@ public:
          d_doppler_step = doppler_step;
      }
 
+     /*!
+      * \brief Set how consecutive dwells are combined when max_dwells > 1.
+      * With DWELL_NONCOHERENT or DWELL_COHERENT the search grid of each dwell is
+      * added to a preallocated accumulation grid, and the test statistics are
+      * computed on the accumulated grid after every dwell, so that a strong signal
+      * still stops the search at the first dwell that clears the threshold.
+      * Coherent accumulation keeps the local carrier phase continuous between
+      * dwells, so it only helps while no data bit transition falls in the
+      * accumulated interval. Not available if bit_transition_flag is set.
+      * \param mode - one of the Dwell_Accumulation values.
+      */
+     void set_dwell_accumulation(unsigned int mode);
+
+     /*!
+      * \brief Set what the dump keeps of each search grid (see Acquisition_Grid_Dump).
+      * The grids of a channel go to one file, one record per search, and are
+      * written by the background dump writer. Must be called before the first search.
+      * \param delay_decimation - consecutive delays reduced to their maximum.
+      * \param roi_delays - delays kept on each side of the peak [samples], 0 for all.
+      * \param roi_doppler_bins - Doppler bins kept on each side of the peak, 0 for all.
+      */
+     void set_dump_options(unsigned int delay_decimation, unsigned int roi_delays, unsigned int roi_doppler_bins);
+
+     /*!
+      * \brief Set the signal conditioner feeding the channel. If the flowgraph keeps
+      * a Gnss_Sample_Ring of it (GNSS-SDR.sample_ring_ms), init() attaches the block
+      * to the ring, and each acquisition searches the freshest dwell of the ring,
+      * and the dwells that follow it, instead of the oldest one of its input buffer.
+      * The ring is not used in pipelined mode.
+      * \param rf_channel - RF channel ID of the channel.
+      */
+     void set_rf_channel(unsigned int rf_channel)
+     {
+         d_rf_channel = rf_channel;
+     }
+
+     /*!
+      * \brief Pipelined mode. The block copies up to max_dwells consecutive
+      * dwells into its own buffers and searches them in a worker thread, so it
+      * keeps consuming its input instead of stalling the stream while the
+      * Doppler bins are searched. The next dwell is buffered while the previous
+      * one is searched, and the input that arrives once all the dwells are buffered
+      * is skipped. The result is posted by the worker as soon as it is known, with
+      * the sample stamp of the dwell it was found in. It can only be enabled once,
+      * before the flowgraph starts.
+      */
+     void set_pipelined(bool pipelined);
+
+     /*!
+      * \brief Reduced-rate acquisition. The block reads dwells of decimation
+      * times the samples it was made for, low-pass filters and decimates them
+      * to the rate it was made for (fs_in), and searches them there. The code
+      * delay of the peak is then refined at the input rate, with direct
+      * correlations against the code of set_full_rate_code() around it, so that
+      * Acq_delay_samples and Acq_samplestamp_samples are in input samples.
+      * Must be called before set_pipelined() and before the flowgraph starts.
+      * Not available with bit_transition_flag.
+      * \param decimation - input rate over fs_in.
+      */
+     void set_decimation(unsigned int decimation);
+
+     /*!
+      * \brief Set one code period at the input rate, for the refinement of
+      * the code delay (see set_decimation).
+      */
+     void set_full_rate_code(std::shared_ptr<const gr_complex> code, unsigned int code_length)
+     {
+         d_full_rate_code = code;
+         d_full_rate_code_length = code_length;
+     }
+
      /*!
       * \brief Parallel Code Phase Search Acquisition signal processing.
       */
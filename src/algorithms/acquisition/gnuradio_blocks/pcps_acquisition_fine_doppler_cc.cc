@@ -31,7 +31,9 @@
  */
 
 #include "pcps_acquisition_fine_doppler_cc.h"
-#include <algorithm>    // std::rotate
+#include <algorithm>    // std::rotate, std::partial_sort
+#include <functional>
+#include <vector>
 #include <sstream>
 #include <glog/logging.h>
 #include <gnuradio/io_signature.h>
@@ -40,7 +42,13 @@
 #include "concurrent_map.h"
 #include "gps_sdr_signal_processing.h"
 #include "control_message_factory.h"
+#include "fft_planner.h"
 #include "GPS_L1_CA.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
+
+// Code phases [samples] searched by the fine pass at each side of a coarse cell
+#define COARSE_CODE_PHASE_WINDOW 2
 
 using google::LogMessage;
 
@@ -80,15 +88,16 @@ pcps_acquisition_fine_doppler_cc::pcps_acquisition_fine_doppler_cc(
     d_gnuradio_forecast_samples = d_fft_size;
     d_input_power = 0.0;
     d_state = 0;
-    d_carrier = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-    d_fft_codes = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-    d_magnitude = static_cast<float*>(volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
+    d_carrier = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
+    d_fft_codes = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
+    d_magnitude = static_cast<float*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
 
     // Direct FFT
-    d_fft_if = new gr::fft::fft_complex(d_fft_size, true);
+    d_fft_if = new gr::fft::fft_complex(d_fft_size, true, Fft_Planner::instance().threads(d_fft_size));
 
     // Inverse FFT
-    d_ifft = new gr::fft::fft_complex(d_fft_size, false);
+    d_ifft = new gr::fft::fft_complex(d_fft_size, false, Fft_Planner::instance().threads(d_fft_size));
+    Gnss_Sdr_Memory_Accounting::add_fft(d_fft_size, 2);
 
     // For dumping samples into a file
     d_dump = dump;
@@ -106,6 +115,14 @@ pcps_acquisition_fine_doppler_cc::pcps_acquisition_fine_doppler_cc(
     d_test_statistics = 0;
     d_well_count = 0;
     d_channel = 0;
+
+    d_coarse_doppler_step = 0;
+    d_num_candidates = 0;
+    d_num_coarse_doppler_points = 0;
+    d_coarse_fft_size = d_samples_per_ms;
+    d_coarse_grid_data = 0;
+    d_coarse_grid_doppler_wipeoffs = 0;
+    d_coarse_fft_codes = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_coarse_fft_size * sizeof(gr_complex), volk_get_alignment()));
 }
 
 void pcps_acquisition_fine_doppler_cc::set_doppler_step(unsigned int doppler_step)
@@ -118,16 +135,69 @@ void pcps_acquisition_fine_doppler_cc::set_doppler_step(unsigned int doppler_ste
     d_grid_data = new float*[d_num_doppler_points];
     for (int i = 0; i < d_num_doppler_points; i++)
         {
-            d_grid_data[i] = static_cast<float*>(volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
+            d_grid_data[i] = static_cast<float*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
         }
     update_carrier_wipeoff();
+
+    if (d_coarse_doppler_step > 0)
+        {
+            update_coarse_carrier_wipeoff();
+        }
+}
+
+
+void pcps_acquisition_fine_doppler_cc::set_coarse_search(unsigned int coarse_doppler_step, unsigned int num_candidates)
+{
+    d_coarse_doppler_step = coarse_doppler_step;
+    d_num_candidates = std::max(num_candidates, 1u);
+    if (d_coarse_doppler_step > 0 && !d_coarse_fft_if)
+        {
+            d_coarse_fft_if = Fft_Planner::instance().acquire(d_coarse_fft_size, true);
+            d_coarse_ifft = Fft_Planner::instance().acquire(d_coarse_fft_size, false);
+        }
+}
+
+
+void pcps_acquisition_fine_doppler_cc::update_coarse_carrier_wipeoff()
+{
+    free_coarse_grid_memory();
+
+    // The coarse grid spans [doppler_min, doppler_max], both included
+    d_num_coarse_doppler_points = floor(std::abs(d_config_doppler_max - d_config_doppler_min) / static_cast<int>(d_coarse_doppler_step)) + 1;
+    d_coarse_grid_data = new float*[d_num_coarse_doppler_points];
+    d_coarse_grid_doppler_wipeoffs = new gr_complex*[d_num_coarse_doppler_points];
+    for (int doppler_index = 0; doppler_index < d_num_coarse_doppler_points; doppler_index++)
+        {
+            int doppler_hz = d_config_doppler_min + d_coarse_doppler_step * doppler_index;
+            float phase_step_rad = static_cast<float>(GPS_TWO_PI) * ( d_freq + doppler_hz ) / static_cast<float>(d_fs_in);
+            float _phase[1];
+            _phase[0] = 0;
+            d_coarse_grid_doppler_wipeoffs[doppler_index] = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_coarse_fft_size * sizeof(gr_complex), volk_get_alignment()));
+            volk_gnsssdr_s32f_sincos_32fc(d_coarse_grid_doppler_wipeoffs[doppler_index], - phase_step_rad, _phase, d_coarse_fft_size);
+            d_coarse_grid_data[doppler_index] = static_cast<float*>(gnss_sdr_volk_malloc(d_coarse_fft_size * sizeof(float), volk_get_alignment()));
+        }
+}
+
+
+void pcps_acquisition_fine_doppler_cc::free_coarse_grid_memory()
+{
+    for (int i = 0; i < d_num_coarse_doppler_points; i++)
+        {
+            gnss_sdr_volk_free(d_coarse_grid_data[i]);
+            gnss_sdr_volk_free(d_coarse_grid_doppler_wipeoffs[i]);
+        }
+    delete[] d_coarse_grid_data;
+    delete[] d_coarse_grid_doppler_wipeoffs;
+    d_coarse_grid_data = 0;
+    d_coarse_grid_doppler_wipeoffs = 0;
+    d_num_coarse_doppler_points = 0;
 }
 
 void pcps_acquisition_fine_doppler_cc::free_grid_memory()
 {
     for (int i = 0; i < d_num_doppler_points; i++)
         {
-            volk_free(d_grid_data[i]);
+            gnss_sdr_volk_free(d_grid_data[i]);
             delete[] d_grid_doppler_wipeoffs[i];
         }
     delete d_grid_data;
@@ -136,9 +206,10 @@ void pcps_acquisition_fine_doppler_cc::free_grid_memory()
 
 pcps_acquisition_fine_doppler_cc::~pcps_acquisition_fine_doppler_cc()
 {
-    volk_free(d_carrier);
-    volk_free(d_fft_codes);
-    volk_free(d_magnitude);
+    gnss_sdr_volk_free(d_carrier);
+    gnss_sdr_volk_free(d_fft_codes);
+    gnss_sdr_volk_free(d_magnitude);
+    gnss_sdr_volk_free(d_coarse_fft_codes);
     delete d_ifft;
     delete d_fft_if;
     if (d_dump)
@@ -146,6 +217,7 @@ pcps_acquisition_fine_doppler_cc::~pcps_acquisition_fine_doppler_cc()
             d_dump_file.close();
         }
     free_grid_memory();
+    free_coarse_grid_memory();
 }
 
 
@@ -157,6 +229,14 @@ void pcps_acquisition_fine_doppler_cc::set_local_code(std::complex<float> * code
     d_fft_if->execute(); // We need the FFT of local code
     //Conjugate the local code
     volk_32fc_conjugate_32fc(d_fft_codes, d_fft_if->get_outbuf(), d_fft_size);
+
+    if (d_coarse_fft_if)
+        {
+            // The coarse pass correlates a single code period
+            memcpy(d_coarse_fft_if->get_inbuf(), code, sizeof(gr_complex) * d_coarse_fft_size);
+            d_coarse_fft_if->execute();
+            volk_32fc_conjugate_32fc(d_coarse_fft_codes, d_coarse_fft_if->get_outbuf(), d_coarse_fft_size);
+        }
 }
 
 void pcps_acquisition_fine_doppler_cc::init()
@@ -195,6 +275,10 @@ void pcps_acquisition_fine_doppler_cc::reset_grid()
                     d_grid_data[i][j] = 0.0;
                 }
         }
+    for (int i = 0; i < d_num_coarse_doppler_points; i++)
+        {
+            std::fill_n(d_coarse_grid_data[i], d_coarse_fft_size, 0.0);
+        }
 }
 
 
@@ -297,7 +381,7 @@ int pcps_acquisition_fine_doppler_cc::compute_and_accumulate_grid(gr_vector_cons
 
 
     // 2- Doppler frequency search loop
-    float* p_tmp_vector = static_cast<float*>(volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
+    float* p_tmp_vector = static_cast<float*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
 
     for (int doppler_index = 0; doppler_index < d_num_doppler_points; doppler_index++)
         {
@@ -323,10 +407,117 @@ int pcps_acquisition_fine_doppler_cc::compute_and_accumulate_grid(gr_vector_cons
 
         }
 
-    volk_free(p_tmp_vector);
+    gnss_sdr_volk_free(p_tmp_vector);
+    return d_fft_size;
+}
+
+int pcps_acquisition_fine_doppler_cc::compute_and_accumulate_coarse_grid(gr_vector_const_void_star &input_items)
+{
+    const gr_complex *in = (const gr_complex *)input_items[0]; //Get the input samples pointer
+
+    DLOG(INFO) << "Channel: " << d_channel
+            << " , doing coarse acquisition of satellite: " << d_gnss_synchro->System << " "<< d_gnss_synchro->PRN
+            << " ,sample stamp: " << d_sample_counter << ", coarse doppler_step: " << d_coarse_doppler_step;
+
+    float* p_tmp_vector = static_cast<float*>(gnss_sdr_volk_malloc(d_coarse_fft_size * sizeof(float), volk_get_alignment()));
+
+    // Same as compute_and_accumulate_grid, on the first code period of the input
+    for (int doppler_index = 0; doppler_index < d_num_coarse_doppler_points; doppler_index++)
+        {
+            volk_32fc_x2_multiply_32fc(d_coarse_fft_if->get_inbuf(), in, d_coarse_grid_doppler_wipeoffs[doppler_index], d_coarse_fft_size);
+            d_coarse_fft_if->execute();
+            volk_32fc_x2_multiply_32fc(d_coarse_ifft->get_inbuf(), d_coarse_fft_if->get_outbuf(), d_coarse_fft_codes, d_coarse_fft_size);
+            d_coarse_ifft->execute();
+            volk_32fc_magnitude_squared_32f(p_tmp_vector, d_coarse_ifft->get_outbuf(), d_coarse_fft_size);
+            volk_32f_x2_add_32f(d_coarse_grid_data[doppler_index], d_coarse_grid_data[doppler_index], p_tmp_vector, d_coarse_fft_size);
+        }
+
+    gnss_sdr_volk_free(p_tmp_vector);
     return d_fft_size;
 }
 
+
+double pcps_acquisition_fine_doppler_cc::search_candidates(gr_vector_const_void_star &input_items)
+{
+    const gr_complex *in = (const gr_complex *)input_items[0]; //Get the input samples pointer
+#if VOLK_GT_122
+    uint16_t tmp_intex_t = 0;
+#else
+    unsigned int tmp_intex_t = 0;
+#endif
+
+    // 1- Keep the strongest cell of each coarse Doppler line, and select the best ones
+    std::vector<std::pair<float, int>> coarse_peaks(d_num_coarse_doppler_points);
+    std::vector<unsigned int> coarse_code_phases(d_num_coarse_doppler_points);
+    for (int i = 0; i < d_num_coarse_doppler_points; i++)
+        {
+            volk_32f_index_max_16u(&tmp_intex_t, d_coarse_grid_data[i], d_coarse_fft_size);
+            coarse_peaks[i] = std::make_pair(d_coarse_grid_data[i][tmp_intex_t], i);
+            coarse_code_phases[i] = tmp_intex_t;
+        }
+    unsigned int num_candidates = std::min(d_num_candidates, static_cast<unsigned int>(d_num_coarse_doppler_points));
+    std::partial_sort(coarse_peaks.begin(), coarse_peaks.begin() + num_candidates, coarse_peaks.end(),
+            std::greater<std::pair<float, int>>());
+
+    // 2- Fine pass on the current input, only in the Doppler bins within half a
+    // coarse bin of each candidate, and only next to its code phase
+    std::vector<bool> computed(d_num_doppler_points, false);
+    float magt = 0.0;
+    int index_doppler = 0;
+    unsigned int index_time = 0;
+    unsigned int fine_bins = 0;
+    for (unsigned int c = 0; c < num_candidates; c++)
+        {
+            int coarse_index = coarse_peaks[c].second;
+            int coarse_doppler_hz = d_config_doppler_min + d_coarse_doppler_step * coarse_index;
+            for (int doppler_index = 0; doppler_index < d_num_doppler_points; doppler_index++)
+                {
+                    int doppler_hz = d_config_doppler_min + d_doppler_step * doppler_index;
+                    if (2 * std::abs(doppler_hz - coarse_doppler_hz) > static_cast<int>(d_coarse_doppler_step))
+                        {
+                            continue;
+                        }
+                    if (!computed[doppler_index])
+                        {
+                            volk_32fc_x2_multiply_32fc(d_fft_if->get_inbuf(), in, d_grid_doppler_wipeoffs[doppler_index], d_fft_size);
+                            d_fft_if->execute();
+                            volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(), d_fft_if->get_outbuf(), d_fft_codes, d_fft_size);
+                            d_ifft->execute();
+                            volk_32fc_magnitude_squared_32f(d_grid_data[doppler_index], d_ifft->get_outbuf(), d_fft_size);
+                            computed[doppler_index] = true;
+                            fine_bins++;
+                        }
+                    for (int offset = -COARSE_CODE_PHASE_WINDOW; offset <= COARSE_CODE_PHASE_WINDOW; offset++)
+                        {
+                            unsigned int code_phase = (coarse_code_phases[coarse_index] + d_coarse_fft_size + offset) % d_coarse_fft_size;
+                            if (d_grid_data[doppler_index][code_phase] > magt)
+                                {
+                                    magt = d_grid_data[doppler_index][code_phase];
+                                    index_doppler = doppler_index;
+                                    index_time = code_phase;
+                                }
+                        }
+                }
+        }
+
+    DLOG(INFO) << "Coarse-to-fine search: " << num_candidates << " candidates, "
+               << fine_bins << " of " << d_num_doppler_points << " fine Doppler bins";
+
+    // Normalize the maximum value to correct the scale factor introduced by FFTW
+    float fft_normalization_factor = static_cast<float>(d_fft_size) * static_cast<float>(d_fft_size);
+    magt = magt / (fft_normalization_factor * fft_normalization_factor);
+
+    // 3- Compute the test statistics (the fine pass is a single dwell)
+    d_test_statistics = magt / d_input_power;
+
+    d_gnss_synchro->Acq_delay_samples = static_cast<double>(index_time);
+    d_gnss_synchro->Acq_doppler_hz = static_cast<double>(index_doppler * d_doppler_step + d_config_doppler_min);
+    d_gnss_synchro->Acq_samplestamp_samples = d_sample_counter;
+
+    return d_test_statistics;
+}
+
+
 int pcps_acquisition_fine_doppler_cc::estimate_Doppler(gr_vector_const_void_star &input_items)
 {
 
@@ -339,7 +530,7 @@ int pcps_acquisition_fine_doppler_cc::estimate_Doppler(gr_vector_const_void_star
     memset(fft_operator->get_inbuf(), 0, fft_size_extended * sizeof(gr_complex));
 
     //1. generate local code aligned with the acquisition code phase estimation
-    gr_complex *code_replica = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
+    gr_complex *code_replica = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
 
     gps_l1_ca_code_gen_complex_sampled(code_replica, d_gnss_synchro->PRN, d_fs_in, 0);
 
@@ -360,7 +551,7 @@ int pcps_acquisition_fine_doppler_cc::estimate_Doppler(gr_vector_const_void_star
     fft_operator->execute();
 
     // 4. Compute the magnitude and find the maximum
-    float* p_tmp_vector = static_cast<float*>(volk_malloc(fft_size_extended * sizeof(float), volk_get_alignment()));
+    float* p_tmp_vector = static_cast<float*>(gnss_sdr_volk_malloc(fft_size_extended * sizeof(float), volk_get_alignment()));
 
     volk_32fc_magnitude_squared_32f(p_tmp_vector, fft_operator->get_outbuf(), fft_size_extended);
 
@@ -432,8 +623,8 @@ int pcps_acquisition_fine_doppler_cc::estimate_Doppler(gr_vector_const_void_star
 
     // free memory!!
     delete fft_operator;
-    volk_free(code_replica);
-    volk_free(p_tmp_vector);
+    gnss_sdr_volk_free(code_replica);
+    gnss_sdr_volk_free(p_tmp_vector);
     return d_fft_size;
 }
 
@@ -442,6 +633,7 @@ int pcps_acquisition_fine_doppler_cc::general_work(int noutput_items,
         gr_vector_int &ninput_items __attribute__((unused)), gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items __attribute__((unused)))
 {
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("pcps_acquisition_fine_doppler_cc::general_work", d_channel, d_gnss_synchro ? d_gnss_synchro->PRN : 0);
 
     /*!
      * TODO:     High sensitivity acquisition algorithm:
@@ -469,7 +661,14 @@ int pcps_acquisition_fine_doppler_cc::general_work(int noutput_items,
         break;
     case 1: // S1. ComputeGrid
         //DLOG(INFO) <<"S1"<<std::endl;
-        compute_and_accumulate_grid(input_items);
+        if (d_coarse_doppler_step > 0)
+            {
+                compute_and_accumulate_coarse_grid(input_items);
+            }
+        else
+            {
+                compute_and_accumulate_grid(input_items);
+            }
         d_well_count++;
         if (d_well_count >= d_max_dwells)
             {
@@ -479,7 +678,14 @@ int pcps_acquisition_fine_doppler_cc::general_work(int noutput_items,
     case 2: // Compute test statistics and decide
         //DLOG(INFO) <<"S2"<<std::endl;
         d_input_power = estimate_input_power(input_items);
-        d_test_statistics = search_maximum();
+        if (d_coarse_doppler_step > 0)
+            {
+                d_test_statistics = search_candidates(input_items);
+            }
+        else
+            {
+                d_test_statistics = search_maximum();
+            }
         if (d_test_statistics > d_threshold)
             {
                 d_state = 3; //perform fine doppler estimation
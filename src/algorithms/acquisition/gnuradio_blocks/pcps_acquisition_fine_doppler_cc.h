@@ -49,6 +49,7 @@
 #define GNSS_SDR_PCPS_ACQUISITION_FINE_DOPPLER_CC_H_
 
 #include <fstream>
+#include <memory>
 #include <string>
 #include <gnuradio/block.h>
 #include <gnuradio/gr_complex.h>
@@ -97,6 +98,12 @@ private:
     void update_carrier_wipeoff();
     void free_grid_memory();
 
+    // Coarse-to-fine search
+    void update_coarse_carrier_wipeoff();
+    void free_coarse_grid_memory();
+    int compute_and_accumulate_coarse_grid(gr_vector_const_void_star &input_items);
+    double search_candidates(gr_vector_const_void_star &input_items);
+
     long d_fs_in;
     long d_freq;
     int d_samples_per_ms;
@@ -122,6 +129,17 @@ private:
 
     gr::fft::fft_complex* d_fft_if;
     gr::fft::fft_complex* d_ifft;
+
+    unsigned int d_coarse_doppler_step;       // 0 if the coarse pass is disabled
+    unsigned int d_num_candidates;            // Coarse cells refined by the fine pass
+    int d_num_coarse_doppler_points;
+    unsigned int d_coarse_fft_size;           // One code period
+    float** d_coarse_grid_data;
+    gr_complex** d_coarse_grid_doppler_wipeoffs;
+    gr_complex* d_coarse_fft_codes;
+    std::shared_ptr<gr::fft::fft_complex> d_coarse_fft_if;
+    std::shared_ptr<gr::fft::fft_complex> d_coarse_ifft;
+
     Gnss_Synchro *d_gnss_synchro;
     unsigned int d_code_phase;
     float d_doppler_freq;
@@ -215,6 +233,17 @@ public:
      */
     void set_doppler_step(unsigned int doppler_step);
 
+    /*!
+     * \brief Enables a two-stage search. The dwells are first accumulated on a
+     * coarse grid of one code period and coarse_doppler_step Hz bins, and then
+     * only the fine Doppler bins around the num_candidates strongest coarse
+     * cells are correlated, with the peak search restricted to the code phases
+     * next to each candidate. Must be called before set_doppler_step.
+     * \param coarse_doppler_step - Frequency bin of the coarse grid [Hz], 0 disables it.
+     * \param num_candidates - Number of coarse cells refined by the fine pass.
+     */
+    void set_coarse_search(unsigned int coarse_doppler_step, unsigned int num_candidates);
+
 
     /*!
      * \brief Parallel Code Phase Search Acquisition signal processing.
@@ -33,29 +33,99 @@
  */
 
 #include "pcps_acquisition_sc.h"
+#include <cmath>
 #include <sstream>
 #include <boost/filesystem.hpp>
 #include <gnuradio/io_signature.h>
 #include <glog/logging.h>
-#include <volk/volk.h>
 #include <volk_gnsssdr/volk_gnsssdr.h>
 #include "control_message_factory.h"
-#include "GPS_L1_CA.h" //GPS_TWO_PI
+#include "acquisition_assistance.h"
+#include "gnss_sdr_trace.h"
 
 using google::LogMessage;
 
+namespace
+{
+// Writes the correlation of each Doppler bin of a search to its own file
+class Doppler_Bin_Dump
+{
+public:
+    Doppler_Bin_Dump(const std::string & dump_filename, const Gnss_Synchro & synchro,
+            const Doppler_Grid & grid, int doppler_center, unsigned int fft_size) :
+        d_filename(dump_filename), d_synchro(synchro), d_grid(grid),
+        d_doppler_center(doppler_center), d_fft_size(fft_size)
+    {}
+
+    void operator()(unsigned int doppler_index, const gr_complex* correlation)
+    {
+        std::stringstream filename;
+        std::ofstream dump_file;
+        std::streamsize n = 2 * sizeof(float) * (d_fft_size); // complex file write
+        boost::filesystem::path p = d_filename;
+        filename << p.parent_path().string()
+                 << boost::filesystem::path::preferred_separator
+                 << p.stem().string()
+                 << "_" << d_synchro.System
+                 <<"_" << d_synchro.Signal << "_sat_"
+                 << d_synchro.PRN << "_doppler_"
+                 << d_doppler_center + d_grid.doppler(doppler_index)
+                 << p.extension().string();
+
+        DLOG(INFO) << "Writing ACQ out to " << filename.str();
+
+        dump_file.open(filename.str().c_str(), std::ios::out | std::ios::binary);
+        dump_file.write((char*)correlation, n); //write directly |abs(x)|^2 in this Doppler bin?
+        dump_file.close();
+    }
+
+private:
+    const std::string & d_filename;
+    const Gnss_Synchro & d_synchro;
+    const Doppler_Grid & d_grid;
+    int d_doppler_center;
+    unsigned int d_fft_size;
+};
+
+
+template<class Detector, class Sample>
+Pcps_Search_Result search_samples(Pcps_Search_Core & core, const void* in,
+        const Doppler_Grid & grid, Doppler_Bin_Dump* dump)
+{
+    const Sample* samples = static_cast<const Sample*>(in);
+    if (dump != 0)
+        {
+            return core.search<Detector>(samples, grid, *dump);
+        }
+    return core.search<Detector>(samples, grid);
+}
+
+
+template<class Detector>
+Pcps_Search_Result search_samples(Pcps_Search_Core & core, const void* in, size_t it_size,
+        const Doppler_Grid & grid, Doppler_Bin_Dump* dump)
+{
+    if (it_size == sizeof(lv_8sc_t))
+        {
+            return search_samples<Detector, lv_8sc_t>(core, in, grid, dump);
+        }
+    return search_samples<Detector, lv_16sc_t>(core, in, grid, dump);
+}
+}
+
+
 pcps_acquisition_sc_sptr pcps_make_acquisition_sc(
                                  unsigned int sampled_ms, unsigned int max_dwells,
                                  unsigned int doppler_max, long freq, long fs_in,
                                  int samples_per_ms, int samples_per_code,
                                  bool bit_transition_flag, bool use_CFAR_algorithm_flag,
                                  bool dump,
-                                 std::string dump_filename)
+                                 std::string dump_filename, size_t it_size)
 {
 
     return pcps_acquisition_sc_sptr(
             new pcps_acquisition_sc(sampled_ms, max_dwells, doppler_max, freq, fs_in, samples_per_ms,
-                                     samples_per_code, bit_transition_flag, use_CFAR_algorithm_flag, dump, dump_filename));
+                                     samples_per_code, bit_transition_flag, use_CFAR_algorithm_flag, dump, dump_filename, it_size));
 }
 
 pcps_acquisition_sc::pcps_acquisition_sc(
@@ -64,10 +134,11 @@ pcps_acquisition_sc::pcps_acquisition_sc(
                          int samples_per_ms, int samples_per_code,
                          bool bit_transition_flag, bool use_CFAR_algorithm_flag,
                          bool dump,
-                         std::string dump_filename) :
+                         std::string dump_filename, size_t it_size) :
     gr::block("pcps_acquisition_sc",
-    gr::io_signature::make(1, 1, sizeof(lv_16sc_t) * sampled_ms * samples_per_ms * ( bit_transition_flag ? 2 : 1 )),
-    gr::io_signature::make(0, 0, 0))
+    gr::io_signature::make(1, 1, it_size * sampled_ms * samples_per_ms * ( bit_transition_flag ? 2 : 1 )),
+    gr::io_signature::make(0, 0, 0)),
+    d_core(samples_per_code, sampled_ms * samples_per_ms * (bit_transition_flag ? 2 : 1), bit_transition_flag)
 {
     this->message_port_register_out(pmt::mp("events"));
     d_sample_counter = 0;    // SAMPLE COUNTER
@@ -85,6 +156,8 @@ pcps_acquisition_sc::pcps_acquisition_sc(
     d_mag = 0;
     d_input_power = 0.0;
     d_num_doppler_bins = 0;
+    d_doppler_center = 0;
+    d_doppler_search_max = doppler_max;
     d_bit_transition_flag = bit_transition_flag;
     d_use_CFAR_algorithm_flag = use_CFAR_algorithm_flag;
     d_threshold = 0.0;
@@ -93,6 +166,7 @@ pcps_acquisition_sc::pcps_acquisition_sc(
     d_test_statistics = 0.0;
     d_channel = 0;
     d_doppler_freq = 0.0;
+    d_it_size = it_size;
 
     //set_relative_rate( 1.0/d_fft_size );
 
@@ -112,44 +186,16 @@ pcps_acquisition_sc::pcps_acquisition_sc(
             d_max_dwells = 1;
         }
 
-    d_fft_codes = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-    d_magnitude = static_cast<float*>(volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
-    //temporary storage for the input conversion from 16sc to float 32fc
-    d_in_32fc = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-
-    // Direct FFT
-    d_fft_if = new gr::fft::fft_complex(d_fft_size, true);
-
-    // Inverse FFT
-    d_ifft = new gr::fft::fft_complex(d_fft_size, false);
-
     // For dumping samples into a file
     d_dump = dump;
     d_dump_filename = dump_filename;
 
     d_gnss_synchro = 0;
-    d_grid_doppler_wipeoffs = 0;
 }
 
 
 pcps_acquisition_sc::~pcps_acquisition_sc()
 {
-    if (d_num_doppler_bins > 0)
-        {
-            for (unsigned int i = 0; i < d_num_doppler_bins; i++)
-                {
-                    volk_free(d_grid_doppler_wipeoffs[i]);
-                }
-            delete[] d_grid_doppler_wipeoffs;
-        }
-
-    volk_free(d_fft_codes);
-    volk_free(d_magnitude);
-    volk_free(d_in_32fc);
-
-    delete d_ifft;
-    delete d_fft_if;
-
     if (d_dump)
         {
             d_dump_file.close();
@@ -159,28 +205,8 @@ pcps_acquisition_sc::~pcps_acquisition_sc()
 
 void pcps_acquisition_sc::set_local_code(std::complex<float> * code)
 {
-    // COD
-    // Here we want to create a buffer that looks like this:
-    // [ 0 0 0 ... 0 c_0 c_1 ... c_L]
-    // where c_i is the local code and there are L zeros and L chips
-    int offset = 0;
-    if( d_bit_transition_flag )
-        {
-            std::fill_n( d_fft_if->get_inbuf(), d_samples_per_code, gr_complex( 0.0, 0.0 ) );
-            offset = d_samples_per_code;
-        }
-    memcpy(d_fft_if->get_inbuf() + offset, code, sizeof(gr_complex) * d_samples_per_code);
-    d_fft_if->execute(); // We need the FFT of local code
-    volk_32fc_conjugate_32fc(d_fft_codes, d_fft_if->get_outbuf(), d_fft_size);
-}
-
-
-void pcps_acquisition_sc::update_local_carrier(gr_complex* carrier_vector, int correlator_length_samples, float freq)
-{
-    float phase_step_rad = GPS_TWO_PI * freq / static_cast<float>(d_fs_in);
-    float _phase[1];
-    _phase[0] = 0;
-    volk_gnsssdr_s32f_sincos_32fc(carrier_vector, - phase_step_rad, _phase, correlator_length_samples);
+    // COD: with bit transitions the code goes after d_samples_per_code zeros
+    d_core.set_local_code(code);
 }
 
 
@@ -198,19 +224,32 @@ void pcps_acquisition_sc::init()
     d_mag = 0.0;
     d_input_power = 0.0;
 
-    d_num_doppler_bins = ceil( static_cast<double>(static_cast<int>(d_doppler_max) - static_cast<int>(-d_doppler_max)) / static_cast<double>(d_doppler_step));
+    update_doppler_window(true);
+}
 
-    // Create the carrier Doppler wipeoff signals
-    d_grid_doppler_wipeoffs = new gr_complex*[d_num_doppler_bins];
 
-    for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+void pcps_acquisition_sc::update_doppler_window(bool force)
+{
+    int doppler_center = 0;
+    unsigned int doppler_search_max = d_doppler_max;
+    if (d_gnss_synchro != 0)
         {
-            d_grid_doppler_wipeoffs[doppler_index] = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-            int doppler = -static_cast<int>(d_doppler_max) + d_doppler_step * doppler_index;
-            update_local_carrier(d_grid_doppler_wipeoffs[doppler_index], d_fft_size, d_freq + doppler);
+            Acquisition_Assistance::doppler_window(*d_gnss_synchro, d_doppler_max, d_doppler_step,
+                    doppler_center, doppler_search_max, static_cast<double>(d_sample_counter) / static_cast<double>(d_fs_in));
         }
-}
+    if (!force && doppler_center == d_doppler_center && doppler_search_max == d_doppler_search_max)
+        {
+            return;
+        }
+    d_doppler_center = doppler_center;
+    d_doppler_search_max = doppler_search_max;
 
+    d_num_doppler_bins = ceil( static_cast<double>(static_cast<int>(d_doppler_search_max) - static_cast<int>(-d_doppler_search_max)) / static_cast<double>(d_doppler_step));
+
+    // Get the carrier Doppler wipeoff signals, shared with the other channels
+    d_grid_doppler_wipeoffs = Doppler_Grid_Store::instance().get(d_fs_in, d_freq + d_doppler_center,
+            d_fft_size, d_doppler_search_max, d_doppler_step, d_num_doppler_bins);
+}
 
 
 void pcps_acquisition_sc::set_state(int state)
@@ -218,6 +257,7 @@ void pcps_acquisition_sc::set_state(int state)
     d_state = state;
     if (d_state == 1)
         {
+            update_doppler_window(false);
             d_gnss_synchro->Acq_delay_samples = 0.0;
             d_gnss_synchro->Acq_doppler_hz = 0.0;
             d_gnss_synchro->Acq_samplestamp_samples = 0;
@@ -238,6 +278,7 @@ int pcps_acquisition_sc::general_work(int noutput_items,
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items __attribute__((unused)))
 {
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("pcps_acquisition_sc::general_work", d_channel, d_gnss_synchro ? d_gnss_synchro->PRN : 0);
     /*
      * By J.Arribas, L.Esteve and M.Molina
      * Acquisition strategy (Kay Borre book + CFAR threshold):
@@ -257,6 +298,7 @@ int pcps_acquisition_sc::general_work(int noutput_items,
         {
             if (d_active)
                 {
+                    update_doppler_window(false);
                     //restart acquisition variables
                     d_gnss_synchro->Acq_delay_samples = 0.0;
                     d_gnss_synchro->Acq_doppler_hz = 0.0;
@@ -280,21 +322,6 @@ int pcps_acquisition_sc::general_work(int noutput_items,
     case 1:
         {
             // initialize acquisition algorithm
-            int doppler;
-#if VOLK_GT_122
-            uint16_t indext = 0;
-#else
-            unsigned int indext = 0;
-#endif
-            float magt = 0.0;
-            const lv_16sc_t *in = (const lv_16sc_t *)input_items[0]; //Get the input samples pointer
-            int effective_fft_size = ( d_bit_transition_flag ? d_fft_size/2 : d_fft_size );
-
-            //TODO: optimize the signal processing chain to not use gr_complex. This is a temporary solution
-            volk_gnsssdr_16ic_convert_32fc(d_in_32fc,in,effective_fft_size);
-
-            float fft_normalization_factor = static_cast<float>(d_fft_size) * static_cast<float>(d_fft_size);
-
             d_mag = 0.0;
 
             d_sample_counter += d_fft_size; // sample counter
@@ -304,105 +331,43 @@ int pcps_acquisition_sc::general_work(int noutput_items,
                        << " , doing acquisition of satellite: " << d_gnss_synchro->System << " "<< d_gnss_synchro->PRN
                        << " ,sample stamp: " << d_sample_counter << ", threshold: "
                        << d_threshold << ", doppler_max: " << d_doppler_max
-                       << ", doppler_step: " << d_doppler_step;
+                       << ", doppler_step: " << d_doppler_step
+                       << ", doppler search: " << d_doppler_center << " +/- " << d_doppler_search_max;
 
+            // 1- (optional) Compute the input signal power estimation
+            // 2- Doppler frequency search loop
+            // 3- Perform the FFT-based convolution  (parallel time search)
+            Doppler_Bin_Dump dump(d_dump_filename, *d_gnss_synchro, *d_grid_doppler_wipeoffs, d_doppler_center, d_fft_size);
+            Doppler_Bin_Dump* bin_dump = d_dump ? &dump : 0;
+            Pcps_Search_Result result;
             if (d_use_CFAR_algorithm_flag == true)
                 {
-                    // 1- (optional) Compute the input signal power estimation
-                    volk_32fc_magnitude_squared_32f(d_magnitude, d_in_32fc, d_fft_size);
-                    volk_32f_accumulator_s32f(&d_input_power, d_magnitude, d_fft_size);
-                    d_input_power /= static_cast<float>(d_fft_size);
+                    result = search_samples<Pcps_Cfar_Detector>(d_core, input_items[0], d_it_size, *d_grid_doppler_wipeoffs, bin_dump);
                 }
-            // 2- Doppler frequency search loop
-            for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+            else
                 {
-                    // doppler search steps
-
-                    doppler = -static_cast<int>(d_doppler_max) + d_doppler_step * doppler_index;
-
-                    volk_32fc_x2_multiply_32fc(d_fft_if->get_inbuf(), d_in_32fc,
-                            d_grid_doppler_wipeoffs[doppler_index], d_fft_size);
-
-                    // 3- Perform the FFT-based convolution  (parallel time search)
-                    // Compute the FFT of the carrier wiped--off incoming signal
-                    d_fft_if->execute();
-
-                    // Multiply carrier wiped--off, Fourier transformed incoming signal
-                    // with the local FFT'd code reference using SIMD operations with VOLK library
-                    volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(),
-                            d_fft_if->get_outbuf(), d_fft_codes, d_fft_size);
-
-                    // compute the inverse FFT
-                    d_ifft->execute();
-
-                    // Search maximum
-                    size_t offset = ( d_bit_transition_flag ? effective_fft_size : 0 );
-                    volk_32fc_magnitude_squared_32f(d_magnitude, d_ifft->get_outbuf() + offset, effective_fft_size);
-                    volk_32f_index_max_16u(&indext, d_magnitude, effective_fft_size);
-                    magt = d_magnitude[indext];
-
-                    if (d_use_CFAR_algorithm_flag == true)
-                        {
-                            // Normalize the maximum value to correct the scale factor introduced by FFTW
-                            magt = d_magnitude[indext] / (fft_normalization_factor * fft_normalization_factor);
-                        }
-
-                    // 4- record the maximum peak and the associated synchronization parameters
-                    if (d_mag < magt)
-                        {
-                            d_mag = magt;
-
-                            if (d_use_CFAR_algorithm_flag == false)
-                                {
-                                    // Search grid noise floor approximation for this doppler line
-                                    volk_32f_accumulator_s32f(&d_input_power, d_magnitude, effective_fft_size);
-                                    d_input_power = (d_input_power - d_mag) / (effective_fft_size - 1);
-                                }
-
-                            // In case that d_bit_transition_flag = true, we compare the potentially
-                            // new maximum test statistics (d_mag/d_input_power) with the value in
-                            // d_test_statistics. When the second dwell is being processed, the value
-                            // of d_mag/d_input_power could be lower than d_test_statistics (i.e,
-                            // the maximum test statistics in the previous dwell is greater than
-                            // current d_mag/d_input_power). Note that d_test_statistics is not
-                            // restarted between consecutive dwells in multidwell operation.
-
-                            if (d_test_statistics < (d_mag / d_input_power) || !d_bit_transition_flag)
-                                {
-                                    d_gnss_synchro->Acq_delay_samples = static_cast<double>(indext % d_samples_per_code);
-                                    d_gnss_synchro->Acq_doppler_hz = static_cast<double>(doppler);
-                                    d_gnss_synchro->Acq_samplestamp_samples = d_sample_counter;
-
-                                    // 5- Compute the test statistics and compare to the threshold
-                                    d_test_statistics = d_mag / d_input_power;
-                                    //std::cout<<"d_input_power="<<d_input_power<<" d_test_statistics="<<d_test_statistics<<" d_gnss_synchro->Acq_doppler_hz ="<<d_gnss_synchro->Acq_doppler_hz <<std::endl;
+                    result = search_samples<Pcps_Peak_To_Floor_Detector>(d_core, input_items[0], d_it_size, *d_grid_doppler_wipeoffs, bin_dump);
+                }
 
-                                }
-                        }
+            // 4- record the maximum peak and the associated synchronization parameters
+            d_mag = result.magnitude;
+            d_input_power = result.noise_power;
+
+            // In case that d_bit_transition_flag = true, we compare the potentially
+            // new maximum test statistics (d_mag/d_input_power) with the value in
+            // d_test_statistics. When the second dwell is being processed, the value
+            // of d_mag/d_input_power could be lower than d_test_statistics (i.e,
+            // the maximum test statistics in the previous dwell is greater than
+            // current d_mag/d_input_power). Note that d_test_statistics is not
+            // restarted between consecutive dwells in multidwell operation.
+            if (d_test_statistics < result.test_statistic || !d_bit_transition_flag)
+                {
+                    d_gnss_synchro->Acq_delay_samples = static_cast<double>(result.delay_samples % d_samples_per_code);
+                    d_gnss_synchro->Acq_doppler_hz = static_cast<double>(d_doppler_center + d_grid_doppler_wipeoffs->doppler(result.doppler_index));
+                    d_gnss_synchro->Acq_samplestamp_samples = d_sample_counter;
 
-                    // Record results to file if required
-                    if (d_dump)
-                        {
-                            std::stringstream filename;
-                            std::streamsize n = 2 * sizeof(float) * (d_fft_size); // complex file write
-                            filename.str("");
-
-                            boost::filesystem::path p = d_dump_filename;
-                            filename << p.parent_path().string()
-                                             << boost::filesystem::path::preferred_separator
-                                             << p.stem().string()
-                                             << "_" << d_gnss_synchro->System
-                                             <<"_" << d_gnss_synchro->Signal << "_sat_"
-                                             << d_gnss_synchro->PRN << "_doppler_"
-                                             <<  doppler
-                                             << p.extension().string();
-
-                            DLOG(INFO) << "Writing ACQ out to " << filename.str();
-
-                            d_dump_file.open(filename.str().c_str(), std::ios::out | std::ios::binary);
-                            d_dump_file.write((char*)d_ifft->get_outbuf(), n); //write directly |abs(x)|^2 in this Doppler bin?
-                            d_dump_file.close();
-                        }
+                    // 5- Compute the test statistics and compare to the threshold
+                    d_test_statistics = result.test_statistic;
                 }
 
             if (!d_bit_transition_flag)
@@ -51,11 +51,13 @@
 #define GNSS_SDR_PCPS_ACQUISITION_SC_H_
 
 #include <fstream>
+#include <memory>
 #include <string>
 #include <gnuradio/block.h>
 #include <gnuradio/gr_complex.h>
-#include <gnuradio/fft/fft.h>
 #include "gnss_synchro.h"
+#include "doppler_grid_store.h"
+#include "pcps_search_core.h"
 
 class pcps_acquisition_sc;
 
@@ -67,13 +69,17 @@ pcps_make_acquisition_sc(unsigned int sampled_ms, unsigned int max_dwells,
                          int samples_per_ms, int samples_per_code,
                          bool bit_transition_flag, bool use_CFAR_algorithm_flag,
                          bool dump,
-                         std::string dump_filename);
+                         std::string dump_filename, size_t it_size);
 
 /*!
  * \brief This class implements a Parallel Code Phase Search Acquisition.
  *
  * Check \ref Navitec2012 "An Open Source Galileo E1 Software Receiver",
  * Algorithm 1, for a pseudocode description of this implementation.
+ *
+ * The samples are lv_16sc_t, or lv_8sc_t if \p it_size is sizeof(lv_8sc_t).
+ * They are widened to floats for the FFTs in the acquisition windows only,
+ * by the Pcps_Search_Core that runs the search.
  */
 class pcps_acquisition_sc: public gr::block
 {
@@ -84,18 +90,16 @@ private:
             int samples_per_ms, int samples_per_code,
             bool bit_transition_flag, bool use_CFAR_algorithm_flag,
             bool dump,
-            std::string dump_filename);
+            std::string dump_filename, size_t it_size);
 
     pcps_acquisition_sc(unsigned int sampled_ms, unsigned int max_dwells,
             unsigned int doppler_max, long freq, long fs_in,
             int samples_per_ms, int samples_per_code,
             bool bit_transition_flag, bool use_CFAR_algorithm_flag,
             bool dump,
-            std::string dump_filename);
+            std::string dump_filename, size_t it_size);
 
-    void update_local_carrier(gr_complex* carrier_vector,
-            int correlator_length_samples,
-            float freq);
+    void update_doppler_window(bool force);
 
     long d_fs_in;
     long d_freq;
@@ -111,17 +115,16 @@ private:
     unsigned int d_well_count;
     unsigned int d_fft_size;
     unsigned long int d_sample_counter;
-    gr_complex** d_grid_doppler_wipeoffs;
+    std::shared_ptr<const Doppler_Grid> d_grid_doppler_wipeoffs;
     unsigned int d_num_doppler_bins;
-    gr_complex* d_fft_codes;
-    gr_complex* d_in_32fc;
-    gr::fft::fft_complex* d_fft_if;
-    gr::fft::fft_complex* d_ifft;
+    int d_doppler_center;              // Centre of the Doppler search, from Acquisition_Assistance [Hz]
+    unsigned int d_doppler_search_max; // Half width of the Doppler search, at most d_doppler_max [Hz]
+    size_t d_it_size;
+    Pcps_Search_Core d_core;
     Gnss_Synchro *d_gnss_synchro;
     unsigned int d_code_phase;
     float d_doppler_freq;
     float d_mag;
-    float* d_magnitude;
     float d_input_power;
     float d_test_statistics;
     bool d_bit_transition_flag;
@@ -41,11 +41,45 @@
 #include <volk/volk.h>
 #include <volk_gnsssdr/volk_gnsssdr.h>
 #include "control_message_factory.h"
-#include "GPS_L1_CA.h" //GPS_TWO_PI
+#include "acquisition_assistance.h"
+#include "gnss_sdr_trace.h"
 
 
 using google::LogMessage;
 
+namespace
+{
+// Writes the correlation with the pilot code of each Doppler bin to its own file
+class Cccwsr_Bin_Dump
+{
+public:
+    Cccwsr_Bin_Dump(const Gnss_Synchro & synchro, const Doppler_Grid & grid,
+            int doppler_center, unsigned int fft_size) :
+        d_synchro(synchro), d_grid(grid), d_doppler_center(doppler_center), d_fft_size(fft_size)
+    {}
+
+    void operator()(unsigned int doppler_index, const gr_complex* correlation)
+    {
+        std::stringstream filename;
+        std::ofstream dump_file;
+        std::streamsize n = 2 * sizeof(float) * (d_fft_size); // complex file write
+        filename << "../data/test_statistics_" << d_synchro.System
+                 <<"_" << d_synchro.Signal << "_sat_"
+                 << d_synchro.PRN << "_doppler_"
+                 << d_doppler_center + d_grid.doppler(doppler_index) << ".dat";
+        dump_file.open(filename.str().c_str(), std::ios::out | std::ios::binary);
+        dump_file.write((char*)correlation, n);
+        dump_file.close();
+    }
+
+private:
+    const Gnss_Synchro & d_synchro;
+    const Doppler_Grid & d_grid;
+    int d_doppler_center;
+    unsigned int d_fft_size;
+};
+}
+
 pcps_cccwsr_acquisition_cc_sptr pcps_cccwsr_make_acquisition_cc(
                                 unsigned int sampled_ms, unsigned int max_dwells,
                                 unsigned int doppler_max, long freq, long fs_in,
@@ -64,7 +98,8 @@ pcps_cccwsr_acquisition_cc::pcps_cccwsr_acquisition_cc(
                     bool dump, std::string dump_filename) :
     gr::block("pcps_cccwsr_acquisition_cc",
     gr::io_signature::make(1, 1, sizeof(gr_complex) * sampled_ms * samples_per_ms),
-    gr::io_signature::make(0, 0, sizeof(gr_complex) * sampled_ms * samples_per_ms))
+    gr::io_signature::make(0, 0, sizeof(gr_complex) * sampled_ms * samples_per_ms)),
+    d_core(sampled_ms * samples_per_ms, sampled_ms * samples_per_ms, false)
 {
     this->message_port_register_out(pmt::mp("events"));
     d_sample_counter = 0;    // SAMPLE COUNTER
@@ -82,20 +117,8 @@ pcps_cccwsr_acquisition_cc::pcps_cccwsr_acquisition_cc(
     d_mag = 0;
     d_input_power = 0.0;
     d_num_doppler_bins = 0;
-
-    d_fft_code_data = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-    d_fft_code_pilot = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-    d_data_correlation = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-    d_pilot_correlation = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-    d_correlation_plus = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-    d_correlation_minus = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-    d_magnitude = static_cast<float*>(volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
-
-    // Direct FFT
-    d_fft_if = new gr::fft::fft_complex(d_fft_size, true);
-
-    // Inverse FFT
-    d_ifft = new gr::fft::fft_complex(d_fft_size, false);
+    d_doppler_center = 0;
+    d_doppler_search_max = doppler_max;
 
     // For dumping samples into a file
     d_dump = dump;
@@ -104,7 +127,6 @@ pcps_cccwsr_acquisition_cc::pcps_cccwsr_acquisition_cc(
     d_doppler_resolution = 0;
     d_threshold = 0;
     d_doppler_step = 0;
-    d_grid_doppler_wipeoffs = 0;
     d_gnss_synchro = 0;
     d_code_phase = 0;
     d_doppler_freq = 0;
@@ -114,26 +136,6 @@ pcps_cccwsr_acquisition_cc::pcps_cccwsr_acquisition_cc(
 
 pcps_cccwsr_acquisition_cc::~pcps_cccwsr_acquisition_cc()
 {
-    if (d_num_doppler_bins > 0)
-        {
-            for (unsigned int i = 0; i < d_num_doppler_bins; i++)
-                {
-                    volk_free(d_grid_doppler_wipeoffs[i]);
-                }
-            delete[] d_grid_doppler_wipeoffs;
-        }
-
-    volk_free(d_fft_code_data);
-    volk_free(d_fft_code_pilot);
-    volk_free(d_data_correlation);
-    volk_free(d_pilot_correlation);
-    volk_free(d_correlation_plus);
-    volk_free(d_correlation_minus);
-    volk_free(d_magnitude);
-
-    delete d_ifft;
-    delete d_fft_if;
-
     if (d_dump)
         {
             d_dump_file.close();
@@ -143,21 +145,9 @@ pcps_cccwsr_acquisition_cc::~pcps_cccwsr_acquisition_cc()
 void pcps_cccwsr_acquisition_cc::set_local_code(std::complex<float>* code_data,
         std::complex<float>* code_pilot)
 {
-    // Data code (E1B)
-    memcpy(d_fft_if->get_inbuf(), code_data, sizeof(gr_complex) * d_fft_size);
-
-    d_fft_if->execute(); // We need the FFT of local code
-
-    //Conjugate the local code
-    volk_32fc_conjugate_32fc(d_fft_code_data,d_fft_if->get_outbuf(),d_fft_size);
-
-    // Pilot code (E1C)
-    memcpy(d_fft_if->get_inbuf(), code_pilot, sizeof(gr_complex) * d_fft_size);
-
-    d_fft_if->execute(); // We need the FFT of local code
-
-    //Conjugate the local code,
-    volk_32fc_conjugate_32fc(d_fft_code_pilot, d_fft_if->get_outbuf(), d_fft_size);
+    // Data code (E1B) and pilot code (E1C)
+    d_core.set_local_code(code_data);
+    d_core.set_pilot_code(code_pilot);
 }
 
 void pcps_cccwsr_acquisition_cc::init()
@@ -174,27 +164,38 @@ void pcps_cccwsr_acquisition_cc::init()
     d_mag = 0.0;
     d_input_power = 0.0;
 
+    update_doppler_window(true);
+}
+
+
+void pcps_cccwsr_acquisition_cc::update_doppler_window(bool force)
+{
+    int doppler_center = 0;
+    unsigned int doppler_search_max = d_doppler_max;
+    if (d_gnss_synchro != 0)
+        {
+            Acquisition_Assistance::doppler_window(*d_gnss_synchro, d_doppler_max, d_doppler_step,
+                    doppler_center, doppler_search_max, static_cast<double>(d_sample_counter) / static_cast<double>(d_fs_in));
+        }
+    if (!force && doppler_center == d_doppler_center && doppler_search_max == d_doppler_search_max)
+        {
+            return;
+        }
+    d_doppler_center = doppler_center;
+    d_doppler_search_max = doppler_search_max;
+
     // Count the number of bins
     d_num_doppler_bins = 0;
-    for (int doppler = static_cast<int>(-d_doppler_max);
-         doppler <= static_cast<int>(d_doppler_max);
+    for (int doppler = static_cast<int>(-d_doppler_search_max);
+         doppler <= static_cast<int>(d_doppler_search_max);
          doppler += d_doppler_step)
     {
         d_num_doppler_bins++;
     }
 
-    // Create the carrier Doppler wipeoff signals
-    d_grid_doppler_wipeoffs = new gr_complex*[d_num_doppler_bins];
-    for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
-        {
-            d_grid_doppler_wipeoffs[doppler_index] = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-
-            int doppler = -static_cast<int>(d_doppler_max) + d_doppler_step * doppler_index;
-            float phase_step_rad = GPS_TWO_PI * (d_freq + doppler) / static_cast<float>(d_fs_in);
-            float _phase[1];
-            _phase[0] = 0;
-            volk_gnsssdr_s32f_sincos_32fc(d_grid_doppler_wipeoffs[doppler_index], - phase_step_rad, _phase, d_fft_size);
-        }
+    // The carrier Doppler wipeoff signals are shared with the other channels
+    d_grid_doppler_wipeoffs = Doppler_Grid_Store::instance().get(d_fs_in, d_freq + d_doppler_center,
+            d_fft_size, d_doppler_search_max, d_doppler_step, d_num_doppler_bins);
 }
 
 
@@ -203,6 +204,7 @@ void pcps_cccwsr_acquisition_cc::set_state(int state)
     d_state = state;
     if (d_state == 1)
         {
+            update_doppler_window(false);
             d_gnss_synchro->Acq_delay_samples = 0.0;
             d_gnss_synchro->Acq_doppler_hz = 0.0;
             d_gnss_synchro->Acq_samplestamp_samples = 0;
@@ -224,6 +226,7 @@ int pcps_cccwsr_acquisition_cc::general_work(int noutput_items,
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items __attribute__((unused)))
 {
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("pcps_cccwsr_acquisition_cc::general_work", d_channel, d_gnss_synchro ? d_gnss_synchro->PRN : 0);
 
     int acquisition_message = -1; //0=STOP_CHANNEL 1=ACQ_SUCCEES 2=ACQ_FAIL
 
@@ -233,6 +236,7 @@ int pcps_cccwsr_acquisition_cc::general_work(int noutput_items,
         {
             if (d_active)
                 {
+                    update_doppler_window(false);
                     //restart acquisition variables
                     d_gnss_synchro->Acq_delay_samples = 0.0;
                     d_gnss_synchro->Acq_doppler_hz = 0.0;
@@ -253,22 +257,7 @@ int pcps_cccwsr_acquisition_cc::general_work(int noutput_items,
     case 1:
         {
             // initialize acquisition algorithm
-            int doppler;
-#if VOLK_GT_122
-            uint16_t indext = 0;
-            uint16_t indext_plus = 0;
-            uint16_t indext_minus = 0;
-#else
-
-            unsigned int indext = 0;
-            unsigned int indext_plus = 0;
-            unsigned int indext_minus = 0;
-#endif
-            float magt = 0.0;
-            float magt_plus = 0.0;
-            float magt_minus = 0.0;
             const gr_complex *in = (const gr_complex *)input_items[0]; //Get the input samples pointer
-            float fft_normalization_factor = static_cast<float>(d_fft_size) * static_cast<float>(d_fft_size);
 
             d_sample_counter += d_fft_size; // sample counter
 
@@ -278,105 +267,32 @@ int pcps_cccwsr_acquisition_cc::general_work(int noutput_items,
                     << " , doing acquisition of satellite: " << d_gnss_synchro->System << " "<< d_gnss_synchro->PRN
                     << " ,sample stamp: " << d_sample_counter << ", threshold: "
                     << d_threshold << ", doppler_max: " << d_doppler_max
-                    << ", doppler_step: " << d_doppler_step;
+                    << ", doppler_step: " << d_doppler_step
+                    << ", doppler search: " << d_doppler_center << " +/- " << d_doppler_search_max;
 
             // 1- Compute the input signal power estimation
-            volk_32fc_magnitude_squared_32f(d_magnitude, in, d_fft_size);
-            volk_32f_accumulator_s32f(&d_input_power, d_magnitude, d_fft_size);
-            d_input_power /= static_cast<float>(d_fft_size);
-
             // 2- Doppler frequency search loop
-            for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+            // 3- Perform the FFT-based convolution (parallel time search) with
+            // the data (E1B) and pilot (E1C) codes, and combine both correlations
+            Pcps_Search_Result result;
+            if (d_dump)
+                {
+                    Cccwsr_Bin_Dump dump(*d_gnss_synchro, *d_grid_doppler_wipeoffs, d_doppler_center, d_fft_size);
+                    result = d_core.search<Pcps_Cfar_Detector>(in, *d_grid_doppler_wipeoffs, dump);
+                }
+            else
+                {
+                    result = d_core.search<Pcps_Cfar_Detector>(in, *d_grid_doppler_wipeoffs);
+                }
+            d_input_power = result.noise_power;
+
+            // 4- record the maximum peak and the associated synchronization parameters
+            if (d_mag < result.magnitude)
                 {
-                    // doppler search steps
-
-                    doppler = -static_cast<int>(d_doppler_max) + d_doppler_step * doppler_index;
-
-                    volk_32fc_x2_multiply_32fc(d_fft_if->get_inbuf(), in,
-                                d_grid_doppler_wipeoffs[doppler_index], d_fft_size);
-
-                    // 3- Perform the FFT-based convolution  (parallel time search)
-                    // Compute the FFT of the carrier wiped--off incoming signal
-                    d_fft_if->execute();
-
-                    // Multiply carrier wiped--off, Fourier transformed incoming signal
-                    // with the local FFT'd data code reference (E1B) using SIMD operations
-                    // with VOLK library
-                    volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(),
-                                d_fft_if->get_outbuf(), d_fft_code_data, d_fft_size);
-
-                    // compute the inverse FFT
-                    d_ifft->execute();
-
-                    // Copy the result of the correlation between wiped--off signal and data code in
-                    // d_data_correlation.
-                    memcpy(d_data_correlation, d_ifft->get_outbuf(), sizeof(gr_complex)*d_fft_size);
-
-                    // Multiply carrier wiped--off, Fourier transformed incoming signal
-                    // with the local FFT'd pilot code reference (E1C) using SIMD operations
-                    // with VOLK library
-                    volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(),
-                                d_fft_if->get_outbuf(), d_fft_code_pilot, d_fft_size);
-
-                    // Compute the inverse FFT
-                    d_ifft->execute();
-
-                    // Copy the result of the correlation between wiped--off signal and pilot code in
-                    // d_data_correlation.
-                    memcpy(d_pilot_correlation, d_ifft->get_outbuf(), sizeof(gr_complex)*d_fft_size);
-
-                    for (unsigned int i = 0; i < d_fft_size; i++)
-                        {
-                            d_correlation_plus[i] = std::complex<float>(
-                                                    d_data_correlation[i].real() - d_pilot_correlation[i].imag(),
-                                                    d_data_correlation[i].imag() + d_pilot_correlation[i].real());
-
-                            d_correlation_minus[i] = std::complex<float>(
-                                                     d_data_correlation[i].real() + d_pilot_correlation[i].imag(),
-                                                     d_data_correlation[i].imag() - d_pilot_correlation[i].real());
-                        }
-
-                    volk_32fc_magnitude_squared_32f(d_magnitude, d_correlation_plus, d_fft_size);
-                    volk_32f_index_max_16u(&indext_plus, d_magnitude, d_fft_size);
-                    magt_plus = d_magnitude[indext_plus] / (fft_normalization_factor * fft_normalization_factor);
-
-                    volk_32fc_magnitude_squared_32f(d_magnitude, d_correlation_minus, d_fft_size);
-                    volk_32f_index_max_16u(&indext_minus, d_magnitude, d_fft_size);
-                    magt_minus = d_magnitude[indext_minus] / (fft_normalization_factor * fft_normalization_factor);
-
-                    if (magt_plus >= magt_minus)
-                    {
-                        magt = magt_plus;
-                        indext = indext_plus;
-                    }
-                    else
-                    {
-                        magt = magt_minus;
-                        indext = indext_minus;
-                    }
-
-                    // 4- record the maximum peak and the associated synchronization parameters
-                    if (d_mag < magt)
-                        {
-                            d_mag = magt;
-                            d_gnss_synchro->Acq_delay_samples = static_cast<double>(indext % d_samples_per_code);
-                            d_gnss_synchro->Acq_doppler_hz = static_cast<double>(doppler);
-                            d_gnss_synchro->Acq_samplestamp_samples = d_sample_counter;
-                        }
-
-                    // Record results to file if required
-                    if (d_dump)
-                        {
-                            std::stringstream filename;
-                            std::streamsize n = 2 * sizeof(float) * (d_fft_size); // complex file write
-                            filename.str("");
-                            filename << "../data/test_statistics_" << d_gnss_synchro->System
-                                     <<"_" << d_gnss_synchro->Signal << "_sat_"
-                                     << d_gnss_synchro->PRN << "_doppler_" <<  doppler << ".dat";
-                            d_dump_file.open(filename.str().c_str(), std::ios::out | std::ios::binary);
-                            d_dump_file.write((char*)d_ifft->get_outbuf(), n); //write directly |abs(x)|^2 in this Doppler bin?
-                            d_dump_file.close();
-                        }
+                    d_mag = result.magnitude;
+                    d_gnss_synchro->Acq_delay_samples = static_cast<double>(result.delay_samples % d_samples_per_code);
+                    d_gnss_synchro->Acq_doppler_hz = static_cast<double>(d_doppler_center + d_grid_doppler_wipeoffs->doppler(result.doppler_index));
+                    d_gnss_synchro->Acq_samplestamp_samples = d_sample_counter;
                 }
 
             // 5- Compute the test statistics and compare to the threshold
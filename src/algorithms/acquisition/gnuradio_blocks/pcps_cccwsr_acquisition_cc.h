@@ -38,11 +38,13 @@
 #define GNSS_SDR_PCPS_CCCWSR_ACQUISITION_CC_H_
 
 #include <fstream>
+#include <memory>
 #include <string>
 #include <gnuradio/block.h>
 #include <gnuradio/gr_complex.h>
-#include <gnuradio/fft/fft.h>
 #include "gnss_synchro.h"
+#include "doppler_grid_store.h"
+#include "pcps_search_core.h"
 
 
 class pcps_cccwsr_acquisition_cc;
@@ -58,6 +60,9 @@ pcps_cccwsr_make_acquisition_cc(unsigned int sampled_ms, unsigned int max_dwells
 /*!
  * \brief This class implements a Parallel Code Phase Search Acquisition with
  * Coherent Channel Combining With Sign Recovery scheme.
+ *
+ * The correlations with the data and pilot codes and their combination are
+ * computed by a Pcps_Search_Core with a pilot code.
  */
 class pcps_cccwsr_acquisition_cc: public gr::block
 {
@@ -76,6 +81,8 @@ private:
     void calculate_magnitudes(gr_complex* fft_begin, int doppler_shift,
             int doppler_offset);
 
+    void update_doppler_window(bool force);
+
     long d_fs_in;
     long d_freq;
     int d_samples_per_ms;
@@ -90,21 +97,14 @@ private:
     unsigned int d_well_count;
     unsigned int d_fft_size;
     unsigned long int d_sample_counter;
-    gr_complex** d_grid_doppler_wipeoffs;
+    std::shared_ptr<const Doppler_Grid> d_grid_doppler_wipeoffs;
     unsigned int d_num_doppler_bins;
-    gr_complex* d_fft_code_data;
-    gr_complex* d_fft_code_pilot;
-    gr::fft::fft_complex* d_fft_if;
-    gr::fft::fft_complex* d_ifft;
+    int d_doppler_center;              // Centre of the Doppler search, from Acquisition_Assistance [Hz]
+    unsigned int d_doppler_search_max; // Half width of the Doppler search, at most d_doppler_max [Hz]
     Gnss_Synchro *d_gnss_synchro;
     unsigned int d_code_phase;
     float d_doppler_freq;
     float d_mag;
-    float* d_magnitude;
-    gr_complex* d_data_correlation;
-    gr_complex* d_pilot_correlation;
-    gr_complex* d_correlation_plus;
-    gr_complex* d_correlation_minus;
     float d_input_power;
     float d_test_statistics;
     std::ofstream d_dump_file;
@@ -113,6 +113,7 @@ private:
     bool d_dump;
     unsigned int d_channel;
     std::string d_dump_filename;
+    Pcps_Search_Core d_core;
 
 public:
     /*!
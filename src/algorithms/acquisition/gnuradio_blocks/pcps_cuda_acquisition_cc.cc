@@ -0,0 +1,316 @@
+/*!
+ * \file pcps_cuda_acquisition_cc.cc
+ * \brief This class implements a Parallel Code Phase Search Acquisition
+ * running the whole Doppler grid search on a CUDA GPU.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "pcps_cuda_acquisition_cc.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
+#include <cmath>
+#include <gnuradio/io_signature.h>
+#include <glog/logging.h>
+#include <volk/volk.h>
+
+
+using google::LogMessage;
+
+pcps_cuda_acquisition_cc_sptr pcps_make_cuda_acquisition_cc(
+                                 unsigned int sampled_ms, unsigned int max_dwells,
+                                 unsigned int doppler_max, long freq, long fs_in,
+                                 int samples_per_ms, int samples_per_code)
+{
+    return pcps_cuda_acquisition_cc_sptr(
+            new pcps_cuda_acquisition_cc(sampled_ms, max_dwells, doppler_max, freq, fs_in,
+                    samples_per_ms, samples_per_code));
+}
+
+
+pcps_cuda_acquisition_cc::pcps_cuda_acquisition_cc(
+                         unsigned int sampled_ms, unsigned int max_dwells,
+                         unsigned int doppler_max, long freq, long fs_in,
+                         int samples_per_ms, int samples_per_code) :
+    gr::block("pcps_cuda_acquisition_cc",
+    gr::io_signature::make(1, 1, sizeof(gr_complex) * sampled_ms * samples_per_ms),
+    gr::io_signature::make(0, 0, sizeof(gr_complex) * sampled_ms * samples_per_ms))
+{
+    this->message_port_register_out(pmt::mp("events"));
+    d_sample_counter = 0;    // SAMPLE COUNTER
+    d_active = false;
+    d_state = 0;
+    d_freq = freq;
+    d_fs_in = fs_in;
+    d_samples_per_ms = samples_per_ms;
+    d_samples_per_code = samples_per_code;
+    d_sampled_ms = sampled_ms;
+    d_max_dwells = max_dwells;
+    d_well_count = 0;
+    d_doppler_max = doppler_max;
+    d_doppler_step = 0;
+    d_fft_size = d_sampled_ms * d_samples_per_ms;
+    d_num_doppler_bins = 0;
+    d_rf_channel = 0;
+    d_slot = -1;
+    d_mag = 0;
+    d_input_power = 0.0;
+    d_test_statistics = 0.0;
+    d_threshold = 0.0;
+    d_channel = 0;
+    d_magnitude = static_cast<float*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
+    d_gnss_synchro = 0;
+}
+
+
+pcps_cuda_acquisition_cc::~pcps_cuda_acquisition_cc()
+{
+    release_slot();
+    gnss_sdr_volk_free(d_magnitude);
+}
+
+
+void pcps_cuda_acquisition_cc::release_slot()
+{
+    if (d_service && d_slot >= 0)
+        {
+            d_service->remove_code(d_slot);
+        }
+    d_slot = -1;
+}
+
+
+void pcps_cuda_acquisition_cc::init()
+{
+    d_gnss_synchro->Flag_valid_acquisition = false;
+    d_gnss_synchro->Flag_valid_symbol_output = false;
+    d_gnss_synchro->Flag_valid_pseudorange = false;
+    d_gnss_synchro->Flag_valid_word = false;
+    d_gnss_synchro->Flag_preamble = false;
+
+    d_gnss_synchro->Acq_delay_samples = 0.0;
+    d_gnss_synchro->Acq_doppler_hz = 0.0;
+    d_gnss_synchro->Acq_samplestamp_samples = 0;
+    d_mag = 0.0;
+    d_input_power = 0.0;
+
+    d_num_doppler_bins = ceil( static_cast<double>(static_cast<int>(d_doppler_max) - static_cast<int>(-d_doppler_max)) / static_cast<double>(d_doppler_step));
+
+    std::shared_ptr<Cuda_Acquisition_Service> service = Cuda_Acquisition_Service_Store::instance().get(d_rf_channel,
+            d_fs_in, d_freq, d_fft_size, d_doppler_max, d_doppler_step, d_num_doppler_bins);
+    if (service != d_service)
+        {
+            // The Doppler grid changed, so the code goes to the new service
+            release_slot();
+            d_service = service;
+        }
+    if (!d_service->ready())
+        {
+            LOG(ERROR) << "Acquisition channel " << d_channel << ": no CUDA device, every search will be negative";
+        }
+}
+
+
+void pcps_cuda_acquisition_cc::set_local_code(std::complex<float> * code)
+{
+    if (!d_service) return;
+    if (d_slot < 0)
+        {
+            d_slot = d_service->add_code(code);
+        }
+    else if (!d_service->set_local_code(d_slot, code))
+        {
+            release_slot();
+        }
+}
+
+
+void pcps_cuda_acquisition_cc::set_state(int state)
+{
+    d_state = state;
+    if (d_state == 1)
+        {
+            d_gnss_synchro->Acq_delay_samples = 0.0;
+            d_gnss_synchro->Acq_doppler_hz = 0.0;
+            d_gnss_synchro->Acq_samplestamp_samples = 0;
+            d_well_count = 0;
+            d_mag = 0.0;
+            d_input_power = 0.0;
+            d_test_statistics = 0.0;
+            if (d_service) d_service->arm(d_slot, true);
+        }
+    else if (d_state == 0)
+        {}
+    else
+        {
+            LOG(ERROR) << "State can only be set to 0 or 1";
+        }
+}
+
+
+int pcps_cuda_acquisition_cc::general_work(int noutput_items,
+        gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items __attribute__((unused)))
+{
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("pcps_cuda_acquisition_cc::general_work", d_channel, d_gnss_synchro ? d_gnss_synchro->PRN : 0);
+    int acquisition_message = -1; //0=STOP_CHANNEL 1=ACQ_SUCCEES 2=ACQ_FAIL
+
+    switch (d_state)
+    {
+    case 0:
+        {
+            if (d_active)
+                {
+                    //restart acquisition variables
+                    d_gnss_synchro->Acq_delay_samples = 0.0;
+                    d_gnss_synchro->Acq_doppler_hz = 0.0;
+                    d_gnss_synchro->Acq_samplestamp_samples = 0;
+                    d_well_count = 0;
+                    d_mag = 0.0;
+                    d_input_power = 0.0;
+                    d_test_statistics = 0.0;
+                    // From now on the batches of the other channels include this one
+                    if (d_service) d_service->arm(d_slot, true);
+
+                    d_state = 1;
+                }
+
+            d_sample_counter += d_fft_size * ninput_items[0]; // sample counter
+            consume_each(ninput_items[0]);
+
+            break;
+        }
+
+    case 1:
+        {
+            const gr_complex *in = (const gr_complex *)input_items[0]; //Get the input samples pointer
+            float fft_normalization_factor = static_cast<float>(d_fft_size) * static_cast<float>(d_fft_size);
+
+            d_input_power = 0.0;
+            d_mag = 0.0;
+            d_sample_counter += d_fft_size; // sample counter
+            d_well_count++;
+
+            DLOG(INFO) << "Channel: " << d_channel
+                    << " , doing acquisition of satellite: " << d_gnss_synchro->System << " " << d_gnss_synchro->PRN
+                    << " ,sample stamp: " << d_sample_counter << ", threshold: "
+                    << d_threshold << ", doppler_max: " << d_doppler_max
+                    << ", doppler_step: " << d_doppler_step;
+
+            // 1- Compute the input signal power estimation
+            volk_32fc_magnitude_squared_32f(d_magnitude, in, d_fft_size);
+            volk_32f_accumulator_s32f(&d_input_power, d_magnitude, d_fft_size);
+            d_input_power /= static_cast<float>(d_fft_size);
+
+            // 2- Search the whole grid, or take the result of the batch that already did
+            if (d_slot >= 0 && d_service->search(d_slot, nitems_read(0), in, d_peaks))
+                {
+                    // 3- Record the maximum peak and the associated synchronization parameters
+                    for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+                        {
+                            // Normalize the maximum value to correct the scale factor introduced by cuFFT
+                            float magt = d_peaks[doppler_index].magnitude / (fft_normalization_factor * fft_normalization_factor);
+                            if (d_mag < magt)
+                                {
+                                    d_mag = magt;
+                                    int doppler = -static_cast<int>(d_doppler_max) + d_doppler_step * doppler_index;
+                                    d_gnss_synchro->Acq_delay_samples = static_cast<double>(d_peaks[doppler_index].index % d_samples_per_code);
+                                    d_gnss_synchro->Acq_doppler_hz = static_cast<double>(doppler);
+                                    d_gnss_synchro->Acq_samplestamp_samples = d_sample_counter;
+                                }
+                        }
+                    // 4- Compute the test statistics and compare to the threshold
+                    d_test_statistics = d_mag / d_input_power;
+                }
+
+            if (d_test_statistics > d_threshold)
+                {
+                    d_state = 2; // Positive acquisition
+                }
+            else if (d_well_count == d_max_dwells)
+                {
+                    d_state = 3; // Negative acquisition
+                }
+            if (d_state != 1 && d_service)
+                {
+                    d_service->arm(d_slot, false);
+                }
+
+            consume_each(1);
+            break;
+        }
+
+    case 2:
+        {
+            // 5.1- Declare positive acquisition using a message port
+            DLOG(INFO) << "positive acquisition";
+            DLOG(INFO) << "satellite " << d_gnss_synchro->System << " " << d_gnss_synchro->PRN;
+            DLOG(INFO) << "sample_stamp " << d_sample_counter;
+            DLOG(INFO) << "test statistics value " << d_test_statistics;
+            DLOG(INFO) << "test statistics threshold " << d_threshold;
+            DLOG(INFO) << "code phase " << d_gnss_synchro->Acq_delay_samples;
+            DLOG(INFO) << "doppler " << d_gnss_synchro->Acq_doppler_hz;
+            DLOG(INFO) << "magnitude " << d_mag;
+            DLOG(INFO) << "input signal power " << d_input_power;
+
+            d_active = false;
+            d_state = 0;
+            d_sample_counter += d_fft_size * ninput_items[0]; // sample counter
+            consume_each(ninput_items[0]);
+
+            acquisition_message = 1;
+            this->message_port_pub(pmt::mp("events"), pmt::from_long(acquisition_message));
+
+            break;
+        }
+
+    case 3:
+        {
+            // 5.2- Declare negative acquisition using a message port
+            DLOG(INFO) << "negative acquisition";
+            DLOG(INFO) << "satellite " << d_gnss_synchro->System << " " << d_gnss_synchro->PRN;
+            DLOG(INFO) << "sample_stamp " << d_sample_counter;
+            DLOG(INFO) << "test statistics value " << d_test_statistics;
+            DLOG(INFO) << "test statistics threshold " << d_threshold;
+            DLOG(INFO) << "code phase " << d_gnss_synchro->Acq_delay_samples;
+            DLOG(INFO) << "doppler " << d_gnss_synchro->Acq_doppler_hz;
+            DLOG(INFO) << "magnitude " << d_mag;
+            DLOG(INFO) << "input signal power " << d_input_power;
+
+            d_active = false;
+            d_state = 0;
+            d_sample_counter += d_fft_size * ninput_items[0]; // sample counter
+            consume_each(ninput_items[0]);
+
+            acquisition_message = 2;
+            this->message_port_pub(pmt::mp("events"), pmt::from_long(acquisition_message));
+
+            break;
+        }
+    }
+
+    return noutput_items;
+}
@@ -0,0 +1,226 @@
+/*!
+ * \file pcps_cuda_acquisition_cc.h
+ * \brief This class implements a Parallel Code Phase Search Acquisition
+ * running the whole Doppler grid search on a CUDA GPU.
+ *
+ *  Acquisition strategy (Kay Borre book + CFAR threshold).
+ *  <ol>
+ *  <li> Compute the input signal power estimation
+ *  <li> Search all the Doppler bins at once on the GPU, batched with the
+ *       other channels that search the same input window
+ *  <li> Record the maximum peak and the associated synchronization parameters
+ *  <li> Compute the test statistics and compare to the threshold
+ *  <li> Declare positive or negative acquisition using a message port
+ *  </ol>
+ *
+ * Kay Borre book: K.Borre, D.M.Akos, N.Bertelsen, P.Rinder, and S.H.Jensen,
+ * "A Software-Defined GPS and Galileo Receiver. A Single-Frequency
+ * Approach", Birkha user, 2007. pp 81-84
+ *
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PCPS_CUDA_ACQUISITION_CC_H_
+#define GNSS_SDR_PCPS_CUDA_ACQUISITION_CC_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <gnuradio/block.h>
+#include <gnuradio/gr_complex.h>
+#include "gnss_synchro.h"
+#include "cuda_acquisition_service.h"
+
+class pcps_cuda_acquisition_cc;
+
+typedef boost::shared_ptr<pcps_cuda_acquisition_cc> pcps_cuda_acquisition_cc_sptr;
+
+pcps_cuda_acquisition_cc_sptr
+pcps_make_cuda_acquisition_cc(unsigned int sampled_ms, unsigned int max_dwells,
+                              unsigned int doppler_max, long freq, long fs_in,
+                              int samples_per_ms, int samples_per_code);
+
+/*!
+ * \brief This class implements a Parallel Code Phase Search Acquisition on a
+ * CUDA GPU.
+ *
+ * The search itself is done by the Cuda_Acquisition_Service shared by all the
+ * channels fed by the same signal conditioner, so that a window is uploaded
+ * and transformed once for all the satellites being searched. Only circular
+ * correlation is available, and the test statistics always use the input
+ * power estimation, since only the peak of each Doppler bin comes back from
+ * the GPU.
+ */
+class pcps_cuda_acquisition_cc: public gr::block
+{
+private:
+    friend pcps_cuda_acquisition_cc_sptr
+    pcps_make_cuda_acquisition_cc(unsigned int sampled_ms, unsigned int max_dwells,
+            unsigned int doppler_max, long freq, long fs_in,
+            int samples_per_ms, int samples_per_code);
+
+    pcps_cuda_acquisition_cc(unsigned int sampled_ms, unsigned int max_dwells,
+            unsigned int doppler_max, long freq, long fs_in,
+            int samples_per_ms, int samples_per_code);
+
+    void release_slot();
+
+    long d_fs_in;
+    long d_freq;
+    int d_samples_per_ms;
+    int d_samples_per_code;
+    float d_threshold;
+    unsigned int d_doppler_max;
+    unsigned int d_doppler_step;
+    unsigned int d_sampled_ms;
+    unsigned int d_max_dwells;
+    unsigned int d_well_count;
+    unsigned int d_fft_size;
+    unsigned long int d_sample_counter;
+    unsigned int d_num_doppler_bins;
+    unsigned int d_rf_channel;
+    std::shared_ptr<Cuda_Acquisition_Service> d_service;
+    int d_slot;
+    std::vector<cuda_acquisition_peak> d_peaks;
+    float* d_magnitude;
+    Gnss_Synchro *d_gnss_synchro;
+    float d_mag;
+    float d_input_power;
+    float d_test_statistics;
+    bool d_active;
+    int d_state;
+    unsigned int d_channel;
+
+public:
+    /*!
+     * \brief Default destructor.
+     */
+     ~pcps_cuda_acquisition_cc();
+
+     /*!
+      * \brief Set acquisition/tracking common Gnss_Synchro object pointer
+      * to exchange synchronization data between acquisition and tracking blocks.
+      * \param p_gnss_synchro Satellite information shared by the processing blocks.
+      */
+     void set_gnss_synchro(Gnss_Synchro* p_gnss_synchro)
+     {
+         d_gnss_synchro = p_gnss_synchro;
+     }
+
+     /*!
+      * \brief Returns the maximum peak of grid search.
+      */
+     unsigned int mag()
+     {
+         return d_mag;
+     }
+
+     /*!
+      * \brief Initializes acquisition algorithm, taking the acquisition
+      * service of the current input and Doppler grid.
+      */
+     void init();
+
+     /*!
+      * \brief Sets local code for PCPS acquisition algorithm.
+      * \param code - Pointer to the PRN code.
+      */
+     void set_local_code(std::complex<float> * code);
+
+     /*!
+      * \brief Starts acquisition algorithm, turning from standby mode to
+      * active mode
+      * \param active - bool that activates/deactivates the block.
+      */
+     void set_active(bool active)
+     {
+         d_active = active;
+     }
+
+     /*!
+      * \brief If set to 1, ensures that acquisition starts at the
+      * first available sample.
+      * \param state - int=1 forces start of acquisition
+      */
+     void set_state(int state);
+
+     /*!
+      * \brief Set acquisition channel unique ID
+      * \param channel - receiver channel.
+      */
+     void set_channel(unsigned int channel)
+     {
+         d_channel = channel;
+     }
+
+     /*!
+      * \brief Set the signal conditioner feeding this channel. Only the
+      * channels with the same one share their searches.
+      * \param rf_channel - RF channel ID of the channel.
+      */
+     void set_rf_channel(unsigned int rf_channel)
+     {
+         d_rf_channel = rf_channel;
+     }
+
+     /*!
+      * \brief Set statistics threshold of PCPS algorithm.
+      * \param threshold - Threshold for signal detection (check \ref Navitec2012,
+      * Algorithm 1, for a definition of this threshold).
+      */
+     void set_threshold(float threshold)
+     {
+         d_threshold = threshold;
+     }
+
+     /*!
+      * \brief Set maximum Doppler grid search
+      * \param doppler_max - Maximum Doppler shift considered in the grid search [Hz].
+      */
+     void set_doppler_max(unsigned int doppler_max)
+     {
+         d_doppler_max = doppler_max;
+     }
+
+     /*!
+      * \brief Set Doppler steps for the grid search
+      * \param doppler_step - Frequency bin of the search grid [Hz].
+      */
+     void set_doppler_step(unsigned int doppler_step)
+     {
+         d_doppler_step = doppler_step;
+     }
+
+     /*!
+      * \brief Parallel Code Phase Search Acquisition signal processing.
+      */
+     int general_work(int noutput_items, gr_vector_int &ninput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+};
+
+#endif /* GNSS_SDR_PCPS_CUDA_ACQUISITION_CC_H_*/
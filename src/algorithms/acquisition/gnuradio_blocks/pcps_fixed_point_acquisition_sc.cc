@@ -0,0 +1,452 @@
+/*!
+ * \file pcps_fixed_point_acquisition_sc.cc
+ * \brief This class implements a Parallel Code Phase Search Acquisition
+ *  computed entirely in 16-bit integer arithmetic
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "pcps_fixed_point_acquisition_sc.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <boost/filesystem.hpp>
+#include <gnuradio/io_signature.h>
+#include <glog/logging.h>
+#include "doppler_grid_store.h"
+#include "acquisition_assistance.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
+
+// Largest input component: keeps the Q15 wipe-off free of overflow
+#define FIXED_POINT_ACQ_INPUT_LIMIT 16383
+
+// Largest magnitude of the Q15 code spectrum (0.5), so that the product
+// with a block floating point spectrum never saturates
+#define FIXED_POINT_ACQ_CODE_LIMIT 16384.0
+
+
+using google::LogMessage;
+
+pcps_fixed_point_acquisition_sc_sptr pcps_make_fixed_point_acquisition_sc(
+                                 unsigned int sampled_ms, unsigned int max_dwells,
+                                 unsigned int doppler_max, long freq, long fs_in,
+                                 int samples_per_ms, int samples_per_code,
+                                 bool dump,
+                                 std::string dump_filename)
+{
+    return pcps_fixed_point_acquisition_sc_sptr(
+            new pcps_fixed_point_acquisition_sc(sampled_ms, max_dwells, doppler_max, freq, fs_in, samples_per_ms,
+                    samples_per_code, dump, dump_filename));
+}
+
+
+pcps_fixed_point_acquisition_sc::pcps_fixed_point_acquisition_sc(
+                         unsigned int sampled_ms, unsigned int max_dwells,
+                         unsigned int doppler_max, long freq, long fs_in,
+                         int samples_per_ms, int samples_per_code,
+                         bool dump,
+                         std::string dump_filename) :
+    gr::block("pcps_fixed_point_acquisition_sc",
+    gr::io_signature::make(1, 1, sizeof(lv_16sc_t) * sampled_ms * samples_per_ms),
+    gr::io_signature::make(0, 0, sizeof(lv_16sc_t) * sampled_ms * samples_per_ms))
+{
+    this->message_port_register_out(pmt::mp("events"));
+
+    d_sample_counter = 0;    // SAMPLE COUNTER
+    d_active = false;
+    d_state = 0;
+    d_freq = freq;
+    d_fs_in = fs_in;
+    d_samples_per_ms = samples_per_ms;
+    d_samples_per_code = samples_per_code;
+    d_sampled_ms = sampled_ms;
+    d_max_dwells = max_dwells;
+    d_well_count = 0;
+    d_doppler_max = doppler_max;
+    d_vector_length = d_sampled_ms * d_samples_per_ms;
+    d_mag = 0;
+    d_input_power = 0.0;
+    d_num_doppler_bins = 0;
+    d_doppler_center = 0;
+    d_doppler_search_max = doppler_max;
+    d_threshold = 0.0;
+    d_doppler_step = 0;
+    d_test_statistics = 0.0;
+    d_channel = 0;
+
+    // The radix-2 FFT needs a power of two length. Otherwise the input is
+    // repeated and the code zero-padded up to a power of two of at least
+    // 2 * d_vector_length - 1, and the first d_vector_length outputs are
+    // still the circular correlation of one input vector.
+    d_fft_size = d_vector_length;
+    if (!Fixed_Point_Fft::is_power_of_two(d_fft_size))
+        {
+            d_fft_size = Fixed_Point_Fft::next_power_of_two(2 * d_vector_length - 1);
+            DLOG(INFO) << "FFT zero-padded from " << d_vector_length << " to " << d_fft_size << " samples";
+        }
+
+    d_fft_codes = static_cast<lv_16sc_t*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(lv_16sc_t), volk_get_alignment()));
+    d_input = static_cast<lv_16sc_t*>(gnss_sdr_volk_malloc(d_vector_length * sizeof(lv_16sc_t), volk_get_alignment()));
+    d_work = static_cast<lv_16sc_t*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(lv_16sc_t), volk_get_alignment()));
+    d_magnitude = static_cast<uint32_t*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(uint32_t), volk_get_alignment()));
+    std::fill_n(d_fft_codes, d_fft_size, lv_16sc_t(0, 0));
+
+    d_fft = new Fixed_Point_Fft(d_fft_size, true);
+    d_ifft = new Fixed_Point_Fft(d_fft_size, false);
+
+    // For dumping samples into a file
+    d_dump = dump;
+    d_dump_filename = dump_filename;
+
+    d_gnss_synchro = 0;
+}
+
+
+pcps_fixed_point_acquisition_sc::~pcps_fixed_point_acquisition_sc()
+{
+    free_wipeoffs();
+
+    gnss_sdr_volk_free(d_fft_codes);
+    gnss_sdr_volk_free(d_input);
+    gnss_sdr_volk_free(d_work);
+    gnss_sdr_volk_free(d_magnitude);
+
+    delete d_ifft;
+    delete d_fft;
+
+    if (d_dump)
+        {
+            d_dump_file.close();
+        }
+}
+
+
+void pcps_fixed_point_acquisition_sc::free_wipeoffs()
+{
+    for (unsigned int i = 0; i < d_grid_doppler_wipeoffs.size(); i++)
+        {
+            gnss_sdr_volk_free(d_grid_doppler_wipeoffs[i]);
+        }
+    d_grid_doppler_wipeoffs.clear();
+}
+
+
+void pcps_fixed_point_acquisition_sc::set_local_code_fft(std::shared_ptr<const gr_complex> fft_code)
+{
+    // Normalize the spectrum so that its largest magnitude is FIXED_POINT_ACQ_CODE_LIMIT in Q15
+    const gr_complex* code = fft_code.get();
+    float max_magnitude = 0.0;
+    for (unsigned int i = 0; i < d_fft_size; i++)
+        {
+            max_magnitude = std::max(max_magnitude, std::abs(code[i]));
+        }
+    float scale = (max_magnitude > 0.0 ? FIXED_POINT_ACQ_CODE_LIMIT / max_magnitude : 0.0);
+    for (unsigned int i = 0; i < d_fft_size; i++)
+        {
+            d_fft_codes[i] = lv_16sc_t(static_cast<int16_t>(std::lround(code[i].real() * scale)),
+                    static_cast<int16_t>(std::lround(code[i].imag() * scale)));
+        }
+}
+
+
+void pcps_fixed_point_acquisition_sc::init()
+{
+    d_gnss_synchro->Flag_valid_acquisition = false;
+    d_gnss_synchro->Flag_valid_symbol_output = false;
+    d_gnss_synchro->Flag_valid_pseudorange = false;
+    d_gnss_synchro->Flag_valid_word = false;
+    d_gnss_synchro->Flag_preamble = false;
+
+    d_gnss_synchro->Acq_delay_samples = 0.0;
+    d_gnss_synchro->Acq_doppler_hz = 0.0;
+    d_gnss_synchro->Acq_samplestamp_samples = 0;
+    d_mag = 0.0;
+    d_input_power = 0.0;
+
+    update_doppler_window(true);
+}
+
+
+void pcps_fixed_point_acquisition_sc::update_doppler_window(bool force)
+{
+    int doppler_center = 0;
+    unsigned int doppler_search_max = d_doppler_max;
+    if (d_gnss_synchro != 0)
+        {
+            Acquisition_Assistance::doppler_window(*d_gnss_synchro, d_doppler_max, d_doppler_step,
+                    doppler_center, doppler_search_max, static_cast<double>(d_sample_counter) / static_cast<double>(d_fs_in));
+        }
+    if (!force && doppler_center == d_doppler_center && doppler_search_max == d_doppler_search_max)
+        {
+            return;
+        }
+    d_doppler_center = doppler_center;
+    d_doppler_search_max = doppler_search_max;
+
+    d_num_doppler_bins = ceil( static_cast<double>(static_cast<int>(d_doppler_search_max) - static_cast<int>(-d_doppler_search_max)) / static_cast<double>(d_doppler_step));
+
+    // Quantize the shared floating point carriers to Q15
+    std::shared_ptr<const Doppler_Grid> grid = Doppler_Grid_Store::instance().get(d_fs_in, d_freq + d_doppler_center,
+            d_vector_length, d_doppler_search_max, d_doppler_step, d_num_doppler_bins);
+    free_wipeoffs();
+    for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+        {
+            lv_16sc_t* carrier = static_cast<lv_16sc_t*>(gnss_sdr_volk_malloc(d_vector_length * sizeof(lv_16sc_t), volk_get_alignment()));
+            const gr_complex* wipeoff = grid->wipeoff(doppler_index);
+            for (unsigned int i = 0; i < d_vector_length; i++)
+                {
+                    carrier[i] = lv_16sc_t(static_cast<int16_t>(std::lround(32767.0 * wipeoff[i].real())),
+                            static_cast<int16_t>(std::lround(32767.0 * wipeoff[i].imag())));
+                }
+            d_grid_doppler_wipeoffs.push_back(carrier);
+        }
+}
+
+
+void pcps_fixed_point_acquisition_sc::set_state(int state)
+{
+    d_state = state;
+    if (d_state == 1)
+        {
+            update_doppler_window(false);
+            d_gnss_synchro->Acq_delay_samples = 0.0;
+            d_gnss_synchro->Acq_doppler_hz = 0.0;
+            d_gnss_synchro->Acq_samplestamp_samples = 0;
+            d_well_count = 0;
+            d_mag = 0.0;
+            d_input_power = 0.0;
+            d_test_statistics = 0.0;
+        }
+    else if (d_state == 0)
+        {}
+    else
+        {
+            LOG(ERROR) << "State can only be set to 0 or 1";
+        }
+}
+
+
+int pcps_fixed_point_acquisition_sc::general_work(int noutput_items,
+        gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items __attribute__((unused)))
+{
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("pcps_fixed_point_acquisition_sc::general_work", d_channel, d_gnss_synchro ? d_gnss_synchro->PRN : 0);
+    int acquisition_message = -1; //0=STOP_CHANNEL 1=ACQ_SUCCEES 2=ACQ_FAIL
+
+    switch (d_state)
+    {
+    case 0:
+        {
+            if (d_active)
+                {
+                    update_doppler_window(false);
+                    //restart acquisition variables
+                    d_gnss_synchro->Acq_delay_samples = 0.0;
+                    d_gnss_synchro->Acq_doppler_hz = 0.0;
+                    d_gnss_synchro->Acq_samplestamp_samples = 0;
+                    d_well_count = 0;
+                    d_mag = 0.0;
+                    d_input_power = 0.0;
+                    d_test_statistics = 0.0;
+
+                    d_state = 1;
+                }
+
+            d_sample_counter += d_vector_length * ninput_items[0]; // sample counter
+            consume_each(ninput_items[0]);
+
+            break;
+        }
+
+    case 1:
+        {
+            const lv_16sc_t *in = (const lv_16sc_t *)input_items[0]; //Get the input samples pointer
+
+            d_input_power = 0.0;
+            d_mag = 0.0;
+
+            d_sample_counter += d_vector_length; // sample counter
+
+            d_well_count++;
+
+            DLOG(INFO) << "Channel: " << d_channel
+                    << " , doing acquisition of satellite: " << d_gnss_synchro->System << " " << d_gnss_synchro->PRN
+                    << " ,sample stamp: " << d_sample_counter << ", threshold: "
+                    << d_threshold << ", doppler_max: " << d_doppler_max
+                    << ", doppler_step: " << d_doppler_step
+                    << ", doppler search: " << d_doppler_center << " +/- " << d_doppler_search_max;
+
+            // 1- Scale the input down to FIXED_POINT_ACQ_INPUT_LIMIT (byte inputs arrive multiplied by 256)
+            int shift = 0;
+            int max_component = Fixed_Point_Fft::max_abs_component(in, d_vector_length);
+            while ((max_component >> shift) > FIXED_POINT_ACQ_INPUT_LIMIT)
+                {
+                    shift++;
+                }
+            for (unsigned int i = 0; i < d_vector_length; i++)
+                {
+                    d_input[i] = lv_16sc_t(in[i].real() >> shift, in[i].imag() >> shift);
+                }
+
+            // 2- Doppler frequency search loop
+            for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+                {
+                    // doppler search steps
+                    int doppler = d_doppler_center - static_cast<int>(d_doppler_search_max) + d_doppler_step * doppler_index;
+
+                    Fixed_Point_Fft::multiply_q15(d_work, d_input, d_grid_doppler_wipeoffs[doppler_index], d_vector_length);
+                    for (unsigned int i = d_vector_length; i < d_fft_size; i++)
+                        {
+                            d_work[i] = d_work[i % d_vector_length];
+                        }
+
+                    // 3- Perform the FFT-based convolution  (parallel time search)
+                    int exponent = d_fft->execute(d_work);
+                    Fixed_Point_Fft::multiply_q15(d_work, d_work, d_fft_codes, d_fft_size);
+                    exponent += d_ifft->execute(d_work);
+
+                    // 4- Search maximum
+                    Fixed_Point_Fft::magnitude_squared(d_magnitude, d_work, d_vector_length);
+                    unsigned int indext = Fixed_Point_Fft::index_max(d_magnitude, d_vector_length);
+
+                    // Bring the peak to a common scale for the comparison between bins
+                    float magt = std::ldexp(static_cast<float>(d_magnitude[indext]), 2 * exponent);
+
+                    // 5- record the maximum peak and the associated synchronization parameters
+                    if (d_mag < magt)
+                        {
+                            d_mag = magt;
+
+                            // Search grid noise floor approximation for this doppler line
+                            unsigned long long int accumulated = 0;
+                            for (unsigned int i = 0; i < d_vector_length; i++)
+                                {
+                                    accumulated += d_magnitude[i];
+                                }
+                            float noise_floor = static_cast<float>(accumulated - d_magnitude[indext]) / static_cast<float>(d_vector_length - 1);
+                            d_input_power = std::ldexp(noise_floor, 2 * exponent);
+
+                            d_gnss_synchro->Acq_delay_samples = static_cast<double>(indext % d_samples_per_code);
+                            d_gnss_synchro->Acq_doppler_hz = static_cast<double>(doppler);
+                            d_gnss_synchro->Acq_samplestamp_samples = d_sample_counter;
+
+                            // 6- Compute the test statistics and compare to the threshold
+                            d_test_statistics = (d_input_power > 0.0 ? d_mag / d_input_power : 0.0);
+                        }
+
+                    // Record results to file if required
+                    if (d_dump)
+                        {
+                            std::stringstream filename;
+                            std::streamsize n = sizeof(lv_16sc_t) * (d_vector_length); // 16-bit complex file write
+                            filename.str("");
+
+                            boost::filesystem::path p = d_dump_filename;
+                            filename << p.parent_path().string()
+                                     << boost::filesystem::path::preferred_separator
+                                     << p.stem().string()
+                                     << "_" << d_gnss_synchro->System
+                                     <<"_" << d_gnss_synchro->Signal << "_sat_"
+                                     << d_gnss_synchro->PRN << "_doppler_"
+                                     <<  doppler
+                                     << p.extension().string();
+
+                            DLOG(INFO) << "Writing ACQ out to " << filename.str();
+
+                            d_dump_file.open(filename.str().c_str(), std::ios::out | std::ios::binary);
+                            d_dump_file.write((char*)d_work, n);
+                            d_dump_file.close();
+                        }
+                }
+
+            if (d_test_statistics > d_threshold)
+                {
+                    d_state = 2; // Positive acquisition
+                }
+            else if (d_well_count == d_max_dwells)
+                {
+                    d_state = 3; // Negative acquisition
+                }
+
+            consume_each(1);
+
+            DLOG(INFO) << "Done. Consumed 1 item.";
+
+            break;
+        }
+
+    case 2:
+        {
+            // 7.1- Declare positive acquisition using a message port
+            DLOG(INFO) << "positive acquisition";
+            DLOG(INFO) << "satellite " << d_gnss_synchro->System << " " << d_gnss_synchro->PRN;
+            DLOG(INFO) << "sample_stamp " << d_sample_counter;
+            DLOG(INFO) << "test statistics value " << d_test_statistics;
+            DLOG(INFO) << "test statistics threshold " << d_threshold;
+            DLOG(INFO) << "code phase " << d_gnss_synchro->Acq_delay_samples;
+            DLOG(INFO) << "doppler " << d_gnss_synchro->Acq_doppler_hz;
+            DLOG(INFO) << "magnitude " << d_mag;
+            DLOG(INFO) << "input signal power " << d_input_power;
+
+            d_active = false;
+            d_state = 0;
+            d_sample_counter += d_vector_length * ninput_items[0]; // sample counter
+            consume_each(ninput_items[0]);
+
+            acquisition_message = 1;
+            this->message_port_pub(pmt::mp("events"), pmt::from_long(acquisition_message));
+
+            break;
+        }
+
+    case 3:
+        {
+            // 7.2- Declare negative acquisition using a message port
+            DLOG(INFO) << "negative acquisition";
+            DLOG(INFO) << "satellite " << d_gnss_synchro->System << " " << d_gnss_synchro->PRN;
+            DLOG(INFO) << "sample_stamp " << d_sample_counter;
+            DLOG(INFO) << "test statistics value " << d_test_statistics;
+            DLOG(INFO) << "test statistics threshold " << d_threshold;
+            DLOG(INFO) << "code phase " << d_gnss_synchro->Acq_delay_samples;
+            DLOG(INFO) << "doppler " << d_gnss_synchro->Acq_doppler_hz;
+            DLOG(INFO) << "magnitude " << d_mag;
+            DLOG(INFO) << "input signal power " << d_input_power;
+
+            d_active = false;
+            d_state = 0;
+
+            d_sample_counter += d_vector_length * ninput_items[0]; // sample counter
+            consume_each(ninput_items[0]);
+            acquisition_message = 2;
+            this->message_port_pub(pmt::mp("events"), pmt::from_long(acquisition_message));
+
+            break;
+        }
+    }
+
+    return noutput_items;
+}
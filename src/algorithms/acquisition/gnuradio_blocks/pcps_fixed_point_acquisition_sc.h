@@ -0,0 +1,241 @@
+/*!
+ * \file pcps_fixed_point_acquisition_sc.h
+ * \brief This class implements a Parallel Code Phase Search Acquisition
+ *  computed entirely in 16-bit integer arithmetic
+ *
+ *  Acquisition strategy:
+ *  <ol>
+ *  <li> Scale the input so that it fits the fixed-point pipeline
+ *  <li> Doppler serial search loop with Q15 carrier wipe-off
+ *  <li> Block floating point FFT-based circular convolution (parallel time search)
+ *  <li> Integer magnitude and maximum search
+ *  <li> Compute the test statistics (peak over noise floor) and compare to the threshold
+ *  <li> Declare positive or negative acquisition using a message port
+ *  </ol>
+ *
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PCPS_FIXED_POINT_ACQUISITION_SC_H_
+#define GNSS_SDR_PCPS_FIXED_POINT_ACQUISITION_SC_H_
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <gnuradio/block.h>
+#include <gnuradio/gr_complex.h>
+#include <volk/volk.h>
+#include "gnss_synchro.h"
+#include "fixed_point_fft.h"
+
+class pcps_fixed_point_acquisition_sc;
+
+typedef boost::shared_ptr<pcps_fixed_point_acquisition_sc> pcps_fixed_point_acquisition_sc_sptr;
+
+pcps_fixed_point_acquisition_sc_sptr
+pcps_make_fixed_point_acquisition_sc(unsigned int sampled_ms, unsigned int max_dwells,
+                         unsigned int doppler_max, long freq, long fs_in,
+                         int samples_per_ms, int samples_per_code,
+                         bool dump,
+                         std::string dump_filename);
+
+/*!
+ * \brief This class implements a Parallel Code Phase Search Acquisition
+ * on lv_16sc_t samples that never converts them to floating point.
+ *
+ * The carriers and the code spectrum are stored in Q15, the FFTs use block
+ * floating point (see Fixed_Point_Fft) and the magnitudes are exact 32-bit
+ * integers. Since the block exponent changes from one Doppler bin to the
+ * next, the test statistic is the peak of the best bin over the noise floor
+ * of that same bin, as pcps_acquisition_cc does with use_CFAR_algorithm=false.
+ * If the input vector (sampled_ms * samples_per_ms) is not a power of two
+ * long, the FFTs are zero-padded to one of at least twice its length.
+ */
+class pcps_fixed_point_acquisition_sc: public gr::block
+{
+private:
+    friend pcps_fixed_point_acquisition_sc_sptr
+    pcps_make_fixed_point_acquisition_sc(unsigned int sampled_ms, unsigned int max_dwells,
+            unsigned int doppler_max, long freq, long fs_in,
+            int samples_per_ms, int samples_per_code,
+            bool dump,
+            std::string dump_filename);
+
+    pcps_fixed_point_acquisition_sc(unsigned int sampled_ms, unsigned int max_dwells,
+            unsigned int doppler_max, long freq, long fs_in,
+            int samples_per_ms, int samples_per_code,
+            bool dump,
+            std::string dump_filename);
+
+    void free_wipeoffs();
+
+    void update_doppler_window(bool force);
+
+    long d_fs_in;
+    long d_freq;
+    int d_samples_per_ms;
+    int d_samples_per_code;
+    float d_threshold;
+    unsigned int d_doppler_max;
+    unsigned int d_doppler_step;
+    unsigned int d_sampled_ms;
+    unsigned int d_max_dwells;
+    unsigned int d_well_count;
+    unsigned int d_vector_length;
+    unsigned int d_fft_size;
+    unsigned long int d_sample_counter;
+    unsigned int d_num_doppler_bins;
+    int d_doppler_center;              // Centre of the Doppler search, from Acquisition_Assistance [Hz]
+    unsigned int d_doppler_search_max; // Half width of the Doppler search, at most d_doppler_max [Hz]
+    std::vector<lv_16sc_t*> d_grid_doppler_wipeoffs;   // Q15 carriers
+    lv_16sc_t* d_fft_codes;                             // Q15 conjugated code spectrum
+    lv_16sc_t* d_input;                                 // Scaled input of the current dwell
+    lv_16sc_t* d_work;                                  // FFT work buffer
+    uint32_t* d_magnitude;
+    Fixed_Point_Fft* d_fft;
+    Fixed_Point_Fft* d_ifft;
+    Gnss_Synchro *d_gnss_synchro;
+    float d_mag;
+    float d_input_power;
+    float d_test_statistics;
+    std::ofstream d_dump_file;
+    bool d_active;
+    int d_state;
+    bool d_dump;
+    unsigned int d_channel;
+    std::string d_dump_filename;
+
+public:
+    /*!
+     * \brief Default destructor.
+     */
+     ~pcps_fixed_point_acquisition_sc();
+
+     /*!
+      * \brief Set acquisition/tracking common Gnss_Synchro object pointer
+      * to exchange synchronization data between acquisition and tracking blocks.
+      * \param p_gnss_synchro Satellite information shared by the processing blocks.
+      */
+     void set_gnss_synchro(Gnss_Synchro* p_gnss_synchro)
+     {
+         d_gnss_synchro = p_gnss_synchro;
+     }
+
+     /*!
+      * \brief Returns the maximum peak of grid search.
+      */
+     unsigned int mag()
+     {
+         return d_mag;
+     }
+
+     /*!
+      * \brief Initializes acquisition algorithm.
+      */
+     void init();
+
+     /*!
+      * \brief Sets the conjugated FFT of the local code, as computed in
+      * floating point by the Fft_Code_Cache. It is converted to Q15 here.
+      * \param fft_code - Conjugated spectrum of length fft_size(), of
+      * the code followed by zeros if the FFT is zero-padded.
+      */
+     void set_local_code_fft(std::shared_ptr<const gr_complex> fft_code);
+
+     /*!
+      * \brief Returns the FFT length used by the block: the input vector
+      * length if it is a power of two, else a power of two of at least
+      * twice that length.
+      */
+     unsigned int fft_size()
+     {
+         return d_fft_size;
+     }
+
+     /*!
+      * \brief Starts acquisition algorithm, turning from standby mode to
+      * active mode
+      * \param active - bool that activates/deactivates the block.
+      */
+     void set_active(bool active)
+     {
+         d_active = active;
+     }
+
+     /*!
+      * \brief If set to 1, ensures that acquisition starts at the
+      * first available sample.
+      * \param state - int=1 forces start of acquisition
+      */
+     void set_state(int state);
+
+     /*!
+      * \brief Set acquisition channel unique ID
+      * \param channel - receiver channel.
+      */
+     void set_channel(unsigned int channel)
+     {
+         d_channel = channel;
+     }
+
+     /*!
+      * \brief Set statistics threshold of PCPS algorithm.
+      * \param threshold - Threshold for signal detection.
+      */
+     void set_threshold(float threshold)
+     {
+         d_threshold = threshold;
+     }
+
+     /*!
+      * \brief Set maximum Doppler grid search
+      * \param doppler_max - Maximum Doppler shift considered in the grid search [Hz].
+      */
+     void set_doppler_max(unsigned int doppler_max)
+     {
+         d_doppler_max = doppler_max;
+     }
+
+     /*!
+      * \brief Set Doppler steps for the grid search
+      * \param doppler_step - Frequency bin of the search grid [Hz].
+      */
+     void set_doppler_step(unsigned int doppler_step)
+     {
+         d_doppler_step = doppler_step;
+     }
+
+     /*!
+      * \brief Parallel Code Phase Search Acquisition signal processing.
+      */
+     int general_work(int noutput_items, gr_vector_int &ninput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+};
+
+#endif /* GNSS_SDR_PCPS_FIXED_POINT_ACQUISITION_SC_H_*/
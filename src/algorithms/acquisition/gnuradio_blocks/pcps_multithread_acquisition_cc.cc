@@ -34,14 +34,18 @@
 
 #include "pcps_multithread_acquisition_cc.h"
 #include <sstream>
+#include <boost/bind.hpp>
 #include <boost/thread/mutex.hpp>
-#include <boost/thread/thread.hpp>
 #include <glog/logging.h>
 #include <gnuradio/io_signature.h>
 #include <volk/volk.h>
 #include <volk_gnsssdr/volk_gnsssdr.h>
 #include "control_message_factory.h"
 #include "GPS_L1_CA.h" //GPS_TWO_PI
+#include "acquisition_assistance.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
+#include "gnss_sdr_task_pool.h"
 
 using google::LogMessage;
 
@@ -50,13 +54,14 @@ pcps_multithread_acquisition_cc_sptr pcps_make_multithread_acquisition_cc(
                                  unsigned int doppler_max, long freq, long fs_in,
                                  int samples_per_ms, int samples_per_code,
                                  bool bit_transition_flag,
+                                 unsigned int num_threads,
                                  bool dump,
                                  std::string dump_filename)
 {
 
     return pcps_multithread_acquisition_cc_sptr(
             new pcps_multithread_acquisition_cc(sampled_ms, max_dwells, doppler_max, freq, fs_in, samples_per_ms,
-                                     samples_per_code, bit_transition_flag, dump, dump_filename));
+                                     samples_per_code, bit_transition_flag, num_threads, dump, dump_filename));
 }
 
 pcps_multithread_acquisition_cc::pcps_multithread_acquisition_cc(
@@ -64,6 +69,7 @@ pcps_multithread_acquisition_cc::pcps_multithread_acquisition_cc(
                          unsigned int doppler_max, long freq, long fs_in,
                          int samples_per_ms, int samples_per_code,
                          bool bit_transition_flag,
+                         unsigned int num_threads,
                          bool dump,
                          std::string dump_filename) :
     gr::block("pcps_multithread_acquisition_cc",
@@ -87,6 +93,8 @@ pcps_multithread_acquisition_cc::pcps_multithread_acquisition_cc(
     d_mag = 0;
     d_input_power = 0.0;
     d_num_doppler_bins = 0;
+    d_doppler_center = 0;
+    d_doppler_search_max = doppler_max;
     d_bit_transition_flag = bit_transition_flag;
     d_in_dwell_count = 0;
 
@@ -95,16 +103,33 @@ pcps_multithread_acquisition_cc::pcps_multithread_acquisition_cc(
     //todo: do something if posix_memalign fails
     for (unsigned int i = 0; i < d_max_dwells; i++)
         {
-            d_in_buffer[i] = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
+            d_in_buffer[i] = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
         }
-    d_fft_codes = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-    d_magnitude = static_cast<float*>(volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
+    d_fft_codes = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
+    d_magnitude = static_cast<float*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
 
     // Direct FFT
     d_fft_if = new gr::fft::fft_complex(d_fft_size, true);
 
     // Inverse FFT
     d_ifft = new gr::fft::fft_complex(d_fft_size, false);
+    Gnss_Sdr_Memory_Accounting::add_fft(d_fft_size, 2);
+
+    // Doppler search workers, each one with its own FFT plans and magnitude buffer
+    d_num_threads = std::max(num_threads, 1u);
+    d_worker_fft_if.push_back(d_fft_if);
+    d_worker_ifft.push_back(d_ifft);
+    d_worker_magnitude.push_back(d_magnitude);
+    for (unsigned int worker = 1; worker < d_num_threads; worker++)
+        {
+            d_worker_fft_if.push_back(new gr::fft::fft_complex(d_fft_size, true));
+            d_worker_ifft.push_back(new gr::fft::fft_complex(d_fft_size, false));
+            Gnss_Sdr_Memory_Accounting::add_fft(d_fft_size, 2);
+            d_worker_magnitude.push_back(static_cast<float*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(float), volk_get_alignment())));
+        }
+
+    d_dwell_task_id = Gnss_Sdr_Task_Pool::task_id("acquisition_dwell");
+    d_doppler_task_id = Gnss_Sdr_Task_Pool::task_id("acquisition_doppler_bins");
 
     // For dumping samples into a file
     d_dump = dump;
@@ -113,7 +138,6 @@ pcps_multithread_acquisition_cc::pcps_multithread_acquisition_cc(
     d_doppler_resolution = 0;
     d_threshold = 0;
     d_doppler_step = 0;
-    d_grid_doppler_wipeoffs = 0;
     d_gnss_synchro = 0;
     d_code_phase = 0;
     d_doppler_freq = 0;
@@ -123,27 +147,25 @@ pcps_multithread_acquisition_cc::pcps_multithread_acquisition_cc(
 
 pcps_multithread_acquisition_cc::~pcps_multithread_acquisition_cc()
 {
-    if (d_num_doppler_bins > 0)
-        {
-            for (unsigned int i = 0; i < d_num_doppler_bins; i++)
-                {
-                    volk_free(d_grid_doppler_wipeoffs[i]);
-                }
-            delete[] d_grid_doppler_wipeoffs;
-        }
-
     for (unsigned int i = 0; i < d_max_dwells; i++)
         {
-            volk_free(d_in_buffer[i]);
+            gnss_sdr_volk_free(d_in_buffer[i]);
         }
     delete[] d_in_buffer;
 
-    volk_free(d_fft_codes);
-    volk_free(d_magnitude);
+    gnss_sdr_volk_free(d_fft_codes);
+    gnss_sdr_volk_free(d_magnitude);
 
     delete d_ifft;
     delete d_fft_if;
 
+    for (unsigned int worker = 1; worker < d_num_threads; worker++)
+        {
+            gnss_sdr_volk_free(d_worker_magnitude[worker]);
+            delete d_worker_ifft[worker];
+            delete d_worker_fft_if[worker];
+        }
+
     if (d_dump)
         {
             d_dump_file.close();
@@ -164,26 +186,41 @@ void pcps_multithread_acquisition_cc::init()
     d_mag = 0.0;
     d_input_power = 0.0;
 
+    update_doppler_window(true);
+}
+
+
+void pcps_multithread_acquisition_cc::update_doppler_window(bool force)
+{
+    int doppler_center = 0;
+    unsigned int doppler_search_max = d_doppler_max;
+    if (d_gnss_synchro != 0)
+        {
+            Acquisition_Assistance::doppler_window(*d_gnss_synchro, d_doppler_max, d_doppler_step,
+                    doppler_center, doppler_search_max, static_cast<double>(d_sample_counter) / static_cast<double>(d_fs_in));
+        }
+    if (!force && doppler_center == d_doppler_center && doppler_search_max == d_doppler_search_max)
+        {
+            return;
+        }
+    d_doppler_center = doppler_center;
+    d_doppler_search_max = doppler_search_max;
+
     // Count the number of bins
     d_num_doppler_bins = 0;
-    for (int doppler = (int)(-d_doppler_max);
-         doppler <= (int)d_doppler_max;
+    for (int doppler = (int)(-d_doppler_search_max);
+         doppler <= (int)d_doppler_search_max;
          doppler += d_doppler_step)
     {
         d_num_doppler_bins++;
     }
 
-    // Create the carrier Doppler wipeoff signals
-    d_grid_doppler_wipeoffs = new gr_complex*[d_num_doppler_bins];
-    for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
-        {
-            d_grid_doppler_wipeoffs[doppler_index] = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-            int doppler = -(int)d_doppler_max + d_doppler_step * doppler_index;
-            float phase_step_rad = static_cast<float>(GPS_TWO_PI) * (d_freq + doppler) / static_cast<float>(d_fs_in);
-            float _phase[1];
-            _phase[0] = 0;
-            volk_gnsssdr_s32f_sincos_32fc(d_grid_doppler_wipeoffs[doppler_index], - phase_step_rad, _phase, d_fft_size);
-        }
+    // Get the carrier Doppler wipeoff signals, shared with the other channels
+    d_grid_doppler_wipeoffs = Doppler_Grid_Store::instance().get(d_fs_in, d_freq + d_doppler_center,
+            d_fft_size, d_doppler_search_max, d_doppler_step, d_num_doppler_bins);
+
+    d_bin_mag.assign(d_num_doppler_bins, 0.0);
+    d_bin_code_phase.assign(d_num_doppler_bins, 0);
 }
 
 void pcps_multithread_acquisition_cc::set_local_code(std::complex<float> * code)
@@ -196,17 +233,68 @@ void pcps_multithread_acquisition_cc::set_local_code(std::complex<float> * code)
     volk_32fc_conjugate_32fc(d_fft_codes, d_fft_if->get_outbuf(), d_fft_size);
 }
 
-void pcps_multithread_acquisition_cc::acquisition_core()
+void pcps_multithread_acquisition_cc::search_doppler_bins(unsigned int worker, const gr_complex* in)
 {
-    // initialize acquisition algorithm
-    int doppler;
 #if VOLK_GT_122
     uint16_t indext = 0;
 #else
     unsigned int indext = 0;
 #endif
-    float magt = 0.0;
     float fft_normalization_factor = (float)d_fft_size * (float)d_fft_size;
+    gr::fft::fft_complex* fft_if = d_worker_fft_if[worker];
+    gr::fft::fft_complex* ifft = d_worker_ifft[worker];
+    float* magnitude = d_worker_magnitude[worker];
+
+    // Contiguous chunk of Doppler bins assigned to this worker
+    unsigned int first_bin = (d_num_doppler_bins * worker) / d_num_threads;
+    unsigned int last_bin = (d_num_doppler_bins * (worker + 1)) / d_num_threads;
+
+    for (unsigned int doppler_index = first_bin; doppler_index < last_bin; doppler_index++)
+        {
+            volk_32fc_x2_multiply_32fc(fft_if->get_inbuf(), in,
+                        d_grid_doppler_wipeoffs->wipeoff(doppler_index), d_fft_size);
+
+            // Perform the FFT-based convolution  (parallel time search)
+            // Compute the FFT of the carrier wiped--off incoming signal
+            fft_if->execute();
+
+            // Multiply carrier wiped--off, Fourier transformed incoming signal
+            // with the local FFT'd code reference using SIMD operations with VOLK library
+            volk_32fc_x2_multiply_32fc(ifft->get_inbuf(),
+                        fft_if->get_outbuf(), d_fft_codes, d_fft_size);
+
+            // compute the inverse FFT
+            ifft->execute();
+
+            // Search maximum
+            volk_32fc_magnitude_squared_32f(magnitude, ifft->get_outbuf(), d_fft_size);
+            volk_32f_index_max_16u(&indext, magnitude, d_fft_size);
+
+            // Normalize the maximum value to correct the scale factor introduced by FFTW
+            d_bin_mag[doppler_index] = magnitude[indext] / (fft_normalization_factor * fft_normalization_factor);
+            d_bin_code_phase[doppler_index] = indext;
+
+            // Record results to file if required
+            if (d_dump)
+                {
+                    std::stringstream filename;
+                    std::ofstream dump_file;
+                    std::streamsize n = 2 * sizeof(float) * (d_fft_size); // complex file write
+                    filename.str("");
+                    filename << "../data/test_statistics_" << d_gnss_synchro->System
+                             <<"_" << d_gnss_synchro->Signal << "_sat_"
+                             << d_gnss_synchro->PRN << "_doppler_" << d_doppler_center + d_grid_doppler_wipeoffs->doppler(doppler_index) << ".dat";
+                    dump_file.open(filename.str().c_str(), std::ios::out | std::ios::binary);
+                    dump_file.write((char*)ifft->get_outbuf(), n); //write directly |abs(x)|^2 in this Doppler bin?
+                    dump_file.close();
+                }
+        }
+}
+
+
+void pcps_multithread_acquisition_cc::acquisition_core()
+{
+    // initialize acquisition algorithm
     gr_complex* in = d_in_buffer[d_well_count];
     unsigned long int samplestamp = d_sample_counter_buffer[d_well_count];
 
@@ -219,41 +307,27 @@ void pcps_multithread_acquisition_cc::acquisition_core()
             << " , doing acquisition of satellite: " << d_gnss_synchro->System << " "<< d_gnss_synchro->PRN
             << " ,sample stamp: " << d_sample_counter << ", threshold: "
             << d_threshold << ", doppler_max: " << d_doppler_max
-            << ", doppler_step: " << d_doppler_step;
+            << ", doppler_step: " << d_doppler_step
+            << ", doppler search: " << d_doppler_center << " +/- " << d_doppler_search_max;
 
     // 1- Compute the input signal power estimation
     volk_32fc_magnitude_squared_32f(d_magnitude, in, d_fft_size);
     volk_32f_accumulator_s32f(&d_input_power, d_magnitude, d_fft_size);
     d_input_power /= (float)d_fft_size;
 
-    // 2- Doppler frequency search loop
-    for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+    // 2- Doppler frequency search, split in chunks run by the task pool. This thread takes the first chunk.
+    Gnss_Sdr_Task_Group workers(d_doppler_task_id);
+    for (unsigned int worker = 1; worker < d_num_threads; worker++)
         {
-            // doppler search steps
-
-            doppler = -(int)d_doppler_max + d_doppler_step*doppler_index;
-
-            volk_32fc_x2_multiply_32fc(d_fft_if->get_inbuf(), in,
-                        d_grid_doppler_wipeoffs[doppler_index], d_fft_size);
-
-            // 3- Perform the FFT-based convolution  (parallel time search)
-            // Compute the FFT of the carrier wiped--off incoming signal
-            d_fft_if->execute();
-
-            // Multiply carrier wiped--off, Fourier transformed incoming signal
-            // with the local FFT'd code reference using SIMD operations with VOLK library
-            volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(),
-                        d_fft_if->get_outbuf(), d_fft_codes, d_fft_size);
-
-            // compute the inverse FFT
-            d_ifft->execute();
-
-            // Search maximum
-            volk_32fc_magnitude_squared_32f(d_magnitude, d_ifft->get_outbuf(), d_fft_size);
-            volk_32f_index_max_16u(&indext, d_magnitude, d_fft_size);
+            workers.run(boost::bind(&pcps_multithread_acquisition_cc::search_doppler_bins, this, worker, in));
+        }
+    search_doppler_bins(0, in);
+    workers.wait();
 
-            // Normalize the maximum value to correct the scale factor introduced by FFTW
-            magt = d_magnitude[indext] / (fft_normalization_factor * fft_normalization_factor);
+    // 3- Reduce the per-bin peaks in bin order, as a serial search would do
+    for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+        {
+            float magt = d_bin_mag[doppler_index];
 
             // 4- record the maximum peak and the associated synchronization parameters
             if (d_mag < magt)
@@ -269,8 +343,8 @@ void pcps_multithread_acquisition_cc::acquisition_core()
                     // restarted between consecutive dwells in multidwell operation.
                     if (d_test_statistics < (d_mag / d_input_power) || !d_bit_transition_flag)
                     {
-                        d_gnss_synchro->Acq_delay_samples = (double)(indext % d_samples_per_code);
-                        d_gnss_synchro->Acq_doppler_hz = (double)doppler;
+                        d_gnss_synchro->Acq_delay_samples = (double)(d_bin_code_phase[doppler_index] % d_samples_per_code);
+                        d_gnss_synchro->Acq_doppler_hz = (double)(d_doppler_center + d_grid_doppler_wipeoffs->doppler(doppler_index));
                         d_gnss_synchro->Acq_samplestamp_samples = samplestamp;
 
                         // 5- Compute the test statistics and compare to the threshold
@@ -278,20 +352,6 @@ void pcps_multithread_acquisition_cc::acquisition_core()
                         d_test_statistics = d_mag / d_input_power;
                     }
                 }
-
-            // Record results to file if required
-            if (d_dump)
-                {
-                    std::stringstream filename;
-                    std::streamsize n = 2 * sizeof(float) * (d_fft_size); // complex file write
-                    filename.str("");
-                    filename << "../data/test_statistics_" << d_gnss_synchro->System
-                             <<"_" << d_gnss_synchro->Signal << "_sat_"
-                             << d_gnss_synchro->PRN << "_doppler_" <<  doppler << ".dat";
-                    d_dump_file.open(filename.str().c_str(), std::ios::out | std::ios::binary);
-                    d_dump_file.write((char*)d_ifft->get_outbuf(), n); //write directly |abs(x)|^2 in this Doppler bin?
-                    d_dump_file.close();
-                }
         }
 
     if (!d_bit_transition_flag)
@@ -330,6 +390,10 @@ void pcps_multithread_acquisition_cc::set_state(int state)
     d_state = state;
     if (d_state == 1)
         {
+            if (!d_core_working)
+                {
+                    update_doppler_window(false);
+                }
             d_gnss_synchro->Acq_delay_samples = 0.0;
             d_gnss_synchro->Acq_doppler_hz = 0.0;
             d_gnss_synchro->Acq_samplestamp_samples = 0;
@@ -354,6 +418,7 @@ int pcps_multithread_acquisition_cc::general_work(int noutput_items,
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items __attribute__((unused)))
 {
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("pcps_multithread_acquisition_cc::general_work", d_channel, d_gnss_synchro ? d_gnss_synchro->PRN : 0);
 
     int acquisition_message = -1; //0=STOP_CHANNEL 1=ACQ_SUCCEES 2=ACQ_FAIL
 
@@ -363,6 +428,11 @@ int pcps_multithread_acquisition_cc::general_work(int noutput_items,
         {
             if (d_active)
                 {
+                    // The grid is only replaced once the last dwell has been searched
+                    if (!d_core_working)
+                        {
+                            update_doppler_window(false);
+                        }
                     //restart acquisition variables
                     d_gnss_synchro->Acq_delay_samples = 0.0;
                     d_gnss_synchro->Acq_doppler_hz = 0.0;
@@ -410,7 +480,7 @@ int pcps_multithread_acquisition_cc::general_work(int noutput_items,
                     d_sample_counter += d_fft_size * ninput_items[0];
                 }
 
-            // We create a new thread to process next block if the following
+            // We submit a new task to process next block if the following
             // conditions are fulfilled:
             //   1. There are new blocks in d_in_buffer that have not been processed yet
             //      (d_well_count < d_in_dwell_count).
@@ -422,7 +492,8 @@ int pcps_multithread_acquisition_cc::general_work(int noutput_items,
             if ((d_well_count < d_in_dwell_count) && !d_core_working && d_state==1)
                 {
                     d_core_working = true;
-                    boost::thread(&pcps_multithread_acquisition_cc::acquisition_core, this);
+                    Gnss_Sdr_Task_Pool::submit(d_dwell_task_id, TASK_PRIORITY_REALTIME,
+                            boost::bind(&pcps_multithread_acquisition_cc::acquisition_core, this));
                 }
 
             break;
@@ -5,7 +5,7 @@
  *  Acquisition strategy (Kay Borre book + CFAR threshold).
  *  <ol>
  *  <li> Compute the input signal power estimation
- *  <li> Doppler serial search loop
+ *  <li> Doppler search loop, split across a pool of worker threads
  *  <li> Perform the FFT-based circular convolution (parallel time search)
  *  <li> Record the maximum peak and the associated synchronization parameters
  *  <li> Compute the test statistics and compare to the threshold
@@ -52,12 +52,14 @@
 
 #include <algorithm>
 #include <fstream>
+#include <memory>
 #include <string>
 #include <vector>
 #include <gnuradio/block.h>
 #include <gnuradio/gr_complex.h>
 #include <gnuradio/fft/fft.h>
 #include "gnss_synchro.h"
+#include "doppler_grid_store.h"
 
 class pcps_multithread_acquisition_cc;
 
@@ -68,6 +70,7 @@ pcps_make_multithread_acquisition_cc(unsigned int sampled_ms, unsigned int max_d
                          unsigned int doppler_max, long freq, long fs_in,
                          int samples_per_ms, int samples_per_code,
                          bool bit_transition_flag,
+                         unsigned int num_threads,
                          bool dump,
                          std::string dump_filename);
 
@@ -76,6 +79,11 @@ pcps_make_multithread_acquisition_cc(unsigned int sampled_ms, unsigned int max_d
  *
  * Check \ref Navitec2012 "An Open Source Galileo E1 Software Receiver",
  * Algorithm 1, for a pseudocode description of this implementation.
+ *
+ * Each dwell is a task of the shared Gnss_Sdr_Task_Pool, and its Doppler
+ * bins are split in contiguous chunks among num_threads tasks, each one with
+ * its own FFT plans and magnitude buffer. The per-bin peaks are reduced afterwards in
+ * bin order, so the result does not depend on the number of workers.
  */
 class pcps_multithread_acquisition_cc: public gr::block
 {
@@ -85,6 +93,7 @@ private:
                              unsigned int doppler_max, long freq, long fs_in,
                              int samples_per_ms, int samples_per_code,
                              bool bit_transition_flag,
+                             unsigned int num_threads,
                              bool dump,
                              std::string dump_filename);
 
@@ -93,12 +102,15 @@ private:
                         unsigned int doppler_max, long freq, long fs_in,
                         int samples_per_ms, int samples_per_code,
                         bool bit_transition_flag,
+                        unsigned int num_threads,
                         bool dump,
                         std::string dump_filename);
 
     void calculate_magnitudes(gr_complex* fft_begin, int doppler_shift,
             int doppler_offset);
 
+    void search_doppler_bins(unsigned int worker, const gr_complex* in);
+
 
     long d_fs_in;
     long d_freq;
@@ -114,8 +126,10 @@ private:
     unsigned int d_well_count;
     unsigned int d_fft_size;
     unsigned long int d_sample_counter;
-    gr_complex** d_grid_doppler_wipeoffs;
+    std::shared_ptr<const Doppler_Grid> d_grid_doppler_wipeoffs;
     unsigned int d_num_doppler_bins;
+    int d_doppler_center;              // Centre of the Doppler search, from Acquisition_Assistance [Hz]
+    unsigned int d_doppler_search_max; // Half width of the Doppler search, at most d_doppler_max [Hz]
     gr_complex* d_fft_codes;
     gr::fft::fft_complex* d_fft_if;
     gr::fft::fft_complex* d_ifft;
@@ -137,6 +151,16 @@ private:
     gr_complex** d_in_buffer;
     std::vector<unsigned long int> d_sample_counter_buffer;
     unsigned int d_in_dwell_count;
+    unsigned int d_num_threads;
+    std::vector<gr::fft::fft_complex*> d_worker_fft_if;   // Worker 0 uses d_fft_if
+    std::vector<gr::fft::fft_complex*> d_worker_ifft;     // Worker 0 uses d_ifft
+    std::vector<float*> d_worker_magnitude;               // Worker 0 uses d_magnitude
+    std::vector<float> d_bin_mag;                         // Normalized peak of each Doppler bin
+    std::vector<unsigned int> d_bin_code_phase;           // Position of the peak of each Doppler bin
+    unsigned int d_dwell_task_id;                         // for the metrics of the task pool
+    unsigned int d_doppler_task_id;
+
+    void update_doppler_window(bool force);
 
 public:
     /*!
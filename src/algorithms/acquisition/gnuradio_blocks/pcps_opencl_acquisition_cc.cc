@@ -60,7 +60,12 @@
 #include "control_message_factory.h"
 #include "fft_base_kernels.h"
 #include "fft_internal.h"
+#include "opencl_environment.h"
+#include "pcps_opencl_acquisition_kernels.h"
 #include "GPS_L1_CA.h" //GPS_TWO_PI
+#include "acquisition_assistance.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
 
 
 using google::LogMessage;
@@ -108,25 +113,32 @@ pcps_opencl_acquisition_cc::pcps_opencl_acquisition_cc(
     d_mag = 0;
     d_input_power = 0.0;
     d_num_doppler_bins = 0;
+    d_doppler_center = 0;
+    d_doppler_search_max = doppler_max;
     d_bit_transition_flag = bit_transition_flag;
     d_in_dwell_count = 0;
     d_cl_fft_batch_size = 1;
+    d_cl_grid_bins = 0;
+    d_cl_peak_group_size = 1;
+    d_cl_buffer_grid_doppler_wipeoffs = 0;
+    d_cl_buffer_peak_values = 0;
+    d_cl_buffer_peak_indexes = 0;
 
     d_in_buffer = new gr_complex*[d_max_dwells];
     for (unsigned int i = 0; i < d_max_dwells; i++)
         {
-            d_in_buffer[i] = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
+            d_in_buffer[i] = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
         }
-    d_magnitude = static_cast<float*>(volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
-    d_fft_codes = static_cast<gr_complex*>(volk_malloc(d_fft_size_pow2 * sizeof(gr_complex), volk_get_alignment()));
-    d_zero_vector = static_cast<gr_complex*>(volk_malloc((d_fft_size_pow2 - d_fft_size) * sizeof(gr_complex), volk_get_alignment()));
+    d_magnitude = static_cast<float*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
+    d_fft_codes = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size_pow2 * sizeof(gr_complex), volk_get_alignment()));
+    d_zero_vector = static_cast<gr_complex*>(gnss_sdr_volk_malloc((d_fft_size_pow2 - d_fft_size) * sizeof(gr_complex), volk_get_alignment()));
 
     for (unsigned int i = 0; i < (d_fft_size_pow2-d_fft_size); i++)
         {
             d_zero_vector[i] = gr_complex(0.0,0.0);
         }
 
-    d_opencl = init_opencl_environment("math_kernel.cl");
+    d_opencl = init_opencl_environment();
 
     if (d_opencl != 0)
     {
@@ -135,6 +147,7 @@ pcps_opencl_acquisition_cc::pcps_opencl_acquisition_cc(
 
         // Inverse FFT
         d_ifft = new gr::fft::fft_complex(d_fft_size, false);
+        Gnss_Sdr_Memory_Accounting::add_fft(d_fft_size, 2);
     }
 
     // For dumping samples into a file
@@ -147,24 +160,15 @@ pcps_opencl_acquisition_cc::pcps_opencl_acquisition_cc(
 
 pcps_opencl_acquisition_cc::~pcps_opencl_acquisition_cc()
 {
-    if (d_num_doppler_bins > 0)
-        {
-            for (unsigned int i = 0; i < d_num_doppler_bins; i++)
-                {
-                    volk_free(d_grid_doppler_wipeoffs[i]);
-                }
-            delete[] d_grid_doppler_wipeoffs;
-        }
-
     for (unsigned int i = 0; i < d_max_dwells; i++)
         {
-            volk_free(d_in_buffer[i]);
+            gnss_sdr_volk_free(d_in_buffer[i]);
         }
     delete[] d_in_buffer;
 
-    volk_free(d_fft_codes);
-    volk_free(d_magnitude);
-    volk_free(d_zero_vector);
+    gnss_sdr_volk_free(d_fft_codes);
+    gnss_sdr_volk_free(d_magnitude);
+    gnss_sdr_volk_free(d_zero_vector);
 
     if (d_opencl == 0)
         {
@@ -172,12 +176,10 @@ pcps_opencl_acquisition_cc::~pcps_opencl_acquisition_cc()
             delete d_cl_buffer_in;
             delete d_cl_buffer_1;
             delete d_cl_buffer_2;
-            delete d_cl_buffer_magnitude;
             delete d_cl_buffer_fft_codes;
-            if(d_num_doppler_bins > 0)
-                {
-                    delete[] d_cl_buffer_grid_doppler_wipeoffs;
-                }
+            delete d_cl_buffer_grid_doppler_wipeoffs;
+            delete d_cl_buffer_peak_values;
+            delete d_cl_buffer_peak_indexes;
 
             clFFT_DestroyPlan(d_cl_fft_plan);
         }
@@ -195,74 +197,44 @@ pcps_opencl_acquisition_cc::~pcps_opencl_acquisition_cc()
 
 
 
-int pcps_opencl_acquisition_cc::init_opencl_environment(std::string kernel_filename)
+int pcps_opencl_acquisition_cc::init_opencl_environment()
 {
-    //get all platforms (drivers)
-    std::vector<cl::Platform> all_platforms;
-    cl::Platform::get(&all_platforms);
-
-    if(all_platforms.size()==0)
-    {
-        std::cout << "No OpenCL platforms found. Check OpenCL installation!" << std::endl;
-        return 1;
-    }
-
-    d_cl_platform = all_platforms[0]; //get default platform
-    std::cout << "Using platform: " << d_cl_platform.getInfo<CL_PLATFORM_NAME>()
-              << std::endl;
-
-    //get default GPU device of the default platform
-    std::vector<cl::Device> gpu_devices;
-    d_cl_platform.getDevices(CL_DEVICE_TYPE_GPU, &gpu_devices);
-
-    if(gpu_devices.size()==0)
-    {
-        std::cout << "No GPU devices found. Check OpenCL installation!" << std::endl;
-        return 2;
-    }
-
-    d_cl_device = gpu_devices[0];
-
-    std::vector<cl::Device> device;
-    device.push_back(d_cl_device);
-    std::cout << "Using device: " << d_cl_device.getInfo<CL_DEVICE_NAME>() << std::endl;
-
-    cl::Context context(device);
-    d_cl_context = context;
-
-    // build the program from the source in the file
-    std::ifstream kernel_file(kernel_filename, std::ifstream::in);
-    std::string kernel_code(std::istreambuf_iterator<char>(kernel_file),
-        (std::istreambuf_iterator<char>()));
-    kernel_file.close();
-
-    // std::cout << "Kernel code: \n" << kernel_code << std::endl;
-
-    cl::Program::Sources sources;
-
-    sources.push_back({kernel_code.c_str(),kernel_code.length()});
+    // The context and the compiled kernels are shared by all the channels
+    Opencl_Environment& environment = Opencl_Environment::instance();
+    if (environment.status() != 0)
+        {
+            return environment.status();
+        }
+    d_cl_device = environment.device();
+    d_cl_context = environment.context();
 
-    cl::Program program(context,sources);
-    if(program.build(device)!=CL_SUCCESS)
-    {
-        std::cout << " Error building: "
-                  << program.getBuildInfo<CL_PROGRAM_BUILD_LOG>(device[0])
-                  << std::endl;
-        return 3;
-    }
-    d_cl_program = program;
+    if (!environment.program("pcps_opencl_acquisition", pcps_opencl_acquisition_kernels, d_cl_program))
+        {
+            return 3;
+        }
+    d_cl_kernel_conj = cl::Kernel(d_cl_program, "conj_vector");
+    d_cl_kernel_wipeoff = cl::Kernel(d_cl_program, "doppler_wipeoff_batch");
+    d_cl_kernel_code_product = cl::Kernel(d_cl_program, "code_product_batch");
+    d_cl_kernel_peak_search = cl::Kernel(d_cl_program, "peak_search_batch");
+
+    // Largest power of two the device runs, up to the local buffers of the kernel
+    size_t max_group_size = d_cl_kernel_peak_search.getWorkGroupInfo<CL_KERNEL_WORK_GROUP_SIZE>(d_cl_device);
+    d_cl_peak_group_size = 1;
+    while (2 * d_cl_peak_group_size <= std::min<size_t>(max_group_size, PCPS_OPENCL_PEAK_GROUP_SIZE))
+        {
+            d_cl_peak_group_size *= 2;
+        }
 
-    // create buffers on the device
+    // create buffers on the device. Those of the Doppler bins are sized in init()
     d_cl_buffer_in = new cl::Buffer(d_cl_context, CL_MEM_READ_WRITE, sizeof(gr_complex)*d_fft_size);
     d_cl_buffer_fft_codes = new cl::Buffer(d_cl_context, CL_MEM_READ_WRITE, sizeof(gr_complex)*d_fft_size_pow2);
     d_cl_buffer_1 = new cl::Buffer(d_cl_context, CL_MEM_READ_WRITE, sizeof(gr_complex)*d_fft_size_pow2);
     d_cl_buffer_2 = new cl::Buffer(d_cl_context, CL_MEM_READ_WRITE, sizeof(gr_complex)*d_fft_size_pow2);
-    d_cl_buffer_magnitude = new cl::Buffer(d_cl_context, CL_MEM_READ_WRITE, sizeof(float)*d_fft_size);
 
     //create queue to which we will push commands for the device.
     d_cl_queue = new cl::CommandQueue(d_cl_context,d_cl_device);
 
-    //create FFT plan
+    //create FFT plan. Its kernels are also built from a cached binary when possible
     cl_int err;
     clFFT_Dim3 dim = {d_fft_size_pow2, 1, 1};
 
@@ -275,7 +247,6 @@ int pcps_opencl_acquisition_cc::init_opencl_environment(std::string kernel_filen
         delete d_cl_buffer_in;
         delete d_cl_buffer_1;
         delete d_cl_buffer_2;
-        delete d_cl_buffer_magnitude;
         delete d_cl_buffer_fft_codes;
 
         std::cout << "Error creating OpenCL FFT plan." << std::endl;
@@ -286,6 +257,41 @@ int pcps_opencl_acquisition_cc::init_opencl_environment(std::string kernel_filen
 }
 
 
+void pcps_opencl_acquisition_cc::allocate_grid_buffers()
+{
+    // Batched buffers, kept between acquisitions while the number of bins does not change
+    if (d_cl_grid_bins != d_num_doppler_bins)
+        {
+            delete d_cl_buffer_1;
+            delete d_cl_buffer_2;
+            delete d_cl_buffer_grid_doppler_wipeoffs;
+            delete d_cl_buffer_peak_values;
+            delete d_cl_buffer_peak_indexes;
+            d_cl_buffer_1 = new cl::Buffer(d_cl_context, CL_MEM_READ_WRITE, sizeof(gr_complex) * d_fft_size_pow2 * d_num_doppler_bins);
+            d_cl_buffer_2 = new cl::Buffer(d_cl_context, CL_MEM_READ_WRITE, sizeof(gr_complex) * d_fft_size_pow2 * d_num_doppler_bins);
+            d_cl_buffer_grid_doppler_wipeoffs = new cl::Buffer(d_cl_context, CL_MEM_READ_ONLY, sizeof(gr_complex) * d_fft_size * d_num_doppler_bins);
+            d_cl_buffer_peak_values = new cl::Buffer(d_cl_context, CL_MEM_WRITE_ONLY, sizeof(cl_float) * d_num_doppler_bins);
+            d_cl_buffer_peak_indexes = new cl::Buffer(d_cl_context, CL_MEM_WRITE_ONLY, sizeof(cl_uint) * d_num_doppler_bins);
+            d_peak_values.resize(d_num_doppler_bins);
+            d_peak_indexes.resize(d_num_doppler_bins);
+            d_cl_grid_bins = d_num_doppler_bins;
+            d_cl_uploaded_grid.reset();
+        }
+
+    // The grid is only uploaded again when the search changes
+    if (d_cl_uploaded_grid != d_grid_doppler_wipeoffs)
+        {
+            for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+                {
+                    d_cl_queue->enqueueWriteBuffer(*d_cl_buffer_grid_doppler_wipeoffs, CL_TRUE,
+                                                   sizeof(gr_complex) * d_fft_size * doppler_index,
+                                                   sizeof(gr_complex) * d_fft_size,
+                                                   d_grid_doppler_wipeoffs->wipeoff(doppler_index));
+                }
+            d_cl_uploaded_grid = d_grid_doppler_wipeoffs;
+        }
+}
+
 
 void pcps_opencl_acquisition_cc::init()
 {
@@ -301,49 +307,43 @@ void pcps_opencl_acquisition_cc::init()
     d_mag = 0.0;
     d_input_power = 0.0;
 
+    update_doppler_window(true);
+}
+
+
+void pcps_opencl_acquisition_cc::update_doppler_window(bool force)
+{
+    int doppler_center = 0;
+    unsigned int doppler_search_max = d_doppler_max;
+    if (d_gnss_synchro != 0)
+        {
+            Acquisition_Assistance::doppler_window(*d_gnss_synchro, d_doppler_max, d_doppler_step,
+                    doppler_center, doppler_search_max, static_cast<double>(d_sample_counter) / static_cast<double>(d_fs_in));
+        }
+    if (!force && doppler_center == d_doppler_center && doppler_search_max == d_doppler_search_max)
+        {
+            return;
+        }
+    d_doppler_center = doppler_center;
+    d_doppler_search_max = doppler_search_max;
+
     // Count the number of bins
     d_num_doppler_bins = 0;
-    for (int doppler = static_cast<int>(-d_doppler_max);
-         doppler <= static_cast<int>(d_doppler_max);
+    for (int doppler = static_cast<int>(-d_doppler_search_max);
+         doppler <= static_cast<int>(d_doppler_search_max);
          doppler += d_doppler_step)
     {
         d_num_doppler_bins++;
     }
 
-    // Create the carrier Doppler wipeoff signals
-    d_grid_doppler_wipeoffs = new gr_complex*[d_num_doppler_bins];
-    if (d_opencl == 0)
-        {
-            d_cl_buffer_grid_doppler_wipeoffs = new cl::Buffer*[d_num_doppler_bins];
-        }
+    // Get the carrier Doppler wipeoff signals, shared with the other channels
+    d_grid_doppler_wipeoffs = Doppler_Grid_Store::instance().get(d_fs_in, d_freq + d_doppler_center,
+            d_fft_size, d_doppler_search_max, d_doppler_step, d_num_doppler_bins);
 
-    for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+    if (d_opencl == 0)
         {
-            d_grid_doppler_wipeoffs[doppler_index] = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-
-            int doppler = -static_cast<int>(d_doppler_max) + d_doppler_step * doppler_index;
-            float phase_step_rad = static_cast<float>(GPS_TWO_PI) * (d_freq + doppler) / static_cast<float>(d_fs_in);
-            float _phase[1];
-            _phase[0] = 0;
-            volk_gnsssdr_s32f_sincos_32fc(d_grid_doppler_wipeoffs[doppler_index], - phase_step_rad, _phase, d_fft_size);
-
-            if (d_opencl == 0)
-                {
-                    d_cl_buffer_grid_doppler_wipeoffs[doppler_index] =
-                            new cl::Buffer(d_cl_context, CL_MEM_READ_WRITE, sizeof(gr_complex)*d_fft_size);
-
-                    d_cl_queue->enqueueWriteBuffer(*(d_cl_buffer_grid_doppler_wipeoffs[doppler_index]),
-                                                   CL_TRUE, 0, sizeof(gr_complex)*d_fft_size,
-                                                   d_grid_doppler_wipeoffs[doppler_index]);
-                }
+            allocate_grid_buffers();
         }
-
-    // zero padding in buffer_1 (FFT input)
-    if (d_opencl == 0)
-    {
-        d_cl_queue->enqueueWriteBuffer(*d_cl_buffer_1, CL_TRUE, sizeof(gr_complex)*d_fft_size,
-                                       sizeof(gr_complex)*(d_fft_size_pow2 - d_fft_size), d_zero_vector);
-    }
 }
 
 void pcps_opencl_acquisition_cc::set_local_code(std::complex<float> * code)
@@ -365,11 +365,10 @@ void pcps_opencl_acquisition_cc::set_local_code(std::complex<float> * code)
                     clFFT_Forward, (*d_cl_buffer_2)(), (*d_cl_buffer_2)(),
                     0, NULL, NULL);
 
-            //Conjucate the local code
-            cl::Kernel kernel = cl::Kernel(d_cl_program, "conj_vector");
-            kernel.setArg(0, *d_cl_buffer_2);         //input
-            kernel.setArg(1, *d_cl_buffer_fft_codes); //output
-            d_cl_queue->enqueueNDRangeKernel(kernel, cl::NullRange, cl::NDRange(d_fft_size_pow2), cl::NullRange);
+            //Conjucate the local code, which then stays in the device
+            d_cl_kernel_conj.setArg(0, *d_cl_buffer_2);         //input
+            d_cl_kernel_conj.setArg(1, *d_cl_buffer_fft_codes); //output
+            d_cl_queue->enqueueNDRangeKernel(d_cl_kernel_conj, cl::NullRange, cl::NDRange(d_fft_size_pow2), cl::NullRange);
         }
     else
         {
@@ -405,7 +404,8 @@ void pcps_opencl_acquisition_cc::acquisition_core_volk()
             << " , doing acquisition of satellite: " << d_gnss_synchro->System << " "<< d_gnss_synchro->PRN
             << " ,sample stamp: " << d_sample_counter << ", threshold: "
             << d_threshold << ", doppler_max: " << d_doppler_max
-            << ", doppler_step: " << d_doppler_step;
+            << ", doppler_step: " << d_doppler_step
+            << ", doppler search: " << d_doppler_center << " +/- " << d_doppler_search_max;
 
     // 1- Compute the input signal power estimation
     volk_32fc_magnitude_squared_32f(d_magnitude, in, d_fft_size);
@@ -416,10 +416,10 @@ void pcps_opencl_acquisition_cc::acquisition_core_volk()
     for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
         {
             // doppler search steps
-            doppler = -static_cast<int>(d_doppler_max) + d_doppler_step * doppler_index;
+            doppler = d_doppler_center - static_cast<int>(d_doppler_search_max) + d_doppler_step * doppler_index;
             
             volk_32fc_x2_multiply_32fc(d_fft_if->get_inbuf(), in,
-                        d_grid_doppler_wipeoffs[doppler_index], d_fft_size);
+                        d_grid_doppler_wipeoffs->wipeoff(doppler_index), d_fft_size);
 
             // 3- Perform the FFT-based convolution  (parallel time search)
             // Compute the FFT of the carrier wiped--off incoming signal
@@ -541,70 +541,71 @@ void pcps_opencl_acquisition_cc::acquisition_core_opencl()
             << " , doing acquisition of satellite: " << d_gnss_synchro->System << " " << d_gnss_synchro->PRN
             << " ,sample stamp: " << d_sample_counter << ", threshold: "
             << d_threshold << ", doppler_max: " << d_doppler_max
-            << ", doppler_step: " << d_doppler_step;
+            << ", doppler_step: " << d_doppler_step
+            << ", doppler search: " << d_doppler_center << " +/- " << d_doppler_search_max;
 
     // 1- Compute the input signal power estimation
     volk_32fc_magnitude_squared_32f(d_magnitude, in, d_fft_size);
     volk_32f_accumulator_s32f(&d_input_power, d_magnitude, d_fft_size);
     d_input_power /= static_cast<float>(d_fft_size);
 
-    cl::Kernel kernel;
+    // 2- Search all the Doppler bins at once
+    const cl_uint fft_size = d_fft_size;
+    const cl_uint fft_size_pow2 = d_fft_size_pow2;
+    const size_t batch_length = d_fft_size_pow2 * d_num_doppler_bins;
+
+    // Multiply input signal with the doppler wipe-off of every bin, zero-padded
+    d_cl_kernel_wipeoff.setArg(0, *d_cl_buffer_in);
+    d_cl_kernel_wipeoff.setArg(1, *d_cl_buffer_grid_doppler_wipeoffs);
+    d_cl_kernel_wipeoff.setArg(2, *d_cl_buffer_1);
+    d_cl_kernel_wipeoff.setArg(3, fft_size);
+    d_cl_kernel_wipeoff.setArg(4, fft_size_pow2);
+    d_cl_queue->enqueueNDRangeKernel(d_cl_kernel_wipeoff, cl::NullRange, cl::NDRange(batch_length),
+                                     cl::NullRange);
+
+    // 3- Perform the FFT-based convolution (parallel time search) of all the bins
+    clFFT_ExecuteInterleaved((*d_cl_queue)(), d_cl_fft_plan, d_num_doppler_bins,
+                              clFFT_Forward, (*d_cl_buffer_1)(), (*d_cl_buffer_2)(),
+                              0, NULL, NULL);
+
+    // Multiply carrier wiped--off, Fourier transformed incoming signal
+    // with the local FFT'd code reference
+    d_cl_kernel_code_product.setArg(0, *d_cl_buffer_2);
+    d_cl_kernel_code_product.setArg(1, *d_cl_buffer_fft_codes);
+    d_cl_kernel_code_product.setArg(2, fft_size_pow2);
+    d_cl_queue->enqueueNDRangeKernel(d_cl_kernel_code_product, cl::NullRange, cl::NDRange(batch_length),
+                                     cl::NullRange);
+
+    // compute the inverse FFT
+    clFFT_ExecuteInterleaved((*d_cl_queue)(), d_cl_fft_plan, d_num_doppler_bins,
+                              clFFT_Inverse, (*d_cl_buffer_2)(), (*d_cl_buffer_2)(),
+                              0, NULL, NULL);
+
+    // Search the maximum of each bin in the GPU
+    d_cl_kernel_peak_search.setArg(0, *d_cl_buffer_2);
+    d_cl_kernel_peak_search.setArg(1, *d_cl_buffer_peak_values);
+    d_cl_kernel_peak_search.setArg(2, *d_cl_buffer_peak_indexes);
+    d_cl_kernel_peak_search.setArg(3, fft_size);
+    d_cl_kernel_peak_search.setArg(4, fft_size_pow2);
+    d_cl_queue->enqueueNDRangeKernel(d_cl_kernel_peak_search, cl::NullRange,
+                                     cl::NDRange(d_cl_peak_group_size * d_num_doppler_bins),
+                                     cl::NDRange(d_cl_peak_group_size));
+
+    // These are the only reads, and the second one blocks this thread until all
+    // previously enqueued OpenCL commands are completed.
+    d_cl_queue->enqueueReadBuffer(*d_cl_buffer_peak_indexes, CL_FALSE, 0,
+                                  sizeof(cl_uint) * d_num_doppler_bins, d_peak_indexes.data());
+    d_cl_queue->enqueueReadBuffer(*d_cl_buffer_peak_values, CL_TRUE, 0,
+                                  sizeof(cl_float) * d_num_doppler_bins, d_peak_values.data());
 
-    // 2- Doppler frequency search loop
     for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
         {
             // doppler search steps
-
-            doppler = -static_cast<int>(d_doppler_max) + d_doppler_step*doppler_index;
-
-            //Multiply input signal with doppler wipe-off
-            kernel = cl::Kernel(d_cl_program, "mult_vectors");
-            kernel.setArg(0, *d_cl_buffer_in); //input 1
-            kernel.setArg(1, *d_cl_buffer_grid_doppler_wipeoffs[doppler_index]); //input 2
-            kernel.setArg(2, *d_cl_buffer_1); //output
-            d_cl_queue->enqueueNDRangeKernel(kernel,cl::NullRange, cl::NDRange(d_fft_size),
-                                             cl::NullRange);
-
-            // In the previous operation, we store the result in the first d_fft_size positions
-            // of d_cl_buffer_1. The rest d_fft_size_pow2-d_fft_size already have zeros
-            // (zero-padding is made in init() for optimization purposes).
-
-            clFFT_ExecuteInterleaved((*d_cl_queue)(), d_cl_fft_plan, d_cl_fft_batch_size,
-                                      clFFT_Forward,(*d_cl_buffer_1)(), (*d_cl_buffer_2)(),
-                                      0, NULL, NULL);
-
-            // Multiply carrier wiped--off, Fourier transformed incoming signal
-            // with the local FFT'd code reference
-            kernel = cl::Kernel(d_cl_program, "mult_vectors");
-            kernel.setArg(0, *d_cl_buffer_2);         //input 1
-            kernel.setArg(1, *d_cl_buffer_fft_codes); //input 2
-            kernel.setArg(2, *d_cl_buffer_2);         //output
-            d_cl_queue->enqueueNDRangeKernel(kernel, cl::NullRange, cl::NDRange(d_fft_size_pow2),
-                                             cl::NullRange);
-
-            // compute the inverse FFT
-            clFFT_ExecuteInterleaved((*d_cl_queue)(), d_cl_fft_plan, d_cl_fft_batch_size,
-                                      clFFT_Inverse, (*d_cl_buffer_2)(), (*d_cl_buffer_2)(),
-                                      0, NULL, NULL);
-
-            // Compute magnitude
-            kernel = cl::Kernel(d_cl_program, "magnitude_squared");
-            kernel.setArg(0, *d_cl_buffer_2);         //input 1
-            kernel.setArg(1, *d_cl_buffer_magnitude); //output
-            d_cl_queue->enqueueNDRangeKernel(kernel, cl::NullRange, cl::NDRange(d_fft_size),
-                                             cl::NullRange);
-
-            // This is the only function that blocks this thread until all previously enqueued
-            // OpenCL commands are completed.
-            d_cl_queue->enqueueReadBuffer(*d_cl_buffer_magnitude, CL_TRUE, 0,
-                                          sizeof(float)*d_fft_size,d_magnitude);
-
-            // Search maximum
-            // @TODO: find an efficient way to search the maximum with OpenCL in the GPU.
-            volk_32f_index_max_16u(&indext, d_magnitude, d_fft_size);
+            doppler = d_doppler_center - static_cast<int>(d_doppler_search_max) + d_doppler_step * doppler_index;
+            indext = d_peak_indexes[doppler_index];
 
             // Normalize the maximum value to correct the scale factor introduced by FFTW
-            magt = d_magnitude[indext] / (fft_normalization_factor * fft_normalization_factor);
+            magt = d_peak_values[doppler_index] / (fft_normalization_factor * fft_normalization_factor);
 
             // 4- record the maximum peak and the associated synchronization parameters
             if (d_mag < magt)
@@ -639,8 +640,13 @@ void pcps_opencl_acquisition_cc::acquisition_core_opencl()
                     filename << "../data/test_statistics_" << d_gnss_synchro->System
                              << "_" << d_gnss_synchro->Signal << "_sat_"
                              << d_gnss_synchro->PRN << "_doppler_" <<  doppler << ".dat";
+                    // The correlations are only in the device
+                    std::vector<gr_complex> correlation(d_fft_size);
+                    d_cl_queue->enqueueReadBuffer(*d_cl_buffer_2, CL_TRUE,
+                                                  sizeof(gr_complex) * d_fft_size_pow2 * doppler_index,
+                                                  sizeof(gr_complex) * d_fft_size, correlation.data());
                     d_dump_file.open(filename.str().c_str(), std::ios::out | std::ios::binary);
-                    d_dump_file.write((char*)d_ifft->get_outbuf(), n); //write directly |abs(x)|^2 in this Doppler bin?
+                    d_dump_file.write((char*)correlation.data(), n); //write directly |abs(x)|^2 in this Doppler bin?
                     d_dump_file.close();
                 }
         }
@@ -684,6 +690,10 @@ void pcps_opencl_acquisition_cc::set_state(int state)
     d_state = state;
     if (d_state == 1)
         {
+            if (!d_core_working)
+                {
+                    update_doppler_window(false);
+                }
             d_gnss_synchro->Acq_delay_samples = 0.0;
             d_gnss_synchro->Acq_doppler_hz = 0.0;
             d_gnss_synchro->Acq_samplestamp_samples = 0;
@@ -706,6 +716,7 @@ int pcps_opencl_acquisition_cc::general_work(int noutput_items,
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items __attribute__((unused)))
 {
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("pcps_opencl_acquisition_cc::general_work", d_channel, d_gnss_synchro ? d_gnss_synchro->PRN : 0);
     int acquisition_message = -1; //0=STOP_CHANNEL 1=ACQ_SUCCEES 2=ACQ_FAIL
     switch (d_state)
     {
@@ -713,6 +724,11 @@ int pcps_opencl_acquisition_cc::general_work(int noutput_items,
         {
             if (d_active)
                 {
+                    // The grid is only replaced once the last dwell has been searched
+                    if (!d_core_working)
+                        {
+                            update_doppler_window(false);
+                        }
                     //restart acquisition variables
                     d_gnss_synchro->Acq_delay_samples = 0.0;
                     d_gnss_synchro->Acq_doppler_hz = 0.0;
@@ -52,6 +52,7 @@
 #define GNSS_SDR_PCPS_OPENCL_ACQUISITION_CC_H_
 
 #include <fstream>
+#include <memory>
 #include <string>
 #include <vector>
 #include <gnuradio/block.h>
@@ -59,6 +60,7 @@
 #include <gnuradio/fft/fft.h>
 #include "fft_internal.h"
 #include "gnss_synchro.h"
+#include "doppler_grid_store.h"
 
 #ifdef __APPLE__
    #include "cl.hpp"
@@ -83,6 +85,11 @@ pcps_make_opencl_acquisition_cc(unsigned int sampled_ms, unsigned int max_dwells
  *
  * Check \ref Navitec2012 "An Open Source Galileo E1 Software Receiver",
  * Algorithm 1, for a pseudocode description of this implementation.
+ *
+ * On the GPU the Doppler grid and the code spectrum stay in device memory,
+ * and every dwell searches all the Doppler bins with batched kernels and
+ * FFTs. The OpenCL context and the compiled kernels are shared by all the
+ * channels (see Opencl_Environment).
  */
 class pcps_opencl_acquisition_cc: public gr::block
 {
@@ -105,7 +112,11 @@ private:
     void calculate_magnitudes(gr_complex* fft_begin, int doppler_shift,
             int doppler_offset);
 
-    int init_opencl_environment(std::string kernel_filename);
+    int init_opencl_environment();
+
+    void allocate_grid_buffers();
+
+    void update_doppler_window(bool force);
 
     long d_fs_in;
     long d_freq;
@@ -123,8 +134,10 @@ private:
     unsigned int d_fft_size_pow2;
     int* d_max_doppler_indexs;
     unsigned long int d_sample_counter;
-    gr_complex** d_grid_doppler_wipeoffs;
+    std::shared_ptr<const Doppler_Grid> d_grid_doppler_wipeoffs;
     unsigned int d_num_doppler_bins;
+    int d_doppler_center;              // Centre of the Doppler search, from Acquisition_Assistance [Hz]
+    unsigned int d_doppler_search_max; // Half width of the Doppler search, at most d_doppler_max [Hz]
     gr_complex* d_fft_codes;
     gr::fft::fft_complex* d_fft_if;
     gr::fft::fft_complex* d_ifft;
@@ -148,16 +161,25 @@ private:
     std::vector<unsigned long int> d_sample_counter_buffer;
     unsigned int d_in_dwell_count;
 
-    cl::Platform d_cl_platform;
     cl::Device d_cl_device;
     cl::Context d_cl_context;
     cl::Program d_cl_program;
+    cl::Kernel d_cl_kernel_conj;
+    cl::Kernel d_cl_kernel_wipeoff;
+    cl::Kernel d_cl_kernel_code_product;
+    cl::Kernel d_cl_kernel_peak_search;
+    size_t d_cl_peak_group_size;
     cl::Buffer* d_cl_buffer_in;
     cl::Buffer* d_cl_buffer_fft_codes;
-    cl::Buffer* d_cl_buffer_1;
-    cl::Buffer* d_cl_buffer_2;
-    cl::Buffer* d_cl_buffer_magnitude;
-    cl::Buffer** d_cl_buffer_grid_doppler_wipeoffs;
+    cl::Buffer* d_cl_buffer_1;               // wiped off input of every bin (num_bins x d_fft_size_pow2)
+    cl::Buffer* d_cl_buffer_2;               // their spectra, and then their correlations
+    cl::Buffer* d_cl_buffer_peak_values;
+    cl::Buffer* d_cl_buffer_peak_indexes;
+    cl::Buffer* d_cl_buffer_grid_doppler_wipeoffs;  // num_bins x d_fft_size, kept while the grid does not change
+    std::shared_ptr<const Doppler_Grid> d_cl_uploaded_grid;
+    unsigned int d_cl_grid_bins;             // bins of the batched buffers
+    std::vector<float> d_peak_values;
+    std::vector<cl_uint> d_peak_indexes;
     cl::CommandQueue* d_cl_queue;
     clFFT_Plan d_cl_fft_plan;
     cl_int d_cl_fft_batch_size;
@@ -0,0 +1,126 @@
+/*!
+ * \file pcps_opencl_acquisition_kernels.h
+ * \brief OpenCL kernels of pcps_opencl_acquisition_cc, batched over all the
+ *  Doppler bins of the search grid.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The search of one dwell runs as one wipe-off kernel, one batched forward
+ * FFT, one product kernel, one batched inverse FFT and one peak search
+ * kernel, all over the num_bins consecutive zero-padded vectors of
+ * fft_size_pow2 samples, so the host only reads back one peak per bin.
+ * The source is compiled in, so the block no longer needs math_kernel.cl
+ * in the working directory.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PCPS_OPENCL_ACQUISITION_KERNELS_H_
+#define GNSS_SDR_PCPS_OPENCL_ACQUISITION_KERNELS_H_
+
+#include <string>
+
+//! Work-items of the peak search, the size of its local buffers
+#define PCPS_OPENCL_PEAK_GROUP_SIZE 256
+
+static const std::string pcps_opencl_acquisition_kernels = std::string(
+        "#define PEAK_GROUP_SIZE 256\n"
+        "\n"
+        "float2 complex_mul(float2 a, float2 b)\n"
+        "{\n"
+        "    return (float2)(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x);\n"
+        "}\n"
+        "\n"
+        "__kernel void conj_vector(__global const float2 *in, __global float2 *out)\n"
+        "{\n"
+        "    int i = get_global_id(0);\n"
+        "    out[i] = (float2)(in[i].x, -in[i].y);\n"
+        "}\n"
+        "\n"
+        // Carrier wipe-off of every Doppler bin, each one zero-padded up to fft_size_pow2
+        "__kernel void doppler_wipeoff_batch(__global const float2 *in, __global const float2 *wipeoffs,\n"
+        "        __global float2 *out, const uint fft_size, const uint fft_size_pow2)\n"
+        "{\n"
+        "    uint i = get_global_id(0);\n"
+        "    uint bin = i / fft_size_pow2;\n"
+        "    uint n = i - bin * fft_size_pow2;\n"
+        "    out[i] = (n < fft_size) ? complex_mul(in[n], wipeoffs[bin * fft_size + n]) : (float2)(0.0f, 0.0f);\n"
+        "}\n"
+        "\n"
+        // Product of the spectrum of every bin with the conjugated code spectrum
+        "__kernel void code_product_batch(__global float2 *spectra, __global const float2 *code,\n"
+        "        const uint fft_size_pow2)\n"
+        "{\n"
+        "    uint i = get_global_id(0);\n"
+        "    spectra[i] = complex_mul(spectra[i], code[i % fft_size_pow2]);\n"
+        "}\n"
+        "\n"
+        // One work-group per bin: maximum of |x|^2 over the first fft_size samples,
+        // and its first index, as volk_32f_index_max_16u
+        "__kernel void peak_search_batch(__global const float2 *correlations, __global float *peak_values,\n"
+        "        __global uint *peak_indexes, const uint fft_size, const uint fft_size_pow2)\n"
+        "{\n"
+        "    __local float values[PEAK_GROUP_SIZE];\n"
+        "    __local uint indexes[PEAK_GROUP_SIZE];\n"
+        "    uint bin = get_group_id(0);\n"
+        "    uint lid = get_local_id(0);\n"
+        "    uint lsize = get_local_size(0);\n"
+        "    __global const float2 *x = correlations + bin * fft_size_pow2;\n"
+        "    float best = -1.0f;\n"
+        "    uint best_index = 0;\n"
+        "    for (uint n = lid; n < fft_size; n += lsize)\n"
+        "        {\n"
+        "            float m = x[n].x * x[n].x + x[n].y * x[n].y;\n"
+        "            if (m > best)\n"
+        "                {\n"
+        "                    best = m;\n"
+        "                    best_index = n;\n"
+        "                }\n"
+        "        }\n"
+        "    values[lid] = best;\n"
+        "    indexes[lid] = best_index;\n"
+        "    barrier(CLK_LOCAL_MEM_FENCE);\n"
+        "    for (uint s = lsize / 2; s > 0; s >>= 1)\n"
+        "        {\n"
+        "            if (lid < s)\n"
+        "                {\n"
+        "                    float v = values[lid + s];\n"
+        "                    uint k = indexes[lid + s];\n"
+        "                    if (v > values[lid] || (v == values[lid] && k < indexes[lid]))\n"
+        "                        {\n"
+        "                            values[lid] = v;\n"
+        "                            indexes[lid] = k;\n"
+        "                        }\n"
+        "                }\n"
+        "            barrier(CLK_LOCAL_MEM_FENCE);\n"
+        "        }\n"
+        "    if (lid == 0)\n"
+        "        {\n"
+        "            peak_values[bin] = values[0];\n"
+        "            peak_indexes[bin] = indexes[0];\n"
+        "        }\n"
+        "}\n"
+);
+
+#endif /* GNSS_SDR_PCPS_OPENCL_ACQUISITION_KERNELS_H_ */
@@ -37,6 +37,9 @@
 #include <volk_gnsssdr/volk_gnsssdr.h>
 #include "control_message_factory.h"
 #include "GPS_L1_CA.h"
+#include "acquisition_assistance.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
 
 
 using google::LogMessage;
@@ -87,18 +90,24 @@ pcps_quicksync_acquisition_cc::pcps_quicksync_acquisition_cc(
     d_mag = 0;
     d_input_power = 0.0;
     d_num_doppler_bins = 0;
+    d_doppler_center = 0;
+    d_doppler_search_max = doppler_max;
     d_bit_transition_flag = bit_transition_flag;
     d_folding_factor = folding_factor;
 
     //fft size is reduced.
     d_fft_size = (d_samples_per_code) / d_folding_factor;
 
-    d_fft_codes = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-    d_magnitude = static_cast<float*>(volk_malloc(d_samples_per_code * d_folding_factor * sizeof(float), volk_get_alignment()));
-    d_magnitude_folded = static_cast<float*>(volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
+    d_fft_codes = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
+    d_magnitude = static_cast<float*>(gnss_sdr_volk_malloc(d_samples_per_code * d_folding_factor * sizeof(float), volk_get_alignment()));
+    d_magnitude_folded = static_cast<float*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
+
+    d_in_temp = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_samples_per_code * d_folding_factor * sizeof(gr_complex), volk_get_alignment()));
+    d_chunk = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
 
     d_possible_delay = new unsigned int[d_folding_factor];
     d_corr_output_f = new float[d_folding_factor];
+    d_corr_output_c = new gr_complex[d_folding_factor];
 
     /*Create the d_code signal , which would store the values of the code in its
     original form to perform later correlation in time domain*/
@@ -108,26 +117,23 @@ pcps_quicksync_acquisition_cc::pcps_quicksync_acquisition_cc(
     d_fft_if = new gr::fft::fft_complex(d_fft_size, true);
     // Inverse FFT
     d_ifft = new gr::fft::fft_complex(d_fft_size, false);
+    Gnss_Sdr_Memory_Accounting::add_fft(d_fft_size, 2);
 
     // For dumping samples into a file
     d_dump = dump;
     d_dump_filename = dump_filename;
 
     d_corr_acumulator = 0;
-    d_signal_folded = 0;
-    d_code_folded = new gr_complex[d_fft_size]();
     d_noise_floor_power = 0;
     d_doppler_resolution = 0;
     d_threshold = 0;
     d_doppler_step = 0;
-    d_grid_doppler_wipeoffs = 0;
     d_fft_if2 = 0;
     d_gnss_synchro = 0;
     d_code_phase = 0;
     d_doppler_freq = 0;
     d_test_statistics = 0;
     d_channel = 0;
-    //d_code_folded = 0;
 
     // DLOG(INFO) << "END CONSTRUCTOR";
 }
@@ -136,25 +142,18 @@ pcps_quicksync_acquisition_cc::pcps_quicksync_acquisition_cc(
 pcps_quicksync_acquisition_cc::~pcps_quicksync_acquisition_cc()
 {
     //DLOG(INFO) << "START DESTROYER";
-    if (d_num_doppler_bins > 0)
-        {
-            for (unsigned int i = 0; i < d_num_doppler_bins; i++)
-                {
-                    volk_free(d_grid_doppler_wipeoffs[i]);
-                }
-            delete[] d_grid_doppler_wipeoffs;
-        }
-
-    volk_free(d_fft_codes);
-    volk_free(d_magnitude);
-    volk_free(d_magnitude_folded);
+    gnss_sdr_volk_free(d_fft_codes);
+    gnss_sdr_volk_free(d_magnitude);
+    gnss_sdr_volk_free(d_magnitude_folded);
+    gnss_sdr_volk_free(d_in_temp);
+    gnss_sdr_volk_free(d_chunk);
 
     delete d_ifft;
     delete d_fft_if;
-    delete d_code;
-    delete d_possible_delay;
-    delete d_corr_output_f;
-    delete[] d_code_folded;
+    delete[] d_code;
+    delete[] d_possible_delay;
+    delete[] d_corr_output_f;
+    delete[] d_corr_output_c;
 
     if (d_dump)
         {
@@ -170,17 +169,15 @@ void pcps_quicksync_acquisition_cc::set_local_code(std::complex<float>* code)
     lation in time in the final steps of the acquisition stage*/
     memcpy(d_code, code, sizeof(gr_complex) * d_samples_per_code);
 
-    //d_code_folded = new gr_complex[d_fft_size]();
-    memcpy(d_fft_if->get_inbuf(), d_code_folded, sizeof(gr_complex) * (d_fft_size));
-
     /*perform folding of the code by the factorial factor parameter. Notice that
     folding of the code in the time stage would result in a downsampled spectrum
     in the frequency domain after applying the fftw operation*/
-    for (unsigned int i = 0; i < d_folding_factor; i++)
+    memcpy(d_fft_if->get_inbuf(), code, sizeof(gr_complex) * d_fft_size);
+    for (unsigned int i = 1; i < d_folding_factor; i++)
         {
-            std::transform ((code + i * d_fft_size), (code + ((i + 1) * d_fft_size)) ,
-                    d_fft_if->get_inbuf(), d_fft_if->get_inbuf(),
-                    std::plus<gr_complex>());
+            volk_32f_x2_add_32f(reinterpret_cast<float*>(d_fft_if->get_inbuf()),
+                    reinterpret_cast<float*>(d_fft_if->get_inbuf()),
+                    reinterpret_cast<const float*>(code + i * d_fft_size), 2 * d_fft_size);
         }
 
     d_fft_if->execute(); // We need the FFT of local code
@@ -208,27 +205,39 @@ void pcps_quicksync_acquisition_cc::init()
     
     if(d_doppler_step == 0) d_doppler_step = 250;
 
+    update_doppler_window(true);
+    // DLOG(INFO) << "end init";
+}
+
+
+void pcps_quicksync_acquisition_cc::update_doppler_window(bool force)
+{
+    int doppler_center = 0;
+    unsigned int doppler_search_max = d_doppler_max;
+    if (d_gnss_synchro != 0)
+        {
+            Acquisition_Assistance::doppler_window(*d_gnss_synchro, d_doppler_max, d_doppler_step,
+                    doppler_center, doppler_search_max, static_cast<double>(d_sample_counter) / static_cast<double>(d_fs_in));
+        }
+    if (!force && doppler_center == d_doppler_center && doppler_search_max == d_doppler_search_max)
+        {
+            return;
+        }
+    d_doppler_center = doppler_center;
+    d_doppler_search_max = doppler_search_max;
+
     // Count the number of bins
     d_num_doppler_bins = 0;
-    for (int doppler = static_cast<int>(-d_doppler_max);
-            doppler <= static_cast<int>(d_doppler_max);
+    for (int doppler = static_cast<int>(-d_doppler_search_max);
+            doppler <= static_cast<int>(d_doppler_search_max);
             doppler += d_doppler_step)
         {
             d_num_doppler_bins++;
         }
 
-    // Create the carrier Doppler wipeoff signals
-    d_grid_doppler_wipeoffs = new gr_complex*[d_num_doppler_bins];
-    for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
-        {
-            d_grid_doppler_wipeoffs[doppler_index] = static_cast<gr_complex*>(volk_malloc(d_samples_per_code * d_folding_factor * sizeof(gr_complex), volk_get_alignment()));
-            int doppler = -static_cast<int>(d_doppler_max) + d_doppler_step * doppler_index;
-            float phase_step_rad = GPS_TWO_PI * (d_freq + doppler) / static_cast<float>(d_fs_in);
-            float _phase[1];
-            _phase[0] = 0;
-            volk_gnsssdr_s32f_sincos_32fc(d_grid_doppler_wipeoffs[doppler_index], - phase_step_rad, _phase, d_samples_per_code * d_folding_factor);
-        }
-    // DLOG(INFO) << "end init";
+    // Get the carrier Doppler wipeoff signals, shared with the other channels
+    d_grid_doppler_wipeoffs = Doppler_Grid_Store::instance().get(d_fs_in, d_freq + d_doppler_center,
+            d_samples_per_code * d_folding_factor, d_doppler_search_max, d_doppler_step, d_num_doppler_bins);
 }
 
 
@@ -237,6 +246,7 @@ void pcps_quicksync_acquisition_cc::set_state(int state)
         d_state = state;
         if (d_state == 1)
             {
+                update_doppler_window(false);
                 d_gnss_synchro->Acq_delay_samples = 0.0;
                 d_gnss_synchro->Acq_doppler_hz = 0.0;
                 d_gnss_synchro->Acq_samplestamp_samples = 0;
@@ -258,6 +268,7 @@ int pcps_quicksync_acquisition_cc::general_work(int noutput_items,
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items __attribute__((unused)))
 {
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("pcps_quicksync_acquisition_cc::general_work", d_channel, d_gnss_synchro ? d_gnss_synchro->PRN : 0);
     /*
      * By J.Arribas, L.Esteve and M.Molina
      * Acquisition strategy (Kay Borre book + CFAR threshold):
@@ -278,6 +289,7 @@ int pcps_quicksync_acquisition_cc::general_work(int noutput_items,
             //DLOG(INFO) << "START CASE 0";
             if (d_active)
                 {
+                    update_doppler_window(false);
                     //restart acquisition variables
                     d_gnss_synchro->Acq_delay_samples = 0.0;
                     d_gnss_synchro->Acq_doppler_hz = 0.0;
@@ -309,22 +321,16 @@ int pcps_quicksync_acquisition_cc::general_work(int noutput_items,
             float magt = 0.0;
             const gr_complex *in = (const gr_complex *)input_items[0]; //Get the input samples pointer
 
-            gr_complex* in_temp = static_cast<gr_complex*>(volk_malloc(d_samples_per_code * d_folding_factor * sizeof(gr_complex), volk_get_alignment()));
-            gr_complex* in_temp_folded = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-
-            /*Create a signal to store a signal of size 1ms, to perform correlation
-            in time. No folding on this data is required*/
-            gr_complex* in_1code = static_cast<gr_complex*>(volk_malloc(d_samples_per_code * sizeof(gr_complex), volk_get_alignment()));
-
-            /*Stores the values of the correlation output between the local code
-            and the signal with doppler shift corrected */
-            gr_complex* corr_output = static_cast<gr_complex*>(volk_malloc(d_samples_per_code * sizeof(gr_complex), volk_get_alignment()));
-
-            /*Stores a copy of the folded version of the signal.This is used for
-            the FFT operations in future steps of excecution*/
-            // gr_complex in_folded[d_fft_size];
+            /*Since superlinear method is being used the folding factor in the
+            incoming raw data signal is of d_folding_factor^2*/
+            const unsigned int folded_chunks = d_folding_factor * d_folding_factor;
             float fft_normalization_factor = static_cast<float>(d_fft_size) * static_cast<float>(d_fft_size);
 
+            // Maximum of the folded correlation in this dwell
+            float dwell_mag = 0.0;
+            unsigned int dwell_delay_folded = 0;
+            unsigned int dwell_doppler_index = 0;
+
             d_input_power = 0.0;
             d_mag = 0.0;
             d_test_statistics = 0.0;
@@ -341,7 +347,8 @@ int pcps_quicksync_acquisition_cc::general_work(int noutput_items,
                     << " ,folding factor: " << d_folding_factor
                     << " ,sample stamp: " << d_sample_counter << ", threshold: "
                     << d_threshold << ", doppler_max: " << d_doppler_max
-                    << ", doppler_step: " << d_doppler_step << ", Signal Size: "
+                    << ", doppler_step: " << d_doppler_step
+                    << ", doppler search: " << d_doppler_center << " +/- " << d_doppler_search_max << ", Signal Size: "
                     << d_samples_per_code * d_folding_factor;
 
 
@@ -353,34 +360,24 @@ int pcps_quicksync_acquisition_cc::general_work(int noutput_items,
 
             for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
                 {
-                    /*Ensure that the signal is going to start with all samples
-                    at zero. This is done to avoid over acumulation when performing
-                    the folding process to be stored in d_fft_if->get_inbuf()*/
-                    d_signal_folded = new gr_complex[d_fft_size]();
-                    memcpy( d_fft_if->get_inbuf(), d_signal_folded, sizeof(gr_complex) * (d_fft_size));
-
                     /*Doppler search steps and then multiplication of the incoming
                     signal with the doppler wipeoffs to eliminate frequency offset
                      */
-                    doppler = -static_cast<int>(d_doppler_max) + d_doppler_step * doppler_index;
-
-                    /*Perform multiplication of the incoming signal with the
-                   complex exponential vector. This removes the frequency doppler
-                   shift offset*/
-                    volk_32fc_x2_multiply_32fc(in_temp, in,
-                            d_grid_doppler_wipeoffs[doppler_index],
-                            d_samples_per_code * d_folding_factor);
-
-                    /*Perform folding of the carrier wiped-off incoming signal. Since
-                   superlinear method is being used the folding factor in the
-                   incoming raw data signal is of d_folding_factor^2*/
-                    for ( int i = 0; i < static_cast<int>(d_folding_factor * d_folding_factor); i++)
+                    doppler = d_doppler_center - static_cast<int>(d_doppler_search_max) + d_doppler_step * doppler_index;
+                    const gr_complex* wipeoff = d_grid_doppler_wipeoffs->wipeoff(doppler_index);
+
+                    /*Wipe off the carrier and fold the incoming signal one chunk
+                    of d_fft_size samples at a time, so that each chunk is still in
+                    cache when it is added. The first chunk is written directly to
+                    the FFT input, which saves clearing it*/
+                    volk_32fc_x2_multiply_32fc(d_fft_if->get_inbuf(), in, wipeoff, d_fft_size);
+                    for (unsigned int i = 1; i < folded_chunks; i++)
                         {
-                            std::transform ((in_temp + i * d_fft_size),
-                                    (in_temp + ((i + 1) * d_fft_size)) ,
-                                    d_fft_if->get_inbuf(),
-                                    d_fft_if->get_inbuf(),
-                                    std::plus<gr_complex>());
+                            volk_32fc_x2_multiply_32fc(d_chunk, in + i * d_fft_size,
+                                    wipeoff + i * d_fft_size, d_fft_size);
+                            volk_32f_x2_add_32f(reinterpret_cast<float*>(d_fft_if->get_inbuf()),
+                                    reinterpret_cast<float*>(d_fft_if->get_inbuf()),
+                                    reinterpret_cast<float*>(d_chunk), 2 * d_fft_size);
                         }
 
                     /* 3- Perform the FFT-based convolution  (parallel time search)
@@ -403,72 +400,15 @@ int pcps_quicksync_acquisition_cc::general_work(int noutput_items,
 
                     /* Normalize the maximum value to correct the scale factor
                    introduced by FFTW*/
-                    //volk_32f_s32f_multiply_32f_a(d_magnitude_folded,d_magnitude_folded,
-                    // (1 / (fft_normalization_factor * fft_normalization_factor)), d_fft_size);
                     volk_32f_index_max_16u(&indext, d_magnitude_folded, d_fft_size);
 
                     magt = d_magnitude_folded[indext] / (fft_normalization_factor * fft_normalization_factor);
 
-                    delete[] d_signal_folded;
-
-                    // 4- record the maximum peak and the associated synchronization parameters
-                    if (d_mag < magt)
+                    if (dwell_mag < magt)
                         {
-                            d_mag = magt;
-
-                            /* In case that d_bit_transition_flag = true, we compare the potentially
-                            new maximum test statistics (d_mag/d_input_power) with the value in
-                            d_test_statistics. When the second dwell is being processed, the value
-                            of d_mag/d_input_power could be lower than d_test_statistics (i.e,
-                            the maximum test statistics in the previous dwell is greater than
-                            current d_mag/d_input_power). Note that d_test_statistics is not
-                            restarted between consecutive dwells in multidwell operation.*/
-                            if (d_test_statistics < (d_mag / d_input_power) || !d_bit_transition_flag)
-                                {
-                                    unsigned int detected_delay_samples_folded = 0;
-                                    detected_delay_samples_folded = (indext % d_samples_per_code);
-                                    gr_complex complex_acumulator[100];
-                                    //gr_complex complex_acumulator[d_folding_factor];
-
-                                    for (int i = 0; i < static_cast<int>(d_folding_factor); i++)
-                                        {
-                                            d_possible_delay[i] = detected_delay_samples_folded + (i) * d_fft_size;
-                                        }
-
-                                    for ( int i = 0; i < static_cast<int>(d_folding_factor); i++)
-                                        {
-
-                                            /*Copy a signal of 1 code length into suggested buffer.
-                                                                      The copied signal must have doppler effect corrected*/
-                                            memcpy(in_1code,&in_temp[d_possible_delay[i]],
-                                                    sizeof(gr_complex) * (d_samples_per_code));
-
-                                            /*Perform multiplication of the unmodified local
-                                                              generated code with the incoming signal with doppler
-                                                              effect corrected and accumulates its value. This
-                                                              is indeed correlation in time for an specific value
-                                                              of a shift*/
-                                            volk_32fc_x2_multiply_32fc(corr_output, in_1code, d_code, d_samples_per_code);
-
-                                            for(int j = 0; j < d_samples_per_code; j++)
-                                                {
-                                                    complex_acumulator[i] += (corr_output[j]);
-                                                }
-
-                                        }
-                                    /*Obtain maximun value of correlation given the possible delay selected */
-                                    volk_32fc_magnitude_squared_32f(d_corr_output_f, complex_acumulator, d_folding_factor);
-                                    volk_32f_index_max_16u(&indext, d_corr_output_f, d_folding_factor);
-
-                                    /*Now save the real code phase in the gnss_syncro block for use in other stages*/
-                                    d_gnss_synchro->Acq_delay_samples = static_cast<double>(d_possible_delay[indext]);
-                                    d_gnss_synchro->Acq_doppler_hz = static_cast<double>(doppler);
-                                    d_gnss_synchro->Acq_samplestamp_samples = d_sample_counter;
-
-                                    /* 5- Compute the test statistics and compare to the threshold d_test_statistics = 2 * d_fft_size * d_mag / d_input_power;*/
-                                    d_test_statistics = d_mag / d_input_power;
-                                    //delete complex_acumulator;
-                                }
+                            dwell_mag = magt;
+                            dwell_delay_folded = indext;
+                            dwell_doppler_index = doppler_index;
                         }
 
                     // Record results to file if required
@@ -489,6 +429,54 @@ int pcps_quicksync_acquisition_cc::general_work(int noutput_items,
                         }
                 }
 
+            // 4- record the maximum peak and the associated synchronization parameters
+            d_mag = dwell_mag;
+
+            /* In case that d_bit_transition_flag = true, we compare the potentially
+            new maximum test statistics (d_mag/d_input_power) with the value in
+            d_test_statistics. When the second dwell is being processed, the value
+            of d_mag/d_input_power could be lower than d_test_statistics (i.e,
+            the maximum test statistics in the previous dwell is greater than
+            current d_mag/d_input_power). Note that d_test_statistics is not
+            restarted between consecutive dwells in multidwell operation.*/
+            if (d_mag > 0.0 && (d_test_statistics < (d_mag / d_input_power) || !d_bit_transition_flag))
+                {
+                    /*Sparse recovery of the code phase: the folded peak is the sum of
+                    the correlations at d_folding_factor possible delays, one every
+                    d_fft_size samples. Only those delays are correlated in time, and
+                    only once per dwell, for the Doppler bin of the peak*/
+                    doppler = d_doppler_center - static_cast<int>(d_doppler_search_max) + d_doppler_step * dwell_doppler_index;
+                    for (unsigned int i = 0; i < d_folding_factor; i++)
+                        {
+                            d_possible_delay[i] = dwell_delay_folded + i * d_fft_size;
+                        }
+                    volk_32fc_x2_multiply_32fc(d_in_temp, in,
+                            d_grid_doppler_wipeoffs->wipeoff(dwell_doppler_index),
+                            d_possible_delay[d_folding_factor - 1] + d_samples_per_code);
+
+                    /*Perform multiplication of the unmodified local generated code
+                    with the incoming signal with doppler effect corrected and
+                    accumulates its value. This is indeed correlation in time for
+                    an specific value of a shift*/
+                    for (unsigned int i = 0; i < d_folding_factor; i++)
+                        {
+                            volk_32fc_x2_dot_prod_32fc(&d_corr_output_c[i], d_in_temp + d_possible_delay[i],
+                                    d_code, d_samples_per_code);
+                        }
+
+                    /*Obtain maximun value of correlation given the possible delay selected */
+                    volk_32fc_magnitude_squared_32f(d_corr_output_f, d_corr_output_c, d_folding_factor);
+                    volk_32f_index_max_16u(&indext, d_corr_output_f, d_folding_factor);
+
+                    /*Now save the real code phase in the gnss_syncro block for use in other stages*/
+                    d_gnss_synchro->Acq_delay_samples = static_cast<double>(d_possible_delay[indext]);
+                    d_gnss_synchro->Acq_doppler_hz = static_cast<double>(doppler);
+                    d_gnss_synchro->Acq_samplestamp_samples = d_sample_counter;
+
+                    /* 5- Compute the test statistics and compare to the threshold d_test_statistics = 2 * d_fft_size * d_mag / d_input_power;*/
+                    d_test_statistics = d_mag / d_input_power;
+                }
+
             if (!d_bit_transition_flag)
                 {
                     if (d_test_statistics > d_threshold)
@@ -517,10 +505,6 @@ int pcps_quicksync_acquisition_cc::general_work(int noutput_items,
                         }
                 }
 
-            volk_free(in_temp);
-            volk_free(in_temp_folded);
-            volk_free(in_1code);
-            volk_free(corr_output);
             consume_each(1);
 
             break;
@@ -52,6 +52,7 @@
 #define GNSS_SDR_PCPS_QUICKSYNC_ACQUISITION_CC_H_
 
 #include <fstream>
+#include <memory>
 #include <string>
 #include <algorithm>
 #include <functional>
@@ -60,6 +61,7 @@
 #include <gnuradio/gr_complex.h>
 #include <gnuradio/fft/fft.h>
 #include "gnss_synchro.h"
+#include "doppler_grid_store.h"
 
 class pcps_quicksync_acquisition_cc;
 
@@ -105,14 +107,17 @@ private:
     void calculate_magnitudes(gr_complex* fft_begin, int doppler_shift,
             int doppler_offset);
 
+    void update_doppler_window(bool force);
+
     gr_complex* d_code;
     unsigned int d_folding_factor; // also referred in the paper as 'p'
     float* d_corr_acumulator;
     unsigned int* d_possible_delay;
     float* d_corr_output_f;
     float* d_magnitude_folded;
-    gr_complex* d_signal_folded;
-    gr_complex* d_code_folded;
+    gr_complex* d_in_temp;             // input of the best Doppler bin, carrier wiped off
+    gr_complex* d_chunk;               // carrier wiped off chunk of d_fft_size samples
+    gr_complex* d_corr_output_c;       // correlation at each possible delay
     float d_noise_floor_power;
 
     long d_fs_in;
@@ -129,8 +134,10 @@ private:
     unsigned int d_well_count;
     unsigned int d_fft_size;
     unsigned long int d_sample_counter;
-    gr_complex** d_grid_doppler_wipeoffs;
+    std::shared_ptr<const Doppler_Grid> d_grid_doppler_wipeoffs;
     unsigned int d_num_doppler_bins;
+    int d_doppler_center;              // Centre of the Doppler search, from Acquisition_Assistance [Hz]
+    unsigned int d_doppler_search_max; // Half width of the Doppler search, at most d_doppler_max [Hz]
     gr_complex* d_fft_codes;
     gr::fft::fft_complex* d_fft_if;
     gr::fft::fft_complex* d_fft_if2;
@@ -0,0 +1,434 @@
+/*!
+ * \file pcps_remote_acquisition_cc.cc
+ * \brief This class implements a Parallel Code Phase Search Acquisition
+ * offloaded to a remote acquisition server.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "pcps_remote_acquisition_cc.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <gnuradio/io_signature.h>
+#include <glog/logging.h>
+#include <volk/volk.h>
+#include "fft_planner.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
+
+
+using google::LogMessage;
+
+pcps_remote_acquisition_cc_sptr pcps_make_remote_acquisition_cc(
+                                 unsigned int sampled_ms, unsigned int max_dwells,
+                                 unsigned int doppler_max, long freq, long fs_in,
+                                 int samples_per_ms, int samples_per_code,
+                                 const std::string & server_address, unsigned short server_port,
+                                 unsigned int timeout_ms, unsigned int reconnect_period_ms)
+{
+    return pcps_remote_acquisition_cc_sptr(
+            new pcps_remote_acquisition_cc(sampled_ms, max_dwells, doppler_max, freq, fs_in,
+                    samples_per_ms, samples_per_code, server_address, server_port,
+                    timeout_ms, reconnect_period_ms));
+}
+
+
+pcps_remote_acquisition_cc::pcps_remote_acquisition_cc(
+                         unsigned int sampled_ms, unsigned int max_dwells,
+                         unsigned int doppler_max, long freq, long fs_in,
+                         int samples_per_ms, int samples_per_code,
+                         const std::string & server_address, unsigned short server_port,
+                         unsigned int timeout_ms, unsigned int reconnect_period_ms) :
+    gr::block("pcps_remote_acquisition_cc",
+    gr::io_signature::make(1, 1, sizeof(gr_complex) * sampled_ms * samples_per_ms),
+    gr::io_signature::make(0, 0, sizeof(gr_complex) * sampled_ms * samples_per_ms)),
+    // A new gain for each dwell
+    d_requantizer(2, 0.0, 1.0)
+{
+    this->message_port_register_out(pmt::mp("events"));
+    d_sample_counter = 0;    // SAMPLE COUNTER
+    d_active = false;
+    d_state = 0;
+    d_freq = freq;
+    d_fs_in = fs_in;
+    d_samples_per_ms = samples_per_ms;
+    d_samples_per_code = samples_per_code;
+    d_sampled_ms = sampled_ms;
+    d_max_dwells = max_dwells;
+    d_well_count = 0;
+    d_doppler_max = doppler_max;
+    d_doppler_step = 0;
+    d_fft_size = d_sampled_ms * d_samples_per_ms;
+    d_num_doppler_bins = 0;
+    d_mag = 0;
+    d_input_power = 0.0;
+    d_test_statistics = 0.0;
+    d_threshold = 0.0;
+    d_channel = 0;
+    d_server_address = server_address;
+    d_server_port = server_port;
+    d_timeout_ms = timeout_ms;
+    d_reconnect_period_ms = reconnect_period_ms;
+    d_request_id = 0;
+    d_remote_searches = 0;
+    d_local_searches = 0;
+    d_dwell_samplestamp = 0;
+
+    d_fft_if = Fft_Planner::instance().acquire(d_fft_size, true);
+    d_ifft = Fft_Planner::instance().acquire(d_fft_size, false);
+    d_fft_codes = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
+    d_magnitude = static_cast<float*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
+    d_dwell = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
+    d_quantized.resize(d_fft_size);
+    d_gnss_synchro = 0;
+}
+
+
+pcps_remote_acquisition_cc::~pcps_remote_acquisition_cc()
+{
+    cancel_request();
+    if (d_remote_searches + d_local_searches > 0)
+        {
+            LOG(INFO) << "Acquisition channel " << d_channel << ": " << d_remote_searches
+                      << " dwells searched by the server, " << d_local_searches << " locally";
+        }
+    gnss_sdr_volk_free(d_fft_codes);
+    gnss_sdr_volk_free(d_magnitude);
+    gnss_sdr_volk_free(d_dwell);
+}
+
+
+void pcps_remote_acquisition_cc::init()
+{
+    d_gnss_synchro->Flag_valid_acquisition = false;
+    d_gnss_synchro->Flag_valid_symbol_output = false;
+    d_gnss_synchro->Flag_valid_pseudorange = false;
+    d_gnss_synchro->Flag_valid_word = false;
+    d_gnss_synchro->Flag_preamble = false;
+
+    d_gnss_synchro->Acq_delay_samples = 0.0;
+    d_gnss_synchro->Acq_doppler_hz = 0.0;
+    d_gnss_synchro->Acq_samplestamp_samples = 0;
+    d_mag = 0.0;
+    d_input_power = 0.0;
+
+    d_num_doppler_bins = ceil( static_cast<double>(static_cast<int>(d_doppler_max) - static_cast<int>(-d_doppler_max)) / static_cast<double>(d_doppler_step));
+
+    // Get the carrier Doppler wipeoff signals, shared with the other channels
+    d_grid_doppler_wipeoffs = Doppler_Grid_Store::instance().get(d_fs_in, d_freq,
+            d_fft_size, d_doppler_max, d_doppler_step, d_num_doppler_bins);
+
+    if (!d_client)
+        {
+            d_client = Remote_Acquisition_Client_Store::instance().get(d_server_address, d_server_port, d_reconnect_period_ms);
+        }
+}
+
+
+void pcps_remote_acquisition_cc::set_local_code(std::complex<float> * code)
+{
+    memcpy(d_fft_if->get_inbuf(), code, sizeof(gr_complex) * d_fft_size);
+    d_fft_if->execute(); // We need the FFT of local code
+    volk_32fc_conjugate_32fc(d_fft_codes, d_fft_if->get_outbuf(), d_fft_size);
+}
+
+
+void pcps_remote_acquisition_cc::cancel_request()
+{
+    if (d_client && d_request_id != 0)
+        {
+            d_client->cancel(d_request_id);
+        }
+    d_request_id = 0;
+}
+
+
+void pcps_remote_acquisition_cc::set_state(int state)
+{
+    d_state = state;
+    if (d_state == 1)
+        {
+            cancel_request();
+            d_gnss_synchro->Acq_delay_samples = 0.0;
+            d_gnss_synchro->Acq_doppler_hz = 0.0;
+            d_gnss_synchro->Acq_samplestamp_samples = 0;
+            d_well_count = 0;
+            d_mag = 0.0;
+            d_input_power = 0.0;
+            d_test_statistics = 0.0;
+        }
+    else if (d_state == 0)
+        {
+            cancel_request();
+        }
+    else
+        {
+            LOG(ERROR) << "State can only be set to 0 or 1";
+        }
+}
+
+
+bool pcps_remote_acquisition_cc::submit_dwell()
+{
+    if (!d_client || !d_client->connected())
+        {
+            return false;
+        }
+    Remote_Acquisition_Request request;
+    request.system = d_gnss_synchro->System;
+    request.signal = std::string(d_gnss_synchro->Signal, 2);
+    request.prns.push_back(d_gnss_synchro->PRN);
+    request.fs_in = d_fs_in;
+    request.if_hz = static_cast<double>(d_freq);
+    request.doppler_min = -static_cast<int>(d_doppler_max);
+    request.doppler_max = request.doppler_min + static_cast<int>(d_doppler_step * (d_num_doppler_bins - 1));
+    request.doppler_step = d_doppler_step;
+    request.threshold = d_threshold;
+    request.samples = d_fft_size;
+    d_requantizer.process(d_dwell, d_quantized.data(), d_fft_size);
+    remote_acquisition_pack(d_quantized.data(), d_fft_size, request.packed);
+
+    d_request_id = d_client->submit(request);
+    d_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(d_timeout_ms);
+    return d_request_id != 0;
+}
+
+
+bool pcps_remote_acquisition_cc::apply_reply(const Remote_Acquisition_Reply & reply)
+{
+    for (unsigned int i = 0; i < reply.peaks.size(); i++)
+        {
+            if (reply.peaks[i].prn != d_gnss_synchro->PRN) continue;
+            d_test_statistics = reply.peaks[i].test_statistics;
+            d_mag = d_test_statistics * d_input_power;
+            double code_phase = std::fmod(reply.peaks[i].code_phase_samples, static_cast<double>(d_samples_per_code));
+            if (code_phase < 0.0) code_phase += d_samples_per_code;
+            d_gnss_synchro->Acq_delay_samples = code_phase;
+            d_gnss_synchro->Acq_doppler_hz = reply.peaks[i].doppler_hz;
+            d_gnss_synchro->Acq_samplestamp_samples = d_dwell_samplestamp;
+            return true;
+        }
+    return false;
+}
+
+
+void pcps_remote_acquisition_cc::local_search()
+{
+    float fft_normalization_factor = static_cast<float>(d_fft_size) * static_cast<float>(d_fft_size);
+    d_mag = 0.0;
+
+    // 2- Doppler frequency search loop
+    for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+        {
+            volk_32fc_x2_multiply_32fc(d_fft_if->get_inbuf(), d_dwell,
+                    d_grid_doppler_wipeoffs->wipeoff(doppler_index), d_fft_size);
+            d_fft_if->execute();
+            volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(),
+                    d_fft_if->get_outbuf(), d_fft_codes, d_fft_size);
+            d_ifft->execute();
+
+            // 3- Record the maximum peak and the associated synchronization parameters
+            volk_32fc_magnitude_squared_32f(d_magnitude, d_ifft->get_outbuf(), d_fft_size);
+            unsigned int indext = std::max_element(d_magnitude, d_magnitude + d_fft_size) - d_magnitude;
+            // Normalize the maximum value to correct the scale factor introduced by FFTW
+            float magt = d_magnitude[indext] / (fft_normalization_factor * fft_normalization_factor);
+            if (d_mag < magt)
+                {
+                    d_mag = magt;
+                    d_gnss_synchro->Acq_delay_samples = static_cast<double>(indext % d_samples_per_code);
+                    d_gnss_synchro->Acq_doppler_hz = static_cast<double>(d_grid_doppler_wipeoffs->doppler(doppler_index));
+                    d_gnss_synchro->Acq_samplestamp_samples = d_dwell_samplestamp;
+                }
+        }
+    // 4- Compute the test statistics
+    d_test_statistics = d_mag / d_input_power;
+    d_local_searches++;
+}
+
+
+int pcps_remote_acquisition_cc::decide()
+{
+    if (d_test_statistics > d_threshold)
+        {
+            return 2; // Positive acquisition
+        }
+    if (d_well_count == d_max_dwells)
+        {
+            return 3; // Negative acquisition
+        }
+    return 1;
+}
+
+
+int pcps_remote_acquisition_cc::general_work(int noutput_items,
+        gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items __attribute__((unused)))
+{
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("pcps_remote_acquisition_cc::general_work", d_channel, d_gnss_synchro ? d_gnss_synchro->PRN : 0);
+    int acquisition_message = -1; //0=STOP_CHANNEL 1=ACQ_SUCCEES 2=ACQ_FAIL
+
+    switch (d_state)
+    {
+    case 0:
+        {
+            if (d_active)
+                {
+                    //restart acquisition variables
+                    d_gnss_synchro->Acq_delay_samples = 0.0;
+                    d_gnss_synchro->Acq_doppler_hz = 0.0;
+                    d_gnss_synchro->Acq_samplestamp_samples = 0;
+                    d_well_count = 0;
+                    d_mag = 0.0;
+                    d_input_power = 0.0;
+                    d_test_statistics = 0.0;
+
+                    d_state = 1;
+                }
+
+            d_sample_counter += d_fft_size * ninput_items[0]; // sample counter
+            consume_each(ninput_items[0]);
+
+            break;
+        }
+
+    case 1:
+        {
+            const gr_complex *in = (const gr_complex *)input_items[0]; //Get the input samples pointer
+            memcpy(d_dwell, in, sizeof(gr_complex) * d_fft_size);
+            d_sample_counter += d_fft_size; // sample counter
+            d_dwell_samplestamp = d_sample_counter;
+            d_well_count++;
+            d_mag = 0.0;
+            d_test_statistics = 0.0;
+
+            DLOG(INFO) << "Channel: " << d_channel
+                    << " , doing acquisition of satellite: " << d_gnss_synchro->System << " " << d_gnss_synchro->PRN
+                    << " ,sample stamp: " << d_sample_counter << ", threshold: "
+                    << d_threshold << ", doppler_max: " << d_doppler_max
+                    << ", doppler_step: " << d_doppler_step;
+
+            // 1- Compute the input signal power estimation
+            volk_32fc_magnitude_squared_32f(d_magnitude, d_dwell, d_fft_size);
+            volk_32f_accumulator_s32f(&d_input_power, d_magnitude, d_fft_size);
+            d_input_power /= static_cast<float>(d_fft_size);
+
+            if (submit_dwell())
+                {
+                    // The input goes on while the server searches the dwell
+                    d_state = 4;
+                }
+            else
+                {
+                    local_search();
+                    d_state = decide();
+                }
+            consume_each(1);
+            break;
+        }
+
+    case 2:
+        {
+            // 5.1- Declare positive acquisition using a message port
+            DLOG(INFO) << "positive acquisition";
+            DLOG(INFO) << "satellite " << d_gnss_synchro->System << " " << d_gnss_synchro->PRN;
+            DLOG(INFO) << "sample_stamp " << d_sample_counter;
+            DLOG(INFO) << "test statistics value " << d_test_statistics;
+            DLOG(INFO) << "test statistics threshold " << d_threshold;
+            DLOG(INFO) << "code phase " << d_gnss_synchro->Acq_delay_samples;
+            DLOG(INFO) << "doppler " << d_gnss_synchro->Acq_doppler_hz;
+            DLOG(INFO) << "magnitude " << d_mag;
+            DLOG(INFO) << "input signal power " << d_input_power;
+
+            d_active = false;
+            d_state = 0;
+            d_sample_counter += d_fft_size * ninput_items[0]; // sample counter
+            consume_each(ninput_items[0]);
+
+            acquisition_message = 1;
+            this->message_port_pub(pmt::mp("events"), pmt::from_long(acquisition_message));
+
+            break;
+        }
+
+    case 3:
+        {
+            // 5.2- Declare negative acquisition using a message port
+            DLOG(INFO) << "negative acquisition";
+            DLOG(INFO) << "satellite " << d_gnss_synchro->System << " " << d_gnss_synchro->PRN;
+            DLOG(INFO) << "sample_stamp " << d_sample_counter;
+            DLOG(INFO) << "test statistics value " << d_test_statistics;
+            DLOG(INFO) << "test statistics threshold " << d_threshold;
+            DLOG(INFO) << "code phase " << d_gnss_synchro->Acq_delay_samples;
+            DLOG(INFO) << "doppler " << d_gnss_synchro->Acq_doppler_hz;
+            DLOG(INFO) << "magnitude " << d_mag;
+            DLOG(INFO) << "input signal power " << d_input_power;
+
+            d_active = false;
+            d_state = 0;
+            d_sample_counter += d_fft_size * ninput_items[0]; // sample counter
+            consume_each(ninput_items[0]);
+
+            acquisition_message = 2;
+            this->message_port_pub(pmt::mp("events"), pmt::from_long(acquisition_message));
+
+            break;
+        }
+
+    case 4:
+        {
+            // Waiting for the server
+            Remote_Acquisition_Reply reply;
+            Remote_Acquisition_Status status = d_client->poll(d_request_id, reply);
+            if (status == REMOTE_ACQUISITION_PENDING && std::chrono::steady_clock::now() < d_deadline)
+                {
+                    d_sample_counter += d_fft_size * ninput_items[0]; // sample counter
+                    consume_each(ninput_items[0]);
+                    break;
+                }
+            if (status == REMOTE_ACQUISITION_DONE && apply_reply(reply))
+                {
+                    d_remote_searches++;
+                }
+            else
+                {
+                    LOG(WARNING) << "Acquisition channel " << d_channel << ": "
+                                 << (status == REMOTE_ACQUISITION_PENDING ? "no answer from" : "search failed at")
+                                 << " the acquisition server, searching the dwell locally";
+                    cancel_request();
+                    local_search();
+                }
+            d_request_id = 0;
+            d_state = decide();
+            // The next dwell, if any, starts at the next input
+            d_sample_counter += d_fft_size * ninput_items[0]; // sample counter
+            consume_each(ninput_items[0]);
+            break;
+        }
+    }
+
+    return noutput_items;
+}
@@ -0,0 +1,273 @@
+/*!
+ * \file pcps_remote_acquisition_cc.h
+ * \brief This class implements a Parallel Code Phase Search Acquisition
+ * offloaded to a remote acquisition server.
+ *
+ *  Acquisition strategy (Kay Borre book + CFAR threshold).
+ *  <ol>
+ *  <li> Compute the input signal power estimation
+ *  <li> Send the dwell, requantized to two bits, to the acquisition server,
+ *       or search it locally if the server does not answer in time
+ *  <li> Record the maximum peak and the associated synchronization parameters
+ *  <li> Compute the test statistics and compare to the threshold
+ *  <li> Declare positive or negative acquisition using a message port
+ *  </ol>
+ *
+ * Kay Borre book: K.Borre, D.M.Akos, N.Bertelsen, P.Rinder, and S.H.Jensen,
+ * "A Software-Defined GPS and Galileo Receiver. A Single-Frequency
+ * Approach", Birkha user, 2007. pp 81-84
+ *
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PCPS_REMOTE_ACQUISITION_CC_H_
+#define GNSS_SDR_PCPS_REMOTE_ACQUISITION_CC_H_
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <gnuradio/block.h>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/fft/fft.h>
+#include "gnss_synchro.h"
+#include "doppler_grid_store.h"
+#include "remote_acquisition_client.h"
+#include "sample_requantizer.h"
+
+class pcps_remote_acquisition_cc;
+
+typedef boost::shared_ptr<pcps_remote_acquisition_cc> pcps_remote_acquisition_cc_sptr;
+
+pcps_remote_acquisition_cc_sptr
+pcps_make_remote_acquisition_cc(unsigned int sampled_ms, unsigned int max_dwells,
+                                unsigned int doppler_max, long freq, long fs_in,
+                                int samples_per_ms, int samples_per_code,
+                                const std::string & server_address, unsigned short server_port,
+                                unsigned int timeout_ms, unsigned int reconnect_period_ms);
+
+/*!
+ * \brief This class implements a Parallel Code Phase Search Acquisition
+ * whose searches run on a remote acquisition server.
+ *
+ * Each dwell is requantized to two bits per component and sent through the
+ * Remote_Acquisition_Client shared by all the channels. Meanwhile the block
+ * keeps consuming its input, and the peak that comes back is applied with
+ * the sample stamp of the dwell, as the tracking expects. If the server is
+ * not connected, or does not answer within timeout_ms, the dwell is searched
+ * here instead, as pcps_acquisition_cc does with circular correlation and
+ * the input power estimation.
+ *
+ * The server correlates the requantized samples and adds the code periods
+ * of a dwell non-coherently, so with coherent_integration_time_ms = 1 its
+ * test statistics is that of the local search, about 0.5 dB lower for the
+ * same signal because of the two bits.
+ */
+class pcps_remote_acquisition_cc: public gr::block
+{
+private:
+    friend pcps_remote_acquisition_cc_sptr
+    pcps_make_remote_acquisition_cc(unsigned int sampled_ms, unsigned int max_dwells,
+            unsigned int doppler_max, long freq, long fs_in,
+            int samples_per_ms, int samples_per_code,
+            const std::string & server_address, unsigned short server_port,
+            unsigned int timeout_ms, unsigned int reconnect_period_ms);
+
+    pcps_remote_acquisition_cc(unsigned int sampled_ms, unsigned int max_dwells,
+            unsigned int doppler_max, long freq, long fs_in,
+            int samples_per_ms, int samples_per_code,
+            const std::string & server_address, unsigned short server_port,
+            unsigned int timeout_ms, unsigned int reconnect_period_ms);
+
+    // Sends the dwell to the server. Returns false if it is not connected
+    bool submit_dwell();
+
+    // Searches the dwell here
+    void local_search();
+
+    // Applies the reply of the server. Returns false if it has no peak for this satellite
+    bool apply_reply(const Remote_Acquisition_Reply & reply);
+
+    // Next state after a dwell: 1 (next dwell), 2 (positive) or 3 (negative)
+    int decide();
+
+    void cancel_request();
+
+    long d_fs_in;
+    long d_freq;
+    int d_samples_per_ms;
+    int d_samples_per_code;
+    float d_threshold;
+    unsigned int d_doppler_max;
+    unsigned int d_doppler_step;
+    unsigned int d_sampled_ms;
+    unsigned int d_max_dwells;
+    unsigned int d_well_count;
+    unsigned int d_fft_size;
+    unsigned long int d_sample_counter;
+    unsigned int d_num_doppler_bins;
+    std::shared_ptr<const Doppler_Grid> d_grid_doppler_wipeoffs;
+    std::shared_ptr<gr::fft::fft_complex> d_fft_if;
+    std::shared_ptr<gr::fft::fft_complex> d_ifft;
+    gr_complex* d_fft_codes;
+    float* d_magnitude;
+
+    // Dwell being searched by the server, kept for the local search
+    gr_complex* d_dwell;
+    unsigned long int d_dwell_samplestamp;
+    Sample_Requantizer d_requantizer;
+    std::vector<std::complex<int8_t> > d_quantized;
+
+    std::string d_server_address;
+    unsigned short d_server_port;
+    unsigned int d_timeout_ms;
+    unsigned int d_reconnect_period_ms;
+    std::shared_ptr<Remote_Acquisition_Client> d_client;
+    unsigned int d_request_id;
+    std::chrono::steady_clock::time_point d_deadline;
+    unsigned long long d_remote_searches;
+    unsigned long long d_local_searches;
+
+    Gnss_Synchro *d_gnss_synchro;
+    float d_mag;
+    float d_input_power;
+    float d_test_statistics;
+    bool d_active;
+    int d_state;
+    unsigned int d_channel;
+
+public:
+    /*!
+     * \brief Default destructor.
+     */
+     ~pcps_remote_acquisition_cc();
+
+     /*!
+      * \brief Set acquisition/tracking common Gnss_Synchro object pointer
+      * to exchange synchronization data between acquisition and tracking blocks.
+      * \param p_gnss_synchro Satellite information shared by the processing blocks.
+      */
+     void set_gnss_synchro(Gnss_Synchro* p_gnss_synchro)
+     {
+         d_gnss_synchro = p_gnss_synchro;
+     }
+
+     /*!
+      * \brief Returns the maximum peak of grid search.
+      */
+     unsigned int mag()
+     {
+         return d_mag;
+     }
+
+     /*!
+      * \brief Initializes acquisition algorithm, taking the connection to
+      * the server and the Doppler grid of the local search.
+      */
+     void init();
+
+     /*!
+      * \brief Sets local code for PCPS acquisition algorithm. The server
+      * generates its own from the satellite.
+      * \param code - Pointer to the PRN code.
+      */
+     void set_local_code(std::complex<float> * code);
+
+     /*!
+      * \brief Starts acquisition algorithm, turning from standby mode to
+      * active mode
+      * \param active - bool that activates/deactivates the block.
+      */
+     void set_active(bool active)
+     {
+         d_active = active;
+     }
+
+     /*!
+      * \brief If set to 1, ensures that acquisition starts at the
+      * first available sample.
+      * \param state - int=1 forces start of acquisition
+      */
+     void set_state(int state);
+
+     /*!
+      * \brief Set acquisition channel unique ID
+      * \param channel - receiver channel.
+      */
+     void set_channel(unsigned int channel)
+     {
+         d_channel = channel;
+     }
+
+     /*!
+      * \brief Set statistics threshold of PCPS algorithm.
+      * \param threshold - Threshold for signal detection (check \ref Navitec2012,
+      * Algorithm 1, for a definition of this threshold).
+      */
+     void set_threshold(float threshold)
+     {
+         d_threshold = threshold;
+     }
+
+     /*!
+      * \brief Set maximum Doppler grid search
+      * \param doppler_max - Maximum Doppler shift considered in the grid search [Hz].
+      */
+     void set_doppler_max(unsigned int doppler_max)
+     {
+         d_doppler_max = doppler_max;
+     }
+
+     /*!
+      * \brief Set Doppler steps for the grid search
+      * \param doppler_step - Frequency bin of the search grid [Hz].
+      */
+     void set_doppler_step(unsigned int doppler_step)
+     {
+         d_doppler_step = doppler_step;
+     }
+
+     //! Dwells searched by the server and here
+     unsigned long long remote_searches() const
+     {
+         return d_remote_searches;
+     }
+
+     unsigned long long local_searches() const
+     {
+         return d_local_searches;
+     }
+
+     /*!
+      * \brief Parallel Code Phase Search Acquisition signal processing.
+      */
+     int general_work(int noutput_items, gr_vector_int &ninput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+};
+
+#endif /* GNSS_SDR_PCPS_REMOTE_ACQUISITION_CC_H_*/
@@ -0,0 +1,466 @@
+/*!
+ * \file pcps_segmented_acquisition_cc.cc
+ * \brief This class implements a Parallel Code Phase Search Acquisition
+ *  for long codes, with partial correlations over code segments combined
+ *  non-coherently
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "pcps_segmented_acquisition_cc.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <boost/filesystem.hpp>
+#include <gnuradio/io_signature.h>
+#include <glog/logging.h>
+#include <volk/volk.h>
+#include "acquisition_assistance.h"
+#include "fft_planner.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
+
+
+using google::LogMessage;
+
+pcps_segmented_acquisition_cc_sptr pcps_make_segmented_acquisition_cc(
+                                 unsigned int max_dwells,
+                                 unsigned int doppler_max, long freq, long fs_in,
+                                 int samples_per_code, unsigned int num_segments,
+                                 bool use_CFAR_algorithm_flag, bool dump,
+                                 std::string dump_filename)
+{
+    return pcps_segmented_acquisition_cc_sptr(
+            new pcps_segmented_acquisition_cc(max_dwells, doppler_max, freq, fs_in,
+                    samples_per_code, num_segments, use_CFAR_algorithm_flag, dump, dump_filename));
+}
+
+
+pcps_segmented_acquisition_cc::pcps_segmented_acquisition_cc(
+                         unsigned int max_dwells,
+                         unsigned int doppler_max, long freq, long fs_in,
+                         int samples_per_code, unsigned int num_segments,
+                         bool use_CFAR_algorithm_flag, bool dump,
+                         std::string dump_filename) :
+    gr::block("pcps_segmented_acquisition_cc",
+    gr::io_signature::make(1, 1, sizeof(gr_complex)),
+    gr::io_signature::make(0, 0, sizeof(gr_complex)) )
+{
+    this->message_port_register_out(pmt::mp("events"));
+
+    d_sample_counter = 0;    // SAMPLE COUNTER
+    d_active = false;
+    d_state = 0;
+    d_freq = freq;
+    d_fs_in = fs_in;
+    d_samples_per_code = samples_per_code;
+    d_max_dwells = max_dwells;
+    d_well_count = 0;
+    d_doppler_max = doppler_max;
+    d_doppler_center = 0;
+    d_doppler_search_max = doppler_max;
+    d_mag = 0;
+    d_input_power = 0.0;
+    d_num_doppler_bins = 0;
+    d_use_CFAR_algorithm_flag = use_CFAR_algorithm_flag;
+    d_threshold = 0.0;
+    d_doppler_step = 0;
+    d_test_statistics = 0.0;
+    d_channel = 0;
+
+    // All the segments have the same length, so their number must divide the code length
+    d_num_segments = std::max(1u, std::min(num_segments, d_samples_per_code));
+    while (d_samples_per_code % d_num_segments != 0)
+        {
+            d_num_segments--;
+        }
+    if (d_num_segments != num_segments)
+        {
+            LOG(WARNING) << num_segments << " segments do not divide the " << d_samples_per_code
+                         << " samples of the code, using " << d_num_segments;
+        }
+    d_segment_length = d_samples_per_code / d_num_segments;
+    d_fft_size = 2 * d_segment_length;
+    d_fft_codes.resize(d_num_segments);
+
+    // The input is the sample stream, read in place one code period at a time
+    set_relative_rate(1.0 / static_cast<double>(d_samples_per_code));
+
+    d_magnitude = static_cast<float*>(gnss_sdr_volk_malloc(d_segment_length * sizeof(float), volk_get_alignment()));
+    d_statistics = static_cast<float*>(gnss_sdr_volk_malloc(d_samples_per_code * sizeof(float), volk_get_alignment()));
+
+    // Direct FFT
+    d_fft_if = new gr::fft::fft_complex(d_fft_size, true, Fft_Planner::instance().threads(d_fft_size));
+
+    // Inverse FFT
+    d_ifft = new gr::fft::fft_complex(d_fft_size, false, Fft_Planner::instance().threads(d_fft_size));
+    Gnss_Sdr_Memory_Accounting::add_fft(d_fft_size, 2);
+
+    // For dumping samples into a file
+    d_dump = dump;
+    d_dump_filename = dump_filename;
+
+    d_gnss_synchro = 0;
+}
+
+
+pcps_segmented_acquisition_cc::~pcps_segmented_acquisition_cc()
+{
+    gnss_sdr_volk_free(d_magnitude);
+    gnss_sdr_volk_free(d_statistics);
+
+    delete d_ifft;
+    delete d_fft_if;
+
+    if (d_dump)
+        {
+            d_dump_file.close();
+        }
+}
+
+
+void pcps_segmented_acquisition_cc::set_local_code(const std::complex<float> * code)
+{
+    for (unsigned int segment = 0; segment < d_num_segments; segment++)
+        {
+            // [ 0 0 0 ... 0 c_k ], so that the second half of the inverse FFT holds the partial correlations
+            std::fill_n(d_fft_if->get_inbuf(), d_segment_length, gr_complex(0.0, 0.0));
+            memcpy(d_fft_if->get_inbuf() + d_segment_length, code + segment * d_segment_length,
+                    sizeof(gr_complex) * d_segment_length);
+            d_fft_if->execute();
+
+            gr_complex* fft_code = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
+            volk_32fc_conjugate_32fc(fft_code, d_fft_if->get_outbuf(), d_fft_size);
+            d_fft_codes[segment] = std::shared_ptr<const gr_complex>(fft_code,
+                    [](const gr_complex* p) { gnss_sdr_volk_free(const_cast<gr_complex*>(p)); });
+        }
+}
+
+
+void pcps_segmented_acquisition_cc::init()
+{
+    d_gnss_synchro->Flag_valid_acquisition = false;
+    d_gnss_synchro->Flag_valid_symbol_output = false;
+    d_gnss_synchro->Flag_valid_pseudorange = false;
+    d_gnss_synchro->Flag_valid_word = false;
+    d_gnss_synchro->Flag_preamble = false;
+
+    d_gnss_synchro->Acq_delay_samples = 0.0;
+    d_gnss_synchro->Acq_doppler_hz = 0.0;
+    d_gnss_synchro->Acq_samplestamp_samples = 0;
+    d_mag = 0.0;
+    d_input_power = 0.0;
+
+    if (d_doppler_step == 0)
+        {
+            LOG(WARNING) << "Doppler step not set. Using 500 Hz";
+            d_doppler_step = 500;
+        }
+
+    update_doppler_window(true);
+
+    DLOG(INFO) << "Channel " << d_channel << ": " << d_num_segments << " segments of "
+               << d_segment_length << " samples, FFTs of " << d_fft_size << " points";
+}
+
+
+void pcps_segmented_acquisition_cc::update_doppler_window(bool force)
+{
+    int doppler_center = 0;
+    unsigned int doppler_search_max = d_doppler_max;
+    if (d_gnss_synchro != 0)
+        {
+            Acquisition_Assistance::doppler_window(*d_gnss_synchro, d_doppler_max, d_doppler_step,
+                    doppler_center, doppler_search_max, static_cast<double>(d_sample_counter) / static_cast<double>(d_fs_in));
+        }
+    if (!force && doppler_center == d_doppler_center && doppler_search_max == d_doppler_search_max)
+        {
+            return;
+        }
+    d_doppler_center = doppler_center;
+    d_doppler_search_max = doppler_search_max;
+
+    d_num_doppler_bins = ceil( static_cast<double>(static_cast<int>(d_doppler_search_max) - static_cast<int>(-d_doppler_search_max)) / static_cast<double>(d_doppler_step));
+
+    // The wipe-offs span one window of two segments. Each window restarts the
+    // carrier phase, which the non-coherent combination does not see
+    d_grid_doppler_wipeoffs = Doppler_Grid_Store::instance().get(d_fs_in, d_freq + d_doppler_center,
+            d_fft_size, d_doppler_search_max, d_doppler_step, d_num_doppler_bins);
+}
+
+
+void pcps_segmented_acquisition_cc::set_state(int state)
+{
+    d_state = state;
+    if (d_state == 1)
+        {
+            d_gnss_synchro->Acq_delay_samples = 0.0;
+            d_gnss_synchro->Acq_doppler_hz = 0.0;
+            d_gnss_synchro->Acq_samplestamp_samples = 0;
+            d_well_count = 0;
+            d_mag = 0.0;
+            d_input_power = 0.0;
+            d_test_statistics = 0.0;
+        }
+    else if (d_state == 0)
+        {}
+    else
+        {
+            LOG(ERROR) << "State can only be set to 0 or 1";
+        }
+}
+
+
+int pcps_segmented_acquisition_cc::acquisition_core(const gr_complex* in)
+{
+    unsigned int N = d_samples_per_code;
+    unsigned int L = d_segment_length;
+    unsigned int S = d_num_segments;
+
+    // |IFFT| is 2L times the partial correlation, which is normalized by its
+    // L samples, and the statistic is the mean over the S segments
+    float scale = 1.0 / (static_cast<float>(d_fft_size) * static_cast<float>(L));
+    float normalization = scale * scale / static_cast<float>(S);
+
+    d_input_power = 0.0;
+    d_mag = 0.0;
+    d_well_count++;
+
+    DLOG(INFO) << "Channel: " << d_channel
+            << " , doing acquisition of satellite: " << d_gnss_synchro->System << " " << d_gnss_synchro->PRN
+            << " ,sample stamp: " << d_sample_counter << ", threshold: "
+            << d_threshold << ", doppler search: " << d_doppler_center << " +/- " << d_doppler_search_max
+            << ", doppler_step: " << d_doppler_step << ", segments: " << S;
+
+    if (d_use_CFAR_algorithm_flag == true)
+        {
+            // 1- (optional) Compute the input signal power estimation
+            for (unsigned int segment = 0; segment < S; segment++)
+                {
+                    float power = 0.0;
+                    volk_32fc_magnitude_squared_32f(d_magnitude, in + segment * L, L);
+                    volk_32f_accumulator_s32f(&power, d_magnitude, L);
+                    d_input_power += power;
+                }
+            d_input_power /= static_cast<float>(N);
+        }
+
+    // 2- Doppler frequency search loop
+    for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+        {
+            const gr_complex* wipeoff = d_grid_doppler_wipeoffs->wipeoff(doppler_index);
+            std::fill_n(d_statistics, N, 0.0f);
+
+            for (unsigned int window = 0; window < S; window++)
+                {
+                    // 3- Carrier wipe-off and FFT of the 2L samples from segment j, circular over the period
+                    unsigned int start = window * L;
+                    unsigned int first = std::min(d_fft_size, N - start);
+                    volk_32fc_x2_multiply_32fc(d_fft_if->get_inbuf(), in + start, wipeoff, first);
+                    if (first < d_fft_size)
+                        {
+                            volk_32fc_x2_multiply_32fc(d_fft_if->get_inbuf() + first, in, wipeoff + first, d_fft_size - first);
+                        }
+                    d_fft_if->execute();
+
+                    // 4- The code segment k meets this window at the code phases [qL, qL + L), q = j - k
+                    for (unsigned int segment = 0; segment < S; segment++)
+                        {
+                            unsigned int q = (window + S - segment) % S;
+                            volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(), d_fft_if->get_outbuf(),
+                                    d_fft_codes[segment].get(), d_fft_size);
+                            d_ifft->execute();
+                            volk_32fc_magnitude_squared_32f(d_magnitude, d_ifft->get_outbuf() + L, L);
+                            volk_32f_x2_add_32f(d_statistics + q * L, d_statistics + q * L, d_magnitude, L);
+                        }
+                }
+
+            // Search maximum
+            unsigned int indext = std::max_element(d_statistics, d_statistics + N) - d_statistics;
+            float magt = d_statistics[indext] * normalization;
+
+            // 5- record the maximum peak and the associated synchronization parameters
+            if (d_mag < magt)
+                {
+                    d_mag = magt;
+
+                    if (d_use_CFAR_algorithm_flag == false)
+                        {
+                            // Search grid noise floor approximation for this doppler line
+                            volk_32f_accumulator_s32f(&d_input_power, d_statistics, N);
+                            d_input_power = (d_input_power * normalization - d_mag) / (N - 1);
+                        }
+
+                    if (d_test_statistics < (d_mag / d_input_power))
+                        {
+                            d_gnss_synchro->Acq_delay_samples = static_cast<double>(indext);
+                            d_gnss_synchro->Acq_doppler_hz = static_cast<double>(d_doppler_center + d_grid_doppler_wipeoffs->doppler(doppler_index));
+                            d_gnss_synchro->Acq_samplestamp_samples = d_sample_counter;
+
+                            // 6- Compute the test statistics and compare to the threshold
+                            d_test_statistics = d_mag / d_input_power;
+                        }
+                }
+
+            // Record results to file if required
+            if (d_dump)
+                {
+                    std::stringstream filename;
+                    std::streamsize n = sizeof(float) * N; // statistics of the code phases
+                    filename.str("");
+
+                    boost::filesystem::path p = d_dump_filename;
+                    filename << p.parent_path().string()
+                             << boost::filesystem::path::preferred_separator
+                             << p.stem().string()
+                             << "_" << d_gnss_synchro->System
+                             <<"_" << d_gnss_synchro->Signal << "_sat_"
+                             << d_gnss_synchro->PRN << "_doppler_"
+                             << d_doppler_center + d_grid_doppler_wipeoffs->doppler(doppler_index)
+                             << p.extension().string();
+
+                    DLOG(INFO) << "Writing ACQ out to " << filename.str();
+
+                    d_dump_file.open(filename.str().c_str(), std::ios::out | std::ios::binary);
+                    d_dump_file.write((char*)d_statistics, n);
+                    d_dump_file.close();
+                }
+        }
+
+    if (d_test_statistics > d_threshold)
+        {
+            return 2; // Positive acquisition
+        }
+    else if (d_well_count == d_max_dwells)
+        {
+            return 3; // Negative acquisition
+        }
+    return 1;
+}
+
+
+int pcps_segmented_acquisition_cc::general_work(int noutput_items,
+        gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items __attribute__((unused)))
+{
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("pcps_segmented_acquisition_cc::general_work", d_channel, d_gnss_synchro ? d_gnss_synchro->PRN : 0);
+    int acquisition_message = -1; //0=STOP_CHANNEL 1=ACQ_SUCCEES 2=ACQ_FAIL
+
+    switch (d_state)
+    {
+    case 0:
+        {
+            if (d_active)
+                {
+                    //restart acquisition variables
+                    d_gnss_synchro->Acq_delay_samples = 0.0;
+                    d_gnss_synchro->Acq_doppler_hz = 0.0;
+                    d_gnss_synchro->Acq_samplestamp_samples = 0;
+                    d_well_count = 0;
+                    d_mag = 0.0;
+                    d_input_power = 0.0;
+                    d_test_statistics = 0.0;
+                    update_doppler_window(false);
+
+                    d_state = 1;
+                }
+
+            d_sample_counter += ninput_items[0]; // sample counter
+            consume_each(ninput_items[0]);
+
+            break;
+        }
+
+    case 1:
+        {
+            if (ninput_items[0] < static_cast<int>(d_samples_per_code))
+                {
+                    // wait for a whole code period
+                    return 0;
+                }
+            const gr_complex *in = (const gr_complex *)input_items[0]; //Get the input samples pointer
+            d_sample_counter += d_samples_per_code; // sample counter
+            d_state = acquisition_core(in);
+
+            consume_each(d_samples_per_code);
+
+            DLOG(INFO) << "Done. Consumed " << d_samples_per_code << " samples.";
+
+            break;
+        }
+
+    case 2:
+        {
+            // 7.1- Declare positive acquisition using a message port
+            DLOG(INFO) << "positive acquisition";
+            DLOG(INFO) << "satellite " << d_gnss_synchro->System << " " << d_gnss_synchro->PRN;
+            DLOG(INFO) << "sample_stamp " << d_sample_counter;
+            DLOG(INFO) << "test statistics value " << d_test_statistics;
+            DLOG(INFO) << "test statistics threshold " << d_threshold;
+            DLOG(INFO) << "code phase " << d_gnss_synchro->Acq_delay_samples;
+            DLOG(INFO) << "doppler " << d_gnss_synchro->Acq_doppler_hz;
+            DLOG(INFO) << "magnitude " << d_mag;
+            DLOG(INFO) << "input signal power " << d_input_power;
+
+            d_active = false;
+            d_state = 0;
+            d_sample_counter += ninput_items[0]; // sample counter
+            consume_each(ninput_items[0]);
+
+            acquisition_message = 1;
+            this->message_port_pub(pmt::mp("events"), pmt::from_long(acquisition_message));
+
+            break;
+        }
+
+    case 3:
+        {
+            // 7.2- Declare negative acquisition using a message port
+            DLOG(INFO) << "negative acquisition";
+            DLOG(INFO) << "satellite " << d_gnss_synchro->System << " " << d_gnss_synchro->PRN;
+            DLOG(INFO) << "sample_stamp " << d_sample_counter;
+            DLOG(INFO) << "test statistics value " << d_test_statistics;
+            DLOG(INFO) << "test statistics threshold " << d_threshold;
+            DLOG(INFO) << "code phase " << d_gnss_synchro->Acq_delay_samples;
+            DLOG(INFO) << "doppler " << d_gnss_synchro->Acq_doppler_hz;
+            DLOG(INFO) << "magnitude " << d_mag;
+            DLOG(INFO) << "input signal power " << d_input_power;
+
+            d_active = false;
+            d_state = 0;
+
+            d_sample_counter += ninput_items[0]; // sample counter
+            consume_each(ninput_items[0]);
+            acquisition_message = 2;
+            this->message_port_pub(pmt::mp("events"), pmt::from_long(acquisition_message));
+
+            break;
+        }
+    }
+
+    return noutput_items;
+}
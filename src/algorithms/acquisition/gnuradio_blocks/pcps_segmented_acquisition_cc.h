@@ -0,0 +1,269 @@
+/*!
+ * \file pcps_segmented_acquisition_cc.h
+ * \brief This class implements a Parallel Code Phase Search Acquisition
+ *  for long codes, with partial correlations over code segments combined
+ *  non-coherently
+ *
+ *  Acquisition strategy:
+ *  <ol>
+ *  <li> Compute the input signal power estimation
+ *  <li> Doppler serial search loop
+ *  <li> Forward FFT of each window of two segments of the input
+ *  <li> Partial correlation of each window with each code segment, and
+ *       non-coherent accumulation over the segments (parallel time search)
+ *  <li> Record the maximum peak and the associated synchronization parameters
+ *  <li> Compute the test statistics and compare to the threshold
+ *  <li> Declare positive or negative acquisition using a message port
+ *  </ol>
+ *
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PCPS_SEGMENTED_ACQUISITION_CC_H_
+#define GNSS_SDR_PCPS_SEGMENTED_ACQUISITION_CC_H_
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <gnuradio/block.h>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/fft/fft.h>
+#include "doppler_grid_store.h"
+#include "gnss_synchro.h"
+
+class pcps_segmented_acquisition_cc;
+
+typedef boost::shared_ptr<pcps_segmented_acquisition_cc> pcps_segmented_acquisition_cc_sptr;
+
+pcps_segmented_acquisition_cc_sptr
+pcps_make_segmented_acquisition_cc(unsigned int max_dwells,
+                         unsigned int doppler_max, long freq, long fs_in,
+                         int samples_per_code, unsigned int num_segments,
+                         bool use_CFAR_algorithm_flag, bool dump,
+                         std::string dump_filename);
+
+/*!
+ * \brief This class implements a Parallel Code Phase Search Acquisition
+ * whose FFTs span two code segments instead of the whole code.
+ *
+ * The code period of N samples is split into S segments of L = N / S samples.
+ * The correlation of segment k of the code at the code phase q * L + p
+ * (0 <= p < L) only reads the window of 2L input samples starting at segment
+ * (k + q) mod S, so it is one product and one inverse FFT of 2L points with
+ * the spectrum of that window. The S partial correlations of each code phase
+ * are combined non-coherently, which also lets the Doppler step grow to
+ * about 2 / (3 T_segment). Each dwell costs S forward and S * S inverse FFTs
+ * of 2L points per Doppler bin, all of them small enough to stay in cache:
+ * for the 20 ms GPS L2 CM code at 5 Msps and S = 5, 40000 points instead
+ * of 100000.
+ *
+ * The test statistic is the mean of the normalized partial correlation
+ * powers, so a signal reaches the same value as in pcps_acquisition_cc,
+ * while the noise cells average to 1/L instead of 1/N.
+ */
+class pcps_segmented_acquisition_cc: public gr::block
+{
+private:
+    friend pcps_segmented_acquisition_cc_sptr
+    pcps_make_segmented_acquisition_cc(unsigned int max_dwells,
+            unsigned int doppler_max, long freq, long fs_in,
+            int samples_per_code, unsigned int num_segments,
+            bool use_CFAR_algorithm_flag, bool dump,
+            std::string dump_filename);
+
+    pcps_segmented_acquisition_cc(unsigned int max_dwells,
+            unsigned int doppler_max, long freq, long fs_in,
+            int samples_per_code, unsigned int num_segments,
+            bool use_CFAR_algorithm_flag, bool dump,
+            std::string dump_filename);
+
+    // Sets the Doppler grid around the window of Acquisition_Assistance, if it changed
+    void update_doppler_window(bool force);
+
+    // Searches one code period, and returns the next state
+    int acquisition_core(const gr_complex* in);
+
+    long d_fs_in;
+    long d_freq;
+    unsigned int d_samples_per_code;   // N
+    unsigned int d_num_segments;       // S
+    unsigned int d_segment_length;     // L = N / S
+    unsigned int d_fft_size;           // 2L
+    float d_threshold;
+    unsigned int d_doppler_max;
+    unsigned int d_doppler_step;
+    int d_doppler_center;              // Centre of the Doppler search, from Acquisition_Assistance [Hz]
+    unsigned int d_doppler_search_max; // Half width of the Doppler search, at most d_doppler_max [Hz]
+    unsigned int d_max_dwells;
+    unsigned int d_well_count;
+    unsigned long int d_sample_counter;
+    unsigned int d_num_doppler_bins;
+    std::shared_ptr<const Doppler_Grid> d_grid_doppler_wipeoffs;
+    std::vector<std::shared_ptr<const gr_complex> > d_fft_codes; // conjugated spectrum of [0 ... 0 c_k] for each segment
+    gr::fft::fft_complex* d_fft_if;
+    gr::fft::fft_complex* d_ifft;
+    Gnss_Synchro *d_gnss_synchro;
+    float d_mag;
+    float* d_magnitude;                // L
+    float* d_statistics;               // N, accumulated over the segments
+    float d_input_power;
+    float d_test_statistics;
+    bool d_use_CFAR_algorithm_flag;
+    std::ofstream d_dump_file;
+    bool d_active;
+    int d_state;
+    bool d_dump;
+    unsigned int d_channel;
+    std::string d_dump_filename;
+
+public:
+    /*!
+     * \brief Default destructor.
+     */
+     ~pcps_segmented_acquisition_cc();
+
+     /*!
+      * \brief Set acquisition/tracking common Gnss_Synchro object pointer
+      * to exchange synchronization data between acquisition and tracking blocks.
+      * \param p_gnss_synchro Satellite information shared by the processing blocks.
+      */
+     void set_gnss_synchro(Gnss_Synchro* p_gnss_synchro)
+     {
+         d_gnss_synchro = p_gnss_synchro;
+     }
+
+     /*!
+      * \brief Returns the maximum peak of grid search.
+      */
+     unsigned int mag()
+     {
+         return d_mag;
+     }
+
+     /*!
+      * \brief Initializes acquisition algorithm.
+      */
+     void init();
+
+     /*!
+      * \brief Sets local code for PCPS acquisition algorithm.
+      * \param code - Pointer to the N samples of the PRN code.
+      */
+     void set_local_code(const std::complex<float> * code);
+
+     /*!
+      * \brief Sets the already conjugated FFT of one code segment c_k,
+      * zero-padded in front ([0 ... 0 c_k], fft_size() points), typically
+      * obtained from the Fft_Code_Cache shared by all the channels.
+      */
+     void set_local_code_fft(unsigned int segment, std::shared_ptr<const gr_complex> fft_code)
+     {
+         d_fft_codes[segment] = fft_code;
+     }
+
+     //! Number of segments S, a divisor of the code length
+     unsigned int num_segments()
+     {
+         return d_num_segments;
+     }
+
+     //! Length L of each segment [samples]
+     unsigned int segment_length()
+     {
+         return d_segment_length;
+     }
+
+     //! Length of the FFTs, 2L [samples]
+     unsigned int fft_size()
+     {
+         return d_fft_size;
+     }
+
+     /*!
+      * \brief Starts acquisition algorithm, turning from standby mode to
+      * active mode
+      * \param active - bool that activates/deactivates the block.
+      */
+     void set_active(bool active)
+     {
+         d_active = active;
+     }
+
+     /*!
+      * \brief If set to 1, ensures that acquisition starts at the
+      * first available sample.
+      * \param state - int=1 forces start of acquisition
+      */
+     void set_state(int state);
+
+     /*!
+      * \brief Set acquisition channel unique ID
+      * \param channel - receiver channel.
+      */
+     void set_channel(unsigned int channel)
+     {
+         d_channel = channel;
+     }
+
+     /*!
+      * \brief Set statistics threshold of PCPS algorithm.
+      * \param threshold - Threshold for signal detection (check \ref Navitec2012,
+      * Algorithm 1, for a definition of this threshold).
+      */
+     void set_threshold(float threshold)
+     {
+         d_threshold = threshold;
+     }
+
+     /*!
+      * \brief Set maximum Doppler grid search
+      * \param doppler_max - Maximum Doppler shift considered in the grid search [Hz].
+      */
+     void set_doppler_max(unsigned int doppler_max)
+     {
+         d_doppler_max = doppler_max;
+     }
+
+     /*!
+      * \brief Set Doppler steps for the grid search
+      * \param doppler_step - Frequency bin of the search grid [Hz].
+      */
+     void set_doppler_step(unsigned int doppler_step)
+     {
+         d_doppler_step = doppler_step;
+     }
+
+     /*!
+      * \brief Parallel Code Phase Search Acquisition signal processing.
+      */
+     int general_work(int noutput_items, gr_vector_int &ninput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+};
+
+#endif /* GNSS_SDR_PCPS_SEGMENTED_ACQUISITION_CC_H_*/
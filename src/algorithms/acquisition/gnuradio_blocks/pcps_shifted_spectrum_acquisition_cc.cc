@@ -0,0 +1,525 @@
+/*!
+ * \file pcps_shifted_spectrum_acquisition_cc.cc
+ * \brief This class implements a Parallel Code Phase Search Acquisition
+ *  in which the Doppler search is done by shifting the input spectrum
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "pcps_shifted_spectrum_acquisition_cc.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <boost/filesystem.hpp>
+#include <gnuradio/io_signature.h>
+#include <glog/logging.h>
+#include <volk/volk.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+#include "GPS_L1_CA.h" //GPS_TWO_PI
+
+
+using google::LogMessage;
+
+pcps_shifted_spectrum_acquisition_cc_sptr pcps_make_shifted_spectrum_acquisition_cc(
+                                 unsigned int sampled_ms, unsigned int max_dwells,
+                                 unsigned int doppler_max, long freq, long fs_in,
+                                 int samples_per_ms, int samples_per_code,
+                                 bool bit_transition_flag, bool use_CFAR_algorithm_flag,
+                                 bool dump,
+                                 std::string dump_filename)
+{
+    return pcps_shifted_spectrum_acquisition_cc_sptr(
+            new pcps_shifted_spectrum_acquisition_cc(sampled_ms, max_dwells, doppler_max, freq, fs_in, samples_per_ms,
+                    samples_per_code, bit_transition_flag, use_CFAR_algorithm_flag, dump, dump_filename));
+}
+
+
+pcps_shifted_spectrum_acquisition_cc::pcps_shifted_spectrum_acquisition_cc(
+                         unsigned int sampled_ms, unsigned int max_dwells,
+                         unsigned int doppler_max, long freq, long fs_in,
+                         int samples_per_ms, int samples_per_code,
+                         bool bit_transition_flag, bool use_CFAR_algorithm_flag,
+                         bool dump,
+                         std::string dump_filename) :
+    gr::block("pcps_shifted_spectrum_acquisition_cc",
+    gr::io_signature::make(1, 1, sizeof(gr_complex) * sampled_ms * samples_per_ms * ( bit_transition_flag ? 2 : 1 )),
+    gr::io_signature::make(0, 0, sizeof(gr_complex) * sampled_ms * samples_per_ms * ( bit_transition_flag ? 2 : 1 )) )
+{
+    this->message_port_register_out(pmt::mp("events"));
+
+    d_sample_counter = 0;    // SAMPLE COUNTER
+    d_active = false;
+    d_state = 0;
+    d_freq = freq;
+    d_fs_in = fs_in;
+    d_samples_per_ms = samples_per_ms;
+    d_samples_per_code = samples_per_code;
+    d_sampled_ms = sampled_ms;
+    d_max_dwells = max_dwells;
+    d_well_count = 0;
+    d_doppler_max = doppler_max;
+    d_fft_size = d_sampled_ms * d_samples_per_ms;
+    d_mag = 0;
+    d_input_power = 0.0;
+    d_num_doppler_bins = 0;
+    d_num_residuals = 0;
+    d_bit_transition_flag = bit_transition_flag;
+    d_use_CFAR_algorithm_flag = use_CFAR_algorithm_flag;
+    d_threshold = 0.0;
+    d_doppler_step = 0;
+    d_test_statistics = 0.0;
+    d_channel = 0;
+    d_share_input_spectrum = false;
+    d_rf_channel = 0;
+
+    // Linear correlation with a zero-padded code, as in pcps_acquisition_cc
+    if( d_bit_transition_flag )
+        {
+            d_fft_size *= 2;
+            d_max_dwells = 1; //Activation of d_bit_transition_flag invalidates the value of d_max_dwells
+        }
+
+    d_magnitude = static_cast<float*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
+
+    // Direct FFT
+    d_fft_if = new gr::fft::fft_complex(d_fft_size, true);
+
+    // Inverse FFT
+    d_ifft = new gr::fft::fft_complex(d_fft_size, false);
+    Gnss_Sdr_Memory_Accounting::add_fft(d_fft_size, 2);
+
+    // For dumping samples into a file
+    d_dump = dump;
+    d_dump_filename = dump_filename;
+
+    d_gnss_synchro = 0;
+}
+
+
+pcps_shifted_spectrum_acquisition_cc::~pcps_shifted_spectrum_acquisition_cc()
+{
+    free_residual_buffers();
+
+    gnss_sdr_volk_free(d_magnitude);
+
+    delete d_ifft;
+    delete d_fft_if;
+
+    if (d_dump)
+        {
+            d_dump_file.close();
+        }
+}
+
+
+void pcps_shifted_spectrum_acquisition_cc::free_residual_buffers()
+{
+    for (unsigned int i = 0; i < d_residual_rotators.size(); i++)
+        {
+            gnss_sdr_volk_free(d_residual_rotators[i]);
+            gnss_sdr_volk_free(d_residual_spectra[i]);
+        }
+    d_residual_rotators.clear();
+    d_residual_spectra.clear();
+    d_spectra.clear();
+}
+
+
+void pcps_shifted_spectrum_acquisition_cc::set_local_code(std::complex<float> * code)
+{
+    // [ 0 0 0 ... 0 c_0 c_1 ... c_L] if d_bit_transition_flag is set
+    if( d_bit_transition_flag )
+        {
+            int offset = d_fft_size/2;
+            std::fill_n( d_fft_if->get_inbuf(), offset, gr_complex( 0.0, 0.0 ) );
+            memcpy(d_fft_if->get_inbuf() + offset, code, sizeof(gr_complex) * offset);
+        }
+    else
+        {
+            memcpy(d_fft_if->get_inbuf(), code, sizeof(gr_complex) * d_fft_size);
+        }
+
+    d_fft_if->execute(); // We need the FFT of local code
+
+    gr_complex* fft_codes = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
+    volk_32fc_conjugate_32fc(fft_codes, d_fft_if->get_outbuf(), d_fft_size);
+    d_fft_codes = std::shared_ptr<const gr_complex>(fft_codes, [](const gr_complex* p) { gnss_sdr_volk_free(const_cast<gr_complex*>(p)); });
+}
+
+
+void pcps_shifted_spectrum_acquisition_cc::init()
+{
+    d_gnss_synchro->Flag_valid_acquisition = false;
+    d_gnss_synchro->Flag_valid_symbol_output = false;
+    d_gnss_synchro->Flag_valid_pseudorange = false;
+    d_gnss_synchro->Flag_valid_word = false;
+    d_gnss_synchro->Flag_preamble = false;
+
+    d_gnss_synchro->Acq_delay_samples = 0.0;
+    d_gnss_synchro->Acq_doppler_hz = 0.0;
+    d_gnss_synchro->Acq_samplestamp_samples = 0;
+    d_mag = 0.0;
+    d_input_power = 0.0;
+
+    if (d_doppler_step == 0)
+        {
+            LOG(WARNING) << "Doppler step not set. Using 500 Hz";
+            d_doppler_step = 500;
+        }
+
+    d_num_doppler_bins = ceil( static_cast<double>(static_cast<int>(d_doppler_max) - static_cast<int>(-d_doppler_max)) / static_cast<double>(d_doppler_step));
+
+    // Spacing of the FFT bins and number of sub-bin offsets needed to honor the Doppler step
+    double bin_hz = static_cast<double>(d_fs_in) / static_cast<double>(d_fft_size);
+    d_num_residuals = std::max(1, static_cast<int>(std::ceil(bin_hz / static_cast<double>(d_doppler_step))));
+
+    // Map each Doppler bin to a (circular shift, residual) pair
+    d_bin_shift.resize(d_num_doppler_bins);
+    d_bin_residual.resize(d_num_doppler_bins);
+    d_bin_doppler.resize(d_num_doppler_bins);
+    for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+        {
+            int doppler = -static_cast<int>(d_doppler_max) + d_doppler_step * doppler_index;
+            long long sub_bins = llround(static_cast<double>(d_freq + doppler) / bin_hz * static_cast<double>(d_num_residuals));
+            long long shift = sub_bins / static_cast<long long>(d_num_residuals);
+            long long residual = sub_bins - shift * static_cast<long long>(d_num_residuals);
+            if (residual < 0)
+                {
+                    residual += d_num_residuals;
+                    shift--;
+                }
+            shift %= static_cast<long long>(d_fft_size);
+            if (shift < 0) shift += d_fft_size;
+            d_bin_shift[doppler_index] = static_cast<unsigned int>(shift);
+            d_bin_residual[doppler_index] = static_cast<unsigned int>(residual);
+            d_bin_doppler[doppler_index] = static_cast<float>(static_cast<double>(sub_bins) * bin_hz / static_cast<double>(d_num_residuals) - static_cast<double>(d_freq));
+        }
+
+    // Input rotators for the residual offsets and storage for their spectra
+    free_residual_buffers();
+    for (unsigned int residual = 0; residual < d_num_residuals; residual++)
+        {
+            gr_complex* rotator = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
+            float phase_step_rad = static_cast<float>(GPS_TWO_PI) * static_cast<float>(residual) / static_cast<float>(d_num_residuals * d_fft_size);
+            float _phase[1];
+            _phase[0] = 0;
+            volk_gnsssdr_s32f_sincos_32fc(rotator, - phase_step_rad, _phase, d_fft_size);
+            d_residual_rotators.push_back(rotator);
+            d_residual_spectra.push_back(static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment())));
+            d_spectra.push_back(d_residual_spectra.back());
+        }
+
+    DLOG(INFO) << "Channel " << d_channel << ": " << d_num_doppler_bins << " Doppler bins searched with "
+               << d_num_residuals << " forward FFTs per dwell";
+}
+
+
+void pcps_shifted_spectrum_acquisition_cc::set_state(int state)
+{
+    d_state = state;
+    if (d_state == 1)
+        {
+            d_gnss_synchro->Acq_delay_samples = 0.0;
+            d_gnss_synchro->Acq_doppler_hz = 0.0;
+            d_gnss_synchro->Acq_samplestamp_samples = 0;
+            d_well_count = 0;
+            d_mag = 0.0;
+            d_input_power = 0.0;
+            d_test_statistics = 0.0;
+        }
+    else if (d_state == 0)
+        {}
+    else
+        {
+            LOG(ERROR) << "State can only be set to 0 or 1";
+        }
+}
+
+
+int pcps_shifted_spectrum_acquisition_cc::general_work(int noutput_items,
+        gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items __attribute__((unused)))
+{
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("pcps_shifted_spectrum_acquisition_cc::general_work", d_channel, d_gnss_synchro ? d_gnss_synchro->PRN : 0);
+    int acquisition_message = -1; //0=STOP_CHANNEL 1=ACQ_SUCCEES 2=ACQ_FAIL
+
+    switch (d_state)
+    {
+    case 0:
+        {
+            if (d_active)
+                {
+                    //restart acquisition variables
+                    d_gnss_synchro->Acq_delay_samples = 0.0;
+                    d_gnss_synchro->Acq_doppler_hz = 0.0;
+                    d_gnss_synchro->Acq_samplestamp_samples = 0;
+                    d_well_count = 0;
+                    d_mag = 0.0;
+                    d_input_power = 0.0;
+                    d_test_statistics = 0.0;
+
+                    d_state = 1;
+                }
+
+            d_sample_counter += d_fft_size * ninput_items[0]; // sample counter
+            consume_each(ninput_items[0]);
+
+            break;
+        }
+
+    case 1:
+        {
+            // initialize acquisition algorithm
+#if VOLK_GT_122
+            uint16_t indext = 0;
+#else
+            unsigned int indext = 0;
+#endif
+            float magt = 0.0;
+            const gr_complex *in = (const gr_complex *)input_items[0]; //Get the input samples pointer
+
+            int effective_fft_size = ( d_bit_transition_flag ? d_fft_size/2 : d_fft_size );
+
+            float fft_normalization_factor = static_cast<float>(d_fft_size) * static_cast<float>(d_fft_size);
+
+            d_input_power = 0.0;
+            d_mag = 0.0;
+
+            d_sample_counter += d_fft_size; // sample counter
+
+            d_well_count++;
+
+            DLOG(INFO) << "Channel: " << d_channel
+                    << " , doing acquisition of satellite: " << d_gnss_synchro->System << " " << d_gnss_synchro->PRN
+                    << " ,sample stamp: " << d_sample_counter << ", threshold: "
+                    << d_threshold << ", doppler_max: " << d_doppler_max
+                    << ", doppler_step: " << d_doppler_step;
+
+            if (d_use_CFAR_algorithm_flag == true)
+                {
+                    // 1- (optional) Compute the input signal power estimation
+                    volk_32fc_magnitude_squared_32f(d_magnitude, in, d_fft_size);
+                    volk_32f_accumulator_s32f(&d_input_power, d_magnitude, d_fft_size);
+                    d_input_power /= static_cast<float>(d_fft_size);
+                }
+
+            // 2- One forward FFT per residual frequency offset
+            std::shared_ptr<const Input_Spectra> shared_spectra;
+            if (d_share_input_spectrum)
+                {
+                    // Computed only by the first channel reaching this input window
+                    shared_spectra = Input_Spectrum_Store::instance().get(d_rf_channel, d_fs_in, d_fft_size,
+                            nitems_read(0), in, d_residual_rotators, d_fft_if);
+                    for (unsigned int residual = 0; residual < d_num_residuals; residual++)
+                        {
+                            d_spectra[residual] = shared_spectra->spectrum(residual);
+                        }
+                }
+            else
+                {
+                    for (unsigned int residual = 0; residual < d_num_residuals; residual++)
+                        {
+                            if (residual == 0)
+                                {
+                                    memcpy(d_fft_if->get_inbuf(), in, sizeof(gr_complex) * d_fft_size);
+                                }
+                            else
+                                {
+                                    volk_32fc_x2_multiply_32fc(d_fft_if->get_inbuf(), in,
+                                            d_residual_rotators[residual], d_fft_size);
+                                }
+                            d_fft_if->execute();
+                            memcpy(d_residual_spectra[residual], d_fft_if->get_outbuf(), sizeof(gr_complex) * d_fft_size);
+                            d_spectra[residual] = d_residual_spectra[residual];
+                        }
+                }
+
+            // 3- Doppler frequency search loop
+            for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+                {
+                    // Shifting the input spectrum by s bins is equivalent to a carrier wipe-off of s * fs / fft_size Hz
+                    unsigned int shift = d_bin_shift[doppler_index];
+                    const gr_complex* spectrum = d_spectra[d_bin_residual[doppler_index]];
+
+                    // 4- Multiply the shifted input spectrum with the local FFT'd code reference
+                    volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(), spectrum + shift,
+                            d_fft_codes.get(), d_fft_size - shift);
+                    if (shift > 0)
+                        {
+                            volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf() + d_fft_size - shift, spectrum,
+                                    d_fft_codes.get() + d_fft_size - shift, shift);
+                        }
+
+                    // compute the inverse FFT
+                    d_ifft->execute();
+
+                    // Search maximum
+                    size_t offset = ( d_bit_transition_flag ? effective_fft_size : 0 );
+                    volk_32fc_magnitude_squared_32f(d_magnitude, d_ifft->get_outbuf() + offset, effective_fft_size);
+                    volk_32f_index_max_16u(&indext, d_magnitude, effective_fft_size);
+                    magt = d_magnitude[indext];
+
+                    if (d_use_CFAR_algorithm_flag == true)
+                        {
+                            // Normalize the maximum value to correct the scale factor introduced by FFTW
+                            magt = d_magnitude[indext] / (fft_normalization_factor * fft_normalization_factor);
+                        }
+                    // 5- record the maximum peak and the associated synchronization parameters
+                    if (d_mag < magt)
+                        {
+                            d_mag = magt;
+
+                            if (d_use_CFAR_algorithm_flag == false)
+                                {
+                                    // Search grid noise floor approximation for this doppler line
+                                    volk_32f_accumulator_s32f(&d_input_power, d_magnitude, effective_fft_size);
+                                    d_input_power = (d_input_power - d_mag) / (effective_fft_size - 1);
+                                }
+
+                            // See pcps_acquisition_cc for the multi-dwell handling of d_test_statistics
+                            if (d_test_statistics < (d_mag / d_input_power) || !d_bit_transition_flag)
+                                {
+                                    d_gnss_synchro->Acq_delay_samples = static_cast<double>(indext % d_samples_per_code);
+                                    d_gnss_synchro->Acq_doppler_hz = static_cast<double>(d_bin_doppler[doppler_index]);
+                                    d_gnss_synchro->Acq_samplestamp_samples = d_sample_counter;
+
+                                    // 6- Compute the test statistics and compare to the threshold
+                                    d_test_statistics = d_mag / d_input_power;
+                                }
+                        }
+
+                    // Record results to file if required
+                    if (d_dump)
+                        {
+                            std::stringstream filename;
+                            std::streamsize n = 2 * sizeof(float) * (d_fft_size); // complex file write
+                            filename.str("");
+
+                            boost::filesystem::path p = d_dump_filename;
+                            filename << p.parent_path().string()
+                                     << boost::filesystem::path::preferred_separator
+                                     << p.stem().string()
+                                     << "_" << d_gnss_synchro->System
+                                     <<"_" << d_gnss_synchro->Signal << "_sat_"
+                                     << d_gnss_synchro->PRN << "_doppler_"
+                                     << static_cast<int>(d_bin_doppler[doppler_index])
+                                     << p.extension().string();
+
+                            DLOG(INFO) << "Writing ACQ out to " << filename.str();
+
+                            d_dump_file.open(filename.str().c_str(), std::ios::out | std::ios::binary);
+                            d_dump_file.write((char*)d_ifft->get_outbuf(), n);
+                            d_dump_file.close();
+                        }
+                }
+
+            if (!d_bit_transition_flag)
+                {
+                    if (d_test_statistics > d_threshold)
+                        {
+                            d_state = 2; // Positive acquisition
+                        }
+                    else if (d_well_count == d_max_dwells)
+                        {
+                            d_state = 3; // Negative acquisition
+                        }
+                }
+            else
+                {
+                    if (d_well_count == d_max_dwells) // d_max_dwells = 2
+                        {
+                            if (d_test_statistics > d_threshold)
+                                {
+                                    d_state = 2; // Positive acquisition
+                                }
+                            else
+                                {
+                                    d_state = 3; // Negative acquisition
+                                }
+                        }
+                }
+
+            consume_each(1);
+
+            DLOG(INFO) << "Done. Consumed 1 item.";
+
+            break;
+        }
+
+    case 2:
+        {
+            // 7.1- Declare positive acquisition using a message port
+            DLOG(INFO) << "positive acquisition";
+            DLOG(INFO) << "satellite " << d_gnss_synchro->System << " " << d_gnss_synchro->PRN;
+            DLOG(INFO) << "sample_stamp " << d_sample_counter;
+            DLOG(INFO) << "test statistics value " << d_test_statistics;
+            DLOG(INFO) << "test statistics threshold " << d_threshold;
+            DLOG(INFO) << "code phase " << d_gnss_synchro->Acq_delay_samples;
+            DLOG(INFO) << "doppler " << d_gnss_synchro->Acq_doppler_hz;
+            DLOG(INFO) << "magnitude " << d_mag;
+            DLOG(INFO) << "input signal power " << d_input_power;
+
+            d_active = false;
+            d_state = 0;
+            d_sample_counter += d_fft_size * ninput_items[0]; // sample counter
+            consume_each(ninput_items[0]);
+
+            acquisition_message = 1;
+            this->message_port_pub(pmt::mp("events"), pmt::from_long(acquisition_message));
+
+            break;
+        }
+
+    case 3:
+        {
+            // 7.2- Declare negative acquisition using a message port
+            DLOG(INFO) << "negative acquisition";
+            DLOG(INFO) << "satellite " << d_gnss_synchro->System << " " << d_gnss_synchro->PRN;
+            DLOG(INFO) << "sample_stamp " << d_sample_counter;
+            DLOG(INFO) << "test statistics value " << d_test_statistics;
+            DLOG(INFO) << "test statistics threshold " << d_threshold;
+            DLOG(INFO) << "code phase " << d_gnss_synchro->Acq_delay_samples;
+            DLOG(INFO) << "doppler " << d_gnss_synchro->Acq_doppler_hz;
+            DLOG(INFO) << "magnitude " << d_mag;
+            DLOG(INFO) << "input signal power " << d_input_power;
+
+            d_active = false;
+            d_state = 0;
+
+            d_sample_counter += d_fft_size * ninput_items[0]; // sample counter
+            consume_each(ninput_items[0]);
+            acquisition_message = 2;
+            this->message_port_pub(pmt::mp("events"), pmt::from_long(acquisition_message));
+
+            break;
+        }
+    }
+
+    return noutput_items;
+}
@@ -0,0 +1,279 @@
+/*!
+ * \file pcps_shifted_spectrum_acquisition_cc.h
+ * \brief This class implements a Parallel Code Phase Search Acquisition
+ *  in which the Doppler search is done by shifting the input spectrum
+ *
+ *  Acquisition strategy:
+ *  <ol>
+ *  <li> Compute the input signal power estimation
+ *  <li> Compute one FFT of the input per residual (sub-bin) frequency offset
+ *  <li> Doppler serial search loop, where each integer FFT bin shift is a
+ *       circular index shift of the input spectrum
+ *  <li> Perform the FFT-based circular convolution (parallel time search)
+ *  <li> Record the maximum peak and the associated synchronization parameters
+ *  <li> Compute the test statistics and compare to the threshold
+ *  <li> Declare positive or negative acquisition using a message port
+ *  </ol>
+ *
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PCPS_SHIFTED_SPECTRUM_ACQUISITION_CC_H_
+#define GNSS_SDR_PCPS_SHIFTED_SPECTRUM_ACQUISITION_CC_H_
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <gnuradio/block.h>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/fft/fft.h>
+#include "gnss_synchro.h"
+#include "input_spectrum_store.h"
+
+class pcps_shifted_spectrum_acquisition_cc;
+
+typedef boost::shared_ptr<pcps_shifted_spectrum_acquisition_cc> pcps_shifted_spectrum_acquisition_cc_sptr;
+
+pcps_shifted_spectrum_acquisition_cc_sptr
+pcps_make_shifted_spectrum_acquisition_cc(unsigned int sampled_ms, unsigned int max_dwells,
+                         unsigned int doppler_max, long freq, long fs_in,
+                         int samples_per_ms, int samples_per_code,
+                         bool bit_transition_flag, bool use_CFAR_algorithm_flag,
+                         bool dump,
+                         std::string dump_filename);
+
+/*!
+ * \brief This class implements a Parallel Code Phase Search Acquisition
+ * that computes only a few forward FFTs of the input per dwell.
+ *
+ * A carrier wipe-off of an integer number m of FFT bins (fs / fft_size Hz each)
+ * is equivalent to a circular shift of m positions of the input spectrum, so
+ * it can be applied directly in the frequency domain. The remaining fraction of
+ * a bin is handled by K pre-rotated copies of the input (K = ceil(bin / doppler_step)),
+ * so that each dwell costs K forward FFTs instead of one per Doppler bin.
+ * The Doppler grid is the same as in pcps_acquisition_cc, with each cell rounded
+ * to the nearest 1/K of a bin. Since the K input spectra do not depend on the PRN,
+ * they can also be shared with the other channels acquiring from the same
+ * signal conditioner (see set_share_input_spectrum).
+ */
+class pcps_shifted_spectrum_acquisition_cc: public gr::block
+{
+private:
+    friend pcps_shifted_spectrum_acquisition_cc_sptr
+    pcps_make_shifted_spectrum_acquisition_cc(unsigned int sampled_ms, unsigned int max_dwells,
+            unsigned int doppler_max, long freq, long fs_in,
+            int samples_per_ms, int samples_per_code,
+            bool bit_transition_flag, bool use_CFAR_algorithm_flag,
+            bool dump,
+            std::string dump_filename);
+
+    pcps_shifted_spectrum_acquisition_cc(unsigned int sampled_ms, unsigned int max_dwells,
+            unsigned int doppler_max, long freq, long fs_in,
+            int samples_per_ms, int samples_per_code,
+            bool bit_transition_flag, bool use_CFAR_algorithm_flag,
+            bool dump,
+            std::string dump_filename);
+
+    void free_residual_buffers();
+
+    long d_fs_in;
+    long d_freq;
+    int d_samples_per_ms;
+    int d_samples_per_code;
+    float d_threshold;
+    unsigned int d_doppler_max;
+    unsigned int d_doppler_step;
+    unsigned int d_sampled_ms;
+    unsigned int d_max_dwells;
+    unsigned int d_well_count;
+    unsigned int d_fft_size;
+    unsigned long int d_sample_counter;
+    unsigned int d_num_doppler_bins;
+    unsigned int d_num_residuals;                  // K: number of sub-bin frequency offsets
+    std::vector<gr_complex*> d_residual_rotators;  // K input rotators (length d_fft_size)
+    std::vector<gr_complex*> d_residual_spectra;   // K input spectra computed in each dwell
+    std::vector<const gr_complex*> d_spectra;      // K input spectra used in the current dwell
+    bool d_share_input_spectrum;
+    unsigned int d_rf_channel;
+    std::vector<unsigned int> d_bin_shift;         // Spectrum shift of each Doppler bin [FFT bins]
+    std::vector<unsigned int> d_bin_residual;      // Residual index of each Doppler bin
+    std::vector<float> d_bin_doppler;              // Doppler actually tested in each bin [Hz]
+    std::shared_ptr<const gr_complex> d_fft_codes;
+    gr::fft::fft_complex* d_fft_if;
+    gr::fft::fft_complex* d_ifft;
+    Gnss_Synchro *d_gnss_synchro;
+    float d_mag;
+    float* d_magnitude;
+    float d_input_power;
+    float d_test_statistics;
+    bool d_bit_transition_flag;
+    bool d_use_CFAR_algorithm_flag;
+    std::ofstream d_dump_file;
+    bool d_active;
+    int d_state;
+    bool d_dump;
+    unsigned int d_channel;
+    std::string d_dump_filename;
+
+public:
+    /*!
+     * \brief Default destructor.
+     */
+     ~pcps_shifted_spectrum_acquisition_cc();
+
+     /*!
+      * \brief Set acquisition/tracking common Gnss_Synchro object pointer
+      * to exchange synchronization data between acquisition and tracking blocks.
+      * \param p_gnss_synchro Satellite information shared by the processing blocks.
+      */
+     void set_gnss_synchro(Gnss_Synchro* p_gnss_synchro)
+     {
+         d_gnss_synchro = p_gnss_synchro;
+     }
+
+     /*!
+      * \brief Returns the maximum peak of grid search.
+      */
+     unsigned int mag()
+     {
+         return d_mag;
+     }
+
+     /*!
+      * \brief Initializes acquisition algorithm.
+      */
+     void init();
+
+     /*!
+      * \brief Sets local code for PCPS acquisition algorithm.
+      * \param code - Pointer to the PRN code.
+      */
+     void set_local_code(std::complex<float> * code);
+
+     /*!
+      * \brief Sets the already conjugated FFT of the local code, typically
+      * obtained from the Fft_Code_Cache shared by all the channels.
+      * \param fft_code - Conjugated spectrum of length fft_size().
+      */
+     void set_local_code_fft(std::shared_ptr<const gr_complex> fft_code)
+     {
+         d_fft_codes = fft_code;
+     }
+
+     /*!
+      * \brief Returns the FFT length used by the block (doubled if
+      * bit_transition_flag is set).
+      */
+     unsigned int fft_size()
+     {
+         return d_fft_size;
+     }
+
+     /*!
+      * \brief Starts acquisition algorithm, turning from standby mode to
+      * active mode
+      * \param active - bool that activates/deactivates the block.
+      */
+     void set_active(bool active)
+     {
+         d_active = active;
+     }
+
+     /*!
+      * \brief If set to 1, ensures that acquisition starts at the
+      * first available sample.
+      * \param state - int=1 forces start of acquisition
+      */
+     void set_state(int state);
+
+     /*!
+      * \brief Set acquisition channel unique ID
+      * \param channel - receiver channel.
+      */
+     void set_channel(unsigned int channel)
+     {
+         d_channel = channel;
+     }
+
+     /*!
+      * \brief Set statistics threshold of PCPS algorithm.
+      * \param threshold - Threshold for signal detection (check \ref Navitec2012,
+      * Algorithm 1, for a definition of this threshold).
+      */
+     void set_threshold(float threshold)
+     {
+         d_threshold = threshold;
+     }
+
+     /*!
+      * \brief Set maximum Doppler grid search
+      * \param doppler_max - Maximum Doppler shift considered in the grid search [Hz].
+      */
+     void set_doppler_max(unsigned int doppler_max)
+     {
+         d_doppler_max = doppler_max;
+     }
+
+     /*!
+      * \brief Set Doppler steps for the grid search
+      * \param doppler_step - Frequency bin of the search grid [Hz].
+      */
+     void set_doppler_step(unsigned int doppler_step)
+     {
+         d_doppler_step = doppler_step;
+     }
+
+     /*!
+      * \brief Shares the input spectra with the other channels fed by the same
+      * signal conditioner through the Input_Spectrum_Store.
+      * \param share - enables or disables the sharing.
+      * \param rf_channel - signal conditioner feeding this channel.
+      */
+     void set_share_input_spectrum(bool share, unsigned int rf_channel)
+     {
+         d_share_input_spectrum = share;
+         d_rf_channel = rf_channel;
+     }
+
+     /*!
+      * \brief Returns the number of forward FFTs of the input computed per dwell.
+      */
+     unsigned int num_forward_ffts()
+     {
+         return d_num_residuals;
+     }
+
+     /*!
+      * \brief Parallel Code Phase Search Acquisition signal processing.
+      */
+     int general_work(int noutput_items, gr_vector_int &ninput_items,
+             gr_vector_const_void_star &input_items,
+             gr_vector_void_star &output_items);
+};
+
+#endif /* GNSS_SDR_PCPS_SHIFTED_SPECTRUM_ACQUISITION_CC_H_*/
@@ -56,9 +56,61 @@
 #include <volk_gnsssdr/volk_gnsssdr.h>
 #include "control_message_factory.h"
 #include "GPS_L1_CA.h" //GPS_TWO_PI
+#include "acquisition_assistance.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
 
 using google::LogMessage;
 
+namespace
+{
+// Adds the test statistics of each Doppler bin of a dwell to the grid
+// accumulated over the dwells, and writes the correlation to a file if required
+class Tong_Grid_Accumulator
+{
+public:
+    Tong_Grid_Accumulator(const Pcps_Search_Core & core, float** grid_data, float* scaled,
+            const Gnss_Synchro & synchro, const Doppler_Grid & grid, int doppler_center, bool dump) :
+        d_core(core), d_grid_data(grid_data), d_scaled(scaled), d_synchro(synchro),
+        d_grid(grid), d_doppler_center(doppler_center), d_dump(dump)
+    {}
+
+    void operator()(unsigned int doppler_index, const gr_complex* correlation)
+    {
+        const unsigned int fft_size = d_core.fft_size();
+        const float fft_normalization_factor = static_cast<float>(fft_size) * static_cast<float>(fft_size);
+        volk_32f_s32f_multiply_32f(d_scaled, d_core.magnitude(),
+                1 / (fft_normalization_factor * fft_normalization_factor * d_core.input_power()),
+                fft_size);
+        volk_32f_x2_add_32f(d_grid_data[doppler_index], d_scaled, d_grid_data[doppler_index], fft_size);
+
+        if (d_dump)
+            {
+                std::stringstream filename;
+                std::ofstream dump_file;
+                std::streamsize n = 2 * sizeof(float) * (fft_size); // complex file write
+                filename << "../data/test_statistics_" << d_synchro.System
+                         <<"_" << d_synchro.Signal << "_sat_"
+                         << d_synchro.PRN << "_doppler_"
+                         << d_doppler_center + d_grid.doppler(doppler_index) << ".dat";
+                dump_file.open(filename.str().c_str(), std::ios::out | std::ios::binary);
+                dump_file.write((char*)correlation, n);
+                dump_file.close();
+            }
+    }
+
+private:
+    const Pcps_Search_Core & d_core;
+    float** d_grid_data;
+    float* d_scaled;
+    const Gnss_Synchro & d_synchro;
+    const Doppler_Grid & d_grid;
+    int d_doppler_center;
+    bool d_dump;
+};
+}
+
+
 pcps_tong_acquisition_cc_sptr pcps_tong_make_acquisition_cc(
                               unsigned int sampled_ms, unsigned int doppler_max,
                               long freq, long fs_in, int samples_per_ms,
@@ -79,7 +131,8 @@ pcps_tong_acquisition_cc::pcps_tong_acquisition_cc(
                          bool dump, std::string dump_filename) :
     gr::block("pcps_tong_acquisition_cc",
     gr::io_signature::make(1, 1, sizeof(gr_complex) * sampled_ms * samples_per_ms),
-    gr::io_signature::make(0, 0, sizeof(gr_complex) * sampled_ms * samples_per_ms))
+    gr::io_signature::make(0, 0, sizeof(gr_complex) * sampled_ms * samples_per_ms)),
+    d_core(sampled_ms * samples_per_ms, sampled_ms * samples_per_ms, false)
 {
     this->message_port_register_out(pmt::mp("events"));
     d_sample_counter = 0;    // SAMPLE COUNTER
@@ -99,15 +152,10 @@ pcps_tong_acquisition_cc::pcps_tong_acquisition_cc(
     d_mag = 0;
     d_input_power = 0.0;
     d_num_doppler_bins = 0;
+    d_doppler_center = 0;
+    d_doppler_search_max = doppler_max;
 
-    d_fft_codes = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-    d_magnitude = static_cast<float*>(volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
-
-    // Direct FFT
-    d_fft_if = new gr::fft::fft_complex(d_fft_size, true);
-
-    // Inverse FFT
-    d_ifft = new gr::fft::fft_complex(d_fft_size, false);
+    d_magnitude = static_cast<float*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
 
     // For dumping samples into a file
     d_dump = dump;
@@ -117,7 +165,6 @@ pcps_tong_acquisition_cc::pcps_tong_acquisition_cc(
     d_threshold = 0;
     d_doppler_step = 0;
     d_grid_data = 0;
-    d_grid_doppler_wipeoffs = 0;
     d_gnss_synchro = 0;
     d_code_phase = 0;
     d_doppler_freq = 0;
@@ -131,18 +178,12 @@ pcps_tong_acquisition_cc::~pcps_tong_acquisition_cc()
         {
             for (unsigned int i = 0; i < d_num_doppler_bins; i++)
                 {
-                    volk_free(d_grid_doppler_wipeoffs[i]);
-                    volk_free(d_grid_data[i]);
+                    gnss_sdr_volk_free(d_grid_data[i]);
                 }
-            delete[] d_grid_doppler_wipeoffs;
             delete[] d_grid_data;
         }
 
-    volk_free(d_fft_codes);
-    volk_free(d_magnitude);
-
-    delete d_ifft;
-    delete d_fft_if;
+    gnss_sdr_volk_free(d_magnitude);
 
     if (d_dump)
         {
@@ -152,12 +193,7 @@ pcps_tong_acquisition_cc::~pcps_tong_acquisition_cc()
 
 void pcps_tong_acquisition_cc::set_local_code(std::complex<float> * code)
 {
-    memcpy(d_fft_if->get_inbuf(), code, sizeof(gr_complex)*d_fft_size);
-
-    d_fft_if->execute(); // We need the FFT of local code
-
-    //Conjugate the local code
-    volk_32fc_conjugate_32fc(d_fft_codes, d_fft_if->get_outbuf(), d_fft_size);
+    d_core.set_local_code(code);
 }
 
 void pcps_tong_acquisition_cc::init()
@@ -174,29 +210,49 @@ void pcps_tong_acquisition_cc::init()
     d_mag = 0.0;
     d_input_power = 0.0;
 
+    update_doppler_window(true);
+}
+
+
+void pcps_tong_acquisition_cc::update_doppler_window(bool force)
+{
+    int doppler_center = 0;
+    unsigned int doppler_search_max = d_doppler_max;
+    if (d_gnss_synchro != 0)
+        {
+            Acquisition_Assistance::doppler_window(*d_gnss_synchro, d_doppler_max, d_doppler_step,
+                    doppler_center, doppler_search_max, static_cast<double>(d_sample_counter) / static_cast<double>(d_fs_in));
+        }
+    if (!force && doppler_center == d_doppler_center && doppler_search_max == d_doppler_search_max)
+        {
+            return;
+        }
+    d_doppler_center = doppler_center;
+    d_doppler_search_max = doppler_search_max;
+
+    for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
+        {
+            gnss_sdr_volk_free(d_grid_data[doppler_index]);
+        }
+    delete[] d_grid_data;
+
     // Count the number of bins
     d_num_doppler_bins = 0;
-    for (int doppler = static_cast<int>(-d_doppler_max);
-         doppler <= static_cast<int>(d_doppler_max);
+    for (int doppler = static_cast<int>(-d_doppler_search_max);
+         doppler <= static_cast<int>(d_doppler_search_max);
          doppler += d_doppler_step)
     {
         d_num_doppler_bins++;
     }
 
     // Create the carrier Doppler wipeoff signals and allocate data grid.
-    d_grid_doppler_wipeoffs = new gr_complex*[d_num_doppler_bins];
+    // The wipeoff signals are shared with the other channels
+    d_grid_doppler_wipeoffs = Doppler_Grid_Store::instance().get(d_fs_in, d_freq + d_doppler_center,
+            d_fft_size, d_doppler_search_max, d_doppler_step, d_num_doppler_bins);
     d_grid_data = new float*[d_num_doppler_bins];
     for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
         {
-            d_grid_doppler_wipeoffs[doppler_index] = static_cast<gr_complex*>(volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
-
-            int doppler = -static_cast<int>(d_doppler_max) + d_doppler_step * doppler_index;
-            float phase_step_rad = GPS_TWO_PI * (d_freq + doppler) / static_cast<float>(d_fs_in);
-            float _phase[1];
-            _phase[0] = 0;
-            volk_gnsssdr_s32f_sincos_32fc(d_grid_doppler_wipeoffs[doppler_index], - phase_step_rad, _phase, d_fft_size);
-
-            d_grid_data[doppler_index] = static_cast<float*>(volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
+            d_grid_data[doppler_index] = static_cast<float*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
 
             for (unsigned int i = 0; i < d_fft_size; i++)
                 {
@@ -210,6 +266,7 @@ void pcps_tong_acquisition_cc::set_state(int state)
     d_state = state;
     if (d_state == 1)
         {
+            update_doppler_window(false);
             d_gnss_synchro->Acq_delay_samples = 0.0;
             d_gnss_synchro->Acq_doppler_hz = 0.0;
             d_gnss_synchro->Acq_samplestamp_samples = 0;
@@ -240,6 +297,7 @@ int pcps_tong_acquisition_cc::general_work(int noutput_items,
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items __attribute__((unused)))
 {
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("pcps_tong_acquisition_cc::general_work", d_channel, d_gnss_synchro ? d_gnss_synchro->PRN : 0);
     int acquisition_message = -1; //0=STOP_CHANNEL 1=ACQ_SUCCEES 2=ACQ_FAIL
 
     switch (d_state)
@@ -248,6 +306,7 @@ int pcps_tong_acquisition_cc::general_work(int noutput_items,
         {
             if (d_active)
                 {
+                    update_doppler_window(false);
                     //restart acquisition variables
                     d_gnss_synchro->Acq_delay_samples = 0.0;
                     d_gnss_synchro->Acq_doppler_hz = 0.0;
@@ -278,7 +337,6 @@ int pcps_tong_acquisition_cc::general_work(int noutput_items,
     case 1:
         {
             // initialize acquisition algorithm
-            int doppler;
 #if VOLK_GT_122
             uint16_t indext = 0;
 #else
@@ -286,7 +344,6 @@ int pcps_tong_acquisition_cc::general_work(int noutput_items,
 #endif
             float magt = 0.0;
             const gr_complex *in = (const gr_complex *)input_items[0]; //Get the input samples pointer
-            float fft_normalization_factor = static_cast<float>(d_fft_size) * static_cast<float>(d_fft_size);
             d_input_power = 0.0;
             d_mag = 0.0;
 
@@ -298,73 +355,31 @@ int pcps_tong_acquisition_cc::general_work(int noutput_items,
                     << " , doing acquisition of satellite: " << d_gnss_synchro->System << " "<< d_gnss_synchro->PRN
                     << " ,sample stamp: " << d_sample_counter << ", threshold: "
                     << d_threshold << ", doppler_max: " << d_doppler_max
-                    << ", doppler_step: " << d_doppler_step;
+                    << ", doppler_step: " << d_doppler_step
+                    << ", doppler search: " << d_doppler_center << " +/- " << d_doppler_search_max;
 
             // 1- Compute the input signal power estimation
-            volk_32fc_magnitude_squared_32f(d_magnitude, in, d_fft_size);
-            volk_32f_accumulator_s32f(&d_input_power, d_magnitude, d_fft_size);
-            d_input_power /= static_cast<float>(d_fft_size);
-
             // 2- Doppler frequency search loop
+            // 3- Perform the FFT-based convolution (parallel time search),
+            // accumulating the test statistics of every cell in d_grid_data
+            Tong_Grid_Accumulator accumulator(d_core, d_grid_data, d_magnitude, *d_gnss_synchro,
+                    *d_grid_doppler_wipeoffs, d_doppler_center, d_dump);
+            d_core.search<Pcps_Cfar_Detector>(in, *d_grid_doppler_wipeoffs, accumulator);
+            d_input_power = d_core.input_power();
+
+            // 4- record the maximum peak of the accumulated grid and the
+            // associated synchronization parameters
             for (unsigned int doppler_index = 0; doppler_index < d_num_doppler_bins; doppler_index++)
                 {
-                    // doppler search steps
-
-                    doppler = -static_cast<int>(d_doppler_max) + d_doppler_step * doppler_index;
-
-                    volk_32fc_x2_multiply_32fc(d_fft_if->get_inbuf(), in,
-                                d_grid_doppler_wipeoffs[doppler_index], d_fft_size);
-
-                    // 3- Perform the FFT-based convolution  (parallel time search)
-                    // Compute the FFT of the carrier wiped--off incoming signal
-                    d_fft_if->execute();
-
-                    // Multiply carrier wiped--off, Fourier transformed incoming signal
-                    // with the local FFT'd code reference using SIMD operations with VOLK library
-                    volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(),
-                                d_fft_if->get_outbuf(), d_fft_codes, d_fft_size);
-
-                    // compute the inverse FFT
-                    d_ifft->execute();
-
-                    // Compute magnitude
-                    volk_32fc_magnitude_squared_32f(d_magnitude, d_ifft->get_outbuf(), d_fft_size);
-
-                    // Compute vector of test statistics corresponding to current doppler index.
-                    volk_32f_s32f_multiply_32f(d_magnitude, d_magnitude,
-                                                1/(fft_normalization_factor*fft_normalization_factor*d_input_power),
-                                                d_fft_size);
-
-                    // Accumulate test statistics in d_grid_data.
-                    volk_32f_x2_add_32f(d_grid_data[doppler_index], d_magnitude, d_grid_data[doppler_index], d_fft_size);
-
-                    // Search maximum
                     volk_32f_index_max_16u(&indext, d_grid_data[doppler_index], d_fft_size);
-
                     magt = d_grid_data[doppler_index][indext];
-
-                    // 4- record the maximum peak and the associated synchronization parameters
                     if (d_mag < magt)
                         {
                             d_mag = magt;
                             d_gnss_synchro->Acq_delay_samples = static_cast<double>(indext % d_samples_per_code);
-                            d_gnss_synchro->Acq_doppler_hz = static_cast<double>(doppler);
+                            d_gnss_synchro->Acq_doppler_hz = static_cast<double>(d_doppler_center + d_grid_doppler_wipeoffs->doppler(doppler_index));
                             d_gnss_synchro->Acq_samplestamp_samples = d_sample_counter;
                         }
-
-                    // Record results to file if required
-                    if (d_dump)
-                        {
-                            std::stringstream filename;
-                            std::streamsize n = 2 * sizeof(float) * (d_fft_size); // complex file write
-                            filename.str("");
-                            filename << "../data/test_statistics_" << d_gnss_synchro->System
-                                     <<"_" << d_gnss_synchro->Signal << "_sat_"
-                                     << d_gnss_synchro->PRN << "_doppler_" <<  doppler << ".dat";
-                            d_dump_file.open(filename.str().c_str(), std::ios::out | std::ios::binary);
-                            d_dump_file.write((char*)d_ifft->get_outbuf(), n); //write directly |abs(x)|^2 in this Doppler bin?
-                            d_dump_file.close();
-                        }
                 }
 
             // 5- Compute the test statistics and compare to the threshold
@@ -52,11 +52,13 @@
 #define GNSS_SDR_PCPS_TONG_ACQUISITION_CC_H_
 
 #include <fstream>
+#include <memory>
 #include <string>
 #include <gnuradio/block.h>
 #include <gnuradio/gr_complex.h>
-#include <gnuradio/fft/fft.h>
 #include "gnss_synchro.h"
+#include "doppler_grid_store.h"
+#include "pcps_search_core.h"
 
 class pcps_tong_acquisition_cc;
 
@@ -72,6 +74,9 @@ pcps_tong_make_acquisition_cc(unsigned int sampled_ms, unsigned int doppler_max,
 /*!
  * \brief This class implements a Parallel Code Phase Search Acquisition with
  * Tong algorithm.
+ *
+ * The correlations are computed by a Pcps_Search_Core; the block adds the
+ * test statistics of every cell over the dwells and runs the Tong counter.
  */
 class pcps_tong_acquisition_cc: public gr::block
 {
@@ -92,6 +97,8 @@ private:
     void calculate_magnitudes(gr_complex* fft_begin, int doppler_shift,
             int doppler_offset);
 
+    void update_doppler_window(bool force);
+
     long d_fs_in;
     long d_freq;
     int d_samples_per_ms;
@@ -108,17 +115,16 @@ private:
     unsigned int d_tong_max_val;
     unsigned int d_fft_size;
     unsigned long int d_sample_counter;
-    gr_complex** d_grid_doppler_wipeoffs;
+    std::shared_ptr<const Doppler_Grid> d_grid_doppler_wipeoffs;
     unsigned int d_num_doppler_bins;
-    gr_complex* d_fft_codes;
-    float** d_grid_data;
-    gr::fft::fft_complex* d_fft_if;
-    gr::fft::fft_complex* d_ifft;
+    int d_doppler_center;              // Centre of the Doppler search, from Acquisition_Assistance [Hz]
+    unsigned int d_doppler_search_max; // Half width of the Doppler search, at most d_doppler_max [Hz]
+    float** d_grid_data;               // test statistics accumulated over the dwells
     Gnss_Synchro *d_gnss_synchro;
     unsigned int d_code_phase;
     float d_doppler_freq;
     float d_mag;
-    float* d_magnitude;
+    float* d_magnitude;                // test statistics of one bin and dwell
     float d_input_power;
     float d_test_statistics;
     std::ofstream d_dump_file;
@@ -127,6 +133,7 @@ private:
     bool d_dump;
     unsigned int d_channel;
     std::string d_dump_filename;
+    Pcps_Search_Core d_core;
 
 public:
     /*!
@@ -0,0 +1,369 @@
+/*!
+ * \file cuda_acquisition_engine.cu
+ * \brief Parallel code phase search of many codes over a whole Doppler grid
+ *  on a CUDA GPU, with batched cuFFT plans and device-resident code spectra.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "cuda_acquisition_engine.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cuda_runtime.h>
+
+#define ACQUISITION_THREADS_PER_BLOCK 256
+#define TWO_PI_F 6.28318530717958647692f
+
+#define acqErrchk(ans) acqAssert((ans), __FILE__, __LINE__)
+inline bool acqAssert(cudaError_t code, const char *file, int line)
+{
+    if (code != cudaSuccess)
+        {
+            fprintf(stderr, "GPUassert: %s %s %d\n", cudaGetErrorString(code), file, line);
+            return false;
+        }
+    return true;
+}
+
+#define acqFftErrchk(ans) acqFftAssert((ans), __FILE__, __LINE__)
+inline bool acqFftAssert(cufftResult code, const char *file, int line)
+{
+    if (code != CUFFT_SUCCESS)
+        {
+            fprintf(stderr, "cuFFT error %d %s %d\n", static_cast<int>(code), file, line);
+            return false;
+        }
+    return true;
+}
+
+
+__device__ inline cufftComplex acq_multiply(cufftComplex a, cufftComplex b)
+{
+    cufftComplex c;
+    c.x = a.x * b.x - a.y * b.y;
+    c.y = a.x * b.y + a.y * b.x;
+    return c;
+}
+
+
+/*
+ * Carrier wipe-off of the input window for every Doppler bin. The phase is
+ * computed from the sample index, as in the multichannel correlator, and
+ * reduced to [-pi, pi] where __sincosf is accurate.
+ */
+__global__ void acquisition_doppler_wipeoff(cufftComplex *d_out, const cufftComplex *d_in,
+        const float *d_phase_steps, int fft_size, int num_bins)
+{
+    float sin;
+    float cos;
+    for (int i = blockIdx.x * blockDim.x + threadIdx.x; i < fft_size * num_bins; i += blockDim.x * gridDim.x)
+        {
+            const int bin = i / fft_size;
+            const int n = i - bin * fft_size;
+            float phase = d_phase_steps[bin] * __int2float_rn(n);
+            phase -= TWO_PI_F * rintf(phase * (1.0f / TWO_PI_F));
+            __sincosf(phase, &sin, &cos);
+            cufftComplex carrier;
+            carrier.x = cos;
+            carrier.y = -sin;
+            d_out[i] = acq_multiply(d_in[n], carrier);
+        }
+}
+
+
+//! Product of the spectra of every bin with the same conjugated code spectrum
+__global__ void acquisition_code_product(cufftComplex *d_out, const cufftComplex *d_spectra,
+        const cufftComplex *d_code_spectrum, int fft_size, int num_bins)
+{
+    for (int i = blockIdx.x * blockDim.x + threadIdx.x; i < fft_size * num_bins; i += blockDim.x * gridDim.x)
+        {
+            d_out[i] = acq_multiply(d_spectra[i], d_code_spectrum[i % fft_size]);
+        }
+}
+
+
+__global__ void acquisition_conjugate(cufftComplex *d_out, const cufftComplex *d_in, int n)
+{
+    for (int i = blockIdx.x * blockDim.x + threadIdx.x; i < n; i += blockDim.x * gridDim.x)
+        {
+            d_out[i].x = d_in[i].x;
+            d_out[i].y = -d_in[i].y;
+        }
+}
+
+
+/*
+ * One thread block per Doppler bin: every thread keeps the maximum of
+ * |x|^2 over a strided part of the bin, and the partial maxima are then
+ * reduced in shared memory. Ties go to the lowest index, as in
+ * volk_32f_index_max_16u, so that the results match the CPU blocks.
+ */
+__global__ void acquisition_peak_search(cuda_acquisition_peak *d_peaks, const cufftComplex *d_correlation, int fft_size)
+{
+    extern __shared__ cuda_acquisition_peak partial_peaks[];
+
+    const cufftComplex *bin = d_correlation + blockIdx.x * fft_size;
+    cuda_acquisition_peak best;
+    best.magnitude = -1.0f;
+    best.index = 0;
+    for (int n = threadIdx.x; n < fft_size; n += blockDim.x)
+        {
+            const float magnitude = bin[n].x * bin[n].x + bin[n].y * bin[n].y;
+            if (magnitude > best.magnitude)
+                {
+                    best.magnitude = magnitude;
+                    best.index = n;
+                }
+        }
+    partial_peaks[threadIdx.x] = best;
+    __syncthreads();
+    // blockDim.x has to be a power of two
+    for (int stride = blockDim.x / 2; stride > 0; stride >>= 1)
+        {
+            if (threadIdx.x < stride)
+                {
+                    const cuda_acquisition_peak other = partial_peaks[threadIdx.x + stride];
+                    const cuda_acquisition_peak mine = partial_peaks[threadIdx.x];
+                    if (other.magnitude > mine.magnitude || (other.magnitude == mine.magnitude && other.index < mine.index))
+                        {
+                            partial_peaks[threadIdx.x] = other;
+                        }
+                }
+            __syncthreads();
+        }
+    if (threadIdx.x == 0)
+        {
+            d_peaks[blockIdx.x] = partial_peaks[0];
+        }
+}
+
+
+cuda_acquisition_engine::cuda_acquisition_engine()
+{
+    d_device = -1;
+    d_fft_size = 0;
+    d_num_doppler_bins = 0;
+    d_max_codes = 0;
+    d_in_cpu = 0;
+    d_in_gpu = 0;
+    d_phase_steps_gpu = 0;
+    d_spectra_gpu = 0;
+    d_product_gpu = 0;
+    d_code_spectra_gpu = 0;
+    d_peaks_gpu = 0;
+    d_peaks_cpu = 0;
+    d_plan_bins = 0;
+    d_plan_code = 0;
+    d_plans_created = false;
+    d_stream = 0;
+    d_search_done = 0;
+    d_threads_per_block = ACQUISITION_THREADS_PER_BLOCK;
+}
+
+
+cuda_acquisition_engine::~cuda_acquisition_engine()
+{
+    free_cuda();
+}
+
+
+bool cuda_acquisition_engine::init(int fft_size, int num_doppler_bins, int max_codes, int device)
+{
+    if (d_in_gpu != 0) free_cuda();
+
+    int num_devices = 0;
+    if (cudaGetDeviceCount(&num_devices) != cudaSuccess || num_devices == 0)
+        {
+            fprintf(stderr, "cuda_acquisition_engine: no CUDA device found\n");
+            return false;
+        }
+    if (device < 0 || device >= num_devices)
+        {
+            int max_multiprocessors = 0;
+            device = 0;
+            for (int dev = 0; dev < num_devices; dev++)
+                {
+                    cudaDeviceProp properties;
+                    cudaGetDeviceProperties(&properties, dev);
+                    if (max_multiprocessors < properties.multiProcessorCount)
+                        {
+                            max_multiprocessors = properties.multiProcessorCount;
+                            device = dev;
+                        }
+                }
+        }
+    d_device = device;
+    if (!acqErrchk(cudaSetDevice(d_device))) return false;
+
+    d_fft_size = fft_size;
+    d_num_doppler_bins = num_doppler_bins;
+    d_max_codes = max_codes;
+    const size_t grid_samples = static_cast<size_t>(d_fft_size) * d_num_doppler_bins;
+
+    bool ok = true;
+    ok = ok && acqErrchk(cudaHostAlloc((void**)&d_in_cpu, sizeof(cufftComplex) * d_fft_size, cudaHostAllocWriteCombined));
+    ok = ok && acqErrchk(cudaMalloc((void**)&d_in_gpu, sizeof(cufftComplex) * d_fft_size));
+    ok = ok && acqErrchk(cudaMalloc((void**)&d_phase_steps_gpu, sizeof(float) * d_num_doppler_bins));
+    ok = ok && acqErrchk(cudaMalloc((void**)&d_spectra_gpu, sizeof(cufftComplex) * grid_samples));
+    ok = ok && acqErrchk(cudaMalloc((void**)&d_product_gpu, sizeof(cufftComplex) * grid_samples));
+    ok = ok && acqErrchk(cudaMalloc((void**)&d_code_spectra_gpu, sizeof(cufftComplex) * d_fft_size * d_max_codes));
+    ok = ok && acqErrchk(cudaMalloc((void**)&d_peaks_gpu, sizeof(cuda_acquisition_peak) * d_num_doppler_bins * d_max_codes));
+    ok = ok && acqErrchk(cudaHostAlloc((void**)&d_peaks_cpu, sizeof(cuda_acquisition_peak) * d_num_doppler_bins * d_max_codes, cudaHostAllocDefault));
+    ok = ok && acqErrchk(cudaStreamCreateWithFlags(&d_stream, cudaStreamNonBlocking));
+    ok = ok && acqErrchk(cudaEventCreateWithFlags(&d_search_done, cudaEventDisableTiming));
+    if (ok)
+        {
+            // The same batched plan serves the forward FFTs of the input and
+            // the inverse FFTs of the correlations: both are in place and have
+            // the same size
+            int n[1] = { d_fft_size };
+            ok = acqFftErrchk(cufftPlanMany(&d_plan_bins, 1, n, NULL, 1, d_fft_size, NULL, 1, d_fft_size, CUFFT_C2C, d_num_doppler_bins));
+            ok = ok && acqFftErrchk(cufftPlan1d(&d_plan_code, d_fft_size, CUFFT_C2C, 1));
+            d_plans_created = ok;
+            ok = ok && acqFftErrchk(cufftSetStream(d_plan_bins, d_stream));
+            ok = ok && acqFftErrchk(cufftSetStream(d_plan_code, d_stream));
+        }
+    if (ok)
+        {
+            ok = acqErrchk(cudaMemset(d_code_spectra_gpu, 0, sizeof(cufftComplex) * d_fft_size * d_max_codes));
+        }
+    if (!ok)
+        {
+            free_cuda();
+        }
+    return ok;
+}
+
+
+bool cuda_acquisition_engine::set_doppler_grid(const float* phase_step_rad)
+{
+    if (d_in_gpu == 0) return false;
+    cudaSetDevice(d_device);
+    return acqErrchk(cudaMemcpy(d_phase_steps_gpu, phase_step_rad, sizeof(float) * d_num_doppler_bins, cudaMemcpyHostToDevice));
+}
+
+
+bool cuda_acquisition_engine::set_local_code(int slot, const std::complex<float>* code)
+{
+    if (d_in_gpu == 0 || slot < 0 || slot >= d_max_codes) return false;
+    cudaSetDevice(d_device);
+    // The codes are only replaced between searches, so the product buffer
+    // can hold the code while its spectrum is computed
+    cufftComplex *code_spectrum = d_code_spectra_gpu + slot * d_fft_size;
+    bool ok = acqErrchk(cudaMemcpyAsync(d_product_gpu, code, sizeof(cufftComplex) * d_fft_size,
+            cudaMemcpyHostToDevice, d_stream));
+    ok = ok && acqFftErrchk(cufftExecC2C(d_plan_code, d_product_gpu, d_product_gpu, CUFFT_FORWARD));
+    const int blocks = (d_fft_size + d_threads_per_block - 1) / d_threads_per_block;
+    acquisition_conjugate<<<blocks, d_threads_per_block, 0, d_stream>>>(code_spectrum, d_product_gpu, d_fft_size);
+    ok = ok && acqErrchk(cudaGetLastError());
+    ok = ok && acqErrchk(cudaStreamSynchronize(d_stream));
+    return ok;
+}
+
+
+bool cuda_acquisition_engine::search_async(const std::complex<float>* in, const int* slots, int n_slots)
+{
+    if (d_in_gpu == 0 || n_slots > d_max_codes) return false;
+    for (int i = 0; i < n_slots; i++)
+        {
+            if (slots[i] < 0 || slots[i] >= d_max_codes) return false;
+        }
+    cudaSetDevice(d_device);
+    // The previous search may still be reading the pinned input
+    acqErrchk(cudaEventSynchronize(d_search_done));
+    memcpy(d_in_cpu, in, sizeof(cufftComplex) * d_fft_size);
+
+    const int grid_samples = d_fft_size * d_num_doppler_bins;
+    const int blocks = std::min((grid_samples + d_threads_per_block - 1) / d_threads_per_block, 4096);
+    bool ok = acqErrchk(cudaMemcpyAsync(d_in_gpu, d_in_cpu, sizeof(cufftComplex) * d_fft_size,
+            cudaMemcpyHostToDevice, d_stream));
+    acquisition_doppler_wipeoff<<<blocks, d_threads_per_block, 0, d_stream>>>(
+            d_spectra_gpu, d_in_gpu, d_phase_steps_gpu, d_fft_size, d_num_doppler_bins);
+    ok = ok && acqErrchk(cudaGetLastError());
+    ok = ok && acqFftErrchk(cufftExecC2C(d_plan_bins, d_spectra_gpu, d_spectra_gpu, CUFFT_FORWARD));
+
+    // The spectra of the input are shared by all the codes
+    for (int i = 0; i < n_slots && ok; i++)
+        {
+            acquisition_code_product<<<blocks, d_threads_per_block, 0, d_stream>>>(
+                    d_product_gpu, d_spectra_gpu, d_code_spectra_gpu + slots[i] * d_fft_size,
+                    d_fft_size, d_num_doppler_bins);
+            ok = ok && acqErrchk(cudaGetLastError());
+            ok = ok && acqFftErrchk(cufftExecC2C(d_plan_bins, d_product_gpu, d_product_gpu, CUFFT_INVERSE));
+            acquisition_peak_search<<<d_num_doppler_bins, d_threads_per_block,
+                    d_threads_per_block * sizeof(cuda_acquisition_peak), d_stream>>>(
+                    d_peaks_gpu + i * d_num_doppler_bins, d_product_gpu, d_fft_size);
+            ok = ok && acqErrchk(cudaGetLastError());
+        }
+    ok = ok && acqErrchk(cudaMemcpyAsync(d_peaks_cpu, d_peaks_gpu, sizeof(cuda_acquisition_peak) * d_num_doppler_bins * n_slots,
+            cudaMemcpyDeviceToHost, d_stream));
+    ok = ok && acqErrchk(cudaEventRecord(d_search_done, d_stream));
+    return ok;
+}
+
+
+bool cuda_acquisition_engine::wait()
+{
+    if (d_in_gpu == 0) return false;
+    cudaSetDevice(d_device);
+    return acqErrchk(cudaEventSynchronize(d_search_done));
+}
+
+
+bool cuda_acquisition_engine::free_cuda()
+{
+    if (d_in_cpu == 0 && d_in_gpu == 0 && d_stream == 0) return true;
+    cudaSetDevice(d_device);
+    if (d_stream != 0) cudaStreamSynchronize(d_stream);
+    if (d_plans_created)
+        {
+            cufftDestroy(d_plan_bins);
+            cufftDestroy(d_plan_code);
+        }
+    if (d_in_cpu != 0) cudaFreeHost(d_in_cpu);
+    if (d_in_gpu != 0) cudaFree(d_in_gpu);
+    if (d_phase_steps_gpu != 0) cudaFree(d_phase_steps_gpu);
+    if (d_spectra_gpu != 0) cudaFree(d_spectra_gpu);
+    if (d_product_gpu != 0) cudaFree(d_product_gpu);
+    if (d_code_spectra_gpu != 0) cudaFree(d_code_spectra_gpu);
+    if (d_peaks_gpu != 0) cudaFree(d_peaks_gpu);
+    if (d_peaks_cpu != 0) cudaFreeHost(d_peaks_cpu);
+    if (d_search_done != 0) cudaEventDestroy(d_search_done);
+    if (d_stream != 0) cudaStreamDestroy(d_stream);
+    d_in_cpu = 0;
+    d_in_gpu = 0;
+    d_phase_steps_gpu = 0;
+    d_spectra_gpu = 0;
+    d_product_gpu = 0;
+    d_code_spectra_gpu = 0;
+    d_peaks_gpu = 0;
+    d_peaks_cpu = 0;
+    d_plans_created = false;
+    d_search_done = 0;
+    d_stream = 0;
+    return true;
+}
@@ -0,0 +1,141 @@
+/*!
+ * \file cuda_acquisition_engine.h
+ * \brief Parallel code phase search of many codes over a whole Doppler grid
+ *  on a CUDA GPU, with batched cuFFT plans and device-resident code spectra.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * One search takes a single input window. The window goes to the device
+ * through a pinned buffer, and everything else stays there: the carrier is
+ * wiped off for all the Doppler bins in one kernel, a cuFFT plan batched
+ * over the bins computes all their spectra at once, and then, for every
+ * code, a product with its conjugated spectrum (computed on the device when
+ * the code is set), one batched inverse FFT and a reduction that finds the
+ * peak of each bin. Only those peaks, one value and one index per code and
+ * bin, are copied back to the host.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CUDA_ACQUISITION_ENGINE_H_
+#define GNSS_SDR_CUDA_ACQUISITION_ENGINE_H_
+
+#include <complex>
+#include <cuda.h>
+#include <cuda_runtime.h>
+#include <cufft.h>
+
+//! Peak of the correlation in one Doppler bin
+struct cuda_acquisition_peak
+{
+    float magnitude;    // |IFFT|^2, not normalized, as the FFTW based blocks
+    int index;          // sample of the peak, the first one if there are ties
+};
+
+
+/*!
+ * \brief PCPS acquisition of many codes at once on a GPU.
+ *
+ * Usage: init(), set_doppler_grid(), set_local_code() once per code slot,
+ * and then search_async() followed by wait() for each input window. The
+ * peaks of the i-th slot given to search_async() are in peaks(i). The
+ * class is not thread-safe.
+ */
+class cuda_acquisition_engine
+{
+public:
+    cuda_acquisition_engine();
+    ~cuda_acquisition_engine();
+
+    /*!
+     * \brief Selects the device, allocates all the device buffers and builds
+     * the cuFFT plans.
+     * \param fft_size - samples of an input window, and of every code.
+     * \param num_doppler_bins - bins of the Doppler grid.
+     * \param max_codes - codes kept on the device.
+     * \param device - CUDA device to use, or -1 for the one with most
+     *  multiprocessors.
+     */
+    bool init(int fft_size, int num_doppler_bins, int max_codes, int device = -1);
+
+    //! Sets the carrier of each Doppler bin, as its phase step per sample [rad]
+    bool set_doppler_grid(const float* phase_step_rad);
+
+    //! Uploads the code of a slot and computes its conjugated spectrum on the device
+    bool set_local_code(int slot, const std::complex<float>* code);
+
+    //! Launches the search of an input window for n_slots code slots and returns immediately
+    bool search_async(const std::complex<float>* in, const int* slots, int n_slots);
+
+    //! Waits for the last search_async()
+    bool wait();
+
+    //! Peak of every Doppler bin for the i-th slot of the last search
+    const cuda_acquisition_peak* peaks(int i) const
+    {
+        return d_peaks_cpu + i * d_num_doppler_bins;
+    }
+
+    int fft_size() const
+    {
+        return d_fft_size;
+    }
+
+    int num_doppler_bins() const
+    {
+        return d_num_doppler_bins;
+    }
+
+    int max_codes() const
+    {
+        return d_max_codes;
+    }
+
+    bool free_cuda();
+
+private:
+    int d_device;
+    int d_fft_size;
+    int d_num_doppler_bins;
+    int d_max_codes;
+
+    cufftComplex* d_in_cpu;             // pinned
+    cufftComplex* d_in_gpu;
+    float* d_phase_steps_gpu;
+    cufftComplex* d_spectra_gpu;        // wiped off input of every bin, and then its spectrum
+    cufftComplex* d_product_gpu;        // every bin of one code, and then their correlations
+    cufftComplex* d_code_spectra_gpu;   // max_codes conjugated code spectra
+    cuda_acquisition_peak* d_peaks_gpu;
+    cuda_acquisition_peak* d_peaks_cpu; // pinned
+
+    cufftHandle d_plan_bins;            // batched over the Doppler bins
+    cufftHandle d_plan_code;
+    bool d_plans_created;
+
+    cudaStream_t d_stream;
+    cudaEvent_t d_search_done;
+    int d_threads_per_block;
+};
+
+#endif /* GNSS_SDR_CUDA_ACQUISITION_ENGINE_H_ */
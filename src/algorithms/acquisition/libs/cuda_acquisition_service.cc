@@ -0,0 +1,206 @@
+/*!
+ * \file cuda_acquisition_service.cc
+ * \brief GPU acquisition engine shared by all the channels that search the
+ *  same input with the same Doppler grid.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "cuda_acquisition_service.h"
+#include <cmath>
+#include <glog/logging.h>
+#include "GPS_L1_CA.h"
+
+using google::LogMessage;
+
+
+Cuda_Acquisition_Service::Cuda_Acquisition_Service(long fs_in, long freq, unsigned int fft_size,
+        unsigned int doppler_max, unsigned int doppler_step,
+        unsigned int num_bins, unsigned int max_codes) :
+        d_ready(false),
+        d_num_bins(num_bins),
+        d_used(max_codes, false),
+        d_armed(max_codes, false),
+        d_hits(0)
+{
+    if (!d_engine.init(fft_size, num_bins, max_codes))
+        {
+            LOG(ERROR) << "No CUDA device available for the acquisition";
+            return;
+        }
+    std::vector<float> phase_steps(num_bins);
+    for (unsigned int i = 0; i < num_bins; i++)
+        {
+            const int doppler = -static_cast<int>(doppler_max) + doppler_step * i;
+            phase_steps[i] = static_cast<float>(GPS_TWO_PI * (static_cast<double>(freq) + doppler) / static_cast<double>(fs_in));
+        }
+    d_ready = d_engine.set_doppler_grid(phase_steps.data());
+}
+
+
+int Cuda_Acquisition_Service::add_code(const std::complex<float>* code)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    if (!d_ready) return -1;
+    for (unsigned int slot = 0; slot < d_used.size(); slot++)
+        {
+            if (!d_used[slot])
+                {
+                    if (!d_engine.set_local_code(slot, code)) return -1;
+                    d_used[slot] = true;
+                    d_armed[slot] = false;
+                    return slot;
+                }
+        }
+    LOG(WARNING) << "All the " << d_used.size() << " code slots of the CUDA acquisition are in use";
+    return -1;
+}
+
+
+bool Cuda_Acquisition_Service::set_local_code(int slot, const std::complex<float>* code)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    if (!d_ready || slot < 0 || slot >= static_cast<int>(d_used.size())) return false;
+    // The stored peaks of this slot were computed with the old code
+    for (auto it = d_results.begin(); it != d_results.end(); ++it)
+        {
+            it->second.erase(slot);
+        }
+    return d_engine.set_local_code(slot, code);
+}
+
+
+void Cuda_Acquisition_Service::remove_code(int slot)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    if (slot < 0 || slot >= static_cast<int>(d_used.size())) return;
+    for (auto it = d_results.begin(); it != d_results.end(); ++it)
+        {
+            it->second.erase(slot);
+        }
+    d_used[slot] = false;
+    d_armed[slot] = false;
+}
+
+
+void Cuda_Acquisition_Service::arm(int slot, bool armed)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    if (slot < 0 || slot >= static_cast<int>(d_used.size())) return;
+    d_armed[slot] = armed && d_used[slot];
+}
+
+
+bool Cuda_Acquisition_Service::search(int slot, unsigned long int window, const std::complex<float>* in,
+        std::vector<cuda_acquisition_peak>& peaks)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    if (!d_ready || slot < 0 || slot >= static_cast<int>(d_used.size()) || !d_used[slot]) return false;
+
+    auto it = d_results.find(window);
+    if (it != d_results.end())
+        {
+            auto found = it->second.find(slot);
+            if (found != it->second.end())
+                {
+                    peaks = found->second;
+                    d_hits++;
+                    return true;
+                }
+        }
+
+    // A new window is searched for every armed slot, an already stored one
+    // only for the caller
+    std::vector<int> slots;
+    if (it == d_results.end())
+        {
+            for (unsigned int i = 0; i < d_armed.size(); i++)
+                {
+                    if (d_armed[i] && static_cast<int>(i) != slot) slots.push_back(i);
+                }
+        }
+    slots.insert(slots.begin(), slot);
+    if (!run_batch(window, in, slots)) return false;
+    peaks = d_results[window][slot];
+    return true;
+}
+
+
+bool Cuda_Acquisition_Service::run_batch(unsigned long int window, const std::complex<float>* in,
+        const std::vector<int>& slots)
+{
+    if (!d_engine.search_async(in, slots.data(), slots.size()) || !d_engine.wait())
+        {
+            return false;
+        }
+    if (d_results.find(window) == d_results.end())
+        {
+            d_order.push_back(window);
+            if (d_order.size() > max_windows)
+                {
+                    d_results.erase(d_order.front());
+                    d_order.pop_front();
+                }
+        }
+    std::map<int, std::vector<cuda_acquisition_peak> >& result = d_results[window];
+    for (unsigned int i = 0; i < slots.size(); i++)
+        {
+            const cuda_acquisition_peak* p = d_engine.peaks(i);
+            result[slots[i]].assign(p, p + d_num_bins);
+        }
+    return true;
+}
+
+
+unsigned long int Cuda_Acquisition_Service::hits()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_hits;
+}
+
+
+Cuda_Acquisition_Service_Store& Cuda_Acquisition_Service_Store::instance()
+{
+    static Cuda_Acquisition_Service_Store store;
+    return store;
+}
+
+
+std::shared_ptr<Cuda_Acquisition_Service> Cuda_Acquisition_Service_Store::get(unsigned int rf_channel,
+        long fs_in, long freq, unsigned int fft_size, unsigned int doppler_max,
+        unsigned int doppler_step, unsigned int num_bins)
+{
+    key_type key = std::make_tuple(rf_channel, fs_in, freq, fft_size, doppler_max, doppler_step, num_bins);
+    boost::mutex::scoped_lock lock(d_mutex);
+    std::shared_ptr<Cuda_Acquisition_Service> service = d_services[key].lock();
+    if (!service)
+        {
+            service = std::make_shared<Cuda_Acquisition_Service>(fs_in, freq, fft_size,
+                    doppler_max, doppler_step, num_bins, max_codes);
+            d_services[key] = service;
+        }
+    return service;
+}
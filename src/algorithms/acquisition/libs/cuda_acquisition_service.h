@@ -0,0 +1,148 @@
+/*!
+ * \file cuda_acquisition_service.h
+ * \brief GPU acquisition engine shared by all the channels that search the
+ *  same input with the same Doppler grid.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Each channel keeps its own acquisition block, its events port and its
+ * state machine, as in Input_Spectrum_Store: the batching happens
+ * underneath. Every channel takes a code slot in the service, and arms it
+ * while it is searching. The first channel that asks for an input window
+ * searches it for ALL the armed slots in one batch on the GPU, and the
+ * other channels just take their peaks from the stored result, so a
+ * full-sky search costs a single upload and a single set of input FFTs.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CUDA_ACQUISITION_SERVICE_H_
+#define GNSS_SDR_CUDA_ACQUISITION_SERVICE_H_
+
+#include <complex>
+#include <deque>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+#include "cuda_acquisition_engine.h"
+
+/*!
+ * \brief Thread-safe front end of a cuda_acquisition_engine for many channels.
+ *
+ * Only the peaks of the last few windows are retained. A channel that asks
+ * for an evicted window, or for a window that was searched before it armed
+ * its slot, searches it again, so batching never changes the results.
+ */
+class Cuda_Acquisition_Service
+{
+public:
+    Cuda_Acquisition_Service(long fs_in, long freq, unsigned int fft_size,
+            unsigned int doppler_max, unsigned int doppler_step,
+            unsigned int num_bins, unsigned int max_codes);
+
+    //! False if there is no usable CUDA device
+    bool ready() const
+    {
+        return d_ready;
+    }
+
+    //! Takes a free code slot and uploads the code. Returns -1 if there is none
+    int add_code(const std::complex<float>* code);
+
+    //! Replaces the code of a slot, e.g. when a new satellite is assigned
+    bool set_local_code(int slot, const std::complex<float>* code);
+
+    //! Frees a code slot
+    void remove_code(int slot);
+
+    //! Armed slots are searched in every batch
+    void arm(int slot, bool armed);
+
+    /*!
+     * \brief Returns the peak of every Doppler bin of a slot for an input window.
+     * \param slot   Code slot of the caller
+     * \param window Index of the window in the input stream (nitems_read of the caller)
+     * \param in     fft_size input samples of the window
+     * \param peaks  num_bins peaks, as given by cuda_acquisition_engine
+     */
+    bool search(int slot, unsigned long int window, const std::complex<float>* in,
+            std::vector<cuda_acquisition_peak>& peaks);
+
+    //! Number of searches served without running the GPU
+    unsigned long int hits();
+
+private:
+    Cuda_Acquisition_Service(const Cuda_Acquisition_Service&);
+    Cuda_Acquisition_Service& operator=(const Cuda_Acquisition_Service&);
+
+    bool run_batch(unsigned long int window, const std::complex<float>* in, const std::vector<int>& slots);
+
+    static const size_t max_windows = 16;
+    cuda_acquisition_engine d_engine;
+    bool d_ready;
+    unsigned int d_num_bins;
+    std::vector<bool> d_used;
+    std::vector<bool> d_armed;
+    // window -> slot -> peaks of its bins
+    std::map<unsigned long int, std::map<int, std::vector<cuda_acquisition_peak> > > d_results;
+    std::deque<unsigned long int> d_order;
+    unsigned long int d_hits;
+    boost::mutex d_mutex;
+};
+
+
+/*!
+ * \brief Process-wide store of acquisition services keyed by
+ * (RF channel, fs, IF, FFT size, doppler_max, doppler_step, number of bins).
+ *
+ * As in Doppler_Grid_Store, a service is released as soon as the last
+ * acquisition block using it is destroyed.
+ */
+class Cuda_Acquisition_Service_Store
+{
+public:
+    //! Returns the store shared by the whole process
+    static Cuda_Acquisition_Service_Store& instance();
+
+    //! Returns the service for the given input and grid, creating it if no block holds it yet
+    std::shared_ptr<Cuda_Acquisition_Service> get(unsigned int rf_channel, long fs_in, long freq,
+            unsigned int fft_size, unsigned int doppler_max, unsigned int doppler_step,
+            unsigned int num_bins);
+
+    //! Code slots of every service, enough for all the GPS, Galileo and SBAS PRNs
+    static const unsigned int max_codes = 64;
+
+private:
+    Cuda_Acquisition_Service_Store() {}
+    Cuda_Acquisition_Service_Store(const Cuda_Acquisition_Service_Store&);
+    Cuda_Acquisition_Service_Store& operator=(const Cuda_Acquisition_Service_Store&);
+
+    typedef std::tuple<unsigned int, long, long, unsigned int, unsigned int, unsigned int, unsigned int> key_type;
+    std::map<key_type, std::weak_ptr<Cuda_Acquisition_Service> > d_services;
+    boost::mutex d_mutex;
+};
+
+#endif /* GNSS_SDR_CUDA_ACQUISITION_SERVICE_H_ */
@@ -43,11 +43,10 @@ using google::LogMessage;
 
 // Constructor
 Channel::Channel(ConfigurationInterface *configuration, unsigned int channel,
-        std::shared_ptr<GNSSBlockInterface> pass_through, std::shared_ptr<AcquisitionInterface> acq,
+        std::shared_ptr<AcquisitionInterface> acq,
         std::shared_ptr<TrackingInterface> trk, std::shared_ptr<TelemetryDecoderInterface> nav,
         std::string role, std::string implementation, boost::shared_ptr<gr::msg_queue> queue)
 {
-    pass_through_ = pass_through;
     acq_ = acq;
     trk_ = trk;
     nav_ = nav;
@@ -77,7 +76,10 @@ Channel::Channel(ConfigurationInterface *configuration, unsigned int channel,
 
     acq_->set_threshold(threshold);
 
-    acq_->init();
+    // acq_->init() allocates the search grid and computes the local code of
+    // the current PRN: it is deferred to the first acquisition, so that the
+    // channels in standby do not pay for it
+    acq_initialized_ = false;
 
     repeat_ = configuration->property("Acquisition_" + implementation_ + boost::lexical_cast<std::string>(channel_) + ".repeat_satellite", false);
     DLOG(INFO) << "Channel " << channel_ << " satellite repeat = " << repeat_;
@@ -108,26 +110,21 @@ void Channel::connect(gr::top_block_sptr top_block)
             LOG(WARNING) << "channel already connected internally";
             return;
         }
-    pass_through_->connect(top_block);
     acq_->connect(top_block);
     trk_->connect(top_block);
     nav_->connect(top_block);
 
-    //Synchronous ports
-    top_block->connect(pass_through_->get_right_block(), 0, acq_->get_left_block(), 0);
-    DLOG(INFO) << "pass_through_ -> acquisition";
-    top_block->connect(pass_through_->get_right_block(), 0, trk_->get_left_block(), 0);
-    DLOG(INFO) << "pass_through_ -> tracking";
-    top_block->connect(trk_->get_right_block(), 0, nav_->get_left_block(), 0);
+    //Synchronous ports, the input is wired by connect_input()
+    top_block->connect(trk_->get_right_block(), trk_->port(), nav_->get_left_block(), 0);
     DLOG(INFO) << "tracking -> telemetry_decoder";
 
     // Message ports
-    top_block->msg_connect(nav_->get_left_block(), pmt::mp("preamble_timestamp_s"), trk_->get_right_block(), pmt::mp("preamble_timestamp_s"));
+    top_block->msg_connect(nav_->get_left_block(), pmt::mp("preamble_timestamp_s"), trk_->get_right_block(), pmt::mp(trk_->message_port("preamble_timestamp_s")));
     DLOG(INFO) << "MSG FEEDBACK CHANNEL telemetry_decoder -> tracking";
 
     //std::cout<<"has port: "<<trk_->get_right_block()->has_msg_port(pmt::mp("events"))<<std::endl;
     top_block->msg_connect(acq_->get_right_block(), pmt::mp("events"), channel_msg_rx, pmt::mp("events"));
-    top_block->msg_connect(trk_->get_right_block(), pmt::mp("events"), channel_msg_rx, pmt::mp("events"));
+    top_block->msg_connect(trk_->get_right_block(), pmt::mp(trk_->message_port("events")), channel_msg_rx, pmt::mp("events"));
 
     connected_ = true;
 }
@@ -140,10 +137,7 @@ void Channel::disconnect(gr::top_block_sptr top_block)
             LOG(WARNING) << "Channel already disconnected internally";
             return;
         }
-    top_block->disconnect(pass_through_->get_right_block(), 0, acq_->get_left_block(), 0);
-    top_block->disconnect(pass_through_->get_right_block(), 0, trk_->get_left_block(), 0);
-    top_block->disconnect(trk_->get_right_block(), 0, nav_->get_left_block(), 0);
-    pass_through_->disconnect(top_block);
+    top_block->disconnect(trk_->get_right_block(), trk_->port(), nav_->get_left_block(), 0);
     acq_->disconnect(top_block);
     trk_->disconnect(top_block);
     nav_->disconnect(top_block);
@@ -151,9 +145,20 @@ void Channel::disconnect(gr::top_block_sptr top_block)
 }
 
 
+void Channel::connect_input(gr::top_block_sptr top_block, gr::basic_block_sptr source, int port)
+{
+    // GNU Radio fans an output out to all its readers from the same buffer
+    top_block->connect(source, port, acq_->get_left_block(), 0);
+    DLOG(INFO) << "input -> acquisition";
+    // the tracking block may be shared by a group of channels
+    top_block->connect(source, port, trk_->get_left_block(), trk_->port());
+    DLOG(INFO) << "input -> tracking";
+}
+
+
 gr::basic_block_sptr Channel::get_left_block()
 {
-    return pass_through_->get_left_block();
+    return acq_->get_left_block();
 }
 
 
@@ -172,13 +177,31 @@ void Channel::set_signal(const Gnss_Signal& gnss_signal)
     gnss_synchro_.Signal[2] = 0; // make sure that string length is only two characters
     gnss_synchro_.PRN = gnss_signal_.get_satellite().get_PRN();
     gnss_synchro_.System = gnss_signal_.get_satellite().get_system_short().c_str()[0];
-    acq_->set_local_code();
+    if (acq_initialized_)
+        {
+            acq_->set_local_code();
+        }
     nav_->set_satellite(gnss_signal_.get_satellite());
 }
 
 
 void Channel::start_acquisition()
 {
+    if (!acq_initialized_)
+        {
+            acq_->init(); // also sets the local code
+            acq_initialized_ = true;
+        }
     channel_fsm_.Event_start_acquisition();
 }
 
+
+bool Channel::stop_tracking()
+{
+    if (channel_fsm_.state() != channel_tracking_fsm_S2)
+        {
+            return false;
+        }
+    return trk_->stop_tracking();
+}
+
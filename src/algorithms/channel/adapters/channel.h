@@ -61,7 +61,7 @@ class Channel: public ChannelInterface
 public:
     //! Constructor
     Channel(ConfigurationInterface *configuration, unsigned int channel,
-            std::shared_ptr<GNSSBlockInterface> pass_through, std::shared_ptr<AcquisitionInterface> acq,
+            std::shared_ptr<AcquisitionInterface> acq,
             std::shared_ptr<TrackingInterface> trk, std::shared_ptr<TelemetryDecoderInterface> nav,
             std::string role, std::string implementation,
             boost::shared_ptr<gr::msg_queue> queue);
@@ -69,6 +69,12 @@ public:
     virtual ~Channel();
     void connect(gr::top_block_sptr top_block);
     void disconnect(gr::top_block_sptr top_block);
+
+    /*!
+     * \brief Connects port \p port of \p source to the acquisition and to the tracking
+     * of the channel, so they read the conditioned stream without any copy in between
+     */
+    void connect_input(gr::top_block_sptr top_block, gr::basic_block_sptr source, int port);
     gr::basic_block_sptr get_left_block();
     gr::basic_block_sptr get_right_block();
     std::string role(){ return role_; }
@@ -82,13 +88,13 @@ public:
     std::shared_ptr<TelemetryDecoderInterface> telemetry(){ return nav_; }
     void start_acquisition();                   //!< Start the State Machine
     void set_signal(const Gnss_Signal& gnss_signal_);  //!< Sets the channel GNSS signal
+    bool stop_tracking();                       //!< Stops the tracking, the state machine sees a loss of lock
 
     void msg_handler_events(pmt::pmt_t msg);
 
 
 private:
     channel_msg_receiver_cc_sptr channel_msg_rx;
-    std::shared_ptr<GNSSBlockInterface> pass_through_;
     std::shared_ptr<AcquisitionInterface> acq_;
     std::shared_ptr<TrackingInterface> trk_;
     std::shared_ptr<TelemetryDecoderInterface> nav_;
@@ -99,6 +105,7 @@ private:
     Gnss_Signal gnss_signal_;
     bool connected_;
     bool repeat_;
+    bool acq_initialized_;  // the acquisition is set up when the channel first searches
     ChannelFsm channel_fsm_;
     boost::shared_ptr<gr::msg_queue> queue_;
 };
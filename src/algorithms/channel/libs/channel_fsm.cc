@@ -1,6 +1,6 @@
 /*!
  * \file channel_fsm.cc
- * \brief Implementation of a State Machine for channel using boost::statechart
+ * \brief Implementation of the table-driven State Machine for channel
  * \author Luis Esteve, 2011. luis(at)epsilon-formacion.com
  *
  * -------------------------------------------------------------------------
@@ -29,157 +29,134 @@
  */
 
 #include "channel_fsm.h"
-#include <memory>
-#include <boost/statechart/simple_state.hpp>
-#include <boost/statechart/state.hpp>
-#include <boost/statechart/transition.hpp>
-#include <boost/statechart/custom_reaction.hpp>
-#include <boost/mpl/list.hpp>
 #include <glog/logging.h>
-#include "control_message_factory.h"
+#include "control_event_bus.h"
 
 
-struct Ev_channel_start_acquisition: sc::event<Ev_channel_start_acquisition>
-{};
-
-struct Ev_channel_valid_acquisition: sc::event<Ev_channel_valid_acquisition>
-{};
-
-struct Ev_channel_failed_acquisition_repeat: sc::event<Ev_channel_failed_acquisition_repeat>
-{};
-
-struct Ev_channel_failed_acquisition_no_repeat: sc::event<Ev_channel_failed_acquisition_no_repeat>
-{};
-
-struct Ev_channel_failed_tracking_standby: sc::event<Ev_channel_failed_tracking_standby>
-{};
-
-//struct Ev_channel_failed_tracking_reacq: sc::event<Ev_channel_failed_tracking_reacq>
-//{};
+namespace
+{
+const int CHANNEL_FSM_STATES = 4;
+const int CHANNEL_FSM_EVENTS = 5;
+const int NO_TRANSITION = -1;
 
-struct channel_idle_fsm_S0: public sc::state<channel_idle_fsm_S0, ChannelFsm>
+// Next state of each state (rows) for each event (columns, in the order of Channel_Fsm_Event)
+const signed char transitions[CHANNEL_FSM_STATES][CHANNEL_FSM_EVENTS] =
 {
-public:
-    // sc::transition(event, next state)
-    typedef sc::transition<Ev_channel_start_acquisition, channel_acquiring_fsm_S1> reactions;
-    channel_idle_fsm_S0(my_context ctx) : my_base(ctx)
-    {
-        //std::cout << "Enter Channel_Idle_S0 " << std::endl;
-    }
+    // start_acq                 valid_acq                 failed_acq_repeat         failed_acq_no_repeat     failed_trk_standby
+    { channel_acquiring_fsm_S1, NO_TRANSITION,            NO_TRANSITION,            NO_TRANSITION,           NO_TRANSITION },        // S0 idle
+    { NO_TRANSITION,            channel_tracking_fsm_S2,  channel_acquiring_fsm_S1, channel_waiting_fsm_S3,  NO_TRANSITION },        // S1 acquiring
+    { channel_acquiring_fsm_S1, NO_TRANSITION,            NO_TRANSITION,            NO_TRANSITION,           channel_idle_fsm_S0 },  // S2 tracking
+    { channel_acquiring_fsm_S1, NO_TRANSITION,            NO_TRANSITION,            NO_TRANSITION,           NO_TRANSITION }         // S3 waiting
 };
+}
 
 
-struct channel_acquiring_fsm_S1: public sc::state<channel_acquiring_fsm_S1, ChannelFsm>
+ChannelFsm::ChannelFsm() : state_(channel_idle_fsm_S0)
 {
-public:
-    typedef mpl::list<sc::transition<Ev_channel_failed_acquisition_no_repeat, channel_waiting_fsm_S3>,
-                      sc::transition<Ev_channel_failed_acquisition_repeat, channel_acquiring_fsm_S1>,
-                      sc::transition<Ev_channel_valid_acquisition, channel_tracking_fsm_S2> > reactions;
+    acq_ = nullptr;
+    trk_ = nullptr;
+    channel_ = 0;
+}
 
-    channel_acquiring_fsm_S1(my_context ctx) : my_base(ctx)
-    {
-        //std::cout << "Enter Channel_Acq_S1 " << std::endl;
-        context<ChannelFsm> ().start_acquisition();
-    }
-    ~channel_acquiring_fsm_S1()
-    {
-        //std::cout << "Exit Channel_Acq_S1 " << std::endl;
-    }
-};
 
 
-struct channel_tracking_fsm_S2: public sc::state<channel_tracking_fsm_S2, ChannelFsm>
+ChannelFsm::ChannelFsm(std::shared_ptr<AcquisitionInterface> acquisition) :
+            acq_(acquisition), state_(channel_idle_fsm_S0)
 {
-public:
-    typedef mpl::list<sc::transition<Ev_channel_failed_tracking_standby, channel_idle_fsm_S0>,
-                      sc::transition<Ev_channel_start_acquisition, channel_acquiring_fsm_S1>> reactions;
+    trk_ = nullptr;
+    channel_ = 0;
+}
 
-    channel_tracking_fsm_S2(my_context ctx) : my_base(ctx)
-    {
-       //std::cout << "Enter Channel_tracking_S2 " << std::endl;
-        context<ChannelFsm> ().start_tracking();
-    }
 
-    ~channel_tracking_fsm_S2()
-    {
-        //std::cout << "Exit Channel_tracking_S2 " << std::endl;
-        context<ChannelFsm> ().notify_stop_tracking();
-    }
+bool ChannelFsm::process_event(Channel_Fsm_Event event)
+{
+    int current = state_.load(std::memory_order_acquire);
+    int next;
+    do
+        {
+            if (current >= CHANNEL_FSM_STATES || event >= CHANNEL_FSM_EVENTS)
+                {
+                    return false;
+                }
+            next = transitions[current][event];
+            if (next == NO_TRANSITION)
+                {
+                    DLOG(INFO) << "Channel " << channel_ << ": event " << event << " discarded in state S" << current;
+                    return false;
+                }
+        }
+    while (!state_.compare_exchange_weak(current, next, std::memory_order_acq_rel, std::memory_order_acquire));
 
-};
+    // A transition to the same state leaves it and enters it again
+    leave(current);
+    enter(next);
+    return true;
+}
 
 
-struct channel_waiting_fsm_S3: public sc::state<channel_waiting_fsm_S3, ChannelFsm>
+void ChannelFsm::enter(int state)
 {
-public:
-    typedef sc::transition<Ev_channel_start_acquisition,
-            channel_acquiring_fsm_S1> reactions;
-
-    channel_waiting_fsm_S3(my_context ctx) :
-        my_base(ctx)
+    switch (state)
     {
-        //std::cout << "Enter Channel_waiting_S3 " << std::endl;
-        context<ChannelFsm> ().request_satellite();
+    case channel_acquiring_fsm_S1:
+        start_acquisition();
+        break;
+    case channel_tracking_fsm_S2:
+        start_tracking();
+        break;
+    case channel_waiting_fsm_S3:
+        request_satellite();
+        break;
+    default:
+        break;
     }
-   // ~channel_waiting_fsm_S3(){}
-};
-
+}
 
 
-ChannelFsm::ChannelFsm()
+void ChannelFsm::leave(int state)
 {
-    acq_ = nullptr;
-    trk_ = nullptr;
-    channel_ = 0;
-    initiate(); //start the FSM
+    if (state == channel_tracking_fsm_S2)
+        {
+            notify_stop_tracking();
+        }
 }
 
 
-
-ChannelFsm::ChannelFsm(std::shared_ptr<AcquisitionInterface> acquisition) :
-            acq_(acquisition)
+void ChannelFsm::terminate()
 {
-    trk_ = nullptr;
-    channel_ = 0;
-    initiate(); //start the FSM
+    int current = state_.exchange(channel_terminated_fsm, std::memory_order_acq_rel);
+    leave(current);
 }
 
 
-
 void ChannelFsm::Event_start_acquisition()
 {
-    this->process_event(Ev_channel_start_acquisition());
-    //std::cout<<"Ev_channel_start_acquisition launched"<<std::endl;
+    process_event(Ev_channel_start_acquisition);
 }
 
 
 void ChannelFsm::Event_valid_acquisition()
 {
-    this->process_event(Ev_channel_valid_acquisition());
+    process_event(Ev_channel_valid_acquisition);
 }
 
 
 void ChannelFsm::Event_failed_acquisition_repeat()
 {
-    this->process_event(Ev_channel_failed_acquisition_repeat());
+    process_event(Ev_channel_failed_acquisition_repeat);
 }
 
 void ChannelFsm::Event_failed_acquisition_no_repeat()
 {
-    this->process_event(Ev_channel_failed_acquisition_no_repeat());
+    process_event(Ev_channel_failed_acquisition_no_repeat);
 }
 
 
-// Something is wrong here, we are using a memory after it ts freed
 void ChannelFsm::Event_failed_tracking_standby()
 {
-    this->process_event(Ev_channel_failed_tracking_standby());
+    process_event(Ev_channel_failed_tracking_standby);
 }
 
-//void ChannelFsm::Event_failed_tracking_reacq() {
-//    this->process_event(Ev_channel_failed_tracking_reacq());
-//}
-
 void ChannelFsm::set_acquisition(std::shared_ptr<AcquisitionInterface> acquisition)
 {
     acq_ = acquisition;
@@ -208,27 +185,15 @@ void ChannelFsm::start_acquisition()
 void ChannelFsm::start_tracking()
 {
     trk_->start_tracking();
-    std::unique_ptr<ControlMessageFactory> cmf(new ControlMessageFactory());
-    if (queue_ != gr::msg_queue::make())
-        {
-            queue_->handle(cmf->GetQueueMessage(channel_, 1));
-        }
+    Control_Event_Bus::send(queue_, channel_, Control_Event_Bus::acquisition_success);
 }
 
 void ChannelFsm::request_satellite()
 {
-    std::unique_ptr<ControlMessageFactory> cmf(new ControlMessageFactory());
-    if (queue_ != gr::msg_queue::make())
-        {
-            queue_->handle(cmf->GetQueueMessage(channel_, 0));
-        }
+    Control_Event_Bus::send(queue_, channel_, Control_Event_Bus::acquisition_failed);
 }
 
 void ChannelFsm::notify_stop_tracking()
 {
-    std::unique_ptr<ControlMessageFactory> cmf(new ControlMessageFactory());
-    if (queue_ != gr::msg_queue::make())
-        {
-            queue_->handle(cmf->GetQueueMessage(channel_, 2));
-        }
+    Control_Event_Bus::send(queue_, channel_, Control_Event_Bus::loss_of_lock);
 }
@@ -1,6 +1,6 @@
 /*!
  * \file channel_fsm.h
- * \brief Interface of the State Machine for channel using boost::statechart
+ * \brief Interface of the table-driven State Machine for channel
  * \author Luis Esteve, 2011. luis(at)epsilon-formacion.com
  *
  *
@@ -32,26 +32,47 @@
 #ifndef GNSS_SDR_CHANNEL_FSM_H
 #define GNSS_SDR_CHANNEL_FSM_H
 
-
-#include <boost/statechart/state_machine.hpp>
+#include <atomic>
+#include <memory>
 #include <gnuradio/msg_queue.h>
 #include "acquisition_interface.h"
 #include "tracking_interface.h"
 #include "telemetry_decoder_interface.h"
 
 
-namespace sc = boost::statechart;
-namespace mpl = boost::mpl;
+//! States of the channel
+enum Channel_Fsm_State
+{
+    channel_idle_fsm_S0 = 0,
+    channel_acquiring_fsm_S1,
+    channel_tracking_fsm_S2,
+    channel_waiting_fsm_S3,
+    channel_terminated_fsm     //!< after terminate(), all the events are ignored
+};
 
-struct channel_idle_fsm_S0;
-struct channel_acquiring_fsm_S1;
-struct channel_tracking_fsm_S2;
-struct channel_waiting_fsm_S3;
+//! Events of the channel
+enum Channel_Fsm_Event
+{
+    Ev_channel_start_acquisition = 0,
+    Ev_channel_valid_acquisition,
+    Ev_channel_failed_acquisition_repeat,
+    Ev_channel_failed_acquisition_no_repeat,
+    Ev_channel_failed_tracking_standby
+};
 
 /*!
- * \brief This class implements a State Machine for channel using boost::statechart
+ * \brief This class implements a State Machine for channel with a transition table
+ *
+ * The next state is looked up in a table of states by events, and an event
+ * without a transition from the current state is discarded. The state is
+ * an atomic value, updated with a compare-and-swap, so events from the
+ * message handlers and from the control thread need neither a lock nor
+ * any allocation. The actions are those of the states:
+ * entering S1 resets the acquisition (also when S1 is entered again),
+ * entering S2 starts the tracking and reports acquisition_success,
+ * leaving S2 reports loss_of_lock, and entering S3 reports acquisition_failed.
  */
-class ChannelFsm: public sc::state_machine<ChannelFsm, channel_idle_fsm_S0>
+class ChannelFsm
 {
 public:
     ChannelFsm();
@@ -74,11 +95,26 @@ public:
     //void Event_gps_failed_tracking_reacq();
     void Event_failed_tracking_standby();
 
+    //! Returns false if the event has no transition from the current state
+    bool process_event(Channel_Fsm_Event event);
+
+    //! Leaves the current state, running its exit action, and ignores the next events
+    void terminate();
+
+    Channel_Fsm_State state() const
+    {
+        return static_cast<Channel_Fsm_State>(state_.load(std::memory_order_acquire));
+    }
+
 private:
+    void enter(int state);
+    void leave(int state);
+
     std::shared_ptr<AcquisitionInterface> acq_;
     std::shared_ptr<TrackingInterface> trk_;
     boost::shared_ptr<gr::msg_queue> queue_;
     unsigned int channel_;
+    std::atomic<int> state_;
 };
 
 #endif /*GNSS_SDR_CHANNEL_FSM_H*/
@@ -30,6 +30,7 @@
 
 
 #include "channel_msg_receiver_cc.h"
+#include "gnss_sdr_trace.h"
 #include <gnuradio/gr_complex.h>
 #include <gnuradio/io_signature.h>
 #include <glog/logging.h>
@@ -44,6 +45,7 @@ channel_msg_receiver_cc_sptr channel_msg_receiver_make_cc(ChannelFsm* channel_fs
 
 void channel_msg_receiver_cc::msg_handler_events(pmt::pmt_t msg)
 {
+    GNSS_SDR_TRACE_SCOPE("channel_msg_receiver_cc::msg_handler_events");
     try
     {
             long int message = pmt::to_long(msg);
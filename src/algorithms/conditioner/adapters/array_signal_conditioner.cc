@@ -43,6 +43,7 @@ ArraySignalConditioner::ArraySignalConditioner(ConfigurationInterface *configura
                 in_filt_(in_filt), res_(res), role_(role), implementation_(implementation)
 {
     connected_ = false;
+    multibeam_ = in_filt_->get_right_block()->output_signature()->min_streams() > 1;
     if(configuration){ };
 }
 
@@ -62,6 +63,14 @@ void ArraySignalConditioner::connect(gr::top_block_sptr top_block)
         }
     //data_type_adapt_->connect(top_block);
     in_filt_->connect(top_block);
+    if (multibeam_)
+        {
+            // the channels take the beams of the input filter
+            DLOG(INFO) << "Array input_filter with " << in_filt_->get_right_block()->output_signature()->min_streams()
+                       << " beams, the resampler is not used";
+            connected_ = true;
+            return;
+        }
     res_->connect(top_block);
 
     //top_block->connect(data_type_adapt_->get_right_block(), 0, in_filt_->get_left_block(), 0);
@@ -85,6 +94,12 @@ void ArraySignalConditioner::disconnect(gr::top_block_sptr top_block)
             return;
         }
 
+    if (multibeam_)
+        {
+            in_filt_->disconnect(top_block);
+            connected_ = false;
+            return;
+        }
     //top_block->disconnect(data_type_adapt_->get_right_block(), 0,
     //                      in_filt_->get_left_block(), 0);
     top_block->disconnect(in_filt_->get_right_block(), 0,
@@ -108,6 +123,10 @@ gr::basic_block_sptr ArraySignalConditioner::get_left_block()
 
 gr::basic_block_sptr ArraySignalConditioner::get_right_block()
 {
+    if (multibeam_)
+        {
+            return in_filt_->get_right_block();
+        }
     return res_->get_right_block();
 }
 
@@ -46,6 +46,10 @@ class TelemetryDecoderInterface;
 /*!
  * \brief This class wraps blocks to change data_type_adapter, input_filter and resampler
  * to be applied to the input flow of sampled signal.
+ *
+ * If the input filter has more than one output (one beam per channel, as
+ * Beam_Steering_Filter), the resampler is not used and get_right_block()
+ * is the input filter, whose output i feeds the channel i.
  */
 class ArraySignalConditioner: public GNSSBlockInterface
 {
@@ -79,6 +83,7 @@ private:
     std::string role_;
     std::string implementation_;
     bool connected_;
+    bool multibeam_;
     //bool stop_;
 };
 
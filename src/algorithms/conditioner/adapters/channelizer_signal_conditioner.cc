@@ -0,0 +1,130 @@
+/*!
+ * \file channelizer_signal_conditioner.cc
+ * \brief Signal conditioner that splits a wideband stream into several
+ * sub-band streams with a polyphase_channelizer block.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "channelizer_signal_conditioner.h"
+#include <algorithm>
+#include <iostream>
+#include <boost/lexical_cast.hpp>
+#include <gnuradio/blocks/file_sink.h>
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/filter/firdes.h>
+#include <glog/logging.h>
+#include "configuration_interface.h"
+
+using google::LogMessage;
+
+ChannelizerSignalConditioner::ChannelizerSignalConditioner(ConfigurationInterface* configuration,
+        std::string role, unsigned int in_streams, unsigned int out_streams) :
+                role_(role), in_streams_(in_streams), out_streams_(out_streams)
+{
+    std::string default_item_type = "gr_complex";
+    std::string default_dump_filename = "../data/signal_conditioner.dat";
+
+    std::string input_item_type = configuration->property(role_ + ".input_item_type", default_item_type);
+    double sampling_freq = configuration->property(role_ + ".sampling_frequency", 4000000.0);
+    unsigned int channels = configuration->property(role_ + ".channels", 8);
+    unsigned int decimation = configuration->property(role_ + ".decimation_factor", channels / 2);
+    unsigned int sub_bands = configuration->property(role_ + ".sub_bands", 1);
+    double cutoff_freq = configuration->property(role_ + ".cutoff_freq", 0.4 * sampling_freq / std::max(decimation, 1u));
+    double transition_width = configuration->property(role_ + ".transition_width", 0.1 * sampling_freq / std::max(decimation, 1u));
+    dump_ = configuration->property(role_ + ".dump", false);
+    dump_filename_ = configuration->property(role_ + ".dump_filename", default_dump_filename);
+
+    bool cshort_in = false;
+    if (input_item_type.compare("cshort") == 0)
+        {
+            cshort_in = true;
+        }
+    else if (input_item_type.compare(default_item_type) != 0)
+        {
+            LOG(ERROR) << input_item_type << " unrecognized input item type for the channelizer signal conditioner. Using gr_complex";
+        }
+
+    std::vector<double> sub_band_freqs;
+    for (unsigned int i = 0; i < std::max(sub_bands, 1u); i++)
+        {
+            sub_band_freqs.push_back(configuration->property(role_ + ".sub_band" + boost::lexical_cast<std::string>(i) + "_freq", 0.0));
+        }
+
+    std::vector<float> taps = gr::filter::firdes::low_pass(1.0, sampling_freq, cutoff_freq,
+            transition_width, gr::filter::firdes::WIN_BLACKMAN);
+    channelizer_ = make_polyphase_channelizer(cshort_in, channels, decimation, taps, sub_band_freqs, sampling_freq);
+    DLOG(INFO) << "polyphase_channelizer(" << channelizer_->unique_id() << ") with " << taps.size() << " taps";
+
+    for (unsigned int i = 0; i < sub_band_freqs.size(); i++)
+        {
+            if (dump_)
+                {
+                    std::string filename = dump_filename_ + "." + boost::lexical_cast<std::string>(i);
+                    DLOG(INFO) << "Dumping sub-band " << i << " into file " << filename;
+                    std::cout << "Dumping sub-band " << i << " into file " << filename << std::endl;
+                    sinks_.push_back(gr::blocks::file_sink::make(item_size(), filename.c_str()));
+                }
+            else
+                {
+                    sinks_.push_back(gr::blocks::null_sink::make(item_size()));
+                }
+        }
+}
+
+
+ChannelizerSignalConditioner::~ChannelizerSignalConditioner()
+{}
+
+
+void ChannelizerSignalConditioner::connect(gr::top_block_sptr top_block)
+{
+    for (unsigned int i = 0; i < sinks_.size(); i++)
+        {
+            top_block->connect(channelizer_, i, sinks_.at(i), 0);
+        }
+}
+
+
+void ChannelizerSignalConditioner::disconnect(gr::top_block_sptr top_block)
+{
+    for (unsigned int i = 0; i < sinks_.size(); i++)
+        {
+            top_block->disconnect(channelizer_, i, sinks_.at(i), 0);
+        }
+}
+
+
+gr::basic_block_sptr ChannelizerSignalConditioner::get_left_block()
+{
+    return channelizer_;
+}
+
+
+gr::basic_block_sptr ChannelizerSignalConditioner::get_right_block()
+{
+    return channelizer_;
+}
@@ -0,0 +1,87 @@
+/*!
+ * \file channelizer_signal_conditioner.h
+ * \brief Signal conditioner that splits a wideband stream into several
+ * sub-band streams with a polyphase_channelizer block.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * One output per sub-band; ChannelN.sub_band chooses the one read by each
+ * channel. The prototype filter is a windowed low-pass designed from the
+ * cutoff_freq and transition_width properties of the conditioner role.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CHANNELIZER_SIGNAL_CONDITIONER_H_
+#define GNSS_SDR_CHANNELIZER_SIGNAL_CONDITIONER_H_
+
+#include <string>
+#include <vector>
+#include <gnuradio/basic_block.h>
+#include "gnss_block_interface.h"
+#include "polyphase_channelizer.h"
+
+class ConfigurationInterface;
+
+class ChannelizerSignalConditioner: public GNSSBlockInterface
+{
+public:
+    ChannelizerSignalConditioner(ConfigurationInterface* configuration,
+            std::string role, unsigned int in_streams, unsigned int out_streams);
+
+    virtual ~ChannelizerSignalConditioner();
+
+    std::string role()
+    {
+        return role_;
+    }
+
+    //! Returns "Channelizer_Signal_Conditioner"
+    std::string implementation()
+    {
+        return "Channelizer_Signal_Conditioner";
+    }
+
+    size_t item_size()
+    {
+        return sizeof(gr_complex);
+    }
+
+    void connect(gr::top_block_sptr top_block);
+    void disconnect(gr::top_block_sptr top_block);
+    gr::basic_block_sptr get_left_block();
+    gr::basic_block_sptr get_right_block();
+
+private:
+    std::string role_;
+    unsigned int in_streams_;
+    unsigned int out_streams_;
+    bool dump_;
+    std::string dump_filename_;
+    polyphase_channelizer_sptr channelizer_;
+    // every output is connected, whether a channel reads it or not
+    std::vector<gr::basic_block_sptr> sinks_;
+};
+
+#endif // GNSS_SDR_CHANNELIZER_SIGNAL_CONDITIONER_H_
@@ -0,0 +1,212 @@
+/*!
+ * \file fused_signal_conditioner.cc
+ * \brief Signal conditioner made of a single fused_conditioner block.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "fused_signal_conditioner.h"
+#include <iostream>
+#include <boost/lexical_cast.hpp>
+#include <gnuradio/filter/pm_remez.h>
+#include <glog/logging.h>
+#include "configuration_interface.h"
+
+using google::LogMessage;
+
+FusedSignalConditioner::FusedSignalConditioner(ConfigurationInterface* configuration,
+        std::string role, std::string filter_role,
+        unsigned int in_streams, unsigned int out_streams) :
+                role_(role), filter_role_(filter_role), in_streams_(in_streams),
+                out_streams_(out_streams)
+{
+    std::string default_item_type = "gr_complex";
+    std::string default_dump_filename = "../data/signal_conditioner.dat";
+
+    std::string input_item_type = configuration->property(role_ + ".input_item_type", default_item_type);
+    std::string output_item_type = configuration->property(role_ + ".output_item_type", default_item_type);
+    bool remove_dc = configuration->property(role_ + ".remove_dc", false);
+    float dc_alpha = configuration->property(role_ + ".dc_alpha", 0.0001);
+    dump_ = configuration->property(role_ + ".dump", false);
+    dump_filename_ = configuration->property(role_ + ".dump_filename", default_dump_filename);
+
+    double intermediate_freq = configuration->property(filter_role_ + ".IF", 0.0);
+    double sampling_freq = configuration->property(filter_role_ + ".sampling_frequency", 4000000.0);
+    unsigned int decimation = configuration->property(filter_role_ + ".decimation_factor", 1);
+
+    if (input_item_type.compare("byte") == 0)
+        {
+            input_type_ = FUSED_INPUT_BYTE;
+        }
+    else if (input_item_type.compare("ibyte") == 0)
+        {
+            input_type_ = FUSED_INPUT_IBYTE;
+        }
+    else if (input_item_type.compare("short") == 0)
+        {
+            input_type_ = FUSED_INPUT_SHORT;
+        }
+    else if (input_item_type.compare("ishort") == 0)
+        {
+            input_type_ = FUSED_INPUT_ISHORT;
+        }
+    else if (input_item_type.compare("float") == 0)
+        {
+            input_type_ = FUSED_INPUT_FLOAT;
+        }
+    else if (input_item_type.compare("packed_2bit") == 0)
+        {
+            input_type_ = FUSED_INPUT_PACKED_2BIT;
+        }
+    else
+        {
+            if (input_item_type.compare(default_item_type) != 0)
+                {
+                    LOG(ERROR) << input_item_type << " unrecognized input item type for the fused signal conditioner. Using gr_complex";
+                }
+            input_type_ = FUSED_INPUT_GR_COMPLEX;
+        }
+
+    if (output_item_type.compare("cshort") == 0)
+        {
+            output_type_ = FUSED_OUTPUT_CSHORT;
+        }
+    else if (output_item_type.compare("cbyte") == 0)
+        {
+            output_type_ = FUSED_OUTPUT_CBYTE;
+        }
+    else
+        {
+            if (output_item_type.compare(default_item_type) != 0)
+                {
+                    LOG(ERROR) << output_item_type << " unrecognized output item type for the fused signal conditioner. Using gr_complex";
+                }
+            output_type_ = FUSED_OUTPUT_GR_COMPLEX;
+        }
+
+    conditioner_ = make_fused_conditioner(input_type_, output_type_, design_taps(configuration),
+            intermediate_freq, sampling_freq, decimation, remove_dc, dc_alpha);
+    DLOG(INFO) << "fused_conditioner(" << conditioner_->unique_id() << ")";
+
+    if (dump_)
+        {
+            DLOG(INFO) << "Dumping output into file " << dump_filename_;
+            std::cout << "Dumping output into file " << dump_filename_ << std::endl;
+            file_sink_ = gr::blocks::file_sink::make(item_size(), dump_filename_.c_str());
+        }
+}
+
+
+FusedSignalConditioner::~FusedSignalConditioner()
+{}
+
+
+void FusedSignalConditioner::connect(gr::top_block_sptr top_block)
+{
+    if (dump_)
+        {
+            top_block->connect(conditioner_, 0, file_sink_, 0);
+        }
+}
+
+
+void FusedSignalConditioner::disconnect(gr::top_block_sptr top_block)
+{
+    if (dump_)
+        {
+            top_block->disconnect(conditioner_, 0, file_sink_, 0);
+        }
+}
+
+
+gr::basic_block_sptr FusedSignalConditioner::get_left_block()
+{
+    return conditioner_;
+}
+
+
+gr::basic_block_sptr FusedSignalConditioner::get_right_block()
+{
+    return conditioner_;
+}
+
+
+std::vector<float> FusedSignalConditioner::design_taps(ConfigurationInterface* configuration)
+{
+    std::vector<float> taps;
+    std::string filter_implementation = configuration->property(filter_role_ + ".implementation", std::string("Pass_Through"));
+    if (filter_implementation.compare("Pass_Through") == 0)
+        {
+            // no filter, only the conversion, DC removal, frequency translation and decimation
+            taps.push_back(1.0);
+            return taps;
+        }
+
+    // Same design as FreqXlatingFirFilter
+    int number_of_taps = configuration->property(filter_role_ + ".number_of_taps", 6);
+    unsigned int number_of_bands = configuration->property(filter_role_ + ".number_of_bands", 2);
+    std::vector<double> default_bands = { 0.0, 0.4, 0.6, 1.0 };
+    std::vector<double> bands;
+    std::vector<double> ampl;
+    std::vector<double> error_w;
+    std::string option;
+    double option_value;
+
+    for (unsigned int i = 0; i < number_of_bands; i++)
+        {
+            option = ".band" + boost::lexical_cast<std::string>(i + 1) + "_begin";
+            option_value = configuration->property(filter_role_ + option, default_bands[i]);
+            bands.push_back(option_value);
+
+            option = ".band" + boost::lexical_cast<std::string>(i + 1) + "_end";
+            option_value = configuration->property(filter_role_ + option, default_bands[i]);
+            bands.push_back(option_value);
+
+            option = ".ampl" + boost::lexical_cast<std::string>(i + 1) + "_begin";
+            option_value = configuration->property(filter_role_ + option, default_bands[i]);
+            ampl.push_back(option_value);
+
+            option = ".ampl" + boost::lexical_cast<std::string>(i + 1) + "_end";
+            option_value = configuration->property(filter_role_ + option, default_bands[i]);
+            ampl.push_back(option_value);
+
+            option = ".band" + boost::lexical_cast<std::string>(i + 1) + "_error";
+            option_value = configuration->property(filter_role_ + option, default_bands[i]);
+            error_w.push_back(option_value);
+        }
+
+    std::string filter_type = configuration->property(filter_role_ + ".filter_type", std::string("bandpass"));
+    int grid_density = configuration->property(filter_role_ + ".grid_density", 16);
+
+    std::vector<double> taps_d = gr::filter::pm_remez(number_of_taps - 1, bands, ampl,
+            error_w, filter_type, grid_density);
+    taps.reserve(taps_d.size());
+    for (std::vector<double>::iterator it = taps_d.begin(); it != taps_d.end(); it++)
+        {
+            taps.push_back(float(*it));
+        }
+    return taps;
+}
@@ -0,0 +1,93 @@
+/*!
+ * \file fused_signal_conditioner.h
+ * \brief Signal conditioner made of a single fused_conditioner block.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Replaces the data type adapter, input filter and resampler of
+ * SignalConditioner with one block that reads the samples of the signal
+ * source as they are and writes the filtered and decimated baseband signal.
+ * The filter is designed as in FreqXlatingFirFilter, from the properties
+ * of the InputFilter role.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_FUSED_SIGNAL_CONDITIONER_H_
+#define GNSS_SDR_FUSED_SIGNAL_CONDITIONER_H_
+
+#include <string>
+#include <vector>
+#include <gnuradio/blocks/file_sink.h>
+#include "gnss_block_interface.h"
+#include "fused_conditioner.h"
+
+class ConfigurationInterface;
+
+class FusedSignalConditioner: public GNSSBlockInterface
+{
+public:
+    FusedSignalConditioner(ConfigurationInterface* configuration,
+            std::string role, std::string filter_role,
+            unsigned int in_streams, unsigned int out_streams);
+
+    virtual ~FusedSignalConditioner();
+
+    std::string role()
+    {
+        return role_;
+    }
+
+    //! Returns "Fused_Signal_Conditioner"
+    std::string implementation()
+    {
+        return "Fused_Signal_Conditioner";
+    }
+
+    size_t item_size()
+    {
+        return fused_conditioner_output_size(output_type_);
+    }
+
+    void connect(gr::top_block_sptr top_block);
+    void disconnect(gr::top_block_sptr top_block);
+    gr::basic_block_sptr get_left_block();
+    gr::basic_block_sptr get_right_block();
+
+private:
+    std::vector<float> design_taps(ConfigurationInterface* configuration);
+
+    std::string role_;
+    std::string filter_role_;
+    unsigned int in_streams_;
+    unsigned int out_streams_;
+    Fused_Conditioner_Input input_type_;
+    Fused_Conditioner_Output output_type_;
+    bool dump_;
+    std::string dump_filename_;
+    fused_conditioner_sptr conditioner_;
+    gr::blocks::file_sink::sptr file_sink_;
+};
+
+#endif // GNSS_SDR_FUSED_SIGNAL_CONDITIONER_H_
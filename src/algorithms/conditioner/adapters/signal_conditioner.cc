@@ -38,9 +38,10 @@ using google::LogMessage;
 // Constructor
 SignalConditioner::SignalConditioner(ConfigurationInterface *configuration,
         std::shared_ptr<GNSSBlockInterface> data_type_adapt, std::shared_ptr<GNSSBlockInterface> in_filt,
-        std::shared_ptr<GNSSBlockInterface> res, std::string role, std::string implementation) :
+        std::shared_ptr<GNSSBlockInterface> res, std::string role, std::string implementation,
+        std::shared_ptr<GNSSBlockInterface> mitigation) :
                 data_type_adapt_(data_type_adapt),
-                in_filt_(in_filt), res_(res), role_(role), implementation_(implementation)
+                in_filt_(in_filt), res_(res), mitigation_(mitigation), role_(role), implementation_(implementation)
 {
     connected_ = false;
     if(configuration){ };
@@ -60,11 +61,21 @@ void SignalConditioner::connect(gr::top_block_sptr top_block)
             return;
         }
     data_type_adapt_->connect(top_block);
+    if (mitigation_) mitigation_->connect(top_block);
     in_filt_->connect(top_block);
     res_->connect(top_block);
 
-    top_block->connect(data_type_adapt_->get_right_block(), 0, in_filt_->get_left_block(), 0);
-    DLOG(INFO) << "data_type_adapter -> input_filter";
+    if (mitigation_)
+        {
+            top_block->connect(data_type_adapt_->get_right_block(), 0, mitigation_->get_left_block(), 0);
+            top_block->connect(mitigation_->get_right_block(), 0, in_filt_->get_left_block(), 0);
+            DLOG(INFO) << "data_type_adapter -> interference_mitigation -> input_filter";
+        }
+    else
+        {
+            top_block->connect(data_type_adapt_->get_right_block(), 0, in_filt_->get_left_block(), 0);
+            DLOG(INFO) << "data_type_adapter -> input_filter";
+        }
 
     top_block->connect(in_filt_->get_right_block(), 0, res_->get_left_block(), 0);
     DLOG(INFO) << "input_filter -> resampler";
@@ -80,12 +91,23 @@ void SignalConditioner::disconnect(gr::top_block_sptr top_block)
             return;
         }
 
-    top_block->disconnect(data_type_adapt_->get_right_block(), 0,
-                          in_filt_->get_left_block(), 0);
+    if (mitigation_)
+        {
+            top_block->disconnect(data_type_adapt_->get_right_block(), 0,
+                                  mitigation_->get_left_block(), 0);
+            top_block->disconnect(mitigation_->get_right_block(), 0,
+                                  in_filt_->get_left_block(), 0);
+        }
+    else
+        {
+            top_block->disconnect(data_type_adapt_->get_right_block(), 0,
+                                  in_filt_->get_left_block(), 0);
+        }
     top_block->disconnect(in_filt_->get_right_block(), 0,
                           res_->get_left_block(), 0);
 
     data_type_adapt_->disconnect(top_block);
+    if (mitigation_) mitigation_->disconnect(top_block);
     in_filt_->disconnect(top_block);
     res_->disconnect(top_block);
 
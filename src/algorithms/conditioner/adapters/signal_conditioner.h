@@ -43,7 +43,8 @@ class TelemetryDecoderInterface;
 
 /*!
  * \brief This class wraps blocks to change data_type_adapter, input_filter and resampler
- * to be applied to the input flow of sampled signal.
+ * to be applied to the input flow of sampled signal. An optional interference
+ * mitigation block goes between the data_type_adapter and the input_filter.
  */
 class SignalConditioner: public GNSSBlockInterface
 {
@@ -51,7 +52,8 @@ public:
     //! Constructor
     SignalConditioner(ConfigurationInterface *configuration,
             std::shared_ptr<GNSSBlockInterface> data_type_adapt, std::shared_ptr<GNSSBlockInterface> in_filt,
-            std::shared_ptr<GNSSBlockInterface> res, std::string role, std::string implementation);
+            std::shared_ptr<GNSSBlockInterface> res, std::string role, std::string implementation,
+            std::shared_ptr<GNSSBlockInterface> mitigation = nullptr);
 
     //! Virtual destructor
     virtual ~SignalConditioner();
@@ -69,11 +71,14 @@ public:
     std::shared_ptr<GNSSBlockInterface> data_type_adapter(){ return data_type_adapt_; }
     std::shared_ptr<GNSSBlockInterface> input_filter(){ return in_filt_; }
     std::shared_ptr<GNSSBlockInterface> resampler(){ return res_; }
+    //! Null if there is no interference mitigation stage
+    std::shared_ptr<GNSSBlockInterface> interference_mitigation(){ return mitigation_; }
 
 private:
     std::shared_ptr<GNSSBlockInterface> data_type_adapt_;
     std::shared_ptr<GNSSBlockInterface> in_filt_;
     std::shared_ptr<GNSSBlockInterface> res_;
+    std::shared_ptr<GNSSBlockInterface> mitigation_;
     std::string role_;
     std::string implementation_;
     bool connected_;
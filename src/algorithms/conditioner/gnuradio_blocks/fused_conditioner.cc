@@ -0,0 +1,290 @@
+/*!
+ * \file fused_conditioner.cc
+ * \brief Signal conditioner that converts, removes the DC, translates the
+ * intermediate frequency, filters and decimates in a single block.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "fused_conditioner.h"
+#include "gnss_sdr_trace.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+
+
+size_t fused_conditioner_input_size(Fused_Conditioner_Input input_type)
+{
+    switch (input_type)
+    {
+    case FUSED_INPUT_BYTE:
+    case FUSED_INPUT_IBYTE:
+    case FUSED_INPUT_PACKED_2BIT:
+        return sizeof(signed char);
+    case FUSED_INPUT_SHORT:
+    case FUSED_INPUT_ISHORT:
+        return sizeof(int16_t);
+    case FUSED_INPUT_FLOAT:
+        return sizeof(float);
+    default:
+        return sizeof(gr_complex);
+    }
+}
+
+
+size_t fused_conditioner_output_size(Fused_Conditioner_Output output_type)
+{
+    switch (output_type)
+    {
+    case FUSED_OUTPUT_CSHORT:
+        return sizeof(lv_16sc_t);
+    case FUSED_OUTPUT_CBYTE:
+        return sizeof(lv_8sc_t);
+    default:
+        return sizeof(gr_complex);
+    }
+}
+
+
+fused_conditioner_sptr make_fused_conditioner(Fused_Conditioner_Input input_type,
+        Fused_Conditioner_Output output_type, const std::vector<float> & taps,
+        double intermediate_freq, double sampling_freq, unsigned int decimation,
+        bool remove_dc, float dc_alpha)
+{
+    return fused_conditioner_sptr(new fused_conditioner(input_type, output_type, taps,
+            intermediate_freq, sampling_freq, decimation, remove_dc, dc_alpha));
+}
+
+
+fused_conditioner::fused_conditioner(Fused_Conditioner_Input input_type,
+        Fused_Conditioner_Output output_type, const std::vector<float> & taps,
+        double intermediate_freq, double sampling_freq, unsigned int decimation,
+        bool remove_dc, float dc_alpha) :
+        gr::block("fused_conditioner",
+                gr::io_signature::make(1, 1, fused_conditioner_input_size(input_type)),
+                gr::io_signature::make(1, 1, fused_conditioner_output_size(output_type)))
+{
+    d_input_type = input_type;
+    d_output_type = output_type;
+    d_real_input = (input_type == FUSED_INPUT_BYTE) || (input_type == FUSED_INPUT_SHORT)
+            || (input_type == FUSED_INPUT_FLOAT) || (input_type == FUSED_INPUT_PACKED_2BIT);
+    d_items_per_group = ((input_type == FUSED_INPUT_IBYTE) || (input_type == FUSED_INPUT_ISHORT)) ? 2 : 1;
+    d_samples_per_group = (input_type == FUSED_INPUT_PACKED_2BIT) ? 4 : 1;
+    d_decimation = std::max(decimation, 1u);
+    d_remove_dc = remove_dc;
+    d_dc_alpha = dc_alpha;
+    d_dc_real = 0.0;
+    d_dc_complex = gr_complex(0.0, 0.0);
+
+    // h_bp[k] = h[k] exp(j w k) applied to x[n - k], and the output rotated by exp(-j w n),
+    // is the filter h applied to the signal translated by -w
+    std::vector<float> prototype = taps;
+    if (prototype.empty())
+        {
+            prototype.push_back(1.0);
+        }
+    d_ntaps = prototype.size();
+    const double w = 2.0 * M_PI * intermediate_freq / sampling_freq;
+    d_taps.resize(d_ntaps);
+    for (unsigned int k = 0; k < d_ntaps; k++)
+        {
+            d_taps[d_ntaps - 1 - k] = prototype[k] * gr_complex(std::cos(w * k), std::sin(w * k));
+        }
+    d_rotator = gr_complex(1.0, 0.0);
+    d_rotator_step = gr_complex(std::cos(w * d_decimation), -std::sin(w * d_decimation));
+
+    // the input before the first sample is taken as zero
+    if (d_real_input)
+        {
+            d_real_samples.assign(d_ntaps - 1, 0.0);
+        }
+    else
+        {
+            d_complex_samples.assign(d_ntaps - 1, gr_complex(0.0, 0.0));
+        }
+
+    set_relative_rate(static_cast<double>(d_samples_per_group) / static_cast<double>(d_items_per_group * d_decimation));
+}
+
+
+fused_conditioner::~fused_conditioner()
+{}
+
+
+void fused_conditioner::forecast(int noutput_items, gr_vector_int &ninput_items_required)
+{
+    const long buffered = d_real_input ? d_real_samples.size() : d_complex_samples.size();
+    const long needed = static_cast<long>(noutput_items - 1) * d_decimation + d_ntaps - buffered;
+    const long groups = std::max((needed + d_samples_per_group - 1) / d_samples_per_group, 1L);
+    ninput_items_required[0] = groups * d_items_per_group;
+}
+
+
+void fused_conditioner::append_samples(const void * in, int groups)
+{
+    const unsigned int n = groups * d_samples_per_group;
+    const unsigned int first = d_real_input ? d_real_samples.size() : d_complex_samples.size();
+    if (n == 0)
+        {
+            return;
+        }
+    if (d_real_input)
+        {
+            d_real_samples.resize(first + n);
+        }
+    else
+        {
+            d_complex_samples.resize(first + n);
+        }
+    float * real_out = d_real_input ? &d_real_samples[first] : nullptr;
+    float * complex_out = d_real_input ? nullptr : reinterpret_cast<float *>(&d_complex_samples[first]);
+
+    switch (d_input_type)
+    {
+    case FUSED_INPUT_BYTE:
+        volk_8i_s32f_convert_32f(real_out, static_cast<const int8_t *>(in), 1.0, n);
+        break;
+    case FUSED_INPUT_IBYTE:
+        volk_8i_s32f_convert_32f(complex_out, static_cast<const int8_t *>(in), 1.0, 2 * n);
+        break;
+    case FUSED_INPUT_SHORT:
+        volk_16i_s32f_convert_32f(real_out, static_cast<const int16_t *>(in), 1.0, n);
+        break;
+    case FUSED_INPUT_ISHORT:
+        volk_16i_s32f_convert_32f(complex_out, static_cast<const int16_t *>(in), 1.0, 2 * n);
+        break;
+    case FUSED_INPUT_FLOAT:
+        std::memcpy(real_out, in, n * sizeof(float));
+        break;
+    case FUSED_INPUT_GR_COMPLEX:
+        std::memcpy(complex_out, in, n * sizeof(gr_complex));
+        break;
+    case FUSED_INPUT_PACKED_2BIT:
+        d_unpacked.resize(n);
+        volk_gnsssdr_8u_unpack2bit_8i(&d_unpacked[0], static_cast<const unsigned char *>(in), n);
+        volk_8i_s32f_convert_32f(real_out, reinterpret_cast<const int8_t *>(&d_unpacked[0]), 1.0, n);
+        break;
+    }
+
+    if (d_remove_dc)
+        {
+            subtract_dc(first, n);
+        }
+}
+
+
+void fused_conditioner::subtract_dc(unsigned int first, unsigned int n)
+{
+    if (d_real_input)
+        {
+            float * x = &d_real_samples[first];
+            for (unsigned int i = 0; i < n; i++)
+                {
+                    d_dc_real += d_dc_alpha * (x[i] - d_dc_real);
+                    x[i] -= d_dc_real;
+                }
+        }
+    else
+        {
+            gr_complex * x = &d_complex_samples[first];
+            for (unsigned int i = 0; i < n; i++)
+                {
+                    d_dc_complex += d_dc_alpha * (x[i] - d_dc_complex);
+                    x[i] -= d_dc_complex;
+                }
+        }
+}
+
+
+int fused_conditioner::general_work(int noutput_items, gr_vector_int &ninput_items,
+        gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
+{
+    GNSS_SDR_TRACE_SCOPE("fused_conditioner::general_work");
+    // convert only the input needed for noutput_items
+    long buffered = d_real_input ? d_real_samples.size() : d_complex_samples.size();
+    const long needed = static_cast<long>(noutput_items - 1) * d_decimation + d_ntaps - buffered;
+    const int groups = std::min(ninput_items[0] / d_items_per_group,
+            static_cast<int>(std::max((needed + d_samples_per_group - 1) / d_samples_per_group, 0L)));
+    append_samples(input_items[0], groups);
+    buffered = d_real_input ? d_real_samples.size() : d_complex_samples.size();
+
+    int nout = 0;
+    if (buffered >= static_cast<long>(d_ntaps))
+        {
+            nout = std::min(static_cast<long>(noutput_items), (buffered - d_ntaps) / d_decimation + 1);
+        }
+
+    gr_complex * out = static_cast<gr_complex *>(output_items[0]);
+    if (d_output_type != FUSED_OUTPUT_GR_COMPLEX)
+        {
+            d_filtered.resize(std::max(nout, 1));
+            out = &d_filtered[0];
+        }
+    lv_32fc_t acc;
+    for (int m = 0; m < nout; m++)
+        {
+            if (d_real_input)
+                {
+                    volk_32fc_32f_dot_prod_32fc(&acc, &d_taps[0], &d_real_samples[m * d_decimation], d_ntaps);
+                }
+            else
+                {
+                    volk_32fc_x2_dot_prod_32fc(&acc, &d_complex_samples[m * d_decimation], &d_taps[0], d_ntaps);
+                }
+            out[m] = acc * d_rotator;
+            d_rotator *= d_rotator_step;
+        }
+    d_rotator /= std::abs(d_rotator);
+
+    switch (d_output_type)
+    {
+    case FUSED_OUTPUT_CSHORT:
+        volk_gnsssdr_32fc_convert_16ic(static_cast<lv_16sc_t *>(output_items[0]), out, nout);
+        break;
+    case FUSED_OUTPUT_CBYTE:
+        volk_gnsssdr_32fc_convert_8ic(static_cast<lv_8sc_t *>(output_items[0]), out, nout);
+        break;
+    default:
+        break;
+    }
+
+    // keep the samples not used yet, and the history of the next output
+    const unsigned int used = nout * d_decimation;
+    if (d_real_input)
+        {
+            d_real_samples.erase(d_real_samples.begin(), d_real_samples.begin() + used);
+        }
+    else
+        {
+            d_complex_samples.erase(d_complex_samples.begin(), d_complex_samples.begin() + used);
+        }
+
+    consume_each(groups * d_items_per_group);
+    return nout;
+}
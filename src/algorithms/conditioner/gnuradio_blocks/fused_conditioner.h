@@ -0,0 +1,146 @@
+/*!
+ * \file fused_conditioner.h
+ * \brief Signal conditioner that converts, removes the DC, translates the
+ * intermediate frequency, filters and decimates in a single block.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * A chain of data type adapter, frequency translating filter (with its own
+ * type conversion blocks) and resampler makes every sample cross several
+ * GNU Radio buffers and several scheduler calls. This block reads the raw
+ * samples of the source and writes the filtered and decimated baseband
+ * signal: the input is converted to float in a small buffer that stays in
+ * cache, and the filter is only evaluated at the output rate, with the taps
+ * shifted to the intermediate frequency and a rotator applied to each
+ * output sample, as in gr::filter::freq_xlating_fir_filter.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_FUSED_CONDITIONER_H_
+#define GNSS_SDR_FUSED_CONDITIONER_H_
+
+#include <vector>
+#include <gnuradio/block.h>
+#include <gnuradio/gr_complex.h>
+
+/*!
+ * \brief Sample formats read by fused_conditioner
+ */
+enum Fused_Conditioner_Input
+{
+    FUSED_INPUT_BYTE = 0,        //!< Real samples, signed char
+    FUSED_INPUT_IBYTE = 1,       //!< Interleaved I/Q samples, signed char
+    FUSED_INPUT_SHORT = 2,       //!< Real samples, short
+    FUSED_INPUT_ISHORT = 3,      //!< Interleaved I/Q samples, short
+    FUSED_INPUT_FLOAT = 4,       //!< Real samples, float
+    FUSED_INPUT_GR_COMPLEX = 5,  //!< Complex samples, gr_complex
+    FUSED_INPUT_PACKED_2BIT = 6  //!< Real 2-bit samples, four per byte, the first one in bits 1:0
+};
+
+/*!
+ * \brief Sample formats written by fused_conditioner
+ */
+enum Fused_Conditioner_Output
+{
+    FUSED_OUTPUT_GR_COMPLEX = 0, //!< gr_complex
+    FUSED_OUTPUT_CSHORT = 1,     //!< lv_16sc_t, rounded and saturated
+    FUSED_OUTPUT_CBYTE = 2       //!< lv_8sc_t, rounded and saturated
+};
+
+class fused_conditioner;
+
+typedef boost::shared_ptr<fused_conditioner> fused_conditioner_sptr;
+
+/*!
+ * \brief Makes a fused_conditioner. The taps are those of the low-pass
+ * prototype filter, at the input sampling frequency.
+ */
+fused_conditioner_sptr make_fused_conditioner(Fused_Conditioner_Input input_type,
+        Fused_Conditioner_Output output_type, const std::vector<float> & taps,
+        double intermediate_freq, double sampling_freq, unsigned int decimation,
+        bool remove_dc, float dc_alpha);
+
+//! Size in bytes of the input items of each format
+size_t fused_conditioner_input_size(Fused_Conditioner_Input input_type);
+
+//! Size in bytes of the output items of each format
+size_t fused_conditioner_output_size(Fused_Conditioner_Output output_type);
+
+/*!
+ * \brief Converts, removes the DC (optionally), translates the
+ * intermediate frequency to zero, filters and decimates.
+ *
+ * The DC is estimated with a first order recursive average,
+ * dc += dc_alpha * (x - dc), which is subtracted from each input sample.
+ */
+class fused_conditioner: public gr::block
+{
+private:
+    friend fused_conditioner_sptr make_fused_conditioner(Fused_Conditioner_Input input_type,
+            Fused_Conditioner_Output output_type, const std::vector<float> & taps,
+            double intermediate_freq, double sampling_freq, unsigned int decimation,
+            bool remove_dc, float dc_alpha);
+
+    fused_conditioner(Fused_Conditioner_Input input_type,
+            Fused_Conditioner_Output output_type, const std::vector<float> & taps,
+            double intermediate_freq, double sampling_freq, unsigned int decimation,
+            bool remove_dc, float dc_alpha);
+
+    // converts groups of input items to samples at the end of the buffer
+    void append_samples(const void * in, int groups);
+    void subtract_dc(unsigned int first, unsigned int n);
+
+    Fused_Conditioner_Input d_input_type;
+    Fused_Conditioner_Output d_output_type;
+    bool d_real_input;
+    int d_items_per_group;            // input items that make d_samples_per_group samples
+    int d_samples_per_group;
+    unsigned int d_decimation;
+    unsigned int d_ntaps;
+    std::vector<gr_complex> d_taps;   // band-pass taps, time reversed
+    gr_complex d_rotator;             // phase of the newest sample of the next output
+    gr_complex d_rotator_step;
+    bool d_remove_dc;
+    float d_dc_alpha;
+    float d_dc_real;
+    gr_complex d_dc_complex;
+
+    // samples not consumed yet by the filter, the oldest ones first
+    std::vector<float> d_real_samples;
+    std::vector<gr_complex> d_complex_samples;
+    std::vector<char> d_unpacked;
+    std::vector<gr_complex> d_filtered;
+
+public:
+    ~fused_conditioner();
+
+    void forecast(int noutput_items, gr_vector_int &ninput_items_required);
+
+    int general_work(int noutput_items, gr_vector_int &ninput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif
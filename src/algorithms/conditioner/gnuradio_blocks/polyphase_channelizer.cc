@@ -0,0 +1,173 @@
+/*!
+ * \file polyphase_channelizer.cc
+ * \brief Polyphase filter bank that splits a wideband stream into several
+ * decimated sub-band streams in a single pass.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "polyphase_channelizer.h"
+#include "fft_planner.h"
+#include "gnss_sdr_trace.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+
+using google::LogMessage;
+
+
+polyphase_channelizer_sptr make_polyphase_channelizer(bool cshort_in, unsigned int channels,
+        unsigned int decimation, const std::vector<float> & taps,
+        const std::vector<double> & sub_band_freqs, double sampling_freq)
+{
+    return polyphase_channelizer_sptr(new polyphase_channelizer(cshort_in, channels, decimation,
+            taps, sub_band_freqs, sampling_freq));
+}
+
+
+polyphase_channelizer::polyphase_channelizer(bool cshort_in, unsigned int channels,
+        unsigned int decimation, const std::vector<float> & taps,
+        const std::vector<double> & sub_band_freqs, double sampling_freq) :
+        gr::sync_decimator("polyphase_channelizer",
+                gr::io_signature::make(1, 1, cshort_in ? sizeof(lv_16sc_t) : sizeof(gr_complex)),
+                gr::io_signature::make(sub_band_freqs.size(), sub_band_freqs.size(), sizeof(gr_complex)),
+                std::min(std::max(decimation, 1u), std::max(channels, 1u)))
+{
+    d_cshort_in = cshort_in;
+    d_channels = std::max(channels, 1u);
+    d_decimation = std::min(std::max(decimation, 1u), d_channels);
+    d_branch_taps = std::max(static_cast<unsigned int>((taps.size() + d_channels - 1) / d_channels), 1u);
+    d_length = d_channels * d_branch_taps;
+
+    // Channel k at the newest sample n is
+    // y_k(n) = sum_l h(l) x(n - l) exp(-j 2 pi k (n - l) / M).
+    // With l = r + M q, the sum over q is the branch r, and the sum over r an
+    // FFT of the branches. Block q holds the samples x(n - M q - M + 1 + j),
+    // j = 0 .. M - 1, so it takes the taps h(M q + M - 1 - j).
+    std::vector<float> prototype = taps;
+    prototype.resize(d_length, 0.0);
+    if (taps.empty())
+        {
+            prototype[0] = 1.0;
+        }
+    d_taps.resize(2 * d_length);
+    for (unsigned int q = 0; q < d_branch_taps; q++)
+        {
+            for (unsigned int j = 0; j < d_channels; j++)
+                {
+                    const float tap = prototype[q * d_channels + d_channels - 1 - j];
+                    d_taps[2 * (q * d_channels + j)] = tap;
+                    d_taps[2 * (q * d_channels + j) + 1] = tap;
+                }
+        }
+
+    // With the blocks in that order the FFT is a forward one, and the phase
+    // left is exp(-j 2 pi k (n + 1) / M)
+    d_twiddles.resize(d_channels);
+    for (unsigned int i = 0; i < d_channels; i++)
+        {
+            const double phase = -2.0 * M_PI * i / d_channels;
+            d_twiddles[i] = gr_complex(std::cos(phase), std::sin(phase));
+        }
+    d_time = 0;
+
+    const double spacing = sampling_freq / d_channels;
+    for (unsigned int i = 0; i < sub_band_freqs.size(); i++)
+        {
+            const long nearest = std::lround(sub_band_freqs[i] / spacing);
+            const long bin = ((nearest % static_cast<long>(d_channels)) + d_channels) % d_channels;
+            const double residual = sub_band_freqs[i] - nearest * spacing;
+            const double step = -2.0 * M_PI * residual * d_decimation / sampling_freq;
+            d_bins.push_back(static_cast<unsigned int>(bin));
+            d_residual.push_back(gr_complex(1.0, 0.0));
+            d_residual_step.push_back(gr_complex(std::cos(step), std::sin(step)));
+            LOG(INFO) << "Sub-band " << i << " at " << sub_band_freqs[i] << " Hz: channel " << bin
+                      << " of " << d_channels << ", residual offset " << residual << " Hz";
+        }
+
+    d_fft = Fft_Planner::instance().acquire(d_channels, true);
+    set_history(d_length - d_decimation + 1);
+}
+
+
+polyphase_channelizer::~polyphase_channelizer()
+{}
+
+
+int polyphase_channelizer::work(int noutput_items,
+        gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
+{
+    GNSS_SDR_TRACE_SCOPE("polyphase_channelizer::work");
+    const gr_complex* in = static_cast<const gr_complex*>(input_items[0]);
+    if (d_cshort_in)
+        {
+            // input samples read by this call, history included
+            const unsigned int span = noutput_items * d_decimation + d_length - d_decimation;
+            if (d_converted.size() < span)
+                {
+                    d_converted.resize(span);
+                }
+            volk_16i_s32f_convert_32f(reinterpret_cast<float*>(d_converted.data()),
+                    static_cast<const int16_t*>(input_items[0]), 1.0, 2 * span);
+            in = d_converted.data();
+        }
+
+    const unsigned int floats = 2 * d_channels;
+    float* sums = reinterpret_cast<float*>(d_fft->get_inbuf());
+    const gr_complex* channels = d_fft->get_outbuf();
+    for (int m = 0; m < noutput_items; m++)
+        {
+            // the newest block of samples goes with the first taps
+            const float* newest = reinterpret_cast<const float*>(in + m * d_decimation + d_length - d_channels);
+            std::fill(sums, sums + floats, 0.0f);
+            for (unsigned int q = 0; q < d_branch_taps; q++)
+                {
+                    const float* x = newest - q * floats;
+                    const float* h = &d_taps[q * floats];
+                    for (unsigned int j = 0; j < floats; j++)
+                        {
+                            sums[j] += h[j] * x[j];
+                        }
+                }
+            d_fft->execute();
+
+            d_time = (d_time + d_decimation) % d_channels;
+            for (unsigned int i = 0; i < d_bins.size(); i++)
+                {
+                    const unsigned int k = d_bins[i];
+                    static_cast<gr_complex*>(output_items[i])[m] = channels[k] * d_twiddles[(k * d_time) % d_channels] * d_residual[i];
+                    d_residual[i] *= d_residual_step[i];
+                }
+        }
+    for (unsigned int i = 0; i < d_residual.size(); i++)
+        {
+            d_residual[i] /= std::abs(d_residual[i]);
+        }
+    return noutput_items;
+}
@@ -0,0 +1,122 @@
+/*!
+ * \file polyphase_channelizer.h
+ * \brief Polyphase filter bank that splits a wideband stream into several
+ * decimated sub-band streams in a single pass.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * A front end that captures several GNSS bands in one stream used to need a
+ * frequency translating filter and a resampler per band, each of them
+ * reading the full-rate stream. The filter bank reads it once: the input is
+ * split into the polyphase branches of one low-pass prototype, and an FFT
+ * of the branch outputs gives all the channels, equally spaced by the
+ * sampling frequency over the number of channels, at the decimated rate.
+ * Each output takes the channel nearest to its band and removes the rest of
+ * the offset with a rotator at the output rate.
+ *
+ * F. J. Harris, C. Dick, M. Rice, Digital Receivers and Transmitters Using
+ * Polyphase Filter Banks for Wireless Communications, IEEE Transactions on
+ * Microwave Theory and Techniques, vol. 51, no. 4, 2003.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_POLYPHASE_CHANNELIZER_H_
+#define GNSS_SDR_POLYPHASE_CHANNELIZER_H_
+
+#include <memory>
+#include <vector>
+#include <gnuradio/sync_decimator.h>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/fft/fft.h>
+
+class polyphase_channelizer;
+
+typedef boost::shared_ptr<polyphase_channelizer> polyphase_channelizer_sptr;
+
+/*!
+ * \brief Makes a polyphase_channelizer with one output per entry of
+ * sub_band_freqs, the centers of the bands relative to the center of the
+ * capture [Hz]. The taps are those of the low-pass prototype, at the input
+ * sampling frequency, and are zero-padded to a multiple of channels.
+ */
+polyphase_channelizer_sptr make_polyphase_channelizer(bool cshort_in, unsigned int channels,
+        unsigned int decimation, const std::vector<float> & taps,
+        const std::vector<double> & sub_band_freqs, double sampling_freq);
+
+/*!
+ * \brief Analysis filter bank of channels channels, decimated by decimation
+ * (at most channels; channels / 2 gives outputs oversampled by two, so that
+ * a band between two channels is not aliased).
+ *
+ * The polyphase filtering costs taps / decimation multiplications per input
+ * sample and the FFT log2(channels) per input sample and output, whatever
+ * the number of sub-bands. Output i is the band at sub_band_freqs[i]
+ * translated to zero and filtered by the prototype, at sampling_freq / decimation.
+ */
+class polyphase_channelizer: public gr::sync_decimator
+{
+private:
+    friend polyphase_channelizer_sptr make_polyphase_channelizer(bool cshort_in, unsigned int channels,
+            unsigned int decimation, const std::vector<float> & taps,
+            const std::vector<double> & sub_band_freqs, double sampling_freq);
+
+    polyphase_channelizer(bool cshort_in, unsigned int channels,
+            unsigned int decimation, const std::vector<float> & taps,
+            const std::vector<double> & sub_band_freqs, double sampling_freq);
+
+    bool d_cshort_in;
+    unsigned int d_channels;
+    unsigned int d_decimation;
+    unsigned int d_branch_taps;        // taps of each polyphase branch
+    unsigned int d_length;             // d_channels * d_branch_taps
+    // taps of each block of d_channels input samples, duplicated for I and Q
+    // and reversed within the block, so that the branch sums are a plain
+    // multiply-add over contiguous floats
+    std::vector<float> d_taps;
+    std::vector<float> d_branch_sums;
+    std::vector<gr_complex> d_converted;  // cshort input converted to float
+
+    std::vector<unsigned int> d_bins;     // channel of each output
+    std::vector<gr_complex> d_twiddles;   // exp(-j 2 pi i / d_channels)
+    unsigned int d_time;                  // index of the next output times d_decimation, modulo d_channels
+    std::vector<gr_complex> d_residual;   // rotators that remove the offset of each band from its channel
+    std::vector<gr_complex> d_residual_step;
+    std::shared_ptr<gr::fft::fft_complex> d_fft;
+
+public:
+    ~polyphase_channelizer();
+
+    //! Channel taken by output i
+    unsigned int bin(unsigned int i) const
+    {
+        return d_bins.at(i);
+    }
+
+    int work(int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif
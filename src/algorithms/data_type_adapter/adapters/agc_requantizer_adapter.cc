@@ -0,0 +1,122 @@
+/*!
+ * \file agc_requantizer_adapter.cc
+ * \brief Adapts an AGC and requantizer to a GNSSBlockInterface
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "agc_requantizer_adapter.h"
+#include <glog/logging.h>
+#include <volk/volk.h>
+#include "configuration_interface.h"
+
+using google::LogMessage;
+
+AgcRequantizer::AgcRequantizer(ConfigurationInterface* configuration, std::string role,
+        unsigned int in_streams, unsigned int out_streams) :
+                role_(role), in_streams_(in_streams), out_streams_(out_streams)
+{
+    std::string default_input_item_type = "gr_complex";
+    std::string default_output_item_type = "cbyte";
+    std::string default_dump_filename = "../data/data_type_adapter.dat";
+
+    DLOG(INFO) << "role " << role_;
+
+    input_item_type_ = configuration->property(role_ + ".input_item_type", default_input_item_type);
+    output_item_type_ = configuration->property(role_ + ".output_item_type", default_output_item_type);
+    dump_ = configuration->property(role_ + ".dump", false);
+    dump_filename_ = configuration->property(role_ + ".dump_filename", default_dump_filename);
+
+    bool cshort_in = input_item_type_.compare("cshort") == 0;
+    if (!cshort_in && input_item_type_.compare("gr_complex") != 0)
+        {
+            LOG(WARNING) << input_item_type_ << " unrecognized input item type for the requantizer. Using gr_complex";
+        }
+    bool cbyte_out = output_item_type_.compare("cbyte") == 0;
+    if (!cbyte_out && output_item_type_.compare("cshort") != 0)
+        {
+            LOG(WARNING) << output_item_type_ << " unrecognized output item type for the requantizer. Using cbyte";
+            cbyte_out = true;
+        }
+    unsigned int max_bits = cbyte_out ? 8 : 16;
+    unsigned int bits = configuration->property(role_ + ".bits", max_bits);
+    if (bits < 2 || bits > max_bits)
+        {
+            LOG(WARNING) << bits << " bits do not fit in " << output_item_type_ << ". Using " << max_bits;
+            bits = max_bits;
+        }
+    float rms_fraction = configuration->property(role_ + ".rms_fraction", 0.25);
+    float fixed_gain = configuration->property(role_ + ".gain", 0.0);
+    double sampling_frequency = configuration->property(role_ + ".sampling_frequency",
+            configuration->property("GNSS-SDR.internal_fs_hz", 2048000.0));
+    double time_constant_ms = configuration->property(role_ + ".agc_time_constant_ms", 100.0);
+
+    requantizer_ = make_agc_requantizer(cshort_in, cbyte_out, bits, rms_fraction,
+            time_constant_ms * 1e-3 * sampling_frequency, fixed_gain);
+    DLOG(INFO) << "data_type_adapter_(" << requantizer_->unique_id() << ")";
+
+    if (dump_)
+        {
+            DLOG(INFO) << "Dumping output into file " << dump_filename_;
+            file_sink_ = gr::blocks::file_sink::make(cbyte_out ? sizeof(lv_8sc_t) : sizeof(lv_16sc_t), dump_filename_.c_str());
+        }
+}
+
+
+AgcRequantizer::~AgcRequantizer()
+{}
+
+
+void AgcRequantizer::connect(gr::top_block_sptr top_block)
+{
+    if (dump_)
+        {
+            top_block->connect(requantizer_, 0, file_sink_, 0);
+        }
+}
+
+
+void AgcRequantizer::disconnect(gr::top_block_sptr top_block)
+{
+    if (dump_)
+        {
+            top_block->disconnect(requantizer_, 0, file_sink_, 0);
+        }
+}
+
+
+
+gr::basic_block_sptr AgcRequantizer::get_left_block()
+{
+    return requantizer_;
+}
+
+
+
+gr::basic_block_sptr AgcRequantizer::get_right_block()
+{
+    return requantizer_;
+}
@@ -0,0 +1,89 @@
+/*!
+ * \file agc_requantizer_adapter.h
+ * \brief Adapts an AGC and requantizer to a GNSSBlockInterface
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_AGC_REQUANTIZER_ADAPTER_H_
+#define GNSS_SDR_AGC_REQUANTIZER_ADAPTER_H_
+
+#include <string>
+#include <gnuradio/blocks/file_sink.h>
+#include "gnss_block_interface.h"
+#include "agc_requantizer.h"
+
+class ConfigurationInterface;
+
+/*!
+ * \brief Scales gr_complex or cshort samples with a slow AGC and requantizes
+ * them to cbyte or cshort, with a configurable number of bits.
+ *
+ * This lets the acquisition and tracking run on 8ic or 16ic kernels with
+ * samples that neither saturate them nor lose resolution when the level of
+ * the front end drifts.
+ */
+class AgcRequantizer: public GNSSBlockInterface
+{
+public:
+    AgcRequantizer(ConfigurationInterface* configuration,
+            std::string role, unsigned int in_streams,
+            unsigned int out_streams);
+
+    virtual ~AgcRequantizer();
+
+    std::string role()
+    {
+        return role_;
+    }
+    //! Returns "Agc_Requantizer"
+    std::string implementation()
+    {
+        return "Agc_Requantizer";
+    }
+    size_t item_size()
+    {
+        return 0;
+    }
+
+    void connect(gr::top_block_sptr top_block);
+    void disconnect(gr::top_block_sptr top_block);
+    gr::basic_block_sptr get_left_block();
+    gr::basic_block_sptr get_right_block();
+
+private:
+    agc_requantizer_sptr requantizer_;
+    bool dump_;
+    std::string dump_filename_;
+    std::string input_item_type_;
+    std::string output_item_type_;
+    std::string role_;
+    unsigned int in_streams_;
+    unsigned int out_streams_;
+    gr::blocks::file_sink::sptr file_sink_;
+};
+
+#endif
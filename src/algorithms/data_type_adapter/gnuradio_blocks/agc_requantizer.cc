@@ -0,0 +1,104 @@
+/*!
+ * \file agc_requantizer.cc
+ * \brief AGC and requantization of the samples to cbyte or cshort
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "agc_requantizer.h"
+#include "gnss_sdr_trace.h"
+#include <algorithm>
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+
+using google::LogMessage;
+
+
+agc_requantizer_sptr make_agc_requantizer(bool cshort_in, bool cbyte_out, unsigned int bits,
+        float rms_fraction, double time_constant_samples, float fixed_gain)
+{
+    return agc_requantizer_sptr(new agc_requantizer(cshort_in, cbyte_out, bits,
+            rms_fraction, time_constant_samples, fixed_gain));
+}
+
+
+agc_requantizer::agc_requantizer(bool cshort_in, bool cbyte_out, unsigned int bits,
+        float rms_fraction, double time_constant_samples, float fixed_gain)
+: gr::sync_block("agc_requantizer",
+        gr::io_signature::make(1, 1, cshort_in ? sizeof(lv_16sc_t) : sizeof(gr_complex)),
+        gr::io_signature::make(1, 1, cbyte_out ? sizeof(lv_8sc_t) : sizeof(lv_16sc_t))),
+  d_requantizer(bits, rms_fraction, time_constant_samples, fixed_gain)
+{
+    d_cshort_in = cshort_in;
+    d_cbyte_out = cbyte_out;
+    const int alignment_multiple = volk_get_alignment() / sizeof(lv_8sc_t);
+    set_alignment(std::max(1, alignment_multiple));
+}
+
+
+agc_requantizer::~agc_requantizer()
+{
+    if (d_requantizer.samples() > 0)
+        {
+            LOG(INFO) << "Requantizer to " << d_requantizer.bits() << " bits: gain " << d_requantizer.gain()
+                      << ", clipped components " << 50.0 * static_cast<double>(d_requantizer.clipped_components())
+                         / static_cast<double>(d_requantizer.samples()) << " %"
+                      << ", implementation loss " << d_requantizer.implementation_loss_db() << " dB";
+        }
+}
+
+
+int agc_requantizer::work(int noutput_items,
+        gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
+{
+    GNSS_SDR_TRACE_SCOPE("agc_requantizer::work");
+    if (d_cshort_in)
+        {
+            const lv_16sc_t* in = static_cast<const lv_16sc_t*>(input_items[0]);
+            if (d_cbyte_out)
+                {
+                    d_requantizer.process(in, static_cast<lv_8sc_t*>(output_items[0]), noutput_items);
+                }
+            else
+                {
+                    d_requantizer.process(in, static_cast<lv_16sc_t*>(output_items[0]), noutput_items);
+                }
+        }
+    else
+        {
+            const gr_complex* in = static_cast<const gr_complex*>(input_items[0]);
+            if (d_cbyte_out)
+                {
+                    d_requantizer.process(in, static_cast<lv_8sc_t*>(output_items[0]), noutput_items);
+                }
+            else
+                {
+                    d_requantizer.process(in, static_cast<lv_16sc_t*>(output_items[0]), noutput_items);
+                }
+        }
+    return noutput_items;
+}
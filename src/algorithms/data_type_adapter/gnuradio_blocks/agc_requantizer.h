@@ -0,0 +1,85 @@
+/*!
+ * \file agc_requantizer.h
+ * \brief AGC and requantization of the samples to cbyte or cshort
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_AGC_REQUANTIZER_H
+#define GNSS_SDR_AGC_REQUANTIZER_H
+
+#include <gnuradio/sync_block.h>
+#include "sample_requantizer.h"
+
+class agc_requantizer;
+typedef boost::shared_ptr<agc_requantizer> agc_requantizer_sptr;
+
+/*!
+ * \brief Makes an agc_requantizer block from gr_complex items, or lv_16sc_t
+ * items if \p cshort_in, to lv_8sc_t items if \p cbyte_out, or else lv_16sc_t.
+ * See Sample_Requantizer for \p bits, \p rms_fraction, \p time_constant_samples
+ * and \p fixed_gain.
+ */
+agc_requantizer_sptr make_agc_requantizer(bool cshort_in, bool cbyte_out, unsigned int bits,
+        float rms_fraction, double time_constant_samples, float fixed_gain);
+
+/*!
+ * \brief Runs a Sample_Requantizer on the stream, so that the 8ic and 16ic
+ * kernels downstream get samples at a controlled level. The gain, the share
+ * of clipped components and the implementation loss are logged when the
+ * block is destroyed.
+ */
+class agc_requantizer: public gr::sync_block
+{
+private:
+    friend agc_requantizer_sptr make_agc_requantizer(bool cshort_in, bool cbyte_out, unsigned int bits,
+            float rms_fraction, double time_constant_samples, float fixed_gain);
+
+    agc_requantizer(bool cshort_in, bool cbyte_out, unsigned int bits,
+            float rms_fraction, double time_constant_samples, float fixed_gain);
+
+    bool d_cshort_in;
+    bool d_cbyte_out;
+    Sample_Requantizer d_requantizer;
+
+public:
+    ~agc_requantizer();
+
+    float gain() const
+    {
+        return d_requantizer.gain();
+    }
+
+    double implementation_loss_db() const
+    {
+        return d_requantizer.implementation_loss_db();
+    }
+
+    int work (int noutput_items, gr_vector_const_void_star &input_items,
+              gr_vector_void_star &output_items);
+};
+
+#endif
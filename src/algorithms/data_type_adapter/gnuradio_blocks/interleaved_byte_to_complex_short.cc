@@ -30,8 +30,10 @@
 
 
 #include "interleaved_byte_to_complex_short.h"
+#include "gnss_sdr_trace.h"
 #include <gnuradio/io_signature.h>
 #include <volk/volk.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
 
 
 interleaved_byte_to_complex_short_sptr make_interleaved_byte_to_complex_short()
@@ -55,17 +57,9 @@ int interleaved_byte_to_complex_short::work(int noutput_items,
         gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE("interleaved_byte_to_complex_short::work");
     const int8_t *in = (const int8_t *) input_items[0];
     lv_16sc_t *out = (lv_16sc_t *) output_items[0];
-    // This could be put into a Volk kernel
-    int8_t real_part;
-    int8_t imag_part;
-    for(int number = 0; number < noutput_items; number++)
-        {
-            // lv_cmake(r, i) defined at volk/volk_complex.h
-            real_part = *in++;
-            imag_part = *in++;
-            *out++ = lv_cmake((int16_t)real_part, (int16_t)imag_part);
-        }
+    volk_gnsssdr_8ic_convert_16ic(out, reinterpret_cast<const lv_8sc_t*>(in), noutput_items);
     return noutput_items;
 }
@@ -30,6 +30,8 @@
 
 
 #include "interleaved_short_to_complex_short.h"
+#include "gnss_sdr_trace.h"
+#include <cstring>
 #include <gnuradio/io_signature.h>
 #include <volk/volk.h>
 
@@ -55,17 +57,10 @@ int interleaved_short_to_complex_short::work(int noutput_items,
         gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE("interleaved_short_to_complex_short::work");
     const int16_t *in = (const int16_t *) input_items[0];
     lv_16sc_t *out = (lv_16sc_t *) output_items[0];
-    // This could be put into a Volk kernel
-    int16_t real_part;
-    int16_t imag_part;
-    for(int number = 0; number < noutput_items; number++)
-        {
-            // lv_cmake(r, i) defined at volk/volk_complex.h
-            real_part = *in++;
-            imag_part = *in++;
-            *out++ = lv_cmake(real_part, imag_part);
-        }
+    // Interleaved I/Q samples already have the layout of lv_16sc_t
+    std::memcpy(out, in, noutput_items * sizeof(lv_16sc_t));
     return noutput_items;
 }
@@ -0,0 +1,104 @@
+/*!
+ * \file beam_steering_filter.cc
+ * \brief Interface of an adapter of the beam steering block of antenna arrays
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "beam_steering_filter.h"
+#include <algorithm>
+#include <boost/lexical_cast.hpp>
+#include <glog/logging.h>
+#include "beam_steering.h"
+#include "configuration_interface.h"
+#include "GPS_L1_CA.h"
+
+
+using google::LogMessage;
+
+BeamSteeringFilter::BeamSteeringFilter(
+        ConfigurationInterface* configuration, std::string role,
+        unsigned int in_stream, unsigned int out_stream) :
+        role_(role), in_stream_(in_stream), out_stream_(out_stream)
+{
+    elements_ = configuration->property(role + ".channels", 8);
+
+    // one beam per receiver channel by default
+    unsigned int channels = configuration->property("Channels_1C.count", 0);
+    channels += configuration->property("Channels_2S.count", 0);
+    channels += configuration->property("Channels_1B.count", 0);
+    channels += configuration->property("Channels_5X.count", 0);
+    beams_ = configuration->property(role + ".beams", std::max(channels, 1u));
+
+    // element0_east, element0_north, element0_up, element1_east, ... [m]
+    std::vector<double> positions;
+    for (unsigned int i = 0; i < elements_; i++)
+        {
+            std::string element = role + ".element" + boost::lexical_cast<std::string>(i);
+            positions.push_back(configuration->property(element + "_east", 0.0));
+            positions.push_back(configuration->property(element + "_north", 0.0));
+            positions.push_back(configuration->property(element + "_up", 0.0));
+        }
+
+    double carrier_freq = configuration->property(role + ".carrier_freq", GPS_L1_FREQ_HZ);
+    double fs_in = configuration->property("GNSS-SDR.internal_fs_hz", 2048000.0);
+    double timeout_ms = configuration->property(role + ".beam_timeout_ms", 2000.0);
+
+    beam_steering_ = make_beam_steering(elements_, beams_, positions, GPS_C_m_s / carrier_freq,
+            static_cast<unsigned long long>(timeout_ms * fs_in / 1000.0));
+    DLOG(INFO) << "beam_steering(" << beam_steering_->unique_id() << ") with "
+               << elements_ << " elements and " << beams_ << " beams";
+}
+
+
+BeamSteeringFilter::~BeamSteeringFilter() {}
+
+
+
+void BeamSteeringFilter::connect(gr::top_block_sptr top_block)
+{
+    if(top_block) { /* top_block is not null */};
+    DLOG(INFO) << "nothing to connect internally";
+}
+
+
+void BeamSteeringFilter::disconnect(gr::top_block_sptr top_block)
+{
+    if(top_block) { /* top_block is not null */};
+    // Nothing to disconnect
+}
+
+
+gr::basic_block_sptr BeamSteeringFilter::get_left_block()
+{
+    return beam_steering_;
+}
+
+
+gr::basic_block_sptr BeamSteeringFilter::get_right_block()
+{
+    return beam_steering_;
+}
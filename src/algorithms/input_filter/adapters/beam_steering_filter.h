@@ -0,0 +1,82 @@
+/*!
+ * \file beam_steering_filter.h
+ * \brief Interface of an adapter of the beam steering block of antenna arrays
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_BEAM_STEERING_FILTER_H_
+#define GNSS_SDR_BEAM_STEERING_FILTER_H_
+
+#include <string>
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/hier_block2.h>
+#include "gnss_block_interface.h"
+
+class ConfigurationInterface;
+
+/*!
+ * \brief Interface of an adapter of the beam_steering block to a
+ * GNSSBlockInterface. The block has one output per beam, and the
+ * flowgraph feeds each channel with its own beam and connects the
+ * "beam_steering" message port of the PVT block to get_right_block().
+ */
+class BeamSteeringFilter: public GNSSBlockInterface
+{
+public:
+    BeamSteeringFilter(ConfigurationInterface* configuration,
+            std::string role, unsigned int in_stream,
+            unsigned int out_stream);
+
+    virtual ~BeamSteeringFilter();
+    std::string role()
+    {
+        return role_;
+    }
+    //! returns "Beam_Steering_Filter"
+    std::string implementation()
+    {
+        return "Beam_Steering_Filter";
+    }
+    size_t item_size()
+    {
+        return sizeof(gr_complex);
+    }
+    void connect(gr::top_block_sptr top_block);
+    void disconnect(gr::top_block_sptr top_block);
+    gr::basic_block_sptr get_left_block();
+    gr::basic_block_sptr get_right_block();
+
+private:
+    std::string role_;
+    unsigned int in_stream_;
+    unsigned int out_stream_;
+    unsigned int elements_;
+    unsigned int beams_;
+    gr::block_sptr beam_steering_;
+};
+
+#endif /*GNSS_SDR_BEAM_STEERING_FILTER_H_*/
@@ -29,8 +29,10 @@
  */
 
 #include "beamformer_filter.h"
+#include <boost/lexical_cast.hpp>
 #include <glog/logging.h>
 #include <gnuradio/blocks/file_sink.h>
+#include <volk_gnsssdr/volk_gnsssdr_complex.h>
 #include "beamformer.h"
 #include "configuration_interface.h"
 
@@ -45,17 +47,33 @@ BeamformerFilter::BeamformerFilter(
     std::string default_item_type = "gr_complex";
     std::string default_dump_file = "./data/input_filter.dat";
     item_type_ = configuration->property(role + ".item_type", default_item_type);
+    channels_ = configuration->property(role + ".channels", 8);
     dump_ = configuration->property(role + ".dump", false);
     DLOG(INFO) << "dump_ is " << dump_;
     dump_filename_ = configuration->property(role + ".dump_filename", default_dump_file);
 
+    // initial weights, weight0_real, weight0_imag, weight1_real, ...
+    std::vector<gr_complex> weights;
+    for (unsigned int i = 0; i < channels_; i++)
+        {
+            std::string weight = role + ".weight" + boost::lexical_cast<std::string>(i);
+            weights.push_back(gr_complex(configuration->property(weight + "_real", 1.0),
+                    configuration->property(weight + "_imag", 0.0)));
+        }
+
     if (item_type_.compare("gr_complex") == 0)
         {
             item_size_ = sizeof(gr_complex);
-            beamformer_ = make_beamformer();
+            beamformer_ = make_beamformer(channels_, BEAMFORMER_ITEM_GR_COMPLEX, weights);
             DLOG(INFO) << "Item size " << item_size_;
-            DLOG(INFO) << "resampler(" << beamformer_->unique_id() << ")";
-
+            DLOG(INFO) << "beamformer(" << beamformer_->unique_id() << ")";
+        }
+    else if (item_type_.compare("cshort") == 0)
+        {
+            item_size_ = sizeof(lv_16sc_t);
+            beamformer_ = make_beamformer(channels_, BEAMFORMER_ITEM_CSHORT, weights);
+            DLOG(INFO) << "Item size " << item_size_;
+            DLOG(INFO) << "beamformer(" << beamformer_->unique_id() << ")";
         }
     else
         {
@@ -39,8 +39,9 @@
 class ConfigurationInterface;
 
 /*!
- * \brief Interface of an adapter of a direct resampler conditioner block
- * to a SignalConditionerInterface
+ * \brief Interface of an adapter of the beamformer block to a
+ * GNSSBlockInterface. The weights can be changed later through the
+ * "weights" message port of get_left_block().
  */
 class BeamformerFilter: public GNSSBlockInterface
 {
@@ -54,7 +55,7 @@ public:
     {
         return role_;
     }
-    //! returns "Direct_Resampler"
+    //! returns "Beamformer_Filter"
     std::string implementation()
     {
         return "Beamformer_Filter";
@@ -74,6 +75,7 @@ private:
     unsigned int out_stream_;
     std::string item_type_;
     size_t item_size_;
+    unsigned int channels_;
     unsigned long long samples_;
     bool dump_;
     std::string dump_filename_;
@@ -0,0 +1,113 @@
+/*!
+ * \file fft_fir_filter_adapter.cc
+ * \brief Adapts an overlap-save FIR filter designed with pm_remez
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "fft_fir_filter_adapter.h"
+#include <glog/logging.h>
+#include <volk/volk.h>
+#include "configuration_interface.h"
+#include "fir_filter.h"
+
+using google::LogMessage;
+
+FftFirFilter::FftFirFilter(ConfigurationInterface* configuration, std::string role,
+        unsigned int in_streams, unsigned int out_streams) :
+                role_(role), in_streams_(in_streams), out_streams_(out_streams)
+{
+    std::string default_item_type = "gr_complex";
+    std::string default_dump_filename = "../data/input_filter.dat";
+    input_item_type_ = configuration->property(role_ + ".input_item_type", default_item_type);
+    output_item_type_ = configuration->property(role_ + ".output_item_type", default_item_type);
+    dump_ = configuration->property(role_ + ".dump", false);
+    dump_filename_ = configuration->property(role_ + ".dump_filename", default_dump_filename);
+    unsigned int decimation_factor = configuration->property(role_ + ".decimation_factor", 1);
+    unsigned int fft_size = configuration->property(role_ + ".fft_size", 0);
+
+    bool cshort_in = input_item_type_.compare("cshort") == 0;
+    bool cshort_out = output_item_type_.compare("cshort") == 0;
+    if ((!cshort_in && input_item_type_.compare("gr_complex") != 0)
+            || (!cshort_out && output_item_type_.compare("gr_complex") != 0))
+        {
+            LOG(ERROR) << " Unknown item type conversion";
+            return;
+        }
+
+    std::vector<float> taps = FirFilter::design_taps(configuration, role_);
+    filter_ = make_fft_fir_filter(taps, decimation_factor, cshort_in, cshort_out, fft_size);
+    DLOG(INFO) << "input_filter(" << filter_->unique_id() << "), FFT length " << filter_->fft_size();
+    if (dump_)
+        {
+            DLOG(INFO) << "Dumping output into file " << dump_filename_;
+            size_t item_size = cshort_out ? sizeof(lv_16sc_t) : sizeof(gr_complex);
+            file_sink_ = gr::blocks::file_sink::make(item_size, dump_filename_.c_str());
+        }
+}
+
+
+
+FftFirFilter::~FftFirFilter()
+{}
+
+
+
+void FftFirFilter::connect(gr::top_block_sptr top_block)
+{
+    if (dump_ && filter_)
+        {
+            top_block->connect(filter_, 0, file_sink_, 0);
+        }
+    else
+        {
+            DLOG(INFO) << "Nothing to connect internally";
+        }
+}
+
+
+
+void FftFirFilter::disconnect(gr::top_block_sptr top_block)
+{
+    if (dump_ && filter_)
+        {
+            top_block->disconnect(filter_, 0, file_sink_, 0);
+        }
+}
+
+
+
+gr::basic_block_sptr FftFirFilter::get_left_block()
+{
+    return filter_;
+}
+
+
+
+gr::basic_block_sptr FftFirFilter::get_right_block()
+{
+    return filter_;
+}
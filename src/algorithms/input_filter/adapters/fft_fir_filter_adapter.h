@@ -0,0 +1,89 @@
+/*!
+ * \file fft_fir_filter_adapter.h
+ * \brief Adapts an overlap-save FIR filter designed with pm_remez
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_FFT_FIR_FILTER_ADAPTER_H_
+#define GNSS_SDR_FFT_FIR_FILTER_ADAPTER_H_
+
+#include <string>
+#include <vector>
+#include <gnuradio/blocks/file_sink.h>
+#include "gnss_block_interface.h"
+#include "fft_fir_filter.h"
+
+class ConfigurationInterface;
+
+/*!
+ * \brief Same filter design as FirFilter, computed with fft_fir_filter.
+ *
+ * Items are gr_complex or cshort on either side. The taps are designed
+ * from the same properties as Fir_Filter. decimation_factor keeps one of
+ * every N outputs and fft_size sets the block length (0 chooses it).
+ */
+class FftFirFilter: public GNSSBlockInterface
+{
+public:
+    FftFirFilter(ConfigurationInterface* configuration,
+                 std::string role,
+                 unsigned int in_streams,
+                 unsigned int out_streams);
+
+    virtual ~FftFirFilter();
+    std::string role()
+    {
+        return role_;
+    }
+
+    //! Returns "Fft_Fir_Filter"
+    std::string implementation()
+    {
+        return "Fft_Fir_Filter";
+    }
+    size_t item_size()
+    {
+        return 0;
+    }
+    void connect(gr::top_block_sptr top_block);
+    void disconnect(gr::top_block_sptr top_block);
+    gr::basic_block_sptr get_left_block();
+    gr::basic_block_sptr get_right_block();
+
+private:
+    fft_fir_filter_sptr filter_;
+    bool dump_;
+    std::string dump_filename_;
+    std::string input_item_type_;
+    std::string output_item_type_;
+    std::string role_;
+    unsigned int in_streams_;
+    unsigned int out_streams_;
+    gr::blocks::file_sink::sptr file_sink_;
+};
+
+#endif
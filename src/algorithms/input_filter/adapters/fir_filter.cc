@@ -368,13 +368,6 @@ void FirFilter::init()
     std::string default_output_item_type = "gr_complex";
     std::string default_taps_item_type = "float";
     std::string default_dump_filename = "../data/input_filter.dat";
-    int default_number_of_taps = 6;
-    unsigned int default_number_of_bands = 2;
-    std::vector<double> default_bands = { 0.0, 0.4, 0.6, 1.0 };
-    std::vector<double> default_ampl = { 1.0, 1.0, 0.0, 0.0 };
-    std::vector<double> default_error_w = { 1.0, 1.0 };
-    std::string default_filter_type = "bandpass";
-    int default_grid_density = 16;
 
     DLOG(INFO) << "role " << role_;
 
@@ -383,8 +376,23 @@ void FirFilter::init()
     taps_item_type_ = config_->property(role_ + ".taps_item_type", default_taps_item_type);
     dump_ = config_->property(role_ + ".dump", false);
     dump_filename_ = config_->property(role_ + ".dump_filename", default_dump_filename);
-    int number_of_taps = config_->property(role_ + ".number_of_taps", default_number_of_taps);
-    unsigned int number_of_bands = config_->property(role_ + ".number_of_bands", default_number_of_bands);
+    taps_ = design_taps(config_, role_);
+}
+
+
+
+std::vector<float> FirFilter::design_taps(ConfigurationInterface* configuration, const std::string& role)
+{
+    int default_number_of_taps = 6;
+    unsigned int default_number_of_bands = 2;
+    std::vector<double> default_bands = { 0.0, 0.4, 0.6, 1.0 };
+    std::vector<double> default_ampl = { 1.0, 1.0, 0.0, 0.0 };
+    std::vector<double> default_error_w = { 1.0, 1.0 };
+    std::string default_filter_type = "bandpass";
+    int default_grid_density = 16;
+
+    int number_of_taps = configuration->property(role + ".number_of_taps", default_number_of_taps);
+    unsigned int number_of_bands = configuration->property(role + ".number_of_bands", default_number_of_bands);
 
     std::vector<double> bands;
     std::vector<double> ampl;
@@ -394,37 +402,39 @@ void FirFilter::init()
     for (unsigned int i = 0; i < number_of_bands; i++)
         {
             option = ".band" + boost::lexical_cast<std::string>(i + 1) + "_begin";
-            option_value = config_->property(role_ + option, default_bands[i]);
+            option_value = configuration->property(role + option, default_bands[i]);
             bands.push_back(option_value);
 
             option = ".band" + boost::lexical_cast<std::string>(i + 1) + "_end";
-            option_value = config_->property(role_ + option, default_bands[i]);
+            option_value = configuration->property(role + option, default_bands[i]);
             bands.push_back(option_value);
 
             option = ".ampl" + boost::lexical_cast<std::string>(i + 1) + "_begin";
-            option_value = config_->property(role_ + option, default_bands[i]);
+            option_value = configuration->property(role + option, default_bands[i]);
             ampl.push_back(option_value);
 
             option = ".ampl" + boost::lexical_cast<std::string>(i + 1) + "_end";
-            option_value = config_->property(role_ + option, default_bands[i]);
+            option_value = configuration->property(role + option, default_bands[i]);
             ampl.push_back(option_value);
 
             option = ".band" + boost::lexical_cast<std::string>(i + 1) + "_error";
-            option_value = config_->property(role_ + option, default_bands[i]);
+            option_value = configuration->property(role + option, default_bands[i]);
             error_w.push_back(option_value);
         }
 
-    std::string filter_type = config_->property(role_ + ".filter_type", default_filter_type);
-    int grid_density = config_->property(role_ + ".grid_density", default_grid_density);
+    std::string filter_type = configuration->property(role + ".filter_type", default_filter_type);
+    int grid_density = configuration->property(role + ".grid_density", default_grid_density);
 
     // pm_remez implements the Parks-McClellan FIR filter design.
     // It calculates the optimal (in the Chebyshev/minimax sense) FIR filter
     // impulse response given a set of band edges, the desired response on
     // those bands, and the weight given to the error in those bands.
     std::vector<double> taps_d = gr::filter::pm_remez(number_of_taps - 1, bands, ampl, error_w, filter_type, grid_density);
-    taps_.reserve(taps_d.size());
+    std::vector<float> taps;
+    taps.reserve(taps_d.size());
     for (std::vector<double>::iterator it = taps_d.begin(); it != taps_d.end(); it++)
         {
-            taps_.push_back(float(*it));
+            taps.push_back(float(*it));
         }
+    return taps;
 }
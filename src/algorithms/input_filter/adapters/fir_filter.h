@@ -89,6 +89,13 @@ public:
     gr::basic_block_sptr get_left_block();
     gr::basic_block_sptr get_right_block();
 
+    /*!
+     * \brief Designs the taps with pm_remez from the number_of_taps,
+     * number_of_bands, band*, ampl*, filter_type and grid_density
+     * properties of role.
+     */
+    static std::vector<float> design_taps(ConfigurationInterface* configuration, const std::string& role);
+
 private:
     gr::filter::fir_filter_ccf::sptr fir_filter_ccf_;
     ConfigurationInterface* config_;
@@ -0,0 +1,114 @@
+/*!
+ * \file pulse_blanking_filter.cc
+ * \brief Adapts the pulse blanking and adaptive notch block
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "pulse_blanking_filter.h"
+#include <glog/logging.h>
+#include <volk/volk.h>
+#include "configuration_interface.h"
+
+using google::LogMessage;
+
+PulseBlankingFilter::PulseBlankingFilter(ConfigurationInterface* configuration, std::string role,
+        unsigned int in_streams, unsigned int out_streams) :
+                role_(role), in_streams_(in_streams), out_streams_(out_streams)
+{
+    std::string default_item_type = "gr_complex";
+    std::string default_dump_filename = "../data/interference_mitigation.dat";
+    item_type_ = configuration->property(role_ + ".item_type", default_item_type);
+    dump_ = configuration->property(role_ + ".dump", false);
+    dump_filename_ = configuration->property(role_ + ".dump_filename", default_dump_filename);
+    double sample_rate = configuration->property("GNSS-SDR.internal_fs_hz", 2048000.0);
+    bool blanking = configuration->property(role_ + ".blanking", true);
+    float threshold = configuration->property(role_ + ".threshold", 10.0);
+    unsigned int guard_samples = configuration->property(role_ + ".guard_samples", 16);
+    bool notch = configuration->property(role_ + ".notch", false);
+    float notch_mu = configuration->property(role_ + ".notch_mu", 0.001);
+    float notch_pole = configuration->property(role_ + ".notch_pole", 0.9);
+
+    bool cshort = item_type_.compare("cshort") == 0;
+    if (!cshort && item_type_.compare("gr_complex") != 0)
+        {
+            LOG(ERROR) << item_type_ << " unknown interference mitigation item type";
+            item_size_ = 0;
+            return;
+        }
+    item_size_ = cshort ? sizeof(lv_16sc_t) : sizeof(gr_complex);
+    blanker_ = make_pulse_blanking_notch(cshort, sample_rate, blanking, threshold, guard_samples,
+            notch, notch_mu, notch_pole, role_);
+    DLOG(INFO) << "interference_mitigation(" << blanker_->unique_id() << ")";
+    if (dump_)
+        {
+            DLOG(INFO) << "Dumping output into file " << dump_filename_;
+            file_sink_ = gr::blocks::file_sink::make(item_size_, dump_filename_.c_str());
+        }
+}
+
+
+
+PulseBlankingFilter::~PulseBlankingFilter()
+{}
+
+
+
+void PulseBlankingFilter::connect(gr::top_block_sptr top_block)
+{
+    if (dump_ && blanker_)
+        {
+            top_block->connect(blanker_, 0, file_sink_, 0);
+        }
+    else
+        {
+            DLOG(INFO) << "Nothing to connect internally";
+        }
+}
+
+
+
+void PulseBlankingFilter::disconnect(gr::top_block_sptr top_block)
+{
+    if (dump_ && blanker_)
+        {
+            top_block->disconnect(blanker_, 0, file_sink_, 0);
+        }
+}
+
+
+
+gr::basic_block_sptr PulseBlankingFilter::get_left_block()
+{
+    return blanker_;
+}
+
+
+
+gr::basic_block_sptr PulseBlankingFilter::get_right_block()
+{
+    return blanker_;
+}
@@ -0,0 +1,89 @@
+/*!
+ * \file pulse_blanking_filter.h
+ * \brief Adapts the pulse blanking and adaptive notch block
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PULSE_BLANKING_FILTER_H_
+#define GNSS_SDR_PULSE_BLANKING_FILTER_H_
+
+#include <string>
+#include <gnuradio/blocks/file_sink.h>
+#include "gnss_block_interface.h"
+#include "pulse_blanking_notch.h"
+
+class ConfigurationInterface;
+
+/*!
+ * \brief Interference mitigation stage of the SignalConditioner, between
+ * the DataTypeAdapter and the InputFilter.
+ *
+ * Items are gr_complex or cshort (item_type). blanking, threshold and
+ * guard_samples configure the pulse blanker; notch, notch_mu and notch_pole
+ * the adaptive notch. See Pulse_Blanker.
+ */
+class PulseBlankingFilter: public GNSSBlockInterface
+{
+public:
+    PulseBlankingFilter(ConfigurationInterface* configuration,
+                        std::string role,
+                        unsigned int in_streams,
+                        unsigned int out_streams);
+
+    virtual ~PulseBlankingFilter();
+    std::string role()
+    {
+        return role_;
+    }
+
+    //! Returns "Pulse_Blanking_Filter"
+    std::string implementation()
+    {
+        return "Pulse_Blanking_Filter";
+    }
+    size_t item_size()
+    {
+        return item_size_;
+    }
+    void connect(gr::top_block_sptr top_block);
+    void disconnect(gr::top_block_sptr top_block);
+    gr::basic_block_sptr get_left_block();
+    gr::basic_block_sptr get_right_block();
+
+private:
+    pulse_blanking_notch_sptr blanker_;
+    bool dump_;
+    std::string dump_filename_;
+    std::string item_type_;
+    size_t item_size_;
+    std::string role_;
+    unsigned int in_streams_;
+    unsigned int out_streams_;
+    gr::blocks::file_sink::sptr file_sink_;
+};
+
+#endif
@@ -0,0 +1,180 @@
+/*!
+ * \file beam_steering.cc
+ * \brief Forms one beam of an antenna array per receiver channel, steered
+ * to the satellite of the channel.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "beam_steering.h"
+#include "gnss_sdr_trace.h"
+#include <cmath>
+#include <boost/bind.hpp>
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+
+using google::LogMessage;
+
+
+beam_steering_sptr make_beam_steering(unsigned int elements, unsigned int beams,
+        const std::vector<double> & positions_enu_m, double wavelength_m,
+        unsigned long long timeout_samples)
+{
+    return beam_steering_sptr(new beam_steering(elements, beams, positions_enu_m,
+            wavelength_m, timeout_samples));
+}
+
+
+beam_steering::beam_steering(unsigned int elements, unsigned int beams,
+        const std::vector<double> & positions_enu_m, double wavelength_m,
+        unsigned long long timeout_samples)
+: gr::sync_block("beam_steering",
+        gr::io_signature::make(elements, elements, sizeof(gr_complex)),
+        gr::io_signature::make(beams, beams, sizeof(gr_complex)))
+{
+    d_elements = elements;
+    d_beams = beams;
+    d_positions = positions_enu_m;
+    if (d_positions.size() != 3 * d_elements)
+        {
+            LOG(WARNING) << "Beam steering with " << d_elements << " elements and "
+                         << d_positions.size() << " coordinates, the missing ones are 0";
+            d_positions.resize(3 * d_elements, 0.0);
+        }
+    d_wavelength_m = wavelength_m;
+    d_timeout_samples = timeout_samples;
+    d_sample_counter = 0;
+
+    d_weights.resize(d_beams * d_elements);
+    d_steered.assign(d_beams, false);
+    d_steered_at.assign(d_beams, 0);
+    for (unsigned int beam = 0; beam < d_beams; beam++)
+        {
+            steer(beam, 0.0, 90.0);
+        }
+
+    message_port_register_in(pmt::mp("beam_steering"));
+    set_msg_handler(pmt::mp("beam_steering"), boost::bind(&beam_steering::msg_handler_beam_steering, this, _1));
+}
+
+
+beam_steering::~beam_steering()
+{}
+
+
+void beam_steering::steer(unsigned int beam, double azimuth_deg, double elevation_deg)
+{
+    const double azimuth = azimuth_deg * M_PI / 180.0;
+    const double elevation = elevation_deg * M_PI / 180.0;
+    const double u[3] = { std::sin(azimuth) * std::cos(elevation),
+                          std::cos(azimuth) * std::cos(elevation),
+                          std::sin(elevation) };
+    for (unsigned int k = 0; k < d_elements; k++)
+        {
+            const double * p = &d_positions[3 * k];
+            const double phase = 2.0 * M_PI * (p[0] * u[0] + p[1] * u[1] + p[2] * u[2]) / d_wavelength_m;
+            d_weights[beam * d_elements + k] = gr_complex(std::cos(phase), -std::sin(phase)) / static_cast<float>(d_elements);
+        }
+}
+
+
+bool beam_steering::set_direction(unsigned int beam, double azimuth_deg, double elevation_deg)
+{
+    if (beam >= d_beams)
+        {
+            return false;
+        }
+    boost::mutex::scoped_lock lock(d_mutex);
+    steer(beam, azimuth_deg, elevation_deg);
+    d_steered[beam] = true;
+    d_steered_at[beam] = d_sample_counter;
+    return true;
+}
+
+
+std::vector<gr_complex> beam_steering::weights(unsigned int beam)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    if (beam >= d_beams)
+        {
+            return std::vector<gr_complex>();
+        }
+    return std::vector<gr_complex>(d_weights.begin() + beam * d_elements,
+            d_weights.begin() + (beam + 1) * d_elements);
+}
+
+
+void beam_steering::msg_handler_beam_steering(pmt::pmt_t msg)
+{
+    GNSS_SDR_TRACE_SCOPE("beam_steering::msg_handler_beam_steering");
+    if (!pmt::is_dict(msg))
+        {
+            LOG(WARNING) << "Beam steering message ignored, it must be a dictionary";
+            return;
+        }
+    pmt::pmt_t channel = pmt::dict_ref(msg, pmt::mp("channel"), pmt::PMT_NIL);
+    pmt::pmt_t azimuth = pmt::dict_ref(msg, pmt::mp("azimuth_deg"), pmt::PMT_NIL);
+    pmt::pmt_t elevation = pmt::dict_ref(msg, pmt::mp("elevation_deg"), pmt::PMT_NIL);
+    if (!pmt::is_integer(channel) || !pmt::is_real(azimuth) || !pmt::is_real(elevation))
+        {
+            LOG(WARNING) << "Beam steering message ignored, it needs channel, azimuth_deg and elevation_deg";
+            return;
+        }
+    // the channels after the last beam have no beam of their own
+    const long beam = pmt::to_long(channel);
+    if (beam < 0 || !set_direction(beam, pmt::to_double(azimuth), pmt::to_double(elevation)))
+        {
+            DLOG(INFO) << "No beam for channel " << beam;
+        }
+}
+
+
+int beam_steering::work(int noutput_items,gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items)
+{
+    GNSS_SDR_TRACE_SCOPE("beam_steering::work");
+    // the weights are not changed in the middle of a buffer. The dispatcher
+    // only sees the arrays of pointers, so the unaligned kernel is used
+    boost::mutex::scoped_lock lock(d_mutex);
+    if (d_timeout_samples > 0)
+        {
+            for (unsigned int beam = 0; beam < d_beams; beam++)
+                {
+                    if (d_steered[beam] && d_sample_counter - d_steered_at[beam] > d_timeout_samples)
+                        {
+                            // the satellite is no longer in the solution
+                            steer(beam, 0.0, 90.0);
+                            d_steered[beam] = false;
+                        }
+                }
+        }
+    volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn_u(reinterpret_cast<lv_32fc_t**>(&output_items[0]),
+            reinterpret_cast<const lv_32fc_t**>(&input_items[0]), &d_weights[0], d_beams, d_elements, noutput_items);
+    d_sample_counter += noutput_items;
+
+    return noutput_items;
+}
@@ -0,0 +1,118 @@
+/*!
+ * \file beam_steering.h
+ * \brief Forms one beam of an antenna array per receiver channel, steered
+ * to the satellite of the channel.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The beamformer combines the antennas into a single output, so all the
+ * channels share one beam. This block has one output per channel: the
+ * beam of each channel is pointed to the azimuth and elevation of its
+ * satellite, received from the PVT block. All the beams are formed at once
+ * with a matrix of weights, so the inputs are read once whatever the
+ * number of channels.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_BEAM_STEERING_H
+#define GNSS_SDR_BEAM_STEERING_H
+
+#include <vector>
+#include <boost/thread/mutex.hpp>
+#include <gnuradio/sync_block.h>
+#include <pmt/pmt.h>
+
+class beam_steering;
+typedef boost::shared_ptr<beam_steering> beam_steering_sptr;
+
+/*!
+ * \brief Makes a beam_steering block of \p elements antennas and \p beams
+ * outputs. The positions are east, north and up of each element, in meters
+ * from the reference point of the array. A beam that is not steered again
+ * within \p timeout_samples samples goes back to the zenith (never if 0).
+ */
+beam_steering_sptr make_beam_steering(unsigned int elements, unsigned int beams,
+        const std::vector<double> & positions_enu_m, double wavelength_m,
+        unsigned long long timeout_samples);
+
+/*!
+ * \brief Forms \p beams beams of an antenna array, each one steered with
+ * its own direction.
+ *
+ * A plane wave from the unit vector u (east, north, up) reaches the element
+ * at the position p with the phase 2 pi p.u / wavelength with respect to the
+ * reference point, so the weights of the beam are
+ * w_k = exp(-j 2 pi p_k.u / wavelength) / elements
+ * and the signal from u keeps its amplitude. All the beams point to the
+ * zenith at the start.
+ *
+ * The message port "beam_steering" takes a dictionary with the keys
+ * "channel", "azimuth_deg" and "elevation_deg", as published by the PVT
+ * block, and steers the beam of that channel.
+ */
+class beam_steering: public gr::sync_block
+{
+private:
+    friend beam_steering_sptr make_beam_steering(unsigned int elements, unsigned int beams,
+            const std::vector<double> & positions_enu_m, double wavelength_m,
+            unsigned long long timeout_samples);
+
+    beam_steering(unsigned int elements, unsigned int beams,
+            const std::vector<double> & positions_enu_m, double wavelength_m,
+            unsigned long long timeout_samples);
+
+    void msg_handler_beam_steering(pmt::pmt_t msg);
+
+    // weights of the beam from the direction, d_mutex locked
+    void steer(unsigned int beam, double azimuth_deg, double elevation_deg);
+
+    unsigned int d_elements;
+    unsigned int d_beams;
+    std::vector<double> d_positions;           // east, north and up of each element [m]
+    double d_wavelength_m;
+    unsigned long long d_timeout_samples;
+    unsigned long long d_sample_counter;
+    std::vector<gr_complex> d_weights;         // d_elements weights of each beam, beam by beam
+    std::vector<bool> d_steered;               // false while the beam points to the zenith
+    std::vector<unsigned long long> d_steered_at; // d_sample_counter of the last direction
+    boost::mutex d_mutex;
+
+public:
+    ~beam_steering();
+
+    /*!
+     * \brief Steers a beam, from any thread. Returns false if there is no
+     * such beam.
+     */
+    bool set_direction(unsigned int beam, double azimuth_deg, double elevation_deg);
+
+    //! Weights of one beam, one per element
+    std::vector<gr_complex> weights(unsigned int beam);
+
+    int work (int noutput_items, gr_vector_const_void_star &input_items,
+              gr_vector_void_star &output_items);
+};
+
+#endif
@@ -1,7 +1,7 @@
 /*!
  * \file beamformer.cc
  *
- * \brief Unpacks byte samples to NSR 2 bits samples
+ * \brief Simple spatial filter using RAW array input and beamforming coefficients
  * \author Javier Arribas jarribas (at) cttc.es
  * -------------------------------------------------------------------------
  *
@@ -30,65 +30,100 @@
 
 
 #include "beamformer.h"
-#include <iostream>
-#include <sstream>
+#include "gnss_sdr_trace.h"
+#include <boost/bind.hpp>
+#include <glog/logging.h>
 #include <gnuradio/io_signature.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
 
-#define GNSS_SDR_BEAMFORMER_CHANNELS 8
+using google::LogMessage;
 
-beamformer_sptr make_beamformer()
+static size_t beamformer_item_size(Beamformer_Item item_type)
 {
-    return beamformer_sptr(new beamformer());
+    return (item_type == BEAMFORMER_ITEM_CSHORT) ? sizeof(lv_16sc_t) : sizeof(gr_complex);
 }
 
 
-beamformer::beamformer()
+beamformer_sptr make_beamformer(unsigned int channels, Beamformer_Item item_type,
+        const std::vector<gr_complex> & weights)
+{
+    return beamformer_sptr(new beamformer(channels, item_type, weights));
+}
+
+
+beamformer::beamformer(unsigned int channels, Beamformer_Item item_type,
+        const std::vector<gr_complex> & weights)
 : gr::sync_block("beamformer",
-        gr::io_signature::make(GNSS_SDR_BEAMFORMER_CHANNELS, GNSS_SDR_BEAMFORMER_CHANNELS,sizeof(gr_complex)),
-        gr::io_signature::make(1, 1,sizeof(gr_complex)))
+        gr::io_signature::make(channels, channels, beamformer_item_size(item_type)),
+        gr::io_signature::make(1, 1, beamformer_item_size(item_type)))
 {
+    d_channels = channels;
+    d_item_type = item_type;
+
     //initialize weight vector
+    d_weights.assign(d_channels, gr_complex(1, 0));
+    if (!weights.empty() && !set_weights(weights))
+        {
+            LOG(WARNING) << "Beamformer with " << d_channels << " channels and "
+                         << weights.size() << " weights, using unit weights";
+        }
+
+    message_port_register_in(pmt::mp("weights"));
+    set_msg_handler(pmt::mp("weights"), boost::bind(&beamformer::msg_handler_weights, this, _1));
+}
+
+
+beamformer::~beamformer()
+{}
 
-    if (posix_memalign((void**)&weight_vector, 16, GNSS_SDR_BEAMFORMER_CHANNELS * sizeof(gr_complex)) == 0){};
 
-    for (int i = 0; i< GNSS_SDR_BEAMFORMER_CHANNELS; i++)
+bool beamformer::set_weights(const std::vector<gr_complex> & weights)
+{
+    if (weights.size() != d_channels)
         {
-            weight_vector[i]=gr_complex(1,0);
+            return false;
         }
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_weights = weights;
+    return true;
 }
 
 
-beamformer::~beamformer()
+std::vector<gr_complex> beamformer::weights()
 {
-    free(weight_vector);
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_weights;
+}
+
+
+void beamformer::msg_handler_weights(pmt::pmt_t msg)
+{
+    GNSS_SDR_TRACE_SCOPE("beamformer::msg_handler_weights");
+    pmt::pmt_t vector = pmt::is_pair(msg) ? pmt::cdr(msg) : msg;
+    if (!pmt::is_c32vector(vector) || !set_weights(pmt::c32vector_elements(vector)))
+        {
+            LOG(WARNING) << "Beamformer weights message ignored, it must be a c32vector of "
+                         << d_channels << " elements";
+        }
 }
 
 
 int beamformer::work(int noutput_items,gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
-    gr_complex *out = (gr_complex *) output_items[0];
-    // channel output buffers
-    //  gr_complex *ch1 = (gr_complex *) input_items[0];
-    //  gr_complex *ch2 = (gr_complex *) input_items[1];
-    //  gr_complex *ch3 = (gr_complex *) input_items[2];
-    //  gr_complex *ch4 = (gr_complex *) input_items[3];
-    //  gr_complex *ch5 = (gr_complex *) input_items[4];
-    //  gr_complex *ch6 = (gr_complex *) input_items[5];
-    //  gr_complex *ch7 = (gr_complex *) input_items[6];
-    //  gr_complex *ch8 = (gr_complex *) input_items[7];
-
-    // NON-VOLK beamforming operation
-    //TODO: Implement VOLK SIMD-accelerated beamformer!
-    gr_complex sum;
-    for(int n = 0; n < noutput_items; n++)
+    GNSS_SDR_TRACE_SCOPE("beamformer::work");
+    // the weights are not changed in the middle of a buffer. The dispatcher
+    // only sees the array of input pointers, so the unaligned kernels are used
+    boost::mutex::scoped_lock lock(d_mutex);
+    if (d_item_type == BEAMFORMER_ITEM_CSHORT)
+        {
+            volk_gnsssdr_16ic_xn_weighted_sum_16ic_u(static_cast<lv_16sc_t*>(output_items[0]),
+                    reinterpret_cast<const lv_16sc_t**>(&input_items[0]), &d_weights[0], d_channels, noutput_items);
+        }
+    else
         {
-            sum = gr_complex(0,0);
-            for (int i = 0; i < GNSS_SDR_BEAMFORMER_CHANNELS; i++)
-                {
-                    sum = sum + ((gr_complex*)input_items[i])[n] * weight_vector[i];
-                }
-            out[n] = sum;
+            volk_gnsssdr_32fc_xn_weighted_sum_32fc_u(static_cast<lv_32fc_t*>(output_items[0]),
+                    reinterpret_cast<const lv_32fc_t**>(&input_items[0]), &d_weights[0], d_channels, noutput_items);
         }
 
     return noutput_items;
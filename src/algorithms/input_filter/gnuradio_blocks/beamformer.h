@@ -3,6 +3,12 @@
  *
  * \brief Simple spatial filter using RAW array input and beamforming coefficients
  * \author Javier Arribas jarribas (at) cttc.es
+ *
+ * The output is the weighted sum of the antenna signals, computed with the
+ * VOLK_GNSSSDR kernels volk_gnsssdr_32fc_xn_weighted_sum_32fc and
+ * volk_gnsssdr_16ic_xn_weighted_sum_16ic. The weights can be replaced while
+ * the flowgraph runs, with set_weights() or a message on the "weights" port.
+ *
  * -------------------------------------------------------------------------
  *
  * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
@@ -31,27 +37,63 @@
 #ifndef GNSS_SDR_BEAMFORMER_H
 #define GNSS_SDR_BEAMFORMER_H
 
+#include <vector>
+#include <boost/thread/mutex.hpp>
 #include <gnuradio/sync_block.h>
+#include <pmt/pmt.h>
+
+/*!
+ * \brief Sample formats of beamformer, the same in the inputs and the output
+ */
+enum Beamformer_Item
+{
+    BEAMFORMER_ITEM_GR_COMPLEX = 0, //!< gr_complex
+    BEAMFORMER_ITEM_CSHORT = 1      //!< lv_16sc_t, the output rounded and saturated
+};
 
 class beamformer;
 typedef boost::shared_ptr<beamformer> beamformer_sptr;
 
-beamformer_sptr make_beamformer();
+/*!
+ * \brief Makes a beamformer of \p channels antennas. The weights must have
+ * one element per channel; if empty, all of them are 1.
+ */
+beamformer_sptr make_beamformer(unsigned int channels, Beamformer_Item item_type,
+        const std::vector<gr_complex> & weights);
 
 /*!
  * \brief This class implements a real-time software-defined spatial filter using the CTTC GNSS experimental antenna array input and a set of dynamically reloadable weights
+ *
+ * The message port "weights" takes a c32vector with one weight per channel,
+ * or a PDU (a pair) whose cdr is that vector. Wrong sizes are ignored.
  */
 class beamformer: public gr::sync_block
 {
 private:
-    friend beamformer_sptr
-    make_beamformer_sptr();
+    friend beamformer_sptr make_beamformer(unsigned int channels, Beamformer_Item item_type,
+            const std::vector<gr_complex> & weights);
+
+    beamformer(unsigned int channels, Beamformer_Item item_type,
+            const std::vector<gr_complex> & weights);
+
+    void msg_handler_weights(pmt::pmt_t msg);
 
-    gr_complex* weight_vector;
+    unsigned int d_channels;
+    Beamformer_Item d_item_type;
+    std::vector<gr_complex> d_weights;
+    boost::mutex d_mutex;
 
 public:
-    beamformer();
     ~beamformer();
+
+    /*!
+     * \brief Replaces the weights, from any thread. Returns false (and keeps
+     * the old ones) if there is not one weight per channel.
+     */
+    bool set_weights(const std::vector<gr_complex> & weights);
+
+    std::vector<gr_complex> weights();
+
     int work (int noutput_items, gr_vector_const_void_star &input_items,
               gr_vector_void_star &output_items);
 };
@@ -0,0 +1,147 @@
+/*!
+ * \file fft_fir_filter.cc
+ * \brief FIR filter computed in the frequency domain (overlap-save)
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "fft_fir_filter.h"
+#include <algorithm>
+#include <cstring>
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+#include "fft_planner.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
+
+using google::LogMessage;
+
+
+fft_fir_filter_sptr make_fft_fir_filter(const std::vector<float> & taps,
+        unsigned int decimation, bool cshort_in, bool cshort_out,
+        unsigned int fft_size)
+{
+    return fft_fir_filter_sptr(new fft_fir_filter(taps, decimation, cshort_in, cshort_out, fft_size));
+}
+
+
+fft_fir_filter::fft_fir_filter(const std::vector<float> & taps, unsigned int decimation,
+        bool cshort_in, bool cshort_out, unsigned int fft_size)
+: gr::sync_decimator("fft_fir_filter",
+        gr::io_signature::make(1, 1, cshort_in ? sizeof(lv_16sc_t) : sizeof(gr_complex)),
+        gr::io_signature::make(1, 1, cshort_out ? sizeof(lv_16sc_t) : sizeof(gr_complex)),
+        std::max(decimation, 1u))
+{
+    d_ntaps = std::max(static_cast<unsigned int>(taps.size()), 1u);
+    d_decimation = std::max(decimation, 1u);
+    d_cshort_in = cshort_in;
+    d_cshort_out = cshort_out;
+
+    unsigned int min_size = d_ntaps - 1 + d_decimation;
+    if (fft_size < min_size)
+        {
+            fft_size = Fft_Planner::fast_size(std::max(4 * d_ntaps, min_size));
+        }
+    d_fft_size = fft_size;
+    d_valid = (d_fft_size - d_ntaps + 1) / d_decimation * d_decimation;
+
+    d_fft = Fft_Planner::instance().acquire(d_fft_size, true);
+    d_ifft = Fft_Planner::instance().acquire(d_fft_size, false);
+
+    // Transform of the taps, zero-padded to the block length
+    gr_complex* buf = d_fft->get_inbuf();
+    std::fill(buf, buf + d_fft_size, gr_complex(0.0, 0.0));
+    for (unsigned int k = 0; k < taps.size(); k++)
+        {
+            buf[k] = gr_complex(taps[k], 0.0);
+        }
+    d_fft->execute();
+    d_taps_fft = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(gr_complex), volk_get_alignment()));
+    volk_32fc_s32fc_multiply_32fc(d_taps_fft, d_fft->get_outbuf(), gr_complex(1.0 / d_fft_size, 0.0), d_fft_size);
+
+    d_block_out = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_valid / d_decimation * sizeof(gr_complex), volk_get_alignment()));
+
+    set_history(d_ntaps);
+    set_output_multiple(d_valid / d_decimation);
+    DLOG(INFO) << "Overlap-save FIR filter of " << d_ntaps << " taps, FFT length " << d_fft_size
+               << ", " << d_valid << " samples per block";
+}
+
+
+fft_fir_filter::~fft_fir_filter()
+{
+    gnss_sdr_volk_free(d_taps_fft);
+    gnss_sdr_volk_free(d_block_out);
+}
+
+
+int fft_fir_filter::work(int noutput_items,
+        gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
+{
+    GNSS_SDR_TRACE_SCOPE("fft_fir_filter::work");
+    const unsigned int outputs_per_block = d_valid / d_decimation;
+    const unsigned int block_in = d_valid + d_ntaps - 1;   // input samples used by each block
+    gr_complex* fft_in = d_fft->get_inbuf();
+    gr_complex* ifft_in = d_ifft->get_inbuf();
+    const gr_complex* ifft_out = d_ifft->get_outbuf();
+
+    // The samples past block_in only reach the outputs that are discarded
+    std::fill(fft_in + block_in, fft_in + d_fft_size, gr_complex(0.0, 0.0));
+
+    for (unsigned int b = 0; b < static_cast<unsigned int>(noutput_items) / outputs_per_block; b++)
+        {
+            // With the history, input sample start is the first one of the overlap
+            unsigned int start = b * d_valid;
+            if (d_cshort_in)
+                {
+                    const lv_16sc_t* in = static_cast<const lv_16sc_t*>(input_items[0]) + start;
+                    volk_16i_s32f_convert_32f(reinterpret_cast<float*>(fft_in), reinterpret_cast<const int16_t*>(in), 1.0, 2 * block_in);
+                }
+            else
+                {
+                    const gr_complex* in = static_cast<const gr_complex*>(input_items[0]) + start;
+                    std::memcpy(fft_in, in, block_in * sizeof(gr_complex));
+                }
+            d_fft->execute();
+            volk_32fc_x2_multiply_32fc(ifft_in, d_fft->get_outbuf(), d_taps_fft, d_fft_size);
+            d_ifft->execute();
+
+            // The first d_ntaps - 1 outputs wrap around the block
+            gr_complex* out = d_cshort_out ? d_block_out
+                    : static_cast<gr_complex*>(output_items[0]) + b * outputs_per_block;
+            for (unsigned int j = 0; j < outputs_per_block; j++)
+                {
+                    out[j] = ifft_out[d_ntaps - 1 + j * d_decimation];
+                }
+            if (d_cshort_out)
+                {
+                    lv_16sc_t* out_16 = static_cast<lv_16sc_t*>(output_items[0]) + b * outputs_per_block;
+                    volk_32f_s32f_convert_16i(reinterpret_cast<int16_t*>(out_16), reinterpret_cast<const float*>(d_block_out), 1.0, 2 * outputs_per_block);
+                }
+        }
+    return noutput_items / outputs_per_block * outputs_per_block;
+}
@@ -0,0 +1,100 @@
+/*!
+ * \file fft_fir_filter.h
+ * \brief FIR filter computed in the frequency domain (overlap-save)
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_FFT_FIR_FILTER_H
+#define GNSS_SDR_FFT_FIR_FILTER_H
+
+#include <memory>
+#include <vector>
+#include <gnuradio/fft/fft.h>
+#include <gnuradio/sync_decimator.h>
+
+class fft_fir_filter;
+typedef boost::shared_ptr<fft_fir_filter> fft_fir_filter_sptr;
+
+/*!
+ * \brief Makes an fft_fir_filter block. Input and output items are either
+ * gr_complex or lv_16sc_t (\p cshort_in, \p cshort_out). If \p fft_size is 0,
+ * or too short for the taps and the decimation, a length of about four times
+ * the number of taps is chosen.
+ */
+fft_fir_filter_sptr make_fft_fir_filter(const std::vector<float> & taps,
+        unsigned int decimation, bool cshort_in, bool cshort_out,
+        unsigned int fft_size = 0);
+
+/*!
+ * \brief Real-tap FIR filter of complex samples, by overlap-save.
+ *
+ * Each block of fft_size input samples, which overlaps the previous one by
+ * taps.size() - 1 samples, is transformed, multiplied by the transform of
+ * the taps and transformed back. The last fft_size - taps.size() + 1
+ * samples are the linear convolution, and every decimation-th of them is
+ * output. The cost per sample grows with log(fft_size) instead of with the
+ * number of taps, which pays off for long filters.
+ *
+ * 16-bit samples are converted to float and back inside the block, with
+ * saturation, so that cshort streams need no extra conversion blocks.
+ * The output is the same as that of fir_filter_ccf with the same taps and
+ * decimation, up to the rounding of the FFT.
+ */
+class fft_fir_filter: public gr::sync_decimator
+{
+private:
+    friend fft_fir_filter_sptr make_fft_fir_filter(const std::vector<float> & taps,
+            unsigned int decimation, bool cshort_in, bool cshort_out,
+            unsigned int fft_size);
+
+    fft_fir_filter(const std::vector<float> & taps, unsigned int decimation,
+            bool cshort_in, bool cshort_out, unsigned int fft_size);
+
+    unsigned int d_ntaps;
+    unsigned int d_decimation;
+    bool d_cshort_in;
+    bool d_cshort_out;
+    unsigned int d_fft_size;
+    unsigned int d_valid;                      // convolution outputs of each block, multiple of d_decimation
+    std::shared_ptr<gr::fft::fft_complex> d_fft;
+    std::shared_ptr<gr::fft::fft_complex> d_ifft;
+    gr_complex* d_taps_fft;                    // transform of the taps, with the 1/fft_size of the inverse
+    gr_complex* d_block_out;                   // decimated outputs of one block, for cshort output
+
+public:
+    ~fft_fir_filter();
+
+    unsigned int fft_size() const
+    {
+        return d_fft_size;
+    }
+
+    int work (int noutput_items, gr_vector_const_void_star &input_items,
+              gr_vector_void_star &output_items);
+};
+
+#endif
@@ -0,0 +1,84 @@
+/*!
+ * \file pulse_blanking_notch.cc
+ * \brief Pulse blanking and adaptive notch block for interference environments
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "pulse_blanking_notch.h"
+#include "gnss_sdr_trace.h"
+#include <cmath>
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+
+
+pulse_blanking_notch_sptr make_pulse_blanking_notch(bool cshort, double sample_rate,
+        bool blanking, float threshold, unsigned int guard_samples,
+        bool notch, float notch_mu, float notch_pole, const std::string & role)
+{
+    return pulse_blanking_notch_sptr(new pulse_blanking_notch(cshort, sample_rate, blanking,
+            threshold, guard_samples, notch, notch_mu, notch_pole, role));
+}
+
+
+pulse_blanking_notch::pulse_blanking_notch(bool cshort, double sample_rate,
+        bool blanking, float threshold, unsigned int guard_samples,
+        bool notch, float notch_mu, float notch_pole, const std::string & role)
+: gr::sync_block("pulse_blanking_notch",
+        gr::io_signature::make(1, 1, cshort ? sizeof(lv_16sc_t) : sizeof(gr_complex)),
+        gr::io_signature::make(1, 1, cshort ? sizeof(lv_16sc_t) : sizeof(gr_complex))),
+  d_blanker(blanking, threshold, guard_samples, notch, notch_mu, notch_pole)
+{
+    d_cshort = cshort;
+    d_sample_rate = sample_rate;
+    d_counters = Gnss_Sdr_Interference_Monitor::counters(role);
+}
+
+
+pulse_blanking_notch::~pulse_blanking_notch()
+{}
+
+
+int pulse_blanking_notch::work(int noutput_items,
+        gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
+{
+    GNSS_SDR_TRACE_SCOPE("pulse_blanking_notch::work");
+    if (d_cshort)
+        {
+            d_blanker.process(static_cast<const lv_16sc_t*>(input_items[0]),
+                    static_cast<lv_16sc_t*>(output_items[0]), noutput_items);
+        }
+    else
+        {
+            d_blanker.process(static_cast<const gr_complex*>(input_items[0]),
+                    static_cast<gr_complex*>(output_items[0]), noutput_items);
+        }
+
+    const std::complex<float> z0 = d_blanker.notch_zero();
+    d_counters->set(d_blanker.samples(), d_blanker.blanked_samples(), d_blanker.pulses(),
+            d_blanker.noise_power(), std::arg(z0) * d_sample_rate / (2.0 * M_PI), std::abs(z0));
+    return noutput_items;
+}
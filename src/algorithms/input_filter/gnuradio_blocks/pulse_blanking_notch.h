@@ -0,0 +1,78 @@
+/*!
+ * \file pulse_blanking_notch.h
+ * \brief Pulse blanking and adaptive notch block for interference environments
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PULSE_BLANKING_NOTCH_H
+#define GNSS_SDR_PULSE_BLANKING_NOTCH_H
+
+#include <memory>
+#include <string>
+#include <gnuradio/sync_block.h>
+#include "gnss_sdr_interference_monitor.h"
+#include "pulse_blanker.h"
+
+class pulse_blanking_notch;
+typedef boost::shared_ptr<pulse_blanking_notch> pulse_blanking_notch_sptr;
+
+/*!
+ * \brief Makes a pulse_blanking_notch block of gr_complex items, or lv_16sc_t
+ * items if \p cshort. Its counters are published under \p role.
+ */
+pulse_blanking_notch_sptr make_pulse_blanking_notch(bool cshort, double sample_rate,
+        bool blanking, float threshold, unsigned int guard_samples,
+        bool notch, float notch_mu, float notch_pole, const std::string & role);
+
+/*!
+ * \brief Runs a Pulse_Blanker on the stream and publishes its counters
+ * through Gnss_Sdr_Interference_Monitor.
+ */
+class pulse_blanking_notch: public gr::sync_block
+{
+private:
+    friend pulse_blanking_notch_sptr make_pulse_blanking_notch(bool cshort, double sample_rate,
+            bool blanking, float threshold, unsigned int guard_samples,
+            bool notch, float notch_mu, float notch_pole, const std::string & role);
+
+    pulse_blanking_notch(bool cshort, double sample_rate,
+            bool blanking, float threshold, unsigned int guard_samples,
+            bool notch, float notch_mu, float notch_pole, const std::string & role);
+
+    bool d_cshort;
+    double d_sample_rate;
+    Pulse_Blanker d_blanker;
+    std::shared_ptr<Gnss_Sdr_Interference_Counters> d_counters;
+
+public:
+    ~pulse_blanking_notch();
+
+    int work (int noutput_items, gr_vector_const_void_star &input_items,
+              gr_vector_void_star &output_items);
+};
+
+#endif
@@ -0,0 +1,480 @@
+/*!
+ * \file acquisition_assistance.cc
+ * \brief Narrows the Doppler search of the acquisitions around the
+ *  predictions of the assistance map.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "acquisition_assistance.h"
+#include <atomic>
+#include <cmath>
+#include <glog/logging.h>
+#include "concurrent_map.h"
+#include "gps_acq_assist.h"
+#include "GPS_L1_CA.h"
+#include "GPS_L2C.h"
+#include "Galileo_E1.h"
+#include "Galileo_E5a.h"
+
+extern concurrent_map<Gps_Acq_Assist> global_gps_acq_assist_map;
+
+using google::LogMessage;
+
+static std::atomic<bool> acquisition_assistance_enabled(false);
+static std::atomic<bool> cross_band_enabled(false);
+static std::atomic<double> cross_band_uncertainty_hz(10.0);
+static std::atomic<bool> reacquisition_enabled(false);
+static std::atomic<double> reacquisition_window_s(10.0);
+static std::atomic<double> reacquisition_uncertainty_hz(50.0);
+static std::atomic<double> reacquisition_rate_uncertainty_hz_s(10.0);
+static std::atomic<bool> tracking_record_enabled(false);
+
+// The Doppler rate is measured over at least this time, to average the noise of the carrier loop [s]
+#define REACQUISITION_RATE_BASELINE_S 1.0
+
+// Doppler shift tracked on L1 C/A or E1, by PRN, NaN if the satellite is not tracked
+#define CROSS_BAND_MAX_PRN 64
+
+struct Tracked_Doppler
+{
+    std::atomic<double> doppler_hz[2][CROSS_BAND_MAX_PRN];
+    Tracked_Doppler()
+    {
+        for (int system = 0; system < 2; system++)
+            {
+                for (int prn = 0; prn < CROSS_BAND_MAX_PRN; prn++)
+                    {
+                        doppler_hz[system][prn] = std::nan("");
+                    }
+            }
+    }
+};
+
+
+static Tracked_Doppler& tracked_doppler()
+{
+    static Tracked_Doppler tracked;
+    return tracked;
+}
+
+
+// Last tracked state of an L1 C/A or E1 satellite, written by the channel that tracks it
+struct Tracked_State
+{
+    std::atomic<double> doppler_hz;
+    std::atomic<double> doppler_rate_hz_s;
+    std::atomic<double> time_s;               // Tracking_timestamp_secs of the last locked epoch
+    std::atomic<double> rate_start_doppler_hz;
+    std::atomic<double> rate_start_time_s;    // start of the current measurement of the rate
+    std::atomic<bool> lost;                   // set by withdraw_tracking(), once the values are final
+};
+
+
+struct Reacquisition_Memory
+{
+    Tracked_State state[2][CROSS_BAND_MAX_PRN];
+    Reacquisition_Memory()
+    {
+        for (int system = 0; system < 2; system++)
+            {
+                for (int prn = 0; prn < CROSS_BAND_MAX_PRN; prn++)
+                    {
+                        Tracked_State & s = state[system][prn];
+                        s.doppler_hz = 0.0;
+                        s.doppler_rate_hz_s = 0.0;
+                        s.time_s = std::nan("");
+                        s.rate_start_doppler_hz = 0.0;
+                        s.rate_start_time_s = std::nan("");
+                        s.lost = false;
+                    }
+            }
+    }
+};
+
+
+static Reacquisition_Memory& reacquisition_memory()
+{
+    static Reacquisition_Memory memory;
+    return memory;
+}
+
+
+// Slot of the satellite of a first band signal, or -1
+static int first_band_system(const Gnss_Synchro & synchro)
+{
+    if (synchro.PRN >= CROSS_BAND_MAX_PRN)
+        {
+            return -1;
+        }
+    if (synchro.System == 'G' && synchro.Signal[0] == '1' && synchro.Signal[1] == 'C')
+        {
+            return 0;
+        }
+    if (synchro.System == 'E' && synchro.Signal[0] == '1' && synchro.Signal[1] == 'B')
+        {
+            return 1;
+        }
+    return -1;
+}
+
+
+void Acquisition_Assistance::set_enabled(bool enabled)
+{
+    acquisition_assistance_enabled = enabled;
+}
+
+
+bool Acquisition_Assistance::enabled()
+{
+    return acquisition_assistance_enabled;
+}
+
+
+void Acquisition_Assistance::set_cross_band(bool enabled, double doppler_uncertainty_hz)
+{
+    cross_band_uncertainty_hz = doppler_uncertainty_hz;
+    cross_band_enabled = enabled;
+    if (!enabled)
+        {
+            Tracked_Doppler& tracked = tracked_doppler();
+            for (int system = 0; system < 2; system++)
+                {
+                    for (int prn = 0; prn < CROSS_BAND_MAX_PRN; prn++)
+                        {
+                            tracked.doppler_hz[system][prn] = std::nan("");
+                        }
+                }
+        }
+}
+
+
+bool Acquisition_Assistance::cross_band()
+{
+    return cross_band_enabled;
+}
+
+
+bool Acquisition_Assistance::cross_band_tracked(char system, unsigned int prn)
+{
+    const int slot = system == 'G' ? 0 : (system == 'E' ? 1 : -1);
+    if (!cross_band_enabled || slot < 0 || prn >= CROSS_BAND_MAX_PRN)
+        {
+            return false;
+        }
+    return !std::isnan(tracked_doppler().doppler_hz[slot][prn].load(std::memory_order_relaxed));
+}
+
+
+void Acquisition_Assistance::set_reacquisition(bool enabled, double window_s, double doppler_uncertainty_hz,
+        double doppler_rate_uncertainty_hz_s)
+{
+    reacquisition_window_s = window_s;
+    reacquisition_uncertainty_hz = doppler_uncertainty_hz;
+    reacquisition_rate_uncertainty_hz_s = doppler_rate_uncertainty_hz_s;
+    reacquisition_enabled = enabled;
+    if (!enabled)
+        {
+            Reacquisition_Memory& memory = reacquisition_memory();
+            for (int system = 0; system < 2; system++)
+                {
+                    for (int prn = 0; prn < CROSS_BAND_MAX_PRN; prn++)
+                        {
+                            memory.state[system][prn].lost = false;
+                        }
+                }
+        }
+}
+
+
+bool Acquisition_Assistance::reacquisition()
+{
+    return reacquisition_enabled;
+}
+
+
+void Acquisition_Assistance::set_tracking_record(bool enabled)
+{
+    tracking_record_enabled = enabled;
+}
+
+
+std::vector<Acquisition_Assistance::Tracked_Satellite> Acquisition_Assistance::tracked_satellites()
+{
+    std::vector<Tracked_Satellite> satellites;
+    Reacquisition_Memory& memory = reacquisition_memory();
+    for (int system = 0; system < 2; system++)
+        {
+            for (int prn = 0; prn < CROSS_BAND_MAX_PRN; prn++)
+                {
+                    const Tracked_State & state = memory.state[system][prn];
+                    if (state.lost.load(std::memory_order_acquire))
+                        {
+                            continue;
+                        }
+                    Tracked_Satellite satellite;
+                    satellite.time_s = state.time_s.load(std::memory_order_relaxed);
+                    if (std::isnan(satellite.time_s))
+                        {
+                            continue;
+                        }
+                    satellite.system = system == 0 ? 'G' : 'E';
+                    satellite.prn = prn;
+                    satellite.doppler_hz = state.doppler_hz.load(std::memory_order_relaxed);
+                    satellite.doppler_rate_hz_s = state.doppler_rate_hz_s.load(std::memory_order_relaxed);
+                    satellites.push_back(satellite);
+                }
+        }
+    return satellites;
+}
+
+
+void Acquisition_Assistance::restore_tracking(const std::vector<Tracked_Satellite> & satellites, double time_offset_s)
+{
+    Reacquisition_Memory& memory = reacquisition_memory();
+    for (unsigned int i = 0; i < satellites.size(); i++)
+        {
+            const Tracked_Satellite & satellite = satellites[i];
+            const int system = satellite.system == 'G' ? 0 : (satellite.system == 'E' ? 1 : -1);
+            if (system < 0 || satellite.prn >= CROSS_BAND_MAX_PRN)
+                {
+                    continue;
+                }
+            Tracked_State & state = memory.state[system][satellite.prn];
+            state.doppler_hz.store(satellite.doppler_hz, std::memory_order_relaxed);
+            state.doppler_rate_hz_s.store(satellite.doppler_rate_hz_s, std::memory_order_relaxed);
+            state.time_s.store(satellite.time_s - time_offset_s, std::memory_order_relaxed);
+            // the rate is measured again once the satellite is tracked
+            state.rate_start_time_s.store(std::nan(""), std::memory_order_relaxed);
+            state.lost.store(true, std::memory_order_release);
+        }
+}
+
+
+static void remember_tracking(Tracked_State & state, const Gnss_Synchro & synchro)
+{
+    double time_s = synchro.Tracking_timestamp_secs;
+    double doppler_hz = synchro.Carrier_Doppler_hz;
+    double baseline_s = time_s - state.rate_start_time_s.load(std::memory_order_relaxed);
+    if (!(baseline_s >= 0.0))
+        {
+            // first epoch, or the time went back
+            state.rate_start_doppler_hz.store(doppler_hz, std::memory_order_relaxed);
+            state.rate_start_time_s.store(time_s, std::memory_order_relaxed);
+            state.doppler_rate_hz_s.store(0.0, std::memory_order_relaxed);
+        }
+    else if (baseline_s >= REACQUISITION_RATE_BASELINE_S)
+        {
+            double rate = (doppler_hz - state.rate_start_doppler_hz.load(std::memory_order_relaxed)) / baseline_s;
+            state.doppler_rate_hz_s.store(rate, std::memory_order_relaxed);
+            state.rate_start_doppler_hz.store(doppler_hz, std::memory_order_relaxed);
+            state.rate_start_time_s.store(time_s, std::memory_order_relaxed);
+        }
+    state.doppler_hz.store(doppler_hz, std::memory_order_relaxed);
+    state.time_s.store(time_s, std::memory_order_relaxed);
+    state.lost.store(false, std::memory_order_relaxed);
+}
+
+
+void Acquisition_Assistance::publish_tracking(const Gnss_Synchro & synchro)
+{
+    if (!cross_band_enabled && !reacquisition_enabled && !tracking_record_enabled)
+        {
+            return;
+        }
+    int system = first_band_system(synchro);
+    if (system < 0)
+        {
+            return;
+        }
+    if (cross_band_enabled)
+        {
+            tracked_doppler().doppler_hz[system][synchro.PRN].store(synchro.Carrier_Doppler_hz, std::memory_order_relaxed);
+        }
+    if (reacquisition_enabled || tracking_record_enabled)
+        {
+            remember_tracking(reacquisition_memory().state[system][synchro.PRN], synchro);
+        }
+}
+
+
+void Acquisition_Assistance::withdraw_tracking(const Gnss_Synchro & synchro)
+{
+    int system = first_band_system(synchro);
+    if (system >= 0)
+        {
+            tracked_doppler().doppler_hz[system][synchro.PRN].store(std::nan(""), std::memory_order_relaxed);
+            // the values of the last epoch are visible to whoever sees the loss
+            reacquisition_memory().state[system][synchro.PRN].lost.store(reacquisition_enabled || tracking_record_enabled, std::memory_order_release);
+        }
+}
+
+
+// Doppler shift of the satellite of synchro at time_s, from its last tracked epoch
+static bool remembered_doppler(const Gnss_Synchro & synchro, double time_s, double & doppler_hz, double & uncertainty_hz)
+{
+    if (!reacquisition_enabled || time_s < 0.0)
+        {
+            return false;
+        }
+    int system = first_band_system(synchro);
+    if (system < 0)
+        {
+            return false;
+        }
+    const Tracked_State & state = reacquisition_memory().state[system][synchro.PRN];
+    if (!state.lost.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+    double elapsed_s = time_s - state.time_s.load(std::memory_order_relaxed);
+    if (!(elapsed_s >= 0.0) || elapsed_s > reacquisition_window_s)
+        {
+            return false;
+        }
+    doppler_hz = state.doppler_hz.load(std::memory_order_relaxed) + state.doppler_rate_hz_s.load(std::memory_order_relaxed) * elapsed_s;
+    uncertainty_hz = reacquisition_uncertainty_hz + reacquisition_rate_uncertainty_hz_s * elapsed_s;
+    return true;
+}
+
+
+// Doppler shift of the second band signal of synchro, scaled from the first band
+static bool cross_band_doppler(const Gnss_Synchro & synchro, double & doppler_hz)
+{
+    if (!cross_band_enabled || synchro.PRN >= CROSS_BAND_MAX_PRN)
+        {
+            return false;
+        }
+    int system;
+    double carrier_ratio;
+    if (synchro.System == 'G' && synchro.Signal[0] == '2' && synchro.Signal[1] == 'S')
+        {
+            system = 0;
+            carrier_ratio = GPS_L2_FREQ_HZ / GPS_L1_FREQ_HZ;
+        }
+    else if (synchro.System == 'E' && synchro.Signal[0] == '5' && synchro.Signal[1] == 'X')
+        {
+            system = 1;
+            carrier_ratio = Galileo_E5a_FREQ_HZ / Galileo_E1_FREQ_HZ;
+        }
+    else
+        {
+            return false;
+        }
+    double tracked = tracked_doppler().doppler_hz[system][synchro.PRN].load(std::memory_order_relaxed);
+    if (std::isnan(tracked))
+        {
+            return false;
+        }
+    doppler_hz = tracked * carrier_ratio;
+    return true;
+}
+
+
+// Window of the bins around center_hz, true if it is narrower than the full search
+static bool lattice_window(double center_hz, double uncertainty_hz, unsigned int doppler_max, unsigned int doppler_step,
+        int & doppler_center, unsigned int & doppler_half_width)
+{
+    // The centre is rounded to the lattice of the bins, and each bin covers half a step
+    // on each side of it, so the window grows by one step to cover the whole uncertainty
+    double step = static_cast<double>(doppler_step);
+    double half_width_hz = uncertainty_hz + step;
+    unsigned int half_width = static_cast<unsigned int>(std::ceil(half_width_hz / step)) * doppler_step;
+    if (half_width >= doppler_max)
+        {
+            return false;
+        }
+    doppler_center = static_cast<int>(std::round(center_hz / step)) * static_cast<int>(doppler_step);
+    doppler_half_width = half_width;
+    return true;
+}
+
+
+bool Acquisition_Assistance::doppler_window(const Gnss_Synchro & synchro, unsigned int doppler_max, unsigned int doppler_step,
+        int & doppler_center, unsigned int & doppler_half_width, double time_s)
+{
+    doppler_center = 0;
+    doppler_half_width = doppler_max;
+    if (doppler_step == 0)
+        {
+            return false;
+        }
+
+    double cross_band_center_hz;
+    if (cross_band_doppler(synchro, cross_band_center_hz)
+            && lattice_window(cross_band_center_hz, cross_band_uncertainty_hz, doppler_max, doppler_step,
+                    doppler_center, doppler_half_width))
+        {
+            DLOG(INFO) << synchro.System << " PRN " << synchro.PRN << " signal " << std::string(synchro.Signal, 2)
+                       << ": Doppler search of " << doppler_center << " +/- " << doppler_half_width
+                       << " [Hz] around the first band";
+            return true;
+        }
+
+    double remembered_hz;
+    double remembered_uncertainty_hz;
+    if (remembered_doppler(synchro, time_s, remembered_hz, remembered_uncertainty_hz)
+            && lattice_window(remembered_hz, remembered_uncertainty_hz, doppler_max, doppler_step,
+                    doppler_center, doppler_half_width))
+        {
+            DLOG(INFO) << synchro.System << " PRN " << synchro.PRN << " signal " << std::string(synchro.Signal, 2)
+                       << ": Doppler search of " << doppler_center << " +/- " << doppler_half_width
+                       << " [Hz] around the loss of lock";
+            return true;
+        }
+
+    if (!enabled() || synchro.System != 'G')
+        {
+            return false;
+        }
+
+    // The map holds the Doppler shift of L1, as SUPL does
+    double carrier_ratio = 1.0;
+    std::string signal = std::string(synchro.Signal, 2);
+    if (signal.compare("2S") == 0)
+        {
+            carrier_ratio = GPS_L2_FREQ_HZ / GPS_L1_FREQ_HZ;
+        }
+    else if (signal.compare("1C") != 0)
+        {
+            return false;
+        }
+
+    Gps_Acq_Assist assistance;
+    if (!global_gps_acq_assist_map.read(synchro.PRN, assistance) || assistance.dopplerUncertainty <= 0.0)
+        {
+            return false;
+        }
+
+    if (!lattice_window(assistance.d_Doppler0 * carrier_ratio, assistance.dopplerUncertainty * carrier_ratio,
+            doppler_max, doppler_step, doppler_center, doppler_half_width))
+        {
+            return false;
+        }
+    DLOG(INFO) << "GPS PRN " << synchro.PRN << " signal " << signal << ": assisted Doppler search of "
+               << doppler_center << " +/- " << doppler_half_width << " [Hz]";
+    return true;
+}
@@ -0,0 +1,137 @@
+/*!
+ * \file acquisition_assistance.h
+ * \brief Narrows the Doppler search of the acquisitions around the
+ *  predictions of the assistance map.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * global_gps_acq_assist_map holds, for each GPS PRN, the Doppler shift of
+ * L1 predicted from SUPL or, once the receiver has a position and its own
+ * ephemerides, by the satellite scheduler of the flowgraph. When the
+ * assistance is enabled, the PCPS acquisitions only search the bins around
+ * that prediction, and the full grid otherwise.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_ACQUISITION_ASSISTANCE_H_
+#define GNSS_SDR_ACQUISITION_ASSISTANCE_H_
+
+#include <vector>
+#include "gnss_synchro.h"
+
+class Acquisition_Assistance
+{
+public:
+    //! Last tracked epoch of an L1 C/A or E1 satellite
+    struct Tracked_Satellite
+    {
+        char system;               // 'G' or 'E'
+        unsigned int prn;
+        double doppler_hz;
+        double doppler_rate_hz_s;
+        double time_s;             // Tracking_timestamp_secs of the epoch
+    };
+
+    //! Enables the assistance for all the acquisitions (disabled by default)
+    static void set_enabled(bool enabled);
+
+    static bool enabled();
+
+    /*!
+     * \brief Lets the L1 C/A and E1 tracking channels seed the L2C and E5a
+     * acquisitions of the same satellites (disabled by default).
+     * \param doppler_uncertainty_hz - uncertainty of the scaled Doppler shift, as
+     * the dopplerUncertainty of the assistance data [Hz].
+     */
+    static void set_cross_band(bool enabled, double doppler_uncertainty_hz);
+
+    static bool cross_band();
+
+    /*!
+     * \brief True if the cross band aiding is enabled and the satellite is tracked
+     * on L1 C/A (\p system 'G') or E1 (\p system 'E'), by a channel of any source.
+     */
+    static bool cross_band_tracked(char system, unsigned int prn);
+
+    /*!
+     * \brief Lets the L1 C/A and E1 acquisitions search around the Doppler shift
+     * last tracked for the same satellite, for window_s seconds after a loss of
+     * lock (disabled by default). The Doppler shift is propagated with the
+     * Doppler rate measured while tracking, and the uncertainty grows with the
+     * time since the last tracked epoch, so the search widens back to the full
+     * one if the satellite stays lost.
+     * \param doppler_uncertainty_hz - uncertainty at the last tracked epoch [Hz].
+     * \param doppler_rate_uncertainty_hz_s - growth of the uncertainty [Hz/s].
+     */
+    static void set_reacquisition(bool enabled, double window_s, double doppler_uncertainty_hz,
+            double doppler_rate_uncertainty_hz_s);
+
+    static bool reacquisition();
+
+    /*!
+     * \brief Keeps the last tracked epoch of the L1 C/A and E1 satellites for
+     * tracked_satellites() even if the reacquisition memory is disabled, without
+     * narrowing any search (disabled by default).
+     */
+    static void set_tracking_record(bool enabled);
+
+    //! Satellites locked now, with their last tracked epoch
+    static std::vector<Tracked_Satellite> tracked_satellites();
+
+    /*!
+     * \brief Remembers \p satellites as lost at their time_s minus \p time_offset_s,
+     * so that, with the reacquisition memory enabled, the acquisitions of a
+     * receiver that resumes a capture search around their Doppler shifts.
+     */
+    static void restore_tracking(const std::vector<Tracked_Satellite> & satellites, double time_offset_s);
+
+    //! Called by the L1 C/A and E1 tracking blocks at every locked epoch
+    static void publish_tracking(const Gnss_Synchro & synchro);
+
+    //! Called by the L1 C/A and E1 tracking blocks when they lose the lock
+    static void withdraw_tracking(const Gnss_Synchro & synchro);
+
+    /*!
+     * \brief Doppler window to search for the satellite and signal of \p synchro.
+     * Both values are multiples of \p doppler_step, so that the bins fall on the
+     * same lattice as the full search, and the window covers the uncertainty
+     * of the prediction. The Doppler shift tracked on L1 C/A (E1) for the same
+     * satellite, scaled to the carrier of L2C (E5a), takes precedence over the
+     * Doppler shift remembered from a recent loss of lock, which takes
+     * precedence over the assistance data.
+     * The PCPS blocks call it at the start of each acquisition, in
+     * update_doppler_window(), and rebuild their grid when the window changes.
+     * \param doppler_max - half width of the full search [Hz].
+     * \param doppler_center - centre of the window, 0 without assistance [Hz].
+     * \param doppler_half_width - half width of the window, at most \p doppler_max [Hz].
+     * \param time_s - sample counter of the acquisition over the sampling rate, the
+     * time base of Tracking_timestamp_secs; negative to skip the loss of lock memory [s].
+     * \return true if the window is narrower than the full search.
+     */
+    static bool doppler_window(const Gnss_Synchro & synchro, unsigned int doppler_max, unsigned int doppler_step,
+            int & doppler_center, unsigned int & doppler_half_width, double time_s = -1.0);
+};
+
+#endif /* GNSS_SDR_ACQUISITION_ASSISTANCE_H_ */
@@ -0,0 +1,153 @@
+/*!
+ * \file acquisition_decimator.cc
+ * \brief Dwells decimated to a lower acquisition rate, and code delays refined at the input rate
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "acquisition_decimator.h"
+#include "gnss_sdr_memory_accounting.h"
+#include <algorithm>
+#include <cmath>
+#include <volk/volk.h>
+
+namespace
+{
+// Taps of the filter per unit of decimation, on each side of the center
+const unsigned int HALF_TAPS_PER_DECIMATION = 4;
+const double PI = 3.1415926535897932384626433832795;
+}
+
+
+Acquisition_Decimator::Acquisition_Decimator(unsigned int decimation, unsigned int dwell_samples)
+{
+    d_decimation = std::max(decimation, 1u);
+    d_dwell_samples = dwell_samples / d_decimation * d_decimation;
+
+    // Hamming windowed sinc, cut at half the decimated rate, unit gain at DC
+    const unsigned int half = HALF_TAPS_PER_DECIMATION * d_decimation;
+    const unsigned int ntaps = 2 * half + 1;
+    const double cutoff = 0.5 / static_cast<double>(d_decimation);
+    d_taps.resize(ntaps);
+    double sum = 0.0;
+    for (unsigned int t = 0; t < ntaps; t++)
+        {
+            const double n = static_cast<double>(t) - static_cast<double>(half);
+            const double sinc = (t == half) ? 2.0 * cutoff : std::sin(2.0 * PI * cutoff * n) / (PI * n);
+            const double window = 0.54 - 0.46 * std::cos(2.0 * PI * static_cast<double>(t) / static_cast<double>(ntaps - 1));
+            d_taps[t] = static_cast<float>(sinc * window);
+            sum += d_taps[t];
+        }
+    for (unsigned int t = 0; t < ntaps; t++)
+        {
+            d_taps[t] = static_cast<float>(d_taps[t] / sum);
+        }
+
+    d_extended = static_cast<std::complex<float>*>(gnss_sdr_volk_malloc((d_dwell_samples + ntaps - 1) * sizeof(std::complex<float>), volk_get_alignment()));
+    d_wiped = static_cast<std::complex<float>*>(gnss_sdr_volk_malloc(d_dwell_samples * sizeof(std::complex<float>), volk_get_alignment()));
+    d_folded = nullptr;
+    d_folded_capacity = 0;
+}
+
+
+Acquisition_Decimator::~Acquisition_Decimator()
+{
+    gnss_sdr_volk_free(d_extended);
+    gnss_sdr_volk_free(d_wiped);
+    gnss_sdr_volk_free(d_folded);
+}
+
+
+void Acquisition_Decimator::decimate(const std::complex<float>* in, std::complex<float>* out)
+{
+    const unsigned int ntaps = d_taps.size();
+    const unsigned int half = ntaps / 2;
+    const unsigned int length = d_dwell_samples;
+    if (length == 0) return;
+
+    // extended[i] = in[(i - half) mod length], so that the output m is
+    // centered on the input m decimation
+    for (unsigned int i = 0; i < length + ntaps - 1; i++)
+        {
+            d_extended[i] = in[(i + length - half % length) % length];
+        }
+    for (unsigned int m = 0; m < length / d_decimation; m++)
+        {
+            volk_32fc_32f_dot_prod_32fc(&out[m], d_extended + m * d_decimation, d_taps.data(), ntaps);
+        }
+}
+
+
+unsigned int Acquisition_Decimator::refine(const std::complex<float>* in, const std::complex<float>* code, unsigned int code_length,
+        unsigned int coarse_delay, double carrier_hz, double fs_in)
+{
+    if (code_length == 0 || d_dwell_samples < code_length)
+        {
+            return coarse_delay;
+        }
+    if (code_length > d_folded_capacity)
+        {
+            gnss_sdr_volk_free(d_folded);
+            d_folded = static_cast<std::complex<float>*>(gnss_sdr_volk_malloc(code_length * sizeof(std::complex<float>), volk_get_alignment()));
+            d_folded_capacity = code_length;
+        }
+
+    // Carrier wipe-off, then the sum of the code periods of the dwell
+    const unsigned int periods = d_dwell_samples / code_length;
+    const double phase_step = -2.0 * PI * carrier_hz / fs_in;
+    const std::complex<float> phase_inc(std::cos(phase_step), std::sin(phase_step));
+    std::complex<float> phase(1.0, 0.0);
+    volk_32fc_s32fc_x2_rotator_32fc(d_wiped, in, phase_inc, &phase, periods * code_length);
+    std::copy(d_wiped, d_wiped + code_length, d_folded);
+    for (unsigned int p = 1; p < periods; p++)
+        {
+            volk_32fc_x2_add_32fc(d_folded, d_folded, d_wiped + p * code_length, code_length);
+        }
+
+    // Circular correlation sum_i folded[(i + k) mod L] conj(code[i]) at the
+    // candidate delays k around the coarse one
+    unsigned int best = coarse_delay % code_length;
+    float best_power = -1.0;
+    const unsigned int span = d_decimation;
+    for (unsigned int c = 0; c <= 2 * span; c++)
+        {
+            const unsigned int k = (coarse_delay % code_length + code_length - span % code_length + c) % code_length;
+            std::complex<float> head(0.0, 0.0);
+            std::complex<float> tail(0.0, 0.0);
+            volk_32fc_x2_conjugate_dot_prod_32fc(&head, d_folded + k, code, code_length - k);
+            if (k > 0)
+                {
+                    volk_32fc_x2_conjugate_dot_prod_32fc(&tail, d_folded, code + code_length - k, k);
+                }
+            const float power = std::norm(head + tail);
+            if (power > best_power)
+                {
+                    best_power = power;
+                    best = k;
+                }
+        }
+    return best;
+}
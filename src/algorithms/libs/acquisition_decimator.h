@@ -0,0 +1,103 @@
+/*!
+ * \file acquisition_decimator.h
+ * \brief Dwells decimated to a lower acquisition rate, and code delays refined at the input rate
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The main lobe of the GPS L1 C/A spectrum is 2.046 MHz wide, so the
+ * search grid of a front end sampling at 8 to 25 Msps has several times
+ * the cells it needs. Searched at about 2 Msps, with FFTs that much
+ * shorter, the dwell gives the same Doppler bin and a code delay within
+ * one decimated sample. A few direct correlations at the input rate
+ * around it give back the delay resolution of the input.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_ACQUISITION_DECIMATOR_H_
+#define GNSS_SDR_ACQUISITION_DECIMATOR_H_
+
+#include <complex>
+#include <vector>
+
+/*!
+ * \brief Low-pass filter and decimation of a dwell, and refinement of the
+ * code delay found in the decimated dwell
+ *
+ * The filter is a zero-phase Hamming windowed sinc of 8 decimation + 1
+ * taps, with its cutoff at the Nyquist frequency of the decimated rate.
+ * The dwell is filtered circularly, as the circular correlation of the
+ * search sees it, so the decimated code delays are those of the input
+ * divided by the decimation. The filter runs on the VOLK dot product.
+ */
+class Acquisition_Decimator
+{
+public:
+    //! For dwells of \p dwell_samples samples, a multiple of \p decimation
+    Acquisition_Decimator(unsigned int decimation, unsigned int dwell_samples);
+    ~Acquisition_Decimator();
+
+    unsigned int decimation() const
+    {
+        return d_decimation;
+    }
+
+    //! Samples of a decimated dwell
+    unsigned int decimated_samples() const
+    {
+        return d_dwell_samples / d_decimation;
+    }
+
+    //! Filters and decimates a dwell of \p in into \p out, of decimated_samples()
+    void decimate(const std::complex<float>* in, std::complex<float>* out);
+
+    /*!
+     * \brief Code delay of the dwell \p in at the input rate, within one
+     * decimated sample of \p coarse_delay, found in the decimated dwell.
+     * The carrier at \p carrier_hz (intermediate frequency plus Doppler
+     * shift) is wiped off, the code periods of the dwell are added, and
+     * the sum is correlated with \p code, one period of code_length input
+     * samples, at each of the 2 decimation + 1 candidate delays.
+     * \param fs_in - input rate [Hz].
+     * \return the delay of the largest correlation [input samples].
+     */
+    unsigned int refine(const std::complex<float>* in, const std::complex<float>* code, unsigned int code_length,
+            unsigned int coarse_delay, double carrier_hz, double fs_in);
+
+    const std::vector<float> & taps() const
+    {
+        return d_taps;
+    }
+
+private:
+    unsigned int d_decimation;
+    unsigned int d_dwell_samples;
+    std::vector<float> d_taps;
+    std::complex<float>* d_extended;  // the dwell with the taps wrapped around on each side
+    std::complex<float>* d_wiped;     // the dwell without its carrier
+    std::complex<float>* d_folded;    // its code periods added
+    unsigned int d_folded_capacity;
+};
+
+#endif /* GNSS_SDR_ACQUISITION_DECIMATOR_H_ */
@@ -0,0 +1,157 @@
+/*!
+ * \file acquisition_grid_dump.cc
+ * \brief Dump of the search grids of an acquisition block to one binary file
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "acquisition_grid_dump.h"
+#include <algorithm>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+
+Acquisition_Grid_Dump::Acquisition_Grid_Dump(unsigned int delay_decimation, unsigned int roi_delays, unsigned int roi_doppler_bins)
+    : d_writer("acquisition_grid", 1, true)
+{
+    d_failed = false;
+    d_decimation = std::max(delay_decimation, 1u);
+    d_roi_delays = roi_delays;
+    d_roi_bins = roi_doppler_bins;
+    d_bins = 0;
+    d_delays = 0;
+    d_rows = 0;
+    d_columns = 0;
+    d_searches = 0;
+}
+
+
+void Acquisition_Grid_Dump::begin(unsigned int num_doppler_bins, unsigned int num_delays)
+{
+    d_bins = num_doppler_bins;
+    d_delays = num_delays;
+    const size_t cells = static_cast<size_t>(d_bins) * d_delays;
+    if (d_grid.size() < cells)
+        {
+            d_grid.resize(cells);
+        }
+}
+
+
+bool Acquisition_Grid_Dump::open(const std::string & filename)
+{
+    const unsigned int decimated = (d_delays + d_decimation - 1) / d_decimation;
+    d_columns = decimated;
+    if (d_roi_delays > 0)
+        {
+            const unsigned int half = (d_roi_delays + d_decimation - 1) / d_decimation;
+            d_columns = std::min(2 * half + 1, decimated);
+        }
+    d_rows = d_bins;
+    if (d_roi_bins > 0)
+        {
+            d_rows = std::min(2 * d_roi_bins + 1, d_bins);
+        }
+    d_stored.resize(static_cast<size_t>(d_rows) * d_columns);
+
+    d_writer.add_field("search", BINARY_DUMP_UINT32);
+    d_writer.add_field("samplestamp", BINARY_DUMP_UINT64);
+    d_writer.add_field("prn", BINARY_DUMP_UINT32);
+    d_writer.add_field("well_count", BINARY_DUMP_UINT32);
+    d_writer.add_field("doppler_bins", BINARY_DUMP_UINT32);
+    d_writer.add_field("first_doppler_hz", BINARY_DUMP_FLOAT64);
+    d_writer.add_field("doppler_step_hz", BINARY_DUMP_FLOAT64);
+    d_writer.add_field("first_delay_samples", BINARY_DUMP_UINT32);
+    d_writer.add_field("delay_step_samples", BINARY_DUMP_UINT32);
+    d_writer.add_field("delays", BINARY_DUMP_UINT32);
+    d_writer.add_field("peak_doppler_hz", BINARY_DUMP_FLOAT64);
+    d_writer.add_field("peak_delay_samples", BINARY_DUMP_UINT32);
+    d_writer.add_field("test_statistic", BINARY_DUMP_FLOAT32);
+    d_writer.add_field("threshold", BINARY_DUMP_FLOAT32);
+    d_writer.add_field("grid", BINARY_DUMP_FLOAT32, d_rows * d_columns);
+    if (!d_writer.open(filename))
+        {
+            LOG(WARNING) << "Cannot open the acquisition dump file " << filename;
+            return false;
+        }
+    LOG(INFO) << "Acquisition grids of " << d_rows << " x " << d_columns << " cells dumped to " << filename;
+    return true;
+}
+
+
+void Acquisition_Grid_Dump::end(const std::string & filename, const Acquisition_Grid_Search & search)
+{
+    if (d_failed || d_bins == 0 || d_delays == 0)
+        {
+            return;
+        }
+    if (!d_writer.is_open() && !open(filename))
+        {
+            // Not retried at every search
+            d_failed = true;
+            return;
+        }
+
+    // Rows around the peak; a search with fewer bins leaves the last ones at zero
+    const unsigned int rows = std::min(d_rows, d_bins);
+    const unsigned int peak_bin = std::min(search.peak_doppler_bin, d_bins - 1);
+    const unsigned int first_row = std::min(peak_bin - std::min(peak_bin, rows / 2), d_bins - rows);
+
+    // Columns around the peak, wrapping around the code period
+    const unsigned int decimated = (d_delays + d_decimation - 1) / d_decimation;
+    const unsigned int peak_column = std::min(search.peak_delay, d_delays - 1) / d_decimation;
+    const unsigned int first_column = (d_columns == decimated) ? 0 : (peak_column + decimated - d_columns / 2) % decimated;
+
+    std::fill(d_stored.begin(), d_stored.end(), 0.0f);
+    for (unsigned int r = 0; r < rows; r++)
+        {
+            const float * in = row(first_row + r);
+            float * out = &d_stored[static_cast<size_t>(r) * d_columns];
+            for (unsigned int c = 0; c < d_columns; c++)
+                {
+                    const unsigned int first = ((first_column + c) % decimated) * d_decimation;
+                    const unsigned int last = std::min(first + d_decimation, d_delays);
+                    out[c] = *std::max_element(in + first, in + last);
+                }
+        }
+
+    d_writer.write(d_searches++);
+    d_writer.write(search.samplestamp);
+    d_writer.write(search.prn);
+    d_writer.write(search.well_count);
+    d_writer.write(rows);
+    d_writer.write(search.first_doppler_hz + first_row * search.doppler_step_hz);
+    d_writer.write(search.doppler_step_hz);
+    d_writer.write(first_column * d_decimation);
+    d_writer.write(d_decimation);
+    d_writer.write(d_delays);
+    d_writer.write(search.first_doppler_hz + peak_bin * search.doppler_step_hz);
+    d_writer.write(search.peak_delay);
+    d_writer.write(search.test_statistic);
+    d_writer.write(search.threshold);
+    d_writer.write_array(d_stored.data(), d_stored.size());
+}
@@ -0,0 +1,128 @@
+/*!
+ * \file acquisition_grid_dump.h
+ * \brief Dump of the search grids of an acquisition block to one binary file
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_ACQUISITION_GRID_DUMP_H_
+#define GNSS_SDR_ACQUISITION_GRID_DUMP_H_
+
+#include <string>
+#include <vector>
+#include "binary_dump_writer.h"
+
+/*!
+ * \brief Description of a search, stored with its grid
+ */
+struct Acquisition_Grid_Search
+{
+    unsigned long long samplestamp;
+    unsigned int prn;
+    unsigned int well_count;
+    double first_doppler_hz;     //!< Doppler of the first row of the grid given to begin()
+    double doppler_step_hz;
+    unsigned int peak_doppler_bin;
+    unsigned int peak_delay;     //!< [samples]
+    float test_statistic;
+    float threshold;
+};
+
+/*!
+ * \brief Writes the Doppler x delay grid of each search as one record of a
+ * binary dump file (see binary_dump_format.h).
+ *
+ * The block copies each row of its search grid with row() and hands the
+ * search over with end(); the decimation, the region of interest and the
+ * disk writes happen there and on the I/O thread shared by the dump
+ * files, never one file per Doppler bin. Each group of delay_decimation
+ * consecutive delays is reduced to its maximum, so that the peak survives.
+ * With roi_delays or roi_doppler_bins set, only the cells within that
+ * distance of the peak are kept; the delays wrap around the code period.
+ *
+ * The size of the grid field is fixed by the first search. A later search
+ * with fewer Doppler bins leaves the last rows at zero (see the doppler_bins
+ * field); one with more is cut around its peak.
+ */
+class Acquisition_Grid_Dump
+{
+public:
+    Acquisition_Grid_Dump(unsigned int delay_decimation, unsigned int roi_delays, unsigned int roi_doppler_bins);
+
+    //! Starts a search of num_doppler_bins rows of num_delays cells
+    void begin(unsigned int num_doppler_bins, unsigned int num_delays);
+
+    //! Row of the given Doppler bin, to be filled by the block
+    float * row(unsigned int doppler_bin)
+    {
+        return &d_grid[static_cast<size_t>(doppler_bin) * d_delays];
+    }
+
+    /*!
+     * \brief Queues the grid of the search for writing. The file is created
+     * at the first search; filename is not used after that.
+     */
+    void end(const std::string & filename, const Acquisition_Grid_Search & search);
+
+    bool is_open() const
+    {
+        return d_writer.is_open();
+    }
+
+    //! Searches written so far
+    unsigned long long records() const
+    {
+        return d_writer.records();
+    }
+
+    //! Writes the queued searches and closes the file
+    void close()
+    {
+        d_writer.close();
+    }
+
+private:
+    bool open(const std::string & filename);
+
+    Binary_Dump_Writer d_writer;
+    bool d_failed;
+    unsigned int d_decimation;
+    unsigned int d_roi_delays;
+    unsigned int d_roi_bins;
+
+    // current search
+    std::vector<float> d_grid;
+    unsigned int d_bins;
+    unsigned int d_delays;
+
+    // stored grid, fixed by the first search
+    unsigned int d_rows;
+    unsigned int d_columns;
+    std::vector<float> d_stored;
+    unsigned int d_searches;
+};
+
+#endif /* GNSS_SDR_ACQUISITION_GRID_DUMP_H_ */
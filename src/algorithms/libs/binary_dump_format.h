@@ -0,0 +1,107 @@
+/*!
+ * \file binary_dump_format.h
+ * \brief Layout of the self-describing binary dump files.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * A dump file starts with a header that names the block that wrote it and
+ * describes the fields of its records, followed by fixed-size records:
+ *
+ *   offset  size  content
+ *        0     8  magic "GNSSDUMP"
+ *        8     4  format version (BINARY_DUMP_VERSION)
+ *       12     4  byte order mark 0x01020304, as written by the host
+ *       16     4  header size [bytes], multiple of 8
+ *       20     4  record size [bytes]
+ *       24     4  number of fields
+ *       28     4  reserved, 0
+ *       32    32  block type, zero padded
+ *       64  40 n  fields: name (32 bytes, zero padded), type, offset in the record
+ *
+ * All the integers are unsigned 32 bit in host byte order. The records
+ * start at the header size and have no padding between fields.
+ *
+ * A field may be an array of values of its type. The low 8 bits of the
+ * type word hold the type and the upper 24 bits the number of values minus
+ * one; the values follow one another in the record. Files with array
+ * fields are format version 2, so that readers of version 1 reject them;
+ * files without array fields are still version 1.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_BINARY_DUMP_FORMAT_H_
+#define GNSS_SDR_BINARY_DUMP_FORMAT_H_
+
+#define BINARY_DUMP_MAGIC "GNSSDUMP"
+#define BINARY_DUMP_VERSION 1
+#define BINARY_DUMP_VERSION_ARRAYS 2
+#define BINARY_DUMP_BYTE_ORDER_MARK 0x01020304
+#define BINARY_DUMP_HEADER_FIXED_SIZE 64
+#define BINARY_DUMP_FIELD_DESCRIPTOR_SIZE 40
+#define BINARY_DUMP_NAME_LENGTH 32
+#define BINARY_DUMP_TYPE_MASK 0xFF
+#define BINARY_DUMP_COUNT_SHIFT 8
+#define BINARY_DUMP_MAX_COUNT (1u << 24)
+
+//! Type of a field, as stored in the header
+enum Binary_Dump_Field_Type
+{
+    BINARY_DUMP_INT8 = 0,
+    BINARY_DUMP_UINT8 = 1,
+    BINARY_DUMP_INT16 = 2,
+    BINARY_DUMP_UINT16 = 3,
+    BINARY_DUMP_INT32 = 4,
+    BINARY_DUMP_UINT32 = 5,
+    BINARY_DUMP_INT64 = 6,
+    BINARY_DUMP_UINT64 = 7,
+    BINARY_DUMP_FLOAT32 = 8,
+    BINARY_DUMP_FLOAT64 = 9
+};
+
+//! Size of a field of the given type [bytes], 0 if the type is not valid
+inline unsigned int binary_dump_field_size(unsigned int type)
+{
+    switch (type)
+    {
+    case BINARY_DUMP_INT8:
+    case BINARY_DUMP_UINT8:
+        return 1;
+    case BINARY_DUMP_INT16:
+    case BINARY_DUMP_UINT16:
+        return 2;
+    case BINARY_DUMP_INT32:
+    case BINARY_DUMP_UINT32:
+    case BINARY_DUMP_FLOAT32:
+        return 4;
+    case BINARY_DUMP_INT64:
+    case BINARY_DUMP_UINT64:
+    case BINARY_DUMP_FLOAT64:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+#endif
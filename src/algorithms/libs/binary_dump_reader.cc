@@ -0,0 +1,273 @@
+/*!
+ * \file binary_dump_reader.cc
+ * \brief Memory-mapped reader of the self-describing binary dump files.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "binary_dump_reader.h"
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+
+namespace
+{
+template<typename T>
+double load(const char * src)
+{
+    T value;
+    std::memcpy(&value, src, sizeof(T));
+    return static_cast<double>(value);
+}
+
+
+uint32_t load_uint32(const char * src)
+{
+    uint32_t value;
+    std::memcpy(&value, src, sizeof(uint32_t));
+    return value;
+}
+
+
+std::string load_name(const char * src)
+{
+    return std::string(src, strnlen(src, BINARY_DUMP_NAME_LENGTH));
+}
+}
+
+
+Binary_Dump_Reader::Binary_Dump_Reader()
+{
+    d_fd = -1;
+    d_data = nullptr;
+    d_size = 0;
+    d_version = 0;
+    d_header_size = 0;
+    d_record_size = 0;
+    d_num_records = 0;
+}
+
+
+Binary_Dump_Reader::~Binary_Dump_Reader()
+{
+    close();
+}
+
+
+bool Binary_Dump_Reader::open(const std::string & filename)
+{
+    close();
+    d_fd = ::open(filename.c_str(), O_RDONLY);
+    if (d_fd < 0)
+        {
+            LOG(WARNING) << "Cannot open dump file " << filename;
+            return false;
+        }
+    struct stat st;
+    if (fstat(d_fd, &st) != 0 || st.st_size < BINARY_DUMP_HEADER_FIXED_SIZE)
+        {
+            LOG(WARNING) << filename << " is not a binary dump file";
+            close();
+            return false;
+        }
+    d_size = st.st_size;
+    void * map = mmap(nullptr, d_size, PROT_READ, MAP_SHARED, d_fd, 0);
+    if (map == MAP_FAILED)
+        {
+            LOG(WARNING) << "Cannot map dump file " << filename;
+            d_size = 0;
+            close();
+            return false;
+        }
+    d_data = static_cast<const char *>(map);
+    if (!parse_header())
+        {
+            LOG(WARNING) << filename << " is not a valid binary dump file";
+            close();
+            return false;
+        }
+    return true;
+}
+
+
+void Binary_Dump_Reader::close()
+{
+    if (d_data != nullptr)
+        {
+            munmap(const_cast<char *>(d_data), d_size);
+            d_data = nullptr;
+        }
+    if (d_fd >= 0)
+        {
+            ::close(d_fd);
+            d_fd = -1;
+        }
+    d_size = 0;
+    d_block_type.clear();
+    d_fields.clear();
+    d_version = 0;
+    d_header_size = 0;
+    d_record_size = 0;
+    d_num_records = 0;
+}
+
+
+bool Binary_Dump_Reader::parse_header()
+{
+    if (std::memcmp(d_data, BINARY_DUMP_MAGIC, 8) != 0)
+        {
+            return false;
+        }
+    d_version = load_uint32(d_data + 8);
+    if (d_version != BINARY_DUMP_VERSION && d_version != BINARY_DUMP_VERSION_ARRAYS)
+        {
+            LOG(WARNING) << "Binary dump format version " << d_version << " is not supported";
+            return false;
+        }
+    if (load_uint32(d_data + 12) != BINARY_DUMP_BYTE_ORDER_MARK)
+        {
+            LOG(WARNING) << "The binary dump file was written with a different byte order";
+            return false;
+        }
+    d_header_size = load_uint32(d_data + 16);
+    d_record_size = load_uint32(d_data + 20);
+    const unsigned int n_fields = load_uint32(d_data + 24);
+    if (d_header_size > d_size || d_record_size == 0 ||
+            BINARY_DUMP_HEADER_FIXED_SIZE + static_cast<unsigned long long>(n_fields) * BINARY_DUMP_FIELD_DESCRIPTOR_SIZE > d_header_size)
+        {
+            return false;
+        }
+    d_block_type = load_name(d_data + 32);
+    for (unsigned int i = 0; i < n_fields; i++)
+        {
+            const char * descriptor = d_data + BINARY_DUMP_HEADER_FIXED_SIZE + i * BINARY_DUMP_FIELD_DESCRIPTOR_SIZE;
+            Field field;
+            field.name = load_name(descriptor);
+            const unsigned int type_word = load_uint32(descriptor + BINARY_DUMP_NAME_LENGTH);
+            const unsigned int type = type_word & BINARY_DUMP_TYPE_MASK;
+            field.count = (type_word >> BINARY_DUMP_COUNT_SHIFT) + 1;
+            field.offset = load_uint32(descriptor + BINARY_DUMP_NAME_LENGTH + 4);
+            const unsigned int size = binary_dump_field_size(type);
+            if (size == 0 || (field.count > 1 && d_version == BINARY_DUMP_VERSION)
+                    || field.offset + static_cast<unsigned long long>(size) * field.count > d_record_size)
+                {
+                    return false;
+                }
+            field.type = static_cast<Binary_Dump_Field_Type>(type);
+            d_fields.push_back(field);
+        }
+    d_num_records = (d_size - d_header_size) / d_record_size;
+    return true;
+}
+
+
+std::string Binary_Dump_Reader::field_name(unsigned int field) const
+{
+    return d_fields.at(field).name;
+}
+
+
+Binary_Dump_Field_Type Binary_Dump_Reader::field_type(unsigned int field) const
+{
+    return d_fields.at(field).type;
+}
+
+
+int Binary_Dump_Reader::field_index(const std::string & name) const
+{
+    for (unsigned int i = 0; i < d_fields.size(); i++)
+        {
+            if (d_fields[i].name == name)
+                {
+                    return i;
+                }
+        }
+    return -1;
+}
+
+
+const char * Binary_Dump_Reader::record(unsigned long long record) const
+{
+    if (record >= d_num_records)
+        {
+            return nullptr;
+        }
+    return d_data + d_header_size + record * d_record_size;
+}
+
+
+unsigned int Binary_Dump_Reader::field_count(unsigned int field) const
+{
+    return d_fields.at(field).count;
+}
+
+
+double Binary_Dump_Reader::value(unsigned long long record, unsigned int field, unsigned int element) const
+{
+    const char * rec = Binary_Dump_Reader::record(record);
+    if (rec == nullptr || field >= d_fields.size() || element >= d_fields[field].count)
+        {
+            return 0.0;
+        }
+    const char * src = rec + d_fields[field].offset + element * binary_dump_field_size(d_fields[field].type);
+    switch (d_fields[field].type)
+    {
+    case BINARY_DUMP_INT8:    return load<int8_t>(src);
+    case BINARY_DUMP_UINT8:   return load<uint8_t>(src);
+    case BINARY_DUMP_INT16:   return load<int16_t>(src);
+    case BINARY_DUMP_UINT16:  return load<uint16_t>(src);
+    case BINARY_DUMP_INT32:   return load<int32_t>(src);
+    case BINARY_DUMP_UINT32:  return load<uint32_t>(src);
+    case BINARY_DUMP_INT64:   return load<int64_t>(src);
+    case BINARY_DUMP_UINT64:  return load<uint64_t>(src);
+    case BINARY_DUMP_FLOAT32: return load<float>(src);
+    case BINARY_DUMP_FLOAT64: return load<double>(src);
+    }
+    return 0.0;
+}
+
+
+std::vector<double> Binary_Dump_Reader::column(unsigned int field, unsigned int element) const
+{
+    std::vector<double> values;
+    if (field >= d_fields.size() || element >= d_fields[field].count)
+        {
+            return values;
+        }
+    values.reserve(d_num_records);
+    for (unsigned long long i = 0; i < d_num_records; i++)
+        {
+            values.push_back(value(i, field, element));
+        }
+    return values;
+}
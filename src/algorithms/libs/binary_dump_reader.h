@@ -0,0 +1,125 @@
+/*!
+ * \file binary_dump_reader.h
+ * \brief Memory-mapped reader of the self-describing binary dump files.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The whole file is mapped in memory, so opening it does not read the
+ * records and any of them can be accessed directly. A last record cut by
+ * the end of the file (e.g., the receiver was killed while dumping) is not
+ * counted.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_BINARY_DUMP_READER_H_
+#define GNSS_SDR_BINARY_DUMP_READER_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "binary_dump_format.h"
+
+class Binary_Dump_Reader
+{
+public:
+    Binary_Dump_Reader();
+    ~Binary_Dump_Reader();
+
+    //! Maps the file and checks its header. Returns false if it is not a valid dump file.
+    bool open(const std::string & filename);
+    void close();
+
+    bool is_open() const
+    {
+        return d_data != nullptr;
+    }
+
+    std::string block_type() const
+    {
+        return d_block_type;
+    }
+
+    unsigned int version() const
+    {
+        return d_version;
+    }
+
+    unsigned int num_fields() const
+    {
+        return d_fields.size();
+    }
+
+    std::string field_name(unsigned int field) const;
+    Binary_Dump_Field_Type field_type(unsigned int field) const;
+
+    //! Returns the index of the field with the given name, -1 if there is none
+    int field_index(const std::string & name) const;
+
+    unsigned int record_size() const
+    {
+        return d_record_size;
+    }
+
+    unsigned long long num_records() const
+    {
+        return d_num_records;
+    }
+
+    //! Raw content of a record, record_size() bytes
+    const char * record(unsigned long long record) const;
+
+    //! Number of values of a field, more than one for arrays
+    unsigned int field_count(unsigned int field) const;
+
+    //! Value of a field of a record (element of an array field), converted to double
+    double value(unsigned long long record, unsigned int field, unsigned int element = 0) const;
+
+    //! Values of a field (element of an array field) in all the records
+    std::vector<double> column(unsigned int field, unsigned int element = 0) const;
+
+private:
+    struct Field
+    {
+        std::string name;
+        Binary_Dump_Field_Type type;
+        unsigned int offset;
+        unsigned int count;
+    };
+
+    bool parse_header();
+
+    int d_fd;
+    const char * d_data;
+    size_t d_size;
+
+    std::string d_block_type;
+    unsigned int d_version;
+    unsigned int d_header_size;
+    unsigned int d_record_size;
+    unsigned long long d_num_records;
+    std::vector<Field> d_fields;
+};
+
+#endif
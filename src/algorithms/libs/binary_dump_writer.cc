@@ -0,0 +1,406 @@
+/*!
+ * \file binary_dump_writer.cc
+ * \brief Buffered writer of the self-describing binary dump files.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "binary_dump_writer.h"
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <utility>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+DEFINE_int32(dump_buffer_records, 1024, "Minimum number of records kept in memory by each binary dump file before writing them");
+DEFINE_bool(dump_async_flush, true, "Write the binary dump files from a background thread shared by all of them");
+
+#define BINARY_DUMP_BLOCK_ALIGNMENT 4096
+#define BINARY_DUMP_MIN_BLOCK_SIZE 65536
+#define BINARY_DUMP_ASYNC_BLOCKS 3
+
+
+/*!
+ * \brief Writes the blocks queued by all the asynchronous dump writers.
+ *
+ * There is one instance while at least one asynchronous writer is open.
+ */
+class Binary_Dump_Io_Thread
+{
+public:
+    static std::shared_ptr<Binary_Dump_Io_Thread> instance();
+    ~Binary_Dump_Io_Thread();
+    void queue(Binary_Dump_Writer * writer, Binary_Dump_Writer::Block * block);
+
+private:
+    Binary_Dump_Io_Thread();
+    void run();
+
+    std::deque<std::pair<Binary_Dump_Writer *, Binary_Dump_Writer::Block *> > d_queue;
+    boost::mutex d_mutex;
+    boost::condition_variable d_cond;
+    bool d_stop;
+    boost::thread d_thread;
+};
+
+
+std::shared_ptr<Binary_Dump_Io_Thread> Binary_Dump_Io_Thread::instance()
+{
+    static boost::mutex instance_mutex;
+    static std::weak_ptr<Binary_Dump_Io_Thread> current;
+    boost::lock_guard<boost::mutex> lock(instance_mutex);
+    std::shared_ptr<Binary_Dump_Io_Thread> io_thread = current.lock();
+    if (!io_thread)
+        {
+            io_thread = std::shared_ptr<Binary_Dump_Io_Thread>(new Binary_Dump_Io_Thread());
+            current = io_thread;
+        }
+    return io_thread;
+}
+
+
+Binary_Dump_Io_Thread::Binary_Dump_Io_Thread()
+{
+    d_stop = false;
+    d_thread = boost::thread(&Binary_Dump_Io_Thread::run, this);
+}
+
+
+Binary_Dump_Io_Thread::~Binary_Dump_Io_Thread()
+{
+    {
+        boost::lock_guard<boost::mutex> lock(d_mutex);
+        d_stop = true;
+    }
+    d_cond.notify_all();
+    d_thread.join();
+}
+
+
+void Binary_Dump_Io_Thread::queue(Binary_Dump_Writer * writer, Binary_Dump_Writer::Block * block)
+{
+    {
+        boost::lock_guard<boost::mutex> lock(d_mutex);
+        d_queue.push_back(std::make_pair(writer, block));
+    }
+    d_cond.notify_one();
+}
+
+
+void Binary_Dump_Io_Thread::run()
+{
+    boost::unique_lock<boost::mutex> lock(d_mutex);
+    while (true)
+        {
+            while (d_queue.empty() && !d_stop)
+                {
+                    d_cond.wait(lock);
+                }
+            if (d_queue.empty())
+                {
+                    return;
+                }
+            std::pair<Binary_Dump_Writer *, Binary_Dump_Writer::Block *> job = d_queue.front();
+            d_queue.pop_front();
+            lock.unlock();
+            job.first->write_block(job.second);
+            job.first->release_block(job.second);
+            lock.lock();
+        }
+}
+
+
+Binary_Dump_Writer::Binary_Dump_Writer(const std::string & block_type)
+    : Binary_Dump_Writer(block_type, FLAGS_dump_buffer_records > 0 ? FLAGS_dump_buffer_records : 1, FLAGS_dump_async_flush)
+{}
+
+
+Binary_Dump_Writer::Binary_Dump_Writer(const std::string & block_type, unsigned int buffer_records, bool async_flush)
+{
+    d_block_type = block_type.substr(0, BINARY_DUMP_NAME_LENGTH - 1);
+    d_record_size = 0;
+    d_next_field = 0;
+    d_next_element = 0;
+    d_records = 0;
+    d_open = false;
+    d_buffer_records = std::max(buffer_records, 1u);
+    d_block_size = 0;
+    d_block = nullptr;
+    d_async_flush = async_flush;
+    d_stalls = 0;
+}
+
+
+Binary_Dump_Writer::~Binary_Dump_Writer()
+{
+    close();
+}
+
+
+void Binary_Dump_Writer::add_field(const std::string & name, Binary_Dump_Field_Type type, unsigned int count)
+{
+    if (d_open)
+        {
+            LOG(WARNING) << "Field " << name << " added to the open dump file of " << d_block_type << ", ignored";
+            return;
+        }
+    if (count == 0 || count > BINARY_DUMP_MAX_COUNT)
+        {
+            LOG(WARNING) << "Field " << name << " of the dump file of " << d_block_type << " has " << count << " values, ignored";
+            return;
+        }
+    Field field;
+    field.name = name.substr(0, BINARY_DUMP_NAME_LENGTH - 1);
+    field.type = type;
+    field.offset = d_record_size;
+    field.size = binary_dump_field_size(type);
+    field.count = count;
+    d_fields.push_back(field);
+    d_record_size += field.size * count;
+}
+
+
+void Binary_Dump_Writer::write_array(const float * values, unsigned int n)
+{
+    while (d_open && n > 0)
+        {
+            const Field & field = d_fields[d_next_field];
+            if (field.type != BINARY_DUMP_FLOAT32 || d_next_element != 0 || n < field.count)
+                {
+                    write(*values++);
+                    n--;
+                    continue;
+                }
+            std::memcpy(d_block->data + d_block->used + field.offset, values, field.count * sizeof(float));
+            values += field.count;
+            n -= field.count;
+            if (++d_next_field == d_fields.size())
+                {
+                    end_record();
+                }
+        }
+}
+
+
+bool Binary_Dump_Writer::open(const std::string & filename)
+{
+    if (d_open)
+        {
+            return true;
+        }
+    if (d_fields.empty())
+        {
+            LOG(WARNING) << "The dump file of " << d_block_type << " has no fields";
+            return false;
+        }
+    const unsigned int descriptors_size = BINARY_DUMP_FIELD_DESCRIPTOR_SIZE * d_fields.size();
+    const unsigned int header_size = (BINARY_DUMP_HEADER_FIXED_SIZE + descriptors_size + 7) / 8 * 8;
+    char fixed_part[BINARY_DUMP_HEADER_FIXED_SIZE] = {};
+    uint32_t version = BINARY_DUMP_VERSION;
+    for (unsigned int i = 0; i < d_fields.size(); i++)
+        {
+            if (d_fields[i].count > 1)
+                {
+                    version = BINARY_DUMP_VERSION_ARRAYS;
+                }
+        }
+    const uint32_t fixed[6] = { version, BINARY_DUMP_BYTE_ORDER_MARK, header_size,
+            d_record_size, static_cast<uint32_t>(d_fields.size()), 0 };
+    std::memcpy(fixed_part, BINARY_DUMP_MAGIC, 8);
+    std::memcpy(fixed_part + 8, fixed, sizeof(fixed));
+    std::memcpy(fixed_part + 32, d_block_type.c_str(), d_block_type.size());
+    std::vector<char> header(fixed_part, fixed_part + BINARY_DUMP_HEADER_FIXED_SIZE);
+    header.resize(header_size, 0);
+    for (unsigned int i = 0; i < d_fields.size(); i++)
+        {
+            char * descriptor = &header[BINARY_DUMP_HEADER_FIXED_SIZE + i * BINARY_DUMP_FIELD_DESCRIPTOR_SIZE];
+            const uint32_t type_and_offset[2] = { static_cast<uint32_t>(d_fields[i].type) | ((d_fields[i].count - 1) << BINARY_DUMP_COUNT_SHIFT),
+                    d_fields[i].offset };
+            std::memcpy(descriptor, d_fields[i].name.c_str(), d_fields[i].name.size());
+            std::memcpy(descriptor + BINARY_DUMP_NAME_LENGTH, type_and_offset, sizeof(type_and_offset));
+        }
+
+    try
+    {
+            d_file.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+            d_file.open(filename.c_str(), std::ios::out | std::ios::binary);
+            d_file.write(&header[0], header_size);
+    }
+    catch (const std::ofstream::failure & e)
+    {
+            LOG(WARNING) << "Exception opening dump file " << filename << ": " << e.what();
+            if (d_file.is_open())
+                {
+                    d_file.close();
+                }
+            return false;
+    }
+
+    // whole records in page-aligned blocks of at least BINARY_DUMP_MIN_BLOCK_SIZE bytes
+    const unsigned int block_records = std::max(d_buffer_records, (BINARY_DUMP_MIN_BLOCK_SIZE + d_record_size - 1) / d_record_size);
+    d_block_size = block_records * d_record_size;
+    const size_t allocated_size = (d_block_size + BINARY_DUMP_BLOCK_ALIGNMENT - 1) / BINARY_DUMP_BLOCK_ALIGNMENT * BINARY_DUMP_BLOCK_ALIGNMENT;
+    d_blocks.resize(d_async_flush ? BINARY_DUMP_ASYNC_BLOCKS : 1);
+    for (unsigned int i = 0; i < d_blocks.size(); i++)
+        {
+            void * data = nullptr;
+            if (posix_memalign(&data, BINARY_DUMP_BLOCK_ALIGNMENT, allocated_size) != 0)
+                {
+                    LOG(WARNING) << "Cannot allocate the buffers of the dump file " << filename;
+                    d_blocks.resize(i);
+                    free_blocks();
+                    d_file.close();
+                    return false;
+                }
+            d_blocks[i].data = static_cast<char *>(data);
+            d_blocks[i].used = 0;
+        }
+    d_block = &d_blocks[0];
+    d_free_blocks.clear();
+    for (unsigned int i = 1; i < d_blocks.size(); i++)
+        {
+            d_free_blocks.push_back(&d_blocks[i]);
+        }
+    if (d_async_flush)
+        {
+            d_io_thread = Binary_Dump_Io_Thread::instance();
+        }
+    d_next_field = 0;
+    d_next_element = 0;
+    d_records = 0;
+    d_stalls = 0;
+    d_open = true;
+    return true;
+}
+
+
+void Binary_Dump_Writer::close()
+{
+    if (!d_open)
+        {
+            return;
+        }
+    flush();
+    if (d_async_flush)
+        {
+            boost::unique_lock<boost::mutex> lock(d_mutex);
+            while (d_free_blocks.size() + 1 < d_blocks.size())
+                {
+                    d_cond.wait(lock);
+                }
+            lock.unlock();
+            d_io_thread.reset();
+        }
+    if (d_next_field != 0 || d_next_element != 0)
+        {
+            LOG(WARNING) << "Incomplete record discarded from the dump file of " << d_block_type;
+        }
+    d_file.close();
+    free_blocks();
+    d_open = false;
+}
+
+
+void Binary_Dump_Writer::flush()
+{
+    if (!d_open || d_block->used == 0)
+        {
+            return;
+        }
+    if (d_async_flush)
+        {
+            Block * full = d_block;
+            {
+                boost::unique_lock<boost::mutex> lock(d_mutex);
+                if (d_free_blocks.empty())
+                    {
+                        d_stalls++;
+                        VLOG(1) << "The dump file of " << d_block_type << " waits for the disk";
+                        while (d_free_blocks.empty())
+                            {
+                                d_cond.wait(lock);
+                            }
+                    }
+                d_block = d_free_blocks.back();
+                d_free_blocks.pop_back();
+            }
+            d_io_thread->queue(this, full);
+        }
+    else
+        {
+            write_block(d_block);
+        }
+}
+
+
+void Binary_Dump_Writer::end_record()
+{
+    d_next_field = 0;
+    d_next_element = 0;
+    d_records++;
+    d_block->used += d_record_size;
+    if (d_block->used + d_record_size > d_block_size)
+        {
+            flush();
+        }
+}
+
+
+void Binary_Dump_Writer::write_block(Block * block)
+{
+    try
+    {
+            d_file.write(block->data, block->used);
+    }
+    catch (const std::ofstream::failure & e)
+    {
+            LOG(WARNING) << "Exception writing the dump file of " << d_block_type << ": " << e.what();
+    }
+    block->used = 0;
+}
+
+
+void Binary_Dump_Writer::release_block(Block * block)
+{
+    boost::lock_guard<boost::mutex> lock(d_mutex);
+    d_free_blocks.push_back(block);
+    d_cond.notify_all();
+}
+
+
+void Binary_Dump_Writer::free_blocks()
+{
+    for (unsigned int i = 0; i < d_blocks.size(); i++)
+        {
+            free(d_blocks[i].data);
+        }
+    d_blocks.clear();
+    d_free_blocks.clear();
+    d_block = nullptr;
+}
@@ -0,0 +1,208 @@
+/*!
+ * \file binary_dump_writer.h
+ * \brief Buffered writer of the self-describing binary dump files.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The blocks used to dump their internal variables with one ofstream::write
+ * per field, in headerless files that only the Matlab scripts knew how to
+ * read. This writer describes the record layout in a header (see
+ * binary_dump_format.h) and packs whole records in large page-aligned
+ * blocks. The full blocks are written either by the block itself or by an
+ * I/O thread shared by all the writers of the receiver, so that a dump
+ * enabled in every tracking channel does not add a thread per channel.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_BINARY_DUMP_WRITER_H_
+#define GNSS_SDR_BINARY_DUMP_WRITER_H_
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/thread.hpp>
+#include "binary_dump_format.h"
+
+class Binary_Dump_Io_Thread;
+
+/*!
+ * \brief Writes fixed-size records, field by field.
+ *
+ * The fields are declared with add_field() before open(). Each call to
+ * write() stores the next field of the current record, converted to the
+ * declared type; the record is complete after its last field. The records
+ * are kept in blocks of at least buffer_records records, rounded up to a
+ * whole number of memory pages. With async_flush, each full block is
+ * queued to the shared I/O thread and the writer goes on with a free one;
+ * it only waits if all its blocks are still queued.
+ */
+class Binary_Dump_Writer
+{
+public:
+    //! Buffer size and flush mode given by the --dump_buffer_records and --dump_async_flush flags
+    Binary_Dump_Writer(const std::string & block_type);
+    Binary_Dump_Writer(const std::string & block_type, unsigned int buffer_records, bool async_flush);
+    ~Binary_Dump_Writer();
+
+    /*!
+     * \brief Declares the next field of the records, an array if count > 1.
+     * Ignored once the file is open.
+     */
+    void add_field(const std::string & name, Binary_Dump_Field_Type type, unsigned int count = 1);
+
+    //! Creates the file and writes the header. Returns false on failure.
+    bool open(const std::string & filename);
+
+    bool is_open() const
+    {
+        return d_open;
+    }
+
+    //! Writes the complete records still in the buffer and closes the file
+    void close();
+
+    //! Writes (or queues, with async_flush) the complete records in the buffer
+    void flush();
+
+    //! Stores the next field of the current record, or the next value of an array field
+    template<typename T>
+    void write(T value)
+    {
+        if (!d_open)
+            {
+                return;
+            }
+        const Field & field = d_fields[d_next_field];
+        char * dest = d_block->data + d_block->used + field.offset + d_next_element * field.size;
+        switch (field.type)
+        {
+        case BINARY_DUMP_INT8:    store(dest, static_cast<int8_t>(value)); break;
+        case BINARY_DUMP_UINT8:   store(dest, static_cast<uint8_t>(value)); break;
+        case BINARY_DUMP_INT16:   store(dest, static_cast<int16_t>(value)); break;
+        case BINARY_DUMP_UINT16:  store(dest, static_cast<uint16_t>(value)); break;
+        case BINARY_DUMP_INT32:   store(dest, static_cast<int32_t>(value)); break;
+        case BINARY_DUMP_UINT32:  store(dest, static_cast<uint32_t>(value)); break;
+        case BINARY_DUMP_INT64:   store(dest, static_cast<int64_t>(value)); break;
+        case BINARY_DUMP_UINT64:  store(dest, static_cast<uint64_t>(value)); break;
+        case BINARY_DUMP_FLOAT32: store(dest, static_cast<float>(value)); break;
+        case BINARY_DUMP_FLOAT64: store(dest, static_cast<double>(value)); break;
+        }
+        if (++d_next_element < field.count)
+            {
+                return;
+            }
+        d_next_element = 0;
+        if (++d_next_field == d_fields.size())
+            {
+                end_record();
+            }
+    }
+
+    //! Stores n values, which may span several fields
+    template<typename T>
+    void write_array(const T * values, unsigned int n)
+    {
+        for (unsigned int i = 0; i < n; i++)
+            {
+                write(values[i]);
+            }
+    }
+
+    //! Same as above; a whole FLOAT32 array field is copied at once
+    void write_array(const float * values, unsigned int n);
+
+    unsigned int record_size() const
+    {
+        return d_record_size;
+    }
+
+    //! Complete records written so far, including those still in the buffer
+    unsigned long long records() const
+    {
+        return d_records;
+    }
+
+    //! Times a full block had to wait for the I/O thread to free another one
+    unsigned long long stalls() const
+    {
+        return d_stalls;
+    }
+
+private:
+    friend class Binary_Dump_Io_Thread;
+
+    struct Field
+    {
+        std::string name;
+        Binary_Dump_Field_Type type;
+        unsigned int offset;
+        unsigned int size;   // of one value [bytes]
+        unsigned int count;  // values
+    };
+
+    // Page-aligned block of whole records
+    struct Block
+    {
+        char * data;
+        unsigned int used;  // [bytes]
+    };
+
+    template<typename T>
+    static void store(char * dest, T value)
+    {
+        std::memcpy(dest, &value, sizeof(T));
+    }
+
+    void end_record();
+    void write_block(Block * block);  // also called from the I/O thread
+    void release_block(Block * block);
+    void free_blocks();
+
+    std::string d_block_type;
+    std::vector<Field> d_fields;
+    unsigned int d_record_size;
+    unsigned int d_next_field;
+    unsigned int d_next_element;  // of an array field
+    unsigned long long d_records;
+    bool d_open;
+
+    std::ofstream d_file;
+    unsigned int d_buffer_records;
+    unsigned int d_block_size;  // [bytes], whole records
+    std::vector<Block> d_blocks;
+    Block * d_block;  // block being filled
+
+    bool d_async_flush;
+    std::shared_ptr<Binary_Dump_Io_Thread> d_io_thread;
+    boost::mutex d_mutex;
+    boost::condition_variable d_cond;
+    std::vector<Block *> d_free_blocks;  // neither being filled nor queued
+    unsigned long long d_stalls;
+};
+
+#endif
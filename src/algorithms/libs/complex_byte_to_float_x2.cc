@@ -30,6 +30,7 @@
 
 
 #include "complex_byte_to_float_x2.h"
+#include "gnss_sdr_trace.h"
 #include <gnuradio/io_signature.h>
 #include <volk/volk.h>
 
@@ -54,6 +55,7 @@ int complex_byte_to_float_x2::work(int noutput_items,
         gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE("complex_byte_to_float_x2::work");
     const lv_8sc_t *in = (const lv_8sc_t *) input_items[0];
     float *out0 = (float*) output_items[0];
     float *out1 = (float*) output_items[1];
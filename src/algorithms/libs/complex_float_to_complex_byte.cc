@@ -33,6 +33,7 @@
 #include <gnuradio/io_signature.h>
 #include <volk/volk.h>
 #include "volk_gnsssdr/volk_gnsssdr.h"
+#include "gnss_sdr_trace.h"
 
 
 
@@ -56,6 +57,7 @@ int complex_float_to_complex_byte::work(int noutput_items,
         gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE("complex_float_to_complex_byte::work");
     const gr_complex *in = (const gr_complex *) input_items[0];
     lv_8sc_t *out = (lv_8sc_t*) output_items[0];
     volk_gnsssdr_32fc_convert_8ic(out, in, noutput_items);
@@ -0,0 +1,116 @@
+/*!
+ * \file doppler_grid_store.cc
+ * \brief Shared, reference-counted store of the carrier Doppler wipe-off
+ *  signals used by the PCPS acquisition blocks.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "doppler_grid_store.h"
+#include "gnss_sdr_memory_accounting.h"
+#include <glog/logging.h>
+#include <volk/volk.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+#include "GPS_L1_CA.h" //GPS_TWO_PI
+
+using google::LogMessage;
+
+
+Doppler_Grid::Doppler_Grid(long fs_in, long freq, unsigned int length,
+        unsigned int doppler_max, unsigned int doppler_step,
+        unsigned int num_bins) :
+        d_length(length), d_doppler_max(doppler_max), d_doppler_step(doppler_step)
+{
+    d_wipeoffs.resize(num_bins);
+    for (unsigned int doppler_index = 0; doppler_index < num_bins; doppler_index++)
+        {
+            d_wipeoffs[doppler_index] = static_cast<std::complex<float>*>(gnss_sdr_volk_malloc(length * sizeof(std::complex<float>), volk_get_alignment()));
+            float phase_step_rad = static_cast<float>(GPS_TWO_PI) * (freq + doppler(doppler_index)) / static_cast<float>(fs_in);
+            float _phase[1];
+            _phase[0] = 0;
+            volk_gnsssdr_s32f_sincos_32fc(d_wipeoffs[doppler_index], - phase_step_rad, _phase, length);
+        }
+}
+
+
+Doppler_Grid::~Doppler_Grid()
+{
+    for (unsigned int i = 0; i < d_wipeoffs.size(); i++)
+        {
+            gnss_sdr_volk_free(d_wipeoffs[i]);
+        }
+}
+
+
+Doppler_Grid_Store& Doppler_Grid_Store::instance()
+{
+    static Doppler_Grid_Store store;
+    return store;
+}
+
+
+std::shared_ptr<const Doppler_Grid> Doppler_Grid_Store::get(long fs_in, long freq,
+        unsigned int length, unsigned int doppler_max,
+        unsigned int doppler_step, unsigned int num_bins)
+{
+    key_type key = std::make_tuple(fs_in, freq, length, doppler_max, doppler_step, num_bins);
+
+    boost::mutex::scoped_lock lock(d_mutex);
+    std::shared_ptr<const Doppler_Grid> grid = d_grids[key].lock();
+    if (!grid)
+        {
+            grid = std::make_shared<const Doppler_Grid>(fs_in, freq, length, doppler_max, doppler_step, num_bins);
+            d_grids[key] = grid;
+            DLOG(INFO) << "Doppler grid store: built " << num_bins << " bins of "
+                       << length << " samples (fs " << fs_in << ", IF " << freq << ")";
+        }
+
+    // Forget the grids that nobody is using anymore
+    for (auto it = d_grids.begin(); it != d_grids.end(); )
+        {
+            if (it->second.expired())
+                {
+                    it = d_grids.erase(it);
+                }
+            else
+                {
+                    ++it;
+                }
+        }
+    return grid;
+}
+
+
+size_t Doppler_Grid_Store::size()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    size_t alive = 0;
+    for (auto it = d_grids.begin(); it != d_grids.end(); ++it)
+        {
+            if (!it->second.expired()) alive++;
+        }
+    return alive;
+}
@@ -0,0 +1,131 @@
+/*!
+ * \file doppler_grid_store.h
+ * \brief Shared, reference-counted store of the carrier Doppler wipe-off
+ *  signals used by the PCPS acquisition blocks.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * All the channels searching with the same sampling frequency, IF, FFT length
+ * and Doppler grid use exactly the same set of local carriers. This store
+ * builds each grid once and keeps it alive only while some acquisition block
+ * holds a reference to it, so memory scales with the number of different
+ * configurations instead of with the number of channels.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_DOPPLER_GRID_STORE_H_
+#define GNSS_SDR_DOPPLER_GRID_STORE_H_
+
+#include <complex>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+
+/*!
+ * \brief Read-only set of carrier wipe-off signals. Bin i holds the
+ * conjugated carrier at freq + (-doppler_max + i * doppler_step) [Hz].
+ */
+class Doppler_Grid
+{
+public:
+    Doppler_Grid(long fs_in, long freq, unsigned int length,
+            unsigned int doppler_max, unsigned int doppler_step,
+            unsigned int num_bins);
+    ~Doppler_Grid();
+
+    //! Returns the wipe-off signal of the given Doppler bin (length() samples, volk-aligned)
+    const std::complex<float>* wipeoff(unsigned int doppler_index) const
+    {
+        return d_wipeoffs[doppler_index];
+    }
+
+    //! Returns the Doppler shift of the given bin [Hz]
+    int doppler(unsigned int doppler_index) const
+    {
+        return -static_cast<int>(d_doppler_max) + static_cast<int>(d_doppler_step * doppler_index);
+    }
+
+    unsigned int num_bins() const
+    {
+        return d_wipeoffs.size();
+    }
+
+    unsigned int length() const
+    {
+        return d_length;
+    }
+
+private:
+    Doppler_Grid(const Doppler_Grid&);
+    Doppler_Grid& operator=(const Doppler_Grid&);
+    std::vector<std::complex<float>*> d_wipeoffs;
+    unsigned int d_length;
+    unsigned int d_doppler_max;
+    unsigned int d_doppler_step;
+};
+
+
+/*!
+ * \brief Process-wide store of Doppler grids keyed by
+ * (fs, IF, length, doppler_max, doppler_step, number of bins).
+ *
+ * The store only keeps weak references: a grid is released as soon as the
+ * last acquisition block using it is destroyed or re-initialized.
+ */
+class Doppler_Grid_Store
+{
+public:
+    //! Returns the store shared by the whole process
+    static Doppler_Grid_Store& instance();
+
+    /*!
+     * \brief Returns the requested grid, building it if no block holds it yet.
+     * \param fs_in        Sampling frequency [Hz]
+     * \param freq         Intermediate frequency [Hz]
+     * \param length       Number of samples of each wipe-off signal
+     * \param doppler_max  Maximum Doppler shift of the search [Hz]
+     * \param doppler_step Frequency bin of the search [Hz]
+     * \param num_bins     Number of Doppler bins, as computed by the caller
+     */
+    std::shared_ptr<const Doppler_Grid> get(long fs_in, long freq,
+            unsigned int length, unsigned int doppler_max,
+            unsigned int doppler_step, unsigned int num_bins);
+
+    //! Number of grids currently alive
+    size_t size();
+
+private:
+    Doppler_Grid_Store() {}
+    Doppler_Grid_Store(const Doppler_Grid_Store&);
+    Doppler_Grid_Store& operator=(const Doppler_Grid_Store&);
+
+    typedef std::tuple<long, long, unsigned int, unsigned int, unsigned int, unsigned int> key_type;
+    std::map<key_type, std::weak_ptr<const Doppler_Grid>> d_grids;
+    boost::mutex d_mutex;
+};
+
+#endif /* GNSS_SDR_DOPPLER_GRID_STORE_H_ */
@@ -0,0 +1,109 @@
+/*!
+ * \file fft_code_cache.cc
+ * \brief Process-wide, read-only cache of conjugated FFTs of local code
+ *  replicas, shared by all the acquisition channels.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "fft_code_cache.h"
+#include <algorithm>
+#include <cstring>
+#include <gnuradio/fft/fft.h>
+#include <glog/logging.h>
+#include <volk/volk.h>
+#include "fft_planner.h"
+#include "gnss_sdr_memory_accounting.h"
+
+using google::LogMessage;
+
+
+Fft_Code_Cache& Fft_Code_Cache::instance()
+{
+    static Fft_Code_Cache cache;
+    return cache;
+}
+
+
+std::shared_ptr<const std::complex<float>> Fft_Code_Cache::get(const std::string& signal,
+        unsigned int prn, long fs_in, unsigned int fft_size,
+        unsigned int code_offset, const code_generator& generator)
+{
+    key_type key = std::make_tuple(signal, prn, fs_in, fft_size, code_offset);
+
+    {
+        boost::mutex::scoped_lock lock(d_mutex);
+        auto it = d_codes.find(key);
+        if (it != d_codes.end())
+            {
+                return it->second;
+            }
+    }
+
+    // Cache miss: generate the code and compute its conjugated spectrum,
+    // with a plan borrowed from the planner pool. This is done without the
+    // lock, so that the channels prepared in parallel at startup do not wait
+    // for each other; two threads may then compute the same spectrum, and
+    // the first one stored is kept.
+    std::shared_ptr<gr::fft::fft_complex> fft = Fft_Planner::instance().acquire(fft_size, true);
+
+    // [ 0 0 0 ... 0 c_0 c_1 ... c_L] (see pcps_acquisition_cc::set_local_code)
+    std::fill_n(fft->get_inbuf(), code_offset, std::complex<float>(0.0, 0.0));
+    generator(fft->get_inbuf() + code_offset);
+    fft->execute();
+
+    std::complex<float>* fft_code = static_cast<std::complex<float>*>(gnss_sdr_volk_malloc(fft_size * sizeof(std::complex<float>), volk_get_alignment()));
+    volk_32fc_conjugate_32fc(fft_code, fft->get_outbuf(), fft_size);
+
+    std::shared_ptr<const std::complex<float>> code_ptr(fft_code, [](const std::complex<float>* p) { gnss_sdr_volk_free(const_cast<std::complex<float>*>(p)); });
+    fft.reset();
+
+    boost::mutex::scoped_lock lock(d_mutex);
+    auto inserted = d_codes.insert(std::make_pair(key, code_ptr));
+    if (!inserted.second)
+        {
+            return inserted.first->second;
+        }
+
+    DLOG(INFO) << "FFT code cache: stored signal " << signal << " PRN " << prn
+               << " fs " << fs_in << " fft_size " << fft_size
+               << " (" << d_codes.size() << " entries)";
+    return code_ptr;
+}
+
+
+size_t Fft_Code_Cache::size()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_codes.size();
+}
+
+
+void Fft_Code_Cache::clear()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_codes.clear();
+}
@@ -0,0 +1,101 @@
+/*!
+ * \file fft_code_cache.h
+ * \brief Process-wide, read-only cache of conjugated FFTs of local code
+ *  replicas, shared by all the acquisition channels.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Every FFT-based acquisition channel needs the conjugate of the FFT of the
+ * sampled local replica of the satellite it is searching for. Since many
+ * channels recycle the same PRNs, this class computes each spectrum only once
+ * and hands out shared pointers to it, so that assigning a new satellite to a
+ * channel becomes a pointer swap instead of a code generation plus an FFT.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_FFT_CODE_CACHE_H_
+#define GNSS_SDR_FFT_CODE_CACHE_H_
+
+#include <complex>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <boost/thread/mutex.hpp>
+
+/*!
+ * \brief Thread-safe store of conjugated code spectra, keyed by
+ * (signal, PRN, sampling frequency, FFT size, code offset).
+ *
+ * The signal identifier is a free string chosen by the caller (e.g. "1C",
+ * "2S", "1B_cboc"), so that replicas built with different options never
+ * collide. The returned buffers are aligned with volk_malloc and must be
+ * treated as read-only.
+ */
+class Fft_Code_Cache
+{
+public:
+    //! Function that writes the sampled time-domain code into its argument
+    typedef std::function<void(std::complex<float>*)> code_generator;
+
+    //! Returns the cache shared by the whole process
+    static Fft_Code_Cache& instance();
+
+    /*!
+     * \brief Returns the conjugated FFT of the requested local code,
+     * computing and storing it on first use.
+     *
+     * \param signal              Signal identifier (see class description)
+     * \param prn                 Satellite PRN
+     * \param fs_in               Sampling frequency [Hz]
+     * \param fft_size            Length of the FFT [samples]
+     * \param code_offset         Number of leading zeros of the FFT input. It is
+     *                            not zero when the code is zero-padded, e.g. if
+     *                            bit_transition_flag is set (see pcps_acquisition_cc)
+     * \param generator           Writes fft_size - code_offset code samples into
+     *                            its argument. Only called on a miss.
+     */
+    std::shared_ptr<const std::complex<float>> get(const std::string& signal,
+            unsigned int prn, long fs_in, unsigned int fft_size,
+            unsigned int code_offset, const code_generator& generator);
+
+    //! Number of code spectra currently stored
+    size_t size();
+
+    //! Drops all the stored spectra. Channels keep their current ones alive.
+    void clear();
+
+private:
+    Fft_Code_Cache() {}
+    Fft_Code_Cache(const Fft_Code_Cache&);
+    Fft_Code_Cache& operator=(const Fft_Code_Cache&);
+
+    typedef std::tuple<std::string, unsigned int, long, unsigned int, unsigned int> key_type;
+    std::map<key_type, std::shared_ptr<const std::complex<float>>> d_codes;
+    boost::mutex d_mutex;
+};
+
+#endif /* GNSS_SDR_FFT_CODE_CACHE_H_ */
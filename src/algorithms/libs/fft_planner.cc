@@ -0,0 +1,241 @@
+/*!
+ * \file fft_planner.cc
+ * \brief Process-wide FFT planning helpers: fast FFT lengths, FFTW wisdom
+ *  persistence and a pool of reusable FFT objects.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "fft_planner.h"
+#include "gnss_sdr_memory_accounting.h"
+#include "gnss_sdr_task_pool.h"
+#include <algorithm>
+#include <thread>
+#include <boost/filesystem.hpp>
+#include <glog/logging.h>
+#if HAVE_FFTW3F
+#include <fftw3.h>
+#endif
+
+using google::LogMessage;
+
+#if HAVE_FFTW3F_THREADS_CALLBACK
+namespace
+{
+// Runs the jobs of a multi-threaded FFTW plan on the task pool. The calling
+// thread takes the first job, and waits for the others.
+void fftw_parallel_loop(void* (*work)(char*), char* jobdata, size_t elsize, int njobs, void* data __attribute__((unused)))
+{
+    static const unsigned int fft_task_id = Gnss_Sdr_Task_Pool::task_id("fft");
+    Gnss_Sdr_Task_Group group(fft_task_id);
+    for (int j = 1; j < njobs; j++)
+        {
+            char* job = jobdata + elsize * j;
+            group.run([work, job]() { work(job); });
+        }
+    work(jobdata);
+    group.wait();
+}
+}
+#endif
+
+
+Fft_Planner& Fft_Planner::instance()
+{
+    static Fft_Planner planner;
+    return planner;
+}
+
+
+Fft_Planner::~Fft_Planner()
+{
+    for (auto it = d_pool.begin(); it != d_pool.end(); ++it)
+        {
+            for (unsigned int i = 0; i < it->second.size(); i++)
+                {
+                    delete it->second[i];
+                }
+        }
+}
+
+
+bool Fft_Planner::is_fast_size(unsigned int n)
+{
+    if (n == 0)
+        {
+            return false;
+        }
+    const unsigned int factors[4] = { 2, 3, 5, 7 };
+    for (unsigned int i = 0; i < 4; i++)
+        {
+            while (n % factors[i] == 0)
+                {
+                    n /= factors[i];
+                }
+        }
+    return n == 1;
+}
+
+
+unsigned int Fft_Planner::fast_size(unsigned int n)
+{
+    unsigned int m = (n == 0 ? 1 : n);
+    while (!is_fast_size(m))
+        {
+            m++;
+        }
+    return m;
+}
+
+
+std::shared_ptr<gr::fft::fft_complex> Fft_Planner::acquire(unsigned int fft_size, bool forward)
+{
+    gr::fft::fft_complex* fft = nullptr;
+    {
+        boost::mutex::scoped_lock lock(d_mutex);
+        std::vector<gr::fft::fft_complex*>& idle = d_pool[std::make_pair(fft_size, forward)];
+        if (!idle.empty())
+            {
+                fft = idle.back();
+                idle.pop_back();
+            }
+    }
+    if (fft == nullptr)
+        {
+            // gr-fft serializes the FFTW planner internally
+            fft = new gr::fft::fft_complex(fft_size, forward, threads(fft_size));
+            // pooled FFTs are accounted to the block that planned them
+            Gnss_Sdr_Memory_Accounting::add_fft(fft_size);
+        }
+    return std::shared_ptr<gr::fft::fft_complex>(fft, [this, fft_size, forward](gr::fft::fft_complex* p) { release(p, fft_size, forward); });
+}
+
+
+void Fft_Planner::release(gr::fft::fft_complex* fft, unsigned int fft_size, bool forward)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_pool[std::make_pair(fft_size, forward)].push_back(fft);
+}
+
+
+size_t Fft_Planner::pooled()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    size_t count = 0;
+    for (auto it = d_pool.begin(); it != d_pool.end(); ++it)
+        {
+            count += it->second.size();
+        }
+    return count;
+}
+
+
+void Fft_Planner::set_threading(unsigned int threads, unsigned int min_size)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_threads = threads;
+    d_threads_min_size = min_size;
+    if (d_threads == 1)
+        {
+            return;
+        }
+#if HAVE_FFTW3F_THREADS_CALLBACK
+    if (!d_callback_set)
+        {
+            fftwf_init_threads();
+            fftwf_threads_set_callback(&fftw_parallel_loop, nullptr);
+            d_callback_set = true;
+        }
+#endif
+    LOG(INFO) << "FFTs of " << min_size << " points or more planned with "
+              << threads << " threads (0: one per task pool worker)";
+}
+
+
+unsigned int Fft_Planner::threads(unsigned int fft_size)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    if (d_threads == 1 || fft_size < d_threads_min_size)
+        {
+            return 1;
+        }
+    if (d_threads > 0)
+        {
+            return d_threads;
+        }
+    unsigned int workers = Gnss_Sdr_Task_Pool::threads();
+    if (workers == 0)
+        {
+            // the pool starts with one worker per core
+            workers = std::thread::hardware_concurrency();
+        }
+    return std::max(workers, 1u);
+}
+
+
+bool Fft_Planner::load_wisdom(const std::string& filename)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_wisdom_file = filename;
+    if (!boost::filesystem::exists(filename))
+        {
+            LOG(INFO) << "FFTW wisdom file " << filename << " not found. It will be created.";
+            return false;
+        }
+#if HAVE_FFTW3F
+    if (fftwf_import_wisdom_from_filename(filename.c_str()) == 0)
+        {
+            LOG(WARNING) << "Unable to import FFTW wisdom from " << filename;
+            return false;
+        }
+    LOG(INFO) << "FFTW wisdom imported from " << filename;
+    return true;
+#else
+    LOG(WARNING) << "Built without FFTW headers. Ignoring wisdom file " << filename;
+    return false;
+#endif
+}
+
+
+bool Fft_Planner::save_wisdom()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    if (d_wisdom_file.empty())
+        {
+            return false;
+        }
+#if HAVE_FFTW3F
+    if (fftwf_export_wisdom_to_filename(d_wisdom_file.c_str()) == 0)
+        {
+            LOG(WARNING) << "Unable to export FFTW wisdom to " << d_wisdom_file;
+            return false;
+        }
+    DLOG(INFO) << "FFTW wisdom exported to " << d_wisdom_file;
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,116 @@
+/*!
+ * \file fft_planner.h
+ * \brief Process-wide FFT planning helpers: fast FFT lengths, FFTW wisdom
+ *  persistence and a pool of reusable FFT objects.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Creating a gr::fft::fft_complex runs the FFTW planner, which can take a
+ * long time for lengths with large prime factors and is repeated for every
+ * block at startup. This class keeps the FFTW wisdom in a file chosen by the
+ * user (GNSS-SDR.fftw_wisdom_file) and lends already planned FFT objects to
+ * code that only needs them transiently.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_FFT_PLANNER_H_
+#define GNSS_SDR_FFT_PLANNER_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+#include <gnuradio/fft/fft.h>
+
+/*!
+ * \brief Thread-safe FFT planning layer shared by the whole receiver.
+ */
+class Fft_Planner
+{
+public:
+    //! Returns the planner shared by the whole process
+    static Fft_Planner& instance();
+
+    /*!
+     * \brief Returns the smallest length >= n whose prime factors are all
+     * 2, 3, 5 or 7, for which FFTW has efficient codelets.
+     */
+    static unsigned int fast_size(unsigned int n);
+
+    //! True if n has no prime factor greater than 7
+    static bool is_fast_size(unsigned int n);
+
+    /*!
+     * \brief Lends an FFT object of the given length and direction.
+     *
+     * The object goes back to the pool when the returned pointer is released,
+     * so the next request of the same length does not run the FFTW planner.
+     * Each object must be used by a single thread at a time.
+     */
+    std::shared_ptr<gr::fft::fft_complex> acquire(unsigned int fft_size, bool forward);
+
+    //! Number of idle FFT objects in the pool
+    size_t pooled();
+
+    /*!
+     * \brief FFTs of \p min_size points or more are planned with \p threads
+     * threads (0: one per worker of Gnss_Sdr_Task_Pool), the smaller ones
+     * with one. Applies to the FFTs planned afterwards. With FFTW 3.3.9 or
+     * later, the threads of the multi-threaded plans are the workers of the
+     * task pool, instead of threads of FFTW.
+     */
+    void set_threading(unsigned int threads, unsigned int min_size);
+
+    //! Threads of the plans of fft_size points, for blocks that plan their own FFTs
+    unsigned int threads(unsigned int fft_size);
+
+    /*!
+     * \brief Imports the FFTW wisdom stored in filename, if it exists, and
+     * remembers filename for save_wisdom(). Returns true if wisdom was loaded.
+     */
+    bool load_wisdom(const std::string& filename);
+
+    //! Exports the accumulated FFTW wisdom to the file given to load_wisdom()
+    bool save_wisdom();
+
+private:
+    Fft_Planner() : d_threads(1), d_threads_min_size(0), d_callback_set(false) {}
+    ~Fft_Planner();
+    Fft_Planner(const Fft_Planner&);
+    Fft_Planner& operator=(const Fft_Planner&);
+    void release(gr::fft::fft_complex* fft, unsigned int fft_size, bool forward);
+
+    typedef std::pair<unsigned int, bool> key_type;
+    std::map<key_type, std::vector<gr::fft::fft_complex*>> d_pool;
+    std::string d_wisdom_file;
+    unsigned int d_threads;
+    unsigned int d_threads_min_size;
+    bool d_callback_set;
+    boost::mutex d_mutex;
+};
+
+#endif /* GNSS_SDR_FFT_PLANNER_H_ */
@@ -48,6 +48,7 @@
 
 #include "fft_internal.h"
 #include "fft_base_kernels.h"
+#include "opencl_program_cache.h"
 #include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
@@ -287,10 +288,6 @@ patch_kernel_source:
 
 	getBlockConfigAndKernelString(plan);
 	
-	const char *source_str = plan->kernel_string->c_str();
-	plan->program = clCreateProgramWithSource(context, 1, (const char**) &source_str, NULL, &err);
-    ERR_MACRO(err);
-
 	err = clGetContextInfo(context, CL_CONTEXT_DEVICES, sizeof(devices), devices, &ret_size);
 	ERR_MACRO(err);
 	
@@ -301,10 +298,14 @@ patch_kernel_source:
 		err = clGetDeviceInfo(devices[i], CL_DEVICE_TYPE, sizeof(device_type), &device_type, NULL);
 		ERR_MACRO(err);
 		
-		if(device_type == CL_DEVICE_TYPE_GPU)
+		if(device_type == CL_DEVICE_TYPE_GPU && !gpu_found)
 		{	
 			gpu_found = 1;
-	        err = clBuildProgram(plan->program, 1, &devices[i], "-cl-mad-enable", NULL, NULL);
+			// The program is built for the first GPU only, from the binary of a
+			// previous run when there is one
+			plan->program = Opencl_Program_Cache::instance().build(context, devices[i], *plan->kernel_string, "-cl-mad-enable", &err);
+			if (!plan->program)
+				ERR_MACRO(err);
 	        if (err != CL_SUCCESS)
 	        {
 		        char *build_log;				
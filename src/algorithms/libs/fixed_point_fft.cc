@@ -0,0 +1,181 @@
+/*!
+ * \file fixed_point_fft.cc
+ * \brief Radix-2 FFT on 16-bit complex integers with block floating point
+ *  scaling, and the integer vector operations used around it.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "fixed_point_fft.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include "GPS_L1_CA.h" //GPS_TWO_PI
+
+// Largest component for which a + w * b cannot overflow: 32767 / (1 + sqrt(2))
+#define FIXED_POINT_FFT_STAGE_LIMIT 13572
+
+
+Fixed_Point_Fft::Fixed_Point_Fft(unsigned int fft_size, bool forward)
+{
+    d_fft_size = fft_size;
+    d_log2_size = 0;
+    while ((1u << d_log2_size) < fft_size)
+        {
+            d_log2_size++;
+        }
+
+    double sign = (forward ? -1.0 : 1.0);
+    for (unsigned int k = 0; k < fft_size / 2; k++)
+        {
+            double phase = sign * GPS_TWO_PI * static_cast<double>(k) / static_cast<double>(fft_size);
+            d_twiddles.push_back(std::complex<int16_t>(static_cast<int16_t>(std::lround(32767.0 * std::cos(phase))),
+                    static_cast<int16_t>(std::lround(32767.0 * std::sin(phase)))));
+        }
+
+    d_bit_reverse.resize(fft_size);
+    for (unsigned int i = 0; i < fft_size; i++)
+        {
+            unsigned int reversed = 0;
+            for (unsigned int b = 0; b < d_log2_size; b++)
+                {
+                    reversed |= ((i >> b) & 1u) << (d_log2_size - 1 - b);
+                }
+            d_bit_reverse[i] = reversed;
+        }
+}
+
+
+bool Fixed_Point_Fft::is_power_of_two(unsigned int n)
+{
+    return (n != 0) && ((n & (n - 1)) == 0);
+}
+
+
+unsigned int Fixed_Point_Fft::next_power_of_two(unsigned int n)
+{
+    unsigned int size = 1;
+    while (size < n)
+        {
+            size <<= 1;
+        }
+    return size;
+}
+
+
+int Fixed_Point_Fft::execute(std::complex<int16_t>* data) const
+{
+    int exponent = 0;
+
+    for (unsigned int i = 0; i < d_fft_size; i++)
+        {
+            if (i < d_bit_reverse[i])
+                {
+                    std::swap(data[i], data[d_bit_reverse[i]]);
+                }
+        }
+
+    for (unsigned int half = 1, stride = d_fft_size / 2; half < d_fft_size; half *= 2, stride /= 2)
+        {
+            // Block floating point: halve everything if a butterfly could overflow
+            if (max_abs_component(data, d_fft_size) > FIXED_POINT_FFT_STAGE_LIMIT)
+                {
+                    for (unsigned int i = 0; i < d_fft_size; i++)
+                        {
+                            data[i] = std::complex<int16_t>(data[i].real() >> 1, data[i].imag() >> 1);
+                        }
+                    exponent++;
+                }
+
+            for (unsigned int start = 0; start < d_fft_size; start += 2 * half)
+                {
+                    for (unsigned int k = 0; k < half; k++)
+                        {
+                            const std::complex<int16_t> w = d_twiddles[k * stride];
+                            std::complex<int16_t>& a = data[start + k];
+                            std::complex<int16_t>& b = data[start + k + half];
+                            int32_t t_re = (static_cast<int32_t>(w.real()) * b.real() - static_cast<int32_t>(w.imag()) * b.imag() + (1 << 14)) >> 15;
+                            int32_t t_im = (static_cast<int32_t>(w.real()) * b.imag() + static_cast<int32_t>(w.imag()) * b.real() + (1 << 14)) >> 15;
+                            int32_t a_re = a.real();
+                            int32_t a_im = a.imag();
+                            a = std::complex<int16_t>(static_cast<int16_t>(a_re + t_re), static_cast<int16_t>(a_im + t_im));
+                            b = std::complex<int16_t>(static_cast<int16_t>(a_re - t_re), static_cast<int16_t>(a_im - t_im));
+                        }
+                }
+        }
+    return exponent;
+}
+
+
+void Fixed_Point_Fft::multiply_q15(std::complex<int16_t>* result, const std::complex<int16_t>* a,
+        const std::complex<int16_t>* b, unsigned int num_points)
+{
+    for (unsigned int i = 0; i < num_points; i++)
+        {
+            int64_t re = (static_cast<int64_t>(a[i].real()) * b[i].real() - static_cast<int64_t>(a[i].imag()) * b[i].imag() + (1 << 14)) >> 15;
+            int64_t im = (static_cast<int64_t>(a[i].real()) * b[i].imag() + static_cast<int64_t>(a[i].imag()) * b[i].real() + (1 << 14)) >> 15;
+            re = std::max<int64_t>(-32768, std::min<int64_t>(32767, re));
+            im = std::max<int64_t>(-32768, std::min<int64_t>(32767, im));
+            result[i] = std::complex<int16_t>(static_cast<int16_t>(re), static_cast<int16_t>(im));
+        }
+}
+
+
+void Fixed_Point_Fft::magnitude_squared(uint32_t* magnitude, const std::complex<int16_t>* in,
+        unsigned int num_points)
+{
+    for (unsigned int i = 0; i < num_points; i++)
+        {
+            int32_t re = in[i].real();
+            int32_t im = in[i].imag();
+            magnitude[i] = static_cast<uint32_t>(re * re) + static_cast<uint32_t>(im * im);
+        }
+}
+
+
+unsigned int Fixed_Point_Fft::index_max(const uint32_t* in, unsigned int num_points)
+{
+    unsigned int index = 0;
+    for (unsigned int i = 1; i < num_points; i++)
+        {
+            if (in[i] > in[index])
+                {
+                    index = i;
+                }
+        }
+    return index;
+}
+
+
+int Fixed_Point_Fft::max_abs_component(const std::complex<int16_t>* in, unsigned int num_points)
+{
+    int max_value = 0;
+    for (unsigned int i = 0; i < num_points; i++)
+        {
+            max_value = std::max(max_value, std::max(std::abs(static_cast<int>(in[i].real())), std::abs(static_cast<int>(in[i].imag()))));
+        }
+    return max_value;
+}
@@ -0,0 +1,96 @@
+/*!
+ * \file fixed_point_fft.h
+ * \brief Radix-2 FFT on 16-bit complex integers with block floating point
+ *  scaling, and the integer vector operations used around it.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Keeping the acquisition in 16-bit integers halves the memory traffic of
+ * the hot loop with respect to gr_complex, which matters on embedded
+ * targets. Overflow is avoided by block floating point: before each stage,
+ * the whole vector is halved if its largest component could overflow in a
+ * butterfly, and the number of halvings is returned as the block exponent.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_FIXED_POINT_FFT_H_
+#define GNSS_SDR_FIXED_POINT_FFT_H_
+
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+/*!
+ * \brief In-place fixed-point FFT of a power of two length.
+ * std::complex<int16_t> is the same type as VOLK's lv_16sc_t.
+ * execute() does not modify the object, so one instance can be used
+ * by several threads at the same time.
+ */
+class Fixed_Point_Fft
+{
+public:
+    Fixed_Point_Fft(unsigned int fft_size, bool forward);
+
+    /*!
+     * \brief Transforms data in place (no 1/N factor in either direction).
+     * \return Block exponent e: the exact transform is data * 2^e
+     */
+    int execute(std::complex<int16_t>* data) const;
+
+    unsigned int size() const
+    {
+        return d_fft_size;
+    }
+
+    static bool is_power_of_two(unsigned int n);
+
+    //! Smallest power of two that is not less than n
+    static unsigned int next_power_of_two(unsigned int n);
+
+    /*!
+     * \brief result = (a * b) / 2^15, rounded and saturated, with b in Q15.
+     * Operands may alias.
+     */
+    static void multiply_q15(std::complex<int16_t>* result, const std::complex<int16_t>* a,
+            const std::complex<int16_t>* b, unsigned int num_points);
+
+    //! magnitude[i] = |in[i]|^2, exact in 32 bits
+    static void magnitude_squared(uint32_t* magnitude, const std::complex<int16_t>* in,
+            unsigned int num_points);
+
+    //! Index of the largest element (first one in case of a tie)
+    static unsigned int index_max(const uint32_t* in, unsigned int num_points);
+
+    //! Largest absolute value of the real and imaginary components
+    static int max_abs_component(const std::complex<int16_t>* in, unsigned int num_points);
+
+private:
+    unsigned int d_fft_size;
+    unsigned int d_log2_size;
+    std::vector<std::complex<int16_t>> d_twiddles;   // Q15, e^(-/+ j 2 pi k / N), k < N/2
+    std::vector<unsigned int> d_bit_reverse;
+};
+
+#endif /* GNSS_SDR_FIXED_POINT_FFT_H_ */
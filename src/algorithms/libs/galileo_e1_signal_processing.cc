@@ -33,42 +33,32 @@
 #include "galileo_e1_signal_processing.h"
 #include <string>
 #include "Galileo_E1.h"
-#include "gnss_signal_processing.h"
+#include "gnss_primary_codes.h"
 
 
 void galileo_e1_code_gen_int(int* _dest, char _Signal[3], signed int _prn)
 {
     std::string _galileo_signal = _Signal;
-    signed int prn = _prn - 1;
-    int index = 0;
-
-    /* A simple error check */
-    if ((_prn < 1) || (_prn > 50))
-        {
-            return;
-        }
+    Gnss_Primary_Code_Id code_id;
 
     if (_galileo_signal.rfind("1B") != std::string::npos && _galileo_signal.length() >= 2)
         {
-            for (size_t i = 0; i < Galileo_E1_B_PRIMARY_CODE[prn].length(); i++)
-                {
-                    hex_to_binary_converter(&_dest[index], Galileo_E1_B_PRIMARY_CODE[prn].at(i));
-                    index = index + 4;
-                }
-
+            code_id = GALILEO_E1_B_PRIMARY_CODE;
         }
     else if (_galileo_signal.rfind("1C") != std::string::npos && _galileo_signal.length() >= 2)
         {
-            for (size_t i = 0; i < Galileo_E1_C_PRIMARY_CODE[prn].length(); i++)
-                {
-                    hex_to_binary_converter(&_dest[index], Galileo_E1_C_PRIMARY_CODE[prn].at(i));
-                    index = index + 4;
-                }
+            code_id = GALILEO_E1_C_PRIMARY_CODE;
         }
     else
         {
             return;
         }
+
+    const Gnss_Primary_Code& code = gnss_primary_code(code_id, _prn);
+    for (unsigned int i = 0; i < code.length(); i++)
+        {
+            _dest[i] = code.chip(i);
+        }
 }
 
 
@@ -112,35 +102,63 @@ void galileo_e1_sinboc_61_gen(std::complex<float>* _dest, int* _prn, unsigned in
 
 
 
-void galileo_e1_gen(std::complex<float>* _dest, int* _prn, char _Signal[3])
+/*
+ * Subcarrier of a chip of value +1, with _samples_per_chip samples: sinboc(1,1)
+ * if _cboc is false, or the CBOC of E1-B (alpha * sinboc(1,1) + beta * sinboc(6,1))
+ * or E1-C (alpha * sinboc(1,1) - beta * sinboc(6,1)) for 12 samples per chip.
+ */
+static void galileo_e1_subcarrier(float* _subcarrier, unsigned int _samples_per_chip, bool _cboc, bool _e1c)
 {
-    std::string _galileo_signal = _Signal;
-    const unsigned int _codeLength = 12 * Galileo_E1_B_CODE_LENGTH_CHIPS;
     const float alpha = sqrt(10.0 / 11.0);
     const float beta = sqrt(1.0 / 11.0);
+    for (unsigned int j = 0; j < _samples_per_chip; j++)
+        {
+            const float sinboc_11 = (j < _samples_per_chip / 2) ? 1.0 : -1.0;
+            const float sinboc_61 = (j % 2 == 0) ? 1.0 : -1.0;
+            if (!_cboc)
+                {
+                    _subcarrier[j] = sinboc_11;
+                }
+            else if (_e1c)
+                {
+                    _subcarrier[j] = alpha * sinboc_11 - beta * sinboc_61;
+                }
+            else
+                {
+                    _subcarrier[j] = alpha * sinboc_11 + beta * sinboc_61;
+                }
+        }
+}
+
 
-    std::complex<float> sinboc_11[12 * 4092]; //  _codeLength not accepted by Clang
-    std::complex<float> sinboc_61[12 * 4092];
 
-    galileo_e1_sinboc_11_gen(sinboc_11, _prn, _codeLength); //generate sinboc(1,1) 12 samples per chip
-    galileo_e1_sinboc_61_gen(sinboc_61, _prn, _codeLength); //generate sinboc(6,1) 12 samples per chip
+void galileo_e1_gen(std::complex<float>* _dest, int* _prn, char _Signal[3])
+{
+    std::string _galileo_signal = _Signal;
+    const unsigned int _samplesPerChip = 12;
+    bool _e1c;
+    float _subcarrier[_samplesPerChip];
 
     if (_galileo_signal.rfind("1B") != std::string::npos && _galileo_signal.length() >= 2)
         {
-            for (unsigned int i = 0; i < _codeLength; i++)
-                {
-                    _dest[i] = alpha * sinboc_11[i] + beta * sinboc_61[i];
-                }
+            _e1c = false;
         }
     else if (_galileo_signal.rfind("1C") != std::string::npos && _galileo_signal.length() >= 2)
         {
-            for (unsigned int i = 0; i < _codeLength; i++)
-                {
-                    _dest[i] = alpha * sinboc_11[i] - beta * sinboc_61[i];
-                }
+            _e1c = true;
         }
     else
         return;
+
+    galileo_e1_subcarrier(_subcarrier, _samplesPerChip, true, _e1c);
+    for (unsigned int i = 0; i < Galileo_E1_B_CODE_LENGTH_CHIPS; i++)
+        {
+            const float chip = static_cast<float>(_prn[i]);
+            for (unsigned int j = 0; j < _samplesPerChip; j++)
+                {
+                    _dest[i * _samplesPerChip + j] = std::complex<float>(chip * _subcarrier[j], 0.0);
+                }
+        }
 }
 
 
@@ -149,14 +167,18 @@ void galileo_e1_code_gen_complex_sampled(std::complex<float>* _dest, char _Signa
         bool _cboc, unsigned int _prn, signed int _fs, unsigned int _chip_shift,
         bool _secondary_flag)
 {
-    // This function is based on the GNU software GPS for MATLAB in Kay Borre's book
+    // This function is based on the GNU software GPS for MATLAB in Kay Borre's book.
+    // Each output sample is taken directly from the code chips and the
+    // subcarrier, at the index that resampler() would pick in the replica
+    // with _samplesPerChip samples per chip, so that replica is never built.
     std::string _galileo_signal = _Signal;
     unsigned int _samplesPerCode;
     const int _codeFreqBasis = Galileo_E1_CODE_CHIP_RATE_HZ; //Hz
-    unsigned int _codeLength = Galileo_E1_B_CODE_LENGTH_CHIPS;
+    const unsigned int _codeLength = Galileo_E1_B_CODE_LENGTH_CHIPS;
     int primary_code_E1_chips[static_cast<int>(Galileo_E1_B_CODE_LENGTH_CHIPS)];
     _samplesPerCode = static_cast<unsigned int>( static_cast<double>(_fs) / (static_cast<double>(_codeFreqBasis ) / static_cast<double>(_codeLength)));
-    const int _samplesPerChip = (_cboc == true) ? 12 : 2;
+    const unsigned int _samplesPerChip = (_cboc == true) ? 12 : 2;
+    const bool _e1c = _galileo_signal.rfind("1C") != std::string::npos && _galileo_signal.length() >= 2;
 
     const unsigned int delay = ((static_cast<int>(Galileo_E1_B_CODE_LENGTH_CHIPS) - _chip_shift)
                                 % static_cast<int>(Galileo_E1_B_CODE_LENGTH_CHIPS))
@@ -164,60 +186,38 @@ void galileo_e1_code_gen_complex_sampled(std::complex<float>* _dest, char _Signa
 
     galileo_e1_code_gen_int(primary_code_E1_chips, _Signal, _prn); //generate Galileo E1 code, 1 sample per chip
 
-    std::complex<float>* _signal_E1;
+    float _subcarrier[12];
+    galileo_e1_subcarrier(_subcarrier, _samplesPerChip, _cboc, _e1c);
 
-    _codeLength = _samplesPerChip * Galileo_E1_B_CODE_LENGTH_CHIPS;
-    _signal_E1 = new std::complex<float>[_codeLength];
+    const bool _resample = (_fs != static_cast<signed int>(_samplesPerChip) * _codeFreqBasis);
+    const float _t_in = 1 / static_cast<float>(_samplesPerChip * _codeFreqBasis);
+    const float _t_out = 1 / static_cast<float>(_fs);
+    const unsigned int _lastIndex = _samplesPerChip * _codeLength - 1;
 
-    if (_cboc == true)
-        {
-            galileo_e1_gen(_signal_E1, primary_code_E1_chips, _Signal); //generate cboc 12 samples per chip
-        }
-    else
-        {
-            galileo_e1_sinboc_11_gen(_signal_E1, primary_code_E1_chips, _codeLength); //generate sinboc(1,1) 2 samples per chip
-        }
+    const unsigned int _codes = (_e1c && _secondary_flag) ? static_cast<unsigned int>(Galileo_E1_C_SECONDARY_CODE_LENGTH) : 1;
+    const unsigned int _samplesPerPeriod = _codes * _samplesPerCode;
+    unsigned int _out = delay % _samplesPerPeriod;
 
-    if (_fs != _samplesPerChip * _codeFreqBasis)
+    for (unsigned int n = 0; n < _codes; n++)
         {
-            std::complex<float>* _resampled_signal = new std::complex<float>[_samplesPerCode];
-            resampler(_signal_E1, _resampled_signal, _samplesPerChip * _codeFreqBasis, _fs,
-                    _codeLength, _samplesPerCode); //resamples code to fs
-
-            delete[] _signal_E1;
-            _signal_E1 = _resampled_signal;
-        }
-
-
-    if (_galileo_signal.rfind("1C") != std::string::npos && _galileo_signal.length() >= 2 && _secondary_flag)
-    {
-
-        std::complex<float>* _signal_E1C_secondary = new std::complex<float>
-                                                    [static_cast<int>(Galileo_E1_C_SECONDARY_CODE_LENGTH)
-                                                    * _samplesPerCode];
-
-        for (unsigned int i = 0; i < static_cast<unsigned int>(Galileo_E1_C_SECONDARY_CODE_LENGTH); i++)
-            {
-                for (unsigned k = 0; k < _samplesPerCode; k++)
-                    {
-                        _signal_E1C_secondary[i*_samplesPerCode + k] = _signal_E1[k]
-                                * (Galileo_E1_C_SECONDARY_CODE.at(i) == '0'
-                                   ? std::complex<float>(1,0) : std::complex<float>(-1,0));
-                    }
-            }
-
-        _samplesPerCode *= static_cast<int>(Galileo_E1_C_SECONDARY_CODE_LENGTH);
-
-        delete[] _signal_E1;
-        _signal_E1 = _signal_E1C_secondary;
-    }
-
-    for (unsigned int i = 0; i < _samplesPerCode; i++)
-        {
-            _dest[(i + delay) % _samplesPerCode] = _signal_E1[i];
+            const float secondary = (_codes > 1 && Galileo_E1_C_SECONDARY_CODE.at(n) != '0') ? -1.0 : 1.0;
+            for (unsigned int k = 0; k < _samplesPerCode; k++)
+                {
+                    unsigned int index = k;
+                    if (_resample)
+                        {
+                            // same rounding as resampler(), which also takes the last sample at the end
+                            const float aux = (_t_out * (k + 1)) / _t_in;
+                            index = (k == _samplesPerCode - 1) ? _lastIndex : static_cast<int>(static_cast<long>(aux + 1)) - 1;
+                        }
+                    const float chip = secondary * static_cast<float>(primary_code_E1_chips[index / _samplesPerChip]);
+                    _dest[_out] = std::complex<float>(chip * _subcarrier[index % _samplesPerChip], 0.0);
+                    if (++_out == _samplesPerPeriod)
+                        {
+                            _out = 0;
+                        }
+                }
         }
-
-    delete[] _signal_E1;
 }
 
 
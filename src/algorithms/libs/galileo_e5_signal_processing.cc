@@ -34,69 +34,35 @@
 #include "galileo_e5_signal_processing.h"
 #include <gnuradio/math.h>
 #include "Galileo_E5a.h"
+#include "gnss_primary_codes.h"
 #include "gnss_signal_processing.h"
 
 
 
 void galileo_e5_a_code_gen_complex_primary(std::complex<float>* _dest, signed int _prn, char _Signal[3])
 {
-    unsigned int prn = _prn - 1;
-    unsigned int index = 0;
-    int a[4];
-    if ((_prn < 1) || (_prn > 50))
-        {
-            return;
-        }
+    const Gnss_Primary_Code& code_I = gnss_primary_code(GALILEO_E5A_I_PRIMARY_CODE, _prn);
+    const Gnss_Primary_Code& code_Q = gnss_primary_code(GALILEO_E5A_Q_PRIMARY_CODE, _prn);
     if (_Signal[0] == '5' && _Signal[1] == 'Q')
         {
-            for (size_t i = 0; i < Galileo_E5a_Q_PRIMARY_CODE[prn].length() - 1; i++)
+            for (unsigned int i = 0; i < code_Q.length(); i++)
                 {
-                    hex_to_binary_converter(a, Galileo_E5a_Q_PRIMARY_CODE[prn].at(i));
-                    _dest[index] = std::complex<float>(0.0, float(a[0]));
-                    _dest[index + 1] = std::complex<float>(0.0, float(a[1]));
-                    _dest[index + 2] = std::complex<float>(0.0, float(a[2]));
-                    _dest[index + 3] = std::complex<float>(0.0, float(a[3]));
-                    index = index + 4;
+                    _dest[i] = std::complex<float>(0.0, float(code_Q.chip(i)));
                 }
-            // last 2 bits are filled up zeros
-            hex_to_binary_converter(a, Galileo_E5a_Q_PRIMARY_CODE[prn].at(Galileo_E5a_Q_PRIMARY_CODE[prn].length() - 1));
-            _dest[index] = std::complex<float>(float(0.0), a[0]);
-            _dest[index + 1] = std::complex<float>(float(0.0), a[1]);
         }
     else if (_Signal[0] == '5' && _Signal[1] == 'I')
         {
-            for (size_t i = 0; i < Galileo_E5a_I_PRIMARY_CODE[prn].length() - 1; i++)
+            for (unsigned int i = 0; i < code_I.length(); i++)
                 {
-                    hex_to_binary_converter(a, Galileo_E5a_I_PRIMARY_CODE[prn].at(i));
-                    _dest[index] = std::complex<float>(float(a[0]), 0.0);
-                    _dest[index + 1] = std::complex<float>(float(a[1]), 0.0);
-                    _dest[index + 2] = std::complex<float>(float(a[2]), 0.0);
-                    _dest[index + 3] = std::complex<float>(float(a[3]), 0.0);
-                    index = index + 4;
+                    _dest[i] = std::complex<float>(float(code_I.chip(i)), 0.0);
                 }
-            // last 2 bits are filled up zeros
-            hex_to_binary_converter(a, Galileo_E5a_I_PRIMARY_CODE[prn].at(Galileo_E5a_I_PRIMARY_CODE[prn].length() - 1));
-            _dest[index] = std::complex<float>(float(a[0]), 0.0);
-            _dest[index + 1] = std::complex<float>(float(a[1]), 0.0);
         }
     else if (_Signal[0] == '5' && _Signal[1] == 'X')
         {
-            int b[4];
-            for (size_t i = 0; i < Galileo_E5a_I_PRIMARY_CODE[prn].length() - 1; i++)
+            for (unsigned int i = 0; i < code_I.length(); i++)
                 {
-                    hex_to_binary_converter(a, Galileo_E5a_I_PRIMARY_CODE[prn].at(i));
-                    hex_to_binary_converter(b, Galileo_E5a_Q_PRIMARY_CODE[prn].at(i));
-                    _dest[index] = std::complex<float>(float(a[0]),float(b[0]));
-                    _dest[index + 1] = std::complex<float>(float(a[1]),float(b[1]));
-                    _dest[index + 2] = std::complex<float>(float(a[2]),float(b[2]));
-                    _dest[index + 3] = std::complex<float>(float(a[3]),float(b[3]));
-                    index = index + 4;
+                    _dest[i] = std::complex<float>(float(code_I.chip(i)), float(code_Q.chip(i)));
                 }
-            // last 2 bits are filled up zeros
-            hex_to_binary_converter(a, Galileo_E5a_I_PRIMARY_CODE[prn].at(Galileo_E5a_I_PRIMARY_CODE[prn].length() - 1));
-            hex_to_binary_converter(b, Galileo_E5a_Q_PRIMARY_CODE[prn].at(Galileo_E5a_Q_PRIMARY_CODE[prn].length() - 1));
-            _dest[index] = std::complex<float>(float(a[0]), float(b[0]));
-            _dest[index + 1] = std::complex<float>(float(a[1]), float(b[1]));
         }
 }
 
@@ -0,0 +1,103 @@
+/*!
+ * \file gnss_code_bank.cc
+ * \brief Process-wide store of the sampled local codes.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_code_bank.h"
+#include "gnss_sdr_memory_accounting.h"
+#include <cstring>
+#include <glog/logging.h>
+#include <volk/volk.h>
+
+using google::LogMessage;
+
+
+Gnss_Code_Bank& Gnss_Code_Bank::instance()
+{
+    static Gnss_Code_Bank bank;
+    return bank;
+}
+
+
+std::shared_ptr<const std::complex<float>> Gnss_Code_Bank::get(const std::string& signal,
+        unsigned int prn, long fs_in, unsigned int chip_shift,
+        unsigned int samples, const code_generator& generator)
+{
+    key_type key = std::make_tuple(signal, prn, fs_in, chip_shift, samples);
+
+    {
+        boost::mutex::scoped_lock lock(d_mutex);
+        auto it = d_codes.find(key);
+        if (it != d_codes.end())
+            {
+                return it->second;
+            }
+    }
+
+    // Miss: generate the code without the lock, as in Fft_Code_Cache. If two
+    // threads generate the same code, the first one stored is kept.
+    std::complex<float>* code = static_cast<std::complex<float>*>(gnss_sdr_volk_malloc(samples * sizeof(std::complex<float>), volk_get_alignment()));
+    std::memset(code, 0, samples * sizeof(std::complex<float>));
+    generator(code);
+    std::shared_ptr<const std::complex<float>> code_ptr(code, [](const std::complex<float>* p) { gnss_sdr_volk_free(const_cast<std::complex<float>*>(p)); });
+
+    boost::mutex::scoped_lock lock(d_mutex);
+    auto inserted = d_codes.insert(std::make_pair(key, code_ptr));
+    if (!inserted.second)
+        {
+            return inserted.first->second;
+        }
+
+    DLOG(INFO) << "Code bank: stored signal " << signal << " PRN " << prn
+               << " fs " << fs_in << " samples " << samples
+               << " (" << d_codes.size() << " entries)";
+    return code_ptr;
+}
+
+
+void Gnss_Code_Bank::copy(std::complex<float>* dest, const std::string& signal,
+        unsigned int prn, long fs_in, unsigned int chip_shift,
+        unsigned int samples, const code_generator& generator)
+{
+    std::shared_ptr<const std::complex<float>> code = get(signal, prn, fs_in, chip_shift, samples, generator);
+    std::memcpy(dest, code.get(), samples * sizeof(std::complex<float>));
+}
+
+
+size_t Gnss_Code_Bank::size()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_codes.size();
+}
+
+
+void Gnss_Code_Bank::clear()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_codes.clear();
+}
@@ -0,0 +1,97 @@
+/*!
+ * \file gnss_code_bank.h
+ * \brief Process-wide store of the sampled local codes.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_CODE_BANK_H_
+#define GNSS_SDR_GNSS_CODE_BANK_H_
+
+#include <complex>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <boost/thread/mutex.hpp>
+
+/*!
+ * \brief Thread-safe store of the outputs of the *_code_gen_complex_sampled
+ * functions, keyed by (signal, PRN, sampling frequency, chip shift, length).
+ *
+ * The signal identifier is chosen by the caller as in Fft_Code_Cache, so
+ * that replicas built with different options never collide. A channel that
+ * is assigned a PRN again, or an acquisition that restarts, gets the code
+ * from the bank instead of generating it.
+ */
+class Gnss_Code_Bank
+{
+public:
+    //! Function that writes the sampled code into its argument
+    typedef std::function<void(std::complex<float>*)> code_generator;
+
+    //! Returns the bank shared by the whole process
+    static Gnss_Code_Bank& instance();
+
+    /*!
+     * \brief Returns the requested sampled code, generating and storing it
+     * on first use. The buffer is aligned with volk_malloc and read-only.
+     *
+     * \param signal      Signal identifier
+     * \param prn         Satellite PRN
+     * \param fs_in       Sampling frequency [Hz]
+     * \param chip_shift  Code phase passed to the generator [chips]
+     * \param samples     Length of the code [samples]
+     * \param generator   Writes \p samples samples into its argument. Only
+     *                    called on a miss.
+     */
+    std::shared_ptr<const std::complex<float>> get(const std::string& signal,
+            unsigned int prn, long fs_in, unsigned int chip_shift,
+            unsigned int samples, const code_generator& generator);
+
+    //! Same as get(), copying the code into \p dest
+    void copy(std::complex<float>* dest, const std::string& signal,
+            unsigned int prn, long fs_in, unsigned int chip_shift,
+            unsigned int samples, const code_generator& generator);
+
+    //! Number of codes currently stored
+    size_t size();
+
+    //! Drops all the stored codes. The ones handed out stay alive.
+    void clear();
+
+private:
+    Gnss_Code_Bank() {}
+    Gnss_Code_Bank(const Gnss_Code_Bank&);
+    Gnss_Code_Bank& operator=(const Gnss_Code_Bank&);
+
+    typedef std::tuple<std::string, unsigned int, long, unsigned int, unsigned int> key_type;
+    std::map<key_type, std::shared_ptr<const std::complex<float>>> d_codes;
+    boost::mutex d_mutex;
+};
+
+#endif /* GNSS_SDR_GNSS_CODE_BANK_H_ */
@@ -0,0 +1,193 @@
+/*!
+ * \file gnss_primary_codes.cc
+ * \brief Bit-packed tables of the primary spreading codes, shared by all
+ * the code generators.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_primary_codes.h"
+#include <string>
+#include "GPS_L2C.h"
+#include "Galileo_E1.h"
+#include "Galileo_E5a.h"
+
+
+namespace
+{
+
+std::vector<Gnss_Primary_Code> gps_l1_ca_primary_codes()
+{
+    const unsigned int code_length = 1023;
+    bool G1[code_length];
+    bool G2[code_length];
+    bool G1_register[10], G2_register[10];
+
+    /* G2 Delays as defined in GPS-ISD-200D */
+    const unsigned int delays[51] = {5 /*PRN1*/, 6, 7, 8, 17, 18, 139, 140, 141, 251, 252, 254 ,255, 256, 257, 258, 469, 470, 471, 472,
+            473, 474, 509, 512, 513, 514, 515, 516, 859, 860, 861, 862 /*PRN32*/,
+            145 /*PRN120*/, 175, 52, 21, 237, 235, 886, 657, 634, 762,
+            355, 1012, 176, 603, 130, 359, 595, 68, 386 /*PRN138*/};
+
+    for (unsigned int lcv = 0; lcv < 10; lcv++)
+        {
+            G1_register[lcv] = 1;
+            G2_register[lcv] = 1;
+        }
+
+    /* Generate G1 & G2 Register, common to all the PRNs */
+    for (unsigned int lcv = 0; lcv < code_length; lcv++)
+        {
+            G1[lcv] = G1_register[0];
+            G2[lcv] = G2_register[0];
+
+            bool feedback1 = G1_register[7] ^ G1_register[0];
+            bool feedback2 = (G2_register[8] + G2_register[7] + G2_register[4] + G2_register[2] + G2_register[1] + G2_register[0]) & 0x1;
+
+            for (unsigned int lcv2 = 0; lcv2 < 9; lcv2++)
+                {
+                    G1_register[lcv2] = G1_register[lcv2 + 1];
+                    G2_register[lcv2] = G2_register[lcv2 + 1];
+                }
+
+            G1_register[9] = feedback1;
+            G2_register[9] = feedback2;
+        }
+
+    /* The chips are +1 where G1 and the delayed G2 differ */
+    std::vector<Gnss_Primary_Code> codes(51, Gnss_Primary_Code(code_length));
+    for (unsigned int prn_idx = 0; prn_idx < 51; prn_idx++)
+        {
+            unsigned int delay = code_length - delays[prn_idx];
+            for (unsigned int lcv = 0; lcv < code_length; lcv++)
+                {
+                    if (G1[lcv] == G2[(lcv + delay) % code_length])
+                        {
+                            codes[prn_idx].set_negative(lcv);
+                        }
+                }
+        }
+    return codes;
+}
+
+
+std::vector<Gnss_Primary_Code> gps_l2c_m_primary_codes()
+{
+    std::vector<Gnss_Primary_Code> codes(50, Gnss_Primary_Code(GPS_L2_M_CODE_LENGTH_CHIPS));
+    for (unsigned int prn_idx = 0; prn_idx < 50; prn_idx++)
+        {
+            int32_t x = GPS_L2C_M_INIT_REG[prn_idx];
+            for (int n = 0; n < GPS_L2_M_CODE_LENGTH_CHIPS; n++)
+                {
+                    if (x & 1)
+                        {
+                            codes[prn_idx].set_negative(n);
+                        }
+                    x = static_cast<int32_t>((x >> 1) ^ ((x & 1) * 0445112474));
+                }
+        }
+    return codes;
+}
+
+
+/*
+ * Memory codes in hexadecimal, most significant bit first. A 1 bit is -1
+ * (see hex_to_binary_converter). The bits after the code length are
+ * padding.
+ */
+std::vector<Gnss_Primary_Code> hex_primary_codes(const std::string* hex_codes, unsigned int n_codes, unsigned int code_length)
+{
+    std::vector<Gnss_Primary_Code> codes(n_codes, Gnss_Primary_Code(code_length));
+    for (unsigned int prn_idx = 0; prn_idx < n_codes; prn_idx++)
+        {
+            for (unsigned int chip = 0; chip < code_length; chip++)
+                {
+                    char digit = hex_codes[prn_idx].at(chip / 4);
+                    unsigned int nibble;
+                    if (digit >= '0' && digit <= '9') nibble = digit - '0';
+                    else if (digit >= 'A' && digit <= 'F') nibble = digit - 'A' + 10;
+                    else nibble = digit - 'a' + 10;
+                    if ((nibble >> (3 - chip % 4)) & 1)
+                        {
+                            codes[prn_idx].set_negative(chip);
+                        }
+                }
+        }
+    return codes;
+}
+
+}
+
+
+const Gnss_Primary_Code& gnss_primary_code(Gnss_Primary_Code_Id code, unsigned int prn)
+{
+    // Each table is built by the first caller. Function-local statics are
+    // initialized only once even if several channels ask at the same time.
+    static const Gnss_Primary_Code no_code;
+    unsigned int prn_idx = prn - 1;
+    switch (code)
+    {
+    case GPS_L1_CA_PRIMARY_CODE:
+        {
+            static const std::vector<Gnss_Primary_Code> codes = gps_l1_ca_primary_codes();
+            if (120 <= prn && prn <= 138)
+                {
+                    prn_idx = prn - 88;    // SBAS PRNs are at indices 32 to 50
+                }
+            return prn_idx < codes.size() ? codes[prn_idx] : no_code;
+        }
+    case GPS_L2C_M_PRIMARY_CODE:
+        {
+            static const std::vector<Gnss_Primary_Code> codes = gps_l2c_m_primary_codes();
+            return prn_idx < codes.size() ? codes[prn_idx] : no_code;
+        }
+    case GALILEO_E1_B_PRIMARY_CODE:
+        {
+            static const std::vector<Gnss_Primary_Code> codes = hex_primary_codes(Galileo_E1_B_PRIMARY_CODE,
+                    Galileo_E1_NUMBER_OF_CODES, static_cast<unsigned int>(Galileo_E1_B_CODE_LENGTH_CHIPS));
+            return prn_idx < codes.size() ? codes[prn_idx] : no_code;
+        }
+    case GALILEO_E1_C_PRIMARY_CODE:
+        {
+            static const std::vector<Gnss_Primary_Code> codes = hex_primary_codes(Galileo_E1_C_PRIMARY_CODE,
+                    Galileo_E1_NUMBER_OF_CODES, static_cast<unsigned int>(Galileo_E1_B_CODE_LENGTH_CHIPS));
+            return prn_idx < codes.size() ? codes[prn_idx] : no_code;
+        }
+    case GALILEO_E5A_I_PRIMARY_CODE:
+        {
+            static const std::vector<Gnss_Primary_Code> codes = hex_primary_codes(Galileo_E5a_I_PRIMARY_CODE,
+                    Galileo_E5a_NUMBER_OF_CODES, Galileo_E5a_CODE_LENGTH_CHIPS);
+            return prn_idx < codes.size() ? codes[prn_idx] : no_code;
+        }
+    case GALILEO_E5A_Q_PRIMARY_CODE:
+        {
+            static const std::vector<Gnss_Primary_Code> codes = hex_primary_codes(Galileo_E5a_Q_PRIMARY_CODE,
+                    Galileo_E5a_NUMBER_OF_CODES, Galileo_E5a_CODE_LENGTH_CHIPS);
+            return prn_idx < codes.size() ? codes[prn_idx] : no_code;
+        }
+    }
+    return no_code;
+}
@@ -0,0 +1,89 @@
+/*!
+ * \file gnss_primary_codes.h
+ * \brief Bit-packed tables of the primary spreading codes, shared by all
+ * the code generators.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The table of each code is built once per process, on the first request
+ * of any of its PRNs, from the LFSR definitions (GPS) or the hexadecimal
+ * memory codes (Galileo) of the system parameters. After that, generating a
+ * code for a new channel only unpacks its bits.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_PRIMARY_CODES_H_
+#define GNSS_SDR_GNSS_PRIMARY_CODES_H_
+
+#include <cstdint>
+#include <vector>
+
+/*!
+ * \brief Chips of a primary code, one bit per chip. A set bit is the
+ * logical level that the generators map to -1.
+ */
+class Gnss_Primary_Code
+{
+public:
+    Gnss_Primary_Code() : d_length(0) {}
+    explicit Gnss_Primary_Code(unsigned int length) : d_words((length + 31) / 32, 0), d_length(length) {}
+
+    //! Length of the code [chips], 0 for an unknown PRN
+    unsigned int length() const { return d_length; }
+
+    //! Value of chip \p chip, +1 or -1
+    int chip(unsigned int chip) const
+    {
+        return ((d_words[chip >> 5] >> (chip & 31)) & 1) ? -1 : 1;
+    }
+
+    void set_negative(unsigned int chip)
+    {
+        d_words[chip >> 5] |= static_cast<uint32_t>(1) << (chip & 31);
+    }
+
+private:
+    std::vector<uint32_t> d_words;
+    unsigned int d_length;
+};
+
+
+enum Gnss_Primary_Code_Id
+{
+    GPS_L1_CA_PRIMARY_CODE,     //!< PRN 1 to 32 and SBAS PRN 120 to 138
+    GPS_L2C_M_PRIMARY_CODE,     //!< PRN 1 to 50
+    GALILEO_E1_B_PRIMARY_CODE,  //!< PRN 1 to 50
+    GALILEO_E1_C_PRIMARY_CODE,  //!< PRN 1 to 50
+    GALILEO_E5A_I_PRIMARY_CODE, //!< PRN 1 to 50
+    GALILEO_E5A_Q_PRIMARY_CODE  //!< PRN 1 to 50
+};
+
+/*!
+ * \brief Primary code \p code of satellite \p prn. It is empty if the PRN
+ * is not defined for that code. Thread-safe.
+ */
+const Gnss_Primary_Code& gnss_primary_code(Gnss_Primary_Code_Id code, unsigned int prn);
+
+#endif /* GNSS_SDR_GNSS_PRIMARY_CODES_H_ */
@@ -0,0 +1,665 @@
+/*!
+ * \file gnss_sample_capture.cc
+ * \brief Capture of the samples delivered by a signal source, with the
+ *  annotations needed to replay the session sample by sample.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sample_capture.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <glog/logging.h>
+#include "binary_dump_reader.h"
+#include "binary_dump_writer.h"
+
+using google::LogMessage;
+
+namespace
+{
+// records of the annotations kept in memory before they are written
+const unsigned int annotation_buffer_records = 256;
+
+inline unsigned int quantize(float x, float inv_step, int half_levels)
+{
+    const int k = static_cast<int>(std::floor(x * inv_step)) + half_levels;
+    return static_cast<unsigned int>(std::min(std::max(k, 0), 2 * half_levels - 1));
+}
+
+inline float dequantize(unsigned int k, float step, int half_levels)
+{
+    return (static_cast<float>(static_cast<int>(k) - half_levels) + 0.5f) * step;
+}
+}
+
+
+double gnss_sample_capture_step(unsigned int bits, double sigma)
+{
+    // thresholds of the 2-bit quantizer at one standard deviation, and the
+    // step of minimum distortion of a Gaussian signal with 16 levels
+    return bits == 2 ? sigma : 0.335 * sigma;
+}
+
+
+Gnss_Sample_Capture_Writer::Gnss_Sample_Capture_Writer(size_t buffer_size, unsigned int buffers)
+{
+    d_buffer_size = std::max((buffer_size + GNSS_SAMPLE_CAPTURE_ALIGNMENT - 1) / GNSS_SAMPLE_CAPTURE_ALIGNMENT, static_cast<size_t>(1))
+            * GNSS_SAMPLE_CAPTURE_ALIGNMENT;
+    d_buffers.resize(std::max(buffers, 2u));
+    for (unsigned int i = 0; i < d_buffers.size(); i++)
+        {
+            d_buffers.at(i).data = 0;
+            d_buffers.at(i).used = 0;
+        }
+    d_open = false;
+    d_item_size = 0;
+    d_bits = 0;
+    d_sample_rate = 0.0;
+    d_buffer = 0;
+    d_half_byte = false;
+    d_step = 0.0;
+    d_sum_squares = 0.0;
+    d_sum_count = 0;
+    d_samples = 0;
+    d_written_samples = 0;
+    d_dropped_samples = 0;
+    d_gap_start = 0;
+    d_gap_samples = 0;
+    d_have_time = false;
+    d_tag_sample = 0;
+    d_tag_seconds = 0;
+    d_tag_fraction = 0.0;
+    d_overflows = 0;
+    d_lost_samples = 0;
+    d_stop = false;
+}
+
+
+Gnss_Sample_Capture_Writer::~Gnss_Sample_Capture_Writer()
+{
+    close();
+}
+
+
+bool Gnss_Sample_Capture_Writer::open(const std::string & filename, size_t item_size, unsigned int bits, double sample_rate)
+{
+    close();
+    if (bits != 0 && (item_size != sizeof(std::complex<float>) || (bits != 2 && bits != 4)))
+        {
+            LOG(WARNING) << "Only gr_complex samples can be requantized, to 2 or 4 bits. Capturing the raw items in " << filename;
+            bits = 0;
+        }
+    d_item_size = item_size;
+    d_bits = bits;
+    d_sample_rate = sample_rate;
+
+    d_file.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!d_file.is_open())
+        {
+            LOG(WARNING) << "Cannot create the capture file " << filename;
+            return false;
+        }
+    d_annotations = std::make_shared<Binary_Dump_Writer>("sample_capture", annotation_buffer_records, true);
+    d_annotations->add_field("event", BINARY_DUMP_UINT8);
+    d_annotations->add_field("sample", BINARY_DUMP_UINT64);
+    d_annotations->add_field("count", BINARY_DUMP_UINT64);
+    d_annotations->add_field("seconds", BINARY_DUMP_UINT64);
+    d_annotations->add_field("value", BINARY_DUMP_FLOAT64);
+    if (!d_annotations->open(filename + ".annotations"))
+        {
+            LOG(WARNING) << "Cannot create the annotations of the capture file " << filename;
+            d_annotations.reset();
+            d_file.close();
+            return false;
+        }
+
+    d_free_buffers.clear();
+    for (unsigned int i = 0; i < d_buffers.size(); i++)
+        {
+            void * data = 0;
+            if (posix_memalign(&data, GNSS_SAMPLE_CAPTURE_ALIGNMENT, d_buffer_size) != 0)
+                {
+                    LOG(WARNING) << "Cannot allocate the buffers of the capture file " << filename;
+                    for (unsigned int j = 0; j < i; j++)
+                        {
+                            std::free(d_buffers.at(j).data);
+                            d_buffers.at(j).data = 0;
+                        }
+                    d_annotations->close();
+                    d_annotations.reset();
+                    d_file.close();
+                    return false;
+                }
+            d_buffers.at(i).data = static_cast<char *>(data);
+            d_buffers.at(i).used = 0;
+            d_free_buffers.push_back(&d_buffers.at(i));
+        }
+    d_queue.clear();
+    d_buffer = 0;
+    d_half_byte = false;
+    d_step = 0.0;
+    d_sum_squares = 0.0;
+    d_sum_count = 0;
+    d_samples = 0;
+    d_written_samples = 0;
+    d_dropped_samples = 0;
+    d_gap_samples = 0;
+    d_have_time = false;
+    d_overflows = 0;
+    d_lost_samples = 0;
+
+    annotate(CAPTURE_FORMAT, 0, d_item_size, d_bits, d_sample_rate);
+    d_stop = false;
+    d_thread = boost::thread(&Gnss_Sample_Capture_Writer::run, this);
+    d_open = true;
+    return true;
+}
+
+
+void Gnss_Sample_Capture_Writer::close()
+{
+    if (!d_open)
+        {
+            return;
+        }
+    if (d_buffer != 0 && d_buffer->used > 0)
+        {
+            queue_buffer();
+        }
+    else if (d_buffer != 0)
+        {
+            boost::lock_guard<boost::mutex> lock(d_mutex);
+            d_free_buffers.push_back(d_buffer);
+            d_buffer = 0;
+        }
+    end_gap();
+    annotate(CAPTURE_END, d_samples, d_written_samples, 0, 0.0);
+
+    {
+        boost::lock_guard<boost::mutex> lock(d_mutex);
+        d_stop = true;
+    }
+    d_cond.notify_all();
+    d_thread.join();
+
+    if (!d_file.good())
+        {
+            LOG(WARNING) << "Error writing the capture file";
+        }
+    d_file.close();
+    d_annotations->close();
+    d_annotations.reset();
+    for (unsigned int i = 0; i < d_buffers.size(); i++)
+        {
+            std::free(d_buffers.at(i).data);
+            d_buffers.at(i).data = 0;
+        }
+    d_free_buffers.clear();
+    d_open = false;
+    LOG(INFO) << "Capture closed: " << d_samples << " samples, " << d_dropped_samples << " dropped, "
+              << d_overflows << " overflows of the source (" << d_lost_samples << " samples lost)";
+    if (d_dropped_samples > 0)
+        {
+            LOG(WARNING) << d_dropped_samples << " samples were not captured because the disk did not keep up";
+        }
+}
+
+
+void Gnss_Sample_Capture_Writer::annotate(Gnss_Sample_Capture_Event event, unsigned long long sample,
+        unsigned long long count, unsigned long long seconds, double value)
+{
+    d_annotations->write(static_cast<unsigned int>(event));
+    d_annotations->write(sample);
+    d_annotations->write(count);
+    d_annotations->write(seconds);
+    d_annotations->write(value);
+}
+
+
+bool Gnss_Sample_Capture_Writer::next_buffer()
+{
+    boost::lock_guard<boost::mutex> lock(d_mutex);
+    if (d_free_buffers.empty())
+        {
+            return false;
+        }
+    d_buffer = d_free_buffers.back();
+    d_free_buffers.pop_back();
+    d_buffer->used = 0;
+    d_half_byte = false;
+    return true;
+}
+
+
+void Gnss_Sample_Capture_Writer::queue_buffer()
+{
+    {
+        boost::lock_guard<boost::mutex> lock(d_mutex);
+        d_queue.push_back(d_buffer);
+        d_buffer = 0;
+    }
+    d_cond.notify_one();
+    update_step();
+}
+
+
+void Gnss_Sample_Capture_Writer::end_gap()
+{
+    if (d_gap_samples > 0)
+        {
+            annotate(CAPTURE_GAP, d_gap_start, d_gap_samples, 0, 0.0);
+            d_gap_samples = 0;
+        }
+}
+
+
+void Gnss_Sample_Capture_Writer::update_step()
+{
+    // from the power of the samples of the last buffer, so that the levels follow the gain of the front end
+    if (d_bits == 0 || d_sum_count == 0)
+        {
+            return;
+        }
+    const double step = gnss_sample_capture_step(d_bits, std::sqrt(d_sum_squares / static_cast<double>(d_sum_count)));
+    d_sum_squares = 0.0;
+    d_sum_count = 0;
+    if (step > 0.0 && std::abs(step - d_step) > 0.01 * d_step)
+        {
+            d_step = step;
+            annotate(CAPTURE_SCALE, d_samples, 0, 0, d_step);
+        }
+}
+
+
+unsigned int Gnss_Sample_Capture_Writer::store(const void * items, unsigned int n_items)
+{
+    if (d_bits == 0)
+        {
+            const size_t room = d_buffer_size / d_item_size - d_buffer->used / d_item_size;
+            const unsigned int n = static_cast<unsigned int>(std::min(room, static_cast<size_t>(n_items)));
+            std::memcpy(d_buffer->data + d_buffer->used, items, n * d_item_size);
+            d_buffer->used += n * d_item_size;
+            if (d_buffer->used + d_item_size > d_buffer_size)
+                {
+                    queue_buffer();
+                }
+            return n;
+        }
+
+    const std::complex<float> * in = static_cast<const std::complex<float> *>(items);
+    const size_t free_bytes = d_buffer_size - d_buffer->used;
+    const size_t room = d_bits == 4 ? free_bytes : 2 * free_bytes + (d_half_byte ? 1 : 0);
+    const unsigned int n = static_cast<unsigned int>(std::min(room, static_cast<size_t>(n_items)));
+    if (d_step <= 0.0)
+        {
+            // the first samples give the first step
+            double sum = 0.0;
+            for (unsigned int i = 0; i < n; i++)
+                {
+                    sum += std::norm(in[i]);
+                }
+            d_step = gnss_sample_capture_step(d_bits, n > 0 ? std::sqrt(sum / (2.0 * n)) : 0.0);
+            if (d_step <= 0.0) d_step = 1.0;
+            annotate(CAPTURE_SCALE, d_samples, 0, 0, d_step);
+        }
+    const float inv_step = static_cast<float>(1.0 / d_step);
+    const int half_levels = 1 << (d_bits - 1);
+    unsigned char * out = reinterpret_cast<unsigned char *>(d_buffer->data);
+    double sum_squares = 0.0;
+    for (unsigned int i = 0; i < n; i++)
+        {
+            const float re = in[i].real();
+            const float im = in[i].imag();
+            sum_squares += re * re + im * im;
+            const unsigned int k_i = quantize(re, inv_step, half_levels);
+            const unsigned int k_q = quantize(im, inv_step, half_levels);
+            if (d_bits == 4)
+                {
+                    out[d_buffer->used++] = static_cast<unsigned char>((k_i << 4) | k_q);
+                }
+            else if (!d_half_byte)
+                {
+                    out[d_buffer->used++] = static_cast<unsigned char>(((k_i << 2) | k_q) << 4);
+                    d_half_byte = true;
+                }
+            else
+                {
+                    out[d_buffer->used - 1] |= static_cast<unsigned char>((k_i << 2) | k_q);
+                    d_half_byte = false;
+                }
+        }
+    d_sum_squares += sum_squares;
+    d_sum_count += 2 * n;
+    if (d_buffer->used == d_buffer_size && !d_half_byte)
+        {
+            queue_buffer();
+        }
+    return n;
+}
+
+
+void Gnss_Sample_Capture_Writer::write(const void * items, unsigned int n_items)
+{
+    if (!d_open)
+        {
+            return;
+        }
+    const char * in = static_cast<const char *>(items);
+    while (n_items > 0)
+        {
+            if (d_buffer == 0 && !next_buffer())
+                {
+                    // the source must not wait for the disk
+                    if (d_gap_samples == 0) d_gap_start = d_samples;
+                    d_gap_samples += n_items;
+                    d_dropped_samples += n_items;
+                    d_samples += n_items;
+                    return;
+                }
+            end_gap();
+            const unsigned int stored = store(in, n_items);
+            in += stored * d_item_size;
+            n_items -= stored;
+            d_samples += stored;
+            d_written_samples += stored;
+        }
+}
+
+
+void Gnss_Sample_Capture_Writer::time_tag(unsigned long long sample, unsigned long long seconds, double fraction)
+{
+    if (!d_open)
+        {
+            return;
+        }
+    annotate(CAPTURE_TIME_TAG, sample, 0, seconds, fraction);
+    if (d_have_time && d_sample_rate > 0.0)
+        {
+            // as in gnss_sdr_overflow_monitor
+            const double elapsed = static_cast<double>(seconds) - static_cast<double>(d_tag_seconds)
+                    + (fraction - d_tag_fraction);
+            const double gap = elapsed * d_sample_rate - static_cast<double>(sample - d_tag_sample);
+            if (gap >= 0.5)
+                {
+                    const unsigned long long lost = static_cast<unsigned long long>(gap + 0.5);
+                    annotate(CAPTURE_OVERFLOW, sample, lost, 0, 0.0);
+                    d_overflows++;
+                    d_lost_samples += lost;
+                }
+        }
+    d_have_time = true;
+    d_tag_sample = sample;
+    d_tag_seconds = seconds;
+    d_tag_fraction = fraction;
+}
+
+
+void Gnss_Sample_Capture_Writer::run()
+{
+    boost::unique_lock<boost::mutex> lock(d_mutex);
+    while (true)
+        {
+            while (d_queue.empty() && !d_stop)
+                {
+                    d_cond.wait(lock);
+                }
+            if (d_queue.empty())
+                {
+                    return;
+                }
+            Buffer * buffer = d_queue.front();
+            d_queue.pop_front();
+            lock.unlock();
+            d_file.write(buffer->data, buffer->used);
+            lock.lock();
+            d_free_buffers.push_back(buffer);
+        }
+}
+
+
+Gnss_Sample_Capture_Reader::Gnss_Sample_Capture_Reader()
+{
+    d_item_size = 0;
+    d_bits = 0;
+    d_sample_rate = 0.0;
+    d_end_sample = 0;
+    d_sample = 0;
+    d_lost_samples = 0;
+    d_next_gap = 0;
+    d_next_scale = 0;
+    d_step = 1.0;
+    d_have_half_byte = false;
+    d_half_byte = 0;
+}
+
+
+Gnss_Sample_Capture_Reader::~Gnss_Sample_Capture_Reader()
+{}
+
+
+bool Gnss_Sample_Capture_Reader::open(const std::string & filename)
+{
+    Binary_Dump_Reader annotations;
+    if (!annotations.open(filename + ".annotations") || annotations.block_type() != "sample_capture")
+        {
+            LOG(WARNING) << "No annotations for the capture file " << filename;
+            return false;
+        }
+    const int event = annotations.field_index("event");
+    const int sample = annotations.field_index("sample");
+    const int count = annotations.field_index("count");
+    const int seconds = annotations.field_index("seconds");
+    const int value = annotations.field_index("value");
+    if (event < 0 || sample < 0 || count < 0 || seconds < 0 || value < 0 || annotations.num_records() == 0
+            || static_cast<int>(annotations.value(0, event)) != CAPTURE_FORMAT)
+        {
+            LOG(WARNING) << "Invalid annotations of the capture file " << filename;
+            return false;
+        }
+    d_item_size = static_cast<size_t>(annotations.value(0, count));
+    d_bits = static_cast<unsigned int>(annotations.value(0, seconds));
+    d_sample_rate = annotations.value(0, value);
+    if (d_item_size == 0 || (d_bits != 0 && d_bits != 2 && d_bits != 4))
+        {
+            LOG(WARNING) << "Unknown format of the capture file " << filename;
+            return false;
+        }
+
+    d_time_tags.clear();
+    d_gaps.clear();
+    d_scales.clear();
+    d_lost_samples = 0;
+    bool have_end = false;
+    unsigned long long gap_samples = 0;
+    for (unsigned long long r = 1; r < annotations.num_records(); r++)
+        {
+            const unsigned long long s = static_cast<unsigned long long>(annotations.value(r, sample));
+            const unsigned long long c = static_cast<unsigned long long>(annotations.value(r, count));
+            switch (static_cast<int>(annotations.value(r, event)))
+            {
+            case CAPTURE_TIME_TAG:
+                {
+                    Time_Tag tag;
+                    tag.sample = s;
+                    tag.seconds = static_cast<unsigned long long>(annotations.value(r, seconds));
+                    tag.fraction = annotations.value(r, value);
+                    d_time_tags.push_back(tag);
+                    break;
+                }
+            case CAPTURE_OVERFLOW:
+                d_lost_samples += c;
+                break;
+            case CAPTURE_GAP:
+                {
+                    Span gap = { s, c, 0.0 };
+                    d_gaps.push_back(gap);
+                    gap_samples += c;
+                    break;
+                }
+            case CAPTURE_SCALE:
+                {
+                    Span scale = { s, 0, annotations.value(r, value) };
+                    d_scales.push_back(scale);
+                    break;
+                }
+            case CAPTURE_END:
+                d_end_sample = s;
+                have_end = true;
+                break;
+            default:
+                break;
+            }
+        }
+
+    d_file.close();
+    d_file.clear();
+    d_file.open(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!d_file.is_open())
+        {
+            LOG(WARNING) << "Cannot open the capture file " << filename;
+            return false;
+        }
+    if (!have_end)
+        {
+            // the capture was not closed: up to the last whole sample in the file
+            d_file.seekg(0, std::ios::end);
+            const unsigned long long bytes = static_cast<unsigned long long>(d_file.tellg());
+            d_file.seekg(0, std::ios::beg);
+            const unsigned long long written = d_bits == 0 ? bytes / d_item_size : (d_bits == 4 ? bytes : 2 * bytes);
+            d_end_sample = written + gap_samples;
+            LOG(WARNING) << "The capture file " << filename << " was not closed, replaying its " << written << " samples";
+        }
+    d_sample = 0;
+    d_next_gap = 0;
+    d_next_scale = 0;
+    d_step = 1.0;
+    d_have_half_byte = false;
+    return true;
+}
+
+
+unsigned int Gnss_Sample_Capture_Reader::read_file(void * dest, unsigned int n_items)
+{
+    if (d_bits == 0)
+        {
+            d_file.read(static_cast<char *>(dest), static_cast<std::streamsize>(n_items * d_item_size));
+            return static_cast<unsigned int>(d_file.gcount() / d_item_size);
+        }
+
+    std::complex<float> * out = static_cast<std::complex<float> *>(dest);
+    const float step = static_cast<float>(d_step);
+    const int half_levels = 1 << (d_bits - 1);
+    if (d_bits == 4)
+        {
+            d_bytes.resize(n_items);
+            d_file.read(reinterpret_cast<char *>(d_bytes.data()), n_items);
+            const unsigned int n = static_cast<unsigned int>(d_file.gcount());
+            for (unsigned int i = 0; i < n; i++)
+                {
+                    out[i] = std::complex<float>(dequantize(d_bytes[i] >> 4, step, half_levels),
+                            dequantize(d_bytes[i] & 0x0F, step, half_levels));
+                }
+            return n;
+        }
+
+    unsigned int n = 0;
+    if (d_have_half_byte && n_items > 0)
+        {
+            const unsigned int code = d_half_byte & 0x0F;
+            out[n++] = std::complex<float>(dequantize(code >> 2, step, half_levels), dequantize(code & 0x03, step, half_levels));
+            d_have_half_byte = false;
+        }
+    const unsigned int remaining = n_items - n;
+    d_bytes.resize((remaining + 1) / 2);
+    d_file.read(reinterpret_cast<char *>(d_bytes.data()), d_bytes.size());
+    const unsigned int bytes = static_cast<unsigned int>(d_file.gcount());
+    for (unsigned int b = 0; b < bytes && n < n_items; b++)
+        {
+            const unsigned int first = d_bytes[b] >> 4;
+            out[n++] = std::complex<float>(dequantize(first >> 2, step, half_levels), dequantize(first & 0x03, step, half_levels));
+            if (n == n_items)
+                {
+                    // the second sample of this byte is the first one of the next read
+                    d_have_half_byte = true;
+                    d_half_byte = d_bytes[b];
+                    break;
+                }
+            const unsigned int second = d_bytes[b] & 0x0F;
+            out[n++] = std::complex<float>(dequantize(second >> 2, step, half_levels), dequantize(second & 0x03, step, half_levels));
+        }
+    return n;
+}
+
+
+unsigned int Gnss_Sample_Capture_Reader::read(void * dest, unsigned int n_items)
+{
+    char * out = static_cast<char *>(dest);
+    const size_t output_size = output_item_size();
+    unsigned int produced = 0;
+    while (produced < n_items && d_sample < d_end_sample)
+        {
+            unsigned long long limit = d_end_sample;
+            while (d_next_gap < d_gaps.size() && d_gaps[d_next_gap].sample + d_gaps[d_next_gap].count <= d_sample)
+                {
+                    d_next_gap++;
+                }
+            if (d_next_gap < d_gaps.size())
+                {
+                    const Span & gap = d_gaps[d_next_gap];
+                    if (gap.sample <= d_sample)
+                        {
+                            // the samples that were not captured are zeros
+                            const unsigned int n = static_cast<unsigned int>(std::min(static_cast<unsigned long long>(n_items - produced),
+                                    std::min(gap.sample + gap.count, d_end_sample) - d_sample));
+                            std::memset(out + produced * output_size, 0, n * output_size);
+                            produced += n;
+                            d_sample += n;
+                            continue;
+                        }
+                    limit = std::min(limit, gap.sample);
+                }
+            while (d_next_scale < d_scales.size() && d_scales[d_next_scale].sample <= d_sample)
+                {
+                    d_step = d_scales[d_next_scale++].value;
+                }
+            if (d_next_scale < d_scales.size())
+                {
+                    limit = std::min(limit, d_scales[d_next_scale].sample);
+                }
+            const unsigned int n = static_cast<unsigned int>(std::min(static_cast<unsigned long long>(n_items - produced), limit - d_sample));
+            const unsigned int r = read_file(out + produced * output_size, n);
+            produced += r;
+            d_sample += r;
+            if (r < n)
+                {
+                    LOG(WARNING) << "The capture file ends at sample " << d_sample << ", before its annotated end";
+                    d_end_sample = d_sample;
+                }
+        }
+    return produced;
+}
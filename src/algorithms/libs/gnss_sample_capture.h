@@ -0,0 +1,304 @@
+/*!
+ * \file gnss_sample_capture.h
+ * \brief Capture of the samples delivered by a signal source, with the
+ *  annotations needed to replay the session sample by sample.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * A capture is two files. The samples file holds the items as the source
+ * delivered them, or, for gr_complex sources, each I and Q component
+ * requantized to 4 bits (one byte per sample, I in the high nibble) or to
+ * 2 bits (two samples per byte, the first one in the high nibble), as
+ * offset binary codes k of a uniform quantizer: x = (k - 2^(bits-1) + 0.5) * step.
+ * The annotations file, <samples file>.annotations, is a binary dump of
+ * block type "sample_capture" with the fields event, sample, count,
+ * seconds and value, where sample counts the items delivered by the
+ * source, written or not:
+ *
+ *  - CAPTURE_FORMAT, the first record: count is the item size [bytes],
+ *    seconds the bits per component (0 for raw items) and value the
+ *    sample rate [samples/s].
+ *  - CAPTURE_TIME_TAG: an "rx_time" tag of the source at sample, seconds
+ *    and value being its full and fractional seconds.
+ *  - CAPTURE_OVERFLOW: count samples lost by the front end just before
+ *    sample, from the times of the tags.
+ *  - CAPTURE_GAP: count samples from sample on that were not written,
+ *    because the disk did not keep up and all the buffers were queued.
+ *  - CAPTURE_SCALE: the quantization step from sample on, in value.
+ *  - CAPTURE_END, the last record: sample is the number of samples
+ *    delivered by the source, count the number of samples written.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SAMPLE_CAPTURE_H_
+#define GNSS_SDR_GNSS_SAMPLE_CAPTURE_H_
+
+#include <complex>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/thread.hpp>
+
+class Binary_Dump_Writer;
+
+#define GNSS_SAMPLE_CAPTURE_ALIGNMENT 4096
+
+enum Gnss_Sample_Capture_Event
+{
+    CAPTURE_FORMAT = 0,
+    CAPTURE_TIME_TAG = 1,
+    CAPTURE_OVERFLOW = 2,
+    CAPTURE_GAP = 3,
+    CAPTURE_SCALE = 4,
+    CAPTURE_END = 5
+};
+
+//! Step of the quantizer of \p bits bits for components of standard deviation \p sigma
+double gnss_sample_capture_step(unsigned int bits, double sigma);
+
+
+/*!
+ * \brief Writes a capture. The samples are copied (or requantized) into
+ * page-aligned buffers, and a background thread writes the full ones, so
+ * that the signal source never waits for the disk: if all the buffers are
+ * still queued, the samples are dropped and annotated as a gap.
+ */
+class Gnss_Sample_Capture_Writer
+{
+public:
+    //! \p buffers buffers of \p buffer_size bytes, rounded up to whole pages
+    Gnss_Sample_Capture_Writer(size_t buffer_size, unsigned int buffers);
+    ~Gnss_Sample_Capture_Writer();
+
+    /*!
+     * \brief Creates the samples and annotations files of items of
+     * \p item_size bytes, requantized to \p bits bits per component if it
+     * is 2 or 4 (only for gr_complex items). Returns false on failure.
+     */
+    bool open(const std::string & filename, size_t item_size, unsigned int bits, double sample_rate);
+
+    //! Writes the samples still in the buffers and closes the files
+    void close();
+
+    bool is_open() const
+    {
+        return d_open;
+    }
+
+    //! Stores the next samples of the source
+    void write(const void * items, unsigned int n_items);
+
+    //! Annotates an "rx_time" tag of the source at \p sample
+    void time_tag(unsigned long long sample, unsigned long long seconds, double fraction);
+
+    //! Samples delivered by the source
+    unsigned long long samples() const
+    {
+        return d_samples;
+    }
+
+    //! Samples written, or being written
+    unsigned long long written_samples() const
+    {
+        return d_written_samples;
+    }
+
+    //! Samples that were dropped because the disk did not keep up
+    unsigned long long dropped_samples() const
+    {
+        return d_dropped_samples;
+    }
+
+    //! Overflows of the front end, and samples lost in them
+    unsigned long long overflows() const
+    {
+        return d_overflows;
+    }
+
+    unsigned long long lost_samples() const
+    {
+        return d_lost_samples;
+    }
+
+private:
+    struct Buffer
+    {
+        char * data;
+        size_t used;  // [bytes]
+    };
+
+    void annotate(Gnss_Sample_Capture_Event event, unsigned long long sample,
+            unsigned long long count, unsigned long long seconds, double value);
+    bool next_buffer();  // false if all of them are queued
+    void queue_buffer();
+    void end_gap();
+    void update_step();
+    unsigned int store(const void * items, unsigned int n_items);  // samples stored in the current buffer
+    void run();
+
+    std::shared_ptr<Binary_Dump_Writer> d_annotations;
+    std::ofstream d_file;
+    bool d_open;
+    size_t d_item_size;
+    unsigned int d_bits;
+    double d_sample_rate;
+
+    size_t d_buffer_size;  // [bytes], whole pages
+    std::vector<Buffer> d_buffers;
+    Buffer * d_buffer;     // being filled, null if none was free
+    bool d_half_byte;      // the last byte of the buffer has only its first sample (2 bits)
+
+    // quantization
+    double d_step;
+    double d_sum_squares;  // of the components quantized with d_step
+    unsigned long long d_sum_count;
+
+    unsigned long long d_samples;
+    unsigned long long d_written_samples;
+    unsigned long long d_dropped_samples;
+    unsigned long long d_gap_start;
+    unsigned long long d_gap_samples;  // of the gap in progress
+
+    bool d_have_time;
+    unsigned long long d_tag_sample;
+    unsigned long long d_tag_seconds;
+    double d_tag_fraction;
+    unsigned long long d_overflows;
+    unsigned long long d_lost_samples;
+
+    // shared with the thread
+    boost::mutex d_mutex;
+    boost::condition_variable d_cond;
+    std::deque<Buffer *> d_queue;
+    std::vector<Buffer *> d_free_buffers;
+    bool d_stop;
+    boost::thread d_thread;
+};
+
+
+/*!
+ * \brief Reads a capture back: the samples as the source delivered them,
+ * dequantized to std::complex<float> if they were requantized, with zeros
+ * in the gaps of the capture, so that every sample keeps its position.
+ */
+class Gnss_Sample_Capture_Reader
+{
+public:
+    struct Time_Tag
+    {
+        unsigned long long sample;
+        unsigned long long seconds;
+        double fraction;
+    };
+
+    Gnss_Sample_Capture_Reader();
+    ~Gnss_Sample_Capture_Reader();
+
+    //! Opens the samples and annotations files. Returns false if they are not a valid capture.
+    bool open(const std::string & filename);
+
+    //! Size of the items of the source [bytes]
+    size_t item_size() const
+    {
+        return d_item_size;
+    }
+
+    //! Size of the items of read(): the source ones, or std::complex<float> if requantized
+    size_t output_item_size() const
+    {
+        return d_bits > 0 ? sizeof(std::complex<float>) : d_item_size;
+    }
+
+    unsigned int bits() const
+    {
+        return d_bits;
+    }
+
+    double sample_rate() const
+    {
+        return d_sample_rate;
+    }
+
+    //! Samples delivered by the source in the session
+    unsigned long long samples() const
+    {
+        return d_end_sample;
+    }
+
+    //! Next sample to be read
+    unsigned long long sample() const
+    {
+        return d_sample;
+    }
+
+    //! Time tags of the source, by sample
+    const std::vector<Time_Tag> & time_tags() const
+    {
+        return d_time_tags;
+    }
+
+    //! Samples lost by the front end, as annotated
+    unsigned long long lost_samples() const
+    {
+        return d_lost_samples;
+    }
+
+    /*!
+     * \brief Copies the next samples (at most n_items) to dest. Returns the
+     * number of samples copied, 0 at the end of the session.
+     */
+    unsigned int read(void * dest, unsigned int n_items);
+
+private:
+    struct Span
+    {
+        unsigned long long sample;
+        unsigned long long count;
+        double value;
+    };
+
+    unsigned int read_file(void * dest, unsigned int n_items);  // from the samples file
+
+    std::ifstream d_file;
+    size_t d_item_size;
+    unsigned int d_bits;
+    double d_sample_rate;
+    unsigned long long d_end_sample;
+    unsigned long long d_sample;
+    std::vector<Time_Tag> d_time_tags;
+    std::vector<Span> d_gaps;
+    std::vector<Span> d_scales;
+    unsigned long long d_lost_samples;
+    unsigned int d_next_gap;
+    unsigned int d_next_scale;
+    double d_step;
+    std::vector<unsigned char> d_bytes;
+    bool d_have_half_byte;       // with 2 bits, the second sample of the last byte read is pending
+    unsigned char d_half_byte;
+};
+
+#endif /* GNSS_SDR_GNSS_SAMPLE_CAPTURE_H_ */
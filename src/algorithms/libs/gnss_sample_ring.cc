@@ -0,0 +1,129 @@
+/*!
+ * \file gnss_sample_ring.cc
+ * \brief Ring buffer of the output of a signal conditioner, indexed by the
+ *  absolute sample counter of the stream.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sample_ring.h"
+#include <algorithm>
+#include <cstring>
+
+
+Gnss_Sample_Ring::Gnss_Sample_Ring(unsigned int capacity)
+{
+    unsigned int size = 1;
+    while (size < capacity)
+        {
+            size <<= 1;
+        }
+    d_buffer.resize(size);
+    d_mask = size - 1;
+    d_written = 0;
+}
+
+
+void Gnss_Sample_Ring::write(const std::complex<float>* in, unsigned int n)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    // only the last capacity() samples can be kept
+    if (n > d_buffer.size())
+        {
+            d_written += n - d_buffer.size();
+            in += n - d_buffer.size();
+            n = d_buffer.size();
+        }
+    unsigned int start = d_written & d_mask;
+    unsigned int first = std::min<unsigned int>(n, d_buffer.size() - start);
+    memcpy(&d_buffer[start], in, first * sizeof(std::complex<float>));
+    memcpy(&d_buffer[0], in + first, (n - first) * sizeof(std::complex<float>));
+    d_written += n;
+}
+
+
+unsigned long int Gnss_Sample_Ring::newest()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_written;
+}
+
+
+bool Gnss_Sample_Ring::read(unsigned long int stamp, std::complex<float>* out, unsigned int n)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    if (n > d_buffer.size() || stamp + n > d_written || stamp + d_buffer.size() < d_written)
+        {
+            return false;
+        }
+    unsigned int start = stamp & d_mask;
+    unsigned int first = std::min<unsigned int>(n, d_buffer.size() - start);
+    memcpy(out, &d_buffer[start], first * sizeof(std::complex<float>));
+    memcpy(out + first, &d_buffer[0], (n - first) * sizeof(std::complex<float>));
+    return true;
+}
+
+
+Gnss_Sample_Ring_Store& Gnss_Sample_Ring_Store::instance()
+{
+    static Gnss_Sample_Ring_Store store;
+    return store;
+}
+
+
+std::shared_ptr<Gnss_Sample_Ring> Gnss_Sample_Ring_Store::create(unsigned int rf_channel, unsigned int capacity)
+{
+    std::shared_ptr<Gnss_Sample_Ring> ring = std::make_shared<Gnss_Sample_Ring>(capacity);
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_rings[rf_channel] = ring;
+    return ring;
+}
+
+
+std::shared_ptr<Gnss_Sample_Ring> Gnss_Sample_Ring_Store::get(unsigned int rf_channel)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    std::map<unsigned int, std::shared_ptr<Gnss_Sample_Ring>>::iterator it = d_rings.find(rf_channel);
+    if (it == d_rings.end())
+        {
+            return std::shared_ptr<Gnss_Sample_Ring>();
+        }
+    return it->second;
+}
+
+
+void Gnss_Sample_Ring_Store::erase(unsigned int rf_channel)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_rings.erase(rf_channel);
+}
+
+
+void Gnss_Sample_Ring_Store::clear()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_rings.clear();
+}
@@ -0,0 +1,117 @@
+/*!
+ * \file gnss_sample_ring.h
+ * \brief Ring buffer of the output of a signal conditioner, indexed by the
+ *  absolute sample counter of the stream.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Each acquisition block used to get the conditioned samples only through
+ * its own input stream, so it searched whatever window happened to be at the
+ * head of its buffer. With a ring the acquisition reads the window it wants,
+ * the freshest one by default, by the sample stamp of its first sample.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SAMPLE_RING_H_
+#define GNSS_SDR_GNSS_SAMPLE_RING_H_
+
+#include <complex>
+#include <map>
+#include <memory>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+#include <volk_gnsssdr/volk_gnsssdr_huge_allocator.h>
+
+/*!
+ * \brief Last capacity() samples of a stream. Sample n of the stream is the
+ * one with stamp n, the first sample ever written has stamp 0. Rings of
+ * several megabytes are kept on huge pages.
+ */
+class Gnss_Sample_Ring
+{
+public:
+    //! The capacity is rounded up to a power of two
+    explicit Gnss_Sample_Ring(unsigned int capacity);
+
+    //! Appends n samples to the stream
+    void write(const std::complex<float>* in, unsigned int n);
+
+    //! Stamp of the next sample to be written, i.e. the number of samples written so far
+    unsigned long int newest();
+
+    /*!
+     * \brief Copies the n samples starting at \p stamp to \p out.
+     * \return false if any of them is not written yet or already overwritten.
+     */
+    bool read(unsigned long int stamp, std::complex<float>* out, unsigned int n);
+
+    unsigned int capacity() const
+    {
+        return d_buffer.size();
+    }
+
+private:
+    Gnss_Sample_Ring(const Gnss_Sample_Ring&);
+    Gnss_Sample_Ring& operator=(const Gnss_Sample_Ring&);
+    std::vector<std::complex<float>, volk_gnsssdr_huge_allocator<std::complex<float>>> d_buffer;
+    unsigned long int d_mask;
+    unsigned long int d_written;
+    boost::mutex d_mutex;
+};
+
+
+/*!
+ * \brief Process-wide rings of the signal conditioners, keyed by RF channel
+ * (Channel%d.RF_channel_ID, plus GNSS-SDR.rf_channel_offset when several
+ * receivers share the process). The flowgraph creates them when
+ * GNSS-SDR.sample_ring_ms is set.
+ */
+class Gnss_Sample_Ring_Store
+{
+public:
+    //! Returns the store shared by the whole process
+    static Gnss_Sample_Ring_Store& instance();
+
+    //! Creates the ring of \p rf_channel, replacing the previous one if any
+    std::shared_ptr<Gnss_Sample_Ring> create(unsigned int rf_channel, unsigned int capacity);
+
+    //! Returns the ring of \p rf_channel, or an empty pointer if there is none
+    std::shared_ptr<Gnss_Sample_Ring> get(unsigned int rf_channel);
+
+    //! Releases the ring of \p rf_channel, if any
+    void erase(unsigned int rf_channel);
+
+    //! Releases all the rings
+    void clear();
+
+private:
+    Gnss_Sample_Ring_Store() {}
+    Gnss_Sample_Ring_Store(const Gnss_Sample_Ring_Store&);
+    Gnss_Sample_Ring_Store& operator=(const Gnss_Sample_Ring_Store&);
+    std::map<unsigned int, std::shared_ptr<Gnss_Sample_Ring>> d_rings;
+    boost::mutex d_mutex;
+};
+
+#endif /* GNSS_SDR_GNSS_SAMPLE_RING_H_ */
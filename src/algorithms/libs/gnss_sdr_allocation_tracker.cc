@@ -0,0 +1,320 @@
+/*!
+ * \file gnss_sdr_allocation_tracker.cc
+ * \brief Counts the heap allocations of the block threads once the receiver runs
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_allocation_tracker.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sstream>
+#ifdef __linux__
+#include <execinfo.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+// Slot of the thread plus one, -1 if it is not tracked, 0 if not known yet
+thread_local int thread_state = 0;
+// Set while an allocation is being counted, so that the allocations made
+// by the tracker itself are not
+thread_local bool counting = false;
+}
+
+
+std::atomic<bool> Gnss_Sdr_Allocation_Tracker::d_armed(false);
+std::atomic<bool> Gnss_Sdr_Allocation_Tracker::d_abort(false);
+std::atomic<unsigned long long> Gnss_Sdr_Allocation_Tracker::d_allocations(0);
+std::atomic<unsigned int> Gnss_Sdr_Allocation_Tracker::d_slots_used(0);
+Gnss_Sdr_Allocation_Tracker::Thread_Slot Gnss_Sdr_Allocation_Tracker::d_slots[Gnss_Sdr_Allocation_Tracker::MAX_THREADS];
+char Gnss_Sdr_Allocation_Tracker::d_process_name[Gnss_Sdr_Allocation_Tracker::NAME_LENGTH];
+
+
+bool Gnss_Sdr_Allocation_Tracker::lock_memory(std::size_t reserve_bytes)
+{
+#ifdef __linux__
+    // One heap for all the threads, whose freed memory stays in the process
+    mallopt(M_ARENA_MAX, 1);
+    mallopt(M_MMAP_MAX, 0);
+    mallopt(M_TRIM_THRESHOLD, -1);
+    const bool locked = mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+    if (reserve_bytes > 0)
+        {
+            // The pages are touched once, then kept in the heap
+            char* reserve = static_cast<char*>(std::malloc(reserve_bytes));
+            if (reserve != nullptr)
+                {
+                    const std::size_t page = sysconf(_SC_PAGESIZE);
+                    for (std::size_t i = 0; i < reserve_bytes; i += page)
+                        {
+                            reserve[i] = 0;
+                        }
+                    std::free(reserve);
+                }
+        }
+    return locked;
+#else
+    (void)reserve_bytes;
+    return false;
+#endif
+}
+
+
+void Gnss_Sdr_Allocation_Tracker::arm(bool abort_on_allocation)
+{
+#ifdef __linux__
+    // The first call to backtrace loads the unwinder, which allocates
+    void* frames[2];
+    backtrace(frames, 2);
+    if (d_process_name[0] == '\0')
+        {
+            pthread_getname_np(pthread_self(), d_process_name, NAME_LENGTH);
+        }
+#endif
+    d_abort = abort_on_allocation;
+    d_armed = true;
+}
+
+
+void Gnss_Sdr_Allocation_Tracker::disarm()
+{
+    d_armed = false;
+}
+
+
+bool Gnss_Sdr_Allocation_Tracker::armed()
+{
+    return d_armed;
+}
+
+
+int Gnss_Sdr_Allocation_Tracker::classify_current_thread()
+{
+    char name[NAME_LENGTH] = "";
+#ifdef __linux__
+    pthread_getname_np(pthread_self(), name, NAME_LENGTH);
+    if (std::strncmp(name, d_process_name, NAME_LENGTH) == 0)
+        {
+            return -1;
+        }
+#else
+    return -1;
+#endif
+    const unsigned int slot = d_slots_used.fetch_add(1);
+    if (slot >= MAX_THREADS)
+        {
+            // counted in the total only
+            return -1;
+        }
+    std::strncpy(d_slots[slot].name, name, NAME_LENGTH - 1);
+    return slot + 1;
+}
+
+
+void Gnss_Sdr_Allocation_Tracker::track_current_thread(bool tracked)
+{
+    if (!tracked)
+        {
+            thread_state = -1;
+        }
+    else if (thread_state <= 0)
+        {
+            // forget the name, this thread is tracked anyway
+            const unsigned int slot = d_slots_used.fetch_add(1);
+            thread_state = slot < MAX_THREADS ? static_cast<int>(slot) + 1 : -1;
+#ifdef __linux__
+            if (slot < MAX_THREADS) pthread_getname_np(pthread_self(), d_slots[slot].name, NAME_LENGTH);
+#endif
+        }
+}
+
+
+void Gnss_Sdr_Allocation_Tracker::on_allocation()
+{
+    if (!d_armed.load(std::memory_order_relaxed) || counting)
+        {
+            return;
+        }
+    counting = true;
+    if (thread_state == 0)
+        {
+            thread_state = classify_current_thread();
+        }
+    if (thread_state > 0)
+        {
+            d_allocations.fetch_add(1, std::memory_order_relaxed);
+            Thread_Slot & slot = d_slots[thread_state - 1];
+            if (slot.allocations.fetch_add(1, std::memory_order_relaxed) == 0)
+                {
+#ifdef __linux__
+                    slot.depth = backtrace(slot.frames, MAX_FRAMES);
+#endif
+                }
+            if (d_abort)
+                {
+#ifdef __linux__
+                    // nothing is allocated on the way out
+                    const char message[] = "Heap allocation in the block thread ";
+                    ssize_t written = write(STDERR_FILENO, message, sizeof(message) - 1);
+                    written = write(STDERR_FILENO, slot.name, std::strlen(slot.name));
+                    written = write(STDERR_FILENO, "\n", 1);
+                    (void)written;
+                    backtrace_symbols_fd(slot.frames, slot.depth, STDERR_FILENO);
+#endif
+                    std::abort();
+                }
+        }
+    counting = false;
+}
+
+
+unsigned long long Gnss_Sdr_Allocation_Tracker::allocations()
+{
+    return d_allocations;
+}
+
+
+std::vector<Gnss_Sdr_Allocation_Tracker::Thread_Allocations> Gnss_Sdr_Allocation_Tracker::threads()
+{
+    std::vector<Thread_Allocations> result;
+    const unsigned int max_threads = MAX_THREADS;
+    const unsigned int used = std::min(d_slots_used.load(), max_threads);
+    for (unsigned int i = 0; i < used; i++)
+        {
+            const unsigned long long allocations = d_slots[i].allocations;
+            if (allocations == 0) continue;
+            Thread_Allocations thread;
+            thread.name = d_slots[i].name;
+            thread.allocations = allocations;
+#ifdef __linux__
+            char** symbols = backtrace_symbols(d_slots[i].frames, d_slots[i].depth);
+            if (symbols != nullptr)
+                {
+                    // the first frames are the tracker and operator new
+                    for (int f = 2; f < d_slots[i].depth; f++)
+                        {
+                            thread.first_stack.push_back(symbols[f]);
+                        }
+                    std::free(symbols);
+                }
+#endif
+            result.push_back(thread);
+        }
+    return result;
+}
+
+
+std::vector<std::string> Gnss_Sdr_Allocation_Tracker::summary()
+{
+    std::vector<std::string> lines;
+    std::vector<Thread_Allocations> allocating = threads();
+    for (unsigned int i = 0; i < allocating.size(); i++)
+        {
+            std::ostringstream line;
+            line << allocating[i].name << ": " << allocating[i].allocations << " allocations, the first one from";
+            lines.push_back(line.str());
+            for (unsigned int f = 0; f < allocating[i].first_stack.size(); f++)
+                {
+                    lines.push_back("    " + allocating[i].first_stack[f]);
+                }
+        }
+    return lines;
+}
+
+
+/*
+ * Replacements of the global allocation functions. The others (arrays,
+ * nothrow) call these ones.
+ */
+void* operator new(std::size_t size)
+{
+    Gnss_Sdr_Allocation_Tracker::on_allocation();
+    if (size == 0) size = 1;
+    void* p;
+    while ((p = std::malloc(size)) == nullptr)
+        {
+            std::new_handler handler = std::get_new_handler();
+            if (handler == nullptr) throw std::bad_alloc();
+            handler();
+        }
+    return p;
+}
+
+
+void* operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    try
+        {
+            return operator new(size);
+        }
+    catch (const std::bad_alloc &)
+        {
+            return nullptr;
+        }
+}
+
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+
+void* operator new[](std::size_t size, const std::nothrow_t & tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+
+void operator delete(void* p, const std::nothrow_t &) noexcept
+{
+    std::free(p);
+}
+
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+
+void operator delete[](void* p, const std::nothrow_t &) noexcept
+{
+    std::free(p);
+}
@@ -0,0 +1,123 @@
+/*!
+ * \file gnss_sdr_allocation_tracker.h
+ * \brief Counts the heap allocations of the block threads once the receiver runs
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * A block that allocates in its work function may wait for the allocator
+ * lock, or for the kernel to map a page, for as long as it likes. In the
+ * real-time mode the memory of the process is locked and a heap is
+ * reserved up front, and every operator new called by a block thread after
+ * the start is counted here, so that the receiver can be certified free of
+ * them, or made to abort at the first one.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_ALLOCATION_TRACKER_H_
+#define GNSS_SDR_GNSS_SDR_ALLOCATION_TRACKER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*!
+ * \brief Heap allocations of the block threads, counted by the replacement
+ * of the global operator new.
+ *
+ * The block threads are those named by GNU Radio after their block; the
+ * threads of the receiver keep the name of the process and are not
+ * tracked, unless track_current_thread() says otherwise. Nothing is
+ * counted, and operator new costs one more load, until arm() is called.
+ */
+class Gnss_Sdr_Allocation_Tracker
+{
+public:
+    //! Allocations of one thread
+    struct Thread_Allocations
+    {
+        std::string name;
+        unsigned long long allocations;
+        std::vector<std::string> first_stack;  //!< Call stack of its first allocation
+    };
+
+    /*!
+     * \brief Locks the pages of the process in memory (mlockall) and
+     * reserves a heap of \p reserve_bytes, that is never given back to the
+     * system, so that later allocations neither fault nor map pages.
+     * \return false if the pages could not be locked (see RLIMIT_MEMLOCK)
+     */
+    static bool lock_memory(std::size_t reserve_bytes);
+
+    /*!
+     * \brief Starts counting. With \p abort_on_allocation, the first
+     * allocation of a block thread writes its stack to stderr and aborts.
+     */
+    static void arm(bool abort_on_allocation);
+
+    //! Stops counting, the counts are kept
+    static void disarm();
+
+    static bool armed();
+
+    //! Tracks the calling thread, or not, whatever its name
+    static void track_current_thread(bool tracked);
+
+    //! Allocations counted since the process started
+    static unsigned long long allocations();
+
+    //! The threads with allocations
+    static std::vector<Thread_Allocations> threads();
+
+    //! One line per thread with allocations, and the first stack of each
+    static std::vector<std::string> summary();
+
+    //! Called by operator new
+    static void on_allocation();
+
+private:
+    static const unsigned int MAX_THREADS = 64;
+    static const unsigned int MAX_FRAMES = 24;
+    static const unsigned int NAME_LENGTH = 16;
+
+    struct Thread_Slot
+    {
+        char name[NAME_LENGTH];
+        std::atomic<unsigned long long> allocations;
+        void* frames[MAX_FRAMES];
+        int depth;
+    };
+
+    static int classify_current_thread();
+
+    static std::atomic<bool> d_armed;
+    static std::atomic<bool> d_abort;
+    static std::atomic<unsigned long long> d_allocations;
+    static std::atomic<unsigned int> d_slots_used;
+    static Thread_Slot d_slots[MAX_THREADS];
+    static char d_process_name[NAME_LENGTH];
+};
+
+#endif /*GNSS_SDR_GNSS_SDR_ALLOCATION_TRACKER_H_*/
@@ -0,0 +1,68 @@
+/*!
+ * \file gnss_sdr_buffer_tuning.cc
+ * \brief Sizes of the stream buffers and of the work calls of the blocks
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_buffer_tuning.h"
+#include <algorithm>
+#include <cmath>
+#include "GPS_L1_CA.h"
+#include "GPS_L2C.h"
+#include "Galileo_E1.h"
+#include "Galileo_E5a.h"
+
+
+double Gnss_Sdr_Buffer_Tuning::code_period(const std::string & signal)
+{
+    if (signal == "1C") return GPS_L1_CA_CODE_PERIOD;
+    if (signal == "2S") return GPS_L2_M_PERIOD;
+    if (signal == "1B") return Galileo_E1_CODE_PERIOD;
+    if (signal == "5X") return GALILEO_E5a_CODE_PERIOD;
+    return 0.001;
+}
+
+
+Gnss_Sdr_Buffer_Settings Gnss_Sdr_Buffer_Tuning::autotune(double item_rate_hz, size_t item_size,
+        double work_period_s, double buffer_period_s)
+{
+    Gnss_Sdr_Buffer_Settings settings = { 0, 0, 0 };
+    if (item_rate_hz <= 0.0 || item_size == 0 || work_period_s <= 0.0)
+        {
+            return settings;
+        }
+    const long max_items = std::max(static_cast<long>(MAX_BUFFER_BYTES / item_size), 2L);
+    long work_items = std::max(static_cast<long>(std::ceil(item_rate_hz * work_period_s)), 1L);
+    work_items = std::min(work_items, max_items / 2);
+    long buffer_items = static_cast<long>(std::ceil(item_rate_hz * std::max(buffer_period_s, 0.0)));
+    buffer_items = std::min(std::max(buffer_items, 2 * work_items), max_items);
+
+    settings.min_output_buffer = buffer_items;
+    settings.max_output_buffer = buffer_items;
+    settings.max_noutput_items = static_cast<int>(work_items);
+    return settings;
+}
@@ -0,0 +1,74 @@
+/*!
+ * \file gnss_sdr_buffer_tuning.h
+ * \brief Sizes of the stream buffers and of the work calls of the blocks
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * GNU Radio gives every output a buffer of 32 KB and lets the blocks
+ * produce as many items as fit in it. At a few Msps that is a work call
+ * every few hundreds of microseconds for the conditioner, while the
+ * tracking outputs, with an item per integration period, hold seconds of
+ * items that are never used. The buffers are better sized in time: a work
+ * call per integration period of the fastest channel and a buffer for some
+ * integration periods of the slowest one.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_BUFFER_TUNING_H_
+#define GNSS_SDR_GNSS_SDR_BUFFER_TUNING_H_
+
+#include <cstddef>
+#include <string>
+
+//! Buffer options of the outputs of a block, 0 leaves the GNU Radio default
+struct Gnss_Sdr_Buffer_Settings
+{
+    long min_output_buffer;  // items
+    long max_output_buffer;  // items
+    int max_noutput_items;
+};
+
+class Gnss_Sdr_Buffer_Tuning
+{
+public:
+    //! Largest buffer given by autotune(), in bytes
+    static const size_t MAX_BUFFER_BYTES = 64 * 1024 * 1024;
+
+    //! Code period in seconds of a signal ("1C", "2S", "1B" or "5X"), 1 ms if unknown
+    static double code_period(const std::string & signal);
+
+    /*!
+     * \brief Settings of a block that produces \p item_rate_hz items of
+     * \p item_size bytes per second, in work calls of \p work_period_s
+     * seconds, into a buffer of \p buffer_period_s seconds. The buffer holds
+     * two work calls at least and MAX_BUFFER_BYTES at most; the minimum and
+     * maximum sizes are the same. GNU Radio still makes it larger if the
+     * history of a downstream block needs it.
+     */
+    static Gnss_Sdr_Buffer_Settings autotune(double item_rate_hz, size_t item_size,
+            double work_period_s, double buffer_period_s);
+};
+
+#endif /* GNSS_SDR_GNSS_SDR_BUFFER_TUNING_H_ */
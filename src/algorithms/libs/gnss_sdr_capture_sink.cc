@@ -0,0 +1,93 @@
+/*!
+ * \file gnss_sdr_capture_sink.cc
+ * \brief GNU Radio sink that captures the samples of a signal source, and
+ *  their "rx_time" tags, with Gnss_Sample_Capture_Writer.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_capture_sink.h"
+#include "gnss_sdr_trace.h"
+#include <stdexcept>
+#include <vector>
+#include <gnuradio/io_signature.h>
+#include <pmt/pmt.h>
+
+
+gnss_sdr_capture_sink_sptr gnss_sdr_make_capture_sink(size_t sizeof_stream_item, const std::string & filename,
+        unsigned int bits, double sample_rate, size_t buffer_size, unsigned int buffers)
+{
+    return gnss_sdr_capture_sink_sptr(new gnss_sdr_capture_sink(sizeof_stream_item, filename,
+            bits, sample_rate, buffer_size, buffers));
+}
+
+
+gnss_sdr_capture_sink::gnss_sdr_capture_sink(size_t sizeof_stream_item, const std::string & filename,
+        unsigned int bits, double sample_rate, size_t buffer_size, unsigned int buffers) :
+        gr::sync_block("capture_sink",
+                gr::io_signature::make(1, 1, sizeof_stream_item),
+                gr::io_signature::make(0, 0, 0)),
+        d_writer(buffer_size, buffers)
+{
+    if (!d_writer.open(filename, sizeof_stream_item, bits, sample_rate))
+        {
+            throw std::runtime_error("capture_sink: cannot create " + filename);
+        }
+}
+
+
+gnss_sdr_capture_sink::~gnss_sdr_capture_sink()
+{
+    d_writer.close();
+}
+
+
+bool gnss_sdr_capture_sink::stop()
+{
+    d_writer.close();
+    return true;
+}
+
+
+int gnss_sdr_capture_sink::work(int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items __attribute__((unused)))
+{
+    GNSS_SDR_TRACE_SCOPE("gnss_sdr_capture_sink::work");
+    std::vector<gr::tag_t> tags;
+    get_tags_in_range(tags, 0, nitems_read(0), nitems_read(0) + noutput_items, pmt::mp("rx_time"));
+    for (std::vector<gr::tag_t>::const_iterator tag = tags.begin(); tag != tags.end(); ++tag)
+        {
+            // (full seconds, fractional seconds), as in the UHD source
+            if (pmt::is_tuple(tag->value) && pmt::length(tag->value) == 2)
+                {
+                    d_writer.time_tag(tag->offset, pmt::to_uint64(pmt::tuple_ref(tag->value, 0)),
+                            pmt::to_double(pmt::tuple_ref(tag->value, 1)));
+                }
+        }
+    d_writer.write(input_items[0], noutput_items);
+    return noutput_items;
+}
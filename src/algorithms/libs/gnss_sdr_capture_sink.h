@@ -0,0 +1,70 @@
+/*!
+ * \file gnss_sdr_capture_sink.h
+ * \brief GNU Radio sink that captures the samples of a signal source, and
+ *  their "rx_time" tags, with Gnss_Sample_Capture_Writer.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_CAPTURE_SINK_H_
+#define GNSS_SDR_GNSS_SDR_CAPTURE_SINK_H_
+
+#include <string>
+#include <gnuradio/sync_block.h>
+#include "gnss_sample_capture.h"
+
+class gnss_sdr_capture_sink;
+typedef boost::shared_ptr<gnss_sdr_capture_sink> gnss_sdr_capture_sink_sptr;
+
+/*!
+ * \brief Makes a sink that captures items of \p sizeof_stream_item bytes to
+ * \p filename, requantized to \p bits bits per component (0: raw items).
+ * Throws std::runtime_error if the files cannot be created.
+ */
+gnss_sdr_capture_sink_sptr gnss_sdr_make_capture_sink(size_t sizeof_stream_item, const std::string & filename,
+        unsigned int bits, double sample_rate, size_t buffer_size, unsigned int buffers);
+
+class gnss_sdr_capture_sink : public gr::sync_block
+{
+    friend gnss_sdr_capture_sink_sptr gnss_sdr_make_capture_sink(size_t sizeof_stream_item, const std::string & filename,
+            unsigned int bits, double sample_rate, size_t buffer_size, unsigned int buffers);
+    gnss_sdr_capture_sink(size_t sizeof_stream_item, const std::string & filename,
+            unsigned int bits, double sample_rate, size_t buffer_size, unsigned int buffers);
+
+    Gnss_Sample_Capture_Writer d_writer;
+
+public:
+    ~gnss_sdr_capture_sink();
+
+    //! Closes the capture when the flowgraph stops
+    bool stop();
+
+    int work(int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif /*GNSS_SDR_GNSS_SDR_CAPTURE_SINK_H_*/
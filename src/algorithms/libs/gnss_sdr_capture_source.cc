@@ -0,0 +1,75 @@
+/*!
+ * \file gnss_sdr_capture_source.cc
+ * \brief GNU Radio source that replays a capture of gnss_sdr_capture_sink.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_capture_source.h"
+#include "gnss_sdr_trace.h"
+#include <vector>
+#include <gnuradio/io_signature.h>
+#include <pmt/pmt.h>
+
+
+gnss_sdr_capture_source_sptr gnss_sdr_make_capture_source(std::shared_ptr<Gnss_Sample_Capture_Reader> reader)
+{
+    return gnss_sdr_capture_source_sptr(new gnss_sdr_capture_source(reader));
+}
+
+
+gnss_sdr_capture_source::gnss_sdr_capture_source(std::shared_ptr<Gnss_Sample_Capture_Reader> reader) :
+        gr::sync_block("capture_source",
+                gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(1, 1, reader->output_item_size())),
+        d_reader(reader), d_next_tag(0)
+{}
+
+
+gnss_sdr_capture_source::~gnss_sdr_capture_source()
+{}
+
+
+int gnss_sdr_capture_source::work(int noutput_items,
+        gr_vector_const_void_star &input_items __attribute__((unused)),
+        gr_vector_void_star &output_items)
+{
+    GNSS_SDR_TRACE_SCOPE("gnss_sdr_capture_source::work");
+    const unsigned int n = d_reader->read(output_items[0], noutput_items);
+    if (n == 0)
+        {
+            return WORK_DONE;
+        }
+    const std::vector<Gnss_Sample_Capture_Reader::Time_Tag> & tags = d_reader->time_tags();
+    const unsigned long long end = nitems_written(0) + n;
+    while (d_next_tag < tags.size() && tags[d_next_tag].sample < end)
+        {
+            add_item_tag(0, tags[d_next_tag].sample, pmt::mp("rx_time"),
+                    pmt::make_tuple(pmt::from_uint64(tags[d_next_tag].seconds), pmt::from_double(tags[d_next_tag].fraction)));
+            d_next_tag++;
+        }
+    return n;
+}
@@ -0,0 +1,67 @@
+/*!
+ * \file gnss_sdr_capture_source.h
+ * \brief GNU Radio source that replays a capture of gnss_sdr_capture_sink.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The samples come out at the positions they had in the session, with
+ * zeros where the capture dropped some, and with the "rx_time" tags of
+ * the source, so the front-end overflows show up again downstream.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_CAPTURE_SOURCE_H_
+#define GNSS_SDR_GNSS_SDR_CAPTURE_SOURCE_H_
+
+#include <memory>
+#include <string>
+#include <gnuradio/sync_block.h>
+#include "gnss_sample_capture.h"
+
+class gnss_sdr_capture_source;
+typedef boost::shared_ptr<gnss_sdr_capture_source> gnss_sdr_capture_source_sptr;
+
+/*!
+ * \brief Takes an open reader. Its items are reader->output_item_size() bytes.
+ */
+gnss_sdr_capture_source_sptr gnss_sdr_make_capture_source(std::shared_ptr<Gnss_Sample_Capture_Reader> reader);
+
+class gnss_sdr_capture_source : public gr::sync_block
+{
+    friend gnss_sdr_capture_source_sptr gnss_sdr_make_capture_source(std::shared_ptr<Gnss_Sample_Capture_Reader> reader);
+    gnss_sdr_capture_source(std::shared_ptr<Gnss_Sample_Capture_Reader> reader);
+
+    std::shared_ptr<Gnss_Sample_Capture_Reader> d_reader;
+    unsigned int d_next_tag;
+
+public:
+    ~gnss_sdr_capture_source();
+
+    int work(int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif /*GNSS_SDR_GNSS_SDR_CAPTURE_SOURCE_H_*/
@@ -0,0 +1,293 @@
+/*!
+ * \file gnss_sdr_event_log.cc
+ * \brief Non-blocking console and log output for the real-time threads
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_event_log.h"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <glog/logging.h>
+#include "concurrent_queue.h"
+#include "gnss_satellite.h"
+
+using google::LogMessage;
+
+std::atomic<bool> Gnss_Sdr_Event_Log::d_running(false);
+std::atomic<unsigned long long> Gnss_Sdr_Event_Log::d_dropped(0);
+std::mutex Gnss_Sdr_Event_Log::d_mutex;
+std::thread Gnss_Sdr_Event_Log::d_thread;
+
+namespace
+{
+// Time the thread sleeps when the queue is empty
+const unsigned int EVENT_LOG_PERIOD_MS = 20;
+
+concurrent_queue<Gnss_Sdr_Event> & event_queue()
+{
+    static concurrent_queue<Gnss_Sdr_Event> queue(Gnss_Sdr_Event_Log::queue_capacity);
+    return queue;
+}
+
+std::string system_name(char system)
+{
+    switch (system)
+    {
+    case 'G': return "GPS";
+    case 'E': return "Galileo";
+    case 'S': return "SBAS";
+    case 'R': return "GLONASS";
+    case 'C': return "Beidou";
+    default: return "";
+    }
+}
+
+// Writes the events still queued when the program exits
+struct Event_Log_Flusher
+{
+    Event_Log_Flusher()
+    {
+        event_queue();  // so that the queue is destroyed after this
+    }
+    ~Event_Log_Flusher()
+    {
+        Gnss_Sdr_Event_Log::flush();
+    }
+} event_log_flusher;
+
+Gnss_Sdr_Event make_event(Gnss_Sdr_Event_Type type, unsigned int sinks, int channel, char system, unsigned int prn)
+{
+    Gnss_Sdr_Event event = Gnss_Sdr_Event();
+    event.type = type;
+    event.sinks = sinks;
+    event.channel = channel;
+    event.system = system;
+    event.prn = prn;
+    return event;
+}
+
+long long to_microseconds(boost::posix_time::ptime utc)
+{
+    return (utc - boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1))).total_microseconds();
+}
+}
+
+
+bool Gnss_Sdr_Event_Log::post(const Gnss_Sdr_Event & event)
+{
+    if (!d_running.load(std::memory_order_acquire))
+        {
+            start();
+        }
+    if (!event_queue().try_push(event))
+        {
+            d_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    return true;
+}
+
+
+void Gnss_Sdr_Event_Log::tracking_start(int channel, char system, unsigned int prn)
+{
+    post(make_event(EVENT_TRACKING_START, EVENT_TO_CONSOLE | EVENT_TO_LOG, channel, system, prn));
+}
+
+
+void Gnss_Sdr_Event_Log::loss_of_lock(int channel)
+{
+    post(make_event(EVENT_LOSS_OF_LOCK, EVENT_TO_CONSOLE | EVENT_TO_LOG, channel, 0, 0));
+}
+
+
+void Gnss_Sdr_Event_Log::satellite_event(Gnss_Sdr_Event_Type type, int channel, char system, unsigned int prn,
+        long long count, unsigned int sinks)
+{
+    Gnss_Sdr_Event event = make_event(type, sinks, channel, system, prn);
+    event.count = count;
+    post(event);
+}
+
+
+void Gnss_Sdr_Event_Log::position(boost::posix_time::ptime utc, unsigned int observations, double latitude_deg,
+        double longitude_deg, double height_m, char system, unsigned int sinks)
+{
+    Gnss_Sdr_Event event = make_event(EVENT_POSITION, sinks, -1, system, 0);
+    event.count = observations;
+    event.utc_us = to_microseconds(utc);
+    event.values[0] = latitude_deg;
+    event.values[1] = longitude_deg;
+    event.values[2] = height_m;
+    post(event);
+}
+
+
+void Gnss_Sdr_Event_Log::dop(boost::posix_time::ptime utc, unsigned int observations, double hdop, double vdop,
+        double tdop, double gdop, unsigned int sinks)
+{
+    Gnss_Sdr_Event event = make_event(EVENT_DOP, sinks, -1, 0, 0);
+    event.count = observations;
+    event.utc_us = to_microseconds(utc);
+    event.values[0] = hdop;
+    event.values[1] = vdop;
+    event.values[2] = tdop;
+    event.values[3] = gdop;
+    post(event);
+}
+
+
+std::string Gnss_Sdr_Event_Log::format(const Gnss_Sdr_Event & event)
+{
+    std::stringstream text;
+    const boost::posix_time::ptime utc = boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1))
+            + boost::posix_time::microseconds(event.utc_us);
+    switch (event.type)
+    {
+    case EVENT_TRACKING_START:
+        text << "Tracking start on channel " << event.channel << " for satellite "
+             << Gnss_Satellite(system_name(event.system), event.prn);
+        break;
+    case EVENT_LOSS_OF_LOCK:
+        text << "Loss of lock in channel " << event.channel << "!";
+        break;
+    case EVENT_SECONDARY_CODE_LOCKED:
+        text << "Secondary code locked in channel " << event.channel << ".";
+        break;
+    case EVENT_SECONDARY_CODE_UNRESOLVED:
+        text << "Secondary code delay couldn't be resolved in channel " << event.channel << ".";
+        break;
+    case EVENT_EXTENDED_CORRELATION:
+        text << "Enabled " << event.values[0] << " [ms] extended correlator for CH " << event.channel
+             << " : Satellite " << Gnss_Satellite(system_name(event.system), event.prn)
+             << " pll_bw = " << event.values[1] << " [Hz], pll_narrow_bw = " << event.values[2] << " [Hz]" << std::endl
+             << " dll_bw = " << event.values[3] << " [Hz], dll_narrow_bw = " << event.values[4] << " [Hz]";
+        break;
+    case EVENT_GALILEO_CRC_OK:
+        text << "Galileo CRC correct on channel " << event.channel << " from satellite "
+             << Gnss_Satellite(system_name(event.system), event.prn);
+        break;
+    case EVENT_GALILEO_CRC_ERROR:
+        text << "Galileo CRC error on channel " << event.channel << " from satellite "
+             << Gnss_Satellite(system_name(event.system), event.prn);
+        break;
+    case EVENT_GALILEO_ALMANAC:
+        text << "Galileo almanac received!";
+        break;
+    case EVENT_CNAV_FRAME:
+        text << "Valid CNAV frame with relative preamble start at " << event.count;
+        break;
+    case EVENT_CNAV_EPHEMERIS:
+        text << "New GPS CNAV Ephemeris received for SV " << event.prn;
+        break;
+    case EVENT_CNAV_IONO:
+        text << "New GPS CNAV IONO model received for SV " << event.prn;
+        break;
+    case EVENT_SBAS_MESSAGE:
+        text << "SBAS message type " << event.count << " from PRN" << event.prn << " received";
+        break;
+    case EVENT_RX_TIME:
+        text << "Current input signal time = " << event.count << " [s]";
+        break;
+    case EVENT_POSITION:
+        text << (event.system == 'E' ? "Galileo Position at " : "Position at ")
+             << boost::posix_time::to_simple_string(utc) << " UTC";
+        if (event.count > 0) text << " using " << event.count << " observations";
+        text << " is Lat = " << event.values[0] << " [deg], Long = " << event.values[1]
+             << " [deg], Height= " << event.values[2] << " [m]";
+        break;
+    case EVENT_DOP:
+        text << "Dilution of Precision at " << boost::posix_time::to_simple_string(utc);
+        if (event.count > 0) text << " UTC using " << event.count << " observations";
+        text << " is HDOP = " << event.values[0] << " VDOP = " << event.values[1]
+             << " TDOP = " << event.values[2] << " GDOP = " << event.values[3];
+        break;
+    }
+    return text.str();
+}
+
+
+void Gnss_Sdr_Event_Log::start()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    if (d_running.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+    d_running.store(true, std::memory_order_release);
+    d_thread = std::thread(&Gnss_Sdr_Event_Log::run);
+}
+
+
+void Gnss_Sdr_Event_Log::run()
+{
+    while (d_running.load(std::memory_order_acquire))
+        {
+            if (drain() == 0)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(EVENT_LOG_PERIOD_MS));
+                }
+        }
+}
+
+
+unsigned int Gnss_Sdr_Event_Log::drain()
+{
+    unsigned int written = 0;
+    Gnss_Sdr_Event event;
+    while (event_queue().try_pop(event))
+        {
+            const std::string text = format(event);
+            if (event.sinks & EVENT_TO_CONSOLE)
+                {
+                    std::cout << text << std::endl;
+                }
+            if (event.sinks & EVENT_TO_LOG)
+                {
+                    LOG(INFO) << text;
+                }
+            written++;
+        }
+    return written;
+}
+
+
+void Gnss_Sdr_Event_Log::flush()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_running.store(false, std::memory_order_release);
+    if (d_thread.joinable())
+        {
+            d_thread.join();
+        }
+    drain();
+    const unsigned long long dropped = d_dropped.exchange(0);
+    if (dropped > 0)
+        {
+            LOG(WARNING) << dropped << " console and log messages were dropped because the event queue was full";
+        }
+}
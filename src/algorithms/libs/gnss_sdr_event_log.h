@@ -0,0 +1,131 @@
+/*!
+ * \file gnss_sdr_event_log.h
+ * \brief Non-blocking console and log output for the real-time threads
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_EVENT_LOG_H_
+#define GNSS_SDR_GNSS_SDR_EVENT_LOG_H_
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+enum Gnss_Sdr_Event_Type
+{
+    EVENT_TRACKING_START = 0,
+    EVENT_LOSS_OF_LOCK,
+    EVENT_SECONDARY_CODE_LOCKED,
+    EVENT_SECONDARY_CODE_UNRESOLVED,
+    EVENT_EXTENDED_CORRELATION,  // values: extended ms, PLL and narrow PLL bandwidths, DLL and narrow DLL bandwidths
+    EVENT_GALILEO_CRC_OK,
+    EVENT_GALILEO_CRC_ERROR,
+    EVENT_GALILEO_ALMANAC,
+    EVENT_CNAV_FRAME,            // count: preamble start
+    EVENT_CNAV_EPHEMERIS,
+    EVENT_CNAV_IONO,
+    EVENT_SBAS_MESSAGE,          // count: message type
+    EVENT_RX_TIME,               // count: seconds of signal
+    EVENT_POSITION,              // count: observations (0: not shown); values: latitude, longitude, height
+    EVENT_DOP                    // count: observations (0: not shown); values: HDOP, VDOP, TDOP, GDOP
+};
+
+//! Where an event is written
+enum Gnss_Sdr_Event_Sink
+{
+    EVENT_TO_CONSOLE = 1,
+    EVENT_TO_LOG = 2
+};
+
+/*!
+ * \brief A fixed-size binary record of an event. The text is only made by
+ * the thread of Gnss_Sdr_Event_Log.
+ */
+struct Gnss_Sdr_Event
+{
+    Gnss_Sdr_Event_Type type;
+    unsigned int sinks;
+    int channel;
+    char system;        // 'G', 'E', 'S', 'R', or 0 if there is no satellite
+    unsigned int prn;
+    long long count;
+    long long utc_us;   // UTC time of a position, in microseconds since 1970
+    double values[5];
+};
+
+/*!
+ * \brief Console and log output of the tracking, telemetry and PVT blocks,
+ * off their threads.
+ *
+ * post() copies the record into a bounded lock-free queue and returns at
+ * once; it never takes a lock nor waits for the console or the log file,
+ * and it drops the event if the queue is full. A background thread, started
+ * with the first event, formats the records and writes them a few tens of
+ * milliseconds later, in the order they were posted.
+ */
+class Gnss_Sdr_Event_Log
+{
+public:
+    static const unsigned int queue_capacity = 4096;
+
+    //! Returns false, and counts the event as dropped, if the queue is full
+    static bool post(const Gnss_Sdr_Event & event);
+
+    static void tracking_start(int channel, char system, unsigned int prn);
+    static void loss_of_lock(int channel);
+    static void satellite_event(Gnss_Sdr_Event_Type type, int channel, char system, unsigned int prn,
+            long long count = 0, unsigned int sinks = EVENT_TO_CONSOLE);
+    static void position(boost::posix_time::ptime utc, unsigned int observations, double latitude_deg,
+            double longitude_deg, double height_m, char system, unsigned int sinks);
+    static void dop(boost::posix_time::ptime utc, unsigned int observations, double hdop, double vdop,
+            double tdop, double gdop, unsigned int sinks);
+
+    //! Text of an event
+    static std::string format(const Gnss_Sdr_Event & event);
+
+    //! Writes the pending events and stops the thread. A later event starts it again.
+    static void flush();
+
+    static unsigned long long dropped()
+    {
+        return d_dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    static void start();
+    static void run();
+    static unsigned int drain();
+
+    static std::atomic<bool> d_running;
+    static std::atomic<unsigned long long> d_dropped;
+    static std::mutex d_mutex;
+    static std::thread d_thread;
+};
+
+#endif /*GNSS_SDR_GNSS_SDR_EVENT_LOG_H_*/
@@ -0,0 +1,306 @@
+/*!
+ * \file gnss_sdr_hw_counters.cc
+ * \brief Hardware performance counters of the work of the blocks
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_hw_counters.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <glog/logging.h>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using google::LogMessage;
+
+
+const unsigned int Gnss_Sdr_Hw_Counters::events;
+std::atomic<bool> Gnss_Sdr_Hw_Counter_Registry::d_enabled(false);
+std::mutex Gnss_Sdr_Hw_Counter_Registry::d_mutex;
+std::multimap<std::string, std::shared_ptr<Gnss_Sdr_Hw_Counters> > Gnss_Sdr_Hw_Counter_Registry::d_counters;
+
+
+const char * Gnss_Sdr_Hw_Counters::event_name(unsigned int event)
+{
+    static const char * names[events] = {"cycles", "instructions", "cache_misses", "branch_misses"};
+    return event < events ? names[event] : "";
+}
+
+
+Gnss_Sdr_Hw_Counters::Gnss_Sdr_Hw_Counters() : d_available(false), d_calls(0)
+{
+    for (unsigned int event = 0; event < events; event++)
+        {
+            d_fd[event] = -1;
+            d_index[event] = 0;
+            d_start[event] = 0;
+            d_counts[event] = 0;
+        }
+    d_opened = 0;
+    d_failed = false;
+    d_start_enabled_ns = 0;
+    d_start_running_ns = 0;
+    d_started = false;
+}
+
+
+Gnss_Sdr_Hw_Counters::~Gnss_Sdr_Hw_Counters()
+{
+    close();
+}
+
+
+bool Gnss_Sdr_Hw_Counters::open()
+{
+#if defined(__linux__)
+    static const unsigned long long configs[events] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    d_opened = 0;
+    for (unsigned int event = 0; event < events; event++)
+        {
+            struct perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[event];
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            // the cycles lead the group, without them there is no group
+            const int leader = event == cycles ? -1 : d_fd[cycles];
+            if (event != cycles && leader < 0) break;
+            // this thread, on any CPU
+            d_fd[event] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0));
+            if (d_fd[event] >= 0)
+                {
+                    d_index[event] = d_opened++;
+                }
+        }
+    if (d_fd[cycles] < 0)
+        {
+            LOG(WARNING) << "Hardware performance counters not available: " << std::strerror(errno)
+                         << ". Check /proc/sys/kernel/perf_event_paranoid";
+            return false;
+        }
+    for (unsigned int event = 0; event < events; event++)
+        {
+            if (d_fd[event] < 0) LOG(WARNING) << "Hardware performance counter " << event_name(event) << " not available";
+        }
+    d_thread = std::this_thread::get_id();
+    return true;
+#else
+    LOG(WARNING) << "Hardware performance counters are only read on Linux";
+    return false;
+#endif
+}
+
+
+void Gnss_Sdr_Hw_Counters::close()
+{
+#if defined(__linux__)
+    // the members first, then the leader
+    for (int event = events - 1; event >= 0; event--)
+        {
+            if (d_fd[event] >= 0) ::close(d_fd[event]);
+            d_fd[event] = -1;
+        }
+#endif
+    d_opened = 0;
+}
+
+
+bool Gnss_Sdr_Hw_Counters::read(unsigned long long * values, unsigned long long & enabled_ns, unsigned long long & running_ns)
+{
+#if defined(__linux__)
+    // nr, time enabled, time running and a value per opened event
+    unsigned long long buffer[3 + events];
+    const ssize_t size = (3 + d_opened) * sizeof(unsigned long long);
+    if (::read(d_fd[cycles], buffer, size) != size) return false;
+    enabled_ns = buffer[1];
+    running_ns = buffer[2];
+    for (unsigned int event = 0; event < events; event++)
+        {
+            values[event] = d_fd[event] >= 0 ? buffer[3 + d_index[event]] : 0;
+        }
+    return true;
+#else
+    (void)values;
+    (void)enabled_ns;
+    (void)running_ns;
+    return false;
+#endif
+}
+
+
+void Gnss_Sdr_Hw_Counters::start()
+{
+    if (d_failed) return;
+    if (d_opened > 0 && d_thread != std::this_thread::get_id())
+        {
+            // the counters only count the thread that opened them
+            close();
+        }
+    if (d_opened == 0)
+        {
+            if (!open())
+                {
+                    close();
+                    d_failed = true;
+                    return;
+                }
+            d_available = true;
+        }
+    d_started = read(d_start, d_start_enabled_ns, d_start_running_ns);
+}
+
+
+void Gnss_Sdr_Hw_Counters::stop()
+{
+    if (!d_started) return;
+    d_started = false;
+    unsigned long long values[events];
+    unsigned long long enabled_ns;
+    unsigned long long running_ns;
+    if (!read(values, enabled_ns, running_ns)) return;
+    const unsigned long long delta_enabled = enabled_ns - d_start_enabled_ns;
+    const unsigned long long delta_running = running_ns - d_start_running_ns;
+    // nothing counted if the group was not scheduled during the call
+    if (delta_running == 0) return;
+    const double scale = static_cast<double>(delta_enabled) / static_cast<double>(delta_running);
+    for (unsigned int event = 0; event < events; event++)
+        {
+            const unsigned long long delta = static_cast<unsigned long long>(static_cast<double>(values[event] - d_start[event]) * scale);
+            d_counts[event].store(d_counts[event].load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        }
+    d_calls.store(d_calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+
+void Gnss_Sdr_Hw_Counter_Registry::enable(bool enabled)
+{
+    d_enabled = enabled;
+}
+
+
+std::shared_ptr<Gnss_Sdr_Hw_Counters> Gnss_Sdr_Hw_Counter_Registry::counters(const std::string & block)
+{
+    if (!enabled()) return std::shared_ptr<Gnss_Sdr_Hw_Counters>();
+    std::shared_ptr<Gnss_Sdr_Hw_Counters> counters = std::make_shared<Gnss_Sdr_Hw_Counters>();
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_counters.insert(std::make_pair(block, counters));
+    return counters;
+}
+
+
+std::vector<Gnss_Sdr_Hw_Counter_Registry::Block_Counters> Gnss_Sdr_Hw_Counter_Registry::totals()
+{
+    std::vector<Block_Counters> all;
+    std::lock_guard<std::mutex> lock(d_mutex);
+    typedef std::multimap<std::string, std::shared_ptr<Gnss_Sdr_Hw_Counters> >::const_iterator iterator;
+    for (iterator it = d_counters.begin(); it != d_counters.end(); ++it)
+        {
+            if (all.empty() || all.back().block != it->first)
+                {
+                    Block_Counters block;
+                    block.block = it->first;
+                    block.calls = 0;
+                    for (unsigned int event = 0; event < Gnss_Sdr_Hw_Counters::events; event++) block.counts[event] = 0;
+                    block.available = false;
+                    all.push_back(block);
+                }
+            Block_Counters & block = all.back();
+            block.calls += it->second->calls();
+            for (unsigned int event = 0; event < Gnss_Sdr_Hw_Counters::events; event++)
+                {
+                    block.counts[event] += it->second->count(event);
+                }
+            block.available = block.available || it->second->available();
+        }
+    return all;
+}
+
+
+std::vector<std::string> Gnss_Sdr_Hw_Counter_Registry::summary()
+{
+    const std::vector<Block_Counters> all = totals();
+    std::vector<std::string> lines;
+    for (unsigned int i = 0; i < all.size(); i++)
+        {
+            if (!all[i].available || all[i].calls == 0) continue;
+            const double calls = static_cast<double>(all[i].calls);
+            const double cycles = static_cast<double>(all[i].counts[Gnss_Sdr_Hw_Counters::cycles]);
+            const double instructions = static_cast<double>(all[i].counts[Gnss_Sdr_Hw_Counters::instructions]);
+            const double kilo_instructions = instructions > 0.0 ? instructions / 1000.0 : 1.0;
+            char line[256];
+            snprintf(line, sizeof(line), "%s: %.0f cycles per call, %.2f instructions per cycle, "
+                    "%.2f cache misses and %.2f branch misses per 1000 instructions",
+                    all[i].block.c_str(), cycles / calls, cycles > 0.0 ? instructions / cycles : 0.0,
+                    all[i].counts[Gnss_Sdr_Hw_Counters::cache_misses] / kilo_instructions,
+                    all[i].counts[Gnss_Sdr_Hw_Counters::branch_misses] / kilo_instructions);
+            lines.push_back(line);
+        }
+    return lines;
+}
+
+
+std::string Gnss_Sdr_Hw_Counter_Registry::prometheus_text()
+{
+    const std::vector<Block_Counters> all = totals();
+    std::ostringstream text;
+    text << "# HELP gnss_sdr_block_hw_events_total Hardware events counted in the work of the blocks\n";
+    text << "# TYPE gnss_sdr_block_hw_events_total counter\n";
+    for (unsigned int i = 0; i < all.size(); i++)
+        {
+            if (!all[i].available) continue;
+            for (unsigned int event = 0; event < Gnss_Sdr_Hw_Counters::events; event++)
+                {
+                    text << "gnss_sdr_block_hw_events_total{block=\"" << all[i].block << "\",event=\""
+                         << Gnss_Sdr_Hw_Counters::event_name(event) << "\"} " << all[i].counts[event] << "\n";
+                }
+        }
+    text << "# HELP gnss_sdr_block_hw_calls_total Calls to the work of the blocks with hardware counters\n";
+    text << "# TYPE gnss_sdr_block_hw_calls_total counter\n";
+    for (unsigned int i = 0; i < all.size(); i++)
+        {
+            if (!all[i].available) continue;
+            text << "gnss_sdr_block_hw_calls_total{block=\"" << all[i].block << "\"} " << all[i].calls << "\n";
+        }
+    return text.str();
+}
+
+
+void Gnss_Sdr_Hw_Counter_Registry::reset()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_counters.clear();
+}
@@ -0,0 +1,160 @@
+/*!
+ * \file gnss_sdr_hw_counters.h
+ * \brief Hardware performance counters of the work of the blocks
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Wall time does not tell whether a block waits for memory or for its
+ * arithmetic. The cycles, instructions, cache misses and branch misses of
+ * the thread that runs the block, read with perf_event_open(2) around its
+ * work, do: a low number of instructions per cycle with many cache misses
+ * per instruction points to the memory layout, a high one to the kernels.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_HW_COUNTERS_H_
+#define GNSS_SDR_GNSS_SDR_HW_COUNTERS_H_
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*!
+ * \brief Counters of one block, written by the thread that runs it
+ *
+ * The events are opened as a group, so that they count over the same
+ * instructions, for the thread that calls start() the first time. They are
+ * read at start() and stop(), and only the differences are accumulated, so
+ * the counters never have to be enabled or disabled. When the kernel
+ * multiplexes the group, the differences are scaled by the share of time
+ * it was scheduled.
+ */
+class Gnss_Sdr_Hw_Counters
+{
+public:
+    enum Event
+    {
+        cycles = 0,
+        instructions,
+        cache_misses,   // last level cache
+        branch_misses
+    };
+    static const unsigned int events = 4;
+
+    static const char * event_name(unsigned int event);
+
+    Gnss_Sdr_Hw_Counters();
+    ~Gnss_Sdr_Hw_Counters();
+
+    void start();
+    void stop();
+
+    //! False if the counters could not be opened, e.g. without PMU access
+    bool available() const
+    {
+        return d_available.load(std::memory_order_relaxed);
+    }
+
+    unsigned long long count(unsigned int event) const
+    {
+        return d_counts[event].load(std::memory_order_relaxed);
+    }
+
+    unsigned long long calls() const
+    {
+        return d_calls.load(std::memory_order_relaxed);
+    }
+
+private:
+    bool open();
+    void close();
+    bool read(unsigned long long * values, unsigned long long & enabled_ns, unsigned long long & running_ns);
+
+    int d_fd[events];          // -1 for the events the kernel refused
+    unsigned int d_index[events];  // position of each event in a read of the group
+    unsigned int d_opened;
+    bool d_failed;
+    std::thread::id d_thread;
+    unsigned long long d_start[events];
+    unsigned long long d_start_enabled_ns;
+    unsigned long long d_start_running_ns;
+    bool d_started;
+
+    std::atomic<bool> d_available;
+    std::atomic<unsigned long long> d_counts[events];
+    std::atomic<unsigned long long> d_calls;
+};
+
+
+/*!
+ * \brief Registry of the hardware counters of the blocks, by block name
+ *
+ * Nothing is measured unless enable() is called before the blocks are
+ * created. All the methods are thread-safe.
+ */
+class Gnss_Sdr_Hw_Counter_Registry
+{
+public:
+    struct Block_Counters
+    {
+        std::string block;
+        unsigned long long calls;
+        unsigned long long counts[Gnss_Sdr_Hw_Counters::events];
+        bool available;
+    };
+
+    static void enable(bool enabled);
+
+    static bool enabled()
+    {
+        return d_enabled.load(std::memory_order_relaxed);
+    }
+
+    //! New counters of a block called \p block, or null if the registry is not enabled
+    static std::shared_ptr<Gnss_Sdr_Hw_Counters> counters(const std::string & block);
+
+    //! Sums of the counters of the blocks of each name
+    static std::vector<Block_Counters> totals();
+
+    //! One line per block name, for the log
+    static std::vector<std::string> summary();
+
+    //! The counters in the Prometheus text format
+    static std::string prometheus_text();
+
+    //! Forgets all the counters
+    static void reset();
+
+private:
+    static std::atomic<bool> d_enabled;
+    static std::mutex d_mutex;
+    static std::multimap<std::string, std::shared_ptr<Gnss_Sdr_Hw_Counters> > d_counters;
+};
+
+#endif /*GNSS_SDR_GNSS_SDR_HW_COUNTERS_H_*/
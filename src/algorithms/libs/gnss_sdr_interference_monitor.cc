@@ -0,0 +1,84 @@
+/*!
+ * \file gnss_sdr_interference_monitor.cc
+ * \brief Counters of the interference mitigation blocks, for the metrics server.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_interference_monitor.h"
+#include <sstream>
+
+
+std::mutex Gnss_Sdr_Interference_Monitor::d_mutex;
+std::map<std::string, std::shared_ptr<Gnss_Sdr_Interference_Counters>> Gnss_Sdr_Interference_Monitor::d_counters;
+
+
+std::shared_ptr<Gnss_Sdr_Interference_Counters> Gnss_Sdr_Interference_Monitor::counters(const std::string & role)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    std::shared_ptr<Gnss_Sdr_Interference_Counters> & entry = d_counters[role];
+    if (!entry)
+        {
+            entry = std::make_shared<Gnss_Sdr_Interference_Counters>();
+        }
+    return entry;
+}
+
+
+std::string Gnss_Sdr_Interference_Monitor::prometheus_text()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    if (d_counters.empty()) return std::string("");
+    std::ostringstream samples, blanked, ratio, pulses, noise, freq, depth;
+    samples << "# HELP gnss_sdr_mitigation_samples_total Samples through the interference mitigation block\n"
+            << "# TYPE gnss_sdr_mitigation_samples_total counter\n";
+    blanked << "# HELP gnss_sdr_mitigation_blanked_samples_total Samples zeroed by the pulse blanker\n"
+            << "# TYPE gnss_sdr_mitigation_blanked_samples_total counter\n";
+    ratio << "# HELP gnss_sdr_mitigation_blanked_ratio Share of the samples zeroed by the pulse blanker\n"
+          << "# TYPE gnss_sdr_mitigation_blanked_ratio gauge\n";
+    pulses << "# HELP gnss_sdr_mitigation_pulses_total Pulses blanked\n"
+           << "# TYPE gnss_sdr_mitigation_pulses_total counter\n";
+    noise << "# HELP gnss_sdr_mitigation_noise_power Mean power of the samples that are not blanked\n"
+          << "# TYPE gnss_sdr_mitigation_noise_power gauge\n";
+    freq << "# HELP gnss_sdr_mitigation_notch_frequency_hz Frequency of the adaptive notch [Hz]\n"
+         << "# TYPE gnss_sdr_mitigation_notch_frequency_hz gauge\n";
+    depth << "# HELP gnss_sdr_mitigation_notch_depth Magnitude of the zero of the adaptive notch\n"
+          << "# TYPE gnss_sdr_mitigation_notch_depth gauge\n";
+    for (std::map<std::string, std::shared_ptr<Gnss_Sdr_Interference_Counters>>::const_iterator it = d_counters.begin(); it != d_counters.end(); ++it)
+        {
+            const std::string label = "{role=\"" + it->first + "\"} ";
+            const Gnss_Sdr_Interference_Counters & c = *it->second;
+            const unsigned long long n = c.samples();
+            samples << "gnss_sdr_mitigation_samples_total" << label << n << "\n";
+            blanked << "gnss_sdr_mitigation_blanked_samples_total" << label << c.blanked_samples() << "\n";
+            ratio << "gnss_sdr_mitigation_blanked_ratio" << label << (n > 0 ? static_cast<double>(c.blanked_samples()) / static_cast<double>(n) : 0.0) << "\n";
+            pulses << "gnss_sdr_mitigation_pulses_total" << label << c.pulses() << "\n";
+            noise << "gnss_sdr_mitigation_noise_power" << label << c.noise_power() << "\n";
+            freq << "gnss_sdr_mitigation_notch_frequency_hz" << label << c.notch_freq_hz() << "\n";
+            depth << "gnss_sdr_mitigation_notch_depth" << label << c.notch_depth() << "\n";
+        }
+    return samples.str() + blanked.str() + ratio.str() + pulses.str() + noise.str() + freq.str() + depth.str();
+}
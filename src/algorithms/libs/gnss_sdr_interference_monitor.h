@@ -0,0 +1,94 @@
+/*!
+ * \file gnss_sdr_interference_monitor.h
+ * \brief Counters of the interference mitigation blocks, for the metrics server.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_INTERFERENCE_MONITOR_H_
+#define GNSS_SDR_GNSS_SDR_INTERFERENCE_MONITOR_H_
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/*!
+ * \brief Counters of one mitigation block, written by that block only
+ */
+class Gnss_Sdr_Interference_Counters
+{
+public:
+    Gnss_Sdr_Interference_Counters() : d_samples(0), d_blanked(0), d_pulses(0), d_noise_power(0.0), d_notch_freq_hz(0.0), d_notch_depth(0.0) {}
+
+    void set(unsigned long long samples, unsigned long long blanked, unsigned long long pulses,
+            double noise_power, double notch_freq_hz, double notch_depth)
+    {
+        d_samples.store(samples, std::memory_order_relaxed);
+        d_blanked.store(blanked, std::memory_order_relaxed);
+        d_pulses.store(pulses, std::memory_order_relaxed);
+        d_noise_power.store(noise_power, std::memory_order_relaxed);
+        d_notch_freq_hz.store(notch_freq_hz, std::memory_order_relaxed);
+        d_notch_depth.store(notch_depth, std::memory_order_relaxed);
+    }
+
+    unsigned long long samples() const { return d_samples.load(std::memory_order_relaxed); }
+    unsigned long long blanked_samples() const { return d_blanked.load(std::memory_order_relaxed); }
+    unsigned long long pulses() const { return d_pulses.load(std::memory_order_relaxed); }
+    double noise_power() const { return d_noise_power.load(std::memory_order_relaxed); }
+    double notch_freq_hz() const { return d_notch_freq_hz.load(std::memory_order_relaxed); }
+    //! Magnitude of the notch zero, near 1 when a tone is being removed
+    double notch_depth() const { return d_notch_depth.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<unsigned long long> d_samples;
+    std::atomic<unsigned long long> d_blanked;
+    std::atomic<unsigned long long> d_pulses;
+    std::atomic<double> d_noise_power;
+    std::atomic<double> d_notch_freq_hz;
+    std::atomic<double> d_notch_depth;
+};
+
+
+/*!
+ * \brief Registry of the counters of the mitigation blocks, by role
+ */
+class Gnss_Sdr_Interference_Monitor
+{
+public:
+    //! The counters of \p role, created at the first call
+    static std::shared_ptr<Gnss_Sdr_Interference_Counters> counters(const std::string & role);
+
+    //! Counters of all the blocks in the Prometheus text format, empty if there is none
+    static std::string prometheus_text();
+
+private:
+    static std::mutex d_mutex;
+    static std::map<std::string, std::shared_ptr<Gnss_Sdr_Interference_Counters>> d_counters;
+};
+
+#endif /*GNSS_SDR_GNSS_SDR_INTERFERENCE_MONITOR_H_*/
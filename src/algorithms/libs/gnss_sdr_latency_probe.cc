@@ -0,0 +1,69 @@
+/*!
+ * \file gnss_sdr_latency_probe.cc
+ * \brief Sink that reports the signal time of the samples that reach it.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_latency_probe.h"
+#include <gnuradio/io_signature.h>
+#include "gnss_sdr_latency_tracer.h"
+#include "gnss_sdr_trace.h"
+
+
+gnss_sdr_latency_probe_sptr gnss_sdr_make_latency_probe(size_t sizeof_stream_item,
+        double sample_rate, const std::string & stage)
+{
+    return gnss_sdr_latency_probe_sptr(new gnss_sdr_latency_probe(sizeof_stream_item, sample_rate, stage));
+}
+
+
+gnss_sdr_latency_probe::gnss_sdr_latency_probe(size_t sizeof_stream_item,
+        double sample_rate, const std::string & stage) :
+        gr::sync_block("latency_probe",
+                gr::io_signature::make(1, 1, sizeof_stream_item),
+                gr::io_signature::make(0, 0, 0)),
+        d_sample_rate(sample_rate), d_stage(stage)
+{}
+
+
+int gnss_sdr_latency_probe::work(int noutput_items,
+        gr_vector_const_void_star &input_items __attribute__((unused)),
+        gr_vector_void_star &output_items __attribute__((unused)))
+{
+    GNSS_SDR_TRACE_SCOPE("gnss_sdr_latency_probe::work");
+    // the last sample of the call, the one that makes it complete
+    const double signal_time_s = static_cast<double>(nitems_read(0) + noutput_items) / d_sample_rate;
+    if (d_stage.empty())
+        {
+            Gnss_Sdr_Latency_Tracer::arrival(signal_time_s);
+        }
+    else
+        {
+            Gnss_Sdr_Latency_Tracer::record(d_stage.c_str(), signal_time_s);
+        }
+    return noutput_items;
+}
@@ -0,0 +1,69 @@
+/*!
+ * \file gnss_sdr_latency_probe.h
+ * \brief Sink that reports the signal time of the samples that reach it.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Connected beside the receiver to an output of the signal source, the
+ * probe marks the arrival of the samples for Gnss_Sdr_Latency_Tracer; to an
+ * output of a signal conditioner, it records the latency of the
+ * conditioner. The signal time is the number of samples over the sample
+ * rate of the output.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_LATENCY_PROBE_H_
+#define GNSS_SDR_GNSS_SDR_LATENCY_PROBE_H_
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include <gnuradio/sync_block.h>
+
+class gnss_sdr_latency_probe;
+typedef boost::shared_ptr<gnss_sdr_latency_probe> gnss_sdr_latency_probe_sptr;
+
+/*!
+ * \brief Makes a probe of a stream of \p sample_rate samples per second,
+ * that records the latency of \p stage, or the arrivals if it is empty
+ */
+gnss_sdr_latency_probe_sptr gnss_sdr_make_latency_probe(size_t sizeof_stream_item,
+        double sample_rate, const std::string & stage);
+
+class gnss_sdr_latency_probe : public gr::sync_block
+{
+    friend gnss_sdr_latency_probe_sptr gnss_sdr_make_latency_probe(size_t sizeof_stream_item,
+            double sample_rate, const std::string & stage);
+    gnss_sdr_latency_probe(size_t sizeof_stream_item, double sample_rate, const std::string & stage);
+
+    double d_sample_rate;
+    std::string d_stage;
+
+public:
+    int work(int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif /*GNSS_SDR_GNSS_SDR_LATENCY_PROBE_H_*/
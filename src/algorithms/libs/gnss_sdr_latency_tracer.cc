@@ -0,0 +1,166 @@
+/*!
+ * \file gnss_sdr_latency_tracer.cc
+ * \brief Delay from the arrival of the samples to the output of each stage.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_latency_tracer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+
+
+const unsigned int Gnss_Sdr_Latency_Tracer::latency_window;
+std::atomic<bool> Gnss_Sdr_Latency_Tracer::d_enabled(false);
+std::mutex Gnss_Sdr_Latency_Tracer::d_mutex;
+// one per call to the work of the probe, several seconds of signal
+ring_buffer<Gnss_Sdr_Latency_Tracer::Arrival> Gnss_Sdr_Latency_Tracer::d_arrivals(16384);
+std::vector<Gnss_Sdr_Latency_Tracer::Stage> Gnss_Sdr_Latency_Tracer::d_stages;
+
+
+double Gnss_Sdr_Latency_Tracer::wall_time_s()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+void Gnss_Sdr_Latency_Tracer::enable(bool enabled)
+{
+    d_enabled = enabled;
+}
+
+
+void Gnss_Sdr_Latency_Tracer::arrival(double signal_time_s)
+{
+    if (!enabled()) return;
+    Arrival arrival;
+    arrival.signal_time_s = signal_time_s;
+    arrival.wall_time_s = wall_time_s();
+    std::lock_guard<std::mutex> lock(d_mutex);
+    if (!d_arrivals.empty() && d_arrivals.back().signal_time_s >= signal_time_s) return;
+    d_arrivals.push_back(arrival);
+}
+
+
+void Gnss_Sdr_Latency_Tracer::record(const char * stage, double signal_time_s)
+{
+    if (!enabled()) return;
+    const double now_s = wall_time_s();
+    std::lock_guard<std::mutex> lock(d_mutex);
+    // the first arrival that holds the signal time, by bisection
+    unsigned int first = 0;
+    unsigned int last = d_arrivals.size();
+    while (first < last)
+        {
+            const unsigned int middle = first + (last - first) / 2;
+            if (d_arrivals[middle].signal_time_s < signal_time_s) first = middle + 1;
+            else last = middle;
+        }
+    // not arrived yet, or older than the arrivals kept
+    if (first == d_arrivals.size() || (first == 0 && d_arrivals.full())) return;
+
+    std::vector<Stage>::iterator it = d_stages.begin();
+    while (it != d_stages.end() && it->name != stage) ++it;
+    if (it == d_stages.end())
+        {
+            Stage new_stage;
+            new_stage.name = stage;
+            new_stage.count = 0;
+            new_stage.latencies_s.set_capacity(latency_window);
+            it = d_stages.insert(d_stages.end(), new_stage);
+        }
+    it->count++;
+    it->latencies_s.push_back(now_s - d_arrivals[first].wall_time_s);
+}
+
+
+std::vector<Gnss_Sdr_Latency_Tracer::Stage_Latency> Gnss_Sdr_Latency_Tracer::latencies()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    std::vector<Stage_Latency> result;
+    for (unsigned int i = 0; i < d_stages.size(); i++)
+        {
+            const Stage & stage = d_stages[i];
+            std::vector<double> sorted(stage.latencies_s.size());
+            if (sorted.empty()) continue;
+            stage.latencies_s.copy_to(&sorted[0]);
+            std::sort(sorted.begin(), sorted.end());
+            // nearest rank
+            const unsigned int n = sorted.size();
+            Stage_Latency latency;
+            latency.stage = stage.name;
+            latency.count = stage.count;
+            latency.p50_ms = 1e3 * sorted[std::min(n - 1, (n * 50 + 99) / 100 - 1)];
+            latency.p90_ms = 1e3 * sorted[std::min(n - 1, (n * 90 + 99) / 100 - 1)];
+            latency.p99_ms = 1e3 * sorted[std::min(n - 1, (n * 99 + 99) / 100 - 1)];
+            latency.max_ms = 1e3 * sorted[n - 1];
+            result.push_back(latency);
+        }
+    return result;
+}
+
+
+std::vector<std::string> Gnss_Sdr_Latency_Tracer::summary()
+{
+    const std::vector<Stage_Latency> all = latencies();
+    std::vector<std::string> lines;
+    for (unsigned int i = 0; i < all.size(); i++)
+        {
+            char line[256];
+            snprintf(line, sizeof(line), "%s: p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms",
+                    all[i].stage.c_str(), all[i].p50_ms, all[i].p90_ms, all[i].p99_ms, all[i].max_ms);
+            lines.push_back(line);
+        }
+    return lines;
+}
+
+
+std::string Gnss_Sdr_Latency_Tracer::prometheus_text()
+{
+    const std::vector<Stage_Latency> all = latencies();
+    std::ostringstream text;
+    text << "# HELP gnss_sdr_stage_latency_seconds Delay from the arrival of the samples to the output of the stage\n";
+    text << "# TYPE gnss_sdr_stage_latency_seconds summary\n";
+    for (unsigned int i = 0; i < all.size(); i++)
+        {
+            const std::string labels = "stage=\"" + all[i].stage + "\"";
+            text << "gnss_sdr_stage_latency_seconds{" << labels << ",quantile=\"0.5\"} " << all[i].p50_ms * 1e-3 << "\n";
+            text << "gnss_sdr_stage_latency_seconds{" << labels << ",quantile=\"0.9\"} " << all[i].p90_ms * 1e-3 << "\n";
+            text << "gnss_sdr_stage_latency_seconds{" << labels << ",quantile=\"0.99\"} " << all[i].p99_ms * 1e-3 << "\n";
+            text << "gnss_sdr_stage_latency_seconds_count{" << labels << "} " << all[i].count << "\n";
+        }
+    return text.str();
+}
+
+
+void Gnss_Sdr_Latency_Tracer::reset()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_arrivals.clear();
+    d_stages.clear();
+}
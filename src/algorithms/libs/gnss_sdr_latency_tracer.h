@@ -0,0 +1,117 @@
+/*!
+ * \file gnss_sdr_latency_tracer.h
+ * \brief Delay from the arrival of the samples to the output of each stage.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The samples are identified by their signal time, the seconds of signal
+ * since the start of the receiver, which every stage already knows: it is
+ * the Tracking_timestamp_secs of the Gnss_Synchro made from them, copied
+ * along by the telemetry decoders and the observables up to the PVT. A
+ * probe beside the signal source stores when the samples up to each signal
+ * time arrive, and each stage reports the signal time of what it delivers:
+ * the difference of their wall-clock times is the latency of the stage.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_LATENCY_TRACER_H_
+#define GNSS_SDR_GNSS_SDR_LATENCY_TRACER_H_
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ring_buffer.h"
+
+/*!
+ * \brief Latencies of the stages of the receiver, from the signal source on
+ *
+ * Nothing is stored unless enable() has been called, and then only for the
+ * last latency_window latencies of each stage, over which the percentiles
+ * are computed. All the methods are thread-safe.
+ */
+class Gnss_Sdr_Latency_Tracer
+{
+public:
+    static const unsigned int latency_window = 1024;
+
+    struct Stage_Latency
+    {
+        std::string stage;
+        unsigned long long count;  // since the start
+        double p50_ms;             // of the last latency_window
+        double p90_ms;
+        double p99_ms;
+        double max_ms;
+    };
+
+    static void enable(bool enabled);
+
+    static bool enabled()
+    {
+        return d_enabled.load(std::memory_order_relaxed);
+    }
+
+    //! The samples up to \p signal_time_s have just arrived
+    static void arrival(double signal_time_s);
+
+    //! \p stage has just delivered its output for the signal up to \p signal_time_s
+    static void record(const char * stage, double signal_time_s);
+
+    //! In the order of their first record, with at least one latency each
+    static std::vector<Stage_Latency> latencies();
+
+    //! One line per stage, for the log
+    static std::vector<std::string> summary();
+
+    //! The percentiles in the Prometheus text format, as a summary per stage
+    static std::string prometheus_text();
+
+    //! Forgets the arrivals and the latencies
+    static void reset();
+
+private:
+    struct Arrival
+    {
+        double signal_time_s;
+        double wall_time_s;
+    };
+
+    struct Stage
+    {
+        std::string name;
+        unsigned long long count;
+        ring_buffer<double> latencies_s;
+    };
+
+    static double wall_time_s();
+
+    static std::atomic<bool> d_enabled;
+    static std::mutex d_mutex;
+    static ring_buffer<Arrival> d_arrivals;
+    static std::vector<Stage> d_stages;
+};
+
+#endif /*GNSS_SDR_GNSS_SDR_LATENCY_TRACER_H_*/
@@ -0,0 +1,287 @@
+/*!
+ * \file gnss_sdr_memory_accounting.cc
+ * \brief Memory footprint of each block of the receiver
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_memory_accounting.h"
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <volk/volk.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+
+std::atomic<bool> Gnss_Sdr_Memory_Accounting::d_enabled(false);
+std::mutex Gnss_Sdr_Memory_Accounting::d_mutex;
+std::vector<Gnss_Sdr_Memory_Accounting::Owner_Memory> Gnss_Sdr_Memory_Accounting::d_owners;
+std::map<std::string, unsigned int> Gnss_Sdr_Memory_Accounting::d_owner_indices;
+std::unordered_map<void *, Gnss_Sdr_Memory_Accounting::Allocation> Gnss_Sdr_Memory_Accounting::d_allocations;
+
+namespace
+{
+// Owners of the scopes of the calling thread, the innermost last
+thread_local std::vector<std::string> scope_owners;
+
+std::string format_bytes(unsigned long long bytes)
+{
+    char text[32];
+    if (bytes >= 1024ULL * 1024ULL)
+        {
+            snprintf(text, sizeof(text), "%.1f MiB", bytes / (1024.0 * 1024.0));
+        }
+    else if (bytes >= 1024ULL)
+        {
+            snprintf(text, sizeof(text), "%.1f KiB", bytes / 1024.0);
+        }
+    else
+        {
+            snprintf(text, sizeof(text), "%llu B", bytes);
+        }
+    return text;
+}
+
+unsigned long long owner_total(const Gnss_Sdr_Memory_Accounting::Owner_Memory & owner)
+{
+    unsigned long long total = 0;
+    for (unsigned int kind = 0; kind < Gnss_Sdr_Memory_Accounting::kinds; kind++) total += owner.bytes[kind];
+    return total;
+}
+}
+
+
+Gnss_Sdr_Memory_Accounting::Scope::Scope(const std::string & owner)
+{
+    scope_owners.push_back(scope_owners.empty() ? owner : scope_owners.back() + "/" + owner);
+}
+
+
+Gnss_Sdr_Memory_Accounting::Scope::~Scope()
+{
+    scope_owners.pop_back();
+}
+
+
+void Gnss_Sdr_Memory_Accounting::enable(bool enabled)
+{
+    d_enabled.store(enabled);
+}
+
+
+std::string Gnss_Sdr_Memory_Accounting::current_owner()
+{
+    if (!scope_owners.empty()) return scope_owners.back();
+#ifdef __linux__
+    char name[16] = "";
+    pthread_getname_np(pthread_self(), name, sizeof(name));
+    if (name[0] != '\0') return name;
+#endif
+    return "unknown";
+}
+
+
+unsigned int Gnss_Sdr_Memory_Accounting::owner_index(const std::string & owner)
+{
+    std::map<std::string, unsigned int>::const_iterator it = d_owner_indices.find(owner);
+    if (it != d_owner_indices.end()) return it->second;
+    Owner_Memory memory;
+    memory.owner = owner;
+    std::fill(memory.bytes, memory.bytes + kinds, 0ULL);
+    memory.allocations = 0;
+    d_owners.push_back(memory);
+    const unsigned int index = d_owners.size() - 1;
+    d_owner_indices[owner] = index;
+    return index;
+}
+
+
+void Gnss_Sdr_Memory_Accounting::allocated(void * pointer, std::size_t bytes)
+{
+    if (!enabled() || pointer == nullptr) return;
+    const std::string owner = current_owner();
+    std::lock_guard<std::mutex> lock(d_mutex);
+    Allocation allocation;
+    allocation.owner = owner_index(owner);
+    allocation.bytes = bytes;
+    d_allocations[pointer] = allocation;
+    d_owners[allocation.owner].bytes[volk] += bytes;
+    d_owners[allocation.owner].allocations++;
+}
+
+
+void Gnss_Sdr_Memory_Accounting::freed(void * pointer)
+{
+    // the buffers allocated before the accounting was enabled are not found
+    if (!enabled() || pointer == nullptr) return;
+    std::lock_guard<std::mutex> lock(d_mutex);
+    std::unordered_map<void *, Allocation>::iterator it = d_allocations.find(pointer);
+    if (it == d_allocations.end()) return;
+    d_owners[it->second.owner].bytes[volk] -= it->second.bytes;
+    d_owners[it->second.owner].allocations--;
+    d_allocations.erase(it);
+}
+
+
+void Gnss_Sdr_Memory_Accounting::add_fft(unsigned int fft_size, unsigned int count)
+{
+    if (!enabled()) return;
+    const std::string owner = current_owner();
+    std::lock_guard<std::mutex> lock(d_mutex);
+    // gr::fft::fft_complex allocates an input and an output buffer
+    d_owners[owner_index(owner)].bytes[fft] += 2ULL * count * fft_size * 2 * sizeof(float);
+}
+
+
+void Gnss_Sdr_Memory_Accounting::set_buffers(const std::string & owner, unsigned long long bytes)
+{
+    if (!enabled()) return;
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_owners[owner_index(owner)].bytes[buffer] = bytes;
+}
+
+
+std::vector<Gnss_Sdr_Memory_Accounting::Owner_Memory> Gnss_Sdr_Memory_Accounting::owners()
+{
+    std::vector<Owner_Memory> all;
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        all = d_owners;
+    }
+    std::stable_sort(all.begin(), all.end(), [](const Owner_Memory & a, const Owner_Memory & b) { return owner_total(a) > owner_total(b); });
+    return all;
+}
+
+
+unsigned long long Gnss_Sdr_Memory_Accounting::total_bytes(Memory_Kind kind)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    unsigned long long total = 0;
+    for (unsigned int i = 0; i < d_owners.size(); i++) total += d_owners[i].bytes[kind];
+    return total;
+}
+
+
+std::vector<std::string> Gnss_Sdr_Memory_Accounting::summary()
+{
+    const std::vector<Owner_Memory> all = owners();
+    std::vector<std::string> lines;
+    unsigned long long totals[kinds] = {0, 0, 0};
+    for (unsigned int i = 0; i < all.size(); i++)
+        {
+            if (owner_total(all[i]) == 0) continue;
+            for (unsigned int kind = 0; kind < kinds; kind++) totals[kind] += all[i].bytes[kind];
+            std::ostringstream line;
+            line << all[i].owner << ": " << format_bytes(owner_total(all[i]))
+                 << " (aligned buffers " << format_bytes(all[i].bytes[volk]) << " in " << all[i].allocations
+                 << ", FFTs " << format_bytes(all[i].bytes[fft])
+                 << ", stream buffers " << format_bytes(all[i].bytes[buffer]) << ")";
+            lines.push_back(line.str());
+        }
+    std::ostringstream line;
+    line << "all the blocks: " << format_bytes(totals[volk] + totals[fft] + totals[buffer])
+         << " (aligned buffers " << format_bytes(totals[volk])
+         << ", FFTs " << format_bytes(totals[fft])
+         << ", stream buffers " << format_bytes(totals[buffer]) << ")";
+    lines.push_back(line.str());
+    return lines;
+}
+
+
+std::string Gnss_Sdr_Memory_Accounting::prometheus_text()
+{
+    static const char * kind_names[kinds] = {"volk", "fft", "buffer"};
+    const std::vector<Owner_Memory> all = owners();
+    std::ostringstream text;
+    text << "# HELP gnss_sdr_block_memory_bytes Memory accounted to the blocks\n";
+    text << "# TYPE gnss_sdr_block_memory_bytes gauge\n";
+    for (unsigned int i = 0; i < all.size(); i++)
+        {
+            for (unsigned int kind = 0; kind < kinds; kind++)
+                {
+                    text << "gnss_sdr_block_memory_bytes{block=\"" << all[i].owner << "\",kind=\""
+                         << kind_names[kind] << "\"} " << all[i].bytes[kind] << "\n";
+                }
+        }
+    return text.str();
+}
+
+
+void Gnss_Sdr_Memory_Accounting::reset()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_owners.clear();
+    d_owner_indices.clear();
+    d_allocations.clear();
+}
+
+
+void * gnss_sdr_volk_malloc(std::size_t size, std::size_t alignment)
+{
+    void * pointer = volk_malloc(size, alignment);
+    if (Gnss_Sdr_Memory_Accounting::enabled()) Gnss_Sdr_Memory_Accounting::allocated(pointer, size);
+    return pointer;
+}
+
+
+void gnss_sdr_volk_free(void * pointer)
+{
+    if (Gnss_Sdr_Memory_Accounting::enabled()) Gnss_Sdr_Memory_Accounting::freed(pointer);
+    volk_free(pointer);
+}
+
+
+void * gnss_sdr_volk_gnsssdr_malloc(std::size_t size, std::size_t alignment)
+{
+    void * pointer = volk_gnsssdr_malloc(size, alignment);
+    if (Gnss_Sdr_Memory_Accounting::enabled()) Gnss_Sdr_Memory_Accounting::allocated(pointer, size);
+    return pointer;
+}
+
+
+void gnss_sdr_volk_gnsssdr_free(void * pointer)
+{
+    if (Gnss_Sdr_Memory_Accounting::enabled()) Gnss_Sdr_Memory_Accounting::freed(pointer);
+    volk_gnsssdr_free(pointer);
+}
+
+
+void * gnss_sdr_volk_gnsssdr_malloc_huge(std::size_t size, std::size_t alignment)
+{
+    void * pointer = volk_gnsssdr_malloc_huge(size, alignment);
+    if (Gnss_Sdr_Memory_Accounting::enabled()) Gnss_Sdr_Memory_Accounting::allocated(pointer, size);
+    return pointer;
+}
+
+
+void gnss_sdr_volk_gnsssdr_free_huge(void * pointer)
+{
+    if (Gnss_Sdr_Memory_Accounting::enabled()) Gnss_Sdr_Memory_Accounting::freed(pointer);
+    volk_gnsssdr_free_huge(pointer);
+}
@@ -0,0 +1,149 @@
+/*!
+ * \file gnss_sdr_memory_accounting.h
+ * \brief Memory footprint of each block of the receiver
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The acquisition grids, the FFTs, the code replicas and the stream buffers
+ * of GNU Radio set how much memory a receiver needs, and they grow with the
+ * channels and the bands. The aligned buffers that the blocks take from
+ * VOLK and VOLK_GNSSSDR, the FFTs and the buffers that GNU Radio allocates
+ * for their outputs are accounted to the block that owns them:
+ * the one being created, or connected, by the flowgraph, and otherwise the
+ * block thread, named by GNU Radio after its block.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_MEMORY_ACCOUNTING_H_
+#define GNSS_SDR_GNSS_SDR_MEMORY_ACCOUNTING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*!
+ * \brief Bytes of the aligned buffers, FFTs and stream buffers of each block
+ */
+class Gnss_Sdr_Memory_Accounting
+{
+public:
+    enum Memory_Kind
+    {
+        volk = 0,    //!< Aligned buffers of volk_malloc and volk_gnsssdr_malloc
+        fft = 1,     //!< Input and output buffers of the FFTs
+        buffer = 2,  //!< Output buffers of the GNU Radio blocks
+        kinds = 3
+    };
+
+    struct Owner_Memory
+    {
+        std::string owner;
+        unsigned long long bytes[kinds];
+        unsigned long long allocations;  //!< VOLK buffers not freed yet
+    };
+
+    /*!
+     * \brief Accounts what is allocated while it exists to \p owner, within
+     * the owner of the enclosing scope, e.g. Channel3/Acquisition_1C
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(const std::string & owner);
+        ~Scope();
+
+    private:
+        Scope(const Scope &);
+        Scope & operator=(const Scope &);
+    };
+
+    static void enable(bool enabled);
+
+    static bool enabled()
+    {
+        return d_enabled.load(std::memory_order_relaxed);
+    }
+
+    //! The owner of the calling thread
+    static std::string current_owner();
+
+    //! Accounts the aligned buffer \p pointer of \p bytes, until it is freed
+    static void allocated(void * pointer, std::size_t bytes);
+    static void freed(void * pointer);
+
+    //! Accounts \p count FFTs of \p fft_size complex points to the current owner
+    static void add_fft(unsigned int fft_size, unsigned int count = 1);
+
+    //! Sets the bytes of the stream buffers of \p owner
+    static void set_buffers(const std::string & owner, unsigned long long bytes);
+
+    //! The owners, with the most memory first
+    static std::vector<Owner_Memory> owners();
+
+    static unsigned long long total_bytes(Memory_Kind kind);
+
+    //! One line per owner, and the totals, for the log
+    static std::vector<std::string> summary();
+
+    //! The bytes of each owner in the Prometheus text format
+    static std::string prometheus_text();
+
+    //! Forgets all the owners and buffers
+    static void reset();
+
+private:
+    struct Allocation
+    {
+        unsigned int owner;
+        std::size_t bytes;
+    };
+
+    static unsigned int owner_index(const std::string & owner);
+
+    static std::atomic<bool> d_enabled;
+    static std::mutex d_mutex;
+    static std::vector<Owner_Memory> d_owners;
+    static std::map<std::string, unsigned int> d_owner_indices;
+    static std::unordered_map<void *, Allocation> d_allocations;
+};
+
+
+/*
+ * volk_malloc, volk_gnsssdr_malloc, volk_gnsssdr_malloc_huge and their
+ * free functions, with the accounting of the buffers when it is enabled.
+ * A buffer must be freed by the function that matches its allocation.
+ */
+void * gnss_sdr_volk_malloc(std::size_t size, std::size_t alignment);
+void gnss_sdr_volk_free(void * pointer);
+void * gnss_sdr_volk_gnsssdr_malloc(std::size_t size, std::size_t alignment);
+void gnss_sdr_volk_gnsssdr_free(void * pointer);
+void * gnss_sdr_volk_gnsssdr_malloc_huge(std::size_t size, std::size_t alignment);
+void gnss_sdr_volk_gnsssdr_free_huge(void * pointer);
+
+#endif /*GNSS_SDR_GNSS_SDR_MEMORY_ACCOUNTING_H_*/
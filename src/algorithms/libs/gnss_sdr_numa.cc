@@ -0,0 +1,167 @@
+/*!
+ * \file gnss_sdr_numa.cc
+ * \brief NUMA nodes of the machine, and placement of the channels on them
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_numa.h"
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <boost/lexical_cast.hpp>
+#include <glog/logging.h>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using google::LogMessage;
+
+namespace
+{
+std::string read_line(const std::string & file_name)
+{
+    std::ifstream file(file_name.c_str());
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+}
+
+
+std::vector<int> Gnss_Sdr_Numa::parse_cpu_list(const std::string & list)
+{
+    std::vector<int> cores;
+    std::istringstream ranges(list);
+    std::string range;
+    while (std::getline(ranges, range, ','))
+        {
+            const size_t dash = range.find('-');
+            const int first = std::atoi(range.substr(0, dash).c_str());
+            const int last = dash == std::string::npos ? first : std::atoi(range.substr(dash + 1).c_str());
+            if (range.find_first_of("0123456789") == std::string::npos || first < 0 || last < first)
+                {
+                    continue;
+                }
+            for (int core = first; core <= last; core++)
+                {
+                    cores.push_back(core);
+                }
+        }
+    return cores;
+}
+
+
+unsigned int Gnss_Sdr_Numa::nodes()
+{
+    const std::vector<int> online = parse_cpu_list(read_line("/sys/devices/system/node/online"));
+    return online.empty() ? 1 : online.back() + 1;
+}
+
+
+std::vector<int> Gnss_Sdr_Numa::node_cores(unsigned int node)
+{
+    return parse_cpu_list(read_line("/sys/devices/system/node/node" + boost::lexical_cast<std::string>(node) + "/cpulist"));
+}
+
+
+std::string Gnss_Sdr_Numa::cpu_affinity(unsigned int node)
+{
+    const std::vector<int> cores = node_cores(node);
+    std::ostringstream affinity;
+    for (unsigned int i = 0; i < cores.size(); i++)
+        {
+            affinity << (i > 0 ? "," : "") << cores[i];
+        }
+    return affinity.str();
+}
+
+
+int Gnss_Sdr_Numa::channel_node(std::shared_ptr<ConfigurationInterface> configuration, unsigned int channel)
+{
+    const char* groups[4] = { "Channels_1C", "Channels_2S", "Channels_1B", "Channels_5X" };
+    int group_node = -1;
+    unsigned int first = 0;
+    for (unsigned int g = 0; g < 4; g++)
+        {
+            const unsigned int count = configuration->property(std::string(groups[g]) + ".count", 0u);
+            if (channel < first + count)
+                {
+                    group_node = configuration->property(std::string(groups[g]) + ".numa_node", -1);
+                    break;
+                }
+            first += count;
+        }
+    return configuration->property("Channel" + boost::lexical_cast<std::string>(channel) + ".numa_node", group_node);
+}
+
+
+void Gnss_Sdr_Numa::run_on_node(int node, const std::function<void()> & task)
+{
+    const std::vector<int> cores = node >= 0 ? node_cores(node) : std::vector<int>();
+#ifdef __linux__
+    if (!cores.empty())
+        {
+            std::exception_ptr error;
+            std::thread thread([&]()
+                    {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                for (unsigned int i = 0; i < cores.size(); i++)
+                    {
+                        CPU_SET(cores[i], &set);
+                    }
+                // the first touch of a page allocates it on the node of the core
+                if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+                    {
+                        LOG(WARNING) << "Cannot bind a thread to the cores of NUMA node " << node;
+                    }
+                try
+                {
+                        task();
+                }
+                catch (...)
+                {
+                        error = std::current_exception();
+                }
+                    });
+            thread.join();
+            if (error)
+                {
+                    std::rethrow_exception(error);
+                }
+            return;
+        }
+#endif
+    if (node >= 0)
+        {
+            LOG(WARNING) << "No cores for NUMA node " << node << ", the memory is not placed";
+        }
+    task();
+}
@@ -0,0 +1,81 @@
+/*!
+ * \file gnss_sdr_numa.h
+ * \brief NUMA nodes of the machine, and placement of the channels on them
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * On a machine with several sockets, a tracking thread that runs on one
+ * node and reads its samples, or its own buffers, from the memory of
+ * another one pays the interconnect at every access. A group of channels
+ * is placed on a node by creating its blocks on a thread bound to the
+ * cores of the node, so that Linux allocates the pages that their
+ * constructors first touch (the volk_gnsssdr_malloc buffers included) in
+ * the local memory, and by binding the threads of the blocks to the same
+ * cores. The nodes are read from sysfs, so no NUMA library is needed.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_NUMA_H_
+#define GNSS_SDR_GNSS_SDR_NUMA_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "configuration_interface.h"
+
+class Gnss_Sdr_Numa
+{
+public:
+    //! NUMA nodes of the machine, 1 if it has none or they are unknown
+    static unsigned int nodes();
+
+    //! Cores of \p node, empty if the node does not exist
+    static std::vector<int> node_cores(unsigned int node);
+
+    //! The cores of \p node as a cpu_affinity list, "0,1,2,3"
+    static std::string cpu_affinity(unsigned int node);
+
+    //! Parses a Linux list of cores, such as "0-3,8-11"
+    static std::vector<int> parse_cpu_list(const std::string & list);
+
+    /*!
+     * \brief Node of channel \p channel: Channel<i>.numa_node or, if absent,
+     * numa_node of its group (Channels_1C, Channels_2S, Channels_1B or
+     * Channels_5X, numbered in this order as by the block factory).
+     * Negative if the channel is not placed.
+     */
+    static int channel_node(std::shared_ptr<ConfigurationInterface> configuration, unsigned int channel);
+
+    /*!
+     * \brief Runs \p task on a thread bound to the cores of \p node, and
+     * waits for it. The exceptions of \p task are thrown again to the
+     * caller. If \p node is negative or has no cores, \p task runs on the
+     * calling thread.
+     */
+    static void run_on_node(int node, const std::function<void()> & task);
+};
+
+#endif /* GNSS_SDR_GNSS_SDR_NUMA_H_ */
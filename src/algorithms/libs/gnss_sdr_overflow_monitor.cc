@@ -0,0 +1,127 @@
+/*!
+ * \file gnss_sdr_overflow_monitor.cc
+ * \brief Sink that counts the samples lost by a radio front-end source.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_overflow_monitor.h"
+#include <vector>
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+#include "control_event_bus.h"
+#include "gnss_sdr_trace.h"
+
+using google::LogMessage;
+
+
+gnss_sdr_overflow_monitor_sptr gnss_sdr_make_overflow_monitor(size_t sizeof_stream_item,
+        double sample_rate, unsigned int rf_channel, gr::msg_queue::sptr queue)
+{
+    return gnss_sdr_overflow_monitor_sptr(new gnss_sdr_overflow_monitor(sizeof_stream_item,
+            sample_rate, rf_channel, queue));
+}
+
+
+gnss_sdr_overflow_monitor::gnss_sdr_overflow_monitor(size_t sizeof_stream_item,
+        double sample_rate, unsigned int rf_channel, gr::msg_queue::sptr queue) :
+        gr::sync_block("overflow_monitor",
+                gr::io_signature::make(1, 1, sizeof_stream_item),
+                gr::io_signature::make(0, 0, 0)),
+        d_sample_rate(sample_rate), d_rf_channel(rf_channel), d_queue(queue),
+        d_have_time(false), d_tag_offset(0), d_tag_seconds(0), d_tag_fraction(0.0),
+        d_overflows(0), d_lost_samples(0)
+{
+    message_port_register_out(pmt::mp("overflow"));
+}
+
+
+gnss_sdr_overflow_monitor::~gnss_sdr_overflow_monitor()
+{
+    if (d_overflows > 0)
+        {
+            LOG(WARNING) << "RF channel " << d_rf_channel << ": " << d_overflows
+                         << " overflows of the signal source, " << d_lost_samples << " samples lost";
+        }
+}
+
+
+void gnss_sdr_overflow_monitor::overflow(double rx_time, unsigned long long lost_samples)
+{
+    d_overflows++;
+    d_lost_samples += lost_samples;
+    if ((d_overflows & (d_overflows - 1)) == 0)
+        {
+            LOG(WARNING) << "RF channel " << d_rf_channel << ": " << d_overflows
+                         << " overflows of the signal source, " << d_lost_samples << " samples lost so far";
+        }
+
+    pmt::pmt_t msg = pmt::make_dict();
+    msg = pmt::dict_add(msg, pmt::mp("rf_channel"), pmt::from_long(d_rf_channel));
+    msg = pmt::dict_add(msg, pmt::mp("overflows"), pmt::from_uint64(d_overflows));
+    msg = pmt::dict_add(msg, pmt::mp("lost_samples"), pmt::from_uint64(d_lost_samples));
+    msg = pmt::dict_add(msg, pmt::mp("rx_time"), pmt::from_double(rx_time));
+    message_port_pub(pmt::mp("overflow"), msg);
+
+    Control_Event_Bus::send(d_queue, Control_Event_Bus::receiver, Control_Event_Bus::signal_source_overflow);
+}
+
+
+int gnss_sdr_overflow_monitor::work(int noutput_items,
+        gr_vector_const_void_star &input_items __attribute__((unused)),
+        gr_vector_void_star &output_items __attribute__((unused)))
+{
+    GNSS_SDR_TRACE_SCOPE("gnss_sdr_overflow_monitor::work");
+    std::vector<gr::tag_t> tags;
+    get_tags_in_range(tags, 0, nitems_read(0), nitems_read(0) + noutput_items, pmt::mp("rx_time"));
+    for (std::vector<gr::tag_t>::const_iterator tag = tags.begin(); tag != tags.end(); ++tag)
+        {
+            // (full seconds, fractional seconds), as in the UHD source
+            if (!pmt::is_tuple(tag->value) || pmt::length(tag->value) != 2)
+                {
+                    continue;
+                }
+            const unsigned long long seconds = pmt::to_uint64(pmt::tuple_ref(tag->value, 0));
+            const double fraction = pmt::to_double(pmt::tuple_ref(tag->value, 1));
+            if (d_have_time)
+                {
+                    // with the seconds apart, so that a sample is much longer than the resolution
+                    const double elapsed = static_cast<double>(seconds) - static_cast<double>(d_tag_seconds)
+                            + (fraction - d_tag_fraction);
+                    const double gap = elapsed * d_sample_rate - static_cast<double>(tag->offset - d_tag_offset);
+                    if (d_sample_rate <= 0.0 || gap >= 0.5)
+                        {
+                            overflow(static_cast<double>(seconds) + fraction,
+                                    d_sample_rate > 0.0 ? static_cast<unsigned long long>(gap + 0.5) : 0);
+                        }
+                }
+            d_have_time = true;
+            d_tag_offset = tag->offset;
+            d_tag_seconds = seconds;
+            d_tag_fraction = fraction;
+        }
+    return noutput_items;
+}
@@ -0,0 +1,102 @@
+/*!
+ * \file gnss_sdr_overflow_monitor.h
+ * \brief Sink that counts the samples lost by a radio front-end source.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * After an overflow, the UHD source (also when it is the backend of
+ * OsmoSDR) tags the next sample with its "rx_time". The monitor is
+ * connected to an output of the source, beside the receiver, and compares
+ * each time tag with the time expected from the number of samples since
+ * the previous one: a gap is an overflow, or packets lost on the way from
+ * the device. Each one is sent to the control thread, published on the
+ * "overflow" message port and logged.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_OVERFLOW_MONITOR_H_
+#define GNSS_SDR_GNSS_SDR_OVERFLOW_MONITOR_H_
+
+#include <boost/shared_ptr.hpp>
+#include <gnuradio/msg_queue.h>
+#include <gnuradio/sync_block.h>
+#include <pmt/pmt.h>
+
+class gnss_sdr_overflow_monitor;
+typedef boost::shared_ptr<gnss_sdr_overflow_monitor> gnss_sdr_overflow_monitor_sptr;
+
+/*!
+ * \brief Makes a monitor of the RF channel \p rf_channel of a source of
+ * \p sample_rate samples per second. The queue can be null.
+ */
+gnss_sdr_overflow_monitor_sptr gnss_sdr_make_overflow_monitor(size_t sizeof_stream_item,
+        double sample_rate, unsigned int rf_channel, gr::msg_queue::sptr queue);
+
+/*!
+ * \brief Implementation of a GNU Radio sink that counts the discontinuities
+ * of the "rx_time" tags of a source, and the samples lost in them.
+ *
+ * The message port "overflow" publishes a dictionary with the keys
+ * "rf_channel", "overflows", "lost_samples" and "rx_time" after each one.
+ */
+class gnss_sdr_overflow_monitor : public gr::sync_block
+{
+    friend gnss_sdr_overflow_monitor_sptr gnss_sdr_make_overflow_monitor(size_t sizeof_stream_item,
+            double sample_rate, unsigned int rf_channel, gr::msg_queue::sptr queue);
+    gnss_sdr_overflow_monitor(size_t sizeof_stream_item, double sample_rate,
+            unsigned int rf_channel, gr::msg_queue::sptr queue);
+
+    void overflow(double rx_time, unsigned long long lost_samples);
+
+    double d_sample_rate;
+    unsigned int d_rf_channel;
+    gr::msg_queue::sptr d_queue;
+    bool d_have_time;                 // a time tag has been seen
+    unsigned long long d_tag_offset;  // sample of the last time tag
+    unsigned long long d_tag_seconds; // and its time, full seconds
+    double d_tag_fraction;            // and fractional seconds
+    unsigned long long d_overflows;
+    unsigned long long d_lost_samples;
+
+public:
+    ~gnss_sdr_overflow_monitor();
+
+    unsigned long long overflows() const
+    {
+        return d_overflows;
+    }
+
+    //! Samples lost, estimated from the times of the tags
+    unsigned long long lost_samples() const
+    {
+        return d_lost_samples;
+    }
+
+    int work(int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif /*GNSS_SDR_GNSS_SDR_OVERFLOW_MONITOR_H_*/
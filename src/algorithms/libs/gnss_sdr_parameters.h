@@ -0,0 +1,74 @@
+/*!
+ * \file gnss_sdr_parameters.h
+ * \brief Reads the values of a parameter update sent to a block.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * When the configuration file changes while the receiver runs, the
+ * flowgraph posts the new values to the "parameters" message port of each
+ * block that registers one, as a dictionary from the name of the parameter,
+ * without the role, to its value as written in the file. The handlers run
+ * in the thread of the block, between two calls to its work function.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_PARAMETERS_H_
+#define GNSS_SDR_GNSS_SDR_PARAMETERS_H_
+
+#include <string>
+#include <boost/lexical_cast.hpp>
+#include <glog/logging.h>
+#include <pmt/pmt.h>
+
+/*!
+ * \brief Sets \p value to the parameter \p name of the update \p parameters.
+ * Returns false, leaving \p value as it was, if the update does not have
+ * it or the value is not valid.
+ */
+template <typename T>
+bool gnss_sdr_get_parameter(pmt::pmt_t parameters, const std::string & name, T & value)
+{
+    if (!pmt::is_dict(parameters))
+        {
+            return false;
+        }
+    pmt::pmt_t entry = pmt::dict_ref(parameters, pmt::mp(name), pmt::PMT_NIL);
+    if (!pmt::is_symbol(entry))
+        {
+            return false;
+        }
+    try
+    {
+            value = boost::lexical_cast<T>(pmt::symbol_to_string(entry));
+    }
+    catch (boost::bad_lexical_cast &)
+    {
+            LOG(WARNING) << "Wrong value of " << name << ": " << pmt::symbol_to_string(entry);
+            return false;
+    }
+    return true;
+}
+
+#endif /*GNSS_SDR_GNSS_SDR_PARAMETERS_H_*/
@@ -0,0 +1,129 @@
+/*!
+ * \file gnss_sdr_realtime_monitor.cc
+ * \brief Wall-clock cost of the signal tracked by each channel.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_realtime_monitor.h"
+#include <sstream>
+
+
+std::mutex Gnss_Sdr_Realtime_Monitor::d_mutex;
+std::atomic<bool> Gnss_Sdr_Realtime_Monitor::d_enabled(false);
+std::map<unsigned int, Gnss_Sdr_Realtime_Monitor::Entry> Gnss_Sdr_Realtime_Monitor::d_channels;
+std::vector<Gnss_Sdr_Realtime_Monitor::Channel_Load> Gnss_Sdr_Realtime_Monitor::d_loads;
+
+
+void Gnss_Sdr_Realtime_Monitor::enable(bool enabled)
+{
+    d_enabled = enabled;
+}
+
+
+bool Gnss_Sdr_Realtime_Monitor::enabled()
+{
+    return d_enabled;
+}
+
+
+std::shared_ptr<Gnss_Sdr_Channel_Cost> Gnss_Sdr_Realtime_Monitor::channel(unsigned int channel, double sample_rate)
+{
+    if (!d_enabled) return std::shared_ptr<Gnss_Sdr_Channel_Cost>();
+    std::lock_guard<std::mutex> lock(d_mutex);
+    Entry & entry = d_channels[channel];
+    if (!entry.cost || entry.cost->sample_rate() != sample_rate)
+        {
+            entry.cost = std::make_shared<Gnss_Sdr_Channel_Cost>(sample_rate);
+            entry.busy_ns = 0;
+            entry.samples = 0;
+        }
+    return entry.cost;
+}
+
+
+std::vector<Gnss_Sdr_Realtime_Monitor::Channel_Load> Gnss_Sdr_Realtime_Monitor::sample()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_loads.clear();
+    for (std::map<unsigned int, Entry>::iterator it = d_channels.begin(); it != d_channels.end(); ++it)
+        {
+            Entry & entry = it->second;
+            const unsigned long long busy_ns = entry.cost->busy_ns();
+            const unsigned long long samples = entry.cost->samples();
+            if (samples > entry.samples && entry.cost->sample_rate() > 0.0)
+                {
+                    const double signal_s = static_cast<double>(samples - entry.samples) / entry.cost->sample_rate();
+                    Channel_Load load;
+                    load.channel = it->first;
+                    load.realtime_factor = static_cast<double>(busy_ns - entry.busy_ns) * 1e-9 / signal_s;
+                    load.cn0_db_hz = entry.cost->cn0_db_hz();
+                    d_loads.push_back(load);
+                }
+            entry.busy_ns = busy_ns;
+            entry.samples = samples;
+        }
+    return d_loads;
+}
+
+
+std::vector<Gnss_Sdr_Realtime_Monitor::Channel_Load> Gnss_Sdr_Realtime_Monitor::loads()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_loads;
+}
+
+
+double Gnss_Sdr_Realtime_Monitor::receiver_load(const std::vector<Channel_Load> & loads, unsigned int cores)
+{
+    double total = 0.0;
+    for (unsigned int i = 0; i < loads.size(); i++)
+        {
+            total += loads[i].realtime_factor;
+        }
+    return total / static_cast<double>(cores > 0 ? cores : 1);
+}
+
+
+std::string Gnss_Sdr_Realtime_Monitor::prometheus_text(unsigned int cores)
+{
+    const std::vector<Channel_Load> all = loads();
+    std::ostringstream text;
+    text << "# HELP gnss_sdr_channel_realtime_factor Seconds of tracking per second of signal\n";
+    text << "# TYPE gnss_sdr_channel_realtime_factor gauge\n";
+    for (unsigned int i = 0; i < all.size(); i++)
+        {
+            text << "gnss_sdr_channel_realtime_factor{channel=\"" << all[i].channel << "\"} " << all[i].realtime_factor << "\n";
+        }
+    const double load = receiver_load(all, cores);
+    text << "# HELP gnss_sdr_receiver_realtime_factor Tracking load of the receiver, over the cores it uses\n";
+    text << "# TYPE gnss_sdr_receiver_realtime_factor gauge\n";
+    text << "gnss_sdr_receiver_realtime_factor " << load << "\n";
+    text << "# HELP gnss_sdr_receiver_realtime_margin One minus the tracking load of the receiver\n";
+    text << "# TYPE gnss_sdr_receiver_realtime_margin gauge\n";
+    text << "gnss_sdr_receiver_realtime_margin " << 1.0 - load << "\n";
+    return text.str();
+}
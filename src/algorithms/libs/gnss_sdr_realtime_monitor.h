@@ -0,0 +1,153 @@
+/*!
+ * \file gnss_sdr_realtime_monitor.h
+ * \brief Wall-clock cost of the signal tracked by each channel.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Each tracking block adds the time it spends in every code period, and
+ * the samples it spans, to the counters of its channel. Sampled at regular
+ * intervals, they give the real-time factor of the channel: the seconds of
+ * processing per second of signal. Their sum, shared among the cores that
+ * the receiver can use, is the load of the receiver, and one minus it is
+ * the real-time margin left before the signal source overflows.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_REALTIME_MONITOR_H_
+#define GNSS_SDR_GNSS_SDR_REALTIME_MONITOR_H_
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*!
+ * \brief Counters of a channel, written by its tracking block only
+ */
+class Gnss_Sdr_Channel_Cost
+{
+public:
+    explicit Gnss_Sdr_Channel_Cost(double sample_rate) : d_sample_rate(sample_rate), d_busy_ns(0), d_samples(0), d_cn0_db_hz(0.0) {}
+
+    //! Adds the processing of \p samples samples that started at \p start
+    void add(const std::chrono::steady_clock::time_point & start, unsigned int samples)
+    {
+        const long long busy_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        d_busy_ns.store(d_busy_ns.load(std::memory_order_relaxed) + busy_ns, std::memory_order_relaxed);
+        d_samples.store(d_samples.load(std::memory_order_relaxed) + samples, std::memory_order_relaxed);
+    }
+
+    double sample_rate() const
+    {
+        return d_sample_rate;
+    }
+
+    unsigned long long busy_ns() const
+    {
+        return d_busy_ns.load(std::memory_order_relaxed);
+    }
+
+    unsigned long long samples() const
+    {
+        return d_samples.load(std::memory_order_relaxed);
+    }
+
+    //! C/N0 of the signal tracked, at its last estimate [dB-Hz]
+    void set_cn0_db_hz(double cn0_db_hz)
+    {
+        d_cn0_db_hz.store(cn0_db_hz, std::memory_order_relaxed);
+    }
+
+    double cn0_db_hz() const
+    {
+        return d_cn0_db_hz.load(std::memory_order_relaxed);
+    }
+
+private:
+    double d_sample_rate;
+    std::atomic<unsigned long long> d_busy_ns;
+    std::atomic<unsigned long long> d_samples;
+    std::atomic<double> d_cn0_db_hz;
+};
+
+
+/*!
+ * \brief Registry of the costs of the channels, sampled by the control thread
+ *
+ * Nothing is measured unless enable() is called before the tracking blocks
+ * are given their channel.
+ */
+class Gnss_Sdr_Realtime_Monitor
+{
+public:
+    struct Channel_Load
+    {
+        unsigned int channel;
+        double realtime_factor;  // seconds of processing per second of signal
+        double cn0_db_hz;        // 0 if the tracking block does not estimate it
+    };
+
+    static void enable(bool enabled);
+    static bool enabled();
+
+    /*!
+     * \brief The counters of \p channel, created at the first call, or null
+     * if the monitor is not enabled
+     */
+    static std::shared_ptr<Gnss_Sdr_Channel_Cost> channel(unsigned int channel, double sample_rate);
+
+    /*!
+     * \brief Real-time factors of the channels that tracked signal since
+     * the previous call, which are also kept for loads()
+     */
+    static std::vector<Channel_Load> sample();
+
+    //! The result of the last call to sample()
+    static std::vector<Channel_Load> loads();
+
+    //! Sum of the real-time factors of \p loads over \p cores
+    static double receiver_load(const std::vector<Channel_Load> & loads, unsigned int cores);
+
+    //! The loads in the Prometheus text format, as Gnss_Block_Metrics does
+    static std::string prometheus_text(unsigned int cores);
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<Gnss_Sdr_Channel_Cost> cost;
+        unsigned long long busy_ns;  // at the previous sample
+        unsigned long long samples;
+    };
+
+    static std::mutex d_mutex;
+    static std::atomic<bool> d_enabled;
+    static std::map<unsigned int, Entry> d_channels;
+    static std::vector<Channel_Load> d_loads;
+};
+
+#endif /*GNSS_SDR_GNSS_SDR_REALTIME_MONITOR_H_*/
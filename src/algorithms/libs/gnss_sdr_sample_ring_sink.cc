@@ -0,0 +1,58 @@
+/*!
+ * \file gnss_sdr_sample_ring_sink.cc
+ * \brief GNU Radio block that writes its input to a Gnss_Sample_Ring
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_sample_ring_sink.h"
+#include "gnss_sdr_trace.h"
+#include <gnuradio/io_signature.h>
+#include <gnuradio/gr_complex.h>
+
+
+gnss_sdr_sample_ring_sink_sptr gnss_sdr_make_sample_ring_sink(std::shared_ptr<Gnss_Sample_Ring> ring)
+{
+    return gnss_sdr_sample_ring_sink_sptr(new gnss_sdr_sample_ring_sink(ring));
+}
+
+
+gnss_sdr_sample_ring_sink::gnss_sdr_sample_ring_sink(std::shared_ptr<Gnss_Sample_Ring> ring) :
+        gr::sync_block("sample_ring_sink",
+                gr::io_signature::make(1, 1, sizeof(gr_complex)),
+                gr::io_signature::make(0, 0, 0)),
+        d_ring(ring)
+{}
+
+
+int gnss_sdr_sample_ring_sink::work(int noutput_items,
+        gr_vector_const_void_star &input_items,
+        gr_vector_void_star &output_items __attribute__((unused)))
+{
+    GNSS_SDR_TRACE_SCOPE("gnss_sdr_sample_ring_sink::work");
+    d_ring->write(static_cast<const gr_complex*>(input_items[0]), noutput_items);
+    return noutput_items;
+}
@@ -0,0 +1,649 @@
+/*!
+ * \file gnss_sdr_task_pool.cc
+ * \brief Work-stealing pool of threads shared by the blocks of the receiver
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_task_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <glog/logging.h>
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+using google::LogMessage;
+
+namespace
+{
+typedef std::chrono::steady_clock task_clock;
+
+struct Task
+{
+    std::function<void()> function;
+    unsigned int id;
+    Gnss_Sdr_Task_Priority priority;
+    std::function<void(std::exception_ptr)> done;  // of the group of the task, if any
+    unsigned int owner;              // worker whose deque got the task
+    task_clock::time_point submitted;
+};
+
+struct Worker
+{
+    std::mutex mutex;
+    std::deque<Task> queues[2];      // by priority
+    std::thread thread;
+};
+
+struct Counters
+{
+    std::atomic<unsigned long long> submitted;
+    std::atomic<unsigned long long> completed;
+    std::atomic<unsigned long long> stolen;
+    std::atomic<unsigned long long> wait_ns;
+    std::atomic<unsigned long long> run_ns;
+    std::atomic<unsigned long long> max_run_ns;
+};
+
+// index of the worker running on this thread, -1 elsewhere
+thread_local int t_worker = -1;
+
+
+class Pool
+{
+public:
+    Pool();
+    ~Pool();
+
+    void configure(unsigned int threads, unsigned int background_threads, const std::vector<int> & cores);
+    void shutdown();
+    unsigned int threads();
+    unsigned int task_id(const std::string & name);
+    void submit(Task & task);
+    bool run_one(unsigned int self);
+    std::vector<Gnss_Sdr_Task_Pool::Task_Metrics> metrics();
+    void reset_metrics();
+
+private:
+    void start();
+    void stop();
+    void work(unsigned int self);
+    bool runnable() const;
+    bool take(unsigned int self, Gnss_Sdr_Task_Priority priority, Task & task);
+    void execute(Task & task, unsigned int self);
+
+    boost::shared_mutex d_lifecycle;  // shared by submit(), exclusive to start and stop the workers
+    bool d_running;
+    unsigned int d_threads_wanted;
+    unsigned int d_background_limit;
+    std::vector<int> d_cores;
+    std::vector<std::unique_ptr<Worker> > d_workers;
+    std::atomic<unsigned int> d_next;  // round robin of the tasks submitted from other threads
+
+    std::mutex d_sleep_mutex;
+    std::condition_variable d_wake;
+    bool d_stop;
+    std::atomic<unsigned int> d_queued[2];
+    std::atomic<unsigned int> d_background_running;
+
+    std::mutex d_names_mutex;
+    std::vector<std::string> d_names;
+    Counters d_counters[Gnss_Sdr_Task_Pool::max_task_ids];
+};
+
+
+Pool::Pool()
+{
+    d_running = false;
+    d_threads_wanted = 0;
+    d_background_limit = 1;
+    d_next = 0;
+    d_stop = false;
+    d_queued[0] = 0;
+    d_queued[1] = 0;
+    d_background_running = 0;
+    d_names.push_back("other");
+    reset_metrics();
+}
+
+
+Pool::~Pool()
+{
+    shutdown();
+}
+
+
+void Pool::configure(unsigned int threads, unsigned int background_threads, const std::vector<int> & cores)
+{
+    boost::unique_lock<boost::shared_mutex> lock(d_lifecycle);
+    if (threads == d_threads_wanted && std::max(background_threads, 1u) == d_background_limit && cores == d_cores)
+        {
+            // several receivers of the process may configure it alike
+            return;
+        }
+    stop();
+    d_threads_wanted = threads;
+    d_background_limit = std::max(background_threads, 1u);
+    d_cores = cores;
+}
+
+
+void Pool::shutdown()
+{
+    boost::unique_lock<boost::shared_mutex> lock(d_lifecycle);
+    stop();
+}
+
+
+unsigned int Pool::threads()
+{
+    boost::shared_lock<boost::shared_mutex> lock(d_lifecycle);
+    return d_workers.size();
+}
+
+
+void Pool::start()
+{
+    unsigned int threads = d_threads_wanted;
+    if (threads == 0)
+        {
+            threads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+    d_stop = false;
+    for (unsigned int i = 0; i < threads; i++)
+        {
+            d_workers.push_back(std::unique_ptr<Worker>(new Worker()));
+        }
+    for (unsigned int i = 0; i < threads; i++)
+        {
+            d_workers[i]->thread = std::thread(&Pool::work, this, i);
+        }
+    d_running = true;
+    LOG(INFO) << "Task pool started with " << threads << " workers, " << d_background_limit << " for background tasks";
+}
+
+
+void Pool::stop()
+{
+    if (!d_running) return;
+    {
+        std::lock_guard<std::mutex> lock(d_sleep_mutex);
+        d_stop = true;
+    }
+    d_wake.notify_all();
+    for (unsigned int i = 0; i < d_workers.size(); i++)
+        {
+            d_workers[i]->thread.join();
+        }
+    d_workers.clear();
+    d_running = false;
+}
+
+
+unsigned int Pool::task_id(const std::string & name)
+{
+    std::lock_guard<std::mutex> lock(d_names_mutex);
+    std::vector<std::string>::iterator it = std::find(d_names.begin(), d_names.end(), name);
+    if (it != d_names.end())
+        {
+            return it - d_names.begin();
+        }
+    if (d_names.size() == Gnss_Sdr_Task_Pool::max_task_ids)
+        {
+            LOG(WARNING) << "No room for the metrics of task " << name << ", counted as other";
+            return 0;
+        }
+    d_names.push_back(name);
+    return d_names.size() - 1;
+}
+
+
+void Pool::submit(Task & task)
+{
+    task.id = std::min(task.id, Gnss_Sdr_Task_Pool::max_task_ids - 1);
+    task.submitted = task_clock::now();
+    d_counters[task.id].submitted++;
+    for (;;)
+        {
+            {
+                boost::shared_lock<boost::shared_mutex> lock(d_lifecycle);
+                if (d_running)
+                    {
+                        // a worker keeps its own tasks, hot in its cache
+                        const unsigned int n = d_workers.size();
+                        task.owner = (t_worker >= 0 && static_cast<unsigned int>(t_worker) < n) ? t_worker : d_next.fetch_add(1) % n;
+                        const Gnss_Sdr_Task_Priority priority = task.priority;
+                        Worker & worker = *d_workers[task.owner];
+                        // counted first, so that the count never goes below zero
+                        d_queued[priority]++;
+                        {
+                            std::lock_guard<std::mutex> queue_lock(worker.mutex);
+                            worker.queues[priority].push_back(std::move(task));
+                        }
+                        {
+                            std::lock_guard<std::mutex> sleep_lock(d_sleep_mutex);
+                        }
+                        d_wake.notify_one();
+                        return;
+                    }
+            }
+            boost::unique_lock<boost::shared_mutex> lock(d_lifecycle);
+            if (!d_running) start();
+        }
+}
+
+
+bool Pool::runnable() const
+{
+    return d_queued[TASK_PRIORITY_REALTIME] > 0
+            || (d_queued[TASK_PRIORITY_BACKGROUND] > 0 && d_background_running < d_background_limit);
+}
+
+
+void Pool::work(unsigned int self)
+{
+    t_worker = self;
+#ifdef __linux__
+    if (!d_cores.empty())
+        {
+            const int core = d_cores[self % d_cores.size()];
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(core, &set);
+            if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+                {
+                    LOG(WARNING) << "Cannot bind task pool worker " << self << " to core " << core;
+                }
+        }
+#endif
+    for (;;)
+        {
+            if (run_one(self)) continue;
+            std::unique_lock<std::mutex> lock(d_sleep_mutex);
+            // the queued tasks are run before stopping
+            if (d_stop && d_queued[0] == 0 && d_queued[1] == 0) break;
+            d_wake.wait(lock, [this]() { return d_stop || runnable(); });
+        }
+    t_worker = -1;
+}
+
+
+bool Pool::take(unsigned int self, Gnss_Sdr_Task_Priority priority, Task & task)
+{
+    // the newest task of its own deque, else the oldest one of another worker
+    const unsigned int n = d_workers.size();
+    for (unsigned int k = 0; k < n; k++)
+        {
+            Worker & worker = *d_workers[(self + k) % n];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            std::deque<Task> & queue = worker.queues[priority];
+            if (queue.empty()) continue;
+            if (k == 0)
+                {
+                    task = std::move(queue.back());
+                    queue.pop_back();
+                }
+            else
+                {
+                    task = std::move(queue.front());
+                    queue.pop_front();
+                }
+            d_queued[priority]--;
+            return true;
+        }
+    return false;
+}
+
+
+bool Pool::run_one(unsigned int self)
+{
+    Task task;
+    if (d_queued[TASK_PRIORITY_REALTIME] > 0 && take(self, TASK_PRIORITY_REALTIME, task))
+        {
+            execute(task, self);
+            return true;
+        }
+    if (d_queued[TASK_PRIORITY_BACKGROUND] == 0) return false;
+    // background tasks may block on I/O, so they never hold all the workers
+    unsigned int running = d_background_running;
+    do
+        {
+            if (running >= d_background_limit) return false;
+        }
+    while (!d_background_running.compare_exchange_weak(running, running + 1));
+    const bool found = take(self, TASK_PRIORITY_BACKGROUND, task);
+    if (found)
+        {
+            execute(task, self);
+        }
+    d_background_running--;
+    if (found)
+        {
+            // a background task may wait for this slot
+            {
+                std::lock_guard<std::mutex> lock(d_sleep_mutex);
+            }
+            d_wake.notify_one();
+        }
+    return found;
+}
+
+
+void Pool::execute(Task & task, unsigned int self)
+{
+    Counters & counters = d_counters[task.id];
+    const task_clock::time_point start = task_clock::now();
+    std::exception_ptr error;
+    try
+    {
+            task.function();
+    }
+    catch (...)
+    {
+            error = std::current_exception();
+    }
+    const task_clock::time_point end = task_clock::now();
+    const unsigned long long run_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    counters.wait_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(start - task.submitted).count();
+    counters.run_ns += run_ns;
+    unsigned long long max_ns = counters.max_run_ns;
+    while (run_ns > max_ns && !counters.max_run_ns.compare_exchange_weak(max_ns, run_ns)) {}
+    if (task.owner != self) counters.stolen++;
+    counters.completed++;
+
+    if (task.done)
+        {
+            task.done(error);
+        }
+    else if (error)
+        {
+            try
+            {
+                    std::rethrow_exception(error);
+            }
+            catch (const std::exception & e)
+            {
+                    LOG(WARNING) << "Task " << task.id << " of the pool failed: " << e.what();
+            }
+            catch (...)
+            {
+                    LOG(WARNING) << "Task " << task.id << " of the pool failed";
+            }
+        }
+}
+
+
+std::vector<Gnss_Sdr_Task_Pool::Task_Metrics> Pool::metrics()
+{
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(d_names_mutex);
+        names = d_names;
+    }
+    std::vector<Gnss_Sdr_Task_Pool::Task_Metrics> result;
+    for (unsigned int i = 0; i < names.size(); i++)
+        {
+            const Counters & counters = d_counters[i];
+            Gnss_Sdr_Task_Pool::Task_Metrics metrics;
+            metrics.name = names[i];
+            metrics.submitted = counters.submitted;
+            metrics.completed = counters.completed;
+            metrics.stolen = counters.stolen;
+            if (metrics.submitted == 0) continue;
+            const double completed = std::max(metrics.completed, 1ULL);
+            metrics.mean_wait_ms = 1e-6 * counters.wait_ns / completed;
+            metrics.mean_run_ms = 1e-6 * counters.run_ns / completed;
+            metrics.max_run_ms = 1e-6 * counters.max_run_ns;
+            result.push_back(metrics);
+        }
+    return result;
+}
+
+
+void Pool::reset_metrics()
+{
+    for (unsigned int i = 0; i < Gnss_Sdr_Task_Pool::max_task_ids; i++)
+        {
+            d_counters[i].submitted = 0;
+            d_counters[i].completed = 0;
+            d_counters[i].stolen = 0;
+            d_counters[i].wait_ns = 0;
+            d_counters[i].run_ns = 0;
+            d_counters[i].max_run_ns = 0;
+        }
+}
+
+
+Pool & pool()
+{
+    static Pool the_pool;
+    return the_pool;
+}
+}
+
+
+const unsigned int Gnss_Sdr_Task_Pool::max_task_ids;
+
+
+void Gnss_Sdr_Task_Pool::configure(unsigned int threads, unsigned int background_threads, const std::vector<int> & cores)
+{
+    pool().configure(threads, background_threads, cores);
+}
+
+
+void Gnss_Sdr_Task_Pool::shutdown()
+{
+    pool().shutdown();
+}
+
+
+unsigned int Gnss_Sdr_Task_Pool::threads()
+{
+    return pool().threads();
+}
+
+
+bool Gnss_Sdr_Task_Pool::in_worker()
+{
+    return t_worker >= 0;
+}
+
+
+unsigned int Gnss_Sdr_Task_Pool::task_id(const std::string & name)
+{
+    return pool().task_id(name);
+}
+
+
+void Gnss_Sdr_Task_Pool::submit(unsigned int task_id, Gnss_Sdr_Task_Priority priority, const std::function<void()> & task)
+{
+    submit(task_id, priority, task, nullptr);
+}
+
+
+void Gnss_Sdr_Task_Pool::submit(unsigned int task_id, Gnss_Sdr_Task_Priority priority,
+        const std::function<void()> & task, Gnss_Sdr_Task_Group * group)
+{
+    Task queued;
+    queued.function = task;
+    queued.id = task_id;
+    queued.priority = priority;
+    if (group)
+        {
+            queued.done = [group](std::exception_ptr error) { group->done(error); };
+        }
+    queued.owner = 0;
+    pool().submit(queued);
+}
+
+
+bool Gnss_Sdr_Task_Pool::run_one()
+{
+    return t_worker >= 0 && pool().run_one(t_worker);
+}
+
+
+std::vector<Gnss_Sdr_Task_Pool::Task_Metrics> Gnss_Sdr_Task_Pool::metrics()
+{
+    return pool().metrics();
+}
+
+
+std::vector<std::string> Gnss_Sdr_Task_Pool::summary()
+{
+    const std::vector<Task_Metrics> all = metrics();
+    std::vector<std::string> lines;
+    for (unsigned int i = 0; i < all.size(); i++)
+        {
+            char line[256];
+            snprintf(line, sizeof(line), "%s: %llu tasks, %llu stolen, mean wait %.3f ms, mean run %.3f ms, max run %.3f ms",
+                    all[i].name.c_str(), all[i].completed, all[i].stolen, all[i].mean_wait_ms, all[i].mean_run_ms, all[i].max_run_ms);
+            lines.push_back(line);
+        }
+    return lines;
+}
+
+
+std::string Gnss_Sdr_Task_Pool::prometheus_text()
+{
+    const std::vector<Task_Metrics> all = metrics();
+    std::ostringstream text;
+    text << "# HELP gnss_sdr_task_pool_tasks_total Tasks run by the shared pool\n";
+    text << "# TYPE gnss_sdr_task_pool_tasks_total counter\n";
+    for (unsigned int i = 0; i < all.size(); i++)
+        {
+            text << "gnss_sdr_task_pool_tasks_total{task=\"" << all[i].name << "\"} " << all[i].completed << "\n";
+        }
+    text << "# HELP gnss_sdr_task_pool_stolen_total Tasks run by another worker than the one that got them\n";
+    text << "# TYPE gnss_sdr_task_pool_stolen_total counter\n";
+    for (unsigned int i = 0; i < all.size(); i++)
+        {
+            text << "gnss_sdr_task_pool_stolen_total{task=\"" << all[i].name << "\"} " << all[i].stolen << "\n";
+        }
+    text << "# HELP gnss_sdr_task_pool_run_seconds Mean and maximum run time of the tasks\n";
+    text << "# TYPE gnss_sdr_task_pool_run_seconds gauge\n";
+    for (unsigned int i = 0; i < all.size(); i++)
+        {
+            text << "gnss_sdr_task_pool_run_seconds{task=\"" << all[i].name << "\",stat=\"mean\"} " << all[i].mean_run_ms * 1e-3 << "\n";
+            text << "gnss_sdr_task_pool_run_seconds{task=\"" << all[i].name << "\",stat=\"max\"} " << all[i].max_run_ms * 1e-3 << "\n";
+        }
+    text << "# HELP gnss_sdr_task_pool_wait_seconds Mean time from the submission of the tasks to their start\n";
+    text << "# TYPE gnss_sdr_task_pool_wait_seconds gauge\n";
+    for (unsigned int i = 0; i < all.size(); i++)
+        {
+            text << "gnss_sdr_task_pool_wait_seconds{task=\"" << all[i].name << "\"} " << all[i].mean_wait_ms * 1e-3 << "\n";
+        }
+    return text.str();
+}
+
+
+void Gnss_Sdr_Task_Pool::reset_metrics()
+{
+    pool().reset_metrics();
+}
+
+
+Gnss_Sdr_Task_Group::Gnss_Sdr_Task_Group(unsigned int task_id, Gnss_Sdr_Task_Priority priority)
+{
+    d_task_id = task_id;
+    d_priority = priority;
+    d_pending = 0;
+}
+
+
+Gnss_Sdr_Task_Group::~Gnss_Sdr_Task_Group()
+{
+    try
+    {
+            wait();
+    }
+    catch (...)
+    {
+    }
+}
+
+
+void Gnss_Sdr_Task_Group::run(const std::function<void()> & task)
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_pending++;
+    }
+    Gnss_Sdr_Task_Pool::submit(d_task_id, d_priority, task, this);
+}
+
+
+void Gnss_Sdr_Task_Group::done(std::exception_ptr error)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    if (error && !d_error)
+        {
+            d_error = error;
+        }
+    if (--d_pending == 0)
+        {
+            d_done.notify_all();
+        }
+}
+
+
+void Gnss_Sdr_Task_Group::wait()
+{
+    std::unique_lock<std::mutex> lock(d_mutex);
+    while (d_pending > 0)
+        {
+            if (Gnss_Sdr_Task_Pool::in_worker())
+                {
+                    // a waiting worker runs tasks, so that nested groups cannot take all the workers
+                    lock.unlock();
+                    const bool ran = Gnss_Sdr_Task_Pool::run_one();
+                    lock.lock();
+                    if (!ran && d_pending > 0)
+                        {
+                            d_done.wait_for(lock, std::chrono::milliseconds(1));
+                        }
+                }
+            else
+                {
+                    d_done.wait(lock);
+                }
+        }
+    if (d_error)
+        {
+            std::exception_ptr error = d_error;
+            d_error = nullptr;
+            std::rethrow_exception(error);
+        }
+}
@@ -0,0 +1,156 @@
+/*!
+ * \file gnss_sdr_task_pool.h
+ * \brief Work-stealing pool of threads shared by the blocks of the receiver
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Blocks that split a computation (the Doppler bins of a search, the start
+ * of the channels) submit tasks to this pool instead of creating their own
+ * threads every time. Each worker has a deque per priority: it takes its
+ * newest tasks first and, when it has none, steals the oldest ones of the
+ * other workers. Tasks submitted from other threads are spread over the
+ * workers. Long-lived loops that block on a device or a socket keep their
+ * own threads.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_TASK_POOL_H_
+#define GNSS_SDR_GNSS_SDR_TASK_POOL_H_
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum Gnss_Sdr_Task_Priority
+{
+    TASK_PRIORITY_REALTIME = 0,   //!< signal processing, always taken first
+    TASK_PRIORITY_BACKGROUND = 1  //!< file and network output, on a limited number of workers at a time
+};
+
+class Gnss_Sdr_Task_Group;
+
+/*!
+ * \brief Process-wide pool. It starts on the first task with one worker per
+ * core, unless configure() was called before. All the methods are thread-safe.
+ */
+class Gnss_Sdr_Task_Pool
+{
+public:
+    //! Task names that can be registered with task_id()
+    static const unsigned int max_task_ids = 64;
+
+    struct Task_Metrics
+    {
+        std::string name;
+        unsigned long long submitted;
+        unsigned long long completed;
+        unsigned long long stolen;     // run by another worker than the one that got it
+        double mean_wait_ms;           // from the submission to the start
+        double mean_run_ms;
+        double max_run_ms;
+    };
+
+    /*!
+     * \brief Restarts the pool, after the queued tasks are done, with
+     * \p threads workers (0: one per core), of which at most
+     * \p background_threads (at least 1) run background tasks at a time.
+     * Worker i is bound to cores[i % cores.size()] if \p cores is not empty.
+     */
+    static void configure(unsigned int threads, unsigned int background_threads, const std::vector<int> & cores);
+
+    //! Runs the queued tasks and stops the workers; the next task starts them again
+    static void shutdown();
+
+    //! Workers of the pool, once started
+    static unsigned int threads();
+
+    //! True on a worker of the pool
+    static bool in_worker();
+
+    /*!
+     * \brief Identifier of the task name, for the metrics. The same name
+     * gives the same identifier; past max_task_ids names, 0 ("other") is returned.
+     */
+    static unsigned int task_id(const std::string & name);
+
+    /*!
+     * \brief Queues \p task. Its exceptions are logged; use a
+     * Gnss_Sdr_Task_Group to wait for tasks and get their exceptions.
+     */
+    static void submit(unsigned int task_id, Gnss_Sdr_Task_Priority priority, const std::function<void()> & task);
+
+    static std::vector<Task_Metrics> metrics();
+
+    //! One line per task name, for the log at the end
+    static std::vector<std::string> summary();
+
+    //! Metrics in the Prometheus text exposition format
+    static std::string prometheus_text();
+
+    static void reset_metrics();
+
+private:
+    friend class Gnss_Sdr_Task_Group;
+    static void submit(unsigned int task_id, Gnss_Sdr_Task_Priority priority,
+            const std::function<void()> & task, Gnss_Sdr_Task_Group * group);
+    // runs a queued task on the calling worker, false if there is none
+    static bool run_one();
+};
+
+
+/*!
+ * \brief Tasks that are waited for together. wait() throws again the first
+ * exception of the tasks. A worker that waits runs other tasks meanwhile,
+ * so groups can be nested; other threads sleep.
+ */
+class Gnss_Sdr_Task_Group
+{
+public:
+    explicit Gnss_Sdr_Task_Group(unsigned int task_id, Gnss_Sdr_Task_Priority priority = TASK_PRIORITY_REALTIME);
+
+    //! Waits for the tasks, without throwing
+    ~Gnss_Sdr_Task_Group();
+
+    void run(const std::function<void()> & task);
+    void wait();
+
+private:
+    friend class Gnss_Sdr_Task_Pool;
+    Gnss_Sdr_Task_Group(const Gnss_Sdr_Task_Group &);
+    Gnss_Sdr_Task_Group & operator=(const Gnss_Sdr_Task_Group &);
+    void done(std::exception_ptr error);
+
+    unsigned int d_task_id;
+    Gnss_Sdr_Task_Priority d_priority;
+    std::mutex d_mutex;
+    std::condition_variable d_done;
+    unsigned int d_pending;
+    std::exception_ptr d_error;
+};
+
+#endif /* GNSS_SDR_GNSS_SDR_TASK_POOL_H_ */
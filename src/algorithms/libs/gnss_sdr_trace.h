@@ -0,0 +1,232 @@
+/*!
+ * \file gnss_sdr_trace.h
+ * \brief Markers of the timeline of the blocks for tracing profilers
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The work of every block, the message handlers, the correlators, the
+ * acquisition Doppler loop, the PVT solutions and the output printers are
+ * marked with GNSS_SDR_TRACE_SCOPE, or GNSS_SDR_TRACE_SCOPE_CHANNEL with
+ * the channel and PRN they run for. A stall of the GNU Radio scheduler then
+ * shows up as a gap in the timeline of a thread. The markers are compiled
+ * in with the CMake option ENABLE_TRACING, which defines GNSS_SDR_TRACING
+ * for one of these backends (TRACING_BACKEND):
+ *
+ * 1 (chrome) - built in: each thread keeps its events in memory, and the
+ *   whole trace is written at exit to the file named by the GNSS_SDR_TRACE_FILE
+ *   environment variable, ./gnss-sdr_trace.json by default, in the Trace
+ *   Event Format read by ui.perfetto.dev and chrome://tracing.
+ * 2 (tracy) - zones of the Tracy profiler, to watch live.
+ * 3 (lttng) - begin and end events through lttng_ust_tracef, for the LTTng
+ *   session daemon, e.g. lttng enable-event -u 'lttng_ust_tracef:*'
+ *
+ * Without ENABLE_TRACING the macros expand to nothing and their arguments
+ * are not evaluated.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_TRACE_H_
+#define GNSS_SDR_GNSS_SDR_TRACE_H_
+
+#define GNSS_SDR_TRACE_CONCAT_(a, b) a##b
+#define GNSS_SDR_TRACE_CONCAT(a, b) GNSS_SDR_TRACE_CONCAT_(a, b)
+
+#if !defined(GNSS_SDR_TRACING) || GNSS_SDR_TRACING == 0
+
+//! Marks the rest of the enclosing scope, \p name must be a string literal
+#define GNSS_SDR_TRACE_SCOPE(name)
+//! Same as GNSS_SDR_TRACE_SCOPE, annotated with a channel and a PRN
+#define GNSS_SDR_TRACE_SCOPE_CHANNEL(name, channel, prn)
+
+#elif GNSS_SDR_TRACING == 2
+
+#include <Tracy.hpp>
+
+#define GNSS_SDR_TRACE_SCOPE(name) ZoneScopedN(name)
+#define GNSS_SDR_TRACE_SCOPE_CHANNEL(name, channel, prn) \
+    ZoneScopedN(name);                                     \
+    ZoneValue(static_cast<uint64_t>(channel));             \
+    ZoneValue(static_cast<uint64_t>(prn))
+
+#else
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <unistd.h>
+#if GNSS_SDR_TRACING == 3
+#include <lttng/tracef.h>
+#endif
+
+/*!
+ * \brief Events of the built-in backend, kept per thread until the trace is written
+ */
+class Gnss_Sdr_Trace
+{
+public:
+    //! Events kept per thread, about 32 bytes each; the later ones are dropped
+    static const size_t max_events_per_thread = 1 << 22;
+
+    static Gnss_Sdr_Trace & instance()
+    {
+        static Gnss_Sdr_Trace trace;
+        return trace;
+    }
+
+    static long long now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void record(const char * name, int channel, int prn, long long begin_ns, long long end_ns)
+    {
+        Thread_Events & events = thread_events();
+        if (events.events.size() >= max_events_per_thread) return;
+        Event event;
+        event.name = name;
+        event.channel = channel;
+        event.prn = prn;
+        event.begin_ns = begin_ns;
+        event.end_ns = end_ns;
+        events.events.push_back(event);
+    }
+
+    //! Writes the events of all the threads, those still running included
+    bool write(const char * filename)
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        FILE * file = std::fopen(filename, "w");
+        if (file == nullptr) return false;
+        std::fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+        const int pid = static_cast<int>(getpid());
+        bool first = true;
+        for (size_t t = 0; t < d_threads.size(); t++)
+            {
+                const std::vector<Event> & events = d_threads[t]->events;
+                for (size_t i = 0; i < events.size(); i++)
+                    {
+                        std::fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"gnss-sdr\",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+                                first ? "" : ",\n", events[i].name, pid, d_threads[t]->id,
+                                (events[i].begin_ns - d_start_ns) * 1e-3, (events[i].end_ns - events[i].begin_ns) * 1e-3);
+                        if (events[i].channel >= 0)
+                            {
+                                std::fprintf(file, ",\"args\":{\"channel\":%d,\"prn\":%d}", events[i].channel, events[i].prn);
+                            }
+                        std::fprintf(file, "}");
+                        first = false;
+                    }
+            }
+        std::fprintf(file, "\n]}\n");
+        return std::fclose(file) == 0;
+    }
+
+private:
+    struct Event
+    {
+        const char * name;  // a string literal
+        int channel;
+        int prn;
+        long long begin_ns;
+        long long end_ns;
+    };
+
+    struct Thread_Events
+    {
+        unsigned int id;
+        std::vector<Event> events;
+    };
+
+    Gnss_Sdr_Trace() : d_start_ns(now_ns()) {}
+
+    ~Gnss_Sdr_Trace()
+    {
+        const char * filename = std::getenv("GNSS_SDR_TRACE_FILE");
+        write(filename != nullptr ? filename : "./gnss-sdr_trace.json");
+    }
+
+    // the events of a thread outlive it, until the trace is written
+    Thread_Events & thread_events()
+    {
+        static thread_local Thread_Events * events = nullptr;
+        if (events == nullptr)
+            {
+                std::lock_guard<std::mutex> lock(d_mutex);
+                d_threads.push_back(std::unique_ptr<Thread_Events>(new Thread_Events()));
+                events = d_threads.back().get();
+                events->id = static_cast<unsigned int>(d_threads.size());
+            }
+        return *events;
+    }
+
+    long long d_start_ns;
+    std::mutex d_mutex;
+    std::vector<std::unique_ptr<Thread_Events> > d_threads;
+};
+
+
+//! Records the time from its construction to its destruction
+class Gnss_Sdr_Trace_Scope
+{
+public:
+    explicit Gnss_Sdr_Trace_Scope(const char * name, int channel = -1, int prn = -1)
+        : d_name(name), d_channel(channel), d_prn(prn)
+    {
+#if GNSS_SDR_TRACING == 3
+        tracef("B %s %d %d", d_name, d_channel, d_prn);
+#else
+        // the trace starts before the first event
+        Gnss_Sdr_Trace::instance();
+        d_begin_ns = Gnss_Sdr_Trace::now_ns();
+#endif
+    }
+
+    ~Gnss_Sdr_Trace_Scope()
+    {
+#if GNSS_SDR_TRACING == 3
+        tracef("E %s %d %d", d_name, d_channel, d_prn);
+#else
+        Gnss_Sdr_Trace::instance().record(d_name, d_channel, d_prn, d_begin_ns, Gnss_Sdr_Trace::now_ns());
+#endif
+    }
+
+private:
+    const char * d_name;
+    int d_channel;
+    int d_prn;
+    long long d_begin_ns;
+};
+
+#define GNSS_SDR_TRACE_SCOPE(name) \
+    Gnss_Sdr_Trace_Scope GNSS_SDR_TRACE_CONCAT(gnss_sdr_trace_scope_, __LINE__)(name)
+#define GNSS_SDR_TRACE_SCOPE_CHANNEL(name, channel, prn) \
+    Gnss_Sdr_Trace_Scope GNSS_SDR_TRACE_CONCAT(gnss_sdr_trace_scope_, __LINE__)(name, static_cast<int>(channel), static_cast<int>(prn))
+
+#endif
+
+#endif /*GNSS_SDR_GNSS_SDR_TRACE_H_*/
@@ -0,0 +1,103 @@
+/*!
+ * \file gnss_sdr_tracking_profiler.cc
+ * \brief Time spent by the tracking blocks in each phase of an epoch.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_tracking_profiler.h"
+
+
+const unsigned int Gnss_Sdr_Tracking_Profile::phases;
+std::mutex Gnss_Sdr_Tracking_Profiler::d_mutex;
+std::atomic<bool> Gnss_Sdr_Tracking_Profiler::d_enabled(false);
+std::multimap<std::string, std::shared_ptr<Gnss_Sdr_Tracking_Profile> > Gnss_Sdr_Tracking_Profiler::d_profiles;
+
+
+const char * Gnss_Sdr_Tracking_Profile::phase_name(unsigned int phase)
+{
+    static const char * names[phases] = {"correlation", "discriminators", "loop_filters", "lock_detectors", "output"};
+    return phase < phases ? names[phase] : "";
+}
+
+
+void Gnss_Sdr_Tracking_Profiler::enable(bool enabled)
+{
+    d_enabled = enabled;
+}
+
+
+bool Gnss_Sdr_Tracking_Profiler::enabled()
+{
+    return d_enabled;
+}
+
+
+std::shared_ptr<Gnss_Sdr_Tracking_Profile> Gnss_Sdr_Tracking_Profiler::profile(const std::string & block)
+{
+    // the profile is also what reads the hardware counters of the block
+    if (!d_enabled && !Gnss_Sdr_Hw_Counter_Registry::enabled()) return std::shared_ptr<Gnss_Sdr_Tracking_Profile>();
+    std::shared_ptr<Gnss_Sdr_Tracking_Profile> profile = std::make_shared<Gnss_Sdr_Tracking_Profile>(Gnss_Sdr_Hw_Counter_Registry::counters(block));
+    if (!d_enabled) return profile;
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_profiles.insert(std::make_pair(block, profile));
+    return profile;
+}
+
+
+Gnss_Sdr_Tracking_Profiler::Breakdown Gnss_Sdr_Tracking_Profiler::breakdown(const std::string & block)
+{
+    unsigned long long ns[Gnss_Sdr_Tracking_Profile::phases] = {0};
+    Breakdown breakdown;
+    breakdown.epochs = 0;
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        typedef std::multimap<std::string, std::shared_ptr<Gnss_Sdr_Tracking_Profile> >::const_iterator iterator;
+        std::pair<iterator, iterator> range = d_profiles.equal_range(block);
+        for (iterator it = range.first; it != range.second; ++it)
+            {
+                breakdown.epochs += it->second->epochs();
+                for (unsigned int phase = 0; phase < Gnss_Sdr_Tracking_Profile::phases; phase++)
+                    {
+                        ns[phase] += it->second->ns(phase);
+                    }
+            }
+    }
+    breakdown.total_ns_per_epoch = 0.0;
+    for (unsigned int phase = 0; phase < Gnss_Sdr_Tracking_Profile::phases; phase++)
+        {
+            breakdown.ns_per_epoch[phase] = breakdown.epochs > 0 ? static_cast<double>(ns[phase]) / static_cast<double>(breakdown.epochs) : 0.0;
+            breakdown.total_ns_per_epoch += breakdown.ns_per_epoch[phase];
+        }
+    return breakdown;
+}
+
+
+void Gnss_Sdr_Tracking_Profiler::reset()
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_profiles.clear();
+}
@@ -0,0 +1,150 @@
+/*!
+ * \file gnss_sdr_tracking_profiler.h
+ * \brief Time spent by the tracking blocks in each phase of an epoch.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * A tracking block starts its profile at the beginning of a code period,
+ * and ends each phase as it goes: the time since the end of the previous
+ * phase is added to it, so the phases must be ended in order and together
+ * they cover the whole epoch. The epochs are counted at the end of the
+ * output phase, the last one.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_TRACKING_PROFILER_H_
+#define GNSS_SDR_GNSS_SDR_TRACKING_PROFILER_H_
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "gnss_sdr_hw_counters.h"
+
+/*!
+ * \brief Time per phase of a tracking block, written by the block only
+ *
+ * With hardware counters, they are read from start() to the end of the
+ * output phase, the whole work of the block.
+ */
+class Gnss_Sdr_Tracking_Profile
+{
+public:
+    enum Phase
+    {
+        correlation = 0,  // carrier wipe-off and correlators, and their accumulation
+        discriminators,
+        loop_filters,     // and the NCO commands
+        lock_detectors,   // and the CN0 estimation
+        output            // Gnss_Synchro, dump and sample counter
+    };
+    static const unsigned int phases = 5;
+
+    static const char * phase_name(unsigned int phase);
+
+    explicit Gnss_Sdr_Tracking_Profile(std::shared_ptr<Gnss_Sdr_Hw_Counters> hw_counters = std::shared_ptr<Gnss_Sdr_Hw_Counters>())
+        : d_hw_counters(hw_counters), d_epochs(0)
+    {
+        for (unsigned int phase = 0; phase < phases; phase++) d_ns[phase] = 0;
+    }
+
+    void start()
+    {
+        if (d_hw_counters) d_hw_counters->start();
+        d_last = std::chrono::steady_clock::now();
+    }
+
+    void end(Phase phase)
+    {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        const long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - d_last).count();
+        d_ns[phase].store(d_ns[phase].load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+        d_last = now;
+        if (phase == output)
+            {
+                d_epochs.store(d_epochs.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                if (d_hw_counters) d_hw_counters->stop();
+            }
+    }
+
+    unsigned long long ns(unsigned int phase) const
+    {
+        return d_ns[phase].load(std::memory_order_relaxed);
+    }
+
+    unsigned long long epochs() const
+    {
+        return d_epochs.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::shared_ptr<Gnss_Sdr_Hw_Counters> d_hw_counters;
+    std::chrono::steady_clock::time_point d_last;
+    std::atomic<unsigned long long> d_ns[phases];
+    std::atomic<unsigned long long> d_epochs;
+};
+
+
+/*!
+ * \brief Registry of the profiles of the tracking blocks, by block name
+ *
+ * Nothing is measured unless enable() is called before the tracking blocks
+ * are created.
+ */
+class Gnss_Sdr_Tracking_Profiler
+{
+public:
+    struct Breakdown
+    {
+        unsigned long long epochs;
+        double ns_per_epoch[Gnss_Sdr_Tracking_Profile::phases];
+        double total_ns_per_epoch;
+    };
+
+    static void enable(bool enabled);
+    static bool enabled();
+
+    /*!
+     * \brief A new profile of a block called \p block, or null if neither
+     * the profiler nor the hardware counters are enabled
+     */
+    static std::shared_ptr<Gnss_Sdr_Tracking_Profile> profile(const std::string & block);
+
+    //! Sum of the profiles of the blocks called \p block
+    static Breakdown breakdown(const std::string & block);
+
+    //! Forgets all the profiles
+    static void reset();
+
+private:
+    static std::mutex d_mutex;
+    static std::atomic<bool> d_enabled;
+    static std::multimap<std::string, std::shared_ptr<Gnss_Sdr_Tracking_Profile> > d_profiles;
+};
+
+#endif /*GNSS_SDR_GNSS_SDR_TRACKING_PROFILER_H_*/
@@ -33,7 +33,8 @@
 #include "gnss_sdr_valve.h"
 #include <algorithm> // for min
 #include <gnuradio/io_signature.h>
-#include "control_message_factory.h"
+#include "control_event_bus.h"
+#include "gnss_sdr_trace.h"
 
 gnss_sdr_valve::gnss_sdr_valve (size_t sizeof_stream_item,
         unsigned long long nitems,
@@ -56,11 +57,10 @@ int gnss_sdr_valve::work (int noutput_items,
         gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE("gnss_sdr_valve::work");
     if (d_ncopied_items >= d_nitems)
         {
-            ControlMessageFactory* cmf = new ControlMessageFactory();
-            d_queue->handle(cmf->GetQueueMessage(200,0));
-            delete cmf;
+            Control_Event_Bus::send(d_queue, Control_Event_Bus::receiver, Control_Event_Bus::stop);
             return -1;    // Done!
         }
     unsigned long long n = std::min(d_nitems - d_ncopied_items, (long long unsigned int)noutput_items);
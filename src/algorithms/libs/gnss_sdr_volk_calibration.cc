@@ -0,0 +1,358 @@
+/*!
+ * \file gnss_sdr_volk_calibration.cc
+ * \brief Selection of the fastest VOLK_GNSSSDR implementations at startup.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_volk_calibration.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <glog/logging.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+
+
+namespace
+{
+const unsigned int calibration_warmup_calls = 2;
+const unsigned int calibration_timed_calls = 20;
+
+struct Calibration_Signal
+{
+    const char * name;
+    double code_period_s;
+    unsigned int code_length;    // samples of the local code replica
+    unsigned int taps;
+};
+
+const Calibration_Signal calibration_signals[] = {
+    {"1C", 0.001, 1023, 3},
+    {"1B", 0.004, 8184, 5},   // two samples per chip of the BOC(1,1) code
+    {"5X", 0.001, 10230, 3},
+    {"2S", 0.020, 10230, 3}
+};
+
+struct Kernel_Use
+{
+    unsigned int vlen;
+    unsigned int taps;
+    unsigned int code_length;
+};
+
+
+//! Buffers of all the types the tracking kernels take, with one spare sample to misalign them
+class Calibration_Buffers
+{
+public:
+    Calibration_Buffers(unsigned int vlen, unsigned int taps, unsigned int code_length) : d_taps(taps)
+    {
+        const size_t alignment = volk_gnsssdr_get_alignment();
+        in_32fc = static_cast<lv_32fc_t*>(volk_gnsssdr_malloc((vlen + 1) * sizeof(lv_32fc_t), alignment));
+        in_16sc = static_cast<lv_16sc_t*>(volk_gnsssdr_malloc((vlen + 1) * sizeof(lv_16sc_t), alignment));
+        in_8sc = static_cast<lv_8sc_t*>(volk_gnsssdr_malloc((vlen + 1) * sizeof(lv_8sc_t), alignment));
+        code_32fc = static_cast<lv_32fc_t*>(volk_gnsssdr_malloc(code_length * sizeof(lv_32fc_t), alignment));
+        code_16sc = static_cast<lv_16sc_t*>(volk_gnsssdr_malloc(code_length * sizeof(lv_16sc_t), alignment));
+        corr_32fc = static_cast<lv_32fc_t*>(volk_gnsssdr_malloc(taps * sizeof(lv_32fc_t), alignment));
+        corr_16sc = static_cast<lv_16sc_t*>(volk_gnsssdr_malloc(taps * sizeof(lv_16sc_t), alignment));
+        shifts_chips = static_cast<float*>(volk_gnsssdr_malloc(taps * sizeof(float), alignment));
+        tmp_code_phases_chips = static_cast<float*>(volk_gnsssdr_malloc(taps * sizeof(float), alignment));
+        resampled_32fc = static_cast<lv_32fc_t**>(volk_gnsssdr_malloc(taps * sizeof(lv_32fc_t*), alignment));
+        resampled_16sc = static_cast<lv_16sc_t**>(volk_gnsssdr_malloc(taps * sizeof(lv_16sc_t*), alignment));
+        for (unsigned int n = 0; n < taps; n++)
+            {
+                resampled_32fc[n] = static_cast<lv_32fc_t*>(volk_gnsssdr_malloc((vlen + 1) * sizeof(lv_32fc_t), alignment));
+                resampled_16sc[n] = static_cast<lv_16sc_t*>(volk_gnsssdr_malloc((vlen + 1) * sizeof(lv_16sc_t), alignment));
+                shifts_chips[n] = 0.5 * (static_cast<float>(n) - static_cast<float>(taps / 2));
+                tmp_code_phases_chips[n] = shifts_chips[n];
+            }
+        for (unsigned int i = 0; i < vlen + 1; i++)
+            {
+                const int re = std::rand() % 256 - 128;
+                const int im = std::rand() % 256 - 128;
+                in_32fc[i] = lv_cmake(static_cast<float>(re), static_cast<float>(im));
+                in_16sc[i] = lv_cmake(static_cast<int16_t>(re), static_cast<int16_t>(im));
+                in_8sc[i] = lv_cmake(static_cast<int8_t>(re / 2), static_cast<int8_t>(im / 2));
+            }
+        for (unsigned int i = 0; i < code_length; i++)
+            {
+                const int chip = (std::rand() % 2) ? 1 : -1;
+                code_32fc[i] = lv_cmake(static_cast<float>(chip), 0.0f);
+                code_16sc[i] = lv_cmake(static_cast<int16_t>(chip), static_cast<int16_t>(0));
+            }
+    }
+
+    ~Calibration_Buffers()
+    {
+        for (unsigned int n = 0; n < d_taps; n++)
+            {
+                volk_gnsssdr_free(resampled_32fc[n]);
+                volk_gnsssdr_free(resampled_16sc[n]);
+            }
+        volk_gnsssdr_free(resampled_32fc);
+        volk_gnsssdr_free(resampled_16sc);
+        volk_gnsssdr_free(tmp_code_phases_chips);
+        volk_gnsssdr_free(shifts_chips);
+        volk_gnsssdr_free(corr_16sc);
+        volk_gnsssdr_free(corr_32fc);
+        volk_gnsssdr_free(code_16sc);
+        volk_gnsssdr_free(code_32fc);
+        volk_gnsssdr_free(in_8sc);
+        volk_gnsssdr_free(in_16sc);
+        volk_gnsssdr_free(in_32fc);
+    }
+
+    lv_32fc_t * in_32fc;
+    lv_16sc_t * in_16sc;
+    lv_8sc_t * in_8sc;
+    lv_32fc_t * code_32fc;
+    lv_16sc_t * code_16sc;
+    lv_32fc_t * corr_32fc;
+    lv_16sc_t * corr_16sc;
+    float * shifts_chips;
+    float * tmp_code_phases_chips;
+    lv_32fc_t ** resampled_32fc;
+    lv_16sc_t ** resampled_16sc;
+
+private:
+    Calibration_Buffers(const Calibration_Buffers &);
+    Calibration_Buffers & operator=(const Calibration_Buffers &);
+    unsigned int d_taps;
+};
+
+
+//! Implementations of \p kernel, and whether they need aligned buffers
+std::vector<std::pair<std::string, bool> > kernel_impls(const std::string & kernel)
+{
+    std::vector<std::pair<std::string, bool> > impls;
+    const char ** impl_names = nullptr;
+    const bool * impl_alignment = nullptr;
+    size_t n_impls = 0;
+#define GNSS_SDR_VOLK_CALIBRATION_DESC(k) \
+    if (kernel == #k) \
+        { \
+            volk_gnsssdr_func_desc_t desc = k##_get_func_desc(); \
+            impl_names = desc.impl_names; \
+            impl_alignment = desc.impl_alignment; \
+            n_impls = desc.n_impls; \
+        }
+    GNSS_SDR_VOLK_CALIBRATION_DESC(volk_gnsssdr_32fc_x2_resampler_rotator_dot_prod_32fc_xn)
+    GNSS_SDR_VOLK_CALIBRATION_DESC(volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn)
+    GNSS_SDR_VOLK_CALIBRATION_DESC(volk_gnsssdr_32fc_x2_rotator_dot_prod_32fc_xn)
+    GNSS_SDR_VOLK_CALIBRATION_DESC(volk_gnsssdr_16ic_xn_resampler_fast_16ic_xn)
+    GNSS_SDR_VOLK_CALIBRATION_DESC(volk_gnsssdr_16ic_x2_rotator_dot_prod_16ic_xn)
+    GNSS_SDR_VOLK_CALIBRATION_DESC(volk_gnsssdr_8ic_32fc_xn_rotator_dot_prod_32fc_xn)
+#undef GNSS_SDR_VOLK_CALIBRATION_DESC
+    for (size_t i = 0; i < n_impls; i++)
+        {
+            impls.push_back(std::make_pair(std::string(impl_names[i]), impl_alignment[i]));
+        }
+    return impls;
+}
+
+
+//! One call of the implementation \p impl of \p kernel, as the tracking blocks make it
+std::function<void()> kernel_call(const std::string & kernel, const std::string & impl, Calibration_Buffers & b,
+        unsigned int vlen, unsigned int taps, unsigned int code_length, bool aligned, lv_32fc_t * phase)
+{
+    const unsigned int offset = aligned ? 0 : 1;
+    const lv_32fc_t phase_inc = lv_cmake(std::cos(0.01f), -std::sin(0.01f));
+    const float code_phase_step_chips = static_cast<float>(code_length) / static_cast<float>(vlen);
+    const int n = static_cast<int>(taps);
+    for (unsigned int t = 0; t < taps; t++)
+        {
+            b.resampled_32fc[t] += offset;
+            b.resampled_16sc[t] += offset;
+        }
+    if (kernel == "volk_gnsssdr_32fc_x2_resampler_rotator_dot_prod_32fc_xn")
+        {
+            return [=, &b]() { volk_gnsssdr_32fc_x2_resampler_rotator_dot_prod_32fc_xn_manual(b.corr_32fc, b.in_32fc + offset, phase_inc, phase,
+                    b.code_32fc, 0.0f, code_phase_step_chips, b.shifts_chips, code_length, n, vlen, impl.c_str()); };
+        }
+    if (kernel == "volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn")
+        {
+            return [=, &b]() { volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn_manual(b.resampled_32fc, b.code_32fc, 0.0f, code_phase_step_chips,
+                    b.shifts_chips, code_length, n, vlen, impl.c_str()); };
+        }
+    if (kernel == "volk_gnsssdr_32fc_x2_rotator_dot_prod_32fc_xn")
+        {
+            return [=, &b]() { volk_gnsssdr_32fc_x2_rotator_dot_prod_32fc_xn_manual(b.corr_32fc, b.in_32fc + offset, phase_inc, phase,
+                    const_cast<const lv_32fc_t**>(b.resampled_32fc), n, vlen, impl.c_str()); };
+        }
+    if (kernel == "volk_gnsssdr_16ic_xn_resampler_fast_16ic_xn")
+        {
+            return [=, &b]() { volk_gnsssdr_16ic_xn_resampler_fast_16ic_xn_manual(b.resampled_16sc, b.code_16sc, b.tmp_code_phases_chips,
+                    code_phase_step_chips, code_length, n, vlen, impl.c_str()); };
+        }
+    if (kernel == "volk_gnsssdr_16ic_x2_rotator_dot_prod_16ic_xn")
+        {
+            return [=, &b]() { volk_gnsssdr_16ic_x2_rotator_dot_prod_16ic_xn_manual(b.corr_16sc, b.in_16sc + offset, phase_inc, phase,
+                    const_cast<const lv_16sc_t**>(b.resampled_16sc), n, vlen, impl.c_str()); };
+        }
+    if (kernel == "volk_gnsssdr_8ic_32fc_xn_rotator_dot_prod_32fc_xn")
+        {
+            return [=, &b]() { volk_gnsssdr_8ic_32fc_xn_rotator_dot_prod_32fc_xn_manual(b.corr_32fc, b.in_8sc + offset, phase_inc, phase,
+                    const_cast<const lv_32fc_t**>(b.resampled_32fc), n, vlen, impl.c_str()); };
+        }
+    return std::function<void()>();
+}
+}
+
+
+std::vector<Gnss_Sdr_Volk_Calibration::Selection> Gnss_Sdr_Volk_Calibration::run(std::shared_ptr<ConfigurationInterface> configuration)
+{
+    std::vector<Selection> selections;
+    if (!configuration->property("GNSS-SDR.volk_calibration", false)) return selections;
+
+    const double fs_hz = configuration->property("GNSS-SDR.internal_fs_hz", 2048000.0);
+    std::map<std::string, Kernel_Use> uses;
+    for (unsigned int s = 0; s < sizeof(calibration_signals) / sizeof(calibration_signals[0]); s++)
+        {
+            const Calibration_Signal & signal = calibration_signals[s];
+            if (configuration->property("Channels_" + std::string(signal.name) + ".count", 0) == 0) continue;
+            const std::string role = "Tracking_" + std::string(signal.name);
+            const std::string item_type = configuration->property(role + ".item_type", std::string("gr_complex"));
+            std::vector<std::string> kernels;
+            if (item_type.compare("gr_complex") == 0)
+                {
+                    if (configuration->property(role + ".fast_resampler", false))
+                        {
+                            kernels.push_back("volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn");
+                            kernels.push_back("volk_gnsssdr_32fc_x2_rotator_dot_prod_32fc_xn");
+                        }
+                    else
+                        {
+                            kernels.push_back("volk_gnsssdr_32fc_x2_resampler_rotator_dot_prod_32fc_xn");
+                        }
+                }
+            else if (item_type.compare("cshort") == 0)
+                {
+                    kernels.push_back("volk_gnsssdr_16ic_xn_resampler_fast_16ic_xn");
+                    kernels.push_back("volk_gnsssdr_16ic_x2_rotator_dot_prod_16ic_xn");
+                }
+            else if (item_type.compare("cbyte") == 0)
+                {
+                    kernels.push_back("volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn");
+                    kernels.push_back("volk_gnsssdr_8ic_32fc_xn_rotator_dot_prod_32fc_xn");
+                }
+            else
+                {
+                    LOG(WARNING) << "VOLK_GNSSSDR calibration: unknown item type " << item_type << " of " << role;
+                    continue;
+                }
+            Kernel_Use use;
+            use.vlen = static_cast<unsigned int>(std::round(fs_hz * signal.code_period_s));
+            use.taps = signal.taps;
+            use.code_length = signal.code_length;
+            for (unsigned int k = 0; k < kernels.size(); k++)
+                {
+                    // a kernel shared by several signals is timed at the longest epoch
+                    std::map<std::string, Kernel_Use>::iterator it = uses.find(kernels[k]);
+                    if (it == uses.end() || it->second.vlen < use.vlen) uses[kernels[k]] = use;
+                }
+        }
+
+    for (std::map<std::string, Kernel_Use>::const_iterator it = uses.begin(); it != uses.end(); ++it)
+        {
+            Selection selection = calibrate(it->first, it->second.vlen, it->second.taps, it->second.code_length);
+            if (selection.impl_a.empty() || selection.impl_u.empty()
+                    || !volk_gnsssdr_select_impls(selection.kernel.c_str(), selection.impl_a.c_str(), selection.impl_u.c_str()))
+                {
+                    LOG(WARNING) << "VOLK_GNSSSDR calibration: could not select the implementations of " << it->first;
+                    continue;
+                }
+            LOG(INFO) << "VOLK_GNSSSDR calibration: " << selection.kernel << " with " << selection.vlen << " samples: "
+                      << selection.impl_a << " (aligned, " << selection.ns_a / 1000.0 << " us), "
+                      << selection.impl_u << " (unaligned, " << selection.ns_u / 1000.0 << " us)";
+            std::cout << "VOLK_GNSSSDR calibration: " << selection.kernel << " uses "
+                      << selection.impl_a << " / " << selection.impl_u << std::endl;
+            selections.push_back(selection);
+        }
+    return selections;
+}
+
+
+Gnss_Sdr_Volk_Calibration::Selection Gnss_Sdr_Volk_Calibration::calibrate(const std::string & kernel, unsigned int vlen, unsigned int taps, unsigned int code_length)
+{
+    Selection selection;
+    selection.kernel = kernel;
+    selection.vlen = vlen;
+    selection.ns_a = std::numeric_limits<double>::max();
+    selection.ns_u = std::numeric_limits<double>::max();
+    const std::vector<std::pair<std::string, bool> > impls = kernel_impls(kernel);
+    for (unsigned int i = 0; i < impls.size(); i++)
+        {
+            const double ns_a = time_impl(kernel, impls[i].first, vlen, taps, code_length, true);
+            if (ns_a < selection.ns_a)
+                {
+                    selection.ns_a = ns_a;
+                    selection.impl_a = impls[i].first;
+                }
+            if (impls[i].second) continue; // requires aligned buffers
+            const double ns_u = time_impl(kernel, impls[i].first, vlen, taps, code_length, false);
+            if (ns_u < selection.ns_u)
+                {
+                    selection.ns_u = ns_u;
+                    selection.impl_u = impls[i].first;
+                }
+        }
+    return selection;
+}
+
+
+double Gnss_Sdr_Volk_Calibration::time_impl(const std::string & kernel, const std::string & impl, unsigned int vlen, unsigned int taps, unsigned int code_length, bool aligned)
+{
+    Calibration_Buffers buffers(vlen, taps, code_length);
+    std::vector<lv_32fc_t*> resampled_32fc(buffers.resampled_32fc, buffers.resampled_32fc + taps);
+    std::vector<lv_16sc_t*> resampled_16sc(buffers.resampled_16sc, buffers.resampled_16sc + taps);
+    lv_32fc_t phase = lv_cmake(1.0f, 0.0f);
+    std::function<void()> call = kernel_call(kernel, impl, buffers, vlen, taps, code_length, aligned, &phase);
+    double best_ns = std::numeric_limits<double>::max();
+    if (call)
+        {
+            for (unsigned int i = 0; i < calibration_warmup_calls; i++) call();
+            for (unsigned int i = 0; i < calibration_timed_calls; i++)
+                {
+                    phase = lv_cmake(1.0f, 0.0f);
+                    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                    call();
+                    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+                    const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+                    if (ns < best_ns) best_ns = ns;
+                }
+        }
+    // kernel_call() misaligns the replicas in place: restore them to be freed
+    for (unsigned int t = 0; t < taps; t++)
+        {
+            buffers.resampled_32fc[t] = resampled_32fc[t];
+            buffers.resampled_16sc[t] = resampled_16sc[t];
+        }
+    return best_ns;
+}
@@ -0,0 +1,73 @@
+/*!
+ * \file gnss_sdr_volk_calibration.h
+ * \brief Selection of the fastest VOLK_GNSSSDR implementations at startup.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Without a volk_gnsssdr_config file, VOLK_GNSSSDR ranks the implementations
+ * of each kernel by the instruction sets they need, which is often wrong
+ * (e.g. unaligned AVX can be slower than SSE3). With
+ * GNSS-SDR.volk_calibration=true, the kernels used by the configured
+ * tracking blocks are timed at the vector lengths of the configured
+ * sampling rate before the flowgraph starts, and the fastest aligned and
+ * unaligned implementations of each one are used for this run.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_VOLK_CALIBRATION_H_
+#define GNSS_SDR_GNSS_SDR_VOLK_CALIBRATION_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "configuration_interface.h"
+
+/*!
+ * \brief Times the tracking kernels and selects the fastest implementations
+ */
+class Gnss_Sdr_Volk_Calibration
+{
+public:
+    struct Selection
+    {
+        std::string kernel;
+        unsigned int vlen;
+        std::string impl_a;  // fastest implementation with aligned buffers
+        double ns_a;
+        std::string impl_u;  // fastest implementation with unaligned buffers
+        double ns_u;
+    };
+
+    //! Calibrates the kernels of the receiver in \p configuration, if GNSS-SDR.volk_calibration is set
+    static std::vector<Selection> run(std::shared_ptr<ConfigurationInterface> configuration);
+
+    //! Times \p kernel with \p vlen samples, \p taps correlators and a code of \p code_length samples, and selects the fastest implementations
+    static Selection calibrate(const std::string & kernel, unsigned int vlen, unsigned int taps, unsigned int code_length);
+
+private:
+    static double time_impl(const std::string & kernel, const std::string & impl, unsigned int vlen, unsigned int taps, unsigned int code_length, bool aligned);
+};
+
+#endif /*GNSS_SDR_GNSS_SDR_VOLK_CALIBRATION_H_*/
@@ -34,41 +34,16 @@
 #include <cstdint>
 #include <cmath>
 #include "GPS_L2C.h"
-
-
-int32_t gps_l2c_m_shift(int32_t x)
-{
-    return static_cast<int32_t>((x >> 1)^((x & 1) * 0445112474));
-}
-
-
-void gps_l2c_m_code(int32_t * _dest, unsigned int _prn)
-{
-    int32_t x;
-    x = GPS_L2C_M_INIT_REG[ _prn - 1];
-    for (int n = 0; n < GPS_L2_M_CODE_LENGTH_CHIPS; n++)
-        {
-            _dest[n] = (int8_t)(x&1);
-            x = gps_l2c_m_shift(x);
-        }
-}
+#include "gnss_primary_codes.h"
 
 
 void gps_l2c_m_code_gen_complex(std::complex<float>* _dest, unsigned int _prn)
 {
-    int32_t* _code = new int32_t[GPS_L2_M_CODE_LENGTH_CHIPS];
-
-    if (_prn > 0 and _prn < 51)
+    const Gnss_Primary_Code& code = gnss_primary_code(GPS_L2C_M_PRIMARY_CODE, _prn);
+    for (unsigned int i = 0; i < code.length(); i++)
         {
-            gps_l2c_m_code(_code, _prn);
+            _dest[i] = std::complex<float>(code.chip(i), 0.0);
         }
-
-    for (signed int i = 0; i < GPS_L2_M_CODE_LENGTH_CHIPS; i++)
-        {
-            _dest[i] = std::complex<float>(1.0 - 2.0 * _code[i], 0.0);
-        }
-
-    delete[] _code;
 }
 
 
@@ -77,10 +52,10 @@ void gps_l2c_m_code_gen_complex(std::complex<float>* _dest, unsigned int _prn)
  */
 void gps_l2c_m_code_gen_complex_sampled(std::complex<float>* _dest, unsigned int _prn, signed int _fs)
 {
-    int32_t* _code = new int32_t[GPS_L2_M_CODE_LENGTH_CHIPS];
-    if (_prn > 0 and _prn < 51)
+    const Gnss_Primary_Code& code = gnss_primary_code(GPS_L2C_M_PRIMARY_CODE, _prn);
+    if (code.length() == 0)
         {
-            gps_l2c_m_code(_code, _prn);
+            return;
         }
 
     signed int _samplesPerCode, _codeValueIndex;
@@ -110,14 +85,13 @@ void gps_l2c_m_code_gen_complex_sampled(std::complex<float>* _dest, unsigned int
             if (i == _samplesPerCode - 1)
                 {
                     //--- Correct the last index (due to number rounding issues) -----------
-                    _dest[i] = std::complex<float>(1.0 - 2.0 * _code[_codeLength - 1], 0);
+                    _dest[i] = std::complex<float>(code.chip(_codeLength - 1), 0);
                 }
             else
                 {
-                    _dest[i] = std::complex<float>(1.0 - 2.0 * _code[_codeValueIndex], 0); //repeat the chip -> upsample
+                    _dest[i] = std::complex<float>(code.chip(_codeValueIndex), 0); //repeat the chip -> upsample
                 }
         }
-    delete[] _code;
 }
 
 
@@ -31,85 +31,18 @@
  */
 
 #include "gps_sdr_signal_processing.h"
+#include "gnss_primary_codes.h"
 
 auto auxCeil = [](float x){ return static_cast<int>(static_cast<long>((x)+1)); };
 
 void gps_l1_ca_code_gen_complex(std::complex<float>* _dest, signed int _prn, unsigned int _chip_shift)
 {
-    const unsigned int _code_length = 1023;
-    bool G1[_code_length];
-    bool G2[_code_length];
-    bool G1_register[10], G2_register[10];
-    bool feedback1, feedback2;
-    bool aux;
-    unsigned int lcv, lcv2;
-    unsigned int delay;
-    signed int prn_idx;
+    const Gnss_Primary_Code& code = gnss_primary_code(GPS_L1_CA_PRIMARY_CODE, _prn);
+    const unsigned int _code_length = code.length();
 
-    /* G2 Delays as defined in GPS-ISD-200D */
-    const signed int delays[51] = {5 /*PRN1*/, 6, 7, 8, 17, 18, 139, 140, 141, 251, 252, 254 ,255, 256, 257, 258, 469, 470, 471, 472,
-            473, 474, 509, 512, 513, 514, 515, 516, 859, 860, 861, 862 /*PRN32*/,
-            145 /*PRN120*/, 175, 52, 21, 237, 235, 886, 657, 634, 762,
-            355, 1012, 176, 603, 130, 359, 595, 68, 386 /*PRN138*/};
-
-    // compute delay array index for given PRN number
-    if(120 <= _prn && _prn <= 138)
-        {
-            prn_idx = _prn - 88;    // SBAS PRNs are at array indices 31 to 50 (offset: -120+33-1 =-88)
-        }
-    else
-        {
-            prn_idx = _prn - 1;
-        }
-
-    /* A simple error check */
-    if((prn_idx < 0) || (prn_idx > 51))
-        return;
-
-    for(lcv = 0; lcv < 10; lcv++)
-        {
-            G1_register[lcv] = 1;
-            G2_register[lcv] = 1;
-        }
-
-    /* Generate G1 & G2 Register */
-    for(lcv = 0; lcv < _code_length; lcv++)
-        {
-            G1[lcv] = G1_register[0];
-            G2[lcv] = G2_register[0];
-
-            feedback1 = G1_register[7]^G1_register[0];
-            feedback2 = (G2_register[8] + G2_register[7] + G2_register[4] + G2_register[2] + G2_register[1] + G2_register[0]) & 0x1;
-
-            for(lcv2 = 0; lcv2 < 9; lcv2++)
-                {
-                    G1_register[lcv2] = G1_register[lcv2 + 1];
-                    G2_register[lcv2] = G2_register[lcv2 + 1];
-                }
-
-            G1_register[9] = feedback1;
-            G2_register[9] = feedback2;
-        }
-
-    /* Set the delay */
-    delay = _code_length - delays[prn_idx];
-    delay += _chip_shift;
-    delay %= _code_length;
-
-    /* Generate PRN from G1 and G2 Registers */
-    for(lcv = 0; lcv < _code_length; lcv++)
+    for (unsigned int lcv = 0; lcv < _code_length; lcv++)
         {
-            aux = G1[(lcv + _chip_shift) % _code_length]^G2[delay];
-            if(aux == true)
-                {
-                    _dest[lcv] = std::complex<float>(1, 0);
-                }
-            else
-                {
-                    _dest[lcv] = std::complex<float>(-1, 0);
-                }
-            delay++;
-            delay %= _code_length;
+            _dest[lcv] = std::complex<float>(code.chip((lcv + _chip_shift) % _code_length), 0);
         }
 }
 
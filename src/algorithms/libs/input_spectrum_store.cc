@@ -0,0 +1,131 @@
+/*!
+ * \file input_spectrum_store.cc
+ * \brief Process-wide store of the spectra of the most recent input windows,
+ *  shared by the acquisition channels fed from the same signal conditioner.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "input_spectrum_store.h"
+#include "gnss_sdr_memory_accounting.h"
+#include <cstring>
+#include <glog/logging.h>
+#include <volk/volk.h>
+
+using google::LogMessage;
+
+
+Input_Spectra::Input_Spectra(unsigned int fft_size, unsigned int num_residuals)
+{
+    for (unsigned int i = 0; i < num_residuals; i++)
+        {
+            d_spectra.push_back(static_cast<std::complex<float>*>(gnss_sdr_volk_malloc(fft_size * sizeof(std::complex<float>), volk_get_alignment())));
+        }
+    d_ready = false;
+}
+
+
+Input_Spectra::~Input_Spectra()
+{
+    for (unsigned int i = 0; i < d_spectra.size(); i++)
+        {
+            gnss_sdr_volk_free(d_spectra[i]);
+        }
+}
+
+
+Input_Spectrum_Store& Input_Spectrum_Store::instance()
+{
+    static Input_Spectrum_Store store;
+    return store;
+}
+
+
+std::shared_ptr<const Input_Spectra> Input_Spectrum_Store::get(unsigned int rf_channel, long fs_in,
+        unsigned int fft_size, unsigned long int window,
+        const std::complex<float>* in,
+        const std::vector<std::complex<float>*>& rotators,
+        gr::fft::fft_complex* fft)
+{
+    unsigned int num_residuals = rotators.size();
+    key_type key = std::make_tuple(rf_channel, fs_in, fft_size, num_residuals, window);
+    std::shared_ptr<Input_Spectra> spectra;
+    {
+        boost::mutex::scoped_lock lock(d_mutex);
+        auto it = d_spectra.find(key);
+        if (it != d_spectra.end())
+            {
+                spectra = it->second;
+                d_hits++;
+            }
+        else
+            {
+                spectra = std::make_shared<Input_Spectra>(fft_size, num_residuals);
+                d_spectra[key] = spectra;
+                d_order.push_back(key);
+                if (d_order.size() > max_windows)
+                    {
+                        d_spectra.erase(d_order.front());
+                        d_order.pop_front();
+                    }
+            }
+    }
+
+    // Channels asking for the same window wait here until the first one has computed it
+    boost::mutex::scoped_lock lock(spectra->d_mutex);
+    if (!spectra->d_ready)
+        {
+            for (unsigned int residual = 0; residual < num_residuals; residual++)
+                {
+                    if (residual == 0)
+                        {
+                            memcpy(fft->get_inbuf(), in, sizeof(std::complex<float>) * fft_size);
+                        }
+                    else
+                        {
+                            volk_32fc_x2_multiply_32fc(fft->get_inbuf(), in, rotators[residual], fft_size);
+                        }
+                    fft->execute();
+                    memcpy(spectra->d_spectra[residual], fft->get_outbuf(), sizeof(std::complex<float>) * fft_size);
+                }
+            spectra->d_ready = true;
+        }
+    return spectra;
+}
+
+
+size_t Input_Spectrum_Store::size()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_spectra.size();
+}
+
+
+unsigned long int Input_Spectrum_Store::hits()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_hits;
+}
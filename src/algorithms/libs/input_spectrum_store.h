@@ -0,0 +1,132 @@
+/*!
+ * \file input_spectrum_store.h
+ * \brief Process-wide store of the spectra of the most recent input windows,
+ *  shared by the acquisition channels fed from the same signal conditioner.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * During a cold start, every channel in acquisition state transforms exactly
+ * the same input window. With this store, the first channel reaching a window
+ * computes its forward FFTs and the others only pay for the product with their
+ * own code spectrum and the inverse FFT. The spectra do not depend on the IF nor
+ * on the PRN, so they can be shared even between different GNSS signals.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_INPUT_SPECTRUM_STORE_H_
+#define GNSS_SDR_INPUT_SPECTRUM_STORE_H_
+
+#include <complex>
+#include <deque>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+#include <gnuradio/fft/fft.h>
+
+/*!
+ * \brief Forward FFTs of one input window, one per residual (sub-bin)
+ * frequency offset. See pcps_shifted_spectrum_acquisition_cc.
+ */
+class Input_Spectra
+{
+public:
+    Input_Spectra(unsigned int fft_size, unsigned int num_residuals);
+    ~Input_Spectra();
+
+    //! Returns the spectrum of the input rotated by the given residual offset (volk-aligned)
+    const std::complex<float>* spectrum(unsigned int residual) const
+    {
+        return d_spectra[residual];
+    }
+
+    unsigned int num_residuals() const
+    {
+        return d_spectra.size();
+    }
+
+private:
+    friend class Input_Spectrum_Store;
+    Input_Spectra(const Input_Spectra&);
+    Input_Spectra& operator=(const Input_Spectra&);
+    std::vector<std::complex<float>*> d_spectra;
+    boost::mutex d_mutex;
+    bool d_ready;
+};
+
+
+/*!
+ * \brief Thread-safe store of input spectra keyed by
+ * (RF channel, sampling frequency, FFT size, number of residuals, window index).
+ *
+ * Only the last few windows are retained. A channel that asks for an evicted
+ * window just computes it again, so sharing is an optimization and never
+ * changes the acquisition results.
+ */
+class Input_Spectrum_Store
+{
+public:
+    //! Returns the store shared by the whole process
+    static Input_Spectrum_Store& instance();
+
+    /*!
+     * \brief Returns the spectra of the given input window, computing them
+     * with the caller's FFT object if no other channel did it before.
+     *
+     * \param rf_channel Signal conditioner feeding the caller (Channel%d.RF_channel_ID)
+     * \param fs_in      Sampling frequency [Hz]
+     * \param fft_size   Length of the window and of the FFT [samples]
+     * \param window     Index of the window in the input stream (nitems_read of the caller)
+     * \param in         Input samples of the window
+     * \param rotators   Residual rotators; rotators[0] is assumed to be all ones and is not applied
+     * \param fft        Forward FFT of size fft_size owned by the caller
+     */
+    std::shared_ptr<const Input_Spectra> get(unsigned int rf_channel, long fs_in,
+            unsigned int fft_size, unsigned long int window,
+            const std::complex<float>* in,
+            const std::vector<std::complex<float>*>& rotators,
+            gr::fft::fft_complex* fft);
+
+    //! Number of windows currently stored
+    size_t size();
+
+    //! Number of requests served without computing any FFT
+    unsigned long int hits();
+
+private:
+    Input_Spectrum_Store() : d_hits(0) {}
+    Input_Spectrum_Store(const Input_Spectrum_Store&);
+    Input_Spectrum_Store& operator=(const Input_Spectrum_Store&);
+
+    static const size_t max_windows = 16;
+    typedef std::tuple<unsigned int, long, unsigned int, unsigned int, unsigned long int> key_type;
+    std::map<key_type, std::shared_ptr<Input_Spectra>> d_spectra;
+    std::deque<key_type> d_order;
+    unsigned long int d_hits;
+    boost::mutex d_mutex;
+};
+
+#endif /* GNSS_SDR_INPUT_SPECTRUM_STORE_H_ */
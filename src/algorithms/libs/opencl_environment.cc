@@ -0,0 +1,118 @@
+/*!
+ * \file opencl_environment.cc
+ * \brief OpenCL platform, device, context and programs shared by all the
+ *  blocks of the receiver.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "opencl_environment.h"
+#include <iostream>
+#include <vector>
+#include <glog/logging.h>
+#include "opencl_program_cache.h"
+
+using google::LogMessage;
+
+
+Opencl_Environment& Opencl_Environment::instance()
+{
+    static Opencl_Environment environment;
+    return environment;
+}
+
+
+Opencl_Environment::Opencl_Environment()
+{
+    d_status = 0;
+
+    //get all platforms (drivers)
+    std::vector<cl::Platform> all_platforms;
+    cl::Platform::get(&all_platforms);
+
+    if(all_platforms.size() == 0)
+        {
+            std::cout << "No OpenCL platforms found. Check OpenCL installation!" << std::endl;
+            d_status = 1;
+            return;
+        }
+
+    d_platform = all_platforms[0]; //get default platform
+    std::cout << "Using platform: " << d_platform.getInfo<CL_PLATFORM_NAME>() << std::endl;
+
+    //get default GPU device of the default platform
+    std::vector<cl::Device> gpu_devices;
+    d_platform.getDevices(CL_DEVICE_TYPE_GPU, &gpu_devices);
+
+    if(gpu_devices.size() == 0)
+        {
+            std::cout << "No GPU devices found. Check OpenCL installation!" << std::endl;
+            d_status = 2;
+            return;
+        }
+
+    d_device = gpu_devices[0];
+    std::cout << "Using device: " << d_device.getInfo<CL_DEVICE_NAME>() << std::endl;
+
+    std::vector<cl::Device> device;
+    device.push_back(d_device);
+    d_context = cl::Context(device);
+}
+
+
+bool Opencl_Environment::program(const std::string& name, const std::string& source, cl::Program& program)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    if (d_status != 0)
+        {
+            return false;
+        }
+    std::map<std::string, cl::Program>::iterator it = d_programs.find(name);
+    if (it != d_programs.end())
+        {
+            program = it->second;
+            return true;
+        }
+
+    cl_int err;
+    cl_program built = Opencl_Program_Cache::instance().build(d_context(), d_device(), source, "", &err);
+    if (built == 0)
+        {
+            LOG(WARNING) << "Unable to create the OpenCL program " << name << ": error " << err;
+            return false;
+        }
+    cl::Program wrapped(built);
+    if (err != CL_SUCCESS)
+        {
+            std::cout << " Error building: "
+                      << wrapped.getBuildInfo<CL_PROGRAM_BUILD_LOG>(d_device)
+                      << std::endl;
+            return false;
+        }
+    d_programs[name] = wrapped;
+    program = wrapped;
+    return true;
+}
@@ -0,0 +1,99 @@
+/*!
+ * \file opencl_environment.h
+ * \brief OpenCL platform, device, context and programs shared by all the
+ *  blocks of the receiver.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Every OpenCL acquisition channel used to pick its own platform and device,
+ * create its own context and compile its own copy of the kernels. Now the
+ * first block that needs them sets all this up, and the others reuse it:
+ * a program is compiled once per process (once per device and driver, with
+ * Opencl_Program_Cache), and all the buffers and FFT plans live in the same
+ * context.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_OPENCL_ENVIRONMENT_H_
+#define GNSS_SDR_OPENCL_ENVIRONMENT_H_
+
+#include <map>
+#include <string>
+#include <boost/thread/mutex.hpp>
+
+#ifdef __APPLE__
+    #include "cl.hpp"
+#else
+    #include <CL/cl.hpp>
+#endif
+
+/*!
+ * \brief Process-wide OpenCL environment on the first GPU of the first platform.
+ */
+class Opencl_Environment
+{
+public:
+    //! Returns the environment shared by the whole process, creating the context on the first call
+    static Opencl_Environment& instance();
+
+    //! 0 if there is a usable GPU, otherwise the error code of init_opencl_environment() in the blocks
+    int status() const
+    {
+        return d_status;
+    }
+
+    cl::Device& device()
+    {
+        return d_device;
+    }
+
+    cl::Context& context()
+    {
+        return d_context;
+    }
+
+    /*!
+     * \brief Returns the program of the given name, building it from source
+     * (or from a cached binary) only the first time it is requested.
+     * \param name - key of the program in this process.
+     * \param source - OpenCL C source of the program.
+     * \param program - the program, if the function returns true.
+     */
+    bool program(const std::string& name, const std::string& source, cl::Program& program);
+
+private:
+    Opencl_Environment();
+    Opencl_Environment(const Opencl_Environment&);
+    Opencl_Environment& operator=(const Opencl_Environment&);
+
+    int d_status;
+    cl::Platform d_platform;
+    cl::Device d_device;
+    cl::Context d_context;
+    std::map<std::string, cl::Program> d_programs;
+    boost::mutex d_mutex;
+};
+
+#endif /* GNSS_SDR_OPENCL_ENVIRONMENT_H_ */
@@ -0,0 +1,187 @@
+/*!
+ * \file opencl_program_cache.cc
+ * \brief Builds OpenCL programs from the binaries of previous runs when
+ *  they are available, so the kernels are only compiled once per device.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "opencl_program_cache.h"
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <sstream>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+
+Opencl_Program_Cache::Opencl_Program_Cache()
+{
+    const char* home = std::getenv("HOME");
+    if (home != 0)
+        {
+            d_directory = std::string(home) + "/.gnss-sdr/opencl_cache";
+        }
+    d_hits = 0;
+}
+
+
+Opencl_Program_Cache& Opencl_Program_Cache::instance()
+{
+    static Opencl_Program_Cache cache;
+    return cache;
+}
+
+
+void Opencl_Program_Cache::set_directory(const std::string& directory)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_directory = directory;
+}
+
+
+std::string Opencl_Program_Cache::directory()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_directory;
+}
+
+
+unsigned long int Opencl_Program_Cache::hits()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_hits;
+}
+
+
+static std::string device_string(cl_device_id device, cl_device_info param)
+{
+    size_t size = 0;
+    if (clGetDeviceInfo(device, param, 0, NULL, &size) != CL_SUCCESS || size == 0)
+        {
+            return std::string();
+        }
+    std::vector<char> value(size);
+    clGetDeviceInfo(device, param, size, value.data(), NULL);
+    return std::string(value.data());
+}
+
+
+std::string Opencl_Program_Cache::file_name(cl_device_id device, const std::string& source, const std::string& options)
+{
+    std::string directory = this->directory();
+    if (directory.empty())
+        {
+            return std::string();
+        }
+    std::string key = source + '\0' + options + '\0' + device_string(device, CL_DEVICE_NAME)
+            + '\0' + device_string(device, CL_DEVICE_VERSION) + '\0' + device_string(device, CL_DRIVER_VERSION);
+    std::ostringstream name;
+    name << directory << "/" << std::hex << std::hash<std::string>()(key) << ".bin";
+    return name.str();
+}
+
+
+cl_program Opencl_Program_Cache::build(cl_context context, cl_device_id device, const std::string& source,
+        const std::string& options, cl_int* error_code)
+{
+    cl_int err;
+    std::string file = file_name(device, source, options);
+
+    if (!file.empty())
+        {
+            std::ifstream ifs(file.c_str(), std::ifstream::binary);
+            if (ifs.is_open())
+                {
+                    std::vector<unsigned char> binary((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+                    const unsigned char* binary_ptr = binary.data();
+                    size_t binary_size = binary.size();
+                    cl_int binary_status = CL_INVALID_BINARY;
+                    cl_program program = clCreateProgramWithBinary(context, 1, &device, &binary_size,
+                            &binary_ptr, &binary_status, &err);
+                    if (err == CL_SUCCESS && binary_status == CL_SUCCESS
+                            && clBuildProgram(program, 1, &device, options.c_str(), NULL, NULL) == CL_SUCCESS)
+                        {
+                            boost::mutex::scoped_lock lock(d_mutex);
+                            d_hits++;
+                            *error_code = CL_SUCCESS;
+                            return program;
+                        }
+                    if (program != 0) clReleaseProgram(program);
+                    LOG(INFO) << "Ignoring the OpenCL binary " << file << ", building from source";
+                }
+        }
+
+    const char* source_ptr = source.c_str();
+    cl_program program = clCreateProgramWithSource(context, 1, &source_ptr, NULL, &err);
+    if (err != CL_SUCCESS)
+        {
+            *error_code = err;
+            return 0;
+        }
+    err = clBuildProgram(program, 1, &device, options.c_str(), NULL, NULL);
+    *error_code = err;
+    if (err != CL_SUCCESS || file.empty())
+        {
+            return program;
+        }
+
+    // Store the binary. It is written to a temporary file first, so that other
+    // channels or receivers never read a partial one
+    size_t binary_size = 0;
+    if (clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(size_t), &binary_size, NULL) != CL_SUCCESS
+            || binary_size == 0)
+        {
+            return program;
+        }
+    std::vector<unsigned char> binary(binary_size);
+    unsigned char* binary_ptr = binary.data();
+    if (clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(unsigned char*), &binary_ptr, NULL) != CL_SUCCESS)
+        {
+            return program;
+        }
+    boost::system::error_code ec;
+    boost::filesystem::path path(file);
+    boost::filesystem::create_directories(path.parent_path(), ec);
+    boost::filesystem::path tmp = boost::filesystem::unique_path(path.string() + ".%%%%%%");
+    std::ofstream ofs(tmp.string().c_str(), std::ofstream::binary);
+    ofs.write(reinterpret_cast<const char*>(binary.data()), binary_size);
+    ofs.close();
+    if (ofs.good())
+        {
+            boost::filesystem::rename(tmp, path, ec);
+        }
+    if (!ofs.good() || ec)
+        {
+            LOG(WARNING) << "Unable to store the OpenCL binary " << file;
+            boost::filesystem::remove(tmp, ec);
+        }
+    return program;
+}
@@ -0,0 +1,90 @@
+/*!
+ * \file opencl_program_cache.h
+ * \brief Builds OpenCL programs from the binaries of previous runs when
+ *  they are available, so the kernels are only compiled once per device.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Compiling the FFT and acquisition kernels takes several seconds per
+ * channel with some drivers. The binaries are stored in a directory, named
+ * after a hash of the source, the build options and the device and driver,
+ * so a new driver or a modified kernel always builds again from source.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_OPENCL_PROGRAM_CACHE_H_
+#define GNSS_SDR_OPENCL_PROGRAM_CACHE_H_
+
+#include <string>
+#include <boost/thread/mutex.hpp>
+
+#ifdef __APPLE__
+    #include <OpenCL/opencl.h>
+#else
+    #include <CL/cl.h>
+#endif
+
+/*!
+ * \brief Process-wide cache of OpenCL program binaries on disk.
+ */
+class Opencl_Program_Cache
+{
+public:
+    //! Returns the cache shared by the whole process
+    static Opencl_Program_Cache& instance();
+
+    /*!
+     * \brief Directory of the binaries. Defaults to $HOME/.gnss-sdr/opencl_cache.
+     * An empty directory disables the cache.
+     */
+    void set_directory(const std::string& directory);
+
+    std::string directory();
+
+    /*!
+     * \brief Returns a program built for the device, from the cached binary if
+     * there is a valid one and from the source otherwise (storing its binary).
+     * \param error_code - result of clBuildProgram. On a build error the program
+     *  is still returned, so that the caller can read its build log.
+     */
+    cl_program build(cl_context context, cl_device_id device, const std::string& source,
+            const std::string& options, cl_int* error_code);
+
+    //! Number of programs loaded from a binary
+    unsigned long int hits();
+
+private:
+    Opencl_Program_Cache();
+    Opencl_Program_Cache(const Opencl_Program_Cache&);
+    Opencl_Program_Cache& operator=(const Opencl_Program_Cache&);
+
+    std::string file_name(cl_device_id device, const std::string& source, const std::string& options);
+
+    std::string d_directory;
+    unsigned long int d_hits;
+    boost::mutex d_mutex;
+};
+
+#endif /* GNSS_SDR_OPENCL_PROGRAM_CACHE_H_ */
@@ -0,0 +1,183 @@
+/*!
+ * \file pcps_search_core.cc
+ * \brief Parallel Code Phase Search over a Doppler grid, shared by the
+ *  acquisition blocks whatever their sample type and detector
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "pcps_search_core.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <volk/volk.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+#include "fft_planner.h"
+#include "gnss_sdr_memory_accounting.h"
+
+namespace
+{
+// The index argument of volk_32f_index_max_16u changed from unsigned int to
+// uint16_t after VOLK 1.2.2. Deducing it from the kernel works with both.
+template<class Index, class Length>
+unsigned int index_max(void (*kernel)(Index*, const float*, Length), const float* in, unsigned int num_points)
+{
+    Index index = 0;
+    kernel(&index, in, num_points);
+    return index;
+}
+}
+
+
+float Pcps_Peak_To_Floor_Detector::noise(const float* magnitude, unsigned int window, float peak, float /*input_power*/)
+{
+    float sum = 0.0;
+    volk_32f_accumulator_s32f(&sum, magnitude, window);
+    return (sum - peak) / static_cast<float>(window - 1);
+}
+
+
+Pcps_Search_Core::Pcps_Search_Core(unsigned int samples_per_code, unsigned int fft_size, bool bit_transition)
+{
+    d_samples_per_code = samples_per_code;
+    d_fft_size = fft_size;
+    d_window = bit_transition ? fft_size / 2 : fft_size;
+    d_window_offset = fft_size - d_window;
+    d_fft = Fft_Planner::instance().acquire(d_fft_size, true);
+    d_ifft = Fft_Planner::instance().acquire(d_fft_size, false);
+    d_fft_codes = static_cast<std::complex<float>*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(std::complex<float>), volk_get_alignment()));
+    d_widened = static_cast<std::complex<float>*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(std::complex<float>), volk_get_alignment()));
+    d_magnitude = static_cast<float*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(float), volk_get_alignment()));
+    d_fft_pilot = 0;
+    d_data_correlation = 0;
+    d_input_power = 0.0;
+}
+
+
+Pcps_Search_Core::~Pcps_Search_Core()
+{
+    gnss_sdr_volk_free(d_fft_codes);
+    gnss_sdr_volk_free(d_widened);
+    gnss_sdr_volk_free(d_magnitude);
+    gnss_sdr_volk_free(d_fft_pilot);
+    gnss_sdr_volk_free(d_data_correlation);
+}
+
+
+void Pcps_Search_Core::set_local_code(const std::complex<float>* code)
+{
+    // [0 ... 0 c_0 c_1 ... c_L-1] with bit_transition, so that the second
+    // half of the correlation is linear instead of circular
+    std::complex<float>* buf = d_fft->get_inbuf();
+    std::fill(buf, buf + d_fft_size, std::complex<float>(0.0, 0.0));
+    const unsigned int length = std::min(d_samples_per_code, d_fft_size - d_window_offset);
+    std::memcpy(buf + d_window_offset, code, sizeof(std::complex<float>) * length);
+    d_fft->execute();
+    volk_32fc_conjugate_32fc(d_fft_codes, d_fft->get_outbuf(), d_fft_size);
+}
+
+
+void Pcps_Search_Core::set_pilot_code(const std::complex<float>* code)
+{
+    if (d_fft_pilot == 0)
+        {
+            d_fft_pilot = static_cast<std::complex<float>*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(std::complex<float>), volk_get_alignment()));
+            d_data_correlation = static_cast<std::complex<float>*>(gnss_sdr_volk_malloc(d_fft_size * sizeof(std::complex<float>), volk_get_alignment()));
+        }
+    std::complex<float>* buf = d_fft->get_inbuf();
+    std::fill(buf, buf + d_fft_size, std::complex<float>(0.0, 0.0));
+    const unsigned int length = std::min(d_samples_per_code, d_fft_size - d_window_offset);
+    std::memcpy(buf + d_window_offset, code, sizeof(std::complex<float>) * length);
+    d_fft->execute();
+    volk_32fc_conjugate_32fc(d_fft_pilot, d_fft->get_outbuf(), d_fft_size);
+}
+
+
+const std::complex<float>* Pcps_Search_Core::widen(const std::complex<float>* in)
+{
+    return in;
+}
+
+
+const std::complex<float>* Pcps_Search_Core::widen(const std::complex<int16_t>* in)
+{
+    volk_gnsssdr_16ic_convert_32fc(d_widened, in, d_fft_size);
+    return d_widened;
+}
+
+
+const std::complex<float>* Pcps_Search_Core::widen(const std::complex<int8_t>* in)
+{
+    volk_8i_s32f_convert_32f(reinterpret_cast<float*>(d_widened), reinterpret_cast<const int8_t*>(in), 1.0, 2 * d_fft_size);
+    return d_widened;
+}
+
+
+float Pcps_Search_Core::input_power(const std::complex<float>* samples)
+{
+    float power = 0.0;
+    volk_32fc_magnitude_squared_32f(d_magnitude, samples, d_fft_size);
+    volk_32f_accumulator_s32f(&power, d_magnitude, d_fft_size);
+    return power / static_cast<float>(d_fft_size);
+}
+
+
+unsigned int Pcps_Search_Core::correlate(const std::complex<float>* samples, const std::complex<float>* wipeoff)
+{
+    volk_32fc_x2_multiply_32fc(d_fft->get_inbuf(), samples, wipeoff, d_fft_size);
+    d_fft->execute();
+    volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(), d_fft->get_outbuf(), d_fft_codes, d_fft_size);
+    d_ifft->execute();
+    if (d_fft_pilot == 0)
+        {
+            volk_32fc_magnitude_squared_32f(d_magnitude, d_ifft->get_outbuf() + d_window_offset, d_window);
+        }
+    else
+        {
+            combine_pilot();
+        }
+    return index_max(volk_32f_index_max_16u, d_magnitude, d_window);
+}
+
+
+void Pcps_Search_Core::combine_pilot()
+{
+    std::memcpy(d_data_correlation, d_ifft->get_outbuf() + d_window_offset, sizeof(std::complex<float>) * d_window);
+    volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(), d_fft->get_outbuf(), d_fft_pilot, d_fft_size);
+    d_ifft->execute();
+
+    // |d + j p|^2 and |d - j p|^2 only differ in the sign of 2 Im(d p*), so
+    // the larger one is |d|^2 + |p|^2 + 2 |Im(d p*)|. The observers get the
+    // correlation with the pilot, left in d_ifft.
+    const std::complex<float>* pilot = d_ifft->get_outbuf() + d_window_offset;
+    for (unsigned int i = 0; i < d_window; i++)
+        {
+            const std::complex<float> d = d_data_correlation[i];
+            const std::complex<float> p = pilot[i];
+            const float cross = d.imag() * p.real() - d.real() * p.imag();
+            d_magnitude[i] = std::norm(d) + std::norm(p) + 2.0f * std::fabs(cross);
+        }
+}
@@ -0,0 +1,225 @@
+/*!
+ * \file pcps_search_core.h
+ * \brief Parallel Code Phase Search over a Doppler grid, shared by the
+ *  acquisition blocks whatever their sample type and detector
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Each Doppler bin of the search wipes the carrier off the input, correlates
+ * it with the local code through a forward FFT, a product with the conjugate
+ * code spectrum and an inverse FFT, and looks for the largest |.|^2 in the
+ * delay window. This is the part of the acquisition where the time goes, so
+ * it is written once here. The blocks are left with their state machine,
+ * their dwell logic and their messages.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PCPS_SEARCH_CORE_H_
+#define GNSS_SDR_PCPS_SEARCH_CORE_H_
+
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <gnuradio/fft/fft.h>
+#include "doppler_grid_store.h"
+
+//! Best cell of a search
+struct Pcps_Search_Result
+{
+    unsigned int doppler_index;  // bin of the Doppler_Grid
+    unsigned int delay_samples;  // index of the peak in the delay window
+    float magnitude;             // peak, as scaled by the detector
+    float noise_power;           // denominator of the test statistic
+    float test_statistic;        // magnitude / noise_power
+};
+
+
+/*!
+ * \brief CFAR detector: the peak, normalized by the FFT gains, over the
+ * mean power of the input samples.
+ */
+struct Pcps_Cfar_Detector
+{
+    static const bool uses_input_power = true;
+
+    static float peak(float magnitude, unsigned int fft_size)
+    {
+        const float norm = static_cast<float>(fft_size) * static_cast<float>(fft_size);
+        return magnitude / (norm * norm);
+    }
+
+    static float noise(const float* /*magnitude*/, unsigned int /*window*/, float /*peak*/, float input_power)
+    {
+        return input_power;
+    }
+};
+
+
+/*!
+ * \brief Peak to floor detector: the peak over the mean of the other cells
+ * of its Doppler bin. Needs no estimate of the input power.
+ */
+struct Pcps_Peak_To_Floor_Detector
+{
+    static const bool uses_input_power = false;
+
+    static float peak(float magnitude, unsigned int /*fft_size*/)
+    {
+        return magnitude;
+    }
+
+    static float noise(const float* magnitude, unsigned int window, float peak, float /*input_power*/);
+};
+
+
+/*!
+ * \brief FFT-based correlation of one input window with the local code,
+ * for every bin of a Doppler grid.
+ *
+ * The input samples may be std::complex<float>, std::complex<int16_t> or
+ * std::complex<int8_t> (VOLK's gr_complex, lv_16sc_t and lv_8sc_t). Integer
+ * samples are widened to floats once per search; float samples are used in
+ * place. The detector is a template parameter, so the per-bin loop has no
+ * run-time branch on it.
+ *
+ * With bit_transition, the FFT is twice the code window: the local code is
+ * placed after samples_per_code zeros, and only the second half of the
+ * correlation, where a data bit transition cannot wrap around, is searched.
+ * With a pilot code, each bin is searched with both codes: see set_pilot_code().
+ * An object must be used by a single thread at a time.
+ */
+class Pcps_Search_Core
+{
+public:
+    Pcps_Search_Core(unsigned int samples_per_code, unsigned int fft_size, bool bit_transition);
+    ~Pcps_Search_Core();
+
+    //! Takes the FFT of samples_per_code samples of the local code
+    void set_local_code(const std::complex<float>* code);
+
+    /*!
+     * \brief Takes the FFT of the pilot code of a data/pilot signal, after
+     * set_local_code() took the one of the data code. The correlations with
+     * both codes are then combined coherently, as data + j pilot and
+     * data - j pilot, and the larger magnitude is searched whatever the sign
+     * of the data bit (Coherent Channel Combining With Sign Recovery).
+     */
+    void set_pilot_code(const std::complex<float>* code);
+
+    //! Correlation observer that does nothing
+    struct No_Observer
+    {
+        void operator()(unsigned int /*doppler_index*/, const std::complex<float>* /*correlation*/) {}
+    };
+
+    //! Searches the fft_size() samples at in over grid, which must have fft_size() samples per wipe-off
+    template<class Detector, class Sample>
+    Pcps_Search_Result search(const Sample* in, const Doppler_Grid& grid)
+    {
+        No_Observer observer;
+        return search<Detector>(in, grid, observer);
+    }
+
+    /*!
+     * \brief Same as search(), calling observer(doppler_index, correlation)
+     * with the fft_size() complex outputs of the inverse FFT of each bin.
+     */
+    template<class Detector, class Sample, class Observer>
+    Pcps_Search_Result search(const Sample* in, const Doppler_Grid& grid, Observer& observer)
+    {
+        const std::complex<float>* samples = widen(in);
+        d_input_power = Detector::uses_input_power ? input_power(samples) : 0.0;
+
+        Pcps_Search_Result best = Pcps_Search_Result();
+        for (unsigned int doppler_index = 0; doppler_index < grid.num_bins(); doppler_index++)
+            {
+                const unsigned int delay = correlate(samples, grid.wipeoff(doppler_index));
+                observer(doppler_index, d_ifft->get_outbuf());
+                const float magnitude = Detector::peak(d_magnitude[delay], d_fft_size);
+                if (magnitude > best.magnitude)
+                    {
+                        // The floor is only computed for the bins that improve the peak
+                        best.doppler_index = doppler_index;
+                        best.delay_samples = delay;
+                        best.magnitude = magnitude;
+                        best.noise_power = Detector::noise(d_magnitude, d_window, magnitude, d_input_power);
+                        best.test_statistic = magnitude / best.noise_power;
+                    }
+            }
+        return best;
+    }
+
+    unsigned int fft_size() const
+    {
+        return d_fft_size;
+    }
+
+    //! Number of delays searched in each bin
+    unsigned int window() const
+    {
+        return d_window;
+    }
+
+    //! Magnitudes of the delay window of the last correlated bin, as seen by the observers
+    const float* magnitude() const
+    {
+        return d_magnitude;
+    }
+
+    //! Mean power of the input of the last search, if the detector uses it
+    float input_power() const
+    {
+        return d_input_power;
+    }
+
+private:
+    Pcps_Search_Core(const Pcps_Search_Core&);
+    Pcps_Search_Core& operator=(const Pcps_Search_Core&);
+
+    const std::complex<float>* widen(const std::complex<float>* in);
+    const std::complex<float>* widen(const std::complex<int16_t>* in);
+    const std::complex<float>* widen(const std::complex<int8_t>* in);
+    float input_power(const std::complex<float>* samples);
+
+    // Fills d_magnitude with the delay window of one bin, returns the index of its peak
+    unsigned int correlate(const std::complex<float>* samples, const std::complex<float>* wipeoff);
+    // Same, from the correlation with the data code in d_ifft, for a data/pilot signal
+    void combine_pilot();
+
+    unsigned int d_samples_per_code;
+    unsigned int d_fft_size;
+    unsigned int d_window;
+    unsigned int d_window_offset;
+    std::shared_ptr<gr::fft::fft_complex> d_fft;
+    std::shared_ptr<gr::fft::fft_complex> d_ifft;
+    std::complex<float>* d_fft_codes;
+    std::complex<float>* d_fft_pilot;          // 0 without a pilot code
+    std::complex<float>* d_data_correlation;
+    std::complex<float>* d_widened;
+    float* d_magnitude;
+    float d_input_power;
+};
+
+#endif /* GNSS_SDR_PCPS_SEARCH_CORE_H_ */
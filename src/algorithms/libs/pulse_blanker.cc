@@ -0,0 +1,174 @@
+/*!
+ * \file pulse_blanker.cc
+ * \brief Pulse blanking and adaptive notch filtering of complex samples
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "pulse_blanker.h"
+#include "gnss_sdr_memory_accounting.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <volk/volk.h>
+
+namespace
+{
+// Weight of the mean power of a call in the noise floor estimate
+const float FLOOR_SMOOTHING = 0.05;
+}
+
+
+Pulse_Blanker::Pulse_Blanker(bool blanking, float threshold, unsigned int guard_samples,
+        bool notch, float notch_mu, float notch_pole)
+{
+    d_blanking = blanking;
+    d_threshold = threshold;
+    d_guard = guard_samples;
+    d_notch = notch;
+    d_notch_mu = notch_mu;
+    d_notch_pole = notch_pole;
+    d_floor = 0.0;
+    d_blank_left = 0;
+    d_z0 = std::complex<float>(0.0, 0.0);
+    d_ar_prev = std::complex<float>(0.0, 0.0);
+    d_samples = 0;
+    d_blanked = 0;
+    d_pulses = 0;
+    d_power = nullptr;
+    d_float_buf = nullptr;
+    d_capacity = 0;
+}
+
+
+Pulse_Blanker::~Pulse_Blanker()
+{
+    gnss_sdr_volk_free(d_power);
+    gnss_sdr_volk_free(d_float_buf);
+}
+
+
+void Pulse_Blanker::reserve(unsigned int num_points)
+{
+    if (num_points <= d_capacity) return;
+    gnss_sdr_volk_free(d_power);
+    gnss_sdr_volk_free(d_float_buf);
+    d_power = static_cast<float*>(gnss_sdr_volk_malloc(num_points * sizeof(float), volk_get_alignment()));
+    d_float_buf = static_cast<std::complex<float>*>(gnss_sdr_volk_malloc(num_points * sizeof(std::complex<float>), volk_get_alignment()));
+    d_capacity = num_points;
+}
+
+
+void Pulse_Blanker::process(const std::complex<float>* in, std::complex<float>* out, unsigned int num_points)
+{
+    if (num_points == 0) return;
+    reserve(num_points);
+    if (out != in)
+        {
+            std::memcpy(out, in, num_points * sizeof(std::complex<float>));
+        }
+
+    volk_32fc_magnitude_squared_32f(d_power, in, num_points);
+    float total_power = 0.0;
+    volk_32f_accumulator_s32f(&total_power, d_power, num_points);
+    // The first call starts from the mean power, pulses included
+    const bool first_call = d_floor <= 0.0;
+    if (first_call)
+        {
+            d_floor = total_power / static_cast<float>(num_points);
+        }
+
+    unsigned int blanked = 0;
+    float blanked_power = 0.0;
+    if (d_blanking)
+        {
+            // Samples [0, run_end) are blanked. run_end may go past this call
+            // when the guard of a pulse does.
+            unsigned int run_end = d_blank_left;
+            unsigned int tail = std::min(run_end, num_points);
+            for (unsigned int i = 0; i < tail; i++)
+                {
+                    blanked_power += d_power[i];
+                    out[i] = std::complex<float>(0.0, 0.0);
+                }
+            blanked = tail;
+
+            const float threshold = d_threshold * d_floor;
+            for (unsigned int i = 0; i < num_points; i++)
+                {
+                    if (d_power[i] <= threshold) continue;
+                    unsigned int first = i > d_guard ? i - d_guard : 0;
+                    if (run_end == 0 || first > run_end)
+                        {
+                            d_pulses++;
+                        }
+                    first = std::max(first, std::min(run_end, num_points));
+                    run_end = std::max(run_end, i + d_guard + 1);
+                    unsigned int last = std::min(run_end, num_points);
+                    for (unsigned int k = first; k < last; k++)
+                        {
+                            blanked_power += d_power[k];
+                            out[k] = std::complex<float>(0.0, 0.0);
+                        }
+                    blanked += last - first;
+                }
+            d_blank_left = run_end > num_points ? run_end - num_points : 0;
+        }
+
+    if (blanked < num_points)
+        {
+            const float mean = (total_power - blanked_power) / static_cast<float>(num_points - blanked);
+            d_floor = first_call ? mean : d_floor + FLOOR_SMOOTHING * (mean - d_floor);
+        }
+
+    if (d_notch && d_floor > 0.0)
+        {
+            const float mu = d_notch_mu / d_floor;
+            const std::complex<float> pole = d_notch_pole;
+            for (unsigned int i = 0; i < num_points; i++)
+                {
+                    const std::complex<float> ar = out[i] + pole * d_z0 * d_ar_prev;
+                    const std::complex<float> y = ar - d_z0 * d_ar_prev;
+                    d_z0 += mu * y * std::conj(d_ar_prev);
+                    if (std::norm(d_z0) > 1.0) d_z0 /= std::abs(d_z0);
+                    d_ar_prev = ar;
+                    out[i] = y;
+                }
+        }
+
+    d_samples += num_points;
+    d_blanked += blanked;
+}
+
+
+void Pulse_Blanker::process(const std::complex<int16_t>* in, std::complex<int16_t>* out, unsigned int num_points)
+{
+    if (num_points == 0) return;
+    reserve(num_points);
+    volk_16i_s32f_convert_32f(reinterpret_cast<float*>(d_float_buf), reinterpret_cast<const int16_t*>(in), 1.0, 2 * num_points);
+    process(d_float_buf, d_float_buf, num_points);
+    volk_32f_s32f_convert_16i(reinterpret_cast<int16_t*>(out), reinterpret_cast<const float*>(d_float_buf), 1.0, 2 * num_points);
+}
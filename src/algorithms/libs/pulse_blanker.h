@@ -0,0 +1,127 @@
+/*!
+ * \file pulse_blanker.h
+ * \brief Pulse blanking and adaptive notch filtering of complex samples
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Pulsed interference, such as DME/TACAN, shows up as short bursts whose
+ * power is far above the noise floor, where the GNSS signals are buried.
+ * Zeroing those samples costs a fraction of the signal energy equal to the
+ * duty cycle, much less than letting the pulses through the correlators.
+ * Continuous wave interference is removed by a one-pole-one-zero adaptive
+ * notch filter, whose zero follows the interfering tone:
+ *
+ * D. Borio, L. Camoriano, L. Lo Presti, Two-Pole and Multi-Pole Notch
+ * Filters: A Computationally Effective Solution for GNSS Interference
+ * Detection and Mitigation, IEEE Systems Journal, vol. 2, no. 1, 2008.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PULSE_BLANKER_H_
+#define GNSS_SDR_PULSE_BLANKER_H_
+
+#include <complex>
+#include <cstdint>
+
+/*!
+ * \brief Blanks the samples around power peaks, then notches the strongest tone.
+ *
+ * A sample is a peak if its power exceeds threshold times the noise floor.
+ * The guard_samples samples on each side of a peak are zeroed as well (the
+ * ones before it only within the same call). The noise floor is the mean
+ * power of the samples that are not blanked, smoothed from call to call.
+ *
+ * The notch filter is
+ * H(z) = (1 - z0 z^-1) / (1 - notch_pole z0 z^-1),
+ * and z0 follows the tone with the normalized gradient step notch_mu.
+ * The power, comparison and conversion loops run on VOLK kernels; the notch
+ * is recursive and runs sample by sample.
+ */
+class Pulse_Blanker
+{
+public:
+    Pulse_Blanker(bool blanking, float threshold, unsigned int guard_samples,
+            bool notch, float notch_mu, float notch_pole);
+    ~Pulse_Blanker();
+
+    //! Processes num_points samples. out may be the same buffer as in.
+    void process(const std::complex<float>* in, std::complex<float>* out, unsigned int num_points);
+
+    //! Same as process(), for 16-bit samples. The output saturates.
+    void process(const std::complex<int16_t>* in, std::complex<int16_t>* out, unsigned int num_points);
+
+    unsigned long long samples() const
+    {
+        return d_samples;
+    }
+
+    unsigned long long blanked_samples() const
+    {
+        return d_blanked;
+    }
+
+    //! Runs of blanked samples, overlapping peaks count once
+    unsigned long long pulses() const
+    {
+        return d_pulses;
+    }
+
+    //! Mean power of the samples that are not blanked
+    float noise_power() const
+    {
+        return d_floor;
+    }
+
+    //! Zero of the notch filter: its argument is the tone frequency over the sample rate, times 2 pi
+    std::complex<float> notch_zero() const
+    {
+        return d_z0;
+    }
+
+private:
+    void reserve(unsigned int num_points);
+
+    bool d_blanking;
+    float d_threshold;
+    unsigned int d_guard;
+    bool d_notch;
+    float d_notch_mu;
+    float d_notch_pole;
+
+    float d_floor;                 // noise power estimate, 0 until the first call
+    unsigned int d_blank_left;     // samples still to blank from the previous call
+    std::complex<float> d_z0;
+    std::complex<float> d_ar_prev; // last output of the AR section of the notch
+
+    unsigned long long d_samples;
+    unsigned long long d_blanked;
+    unsigned long long d_pulses;
+
+    float* d_power;
+    std::complex<float>* d_float_buf;  // 16-bit samples converted to float
+    unsigned int d_capacity;
+};
+
+#endif /* GNSS_SDR_PULSE_BLANKER_H_ */
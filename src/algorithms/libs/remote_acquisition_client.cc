@@ -0,0 +1,278 @@
+/*!
+ * \file remote_acquisition_client.cc
+ * \brief Connection of the acquisition blocks to a remote acquisition server
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "remote_acquisition_client.h"
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+
+Remote_Acquisition_Client::Remote_Acquisition_Client(const std::string & host, unsigned short port,
+        unsigned int reconnect_period_ms)
+    : d_resolver(d_io_service),
+      d_socket(d_io_service),
+      d_retry_timer(d_io_service)
+{
+    d_host = host;
+    d_port = port;
+    d_reconnect_period_ms = reconnect_period_ms;
+    d_writing = false;
+    d_stopping = false;
+    d_read_buffer.resize(64 * 1024);
+    d_connected = false;
+    d_bytes_sent = 0;
+    d_next_id = 0;
+
+    d_work.reset(new boost::asio::io_service::work(d_io_service));
+    d_io_service.post([this]() { do_connect(); });
+    d_thread = std::thread([this]() { d_io_service.run(); });
+}
+
+
+Remote_Acquisition_Client::~Remote_Acquisition_Client()
+{
+    d_io_service.post([this]()
+            {
+        d_stopping = true;
+        boost::system::error_code ec;
+        d_retry_timer.cancel(ec);
+        d_resolver.cancel();
+        d_socket.close(ec);
+        d_connected = false;
+        d_queue.clear();
+            });
+    // run() returns once the pending operations have been cancelled
+    d_work.reset();
+    d_thread.join();
+    LOG(INFO) << "Remote acquisition server " << d_host << ":" << d_port << ": "
+              << d_bytes_sent.load() << " bytes sent";
+}
+
+
+unsigned int Remote_Acquisition_Client::submit(Remote_Acquisition_Request & request)
+{
+    if (!d_connected)
+        {
+            return 0;
+        }
+    {
+        boost::mutex::scoped_lock lock(d_mutex);
+        // 0 is never an id
+        d_next_id = (d_next_id == 0xFFFFFFFF) ? 1 : d_next_id + 1;
+        request.id = d_next_id;
+        d_pending.insert(request.id);
+    }
+    std::shared_ptr<std::string> buffer = std::make_shared<std::string>(remote_acquisition_encode(request));
+    const unsigned int id = request.id;
+    d_io_service.post([this, buffer, id]()
+            {
+        if (d_stopping or !d_connected)
+            {
+                // lost in the meantime
+                cancel(id);
+                return;
+            }
+        d_queue.push_back(std::string());
+        d_queue.back().swap(*buffer);
+        do_write();
+            });
+    return request.id;
+}
+
+
+Remote_Acquisition_Status Remote_Acquisition_Client::poll(unsigned int id, Remote_Acquisition_Reply & reply)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    std::map<unsigned int, Remote_Acquisition_Reply>::iterator it = d_replies.find(id);
+    if (it != d_replies.end())
+        {
+            std::swap(reply, it->second);
+            d_replies.erase(it);
+            return REMOTE_ACQUISITION_DONE;
+        }
+    // the requests in flight when the connection was lost are forgotten
+    return d_pending.count(id) ? REMOTE_ACQUISITION_PENDING : REMOTE_ACQUISITION_FAILED;
+}
+
+
+void Remote_Acquisition_Client::cancel(unsigned int id)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_pending.erase(id);
+    d_replies.erase(id);
+}
+
+
+void Remote_Acquisition_Client::do_connect()
+{
+    boost::asio::ip::tcp::resolver::query query(d_host, std::to_string(d_port));
+    d_resolver.async_resolve(query, [this](boost::system::error_code ec, boost::asio::ip::tcp::resolver::iterator endpoints)
+            {
+        if (d_stopping)
+            {
+                return;
+            }
+        if (ec)
+            {
+                LOG(WARNING) << "Cannot resolve " << d_host << ": " << ec.message();
+                close_and_retry();
+                return;
+            }
+        boost::asio::async_connect(d_socket, endpoints,
+                [this](boost::system::error_code ec, boost::asio::ip::tcp::resolver::iterator /*endpoint*/)
+                        {
+            if (d_stopping)
+                {
+                    return;
+                }
+            if (ec)
+                {
+                    DLOG(INFO) << "Cannot connect to " << d_host << ":" << d_port << ": " << ec.message();
+                    close_and_retry();
+                    return;
+                }
+            LOG(INFO) << "Connected to the remote acquisition server " << d_host << ":" << d_port;
+            boost::system::error_code option_ec;
+            d_socket.set_option(boost::asio::ip::tcp::no_delay(true), option_ec);
+            d_decoder.reset();
+            d_connected = true;
+            do_read();
+            do_write();
+                        });
+            });
+}
+
+
+void Remote_Acquisition_Client::do_read()
+{
+    d_socket.async_read_some(boost::asio::buffer(d_read_buffer),
+            [this](boost::system::error_code ec, std::size_t length)
+                    {
+        if (d_stopping or !d_connected)
+            {
+                return;
+            }
+        if (!ec)
+            {
+                d_decoder.push(d_read_buffer.data(), length);
+                Remote_Acquisition_Reply reply;
+                boost::mutex::scoped_lock lock(d_mutex);
+                while (d_decoder.next_reply(reply))
+                    {
+                        // the replies to cancelled requests are dropped
+                        if (d_pending.erase(reply.id))
+                            {
+                                d_replies[reply.id] = reply;
+                            }
+                    }
+            }
+        if (ec or d_decoder.error())
+            {
+                LOG(WARNING) << "Connection to the remote acquisition server " << d_host << ":" << d_port
+                             << " lost: " << (ec ? ec.message() : std::string("malformed reply"));
+                close_and_retry();
+                return;
+            }
+        do_read();
+                    });
+}
+
+
+void Remote_Acquisition_Client::do_write()
+{
+    if (d_writing or !d_connected or d_queue.empty())
+        {
+            return;
+        }
+    d_writing = true;
+    boost::asio::async_write(d_socket, boost::asio::buffer(d_queue.front()),
+            [this](boost::system::error_code ec, std::size_t length)
+                    {
+        d_writing = false;
+        if (d_stopping or !d_connected)
+            {
+                return;
+            }
+        if (ec)
+            {
+                LOG(WARNING) << "Connection to the remote acquisition server " << d_host << ":" << d_port
+                             << " lost: " << ec.message();
+                close_and_retry();
+                return;
+            }
+        d_bytes_sent += length;
+        d_queue.pop_front();
+        do_write();
+                    });
+}
+
+
+void Remote_Acquisition_Client::close_and_retry()
+{
+    d_connected = false;
+    boost::system::error_code ec;
+    d_socket.close(ec);
+    d_queue.clear();
+    {
+        // the blocks search these snapshots locally
+        boost::mutex::scoped_lock lock(d_mutex);
+        d_pending.clear();
+    }
+    d_retry_timer.expires_from_now(boost::posix_time::milliseconds(d_reconnect_period_ms));
+    d_retry_timer.async_wait([this](boost::system::error_code ec)
+            {
+        if (!ec and !d_stopping)
+            {
+                do_connect();
+            }
+            });
+}
+
+
+Remote_Acquisition_Client_Store& Remote_Acquisition_Client_Store::instance()
+{
+    static Remote_Acquisition_Client_Store store;
+    return store;
+}
+
+
+std::shared_ptr<Remote_Acquisition_Client> Remote_Acquisition_Client_Store::get(const std::string & host,
+        unsigned short port, unsigned int reconnect_period_ms)
+{
+    const std::string key = host + ":" + std::to_string(port);
+    boost::mutex::scoped_lock lock(d_mutex);
+    std::shared_ptr<Remote_Acquisition_Client> client = d_clients[key].lock();
+    if (!client)
+        {
+            client = std::make_shared<Remote_Acquisition_Client>(host, port, reconnect_period_ms);
+            d_clients[key] = client;
+        }
+    return client;
+}
@@ -0,0 +1,149 @@
+/*!
+ * \file remote_acquisition_client.h
+ * \brief Connection of the acquisition blocks to a remote acquisition server
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_REMOTE_ACQUISITION_CLIENT_H_
+#define GNSS_SDR_REMOTE_ACQUISITION_CLIENT_H_
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/asio.hpp>
+#include <boost/thread/mutex.hpp>
+#include "remote_acquisition_protocol.h"
+
+//! State of a request, see Remote_Acquisition_Client::poll()
+enum Remote_Acquisition_Status
+{
+    REMOTE_ACQUISITION_PENDING = 0,
+    REMOTE_ACQUISITION_DONE = 1,
+    REMOTE_ACQUISITION_FAILED = 2
+};
+
+/*!
+ * \brief TCP connection to a remote acquisition server, shared by the
+ * acquisition blocks of all the channels.
+ *
+ * A network thread connects when the client is built, and reconnects
+ * reconnect_period_ms after any error. The requests are only accepted while
+ * connected, and those in flight when the connection is lost fail, so that
+ * the blocks can search their snapshots locally at once.
+ */
+class Remote_Acquisition_Client
+{
+public:
+    Remote_Acquisition_Client(const std::string & host, unsigned short port, unsigned int reconnect_period_ms);
+    ~Remote_Acquisition_Client();
+
+    bool connected() const
+    {
+        return d_connected.load();
+    }
+
+    /*!
+     * \brief Sends a request, setting its id. Returns the id, or 0 if the
+     * client is not connected.
+     */
+    unsigned int submit(Remote_Acquisition_Request & request);
+
+    //! Takes the reply to request \p id, once it is REMOTE_ACQUISITION_DONE
+    Remote_Acquisition_Status poll(unsigned int id, Remote_Acquisition_Reply & reply);
+
+    //! Forgets request \p id, e.g., after a timeout
+    void cancel(unsigned int id);
+
+    unsigned long long bytes_sent() const
+    {
+        return d_bytes_sent.load();
+    }
+
+private:
+    // Network thread
+    void do_connect();
+    void do_read();
+    void do_write();
+    void close_and_retry();
+
+    std::string d_host;
+    unsigned short d_port;
+    unsigned int d_reconnect_period_ms;
+
+    boost::asio::io_service d_io_service;
+    std::unique_ptr<boost::asio::io_service::work> d_work;
+    boost::asio::ip::tcp::resolver d_resolver;
+    boost::asio::ip::tcp::socket d_socket;
+    boost::asio::deadline_timer d_retry_timer;
+    std::thread d_thread;
+    bool d_writing;
+    bool d_stopping;
+    std::deque<std::string> d_queue;
+    std::vector<char> d_read_buffer;
+    Remote_Acquisition_Decoder d_decoder;
+    std::atomic<bool> d_connected;
+    std::atomic<unsigned long long> d_bytes_sent;
+
+    // Shared with the blocks
+    boost::mutex d_mutex;
+    unsigned int d_next_id;
+    std::set<unsigned int> d_pending;
+    std::map<unsigned int, Remote_Acquisition_Reply> d_replies;
+};
+
+
+/*!
+ * \brief Process-wide store of the clients, keyed by server address and port.
+ *
+ * The store only keeps weak references: the connection is closed when the
+ * last acquisition block using it is destroyed.
+ */
+class Remote_Acquisition_Client_Store
+{
+public:
+    //! Returns the store shared by the whole process
+    static Remote_Acquisition_Client_Store& instance();
+
+    //! Returns the client of host:port, connecting it if no block holds it yet
+    std::shared_ptr<Remote_Acquisition_Client> get(const std::string & host, unsigned short port,
+            unsigned int reconnect_period_ms);
+
+private:
+    Remote_Acquisition_Client_Store() {}
+    Remote_Acquisition_Client_Store(const Remote_Acquisition_Client_Store&);
+    Remote_Acquisition_Client_Store& operator=(const Remote_Acquisition_Client_Store&);
+
+    std::map<std::string, std::weak_ptr<Remote_Acquisition_Client>> d_clients;
+    boost::mutex d_mutex;
+};
+
+#endif /* GNSS_SDR_REMOTE_ACQUISITION_CLIENT_H_ */
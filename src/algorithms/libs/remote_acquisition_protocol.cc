@@ -0,0 +1,337 @@
+/*!
+ * \file remote_acquisition_protocol.cc
+ * \brief Messages between the acquisition blocks and a remote acquisition server
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "remote_acquisition_protocol.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+const char MAGIC[2] = {'R', 'A'};
+const std::size_t HEADER_BYTES = 7;
+
+
+void put_uint(std::string & out, std::uint64_t value, unsigned int bytes)
+{
+    for (unsigned int k = 0; k < bytes; k++)
+        {
+            out.push_back(static_cast<char>((value >> (8 * k)) & 0xFF));
+        }
+}
+
+
+void put_float(std::string & out, float value)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put_uint(out, bits, 4);
+}
+
+
+void put_double(std::string & out, double value)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    put_uint(out, bits, 8);
+}
+
+
+// Reads the payload of a frame, failing at its end
+class Reader
+{
+public:
+    explicit Reader(const std::string & data) : d_data(data), d_pos(0), d_ok(true) {}
+
+    std::uint64_t uint(unsigned int bytes)
+    {
+        if (d_data.size() - d_pos < bytes)
+            {
+                d_ok = false;
+                d_pos = d_data.size();
+                return 0;
+            }
+        std::uint64_t value = 0;
+        for (unsigned int k = 0; k < bytes; k++)
+            {
+                value |= static_cast<std::uint64_t>(static_cast<unsigned char>(d_data[d_pos++])) << (8 * k);
+            }
+        return value;
+    }
+
+    float float_value()
+    {
+        const std::uint32_t bits = uint(4);
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    double double_value()
+    {
+        const std::uint64_t bits = uint(8);
+        double d;
+        std::memcpy(&d, &bits, sizeof(d));
+        return d;
+    }
+
+    std::size_t left() const
+    {
+        return d_data.size() - d_pos;
+    }
+
+    const char* data() const
+    {
+        return d_data.data() + d_pos;
+    }
+
+    bool ok() const
+    {
+        return d_ok;
+    }
+
+private:
+    const std::string & d_data;
+    std::size_t d_pos;
+    bool d_ok;
+};
+
+
+std::string frame(unsigned char type, const std::string & payload)
+{
+    std::string out;
+    out.reserve(HEADER_BYTES + payload.size());
+    out.append(MAGIC, 2);
+    out.push_back(static_cast<char>(type));
+    put_uint(out, payload.size(), 4);
+    out.append(payload);
+    return out;
+}
+}
+
+
+std::string remote_acquisition_encode(const Remote_Acquisition_Request & request)
+{
+    std::string payload;
+    payload.reserve(48 + request.prns.size() + request.packed.size());
+    payload.push_back(static_cast<char>(REMOTE_ACQUISITION_VERSION));
+    put_uint(payload, request.id, 4);
+    payload.push_back(request.system);
+    payload.push_back(request.signal.size() > 0 ? request.signal[0] : ' ');
+    payload.push_back(request.signal.size() > 1 ? request.signal[1] : ' ');
+    put_uint(payload, static_cast<std::uint64_t>(static_cast<std::int64_t>(request.fs_in)), 8);
+    put_double(payload, request.if_hz);
+    put_uint(payload, static_cast<std::uint32_t>(request.doppler_min), 4);
+    put_uint(payload, static_cast<std::uint32_t>(request.doppler_max), 4);
+    put_uint(payload, request.doppler_step, 4);
+    put_float(payload, request.threshold);
+    const unsigned int satellites = std::min<std::size_t>(request.prns.size(), 255);
+    payload.push_back(static_cast<char>(satellites));
+    for (unsigned int i = 0; i < satellites; i++)
+        {
+            payload.push_back(static_cast<char>(request.prns[i] & 0xFF));
+        }
+    put_uint(payload, request.samples, 4);
+    payload.append(reinterpret_cast<const char*>(request.packed.data()), request.packed.size());
+    return frame(REMOTE_ACQUISITION_REQUEST, payload);
+}
+
+
+std::string remote_acquisition_encode(const Remote_Acquisition_Reply & reply)
+{
+    std::string payload;
+    const unsigned int peaks = std::min<std::size_t>(reply.peaks.size(), 255);
+    payload.reserve(5 + peaks * 21);
+    put_uint(payload, reply.id, 4);
+    payload.push_back(static_cast<char>(peaks));
+    for (unsigned int i = 0; i < peaks; i++)
+        {
+            const Remote_Acquisition_Peak & peak = reply.peaks[i];
+            payload.push_back(static_cast<char>(peak.prn & 0xFF));
+            put_float(payload, peak.test_statistics);
+            put_double(payload, peak.code_phase_samples);
+            put_double(payload, peak.doppler_hz);
+        }
+    return frame(REMOTE_ACQUISITION_REPLY, payload);
+}
+
+
+void remote_acquisition_pack(const std::complex<int8_t>* in, unsigned int num_points, std::vector<unsigned char> & packed)
+{
+    packed.assign((num_points + 1) / 2, 0);
+    for (unsigned int i = 0; i < num_points; i++)
+        {
+            // -3, -1, 1, 3 -> 0, 1, 2, 3
+            const unsigned int re = static_cast<unsigned int>(std::min(std::max(in[i].real() + 3, 0), 6)) >> 1;
+            const unsigned int im = static_cast<unsigned int>(std::min(std::max(in[i].imag() + 3, 0), 6)) >> 1;
+            packed[i >> 1] |= static_cast<unsigned char>((re | (im << 2)) << (4 * (i & 1)));
+        }
+}
+
+
+void remote_acquisition_unpack(const std::vector<unsigned char> & packed, unsigned int num_points, std::vector<std::complex<float>> & out)
+{
+    num_points = std::min<std::size_t>(num_points, 2 * packed.size());
+    out.resize(num_points);
+    for (unsigned int i = 0; i < num_points; i++)
+        {
+            const unsigned int nibble = (packed[i >> 1] >> (4 * (i & 1))) & 0x0F;
+            out[i] = std::complex<float>(2.0f * static_cast<float>(nibble & 0x03) - 3.0f,
+                    2.0f * static_cast<float>(nibble >> 2) - 3.0f);
+        }
+}
+
+
+Remote_Acquisition_Decoder::Remote_Acquisition_Decoder()
+{
+    d_error = false;
+}
+
+
+void Remote_Acquisition_Decoder::reset()
+{
+    d_buffer.clear();
+    d_error = false;
+    d_requests.clear();
+    d_replies.clear();
+}
+
+
+void Remote_Acquisition_Decoder::push(const char* data, std::size_t size)
+{
+    if (d_error) return;
+    d_buffer.append(data, size);
+    std::size_t pos = 0;
+    while (d_buffer.size() - pos >= HEADER_BYTES)
+        {
+            const char* header = d_buffer.data() + pos;
+            if (header[0] != MAGIC[0] or header[1] != MAGIC[1])
+                {
+                    d_error = true;
+                    break;
+                }
+            std::uint32_t length = 0;
+            for (int k = 0; k < 4; k++)
+                {
+                    length |= static_cast<std::uint32_t>(static_cast<unsigned char>(header[3 + k])) << (8 * k);
+                }
+            if (length > REMOTE_ACQUISITION_MAX_PAYLOAD)
+                {
+                    d_error = true;
+                    break;
+                }
+            if (d_buffer.size() - pos < HEADER_BYTES + length) break;
+            if (!decode_frame(static_cast<unsigned char>(header[2]), d_buffer.substr(pos + HEADER_BYTES, length)))
+                {
+                    d_error = true;
+                    break;
+                }
+            pos += HEADER_BYTES + length;
+        }
+    if (d_error)
+        {
+            d_buffer.clear();
+            return;
+        }
+    d_buffer.erase(0, pos);
+}
+
+
+bool Remote_Acquisition_Decoder::decode_frame(unsigned char type, const std::string & payload)
+{
+    Reader reader(payload);
+    switch (type)
+    {
+    case REMOTE_ACQUISITION_REQUEST:
+        {
+            if (reader.uint(1) != REMOTE_ACQUISITION_VERSION) return false;
+            Remote_Acquisition_Request request;
+            request.id = reader.uint(4);
+            request.system = static_cast<char>(reader.uint(1));
+            request.signal.push_back(static_cast<char>(reader.uint(1)));
+            request.signal.push_back(static_cast<char>(reader.uint(1)));
+            request.fs_in = static_cast<long>(static_cast<std::int64_t>(reader.uint(8)));
+            request.if_hz = reader.double_value();
+            request.doppler_min = static_cast<std::int32_t>(reader.uint(4));
+            request.doppler_max = static_cast<std::int32_t>(reader.uint(4));
+            request.doppler_step = reader.uint(4);
+            request.threshold = reader.float_value();
+            const unsigned int satellites = reader.uint(1);
+            for (unsigned int i = 0; i < satellites; i++)
+                {
+                    request.prns.push_back(reader.uint(1));
+                }
+            request.samples = reader.uint(4);
+            if (!reader.ok() or reader.left() != (static_cast<std::size_t>(request.samples) + 1) / 2) return false;
+            request.packed.assign(reinterpret_cast<const unsigned char*>(reader.data()),
+                    reinterpret_cast<const unsigned char*>(reader.data()) + reader.left());
+            d_requests.push_back(Remote_Acquisition_Request());
+            std::swap(d_requests.back(), request);
+            return true;
+        }
+    case REMOTE_ACQUISITION_REPLY:
+        {
+            Remote_Acquisition_Reply reply;
+            reply.id = reader.uint(4);
+            const unsigned int peaks = reader.uint(1);
+            for (unsigned int i = 0; i < peaks; i++)
+                {
+                    Remote_Acquisition_Peak peak;
+                    peak.prn = reader.uint(1);
+                    peak.test_statistics = reader.float_value();
+                    peak.code_phase_samples = reader.double_value();
+                    peak.doppler_hz = reader.double_value();
+                    reply.peaks.push_back(peak);
+                }
+            if (!reader.ok() or reader.left() != 0) return false;
+            d_replies.push_back(reply);
+            return true;
+        }
+    default:
+        return false;
+    }
+}
+
+
+bool Remote_Acquisition_Decoder::next_request(Remote_Acquisition_Request & request)
+{
+    if (d_requests.empty()) return false;
+    std::swap(request, d_requests.front());
+    d_requests.pop_front();
+    return true;
+}
+
+
+bool Remote_Acquisition_Decoder::next_reply(Remote_Acquisition_Reply & reply)
+{
+    if (d_replies.empty()) return false;
+    std::swap(reply, d_replies.front());
+    d_replies.pop_front();
+    return true;
+}
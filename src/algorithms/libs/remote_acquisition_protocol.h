@@ -0,0 +1,160 @@
+/*!
+ * \file remote_acquisition_protocol.h
+ * \brief Messages between the acquisition blocks and a remote acquisition server
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * A receiver sends a snapshot of the dwell of an acquisition, requantized
+ * to two bits per component, and the server sends back the correlation
+ * peak of each requested satellite. The messages are frames
+ *
+ * | magic "RA" | type (1 byte) | payload length (4 bytes, little endian) | payload |
+ *
+ * and the fields of the payloads are little endian as well.
+ *
+ * - REQUEST: version (1 byte), id (4), system (1), signal (2), sampling
+ *   frequency (8, integer), IF (8, double), first and last Doppler bin (4 + 4,
+ *   integers), Doppler step (4), threshold (4, float), number of satellites (1),
+ *   one PRN per satellite (1 each), number of samples (4) and the samples,
+ *   two per byte.
+ * - REPLY: id (4), number of peaks (1), and for each peak: PRN (1),
+ *   test statistics (4, float), code phase [samples] (8, double) and
+ *   Doppler [Hz] (8, double). A reply without peaks means that the
+ *   server could not search the snapshot.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_REMOTE_ACQUISITION_PROTOCOL_H_
+#define GNSS_SDR_REMOTE_ACQUISITION_PROTOCOL_H_
+
+#include <complex>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#define REMOTE_ACQUISITION_VERSION 1
+
+//! Largest payload accepted by the decoder [bytes]
+#define REMOTE_ACQUISITION_MAX_PAYLOAD (16 * 1024 * 1024)
+
+//! Frames of the protocol
+enum Remote_Acquisition_Frame
+{
+    REMOTE_ACQUISITION_REQUEST = 1,
+    REMOTE_ACQUISITION_REPLY = 2
+};
+
+/*!
+ * \brief Search of one snapshot. The Doppler bins are
+ * doppler_min + k doppler_step <= doppler_max [Hz].
+ */
+struct Remote_Acquisition_Request
+{
+    unsigned int id;
+    char system;                        //!< 'G', 'E', as in Gnss_Synchro
+    std::string signal;                 //!< "1C", "1B", as in Gnss_Synchro
+    std::vector<unsigned int> prns;
+    long fs_in;                         //!< Sampling frequency [Hz]
+    double if_hz;                       //!< Intermediate frequency [Hz]
+    int doppler_min;
+    int doppler_max;
+    unsigned int doppler_step;
+    float threshold;                    //!< The server may refine the detections above it
+    unsigned int samples;
+    std::vector<unsigned char> packed;  //!< See remote_acquisition_pack()
+};
+
+//! Correlation peak of one satellite
+struct Remote_Acquisition_Peak
+{
+    unsigned int prn;
+    float test_statistics;
+    double code_phase_samples;  //!< Start of a code period in the snapshot
+    double doppler_hz;
+};
+
+struct Remote_Acquisition_Reply
+{
+    unsigned int id;
+    std::vector<Remote_Acquisition_Peak> peaks;
+};
+
+//! REQUEST frame
+std::string remote_acquisition_encode(const Remote_Acquisition_Request & request);
+
+//! REPLY frame
+std::string remote_acquisition_encode(const Remote_Acquisition_Reply & reply);
+
+/*!
+ * \brief Packs num_points samples quantized to two bits, whose components
+ * are -3, -1, 1 or 3 (see Sample_Requantizer), into num_points / 2 bytes
+ * (rounded up). The in-phase component takes the two low bits of a sample
+ * and the first sample of a byte its four low bits.
+ */
+void remote_acquisition_pack(const std::complex<int8_t>* in, unsigned int num_points, std::vector<unsigned char> & packed);
+
+//! Unpacks the samples of remote_acquisition_pack(), with components -3, -1, 1 or 3
+void remote_acquisition_unpack(const std::vector<unsigned char> & packed, unsigned int num_points, std::vector<std::complex<float>> & out);
+
+
+/*!
+ * \brief Decodes a stream of frames, received in pieces of any size.
+ *
+ * A malformed stream (bad magic, unknown version or frame, payload too
+ * long or inconsistent) sets error() and the rest of it is ignored.
+ */
+class Remote_Acquisition_Decoder
+{
+public:
+    Remote_Acquisition_Decoder();
+
+    //! Decodes the frames completed by \p size more bytes of the stream
+    void push(const char* data, std::size_t size);
+
+    //! Takes the oldest decoded request
+    bool next_request(Remote_Acquisition_Request & request);
+
+    //! Takes the oldest decoded reply
+    bool next_reply(Remote_Acquisition_Reply & reply);
+
+    bool error() const
+    {
+        return d_error;
+    }
+
+    //! Forgets the state of the stream, e.g., for a new connection
+    void reset();
+
+private:
+    bool decode_frame(unsigned char type, const std::string & payload);
+
+    std::string d_buffer;        // bytes of the incomplete frame
+    bool d_error;
+    std::deque<Remote_Acquisition_Request> d_requests;
+    std::deque<Remote_Acquisition_Reply> d_replies;
+};
+
+#endif /* GNSS_SDR_REMOTE_ACQUISITION_PROTOCOL_H_ */
@@ -0,0 +1,200 @@
+/*!
+ * \file sample_requantizer.cc
+ * \brief Automatic gain control and requantization of complex samples to
+ *  narrow integer types
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "sample_requantizer.h"
+#include "gnss_sdr_memory_accounting.h"
+#include <algorithm>
+#include <cmath>
+#include <volk/volk.h>
+
+namespace
+{
+// Step of minimum distortion of a Gaussian signal of unit standard deviation,
+// for 2, 3 and 4 bits (Max, 1960)
+const float optimum_step[3] = { 0.9957, 0.5860, 0.3352 };
+}
+
+
+Sample_Requantizer::Sample_Requantizer(unsigned int bits, float rms_fraction, double time_constant_samples, float fixed_gain)
+{
+    d_bits = std::min(std::max(bits, 2u), 16u);
+    d_odd_levels = d_bits <= 4;
+    if (d_odd_levels)
+        {
+            d_max_level = static_cast<float>(1 << (d_bits - 1)) - 0.5;
+            d_target_rms = 1.0 / optimum_step[d_bits - 2];
+            d_output_scale = 2.0;
+        }
+    else
+        {
+            d_max_level = static_cast<float>((1 << (d_bits - 1)) - 1);
+            d_target_rms = rms_fraction * d_max_level;
+            d_output_scale = 1.0;
+        }
+    d_time_constant = std::max(time_constant_samples, 1.0);
+    d_agc = fixed_gain <= 0.0;
+    d_gain = d_agc ? 0.0 : fixed_gain / d_output_scale;
+    d_samples = 0;
+    d_clipped = 0;
+    d_sum_xq = 0.0;
+    d_sum_xx = 0.0;
+    d_sum_qq = 0.0;
+    d_float_in = nullptr;
+    d_scaled = nullptr;
+    d_quantized = nullptr;
+    d_capacity = 0;
+}
+
+
+Sample_Requantizer::~Sample_Requantizer()
+{
+    gnss_sdr_volk_free(d_float_in);
+    gnss_sdr_volk_free(d_scaled);
+    gnss_sdr_volk_free(d_quantized);
+}
+
+
+void Sample_Requantizer::reserve(unsigned int num_points)
+{
+    if (num_points <= d_capacity) return;
+    gnss_sdr_volk_free(d_float_in);
+    gnss_sdr_volk_free(d_scaled);
+    gnss_sdr_volk_free(d_quantized);
+    const size_t size = 2 * num_points * sizeof(float);
+    d_float_in = static_cast<float*>(gnss_sdr_volk_malloc(size, volk_get_alignment()));
+    d_scaled = static_cast<float*>(gnss_sdr_volk_malloc(size, volk_get_alignment()));
+    d_quantized = static_cast<float*>(gnss_sdr_volk_malloc(size, volk_get_alignment()));
+    d_capacity = num_points;
+}
+
+
+void Sample_Requantizer::quantize(const float* in, unsigned int num_points)
+{
+    const unsigned int n = 2 * num_points;
+    if (d_agc)
+        {
+            float sum_squares = 0.0;
+            volk_32f_x2_dot_prod_32f(&sum_squares, in, in, n);
+            const float sigma = std::sqrt(sum_squares / static_cast<float>(n));
+            if (sigma > 0.0)
+                {
+                    const float target = d_target_rms / sigma;
+                    if (d_gain <= 0.0)
+                        {
+                            d_gain = target;
+                        }
+                    else
+                        {
+                            const double alpha = std::min(static_cast<double>(num_points) / d_time_constant, 1.0);
+                            d_gain *= static_cast<float>(std::pow(static_cast<double>(target / d_gain), alpha));
+                        }
+                }
+        }
+    volk_32f_s32f_multiply_32f(d_scaled, in, d_gain, n);
+
+    unsigned int clipped = 0;
+    const float max_level = d_max_level;
+    if (d_odd_levels)
+        {
+            for (unsigned int i = 0; i < n; i++)
+                {
+                    const float q = std::floor(d_scaled[i]) + 0.5f;
+                    clipped += std::abs(q) > max_level;
+                    d_quantized[i] = std::min(std::max(q, -max_level), max_level);
+                }
+        }
+    else
+        {
+            for (unsigned int i = 0; i < n; i++)
+                {
+                    const float q = std::nearbyint(d_scaled[i]);
+                    clipped += std::abs(q) > max_level;
+                    d_quantized[i] = std::min(std::max(q, -max_level), max_level);
+                }
+        }
+
+    float xq = 0.0;
+    float xx = 0.0;
+    float qq = 0.0;
+    volk_32f_x2_dot_prod_32f(&xq, d_scaled, d_quantized, n);
+    volk_32f_x2_dot_prod_32f(&xx, d_scaled, d_scaled, n);
+    volk_32f_x2_dot_prod_32f(&qq, d_quantized, d_quantized, n);
+    d_sum_xq += xq;
+    d_sum_xx += xx;
+    d_sum_qq += qq;
+    d_clipped += clipped;
+    d_samples += num_points;
+}
+
+
+void Sample_Requantizer::process(const std::complex<float>* in, std::complex<int8_t>* out, unsigned int num_points)
+{
+    if (num_points == 0) return;
+    reserve(num_points);
+    quantize(reinterpret_cast<const float*>(in), num_points);
+    volk_32f_s32f_convert_8i(reinterpret_cast<int8_t*>(out), d_quantized, d_output_scale, 2 * num_points);
+}
+
+
+void Sample_Requantizer::process(const std::complex<float>* in, std::complex<int16_t>* out, unsigned int num_points)
+{
+    if (num_points == 0) return;
+    reserve(num_points);
+    quantize(reinterpret_cast<const float*>(in), num_points);
+    volk_32f_s32f_convert_16i(reinterpret_cast<int16_t*>(out), d_quantized, d_output_scale, 2 * num_points);
+}
+
+
+void Sample_Requantizer::process(const std::complex<int16_t>* in, std::complex<int8_t>* out, unsigned int num_points)
+{
+    if (num_points == 0) return;
+    reserve(num_points);
+    volk_16i_s32f_convert_32f(d_float_in, reinterpret_cast<const int16_t*>(in), 1.0, 2 * num_points);
+    quantize(d_float_in, num_points);
+    volk_32f_s32f_convert_8i(reinterpret_cast<int8_t*>(out), d_quantized, d_output_scale, 2 * num_points);
+}
+
+
+void Sample_Requantizer::process(const std::complex<int16_t>* in, std::complex<int16_t>* out, unsigned int num_points)
+{
+    if (num_points == 0) return;
+    reserve(num_points);
+    volk_16i_s32f_convert_32f(d_float_in, reinterpret_cast<const int16_t*>(in), 1.0, 2 * num_points);
+    quantize(d_float_in, num_points);
+    volk_32f_s32f_convert_16i(reinterpret_cast<int16_t*>(out), d_quantized, d_output_scale, 2 * num_points);
+}
+
+
+double Sample_Requantizer::implementation_loss_db() const
+{
+    if (d_sum_xx <= 0.0 || d_sum_qq <= 0.0) return 0.0;
+    return -10.0 * std::log10(d_sum_xq * d_sum_xq / (d_sum_xx * d_sum_qq));
+}
@@ -0,0 +1,128 @@
+/*!
+ * \file sample_requantizer.h
+ * \brief Automatic gain control and requantization of complex samples to
+ *  narrow integer types
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The 8ic and 16ic acquisition and tracking kernels saturate if the level
+ * of the samples drifts. A slow AGC keeps the standard deviation of the
+ * components at a fixed fraction of the full scale, which is what a
+ * front end with an analog AGC would deliver.
+ *
+ * With 2, 3 or 4 bits, the samples are quantized with the uniform step
+ * of minimum distortion for a Gaussian signal (J. Max, Quantizing for
+ * Minimum Distortion, IRE Trans. Inf. Theory, vol. 6, no. 1, 1960), and
+ * written as the odd values 2 k + 1, as the 2-bit unpackers do.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_SAMPLE_REQUANTIZER_H_
+#define GNSS_SDR_SAMPLE_REQUANTIZER_H_
+
+#include <complex>
+#include <cstdint>
+
+/*!
+ * \brief Scales complex samples with a slow AGC and requantizes them to
+ * bits bits per component, in std::complex<int8_t> or std::complex<int16_t>.
+ *
+ * With more than 4 bits the components are rounded to integers in
+ * [-(2^(bits-1) - 1), 2^(bits-1) - 1], with a standard deviation of
+ * rms_fraction times that full scale. With 2 to 4 bits they are
+ * 2 k + 1, k in [-2^(bits-1), 2^(bits-1) - 1].
+ *
+ * The gain follows the measured level with the time constant
+ * time_constant_samples, in a logarithmic scale, so that a step of the
+ * front end gain settles at the same rate in both directions. A fixed_gain
+ * greater than zero disables the AGC.
+ *
+ * The implementation loss is that of the correlation of the quantized
+ * samples with the input ones, accumulated over all the samples:
+ * -10 log10(E[x q]^2 / (E[x^2] E[q^2])).
+ */
+class Sample_Requantizer
+{
+public:
+    Sample_Requantizer(unsigned int bits, float rms_fraction, double time_constant_samples, float fixed_gain = 0.0);
+    ~Sample_Requantizer();
+
+    void process(const std::complex<float>* in, std::complex<int8_t>* out, unsigned int num_points);
+    void process(const std::complex<float>* in, std::complex<int16_t>* out, unsigned int num_points);
+    void process(const std::complex<int16_t>* in, std::complex<int8_t>* out, unsigned int num_points);
+    void process(const std::complex<int16_t>* in, std::complex<int16_t>* out, unsigned int num_points);
+
+    unsigned int bits() const
+    {
+        return d_bits;
+    }
+
+    //! Output units per input unit
+    float gain() const
+    {
+        return d_gain * d_output_scale;
+    }
+
+    unsigned long long samples() const
+    {
+        return d_samples;
+    }
+
+    //! Components beyond the largest output level
+    unsigned long long clipped_components() const
+    {
+        return d_clipped;
+    }
+
+    //! SNR loss of the requantization, in dB
+    double implementation_loss_db() const;
+
+private:
+    // Scales and quantizes 2 num_points components of in into d_quantized
+    void quantize(const float* in, unsigned int num_points);
+    void reserve(unsigned int num_points);
+
+    unsigned int d_bits;
+    bool d_odd_levels;      // 2 to 4 bits: values 2 k + 1
+    float d_max_level;
+    float d_target_rms;     // standard deviation of the components after the gain, in quantizer steps
+    double d_time_constant;
+    bool d_agc;
+    float d_gain;           // quantizer steps per input unit
+    float d_output_scale;   // output units per quantizer step
+
+    unsigned long long d_samples;
+    unsigned long long d_clipped;
+    double d_sum_xq;
+    double d_sum_xx;
+    double d_sum_qq;
+
+    float* d_float_in;      // 16-bit input converted to float
+    float* d_scaled;
+    float* d_quantized;
+    unsigned int d_capacity;
+};
+
+#endif /* GNSS_SDR_SAMPLE_REQUANTIZER_H_ */
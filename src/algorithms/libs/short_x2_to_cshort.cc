@@ -30,8 +30,10 @@
 
 
 #include "short_x2_to_cshort.h"
+#include "gnss_sdr_trace.h"
 #include <gnuradio/io_signature.h>
 #include <volk/volk.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
 
 
 short_x2_to_cshort_sptr make_short_x2_to_cshort()
@@ -54,19 +56,10 @@ int short_x2_to_cshort::work(int noutput_items,
         gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE("short_x2_to_cshort::work");
     const short *in0 = (const short *) input_items[0];
     const short *in1 = (const short *) input_items[1];
     lv_16sc_t *out = (lv_16sc_t *) output_items[0];
-    // This could be put into a volk kernel
-    short real_part;
-    short imag_part;
-    for(int number = 0; number < noutput_items; number++)
-        {
-            // lv_cmake(r, i) defined at volk/volk_complex.h
-            real_part = *in0++;
-            imag_part = *in1++;
-            *out++ = lv_cmake(real_part, imag_part);
-        }
-
+    volk_gnsssdr_16i_x2_interleave_16ic(out, in0, in1, noutput_items);
     return noutput_items;
 }
@@ -0,0 +1,173 @@
+/* Copyright (C) 2010-2016 (see AUTHORS file for a list of contributors)
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Compares the timings of two JSON files written by
+ * "volk_gnsssdr_profile --timings --json <file>", a stored baseline and a
+ * new run, and flags the timings that got slower than the threshold. The
+ * exit status is 1 if there is any regression, so it can be used in scripts:
+ *
+ *   volk_gnsssdr_compare --baseline baseline.json --current current.json --threshold 0.05
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <boost/foreach.hpp>
+#include <boost/program_options.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+namespace pt = boost::property_tree;
+
+// kernel arch vlen data cache -> statistic [ns]
+typedef std::map<std::string, double> timings_t;
+
+static bool read_timings(const std::string &filename, const std::string &statistic,
+        timings_t &timings, std::string &machine)
+{
+    pt::ptree root;
+    try {
+        pt::read_json(filename, root);
+    }
+    catch (pt::json_parser_error &error) {
+        std::cerr << "Error reading " << filename << ": " << error.what() << std::endl;
+        return false;
+    }
+    if(root.get<int>("schema_version", 1) < 2) {
+        std::cerr << filename << " has no timings: run volk_gnsssdr_profile with --timings" << std::endl;
+        return false;
+    }
+    machine = root.get<std::string>("host", "") + " (" + root.get<std::string>("machine", "") + ")";
+    BOOST_FOREACH(const pt::ptree::value_type &test, root.get_child("volk_gnsssdr_tests")) {
+        const std::string kernel = test.second.get<std::string>("name");
+        BOOST_FOREACH(const pt::ptree::value_type &timing, test.second.get_child("timings")) {
+            const std::string key = kernel + " " + timing.second.get<std::string>("arch")
+                + " " + timing.second.get<std::string>("vlen")
+                + " " + timing.second.get<std::string>("data")
+                + " " + timing.second.get<std::string>("cache");
+            timings[key] = timing.second.get<double>(statistic);
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    boost::program_options::options_description desc("Options");
+    desc.add_options()
+      ("help,h", "Print help messages")
+      ("baseline,b",
+            boost::program_options::value<std::string>(),
+            "JSON output of volk_gnsssdr_profile --timings taken as reference")
+      ("current,c",
+            boost::program_options::value<std::string>(),
+            "JSON output of volk_gnsssdr_profile --timings to be checked")
+      ("threshold,t",
+            boost::program_options::value<float>()->default_value( 0.05 ),
+            "Relative slowdown above which a timing is a regression")
+      ("statistic,s",
+            boost::program_options::value<std::string>()->default_value( "median" ),
+            "Statistic of the trials that is compared: min, median, mean or p90")
+      ("verbose,v",
+            boost::program_options::value<bool>()->default_value( false )
+                                                     ->implicit_value( true ),
+            "Print every timing, not only the regressions and improvements")
+      ;
+
+    boost::program_options::variables_map vm;
+    try {
+        boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+        boost::program_options::notify(vm);
+    }
+    catch (boost::program_options::error& error) {
+        std::cerr << "Error: " << error.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return 2;
+    }
+
+    if ( vm.count("help") || !vm.count("baseline") || !vm.count("current") ) {
+      std::cout << "Compares the timings of two runs of volk_gnsssdr_profile --timings." << std::endl
+                << desc << std::endl;
+      return vm.count("help") ? 0 : 2;
+    }
+
+    const float threshold = vm["threshold"].as<float>();
+    const std::string statistic = vm["statistic"].as<std::string>();
+    const bool verbose = vm["verbose"].as<bool>();
+    if (statistic != "min" && statistic != "median" && statistic != "mean" && statistic != "p90") {
+        std::cerr << "Error: unknown statistic " << statistic << std::endl;
+        return 2;
+    }
+
+    timings_t baseline, current;
+    std::string baseline_machine, current_machine;
+    try {
+        if (!read_timings(vm["baseline"].as<std::string>(), statistic, baseline, baseline_machine) ||
+            !read_timings(vm["current"].as<std::string>(), statistic, current, current_machine)) {
+            return 2;
+        }
+    }
+    catch (pt::ptree_error &error) {
+        std::cerr << "Error: unexpected JSON contents: " << error.what() << std::endl;
+        return 2;
+    }
+    if (baseline_machine != current_machine) {
+        std::cout << "Warning: the baseline is from " << baseline_machine
+                  << " and the current run from " << current_machine << std::endl;
+    }
+
+    unsigned int regressions = 0, improvements = 0, compared = 0;
+    for (timings_t::const_iterator it = baseline.begin(); it != baseline.end(); ++it) {
+        timings_t::const_iterator now = current.find(it->first);
+        if (now == current.end()) {
+            std::cout << "missing     " << it->first << std::endl;
+            continue;
+        }
+        compared++;
+        double change = it->second > 0.0 ? now->second / it->second - 1.0 : 0.0;
+        const char *verdict = "";
+        if (change > threshold) {
+            verdict = "REGRESSION  ";
+            regressions++;
+        }
+        else if (change < -threshold) {
+            verdict = "improvement ";
+            improvements++;
+        }
+        else if (verbose) {
+            verdict = "unchanged   ";
+        }
+        if (*verdict) {
+            std::cout << verdict << it->first << ": " << std::fixed << std::setprecision(1)
+                      << it->second << " -> " << now->second << " ns ("
+                      << std::showpos << 100.0 * change << std::noshowpos << "%)" << std::endl;
+        }
+    }
+    for (timings_t::const_iterator it = current.begin(); it != current.end(); ++it) {
+        if (baseline.find(it->first) == baseline.end()) {
+            std::cout << "new         " << it->first << std::endl;
+        }
+    }
+
+    std::cout << compared << " timings compared (" << statistic << ", threshold "
+              << 100.0 * threshold << "%): " << regressions << " regressions, "
+              << improvements << " improvements" << std::endl;
+    return regressions ? 1 : 0;
+}
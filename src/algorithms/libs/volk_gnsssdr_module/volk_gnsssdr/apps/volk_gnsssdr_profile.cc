@@ -23,9 +23,14 @@
 #include <volk_gnsssdr/volk_gnsssdr.h>
 #include <volk_gnsssdr/volk_gnsssdr_prefs.h>
 
+#include <algorithm>
 #include <ciso646>
+#include <cmath>
+#include <sstream>
 #include <vector>
+#include <boost/asio/ip/host_name.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/program_options.hpp>
 #include <boost/xpressive/xpressive.hpp>
 #include <iostream>
@@ -67,6 +72,16 @@ int main(int argc, char *argv[]) {
       ("json,j",
             boost::program_options::value<std::string>(),
             "JSON output file")
+      ("timings,T",
+            boost::program_options::value<bool>()->default_value( false )
+                                                     ->implicit_value( true ),
+            "Also measure the time per call of every implementation, and write it to the JSON output")
+      ("vlens",
+            boost::program_options::value<std::string>(),
+            "Comma-separated list of vector lengths of the timings (default: vlen)")
+      ("trials",
+            boost::program_options::value<int>()->default_value( 25 ),
+            "Number of trials of each timing")
       ("path,p",
             boost::program_options::value<std::string>(),
             "Specify volk_config path.")
@@ -85,6 +100,9 @@ int main(int argc, char *argv[]) {
     std::string def_kernel_regex;
     bool update_mode = false;
     bool dry_run = false;
+    bool timings_mode = false;
+    std::vector<unsigned int> timing_vlens;
+    unsigned int timing_trials = 0;
     std::string config_file;
 
     // Handle the provided options
@@ -107,6 +125,23 @@ int main(int argc, char *argv[]) {
         def_kernel_regex = kernel_regex;
         update_mode = vm["update"].as<bool>();
         dry_run = vm["dry-run"].as<bool>();
+        timings_mode = vm["timings"].as<bool>();
+        timing_trials = vm["trials"].as<int>();
+        if ( vm.count("vlens") ) {
+            std::stringstream vlens(vm["vlens"].as<std::string>());
+            std::string vlen;
+            while(std::getline(vlens, vlen, ',')) {
+                if(!vlen.empty()) timing_vlens.push_back(boost::lexical_cast<unsigned int>(vlen));
+            }
+        }
+        else {
+            timing_vlens.push_back(def_vlen);
+        }
+    }
+    catch (boost::bad_lexical_cast& error) {
+        std::cerr << "Error: invalid vector length in --vlens" << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return 1;
     }
     catch (boost::program_options::error& error) {
         std::cerr << "Error: " << error.what() << std::endl << std::endl;
@@ -197,6 +232,10 @@ int main(int argc, char *argv[]) {
             try {
             run_volk_gnsssdr_tests(test_case.desc(), test_case.kernel_ptr(), test_case.name(),
                 test_case.test_parameters(), &results, test_case.puppet_master_name());
+            if(timings_mode) {
+                run_volk_gnsssdr_timings(test_case.desc(), test_case.kernel_ptr(), test_case.name(),
+                    test_case.test_parameters(), timing_vlens, timing_trials, &results.back());
+            }
             }
             catch (std::string error) {
                 std::cerr << "Caught Exception in 'run_volk_gnsssdr_tests': " << error << std::endl;
@@ -328,9 +367,45 @@ void write_results(const std::vector<volk_gnsssdr_test_results_t> *results, bool
     config.close();
 }
 
+// Statistics of the time per call, then the time of every trial
+void write_json_timing(std::ofstream &json_file, const volk_gnsssdr_test_timing_t &timing)
+{
+    std::vector<double> ns(timing.ns_per_call);
+    std::sort(ns.begin(), ns.end());
+    size_t n = ns.size();
+    double mean = 0.0;
+    double variance = 0.0;
+    for(size_t i = 0; i < n; i++) mean += ns[i] / n;
+    for(size_t i = 0; i < n; i++) variance += (ns[i] - mean) * (ns[i] - mean) / n;
+    double median = n ? (n % 2 ? ns[n / 2] : (ns[n / 2 - 1] + ns[n / 2]) / 2.0) : 0.0;
+
+    json_file << "    {" << std::endl;
+    json_file << "     \"arch\": \"" << timing.arch << "\"," << std::endl;
+    json_file << "     \"vlen\": " << timing.vlen << "," << std::endl;
+    json_file << "     \"data\": \"" << (timing.aligned_data ? "aligned" : "unaligned") << "\"," << std::endl;
+    json_file << "     \"cache\": \"" << (timing.cold_cache ? "cold" : "warm") << "\"," << std::endl;
+    json_file << "     \"trials\": " << n << "," << std::endl;
+    json_file << "     \"units\": \"ns\"," << std::endl;
+    json_file << "     \"min\": " << (n ? ns.front() : 0.0) << "," << std::endl;
+    json_file << "     \"median\": " << median << "," << std::endl;
+    json_file << "     \"mean\": " << mean << "," << std::endl;
+    json_file << "     \"p90\": " << (n ? ns[static_cast<size_t>(0.9 * (n - 1) + 0.5)] : 0.0) << "," << std::endl;
+    json_file << "     \"max\": " << (n ? ns.back() : 0.0) << "," << std::endl;
+    json_file << "     \"stddev\": " << std::sqrt(variance) << "," << std::endl;
+    json_file << "     \"ns_per_call\": [";
+    for(size_t i = 0; i < timing.ns_per_call.size(); i++) {
+        json_file << (i ? ", " : "") << timing.ns_per_call[i];
+    }
+    json_file << "]" << std::endl;
+    json_file << "    }";
+}
+
 void write_json(std::ofstream &json_file, std::vector<volk_gnsssdr_test_results_t> results)
 {
     json_file << "{" << std::endl;
+    json_file << " \"schema_version\": 2," << std::endl;
+    json_file << " \"machine\": \"" << volk_gnsssdr_get_machine() << "\"," << std::endl;
+    json_file << " \"host\": \"" << boost::asio::ip::host_name() << "\"," << std::endl;
     json_file << " \"volk_gnsssdr_tests\": [" << std::endl;
     size_t len = results.size();
     size_t i = 0;
@@ -362,7 +437,13 @@ void write_json(std::ofstream &json_file, std::vector<volk_gnsssdr_test_results_
             json_file << std::endl;
             ri++;
         }
-        json_file << "   }" << std::endl;
+        json_file << "   }," << std::endl;
+        json_file << "   \"timings\": [" << std::endl;
+        for(size_t ti = 0; ti < result->timings.size(); ti++) {
+            write_json_timing(json_file, result->timings[ti]);
+            json_file << (ti + 1 != result->timings.size() ? "," : "") << std::endl;
+        }
+        json_file << "   ]" << std::endl;
         json_file << "  }";
         if(i+1 != len) {
             json_file << ",";
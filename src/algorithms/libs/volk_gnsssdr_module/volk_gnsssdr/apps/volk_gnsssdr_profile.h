@@ -33,4 +33,5 @@ void read_results(std::vector<volk_gnsssdr_test_results_t> *results);
 void read_results(std::vector<volk_gnsssdr_test_results_t> *results, std::string path);
 void write_results(const std::vector<volk_gnsssdr_test_results_t> *results, bool update_result);
 void write_results(const std::vector<volk_gnsssdr_test_results_t> *results, bool update_result, const std::string path);
+void write_json_timing(std::ofstream &json_file, const volk_gnsssdr_test_timing_t &timing);
 void write_json(std::ofstream &json_file, std::vector<volk_gnsssdr_test_results_t> results);
@@ -26,6 +26,7 @@
 #define INCLUDED_VOLK_GNSSSDR_SATURATION_ARITHMETIC_H_
 
 #include <limits.h>
+#include <math.h>
 
 static inline int16_t sat_adds16i(int16_t x, int16_t y)
 {
@@ -47,4 +48,23 @@ static inline int16_t sat_muls16i(int16_t x, int16_t y)
     return res;
 }
 
+/* Saturates to [-SHRT_MAX, SHRT_MAX]. Leaving SHRT_MIN out, the sum of two
+ * products of 16-bit integers (a complex multiplication) always fits in 32 bits */
+static inline int16_t sat_syms16i(int16_t x)
+{
+    if (x < -SHRT_MAX) return -SHRT_MAX;
+    return x;
+}
+
+/* Rounds to the nearest integer and saturates to [-SHRT_MAX, SHRT_MAX] */
+static inline int16_t sat_rounds16i(float x)
+{
+    float res = rintf(x);
+
+    if (res < -SHRT_MAX) res = -SHRT_MAX;
+    if (res > SHRT_MAX) res = SHRT_MAX;
+
+    return (int16_t) res;
+}
+
 #endif /* INCLUDED_VOLK_GNSSSDR_SATURATION_ARITHMETIC_H_ */
@@ -0,0 +1,85 @@
+/*!
+ * \file volk_gnsssdr_huge_allocator.h
+ * \brief C++ allocator on top of volk_gnsssdr_malloc_huge, for containers of
+ * large DSP buffers.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Copyright (C) 2010-2016 (see AUTHORS file for a list of contributors)
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INCLUDED_VOLK_GNSSSDR_HUGE_ALLOCATOR_H
+#define INCLUDED_VOLK_GNSSSDR_HUGE_ALLOCATOR_H
+
+#include <volk_gnsssdr/volk_gnsssdr_malloc.h>
+#include <cstddef>
+#include <new>
+
+/*!
+ * \brief Allocator of aligned memory, on huge pages for the allocations of
+ * 2 MiB or more (see volk_gnsssdr_malloc_huge), e.g.
+ * std::vector<float, volk_gnsssdr_huge_allocator<float> >.
+ *
+ * \details The alignment is \p Alignment bytes, enough for the widest
+ * SIMD kernels by default.
+ */
+template <typename T, std::size_t Alignment = 64>
+class volk_gnsssdr_huge_allocator
+{
+public:
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef volk_gnsssdr_huge_allocator<U, Alignment> other;
+    };
+
+    volk_gnsssdr_huge_allocator() {}
+
+    template <typename U>
+    volk_gnsssdr_huge_allocator(const volk_gnsssdr_huge_allocator<U, Alignment>&) {}
+
+    T* allocate(std::size_t n)
+    {
+        void* p = volk_gnsssdr_malloc_huge(n * sizeof(T), Alignment);
+        if (p == NULL)
+            {
+                throw std::bad_alloc();
+            }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, std::size_t)
+    {
+        volk_gnsssdr_free_huge(p);
+    }
+};
+
+template <typename T, typename U, std::size_t Alignment>
+bool operator==(const volk_gnsssdr_huge_allocator<T, Alignment>&, const volk_gnsssdr_huge_allocator<U, Alignment>&)
+{
+    return true;
+}
+
+template <typename T, typename U, std::size_t Alignment>
+bool operator!=(const volk_gnsssdr_huge_allocator<T, Alignment>&, const volk_gnsssdr_huge_allocator<U, Alignment>&)
+{
+    return false;
+}
+
+#endif /* INCLUDED_VOLK_GNSSSDR_HUGE_ALLOCATOR_H */
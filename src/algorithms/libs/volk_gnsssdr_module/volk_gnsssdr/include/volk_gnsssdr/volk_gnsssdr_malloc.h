@@ -63,6 +63,53 @@ VOLK_API void *volk_gnsssdr_malloc(size_t size, size_t alignment);
  */
 VOLK_API void volk_gnsssdr_free(void *aptr);
 
+/*!
+ * \brief Allocate \p size bytes of data aligned to \p alignment, on huge
+ * pages when possible.
+ *
+ * \details
+ * Large buffers that are swept at every call, such as acquisition grids
+ * or sample rings, touch a new 4 KiB page every few hundred samples, and
+ * miss the TLB as often. Buffers of at least 2 MiB are mapped, in this
+ * order of preference:
+ *
+ * - on 1 GiB pages, if they take at least 1 GiB, or on 2 MiB pages, from
+ *   the pool of huge pages reserved by the administrator (vm.nr_hugepages);
+ *
+ * - on anonymous memory aligned to 2 MiB, which the kernel backs with
+ *   transparent huge pages if they are enabled (madvise or always);
+ *
+ * - as volk_gnsssdr_malloc does.
+ *
+ * Smaller buffers, and all of them if volk_gnsssdr_set_huge_pages(0) was
+ * called, take the last path. The memory must be freed with
+ * volk_gnsssdr_free_huge.
+ *
+ * \param size The number of bytes to allocate.
+ * \param alignment The byte alignment of the allocated memory.
+ * \return pointer to aligned memory.
+ */
+VOLK_API void *volk_gnsssdr_malloc_huge(size_t size, size_t alignment);
+
+/*!
+ * \brief Free's memory allocated by volk_gnsssdr_malloc_huge.
+ * \param aptr The aligned pointer allocated by volk_gnsssdr_malloc_huge.
+ */
+VOLK_API void volk_gnsssdr_free_huge(void *aptr);
+
+/*!
+ * \brief Enables (by default) or disables the huge pages of
+ * volk_gnsssdr_malloc_huge, for the allocations that follow.
+ */
+VOLK_API void volk_gnsssdr_set_huge_pages(int enabled);
+
+/*!
+ * \brief Bytes allocated by volk_gnsssdr_malloc_huge that are currently
+ * mapped on reserved huge pages (\p reserved) or eligible for transparent
+ * huge pages (\p transparent). Either pointer may be NULL.
+ */
+VOLK_API void volk_gnsssdr_huge_pages_usage(size_t *reserved, size_t *transparent);
+
 __VOLK_DECL_END
 
 #endif /* INCLUDED_VOLK_MALLOC_H */
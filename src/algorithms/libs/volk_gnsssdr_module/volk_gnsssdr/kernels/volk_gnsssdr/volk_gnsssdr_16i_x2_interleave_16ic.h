@@ -0,0 +1,239 @@
+/*!
+ * \file volk_gnsssdr_16i_x2_interleave_16ic.h
+ * \brief VOLK_GNSSSDR kernel: interleaves two 16-bit integer vectors into a complex vector.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * VOLK_GNSSSDR kernel that takes the real parts from one 16-bit integer
+ * vector and the imaginary parts from another, and interleaves them into
+ * a complex 16-bit integer vector.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+/*!
+ * \page volk_gnsssdr_16i_x2_interleave_16ic
+ *
+ * \b Overview
+ *
+ * cVector[i] = lv_cmake(aVector[i], bVector[i])
+ *
+ * <b>Dispatcher Prototype</b>
+ * \code
+ * void volk_gnsssdr_16i_x2_interleave_16ic(lv_16sc_t* cVector, const int16_t* aVector, const int16_t* bVector, unsigned int num_points)
+ * \endcode
+ *
+ * \b Inputs
+ * \li aVector: The real parts.
+ * \li bVector: The imaginary parts.
+ * \li num_points: The number of values in \p aVector and \p bVector.
+ *
+ * \b Outputs
+ * \li cVector: The complex output vector.
+ *
+ */
+
+#ifndef INCLUDED_volk_gnsssdr_16i_x2_interleave_16ic_H
+#define INCLUDED_volk_gnsssdr_16i_x2_interleave_16ic_H
+
+#include <volk_gnsssdr/volk_gnsssdr_complex.h>
+
+
+#ifdef LV_HAVE_GENERIC
+
+static inline void volk_gnsssdr_16i_x2_interleave_16ic_generic(lv_16sc_t* cVector, const int16_t* aVector, const int16_t* bVector, unsigned int num_points)
+{
+    unsigned int number;
+    for(number = 0; number < num_points; number++)
+        {
+            cVector[number] = lv_cmake(aVector[number], bVector[number]);
+        }
+}
+#endif /* LV_HAVE_GENERIC */
+
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+
+static inline void volk_gnsssdr_16i_x2_interleave_16ic_u_sse2(lv_16sc_t* cVector, const int16_t* aVector, const int16_t* bVector, unsigned int num_points)
+{
+    const unsigned int sse_iters = num_points / 8;
+    unsigned int number;
+    unsigned int i;
+    lv_16sc_t* cPtr = cVector;
+    const int16_t* aPtr = aVector;
+    const int16_t* bPtr = bVector;
+    __m128i aVal, bVal;
+
+    for(number = 0; number < sse_iters; number++)
+        {
+            aVal = _mm_loadu_si128((__m128i*)aPtr);
+            bVal = _mm_loadu_si128((__m128i*)bPtr);
+            _mm_storeu_si128((__m128i*)cPtr, _mm_unpacklo_epi16(aVal, bVal));
+            _mm_storeu_si128((__m128i*)(cPtr + 4), _mm_unpackhi_epi16(aVal, bVal));
+            aPtr += 8;
+            bPtr += 8;
+            cPtr += 8;
+        }
+    for(i = sse_iters * 8; i < num_points; ++i)
+        {
+            *cPtr++ = lv_cmake(*aPtr++, *bPtr++);
+        }
+}
+#endif /* LV_HAVE_SSE2 */
+
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+
+static inline void volk_gnsssdr_16i_x2_interleave_16ic_a_sse2(lv_16sc_t* cVector, const int16_t* aVector, const int16_t* bVector, unsigned int num_points)
+{
+    const unsigned int sse_iters = num_points / 8;
+    unsigned int number;
+    unsigned int i;
+    lv_16sc_t* cPtr = cVector;
+    const int16_t* aPtr = aVector;
+    const int16_t* bPtr = bVector;
+    __m128i aVal, bVal;
+
+    for(number = 0; number < sse_iters; number++)
+        {
+            aVal = _mm_load_si128((__m128i*)aPtr);
+            bVal = _mm_load_si128((__m128i*)bPtr);
+            _mm_store_si128((__m128i*)cPtr, _mm_unpacklo_epi16(aVal, bVal));
+            _mm_store_si128((__m128i*)(cPtr + 4), _mm_unpackhi_epi16(aVal, bVal));
+            aPtr += 8;
+            bPtr += 8;
+            cPtr += 8;
+        }
+    for(i = sse_iters * 8; i < num_points; ++i)
+        {
+            *cPtr++ = lv_cmake(*aPtr++, *bPtr++);
+        }
+}
+#endif /* LV_HAVE_SSE2 */
+
+
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_16i_x2_interleave_16ic_u_avx2(lv_16sc_t* cVector, const int16_t* aVector, const int16_t* bVector, unsigned int num_points)
+{
+    const unsigned int avx_iters = num_points / 16;
+    unsigned int number;
+    unsigned int i;
+    lv_16sc_t* cPtr = cVector;
+    const int16_t* aPtr = aVector;
+    const int16_t* bPtr = bVector;
+    __m256i aVal, bVal, lo, hi;
+
+    for(number = 0; number < avx_iters; number++)
+        {
+            aVal = _mm256_loadu_si256((__m256i*)aPtr);
+            bVal = _mm256_loadu_si256((__m256i*)bPtr);
+            // unpack works within each 128-bit lane: put the lanes back in order
+            lo = _mm256_unpacklo_epi16(aVal, bVal);
+            hi = _mm256_unpackhi_epi16(aVal, bVal);
+            _mm256_storeu_si256((__m256i*)cPtr, _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256((__m256i*)(cPtr + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+            aPtr += 16;
+            bPtr += 16;
+            cPtr += 16;
+        }
+    _mm256_zeroupper();
+    for(i = avx_iters * 16; i < num_points; ++i)
+        {
+            *cPtr++ = lv_cmake(*aPtr++, *bPtr++);
+        }
+}
+#endif /* LV_HAVE_AVX2 */
+
+
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_16i_x2_interleave_16ic_a_avx2(lv_16sc_t* cVector, const int16_t* aVector, const int16_t* bVector, unsigned int num_points)
+{
+    const unsigned int avx_iters = num_points / 16;
+    unsigned int number;
+    unsigned int i;
+    lv_16sc_t* cPtr = cVector;
+    const int16_t* aPtr = aVector;
+    const int16_t* bPtr = bVector;
+    __m256i aVal, bVal, lo, hi;
+
+    for(number = 0; number < avx_iters; number++)
+        {
+            aVal = _mm256_load_si256((__m256i*)aPtr);
+            bVal = _mm256_load_si256((__m256i*)bPtr);
+            // unpack works within each 128-bit lane: put the lanes back in order
+            lo = _mm256_unpacklo_epi16(aVal, bVal);
+            hi = _mm256_unpackhi_epi16(aVal, bVal);
+            _mm256_store_si256((__m256i*)cPtr, _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_store_si256((__m256i*)(cPtr + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+            aPtr += 16;
+            bPtr += 16;
+            cPtr += 16;
+        }
+    _mm256_zeroupper();
+    for(i = avx_iters * 16; i < num_points; ++i)
+        {
+            *cPtr++ = lv_cmake(*aPtr++, *bPtr++);
+        }
+}
+#endif /* LV_HAVE_AVX2 */
+
+
+#ifdef LV_HAVE_NEON
+#include <arm_neon.h>
+
+static inline void volk_gnsssdr_16i_x2_interleave_16ic_neon(lv_16sc_t* cVector, const int16_t* aVector, const int16_t* bVector, unsigned int num_points)
+{
+    const unsigned int neon_iters = num_points / 8;
+    unsigned int number;
+    unsigned int i;
+    lv_16sc_t* cPtr = cVector;
+    const int16_t* aPtr = aVector;
+    const int16_t* bPtr = bVector;
+    int16x8x2_t c;
+
+    for(number = 0; number < neon_iters; number++)
+        {
+            c.val[0] = vld1q_s16((const int16_t*)aPtr);
+            c.val[1] = vld1q_s16((const int16_t*)bPtr);
+            __builtin_prefetch(aPtr + 8);
+            __builtin_prefetch(bPtr + 8);
+            vst2q_s16((int16_t*)cPtr, c);
+            aPtr += 8;
+            bPtr += 8;
+            cPtr += 8;
+        }
+    for(i = neon_iters * 8; i < num_points; ++i)
+        {
+            *cPtr++ = lv_cmake(*aPtr++, *bPtr++);
+        }
+}
+#endif /* LV_HAVE_NEON */
+
+#endif /* INCLUDED_volk_gnsssdr_16i_x2_interleave_16ic_H */
@@ -0,0 +1,462 @@
+/*!
+ * \file volk_gnsssdr_16ic_x2_dot_prod_32fc_xn.h
+ * \brief VOLK_GNSSSDR kernel: multiplies N 16 bits vectors by a common vector and accumulates the results in N 32 bits float complex outputs.
+ * \authors <ul>
+ *          <li> GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *          </ul>
+ *
+ * VOLK_GNSSSDR kernel that multiplies N 16 bits vectors by a common vector and accumulates the results
+ * without saturation in N 32 bits float complex outputs.
+ * It is optimized to perform the N tap correlation process in GNSS receivers with long coherent integration times.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+/*!
+ * \page volk_gnsssdr_16ic_x2_dot_prod_32fc_xn
+ *
+ * \b Overview
+ *
+ * Multiplies a reference complex vector by an arbitrary number of other complex vectors, accumulates the results and stores them in the output vector.
+ * This function can be used as a multiple correlator.
+ *
+ * Unlike volk_gnsssdr_16ic_x2_dot_prod_16ic_xn, the products are accumulated in 64 bits integers,
+ * so the result does not saturate and is the same for all the implementations.
+ * The components of \p in_common equal to -32768 are taken as -32767.
+ *
+ * <b>Dispatcher Prototype</b>
+ * \code
+ * void volk_gnsssdr_16ic_x2_dot_prod_32fc_xn(lv_32fc_t* result, const lv_16sc_t* in_common, const lv_16sc_t** in_a, int num_a_vectors, unsigned int num_points);
+ * \endcode
+ *
+ * \b Inputs
+ * \li in_common:     Pointer to one of the vectors to be multiplied and accumulated (reference vector)
+ * \li in_a:          Pointer to an array of pointers to other vectors to be multiplied by \p in_common and accumulated.
+ * \li num_a_vectors: Number of vectors to be multiplied by the reference vector \p in_common and accumulated.
+ * \li num_points:    Number of complex values to be multiplied together, accumulated and stored into \p result
+ *
+ * \b Outputs
+ * \li result:        Vector of \p num_a_vectors components with vector \p in_common multiplied by the vectors in \p in_a and accumulated.
+ *
+ */
+
+#ifndef INCLUDED_volk_gnsssdr_16ic_x2_dot_prod_32fc_xn_H
+#define INCLUDED_volk_gnsssdr_16ic_x2_dot_prod_32fc_xn_H
+
+
+#include <volk_gnsssdr/volk_gnsssdr_complex.h>
+#include <volk_gnsssdr/volk_gnsssdr_malloc.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+#include <volk_gnsssdr/saturation_arithmetic.h>
+#include <stdint.h>
+
+#ifdef LV_HAVE_GENERIC
+
+static inline void volk_gnsssdr_16ic_x2_dot_prod_32fc_xn_generic(lv_32fc_t* result, const lv_16sc_t* in_common, const lv_16sc_t** in_a, int num_a_vectors, unsigned int num_points)
+{
+    int n_vec;
+    unsigned int n;
+    int64_t real_acc, imag_acc;
+    int32_t common_real, common_imag;
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            real_acc = 0;
+            imag_acc = 0;
+            for (n = 0; n < num_points; n++)
+                {
+                    common_real = sat_syms16i(lv_creal(in_common[n]));
+                    common_imag = sat_syms16i(lv_cimag(in_common[n]));
+                    real_acc += common_real * lv_creal(in_a[n_vec][n]) - common_imag * lv_cimag(in_a[n_vec][n]);
+                    imag_acc += common_real * lv_cimag(in_a[n_vec][n]) + common_imag * lv_creal(in_a[n_vec][n]);
+                }
+            result[n_vec] = lv_cmake((float)real_acc, (float)imag_acc);
+        }
+}
+
+#endif /*LV_HAVE_GENERIC*/
+
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+
+static inline void volk_gnsssdr_16ic_x2_dot_prod_32fc_xn_a_sse2(lv_32fc_t* result, const lv_16sc_t* in_common, const lv_16sc_t** in_a, int num_a_vectors, unsigned int num_points)
+{
+    int n_vec;
+    unsigned int index;
+    const unsigned int sse_iters = num_points / 4;
+
+    const lv_16sc_t** _in_a = in_a;
+    const lv_16sc_t* _in_common = in_common;
+    __VOLK_ATTR_ALIGNED(16) int64_t acc_vector[2];
+    int64_t real_acc, imag_acc;
+    int32_t common_real, common_imag;
+
+    __m128i* realcacc = (__m128i*)volk_gnsssdr_malloc(num_a_vectors * sizeof(__m128i), volk_gnsssdr_get_alignment());
+    __m128i* imagcacc = (__m128i*)volk_gnsssdr_malloc(num_a_vectors * sizeof(__m128i), volk_gnsssdr_get_alignment());
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            realcacc[n_vec] = _mm_setzero_si128();
+            imagcacc[n_vec] = _mm_setzero_si128();
+        }
+
+    __m128i a, b, b_conj, b_swap, real, imag, sign;
+
+    const __m128i mask_imag = _mm_set_epi8(255, 255, 0, 0, 255, 255, 0, 0, 255, 255, 0, 0, 255, 255, 0, 0);
+    const __m128i min_sample = _mm_set1_epi16(-32767);
+
+    for(index = 0; index < sse_iters; index++)
+        {
+            // b[127:0]=[b3.i,b3.r,b2.i,b2.r,b1.i,b1.r,b0.i,b0.r], saturated to [-32767, 32767] so the 32 bits sums of products below cannot overflow
+            b = _mm_max_epi16(_mm_load_si128((__m128i*)_in_common), min_sample); //load (2 byte imag, 2 byte real) x 4 into 128 bits reg
+            __builtin_prefetch(_in_common + 8);
+            b_conj = _mm_sub_epi16(_mm_xor_si128(b, mask_imag), mask_imag); // b3.r,-b3.i, ...
+            b_swap = _mm_shufflehi_epi16(_mm_shufflelo_epi16(b, 0xB1), 0xB1); // b3.i,b3.r, ...
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    a = _mm_load_si128((__m128i*)&(_in_a[n_vec][index*4])); //load (2 byte imag, 2 byte real) x 4 into 128 bits reg
+
+                    real = _mm_madd_epi16(a, b_conj); // a3.r*b3.r-a3.i*b3.i, ... in 32 bits
+                    imag = _mm_madd_epi16(a, b_swap); // a3.r*b3.i+a3.i*b3.r, ... in 32 bits
+
+                    // sign-extend to 64 bits and accumulate
+                    sign = _mm_srai_epi32(real, 31);
+                    realcacc[n_vec] = _mm_add_epi64(realcacc[n_vec], _mm_add_epi64(_mm_unpacklo_epi32(real, sign), _mm_unpackhi_epi32(real, sign)));
+                    sign = _mm_srai_epi32(imag, 31);
+                    imagcacc[n_vec] = _mm_add_epi64(imagcacc[n_vec], _mm_add_epi64(_mm_unpacklo_epi32(imag, sign), _mm_unpackhi_epi32(imag, sign)));
+                }
+            _in_common += 4;
+        }
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            _mm_store_si128((__m128i*)acc_vector, realcacc[n_vec]);
+            real_acc = acc_vector[0] + acc_vector[1];
+            _mm_store_si128((__m128i*)acc_vector, imagcacc[n_vec]);
+            imag_acc = acc_vector[0] + acc_vector[1];
+            for(index = sse_iters * 4; index < num_points; index++)
+                {
+                    common_real = sat_syms16i(lv_creal(in_common[index]));
+                    common_imag = sat_syms16i(lv_cimag(in_common[index]));
+                    real_acc += common_real * lv_creal(in_a[n_vec][index]) - common_imag * lv_cimag(in_a[n_vec][index]);
+                    imag_acc += common_real * lv_cimag(in_a[n_vec][index]) + common_imag * lv_creal(in_a[n_vec][index]);
+                }
+            result[n_vec] = lv_cmake((float)real_acc, (float)imag_acc);
+        }
+    volk_gnsssdr_free(realcacc);
+    volk_gnsssdr_free(imagcacc);
+}
+#endif /* LV_HAVE_SSE2 */
+
+
+#ifdef LV_HAVE_SSE2
+
+static inline void volk_gnsssdr_16ic_x2_dot_prod_32fc_xn_u_sse2(lv_32fc_t* result, const lv_16sc_t* in_common, const lv_16sc_t** in_a, int num_a_vectors, unsigned int num_points)
+{
+    int n_vec;
+    unsigned int index;
+    const unsigned int sse_iters = num_points / 4;
+
+    const lv_16sc_t** _in_a = in_a;
+    const lv_16sc_t* _in_common = in_common;
+    __VOLK_ATTR_ALIGNED(16) int64_t acc_vector[2];
+    int64_t real_acc, imag_acc;
+    int32_t common_real, common_imag;
+
+    __m128i* realcacc = (__m128i*)volk_gnsssdr_malloc(num_a_vectors * sizeof(__m128i), volk_gnsssdr_get_alignment());
+    __m128i* imagcacc = (__m128i*)volk_gnsssdr_malloc(num_a_vectors * sizeof(__m128i), volk_gnsssdr_get_alignment());
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            realcacc[n_vec] = _mm_setzero_si128();
+            imagcacc[n_vec] = _mm_setzero_si128();
+        }
+
+    __m128i a, b, b_conj, b_swap, real, imag, sign;
+
+    const __m128i mask_imag = _mm_set_epi8(255, 255, 0, 0, 255, 255, 0, 0, 255, 255, 0, 0, 255, 255, 0, 0);
+    const __m128i min_sample = _mm_set1_epi16(-32767);
+
+    for(index = 0; index < sse_iters; index++)
+        {
+            // b[127:0]=[b3.i,b3.r,b2.i,b2.r,b1.i,b1.r,b0.i,b0.r], saturated to [-32767, 32767] so the 32 bits sums of products below cannot overflow
+            b = _mm_max_epi16(_mm_loadu_si128((__m128i*)_in_common), min_sample); //load (2 byte imag, 2 byte real) x 4 into 128 bits reg
+            __builtin_prefetch(_in_common + 8);
+            b_conj = _mm_sub_epi16(_mm_xor_si128(b, mask_imag), mask_imag); // b3.r,-b3.i, ...
+            b_swap = _mm_shufflehi_epi16(_mm_shufflelo_epi16(b, 0xB1), 0xB1); // b3.i,b3.r, ...
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    a = _mm_loadu_si128((__m128i*)&(_in_a[n_vec][index*4])); //load (2 byte imag, 2 byte real) x 4 into 128 bits reg
+
+                    real = _mm_madd_epi16(a, b_conj); // a3.r*b3.r-a3.i*b3.i, ... in 32 bits
+                    imag = _mm_madd_epi16(a, b_swap); // a3.r*b3.i+a3.i*b3.r, ... in 32 bits
+
+                    // sign-extend to 64 bits and accumulate
+                    sign = _mm_srai_epi32(real, 31);
+                    realcacc[n_vec] = _mm_add_epi64(realcacc[n_vec], _mm_add_epi64(_mm_unpacklo_epi32(real, sign), _mm_unpackhi_epi32(real, sign)));
+                    sign = _mm_srai_epi32(imag, 31);
+                    imagcacc[n_vec] = _mm_add_epi64(imagcacc[n_vec], _mm_add_epi64(_mm_unpacklo_epi32(imag, sign), _mm_unpackhi_epi32(imag, sign)));
+                }
+            _in_common += 4;
+        }
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            _mm_store_si128((__m128i*)acc_vector, realcacc[n_vec]);
+            real_acc = acc_vector[0] + acc_vector[1];
+            _mm_store_si128((__m128i*)acc_vector, imagcacc[n_vec]);
+            imag_acc = acc_vector[0] + acc_vector[1];
+            for(index = sse_iters * 4; index < num_points; index++)
+                {
+                    common_real = sat_syms16i(lv_creal(in_common[index]));
+                    common_imag = sat_syms16i(lv_cimag(in_common[index]));
+                    real_acc += common_real * lv_creal(in_a[n_vec][index]) - common_imag * lv_cimag(in_a[n_vec][index]);
+                    imag_acc += common_real * lv_cimag(in_a[n_vec][index]) + common_imag * lv_creal(in_a[n_vec][index]);
+                }
+            result[n_vec] = lv_cmake((float)real_acc, (float)imag_acc);
+        }
+    volk_gnsssdr_free(realcacc);
+    volk_gnsssdr_free(imagcacc);
+}
+#endif /* LV_HAVE_SSE2 */
+
+
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_16ic_x2_dot_prod_32fc_xn_a_avx2(lv_32fc_t* result, const lv_16sc_t* in_common, const lv_16sc_t** in_a, int num_a_vectors, unsigned int num_points)
+{
+    int n_vec;
+    unsigned int index;
+    const unsigned int avx2_iters = num_points / 8;
+
+    const lv_16sc_t** _in_a = in_a;
+    const lv_16sc_t* _in_common = in_common;
+    __VOLK_ATTR_ALIGNED(32) int64_t acc_vector[4];
+    int64_t real_acc, imag_acc;
+    int32_t common_real, common_imag;
+
+    __m256i* realcacc = (__m256i*)volk_gnsssdr_malloc(num_a_vectors * sizeof(__m256i), volk_gnsssdr_get_alignment());
+    __m256i* imagcacc = (__m256i*)volk_gnsssdr_malloc(num_a_vectors * sizeof(__m256i), volk_gnsssdr_get_alignment());
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            realcacc[n_vec] = _mm256_setzero_si256();
+            imagcacc[n_vec] = _mm256_setzero_si256();
+        }
+
+    __m256i a, b, b_conj, b_swap, real, imag, sign;
+
+    const __m256i mask_imag = _mm256_set_epi8(255, 255, 0, 0, 255, 255, 0, 0, 255, 255, 0, 0, 255, 255, 0, 0, 255, 255, 0, 0, 255, 255, 0, 0, 255, 255, 0, 0, 255, 255, 0, 0);
+    const __m256i min_sample = _mm256_set1_epi16(-32767);
+
+    for(index = 0; index < avx2_iters; index++)
+        {
+            // b[255:0]=[b7.i,b7.r, ... ,b0.i,b0.r], saturated to [-32767, 32767] so the 32 bits sums of products below cannot overflow
+            b = _mm256_max_epi16(_mm256_load_si256((__m256i*)_in_common), min_sample); //load (2 byte imag, 2 byte real) x 8 into 256 bits reg
+            __builtin_prefetch(_in_common + 16);
+            b_conj = _mm256_sub_epi16(_mm256_xor_si256(b, mask_imag), mask_imag); // b7.r,-b7.i, ...
+            b_swap = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(b, 0xB1), 0xB1); // b7.i,b7.r, ...
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    a = _mm256_load_si256((__m256i*)&(_in_a[n_vec][index*8])); //load (2 byte imag, 2 byte real) x 8 into 256 bits reg
+
+                    real = _mm256_madd_epi16(a, b_conj); // a7.r*b7.r-a7.i*b7.i, ... in 32 bits
+                    imag = _mm256_madd_epi16(a, b_swap); // a7.r*b7.i+a7.i*b7.r, ... in 32 bits
+
+                    // sign-extend to 64 bits and accumulate
+                    sign = _mm256_srai_epi32(real, 31);
+                    realcacc[n_vec] = _mm256_add_epi64(realcacc[n_vec], _mm256_add_epi64(_mm256_unpacklo_epi32(real, sign), _mm256_unpackhi_epi32(real, sign)));
+                    sign = _mm256_srai_epi32(imag, 31);
+                    imagcacc[n_vec] = _mm256_add_epi64(imagcacc[n_vec], _mm256_add_epi64(_mm256_unpacklo_epi32(imag, sign), _mm256_unpackhi_epi32(imag, sign)));
+                }
+            _in_common += 8;
+        }
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            _mm256_store_si256((__m256i*)acc_vector, realcacc[n_vec]);
+            real_acc = acc_vector[0] + acc_vector[1] + acc_vector[2] + acc_vector[3];
+            _mm256_store_si256((__m256i*)acc_vector, imagcacc[n_vec]);
+            imag_acc = acc_vector[0] + acc_vector[1] + acc_vector[2] + acc_vector[3];
+            for(index = avx2_iters * 8; index < num_points; index++)
+                {
+                    common_real = sat_syms16i(lv_creal(in_common[index]));
+                    common_imag = sat_syms16i(lv_cimag(in_common[index]));
+                    real_acc += common_real * lv_creal(in_a[n_vec][index]) - common_imag * lv_cimag(in_a[n_vec][index]);
+                    imag_acc += common_real * lv_cimag(in_a[n_vec][index]) + common_imag * lv_creal(in_a[n_vec][index]);
+                }
+            result[n_vec] = lv_cmake((float)real_acc, (float)imag_acc);
+        }
+    volk_gnsssdr_free(realcacc);
+    volk_gnsssdr_free(imagcacc);
+    _mm256_zeroupper();
+}
+#endif /* LV_HAVE_AVX2 */
+
+
+#ifdef LV_HAVE_AVX2
+
+static inline void volk_gnsssdr_16ic_x2_dot_prod_32fc_xn_u_avx2(lv_32fc_t* result, const lv_16sc_t* in_common, const lv_16sc_t** in_a, int num_a_vectors, unsigned int num_points)
+{
+    int n_vec;
+    unsigned int index;
+    const unsigned int avx2_iters = num_points / 8;
+
+    const lv_16sc_t** _in_a = in_a;
+    const lv_16sc_t* _in_common = in_common;
+    __VOLK_ATTR_ALIGNED(32) int64_t acc_vector[4];
+    int64_t real_acc, imag_acc;
+    int32_t common_real, common_imag;
+
+    __m256i* realcacc = (__m256i*)volk_gnsssdr_malloc(num_a_vectors * sizeof(__m256i), volk_gnsssdr_get_alignment());
+    __m256i* imagcacc = (__m256i*)volk_gnsssdr_malloc(num_a_vectors * sizeof(__m256i), volk_gnsssdr_get_alignment());
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            realcacc[n_vec] = _mm256_setzero_si256();
+            imagcacc[n_vec] = _mm256_setzero_si256();
+        }
+
+    __m256i a, b, b_conj, b_swap, real, imag, sign;
+
+    const __m256i mask_imag = _mm256_set_epi8(255, 255, 0, 0, 255, 255, 0, 0, 255, 255, 0, 0, 255, 255, 0, 0, 255, 255, 0, 0, 255, 255, 0, 0, 255, 255, 0, 0, 255, 255, 0, 0);
+    const __m256i min_sample = _mm256_set1_epi16(-32767);
+
+    for(index = 0; index < avx2_iters; index++)
+        {
+            // b[255:0]=[b7.i,b7.r, ... ,b0.i,b0.r], saturated to [-32767, 32767] so the 32 bits sums of products below cannot overflow
+            b = _mm256_max_epi16(_mm256_loadu_si256((__m256i*)_in_common), min_sample); //load (2 byte imag, 2 byte real) x 8 into 256 bits reg
+            __builtin_prefetch(_in_common + 16);
+            b_conj = _mm256_sub_epi16(_mm256_xor_si256(b, mask_imag), mask_imag); // b7.r,-b7.i, ...
+            b_swap = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(b, 0xB1), 0xB1); // b7.i,b7.r, ...
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    a = _mm256_loadu_si256((__m256i*)&(_in_a[n_vec][index*8])); //load (2 byte imag, 2 byte real) x 8 into 256 bits reg
+
+                    real = _mm256_madd_epi16(a, b_conj); // a7.r*b7.r-a7.i*b7.i, ... in 32 bits
+                    imag = _mm256_madd_epi16(a, b_swap); // a7.r*b7.i+a7.i*b7.r, ... in 32 bits
+
+                    // sign-extend to 64 bits and accumulate
+                    sign = _mm256_srai_epi32(real, 31);
+                    realcacc[n_vec] = _mm256_add_epi64(realcacc[n_vec], _mm256_add_epi64(_mm256_unpacklo_epi32(real, sign), _mm256_unpackhi_epi32(real, sign)));
+                    sign = _mm256_srai_epi32(imag, 31);
+                    imagcacc[n_vec] = _mm256_add_epi64(imagcacc[n_vec], _mm256_add_epi64(_mm256_unpacklo_epi32(imag, sign), _mm256_unpackhi_epi32(imag, sign)));
+                }
+            _in_common += 8;
+        }
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            _mm256_store_si256((__m256i*)acc_vector, realcacc[n_vec]);
+            real_acc = acc_vector[0] + acc_vector[1] + acc_vector[2] + acc_vector[3];
+            _mm256_store_si256((__m256i*)acc_vector, imagcacc[n_vec]);
+            imag_acc = acc_vector[0] + acc_vector[1] + acc_vector[2] + acc_vector[3];
+            for(index = avx2_iters * 8; index < num_points; index++)
+                {
+                    common_real = sat_syms16i(lv_creal(in_common[index]));
+                    common_imag = sat_syms16i(lv_cimag(in_common[index]));
+                    real_acc += common_real * lv_creal(in_a[n_vec][index]) - common_imag * lv_cimag(in_a[n_vec][index]);
+                    imag_acc += common_real * lv_cimag(in_a[n_vec][index]) + common_imag * lv_creal(in_a[n_vec][index]);
+                }
+            result[n_vec] = lv_cmake((float)real_acc, (float)imag_acc);
+        }
+    volk_gnsssdr_free(realcacc);
+    volk_gnsssdr_free(imagcacc);
+    _mm256_zeroupper();
+}
+#endif /* LV_HAVE_AVX2 */
+
+
+#ifdef LV_HAVE_NEON
+#include <arm_neon.h>
+
+static inline void volk_gnsssdr_16ic_x2_dot_prod_32fc_xn_neon(lv_32fc_t* result, const lv_16sc_t* in_common, const lv_16sc_t** in_a, int num_a_vectors, unsigned int num_points)
+{
+    int n_vec;
+    unsigned int index;
+    const unsigned int neon_iters = num_points / 4;
+
+    const lv_16sc_t** _in_a = in_a;
+    const lv_16sc_t* _in_common = in_common;
+    __VOLK_ATTR_ALIGNED(16) int64_t acc_vector[2];
+    int64_t real_acc, imag_acc;
+    int32_t common_real, common_imag;
+
+    int64x2_t* accumulator = (int64x2_t*)volk_gnsssdr_malloc(2 * num_a_vectors * sizeof(int64x2_t), volk_gnsssdr_get_alignment());
+
+    for(n_vec = 0; n_vec < 2 * num_a_vectors; n_vec++)
+        {
+            accumulator[n_vec] = vdupq_n_s64(0);
+        }
+
+    int16x4x2_t a_val, b_val;
+    int32x4_t real, imag;
+    const int16x4_t min_sample = vdup_n_s16(-32767);
+
+    for(index = 0; index < neon_iters; index++)
+        {
+            b_val = vld2_s16((int16_t*)_in_common); //load (2 byte imag, 2 byte real) x 4 into 128 bits reg
+            __builtin_prefetch(_in_common + 8);
+            // saturated to [-32767, 32767] so the 32 bits sums of products below cannot overflow
+            b_val.val[0] = vmax_s16(b_val.val[0], min_sample);
+            b_val.val[1] = vmax_s16(b_val.val[1], min_sample);
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    a_val = vld2_s16((int16_t*)&(_in_a[n_vec][index*4])); //load (2 byte imag, 2 byte real) x 4 into 128 bits reg
+
+                    // a0r*b0r-a0i*b0i|a1r*b1r-a1i*b1i|a2r*b2r-a2i*b2i|a3r*b3r-a3i*b3i in 32 bits
+                    real = vmlsl_s16(vmull_s16(a_val.val[0], b_val.val[0]), a_val.val[1], b_val.val[1]);
+                    // a0r*b0i+a0i*b0r|a1r*b1i+a1i*b1r|a2r*b2i+a2i*b2r|a3r*b3i+a3i*b3r in 32 bits
+                    imag = vmlal_s16(vmull_s16(a_val.val[0], b_val.val[1]), a_val.val[1], b_val.val[0]);
+
+                    // pairwise add to 64 bits and accumulate
+                    accumulator[2 * n_vec] = vpadalq_s32(accumulator[2 * n_vec], real);
+                    accumulator[2 * n_vec + 1] = vpadalq_s32(accumulator[2 * n_vec + 1], imag);
+                }
+            _in_common += 4;
+        }
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            vst1q_s64(acc_vector, accumulator[2 * n_vec]);
+            real_acc = acc_vector[0] + acc_vector[1];
+            vst1q_s64(acc_vector, accumulator[2 * n_vec + 1]);
+            imag_acc = acc_vector[0] + acc_vector[1];
+            for(index = neon_iters * 4; index < num_points; index++)
+                {
+                    common_real = sat_syms16i(lv_creal(in_common[index]));
+                    common_imag = sat_syms16i(lv_cimag(in_common[index]));
+                    real_acc += common_real * lv_creal(in_a[n_vec][index]) - common_imag * lv_cimag(in_a[n_vec][index]);
+                    imag_acc += common_real * lv_cimag(in_a[n_vec][index]) + common_imag * lv_creal(in_a[n_vec][index]);
+                }
+            result[n_vec] = lv_cmake((float)real_acc, (float)imag_acc);
+        }
+    volk_gnsssdr_free(accumulator);
+}
+
+#endif /* LV_HAVE_NEON */
+
+#endif /*INCLUDED_volk_gnsssdr_16ic_x2_dot_prod_32fc_xn_H*/
@@ -0,0 +1,311 @@
+/*!
+ * \file volk_gnsssdr_16ic_xn_weighted_sum_16ic.h
+ * \brief VOLK_GNSSSDR kernel: weighted sum, sample by sample, of N complex (16-bit integer per component) vectors.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * VOLK_GNSSSDR kernel that multiplies each of N 16 bits integer complex
+ * vectors by its 32 bits float complex weight and adds them sample by sample.
+ * The sum is accumulated in float and rounded and saturated to 16 bits at
+ * the end, so the weights do not need a fixed point scaling.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+/*!
+ * \page volk_gnsssdr_16ic_xn_weighted_sum_16ic
+ *
+ * \b Overview
+ *
+ * Computes result[n] = sum over k of weights[k] * in[k][n], rounded to the
+ * nearest integer and saturated.
+ *
+ * <b>Dispatcher Prototype</b>
+ * \code
+ * void volk_gnsssdr_16ic_xn_weighted_sum_16ic(lv_16sc_t* result, const lv_16sc_t** in, const lv_32fc_t* weights, int num_in_vectors, unsigned int num_points);
+ * \endcode
+ *
+ * \b Inputs
+ * \li in:             Pointer to an array of pointers to the vectors to be weighted and added.
+ * \li weights:        Vector of \p num_in_vectors complex weights.
+ * \li num_in_vectors: Number of input vectors.
+ * \li num_points:     Number of samples of each vector.
+ *
+ * \b Outputs
+ * \li result:         Vector of \p num_points weighted sums.
+ *
+ */
+
+#ifndef INCLUDED_volk_gnsssdr_16ic_xn_weighted_sum_16ic_H
+#define INCLUDED_volk_gnsssdr_16ic_xn_weighted_sum_16ic_H
+
+#include <limits.h>
+#include <math.h>
+#include <volk_gnsssdr/volk_gnsssdr_complex.h>
+#include <volk_gnsssdr/volk_gnsssdr_malloc.h>
+
+
+#ifdef LV_HAVE_GENERIC
+
+static inline void volk_gnsssdr_16ic_xn_weighted_sum_16ic_generic(lv_16sc_t* result, const lv_16sc_t** in, const lv_32fc_t* weights, int num_in_vectors, unsigned int num_points)
+{
+    const float min_val = (float)SHRT_MIN;
+    const float max_val = (float)SHRT_MAX;
+    float sum_real, sum_imag, in_real, in_imag;
+    int n_vec;
+    unsigned int n;
+    for (n = 0; n < num_points; n++)
+        {
+            sum_real = 0.0f;
+            sum_imag = 0.0f;
+            for (n_vec = 0; n_vec < num_in_vectors; n_vec++)
+                {
+                    in_real = (float)lv_creal(in[n_vec][n]);
+                    in_imag = (float)lv_cimag(in[n_vec][n]);
+                    sum_real += in_real * lv_creal(weights[n_vec]) - in_imag * lv_cimag(weights[n_vec]);
+                    sum_imag += in_imag * lv_creal(weights[n_vec]) + in_real * lv_cimag(weights[n_vec]);
+                }
+            sum_real = sum_real > max_val ? max_val : (sum_real < min_val ? min_val : sum_real);
+            sum_imag = sum_imag > max_val ? max_val : (sum_imag < min_val ? min_val : sum_imag);
+            result[n] = lv_cmake((int16_t)rintf(sum_real), (int16_t)rintf(sum_imag));
+        }
+}
+
+#endif /*LV_HAVE_GENERIC*/
+
+
+#ifdef LV_HAVE_SSE3
+#include <pmmintrin.h>
+
+static inline void volk_gnsssdr_16ic_xn_weighted_sum_16ic_u_sse3(lv_16sc_t* result, const lv_16sc_t** in, const lv_32fc_t* weights, int num_in_vectors, unsigned int num_points)
+{
+    const unsigned int sse_iters = num_points / 4;
+    const float min_val = (float)SHRT_MIN;
+    const float max_val = (float)SHRT_MAX;
+    float sum_real, sum_imag, in_real, in_imag;
+    int n_vec;
+    unsigned int number;
+    unsigned int n;
+    __m128i a;
+    __m128 a_lo, a_hi, acc_lo, acc_hi, tmp1, tmp2;
+    const __m128 vmin_val = _mm_set_ps1(min_val);
+    const __m128 vmax_val = _mm_set_ps1(max_val);
+
+    // real and imaginary parts of each weight, in all the lanes
+    __m128* wr = (__m128*)volk_gnsssdr_malloc(num_in_vectors * sizeof(__m128), volk_gnsssdr_get_alignment());
+    __m128* wi = (__m128*)volk_gnsssdr_malloc(num_in_vectors * sizeof(__m128), volk_gnsssdr_get_alignment());
+    for (n_vec = 0; n_vec < num_in_vectors; n_vec++)
+        {
+            wr[n_vec] = _mm_set1_ps(lv_creal(weights[n_vec]));
+            wi[n_vec] = _mm_set1_ps(lv_cimag(weights[n_vec]));
+        }
+
+    for(number = 0; number < sse_iters; number++)
+        {
+            acc_lo = _mm_setzero_ps();
+            acc_hi = _mm_setzero_ps();
+            for (n_vec = 0; n_vec < num_in_vectors; n_vec++)
+                {
+                    // four samples, sign extended to 32 bits and converted to float
+                    a = _mm_loadu_si128((__m128i*)&(in[n_vec][number * 4]));
+                    a_lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(a, a), 16));
+                    a_hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(a, a), 16));
+
+                    tmp1 = _mm_mul_ps(a_lo, wr[n_vec]);
+                    a_lo = _mm_shuffle_ps(a_lo, a_lo, 0xB1);
+                    tmp2 = _mm_mul_ps(a_lo, wi[n_vec]);
+                    acc_lo = _mm_add_ps(acc_lo, _mm_addsub_ps(tmp1, tmp2));
+
+                    tmp1 = _mm_mul_ps(a_hi, wr[n_vec]);
+                    a_hi = _mm_shuffle_ps(a_hi, a_hi, 0xB1);
+                    tmp2 = _mm_mul_ps(a_hi, wi[n_vec]);
+                    acc_hi = _mm_add_ps(acc_hi, _mm_addsub_ps(tmp1, tmp2));
+                }
+            acc_lo = _mm_max_ps(_mm_min_ps(acc_lo, vmax_val), vmin_val);
+            acc_hi = _mm_max_ps(_mm_min_ps(acc_hi, vmax_val), vmin_val);
+            a = _mm_packs_epi32(_mm_cvtps_epi32(acc_lo), _mm_cvtps_epi32(acc_hi));
+            _mm_storeu_si128((__m128i*)&result[number * 4], a);
+        }
+    volk_gnsssdr_free(wr);
+    volk_gnsssdr_free(wi);
+
+    for(n = sse_iters * 4; n < num_points; n++)
+        {
+            sum_real = 0.0f;
+            sum_imag = 0.0f;
+            for (n_vec = 0; n_vec < num_in_vectors; n_vec++)
+                {
+                    in_real = (float)lv_creal(in[n_vec][n]);
+                    in_imag = (float)lv_cimag(in[n_vec][n]);
+                    sum_real += in_real * lv_creal(weights[n_vec]) - in_imag * lv_cimag(weights[n_vec]);
+                    sum_imag += in_imag * lv_creal(weights[n_vec]) + in_real * lv_cimag(weights[n_vec]);
+                }
+            sum_real = sum_real > max_val ? max_val : (sum_real < min_val ? min_val : sum_real);
+            sum_imag = sum_imag > max_val ? max_val : (sum_imag < min_val ? min_val : sum_imag);
+            result[n] = lv_cmake((int16_t)rintf(sum_real), (int16_t)rintf(sum_imag));
+        }
+}
+
+#endif /* LV_HAVE_SSE3 */
+
+
+#ifdef LV_HAVE_SSE3
+#include <pmmintrin.h>
+
+static inline void volk_gnsssdr_16ic_xn_weighted_sum_16ic_a_sse3(lv_16sc_t* result, const lv_16sc_t** in, const lv_32fc_t* weights, int num_in_vectors, unsigned int num_points)
+{
+    const unsigned int sse_iters = num_points / 4;
+    const float min_val = (float)SHRT_MIN;
+    const float max_val = (float)SHRT_MAX;
+    float sum_real, sum_imag, in_real, in_imag;
+    int n_vec;
+    unsigned int number;
+    unsigned int n;
+    __m128i a;
+    __m128 a_lo, a_hi, acc_lo, acc_hi, tmp1, tmp2;
+    const __m128 vmin_val = _mm_set_ps1(min_val);
+    const __m128 vmax_val = _mm_set_ps1(max_val);
+
+    // real and imaginary parts of each weight, in all the lanes
+    __m128* wr = (__m128*)volk_gnsssdr_malloc(num_in_vectors * sizeof(__m128), volk_gnsssdr_get_alignment());
+    __m128* wi = (__m128*)volk_gnsssdr_malloc(num_in_vectors * sizeof(__m128), volk_gnsssdr_get_alignment());
+    for (n_vec = 0; n_vec < num_in_vectors; n_vec++)
+        {
+            wr[n_vec] = _mm_set1_ps(lv_creal(weights[n_vec]));
+            wi[n_vec] = _mm_set1_ps(lv_cimag(weights[n_vec]));
+        }
+
+    for(number = 0; number < sse_iters; number++)
+        {
+            acc_lo = _mm_setzero_ps();
+            acc_hi = _mm_setzero_ps();
+            for (n_vec = 0; n_vec < num_in_vectors; n_vec++)
+                {
+                    // four samples, sign extended to 32 bits and converted to float
+                    a = _mm_load_si128((__m128i*)&(in[n_vec][number * 4]));
+                    a_lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(a, a), 16));
+                    a_hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(a, a), 16));
+
+                    tmp1 = _mm_mul_ps(a_lo, wr[n_vec]);
+                    a_lo = _mm_shuffle_ps(a_lo, a_lo, 0xB1);
+                    tmp2 = _mm_mul_ps(a_lo, wi[n_vec]);
+                    acc_lo = _mm_add_ps(acc_lo, _mm_addsub_ps(tmp1, tmp2));
+
+                    tmp1 = _mm_mul_ps(a_hi, wr[n_vec]);
+                    a_hi = _mm_shuffle_ps(a_hi, a_hi, 0xB1);
+                    tmp2 = _mm_mul_ps(a_hi, wi[n_vec]);
+                    acc_hi = _mm_add_ps(acc_hi, _mm_addsub_ps(tmp1, tmp2));
+                }
+            acc_lo = _mm_max_ps(_mm_min_ps(acc_lo, vmax_val), vmin_val);
+            acc_hi = _mm_max_ps(_mm_min_ps(acc_hi, vmax_val), vmin_val);
+            a = _mm_packs_epi32(_mm_cvtps_epi32(acc_lo), _mm_cvtps_epi32(acc_hi));
+            _mm_store_si128((__m128i*)&result[number * 4], a);
+        }
+    volk_gnsssdr_free(wr);
+    volk_gnsssdr_free(wi);
+
+    for(n = sse_iters * 4; n < num_points; n++)
+        {
+            sum_real = 0.0f;
+            sum_imag = 0.0f;
+            for (n_vec = 0; n_vec < num_in_vectors; n_vec++)
+                {
+                    in_real = (float)lv_creal(in[n_vec][n]);
+                    in_imag = (float)lv_cimag(in[n_vec][n]);
+                    sum_real += in_real * lv_creal(weights[n_vec]) - in_imag * lv_cimag(weights[n_vec]);
+                    sum_imag += in_imag * lv_creal(weights[n_vec]) + in_real * lv_cimag(weights[n_vec]);
+                }
+            sum_real = sum_real > max_val ? max_val : (sum_real < min_val ? min_val : sum_real);
+            sum_imag = sum_imag > max_val ? max_val : (sum_imag < min_val ? min_val : sum_imag);
+            result[n] = lv_cmake((int16_t)rintf(sum_real), (int16_t)rintf(sum_imag));
+        }
+}
+
+#endif /* LV_HAVE_SSE3 */
+
+
+#ifdef LV_HAVE_NEON
+#include <arm_neon.h>
+
+static inline void volk_gnsssdr_16ic_xn_weighted_sum_16ic_neon(lv_16sc_t* result, const lv_16sc_t** in, const lv_32fc_t* weights, int num_in_vectors, unsigned int num_points)
+{
+    const unsigned int neon_iters = num_points / 4;
+    const float min_val_f = (float)SHRT_MIN;
+    const float max_val_f = (float)SHRT_MAX;
+    float sum_real, sum_imag, in_real, in_imag;
+    int n_vec;
+    unsigned int number;
+    unsigned int n;
+    const float32x4_t min_val = vmovq_n_f32(min_val_f);
+    const float32x4_t max_val = vmovq_n_f32(max_val_f);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    float32x4_t a_real, a_imag, acc_real, acc_imag, sign;
+    int16x4x2_t a_val, res;
+
+    for(number = 0; number < neon_iters; number++)
+        {
+            acc_real = vdupq_n_f32(0.0f);
+            acc_imag = vdupq_n_f32(0.0f);
+            for (n_vec = 0; n_vec < num_in_vectors; n_vec++)
+                {
+                    /* load 4 complex numbers, real and imaginary parts apart */
+                    a_val = vld2_s16((const int16_t*)&(in[n_vec][number * 4]));
+                    a_real = vcvtq_f32_s32(vmovl_s16(a_val.val[0]));
+                    a_imag = vcvtq_f32_s32(vmovl_s16(a_val.val[1]));
+                    acc_real = vmlaq_n_f32(acc_real, a_real, lv_creal(weights[n_vec]));
+                    acc_real = vmlsq_n_f32(acc_real, a_imag, lv_cimag(weights[n_vec]));
+                    acc_imag = vmlaq_n_f32(acc_imag, a_imag, lv_creal(weights[n_vec]));
+                    acc_imag = vmlaq_n_f32(acc_imag, a_real, lv_cimag(weights[n_vec]));
+                }
+            acc_real = vmaxq_f32(vminq_f32(acc_real, max_val), min_val);
+            acc_imag = vmaxq_f32(vminq_f32(acc_imag, max_val), min_val);
+
+            /* round to nearest, half away from zero */
+            sign = vcvtq_f32_u32((vshrq_n_u32(vreinterpretq_u32_f32(acc_real), 31)));
+            res.val[0] = vqmovn_s32(vcvtq_s32_f32(vsubq_f32(vaddq_f32(acc_real, half), sign)));
+            sign = vcvtq_f32_u32((vshrq_n_u32(vreinterpretq_u32_f32(acc_imag), 31)));
+            res.val[1] = vqmovn_s32(vcvtq_s32_f32(vsubq_f32(vaddq_f32(acc_imag, half), sign)));
+            vst2_s16((int16_t*)&result[number * 4], res);
+        }
+
+    for(n = neon_iters * 4; n < num_points; n++)
+        {
+            sum_real = 0.0f;
+            sum_imag = 0.0f;
+            for (n_vec = 0; n_vec < num_in_vectors; n_vec++)
+                {
+                    in_real = (float)lv_creal(in[n_vec][n]);
+                    in_imag = (float)lv_cimag(in[n_vec][n]);
+                    sum_real += in_real * lv_creal(weights[n_vec]) - in_imag * lv_cimag(weights[n_vec]);
+                    sum_imag += in_imag * lv_creal(weights[n_vec]) + in_real * lv_cimag(weights[n_vec]);
+                }
+            sum_real = sum_real > max_val_f ? max_val_f : (sum_real < min_val_f ? min_val_f : sum_real);
+            sum_imag = sum_imag > max_val_f ? max_val_f : (sum_imag < min_val_f ? min_val_f : sum_imag);
+            result[n] = lv_cmake((int16_t)rintf(sum_real), (int16_t)rintf(sum_imag));
+        }
+}
+
+#endif /* LV_HAVE_NEON */
+
+#endif /* INCLUDED_volk_gnsssdr_16ic_xn_weighted_sum_16ic_H */
@@ -0,0 +1,210 @@
+/*!
+ * \file volk_gnsssdr_32fc_weightedsumxnpuppet_32fc.h
+ * \brief VOLK_GNSSSDR puppet for the weighted sum of N complex vectors, for testing purposes
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * VOLK_GNSSSDR puppet for integrating the weighted sum of N vectors into
+ * the test system, with three copies of the input and fixed weights.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef INCLUDED_volk_gnsssdr_32fc_weightedsumxnpuppet_32fc_H
+#define INCLUDED_volk_gnsssdr_32fc_weightedsumxnpuppet_32fc_H
+
+#include "volk_gnsssdr/volk_gnsssdr_32fc_xn_weighted_sum_32fc.h"
+#include <volk_gnsssdr/volk_gnsssdr_malloc.h>
+#include <volk_gnsssdr/volk_gnsssdr_complex.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+#include <string.h>
+
+#ifdef LV_HAVE_GENERIC
+static inline void volk_gnsssdr_32fc_weightedsumxnpuppet_32fc_generic(lv_32fc_t* result, const lv_32fc_t* in, unsigned int num_points)
+{
+    int num_in_vectors = 3;
+    lv_32fc_t weights[3];
+    weights[0] = lv_cmake(0.5f, 0.0f);
+    weights[1] = lv_cmake(-0.25f, 0.25f);
+    weights[2] = lv_cmake(0.0f, 0.125f);
+    lv_32fc_t** in_a = (lv_32fc_t**)volk_gnsssdr_malloc(sizeof(lv_32fc_t*) * num_in_vectors, volk_gnsssdr_get_alignment());
+    unsigned int n;
+    for(n = 0; n < num_in_vectors; n++)
+    {
+       in_a[n] = (lv_32fc_t*)volk_gnsssdr_malloc(sizeof(lv_32fc_t) * num_points, volk_gnsssdr_get_alignment());
+       memcpy((lv_32fc_t*)in_a[n], (lv_32fc_t*)in, sizeof(lv_32fc_t) * num_points);
+    }
+
+    volk_gnsssdr_32fc_xn_weighted_sum_32fc_generic(result, (const lv_32fc_t**) in_a, weights, num_in_vectors, num_points);
+
+    for(n = 0; n < num_in_vectors; n++)
+    {
+        volk_gnsssdr_free(in_a[n]);
+    }
+    volk_gnsssdr_free(in_a);
+}
+
+#endif  /* Generic */
+
+
+#ifdef LV_HAVE_SSE3
+static inline void volk_gnsssdr_32fc_weightedsumxnpuppet_32fc_u_sse3(lv_32fc_t* result, const lv_32fc_t* in, unsigned int num_points)
+{
+    int num_in_vectors = 3;
+    lv_32fc_t weights[3];
+    weights[0] = lv_cmake(0.5f, 0.0f);
+    weights[1] = lv_cmake(-0.25f, 0.25f);
+    weights[2] = lv_cmake(0.0f, 0.125f);
+    lv_32fc_t** in_a = (lv_32fc_t**)volk_gnsssdr_malloc(sizeof(lv_32fc_t*) * num_in_vectors, volk_gnsssdr_get_alignment());
+    unsigned int n;
+    for(n = 0; n < num_in_vectors; n++)
+    {
+       in_a[n] = (lv_32fc_t*)volk_gnsssdr_malloc(sizeof(lv_32fc_t) * num_points, volk_gnsssdr_get_alignment());
+       memcpy((lv_32fc_t*)in_a[n], (lv_32fc_t*)in, sizeof(lv_32fc_t) * num_points);
+    }
+
+    volk_gnsssdr_32fc_xn_weighted_sum_32fc_u_sse3(result, (const lv_32fc_t**) in_a, weights, num_in_vectors, num_points);
+
+    for(n = 0; n < num_in_vectors; n++)
+    {
+        volk_gnsssdr_free(in_a[n]);
+    }
+    volk_gnsssdr_free(in_a);
+}
+
+#endif /* LV_HAVE_SSE3 */
+
+
+#ifdef LV_HAVE_SSE3
+static inline void volk_gnsssdr_32fc_weightedsumxnpuppet_32fc_a_sse3(lv_32fc_t* result, const lv_32fc_t* in, unsigned int num_points)
+{
+    int num_in_vectors = 3;
+    lv_32fc_t weights[3];
+    weights[0] = lv_cmake(0.5f, 0.0f);
+    weights[1] = lv_cmake(-0.25f, 0.25f);
+    weights[2] = lv_cmake(0.0f, 0.125f);
+    lv_32fc_t** in_a = (lv_32fc_t**)volk_gnsssdr_malloc(sizeof(lv_32fc_t*) * num_in_vectors, volk_gnsssdr_get_alignment());
+    unsigned int n;
+    for(n = 0; n < num_in_vectors; n++)
+    {
+       in_a[n] = (lv_32fc_t*)volk_gnsssdr_malloc(sizeof(lv_32fc_t) * num_points, volk_gnsssdr_get_alignment());
+       memcpy((lv_32fc_t*)in_a[n], (lv_32fc_t*)in, sizeof(lv_32fc_t) * num_points);
+    }
+
+    volk_gnsssdr_32fc_xn_weighted_sum_32fc_a_sse3(result, (const lv_32fc_t**) in_a, weights, num_in_vectors, num_points);
+
+    for(n = 0; n < num_in_vectors; n++)
+    {
+        volk_gnsssdr_free(in_a[n]);
+    }
+    volk_gnsssdr_free(in_a);
+}
+
+#endif /* LV_HAVE_SSE3 */
+
+
+#ifdef LV_HAVE_AVX
+static inline void volk_gnsssdr_32fc_weightedsumxnpuppet_32fc_u_avx(lv_32fc_t* result, const lv_32fc_t* in, unsigned int num_points)
+{
+    int num_in_vectors = 3;
+    lv_32fc_t weights[3];
+    weights[0] = lv_cmake(0.5f, 0.0f);
+    weights[1] = lv_cmake(-0.25f, 0.25f);
+    weights[2] = lv_cmake(0.0f, 0.125f);
+    lv_32fc_t** in_a = (lv_32fc_t**)volk_gnsssdr_malloc(sizeof(lv_32fc_t*) * num_in_vectors, volk_gnsssdr_get_alignment());
+    unsigned int n;
+    for(n = 0; n < num_in_vectors; n++)
+    {
+       in_a[n] = (lv_32fc_t*)volk_gnsssdr_malloc(sizeof(lv_32fc_t) * num_points, volk_gnsssdr_get_alignment());
+       memcpy((lv_32fc_t*)in_a[n], (lv_32fc_t*)in, sizeof(lv_32fc_t) * num_points);
+    }
+
+    volk_gnsssdr_32fc_xn_weighted_sum_32fc_u_avx(result, (const lv_32fc_t**) in_a, weights, num_in_vectors, num_points);
+
+    for(n = 0; n < num_in_vectors; n++)
+    {
+        volk_gnsssdr_free(in_a[n]);
+    }
+    volk_gnsssdr_free(in_a);
+}
+
+#endif /* LV_HAVE_AVX */
+
+
+#ifdef LV_HAVE_AVX
+static inline void volk_gnsssdr_32fc_weightedsumxnpuppet_32fc_a_avx(lv_32fc_t* result, const lv_32fc_t* in, unsigned int num_points)
+{
+    int num_in_vectors = 3;
+    lv_32fc_t weights[3];
+    weights[0] = lv_cmake(0.5f, 0.0f);
+    weights[1] = lv_cmake(-0.25f, 0.25f);
+    weights[2] = lv_cmake(0.0f, 0.125f);
+    lv_32fc_t** in_a = (lv_32fc_t**)volk_gnsssdr_malloc(sizeof(lv_32fc_t*) * num_in_vectors, volk_gnsssdr_get_alignment());
+    unsigned int n;
+    for(n = 0; n < num_in_vectors; n++)
+    {
+       in_a[n] = (lv_32fc_t*)volk_gnsssdr_malloc(sizeof(lv_32fc_t) * num_points, volk_gnsssdr_get_alignment());
+       memcpy((lv_32fc_t*)in_a[n], (lv_32fc_t*)in, sizeof(lv_32fc_t) * num_points);
+    }
+
+    volk_gnsssdr_32fc_xn_weighted_sum_32fc_a_avx(result, (const lv_32fc_t**) in_a, weights, num_in_vectors, num_points);
+
+    for(n = 0; n < num_in_vectors; n++)
+    {
+        volk_gnsssdr_free(in_a[n]);
+    }
+    volk_gnsssdr_free(in_a);
+}
+
+#endif /* LV_HAVE_AVX */
+
+
+#ifdef LV_HAVE_NEON
+static inline void volk_gnsssdr_32fc_weightedsumxnpuppet_32fc_neon(lv_32fc_t* result, const lv_32fc_t* in, unsigned int num_points)
+{
+    int num_in_vectors = 3;
+    lv_32fc_t weights[3];
+    weights[0] = lv_cmake(0.5f, 0.0f);
+    weights[1] = lv_cmake(-0.25f, 0.25f);
+    weights[2] = lv_cmake(0.0f, 0.125f);
+    lv_32fc_t** in_a = (lv_32fc_t**)volk_gnsssdr_malloc(sizeof(lv_32fc_t*) * num_in_vectors, volk_gnsssdr_get_alignment());
+    unsigned int n;
+    for(n = 0; n < num_in_vectors; n++)
+    {
+       in_a[n] = (lv_32fc_t*)volk_gnsssdr_malloc(sizeof(lv_32fc_t) * num_points, volk_gnsssdr_get_alignment());
+       memcpy((lv_32fc_t*)in_a[n], (lv_32fc_t*)in, sizeof(lv_32fc_t) * num_points);
+    }
+
+    volk_gnsssdr_32fc_xn_weighted_sum_32fc_neon(result, (const lv_32fc_t**) in_a, weights, num_in_vectors, num_points);
+
+    for(n = 0; n < num_in_vectors; n++)
+    {
+        volk_gnsssdr_free(in_a[n]);
+    }
+    volk_gnsssdr_free(in_a);
+}
+
+#endif /* LV_HAVE_NEON */
+
+#endif  // INCLUDED_volk_gnsssdr_32fc_weightedsumxnpuppet_32fc_H
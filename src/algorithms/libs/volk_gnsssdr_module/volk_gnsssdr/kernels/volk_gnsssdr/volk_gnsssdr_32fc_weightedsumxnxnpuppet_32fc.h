@@ -0,0 +1,331 @@
+/*!
+ * \file volk_gnsssdr_32fc_weightedsumxnxnpuppet_32fc.h
+ * \brief VOLK_GNSSSDR puppet for the M weighted sums of N complex vectors, for testing purposes
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * VOLK_GNSSSDR puppet for integrating the M weighted sums of N vectors into
+ * the test system, with three copies of the input, a fixed 3 x 3 matrix of
+ * weights and the sum of the three output vectors as result.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef INCLUDED_volk_gnsssdr_32fc_weightedsumxnxnpuppet_32fc_H
+#define INCLUDED_volk_gnsssdr_32fc_weightedsumxnxnpuppet_32fc_H
+
+#include "volk_gnsssdr/volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn.h"
+#include <volk_gnsssdr/volk_gnsssdr_malloc.h>
+#include <volk_gnsssdr/volk_gnsssdr_complex.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+#include <string.h>
+
+#ifdef LV_HAVE_GENERIC
+static inline void volk_gnsssdr_32fc_weightedsumxnxnpuppet_32fc_generic(lv_32fc_t* result, const lv_32fc_t* in, unsigned int num_points)
+{
+    int num_in_vectors = 3;
+    int num_out_vectors = 3;
+    lv_32fc_t weights[9];
+    unsigned int k;
+    for(k = 0; k < 3; k++)
+    {
+        weights[3 * k] = lv_cmake(0.5f, 0.0f);
+        weights[3 * k + 1] = lv_cmake(-0.25f, 0.25f * k);
+        weights[3 * k + 2] = lv_cmake(0.125f * k, 0.125f);
+    }
+    lv_32fc_t** in_a = (lv_32fc_t**)volk_gnsssdr_malloc(sizeof(lv_32fc_t*) * num_in_vectors, volk_gnsssdr_get_alignment());
+    unsigned int n;
+    for(n = 0; n < num_in_vectors; n++)
+    {
+       in_a[n] = (lv_32fc_t*)volk_gnsssdr_malloc(sizeof(lv_32fc_t) * num_points, volk_gnsssdr_get_alignment());
+       memcpy((lv_32fc_t*)in_a[n], (lv_32fc_t*)in, sizeof(lv_32fc_t) * num_points);
+    }
+    lv_32fc_t** result_a = (lv_32fc_t**)volk_gnsssdr_malloc(sizeof(lv_32fc_t*) * num_out_vectors, volk_gnsssdr_get_alignment());
+    for(n = 0; n < num_out_vectors; n++)
+    {
+       result_a[n] = (lv_32fc_t*)volk_gnsssdr_malloc(sizeof(lv_32fc_t) * num_points, volk_gnsssdr_get_alignment());
+    }
+
+    volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn_generic(result_a, (const lv_32fc_t**) in_a, weights, num_out_vectors, num_in_vectors, num_points);
+
+    for(k = 0; k < num_points; k++)
+    {
+        result[k] = result_a[0][k] + result_a[1][k] + result_a[2][k];
+    }
+
+    for(n = 0; n < num_in_vectors; n++)
+    {
+        volk_gnsssdr_free(in_a[n]);
+    }
+    volk_gnsssdr_free(in_a);
+    for(n = 0; n < num_out_vectors; n++)
+    {
+        volk_gnsssdr_free(result_a[n]);
+    }
+    volk_gnsssdr_free(result_a);
+}
+
+#endif  /* Generic */
+
+
+#ifdef LV_HAVE_SSE3
+static inline void volk_gnsssdr_32fc_weightedsumxnxnpuppet_32fc_u_sse3(lv_32fc_t* result, const lv_32fc_t* in, unsigned int num_points)
+{
+    int num_in_vectors = 3;
+    int num_out_vectors = 3;
+    lv_32fc_t weights[9];
+    unsigned int k;
+    for(k = 0; k < 3; k++)
+    {
+        weights[3 * k] = lv_cmake(0.5f, 0.0f);
+        weights[3 * k + 1] = lv_cmake(-0.25f, 0.25f * k);
+        weights[3 * k + 2] = lv_cmake(0.125f * k, 0.125f);
+    }
+    lv_32fc_t** in_a = (lv_32fc_t**)volk_gnsssdr_malloc(sizeof(lv_32fc_t*) * num_in_vectors, volk_gnsssdr_get_alignment());
+    unsigned int n;
+    for(n = 0; n < num_in_vectors; n++)
+    {
+       in_a[n] = (lv_32fc_t*)volk_gnsssdr_malloc(sizeof(lv_32fc_t) * num_points, volk_gnsssdr_get_alignment());
+       memcpy((lv_32fc_t*)in_a[n], (lv_32fc_t*)in, sizeof(lv_32fc_t) * num_points);
+    }
+    lv_32fc_t** result_a = (lv_32fc_t**)volk_gnsssdr_malloc(sizeof(lv_32fc_t*) * num_out_vectors, volk_gnsssdr_get_alignment());
+    for(n = 0; n < num_out_vectors; n++)
+    {
+       result_a[n] = (lv_32fc_t*)volk_gnsssdr_malloc(sizeof(lv_32fc_t) * num_points, volk_gnsssdr_get_alignment());
+    }
+
+    volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn_u_sse3(result_a, (const lv_32fc_t**) in_a, weights, num_out_vectors, num_in_vectors, num_points);
+
+    for(k = 0; k < num_points; k++)
+    {
+        result[k] = result_a[0][k] + result_a[1][k] + result_a[2][k];
+    }
+
+    for(n = 0; n < num_in_vectors; n++)
+    {
+        volk_gnsssdr_free(in_a[n]);
+    }
+    volk_gnsssdr_free(in_a);
+    for(n = 0; n < num_out_vectors; n++)
+    {
+        volk_gnsssdr_free(result_a[n]);
+    }
+    volk_gnsssdr_free(result_a);
+}
+
+#endif /* LV_HAVE_SSE3 */
+
+
+#ifdef LV_HAVE_SSE3
+static inline void volk_gnsssdr_32fc_weightedsumxnxnpuppet_32fc_a_sse3(lv_32fc_t* result, const lv_32fc_t* in, unsigned int num_points)
+{
+    int num_in_vectors = 3;
+    int num_out_vectors = 3;
+    lv_32fc_t weights[9];
+    unsigned int k;
+    for(k = 0; k < 3; k++)
+    {
+        weights[3 * k] = lv_cmake(0.5f, 0.0f);
+        weights[3 * k + 1] = lv_cmake(-0.25f, 0.25f * k);
+        weights[3 * k + 2] = lv_cmake(0.125f * k, 0.125f);
+    }
+    lv_32fc_t** in_a = (lv_32fc_t**)volk_gnsssdr_malloc(sizeof(lv_32fc_t*) * num_in_vectors, volk_gnsssdr_get_alignment());
+    unsigned int n;
+    for(n = 0; n < num_in_vectors; n++)
+    {
+       in_a[n] = (lv_32fc_t*)volk_gnsssdr_malloc(sizeof(lv_32fc_t) * num_points, volk_gnsssdr_get_alignment());
+       memcpy((lv_32fc_t*)in_a[n], (lv_32fc_t*)in, sizeof(lv_32fc_t) * num_points);
+    }
+    lv_32fc_t** result_a = (lv_32fc_t**)volk_gnsssdr_malloc(sizeof(lv_32fc_t*) * num_out_vectors, volk_gnsssdr_get_alignment());
+    for(n = 0; n < num_out_vectors; n++)
+    {
+       result_a[n] = (lv_32fc_t*)volk_gnsssdr_malloc(sizeof(lv_32fc_t) * num_points, volk_gnsssdr_get_alignment());
+    }
+
+    volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn_a_sse3(result_a, (const lv_32fc_t**) in_a, weights, num_out_vectors, num_in_vectors, num_points);
+
+    for(k = 0; k < num_points; k++)
+    {
+        result[k] = result_a[0][k] + result_a[1][k] + result_a[2][k];
+    }
+
+    for(n = 0; n < num_in_vectors; n++)
+    {
+        volk_gnsssdr_free(in_a[n]);
+    }
+    volk_gnsssdr_free(in_a);
+    for(n = 0; n < num_out_vectors; n++)
+    {
+        volk_gnsssdr_free(result_a[n]);
+    }
+    volk_gnsssdr_free(result_a);
+}
+
+#endif /* LV_HAVE_SSE3 */
+
+
+#ifdef LV_HAVE_AVX
+static inline void volk_gnsssdr_32fc_weightedsumxnxnpuppet_32fc_u_avx(lv_32fc_t* result, const lv_32fc_t* in, unsigned int num_points)
+{
+    int num_in_vectors = 3;
+    int num_out_vectors = 3;
+    lv_32fc_t weights[9];
+    unsigned int k;
+    for(k = 0; k < 3; k++)
+    {
+        weights[3 * k] = lv_cmake(0.5f, 0.0f);
+        weights[3 * k + 1] = lv_cmake(-0.25f, 0.25f * k);
+        weights[3 * k + 2] = lv_cmake(0.125f * k, 0.125f);
+    }
+    lv_32fc_t** in_a = (lv_32fc_t**)volk_gnsssdr_malloc(sizeof(lv_32fc_t*) * num_in_vectors, volk_gnsssdr_get_alignment());
+    unsigned int n;
+    for(n = 0; n < num_in_vectors; n++)
+    {
+       in_a[n] = (lv_32fc_t*)volk_gnsssdr_malloc(sizeof(lv_32fc_t) * num_points, volk_gnsssdr_get_alignment());
+       memcpy((lv_32fc_t*)in_a[n], (lv_32fc_t*)in, sizeof(lv_32fc_t) * num_points);
+    }
+    lv_32fc_t** result_a = (lv_32fc_t**)volk_gnsssdr_malloc(sizeof(lv_32fc_t*) * num_out_vectors, volk_gnsssdr_get_alignment());
+    for(n = 0; n < num_out_vectors; n++)
+    {
+       result_a[n] = (lv_32fc_t*)volk_gnsssdr_malloc(sizeof(lv_32fc_t) * num_points, volk_gnsssdr_get_alignment());
+    }
+
+    volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn_u_avx(result_a, (const lv_32fc_t**) in_a, weights, num_out_vectors, num_in_vectors, num_points);
+
+    for(k = 0; k < num_points; k++)
+    {
+        result[k] = result_a[0][k] + result_a[1][k] + result_a[2][k];
+    }
+
+    for(n = 0; n < num_in_vectors; n++)
+    {
+        volk_gnsssdr_free(in_a[n]);
+    }
+    volk_gnsssdr_free(in_a);
+    for(n = 0; n < num_out_vectors; n++)
+    {
+        volk_gnsssdr_free(result_a[n]);
+    }
+    volk_gnsssdr_free(result_a);
+}
+
+#endif /* LV_HAVE_AVX */
+
+
+#ifdef LV_HAVE_AVX
+static inline void volk_gnsssdr_32fc_weightedsumxnxnpuppet_32fc_a_avx(lv_32fc_t* result, const lv_32fc_t* in, unsigned int num_points)
+{
+    int num_in_vectors = 3;
+    int num_out_vectors = 3;
+    lv_32fc_t weights[9];
+    unsigned int k;
+    for(k = 0; k < 3; k++)
+    {
+        weights[3 * k] = lv_cmake(0.5f, 0.0f);
+        weights[3 * k + 1] = lv_cmake(-0.25f, 0.25f * k);
+        weights[3 * k + 2] = lv_cmake(0.125f * k, 0.125f);
+    }
+    lv_32fc_t** in_a = (lv_32fc_t**)volk_gnsssdr_malloc(sizeof(lv_32fc_t*) * num_in_vectors, volk_gnsssdr_get_alignment());
+    unsigned int n;
+    for(n = 0; n < num_in_vectors; n++)
+    {
+       in_a[n] = (lv_32fc_t*)volk_gnsssdr_malloc(sizeof(lv_32fc_t) * num_points, volk_gnsssdr_get_alignment());
+       memcpy((lv_32fc_t*)in_a[n], (lv_32fc_t*)in, sizeof(lv_32fc_t) * num_points);
+    }
+    lv_32fc_t** result_a = (lv_32fc_t**)volk_gnsssdr_malloc(sizeof(lv_32fc_t*) * num_out_vectors, volk_gnsssdr_get_alignment());
+    for(n = 0; n < num_out_vectors; n++)
+    {
+       result_a[n] = (lv_32fc_t*)volk_gnsssdr_malloc(sizeof(lv_32fc_t) * num_points, volk_gnsssdr_get_alignment());
+    }
+
+    volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn_a_avx(result_a, (const lv_32fc_t**) in_a, weights, num_out_vectors, num_in_vectors, num_points);
+
+    for(k = 0; k < num_points; k++)
+    {
+        result[k] = result_a[0][k] + result_a[1][k] + result_a[2][k];
+    }
+
+    for(n = 0; n < num_in_vectors; n++)
+    {
+        volk_gnsssdr_free(in_a[n]);
+    }
+    volk_gnsssdr_free(in_a);
+    for(n = 0; n < num_out_vectors; n++)
+    {
+        volk_gnsssdr_free(result_a[n]);
+    }
+    volk_gnsssdr_free(result_a);
+}
+
+#endif /* LV_HAVE_AVX */
+
+
+#ifdef LV_HAVE_NEON
+static inline void volk_gnsssdr_32fc_weightedsumxnxnpuppet_32fc_neon(lv_32fc_t* result, const lv_32fc_t* in, unsigned int num_points)
+{
+    int num_in_vectors = 3;
+    int num_out_vectors = 3;
+    lv_32fc_t weights[9];
+    unsigned int k;
+    for(k = 0; k < 3; k++)
+    {
+        weights[3 * k] = lv_cmake(0.5f, 0.0f);
+        weights[3 * k + 1] = lv_cmake(-0.25f, 0.25f * k);
+        weights[3 * k + 2] = lv_cmake(0.125f * k, 0.125f);
+    }
+    lv_32fc_t** in_a = (lv_32fc_t**)volk_gnsssdr_malloc(sizeof(lv_32fc_t*) * num_in_vectors, volk_gnsssdr_get_alignment());
+    unsigned int n;
+    for(n = 0; n < num_in_vectors; n++)
+    {
+       in_a[n] = (lv_32fc_t*)volk_gnsssdr_malloc(sizeof(lv_32fc_t) * num_points, volk_gnsssdr_get_alignment());
+       memcpy((lv_32fc_t*)in_a[n], (lv_32fc_t*)in, sizeof(lv_32fc_t) * num_points);
+    }
+    lv_32fc_t** result_a = (lv_32fc_t**)volk_gnsssdr_malloc(sizeof(lv_32fc_t*) * num_out_vectors, volk_gnsssdr_get_alignment());
+    for(n = 0; n < num_out_vectors; n++)
+    {
+       result_a[n] = (lv_32fc_t*)volk_gnsssdr_malloc(sizeof(lv_32fc_t) * num_points, volk_gnsssdr_get_alignment());
+    }
+
+    volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn_neon(result_a, (const lv_32fc_t**) in_a, weights, num_out_vectors, num_in_vectors, num_points);
+
+    for(k = 0; k < num_points; k++)
+    {
+        result[k] = result_a[0][k] + result_a[1][k] + result_a[2][k];
+    }
+
+    for(n = 0; n < num_in_vectors; n++)
+    {
+        volk_gnsssdr_free(in_a[n]);
+    }
+    volk_gnsssdr_free(in_a);
+    for(n = 0; n < num_out_vectors; n++)
+    {
+        volk_gnsssdr_free(result_a[n]);
+    }
+    volk_gnsssdr_free(result_a);
+}
+
+#endif /* LV_HAVE_NEON */
+
+#endif  // INCLUDED_volk_gnsssdr_32fc_weightedsumxnxnpuppet_32fc_H
@@ -0,0 +1,640 @@
+/*!
+ * \file volk_gnsssdr_32fc_x2_resampler_rotator_dot_prod_32fc_xn.h
+ * \brief VOLK_GNSSSDR kernel: resamples a local code into N delayed replicas,
+ * multiplies them by a common phase-rotated vector and accumulates the results
+ * in N float complex outputs, without storing the replicas.
+ * \authors <ul>
+ *          <li> GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *          </ul>
+ *
+ * VOLK_GNSSSDR kernel that fuses volk_gnsssdr_32fc_xn_resampler_32fc_xn and
+ * volk_gnsssdr_32fc_x2_rotator_dot_prod_32fc_xn: the code chip index of each
+ * tap is computed on the fly inside the dot product loop, so that the N
+ * resampled replicas are never written to memory and read back.
+ * It is optimized to perform the N tap correlation process in GNSS receivers.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+/*!
+ * \page volk_gnsssdr_32fc_x2_resampler_rotator_dot_prod_32fc_xn
+ *
+ * \b Overview
+ *
+ * Rotates the reference complex vector and multiplies it with \p num_a_vectors
+ * zero-hold resampled and delayed replicas of \p local_code, accumulating the
+ * results in the output vector. The output is the same as calling
+ * volk_gnsssdr_32fc_xn_resampler_32fc_xn followed by volk_gnsssdr_32fc_x2_rotator_dot_prod_32fc_xn.
+ *
+ * <b>Dispatcher Prototype</b>
+ * \code
+ * void volk_gnsssdr_32fc_x2_resampler_rotator_dot_prod_32fc_xn(lv_32fc_t* result, const lv_32fc_t* in_common, const lv_32fc_t phase_inc, lv_32fc_t* phase, const lv_32fc_t* local_code, float rem_code_phase_chips, float code_phase_step_chips, float* shifts_chips, unsigned int code_length_chips, int num_a_vectors, unsigned int num_points)
+ * \endcode
+ *
+ * \b Inputs
+ * \li in_common:             Pointer to the vector to be rotated, multiplied and accumulated (reference vector).
+ * \li phase_inc:             Phase increment = lv_cmake(cos(phase_step_rad), sin(phase_step_rad))
+ * \li phase:                 Initial phase = lv_cmake(cos(initial_phase_rad), sin(initial_phase_rad))
+ * \li local_code:            Local code, one sample per chip.
+ * \li rem_code_phase_chips:  Remnant code phase [chips].
+ * \li code_phase_step_chips: Phase increment per sample [chips/sample].
+ * \li shifts_chips:          Vector of floats that defines the spacing (in chips) between the replicas of \p local_code
+ * \li code_length_chips:     Code length in chips.
+ * \li num_a_vectors:         Number of correlators.
+ * \li num_points:            Number of complex values to be multiplied together, accumulated and stored into \p result.
+ *
+ * \b Outputs
+ * \li phase:                 Final phase.
+ * \li result:                Vector of \p num_a_vectors correlator outputs.
+ *
+ */
+
+#ifndef INCLUDED_volk_gnsssdr_32fc_x2_resampler_rotator_dot_prod_32fc_xn_H
+#define INCLUDED_volk_gnsssdr_32fc_x2_resampler_rotator_dot_prod_32fc_xn_H
+
+
+#include <volk_gnsssdr/volk_gnsssdr.h>
+#include <volk_gnsssdr/volk_gnsssdr_malloc.h>
+#include <volk_gnsssdr/volk_gnsssdr_complex.h>
+#include <math.h>
+#include <stdlib.h> /* abs */
+
+#ifdef LV_HAVE_GENERIC
+
+static inline void volk_gnsssdr_32fc_x2_resampler_rotator_dot_prod_32fc_xn_generic(lv_32fc_t* result, const lv_32fc_t* in_common, const lv_32fc_t phase_inc, lv_32fc_t* phase, const lv_32fc_t* local_code, float rem_code_phase_chips, float code_phase_step_chips, float* shifts_chips, unsigned int code_length_chips, int num_a_vectors, unsigned int num_points)
+{
+    lv_32fc_t tmp32_1;
+    int local_code_chip_index;
+    int n_vec;
+    unsigned int n;
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            result[n_vec] = lv_cmake(0,0);
+        }
+    for (n = 0; n < num_points; n++)
+        {
+            tmp32_1 = *in_common++ * (*phase);
+
+            // Regenerate phase
+            if (n % 256 == 0)
+                {
+#ifdef __cplusplus
+                    (*phase) /= std::abs((*phase));
+#else
+                    (*phase) /= hypotf(lv_creal(*phase), lv_cimag(*phase));
+#endif
+                }
+
+            (*phase) *= phase_inc;
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    // resample code for current tap
+                    local_code_chip_index = (int)floor(code_phase_step_chips * (float)n + shifts_chips[n_vec] - rem_code_phase_chips);
+                    //Take into account that in multitap correlators, the shifts can be negative!
+                    if (local_code_chip_index < 0) local_code_chip_index += (int)code_length_chips * (abs(local_code_chip_index) / code_length_chips + 1);
+                    local_code_chip_index = local_code_chip_index % code_length_chips;
+                    result[n_vec] += tmp32_1 * local_code[local_code_chip_index];
+                }
+        }
+}
+
+#endif /*LV_HAVE_GENERIC*/
+
+
+#ifdef LV_HAVE_SSE4_1
+#include <smmintrin.h>
+static inline void volk_gnsssdr_32fc_x2_resampler_rotator_dot_prod_32fc_xn_u_sse4_1(lv_32fc_t* result, const lv_32fc_t* in_common, const lv_32fc_t phase_inc, lv_32fc_t* phase, const lv_32fc_t* local_code, float rem_code_phase_chips, float code_phase_step_chips, float* shifts_chips, unsigned int code_length_chips, int num_a_vectors, unsigned int num_points)
+{
+    lv_32fc_t dotProduct = lv_cmake(0,0);
+    lv_32fc_t tmp32_1;
+    const unsigned int sse_iters = num_points / 4;
+    int n_vec;
+    int i;
+    int local_code_chip_index_;
+    unsigned int number;
+    unsigned int n;
+    const lv_32fc_t* _in_common = in_common;
+
+    __VOLK_ATTR_ALIGNED(16) lv_32fc_t dotProductVector[2];
+    __VOLK_ATTR_ALIGNED(16) int local_code_chip_index[4];
+
+    // accumulators, followed by the (shift - rem_code_phase) offset of each tap
+    __m128* acc = (__m128*)volk_gnsssdr_malloc(2 * num_a_vectors * sizeof(__m128), volk_gnsssdr_get_alignment());
+    __m128* tap_offset = acc + num_a_vectors;
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            acc[n_vec] = _mm_setzero_ps();
+            tap_offset[n_vec] = _mm_sub_ps(_mm_set_ps1(shifts_chips[n_vec]), _mm_set_ps1(rem_code_phase_chips));
+        }
+
+    // code resampler registers
+    const __m128 fours = _mm_set1_ps(4.0f);
+    const __m128 code_phase_step_chips_reg = _mm_set_ps1(code_phase_step_chips);
+    const __m128 code_length_chips_reg_f = _mm_set_ps1((float)code_length_chips);
+    const __m128i code_length_chips_reg_i = _mm_set1_epi32((int)code_length_chips);
+    const __m128i zeros = _mm_setzero_si128();
+    __m128 indexn = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+    __m128 aux, aux2, cTrunc, code;
+    __m128i local_code_chip_index_reg;
+
+    // phase rotation registers
+    __m128 a, two_phase_acc_reg, two_phase_inc_reg, yl, yh, tmp1, tmp1p, tmp2, tmp2p, z1, yl_lo, yh_lo, yl_hi, yh_hi;
+
+    __VOLK_ATTR_ALIGNED(16) lv_32fc_t two_phase_inc[2];
+    two_phase_inc[0] = phase_inc * phase_inc;
+    two_phase_inc[1] = phase_inc * phase_inc;
+    two_phase_inc_reg = _mm_load_ps((float*) two_phase_inc);
+    __VOLK_ATTR_ALIGNED(16) lv_32fc_t two_phase_acc[2];
+    two_phase_acc[0] = (*phase);
+    two_phase_acc[1] = (*phase) * phase_inc;
+    two_phase_acc_reg = _mm_load_ps((float*)two_phase_acc);
+
+    const __m128 ylp = _mm_moveldup_ps(two_phase_inc_reg);
+    const __m128 yhp = _mm_movehdup_ps(two_phase_inc_reg);
+
+    for(number = 0; number < sse_iters; number++)
+        {
+            // Phase rotation of samples 0 and 1
+            a = _mm_loadu_ps((float*)_in_common);
+            yl = _mm_moveldup_ps(two_phase_acc_reg); // Load yl with cr,cr,dr,dr
+            yh = _mm_movehdup_ps(two_phase_acc_reg);
+            tmp1 = _mm_mul_ps(a, yl);
+            tmp1p = _mm_mul_ps(two_phase_acc_reg, ylp);
+            a = _mm_shuffle_ps(a, a, 0xB1);
+            two_phase_acc_reg = _mm_shuffle_ps(two_phase_acc_reg, two_phase_acc_reg, 0xB1);
+            tmp2 = _mm_mul_ps(a, yh);
+            tmp2p = _mm_mul_ps(two_phase_acc_reg, yhp);
+            z1 = _mm_addsub_ps(tmp1, tmp2);
+            two_phase_acc_reg = _mm_addsub_ps(tmp1p, tmp2p);
+            yl_lo = _mm_moveldup_ps(z1);
+            yh_lo = _mm_movehdup_ps(z1);
+
+            // Phase rotation of samples 2 and 3
+            a = _mm_loadu_ps((float*)(_in_common + 2));
+            yl = _mm_moveldup_ps(two_phase_acc_reg);
+            yh = _mm_movehdup_ps(two_phase_acc_reg);
+            tmp1 = _mm_mul_ps(a, yl);
+            tmp1p = _mm_mul_ps(two_phase_acc_reg, ylp);
+            a = _mm_shuffle_ps(a, a, 0xB1);
+            two_phase_acc_reg = _mm_shuffle_ps(two_phase_acc_reg, two_phase_acc_reg, 0xB1);
+            tmp2 = _mm_mul_ps(a, yh);
+            tmp2p = _mm_mul_ps(two_phase_acc_reg, yhp);
+            z1 = _mm_addsub_ps(tmp1, tmp2);
+            two_phase_acc_reg = _mm_addsub_ps(tmp1p, tmp2p);
+            yl_hi = _mm_moveldup_ps(z1);
+            yh_hi = _mm_movehdup_ps(z1);
+
+            //next four samples
+            _in_common += 4;
+
+            aux = _mm_mul_ps(code_phase_step_chips_reg, indexn);
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    // code chip index = floor(step * n + shift - rem) mod code_length
+                    aux2 = _mm_floor_ps(_mm_add_ps(aux, tap_offset[n_vec]));
+                    cTrunc = _mm_round_ps(_mm_div_ps(aux2, code_length_chips_reg_f), (_MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+                    local_code_chip_index_reg = _mm_cvtps_epi32(_mm_sub_ps(aux2, _mm_mul_ps(cTrunc, code_length_chips_reg_f)));
+                    local_code_chip_index_reg = _mm_add_epi32(local_code_chip_index_reg, _mm_and_si128(code_length_chips_reg_i, _mm_cmplt_epi32(local_code_chip_index_reg, zeros)));
+                    _mm_store_si128((__m128i*)local_code_chip_index, local_code_chip_index_reg);
+
+                    code = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)&local_code[local_code_chip_index[0]]);
+                    code = _mm_loadh_pi(code, (const __m64*)&local_code[local_code_chip_index[1]]);
+                    tmp1 = _mm_mul_ps(code, yl_lo);
+                    code = _mm_shuffle_ps(code, code, 0xB1);
+                    tmp2 = _mm_mul_ps(code, yh_lo);
+                    acc[n_vec] = _mm_add_ps(acc[n_vec], _mm_addsub_ps(tmp1, tmp2));
+
+                    code = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)&local_code[local_code_chip_index[2]]);
+                    code = _mm_loadh_pi(code, (const __m64*)&local_code[local_code_chip_index[3]]);
+                    tmp1 = _mm_mul_ps(code, yl_hi);
+                    code = _mm_shuffle_ps(code, code, 0xB1);
+                    tmp2 = _mm_mul_ps(code, yh_hi);
+                    acc[n_vec] = _mm_add_ps(acc[n_vec], _mm_addsub_ps(tmp1, tmp2));
+                }
+            indexn = _mm_add_ps(indexn, fours);
+
+            // Regenerate phase
+            if ((number % 64) == 0)
+                {
+                    tmp1 = _mm_mul_ps(two_phase_acc_reg, two_phase_acc_reg);
+                    tmp2 = _mm_hadd_ps(tmp1, tmp1);
+                    tmp1 = _mm_shuffle_ps(tmp2, tmp2, 0xD8);
+                    tmp2 = _mm_sqrt_ps(tmp1);
+                    two_phase_acc_reg = _mm_div_ps(two_phase_acc_reg, tmp2);
+                }
+        }
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            _mm_store_ps((float*)dotProductVector, acc[n_vec]); // Store the results back into the dot product vector
+            dotProduct = lv_cmake(0,0);
+            for (i = 0; i < 2; ++i)
+                {
+                    dotProduct = dotProduct + dotProductVector[i];
+                }
+            result[n_vec] = dotProduct;
+        }
+    volk_gnsssdr_free(acc);
+
+    _mm_store_ps((float*)two_phase_acc, two_phase_acc_reg);
+    (*phase) = two_phase_acc[0];
+
+    for(n = sse_iters * 4; n < num_points; n++)
+        {
+            tmp32_1 = in_common[n] * (*phase);
+            (*phase) *= phase_inc;
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    local_code_chip_index_ = (int)floor(code_phase_step_chips * (float)n + shifts_chips[n_vec] - rem_code_phase_chips);
+                    if (local_code_chip_index_ < 0) local_code_chip_index_ += (int)code_length_chips * (abs(local_code_chip_index_) / code_length_chips + 1);
+                    local_code_chip_index_ = local_code_chip_index_ % code_length_chips;
+                    result[n_vec] += tmp32_1 * local_code[local_code_chip_index_];
+                }
+        }
+}
+#endif /* LV_HAVE_SSE4_1 */
+
+
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+static inline void volk_gnsssdr_32fc_x2_resampler_rotator_dot_prod_32fc_xn_u_avx2(lv_32fc_t* result, const lv_32fc_t* in_common, const lv_32fc_t phase_inc, lv_32fc_t* phase, const lv_32fc_t* local_code, float rem_code_phase_chips, float code_phase_step_chips, float* shifts_chips, unsigned int code_length_chips, int num_a_vectors, unsigned int num_points)
+{
+    lv_32fc_t dotProduct = lv_cmake(0,0);
+    lv_32fc_t tmp32_1;
+    const unsigned int avx_iters = num_points / 4;
+    int n_vec;
+    int i;
+    int local_code_chip_index_;
+    unsigned int number;
+    unsigned int n;
+    const lv_32fc_t* _in_common = in_common;
+    lv_32fc_t _phase = (*phase);
+
+    __VOLK_ATTR_ALIGNED(32) lv_32fc_t dotProductVector[4];
+
+    __m256* acc = (__m256*)volk_gnsssdr_malloc(num_a_vectors * sizeof(__m256), volk_gnsssdr_get_alignment());
+    __m128* tap_offset = (__m128*)volk_gnsssdr_malloc(num_a_vectors * sizeof(__m128), volk_gnsssdr_get_alignment());
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            acc[n_vec] = _mm256_setzero_ps();
+            tap_offset[n_vec] = _mm_sub_ps(_mm_set_ps1(shifts_chips[n_vec]), _mm_set_ps1(rem_code_phase_chips));
+        }
+
+    // code resampler registers
+    const __m128 fours = _mm_set1_ps(4.0f);
+    const __m128 code_phase_step_chips_reg = _mm_set_ps1(code_phase_step_chips);
+    const __m128 code_length_chips_reg_f = _mm_set_ps1((float)code_length_chips);
+    const __m128i code_length_chips_reg_i = _mm_set1_epi32((int)code_length_chips);
+    const __m128i zeros = _mm_setzero_si128();
+    __m128 indexn = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+    __m128 aux, aux2, cTrunc;
+    __m128i local_code_chip_index_reg;
+
+    // phase rotation registers
+    __m256 a, four_phase_acc_reg, yl, yh, tmp1, tmp1p, tmp2, tmp2p, z;
+
+    __VOLK_ATTR_ALIGNED(32) lv_32fc_t four_phase_inc[4];
+    const lv_32fc_t phase_inc2 = phase_inc * phase_inc;
+    const lv_32fc_t phase_inc3 = phase_inc2 * phase_inc;
+    const lv_32fc_t phase_inc4 = phase_inc3 * phase_inc;
+    four_phase_inc[0] = phase_inc4;
+    four_phase_inc[1] = phase_inc4;
+    four_phase_inc[2] = phase_inc4;
+    four_phase_inc[3] = phase_inc4;
+    const __m256 four_phase_inc_reg = _mm256_load_ps((float*)four_phase_inc);
+
+    __VOLK_ATTR_ALIGNED(32) lv_32fc_t four_phase_acc[4];
+    four_phase_acc[0] = _phase;
+    four_phase_acc[1] = _phase * phase_inc;
+    four_phase_acc[2] = _phase * phase_inc2;
+    four_phase_acc[3] = _phase * phase_inc3;
+    four_phase_acc_reg = _mm256_load_ps((float*)four_phase_acc);
+
+    const __m256 ylp = _mm256_moveldup_ps(four_phase_inc_reg);
+    const __m256 yhp = _mm256_movehdup_ps(four_phase_inc_reg);
+
+    for(number = 0; number < avx_iters; number++)
+        {
+            // Phase rotation on operand in_common starts here:
+            a = _mm256_loadu_ps((float*)_in_common);
+            __builtin_prefetch(_in_common + 16);
+            yl = _mm256_moveldup_ps(four_phase_acc_reg); // Load yl with cr,cr,dr,dr
+            yh = _mm256_movehdup_ps(four_phase_acc_reg);
+            tmp1 = _mm256_mul_ps(a, yl);
+            tmp1p = _mm256_mul_ps(four_phase_acc_reg, ylp);
+            a = _mm256_shuffle_ps(a, a, 0xB1);
+            four_phase_acc_reg = _mm256_shuffle_ps(four_phase_acc_reg, four_phase_acc_reg, 0xB1);
+            tmp2 = _mm256_mul_ps(a, yh);
+            tmp2p = _mm256_mul_ps(four_phase_acc_reg, yhp);
+            z = _mm256_addsub_ps(tmp1, tmp2);
+            four_phase_acc_reg = _mm256_addsub_ps(tmp1p, tmp2p);
+
+            yl = _mm256_moveldup_ps(z); // Load yl with cr,cr,dr,dr
+            yh = _mm256_movehdup_ps(z);
+
+            //next four samples
+            _in_common += 4;
+
+            aux = _mm_mul_ps(code_phase_step_chips_reg, indexn);
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    // code chip index = floor(step * n + shift - rem) mod code_length
+                    aux2 = _mm_floor_ps(_mm_add_ps(aux, tap_offset[n_vec]));
+                    cTrunc = _mm_round_ps(_mm_div_ps(aux2, code_length_chips_reg_f), (_MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+                    local_code_chip_index_reg = _mm_cvtps_epi32(_mm_sub_ps(aux2, _mm_mul_ps(cTrunc, code_length_chips_reg_f)));
+                    local_code_chip_index_reg = _mm_add_epi32(local_code_chip_index_reg, _mm_and_si128(code_length_chips_reg_i, _mm_cmplt_epi32(local_code_chip_index_reg, zeros)));
+
+                    // each complex sample is gathered as a single 64-bit element
+                    a = _mm256_castpd_ps(_mm256_i32gather_pd((const double*)local_code, local_code_chip_index_reg, 8));
+                    tmp1 = _mm256_mul_ps(a, yl);
+                    a = _mm256_shuffle_ps(a, a, 0xB1);
+                    tmp2 = _mm256_mul_ps(a, yh);
+                    z = _mm256_addsub_ps(tmp1, tmp2);
+                    acc[n_vec] = _mm256_add_ps(acc[n_vec], z);
+                }
+            indexn = _mm_add_ps(indexn, fours);
+
+            // Regenerate phase
+            if ((number % 128) == 0)
+                {
+                    tmp1 = _mm256_mul_ps(four_phase_acc_reg, four_phase_acc_reg);
+                    tmp2 = _mm256_hadd_ps(tmp1, tmp1);
+                    tmp1 = _mm256_shuffle_ps(tmp2, tmp2, 0xD8);
+                    tmp2 = _mm256_sqrt_ps(tmp1);
+                    four_phase_acc_reg = _mm256_div_ps(four_phase_acc_reg, tmp2);
+                }
+        }
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            _mm256_store_ps((float*)dotProductVector, acc[n_vec]); // Store the results back into the dot product vector
+            dotProduct = lv_cmake(0,0);
+            for (i = 0; i < 4; ++i)
+                {
+                    dotProduct = dotProduct + dotProductVector[i];
+                }
+            result[n_vec] = dotProduct;
+        }
+    volk_gnsssdr_free(acc);
+    volk_gnsssdr_free(tap_offset);
+
+    tmp1 = _mm256_mul_ps(four_phase_acc_reg, four_phase_acc_reg);
+    tmp2 = _mm256_hadd_ps(tmp1, tmp1);
+    tmp1 = _mm256_shuffle_ps(tmp2, tmp2, 0xD8);
+    tmp2 = _mm256_sqrt_ps(tmp1);
+    four_phase_acc_reg = _mm256_div_ps(four_phase_acc_reg, tmp2);
+
+    _mm256_store_ps((float*)four_phase_acc, four_phase_acc_reg);
+    _phase  = four_phase_acc[0];
+    _mm256_zeroupper();
+
+    for(n = avx_iters * 4; n < num_points; n++)
+        {
+            tmp32_1 = *_in_common++ * _phase;
+            _phase *= phase_inc;
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    local_code_chip_index_ = (int)floor(code_phase_step_chips * (float)n + shifts_chips[n_vec] - rem_code_phase_chips);
+                    if (local_code_chip_index_ < 0) local_code_chip_index_ += (int)code_length_chips * (abs(local_code_chip_index_) / code_length_chips + 1);
+                    local_code_chip_index_ = local_code_chip_index_ % code_length_chips;
+                    result[n_vec] += tmp32_1 * local_code[local_code_chip_index_];
+                }
+        }
+    (*phase) = _phase;
+}
+#endif /* LV_HAVE_AVX2 */
+
+
+#ifdef LV_HAVE_NEON
+#include <arm_neon.h>
+
+static inline void volk_gnsssdr_32fc_x2_resampler_rotator_dot_prod_32fc_xn_neon(lv_32fc_t* result, const lv_32fc_t* in_common, const lv_32fc_t phase_inc, lv_32fc_t* phase, const lv_32fc_t* local_code, float rem_code_phase_chips, float code_phase_step_chips, float* shifts_chips, unsigned int code_length_chips, int num_a_vectors, unsigned int num_points)
+{
+    const unsigned int neon_iters = num_points / 4;
+    int n_vec;
+    int i;
+    unsigned int k;
+    unsigned int number;
+    unsigned int n;
+    int32_t local_code_chip_index_;
+    const lv_32fc_t* _in_common = in_common;
+    lv_32fc_t* _out = result;
+
+    lv_32fc_t _phase = (*phase);
+    lv_32fc_t tmp32_1;
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            _out[n_vec] = lv_cmake(0,0);
+        }
+
+    if (neon_iters > 0)
+        {
+            lv_32fc_t dotProduct = lv_cmake(0,0);
+            float32_t arg_phase0 = cargf(_phase);
+            float32_t arg_phase_inc = cargf(phase_inc);
+            float32_t phase_est;
+
+            lv_32fc_t ___phase4 = phase_inc * phase_inc * phase_inc * phase_inc;
+            __VOLK_ATTR_ALIGNED(16) float32_t __phase4_real[4] = { lv_creal(___phase4), lv_creal(___phase4), lv_creal(___phase4), lv_creal(___phase4) };
+            __VOLK_ATTR_ALIGNED(16) float32_t __phase4_imag[4] = { lv_cimag(___phase4), lv_cimag(___phase4), lv_cimag(___phase4), lv_cimag(___phase4) };
+
+            float32x4_t _phase4_real = vld1q_f32(__phase4_real);
+            float32x4_t _phase4_imag = vld1q_f32(__phase4_imag);
+
+            lv_32fc_t phase2 = (lv_32fc_t)(_phase) * phase_inc;
+            lv_32fc_t phase3 = phase2 * phase_inc;
+            lv_32fc_t phase4 = phase3 * phase_inc;
+
+            __VOLK_ATTR_ALIGNED(16) float32_t __phase_real[4] = { lv_creal((_phase)), lv_creal(phase2), lv_creal(phase3), lv_creal(phase4) };
+            __VOLK_ATTR_ALIGNED(16) float32_t __phase_imag[4] = { lv_cimag((_phase)), lv_cimag(phase2), lv_cimag(phase3), lv_cimag(phase4) };
+
+            float32x4_t _phase_real = vld1q_f32(__phase_real);
+            float32x4_t _phase_imag = vld1q_f32(__phase_imag);
+
+            __VOLK_ATTR_ALIGNED(32) lv_32fc_t dotProductVector[4];
+
+            float32x4x2_t a_val, b_val, tmp32_real, tmp32_imag;
+
+            // code resampler registers
+            const int32x4_t ones = vdupq_n_s32(1);
+            const float32x4_t fours = vdupq_n_f32(4.0f);
+            const float32x4_t code_phase_step_chips_reg = vdupq_n_f32(code_phase_step_chips);
+            const int32x4_t zeros = vdupq_n_s32(0);
+            const float32x4_t code_length_chips_reg_f = vdupq_n_f32((float)code_length_chips);
+            const int32x4_t code_length_chips_reg_i = vdupq_n_s32((int32_t)code_length_chips);
+            int32x4_t local_code_chip_index_reg, aux_i, negatives, ii;
+            float32x4_t aux, aux2, fi, c, j, cTrunc, base, indexn, reciprocal;
+            uint32x4_t igx;
+            __VOLK_ATTR_ALIGNED(16) const float vec[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+            __VOLK_ATTR_ALIGNED(16) int32_t local_code_chip_index[4];
+            __VOLK_ATTR_ALIGNED(16) float32_t code_real[4];
+            __VOLK_ATTR_ALIGNED(16) float32_t code_imag[4];
+            reciprocal = vrecpeq_f32(code_length_chips_reg_f);
+            reciprocal = vmulq_f32(vrecpsq_f32(code_length_chips_reg_f, reciprocal), reciprocal);
+            reciprocal = vmulq_f32(vrecpsq_f32(code_length_chips_reg_f, reciprocal), reciprocal); // this refinement is required!
+            indexn = vld1q_f32((float*)vec);
+
+            float32x4x2_t* accumulator1 = (float32x4x2_t*)volk_gnsssdr_malloc(num_a_vectors * sizeof(float32x4x2_t), volk_gnsssdr_get_alignment());
+            float32x4x2_t* accumulator2 = (float32x4x2_t*)volk_gnsssdr_malloc(num_a_vectors * sizeof(float32x4x2_t), volk_gnsssdr_get_alignment());
+            float32x4_t* tap_offset = (float32x4_t*)volk_gnsssdr_malloc(num_a_vectors * sizeof(float32x4_t), volk_gnsssdr_get_alignment());
+
+            for(n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    accumulator1[n_vec].val[0] = vdupq_n_f32(0.0f);
+                    accumulator1[n_vec].val[1] = vdupq_n_f32(0.0f);
+                    accumulator2[n_vec].val[0] = vdupq_n_f32(0.0f);
+                    accumulator2[n_vec].val[1] = vdupq_n_f32(0.0f);
+                    tap_offset[n_vec] = vsubq_f32(vdupq_n_f32(shifts_chips[n_vec]), vdupq_n_f32(rem_code_phase_chips));
+                }
+
+            for(number = 0; number < neon_iters; number++)
+                {
+                    /* load 4 complex numbers (float 32 bits each component) */
+                    b_val = vld2q_f32((float32_t*)_in_common);
+                    __builtin_prefetch(_in_common + 8);
+                    _in_common += 4;
+
+                    /* complex multiplication of four complex samples (float 32 bits each component) */
+                    tmp32_real.val[0] = vmulq_f32(b_val.val[0], _phase_real);
+                    tmp32_real.val[1] = vmulq_f32(b_val.val[1], _phase_imag);
+                    tmp32_imag.val[0] = vmulq_f32(b_val.val[0], _phase_imag);
+                    tmp32_imag.val[1] = vmulq_f32(b_val.val[1], _phase_real);
+
+                    b_val.val[0] = vsubq_f32(tmp32_real.val[0], tmp32_real.val[1]);
+                    b_val.val[1] = vaddq_f32(tmp32_imag.val[0], tmp32_imag.val[1]);
+
+                    /* compute next four phases */
+                    tmp32_real.val[0] = vmulq_f32(_phase_real, _phase4_real);
+                    tmp32_real.val[1] = vmulq_f32(_phase_imag, _phase4_imag);
+                    tmp32_imag.val[0] = vmulq_f32(_phase_real, _phase4_imag);
+                    tmp32_imag.val[1] = vmulq_f32(_phase_imag, _phase4_real);
+
+                    _phase_real = vsubq_f32(tmp32_real.val[0], tmp32_real.val[1]);
+                    _phase_imag = vaddq_f32(tmp32_imag.val[0], tmp32_imag.val[1]);
+
+                    // Regenerate phase
+                    if ((number % 128) == 0)
+                        {
+                            phase_est = arg_phase0 + (number + 1) * 4 * arg_phase_inc;
+
+                            _phase = lv_cmake(cos(phase_est), sin(phase_est));
+                            phase2 = _phase * phase_inc;
+                            phase3 = phase2 * phase_inc;
+                            phase4 = phase3 * phase_inc;
+
+                            __VOLK_ATTR_ALIGNED(16) float32_t ____phase_real[4] = { lv_creal((_phase)), lv_creal(phase2), lv_creal(phase3), lv_creal(phase4) };
+                            __VOLK_ATTR_ALIGNED(16) float32_t ____phase_imag[4] = { lv_cimag((_phase)), lv_cimag(phase2), lv_cimag(phase3), lv_cimag(phase4) };
+
+                            _phase_real = vld1q_f32(____phase_real);
+                            _phase_imag = vld1q_f32(____phase_imag);
+                        }
+
+                    aux = vmulq_f32(code_phase_step_chips_reg, indexn);
+                    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                        {
+                            aux2 = vaddq_f32(aux, tap_offset[n_vec]);
+
+                            //floor
+                            ii = vcvtq_s32_f32(aux2);
+                            fi = vcvtq_f32_s32(ii);
+                            igx = vcgtq_f32(fi, aux2);
+                            j = vcvtq_f32_s32(vandq_s32(vreinterpretq_s32_u32(igx), ones));
+                            aux2 = vsubq_f32(fi, j);
+
+                            // fmod
+                            c = vmulq_f32(aux2, reciprocal);
+                            ii = vcvtq_s32_f32(c);
+                            cTrunc = vcvtq_f32_s32(ii);
+                            base = vmulq_f32(cTrunc, code_length_chips_reg_f);
+                            aux2 = vsubq_f32(aux2, base);
+                            local_code_chip_index_reg = vcvtq_s32_f32(aux2);
+
+                            negatives = vreinterpretq_s32_u32(vcltq_s32(local_code_chip_index_reg, zeros));
+                            aux_i = vandq_s32(code_length_chips_reg_i, negatives);
+                            local_code_chip_index_reg = vaddq_s32(local_code_chip_index_reg, aux_i);
+
+                            vst1q_s32((int32_t*)local_code_chip_index, local_code_chip_index_reg);
+                            for(k = 0; k < 4; ++k)
+                                {
+                                    code_real[k] = lv_creal(local_code[local_code_chip_index[k]]);
+                                    code_imag[k] = lv_cimag(local_code[local_code_chip_index[k]]);
+                                }
+                            a_val.val[0] = vld1q_f32(code_real);
+                            a_val.val[1] = vld1q_f32(code_imag);
+
+                            // use 2 accumulators to remove inter-instruction data dependencies
+                            accumulator1[n_vec].val[0] = vmlaq_f32(accumulator1[n_vec].val[0], a_val.val[0], b_val.val[0]);
+                            accumulator2[n_vec].val[0] = vmlsq_f32(accumulator2[n_vec].val[0], a_val.val[1], b_val.val[1]);
+                            accumulator1[n_vec].val[1] = vmlaq_f32(accumulator1[n_vec].val[1], a_val.val[0], b_val.val[1]);
+                            accumulator2[n_vec].val[1] = vmlaq_f32(accumulator2[n_vec].val[1], a_val.val[1], b_val.val[0]);
+                        }
+                    indexn = vaddq_f32(indexn, fours);
+                }
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    accumulator1[n_vec].val[0] = vaddq_f32(accumulator1[n_vec].val[0], accumulator2[n_vec].val[0]);
+                    accumulator1[n_vec].val[1] = vaddq_f32(accumulator1[n_vec].val[1], accumulator2[n_vec].val[1]);
+                }
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    vst2q_f32((float32_t*)dotProductVector, accumulator1[n_vec]); // Store the results back into the dot product vector
+                    dotProduct = lv_cmake(0,0);
+                    for (i = 0; i < 4; ++i)
+                        {
+                            dotProduct = dotProduct + dotProductVector[i];
+                        }
+                    _out[n_vec] = dotProduct;
+                }
+            volk_gnsssdr_free(accumulator1);
+            volk_gnsssdr_free(accumulator2);
+            volk_gnsssdr_free(tap_offset);
+
+            vst1q_f32((float32_t*)__phase_real, _phase_real);
+            vst1q_f32((float32_t*)__phase_imag, _phase_imag);
+
+            _phase = lv_cmake((float32_t)__phase_real[0], (float32_t)__phase_imag[0]);
+        }
+
+    for(n = neon_iters * 4; n < num_points; n++)
+        {
+            tmp32_1 = in_common[n] * _phase;
+            _phase *= phase_inc;
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    local_code_chip_index_ = (int)floor(code_phase_step_chips * (float)n + shifts_chips[n_vec] - rem_code_phase_chips);
+                    if (local_code_chip_index_ < 0) local_code_chip_index_ += (int)code_length_chips * (abs(local_code_chip_index_) / code_length_chips + 1);
+                    local_code_chip_index_ = local_code_chip_index_ % code_length_chips;
+                    _out[n_vec] += tmp32_1 * local_code[local_code_chip_index_];
+                }
+        }
+    (*phase) = _phase;
+}
+
+#endif /* LV_HAVE_NEON */
+
+#endif /* INCLUDED_volk_gnsssdr_32fc_x2_resampler_rotator_dot_prod_32fc_xn_H */
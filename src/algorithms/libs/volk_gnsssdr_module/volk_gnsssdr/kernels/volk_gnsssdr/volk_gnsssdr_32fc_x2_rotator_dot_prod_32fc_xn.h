@@ -637,6 +637,482 @@ static inline void volk_gnsssdr_32fc_x2_rotator_dot_prod_32fc_xn_a_avx(lv_32fc_t
 #endif /* LV_HAVE_AVX */
 
 
+#if LV_HAVE_AVX2 && LV_HAVE_FMA
+#include <immintrin.h>
+static inline void volk_gnsssdr_32fc_x2_rotator_dot_prod_32fc_xn_u_avx2_fma(lv_32fc_t* result, const lv_32fc_t* in_common, const lv_32fc_t phase_inc, lv_32fc_t* phase, const lv_32fc_t** in_a, int num_a_vectors, unsigned int num_points)
+{
+    lv_32fc_t dotProduct = lv_cmake(0,0);
+    lv_32fc_t tmp32_1, tmp32_2;
+    const unsigned int avx_iters = num_points / 4;
+    int n_vec;
+    int i;
+    unsigned int number;
+    unsigned int n;
+    const lv_32fc_t** _in_a = in_a;
+    const lv_32fc_t* _in_common = in_common;
+    lv_32fc_t _phase = (*phase);
+
+    __VOLK_ATTR_ALIGNED(32) lv_32fc_t dotProductVector[4];
+
+    __m256* acc = (__m256*)volk_gnsssdr_malloc(num_a_vectors * sizeof(__m256), volk_gnsssdr_get_alignment());
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            acc[n_vec] = _mm256_setzero_ps();
+            result[n_vec] = lv_cmake(0, 0);
+        }
+
+    // phase rotation registers
+    __m256 a, four_phase_acc_reg, yl, yh, tmp1, tmp2, tmp2p, z;
+
+    __VOLK_ATTR_ALIGNED(32) lv_32fc_t four_phase_inc[4];
+    const lv_32fc_t phase_inc2 = phase_inc * phase_inc;
+    const lv_32fc_t phase_inc3 = phase_inc2 * phase_inc;
+    const lv_32fc_t phase_inc4 = phase_inc3 * phase_inc;
+    four_phase_inc[0] = phase_inc4;
+    four_phase_inc[1] = phase_inc4;
+    four_phase_inc[2] = phase_inc4;
+    four_phase_inc[3] = phase_inc4;
+    const __m256 four_phase_inc_reg = _mm256_load_ps((float*)four_phase_inc);
+
+    __VOLK_ATTR_ALIGNED(32) lv_32fc_t four_phase_acc[4];
+    four_phase_acc[0] = _phase;
+    four_phase_acc[1] = _phase * phase_inc;
+    four_phase_acc[2] = _phase * phase_inc2;
+    four_phase_acc[3] = _phase * phase_inc3;
+    four_phase_acc_reg = _mm256_load_ps((float*)four_phase_acc);
+
+    const __m256 ylp = _mm256_moveldup_ps(four_phase_inc_reg);
+    const __m256 yhp = _mm256_movehdup_ps(four_phase_inc_reg);
+
+    for(number = 0; number < avx_iters; number++)
+        {
+            // Phase rotation on operand in_common starts here:
+            a = _mm256_loadu_ps((float*)_in_common);
+            __builtin_prefetch(_in_common + 16);
+            yl = _mm256_moveldup_ps(four_phase_acc_reg); // Load yl with cr,cr,dr,dr
+            yh = _mm256_movehdup_ps(four_phase_acc_reg);
+            // the complex product a * y is fmaddsub(a, yl, swap(a) * yh)
+            tmp2 = _mm256_mul_ps(_mm256_permute_ps(a, 0xB1), yh);
+            tmp2p = _mm256_mul_ps(_mm256_permute_ps(four_phase_acc_reg, 0xB1), yhp);
+            z = _mm256_fmaddsub_ps(a, yl, tmp2);
+            four_phase_acc_reg = _mm256_fmaddsub_ps(four_phase_acc_reg, ylp, tmp2p);
+
+            yl = _mm256_moveldup_ps(z); // Load yl with cr,cr,dr,dr
+            yh = _mm256_movehdup_ps(z);
+
+            //next four samples
+            _in_common += 4;
+
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    a = _mm256_loadu_ps((float*)&(_in_a[n_vec][number * 4]));
+                    tmp2 = _mm256_mul_ps(_mm256_permute_ps(a, 0xB1), yh);
+                    acc[n_vec] = _mm256_add_ps(acc[n_vec], _mm256_fmaddsub_ps(a, yl, tmp2));
+                }
+            // Regenerate phase
+            if ((number % 128) == 0)
+                {
+                    tmp1 = _mm256_mul_ps(four_phase_acc_reg, four_phase_acc_reg);
+                    tmp2 = _mm256_hadd_ps(tmp1, tmp1);
+                    tmp1 = _mm256_shuffle_ps(tmp2, tmp2, 0xD8);
+                    tmp2 = _mm256_sqrt_ps(tmp1);
+                    four_phase_acc_reg = _mm256_div_ps(four_phase_acc_reg, tmp2);
+                }
+        }
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            _mm256_store_ps((float*)dotProductVector, acc[n_vec]); // Store the results back into the dot product vector
+            dotProduct = lv_cmake(0,0);
+            for (i = 0; i < 4; ++i)
+                {
+                    dotProduct = dotProduct + dotProductVector[i];
+                }
+            result[n_vec] = dotProduct;
+        }
+    volk_gnsssdr_free(acc);
+
+    tmp1 = _mm256_mul_ps(four_phase_acc_reg, four_phase_acc_reg);
+    tmp2 = _mm256_hadd_ps(tmp1, tmp1);
+    tmp1 = _mm256_shuffle_ps(tmp2, tmp2, 0xD8);
+    tmp2 = _mm256_sqrt_ps(tmp1);
+    four_phase_acc_reg = _mm256_div_ps(four_phase_acc_reg, tmp2);
+
+    _mm256_store_ps((float*)four_phase_acc, four_phase_acc_reg);
+    _phase  = four_phase_acc[0];
+    _mm256_zeroupper();
+
+    for(n = avx_iters * 4; n < num_points; n++)
+        {
+            tmp32_1 = *_in_common++ * _phase;
+            _phase *= phase_inc;
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    tmp32_2 = tmp32_1 * _in_a[n_vec][n];
+                    result[n_vec] += tmp32_2;
+                }
+        }
+    (*phase) = _phase;
+}
+#endif /* LV_HAVE_AVX2 && LV_HAVE_FMA */
+
+
+#if LV_HAVE_AVX2 && LV_HAVE_FMA
+#include <immintrin.h>
+static inline void volk_gnsssdr_32fc_x2_rotator_dot_prod_32fc_xn_a_avx2_fma(lv_32fc_t* result, const lv_32fc_t* in_common, const lv_32fc_t phase_inc, lv_32fc_t* phase, const lv_32fc_t** in_a, int num_a_vectors, unsigned int num_points)
+{
+    lv_32fc_t dotProduct = lv_cmake(0,0);
+    lv_32fc_t tmp32_1, tmp32_2;
+    const unsigned int avx_iters = num_points / 4;
+    int n_vec;
+    int i;
+    unsigned int number;
+    unsigned int n;
+    const lv_32fc_t** _in_a = in_a;
+    const lv_32fc_t* _in_common = in_common;
+    lv_32fc_t _phase = (*phase);
+
+    __VOLK_ATTR_ALIGNED(32) lv_32fc_t dotProductVector[4];
+
+    __m256* acc = (__m256*)volk_gnsssdr_malloc(num_a_vectors * sizeof(__m256), volk_gnsssdr_get_alignment());
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            acc[n_vec] = _mm256_setzero_ps();
+            result[n_vec] = lv_cmake(0, 0);
+        }
+
+    // phase rotation registers
+    __m256 a, four_phase_acc_reg, yl, yh, tmp1, tmp2, tmp2p, z;
+
+    __VOLK_ATTR_ALIGNED(32) lv_32fc_t four_phase_inc[4];
+    const lv_32fc_t phase_inc2 = phase_inc * phase_inc;
+    const lv_32fc_t phase_inc3 = phase_inc2 * phase_inc;
+    const lv_32fc_t phase_inc4 = phase_inc3 * phase_inc;
+    four_phase_inc[0] = phase_inc4;
+    four_phase_inc[1] = phase_inc4;
+    four_phase_inc[2] = phase_inc4;
+    four_phase_inc[3] = phase_inc4;
+    const __m256 four_phase_inc_reg = _mm256_load_ps((float*)four_phase_inc);
+
+    __VOLK_ATTR_ALIGNED(32) lv_32fc_t four_phase_acc[4];
+    four_phase_acc[0] = _phase;
+    four_phase_acc[1] = _phase * phase_inc;
+    four_phase_acc[2] = _phase * phase_inc2;
+    four_phase_acc[3] = _phase * phase_inc3;
+    four_phase_acc_reg = _mm256_load_ps((float*)four_phase_acc);
+
+    const __m256 ylp = _mm256_moveldup_ps(four_phase_inc_reg);
+    const __m256 yhp = _mm256_movehdup_ps(four_phase_inc_reg);
+
+    for(number = 0; number < avx_iters; number++)
+        {
+            // Phase rotation on operand in_common starts here:
+            a = _mm256_load_ps((float*)_in_common);
+            __builtin_prefetch(_in_common + 16);
+            yl = _mm256_moveldup_ps(four_phase_acc_reg); // Load yl with cr,cr,dr,dr
+            yh = _mm256_movehdup_ps(four_phase_acc_reg);
+            // the complex product a * y is fmaddsub(a, yl, swap(a) * yh)
+            tmp2 = _mm256_mul_ps(_mm256_permute_ps(a, 0xB1), yh);
+            tmp2p = _mm256_mul_ps(_mm256_permute_ps(four_phase_acc_reg, 0xB1), yhp);
+            z = _mm256_fmaddsub_ps(a, yl, tmp2);
+            four_phase_acc_reg = _mm256_fmaddsub_ps(four_phase_acc_reg, ylp, tmp2p);
+
+            yl = _mm256_moveldup_ps(z); // Load yl with cr,cr,dr,dr
+            yh = _mm256_movehdup_ps(z);
+
+            //next four samples
+            _in_common += 4;
+
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    a = _mm256_load_ps((float*)&(_in_a[n_vec][number * 4]));
+                    tmp2 = _mm256_mul_ps(_mm256_permute_ps(a, 0xB1), yh);
+                    acc[n_vec] = _mm256_add_ps(acc[n_vec], _mm256_fmaddsub_ps(a, yl, tmp2));
+                }
+            // Regenerate phase
+            if ((number % 128) == 0)
+                {
+                    tmp1 = _mm256_mul_ps(four_phase_acc_reg, four_phase_acc_reg);
+                    tmp2 = _mm256_hadd_ps(tmp1, tmp1);
+                    tmp1 = _mm256_shuffle_ps(tmp2, tmp2, 0xD8);
+                    tmp2 = _mm256_sqrt_ps(tmp1);
+                    four_phase_acc_reg = _mm256_div_ps(four_phase_acc_reg, tmp2);
+                }
+        }
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            _mm256_store_ps((float*)dotProductVector, acc[n_vec]); // Store the results back into the dot product vector
+            dotProduct = lv_cmake(0,0);
+            for (i = 0; i < 4; ++i)
+                {
+                    dotProduct = dotProduct + dotProductVector[i];
+                }
+            result[n_vec] = dotProduct;
+        }
+    volk_gnsssdr_free(acc);
+
+    tmp1 = _mm256_mul_ps(four_phase_acc_reg, four_phase_acc_reg);
+    tmp2 = _mm256_hadd_ps(tmp1, tmp1);
+    tmp1 = _mm256_shuffle_ps(tmp2, tmp2, 0xD8);
+    tmp2 = _mm256_sqrt_ps(tmp1);
+    four_phase_acc_reg = _mm256_div_ps(four_phase_acc_reg, tmp2);
+
+    _mm256_store_ps((float*)four_phase_acc, four_phase_acc_reg);
+    _phase  = four_phase_acc[0];
+    _mm256_zeroupper();
+
+    for(n = avx_iters * 4; n < num_points; n++)
+        {
+            tmp32_1 = *_in_common++ * _phase;
+            _phase *= phase_inc;
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    tmp32_2 = tmp32_1 * _in_a[n_vec][n];
+                    result[n_vec] += tmp32_2;
+                }
+        }
+    (*phase) = _phase;
+}
+#endif /* LV_HAVE_AVX2 && LV_HAVE_FMA */
+
+
+#ifdef LV_HAVE_AVX512F
+#include <immintrin.h>
+static inline void volk_gnsssdr_32fc_x2_rotator_dot_prod_32fc_xn_u_avx512f(lv_32fc_t* result, const lv_32fc_t* in_common, const lv_32fc_t phase_inc, lv_32fc_t* phase, const lv_32fc_t** in_a, int num_a_vectors, unsigned int num_points)
+{
+    lv_32fc_t dotProduct = lv_cmake(0,0);
+    lv_32fc_t tmp32_1, tmp32_2;
+    const unsigned int avx512_iters = num_points / 8;
+    int n_vec;
+    int i;
+    unsigned int number;
+    unsigned int n;
+    const lv_32fc_t** _in_a = in_a;
+    const lv_32fc_t* _in_common = in_common;
+    lv_32fc_t _phase = (*phase);
+
+    __VOLK_ATTR_ALIGNED(64) lv_32fc_t dotProductVector[8];
+
+    __m512* acc = (__m512*)volk_gnsssdr_malloc(num_a_vectors * sizeof(__m512), volk_gnsssdr_get_alignment());
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            acc[n_vec] = _mm512_setzero_ps();
+            result[n_vec] = lv_cmake(0, 0);
+        }
+
+    // phase rotation registers
+    __m512 a, eight_phase_acc_reg, yl, yh, tmp1, tmp2, tmp2p, z;
+
+    __VOLK_ATTR_ALIGNED(64) lv_32fc_t eight_phase_inc[8];
+    __VOLK_ATTR_ALIGNED(64) lv_32fc_t eight_phase_acc[8];
+    lv_32fc_t phase_inc_k = lv_cmake(1,0);
+    for (i = 0; i < 8; i++)
+        {
+            eight_phase_acc[i] = _phase * phase_inc_k;
+            phase_inc_k *= phase_inc;
+        }
+    for (i = 0; i < 8; i++)
+        {
+            eight_phase_inc[i] = phase_inc_k;
+        }
+    const __m512 eight_phase_inc_reg = _mm512_load_ps((float*)eight_phase_inc);
+    eight_phase_acc_reg = _mm512_load_ps((float*)eight_phase_acc);
+
+    const __m512 ylp = _mm512_moveldup_ps(eight_phase_inc_reg);
+    const __m512 yhp = _mm512_movehdup_ps(eight_phase_inc_reg);
+
+    for(number = 0; number < avx512_iters; number++)
+        {
+            // Phase rotation on operand in_common starts here:
+            a = _mm512_loadu_ps((float*)_in_common);
+            __builtin_prefetch(_in_common + 32);
+            yl = _mm512_moveldup_ps(eight_phase_acc_reg); // Load yl with cr,cr,dr,dr
+            yh = _mm512_movehdup_ps(eight_phase_acc_reg);
+            // the complex product a * y is fmaddsub(a, yl, swap(a) * yh)
+            tmp2 = _mm512_mul_ps(_mm512_permute_ps(a, 0xB1), yh);
+            tmp2p = _mm512_mul_ps(_mm512_permute_ps(eight_phase_acc_reg, 0xB1), yhp);
+            z = _mm512_fmaddsub_ps(a, yl, tmp2);
+            eight_phase_acc_reg = _mm512_fmaddsub_ps(eight_phase_acc_reg, ylp, tmp2p);
+
+            yl = _mm512_moveldup_ps(z); // Load yl with cr,cr,dr,dr
+            yh = _mm512_movehdup_ps(z);
+
+            //next eight samples
+            _in_common += 8;
+
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    a = _mm512_loadu_ps((float*)&(_in_a[n_vec][number * 8]));
+                    tmp2 = _mm512_mul_ps(_mm512_permute_ps(a, 0xB1), yh);
+                    acc[n_vec] = _mm512_add_ps(acc[n_vec], _mm512_fmaddsub_ps(a, yl, tmp2));
+                }
+            // Regenerate phase
+            if ((number % 64) == 0)
+                {
+                    tmp1 = _mm512_mul_ps(eight_phase_acc_reg, eight_phase_acc_reg);
+                    tmp2 = _mm512_add_ps(tmp1, _mm512_permute_ps(tmp1, 0xB1));
+                    tmp2 = _mm512_sqrt_ps(tmp2);
+                    eight_phase_acc_reg = _mm512_div_ps(eight_phase_acc_reg, tmp2);
+                }
+        }
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            _mm512_store_ps((float*)dotProductVector, acc[n_vec]); // Store the results back into the dot product vector
+            dotProduct = lv_cmake(0,0);
+            for (i = 0; i < 8; ++i)
+                {
+                    dotProduct = dotProduct + dotProductVector[i];
+                }
+            result[n_vec] = dotProduct;
+        }
+    volk_gnsssdr_free(acc);
+
+    tmp1 = _mm512_mul_ps(eight_phase_acc_reg, eight_phase_acc_reg);
+    tmp2 = _mm512_add_ps(tmp1, _mm512_permute_ps(tmp1, 0xB1));
+    tmp2 = _mm512_sqrt_ps(tmp2);
+    eight_phase_acc_reg = _mm512_div_ps(eight_phase_acc_reg, tmp2);
+
+    _mm512_store_ps((float*)eight_phase_acc, eight_phase_acc_reg);
+    _phase  = eight_phase_acc[0];
+    _mm256_zeroupper();
+
+    for(n = avx512_iters * 8; n < num_points; n++)
+        {
+            tmp32_1 = *_in_common++ * _phase;
+            _phase *= phase_inc;
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    tmp32_2 = tmp32_1 * _in_a[n_vec][n];
+                    result[n_vec] += tmp32_2;
+                }
+        }
+    (*phase) = _phase;
+}
+#endif /* LV_HAVE_AVX512F */
+
+
+#ifdef LV_HAVE_AVX512F
+#include <immintrin.h>
+static inline void volk_gnsssdr_32fc_x2_rotator_dot_prod_32fc_xn_a_avx512f(lv_32fc_t* result, const lv_32fc_t* in_common, const lv_32fc_t phase_inc, lv_32fc_t* phase, const lv_32fc_t** in_a, int num_a_vectors, unsigned int num_points)
+{
+    lv_32fc_t dotProduct = lv_cmake(0,0);
+    lv_32fc_t tmp32_1, tmp32_2;
+    const unsigned int avx512_iters = num_points / 8;
+    int n_vec;
+    int i;
+    unsigned int number;
+    unsigned int n;
+    const lv_32fc_t** _in_a = in_a;
+    const lv_32fc_t* _in_common = in_common;
+    lv_32fc_t _phase = (*phase);
+
+    __VOLK_ATTR_ALIGNED(64) lv_32fc_t dotProductVector[8];
+
+    __m512* acc = (__m512*)volk_gnsssdr_malloc(num_a_vectors * sizeof(__m512), volk_gnsssdr_get_alignment());
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            acc[n_vec] = _mm512_setzero_ps();
+            result[n_vec] = lv_cmake(0, 0);
+        }
+
+    // phase rotation registers
+    __m512 a, eight_phase_acc_reg, yl, yh, tmp1, tmp2, tmp2p, z;
+
+    __VOLK_ATTR_ALIGNED(64) lv_32fc_t eight_phase_inc[8];
+    __VOLK_ATTR_ALIGNED(64) lv_32fc_t eight_phase_acc[8];
+    lv_32fc_t phase_inc_k = lv_cmake(1,0);
+    for (i = 0; i < 8; i++)
+        {
+            eight_phase_acc[i] = _phase * phase_inc_k;
+            phase_inc_k *= phase_inc;
+        }
+    for (i = 0; i < 8; i++)
+        {
+            eight_phase_inc[i] = phase_inc_k;
+        }
+    const __m512 eight_phase_inc_reg = _mm512_load_ps((float*)eight_phase_inc);
+    eight_phase_acc_reg = _mm512_load_ps((float*)eight_phase_acc);
+
+    const __m512 ylp = _mm512_moveldup_ps(eight_phase_inc_reg);
+    const __m512 yhp = _mm512_movehdup_ps(eight_phase_inc_reg);
+
+    for(number = 0; number < avx512_iters; number++)
+        {
+            // Phase rotation on operand in_common starts here:
+            a = _mm512_load_ps((float*)_in_common);
+            __builtin_prefetch(_in_common + 32);
+            yl = _mm512_moveldup_ps(eight_phase_acc_reg); // Load yl with cr,cr,dr,dr
+            yh = _mm512_movehdup_ps(eight_phase_acc_reg);
+            // the complex product a * y is fmaddsub(a, yl, swap(a) * yh)
+            tmp2 = _mm512_mul_ps(_mm512_permute_ps(a, 0xB1), yh);
+            tmp2p = _mm512_mul_ps(_mm512_permute_ps(eight_phase_acc_reg, 0xB1), yhp);
+            z = _mm512_fmaddsub_ps(a, yl, tmp2);
+            eight_phase_acc_reg = _mm512_fmaddsub_ps(eight_phase_acc_reg, ylp, tmp2p);
+
+            yl = _mm512_moveldup_ps(z); // Load yl with cr,cr,dr,dr
+            yh = _mm512_movehdup_ps(z);
+
+            //next eight samples
+            _in_common += 8;
+
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    a = _mm512_load_ps((float*)&(_in_a[n_vec][number * 8]));
+                    tmp2 = _mm512_mul_ps(_mm512_permute_ps(a, 0xB1), yh);
+                    acc[n_vec] = _mm512_add_ps(acc[n_vec], _mm512_fmaddsub_ps(a, yl, tmp2));
+                }
+            // Regenerate phase
+            if ((number % 64) == 0)
+                {
+                    tmp1 = _mm512_mul_ps(eight_phase_acc_reg, eight_phase_acc_reg);
+                    tmp2 = _mm512_add_ps(tmp1, _mm512_permute_ps(tmp1, 0xB1));
+                    tmp2 = _mm512_sqrt_ps(tmp2);
+                    eight_phase_acc_reg = _mm512_div_ps(eight_phase_acc_reg, tmp2);
+                }
+        }
+
+    for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+        {
+            _mm512_store_ps((float*)dotProductVector, acc[n_vec]); // Store the results back into the dot product vector
+            dotProduct = lv_cmake(0,0);
+            for (i = 0; i < 8; ++i)
+                {
+                    dotProduct = dotProduct + dotProductVector[i];
+                }
+            result[n_vec] = dotProduct;
+        }
+    volk_gnsssdr_free(acc);
+
+    tmp1 = _mm512_mul_ps(eight_phase_acc_reg, eight_phase_acc_reg);
+    tmp2 = _mm512_add_ps(tmp1, _mm512_permute_ps(tmp1, 0xB1));
+    tmp2 = _mm512_sqrt_ps(tmp2);
+    eight_phase_acc_reg = _mm512_div_ps(eight_phase_acc_reg, tmp2);
+
+    _mm512_store_ps((float*)eight_phase_acc, eight_phase_acc_reg);
+    _phase  = eight_phase_acc[0];
+    _mm256_zeroupper();
+
+    for(n = avx512_iters * 8; n < num_points; n++)
+        {
+            tmp32_1 = *_in_common++ * _phase;
+            _phase *= phase_inc;
+            for (n_vec = 0; n_vec < num_a_vectors; n_vec++)
+                {
+                    tmp32_2 = tmp32_1 * _in_a[n_vec][n];
+                    result[n_vec] += tmp32_2;
+                }
+        }
+    (*phase) = _phase;
+}
+#endif /* LV_HAVE_AVX512F */
+
+
 #ifdef LV_HAVE_NEON
 #include <arm_neon.h>
 
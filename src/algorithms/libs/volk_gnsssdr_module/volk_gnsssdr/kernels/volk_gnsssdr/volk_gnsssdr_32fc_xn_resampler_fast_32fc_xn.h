@@ -0,0 +1,370 @@
+/*!
+ * \file volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn.h
+ * \brief VOLK_GNSSSDR kernel: Resamples N complex 32-bit float vectors using zero hold resample algorithm
+ * driven by a fixed-point code NCO.
+ * \authors <ul>
+ *          <li> GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *          </ul>
+ *
+ * VOLK_GNSSSDR kernel that resamples N complex 32-bit float vectors using zero hold resample algorithm.
+ * It produces the same replicas as volk_gnsssdr_32fc_xn_resampler_32fc_xn, but the code phase of each
+ * tap is kept in a 32.32 fixed-point accumulator that is advanced by an integer addition and wrapped
+ * by a compare and subtract, instead of computing a floor and a modulo for every sample. This is
+ * specially worth it for long codes (GPS L2CM, Galileo E5a), where the float product
+ * code_phase_step_chips * n also loses resolution at the end of the integration.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+/*!
+ * \page volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn
+ *
+ * \b Overview
+ *
+ * Resamples a complex vector (32-bit float each component), providing \p num_out_vectors outputs.
+ * The code phase is handled in fixed point with 2^-32 chip resolution, so the chip index can
+ * differ from the one of volk_gnsssdr_32fc_xn_resampler_32fc_xn when a sample falls within
+ * the float rounding error of a chip transition.
+ * WARNING: the absolute value of \p code_phase_step_chips must be smaller than \p code_length_chips.
+ *
+ * <b>Dispatcher Prototype</b>
+ * \code
+ * void volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn(lv_32fc_t** result, const lv_32fc_t* local_code, float rem_code_phase_chips, float code_phase_step_chips, float* shifts_chips, unsigned int code_length_chips, int num_out_vectors, unsigned int num_points)
+ * \endcode
+ *
+ * \b Inputs
+ * \li local_code:            One of the vectors to be multiplied.
+ * \li rem_code_phase_chips:  Remnant code phase [chips].
+ * \li code_phase_step_chips: Phase increment per sample [chips/sample].
+ * \li shifts_chips:          Vector of floats that defines the spacing (in chips) between the replicas of \p local_code
+ * \li code_length_chips:     Code length in chips.
+ * \li num_out_vectors        Number of output vectors.
+ * \li num_points:            The number of data values to be in the resampled vector.
+ *
+ * \b Outputs
+ * \li result:                Pointer to a vector of pointers where the results will be stored.
+ *
+ */
+
+#ifndef INCLUDED_volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn_H
+#define INCLUDED_volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h> /* llabs */
+#include <volk_gnsssdr/volk_gnsssdr_common.h>
+#include <volk_gnsssdr/volk_gnsssdr_complex.h>
+
+#define VOLK_GNSSSDR_CODE_NCO_ONE 4294967296.0 /* 2^32, one chip in the fixed-point code NCO */
+
+
+/*
+ * Initial fixed-point code phase of a tap, wrapped into [0, code_length_chips)
+ */
+static inline int64_t volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn_start_phase(float rem_code_phase_chips, float shift_chips, unsigned int code_length_chips)
+{
+    const int64_t code_length_fx = (int64_t)code_length_chips << 32;
+    int64_t phase = llround(((double)shift_chips - (double)rem_code_phase_chips) * VOLK_GNSSSDR_CODE_NCO_ONE);
+    phase %= code_length_fx;
+    if (phase < 0) phase += code_length_fx;
+    return phase;
+}
+
+
+#ifdef LV_HAVE_GENERIC
+
+static inline void volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn_generic(lv_32fc_t** result, const lv_32fc_t* local_code, float rem_code_phase_chips, float code_phase_step_chips, float* shifts_chips, unsigned int code_length_chips, int num_out_vectors, unsigned int num_points)
+{
+    const int64_t code_length_fx = (int64_t)code_length_chips << 32;
+    const int64_t step_fx = llround((double)code_phase_step_chips * VOLK_GNSSSDR_CODE_NCO_ONE);
+    int64_t phase;
+    int current_correlator_tap;
+    unsigned int n;
+    for (current_correlator_tap = 0; current_correlator_tap < num_out_vectors; current_correlator_tap++)
+        {
+            phase = volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn_start_phase(rem_code_phase_chips, shifts_chips[current_correlator_tap], code_length_chips);
+            for (n = 0; n < num_points; n++)
+                {
+                    result[current_correlator_tap][n] = local_code[phase >> 32];
+                    phase += step_fx;
+                    if (phase >= code_length_fx) phase -= code_length_fx;
+                    if (phase < 0) phase += code_length_fx;
+                }
+        }
+}
+
+#endif /*LV_HAVE_GENERIC*/
+
+
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+static inline void volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn_u_avx2(lv_32fc_t** result, const lv_32fc_t* local_code, float rem_code_phase_chips, float code_phase_step_chips, float* shifts_chips, unsigned int code_length_chips, int num_out_vectors, unsigned int num_points)
+{
+    lv_32fc_t** _result = result;
+    const unsigned int avx_iters = num_points / 8;
+    const int64_t code_length_fx = (int64_t)code_length_chips << 32;
+    const int64_t step_fx = llround((double)code_phase_step_chips * VOLK_GNSSSDR_CODE_NCO_ONE);
+    // The accumulators are not wrapped inside the loop, which would put a compare
+    // in the dependency chain. They are kept in [lane_offset, lane_offset + code_length)
+    // at the start of each chunk, and a chunk is short enough for them not to leave
+    // [0, 2 * code_length), so the chip index only needs a single conditional subtraction.
+    const int64_t lane_offset = (step_fx < 0) ? code_length_fx : 0;
+    const int64_t abs_eight_steps = llabs(8 * step_fx);
+    unsigned int chunk_iters = (abs_eight_steps > 0) ? (unsigned int)((code_length_fx - 1) / abs_eight_steps) : avx_iters;
+    int current_correlator_tap;
+    unsigned int n, m, j;
+    int64_t phase;
+    int k;
+    if (chunk_iters == 0) chunk_iters = 1;  // out of the supported range, one iteration per chunk still works
+
+    const __m256i code_length_reg = _mm256_set1_epi64x(code_length_fx);
+    const __m256i code_length_minus1_reg = _mm256_set1_epi64x(code_length_fx - 1);
+    const __m256i eight_steps = _mm256_set1_epi64x(8 * step_fx);
+    __m256i phase_lo, phase_hi, index_lo, index_hi;
+    __m256d code_lo, code_hi;
+    __VOLK_ATTR_ALIGNED(32) int64_t phases[8];
+
+    for (current_correlator_tap = 0; current_correlator_tap < num_out_vectors; current_correlator_tap++)
+        {
+            // the eight lanes start at samples 0,...,7
+            phase = volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn_start_phase(rem_code_phase_chips, shifts_chips[current_correlator_tap], code_length_chips);
+            for (k = 0; k < 8; k++)
+                {
+                    phases[k] = phase + lane_offset;
+                    phase += step_fx;
+                    if (phase >= code_length_fx) phase -= code_length_fx;
+                    if (phase < 0) phase += code_length_fx;
+                }
+            n = 0;
+            while (n < avx_iters)
+                {
+                    m = avx_iters - n;
+                    if (m > chunk_iters) m = chunk_iters;
+                    phase_lo = _mm256_load_si256((__m256i*)phases);
+                    phase_hi = _mm256_load_si256((__m256i*)(phases + 4));
+                    for (j = 0; j < m; j++)
+                        {
+                            index_lo = _mm256_sub_epi64(phase_lo, _mm256_and_si256(_mm256_cmpgt_epi64(phase_lo, code_length_minus1_reg), code_length_reg));
+                            index_hi = _mm256_sub_epi64(phase_hi, _mm256_and_si256(_mm256_cmpgt_epi64(phase_hi, code_length_minus1_reg), code_length_reg));
+                            // the integer part of the phase is the chip index, and each complex
+                            // sample is gathered as a single 64-bit element
+                            code_lo = _mm256_i64gather_pd((const double*)local_code, _mm256_srli_epi64(index_lo, 32), 8);
+                            code_hi = _mm256_i64gather_pd((const double*)local_code, _mm256_srli_epi64(index_hi, 32), 8);
+                            _mm256_storeu_pd((double*)&_result[current_correlator_tap][(n + j) * 8], code_lo);
+                            _mm256_storeu_pd((double*)&_result[current_correlator_tap][(n + j) * 8 + 4], code_hi);
+                            phase_lo = _mm256_add_epi64(phase_lo, eight_steps);
+                            phase_hi = _mm256_add_epi64(phase_hi, eight_steps);
+                        }
+                    _mm256_store_si256((__m256i*)phases, phase_lo);
+                    _mm256_store_si256((__m256i*)(phases + 4), phase_hi);
+                    for (k = 0; k < 8; k++)
+                        {
+                            while (phases[k] >= lane_offset + code_length_fx) phases[k] -= code_length_fx;
+                            while (phases[k] < lane_offset) phases[k] += code_length_fx;
+                        }
+                    n += m;
+                }
+            _mm256_zeroupper();
+            phase = phases[0] - lane_offset;
+            for(n = avx_iters * 8; n < num_points; n++)
+                {
+                    _result[current_correlator_tap][n] = local_code[phase >> 32];
+                    phase += step_fx;
+                    if (phase >= code_length_fx) phase -= code_length_fx;
+                    if (phase < 0) phase += code_length_fx;
+                }
+        }
+}
+
+#endif /* LV_HAVE_AVX2 */
+
+
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+static inline void volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn_a_avx2(lv_32fc_t** result, const lv_32fc_t* local_code, float rem_code_phase_chips, float code_phase_step_chips, float* shifts_chips, unsigned int code_length_chips, int num_out_vectors, unsigned int num_points)
+{
+    lv_32fc_t** _result = result;
+    const unsigned int avx_iters = num_points / 8;
+    const int64_t code_length_fx = (int64_t)code_length_chips << 32;
+    const int64_t step_fx = llround((double)code_phase_step_chips * VOLK_GNSSSDR_CODE_NCO_ONE);
+    // The accumulators are not wrapped inside the loop, which would put a compare
+    // in the dependency chain. They are kept in [lane_offset, lane_offset + code_length)
+    // at the start of each chunk, and a chunk is short enough for them not to leave
+    // [0, 2 * code_length), so the chip index only needs a single conditional subtraction.
+    const int64_t lane_offset = (step_fx < 0) ? code_length_fx : 0;
+    const int64_t abs_eight_steps = llabs(8 * step_fx);
+    unsigned int chunk_iters = (abs_eight_steps > 0) ? (unsigned int)((code_length_fx - 1) / abs_eight_steps) : avx_iters;
+    int current_correlator_tap;
+    unsigned int n, m, j;
+    int64_t phase;
+    int k;
+    if (chunk_iters == 0) chunk_iters = 1;  // out of the supported range, one iteration per chunk still works
+
+    const __m256i code_length_reg = _mm256_set1_epi64x(code_length_fx);
+    const __m256i code_length_minus1_reg = _mm256_set1_epi64x(code_length_fx - 1);
+    const __m256i eight_steps = _mm256_set1_epi64x(8 * step_fx);
+    __m256i phase_lo, phase_hi, index_lo, index_hi;
+    __m256d code_lo, code_hi;
+    __VOLK_ATTR_ALIGNED(32) int64_t phases[8];
+
+    for (current_correlator_tap = 0; current_correlator_tap < num_out_vectors; current_correlator_tap++)
+        {
+            // the eight lanes start at samples 0,...,7
+            phase = volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn_start_phase(rem_code_phase_chips, shifts_chips[current_correlator_tap], code_length_chips);
+            for (k = 0; k < 8; k++)
+                {
+                    phases[k] = phase + lane_offset;
+                    phase += step_fx;
+                    if (phase >= code_length_fx) phase -= code_length_fx;
+                    if (phase < 0) phase += code_length_fx;
+                }
+            n = 0;
+            while (n < avx_iters)
+                {
+                    m = avx_iters - n;
+                    if (m > chunk_iters) m = chunk_iters;
+                    phase_lo = _mm256_load_si256((__m256i*)phases);
+                    phase_hi = _mm256_load_si256((__m256i*)(phases + 4));
+                    for (j = 0; j < m; j++)
+                        {
+                            index_lo = _mm256_sub_epi64(phase_lo, _mm256_and_si256(_mm256_cmpgt_epi64(phase_lo, code_length_minus1_reg), code_length_reg));
+                            index_hi = _mm256_sub_epi64(phase_hi, _mm256_and_si256(_mm256_cmpgt_epi64(phase_hi, code_length_minus1_reg), code_length_reg));
+                            // the integer part of the phase is the chip index, and each complex
+                            // sample is gathered as a single 64-bit element
+                            code_lo = _mm256_i64gather_pd((const double*)local_code, _mm256_srli_epi64(index_lo, 32), 8);
+                            code_hi = _mm256_i64gather_pd((const double*)local_code, _mm256_srli_epi64(index_hi, 32), 8);
+                            _mm256_store_pd((double*)&_result[current_correlator_tap][(n + j) * 8], code_lo);
+                            _mm256_store_pd((double*)&_result[current_correlator_tap][(n + j) * 8 + 4], code_hi);
+                            phase_lo = _mm256_add_epi64(phase_lo, eight_steps);
+                            phase_hi = _mm256_add_epi64(phase_hi, eight_steps);
+                        }
+                    _mm256_store_si256((__m256i*)phases, phase_lo);
+                    _mm256_store_si256((__m256i*)(phases + 4), phase_hi);
+                    for (k = 0; k < 8; k++)
+                        {
+                            while (phases[k] >= lane_offset + code_length_fx) phases[k] -= code_length_fx;
+                            while (phases[k] < lane_offset) phases[k] += code_length_fx;
+                        }
+                    n += m;
+                }
+            _mm256_zeroupper();
+            phase = phases[0] - lane_offset;
+            for(n = avx_iters * 8; n < num_points; n++)
+                {
+                    _result[current_correlator_tap][n] = local_code[phase >> 32];
+                    phase += step_fx;
+                    if (phase >= code_length_fx) phase -= code_length_fx;
+                    if (phase < 0) phase += code_length_fx;
+                }
+        }
+}
+
+#endif /* LV_HAVE_AVX2 */
+
+
+
+#ifdef LV_HAVE_NEON
+#include <arm_neon.h>
+static inline void volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn_neon(lv_32fc_t** result, const lv_32fc_t* local_code, float rem_code_phase_chips, float code_phase_step_chips, float* shifts_chips, unsigned int code_length_chips, int num_out_vectors, unsigned int num_points)
+{
+    lv_32fc_t** _result = result;
+    const unsigned int neon_iters = num_points / 4;
+    const int64_t code_length_fx = (int64_t)code_length_chips << 32;
+    const int64_t step_fx = llround((double)code_phase_step_chips * VOLK_GNSSSDR_CODE_NCO_ONE);
+    // Same chunks as the AVX2 version, with four lanes. There is no gather,
+    // so the chip indexes are taken out of the accumulators one by one.
+    const int64_t lane_offset = (step_fx < 0) ? code_length_fx : 0;
+    const int64_t abs_four_steps = llabs(4 * step_fx);
+    unsigned int chunk_iters = (abs_four_steps > 0) ? (unsigned int)((code_length_fx - 1) / abs_four_steps) : neon_iters;
+    int current_correlator_tap;
+    unsigned int n, m, j;
+    int64_t phase;
+    int k;
+    lv_32fc_t* out;
+    if (chunk_iters == 0) chunk_iters = 1;  // out of the supported range, one iteration per chunk still works
+
+    const int64x2_t code_length_reg = vdupq_n_s64(code_length_fx);
+    const int64x2_t code_length_minus1_reg = vdupq_n_s64(code_length_fx - 1);
+    const int64x2_t four_steps = vdupq_n_s64(4 * step_fx);
+    int64x2_t phase_lo, phase_hi, index_lo, index_hi;
+    __VOLK_ATTR_ALIGNED(16) int64_t phases[4];
+
+    for (current_correlator_tap = 0; current_correlator_tap < num_out_vectors; current_correlator_tap++)
+        {
+            // the four lanes start at samples 0,...,3
+            phase = volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn_start_phase(rem_code_phase_chips, shifts_chips[current_correlator_tap], code_length_chips);
+            for (k = 0; k < 4; k++)
+                {
+                    phases[k] = phase + lane_offset;
+                    phase += step_fx;
+                    if (phase >= code_length_fx) phase -= code_length_fx;
+                    if (phase < 0) phase += code_length_fx;
+                }
+            out = _result[current_correlator_tap];
+            n = 0;
+            while (n < neon_iters)
+                {
+                    m = neon_iters - n;
+                    if (m > chunk_iters) m = chunk_iters;
+                    phase_lo = vld1q_s64(phases);
+                    phase_hi = vld1q_s64(phases + 2);
+                    for (j = 0; j < m; j++)
+                        {
+                            // code_length - 1 - phase is negative, and its sign all ones, in the lanes to be wrapped
+                            index_lo = vsubq_s64(phase_lo, vandq_s64(vshrq_n_s64(vsubq_s64(code_length_minus1_reg, phase_lo), 63), code_length_reg));
+                            index_hi = vsubq_s64(phase_hi, vandq_s64(vshrq_n_s64(vsubq_s64(code_length_minus1_reg, phase_hi), 63), code_length_reg));
+                            index_lo = vshrq_n_s64(index_lo, 32);
+                            index_hi = vshrq_n_s64(index_hi, 32);
+                            out[0] = local_code[vgetq_lane_s64(index_lo, 0)];
+                            out[1] = local_code[vgetq_lane_s64(index_lo, 1)];
+                            out[2] = local_code[vgetq_lane_s64(index_hi, 0)];
+                            out[3] = local_code[vgetq_lane_s64(index_hi, 1)];
+                            out += 4;
+                            phase_lo = vaddq_s64(phase_lo, four_steps);
+                            phase_hi = vaddq_s64(phase_hi, four_steps);
+                        }
+                    vst1q_s64(phases, phase_lo);
+                    vst1q_s64(phases + 2, phase_hi);
+                    for (k = 0; k < 4; k++)
+                        {
+                            while (phases[k] >= lane_offset + code_length_fx) phases[k] -= code_length_fx;
+                            while (phases[k] < lane_offset) phases[k] += code_length_fx;
+                        }
+                    n += m;
+                }
+            phase = phases[0] - lane_offset;
+            for(n = neon_iters * 4; n < num_points; n++)
+                {
+                    _result[current_correlator_tap][n] = local_code[phase >> 32];
+                    phase += step_fx;
+                    if (phase >= code_length_fx) phase -= code_length_fx;
+                    if (phase < 0) phase += code_length_fx;
+                }
+        }
+}
+
+#endif /* LV_HAVE_NEON */
+
+#endif /*INCLUDED_volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn_H*/
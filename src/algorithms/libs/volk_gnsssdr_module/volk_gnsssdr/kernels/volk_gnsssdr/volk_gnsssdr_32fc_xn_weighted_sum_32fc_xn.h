@@ -0,0 +1,422 @@
+/*!
+ * \file volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn.h
+ * \brief VOLK_GNSSSDR kernel: M weighted sums, sample by sample, of N complex (32-bit float per component) vectors.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * VOLK_GNSSSDR kernel that multiplies the N 32 bits float complex vectors
+ * by a M x N complex matrix, sample by sample. It forms M beams of an
+ * antenna array at once: each block of input samples is read once and
+ * added to the M accumulators, so the memory traffic grows with N + M
+ * instead of with N * M as with M calls to the weighted sum of N vectors.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+/*!
+ * \page volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn
+ *
+ * \b Overview
+ *
+ * Computes result[m][n] = sum over k of weights[m * num_in_vectors + k] * in[k][n].
+ *
+ * <b>Dispatcher Prototype</b>
+ * \code
+ * void volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn(lv_32fc_t** result, const lv_32fc_t** in, const lv_32fc_t* weights, int num_out_vectors, int num_in_vectors, unsigned int num_points);
+ * \endcode
+ *
+ * \b Inputs
+ * \li in:              Pointer to an array of pointers to the vectors to be weighted and added.
+ * \li weights:         Matrix of \p num_out_vectors rows of \p num_in_vectors complex weights, row by row.
+ * \li num_out_vectors: Number of output vectors (rows of the matrix).
+ * \li num_in_vectors:  Number of input vectors (columns of the matrix).
+ * \li num_points:      Number of samples of each vector.
+ *
+ * \b Outputs
+ * \li result:          Pointer to an array of pointers to the \p num_out_vectors output vectors.
+ *
+ */
+
+#ifndef INCLUDED_volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn_H
+#define INCLUDED_volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn_H
+
+#include <volk_gnsssdr/volk_gnsssdr_complex.h>
+#include <volk_gnsssdr/volk_gnsssdr_malloc.h>
+
+
+#ifdef LV_HAVE_GENERIC
+
+static inline void volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn_generic(lv_32fc_t** result, const lv_32fc_t** in, const lv_32fc_t* weights, int num_out_vectors, int num_in_vectors, unsigned int num_points)
+{
+    lv_32fc_t sum;
+    int n_out;
+    int n_vec;
+    unsigned int n;
+    for (n_out = 0; n_out < num_out_vectors; n_out++)
+        {
+            for (n = 0; n < num_points; n++)
+                {
+                    sum = lv_cmake(0, 0);
+                    for (n_vec = 0; n_vec < num_in_vectors; n_vec++)
+                        {
+                            sum += in[n_vec][n] * weights[n_out * num_in_vectors + n_vec];
+                        }
+                    result[n_out][n] = sum;
+                }
+        }
+}
+
+#endif /*LV_HAVE_GENERIC*/
+
+
+#ifdef LV_HAVE_SSE3
+#include <pmmintrin.h>
+
+static inline void volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn_u_sse3(lv_32fc_t** result, const lv_32fc_t** in, const lv_32fc_t* weights, int num_out_vectors, int num_in_vectors, unsigned int num_points)
+{
+    const unsigned int sse_iters = num_points / 2;
+    const int num_weights = num_out_vectors * num_in_vectors;
+    lv_32fc_t sum;
+    int n_out;
+    int n_vec;
+    unsigned int number;
+    unsigned int n;
+    __m128 a, a_swapped, tmp1, tmp2;
+
+    // real and imaginary parts of each weight, in all the lanes, and the accumulators of the output vectors
+    __m128* wr = (__m128*)volk_gnsssdr_malloc(num_weights * sizeof(__m128), volk_gnsssdr_get_alignment());
+    __m128* wi = (__m128*)volk_gnsssdr_malloc(num_weights * sizeof(__m128), volk_gnsssdr_get_alignment());
+    __m128* acc = (__m128*)volk_gnsssdr_malloc(num_out_vectors * sizeof(__m128), volk_gnsssdr_get_alignment());
+    for (n_vec = 0; n_vec < num_weights; n_vec++)
+        {
+            wr[n_vec] = _mm_set1_ps(lv_creal(weights[n_vec]));
+            wi[n_vec] = _mm_set1_ps(lv_cimag(weights[n_vec]));
+        }
+
+    for(number = 0; number < sse_iters; number++)
+        {
+            for (n_out = 0; n_out < num_out_vectors; n_out++)
+                {
+                    acc[n_out] = _mm_setzero_ps();
+                }
+            for (n_vec = 0; n_vec < num_in_vectors; n_vec++)
+                {
+                    a = _mm_loadu_ps((float*)&(in[n_vec][number * 2]));
+                    a_swapped = _mm_shuffle_ps(a, a, 0xB1);
+                    for (n_out = 0; n_out < num_out_vectors; n_out++)
+                        {
+                            tmp1 = _mm_mul_ps(a, wr[n_out * num_in_vectors + n_vec]);
+                            tmp2 = _mm_mul_ps(a_swapped, wi[n_out * num_in_vectors + n_vec]);
+                            acc[n_out] = _mm_add_ps(acc[n_out], _mm_addsub_ps(tmp1, tmp2));
+                        }
+                }
+            for (n_out = 0; n_out < num_out_vectors; n_out++)
+                {
+                    _mm_storeu_ps((float*)&result[n_out][number * 2], acc[n_out]);
+                }
+        }
+    volk_gnsssdr_free(wr);
+    volk_gnsssdr_free(wi);
+    volk_gnsssdr_free(acc);
+
+    for (n_out = 0; n_out < num_out_vectors; n_out++)
+        {
+            for(n = sse_iters * 2; n < num_points; n++)
+                {
+                    sum = lv_cmake(0, 0);
+                    for (n_vec = 0; n_vec < num_in_vectors; n_vec++)
+                        {
+                            sum += in[n_vec][n] * weights[n_out * num_in_vectors + n_vec];
+                        }
+                    result[n_out][n] = sum;
+                }
+        }
+}
+
+#endif /* LV_HAVE_SSE3 */
+
+
+#ifdef LV_HAVE_SSE3
+#include <pmmintrin.h>
+
+static inline void volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn_a_sse3(lv_32fc_t** result, const lv_32fc_t** in, const lv_32fc_t* weights, int num_out_vectors, int num_in_vectors, unsigned int num_points)
+{
+    const unsigned int sse_iters = num_points / 2;
+    const int num_weights = num_out_vectors * num_in_vectors;
+    lv_32fc_t sum;
+    int n_out;
+    int n_vec;
+    unsigned int number;
+    unsigned int n;
+    __m128 a, a_swapped, tmp1, tmp2;
+
+    // real and imaginary parts of each weight, in all the lanes, and the accumulators of the output vectors
+    __m128* wr = (__m128*)volk_gnsssdr_malloc(num_weights * sizeof(__m128), volk_gnsssdr_get_alignment());
+    __m128* wi = (__m128*)volk_gnsssdr_malloc(num_weights * sizeof(__m128), volk_gnsssdr_get_alignment());
+    __m128* acc = (__m128*)volk_gnsssdr_malloc(num_out_vectors * sizeof(__m128), volk_gnsssdr_get_alignment());
+    for (n_vec = 0; n_vec < num_weights; n_vec++)
+        {
+            wr[n_vec] = _mm_set1_ps(lv_creal(weights[n_vec]));
+            wi[n_vec] = _mm_set1_ps(lv_cimag(weights[n_vec]));
+        }
+
+    for(number = 0; number < sse_iters; number++)
+        {
+            for (n_out = 0; n_out < num_out_vectors; n_out++)
+                {
+                    acc[n_out] = _mm_setzero_ps();
+                }
+            for (n_vec = 0; n_vec < num_in_vectors; n_vec++)
+                {
+                    a = _mm_load_ps((float*)&(in[n_vec][number * 2]));
+                    a_swapped = _mm_shuffle_ps(a, a, 0xB1);
+                    for (n_out = 0; n_out < num_out_vectors; n_out++)
+                        {
+                            tmp1 = _mm_mul_ps(a, wr[n_out * num_in_vectors + n_vec]);
+                            tmp2 = _mm_mul_ps(a_swapped, wi[n_out * num_in_vectors + n_vec]);
+                            acc[n_out] = _mm_add_ps(acc[n_out], _mm_addsub_ps(tmp1, tmp2));
+                        }
+                }
+            for (n_out = 0; n_out < num_out_vectors; n_out++)
+                {
+                    _mm_store_ps((float*)&result[n_out][number * 2], acc[n_out]);
+                }
+        }
+    volk_gnsssdr_free(wr);
+    volk_gnsssdr_free(wi);
+    volk_gnsssdr_free(acc);
+
+    for (n_out = 0; n_out < num_out_vectors; n_out++)
+        {
+            for(n = sse_iters * 2; n < num_points; n++)
+                {
+                    sum = lv_cmake(0, 0);
+                    for (n_vec = 0; n_vec < num_in_vectors; n_vec++)
+                        {
+                            sum += in[n_vec][n] * weights[n_out * num_in_vectors + n_vec];
+                        }
+                    result[n_out][n] = sum;
+                }
+        }
+}
+
+#endif /* LV_HAVE_SSE3 */
+
+
+#ifdef LV_HAVE_AVX
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn_u_avx(lv_32fc_t** result, const lv_32fc_t** in, const lv_32fc_t* weights, int num_out_vectors, int num_in_vectors, unsigned int num_points)
+{
+    const unsigned int avx_iters = num_points / 4;
+    const int num_weights = num_out_vectors * num_in_vectors;
+    lv_32fc_t sum;
+    int n_out;
+    int n_vec;
+    unsigned int number;
+    unsigned int n;
+    __m256 a, a_swapped, tmp1, tmp2;
+
+    // real and imaginary parts of each weight, in all the lanes, and the accumulators of the output vectors
+    __m256* wr = (__m256*)volk_gnsssdr_malloc(num_weights * sizeof(__m256), volk_gnsssdr_get_alignment());
+    __m256* wi = (__m256*)volk_gnsssdr_malloc(num_weights * sizeof(__m256), volk_gnsssdr_get_alignment());
+    __m256* acc = (__m256*)volk_gnsssdr_malloc(num_out_vectors * sizeof(__m256), volk_gnsssdr_get_alignment());
+    for (n_vec = 0; n_vec < num_weights; n_vec++)
+        {
+            wr[n_vec] = _mm256_set1_ps(lv_creal(weights[n_vec]));
+            wi[n_vec] = _mm256_set1_ps(lv_cimag(weights[n_vec]));
+        }
+
+    for(number = 0; number < avx_iters; number++)
+        {
+            for (n_out = 0; n_out < num_out_vectors; n_out++)
+                {
+                    acc[n_out] = _mm256_setzero_ps();
+                }
+            for (n_vec = 0; n_vec < num_in_vectors; n_vec++)
+                {
+                    a = _mm256_loadu_ps((float*)&(in[n_vec][number * 4]));
+                    a_swapped = _mm256_shuffle_ps(a, a, 0xB1);
+                    for (n_out = 0; n_out < num_out_vectors; n_out++)
+                        {
+                            tmp1 = _mm256_mul_ps(a, wr[n_out * num_in_vectors + n_vec]);
+                            tmp2 = _mm256_mul_ps(a_swapped, wi[n_out * num_in_vectors + n_vec]);
+                            acc[n_out] = _mm256_add_ps(acc[n_out], _mm256_addsub_ps(tmp1, tmp2));
+                        }
+                }
+            for (n_out = 0; n_out < num_out_vectors; n_out++)
+                {
+                    _mm256_storeu_ps((float*)&result[n_out][number * 4], acc[n_out]);
+                }
+        }
+    _mm256_zeroupper();
+    volk_gnsssdr_free(wr);
+    volk_gnsssdr_free(wi);
+    volk_gnsssdr_free(acc);
+
+    for (n_out = 0; n_out < num_out_vectors; n_out++)
+        {
+            for(n = avx_iters * 4; n < num_points; n++)
+                {
+                    sum = lv_cmake(0, 0);
+                    for (n_vec = 0; n_vec < num_in_vectors; n_vec++)
+                        {
+                            sum += in[n_vec][n] * weights[n_out * num_in_vectors + n_vec];
+                        }
+                    result[n_out][n] = sum;
+                }
+        }
+}
+
+#endif /* LV_HAVE_AVX */
+
+
+#ifdef LV_HAVE_AVX
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn_a_avx(lv_32fc_t** result, const lv_32fc_t** in, const lv_32fc_t* weights, int num_out_vectors, int num_in_vectors, unsigned int num_points)
+{
+    const unsigned int avx_iters = num_points / 4;
+    const int num_weights = num_out_vectors * num_in_vectors;
+    lv_32fc_t sum;
+    int n_out;
+    int n_vec;
+    unsigned int number;
+    unsigned int n;
+    __m256 a, a_swapped, tmp1, tmp2;
+
+    // real and imaginary parts of each weight, in all the lanes, and the accumulators of the output vectors
+    __m256* wr = (__m256*)volk_gnsssdr_malloc(num_weights * sizeof(__m256), volk_gnsssdr_get_alignment());
+    __m256* wi = (__m256*)volk_gnsssdr_malloc(num_weights * sizeof(__m256), volk_gnsssdr_get_alignment());
+    __m256* acc = (__m256*)volk_gnsssdr_malloc(num_out_vectors * sizeof(__m256), volk_gnsssdr_get_alignment());
+    for (n_vec = 0; n_vec < num_weights; n_vec++)
+        {
+            wr[n_vec] = _mm256_set1_ps(lv_creal(weights[n_vec]));
+            wi[n_vec] = _mm256_set1_ps(lv_cimag(weights[n_vec]));
+        }
+
+    for(number = 0; number < avx_iters; number++)
+        {
+            for (n_out = 0; n_out < num_out_vectors; n_out++)
+                {
+                    acc[n_out] = _mm256_setzero_ps();
+                }
+            for (n_vec = 0; n_vec < num_in_vectors; n_vec++)
+                {
+                    a = _mm256_load_ps((float*)&(in[n_vec][number * 4]));
+                    a_swapped = _mm256_shuffle_ps(a, a, 0xB1);
+                    for (n_out = 0; n_out < num_out_vectors; n_out++)
+                        {
+                            tmp1 = _mm256_mul_ps(a, wr[n_out * num_in_vectors + n_vec]);
+                            tmp2 = _mm256_mul_ps(a_swapped, wi[n_out * num_in_vectors + n_vec]);
+                            acc[n_out] = _mm256_add_ps(acc[n_out], _mm256_addsub_ps(tmp1, tmp2));
+                        }
+                }
+            for (n_out = 0; n_out < num_out_vectors; n_out++)
+                {
+                    _mm256_store_ps((float*)&result[n_out][number * 4], acc[n_out]);
+                }
+        }
+    _mm256_zeroupper();
+    volk_gnsssdr_free(wr);
+    volk_gnsssdr_free(wi);
+    volk_gnsssdr_free(acc);
+
+    for (n_out = 0; n_out < num_out_vectors; n_out++)
+        {
+            for(n = avx_iters * 4; n < num_points; n++)
+                {
+                    sum = lv_cmake(0, 0);
+                    for (n_vec = 0; n_vec < num_in_vectors; n_vec++)
+                        {
+                            sum += in[n_vec][n] * weights[n_out * num_in_vectors + n_vec];
+                        }
+                    result[n_out][n] = sum;
+                }
+        }
+}
+
+#endif /* LV_HAVE_AVX */
+
+
+#ifdef LV_HAVE_NEON
+#include <arm_neon.h>
+
+static inline void volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn_neon(lv_32fc_t** result, const lv_32fc_t** in, const lv_32fc_t* weights, int num_out_vectors, int num_in_vectors, unsigned int num_points)
+{
+    const unsigned int neon_iters = num_points / 4;
+    lv_32fc_t sum;
+    lv_32fc_t w;
+    int n_out;
+    int n_vec;
+    unsigned int number;
+    unsigned int n;
+    float32x4x2_t a_val;
+
+    float32x4x2_t* acc = (float32x4x2_t*)volk_gnsssdr_malloc(num_out_vectors * sizeof(float32x4x2_t), volk_gnsssdr_get_alignment());
+
+    for(number = 0; number < neon_iters; number++)
+        {
+            for (n_out = 0; n_out < num_out_vectors; n_out++)
+                {
+                    acc[n_out].val[0] = vdupq_n_f32(0.0f);
+                    acc[n_out].val[1] = vdupq_n_f32(0.0f);
+                }
+            for (n_vec = 0; n_vec < num_in_vectors; n_vec++)
+                {
+                    /* load 4 complex numbers, real and imaginary parts apart */
+                    a_val = vld2q_f32((float32_t*)&(in[n_vec][number * 4]));
+                    for (n_out = 0; n_out < num_out_vectors; n_out++)
+                        {
+                            w = weights[n_out * num_in_vectors + n_vec];
+                            acc[n_out].val[0] = vmlaq_n_f32(acc[n_out].val[0], a_val.val[0], lv_creal(w));
+                            acc[n_out].val[0] = vmlsq_n_f32(acc[n_out].val[0], a_val.val[1], lv_cimag(w));
+                            acc[n_out].val[1] = vmlaq_n_f32(acc[n_out].val[1], a_val.val[0], lv_cimag(w));
+                            acc[n_out].val[1] = vmlaq_n_f32(acc[n_out].val[1], a_val.val[1], lv_creal(w));
+                        }
+                }
+            for (n_out = 0; n_out < num_out_vectors; n_out++)
+                {
+                    vst2q_f32((float32_t*)&result[n_out][number * 4], acc[n_out]);
+                }
+        }
+    volk_gnsssdr_free(acc);
+
+    for (n_out = 0; n_out < num_out_vectors; n_out++)
+        {
+            for(n = neon_iters * 4; n < num_points; n++)
+                {
+                    sum = lv_cmake(0, 0);
+                    for (n_vec = 0; n_vec < num_in_vectors; n_vec++)
+                        {
+                            sum += in[n_vec][n] * weights[n_out * num_in_vectors + n_vec];
+                        }
+                    result[n_out][n] = sum;
+                }
+        }
+}
+
+#endif /* LV_HAVE_NEON */
+
+#endif /* INCLUDED_volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn_H */
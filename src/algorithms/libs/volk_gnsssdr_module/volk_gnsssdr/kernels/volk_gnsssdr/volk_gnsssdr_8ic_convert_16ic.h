@@ -0,0 +1,225 @@
+/*!
+ * \file volk_gnsssdr_8ic_convert_16ic.h
+ * \brief VOLK_GNSSSDR kernel: converts complex 8-bit integers into complex 16-bit integers.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * VOLK_GNSSSDR kernel that sign-extends each component of a complex 8-bit
+ * integer vector to 16 bits. Interleaved I/Q bytes are already in the
+ * lv_8sc_t layout, so this also deinterleaves and widens them in one pass.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+/*!
+ * \page volk_gnsssdr_8ic_convert_16ic
+ *
+ * \b Overview
+ *
+ * Converts a complex vector of 8-bit integer components into a complex
+ * vector of 16-bit integer components, with no scaling.
+ *
+ * <b>Dispatcher Prototype</b>
+ * \code
+ * void volk_gnsssdr_8ic_convert_16ic(lv_16sc_t* outputVector, const lv_8sc_t* inputVector, unsigned int num_points)
+ * \endcode
+ *
+ * \b Inputs
+ * \li inputVector: The complex 8-bit integer input data buffer.
+ * \li num_points: The number of complex values to be converted.
+ *
+ * \b Outputs
+ * \li outputVector: The complex 16-bit integer output data buffer.
+ *
+ */
+
+#ifndef INCLUDED_volk_gnsssdr_8ic_convert_16ic_H
+#define INCLUDED_volk_gnsssdr_8ic_convert_16ic_H
+
+#include <volk_gnsssdr/volk_gnsssdr_complex.h>
+
+
+#ifdef LV_HAVE_GENERIC
+
+static inline void volk_gnsssdr_8ic_convert_16ic_generic(lv_16sc_t* outputVector, const lv_8sc_t* inputVector, unsigned int num_points)
+{
+    unsigned int i;
+    for(i = 0; i < num_points; i++)
+        {
+            outputVector[i] = lv_cmake((int16_t)lv_creal(inputVector[i]), (int16_t)lv_cimag(inputVector[i]));
+        }
+}
+#endif /* LV_HAVE_GENERIC */
+
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+
+static inline void volk_gnsssdr_8ic_convert_16ic_u_sse2(lv_16sc_t* outputVector, const lv_8sc_t* inputVector, unsigned int num_points)
+{
+    const unsigned int sse_iters = num_points / 8;
+    unsigned int number;
+    unsigned int i;
+    const lv_8sc_t* _in = inputVector;
+    lv_16sc_t* _out = outputVector;
+    __m128i a, lo, hi;
+
+    for(number = 0; number < sse_iters; number++)
+        {
+            a = _mm_loadu_si128((__m128i*)_in);
+            // each byte in both halves of a 16-bit word, then an arithmetic shift sign-extends it
+            lo = _mm_srai_epi16(_mm_unpacklo_epi8(a, a), 8);
+            hi = _mm_srai_epi16(_mm_unpackhi_epi8(a, a), 8);
+            _mm_storeu_si128((__m128i*)_out, lo);
+            _mm_storeu_si128((__m128i*)(_out + 4), hi);
+            _in += 8;
+            _out += 8;
+        }
+    for(i = sse_iters * 8; i < num_points; ++i)
+        {
+            *_out++ = lv_cmake((int16_t)lv_creal(*_in), (int16_t)lv_cimag(*_in));
+            _in++;
+        }
+}
+#endif /* LV_HAVE_SSE2 */
+
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+
+static inline void volk_gnsssdr_8ic_convert_16ic_a_sse2(lv_16sc_t* outputVector, const lv_8sc_t* inputVector, unsigned int num_points)
+{
+    const unsigned int sse_iters = num_points / 8;
+    unsigned int number;
+    unsigned int i;
+    const lv_8sc_t* _in = inputVector;
+    lv_16sc_t* _out = outputVector;
+    __m128i a, lo, hi;
+
+    for(number = 0; number < sse_iters; number++)
+        {
+            a = _mm_load_si128((__m128i*)_in);
+            // each byte in both halves of a 16-bit word, then an arithmetic shift sign-extends it
+            lo = _mm_srai_epi16(_mm_unpacklo_epi8(a, a), 8);
+            hi = _mm_srai_epi16(_mm_unpackhi_epi8(a, a), 8);
+            _mm_store_si128((__m128i*)_out, lo);
+            _mm_store_si128((__m128i*)(_out + 4), hi);
+            _in += 8;
+            _out += 8;
+        }
+    for(i = sse_iters * 8; i < num_points; ++i)
+        {
+            *_out++ = lv_cmake((int16_t)lv_creal(*_in), (int16_t)lv_cimag(*_in));
+            _in++;
+        }
+}
+#endif /* LV_HAVE_SSE2 */
+
+
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_8ic_convert_16ic_u_avx2(lv_16sc_t* outputVector, const lv_8sc_t* inputVector, unsigned int num_points)
+{
+    const unsigned int avx_iters = num_points / 16;
+    unsigned int number;
+    unsigned int i;
+    const lv_8sc_t* _in = inputVector;
+    lv_16sc_t* _out = outputVector;
+
+    for(number = 0; number < avx_iters; number++)
+        {
+            _mm256_storeu_si256((__m256i*)_out, _mm256_cvtepi8_epi16(_mm_loadu_si128((__m128i*)_in)));
+            _mm256_storeu_si256((__m256i*)(_out + 8), _mm256_cvtepi8_epi16(_mm_loadu_si128((__m128i*)(_in + 8))));
+            _in += 16;
+            _out += 16;
+        }
+    _mm256_zeroupper();
+    for(i = avx_iters * 16; i < num_points; ++i)
+        {
+            *_out++ = lv_cmake((int16_t)lv_creal(*_in), (int16_t)lv_cimag(*_in));
+            _in++;
+        }
+}
+#endif /* LV_HAVE_AVX2 */
+
+
+#ifdef LV_HAVE_AVX2
+#include <immintrin.h>
+
+static inline void volk_gnsssdr_8ic_convert_16ic_a_avx2(lv_16sc_t* outputVector, const lv_8sc_t* inputVector, unsigned int num_points)
+{
+    const unsigned int avx_iters = num_points / 16;
+    unsigned int number;
+    unsigned int i;
+    const lv_8sc_t* _in = inputVector;
+    lv_16sc_t* _out = outputVector;
+
+    for(number = 0; number < avx_iters; number++)
+        {
+            _mm256_store_si256((__m256i*)_out, _mm256_cvtepi8_epi16(_mm_load_si128((__m128i*)_in)));
+            _mm256_store_si256((__m256i*)(_out + 8), _mm256_cvtepi8_epi16(_mm_load_si128((__m128i*)(_in + 8))));
+            _in += 16;
+            _out += 16;
+        }
+    _mm256_zeroupper();
+    for(i = avx_iters * 16; i < num_points; ++i)
+        {
+            *_out++ = lv_cmake((int16_t)lv_creal(*_in), (int16_t)lv_cimag(*_in));
+            _in++;
+        }
+}
+#endif /* LV_HAVE_AVX2 */
+
+
+#ifdef LV_HAVE_NEON
+#include <arm_neon.h>
+
+static inline void volk_gnsssdr_8ic_convert_16ic_neon(lv_16sc_t* outputVector, const lv_8sc_t* inputVector, unsigned int num_points)
+{
+    const unsigned int neon_iters = num_points / 8;
+    unsigned int number;
+    unsigned int i;
+    const lv_8sc_t* _in = inputVector;
+    lv_16sc_t* _out = outputVector;
+    int8x16_t a;
+
+    for(number = 0; number < neon_iters; number++)
+        {
+            a = vld1q_s8((const int8_t*)_in);
+            __builtin_prefetch(_in + 16);
+            vst1q_s16((int16_t*)_out, vmovl_s8(vget_low_s8(a)));
+            vst1q_s16((int16_t*)(_out + 4), vmovl_s8(vget_high_s8(a)));
+            _in += 8;
+            _out += 8;
+        }
+    for(i = neon_iters * 8; i < num_points; ++i)
+        {
+            *_out++ = lv_cmake((int16_t)lv_creal(*_in), (int16_t)lv_cimag(*_in));
+            _in++;
+        }
+}
+#endif /* LV_HAVE_NEON */
+
+#endif /* INCLUDED_volk_gnsssdr_8ic_convert_16ic_H */
@@ -279,4 +279,35 @@ static inline void volk_gnsssdr_8ic_magnitude_squared_8i_u_orc(char* magnitudeVe
 }
 #endif /* LV_HAVE_ORC */
 
+
+#ifdef LV_HAVE_NEON
+#include <arm_neon.h>
+
+static inline void volk_gnsssdr_8ic_magnitude_squared_8i_neon(char* magnitudeVector, const lv_8sc_t* complexVector, unsigned int num_points)
+{
+    const unsigned int neon_iters = num_points / 16;
+    unsigned int number;
+    const char* complexVectorPtr = (char*)complexVector;
+    char* magnitudeVectorPtr = magnitudeVector;
+    // 1st lane holds the real parts, 2nd lane holds the imaginary parts
+    int8x16x2_t a_val;
+
+    for(number = 0; number < neon_iters; number++)
+        {
+            a_val = vld2q_s8((const int8_t*)complexVectorPtr);
+            __builtin_prefetch(complexVectorPtr + 64);
+            vst1q_s8((int8_t*)magnitudeVectorPtr, vaddq_s8(vmulq_s8(a_val.val[0], a_val.val[0]), vmulq_s8(a_val.val[1], a_val.val[1])));
+            complexVectorPtr += 32;
+            magnitudeVectorPtr += 16;
+        }
+
+    for (number = neon_iters * 16; number < num_points; ++number)
+        {
+            const char valReal = *complexVectorPtr++;
+            const char valImag = *complexVectorPtr++;
+            *magnitudeVectorPtr++ = (valReal * valReal) + (valImag * valImag);
+        }
+}
+#endif /* LV_HAVE_NEON */
+
 #endif /* INCLUDED_volk_gnsssdr_32fc_magnitude_32f_H */
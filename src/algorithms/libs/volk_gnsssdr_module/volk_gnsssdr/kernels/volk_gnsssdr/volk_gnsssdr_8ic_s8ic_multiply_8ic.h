@@ -218,4 +218,37 @@ static inline void volk_gnsssdr_8ic_s8ic_multiply_8ic_u_orc(lv_8sc_t* cVector, c
 }
 #endif /* LV_HAVE_ORC */
 
+
+#ifdef LV_HAVE_NEON
+#include <arm_neon.h>
+
+static inline void volk_gnsssdr_8ic_s8ic_multiply_8ic_neon(lv_8sc_t* cVector, const lv_8sc_t* aVector, const lv_8sc_t scalar, unsigned int num_points)
+{
+    const unsigned int neon_iters = num_points / 16;
+    unsigned int number;
+    lv_8sc_t* c = cVector;
+    const lv_8sc_t* a = aVector;
+    // 1st lane holds the real parts, 2nd lane holds the imaginary parts
+    int8x16x2_t a_val, c_val;
+    const int8x16_t scalar_real = vdupq_n_s8(lv_creal(scalar));
+    const int8x16_t scalar_imag = vdupq_n_s8(lv_cimag(scalar));
+
+    for(number = 0; number < neon_iters; number++)
+        {
+            a_val = vld2q_s8((const int8_t*)a);
+            __builtin_prefetch(a + 32);
+            c_val.val[0] = vsubq_s8(vmulq_s8(a_val.val[0], scalar_real), vmulq_s8(a_val.val[1], scalar_imag));
+            c_val.val[1] = vaddq_s8(vmulq_s8(a_val.val[0], scalar_imag), vmulq_s8(a_val.val[1], scalar_real));
+            vst2q_s8((int8_t*)c, c_val);
+            a += 16;
+            c += 16;
+        }
+
+    for (number = neon_iters * 16; number < num_points; ++number)
+        {
+            *c++ = (*a++) * scalar;
+        }
+}
+#endif /* LV_HAVE_NEON */
+
 #endif /* INCLUDED_volk_gnsssdr_32fc_x2_multiply_32fc_H */
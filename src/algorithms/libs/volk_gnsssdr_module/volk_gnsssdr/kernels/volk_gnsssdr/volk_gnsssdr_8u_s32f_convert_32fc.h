@@ -0,0 +1,205 @@
+/*!
+ * \file volk_gnsssdr_8u_s32f_convert_32fc.h
+ * \brief VOLK_GNSSSDR kernel: converts interleaved unsigned 8-bit I/Q samples into complex floats.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * VOLK_GNSSSDR kernel that converts the interleaved unsigned bytes of
+ * front-ends such as the RTL2832U (rtl_sdr, rtl_tcp) into 32 bits float
+ * complex samples, subtracting the offset of the zero level and scaling
+ * to the 8-bit full scale.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+/*!
+ * \page volk_gnsssdr_8u_s32f_convert_32fc
+ *
+ * \b Overview
+ *
+ * Converts 2 * num_points unsigned bytes, I and Q of each sample, into
+ * num_points complex floats: each component is (x - offset) / 128.
+ *
+ * <b>Dispatcher Prototype</b>
+ * \code
+ * void volk_gnsssdr_8u_s32f_convert_32fc(lv_32fc_t* outputVector, const unsigned char* inputVector, const float offset, unsigned int num_points);
+ * \endcode
+ *
+ * \b Inputs
+ * \li inputVector: The interleaved I/Q bytes, 2 * num_points of them
+ * \li offset: The value of the zero level, 127.4 for the RTL2832U
+ * \li num_points: The number of complex samples
+ *
+ * \b Outputs
+ * \li outputVector: The complex samples
+ *
+ */
+
+#ifndef INCLUDED_volk_gnsssdr_8u_s32f_convert_32fc_H
+#define INCLUDED_volk_gnsssdr_8u_s32f_convert_32fc_H
+
+#include <volk_gnsssdr/volk_gnsssdr_complex.h>
+
+
+#ifdef LV_HAVE_GENERIC
+
+static inline void volk_gnsssdr_8u_s32f_convert_32fc_generic(lv_32fc_t* outputVector, const unsigned char* inputVector, const float offset, unsigned int num_points)
+{
+    float* out = (float*)outputVector;
+    const float scale = 1.0f / 128.0f;
+    unsigned int i;
+    for(i = 0; i < 2 * num_points; i++)
+        {
+            out[i] = ((float)inputVector[i] - offset) * scale;
+        }
+}
+
+#endif /* LV_HAVE_GENERIC */
+
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+
+static inline void volk_gnsssdr_8u_s32f_convert_32fc_u_sse2(lv_32fc_t* outputVector, const unsigned char* inputVector, const float offset, unsigned int num_points)
+{
+    const unsigned int sse_iters = (2 * num_points) / 16;
+    const float scale = 1.0f / 128.0f;
+    unsigned int number;
+    unsigned int i;
+    float* out = (float*)outputVector;
+    const unsigned char* a = inputVector;
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 offset_val = _mm_set1_ps(offset);
+    const __m128 scale_val = _mm_set1_ps(scale);
+    __m128i bytes, words;
+
+    for(number = 0; number < sse_iters; number++)
+        {
+            bytes = _mm_loadu_si128((__m128i*)a);
+
+            // 16 bytes, widened to 2 x 8 words and 4 x 4 double words
+            words = _mm_unpacklo_epi8(bytes, zero);
+            _mm_storeu_ps(out, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero)), offset_val), scale_val));
+            _mm_storeu_ps(out + 4, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(words, zero)), offset_val), scale_val));
+            words = _mm_unpackhi_epi8(bytes, zero);
+            _mm_storeu_ps(out + 8, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero)), offset_val), scale_val));
+            _mm_storeu_ps(out + 12, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(words, zero)), offset_val), scale_val));
+
+            a += 16;
+            out += 16;
+        }
+
+    for(i = sse_iters * 16; i < 2 * num_points; i++)
+        {
+            *out++ = ((float)inputVector[i] - offset) * scale;
+        }
+}
+
+#endif /* LV_HAVE_SSE2 */
+
+
+#ifdef LV_HAVE_SSE2
+#include <emmintrin.h>
+
+static inline void volk_gnsssdr_8u_s32f_convert_32fc_a_sse2(lv_32fc_t* outputVector, const unsigned char* inputVector, const float offset, unsigned int num_points)
+{
+    const unsigned int sse_iters = (2 * num_points) / 16;
+    const float scale = 1.0f / 128.0f;
+    unsigned int number;
+    unsigned int i;
+    float* out = (float*)outputVector;
+    const unsigned char* a = inputVector;
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 offset_val = _mm_set1_ps(offset);
+    const __m128 scale_val = _mm_set1_ps(scale);
+    __m128i bytes, words;
+
+    for(number = 0; number < sse_iters; number++)
+        {
+            bytes = _mm_load_si128((__m128i*)a);
+
+            // 16 bytes, widened to 2 x 8 words and 4 x 4 double words
+            words = _mm_unpacklo_epi8(bytes, zero);
+            _mm_store_ps(out, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero)), offset_val), scale_val));
+            _mm_store_ps(out + 4, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(words, zero)), offset_val), scale_val));
+            words = _mm_unpackhi_epi8(bytes, zero);
+            _mm_store_ps(out + 8, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero)), offset_val), scale_val));
+            _mm_store_ps(out + 12, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(words, zero)), offset_val), scale_val));
+
+            a += 16;
+            out += 16;
+        }
+
+    for(i = sse_iters * 16; i < 2 * num_points; i++)
+        {
+            *out++ = ((float)inputVector[i] - offset) * scale;
+        }
+}
+
+#endif /* LV_HAVE_SSE2 */
+
+
+#ifdef LV_HAVE_NEON
+#include <arm_neon.h>
+
+static inline void volk_gnsssdr_8u_s32f_convert_32fc_neon(lv_32fc_t* outputVector, const unsigned char* inputVector, const float offset, unsigned int num_points)
+{
+    const unsigned int neon_iters = (2 * num_points) / 16;
+    const float scale = 1.0f / 128.0f;
+    unsigned int number;
+    unsigned int i;
+    float* out = (float*)outputVector;
+    const unsigned char* a = inputVector;
+
+    const float32x4_t offset_val = vdupq_n_f32(offset);
+    uint8x16_t bytes;
+    uint16x8_t words;
+
+    for(number = 0; number < neon_iters; number++)
+        {
+            bytes = vld1q_u8(a);
+            __builtin_prefetch(a + 16);
+
+            words = vmovl_u8(vget_low_u8(bytes));
+            vst1q_f32(out, vmulq_n_f32(vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(words))), offset_val), scale));
+            vst1q_f32(out + 4, vmulq_n_f32(vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(words))), offset_val), scale));
+            words = vmovl_u8(vget_high_u8(bytes));
+            vst1q_f32(out + 8, vmulq_n_f32(vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(words))), offset_val), scale));
+            vst1q_f32(out + 12, vmulq_n_f32(vsubq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(words))), offset_val), scale));
+
+            a += 16;
+            out += 16;
+        }
+
+    for(i = neon_iters * 16; i < 2 * num_points; i++)
+        {
+            *out++ = ((float)inputVector[i] - offset) * scale;
+        }
+}
+
+#endif /* LV_HAVE_NEON */
+
+#endif /* INCLUDED_volk_gnsssdr_8u_s32f_convert_32fc_H */
@@ -0,0 +1,230 @@
+/*!
+ * \file volk_gnsssdr_8u_unpack2bit_8i.h
+ * \brief VOLK_GNSSSDR kernel: unpacks 2-bit samples, packed four per byte, into bytes.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * VOLK_GNSSSDR kernel that unpacks 2-bit two's complement samples packed
+ * four per byte, the first one in the least significant bits, into one
+ * signed byte per sample. The SIMD versions look up the two samples of each
+ * nibble in 16-entry tables.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+/*!
+ * \page volk_gnsssdr_8u_unpack2bit_8i
+ *
+ * \b Overview
+ *
+ * Unpacks 2-bit samples packed four per byte, sample 0 in bits 1:0 and
+ * sample 3 in bits 7:6. Each sample x (two's complement) is written as the
+ * odd value 2 * x + 1:
+ *
+ * 00 -> +1, 01 -> +3, 10 -> -3, 11 -> -1
+ *
+ * <b>Dispatcher Prototype</b>
+ * \code
+ * void volk_gnsssdr_8u_unpack2bit_8i(char* outputVector, const unsigned char* inputVector, unsigned int num_points);
+ * \endcode
+ *
+ * \b Inputs
+ * \li inputVector: The packed samples, (num_points + 3) / 4 bytes
+ * \li num_points: The number of samples to be unpacked
+ *
+ * \b Outputs
+ * \li outputVector: The unpacked samples, num_points bytes
+ *
+ */
+
+#ifndef INCLUDED_volk_gnsssdr_8u_unpack2bit_8i_H
+#define INCLUDED_volk_gnsssdr_8u_unpack2bit_8i_H
+
+
+#ifdef LV_HAVE_GENERIC
+
+static inline void volk_gnsssdr_8u_unpack2bit_8i_generic(char* outputVector, const unsigned char* inputVector, unsigned int num_points)
+{
+    const signed char values[4] = { 1, 3, -3, -1 };
+    unsigned int number;
+
+    for(number = 0; number < num_points; number++)
+        {
+            outputVector[number] = values[(inputVector[number / 4] >> (2 * (number % 4))) & 3];
+        }
+}
+#endif /* LV_HAVE_GENERIC */
+
+
+#ifdef LV_HAVE_SSSE3
+#include <tmmintrin.h>
+
+static inline void volk_gnsssdr_8u_unpack2bit_8i_u_ssse3(char* outputVector, const unsigned char* inputVector, unsigned int num_points)
+{
+    const unsigned int sse_iters = num_points / 64;
+    unsigned int number;
+    unsigned int i;
+    const signed char values[4] = { 1, 3, -3, -1 };
+    char* c = outputVector;
+    const unsigned char* a = inputVector;
+
+    // values of the samples in bits 1:0 and 3:2 of each nibble
+    const __m128i first_table = _mm_setr_epi8(1, 3, -3, -1, 1, 3, -3, -1, 1, 3, -3, -1, 1, 3, -3, -1);
+    const __m128i second_table = _mm_setr_epi8(1, 1, 1, 1, 3, 3, 3, 3, -3, -3, -3, -3, -1, -1, -1, -1);
+    const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+    __m128i packed, lo, hi, lo_pairs, hi_pairs;
+
+    for(number = 0; number < sse_iters; number++)
+        {
+            packed = _mm_lddqu_si128((__m128i*)a);
+            lo = _mm_and_si128(packed, nibble_mask);
+            hi = _mm_and_si128(_mm_srli_epi16(packed, 4), nibble_mask);
+
+            // samples 0, 1 of bytes 0 to 7, then samples 2, 3
+            lo_pairs = _mm_unpacklo_epi8(_mm_shuffle_epi8(first_table, lo), _mm_shuffle_epi8(second_table, lo));
+            hi_pairs = _mm_unpacklo_epi8(_mm_shuffle_epi8(first_table, hi), _mm_shuffle_epi8(second_table, hi));
+            _mm_storeu_si128((__m128i*)c, _mm_unpacklo_epi16(lo_pairs, hi_pairs));
+            _mm_storeu_si128((__m128i*)(c + 16), _mm_unpackhi_epi16(lo_pairs, hi_pairs));
+
+            // bytes 8 to 15
+            lo_pairs = _mm_unpackhi_epi8(_mm_shuffle_epi8(first_table, lo), _mm_shuffle_epi8(second_table, lo));
+            hi_pairs = _mm_unpackhi_epi8(_mm_shuffle_epi8(first_table, hi), _mm_shuffle_epi8(second_table, hi));
+            _mm_storeu_si128((__m128i*)(c + 32), _mm_unpacklo_epi16(lo_pairs, hi_pairs));
+            _mm_storeu_si128((__m128i*)(c + 48), _mm_unpackhi_epi16(lo_pairs, hi_pairs));
+
+            a += 16;
+            c += 64;
+        }
+
+    for (i = sse_iters * 64; i < num_points; ++i)
+        {
+            *c++ = values[(inputVector[i / 4] >> (2 * (i % 4))) & 3];
+        }
+}
+#endif /* LV_HAVE_SSSE3 */
+
+
+#ifdef LV_HAVE_SSSE3
+#include <tmmintrin.h>
+
+static inline void volk_gnsssdr_8u_unpack2bit_8i_a_ssse3(char* outputVector, const unsigned char* inputVector, unsigned int num_points)
+{
+    const unsigned int sse_iters = num_points / 64;
+    unsigned int number;
+    unsigned int i;
+    const signed char values[4] = { 1, 3, -3, -1 };
+    char* c = outputVector;
+    const unsigned char* a = inputVector;
+
+    // values of the samples in bits 1:0 and 3:2 of each nibble
+    const __m128i first_table = _mm_setr_epi8(1, 3, -3, -1, 1, 3, -3, -1, 1, 3, -3, -1, 1, 3, -3, -1);
+    const __m128i second_table = _mm_setr_epi8(1, 1, 1, 1, 3, 3, 3, 3, -3, -3, -3, -3, -1, -1, -1, -1);
+    const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+    __m128i packed, lo, hi, lo_pairs, hi_pairs;
+
+    for(number = 0; number < sse_iters; number++)
+        {
+            packed = _mm_load_si128((__m128i*)a);
+            lo = _mm_and_si128(packed, nibble_mask);
+            hi = _mm_and_si128(_mm_srli_epi16(packed, 4), nibble_mask);
+
+            // samples 0, 1 of bytes 0 to 7, then samples 2, 3
+            lo_pairs = _mm_unpacklo_epi8(_mm_shuffle_epi8(first_table, lo), _mm_shuffle_epi8(second_table, lo));
+            hi_pairs = _mm_unpacklo_epi8(_mm_shuffle_epi8(first_table, hi), _mm_shuffle_epi8(second_table, hi));
+            _mm_store_si128((__m128i*)c, _mm_unpacklo_epi16(lo_pairs, hi_pairs));
+            _mm_store_si128((__m128i*)(c + 16), _mm_unpackhi_epi16(lo_pairs, hi_pairs));
+
+            // bytes 8 to 15
+            lo_pairs = _mm_unpackhi_epi8(_mm_shuffle_epi8(first_table, lo), _mm_shuffle_epi8(second_table, lo));
+            hi_pairs = _mm_unpackhi_epi8(_mm_shuffle_epi8(first_table, hi), _mm_shuffle_epi8(second_table, hi));
+            _mm_store_si128((__m128i*)(c + 32), _mm_unpacklo_epi16(lo_pairs, hi_pairs));
+            _mm_store_si128((__m128i*)(c + 48), _mm_unpackhi_epi16(lo_pairs, hi_pairs));
+
+            a += 16;
+            c += 64;
+        }
+
+    for (i = sse_iters * 64; i < num_points; ++i)
+        {
+            *c++ = values[(inputVector[i / 4] >> (2 * (i % 4))) & 3];
+        }
+}
+#endif /* LV_HAVE_SSSE3 */
+
+
+#ifdef LV_HAVE_NEON
+#include <arm_neon.h>
+
+static inline void volk_gnsssdr_8u_unpack2bit_8i_neon(char* outputVector, const unsigned char* inputVector, unsigned int num_points)
+{
+    const unsigned int neon_iters = num_points / 32;
+    unsigned int number;
+    unsigned int i;
+    const signed char values[4] = { 1, 3, -3, -1 };
+    char* c = outputVector;
+    const unsigned char* a = inputVector;
+
+    // values of the samples in bits 1:0 and 3:2 of each nibble
+    const int8_t first_values[16] = { 1, 3, -3, -1, 1, 3, -3, -1, 1, 3, -3, -1, 1, 3, -3, -1 };
+    const int8_t second_values[16] = { 1, 1, 1, 1, 3, 3, 3, 3, -3, -3, -3, -3, -1, -1, -1, -1 };
+    int8x8x2_t first_table, second_table;
+    first_table.val[0] = vld1_s8(first_values);
+    first_table.val[1] = vld1_s8(first_values + 8);
+    second_table.val[0] = vld1_s8(second_values);
+    second_table.val[1] = vld1_s8(second_values + 8);
+    const uint8x8_t nibble_mask = vdup_n_u8(0x0F);
+    uint8x8_t packed;
+    int8x8_t lo, hi;
+    int8x8x2_t lo_pairs, hi_pairs;
+    int16x4x2_t samples;
+
+    for(number = 0; number < neon_iters; number++)
+        {
+            packed = vld1_u8(a);
+            __builtin_prefetch(a + 8);
+            lo = vreinterpret_s8_u8(vand_u8(packed, nibble_mask));
+            hi = vreinterpret_s8_u8(vshr_n_u8(packed, 4));
+
+            lo_pairs = vzip_s8(vtbl2_s8(first_table, lo), vtbl2_s8(second_table, lo));
+            hi_pairs = vzip_s8(vtbl2_s8(first_table, hi), vtbl2_s8(second_table, hi));
+
+            samples = vzip_s16(vreinterpret_s16_s8(lo_pairs.val[0]), vreinterpret_s16_s8(hi_pairs.val[0]));
+            vst1_s8((int8_t*)c, vreinterpret_s8_s16(samples.val[0]));
+            vst1_s8((int8_t*)(c + 8), vreinterpret_s8_s16(samples.val[1]));
+            samples = vzip_s16(vreinterpret_s16_s8(lo_pairs.val[1]), vreinterpret_s16_s8(hi_pairs.val[1]));
+            vst1_s8((int8_t*)(c + 16), vreinterpret_s8_s16(samples.val[0]));
+            vst1_s8((int8_t*)(c + 24), vreinterpret_s8_s16(samples.val[1]));
+
+            a += 8;
+            c += 32;
+        }
+
+    for (i = neon_iters * 32; i < num_points; ++i)
+        {
+            *c++ = values[(inputVector[i / 4] >> (2 * (i % 4))) & 3];
+        }
+}
+#endif /* LV_HAVE_NEON */
+
+#endif /* INCLUDED_volk_gnsssdr_8u_unpack2bit_8i_H */
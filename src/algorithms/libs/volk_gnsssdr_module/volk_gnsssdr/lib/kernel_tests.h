@@ -75,7 +75,12 @@ std::vector<volk_gnsssdr_test_case_t> init_test_list(volk_gnsssdr_test_params_t
         (VOLK_INIT_TEST(volk_gnsssdr_8ic_x2_dot_prod_8ic, test_params))
         (VOLK_INIT_TEST(volk_gnsssdr_8ic_x2_multiply_8ic, test_params))
         (VOLK_INIT_TEST(volk_gnsssdr_8ic_s8ic_multiply_8ic, test_params))
+        (VOLK_INIT_TEST(volk_gnsssdr_8u_s32f_convert_32fc, test_params))
         (VOLK_INIT_TEST(volk_gnsssdr_8u_x2_multiply_8u, test_params_more_iters))
+        (VOLK_INIT_TEST(volk_gnsssdr_8u_unpack2bit_8i, test_params_more_iters))
+        (VOLK_INIT_TEST(volk_gnsssdr_8u_unpack2bitmsb_8i, test_params_more_iters))
+        (VOLK_INIT_TEST(volk_gnsssdr_8i_x2_interleave_8ic, test_params_more_iters))
+        (VOLK_INIT_TEST(volk_gnsssdr_8ic_convert_16ic, test_params_more_iters))
         (VOLK_INIT_TEST(volk_gnsssdr_64f_accumulator_64f, test_params))
         (VOLK_INIT_TEST(volk_gnsssdr_32f_sincos_32fc, test_params_inacc))
         (VOLK_INIT_TEST(volk_gnsssdr_32fc_convert_8ic, test_params))
@@ -83,15 +88,24 @@ std::vector<volk_gnsssdr_test_case_t> init_test_list(volk_gnsssdr_test_params_t
         (VOLK_INIT_TEST(volk_gnsssdr_16ic_x2_dot_prod_16ic, test_params))
         (VOLK_INIT_TEST(volk_gnsssdr_16ic_x2_multiply_16ic, test_params_more_iters))
         (VOLK_INIT_TEST(volk_gnsssdr_16ic_convert_32fc, test_params_more_iters))
+        (VOLK_INIT_TEST(volk_gnsssdr_16i_x2_interleave_16ic, test_params_more_iters))
         (VOLK_INIT_PUPP(volk_gnsssdr_s32f_sincospuppet_32fc, volk_gnsssdr_s32f_sincos_32fc, test_params_inacc2))
         (VOLK_INIT_PUPP(volk_gnsssdr_16ic_rotatorpuppet_16ic, volk_gnsssdr_16ic_s32fc_x2_rotator_16ic, test_params_int1))
         (VOLK_INIT_PUPP(volk_gnsssdr_16ic_resamplerfastpuppet_16ic, volk_gnsssdr_16ic_resampler_fast_16ic, test_params))
         (VOLK_INIT_PUPP(volk_gnsssdr_16ic_resamplerfastxnpuppet_16ic, volk_gnsssdr_16ic_xn_resampler_fast_16ic_xn, test_params))
         (VOLK_INIT_PUPP(volk_gnsssdr_16ic_resamplerxnpuppet_16ic, volk_gnsssdr_16ic_xn_resampler_16ic_xn, test_params))
         (VOLK_INIT_PUPP(volk_gnsssdr_32fc_resamplerxnpuppet_32fc, volk_gnsssdr_32fc_xn_resampler_32fc_xn, test_params))
+        (VOLK_INIT_PUPP(volk_gnsssdr_32fc_resamplerfastxnpuppet_32fc, volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn, test_params))
         (VOLK_INIT_PUPP(volk_gnsssdr_16ic_x2_dotprodxnpuppet_16ic, volk_gnsssdr_16ic_x2_dot_prod_16ic_xn, test_params))
         (VOLK_INIT_PUPP(volk_gnsssdr_16ic_x2_rotator_dotprodxnpuppet_16ic, volk_gnsssdr_16ic_x2_rotator_dot_prod_16ic_xn, test_params_int16))
+        (VOLK_INIT_PUPP(volk_gnsssdr_16ic_x2_dotprodxnpuppet_32fc, volk_gnsssdr_16ic_x2_dot_prod_32fc_xn, test_params))
+        (VOLK_INIT_PUPP(volk_gnsssdr_16ic_x2_rotator_dotprodxnpuppet_32fc, volk_gnsssdr_16ic_x2_rotator_dot_prod_32fc_xn, test_params_inacc))
         (VOLK_INIT_PUPP(volk_gnsssdr_32fc_x2_rotator_dotprodxnpuppet_32fc, volk_gnsssdr_32fc_x2_rotator_dot_prod_32fc_xn, test_params_int1))
+        (VOLK_INIT_PUPP(volk_gnsssdr_8ic_x2_rotator_dotprodxnpuppet_32fc, volk_gnsssdr_8ic_32fc_xn_rotator_dot_prod_32fc_xn, test_params_int1))
+        (VOLK_INIT_PUPP(volk_gnsssdr_32fc_x2_resampler_rotator_dotprodxnpuppet_32fc, volk_gnsssdr_32fc_x2_resampler_rotator_dot_prod_32fc_xn, test_params_int1))
+        (VOLK_INIT_PUPP(volk_gnsssdr_32fc_weightedsumxnpuppet_32fc, volk_gnsssdr_32fc_xn_weighted_sum_32fc, test_params_inacc))
+        (VOLK_INIT_PUPP(volk_gnsssdr_16ic_weightedsumxnpuppet_16ic, volk_gnsssdr_16ic_xn_weighted_sum_16ic, test_params_int1))
+        (VOLK_INIT_PUPP(volk_gnsssdr_32fc_weightedsumxnxnpuppet_32fc, volk_gnsssdr_32fc_xn_weighted_sum_32fc_xn, test_params_inacc))
         ;
 
     return test_cases;
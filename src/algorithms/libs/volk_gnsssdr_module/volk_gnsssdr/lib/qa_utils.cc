@@ -32,6 +32,7 @@
 #include <ctime>
 #include <cmath>
 #include <limits>
+#include <algorithm>
 
 #include <volk_gnsssdr/volk_gnsssdr.h>
 #include <volk_gnsssdr/volk_gnsssdr_cpu.h>
@@ -372,6 +373,135 @@ bool icompare(t *in1, t *in2, unsigned int vlen, unsigned int tol) {
     return fail;
 }
 
+// Runs iter times the implementation arch of a kernel on buffs, in the order of the kernel signature
+static void run_cast_test(void (*manual_func)(), std::vector<void *> &buffs, const std::vector<volk_gnsssdr_type_t> &inputsc,
+        size_t n_sigs, lv_32fc_t scalar, unsigned int vlen, unsigned int iter, std::string arch)
+{
+    switch(n_sigs)
+    {
+    case 1:
+        if(inputsc.size() == 0)
+            {
+                run_cast_test1((volk_gnsssdr_fn_1arg)(manual_func), buffs, vlen, iter, arch);
+            }
+        else if(inputsc.size() == 1 && inputsc[0].is_float)
+            {
+                if(inputsc[0].is_complex)
+                    {
+                        run_cast_test1_s32fc((volk_gnsssdr_fn_1arg_s32fc)(manual_func), buffs, scalar, vlen, iter, arch);
+                    }
+                else
+                    {
+                        run_cast_test1_s32f((volk_gnsssdr_fn_1arg_s32f)(manual_func), buffs, scalar.real(), vlen, iter, arch);
+                    }
+            }
+        //ADDED BY GNSS-SDR. START
+        else if(inputsc.size() == 1 && !inputsc[0].is_float)
+            {
+                if(inputsc[0].is_complex)
+                    {
+                        if(inputsc[0].size == 2)
+                            {
+                                run_cast_test1_s16ic((volk_gnsssdr_fn_1arg_s16ic)(manual_func), buffs, scalar, vlen, iter, arch);
+                            }
+                        else
+                            {
+                                run_cast_test1_s8ic((volk_gnsssdr_fn_1arg_s8ic)(manual_func), buffs, scalar, vlen, iter, arch);
+                            }
+                    }
+                else
+                    {
+                        run_cast_test1_s8i((volk_gnsssdr_fn_1arg_s8i)(manual_func), buffs, scalar.real(), vlen, iter, arch);
+                    }
+            }
+        //ADDED BY GNSS-SDR. END
+        else throw "unsupported 1 arg function >1 scalars";
+        break;
+    case 2:
+        if(inputsc.size() == 0)
+            {
+                        run_cast_test2((volk_gnsssdr_fn_2arg)(manual_func), buffs, vlen, iter, arch);
+            }
+        else if(inputsc.size() == 1 && inputsc[0].is_float)
+            {
+                if(inputsc[0].is_complex)
+                    {
+                        run_cast_test2_s32fc((volk_gnsssdr_fn_2arg_s32fc)(manual_func), buffs, scalar, vlen, iter, arch);
+                    }
+                else
+                    {
+                        run_cast_test2_s32f((volk_gnsssdr_fn_2arg_s32f)(manual_func), buffs, scalar.real(), vlen, iter, arch);
+                    }
+            }
+        //ADDED BY GNSS-SDR. START
+        else if(inputsc.size() == 1 && !inputsc[0].is_float)
+            {
+                if(inputsc[0].is_complex)
+                    {
+                        if(inputsc[0].size == 2)
+                            {
+                                run_cast_test2_s16ic((volk_gnsssdr_fn_2arg_s16ic)(manual_func), buffs, scalar, vlen, iter, arch);
+                            }
+                        else
+                            {
+                                run_cast_test2_s8ic((volk_gnsssdr_fn_2arg_s8ic)(manual_func), buffs, scalar, vlen, iter, arch);
+                            }
+                    }
+                else
+                    {
+                        run_cast_test2_s8i((volk_gnsssdr_fn_2arg_s8i)(manual_func), buffs, scalar.real(), vlen, iter, arch);
+                    }
+            }
+        //ADDED BY GNSS-SDR. END
+        else throw "unsupported 2 arg function >1 scalars";
+        break;
+    case 3:
+        if(inputsc.size() == 0)
+            {
+                run_cast_test3((volk_gnsssdr_fn_3arg)(manual_func), buffs, vlen, iter, arch);
+            }
+        else if(inputsc.size() == 1 && inputsc[0].is_float)
+            {
+                if(inputsc[0].is_complex)
+                    {
+                        run_cast_test3_s32fc((volk_gnsssdr_fn_3arg_s32fc)(manual_func), buffs, scalar, vlen, iter, arch);
+                    }
+                else
+                    {
+                        run_cast_test3_s32f((volk_gnsssdr_fn_3arg_s32f)(manual_func), buffs, scalar.real(), vlen, iter, arch);
+                    }
+            }
+        //ADDED BY GNSS-SDR. START
+        else if(inputsc.size() == 1 && !inputsc[0].is_float)
+            {
+                if(inputsc[0].is_complex)
+                    {
+                        {
+                             if(inputsc[0].size == 4)
+                                 {
+                                     run_cast_test3_s16ic((volk_gnsssdr_fn_3arg_s16ic)(manual_func), buffs, scalar, vlen, iter, arch);
+                                 }
+                             else
+                                 {
+                                     run_cast_test3_s8ic((volk_gnsssdr_fn_3arg_s8ic)(manual_func), buffs, scalar, vlen, iter, arch);
+                                 }
+                         }
+                    }
+                else
+                    {
+                        run_cast_test3_s8i((volk_gnsssdr_fn_3arg_s8i)(manual_func), buffs, scalar.real(), vlen, iter, arch);
+                    }
+            }
+        //ADDED BY GNSS-SDR. END
+        else throw "unsupported 3 arg function >1 scalars";
+        break;
+        default:
+            throw "no function handler for this signature";
+            break;
+    }
+}
+
+
 class volk_gnsssdr_qa_aligned_mem_pool{
 public:
     void *get_new(size_t size){
@@ -495,128 +625,7 @@ bool run_volk_gnsssdr_tests(volk_gnsssdr_func_desc_t desc,
     for(size_t i = 0; i < arch_list.size(); i++) {
         start = clock();
 
-        switch(both_sigs.size())
-        {
-        case 1:
-            if(inputsc.size() == 0)
-                {
-                    run_cast_test1((volk_gnsssdr_fn_1arg)(manual_func), test_data[i], vlen, iter, arch_list[i]);
-                }
-            else if(inputsc.size() == 1 && inputsc[0].is_float)
-                {
-                    if(inputsc[0].is_complex)
-                        {
-                            run_cast_test1_s32fc((volk_gnsssdr_fn_1arg_s32fc)(manual_func), test_data[i], scalar, vlen, iter, arch_list[i]);
-                        }
-                    else
-                        {
-                            run_cast_test1_s32f((volk_gnsssdr_fn_1arg_s32f)(manual_func), test_data[i], scalar.real(), vlen, iter, arch_list[i]);
-                        }
-                }
-            //ADDED BY GNSS-SDR. START
-            else if(inputsc.size() == 1 && !inputsc[0].is_float)
-                {
-                    if(inputsc[0].is_complex)
-                        {
-                            if(inputsc[0].size == 2)
-                                {
-                                    run_cast_test1_s16ic((volk_gnsssdr_fn_1arg_s16ic)(manual_func), test_data[i], scalar, vlen, iter, arch_list[i]);
-                                }
-                            else
-                                {
-                                    run_cast_test1_s8ic((volk_gnsssdr_fn_1arg_s8ic)(manual_func), test_data[i], scalar, vlen, iter, arch_list[i]);
-                                }
-                        }
-                    else
-                        {
-                            run_cast_test1_s8i((volk_gnsssdr_fn_1arg_s8i)(manual_func), test_data[i], scalar.real(), vlen, iter, arch_list[i]);
-                        }
-                }
-            //ADDED BY GNSS-SDR. END
-            else throw "unsupported 1 arg function >1 scalars";
-            break;
-        case 2:
-            if(inputsc.size() == 0)
-                {
-                            run_cast_test2((volk_gnsssdr_fn_2arg)(manual_func), test_data[i], vlen, iter, arch_list[i]);
-                }
-            else if(inputsc.size() == 1 && inputsc[0].is_float)
-                {
-                    if(inputsc[0].is_complex)
-                        {
-                            run_cast_test2_s32fc((volk_gnsssdr_fn_2arg_s32fc)(manual_func), test_data[i], scalar, vlen, iter, arch_list[i]);
-                        }
-                    else
-                        {
-                            run_cast_test2_s32f((volk_gnsssdr_fn_2arg_s32f)(manual_func), test_data[i], scalar.real(), vlen, iter, arch_list[i]);
-                        }
-                }
-            //ADDED BY GNSS-SDR. START
-            else if(inputsc.size() == 1 && !inputsc[0].is_float)
-                {
-                    if(inputsc[0].is_complex)
-                        {
-                            if(inputsc[0].size == 2)
-                                {
-                                    run_cast_test2_s16ic((volk_gnsssdr_fn_2arg_s16ic)(manual_func), test_data[i], scalar, vlen, iter, arch_list[i]);
-                                }
-                            else
-                                {
-                                    run_cast_test2_s8ic((volk_gnsssdr_fn_2arg_s8ic)(manual_func), test_data[i], scalar, vlen, iter, arch_list[i]);
-                                }
-                        }
-                    else
-                        {
-                            run_cast_test2_s8i((volk_gnsssdr_fn_2arg_s8i)(manual_func), test_data[i], scalar.real(), vlen, iter, arch_list[i]);
-                        }
-                }
-            //ADDED BY GNSS-SDR. END
-            else throw "unsupported 2 arg function >1 scalars";
-            break;
-        case 3:
-            if(inputsc.size() == 0)
-                {
-                    run_cast_test3((volk_gnsssdr_fn_3arg)(manual_func), test_data[i], vlen, iter, arch_list[i]);
-                }
-            else if(inputsc.size() == 1 && inputsc[0].is_float)
-                {
-                    if(inputsc[0].is_complex)
-                        {
-                            run_cast_test3_s32fc((volk_gnsssdr_fn_3arg_s32fc)(manual_func), test_data[i], scalar, vlen, iter, arch_list[i]);
-                        }
-                    else
-                        {
-                            run_cast_test3_s32f((volk_gnsssdr_fn_3arg_s32f)(manual_func), test_data[i], scalar.real(), vlen, iter, arch_list[i]);
-                        }
-                }
-            //ADDED BY GNSS-SDR. START
-            else if(inputsc.size() == 1 && !inputsc[0].is_float)
-                {
-                    if(inputsc[0].is_complex)
-                        {
-                            {
-                                 if(inputsc[0].size == 4)
-                                     {
-                                         run_cast_test3_s16ic((volk_gnsssdr_fn_3arg_s16ic)(manual_func), test_data[i], scalar, vlen, iter, arch_list[i]);
-                                     }
-                                 else
-                                     {
-                                         run_cast_test3_s8ic((volk_gnsssdr_fn_3arg_s8ic)(manual_func), test_data[i], scalar, vlen, iter, arch_list[i]);
-                                     }
-                             }
-                        }
-                    else
-                        {
-                            run_cast_test3_s8i((volk_gnsssdr_fn_3arg_s8i)(manual_func), test_data[i], scalar.real(), vlen, iter, arch_list[i]);
-                        }
-                }
-            //ADDED BY GNSS-SDR. END
-            else throw "unsupported 3 arg function >1 scalars";
-            break;
-            default:
-                throw "no function handler for this signature";
-                break;
-        }
+        run_cast_test(manual_func, test_data[i], inputsc, both_sigs.size(), scalar, vlen, iter, arch_list[i]);
 
         end = clock();
         double arch_time = 1000.0 * (double)(end-start)/(double)CLOCKS_PER_SEC;
@@ -797,3 +806,104 @@ bool run_volk_gnsssdr_tests(volk_gnsssdr_func_desc_t desc,
 
     return fail_global;
 }
+
+
+static double qa_time_ns()
+{
+#ifdef _WIN32
+    return 1e9 * static_cast<double>(clock()) / static_cast<double>(CLOCKS_PER_SEC);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return 1e9 * static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec);
+#endif
+}
+
+
+// Evicts the kernel buffers from the caches, by writing a buffer larger than the last level cache
+static void qa_flush_caches()
+{
+    static std::vector<char> flush_buffer(64 * 1024 * 1024);
+    static char value = 0;
+    value++;
+    memset(&flush_buffer[0], value, flush_buffer.size());
+}
+
+
+void run_volk_gnsssdr_timings(volk_gnsssdr_func_desc_t desc,
+                    void (*manual_func)(),
+                    std::string name,
+                    volk_gnsssdr_test_params_t test_params,
+                    const std::vector<unsigned int> &vlens,
+                    unsigned int trials,
+                    volk_gnsssdr_test_results_t *result)
+{
+    std::vector<std::string> arch_list = get_arch_list(desc);
+    std::vector<volk_gnsssdr_type_t> inputsig, outputsig;
+    try {
+        get_signatures_from_name(inputsig, outputsig, name);
+    }
+    catch (boost::bad_lexical_cast& error) {
+        std::cerr << "Error: unable to get function signature from kernel name" << std::endl;
+        std::cerr << "  - " << name << std::endl;
+        return;
+    }
+    std::vector<volk_gnsssdr_type_t> inputsc;
+    for(size_t i=0; i<inputsig.size(); i++) {
+        if(inputsig[i].is_scalar) {
+            inputsc.push_back(inputsig[i]);
+            inputsig.erase(inputsig.begin() + i);
+            i -= 1;
+        }
+    }
+    std::vector<volk_gnsssdr_type_t> both_sigs;
+    both_sigs.insert(both_sigs.end(), outputsig.begin(), outputsig.end());
+    both_sigs.insert(both_sigs.end(), inputsig.begin(), inputsig.end());
+
+    if(trials == 0) trials = 1;
+    const unsigned int calls_per_trial = std::max(test_params.iter() / trials, 1u);
+
+    for(size_t v = 0; v < vlens.size(); v++) {
+        const unsigned int vlen = vlens[v];
+        std::cout << "RUN_VOLK_GNSSSDR_TIMINGS: " << name << "(" << vlen << "," << trials << ")" << std::endl;
+
+        // One item more than vlen, so that the buffers can be used one item off
+        volk_gnsssdr_qa_aligned_mem_pool mem_pool;
+        std::vector<void *> aligned_buffs, unaligned_buffs;
+        for(size_t j = 0; j < both_sigs.size(); j++) {
+            size_t item_size = both_sigs[j].size * (both_sigs[j].is_complex ? 2 : 1);
+            char *buff = static_cast<char *>(mem_pool.get_new((vlen + 1) * item_size));
+            if(j >= outputsig.size()) load_random_data(buff, both_sigs[j], vlen + 1);
+            aligned_buffs.push_back(buff);
+            unaligned_buffs.push_back(buff + item_size);
+        }
+
+        for(size_t i = 0; i < arch_list.size(); i++) {
+            for(int misaligned = 0; misaligned < (desc.impl_alignment[i] ? 1 : 2); misaligned++) {
+                std::vector<void *> &buffs = misaligned ? unaligned_buffs : aligned_buffs;
+                for(int cold = 0; cold < 2; cold++) {
+                    volk_gnsssdr_test_timing_t timing;
+                    timing.arch = arch_list[i];
+                    timing.vlen = vlen;
+                    timing.aligned_data = !misaligned;
+                    timing.cold_cache = cold;
+                    try {
+                        run_cast_test(manual_func, buffs, inputsc, both_sigs.size(), test_params.scalar(), vlen, 1, arch_list[i]);
+                        for(unsigned int t = 0; t < trials; t++) {
+                            if(cold) qa_flush_caches();
+                            unsigned int calls = cold ? 1 : calls_per_trial;
+                            double start = qa_time_ns();
+                            run_cast_test(manual_func, buffs, inputsc, both_sigs.size(), test_params.scalar(), vlen, calls, arch_list[i]);
+                            timing.ns_per_call.push_back((qa_time_ns() - start) / static_cast<double>(calls));
+                        }
+                    }
+                    catch (const char *error) {
+                        std::cerr << "Error timing " << name << " on " << arch_list[i] << ": " << error << std::endl;
+                        return;
+                    }
+                    result->timings.push_back(timing);
+                }
+            }
+        }
+    }
+}
@@ -48,6 +48,16 @@ class volk_gnsssdr_test_time_t {
         bool pass;
 };
 
+// Time per call of one implementation, over a number of trials
+class volk_gnsssdr_test_timing_t {
+    public:
+        std::string arch;
+        unsigned int vlen;
+        bool aligned_data;    // buffers at the alignment of the machine, or one item off
+        bool cold_cache;      // caches flushed before each call, or warmed up by the previous ones
+        std::vector<double> ns_per_call;
+};
+
 class volk_gnsssdr_test_results_t {
     public:
         std::string name;
@@ -57,6 +67,7 @@ class volk_gnsssdr_test_results_t {
         std::map<std::string, volk_gnsssdr_test_time_t> results;
         std::string best_arch_a;
         std::string best_arch_u;
+        std::vector<volk_gnsssdr_test_timing_t> timings;
 };
 
 class volk_gnsssdr_test_params_t {
@@ -140,6 +151,23 @@ bool run_volk_gnsssdr_tests(
 );
 
 
+/*!
+ * Measures every implementation of a kernel at each length of vlens: on aligned
+ * buffers, and also on buffers one item off for the unaligned implementations,
+ * each with warm and with cold caches. Every timing has trials calls, and is
+ * added to the timings of result.
+ */
+void run_volk_gnsssdr_timings(
+        volk_gnsssdr_func_desc_t,
+        void(*)(),
+        std::string,
+        volk_gnsssdr_test_params_t,
+        const std::vector<unsigned int> &vlens,
+        unsigned int trials,
+        volk_gnsssdr_test_results_t *result
+);
+
+
 #define VOLK_RUN_TESTS(func, tol, scalar, len, iter) \
     BOOST_AUTO_TEST_CASE(func##_test) { \
         BOOST_CHECK_EQUAL(run_volk_gnsssdr_tests( \
@@ -18,6 +18,7 @@
  */
 
 #include "volk_gnsssdr/volk_gnsssdr_malloc.h"
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -127,3 +128,181 @@ volk_gnsssdr_free(void *ptr)
 #endif // _POSIX_C_SOURCE >= 200112L || _XOPEN_SOURCE >= 600 || HAVE_POSIX_MEMALIGN
 
 //#endif // _ISOC11_SOURCE
+
+
+/*
+ * Huge page allocations. Each one keeps, just before the aligned pointer,
+ * what is needed to release it.
+ */
+#define VOLK_GNSSSDR_HUGE_PAGE_SIZE (2UL * 1024 * 1024)
+#define VOLK_GNSSSDR_GIGANTIC_PAGE_SIZE (1024UL * 1024 * 1024)
+
+enum huge_block_kind
+{
+    HUGE_BLOCK_MALLOC = 0,     // from volk_gnsssdr_malloc
+    HUGE_BLOCK_RESERVED = 1,   // mapped on reserved huge pages
+    HUGE_BLOCK_TRANSPARENT = 2 // mapped, eligible for transparent huge pages
+};
+
+struct huge_block_info
+{
+    void *real;
+    size_t length;
+    int kind;
+};
+
+static volatile int huge_pages_enabled = 1;
+static volatile size_t huge_reserved_bytes = 0;
+static volatile size_t huge_transparent_bytes = 0;
+
+void volk_gnsssdr_set_huge_pages(int enabled)
+{
+    huge_pages_enabled = enabled;
+}
+
+void volk_gnsssdr_huge_pages_usage(size_t *reserved, size_t *transparent)
+{
+    if (reserved) *reserved = huge_reserved_bytes;
+    if (transparent) *transparent = huge_transparent_bytes;
+}
+
+// Room before the aligned pointer for the info, a power of two multiple of alignment
+static size_t huge_block_offset(size_t alignment)
+{
+    size_t offset = alignment > 0 ? alignment : sizeof(void *);
+    while (offset < sizeof(struct huge_block_info))
+        offset *= 2;
+    return offset;
+}
+
+#if defined(__linux__)
+#include <sys/mman.h>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+static void *map_huge(size_t length, size_t page_size, int *kind)
+{
+    void *real = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+    if (page_size == VOLK_GNSSSDR_GIGANTIC_PAGE_SIZE)
+        flags |= 30 << MAP_HUGE_SHIFT;
+    real = mmap(NULL, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (real != MAP_FAILED)
+        {
+            *kind = HUGE_BLOCK_RESERVED;
+            return real;
+        }
+#endif
+    (void)page_size;
+    *kind = HUGE_BLOCK_TRANSPARENT;
+    return MAP_FAILED;
+}
+
+void *volk_gnsssdr_malloc_huge(size_t size, size_t alignment)
+{
+    const size_t offset = huge_block_offset(alignment);
+    if (huge_pages_enabled && size >= VOLK_GNSSSDR_HUGE_PAGE_SIZE && offset < VOLK_GNSSSDR_HUGE_PAGE_SIZE)
+        {
+            // the mappings are page aligned, so the pointer is offset bytes after it
+            int kind = HUGE_BLOCK_RESERVED;
+            void *real = MAP_FAILED;
+            size_t length = 0;
+            if (size + offset >= VOLK_GNSSSDR_GIGANTIC_PAGE_SIZE)
+                {
+                    length = (size + offset + VOLK_GNSSSDR_GIGANTIC_PAGE_SIZE - 1) & ~(VOLK_GNSSSDR_GIGANTIC_PAGE_SIZE - 1);
+                    real = map_huge(length, VOLK_GNSSSDR_GIGANTIC_PAGE_SIZE, &kind);
+                }
+            if (real == MAP_FAILED)
+                {
+                    length = (size + offset + VOLK_GNSSSDR_HUGE_PAGE_SIZE - 1) & ~(VOLK_GNSSSDR_HUGE_PAGE_SIZE - 1);
+                    real = map_huge(length, VOLK_GNSSSDR_HUGE_PAGE_SIZE, &kind);
+                }
+            if (real == MAP_FAILED)
+                {
+                    // one more huge page to align the mapping to it, the rest is unmapped
+                    void *raw = mmap(NULL, length + VOLK_GNSSSDR_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                    if (raw != MAP_FAILED)
+                        {
+                            uintptr_t start = ((uintptr_t)raw + VOLK_GNSSSDR_HUGE_PAGE_SIZE - 1) & ~(VOLK_GNSSSDR_HUGE_PAGE_SIZE - 1);
+                            size_t head = start - (uintptr_t)raw;
+                            if (head > 0) munmap(raw, head);
+                            if (VOLK_GNSSSDR_HUGE_PAGE_SIZE - head > 0) munmap((void *)(start + length), VOLK_GNSSSDR_HUGE_PAGE_SIZE - head);
+                            real = (void *)start;
+#ifdef MADV_HUGEPAGE
+                            madvise(real, length, MADV_HUGEPAGE);
+#endif
+                        }
+                }
+            if (real != MAP_FAILED)
+                {
+                    void *user = (void *)((uintptr_t)real + offset);
+                    struct huge_block_info *info = (struct huge_block_info *)((uintptr_t)user - sizeof(struct huge_block_info));
+                    info->real = real;
+                    info->length = length;
+                    info->kind = kind;
+                    if (kind == HUGE_BLOCK_RESERVED)
+                        __sync_fetch_and_add(&huge_reserved_bytes, length);
+                    else
+                        __sync_fetch_and_add(&huge_transparent_bytes, length);
+                    return user;
+                }
+        }
+
+    void *real = volk_gnsssdr_malloc(size + offset, offset);
+    if (real == NULL)
+        return NULL;
+    void *user = (void *)((uintptr_t)real + offset);
+    struct huge_block_info *info = (struct huge_block_info *)((uintptr_t)user - sizeof(struct huge_block_info));
+    info->real = real;
+    info->length = size + offset;
+    info->kind = HUGE_BLOCK_MALLOC;
+    return user;
+}
+
+void volk_gnsssdr_free_huge(void *ptr)
+{
+    if (ptr == NULL)
+        return;
+    struct huge_block_info *info = (struct huge_block_info *)((uintptr_t)ptr - sizeof(struct huge_block_info));
+    if (info->kind == HUGE_BLOCK_MALLOC)
+        {
+            volk_gnsssdr_free(info->real);
+            return;
+        }
+    if (info->kind == HUGE_BLOCK_RESERVED)
+        __sync_fetch_and_sub(&huge_reserved_bytes, info->length);
+    else
+        __sync_fetch_and_sub(&huge_transparent_bytes, info->length);
+    munmap(info->real, info->length);
+}
+
+#else // __linux__
+
+// Elsewhere, the buffers are allocated as by volk_gnsssdr_malloc
+void *volk_gnsssdr_malloc_huge(size_t size, size_t alignment)
+{
+    const size_t offset = huge_block_offset(alignment);
+    void *real = volk_gnsssdr_malloc(size + offset, offset);
+    if (real == NULL)
+        return NULL;
+    void *user = (void *)((uintptr_t)real + offset);
+    struct huge_block_info *info = (struct huge_block_info *)((uintptr_t)user - sizeof(struct huge_block_info));
+    info->real = real;
+    info->length = size + offset;
+    info->kind = HUGE_BLOCK_MALLOC;
+    return user;
+}
+
+void volk_gnsssdr_free_huge(void *ptr)
+{
+    if (ptr == NULL)
+        return;
+    struct huge_block_info *info = (struct huge_block_info *)((uintptr_t)ptr - sizeof(struct huge_block_info));
+    volk_gnsssdr_free(info->real);
+}
+
+#endif // __linux__
@@ -207,3 +207,31 @@ volk_gnsssdr_func_desc_t $(kern.name)_get_func_desc(void) {
 }
 
 #end for
+
+static int __find_impl(const char **impl_names, const size_t n_impls, const char *impl_name)
+{
+    size_t i;
+    for (i = 0; i < n_impls; i++)
+        {
+            if (!strcmp(impl_names[i], impl_name)) return (int)i;
+        }
+    return -1;
+}
+
+bool volk_gnsssdr_select_impls(const char *kern_name, const char *impl_a, const char *impl_u)
+{
+    int index_a, index_u;
+#for $kern in $kernels
+    if (!strcmp(kern_name, "$(kern.name)"))
+        {
+            index_a = __find_impl(get_machine()->$(kern.name)_impl_names, get_machine()->$(kern.name)_n_impls, impl_a);
+            index_u = __find_impl(get_machine()->$(kern.name)_impl_names, get_machine()->$(kern.name)_n_impls, impl_u);
+            if (index_a < 0 || index_u < 0 || get_machine()->$(kern.name)_impl_alignment[index_u]) return false;
+            $(kern.name)_a = get_machine()->$(kern.name)_impls[index_a];
+            $(kern.name)_u = get_machine()->$(kern.name)_impls[index_u];
+            $(kern.name) = &__$(kern.name)_d;
+            return true;
+        }
+#end for
+    return false;
+}
@@ -86,6 +86,17 @@ extern VOLK_API void $(kern.name)_manual($kern.arglist_full, const char* impl_na
 extern VOLK_API volk_gnsssdr_func_desc_t $(kern.name)_get_func_desc(void);
 #end for
 
+/*!
+ * Makes the kernel \p kern_name use the implementations \p impl_a for
+ * aligned buffers and \p impl_u for the unaligned ones, whatever the
+ * volk_gnsssdr_config file says. It is not thread safe: call it before
+ * the kernel is used in other threads.
+ *
+ * \return false, and nothing is changed, if the kernel or one of the
+ * implementations is unknown, or if \p impl_u requires aligned buffers
+ */
+VOLK_API bool volk_gnsssdr_select_impls(const char *kern_name, const char *impl_a, const char *impl_u);
+
 __VOLK_DECL_END
 
 
@@ -115,6 +115,15 @@ static inline unsigned int get_avx2_enabled(void) {
 #endif
 }
 
+static inline unsigned int get_avx512f_enabled(void) {
+#if defined(VOLK_CPU_x86)
+    // XMM, YMM, opmask and the two halves of the ZMM state
+    return (__xgetbv() & 0xE6) == 0xE6;
+#else
+    return 0;
+#endif
+}
+
 //neon detection is linux specific
 #if defined(__arm__) && defined(__linux__)
     #include <asm/hwcap.h>
@@ -124,7 +133,10 @@ static inline unsigned int get_avx2_enabled(void) {
 #endif
 
 static int has_neon(void){
-#if defined(VOLK_CPU_ARM)
+#if defined(__aarch64__)
+    // ASIMD is mandatory in ARMv8-A
+    return 1;
+#elif defined(VOLK_CPU_ARM)
     FILE *auxvec_f;
     unsigned long auxvec[2];
     unsigned int found_neon = 0;
@@ -147,6 +159,14 @@ static int has_neon(void){
 #endif
 }
 
+static int has_neonv8(void){
+#if defined(__aarch64__)
+    return 1;
+#else
+    return 0;
+#endif
+}
+
 #for $arch in $archs
 static int i_can_has_$arch.name (void) {
     #for $check, $params in $arch.checks
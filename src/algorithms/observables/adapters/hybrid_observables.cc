@@ -52,7 +52,16 @@ HybridObservables::HybridObservables(ConfigurationInterface* configuration,
     flag_averaging = configuration->property(role + ".flag_averaging", false);
     dump_ = configuration->property(role + ".dump", false);
     dump_filename_ = configuration->property(role + ".dump_filename", default_dump_filename);
-    observables_ = hybrid_make_observables_cc(in_streams_, dump_, dump_filename_, output_rate_ms, flag_averaging);
+    // 0 produces the observables at the latest symbol of every channel
+    unsigned int epoch_rate_hz = configuration->property(role + ".epoch_rate_hz", 0);
+    if (epoch_rate_hz > OBSERVABLES_SYNC_MAX_EPOCH_RATE_HZ)
+        {
+            LOG(WARNING) << role << ".epoch_rate_hz cannot be higher than " << OBSERVABLES_SYNC_MAX_EPOCH_RATE_HZ << " Hz";
+            epoch_rate_hz = OBSERVABLES_SYNC_MAX_EPOCH_RATE_HZ;
+        }
+    observables_ = hybrid_make_observables_cc(in_streams_, dump_, dump_filename_, output_rate_ms, flag_averaging, epoch_rate_hz);
+    // the sample stamps of the tracking blocks count samples at this rate
+    observables_->set_sample_rate(configuration->property("GNSS-SDR.internal_fs_hz", 0u));
     DLOG(INFO) << "pseudorange(" << observables_->unique_id() << ")";
 }
 
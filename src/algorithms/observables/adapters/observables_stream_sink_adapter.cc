@@ -0,0 +1,88 @@
+/*!
+ * \file observables_stream_sink_adapter.cc
+ * \brief PVT replacement of an edge receiver, which sends its observables to a central PVT
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "observables_stream_sink_adapter.h"
+#include <glog/logging.h>
+#include "configuration_interface.h"
+
+using google::LogMessage;
+
+ObservablesStreamSinkAdapter::ObservablesStreamSinkAdapter(ConfigurationInterface* configuration,
+        std::string role,
+        unsigned int in_streams,
+        unsigned int out_streams) :
+                role_(role),
+                in_streams_(in_streams),
+                out_streams_(out_streams)
+{
+    std::string server_address = configuration->property(role + ".server_address", std::string("127.0.0.1"));
+    unsigned short server_port = configuration->property(role + ".server_port", 2102);
+    std::string station = configuration->property(role + ".station", std::string("edge"));
+    // one batch every 100 epochs, 0.1 s at the tracking rate of the L1 C/A signals
+    unsigned int batch_epochs = configuration->property(role + ".batch_epochs", 100);
+    // the prompt correlator outputs and the code phase, for monitoring at the server
+    bool tracking_outputs = configuration->property(role + ".tracking_outputs", false);
+    unsigned int max_queued_batches = configuration->property(role + ".max_queued_batches", 100);
+    unsigned int reconnect_period_ms = configuration->property(role + ".reconnect_period_ms", 1000);
+    sink_ = make_observables_stream_sink(in_streams_, server_address, server_port, station,
+            batch_epochs, tracking_outputs, max_queued_batches, reconnect_period_ms);
+    DLOG(INFO) << "observables stream sink(" << sink_->unique_id() << ")";
+}
+
+
+ObservablesStreamSinkAdapter::~ObservablesStreamSinkAdapter()
+{}
+
+
+void ObservablesStreamSinkAdapter::connect(gr::top_block_sptr top_block)
+{
+    if(top_block) { /* top_block is not null */};
+    // Nothing to connect internally
+    DLOG(INFO) << "nothing to connect internally";
+}
+
+
+void ObservablesStreamSinkAdapter::disconnect(gr::top_block_sptr top_block)
+{
+    if(top_block) { /* top_block is not null */};
+    // Nothing to disconnect
+}
+
+
+gr::basic_block_sptr ObservablesStreamSinkAdapter::get_left_block()
+{
+    return sink_;
+}
+
+
+gr::basic_block_sptr ObservablesStreamSinkAdapter::get_right_block()
+{
+    return sink_; // this is a sink, nothing downstream
+}
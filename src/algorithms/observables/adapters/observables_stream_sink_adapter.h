@@ -0,0 +1,88 @@
+/*!
+ * \file observables_stream_sink_adapter.h
+ * \brief PVT replacement of an edge receiver, which sends its observables to a central PVT
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_OBSERVABLES_STREAM_SINK_ADAPTER_H_
+#define GNSS_SDR_OBSERVABLES_STREAM_SINK_ADAPTER_H_
+
+#include <string>
+#include "pvt_interface.h"
+#include "observables_stream_sink.h"
+
+
+class ConfigurationInterface;
+
+/*!
+ * \brief This class implements a PvtInterface that sends the observables
+ * and the navigation data to the Observables_Stream_Source of a central receiver
+ */
+class ObservablesStreamSinkAdapter : public PvtInterface
+{
+public:
+    ObservablesStreamSinkAdapter(ConfigurationInterface* configuration,
+            std::string role,
+            unsigned int in_streams,
+            unsigned int out_streams);
+
+    virtual ~ObservablesStreamSinkAdapter();
+
+    std::string role()
+    {
+        return role_;
+    }
+
+    //! Returns "Observables_Stream_Sink"
+    std::string implementation()
+    {
+        return "Observables_Stream_Sink";
+    }
+
+    void connect(gr::top_block_sptr top_block);
+    void disconnect(gr::top_block_sptr top_block);
+    gr::basic_block_sptr get_left_block();
+    gr::basic_block_sptr get_right_block();
+
+    void reset()
+    {
+        return;
+    }
+
+    size_t item_size()
+    {
+        return sizeof(Gnss_Synchro);
+    }
+
+private:
+    observables_stream_sink_sptr sink_;
+    std::string role_;
+    unsigned int in_streams_;
+    unsigned int out_streams_;
+};
+
+#endif
@@ -0,0 +1,81 @@
+/*!
+ * \file observables_stream_source_adapter.cc
+ * \brief Observables of a central receiver, received from an edge receiver
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "observables_stream_source_adapter.h"
+#include <glog/logging.h>
+#include "configuration_interface.h"
+
+using google::LogMessage;
+
+ObservablesStreamSourceAdapter::ObservablesStreamSourceAdapter(ConfigurationInterface* configuration,
+        std::string role,
+        unsigned int in_streams,
+        unsigned int out_streams) :
+                role_(role),
+                in_streams_(in_streams),
+                out_streams_(out_streams)
+{
+    unsigned short port = configuration->property(role + ".port", 2102);
+    // empty accepts any station
+    std::string station = configuration->property(role + ".station", std::string(""));
+    source_ = make_observables_stream_source(out_streams_, port, station);
+    DLOG(INFO) << "observables stream source(" << source_->unique_id() << ")";
+}
+
+
+ObservablesStreamSourceAdapter::~ObservablesStreamSourceAdapter()
+{}
+
+
+void ObservablesStreamSourceAdapter::connect(gr::top_block_sptr top_block)
+{
+    if(top_block) { /* top_block is not null */};
+    // Nothing to connect internally
+    DLOG(INFO) << "nothing to connect internally";
+}
+
+
+void ObservablesStreamSourceAdapter::disconnect(gr::top_block_sptr top_block)
+{
+    if(top_block) { /* top_block is not null */};
+    // Nothing to disconnect
+}
+
+
+gr::basic_block_sptr ObservablesStreamSourceAdapter::get_left_block()
+{
+    return source_; // this is a source, nothing upstream
+}
+
+
+gr::basic_block_sptr ObservablesStreamSourceAdapter::get_right_block()
+{
+    return source_;
+}
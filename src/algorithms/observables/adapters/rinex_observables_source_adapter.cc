@@ -0,0 +1,91 @@
+/*!
+ * \file rinex_observables_source_adapter.cc
+ * \brief Adapts the replay of the observables of RINEX files to an ObservablesInterface
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "rinex_observables_source_adapter.h"
+#include <vector>
+#include <boost/algorithm/string.hpp>
+#include <glog/logging.h>
+#include "configuration_interface.h"
+
+using google::LogMessage;
+
+RinexObservablesSourceAdapter::RinexObservablesSourceAdapter(ConfigurationInterface* configuration,
+        std::string role,
+        unsigned int in_streams,
+        unsigned int out_streams,
+        boost::shared_ptr<gr::msg_queue> queue) :
+                role_(role),
+                in_streams_(in_streams),
+                out_streams_(out_streams)
+{
+    std::string obs_filename = configuration->property(role + ".obs_filename", std::string("./observables.16o"));
+    // a comma separated list, such as the GPS and the Galileo navigation files
+    std::string nav_filename = configuration->property(role + ".nav_filename", std::string(""));
+    std::vector<std::string> nav_files;
+    boost::split(nav_files, nav_filename, boost::is_any_of(","), boost::token_compress_on);
+    for (std::vector<std::string>::iterator it = nav_files.begin(); it != nav_files.end(); )
+        {
+            boost::trim(*it);
+            it = it->empty() ? nav_files.erase(it) : it + 1;
+        }
+    source_ = make_rinex_observables_source(out_streams_, obs_filename, nav_files, queue);
+    DLOG(INFO) << "RINEX observables source(" << source_->unique_id() << ")";
+}
+
+
+RinexObservablesSourceAdapter::~RinexObservablesSourceAdapter()
+{}
+
+
+void RinexObservablesSourceAdapter::connect(gr::top_block_sptr top_block)
+{
+    if(top_block) { /* top_block is not null */};
+    // Nothing to connect internally
+    DLOG(INFO) << "nothing to connect internally";
+}
+
+
+void RinexObservablesSourceAdapter::disconnect(gr::top_block_sptr top_block)
+{
+    if(top_block) { /* top_block is not null */};
+    // Nothing to disconnect
+}
+
+
+gr::basic_block_sptr RinexObservablesSourceAdapter::get_left_block()
+{
+    return source_; // this is a source, nothing upstream
+}
+
+
+gr::basic_block_sptr RinexObservablesSourceAdapter::get_right_block()
+{
+    return source_;
+}
@@ -0,0 +1,92 @@
+/*!
+ * \file rinex_observables_source_adapter.h
+ * \brief Adapts the replay of the observables of RINEX files to an ObservablesInterface
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_RINEX_OBSERVABLES_SOURCE_ADAPTER_H_
+#define GNSS_SDR_RINEX_OBSERVABLES_SOURCE_ADAPTER_H_
+
+#include <string>
+#include <gnuradio/msg_queue.h>
+#include "observables_interface.h"
+#include "rinex_observables_source.h"
+
+
+class ConfigurationInterface;
+
+/*!
+ * \brief This class implements an ObservablesInterface whose observables
+ * are read from RINEX 3 files, to run the PVT and its outputs again on
+ * them. As with Observables_Stream_Source, the flowgraph has no signal
+ * source nor channels.
+ */
+class RinexObservablesSourceAdapter : public ObservablesInterface
+{
+public:
+    RinexObservablesSourceAdapter(ConfigurationInterface* configuration,
+            std::string role,
+            unsigned int in_streams,
+            unsigned int out_streams,
+            boost::shared_ptr<gr::msg_queue> queue);
+
+    virtual ~RinexObservablesSourceAdapter();
+
+    std::string role()
+    {
+        return role_;
+    }
+
+    //! Returns "RINEX_Observables_Source"
+    std::string implementation()
+    {
+        return "RINEX_Observables_Source";
+    }
+
+    void connect(gr::top_block_sptr top_block);
+    void disconnect(gr::top_block_sptr top_block);
+    gr::basic_block_sptr get_left_block();
+    gr::basic_block_sptr get_right_block();
+
+    void reset()
+    {
+        return;
+    }
+
+    size_t item_size()
+    {
+        return sizeof(Gnss_Synchro);
+    }
+
+private:
+    rinex_observables_source_sptr source_;
+    std::string role_;
+    unsigned int in_streams_;
+    unsigned int out_streams_;
+};
+
+#endif
@@ -37,6 +37,8 @@
 #include <fstream>
 #include <string>
 #include <gnuradio/block.h>
+#include "observables_sync.h"
+#include "ring_buffer.h"
 
 
 class galileo_e1_observables_cc;
@@ -44,7 +46,7 @@ class galileo_e1_observables_cc;
 typedef boost::shared_ptr<galileo_e1_observables_cc> galileo_e1_observables_cc_sptr;
 
 galileo_e1_observables_cc_sptr
-galileo_e1_make_observables_cc(unsigned int n_channels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging);
+galileo_e1_make_observables_cc(unsigned int n_channels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging, unsigned int epoch_rate_hz);
 
 /*!
  * \brief This class implements a block that computes Galileo observables
@@ -57,15 +59,26 @@ public:
     int general_work (int noutput_items, gr_vector_int &ninput_items,
             gr_vector_const_void_star &input_items, gr_vector_void_star &output_items);
 
+    //! Sample rate of the tracking blocks [Hz], to align the channels with their sample stamps
+    void set_sample_rate(uint64_t fs_hz)
+    {
+        d_sync.set_sample_rate(fs_hz);
+    }
+
 private:
     friend galileo_e1_observables_cc_sptr
-    galileo_e1_make_observables_cc(unsigned int nchannels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging);
-    galileo_e1_observables_cc(unsigned int nchannels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging);
+    galileo_e1_make_observables_cc(unsigned int nchannels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging, unsigned int epoch_rate_hz);
+    galileo_e1_observables_cc(unsigned int nchannels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging, unsigned int epoch_rate_hz);
+
+    void symbol_observables(const Gnss_Synchro* const* in);
+
+    // measurements of the current epoch, aligned to the common reception time
+    observables_sync d_sync;
 
     //Tracking observable history
-    std::vector<std::deque<double>> d_acc_carrier_phase_queue_rads;
-    std::vector<std::deque<double>> d_carrier_doppler_queue_hz;
-    std::vector<std::deque<double>> d_symbol_TOW_queue_s;
+    std::vector<ring_buffer<double>> d_acc_carrier_phase_queue_rads;
+    std::vector<ring_buffer<double>> d_carrier_doppler_queue_hz;
+    std::vector<ring_buffer<double>> d_symbol_TOW_queue_s;
 
     // class private vars
     bool d_dump;
@@ -31,15 +31,14 @@
 #include <algorithm>
 #include <cmath>
 #include <iostream>
-#include <map>
 #include <vector>
-#include <utility>
-#include <armadillo>
 #include <gnuradio/io_signature.h>
 #include <glog/logging.h>
 #include "control_message_factory.h"
+#include "gnss_sdr_latency_tracer.h"
 #include "gnss_synchro.h"
 #include "GPS_L1_CA.h"
+#include "gnss_sdr_trace.h"
 
 
 
@@ -47,15 +46,16 @@ using google::LogMessage;
 
 
 gps_l1_ca_observables_cc_sptr
-gps_l1_ca_make_observables_cc(unsigned int nchannels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging)
+gps_l1_ca_make_observables_cc(unsigned int nchannels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging, unsigned int epoch_rate_hz)
 {
-    return gps_l1_ca_observables_cc_sptr(new gps_l1_ca_observables_cc(nchannels, dump, dump_filename, output_rate_ms, flag_averaging));
+    return gps_l1_ca_observables_cc_sptr(new gps_l1_ca_observables_cc(nchannels, dump, dump_filename, output_rate_ms, flag_averaging, epoch_rate_hz));
 }
 
 
-gps_l1_ca_observables_cc::gps_l1_ca_observables_cc(unsigned int nchannels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging) :
+gps_l1_ca_observables_cc::gps_l1_ca_observables_cc(unsigned int nchannels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging, unsigned int epoch_rate_hz) :
                                 gr::block("gps_l1_ca_observables_cc", gr::io_signature::make(nchannels, nchannels, sizeof(Gnss_Synchro)),
-                                gr::io_signature::make(nchannels, nchannels, sizeof(Gnss_Synchro)))
+                                gr::io_signature::make(nchannels, nchannels, sizeof(Gnss_Synchro))),
+                                d_sync(nchannels, &Gnss_Synchro::d_TOW_at_current_symbol, GPS_STARTOFFSET_ms, GPS_C_m_ms)
 {
     // initialize internal vars
     d_dump = dump;
@@ -63,12 +63,13 @@ gps_l1_ca_observables_cc::gps_l1_ca_observables_cc(unsigned int nchannels, bool
     d_output_rate_ms = output_rate_ms;
     d_dump_filename = dump_filename;
     d_flag_averaging = flag_averaging;
+    d_sync.set_epoch_rate(epoch_rate_hz);
 
     for (unsigned int i = 0; i < d_nchannels; i++)
         {
-            d_acc_carrier_phase_queue_rads.push_back(std::deque<double>(d_nchannels));
-            d_carrier_doppler_queue_hz.push_back(std::deque<double>(d_nchannels));
-            d_symbol_TOW_queue_s.push_back(std::deque<double>(d_nchannels));
+            d_acc_carrier_phase_queue_rads.push_back(ring_buffer<double>(GPS_L1_CA_HISTORY_DEEP));
+            d_carrier_doppler_queue_hz.push_back(ring_buffer<double>(GPS_L1_CA_HISTORY_DEEP));
+            d_symbol_TOW_queue_s.push_back(ring_buffer<double>(GPS_L1_CA_HISTORY_DEEP));
         }
 
     // ############# ENABLE DATA FILE LOG #################
@@ -98,68 +99,22 @@ gps_l1_ca_observables_cc::~gps_l1_ca_observables_cc()
 }
 
 
-bool pairCompare_gnss_synchro_Prn_delay_ms(const std::pair<int,Gnss_Synchro>& a, const std::pair<int,Gnss_Synchro>& b)
+void gps_l1_ca_observables_cc::symbol_observables(const Gnss_Synchro* const* in)
 {
-    return (a.second.Prn_timestamp_ms) < (b.second.Prn_timestamp_ms);
-}
-
-
-bool pairCompare_gnss_synchro_d_TOW_at_current_symbol(const std::pair<int,Gnss_Synchro>& a, const std::pair<int,Gnss_Synchro>& b)
-{
-    return (a.second.d_TOW_at_current_symbol) < (b.second.d_TOW_at_current_symbol);
-}
-
-
-int gps_l1_ca_observables_cc::general_work (int noutput_items, gr_vector_int &ninput_items,
-        gr_vector_const_void_star &input_items,    gr_vector_void_star &output_items)
-{
-    Gnss_Synchro **in = (Gnss_Synchro **)  &input_items[0];   // Get the input pointer
-    Gnss_Synchro **out = (Gnss_Synchro **)  &output_items[0]; // Get the output pointer
-
-    Gnss_Synchro current_gnss_synchro[d_nchannels];
-    std::map<int,Gnss_Synchro> current_gnss_synchro_map;
-    std::map<int,Gnss_Synchro>::iterator gnss_synchro_iter;
-    
-    if (d_nchannels != ninput_items.size())
-        {
-            LOG(WARNING) << "The Observables block is not well connected";
-        }
-
     /*
      * 1. Read the GNSS SYNCHRO objects from available channels
      */
+    d_sync.load(in);
     for (unsigned int i = 0; i < d_nchannels; i++)
         {
-            //Copy the telemetry decoder data to local copy
-            current_gnss_synchro[i] = in[i][0];
-            /*
-             * 1.2 Assume no valid pseudoranges
-             */
-            current_gnss_synchro[i].Flag_valid_pseudorange = false;
-            current_gnss_synchro[i].Pseudorange_m = 0.0;
-            if (current_gnss_synchro[i].Flag_valid_word) //if this channel have valid word
+            if (d_sync.valid(i)) //if this channel have valid word
                 {
-                    //record the word structure in a map for pseudorange computation
-                    current_gnss_synchro_map.insert(std::pair<int, Gnss_Synchro>(current_gnss_synchro[i].Channel_ID, current_gnss_synchro[i]));
-
                     //################### SAVE DOPPLER AND ACC CARRIER PHASE HISTORIC DATA FOR INTERPOLATION IN OBSERVABLE MODULE #######
-                    d_carrier_doppler_queue_hz[i].push_back(current_gnss_synchro[i].Carrier_Doppler_hz);
-                    d_acc_carrier_phase_queue_rads[i].push_back(current_gnss_synchro[i].Carrier_phase_rads);
+                    d_carrier_doppler_queue_hz[i].push_back(d_sync.synchro(i).Carrier_Doppler_hz);
+                    d_acc_carrier_phase_queue_rads[i].push_back(d_sync.synchro(i).Carrier_phase_rads);
                     // save TOW history
-                    d_symbol_TOW_queue_s[i].push_back(current_gnss_synchro[i].d_TOW_at_current_symbol);
-
-                    if (d_carrier_doppler_queue_hz[i].size() > GPS_L1_CA_HISTORY_DEEP)
-                        {
-                            d_carrier_doppler_queue_hz[i].pop_front();
-                        }
-                    if (d_acc_carrier_phase_queue_rads[i].size() > GPS_L1_CA_HISTORY_DEEP)
-                        {
-                            d_acc_carrier_phase_queue_rads[i].pop_front();
-                        }
-                    if (d_symbol_TOW_queue_s[i].size() > GPS_L1_CA_HISTORY_DEEP)
-                        {
-                            d_symbol_TOW_queue_s[i].pop_front();
-                        }
+                    d_symbol_TOW_queue_s[i].push_back(d_sync.synchro(i).d_TOW_at_current_symbol);
+                    // the history buffers keep the last GPS_L1_CA_HISTORY_DEEP values
                 }
             else
                 {
@@ -176,73 +131,49 @@ int gps_l1_ca_observables_cc::general_work (int noutput_items, gr_vector_int &ni
     /*
      * 2. Compute RAW pseudoranges using COMMON RECEPTION TIME algorithm. Use only the valid channels (channels that are tracking a satellite)
      */
-    if(current_gnss_synchro_map.size() > 0)
+    if (d_sync.compute_pseudoranges())
         {
-            /*
-             *  2.1 Use CURRENT set of measurements and find the nearest satellite
-             *  common RX time algorithm
-             */
-            // what is the most recent symbol TOW in the current set? -> this will be the reference symbol
-            gnss_synchro_iter = max_element(current_gnss_synchro_map.begin(), current_gnss_synchro_map.end(), pairCompare_gnss_synchro_d_TOW_at_current_symbol);
-            double d_TOW_reference = gnss_synchro_iter->second.d_TOW_at_current_symbol;
-            double d_ref_PRN_rx_time_ms = gnss_synchro_iter->second.Prn_timestamp_ms;
-            //int reference_channel= gnss_synchro_iter->second.Channel_ID;
-
-            // Now compute RX time differences due to the PRN alignment in the correlators
-            double traveltime_ms;
-            double pseudorange_m;
-            double delta_rx_time_ms;
-            arma::vec symbol_TOW_vec_s;
-            arma::vec dopper_vec_hz;
-            arma::vec dopper_vec_interp_hz;
-            arma::vec acc_phase_vec_rads;
-            arma::vec acc_phase_vec_interp_rads;
-            arma::vec desired_symbol_TOW(1);
-            for(gnss_synchro_iter = current_gnss_synchro_map.begin(); gnss_synchro_iter != current_gnss_synchro_map.end(); gnss_synchro_iter++)
+            for (int ch = d_sync.first_valid(); ch >= 0; ch = d_sync.next_valid(ch))
                 {
-                    // compute the required symbol history shift in order to match the reference symbol
-                    delta_rx_time_ms = gnss_synchro_iter->second.Prn_timestamp_ms - d_ref_PRN_rx_time_ms;
-                    //compute the pseudorange
-                    traveltime_ms = (d_TOW_reference-gnss_synchro_iter->second.d_TOW_at_current_symbol) * 1000.0 + delta_rx_time_ms + GPS_STARTOFFSET_ms;
-                    pseudorange_m = traveltime_ms * GPS_C_m_ms; // [m]
-                    // update the pseudorange object
-                    current_gnss_synchro[gnss_synchro_iter->second.Channel_ID] = gnss_synchro_iter->second;
-                    current_gnss_synchro[gnss_synchro_iter->second.Channel_ID].Pseudorange_m = pseudorange_m;
-                    current_gnss_synchro[gnss_synchro_iter->second.Channel_ID].Flag_valid_pseudorange = true;
-                    current_gnss_synchro[gnss_synchro_iter->second.Channel_ID].d_TOW_at_current_symbol = round(d_TOW_reference*1000.0)/1000.0 + GPS_STARTOFFSET_ms/1000.0;
-
-                    if (d_symbol_TOW_queue_s[gnss_synchro_iter->second.Channel_ID].size()>=GPS_L1_CA_HISTORY_DEEP)
+                    if (d_symbol_TOW_queue_s[ch].size() >= GPS_L1_CA_HISTORY_DEEP)
                         {
-                            // compute interpolated observation values for Doppler and Accumulate carrier phase
-                            symbol_TOW_vec_s = arma::vec(std::vector<double>(d_symbol_TOW_queue_s[gnss_synchro_iter->second.Channel_ID].begin(), d_symbol_TOW_queue_s[gnss_synchro_iter->second.Channel_ID].end()));
-                            acc_phase_vec_rads = arma::vec(std::vector<double>(d_acc_carrier_phase_queue_rads[gnss_synchro_iter->second.Channel_ID].begin(), d_acc_carrier_phase_queue_rads[gnss_synchro_iter->second.Channel_ID].end()));
-                            dopper_vec_hz = arma::vec(std::vector<double>(d_carrier_doppler_queue_hz[gnss_synchro_iter->second.Channel_ID].begin(), d_carrier_doppler_queue_hz[gnss_synchro_iter->second.Channel_ID].end()));
+                            // compute interpolated observation values for Doppler and Accumulate carrier phase,
+                            // fitting a line to the history
+                            double desired_symbol_TOW = d_symbol_TOW_queue_s[ch].back() + d_sync.delta_rx_time_ms(ch) / 1000.0;
+                            d_sync.synchro(ch).Carrier_phase_rads = observables_sync::linear_fit(d_symbol_TOW_queue_s[ch], d_acc_carrier_phase_queue_rads[ch], desired_symbol_TOW);
+                            d_sync.synchro(ch).Carrier_Doppler_hz = observables_sync::linear_fit(d_symbol_TOW_queue_s[ch], d_carrier_doppler_queue_hz[ch], desired_symbol_TOW);
+                        }
+                }
+        }
+}
 
-                            desired_symbol_TOW[0] = symbol_TOW_vec_s[GPS_L1_CA_HISTORY_DEEP - 1] + delta_rx_time_ms / 1000.0;
-                            //    arma::interp1(symbol_TOW_vec_s,dopper_vec_hz,desired_symbol_TOW,dopper_vec_interp_hz);
-                            //    arma::interp1(symbol_TOW_vec_s,acc_phase_vec_rads,desired_symbol_TOW,acc_phase_vec_interp_rads);
 
-                            // Curve fitting to cuadratic function
-                            arma::mat A = arma::ones<arma::mat> (GPS_L1_CA_HISTORY_DEEP, 2);
-                            A.col(1) = symbol_TOW_vec_s;
+int gps_l1_ca_observables_cc::general_work (int noutput_items, gr_vector_int &ninput_items,
+        gr_vector_const_void_star &input_items,    gr_vector_void_star &output_items)
+{
+    GNSS_SDR_TRACE_SCOPE("gps_l1_ca_observables_cc::general_work");
+    Gnss_Synchro **in = (Gnss_Synchro **)  &input_items[0];   // Get the input pointer
+    Gnss_Synchro **out = (Gnss_Synchro **)  &output_items[0]; // Get the output pointer
 
-                            arma::mat coef_acc_phase(1,3);
-                            arma::mat pinv_A = arma::pinv(A.t() * A) * A.t();
-                            coef_acc_phase = pinv_A * acc_phase_vec_rads;
-                            arma::mat coef_doppler(1,3);
-                            coef_doppler = pinv_A * dopper_vec_hz;
-                            arma::vec acc_phase_lin;
-                            arma::vec carrier_doppler_lin;
-                            acc_phase_lin = coef_acc_phase[0] + coef_acc_phase[1] * desired_symbol_TOW[0];   // +coef_acc_phase[2]*desired_symbol_TOW[0]*desired_symbol_TOW[0];
-                            carrier_doppler_lin = coef_doppler[0] + coef_doppler[1] * desired_symbol_TOW[0]; // +coef_doppler[2]*desired_symbol_TOW[0]*desired_symbol_TOW[0];
-                            //std::cout<<"acc_phase_vec_interp_rads="<<acc_phase_vec_interp_rads[0]<<std::endl;
-                            //std::cout<<"dopper_vec_interp_hz="<<dopper_vec_interp_hz[0]<<std::endl;
-                            current_gnss_synchro[gnss_synchro_iter->second.Channel_ID].Carrier_phase_rads = acc_phase_lin[0];
-                            current_gnss_synchro[gnss_synchro_iter->second.Channel_ID].Carrier_Doppler_hz = carrier_doppler_lin[0];
-                        }
+    if (d_nchannels != ninput_items.size())
+        {
+            LOG(WARNING) << "The Observables block is not well connected";
+        }
 
+    if (d_sync.epoch_rate() > 0)
+        {
+            // observables at receiver epochs, interpolated from the channel histories
+            if (d_sync.load_epoch(in) == false)
+                {
+                    consume_each(1);
+                    return 0;
                 }
         }
+    else
+        {
+            // observables at the latest symbol of every channel
+            symbol_observables(in);
+        }
 
     if(d_dump == true)
         {
@@ -252,20 +183,20 @@ int gps_l1_ca_observables_cc::general_work (int noutput_items, gr_vector_int &ni
                     double tmp_double;
                     for (unsigned int i = 0; i < d_nchannels; i++)
                         {
-                            tmp_double = current_gnss_synchro[i].d_TOW_at_current_symbol;
+                            tmp_double = d_sync.synchro(i).d_TOW_at_current_symbol;
                             d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            //tmp_double = current_gnss_synchro[i].Prn_timestamp_ms;
-                            tmp_double = current_gnss_synchro[i].Carrier_Doppler_hz;
+                            //tmp_double = d_sync.synchro(i).Prn_timestamp_ms;
+                            tmp_double = d_sync.synchro(i).Carrier_Doppler_hz;
                             d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            tmp_double = current_gnss_synchro[i].Carrier_phase_rads/GPS_TWO_PI;
+                            tmp_double = d_sync.synchro(i).Carrier_phase_rads/GPS_TWO_PI;
                             d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            tmp_double = current_gnss_synchro[i].Pseudorange_m;
+                            tmp_double = d_sync.synchro(i).Pseudorange_m;
                             d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            //tmp_double = (double)(current_gnss_synchro[i].Flag_valid_pseudorange==true);
-                            //tmp_double = current_gnss_synchro[i].debug_var1;
-                            //tmp_double = current_gnss_synchro[i].debug_var2;
+                            //tmp_double = (double)(d_sync.synchro(i).Flag_valid_pseudorange==true);
+                            //tmp_double = d_sync.synchro(i).debug_var1;
+                            //tmp_double = d_sync.synchro(i).debug_var2;
                             //d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            tmp_double = current_gnss_synchro[i].PRN;
+                            tmp_double = d_sync.synchro(i).PRN;
                             d_dump_file.write((char*)&tmp_double, sizeof(double));
                         }
             }
@@ -276,10 +207,13 @@ int gps_l1_ca_observables_cc::general_work (int noutput_items, gr_vector_int &ni
         }
 
     consume_each(1); //one by one
+    double signal_time_s = 0.0;  // of the newest samples in the observables
     for (unsigned int i = 0; i < d_nchannels; i++)
         {
-            *out[i] = current_gnss_synchro[i];
+            *out[i] = d_sync.synchro(i);
+            if (d_sync.synchro(i).Flag_valid_pseudorange) signal_time_s = std::max(signal_time_s, d_sync.synchro(i).Tracking_timestamp_secs);
         }
+    if (signal_time_s > 0.0) Gnss_Sdr_Latency_Tracer::record("observables", signal_time_s);
     if (noutput_items == 0)
         {
             LOG(WARNING) << "noutput_items = 0";
@@ -30,17 +30,16 @@
  */
 
 #include "hybrid_observables_cc.h"
-#include <algorithm>
 #include <cmath>
 #include <iostream>
-#include <map>
-#include <utility>
 #include <vector>
+#include <boost/lexical_cast.hpp>
 #include <gnuradio/io_signature.h>
 #include <glog/logging.h>
 #include "gnss_synchro.h"
 #include "Galileo_E1.h"
 #include "GPS_L1_CA.h"
+#include "gnss_sdr_trace.h"
 
 
 
@@ -48,15 +47,17 @@ using google::LogMessage;
 
 
 hybrid_observables_cc_sptr
-hybrid_make_observables_cc(unsigned int nchannels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging)
+hybrid_make_observables_cc(unsigned int nchannels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging, unsigned int epoch_rate_hz)
 {
-    return hybrid_observables_cc_sptr(new hybrid_observables_cc(nchannels, dump, dump_filename, output_rate_ms, flag_averaging));
+    return hybrid_observables_cc_sptr(new hybrid_observables_cc(nchannels, dump, dump_filename, output_rate_ms, flag_averaging, epoch_rate_hz));
 }
 
 
-hybrid_observables_cc::hybrid_observables_cc(unsigned int nchannels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging) :
+hybrid_observables_cc::hybrid_observables_cc(unsigned int nchannels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging, unsigned int epoch_rate_hz) :
                                 gr::block("hybrid_observables_cc", gr::io_signature::make(nchannels, nchannels, sizeof(Gnss_Synchro)),
-                                gr::io_signature::make(nchannels, nchannels, sizeof(Gnss_Synchro)))
+                                gr::io_signature::make(nchannels, nchannels, sizeof(Gnss_Synchro))),
+                                d_sync(nchannels, &Gnss_Synchro::d_TOW_hybrid_at_current_symbol, GALILEO_STARTOFFSET_ms, GALILEO_C_m_ms),
+                                d_dump_file("hybrid_observables")
 {
     // initialize internal vars
     d_dump = dump;
@@ -64,22 +65,28 @@ hybrid_observables_cc::hybrid_observables_cc(unsigned int nchannels, bool dump,
     d_output_rate_ms = output_rate_ms;
     d_dump_filename = dump_filename;
     d_flag_averaging = flag_averaging;
+    d_sync.set_epoch_rate(epoch_rate_hz);
 
     // ############# ENABLE DATA FILE LOG #################
     if (d_dump == true)
         {
             if (d_dump_file.is_open() == false)
                 {
-                    try
-                    {
-                            d_dump_file.exceptions (std::ifstream::failbit | std::ifstream::badbit );
-                            d_dump_file.open(d_dump_filename.c_str(), std::ios::out | std::ios::binary);
+                    // one group of fields per channel
+                    for (unsigned int i = 0; i < d_nchannels; i++)
+                        {
+                            const std::string ch = "ch" + boost::lexical_cast<std::string>(i) + "_";
+                            d_dump_file.add_field(ch + "TOW_at_current_symbol_s", BINARY_DUMP_FLOAT64);
+                            d_dump_file.add_field(ch + "TOW_hybrid_s", BINARY_DUMP_FLOAT64);
+                            d_dump_file.add_field(ch + "PRN_timestamp_ms", BINARY_DUMP_FLOAT64);
+                            d_dump_file.add_field(ch + "pseudorange_m", BINARY_DUMP_FLOAT64);
+                            d_dump_file.add_field(ch + "valid_pseudorange", BINARY_DUMP_FLOAT64);
+                            d_dump_file.add_field(ch + "PRN", BINARY_DUMP_FLOAT64);
+                        }
+                    if (d_dump_file.open(d_dump_filename))
+                        {
                             LOG(INFO) << "Observables dump enabled Log file: " << d_dump_filename.c_str();
-                    }
-                    catch (const std::ifstream::failure & e)
-                    {
-                            LOG(WARNING) << "Exception opening observables dump file " << e.what();
-                    }
+                        }
                 }
         }
 }
@@ -93,144 +100,74 @@ hybrid_observables_cc::~hybrid_observables_cc()
 
 
 
-bool Hybrid_pairCompare_gnss_synchro_Prn_delay_ms(const std::pair<int,Gnss_Synchro>& a, const std::pair<int,Gnss_Synchro>& b)
-{
-    return (a.second.Prn_timestamp_ms) < (b.second.Prn_timestamp_ms);
-}
-
-
-bool Hybrid_pairCompare_gnss_synchro_d_TOW_hybrid_at_current_symbol(const std::pair<int,Gnss_Synchro>& a, const std::pair<int,Gnss_Synchro>& b)
-{
-    return (a.second.d_TOW_hybrid_at_current_symbol) < (b.second.d_TOW_hybrid_at_current_symbol);
-}
-
-bool Hybrid_pairCompare_gnss_synchro_d_TOW_at_current_symbol(const std::pair<int,Gnss_Synchro>& a, const std::pair<int,Gnss_Synchro>& b)
-{
-    return (a.second.d_TOW_at_current_symbol) < (b.second.d_TOW_at_current_symbol);
-}
-
-
 int hybrid_observables_cc::general_work (int noutput_items, gr_vector_int &ninput_items,
         gr_vector_const_void_star &input_items,    gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE("hybrid_observables_cc::general_work");
     Gnss_Synchro **in = (Gnss_Synchro **)  &input_items[0];   // Get the input pointer
     Gnss_Synchro **out = (Gnss_Synchro **)  &output_items[0]; // Get the output pointer
 
-    Gnss_Synchro current_gnss_synchro[d_nchannels];
-    std::map<int,Gnss_Synchro> current_gnss_synchro_map;
-    std::map<int,Gnss_Synchro> current_gnss_synchro_map_gps_only;
-    std::map<int,Gnss_Synchro>::iterator gnss_synchro_iter;
-
     if (d_nchannels != ninput_items.size())
         {
             LOG(WARNING) << "The Observables block is not well connected";
         }
 
-    /*
-     * 1. Read the GNSS SYNCHRO objects from available channels
-     */
-    for (unsigned int i = 0; i < d_nchannels; i++)
+    if (d_sync.epoch_rate() > 0)
         {
-            //Copy the telemetry decoder data to local copy
-            current_gnss_synchro[i] = in[i][0];
-            /*
-             * 1.2 Assume no valid pseudoranges
-             */
-            current_gnss_synchro[i].Flag_valid_pseudorange = false;
-            current_gnss_synchro[i].Pseudorange_m = 0.0;
-            if (current_gnss_synchro[i].Flag_valid_word)
+            // observables at receiver epochs, interpolated from the channel histories
+            if (d_sync.load_epoch(in) == false)
                 {
-                    //record the word structure in a map for pseudorange computation
-                    current_gnss_synchro_map.insert(std::pair<int, Gnss_Synchro>(current_gnss_synchro[i].Channel_ID, current_gnss_synchro[i]));
-                    if (current_gnss_synchro[i].System == 'G')
-                        {
-                            current_gnss_synchro_map_gps_only.insert(std::pair<int, Gnss_Synchro>(current_gnss_synchro[i].Channel_ID, current_gnss_synchro[i]));
-                        }
+                    consume_each(1);
+                    return 0;
                 }
         }
-
-    /*
-     * 2. Compute RAW pseudoranges using COMMON RECEPTION TIME algorithm. Use only the valid channels (channels that are tracking a satellite)
-     */
-    DLOG(INFO) << "gnss_synchro set size=" << current_gnss_synchro_map.size();
-
-    if(current_gnss_synchro_map.size() > 0)// and current_gnss_synchro_map_gps_only.size()>0)
+    else
         {
             /*
-             *  2.1 Use CURRENT set of measurements and find the nearest satellite
-             *  common RX time algorithm
+             * 1. Read the GNSS SYNCHRO objects from available channels
+             */
+            d_sync.load(in);
+
+            /*
+             * 2. Compute RAW pseudoranges using COMMON RECEPTION TIME algorithm. Use only the valid channels (channels that are tracking a satellite)
              */
-            // what is the most recent symbol TOW in the current set? -> this will be the reference symbol
-            gnss_synchro_iter = max_element(current_gnss_synchro_map.begin(), current_gnss_synchro_map.end(), Hybrid_pairCompare_gnss_synchro_d_TOW_hybrid_at_current_symbol);
-            //gnss_synchro_iter = max_element(current_gnss_synchro_map_gps_only.begin(), current_gnss_synchro_map_gps_only.end(), Hybrid_pairCompare_gnss_synchro_d_TOW_hybrid_at_current_symbol);
-            double d_TOW_reference = gnss_synchro_iter->second.d_TOW_hybrid_at_current_symbol;
-            DLOG(INFO) << "d_TOW_hybrid_reference [ms] = " << d_TOW_reference * 1000;
-            double d_ref_PRN_rx_time_ms = gnss_synchro_iter->second.Prn_timestamp_ms;
-            DLOG(INFO) << "ref_PRN_rx_time_ms [ms] = " << d_ref_PRN_rx_time_ms;
-            //int reference_channel= gnss_synchro_iter->second.Channel_ID;
-
-            // Now compute RX time differences due to the PRN alignment in the correlators
-            double traveltime_ms;
-            double pseudorange_m;
-            double delta_rx_time_ms;
-            double delta_TOW_ms;
-            for(gnss_synchro_iter = current_gnss_synchro_map.begin(); gnss_synchro_iter != current_gnss_synchro_map.end(); gnss_synchro_iter++)
+            d_sync.compute_pseudoranges();
+        }
+    DLOG(INFO) << "gnss_synchro set size=" << d_sync.num_valid();
+
+    if (d_sync.num_valid() > 0)
+        {
+            DLOG(INFO) << "ref_PRN_rx_time_ms [ms] = " << d_sync.synchro(d_sync.reference_channel()).Prn_timestamp_ms;
+            for (int ch = d_sync.first_valid(); ch >= 0; ch = d_sync.next_valid(ch))
                 {
-                    // check and correct synchronization in cross-system pseudoranges!
-                    delta_rx_time_ms = gnss_synchro_iter->second.Prn_timestamp_ms - d_ref_PRN_rx_time_ms;
-                    delta_TOW_ms = (d_TOW_reference - gnss_synchro_iter->second.d_TOW_hybrid_at_current_symbol) * 1000.0;
-
-                    //compute the pseudorange
-                    traveltime_ms =  delta_TOW_ms + delta_rx_time_ms + GALILEO_STARTOFFSET_ms;
-                    pseudorange_m = traveltime_ms * GALILEO_C_m_ms; // [m]
-                    DLOG(INFO) << "CH " << gnss_synchro_iter->second.Channel_ID << " tracking GNSS System "
-                               << gnss_synchro_iter->second.System << " has PRN start at= " << gnss_synchro_iter->second.Prn_timestamp_ms
-                               << " [ms], d_TOW_at_current_symbol = " << (gnss_synchro_iter->second.d_TOW_at_current_symbol) * 1000
-                               << " [ms], d_TOW_hybrid_at_current_symbol = "<< (gnss_synchro_iter->second.d_TOW_hybrid_at_current_symbol) * 1000
-                               << "[ms], delta_rx_time_ms = " << delta_rx_time_ms << "[ms], travel_time = " << traveltime_ms
-                               << ", pseudorange[m] = "<< pseudorange_m;
-
-                    // update the pseudorange object
-                    //current_gnss_synchro[gnss_synchro_iter->second.Channel_ID] = gnss_synchro_iter->second;
-                    current_gnss_synchro[gnss_synchro_iter->second.Channel_ID].Pseudorange_m = pseudorange_m;
-                    current_gnss_synchro[gnss_synchro_iter->second.Channel_ID].Flag_valid_pseudorange = true;
-                    current_gnss_synchro[gnss_synchro_iter->second.Channel_ID].d_TOW_hybrid_at_current_symbol = round(d_TOW_reference * 1000) / 1000 + GALILEO_STARTOFFSET_ms / 1000.0;
+                    DLOG(INFO) << "CH " << d_sync.synchro(ch).Channel_ID << " tracking GNSS System "
+                               << d_sync.synchro(ch).System << " has PRN start at= " << d_sync.synchro(ch).Prn_timestamp_ms
+                               << " [ms], d_TOW_at_current_symbol = " << (d_sync.synchro(ch).d_TOW_at_current_symbol) * 1000
+                               << " [ms], d_TOW_hybrid_at_current_symbol = "<< (d_sync.synchro(ch).d_TOW_hybrid_at_current_symbol) * 1000
+                               << "[ms], delta_rx_time_ms = " << d_sync.delta_rx_time_ms(ch)
+                               << "[ms], pseudorange[m] = "<< d_sync.synchro(ch).Pseudorange_m;
                 }
         }
 
     if(d_dump == true)
         {
             // MULTIPLEXED FILE RECORDING - Record results to file
-            try
-            {
-                    double tmp_double;
-                    for (unsigned int i = 0; i < d_nchannels ; i++)
-                        {
-                            tmp_double = current_gnss_synchro[i].d_TOW_at_current_symbol;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            tmp_double = current_gnss_synchro[i].d_TOW_hybrid_at_current_symbol;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            tmp_double = current_gnss_synchro[i].Prn_timestamp_ms;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            tmp_double = current_gnss_synchro[i].Pseudorange_m;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            tmp_double = (double)(current_gnss_synchro[i].Flag_valid_pseudorange==true);
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                            tmp_double = current_gnss_synchro[i].PRN;
-                            d_dump_file.write((char*)&tmp_double, sizeof(double));
-                        }
-            }
-            catch (const std::ifstream::failure& e)
-            {
-                    LOG(WARNING) << "Exception writing observables dump file " << e.what();
-            }
+            for (unsigned int i = 0; i < d_nchannels ; i++)
+                {
+                    d_dump_file.write(d_sync.synchro(i).d_TOW_at_current_symbol);
+                    d_dump_file.write(d_sync.synchro(i).d_TOW_hybrid_at_current_symbol);
+                    d_dump_file.write(d_sync.synchro(i).Prn_timestamp_ms);
+                    d_dump_file.write(d_sync.synchro(i).Pseudorange_m);
+                    d_dump_file.write(d_sync.synchro(i).Flag_valid_pseudorange == true);
+                    d_dump_file.write(d_sync.synchro(i).PRN);
+                }
         }
 
     consume_each(1); //consume one by one
 
     for (unsigned int i = 0; i < d_nchannels ; i++)
         {
-            *out[i] = current_gnss_synchro[i];
+            *out[i] = d_sync.synchro(i);
         }
 
     if (noutput_items == 0)
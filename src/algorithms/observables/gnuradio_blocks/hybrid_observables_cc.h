@@ -36,6 +36,8 @@
 #include <fstream>
 #include <string>
 #include <gnuradio/block.h>
+#include "binary_dump_writer.h"
+#include "observables_sync.h"
 
 
 class hybrid_observables_cc;
@@ -43,7 +45,7 @@ class hybrid_observables_cc;
 typedef boost::shared_ptr<hybrid_observables_cc> hybrid_observables_cc_sptr;
 
 hybrid_observables_cc_sptr
-hybrid_make_observables_cc(unsigned int n_channels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging);
+hybrid_make_observables_cc(unsigned int n_channels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging, unsigned int epoch_rate_hz);
 
 /*!
  * \brief This class implements a block that computes Galileo observables
@@ -55,10 +57,19 @@ public:
     int general_work (int noutput_items, gr_vector_int &ninput_items,
             gr_vector_const_void_star &input_items, gr_vector_void_star &output_items);
 
+    //! Sample rate of the tracking blocks [Hz], to align the channels with their sample stamps
+    void set_sample_rate(uint64_t fs_hz)
+    {
+        d_sync.set_sample_rate(fs_hz);
+    }
+
 private:
     friend hybrid_observables_cc_sptr
-    hybrid_make_observables_cc(unsigned int nchannels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging);
-    hybrid_observables_cc(unsigned int nchannels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging);
+    hybrid_make_observables_cc(unsigned int nchannels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging, unsigned int epoch_rate_hz);
+    hybrid_observables_cc(unsigned int nchannels, bool dump, std::string dump_filename, int output_rate_ms, bool flag_averaging, unsigned int epoch_rate_hz);
+
+    // measurements of the current epoch, aligned to the common reception time
+    observables_sync d_sync;
 
     // class private vars
     bool d_dump;
@@ -66,7 +77,7 @@ private:
     unsigned int d_nchannels;
     int d_output_rate_ms;
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Binary_Dump_Writer d_dump_file;
 };
 
 #endif
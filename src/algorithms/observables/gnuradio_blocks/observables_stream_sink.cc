@@ -0,0 +1,326 @@
+/*!
+ * \file observables_stream_sink.cc
+ * \brief Sends the observables and the navigation data of an edge receiver to a central PVT
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "observables_stream_sink.h"
+#include <algorithm>
+#include <iostream>
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+#include "gnss_nav_data_store.h"
+#include "gnss_sdr_trace.h"
+
+using google::LogMessage;
+
+
+observables_stream_sink_sptr make_observables_stream_sink(unsigned int nchannels,
+        const std::string & host, unsigned short port, const std::string & station,
+        unsigned int batch_epochs, bool tracking_outputs,
+        unsigned int max_queued_batches, unsigned int reconnect_period_ms)
+{
+    return observables_stream_sink_sptr(new observables_stream_sink(nchannels, host, port, station,
+            batch_epochs, tracking_outputs, max_queued_batches, reconnect_period_ms));
+}
+
+
+observables_stream_sink::observables_stream_sink(unsigned int nchannels,
+        const std::string & host, unsigned short port, const std::string & station,
+        unsigned int batch_epochs, bool tracking_outputs,
+        unsigned int max_queued_batches, unsigned int reconnect_period_ms)
+    : gr::sync_block("observables_stream_sink",
+            gr::io_signature::make(nchannels, nchannels, sizeof(Gnss_Synchro)),
+            gr::io_signature::make(0, 0, 0)),
+      d_encoder(nchannels, tracking_outputs),
+      d_resolver(d_io_service),
+      d_socket(d_io_service),
+      d_retry_timer(d_io_service)
+{
+    d_nchannels = nchannels;
+    d_host = host;
+    d_port = port;
+    d_station = station;
+    d_batch_epochs = std::max(batch_epochs, 1u);
+    d_max_queued_batches = std::max(max_queued_batches, 1u);
+    d_reconnect_period_ms = reconnect_period_ms;
+    d_epoch.resize(nchannels);
+    d_nav_version = 0;
+    d_resend_navigation_data = false;
+    d_connected = false;
+    d_writing = false;
+    d_stopping = false;
+    d_bytes_sent = 0;
+    d_dropped_batches = 0;
+}
+
+
+observables_stream_sink::~observables_stream_sink()
+{
+    stop();
+}
+
+
+bool observables_stream_sink::start()
+{
+    if (d_thread.joinable())
+        {
+            return true;
+        }
+    d_stopping = false;
+    d_io_service.reset();
+    d_work.reset(new boost::asio::io_service::work(d_io_service));
+    d_io_service.post([this]() { do_connect(); });
+    d_thread = std::thread([this]() { d_io_service.run(); });
+    std::cout << "Sending the observables of station " << d_station << " to "
+              << d_host << ":" << d_port << std::endl;
+    return true;
+}
+
+
+bool observables_stream_sink::stop()
+{
+    if (!d_thread.joinable())
+        {
+            return true;
+        }
+    d_io_service.post([this]()
+            {
+        d_stopping = true;
+        boost::system::error_code ec;
+        d_retry_timer.cancel(ec);
+        d_resolver.cancel();
+        d_socket.close(ec);
+        d_connected = false;
+        d_queue.clear();
+            });
+    // run() returns once the pending operations have been cancelled
+    d_work.reset();
+    d_thread.join();
+    LOG(INFO) << "Observables of station " << d_station << ": " << d_bytes_sent.load()
+              << " bytes sent, " << d_dropped_batches.load() << " batches dropped";
+    return true;
+}
+
+
+void observables_stream_sink::send(std::string frame)
+{
+    std::shared_ptr<std::string> buffer = std::make_shared<std::string>();
+    buffer->swap(frame);
+    d_io_service.post([this, buffer]()
+            {
+        if (d_stopping)
+            {
+                return;
+            }
+        if (d_queue.size() >= d_max_queued_batches)
+            {
+                // the oldest batch that is not being written; the navigation data are kept
+                for (std::deque<std::string>::iterator it = d_queue.begin() + (d_writing ? 1 : 0); it != d_queue.end(); ++it)
+                    {
+                        if (static_cast<unsigned char>((*it)[2]) == OBSERVABLES_STREAM_EPOCHS)
+                            {
+                                d_queue.erase(it);
+                                d_dropped_batches++;
+                                break;
+                            }
+                    }
+            }
+        d_queue.push_back(std::string());
+        d_queue.back().swap(*buffer);
+        do_write();
+            });
+}
+
+
+void observables_stream_sink::do_connect()
+{
+    boost::asio::ip::tcp::resolver::query query(d_host, std::to_string(d_port));
+    d_resolver.async_resolve(query, [this](boost::system::error_code ec, boost::asio::ip::tcp::resolver::iterator endpoints)
+            {
+        if (d_stopping)
+            {
+                return;
+            }
+        if (ec)
+            {
+                LOG(WARNING) << "Cannot resolve " << d_host << ": " << ec.message();
+                close_and_retry();
+                return;
+            }
+        boost::asio::async_connect(d_socket, endpoints,
+                [this](boost::system::error_code ec, boost::asio::ip::tcp::resolver::iterator /*endpoint*/)
+                        {
+            if (d_stopping)
+                {
+                    return;
+                }
+            if (ec)
+                {
+                    DLOG(INFO) << "Cannot connect to " << d_host << ":" << d_port << ": " << ec.message();
+                    close_and_retry();
+                    return;
+                }
+            LOG(INFO) << "Station " << d_station << " connected to " << d_host << ":" << d_port;
+            d_connected = true;
+            // a new connection starts with the station and all the navigation data
+            d_queue.push_front(d_encoder.hello(d_station));
+            d_resend_navigation_data = true;
+            do_write();
+                        });
+            });
+}
+
+
+void observables_stream_sink::do_write()
+{
+    if (d_writing or !d_connected or d_queue.empty())
+        {
+            return;
+        }
+    d_writing = true;
+    boost::asio::async_write(d_socket, boost::asio::buffer(d_queue.front()),
+            [this](boost::system::error_code ec, std::size_t length)
+                    {
+        d_writing = false;
+        if (d_stopping or !d_connected)
+            {
+                return;
+            }
+        if (ec)
+            {
+                // the frame is sent again, whole, on the next connection
+                LOG(WARNING) << "Connection of station " << d_station << " to " << d_host << ":" << d_port
+                             << " lost: " << ec.message();
+                close_and_retry();
+                return;
+            }
+        d_bytes_sent += length;
+        d_queue.pop_front();
+        do_write();
+                    });
+}
+
+
+void observables_stream_sink::close_and_retry()
+{
+    d_connected = false;
+    boost::system::error_code ec;
+    d_socket.close(ec);
+    d_retry_timer.expires_from_now(boost::posix_time::milliseconds(d_reconnect_period_ms));
+    d_retry_timer.async_wait([this](boost::system::error_code ec)
+            {
+        if (!ec and !d_stopping)
+            {
+                do_connect();
+            }
+            });
+}
+
+
+void observables_stream_sink::send_navigation_data()
+{
+    Gnss_Nav_Data_Store & store = Gnss_Nav_Data_Store::instance();
+    const bool resend = d_resend_navigation_data.exchange(false);
+    if (!resend and store.version() == d_nav_version)
+        {
+            return;
+        }
+    if (resend)
+        {
+            d_gps_ephemeris_sent.clear();
+            d_galileo_ephemeris_sent.clear();
+            d_gps_iono_sent.clear();
+            d_gps_utc_model_sent.clear();
+        }
+    std::shared_ptr<const Gnss_Nav_Data> nav = store.snapshot();
+    d_nav_version = nav->version;
+
+    for (std::map<int, Gps_Ephemeris>::const_iterator it = nav->gps_ephemeris_map.begin(); it != nav->gps_ephemeris_map.end(); ++it)
+        {
+            std::map<int, unsigned long long>::const_iterator version = nav->gps_ephemeris_version.find(it->first);
+            const unsigned long long v = (version != nav->gps_ephemeris_version.end()) ? version->second : 0;
+            std::map<int, unsigned long long>::iterator sent = d_gps_ephemeris_sent.find(it->first);
+            if (sent == d_gps_ephemeris_sent.end() or sent->second != v)
+                {
+                    send(Observables_Stream_Encoder::nav(OBSERVABLES_STREAM_GPS_EPHEMERIS, observables_stream_save(it->second)));
+                    d_gps_ephemeris_sent[it->first] = v;
+                }
+        }
+    for (std::map<int, Galileo_Ephemeris>::const_iterator it = nav->galileo_ephemeris_map.begin(); it != nav->galileo_ephemeris_map.end(); ++it)
+        {
+            std::map<int, unsigned long long>::const_iterator version = nav->galileo_ephemeris_version.find(it->first);
+            const unsigned long long v = (version != nav->galileo_ephemeris_version.end()) ? version->second : 0;
+            std::map<int, unsigned long long>::iterator sent = d_galileo_ephemeris_sent.find(it->first);
+            if (sent == d_galileo_ephemeris_sent.end() or sent->second != v)
+                {
+                    send(Observables_Stream_Encoder::nav(OBSERVABLES_STREAM_GALILEO_EPHEMERIS, observables_stream_save(it->second)));
+                    d_galileo_ephemeris_sent[it->first] = v;
+                }
+        }
+    // the models have no version, they are compared with the last one sent
+    if (nav->gps_iono.valid)
+        {
+            std::string iono = observables_stream_save(nav->gps_iono);
+            if (iono != d_gps_iono_sent)
+                {
+                    send(Observables_Stream_Encoder::nav(OBSERVABLES_STREAM_GPS_IONO, iono));
+                    d_gps_iono_sent.swap(iono);
+                }
+        }
+    if (nav->gps_utc_model.valid)
+        {
+            std::string utc_model = observables_stream_save(nav->gps_utc_model);
+            if (utc_model != d_gps_utc_model_sent)
+                {
+                    send(Observables_Stream_Encoder::nav(OBSERVABLES_STREAM_GPS_UTC_MODEL, utc_model));
+                    d_gps_utc_model_sent.swap(utc_model);
+                }
+        }
+}
+
+
+int observables_stream_sink::work(int noutput_items,
+        gr_vector_const_void_star &input_items, gr_vector_void_star &output_items __attribute__((unused)))
+{
+    GNSS_SDR_TRACE_SCOPE("observables_stream_sink::work");
+    const Gnss_Synchro **in = (const Gnss_Synchro **) &input_items[0];
+    send_navigation_data();
+    for (int i = 0; i < noutput_items; i++)
+        {
+            for (unsigned int c = 0; c < d_nchannels; c++)
+                {
+                    d_epoch[c] = &in[c][i];
+                }
+            d_encoder.add_epoch(d_epoch.data());
+            if (d_encoder.epochs() >= d_batch_epochs)
+                {
+                    send(d_encoder.batch());
+                }
+        }
+    return noutput_items;
+}
@@ -0,0 +1,145 @@
+/*!
+ * \file observables_stream_sink.h
+ * \brief Sends the observables and the navigation data of an edge receiver to a central PVT
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_OBSERVABLES_STREAM_SINK_H_
+#define GNSS_SDR_OBSERVABLES_STREAM_SINK_H_
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <boost/asio.hpp>
+#include <gnuradio/sync_block.h>
+#include "observables_stream.h"
+
+class observables_stream_sink;
+typedef boost::shared_ptr<observables_stream_sink> observables_stream_sink_sptr;
+
+/*!
+ * \brief Makes a sink of \p nchannels streams of Gnss_Synchro that sends
+ * them to \p host : \p port, in batches of \p batch_epochs epochs.
+ */
+observables_stream_sink_sptr make_observables_stream_sink(unsigned int nchannels,
+        const std::string & host, unsigned short port, const std::string & station,
+        unsigned int batch_epochs, bool tracking_outputs,
+        unsigned int max_queued_batches, unsigned int reconnect_period_ms);
+
+/*!
+ * \brief Takes the place of the PVT block in an edge receiver.
+ *
+ * The epochs are encoded by an Observables_Stream_Encoder and sent from a
+ * network thread, which connects to the central receiver when the flowgraph
+ * starts and reconnects after any error. The navigation data of
+ * Gnss_Nav_Data_Store are sent when they change, and all of them again
+ * after each connection. While the link is down or too slow, up to
+ * max_queued_batches batches wait, and the oldest ones are dropped.
+ */
+class observables_stream_sink : public gr::sync_block
+{
+private:
+    friend observables_stream_sink_sptr make_observables_stream_sink(unsigned int nchannels,
+            const std::string & host, unsigned short port, const std::string & station,
+            unsigned int batch_epochs, bool tracking_outputs,
+            unsigned int max_queued_batches, unsigned int reconnect_period_ms);
+
+    observables_stream_sink(unsigned int nchannels,
+            const std::string & host, unsigned short port, const std::string & station,
+            unsigned int batch_epochs, bool tracking_outputs,
+            unsigned int max_queued_batches, unsigned int reconnect_period_ms);
+
+    // Queues the navigation data that changed since the last call
+    void send_navigation_data();
+    void send(std::string frame);
+
+    // Network thread
+    void do_connect();
+    void do_write();
+    void close_and_retry();
+
+    unsigned int d_nchannels;
+    std::string d_host;
+    unsigned short d_port;
+    std::string d_station;
+    unsigned int d_batch_epochs;
+    unsigned int d_max_queued_batches;
+    unsigned int d_reconnect_period_ms;
+
+    Observables_Stream_Encoder d_encoder;
+    std::vector<const Gnss_Synchro*> d_epoch;
+
+    unsigned long long d_nav_version;
+    std::map<int, unsigned long long> d_gps_ephemeris_sent;     // version of each ephemeris sent
+    std::map<int, unsigned long long> d_galileo_ephemeris_sent;
+    std::string d_gps_iono_sent;
+    std::string d_gps_utc_model_sent;
+    std::atomic<bool> d_resend_navigation_data;  // set by each new connection
+
+    // Only used from the network thread
+    boost::asio::io_service d_io_service;
+    std::unique_ptr<boost::asio::io_service::work> d_work;
+    boost::asio::ip::tcp::resolver d_resolver;
+    boost::asio::ip::tcp::socket d_socket;
+    boost::asio::deadline_timer d_retry_timer;
+    std::thread d_thread;
+    bool d_connected;
+    bool d_writing;
+    bool d_stopping;
+    std::deque<std::string> d_queue;
+
+    std::atomic<unsigned long long> d_bytes_sent;
+    std::atomic<unsigned long long> d_dropped_batches;
+
+public:
+    ~observables_stream_sink();
+
+    //! Starts the network thread
+    bool start();
+
+    //! Closes the connection and joins the network thread
+    bool stop();
+
+    unsigned long long bytes_sent() const
+    {
+        return d_bytes_sent.load();
+    }
+
+    //! Batches dropped because the link was down or too slow
+    unsigned long long dropped_batches() const
+    {
+        return d_dropped_batches.load();
+    }
+
+    int work(int noutput_items, gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif
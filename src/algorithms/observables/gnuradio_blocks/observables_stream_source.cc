@@ -0,0 +1,276 @@
+/*!
+ * \file observables_stream_source.cc
+ * \brief Receives the observables and the navigation data of an edge receiver
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "observables_stream_source.h"
+#include "gnss_sdr_trace.h"
+#include <chrono>
+#include <iostream>
+#include <utility>
+#include <vector>
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+
+using google::LogMessage;
+
+//! Longest wait for an epoch in work() [ms]
+#define OBSERVABLES_STREAM_SOURCE_WAIT_MS 100
+
+
+observables_stream_source_sptr make_observables_stream_source(unsigned int nchannels,
+        unsigned short port, const std::string & station)
+{
+    return observables_stream_source_sptr(new observables_stream_source(nchannels, port, station));
+}
+
+
+observables_stream_source::observables_stream_source(unsigned int nchannels,
+        unsigned short port, const std::string & station)
+    : gr::sync_block("observables_stream_source",
+            gr::io_signature::make(0, 0, 0),
+            gr::io_signature::make(nchannels, nchannels, sizeof(Gnss_Synchro))),
+      d_acceptor(d_io_service)
+{
+    d_nchannels = nchannels;
+    d_port = port;
+    d_station = station;
+    d_channels_warned = false;
+    d_bytes_received = 0;
+    d_connections = 0;
+    this->message_port_register_out(pmt::mp("telemetry"));
+}
+
+
+observables_stream_source::~observables_stream_source()
+{
+    stop();
+}
+
+
+bool observables_stream_source::start()
+{
+    if (d_thread.joinable())
+        {
+            return true;
+        }
+    try
+    {
+            boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::tcp::v4(), d_port);
+            d_acceptor.open(endpoint.protocol());
+            d_acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+            d_acceptor.bind(endpoint);
+            d_acceptor.listen();
+            d_port = d_acceptor.local_endpoint().port();
+    }
+    catch (const boost::system::system_error & e)
+    {
+            LOG(ERROR) << "The observables source cannot listen on port " << d_port << ": " << e.what();
+            boost::system::error_code ec;
+            d_acceptor.close(ec);
+            return false;
+    }
+    d_io_service.reset();
+    d_work.reset(new boost::asio::io_service::work(d_io_service));
+    do_accept();
+    d_thread = std::thread([this]() { d_io_service.run(); });
+    std::cout << "Waiting for the observables of "
+              << (d_station.empty() ? std::string("any station") : "station " + d_station)
+              << " on port " << d_port << std::endl;
+    return true;
+}
+
+
+bool observables_stream_source::stop()
+{
+    if (!d_thread.joinable())
+        {
+            return true;
+        }
+    d_io_service.post([this]()
+            {
+        boost::system::error_code ec;
+        d_acceptor.close(ec);
+        if (d_connection)
+            {
+                d_connection->close(ec);
+                d_connection.reset();
+            }
+            });
+    // run() returns once the pending operations have been cancelled
+    d_work.reset();
+    d_thread.join();
+    d_received.notify_all();
+    LOG(INFO) << "Observables source on port " << d_port << ": " << d_connections.load()
+              << " connections, " << d_bytes_received.load() << " bytes received";
+    return true;
+}
+
+
+void observables_stream_source::do_accept()
+{
+    std::shared_ptr<boost::asio::ip::tcp::socket> socket = std::make_shared<boost::asio::ip::tcp::socket>(d_io_service);
+    d_acceptor.async_accept(*socket, [this, socket](boost::system::error_code ec)
+            {
+        if (!d_acceptor.is_open())
+            {
+                return;
+            }
+        if (!ec)
+            {
+                boost::system::error_code ep_ec;
+                LOG(INFO) << "Observables source on port " << d_port << " connected to "
+                          << socket->remote_endpoint(ep_ec).address().to_string();
+                if (d_connection)
+                    {
+                        boost::system::error_code close_ec;
+                        d_connection->close(close_ec);
+                    }
+                d_connection = socket;
+                d_connections++;
+                {
+                    std::lock_guard<std::mutex> lock(d_mutex);
+                    d_decoder.reset();
+                }
+                do_read(socket);
+            }
+        else
+            {
+                LOG(WARNING) << "Error when accepting an edge receiver: " << ec.message();
+            }
+        do_accept();
+            });
+}
+
+
+void observables_stream_source::do_read(std::shared_ptr<boost::asio::ip::tcp::socket> socket)
+{
+    socket->async_read_some(boost::asio::buffer(d_read_buffer, sizeof(d_read_buffer)),
+            [this, socket](boost::system::error_code ec, std::size_t length)
+                    {
+        // a connection replaced by a newer one
+        if (socket != d_connection)
+            {
+                return;
+            }
+        bool drop = false;
+        if (!ec)
+            {
+                d_bytes_received += length;
+                std::lock_guard<std::mutex> lock(d_mutex);
+                d_decoder.push(d_read_buffer, length);
+                if (d_decoder.error())
+                    {
+                        LOG(WARNING) << "Malformed observables stream on port " << d_port << ", closing the connection";
+                        drop = true;
+                    }
+                else if (d_decoder.has_station() and !d_station.empty() and d_decoder.station() != d_station)
+                    {
+                        LOG(WARNING) << "Observables of station " << d_decoder.station() << " on port " << d_port
+                                     << ", where those of " << d_station << " are expected. Closing the connection";
+                        d_decoder.reset();
+                        drop = true;
+                    }
+            }
+        else
+            {
+                LOG(INFO) << "Edge receiver disconnected from port " << d_port << ": " << ec.message();
+                drop = true;
+            }
+        d_received.notify_all();
+        if (drop)
+            {
+                boost::system::error_code close_ec;
+                socket->close(close_ec);
+                d_connection.reset();
+                return;
+            }
+        do_read(socket);
+                    });
+}
+
+
+int observables_stream_source::work(int noutput_items,
+        gr_vector_const_void_star &input_items __attribute__((unused)), gr_vector_void_star &output_items)
+{
+    GNSS_SDR_TRACE_SCOPE("observables_stream_source::work");
+    Gnss_Synchro **out = (Gnss_Synchro **) &output_items[0];
+    std::vector<std::pair<unsigned char, std::string> > records;
+    int produced = 0;
+    {
+        std::unique_lock<std::mutex> lock(d_mutex);
+        if (d_decoder.pending_epochs() == 0)
+            {
+                d_received.wait_for(lock, std::chrono::milliseconds(OBSERVABLES_STREAM_SOURCE_WAIT_MS));
+            }
+        unsigned char record;
+        std::string archive;
+        while (d_decoder.next_nav(record, archive))
+            {
+                records.push_back(std::make_pair(record, archive));
+            }
+        std::vector<Gnss_Synchro> epoch;
+        while (produced < noutput_items and d_decoder.next_epoch(epoch))
+            {
+                if (epoch.size() != d_nchannels and !d_channels_warned)
+                    {
+                        LOG(WARNING) << "Station " << d_decoder.station() << " has " << epoch.size()
+                                     << " channels, and the observables source " << d_nchannels;
+                        d_channels_warned = true;
+                    }
+                for (unsigned int c = 0; c < d_nchannels; c++)
+                    {
+                        if (c < epoch.size())
+                            {
+                                out[c][produced] = epoch[c];
+                            }
+                        else
+                            {
+                                out[c][produced] = Gnss_Synchro();
+                                out[c][produced].Channel_ID = c;
+                            }
+                    }
+                produced++;
+            }
+    }
+
+    // as the telemetry decoders send them
+    for (std::vector<std::pair<unsigned char, std::string> >::const_iterator it = records.begin(); it != records.end(); ++it)
+        {
+            boost::any object;
+            if (observables_stream_load(it->first, it->second, object))
+                {
+                    this->message_port_pub(pmt::mp("telemetry"), pmt::make_any(object));
+                }
+            else
+                {
+                    LOG(WARNING) << "Unknown navigation record " << static_cast<int>(it->first) << " from station " << d_station;
+                }
+        }
+    return produced;
+}
@@ -0,0 +1,121 @@
+/*!
+ * \file observables_stream_source.h
+ * \brief Receives the observables and the navigation data of an edge receiver
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_OBSERVABLES_STREAM_SOURCE_H_
+#define GNSS_SDR_OBSERVABLES_STREAM_SOURCE_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <boost/asio.hpp>
+#include <gnuradio/sync_block.h>
+#include "observables_stream.h"
+
+class observables_stream_source;
+typedef boost::shared_ptr<observables_stream_source> observables_stream_source_sptr;
+
+/*!
+ * \brief Makes a source of \p nchannels streams of Gnss_Synchro received on
+ * \p port from the edge receiver of \p station (any station if empty).
+ */
+observables_stream_source_sptr make_observables_stream_source(unsigned int nchannels,
+        unsigned short port, const std::string & station);
+
+/*!
+ * \brief Takes the place of the observables block in a central receiver,
+ * which has no signal source nor channels.
+ *
+ * A network thread accepts the connection of the edge receiver and decodes
+ * its stream with an Observables_Stream_Decoder. A new connection replaces
+ * the current one, since an edge receiver reconnects after an error that the
+ * server may not have noticed. Each epoch is output on the streams of the
+ * channels of the station, and the navigation records are published on the
+ * "telemetry" port as the telemetry decoders would, for the PVT block.
+ * While no epoch is received, nothing is output.
+ */
+class observables_stream_source : public gr::sync_block
+{
+private:
+    friend observables_stream_source_sptr make_observables_stream_source(unsigned int nchannels,
+            unsigned short port, const std::string & station);
+
+    observables_stream_source(unsigned int nchannels, unsigned short port, const std::string & station);
+
+    // Network thread
+    void do_accept();
+    void do_read(std::shared_ptr<boost::asio::ip::tcp::socket> socket);
+
+    unsigned int d_nchannels;
+    unsigned short d_port;
+    std::string d_station;
+
+    boost::asio::io_service d_io_service;
+    std::unique_ptr<boost::asio::io_service::work> d_work;
+    boost::asio::ip::tcp::acceptor d_acceptor;
+    std::shared_ptr<boost::asio::ip::tcp::socket> d_connection;  // the one being read
+    std::thread d_thread;
+    char d_read_buffer[65536];
+
+    std::mutex d_mutex;                  // guards the decoder
+    std::condition_variable d_received;
+    Observables_Stream_Decoder d_decoder;
+    bool d_channels_warned;
+
+    std::atomic<unsigned long long> d_bytes_received;
+    std::atomic<unsigned long long> d_connections;
+
+public:
+    ~observables_stream_source();
+
+    //! Starts listening on the port
+    bool start();
+
+    //! Closes the connection and joins the network thread
+    bool stop();
+
+    //! Port the source is listening on, once started
+    unsigned short port() const
+    {
+        return d_port;
+    }
+
+    unsigned long long bytes_received() const
+    {
+        return d_bytes_received.load();
+    }
+
+    int work(int noutput_items, gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif
@@ -0,0 +1,203 @@
+/*!
+ * \file rinex_observables_source.cc
+ * \brief Replay of the observables of RINEX 3 files into the PVT block
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "rinex_observables_source.h"
+#include <iostream>
+#include <boost/lexical_cast.hpp>
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+#include "control_event_bus.h"
+#include "gnss_nav_data_store.h"
+#include "gnss_sdr_trace.h"
+
+using google::LogMessage;
+
+//! Navigation records given before the epochs [s], the ephemeris are broadcast up to two hours before their Toc
+#define RINEX_OBSERVABLES_SOURCE_NAV_LEAD_S 7200.0
+
+namespace
+{
+std::string signal_key(const Gnss_Synchro & observation)
+{
+    return std::string(1, observation.System) + observation.Signal + boost::lexical_cast<std::string>(observation.PRN);
+}
+}
+
+
+rinex_observables_source_sptr make_rinex_observables_source(unsigned int nchannels,
+        const std::string & obs_file, const std::vector<std::string> & nav_files,
+        gr::msg_queue::sptr queue)
+{
+    return rinex_observables_source_sptr(new rinex_observables_source(nchannels, obs_file, nav_files, queue));
+}
+
+
+rinex_observables_source::rinex_observables_source(unsigned int nchannels, const std::string & obs_file,
+        const std::vector<std::string> & nav_files, gr::msg_queue::sptr queue)
+    : gr::sync_block("rinex_observables_source",
+            gr::io_signature::make(0, 0, 0),
+            gr::io_signature::make(nchannels, nchannels, sizeof(Gnss_Synchro)))
+{
+    d_nchannels = nchannels;
+    d_obs_file = obs_file;
+    d_nav_files = nav_files;
+    d_queue = queue;
+    d_opened = false;
+    d_done = false;
+    d_dropped = 0;
+    d_first_epoch_s = 0.0;
+    d_last_epoch_s = 0.0;
+    // connected to the PVT as the port of Observables_Stream_Source, nothing is published on it
+    this->message_port_register_out(pmt::mp("telemetry"));
+}
+
+
+rinex_observables_source::~rinex_observables_source()
+{}
+
+
+bool rinex_observables_source::start()
+{
+    if (d_opened)
+        {
+            return true;
+        }
+    for (std::vector<std::string>::const_iterator it = d_nav_files.begin(); it != d_nav_files.end(); ++it)
+        {
+            if (!d_reader.read_navigation(*it))
+                {
+                    LOG(ERROR) << "RINEX replay: " << d_reader.error();
+                    std::cout << "RINEX replay: " << d_reader.error() << std::endl;
+                    return false;
+                }
+        }
+    if (!d_reader.open_observations(d_obs_file))
+        {
+            LOG(ERROR) << "RINEX replay: " << d_reader.error();
+            std::cout << "RINEX replay: " << d_reader.error() << std::endl;
+            return false;
+        }
+    d_opened = true;
+    d_start = std::chrono::steady_clock::now();
+    LOG(INFO) << "RINEX replay of " << d_obs_file << ", " << d_reader.pending_navigation() << " navigation records";
+    return true;
+}
+
+
+int rinex_observables_source::work(int noutput_items,
+        gr_vector_const_void_star &input_items __attribute__((unused)), gr_vector_void_star &output_items)
+{
+    GNSS_SDR_TRACE_SCOPE("rinex_observables_source::work");
+    if (!d_opened || d_done)
+        {
+            return -1;
+        }
+    Gnss_Synchro **out = (Gnss_Synchro **) &output_items[0];
+    int produced = 0;
+    Rinex_Epoch epoch;
+    while (produced < noutput_items && d_reader.next_epoch(epoch))
+        {
+            boost::any record;
+            while (d_reader.next_navigation(epoch.gps_time_s + RINEX_OBSERVABLES_SOURCE_NAV_LEAD_S, record))
+                {
+                    Gnss_Nav_Data_Store::instance().update(record);
+                }
+            if (d_reader.epochs() == 1) d_first_epoch_s = epoch.gps_time_s;
+            d_last_epoch_s = epoch.gps_time_s;
+
+            for (unsigned int c = 0; c < d_nchannels; c++)
+                {
+                    out[c][produced] = Gnss_Synchro();
+                    out[c][produced].Channel_ID = c;
+                }
+            // the signals of the last epoch keep their channels, the new ones take the free ones
+            std::map<std::string, unsigned int> channels;
+            std::vector<bool> used(d_nchannels, false);
+            std::vector<int> assigned(epoch.observations.size(), -1);
+            for (unsigned int i = 0; i < epoch.observations.size(); i++)
+                {
+                    const std::string key = signal_key(epoch.observations[i]);
+                    std::map<std::string, unsigned int>::const_iterator previous = d_channels.find(key);
+                    if (previous != d_channels.end())
+                        {
+                            assigned[i] = previous->second;
+                            used[previous->second] = true;
+                            channels[key] = previous->second;
+                        }
+                }
+            unsigned int free_channel = 0;
+            for (unsigned int i = 0; i < epoch.observations.size(); i++)
+                {
+                    if (assigned[i] >= 0) continue;
+                    while (free_channel < d_nchannels && used[free_channel]) free_channel++;
+                    if (free_channel == d_nchannels)
+                        {
+                            d_dropped++;
+                            continue;
+                        }
+                    assigned[i] = free_channel;
+                    used[free_channel] = true;
+                    channels[signal_key(epoch.observations[i])] = free_channel;
+                }
+            d_channels.swap(channels);
+            for (unsigned int i = 0; i < epoch.observations.size(); i++)
+                {
+                    if (assigned[i] < 0) continue;
+                    out[assigned[i]][produced] = epoch.observations[i];
+                    out[assigned[i]][produced].Channel_ID = assigned[i];
+                }
+            produced++;
+        }
+    if (produced > 0)
+        {
+            return produced;
+        }
+
+    // end of the replay
+    d_done = true;
+    if (!d_reader.error().empty())
+        {
+            LOG(WARNING) << "RINEX replay of " << d_obs_file << " stopped: " << d_reader.error();
+        }
+    const double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - d_start).count();
+    const double observed_s = d_last_epoch_s - d_first_epoch_s;
+    std::cout << "RINEX replay: " << d_reader.epochs() << " epochs, " << observed_s << " s of observations in "
+              << elapsed_s << " s";
+    if (elapsed_s > 0.0) std::cout << ", " << observed_s / elapsed_s << " times faster than real time";
+    std::cout << std::endl;
+    LOG(INFO) << "RINEX replay: " << d_reader.epochs() << " epochs in " << elapsed_s << " s, "
+              << d_dropped << " observations without a free channel";
+    if (d_dropped > 0)
+        {
+            LOG(WARNING) << "RINEX replay: " << d_dropped << " observations dropped, more channels are needed";
+        }
+    Control_Event_Bus::send(d_queue, Control_Event_Bus::receiver, Control_Event_Bus::stop);
+    return -1;
+}
@@ -0,0 +1,102 @@
+/*!
+ * \file rinex_observables_source.h
+ * \brief Replay of the observables of RINEX 3 files into the PVT block
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_RINEX_OBSERVABLES_SOURCE_H_
+#define GNSS_SDR_RINEX_OBSERVABLES_SOURCE_H_
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+#include <gnuradio/msg_queue.h>
+#include <gnuradio/sync_block.h>
+#include "rinex_observables_reader.h"
+
+class rinex_observables_source;
+typedef boost::shared_ptr<rinex_observables_source> rinex_observables_source_sptr;
+
+/*!
+ * \brief Makes a source of \p nchannels streams of Gnss_Synchro read from
+ * the RINEX 3 observation file \p obs_file, with the ephemeris of the
+ * navigation files \p nav_files.
+ */
+rinex_observables_source_sptr make_rinex_observables_source(unsigned int nchannels,
+        const std::string & obs_file, const std::vector<std::string> & nav_files,
+        gr::msg_queue::sptr queue);
+
+/*!
+ * \brief Takes the place of the observables block in a receiver that runs
+ * the back end alone, as the Observables_Stream_Source of a central
+ * receiver does, on observables recorded in RINEX files.
+ *
+ * Each epoch is output on the streams of the channels, as fast as the PVT
+ * takes them. A signal keeps its channel while it is observed, and
+ * channels without a signal output an invalid pseudorange. Before each
+ * epoch, the navigation records up to two hours after it are given to
+ * Gnss_Nav_Data_Store, as the telemetry decoders would have decoded them
+ * by then; the store is updated here, not from the "telemetry" port, so
+ * that the PVT has them for that epoch. At the end of the observation file
+ * the receiver is stopped.
+ */
+class rinex_observables_source : public gr::sync_block
+{
+private:
+    friend rinex_observables_source_sptr make_rinex_observables_source(unsigned int nchannels,
+            const std::string & obs_file, const std::vector<std::string> & nav_files,
+            gr::msg_queue::sptr queue);
+
+    rinex_observables_source(unsigned int nchannels, const std::string & obs_file,
+            const std::vector<std::string> & nav_files, gr::msg_queue::sptr queue);
+
+    unsigned int d_nchannels;
+    std::string d_obs_file;
+    std::vector<std::string> d_nav_files;
+    gr::msg_queue::sptr d_queue;
+
+    Rinex_Observables_Reader d_reader;
+    bool d_opened;
+    bool d_done;
+    std::map<std::string, unsigned int> d_channels;  // channel of the signals of the last epoch
+    unsigned long long d_dropped;  // observations with no free channel
+    double d_first_epoch_s;
+    double d_last_epoch_s;
+    std::chrono::steady_clock::time_point d_start;
+
+public:
+    ~rinex_observables_source();
+
+    //! Opens the files, false if one cannot be read
+    bool start();
+
+    int work(int noutput_items, gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif
@@ -0,0 +1,569 @@
+/*!
+ * \file observables_stream.cc
+ * \brief Compact binary stream of observables, from the edge receivers to a central PVT
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "observables_stream.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+
+namespace
+{
+const char MAGIC[2] = {'G', 'S'};
+const std::size_t HEADER_BYTES = 7;
+
+// Quantized fields, with their scale (units per unit of the field)
+enum Field
+{
+    PSEUDORANGE, CARRIER_PHASE, DOPPLER, CN0, TOW, TOW_HYBRID,
+    TRACKING_TIMESTAMP, PRN_TIMESTAMP, CODE_PHASE, FIELDS
+};
+const double SCALE[FIELDS] = {1e4, 1e4, 1e3, 1e2, 1e9, 1e9, 1e9, 1e6, 1e12};
+double Gnss_Synchro::* const MEMBER[FIELDS] = {
+        &Gnss_Synchro::Pseudorange_m, &Gnss_Synchro::Carrier_phase_rads,
+        &Gnss_Synchro::Carrier_Doppler_hz, &Gnss_Synchro::CN0_dB_hz,
+        &Gnss_Synchro::d_TOW_at_current_symbol, &Gnss_Synchro::d_TOW_hybrid_at_current_symbol,
+        &Gnss_Synchro::Tracking_timestamp_secs, &Gnss_Synchro::Prn_timestamp_ms,
+        &Gnss_Synchro::Code_phase_secs};
+
+// Flags of a channel record
+const unsigned char VALID_SYMBOL_OUTPUT = 0x01;
+const unsigned char VALID_WORD = 0x02;
+const unsigned char PREAMBLE = 0x04;
+const unsigned char VALID_PSEUDORANGE = 0x08;
+const unsigned char VALID_ACQUISITION = 0x10;
+const unsigned char IDENTITY = 0x20;
+const unsigned char HAS_VALUES = VALID_SYMBOL_OUTPUT | VALID_PSEUDORANGE;
+
+
+std::int64_t quantize(double value, double scale)
+{
+    const double q = std::round(value * scale);
+    if (!(std::fabs(q) < 9.0e18)) // NaN too
+        {
+            return std::isnan(q) ? 0 : (q > 0 ? INT64_C(9000000000000000000) : -INT64_C(9000000000000000000));
+        }
+    return static_cast<std::int64_t>(q);
+}
+
+
+void put_varint(std::string & out, std::uint64_t value)
+{
+    while (value >= 0x80)
+        {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+    out.push_back(static_cast<char>(value));
+}
+
+
+void put_signed(std::string & out, std::int64_t value)
+{
+    put_varint(out, (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+}
+
+
+void put_float(std::string & out, double value)
+{
+    const float f = static_cast<float>(value);
+    std::uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    for (int k = 0; k < 4; k++)
+        {
+            out.push_back(static_cast<char>((bits >> (8 * k)) & 0xFF));
+        }
+}
+
+
+// Reads the payload of a frame, failing at its end
+class Reader
+{
+public:
+    explicit Reader(const std::string & data) : d_data(data), d_pos(0), d_ok(true) {}
+
+    unsigned char byte()
+    {
+        if (d_pos >= d_data.size())
+            {
+                d_ok = false;
+                return 0;
+            }
+        return static_cast<unsigned char>(d_data[d_pos++]);
+    }
+
+    std::uint64_t varint()
+    {
+        std::uint64_t value = 0;
+        for (unsigned int shift = 0; shift < 64; shift += 7)
+            {
+                const unsigned char b = byte();
+                value |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+                if (!(b & 0x80)) return value;
+            }
+        d_ok = false;
+        return 0;
+    }
+
+    std::int64_t signed_varint()
+    {
+        const std::uint64_t v = varint();
+        return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+    }
+
+    double float_value()
+    {
+        std::uint32_t bits = 0;
+        for (int k = 0; k < 4; k++)
+            {
+                bits |= static_cast<std::uint32_t>(byte()) << (8 * k);
+            }
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    std::string rest()
+    {
+        std::string r = d_data.substr(std::min(d_pos, d_data.size()));
+        d_pos = d_data.size();
+        return r;
+    }
+
+    bool ok() const
+    {
+        return d_ok;
+    }
+
+private:
+    const std::string & d_data;
+    std::size_t d_pos;
+    bool d_ok;
+};
+
+
+std::string frame(unsigned char type, const std::string & payload)
+{
+    std::string out;
+    out.reserve(HEADER_BYTES + payload.size());
+    out.append(MAGIC, 2);
+    out.push_back(static_cast<char>(type));
+    const std::uint32_t length = payload.size();
+    for (int k = 0; k < 4; k++)
+        {
+            out.push_back(static_cast<char>((length >> (8 * k)) & 0xFF));
+        }
+    out.append(payload);
+    return out;
+}
+
+
+bool same_identity(const Gnss_Synchro & a, const Gnss_Synchro & b)
+{
+    return a.System == b.System and a.Signal[0] == b.Signal[0] and a.Signal[1] == b.Signal[1]
+            and a.PRN == b.PRN and a.Channel_ID == b.Channel_ID
+            and a.correlation_length_ms == b.correlation_length_ms;
+}
+
+
+// Value of field k from the last two records of a channel
+std::int64_t predict(const std::int64_t* ref, unsigned int history, unsigned int k)
+{
+    if (history == 0) return 0;
+    if (history == 1) return ref[2 * k];
+    return 2 * ref[2 * k] - ref[2 * k + 1];
+}
+
+
+void remember(std::int64_t* ref, unsigned int k, std::int64_t value)
+{
+    ref[2 * k + 1] = ref[2 * k];
+    ref[2 * k] = value;
+}
+
+
+template<class T>
+std::string save(const T & object)
+{
+    std::ostringstream os;
+    {
+        boost::archive::text_oarchive archive(os);
+        archive << object;
+    }
+    return os.str();
+}
+
+
+template<class T>
+bool load(const std::string & text, boost::any & object)
+{
+    try
+    {
+            std::shared_ptr<T> record = std::make_shared<T>();
+            std::istringstream is(text);
+            boost::archive::text_iarchive archive(is);
+            archive >> *record;
+            object = record;
+    }
+    catch (std::exception & e)
+    {
+            return false;
+    }
+    return true;
+}
+}
+
+
+Observables_Stream_Encoder::Observables_Stream_Encoder(unsigned int channels, bool tracking_outputs)
+{
+    d_channels = channels;
+    d_tracking_outputs = tracking_outputs;
+    d_epochs = 0;
+    Gnss_Synchro empty = Gnss_Synchro();
+    d_last.assign(channels, empty);
+    d_ref.assign(static_cast<std::size_t>(channels) * 2 * FIELDS, 0);
+    d_history.assign(channels, 0);
+}
+
+
+std::string Observables_Stream_Encoder::hello(const std::string & station) const
+{
+    std::string payload;
+    payload.push_back(static_cast<char>(OBSERVABLES_STREAM_VERSION));
+    put_varint(payload, d_channels);
+    payload.push_back(static_cast<char>(d_tracking_outputs ? OBSERVABLES_STREAM_TRACKING_OUTPUTS : 0));
+    payload.append(station);
+    return frame(OBSERVABLES_STREAM_HELLO, payload);
+}
+
+
+void Observables_Stream_Encoder::add_epoch(const Gnss_Synchro* const* in)
+{
+    const unsigned int fields = d_tracking_outputs ? FIELDS : CODE_PHASE;
+    for (unsigned int c = 0; c < d_channels; c++)
+        {
+            const Gnss_Synchro & s = *in[c];
+            unsigned char flags = 0;
+            if (s.Flag_valid_symbol_output) flags |= VALID_SYMBOL_OUTPUT;
+            if (s.Flag_valid_word) flags |= VALID_WORD;
+            if (s.Flag_preamble) flags |= PREAMBLE;
+            if (s.Flag_valid_pseudorange) flags |= VALID_PSEUDORANGE;
+            if (s.Flag_valid_acquisition) flags |= VALID_ACQUISITION;
+            // the first epoch of the batch carries the identity of every channel
+            if (d_epochs == 0 or !same_identity(s, d_last[c]))
+                {
+                    flags |= IDENTITY;
+                    d_history[c] = 0;
+                }
+            d_payload.push_back(static_cast<char>(flags));
+            if (flags & IDENTITY)
+                {
+                    d_payload.push_back(s.System);
+                    d_payload.append(s.Signal, 2);
+                    put_varint(d_payload, s.PRN);
+                    put_signed(d_payload, s.Channel_ID);
+                    put_signed(d_payload, s.correlation_length_ms);
+                    d_last[c] = s;
+                }
+            if (!(flags & HAS_VALUES))
+                {
+                    d_history[c] = 0;
+                    continue;
+                }
+            std::int64_t* ref = &d_ref[static_cast<std::size_t>(c) * 2 * FIELDS];
+            for (unsigned int k = 0; k < fields; k++)
+                {
+                    const std::int64_t q = quantize(s.*MEMBER[k], SCALE[k]);
+                    put_signed(d_payload, q - predict(ref, d_history[c], k));
+                    remember(ref, k, q);
+                }
+            if (d_tracking_outputs)
+                {
+                    put_float(d_payload, s.Prompt_I);
+                    put_float(d_payload, s.Prompt_Q);
+                }
+            if (d_history[c] < 2) d_history[c]++;
+        }
+    d_epochs++;
+}
+
+
+std::string Observables_Stream_Encoder::batch()
+{
+    std::string payload;
+    put_varint(payload, d_channels);
+    put_varint(payload, d_epochs);
+    payload.append(d_payload);
+    d_payload.clear();
+    d_epochs = 0;
+    std::fill(d_history.begin(), d_history.end(), 0);
+    return frame(OBSERVABLES_STREAM_EPOCHS, payload);
+}
+
+
+std::string Observables_Stream_Encoder::nav(unsigned char record, const std::string & archive)
+{
+    std::string payload(1, static_cast<char>(record));
+    payload.append(archive);
+    return frame(OBSERVABLES_STREAM_NAV, payload);
+}
+
+
+Observables_Stream_Decoder::Observables_Stream_Decoder()
+{
+    reset();
+}
+
+
+void Observables_Stream_Decoder::reset()
+{
+    d_buffer.clear();
+    d_error = false;
+    d_has_station = false;
+    d_station.clear();
+    d_channels = 0;
+    d_tracking_outputs = false;
+    d_last.clear();
+    d_ref.clear();
+    d_history.clear();
+    d_epochs.clear();
+    d_nav.clear();
+}
+
+
+void Observables_Stream_Decoder::push(const char* data, std::size_t size)
+{
+    if (d_error) return;
+    d_buffer.append(data, size);
+    std::size_t pos = 0;
+    while (d_buffer.size() - pos >= HEADER_BYTES)
+        {
+            const char* header = d_buffer.data() + pos;
+            if (header[0] != MAGIC[0] or header[1] != MAGIC[1])
+                {
+                    d_error = true;
+                    break;
+                }
+            std::uint32_t length = 0;
+            for (int k = 0; k < 4; k++)
+                {
+                    length |= static_cast<std::uint32_t>(static_cast<unsigned char>(header[3 + k])) << (8 * k);
+                }
+            if (length > OBSERVABLES_STREAM_MAX_PAYLOAD)
+                {
+                    d_error = true;
+                    break;
+                }
+            if (d_buffer.size() - pos < HEADER_BYTES + length) break;
+            if (!decode_frame(static_cast<unsigned char>(header[2]), d_buffer.substr(pos + HEADER_BYTES, length)))
+                {
+                    d_error = true;
+                    break;
+                }
+            pos += HEADER_BYTES + length;
+        }
+    if (d_error)
+        {
+            d_buffer.clear();
+            return;
+        }
+    d_buffer.erase(0, pos);
+}
+
+
+bool Observables_Stream_Decoder::decode_frame(unsigned char type, const std::string & payload)
+{
+    Reader reader(payload);
+    switch (type)
+    {
+    case OBSERVABLES_STREAM_HELLO:
+        {
+            if (reader.byte() != OBSERVABLES_STREAM_VERSION) return false;
+            const std::uint64_t channels = reader.varint();
+            const unsigned char options = reader.byte();
+            if (!reader.ok() or channels > 0xFFFF) return false;
+            d_channels = channels;
+            d_tracking_outputs = options & OBSERVABLES_STREAM_TRACKING_OUTPUTS;
+            d_station = reader.rest();
+            d_has_station = true;
+            return true;
+        }
+    case OBSERVABLES_STREAM_EPOCHS:
+        return decode_epochs(payload);
+    case OBSERVABLES_STREAM_NAV:
+        {
+            const unsigned char record = reader.byte();
+            if (!reader.ok()) return false;
+            d_nav.push_back(std::make_pair(record, reader.rest()));
+            return true;
+        }
+    default:
+        // frames of later versions of the protocol
+        return true;
+    }
+}
+
+
+bool Observables_Stream_Decoder::decode_epochs(const std::string & payload)
+{
+    Reader reader(payload);
+    const std::uint64_t channels = reader.varint();
+    const std::uint64_t epochs = reader.varint();
+    if (!reader.ok() or channels > 0xFFFF) return false;
+    if (channels != d_last.size())
+        {
+            Gnss_Synchro empty = Gnss_Synchro();
+            d_last.assign(channels, empty);
+            d_ref.assign(channels * 2 * FIELDS, 0);
+            d_history.assign(channels, 0);
+        }
+    d_channels = channels;
+    std::fill(d_history.begin(), d_history.end(), 0);
+
+    const unsigned int fields = d_tracking_outputs ? FIELDS : CODE_PHASE;
+    for (std::uint64_t e = 0; e < epochs; e++)
+        {
+            std::vector<Gnss_Synchro> epoch(channels);
+            for (unsigned int c = 0; c < channels; c++)
+                {
+                    const unsigned char flags = reader.byte();
+                    if (flags & IDENTITY)
+                        {
+                            Gnss_Synchro & last = d_last[c];
+                            last.System = static_cast<char>(reader.byte());
+                            last.Signal[0] = static_cast<char>(reader.byte());
+                            last.Signal[1] = static_cast<char>(reader.byte());
+                            last.Signal[2] = '\0';
+                            last.PRN = reader.varint();
+                            last.Channel_ID = reader.signed_varint();
+                            last.correlation_length_ms = reader.signed_varint();
+                            d_history[c] = 0;
+                        }
+                    if (!reader.ok()) return false;
+                    Gnss_Synchro & s = epoch[c];
+                    s = Gnss_Synchro();
+                    s.System = d_last[c].System;
+                    std::memcpy(s.Signal, d_last[c].Signal, sizeof(s.Signal));
+                    s.PRN = d_last[c].PRN;
+                    s.Channel_ID = d_last[c].Channel_ID;
+                    s.correlation_length_ms = d_last[c].correlation_length_ms;
+                    s.Flag_valid_symbol_output = flags & VALID_SYMBOL_OUTPUT;
+                    s.Flag_valid_word = flags & VALID_WORD;
+                    s.Flag_preamble = flags & PREAMBLE;
+                    s.Flag_valid_pseudorange = flags & VALID_PSEUDORANGE;
+                    s.Flag_valid_acquisition = flags & VALID_ACQUISITION;
+                    if (!(flags & HAS_VALUES))
+                        {
+                            d_history[c] = 0;
+                            continue;
+                        }
+                    std::int64_t* ref = &d_ref[static_cast<std::size_t>(c) * 2 * FIELDS];
+                    for (unsigned int k = 0; k < fields; k++)
+                        {
+                            const std::int64_t q = predict(ref, d_history[c], k) + reader.signed_varint();
+                            remember(ref, k, q);
+                            s.*MEMBER[k] = static_cast<double>(q) / SCALE[k];
+                        }
+                    if (d_tracking_outputs)
+                        {
+                            s.Prompt_I = reader.float_value();
+                            s.Prompt_Q = reader.float_value();
+                        }
+                    if (d_history[c] < 2) d_history[c]++;
+                }
+            if (!reader.ok()) return false;
+            d_epochs.push_back(epoch);
+        }
+    return true;
+}
+
+
+bool Observables_Stream_Decoder::next_epoch(std::vector<Gnss_Synchro> & epoch)
+{
+    if (d_epochs.empty()) return false;
+    epoch.swap(d_epochs.front());
+    d_epochs.pop_front();
+    return true;
+}
+
+
+bool Observables_Stream_Decoder::next_nav(unsigned char & record, std::string & archive)
+{
+    if (d_nav.empty()) return false;
+    record = d_nav.front().first;
+    archive.swap(d_nav.front().second);
+    d_nav.pop_front();
+    return true;
+}
+
+
+std::string observables_stream_save(const Gps_Ephemeris & ephemeris)
+{
+    return save(ephemeris);
+}
+
+
+std::string observables_stream_save(const Gps_Iono & iono)
+{
+    return save(iono);
+}
+
+
+std::string observables_stream_save(const Gps_Utc_Model & utc_model)
+{
+    return save(utc_model);
+}
+
+
+std::string observables_stream_save(const Galileo_Ephemeris & ephemeris)
+{
+    return save(ephemeris);
+}
+
+
+bool observables_stream_load(unsigned char record, const std::string & archive, boost::any & object)
+{
+    switch (record)
+    {
+    case OBSERVABLES_STREAM_GPS_EPHEMERIS:
+        return load<Gps_Ephemeris>(archive, object);
+    case OBSERVABLES_STREAM_GPS_IONO:
+        return load<Gps_Iono>(archive, object);
+    case OBSERVABLES_STREAM_GPS_UTC_MODEL:
+        return load<Gps_Utc_Model>(archive, object);
+    case OBSERVABLES_STREAM_GALILEO_EPHEMERIS:
+        return load<Galileo_Ephemeris>(archive, object);
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,233 @@
+/*!
+ * \file observables_stream.h
+ * \brief Compact binary stream of observables, from the edge receivers to a central PVT
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * An edge receiver runs the signal conditioning, acquisition, tracking,
+ * telemetry decoding and observables, and sends the observables of each
+ * epoch and its navigation data to a central receiver, which runs the PVT,
+ * RINEX and RTCM outputs of all the stations.
+ *
+ * The stream is a sequence of frames:
+ *
+ * | magic "GS" | type (1 byte) | payload length (4 bytes, little endian) | payload |
+ *
+ * - HELLO: protocol version (1 byte), channels (varint), options (1 byte),
+ *   station name (the rest of the payload). First frame of each connection.
+ * - EPOCHS: a batch of epochs, see Observables_Stream_Encoder.
+ * - NAV: record type (1 byte) and a boost text archive of the record.
+ *
+ * The integers are unsigned LEB128 varints, the signed ones zigzag encoded
+ * first, so that the stream does not depend on the byte order of the hosts.
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_OBSERVABLES_STREAM_H_
+#define GNSS_SDR_OBSERVABLES_STREAM_H_
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include <boost/any.hpp>
+#include "gnss_synchro.h"
+#include "gps_ephemeris.h"
+#include "gps_iono.h"
+#include "gps_utc_model.h"
+#include "galileo_ephemeris.h"
+
+#define OBSERVABLES_STREAM_VERSION 1
+
+//! Frames of the stream
+enum Observables_Stream_Frame
+{
+    OBSERVABLES_STREAM_HELLO = 1,
+    OBSERVABLES_STREAM_EPOCHS = 2,
+    OBSERVABLES_STREAM_NAV = 3
+};
+
+//! Navigation data records, those saved by Gnss_Receiver_State
+enum Observables_Stream_Nav_Record
+{
+    OBSERVABLES_STREAM_GPS_EPHEMERIS = 1,
+    OBSERVABLES_STREAM_GPS_IONO = 2,
+    OBSERVABLES_STREAM_GPS_UTC_MODEL = 3,
+    OBSERVABLES_STREAM_GALILEO_EPHEMERIS = 4
+};
+
+//! HELLO option: the epochs carry the prompt correlator outputs and the code phase
+#define OBSERVABLES_STREAM_TRACKING_OUTPUTS 0x01
+
+//! Largest payload accepted by the decoder [bytes]
+#define OBSERVABLES_STREAM_MAX_PAYLOAD (16 * 1024 * 1024)
+
+
+/*!
+ * \brief Encodes the epochs of a set of channels into EPOCHS frames.
+ *
+ * Each channel record starts with a byte of flags. The channels without a
+ * valid pseudorange nor a valid symbol output carry nothing else. The other
+ * ones carry their measurements quantized to integers:
+ *
+ * - Pseudorange_m: 0.1 mm
+ * - Carrier_phase_rads: 0.1 mrad
+ * - Carrier_Doppler_hz: 1 mHz
+ * - CN0_dB_hz: 0.01 dB
+ * - d_TOW_at_current_symbol, d_TOW_hybrid_at_current_symbol,
+ *   Tracking_timestamp_secs and Prn_timestamp_ms: 1 ns
+ * - Code_phase_secs: 1 ps, with the tracking outputs
+ *
+ * and Prompt_I and Prompt_Q as floats, with the tracking outputs. Each
+ * integer is the difference with its prediction from the last two records
+ * of the channel (a constant rate), or from the last one, so that smooth
+ * measurements take one or two bytes. The first record of each channel in a
+ * batch is absolute: a batch is decoded on its own and the sink may drop
+ * batches when the link is too slow. The satellite, signal, channel and
+ * correlation length are sent when they change and at the start of a batch.
+ * The acquisition fields, d_TOW and the sample stamp are not sent.
+ */
+class Observables_Stream_Encoder
+{
+public:
+    Observables_Stream_Encoder(unsigned int channels, bool tracking_outputs);
+
+    //! HELLO frame of a station
+    std::string hello(const std::string & station) const;
+
+    //! Adds the epoch of all the channels, in[i] being the item of channel i
+    void add_epoch(const Gnss_Synchro* const* in);
+
+    //! Epochs in the current batch
+    unsigned int epochs() const
+    {
+        return d_epochs;
+    }
+
+    //! EPOCHS frame of the current batch, which is cleared
+    std::string batch();
+
+    //! NAV frame of a record serialized by observables_stream_save()
+    static std::string nav(unsigned char record, const std::string & archive);
+
+private:
+    unsigned int d_channels;
+    bool d_tracking_outputs;
+    unsigned int d_epochs;
+    std::string d_payload;
+    std::vector<Gnss_Synchro> d_last;     // last record of each channel
+    std::vector<std::int64_t> d_ref;      // quantized values of the last two records
+    std::vector<unsigned int> d_history;  // records of the channel in the batch, up to 2
+};
+
+
+/*!
+ * \brief Decodes a stream of frames, received in pieces of any size.
+ *
+ * The epochs and the navigation records are queued until they are taken.
+ * A malformed stream (bad magic, unknown version, payload too long or
+ * truncated) sets error() and the rest of it is ignored.
+ */
+class Observables_Stream_Decoder
+{
+public:
+    Observables_Stream_Decoder();
+
+    //! Decodes the frames completed by \p size more bytes of the stream
+    void push(const char* data, std::size_t size);
+
+    //! Takes the oldest decoded epoch, one item per channel of the station
+    bool next_epoch(std::vector<Gnss_Synchro> & epoch);
+
+    //! Takes the oldest navigation record
+    bool next_nav(unsigned char & record, std::string & archive);
+
+    //! Decoded epochs not taken yet
+    std::size_t pending_epochs() const
+    {
+        return d_epochs.size();
+    }
+
+    //! A HELLO frame has been received
+    bool has_station() const
+    {
+        return d_has_station;
+    }
+
+    const std::string & station() const
+    {
+        return d_station;
+    }
+
+    unsigned int channels() const
+    {
+        return d_channels;
+    }
+
+    bool tracking_outputs() const
+    {
+        return d_tracking_outputs;
+    }
+
+    bool error() const
+    {
+        return d_error;
+    }
+
+    //! Forgets the state of the stream, e.g., for a new connection
+    void reset();
+
+private:
+    bool decode_frame(unsigned char type, const std::string & payload);
+    bool decode_epochs(const std::string & payload);
+
+    std::string d_buffer;        // bytes of the incomplete frame
+    bool d_error;
+    bool d_has_station;
+    std::string d_station;
+    unsigned int d_channels;
+    bool d_tracking_outputs;
+    std::vector<Gnss_Synchro> d_last;
+    std::vector<std::int64_t> d_ref;
+    std::vector<unsigned int> d_history;
+    std::deque<std::vector<Gnss_Synchro> > d_epochs;
+    std::deque<std::pair<unsigned char, std::string> > d_nav;
+};
+
+
+// Navigation records of the NAV frames. The text archives do not depend on
+// the byte order or the word size of the hosts.
+std::string observables_stream_save(const Gps_Ephemeris & ephemeris);
+std::string observables_stream_save(const Gps_Iono & iono);
+std::string observables_stream_save(const Gps_Utc_Model & utc_model);
+std::string observables_stream_save(const Galileo_Ephemeris & ephemeris);
+
+/*!
+ * \brief Loads a navigation record into \p object, as a std::shared_ptr to
+ * the record type, the way the telemetry messages carry it. Returns false
+ * for an unknown record type or a malformed archive.
+ */
+bool observables_stream_load(unsigned char record, const std::string & archive, boost::any & object);
+
+#endif
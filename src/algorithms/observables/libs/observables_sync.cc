@@ -0,0 +1,362 @@
+/*!
+ * \file observables_sync.cc
+ * \brief Common reception time alignment of the channel measurements, shared
+ *  by the observables blocks.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "observables_sync.h"
+#include <cmath>
+
+
+observables_sync::observables_sync(unsigned int nchannels, double Gnss_Synchro::*tow_s,
+        double start_offset_ms, double c_m_ms) :
+        d_nchannels(nchannels),
+        d_tow_s(tow_s),
+        d_start_offset_ms(start_offset_ms),
+        d_c_m_ms(c_m_ms),
+        d_synchro(nchannels),
+        d_delta_rx_time_ms(nchannels, 0.0),
+        d_valid((nchannels + 63) / 64, 0),
+        d_num_valid(0),
+        d_reference(-1),
+        d_fs_hz(0),
+        d_stamps(false),
+        d_epoch_rate_hz(0),
+        d_epoch_period_ms(0.0),
+        d_next_epoch(-1),
+        d_epoch_counter(0),
+        d_epoch_fraction(0.0)
+{}
+
+
+void observables_sync::set_epoch_rate(unsigned int rate_hz)
+{
+    if (rate_hz > OBSERVABLES_SYNC_MAX_EPOCH_RATE_HZ)
+        {
+            rate_hz = OBSERVABLES_SYNC_MAX_EPOCH_RATE_HZ;
+        }
+    d_epoch_rate_hz = rate_hz;
+    d_epoch_period_ms = (rate_hz > 0) ? 1000.0 / static_cast<double>(rate_hz) : 0.0;
+    d_next_epoch = -1;
+    d_history.assign(rate_hz > 0 ? d_nchannels : 0, ring_buffer<observables_sample>(OBSERVABLES_SYNC_HISTORY_DEPTH));
+}
+
+
+unsigned int observables_sync::load(const Gnss_Synchro* const* in)
+{
+    for (unsigned int w = 0; w < d_valid.size(); w++)
+        {
+            d_valid[w] = 0;
+        }
+    d_num_valid = 0;
+    d_reference = -1;
+    d_stamps = d_fs_hz > 0;
+    for (unsigned int i = 0; i < d_nchannels; i++)
+        {
+            d_synchro[i] = in[i][0];
+            // Assume no valid pseudoranges
+            d_synchro[i].Flag_valid_pseudorange = false;
+            d_synchro[i].Pseudorange_m = 0.0;
+            if (d_synchro[i].Flag_valid_word)
+                {
+                    d_valid[i >> 6] |= static_cast<uint64_t>(1) << (i & 63);
+                    d_num_valid++;
+                    d_stamps = d_stamps && d_synchro[i].has_sample_stamp();
+                }
+        }
+    return d_num_valid;
+}
+
+
+int observables_sync::next_valid(int channel) const
+{
+    unsigned int i = static_cast<unsigned int>(channel + 1);
+    while (i < d_nchannels)
+        {
+            // skip the rest of the word at once
+            uint64_t word = d_valid[i >> 6] >> (i & 63);
+            if (word == 0)
+                {
+                    i = (i | 63) + 1;
+                    continue;
+                }
+            while ((word & 1) == 0)
+                {
+                    word >>= 1;
+                    i++;
+                }
+            return static_cast<int>(i);
+        }
+    return -1;
+}
+
+
+bool observables_sync::compute_pseudoranges()
+{
+    if (d_num_valid == 0)
+        {
+            return false;
+        }
+    align(true);
+    return true;
+}
+
+
+void observables_sync::align(bool round_rx_tow)
+{
+    // The most recent symbol TOW in the current set is the reference symbol
+    d_reference = first_valid();
+    for (int ch = next_valid(d_reference); ch >= 0; ch = next_valid(ch))
+        {
+            if (d_synchro[ch].*d_tow_s > d_synchro[d_reference].*d_tow_s)
+                {
+                    d_reference = ch;
+                }
+        }
+    const double TOW_reference_s = d_synchro[d_reference].*d_tow_s;
+    const double ref_PRN_rx_time_ms = d_synchro[d_reference].Prn_timestamp_ms;
+    double rx_TOW_s = TOW_reference_s + d_start_offset_ms / 1000.0;
+    if (round_rx_tow)
+        {
+            // the symbol TOW is a whole number of milliseconds
+            rx_TOW_s = round(TOW_reference_s * 1000.0) / 1000.0 + d_start_offset_ms / 1000.0;
+        }
+
+    // RX time differences due to the PRN alignment in the correlators
+    const double ms_per_stamp = d_stamps ? 1000.0 / (static_cast<double>(d_fs_hz) * GNSS_SYNCHRO_STAMP_ONE) : 0.0;
+    for (int ch = first_valid(); ch >= 0; ch = next_valid(ch))
+        {
+            Gnss_Synchro& synchro = d_synchro[ch];
+            if (d_stamps)
+                {
+                    d_delta_rx_time_ms[ch] = static_cast<double>(synchro.sample_stamp_difference(d_synchro[d_reference])) * ms_per_stamp;
+                }
+            else
+                {
+                    d_delta_rx_time_ms[ch] = synchro.Prn_timestamp_ms - ref_PRN_rx_time_ms;
+                }
+            const double traveltime_ms = (TOW_reference_s - synchro.*d_tow_s) * 1000.0 + d_delta_rx_time_ms[ch] + d_start_offset_ms;
+            synchro.Pseudorange_m = traveltime_ms * d_c_m_ms;
+            synchro.Flag_valid_pseudorange = true;
+            synchro.*d_tow_s = rx_TOW_s;
+        }
+}
+
+
+bool observables_sync::load_epoch(const Gnss_Synchro* const* in)
+{
+    load(in);
+
+    // The receiver clock is the oldest latest measurement among the channels
+    // with history, so that all of them can be interpolated to it
+    int clock = -1;
+    for (unsigned int i = 0; i < d_nchannels; i++)
+        {
+            if (!valid(i))
+                {
+                    d_history[i].clear();
+                    continue;
+                }
+            observables_sample sample;
+            sample.rx_time_ms = d_synchro[i].Prn_timestamp_ms;
+            sample.sample_counter = d_synchro[i].Tracking_sample_counter;
+            sample.sample_fraction = d_synchro[i].Tracking_sample_fraction;
+            sample.tow_s = d_synchro[i].*d_tow_s;
+            sample.carrier_phase_rads = d_synchro[i].Carrier_phase_rads;
+            sample.carrier_doppler_hz = d_synchro[i].Carrier_Doppler_hz;
+            if (!d_history[i].empty() && !later(sample, d_history[i].back()))
+                {
+                    // the tracking timestamps went back, e.g. after a new acquisition
+                    d_history[i].clear();
+                }
+            d_history[i].push_back(sample);
+            if (clock < 0 || later(d_history[clock].back(), sample))
+                {
+                    clock = static_cast<int>(i);
+                }
+        }
+    observables_sample clock_sample;
+    if (clock >= 0)
+        {
+            clock_sample = d_history[clock].back();
+        }
+    else
+        {
+            // no valid channel, keep the epochs going with the tracking time
+            d_stamps = false;
+            clock_sample.rx_time_ms = -1.0;
+            for (unsigned int i = 0; i < d_nchannels; i++)
+                {
+                    if (d_synchro[i].Prn_timestamp_ms > clock_sample.rx_time_ms)
+                        {
+                            clock_sample.rx_time_ms = d_synchro[i].Prn_timestamp_ms;
+                        }
+                }
+        }
+
+    long long last_epoch;
+    long long first_epoch;
+    if (d_stamps)
+        {
+            // epoch n is at sample n fs / rate: the last one at or before
+            // the clock, and the first one at or after it
+            const uint64_t scaled = clock_sample.sample_counter * d_epoch_rate_hz
+                    + (static_cast<uint64_t>(clock_sample.sample_fraction) * d_epoch_rate_hz) / GNSS_SYNCHRO_STAMP_ONE;
+            const bool exact = (static_cast<uint64_t>(clock_sample.sample_fraction) * d_epoch_rate_hz) % GNSS_SYNCHRO_STAMP_ONE == 0;
+            last_epoch = static_cast<long long>(scaled / d_fs_hz);
+            first_epoch = (exact && scaled % d_fs_hz == 0) ? last_epoch : last_epoch + 1;
+        }
+    else
+        {
+            if (clock_sample.rx_time_ms <= 0.0)
+                {
+                    return false;
+                }
+            last_epoch = static_cast<long long>(floor(clock_sample.rx_time_ms / d_epoch_period_ms));
+            first_epoch = static_cast<long long>(ceil(clock_sample.rx_time_ms / d_epoch_period_ms));
+        }
+    if (d_next_epoch < 0)
+        {
+            d_next_epoch = first_epoch;
+        }
+    if (d_next_epoch > last_epoch)
+        {
+            return false;
+        }
+    // after a gap, skip to the latest epoch
+    const double epoch_ms = static_cast<double>(last_epoch) * d_epoch_period_ms;
+    d_next_epoch = last_epoch + 1;
+    if (d_stamps)
+        {
+            const uint64_t epoch_scaled = static_cast<uint64_t>(last_epoch) * d_fs_hz;
+            d_epoch_counter = epoch_scaled / d_epoch_rate_hz;
+            d_epoch_fraction = static_cast<double>(epoch_scaled % d_epoch_rate_hz) / static_cast<double>(d_epoch_rate_hz);
+        }
+
+    d_num_valid = 0;
+    for (unsigned int i = 0; i < d_nchannels; i++)
+        {
+            d_synchro[i].Prn_timestamp_ms = epoch_ms;
+            if (d_stamps)
+                {
+                    d_synchro[i].set_sample_stamp(d_epoch_counter, d_epoch_fraction, static_cast<double>(d_fs_hz));
+                }
+            if (!valid(i))
+                {
+                    continue;
+                }
+            if (interpolate(i, epoch_ms))
+                {
+                    d_num_valid++;
+                }
+            else
+                {
+                    d_valid[i >> 6] &= ~(static_cast<uint64_t>(1) << (i & 63));
+                }
+        }
+    if (d_num_valid > 0)
+        {
+            align(false);
+        }
+    return true;
+}
+
+
+bool observables_sync::later(const observables_sample& a, const observables_sample& b) const
+{
+    if (d_stamps)
+        {
+            return Gnss_Synchro::sample_stamp_difference(a.sample_counter, a.sample_fraction, b.sample_counter, b.sample_fraction) > 0;
+        }
+    return a.rx_time_ms > b.rx_time_ms;
+}
+
+
+double observables_sync::after_epoch(const observables_sample& s, double rx_time_ms) const
+{
+    if (d_stamps)
+        {
+            return static_cast<double>(static_cast<int64_t>(s.sample_counter - d_epoch_counter))
+                    + static_cast<double>(s.sample_fraction) / GNSS_SYNCHRO_STAMP_ONE - d_epoch_fraction;
+        }
+    return s.rx_time_ms - rx_time_ms;
+}
+
+
+bool observables_sync::interpolate(unsigned int channel, double rx_time_ms)
+{
+    const ring_buffer<observables_sample>& history = d_history[channel];
+    if (history.size() < 2 || after_epoch(history.front(), rx_time_ms) > 0.0)
+        {
+            return false;
+        }
+    // the epoch is close to the latest measurement
+    unsigned int k = history.size() - 1;
+    while (after_epoch(history[k - 1], rx_time_ms) > 0.0)
+        {
+            k--;
+        }
+    const observables_sample& a = history[k - 1];
+    const observables_sample& b = history[k];
+    const double after_a = after_epoch(a, rx_time_ms);
+    const double alpha = -after_a / (after_epoch(b, rx_time_ms) - after_a);
+    Gnss_Synchro& synchro = d_synchro[channel];
+    synchro.*d_tow_s = a.tow_s + alpha * (b.tow_s - a.tow_s);
+    synchro.Carrier_phase_rads = a.carrier_phase_rads + alpha * (b.carrier_phase_rads - a.carrier_phase_rads);
+    synchro.Carrier_Doppler_hz = a.carrier_doppler_hz + alpha * (b.carrier_doppler_hz - a.carrier_doppler_hz);
+    return true;
+}
+
+
+double observables_sync::linear_fit(const ring_buffer<double>& x, const ring_buffer<double>& y, double x0)
+{
+    // centered on the mean of x, since the TOW values are large
+    const unsigned int n = x.size();
+    double mean_x = 0.0;
+    double mean_y = 0.0;
+    for (unsigned int i = 0; i < n; i++)
+        {
+            mean_x += x[i];
+            mean_y += y[i];
+        }
+    mean_x /= static_cast<double>(n);
+    mean_y /= static_cast<double>(n);
+    double sxx = 0.0;
+    double sxy = 0.0;
+    for (unsigned int i = 0; i < n; i++)
+        {
+            const double dx = x[i] - mean_x;
+            sxx += dx * dx;
+            sxy += dx * (y[i] - mean_y);
+        }
+    if (sxx == 0.0)
+        {
+            return mean_y;
+        }
+    return mean_y + sxy / sxx * (x0 - mean_x);
+}
@@ -0,0 +1,233 @@
+/*!
+ * \file observables_sync.h
+ * \brief Common reception time alignment of the channel measurements, shared
+ *  by the observables blocks.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The observables blocks used to copy the valid channels of every epoch into
+ * a std::map, find the reference satellite with max_element and copy the
+ * measurements back to a variable length array, allocating a map node per
+ * channel and epoch. This class keeps the measurements in an array indexed
+ * by channel, allocated once, with a bitmask of the channels that have a
+ * valid word. The reference satellite and the pseudoranges are computed in
+ * two linear passes over the valid channels.
+ *
+ * Optionally, the class keeps a short time-tagged history of every channel
+ * and interpolates all of them to common receiver clock epochs, at a rate
+ * that does not depend on the rate of the tracking outputs.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_OBSERVABLES_SYNC_H_
+#define GNSS_SDR_OBSERVABLES_SYNC_H_
+
+#include <cstdint>
+#include <vector>
+#include "gnss_synchro.h"
+#include "ring_buffer.h"
+
+//! Measurements kept per channel for the interpolation to receiver epochs
+#define OBSERVABLES_SYNC_HISTORY_DEPTH 64
+
+//! Largest receiver epoch rate [Hz]
+#define OBSERVABLES_SYNC_MAX_EPOCH_RATE_HZ 100
+
+//! Time-tagged measurement of a channel
+struct observables_sample
+{
+    double rx_time_ms;          // Prn_timestamp_ms
+    uint64_t sample_counter;    // sample stamp of Gnss_Synchro
+    uint16_t sample_fraction;
+    double tow_s;
+    double carrier_phase_rads;
+    double carrier_doppler_hz;
+};
+
+
+/*!
+ * \brief Computes the pseudoranges of a set of channels with the common
+ * reception time algorithm.
+ *
+ * Every epoch, load() copies the measurements of all the channels and
+ * compute_pseudoranges() takes the valid channel with the most recent symbol
+ * TOW as the reference. The TOW member used (GPS or hybrid time scale), the
+ * start offset and the speed of light are given to the constructor, so the
+ * same engine serves the GPS, Galileo and hybrid observables blocks.
+ * The channels are indexed by input port. The class is not thread-safe.
+ *
+ * After set_epoch_rate(), load_epoch() replaces load() and
+ * compute_pseudoranges(): each call stores the valid measurements in the
+ * channel histories and, once every channel has reached the next receiver
+ * epoch (a multiple of 1000 / rate_hz ms of Prn_timestamp_ms), interpolates
+ * the TOW, carrier phase and Doppler of all the channels to that epoch.
+ *
+ * After set_sample_rate(), the channels are aligned with the integer sample
+ * stamps set by the tracking blocks instead of Prn_timestamp_ms: the PRN
+ * start differences, the ordering of the histories and the receiver epochs,
+ * placed at whole fractions of the sample rate, are computed exactly at
+ * any time since the start of the run. Measurements without a stamp, such
+ * as those replayed from files, fall back to Prn_timestamp_ms.
+ */
+class observables_sync
+{
+public:
+    /*!
+     * \param nchannels - number of channels (block input ports).
+     * \param tow_s - member of Gnss_Synchro holding the TOW of the current symbol [s].
+     * \param start_offset_ms - travel time assigned to the reference satellite [ms].
+     * \param c_m_ms - speed of light [m/ms].
+     */
+    observables_sync(unsigned int nchannels, double Gnss_Synchro::*tow_s,
+            double start_offset_ms, double c_m_ms);
+
+    /*!
+     * \brief Copies the current measurement of every channel, with no valid
+     * pseudorange yet, and marks the channels that have a valid word.
+     * Returns the number of valid channels.
+     */
+    unsigned int load(const Gnss_Synchro* const* in);
+
+    /*!
+     * \brief Computes the pseudorange and the receiver TOW of every valid
+     * channel. Returns false if there is no valid channel.
+     */
+    bool compute_pseudoranges();
+
+    /*!
+     * \brief Enables the output at receiver epochs, from 1 to
+     * OBSERVABLES_SYNC_MAX_EPOCH_RATE_HZ per second, or disables it with 0.
+     */
+    void set_epoch_rate(unsigned int rate_hz);
+
+    /*!
+     * \brief Sample rate of the tracking blocks [Hz], to align the channels
+     * with their sample stamps, or 0 to align them with Prn_timestamp_ms
+     */
+    void set_sample_rate(uint64_t fs_hz)
+    {
+        d_fs_hz = fs_hz;
+    }
+
+    //! Receiver epoch rate [Hz], 0 if the epochs are disabled
+    unsigned int epoch_rate() const
+    {
+        return d_epoch_rate_hz;
+    }
+
+    /*!
+     * \brief Loads the current measurements and updates the channel
+     * histories. Returns true if a receiver epoch is complete, in which case
+     * the channels hold the measurements interpolated to it, with their
+     * pseudoranges, and Prn_timestamp_ms is the epoch time. Channels that
+     * have no history around the epoch are not valid.
+     */
+    bool load_epoch(const Gnss_Synchro* const* in);
+
+    bool valid(unsigned int channel) const
+    {
+        return (d_valid[channel >> 6] >> (channel & 63)) & 1;
+    }
+
+    //! First valid channel, or -1
+    int first_valid() const
+    {
+        return next_valid(-1);
+    }
+
+    //! Next valid channel after channel, or -1
+    int next_valid(int channel) const;
+
+    unsigned int num_valid() const
+    {
+        return d_num_valid;
+    }
+
+    unsigned int num_channels() const
+    {
+        return d_nchannels;
+    }
+
+    //! Reference channel of the last compute_pseudoranges(), or -1
+    int reference_channel() const
+    {
+        return d_reference;
+    }
+
+    Gnss_Synchro& synchro(unsigned int channel)
+    {
+        return d_synchro[channel];
+    }
+
+    const Gnss_Synchro& synchro(unsigned int channel) const
+    {
+        return d_synchro[channel];
+    }
+
+    //! PRN start time of the channel minus that of the reference channel [ms]
+    double delta_rx_time_ms(unsigned int channel) const
+    {
+        return d_delta_rx_time_ms[channel];
+    }
+
+    /*!
+     * \brief Least squares line through the points (x[i], y[i]), evaluated
+     * at x0. Both buffers must have the same size, of at least two points.
+     */
+    static double linear_fit(const ring_buffer<double>& x, const ring_buffer<double>& y, double x0);
+
+private:
+    // pseudoranges of the valid channels against the one with the latest TOW
+    void align(bool round_rx_tow);
+    bool interpolate(unsigned int channel, double rx_time_ms);
+    // a was measured after b
+    bool later(const observables_sample& a, const observables_sample& b) const;
+    // time from the epoch at rx_time_ms to the measurement s: in samples with
+    // the sample stamps, in ms without them
+    double after_epoch(const observables_sample& s, double rx_time_ms) const;
+
+    unsigned int d_nchannels;
+    double Gnss_Synchro::*d_tow_s;
+    double d_start_offset_ms;
+    double d_c_m_ms;
+
+    std::vector<Gnss_Synchro> d_synchro;
+    std::vector<double> d_delta_rx_time_ms;
+    std::vector<uint64_t> d_valid;   // bit (ch & 63) of word (ch >> 6)
+    unsigned int d_num_valid;
+    int d_reference;
+    uint64_t d_fs_hz;
+    bool d_stamps;      // all the valid channels of the epoch have a sample stamp
+
+    // receiver epochs
+    unsigned int d_epoch_rate_hz;
+    double d_epoch_period_ms;
+    long long d_next_epoch;     // index of the next epoch, or -1 before the first one
+    uint64_t d_epoch_counter;   // sample stamp of the current epoch, with the stamps
+    double d_epoch_fraction;    // [samples]
+    std::vector<ring_buffer<observables_sample>> d_history;
+};
+
+#endif /* GNSS_SDR_OBSERVABLES_SYNC_H_ */
@@ -0,0 +1,506 @@
+/*!
+ * \file rinex_observables_reader.cc
+ * \brief Reader of the observations and ephemeris of RINEX 3 files
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "rinex_observables_reader.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include "GPS_L1_CA.h"
+#include "gps_ephemeris.h"
+#include "gps_iono.h"
+#include "gps_utc_model.h"
+#include "galileo_ephemeris.h"
+
+namespace
+{
+const double SECONDS_PER_WEEK = 604800.0;
+
+// Header label, in columns 61 to 80
+bool has_label(const std::string & line, const char * label)
+{
+    return line.size() > 60 && line.compare(60, std::string(label).size(), label) == 0;
+}
+
+// Days from 1 January 1970 to a date of the Gregorian calendar
+long days_from_civil(int year, int month, int day)
+{
+    year -= month <= 2;
+    const long era = (year >= 0 ? year : year - 399) / 400;
+    const long year_of_era = year - era * 400;
+    const long day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const long day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+// URA index of a user range accuracy in meters, IS-GPS-200 20.3.3.3.1.3
+int ura_index(double accuracy_m)
+{
+    const double ura[15] = { 2.4, 3.4, 4.85, 6.85, 9.65, 13.65, 24.0, 48.0, 96.0, 192.0, 384.0, 768.0, 1536.0, 3072.0, 6144.0 };
+    for (int i = 0; i < 15; i++)
+        {
+            if (accuracy_m <= ura[i]) return i;
+        }
+    return 15;
+}
+
+// The signals that are read, and the attributes of their observation codes
+struct Wanted_Signal
+{
+    char system;
+    const char * signal;
+    char band;
+    const char * attributes;
+};
+
+const Wanted_Signal WANTED_SIGNALS[4] = {
+        { 'G', "1C", '1', "C" },
+        { 'G', "2S", '2', "SLX" },
+        { 'E', "1B", '1', "BCX" },
+        { 'E', "5X", '5', "XQI" } };
+}
+
+
+Rinex_Observables_Reader::Rinex_Observables_Reader()
+{
+    d_epochs = 0;
+    d_next_navigation = 0;
+}
+
+
+double Rinex_Observables_Reader::gps_time(int year, int month, int day, int hour, int minute, double second)
+{
+    // 6 January 1980 is 3657 days after 1 January 1970
+    const long days = days_from_civil(year, month, day) - 3657;
+    return static_cast<double>(days) * 86400.0 + hour * 3600.0 + minute * 60.0 + second;
+}
+
+
+double Rinex_Observables_Reader::field(const std::string & line, size_t start, size_t width)
+{
+    if (start >= line.size()) return 0.0;
+    std::string text = line.substr(start, width);
+    std::replace(text.begin(), text.end(), 'D', 'E');
+    std::replace(text.begin(), text.end(), 'd', 'e');
+    return std::strtod(text.c_str(), nullptr);
+}
+
+
+bool Rinex_Observables_Reader::open_observations(const std::string & filename)
+{
+    d_error.clear();
+    d_codes.clear();
+    d_epochs = 0;
+    if (d_obs_file.is_open()) d_obs_file.close();
+    d_obs_file.clear();
+    d_obs_file.open(filename.c_str());
+    std::string line;
+    if (!d_obs_file.is_open() || !std::getline(d_obs_file, line))
+        {
+            d_error = "cannot read " + filename;
+            return false;
+        }
+    if (!has_label(line, "RINEX VERSION / TYPE") || field(line, 0, 9) < 3.0 || line[20] != 'O')
+        {
+            d_error = filename + " is not a RINEX 3 observation file";
+            return false;
+        }
+
+    std::map<char, std::vector<std::string>> types;
+    char system = ' ';
+    unsigned int count = 0;
+    bool header_end = false;
+    while (std::getline(d_obs_file, line))
+        {
+            if (has_label(line, "END OF HEADER"))
+                {
+                    header_end = true;
+                    break;
+                }
+            if (!has_label(line, "SYS / # / OBS TYPES")) continue;
+            // A1,2X,I3,13(1X,A3), continued by 6X,13(1X,A3)
+            if (line[0] != ' ')
+                {
+                    system = line[0];
+                    count = std::atoi(line.substr(3, 3).c_str());
+                }
+            for (size_t col = 7; col + 3 <= 60 && types[system].size() < count; col += 4)
+                {
+                    types[system].push_back(line.substr(col, 3));
+                }
+        }
+    if (!header_end)
+        {
+            d_error = filename + " has no END OF HEADER";
+            return false;
+        }
+
+    for (unsigned int w = 0; w < 4; w++)
+        {
+            const std::vector<std::string> & codes = types[WANTED_SIGNALS[w].system];
+            Signal_Codes signal = { WANTED_SIGNALS[w].signal, -1, -1, -1, -1 };
+            for (unsigned int i = 0; i < codes.size() && signal.pseudorange < 0; i++)
+                {
+                    if (codes[i][0] == 'C' && codes[i][1] == WANTED_SIGNALS[w].band
+                            && std::string(WANTED_SIGNALS[w].attributes).find(codes[i][2]) != std::string::npos)
+                        {
+                            signal.pseudorange = i;
+                        }
+                }
+            if (signal.pseudorange < 0) continue;
+            const std::string code = codes[signal.pseudorange].substr(1);
+            for (unsigned int i = 0; i < codes.size(); i++)
+                {
+                    if (codes[i].substr(1) != code) continue;
+                    if (codes[i][0] == 'L') signal.carrier_phase = i;
+                    if (codes[i][0] == 'D') signal.doppler = i;
+                    if (codes[i][0] == 'S') signal.cn0 = i;
+                }
+            d_codes[WANTED_SIGNALS[w].system].push_back(signal);
+        }
+    if (d_codes.empty())
+        {
+            d_error = filename + " has no observations of the supported signals";
+            return false;
+        }
+    return true;
+}
+
+
+bool Rinex_Observables_Reader::next_epoch(Rinex_Epoch & epoch)
+{
+    epoch.observations.clear();
+    std::string line;
+    while (std::getline(d_obs_file, line))
+        {
+            if (line.empty() || line[0] != '>') continue;
+            int year, month, day, hour, minute, flag, satellites;
+            double second;
+            if (std::sscanf(line.c_str() + 1, "%d %d %d %d %d %lf %d %d",
+                    &year, &month, &day, &hour, &minute, &second, &flag, &satellites) != 8)
+                {
+                    d_error = "malformed epoch: " + line;
+                    return false;
+                }
+            // events and cycle slip records have no observations to read
+            const bool event = flag > 1;
+            epoch.gps_time_s = gps_time(year, month, day, hour, minute, second);
+            const double tow = std::fmod(epoch.gps_time_s, SECONDS_PER_WEEK);
+            for (int s = 0; s < satellites; s++)
+                {
+                    if (!std::getline(d_obs_file, line))
+                        {
+                            d_error = "truncated epoch";
+                            return false;
+                        }
+                    if (event || line.size() < 3) continue;
+                    std::map<char, std::vector<Signal_Codes>>::const_iterator codes = d_codes.find(line[0]);
+                    if (codes == d_codes.end()) continue;
+                    const unsigned int prn = std::atoi(line.substr(1, 2).c_str());
+                    for (std::vector<Signal_Codes>::const_iterator it = codes->second.begin(); it != codes->second.end(); ++it)
+                        {
+                            // F14.3,I1,I1 per observation
+                            const double pseudorange = field(line, 3 + 16 * it->pseudorange, 14);
+                            if (pseudorange == 0.0) continue;
+                            Gnss_Synchro observation = Gnss_Synchro();
+                            observation.System = line[0];
+                            observation.Signal[0] = it->signal[0];
+                            observation.Signal[1] = it->signal[1];
+                            observation.Signal[2] = '\0';
+                            observation.PRN = prn;
+                            observation.Flag_valid_word = true;
+                            observation.Flag_valid_pseudorange = true;
+                            observation.Pseudorange_m = pseudorange;
+                            if (it->carrier_phase >= 0) observation.Carrier_phase_rads = GPS_TWO_PI * field(line, 3 + 16 * it->carrier_phase, 14);
+                            if (it->doppler >= 0) observation.Carrier_Doppler_hz = field(line, 3 + 16 * it->doppler, 14);
+                            if (it->cn0 >= 0) observation.CN0_dB_hz = field(line, 3 + 16 * it->cn0, 14);
+                            observation.d_TOW = tow;
+                            observation.d_TOW_at_current_symbol = tow;
+                            observation.d_TOW_hybrid_at_current_symbol = tow;
+                            epoch.observations.push_back(observation);
+                        }
+                }
+            if (event) continue;
+            d_epochs++;
+            return true;
+        }
+    return false;
+}
+
+
+void Rinex_Observables_Reader::add_navigation(double gps_time_s, const boost::any & record)
+{
+    std::vector<std::pair<double, boost::any>>::iterator position = std::upper_bound(
+            d_navigation.begin() + d_next_navigation, d_navigation.end(), gps_time_s,
+            [](double t, const std::pair<double, boost::any> & r) { return t < r.first; });
+    d_navigation.insert(position, std::make_pair(gps_time_s, record));
+}
+
+
+bool Rinex_Observables_Reader::next_navigation(double gps_time_s, boost::any & record)
+{
+    if (d_next_navigation >= d_navigation.size() || d_navigation[d_next_navigation].first > gps_time_s)
+        {
+            return false;
+        }
+    record = d_navigation[d_next_navigation].second;
+    d_navigation[d_next_navigation].second = boost::any();
+    d_next_navigation++;
+    return true;
+}
+
+
+bool Rinex_Observables_Reader::read_orbit_lines(std::ifstream & file, unsigned int count, std::vector<double> & values)
+{
+    // 4X,4D19.12 per line
+    values.clear();
+    std::string line;
+    for (unsigned int l = 0; l < count; l++)
+        {
+            if (!std::getline(file, line)) return false;
+            for (unsigned int k = 0; k < 4; k++)
+                {
+                    values.push_back(field(line, 4 + 19 * k, 19));
+                }
+        }
+    return true;
+}
+
+
+bool Rinex_Observables_Reader::read_gps_ephemeris(std::ifstream & file, const std::string & first_line)
+{
+    std::vector<double> orbit;
+    if (!read_orbit_lines(file, 7, orbit)) return false;
+    const double toc = gps_time(std::atoi(first_line.substr(4, 4).c_str()), std::atoi(first_line.substr(9, 2).c_str()),
+            std::atoi(first_line.substr(12, 2).c_str()), std::atoi(first_line.substr(15, 2).c_str()),
+            std::atoi(first_line.substr(18, 2).c_str()), field(first_line, 21, 2));
+
+    std::shared_ptr<Gps_Ephemeris> ephemeris = std::make_shared<Gps_Ephemeris>();
+    ephemeris->i_satellite_PRN = std::atoi(first_line.substr(1, 2).c_str());
+    ephemeris->d_Toc = std::fmod(toc, SECONDS_PER_WEEK);
+    ephemeris->d_A_f0 = field(first_line, 23, 19);
+    ephemeris->d_A_f1 = field(first_line, 42, 19);
+    ephemeris->d_A_f2 = field(first_line, 61, 19);
+    ephemeris->d_IODE_SF2 = orbit[0];
+    ephemeris->d_IODE_SF3 = orbit[0];
+    ephemeris->d_Crs = orbit[1];
+    ephemeris->d_Delta_n = orbit[2];
+    ephemeris->d_M_0 = orbit[3];
+    ephemeris->d_Cuc = orbit[4];
+    ephemeris->d_e_eccentricity = orbit[5];
+    ephemeris->d_Cus = orbit[6];
+    ephemeris->d_sqrt_A = orbit[7];
+    ephemeris->d_Toe = orbit[8];
+    ephemeris->d_Cic = orbit[9];
+    ephemeris->d_OMEGA0 = orbit[10];
+    ephemeris->d_Cis = orbit[11];
+    ephemeris->d_i_0 = orbit[12];
+    ephemeris->d_Crc = orbit[13];
+    ephemeris->d_OMEGA = orbit[14];
+    ephemeris->d_OMEGA_DOT = orbit[15];
+    ephemeris->d_IDOT = orbit[16];
+    ephemeris->i_code_on_L2 = static_cast<int>(orbit[17]);
+    // the navigation message has the week modulo 1024, as the decoders store it
+    ephemeris->i_GPS_week = static_cast<int>(orbit[18]) % 1024;
+    ephemeris->b_L2_P_data_flag = orbit[19] != 0.0;
+    ephemeris->i_SV_accuracy = ura_index(orbit[20]);
+    ephemeris->i_SV_health = static_cast<int>(orbit[21]);
+    ephemeris->d_TGD = orbit[22];
+    ephemeris->d_IODC = orbit[23];
+    ephemeris->d_TOW = orbit[24];
+    ephemeris->b_fit_interval_flag = orbit[25] > 4.0;
+    add_navigation(toc, ephemeris);
+    return true;
+}
+
+
+bool Rinex_Observables_Reader::read_galileo_ephemeris(std::ifstream & file, const std::string & first_line)
+{
+    std::vector<double> orbit;
+    if (!read_orbit_lines(file, 7, orbit)) return false;
+    const double toc = gps_time(std::atoi(first_line.substr(4, 4).c_str()), std::atoi(first_line.substr(9, 2).c_str()),
+            std::atoi(first_line.substr(12, 2).c_str()), std::atoi(first_line.substr(15, 2).c_str()),
+            std::atoi(first_line.substr(18, 2).c_str()), field(first_line, 21, 2));
+
+    std::shared_ptr<Galileo_Ephemeris> ephemeris = std::make_shared<Galileo_Ephemeris>();
+    ephemeris->i_satellite_PRN = std::atoi(first_line.substr(1, 2).c_str());
+    ephemeris->SV_ID_PRN_4 = ephemeris->i_satellite_PRN;
+    ephemeris->t0c_4 = std::fmod(toc, SECONDS_PER_WEEK);
+    ephemeris->af0_4 = field(first_line, 23, 19);
+    ephemeris->af1_4 = field(first_line, 42, 19);
+    ephemeris->af2_4 = field(first_line, 61, 19);
+    ephemeris->IOD_ephemeris = static_cast<int>(orbit[0]);
+    ephemeris->IOD_nav_1 = ephemeris->IOD_ephemeris;
+    ephemeris->C_rs_3 = orbit[1];
+    ephemeris->delta_n_3 = orbit[2];
+    ephemeris->M0_1 = orbit[3];
+    ephemeris->C_uc_3 = orbit[4];
+    ephemeris->e_1 = orbit[5];
+    ephemeris->C_us_3 = orbit[6];
+    ephemeris->A_1 = orbit[7];
+    ephemeris->t0e_1 = orbit[8];
+    ephemeris->C_ic_4 = orbit[9];
+    ephemeris->OMEGA_0_2 = orbit[10];
+    ephemeris->C_is_4 = orbit[11];
+    ephemeris->i_0_2 = orbit[12];
+    ephemeris->C_rc_3 = orbit[13];
+    ephemeris->omega_2 = orbit[14];
+    ephemeris->OMEGA_dot_3 = orbit[15];
+    ephemeris->iDot_2 = orbit[16];
+    // RINEX has the week of the GPS time scale, 1024 weeks ahead of the GST one
+    ephemeris->WN_5 = orbit[18] - 1024.0;
+    ephemeris->SISA_3 = orbit[20];
+    // health bits: E1-B DVS, E1-B HS (2), E5a DVS, E5a HS (2), E5b DVS, E5b HS (2)
+    const unsigned int health = static_cast<unsigned int>(orbit[21]);
+    ephemeris->E1B_DVS_5 = health & 1;
+    ephemeris->E1B_HS_5 = (health >> 1) & 3;
+    ephemeris->E5a_DVS = (health >> 3) & 1;
+    ephemeris->E5a_HS = (health >> 4) & 3;
+    ephemeris->E5b_DVS_5 = (health >> 6) & 1;
+    ephemeris->E5b_HS_5 = (health >> 7) & 3;
+    ephemeris->BGD_E1E5a_5 = orbit[22];
+    ephemeris->BGD_E1E5b_5 = orbit[23];
+    ephemeris->TOW_5 = orbit[24];
+    ephemeris->flag_all_ephemeris = true;
+    add_navigation(toc, ephemeris);
+    return true;
+}
+
+
+bool Rinex_Observables_Reader::read_navigation(const std::string & filename)
+{
+    d_error.clear();
+    std::ifstream file(filename.c_str());
+    std::string line;
+    if (!file.is_open() || !std::getline(file, line))
+        {
+            d_error = "cannot read " + filename;
+            return false;
+        }
+    if (!has_label(line, "RINEX VERSION / TYPE") || field(line, 0, 9) < 3.0 || line[20] != 'N')
+        {
+            d_error = filename + " is not a RINEX 3 navigation file";
+            return false;
+        }
+
+    // the models of the header apply from the first epoch
+    const double header_time = -std::numeric_limits<double>::max();
+    std::shared_ptr<Gps_Iono> iono = std::make_shared<Gps_Iono>();
+    std::shared_ptr<Gps_Utc_Model> utc = std::make_shared<Gps_Utc_Model>();
+    bool header_end = false;
+    while (std::getline(file, line))
+        {
+            if (has_label(line, "END OF HEADER"))
+                {
+                    header_end = true;
+                    break;
+                }
+            if (has_label(line, "IONOSPHERIC CORR"))
+                {
+                    // A4,1X,4D12.4
+                    double * coefficients[2][4] = {
+                            { &iono->d_alpha0, &iono->d_alpha1, &iono->d_alpha2, &iono->d_alpha3 },
+                            { &iono->d_beta0, &iono->d_beta1, &iono->d_beta2, &iono->d_beta3 } };
+                    const int set = line.compare(0, 4, "GPSA") == 0 ? 0 : (line.compare(0, 4, "GPSB") == 0 ? 1 : -1);
+                    if (set < 0) continue;
+                    for (unsigned int k = 0; k < 4; k++)
+                        {
+                            *coefficients[set][k] = field(line, 5 + 12 * k, 12);
+                        }
+                    iono->valid = true;
+                }
+            else if (has_label(line, "TIME SYSTEM CORR") && line.compare(0, 4, "GPUT") == 0)
+                {
+                    // A4,1X,D17.10,D16.9,1X,I6,1X,I4
+                    utc->d_A0 = field(line, 5, 17);
+                    utc->d_A1 = field(line, 22, 16);
+                    utc->d_t_OT = field(line, 38, 7);
+                    utc->i_WN_T = static_cast<int>(field(line, 45, 5)) % 1024;
+                    utc->valid = true;
+                }
+            else if (has_label(line, "LEAP SECONDS"))
+                {
+                    // 4I6: current and future leap seconds, week and day of the change
+                    utc->d_DeltaT_LS = field(line, 0, 6);
+                    utc->d_DeltaT_LSF = field(line, 6, 6);
+                    utc->i_WN_LSF = static_cast<int>(field(line, 12, 6)) % 1024;
+                    utc->i_DN = static_cast<int>(field(line, 18, 6));
+                    if (line.substr(6, 6).find_first_not_of(' ') == std::string::npos)
+                        {
+                            utc->d_DeltaT_LSF = utc->d_DeltaT_LS;
+                        }
+                    utc->valid = true;
+                }
+        }
+    if (!header_end)
+        {
+            d_error = filename + " has no END OF HEADER";
+            return false;
+        }
+    if (iono->valid) add_navigation(header_time, iono);
+    if (utc->valid) add_navigation(header_time, utc);
+
+    while (std::getline(file, line))
+        {
+            if (line.size() < 23 || line[0] == ' ') continue;
+            bool read = true;
+            switch (line[0])
+                {
+                case 'G':
+                    read = read_gps_ephemeris(file, line);
+                    break;
+                case 'E':
+                    read = read_galileo_ephemeris(file, line);
+                    break;
+                case 'R':
+                case 'S':
+                    {
+                        // GLONASS and SBAS records have 3 more lines
+                        std::vector<double> skipped;
+                        read = read_orbit_lines(file, 3, skipped);
+                        break;
+                    }
+                default:
+                    {
+                        std::vector<double> skipped;
+                        read = read_orbit_lines(file, 7, skipped);
+                        break;
+                    }
+                }
+            if (!read)
+                {
+                    d_error = filename + " has a truncated record: " + line.substr(0, 23);
+                    return false;
+                }
+        }
+    return true;
+}
@@ -0,0 +1,140 @@
+/*!
+ * \file rinex_observables_reader.h
+ * \brief Reader of the observations and ephemeris of RINEX 3 files
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The observations of a RINEX 3 observation file are read epoch by epoch
+ * as the observables block outputs them, and the navigation records of
+ * RINEX 3 navigation files are sorted by time, so that the back end (PVT,
+ * RINEX, RTCM and NMEA outputs) can be run again on recorded observables,
+ * without the signal processing, as fast as it can go.
+ *
+ * Only the GPS L1 C/A, GPS L2C, Galileo E1 and Galileo E5a signals are
+ * read, with the observation codes C, L, D and S of 1C; 2S, 2L or 2X; 1B,
+ * 1C or 1X; and 5X, 5Q or 5I, the first one of the header if there are
+ * several for a signal.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_RINEX_OBSERVABLES_READER_H_
+#define GNSS_SDR_RINEX_OBSERVABLES_READER_H_
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/any.hpp>
+#include "gnss_synchro.h"
+
+//! Observations of an epoch
+struct Rinex_Epoch
+{
+    double gps_time_s;  //!< Seconds since the GPS epoch, 6 January 1980
+    std::vector<Gnss_Synchro> observations;  //!< One per signal with a pseudorange
+};
+
+class Rinex_Observables_Reader
+{
+public:
+    Rinex_Observables_Reader();
+
+    //! Opens a RINEX 3 observation file and reads its header
+    bool open_observations(const std::string & filename);
+
+    /*!
+     * \brief Reads the next epoch with observations. The event records
+     * are skipped. Returns false at the end of the file or on a malformed
+     * epoch, which error() tells apart.
+     */
+    bool next_epoch(Rinex_Epoch & epoch);
+
+    /*!
+     * \brief Reads the GPS and Galileo ephemeris of a RINEX 3 navigation
+     * file, and the GPS ionospheric and UTC models of its header. The other
+     * systems are skipped. Several files may be read, their records are
+     * merged by time.
+     */
+    bool read_navigation(const std::string & filename);
+
+    /*!
+     * \brief Takes the next navigation record whose time is not later than
+     * \p gps_time_s, as a std::shared_ptr to a Gps_Ephemeris, Gps_Iono,
+     * Gps_Utc_Model or Galileo_Ephemeris, the objects published by the
+     * telemetry decoders. The models of the headers come first, the
+     * ephemeris at their clock reference time.
+     */
+    bool next_navigation(double gps_time_s, boost::any & record);
+
+    //! Navigation records not taken yet
+    size_t pending_navigation() const
+    {
+        return d_navigation.size() - d_next_navigation;
+    }
+
+    unsigned long long epochs() const
+    {
+        return d_epochs;
+    }
+
+    //! Last error, empty if none
+    const std::string & error() const
+    {
+        return d_error;
+    }
+
+    //! Seconds since the GPS epoch of a date and time of the GPS time scale
+    static double gps_time(int year, int month, int day, int hour, int minute, double second);
+
+    //! Value of a field of a RINEX record, in Fortran or C notation; 0 if blank
+    static double field(const std::string & line, size_t start, size_t width);
+
+private:
+    // Observation codes of a signal, positions in the list of a system (-1 if absent)
+    struct Signal_Codes
+    {
+        std::string signal;
+        int pseudorange;
+        int carrier_phase;
+        int doppler;
+        int cn0;
+    };
+
+    bool read_gps_ephemeris(std::ifstream & file, const std::string & first_line);
+    bool read_galileo_ephemeris(std::ifstream & file, const std::string & first_line);
+    bool read_orbit_lines(std::ifstream & file, unsigned int count, std::vector<double> & values);
+    void add_navigation(double gps_time_s, const boost::any & record);
+
+    std::ifstream d_obs_file;
+    std::map<char, std::vector<Signal_Codes>> d_codes;  // by system
+    unsigned long long d_epochs;
+    std::string d_error;
+
+    std::vector<std::pair<double, boost::any>> d_navigation;  // sorted by time
+    size_t d_next_navigation;
+};
+
+#endif /* GNSS_SDR_RINEX_OBSERVABLES_READER_H_ */
@@ -0,0 +1,127 @@
+/*!
+ * \file fractional_resampler_conditioner.cc
+ * \brief Adapts the polyphase and Farrow resamplers to a GNSSBlockInterface
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "fractional_resampler_conditioner.h"
+#include <glog/logging.h>
+#include <gnuradio/blocks/file_sink.h>
+#include "fractional_resampler.h"
+#include "configuration_interface.h"
+
+
+using google::LogMessage;
+
+FractionalResamplerConditioner::FractionalResamplerConditioner(
+        ConfigurationInterface* configuration, std::string role, std::string implementation,
+        unsigned int in_stream, unsigned int out_stream) :
+        role_(role), implementation_(implementation), in_stream_(in_stream), out_stream_(out_stream)
+{
+    std::string default_item_type = "gr_complex";
+    std::string default_dump_file = "./data/signal_conditioner.dat";
+    sample_freq_in_ = configuration->property(role_ + ".sample_freq_in", (double)4000000.0);
+    sample_freq_out_ = configuration->property(role_ + ".sample_freq_out", (double)2048000.0);
+    item_type_ = configuration->property(role + ".item_type", default_item_type);
+    taps_ = configuration->property(role + ".taps", 16);
+    cutoff_ratio_ = configuration->property(role + ".cutoff_ratio", 0.8);
+    dump_ = configuration->property(role + ".dump", false);
+    DLOG(INFO) << "dump_ is " << dump_;
+    dump_filename_ = configuration->property(role + ".dump_filename", default_dump_file);
+
+    Fractional_Resampler_Method method = RESAMPLER_FARROW;
+    if (implementation_.compare("Polyphase_Resampler") == 0)
+        {
+            method = RESAMPLER_POLYPHASE;
+        }
+
+    Fractional_Resampler_Item item = RESAMPLER_ITEM_GR_COMPLEX;
+    if (item_type_.compare("cshort") == 0)
+        {
+            item = RESAMPLER_ITEM_CSHORT;
+        }
+    else if (item_type_.compare("cbyte") == 0)
+        {
+            item = RESAMPLER_ITEM_CBYTE;
+        }
+    else if (item_type_.compare("gr_complex") != 0)
+        {
+            LOG(WARNING) << item_type_ << " unrecognized item type for resampler, using gr_complex";
+        }
+    item_size_ = fractional_resampler_item_size(item);
+
+    resampler_ = make_fractional_resampler(method, item, sample_freq_in_, sample_freq_out_, taps_, cutoff_ratio_);
+    DLOG(INFO) << "sample_freq_in " << sample_freq_in_;
+    DLOG(INFO) << "sample_freq_out " << sample_freq_out_;
+    DLOG(INFO) << "Item size " << item_size_;
+    DLOG(INFO) << "resampler(" << resampler_->unique_id() << ")";
+
+    if (dump_)
+        {
+            DLOG(INFO) << "Dumping output into file " << dump_filename_;
+            file_sink_ = gr::blocks::file_sink::make(item_size_, dump_filename_.c_str());
+            DLOG(INFO) << "file_sink(" << file_sink_->unique_id() << ")";
+        }
+}
+
+
+FractionalResamplerConditioner::~FractionalResamplerConditioner() {}
+
+
+void FractionalResamplerConditioner::connect(gr::top_block_sptr top_block)
+{
+    if (dump_)
+        {
+            top_block->connect(resampler_, 0, file_sink_, 0);
+            DLOG(INFO) << "connected resampler to file sink";
+        }
+    else
+        {
+            DLOG(INFO) << "nothing to connect internally";
+        }
+}
+
+
+void FractionalResamplerConditioner::disconnect(gr::top_block_sptr top_block)
+{
+    if (dump_)
+        {
+            top_block->disconnect(resampler_, 0, file_sink_, 0);
+        }
+}
+
+
+gr::basic_block_sptr FractionalResamplerConditioner::get_left_block()
+{
+    return resampler_;
+}
+
+
+gr::basic_block_sptr FractionalResamplerConditioner::get_right_block()
+{
+    return resampler_;
+}
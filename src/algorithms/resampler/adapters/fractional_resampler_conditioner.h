@@ -0,0 +1,87 @@
+/*!
+ * \file fractional_resampler_conditioner.h
+ * \brief Adapts the polyphase and Farrow resamplers to a GNSSBlockInterface
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_FRACTIONAL_RESAMPLER_CONDITIONER_H_
+#define GNSS_SDR_FRACTIONAL_RESAMPLER_CONDITIONER_H_
+
+#include <string>
+#include <gnuradio/hier_block2.h>
+#include "gnss_block_interface.h"
+
+class ConfigurationInterface;
+
+/*!
+ * \brief Interface of an adapter of the filtered resamplers
+ * (Polyphase_Resampler and Farrow_Resampler) to a GNSSBlockInterface
+ */
+class FractionalResamplerConditioner: public GNSSBlockInterface
+{
+public:
+    FractionalResamplerConditioner(ConfigurationInterface* configuration,
+            std::string role, std::string implementation,
+            unsigned int in_stream, unsigned int out_stream);
+
+    virtual ~FractionalResamplerConditioner();
+    std::string role()
+    {
+        return role_;
+    }
+    //! returns "Polyphase_Resampler" or "Farrow_Resampler"
+    std::string implementation()
+    {
+        return implementation_;
+    }
+    size_t item_size()
+    {
+        return item_size_;
+    }
+    void connect(gr::top_block_sptr top_block);
+    void disconnect(gr::top_block_sptr top_block);
+    gr::basic_block_sptr get_left_block();
+    gr::basic_block_sptr get_right_block();
+
+private:
+    std::string role_;
+    std::string implementation_;
+    unsigned int in_stream_;
+    unsigned int out_stream_;
+    std::string item_type_;
+    size_t item_size_;
+    bool dump_;
+    std::string dump_filename_;
+    double sample_freq_in_;
+    double sample_freq_out_;
+    unsigned int taps_;
+    double cutoff_ratio_;
+    gr::block_sptr resampler_;
+    gr::block_sptr file_sink_;
+};
+
+#endif /*GNSS_SDR_FRACTIONAL_RESAMPLER_CONDITIONER_H_*/
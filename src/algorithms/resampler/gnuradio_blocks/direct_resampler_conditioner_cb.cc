@@ -33,6 +33,7 @@
 
 
 #include "direct_resampler_conditioner_cb.h"
+#include "gnss_sdr_trace.h"
 #include <algorithm>
 #include <iostream>
 #include <gnuradio/io_signature.h>
@@ -95,6 +96,7 @@ int direct_resampler_conditioner_cb::general_work(int noutput_items,
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE("direct_resampler_conditioner_cb::general_work");
 
     const lv_8sc_t *in = (const lv_8sc_t *)input_items[0];
     lv_8sc_t *out = (lv_8sc_t *)output_items[0];
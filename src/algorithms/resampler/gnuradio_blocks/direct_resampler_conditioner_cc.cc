@@ -33,6 +33,7 @@
 
 
 #include "direct_resampler_conditioner_cc.h"
+#include "gnss_sdr_trace.h"
 #include <algorithm>
 #include <iostream>
 #include <gnuradio/io_signature.h>
@@ -101,6 +102,7 @@ int direct_resampler_conditioner_cc::general_work(int noutput_items,
         gr_vector_int &ninput_items, gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE("direct_resampler_conditioner_cc::general_work");
     const gr_complex *in = (const gr_complex *)input_items[0];
     gr_complex *out = (gr_complex *)output_items[0];
 
@@ -0,0 +1,312 @@
+/*!
+ * \file fractional_resampler.cc
+ * \brief Filtered resampler of complex samples, polyphase for rational
+ * ratios and Farrow for arbitrary ones.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "fractional_resampler.h"
+#include "gnss_sdr_trace.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <boost/math/common_factor_rt.hpp>
+#include <gnuradio/io_signature.h>
+#include <glog/logging.h>
+#include <volk/volk.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+
+using google::LogMessage;
+
+#define FRACTIONAL_RESAMPLER_MAX_INTERPOLATION 1024
+
+namespace
+{
+// Windowed sinc low-pass impulse response, cutoff in cycles per sample,
+// t in samples from the center and a Blackman window of the given length
+double windowed_sinc(double t, double cutoff, double length)
+{
+    if (std::fabs(t) >= length / 2.0)
+        {
+            return 0.0;
+        }
+    const double x = 2.0 * M_PI * cutoff * t;
+    const double sinc = (std::fabs(x) < 1e-9) ? 1.0 : std::sin(x) / x;
+    const double window = 0.42 + 0.5 * std::cos(2.0 * M_PI * t / length) + 0.08 * std::cos(4.0 * M_PI * t / length);
+    return 2.0 * cutoff * sinc * window;
+}
+}
+
+
+size_t fractional_resampler_item_size(Fractional_Resampler_Item item_type)
+{
+    switch (item_type)
+    {
+    case RESAMPLER_ITEM_CSHORT:
+        return sizeof(lv_16sc_t);
+    case RESAMPLER_ITEM_CBYTE:
+        return sizeof(lv_8sc_t);
+    default:
+        return sizeof(gr_complex);
+    }
+}
+
+
+fractional_resampler_sptr make_fractional_resampler(Fractional_Resampler_Method method,
+        Fractional_Resampler_Item item_type, double sample_freq_in, double sample_freq_out,
+        unsigned int taps, double cutoff_ratio)
+{
+    return fractional_resampler_sptr(new fractional_resampler(method, item_type,
+            sample_freq_in, sample_freq_out, taps, cutoff_ratio));
+}
+
+
+fractional_resampler::fractional_resampler(Fractional_Resampler_Method method,
+        Fractional_Resampler_Item item_type, double sample_freq_in, double sample_freq_out,
+        unsigned int taps, double cutoff_ratio) :
+        gr::block("fractional_resampler",
+                gr::io_signature::make(1, 1, fractional_resampler_item_size(item_type)),
+                gr::io_signature::make(1, 1, fractional_resampler_item_size(item_type)))
+{
+    if (!(sample_freq_in > 0.0) || !(sample_freq_out > 0.0))
+        {
+            throw std::invalid_argument("The sampling frequencies of the resampler must be positive");
+        }
+    d_method = method;
+    d_item_type = item_type;
+    d_sample_freq_in = sample_freq_in;
+    d_sample_freq_out = sample_freq_out;
+    d_interpolation = 1;
+    d_decimation = 1;
+    d_next_phase = 0;
+    d_step = sample_freq_in / sample_freq_out;
+    d_mu = 0.0;
+
+    // longer filters when decimating, the transition band is narrower in input samples
+    const unsigned int decimation_ratio = std::max(static_cast<unsigned int>(std::ceil(d_step)), 1u);
+    const double cutoff = std::max(std::min(cutoff_ratio, 1.0), 0.01) * std::min(sample_freq_in, sample_freq_out) / 2.0;
+    taps = std::max(taps, 2u) * decimation_ratio;
+
+    if (method == RESAMPLER_POLYPHASE)
+        {
+            const long long freq_in = std::llround(sample_freq_in);
+            const long long freq_out = std::llround(sample_freq_out);
+            const long long gcd = boost::math::gcd(freq_in, freq_out);
+            if (gcd == 0 || freq_out / gcd > FRACTIONAL_RESAMPLER_MAX_INTERPOLATION)
+                {
+                    throw std::invalid_argument("The polyphase resampler needs fs_out / fs_in = L / M with L <= 1024, use the Farrow resampler");
+                }
+            d_interpolation = freq_out / gcd;
+            d_decimation = freq_in / gcd;
+            design_polyphase(taps, cutoff);
+            d_history = d_phases[0].size() - 1;
+            d_lookahead = 0;
+        }
+    else
+        {
+            design_farrow(taps + (taps % 2), cutoff);
+            d_history = d_polynomial[0].size() - 1;
+            d_lookahead = d_polynomial[0].size() / 2;
+        }
+
+    // the input before the first sample is taken as zero
+    d_next_sample = d_history - d_lookahead;
+    d_samples.assign(d_next_sample, gr_complex(0.0, 0.0));
+
+    set_relative_rate(sample_freq_out / sample_freq_in);
+    DLOG(INFO) << "Resampler from " << sample_freq_in << " to " << sample_freq_out << " Sps with "
+               << d_history + 1 << " taps per output sample";
+}
+
+
+fractional_resampler::~fractional_resampler()
+{}
+
+
+void fractional_resampler::design_polyphase(unsigned int taps, double cutoff)
+{
+    // prototype at L * fs_in, taps per phase
+    const unsigned int length = taps * d_interpolation;
+    const double normalized_cutoff = cutoff / (d_sample_freq_in * d_interpolation);
+    const double center = (length - 1) / 2.0;
+    std::vector<double> prototype(length);
+    double sum = 0.0;
+    for (unsigned int i = 0; i < length; i++)
+        {
+            prototype[i] = windowed_sinc(i - center, normalized_cutoff, length);
+            sum += prototype[i];
+        }
+    // unit gain at DC in each phase
+    d_phases.assign(d_interpolation, std::vector<float>(taps, 0.0));
+    for (unsigned int p = 0; p < d_interpolation; p++)
+        {
+            for (unsigned int j = 0; j < taps; j++)
+                {
+                    d_phases[p][taps - 1 - j] = prototype[p + j * d_interpolation] * d_interpolation / sum;
+                }
+        }
+}
+
+
+void fractional_resampler::design_farrow(unsigned int taps, double cutoff)
+{
+    // The response to the input sample m at the output position n + mu is
+    // h(n + mu - m) = h(mu + j), j = n - m. In each interval of mu it is
+    // interpolated by a cubic through mu = 0, 1/3, 2/3 and 1.
+    const double normalized_cutoff = cutoff / d_sample_freq_in;
+    const int half = taps / 2;
+    double sum = 0.0;
+    for (int j = -half; j < half; j++)
+        {
+            sum += windowed_sinc(j, normalized_cutoff, taps);
+        }
+    d_polynomial.assign(4, std::vector<float>(taps, 0.0));
+    for (unsigned int q = 0; q < taps; q++)
+        {
+            // buffer index q is the sample m = n - half + 1 + q
+            const int j = half - 1 - static_cast<int>(q);
+            double f[4];
+            for (int k = 0; k < 4; k++)
+                {
+                    f[k] = windowed_sinc(j + k / 3.0, normalized_cutoff, taps) / sum;
+                }
+            // Newton forward differences in s = 3 mu
+            const double d1 = f[1] - f[0];
+            const double d2 = f[2] - 2.0 * f[1] + f[0];
+            const double d3 = f[3] - 3.0 * f[2] + 3.0 * f[1] - f[0];
+            d_polynomial[0][q] = f[0];
+            d_polynomial[1][q] = 3.0 * (d1 - d2 / 2.0 + d3 / 3.0);
+            d_polynomial[2][q] = 9.0 * (d2 / 2.0 - d3 / 2.0);
+            d_polynomial[3][q] = 27.0 * (d3 / 6.0);
+        }
+}
+
+
+long fractional_resampler::newest_sample(int k) const
+{
+    if (d_method == RESAMPLER_POLYPHASE)
+        {
+            return d_next_sample + (d_next_phase + static_cast<long>(k) * d_decimation) / d_interpolation;
+        }
+    return d_next_sample + static_cast<long>(std::floor(d_mu + k * d_step)) + d_lookahead;
+}
+
+
+void fractional_resampler::forecast(int noutput_items, gr_vector_int &ninput_items_required)
+{
+    const long needed = newest_sample(noutput_items - 1) + 1 - static_cast<long>(d_samples.size());
+    ninput_items_required[0] = std::max(needed, 0L);
+}
+
+
+int fractional_resampler::general_work(int noutput_items, gr_vector_int &ninput_items,
+        gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
+{
+    GNSS_SDR_TRACE_SCOPE("fractional_resampler::general_work");
+    // convert only the input needed for noutput_items
+    const long needed = newest_sample(noutput_items - 1) + 1 - static_cast<long>(d_samples.size());
+    const int nin = std::min(static_cast<long>(ninput_items[0]), std::max(needed, 0L));
+    const unsigned int first = d_samples.size();
+    d_samples.resize(first + nin);
+    if (nin > 0)
+        {
+            switch (d_item_type)
+            {
+            case RESAMPLER_ITEM_CSHORT:
+                volk_gnsssdr_16ic_convert_32fc(&d_samples[first], static_cast<const lv_16sc_t *>(input_items[0]), nin);
+                break;
+            case RESAMPLER_ITEM_CBYTE:
+                volk_8i_s32f_convert_32f(reinterpret_cast<float *>(&d_samples[first]), static_cast<const int8_t *>(input_items[0]), 1.0, 2 * nin);
+                break;
+            default:
+                std::memcpy(&d_samples[first], input_items[0], nin * sizeof(gr_complex));
+                break;
+            }
+        }
+
+    gr_complex * out = static_cast<gr_complex *>(output_items[0]);
+    if (d_item_type != RESAMPLER_ITEM_GR_COMPLEX)
+        {
+            d_resampled.resize(noutput_items);
+            out = &d_resampled[0];
+        }
+
+    const long buffered = d_samples.size();
+    const unsigned int ntaps = d_history + 1;
+    int nout = 0;
+    lv_32fc_t v[4];
+    while (nout < noutput_items && d_next_sample + static_cast<long>(d_lookahead) < buffered)
+        {
+            const gr_complex * oldest = &d_samples[d_next_sample + d_lookahead - d_history];
+            if (d_method == RESAMPLER_POLYPHASE)
+                {
+                    volk_32fc_32f_dot_prod_32fc(&v[0], oldest, &d_phases[d_next_phase][0], ntaps);
+                    out[nout] = v[0];
+                    d_next_phase += d_decimation;
+                    d_next_sample += d_next_phase / d_interpolation;
+                    d_next_phase %= d_interpolation;
+                }
+            else
+                {
+                    for (int i = 0; i < 4; i++)
+                        {
+                            volk_32fc_32f_dot_prod_32fc(&v[i], oldest, &d_polynomial[i][0], ntaps);
+                        }
+                    const float mu = d_mu;
+                    out[nout] = ((v[3] * mu + v[2]) * mu + v[1]) * mu + v[0];
+                    d_mu += d_step;
+                    const double advance = std::floor(d_mu);
+                    d_next_sample += static_cast<long>(advance);
+                    d_mu -= advance;
+                }
+            nout++;
+        }
+
+    switch (d_item_type)
+    {
+    case RESAMPLER_ITEM_CSHORT:
+        volk_gnsssdr_32fc_convert_16ic(static_cast<lv_16sc_t *>(output_items[0]), out, nout);
+        break;
+    case RESAMPLER_ITEM_CBYTE:
+        volk_gnsssdr_32fc_convert_8ic(static_cast<lv_8sc_t *>(output_items[0]), out, nout);
+        break;
+    default:
+        break;
+    }
+
+    // keep the history of the next output (and anything after it)
+    const long used = std::min(d_next_sample + static_cast<long>(d_lookahead) - static_cast<long>(d_history), buffered);
+    if (used > 0)
+        {
+            d_samples.erase(d_samples.begin(), d_samples.begin() + used);
+            d_next_sample -= used;
+        }
+
+    consume_each(nin);
+    return nout;
+}
@@ -0,0 +1,153 @@
+/*!
+ * \file fractional_resampler.h
+ * \brief Filtered resampler of complex samples, polyphase for rational
+ * ratios and Farrow for arbitrary ones.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Unlike the direct resamplers, which pick the nearest input sample and
+ * fold all the spectrum above the new Nyquist frequency onto the signal,
+ * these resamplers low-pass filter the signal at the same time:
+ *
+ * - Polyphase: fs_out / fs_in = L / M with small integers. The windowed-sinc
+ *   prototype filter is designed at L * fs_in and split in L phases, and
+ *   each output sample is the dot product of one phase with the input.
+ * - Farrow: any ratio. The windowed-sinc impulse response is approximated
+ *   by a cubic polynomial in the fractional delay mu between input samples,
+ *   so each output is four dot products with the input combined as
+ *   ((v3 mu + v2) mu + v1) mu + v0.
+ *
+ * The dot products are computed with VOLK. The cshort and cbyte samples
+ * are converted to float internally, in a buffer that holds just the
+ * history of the filter and the input of one call.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_FRACTIONAL_RESAMPLER_H
+#define GNSS_SDR_FRACTIONAL_RESAMPLER_H
+
+#include <vector>
+#include <gnuradio/block.h>
+#include <gnuradio/gr_complex.h>
+
+/*!
+ * \brief Sample formats of fractional_resampler
+ */
+enum Fractional_Resampler_Item
+{
+    RESAMPLER_ITEM_GR_COMPLEX = 0, //!< gr_complex
+    RESAMPLER_ITEM_CSHORT = 1,     //!< lv_16sc_t
+    RESAMPLER_ITEM_CBYTE = 2       //!< lv_8sc_t
+};
+
+/*!
+ * \brief Interpolation structures of fractional_resampler
+ */
+enum Fractional_Resampler_Method
+{
+    RESAMPLER_POLYPHASE = 0,
+    RESAMPLER_FARROW = 1
+};
+
+class fractional_resampler;
+
+typedef boost::shared_ptr<fractional_resampler> fractional_resampler_sptr;
+
+/*!
+ * \brief Makes a fractional_resampler.
+ *
+ * The pass band ends at cutoff_ratio times half the lower of the two
+ * sampling frequencies. The filter spans taps input samples, times the
+ * decimation ratio when fs_out < fs_in. The polyphase method needs fs_out / fs_in = L / M with
+ * L <= 1024 (both frequencies in whole Hz); otherwise it throws
+ * std::invalid_argument.
+ */
+fractional_resampler_sptr make_fractional_resampler(Fractional_Resampler_Method method,
+        Fractional_Resampler_Item item_type, double sample_freq_in, double sample_freq_out,
+        unsigned int taps, double cutoff_ratio);
+
+//! Size in bytes of the samples of each format
+size_t fractional_resampler_item_size(Fractional_Resampler_Item item_type);
+
+class fractional_resampler: public gr::block
+{
+private:
+    friend fractional_resampler_sptr make_fractional_resampler(Fractional_Resampler_Method method,
+            Fractional_Resampler_Item item_type, double sample_freq_in, double sample_freq_out,
+            unsigned int taps, double cutoff_ratio);
+
+    fractional_resampler(Fractional_Resampler_Method method,
+            Fractional_Resampler_Item item_type, double sample_freq_in, double sample_freq_out,
+            unsigned int taps, double cutoff_ratio);
+
+    void design_polyphase(unsigned int taps, double cutoff);
+    void design_farrow(unsigned int taps, double cutoff);
+
+    // Buffer index of the newest input sample used by the k-th next output
+    long newest_sample(int k) const;
+
+    Fractional_Resampler_Method d_method;
+    Fractional_Resampler_Item d_item_type;
+    double d_sample_freq_in;
+    double d_sample_freq_out;
+    unsigned int d_history;                    // samples before the newest one used by each output
+    unsigned int d_lookahead;                  // samples after the one of the output position
+
+    // polyphase: output k is at input n_k + p_k / L, p_k < L
+    unsigned int d_interpolation;              // L
+    unsigned int d_decimation;                 // M
+    std::vector<std::vector<float> > d_phases; // time reversed
+    long d_next_sample;                        // n of the next output, buffer index
+    unsigned int d_next_phase;                 // p of the next output
+
+    // Farrow: output at input sample n + mu, 0 <= mu < 1
+    double d_step;                             // fs_in / fs_out
+    double d_mu;
+    std::vector<std::vector<float> > d_polynomial; // coefficients of mu^0 to mu^3, in buffer order
+
+    std::vector<gr_complex> d_samples;         // input not used yet and history, the oldest first
+    std::vector<gr_complex> d_resampled;
+
+public:
+    ~fractional_resampler();
+
+    double sample_freq_in() const
+    {
+        return d_sample_freq_in;
+    }
+
+    double sample_freq_out() const
+    {
+        return d_sample_freq_out;
+    }
+
+    void forecast(int noutput_items, gr_vector_int &ninput_items_required);
+
+    int general_work(int noutput_items, gr_vector_int &ninput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif
@@ -36,6 +36,7 @@
 #include "Galileo_E1.h"
 #include "GPS_L1_CA.h"
 #include "Galileo_E5a.h"
+#include "gnss_scenario.h"
 
 
 using google::LogMessage;
@@ -59,12 +60,20 @@ SignalGenerator::SignalGenerator(ConfigurationInterface* configuration,
     bool noise_flag = configuration->property("SignalSource.noise_flag", false);
     float BW_BB = configuration->property("SignalSource.BW_BB", 1.0);
     unsigned int num_satellites = configuration->property("SignalSource.num_satellites", 1);
+    unsigned int threads = configuration->property("SignalSource.threads", 1);
+
+    // Scenario mode: delays and Dopplers from a receiver trajectory and the ephemeris
+    std::string trajectory_file = configuration->property("SignalSource.trajectory_file", std::string(""));
+    std::string gps_ephemeris_xml = configuration->property("SignalSource.gps_ephemeris_xml", std::string(""));
+    std::string gal_ephemeris_xml = configuration->property("SignalSource.gal_ephemeris_xml", std::string(""));
+    double start_tow_s = configuration->property("SignalSource.start_tow_s", -1.0);
 
     std::vector<std::string> signal1;
     std::vector<std::string> system;
     std::vector<unsigned int> PRN;
     std::vector<float> CN0_dB;
     std::vector<float> doppler_Hz;
+    std::vector<float> doppler_rate_Hz_s;
     std::vector<unsigned int> delay_chips;
     std::vector<unsigned int> delay_sec;
 
@@ -76,6 +85,7 @@ SignalGenerator::SignalGenerator(ConfigurationInterface* configuration,
             PRN.push_back(configuration->property("SignalSource.PRN_" + sat, 1));
             CN0_dB.push_back(configuration->property("SignalSource.CN0_dB_" + sat, 10));
             doppler_Hz.push_back(configuration->property("SignalSource.doppler_Hz_" + sat, 0));
+            doppler_rate_Hz_s.push_back(configuration->property("SignalSource.doppler_rate_Hz_s_" + sat, 0.0));
             delay_chips.push_back(configuration->property("SignalSource.delay_chips_" + sat, 0));
             delay_sec.push_back(configuration->property("SignalSource.delay_sec_" + sat, 0));
         }
@@ -107,8 +117,21 @@ SignalGenerator::SignalGenerator(ConfigurationInterface* configuration,
         {
             item_size_ = sizeof(gr_complex);
             DLOG(INFO) << "Item size " << item_size_;
-            gen_source_ = signal_make_generator_c(signal1, system, PRN, CN0_dB, doppler_Hz, delay_chips, delay_sec,
+            signal_generator_c_sptr generator = signal_make_generator_c(signal1, system, PRN, CN0_dB, doppler_Hz, delay_chips, delay_sec,
                     data_flag, noise_flag, fs_in, vector_length, BW_BB);
+            generator->set_doppler_rate(doppler_rate_Hz_s);
+            generator->set_threads(threads);
+            if (!trajectory_file.empty())
+                {
+                    std::shared_ptr<Gnss_Scenario> scenario = std::make_shared<Gnss_Scenario>();
+                    if (start_tow_s >= 0.0) scenario->set_start_tow(start_tow_s);
+                    scenario->load_trajectory(trajectory_file);
+                    if (!gps_ephemeris_xml.empty()) scenario->load_gps_ephemeris_xml(gps_ephemeris_xml);
+                    if (!gal_ephemeris_xml.empty()) scenario->load_galileo_ephemeris_xml(gal_ephemeris_xml);
+                    generator->set_scenario(scenario);
+                    LOG(INFO) << "Scenario from " << trajectory_file << " starting at TOW " << scenario->start_tow() << " s";
+                }
+            gen_source_ = generator;
 
             vector_to_stream_ = gr::blocks::vector_to_stream::make(item_size_, vector_length);
 
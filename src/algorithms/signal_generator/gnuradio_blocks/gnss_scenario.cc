@@ -0,0 +1,213 @@
+/*!
+ * \file gnss_scenario.cc
+ * \brief Receiver trajectory and satellite ephemeris of a generated scene
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_scenario.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <boost/archive/xml_iarchive.hpp>
+#include <boost/serialization/map.hpp>
+#include <glog/logging.h>
+#include "GPS_L1_CA.h"
+#include "gps_navigation_message_encoder.h"
+
+
+Gnss_Scenario::Gnss_Scenario() :
+        d_start_tow(0.0),
+        d_start_tow_set(false)
+{}
+
+
+bool Gnss_Scenario::load_trajectory(const std::string & file_name)
+{
+    std::ifstream ifs(file_name.c_str());
+    if (!ifs.is_open())
+        {
+            LOG(WARNING) << "Unable to open the trajectory file " << file_name;
+            return false;
+        }
+    d_t.clear();
+    d_x.clear();
+    d_y.clear();
+    d_z.clear();
+    std::string line;
+    while (std::getline(ifs, line))
+        {
+            if (line.empty() || line[0] == '#') continue;
+            std::istringstream fields(line);
+            double t, x, y, z;
+            if (!(fields >> t >> x >> y >> z) || (!d_t.empty() && t <= d_t.back()))
+                {
+                    LOG(WARNING) << "Wrong trajectory line in " << file_name << ": " << line;
+                    return false;
+                }
+            d_t.push_back(t);
+            d_x.push_back(x);
+            d_y.push_back(y);
+            d_z.push_back(z);
+        }
+    LOG(INFO) << "Loaded a trajectory of " << d_t.size() << " epochs from " << file_name;
+    return !d_t.empty();
+}
+
+
+bool Gnss_Scenario::load_gps_ephemeris_xml(const std::string & file_name)
+{
+    try
+    {
+            std::ifstream ifs(file_name.c_str(), std::ifstream::binary | std::ifstream::in);
+            boost::archive::xml_iarchive xml(ifs);
+            d_gps_ephemeris.clear();
+            xml >> boost::serialization::make_nvp("GNSS-SDR_ephemeris_map", d_gps_ephemeris);
+            LOG(INFO) << "Loaded GPS ephemeris of " << d_gps_ephemeris.size() << " satellites";
+    }
+    catch (std::exception& e)
+    {
+            LOG(WARNING) << e.what() << " File: " << file_name;
+            return false;
+    }
+    if (!d_start_tow_set && !d_gps_ephemeris.empty())
+        {
+            d_start_tow = d_gps_ephemeris.begin()->second.d_Toe;
+        }
+    return true;
+}
+
+
+bool Gnss_Scenario::load_galileo_ephemeris_xml(const std::string & file_name)
+{
+    try
+    {
+            std::ifstream ifs(file_name.c_str(), std::ifstream::binary | std::ifstream::in);
+            boost::archive::xml_iarchive xml(ifs);
+            d_galileo_ephemeris.clear();
+            xml >> boost::serialization::make_nvp("GNSS-SDR_ephemeris_map", d_galileo_ephemeris);
+            LOG(INFO) << "Loaded Galileo ephemeris of " << d_galileo_ephemeris.size() << " satellites";
+    }
+    catch (std::exception& e)
+    {
+            LOG(WARNING) << e.what() << " File: " << file_name;
+            return false;
+    }
+    if (!d_start_tow_set && d_gps_ephemeris.empty() && !d_galileo_ephemeris.empty())
+        {
+            d_start_tow = d_galileo_ephemeris.begin()->second.t0e_1;
+        }
+    return true;
+}
+
+
+void Gnss_Scenario::set_start_tow(double tow_s)
+{
+    d_start_tow = tow_s;
+    d_start_tow_set = true;
+}
+
+
+double Gnss_Scenario::start_tow() const
+{
+    return d_start_tow;
+}
+
+
+bool Gnss_Scenario::has_satellite(const std::string & system, unsigned int prn) const
+{
+    if (system == "G") return d_gps_ephemeris.count(prn) > 0;
+    if (system == "E") return d_galileo_ephemeris.count(prn) > 0;
+    return false;
+}
+
+
+void Gnss_Scenario::receiver_position(double t, double position[3]) const
+{
+    if (d_t.empty())
+        {
+            position[0] = position[1] = position[2] = 0.0;
+            return;
+        }
+    unsigned int i = 0;
+    while (i + 2 < d_t.size() && t > d_t[i + 1]) i++;
+    double a = 0.0;
+    if (i + 1 < d_t.size())
+        {
+            a = std::min(std::max((t - d_t[i]) / (d_t[i + 1] - d_t[i]), 0.0), 1.0);
+        }
+    const unsigned int j = std::min(i + 1, static_cast<unsigned int>(d_t.size() - 1));
+    position[0] = d_x[i] + a * (d_x[j] - d_x[i]);
+    position[1] = d_y[i] + a * (d_y[j] - d_y[i]);
+    position[2] = d_z[i] + a * (d_z[j] - d_z[i]);
+}
+
+
+double Gnss_Scenario::delay(const std::string & system, unsigned int prn, double t) const
+{
+    double receiver[3];
+    receiver_position(t, receiver);
+    const double receive_time = d_start_tow + t;
+
+    double traveltime = GPS_STARTOFFSET_ms / 1000.0;
+    double clock_bias = 0.0;
+    for (int iter = 0; iter < 4; iter++)
+        {
+            const double transmit_time = receive_time - traveltime;
+            double sat[3];
+            if (system == "G")
+                {
+                    Gps_Ephemeris eph = d_gps_ephemeris.at(prn);
+                    eph.satellitePosition(transmit_time);
+                    clock_bias = eph.sv_clock_drift(transmit_time);
+                    sat[0] = eph.d_satpos_X; sat[1] = eph.d_satpos_Y; sat[2] = eph.d_satpos_Z;
+                }
+            else
+                {
+                    Galileo_Ephemeris eph = d_galileo_ephemeris.at(prn);
+                    eph.satellitePosition(transmit_time);
+                    clock_bias = eph.sv_clock_drift(transmit_time);
+                    sat[0] = eph.d_satpos_X; sat[1] = eph.d_satpos_Y; sat[2] = eph.d_satpos_Z;
+                }
+            // The ECEF frame rotates while the signal travels
+            const double omegatau = OMEGA_EARTH_DOT * traveltime;
+            const double x = std::cos(omegatau) * sat[0] + std::sin(omegatau) * sat[1];
+            const double y = -std::sin(omegatau) * sat[0] + std::cos(omegatau) * sat[1];
+            const double dx = x - receiver[0];
+            const double dy = y - receiver[1];
+            const double dz = sat[2] - receiver[2];
+            traveltime = std::sqrt(dx * dx + dy * dy + dz * dz) / GPS_C_m_s;
+        }
+    return traveltime - clock_bias;
+}
+
+
+void Gnss_Scenario::gps_subframe(unsigned int prn, long int subframe_count, unsigned int words[10]) const
+{
+    Gps_Navigation_Message_Encoder encoder(d_gps_ephemeris.at(prn));
+    encoder.subframe(subframe_count, words);
+}
@@ -0,0 +1,95 @@
+/*!
+ * \file gnss_scenario.h
+ * \brief Receiver trajectory and satellite ephemeris of a generated scene
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The trajectory is a text file with one "t x y z" line per epoch: the time
+ * from the first sample [s] and the ECEF position of the receiver [m], with
+ * lines starting with # ignored. The position is interpolated linearly
+ * between the epochs, and held before the first and after the last one.
+ * The ephemeris are the XML files written by the PVT blocks, a map of
+ * Gps_Ephemeris or Galileo_Ephemeris by PRN.
+ *
+ * The propagation delays account for the geometric range, the rotation of
+ * the Earth during the propagation and the satellite clock, but not for the
+ * ionosphere nor the troposphere. The receiver clock is ideal.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SCENARIO_H_
+#define GNSS_SDR_GNSS_SCENARIO_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include "gps_ephemeris.h"
+#include "galileo_ephemeris.h"
+
+/*!
+ * \brief Propagation delays and GPS NAV message of the satellites seen from
+ * a receiver trajectory
+ */
+class Gnss_Scenario
+{
+public:
+    Gnss_Scenario();
+
+    bool load_trajectory(const std::string & file_name);
+    bool load_gps_ephemeris_xml(const std::string & file_name);
+    bool load_galileo_ephemeris_xml(const std::string & file_name);
+
+    //! GPS time of week of the first sample [s]. By default, the toe of the first ephemeris
+    void set_start_tow(double tow_s);
+    double start_tow() const;
+
+    //! True if there are ephemeris for satellite \p prn of system \p system, "G" or "E"
+    bool has_satellite(const std::string & system, unsigned int prn) const;
+
+    //! Receiver position [m] at \p t seconds from the first sample
+    void receiver_position(double t, double position[3]) const;
+
+    /*!
+     * \brief Difference [s] between the time at which the receiver gets, \p t
+     * seconds after the first sample, the signal of a satellite and the time
+     * of transmission read on the satellite clock
+     */
+    double delay(const std::string & system, unsigned int prn, double t) const;
+
+    //! Transmitted words of a GPS NAV subframe, see Gps_Navigation_Message_Encoder::subframe
+    void gps_subframe(unsigned int prn, long int subframe_count, unsigned int words[10]) const;
+
+private:
+    std::vector<double> d_t;
+    std::vector<double> d_x;
+    std::vector<double> d_y;
+    std::vector<double> d_z;
+    std::map<int, Gps_Ephemeris> d_gps_ephemeris;
+    std::map<int, Galileo_Ephemeris> d_galileo_ephemeris;
+    double d_start_tow;
+    bool d_start_tow_set;
+};
+
+#endif /* GNSS_SDR_GNSS_SCENARIO_H_ */
@@ -29,10 +29,14 @@
 */
 
 #include "signal_generator_c.h"
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <thread>
 #include <gnuradio/io_signature.h>
+#include <glog/logging.h>
 #include <volk/volk.h>
 #include <volk_gnsssdr/volk_gnsssdr.h>
 #include "gps_sdr_signal_processing.h"
@@ -41,6 +45,32 @@
 #include "Galileo_E1.h"
 #include "Galileo_E5a.h"
 #include "GPS_L1_CA.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
+
+// Number of entries of the noise table (a power of 2)
+static const unsigned int noise_table_size = 1 << 16;
+
+// xorshift64*: good enough for the noise table indices and the data bits,
+// and much cheaper than a Gaussian draw per sample
+static inline unsigned long long signal_generator_random(unsigned long long &state)
+{
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ULL;
+}
+
+// Pseudorandom symbol of a Galileo satellite, a function of its index only
+// so that the scene does not depend on how it is split into vectors
+static inline float signal_generator_galileo_symbol(unsigned int prn, long int symbol)
+{
+    unsigned long long z = (static_cast<unsigned long long>(symbol) << 6) + prn + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return (z >> 63) == 0 ? 1.0 : -1.0;
+}
 
 /*
 * Create a new instance of signal_generator_c and return
@@ -70,6 +100,7 @@ signal_generator_c::signal_generator_c (std::vector<std::string> signal1, std::v
                   PRN_(PRN),
                   CN0_dB_(CN0_dB),
                   doppler_Hz_(doppler_Hz),
+                  doppler_rate_Hz_s_(PRN.size(), 0.0),
                   delay_chips_(delay_chips),
                   delay_sec_(delay_sec),
                   data_flag_(data_flag),
@@ -86,8 +117,7 @@ signal_generator_c::signal_generator_c (std::vector<std::string> signal1, std::v
 void signal_generator_c::init()
 {
     work_counter_ = 0;
-
-    complex_phase_ = static_cast<gr_complex*>(volk_malloc(vector_length_ * sizeof(gr_complex), volk_get_alignment()));
+    threads_ = 1;
 
     // True if Galileo satellites are present
     bool galileo_signal = std::find(system_.begin(), system_.end(), "E") != system_.end();
@@ -100,6 +130,9 @@ void signal_generator_c::init()
             ms_counter_.push_back(0);
             data_modulation_.push_back((Galileo_E5a_I_SECONDARY_CODE.at(0) == '0' ? 1 : -1));
             pilot_modulation_.push_back((Galileo_E5a_Q_SECONDARY_CODE[PRN_[sat]].at(0) == '0' ? 1 : -1));
+            carrier_phase_.push_back(gr_complex(1, 0));
+            carrier_phase_inc_.push_back(gr_complex(1, 0));
+            data_bit_state_.push_back(0x9E3779B97F4A7C15ULL * (sat + 1) + rand());
 
             if (system_[sat] == "G")
                 {
@@ -131,6 +164,47 @@ void signal_generator_c::init()
                 }
         }
     random_ = new gr::random();
+
+    scratch_length_ = samples_per_code_.empty() ? 0 : *std::max_element(samples_per_code_.begin(), samples_per_code_.end());
+    allocate_buffers();
+
+    if (noise_flag_)
+        {
+            noise_table_.resize(noise_table_size);
+            for (unsigned int i = 0; i < noise_table_size; i++)
+                {
+                    noise_table_[i] = gr_complex(random_->gasdev(), random_->gasdev());
+                }
+        }
+    noise_state_ = 0x2545F4914F6CDD1DULL + rand();
+}
+
+
+void signal_generator_c::allocate_buffers()
+{
+    for (unsigned int t = 1; t < threads_; t++)
+        {
+            thread_out_.push_back(static_cast<gr_complex*>(gnss_sdr_volk_malloc(vector_length_ * sizeof(gr_complex), volk_get_alignment())));
+        }
+    for (unsigned int i = 0; i < 2 * threads_; i++)
+        {
+            scratch_.push_back(static_cast<gr_complex*>(gnss_sdr_volk_malloc(scratch_length_ * sizeof(gr_complex), volk_get_alignment())));
+        }
+}
+
+
+void signal_generator_c::free_buffers()
+{
+    for (unsigned int i = 0; i < thread_out_.size(); i++)
+        {
+            gnss_sdr_volk_free(thread_out_[i]);
+        }
+    for (unsigned int i = 0; i < scratch_.size(); i++)
+        {
+            gnss_sdr_volk_free(scratch_[i]);
+        }
+    thread_out_.clear();
+    scratch_.clear();
 }
 
 
@@ -234,6 +308,78 @@ void signal_generator_c::generate_codes()
 
 
 
+void signal_generator_c::set_doppler_rate(const std::vector<float> &doppler_rate_Hz_s)
+{
+    for (unsigned int sat = 0; sat < std::min(num_sats_, static_cast<unsigned int>(doppler_rate_Hz_s.size())); sat++)
+        {
+            doppler_rate_Hz_s_[sat] = doppler_rate_Hz_s[sat];
+        }
+}
+
+
+void signal_generator_c::set_threads(unsigned int threads)
+{
+    free_buffers();
+    threads_ = std::max(1u, std::min(threads, num_sats_));
+    allocate_buffers();
+}
+
+
+void signal_generator_c::set_scenario(std::shared_ptr<Gnss_Scenario> scenario)
+{
+    scenario_ = scenario;
+    scenario_code_.assign(num_sats_, std::vector<gr_complex>());
+    gps_subframe_count_.assign(num_sats_, -1);
+    gps_subframe_words_.assign(10 * num_sats_, 0);
+    for (unsigned int sat = 0; sat < num_sats_; sat++)
+        {
+            if (!scenario_->has_satellite(system_[sat], PRN_[sat]))
+                {
+                    LOG(WARNING) << "No ephemeris for satellite " << system_[sat] << " " << PRN_[sat] << ", it is not generated";
+                    continue;
+                }
+            std::vector<gr_complex>& code = scenario_code_[sat];
+            // Same amplitudes as the codes of the static scene
+            float amplitude = 1.0;
+            if (system_[sat] == "G")
+                {
+                    code.resize(static_cast<unsigned int>(GPS_L1_CA_CODE_LENGTH_CHIPS));
+                    gps_l1_ca_code_gen_complex(&code[0], PRN_[sat], 0);
+                    if (noise_flag_) amplitude = sqrt(pow(10, CN0_dB_[sat] / 10) / BW_BB_);
+                }
+            else if (signal_[sat].at(0) == '5')
+                {
+                    char signal[3];
+                    strcpy(signal, "5X");
+                    code.resize(static_cast<unsigned int>(Galileo_E5a_CODE_LENGTH_CHIPS));
+                    galileo_e5_a_code_gen_complex_primary(&code[0], PRN_[sat], signal);
+                    if (noise_flag_) amplitude = sqrt(pow(10, CN0_dB_[sat] / 10) / BW_BB_ / 2);
+                }
+            else
+                {
+                    const unsigned int samples = 12 * static_cast<unsigned int>(Galileo_E1_B_CODE_LENGTH_CHIPS);
+                    const int fs = 12 * static_cast<int>(Galileo_E1_CODE_CHIP_RATE_HZ);
+                    std::vector<gr_complex> pilot(samples);
+                    char signal[3];
+                    code.resize(samples);
+                    strcpy(signal, "1B");
+                    galileo_e1_code_gen_complex_sampled(&code[0], signal, true, PRN_[sat], fs, 0);
+                    strcpy(signal, "1C");
+                    galileo_e1_code_gen_complex_sampled(&pilot[0], signal, true, PRN_[sat], fs, 0);
+                    for (unsigned int i = 0; i < samples; i++)
+                        {
+                            code[i] = gr_complex(code[i].real(), pilot[i].real());
+                        }
+                    if (noise_flag_) amplitude = sqrt(pow(10, CN0_dB_[sat] / 10) / BW_BB_ / 2);
+                }
+            for (unsigned int i = 0; i < code.size(); i++)
+                {
+                    code[i] *= amplitude;
+                }
+        }
+}
+
+
 signal_generator_c::~signal_generator_c()
 {
     /*  for (unsigned int sat = 0; sat < num_sats_; sat++)
@@ -244,147 +390,297 @@ signal_generator_c::~signal_generator_c()
                     std::free(sampled_code_pilot_[sat]);
                 }
         } */
-    volk_free(complex_phase_);
+    free_buffers();
     delete random_;
 }
 
 
-int signal_generator_c::general_work (int noutput_items __attribute__((unused)),
-        gr_vector_int &ninput_items __attribute__((unused)),
-        gr_vector_const_void_star &input_items __attribute__((unused)),
-        gr_vector_void_star &output_items)
+void signal_generator_c::add_rotated(gr_complex* out, const gr_complex* in, gr_complex* scratch, unsigned int length,
+        float sign, gr_complex& phase, gr_complex phase_inc)
 {
-    gr_complex *out = (gr_complex *) output_items[0];
+    if (length == 0) return;
+    // The sign of the data bit goes into the NCO phase, and out of it again
+    phase *= sign;
+    volk_32fc_s32fc_x2_rotator_32fc(scratch, in, phase_inc, &phase, length);
+    phase *= sign;
+    volk_32f_x2_add_32f(reinterpret_cast<float*>(out), reinterpret_cast<float*>(out), reinterpret_cast<float*>(scratch), 2 * length);
+}
 
-    work_counter_++;
 
+void signal_generator_c::add_satellite(unsigned int sat, gr_complex* out, gr_complex* scratch, gr_complex* scratch2)
+{
+    float phase_step_rad = -static_cast<float>(GPS_TWO_PI) * doppler_Hz_[sat] / static_cast<float>(fs_in_);
+    carrier_phase_[sat] = gr_complex(std::cos(-start_phase_rad_[sat]), std::sin(-start_phase_rad_[sat]));
+    carrier_phase_inc_[sat] = gr_complex(std::cos(-phase_step_rad), std::sin(-phase_step_rad));
+    start_phase_rad_[sat] += vector_length_ * phase_step_rad;
+    doppler_Hz_[sat] += doppler_rate_Hz_s_[sat] * static_cast<float>(vector_length_) / static_cast<float>(fs_in_);
+
+    gr_complex& phase = carrier_phase_[sat];
+    const gr_complex phase_inc = carrier_phase_inc_[sat];
     unsigned int out_idx = 0;
-    unsigned int i = 0;
-    unsigned int k = 0;
 
-    for (out_idx = 0; out_idx < vector_length_; out_idx++)
+    if (system_[sat] == "G")
         {
-            out[out_idx] = gr_complex(0.0,0.0);
-        }
-
-    for (unsigned int sat = 0; sat < num_sats_; sat++)
-        {
-            float phase_step_rad = -static_cast<float>(GPS_TWO_PI) * doppler_Hz_[sat] / static_cast<float>(fs_in_);
-            float _phase[1];
-            _phase[0] = -start_phase_rad_[sat];
-            volk_gnsssdr_s32f_sincos_32fc(complex_phase_, -phase_step_rad, _phase, vector_length_);
-            start_phase_rad_[sat] += vector_length_ * phase_step_rad;
-
-            out_idx = 0;
+            unsigned int delay_samples = (delay_chips_[sat] % static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS))
+                                         * samples_per_code_[sat] / GPS_L1_CA_CODE_LENGTH_CHIPS;
 
-            if (system_[sat] == "G")
+            for (unsigned int i = 0; i < num_of_codes_per_vector_[sat]; i++)
                 {
-                    unsigned int delay_samples = (delay_chips_[sat] % static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS))
-                                                            * samples_per_code_[sat] / GPS_L1_CA_CODE_LENGTH_CHIPS;
+                    add_rotated(&out[out_idx], &sampled_code_data_[sat][out_idx], scratch, delay_samples,
+                            current_data_bits_[sat].real(), phase, phase_inc);
+                    out_idx += delay_samples;
 
-                    for (i = 0; i < num_of_codes_per_vector_[sat]; i++)
+                    if (ms_counter_[sat] == 0 && data_flag_)
                         {
-                            for (k = 0; k < delay_samples; k++)
-                                {
-                                    out[out_idx] += sampled_code_data_[sat][out_idx]
-                                                                            * current_data_bits_[sat]
-                                                                                                 * complex_phase_[out_idx];
-                                    out_idx++;
-                                }
-
-                            if (ms_counter_[sat] == 0 && data_flag_)
-                                {
-                                    // New random data bit
-                                    current_data_bits_[sat] = gr_complex((rand() % 2) == 0 ? 1 : -1, 0);
-                                }
+                            // New random data bit
+                            current_data_bits_[sat] = gr_complex((signal_generator_random(data_bit_state_[sat]) >> 63) == 0 ? 1 : -1, 0);
+                        }
 
-                            for (k = delay_samples; k < samples_per_code_[sat]; k++)
-                                {
-                                    out[out_idx] += sampled_code_data_[sat][out_idx]
-                                                                            * current_data_bits_[sat]
-                                                                                                 * complex_phase_[out_idx];
-                                    out_idx++;
-                                }
+                    add_rotated(&out[out_idx], &sampled_code_data_[sat][out_idx], scratch, samples_per_code_[sat] - delay_samples,
+                            current_data_bits_[sat].real(), phase, phase_inc);
+                    out_idx += samples_per_code_[sat] - delay_samples;
 
-                            ms_counter_[sat] = (ms_counter_[sat] + static_cast<int>(round(1e3*GPS_L1_CA_CODE_PERIOD)))
-                                                        % data_bit_duration_ms_[sat];
-                        }
+                    ms_counter_[sat] = (ms_counter_[sat] + static_cast<int>(round(1e3*GPS_L1_CA_CODE_PERIOD)))
+                                       % data_bit_duration_ms_[sat];
                 }
+        }
 
-            else if (system_[sat] == "E")
+    else if (system_[sat] == "E")
+        {
+            if(signal_[sat].at(0)=='5')
                 {
-                    if(signal_[sat].at(0)=='5')
+                    // EACH WORK outputs 1 modulated primary code
+                    int codelen = static_cast<int>(Galileo_E5a_CODE_LENGTH_CHIPS);
+                    unsigned int delay_samples = (delay_chips_[sat] % codelen)
+                                                 * samples_per_code_[sat] / codelen;
+                    for (unsigned int segment = 0; segment < 2; segment++)
                         {
-                            // EACH WORK outputs 1 modulated primary code
-                            int codelen = static_cast<int>(Galileo_E5a_CODE_LENGTH_CHIPS);
-                            unsigned int delay_samples = (delay_chips_[sat] % codelen)
-                                                  * samples_per_code_[sat] / codelen;
-                            for (k = 0; k < delay_samples; k++)
+                            const unsigned int length = segment == 0 ? delay_samples : samples_per_code_[sat] - delay_samples;
+                            // (I * data + j Q * pilot) is data * code if both
+                            // modulations are equal, and data * conj(code) if not
+                            const gr_complex* code = &sampled_code_data_[sat][out_idx];
+                            if (data_modulation_[sat] != pilot_modulation_[sat])
                                 {
-                                    out[out_idx] += (gr_complex(sampled_code_data_[sat][out_idx].real()*data_modulation_[sat],
-                                            sampled_code_data_[sat][out_idx].imag()*pilot_modulation_[sat]) )
-                                            * complex_phase_[out_idx];
-                                    out_idx++;
+                                    volk_32fc_conjugate_32fc(scratch2, code, length);
+                                    code = scratch2;
                                 }
+                            add_rotated(&out[out_idx], code, scratch, length, data_modulation_[sat], phase, phase_inc);
+                            out_idx += length;
 
-                            if (ms_counter_[sat]%data_bit_duration_ms_[sat] == 0 && data_flag_)
+                            if (segment == 0)
                                 {
-                                    // New random data bit
-                                    current_data_bit_int_[sat] = (rand()%2) == 0 ? 1 : -1;
-                                }
-                            data_modulation_[sat] = current_data_bit_int_[sat] * (Galileo_E5a_I_SECONDARY_CODE.at((ms_counter_[sat]+delay_sec_[sat]) % 20) == '0' ? 1 : -1);
-                            pilot_modulation_[sat] = (Galileo_E5a_Q_SECONDARY_CODE[PRN_[sat] - 1].at((ms_counter_[sat] + delay_sec_[sat]) % 100) == '0' ? 1 : -1);
-
-                            ms_counter_[sat] = ms_counter_[sat] + static_cast<int>(round(1e3*GALILEO_E5a_CODE_PERIOD));
+                                    if (ms_counter_[sat]%data_bit_duration_ms_[sat] == 0 && data_flag_)
+                                        {
+                                            // New random data bit
+                                            current_data_bit_int_[sat] = (signal_generator_random(data_bit_state_[sat]) >> 63) == 0 ? 1 : -1;
+                                        }
+                                    data_modulation_[sat] = current_data_bit_int_[sat] * (Galileo_E5a_I_SECONDARY_CODE.at((ms_counter_[sat]+delay_sec_[sat]) % 20) == '0' ? 1 : -1);
+                                    pilot_modulation_[sat] = (Galileo_E5a_Q_SECONDARY_CODE[PRN_[sat] - 1].at((ms_counter_[sat] + delay_sec_[sat]) % 100) == '0' ? 1 : -1);
 
-                            for (k = delay_samples; k < samples_per_code_[sat]; k++)
-                                {
-                                    out[out_idx] += (gr_complex(sampled_code_data_[sat][out_idx].real() * data_modulation_[sat] ,
-                                            sampled_code_data_[sat][out_idx].imag() * pilot_modulation_[sat]) )
-                                            * complex_phase_[out_idx];
-                                    out_idx++;
+                                    ms_counter_[sat] = ms_counter_[sat] + static_cast<int>(round(1e3*GALILEO_E5a_CODE_PERIOD));
                                 }
                         }
-                    else
-                        {
-                            unsigned int delay_samples = (delay_chips_[sat] % static_cast<int>(Galileo_E1_B_CODE_LENGTH_CHIPS))
-                                                  * samples_per_code_[sat] / Galileo_E1_B_CODE_LENGTH_CHIPS;
+                }
+            else
+                {
+                    unsigned int delay_samples = (delay_chips_[sat] % static_cast<int>(Galileo_E1_B_CODE_LENGTH_CHIPS))
+                                                 * samples_per_code_[sat] / Galileo_E1_B_CODE_LENGTH_CHIPS;
 
-                            for (i = 0; i < num_of_codes_per_vector_[sat]; i++)
+                    for (unsigned int i = 0; i < num_of_codes_per_vector_[sat]; i++)
+                        {
+                            for (unsigned int segment = 0; segment < 2; segment++)
                                 {
-                                    for (k = 0; k < delay_samples; k++)
+                                    const unsigned int length = segment == 0 ? delay_samples : samples_per_code_[sat] - delay_samples;
+                                    // data * bit - pilot, that is data - pilot or -(data + pilot)
+                                    const float bit = current_data_bits_[sat].real();
+                                    float* data = reinterpret_cast<float*>(&sampled_code_data_[sat][out_idx]);
+                                    float* pilot = reinterpret_cast<float*>(&sampled_code_pilot_[sat][out_idx]);
+                                    if (bit > 0)
                                         {
-                                            out[out_idx] += (sampled_code_data_[sat][out_idx] * current_data_bits_[sat]
-                                                                                                                   - sampled_code_pilot_[sat][out_idx]) * complex_phase_[out_idx];
-                                            out_idx++;
+                                            volk_32f_x2_subtract_32f(reinterpret_cast<float*>(scratch2), data, pilot, 2 * length);
                                         }
-
-                                    if (ms_counter_[sat] == 0 && data_flag_)
+                                    else
                                         {
-                                            // New random data bit
-                                            current_data_bits_[sat] = gr_complex((rand() % 2) == 0 ? 1 : -1, 0);
+                                            volk_32f_x2_add_32f(reinterpret_cast<float*>(scratch2), data, pilot, 2 * length);
                                         }
+                                    add_rotated(&out[out_idx], scratch2, scratch, length, bit, phase, phase_inc);
+                                    out_idx += length;
 
-                                    for (k = delay_samples; k < samples_per_code_[sat]; k++)
+                                    if (segment == 0 && ms_counter_[sat] == 0 && data_flag_)
                                         {
-                                            out[out_idx] += (sampled_code_data_[sat][out_idx] * current_data_bits_[sat]
-                                                                                                                   - sampled_code_pilot_[sat][out_idx])
-                                                                                                                   * complex_phase_[out_idx];
-                                            out_idx++;
+                                            // New random data bit
+                                            current_data_bits_[sat] = gr_complex((signal_generator_random(data_bit_state_[sat]) >> 63) == 0 ? 1 : -1, 0);
                                         }
+                                }
+
+                            ms_counter_[sat] = (ms_counter_[sat] + static_cast<int>(round(1e3 * Galileo_E1_CODE_PERIOD))) % data_bit_duration_ms_[sat];
+                        }
+                }
+        }
+}
+
+
+float signal_generator_c::gps_nav_bit(unsigned int sat, long int subframe_count, unsigned int bit)
+{
+    unsigned int* words = &gps_subframe_words_[10 * sat];
+    if (gps_subframe_count_[sat] != subframe_count)
+        {
+            scenario_->gps_subframe(PRN_[sat], subframe_count % (604800 / GPS_SUBFRAME_SECONDS), words);
+            gps_subframe_count_[sat] = subframe_count;
+        }
+    return ((words[bit / GPS_WORD_BITS] >> (GPS_WORD_BITS - 1 - bit % GPS_WORD_BITS)) & 1) ? 1.0 : -1.0;
+}
+
 
-                                    ms_counter_[sat] = (ms_counter_[sat] + static_cast<int>(round(1e3 * Galileo_E1_CODE_PERIOD))) % data_bit_duration_ms_[sat];
+void signal_generator_c::add_scenario_satellite(unsigned int sat, gr_complex* out, gr_complex* scratch, gr_complex* scratch2)
+{
+    const bool gps = system_[sat] == "G";
+    const bool e5a = !gps && signal_[sat].at(0) == '5';
+    const double carrier_hz = gps ? GPS_L1_FREQ_HZ : (e5a ? Galileo_E5a_FREQ_HZ : Galileo_E1_FREQ_HZ);
+    const double chip_rate = gps ? GPS_L1_CA_CODE_RATE_HZ : (e5a ? Galileo_E5a_CODE_CHIP_RATE_HZ : Galileo_E1_CODE_CHIP_RATE_HZ);
+    // The data and secondary codes start again at each subframe (GPS) or each 100 ms (Galileo)
+    const double period_s = gps ? GPS_SUBFRAME_SECONDS : 0.1;
+    const gr_complex* code = &scenario_code_[sat][0];
+    const double fs = static_cast<double>(fs_in_);
+
+    // The delays are interpolated linearly over 1 ms segments
+    const unsigned int segment_samples = fs_in_ / 1000;
+    const double first_t = static_cast<double>(work_counter_ - 1) * static_cast<double>(vector_length_) / fs;
+    double delay_a = scenario_->delay(system_[sat], PRN_[sat], first_t);
+
+    for (unsigned int out_idx = 0; out_idx < vector_length_; out_idx += segment_samples)
+        {
+            const unsigned int length = std::min(segment_samples, vector_length_ - out_idx);
+            const double t_a = first_t + static_cast<double>(out_idx) / fs;
+            const double delay_b = scenario_->delay(system_[sat], PRN_[sat], t_a + static_cast<double>(length) / fs);
+
+            // Satellite time of the first sample, from the start of its period
+            const double satellite_time = scenario_->start_tow() + t_a - delay_a;
+            const long int period_count = static_cast<long int>(std::floor(satellite_time / period_s));
+            const double chips = (satellite_time - static_cast<double>(period_count) * period_s) * chip_rate;
+            const double chips_step = (static_cast<double>(length) / fs - (delay_b - delay_a)) * chip_rate / static_cast<double>(length);
+
+            if (gps)
+                {
+                    const unsigned int chips_per_bit = static_cast<unsigned int>(GPS_L1_CA_CODE_LENGTH_CHIPS) * GPS_CA_TELEMETRY_SYMBOLS_PER_BIT;
+                    for (unsigned int k = 0; k < length; k++)
+                        {
+                            const unsigned long int chip = static_cast<unsigned long int>(chips + k * chips_step);
+                            long int subframe = period_count;
+                            unsigned int bit = chip / chips_per_bit;
+                            if (bit >= GPS_SUBFRAME_BITS)
+                                {
+                                    bit -= GPS_SUBFRAME_BITS;
+                                    subframe++;
                                 }
+                            const float sign = data_flag_ ? gps_nav_bit(sat, subframe, bit) : 1.0;
+                            scratch2[k] = code[chip % static_cast<unsigned int>(GPS_L1_CA_CODE_LENGTH_CHIPS)] * sign;
                         }
                 }
+            else if (e5a)
+                {
+                    const unsigned int codelen = static_cast<unsigned int>(Galileo_E5a_CODE_LENGTH_CHIPS);
+                    for (unsigned int k = 0; k < length; k++)
+                        {
+                            const unsigned long int chip = static_cast<unsigned long int>(chips + k * chips_step);
+                            const long int code_count = period_count * 100 + chip / codelen;
+                            const float data = data_flag_ ? signal_generator_galileo_symbol(PRN_[sat], code_count / 20) : 1.0;
+                            const float data_modulation = data * (Galileo_E5a_I_SECONDARY_CODE.at(code_count % 20) == '0' ? 1.0 : -1.0);
+                            const float pilot_modulation = Galileo_E5a_Q_SECONDARY_CODE[PRN_[sat] - 1].at(code_count % 100) == '0' ? 1.0 : -1.0;
+                            const gr_complex value = code[chip % codelen];
+                            scratch2[k] = gr_complex(value.real() * data_modulation, value.imag() * pilot_modulation);
+                        }
+                }
+            else
+                {
+                    // 12 samples per chip of the CBOC codes
+                    const unsigned int codelen = 12 * static_cast<unsigned int>(Galileo_E1_B_CODE_LENGTH_CHIPS);
+                    const unsigned int secondary_length = static_cast<unsigned int>(Galileo_E1_C_SECONDARY_CODE_LENGTH);
+                    for (unsigned int k = 0; k < length; k++)
+                        {
+                            const unsigned long int sample = static_cast<unsigned long int>(12.0 * (chips + k * chips_step));
+                            const long int code_count = period_count * secondary_length + sample / codelen;
+                            const float data = data_flag_ ? signal_generator_galileo_symbol(PRN_[sat], code_count) : 1.0;
+                            const float secondary = Galileo_E1_C_SECONDARY_CODE.at(code_count % secondary_length) == '0' ? 1.0 : -1.0;
+                            const gr_complex value = code[sample % codelen];
+                            scratch2[k] = gr_complex(value.real() * data - value.imag() * secondary, 0.0);
+                        }
+                }
+
+            // exp(-j 2 pi f delay), computed again at each segment so that
+            // the phase does not drift
+            double cycles = carrier_hz * delay_a;
+            cycles -= std::floor(cycles);
+            gr_complex phase(std::cos(-GPS_TWO_PI * cycles), std::sin(-GPS_TWO_PI * cycles));
+            const double phase_step_rad = -GPS_TWO_PI * carrier_hz * (delay_b - delay_a) / static_cast<double>(length);
+            add_rotated(&out[out_idx], scratch2, scratch, length, 1.0, phase, gr_complex(std::cos(phase_step_rad), std::sin(phase_step_rad)));
+            delay_a = delay_b;
         }
+}
 
-    if (noise_flag_)
+
+void signal_generator_c::add_satellites(unsigned int first, unsigned int stride, gr_complex* out)
+{
+    std::fill_n(out, vector_length_, gr_complex(0.0, 0.0));
+    for (unsigned int sat = first; sat < num_sats_; sat += stride)
         {
-            for (out_idx = 0; out_idx < vector_length_; out_idx++)
+            if (!scenario_)
                 {
-                    out[out_idx] += gr_complex(random_->gasdev(),random_->gasdev());
+                    add_satellite(sat, out, scratch_[2 * first], scratch_[2 * first + 1]);
                 }
+            else if (!scenario_code_[sat].empty())
+                {
+                    add_scenario_satellite(sat, out, scratch_[2 * first], scratch_[2 * first + 1]);
+                }
+        }
+}
+
+
+void signal_generator_c::add_noise(gr_complex* out)
+{
+    // Two table indices from each random number
+    const unsigned int mask = noise_table_size - 1;
+    unsigned int out_idx = 0;
+    for (; out_idx + 1 < vector_length_; out_idx += 2)
+        {
+            unsigned long long r = signal_generator_random(noise_state_);
+            out[out_idx] += noise_table_[(r >> 32) & mask];
+            out[out_idx + 1] += noise_table_[(r >> 48) & mask];
+        }
+    if (out_idx < vector_length_)
+        {
+            out[out_idx] += noise_table_[(signal_generator_random(noise_state_) >> 32) & mask];
+        }
+}
+
+
+int signal_generator_c::general_work (int noutput_items __attribute__((unused)),
+        gr_vector_int &ninput_items __attribute__((unused)),
+        gr_vector_const_void_star &input_items __attribute__((unused)),
+        gr_vector_void_star &output_items)
+{
+    GNSS_SDR_TRACE_SCOPE("signal_generator_c::general_work");
+    gr_complex *out = (gr_complex *) output_items[0];
+
+    work_counter_++;
+
+    // Each thread adds its satellites to its own vector
+    std::vector<std::thread> workers;
+    for (unsigned int t = 1; t < threads_; t++)
+        {
+            workers.push_back(std::thread(&signal_generator_c::add_satellites, this, t, threads_, thread_out_[t - 1]));
+        }
+    add_satellites(0, threads_, out);
+    for (unsigned int t = 1; t < threads_; t++)
+        {
+            workers[t - 1].join();
+            volk_32f_x2_add_32f(reinterpret_cast<float*>(out), reinterpret_cast<float*>(out),
+                    reinterpret_cast<float*>(thread_out_[t - 1]), 2 * vector_length_);
+        }
+
+    if (noise_flag_)
+        {
+            add_noise(out);
         }
 
     // Tell runtime system how many output items we produced.
@@ -31,12 +31,14 @@
 #ifndef GNSS_SDR_SIGNAL_GENERATOR_C_H
 #define GNSS_SDR_SIGNAL_GENERATOR_C_H
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <boost/scoped_array.hpp>
 #include <gnuradio/random.h>
 #include <gnuradio/block.h>
 #include "gnss_signal.h"
+#include "gnss_scenario.h"
 
 class signal_generator_c;
 
@@ -91,12 +93,25 @@ private:
 
     void init();
     void generate_codes();
+    void allocate_buffers();
+    void free_buffers();
+
+    // Adds the signals of the satellites first, first + stride, ... of the
+    // current vector to out, which is cleared first
+    void add_satellites(unsigned int first, unsigned int stride, gr_complex* out);
+    void add_satellite(unsigned int sat, gr_complex* out, gr_complex* scratch, gr_complex* scratch2);
+    void add_scenario_satellite(unsigned int sat, gr_complex* out, gr_complex* scratch, gr_complex* scratch2);
+    float gps_nav_bit(unsigned int sat, long int subframe_count, unsigned int bit);
+    void add_rotated(gr_complex* out, const gr_complex* in, gr_complex* scratch, unsigned int length,
+            float sign, gr_complex& phase, gr_complex phase_inc);
+    void add_noise(gr_complex* out);
 
     std::vector<std::string> signal_;
     std::vector<std::string> system_;
     std::vector<unsigned int> PRN_;
     std::vector<float> CN0_dB_;
     std::vector<float> doppler_Hz_;
+    std::vector<float> doppler_rate_Hz_s_;
     std::vector<unsigned int> delay_chips_;
     std::vector<unsigned int> delay_sec_;
     bool data_flag_;
@@ -119,13 +134,51 @@ private:
     boost::scoped_array<gr_complex*> sampled_code_data_;
     boost::scoped_array<gr_complex*> sampled_code_pilot_;
     gr::random* random_;
-    gr_complex* complex_phase_;
+    std::vector<gr_complex> carrier_phase_;
+    std::vector<gr_complex> carrier_phase_inc_;
+    std::vector<unsigned long long> data_bit_state_;
+
+    // Complex Gaussian samples, picked at random for each output sample
+    std::vector<gr_complex> noise_table_;
+    unsigned long long noise_state_;
+
+    // Scenario mode: one code period per satellite, with the data and pilot
+    // (E1) or I and Q (E5a) codes in the real and imaginary parts
+    std::shared_ptr<Gnss_Scenario> scenario_;
+    std::vector<std::vector<gr_complex> > scenario_code_;
+    std::vector<long int> gps_subframe_count_;
+    std::vector<unsigned int> gps_subframe_words_;  // 10 per satellite
+
+    unsigned int threads_;
+    unsigned int scratch_length_;
+    std::vector<gr_complex*> thread_out_;   // output of the threads other than the block's
+    std::vector<gr_complex*> scratch_;      // two buffers per thread
 
     unsigned int work_counter_;
 
 public:
     ~signal_generator_c();    // public destructor
 
+    /*!
+     * \brief Changes the Doppler of each satellite by its rate [Hz/s], once
+     * per output vector. Only the carrier is affected, not the code.
+     */
+    void set_doppler_rate(const std::vector<float> &doppler_rate_Hz_s);
+
+    /*!
+     * \brief Splits the satellites among \p threads threads in each call to
+     * general_work. 1, the default, synthesizes them in the block's thread.
+     */
+    void set_threads(unsigned int threads);
+
+    /*!
+     * \brief Takes the code and carrier phases of the satellites from the
+     * propagation delays of \p scenario instead of the static delays and
+     * Dopplers, with the GPS NAV message of their ephemeris as data bits.
+     * The satellites with no ephemeris are not generated.
+     */
+    void set_scenario(std::shared_ptr<Gnss_Scenario> scenario);
+
     // Where all the action really happens
 
     int general_work (int noutput_items,
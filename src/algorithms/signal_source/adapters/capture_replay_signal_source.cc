@@ -0,0 +1,204 @@
+/*!
+ * \file capture_replay_signal_source.cc
+ * \brief Implementation of a signal source that replays a capture made with
+ *  the SignalSource.capture_filename property
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "capture_replay_signal_source.h"
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include "configuration_interface.h"
+#include "gnss_sample_capture.h"
+#include "gnss_sdr_valve.h"
+
+using google::LogMessage;
+
+DECLARE_string(signal_source);
+
+
+CaptureReplaySignalSource::CaptureReplaySignalSource(ConfigurationInterface* configuration,
+        std::string role, unsigned int in_streams, unsigned int out_streams,
+        boost::shared_ptr<gr::msg_queue> queue) :
+                        role_(role), in_streams_(in_streams), out_streams_(out_streams), queue_(queue)
+{
+    std::string default_filename = "./example_capture.dat";
+    std::string default_dump_filename = "./my_capture.dat";
+
+    samples_ = std::strtoull(configuration->property(role + ".samples", std::string("0")).c_str(), nullptr, 10);
+    filename_ = configuration->property(role + ".filename", default_filename);
+
+    // override value with commandline flag, if present
+    if (FLAGS_signal_source.compare("-") != 0) filename_= FLAGS_signal_source;
+
+    dump_ = configuration->property(role + ".dump", false);
+    dump_filename_ = configuration->property(role + ".dump_filename", default_dump_filename);
+    enable_throttle_control_ = configuration->property(role + ".enable_throttle_control", false);
+    bool overflow_monitor_enabled = configuration->property(role + ".overflow_monitor", true);
+
+    reader_ = std::make_shared<Gnss_Sample_Capture_Reader>();
+    if (!reader_->open(filename_))
+        {
+            std::cerr
+            << "The receiver was configured to replay a capture "
+            << std::endl
+            << "but " << filename_ << " or its annotations file " << filename_ << ".annotations"
+            << std::endl
+            << "are unreachable by GNSS-SDR or are not a valid capture."
+            << std::endl
+            <<  "Please modify your configuration file"
+            << std::endl
+            <<  "and point SignalSource.filename to a capture made with SignalSource.capture_filename."
+            << std::endl;
+
+            LOG(INFO) << "capture_replay_signal_source: Unable to open the capture "
+                      << filename_.c_str() << ", exiting the program.";
+            throw std::runtime_error("Unable to open the capture " + filename_);
+        }
+    item_size_ = reader_->output_item_size();
+
+    capture_source_ = gnss_sdr_make_capture_source(reader_);
+    DLOG(INFO) << "capture_source(" << capture_source_->unique_id() << ")";
+
+    if (samples_ == 0 || samples_ > reader_->samples()) // replay the whole session
+        {
+            samples_ = reader_->samples();
+        }
+    CHECK(samples_ > 0) << "The capture does not contain any sample.";
+
+    double signal_duration_s = static_cast<double>(samples_) / reader_->sample_rate();
+    std::cout << std::setprecision(16);
+    std::cout << "Replaying capture " << filename_ << " of " << reader_->samples() << " samples";
+    if (reader_->lost_samples() > 0)
+        {
+            std::cout << " (" << reader_->lost_samples() << " lost by the front end)";
+        }
+    std::cout << std::endl;
+    std::cout << "GNSS signal recorded time to be processed: " << signal_duration_s << " [s]" << std::endl;
+
+    valve_ = gnss_sdr_make_valve(item_size_, samples_, queue_);
+    DLOG(INFO) << "valve(" << valve_->unique_id() << ")";
+
+    if (dump_)
+        {
+            sink_ = gr::blocks::file_sink::make(item_size_, dump_filename_.c_str());
+            DLOG(INFO) << "file_sink(" << sink_->unique_id() << ")";
+        }
+
+    if (enable_throttle_control_)
+        {
+            throttle_ = gr::blocks::throttle::make(item_size_, reader_->sample_rate());
+        }
+
+    // only a capture with time tags can tell the overflows
+    if (overflow_monitor_enabled && !reader_->time_tags().empty())
+        {
+            overflow_monitor_ = gnss_sdr_make_overflow_monitor(item_size_, reader_->sample_rate(), 0, queue_);
+            DLOG(INFO) << "overflow_monitor(" << overflow_monitor_->unique_id() << ")";
+        }
+    DLOG(INFO) << "Capture filename " << filename_;
+    DLOG(INFO) << "Samples " << samples_;
+    DLOG(INFO) << "Sampling frequency " << reader_->sample_rate();
+    DLOG(INFO) << "Bits " << reader_->bits();
+    DLOG(INFO) << "Item size " << item_size_;
+    DLOG(INFO) << "Dump " << dump_;
+    DLOG(INFO) << "Dump filename " << dump_filename_;
+}
+
+
+
+CaptureReplaySignalSource::~CaptureReplaySignalSource()
+{}
+
+
+
+void CaptureReplaySignalSource::connect(gr::top_block_sptr top_block)
+{
+    gr::basic_block_sptr last = capture_source_;
+    if (overflow_monitor_)
+        {
+            top_block->connect(capture_source_, 0, overflow_monitor_, 0);
+            DLOG(INFO) << "connected capture source to overflow monitor";
+        }
+    if (enable_throttle_control_ == true)
+        {
+            top_block->connect(last, 0, throttle_, 0);
+            DLOG(INFO) << "connected capture source to throttle";
+            last = throttle_;
+        }
+    top_block->connect(last, 0, valve_, 0);
+    DLOG(INFO) << "connected to valve";
+    if (dump_)
+        {
+            top_block->connect(valve_, 0, sink_, 0);
+            DLOG(INFO) << "connected to file sink";
+        }
+}
+
+
+
+void CaptureReplaySignalSource::disconnect(gr::top_block_sptr top_block)
+{
+    gr::basic_block_sptr last = capture_source_;
+    if (overflow_monitor_)
+        {
+            top_block->disconnect(capture_source_, 0, overflow_monitor_, 0);
+            DLOG(INFO) << "disconnected overflow monitor";
+        }
+    if (enable_throttle_control_ == true)
+        {
+            top_block->disconnect(last, 0, throttle_, 0);
+            DLOG(INFO) << "disconnected capture source to throttle";
+            last = throttle_;
+        }
+    top_block->disconnect(last, 0, valve_, 0);
+    DLOG(INFO) << "disconnected valve";
+    if (dump_)
+        {
+            top_block->disconnect(valve_, 0, sink_, 0);
+            DLOG(INFO) << "disconnected file sink";
+        }
+}
+
+
+
+gr::basic_block_sptr CaptureReplaySignalSource::get_left_block()
+{
+    LOG(WARNING) << "Left block of a signal source should not be retrieved";
+    return gr::block_sptr();
+}
+
+
+
+gr::basic_block_sptr CaptureReplaySignalSource::get_right_block()
+{
+    return valve_;
+}
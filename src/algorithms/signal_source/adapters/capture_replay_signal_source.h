@@ -0,0 +1,114 @@
+/*!
+ * \file capture_replay_signal_source.h
+ * \brief Interface of a signal source that replays a capture made with the
+ *  SignalSource.capture_filename property
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The samples come out as the captured source delivered them, or as
+ * gr_complex if they were requantized, with zeros in the gaps of the
+ * capture and the "rx_time" tags of the source at the same samples, so
+ * that a live session can be processed again sample by sample. The
+ * overflows of the front end are reported by an overflow monitor, as for
+ * a live source.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CAPTURE_REPLAY_SIGNAL_SOURCE_H_
+#define GNSS_SDR_CAPTURE_REPLAY_SIGNAL_SOURCE_H_
+
+#include <memory>
+#include <string>
+#include <gnuradio/blocks/file_sink.h>
+#include <gnuradio/blocks/throttle.h>
+#include <gnuradio/msg_queue.h>
+#include "gnss_block_interface.h"
+#include "gnss_sdr_capture_source.h"
+#include "gnss_sdr_overflow_monitor.h"
+
+class ConfigurationInterface;
+class Gnss_Sample_Capture_Reader;
+
+/*!
+ * \brief Class that replays a capture of a signal source and adapts it
+ * to a SignalSourceInterface
+ */
+class CaptureReplaySignalSource: public GNSSBlockInterface
+{
+public:
+    CaptureReplaySignalSource(ConfigurationInterface* configuration, std::string role,
+            unsigned int in_streams, unsigned int out_streams,
+            boost::shared_ptr<gr::msg_queue> queue);
+
+    virtual ~CaptureReplaySignalSource();
+    std::string role()
+    {
+        return role_;
+    }
+
+    /*!
+     * \brief Returns "Capture_Replay_Signal_Source".
+     */
+    std::string implementation()
+    {
+        return "Capture_Replay_Signal_Source";
+    }
+    size_t item_size()
+    {
+        return item_size_;
+    }
+    void connect(gr::top_block_sptr top_block);
+    void disconnect(gr::top_block_sptr top_block);
+    gr::basic_block_sptr get_left_block();
+    gr::basic_block_sptr get_right_block();
+    std::string filename()
+    {
+        return filename_;
+    }
+    long samples()
+    {
+        return samples_;
+    }
+
+private:
+    unsigned long long samples_;
+    std::string filename_;
+    bool dump_;
+    std::string dump_filename_;
+    std::string role_;
+    unsigned int in_streams_;
+    unsigned int out_streams_;
+    std::shared_ptr<Gnss_Sample_Capture_Reader> reader_;
+    gnss_sdr_capture_source_sptr capture_source_;
+    boost::shared_ptr<gr::block> valve_;
+    gr::blocks::file_sink::sptr sink_;
+    gr::blocks::throttle::sptr  throttle_;
+    gnss_sdr_overflow_monitor_sptr overflow_monitor_;
+    boost::shared_ptr<gr::msg_queue> queue_;
+    size_t item_size_;
+    bool enable_throttle_control_;
+};
+
+#endif /*GNSS_SDR_CAPTURE_REPLAY_SIGNAL_SOURCE_H_*/
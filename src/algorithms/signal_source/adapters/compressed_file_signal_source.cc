@@ -0,0 +1,229 @@
+/*!
+ * \file compressed_file_signal_source.cc
+ * \brief Signal source that reads a compressed capture, decompressing
+ * its chunks in parallel
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "compressed_file_signal_source.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include "configuration_interface.h"
+#include "gnss_sdr_valve.h"
+
+using google::LogMessage;
+
+DECLARE_string(signal_source);
+
+
+CompressedFileSignalSource::CompressedFileSignalSource(ConfigurationInterface* configuration,
+        std::string role, unsigned int in_streams, unsigned int out_streams,
+        boost::shared_ptr<gr::msg_queue> queue) :
+                        role_(role), in_streams_(in_streams), out_streams_(out_streams), queue_(queue)
+{
+    std::string default_filename = "./example_capture.gsc";
+    std::string default_dump_filename = "./my_capture.dat";
+
+    samples_ = std::strtoull(configuration->property(role + ".samples", std::string("0")).c_str(), nullptr, 10);
+    filename_ = configuration->property(role + ".filename", default_filename);
+
+    // override value with commandline flag, if present
+    if (FLAGS_signal_source.compare("-") != 0) filename_= FLAGS_signal_source;
+
+    repeat_ = configuration->property(role + ".repeat", false);
+    dump_ = configuration->property(role + ".dump", false);
+    dump_filename_ = configuration->property(role + ".dump_filename", default_dump_filename);
+    enable_throttle_control_ = configuration->property(role + ".enable_throttle_control", false);
+    unsigned int threads = configuration->property(role + ".threads", 0u);
+    if (threads == 0)
+        {
+            threads = std::max(std::min(std::thread::hardware_concurrency(), 4u), 1u);
+        }
+    double seconds_to_skip = configuration->property(role + ".seconds_to_skip", 0.0);
+    size_t header_size = configuration->property(role + ".header_size", 0);
+
+    reader_ = std::make_shared<Compressed_Capture_Reader>();
+    if (!reader_->open(filename_))
+        {
+            std::cerr
+            << "The receiver was configured to read a compressed capture "
+            << std::endl
+            << "but " << filename_ << " is unreachable by GNSS-SDR or is not a valid compressed capture."
+            << std::endl
+            <<  "Please modify your configuration file"
+            << std::endl
+            <<  "and point SignalSource.filename to a file made with capture-compress."
+            << std::endl;
+
+            LOG(INFO) << "compressed_file_signal_source: Unable to open the capture "
+                      << filename_.c_str() << ", exiting the program.";
+            throw std::runtime_error("Unable to open the compressed capture " + filename_);
+        }
+
+    // the item type is the one of the raw file
+    item_type_ = reader_->item_type();
+    const std::string configured_type = configuration->property(role + ".item_type", item_type_);
+    if (configured_type != item_type_)
+        {
+            LOG(WARNING) << "The compressed capture holds " << item_type_ << " items, not " << configured_type;
+        }
+    bool is_complex = false;
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            item_size_ = sizeof(gr_complex);
+        }
+    else if (item_type_.compare("float") == 0)
+        {
+            item_size_ = sizeof(float);
+        }
+    else if (item_type_.compare("short") == 0)
+        {
+            item_size_ = sizeof(int16_t);
+        }
+    else if (item_type_.compare("ishort") == 0)
+        {
+            item_size_ = sizeof(int16_t);
+            is_complex = true;
+        }
+    else if (item_type_.compare("byte") == 0)
+        {
+            item_size_ = sizeof(int8_t);
+        }
+    else if (item_type_.compare("ibyte") == 0)
+        {
+            item_size_ = sizeof(int8_t);
+            is_complex = true;
+        }
+    else
+        {
+            LOG(WARNING) << item_type_
+                    << " unrecognized item type. Using gr_complex.";
+            item_size_ = sizeof(gr_complex);
+        }
+
+    // same units as in File_Signal_Source
+    const double sampling_frequency = configuration->property(role + ".sampling_frequency", reader_->sample_rate());
+    unsigned long long items_to_skip = 0;
+    if (seconds_to_skip > 0)
+        {
+            items_to_skip = static_cast<unsigned long long>(seconds_to_skip * sampling_frequency);
+            if (is_complex)
+                {
+                    items_to_skip *= 2;
+                }
+        }
+    items_to_skip += header_size;
+
+    source_ = make_compressed_file_source(reader_, item_size_, items_to_skip, repeat_, threads);
+    DLOG(INFO) << "compressed_file_source(" << source_->unique_id() << ")";
+
+    if (samples_ == 0 || (!repeat_ && samples_ > source_->items()))
+        {
+            samples_ = source_->items();
+        }
+    std::cout << "Reading compressed capture " << filename_ << " of " << reader_->raw_bytes() << " bytes in "
+              << reader_->chunks() << " chunks, with " << threads << " threads" << std::endl;
+
+    if (enable_throttle_control_)
+        {
+            throttle_ = gr::blocks::throttle::make(item_size_, sampling_frequency);
+        }
+    valve_ = gnss_sdr_make_valve(item_size_, samples_, queue_);
+    DLOG(INFO) << "valve(" << valve_->unique_id() << ")";
+
+    if (dump_)
+        {
+            sink_ = gr::blocks::file_sink::make(item_size_, dump_filename_.c_str());
+            DLOG(INFO) << "file_sink(" << sink_->unique_id() << ")";
+        }
+    DLOG(INFO) << "Compressed capture filename " << filename_;
+    DLOG(INFO) << "Samples " << samples_;
+    DLOG(INFO) << "Sampling frequency " << sampling_frequency;
+    DLOG(INFO) << "Item type " << item_type_;
+}
+
+
+
+CompressedFileSignalSource::~CompressedFileSignalSource()
+{}
+
+
+
+void CompressedFileSignalSource::connect(gr::top_block_sptr top_block)
+{
+    gr::basic_block_sptr last = source_;
+    if (enable_throttle_control_ == true)
+        {
+            top_block->connect(last, 0, throttle_, 0);
+            DLOG(INFO) << "connected compressed file source to throttle";
+            last = throttle_;
+        }
+    top_block->connect(last, 0, valve_, 0);
+    DLOG(INFO) << "connected to valve";
+    if (dump_)
+        {
+            top_block->connect(valve_, 0, sink_, 0);
+            DLOG(INFO) << "connected valve to file sink";
+        }
+}
+
+
+
+void CompressedFileSignalSource::disconnect(gr::top_block_sptr top_block)
+{
+    gr::basic_block_sptr last = source_;
+    if (enable_throttle_control_ == true)
+        {
+            top_block->disconnect(last, 0, throttle_, 0);
+            last = throttle_;
+        }
+    top_block->disconnect(last, 0, valve_, 0);
+    if (dump_)
+        {
+            top_block->disconnect(valve_, 0, sink_, 0);
+        }
+}
+
+
+
+gr::basic_block_sptr CompressedFileSignalSource::get_left_block()
+{
+    LOG(WARNING) << "Left block of a signal source should not be retrieved";
+    return gr::block_sptr();
+}
+
+
+
+gr::basic_block_sptr CompressedFileSignalSource::get_right_block()
+{
+    return valve_;
+}
@@ -0,0 +1,111 @@
+/*!
+ * \file compressed_file_signal_source.h
+ * \brief Signal source that reads a compressed capture, decompressing
+ * its chunks in parallel
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_COMPRESSED_FILE_SIGNAL_SOURCE_H_
+#define GNSS_SDR_COMPRESSED_FILE_SIGNAL_SOURCE_H_
+
+#include <memory>
+#include <string>
+#include <gnuradio/blocks/file_sink.h>
+#include <gnuradio/blocks/throttle.h>
+#include <gnuradio/msg_queue.h>
+#include "gnss_block_interface.h"
+#include "compressed_file_source.h"
+
+class ConfigurationInterface;
+
+/*!
+ * \brief Reads a capture compressed by capture-compress as File_Signal_Source
+ * reads the raw file, with the item type and sample rate stored in the
+ * capture. Throws std::runtime_error if it is not a valid capture.
+ */
+class CompressedFileSignalSource: public GNSSBlockInterface
+{
+public:
+    CompressedFileSignalSource(ConfigurationInterface* configuration, std::string role,
+            unsigned int in_streams, unsigned int out_streams,
+            boost::shared_ptr<gr::msg_queue> queue);
+
+    virtual ~CompressedFileSignalSource();
+    std::string role()
+    {
+        return role_;
+    }
+
+    /*!
+     * \brief Returns "Compressed_File_Signal_Source".
+     */
+    std::string implementation()
+    {
+        return "Compressed_File_Signal_Source";
+    }
+    size_t item_size()
+    {
+        return item_size_;
+    }
+    void connect(gr::top_block_sptr top_block);
+    void disconnect(gr::top_block_sptr top_block);
+    gr::basic_block_sptr get_left_block();
+    gr::basic_block_sptr get_right_block();
+    std::string filename()
+    {
+        return filename_;
+    }
+    std::string item_type()
+    {
+        return item_type_;
+    }
+    unsigned long long samples()
+    {
+        return samples_;
+    }
+
+private:
+    unsigned long long samples_;
+    std::string filename_;
+    std::string item_type_;
+    bool repeat_;
+    bool dump_;
+    std::string dump_filename_;
+    bool enable_throttle_control_;
+    std::string role_;
+    unsigned int in_streams_;
+    unsigned int out_streams_;
+    size_t item_size_;
+    std::shared_ptr<Compressed_Capture_Reader> reader_;
+    compressed_file_source_sptr source_;
+    gr::blocks::throttle::sptr throttle_;
+    boost::shared_ptr<gr::block> valve_;
+    gr::blocks::file_sink::sptr sink_;
+    boost::shared_ptr<gr::msg_queue> queue_;
+};
+
+#endif /*GNSS_SDR_COMPRESSED_FILE_SIGNAL_SOURCE_H_*/
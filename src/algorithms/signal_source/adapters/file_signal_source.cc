@@ -60,7 +60,8 @@ FileSignalSource::FileSignalSource(ConfigurationInterface* configuration,
 
     double default_seconds_to_skip = 0.0;
     size_t header_size = 0;
-    samples_ = configuration->property(role + ".samples", 0);
+    // read as a string: long captures have more samples than an int can hold
+    samples_ = std::strtoull(configuration->property(role + ".samples", std::string("0")).c_str(), nullptr, 10);
     sampling_frequency_ = configuration->property(role + ".sampling_frequency", 0);
     filename_ = configuration->property(role + ".filename", default_filename);
 
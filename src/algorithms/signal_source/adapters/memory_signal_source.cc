@@ -0,0 +1,177 @@
+/*!
+ * \file memory_signal_source.cc
+ * \brief Signal source that reads the samples from a buffer of the
+ * embedding application
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "memory_signal_source.h"
+#include <cstdlib>
+#include <stdexcept>
+#include <glog/logging.h>
+#include "configuration_interface.h"
+#include "gnss_sdr_valve.h"
+#include "memory_signal_buffers.h"
+
+using google::LogMessage;
+
+
+MemorySignalSource::MemorySignalSource(ConfigurationInterface* configuration,
+        std::string role, unsigned int in_streams, unsigned int out_streams,
+        boost::shared_ptr<gr::msg_queue> queue) :
+                        role_(role), in_streams_(in_streams), out_streams_(out_streams), queue_(queue)
+{
+    std::string default_item_type = "short";
+    std::string default_dump_filename = "./my_capture.dat";
+
+    buffer_ = configuration->property(role + ".buffer", std::string(""));
+    samples_ = std::strtoull(configuration->property(role + ".samples", std::string("0")).c_str(), nullptr, 10);
+    sampling_frequency_ = configuration->property(role + ".sampling_frequency", 0);
+    item_type_ = configuration->property(role + ".item_type", default_item_type);
+    repeat_ = configuration->property(role + ".repeat", false);
+    dump_ = configuration->property(role + ".dump", false);
+    dump_filename_ = configuration->property(role + ".dump_filename", default_dump_filename);
+    double seconds_to_skip = configuration->property(role + ".seconds_to_skip", 0.0);
+    size_t header_size = configuration->property(role + ".header_size", 0);
+
+    bool is_complex = false;
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            item_size_ = sizeof(gr_complex);
+        }
+    else if (item_type_.compare("float") == 0)
+        {
+            item_size_ = sizeof(float);
+        }
+    else if (item_type_.compare("short") == 0)
+        {
+            item_size_ = sizeof(int16_t);
+        }
+    else if (item_type_.compare("ishort") == 0)
+        {
+            item_size_ = sizeof(int16_t);
+            is_complex = true;
+        }
+    else if (item_type_.compare("byte") == 0)
+        {
+            item_size_ = sizeof(int8_t);
+        }
+    else if (item_type_.compare("ibyte") == 0)
+        {
+            item_size_ = sizeof(int8_t);
+            is_complex = true;
+        }
+    else
+        {
+            LOG(WARNING) << item_type_
+                    << " unrecognized item type. Using gr_complex.";
+            item_size_ = sizeof(gr_complex);
+        }
+
+    // same units as in File_Signal_Source: items of the buffer
+    unsigned long long items_to_skip = 0;
+    if (seconds_to_skip > 0)
+        {
+            items_to_skip = static_cast<unsigned long long>(seconds_to_skip * sampling_frequency_);
+            if (is_complex)
+                {
+                    items_to_skip *= 2;
+                }
+        }
+    items_to_skip += header_size;
+
+    const void* data = nullptr;
+    size_t bytes = 0;
+    if (!Memory_Signal_Buffers::find(buffer_, &data, &bytes))
+        {
+            LOG(WARNING) << "There is no sample buffer named \"" << buffer_ << "\"";
+            throw std::runtime_error("Memory_Signal_Source: no sample buffer " + buffer_);
+        }
+    source_ = make_memory_source(item_size_, data, bytes, items_to_skip * item_size_, repeat_);
+
+    // unlike a file, the whole buffer is processed
+    if (samples_ == 0 || samples_ > source_->items())
+        {
+            samples_ = source_->items();
+        }
+    valve_ = gnss_sdr_make_valve(item_size_, samples_, queue_);
+    DLOG(INFO) << "valve(" << valve_->unique_id() << ")";
+
+    if (dump_)
+        {
+            sink_ = gr::blocks::file_sink::make(item_size_, dump_filename_.c_str());
+            DLOG(INFO) << "file_sink(" << sink_->unique_id() << ")";
+        }
+    DLOG(INFO) << "Memory source buffer " << buffer_ << " of " << bytes << " bytes";
+    DLOG(INFO) << "Samples " << samples_;
+    DLOG(INFO) << "Sampling frequency " << sampling_frequency_;
+    DLOG(INFO) << "Item type " << item_type_;
+}
+
+
+
+MemorySignalSource::~MemorySignalSource()
+{}
+
+
+
+void MemorySignalSource::connect(gr::top_block_sptr top_block)
+{
+    top_block->connect(source_, 0, valve_, 0);
+    DLOG(INFO) << "connected memory source to valve";
+    if (dump_)
+        {
+            top_block->connect(valve_, 0, sink_, 0);
+            DLOG(INFO) << "connected valve to file sink";
+        }
+}
+
+
+
+void MemorySignalSource::disconnect(gr::top_block_sptr top_block)
+{
+    top_block->disconnect(source_, 0, valve_, 0);
+    if (dump_)
+        {
+            top_block->disconnect(valve_, 0, sink_, 0);
+        }
+}
+
+
+
+gr::basic_block_sptr MemorySignalSource::get_left_block()
+{
+    LOG(WARNING) << "Left block of a signal source should not be retrieved";
+    return gr::block_sptr();
+}
+
+
+
+gr::basic_block_sptr MemorySignalSource::get_right_block()
+{
+    return valve_;
+}
@@ -0,0 +1,112 @@
+/*!
+ * \file memory_signal_source.h
+ * \brief Signal source that reads the samples from a buffer of the
+ * embedding application
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MEMORY_SIGNAL_SOURCE_H_
+#define GNSS_SDR_MEMORY_SIGNAL_SOURCE_H_
+
+#include <string>
+#include <gnuradio/blocks/file_sink.h>
+#include <gnuradio/msg_queue.h>
+#include "gnss_block_interface.h"
+#include "memory_source.h"
+
+
+class ConfigurationInterface;
+
+/*!
+ * \brief Reads the samples of the buffer added to Memory_Signal_Buffers
+ * with the name of the .buffer property, as a file signal source reads
+ * the file. Throws std::runtime_error if there is no such buffer.
+ */
+class MemorySignalSource: public GNSSBlockInterface
+{
+public:
+    MemorySignalSource(ConfigurationInterface* configuration, std::string role,
+            unsigned int in_streams, unsigned int out_streams,
+            boost::shared_ptr<gr::msg_queue> queue);
+
+    virtual ~MemorySignalSource();
+    std::string role()
+    {
+        return role_;
+    }
+
+    /*!
+     * \brief Returns "Memory_Signal_Source".
+     */
+    std::string implementation()
+    {
+        return "Memory_Signal_Source";
+    }
+    size_t item_size()
+    {
+        return item_size_;
+    }
+    void connect(gr::top_block_sptr top_block);
+    void disconnect(gr::top_block_sptr top_block);
+    gr::basic_block_sptr get_left_block();
+    gr::basic_block_sptr get_right_block();
+    std::string buffer()
+    {
+        return buffer_;
+    }
+    std::string item_type()
+    {
+        return item_type_;
+    }
+    long sampling_frequency()
+    {
+        return sampling_frequency_;
+    }
+    unsigned long long samples()
+    {
+        return samples_;
+    }
+
+private:
+    unsigned long long samples_;
+    long sampling_frequency_;
+    std::string buffer_;
+    std::string item_type_;
+    bool repeat_;
+    bool dump_;
+    std::string dump_filename_;
+    std::string role_;
+    unsigned int in_streams_;
+    unsigned int out_streams_;
+    size_t item_size_;
+    memory_source_sptr source_;
+    boost::shared_ptr<gr::block> valve_;
+    gr::blocks::file_sink::sptr sink_;
+    boost::shared_ptr<gr::msg_queue> queue_;
+};
+
+#endif /*GNSS_SDR_MEMORY_SIGNAL_SOURCE_H_*/
@@ -0,0 +1,284 @@
+/*!
+ * \file mmap_file_signal_source.cc
+ * \brief Implementation of a class that reads signal samples from a memory
+ * mapped file and adapts it to a SignalSourceInterface
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "mmap_file_signal_source.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <exception>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include "gnss_sdr_valve.h"
+#include "configuration_interface.h"
+
+using google::LogMessage;
+
+DECLARE_string(signal_source);
+
+
+MmapFileSignalSource::MmapFileSignalSource(ConfigurationInterface* configuration,
+        std::string role, unsigned int in_streams, unsigned int out_streams,
+        boost::shared_ptr<gr::msg_queue> queue) :
+                        role_(role), in_streams_(in_streams), out_streams_(out_streams), queue_(queue)
+{
+    std::string default_filename = "./example_capture.dat";
+    std::string default_item_type = "short";
+    std::string default_dump_filename = "./my_capture.dat";
+
+    double default_seconds_to_skip = 0.0;
+    size_t header_size = 0;
+    // read as a string: long captures have more samples than an int can hold
+    samples_ = std::strtoull(configuration->property(role + ".samples", std::string("0")).c_str(), nullptr, 10);
+    sampling_frequency_ = configuration->property(role + ".sampling_frequency", 0);
+    filename_ = configuration->property(role + ".filename", default_filename);
+
+    // override value with commandline flag, if present
+    if (FLAGS_signal_source.compare("-") != 0) filename_= FLAGS_signal_source;
+
+    item_type_ = configuration->property(role + ".item_type", default_item_type);
+    repeat_ = configuration->property(role + ".repeat", false);
+    dump_ = configuration->property(role + ".dump", false);
+    dump_filename_ = configuration->property(role + ".dump_filename", default_dump_filename);
+    enable_throttle_control_ = configuration->property(role + ".enable_throttle_control", false);
+    double seconds_to_skip = configuration->property(role + ".seconds_to_skip", default_seconds_to_skip );
+    header_size = configuration->property( role + ".header_size", 0 );
+    unsigned int window_size_mb = configuration->property(role + ".window_size_mb", MMAP_FILE_READER_DEFAULT_WINDOW_SIZE / (1024 * 1024));
+    long samples_to_skip = 0;
+
+    bool is_complex = false;
+
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            item_size_ = sizeof(gr_complex);
+        }
+    else if (item_type_.compare("float") == 0)
+        {
+            item_size_ = sizeof(float);
+        }
+    else if (item_type_.compare("short") == 0)
+        {
+            item_size_ = sizeof(int16_t);
+        }
+    else if (item_type_.compare("ishort") == 0)
+        {
+            item_size_ = sizeof(int16_t);
+            is_complex = true;
+        }
+    else if (item_type_.compare("byte") == 0)
+        {
+            item_size_ = sizeof(int8_t);
+        }
+    else if (item_type_.compare("ibyte") == 0)
+        {
+            item_size_ = sizeof(int8_t);
+            is_complex = true;
+        }
+    else
+        {
+            LOG(WARNING) << item_type_
+                    << " unrecognized item type. Using gr_complex.";
+            item_size_ = sizeof(gr_complex);
+        }
+
+    // same units as in File_Signal_Source: items of the file
+    if (seconds_to_skip > 0)
+        {
+            samples_to_skip = static_cast<long>(seconds_to_skip * sampling_frequency_);
+            if (is_complex)
+                {
+                    samples_to_skip *= 2;
+                }
+        }
+    samples_to_skip += header_size;
+    if (samples_to_skip > 0)
+        {
+            LOG(INFO) << "Skipping " << samples_to_skip << " samples of the input file";
+        }
+
+    try
+    {
+            file_source_ = make_mmap_file_source(item_size_, filename_,
+                    static_cast<unsigned long long>(samples_to_skip) * item_size_, repeat_,
+                    static_cast<size_t>(std::max(window_size_mb, 1u)) * 1024 * 1024);
+    }
+    catch (const std::exception &e)
+    {
+            std::cerr
+            << "The receiver was configured to work with a memory mapped file signal source "
+            << std::endl
+            << "but the specified file is unreachable by GNSS-SDR"
+            << std::endl
+            << "or it is shorter than the samples to skip."
+            << std::endl
+            <<  "Please modify your configuration file"
+            << std::endl
+            <<  "and point SignalSource.filename to a valid raw data file. Then:"
+            << std::endl
+            << "$ gnss-sdr --config_file=/path/to/my_GNSS_SDR_configuration.conf"
+            << std::endl
+            << "Examples of configuration files available at:"
+            << std::endl
+            << GNSSSDR_INSTALL_DIR "/share/gnss-sdr/conf/"
+            << std::endl;
+
+            LOG(INFO) << "mmap_file_signal_source: Unable to map the samples file "
+                      << filename_.c_str() << ", exiting the program.";
+            throw(e);
+    }
+
+    DLOG(INFO) << "mmap_file_source(" << file_source_->unique_id() << ")";
+
+    if (samples_ == 0) // read all file
+        {
+            // as in File_Signal_Source, the valve stops the receiver before the end of the file
+            std::cout << std::setprecision(16);
+            std::cout << "Processing file " << filename_ << ", which contains "
+                      << static_cast<double>(file_source_->items() * item_size_) << " [bytes] after the skipped samples" << std::endl;
+            long long samples_to_process = static_cast<long long>(file_source_->items()) - static_cast<long long>(ceil(0.002 * static_cast<double>(sampling_frequency_)));
+            samples_ = samples_to_process > 0 ? samples_to_process : 0;
+        }
+
+    CHECK(samples_ > 0) << "File does not contain enough samples to process.";
+    double signal_duration_s;
+    signal_duration_s = static_cast<double>(samples_) * ( 1 / static_cast<double>(sampling_frequency_));
+
+    if (is_complex)
+        {
+            signal_duration_s /= 2.0;
+        }
+
+    DLOG(INFO) << "Total number samples to be processed= " << samples_ << " GNSS signal duration= " << signal_duration_s << " [s]";
+    std::cout << "GNSS signal recorded time to be processed: " << signal_duration_s << " [s]" << std::endl;
+
+    valve_ = gnss_sdr_make_valve(item_size_, samples_, queue_);
+    DLOG(INFO) << "valve(" << valve_->unique_id() << ")";
+
+    if (dump_)
+        {
+            sink_ = gr::blocks::file_sink::make(item_size_, dump_filename_.c_str());
+            DLOG(INFO) << "file_sink(" << sink_->unique_id() << ")";
+        }
+
+    if (enable_throttle_control_)
+        {
+            throttle_ = gr::blocks::throttle::make(item_size_, sampling_frequency_);
+        }
+    DLOG(INFO) << "File source filename " << filename_;
+    DLOG(INFO) << "Samples " << samples_;
+    DLOG(INFO) << "Sampling frequency " << sampling_frequency_;
+    DLOG(INFO) << "Item type " << item_type_;
+    DLOG(INFO) << "Item size " << item_size_;
+    DLOG(INFO) << "Repeat " << repeat_;
+    DLOG(INFO) << "Window size " << window_size_mb << " [MB]";
+    DLOG(INFO) << "Dump " << dump_;
+    DLOG(INFO) << "Dump filename " << dump_filename_;
+}
+
+
+
+MmapFileSignalSource::~MmapFileSignalSource()
+{}
+
+
+
+void MmapFileSignalSource::connect(gr::top_block_sptr top_block)
+{
+    gr::basic_block_sptr last = file_source_;
+    if (enable_throttle_control_ == true)
+        {
+            top_block->connect(last, 0, throttle_, 0);
+            DLOG(INFO) << "connected file source to throttle";
+            last = throttle_;
+        }
+    if (samples_ > 0)
+        {
+            top_block->connect(last, 0, valve_, 0);
+            DLOG(INFO) << "connected to valve";
+            last = valve_;
+        }
+    if (dump_)
+        {
+            top_block->connect(last, 0, sink_, 0);
+            DLOG(INFO) << "connected to file sink";
+        }
+}
+
+
+
+void MmapFileSignalSource::disconnect(gr::top_block_sptr top_block)
+{
+    gr::basic_block_sptr last = file_source_;
+    if (enable_throttle_control_ == true)
+        {
+            top_block->disconnect(last, 0, throttle_, 0);
+            DLOG(INFO) << "disconnected file source to throttle";
+            last = throttle_;
+        }
+    if (samples_ > 0)
+        {
+            top_block->disconnect(last, 0, valve_, 0);
+            DLOG(INFO) << "disconnected valve";
+            last = valve_;
+        }
+    if (dump_)
+        {
+            top_block->disconnect(last, 0, sink_, 0);
+            DLOG(INFO) << "disconnected file sink";
+        }
+}
+
+
+
+gr::basic_block_sptr MmapFileSignalSource::get_left_block()
+{
+    LOG(WARNING) << "Left block of a signal source should not be retrieved";
+    return gr::block_sptr();
+}
+
+
+
+gr::basic_block_sptr MmapFileSignalSource::get_right_block()
+{
+    if (samples_ > 0)
+        {
+            return valve_;
+        }
+    else if (enable_throttle_control_ == true)
+        {
+            return throttle_;
+        }
+    else
+        {
+            return file_source_;
+        }
+}
@@ -66,6 +66,7 @@ OsmosdrSignalSource::OsmosdrSignalSource(ConfigurationInterface* configuration,
     sample_rate_ = configuration->property(role + ".sampling_frequency", (double)2.0e6);
     item_type_ = configuration->property(role + ".item_type", default_item_type);
     osmosdr_args_ = configuration->property(role + ".osmosdr_args", std::string( ));
+    overflow_monitor_enabled_ = configuration->property(role + ".overflow_monitor", true);
 
     if (item_type_.compare("short") == 0)
         {
@@ -139,6 +140,14 @@ OsmosdrSignalSource::OsmosdrSignalSource(ConfigurationInterface* configuration,
             file_sink_ = gr::blocks::file_sink::make(item_size_, dump_filename_.c_str());
             DLOG(INFO) << "file_sink(" << file_sink_->unique_id() << ")";
         }
+
+    // only the UHD backend tags the samples after an overflow, the monitor
+    // counts nothing with the other ones
+    if (overflow_monitor_enabled_ && osmosdr_source_)
+        {
+            overflow_monitor_ = gnss_sdr_make_overflow_monitor(item_size_, osmosdr_source_->get_sample_rate(), 0, queue_);
+            DLOG(INFO) << "overflow_monitor(" << overflow_monitor_->unique_id() << ")";
+        }
 }
 
 
@@ -168,6 +177,11 @@ void OsmosdrSignalSource::connect(gr::top_block_sptr top_block)
                     DLOG(INFO) << "connected osmosdr source to file sink";
                 }
         }
+    if (overflow_monitor_)
+        {
+            top_block->connect(osmosdr_source_, 0, overflow_monitor_, 0);
+            DLOG(INFO) << "connected osmosdr source to overflow monitor";
+        }
 }
 
 
@@ -189,6 +203,10 @@ void OsmosdrSignalSource::disconnect(gr::top_block_sptr top_block)
                     top_block->disconnect(osmosdr_source_, 0, file_sink_, 0);
                 }
         }
+    if (overflow_monitor_)
+        {
+            top_block->disconnect(osmosdr_source_, 0, overflow_monitor_, 0);
+        }
 }
 
 
@@ -38,6 +38,7 @@
 #include <gnuradio/msg_queue.h>
 #include <gnuradio/blocks/file_sink.h>
 #include <osmosdr/source.h>
+#include "gnss_sdr_overflow_monitor.h"
 #include "gnss_block_interface.h"
 
 class ConfigurationInterface;
@@ -101,9 +102,11 @@ private:
 
     osmosdr::source::sptr osmosdr_source_;
     std::string osmosdr_args_;
+    bool overflow_monitor_enabled_;
 
     boost::shared_ptr<gr::block> valve_;
     gr::blocks::file_sink::sptr file_sink_;
+    gnss_sdr_overflow_monitor_sptr overflow_monitor_;
     boost::shared_ptr<gr::msg_queue> queue_;
 };
 
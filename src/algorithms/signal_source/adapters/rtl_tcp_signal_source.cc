@@ -69,6 +69,8 @@ RtlTcpSignalSource::RtlTcpSignalSource(ConfigurationInterface* configuration,
     address_ = configuration->property(role + ".address", default_address);
     port_ = configuration->property(role + ".port", default_port);
     flip_iq_ = configuration->property(role + ".flip_iq", false);
+    buffer_size_ = configuration->property(role + ".buffer_size", 8 * 1024 * 1024u);
+    read_size_ = configuration->property(role + ".read_size", 256 * 1024u);
 
     if (item_type_.compare("short") == 0)
         {
@@ -82,7 +84,8 @@ RtlTcpSignalSource::RtlTcpSignalSource(ConfigurationInterface* configuration,
             {
                     std::cout << "Connecting to " << address_ << ":" << port_ << std::endl;
                     LOG (INFO) << "Connecting to " << address_ << ":" << port_;
-                    signal_source_ = rtl_tcp_make_signal_source_c (address_, port_, flip_iq_);
+                    signal_source_ = rtl_tcp_make_signal_source_c (address_, port_, flip_iq_,
+                            buffer_size_, read_size_);
             }
             catch( boost::exception & e )
             {
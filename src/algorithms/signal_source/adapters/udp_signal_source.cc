@@ -0,0 +1,180 @@
+/*!
+ * \file udp_signal_source.cc
+ * \brief Signal source of the samples that a network front end streams in
+ * raw or VITA-49 UDP packets
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "udp_signal_source.h"
+#include <glog/logging.h>
+#include <volk/volk_complex.h>
+#include "configuration_interface.h"
+#include "gnss_sdr_valve.h"
+
+using google::LogMessage;
+
+
+UdpSignalSource::UdpSignalSource(ConfigurationInterface* configuration,
+        std::string role, unsigned int in_stream, unsigned int out_stream,
+        boost::shared_ptr<gr::msg_queue> queue) :
+                role_(role), in_stream_(in_stream), out_stream_(out_stream),
+                queue_(queue)
+{
+    std::string default_address = "0.0.0.0";
+    std::string default_format = "vita49";
+    std::string default_sample_type = "16ic";
+    std::string default_item_type = "cshort";
+    std::string default_dump_file = "./data/signal_source.dat";
+    // 4991 is the port of the VITA Radio Transport
+    address_ = configuration->property(role + ".address", default_address);
+    port_ = configuration->property(role + ".port", static_cast<unsigned short>(4991));
+    payload_format_ = configuration->property(role + ".payload_format", default_format);
+    sample_type_ = configuration->property(role + ".sample_type", default_sample_type);
+    big_endian_ = configuration->property(role + ".big_endian", payload_format_ == "vita49");
+    batch_size_ = configuration->property(role + ".batch_size", 64u);
+    max_packet_size_ = configuration->property(role + ".max_packet_size", 9000u);
+    buffer_size_ = configuration->property(role + ".buffer_size", 64 * 1024 * 1024u);
+    socket_buffer_size_ = configuration->property(role + ".socket_buffer_size", 32 * 1024 * 1024u);
+    item_type_ = configuration->property(role + ".item_type", default_item_type);
+    samples_ = configuration->property(role + ".samples", 0);
+    dump_ = configuration->property(role + ".dump", false);
+    dump_filename_ = configuration->property(role + ".dump_filename", default_dump_file);
+
+    Udp_Payload_Format format;
+    if (!udp_payload_format(payload_format_, format))
+        {
+            LOG(WARNING) << payload_format_ << " unrecognized payload format. Using raw.";
+            format = UDP_PAYLOAD_RAW;
+        }
+    unsigned int sample_bits = 16;
+    if (sample_type_ == "8ic")
+        {
+            sample_bits = 8;
+        }
+    else if (sample_type_ != "16ic")
+        {
+            LOG(WARNING) << sample_type_ << " unrecognized sample type. Using 16ic.";
+        }
+
+    // The integer items are the samples as received, so their size follows the packets
+    const std::string integer_type = sample_bits == 8 ? "cbyte" : "cshort";
+    if (item_type_ == "gr_complex")
+        {
+            item_size_ = sizeof(gr_complex);
+        }
+    else
+        {
+            if (item_type_ != integer_type)
+                {
+                    LOG(WARNING) << item_type_ << " is not an item type for " << sample_type_
+                                 << " samples. Using " << integer_type << ".";
+                }
+            item_type_ = integer_type;
+            item_size_ = sample_bits == 8 ? sizeof(lv_8sc_t) : sizeof(lv_16sc_t);
+        }
+
+    signal_source_ = make_udp_sample_source(address_, port_, format, sample_bits, big_endian_,
+            item_type_ == "gr_complex", batch_size_, max_packet_size_, buffer_size_,
+            socket_buffer_size_, queue_);
+    DLOG(INFO) << "udp_sample_source(" << signal_source_->unique_id() << ") on "
+               << address_ << ":" << port_ << ", " << payload_format_ << " packets of " << sample_type_ << " samples";
+
+    if (samples_ != 0)
+        {
+            DLOG(INFO) << "Send STOP signal after " << samples_ << " samples";
+            valve_ = gnss_sdr_make_valve(item_size_, samples_, queue_);
+            DLOG(INFO) << "valve(" << valve_->unique_id() << ")";
+        }
+
+    if (dump_)
+        {
+            DLOG(INFO) << "Dumping output into file " << dump_filename_;
+            file_sink_ = gr::blocks::file_sink::make(item_size_, dump_filename_.c_str());
+            DLOG(INFO) << "file_sink(" << file_sink_->unique_id() << ")";
+        }
+}
+
+
+UdpSignalSource::~UdpSignalSource()
+{}
+
+
+void UdpSignalSource::connect(gr::top_block_sptr top_block)
+{
+    if (samples_ != 0)
+        {
+            top_block->connect(signal_source_, 0, valve_, 0);
+            DLOG(INFO) << "connected udp source to valve";
+            if (dump_)
+                {
+                    top_block->connect(valve_, 0, file_sink_, 0);
+                    DLOG(INFO) << "connected valve to file sink";
+                }
+        }
+    else if (dump_)
+        {
+            top_block->connect(signal_source_, 0, file_sink_, 0);
+            DLOG(INFO) << "connected udp source to file sink";
+        }
+}
+
+
+void UdpSignalSource::disconnect(gr::top_block_sptr top_block)
+{
+    if (samples_ != 0)
+        {
+            top_block->disconnect(signal_source_, 0, valve_, 0);
+            if (dump_)
+                {
+                    top_block->disconnect(valve_, 0, file_sink_, 0);
+                }
+        }
+    else if (dump_)
+        {
+            top_block->disconnect(signal_source_, 0, file_sink_, 0);
+        }
+}
+
+
+gr::basic_block_sptr UdpSignalSource::get_left_block()
+{
+    LOG(WARNING) << "Trying to get signal source left block.";
+    return gr::basic_block_sptr();
+}
+
+
+gr::basic_block_sptr UdpSignalSource::get_right_block()
+{
+    if (samples_ != 0)
+        {
+            return valve_;
+        }
+    else
+        {
+            return signal_source_;
+        }
+}
@@ -0,0 +1,108 @@
+/*!
+ * \file udp_signal_source.h
+ * \brief Signal source of the samples that a network front end streams in
+ * raw or VITA-49 UDP packets
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_UDP_SIGNAL_SOURCE_ADAPTER_H_
+#define GNSS_SDR_UDP_SIGNAL_SOURCE_ADAPTER_H_
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include <gnuradio/msg_queue.h>
+#include <gnuradio/blocks/file_sink.h>
+#include "gnss_block_interface.h"
+#include "udp_sample_source.h"
+
+class ConfigurationInterface;
+
+/*!
+ * \brief Receives interleaved 8-bit (8ic) or 16-bit (16ic) I/Q samples in
+ * UDP packets. With item_type=cbyte or cshort the samples are output as
+ * they are, for the data type adapters; with gr_complex they are converted.
+ */
+class UdpSignalSource: public GNSSBlockInterface
+{
+public:
+    UdpSignalSource(ConfigurationInterface* configuration,
+            std::string role, unsigned int in_stream,
+            unsigned int out_stream, boost::shared_ptr<gr::msg_queue> queue);
+
+    virtual ~UdpSignalSource();
+
+    std::string role()
+    {
+        return role_;
+    }
+
+    /*!
+     * \brief Returns "UDP_Signal_Source"
+     */
+    std::string implementation()
+    {
+        return "UDP_Signal_Source";
+    }
+
+    size_t item_size()
+    {
+        return item_size_;
+    }
+
+    void connect(gr::top_block_sptr top_block);
+    void disconnect(gr::top_block_sptr top_block);
+    gr::basic_block_sptr get_left_block();
+    gr::basic_block_sptr get_right_block();
+
+private:
+    std::string role_;
+    unsigned int in_stream_;
+    unsigned int out_stream_;
+
+    std::string address_;
+    unsigned short port_;
+    std::string payload_format_;
+    std::string sample_type_;
+    bool big_endian_;
+    unsigned int batch_size_;
+    unsigned int max_packet_size_;
+    unsigned int buffer_size_;
+    unsigned int socket_buffer_size_;
+
+    std::string item_type_;
+    size_t item_size_;
+    long samples_;
+    bool dump_;
+    std::string dump_filename_;
+
+    udp_sample_source_sptr signal_source_;
+    boost::shared_ptr<gr::block> valve_;
+    gr::blocks::file_sink::sptr file_sink_;
+    boost::shared_ptr<gr::msg_queue> queue_;
+};
+
+#endif /*GNSS_SDR_UDP_SIGNAL_SOURCE_ADAPTER_H_*/
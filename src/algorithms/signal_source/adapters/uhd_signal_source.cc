@@ -68,6 +68,8 @@ UhdSignalSource::UhdSignalSource(ConfigurationInterface* configuration,
     RF_channels_ = configuration->property(role + ".RF_channels", 1);
     sample_rate_ = configuration->property(role + ".sampling_frequency", (double)4.0e6);
     item_type_ = configuration->property(role + ".item_type", default_item_type);
+    overflow_monitor_enabled_ = configuration->property(role + ".overflow_monitor", true);
+    min_output_buffer_ms_ = configuration->property(role + ".min_output_buffer_ms", 0.0);
 
     if (RF_channels_ == 1)
         {
@@ -161,6 +163,16 @@ UhdSignalSource::UhdSignalSource(ConfigurationInterface* configuration,
     std::cout << boost::format("Sampling Rate for the USRP device: %f [sps]...") % (uhd_source_->get_samp_rate()) << std::endl;
     LOG(INFO) << boost::format("Sampling Rate for the USRP device: %f [sps]...") % (uhd_source_->get_samp_rate());
 
+    // 2.3 make room for the samples of min_output_buffer_ms_ at the output of the usrp
+    // source, so that a slow start of the rest of the receiver does not overflow it
+    if (min_output_buffer_ms_ > 0.0)
+        {
+            long min_output_buffer = static_cast<long>(uhd_source_->get_samp_rate() * min_output_buffer_ms_ / 1000.0);
+            uhd_source_->set_min_output_buffer(min_output_buffer);
+            std::cout << "USRP source output buffer of at least " << min_output_buffer << " samples" << std::endl;
+            LOG(INFO) << "USRP source output buffer of at least " << min_output_buffer << " samples";
+        }
+
     std::vector<std::string> sensor_names;
 
     for (int i = 0; i < RF_channels_; i++)
@@ -224,6 +236,12 @@ UhdSignalSource::UhdSignalSource(ConfigurationInterface* configuration,
                     file_sink_.push_back(gr::blocks::file_sink::make(item_size_, dump_filename_.at(i).c_str()));
                     DLOG(INFO) << "file_sink(" << file_sink_.at(i)->unique_id() << ")";
                 }
+
+            if (overflow_monitor_enabled_)
+                {
+                    overflow_monitor_.push_back(gnss_sdr_make_overflow_monitor(item_size_, uhd_source_->get_samp_rate(), i, queue_));
+                    DLOG(INFO) << "overflow_monitor(" << overflow_monitor_.at(i)->unique_id() << ")";
+                }
         }
 }
 
@@ -255,6 +273,11 @@ void UhdSignalSource::connect(gr::top_block_sptr top_block)
                             DLOG(INFO) << "connected usrp source to file sink RF Channel " << i;
                         }
                 }
+            if (overflow_monitor_enabled_)
+                {
+                    top_block->connect(uhd_source_, i, overflow_monitor_.at(i), 0);
+                    DLOG(INFO) << "connected usrp source to overflow monitor RF Channel " << i;
+                }
         }
 }
 
@@ -280,6 +303,10 @@ void UhdSignalSource::disconnect(gr::top_block_sptr top_block)
                             top_block->disconnect(uhd_source_, i, file_sink_.at(i), 0);
                         }
                 }
+            if (overflow_monitor_enabled_)
+                {
+                    top_block->disconnect(uhd_source_, i, overflow_monitor_.at(i), 0);
+                }
         }
 }
 
@@ -39,6 +39,7 @@
 #include <gnuradio/blocks/file_sink.h>
 #include <gnuradio/msg_queue.h>
 #include "gnss_block_interface.h"
+#include "gnss_sdr_overflow_monitor.h"
 
 class ConfigurationInterface;
 
@@ -95,6 +96,8 @@ private:
 
     std::string subdevice_;
     std::string clock_source_;
+    bool overflow_monitor_enabled_;
+    double min_output_buffer_ms_;
 
     std::vector<double> freq_;
     std::vector<double> gain_;
@@ -105,6 +108,7 @@ private:
 
     std::vector<boost::shared_ptr<gr::block>> valve_;
     std::vector<gr::blocks::file_sink::sptr> file_sink_;
+    std::vector<gnss_sdr_overflow_monitor_sptr> overflow_monitor_;
 
     boost::shared_ptr<gr::msg_queue> queue_;
 };
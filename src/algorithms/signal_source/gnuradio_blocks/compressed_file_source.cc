@@ -0,0 +1,194 @@
+/*!
+ * \file compressed_file_source.cc
+ * \brief Source of the samples of a compressed capture, decompressed in parallel
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "compressed_file_source.h"
+#include "gnss_sdr_trace.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+
+using google::LogMessage;
+
+
+compressed_file_source_sptr make_compressed_file_source(std::shared_ptr<Compressed_Capture_Reader> reader,
+        size_t item_size, unsigned long long first_item, bool repeat, unsigned int threads)
+{
+    return compressed_file_source_sptr(new compressed_file_source(reader, item_size, first_item, repeat, threads));
+}
+
+
+compressed_file_source::compressed_file_source(std::shared_ptr<Compressed_Capture_Reader> reader,
+        size_t item_size, unsigned long long first_item, bool repeat, unsigned int threads) :
+        gr::sync_block("compressed_file_source",
+                gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(1, 1, item_size))
+{
+    if (!reader || item_size == 0 || reader->chunks() == 0 || reader->chunk_bytes() % item_size != 0
+            || reader->raw_bytes() / item_size <= first_item)
+        {
+            throw std::runtime_error("compressed_file_source: no items in the capture");
+        }
+    d_reader = reader;
+    d_item_size = item_size;
+    d_first_item = first_item;
+    d_repeat = repeat;
+    const unsigned long long first_byte = first_item * item_size;
+    d_first_chunk = static_cast<size_t>(first_byte / reader->chunk_bytes());
+    d_first_offset = static_cast<size_t>(first_byte % reader->chunk_bytes());
+    d_sequences = reader->chunks() - d_first_chunk;
+    d_next_decode = 0;
+    d_next_output = 0;
+    d_offset = d_first_offset;
+    d_stop = false;
+    d_failed = false;
+
+    threads = std::max(threads, 1u);
+    d_slots.resize(2 * threads);
+    for (size_t s = 0; s < d_slots.size(); s++)
+        {
+            d_slots[s].data.resize(reader->chunk_bytes());
+            d_slots[s].ready = false;
+            d_slots[s].sequence = 0;
+        }
+    for (unsigned int t = 0; t < threads; t++)
+        {
+            d_threads.push_back(std::thread([this]() { decompress(); }));
+        }
+    DLOG(INFO) << "Compressed capture of " << reader->chunks() << " chunks of " << reader->chunk_bytes()
+               << " bytes, " << threads << " decompression threads";
+}
+
+
+compressed_file_source::~compressed_file_source()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_stop = true;
+    }
+    d_released.notify_all();
+    for (size_t t = 0; t < d_threads.size(); t++)
+        {
+            d_threads[t].join();
+        }
+}
+
+
+size_t compressed_file_source::chunk_of(unsigned long long sequence) const
+{
+    // the first pass starts at the first item, and the next ones at the start of the capture
+    if (sequence < d_sequences)
+        {
+            return d_first_chunk + static_cast<size_t>(sequence);
+        }
+    return static_cast<size_t>((sequence - d_sequences) % d_reader->chunks());
+}
+
+
+void compressed_file_source::decompress()
+{
+    std::vector<unsigned char> scratch;
+    std::unique_lock<std::mutex> lock(d_mutex);
+    for (;;)
+        {
+            // the slot of the next chunk is free once work() is done with the one before
+            while (!d_stop && ((!d_repeat && d_next_decode >= d_sequences)
+                    || d_next_decode >= d_next_output + d_slots.size()))
+                {
+                    d_released.wait(lock);
+                }
+            if (d_stop) return;
+            const unsigned long long sequence = d_next_decode++;
+            Slot & slot = d_slots[sequence % d_slots.size()];
+            lock.unlock();
+
+            const size_t chunk = chunk_of(sequence);
+            const bool ok = d_reader->read_chunk(chunk, slot.data.data(), scratch);
+            if (!ok)
+                {
+                    LOG(ERROR) << "Chunk " << chunk << " of the compressed capture is corrupt";
+                    d_failed = true;
+                }
+
+            lock.lock();
+            slot.sequence = sequence;
+            slot.ready = true;
+            d_decoded.notify_all();
+        }
+}
+
+
+int compressed_file_source::work(int noutput_items,
+        gr_vector_const_void_star &input_items __attribute__((unused)),
+        gr_vector_void_star &output_items)
+{
+    GNSS_SDR_TRACE_SCOPE("compressed_file_source::work");
+    unsigned char * out = static_cast<unsigned char *>(output_items[0]);
+    const size_t wanted = static_cast<size_t>(noutput_items) * d_item_size;
+    size_t produced = 0;
+    std::unique_lock<std::mutex> lock(d_mutex);
+    while (produced < wanted)
+        {
+            if (!d_repeat && d_next_output >= d_sequences)
+                {
+                    break;
+                }
+            Slot & slot = d_slots[d_next_output % d_slots.size()];
+            while (!(slot.ready && slot.sequence == d_next_output))
+                {
+                    d_decoded.wait(lock);
+                }
+            if (d_failed.load())
+                {
+                    return WORK_DONE;
+                }
+            // whole items only: a partial one at the end of the capture is not output
+            const size_t size = d_reader->chunk_size(chunk_of(d_next_output)) / d_item_size * d_item_size;
+            const size_t n = std::min(wanted - produced, size - std::min(d_offset, size));
+            lock.unlock();
+            std::memcpy(out + produced, slot.data.data() + d_offset, n);
+            lock.lock();
+            produced += n;
+            d_offset += n;
+            if (d_offset >= size)
+                {
+                    slot.ready = false;
+                    d_next_output++;
+                    d_offset = 0;
+                    d_released.notify_all();
+                }
+        }
+    if (produced == 0)
+        {
+            return WORK_DONE;
+        }
+    return static_cast<int>(produced / d_item_size);
+}
@@ -0,0 +1,116 @@
+/*!
+ * \file compressed_file_source.h
+ * \brief Source of the samples of a compressed capture, decompressed in parallel
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_COMPRESSED_FILE_SOURCE_H_
+#define GNSS_SDR_COMPRESSED_FILE_SOURCE_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <gnuradio/sync_block.h>
+#include "compressed_capture.h"
+
+class compressed_file_source;
+typedef boost::shared_ptr<compressed_file_source> compressed_file_source_sptr;
+
+/*!
+ * \brief Makes a source of the items of \p item_size bytes of an open
+ * compressed capture, from item \p first_item, with \p threads threads
+ * decompressing chunks ahead. Throws std::runtime_error if there are no
+ * items after the first one.
+ */
+compressed_file_source_sptr make_compressed_file_source(std::shared_ptr<Compressed_Capture_Reader> reader,
+        size_t item_size, unsigned long long first_item, bool repeat, unsigned int threads);
+
+/*!
+ * \brief Outputs the items of a compressed capture, as File_Signal_Source
+ * would output the raw file.
+ *
+ * The worker threads decompress the next chunks, in any order, into 2 x
+ * threads slots, and work() copies them out in order. Decompressing one
+ * chunk is serial, so it is the threads that make the source faster than
+ * a wide front end streams. With repeat, the capture is read again from
+ * its first item after its last one.
+ */
+class compressed_file_source : public gr::sync_block
+{
+private:
+    friend compressed_file_source_sptr make_compressed_file_source(std::shared_ptr<Compressed_Capture_Reader> reader,
+            size_t item_size, unsigned long long first_item, bool repeat, unsigned int threads);
+
+    compressed_file_source(std::shared_ptr<Compressed_Capture_Reader> reader,
+            size_t item_size, unsigned long long first_item, bool repeat, unsigned int threads);
+
+    struct Slot
+    {
+        std::vector<unsigned char> data;
+        unsigned long long sequence;  // position of the chunk in the output, see chunk_of()
+        bool ready;
+    };
+
+    size_t chunk_of(unsigned long long sequence) const;
+    void decompress();  // worker thread
+
+    std::shared_ptr<Compressed_Capture_Reader> d_reader;
+    size_t d_item_size;
+    unsigned long long d_first_item;
+    bool d_repeat;
+    size_t d_first_chunk;
+    size_t d_first_offset;                 // [bytes] in the first chunk
+    unsigned long long d_sequences;        // chunks to output, unless repeat
+
+    std::vector<Slot> d_slots;             // chunk sequence s goes to slot s % size
+    std::vector<std::thread> d_threads;
+    std::mutex d_mutex;
+    std::condition_variable d_decoded;     // a slot is ready
+    std::condition_variable d_released;    // a slot is free
+    unsigned long long d_next_decode;      // next sequence for the workers
+    unsigned long long d_next_output;      // sequence being output by work()
+    size_t d_offset;                       // [bytes] in it
+    bool d_stop;
+    std::atomic<bool> d_failed;
+
+public:
+    ~compressed_file_source();
+
+    //! Items of the capture after the first one
+    unsigned long long items() const
+    {
+        return d_reader->raw_bytes() / d_item_size - d_first_item;
+    }
+
+    int work(int noutput_items, gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif /* GNSS_SDR_COMPRESSED_FILE_SOURCE_H_ */
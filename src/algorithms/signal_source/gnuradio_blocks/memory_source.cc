@@ -0,0 +1,92 @@
+/*!
+ * \file memory_source.cc
+ * \brief GNU Radio source of the items of a buffer in memory
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "memory_source.h"
+#include "gnss_sdr_trace.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <gnuradio/io_signature.h>
+
+
+memory_source_sptr make_memory_source(size_t item_size, const void * data, size_t bytes,
+        unsigned long long offset, bool repeat)
+{
+    return memory_source_sptr(new memory_source(item_size, data, bytes, offset, repeat));
+}
+
+
+memory_source::memory_source(size_t item_size, const void * data, size_t bytes,
+        unsigned long long offset, bool repeat) :
+        gr::sync_block("memory_source",
+                gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(1, 1, item_size))
+{
+    if (data == nullptr || item_size == 0 || offset >= bytes || (bytes - offset) / item_size == 0)
+        {
+            throw std::runtime_error("memory_source: no items in the buffer");
+        }
+    d_item_size = item_size;
+    d_start = static_cast<const char *>(data) + offset;
+    d_items = (bytes - offset) / item_size;
+    d_next = 0;
+    d_repeat = repeat;
+}
+
+
+memory_source::~memory_source()
+{}
+
+
+int memory_source::work(int noutput_items,
+        gr_vector_const_void_star &input_items __attribute__((unused)),
+        gr_vector_void_star &output_items)
+{
+    GNSS_SDR_TRACE_SCOPE("memory_source::work");
+    char * out = static_cast<char *>(output_items[0]);
+    unsigned long long produced = 0;
+    while (produced < static_cast<unsigned long long>(noutput_items))
+        {
+            if (d_next == d_items)
+                {
+                    if (!d_repeat) break;
+                    d_next = 0;
+                }
+            const unsigned long long n = std::min(static_cast<unsigned long long>(noutput_items) - produced, d_items - d_next);
+            std::memcpy(out + produced * d_item_size, d_start + d_next * d_item_size, n * d_item_size);
+            d_next += n;
+            produced += n;
+        }
+    if (produced == 0)
+        {
+            return WORK_DONE;
+        }
+    return produced;
+}
@@ -0,0 +1,78 @@
+/*!
+ * \file memory_source.h
+ * \brief GNU Radio source of the items of a buffer in memory
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MEMORY_SOURCE_H_
+#define GNSS_SDR_MEMORY_SOURCE_H_
+
+#include <gnuradio/sync_block.h>
+
+class memory_source;
+
+typedef boost::shared_ptr<memory_source> memory_source_sptr;
+
+/*!
+ * \brief The buffer is not copied, and must outlive the block. Throws
+ * std::runtime_error if it has no items after the first offset bytes.
+ */
+memory_source_sptr make_memory_source(size_t item_size, const void * data, size_t bytes,
+        unsigned long long offset, bool repeat);
+
+/*!
+ * \brief Outputs the whole items of a buffer, from its first offset bytes
+ * to its end, or forever with repeat.
+ */
+class memory_source: public gr::sync_block
+{
+private:
+    friend memory_source_sptr make_memory_source(size_t item_size, const void * data, size_t bytes,
+            unsigned long long offset, bool repeat);
+    memory_source(size_t item_size, const void * data, size_t bytes,
+            unsigned long long offset, bool repeat);
+
+    size_t d_item_size;
+    const char * d_start;
+    unsigned long long d_items;
+    unsigned long long d_next;
+    bool d_repeat;
+
+public:
+    ~memory_source();
+
+    //! Items in the buffer after the offset
+    unsigned long long items() const
+    {
+        return d_items;
+    }
+
+    int work(int noutput_items, gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif
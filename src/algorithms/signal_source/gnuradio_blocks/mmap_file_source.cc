@@ -0,0 +1,72 @@
+/*!
+ * \file mmap_file_source.cc
+ * \brief GNU Radio source that reads a sample file through a memory map.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "mmap_file_source.h"
+#include "gnss_sdr_trace.h"
+#include <stdexcept>
+#include <gnuradio/io_signature.h>
+
+
+mmap_file_source_sptr make_mmap_file_source(size_t item_size, const std::string & filename,
+        unsigned long long offset, bool repeat, size_t window_size)
+{
+    return mmap_file_source_sptr(new mmap_file_source(item_size, filename, offset, repeat, window_size));
+}
+
+
+mmap_file_source::mmap_file_source(size_t item_size, const std::string & filename,
+        unsigned long long offset, bool repeat, size_t window_size) :
+        gr::sync_block("mmap_file_source",
+                gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(1, 1, item_size))
+{
+    if (!d_reader.open(filename, item_size, offset, repeat, window_size))
+        {
+            throw std::runtime_error("mmap_file_source: cannot map " + filename);
+        }
+}
+
+
+mmap_file_source::~mmap_file_source()
+{}
+
+
+int mmap_file_source::work(int noutput_items,
+        gr_vector_const_void_star &input_items __attribute__((unused)),
+        gr_vector_void_star &output_items)
+{
+    GNSS_SDR_TRACE_SCOPE("mmap_file_source::work");
+    const size_t n = d_reader.read(output_items[0], noutput_items);
+    if (n == 0)
+        {
+            return WORK_DONE;
+        }
+    return n;
+}
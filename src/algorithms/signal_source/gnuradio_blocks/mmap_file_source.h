@@ -0,0 +1,81 @@
+/*!
+ * \file mmap_file_source.h
+ * \brief GNU Radio source that reads a sample file through a memory map.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Replacement of gr::blocks::file_source for long captures: the samples are
+ * copied once, from the page cache to the output buffer, by a
+ * Mmap_File_Reader, instead of being read into a staging buffer and then
+ * copied to the output buffer.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MMAP_FILE_SOURCE_H_
+#define GNSS_SDR_MMAP_FILE_SOURCE_H_
+
+#include <string>
+#include <gnuradio/sync_block.h>
+#include "mmap_file_reader.h"
+
+class mmap_file_source;
+
+typedef boost::shared_ptr<mmap_file_source> mmap_file_source_sptr;
+
+/*!
+ * \brief Throws std::runtime_error if the file cannot be opened or has no
+ * items after the first offset bytes.
+ */
+mmap_file_source_sptr make_mmap_file_source(size_t item_size, const std::string & filename,
+        unsigned long long offset, bool repeat, size_t window_size = MMAP_FILE_READER_DEFAULT_WINDOW_SIZE);
+
+/*!
+ * \brief Outputs the items of a file, from its first offset bytes to its
+ * end, or forever with repeat.
+ */
+class mmap_file_source: public gr::sync_block
+{
+private:
+    friend mmap_file_source_sptr make_mmap_file_source(size_t item_size, const std::string & filename,
+            unsigned long long offset, bool repeat, size_t window_size);
+    mmap_file_source(size_t item_size, const std::string & filename,
+            unsigned long long offset, bool repeat, size_t window_size);
+
+    Mmap_File_Reader d_reader;
+
+public:
+    ~mmap_file_source();
+
+    //! Items in the file after the offset
+    unsigned long long items() const
+    {
+        return d_reader.items();
+    }
+
+    int work(int noutput_items, gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif
@@ -32,59 +32,63 @@
 
 #include "rtl_tcp_signal_source_c.h"
 #include "rtl_tcp_commands.h"
-#include <glog/logging.h>
-#include <boost/thread/thread.hpp>
+#include "gnss_sdr_trace.h"
+#include <algorithm>
 #include <map>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <glog/logging.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
 
 using google::LogMessage;
 
 namespace ip = boost::asio::ip;
 using boost::asio::ip::tcp;
 
-// Buffer constants
-// TODO: Make these configurable
-enum {
-    RTL_TCP_BUFFER_SIZE = 1024 * 16, // 16 KB
-    RTL_TCP_PAYLOAD_SIZE = 1024 * 4  //  4 KB
-};
+// Zero level of the unsigned samples of the RTL2832U
+#define RTL_TCP_SAMPLE_OFFSET 127.4f
 
 rtl_tcp_signal_source_c_sptr
 rtl_tcp_make_signal_source_c(const std::string &address,
         short port,
-        bool flip_iq)
+        bool flip_iq,
+        size_t buffer_size,
+        size_t read_size)
 {
     return gnuradio::get_initial_sptr (new rtl_tcp_signal_source_c (address,
             port,
-            flip_iq));
+            flip_iq,
+            buffer_size,
+            read_size));
 }
 
 
 rtl_tcp_signal_source_c::rtl_tcp_signal_source_c(const std::string &address,
         short port,
-        bool flip_iq)
+        bool flip_iq,
+        size_t buffer_size,
+        size_t read_size)
 : gr::sync_block ("rtl_tcp_signal_source_c",
         gr::io_signature::make(0, 0, 0),
         gr::io_signature::make(1, 1, sizeof(gr_complex))),
         socket_ (io_service_),
-        data_ (RTL_TCP_PAYLOAD_SIZE),
+        overflow_data_ (std::max<size_t> (read_size & ~static_cast<size_t> (1), 2)), // whole samples
+        read_size_ (overflow_data_.size ()),
         flip_iq_(flip_iq),
-        buffer_ (RTL_TCP_BUFFER_SIZE),
-        unread_ (0)
+        buffer_ (std::max (buffer_size, read_size_)),
+        stopped_ (false),
+        overflows_ (0),
+        dropped_bytes_ (0)
 {
     boost::system::error_code ec;
 
-    // 1. Setup lookup table
-    for (unsigned i = 0; i < 0xff; i++)
-        {
-            lookup_[i] = ((float)(i & 0xff) - 127.4f) * (1.0f / 128.0f);
-        }
-
-    // 2. Set socket options
+    // 1. Set socket options
     ip::address addr = ip::address::from_string (address, ec);
     if (ec)
         {
             std::cout << address << " is not an IP address" << std::endl;
             LOG (ERROR) << address << " is not an IP address";
+            stopped_ = true;
             return;
         }
     ip::tcp::endpoint ep (addr, port);
@@ -108,7 +112,7 @@ rtl_tcp_signal_source_c::rtl_tcp_signal_source_c(const std::string &address,
             LOG (WARNING)  << "Failed to set linger option";
         }
 
-    // 3. Connect socket
+    // 2. Connect socket
 
     socket_.connect(ep, ec);
     if (ec)
@@ -117,20 +121,26 @@ rtl_tcp_signal_source_c::rtl_tcp_signal_source_c(const std::string &address,
                     << "(" << ec << ")" << std::endl;
             LOG (ERROR)  << "Failed to connect to " << addr << ":" << port
                     << "(" << ec << ")";
+            stopped_ = true;
             return;
         }
     std::cout << "Connected to " << addr << ":" << port << std::endl;
     LOG (INFO)  << "Connected to " << addr << ":" << port;
 
-    // 4. Set nodelay
+    // 3. Set nodelay and a receive buffer of at least one batch
     socket_.set_option (tcp::no_delay (true), ec);
     if (ec)
         {
             std::cout << "Failed to set no delay option." << std::endl;
             LOG (WARNING)  << "Failed to set no delay option";
         }
+    socket_.set_option (boost::asio::socket_base::receive_buffer_size (read_size_), ec);
+    if (ec)
+        {
+            LOG (WARNING)  << "Failed to set receive buffer size option";
+        }
 
-    // 5. Receive dongle info
+    // 4. Receive dongle info
     ec = info_.read (socket_);
     if (ec)
         {
@@ -143,17 +153,26 @@ rtl_tcp_signal_source_c::rtl_tcp_signal_source_c(const std::string &address,
             LOG (INFO)  << "Found " << info_.get_type_name() << " tuner.";
         }
 
-    // 6. Start reading
-    boost::asio::async_read (socket_, boost::asio::buffer (data_),
-            boost::bind (&rtl_tcp_signal_source_c::handle_read,
-                    this, _1, _2));
+    // 5. Start reading
+    LOG (INFO) << "rtl_tcp ring buffer of " << buffer_.capacity () << " bytes, reads of up to "
+               << read_size_ << " bytes";
+    start_read ();
     boost::thread (boost::bind (&boost::asio::io_service::run, &io_service_));
 }
 
 
 rtl_tcp_signal_source_c::~rtl_tcp_signal_source_c()
 {
-   io_service_.stop ();
+    io_service_.stop ();
+    if (overflows_.load () > 0)
+        {
+            LOG (WARNING) << "rtl_tcp ring buffer overflowed " << overflows_.load ()
+                          << " times, " << dropped_bytes_.load () << " bytes dropped";
+        }
+    else
+        {
+            LOG (INFO) << "rtl_tcp ring buffer never overflowed";
+        }
 }
 
 
@@ -161,34 +180,43 @@ int rtl_tcp_signal_source_c::work (int noutput_items,
         gr_vector_const_void_star &/*input_items*/,
         gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE("rtl_tcp_signal_source_c::work");
     gr_complex *out = reinterpret_cast <gr_complex *>( output_items[0] );
-    int i = 0;
-    if (io_service_.stopped ())
+
+    // wait for a whole sample, or for the end of the stream
+    while (buffer_.wait_readable (2, 100) < 2)
         {
-            return -1;
+            if (stopped_.load ())
+                {
+                    return -1;
+                }
         }
 
-    {
-        boost::mutex::scoped_lock lock (mutex_);
-        not_empty_.wait (lock, boost::bind (&rtl_tcp_signal_source_c::not_empty,
-                this));
-
-        for ( ; i < noutput_items && unread_ > 1; i++ )
-            {
-                float re = buffer_[--unread_];
-                float im = buffer_[--unread_];
-                if (flip_iq_)
-                    {
-                        out[i] = gr_complex (im, re);
-                    }
-                else
-                    {
-                        out[i] = gr_complex (re, im);
-                    }
-            }
-    }
-    not_full_.notify_one ();
-    return i == 0 ? -1 : i;
+    // the reads are always of whole samples and the size of the ring is
+    // even, so a sample is never split at the end of the storage
+    int produced = 0;
+    while (produced < noutput_items)
+        {
+            size_t size = 0;
+            const unsigned char *in = buffer_.read_region (size);
+            const int n = static_cast<int> (std::min (static_cast<size_t> (noutput_items - produced), size / 2));
+            if (n == 0)
+                {
+                    break;
+                }
+            volk_gnsssdr_8u_s32f_convert_32fc (out + produced, in, RTL_TCP_SAMPLE_OFFSET, n);
+            buffer_.commit_read (2 * n);
+            produced += n;
+        }
+
+    if (flip_iq_)
+        {
+            for (int i = 0; i < produced; i++)
+                {
+                    out[i] = gr_complex (out[i].imag (), out[i].real ());
+                }
+        }
+    return produced;
 }
 
 
@@ -314,6 +342,33 @@ void rtl_tcp_signal_source_c::set_if_gain (int gain)
 
 
 
+void rtl_tcp_signal_source_c::start_read ()
+{
+    size_t size = 0;
+    unsigned char *region = buffer_.write_region (size);
+    if (size > 0)
+        {
+            socket_.async_read_some (boost::asio::buffer (region, std::min (size, read_size_)),
+                    boost::bind (&rtl_tcp_signal_source_c::handle_read,
+                            this, _1, _2));
+        }
+    else
+        {
+            // the flowgraph does not keep up: keep reading the socket, so that
+            // the server does not fall behind, but drop a batch of samples
+            const unsigned long long overflows = ++overflows_;
+            if ((overflows & (overflows - 1)) == 0)
+                {
+                    LOG (WARNING) << "rtl_tcp ring buffer full, " << overflows << " overflows and "
+                                  << dropped_bytes_.load () << " bytes dropped so far";
+                }
+            boost::asio::async_read (socket_, boost::asio::buffer (overflow_data_),
+                    boost::bind (&rtl_tcp_signal_source_c::handle_overflow_read,
+                            this, _1, _2));
+        }
+}
+
+
 void rtl_tcp_signal_source_c::handle_read (const boost::system::error_code &ec,
         size_t bytes_transferred)
 {
@@ -321,41 +376,29 @@ void rtl_tcp_signal_source_c::handle_read (const boost::system::error_code &ec,
         {
             std::cout << "Error during read: " << ec << std::endl;
             LOG (WARNING) << "Error during read: " << ec;
-            boost::mutex::scoped_lock lock (mutex_);
+            stopped_ = true;
             io_service_.stop ();
-            not_empty_.notify_one ();
+            buffer_.notify ();
         }
     else
         {
-            {
-                // Unpack read data
-                boost::mutex::scoped_lock lock (mutex_);
-                not_full_.wait (lock,
-                        boost::bind (&rtl_tcp_signal_source_c::not_full,
-                                this));
-
-                for (size_t i = 0; i < bytes_transferred; i++)
-                    {
-                        while (!not_full( ))
-                            {
-                                // uh-oh, buffer overflow
-                                // wait until there's space for more
-                                not_empty_.notify_one (); // needed?
-                                not_full_.wait (lock,
-                                        boost::bind (&rtl_tcp_signal_source_c::not_full,
-                                                this));
-                            }
-
-                        buffer_.push_front (lookup_[data_[i]]);
-                        unread_++;
-                    }
-            }
-            // let woker know that more data is available
-            not_empty_.notify_one ();
-            // Read some more
-            boost::asio::async_read (socket_,
-                    boost::asio::buffer (data_),
-                    boost::bind (&rtl_tcp_signal_source_c::handle_read,
-                            this, _1, _2));
+            // let the worker know that more data is available, and read some more
+            buffer_.commit_write (bytes_transferred);
+            start_read ();
+        }
+}
+
+
+void rtl_tcp_signal_source_c::handle_overflow_read (const boost::system::error_code &ec,
+        size_t bytes_transferred)
+{
+    dropped_bytes_ += bytes_transferred;
+    if (ec)
+        {
+            handle_read (ec, 0);
+        }
+    else
+        {
+            start_read ();
         }
 }
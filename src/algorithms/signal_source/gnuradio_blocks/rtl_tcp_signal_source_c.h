@@ -7,8 +7,7 @@
  * sources. The data format and command structure is taken from the
  * original Osmocom rtl_tcp_source_f (http://git.osmocom.org/gr-osmosdr).
  * The aynchronous reading code comes from the examples provides
- * by Boost.Asio and the bounded buffer producer-consumer solution is
- * taken from the Boost.CircularBuffer examples (http://boost.org/).
+ * by Boost.Asio (http://boost.org/).
  *
  * -------------------------------------------------------------------------
  *
@@ -39,27 +38,40 @@
 #define    GNSS_SDR_RTL_TCP_SIGNAL_SOURCE_C_H
 
 #include "rtl_tcp_dongle_info.h"
+#include "byte_ring_buffer.h"
+#include <atomic>
 #include <boost/asio.hpp>
 #include <gnuradio/sync_block.h>
 #include <string>
-#include <boost/thread/mutex.hpp>
-#include <boost/thread/condition.hpp>
-#include <boost/array.hpp>
-#include <boost/circular_buffer.hpp>
+#include <vector>
 
 class rtl_tcp_signal_source_c;
 
 typedef boost::shared_ptr<rtl_tcp_signal_source_c>
         rtl_tcp_signal_source_c_sptr;
 
+/*!
+ * \brief Makes the source. \p buffer_size is the size in bytes of the ring
+ * between the socket and the flowgraph, and \p read_size the most bytes
+ * requested from the socket at once.
+ */
 rtl_tcp_signal_source_c_sptr
 rtl_tcp_make_signal_source_c(const std::string &address,
                              short port,
-                             bool flip_iq = false);
+                             bool flip_iq = false,
+                             size_t buffer_size = 8 * 1024 * 1024,
+                             size_t read_size = 256 * 1024);
 
 /*!
  * \brief This class reads interleaved I/Q samples
  * from an rtl_tcp server and outputs complex types.
+ *
+ * The thread of the socket reads large batches straight into a lock-free
+ * ring of bytes, and work() converts them into complex samples with
+ * VOLK_GNSSSDR. When the flowgraph does not keep up and the ring is full,
+ * the socket keeps being read, so that the server does not fall behind,
+ * and the bytes are dropped in whole samples. The overflows are counted
+ * and logged.
  */
 class rtl_tcp_signal_source_c : public gr::sync_block
 {
@@ -76,47 +88,55 @@ public:
     void set_gain (int gain);
     void set_if_gain (int gain);
 
-private:
-    typedef boost::circular_buffer_space_optimized<float> buffer_type;
+    //! Times the ring was found full by the socket thread
+    unsigned long long overflows () const
+    {
+        return overflows_.load ();
+    }
+
+    //! Bytes read from the socket and dropped because the ring was full
+    unsigned long long dropped_bytes () const
+    {
+        return dropped_bytes_.load ();
+    }
 
+private:
     friend rtl_tcp_signal_source_c_sptr
     rtl_tcp_make_signal_source_c(const std::string &address,
             short port,
-            bool flip_iq);
+            bool flip_iq,
+            size_t buffer_size,
+            size_t read_size);
 
     rtl_tcp_signal_source_c(const std::string &address,
             short port,
-            bool flip_iq);
+            bool flip_iq,
+            size_t buffer_size,
+            size_t read_size);
 
     rtl_tcp_dongle_info info_;
 
     // IO members
     boost::asio::io_service io_service_;
     boost::asio::ip::tcp::socket socket_;
-    std::vector<unsigned char> data_;
+    std::vector<unsigned char> overflow_data_; // where the bytes are read when the ring is full
+    size_t read_size_;
     bool flip_iq_;
 
-    // producer-consumer helpers
-    boost::mutex mutex_;
-    boost::condition not_full_;
-    boost::condition not_empty_;
-    buffer_type buffer_;
-    size_t unread_;
+    // producer-consumer ring, the socket thread is the only producer
+    Byte_Ring_Buffer buffer_;
+    std::atomic<bool> stopped_;
+    std::atomic<unsigned long long> overflows_;
+    std::atomic<unsigned long long> dropped_bytes_;
 
-    // lookup for scaling data
-    boost::array<float, 0xff> lookup_;
+    // issues the next read, into the ring or into overflow_data_ if it is full
+    void start_read ();
 
-    // async read callback
+    // async read callbacks
     void handle_read (const boost::system::error_code &ec,
             size_t bytes_transferred);
-
-    inline bool not_full ( ) const {
-        return unread_ < buffer_.capacity( );
-    }
-
-    inline bool not_empty ( ) const {
-        return unread_ > 0 || io_service_.stopped ();
-    }
+    void handle_overflow_read (const boost::system::error_code &ec,
+            size_t bytes_transferred);
 };
 
 #endif //GNSS_SDR_RTL_TCP_SIGNAL_SOURCE_C_H
@@ -0,0 +1,404 @@
+/*!
+ * \file udp_sample_source.cc
+ * \brief Source of the complex samples that a front end streams in UDP packets
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "udp_sample_source.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+#include "control_event_bus.h"
+#include "gnss_sdr_trace.h"
+
+using google::LogMessage;
+
+namespace
+{
+// Longest wait of the receiving thread and of work(), so that they see a stop
+const int POLL_TIMEOUT_MS = 100;
+
+/*
+ * Receives up to lengths.size() packets of up to max_size bytes into
+ * packets, without blocking. Returns the number of packets, or -1 on error.
+ * The length of a truncated packet is set to 0.
+ */
+class Batch_Receiver
+{
+public:
+    Batch_Receiver(unsigned char * packets, unsigned int batch, unsigned int max_size)
+        : d_packets(packets), d_batch(batch), d_max_size(max_size)
+    {
+#ifdef __linux__
+        d_iovecs.resize(batch);
+        d_headers.resize(batch);
+        for (unsigned int i = 0; i < batch; i++)
+            {
+                d_iovecs[i].iov_base = packets + static_cast<size_t>(i) * max_size;
+                d_iovecs[i].iov_len = max_size;
+                std::memset(&d_headers[i], 0, sizeof(d_headers[i]));
+                d_headers[i].msg_hdr.msg_iov = &d_iovecs[i];
+                d_headers[i].msg_hdr.msg_iovlen = 1;
+            }
+#endif
+    }
+
+    int receive(int fd, std::vector<size_t> & lengths)
+    {
+#ifdef __linux__
+        const int n = recvmmsg(fd, d_headers.data(), d_batch, MSG_DONTWAIT, nullptr);
+        for (int i = 0; i < n; i++)
+            {
+                lengths[i] = (d_headers[i].msg_hdr.msg_flags & MSG_TRUNC) ? 0 : d_headers[i].msg_len;
+                d_headers[i].msg_hdr.msg_flags = 0;
+            }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return 0;
+        return n;
+#else
+        // one system call per packet where there is no recvmmsg()
+        int n = 0;
+        while (n < static_cast<int>(d_batch))
+            {
+                const ssize_t size = ::recv(fd, d_packets + static_cast<size_t>(n) * d_max_size, d_max_size, MSG_DONTWAIT);
+                if (size < 0)
+                    {
+                        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) break;
+                        return n > 0 ? n : -1;
+                    }
+                lengths[n++] = static_cast<size_t>(size);
+            }
+        return n;
+#endif
+    }
+
+private:
+    unsigned char * d_packets;
+    unsigned int d_batch;
+    unsigned int d_max_size;
+#ifdef __linux__
+    std::vector<iovec> d_iovecs;
+    std::vector<mmsghdr> d_headers;
+#endif
+};
+}
+
+
+udp_sample_source_sptr make_udp_sample_source(const std::string & address,
+        unsigned short port, Udp_Payload_Format format, unsigned int sample_bits,
+        bool big_endian, bool to_gr_complex, unsigned int batch_size,
+        unsigned int max_packet_size, size_t buffer_size, size_t socket_buffer_size,
+        gr::msg_queue::sptr queue)
+{
+    return udp_sample_source_sptr(new udp_sample_source(address, port, format, sample_bits,
+            big_endian, to_gr_complex, batch_size, max_packet_size, buffer_size,
+            socket_buffer_size, queue));
+}
+
+
+udp_sample_source::udp_sample_source(const std::string & address,
+        unsigned short port, Udp_Payload_Format format, unsigned int sample_bits,
+        bool big_endian, bool to_gr_complex, unsigned int batch_size,
+        unsigned int max_packet_size, size_t buffer_size, size_t socket_buffer_size,
+        gr::msg_queue::sptr queue) :
+        gr::sync_block("udp_sample_source",
+                gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(1, 1, to_gr_complex ? sizeof(gr_complex) : (sample_bits == 16 ? 4 : 2))),
+        d_address(address),
+        d_port(port),
+        d_format(format),
+        d_sample_bytes(sample_bits == 16 ? 4 : 2),
+        d_swap(sample_bits == 16 && big_endian),
+        d_to_gr_complex(to_gr_complex),
+        d_batch_size(std::max(batch_size, 1u)),
+        d_max_packet_size(std::max(max_packet_size, 64u)),
+        d_socket_buffer_size(socket_buffer_size),
+        d_queue(queue),
+        d_socket(d_io_service),
+        d_packets(static_cast<size_t>(d_batch_size) * d_max_packet_size),
+        d_lengths(d_batch_size),
+        d_stream_locked(false),
+        d_stream_id(0),
+        d_buffer(std::max(buffer_size, static_cast<size_t>(d_batch_size) * d_max_packet_size)),
+        d_running(false),
+        d_failed(false),
+        d_received(0),
+        d_batches(0),
+        d_lost_packets(0),
+        d_overflows(0),
+        d_invalid(0),
+        d_other_streams(0)
+{
+    if (sample_bits != 8 && sample_bits != 16)
+        {
+            LOG(WARNING) << "UDP samples of " << sample_bits << " bits are not supported, using 16 bits";
+        }
+}
+
+
+udp_sample_source::~udp_sample_source()
+{
+    stop();
+}
+
+
+bool udp_sample_source::start()
+{
+    if (d_thread.joinable())
+        {
+            return true;
+        }
+    try
+    {
+            const boost::asio::ip::address address = boost::asio::ip::address::from_string(d_address);
+            boost::asio::ip::udp::endpoint endpoint(address, d_port);
+            d_socket.open(endpoint.protocol());
+            d_socket.set_option(boost::asio::ip::udp::socket::reuse_address(true));
+            d_socket.bind(endpoint);
+            if (address.is_multicast())
+                {
+                    d_socket.set_option(boost::asio::ip::multicast::join_group(address));
+                }
+            d_port = d_socket.local_endpoint().port();
+    }
+    catch (const boost::system::system_error & e)
+    {
+            LOG(ERROR) << "The UDP signal source cannot receive on " << d_address << ":" << d_port << ": " << e.what();
+            boost::system::error_code ec;
+            d_socket.close(ec);
+            d_failed = true;
+            return false;
+    }
+
+    // Room for bursts while the receiving thread is not scheduled; the
+    // kernel may cap it at net.core.rmem_max
+    boost::system::error_code ec;
+    d_socket.set_option(boost::asio::socket_base::receive_buffer_size(d_socket_buffer_size), ec);
+    boost::asio::socket_base::receive_buffer_size granted;
+    d_socket.get_option(granted, ec);
+    if (ec || static_cast<size_t>(granted.value()) < d_socket_buffer_size)
+        {
+            LOG(WARNING) << "UDP receive buffer of " << (ec ? 0 : granted.value()) << " bytes instead of "
+                         << d_socket_buffer_size << ", see net.core.rmem_max";
+        }
+
+    d_sequence.reset();
+    d_stream_locked = false;
+    d_running = true;
+    d_failed = false;
+    d_thread = std::thread([this]() { receive(); });
+    LOG(INFO) << "UDP signal source on " << d_address << ":" << d_port << ", batches of "
+              << d_batch_size << " packets, ring buffer of " << d_buffer.capacity() << " bytes";
+    return true;
+}
+
+
+bool udp_sample_source::stop()
+{
+    if (!d_thread.joinable())
+        {
+            return true;
+        }
+    d_running = false;
+    d_thread.join();
+    boost::system::error_code ec;
+    d_socket.close(ec);
+    d_buffer.notify();
+    LOG(INFO) << "UDP signal source on port " << d_port << ": " << d_received.load() << " packets in "
+              << d_batches.load() << " batches, " << d_lost_packets.load() << " lost, "
+              << d_overflows.load() << " dropped in overflows, " << d_invalid.load() << " invalid, "
+              << d_other_streams.load() << " of other streams";
+    return true;
+}
+
+
+void udp_sample_source::receive()
+{
+    const int fd = d_socket.native_handle();
+    Batch_Receiver receiver(d_packets.data(), d_batch_size, d_max_packet_size);
+    while (d_running.load())
+        {
+            pollfd descriptor;
+            descriptor.fd = fd;
+            descriptor.events = POLLIN;
+            descriptor.revents = 0;
+            const int ready = poll(&descriptor, 1, POLL_TIMEOUT_MS);
+            if (ready == 0 || (ready < 0 && errno == EINTR))
+                {
+                    continue;
+                }
+            const int n = ready < 0 ? -1 : receiver.receive(fd, d_lengths);
+            if (n < 0)
+                {
+                    LOG(ERROR) << "UDP signal source: receive error, " << std::strerror(errno);
+                    d_failed = true;
+                    d_buffer.notify();
+                    return;
+                }
+            if (n == 0)
+                {
+                    continue;
+                }
+            d_batches++;
+            d_received += n;
+            for (int i = 0; i < n; i++)
+                {
+                    handle_packet(&d_packets[static_cast<size_t>(i) * d_max_packet_size], d_lengths[i]);
+                }
+        }
+}
+
+
+void udp_sample_source::handle_packet(const unsigned char * data, size_t size)
+{
+    Udp_Packet packet;
+    if (size == 0 || !udp_parse_packet(data, size, d_format, packet))
+        {
+            d_invalid++;
+            return;
+        }
+    if (packet.has_stream_id)
+        {
+            if (!d_stream_locked)
+                {
+                    d_stream_locked = true;
+                    d_stream_id = packet.stream_id;
+                    LOG(INFO) << "UDP signal source: VITA-49 stream id 0x" << std::hex << d_stream_id << std::dec;
+                }
+            else if (packet.stream_id != d_stream_id)
+                {
+                    d_other_streams++;
+                    return;
+                }
+        }
+
+    const unsigned int lost_packets = d_sequence.next(packet);
+    if (lost_packets > 0)
+        {
+            d_lost_packets += lost_packets;
+            lost(d_sequence.gaps(), "gaps in the packet sequence");
+        }
+
+    // Whole samples only, so that none is split at the end of the ring
+    const size_t bytes = packet.payload_bytes / d_sample_bytes * d_sample_bytes;
+    if (bytes == 0)
+        {
+            return;
+        }
+    if (d_buffer.capacity() - d_buffer.readable() < bytes)
+        {
+            d_overflows++;
+            lost(d_overflows.load(), "packets dropped, the ring buffer is full");
+            return;
+        }
+    const unsigned char * payload = data + packet.payload_offset;
+    size_t copied = 0;
+    while (copied < bytes)
+        {
+            size_t size_free = 0;
+            unsigned char * region = d_buffer.write_region(size_free);
+            const size_t n = std::min(size_free, bytes - copied);
+            std::memcpy(region, payload + copied, n);
+            d_buffer.commit_write(n);
+            copied += n;
+        }
+}
+
+
+void udp_sample_source::lost(unsigned long long events, const char * what)
+{
+    if ((events & (events - 1)) == 0)
+        {
+            LOG(WARNING) << "UDP signal source: " << events << " " << what << " so far";
+        }
+    Control_Event_Bus::send(d_queue, Control_Event_Bus::receiver, Control_Event_Bus::signal_source_overflow);
+}
+
+
+int udp_sample_source::work(int noutput_items,
+        gr_vector_const_void_star &input_items __attribute__((unused)),
+        gr_vector_void_star &output_items)
+{
+    GNSS_SDR_TRACE_SCOPE("udp_sample_source::work");
+    while (d_buffer.wait_readable(d_sample_bytes, POLL_TIMEOUT_MS) < d_sample_bytes)
+        {
+            if (d_failed.load() || !d_running.load())
+                {
+                    return WORK_DONE;
+                }
+        }
+
+    // Every write is of whole samples and the capacity is a power of two,
+    // so the regions end at a sample boundary
+    int produced = 0;
+    while (produced < noutput_items)
+        {
+            size_t size = 0;
+            const unsigned char * in = d_buffer.read_region(size);
+            const unsigned int n = static_cast<unsigned int>(std::min(static_cast<size_t>(noutput_items - produced), size / d_sample_bytes));
+            if (n == 0)
+                {
+                    break;
+                }
+            if (d_to_gr_complex)
+                {
+                    float * out = reinterpret_cast<float *>(static_cast<gr_complex *>(output_items[0]) + produced);
+                    if (d_sample_bytes == 2)
+                        {
+                            volk_8i_s32f_convert_32f(out, reinterpret_cast<const int8_t *>(in), 1.0, 2 * n);
+                        }
+                    else
+                        {
+                            const int16_t * samples = reinterpret_cast<const int16_t *>(in);
+                            if (d_swap)
+                                {
+                                    d_swapped.resize(std::max(d_swapped.size(), static_cast<size_t>(2 * n)));
+                                    std::memcpy(d_swapped.data(), in, 2 * n * sizeof(int16_t));
+                                    volk_16u_byteswap(reinterpret_cast<uint16_t *>(d_swapped.data()), 2 * n);
+                                    samples = d_swapped.data();
+                                }
+                            volk_16i_s32f_convert_32f(out, samples, 1.0, 2 * n);
+                        }
+                }
+            else
+                {
+                    unsigned char * out = static_cast<unsigned char *>(output_items[0]) + static_cast<size_t>(produced) * d_sample_bytes;
+                    std::memcpy(out, in, static_cast<size_t>(n) * d_sample_bytes);
+                    if (d_swap)
+                        {
+                            volk_16u_byteswap(reinterpret_cast<uint16_t *>(out), 2 * n);
+                        }
+                }
+            d_buffer.commit_read(static_cast<size_t>(n) * d_sample_bytes);
+            produced += n;
+        }
+    return produced;
+}
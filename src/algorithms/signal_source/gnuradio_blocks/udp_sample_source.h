@@ -0,0 +1,180 @@
+/*!
+ * \file udp_sample_source.h
+ * \brief Source of the complex samples that a front end streams in UDP packets
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_UDP_SAMPLE_SOURCE_H_
+#define GNSS_SDR_UDP_SAMPLE_SOURCE_H_
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/asio.hpp>
+#include <gnuradio/msg_queue.h>
+#include <gnuradio/sync_block.h>
+#include "byte_ring_buffer.h"
+#include "udp_packet_parser.h"
+
+class udp_sample_source;
+typedef boost::shared_ptr<udp_sample_source> udp_sample_source_sptr;
+
+/*!
+ * \brief Makes a source of the samples received on \p address : \p port,
+ * which may be a multicast group. The samples are interleaved I/Q of
+ * \p sample_bits (8 or 16) bits, and big endian in the packets if
+ * \p big_endian. They are output as gr_complex if \p to_gr_complex, and
+ * else as they are (lv_8sc_t or lv_16sc_t), for the data type adapters.
+ * \p batch_size packets of up to \p max_packet_size bytes are received at
+ * once into a ring of \p buffer_size bytes. The sequence gaps and the
+ * overflows of the ring are sent to \p queue, which can be null.
+ */
+udp_sample_source_sptr make_udp_sample_source(const std::string & address,
+        unsigned short port, Udp_Payload_Format format, unsigned int sample_bits,
+        bool big_endian, bool to_gr_complex, unsigned int batch_size,
+        unsigned int max_packet_size, size_t buffer_size, size_t socket_buffer_size,
+        gr::msg_queue::sptr queue);
+
+/*!
+ * \brief Reads the UDP packets of a network front end, such as a digitizer
+ * streaming VITA-49 at tens of megasamples per second.
+ *
+ * A thread receives batches of packets with one recvmmsg() call each,
+ * finds their samples and copies them into a lock-free ring of bytes, from
+ * which work() outputs them. At these rates a system call per packet is
+ * what limits a plain socket reader. The thread locks onto the stream id
+ * of the first VITA-49 packet and drops the packets of other streams.
+ *
+ * The packets lost in the network are found from the VITA-49 packet
+ * count, and the packets that find the ring full are dropped. Both are
+ * counted, logged and sent to the control queue as overflows of the signal
+ * source, since the samples after them are not contiguous with the ones
+ * before.
+ */
+class udp_sample_source : public gr::sync_block
+{
+private:
+    friend udp_sample_source_sptr make_udp_sample_source(const std::string & address,
+            unsigned short port, Udp_Payload_Format format, unsigned int sample_bits,
+            bool big_endian, bool to_gr_complex, unsigned int batch_size,
+            unsigned int max_packet_size, size_t buffer_size, size_t socket_buffer_size,
+            gr::msg_queue::sptr queue);
+
+    udp_sample_source(const std::string & address,
+            unsigned short port, Udp_Payload_Format format, unsigned int sample_bits,
+            bool big_endian, bool to_gr_complex, unsigned int batch_size,
+            unsigned int max_packet_size, size_t buffer_size, size_t socket_buffer_size,
+            gr::msg_queue::sptr queue);
+
+    // Receiving thread
+    void receive();
+    void handle_packet(const unsigned char * data, size_t size);
+    void lost(unsigned long long events, const char * what);
+
+    std::string d_address;
+    unsigned short d_port;
+    Udp_Payload_Format d_format;
+    unsigned int d_sample_bytes;          // bytes of an I/Q pair in the packets
+    bool d_swap;                          // 16-bit samples in the other byte order
+    bool d_to_gr_complex;
+    unsigned int d_batch_size;
+    unsigned int d_max_packet_size;
+    size_t d_socket_buffer_size;
+    gr::msg_queue::sptr d_queue;
+
+    boost::asio::io_service d_io_service;
+    boost::asio::ip::udp::socket d_socket;
+    std::thread d_thread;
+    std::vector<unsigned char> d_packets; // d_batch_size packets of d_max_packet_size bytes
+    std::vector<size_t> d_lengths;        // of the packets of the last batch, 0 if truncated
+    Udp_Sequence_Tracker d_sequence;
+    bool d_stream_locked;
+    uint32_t d_stream_id;
+
+    Byte_Ring_Buffer d_buffer;
+    std::vector<int16_t> d_swapped;       // 16-bit samples in host order, for the conversion
+    std::atomic<bool> d_running;
+    std::atomic<bool> d_failed;
+
+    std::atomic<unsigned long long> d_received;
+    std::atomic<unsigned long long> d_batches;
+    std::atomic<unsigned long long> d_lost_packets;
+    std::atomic<unsigned long long> d_overflows;
+    std::atomic<unsigned long long> d_invalid;
+    std::atomic<unsigned long long> d_other_streams;
+
+public:
+    ~udp_sample_source();
+
+    //! Binds the socket and starts the receiving thread
+    bool start();
+
+    //! Joins the receiving thread and closes the socket
+    bool stop();
+
+    //! Port the source is bound to, once started
+    unsigned short port() const
+    {
+        return d_port;
+    }
+
+    //! Packets received, whatever their content
+    unsigned long long packets() const
+    {
+        return d_received.load();
+    }
+
+    //! recvmmsg() calls that returned packets
+    unsigned long long batches() const
+    {
+        return d_batches.load();
+    }
+
+    //! Packets lost in the network, from the sequence numbers
+    unsigned long long lost_packets() const
+    {
+        return d_lost_packets.load();
+    }
+
+    //! Packets dropped because the ring was full
+    unsigned long long overflows() const
+    {
+        return d_overflows.load();
+    }
+
+    //! Packets that are not valid in the format, or longer than max_packet_size
+    unsigned long long invalid_packets() const
+    {
+        return d_invalid.load();
+    }
+
+    int work(int noutput_items, gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items);
+};
+
+#endif /* GNSS_SDR_UDP_SAMPLE_SOURCE_H_ */
@@ -30,7 +30,9 @@
 
 
 #include "unpack_2bit_samples.h"
+#include "gnss_sdr_trace.h"
 #include <gnuradio/io_signature.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
 
 struct byte_2bit_struct
 {
@@ -84,6 +86,16 @@ void swapEndianness( int8_t const *in, std::vector< int8_t > &out, size_t item_s
     }
 }
 
+void swapNibbleSamples( int8_t const *in, std::vector< int8_t > &out, unsigned int ninput_bytes )
+{
+    // bits 1:0 <-> 3:2 and 5:4 <-> 7:6
+    for( unsigned int i = 0; i < ninput_bytes; ++i )
+    {
+        uint8_t b = static_cast< uint8_t >( in[i] );
+        out[i] = static_cast< int8_t >( ( ( b & 0x33 ) << 2 ) | ( ( b >> 2 ) & 0x33 ) );
+    }
+}
+
 unpack_2bit_samples_sptr make_unpack_2bit_samples( bool big_endian_bytes,
                                                    size_t item_size,
                                                    bool big_endian_items,
@@ -132,6 +144,7 @@ int unpack_2bit_samples::work(int noutput_items,
                                    gr_vector_const_void_star &input_items,
                                    gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE("unpack_2bit_samples::work");
     signed char const *in = (signed char const *)input_items[0];
     int8_t *out = (int8_t*)output_items[0];
 
@@ -141,7 +154,7 @@ int unpack_2bit_samples::work(int noutput_items,
     // Handle endian swap if needed
     if( swap_endian_items_ )
     {
-        work_buffer_.reserve( ninput_bytes );
+        work_buffer_.resize( ninput_bytes );
         swapEndianness( in, work_buffer_, item_size_, ninput_items );
 
         in = const_cast< signed char const *> ( &work_buffer_[0] );
@@ -151,72 +164,24 @@ int unpack_2bit_samples::work(int noutput_items,
     // converted. But we now have two possibilities:
     // 1) The samples in a byte are in big endian order
     // 2) The samples in a byte are in little endian order
+    // and, with reverse interleaving, the two samples of each nibble are
+    // swapped before unpacking them in either order.
 
-    byte_and_samples raw_byte;
-    int n = 0;
-
-    if( !reverse_interleaving_ )
+    if( reverse_interleaving_ )
     {
-        if( swap_endian_bytes_ )
-        {
-            for(unsigned int i = 0; i < ninput_bytes; ++i)
-            {
-                // Read packed input sample (1 byte = 4 samples)
-                raw_byte.byte = in[i];
-
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_3 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_2 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_1 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_0 + 1 );
-
-            }
-        }
-        else
-        {
-            for(unsigned int i = 0; i < ninput_bytes; ++i )
-            {
+        work_buffer_.resize( ninput_bytes );
+        swapNibbleSamples( in, work_buffer_, ninput_bytes );
 
-                // Read packed input sample (1 byte = 4 samples)
-                raw_byte.byte = in[i];
+        in = const_cast< signed char const *> ( &work_buffer_[0] );
+    }
 
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_0 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_1 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_2 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_3 + 1 );
-            }
-        }
+    if( swap_endian_bytes_ )
+    {
+        volk_gnsssdr_8u_unpack2bitmsb_8i( (char*)out, (const unsigned char*)in, ninput_bytes*4 );
     }
     else
     {
-
-        if( swap_endian_bytes_ )
-        {
-            for(unsigned int i = 0; i < ninput_bytes; ++i)
-            {
-                // Read packed input sample (1 byte = 4 samples)
-                raw_byte.byte = in[i];
-
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_2 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_3 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_0 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_1 + 1 );
-
-            }
-        }
-        else
-        {
-            for(unsigned int i = 0; i < ninput_bytes; ++i )
-            {
-
-                // Read packed input sample (1 byte = 4 samples)
-                raw_byte.byte = in[i];
-
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_1 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_0 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_3 + 1 );
-                out[n++] = (int8_t)( 2*raw_byte.samples.sample_2 + 1 );
-            }
-        }
+        volk_gnsssdr_8u_unpack2bit_8i( (char*)out, (const unsigned char*)in, ninput_bytes*4 );
     }
 
     return noutput_items;
@@ -34,12 +34,9 @@
 
 
 #include "unpack_byte_2bit_cpx_samples.h"
+#include "gnss_sdr_trace.h"
 #include <gnuradio/io_signature.h>
-
-struct byte_2bit_struct
-{
-    signed two_bit_sample:2;  // <- 2 bits wide only
-};
+#include <volk_gnsssdr/volk_gnsssdr.h>
 
 
 unpack_byte_2bit_cpx_samples_sptr make_unpack_byte_2bit_cpx_samples()
@@ -60,47 +57,31 @@ int unpack_byte_2bit_cpx_samples::work(int noutput_items,
         gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE("unpack_byte_2bit_cpx_samples::work");
     const signed char *in = (const signed char *)input_items[0];
     short *out = (short*)output_items[0];
 
-    byte_2bit_struct sample;
-    int n = 0;
-    for(int i = 0; i < noutput_items/4; i++)
-        {
-            // Read packed input sample (1 byte = 2 complex samples)
-            //*     Packing Order
-            //*     Most Significant Nibble  - Sample n
-            //*     Least Significant Nibble - Sample n+1
-            //*     Packing order in Nibble Q1 Q0 I1 I0
-            //normal
-            //  signed char c = in[i];
-            //  //Q[n]
-            //  sample.two_bit_sample = (c>>6) & 3;
-            //  out[n++] = (2*(short)sample.two_bit_sample+1);
-            //  //I[n]
-            //  sample.two_bit_sample = (c>>4) & 3;
-            //  out[n++] = (2*(short)sample.two_bit_sample+1);
-            //  //Q[n+1]
-            //  sample.two_bit_sample = (c>>2) & 3;
-            //  out[n++] = (2*(short)sample.two_bit_sample+1);
-            //  //I[n+1]
-            //  sample.two_bit_sample = c & 3;
-            //  out[n++] = (2*(short)sample.two_bit_sample+1);
+    const unsigned int ninput_bytes = noutput_items / 4;
 
-            //I/Q swap
-            signed char c = in[i];
-            //I[n]
-            sample.two_bit_sample = (c >> 4) & 3;
-            out[n++] = (2*(short)sample.two_bit_sample + 1);
-            //Q[n]
-            sample.two_bit_sample = (c >> 6) & 3;
-            out[n++] = (2*(short)sample.two_bit_sample + 1);
-            //I[n+1]
-            sample.two_bit_sample = c & 3;
-            out[n++] = (2*(short)sample.two_bit_sample + 1);
-            //Q[n+1]
-            sample.two_bit_sample = (c >> 2) & 3;
-            out[n++] = (2*(short)sample.two_bit_sample + 1);
+    // Read packed input sample (1 byte = 2 complex samples)
+    //*     Packing Order
+    //*     Most Significant Nibble  - Sample n
+    //*     Least Significant Nibble - Sample n+1
+    //*     Packing order in Nibble Q1 Q0 I1 I0
+    // The output order (with I/Q swap) is I[n], Q[n], I[n+1], Q[n+1], that is,
+    // bits 5:4, 7:6, 1:0, 3:2. Swapping the two samples of each nibble
+    // leaves them in the most significant first order of the VOLK_GNSSSDR kernel.
+    swapped_bytes_.resize(ninput_bytes);
+    unpacked_samples_.resize(ninput_bytes * 4);
+    for(unsigned int i = 0; i < ninput_bytes; i++)
+        {
+            unsigned char c = static_cast<unsigned char>(in[i]);
+            swapped_bytes_[i] = ((c & 0x33) << 2) | ((c >> 2) & 0x33);
+        }
+    volk_gnsssdr_8u_unpack2bitmsb_8i(&unpacked_samples_[0], &swapped_bytes_[0], ninput_bytes * 4);
+    for(unsigned int n = 0; n < ninput_bytes * 4; n++)
+        {
+            out[n] = static_cast<short>(static_cast<signed char>(unpacked_samples_[n]));
         }
     return noutput_items;
 }
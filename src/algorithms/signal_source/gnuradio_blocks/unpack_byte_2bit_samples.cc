@@ -30,12 +30,9 @@
 
 
 #include "unpack_byte_2bit_samples.h"
+#include "gnss_sdr_trace.h"
 #include <gnuradio/io_signature.h>
-
-struct byte_2bit_struct
-{
-    signed two_bit_sample:2;  // <- 2 bits wide only
-};
+#include <volk_gnsssdr/volk_gnsssdr.h>
 
 
 unpack_byte_2bit_samples_sptr make_unpack_byte_2bit_samples()
@@ -59,26 +56,19 @@ int unpack_byte_2bit_samples::work(int noutput_items,
         gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE("unpack_byte_2bit_samples::work");
     const signed char *in = (const signed char *)input_items[0];
     float *out = (float*)output_items[0];
 
-    byte_2bit_struct sample;
-    int n = 0;
-    for(int i = 0; i < noutput_items/4; i++)
-        {
-            // Read packed input sample (1 byte = 4 samples)
-            signed char c = in[i];
-            sample.two_bit_sample = c & 3;
-            out[n++] = (float)sample.two_bit_sample;
-
-            sample.two_bit_sample = (c>>2) & 3;
-            out[n++] = (float)sample.two_bit_sample;
-
-            sample.two_bit_sample = (c>>4) & 3;
-            out[n++] = (float)sample.two_bit_sample;
+    const unsigned int nsamples = (noutput_items / 4) * 4;
 
-            sample.two_bit_sample = (c>>6) & 3;
-            out[n++] = (float)sample.two_bit_sample;
+    // Read packed input sample (1 byte = 4 samples, the first one in bits 1:0).
+    // The kernel gives 2 * x + 1 for each two's complement sample x
+    unpacked_samples_.resize(nsamples);
+    volk_gnsssdr_8u_unpack2bit_8i(&unpacked_samples_[0], reinterpret_cast<const unsigned char*>(in), nsamples);
+    for(unsigned int n = 0; n < nsamples; n++)
+        {
+            out[n] = static_cast<float>((static_cast<signed char>(unpacked_samples_[n]) - 1) / 2);
         }
     return noutput_items;
 }
@@ -31,6 +31,7 @@
 #ifndef GNSS_SDR_UNPACK_BYTE_2BIT_SAMPLES_H
 #define GNSS_SDR_UNPACK_BYTE_2BIT_SAMPLES_H
 
+#include <vector>
 #include <gnuradio/sync_interpolator.h>
 
 class unpack_byte_2bit_samples;
@@ -48,6 +49,7 @@ class unpack_byte_2bit_samples: public gr::sync_interpolator
 private:
     friend unpack_byte_2bit_samples_sptr
     make_unpack_byte_2bit_samples_sptr();
+    std::vector<char> unpacked_samples_;
 
 public:
     unpack_byte_2bit_samples();
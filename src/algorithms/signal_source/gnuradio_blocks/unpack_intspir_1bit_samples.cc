@@ -30,6 +30,7 @@
 
 
 #include "unpack_intspir_1bit_samples.h"
+#include "gnss_sdr_trace.h"
 #include <gnuradio/io_signature.h>
 
 
@@ -55,6 +56,7 @@ int unpack_intspir_1bit_samples::work(int noutput_items,
         gr_vector_const_void_star &input_items,
         gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE("unpack_intspir_1bit_samples::work");
     const signed int *in = (const signed int *)input_items[0];
     float *out = (float*)output_items[0];
 
@@ -64,23 +66,10 @@ int unpack_intspir_1bit_samples::work(int noutput_items,
         {
             // Read packed input sample (1 byte = 1 complex sample)
             // For historical reasons, values are float versions of short int limits (32767)
+            // Bit b gives 2 * 32767 * b - 32767, without branches
             signed int val = in[i];
-            if(((val >> ((channel - 1)*2)) & 1) == 1)
-                {
-                    out[n++] = static_cast<float>(32767.0);
-                }
-            else
-                {
-                    out[n++] = static_cast<float>(-32767.0);
-                }
-            if(((val >> (2*channel - 1)) & 1) == 1)
-                {
-                    out[n++] = static_cast<float>(32767.0);
-                }
-            else
-                {
-                    out[n++] = static_cast<float>(-32767.0);
-                }
+            out[n++] = static_cast<float>(((val >> ((channel - 1)*2)) & 1) * 65534 - 32767);
+            out[n++] = static_cast<float>(((val >> (2*channel - 1)) & 1) * 65534 - 32767);
         }
     return noutput_items;
 }
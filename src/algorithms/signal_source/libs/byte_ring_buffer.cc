@@ -0,0 +1,111 @@
+/*!
+ * \file byte_ring_buffer.cc
+ * \brief Lock-free ring of bytes between one producer and one consumer thread.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "byte_ring_buffer.h"
+#include <algorithm>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+
+Byte_Ring_Buffer::Byte_Ring_Buffer(size_t capacity) : d_head(0), d_tail(0)
+{
+    size_t size = 2;
+    while (size < capacity)
+        {
+            size <<= 1;
+        }
+    d_storage.resize(size);
+    d_mask = size - 1;
+}
+
+
+unsigned char * Byte_Ring_Buffer::write_region(size_t & size)
+{
+    const unsigned long long head = d_head.load(std::memory_order_relaxed);
+    const unsigned long long tail = d_tail.load(std::memory_order_acquire);
+    const size_t offset = head & d_mask;
+    size = std::min(d_storage.size() - static_cast<size_t>(head - tail), d_storage.size() - offset);
+    return &d_storage[offset];
+}
+
+
+void Byte_Ring_Buffer::commit_write(size_t n)
+{
+    d_head.store(d_head.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    d_cond.notify_all();
+}
+
+
+const unsigned char * Byte_Ring_Buffer::read_region(size_t & size)
+{
+    const unsigned long long tail = d_tail.load(std::memory_order_relaxed);
+    const unsigned long long head = d_head.load(std::memory_order_acquire);
+    const size_t offset = tail & d_mask;
+    size = std::min(static_cast<size_t>(head - tail), d_storage.size() - offset);
+    return &d_storage[offset];
+}
+
+
+void Byte_Ring_Buffer::commit_read(size_t n)
+{
+    d_tail.store(d_tail.load(std::memory_order_relaxed) + n, std::memory_order_release);
+}
+
+
+size_t Byte_Ring_Buffer::readable() const
+{
+    const unsigned long long tail = d_tail.load(std::memory_order_acquire);
+    return static_cast<size_t>(d_head.load(std::memory_order_acquire) - tail);
+}
+
+
+size_t Byte_Ring_Buffer::wait_readable(size_t n, unsigned int timeout_ms)
+{
+    size_t available = readable();
+    if (available >= n)
+        {
+            return available;
+        }
+    // the producer does not take the lock before notifying, so a wake-up
+    // can be missed: the waits are short and the condition checked again
+    const boost::posix_time::ptime deadline = boost::posix_time::microsec_clock::universal_time()
+            + boost::posix_time::milliseconds(timeout_ms);
+    boost::mutex::scoped_lock lock(d_mutex);
+    while ((available = readable()) < n && boost::posix_time::microsec_clock::universal_time() < deadline)
+        {
+            d_cond.timed_wait(lock, boost::posix_time::milliseconds(std::min(timeout_ms, 10u)));
+        }
+    return available;
+}
+
+
+void Byte_Ring_Buffer::notify()
+{
+    d_cond.notify_all();
+}
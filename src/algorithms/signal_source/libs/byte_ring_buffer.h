@@ -0,0 +1,98 @@
+/*!
+ * \file byte_ring_buffer.h
+ * \brief Lock-free ring of bytes between one producer and one consumer thread.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The producer (typically the thread of a socket) gets the free space at
+ * the write position, fills it in place, for instance with a read from the
+ * socket, and commits it. The consumer does the same with the bytes at the
+ * read position. Neither of them takes a lock: each position is written by
+ * one thread only and read by the other one with acquire semantics.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_BYTE_RING_BUFFER_H_
+#define GNSS_SDR_BYTE_RING_BUFFER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+/*!
+ * \brief Bounded ring of bytes for a single producer and a single consumer.
+ *
+ * The capacity is rounded up to a power of two. The regions are contiguous,
+ * so a region ends at the end of the storage and the rest is returned by
+ * the next call, after the commit.
+ */
+class Byte_Ring_Buffer
+{
+public:
+    explicit Byte_Ring_Buffer(size_t capacity);
+
+    size_t capacity() const
+    {
+        return d_storage.size();
+    }
+
+    //! Producer: the free bytes at the write position, size of them in \p size
+    unsigned char * write_region(size_t & size);
+
+    //! Producer: the first \p n bytes of the write region have been filled
+    void commit_write(size_t n);
+
+    //! Consumer: the bytes at the read position, size of them in \p size
+    const unsigned char * read_region(size_t & size);
+
+    //! Consumer: the first \p n bytes of the read region have been used
+    void commit_read(size_t n);
+
+    //! Bytes that can be read, from any thread
+    size_t readable() const;
+
+    /*!
+     * \brief Consumer: waits up to \p timeout_ms milliseconds for at least
+     * \p n readable bytes. Returns the readable bytes, which may be fewer.
+     */
+    size_t wait_readable(size_t n, unsigned int timeout_ms);
+
+    //! Wakes up the consumer from wait_readable(), e.g. at the end of the stream
+    void notify();
+
+private:
+    std::vector<unsigned char> d_storage;
+    size_t d_mask;
+    std::atomic<unsigned long long> d_head;     // bytes written, by the producer only
+    std::atomic<unsigned long long> d_tail;     // bytes read, by the consumer only
+
+    // only for sleeping while the ring is empty
+    boost::mutex d_mutex;
+    boost::condition_variable d_cond;
+};
+
+#endif
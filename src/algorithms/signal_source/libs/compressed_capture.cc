@@ -0,0 +1,633 @@
+/*!
+ * \file compressed_capture.cc
+ * \brief Lossless chunked compression of sample files, with random access
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "compressed_capture.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+const char MAGIC[8] = {'G', 'S', 'D', 'R', 'C', 'M', 'P', '1'};
+const uint32_t VERSION = 1;
+const unsigned int ITEM_TYPE_SIZE = 16;
+
+const unsigned char METHOD_STORED = 0;
+const unsigned char METHOD_HUFFMAN = 1;
+
+// Longest code: the decoding table has 2^12 entries, and fits in the L1 cache
+const unsigned int MAX_CODE_LENGTH = 12;
+const unsigned int BYTE_SYMBOLS = 256;
+const unsigned int INT16_SYMBOLS = 17;      // bit lengths 0 to 16
+
+void put_u32(unsigned char * p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) p[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+void put_u64(unsigned char * p, uint64_t v)
+{
+    for (int i = 0; i < 8; i++) p[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+uint32_t get_u32(const unsigned char * p)
+{
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+uint64_t get_u64(const unsigned char * p)
+{
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) v = (v << 8) | p[i];
+    return v;
+}
+
+unsigned int bit_length(uint32_t v)
+{
+    unsigned int n = 0;
+    while (v) { n++; v >>= 1; }
+    return n;
+}
+
+uint16_t zigzag(int16_t v)
+{
+    return static_cast<uint16_t>((static_cast<uint16_t>(v) << 1) ^ static_cast<uint16_t>(v >> 15));
+}
+
+int16_t unzigzag(uint16_t z)
+{
+    return static_cast<int16_t>((z >> 1) ^ static_cast<uint16_t>(-(z & 1)));
+}
+
+/*
+ * Huffman code lengths of the symbols, 0 for the unused ones. While the
+ * longest code is too long, the counts are halved, which flattens the tree.
+ */
+void code_lengths(std::vector<uint64_t> counts, std::vector<unsigned char> & lengths)
+{
+    const unsigned int n = counts.size();
+    lengths.assign(n, 0);
+    for (;;)
+        {
+            typedef std::pair<uint64_t, unsigned int> Node;
+            std::priority_queue<Node, std::vector<Node>, std::greater<Node> > heap;
+            std::vector<unsigned int> parent(2 * n, 0);
+            for (unsigned int s = 0; s < n; s++)
+                {
+                    if (counts[s] > 0) heap.push(Node(counts[s], s));
+                }
+            if (heap.empty()) return;
+            if (heap.size() == 1)
+                {
+                    lengths[heap.top().second] = 1;
+                    return;
+                }
+            unsigned int next = n;
+            while (heap.size() > 1)
+                {
+                    const Node a = heap.top(); heap.pop();
+                    const Node b = heap.top(); heap.pop();
+                    parent[a.second] = next;
+                    parent[b.second] = next;
+                    heap.push(Node(a.first + b.first, next++));
+                }
+            const unsigned int root = next - 1;
+            unsigned int longest = 0;
+            for (unsigned int s = 0; s < n; s++)
+                {
+                    if (counts[s] == 0) continue;
+                    unsigned int length = 0;
+                    for (unsigned int node = s; node != root; node = parent[node]) length++;
+                    lengths[s] = length;
+                    longest = std::max(longest, length);
+                }
+            if (longest <= MAX_CODE_LENGTH) return;
+            for (unsigned int s = 0; s < n; s++)
+                {
+                    if (counts[s] > 0) counts[s] = (counts[s] + 1) / 2;
+                }
+        }
+}
+
+// Canonical codes of the lengths, bit reversed for the LSB-first stream
+void canonical_codes(const std::vector<unsigned char> & lengths, std::vector<uint32_t> & codes)
+{
+    unsigned int count[MAX_CODE_LENGTH + 1] = {0};
+    for (size_t s = 0; s < lengths.size(); s++) count[lengths[s]]++;
+    count[0] = 0;
+    uint32_t next[MAX_CODE_LENGTH + 1] = {0};
+    uint32_t code = 0;
+    for (unsigned int length = 1; length <= MAX_CODE_LENGTH; length++)
+        {
+            code = (code + count[length - 1]) << 1;
+            next[length] = code;
+        }
+    codes.assign(lengths.size(), 0);
+    for (size_t s = 0; s < lengths.size(); s++)
+        {
+            const unsigned int length = lengths[s];
+            if (length == 0) continue;
+            const uint32_t c = next[length]++;
+            uint32_t reversed = 0;
+            for (unsigned int b = 0; b < length; b++) reversed |= ((c >> b) & 1) << (length - 1 - b);
+            codes[s] = reversed;
+        }
+}
+
+class Bit_Writer
+{
+public:
+    explicit Bit_Writer(std::vector<unsigned char> & out) : d_out(out), d_acc(0), d_bits(0) {}
+
+    void put(uint32_t value, unsigned int bits)
+    {
+        d_acc |= static_cast<uint64_t>(value) << d_bits;
+        d_bits += bits;
+        while (d_bits >= 8)
+            {
+                d_out.push_back(static_cast<unsigned char>(d_acc));
+                d_acc >>= 8;
+                d_bits -= 8;
+            }
+    }
+
+    void finish()
+    {
+        if (d_bits > 0) d_out.push_back(static_cast<unsigned char>(d_acc));
+        d_acc = 0;
+        d_bits = 0;
+    }
+
+private:
+    std::vector<unsigned char> & d_out;
+    uint64_t d_acc;
+    unsigned int d_bits;
+};
+
+/*
+ * Past the end of the stream the reader shifts in zeros, and bits() goes
+ * negative once more bits have been taken than there were.
+ */
+class Bit_Reader
+{
+public:
+    Bit_Reader(const unsigned char * data, size_t size) : d_p(data), d_end(data + size), d_acc(0), d_bits(0) {}
+
+    void refill()
+    {
+        while (d_bits <= 56 && d_p < d_end)
+            {
+                d_acc |= static_cast<uint64_t>(*d_p++) << d_bits;
+                d_bits += 8;
+            }
+    }
+
+    uint32_t peek(unsigned int bits) const
+    {
+        return static_cast<uint32_t>(d_acc & ((static_cast<uint64_t>(1) << bits) - 1));
+    }
+
+    void skip(unsigned int bits)
+    {
+        d_acc >>= bits;
+        d_bits -= static_cast<int>(bits);
+    }
+
+    int bits() const
+    {
+        return d_bits;
+    }
+
+private:
+    const unsigned char * d_p;
+    const unsigned char * d_end;
+    uint64_t d_acc;
+    int d_bits;
+};
+
+// Entry of the decoding table: symbol << 4 | code length, 0 if no code starts so
+bool decoding_table(const std::vector<unsigned char> & lengths, std::vector<uint16_t> & table)
+{
+    std::vector<uint32_t> codes;
+    canonical_codes(lengths, codes);
+    table.assign(1 << MAX_CODE_LENGTH, 0);
+    uint32_t kraft = 0;
+    for (size_t s = 0; s < lengths.size(); s++)
+        {
+            const unsigned int length = lengths[s];
+            if (length == 0) continue;
+            kraft += 1 << (MAX_CODE_LENGTH - length);
+            if (kraft > (1u << MAX_CODE_LENGTH)) return false;
+            for (uint32_t high = 0; high < (1u << (MAX_CODE_LENGTH - length)); high++)
+                {
+                    table[codes[s] | (high << length)] = static_cast<uint16_t>((s << 4) | length);
+                }
+        }
+    return true;
+}
+
+bool encode_huffman(const unsigned char * data, size_t bytes, Compressed_Capture_Model model,
+        std::vector<unsigned char> & out)
+{
+    const unsigned int symbols = model == COMPRESSED_CAPTURE_INT16 ? INT16_SYMBOLS : BYTE_SYMBOLS;
+    std::vector<uint64_t> counts(symbols, 0);
+    if (model == COMPRESSED_CAPTURE_INT16)
+        {
+            if (bytes % 2 != 0) return false;
+            for (size_t i = 0; i < bytes; i += 2)
+                {
+                    const int16_t v = static_cast<int16_t>(data[i] | (data[i + 1] << 8));
+                    counts[bit_length(zigzag(v))]++;
+                }
+        }
+    else
+        {
+            for (size_t i = 0; i < bytes; i++) counts[data[i]]++;
+        }
+    std::vector<unsigned char> lengths;
+    code_lengths(counts, lengths);
+    std::vector<uint32_t> codes;
+    canonical_codes(lengths, codes);
+
+    for (unsigned int s = 0; s < symbols; s += 2)
+        {
+            const unsigned char high = s + 1 < symbols ? lengths[s + 1] : 0;
+            out.push_back(static_cast<unsigned char>(lengths[s] | (high << 4)));
+        }
+    Bit_Writer writer(out);
+    if (model == COMPRESSED_CAPTURE_INT16)
+        {
+            for (size_t i = 0; i < bytes; i += 2)
+                {
+                    const uint16_t z = zigzag(static_cast<int16_t>(data[i] | (data[i + 1] << 8)));
+                    const unsigned int length = bit_length(z);
+                    writer.put(codes[length], lengths[length]);
+                    if (length > 1) writer.put(z & ((1u << (length - 1)) - 1), length - 1);
+                }
+        }
+    else
+        {
+            for (size_t i = 0; i < bytes; i++) writer.put(codes[data[i]], lengths[data[i]]);
+        }
+    writer.finish();
+    return true;
+}
+
+bool decode_huffman(const unsigned char * payload, size_t size, Compressed_Capture_Model model,
+        unsigned char * out, size_t bytes)
+{
+    const unsigned int symbols = model == COMPRESSED_CAPTURE_INT16 ? INT16_SYMBOLS : BYTE_SYMBOLS;
+    const size_t table_bytes = (symbols + 1) / 2;
+    if (size < table_bytes) return false;
+    std::vector<unsigned char> lengths(symbols);
+    for (unsigned int s = 0; s < symbols; s++)
+        {
+            lengths[s] = (payload[s / 2] >> (4 * (s % 2))) & 0xF;
+            if (lengths[s] > MAX_CODE_LENGTH) return false;
+        }
+    std::vector<uint16_t> table;
+    if (!decoding_table(lengths, table)) return false;
+
+    Bit_Reader reader(payload + table_bytes, size - table_bytes);
+    const uint32_t mask = (1u << MAX_CODE_LENGTH) - 1;
+    if (model == COMPRESSED_CAPTURE_INT16)
+        {
+            if (bytes % 2 != 0) return false;
+            for (size_t i = 0; i < bytes; i += 2)
+                {
+                    // a code and up to 15 bits below the leading one
+                    if (reader.bits() < static_cast<int>(MAX_CODE_LENGTH + 15)) reader.refill();
+                    const uint16_t entry = table[reader.peek(MAX_CODE_LENGTH) & mask];
+                    if (entry == 0) return false;
+                    reader.skip(entry & 0xF);
+                    const unsigned int length = entry >> 4;
+                    uint16_t z = 0;
+                    if (length > 0)
+                        {
+                            z = static_cast<uint16_t>(1u << (length - 1));
+                            if (length > 1)
+                                {
+                                    z |= static_cast<uint16_t>(reader.peek(length - 1));
+                                    reader.skip(length - 1);
+                                }
+                        }
+                    const uint16_t v = static_cast<uint16_t>(unzigzag(z));
+                    out[i] = static_cast<unsigned char>(v);
+                    out[i + 1] = static_cast<unsigned char>(v >> 8);
+                }
+        }
+    else
+        {
+            size_t i = 0;
+            while (i < bytes)
+                {
+                    // four codes per refill, without checks in between
+                    reader.refill();
+                    const size_t last = std::min(bytes, i + 4);
+                    for (; i < last; i++)
+                        {
+                            const uint16_t entry = table[reader.peek(MAX_CODE_LENGTH)];
+                            if (entry == 0) return false;
+                            out[i] = static_cast<unsigned char>(entry >> 4);
+                            reader.skip(entry & 0xF);
+                        }
+                }
+        }
+    return reader.bits() >= 0;
+}
+}
+
+
+Compressed_Capture_Model compressed_capture_model(const std::string & item_type)
+{
+    if (item_type == "short" || item_type == "ishort")
+        {
+            return COMPRESSED_CAPTURE_INT16;
+        }
+    return COMPRESSED_CAPTURE_BYTES;
+}
+
+
+void compressed_capture_encode_chunk(const unsigned char * data, size_t bytes,
+        Compressed_Capture_Model model, std::vector<unsigned char> & out)
+{
+    out.assign(COMPRESSED_CAPTURE_CHUNK_HEADER_SIZE, 0);
+    unsigned char method = METHOD_HUFFMAN;
+    if (!encode_huffman(data, bytes, model, out) || out.size() - COMPRESSED_CAPTURE_CHUNK_HEADER_SIZE >= bytes)
+        {
+            method = METHOD_STORED;
+            out.resize(COMPRESSED_CAPTURE_CHUNK_HEADER_SIZE);
+            out.insert(out.end(), data, data + bytes);
+        }
+    put_u32(&out[0], static_cast<uint32_t>(bytes));
+    put_u32(&out[4], static_cast<uint32_t>(out.size() - COMPRESSED_CAPTURE_CHUNK_HEADER_SIZE));
+    out[8] = method;
+}
+
+
+bool compressed_capture_decode_chunk(const unsigned char * chunk, size_t size,
+        Compressed_Capture_Model model, unsigned char * out, size_t bytes)
+{
+    if (size < COMPRESSED_CAPTURE_CHUNK_HEADER_SIZE) return false;
+    const size_t raw = get_u32(chunk);
+    const size_t payload = get_u32(chunk + 4);
+    const unsigned char method = chunk[8];
+    if (raw != bytes || payload != size - COMPRESSED_CAPTURE_CHUNK_HEADER_SIZE) return false;
+    const unsigned char * data = chunk + COMPRESSED_CAPTURE_CHUNK_HEADER_SIZE;
+    if (method == METHOD_STORED)
+        {
+            if (payload != bytes) return false;
+            std::memcpy(out, data, bytes);
+            return true;
+        }
+    if (method == METHOD_HUFFMAN)
+        {
+            return decode_huffman(data, payload, model, out, bytes);
+        }
+    return false;
+}
+
+
+Compressed_Capture_Writer::Compressed_Capture_Writer()
+{
+    d_model = COMPRESSED_CAPTURE_BYTES;
+    d_sample_rate = 0.0;
+    d_chunk_bytes = 0;
+    d_threads = 1;
+    d_raw_bytes = 0;
+    d_compressed_bytes = 0;
+}
+
+
+Compressed_Capture_Writer::~Compressed_Capture_Writer()
+{
+    close();
+}
+
+
+bool Compressed_Capture_Writer::open(const std::string & filename, const std::string & item_type,
+        double sample_rate, size_t chunk_bytes, unsigned int threads)
+{
+    close();
+    if (item_type.size() >= ITEM_TYPE_SIZE) return false;
+    d_file.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!d_file.is_open()) return false;
+    d_item_type = item_type;
+    d_model = compressed_capture_model(item_type);
+    d_sample_rate = sample_rate;
+    // whole items of any type, up to gr_complex
+    d_chunk_bytes = std::max<size_t>(std::min<size_t>(chunk_bytes, 0xFFFFFFF0u) / 8 * 8, 8);
+    d_threads = std::max(threads, 1u);
+    d_pending.clear();
+    d_pending.reserve(d_chunk_bytes * d_threads);
+    d_encoded.resize(d_threads);
+    d_index.clear();
+    d_raw_bytes = 0;
+
+    // the header is written again by close(), with the index
+    const std::vector<char> header(COMPRESSED_CAPTURE_HEADER_SIZE, 0);
+    d_file.write(header.data(), header.size());
+    d_compressed_bytes = COMPRESSED_CAPTURE_HEADER_SIZE;
+    return d_file.good();
+}
+
+
+bool Compressed_Capture_Writer::write(const void * data, size_t bytes)
+{
+    if (!d_file.is_open()) return false;
+    const unsigned char * in = static_cast<const unsigned char *>(data);
+    const size_t batch = d_chunk_bytes * d_threads;
+    while (bytes > 0)
+        {
+            const size_t n = std::min(bytes, batch - d_pending.size());
+            d_pending.insert(d_pending.end(), in, in + n);
+            in += n;
+            bytes -= n;
+            d_raw_bytes += n;
+            if (d_pending.size() == batch && !flush(d_threads)) return false;
+        }
+    return true;
+}
+
+
+bool Compressed_Capture_Writer::flush(size_t chunks)
+{
+    std::vector<std::thread> workers;
+    for (size_t c = 1; c < chunks; c++)
+        {
+            workers.push_back(std::thread([this, c]()
+                    {
+                const size_t first = c * d_chunk_bytes;
+                compressed_capture_encode_chunk(&d_pending[first], std::min(d_chunk_bytes, d_pending.size() - first), d_model, d_encoded[c]);
+                    }));
+        }
+    compressed_capture_encode_chunk(&d_pending[0], std::min(d_chunk_bytes, d_pending.size()), d_model, d_encoded[0]);
+    for (size_t w = 0; w < workers.size(); w++) workers[w].join();
+
+    for (size_t c = 0; c < chunks; c++)
+        {
+            d_index.push_back(d_compressed_bytes);
+            d_file.write(reinterpret_cast<const char *>(d_encoded[c].data()), d_encoded[c].size());
+            d_compressed_bytes += d_encoded[c].size();
+        }
+    d_pending.clear();
+    return d_file.good();
+}
+
+
+bool Compressed_Capture_Writer::close()
+{
+    if (!d_file.is_open()) return false;
+    bool ok = true;
+    if (!d_pending.empty())
+        {
+            ok = flush((d_pending.size() + d_chunk_bytes - 1) / d_chunk_bytes);
+        }
+
+    const unsigned long long index_offset = d_compressed_bytes;
+    std::vector<unsigned char> index(8 * d_index.size());
+    for (size_t i = 0; i < d_index.size(); i++) put_u64(&index[8 * i], d_index[i]);
+    d_file.write(reinterpret_cast<const char *>(index.data()), index.size());
+    d_compressed_bytes += index.size();
+
+    unsigned char header[COMPRESSED_CAPTURE_HEADER_SIZE] = {0};
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    put_u32(header + 8, VERSION);
+    put_u32(header + 12, d_model);
+    put_u32(header + 16, static_cast<uint32_t>(d_chunk_bytes));
+    put_u64(header + 24, d_raw_bytes);
+    uint64_t rate_bits = 0;
+    std::memcpy(&rate_bits, &d_sample_rate, sizeof(double));
+    put_u64(header + 32, rate_bits);
+    put_u64(header + 40, index_offset);
+    put_u64(header + 48, d_index.size());
+    std::memcpy(header + 56, d_item_type.c_str(), d_item_type.size());
+    d_file.seekp(0);
+    d_file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    ok = ok && d_file.good();
+    d_file.close();
+    return ok;
+}
+
+
+Compressed_Capture_Reader::Compressed_Capture_Reader()
+{
+    d_fd = -1;
+    d_model = COMPRESSED_CAPTURE_BYTES;
+    d_sample_rate = 0.0;
+    d_raw_bytes = 0;
+    d_chunk_bytes = 0;
+    d_index_offset = 0;
+}
+
+
+Compressed_Capture_Reader::~Compressed_Capture_Reader()
+{
+    if (d_fd >= 0) ::close(d_fd);
+}
+
+
+bool Compressed_Capture_Reader::open(const std::string & filename)
+{
+    if (d_fd >= 0) ::close(d_fd);
+    d_index.clear();
+    d_fd = ::open(filename.c_str(), O_RDONLY);
+    if (d_fd < 0) return false;
+
+    unsigned char header[COMPRESSED_CAPTURE_HEADER_SIZE];
+    if (pread(d_fd, header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))
+            || std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0 || get_u32(header + 8) != VERSION)
+        {
+            return false;
+        }
+    const uint32_t model = get_u32(header + 12);
+    if (model != COMPRESSED_CAPTURE_BYTES && model != COMPRESSED_CAPTURE_INT16) return false;
+    d_model = static_cast<Compressed_Capture_Model>(model);
+    d_chunk_bytes = get_u32(header + 16);
+    d_raw_bytes = get_u64(header + 24);
+    const uint64_t rate_bits = get_u64(header + 32);
+    std::memcpy(&d_sample_rate, &rate_bits, sizeof(double));
+    d_index_offset = get_u64(header + 40);
+    const unsigned long long chunks = get_u64(header + 48);
+    d_item_type.assign(reinterpret_cast<const char *>(header + 56), strnlen(reinterpret_cast<const char *>(header + 56), ITEM_TYPE_SIZE));
+    if (d_chunk_bytes == 0 || chunks != (d_raw_bytes + d_chunk_bytes - 1) / d_chunk_bytes)
+        {
+            return false;
+        }
+
+    std::vector<unsigned char> index(8 * chunks);
+    if (pread(d_fd, index.data(), index.size(), d_index_offset) != static_cast<ssize_t>(index.size()))
+        {
+            return false;
+        }
+    d_index.resize(chunks);
+    for (size_t i = 0; i < chunks; i++)
+        {
+            d_index[i] = get_u64(&index[8 * i]);
+            const unsigned long long end = i + 1 < chunks ? get_u64(&index[8 * (i + 1)]) : d_index_offset;
+            if (d_index[i] < COMPRESSED_CAPTURE_HEADER_SIZE || end < d_index[i] + COMPRESSED_CAPTURE_CHUNK_HEADER_SIZE)
+                {
+                    d_index.clear();
+                    return false;
+                }
+        }
+    return true;
+}
+
+
+size_t Compressed_Capture_Reader::chunk_size(size_t i) const
+{
+    if (i + 1 < d_index.size()) return d_chunk_bytes;
+    return static_cast<size_t>(d_raw_bytes - static_cast<unsigned long long>(i) * d_chunk_bytes);
+}
+
+
+bool Compressed_Capture_Reader::read_chunk(size_t i, unsigned char * out, std::vector<unsigned char> & scratch) const
+{
+    if (i >= d_index.size()) return false;
+    const unsigned long long end = i + 1 < d_index.size() ? d_index[i + 1] : d_index_offset;
+    scratch.resize(static_cast<size_t>(end - d_index[i]));
+    // pread() does not move the file position, so threads do not interfere
+    size_t done = 0;
+    while (done < scratch.size())
+        {
+            const ssize_t n = pread(d_fd, &scratch[done], scratch.size() - done, d_index[i] + done);
+            if (n <= 0) return false;
+            done += n;
+        }
+    return compressed_capture_decode_chunk(scratch.data(), scratch.size(), d_model, out, chunk_size(i));
+}
@@ -0,0 +1,203 @@
+/*!
+ * \file compressed_capture.h
+ * \brief Lossless chunked compression of sample files, with random access
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * A compressed capture holds the bytes of a raw sample file, as read by
+ * File_Signal_Source, in chunks that are compressed independently, so that
+ * they can be decompressed in parallel and from any position. The file is
+ * a header, the chunks and an index (little endian):
+ *
+ *  - header: "GSDRCMP1", version (u32), model (u32), chunk size [bytes]
+ *    (u32), reserved (u32), bytes of the raw file (u64), sample rate [Hz]
+ *    (f64), offset of the index (u64), number of chunks (u64) and the
+ *    item_type of the raw file (16 chars, zero padded).
+ *  - chunk: raw bytes (u32), payload bytes (u32), method (u8, 0 stored or
+ *    1 Huffman), 3 reserved bytes and the payload.
+ *  - index: the file offset of each chunk (u64).
+ *
+ * The Huffman payload is the code length of each symbol (4 bits each) and
+ * the codes, least significant bit first. With the byte model the symbols
+ * are the bytes of the file, so that the 2 or 4-bit samples of packed
+ * files are coded four or two at a time. With the int16 model, for short
+ * and ishort files, each sample is zigzag mapped, and its bit length is
+ * coded, followed by the bits below the leading one. Either way the gain
+ * comes from the samples using few of the levels, or mostly the ones
+ * around zero, as the quantized noise of a GNSS front end does.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_COMPRESSED_CAPTURE_H_
+#define GNSS_SDR_COMPRESSED_CAPTURE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#define COMPRESSED_CAPTURE_HEADER_SIZE 72
+#define COMPRESSED_CAPTURE_CHUNK_HEADER_SIZE 12
+
+enum Compressed_Capture_Model
+{
+    COMPRESSED_CAPTURE_BYTES = 0,
+    COMPRESSED_CAPTURE_INT16 = 1
+};
+
+//! Model for the files of a File_Signal_Source item_type: int16 for short and ishort, bytes otherwise
+Compressed_Capture_Model compressed_capture_model(const std::string & item_type);
+
+/*!
+ * \brief Compresses \p bytes bytes of \p data into \p out, as a chunk with
+ * its header. The chunk is stored as it is if that is shorter.
+ */
+void compressed_capture_encode_chunk(const unsigned char * data, size_t bytes,
+        Compressed_Capture_Model model, std::vector<unsigned char> & out);
+
+/*!
+ * \brief Decompresses the chunk of \p size bytes at \p chunk, header
+ * included, into \p out, which holds \p bytes bytes. Returns false if the
+ * chunk is corrupt or does not have \p bytes raw bytes.
+ */
+bool compressed_capture_decode_chunk(const unsigned char * chunk, size_t size,
+        Compressed_Capture_Model model, unsigned char * out, size_t bytes);
+
+
+/*!
+ * \brief Writes a compressed capture. Each batch of \p threads full chunks
+ * is compressed in parallel.
+ */
+class Compressed_Capture_Writer
+{
+public:
+    Compressed_Capture_Writer();
+    ~Compressed_Capture_Writer();
+
+    /*!
+     * \brief Creates \p filename for the raw file of \p item_type. The chunk
+     * size is rounded down to whole gr_complex items. Returns false on failure.
+     */
+    bool open(const std::string & filename, const std::string & item_type, double sample_rate,
+            size_t chunk_bytes, unsigned int threads);
+
+    bool write(const void * data, size_t bytes);
+
+    //! Writes the last chunk and the index. Returns false on failure.
+    bool close();
+
+    unsigned long long raw_bytes() const
+    {
+        return d_raw_bytes;
+    }
+
+    unsigned long long compressed_bytes() const
+    {
+        return d_compressed_bytes;
+    }
+
+private:
+    bool flush(size_t chunks);  // compresses and writes the first chunks of the pending bytes
+
+    std::ofstream d_file;
+    std::string d_item_type;
+    Compressed_Capture_Model d_model;
+    double d_sample_rate;
+    size_t d_chunk_bytes;
+    unsigned int d_threads;
+    std::vector<unsigned char> d_pending;  // raw bytes not compressed yet
+    std::vector<std::vector<unsigned char> > d_encoded;
+    std::vector<unsigned long long> d_index;
+    unsigned long long d_raw_bytes;
+    unsigned long long d_compressed_bytes;  // file size so far
+};
+
+
+/*!
+ * \brief Reads a compressed capture. Chunks can be read and decompressed
+ * from several threads at the same time.
+ */
+class Compressed_Capture_Reader
+{
+public:
+    Compressed_Capture_Reader();
+    ~Compressed_Capture_Reader();
+
+    //! Reads the header and the index. Returns false if the file is not a valid capture.
+    bool open(const std::string & filename);
+
+    const std::string & item_type() const
+    {
+        return d_item_type;
+    }
+
+    Compressed_Capture_Model model() const
+    {
+        return d_model;
+    }
+
+    double sample_rate() const
+    {
+        return d_sample_rate;
+    }
+
+    //! Bytes of the raw file
+    unsigned long long raw_bytes() const
+    {
+        return d_raw_bytes;
+    }
+
+    size_t chunk_bytes() const
+    {
+        return d_chunk_bytes;
+    }
+
+    size_t chunks() const
+    {
+        return d_index.size();
+    }
+
+    //! Raw bytes of chunk \p i: chunk_bytes(), but for the last one
+    size_t chunk_size(size_t i) const;
+
+    /*!
+     * \brief Decompresses chunk \p i into \p out, of at least chunk_size(i)
+     * bytes. \p scratch holds the compressed chunk; each thread has its own.
+     */
+    bool read_chunk(size_t i, unsigned char * out, std::vector<unsigned char> & scratch) const;
+
+private:
+    int d_fd;
+    std::string d_item_type;
+    Compressed_Capture_Model d_model;
+    double d_sample_rate;
+    unsigned long long d_raw_bytes;
+    size_t d_chunk_bytes;
+    std::vector<unsigned long long> d_index;
+    unsigned long long d_index_offset;   // end of the last chunk
+};
+
+#endif /* GNSS_SDR_COMPRESSED_CAPTURE_H_ */
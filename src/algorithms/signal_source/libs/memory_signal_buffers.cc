@@ -0,0 +1,80 @@
+/*!
+ * \file memory_signal_buffers.cc
+ * \brief Process-wide table of the sample buffers read by Memory_Signal_Source
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "memory_signal_buffers.h"
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace
+{
+typedef std::map<std::string, std::pair<const void *, size_t> > Buffer_Table;
+
+// Built at the first use, as the block tables of the factory
+Buffer_Table & buffer_table()
+{
+    static Buffer_Table table;
+    return table;
+}
+
+std::mutex & buffer_table_mutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+}
+
+
+void Memory_Signal_Buffers::add(const std::string & name, const void * data, size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(buffer_table_mutex());
+    buffer_table()[name] = std::make_pair(data, bytes);
+}
+
+
+bool Memory_Signal_Buffers::find(const std::string & name, const void ** data, size_t * bytes)
+{
+    std::lock_guard<std::mutex> lock(buffer_table_mutex());
+    Buffer_Table::const_iterator it = buffer_table().find(name);
+    if (it == buffer_table().end())
+        {
+            return false;
+        }
+    *data = it->second.first;
+    *bytes = it->second.second;
+    return true;
+}
+
+
+void Memory_Signal_Buffers::remove(const std::string & name)
+{
+    std::lock_guard<std::mutex> lock(buffer_table_mutex());
+    buffer_table().erase(name);
+}
@@ -0,0 +1,56 @@
+/*!
+ * \file memory_signal_buffers.h
+ * \brief Process-wide table of the sample buffers read by Memory_Signal_Source
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MEMORY_SIGNAL_BUFFERS_H_
+#define GNSS_SDR_MEMORY_SIGNAL_BUFFERS_H_
+
+#include <cstddef>
+#include <string>
+
+/*!
+ * \brief Sample buffers of the embedding application, by name.
+ *
+ * The buffers are not copied: the application keeps each one alive, and
+ * unchanged, from add() until the receiver that reads it has stopped and
+ * remove() has been called.
+ */
+class Memory_Signal_Buffers
+{
+public:
+    //! Adds or replaces the buffer \p name
+    static void add(const std::string & name, const void * data, size_t bytes);
+
+    //! False if there is no buffer \p name
+    static bool find(const std::string & name, const void ** data, size_t * bytes);
+
+    static void remove(const std::string & name);
+};
+
+#endif
@@ -0,0 +1,222 @@
+/*!
+ * \file mmap_file_reader.cc
+ * \brief Sequential reader of sample files through a sliding memory map.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "mmap_file_reader.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Windows start at multiples of this, so that they can be backed by huge pages
+#define MMAP_FILE_READER_WINDOW_ALIGNMENT (2 * 1024 * 1024)
+
+
+Mmap_File_Reader::Mmap_File_Reader()
+{
+    d_fd = -1;
+    d_item_size = 1;
+    d_repeat = false;
+    d_window_size = MMAP_FILE_READER_DEFAULT_WINDOW_SIZE;
+    d_start = 0;
+    d_end = 0;
+    d_position = 0;
+    d_window = nullptr;
+    d_window_offset = 0;
+    d_window_length = 0;
+    d_prefetched_offset = 0;
+    d_items_read = 0;
+}
+
+
+Mmap_File_Reader::~Mmap_File_Reader()
+{
+    close();
+}
+
+
+bool Mmap_File_Reader::open(const std::string & filename, size_t item_size, unsigned long long offset,
+        bool repeat, size_t window_size)
+{
+    close();
+    if (item_size == 0)
+        {
+            return false;
+        }
+    d_fd = ::open(filename.c_str(), O_RDONLY);
+    if (d_fd < 0)
+        {
+            return false;
+        }
+    struct stat st;
+    if (fstat(d_fd, &st) != 0 || static_cast<unsigned long long>(st.st_size) <= offset)
+        {
+            close();
+            return false;
+        }
+    d_item_size = item_size;
+    d_repeat = repeat;
+    d_window_size = (std::max(window_size, static_cast<size_t>(1)) + MMAP_FILE_READER_WINDOW_ALIGNMENT - 1)
+            / MMAP_FILE_READER_WINDOW_ALIGNMENT * MMAP_FILE_READER_WINDOW_ALIGNMENT;
+    d_start = offset;
+    d_end = d_start + (st.st_size - d_start) / d_item_size * d_item_size;
+    if (d_end == d_start)
+        {
+            close();
+            return false;
+        }
+    d_position = d_start;
+    d_items_read = 0;
+    posix_fadvise(d_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    return true;
+}
+
+
+void Mmap_File_Reader::close()
+{
+    unmap_window();
+    if (d_fd >= 0)
+        {
+            ::close(d_fd);
+            d_fd = -1;
+        }
+    d_start = 0;
+    d_end = 0;
+    d_position = 0;
+}
+
+
+size_t Mmap_File_Reader::read(void * dest, size_t n_items)
+{
+    if (d_fd < 0)
+        {
+            return 0;
+        }
+    char * out = static_cast<char *>(dest);
+    const unsigned long long wanted = static_cast<unsigned long long>(n_items) * d_item_size;
+    unsigned long long copied = 0;
+    while (copied < wanted)
+        {
+            if (d_position == d_end)
+                {
+                    if (!d_repeat)
+                        {
+                            break;
+                        }
+                    d_position = d_start;
+                }
+            if (d_window == nullptr || d_position < d_window_offset || d_position >= d_window_offset + d_window_length)
+                {
+                    if (!map_window(d_position))
+                        {
+                            break;
+                        }
+                }
+            const unsigned long long window_end = std::min(d_window_offset + d_window_length, d_end);
+            const size_t chunk = std::min(wanted - copied, window_end - d_position);
+            std::memcpy(out + copied, d_window + (d_position - d_window_offset), chunk);
+            copied += chunk;
+            d_position += chunk;
+            if (d_position - d_window_offset > d_window_length / 2)
+                {
+                    prefetch_next_window();
+                }
+        }
+    // only whole items, in case a window could not be mapped in the middle of one
+    const unsigned long long partial = copied % d_item_size;
+    d_position -= partial;
+    d_items_read += copied / d_item_size;
+    return copied / d_item_size;
+}
+
+
+bool Mmap_File_Reader::map_window(unsigned long long position)
+{
+    const unsigned long long previous_offset = d_window_offset;
+    const size_t previous_length = d_window_length;
+    const bool drop_previous = d_window != nullptr && !d_repeat;
+    unmap_window();
+    if (drop_previous)
+        {
+            // read once: do not keep it in the page cache
+            posix_fadvise(d_fd, previous_offset, previous_length, POSIX_FADV_DONTNEED);
+        }
+
+    const unsigned long long offset = position / MMAP_FILE_READER_WINDOW_ALIGNMENT * MMAP_FILE_READER_WINDOW_ALIGNMENT;
+    const size_t length = std::min(static_cast<unsigned long long>(d_window_size), d_end - offset);
+    void * map = mmap(nullptr, length, PROT_READ, MAP_SHARED, d_fd, offset);
+    if (map == MAP_FAILED)
+        {
+            return false;
+        }
+    d_window = static_cast<char *>(map);
+    d_window_offset = offset;
+    d_window_length = length;
+    madvise(map, length, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    madvise(map, length, MADV_HUGEPAGE);
+#endif
+    madvise(map, length, MADV_WILLNEED);
+    d_prefetched_offset = offset;
+    return true;
+}
+
+
+void Mmap_File_Reader::unmap_window()
+{
+    if (d_window != nullptr)
+        {
+            munmap(d_window, d_window_length);
+            d_window = nullptr;
+        }
+    d_window_offset = 0;
+    d_window_length = 0;
+}
+
+
+void Mmap_File_Reader::prefetch_next_window()
+{
+    unsigned long long next = d_window_offset + d_window_length;
+    if (next >= d_end)
+        {
+            if (!d_repeat)
+                {
+                    return;
+                }
+            next = d_start / MMAP_FILE_READER_WINDOW_ALIGNMENT * MMAP_FILE_READER_WINDOW_ALIGNMENT;
+        }
+    if (next == d_prefetched_offset)
+        {
+            return;
+        }
+    posix_fadvise(d_fd, next, std::min(static_cast<unsigned long long>(d_window_size), d_end - next), POSIX_FADV_WILLNEED);
+    d_prefetched_offset = next;
+}
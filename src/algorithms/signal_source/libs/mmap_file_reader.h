@@ -0,0 +1,108 @@
+/*!
+ * \file mmap_file_reader.h
+ * \brief Sequential reader of sample files through a sliding memory map.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The file is not read with read() or fread() into an intermediate buffer:
+ * a window of it is mapped in memory and the samples are copied from the
+ * page cache straight into the destination. The windows are aligned to
+ * huge page boundaries and advised as sequential; when the reader is half
+ * way through a window, the kernel is asked to start reading the next one.
+ * Without repeat, the pages of the windows already read are dropped from
+ * the page cache, so that processing a capture of hundreds of gigabytes
+ * does not evict everything else from memory.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MMAP_FILE_READER_H_
+#define GNSS_SDR_MMAP_FILE_READER_H_
+
+#include <cstddef>
+#include <string>
+
+#define MMAP_FILE_READER_DEFAULT_WINDOW_SIZE (64 * 1024 * 1024)
+
+class Mmap_File_Reader
+{
+public:
+    Mmap_File_Reader();
+    ~Mmap_File_Reader();
+
+    /*!
+     * \brief Opens a file of items of item_size bytes, skipping its first
+     * offset bytes. The window size is rounded up to a whole number of huge
+     * pages. Returns false if the file cannot be opened or has no items.
+     */
+    bool open(const std::string & filename, size_t item_size, unsigned long long offset,
+            bool repeat, size_t window_size = MMAP_FILE_READER_DEFAULT_WINDOW_SIZE);
+
+    void close();
+
+    bool is_open() const
+    {
+        return d_fd >= 0;
+    }
+
+    /*!
+     * \brief Copies the next items (at most n_items) to dest. Returns the
+     * number of items copied, which is smaller than n_items only at the end
+     * of the file (without repeat), and 0 after it.
+     */
+    size_t read(void * dest, size_t n_items);
+
+    //! Items in the file after the offset
+    unsigned long long items() const
+    {
+        return (d_end - d_start) / d_item_size;
+    }
+
+    //! Items read so far, counting again those read again with repeat
+    unsigned long long items_read() const
+    {
+        return d_items_read;
+    }
+
+private:
+    bool map_window(unsigned long long position);
+    void unmap_window();
+    void prefetch_next_window();
+
+    int d_fd;
+    size_t d_item_size;
+    bool d_repeat;
+    size_t d_window_size;              // [bytes], whole huge pages
+    unsigned long long d_start;        // [bytes] first item in the file
+    unsigned long long d_end;          // [bytes] end of the last whole item
+    unsigned long long d_position;     // [bytes] next byte to be read
+
+    char * d_window;
+    unsigned long long d_window_offset;     // [bytes] file offset of d_window
+    size_t d_window_length;                 // [bytes]
+    unsigned long long d_prefetched_offset; // [bytes] file offset of the last window prefetched
+    unsigned long long d_items_read;
+};
+
+#endif
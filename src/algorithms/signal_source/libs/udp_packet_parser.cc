@@ -0,0 +1,156 @@
+/*!
+ * \file udp_packet_parser.cc
+ * \brief Payload and sequence number of the UDP packets of network front ends
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "udp_packet_parser.h"
+
+namespace
+{
+// Packet types of VITA-49 that carry signal data, without and with a stream id
+const unsigned int VITA49_IF_DATA = 0;
+const unsigned int VITA49_IF_DATA_STREAM_ID = 1;
+
+uint32_t read_be32(const unsigned char * p)
+{
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16)
+            | (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+}
+
+
+bool udp_payload_format(const std::string & name, Udp_Payload_Format & format)
+{
+    if (name == "raw")
+        {
+            format = UDP_PAYLOAD_RAW;
+            return true;
+        }
+    if (name == "vita49")
+        {
+            format = UDP_PAYLOAD_VITA49;
+            return true;
+        }
+    return false;
+}
+
+
+bool udp_parse_packet(const unsigned char * data, size_t size, Udp_Payload_Format format, Udp_Packet & packet)
+{
+    packet.payload_offset = 0;
+    packet.payload_bytes = size;
+    packet.has_sequence = false;
+    packet.sequence = 0;
+    packet.sequence_modulo = 1;
+    packet.has_stream_id = false;
+    packet.stream_id = 0;
+    if (format == UDP_PAYLOAD_RAW)
+        {
+            return size > 0;
+        }
+
+    // Header word: type (4 bits), class id present, trailer present, 2
+    // reserved bits, integer and fractional timestamp types (2 bits each),
+    // packet count (4 bits) and packet size in 32-bit words (16 bits)
+    if (size < 4) return false;
+    const uint32_t header = read_be32(data);
+    const unsigned int type = header >> 28;
+    if (type != VITA49_IF_DATA && type != VITA49_IF_DATA_STREAM_ID) return false;
+    const bool class_id = (header >> 27) & 1;
+    const bool trailer = (header >> 26) & 1;
+    const bool integer_timestamp = ((header >> 22) & 3) != 0;
+    const bool fractional_timestamp = ((header >> 20) & 3) != 0;
+    const size_t packet_words = header & 0xFFFF;
+
+    size_t header_words = 1;
+    if (type == VITA49_IF_DATA_STREAM_ID)
+        {
+            if (size < 8) return false;
+            packet.has_stream_id = true;
+            packet.stream_id = read_be32(data + 4);
+            header_words++;
+        }
+    if (class_id) header_words += 2;
+    if (integer_timestamp) header_words += 1;
+    if (fractional_timestamp) header_words += 2;
+    const size_t trailer_words = trailer ? 1 : 0;
+
+    // The datagram may be padded, but not shorter than the packet
+    if (packet_words * 4 > size || packet_words < header_words + trailer_words) return false;
+    packet.payload_offset = header_words * 4;
+    packet.payload_bytes = (packet_words - header_words - trailer_words) * 4;
+    packet.has_sequence = true;
+    packet.sequence = (header >> 16) & 0xF;
+    packet.sequence_modulo = 16;
+    return true;
+}
+
+
+Udp_Sequence_Tracker::Udp_Sequence_Tracker()
+{
+    d_packets = 0;
+    d_lost = 0;
+    d_gaps = 0;
+    reset();
+}
+
+
+void Udp_Sequence_Tracker::reset()
+{
+    d_started = false;
+    d_expected = 0;
+}
+
+
+unsigned int Udp_Sequence_Tracker::next(const Udp_Packet & packet)
+{
+    d_packets++;
+    if (!packet.has_sequence || packet.sequence_modulo < 2)
+        {
+            return 0;
+        }
+    unsigned int lost = 0;
+    if (d_started)
+        {
+            lost = (packet.sequence + packet.sequence_modulo - d_expected) % packet.sequence_modulo;
+            if (lost > packet.sequence_modulo / 2)
+                {
+                    // late or repeated packet: its samples are used, nothing is
+                    // lost, and the next one is still expected
+                    return 0;
+                }
+        }
+    if (lost > 0)
+        {
+            d_gaps++;
+            d_lost += lost;
+        }
+    d_started = true;
+    d_expected = (packet.sequence + 1) % packet.sequence_modulo;
+    return lost;
+}
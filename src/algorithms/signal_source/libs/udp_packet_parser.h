@@ -0,0 +1,109 @@
+/*!
+ * \file udp_packet_parser.h
+ * \brief Payload and sequence number of the UDP packets of network front ends
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Two formats are understood: raw packets, whose whole payload is samples,
+ * and VITA-49 (ANSI/VITA 49.0, VITA Radio Transport) IF data packets, whose
+ * header gives the position of the samples and a 4-bit packet count.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_UDP_PACKET_PARSER_H_
+#define GNSS_SDR_UDP_PACKET_PARSER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+enum Udp_Payload_Format
+{
+    UDP_PAYLOAD_RAW = 0,
+    UDP_PAYLOAD_VITA49 = 1
+};
+
+//! Format of a name, "raw" or "vita49". Returns false if it is neither.
+bool udp_payload_format(const std::string & name, Udp_Payload_Format & format);
+
+struct Udp_Packet
+{
+    size_t payload_offset;       //!< first byte of the samples
+    size_t payload_bytes;        //!< bytes of samples
+    bool has_sequence;           //!< the packet carries a sequence number
+    unsigned int sequence;       //!< modulo sequence_modulo
+    unsigned int sequence_modulo;
+    bool has_stream_id;
+    uint32_t stream_id;
+};
+
+/*!
+ * \brief Finds the samples of a packet of \p size bytes. Returns false if the
+ * packet is not valid in the format, e.g. a VITA-49 context packet or one
+ * shorter than its header says.
+ */
+bool udp_parse_packet(const unsigned char * data, size_t size, Udp_Payload_Format format, Udp_Packet & packet);
+
+/*!
+ * \brief Counts the packets lost between the ones that have been received,
+ * from their sequence numbers. A jump of more than half the modulo cannot
+ * be told apart from a reordered packet; with the 4-bit count of VITA-49
+ * at most 15 packets lost in a row are seen.
+ */
+class Udp_Sequence_Tracker
+{
+public:
+    Udp_Sequence_Tracker();
+
+    //! Returns the packets lost just before this one
+    unsigned int next(const Udp_Packet & packet);
+
+    void reset();
+
+    unsigned long long packets() const
+    {
+        return d_packets;
+    }
+
+    unsigned long long lost_packets() const
+    {
+        return d_lost;
+    }
+
+    //! Times at least one packet was lost
+    unsigned long long gaps() const
+    {
+        return d_gaps;
+    }
+
+private:
+    bool d_started;
+    unsigned int d_expected;
+    unsigned long long d_packets;
+    unsigned long long d_lost;
+    unsigned long long d_gaps;
+};
+
+#endif /* GNSS_SDR_UDP_PACKET_PARSER_H_ */
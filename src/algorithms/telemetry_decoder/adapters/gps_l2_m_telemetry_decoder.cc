@@ -63,6 +63,18 @@ GpsL2MTelemetryDecoder::GpsL2MTelemetryDecoder(ConfigurationInterface* configura
     //decimation factor
     int decimation_factor = configuration->property(role + ".decimation_factor", 1);
     telemetry_decoder_->set_decimation(decimation_factor);
+
+    //output of every tracking epoch [all], one epoch per output_period_ms [rate],
+    //or the preamble epoch of every frame [preamble]
+    std::string output_mode_name = configuration->property(role + ".output_mode", std::string("all"));
+    Telemetry_Output_Decimator::output_mode output_mode = Telemetry_Output_Decimator::all_epochs;
+    if (Telemetry_Output_Decimator::parse_mode(output_mode_name, output_mode) == false)
+        {
+            LOG(WARNING) << role << ".output_mode=" << output_mode_name << " is not all, rate or preamble. Using all";
+        }
+    double default_output_period_ms = (output_mode == Telemetry_Output_Decimator::preambles) ? GPS_L2_CNAV_DATA_PAGE_DURATION_S * 1000 : 100.0;
+    double output_period_ms = configuration->property(role + ".output_period_ms", default_output_period_ms);
+    telemetry_decoder_->set_output_mode(output_mode, output_period_ms);
     LOG(INFO) << "global navigation message queue assigned to telemetry_decoder (" << telemetry_decoder_->unique_id() << ")" << "role " << role;
     channel_ = 0;
 }
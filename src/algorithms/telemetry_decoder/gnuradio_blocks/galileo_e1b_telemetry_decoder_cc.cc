@@ -31,6 +31,7 @@
 
 
 #include "galileo_e1b_telemetry_decoder_cc.h"
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
@@ -38,8 +39,10 @@
 #include <gnuradio/io_signature.h>
 #include <glog/logging.h>
 #include "control_message_factory.h"
+#include "gnss_nav_data_store.h"
+#include "gnss_sdr_event_log.h"
 #include "gnss_synchro.h"
-#include "convolutional.h"
+#include "gnss_sdr_trace.h"
 
 
 #define CRC_ERROR_LIMIT 6
@@ -64,52 +67,11 @@ void galileo_e1b_telemetry_decoder_cc::forecast (int noutput_items, gr_vector_in
 }
 
 
-void galileo_e1b_telemetry_decoder_cc::viterbi_decoder(double *page_part_symbols, int *page_part_bits)
+void galileo_e1b_telemetry_decoder_cc::viterbi_decoder(float *page_part_symbols, int *page_part_bits)
 {
-    int CodeLength = 240;
-    int DataLength;
-    int nn, KK, mm, max_states;
-    int g_encoder[2];
-
-    nn = 2;             // Coding rate 1/n
-    KK = 7;             // Constraint Length
-    g_encoder[0] = 121; // Polynomial G1
-    g_encoder[1] = 91;  // Polynomial G2
-
-    mm = KK - 1;
-    max_states = 1 << mm; /* 2^mm */
-    DataLength = (CodeLength/nn) - mm;
-
-    /* create appropriate transition matrices */
-    int *out0, *out1, *state0, *state1;
-    out0 = (int*)calloc( max_states, sizeof(int) );
-    out1 = (int*)calloc( max_states, sizeof(int) );
-    state0 = (int*)calloc( max_states, sizeof(int) );
-    state1 = (int*)calloc( max_states, sizeof(int) );
-
-    nsc_transit( out0, state0, 0, g_encoder, KK, nn );
-    nsc_transit( out1, state1, 1, g_encoder, KK, nn );
-
-    Viterbi(page_part_bits, out0, state0, out1, state1,
-            page_part_symbols, KK, nn, DataLength );
-
-    /* Clean up memory */
-    free( out0 );
-    free( out1 );
-    free( state0 );
-    free( state1 );
-}
-
-
-void galileo_e1b_telemetry_decoder_cc::deinterleaver(int rows, int cols, double *in, double *out)
-{
-    for (int r = 0; r < rows; r++)
-        {
-            for(int c = 0; c < cols; c++)
-                {
-                    out[c*rows + r] = in[r*cols + c];
-                }
-        }
+    const int CodeLength = 240;
+    const int DataLength = (CodeLength / 2) - 6;  // rate 1/2, without the 6 tail bits
+    d_viterbi->decode_block(page_part_symbols, page_part_bits, DataLength);
 }
 
 
@@ -117,7 +79,8 @@ galileo_e1b_telemetry_decoder_cc::galileo_e1b_telemetry_decoder_cc(
         Gnss_Satellite satellite,
         bool dump) :
                    gr::block("galileo_e1b_telemetry_decoder_cc", gr::io_signature::make(1, 1, sizeof(Gnss_Synchro)),
-                           gr::io_signature::make(1, 1, sizeof(Gnss_Synchro)))
+                           gr::io_signature::make(1, 1, sizeof(Gnss_Synchro))),
+                   d_deinterleaver(GALILEO_INAV_INTERLEAVER_ROWS, GALILEO_INAV_INTERLEAVER_COLS)
 {
     // Telemetry Bit transition synchronization port out
     this->message_port_register_out(pmt::mp("preamble_timestamp_s"));
@@ -137,23 +100,9 @@ galileo_e1b_telemetry_decoder_cc::galileo_e1b_telemetry_decoder_cc(
     memcpy((unsigned short int*)this->d_preambles_bits, (unsigned short int*)preambles_bits, GALILEO_INAV_PREAMBLE_LENGTH_BITS*sizeof(unsigned short int));
 
     // preamble bits to sampled symbols
-    d_preambles_symbols = (signed int*)malloc(sizeof(signed int) * d_symbols_per_preamble);
-    int n = 0;
-    for (int i = 0; i < GALILEO_INAV_PREAMBLE_LENGTH_BITS; i++)
-        {
-            for (unsigned int j = 0; j < d_samples_per_symbol; j++)
-                {
-                    if (d_preambles_bits[i] == 1)
-                        {
-                            d_preambles_symbols[n] = 1;
-                        }
-                    else
-                        {
-                            d_preambles_symbols[n] = -1;
-                        }
-                    n++;
-                }
-        }
+    d_preamble_correlator = new Preamble_Correlator(d_preambles_bits, GALILEO_INAV_PREAMBLE_LENGTH_BITS, d_samples_per_symbol);
+    int g_encoder[2] = { 121, 91 };  // Polynomials G1 and G2
+    d_viterbi = new Viterbi_Decoder(g_encoder, 7, 2);
     d_sample_counter = 0;
     d_stat = 0;
     d_preamble_index = 0;
@@ -171,34 +120,26 @@ galileo_e1b_telemetry_decoder_cc::galileo_e1b_telemetry_decoder_cc(
     d_channel = 0;
     Prn_timestamp_at_preamble_ms = 0.0;
     flag_TOW_set = false;
-    d_average_count = 0;
-    d_decimation_output_factor = 1;
 }
 
 
 galileo_e1b_telemetry_decoder_cc::~galileo_e1b_telemetry_decoder_cc()
 {
-    delete d_preambles_symbols;
+    delete d_preamble_correlator;
+    delete d_viterbi;
     d_dump_file.close();
 }
 
 
 void galileo_e1b_telemetry_decoder_cc::decode_word(double *page_part_symbols,int frame_length)
 {
-    double page_part_symbols_deint[frame_length];
-    // 1. De-interleave
-    deinterleaver(GALILEO_INAV_INTERLEAVER_ROWS, GALILEO_INAV_INTERLEAVER_COLS, page_part_symbols, page_part_symbols_deint);
-
+    float page_part_symbols_deint[frame_length];
+    // 1. De-interleave, narrowing the soft symbols to float
     // 2. Viterbi decoder
-    // 2.1 Take into account the NOT gate in G2 polynomial (Galileo ICD Figure 13, FEC encoder)
-    // 2.2 Take into account the possible inversion of the polarity due to PLL lock at 180�
-    for (int i = 0; i < frame_length; i++)
-        {
-            if ((i + 1) % 2 == 0)
-                {
-                    page_part_symbols_deint[i] = -page_part_symbols_deint[i];
-                }
-        }
+    // 2.1 Take into account the NOT gate in G2 polynomial (Galileo ICD Figure 13, FEC encoder):
+    //     the deinterleaver negates every other symbol
+    // 2.2 Take into account the possible inversion of the polarity due to PLL lock at 180 degrees
+    d_deinterleaver.deinterleave(page_part_symbols, page_part_symbols_deint);
 
     int page_part_bits[frame_length/2];
     viterbi_decoder(page_part_symbols_deint, page_part_bits);
@@ -223,13 +164,11 @@ void galileo_e1b_telemetry_decoder_cc::decode_word(double *page_part_symbols,int
             d_nav.split_page(page_String, flag_even_word_arrived);
             if(d_nav.flag_CRC_test == true)
                 {
-                    LOG(INFO) << "Galileo CRC correct on channel " << d_channel << " from satellite " << d_satellite;
-                    std::cout << "Galileo CRC correct on channel " << d_channel << " from satellite " << d_satellite << std::endl;
+                    Gnss_Sdr_Event_Log::satellite_event(EVENT_GALILEO_CRC_OK, d_channel, 'E', d_satellite.get_PRN(), 0, EVENT_TO_CONSOLE | EVENT_TO_LOG);
                 }
             else
                 {
-                    std::cout << "Galileo CRC error on channel " << d_channel <<  " from satellite " << d_satellite << std::endl;
-                    LOG(INFO) << "Galileo CRC error on channel " << d_channel <<  " from satellite " << d_satellite;
+                    Gnss_Sdr_Event_Log::satellite_event(EVENT_GALILEO_CRC_ERROR, d_channel, 'E', d_satellite.get_PRN(), 0, EVENT_TO_CONSOLE | EVENT_TO_LOG);
                 }
             flag_even_word_arrived = 0;
         }
@@ -240,42 +179,37 @@ void galileo_e1b_telemetry_decoder_cc::decode_word(double *page_part_symbols,int
             flag_even_word_arrived = 1;
         }
 
-    // 4. Push the new navigation data to the queues
+    // 4. Push the new navigation data to the store
     if (d_nav.have_new_ephemeris() == true)
         {
             // get object for this SV (mandatory)
-            std::shared_ptr<Galileo_Ephemeris> tmp_obj = std::make_shared<Galileo_Ephemeris>(d_nav.get_ephemeris());
-
-            this->message_port_pub(pmt::mp("telemetry"), pmt::make_any(tmp_obj));
-
+            Gnss_Nav_Data_Store::instance().update(d_nav.get_ephemeris());
         }
     if (d_nav.have_new_iono_and_GST() == true)
         {
             // get object for this SV (mandatory)
-            std::shared_ptr<Galileo_Iono> tmp_obj = std::make_shared<Galileo_Iono>(d_nav.get_iono());
-            this->message_port_pub(pmt::mp("telemetry"), pmt::make_any(tmp_obj));
+            Gnss_Nav_Data_Store::instance().update(d_nav.get_iono());
         }
     if (d_nav.have_new_utc_model() == true)
         {
             // get object for this SV (mandatory)
-            std::shared_ptr<Galileo_Utc_Model> tmp_obj = std::make_shared<Galileo_Utc_Model>(d_nav.get_utc_model());
-            this->message_port_pub(pmt::mp("telemetry"), pmt::make_any(tmp_obj));
+            Gnss_Nav_Data_Store::instance().update(d_nav.get_utc_model());
         }
     if (d_nav.have_new_almanac() == true)
         {
-            std::shared_ptr<Galileo_Almanac> tmp_obj= std::make_shared<Galileo_Almanac>(d_nav.get_almanac());
-            this->message_port_pub(pmt::mp("telemetry"), pmt::make_any(tmp_obj));
+            const Galileo_Almanac almanac = d_nav.get_almanac();
+            Gnss_Nav_Data_Store::instance().update(almanac);
             //debug
-            std::cout << "Galileo almanac received!" << std::endl;
+            Gnss_Sdr_Event_Log::satellite_event(EVENT_GALILEO_ALMANAC, d_channel, 'E', d_satellite.get_PRN());
             LOG(INFO) << "GPS_to_Galileo time conversion:";
-            LOG(INFO) << "A0G=" << tmp_obj->A_0G_10;
-            LOG(INFO) << "A1G=" << tmp_obj->A_1G_10;
-            LOG(INFO) << "T0G=" << tmp_obj->t_0G_10;
-            LOG(INFO) << "WN_0G_10=" << tmp_obj->WN_0G_10;
+            LOG(INFO) << "A0G=" << almanac.A_0G_10;
+            LOG(INFO) << "A1G=" << almanac.A_1G_10;
+            LOG(INFO) << "T0G=" << almanac.t_0G_10;
+            LOG(INFO) << "WN_0G_10=" << almanac.WN_0G_10;
             LOG(INFO) << "Current parameters:";
             LOG(INFO) << "d_TOW_at_current_symbol=" << d_TOW_at_current_symbol;
             LOG(INFO) << "d_nav.WN_0=" << d_nav.WN_0;
-            delta_t = tmp_obj->A_0G_10 + tmp_obj->A_1G_10 * (d_TOW_at_current_symbol - tmp_obj->t_0G_10 + 604800 * (fmod((d_nav.WN_0 - tmp_obj->WN_0G_10), 64)));
+            delta_t = almanac.A_0G_10 + almanac.A_1G_10 * (d_TOW_at_current_symbol - almanac.t_0G_10 + 604800 * (fmod((d_nav.WN_0 - almanac.WN_0G_10), 64)));
             LOG(INFO) << "delta_t=" << delta_t << "[s]";
         }
 }
@@ -286,6 +220,7 @@ void galileo_e1b_telemetry_decoder_cc::decode_word(double *page_part_symbols,int
 int galileo_e1b_telemetry_decoder_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
         gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE("galileo_e1b_telemetry_decoder_cc::general_work");
     int corr_value = 0;
     int preamble_diff = 0;
 
@@ -295,19 +230,15 @@ int galileo_e1b_telemetry_decoder_cc::general_work (int noutput_items __attribut
     // ########### Output the tracking data to navigation and PVT ##########
     const Gnss_Synchro **in = (const Gnss_Synchro **)  &input_items[0]; //Get the input samples pointer
 
-    // TODO Optimize me!
     //******* preamble correlation ********
-    for (int i = 0; i < d_symbols_per_preamble; i++)
+    // push the symbols of the preamble window that the correlator has not seen yet
+    unsigned long int first_symbol = nitems_read(0);
+    unsigned long int next_symbol = std::max(d_preamble_correlator->symbols_pushed(), first_symbol);
+    for (unsigned long int k = next_symbol; k < first_symbol + d_symbols_per_preamble; k++)
         {
-            if (in[0][i].Prompt_I < 0)    // symbols clipping
-                {
-                    corr_value -= d_preambles_symbols[i];
-                }
-            else
-                {
-                    corr_value += d_preambles_symbols[i];
-                }
+            d_preamble_correlator->push_symbol(in[0][k - first_symbol].Prompt_I);
         }
+    corr_value = d_preamble_correlator->correlation();
     d_flag_preamble = false;
 
     //******* frame sync ******************
@@ -463,7 +394,6 @@ int galileo_e1b_telemetry_decoder_cc::general_work (int noutput_items __attribut
     current_synchro_data.d_TOW_hybrid_at_current_symbol = current_synchro_data.d_TOW_at_current_symbol - delta_t; //delta_t = t_gal - t_gps  ---->  t_gps = t_gal -delta_t
     current_synchro_data.Flag_preamble = d_flag_preamble;
     current_synchro_data.Prn_timestamp_ms = in[0][0].Tracking_timestamp_secs * 1000.0;
-    current_synchro_data.Prn_timestamp_at_preamble_ms = Prn_timestamp_at_preamble_ms;
 
     if(d_dump == true)
         {
@@ -483,12 +413,8 @@ int galileo_e1b_telemetry_decoder_cc::general_work (int noutput_items __attribut
                     LOG(WARNING) << "Exception writing observables dump file " << e.what();
             }
         }
-    //todo: implement averaging
-    d_average_count++;
-
-    if (d_average_count == d_decimation_output_factor)
+    if (d_output_decimator.output(current_synchro_data.Prn_timestamp_ms, d_flag_frame_sync, d_flag_preamble))
         {
-            d_average_count = 0;
             //3. Make the output (copy the object contents to the GNURadio reserved memory)
             *out[0] = current_synchro_data;
             //std::cout<<"GPS L1 TLM output on CH="<<this->d_channel << " SAMPLE STAMP="<<d_sample_counter/d_decimation_output_factor<<std::endl;
@@ -504,7 +430,13 @@ int galileo_e1b_telemetry_decoder_cc::general_work (int noutput_items __attribut
 
 void galileo_e1b_telemetry_decoder_cc::set_decimation(int decimation)
 {
-    d_decimation_output_factor = decimation;
+    d_output_decimator.set_decimation(decimation);
+}
+
+
+void galileo_e1b_telemetry_decoder_cc::set_output_mode(Telemetry_Output_Decimator::output_mode mode, double period_ms)
+{
+    d_output_decimator.set_mode(mode, period_ms);
 }
 
 
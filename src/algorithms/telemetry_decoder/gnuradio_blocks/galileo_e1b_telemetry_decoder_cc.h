@@ -38,11 +38,15 @@
 #include "Galileo_E1.h"
 #include "concurrent_queue.h"
 #include "gnss_satellite.h"
+#include "telemetry_output_decimator.h"
 #include "galileo_navigation_message.h"
 #include "galileo_ephemeris.h"
 #include "galileo_almanac.h"
 #include "galileo_iono.h"
 #include "galileo_utc_model.h"
+#include "galileo_page_deinterleaver.h"
+#include "preamble_correlator.h"
+#include "viterbi_decoder.h"
 
 
 
@@ -67,6 +71,11 @@ public:
      * \brief Set decimation factor to average the GPS synchronization estimation output from the tracking module.
      */
     void set_decimation(int decimation);
+    /*!
+     * \brief Sends only some epochs to the observables, see Telemetry_Output_Decimator.
+     * \param period_ms - length of the output cells in the sparse modes [ms].
+     */
+    void set_output_mode(Telemetry_Output_Decimator::output_mode mode, double period_ms);
 
     /*!
      * \brief This is where all signal processing takes place
@@ -85,15 +94,15 @@ private:
     galileo_e1b_make_telemetry_decoder_cc(Gnss_Satellite satellite, bool dump);
     galileo_e1b_telemetry_decoder_cc(Gnss_Satellite satellite, bool dump);
 
-    void viterbi_decoder(double *page_part_symbols, int *page_part_bits);
-
-    void deinterleaver(int rows, int cols, double *in, double *out);
+    void viterbi_decoder(float *page_part_symbols, int *page_part_bits);
 
     void decode_word(double *symbols,int frame_length);
 
     unsigned short int d_preambles_bits[GALILEO_INAV_PREAMBLE_LENGTH_BITS];
 
-    int *d_preambles_symbols;
+    Preamble_Correlator *d_preamble_correlator;
+    Viterbi_Decoder *d_viterbi;
+    Galileo_Page_Deinterleaver d_deinterleaver;
     unsigned int d_samples_per_symbol;
     int d_symbols_per_preamble;
 
@@ -113,9 +122,8 @@ private:
     Gnss_Satellite d_satellite;
     int d_channel;
 
-    // output averaging and decimation
-    int d_average_count;
-    int d_decimation_output_factor;
+    // output decimation
+    Telemetry_Output_Decimator d_output_decimator;
 
     double d_preamble_time_seconds;
 
@@ -41,8 +41,10 @@
 #include <gnuradio/io_signature.h>
 #include <glog/logging.h>
 #include "control_message_factory.h"
+#include "gnss_nav_data_store.h"
+#include "gnss_sdr_event_log.h"
 #include "gnss_synchro.h"
-#include "convolutional.h"
+#include "gnss_sdr_trace.h"
 
 
 #define CRC_ERROR_LIMIT 6
@@ -67,76 +69,23 @@ void galileo_e5a_telemetry_decoder_cc::forecast (int noutput_items, gr_vector_in
 }
 
 
-void galileo_e5a_telemetry_decoder_cc::viterbi_decoder(double *page_part_symbols, int *page_part_bits)
+void galileo_e5a_telemetry_decoder_cc::viterbi_decoder(float *page_part_symbols, int *page_part_bits)
 {
-    //    int CodeLength = 240;
-    int CodeLength = 488;
-    int DataLength;
-    int nn, KK, mm, max_states;
-    int g_encoder[2];
-
-    nn = 2;             // Coding rate 1/n
-    KK = 7;             // Constraint Length
-    g_encoder[0] = 121; // Polynomial G1
-    g_encoder[1] = 91;  // Polynomial G2
-    //    g_encoder[0] = 171; // Polynomial G1
-    //    g_encoder[1] = 133;  // Polynomial G2
-
-    mm = KK - 1;
-    max_states = 1 << mm; // 2^mm
-    DataLength = (CodeLength/nn) - mm;
-
-    //create appropriate transition matrices
-
-    int *out0, *out1, *state0, *state1;
-    out0 = (int*)calloc( max_states, sizeof(int) );
-    out1 = (int*)calloc( max_states, sizeof(int) );
-    state0 = (int*)calloc( max_states, sizeof(int) );
-    state1 = (int*)calloc( max_states, sizeof(int) );
-
-    nsc_transit( out0, state0, 0, g_encoder, KK, nn );
-    nsc_transit( out1, state1, 1, g_encoder, KK, nn );
-
-    Viterbi(page_part_bits, out0, state0, out1, state1,
-            page_part_symbols, KK, nn, DataLength );
-
-    //Clean up memory
-    free( out0 );
-    free( out1 );
-    free( state0 );
-    free( state1 );
-}
-
-
-void galileo_e5a_telemetry_decoder_cc::deinterleaver(int rows, int cols, double *in, double *out)
-{
-    for (int r = 0; r < rows; r++)
-        {
-            for(int c = 0; c < cols; c++)
-                {
-                    out[c*rows + r] = in[r*cols + c];
-                }
-        }
+    const int CodeLength = 488;
+    const int DataLength = (CodeLength / 2) - 6;  // rate 1/2, without the 6 tail bits
+    d_viterbi->decode_block(page_part_symbols, page_part_bits, DataLength);
 }
 
 
 void galileo_e5a_telemetry_decoder_cc::decode_word(double *page_symbols,int frame_length)
 {
-    double page_symbols_deint[frame_length];
-    // 1. De-interleave
-
-    galileo_e5a_telemetry_decoder_cc::deinterleaver(GALILEO_FNAV_INTERLEAVER_ROWS, GALILEO_FNAV_INTERLEAVER_COLS, page_symbols, page_symbols_deint);
-
+    float page_symbols_deint[frame_length];
+    // 1. De-interleave, narrowing the soft symbols to float
     // 2. Viterbi decoder
-    // 2.1 Take into account the NOT gate in G2 polynomial (Galileo ICD Figure 13, FEC encoder)
-    // 2.2 Take into account the possible inversion of the polarity due to PLL lock at 180�
-    for (int i = 0; i < frame_length; i++)
-        {
-            if ((i + 1) % 2 == 0)
-                {
-                    page_symbols_deint[i] = -page_symbols_deint[i];
-                }
-        }
+    // 2.1 Take into account the NOT gate in G2 polynomial (Galileo ICD Figure 13, FEC encoder):
+    //     the deinterleaver negates every other symbol
+    // 2.2 Take into account the possible inversion of the polarity due to PLL lock at 180 degrees
+    d_deinterleaver.deinterleave(page_symbols, page_symbols_deint);
     int page_bits[frame_length/2];
     galileo_e5a_telemetry_decoder_cc::viterbi_decoder(page_symbols_deint, page_bits);
 
@@ -158,30 +107,25 @@ void galileo_e5a_telemetry_decoder_cc::decode_word(double *page_symbols,int fram
     d_nav.split_page(page_String);
     if(d_nav.flag_CRC_test == true)
         {
-            LOG(INFO) << "Galileo CRC correct on channel " << d_channel << " from satellite " << d_satellite;
-            std::cout << "Galileo CRC correct on channel " << d_channel << " from satellite " << d_satellite << std::endl;
+            Gnss_Sdr_Event_Log::satellite_event(EVENT_GALILEO_CRC_OK, d_channel, 'E', d_satellite.get_PRN(), 0, EVENT_TO_CONSOLE | EVENT_TO_LOG);
         }
     else
         {
-            std::cout << "Galileo CRC error on channel " << d_channel << " from satellite " << d_satellite << std::endl;
-            LOG(INFO)<< "Galileo CRC error on channel " << d_channel << " from satellite " << d_satellite;
+            Gnss_Sdr_Event_Log::satellite_event(EVENT_GALILEO_CRC_ERROR, d_channel, 'E', d_satellite.get_PRN(), 0, EVENT_TO_CONSOLE | EVENT_TO_LOG);
         }
 
-    // 4. Push the new navigation data to the queues
+    // 4. Push the new navigation data to the store
     if (d_nav.have_new_ephemeris() == true)
         {
-            std::shared_ptr<Galileo_Ephemeris> tmp_obj= std::make_shared<Galileo_Ephemeris>(d_nav.get_ephemeris());
-            this->message_port_pub(pmt::mp("telemetry"), pmt::make_any(tmp_obj));
+            Gnss_Nav_Data_Store::instance().update(d_nav.get_ephemeris());
         }
     if (d_nav.have_new_iono_and_GST() == true)
         {
-            std::shared_ptr<Galileo_Iono> tmp_obj= std::make_shared<Galileo_Iono>(d_nav.get_iono());
-            this->message_port_pub(pmt::mp("telemetry"), pmt::make_any(tmp_obj));
+            Gnss_Nav_Data_Store::instance().update(d_nav.get_iono());
         }
     if (d_nav.have_new_utc_model() == true)
         {
-            std::shared_ptr<Galileo_Utc_Model> tmp_obj= std::make_shared<Galileo_Utc_Model>(d_nav.get_utc_model());
-            this->message_port_pub(pmt::mp("telemetry"), pmt::make_any(tmp_obj));
+            Gnss_Nav_Data_Store::instance().update(d_nav.get_utc_model());
         }
 
 }
@@ -190,7 +134,8 @@ galileo_e5a_telemetry_decoder_cc::galileo_e5a_telemetry_decoder_cc(
         Gnss_Satellite satellite,
         bool dump) :
                    gr::block("galileo_e5a_telemetry_decoder_cc", gr::io_signature::make(1, 1, sizeof(Gnss_Synchro)),
-                           gr::io_signature::make(1, 1, sizeof(Gnss_Synchro)))
+                           gr::io_signature::make(1, 1, sizeof(Gnss_Synchro))),
+                   d_deinterleaver(GALILEO_FNAV_INTERLEAVER_ROWS, GALILEO_FNAV_INTERLEAVER_COLS)
 {
     // Telemetry Bit transition synchronization port out
     this->message_port_register_out(pmt::mp("preamble_timestamp_s"));
@@ -202,41 +147,23 @@ galileo_e5a_telemetry_decoder_cc::galileo_e5a_telemetry_decoder_cc(
     LOG(INFO) << "GALILEO E5A TELEMETRY PROCESSING: satellite " << d_satellite;
     //d_samples_per_symbol = ( Galileo_E5a_CODE_CHIP_RATE_HZ / Galileo_E5a_CODE_LENGTH_CHIPS ) / Galileo_E1_B_SYMBOL_RATE_BPS;
 
-    // set the preamble
-    //unsigned short int preambles_bits[GALILEO_FNAV_PREAMBLE_LENGTH_BITS] = GALILEO_FNAV_PREAMBLE;
+    // set the preamble (a '0' is a positive symbol)
+    unsigned short int preambles_bits[GALILEO_FNAV_PREAMBLE_LENGTH_BITS];
     for (int i = 0; i < GALILEO_FNAV_PREAMBLE_LENGTH_BITS; i++)
         {
             if (GALILEO_FNAV_PREAMBLE.at(i) == '0')
                 {
-                    d_preamble_bits[i] = 1;
+                    preambles_bits[i] = 1;
                 }
             else
                 {
-                    d_preamble_bits[i] = -1;
+                    preambles_bits[i] = 0;
                 }
         }
+    d_preamble_correlator = new Preamble_Correlator(preambles_bits, GALILEO_FNAV_PREAMBLE_LENGTH_BITS, 1);
+    int g_encoder[2] = { 121, 91 };  // Polynomials G1 and G2
+    d_viterbi = new Viterbi_Decoder(g_encoder, 7, 2);
 
-    //    memcpy((unsigned short int*)this->d_preambles_bits, (unsigned short int*)preambles_bits, GALILEO_FNAV_PREAMBLE_LENGTH_BITS*sizeof(unsigned short int));
-
-    //    // preamble bits to sampled symbols
-    //    d_preambles_symbols = (signed int*)malloc(sizeof(signed int) * GALILEO_FNAV_SAMPLES_PER_PREAMBLE);
-    //    int n = 0;
-    //    for (int i = 0; i < GALILEO_FNAV_PREAMBLE_LENGTH_BITS; i++)
-    //        {
-    //            for (unsigned int j = 0; j < GALILEO_FNAV_SAMPLES_PER_SYMBOL; j++)
-    //                {
-    //                    if (d_preambles_bits[i] == 1)
-    //                        {
-    //                            d_preambles_symbols[n] = 1;
-    //                        }
-    //                    else
-    //                        {
-    //                            d_preambles_symbols[n] = -1;
-    //                        }
-    //                    n++;
-    //                }
-    //        }
-    //
     d_sample_counter = 0;
     d_state = 0;
     d_preamble_lock = false;
@@ -262,6 +189,8 @@ galileo_e5a_telemetry_decoder_cc::galileo_e5a_telemetry_decoder_cc(
 
 galileo_e5a_telemetry_decoder_cc::~galileo_e5a_telemetry_decoder_cc()
 {
+    delete d_preamble_correlator;
+    delete d_viterbi;
     d_dump_file.close();
 }
 
@@ -269,6 +198,7 @@ galileo_e5a_telemetry_decoder_cc::~galileo_e5a_telemetry_decoder_cc()
 int galileo_e5a_telemetry_decoder_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
         gr_vector_const_void_star &input_items,    gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE("galileo_e5a_telemetry_decoder_cc::general_work");
     //
     const Gnss_Synchro **in = (const Gnss_Synchro **)  &input_items[0]; //Get the input samples pointer
     Gnss_Synchro **out = (Gnss_Synchro **) &output_items[0];
@@ -297,6 +227,7 @@ int galileo_e5a_telemetry_decoder_cc::general_work (int noutput_items __attribut
                                 {
                                     d_page_symbols[d_symbol_counter] = -1;
                                 }
+                            d_preamble_correlator->push_symbol(d_current_symbol);
                             d_current_symbol = 0;
                             d_symbol_counter++;
                             d_prompt_counter = 0;
@@ -326,37 +257,13 @@ int galileo_e5a_telemetry_decoder_cc::general_work (int noutput_items __attribut
                             d_page_symbols[d_symbol_counter] = -1;
                         }
                     //            d_page_symbols[d_symbol_counter] = d_current_symbol_float/(float)GALILEO_FNAV_CODES_PER_SYMBOL;
+                    d_preamble_correlator->push_symbol(d_current_symbol);
                     d_current_symbol = 0;
                     d_symbol_counter++;
                     d_prompt_counter = 0;
                     // **** Attempt Preamble correlation ****
-                    bool corr_flag=true;
-                    int corr_sign = 0; // sequence can be found inverted
-                    // check if the preamble starts positive correlated or negative correlated
-                    if (d_page_symbols[d_symbol_counter - GALILEO_FNAV_PREAMBLE_LENGTH_BITS] < 0)    // symbols clipping
-                        {
-                            corr_sign=-d_preamble_bits[0];
-                        }
-                    else
-                        {
-                            corr_sign=d_preamble_bits[0];
-                        }
-                    // the preamble is fully correlated only if maintains corr_sign along the whole sequence
-                    for (int i = 1; i < GALILEO_FNAV_PREAMBLE_LENGTH_BITS; i++)
-                        {
-                            if (d_page_symbols[d_symbol_counter - GALILEO_FNAV_PREAMBLE_LENGTH_BITS + i] < 0 && d_preamble_bits[i]+corr_sign != 0)
-                                {
-                                    //exit for
-                                    corr_flag=false;
-                                    break;
-                                }
-                            if (d_page_symbols[d_symbol_counter - GALILEO_FNAV_PREAMBLE_LENGTH_BITS + i] > 0 && d_preamble_bits[i]+corr_sign == 0)
-                                {
-                                    //exit for
-                                    corr_flag=false;
-                                    break;
-                                }
-                        }
+                    // the sequence can be found inverted
+                    bool corr_flag = (abs(d_preamble_correlator->correlation()) == GALILEO_FNAV_PREAMBLE_LENGTH_BITS);
                     //
                     if (corr_flag==true) // preamble fully correlates
                         {
@@ -390,6 +297,7 @@ int galileo_e5a_telemetry_decoder_cc::general_work (int noutput_items __attribut
                             d_page_symbols[d_symbol_counter] = -1;
                         }
                     // d_page_symbols[d_symbol_counter] = d_current_symbol_float/(float)GALILEO_FNAV_CODES_PER_SYMBOL;
+                    d_preamble_correlator->push_symbol(d_current_symbol);
                     d_current_symbol = 0;
                     d_symbol_counter++;
                     d_prompt_counter = 0;
@@ -397,43 +305,8 @@ int galileo_e5a_telemetry_decoder_cc::general_work (int noutput_items __attribut
                     if (d_sample_counter == d_preamble_index + GALILEO_FNAV_CODES_PER_PAGE + GALILEO_FNAV_CODES_PER_PREAMBLE)
                         {
                             // **** Attempt Preamble correlation ****
-                            bool corr_flag = true;
-                            int corr_sign = 0; // sequence can be found inverted
-                            //    corr_sign = d_preamble_bits[0] * d_page_symbols[d_symbol_counter - GALILEO_FNAV_PREAMBLE_LENGTH_BITS];
-                            //    for (int i = 1; i < GALILEO_FNAV_PREAMBLE_LENGTH_BITS; i++)
-                            //       {
-                            //          if ((d_preamble_bits[i] * d_page_symbols[i + d_symbol_counter - GALILEO_FNAV_PREAMBLE_LENGTH_BITS]) != corr_sign)
-                            //              {
-                            //                  //exit for if one bit doesn't correlate
-                            //                corr_flag = false;
-                            //                  break;
-                            //              }
-                            //     }
-                            // check if the preamble starts positive correlated or negative correlated
-                            if (d_page_symbols[d_symbol_counter - GALILEO_FNAV_PREAMBLE_LENGTH_BITS] < 0)    // symbols clipping
-                                {
-                                    corr_sign=-d_preamble_bits[0];
-                                }
-                            else
-                                {
-                                    corr_sign=d_preamble_bits[0];
-                                }
-                            // the preamble is fully correlated only if maintains corr_sign along the whole sequence
-                            for (int i = 1; i < GALILEO_FNAV_PREAMBLE_LENGTH_BITS; i++)
-                                {
-                                    if (d_page_symbols[d_symbol_counter - GALILEO_FNAV_PREAMBLE_LENGTH_BITS + i] < 0 && d_preamble_bits[i]+corr_sign != 0)
-                                        {
-                                            //exit for
-                                            corr_flag=false;
-                                            break;
-                                        }
-                                    if (d_page_symbols[d_symbol_counter - GALILEO_FNAV_PREAMBLE_LENGTH_BITS + i] > 0 && d_preamble_bits[i]+corr_sign == 0)
-                                        {
-                                            //exit for
-                                            corr_flag=false;
-                                            break;
-                                        }
-                                }
+                            // the sequence can be found inverted
+                            bool corr_flag = (abs(d_preamble_correlator->correlation()) == GALILEO_FNAV_PREAMBLE_LENGTH_BITS);
 
                             if (corr_flag==true) // NEW PREAMBLE RECEIVED. DECODE PAGE
                                 {
@@ -542,7 +415,6 @@ int galileo_e5a_telemetry_decoder_cc::general_work (int noutput_items __attribut
     current_synchro_data.d_TOW_at_current_symbol = d_TOW_at_current_symbol;
     current_synchro_data.Flag_preamble = d_flag_preamble;
     current_synchro_data.Prn_timestamp_ms = in[0][0].Tracking_timestamp_secs * 1000.0;
-    current_synchro_data.Prn_timestamp_at_preamble_ms = Prn_timestamp_at_preamble_ms;
 
     if(d_dump == true)
         {
@@ -47,6 +47,9 @@
 #include "galileo_almanac.h"
 #include "galileo_iono.h"
 #include "galileo_utc_model.h"
+#include "galileo_page_deinterleaver.h"
+#include "preamble_correlator.h"
+#include "viterbi_decoder.h"
 
 //#include "convolutional.h"
 
@@ -84,13 +87,13 @@ private:
     galileo_e5a_make_telemetry_decoder_cc(Gnss_Satellite satellite, bool dump);
     galileo_e5a_telemetry_decoder_cc(Gnss_Satellite satellite, bool dump);
 
-    void viterbi_decoder(double *page_part_symbols, int *page_part_bits);
-
-    void deinterleaver(int rows, int cols, double *in, double *out);
+    void viterbi_decoder(float *page_part_symbols, int *page_part_bits);
 
     void decode_word(double *page_symbols,int frame_length);
 
-    int d_preamble_bits[GALILEO_FNAV_PREAMBLE_LENGTH_BITS];
+    Preamble_Correlator *d_preamble_correlator;
+    Viterbi_Decoder *d_viterbi;
+    Galileo_Page_Deinterleaver d_deinterleaver;
     // signed int d_page_symbols[GALILEO_FNAV_SYMBOLS_PER_PAGE + GALILEO_FNAV_PREAMBLE_LENGTH_BITS];
     double d_page_symbols[GALILEO_FNAV_SYMBOLS_PER_PAGE + GALILEO_FNAV_PREAMBLE_LENGTH_BITS];
     // signed int *d_preamble_symbols;
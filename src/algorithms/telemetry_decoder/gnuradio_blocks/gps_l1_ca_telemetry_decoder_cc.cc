@@ -30,12 +30,16 @@
  */
 
 #include "gps_l1_ca_telemetry_decoder_cc.h"
+#include <algorithm>
 #include <iostream>
 #include <boost/lexical_cast.hpp>
 #include <gnuradio/io_signature.h>
 #include <glog/logging.h>
 #include "control_message_factory.h"
+#include "gnss_nav_data_store.h"
+#include "gnss_sdr_latency_tracer.h"
 #include "gnss_synchro.h"
+#include "gnss_sdr_trace.h"
 
 #ifndef _rotl
 #define _rotl(X,N)  ((X << N) ^ (X >> (32-N)))  // Used in the parity check algorithm
@@ -74,23 +78,7 @@ gps_l1_ca_telemetry_decoder_cc::gps_l1_ca_telemetry_decoder_cc(
     //memcpy((unsigned short int*)this->d_preambles_bits, (unsigned short int*)preambles_bits, GPS_CA_PREAMBLE_LENGTH_BITS*sizeof(unsigned short int));
 
     // preamble bits to sampled symbols
-    d_preambles_symbols = (signed int*)malloc(sizeof(signed int) * GPS_CA_PREAMBLE_LENGTH_SYMBOLS);
-    int n = 0;
-    for (int i = 0; i < GPS_CA_PREAMBLE_LENGTH_BITS; i++)
-        {
-            for (unsigned int j = 0; j < GPS_CA_TELEMETRY_SYMBOLS_PER_BIT; j++)
-                {
-                    if (preambles_bits[i] == 1)
-                        {
-                            d_preambles_symbols[n] = 1;
-                        }
-                    else
-                        {
-                            d_preambles_symbols[n] = -1;
-                        }
-                    n++;
-                }
-        }
+    d_preamble_correlator = new Preamble_Correlator(preambles_bits, GPS_CA_PREAMBLE_LENGTH_BITS, GPS_CA_TELEMETRY_SYMBOLS_PER_BIT);
     d_stat = 0;
     d_symbol_accumulator = 0;
     d_symbol_accumulator_counter = 0;
@@ -103,10 +91,8 @@ gps_l1_ca_telemetry_decoder_cc::gps_l1_ca_telemetry_decoder_cc(
     d_TOW_at_Preamble = 0;
     d_TOW_at_current_symbol = 0;
     flag_TOW_set = false;
-    d_average_count = 0;
     d_flag_preamble = false;
     d_word_number = 0;
-    d_decimation_output_factor = 1;
     d_channel = 0;
     Prn_timestamp_at_preamble_ms = 0.0;
     flag_PLL_180_deg_phase_locked = false;
@@ -115,7 +101,7 @@ gps_l1_ca_telemetry_decoder_cc::gps_l1_ca_telemetry_decoder_cc(
 
 gps_l1_ca_telemetry_decoder_cc::~gps_l1_ca_telemetry_decoder_cc()
 {
-    delete d_preambles_symbols;
+    delete d_preamble_correlator;
     d_dump_file.close();
 }
 
@@ -145,6 +131,7 @@ bool gps_l1_ca_telemetry_decoder_cc::gps_word_parityCheck(unsigned int gpsword)
 int gps_l1_ca_telemetry_decoder_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
         gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE("gps_l1_ca_telemetry_decoder_cc::general_work");
     int corr_value = 0;
     int preamble_diff_ms = 0;
 
@@ -154,21 +141,24 @@ int gps_l1_ca_telemetry_decoder_cc::general_work (int noutput_items __attribute_
     const Gnss_Synchro **in = (const Gnss_Synchro **)  &input_items[0]; //Get the input samples pointer
 
     //******* preamble correlation ********
-    for (unsigned int i = 0; i < GPS_CA_PREAMBLE_LENGTH_SYMBOLS; i++)
+    // The input window holds the last GPS_CA_PREAMBLE_LENGTH_SYMBOLS symbols and
+    // the block consumes one per call, so only the symbols the correlator has not
+    // seen yet are pushed (all of them on the first call)
+    unsigned long int first_symbol = nitems_read(0);
+    unsigned long int next_symbol = std::max(d_preamble_correlator->symbols_pushed(), first_symbol);
+    for (unsigned long int k = next_symbol; k < first_symbol + GPS_CA_PREAMBLE_LENGTH_SYMBOLS; k++)
         {
-            if (in[0][i].Flag_valid_symbol_output == true)
+            const Gnss_Synchro &symbol = in[0][k - first_symbol];
+            if (symbol.Flag_valid_symbol_output == true)
                 {
-                    if (in[0][i].Prompt_I < 0)  // symbols clipping
-                        {
-                            corr_value -= d_preambles_symbols[i] * in[0][i].correlation_length_ms;
-                        }
-                    else
-                        {
-                            corr_value += d_preambles_symbols[i] * in[0][i].correlation_length_ms;
-                        }
+                    d_preamble_correlator->push_symbol(symbol.Prompt_I, symbol.correlation_length_ms);
+                }
+            else
+                {
+                    d_preamble_correlator->push_erasure();
                 }
-            if (corr_value >= GPS_CA_PREAMBLE_LENGTH_SYMBOLS) break;
         }
+    corr_value = d_preamble_correlator->correlation();
     d_flag_preamble = false;
 
     //******* frame sync ******************
@@ -275,29 +265,32 @@ int gps_l1_ca_telemetry_decoder_cc::general_work (int noutput_items __attribute_
                              memcpy(&d_GPS_FSM.d_GPS_frame_4bytes, &d_GPS_frame_4bytes, sizeof(char)*4);
                              d_GPS_FSM.d_preamble_time_ms = d_preamble_time_seconds * 1000.0;
                              d_GPS_FSM.Event_gps_word_valid();
-                             // send TLM data to PVT using asynchronous message queues
+                             // publish the new navigation data to the PVT and the printers
                              if (d_GPS_FSM.d_flag_new_subframe == true)
                                  {
                                      switch (d_GPS_FSM.d_subframe_ID)
                                      {
                                      case 3: //we have a new set of ephemeris data for the current SV
-                                         if (d_GPS_FSM.d_nav.satellite_validation() == true)
+                                         // unless subframes 1 to 3 repeated the published one
+                                         if (d_GPS_FSM.d_flag_new_ephemeris == true and d_GPS_FSM.d_nav.satellite_validation() == true)
                                              {
                                                  // get ephemeris object for this SV (mandatory)
-                                                 std::shared_ptr<Gps_Ephemeris> tmp_obj = std::make_shared<Gps_Ephemeris>(d_GPS_FSM.d_nav.get_ephemeris());
-                                                 this->message_port_pub(pmt::mp("telemetry"), pmt::make_any(tmp_obj));
+                                                 Gnss_Nav_Data_Store::instance().update(d_GPS_FSM.d_nav.get_ephemeris());
+                                                 d_GPS_FSM.d_flag_new_ephemeris = false;
                                              }
                                          break;
                                      case 4: // Possible IONOSPHERE and UTC model update (page 18)
+                                         if (d_GPS_FSM.d_nav.b_subframe_repeated == true)
+                                             {
+                                                 break;
+                                             }
                                          if (d_GPS_FSM.d_nav.flag_iono_valid == true)
                                              {
-                                                 std::shared_ptr<Gps_Iono> tmp_obj = std::make_shared<Gps_Iono>( d_GPS_FSM.d_nav.get_iono());
-                                                 this->message_port_pub(pmt::mp("telemetry"), pmt::make_any(tmp_obj));
+                                                 Gnss_Nav_Data_Store::instance().update(d_GPS_FSM.d_nav.get_iono());
                                              }
                                          if (d_GPS_FSM.d_nav.flag_utc_model_valid == true)
                                              {
-                                                 std::shared_ptr<Gps_Utc_Model> tmp_obj = std::make_shared<Gps_Utc_Model>(d_GPS_FSM.d_nav.get_utc_model());
-                                                 this->message_port_pub(pmt::mp("telemetry"), pmt::make_any(tmp_obj));
+                                                 Gnss_Nav_Data_Store::instance().update(d_GPS_FSM.d_nav.get_utc_model());
                                              }
                                          break;
                                      case 5:
@@ -357,7 +350,6 @@ int gps_l1_ca_telemetry_decoder_cc::general_work (int noutput_items __attribute_
      current_synchro_data.Flag_valid_word = (d_flag_frame_sync == true and d_flag_parity == true and flag_TOW_set == true);
      current_synchro_data.Flag_preamble = d_flag_preamble;
      current_synchro_data.Prn_timestamp_ms = in[0][0].Tracking_timestamp_secs * 1000.0;
-     current_synchro_data.Prn_timestamp_at_preamble_ms = Prn_timestamp_at_preamble_ms;
 
      if (flag_PLL_180_deg_phase_locked == true)
          {
@@ -384,14 +376,11 @@ int gps_l1_ca_telemetry_decoder_cc::general_work (int noutput_items __attribute_
              }
          }
 
-     //todo: implement averaging
-
-     d_average_count++;
-     if (d_average_count == d_decimation_output_factor)
+     if (d_output_decimator.output(current_synchro_data.Prn_timestamp_ms, d_flag_frame_sync, d_flag_preamble))
          {
-             d_average_count = 0;
              //3. Make the output (copy the object contents to the GNURadio reserved memory)
              *out[0] = current_synchro_data;
+             Gnss_Sdr_Latency_Tracer::record("telemetry", current_synchro_data.Tracking_timestamp_secs);
              //std::cout<<"GPS L1 TLM output on CH="<<this->d_channel << " SAMPLE STAMP="<<d_sample_counter/d_decimation_output_factor<<std::endl;
              return 1;
          }
@@ -404,13 +393,25 @@ int gps_l1_ca_telemetry_decoder_cc::general_work (int noutput_items __attribute_
 
  void gps_l1_ca_telemetry_decoder_cc::set_decimation(int decimation)
  {
-     d_decimation_output_factor = decimation;
+     d_output_decimator.set_decimation(decimation);
+ }
+
+
+ void gps_l1_ca_telemetry_decoder_cc::set_output_mode(Telemetry_Output_Decimator::output_mode mode, double period_ms)
+ {
+     d_output_decimator.set_mode(mode, period_ms);
  }
 
  void gps_l1_ca_telemetry_decoder_cc::set_satellite(Gnss_Satellite satellite)
  {
      d_satellite = Gnss_Satellite(satellite.get_system(), satellite.get_PRN());
      LOG(INFO) << "Setting decoder Finite State Machine to satellite "  << d_satellite;
+     if (d_GPS_FSM.i_satellite_PRN != d_satellite.get_PRN())
+         {
+             // the subframes of the previous satellite are not repeated by this one
+             d_GPS_FSM.d_nav.reset();
+             d_GPS_FSM.d_flag_new_ephemeris = false;
+         }
      d_GPS_FSM.i_satellite_PRN = d_satellite.get_PRN();
      DLOG(INFO) << "Navigation Satellite set to " << d_satellite;
  }
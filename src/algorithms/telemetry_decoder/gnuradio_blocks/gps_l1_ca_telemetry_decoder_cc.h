@@ -34,11 +34,12 @@
 #include <fstream>
 #include <string>
 #include <gnuradio/block.h>
-#include <deque>
 #include "GPS_L1_CA.h"
 #include "gps_l1_ca_subframe_fsm.h"
+#include "preamble_correlator.h"
 #include "concurrent_queue.h"
 #include "gnss_satellite.h"
+#include "telemetry_output_decimator.h"
 
 
 
@@ -63,6 +64,11 @@ public:
      * \brief Set decimation factor to average the GPS synchronization estimation output from the tracking module.
      */
     void set_decimation(int decimation);
+    /*!
+     * \brief Sends only some epochs to the observables, see Telemetry_Output_Decimator.
+     * \param period_ms - length of the output cells in the sparse modes [ms].
+     */
+    void set_output_mode(Telemetry_Output_Decimator::output_mode mode, double period_ms);
 
     /*!
      * \brief This is where all signal processing takes place
@@ -88,13 +94,11 @@ private:
     //unsigned short int d_preambles_bits[GPS_CA_PREAMBLE_LENGTH_BITS];
     // class private vars
 
-    int *d_preambles_symbols;
+    Preamble_Correlator *d_preamble_correlator;
     unsigned int d_stat;
     bool d_flag_frame_sync;
 
     // symbols
-    std::deque<double> d_symbol_history;
-    std::deque<int> d_correlation_length_ms_history;
     double d_symbol_accumulator;
     short int d_symbol_accumulator_counter;
 
@@ -106,9 +110,8 @@ private:
     bool d_flag_preamble;
     int d_word_number;
 
-    // output averaging and decimation
-    int d_average_count;
-    int d_decimation_output_factor;
+    // output decimation
+    Telemetry_Output_Decimator d_output_decimator;
 
     //double d_preamble_duration_seconds;
     // navigation message vars
@@ -32,18 +32,19 @@
 #define GNSS_SDR_GPS_L2_M_TELEMETRY_DECODER_CC_H
 
 #include <algorithm> // for copy
-#include <deque>
 #include <fstream>
 #include <string>
 #include <utility> // for pair
 #include <vector>
-#include <boost/crc.hpp>
 #include <gnuradio/block.h>
 #include "gnss_satellite.h"
-#include "viterbi_decoder.h"
+#include "telemetry_output_decimator.h"
+#include "viterbi_symbol_aligner.h"
+#include "crc24q_frame_detector.h"
 #include "gps_cnav_navigation_message.h"
 #include "gps_cnav_ephemeris.h"
 #include "gps_cnav_iono.h"
+#include "gnss_telemetry_payload.h"
 #include "concurrent_queue.h"
 #include "GPS_L2C.h"
 
@@ -65,6 +66,11 @@ public:
     void set_satellite(Gnss_Satellite satellite);  //!< Set satellite PRN
     void set_channel(int channel);                 //!< Set receiver's channel
     void set_decimation(int decimation);
+    /*!
+     * \brief Sends only some epochs to the observables, see Telemetry_Output_Decimator.
+     * \param period_ms - length of the output cells in the sparse modes [ms].
+     */
+    void set_output_mode(Telemetry_Output_Decimator::output_mode mode, double period_ms);
 
     /*!
      * \brief This is where all signal processing takes place
@@ -99,55 +105,24 @@ private:
 
     bool d_flag_invert_input_symbols;
     bool d_flag_invert_buffer_symbols;
-    int d_decimation_output_factor;
-    int d_average_count;
+    Telemetry_Output_Decimator d_output_decimator;
     size_t d_block_size; //!< number of samples which are processed during one invocation of the algorithms
     std::vector<double> d_sample_buf; //!< input buffer holding the samples to be processed in one block
 
-    typedef std::pair<int,std::vector<int>> msg_candiate_int_t;
-    typedef std::pair<int,std::vector<unsigned char>> msg_candiate_char_t;
-
-    // helper class for symbol alignment and Viterbi decoding
-    class symbol_aligner_and_decoder
-    {
-    public:
-        symbol_aligner_and_decoder();
-        ~symbol_aligner_and_decoder();
-        void reset();
-        bool get_bits(const std::vector<double> & symbols, std::vector<int> & bits);
-    private:
-        int d_KK;
-        Viterbi_Decoder * d_vd1;
-        Viterbi_Decoder * d_vd2;
-        double d_past_symbol;
-    } d_symbol_aligner_and_decoder;
-
-
-    // helper class for detecting the preamble and collect the corresponding message candidates
-    class frame_detector
-    {
-    public:
-        void reset();
-        void get_frame_candidates(const std::vector<int> & bits, std::vector<std::pair<int, std::vector<int>>> & msg_candidates);
-    private:
-        std::deque<int> d_buffer;
-    } d_frame_detector;
-
-
-    // helper class for checking the CRC of the message candidates
-    class crc_verifier
-    {
-    public:
-        void reset();
-        void get_valid_frames(const std::vector<msg_candiate_int_t> & msg_candidates, std::vector<msg_candiate_int_t> & valid_msgs);
-    private:
-        typedef boost::crc_optimal<24, 0x1864CFBu, 0x0, 0x0, false, false> crc_24_q_type;
-        crc_24_q_type d_checksum_agent;
-        void zerropad_front_and_convert_to_bytes(const std::vector<int> & msg_candidate, std::vector<unsigned char> & bytes);
-        void zerropad_back_and_convert_to_bytes(const std::vector<int> & msg_candidate, std::vector<unsigned char> & bytes);
-    } d_crc_verifier;
+    // work buffers of one block, allocated once
+    std::vector<int> d_bits;
+    std::vector<Crc24q_Frame_Detector::frame_t> d_valid_msgs;
+
+    // symbol alignment and Viterbi decoding
+    Viterbi_Symbol_Aligner d_symbol_aligner_and_decoder;
+
+    // preamble detection and CRC check of the message candidates
+    Crc24q_Frame_Detector d_frame_detector;
 
     Gps_CNAV_Navigation_Message d_CNAV_Message;
+    // payloads of the telemetry messages, reused once the PVT is done with them
+    Gnss_Telemetry_Pool<Gps_CNAV_Ephemeris> d_ephemeris_pool;
+    Gnss_Telemetry_Pool<Gps_CNAV_Iono> d_iono_pool;
 };
 
 
@@ -34,8 +34,10 @@
 #include <glog/logging.h>
 #include <boost/lexical_cast.hpp>
 #include "control_message_factory.h"
+#include "gnss_sdr_event_log.h"
 #include "gnss_synchro.h"
 #include "sbas_l1_telemetry_decoder_cc.h"
+#include "gnss_sdr_trace.h"
 
 using google::LogMessage;
 
@@ -45,6 +47,19 @@ using google::LogMessage;
 #define SAMP_SYNC 4 // about 1 log entry per sample -> high output
 #define LMORE 5     //
 
+namespace
+{
+// convolutional code of the SBAS L1 messages
+const int sbas_l1_KK = 7;
+const int sbas_l1_nn = 2;
+const int sbas_l1_g_encoder[2] = { 121, 91 };
+
+// preambles of the three consecutive messages
+const int sbas_l1_msg_length = 250;
+const int sbas_l1_preambles[3 * 8] = { 0, 1, 0, 1, 0, 0, 1, 1,
+                                       1, 0, 0, 1, 1, 0, 1, 0,
+                                       1, 1, 0, 0, 0, 1, 1, 0 };
+}
 
 
 sbas_l1_telemetry_decoder_cc_sptr
@@ -60,7 +75,9 @@ sbas_l1_telemetry_decoder_cc::sbas_l1_telemetry_decoder_cc(
         bool dump) :
                 gr::block("sbas_l1_telemetry_decoder_cc",
                 gr::io_signature::make(1, 1, sizeof(Gnss_Synchro)),
-                gr::io_signature::make(1, 1, sizeof(Gnss_Synchro)))
+                gr::io_signature::make(1, 1, sizeof(Gnss_Synchro))),
+                d_symbol_aligner_and_decoder(sbas_l1_g_encoder, sbas_l1_KK, sbas_l1_nn, 2 * d_symbols_per_bit * d_block_size_in_bits),
+                d_frame_detector(sbas_l1_msg_length, sbas_l1_preambles, 3, 8)
 {
     // Telemetry Bit transition synchronization port out
     this->message_port_register_out(pmt::mp("preamble_timestamp_s"));
@@ -71,6 +88,10 @@ sbas_l1_telemetry_decoder_cc::sbas_l1_telemetry_decoder_cc(
     d_satellite = Gnss_Satellite(satellite.get_system(), satellite.get_PRN());
     LOG(INFO) << "SBAS L1 TELEMETRY PROCESSING: satellite " << d_satellite;
     d_block_size = d_samples_per_symbol * d_symbols_per_bit * d_block_size_in_bits;
+    // clear() keeps the capacity, so the buffers only grow if a call brings more samples than ever before
+    d_sample_buf.reserve(2 * d_block_size);
+    d_symbols.reserve(d_block_size);
+    d_bits.reserve(d_block_size);
     d_channel = 0;
     set_output_multiple (1);
 }
@@ -97,6 +118,7 @@ void sbas_l1_telemetry_decoder_cc::forecast (int noutput_items, gr_vector_int &n
 int sbas_l1_telemetry_decoder_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
         gr_vector_const_void_star &input_items,    gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE("sbas_l1_telemetry_decoder_cc::general_work");
     VLOG(FLOW) << "general_work(): " << "noutput_items=" << noutput_items << "\toutput_items real size=" << output_items.size() <<  "\tninput_items size=" << ninput_items.size() << "\tinput_items real size=" << input_items.size() << "\tninput_items[0]=" << ninput_items[0];
     // get pointers on in- and output gnss-synchro objects
     const Gnss_Synchro *in = (const Gnss_Synchro *)  input_items[0]; // input
@@ -120,29 +142,23 @@ int sbas_l1_telemetry_decoder_cc::general_work (int noutput_items __attribute__(
         {
             // align correlation samples in pairs
             // and obtain the symbols by summing the paired correlation samples
-            std::vector<double> symbols;
-            bool sample_alignment = d_sample_aligner.get_symbols(d_sample_buf, symbols);
+            d_symbols.clear();
+            bool sample_alignment = d_sample_aligner.get_symbols(d_sample_buf, d_symbols);
 
             // align symbols in pairs
             // and obtain the bits by decoding the symbol pairs
-            std::vector<int> bits;
-            bool symbol_alignment = d_symbol_aligner_and_decoder.get_bits(symbols, bits);
-
-            // search for preambles
-            // and extract the corresponding message candidates
-            std::vector<msg_candiate_int_t> msg_candidates;
-            d_frame_detector.get_frame_candidates(bits, msg_candidates);
+            d_bits.clear();
+            bool symbol_alignment = d_symbol_aligner_and_decoder.get_bits(d_symbols.data(), d_symbols.size(), d_bits);
 
-            // verify checksum
+            // search for preambles, verify the checksum of the message candidates
             // and return the valid messages
-            std::vector<msg_candiate_char_t> valid_msgs;
-            d_crc_verifier.get_valid_frames(msg_candidates, valid_msgs);
-
-            // compute message sample stamp
-            // and fill messages in SBAS raw message objects
-            std::vector<Sbas_Raw_Msg> sbas_raw_msgs;
-            for(std::vector<msg_candiate_char_t>::const_iterator it = valid_msgs.begin();
-                    it != valid_msgs.end(); ++it)
+            d_valid_msgs.clear();
+            d_frame_detector.push_bits(d_bits.data(), d_bits.size(), d_valid_msgs);
+
+            // compute message sample stamp, fill messages in SBAS raw message objects,
+            // parse them and send them to the SBAS raw message queue
+            for(std::vector<Crc24q_Frame_Detector::frame_t>::const_iterator it = d_valid_msgs.begin();
+                    it != d_valid_msgs.end(); ++it)
                 {
                     int message_sample_offset =
                             (sample_alignment ? 0 : -1)
@@ -156,16 +172,12 @@ int sbas_l1_telemetry_decoder_cc::general_work (int noutput_items __attribute__(
                             << " relative_preamble_start=" << it->first
                             << " message_sample_offset=" << message_sample_offset
                             << ")";
-                    Sbas_Raw_Msg sbas_raw_msg(message_sample_stamp, this->d_satellite.get_PRN(), it->second);
-                    sbas_raw_msgs.push_back(sbas_raw_msg);
-                }
-
-            // parse messages
-            // and send them to the SBAS raw message queue
-            for(std::vector<Sbas_Raw_Msg>::iterator it = sbas_raw_msgs.begin(); it != sbas_raw_msgs.end(); it++)
-                {
-                    std::cout << "SBAS message type " << it->get_msg_type() << " from PRN" << it->get_prn() << " received" << std::endl;
-                    sbas_telemetry_data.update(*it);
+                    // 250 bits, zero padded at the back to 32 bytes
+                    std::vector<unsigned char> msg_bytes((it->second.size() + 7) / 8);
+                    Crc24q_Frame_Detector::pack_bits(it->second.data(), it->second.size(), msg_bytes.data());
+                    Sbas_Raw_Msg sbas_raw_msg(message_sample_stamp, this->d_satellite.get_PRN(), msg_bytes);
+                    Gnss_Sdr_Event_Log::satellite_event(EVENT_SBAS_MESSAGE, d_channel, 'S', sbas_raw_msg.get_prn(), sbas_raw_msg.get_msg_type());
+                    sbas_telemetry_data.update(sbas_raw_msg);
                 }
 
             // clear all processed samples in the input buffer
@@ -231,7 +243,7 @@ void sbas_l1_telemetry_decoder_cc::sample_aligner::reset()
 /*
  * samples length must be a multiple of two
  */
-bool sbas_l1_telemetry_decoder_cc::sample_aligner::get_symbols(const std::vector<double> samples, std::vector<double> &symbols)
+bool sbas_l1_telemetry_decoder_cc::sample_aligner::get_symbols(const std::vector<double> & samples, std::vector<double> &symbols)
 {
     double smpls[3] = { };
     double corr_diff;
@@ -283,240 +295,3 @@ bool sbas_l1_telemetry_decoder_cc::sample_aligner::get_symbols(const std::vector
     d_past_sample = (temp);
     return d_aligned;
 }
-
-
-// ### helper class for symbol alignment and viterbi decoding ###
-sbas_l1_telemetry_decoder_cc::symbol_aligner_and_decoder::symbol_aligner_and_decoder()
-{
-    // convolutional code properties
-    d_KK = 7;
-    int nn = 2;
-    int g_encoder[nn];
-    g_encoder[0] = 121;
-    g_encoder[1] = 91;
-
-    d_vd1 = new Viterbi_Decoder(g_encoder, d_KK, nn);
-    d_vd2 = new Viterbi_Decoder(g_encoder, d_KK, nn);
-    d_past_symbol = 0;
-}
-
-
-sbas_l1_telemetry_decoder_cc::symbol_aligner_and_decoder::~symbol_aligner_and_decoder()
-{
-    delete d_vd1;
-    delete d_vd2;
-}
-
-
-void sbas_l1_telemetry_decoder_cc::symbol_aligner_and_decoder::reset()
-{
-    d_past_symbol = 0;
-    d_vd1->reset();
-    d_vd2->reset();
-}
-
-
-bool sbas_l1_telemetry_decoder_cc::symbol_aligner_and_decoder::get_bits(const std::vector<double> symbols, std::vector<int> &bits)
-{
-    const int traceback_depth = 5*d_KK;
-    int nbits_requested = symbols.size()/d_symbols_per_bit;
-    int nbits_decoded;
-    // fill two vectors with the two possible symbol alignments
-    std::vector<double> symbols_vd1(symbols); // aligned symbol vector -> copy input symbol vector
-    std::vector<double> symbols_vd2;  // shifted symbol vector -> add past sample in front of input vector
-    symbols_vd2.push_back(d_past_symbol);
-    for (std::vector<double>::const_iterator symbol_it = symbols.begin(); symbol_it != symbols.end() - 1; ++symbol_it)
-        {
-            symbols_vd2.push_back(*symbol_it);
-        }
-    // arrays for decoded bits
-    int * bits_vd1 = new int[nbits_requested];
-    int * bits_vd2 = new int[nbits_requested];
-    // decode
-    float metric_vd1 = d_vd1->decode_continuous(symbols_vd1.data(), traceback_depth, bits_vd1, nbits_requested, nbits_decoded);
-    float metric_vd2 = d_vd2->decode_continuous(symbols_vd2.data(), traceback_depth, bits_vd2, nbits_requested, nbits_decoded);
-    // choose the bits with the better metric
-    for (int i = 0; i < nbits_decoded; i++)
-        {
-            if (metric_vd1 > metric_vd2)
-                {// symbols aligned
-                    bits.push_back(bits_vd1[i]);
-                }
-            else
-                {// symbols shifted
-                    bits.push_back(bits_vd2[i]);
-                }
-        }
-    d_past_symbol = symbols.back();
-    delete[] bits_vd1;
-    delete[] bits_vd2;
-    return metric_vd1 > metric_vd2;
-}
-
-
-// ### helper class for detecting the preamble and collect the corresponding message candidates ###
-void sbas_l1_telemetry_decoder_cc::frame_detector::reset()
-{
-    d_buffer.clear();
-}
-
-
-void sbas_l1_telemetry_decoder_cc::frame_detector::get_frame_candidates(const std::vector<int> bits, std::vector<std::pair<int,std::vector<int>>> &msg_candidates)
-{
-    std::stringstream ss;
-    unsigned int sbas_msg_length = 250;
-    std::vector<std::vector<int>> preambles = {{0, 1, 0, 1, 0, 0, 1 ,1},
-                                               {1, 0, 0, 1, 1, 0, 1, 0},
-                                               {1, 1, 0, 0, 0, 1, 1, 0}};
-    VLOG(FLOW) << "get_frame_candidates(): " << "d_buffer.size()=" << d_buffer.size() << "\tbits.size()=" << bits.size();
-    ss << "copy bits ";
-    int count = 0;
-    // copy new bits into the working buffer
-    for (std::vector<int>::const_iterator bit_it = bits.begin(); bit_it < bits.end(); ++bit_it)
-        {
-            d_buffer.push_back(*bit_it);
-            ss << *bit_it;
-            count++;
-        }
-    VLOG(SAMP_SYNC) << ss.str() << " into working buffer (" << count << " bits)";
-    int relative_preamble_start = 0;
-    while(d_buffer.size() >= sbas_msg_length)
-        {
-            // compare with all preambles
-            for (std::vector<std::vector<int>>::iterator preample_it = preambles.begin(); preample_it < preambles.end(); ++preample_it)
-                {
-                    bool preamble_detected = true;
-                    bool inv_preamble_detected = true;
-                    // compare the buffer bits with the preamble bits
-                    for (std::vector<int>::iterator preample_bit_it = preample_it->begin(); preample_bit_it < preample_it->end(); ++preample_bit_it)
-                        {
-                            preamble_detected = *preample_bit_it == d_buffer[preample_bit_it - preample_it->begin()] ? preamble_detected : false ;
-                            inv_preamble_detected = *preample_bit_it != d_buffer[preample_bit_it - preample_it->begin()] ? inv_preamble_detected : false ;
-                        }
-                    if (preamble_detected || inv_preamble_detected)
-                        {
-                            // copy candidate
-                            std::vector<int> candidate;
-                            std::copy(d_buffer.begin(), d_buffer.begin() + sbas_msg_length, std::back_inserter(candidate));
-                            if(inv_preamble_detected)
-                                {
-                                    // invert bits
-                                    for (std::vector<int>::iterator candidate_bit_it = candidate.begin(); candidate_bit_it != candidate.end(); candidate_bit_it++)
-                                        *candidate_bit_it = *candidate_bit_it == 0 ? 1 : 0;
-                                }
-                            msg_candidates.push_back(std::pair<int,std::vector<int>>(relative_preamble_start, candidate));
-                            ss.str("");
-                            ss << "preamble " << preample_it - preambles.begin() << (inv_preamble_detected?" inverted":" normal") << " detected! candidate=";
-                            for (std::vector<int>::iterator bit_it = candidate.begin(); bit_it < candidate.end(); ++bit_it)
-                                ss << *bit_it;
-                            VLOG(EVENT) << ss.str();
-                        }
-                }
-            relative_preamble_start++;
-            // remove bit in front
-            d_buffer.pop_front();
-        }
-}
-
-
-// ### helper class for checking the CRC of the message candidates ###
-
-
-void sbas_l1_telemetry_decoder_cc::crc_verifier::reset()
-{
-
-}
-
-void sbas_l1_telemetry_decoder_cc::crc_verifier::get_valid_frames(const std::vector<msg_candiate_int_t> msg_candidates, std::vector<msg_candiate_char_t> &valid_msgs)
-{
-    std::stringstream ss;
-    VLOG(FLOW) << "get_valid_frames(): " << "msg_candidates.size()=" << msg_candidates.size();
-    // for each candidate
-    for (std::vector<msg_candiate_int_t>::const_iterator candidate_it = msg_candidates.begin(); candidate_it < msg_candidates.end(); ++candidate_it)
-        {
-            // convert to bytes
-            std::vector<unsigned char> candidate_bytes;
-            zerropad_back_and_convert_to_bytes(candidate_it->second, candidate_bytes);
-            // verify CRC
-            d_checksum_agent.reset(0);
-            d_checksum_agent.process_bytes(candidate_bytes.data(), candidate_bytes.size());
-            unsigned int crc = d_checksum_agent.checksum();
-            VLOG(SAMP_SYNC) << "candidate " << candidate_it - msg_candidates.begin()
-                            << ": final crc remainder= " << std::hex << crc
-                            << std::setfill(' ') << std::resetiosflags(std::ios::hex);
-            //  the final remainder must be zero for a valid message, because the CRC is done over the received CRC value
-            if (crc == 0)
-                {
-                    valid_msgs.push_back(msg_candiate_char_t(candidate_it->first, candidate_bytes));
-                    ss << "Valid message found!";
-                }
-            else
-                {
-                    ss << "Not a valid message.";
-                }
-            ss << " Relbitoffset=" << candidate_it->first << " content=";
-            for (std::vector<unsigned char>::iterator byte_it = candidate_bytes.begin(); byte_it < candidate_bytes.end(); ++byte_it)
-                {
-                    ss << std::setw(2) << std::setfill('0') << std::hex << (unsigned int)(*byte_it);
-                }
-            VLOG(SAMP_SYNC) << ss.str() << std::setfill(' ') << std::resetiosflags(std::ios::hex) << std::endl;
-        }
-}
-
-
-
-
-
-void sbas_l1_telemetry_decoder_cc::crc_verifier::zerropad_back_and_convert_to_bytes(const std::vector<int> msg_candidate, std::vector<unsigned char> &bytes)
-{
-    std::stringstream ss;
-    const size_t bits_per_byte = 8;
-    unsigned char byte = 0;
-    VLOG(LMORE) << "zerropad_back_and_convert_to_bytes():" << byte;
-    for (std::vector<int>::const_iterator candidate_bit_it = msg_candidate.begin(); candidate_bit_it < msg_candidate.end(); ++candidate_bit_it)
-        {
-            int idx_bit = candidate_bit_it - msg_candidate.begin();
-            int bit_pos_in_current_byte = (bits_per_byte - 1) - (idx_bit % bits_per_byte);
-            byte |= (unsigned char)(*candidate_bit_it) << bit_pos_in_current_byte;
-            ss << *candidate_bit_it;
-            if (idx_bit % bits_per_byte == bits_per_byte - 1)
-                {
-                    bytes.push_back(byte);
-                    VLOG(LMORE) << ss.str() << " -> byte=" << std::setw(2) << std::setfill('0') << std::hex << (unsigned int)byte; ss.str("");
-                    byte = 0;
-                }
-        }
-    bytes.push_back(byte); // implies: insert 6 zeros at the end to fit the 250bits into a multiple of bytes
-    VLOG(LMORE) << " -> byte=" << std::setw(2)
-                << std::setfill('0') << std::hex << (unsigned int)byte
-                << std::setfill(' ') << std::resetiosflags(std::ios::hex);
-}
-
-
-
-void sbas_l1_telemetry_decoder_cc::crc_verifier::zerropad_front_and_convert_to_bytes(const std::vector<int> msg_candidate, std::vector<unsigned char> &bytes)
-{
-    std::stringstream ss;
-    const size_t bits_per_byte = 8;
-    unsigned char byte = 0;
-    int idx_bit = 6; // insert 6 zeros at the front to fit the 250bits into a multiple of bytes
-    VLOG(LMORE) << "zerropad_front_and_convert_to_bytes():" << byte;
-    for (std::vector<int>::const_iterator candidate_bit_it = msg_candidate.begin(); candidate_bit_it < msg_candidate.end(); ++candidate_bit_it)
-        {
-            int bit_pos_in_current_byte = (bits_per_byte - 1) - (idx_bit % bits_per_byte);
-            byte |= (unsigned char)(*candidate_bit_it) << bit_pos_in_current_byte;
-            ss << *candidate_bit_it;
-            if (idx_bit % bits_per_byte == bits_per_byte - 1)
-                {
-                    bytes.push_back(byte);
-                    VLOG(LMORE) << ss.str() << " -> byte=" << std::setw(2)
-                                << std::setfill('0') << std::hex << (unsigned int)byte; ss.str("");
-                    byte = 0;
-                }
-            idx_bit++;
-        }
-    VLOG(LMORE) << " -> byte=" << std::setw(2)
-                << std::setfill('0') << std::hex << (unsigned int)byte
-                << std::setfill(' ') << std::resetiosflags(std::ios::hex);
-}
-
@@ -32,15 +32,14 @@
 #define GNSS_SDR_SBAS_L1_TELEMETRY_DECODER_CC_H
 
 #include <algorithm> // for copy
-#include <deque>
 #include <fstream>
 #include <string>
 #include <utility> // for pair
 #include <vector>
-#include <boost/crc.hpp>
 #include <gnuradio/block.h>
 #include "gnss_satellite.h"
-#include "viterbi_decoder.h"
+#include "viterbi_symbol_aligner.h"
+#include "crc24q_frame_detector.h"
 #include "sbas_telemetry_data.h"
 
 class sbas_l1_telemetry_decoder_cc;
@@ -95,8 +94,10 @@ private:
     size_t d_block_size; //!< number of samples which are processed during one invocation of the algorithms
     std::vector<double> d_sample_buf; //!< input buffer holding the samples to be processed in one block
 
-    typedef std::pair<int,std::vector<int>> msg_candiate_int_t;
-    typedef std::pair<int,std::vector<unsigned char>> msg_candiate_char_t;
+    // work buffers of one block, allocated once
+    std::vector<double> d_symbols;
+    std::vector<int> d_bits;
+    std::vector<Crc24q_Frame_Detector::frame_t> d_valid_msgs;
 
     // helper class for sample alignment
     class sample_aligner
@@ -109,7 +110,7 @@ private:
          * samples length must be a multiple of two
          * for block operation
          */
-       bool get_symbols(const std::vector<double> samples, std::vector<double> &symbols);
+       bool get_symbols(const std::vector<double> & samples, std::vector<double> &symbols);
     private:
         int d_n_smpls_in_history ;
         double d_iir_par;
@@ -119,46 +120,11 @@ private:
         double d_past_sample;
     } d_sample_aligner;
 
-    // helper class for symbol alignment and Viterbi decoding
-    class symbol_aligner_and_decoder
-    {
-    public:
-        symbol_aligner_and_decoder();
-        ~symbol_aligner_and_decoder();
-        void reset();
-        bool get_bits(const std::vector<double> symbols, std::vector<int> &bits);
-    private:
-        int d_KK;
-        Viterbi_Decoder * d_vd1;
-        Viterbi_Decoder * d_vd2;
-        double d_past_symbol;
-    } d_symbol_aligner_and_decoder;
-
-
-    // helper class for detecting the preamble and collect the corresponding message candidates
-    class frame_detector
-    {
-    public:
-        void reset();
-        void get_frame_candidates(const std::vector<int> bits, std::vector<std::pair<int, std::vector<int>>> &msg_candidates);
-    private:
-        std::deque<int> d_buffer;
-    } d_frame_detector;
-
-
-    // helper class for checking the CRC of the message candidates
-    class crc_verifier
-    {
-    public:
-        void reset();
-        void get_valid_frames(const std::vector<msg_candiate_int_t> msg_candidates, std::vector<msg_candiate_char_t> &valid_msgs);
-    private:
-        typedef boost::crc_optimal<24, 0x1864CFBu, 0x0, 0x0, false, false> crc_24_q_type;
-        crc_24_q_type d_checksum_agent;
-        void zerropad_front_and_convert_to_bytes(const std::vector<int> msg_candidate, std::vector<unsigned char> &bytes);
-        void zerropad_back_and_convert_to_bytes(const std::vector<int> msg_candidate, std::vector<unsigned char> &bytes);
-    } d_crc_verifier;
+    // symbol alignment and Viterbi decoding
+    Viterbi_Symbol_Aligner d_symbol_aligner_and_decoder;
 
+    // preamble detection and CRC check of the message candidates
+    Crc24q_Frame_Detector d_frame_detector;
 
     Sbas_Telemetry_Data sbas_telemetry_data;
 };
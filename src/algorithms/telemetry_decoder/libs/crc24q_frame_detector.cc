@@ -0,0 +1,113 @@
+/*!
+ * \file crc24q_frame_detector.cc
+ * \brief Finds the messages protected by a CRC-24Q in a stream of decoded
+ *  bits, as those of SBAS L1 and GPS L2C CNAV.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "crc24q_frame_detector.h"
+#include <algorithm>
+#include <cstring>
+#include "gnss_crc24q.h"
+
+
+Crc24q_Frame_Detector::Crc24q_Frame_Detector(unsigned int msg_length, const int* preambles, int n_preambles, int preamble_length) :
+        d_buffer(msg_length)
+{
+    d_msg_length = msg_length;
+    d_n_preambles = n_preambles;
+    d_preamble_length = preamble_length;
+    d_preambles.assign(preambles, preambles + n_preambles * preamble_length);
+    d_candidate.resize(msg_length);
+    d_bytes.resize((msg_length + 7) / 8);
+}
+
+
+void Crc24q_Frame_Detector::reset()
+{
+    d_buffer.clear();
+}
+
+
+void Crc24q_Frame_Detector::pack_bits(const int* bits, unsigned int n_bits, unsigned char* bytes)
+{
+    std::memset(bytes, 0, (n_bits + 7) / 8);
+    for (unsigned int i = 0; i < n_bits; i++)
+        {
+            bytes[i / 8] |= static_cast<unsigned char>(bits[i] & 1) << (7 - (i % 8));
+        }
+}
+
+
+bool Crc24q_Frame_Detector::check_crc()
+{
+    // the zeros padding the last byte do not change a zero remainder
+    pack_bits(d_candidate.data(), d_msg_length, d_bytes.data());
+    return Gnss_Crc24q::checksum(d_bytes.data(), d_bytes.size()) == 0;
+}
+
+
+int Crc24q_Frame_Detector::push_bits(const int* bits, int n_bits, std::vector<frame_t>& valid_frames)
+{
+    int n_valid = 0;
+    int relative_preamble_start = 0;
+    for (int n = 0; n < n_bits; n++)
+        {
+            d_buffer.push_back(bits[n]);
+            if (d_buffer.full() == false) continue;
+            for (int p = 0; p < d_n_preambles; p++)
+                {
+                    const int* preamble = &d_preambles[p * d_preamble_length];
+                    bool preamble_detected = true;
+                    bool inv_preamble_detected = true;
+                    for (int i = 0; i < d_preamble_length && (preamble_detected || inv_preamble_detected); i++)
+                        {
+                            preamble_detected = preamble_detected && preamble[i] == d_buffer[i];
+                            inv_preamble_detected = inv_preamble_detected && preamble[i] != d_buffer[i];
+                        }
+                    if (preamble_detected || inv_preamble_detected)
+                        {
+                            d_buffer.copy_to(d_candidate.data());
+                            if (inv_preamble_detected)
+                                {
+                                    for (unsigned int i = 0; i < d_msg_length; i++)
+                                        {
+                                            d_candidate[i] = d_candidate[i] == 0 ? 1 : 0;
+                                        }
+                                }
+                            if (check_crc())
+                                {
+                                    valid_frames.push_back(frame_t(relative_preamble_start, d_candidate));
+                                    n_valid++;
+                                }
+                        }
+                }
+            relative_preamble_start++;
+            d_buffer.pop_front();
+        }
+    return n_valid;
+}
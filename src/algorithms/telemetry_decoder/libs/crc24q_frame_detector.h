@@ -0,0 +1,88 @@
+/*!
+ * \file crc24q_frame_detector.h
+ * \brief Finds the messages protected by a CRC-24Q in a stream of decoded
+ *  bits, as those of SBAS L1 and GPS L2C CNAV.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Replaces the frame_detector and crc_verifier helpers of the SBAS and CNAV
+ * decoders, which built a std::vector for every preamble candidate and one
+ * more for its bytes before running boost::crc_optimal over them. Each
+ * candidate is now packed into a member buffer and checked with the
+ * slicing-by-8 Gnss_Crc24q, so only the messages that pass the CRC are
+ * copied out.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CRC24Q_FRAME_DETECTOR_H_
+#define GNSS_SDR_CRC24Q_FRAME_DETECTOR_H_
+
+#include <utility>
+#include <vector>
+#include "ring_buffer.h"
+
+/*!
+ * \brief Sliding window of one message length over the decoded bits. When
+ * the window starts with one of the preambles, or with its inverse, and its
+ * CRC-24Q remainder (over the received parity) is zero, it is a valid message.
+ */
+class Crc24q_Frame_Detector
+{
+public:
+    typedef std::pair<int, std::vector<int>> frame_t;  //!< bit offset of the preamble in the batch, and the message bits
+
+    /*!
+     * \param msg_length - message length [bits], parity included.
+     * \param preambles - preamble_length bits of each of the n_preambles preambles, one after the other.
+     */
+    Crc24q_Frame_Detector(unsigned int msg_length, const int* preambles, int n_preambles, int preamble_length);
+    void reset();
+
+    /*!
+     * \brief Pushes n_bits decoded bits and appends the valid messages
+     * ending in them to valid_frames, with inverted messages set upright.
+     * \return the number of messages appended.
+     */
+    int push_bits(const int* bits, int n_bits, std::vector<frame_t>& valid_frames);
+
+    /*!
+     * \brief Packs n_bits bits into bytes, most significant bit first,
+     * padding the last byte with zeros.
+     */
+    static void pack_bits(const int* bits, unsigned int n_bits, unsigned char* bytes);
+
+private:
+    bool check_crc();
+
+    unsigned int d_msg_length;
+    int d_n_preambles;
+    int d_preamble_length;
+    std::vector<int> d_preambles;
+    ring_buffer<int> d_buffer;             // bits of the next message candidate
+    std::vector<int> d_candidate;
+    std::vector<unsigned char> d_bytes;    // d_candidate packed by pack_bits
+};
+
+#endif /* GNSS_SDR_CRC24Q_FRAME_DETECTOR_H_ */
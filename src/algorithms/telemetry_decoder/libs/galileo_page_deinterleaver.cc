@@ -0,0 +1,88 @@
+/*!
+ * \file galileo_page_deinterleaver.cc
+ * \brief Block deinterleaver of the Galileo I/NAV and F/NAV pages, which
+ *  also prepares the soft symbols for the Viterbi decoder.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "galileo_page_deinterleaver.h"
+
+
+Galileo_Page_Deinterleaver::Galileo_Page_Deinterleaver(int rows, int cols)
+{
+    d_source.resize(rows * cols);
+    d_sign.resize(rows * cols);
+    for (int r = 0; r < rows; r++)
+        {
+            for (int c = 0; c < cols; c++)
+                {
+                    d_source[c * rows + r] = r * cols + c;
+                }
+        }
+    for (int k = 0; k < rows * cols; k++)
+        {
+            d_sign[k] = (k % 2 == 0) ? 1.0 : -1.0;
+        }
+}
+
+
+void Galileo_Page_Deinterleaver::deinterleave(const double* in, float* out) const
+{
+    const int* source = &d_source[0];
+    const float* sign = &d_sign[0];
+    const int n = size();
+    for (int k = 0; k < n; k++)
+        {
+            out[k] = sign[k] * static_cast<float>(in[source[k]]);
+        }
+}
+
+
+void Galileo_Page_Deinterleaver::deinterleave(const float* in, float* out) const
+{
+    const int* source = &d_source[0];
+    const float* sign = &d_sign[0];
+    const int n = size();
+    for (int k = 0; k < n; k++)
+        {
+            out[k] = sign[k] * in[source[k]];
+        }
+}
+
+
+void Galileo_Page_Deinterleaver::deinterleave(const int8_t* in, int8_t* out) const
+{
+    const int* source = &d_source[0];
+    const int n = size();
+    for (int k = 0; k < n; k++)
+        {
+            const int symbol = in[source[k]];
+            // the sign alternates, and -(-128) saturates
+            const int value = (k % 2 == 0) ? symbol : -symbol;
+            out[k] = static_cast<int8_t>(value > 127 ? 127 : value);
+        }
+}
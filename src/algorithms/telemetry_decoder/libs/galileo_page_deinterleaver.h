@@ -0,0 +1,74 @@
+/*!
+ * \file galileo_page_deinterleaver.h
+ * \brief Block deinterleaver of the Galileo I/NAV and F/NAV pages, which
+ *  also prepares the soft symbols for the Viterbi decoder.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The symbols of a page are written into the interleaver by rows and read
+ * out by columns (Galileo OS SIS ICD, section 4.1.4). Undoing it is a fixed
+ * permutation, so it is computed once into a table, together with the sign
+ * that takes the NOT gate of the G2 polynomial into account. A page is then
+ * deinterleaved, sign corrected and narrowed to float or 8-bit soft symbols
+ * in a single gather loop, ready for Viterbi_Decoder::decode_block().
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GALILEO_PAGE_DEINTERLEAVER_H_
+#define GNSS_SDR_GALILEO_PAGE_DEINTERLEAVER_H_
+
+#include <cstdint>
+#include <vector>
+
+/*!
+ * \brief Deinterleaves pages of rows x cols symbols and negates the second
+ * symbol of each pair, as the Galileo FEC encoder inverts its G2 output.
+ */
+class Galileo_Page_Deinterleaver
+{
+public:
+    Galileo_Page_Deinterleaver(int rows, int cols);
+
+    //! Symbols of a page
+    int size() const
+    {
+        return static_cast<int>(d_source.size());
+    }
+
+    //! out[k] = +/- in[(k % rows) * cols + k / rows]. in and out must not overlap.
+    void deinterleave(const double* in, float* out) const;
+
+    //! Same as above, for float soft symbols
+    void deinterleave(const float* in, float* out) const;
+
+    //! Same as above, for 8-bit soft symbols. -128 is negated to 127.
+    void deinterleave(const int8_t* in, int8_t* out) const;
+
+private:
+    std::vector<int> d_source;   // index of the interleaved symbol of each output
+    std::vector<float> d_sign;   // -1 for the G2 symbols, +1 for the G1 ones
+};
+
+#endif /* GNSS_SDR_GALILEO_PAGE_DEINTERLEAVER_H_ */
@@ -241,6 +241,7 @@ GpsL1CaSubframeFsm::GpsL1CaSubframeFsm()
     d_preamble_time_ms = 0;
     d_subframe_ID=0;
     d_flag_new_subframe=false;
+    d_flag_new_ephemeris=false;
     initiate(); //start the FSM
 }
 
@@ -267,6 +268,10 @@ void GpsL1CaSubframeFsm::gps_subframe_to_nav_msg()
     d_nav.i_satellite_PRN = i_satellite_PRN;
     d_nav.i_channel_ID = i_channel_ID;
     d_nav.d_subframe_timestamp_ms = this->d_preamble_time_ms;
+    if (d_subframe_ID >= 1 && d_subframe_ID <= 3 && !d_nav.b_subframe_repeated)
+        {
+            d_flag_new_ephemeris = true;
+        }
 
     d_flag_new_subframe=true;
 }
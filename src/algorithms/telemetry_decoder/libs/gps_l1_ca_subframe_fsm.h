@@ -82,6 +82,7 @@ public:
     char d_subframe[GPS_SUBFRAME_LENGTH];
     int d_subframe_ID;
     bool d_flag_new_subframe;
+    bool d_flag_new_ephemeris;  //!< Subframes 1 to 3 brought new data since the ephemeris was last published
     char d_GPS_frame_4bytes[GPS_WORD_LENGTH];
     double d_preamble_time_ms;
 
@@ -0,0 +1,111 @@
+/*!
+ * \file preamble_correlator.cc
+ * \brief Sliding correlation of the received symbols with a navigation
+ *  message preamble.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "preamble_correlator.h"
+#include "gnss_sdr_memory_accounting.h"
+#include <cmath>
+#include <volk/volk.h>
+
+
+Preamble_Correlator::Preamble_Correlator(const unsigned short int* preamble_bits, int n_bits, int symbols_per_bit)
+{
+    d_length = n_bits * symbols_per_bit;
+    d_preamble_symbols = static_cast<float*>(gnss_sdr_volk_malloc(d_length * sizeof(float), volk_get_alignment()));
+    d_history = static_cast<float*>(gnss_sdr_volk_malloc(2 * d_length * sizeof(float), volk_get_alignment()));
+    int n = 0;
+    for (int i = 0; i < n_bits; i++)
+        {
+            for (int j = 0; j < symbols_per_bit; j++)
+                {
+                    d_preamble_symbols[n] = (preamble_bits[i] == 1) ? 1.0 : -1.0;
+                    n++;
+                }
+        }
+    reset();
+}
+
+
+Preamble_Correlator::~Preamble_Correlator()
+{
+    gnss_sdr_volk_free(d_preamble_symbols);
+    gnss_sdr_volk_free(d_history);
+}
+
+
+void Preamble_Correlator::reset()
+{
+    for (int n = 0; n < 2 * d_length; n++)
+        {
+            d_history[n] = 0.0;
+        }
+    d_index = 0;
+    d_symbols_pushed = 0;
+}
+
+
+void Preamble_Correlator::push(float value)
+{
+    // the window always starts at d_history + d_index
+    d_history[d_index] = value;
+    d_history[d_index + d_length] = value;
+    d_index++;
+    if (d_index == d_length) d_index = 0;
+    d_symbols_pushed++;
+}
+
+
+void Preamble_Correlator::push_symbol(double value, int weight)
+{
+    // symbols clipping
+    if (value < 0)
+        {
+            push(static_cast<float>(-weight));
+        }
+    else
+        {
+            push(static_cast<float>(weight));
+        }
+}
+
+
+void Preamble_Correlator::push_erasure()
+{
+    push(0.0);
+}
+
+
+int Preamble_Correlator::correlation() const
+{
+    float corr_value;
+    // the symbols are small integers, so the float accumulation is exact
+    volk_32f_x2_dot_prod_32f(&corr_value, d_history + d_index, d_preamble_symbols, d_length);
+    return static_cast<int>(std::round(corr_value));
+}
@@ -0,0 +1,87 @@
+/*!
+ * \file preamble_correlator.h
+ * \brief Sliding correlation of the received symbols with a navigation
+ *  message preamble.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The telemetry decoders used to walk the whole preamble window of the
+ * block input, symbol by symbol, on every call. This class keeps the last
+ * preamble-length symbols in a mirrored ring buffer, so that the window is
+ * always contiguous in memory, and computes the correlation with a VOLK
+ * dot product. Each new symbol is written once, whatever the window length.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PREAMBLE_CORRELATOR_H_
+#define GNSS_SDR_PREAMBLE_CORRELATOR_H_
+
+
+/*!
+ * \brief Correlates the last received symbols with a preamble.
+ *
+ * Symbols are hard decisions weighted by the number of code periods they
+ * span, so that the correlation of a matching window is the preamble length
+ * in symbols regardless of the coherent integration time of the tracking
+ * loops. Symbols not valid for decoding are pushed as erasures.
+ */
+class Preamble_Correlator
+{
+public:
+    /*!
+     * \brief Builds the correlator for a preamble of n_bits bits, each one
+     * spread over symbols_per_bit symbols.
+     */
+    Preamble_Correlator(const unsigned short int* preamble_bits, int n_bits, int symbols_per_bit);
+    ~Preamble_Correlator();
+
+    //! Appends the hard decision of a symbol, weighted by weight
+    void push_symbol(double value, int weight = 1);
+
+    //! Appends a symbol that carries no information
+    void push_erasure();
+
+    /*!
+     * \brief Correlation of the window (oldest symbol first) with the
+     * preamble. Its absolute value equals length() on a full match, and it
+     * is negative if the symbols are inverted.
+     */
+    int correlation() const;
+
+    int length() const { return d_length; }     //!< Window length [symbols]
+    unsigned long int symbols_pushed() const { return d_symbols_pushed; } //!< Symbols received since the last reset
+    void reset();
+
+private:
+    void push(float value);
+
+    int d_length;
+    int d_index;                // slot of the oldest symbol
+    unsigned long int d_symbols_pushed;
+    float* d_preamble_symbols;
+    float* d_history;           // 2 * d_length, the second half mirrors the first one
+};
+
+#endif
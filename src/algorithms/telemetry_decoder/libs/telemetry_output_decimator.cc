@@ -0,0 +1,133 @@
+/*!
+ * \file telemetry_output_decimator.cc
+ * \brief Decides which tracking epochs a telemetry decoder sends on to
+ *  the observables block.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "telemetry_output_decimator.h"
+#include <cmath>
+
+
+Telemetry_Output_Decimator::Telemetry_Output_Decimator()
+{
+    d_mode = all_epochs;
+    d_period_ms = 0.0;
+    d_decimation_factor = 1;
+    reset();
+}
+
+
+bool Telemetry_Output_Decimator::parse_mode(const std::string& name, output_mode& mode)
+{
+    if (name == "all")
+        {
+            mode = all_epochs;
+        }
+    else if (name == "rate")
+        {
+            mode = fixed_rate;
+        }
+    else if (name == "preamble")
+        {
+            mode = preambles;
+        }
+    else
+        {
+            return false;
+        }
+    return true;
+}
+
+
+void Telemetry_Output_Decimator::set_decimation(int factor)
+{
+    d_decimation_factor = factor < 1 ? 1 : factor;
+    d_count = 0;
+}
+
+
+void Telemetry_Output_Decimator::set_mode(output_mode mode, double period_ms)
+{
+    d_mode = mode;
+    d_period_ms = period_ms;
+    if (d_mode != all_epochs && d_period_ms <= 0.0)
+        {
+            d_mode = all_epochs;
+        }
+    reset();
+}
+
+
+void Telemetry_Output_Decimator::reset()
+{
+    d_count = 0;
+    d_started = false;
+    d_last_cell = 0;
+    d_owed = 0;
+}
+
+
+bool Telemetry_Output_Decimator::output(double rx_time_ms, bool frame_sync, bool preamble)
+{
+    if (d_mode == all_epochs)
+        {
+            d_count++;
+            if (d_count < d_decimation_factor)
+                {
+                    return false;
+                }
+            d_count = 0;
+            return true;
+        }
+
+    long long cell = static_cast<long long>(std::floor(rx_time_ms / d_period_ms));
+    if (!d_started || cell < d_last_cell)
+        {
+            // first epoch, or the tracking timestamps went back
+            d_started = true;
+            d_last_cell = cell;
+            d_owed = 1;
+        }
+    else if (cell > d_last_cell)
+        {
+            d_owed += cell - d_last_cell;
+            d_last_cell = cell;
+        }
+    if (d_owed == 0)
+        {
+            return false;
+        }
+    // with frame sync, wait for the preamble, unless a cell went by without
+    // one (the preamble drifted over a cell boundary)
+    if (d_mode == preambles && frame_sync && !preamble && d_owed == 1)
+        {
+            return false;
+        }
+    d_owed--;
+    return true;
+}
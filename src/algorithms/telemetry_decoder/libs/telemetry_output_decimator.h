@@ -0,0 +1,102 @@
+/*!
+ * \file telemetry_output_decimator.h
+ * \brief Decides which tracking epochs a telemetry decoder sends on to
+ *  the observables block.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The observables block consumes one item of every channel per call, so a
+ * sparse output is only possible if every decoder emits the same number of
+ * items over time. Sparse outputs are therefore organized in cells of
+ * period_ms of tracking time, common to all the channels since they share
+ * the sample counter, and each decoder emits exactly one item per cell:
+ * at the first epoch of the cell (fixed rate), or at the preamble when the
+ * channel has frame sync (preambles). The items keep their own
+ * Prn_timestamp_ms and TOW, so Observables.epoch_rate_hz can interpolate
+ * them to common receiver epochs.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_TELEMETRY_OUTPUT_DECIMATOR_H_
+#define GNSS_SDR_TELEMETRY_OUTPUT_DECIMATOR_H_
+
+#include <string>
+
+class Telemetry_Output_Decimator
+{
+public:
+    enum output_mode
+    {
+        all_epochs,   //!< every decimation_factor-th epoch, the former behaviour
+        fixed_rate,   //!< the first epoch of every cell
+        preambles     //!< the preamble epoch of every cell, or its first epoch if there is no frame sync
+    };
+
+    Telemetry_Output_Decimator();
+
+    /*!
+     * \brief Parses "all", "rate" or "preamble" (the values of the
+     * output_mode property). Returns false, and leaves mode unchanged, for
+     * any other string.
+     */
+    static bool parse_mode(const std::string& name, output_mode& mode);
+
+    //! Output every factor-th epoch in all_epochs mode
+    void set_decimation(int factor);
+
+    //! Selects the mode and, for the sparse modes, the cell period [ms]
+    void set_mode(output_mode mode, double period_ms);
+
+    output_mode mode() const
+    {
+        return d_mode;
+    }
+
+    double period_ms() const
+    {
+        return d_period_ms;
+    }
+
+    /*!
+     * \brief Returns true if the epoch is to be sent to the observables.
+     * \param rx_time_ms - tracking time of the epoch (Prn_timestamp_ms).
+     * \param frame_sync - the decoder has frame synchronization.
+     * \param preamble - the epoch is a preamble (or a new frame).
+     */
+    bool output(double rx_time_ms, bool frame_sync, bool preamble);
+
+    void reset();
+
+private:
+    output_mode d_mode;
+    double d_period_ms;
+    int d_decimation_factor;
+    int d_count;
+    bool d_started;
+    long long d_last_cell;
+    long long d_owed;   // items owed to the cells passed
+};
+
+#endif /* GNSS_SDR_TELEMETRY_OUTPUT_DECIMATOR_H_ */
@@ -30,7 +30,7 @@
  */
 
 #include "viterbi_decoder.h"
-#include <iostream>
+#include <cstring>
 #include <glog/logging.h>
 
 // logging
@@ -51,36 +51,46 @@ Viterbi_Decoder::Viterbi_Decoder(const int g_encoder[], const int KK, const int
     // derived code properties
     d_mm = d_KK - 1;
     d_states = 1 << d_mm; /* 2^mm */
-    d_number_symbols = 1 << d_nn; /* 2^nn */
-
-    /* create appropriate transition matrices (trellis) */
-    d_out0 = new int[d_states];
-    d_out1 = new int[d_states];
-    d_state0 = new int[d_states];
-    d_state1 = new int[d_states];
-
-    nsc_transit(d_out0, d_state0, 0, g_encoder, d_KK, d_nn);
-    nsc_transit(d_out1, d_state1, 1, g_encoder, d_KK, d_nn);
+    d_half_states = d_states / 2;
+    d_words_per_step = (d_states + 63) / 64;
+
+    /* create the butterflies of the trellis: state s at t+1 is reached from
+     * the even state (s << 1) & (states - 1) and from the next odd state,
+     * in both cases with the input bit s >> (mm - 1) */
+    d_out0.resize(d_states);
+    d_out1.resize(d_states);
+    d_sign0.resize(d_nn * d_states);
+    d_sign1.resize(d_nn * d_states);
+    int next_state[1];
+    for (int state = 0; state < d_states; state++)
+        {
+            int input = state >> (d_mm - 1);
+            int even_ancestor = (state << 1) & (d_states - 1);
+            d_out0[state] = nsc_enc_bit(next_state, input, even_ancestor, g_encoder, d_KK, d_nn);
+            d_out1[state] = nsc_enc_bit(next_state, input, even_ancestor | 1, g_encoder, d_KK, d_nn);
+            for (int i = 0; i < d_nn; i++)
+                {
+                    // the first received symbol of a section belongs to the first generator, the MSB of the code symbol
+                    d_sign0[i * d_states + state] = ((d_out0[state] >> (d_nn - i - 1)) & 1) ? 1.0 : -1.0;
+                    d_sign1[i * d_states + state] = ((d_out1[state] >> (d_nn - i - 1)) & 1) ? 1.0 : -1.0;
+                }
+        }
 
-    // initialise trellis state
-    d_trellis_state_is_initialised = false;
+    // trellis state, allocated once
+    d_pm_t.resize(d_states);
+    d_pm_even.resize(d_half_states);
+    d_pm_odd.resize(d_half_states);
+    d_metric0.resize(d_states);
+    d_metric1.resize(d_states);
+    d_selected.resize(d_states);
+    d_n_steps = 0;
+    reserve_steps(512);
     Viterbi_Decoder::init_trellis_state();
 }
 
 
 Viterbi_Decoder::~Viterbi_Decoder()
-{
-    // trellis definition
-    delete[] d_out0;
-    delete[] d_out1;
-    delete[] d_state0;
-    delete[] d_state1;
-
-    // init trellis state
-    delete[] d_pm_t;
-    delete[] d_rec_array;
-    delete[] d_metric_c;
-}
+{}
 
 
 
@@ -101,6 +111,25 @@ void Viterbi_Decoder::reset()
  output_u_int[]    Hard decisions on the data bits (without the mm zero-tail-bits)
  */
 float Viterbi_Decoder::decode_block(const double input_c[], int output_u_int[], const int LL)
+{
+    return decode_symbols(input_c, output_u_int, LL);
+}
+
+
+float Viterbi_Decoder::decode_block(const float input_c[], int output_u_int[], const int LL)
+{
+    return decode_symbols(input_c, output_u_int, LL);
+}
+
+
+float Viterbi_Decoder::decode_block(const int8_t input_c[], int output_u_int[], const int LL)
+{
+    return decode_symbols(input_c, output_u_int, LL);
+}
+
+
+template<class Symbol>
+float Viterbi_Decoder::decode_symbols(const Symbol input_c[], int output_u_int[], const int LL)
 {
     int state;
     int decoding_length_mismatch;
@@ -141,7 +170,11 @@ float Viterbi_Decoder::decode_continuous(const double sym[],
     state = do_traceback(traceback_depth);
     // traceback and decode
     decoding_length_mismatch = do_tb_and_decode(traceback_depth, nbits_requested, state,  bits, d_indicator_metric);
-    nbits_decoded = nbits_requested + decoding_length_mismatch;
+    nbits_decoded = nbits_requested + (decoding_length_mismatch < 0 ? decoding_length_mismatch : 0);
+    if (nbits_decoded < 0)
+        {
+            nbits_decoded = 0;
+        }
 
     VLOG(FLOW) << "decoding length mismatch (continuous decoding): " << decoding_length_mismatch;
 
@@ -152,149 +185,135 @@ float Viterbi_Decoder::decode_continuous(const double sym[],
 
 void Viterbi_Decoder::init_trellis_state()
 {
-    int state;
-    // if trellis state has been initialised, free old state memory
-    if(d_trellis_state_is_initialised)
-        {
-            // init trellis state
-            delete[] d_pm_t;
-            delete[] d_rec_array;
-            delete[] d_metric_c;
-        }
-
-    // reserve new trellis state memory
-    d_pm_t = new float[d_states];
-    d_trellis_paths = std::deque<Prev>();
-    d_rec_array = new float[d_nn];
-    d_metric_c = new float[d_number_symbols];
-    d_trellis_state_is_initialised = true;
-
     /* initialize trellis */
-    for (state = 0; state < d_states; state++)
+    for (int state = 0; state < d_states; state++)
         {
             d_pm_t[state] = -MAXLOG;
-            //d_pm_t_next[state] = -MAXLOG;
         }
     d_pm_t[0] = 0; /* start in all-zeros state */
 
+    d_n_steps = 0;
     d_indicator_metric = 0;
 }
 
 
 
-
-int Viterbi_Decoder::do_acs(const double sym[], int nbits)
+void Viterbi_Decoder::reserve_steps(int n_steps)
 {
-    int t, i, state_at_t;
-    float metric;
-    float max_val;
-    float * pm_t_next = new float[d_states];
-
-    /* t:
-     *    - state: state at t
-     *    - d_prev_section[state_at_t]: path metric at t for state state_at_t
-     *    - d_out0[state_at_t]: sent symbols for a data bit 0 if state is state_at_t at time t
-     *
-     */
-
-    for (state_at_t = 0; state_at_t < d_states; state_at_t++)
+    // grows geometrically, so that continuous decoding settles on a fixed size
+    if (static_cast<int>(d_rec.size()) < n_steps * d_nn)
         {
-            pm_t_next[state_at_t] = -MAXLOG;
+            int capacity = 2 * n_steps;
+            d_decisions.resize(capacity * d_words_per_step);
+            d_rec.resize(capacity * d_nn);
         }
+}
+
+
+
+template<class Symbol>
+void Viterbi_Decoder::do_acs(const Symbol sym[], int nbits)
+{
+    float * pm_t = &d_pm_t[0];
+    float * pm_even = &d_pm_even[0];
+    float * pm_odd = &d_pm_odd[0];
+    float * metric0 = &d_metric0[0];
+    float * metric1 = &d_metric1[0];
+    unsigned char * selected = &d_selected[0];
+    const int states = d_states;
+    const int half_states = d_half_states;
+
+    reserve_steps(d_n_steps + nbits);
 
     /* go through trellis */
-    for (t = 0; t < nbits; t++)
+    for (int t = 0; t < nbits; t++)
         {
-            /* Temporarily store the received symbols current decoding step */
-            for (i = 0; i < d_nn; i++)
-                d_rec_array[i] = static_cast<float>(sym[d_nn * t + i]);
+            float * rec = &d_rec[d_nn * d_n_steps];
+            unsigned long long * decisions = &d_decisions[d_words_per_step * d_n_steps];
 
-            /* precompute all possible branch metrics */
-            for (i = 0; i < d_number_symbols; i++)
+            /* path metrics of the even and odd predecessors */
+            for (int j = 0; j < half_states; j++)
                 {
-                    d_metric_c[i] = gamma(d_rec_array, i, d_nn);
-                    VLOG(LMORE) << "metric for (tx_sym=" << i << "|ry_sym=(" << d_rec_array[0] << ", " << d_rec_array[1] << ") = " << d_metric_c[i];
+                    pm_even[j] = pm_t[2 * j];
+                    pm_odd[j] = pm_t[2 * j + 1];
                 }
-
-            // find the survivor branches leading the trellis states at t+1
-            Prev next_trellis_states(d_states, t+1);
-            /* step through all states */
-            for (state_at_t = 0; state_at_t < d_states; state_at_t++)
+            for (int j = 0; j < half_states; j++)
                 {
-                    int next_state_if_0 = d_state0[state_at_t];
-                    int next_state_if_1 = d_state1[state_at_t];
-
-                    /* hypothesis: info bit is a zero */
-                    int bm_0 = d_metric_c[d_out0[state_at_t]];
-                    metric = d_pm_t[state_at_t] + bm_0; // path metric + zerobranch metric
-
-                    /* store new metric if more than metric in storage */
-                    if (metric > pm_t_next[next_state_if_0])
-                        {
-                            pm_t_next[next_state_if_0] = metric;
-                            next_trellis_states.set_current_state_as_ancestor_of_next_state(next_state_if_0, state_at_t);
-                            next_trellis_states.set_decoded_bit_for_next_state(next_state_if_0, 0);
-                            next_trellis_states.set_survivor_branch_metric_of_next_state(next_state_if_0, bm_0);
-                        }
-
-                    /* hypothesis: info bit is a one */
-                    int bm_1 = d_metric_c[d_out1[state_at_t]];
-                    metric = d_pm_t[state_at_t] + bm_1; // path metric + onebranch metric
+                    metric0[j] = pm_even[j];
+                    metric0[j + half_states] = pm_even[j];
+                    metric1[j] = pm_odd[j];
+                    metric1[j + half_states] = pm_odd[j];
+                }
 
-                    /* store new metric if more than metric in storage */
-                    if (metric > pm_t_next[next_state_if_1])
+            /* add the branch metrics, one received symbol at a time */
+            for (int i = 0; i < d_nn; i++)
+                {
+                    const float r = static_cast<float>(sym[d_nn * t + i]);
+                    const float * sign0 = &d_sign0[i * states];
+                    const float * sign1 = &d_sign1[i * states];
+                    rec[i] = r;
+                    for (int state = 0; state < states; state++)
                         {
-                            pm_t_next[next_state_if_1] = metric;
-                            next_trellis_states.set_current_state_as_ancestor_of_next_state(next_state_if_1, state_at_t);
-                            next_trellis_states.set_decoded_bit_for_next_state(next_state_if_1, 1);
-                            next_trellis_states.set_survivor_branch_metric_of_next_state(next_state_if_1, bm_1);
+                            metric0[state] += sign0[state] * r;
+                            metric1[state] += sign1[state] * r;
                         }
                 }
 
-            d_trellis_paths.push_front(next_trellis_states);
+            /* compare and select, the even predecessor wins ties */
+            for (int state = 0; state < states; state++)
+                {
+                    selected[state] = metric1[state] > metric0[state];
+                    pm_t[state] = metric1[state] > metric0[state] ? metric1[state] : metric0[state];
+                }
 
-            /* normalize -> afterwards, the largest metric value is always 0 */
-            //max_val = 0;
-            max_val = -MAXLOG;
-            for (state_at_t = 0; state_at_t < d_states; state_at_t++)
+            /* pack the decisions, eight states at a time */
+            for (int w = 0; w < d_words_per_step; w++)
                 {
-                    if (pm_t_next[state_at_t] > max_val)
+                    decisions[w] = 0;
+                }
+            for (int first = 0; first < states; first += 8)
+                {
+                    unsigned long long bytes = 0;
+                    for (int k = 0; k < 8 && first + k < states; k++)
                         {
-                            max_val = pm_t_next[state_at_t];
+                            bytes |= static_cast<unsigned long long>(selected[first + k]) << (8 * k);
                         }
+                    // moves the lowest bit of each byte to bits 56 to 63
+                    unsigned long long packed = (bytes * 0x0102040810204080ULL) >> 56;
+                    decisions[first >> 6] |= packed << (first & 63);
                 }
-            VLOG(LMORE) << "max_val at t=" << t << ": " << max_val;
-            for (state_at_t = 0; state_at_t < d_states; state_at_t++)
+
+            /* normalize to the metric of the all-zeros state. The spread of the
+             * metrics is bounded, so this keeps them from growing just as well
+             * as subtracting the largest one, without a serial max search */
+            const float reference_metric = pm_t[0];
+            for (int state = 0; state < states; state++)
                 {
-                    d_pm_t[state_at_t] = pm_t_next[state_at_t] - max_val;
-                    pm_t_next[state_at_t] = -MAXLOG;
+                    pm_t[state] -= reference_metric;
                 }
+            d_n_steps++;
         }
-
-    delete[] pm_t_next;
-
-    return t;
 }
 
 
 
-int Viterbi_Decoder::do_traceback(size_t traceback_length)
+int Viterbi_Decoder::do_traceback(int traceback_length)
 {
     // traceback_length is in bits
     int state;
-    std::deque<Prev>::iterator it;
 
-    VLOG(FLOW) << "do_traceback(): traceback_length=" << traceback_length << std::endl;
+    VLOG(FLOW) << "do_traceback(): traceback_length=" << traceback_length;
 
-    if (d_trellis_paths.size() < traceback_length)
+    if (d_n_steps < traceback_length)
         {
-            traceback_length = d_trellis_paths.size();
+            traceback_length = d_n_steps;
         }
 
     state = 0; // maybe start not at state 0, but at state with best metric
-    for (it = d_trellis_paths.begin(); it < d_trellis_paths.begin() + traceback_length; ++it)
+    for (int t = d_n_steps - 1; t >= d_n_steps - traceback_length; t--)
         {
-            state = it->get_anchestor_state_of_current_state(state);
+            int odd = (d_decisions[d_words_per_step * t + (state >> 6)] >> (state & 63)) & 1;
+            state = ((state << 1) & (d_states - 1)) | odd;
         }
     return state;
 }
@@ -304,38 +323,38 @@ int Viterbi_Decoder::do_traceback(size_t traceback_length)
 
 int Viterbi_Decoder::do_tb_and_decode(int traceback_length, int requested_decoding_length, int state, int output_u_int[], float& indicator_metric)
 {
-    int n_of_branches_for_indicator_metric = 500;
-    int t_out;
-    std::deque<Prev>::iterator it;
+    const int n_of_branches_for_indicator_metric = 500;
     int decoding_length_mismatch;
     int overstep_length;
     int n_im = 0;
 
     VLOG(FLOW) << "do_tb_and_decode(): requested_decoding_length=" << requested_decoding_length;
     // decode only decode_length bits -> overstep newer bits which are too much
-    decoding_length_mismatch = d_trellis_paths.size() - (traceback_length + requested_decoding_length);
+    decoding_length_mismatch = d_n_steps - (traceback_length + requested_decoding_length);
     VLOG(BLOCK) << "decoding_length_mismatch=" << decoding_length_mismatch;
     overstep_length = decoding_length_mismatch >= 0 ? decoding_length_mismatch : 0;
     VLOG(BLOCK) << "overstep_length=" << overstep_length;
 
-    for (it = d_trellis_paths.begin() + traceback_length;
-            it < d_trellis_paths.begin() + traceback_length + overstep_length; ++it)
+    int first_traced = d_n_steps - (traceback_length < d_n_steps ? traceback_length : d_n_steps);
+    int n_decoded = first_traced - overstep_length;
+    for (int t = first_traced - 1; t >= n_decoded; t--)
         {
-            state = it->get_anchestor_state_of_current_state(state);
+            int odd = (d_decisions[d_words_per_step * t + (state >> 6)] >> (state & 63)) & 1;
+            state = ((state << 1) & (d_states - 1)) | odd;
         }
-    t_out = d_trellis_paths.end() - (d_trellis_paths.begin() + traceback_length + overstep_length) - 1;//requested_decoding_length-1;
+
     indicator_metric = 0;
-    for (it = d_trellis_paths.begin() + traceback_length + overstep_length; it < d_trellis_paths.end(); ++it)
+    for (int t = n_decoded - 1; t >= 0; t--)
         {
-            if(it - (d_trellis_paths.begin() + traceback_length + overstep_length) < n_of_branches_for_indicator_metric)
+            int odd = (d_decisions[d_words_per_step * t + (state >> 6)] >> (state & 63)) & 1;
+            int ancestor = ((state << 1) & (d_states - 1)) | odd;
+            if (n_im < n_of_branches_for_indicator_metric)
                 {
                     n_im++;
-                    indicator_metric += it->get_metric_of_current_state(state);
-                    VLOG(SAMPLE) << "@t=" << it->get_t() << " b=" << it->get_bit_of_current_state(state) << " sm=" << indicator_metric << " d=" << it->get_metric_of_current_state(state);
+                    indicator_metric += survivor_branch_metric(t, state, ancestor);
                 }
-            output_u_int[t_out] = it->get_bit_of_current_state(state);
-            state = it->get_anchestor_state_of_current_state(state);
-            t_out--;
+            output_u_int[t] = state >> (d_mm - 1);
+            state = ancestor;
         }
     if(n_im > 0)
         {
@@ -344,68 +363,29 @@ int Viterbi_Decoder::do_tb_and_decode(int traceback_length, int requested_decodi
 
     VLOG(BLOCK) << "indicator metric: " << indicator_metric;
     // remove old states
-    if (d_trellis_paths.begin() + traceback_length + overstep_length <= d_trellis_paths.end())
+    if (n_decoded > 0)
         {
-
-            d_trellis_paths.erase(d_trellis_paths.begin() + traceback_length+overstep_length, d_trellis_paths.end());
+            d_n_steps -= n_decoded;
+            std::memmove(&d_decisions[0], &d_decisions[d_words_per_step * n_decoded], sizeof(unsigned long long) * d_words_per_step * d_n_steps);
+            std::memmove(&d_rec[0], &d_rec[d_nn * n_decoded], sizeof(float) * d_nn * d_n_steps);
         }
     return decoding_length_mismatch;
 }
 
 
 
-/* function Gamma()
-
- Description: Computes the branch metric used for decoding.
-
- Output parameters:
- (returned float)     The metric between the hypothetical symbol and the recevieved vector
-
- Input parameters:
- rec_array            The received vector, of length nn
- symbol                The hypothetical symbol
- nn                    The length of the received vector
-
- This function is used by siso()  */
-float
-Viterbi_Decoder::gamma(float rec_array[], int symbol, int nn)
+/* Branch metric of the survivor from ancestor (at t) to state (at t+1),
+ * the +/-1 weighted sum of the received symbols of step t */
+float Viterbi_Decoder::survivor_branch_metric(int t, int state, int ancestor) const
 {
+    const std::vector<float> & sign = (ancestor & 1) ? d_sign1 : d_sign0;
     float rm = 0;
-    int i;
-    int mask;
-    float txsym;
-
-    mask = 1;
-    for (i = 0; i < nn; i++)
-        {
-            //if (symbol & mask) rm += rec_array[nn - i - 1];
-            txsym = symbol & mask ? 1 : -1;
-            rm += txsym * rec_array[nn - i - 1];
-            mask = mask << 1;
-        }
-    //rm = rm > 50 ? rm : -1000;
-
-    return (rm);
-}
-
-/* function that creates the transit and output vectors */
-void
-Viterbi_Decoder::nsc_transit(int output_p[], int trans_p[], int input, const int g[],
-        int KK, int nn)
-{
-    int nextstate[1];
-    int state, states;
-    states = (1 << (KK - 1)); /* The number of states: 2^mm */
-
-    /* Determine the output and next state for each possible starting state */
-    for (state = 0; state < states; state++)
+    for (int i = 0; i < d_nn; i++)
         {
-            output_p[state] = nsc_enc_bit(nextstate, input, state, g, KK, nn);
-            trans_p[state] = nextstate[0];
+            rm += sign[i * d_states + state] * d_rec[d_nn * t + i];
         }
-    return;
+    return rm;
 }
-
 /* Function nsc_enc_bit()
 
  Description: Convolutionally encodes a single bit using a rate 1/n encoder.
@@ -471,171 +451,3 @@ int Viterbi_Decoder::parity_counter(int symbol, int length)
         }
     return (temp_parity);
 }
-
-
-
-// prev helper class
-Viterbi_Decoder::Prev::Prev(int states, int t)
-{
-    this->t = t;
-    num_states = states;
-    state = new int[states];
-    bit = new int[states];
-    metric = new float[states];
-    refcount = new int;
-    *refcount = 1;
-    memset(state, 0, sizeof(int) * num_states);
-    memset(bit, 0, sizeof(int) * num_states);
-    memset(metric, 0, sizeof(float) * num_states);
-}
-
-
-
-// copy constructor
-Viterbi_Decoder::Prev::Prev(const Prev& prev)
-{
-    refcount = prev.refcount;
-    (*refcount)++;
-    t = prev.t;
-    state = prev.state;
-    num_states = prev.num_states;
-    bit = prev.bit;
-    metric = prev.metric;
-    VLOG(LMORE) << "Prev(" << "?" << ", " << t << ")" << " copy, new refcount = " << *refcount;
-}
-
-
-
-// assignment constructor
-Viterbi_Decoder::Prev& Viterbi_Decoder::Prev::operator=(const Prev& other)
-{
-    // check for self-assignment
-    if(&other == this)
-        {
-            return *this;
-        }
-
-    // handle old resources
-    if(*refcount == 1)
-        { // if they are not used anymore -> unallocate them
-            delete[] state;
-            delete[] bit;
-            delete[] metric;
-            delete refcount;
-        }
-    else
-        { // this object is not anymore using them
-            (*refcount)--;
-        }
-
-    // increase ref counter for this resource set
-    refcount = other.refcount;
-    (*refcount)++;
-
-    // take over resources
-    t = other.t;
-    state = other.state;
-    bit = other.bit;
-    metric = other.metric;
-
-    VLOG(LMORE) << "Prev(" << "?" << ", " << t << ")" << " assignment, new refcount = " << *refcount;
-    return *this;
-}
-
-
-
-
-Viterbi_Decoder::Prev::~Prev()
-{
-    if (*refcount == 1)
-        {
-            delete[] state;
-            delete[] bit;
-            delete[] metric;
-            delete refcount;
-            //std::cout << "~Prev(" << "?" << ", " << t << ")" << " destructor with delete" << std::endl;
-        }
-    else
-        {
-            (*refcount)--;
-            VLOG(LMORE) << "~Prev(" << "?" << ", " << t << ")" << " destructor after copy, new refcount = " << *refcount;
-        }
-}
-
-
-
-int Viterbi_Decoder::Prev::get_anchestor_state_of_current_state(int current_state)
-{
-    //std::cout << "get prev state: for state " << current_state << " at time " << t << ", the prev state at time " << t-1 << " is " << state[current_state] << std::endl;
-    if (num_states > current_state)
-        {
-            return state[current_state];
-        }
-    else
-        {
-            //std::cout<<"alarm "<<"num_states="<<num_states<<" current_state="<<current_state<<std::endl;
-            //return state[current_state];
-            return 0;
-        }
-}
-
-
-
-int Viterbi_Decoder::Prev::get_bit_of_current_state(int current_state)
-{
-    //std::cout << "get prev bit  : for state " << current_state << " at time " << t << ", the send bit is " << bit[current_state] << std::endl;
-    if (num_states > current_state)
-        {
-            return bit[current_state];
-        }
-    else
-        {
-            return 0;
-        }
-}
-
-
-float Viterbi_Decoder::Prev::get_metric_of_current_state(int current_state)
-{
-    if (num_states > current_state)
-        {
-            return metric[current_state];
-        }
-    else
-        {
-            return 0;
-        }
-}
-
-
-int Viterbi_Decoder::Prev::get_t()
-{
-    return t;
-}
-
-
-void Viterbi_Decoder::Prev::set_current_state_as_ancestor_of_next_state(int next_state, int current_state)
-{
-    if (num_states > next_state)
-        {
-            state[next_state] = current_state;
-        }
-}
-
-
-void Viterbi_Decoder::Prev::set_decoded_bit_for_next_state(int next_state, int bit)
-{
-    if (num_states > next_state)
-        {
-            this->bit[next_state] = bit;
-        }
-}
-
-
-void Viterbi_Decoder::Prev::set_survivor_branch_metric_of_next_state(int next_state, float metric)
-{
-    if (num_states > next_state)
-        {
-            this->metric[next_state] = metric;
-        }
-}
@@ -32,11 +32,22 @@
 #ifndef GNSS_SDR_VITERBI_DECODER_H_
 #define GNSS_SDR_VITERBI_DECODER_H_
 
-#include <deque>
-#include <cstdio>
+#include <cstdint>
+#include <vector>
 
 /*!
- * \brief Class that implements a Viterbi decoder
+ * \brief Class that implements a Viterbi decoder for rate 1/nn
+ * non-systematic convolutional codes.
+ *
+ * The add-compare-select step works on the butterflies of the trellis: the
+ * two predecessors of state s are ((s << 1) & (states - 1)) | b, b = 0, 1.
+ * The path metrics of the even and odd predecessors are split into contiguous
+ * arrays and the branch metrics are obtained from precomputed +/-1 code symbol
+ * tables, so every loop of the step runs over contiguous float arrays without
+ * branches and is vectorized by the compiler. The survivor decisions are kept
+ * as one bit per state and trellis step in a buffer allocated once, and the
+ * survivor branch metrics are recomputed during the traceback from the stored
+ * received symbols.
  */
 class Viterbi_Decoder
 {
@@ -55,35 +66,16 @@ public:
      */
     float decode_block(const double input_c[], int* output_u_int, const int LL);
 
+    //! Same as above, with float soft symbols
+    float decode_block(const float input_c[], int* output_u_int, const int LL);
+
+    //! Same as above, with 8-bit soft symbols
+    float decode_block(const int8_t input_c[], int* output_u_int, const int LL);
+
     float decode_continuous(const double sym[], const int traceback_depth, int output_u_int[],
             const int nbits_requested, int &nbits_decoded);
 
 private:
-    class Prev
-    {
-    public:
-        int num_states;
-        Prev(int states, int t);
-        Prev(const Prev& prev);
-        Prev& operator=(const Prev& other);
-        ~Prev();
-
-        int get_anchestor_state_of_current_state(int current_state);
-        int get_bit_of_current_state(int current_state);
-        float get_metric_of_current_state(int current_state);
-        int get_t();
-        void set_current_state_as_ancestor_of_next_state(int next_state, int current_state);
-        void set_decoded_bit_for_next_state(int next_state, int bit);
-        void set_survivor_branch_metric_of_next_state(int next_state, float metric);
-
-    private:
-        int t;
-        int * state;
-        int * bit;
-        float * metric;
-        int * refcount;
-    };
-
     // code properties
     int d_KK;
     int d_nn;
@@ -91,35 +83,39 @@ private:
     // derived code properties
     int d_mm;
     int d_states;
-    int d_number_symbols;
+    int d_half_states;
+    int d_words_per_step;  // 64-bit words of survivor decisions per trellis step
 
-    // trellis definition
-    int* d_out0;
-    int* d_state0;
-    int* d_out1;
-    int* d_state1;
+    // trellis definition, indexed by the state at t+1
+    std::vector<int> d_out0;      // code symbol of the branch from the even predecessor
+    std::vector<int> d_out1;      // code symbol of the branch from the odd predecessor
+    std::vector<float> d_sign0;   // d_out0 as +/-1 per code symbol, d_nn rows of d_states
+    std::vector<float> d_sign1;
 
     // trellis state
-    float *d_pm_t;
-    std::deque<Prev> d_trellis_paths;
-    float *d_metric_c; /* Set of all possible branch metrics */
-    float *d_rec_array; /* Received values for one trellis section */
-    bool d_trellis_state_is_initialised;
+    std::vector<float> d_pm_t;
+    std::vector<float> d_pm_even;
+    std::vector<float> d_pm_odd;
+    std::vector<float> d_metric0;
+    std::vector<float> d_metric1;
+    std::vector<unsigned char> d_selected;          // decisions of the current step, one byte per state
+    std::vector<unsigned long long> d_decisions;  // bit s of step t: state s survived from its odd predecessor
+    std::vector<float> d_rec;                     // received symbols of every stored step
+    int d_n_steps;                                // trellis steps stored, oldest first
 
     // measures
     float d_indicator_metric;
 
     // operations on the trellis (change decoder state)
     void init_trellis_state();
-    int do_acs(const double sym[], int nbits);
-    int do_traceback(size_t traceback_length);
+    void reserve_steps(int n_steps);
+    template<class Symbol> float decode_symbols(const Symbol input_c[], int* output_u_int, const int LL);
+    template<class Symbol> void do_acs(const Symbol sym[], int nbits);
+    int do_traceback(int traceback_length);
     int do_tb_and_decode(int traceback_length, int requested_decoding_length, int state, int bits[], float& indicator_metric);
-
-    // branch metric function
-    float gamma(float rec_array[], int symbol, int nn);
+    float survivor_branch_metric(int t, int state, int ancestor) const;
 
     // trellis generation
-    void nsc_transit(int output_p[], int trans_p[], int input, const int g[], int KK, int nn);
     int nsc_enc_bit(int state_out_p[], int input, int state_in, const int g[], int KK, int nn);
     int parity_counter(int symbol, int length);
 };
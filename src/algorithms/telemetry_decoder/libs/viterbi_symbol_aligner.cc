@@ -0,0 +1,80 @@
+/*!
+ * \file viterbi_symbol_aligner.cc
+ * \brief Viterbi decoding of a continuous stream of rate 1/nn symbols whose
+ *  alignment with the code symbol pairs is not known.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "viterbi_symbol_aligner.h"
+#include <algorithm>
+
+
+Viterbi_Symbol_Aligner::Viterbi_Symbol_Aligner(const int g_encoder[], int KK, int nn, int max_symbols) :
+        d_vd1(g_encoder, KK, nn),
+        d_vd2(g_encoder, KK, nn)
+{
+    d_KK = KK;
+    d_nn = nn;
+    d_past_symbol = 0;
+    d_shifted_symbols.resize(max_symbols);
+    d_bits_vd1.resize(max_symbols / nn);
+    d_bits_vd2.resize(max_symbols / nn);
+}
+
+
+void Viterbi_Symbol_Aligner::reset()
+{
+    d_past_symbol = 0;
+    d_vd1.reset();
+    d_vd2.reset();
+}
+
+
+bool Viterbi_Symbol_Aligner::get_bits(const double* symbols, int n_symbols, std::vector<int>& bits)
+{
+    if (n_symbols <= 0) return true;
+    const int traceback_depth = 5 * d_KK;
+    int nbits_requested = n_symbols / d_nn;
+    int nbits_decoded = 0;
+    if (static_cast<int>(d_shifted_symbols.size()) < n_symbols)
+        {
+            // only if the batch is larger than announced
+            d_shifted_symbols.resize(n_symbols);
+            d_bits_vd1.resize(nbits_requested);
+            d_bits_vd2.resize(nbits_requested);
+        }
+    d_shifted_symbols[0] = d_past_symbol;
+    std::copy(symbols, symbols + n_symbols - 1, d_shifted_symbols.begin() + 1);
+
+    float metric_vd1 = d_vd1.decode_continuous(symbols, traceback_depth, d_bits_vd1.data(), nbits_requested, nbits_decoded);
+    float metric_vd2 = d_vd2.decode_continuous(d_shifted_symbols.data(), traceback_depth, d_bits_vd2.data(), nbits_requested, nbits_decoded);
+    bool aligned = metric_vd1 > metric_vd2;
+    const std::vector<int>& best = aligned ? d_bits_vd1 : d_bits_vd2;
+    bits.insert(bits.end(), best.begin(), best.begin() + nbits_decoded);
+    d_past_symbol = symbols[n_symbols - 1];
+    return aligned;
+}
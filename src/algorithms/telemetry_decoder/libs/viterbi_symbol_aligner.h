@@ -0,0 +1,74 @@
+/*!
+ * \file viterbi_symbol_aligner.h
+ * \brief Viterbi decoding of a continuous stream of rate 1/nn symbols whose
+ *  alignment with the code symbol pairs is not known.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The SBAS and GPS L2C CNAV decoders each had a copy of this helper, which
+ * allocated the shifted symbols and both bit arrays at every batch. The
+ * work buffers are now members, sized for the largest batch.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_VITERBI_SYMBOL_ALIGNER_H_
+#define GNSS_SDR_VITERBI_SYMBOL_ALIGNER_H_
+
+#include <vector>
+#include "viterbi_decoder.h"
+
+/*!
+ * \brief Decodes the symbols both as they are and shifted by one symbol,
+ * with one Viterbi_Decoder each, and keeps the bits of the alignment with
+ * the better path metric.
+ */
+class Viterbi_Symbol_Aligner
+{
+public:
+    /*!
+     * \param g_encoder, KK, nn - the convolutional code, as in Viterbi_Decoder.
+     * \param max_symbols - the largest batch of symbols passed to get_bits().
+     */
+    Viterbi_Symbol_Aligner(const int g_encoder[], int KK, int nn, int max_symbols);
+    void reset();
+
+    /*!
+     * \brief Appends to bits the data bits decoded from n_symbols symbols.
+     * \return true if the symbols were aligned with the code symbol pairs.
+     */
+    bool get_bits(const double* symbols, int n_symbols, std::vector<int>& bits);
+
+private:
+    int d_KK;
+    int d_nn;
+    Viterbi_Decoder d_vd1;  // aligned symbols
+    Viterbi_Decoder d_vd2;  // symbols shifted by one, the last symbol of the previous batch in front
+    double d_past_symbol;
+    std::vector<double> d_shifted_symbols;
+    std::vector<int> d_bits_vd1;
+    std::vector<int> d_bits_vd2;
+};
+
+#endif /* GNSS_SDR_VITERBI_SYMBOL_ALIGNER_H_ */
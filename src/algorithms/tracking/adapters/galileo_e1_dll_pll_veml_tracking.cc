@@ -54,14 +54,16 @@ GalileoE1DllPllVemlTracking::GalileoE1DllPllVemlTracking(
     int f_if;
     bool dump;
     std::string dump_filename;
-    std::string item_type;
     std::string default_item_type = "gr_complex";
     float pll_bw_hz;
     float dll_bw_hz;
     float early_late_space_chips;
     float very_early_late_space_chips;
+    bool track_pilot;
+    int monitor_taps;
+    float monitor_tap_spacing_chips;
 
-    item_type = configuration->property(role + ".item_type", default_item_type);
+    item_type_ = configuration->property(role + ".item_type", default_item_type);
     fs_in = configuration->property("GNSS-SDR.internal_fs_hz", 2048000);
     f_if = configuration->property(role + ".if", 0);
     dump = configuration->property(role + ".dump", false);
@@ -69,6 +71,15 @@ GalileoE1DllPllVemlTracking::GalileoE1DllPllVemlTracking(
     dll_bw_hz = configuration->property(role + ".dll_bw_hz", 2.0);
     early_late_space_chips = configuration->property(role + ".early_late_space_chips", 0.15);
     very_early_late_space_chips = configuration->property(role + ".very_early_late_space_chips", 0.6);
+    track_pilot = configuration->property(role + ".track_pilot", false);
+    monitor_taps = configuration->property(role + ".monitor_taps", 0);
+    monitor_tap_spacing_chips = configuration->property(role + ".monitor_tap_spacing_chips", 0.1);
+    std::string loop_arithmetic_name = configuration->property(role + ".loop_arithmetic", std::string("float"));
+    Tracking_Loop_Arithmetic loop_arithmetic = TRACKING_LOOP_FLOAT;
+    if (parse_tracking_loop_arithmetic(loop_arithmetic_name, loop_arithmetic) == false)
+        {
+            LOG(WARNING) << role << ".loop_arithmetic=" << loop_arithmetic_name << " is not float or fixed. Using float";
+        }
 
     std::string default_dump_filename = "./track_ch";
     dump_filename = configuration->property(role + ".dump_filename",
@@ -76,10 +87,10 @@ GalileoE1DllPllVemlTracking::GalileoE1DllPllVemlTracking(
     vector_length = std::round(fs_in / (Galileo_E1_CODE_CHIP_RATE_HZ / Galileo_E1_B_CODE_LENGTH_CHIPS));
 
     //################# MAKE TRACKING GNURadio object ###################
-    if (item_type.compare("gr_complex") == 0)
+    if (item_type_.compare("gr_complex") == 0)
         {
             item_size_ = sizeof(gr_complex);
-            tracking_ = galileo_e1_dll_pll_veml_make_tracking_cc(
+            tracking_cc = galileo_e1_dll_pll_veml_make_tracking_cc(
                     f_if,
                     fs_in,
                     vector_length,
@@ -88,17 +99,43 @@ GalileoE1DllPllVemlTracking::GalileoE1DllPllVemlTracking(
                     pll_bw_hz,
                     dll_bw_hz,
                     early_late_space_chips,
-                    very_early_late_space_chips);
+                    very_early_late_space_chips,
+                    track_pilot,
+                    loop_arithmetic);
+            if (monitor_taps > 0)
+                {
+                    tracking_cc->set_monitor_taps(monitor_taps, monitor_tap_spacing_chips);
+                }
+            DLOG(INFO) << "tracking(" << tracking_cc->unique_id() << ")";
+        }
+    else if (item_type_.compare("cshort") == 0)
+        {
+            item_size_ = sizeof(lv_16sc_t);
+            tracking_sc = galileo_e1_dll_pll_veml_make_tracking_sc(
+                    f_if,
+                    fs_in,
+                    vector_length,
+                    dump,
+                    dump_filename,
+                    pll_bw_hz,
+                    dll_bw_hz,
+                    early_late_space_chips,
+                    very_early_late_space_chips,
+                    track_pilot,
+                    loop_arithmetic);
+            if (monitor_taps > 0)
+                {
+                    tracking_sc->set_monitor_taps(monitor_taps, monitor_tap_spacing_chips);
+                }
+            DLOG(INFO) << "tracking(" << tracking_sc->unique_id() << ")";
         }
     else
         {
             item_size_ = sizeof(gr_complex);
-            LOG(WARNING) << item_type << " unknown tracking item type.";
+            LOG(WARNING) << item_type_ << " unknown tracking item type.";
         }
 
     channel_ = 0;
-
-    DLOG(INFO) << "tracking(" << tracking_->unique_id() << ")";
 }
 
 GalileoE1DllPllVemlTracking::~GalileoE1DllPllVemlTracking()
@@ -106,7 +143,18 @@ GalileoE1DllPllVemlTracking::~GalileoE1DllPllVemlTracking()
 
 void GalileoE1DllPllVemlTracking::start_tracking()
 {
-    tracking_->start_tracking();
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            tracking_cc->start_tracking();
+        }
+    else if (item_type_.compare("cshort") == 0)
+        {
+            tracking_sc->start_tracking();
+        }
+    else
+        {
+            LOG(WARNING) << item_type_ << " unknown tracking item type";
+        }
 }
 
 /*
@@ -115,13 +163,36 @@ void GalileoE1DllPllVemlTracking::start_tracking()
 void GalileoE1DllPllVemlTracking::set_channel(unsigned int channel)
 {
     channel_ = channel;
-    tracking_->set_channel(channel);
+
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            tracking_cc->set_channel(channel);
+        }
+    else if (item_type_.compare("cshort") == 0)
+        {
+            tracking_sc->set_channel(channel);
+        }
+    else
+        {
+            LOG(WARNING) << item_type_ << " unknown tracking item type";
+        }
 }
 
 
 void GalileoE1DllPllVemlTracking::set_gnss_synchro(Gnss_Synchro* p_gnss_synchro)
 {
-    tracking_->set_gnss_synchro(p_gnss_synchro);
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            tracking_cc->set_gnss_synchro(p_gnss_synchro);
+        }
+    else if (item_type_.compare("cshort") == 0)
+        {
+            tracking_sc->set_gnss_synchro(p_gnss_synchro);
+        }
+    else
+        {
+            LOG(WARNING) << item_type_ << " unknown tracking item type";
+        }
 }
 
 void GalileoE1DllPllVemlTracking::connect(gr::top_block_sptr top_block)
@@ -138,11 +209,35 @@ void GalileoE1DllPllVemlTracking::disconnect(gr::top_block_sptr top_block)
 
 gr::basic_block_sptr GalileoE1DllPllVemlTracking::get_left_block()
 {
-    return tracking_;
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            return tracking_cc;
+        }
+    else if (item_type_.compare("cshort") == 0)
+        {
+            return tracking_sc;
+        }
+    else
+        {
+            LOG(WARNING) << item_type_ << " unknown tracking item type";
+            return nullptr;
+        }
 }
 
 gr::basic_block_sptr GalileoE1DllPllVemlTracking::get_right_block()
 {
-    return tracking_;
+    if (item_type_.compare("gr_complex") == 0)
+        {
+            return tracking_cc;
+        }
+    else if (item_type_.compare("cshort") == 0)
+        {
+            return tracking_sc;
+        }
+    else
+        {
+            LOG(WARNING) << item_type_ << " unknown tracking item type";
+            return nullptr;
+        }
 }
 
@@ -37,13 +37,68 @@
 
 
 #include "gps_l1_ca_dll_pll_tracking.h"
+#include <boost/lexical_cast.hpp>
 #include <glog/logging.h>
 #include "GPS_L1_CA.h"
+#include "configuration_binding.h"
 #include "configuration_interface.h"
 
 
 using google::LogMessage;
 
+struct Gps_L1_Ca_Dll_Pll_Tracking_Params
+{
+    std::string item_type;
+    int f_if;
+    bool dump;
+    std::string dump_filename;  // unused!
+    float pll_bw_hz;
+    float dll_bw_hz;
+    float early_late_space_chips;
+    bool vector_tracking;
+    float vector_pll_bw_hz;
+    float vector_dll_bw_hz;
+    int extend_correlation_ms;
+    float pll_bw_narrow_hz;
+    float dll_bw_narrow_hz;
+    unsigned int channel_group_size;
+    unsigned int channel_group_threads;
+    bool channel_group_shared_correlator;
+    bool replay_pull_in;
+    int monitor_taps;
+    float monitor_tap_spacing_chips;
+    std::string loop_arithmetic;
+};
+
+
+static const Configuration_Binding<Gps_L1_Ca_Dll_Pll_Tracking_Params>& gps_l1_ca_dll_pll_tracking_binding()
+{
+    typedef Gps_L1_Ca_Dll_Pll_Tracking_Params P;
+    static const Configuration_Binding<P> binding = Configuration_Binding<P>()
+            .field("item_type", &P::item_type, std::string("gr_complex"))
+            .field("if", &P::f_if, 0)
+            .field("dump", &P::dump, false)
+            .field("dump_filename", &P::dump_filename, std::string("./track_ch"))
+            .field("pll_bw_hz", &P::pll_bw_hz, 50.0f)
+            .field("dll_bw_hz", &P::dll_bw_hz, 2.0f)
+            .field("early_late_space_chips", &P::early_late_space_chips, 0.5f)
+            .field("vector_tracking", &P::vector_tracking, false)
+            .field("vector_pll_bw_hz", &P::vector_pll_bw_hz, &P::pll_bw_hz)
+            .field("vector_dll_bw_hz", &P::vector_dll_bw_hz, &P::dll_bw_hz)
+            .field("extend_correlation_ms", &P::extend_correlation_ms, 1)
+            .field("pll_bw_narrow_hz", &P::pll_bw_narrow_hz, 20.0f)
+            .field("dll_bw_narrow_hz", &P::dll_bw_narrow_hz, 2.0f)
+            .field("channel_group_size", &P::channel_group_size, 0u)
+            .field("channel_group_threads", &P::channel_group_threads, 1u)
+            .field("channel_group_shared_correlator", &P::channel_group_shared_correlator, false)
+            .field("replay_pull_in", &P::replay_pull_in, false)
+            .field("monitor_taps", &P::monitor_taps, 0)
+            .field("monitor_tap_spacing_chips", &P::monitor_tap_spacing_chips, 0.1f)
+            .field("loop_arithmetic", &P::loop_arithmetic, std::string("float"));
+    return binding;
+}
+
+
 GpsL1CaDllPllTracking::GpsL1CaDllPllTracking(
         ConfigurationInterface* configuration, std::string role,
         unsigned int in_streams, unsigned int out_streams) :
@@ -51,45 +106,53 @@ GpsL1CaDllPllTracking::GpsL1CaDllPllTracking(
 {
     DLOG(INFO) << "role " << role;
     //################# CONFIGURATION PARAMETERS ########################
-    int fs_in;
-    int vector_length;
-    int f_if;
-    bool dump;
-    std::string dump_filename;
-    std::string item_type;
-    std::string default_item_type = "gr_complex";
-    float pll_bw_hz;
-    float dll_bw_hz;
-    float early_late_space_chips;
-    item_type = configuration->property(role + ".item_type", default_item_type);
-    fs_in = configuration->property("GNSS-SDR.internal_fs_hz", 2048000);
-    f_if = configuration->property(role + ".if", 0);
-    dump = configuration->property(role + ".dump", false);
-    pll_bw_hz = configuration->property(role + ".pll_bw_hz", 50.0);
-    dll_bw_hz = configuration->property(role + ".dll_bw_hz", 2.0);
-    early_late_space_chips = configuration->property(role + ".early_late_space_chips", 0.5);
-    std::string default_dump_filename = "./track_ch";
-    dump_filename = configuration->property(role + ".dump_filename", default_dump_filename); //unused!
-    vector_length = std::round(fs_in / (GPS_L1_CA_CODE_RATE_HZ / GPS_L1_CA_CODE_LENGTH_CHIPS));
+    Gps_L1_Ca_Dll_Pll_Tracking_Params params;
+    gps_l1_ca_dll_pll_tracking_binding().load(configuration, role, params);
+    int fs_in = configuration->property("GNSS-SDR.internal_fs_hz", 2048000);
+    int vector_length = std::round(fs_in / (GPS_L1_CA_CODE_RATE_HZ / GPS_L1_CA_CODE_LENGTH_CHIPS));
+    // channels of this role tracked together in one block, 0 or 1 for a block per channel
+    group_size_ = params.channel_group_size;
+    group_threads_ = params.channel_group_threads;
+    group_shared_correlator_ = params.channel_group_shared_correlator;
+    group_port_ = 0;
+    vector_length_ = vector_length;
+    replay_pull_in_ = params.replay_pull_in;
+    configuration_ = configuration;
+    Tracking_Loop_Arithmetic loop_arithmetic = TRACKING_LOOP_FLOAT;
+    if (parse_tracking_loop_arithmetic(params.loop_arithmetic, loop_arithmetic) == false)
+        {
+            LOG(WARNING) << role << ".loop_arithmetic=" << params.loop_arithmetic << " is not float or fixed. Using float";
+        }
 
     //################# MAKE TRACKING GNURadio object ###################
-    if (item_type.compare("gr_complex") == 0)
+    if (params.item_type.compare("gr_complex") == 0)
         {
             item_size_ = sizeof(gr_complex);
             tracking_ = gps_l1_ca_dll_pll_make_tracking_cc(
-                    f_if,
+                    params.f_if,
                     fs_in,
                     vector_length,
-                    dump,
-                    dump_filename,
-                    pll_bw_hz,
-                    dll_bw_hz,
-                    early_late_space_chips);
+                    params.dump,
+                    params.dump_filename,
+                    params.pll_bw_hz,
+                    params.dll_bw_hz,
+                    params.early_late_space_chips,
+                    params.vector_tracking,
+                    params.vector_pll_bw_hz,
+                    params.vector_dll_bw_hz,
+                    params.extend_correlation_ms,
+                    params.pll_bw_narrow_hz,
+                    params.dll_bw_narrow_hz,
+                    loop_arithmetic);
+            if (params.monitor_taps > 0)
+                {
+                    tracking_->set_monitor_taps(params.monitor_taps, params.monitor_tap_spacing_chips);
+                }
         }
     else
         {
             item_size_ = sizeof(gr_complex);
-            LOG(WARNING) << item_type << " unknown tracking item type.";
+            LOG(WARNING) << params.item_type << " unknown tracking item type.";
         }
     channel_ = 0;
     DLOG(INFO) << "tracking(" << tracking_->unique_id() << ")";
@@ -106,6 +169,13 @@ void GpsL1CaDllPllTracking::start_tracking()
 }
 
 
+bool GpsL1CaDllPllTracking::stop_tracking()
+{
+    get_right_block()->_post(pmt::mp(message_port("stop_tracking")), pmt::PMT_T);
+    return true;
+}
+
+
 /*
  * Set tracking channel unique ID
  */
@@ -113,6 +183,22 @@ void GpsL1CaDllPllTracking::set_channel(unsigned int channel)
 {
     channel_ = channel;
     tracking_->set_channel(channel);
+    if (replay_pull_in_ and group_size_ <= 1)
+        {
+            unsigned int rf_channel = configuration_->property("GNSS-SDR.rf_channel_offset", 0u)
+                    + configuration_->property("Channel" + boost::lexical_cast<std::string>(channel) + ".RF_channel_ID", 0);
+            tracking_->set_replay_pull_in(true, rf_channel);
+        }
+    if (group_size_ > 1 and !group_)
+        {
+            // the groups of the other receivers of the process have other keys
+            const std::string group_key = role_ + "@"
+                    + boost::lexical_cast<std::string>(configuration_->property("GNSS-SDR.receiver_index", 0u));
+            group_ = gps_l1_ca_dll_pll_tracking_group_join(group_key, group_size_, group_threads_,
+                    vector_length_, tracking_, group_port_, group_shared_correlator_);
+            DLOG(INFO) << "channel " << channel << " tracked in port " << group_port_
+                       << " of group " << group_->unique_id();
+        }
 }
 
 
@@ -138,12 +224,31 @@ void GpsL1CaDllPllTracking::disconnect(gr::top_block_sptr top_block)
 
 gr::basic_block_sptr GpsL1CaDllPllTracking::get_left_block()
 {
+    if (group_) return group_;
     return tracking_;
 }
 
 
 gr::basic_block_sptr GpsL1CaDllPllTracking::get_right_block()
 {
+    if (group_) return group_;
     return tracking_;
 }
 
+
+int GpsL1CaDllPllTracking::port()
+{
+    return group_port_;
+}
+
+
+std::string GpsL1CaDllPllTracking::message_port(const std::string& name)
+{
+    if (group_ and (name.compare("events") == 0 or name.compare("preamble_timestamp_s") == 0
+            or name.compare("stop_tracking") == 0))
+        {
+            return name + "_" + boost::lexical_cast<std::string>(group_port_);
+        }
+    return name;
+}
+
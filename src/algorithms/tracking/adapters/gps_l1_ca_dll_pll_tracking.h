@@ -41,6 +41,7 @@
 #include <string>
 #include "tracking_interface.h"
 #include "gps_l1_ca_dll_pll_tracking_cc.h"
+#include "gps_l1_ca_dll_pll_tracking_group_cc.h"
 
 
 class ConfigurationInterface;
@@ -92,8 +93,23 @@ public:
 
     void start_tracking();
 
+    //! Posts the stop to the block that runs the channel, which reports it as a loss of lock
+    bool stop_tracking();
+
+    //! The ports of the channel in its tracking group, if any
+    int port();
+    std::string message_port(const std::string& name);
+
 private:
     gps_l1_ca_dll_pll_tracking_cc_sptr tracking_;
+    gps_l1_ca_dll_pll_tracking_group_cc_sptr group_;
+    unsigned int group_size_;
+    unsigned int group_threads_;
+    bool group_shared_correlator_;
+    unsigned int group_port_;
+    unsigned int vector_length_;
+    bool replay_pull_in_;   // not available in tracking groups
+    ConfigurationInterface* configuration_;
     size_t item_size_;
     unsigned int channel_;
     std::string role_;
@@ -36,9 +36,12 @@
 
 
 #include "gps_l1_ca_dll_pll_tracking_gpu.h"
+#include <thread>
+#include <boost/lexical_cast.hpp>
 #include <glog/logging.h>
 #include "GPS_L1_CA.h"
 #include "configuration_interface.h"
+#include "correlator_backend_scheduler.h"
 
 
 using google::LogMessage;
@@ -49,6 +52,7 @@ GpsL1CaDllPllTrackingGPU::GpsL1CaDllPllTrackingGPU(
                 role_(role), in_streams_(in_streams), out_streams_(out_streams)
 {
     DLOG(INFO) << "role " << role;
+    configuration_ = configuration;
     //################# CONFIGURATION PARAMETERS ########################
     int fs_in;
     int vector_length;
@@ -73,6 +77,14 @@ GpsL1CaDllPllTrackingGPU::GpsL1CaDllPllTrackingGPU(
             default_dump_filename); //unused!
     vector_length = std::round(fs_in / (GPS_L1_CA_CODE_RATE_HZ / GPS_L1_CA_CODE_LENGTH_CHIPS));
 
+    // Channels of the GPU tracking blocks that also use the CPU correlators
+    bool scheduler = configuration->property("GNSS-SDR.correlator_scheduler", false);
+    unsigned int gpu_max_channels = configuration->property("GNSS-SDR.correlator_scheduler_gpu_max_channels", 0);
+    unsigned int cpu_max_channels = configuration->property("GNSS-SDR.correlator_scheduler_cpu_max_channels", std::thread::hardware_concurrency());
+    unsigned int rebalance_reports = configuration->property("GNSS-SDR.correlator_scheduler_rebalance_epochs", 1000);
+    double load_limit = configuration->property("GNSS-SDR.correlator_scheduler_load_limit", 0.5);
+    Correlator_Backend_Scheduler::instance().configure(scheduler, gpu_max_channels, cpu_max_channels, rebalance_reports, load_limit);
+
     //################# MAKE TRACKING GNURadio object ###################
     if (item_type.compare("gr_complex") == 0)
         {
@@ -113,6 +125,11 @@ void GpsL1CaDllPllTrackingGPU::set_channel(unsigned int channel)
 {
     channel_ = channel;
     tracking_->set_channel(channel);
+
+    // Channels fed by the same signal conditioner are correlated in the same batches
+    unsigned int rf_channel = configuration_->property("GNSS-SDR.rf_channel_offset", 0u)
+            + configuration_->property("Channel" + boost::lexical_cast<std::string>(channel_) + ".RF_channel_ID", 0);
+    tracking_->set_rf_channel(rf_channel);
 }
 
 void GpsL1CaDllPllTrackingGPU::set_gnss_synchro(Gnss_Synchro* p_gnss_synchro)
@@ -91,6 +91,7 @@ public:
     void start_tracking();
 
 private:
+    ConfigurationInterface* configuration_;
     gps_l1_ca_dll_pll_tracking_gpu_cc_sptr tracking_;
     size_t item_size_;
     unsigned int channel_;
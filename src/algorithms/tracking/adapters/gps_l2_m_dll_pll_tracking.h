@@ -94,8 +94,10 @@ public:
     void start_tracking();
 
 private:
-    gps_l2_m_dll_pll_tracking_cc_sptr tracking_;
+    gps_l2_m_dll_pll_tracking_cc_sptr tracking_cc;
+    gps_l2_m_dll_pll_tracking_sc_sptr tracking_sc;
     size_t item_size_;
+    std::string item_type_;
     unsigned int channel_;
     std::string role_;
     unsigned int in_streams_;
@@ -36,6 +36,7 @@
 
 #include "galileo_e1_dll_pll_veml_tracking_cc.h"
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <sstream>
@@ -44,10 +45,15 @@
 #include <glog/logging.h>
 #include <volk/volk.h>
 #include "galileo_e1_signal_processing.h"
+#include "gnss_code_bank.h"
 #include "tracking_discriminators.h"
 #include "lock_detectors.h"
 #include "Galileo_E1.h"
+#include "acquisition_assistance.h"
 #include "control_message_factory.h"
+#include "gnss_sdr_event_log.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
 
 
 
@@ -72,14 +78,36 @@ galileo_e1_dll_pll_veml_make_tracking_cc(
         float pll_bw_hz,
         float dll_bw_hz,
         float early_late_space_chips,
-        float very_early_late_space_chips)
+        float very_early_late_space_chips,
+        bool track_pilot,
+        Tracking_Loop_Arithmetic loop_arithmetic)
 {
-    return galileo_e1_dll_pll_veml_tracking_cc_sptr(new galileo_e1_dll_pll_veml_tracking_cc(if_freq,
-            fs_in, vector_length, dump, dump_filename, pll_bw_hz, dll_bw_hz, early_late_space_chips, very_early_late_space_chips));
+    return galileo_e1_dll_pll_veml_tracking_cc_sptr(new galileo_e1_dll_pll_veml_tracking_cc("galileo_e1_dll_pll_veml_tracking_cc", if_freq,
+            fs_in, vector_length, dump, dump_filename, pll_bw_hz, dll_bw_hz, early_late_space_chips, very_early_late_space_chips, track_pilot, loop_arithmetic));
 }
 
 
-void galileo_e1_dll_pll_veml_tracking_cc::forecast (int noutput_items,
+galileo_e1_dll_pll_veml_tracking_sc_sptr
+galileo_e1_dll_pll_veml_make_tracking_sc(
+        long if_freq,
+        long fs_in,
+        unsigned int vector_length,
+        bool dump,
+        std::string dump_filename,
+        float pll_bw_hz,
+        float dll_bw_hz,
+        float early_late_space_chips,
+        float very_early_late_space_chips,
+        bool track_pilot,
+        Tracking_Loop_Arithmetic loop_arithmetic)
+{
+    return galileo_e1_dll_pll_veml_tracking_sc_sptr(new galileo_e1_dll_pll_veml_tracking_sc("galileo_e1_dll_pll_veml_tracking_sc", if_freq,
+            fs_in, vector_length, dump, dump_filename, pll_bw_hz, dll_bw_hz, early_late_space_chips, very_early_late_space_chips, track_pilot, loop_arithmetic));
+}
+
+
+template <class Sample>
+void galileo_e1_dll_pll_veml_tracking<Sample>::forecast (int noutput_items,
         gr_vector_int &ninput_items_required)
 {
     if (noutput_items != 0)
@@ -89,7 +117,9 @@ void galileo_e1_dll_pll_veml_tracking_cc::forecast (int noutput_items,
 }
 
 
-galileo_e1_dll_pll_veml_tracking_cc::galileo_e1_dll_pll_veml_tracking_cc(
+template <class Sample>
+galileo_e1_dll_pll_veml_tracking<Sample>::galileo_e1_dll_pll_veml_tracking(
+        const std::string& name,
         long if_freq,
         long fs_in,
         unsigned int vector_length,
@@ -98,9 +128,15 @@ galileo_e1_dll_pll_veml_tracking_cc::galileo_e1_dll_pll_veml_tracking_cc(
         float pll_bw_hz,
         float dll_bw_hz,
         float early_late_space_chips,
-        float very_early_late_space_chips):
-        gr::block("galileo_e1_dll_pll_veml_tracking_cc", gr::io_signature::make(1, 1, sizeof(gr_complex)),
-                gr::io_signature::make(1, 1, sizeof(Gnss_Synchro)))
+        float very_early_late_space_chips,
+        bool track_pilot,
+        Tracking_Loop_Arithmetic loop_arithmetic):
+        gr::block(name, gr::io_signature::make(1, 1, sizeof(Sample)),
+                gr::io_signature::make(1, 1, sizeof(Gnss_Synchro))),
+        d_track_pilot(track_pilot),
+        d_engine(make_tracking_engine<Galileo_E1_Tracking_Traits, Sample>(loop_arithmetic,
+                fs_in, 2 * vector_length, early_late_space_chips, very_early_late_space_chips, track_pilot)),
+        d_dump_file("galileo_e1_veml_tracking")
 {
     // Telemetry bit synchronization message port input
     this->message_port_register_in(pmt::mp("preamble_timestamp_s"));
@@ -123,47 +159,7 @@ galileo_e1_dll_pll_veml_tracking_cc::galileo_e1_dll_pll_veml_tracking_cc(
     d_code_loop_filter.set_DLL_BW(dll_bw_hz);
     d_carrier_loop_filter.set_PLL_BW(pll_bw_hz);
 
-    // Correlator spacing
-    d_early_late_spc_chips = early_late_space_chips; // Define early-late offset (in chips)
-    d_very_early_late_spc_chips = very_early_late_space_chips; // Define very-early-late offset (in chips)
-
-    // Initialization of local code replica
-    // Get space for a vector with the sinboc(1,1) replica sampled 2x/chip
-    d_ca_code = static_cast<gr_complex*>(volk_malloc((2 * Galileo_E1_B_CODE_LENGTH_CHIPS) * sizeof(gr_complex), volk_get_alignment()));
-
-    // correlator outputs (scalar)
-    d_n_correlator_taps = 5; // Very-Early, Early, Prompt, Late, Very-Late
-    d_correlator_outs = static_cast<gr_complex*>(volk_malloc(d_n_correlator_taps * sizeof(gr_complex), volk_get_alignment()));
-    for (int n = 0; n < d_n_correlator_taps; n++)
-        {
-            d_correlator_outs[n] = gr_complex(0,0);
-        }
-    // map memory pointers of correlator outputs
-    d_Very_Early = &d_correlator_outs[0];
-    d_Early = &d_correlator_outs[1];
-    d_Prompt = &d_correlator_outs[2];
-    d_Late = &d_correlator_outs[3];
-    d_Very_Late = &d_correlator_outs[4];
-
-    d_local_code_shift_chips = static_cast<float*>(volk_malloc(d_n_correlator_taps * sizeof(float), volk_get_alignment()));
-    // Set TAPs delay values [chips]
-    d_local_code_shift_chips[0] = - d_very_early_late_spc_chips * 2.0;
-    d_local_code_shift_chips[1] = - d_very_early_late_spc_chips;
-    d_local_code_shift_chips[2] = 0.0;
-    d_local_code_shift_chips[3] = d_very_early_late_spc_chips;
-    d_local_code_shift_chips[4] = d_very_early_late_spc_chips * 2.0;
-
-    d_correlation_length_samples = d_vector_length;
-
-    multicorrelator_cpu.init(2 * d_correlation_length_samples, d_n_correlator_taps);
-
-    //--- Initializations ------------------------------
-    // Initial code frequency basis of NCO
-    d_code_freq_chips = static_cast<double>(Galileo_E1_CODE_CHIP_RATE_HZ);
-    // Residual code phase (in chips)
-    d_rem_code_phase_samples = 0.0;
-    // Residual carrier phase
-    d_rem_carr_phase_rad = 0.0;
+    d_profile = Gnss_Sdr_Tracking_Profiler::profile(name);
 
     // sample synchronization
     d_sample_counter = 0;
@@ -173,8 +169,6 @@ galileo_e1_dll_pll_veml_tracking_cc::galileo_e1_dll_pll_veml_tracking_cc(
     d_enable_tracking = false;
     d_pull_in = false;
 
-    d_current_prn_length_samples = static_cast<int>(d_vector_length);
-
     // CN0 estimation and lock detector buffers
     d_cn0_estimation_counter = 0;
     d_Prompt_buffer = new gr_complex[CN0_ESTIMATION_SAMPLES];
@@ -184,22 +178,15 @@ galileo_e1_dll_pll_veml_tracking_cc::galileo_e1_dll_pll_veml_tracking_cc(
     d_carrier_lock_threshold = CARRIER_LOCK_THRESHOLD;
 
     systemName["E"] = std::string("Galileo");
-    *d_Very_Early = gr_complex(0,0);
-    *d_Early = gr_complex(0,0);
-    *d_Prompt = gr_complex(0,0);
-    *d_Late = gr_complex(0,0);
-    *d_Very_Late = gr_complex(0,0);
 
     d_acquisition_gnss_synchro = 0;
     d_channel = 0;
     d_acq_code_phase_samples = 0.0;
     d_acq_carrier_doppler_hz = 0.0;
-    d_carrier_doppler_hz = 0.0;
-    d_acc_carrier_phase_rad = 0.0;
-    d_acc_code_phase_secs = 0.0;
 }
 
-void galileo_e1_dll_pll_veml_tracking_cc::start_tracking()
+template <class Sample>
+void galileo_e1_dll_pll_veml_tracking<Sample>::start_tracking()
 {
     d_acq_code_phase_samples = d_acquisition_gnss_synchro->Acq_delay_samples;
     d_acq_carrier_doppler_hz = d_acquisition_gnss_synchro->Acq_doppler_hz;
@@ -209,72 +196,75 @@ void galileo_e1_dll_pll_veml_tracking_cc::start_tracking()
     d_carrier_loop_filter.initialize(); // initialize the carrier filter
     d_code_loop_filter.initialize();    // initialize the code filter
 
-    // generate local reference ALWAYS starting at chip 1 (2 samples per chip)
-    galileo_e1_code_gen_complex_sampled(d_ca_code,
-                                        d_acquisition_gnss_synchro->Signal,
-                                        false,
-                                        d_acquisition_gnss_synchro->PRN,
-                                        2 * Galileo_E1_CODE_CHIP_RATE_HZ,
-                                        0);
+    // generate local reference ALWAYS starting at chip 1 (2 samples per chip),
+    // or take it from the code bank if the PRN was already generated
+    char signal_str[3];
+    std::memcpy(signal_str, d_acquisition_gnss_synchro->Signal, 3);
+    unsigned int prn = d_acquisition_gnss_synchro->PRN;
+    Gnss_Code_Bank::instance().copy(d_engine->local_code(), std::string(signal_str, 2), prn,
+            2 * Galileo_E1_CODE_CHIP_RATE_HZ, 0, static_cast<unsigned int>(2 * Galileo_E1_B_CODE_LENGTH_CHIPS),
+            [signal_str, prn](gr_complex* dest) mutable
+            {
+                galileo_e1_code_gen_complex_sampled(dest, signal_str, false, prn, 2 * Galileo_E1_CODE_CHIP_RATE_HZ, 0);
+            });
 
-    multicorrelator_cpu.set_local_code_and_taps(static_cast<int>(2 * Galileo_E1_B_CODE_LENGTH_CHIPS), d_ca_code, d_local_code_shift_chips);
-    for (int n = 0; n < d_n_correlator_taps; n++)
+    if (d_track_pilot)
         {
-            d_correlator_outs[n] = gr_complex(0,0);
+            // the E1-C primary code, without its secondary code, which the
+            // Costas discriminator does not see within one code period
+            char pilot_signal_str[3] = {'1', 'C', '\0'};
+            Gnss_Code_Bank::instance().copy(d_engine->pilot_code(), std::string(pilot_signal_str, 2), prn,
+                    2 * Galileo_E1_CODE_CHIP_RATE_HZ, 0, static_cast<unsigned int>(2 * Galileo_E1_B_CODE_LENGTH_CHIPS),
+                    [pilot_signal_str, prn](gr_complex* dest) mutable
+                    {
+                        galileo_e1_code_gen_complex_sampled(dest, pilot_signal_str, false, prn, 2 * Galileo_E1_CODE_CHIP_RATE_HZ, 0);
+                    });
         }
+    d_engine->start(d_acq_carrier_doppler_hz, d_acq_code_phase_samples);
 
     d_carrier_lock_fail_counter = 0;
-    d_rem_code_phase_samples = 0.0;
-    d_rem_carr_phase_rad = 0.0;
-    d_acc_carrier_phase_rad = 0.0;
-
-    d_acc_code_phase_secs = 0.0;
-    d_carrier_doppler_hz = d_acq_carrier_doppler_hz;
-    d_current_prn_length_samples = d_vector_length;
 
     std::string sys_ = &d_acquisition_gnss_synchro->System;
     sys = sys_.substr(0, 1);
 
     // DEBUG OUTPUT
-    std::cout << "Tracking start on channel " << d_channel << " for satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN) << std::endl;
-    LOG(INFO) << "Starting tracking of satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN) << " on channel " << d_channel;
+    Gnss_Sdr_Event_Log::tracking_start(d_channel, d_acquisition_gnss_synchro->System, d_acquisition_gnss_synchro->PRN);
 
     // enable tracking
     d_pull_in = true;
     d_enable_tracking = true;
 
-    LOG(INFO) << "PULL-IN Doppler [Hz]=" << d_carrier_doppler_hz
+    LOG(INFO) << "PULL-IN Doppler [Hz]=" << d_engine->carrier_doppler_hz()
               << " PULL-IN Code Phase [samples]=" << d_acq_code_phase_samples;
 }
 
-galileo_e1_dll_pll_veml_tracking_cc::~galileo_e1_dll_pll_veml_tracking_cc()
+template <class Sample>
+galileo_e1_dll_pll_veml_tracking<Sample>::~galileo_e1_dll_pll_veml_tracking()
 {
     d_dump_file.close();
 
-    volk_free(d_local_code_shift_chips);
-    volk_free(d_correlator_outs);
-    volk_free(d_ca_code);
-
     delete[] d_Prompt_buffer;
-    multicorrelator_cpu.free();
 }
 
 
 
-int galileo_e1_dll_pll_veml_tracking_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
+template <class Sample>
+int galileo_e1_dll_pll_veml_tracking<Sample>::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
         gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("galileo_e1_dll_pll_veml_tracking::general_work", d_channel, d_acquisition_gnss_synchro ? d_acquisition_gnss_synchro->PRN : 0);
     double carr_error_hz = 0.0;
     double carr_error_filt_hz = 0.0;
     double code_error_chips = 0.0;
     double code_error_filt_chips = 0.0;
 
     // Block input data and block output stream pointers
-    const gr_complex* in = (gr_complex*) input_items[0];
+    const Sample* in = (const Sample*) input_items[0];
     Gnss_Synchro **out = (Gnss_Synchro **) &output_items[0];
     // GNSS_SYNCHRO OBJECT to interchange data between tracking->telemetry_decoder
     Gnss_Synchro current_synchro_data = Gnss_Synchro();
 
+    if (d_profile) d_profile->start();
     if (d_enable_tracking == true)
         {
             // Fill the acquisition data
@@ -288,9 +278,9 @@ int galileo_e1_dll_pll_veml_tracking_cc::general_work (int noutput_items __attri
                     double acq_trk_shif_correction_samples;
                     int acq_to_trk_delay_samples;
                     acq_to_trk_delay_samples = d_sample_counter - d_acq_sample_stamp;
-                    acq_trk_shif_correction_samples = d_current_prn_length_samples - std::fmod(static_cast<double>(acq_to_trk_delay_samples), static_cast<double>(d_current_prn_length_samples));
+                    acq_trk_shif_correction_samples = d_engine->current_prn_length_samples() - std::fmod(static_cast<double>(acq_to_trk_delay_samples), static_cast<double>(d_engine->current_prn_length_samples()));
                     samples_offset = std::round(d_acq_code_phase_samples + acq_trk_shif_correction_samples);
-                    current_synchro_data.Tracking_timestamp_secs = (static_cast<double>(d_sample_counter) + static_cast<double>(d_rem_code_phase_samples)) / static_cast<double>(d_fs_in);
+                    current_synchro_data.set_sample_stamp(d_sample_counter, d_engine->rem_code_phase_samples(), static_cast<double>(d_fs_in));
                     *out[0] = current_synchro_data;
                     d_sample_counter = d_sample_counter + samples_offset; //count for the processed samples
                     d_pull_in = false;
@@ -299,64 +289,34 @@ int galileo_e1_dll_pll_veml_tracking_cc::general_work (int noutput_items __attri
                 }
 
             // ################# CARRIER WIPEOFF AND CORRELATORS ##############################
-            // perform carrier wipe-off and compute Early, Prompt and Late correlation
-            multicorrelator_cpu.set_input_output_vectors(d_correlator_outs,in);
-
-            double carr_phase_step_rad = GALILEO_TWO_PI * d_carrier_doppler_hz / static_cast<double>(d_fs_in);
-            double code_phase_step_half_chips = (2.0 * d_code_freq_chips) / (static_cast<double>(d_fs_in));
-            double rem_code_phase_half_chips = d_rem_code_phase_samples * (2.0*d_code_freq_chips / d_fs_in);
-            multicorrelator_cpu.Carrier_wipeoff_multicorrelator_resampler(
-                    d_rem_carr_phase_rad,
-                    carr_phase_step_rad,
-                    rem_code_phase_half_chips,
-                    code_phase_step_half_chips,
-                    d_correlation_length_samples);
+            // perform carrier wipe-off and compute Very Early, Early, Prompt, Late and Very Late correlation
+            d_engine->correlate(in);
+            if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::correlation);
 
-            // ################## PLL ##########################################################
             // PLL discriminator
-            carr_error_hz = pll_cloop_two_quadrant_atan(*d_Prompt) / GALILEO_TWO_PI;
+            carr_error_hz = d_engine->carrier_error_cycles();
+            // DLL discriminator
+            const gr_complex* taps = d_engine->taps();
+            code_error_chips = dll_nc_vemlp_normalized(taps[0], taps[1], taps[3], taps[4]); //[chips/Ti]
+            if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::discriminators);
+
+            // ################## PLL ##########################################################
             // Carrier discriminator filter
             carr_error_filt_hz = d_carrier_loop_filter.get_carrier_nco(carr_error_hz);
-            // New carrier Doppler frequency estimation
-            d_carrier_doppler_hz = d_acq_carrier_doppler_hz + carr_error_filt_hz;
-            // New code Doppler frequency estimation
-            d_code_freq_chips = Galileo_E1_CODE_CHIP_RATE_HZ + ((d_carrier_doppler_hz * Galileo_E1_CODE_CHIP_RATE_HZ) / Galileo_E1_FREQ_HZ);
-            //carrier phase accumulator for (K) Doppler estimation-
-            d_acc_carrier_phase_rad -= GALILEO_TWO_PI * d_carrier_doppler_hz * static_cast<double>(d_current_prn_length_samples) / static_cast<double>(d_fs_in);
-            //remnant carrier phase to prevent overflow in the code NCO
-            d_rem_carr_phase_rad = d_rem_carr_phase_rad + GALILEO_TWO_PI * d_carrier_doppler_hz * static_cast<double>(d_current_prn_length_samples) / static_cast<double>(d_fs_in);
-            d_rem_carr_phase_rad = std::fmod(d_rem_carr_phase_rad, GALILEO_TWO_PI);
 
             // ################## DLL ##########################################################
-            // DLL discriminator
-            code_error_chips = dll_nc_vemlp_normalized(*d_Very_Early, *d_Early, *d_Late, *d_Very_Late); //[chips/Ti]
             // Code discriminator filter
             code_error_filt_chips = d_code_loop_filter.get_code_nco(code_error_chips); //[chips/second]
-            //Code phase accumulator
-            double code_error_filt_secs;
-            code_error_filt_secs = (Galileo_E1_CODE_PERIOD * code_error_filt_chips) / Galileo_E1_CODE_CHIP_RATE_HZ; //[seconds]
-            //code_error_filt_secs=T_prn_seconds*code_error_filt_chips*T_chip_seconds*static_cast<float>(d_fs_in); //[seconds]
-            d_acc_code_phase_secs = d_acc_code_phase_secs  + code_error_filt_secs;
-
-            // ################## CARRIER AND CODE NCO BUFFER ALIGNEMENT #######################
-            // keep alignment parameters for the next input buffer
-            double T_chip_seconds;
-            double T_prn_seconds;
-            double T_prn_samples;
-            double K_blk_samples;
-            // Compute the next buffer length based in the new period of the PRN sequence and the code phase error estimation
-            T_chip_seconds = 1.0 / d_code_freq_chips;
-            T_prn_seconds = T_chip_seconds * Galileo_E1_B_CODE_LENGTH_CHIPS;
-            T_prn_samples = T_prn_seconds * static_cast<double>(d_fs_in);
-            K_blk_samples = T_prn_samples + d_rem_code_phase_samples + code_error_filt_secs * static_cast<double>(d_fs_in);
-            d_current_prn_length_samples = std::round(K_blk_samples); //round to a discrete samples
-            //d_rem_code_phase_samples = K_blk_samples - d_current_prn_length_samples; //rounding error < 1 sample
+
+            // ################## CARRIER AND CODE NCOS #######################################
+            d_engine->update(d_acq_carrier_doppler_hz + carr_error_filt_hz, code_error_filt_chips);
+            if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::loop_filters);
 
             // ####### CN0 ESTIMATION AND LOCK DETECTORS ######
             if (d_cn0_estimation_counter < CN0_ESTIMATION_SAMPLES)
                 {
                     // fill buffer with prompt correlator output values
-                    d_Prompt_buffer[d_cn0_estimation_counter] = *d_Prompt;
+                    d_Prompt_buffer[d_cn0_estimation_counter] = d_engine->prompt();
                     d_cn0_estimation_counter++;
                 }
             else
@@ -380,38 +340,36 @@ int galileo_e1_dll_pll_veml_tracking_cc::general_work (int noutput_items __attri
                         }
                     if (d_carrier_lock_fail_counter > MAXIMUM_LOCK_FAIL_COUNTER)
                         {
-                            std::cout << "Loss of lock in channel " << d_channel << "!" << std::endl;
-                            LOG(INFO) << "Loss of lock in channel " << d_channel << "!";
+                            Gnss_Sdr_Event_Log::loss_of_lock(d_channel);
                             this->message_port_pub(pmt::mp("events"), pmt::from_long(3));//3 -> loss of lock
                             d_carrier_lock_fail_counter = 0;
+                            Acquisition_Assistance::withdraw_tracking(current_synchro_data);
                             d_enable_tracking = false; // TODO: check if disabling tracking is consistent with the channel state machine
                         }
                 }
+            if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::lock_detectors);
 
             // ########### Output the tracking results to Telemetry block ##########
 
-            current_synchro_data.Prompt_I = static_cast<double>((*d_Prompt).real());
-            current_synchro_data.Prompt_Q = static_cast<double>((*d_Prompt).imag());
+            current_synchro_data.Prompt_I = static_cast<double>(d_engine->data_prompt().real());
+            current_synchro_data.Prompt_Q = static_cast<double>(d_engine->data_prompt().imag());
             // Tracking_timestamp_secs is aligned with the CURRENT PRN start sample (Hybridization OK!)
-            current_synchro_data.Tracking_timestamp_secs = (static_cast<double>(d_sample_counter) + static_cast<double>(d_rem_code_phase_samples)) / static_cast<double>(d_fs_in);
-            //compute remnant code phase samples AFTER the Tracking timestamp
-            d_rem_code_phase_samples = K_blk_samples - d_current_prn_length_samples; //rounding error < 1 sample
+            current_synchro_data.set_sample_stamp(d_sample_counter, d_engine->period_start_rem_samples(), static_cast<double>(d_fs_in));
             // This tracking block aligns the Tracking_timestamp_secs with the start sample of the PRN, thus, Code_phase_secs=0
             current_synchro_data.Code_phase_secs = 0;
-            current_synchro_data.Carrier_phase_rads = d_acc_carrier_phase_rad;
-            current_synchro_data.Carrier_Doppler_hz = d_carrier_doppler_hz;
+            current_synchro_data.Carrier_phase_rads = d_engine->acc_carrier_phase_rad();
+            current_synchro_data.Carrier_Doppler_hz = d_engine->carrier_doppler_hz();
             current_synchro_data.CN0_dB_hz = d_CN0_SNV_dB_Hz;
+            if (d_enable_tracking) Acquisition_Assistance::publish_tracking(current_synchro_data);
             current_synchro_data.Flag_valid_symbol_output = true;
             current_synchro_data.correlation_length_ms = 4;
 
         }
     else
     {
-        *d_Early = gr_complex(0,0);
-        *d_Prompt = gr_complex(0,0);
-        *d_Late = gr_complex(0,0);
+        d_engine->clear_outputs();
         // GNSS_SYNCHRO OBJECT to interchange data between tracking->telemetry_decoder
-        current_synchro_data.Tracking_timestamp_secs = (static_cast<double>(d_sample_counter) + static_cast<double>(d_rem_code_phase_samples)) / static_cast<double>(d_fs_in);
+        current_synchro_data.set_sample_stamp(d_sample_counter, d_engine->rem_code_phase_samples(), static_cast<double>(d_fs_in));
     }
     //assign the GNURadio block output data
     current_synchro_data.System = {'E'};
@@ -423,75 +381,54 @@ int galileo_e1_dll_pll_veml_tracking_cc::general_work (int noutput_items __attri
     if(d_dump)
         {
             // Dump results to file
-            float prompt_I;
-            float prompt_Q;
-            float tmp_VE, tmp_E, tmp_P, tmp_L, tmp_VL;
-            float tmp_float;
-            double tmp_double;
-            prompt_I = (*d_Prompt).real();
-            prompt_Q = (*d_Prompt).imag();
-            tmp_VE = std::abs<float>(*d_Very_Early);
-            tmp_E = std::abs<float>(*d_Early);
-            tmp_P = std::abs<float>(*d_Prompt);
-            tmp_L = std::abs<float>(*d_Late);
-            tmp_VL = std::abs<float>(*d_Very_Late);
-
-            try
-            {
-                    // Dump correlators output
-                    d_dump_file.write(reinterpret_cast<char*>(&tmp_VE), sizeof(float));
-                    d_dump_file.write(reinterpret_cast<char*>(&tmp_E), sizeof(float));
-                    d_dump_file.write(reinterpret_cast<char*>(&tmp_P), sizeof(float));
-                    d_dump_file.write(reinterpret_cast<char*>(&tmp_L), sizeof(float));
-                    d_dump_file.write(reinterpret_cast<char*>(&tmp_VL), sizeof(float));
-                    // PROMPT I and Q (to analyze navigation symbols)
-                    d_dump_file.write(reinterpret_cast<char*>(&prompt_I), sizeof(float));
-                    d_dump_file.write(reinterpret_cast<char*>(&prompt_Q), sizeof(float));
-                    // PRN start sample stamp
-                    d_dump_file.write(reinterpret_cast<char*>(&d_sample_counter), sizeof(unsigned long int));
-                    // accumulated carrier phase
-                    tmp_float = d_acc_carrier_phase_rad;
-                    d_dump_file.write(reinterpret_cast<char*>(&tmp_float), sizeof(float));
-                    // carrier and code frequency
-                    tmp_float = d_carrier_doppler_hz;
-                    d_dump_file.write(reinterpret_cast<char*>(&tmp_float), sizeof(float));
-                    tmp_float = d_code_freq_chips;
-                    d_dump_file.write(reinterpret_cast<char*>(&tmp_float), sizeof(float));
-                    //PLL commands
-                    tmp_float = carr_error_hz;
-                    d_dump_file.write(reinterpret_cast<char*>(&tmp_float), sizeof(float));
-                    tmp_float = carr_error_filt_hz;
-                    d_dump_file.write(reinterpret_cast<char*>(&tmp_float), sizeof(float));
-                    //DLL commands
-                    tmp_float = code_error_chips;
-                    d_dump_file.write(reinterpret_cast<char*>(&tmp_float), sizeof(float));
-                    tmp_float = code_error_filt_chips;
-                    d_dump_file.write(reinterpret_cast<char*>(&tmp_float), sizeof(float));
-                    // CN0 and carrier lock test
-                    tmp_float = d_CN0_SNV_dB_Hz;
-                    d_dump_file.write(reinterpret_cast<char*>(&tmp_float), sizeof(float));
-                    tmp_float = d_carrier_lock_test;
-                    d_dump_file.write(reinterpret_cast<char*>(&tmp_float), sizeof(float));
-                    // AUX vars (for debug purposes)
-                    tmp_float = d_rem_code_phase_samples;
-                    d_dump_file.write(reinterpret_cast<char*>(&tmp_float), sizeof(float));
-                    tmp_double = static_cast<double>(d_sample_counter + d_current_prn_length_samples);
-                    d_dump_file.write(reinterpret_cast<char*>(&tmp_double), sizeof(double));
-            }
-            catch (const std::ifstream::failure &e)
-            {
-                    LOG(WARNING) << "Exception writing trk dump file " << e.what() << std::endl;
-            }
+            // Correlators output
+            for (int n = 0; n < d_engine->n_taps; n++)
+                {
+                    d_dump_file.write(std::abs<float>(d_engine->taps()[n]));
+                }
+            // PROMPT I and Q (to analyze navigation symbols)
+            d_dump_file.write(d_engine->prompt().real());
+            d_dump_file.write(d_engine->prompt().imag());
+            // PRN start sample stamp
+            d_dump_file.write(d_sample_counter);
+            // accumulated carrier phase
+            d_dump_file.write(d_engine->acc_carrier_phase_rad());
+            // carrier and code frequency
+            d_dump_file.write(d_engine->carrier_doppler_hz());
+            d_dump_file.write(d_engine->code_freq_chips());
+            //PLL commands
+            d_dump_file.write(carr_error_hz);
+            d_dump_file.write(carr_error_filt_hz);
+            //DLL commands
+            d_dump_file.write(code_error_chips);
+            d_dump_file.write(code_error_filt_chips);
+            // CN0 and carrier lock test
+            d_dump_file.write(d_CN0_SNV_dB_Hz);
+            d_dump_file.write(d_carrier_lock_test);
+            // AUX vars (for debug purposes)
+            d_dump_file.write(d_engine->rem_code_phase_samples());
+            d_dump_file.write(static_cast<double>(d_sample_counter + d_engine->current_prn_length_samples()));
+            // Output to telemetry, enough to replay the back end from the dump
+            d_dump_file.write(current_synchro_data.PRN);
+            d_dump_file.write(current_synchro_data.Tracking_timestamp_secs);
+            d_dump_file.write(current_synchro_data.Flag_valid_symbol_output);
+            d_dump_file.write(current_synchro_data.correlation_length_ms);
+            if (d_engine->n_monitor_taps() > 0)
+                {
+                    d_dump_file.write_array(reinterpret_cast<const float*>(d_engine->monitor_outputs()), 2 * d_engine->n_monitor_taps());
+                }
         }
-    consume_each(d_current_prn_length_samples); // this is required for gr_block derivates
-    d_sample_counter += d_current_prn_length_samples; //count for the processed samples
+    consume_each(d_engine->current_prn_length_samples()); // this is required for gr_block derivates
+    d_sample_counter += d_engine->current_prn_length_samples(); //count for the processed samples
+    if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::output);
 
     return 1; //output tracking result ALWAYS even in the case of d_enable_tracking==false
 }
 
 
 
-void galileo_e1_dll_pll_veml_tracking_cc::set_channel(unsigned int channel)
+template <class Sample>
+void galileo_e1_dll_pll_veml_tracking<Sample>::set_channel(unsigned int channel)
 {
     d_channel = channel;
     LOG(INFO) << "Tracking Channel set to " << d_channel;
@@ -500,18 +437,39 @@ void galileo_e1_dll_pll_veml_tracking_cc::set_channel(unsigned int channel)
         {
             if (d_dump_file.is_open() == false)
                 {
-                    try
-                    {
-                            d_dump_filename.append(boost::lexical_cast<std::string>(d_channel));
-                            d_dump_filename.append(".dat");
-                            d_dump_file.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-                            d_dump_file.open(d_dump_filename.c_str(), std::ios::out | std::ios::binary);
+                    d_dump_filename.append(boost::lexical_cast<std::string>(d_channel));
+                    d_dump_filename.append(".dat");
+                    d_dump_file.add_field("abs_VE", BINARY_DUMP_FLOAT32);
+                    d_dump_file.add_field("abs_E", BINARY_DUMP_FLOAT32);
+                    d_dump_file.add_field("abs_P", BINARY_DUMP_FLOAT32);
+                    d_dump_file.add_field("abs_L", BINARY_DUMP_FLOAT32);
+                    d_dump_file.add_field("abs_VL", BINARY_DUMP_FLOAT32);
+                    d_dump_file.add_field("prompt_I", BINARY_DUMP_FLOAT32);
+                    d_dump_file.add_field("prompt_Q", BINARY_DUMP_FLOAT32);
+                    d_dump_file.add_field("PRN_start_sample_count", BINARY_DUMP_UINT64);
+                    d_dump_file.add_field("acc_carrier_phase_rad", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("carrier_doppler_hz", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("code_freq_chips", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("carr_error_hz", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("carr_nco_hz", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("code_error_chips", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("code_nco_chips", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("CN0_SNV_dB_Hz", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("carrier_lock_test", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("rem_code_phase_samples", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("next_PRN_start_sample", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("PRN", BINARY_DUMP_UINT32);
+                    d_dump_file.add_field("tracking_timestamp_secs", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("valid_symbol", BINARY_DUMP_UINT8);
+                    d_dump_file.add_field("correlation_length_ms", BINARY_DUMP_UINT32);
+                    if (d_engine->n_monitor_taps() > 0)
+                        {
+                            d_dump_file.add_field("monitor_IQ", BINARY_DUMP_FLOAT32, 2 * d_engine->n_monitor_taps());
+                        }
+                    if (d_dump_file.open(d_dump_filename))
+                        {
                             LOG(INFO) << "Tracking dump enabled on channel " << d_channel << " Log file: " << d_dump_filename.c_str();
-                    }
-                    catch (const std::ifstream::failure &e)
-                    {
-                            LOG(WARNING) << "channel " << d_channel << " Exception opening trk dump file " << e.what() << std::endl;
-                    }
+                        }
                 }
         }
 }
@@ -519,7 +477,19 @@ void galileo_e1_dll_pll_veml_tracking_cc::set_channel(unsigned int channel)
 
 
 
-void galileo_e1_dll_pll_veml_tracking_cc::set_gnss_synchro(Gnss_Synchro* p_gnss_synchro)
+template <class Sample>
+void galileo_e1_dll_pll_veml_tracking<Sample>::set_gnss_synchro(Gnss_Synchro* p_gnss_synchro)
 {
     d_acquisition_gnss_synchro = p_gnss_synchro;
 }
+
+
+template <class Sample>
+void galileo_e1_dll_pll_veml_tracking<Sample>::set_monitor_taps(int n_taps, float spacing_chips)
+{
+    d_engine->set_monitor_taps(n_taps, spacing_chips);
+}
+
+
+template class galileo_e1_dll_pll_veml_tracking<gr_complex>;
+template class galileo_e1_dll_pll_veml_tracking<lv_16sc_t>;
@@ -32,19 +32,30 @@
 #ifndef GNSS_SDR_GALILEO_E1_DLL_PLL_VEML_TRACKING_CC_H
 #define GNSS_SDR_GALILEO_E1_DLL_PLL_VEML_TRACKING_CC_H
 
-#include <fstream>
 #include <string>
 #include <map>
+#include <memory>
 #include <gnuradio/block.h>
+#include "binary_dump_writer.h"
 #include "gnss_synchro.h"
 #include "tracking_2nd_DLL_filter.h"
 #include "tracking_2nd_PLL_filter.h"
-#include "cpu_multicorrelator.h"
+#include "tracking_engine.h"
+#include "gnss_sdr_tracking_profiler.h"
 
-class galileo_e1_dll_pll_veml_tracking_cc;
+template <class Sample>
+class galileo_e1_dll_pll_veml_tracking;
+
+//! Tracking block for gr_complex samples
+typedef galileo_e1_dll_pll_veml_tracking<gr_complex> galileo_e1_dll_pll_veml_tracking_cc;
+
+//! Tracking block for lv_16sc_t samples
+typedef galileo_e1_dll_pll_veml_tracking<lv_16sc_t> galileo_e1_dll_pll_veml_tracking_sc;
 
 typedef boost::shared_ptr<galileo_e1_dll_pll_veml_tracking_cc> galileo_e1_dll_pll_veml_tracking_cc_sptr;
 
+typedef boost::shared_ptr<galileo_e1_dll_pll_veml_tracking_sc> galileo_e1_dll_pll_veml_tracking_sc_sptr;
+
 galileo_e1_dll_pll_veml_tracking_cc_sptr
 galileo_e1_dll_pll_veml_make_tracking_cc(long if_freq,
                                    long fs_in, unsigned
@@ -54,21 +65,50 @@ galileo_e1_dll_pll_veml_make_tracking_cc(long if_freq,
                                    float pll_bw_hz,
                                    float dll_bw_hz,
                                    float early_late_space_chips,
-                                   float very_early_late_space_chips);
+                                   float very_early_late_space_chips,
+                                   bool track_pilot,
+                                   Tracking_Loop_Arithmetic loop_arithmetic);
+
+galileo_e1_dll_pll_veml_tracking_sc_sptr
+galileo_e1_dll_pll_veml_make_tracking_sc(long if_freq,
+                                   long fs_in, unsigned
+                                   int vector_length,
+                                   bool dump,
+                                   std::string dump_filename,
+                                   float pll_bw_hz,
+                                   float dll_bw_hz,
+                                   float early_late_space_chips,
+                                   float very_early_late_space_chips,
+                                   bool track_pilot,
+                                   Tracking_Loop_Arithmetic loop_arithmetic);
 
 /*!
  * \brief This class implements a code DLL + carrier PLL VEML (Very Early
- *  Minus Late) tracking block for Galileo E1 signals
+ *  Minus Late) tracking block for Galileo E1 signals, for \p Sample input
+ *  samples, gr_complex or lv_16sc_t
+ *
+ * With track_pilot, the loops run on the VEML correlators of the E1-C
+ * pilot, and only the prompt of E1-B is computed for the navigation
+ * symbols, both in the same pass over the samples.
  */
-class galileo_e1_dll_pll_veml_tracking_cc: public gr::block
+template <class Sample>
+class galileo_e1_dll_pll_veml_tracking: public gr::block
 {
 public:
-    ~galileo_e1_dll_pll_veml_tracking_cc();
+    ~galileo_e1_dll_pll_veml_tracking();
 
     void set_channel(unsigned int channel);
     void set_gnss_synchro(Gnss_Synchro* p_gnss_synchro);
     void start_tracking();
 
+    /*!
+     * \brief Samples the correlation peak (of E1-C with track_pilot) with
+     * \p n_taps taps, \p spacing_chips apart around the prompt, computed from
+     * the FFT correlation window of each code period, and adds them to the
+     * dump ("monitor_IQ"). Call it before set_channel().
+     */
+    void set_monitor_taps(int n_taps, float spacing_chips);
+
     /*!
      * \brief Code DLL + carrier PLL according to the algorithms described in:
      * K.Borre, D.M.Akos, N.Bertelsen, P.Rinder, and S.H.Jensen,
@@ -89,9 +129,12 @@ private:
             float pll_bw_hz,
             float dll_bw_hz,
             float early_late_space_chips,
-            float very_early_late_space_chips);
+            float very_early_late_space_chips,
+            bool track_pilot,
+            Tracking_Loop_Arithmetic loop_arithmetic);
 
-    galileo_e1_dll_pll_veml_tracking_cc(long if_freq,
+    friend galileo_e1_dll_pll_veml_tracking_sc_sptr
+    galileo_e1_dll_pll_veml_make_tracking_sc(long if_freq,
             long fs_in, unsigned
             int vector_length,
             bool dump,
@@ -99,7 +142,22 @@ private:
             float pll_bw_hz,
             float dll_bw_hz,
             float early_late_space_chips,
-            float very_early_late_space_chips);
+            float very_early_late_space_chips,
+            bool track_pilot,
+            Tracking_Loop_Arithmetic loop_arithmetic);
+
+    galileo_e1_dll_pll_veml_tracking(const std::string& name,
+            long if_freq,
+            long fs_in, unsigned
+            int vector_length,
+            bool dump,
+            std::string dump_filename,
+            float pll_bw_hz,
+            float dll_bw_hz,
+            float early_late_space_chips,
+            float very_early_late_space_chips,
+            bool track_pilot,
+            Tracking_Loop_Arithmetic loop_arithmetic);
 
     void update_local_code();
 
@@ -114,26 +172,9 @@ private:
     long d_if_freq;
     long d_fs_in;
 
-    //Integration period in samples
-    int d_correlation_length_samples;
-    int d_n_correlator_taps;
-    double d_early_late_spc_chips;
-    double d_very_early_late_spc_chips;
-
-    gr_complex* d_ca_code;
-    float* d_local_code_shift_chips;
-    gr_complex* d_correlator_outs;
-    cpu_multicorrelator multicorrelator_cpu;
-
-    gr_complex *d_Very_Early;
-    gr_complex *d_Early;
-    gr_complex *d_Prompt;
-    gr_complex *d_Late;
-    gr_complex *d_Very_Late;
-
-    // remaining code phase and carrier phase between tracking loops
-    double d_rem_code_phase_samples;
-    double d_rem_carr_phase_rad;
+    // correlators and code and carrier NCOs, on the E1-C pilot if d_track_pilot
+    bool d_track_pilot;
+    std::unique_ptr<Tracking_Engine_Base<Galileo_E1_Tracking_Traits, Sample> > d_engine;
 
     // PLL and DLL filter library
     Tracking_2nd_DLL_filter d_code_loop_filter;
@@ -143,15 +184,6 @@ private:
     double d_acq_code_phase_samples;
     double d_acq_carrier_doppler_hz;
 
-    // tracking vars
-    double d_code_freq_chips;
-    double d_carrier_doppler_hz;
-    double d_acc_carrier_phase_rad;
-    double d_acc_code_phase_secs;
-
-    //PRN period in samples
-    int d_current_prn_length_samples;
-
     //processing samples counters
     unsigned long int d_sample_counter;
     unsigned long int d_acq_sample_stamp;
@@ -170,10 +202,13 @@ private:
 
     // file dump
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Binary_Dump_Writer d_dump_file;
 
     std::map<std::string, std::string> systemName;
     std::string sys;
+
+    // time per phase of the epochs, null unless the tracking profiler is enabled
+    std::shared_ptr<Gnss_Sdr_Tracking_Profile> d_profile;
 };
 
 #endif //GNSS_SDR_GALILEO_E1_DLL_PLL_VEML_TRACKING_CC_H
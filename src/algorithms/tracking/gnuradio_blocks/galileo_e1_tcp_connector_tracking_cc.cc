@@ -38,6 +38,7 @@
 
 #include "galileo_e1_tcp_connector_tracking_cc.h"
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <sstream>
@@ -47,13 +48,17 @@
 #include <glog/logging.h>
 #include <volk/volk.h>
 #include "galileo_e1_signal_processing.h"
+#include "gnss_code_bank.h"
 #include "tracking_discriminators.h"
 #include "lock_detectors.h"
 #include "GPS_L1_CA.h"
 #include "Galileo_E1.h"
 #include "control_message_factory.h"
+#include "gnss_sdr_event_log.h"
 #include "tcp_communication.h"
 #include "tcp_packet_data.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
 
 /*!
  * \todo Include in definition header file
@@ -75,10 +80,11 @@ galileo_e1_tcp_connector_tracking_cc_sptr galileo_e1_tcp_connector_make_tracking
         float dll_bw_hz,
         float early_late_space_chips,
         float very_early_late_space_chips,
-        size_t port_ch0)
+        size_t port_ch0,
+        std::string shm_name)
 {
     return galileo_e1_tcp_connector_tracking_cc_sptr(new Galileo_E1_Tcp_Connector_Tracking_cc(if_freq,
-            fs_in, vector_length, dump, dump_filename, pll_bw_hz, dll_bw_hz, early_late_space_chips, very_early_late_space_chips, port_ch0));
+            fs_in, vector_length, dump, dump_filename, pll_bw_hz, dll_bw_hz, early_late_space_chips, very_early_late_space_chips, port_ch0, shm_name));
 }
 
 
@@ -102,7 +108,8 @@ Galileo_E1_Tcp_Connector_Tracking_cc::Galileo_E1_Tcp_Connector_Tracking_cc(
         float dll_bw_hz __attribute__((unused)),
         float early_late_space_chips,
         float very_early_late_space_chips,
-        size_t port_ch0):
+        size_t port_ch0,
+        std::string shm_name):
         gr::block("Galileo_E1_Tcp_Connector_Tracking_cc", gr::io_signature::make(1, 1, sizeof(gr_complex)),
                 gr::io_signature::make(1, 1, sizeof(Gnss_Synchro)))
 {
@@ -124,17 +131,18 @@ Galileo_E1_Tcp_Connector_Tracking_cc::Galileo_E1_Tcp_Connector_Tracking_cc(
 
     //--- TCP CONNECTOR variables --------------------------------------------------------
     d_port_ch0 = port_ch0;
+    d_shm_name = shm_name;
     d_port = 0;
     d_listen_connection = true;
     d_control_id = 0;
 
     // Initialization of local code replica
     // Get space for a vector with the sinboc(1,1) replica sampled 2x/chip
-    d_ca_code = static_cast<gr_complex*>(volk_malloc((2*Galileo_E1_B_CODE_LENGTH_CHIPS) * sizeof(gr_complex), volk_get_alignment()));
+    d_ca_code = static_cast<gr_complex*>(gnss_sdr_volk_malloc((2*Galileo_E1_B_CODE_LENGTH_CHIPS) * sizeof(gr_complex), volk_get_alignment()));
 
     // correlator outputs (scalar)
     d_n_correlator_taps = 5; // Very-Early, Early, Prompt, Late, Very-Late
-    d_correlator_outs = static_cast<gr_complex*>(volk_malloc(d_n_correlator_taps*sizeof(gr_complex), volk_get_alignment()));
+    d_correlator_outs = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_n_correlator_taps*sizeof(gr_complex), volk_get_alignment()));
     for (int n = 0; n < d_n_correlator_taps; n++)
         {
             d_correlator_outs[n] = gr_complex(0,0);
@@ -146,7 +154,7 @@ Galileo_E1_Tcp_Connector_Tracking_cc::Galileo_E1_Tcp_Connector_Tracking_cc(
     d_Late = &d_correlator_outs[3];
     d_Very_Late = &d_correlator_outs[4];
 
-    d_local_code_shift_chips = static_cast<float*>(volk_malloc(d_n_correlator_taps * sizeof(float), volk_get_alignment()));
+    d_local_code_shift_chips = static_cast<float*>(gnss_sdr_volk_malloc(d_n_correlator_taps * sizeof(float), volk_get_alignment()));
     // Set TAPs delay values [chips]
     d_local_code_shift_chips[0] = - d_very_early_late_spc_chips * 2.0;
     d_local_code_shift_chips[1] = - d_very_early_late_spc_chips;
@@ -204,13 +212,17 @@ void Galileo_E1_Tcp_Connector_Tracking_cc::start_tracking()
     d_acq_carrier_doppler_hz = d_acquisition_gnss_synchro->Acq_doppler_hz;
     d_acq_sample_stamp =  d_acquisition_gnss_synchro->Acq_samplestamp_samples;
 
-    // generate local reference ALWAYS starting at chip 1 (2 samples per chip)
-    galileo_e1_code_gen_complex_sampled(d_ca_code,
-                                        d_acquisition_gnss_synchro->Signal,
-                                        false,
-                                        d_acquisition_gnss_synchro->PRN,
-                                        2 * Galileo_E1_CODE_CHIP_RATE_HZ,
-                                        0);
+    // generate local reference ALWAYS starting at chip 1 (2 samples per chip),
+    // or take it from the code bank if the PRN was already generated
+    char signal_str[3];
+    std::memcpy(signal_str, d_acquisition_gnss_synchro->Signal, 3);
+    unsigned int prn = d_acquisition_gnss_synchro->PRN;
+    Gnss_Code_Bank::instance().copy(d_ca_code, std::string(signal_str, 2), prn,
+            2 * Galileo_E1_CODE_CHIP_RATE_HZ, 0, static_cast<unsigned int>(2 * Galileo_E1_B_CODE_LENGTH_CHIPS),
+            [signal_str, prn](gr_complex* dest) mutable
+            {
+                galileo_e1_code_gen_complex_sampled(dest, signal_str, false, prn, 2 * Galileo_E1_CODE_CHIP_RATE_HZ, 0);
+            });
 
     multicorrelator_cpu.set_local_code_and_taps(static_cast<int>(2*Galileo_E1_B_CODE_LENGTH_CHIPS), d_ca_code, d_local_code_shift_chips);
     for (int n = 0; n < d_n_correlator_taps; n++)
@@ -231,8 +243,7 @@ void Galileo_E1_Tcp_Connector_Tracking_cc::start_tracking()
     sys = sys_.substr(0,1);
 
     // DEBUG OUTPUT
-    std::cout << "Tracking start on channel " << d_channel << " for satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN) << std::endl;
-    LOG(INFO) << "Starting tracking of satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN) << " on channel " << d_channel;
+    Gnss_Sdr_Event_Log::tracking_start(d_channel, d_acquisition_gnss_synchro->System, d_acquisition_gnss_synchro->PRN);
 
     // enable tracking
     d_pull_in = true;
@@ -247,9 +258,9 @@ Galileo_E1_Tcp_Connector_Tracking_cc::~Galileo_E1_Tcp_Connector_Tracking_cc()
     d_dump_file.close();
 
     delete[] d_Prompt_buffer;
-    volk_free(d_ca_code);
-    volk_free(d_local_code_shift_chips);
-    volk_free(d_correlator_outs);
+    gnss_sdr_volk_free(d_ca_code);
+    gnss_sdr_volk_free(d_local_code_shift_chips);
+    gnss_sdr_volk_free(d_correlator_outs);
 
     d_tcp_com.close_tcp_connection(d_port);
     multicorrelator_cpu.free();
@@ -259,6 +270,7 @@ Galileo_E1_Tcp_Connector_Tracking_cc::~Galileo_E1_Tcp_Connector_Tracking_cc()
 int Galileo_E1_Tcp_Connector_Tracking_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
         gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("Galileo_E1_Tcp_Connector_Tracking_cc::general_work", d_channel, d_acquisition_gnss_synchro ? d_acquisition_gnss_synchro->PRN : 0);
     // process vars
     float carr_error_filt_hz;
     float code_error_filt_chips;
@@ -284,7 +296,7 @@ int Galileo_E1_Tcp_Connector_Tracking_cc::general_work (int noutput_items __attr
                     acq_to_trk_delay_samples = d_sample_counter - d_acq_sample_stamp;
                     acq_trk_shif_correction_samples = d_current_prn_length_samples - fmod((float)acq_to_trk_delay_samples, (float)d_current_prn_length_samples);
                     samples_offset = round(d_acq_code_phase_samples + acq_trk_shif_correction_samples);
-                    current_synchro_data.Tracking_timestamp_secs = (static_cast<double>(d_sample_counter) + static_cast<double>(d_rem_code_phase_samples)) / static_cast<double>(d_fs_in);
+                    current_synchro_data.set_sample_stamp(d_sample_counter, static_cast<double>(d_rem_code_phase_samples), static_cast<double>(d_fs_in));
                     *out[0] = current_synchro_data;
                     d_sample_counter = d_sample_counter + samples_offset; //count for the processed samples
                     d_pull_in = false;
@@ -389,8 +401,7 @@ int Galileo_E1_Tcp_Connector_Tracking_cc::general_work (int noutput_items __attr
                         }
                     if (d_carrier_lock_fail_counter > MAXIMUM_LOCK_FAIL_COUNTER)
                         {
-                            std::cout << "Loss of lock in channel " << d_channel << "!" << std::endl;
-                            LOG(INFO) << "Loss of lock in channel " << d_channel << "!";
+                            Gnss_Sdr_Event_Log::loss_of_lock(d_channel);
                             this->message_port_pub(pmt::mp("events"), pmt::from_long(3));//3 -> loss of lock
 
                             d_carrier_lock_fail_counter = 0;
@@ -403,7 +414,7 @@ int Galileo_E1_Tcp_Connector_Tracking_cc::general_work (int noutput_items __attr
             current_synchro_data.Prompt_Q = (double)(*d_Prompt).imag();
             // Tracking_timestamp_secs is aligned with the PRN start sample
             //current_synchro_data.Tracking_timestamp_secs = ((double)d_sample_counter + (double)d_next_prn_length_samples + (double)d_next_rem_code_phase_samples)/(double)d_fs_in;
-            current_synchro_data.Tracking_timestamp_secs = ((double)d_sample_counter + (double)d_rem_code_phase_samples)/(double)d_fs_in;
+            current_synchro_data.set_sample_stamp(d_sample_counter, (double)d_rem_code_phase_samples, (double)d_fs_in);
             d_rem_code_phase_samples = K_blk_samples - d_current_prn_length_samples; //rounding error < 1 sample
             // This tracking block aligns the Tracking_timestamp_secs with the start sample of the PRN, thus, Code_phase_secs=0
             current_synchro_data.Code_phase_secs = 0;
@@ -419,7 +430,7 @@ int Galileo_E1_Tcp_Connector_Tracking_cc::general_work (int noutput_items __attr
             *d_Prompt = gr_complex(0,0);
             *d_Late = gr_complex(0,0);
 
-            current_synchro_data.Tracking_timestamp_secs = (static_cast<double>(d_sample_counter) + static_cast<double>(d_rem_code_phase_samples)) / static_cast<double>(d_fs_in);
+            current_synchro_data.set_sample_stamp(d_sample_counter, static_cast<double>(d_rem_code_phase_samples), static_cast<double>(d_fs_in));
             //! When tracking is disabled an array of 1's is sent to maintain the TCP connection
             boost::array<float, NUM_TX_VARIABLES_GALILEO_E1> tx_variables_array = {{1,1,1,1,1,1,1,1,1,1,1,1,0}};
             d_tcp_com.send_receive_tcp_packet_galileo_e1(tx_variables_array, &tcp_data);
@@ -524,11 +535,18 @@ void Galileo_E1_Tcp_Connector_Tracking_cc::set_channel(unsigned int channel)
                 }
         }
 
-    //! Listen for connections on a TCP port
+    //! Attach to the shared memory mailboxes, or listen for connections on a TCP port
     if (d_listen_connection == true)
         {
             d_port = d_port_ch0 + d_channel;
-            d_listen_connection = d_tcp_com.listen_tcp_connection(d_port, d_port_ch0);
+            if (!d_shm_name.empty() && d_tcp_com.open_shm_connection(d_shm_name, d_channel))
+                {
+                    d_listen_connection = false;
+                }
+            else
+                {
+                    d_listen_connection = d_tcp_com.listen_tcp_connection(d_port, d_port_ch0);
+                }
         }
 }
 
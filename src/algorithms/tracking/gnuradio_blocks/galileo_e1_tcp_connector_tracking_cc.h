@@ -63,7 +63,8 @@ galileo_e1_tcp_connector_make_tracking_cc(long if_freq,
                                    float dll_bw_hz,
                                    float early_late_space_chips,
                                    float very_early_late_space_chips,
-                                   size_t port_ch0);
+                                   size_t port_ch0,
+                                   std::string shm_name);
 
 /*!
  * \brief This class implements a code DLL + carrier PLL VEML (Very Early
@@ -93,7 +94,8 @@ private:
             float dll_bw_hz,
             float early_late_space_chips,
             float very_early_late_space_chips,
-            size_t port_ch0);
+            size_t port_ch0,
+            std::string shm_name);
 
     Galileo_E1_Tcp_Connector_Tracking_cc(long if_freq,
             long fs_in, unsigned
@@ -104,7 +106,8 @@ private:
             float dll_bw_hz,
             float early_late_space_chips,
             float very_early_late_space_chips,
-            size_t port_ch0);
+            size_t port_ch0,
+            std::string shm_name);
 
     void update_local_code();
 
@@ -154,6 +157,7 @@ private:
     float d_acc_code_phase_secs;
     float d_code_phase_samples;
     size_t d_port_ch0;
+    std::string d_shm_name;
     size_t d_port;
     int d_listen_connection;
     float d_control_id;
@@ -48,6 +48,9 @@
 #include "Galileo_E5a.h"
 #include "Galileo_E1.h"
 #include "control_message_factory.h"
+#include "gnss_sdr_event_log.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
 
 
 /*!
@@ -73,15 +76,37 @@ galileo_e5a_dll_pll_make_tracking_cc(
         float pll_bw_init_hz,
         float dll_bw_init_hz,
         int ti_ms,
-        float early_late_space_chips)
+        float early_late_space_chips,
+        bool fast_resampler)
 {
-    return galileo_e5a_dll_pll_tracking_cc_sptr(new Galileo_E5a_Dll_Pll_Tracking_cc(if_freq,
-            fs_in, vector_length, dump, dump_filename, pll_bw_hz, dll_bw_hz, pll_bw_init_hz, dll_bw_init_hz, ti_ms, early_late_space_chips));
+    return galileo_e5a_dll_pll_tracking_cc_sptr(new Galileo_E5a_Dll_Pll_Tracking_cc("Galileo_E5a_Dll_Pll_Tracking_cc", if_freq,
+            fs_in, vector_length, dump, dump_filename, pll_bw_hz, dll_bw_hz, pll_bw_init_hz, dll_bw_init_hz, ti_ms, early_late_space_chips, fast_resampler));
+}
+
+
+galileo_e5a_dll_pll_tracking_sc_sptr
+galileo_e5a_dll_pll_make_tracking_sc(
+        long if_freq,
+        long fs_in,
+        unsigned int vector_length,
+        bool dump,
+        std::string dump_filename,
+        float pll_bw_hz,
+        float dll_bw_hz,
+        float pll_bw_init_hz,
+        float dll_bw_init_hz,
+        int ti_ms,
+        float early_late_space_chips,
+        bool fast_resampler)
+{
+    return galileo_e5a_dll_pll_tracking_sc_sptr(new Galileo_E5a_Dll_Pll_Tracking_sc("Galileo_E5a_Dll_Pll_Tracking_sc", if_freq,
+            fs_in, vector_length, dump, dump_filename, pll_bw_hz, dll_bw_hz, pll_bw_init_hz, dll_bw_init_hz, ti_ms, early_late_space_chips, fast_resampler));
 }
 
 
 
-void Galileo_E5a_Dll_Pll_Tracking_cc::forecast (int noutput_items, gr_vector_int &ninput_items_required)
+template <class Sample>
+void Galileo_E5a_Dll_Pll_Tracking<Sample>::forecast (int noutput_items, gr_vector_int &ninput_items_required)
 {
     if (noutput_items != 0)
         {
@@ -90,7 +115,9 @@ void Galileo_E5a_Dll_Pll_Tracking_cc::forecast (int noutput_items, gr_vector_int
 }
 
 
-Galileo_E5a_Dll_Pll_Tracking_cc::Galileo_E5a_Dll_Pll_Tracking_cc(
+template <class Sample>
+Galileo_E5a_Dll_Pll_Tracking<Sample>::Galileo_E5a_Dll_Pll_Tracking(
+        const std::string& name,
         long if_freq,
         long fs_in,
         unsigned int vector_length,
@@ -101,8 +128,9 @@ Galileo_E5a_Dll_Pll_Tracking_cc::Galileo_E5a_Dll_Pll_Tracking_cc(
         float pll_bw_init_hz,
         float dll_bw_init_hz,
         int ti_ms,
-        float early_late_space_chips) :
-        gr::block("Galileo_E5a_Dll_Pll_Tracking_cc", gr::io_signature::make(1, 1, sizeof(gr_complex)),
+        float early_late_space_chips,
+        bool fast_resampler) :
+        gr::block(name, gr::io_signature::make(1, 1, sizeof(Sample)),
                 gr::io_signature::make(1, 1, sizeof(Gnss_Synchro)))
 {
     // Telemetry bit synchronization message port input
@@ -132,35 +160,38 @@ Galileo_E5a_Dll_Pll_Tracking_cc::Galileo_E5a_Dll_Pll_Tracking_cc(
     d_early_late_spc_chips = early_late_space_chips; // Define early-late offset (in chips)
 
     // Initialization of local code replica
-    // Get space for a vector with the E5a primary code replicas sampled 1x/chip
-    d_codeQ = static_cast<gr_complex*>(volk_malloc(Galileo_E5a_CODE_LENGTH_CHIPS * sizeof(gr_complex), volk_get_alignment()));
-    d_codeI = static_cast<gr_complex*>(volk_malloc(Galileo_E5a_CODE_LENGTH_CHIPS * sizeof(gr_complex), volk_get_alignment()));
-
-    // correlator Q outputs (scalar)
+    // Get space for a vector with the E5a primary code replicas sampled 1x/chip,
+    // and for their copies in the sample type, which the correlator takes
+    d_codeQ = static_cast<gr_complex*>(gnss_sdr_volk_malloc(Galileo_E5a_CODE_LENGTH_CHIPS * sizeof(gr_complex), volk_get_alignment()));
+    d_codeI = static_cast<gr_complex*>(gnss_sdr_volk_malloc(Galileo_E5a_CODE_LENGTH_CHIPS * sizeof(gr_complex), volk_get_alignment()));
+    d_codeQ_sample = static_cast<Sample*>(gnss_sdr_volk_malloc(Galileo_E5a_CODE_LENGTH_CHIPS * sizeof(Sample), volk_get_alignment()));
+    d_codeI_sample = static_cast<Sample*>(gnss_sdr_volk_malloc(Galileo_E5a_CODE_LENGTH_CHIPS * sizeof(Sample), volk_get_alignment()));
+
+    // correlator outputs (scalar): the I prompt for data, then the Q
+    // Early, Prompt and Late of the pilot, all in one pass
     d_n_correlator_taps = 3; //  Early, Prompt, Late
-    d_correlator_outs = static_cast<gr_complex*>(volk_malloc(d_n_correlator_taps*sizeof(gr_complex), volk_get_alignment()));
-    for (int n = 0; n < d_n_correlator_taps; n++)
+    d_correlator_outs = static_cast<gr_complex*>(gnss_sdr_volk_malloc((1 + d_n_correlator_taps) * sizeof(gr_complex), volk_get_alignment()));
+    for (int n = 0; n < 1 + d_n_correlator_taps; n++)
         {
             d_correlator_outs[n] = gr_complex(0,0);
         }
 
     // map memory pointers of correlator outputs
-    d_Single_Early = &d_correlator_outs[0];
-    d_Single_Prompt = &d_correlator_outs[1];
-    d_Single_Late = &d_correlator_outs[2];
+    d_Single_Prompt_data = &d_correlator_outs[0];
+    d_Single_Early = &d_correlator_outs[1];
+    d_Single_Prompt = &d_correlator_outs[2];
+    d_Single_Late = &d_correlator_outs[3];
 
-    d_local_code_shift_chips = static_cast<float*>(volk_malloc(d_n_correlator_taps * sizeof(float), volk_get_alignment()));
+    d_local_code_shift_chips = static_cast<float*>(gnss_sdr_volk_malloc(d_n_correlator_taps * sizeof(float), volk_get_alignment()));
     // Set TAPs delay values [chips]
     d_local_code_shift_chips[0] = - d_early_late_spc_chips;
     d_local_code_shift_chips[1] = 0.0;
     d_local_code_shift_chips[2] = d_early_late_spc_chips;
 
-    multicorrelator_cpu_Q.init(2 * d_vector_length, d_n_correlator_taps);
-
-    // correlator I single output for data (scalar)
-    d_Single_Prompt_data=static_cast<gr_complex*>(volk_malloc(sizeof(gr_complex), volk_get_alignment()));
-    *d_Single_Prompt_data = gr_complex(0,0);
-    multicorrelator_cpu_I.init(2 * d_vector_length, 1); // single correlator for data channel
+    multicorrelator_cpu.init(2 * d_vector_length, 1, d_n_correlator_taps); // single correlator for data channel
+    d_profile = Gnss_Sdr_Tracking_Profiler::profile(name);
+    // the fixed-point code NCO resampler is cheaper for the 10230-chip E5a codes
+    Tracking_Correlator<Sample>::set_fast_resampler(multicorrelator_cpu, fast_resampler);
 
     //--- Perform initializations ------------------------------
     // define initial code frequency basis of NCO
@@ -211,26 +242,28 @@ Galileo_E5a_Dll_Pll_Tracking_cc::Galileo_E5a_Dll_Pll_Tracking_cc(
 }
 
 
-Galileo_E5a_Dll_Pll_Tracking_cc::~Galileo_E5a_Dll_Pll_Tracking_cc ()
+template <class Sample>
+Galileo_E5a_Dll_Pll_Tracking<Sample>::~Galileo_E5a_Dll_Pll_Tracking()
 {
     d_dump_file.close();
 
-    delete[] d_codeI;
-    delete[] d_codeQ;
+    gnss_sdr_volk_free(d_codeI);
+    gnss_sdr_volk_free(d_codeQ);
+    gnss_sdr_volk_free(d_codeI_sample);
+    gnss_sdr_volk_free(d_codeQ_sample);
     delete[] d_Prompt_buffer;
 
     d_dump_file.close();
 
-    volk_free(d_local_code_shift_chips);
-    volk_free(d_correlator_outs);
-    volk_free(d_Single_Prompt_data);
+    gnss_sdr_volk_free(d_local_code_shift_chips);
+    gnss_sdr_volk_free(d_correlator_outs);
 
-    multicorrelator_cpu_Q.free();
-    multicorrelator_cpu_I.free();
+    multicorrelator_cpu.free();
 }
 
 
-void Galileo_E5a_Dll_Pll_Tracking_cc::start_tracking()
+template <class Sample>
+void Galileo_E5a_Dll_Pll_Tracking<Sample>::start_tracking()
 {
     /*
      *  correct the code phase according to the delay between acq and trk
@@ -289,6 +322,10 @@ void Galileo_E5a_Dll_Pll_Tracking_cc::start_tracking()
     strcpy(sig,"5I");
     galileo_e5_a_code_gen_complex_primary(d_codeI, d_acquisition_gnss_synchro->PRN, sig);
 
+    // the I prompt for data, then the Q Early, Prompt and Late of the pilot
+    Tracking_Correlator<Sample>::set_code(multicorrelator_cpu, Galileo_E5a_CODE_LENGTH_CHIPS, d_codeI, d_codeI_sample, &d_local_code_shift_chips[1]);
+    Tracking_Correlator<Sample>::set_pilot_code(multicorrelator_cpu, Galileo_E5a_CODE_LENGTH_CHIPS, d_codeQ, d_codeQ_sample, d_local_code_shift_chips);
+
     d_carrier_lock_fail_counter = 0;
     d_rem_code_phase_samples = 0;
     d_rem_carr_phase_rad = 0;
@@ -301,8 +338,7 @@ void Galileo_E5a_Dll_Pll_Tracking_cc::start_tracking()
     sys = sys_.substr(0,1);
 
     // DEBUG OUTPUT
-    std::cout << "Tracking start on channel " << d_channel << " for satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN) << std::endl;
-    LOG(INFO) << "Starting tracking of satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN) << " on channel " << d_channel;
+    Gnss_Sdr_Event_Log::tracking_start(d_channel, d_acquisition_gnss_synchro->System, d_acquisition_gnss_synchro->PRN);
 
 
     // enable tracking
@@ -315,7 +351,8 @@ void Galileo_E5a_Dll_Pll_Tracking_cc::start_tracking()
 }
 
 
-void Galileo_E5a_Dll_Pll_Tracking_cc::acquire_secondary()
+template <class Sample>
+void Galileo_E5a_Dll_Pll_Tracking<Sample>::acquire_secondary()
 {
     // 1. Transform replica to 1 and -1
     int sec_code_signed[Galileo_E5a_Q_SECONDARY_CODE_LENGTH];
@@ -368,9 +405,11 @@ void Galileo_E5a_Dll_Pll_Tracking_cc::acquire_secondary()
 }
 
 
-int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
+template <class Sample>
+int Galileo_E5a_Dll_Pll_Tracking<Sample>::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
         gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("Galileo_E5a_Dll_Pll_Tracking::general_work", d_channel, d_acquisition_gnss_synchro ? d_acquisition_gnss_synchro->PRN : 0);
     // process vars
     double carr_error_hz;
     double carr_error_filt_hz;
@@ -390,6 +429,7 @@ int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute
      *         3 Tracking algorithm. Correlates EPL each loop and accumulates the result
      *                     until it reaches integration time.
      */
+    if (d_profile) d_profile->start();
     switch (d_state)
     {
     case 0:
@@ -399,7 +439,7 @@ int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute
             d_Prompt = gr_complex(0,0);
             d_Late = gr_complex(0,0);
             d_Prompt_data = gr_complex(0,0);
-            current_synchro_data.Tracking_timestamp_secs = static_cast<double>(d_sample_counter) / static_cast<double>(d_fs_in);
+            current_synchro_data.set_sample_stamp(d_sample_counter, 0.0, static_cast<double>(d_fs_in));
             *out[0] = current_synchro_data;
 
             break;
@@ -419,7 +459,7 @@ int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute
             // make an output to not stop the rest of the processing blocks
             current_synchro_data.Prompt_I = 0.0;
             current_synchro_data.Prompt_Q = 0.0;
-            current_synchro_data.Tracking_timestamp_secs = static_cast<double>(d_sample_counter) / static_cast<double>(d_fs_in);
+            current_synchro_data.set_sample_stamp(d_sample_counter, 0.0, static_cast<double>(d_fs_in));
             current_synchro_data.Carrier_phase_rads = 0.0;
             current_synchro_data.Code_phase_secs = 0.0;
             current_synchro_data.CN0_dB_hz = 0.0;
@@ -431,7 +471,7 @@ int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute
     case 2:
         {
             // Block input data and block output stream pointers
-            const gr_complex* in = (gr_complex*) input_items[0]; //PRN start block alignment
+            const Sample* in = (const Sample*) input_items[0]; //PRN start block alignment
             gr_complex sec_sign_Q;
             gr_complex sec_sign_I;
             // Secondary code Chip
@@ -461,29 +501,14 @@ int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute
                     d_Late = gr_complex(0,0);
                 }
 
-            // perform carrier wipe-off and compute Early, Prompt and Late
-            // correlation of 1 primary code
-
-            multicorrelator_cpu_Q.set_local_code_and_taps(Galileo_E5a_CODE_LENGTH_CHIPS, d_codeQ, d_local_code_shift_chips);
-            multicorrelator_cpu_I.set_local_code_and_taps(Galileo_E5a_CODE_LENGTH_CHIPS, d_codeI, &d_local_code_shift_chips[1]);
-
-
             // ################# CARRIER WIPEOFF AND CORRELATORS ##############################
             // perform carrier wipe-off and compute Early, Prompt and Late correlation
-            multicorrelator_cpu_Q.set_input_output_vectors(d_correlator_outs,in);
-            multicorrelator_cpu_I.set_input_output_vectors(d_Single_Prompt_data,in);
+            multicorrelator_cpu.set_input_output_vectors(d_correlator_outs,in);
 
             double carr_phase_step_rad = GALILEO_TWO_PI * d_carrier_doppler_hz / static_cast<double>(d_fs_in);
             double code_phase_step_chips = d_code_freq_chips / (static_cast<double>(d_fs_in));
             double rem_code_phase_chips = d_rem_code_phase_samples * (d_code_freq_chips / d_fs_in);
-            multicorrelator_cpu_Q.Carrier_wipeoff_multicorrelator_resampler(
-                    d_rem_carr_phase_rad,
-                    carr_phase_step_rad,
-                    rem_code_phase_chips,
-                    code_phase_step_chips,
-                    d_current_prn_length_samples);
-
-            multicorrelator_cpu_I.Carrier_wipeoff_multicorrelator_resampler(
+            multicorrelator_cpu.Carrier_wipeoff_multicorrelator_resampler(
                     d_rem_carr_phase_rad,
                     carr_phase_step_rad,
                     rem_code_phase_chips,
@@ -498,11 +523,11 @@ int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute
             d_Prompt_data=(*d_Single_Prompt_data);
             d_Prompt_data *= sec_sign_I;
             d_integration_counter++;
+            if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::correlation);
 
-            // ################## PLL ##########################################################
-            // PLL discriminator
             if (d_integration_counter == d_current_ti_ms)
                 {
+                    // PLL discriminator
                     if (d_secondary_lock == true)
                         {
                             carr_error_hz = pll_four_quadrant_atan(d_Prompt) / GALILEO_PI * 2.0;
@@ -511,7 +536,14 @@ int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute
                         {
                             carr_error_hz = pll_cloop_two_quadrant_atan(d_Prompt) / GALILEO_PI * 2.0;
                         }
+                    // DLL discriminator
+                    code_error_chips = dll_nc_e_minus_l_normalized(d_Early, d_Late); //[chips/Ti]
+                }
+            if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::discriminators);
 
+            // ################## PLL ##########################################################
+            if (d_integration_counter == d_current_ti_ms)
+                {
                     // Carrier discriminator filter
                     carr_error_filt_hz = d_carrier_loop_filter.get_carrier_nco(carr_error_hz);
                     // New carrier Doppler frequency estimation
@@ -528,8 +560,6 @@ int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute
             // ################## DLL ##########################################################
             if (d_integration_counter == d_current_ti_ms)
                 {
-                    // DLL discriminator
-                    code_error_chips = dll_nc_e_minus_l_normalized(d_Early, d_Late); //[chips/Ti]
                     // Code discriminator filter
                     code_error_filt_chips = d_code_loop_filter.get_code_nco(code_error_chips); //[chips/second]
                     //Code phase accumulator
@@ -550,6 +580,7 @@ int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute
             K_blk_samples = T_prn_samples + d_rem_code_phase_samples + d_code_error_filt_secs * static_cast<double>(d_fs_in);
             d_current_prn_length_samples = round(K_blk_samples); //round to a discrete samples
             d_rem_code_phase_samples = K_blk_samples - d_current_prn_length_samples; //rounding error < 1 sample
+            if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::loop_filters);
 
             // ####### CN0 ESTIMATION AND LOCK DETECTORS ######
             if (d_cn0_estimation_counter < CN0_ESTIMATION_SAMPLES-1)
@@ -567,7 +598,7 @@ int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute
                             acquire_secondary(); // changes d_secondary_lock and d_secondary_delay
                             if (d_secondary_lock == true)
                                 {
-                                    std::cout << "Secondary code locked." << std::endl;
+                                    Gnss_Sdr_Event_Log::satellite_event(EVENT_SECONDARY_CODE_LOCKED, d_channel, d_acquisition_gnss_synchro->System, d_acquisition_gnss_synchro->PRN);
                                     d_current_ti_ms = d_ti_ms;
                                     // Change loop parameters ==========================================
                                     d_code_loop_filter.set_pdi(d_current_ti_ms * GALILEO_E5a_CODE_PERIOD);
@@ -577,12 +608,11 @@ int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute
                                 }
                             else
                                 {
-                                    std::cout << "Secondary code delay couldn't be resolved." << std::endl;
+                                    Gnss_Sdr_Event_Log::satellite_event(EVENT_SECONDARY_CODE_UNRESOLVED, d_channel, d_acquisition_gnss_synchro->System, d_acquisition_gnss_synchro->PRN);
                                     d_carrier_lock_fail_counter++;
                                     if (d_carrier_lock_fail_counter > MAXIMUM_LOCK_FAIL_COUNTER)
                                         {
-                                            std::cout << "Loss of lock in channel " << d_channel << "!" << std::endl;
-                                            LOG(INFO) << "Loss of lock in channel " << d_channel << "!";
+                                            Gnss_Sdr_Event_Log::loss_of_lock(d_channel);
                                             this->message_port_pub(pmt::mp("events"), pmt::from_long(3));//3 -> loss of lock
                                             d_carrier_lock_fail_counter = 0;
                                             d_state = 0; // TODO: check if disabling tracking is consistent with the channel state machine
@@ -606,8 +636,7 @@ int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute
 
                                     if (d_carrier_lock_fail_counter > MAXIMUM_LOCK_FAIL_COUNTER)
                                         {
-                                            std::cout << "Loss of lock in channel " << d_channel << "!" << std::endl;
-                                            LOG(INFO) << "Loss of lock in channel " << d_channel << "!";
+                                            Gnss_Sdr_Event_Log::loss_of_lock(d_channel);
                                             this->message_port_pub(pmt::mp("events"), pmt::from_long(3));//3 -> loss of lock
                                             d_carrier_lock_fail_counter = 0;
                                             d_state = 0;
@@ -620,6 +649,7 @@ int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute
                 {
                     d_first_transition = true;
                 }
+            if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::lock_detectors);
             // ########### Output the tracking data to navigation and PVT ##########
             // The first Prompt output not equal to 0 is synchronized with the transition of a navigation data bit.
             if (d_secondary_lock && d_first_transition)
@@ -627,7 +657,7 @@ int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute
                     current_synchro_data.Prompt_I = static_cast<double>((d_Prompt_data).real());
                     current_synchro_data.Prompt_Q = static_cast<double>((d_Prompt_data).imag());
                     // Tracking_timestamp_secs is aligned with the PRN start sample
-                    current_synchro_data.Tracking_timestamp_secs = (static_cast<double>(d_sample_counter) + static_cast<double>(d_current_prn_length_samples) + static_cast<double>(d_rem_code_phase_samples)) / static_cast<double>(d_fs_in);
+                    current_synchro_data.set_sample_stamp(d_sample_counter, static_cast<double>(d_current_prn_length_samples) + static_cast<double>(d_rem_code_phase_samples), static_cast<double>(d_fs_in));
                     // This tracking block aligns the Tracking_timestamp_secs with the start sample of the PRN, thus, Code_phase_secs=0
                     current_synchro_data.Code_phase_secs = 0;
                     current_synchro_data.Carrier_phase_rads = d_acc_carrier_phase_rad;
@@ -640,7 +670,7 @@ int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute
                     // make an output to not stop the rest of the processing blocks
                     current_synchro_data.Prompt_I = 0.0;
                     current_synchro_data.Prompt_Q = 0.0;
-                    current_synchro_data.Tracking_timestamp_secs = static_cast<double>(d_sample_counter) /  static_cast<double>(d_fs_in);
+                    current_synchro_data.set_sample_stamp(d_sample_counter, 0.0, static_cast<double>(d_fs_in));
                     current_synchro_data.Carrier_phase_rads = 0.0;
                     current_synchro_data.Code_phase_secs = 0.0;
                     current_synchro_data.CN0_dB_hz = 0.0;
@@ -712,11 +742,13 @@ int Galileo_E5a_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute
     d_secondary_delay = (d_secondary_delay + 1) % Galileo_E5a_Q_SECONDARY_CODE_LENGTH;
     d_sample_counter += d_current_prn_length_samples; //count for the processed samples
     consume_each(d_current_prn_length_samples); // this is necessary in gr::block derivates
+    if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::output);
     return 1; //output tracking result ALWAYS even in the case of d_enable_tracking==false
 }
 
 
-void Galileo_E5a_Dll_Pll_Tracking_cc::set_channel(unsigned int channel)
+template <class Sample>
+void Galileo_E5a_Dll_Pll_Tracking<Sample>::set_channel(unsigned int channel)
 {
     d_channel = channel;
     LOG(INFO) << "Tracking Channel set to " << d_channel;
@@ -742,8 +774,12 @@ void Galileo_E5a_Dll_Pll_Tracking_cc::set_channel(unsigned int channel)
 }
 
 
-void Galileo_E5a_Dll_Pll_Tracking_cc::set_gnss_synchro(Gnss_Synchro* p_gnss_synchro)
+template <class Sample>
+void Galileo_E5a_Dll_Pll_Tracking<Sample>::set_gnss_synchro(Gnss_Synchro* p_gnss_synchro)
 {
     d_acquisition_gnss_synchro = p_gnss_synchro;
 }
 
+
+template class Galileo_E5a_Dll_Pll_Tracking<gr_complex>;
+template class Galileo_E5a_Dll_Pll_Tracking<lv_16sc_t>;
@@ -44,13 +44,24 @@
 #include "gnss_synchro.h"
 #include "tracking_2nd_DLL_filter.h"
 #include "tracking_2nd_PLL_filter.h"
-#include "cpu_multicorrelator.h"
+#include "tracking_engine.h"
+#include "gnss_sdr_tracking_profiler.h"
 
-class Galileo_E5a_Dll_Pll_Tracking_cc;
+template <class Sample>
+class Galileo_E5a_Dll_Pll_Tracking;
+
+//! Tracking block for gr_complex samples
+typedef Galileo_E5a_Dll_Pll_Tracking<gr_complex> Galileo_E5a_Dll_Pll_Tracking_cc;
+
+//! Tracking block for lv_16sc_t samples
+typedef Galileo_E5a_Dll_Pll_Tracking<lv_16sc_t> Galileo_E5a_Dll_Pll_Tracking_sc;
 
 typedef boost::shared_ptr<Galileo_E5a_Dll_Pll_Tracking_cc>
         galileo_e5a_dll_pll_tracking_cc_sptr;
 
+typedef boost::shared_ptr<Galileo_E5a_Dll_Pll_Tracking_sc>
+        galileo_e5a_dll_pll_tracking_sc_sptr;
+
 galileo_e5a_dll_pll_tracking_cc_sptr
 galileo_e5a_dll_pll_make_tracking_cc(long if_freq,
                                    long fs_in, unsigned
@@ -62,17 +73,34 @@ galileo_e5a_dll_pll_make_tracking_cc(long if_freq,
                                    float pll_bw_init_hz,
                                    float dll_bw_init_hz,
                                    int ti_ms,
-                                   float early_late_space_chips);
+                                   float early_late_space_chips,
+                                   bool fast_resampler);
+
+galileo_e5a_dll_pll_tracking_sc_sptr
+galileo_e5a_dll_pll_make_tracking_sc(long if_freq,
+                                   long fs_in, unsigned
+                                   int vector_length,
+                                   bool dump,
+                                   std::string dump_filename,
+                                   float pll_bw_hz,
+                                   float dll_bw_hz,
+                                   float pll_bw_init_hz,
+                                   float dll_bw_init_hz,
+                                   int ti_ms,
+                                   float early_late_space_chips,
+                                   bool fast_resampler);
 
 
 
 /*!
- * \brief This class implements a DLL + PLL tracking loop block
+ * \brief This class implements a DLL + PLL tracking loop block for
+ * \p Sample input samples, gr_complex or lv_16sc_t
  */
-class Galileo_E5a_Dll_Pll_Tracking_cc: public gr::block
+template <class Sample>
+class Galileo_E5a_Dll_Pll_Tracking: public gr::block
 {
 public:
-    ~Galileo_E5a_Dll_Pll_Tracking_cc();
+    ~Galileo_E5a_Dll_Pll_Tracking();
 
     void set_channel(unsigned int channel);
     void set_gnss_synchro(Gnss_Synchro* p_gnss_synchro);
@@ -95,9 +123,25 @@ private:
             float pll_bw_init_hz,
             float dll_bw_init_hz,
             int ti_ms,
-            float early_late_space_chips);
+            float early_late_space_chips,
+            bool fast_resampler);
+
+    friend galileo_e5a_dll_pll_tracking_sc_sptr
+    galileo_e5a_dll_pll_make_tracking_sc(long if_freq,
+            long fs_in, unsigned
+            int vector_length,
+            bool dump,
+            std::string dump_filename,
+            float pll_bw_hz,
+            float dll_bw_hz,
+            float pll_bw_init_hz,
+            float dll_bw_init_hz,
+            int ti_ms,
+            float early_late_space_chips,
+            bool fast_resampler);
 
-    Galileo_E5a_Dll_Pll_Tracking_cc(long if_freq,
+    Galileo_E5a_Dll_Pll_Tracking(const std::string& name,
+            long if_freq,
             long fs_in, unsigned
             int vector_length,
             bool dump,
@@ -107,7 +151,8 @@ private:
             float pll_bw_init_hz,
             float dll_bw_init_hz,
             int ti_ms,
-            float early_late_space_chips);
+            float early_late_space_chips,
+            bool fast_resampler);
     void acquire_secondary();
     // tracking configuration vars
     unsigned int d_vector_length;
@@ -129,6 +174,8 @@ private:
 
     gr_complex* d_codeQ;
     gr_complex* d_codeI;
+    Sample* d_codeQ_sample;    // replicas in the sample type
+    Sample* d_codeI_sample;
 
     gr_complex d_Early;
     gr_complex d_Prompt;
@@ -160,8 +207,7 @@ private:
     int d_n_correlator_taps;
     float* d_local_code_shift_chips;
     gr_complex* d_correlator_outs;
-    cpu_multicorrelator multicorrelator_cpu_I;
-    cpu_multicorrelator multicorrelator_cpu_Q;
+    typename Tracking_Correlator<Sample>::type multicorrelator_cpu;  // data I prompt and pilot Q taps in one pass
 
     // tracking vars
     double d_code_freq_chips;
@@ -204,6 +250,9 @@ private:
 
     std::map<std::string, std::string> systemName;
     std::string sys;
+
+    // time per phase of the epochs, null unless the tracking profiler is enabled
+    std::shared_ptr<Gnss_Sdr_Tracking_Profile> d_profile;
 };
 
 #endif /* GNSS_SDR_GALILEO_E5A_DLL_PLL_TRACKING_CC_H_ */
@@ -44,6 +44,9 @@
 #include "lock_detectors.h"
 #include "GPS_L1_CA.h"
 #include "control_message_factory.h"
+#include "gnss_sdr_event_log.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
 
 
 /*!
@@ -88,6 +91,7 @@ void gps_l1_ca_dll_pll_c_aid_tracking_cc::forecast (int noutput_items,
 
 void gps_l1_ca_dll_pll_c_aid_tracking_cc::msg_handler_preamble_index(pmt::pmt_t msg)
 {
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("gps_l1_ca_dll_pll_c_aid_tracking_cc::msg_handler_preamble_index", d_channel, d_acquisition_gnss_synchro ? d_acquisition_gnss_synchro->PRN : 0);
     //pmt::print(msg);
     DLOG(INFO) << "Extended correlation enabled for Tracking CH " << d_channel <<  ": Satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN);
     if (d_enable_extended_integration == false) //avoid re-setting preamble indicator
@@ -143,22 +147,23 @@ gps_l1_ca_dll_pll_c_aid_tracking_cc::gps_l1_ca_dll_pll_c_aid_tracking_cc(
 
     // Initialization of local code replica
     // Get space for a vector with the C/A code replica sampled 1x/chip
-    d_ca_code = static_cast<gr_complex*>(volk_malloc(static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS) * sizeof(gr_complex), volk_get_alignment()));
+    d_ca_code = static_cast<gr_complex*>(gnss_sdr_volk_malloc(static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS) * sizeof(gr_complex), volk_get_alignment()));
 
     // correlator outputs (scalar)
     d_n_correlator_taps = 3; // Early, Prompt, and Late
-    d_correlator_outs = static_cast<gr_complex*>(volk_malloc(d_n_correlator_taps*sizeof(gr_complex), volk_get_alignment()));
+    d_correlator_outs = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_n_correlator_taps*sizeof(gr_complex), volk_get_alignment()));
     for (int n = 0; n < d_n_correlator_taps; n++)
         {
             d_correlator_outs[n] = gr_complex(0,0);
         }
-    d_local_code_shift_chips = static_cast<float*>(volk_malloc(d_n_correlator_taps*sizeof(float), volk_get_alignment()));
+    d_local_code_shift_chips = static_cast<float*>(gnss_sdr_volk_malloc(d_n_correlator_taps*sizeof(float), volk_get_alignment()));
     // Set TAPs delay values [chips]
     d_local_code_shift_chips[0] = - d_early_late_spc_chips;
     d_local_code_shift_chips[1] = 0.0;
     d_local_code_shift_chips[2] = d_early_late_spc_chips;
 
     multicorrelator_cpu.init(2 * d_correlation_length_samples, d_n_correlator_taps);
+    d_profile = Gnss_Sdr_Tracking_Profiler::profile("gps_l1_ca_dll_pll_c_aid_tracking_cc");
 
     //--- Perform initializations ------------------------------
     // define initial code frequency basis of NCO
@@ -287,8 +292,7 @@ void gps_l1_ca_dll_pll_c_aid_tracking_cc::start_tracking()
     sys = sys_.substr(0,1);
 
     // DEBUG OUTPUT
-    std::cout << "Tracking start on channel " << d_channel << " for satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN) << std::endl;
-    LOG(INFO) << "Starting tracking of satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN) << " on channel " << d_channel;
+    Gnss_Sdr_Event_Log::tracking_start(d_channel, d_acquisition_gnss_synchro->System, d_acquisition_gnss_synchro->PRN);
 
     // enable tracking
     d_pull_in = true;
@@ -305,9 +309,9 @@ gps_l1_ca_dll_pll_c_aid_tracking_cc::~gps_l1_ca_dll_pll_c_aid_tracking_cc()
 {
     d_dump_file.close();
 
-    volk_free(d_local_code_shift_chips);
-    volk_free(d_correlator_outs);
-    volk_free(d_ca_code);
+    gnss_sdr_volk_free(d_local_code_shift_chips);
+    gnss_sdr_volk_free(d_correlator_outs);
+    gnss_sdr_volk_free(d_ca_code);
 
     delete[] d_Prompt_buffer;
     multicorrelator_cpu.free();
@@ -318,6 +322,7 @@ gps_l1_ca_dll_pll_c_aid_tracking_cc::~gps_l1_ca_dll_pll_c_aid_tracking_cc()
 int gps_l1_ca_dll_pll_c_aid_tracking_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
         gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("gps_l1_ca_dll_pll_c_aid_tracking_cc::general_work", d_channel, d_acquisition_gnss_synchro ? d_acquisition_gnss_synchro->PRN : 0);
     // Block input data and block output stream pointers
     const gr_complex* in = (gr_complex*) input_items[0]; //PRN start block alignment
     Gnss_Synchro **out = (Gnss_Synchro **) &output_items[0];
@@ -331,6 +336,7 @@ int gps_l1_ca_dll_pll_c_aid_tracking_cc::general_work (int noutput_items __attri
     double CORRECTED_INTEGRATION_TIME_S = 0.0;
     double dll_code_error_secs_Ti = 0.0;
     double old_d_rem_code_phase_samples;
+    if (d_profile) d_profile->start();
     if (d_enable_tracking == true)
         {
             // Fill the acquisition data
@@ -345,7 +351,7 @@ int gps_l1_ca_dll_pll_c_aid_tracking_cc::general_work (int noutput_items __attri
                     acq_trk_shif_correction_samples = d_correlation_length_samples - fmod(static_cast<double>(acq_to_trk_delay_samples), static_cast<double>(d_correlation_length_samples));
                     samples_offset = round(d_acq_code_phase_samples + acq_trk_shif_correction_samples);
 
-                    current_synchro_data.Tracking_timestamp_secs = (static_cast<double>(d_sample_counter) + static_cast<double>(d_rem_code_phase_samples)) / static_cast<double>(d_fs_in);
+                    current_synchro_data.set_sample_stamp(d_sample_counter, static_cast<double>(d_rem_code_phase_samples), static_cast<double>(d_fs_in));
                     *out[0] = current_synchro_data;
                     d_sample_counter += samples_offset; //count for the processed samples
                     d_pull_in = false;
@@ -399,9 +405,18 @@ int gps_l1_ca_dll_pll_c_aid_tracking_cc::general_work (int noutput_items __attri
                                     d_code_loop_filter.set_DLL_BW(d_dll_bw_narrow_hz);
                                     d_carrier_loop_filter.set_params(10.0, d_pll_bw_narrow_hz,2);
                                     d_preamble_synchronized = true;
-                                    std::cout << "Enabled "<<d_extend_correlation_ms<<" [ms] extended correlator for CH "<< d_channel <<" : Satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN)
-                                              <<" pll_bw = " << d_pll_bw_hz << " [Hz], pll_narrow_bw = " << d_pll_bw_narrow_hz << " [Hz]" << std::endl
-                                              <<" dll_bw = " << d_dll_bw_hz << " [Hz], dll_narrow_bw = " << d_dll_bw_narrow_hz << " [Hz]" << std::endl;
+                                    Gnss_Sdr_Event event = Gnss_Sdr_Event();
+                                    event.type = EVENT_EXTENDED_CORRELATION;
+                                    event.sinks = EVENT_TO_CONSOLE;
+                                    event.channel = d_channel;
+                                    event.system = d_acquisition_gnss_synchro->System;
+                                    event.prn = d_acquisition_gnss_synchro->PRN;
+                                    event.values[0] = d_extend_correlation_ms;
+                                    event.values[1] = d_pll_bw_hz;
+                                    event.values[2] = d_pll_bw_narrow_hz;
+                                    event.values[3] = d_dll_bw_hz;
+                                    event.values[4] = d_dll_bw_narrow_hz;
+                                    Gnss_Sdr_Event_Log::post(event);
                                 }
                             // UPDATE INTEGRATION TIME
                             CURRENT_INTEGRATION_TIME_S = static_cast<double>(d_extend_correlation_ms) * GPS_L1_CA_CODE_PERIOD;
@@ -454,11 +469,17 @@ int gps_l1_ca_dll_pll_c_aid_tracking_cc::general_work (int noutput_items __attri
                     enable_dll_pll = true;
                 }
 
+            if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::correlation);
+
             if (enable_dll_pll == true)
                 {
-                    // ################## PLL ##########################################################
                     // Update PLL discriminator [rads/Ti -> Secs/Ti]
                     d_carr_phase_error_secs_Ti = pll_cloop_two_quadrant_atan(d_correlator_outs[1]) / GPS_TWO_PI; //prompt output
+                    // DLL discriminator
+                    d_code_error_chips_Ti = dll_nc_e_minus_l_normalized(d_correlator_outs[0], d_correlator_outs[2]); //[chips/Ti] //early and late
+                    if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::discriminators);
+
+                    // ################## PLL ##########################################################
                     // Carrier discriminator filter
                     // NOTICE: The carrier loop filter includes the Carrier Doppler accumulator, as described in Kaplan
                     //d_carrier_doppler_hz = d_acq_carrier_doppler_hz + carr_phase_error_filt_secs_ti/INTEGRATION_TIME;
@@ -470,8 +491,6 @@ int gps_l1_ca_dll_pll_c_aid_tracking_cc::general_work (int noutput_items __attri
                     d_code_freq_chips = GPS_L1_CA_CODE_RATE_HZ + ((d_carrier_doppler_hz * GPS_L1_CA_CODE_RATE_HZ) / GPS_L1_FREQ_HZ);
 
                     // ################## DLL ##########################################################
-                    // DLL discriminator
-                    d_code_error_chips_Ti = dll_nc_e_minus_l_normalized(d_correlator_outs[0], d_correlator_outs[2]); //[chips/Ti] //early and late
                     // Code discriminator filter
                     d_code_error_filt_chips_s = d_code_loop_filter.get_code_nco(d_code_error_chips_Ti); //input [chips/Ti] -> output [chips/second]
                     d_code_error_filt_chips_Ti = d_code_error_filt_chips_s * CURRENT_INTEGRATION_TIME_S;
@@ -517,6 +536,7 @@ int gps_l1_ca_dll_pll_c_aid_tracking_cc::general_work (int noutput_items __attri
                     d_code_phase_step_chips = d_code_freq_chips / static_cast<double>(d_fs_in);
                     //remnant code phase [chips]
                     d_rem_code_phase_chips = d_rem_code_phase_samples * (d_code_freq_chips / static_cast<double>(d_fs_in));
+                    if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::loop_filters);
 
                     // ####### CN0 ESTIMATION AND LOCK DETECTORS #######################################
                     if (d_cn0_estimation_counter < CN0_ESTIMATION_SAMPLES)
@@ -543,18 +563,18 @@ int gps_l1_ca_dll_pll_c_aid_tracking_cc::general_work (int noutput_items __attri
                                 }
                             if (d_carrier_lock_fail_counter > MAXIMUM_LOCK_FAIL_COUNTER)
                                 {
-                                    std::cout << "Loss of lock in channel " << d_channel << "!" << std::endl;
-                                    LOG(INFO) << "Loss of lock in channel " << d_channel << "!";
+                                    Gnss_Sdr_Event_Log::loss_of_lock(d_channel);
                                     this->message_port_pub(pmt::mp("events"), pmt::from_long(3));//3 -> loss of lock
                                     d_carrier_lock_fail_counter = 0;
                                     d_enable_tracking = false; // TODO: check if disabling tracking is consistent with the channel state machine
                                 }
                         }
+                    if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::lock_detectors);
                     // ########### Output the tracking data to navigation and PVT ##########
                     current_synchro_data.Prompt_I = static_cast<double>((d_correlator_outs[1]).real());
                     current_synchro_data.Prompt_Q = static_cast<double>((d_correlator_outs[1]).imag());
                     // Tracking_timestamp_secs is aligned with the CURRENT PRN start sample (Hybridization OK!)
-                    current_synchro_data.Tracking_timestamp_secs = (static_cast<double>(d_sample_counter) + old_d_rem_code_phase_samples) / static_cast<double>(d_fs_in);
+                    current_synchro_data.set_sample_stamp(d_sample_counter, old_d_rem_code_phase_samples, static_cast<double>(d_fs_in));
                     // This tracking block aligns the Tracking_timestamp_secs with the start sample of the PRN, thus, Code_phase_secs=0
                     current_synchro_data.Code_phase_secs = 0;
                     current_synchro_data.Carrier_phase_rads = GPS_TWO_PI * d_acc_carrier_phase_cycles;
@@ -575,7 +595,7 @@ int gps_l1_ca_dll_pll_c_aid_tracking_cc::general_work (int noutput_items __attri
                     current_synchro_data.Prompt_I = static_cast<double>((d_correlator_outs[1]).real());
                     current_synchro_data.Prompt_Q = static_cast<double>((d_correlator_outs[1]).imag());
                     // Tracking_timestamp_secs is aligned with the CURRENT PRN start sample (Hybridization OK!)
-                    current_synchro_data.Tracking_timestamp_secs = (static_cast<double>(d_sample_counter) + d_rem_code_phase_samples) / static_cast<double>(d_fs_in);
+                    current_synchro_data.set_sample_stamp(d_sample_counter, d_rem_code_phase_samples, static_cast<double>(d_fs_in));
                     // This tracking block aligns the Tracking_timestamp_secs with the start sample of the PRN, thus, Code_phase_secs=0
                     current_synchro_data.Code_phase_secs = 0;
                     current_synchro_data.Carrier_phase_rads = GPS_TWO_PI * d_acc_carrier_phase_cycles;
@@ -591,7 +611,7 @@ int gps_l1_ca_dll_pll_c_aid_tracking_cc::general_work (int noutput_items __attri
                 }
 
             current_synchro_data.System = {'G'};
-            current_synchro_data.Tracking_timestamp_secs = (static_cast<double>(d_sample_counter) + static_cast<double>(d_rem_code_phase_samples)) / static_cast<double>(d_fs_in);
+            current_synchro_data.set_sample_stamp(d_sample_counter, static_cast<double>(d_rem_code_phase_samples), static_cast<double>(d_fs_in));
         }
     //assign the GNURadio block output data
     *out[0] = current_synchro_data;
@@ -652,6 +672,7 @@ int gps_l1_ca_dll_pll_c_aid_tracking_cc::general_work (int noutput_items __attri
 
     consume_each(d_correlation_length_samples); // this is necessary in gr::block derivates
     d_sample_counter += d_correlation_length_samples; //count for the processed samples
+    if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::output);
 
     return 1; //output tracking result ALWAYS even in the case of d_enable_tracking==false
 }
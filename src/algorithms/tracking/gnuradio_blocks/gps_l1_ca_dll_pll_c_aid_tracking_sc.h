@@ -49,6 +49,7 @@
 #include "tracking_2nd_DLL_filter.h"
 #include "tracking_FLL_PLL_filter.h"
 #include "cpu_multicorrelator_16sc.h"
+#include "gnss_sdr_tracking_profiler.h"
 
 class gps_l1_ca_dll_pll_c_aid_tracking_sc;
 
@@ -182,6 +183,9 @@ private:
 
     std::map<std::string, std::string> systemName;
     std::string sys;
+
+    // time per phase of the epochs, null unless the tracking profiler is enabled
+    std::shared_ptr<Gnss_Sdr_Tracking_Profile> d_profile;
 };
 
 #endif //GNSS_SDR_GPS_L1_CA_DLL_PLL_C_AID_TRACKING_SC_H
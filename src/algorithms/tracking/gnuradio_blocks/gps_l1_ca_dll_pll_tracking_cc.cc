@@ -35,10 +35,14 @@
  */
 
 #include "gps_l1_ca_dll_pll_tracking_cc.h"
+#include <algorithm>
 #include <cmath>
+#include <chrono>
 #include <iostream>
+#include <thread>
 #include <memory>
 #include <sstream>
+#include <boost/bind.hpp>
 #include <boost/lexical_cast.hpp>
 #include <gnuradio/io_signature.h>
 #include <glog/logging.h>
@@ -47,7 +51,15 @@
 #include "tracking_discriminators.h"
 #include "lock_detectors.h"
 #include "GPS_L1_CA.h"
+#include "acquisition_assistance.h"
 #include "control_message_factory.h"
+#include "gnss_sdr_event_log.h"
+#include "gnss_sdr_latency_tracer.h"
+#include "gnss_sdr_parameters.h"
+#include "gnss_sdr_realtime_monitor.h"
+#include "gnss_sdr_tracking_profiler.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
 
 
 /*!
@@ -57,6 +69,9 @@
 #define MINIMUM_VALID_CN0 25
 #define MAXIMUM_LOCK_FAIL_COUNTER 50
 #define CARRIER_LOCK_THRESHOLD 0.85
+#define VECTOR_TRACKING_MAX_AIDING_AGE_S 1.0
+#define EXTENDED_INTEGRATION_MIN_LOCK_MS 200
+#define EXTENDED_INTEGRATION_MAX_FAIL_MS 100
 
 
 using google::LogMessage;
@@ -70,10 +85,19 @@ gps_l1_ca_dll_pll_make_tracking_cc(
         std::string dump_filename,
         float pll_bw_hz,
         float dll_bw_hz,
-        float early_late_space_chips)
+        float early_late_space_chips,
+        bool vector_tracking,
+        float vector_pll_bw_hz,
+        float vector_dll_bw_hz,
+        int extend_correlation_ms,
+        float pll_bw_narrow_hz,
+        float dll_bw_narrow_hz,
+        Tracking_Loop_Arithmetic loop_arithmetic)
 {
     return gps_l1_ca_dll_pll_tracking_cc_sptr(new Gps_L1_Ca_Dll_Pll_Tracking_cc(if_freq,
-            fs_in, vector_length, dump, dump_filename, pll_bw_hz, dll_bw_hz, early_late_space_chips));
+            fs_in, vector_length, dump, dump_filename, pll_bw_hz, dll_bw_hz, early_late_space_chips,
+            vector_tracking, vector_pll_bw_hz, vector_dll_bw_hz,
+            extend_correlation_ms, pll_bw_narrow_hz, dll_bw_narrow_hz, loop_arithmetic));
 }
 
 
@@ -83,7 +107,8 @@ void Gps_L1_Ca_Dll_Pll_Tracking_cc::forecast (int noutput_items,
 {
     if (noutput_items != 0)
         {
-            ninput_items_required[0] = static_cast<int>(d_vector_length) * 2; //set the required available samples in each call
+            // one code period per output item, plus the margin needed by the last one
+            ninput_items_required[0] = static_cast<int>(d_vector_length) * (noutput_items + 1);
         }
 }
 
@@ -97,13 +122,33 @@ Gps_L1_Ca_Dll_Pll_Tracking_cc::Gps_L1_Ca_Dll_Pll_Tracking_cc(
         std::string dump_filename,
         float pll_bw_hz,
         float dll_bw_hz,
-        float early_late_space_chips) :
+        float early_late_space_chips,
+        bool vector_tracking,
+        float vector_pll_bw_hz,
+        float vector_dll_bw_hz,
+        int extend_correlation_ms,
+        float pll_bw_narrow_hz,
+        float dll_bw_narrow_hz,
+        Tracking_Loop_Arithmetic loop_arithmetic) :
         gr::block("Gps_L1_Ca_Dll_Pll_Tracking_cc", gr::io_signature::make(1, 1, sizeof(gr_complex)),
-                gr::io_signature::make(1, 1, sizeof(Gnss_Synchro)))
+                gr::io_signature::make(1, 1, sizeof(Gnss_Synchro))),
+        d_engine(make_tracking_engine<Gps_L1_Ca_Tracking_Traits, gr_complex>(loop_arithmetic,
+                fs_in, 2 * vector_length, early_late_space_chips)),
+        d_dump_file("gps_l1_ca_dll_pll_tracking")
 {
     // Telemetry bit synchronization message port input
     this->message_port_register_in(pmt::mp("preamble_timestamp_s"));
+    this->set_msg_handler(pmt::mp("preamble_timestamp_s"), boost::bind(&Gps_L1_Ca_Dll_Pll_Tracking_cc::msg_handler_preamble_timestamp, this, _1));
     this->message_port_register_out(pmt::mp("events"));
+    // Navigation solution predictions from the PVT block
+    this->message_port_register_in(pmt::mp("vector_tracking"));
+    this->set_msg_handler(pmt::mp("vector_tracking"), boost::bind(&Gps_L1_Ca_Dll_Pll_Tracking_cc::msg_handler_vector_tracking, this, _1));
+    // Loop bandwidths changed in the configuration file while running
+    this->message_port_register_in(pmt::mp("parameters"));
+    this->set_msg_handler(pmt::mp("parameters"), boost::bind(&Gps_L1_Ca_Dll_Pll_Tracking_cc::msg_handler_parameters, this, _1));
+    // Channels shed by the receiver when it falls behind real time
+    this->message_port_register_in(pmt::mp("stop_tracking"));
+    this->set_msg_handler(pmt::mp("stop_tracking"), boost::bind(&Gps_L1_Ca_Dll_Pll_Tracking_cc::msg_handler_stop_tracking, this, _1));
 
     // initialize internal vars
     d_dump = dump;
@@ -112,41 +157,40 @@ Gps_L1_Ca_Dll_Pll_Tracking_cc::Gps_L1_Ca_Dll_Pll_Tracking_cc(
     d_vector_length = vector_length;
     d_dump_filename = dump_filename;
 
-    d_current_prn_length_samples = static_cast<int>(d_vector_length);
-
     // Initialize tracking  ==========================================
     d_code_loop_filter.set_DLL_BW(dll_bw_hz);
     d_carrier_loop_filter.set_PLL_BW(pll_bw_hz);
-
-    //--- DLL variables --------------------------------------------------------
-    d_early_late_spc_chips = early_late_space_chips; // Define early-late offset (in chips)
-
-    // Initialization of local code replica
-    // Get space for a vector with the C/A code replica sampled 1x/chip
-    d_ca_code = static_cast<gr_complex*>(volk_malloc(static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS) * sizeof(gr_complex), volk_get_alignment()));
-
-    // correlator outputs (scalar)
-    d_n_correlator_taps = 3; // Early, Prompt, and Late
-    d_correlator_outs = static_cast<gr_complex*>(volk_malloc(d_n_correlator_taps*sizeof(gr_complex), volk_get_alignment()));
-    for (int n = 0; n < d_n_correlator_taps; n++)
-        {
-            d_correlator_outs[n] = gr_complex(0,0);
-        }
-    d_local_code_shift_chips = static_cast<float*>(volk_malloc(d_n_correlator_taps*sizeof(float), volk_get_alignment()));
-    // Set TAPs delay values [chips]
-    d_local_code_shift_chips[0] = - d_early_late_spc_chips;
-    d_local_code_shift_chips[1] = 0.0;
-    d_local_code_shift_chips[2] = d_early_late_spc_chips;
-
-    multicorrelator_cpu.init(2 * d_current_prn_length_samples, d_n_correlator_taps);
-
-    //--- Perform initializations ------------------------------
-    // define initial code frequency basis of NCO
-    d_code_freq_chips = GPS_L1_CA_CODE_RATE_HZ;
-    // define residual code phase (in chips)
-    d_rem_code_phase_samples = 0.0;
-    // define residual carrier phase
-    d_rem_carr_phase_rad = 0.0;
+    d_pll_bw_hz = pll_bw_hz;
+    d_dll_bw_hz = dll_bw_hz;
+    d_loops = 0;
+    d_loops_channel = -1;
+    d_loops_prepared = false;
+    d_close_loops = true;
+    d_bit_edge = false;
+    d_integration_ms = 1;
+
+    // Vector tracking
+    d_vector_tracking = vector_tracking;
+    d_vector_pll_bw_hz = vector_pll_bw_hz;
+    d_vector_dll_bw_hz = vector_dll_bw_hz;
+    d_aiding_valid = false;
+    d_vector_aiding_active = false;
+    d_aiding_timestamp_s = 0.0;
+    d_aiding_range_rate_m_s = 0.0;
+    d_carrier_doppler_reference_hz = 0.0;
+
+    // Extended coherent integration
+    d_extend_correlation_ms = std::max(extend_correlation_ms, 1);
+    d_pll_bw_narrow_hz = pll_bw_narrow_hz;
+    d_dll_bw_narrow_hz = dll_bw_narrow_hz;
+    d_preamble_synchronized = false;
+    d_extended_integration_active = false;
+    d_preamble_timestamp_s = 0.0;
+    d_carrier_lock_ok_ms = 0;
+
+    // Early, Prompt and Late correlations, accumulated up to the bit edges
+    d_integrated_outs = static_cast<gr_complex*>(gnss_sdr_volk_malloc(d_engine->n_taps * sizeof(gr_complex), volk_get_alignment()));
+    d_profile = Gnss_Sdr_Tracking_Profiler::profile("Gps_L1_Ca_Dll_Pll_Tracking_cc");
 
     // sample synchronization
     d_sample_counter = 0;
@@ -155,10 +199,14 @@ Gps_L1_Ca_Dll_Pll_Tracking_cc::Gps_L1_Ca_Dll_Pll_Tracking_cc(
 
     d_enable_tracking = false;
     d_pull_in = false;
+    d_replay_pull_in = false;
+    d_rf_channel = 0;
+    d_replay_buffer = 0;
+    d_replay_stamp = 0;
+    d_replaying = false;
 
     // CN0 estimation and lock detector buffers
-    d_cn0_estimation_counter = 0;
-    d_Prompt_buffer = new gr_complex[CN0_ESTIMATION_SAMPLES];
+    d_lock_detector.set_length(CN0_ESTIMATION_SAMPLES);
     d_carrier_lock_test = 1;
     d_CN0_SNV_dB_Hz = 0;
     d_carrier_lock_fail_counter = 0;
@@ -171,13 +219,6 @@ Gps_L1_Ca_Dll_Pll_Tracking_cc::Gps_L1_Ca_Dll_Pll_Tracking_cc(
     d_channel = 0;
     d_acq_code_phase_samples = 0.0;
     d_acq_carrier_doppler_hz = 0.0;
-    d_carrier_doppler_hz = 0.0;
-    d_acc_carrier_phase_rad = 0.0;
-    d_code_phase_samples = 0.0;
-    d_acc_code_phase_secs = 0.0;
-    d_rem_code_phase_chips = 0.0;
-    d_code_phase_step_chips = 0.0;
-    d_carrier_phase_step_rad = 0.0;
 
     set_relative_rate(1.0 / static_cast<double>(d_vector_length));
 }
@@ -204,14 +245,10 @@ void Gps_L1_Ca_Dll_Pll_Tracking_cc::start_tracking()
     double T_chip_mod_seconds;
     double T_prn_mod_seconds;
     double T_prn_mod_samples;
-    d_code_freq_chips = radial_velocity * GPS_L1_CA_CODE_RATE_HZ;
-    d_code_phase_step_chips = static_cast<double>(d_code_freq_chips) / static_cast<double>(d_fs_in);
-    T_chip_mod_seconds = 1/d_code_freq_chips;
+    T_chip_mod_seconds = 1 / (radial_velocity * GPS_L1_CA_CODE_RATE_HZ);
     T_prn_mod_seconds = T_chip_mod_seconds * GPS_L1_CA_CODE_LENGTH_CHIPS;
     T_prn_mod_samples = T_prn_mod_seconds * static_cast<double>(d_fs_in);
 
-    d_current_prn_length_samples = round(T_prn_mod_samples);
-
     double T_prn_true_seconds = GPS_L1_CA_CODE_LENGTH_CHIPS / GPS_L1_CA_CODE_RATE_HZ;
     double T_prn_true_samples = T_prn_true_seconds * static_cast<double>(d_fs_in);
     double T_prn_diff_seconds = T_prn_true_seconds - T_prn_mod_seconds;
@@ -226,63 +263,324 @@ void Gps_L1_Ca_Dll_Pll_Tracking_cc::start_tracking()
 
     d_acq_code_phase_samples = corrected_acq_phase_samples;
 
-    d_carrier_doppler_hz = d_acq_carrier_doppler_hz;
-    d_carrier_phase_step_rad = GPS_TWO_PI * d_carrier_doppler_hz / static_cast<double>(d_fs_in);
+    // predictions for the previous satellite of this channel do not apply
+    d_aiding_valid = false;
+    d_vector_aiding_active = false;
+    d_carrier_doppler_reference_hz = d_acq_carrier_doppler_hz;
+
+    // 1 ms integration until the telemetry decoder finds the bit edges of this satellite
+    d_preamble_synchronized = false;
+    d_extended_integration_active = false;
+    d_carrier_lock_ok_ms = 0;
 
     // DLL/PLL filter initialization
-    d_carrier_loop_filter.initialize(); // initialize the carrier filter
-    d_code_loop_filter.initialize();    // initialize the code filter
+    update_loop_filters();
+    initialize_loop_filters();
 
     // generate local reference ALWAYS starting at chip 1 (1 sample per chip)
-    gps_l1_ca_code_gen_complex(d_ca_code, d_acquisition_gnss_synchro->PRN, 0);
-
-    multicorrelator_cpu.set_local_code_and_taps(static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS), d_ca_code, d_local_code_shift_chips);
-    for (int n = 0; n < d_n_correlator_taps; n++)
+    gps_l1_ca_code_gen_complex(d_engine->local_code(), d_acquisition_gnss_synchro->PRN, 0);
+    d_engine->start(d_acq_carrier_doppler_hz, d_acq_code_phase_samples);
+    for (int n = 0; n < d_engine->n_taps; n++)
         {
-            d_correlator_outs[n] = gr_complex(0,0);
+            d_integrated_outs[n] = gr_complex(0,0);
         }
 
+    d_lock_detector.reset();
     d_carrier_lock_fail_counter = 0;
-    d_rem_code_phase_samples = 0;
-    d_rem_carr_phase_rad = 0.0;
-    d_rem_code_phase_chips = 0.0;
-    d_acc_carrier_phase_rad = 0.0;
-    d_acc_code_phase_secs = 0.0;
-
-    d_code_phase_samples = d_acq_code_phase_samples;
 
     std::string sys_ = &d_acquisition_gnss_synchro->System;
     sys = sys_.substr(0,1);
 
     // DEBUG OUTPUT
-    std::cout << "Tracking start on channel " << d_channel << " for satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN) << std::endl;
-    LOG(INFO) << "Starting tracking of satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN) << " on channel " << d_channel;
+    Gnss_Sdr_Event_Log::tracking_start(d_channel, d_acquisition_gnss_synchro->System, d_acquisition_gnss_synchro->PRN);
+
+    // Replayed pull-in from the last code period of the acquired dwell, whose
+    // length is a whole number of periods
+    d_replaying = false;
+    if (d_replay_pull_in)
+        {
+            d_ring = Gnss_Sample_Ring_Store::instance().get(d_rf_channel);
+            long int replay_stamp = static_cast<long int>(d_acq_sample_stamp) - static_cast<long int>(d_vector_length)
+                    + static_cast<long int>(round(fmod(d_acquisition_gnss_synchro->Acq_delay_samples, static_cast<double>(d_vector_length))));
+            if (d_ring and replay_stamp >= 0 and d_ring->capacity() >= 2 * d_vector_length)
+                {
+                    if (d_replay_buffer == 0)
+                        {
+                            d_replay_buffer = static_cast<gr_complex*>(gnss_sdr_volk_malloc(2 * d_vector_length * sizeof(gr_complex), volk_get_alignment()));
+                        }
+                    d_replay_stamp = replay_stamp;
+                    d_replaying = true;
+                }
+        }
 
     // enable tracking
     d_pull_in = true;
     d_enable_tracking = true;
 
-    LOG(INFO) << "PULL-IN Doppler [Hz]=" << d_carrier_doppler_hz
+    LOG(INFO) << "PULL-IN Doppler [Hz]=" << d_engine->carrier_doppler_hz()
             << " Code Phase correction [samples]=" << delay_correction_samples
             << " PULL-IN Code Phase [samples]=" << d_acq_code_phase_samples;
 }
 
+void Gps_L1_Ca_Dll_Pll_Tracking_cc::set_events_publisher(boost::function<void(pmt::pmt_t)> publisher)
+{
+    d_events_publisher = publisher;
+}
+
+
+void Gps_L1_Ca_Dll_Pll_Tracking_cc::set_replay_pull_in(bool replay, unsigned int rf_channel)
+{
+    d_replay_pull_in = replay;
+    d_rf_channel = rf_channel;
+}
+
+
+void Gps_L1_Ca_Dll_Pll_Tracking_cc::set_monitor_taps(int n_taps, float spacing_chips)
+{
+    d_engine->set_monitor_taps(n_taps, spacing_chips);
+}
+
+
 Gps_L1_Ca_Dll_Pll_Tracking_cc::~Gps_L1_Ca_Dll_Pll_Tracking_cc()
 {
     d_dump_file.close();
 
-    volk_free(d_local_code_shift_chips);
-    volk_free(d_correlator_outs);
-    volk_free(d_ca_code);
-
-    delete[] d_Prompt_buffer;
-    multicorrelator_cpu.free();
+    gnss_sdr_volk_free(d_integrated_outs);
+    gnss_sdr_volk_free(d_replay_buffer);
 }
 
 
 
-int Gps_L1_Ca_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
+int Gps_L1_Ca_Dll_Pll_Tracking_cc::general_work (int noutput_items, gr_vector_int &ninput_items,
         gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
+{
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("Gps_L1_Ca_Dll_Pll_Tracking_cc::general_work", d_channel, d_acquisition_gnss_synchro ? d_acquisition_gnss_synchro->PRN : 0);
+    // Block input data and block output stream pointers
+    const gr_complex* in = (gr_complex*) input_items[0]; //PRN start block alignment
+    Gnss_Synchro* out = (Gnss_Synchro*) output_items[0];
+
+    // Track as many complete code periods as the input buffer holds, instead of
+    // waking up the scheduler once per millisecond with a single period
+    int produced = 0;
+    int consumed = 0;
+    if (d_replaying)
+        {
+            produced = replay_epochs(ninput_items[0], out, noutput_items, consumed);
+        }
+    while (!d_replaying and produced < noutput_items)
+        {
+            int epoch_samples = track_epoch(in + consumed, ninput_items[0] - consumed, &out[produced]);
+            if (epoch_samples < 0) break;
+            consumed += epoch_samples;
+            produced++;
+        }
+    consume_each(consumed); // this is necessary in gr::block derivates
+    if (produced > 0) Gnss_Sdr_Latency_Tracer::record("tracking", out[produced - 1].Tracking_timestamp_secs);
+    return produced; //output tracking result ALWAYS even in the case of d_enable_tracking==false
+}
+
+
+int Gps_L1_Ca_Dll_Pll_Tracking_cc::replay_epochs(int available_samples, Gnss_Synchro* out, int noutput_items, int& consumed)
+{
+    const unsigned long int stream_stamp = nitems_read(0);
+    const unsigned int replay_samples = 2 * d_vector_length; // the margin of track_epoch()
+    int produced = 0;
+    consumed = 0;
+    if (d_pull_in)
+        {
+            // the replay starts at a code period, so there is nothing to align
+            d_sample_counter = d_replay_stamp;
+            d_pull_in = false;
+        }
+    while (produced < noutput_items and d_enable_tracking)
+        {
+            // back to the live input as soon as it holds the next code period
+            if (d_sample_counter >= stream_stamp and d_sample_counter < stream_stamp + available_samples)
+                {
+                    consumed = d_sample_counter - stream_stamp;
+                    d_replaying = false;
+                    LOG(INFO) << "Replayed pull-in of channel " << d_channel << " done, "
+                              << (stream_stamp + consumed - d_replay_stamp) << " samples";
+                    return produced;
+                }
+            if (d_ring->read(d_sample_counter, d_replay_buffer, replay_samples))
+                {
+                    track_epoch(d_replay_buffer, replay_samples, &out[produced]);
+                    produced++;
+                    continue;
+                }
+            if (d_sample_counter + replay_samples <= d_ring->newest())
+                {
+                    // overwritten: the replay is slower than real time
+                    LOG(WARNING) << "The replayed pull-in of channel " << d_channel << " fell behind the sample ring";
+                    if (d_events_publisher)
+                        {
+                            d_events_publisher(pmt::from_long(3));//3 -> loss of lock
+                        }
+                    else
+                        {
+                            this->message_port_pub(pmt::mp("events"), pmt::from_long(3));//3 -> loss of lock
+                        }
+                    d_enable_tracking = false;
+                }
+            else if (d_sample_counter + replay_samples <= stream_stamp + available_samples)
+                {
+                    // the ring is filled by another reader of this stream, which may lag a little
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+            else
+                {
+                    break;
+                }
+        }
+    if (!d_enable_tracking)
+        {
+            // lost lock while replaying: go on from the live input, as after any loss of lock
+            d_sample_counter = stream_stamp;
+            d_replaying = false;
+            return produced;
+        }
+    // the live input before the replayed period is in the ring
+    if (d_sample_counter > stream_stamp)
+        {
+            consumed = std::min<unsigned long int>(available_samples, d_sample_counter - stream_stamp);
+        }
+    return produced;
+}
+
+
+int Gps_L1_Ca_Dll_Pll_Tracking_cc::track_epoch(const gr_complex* in, int available_samples, Gnss_Synchro* out)
+{
+    bool pending = false;
+    int samples = begin_epoch(available_samples, out, pending);
+    if (pending == false) return samples;
+    correlate(in);
+    return end_epoch(out);
+}
+
+
+int Gps_L1_Ca_Dll_Pll_Tracking_cc::begin_epoch(int available_samples, Gnss_Synchro* out, bool& pending)
+{
+    pending = false;
+    // the same margin that forecast() used to ask for a single period: the
+    // length of the next period is only known after this one is tracked
+    if (available_samples < 2 * static_cast<int>(d_vector_length)) return -1;
+    if (d_realtime_cost) d_epoch_start = std::chrono::steady_clock::now();
+    if (d_profile) d_profile->start();
+
+    // Receiver signal alignment
+    if (d_enable_tracking == true and d_pull_in == true)
+        {
+            // Fill the acquisition data
+            Gnss_Synchro current_synchro_data = *d_acquisition_gnss_synchro;
+            int samples_offset;
+            double acq_trk_shif_correction_samples;
+            int acq_to_trk_delay_samples;
+            acq_to_trk_delay_samples = d_sample_counter - d_acq_sample_stamp;
+            acq_trk_shif_correction_samples = d_engine->current_prn_length_samples() - fmod(static_cast<float>(acq_to_trk_delay_samples), static_cast<float>(d_engine->current_prn_length_samples()));
+            samples_offset = round(d_acq_code_phase_samples + acq_trk_shif_correction_samples);
+            if (samples_offset > available_samples) return -1;
+            current_synchro_data.set_sample_stamp(d_sample_counter, d_engine->rem_code_phase_samples(), static_cast<double>(d_fs_in));
+            d_sample_counter = d_sample_counter + samples_offset; //count for the processed samples
+            d_pull_in = false;
+            *out = current_synchro_data;
+            return samples_offset; //shift input to perform alignment with local replica
+        }
+    pending = true;
+    return 0;
+}
+
+
+void Gps_L1_Ca_Dll_Pll_Tracking_cc::correlate(const gr_complex* in)
+{
+    if (d_enable_tracking == false) return;
+    // ################# CARRIER WIPEOFF AND CORRELATORS ##############################
+    // perform carrier wipe-off and compute Early, Prompt and Late correlation
+    d_engine->correlate(in);
+}
+
+
+void Gps_L1_Ca_Dll_Pll_Tracking_cc::submit(multichannel_correlator& correlator, int channel, const gr_complex* in)
+{
+    if (d_enable_tracking == false) return;
+    // the correlator writes the outputs of d_engine on its next execute()
+    correlator.submit(channel, in, d_engine->rem_carr_phase_rad(),
+            d_engine->carrier_phase_step_rad(),
+            d_engine->rem_code_phase_chips(),
+            d_engine->code_phase_step_chips(),
+            d_engine->current_prn_length_samples());
+    d_engine->correlate_monitor(in);
+}
+
+
+int Gps_L1_Ca_Dll_Pll_Tracking_cc::add_to(multichannel_correlator& correlator)
+{
+    return correlator.add_channel(d_engine->code_samples, d_engine->local_code(),
+            d_engine->shifts(), d_engine->n_taps, d_engine->outputs());
+}
+
+
+int Gps_L1_Ca_Dll_Pll_Tracking_cc::add_to(multichannel_loop_filters& loops)
+{
+    // the integrated correlations are copied to the outputs of d_engine at the bit edges
+    int channel = loops.add_channel(d_engine->outputs(), Gps_L1_Ca_Tracking_Traits::early,
+            Gps_L1_Ca_Tracking_Traits::prompt, Gps_L1_Ca_Tracking_Traits::late, GPS_L1_CA_CODE_PERIOD);
+    if (channel < 0) return channel;
+    d_loops = &loops;
+    d_loops_channel = channel;
+    // the shared filters take over the bandwidths, and start from the state of a new satellite
+    update_loop_filters();
+    initialize_loop_filters();
+    return channel;
+}
+
+
+bool Gps_L1_Ca_Dll_Pll_Tracking_cc::prepare_loops()
+{
+    d_loops_prepared = true;
+    d_close_loops = true;
+    d_bit_edge = false;
+    d_integration_ms = 1;
+    if (d_enable_tracking == false) return false;
+
+    // ################## VECTOR TRACKING AIDING ######################################
+    update_vector_aiding();
+
+    // ################## COHERENT INTEGRATION EXTENSION ###############################
+    // Once the telemetry decoder has found the bit edges, the 1 ms correlations are
+    // accumulated up to the next edge and the loops are closed once per edge only
+    if (d_preamble_synchronized == true)
+        {
+            long int symbol_diff = round(1000.0 * ((static_cast<double>(d_sample_counter) + d_engine->rem_code_phase_samples()) / static_cast<double>(d_fs_in) - d_preamble_timestamp_s));
+            d_bit_edge = (symbol_diff > 0 and symbol_diff % d_extend_correlation_ms == 0);
+        }
+    if (d_extended_integration_active == true)
+        {
+            gr_complex* correlator_outs = d_engine->outputs();
+            for (int n = 0; n < d_engine->n_taps; n++)
+                {
+                    d_integrated_outs[n] += correlator_outs[n];
+                }
+            if (d_bit_edge == true)
+                {
+                    for (int n = 0; n < d_engine->n_taps; n++)
+                        {
+                            correlator_outs[n] = d_integrated_outs[n];
+                            d_integrated_outs[n] = gr_complex(0,0);
+                        }
+                    d_integration_ms = d_extend_correlation_ms;
+                }
+            else
+                {
+                    d_close_loops = false;
+                }
+        }
+    if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::correlation);
+    return d_close_loops;
+}
+
+
+int Gps_L1_Ca_Dll_Pll_Tracking_cc::end_epoch(Gnss_Synchro* out)
 {
     // process vars
     double carr_error_hz = 0.0;
@@ -290,10 +588,6 @@ int Gps_L1_Ca_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute__
     double code_error_chips = 0.0;
     double code_error_filt_chips = 0.0;
 
-    // Block input data and block output stream pointers
-    const gr_complex* in = (gr_complex*) input_items[0]; //PRN start block alignment
-    Gnss_Synchro **out = (Gnss_Synchro **) &output_items[0];
-
     // GNSS_SYNCHRO OBJECT to interchange data between tracking->telemetry_decoder
     Gnss_Synchro current_synchro_data = Gnss_Synchro();
 
@@ -301,204 +595,377 @@ int Gps_L1_Ca_Dll_Pll_Tracking_cc::general_work (int noutput_items __attribute__
         {
             // Fill the acquisition data
             current_synchro_data = *d_acquisition_gnss_synchro;
-            // Receiver signal alignment
-            if (d_pull_in == true)
+
+            // with shared loops, the group has already prepared the period and run the loops
+            if (d_loops_prepared == false) prepare_loops();
+            const bool close_loops = d_close_loops;
+            const bool bit_edge = d_bit_edge;
+            const int integration_ms = d_integration_ms;
+            double carrier_doppler_hz = d_engine->carrier_doppler_hz();
+
+            if (close_loops == true and d_loops != 0)
                 {
-                    int samples_offset;
-                    double acq_trk_shif_correction_samples;
-                    int acq_to_trk_delay_samples;
-                    acq_to_trk_delay_samples = d_sample_counter - d_acq_sample_stamp;
-                    acq_trk_shif_correction_samples = d_current_prn_length_samples - fmod(static_cast<float>(acq_to_trk_delay_samples), static_cast<float>(d_current_prn_length_samples));
-                    samples_offset = round(d_acq_code_phase_samples + acq_trk_shif_correction_samples);
-                    current_synchro_data.Tracking_timestamp_secs = (static_cast<double>(d_sample_counter) + static_cast<double>(d_rem_code_phase_samples)) / static_cast<double>(d_fs_in);
-                    d_sample_counter = d_sample_counter + samples_offset; //count for the processed samples
-                    d_pull_in = false;
-                    *out[0] = current_synchro_data;
-                    consume_each(samples_offset); //shift input to perform alignment with local replica
-                    return 1;
+                    carr_error_hz = d_loops->carrier_error_hz(d_loops_channel);
+                    code_error_chips = d_loops->code_error_chips(d_loops_channel);
                 }
+            else if (close_loops == true)
+                {
+                    // PLL discriminator, on the prompt output [rads/Ti -> Secs/Ti]
+                    carr_error_hz = d_engine->carrier_error_cycles();
+                    // DLL discriminator, on the early and late outputs [chips/Ti]
+                    code_error_chips = d_engine->code_error_chips();
+                }
+            if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::discriminators);
 
-            // ################# CARRIER WIPEOFF AND CORRELATORS ##############################
-            // perform carrier wipe-off and compute Early, Prompt and Late correlation
-            multicorrelator_cpu.set_input_output_vectors(d_correlator_outs, in);
-            multicorrelator_cpu.Carrier_wipeoff_multicorrelator_resampler(d_rem_carr_phase_rad,
-                    d_carrier_phase_step_rad,
-                    d_rem_code_phase_chips,
-                    d_code_phase_step_chips,
-                    d_current_prn_length_samples);
-
-            // ################## PLL ##########################################################
-            // PLL discriminator
-            // Update PLL discriminator [rads/Ti -> Secs/Ti]
-            carr_error_hz = pll_cloop_two_quadrant_atan(d_correlator_outs[1]) / GPS_TWO_PI; //prompt output
-            // Carrier discriminator filter
-            carr_error_filt_hz = d_carrier_loop_filter.get_carrier_nco(carr_error_hz);
-            // New carrier Doppler frequency estimation
-            d_carrier_doppler_hz = d_acq_carrier_doppler_hz + carr_error_filt_hz;
-
-            // New code Doppler frequency estimation
-            d_code_freq_chips = GPS_L1_CA_CODE_RATE_HZ + ((d_carrier_doppler_hz * GPS_L1_CA_CODE_RATE_HZ) / GPS_L1_FREQ_HZ);
-            //carrier phase accumulator for (K) doppler estimation
-            d_acc_carrier_phase_rad -= GPS_TWO_PI * d_carrier_doppler_hz * GPS_L1_CA_CODE_PERIOD;
-            //remanent carrier phase to prevent overflow in the code NCO
-            d_rem_carr_phase_rad = d_rem_carr_phase_rad + GPS_TWO_PI * ( d_if_freq + d_carrier_doppler_hz ) * GPS_L1_CA_CODE_PERIOD;
-            d_rem_carr_phase_rad = fmod(d_rem_carr_phase_rad, GPS_TWO_PI);
-
-            // ################## DLL ##########################################################
-            // DLL discriminator
-            code_error_chips = dll_nc_e_minus_l_normalized(d_correlator_outs[0], d_correlator_outs[2]); //[chips/Ti] //early and late
-            // Code discriminator filter
-            code_error_filt_chips = d_code_loop_filter.get_code_nco(code_error_chips); //[chips/second]
-            //Code phase accumulator
-            double code_error_filt_secs;
-            code_error_filt_secs = (GPS_L1_CA_CODE_PERIOD * code_error_filt_chips) / GPS_L1_CA_CODE_RATE_HZ; //[seconds]
-            d_acc_code_phase_secs = d_acc_code_phase_secs + code_error_filt_secs;
-
-            // ################## CARRIER AND CODE NCO BUFFER ALIGNEMENT #######################
-            // keep alignment parameters for the next input buffer
-            double T_chip_seconds;
-            double T_prn_seconds;
-            double T_prn_samples;
-            double K_blk_samples;
-            // Compute the next buffer length based in the new period of the PRN sequence and the code phase error estimation
-            T_chip_seconds = 1 / static_cast<double>(d_code_freq_chips);
-            T_prn_seconds = T_chip_seconds * GPS_L1_CA_CODE_LENGTH_CHIPS;
-            T_prn_samples = T_prn_seconds * static_cast<double>(d_fs_in);
-            K_blk_samples = T_prn_samples + d_rem_code_phase_samples + code_error_filt_secs * static_cast<double>(d_fs_in);
-            d_current_prn_length_samples = round(K_blk_samples); //round to a discrete samples
-
-            //################### PLL COMMANDS #################################################
-            //carrier phase step (NCO phase increment per sample) [rads/sample]
-            d_carrier_phase_step_rad = GPS_TWO_PI * d_carrier_doppler_hz / static_cast<double>(d_fs_in);
-
-            //################### DLL COMMANDS #################################################
-            //code phase step (Code resampler phase increment per sample) [chips/sample]
-            d_code_phase_step_chips = d_code_freq_chips / static_cast<double>(d_fs_in);
-            //remnant code phase [chips]
-            d_rem_code_phase_chips = d_rem_code_phase_samples * (d_code_freq_chips / static_cast<double>(d_fs_in));
+            if (close_loops == true)
+                {
+                    // ################## PLL ##########################################################
+                    // Carrier discriminator filter
+                    if (d_loops != 0)
+                        {
+                            carr_error_filt_hz = d_loops->carrier_error_filt_hz(d_loops_channel);
+                        }
+                    else
+                        {
+                            carr_error_filt_hz = d_carrier_loop_filter.get_carrier_nco(carr_error_hz);
+                        }
+                    // New carrier Doppler frequency estimation (around the navigation solution prediction in vector tracking)
+                    carrier_doppler_hz = d_carrier_doppler_reference_hz + carr_error_filt_hz;
+
+                    // ################## DLL ##########################################################
+                    // Code discriminator filter
+                    if (d_loops != 0)
+                        {
+                            code_error_filt_chips = d_loops->code_error_filt_chips(d_loops_channel);
+                        }
+                    else
+                        {
+                            code_error_filt_chips = d_code_loop_filter.get_code_nco(code_error_chips); //[chips/second]
+                        }
+                }
+            // otherwise, the NCOs keep running with the last loop outputs until the next bit edge
+
+            // ################## CARRIER AND CODE NCOS #######################################
+            // The code error of an extended integration is corrected in the period that closes it
+            d_engine->update(carrier_doppler_hz, static_cast<double>(integration_ms) * code_error_filt_chips);
+            if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::loop_filters);
 
             // ####### CN0 ESTIMATION AND LOCK DETECTORS ######
-            if (d_cn0_estimation_counter < CN0_ESTIMATION_SAMPLES)
+            // The window slides by one prompt value per loop update, so both indicators
+            // are refreshed at every update once the first CN0_ESTIMATION_SAMPLES are in
+            if (close_loops == true)
                 {
-                    // fill buffer with prompt correlator output values
-                    d_Prompt_buffer[d_cn0_estimation_counter] = d_correlator_outs[1]; //prompt
-                    d_cn0_estimation_counter++;
+                    d_lock_detector.update(d_engine->prompt());
                 }
-            else
+            if (close_loops == true and d_lock_detector.is_full())
                 {
-                    d_cn0_estimation_counter = 0;
-                    // Code lock indicator
-                    d_CN0_SNV_dB_Hz = cn0_svn_estimator(d_Prompt_buffer, CN0_ESTIMATION_SAMPLES, d_fs_in, GPS_L1_CA_CODE_LENGTH_CHIPS);
+                    // Code lock indicator (the prompt values span integration_ms code periods)
+                    d_CN0_SNV_dB_Hz = d_lock_detector.cn0_svn_estimator(d_fs_in, GPS_L1_CA_CODE_LENGTH_CHIPS * static_cast<double>(integration_ms));
+                    if (d_realtime_cost) d_realtime_cost->set_cn0_db_hz(d_CN0_SNV_dB_Hz);
                     // Carrier lock indicator
-                    d_carrier_lock_test = carrier_lock_detector(d_Prompt_buffer, CN0_ESTIMATION_SAMPLES);
-                    // Loss of lock detection
-                    if (d_carrier_lock_test < d_carrier_lock_threshold or d_CN0_SNV_dB_Hz < MINIMUM_VALID_CN0)
+                    d_carrier_lock_test = d_lock_detector.carrier_lock_detector();
+                    // Loss of lock detection. The counters are kept in milliseconds of
+                    // signal, so the loss-of-lock time does not depend on the integration time
+                    bool lock_ok = (d_carrier_lock_test >= d_carrier_lock_threshold and d_CN0_SNV_dB_Hz >= MINIMUM_VALID_CN0);
+                    if (lock_ok == false)
                         {
-                            d_carrier_lock_fail_counter++;
+                            d_carrier_lock_fail_counter += integration_ms;
+                            d_carrier_lock_ok_ms = 0;
                         }
                     else
                         {
-                            if (d_carrier_lock_fail_counter > 0) d_carrier_lock_fail_counter--;
+                            d_carrier_lock_fail_counter = std::max(d_carrier_lock_fail_counter - integration_ms, 0);
+                            d_carrier_lock_ok_ms += integration_ms;
                         }
-                    if (d_carrier_lock_fail_counter > MAXIMUM_LOCK_FAIL_COUNTER)
+                    if (d_carrier_lock_fail_counter > MAXIMUM_LOCK_FAIL_COUNTER * CN0_ESTIMATION_SAMPLES)
                         {
-                            std::cout << "Loss of lock in channel " << d_channel << "!" << std::endl;
-                            LOG(INFO) << "Loss of lock in channel " << d_channel << "!";
-                            this->message_port_pub(pmt::mp("events"), pmt::from_long(3));//3 -> loss of lock
+                            Gnss_Sdr_Event_Log::loss_of_lock(d_channel);
+                            if (d_events_publisher)
+                                {
+                                    d_events_publisher(pmt::from_long(3));//3 -> loss of lock
+                                }
+                            else
+                                {
+                                    this->message_port_pub(pmt::mp("events"), pmt::from_long(3));//3 -> loss of lock
+                                }
                             d_carrier_lock_fail_counter = 0;
+                            Acquisition_Assistance::withdraw_tracking(current_synchro_data);
                             d_enable_tracking = false; // TODO: check if disabling tracking is consistent with the channel state machine
                         }
+                    else
+                        {
+                            update_integration_time(bit_edge);
+                        }
                 }
+            if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::lock_detectors);
             // ########### Output the tracking data to navigation and PVT ##########
-            current_synchro_data.Prompt_I = static_cast<double>((d_correlator_outs[1]).real());
-            current_synchro_data.Prompt_Q = static_cast<double>((d_correlator_outs[1]).imag());
+            current_synchro_data.Prompt_I = static_cast<double>(d_engine->prompt().real());
+            current_synchro_data.Prompt_Q = static_cast<double>(d_engine->prompt().imag());
 
             // Tracking_timestamp_secs is aligned with the CURRENT PRN start sample (Hybridization OK!, but some glitches??)
-            current_synchro_data.Tracking_timestamp_secs = (static_cast<double>(d_sample_counter) + static_cast<double>(d_rem_code_phase_samples)) / static_cast<double>(d_fs_in);
-            //compute remnant code phase samples AFTER the Tracking timestamp
-            d_rem_code_phase_samples = K_blk_samples - d_current_prn_length_samples; //rounding error < 1 sample
+            current_synchro_data.set_sample_stamp(d_sample_counter, d_engine->period_start_rem_samples(), static_cast<double>(d_fs_in));
 
             //current_synchro_data.Tracking_timestamp_secs = ((double)d_sample_counter)/static_cast<double>(d_fs_in);
             // This tracking block aligns the Tracking_timestamp_secs with the start sample of the PRN, thus, Code_phase_secs=0
             current_synchro_data.Code_phase_secs = 0;
-            current_synchro_data.Carrier_phase_rads = d_acc_carrier_phase_rad;
-            current_synchro_data.Carrier_Doppler_hz = d_carrier_doppler_hz;
+            current_synchro_data.Carrier_phase_rads = d_engine->acc_carrier_phase_rad();
+            current_synchro_data.Carrier_Doppler_hz = d_engine->carrier_doppler_hz();
             current_synchro_data.CN0_dB_hz = d_CN0_SNV_dB_Hz;
-            current_synchro_data.Flag_valid_symbol_output = true;
-            current_synchro_data.correlation_length_ms = 1;
+            if (d_enable_tracking) Acquisition_Assistance::publish_tracking(current_synchro_data);
+            // with extended integration, only the outputs at the bit edges carry a symbol
+            current_synchro_data.Flag_valid_symbol_output = close_loops;
+            current_synchro_data.correlation_length_ms = integration_ms;
         }
     else
         {
-            for (int n = 0; n < d_n_correlator_taps; n++)
-                {
-                    d_correlator_outs[n] = gr_complex(0,0);
-                }
+            d_engine->clear_outputs();
 
-            current_synchro_data.Tracking_timestamp_secs = (static_cast<double>(d_sample_counter) + static_cast<double>(d_rem_code_phase_samples)) / static_cast<double>(d_fs_in);
+            current_synchro_data.set_sample_stamp(d_sample_counter, d_engine->rem_code_phase_samples(), static_cast<double>(d_fs_in));
             current_synchro_data.System = {'G'};
         }
 
     //assign the GNURadio block output data
-    *out[0] = current_synchro_data;
+    *out = current_synchro_data;
     if(d_dump)
         {
             // MULTIPLEXED FILE RECORDING - Record results to file
             float prompt_I;
             float prompt_Q;
             float tmp_E, tmp_P, tmp_L;
-            double tmp_double;
-            prompt_I = d_correlator_outs[1].real();
-            prompt_Q = d_correlator_outs[1].imag();
-            tmp_E = std::abs<float>(d_correlator_outs[0]);
-            tmp_P = std::abs<float>(d_correlator_outs[1]);
-            tmp_L = std::abs<float>(d_correlator_outs[2]);
-            try
-            {
-                // EPR
-                d_dump_file.write(reinterpret_cast<char*>(&tmp_E), sizeof(float));
-                d_dump_file.write(reinterpret_cast<char*>(&tmp_P), sizeof(float));
-                d_dump_file.write(reinterpret_cast<char*>(&tmp_L), sizeof(float));
-                // PROMPT I and Q (to analyze navigation symbols)
-                d_dump_file.write(reinterpret_cast<char*>(&prompt_I), sizeof(float));
-                d_dump_file.write(reinterpret_cast<char*>(&prompt_Q), sizeof(float));
-                // PRN start sample stamp
-                //tmp_float=(float)d_sample_counter;
-                d_dump_file.write(reinterpret_cast<char*>(&d_sample_counter), sizeof(unsigned long int));
-                // accumulated carrier phase
-                d_dump_file.write(reinterpret_cast<char*>(&d_acc_carrier_phase_rad), sizeof(double));
-
-                // carrier and code frequency
-                d_dump_file.write(reinterpret_cast<char*>(&d_carrier_doppler_hz), sizeof(double));
-                d_dump_file.write(reinterpret_cast<char*>(&d_code_freq_chips), sizeof(double));
-
-                //PLL commands
-                d_dump_file.write(reinterpret_cast<char*>(&carr_error_hz), sizeof(double));
-                d_dump_file.write(reinterpret_cast<char*>(&d_carrier_doppler_hz), sizeof(double));
-
-                //DLL commands
-                d_dump_file.write(reinterpret_cast<char*>(&code_error_chips), sizeof(double));
-                d_dump_file.write(reinterpret_cast<char*>(&code_error_filt_chips), sizeof(double));
-
-                // CN0 and carrier lock test
-                d_dump_file.write(reinterpret_cast<char*>(&d_CN0_SNV_dB_Hz), sizeof(double));
-                d_dump_file.write(reinterpret_cast<char*>(&d_carrier_lock_test), sizeof(double));
-
-                // AUX vars (for debug purposes)
-                tmp_double = d_rem_code_phase_samples;
-                d_dump_file.write(reinterpret_cast<char*>(&tmp_double), sizeof(double));
-                tmp_double = static_cast<double>(d_sample_counter + d_current_prn_length_samples);
-                d_dump_file.write(reinterpret_cast<char*>(&tmp_double), sizeof(double));
-            }
-            catch (const std::ifstream::failure &e)
-            {
-                    LOG(WARNING) << "Exception writing trk dump file " << e.what();
-            }
+            prompt_I = d_engine->prompt().real();
+            prompt_Q = d_engine->prompt().imag();
+            tmp_E = std::abs<float>(d_engine->early());
+            tmp_P = std::abs<float>(d_engine->prompt());
+            tmp_L = std::abs<float>(d_engine->late());
+            // EPR
+            d_dump_file.write(tmp_E);
+            d_dump_file.write(tmp_P);
+            d_dump_file.write(tmp_L);
+            // PROMPT I and Q (to analyze navigation symbols)
+            d_dump_file.write(prompt_I);
+            d_dump_file.write(prompt_Q);
+            // PRN start sample stamp
+            d_dump_file.write(d_sample_counter);
+            // accumulated carrier phase
+            d_dump_file.write(d_engine->acc_carrier_phase_rad());
+
+            // carrier and code frequency
+            d_dump_file.write(d_engine->carrier_doppler_hz());
+            d_dump_file.write(d_engine->code_freq_chips());
+
+            //PLL commands
+            d_dump_file.write(carr_error_hz);
+            d_dump_file.write(d_engine->carrier_doppler_hz());
+
+            //DLL commands
+            d_dump_file.write(code_error_chips);
+            d_dump_file.write(code_error_filt_chips);
+
+            // CN0 and carrier lock test
+            d_dump_file.write(d_CN0_SNV_dB_Hz);
+            d_dump_file.write(d_carrier_lock_test);
+
+            // AUX vars (for debug purposes)
+            d_dump_file.write(d_engine->rem_code_phase_samples());
+            d_dump_file.write(static_cast<double>(d_sample_counter + d_engine->current_prn_length_samples()));
+
+            // Output to telemetry, enough to replay the back end from the dump
+            d_dump_file.write(current_synchro_data.PRN);
+            d_dump_file.write(current_synchro_data.Tracking_timestamp_secs);
+            d_dump_file.write(current_synchro_data.Flag_valid_symbol_output);
+            d_dump_file.write(current_synchro_data.correlation_length_ms);
+            if (d_engine->n_monitor_taps() > 0)
+                {
+                    d_dump_file.write_array(reinterpret_cast<const float*>(d_engine->monitor_outputs()), 2 * d_engine->n_monitor_taps());
+                }
         }
 
-    consume_each(d_current_prn_length_samples); // this is necessary in gr::block derivates
-    d_sample_counter += d_current_prn_length_samples; //count for the processed samples
+    const int prn_length_samples = d_engine->current_prn_length_samples();
+    d_sample_counter += prn_length_samples; //count for the processed samples
+    d_loops_prepared = false;
+    if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::output);
+    if (d_realtime_cost) d_realtime_cost->add(d_epoch_start, prn_length_samples);
+    return prn_length_samples;
+}
+
+
+
+void Gps_L1_Ca_Dll_Pll_Tracking_cc::msg_handler_preamble_timestamp(pmt::pmt_t msg)
+{
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("Gps_L1_Ca_Dll_Pll_Tracking_cc::msg_handler_preamble_timestamp", d_channel, d_acquisition_gnss_synchro ? d_acquisition_gnss_synchro->PRN : 0);
+    if (d_extend_correlation_ms == 1 or d_enable_tracking == false) return;
+    // start of the bit that precedes the first preamble symbol
+    d_preamble_timestamp_s = pmt::to_double(msg);
+    d_preamble_synchronized = true;
+    DLOG(INFO) << "Bit synchronization for Tracking CH " << d_channel <<  ": Satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN);
+}
+
+
 
-    return 1; //output tracking result ALWAYS even in the case of d_enable_tracking==false
+void Gps_L1_Ca_Dll_Pll_Tracking_cc::update_integration_time(bool bit_edge)
+{
+    if (d_preamble_synchronized == false) return;
+    if (d_extended_integration_active == false)
+        {
+            // switch on a bit edge, so that the first integration starts with a bit
+            if (bit_edge == true and d_carrier_lock_ok_ms >= EXTENDED_INTEGRATION_MIN_LOCK_MS)
+                {
+                    d_extended_integration_active = true;
+                    LOG(INFO) << "Enabled " << d_extend_correlation_ms << " [ms] coherent integration in channel " << d_channel
+                              << " : Satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN);
+                }
+        }
+    else if (d_carrier_lock_fail_counter > EXTENDED_INTEGRATION_MAX_FAIL_MS)
+        {
+            // the carrier lock is weakening: go back to the 1 ms loops, which pull in faster
+            d_extended_integration_active = false;
+            LOG(INFO) << "Disabled extended coherent integration in channel " << d_channel
+                      << " : Satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN);
+        }
+    else
+        {
+            return;
+        }
+    for (int n = 0; n < d_engine->n_taps; n++)
+        {
+            d_integrated_outs[n] = gr_complex(0,0);
+        }
+    // the prompt values of the two modes have different amplitudes
+    d_lock_detector.reset();
+    d_carrier_lock_ok_ms = 0;
+    update_loop_filters();
+}
+
+
+
+void Gps_L1_Ca_Dll_Pll_Tracking_cc::update_loop_filters()
+{
+    float pll_bw_hz = d_pll_bw_hz;
+    float dll_bw_hz = d_dll_bw_hz;
+    float pdi = GPS_L1_CA_CODE_PERIOD;
+    if (d_vector_aiding_active == true)
+        {
+            pll_bw_hz = d_vector_pll_bw_hz;
+            dll_bw_hz = d_vector_dll_bw_hz;
+        }
+    // the narrow bandwidths take precedence, they are set for the longer integration
+    if (d_extended_integration_active == true)
+        {
+            pll_bw_hz = d_pll_bw_narrow_hz;
+            dll_bw_hz = d_dll_bw_narrow_hz;
+            pdi = static_cast<float>(d_extend_correlation_ms) * GPS_L1_CA_CODE_PERIOD;
+        }
+    if (d_loops != 0)
+        {
+            d_loops->set_pll_bw(d_loops_channel, pll_bw_hz);
+            d_loops->set_dll_bw(d_loops_channel, dll_bw_hz);
+            d_loops->set_pdi(d_loops_channel, pdi);
+            return;
+        }
+    d_carrier_loop_filter.set_PLL_BW(pll_bw_hz);
+    d_carrier_loop_filter.set_pdi(pdi);
+    d_code_loop_filter.set_DLL_BW(dll_bw_hz);
+    d_code_loop_filter.set_pdi(pdi);
+}
+
+
+
+void Gps_L1_Ca_Dll_Pll_Tracking_cc::initialize_loop_filters()
+{
+    if (d_loops != 0)
+        {
+            d_loops->initialize(d_loops_channel);
+            return;
+        }
+    d_carrier_loop_filter.initialize(); // initialize the carrier filter
+    d_code_loop_filter.initialize();    // initialize the code filter
+}
+
+
+
+void Gps_L1_Ca_Dll_Pll_Tracking_cc::msg_handler_parameters(pmt::pmt_t msg)
+{
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("Gps_L1_Ca_Dll_Pll_Tracking_cc::msg_handler_parameters", d_channel, d_acquisition_gnss_synchro ? d_acquisition_gnss_synchro->PRN : 0);
+    // the handler runs between two calls to general_work, which end at a code period
+    bool changed = false;
+    changed |= gnss_sdr_get_parameter(msg, "pll_bw_hz", d_pll_bw_hz);
+    changed |= gnss_sdr_get_parameter(msg, "dll_bw_hz", d_dll_bw_hz);
+    changed |= gnss_sdr_get_parameter(msg, "vector_pll_bw_hz", d_vector_pll_bw_hz);
+    changed |= gnss_sdr_get_parameter(msg, "vector_dll_bw_hz", d_vector_dll_bw_hz);
+    changed |= gnss_sdr_get_parameter(msg, "pll_bw_narrow_hz", d_pll_bw_narrow_hz);
+    changed |= gnss_sdr_get_parameter(msg, "dll_bw_narrow_hz", d_dll_bw_narrow_hz);
+    if (changed)
+        {
+            update_loop_filters();
+            LOG(INFO) << "Tracking channel " << d_channel << ": loop bandwidths updated, PLL "
+                      << d_pll_bw_hz << " Hz, DLL " << d_dll_bw_hz << " Hz";
+        }
+}
+
+
+
+void Gps_L1_Ca_Dll_Pll_Tracking_cc::msg_handler_stop_tracking(pmt::pmt_t msg)
+{
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("Gps_L1_Ca_Dll_Pll_Tracking_cc::msg_handler_stop_tracking", d_channel, d_acquisition_gnss_synchro ? d_acquisition_gnss_synchro->PRN : 0);
+    if (d_enable_tracking == false or pmt::is_true(msg) == false) return;
+    // the channel state machine sees a loss of lock, and the control thread keeps the channel idle
+    if (d_events_publisher)
+        {
+            d_events_publisher(pmt::from_long(3));//3 -> loss of lock
+        }
+    else
+        {
+            this->message_port_pub(pmt::mp("events"), pmt::from_long(3));//3 -> loss of lock
+        }
+    d_carrier_lock_fail_counter = 0;
+    Acquisition_Assistance::withdraw_tracking(*d_acquisition_gnss_synchro);
+    d_enable_tracking = false;
+    LOG(INFO) << "Tracking of channel " << d_channel << " stopped to shed load";
+}
+
+
+
+void Gps_L1_Ca_Dll_Pll_Tracking_cc::msg_handler_vector_tracking(pmt::pmt_t msg)
+{
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("Gps_L1_Ca_Dll_Pll_Tracking_cc::msg_handler_vector_tracking", d_channel, d_acquisition_gnss_synchro ? d_acquisition_gnss_synchro->PRN : 0);
+    if (d_vector_tracking == false or d_enable_tracking == false or pmt::is_dict(msg) == false) return;
+    long channel = pmt::to_long(pmt::dict_ref(msg, pmt::mp("channel"), pmt::from_long(-1)));
+    long prn = pmt::to_long(pmt::dict_ref(msg, pmt::mp("prn"), pmt::from_long(-1)));
+    if (channel != static_cast<long>(d_channel) or prn != static_cast<long>(d_acquisition_gnss_synchro->PRN)) return;
+    d_aiding_timestamp_s = pmt::to_double(pmt::dict_ref(msg, pmt::mp("timestamp_s"), pmt::from_double(0.0)));
+    d_aiding_range_rate_m_s = pmt::to_double(pmt::dict_ref(msg, pmt::mp("range_rate_m_s"), pmt::from_double(0.0)));
+    d_aiding_valid = true;
+}
+
+
+
+void Gps_L1_Ca_Dll_Pll_Tracking_cc::update_vector_aiding()
+{
+    if (d_vector_tracking == false) return;
+    double aiding_age_s = static_cast<double>(d_sample_counter) / static_cast<double>(d_fs_in) - d_aiding_timestamp_s;
+    if (d_aiding_valid and aiding_age_s < VECTOR_TRACKING_MAX_AIDING_AGE_S)
+        {
+            d_carrier_doppler_reference_hz = - d_aiding_range_rate_m_s * GPS_L1_FREQ_HZ / GPS_C_m_s;
+            if (d_vector_aiding_active == false)
+                {
+                    // The loops now only follow the error of the prediction, which is
+                    // common to all the channels, so they can run narrower. The code
+                    // NCO is aided by the carrier Doppler, so it follows the prediction too.
+                    d_vector_aiding_active = true;
+                    update_loop_filters();
+                    initialize_loop_filters();
+                    LOG(INFO) << "Vector tracking enabled in channel " << d_channel;
+                }
+        }
+    else if (d_vector_aiding_active == true)
+        {
+            // No recent navigation solution: keep the current Doppler and track standalone
+            d_carrier_doppler_reference_hz = d_engine->carrier_doppler_hz();
+            d_vector_aiding_active = false;
+            update_loop_filters();
+            initialize_loop_filters();
+            LOG(INFO) << "Vector tracking disabled in channel " << d_channel << ", no recent navigation solution";
+        }
 }
 
 
@@ -507,23 +974,43 @@ void Gps_L1_Ca_Dll_Pll_Tracking_cc::set_channel(unsigned int channel)
 {
     d_channel = channel;
     LOG(INFO) << "Tracking Channel set to " << d_channel;
+    d_realtime_cost = Gnss_Sdr_Realtime_Monitor::channel(d_channel, static_cast<double>(d_fs_in));
     // ############# ENABLE DATA FILE LOG #################
     if (d_dump == true)
         {
             if (d_dump_file.is_open() == false)
                 {
-                    try
-                    {
-                            d_dump_filename.append(boost::lexical_cast<std::string>(d_channel));
-                            d_dump_filename.append(".dat");
-                            d_dump_file.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-                            d_dump_file.open(d_dump_filename.c_str(), std::ios::out | std::ios::binary);
+                    d_dump_filename.append(boost::lexical_cast<std::string>(d_channel));
+                    d_dump_filename.append(".dat");
+                    d_dump_file.add_field("abs_E", BINARY_DUMP_FLOAT32);
+                    d_dump_file.add_field("abs_P", BINARY_DUMP_FLOAT32);
+                    d_dump_file.add_field("abs_L", BINARY_DUMP_FLOAT32);
+                    d_dump_file.add_field("prompt_I", BINARY_DUMP_FLOAT32);
+                    d_dump_file.add_field("prompt_Q", BINARY_DUMP_FLOAT32);
+                    d_dump_file.add_field("PRN_start_sample_count", BINARY_DUMP_UINT64);
+                    d_dump_file.add_field("acc_carrier_phase_rad", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("carrier_doppler_hz", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("code_freq_chips", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("carr_error_hz", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("carr_nco_hz", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("code_error_chips", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("code_nco_chips", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("CN0_SNV_dB_Hz", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("carrier_lock_test", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("rem_code_phase_samples", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("next_PRN_start_sample", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("PRN", BINARY_DUMP_UINT32);
+                    d_dump_file.add_field("tracking_timestamp_secs", BINARY_DUMP_FLOAT64);
+                    d_dump_file.add_field("valid_symbol", BINARY_DUMP_UINT8);
+                    d_dump_file.add_field("correlation_length_ms", BINARY_DUMP_UINT32);
+                    if (d_engine->n_monitor_taps() > 0)
+                        {
+                            d_dump_file.add_field("monitor_IQ", BINARY_DUMP_FLOAT32, 2 * d_engine->n_monitor_taps());
+                        }
+                    if (d_dump_file.open(d_dump_filename))
+                        {
                             LOG(INFO) << "Tracking dump enabled on channel " << d_channel << " Log file: " << d_dump_filename.c_str();
-                    }
-                    catch (const std::ifstream::failure &e)
-                    {
-                            LOG(WARNING) << "channel " << d_channel << " Exception opening trk dump file " << e.what();
-                    }
+                        }
                 }
         }
 }
@@ -37,14 +37,24 @@
 #ifndef GNSS_SDR_GPS_L1_CA_DLL_PLL_TRACKING_CC_H
 #define GNSS_SDR_GPS_L1_CA_DLL_PLL_TRACKING_CC_H
 
+#include <chrono>
 #include <fstream>
 #include <map>
+#include <memory>
 #include <string>
+#include <boost/function.hpp>
 #include <gnuradio/block.h>
+#include "binary_dump_writer.h"
 #include "gnss_synchro.h"
 #include "tracking_2nd_DLL_filter.h"
 #include "tracking_2nd_PLL_filter.h"
-#include "cpu_multicorrelator.h"
+#include "tracking_engine.h"
+#include "multichannel_correlator.h"
+#include "multichannel_loop_filters.h"
+#include "lock_detectors.h"
+#include "gnss_sdr_realtime_monitor.h"
+#include "gnss_sdr_tracking_profiler.h"
+#include "gnss_sample_ring.h"
 
 class Gps_L1_Ca_Dll_Pll_Tracking_cc;
 
@@ -59,7 +69,14 @@ gps_l1_ca_dll_pll_make_tracking_cc(long if_freq,
                                    std::string dump_filename,
                                    float pll_bw_hz,
                                    float dll_bw_hz,
-                                   float early_late_space_chips);
+                                   float early_late_space_chips,
+                                   bool vector_tracking,
+                                   float vector_pll_bw_hz,
+                                   float vector_dll_bw_hz,
+                                   int extend_correlation_ms,
+                                   float pll_bw_narrow_hz,
+                                   float dll_bw_narrow_hz,
+                                   Tracking_Loop_Arithmetic loop_arithmetic);
 
 
 
@@ -75,12 +92,36 @@ public:
     void set_gnss_synchro(Gnss_Synchro* p_gnss_synchro);
     void start_tracking();
 
+    /*!
+     * \brief Sends the events of the channel through \p publisher instead of
+     * the "events" port, for a block run by a tracking group.
+     */
+    void set_events_publisher(boost::function<void(pmt::pmt_t)> publisher);
+
+    /*!
+     * \brief Replayed pull-in. If the flowgraph keeps a Gnss_Sample_Ring of
+     * \p rf_channel (GNSS-SDR.sample_ring_ms), the tracking starts at the last
+     * code period of the acquired dwell and replays the ring, faster than real
+     * time, until it catches up with its input. The loops converge on the
+     * acquired samples instead of extrapolating the code phase to the live ones.
+     */
+    void set_replay_pull_in(bool replay, unsigned int rf_channel);
+
+    /*!
+     * \brief Samples the correlation peak with \p n_taps taps, \p spacing_chips
+     * apart around the prompt, computed from the FFT correlation window of
+     * each code period, and adds them to the dump ("monitor_IQ": I and Q of
+     * each tap, from the earliest one). Call it before set_channel().
+     */
+    void set_monitor_taps(int n_taps, float spacing_chips);
+
     int general_work (int noutput_items, gr_vector_int &ninput_items,
             gr_vector_const_void_star &input_items, gr_vector_void_star &output_items);
 
     void forecast (int noutput_items, gr_vector_int &ninput_items_required);
 
 private:
+    friend class gps_l1_ca_dll_pll_tracking_group_cc;
     friend gps_l1_ca_dll_pll_tracking_cc_sptr
     gps_l1_ca_dll_pll_make_tracking_cc(long if_freq,
             long fs_in, unsigned
@@ -89,7 +130,14 @@ private:
             std::string dump_filename,
             float pll_bw_hz,
             float dll_bw_hz,
-            float early_late_space_chips);
+            float early_late_space_chips,
+            bool vector_tracking,
+            float vector_pll_bw_hz,
+            float vector_dll_bw_hz,
+            int extend_correlation_ms,
+            float pll_bw_narrow_hz,
+            float dll_bw_narrow_hz,
+            Tracking_Loop_Arithmetic loop_arithmetic);
 
     Gps_L1_Ca_Dll_Pll_Tracking_cc(long if_freq,
             long fs_in, unsigned
@@ -98,7 +146,80 @@ private:
             std::string dump_filename,
             float pll_bw_hz,
             float dll_bw_hz,
-            float early_late_space_chips);
+            float early_late_space_chips,
+            bool vector_tracking,
+            float vector_pll_bw_hz,
+            float vector_dll_bw_hz,
+            int extend_correlation_ms,
+            float pll_bw_narrow_hz,
+            float dll_bw_narrow_hz,
+            Tracking_Loop_Arithmetic loop_arithmetic);
+
+    /*
+     * Runs the tracking loop over the code period that starts at in, writes the
+     * result to out and returns the number of samples it spans, or -1 if the
+     * available_samples do not hold the whole period.
+     */
+    int track_epoch(const gr_complex* in, int available_samples, Gnss_Synchro* out);
+
+    /*
+     * track_epoch() in two halves, so that a tracking group can correlate the
+     * code periods of its members in one sweep. begin_epoch() returns -1 if the
+     * available_samples do not hold the whole period, or the samples it takes.
+     * If pending is set, the period still has to be correlated, with correlate()
+     * or submit(), and end_epoch() completes it and returns its samples instead.
+     */
+    int begin_epoch(int available_samples, Gnss_Synchro* out, bool& pending);
+    void correlate(const gr_complex* in);
+    void submit(multichannel_correlator& correlator, int channel, const gr_complex* in);
+    int end_epoch(Gnss_Synchro* out);
+
+    //! Registers the code, taps and outputs of the correlators in a shared correlator
+    int add_to(multichannel_correlator& correlator);
+
+    /*
+     * Registers the discriminators and loop filters in shared loop filters,
+     * which then replace the scalar ones. With shared loops, end_epoch() is
+     * split too: prepare_loops() returns true if the loops close at this
+     * period, and then multichannel_loop_filters::execute() has to run for
+     * the channel before end_epoch() reads its outputs.
+     */
+    int add_to(multichannel_loop_filters& loops);
+    bool prepare_loops();
+
+    /*
+     * Replayed pull-in: tracks the code periods stored in d_ring from
+     * d_sample_counter on, and returns the number of outputs. Once the live
+     * input holds the next period, d_replaying is cleared and consumed is the
+     * number of input samples before it.
+     */
+    int replay_epochs(int available_samples, Gnss_Synchro* out, int noutput_items, int& consumed);
+
+    /*
+     * Vector tracking: stores the pseudorange rate that the PVT block predicts
+     * for this channel, and switches the loops between the prediction (with
+     * the vector bandwidths) and standalone tracking when it becomes stale.
+     */
+    void msg_handler_vector_tracking(pmt::pmt_t msg);
+    void update_vector_aiding();
+
+    /*
+     * Extended coherent integration: once the telemetry decoder reports the
+     * bit edges, the loops integrate over d_extend_correlation_ms code periods
+     * while the carrier lock holds, and go back to 1 ms when it weakens.
+     */
+    void msg_handler_preamble_timestamp(pmt::pmt_t msg);
+    void update_integration_time(bool bit_edge);
+
+    // New loop bandwidths from the configuration file, see gnss_sdr_parameters.h
+    void msg_handler_parameters(pmt::pmt_t msg);
+
+    // Stops the tracking as after a loss of lock, for the overload protection of the receiver
+    void msg_handler_stop_tracking(pmt::pmt_t msg);
+
+    // Sets the loop bandwidths and update interval for the current mode
+    void update_loop_filters();
+    void initialize_loop_filters();
 
     // tracking configuration vars
     unsigned int d_vector_length;
@@ -110,62 +231,84 @@ private:
     long d_if_freq;
     long d_fs_in;
 
-    double d_early_late_spc_chips;
-
-    // remaining code phase and carrier phase between tracking loops
-    double d_rem_code_phase_samples;
-    double d_rem_code_phase_chips;
-    double d_rem_carr_phase_rad;
+    // correlators and code and carrier NCOs
+    std::unique_ptr<Tracking_Engine_Base<Gps_L1_Ca_Tracking_Traits, gr_complex> > d_engine;
 
     // PLL and DLL filter library
     Tracking_2nd_DLL_filter d_code_loop_filter;
     Tracking_2nd_PLL_filter d_carrier_loop_filter;
+    // shared loop filters of a tracking group, if any, and the channel in them
+    multichannel_loop_filters* d_loops;
+    int d_loops_channel;
+    // the period being tracked, see prepare_loops()
+    bool d_loops_prepared;
+    bool d_close_loops;
+    bool d_bit_edge;
+    int d_integration_ms;
 
     // acquisition
     double d_acq_code_phase_samples;
     double d_acq_carrier_doppler_hz;
-    // correlator
-    int d_n_correlator_taps;
-    gr_complex* d_ca_code;
-    float* d_local_code_shift_chips;
-    gr_complex* d_correlator_outs;
-    cpu_multicorrelator multicorrelator_cpu;
-
-
-    // tracking vars
-    double d_code_freq_chips;
-    double d_code_phase_step_chips;
-    double d_carrier_doppler_hz;
-    double d_carrier_phase_step_rad;
-    double d_acc_carrier_phase_rad;
-    double d_code_phase_samples;
-    double d_acc_code_phase_secs;
-
-    //PRN period in samples
-    int d_current_prn_length_samples;
+
+    // vector tracking
+    bool d_vector_tracking;
+    float d_pll_bw_hz;
+    float d_dll_bw_hz;
+    float d_vector_pll_bw_hz;
+    float d_vector_dll_bw_hz;
+    bool d_aiding_valid;
+    bool d_vector_aiding_active;
+    double d_aiding_timestamp_s;
+    double d_aiding_range_rate_m_s;
+    double d_carrier_doppler_reference_hz; // the PLL tracks the residual with respect to this Doppler
+
+    // extended coherent integration
+    int d_extend_correlation_ms;
+    float d_pll_bw_narrow_hz;
+    float d_dll_bw_narrow_hz;
+    bool d_preamble_synchronized;
+    bool d_extended_integration_active;
+    double d_preamble_timestamp_s;
+    gr_complex* d_integrated_outs;
 
     //processing samples counters
     unsigned long int d_sample_counter;
     unsigned long int d_acq_sample_stamp;
 
     // CN0 estimation and lock detector
-    int d_cn0_estimation_counter;
-    gr_complex* d_Prompt_buffer;
+    Sliding_Lock_Detector d_lock_detector;
     double d_carrier_lock_test;
     double d_CN0_SNV_dB_Hz;
     double d_carrier_lock_threshold;
     int d_carrier_lock_fail_counter;
+    int d_carrier_lock_ok_ms;
 
     // control vars
     bool d_enable_tracking;
     bool d_pull_in;
 
+    // replayed pull-in, see set_replay_pull_in()
+    bool d_replay_pull_in;
+    unsigned int d_rf_channel;
+    std::shared_ptr<Gnss_Sample_Ring> d_ring;
+    gr_complex* d_replay_buffer;
+    unsigned long int d_replay_stamp;   // stamp of the first replayed sample
+    bool d_replaying;
+
     // file dump
     std::string d_dump_filename;
-    std::ofstream d_dump_file;
+    Binary_Dump_Writer d_dump_file;
 
     std::map<std::string, std::string> systemName;
     std::string sys;
+
+    boost::function<void(pmt::pmt_t)> d_events_publisher;
+
+    // wall-clock cost of the code periods, null unless the real-time monitor is enabled
+    std::shared_ptr<Gnss_Sdr_Channel_Cost> d_realtime_cost;
+    std::chrono::steady_clock::time_point d_epoch_start;
+    // time per phase of the epochs, null unless the tracking profiler is enabled
+    std::shared_ptr<Gnss_Sdr_Tracking_Profile> d_profile;
 };
 
 #endif //GNSS_SDR_GPS_L1_CA_DLL_PLL_TRACKING_CC_H
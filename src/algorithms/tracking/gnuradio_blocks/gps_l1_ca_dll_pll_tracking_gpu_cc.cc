@@ -29,6 +29,7 @@
  */
 
 #include "gps_l1_ca_dll_pll_tracking_gpu_cc.h"
+#include <chrono>
 #include <cmath>
 #include <iostream>
 #include <memory>
@@ -42,6 +43,9 @@
 #include "lock_detectors.h"
 #include "GPS_L1_CA.h"
 #include "control_message_factory.h"
+#include "gnss_sdr_event_log.h"
+#include "correlator_backend_scheduler.h"
+#include "gnss_sdr_trace.h"
 // includes
 #include <cuda_profiler_api.h>
 
@@ -124,7 +128,6 @@ Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc::Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc(
     cudaHostAlloc((void**)&d_ca_code, (static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS)* sizeof(gr_complex)), cudaHostAllocMapped || cudaHostAllocWriteCombined);
     // Get space for the resampled early / prompt / late local replicas
     cudaHostAlloc((void**)&d_local_code_shift_chips, d_n_correlator_taps * sizeof(float),  cudaHostAllocMapped || cudaHostAllocWriteCombined);
-    cudaHostAlloc((void**)&in_gpu, 2 * d_vector_length * sizeof(gr_complex), cudaHostAllocMapped || cudaHostAllocWriteCombined);
     // correlator outputs (scalar)
     cudaHostAlloc((void**)&d_correlator_outs ,sizeof(gr_complex)*d_n_correlator_taps, cudaHostAllocMapped ||  cudaHostAllocWriteCombined );
 
@@ -135,10 +138,13 @@ Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc::Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc(
 
 
     //--- Perform initializations ------------------------------
-    multicorrelator_gpu = new cuda_multicorrelator();
-    //local code resampler on GPU
-    multicorrelator_gpu->init_cuda_integrated_resampler(2 * d_vector_length, GPS_L1_CA_CODE_LENGTH_CHIPS, d_n_correlator_taps);
-    multicorrelator_gpu->set_input_output_vectors(d_correlator_outs, in_gpu);
+    // the GPU correlators are those of the service of the RF channel, taken in start_tracking()
+    d_service_channel = -1;
+    d_service_active = false;
+    d_profile = Gnss_Sdr_Tracking_Profiler::profile("Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc");
+    // CPU correlators of the same taps, used when the scheduler moves the channel off the GPU,
+    // and for the epochs that the service cannot correlate
+    multicorrelator_cpu.init(2 * d_vector_length, d_n_correlator_taps);
 
     // define initial code frequency basis of NCO
     d_code_freq_chips = GPS_L1_CA_CODE_RATE_HZ;
@@ -170,6 +176,7 @@ Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc::Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc(
 
     d_acquisition_gnss_synchro = 0;
     d_channel = 0;
+    d_rf_channel = 0;
     d_acq_code_phase_samples = 0.0;
     d_acq_carrier_doppler_hz = 0.0;
     d_carrier_doppler_hz = 0.0;
@@ -238,7 +245,31 @@ void Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc::start_tracking()
     // generate local reference ALWAYS starting at chip 1 (1 sample per chip)
     gps_l1_ca_code_gen_complex(d_ca_code, d_acquisition_gnss_synchro->PRN, 0);
 
-    multicorrelator_gpu->set_local_code_and_taps(static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS), d_ca_code, d_local_code_shift_chips, d_n_correlator_taps);
+    std::shared_ptr<Cuda_Tracking_Service> service = Cuda_Tracking_Service_Store::instance().get(d_rf_channel, d_fs_in);
+    if (service != d_service)
+        {
+            // a new RF channel, the channel of the old service stays unused
+            set_service_active(false);
+            d_service = service;
+            d_service_channel = -1;
+        }
+    if (d_service_channel < 0)
+        {
+            d_service_channel = d_service->add_channel(static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS), d_ca_code,
+                    d_local_code_shift_chips, d_n_correlator_taps, d_correlator_outs);
+        }
+    else if (!d_service->set_local_code(d_service_channel, static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS), d_ca_code,
+            d_local_code_shift_chips, d_n_correlator_taps))
+        {
+            set_service_active(false);
+            d_service_channel = -1;
+        }
+    if (d_service_channel < 0)
+        {
+            LOG(WARNING) << "Tracking channel " << d_channel << ": no GPU correlators, the channel runs on the CPU";
+        }
+    multicorrelator_cpu.set_local_code_and_taps(static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS), d_ca_code, d_local_code_shift_chips);
+    Correlator_Backend_Scheduler::instance().assign(d_channel);
 
     for (int n = 0; n < d_n_correlator_taps; n++)
         {
@@ -257,8 +288,7 @@ void Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc::start_tracking()
     sys = sys_.substr(0,1);
 
     // DEBUG OUTPUT
-    std::cout << "Tracking start on channel " << d_channel << " for satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN) << std::endl;
-    LOG(INFO) << "Starting tracking of satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN) << " on channel " << d_channel;
+    Gnss_Sdr_Event_Log::tracking_start(d_channel, d_acquisition_gnss_synchro->System, d_acquisition_gnss_synchro->PRN);
 
 
     // enable tracking
@@ -275,20 +305,30 @@ Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc::~Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc()
 {
 
     d_dump_file.close();
-    cudaFreeHost(in_gpu);
+    set_service_active(false);
     cudaFreeHost(d_correlator_outs);
     cudaFreeHost(d_local_code_shift_chips);
     cudaFreeHost(d_ca_code);
-    multicorrelator_gpu->free_cuda();
+    multicorrelator_cpu.free();
     delete[] d_Prompt_buffer;
-    delete(multicorrelator_gpu);
+}
+
+
+void Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc::set_service_active(bool active)
+{
+    if (d_service and d_service_channel >= 0 and d_service_active != active)
+        {
+            d_service->set_active(d_service_channel, active);
+            d_service_active = active;
+        }
 }
 
 
 
-int Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
+int Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items,
         gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc::general_work", d_channel, d_acquisition_gnss_synchro ? d_acquisition_gnss_synchro->PRN : 0);
     // Block input data and block output stream pointers
     const gr_complex* in = (gr_complex*) input_items[0]; //PRN start block alignment
     Gnss_Synchro **out = (Gnss_Synchro **) &output_items[0];
@@ -305,6 +345,13 @@ int Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc::general_work (int noutput_items __attribu
     double dll_code_error_secs_Ti = 0.0;
     double carr_phase_error_secs_Ti = 0.0;
     double old_d_rem_code_phase_samples;
+    if (d_profile) d_profile->start();
+    // every sample goes to the ring of the service before it is consumed, even
+    // when this channel is not tracking, since the others may need it
+    if (d_service)
+        {
+            d_service->push(d_sample_counter, in, ninput_items[0]);
+        }
     if (d_enable_tracking == true)
         {
             // Fill the acquisition data
@@ -319,7 +366,7 @@ int Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc::general_work (int noutput_items __attribu
                     acq_trk_shif_correction_samples = d_correlation_length_samples - fmod(static_cast<double>(acq_to_trk_delay_samples), static_cast<double>(d_correlation_length_samples));
                     samples_offset = round(d_acq_code_phase_samples + acq_trk_shif_correction_samples);
 
-                    current_synchro_data.Tracking_timestamp_secs = (static_cast<double>(d_sample_counter) + static_cast<double>(d_rem_code_phase_samples)) / static_cast<double>(d_fs_in);
+                    current_synchro_data.set_sample_stamp(d_sample_counter, static_cast<double>(d_rem_code_phase_samples), static_cast<double>(d_fs_in));
                     *out[0] = current_synchro_data;
 
                     d_sample_counter += samples_offset; //count for the processed samples
@@ -331,22 +378,47 @@ int Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc::general_work (int noutput_items __attribu
             // ################# CARRIER WIPEOFF AND CORRELATORS ##############################
             // perform carrier wipe-off and compute Early, Prompt and Late correlation
 
-            memcpy(in_gpu, in, sizeof(gr_complex) * d_correlation_length_samples);
-            cudaProfilerStart();
-            multicorrelator_gpu->Carrier_wipeoff_multicorrelator_resampler_cuda( static_cast<float>(d_rem_carrier_phase_rad),
-                    static_cast<float>(d_carrier_phase_step_rad),
-                    static_cast<float>(d_code_phase_step_chips),
-                    static_cast<float>(d_rem_code_phase_chips),
-                    d_correlation_length_samples, d_n_correlator_taps);
-            cudaProfilerStop();
+            // the backend may change from one epoch to the next, the NCO state is the same for both
+            std::chrono::steady_clock::time_point correlation_start = std::chrono::steady_clock::now();
+            set_service_active(Correlator_Backend_Scheduler::instance().backend(d_channel) == CORRELATOR_BACKEND_GPU);
+            bool correlated = false;
+            if (d_service_active)
+                {
+                    cudaProfilerStart();
+                    correlated = d_service->correlate(d_service_channel, d_sample_counter,
+                            static_cast<float>(d_rem_carrier_phase_rad),
+                            static_cast<float>(d_carrier_phase_step_rad),
+                            static_cast<float>(d_rem_code_phase_chips),
+                            static_cast<float>(d_code_phase_step_chips),
+                            d_correlation_length_samples);
+                    cudaProfilerStop();
+                }
+            if (!correlated)
+                {
+                    multicorrelator_cpu.set_input_output_vectors(d_correlator_outs, in);
+                    multicorrelator_cpu.Carrier_wipeoff_multicorrelator_resampler(static_cast<float>(d_rem_carrier_phase_rad),
+                            static_cast<float>(d_carrier_phase_step_rad),
+                            static_cast<float>(d_rem_code_phase_chips),
+                            static_cast<float>(d_code_phase_step_chips),
+                            d_correlation_length_samples);
+                }
+            std::chrono::steady_clock::time_point correlation_end = std::chrono::steady_clock::now();
+            Correlator_Backend_Scheduler::instance().report(d_channel,
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(correlation_end - correlation_start).count() / 1000.0,
+                    1e6 * static_cast<double>(d_correlation_length_samples) / static_cast<double>(d_fs_in));
             //std::cout<<"c_out[0]="<<d_correlator_outs[0]<<"c_out[1]="<<d_correlator_outs[1]<<"c_out[2]="<<d_correlator_outs[2]<<std::endl;
 
             // UPDATE INTEGRATION TIME
             CURRENT_INTEGRATION_TIME_S = static_cast<double>(d_correlation_length_samples) / static_cast<double>(d_fs_in);
+            if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::correlation);
 
-            // ################## PLL ##########################################################
             // Update PLL discriminator [rads/Ti -> Secs/Ti]
             carr_phase_error_secs_Ti = pll_cloop_two_quadrant_atan(d_correlator_outs[1]) / GPS_TWO_PI; //prompt output
+            // DLL discriminator
+            code_error_chips_Ti = dll_nc_e_minus_l_normalized(d_correlator_outs[0], d_correlator_outs[2]); //[chips/Ti] //early and late
+            if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::discriminators);
+
+            // ################## PLL ##########################################################
             // Carrier discriminator filter
             // NOTICE: The carrier loop filter includes the Carrier Doppler accumulator, as described in Kaplan
             //d_carrier_doppler_hz = d_acq_carrier_doppler_hz + carr_phase_error_filt_secs_ti/INTEGRATION_TIME;
@@ -358,8 +430,6 @@ int Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc::general_work (int noutput_items __attribu
             d_code_freq_chips = GPS_L1_CA_CODE_RATE_HZ + ((d_carrier_doppler_hz * GPS_L1_CA_CODE_RATE_HZ) / GPS_L1_FREQ_HZ);
 
             // ################## DLL ##########################################################
-            // DLL discriminator
-            code_error_chips_Ti = dll_nc_e_minus_l_normalized(d_correlator_outs[0], d_correlator_outs[2]); //[chips/Ti] //early and late
             // Code discriminator filter
             code_error_filt_chips = d_code_loop_filter.get_code_nco(code_error_chips_Ti); //input [chips/Ti] -> output [chips/second]
             code_error_filt_secs_Ti = code_error_filt_chips*CURRENT_INTEGRATION_TIME_S/d_code_freq_chips; // [s/Ti]
@@ -400,6 +470,7 @@ int Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc::general_work (int noutput_items __attribu
             d_code_phase_step_chips = d_code_freq_chips / static_cast<double>(d_fs_in);
             //remnant code phase [chips]
             d_rem_code_phase_chips = d_rem_code_phase_samples * (d_code_freq_chips / static_cast<double>(d_fs_in));
+            if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::loop_filters);
 
             // ####### CN0 ESTIMATION AND LOCK DETECTORS #######################################
             if (d_cn0_estimation_counter < CN0_ESTIMATION_SAMPLES)
@@ -426,19 +497,21 @@ int Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc::general_work (int noutput_items __attribu
                         }
                     if (d_carrier_lock_fail_counter > MAXIMUM_LOCK_FAIL_COUNTER)
                         {
-                            std::cout << "Loss of lock in channel " << d_channel << "!" << std::endl;
-                            LOG(INFO) << "Loss of lock in channel " << d_channel << "!";
+                            Gnss_Sdr_Event_Log::loss_of_lock(d_channel);
                             this->message_port_pub(pmt::mp("events"), pmt::from_long(3));//3 -> loss of lock
                             d_carrier_lock_fail_counter = 0;
+                            Correlator_Backend_Scheduler::instance().release(d_channel);
+                            set_service_active(false);
                             d_enable_tracking = false; // TODO: check if disabling tracking is consistent with the channel state machine
                         }
                 }
+            if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::lock_detectors);
 
             // ########### Output the tracking data to navigation and PVT ##########
             current_synchro_data.Prompt_I = static_cast<double>((d_correlator_outs[1]).real());
             current_synchro_data.Prompt_Q = static_cast<double>((d_correlator_outs[1]).imag());
             // Tracking_timestamp_secs is aligned with the CURRENT PRN start sample (Hybridization OK!)
-            current_synchro_data.Tracking_timestamp_secs = (static_cast<double>(d_sample_counter) + old_d_rem_code_phase_samples) / static_cast<double>(d_fs_in);
+            current_synchro_data.set_sample_stamp(d_sample_counter, old_d_rem_code_phase_samples, static_cast<double>(d_fs_in));
             // This tracking block aligns the Tracking_timestamp_secs with the start sample of the PRN, thus, Code_phase_secs=0
             current_synchro_data.Code_phase_secs = 0;
             current_synchro_data.Carrier_phase_rads = GPS_TWO_PI * d_acc_carrier_phase_cycles;
@@ -457,7 +530,7 @@ int Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc::general_work (int noutput_items __attribu
                 }
 
             current_synchro_data.System = {'G'};
-            current_synchro_data.Tracking_timestamp_secs = (static_cast<double>(d_sample_counter) + static_cast<double>(d_rem_code_phase_samples)) / static_cast<double>(d_fs_in);
+            current_synchro_data.set_sample_stamp(d_sample_counter, static_cast<double>(d_rem_code_phase_samples), static_cast<double>(d_fs_in));
         }
 
     //assign the GNURadio block output data
@@ -520,6 +593,7 @@ int Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc::general_work (int noutput_items __attribu
 
     consume_each(d_correlation_length_samples); // this is necessary in gr::block derivates
     d_sample_counter += d_correlation_length_samples; //count for the processed samples
+    if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::output);
 
     return 1; //output tracking result ALWAYS even in the case of d_enable_tracking==false
 }
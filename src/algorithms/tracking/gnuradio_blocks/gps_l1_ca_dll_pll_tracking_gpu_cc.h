@@ -38,12 +38,15 @@
 
 #include <fstream>
 #include <map>
+#include <memory>
 #include <string>
 #include <gnuradio/block.h>
 #include "gnss_synchro.h"
 #include "tracking_2nd_DLL_filter.h"
 #include "tracking_FLL_PLL_filter.h"
-#include "cuda_multicorrelator.h"
+#include "cuda_tracking_service.h"
+#include "cpu_multicorrelator.h"
+#include "gnss_sdr_tracking_profiler.h"
 
 class Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc;
 
@@ -64,6 +67,11 @@ gps_l1_ca_dll_pll_make_tracking_gpu_cc(long if_freq,
 
 /*!
  * \brief This class implements a DLL + PLL tracking loop block
+ *
+ * The correlators of each epoch run on the GPU or on the CPU, as decided
+ * by Correlator_Backend_Scheduler from the latency of the previous epochs.
+ * On the GPU, the epochs of all the channels of an RF channel are batched
+ * by a Cuda_Tracking_Service, that keeps their input on the device.
  */
 class Gps_L1_Ca_Dll_Pll_Tracking_GPU_cc: public gr::block
 {
@@ -74,6 +82,14 @@ public:
     void set_gnss_synchro(Gnss_Synchro* p_gnss_synchro);
     void start_tracking();
 
+    /*!
+     * \brief Channels of the same RF channel share a Cuda_Tracking_Service
+     */
+    void set_rf_channel(unsigned int rf_channel)
+    {
+        d_rf_channel = rf_channel;
+    }
+
     int general_work (int noutput_items, gr_vector_int &ninput_items,
             gr_vector_const_void_star &input_items, gr_vector_void_star &output_items);
 
@@ -100,6 +116,7 @@ private:
             float early_late_space_chips);
     void update_local_code();
     void update_local_carrier();
+    void set_service_active(bool active);
 
     // tracking configuration vars
     unsigned int d_vector_length;
@@ -107,6 +124,7 @@ private:
 
     Gnss_Synchro* d_acquisition_gnss_synchro;
     unsigned int d_channel;
+    unsigned int d_rf_channel;
 
     long d_if_freq;
     long d_fs_in;
@@ -116,10 +134,13 @@ private:
 
 
     //GPU HOST PINNED MEMORY IN/OUT VECTORS
-    gr_complex* in_gpu;
     float* d_local_code_shift_chips;
     gr_complex* d_correlator_outs;
-    cuda_multicorrelator *multicorrelator_gpu;
+    cpu_multicorrelator multicorrelator_cpu;
+    // batched GPU correlators, and the channel of this block in them
+    std::shared_ptr<Cuda_Tracking_Service> d_service;
+    int d_service_channel;
+    bool d_service_active;
     gr_complex* d_ca_code;
 
     gr_complex *d_Early;
@@ -174,6 +195,9 @@ private:
 
     std::map<std::string, std::string> systemName;
     std::string sys;
+
+    // time per phase of the epochs, null unless the tracking profiler is enabled
+    std::shared_ptr<Gnss_Sdr_Tracking_Profile> d_profile;
 };
 
 #endif //GNSS_SDR_GPS_L1_CA_DLL_PLL_TRACKING_GPU_CC_H
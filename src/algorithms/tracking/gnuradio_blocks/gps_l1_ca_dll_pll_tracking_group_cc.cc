@@ -0,0 +1,396 @@
+/*!
+ * \file gps_l1_ca_dll_pll_tracking_group_cc.cc
+ * \brief Block that runs the GPS L1 C/A DLL + PLL tracking of a group of channels
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gps_l1_ca_dll_pll_tracking_group_cc.h"
+#include <algorithm>
+#include <map>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/weak_ptr.hpp>
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+#include "gnss_sdr_latency_tracer.h"
+#include "gnss_synchro.h"
+#include "gnss_sdr_trace.h"
+
+
+using google::LogMessage;
+
+namespace
+{
+// the group of each role that is being filled
+boost::mutex groups_mutex;
+std::map<std::string, boost::weak_ptr<gps_l1_ca_dll_pll_tracking_group_cc> > groups;
+}
+
+
+gps_l1_ca_dll_pll_tracking_group_cc_sptr
+gps_l1_ca_dll_pll_make_tracking_group_cc(unsigned int group_size,
+        unsigned int threads,
+        unsigned int vector_length,
+        bool shared_correlator)
+{
+    return gps_l1_ca_dll_pll_tracking_group_cc_sptr(new gps_l1_ca_dll_pll_tracking_group_cc(group_size,
+            threads, vector_length, shared_correlator));
+}
+
+
+gps_l1_ca_dll_pll_tracking_group_cc_sptr
+gps_l1_ca_dll_pll_tracking_group_join(const std::string& role,
+        unsigned int group_size,
+        unsigned int threads,
+        unsigned int vector_length,
+        gps_l1_ca_dll_pll_tracking_cc_sptr tracking,
+        unsigned int& port,
+        bool shared_correlator)
+{
+    boost::mutex::scoped_lock lock(groups_mutex);
+    gps_l1_ca_dll_pll_tracking_group_cc_sptr group = groups[role].lock();
+    if (!group or group->members() >= group->group_size())
+        {
+            group = gps_l1_ca_dll_pll_make_tracking_group_cc(group_size, threads, vector_length, shared_correlator);
+            groups[role] = group;
+        }
+    port = group->add_member(tracking);
+    return group;
+}
+
+
+gps_l1_ca_dll_pll_tracking_group_cc::gps_l1_ca_dll_pll_tracking_group_cc(unsigned int group_size,
+        unsigned int threads,
+        unsigned int vector_length,
+        bool shared_correlator) :
+        gr::block("Gps_L1_Ca_Dll_Pll_Tracking_Group_cc", gr::io_signature::make(1, group_size, sizeof(gr_complex)),
+                gr::io_signature::make(1, group_size, sizeof(Gnss_Synchro))),
+        d_group_size(group_size), d_threads(std::max(threads, 1u)), d_vector_length(vector_length),
+        d_shared_correlator(shared_correlator),
+        d_noutput_items(0), d_ninput_items(0), d_input_items(0), d_output_items(0),
+        d_next_member(0), d_generation(0), d_pending(0), d_stopping(false)
+{
+    // Navigation solution predictions from the PVT block, for all the members
+    this->message_port_register_in(pmt::mp("vector_tracking"));
+    this->set_msg_handler(pmt::mp("vector_tracking"), boost::bind(&gps_l1_ca_dll_pll_tracking_group_cc::msg_handler_vector_tracking, this, _1));
+    // The members share their role, and so the updates of their parameters
+    this->message_port_register_in(pmt::mp("parameters"));
+    this->set_msg_handler(pmt::mp("parameters"), boost::bind(&gps_l1_ca_dll_pll_tracking_group_cc::msg_handler_parameters, this, _1));
+}
+
+
+gps_l1_ca_dll_pll_tracking_group_cc::~gps_l1_ca_dll_pll_tracking_group_cc()
+{
+    stop();
+}
+
+
+int gps_l1_ca_dll_pll_tracking_group_cc::add_member(gps_l1_ca_dll_pll_tracking_cc_sptr tracking)
+{
+    if (d_members.size() >= d_group_size) return -1;
+    const unsigned int member = d_members.size();
+    const std::string suffix = "_" + boost::lexical_cast<std::string>(member);
+    d_members.push_back(tracking);
+    d_consumed.push_back(0);
+    d_produced.push_back(0);
+
+    this->message_port_register_in(pmt::mp("preamble_timestamp_s" + suffix));
+    this->set_msg_handler(pmt::mp("preamble_timestamp_s" + suffix), boost::bind(&gps_l1_ca_dll_pll_tracking_group_cc::msg_handler_preamble_timestamp, this, member, _1));
+    this->message_port_register_in(pmt::mp("stop_tracking" + suffix));
+    this->set_msg_handler(pmt::mp("stop_tracking" + suffix), boost::bind(&gps_l1_ca_dll_pll_tracking_group_cc::msg_handler_stop_tracking, this, member, _1));
+    this->message_port_register_out(pmt::mp("events" + suffix));
+    tracking->set_events_publisher(boost::bind(&gps_l1_ca_dll_pll_tracking_group_cc::publish_event, this, member, _1));
+    return member;
+}
+
+
+void gps_l1_ca_dll_pll_tracking_group_cc::msg_handler_preamble_timestamp(unsigned int member, pmt::pmt_t msg)
+{
+    GNSS_SDR_TRACE_SCOPE("gps_l1_ca_dll_pll_tracking_group_cc::msg_handler_preamble_timestamp");
+    d_members.at(member)->msg_handler_preamble_timestamp(msg);
+}
+
+
+void gps_l1_ca_dll_pll_tracking_group_cc::msg_handler_stop_tracking(unsigned int member, pmt::pmt_t msg)
+{
+    GNSS_SDR_TRACE_SCOPE("gps_l1_ca_dll_pll_tracking_group_cc::msg_handler_stop_tracking");
+    d_members.at(member)->msg_handler_stop_tracking(msg);
+}
+
+
+void gps_l1_ca_dll_pll_tracking_group_cc::msg_handler_vector_tracking(pmt::pmt_t msg)
+{
+    GNSS_SDR_TRACE_SCOPE("gps_l1_ca_dll_pll_tracking_group_cc::msg_handler_vector_tracking");
+    // each member keeps only the predictions of its own channel
+    for (unsigned int member = 0; member < d_members.size(); member++)
+        {
+            d_members.at(member)->msg_handler_vector_tracking(msg);
+        }
+}
+
+
+void gps_l1_ca_dll_pll_tracking_group_cc::msg_handler_parameters(pmt::pmt_t msg)
+{
+    GNSS_SDR_TRACE_SCOPE("gps_l1_ca_dll_pll_tracking_group_cc::msg_handler_parameters");
+    for (unsigned int member = 0; member < d_members.size(); member++)
+        {
+            d_members.at(member)->msg_handler_parameters(msg);
+        }
+}
+
+
+void gps_l1_ca_dll_pll_tracking_group_cc::publish_event(unsigned int member, pmt::pmt_t msg)
+{
+    this->message_port_pub(pmt::mp("events_" + boost::lexical_cast<std::string>(member)), msg);
+}
+
+
+bool gps_l1_ca_dll_pll_tracking_group_cc::start()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_stopping = false;
+    const unsigned int threads = std::max(std::min(d_threads, static_cast<unsigned int>(d_members.size())), 1u);
+    d_correlators.clear();
+    d_correlator_ids.assign(d_members.size(), -1);
+    d_loops.clear();
+    d_loops_ids.assign(d_members.size(), -1);
+    if (d_shared_correlator)
+        {
+            // member i is tracked by thread i % threads
+            for (unsigned int thread = 0; thread < threads; thread++)
+                {
+                    d_correlators.push_back(boost::shared_ptr<multichannel_correlator>(new multichannel_correlator()));
+                    d_correlators.back()->init(3); // Early, Prompt and Late
+                    d_loops.push_back(boost::shared_ptr<multichannel_loop_filters>(new multichannel_loop_filters()));
+                    d_loops.back()->init((d_members.size() + threads - 1) / threads);
+                }
+            for (unsigned int member = 0; member < d_members.size(); member++)
+                {
+                    d_correlator_ids.at(member) = d_members.at(member)->add_to(*d_correlators.at(member % threads));
+                    d_loops_ids.at(member) = d_members.at(member)->add_to(*d_loops.at(member % threads));
+                }
+        }
+    // the scheduler thread of the block tracks members too
+    for (unsigned int thread = 1; thread < threads; thread++)
+        {
+            d_workers.push_back(boost::shared_ptr<boost::thread>(new boost::thread(
+                    boost::bind(&gps_l1_ca_dll_pll_tracking_group_cc::worker, this, d_generation, thread))));
+        }
+    LOG(INFO) << "Tracking group of " << d_members.size() << " channels, "
+              << d_workers.size() + 1 << " threads" << (d_shared_correlator ? ", shared correlators" : "");
+    return true;
+}
+
+
+bool gps_l1_ca_dll_pll_tracking_group_cc::stop()
+{
+    {
+        boost::mutex::scoped_lock lock(d_mutex);
+        d_stopping = true;
+    }
+    d_work_cond.notify_all();
+    for (unsigned int i = 0; i < d_workers.size(); i++)
+        {
+            d_workers.at(i)->join();
+        }
+    d_workers.clear();
+    return true;
+}
+
+
+void gps_l1_ca_dll_pll_tracking_group_cc::worker(unsigned long generation, unsigned int thread)
+{
+    boost::unique_lock<boost::mutex> lock(d_mutex);
+    while (true)
+        {
+            while (d_stopping == false and d_generation == generation)
+                {
+                    d_work_cond.wait(lock);
+                }
+            if (d_stopping) return;
+            generation = d_generation;
+            lock.unlock();
+            track_members(thread);
+            lock.lock();
+            if (--d_pending == 0)
+                {
+                    d_done_cond.notify_one();
+                }
+        }
+}
+
+
+void gps_l1_ca_dll_pll_tracking_group_cc::forecast (int noutput_items,
+        gr_vector_int &ninput_items_required)
+{
+    if (noutput_items != 0)
+        {
+            // one code period per output item, plus the margin needed by the last one
+            for (unsigned int i = 0; i < ninput_items_required.size(); i++)
+                {
+                    ninput_items_required[i] = static_cast<int>(d_vector_length) * (noutput_items + 1);
+                }
+        }
+}
+
+
+void gps_l1_ca_dll_pll_tracking_group_cc::track_members(unsigned int thread)
+{
+    if (d_correlators.empty() == false)
+        {
+            track_members_shared(thread);
+            return;
+        }
+    const unsigned int members = std::min(d_members.size(), d_ninput_items->size());
+    unsigned int member;
+    while ((member = d_next_member.fetch_add(1)) < members)
+        {
+            track_member(member);
+        }
+}
+
+
+void gps_l1_ca_dll_pll_tracking_group_cc::track_member(unsigned int member)
+{
+    const gr_complex* in = (const gr_complex*) (*d_input_items)[member];
+    Gnss_Synchro* out = (Gnss_Synchro*) (*d_output_items)[member];
+    const int available_samples = (*d_ninput_items)[member];
+    int produced = 0;
+    int consumed = 0;
+    while (produced < d_noutput_items)
+        {
+            int epoch_samples = d_members[member]->track_epoch(in + consumed, available_samples - consumed, &out[produced]);
+            if (epoch_samples < 0) break;
+            consumed += epoch_samples;
+            produced++;
+        }
+    d_consumed[member] = consumed;
+    d_produced[member] = produced;
+}
+
+
+void gps_l1_ca_dll_pll_tracking_group_cc::track_members_shared(unsigned int thread)
+{
+    const unsigned int members = std::min(d_members.size(), d_ninput_items->size());
+    const unsigned int threads = d_correlators.size();
+    multichannel_correlator& correlator = *d_correlators.at(thread);
+    multichannel_loop_filters& loops = *d_loops.at(thread);
+    std::vector<unsigned int> pending;
+    std::vector<unsigned char> close_loops(loops.num_channels());
+    for (unsigned int member = thread; member < members; member += threads)
+        {
+            d_consumed[member] = 0;
+            d_produced[member] = 0;
+        }
+    // a round takes the next code period of each member
+    bool tracked = true;
+    while (tracked)
+        {
+            tracked = false;
+            pending.clear();
+            for (unsigned int member = thread; member < members; member += threads)
+                {
+                    if (d_produced[member] >= d_noutput_items) continue;
+                    const gr_complex* in = (const gr_complex*) (*d_input_items)[member] + d_consumed[member];
+                    Gnss_Synchro* out = (Gnss_Synchro*) (*d_output_items)[member] + d_produced[member];
+                    bool correlate = false;
+                    int samples = d_members[member]->begin_epoch((*d_ninput_items)[member] - d_consumed[member], out, correlate);
+                    if (samples < 0) continue;
+                    tracked = true;
+                    if (correlate)
+                        {
+                            d_members[member]->submit(correlator, d_correlator_ids[member], in);
+                            pending.push_back(member);
+                        }
+                    else
+                        {
+                            d_consumed[member] += samples;
+                            d_produced[member]++;
+                        }
+                }
+            // the code periods of the round, in one sweep
+            correlator.execute();
+            // and the loops of the members that close them at this period, in one pass
+            std::fill(close_loops.begin(), close_loops.end(), 0);
+            for (unsigned int i = 0; i < pending.size(); i++)
+                {
+                    const unsigned int member = pending.at(i);
+                    close_loops.at(d_loops_ids[member]) = d_members[member]->prepare_loops();
+                }
+            loops.execute(close_loops.data());
+            for (unsigned int i = 0; i < pending.size(); i++)
+                {
+                    const unsigned int member = pending.at(i);
+                    Gnss_Synchro* out = (Gnss_Synchro*) (*d_output_items)[member] + d_produced[member];
+                    d_consumed[member] += d_members[member]->end_epoch(out);
+                    d_produced[member]++;
+                }
+        }
+}
+
+
+int gps_l1_ca_dll_pll_tracking_group_cc::general_work (int noutput_items, gr_vector_int &ninput_items,
+        gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
+{
+    GNSS_SDR_TRACE_SCOPE("gps_l1_ca_dll_pll_tracking_group_cc::general_work");
+    d_noutput_items = noutput_items;
+    d_ninput_items = &ninput_items;
+    d_input_items = &input_items;
+    d_output_items = &output_items;
+    d_next_member = 0;
+
+    if (d_workers.empty() == false)
+        {
+            boost::mutex::scoped_lock lock(d_mutex);
+            d_pending = d_workers.size();
+            d_generation++;
+            d_work_cond.notify_all();
+        }
+    track_members(0);
+    if (d_workers.empty() == false)
+        {
+            boost::unique_lock<boost::mutex> lock(d_mutex);
+            while (d_pending > 0)
+                {
+                    d_done_cond.wait(lock);
+                }
+        }
+
+    // the members advance at their own pace, as separate blocks would
+    const unsigned int members = std::min(d_members.size(), ninput_items.size());
+    for (unsigned int member = 0; member < members; member++)
+        {
+            consume(member, d_consumed[member]);
+            produce(member, d_produced[member]);
+            if (d_produced[member] > 0)
+                {
+                    const Gnss_Synchro* out = (const Gnss_Synchro*) output_items[member];
+                    Gnss_Sdr_Latency_Tracer::record("tracking", out[d_produced[member] - 1].Tracking_timestamp_secs);
+                }
+        }
+    return WORK_CALLED_PRODUCE;
+}
@@ -0,0 +1,174 @@
+/*!
+ * \file gps_l1_ca_dll_pll_tracking_group_cc.h
+ * \brief Block that runs the GPS L1 C/A DLL + PLL tracking of a group of channels
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * With one tracking block per channel, the scheduler runs one thread per
+ * channel, and each of them wakes up for a few code periods at a time.
+ * This block takes the place of the tracking blocks of up to group_size
+ * channels: each channel is connected to its own input and output port,
+ * and every call to general_work() tracks all of them, shared among a
+ * small pool of threads. The loops themselves are those of
+ * Gps_L1_Ca_Dll_Pll_Tracking_cc, which are kept as the members of the
+ * group and are not connected to the flowgraph.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GPS_L1_CA_DLL_PLL_TRACKING_GROUP_CC_H
+#define GNSS_SDR_GPS_L1_CA_DLL_PLL_TRACKING_GROUP_CC_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <gnuradio/block.h>
+#include <pmt/pmt.h>
+#include "gps_l1_ca_dll_pll_tracking_cc.h"
+
+class gps_l1_ca_dll_pll_tracking_group_cc;
+
+typedef boost::shared_ptr<gps_l1_ca_dll_pll_tracking_group_cc>
+        gps_l1_ca_dll_pll_tracking_group_cc_sptr;
+
+gps_l1_ca_dll_pll_tracking_group_cc_sptr
+gps_l1_ca_dll_pll_make_tracking_group_cc(unsigned int group_size,
+                                         unsigned int threads,
+                                         unsigned int vector_length,
+                                         bool shared_correlator = false);
+
+/*!
+ * \brief Adds \p tracking to the group of the channels of \p role that is
+ * being filled, or to a new one if it is full, and returns the group. The
+ * stream and message ports of the channel in the group are \p port.
+ */
+gps_l1_ca_dll_pll_tracking_group_cc_sptr
+gps_l1_ca_dll_pll_tracking_group_join(const std::string& role,
+                                      unsigned int group_size,
+                                      unsigned int threads,
+                                      unsigned int vector_length,
+                                      gps_l1_ca_dll_pll_tracking_cc_sptr tracking,
+                                      unsigned int& port,
+                                      bool shared_correlator = false);
+
+/*!
+ * \brief This class runs the DLL + PLL tracking loops of several channels
+ *
+ * Member i reads input port i and writes output port i. Its message ports
+ * are "preamble_timestamp_s_<i>" and "events_<i>"; "vector_tracking" is
+ * shared, since the messages name their channel, and so is "parameters".
+ *
+ * With a shared correlator, each thread tracks a fixed share of the members
+ * and correlates one code period of all of them in a single sweep of a
+ * multichannel_correlator, instead of taking the members one at a time.
+ * Their discriminators and loop filters are then updated in a single pass
+ * of a multichannel_loop_filters.
+ */
+class gps_l1_ca_dll_pll_tracking_group_cc: public gr::block
+{
+public:
+    ~gps_l1_ca_dll_pll_tracking_group_cc();
+
+    unsigned int group_size() const
+    {
+        return d_group_size;
+    }
+
+    unsigned int members() const
+    {
+        return d_members.size();
+    }
+
+    //! Adds a channel to the group and returns its port, or -1 if the group is full
+    int add_member(gps_l1_ca_dll_pll_tracking_cc_sptr tracking);
+
+    bool start();
+    bool stop();
+
+    int general_work (int noutput_items, gr_vector_int &ninput_items,
+            gr_vector_const_void_star &input_items, gr_vector_void_star &output_items);
+
+    void forecast (int noutput_items, gr_vector_int &ninput_items_required);
+
+private:
+    friend gps_l1_ca_dll_pll_tracking_group_cc_sptr
+    gps_l1_ca_dll_pll_make_tracking_group_cc(unsigned int group_size,
+            unsigned int threads,
+            unsigned int vector_length,
+            bool shared_correlator);
+
+    gps_l1_ca_dll_pll_tracking_group_cc(unsigned int group_size,
+            unsigned int threads,
+            unsigned int vector_length,
+            bool shared_correlator);
+
+    void msg_handler_preamble_timestamp(unsigned int member, pmt::pmt_t msg);
+    void msg_handler_stop_tracking(unsigned int member, pmt::pmt_t msg);
+    void msg_handler_vector_tracking(pmt::pmt_t msg);
+    void msg_handler_parameters(pmt::pmt_t msg);
+    void publish_event(unsigned int member, pmt::pmt_t msg);
+
+    // Tracks the members that are not taken yet by another thread, or the
+    // share of the thread with a shared correlator
+    void track_members(unsigned int thread);
+    void track_member(unsigned int member);
+    void track_members_shared(unsigned int thread);
+    void worker(unsigned long generation, unsigned int thread);
+
+    unsigned int d_group_size;
+    unsigned int d_threads;
+    unsigned int d_vector_length;
+    std::vector<gps_l1_ca_dll_pll_tracking_cc_sptr> d_members;
+
+    // one correlator and loop filters per thread, and the channel of each member in them
+    bool d_shared_correlator;
+    std::vector<boost::shared_ptr<multichannel_correlator> > d_correlators;
+    std::vector<int> d_correlator_ids;
+    std::vector<boost::shared_ptr<multichannel_loop_filters> > d_loops;
+    std::vector<int> d_loops_ids;
+
+    // arguments and results of the current call to general_work()
+    int d_noutput_items;
+    gr_vector_int* d_ninput_items;
+    gr_vector_const_void_star* d_input_items;
+    gr_vector_void_star* d_output_items;
+    std::vector<int> d_consumed;
+    std::vector<int> d_produced;
+    std::atomic<unsigned int> d_next_member;
+
+    // the worker threads, woken up once per call to general_work()
+    std::vector<boost::shared_ptr<boost::thread> > d_workers;
+    boost::mutex d_mutex;
+    boost::condition_variable d_work_cond;
+    boost::condition_variable d_done_cond;
+    unsigned long d_generation;
+    unsigned int d_pending;
+    bool d_stopping;
+};
+
+#endif //GNSS_SDR_GPS_L1_CA_DLL_PLL_TRACKING_GROUP_CC_H
@@ -58,7 +58,8 @@ gps_l1_ca_tcp_connector_make_tracking_cc(long if_freq,
                                    bool dump,
                                    std::string dump_filename,
                                    float early_late_space_chips,
-                                   size_t port_ch0);
+                                   size_t port_ch0,
+                                   std::string shm_name);
 
 
 /*!
@@ -90,7 +91,8 @@ private:
             bool dump,
             std::string dump_filename,
             float early_late_space_chips,
-            size_t port_ch0);
+            size_t port_ch0,
+            std::string shm_name);
 
     Gps_L1_Ca_Tcp_Connector_Tracking_cc(long if_freq,
             long fs_in, unsigned
@@ -98,7 +100,8 @@ private:
             bool dump,
             std::string dump_filename,
             float early_late_space_chips,
-            size_t port_ch0);
+            size_t port_ch0,
+            std::string shm_name);
 
     // tracking configuration vars
     unsigned int d_vector_length;
@@ -140,6 +143,7 @@ private:
     double d_acc_carrier_phase_rad;
     double d_code_phase_samples;
     size_t d_port_ch0;
+    std::string d_shm_name;
     size_t d_port;
     int d_listen_connection;
     float d_control_id;
@@ -1,6 +1,7 @@
 /*!
  * \file gps_l2_m_dll_pll_tracking_cc.cc
- * \brief Implementation of a code DLL + carrier PLL tracking block
+ * \brief Implementation of a code DLL + carrier PLL tracking block, for
+ *  gr_complex and lv_16sc_t samples
  * \author Carlos Aviles, 2010. carlos.avilesr(at)googlemail.com
  *         Javier Arribas, 2011. jarribas(at)cttc.es
  *
@@ -42,12 +43,13 @@
 #include <boost/lexical_cast.hpp>
 #include <gnuradio/io_signature.h>
 #include <glog/logging.h>
-#include <volk/volk.h>
 #include "gps_l2c_signal.h"
 #include "tracking_discriminators.h"
 #include "lock_detectors.h"
 #include "GPS_L2C.h"
 #include "control_message_factory.h"
+#include "gnss_sdr_event_log.h"
+#include "gnss_sdr_trace.h"
 
 
 /*!
@@ -70,14 +72,35 @@ gps_l2_m_dll_pll_make_tracking_cc(
         std::string dump_filename,
         float pll_bw_hz,
         float dll_bw_hz,
-        float early_late_space_chips)
+        float early_late_space_chips,
+        bool fast_resampler,
+        Tracking_Loop_Arithmetic loop_arithmetic)
 {
-    return gps_l2_m_dll_pll_tracking_cc_sptr(new gps_l2_m_dll_pll_tracking_cc(if_freq,
-            fs_in, vector_length, dump, dump_filename, pll_bw_hz, dll_bw_hz, early_late_space_chips));
+    return gps_l2_m_dll_pll_tracking_cc_sptr(new gps_l2_m_dll_pll_tracking_cc("gps_l2_m_dll_pll_tracking_cc", if_freq,
+            fs_in, vector_length, dump, dump_filename, pll_bw_hz, dll_bw_hz, early_late_space_chips, fast_resampler, loop_arithmetic));
 }
 
 
-void gps_l2_m_dll_pll_tracking_cc::forecast (int noutput_items,
+gps_l2_m_dll_pll_tracking_sc_sptr
+gps_l2_m_dll_pll_make_tracking_sc(
+        long if_freq,
+        long fs_in,
+        unsigned int vector_length,
+        bool dump,
+        std::string dump_filename,
+        float pll_bw_hz,
+        float dll_bw_hz,
+        float early_late_space_chips,
+        bool fast_resampler,
+        Tracking_Loop_Arithmetic loop_arithmetic)
+{
+    return gps_l2_m_dll_pll_tracking_sc_sptr(new gps_l2_m_dll_pll_tracking_sc("gps_l2_m_dll_pll_tracking_sc", if_freq,
+            fs_in, vector_length, dump, dump_filename, pll_bw_hz, dll_bw_hz, early_late_space_chips, fast_resampler, loop_arithmetic));
+}
+
+
+template <class Sample>
+void gps_l2_m_dll_pll_tracking<Sample>::forecast (int noutput_items,
         gr_vector_int &ninput_items_required)
 {
     if (noutput_items != 0)
@@ -88,7 +111,9 @@ void gps_l2_m_dll_pll_tracking_cc::forecast (int noutput_items,
 
 
 
-gps_l2_m_dll_pll_tracking_cc::gps_l2_m_dll_pll_tracking_cc(
+template <class Sample>
+gps_l2_m_dll_pll_tracking<Sample>::gps_l2_m_dll_pll_tracking(
+        const std::string& name,
         long if_freq,
         long fs_in,
         unsigned int vector_length,
@@ -96,9 +121,13 @@ gps_l2_m_dll_pll_tracking_cc::gps_l2_m_dll_pll_tracking_cc(
         std::string dump_filename,
         float pll_bw_hz,
         float dll_bw_hz,
-        float early_late_space_chips) :
-        gr::block("gps_l2_m_dll_pll_tracking_cc", gr::io_signature::make(1, 1, sizeof(gr_complex)),
-                gr::io_signature::make(1, 1, sizeof(Gnss_Synchro)))
+        float early_late_space_chips,
+        bool fast_resampler,
+        Tracking_Loop_Arithmetic loop_arithmetic) :
+        gr::block(name, gr::io_signature::make(1, 1, sizeof(Sample)),
+                gr::io_signature::make(1, 1, sizeof(Gnss_Synchro))),
+        d_engine(make_tracking_engine<Gps_L2_M_Tracking_Traits, Sample>(loop_arithmetic,
+                fs_in, 2 * vector_length, early_late_space_chips))
 {
     // Telemetry bit synchronization message port input
     this->message_port_register_in(pmt::mp("preamble_timestamp_s"));
@@ -118,36 +147,9 @@ gps_l2_m_dll_pll_tracking_cc::gps_l2_m_dll_pll_tracking_cc(
     d_code_loop_filter.set_DLL_BW(dll_bw_hz);
     d_carrier_loop_filter.set_PLL_BW(pll_bw_hz);
 
-    //--- DLL variables --------------------------------------------------------
-    d_early_late_spc_chips = early_late_space_chips; // Define early-late offset (in chips)
-
-    // Initialization of local code replica
-    // Get space for a vector with the C/A code replica sampled 1x/chip
-    d_ca_code = static_cast<gr_complex*>(volk_malloc(static_cast<int>(GPS_L2_M_CODE_LENGTH_CHIPS) * sizeof(gr_complex), volk_get_alignment()));
-
-    // correlator outputs (scalar)
-    d_n_correlator_taps = 3; // Early, Prompt, and Late
-    d_correlator_outs = static_cast<gr_complex*>(volk_malloc(d_n_correlator_taps*sizeof(gr_complex), volk_get_alignment()));
-    for (int n = 0; n < d_n_correlator_taps; n++)
-        {
-            d_correlator_outs[n] = gr_complex(0,0);
-        }
-    d_local_code_shift_chips = static_cast<float*>(volk_malloc(d_n_correlator_taps*sizeof(float), volk_get_alignment()));
-    // Set TAPs delay values [chips]
-    d_local_code_shift_chips[0] = - d_early_late_spc_chips;
-    d_local_code_shift_chips[1] = 0.0;
-    d_local_code_shift_chips[2] = d_early_late_spc_chips;
-
-    multicorrelator_cpu.init(2 * d_vector_length, d_n_correlator_taps);
-
-
-    //--- Perform initializations ------------------------------
-    // define initial code frequency basis of NCO
-    d_code_freq_chips = GPS_L2_M_CODE_RATE_HZ;
-    // define residual code phase (in chips)
-    d_rem_code_phase_samples = 0.0;
-    // define residual carrier phase
-    d_rem_carr_phase_rad = 0.0;
+    d_profile = Gnss_Sdr_Tracking_Profiler::profile(name);
+    // the fixed-point code NCO resampler is cheaper for the 10230-chip L2CM code
+    d_engine->set_fast_resampler(fast_resampler);
 
     // sample synchronization
     d_sample_counter = 0;
@@ -157,8 +159,6 @@ gps_l2_m_dll_pll_tracking_cc::gps_l2_m_dll_pll_tracking_cc(
     d_enable_tracking = false;
     d_pull_in = false;
 
-    d_current_prn_length_samples = static_cast<int>(d_vector_length);
-
     // CN0 estimation and lock detector buffers
     d_cn0_estimation_counter = 0;
     d_Prompt_buffer = new gr_complex[GPS_L2M_CN0_ESTIMATION_SAMPLES];
@@ -176,20 +176,13 @@ gps_l2_m_dll_pll_tracking_cc::gps_l2_m_dll_pll_tracking_cc(
     d_channel = 0;
     d_acq_code_phase_samples = 0.0;
     d_acq_carrier_doppler_hz = 0.0;
-    d_carrier_doppler_hz = 0.0;
-    d_acc_carrier_phase_rad = 0.0;
-    d_code_phase_samples = 0.0;
-    d_acc_code_phase_secs = 0.0;
-
-    d_rem_code_phase_chips = 0.0;
-    d_code_phase_step_chips = 0.0;
-    d_carrier_phase_step_rad = 0.0;
 
     LOG(INFO) << "d_vector_length" << d_vector_length;
 }
 
 
-void gps_l2_m_dll_pll_tracking_cc::start_tracking()
+template <class Sample>
+void gps_l2_m_dll_pll_tracking<Sample>::start_tracking()
 {
     /*
      *  correct the code phase according to the delay between acq and trk
@@ -210,14 +203,10 @@ void gps_l2_m_dll_pll_tracking_cc::start_tracking()
     double T_chip_mod_seconds;
     double T_prn_mod_seconds;
     double T_prn_mod_samples;
-    d_code_freq_chips = radial_velocity * GPS_L2_M_CODE_RATE_HZ;
-    d_code_phase_step_chips = static_cast<double>(d_code_freq_chips) / static_cast<double>(d_fs_in);
-    T_chip_mod_seconds = 1/d_code_freq_chips;
+    T_chip_mod_seconds = 1 / (radial_velocity * GPS_L2_M_CODE_RATE_HZ);
     T_prn_mod_seconds = T_chip_mod_seconds * GPS_L2_M_CODE_LENGTH_CHIPS;
     T_prn_mod_samples = T_prn_mod_seconds * static_cast<float>(d_fs_in);
 
-    d_current_prn_length_samples = round(T_prn_mod_samples);
-
     double T_prn_true_seconds = GPS_L2_M_CODE_LENGTH_CHIPS / GPS_L2_M_CODE_RATE_HZ;
     double T_prn_true_samples = T_prn_true_seconds * static_cast<float>(d_fs_in);
     double T_prn_diff_seconds = T_prn_true_seconds - T_prn_mod_seconds;
@@ -232,65 +221,47 @@ void gps_l2_m_dll_pll_tracking_cc::start_tracking()
     //TODO: debug the algorithm implementation and enable correction
     //d_acq_code_phase_samples = corrected_acq_phase_samples;
 
-    d_carrier_doppler_hz = d_acq_carrier_doppler_hz;
-    d_carrier_phase_step_rad = GPS_L2_TWO_PI * d_carrier_doppler_hz / static_cast<double>(d_fs_in);
-
     // DLL/PLL filter initialization
     d_carrier_loop_filter.initialize(); // initialize the carrier filter
     d_code_loop_filter.initialize();    // initialize the code filter
 
     // generate local reference ALWAYS starting at chip 1 (1 sample per chip)
-    gps_l2c_m_code_gen_complex(d_ca_code, d_acquisition_gnss_synchro->PRN);
-
-    multicorrelator_cpu.set_local_code_and_taps(static_cast<int>(GPS_L2_M_CODE_LENGTH_CHIPS), d_ca_code, d_local_code_shift_chips);
-    for (int n = 0; n < d_n_correlator_taps; n++)
-        {
-            d_correlator_outs[n] = gr_complex(0,0);
-        }
+    gps_l2c_m_code_gen_complex(d_engine->local_code(), d_acquisition_gnss_synchro->PRN);
+    // the code and carrier NCOs start from the acquisition Doppler
+    d_engine->start(d_acq_carrier_doppler_hz, d_acq_code_phase_samples);
 
     d_carrier_lock_fail_counter = 0;
-    d_rem_code_phase_samples = 0;
-    d_rem_carr_phase_rad = 0;
-    d_rem_code_phase_chips = 0.0;
-    d_acc_carrier_phase_rad = 0;
-    d_acc_code_phase_secs = 0;
-
-    d_code_phase_samples = d_acq_code_phase_samples;
 
     std::string sys_ = &d_acquisition_gnss_synchro->System;
     sys = sys_.substr(0,1);
 
     // DEBUG OUTPUT
-    std::cout << "Tracking start on channel " << d_channel << " for satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN) <<" whith Doppler="<<d_acq_carrier_doppler_hz<<" [Hz]"<< std::endl;
-    LOG(INFO) << "Starting tracking of satellite " << Gnss_Satellite(systemName[sys], d_acquisition_gnss_synchro->PRN) << " on channel " << d_channel;
+    Gnss_Sdr_Event_Log::tracking_start(d_channel, d_acquisition_gnss_synchro->System, d_acquisition_gnss_synchro->PRN);
 
 
     // enable tracking
     d_pull_in = true;
     d_enable_tracking = true;
 
-    LOG(INFO) << "PULL-IN Doppler [Hz]=" << d_carrier_doppler_hz
+    LOG(INFO) << "PULL-IN Doppler [Hz]=" << d_engine->carrier_doppler_hz()
             << " Code Phase correction [samples]=" << delay_correction_samples
             << " PULL-IN Code Phase [samples]=" << d_acq_code_phase_samples;
 }
 
-gps_l2_m_dll_pll_tracking_cc::~gps_l2_m_dll_pll_tracking_cc()
+template <class Sample>
+gps_l2_m_dll_pll_tracking<Sample>::~gps_l2_m_dll_pll_tracking()
 {
     d_dump_file.close();
-
-    volk_free(d_local_code_shift_chips);
-    volk_free(d_correlator_outs);
-    volk_free(d_ca_code);
-
     delete[] d_Prompt_buffer;
-    multicorrelator_cpu.free();
 }
 
 
 
-int gps_l2_m_dll_pll_tracking_cc::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
+template <class Sample>
+int gps_l2_m_dll_pll_tracking<Sample>::general_work (int noutput_items __attribute__((unused)), gr_vector_int &ninput_items __attribute__((unused)),
         gr_vector_const_void_star &input_items, gr_vector_void_star &output_items)
 {
+    GNSS_SDR_TRACE_SCOPE_CHANNEL("gps_l2_m_dll_pll_tracking::general_work", d_channel, d_acquisition_gnss_synchro ? d_acquisition_gnss_synchro->PRN : 0);
     // process vars
     double carr_error_hz = 0;
     double carr_error_filt_hz = 0;
@@ -301,9 +272,10 @@ int gps_l2_m_dll_pll_tracking_cc::general_work (int noutput_items __attribute__(
     Gnss_Synchro current_synchro_data = Gnss_Synchro();
 
     // Block input data and block output stream pointers
-    const gr_complex* in = (gr_complex*) input_items[0]; //PRN start block alignment
+    const Sample* in = (const Sample*) input_items[0]; //PRN start block alignment
     Gnss_Synchro **out = (Gnss_Synchro **) &output_items[0];
 
+    if (d_profile) d_profile->start();
     if (d_enable_tracking == true)
         {
             // Fill the acquisition data
@@ -314,10 +286,10 @@ int gps_l2_m_dll_pll_tracking_cc::general_work (int noutput_items __attribute__(
                     int samples_offset;
                     double acq_trk_shif_correction_samples;
                     int acq_to_trk_delay_samples;
-                    acq_to_trk_delay_samples = (d_sample_counter - (d_acq_sample_stamp-d_current_prn_length_samples));
-                    acq_trk_shif_correction_samples = -fmod(static_cast<float>(acq_to_trk_delay_samples), static_cast<float>(d_current_prn_length_samples));
+                    acq_to_trk_delay_samples = (d_sample_counter - (d_acq_sample_stamp - d_engine->current_prn_length_samples()));
+                    acq_trk_shif_correction_samples = -fmod(static_cast<float>(acq_to_trk_delay_samples), static_cast<float>(d_engine->current_prn_length_samples()));
                     samples_offset = round(d_acq_code_phase_samples + acq_trk_shif_correction_samples);//+(1.5*(d_fs_in/GPS_L2_M_CODE_RATE_HZ)));
-                    current_synchro_data.Tracking_timestamp_secs = (static_cast<double>(d_sample_counter) + static_cast<double>(d_rem_code_phase_samples)) / static_cast<double>(d_fs_in);
+                    current_synchro_data.set_sample_stamp(d_sample_counter, d_engine->rem_code_phase_samples(), static_cast<double>(d_fs_in));
                     *out[0] = current_synchro_data;
                     d_sample_counter = d_sample_counter + samples_offset; //count for the processed samples
                     d_pull_in = false;
@@ -327,67 +299,34 @@ int gps_l2_m_dll_pll_tracking_cc::general_work (int noutput_items __attribute__(
 
             // ################# CARRIER WIPEOFF AND CORRELATORS ##############################
             // perform carrier wipe-off and compute Early, Prompt and Late correlation
-            multicorrelator_cpu.set_input_output_vectors(d_correlator_outs, in);
-            multicorrelator_cpu.Carrier_wipeoff_multicorrelator_resampler(d_rem_carr_phase_rad,
-                    d_carrier_phase_step_rad,
-                    d_rem_code_phase_chips,
-                    d_code_phase_step_chips,
-                    d_current_prn_length_samples);
+            d_engine->correlate(in);
+            if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::correlation);
 
-            // ################## PLL ##########################################################
             // PLL discriminator
-            carr_error_hz = pll_cloop_two_quadrant_atan(d_correlator_outs[1]) / GPS_L2_TWO_PI;
+            carr_error_hz = d_engine->carrier_error_cycles();
+            // DLL discriminator
+            code_error_chips = d_engine->code_error_chips(); //[chips/Ti]
+            if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::discriminators);
+
+            // ################## PLL ##########################################################
             // Carrier discriminator filter
             carr_error_filt_hz = d_carrier_loop_filter.get_carrier_nco(carr_error_hz);
-            // New carrier Doppler frequency estimation
-            d_carrier_doppler_hz = d_acq_carrier_doppler_hz + carr_error_filt_hz;
-            // New code Doppler frequency estimation
-            d_code_freq_chips = GPS_L2_M_CODE_RATE_HZ + ((d_carrier_doppler_hz * GPS_L2_M_CODE_RATE_HZ) / GPS_L2_FREQ_HZ);
-            //carrier phase accumulator for (K) doppler estimation
-            d_acc_carrier_phase_rad -= GPS_L2_TWO_PI * d_carrier_doppler_hz * GPS_L2_M_PERIOD;
-            //remanent carrier phase to prevent overflow in the code NCO
-            d_rem_carr_phase_rad = d_rem_carr_phase_rad + GPS_L2_TWO_PI * d_carrier_doppler_hz * GPS_L2_M_PERIOD;
-            d_rem_carr_phase_rad = fmod(d_rem_carr_phase_rad, GPS_L2_TWO_PI);
 
             // ################## DLL ##########################################################
-            // DLL discriminator
-            code_error_chips = dll_nc_e_minus_l_normalized(d_correlator_outs[0], d_correlator_outs[2]); //[chips/Ti]
             // Code discriminator filter
             code_error_filt_chips = d_code_loop_filter.get_code_nco(code_error_chips); //[chips/second]
-            //Code phase accumulator
-            double code_error_filt_secs;
-            code_error_filt_secs = (GPS_L2_M_PERIOD * code_error_filt_chips) / GPS_L2_M_CODE_RATE_HZ; //[seconds]
-            d_acc_code_phase_secs = d_acc_code_phase_secs + code_error_filt_secs;
 
             // ################## CARRIER AND CODE NCO BUFFER ALIGNEMENT #######################
-            // keep alignment parameters for the next input buffer
-            double T_chip_seconds;
-            double T_prn_seconds;
-            double T_prn_samples;
-            double K_blk_samples;
-            // Compute the next buffer length based in the new period of the PRN sequence and the code phase error estimation
-            T_chip_seconds = 1.0 / d_code_freq_chips;
-            T_prn_seconds = T_chip_seconds * GPS_L2_M_CODE_LENGTH_CHIPS;
-            T_prn_samples = T_prn_seconds * static_cast<double>(d_fs_in);
-            K_blk_samples = T_prn_samples + d_rem_code_phase_samples + code_error_filt_secs * static_cast<double>(d_fs_in);
-            d_current_prn_length_samples = round(K_blk_samples); //round to a discrete samples
-
-            //################### PLL COMMANDS #################################################
-            //carrier phase step (NCO phase increment per sample) [rads/sample]
-            d_carrier_phase_step_rad = GPS_L2_TWO_PI * d_carrier_doppler_hz / static_cast<double>(d_fs_in);
-
-            //################### DLL COMMANDS #################################################
-            //code phase step (Code resampler phase increment per sample) [chips/sample]
-            d_code_phase_step_chips = d_code_freq_chips / static_cast<double>(d_fs_in);
-
-            //remnant code phase [chips]
-            d_rem_code_phase_chips = d_rem_code_phase_samples * (d_code_freq_chips / static_cast<double>(d_fs_in));
+            // New carrier Doppler frequency estimation, code Doppler, phase accumulators
+            // and length of the next buffer
+            d_engine->update(d_acq_carrier_doppler_hz + carr_error_filt_hz, code_error_filt_chips);
+            if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::loop_filters);
 
             // ####### CN0 ESTIMATION AND LOCK DETECTORS ######
             if (d_cn0_estimation_counter < GPS_L2M_CN0_ESTIMATION_SAMPLES)
                 {
                     // fill buffer with prompt correlator output values
-                    d_Prompt_buffer[d_cn0_estimation_counter] = d_correlator_outs[1];
+                    d_Prompt_buffer[d_cn0_estimation_counter] = d_engine->prompt();
                     d_cn0_estimation_counter++;
                 }
             else
@@ -408,27 +347,25 @@ int gps_l2_m_dll_pll_tracking_cc::general_work (int noutput_items __attribute__(
                         }
                     if (d_carrier_lock_fail_counter > GPS_L2M_MAXIMUM_LOCK_FAIL_COUNTER)
                         {
-                            std::cout << "Loss of lock in channel " << d_channel << "!" << std::endl;
-                            LOG(INFO) << "Loss of lock in channel " << d_channel << "!";
+                            Gnss_Sdr_Event_Log::loss_of_lock(d_channel);
                             this->message_port_pub(pmt::mp("events"), pmt::from_long(3));//3 -> loss of lock
                             d_carrier_lock_fail_counter = 0;
                             d_enable_tracking = false; // TODO: check if disabling tracking is consistent with the channel state machine
                         }
                 }
+            if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::lock_detectors);
             // ########### Output the tracking data to navigation and PVT ##########
-            current_synchro_data.Prompt_I = static_cast<double>(d_correlator_outs[1].real());
-            current_synchro_data.Prompt_Q = static_cast<double>(d_correlator_outs[1].imag());
+            current_synchro_data.Prompt_I = static_cast<double>(d_engine->prompt().real());
+            current_synchro_data.Prompt_Q = static_cast<double>(d_engine->prompt().imag());
 
             // Tracking_timestamp_secs is aligned with the CURRENT PRN start sample (Hybridization OK!, but some glitches??)
-            current_synchro_data.Tracking_timestamp_secs = (static_cast<double>(d_sample_counter) + d_rem_code_phase_samples) / static_cast<double>(d_fs_in);
-            //compute remnant code phase samples AFTER the Tracking timestamp
-            d_rem_code_phase_samples = K_blk_samples - d_current_prn_length_samples; //rounding error < 1 sample
+            current_synchro_data.set_sample_stamp(d_sample_counter, d_engine->period_start_rem_samples(), static_cast<double>(d_fs_in));
 
             //current_synchro_data.Tracking_timestamp_secs = ((double)d_sample_counter)/static_cast<double>(d_fs_in);
             // This tracking block aligns the Tracking_timestamp_secs with the start sample of the PRN, thus, Code_phase_secs=0
             current_synchro_data.Code_phase_secs = 0;
-            current_synchro_data.Carrier_phase_rads = d_acc_carrier_phase_rad;
-            current_synchro_data.Carrier_Doppler_hz = d_carrier_doppler_hz;
+            current_synchro_data.Carrier_phase_rads = d_engine->acc_carrier_phase_rad();
+            current_synchro_data.Carrier_Doppler_hz = d_engine->carrier_doppler_hz();
             current_synchro_data.CN0_dB_hz = d_CN0_SNV_dB_Hz;
             current_synchro_data.Flag_valid_symbol_output = true;
             current_synchro_data.correlation_length_ms=20;
@@ -436,11 +373,8 @@ int gps_l2_m_dll_pll_tracking_cc::general_work (int noutput_items __attribute__(
         }
     else
         {
-            for (int n = 0; n < d_n_correlator_taps; n++)
-                {
-                    d_correlator_outs[n] = gr_complex(0,0);
-                }
-            current_synchro_data.Tracking_timestamp_secs = (static_cast<double>(d_sample_counter) + static_cast<double>(d_rem_code_phase_samples)) / static_cast<double>(d_fs_in);
+            d_engine->clear_outputs();
+            current_synchro_data.set_sample_stamp(d_sample_counter, d_engine->rem_code_phase_samples(), static_cast<double>(d_fs_in));
         }
     //assign the GNURadio block output data
     *out[0] = current_synchro_data;
@@ -452,11 +386,11 @@ int gps_l2_m_dll_pll_tracking_cc::general_work (int noutput_items __attribute__(
             float prompt_Q;
             float tmp_E, tmp_P, tmp_L;
             double tmp_double;
-            prompt_I = d_correlator_outs[1].real();
-            prompt_Q = d_correlator_outs[1].imag();
-            tmp_E = std::abs<float>(d_correlator_outs[0]);
-            tmp_P = std::abs<float>(d_correlator_outs[1]);
-            tmp_L = std::abs<float>(d_correlator_outs[2]);
+            prompt_I = d_engine->prompt().real();
+            prompt_Q = d_engine->prompt().imag();
+            tmp_E = std::abs<float>(d_engine->early());
+            tmp_P = std::abs<float>(d_engine->prompt());
+            tmp_L = std::abs<float>(d_engine->late());
             try
             {
                     // EPR
@@ -470,15 +404,19 @@ int gps_l2_m_dll_pll_tracking_cc::general_work (int noutput_items __attribute__(
                     //tmp_float=(float)d_sample_counter;
                     d_dump_file.write(reinterpret_cast<char*>(&d_sample_counter), sizeof(unsigned long int));
                     // accumulated carrier phase
-                    d_dump_file.write(reinterpret_cast<char*>(&d_acc_carrier_phase_rad), sizeof(double));
+                    tmp_double = d_engine->acc_carrier_phase_rad();
+                    d_dump_file.write(reinterpret_cast<char*>(&tmp_double), sizeof(double));
 
                     // carrier and code frequency
-                    d_dump_file.write(reinterpret_cast<char*>(&d_carrier_doppler_hz), sizeof(double));
-                    d_dump_file.write(reinterpret_cast<char*>(&d_code_freq_chips), sizeof(double));
+                    tmp_double = d_engine->carrier_doppler_hz();
+                    d_dump_file.write(reinterpret_cast<char*>(&tmp_double), sizeof(double));
+                    tmp_double = d_engine->code_freq_chips();
+                    d_dump_file.write(reinterpret_cast<char*>(&tmp_double), sizeof(double));
 
                     //PLL commands
                     d_dump_file.write(reinterpret_cast<char*>(&carr_error_hz), sizeof(double));
-                    d_dump_file.write(reinterpret_cast<char*>(&d_carrier_doppler_hz), sizeof(double));
+                    tmp_double = d_engine->carrier_doppler_hz();
+                    d_dump_file.write(reinterpret_cast<char*>(&tmp_double), sizeof(double));
 
                     //DLL commands
                     d_dump_file.write(reinterpret_cast<char*>(&code_error_chips), sizeof(double));
@@ -489,9 +427,9 @@ int gps_l2_m_dll_pll_tracking_cc::general_work (int noutput_items __attribute__(
                     d_dump_file.write(reinterpret_cast<char*>(&d_carrier_lock_test), sizeof(double));
 
                     // AUX vars (for debug purposes)
-                    tmp_double = d_rem_code_phase_samples;
+                    tmp_double = d_engine->rem_code_phase_samples();
                     d_dump_file.write(reinterpret_cast<char*>(&tmp_double), sizeof(double));
-                    tmp_double = static_cast<double>(d_sample_counter + d_current_prn_length_samples);
+                    tmp_double = static_cast<double>(d_sample_counter + d_engine->current_prn_length_samples());
                     d_dump_file.write(reinterpret_cast<char*>(&tmp_double), sizeof(double));
             }
             catch (std::ifstream::failure& e)
@@ -499,14 +437,16 @@ int gps_l2_m_dll_pll_tracking_cc::general_work (int noutput_items __attribute__(
                     LOG(WARNING) << "Exception writing trk dump file " << e.what();
             }
         }
-    consume_each(d_current_prn_length_samples); // this is necessary in gr::block derivates
-    d_sample_counter += d_current_prn_length_samples; //count for the processed samples
+    consume_each(d_engine->current_prn_length_samples()); // this is necessary in gr::block derivates
+    d_sample_counter += d_engine->current_prn_length_samples(); //count for the processed samples
+    if (d_profile) d_profile->end(Gnss_Sdr_Tracking_Profile::output);
     return 1; //output tracking result ALWAYS even in the case of d_enable_tracking==false
 }
 
 
 
-void gps_l2_m_dll_pll_tracking_cc::set_channel(unsigned int channel)
+template <class Sample>
+void gps_l2_m_dll_pll_tracking<Sample>::set_channel(unsigned int channel)
 {
     d_channel = channel;
     LOG(INFO) << "Tracking Channel set to " << d_channel;
@@ -533,7 +473,12 @@ void gps_l2_m_dll_pll_tracking_cc::set_channel(unsigned int channel)
 
 
 
-void gps_l2_m_dll_pll_tracking_cc::set_gnss_synchro(Gnss_Synchro* p_gnss_synchro)
+template <class Sample>
+void gps_l2_m_dll_pll_tracking<Sample>::set_gnss_synchro(Gnss_Synchro* p_gnss_synchro)
 {
     d_acquisition_gnss_synchro = p_gnss_synchro;
 }
+
+
+template class gps_l2_m_dll_pll_tracking<gr_complex>;
+template class gps_l2_m_dll_pll_tracking<lv_16sc_t>;
@@ -38,18 +38,30 @@
 
 #include <fstream>
 #include <map>
+#include <memory>
 #include <string>
 #include <gnuradio/block.h>
 #include "gnss_synchro.h"
 #include "tracking_2nd_DLL_filter.h"
 #include "tracking_2nd_PLL_filter.h"
-#include "cpu_multicorrelator.h"
+#include "tracking_engine.h"
+#include "gnss_sdr_tracking_profiler.h"
 
-class gps_l2_m_dll_pll_tracking_cc;
+template <class Sample>
+class gps_l2_m_dll_pll_tracking;
+
+//! Tracking block for gr_complex samples
+typedef gps_l2_m_dll_pll_tracking<gr_complex> gps_l2_m_dll_pll_tracking_cc;
+
+//! Tracking block for lv_16sc_t samples
+typedef gps_l2_m_dll_pll_tracking<lv_16sc_t> gps_l2_m_dll_pll_tracking_sc;
 
 typedef boost::shared_ptr<gps_l2_m_dll_pll_tracking_cc>
         gps_l2_m_dll_pll_tracking_cc_sptr;
 
+typedef boost::shared_ptr<gps_l2_m_dll_pll_tracking_sc>
+        gps_l2_m_dll_pll_tracking_sc_sptr;
+
 gps_l2_m_dll_pll_tracking_cc_sptr
 gps_l2_m_dll_pll_make_tracking_cc(long if_freq,
                                    long fs_in, unsigned
@@ -58,17 +70,33 @@ gps_l2_m_dll_pll_make_tracking_cc(long if_freq,
                                    std::string dump_filename,
                                    float pll_bw_hz,
                                    float dll_bw_hz,
-                                   float early_late_space_chips);
+                                   float early_late_space_chips,
+                                   bool fast_resampler,
+                                   Tracking_Loop_Arithmetic loop_arithmetic);
+
+gps_l2_m_dll_pll_tracking_sc_sptr
+gps_l2_m_dll_pll_make_tracking_sc(long if_freq,
+                                   long fs_in, unsigned
+                                   int vector_length,
+                                   bool dump,
+                                   std::string dump_filename,
+                                   float pll_bw_hz,
+                                   float dll_bw_hz,
+                                   float early_late_space_chips,
+                                   bool fast_resampler,
+                                   Tracking_Loop_Arithmetic loop_arithmetic);
 
 
 
 /*!
- * \brief This class implements a DLL + PLL tracking loop block
+ * \brief This class implements a DLL + PLL tracking loop block for
+ * \p Sample input samples, gr_complex or lv_16sc_t
  */
-class gps_l2_m_dll_pll_tracking_cc: public gr::block
+template <class Sample>
+class gps_l2_m_dll_pll_tracking: public gr::block
 {
 public:
-    ~gps_l2_m_dll_pll_tracking_cc();
+    ~gps_l2_m_dll_pll_tracking();
 
     void set_channel(unsigned int channel);
     void set_gnss_synchro(Gnss_Synchro* p_gnss_synchro);
@@ -88,16 +116,33 @@ private:
             std::string dump_filename,
             float pll_bw_hz,
             float dll_bw_hz,
-            float early_late_space_chips);
+            float early_late_space_chips,
+            bool fast_resampler,
+            Tracking_Loop_Arithmetic loop_arithmetic);
 
-    gps_l2_m_dll_pll_tracking_cc(long if_freq,
+    friend gps_l2_m_dll_pll_tracking_sc_sptr
+    gps_l2_m_dll_pll_make_tracking_sc(long if_freq,
             long fs_in, unsigned
             int vector_length,
             bool dump,
             std::string dump_filename,
             float pll_bw_hz,
             float dll_bw_hz,
-            float early_late_space_chips);
+            float early_late_space_chips,
+            bool fast_resampler,
+            Tracking_Loop_Arithmetic loop_arithmetic);
+
+    gps_l2_m_dll_pll_tracking(const std::string& name,
+            long if_freq,
+            long fs_in, unsigned
+            int vector_length,
+            bool dump,
+            std::string dump_filename,
+            float pll_bw_hz,
+            float dll_bw_hz,
+            float early_late_space_chips,
+            bool fast_resampler,
+            Tracking_Loop_Arithmetic loop_arithmetic);
 
     // tracking configuration vars
     unsigned int d_vector_length;
@@ -108,12 +153,8 @@ private:
     long d_if_freq;
     long d_fs_in;
 
-    double d_early_late_spc_chips;
-
-    // remaining code phase and carrier phase between tracking loops
-    double d_rem_code_phase_samples;
-    double d_rem_code_phase_chips;
-    double d_rem_carr_phase_rad;
+    // correlators and code and carrier NCOs
+    std::unique_ptr<Tracking_Engine_Base<Gps_L2_M_Tracking_Traits, Sample> > d_engine;
 
     // PLL and DLL filter library
     Tracking_2nd_DLL_filter d_code_loop_filter;
@@ -122,24 +163,6 @@ private:
     // acquisition
     double d_acq_code_phase_samples;
     double d_acq_carrier_doppler_hz;
-    // correlator
-    int d_n_correlator_taps;
-    gr_complex* d_ca_code;
-    float* d_local_code_shift_chips;
-    gr_complex* d_correlator_outs;
-    cpu_multicorrelator multicorrelator_cpu;
-
-    // tracking vars
-    double d_code_freq_chips;
-    double d_code_phase_step_chips;
-    double d_carrier_doppler_hz;
-    double d_carrier_phase_step_rad;
-    double d_acc_carrier_phase_rad;
-    double d_code_phase_samples;
-    double d_acc_code_phase_secs;
-
-    //PRN period in samples
-    int d_current_prn_length_samples;
 
     //processing samples counters
     unsigned long int d_sample_counter;
@@ -163,6 +186,9 @@ private:
 
     std::map<std::string, std::string> systemName;
     std::string sys;
+
+    // time per phase of the epochs, null unless the tracking profiler is enabled
+    std::shared_ptr<Gnss_Sdr_Tracking_Profile> d_profile;
 };
 
 #endif //GNSS_SDR_GPS_L2_M_DLL_PLL_TRACKING_CC_H
@@ -0,0 +1,119 @@
+/*!
+ * \file tracking_dump_source.cc
+ * \brief Source of the outputs of tracking channels replayed from their dumps
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "tracking_dump_source.h"
+#include <glog/logging.h>
+#include <gnuradio/io_signature.h>
+#include "gnss_sdr_trace.h"
+#include "gnss_synchro.h"
+
+using google::LogMessage;
+
+
+tracking_dump_source_sptr make_tracking_dump_source(const std::vector<std::string> & dump_files)
+{
+    return tracking_dump_source_sptr(new tracking_dump_source(dump_files));
+}
+
+
+tracking_dump_source::tracking_dump_source(const std::vector<std::string> & dump_files) :
+        gr::block("tracking_dump_source", gr::io_signature::make(0, 0, 0),
+                gr::io_signature::make(dump_files.size(), dump_files.size(), sizeof(Gnss_Synchro))),
+        d_replays(dump_files.size())
+{
+    for (unsigned int i = 0; i < dump_files.size(); i++)
+        {
+            if (!d_replays[i].open(dump_files[i]))
+                {
+                    d_error += (d_error.empty() ? "" : "; ") + d_replays[i].error();
+                    continue;
+                }
+            LOG(INFO) << "Channel " << i << " replays " << d_replays[i].records() << " records of "
+                      << d_replays[i].system() << " " << d_replays[i].signal() << " PRN " << d_replays[i].prn()
+                      << " from " << dump_files[i];
+        }
+    if (!d_error.empty())
+        {
+            LOG(WARNING) << d_error;
+        }
+}
+
+
+tracking_dump_source::~tracking_dump_source()
+{}
+
+
+Gnss_Satellite tracking_dump_source::satellite(unsigned int channel) const
+{
+    const Tracking_Dump_Replay & replay = d_replays.at(channel);
+    return Gnss_Satellite(replay.system() == 'E' ? "Galileo" : "GPS", replay.prn());
+}
+
+
+std::string tracking_dump_source::signal(unsigned int channel) const
+{
+    return d_replays.at(channel).signal();
+}
+
+
+unsigned long long tracking_dump_source::replayed() const
+{
+    unsigned long long replayed = 0;
+    for (unsigned int i = 0; i < d_replays.size(); i++)
+        {
+            replayed += d_replays[i].replayed();
+        }
+    return replayed;
+}
+
+
+int tracking_dump_source::general_work(int noutput_items, gr_vector_int &ninput_items __attribute__((unused)),
+        gr_vector_const_void_star &input_items __attribute__((unused)), gr_vector_void_star &output_items)
+{
+    GNSS_SDR_TRACE_SCOPE("tracking_dump_source::general_work");
+    bool produced = false;
+    for (unsigned int i = 0; i < d_replays.size(); i++)
+        {
+            Gnss_Synchro* out = static_cast<Gnss_Synchro*>(output_items[i]);
+            int n = 0;
+            while (n < noutput_items && d_replays[i].next(out[n], i))
+                {
+                    n++;
+                }
+            produce(i, n);
+            produced = produced || n > 0;
+        }
+    if (!produced)
+        {
+            LOG(INFO) << "End of the tracking dumps, " << replayed() << " outputs replayed";
+            return WORK_DONE;
+        }
+    return WORK_CALLED_PRODUCE;
+}
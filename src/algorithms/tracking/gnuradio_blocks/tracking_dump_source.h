@@ -0,0 +1,95 @@
+/*!
+ * \file tracking_dump_source.h
+ * \brief Source of the outputs of tracking channels replayed from their dumps
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_TRACKING_DUMP_SOURCE_H_
+#define GNSS_SDR_TRACKING_DUMP_SOURCE_H_
+
+#include <string>
+#include <vector>
+#include <gnuradio/block.h>
+#include "gnss_satellite.h"
+#include "tracking_dump_replay.h"
+
+class tracking_dump_source;
+typedef boost::shared_ptr<tracking_dump_source> tracking_dump_source_sptr;
+
+/*!
+ * \brief Makes a source with one Gnss_Synchro stream per tracking dump of
+ * \p dump_files, in that order.
+ */
+tracking_dump_source_sptr make_tracking_dump_source(const std::vector<std::string> & dump_files);
+
+/*!
+ * \brief Takes the place of the tracking blocks of the channels, so that
+ * the telemetry decoders, observables and PVT run on recorded tracking
+ * outputs, without the signal and as fast as they can take them.
+ *
+ * Each stream goes on at its own pace, as the channels do, and the block
+ * is done when all the dumps are.
+ */
+class tracking_dump_source : public gr::block
+{
+private:
+    friend tracking_dump_source_sptr make_tracking_dump_source(const std::vector<std::string> & dump_files);
+
+    tracking_dump_source(const std::vector<std::string> & dump_files);
+
+    std::vector<Tracking_Dump_Replay> d_replays;
+    std::string d_error;
+
+public:
+    ~tracking_dump_source();
+
+    //! Streams, one per dump
+    unsigned int channels() const
+    {
+        return d_replays.size();
+    }
+
+    //! Satellite of the first signal tracked in the dump of \p channel
+    Gnss_Satellite satellite(unsigned int channel) const;
+
+    //! "1C" or "1B"
+    std::string signal(unsigned int channel) const;
+
+    //! Outputs replayed on all the streams
+    unsigned long long replayed() const;
+
+    //! Errors opening the dumps, empty if none. The streams of those dumps are empty.
+    const std::string & error() const
+    {
+        return d_error;
+    }
+
+    int general_work(int noutput_items, gr_vector_int &ninput_items,
+            gr_vector_const_void_star &input_items, gr_vector_void_star &output_items);
+};
+
+#endif
@@ -0,0 +1,94 @@
+/*!
+ * \file carrier_rotator.cc
+ * \brief Persistent carrier wipe-off rotator for the multicorrelators
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "carrier_rotator.h"
+#include <cmath>
+#include "GPS_L1_CA.h"
+
+
+Carrier_Rotator::Carrier_Rotator()
+{
+    d_resync_period = 1000;
+    d_calls = 0;
+    d_phase_step_rad = 0.0;
+    d_phase_inc_accurate = std::complex<double>(1.0, 0.0);
+    d_phase_inc = std::complex<float>(1.0, 0.0);
+    set_phase(0.0);
+}
+
+
+void Carrier_Rotator::set_resync_period(unsigned int resync_period)
+{
+    d_resync_period = resync_period;
+}
+
+
+void Carrier_Rotator::set_phase(double phase_rad)
+{
+    d_phase_rad = std::fmod(phase_rad, GPS_TWO_PI);
+    d_phase = std::complex<float>(static_cast<float>(std::cos(d_phase_rad)), static_cast<float>(-std::sin(d_phase_rad)));
+    d_calls = 0;
+}
+
+
+void Carrier_Rotator::set_phase_step(double phase_step_rad)
+{
+    if (phase_step_rad == d_phase_step_rad) return;
+    const double delta = phase_step_rad - d_phase_step_rad;
+    if (std::abs(delta) < 1e-3)
+        {
+            // the loop filters change the step by small amounts: rotate the
+            // increment by exp(-j delta), with an error below delta^4 / 24
+            const double delta2 = delta * delta;
+            d_phase_inc_accurate *= std::complex<double>(1.0 - delta2 / 2.0, -delta * (1.0 - delta2 / 6.0));
+            d_phase_inc_accurate /= std::abs(d_phase_inc_accurate);
+        }
+    else
+        {
+            d_phase_inc_accurate = std::complex<double>(std::cos(phase_step_rad), -std::sin(phase_step_rad));
+        }
+    d_phase_step_rad = phase_step_rad;
+    d_phase_inc = std::complex<float>(static_cast<float>(d_phase_inc_accurate.real()), static_cast<float>(d_phase_inc_accurate.imag()));
+}
+
+
+void Carrier_Rotator::advance(int samples)
+{
+    d_phase_rad = std::fmod(d_phase_rad + d_phase_step_rad * static_cast<double>(samples), GPS_TWO_PI);
+    d_calls++;
+    if (d_resync_period > 0 && d_calls >= d_resync_period)
+        {
+            set_phase(d_phase_rad);
+        }
+    else
+        {
+            d_phase /= std::abs(d_phase);
+        }
+}
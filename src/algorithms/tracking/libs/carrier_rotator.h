@@ -0,0 +1,89 @@
+/*!
+ * \file carrier_rotator.h
+ * \brief Persistent carrier wipe-off rotator for the multicorrelators
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The rotator kernels take the phase of the first sample and the phase
+ * increment per sample as unit complex numbers, and return the phase of the
+ * sample after the last one. Keeping that state from one epoch to the next
+ * avoids building it again from sin/cos in every call: the phase continues
+ * from the kernel output and the phase increment is rotated by the change
+ * of the phase step. Every few calls the phase is rebuilt from its angle,
+ * accumulated in double precision, so the rounding errors of the kernels
+ * do not add up over long tracking runs.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CARRIER_ROTATOR_H_
+#define GNSS_SDR_CARRIER_ROTATOR_H_
+
+#include <complex>
+
+/*!
+ * \brief Wipes off a carrier of phase phase_rad() at the first sample,
+ * advancing phase_step_rad per sample
+ */
+class Carrier_Rotator
+{
+public:
+    Carrier_Rotator();
+
+    /*!
+     * \brief Every \p resync_period calls to advance() the phase is rebuilt
+     * from its angle with sin/cos. In the other calls it is only normalized.
+     * 0 never rebuilds it.
+     */
+    void set_resync_period(unsigned int resync_period);
+
+    //! Sets the carrier phase at the next sample
+    void set_phase(double phase_rad);
+
+    //! Sets the carrier phase step per sample
+    void set_phase_step(double phase_step_rad);
+
+    //! Wipe-off rotation at the next sample, updated by the rotator kernels
+    std::complex<float>* phase() { return &d_phase; }
+
+    //! Wipe-off rotation per sample
+    std::complex<float> phase_inc() const { return d_phase_inc; }
+
+    double phase_rad() const { return d_phase_rad; }
+    double phase_step_rad() const { return d_phase_step_rad; }
+
+    //! To be called after a rotator kernel has rotated \p samples samples
+    void advance(int samples);
+
+private:
+    std::complex<float> d_phase;
+    std::complex<float> d_phase_inc;
+    std::complex<double> d_phase_inc_accurate;
+    double d_phase_rad;
+    double d_phase_step_rad;
+    unsigned int d_resync_period;
+    unsigned int d_calls;
+};
+
+#endif /* GNSS_SDR_CARRIER_ROTATOR_H_ */
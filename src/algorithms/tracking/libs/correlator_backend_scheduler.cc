@@ -0,0 +1,236 @@
+/*!
+ * \file correlator_backend_scheduler.cc
+ * \brief Assignment of the tracking channels to the CPU or GPU correlators
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "correlator_backend_scheduler.h"
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+namespace
+{
+// Weight of a report in the smoothed latencies
+const double LATENCY_SMOOTHING = 0.05;
+// A backend is slower than the other one above this latency ratio, so that
+// two backends of about the same speed do not trade channels back and forth
+const double LATENCY_MARGIN = 1.25;
+
+const char* backend_name(Correlator_Backend backend)
+{
+    return backend == CORRELATOR_BACKEND_GPU ? "GPU" : "CPU";
+}
+}
+
+
+Correlator_Backend_Scheduler& Correlator_Backend_Scheduler::instance()
+{
+    static Correlator_Backend_Scheduler scheduler;
+    return scheduler;
+}
+
+
+Correlator_Backend_Scheduler::Correlator_Backend_Scheduler()
+{
+    d_enabled = false;
+    d_max_channels[CORRELATOR_BACKEND_CPU] = 0;
+    d_max_channels[CORRELATOR_BACKEND_GPU] = 0;
+    d_rebalance_reports = 1000;
+    d_load_limit = 0.5;
+    d_latency_us[CORRELATOR_BACKEND_CPU] = 0.0;
+    d_latency_us[CORRELATOR_BACKEND_GPU] = 0.0;
+    d_measured[CORRELATOR_BACKEND_CPU] = false;
+    d_measured[CORRELATOR_BACKEND_GPU] = false;
+    d_epoch_us = 0.0;
+    d_reports = 0;
+    d_migrations = 0;
+}
+
+
+void Correlator_Backend_Scheduler::configure(bool enabled, unsigned int gpu_max_channels, unsigned int cpu_max_channels,
+        unsigned int rebalance_reports, double load_limit)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_enabled = enabled;
+    d_max_channels[CORRELATOR_BACKEND_GPU] = gpu_max_channels;
+    d_max_channels[CORRELATOR_BACKEND_CPU] = cpu_max_channels;
+    d_rebalance_reports = rebalance_reports > 0 ? rebalance_reports : 1;
+    d_load_limit = load_limit;
+}
+
+
+Correlator_Backend Correlator_Backend_Scheduler::assign(unsigned int channel)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_channels.erase(channel);
+    Correlator_Backend backend = CORRELATOR_BACKEND_GPU;
+    if (d_enabled && has_room(CORRELATOR_BACKEND_CPU))
+        {
+            // the GPU is preferred until it is full or measured slower
+            if (!has_room(CORRELATOR_BACKEND_GPU)
+                    || (d_measured[CORRELATOR_BACKEND_GPU] && d_measured[CORRELATOR_BACKEND_CPU]
+                            && d_latency_us[CORRELATOR_BACKEND_CPU] < d_latency_us[CORRELATOR_BACKEND_GPU])
+                    || (d_measured[CORRELATOR_BACKEND_GPU] && !d_measured[CORRELATOR_BACKEND_CPU]
+                            && d_latency_us[CORRELATOR_BACKEND_GPU] > d_load_limit * d_epoch_us))
+                {
+                    backend = CORRELATOR_BACKEND_CPU;
+                }
+        }
+    Channel_Load load;
+    load.backend = backend;
+    load.latency_us = 0.0;
+    d_channels[channel] = load;
+    DLOG(INFO) << "Channel " << channel << " correlated on the " << backend_name(backend);
+    return backend;
+}
+
+
+Correlator_Backend Correlator_Backend_Scheduler::backend(unsigned int channel)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    std::map<unsigned int, Channel_Load>::const_iterator it = d_channels.find(channel);
+    return it == d_channels.end() ? CORRELATOR_BACKEND_GPU : it->second.backend;
+}
+
+
+void Correlator_Backend_Scheduler::report(unsigned int channel, double latency_us, double epoch_us)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    if (!d_enabled) return;
+    std::map<unsigned int, Channel_Load>::iterator it = d_channels.find(channel);
+    if (it == d_channels.end()) return;
+    Correlator_Backend backend = it->second.backend;
+    if (d_measured[backend])
+        {
+            d_latency_us[backend] += LATENCY_SMOOTHING * (latency_us - d_latency_us[backend]);
+        }
+    else
+        {
+            d_latency_us[backend] = latency_us;
+            d_measured[backend] = true;
+        }
+    it->second.latency_us = it->second.latency_us > 0.0 ?
+            it->second.latency_us + LATENCY_SMOOTHING * (latency_us - it->second.latency_us) : latency_us;
+    d_epoch_us = epoch_us;
+    if (++d_reports >= d_rebalance_reports)
+        {
+            d_reports = 0;
+            rebalance();
+        }
+}
+
+
+void Correlator_Backend_Scheduler::release(unsigned int channel)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    d_channels.erase(channel);
+}
+
+
+unsigned int Correlator_Backend_Scheduler::channels(Correlator_Backend backend)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return count(backend);
+}
+
+
+double Correlator_Backend_Scheduler::latency_us(Correlator_Backend backend)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_latency_us[backend];
+}
+
+
+unsigned long long Correlator_Backend_Scheduler::migrations()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_migrations;
+}
+
+
+unsigned int Correlator_Backend_Scheduler::count(Correlator_Backend backend) const
+{
+    unsigned int n = 0;
+    for (std::map<unsigned int, Channel_Load>::const_iterator it = d_channels.begin(); it != d_channels.end(); ++it)
+        {
+            if (it->second.backend == backend) n++;
+        }
+    return n;
+}
+
+
+bool Correlator_Backend_Scheduler::has_room(Correlator_Backend backend) const
+{
+    return d_max_channels[backend] == 0 || count(backend) < d_max_channels[backend];
+}
+
+
+bool Correlator_Backend_Scheduler::overloaded(Correlator_Backend backend, Correlator_Backend other) const
+{
+    if (!d_measured[backend] || count(backend) == 0) return false;
+    if (d_measured[other])
+        {
+            return d_latency_us[backend] > LATENCY_MARGIN * d_latency_us[other];
+        }
+    // a backend never measured is only tried when this one misses its deadline
+    return d_latency_us[backend] > d_load_limit * d_epoch_us;
+}
+
+
+void Correlator_Backend_Scheduler::rebalance()
+{
+    if (overloaded(CORRELATOR_BACKEND_GPU, CORRELATOR_BACKEND_CPU) && has_room(CORRELATOR_BACKEND_CPU))
+        {
+            migrate(CORRELATOR_BACKEND_GPU, CORRELATOR_BACKEND_CPU);
+        }
+    else if (overloaded(CORRELATOR_BACKEND_CPU, CORRELATOR_BACKEND_GPU) && has_room(CORRELATOR_BACKEND_GPU))
+        {
+            migrate(CORRELATOR_BACKEND_CPU, CORRELATOR_BACKEND_GPU);
+        }
+}
+
+
+void Correlator_Backend_Scheduler::migrate(Correlator_Backend from, Correlator_Backend to)
+{
+    // the slowest channel gains the most from the move
+    std::map<unsigned int, Channel_Load>::iterator slowest = d_channels.end();
+    for (std::map<unsigned int, Channel_Load>::iterator it = d_channels.begin(); it != d_channels.end(); ++it)
+        {
+            if (it->second.backend == from && (slowest == d_channels.end() || it->second.latency_us > slowest->second.latency_us))
+                {
+                    slowest = it;
+                }
+        }
+    if (slowest == d_channels.end()) return;
+    slowest->second.backend = to;
+    slowest->second.latency_us = 0.0;
+    d_migrations++;
+    LOG(INFO) << "Channel " << slowest->first << " moved from the " << backend_name(from) << " to the "
+              << backend_name(to) << " correlators, epoch latency " << d_latency_us[from]
+              << " us vs " << d_latency_us[to] << " us";
+}
@@ -0,0 +1,121 @@
+/*!
+ * \file correlator_backend_scheduler.h
+ * \brief Assignment of the tracking channels to the CPU or GPU correlators
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * With the GPU tracking blocks every channel is correlated on the GPU, so a
+ * saturated device delays all of them. The blocks also own a CPU
+ * correlator, and this scheduler decides, from the latency they measure at
+ * each epoch, which one each channel uses. A channel moves at an epoch
+ * boundary: the loop and NCO state stay in the block, and both correlators
+ * hold the local code, so nothing else has to be carried over.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CORRELATOR_BACKEND_SCHEDULER_H_
+#define GNSS_SDR_CORRELATOR_BACKEND_SCHEDULER_H_
+
+#include <map>
+#include <boost/thread/mutex.hpp>
+
+enum Correlator_Backend
+{
+    CORRELATOR_BACKEND_CPU = 0,
+    CORRELATOR_BACKEND_GPU = 1
+};
+
+/*!
+ * \brief Balances the tracking channels between the CPU and GPU correlators.
+ *
+ * Each backend keeps a smoothed latency of the epochs correlated on it.
+ * Every rebalance_reports reports, one channel moves from the GPU to the
+ * CPU if the CPU has room and the GPU latency exceeds the CPU one by a
+ * margin, or, before the CPU has been measured, load_limit times the epoch
+ * duration; or from the CPU to the GPU in the opposite case. Moving a single channel per period lets the estimates
+ * settle before the next decision. Thread-safe.
+ */
+class Correlator_Backend_Scheduler
+{
+public:
+    //! Returns the scheduler shared by the tracking blocks
+    static Correlator_Backend_Scheduler& instance();
+
+    Correlator_Backend_Scheduler();
+
+    /*!
+     * \brief Disabled, every channel is assigned to the GPU, as without the
+     * scheduler. A max_channels of 0 leaves that backend unbounded.
+     */
+    void configure(bool enabled, unsigned int gpu_max_channels, unsigned int cpu_max_channels,
+            unsigned int rebalance_reports, double load_limit);
+
+    //! Backend of a channel that starts tracking
+    Correlator_Backend assign(unsigned int channel);
+
+    //! Backend to use for the next epoch of a channel
+    Correlator_Backend backend(unsigned int channel);
+
+    //! Time taken by the correlation of an epoch of epoch_us microseconds, on the channel backend
+    void report(unsigned int channel, double latency_us, double epoch_us);
+
+    //! The channel stopped tracking
+    void release(unsigned int channel);
+
+    unsigned int channels(Correlator_Backend backend);
+
+    //! Smoothed latency of an epoch on the backend [us], 0 before the first report
+    double latency_us(Correlator_Backend backend);
+
+    unsigned long long migrations();
+
+private:
+    struct Channel_Load
+    {
+        Correlator_Backend backend;
+        double latency_us;
+    };
+
+    bool has_room(Correlator_Backend backend) const;
+    unsigned int count(Correlator_Backend backend) const;
+    bool overloaded(Correlator_Backend backend, Correlator_Backend other) const;
+    void rebalance();
+    void migrate(Correlator_Backend from, Correlator_Backend to);
+
+    bool d_enabled;
+    unsigned int d_max_channels[2];
+    unsigned int d_rebalance_reports;
+    double d_load_limit;
+
+    std::map<unsigned int, Channel_Load> d_channels;
+    double d_latency_us[2];
+    bool d_measured[2];
+    double d_epoch_us;
+    unsigned int d_reports;
+    unsigned long long d_migrations;
+    boost::mutex d_mutex;
+};
+
+#endif /* GNSS_SDR_CORRELATOR_BACKEND_SCHEDULER_H_ */
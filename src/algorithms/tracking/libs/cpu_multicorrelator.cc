@@ -33,6 +33,9 @@
  */
 
 #include "cpu_multicorrelator.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <volk_gnsssdr/volk_gnsssdr.h>
@@ -42,11 +45,16 @@ cpu_multicorrelator::cpu_multicorrelator()
 {
     d_sig_in = nullptr;
     d_local_code_in = nullptr;
+    d_pilot_code_in = nullptr;
     d_shifts_chips = nullptr;
+    d_pilot_shifts_chips = nullptr;
     d_corr_out = nullptr;
     d_local_codes_resampled = nullptr;
     d_code_length_chips = 0;
     d_n_correlators = 0;
+    d_n_pilot_correlators = 0;
+    d_fast_resampler = false;
+    d_fft_correlation = false;
 }
 
 
@@ -62,16 +70,28 @@ cpu_multicorrelator::~cpu_multicorrelator()
 bool cpu_multicorrelator::init(
         int max_signal_length_samples,
         int n_correlators)
+{
+    return init(max_signal_length_samples, n_correlators, 0);
+}
+
+
+bool cpu_multicorrelator::init(
+        int max_signal_length_samples,
+        int n_correlators,
+        int n_pilot_correlators)
 {
     // ALLOCATE MEMORY FOR INTERNAL vectors
     size_t size = max_signal_length_samples * sizeof(std::complex<float>);
+    // the pilot replicas follow the data ones
+    int n_replicas = n_correlators + n_pilot_correlators;
 
-    d_local_codes_resampled = static_cast<std::complex<float>**>(volk_gnsssdr_malloc(n_correlators * sizeof(std::complex<float>*), volk_gnsssdr_get_alignment()));
-    for (int n = 0; n < n_correlators; n++)
+    d_local_codes_resampled = static_cast<std::complex<float>**>(gnss_sdr_volk_gnsssdr_malloc(n_replicas * sizeof(std::complex<float>*), volk_gnsssdr_get_alignment()));
+    for (int n = 0; n < n_replicas; n++)
         {
-            d_local_codes_resampled[n] = static_cast<std::complex<float>*>(volk_gnsssdr_malloc(size, volk_gnsssdr_get_alignment()));
+            d_local_codes_resampled[n] = static_cast<std::complex<float>*>(gnss_sdr_volk_gnsssdr_malloc(size, volk_gnsssdr_get_alignment()));
         }
     d_n_correlators = n_correlators;
+    d_n_pilot_correlators = n_pilot_correlators;
     return true;
 }
 
@@ -89,6 +109,16 @@ bool cpu_multicorrelator::set_local_code_and_taps(
 }
 
 
+bool cpu_multicorrelator::set_pilot_code_and_taps(
+        const std::complex<float>* pilot_code_in,
+        float *pilot_shifts_chips)
+{
+    d_pilot_code_in = pilot_code_in;
+    d_pilot_shifts_chips = pilot_shifts_chips;
+    return true;
+}
+
+
 bool cpu_multicorrelator::set_input_output_vectors(std::complex<float>* corr_out, const std::complex<float>* sig_in)
 {
     // Save CPU pointers
@@ -98,15 +128,52 @@ bool cpu_multicorrelator::set_input_output_vectors(std::complex<float>* corr_out
 }
 
 
+void cpu_multicorrelator::set_fast_resampler(bool fast_resampler)
+{
+    d_fast_resampler = fast_resampler;
+}
+
+
+void cpu_multicorrelator::set_fft_correlation(bool fft_correlation)
+{
+    d_fft_correlation = fft_correlation;
+}
+
+
 void cpu_multicorrelator::update_local_code(int correlator_length_samples, float rem_code_phase_chips, float code_phase_step_chips)
 {
-    volk_gnsssdr_32fc_xn_resampler_32fc_xn(d_local_codes_resampled,
-            d_local_code_in,
+    resample(d_local_codes_resampled, d_local_code_in, d_shifts_chips, d_n_correlators,
+            correlator_length_samples, rem_code_phase_chips, code_phase_step_chips);
+    if (d_n_pilot_correlators > 0)
+        {
+            resample(d_local_codes_resampled + d_n_correlators, d_pilot_code_in, d_pilot_shifts_chips, d_n_pilot_correlators,
+                    correlator_length_samples, rem_code_phase_chips, code_phase_step_chips);
+        }
+}
+
+
+void cpu_multicorrelator::resample(std::complex<float>** replicas, const std::complex<float>* code, float* shifts_chips, int n_replicas,
+        int correlator_length_samples, float rem_code_phase_chips, float code_phase_step_chips)
+{
+    if (d_fast_resampler)
+        {
+            volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn(replicas,
+                    code,
+                    rem_code_phase_chips,
+                    code_phase_step_chips,
+                    shifts_chips,
+                    d_code_length_chips,
+                    n_replicas,
+                    correlator_length_samples);
+            return;
+        }
+    volk_gnsssdr_32fc_xn_resampler_32fc_xn(replicas,
+            code,
             rem_code_phase_chips,
             code_phase_step_chips,
-            d_shifts_chips,
+            shifts_chips,
             d_code_length_chips,
-            d_n_correlators,
+            n_replicas,
             correlator_length_samples);
 }
 
@@ -118,26 +185,91 @@ bool cpu_multicorrelator::Carrier_wipeoff_multicorrelator_resampler(
         float code_phase_step_chips,
         int signal_length_samples)
 {
-    update_local_code(signal_length_samples, rem_code_phase_chips, code_phase_step_chips);
+    GNSS_SDR_TRACE_SCOPE("cpu_multicorrelator::Carrier_wipeoff_multicorrelator_resampler");
     // Regenerate phase at each call in order to avoid numerical issues
     lv_32fc_t phase_offset_as_complex[1];
     phase_offset_as_complex[0] = lv_cmake(std::cos(rem_carrier_phase_in_rad), -std::sin(rem_carrier_phase_in_rad));
-    // call VOLK_GNSSSDR kernel
-    volk_gnsssdr_32fc_x2_rotator_dot_prod_32fc_xn(d_corr_out, d_sig_in, std::exp(lv_32fc_t(0, - phase_step_rad)), phase_offset_as_complex, (const lv_32fc_t**)d_local_codes_resampled, d_n_correlators, signal_length_samples);
+    if (d_fft_correlation)
+        {
+            fft_correlate(phase_offset_as_complex, std::exp(lv_32fc_t(0, - phase_step_rad)), rem_code_phase_chips,
+                    code_phase_step_chips, signal_length_samples);
+            return true;
+        }
+    if (d_fast_resampler || d_n_pilot_correlators > 0)
+        {
+            // data and pilot replicas in the same pass over the samples
+            update_local_code(signal_length_samples, rem_code_phase_chips, code_phase_step_chips);
+            volk_gnsssdr_32fc_x2_rotator_dot_prod_32fc_xn(d_corr_out, d_sig_in, std::exp(lv_32fc_t(0, - phase_step_rad)), phase_offset_as_complex,
+                    (const lv_32fc_t**)d_local_codes_resampled, d_n_correlators + d_n_pilot_correlators, signal_length_samples);
+            return true;
+        }
+    // call VOLK_GNSSSDR kernel. The code replicas are resampled on the fly,
+    // so d_local_codes_resampled is only filled by update_local_code()
+    volk_gnsssdr_32fc_x2_resampler_rotator_dot_prod_32fc_xn(d_corr_out, d_sig_in, std::exp(lv_32fc_t(0, - phase_step_rad)), phase_offset_as_complex,
+            d_local_code_in, rem_code_phase_chips, code_phase_step_chips, d_shifts_chips, d_code_length_chips, d_n_correlators, signal_length_samples);
     return true;
 }
 
 
+bool cpu_multicorrelator::Carrier_wipeoff_multicorrelator_resampler(
+        Carrier_Rotator& rotator,
+        float rem_code_phase_chips,
+        float code_phase_step_chips,
+        int signal_length_samples)
+{
+    GNSS_SDR_TRACE_SCOPE("cpu_multicorrelator::Carrier_wipeoff_multicorrelator_resampler");
+    if (d_fft_correlation)
+        {
+            fft_correlate(rotator.phase(), rotator.phase_inc(), rem_code_phase_chips,
+                    code_phase_step_chips, signal_length_samples);
+        }
+    else if (d_fast_resampler || d_n_pilot_correlators > 0)
+        {
+            update_local_code(signal_length_samples, rem_code_phase_chips, code_phase_step_chips);
+            volk_gnsssdr_32fc_x2_rotator_dot_prod_32fc_xn(d_corr_out, d_sig_in, rotator.phase_inc(), rotator.phase(),
+                    (const lv_32fc_t**)d_local_codes_resampled, d_n_correlators + d_n_pilot_correlators, signal_length_samples);
+        }
+    else
+        {
+            volk_gnsssdr_32fc_x2_resampler_rotator_dot_prod_32fc_xn(d_corr_out, d_sig_in, rotator.phase_inc(), rotator.phase(),
+                    d_local_code_in, rem_code_phase_chips, code_phase_step_chips, d_shifts_chips, d_code_length_chips, d_n_correlators, signal_length_samples);
+        }
+    rotator.advance(signal_length_samples);
+    return true;
+}
+
+
+void cpu_multicorrelator::fft_correlate(std::complex<float>* phase, std::complex<float> phase_inc,
+        float rem_code_phase_chips, float code_phase_step_chips, int signal_length_samples)
+{
+    GNSS_SDR_TRACE_SCOPE("cpu_multicorrelator::fft_correlate");
+    // one window holds the taps of both codes
+    int max_lag = Fft_Correlation_Window::max_lag_samples(d_shifts_chips, d_n_correlators, code_phase_step_chips);
+    if (d_n_pilot_correlators > 0)
+        {
+            max_lag = std::max(max_lag, Fft_Correlation_Window::max_lag_samples(d_pilot_shifts_chips, d_n_pilot_correlators, code_phase_step_chips));
+        }
+    d_fft_window.set_signal(d_sig_in, phase, phase_inc, signal_length_samples, max_lag);
+    d_fft_window.correlate(d_corr_out, d_local_code_in, d_code_length_chips, rem_code_phase_chips,
+            code_phase_step_chips, d_shifts_chips, d_n_correlators);
+    if (d_n_pilot_correlators > 0)
+        {
+            d_fft_window.correlate(d_corr_out + d_n_correlators, d_pilot_code_in, d_code_length_chips, rem_code_phase_chips,
+                    code_phase_step_chips, d_pilot_shifts_chips, d_n_pilot_correlators);
+        }
+}
+
+
 bool cpu_multicorrelator::free()
 {
     // Free memory
     if (d_local_codes_resampled != nullptr)
         {
-            for (int n = 0; n < d_n_correlators; n++)
+            for (int n = 0; n < d_n_correlators + d_n_pilot_correlators; n++)
                 {
-                    volk_gnsssdr_free(d_local_codes_resampled[n]);
+                    gnss_sdr_volk_gnsssdr_free(d_local_codes_resampled[n]);
                 }
-            volk_gnsssdr_free(d_local_codes_resampled);
+            gnss_sdr_volk_gnsssdr_free(d_local_codes_resampled);
             d_local_codes_resampled = nullptr;
         }
     return true;
@@ -37,9 +37,21 @@
 
 
 #include <complex>
+#include "carrier_rotator.h"
+#include "fft_correlation_window.h"
 
 /*!
  * \brief Class that implements carrier wipe-off and correlators.
+ *
+ * Signals with a data and a pilot component, such as Galileo E1 B/C or
+ * E5a I/Q, can be correlated in a single pass over the input samples: the
+ * pilot code replicas are dot products of the same rotator kernel call as
+ * the data ones, so the carrier wipe-off is shared. The outputs of the
+ * pilot correlators follow the ones of the data correlators in corr_out.
+ *
+ * Many correlators, as used to monitor the shape of the correlation peak,
+ * are cheaper computed from the whole correlation window with FFTs, see
+ * set_fft_correlation().
  */
 class cpu_multicorrelator
 {
@@ -47,21 +59,66 @@ public:
     cpu_multicorrelator();
     ~cpu_multicorrelator();
     bool init(int max_signal_length_samples, int n_correlators);
+    /*!
+     * \brief Same as above, with \p n_pilot_correlators correlators of a
+     * pilot code set by set_pilot_code_and_taps()
+     */
+    bool init(int max_signal_length_samples, int n_correlators, int n_pilot_correlators);
     bool set_local_code_and_taps(int code_length_chips, const std::complex<float>* local_code_in, float *shifts_chips);
+    /*!
+     * \brief Sets the pilot code, of the same length and code phase as the
+     * data code, and the shifts of its correlators [chips]
+     */
+    bool set_pilot_code_and_taps(const std::complex<float>* pilot_code_in, float *pilot_shifts_chips);
     bool set_input_output_vectors(std::complex<float>* corr_out, const std::complex<float>* sig_in);
     void update_local_code(int correlator_length_samples, float rem_code_phase_chips, float code_phase_step_chips);
     bool Carrier_wipeoff_multicorrelator_resampler(float rem_carrier_phase_in_rad, float phase_step_rad, float rem_code_phase_chips, float code_phase_step_chips, int signal_length_samples);
+    /*!
+     * \brief Same as above, with the carrier wipe-off done by \p rotator,
+     * which is then advanced by \p signal_length_samples
+     */
+    bool Carrier_wipeoff_multicorrelator_resampler(Carrier_Rotator& rotator, float rem_code_phase_chips, float code_phase_step_chips, int signal_length_samples);
+    /*!
+     * \brief Resamples the code replicas with the fixed-point code NCO
+     * (volk_gnsssdr_32fc_xn_resampler_fast_32fc_xn) before the dot products,
+     * instead of computing the chip indices inside the fused kernel.
+     * It pays off for long codes such as GPS L2CM or Galileo E5a.
+     */
+    void set_fast_resampler(bool fast_resampler);
+    /*!
+     * \brief Computes the correlators from the correlation at every sample
+     * lag around the prompt (Fft_Correlation_Window) instead of one dot
+     * product per correlator. It pays off from a few tens of correlators;
+     * taps between two sample lags are interpolated linearly.
+     */
+    void set_fft_correlation(bool fft_correlation);
+    //! Correlation window of the last call with set_fft_correlation(true)
+    const Fft_Correlation_Window& fft_correlation_window() const
+    {
+        return d_fft_window;
+    }
     bool free();
 
 private:
+    void resample(std::complex<float>** replicas, const std::complex<float>* code, float* shifts_chips, int n_replicas,
+            int correlator_length_samples, float rem_code_phase_chips, float code_phase_step_chips);
+    void fft_correlate(std::complex<float>* phase, std::complex<float> phase_inc, float rem_code_phase_chips,
+            float code_phase_step_chips, int signal_length_samples);
+
     // Allocate the device input vectors
     const std::complex<float> *d_sig_in;
     std::complex<float> **d_local_codes_resampled;
     const std::complex<float> *d_local_code_in;
+    const std::complex<float> *d_pilot_code_in;
     std::complex<float> *d_corr_out;
     float *d_shifts_chips;
+    float *d_pilot_shifts_chips;
     int d_code_length_chips;
     int d_n_correlators;
+    int d_n_pilot_correlators;
+    bool d_fast_resampler;
+    bool d_fft_correlation;
+    Fft_Correlation_Window d_fft_window;
 };
 
 
@@ -33,6 +33,8 @@
  */
 
 #include "cpu_multicorrelator_16sc.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
 #include <cmath>
 
 
@@ -40,17 +42,29 @@
 bool cpu_multicorrelator_16sc::init(
         int max_signal_length_samples,
         int n_correlators)
+{
+    return init(max_signal_length_samples, n_correlators, 0);
+}
+
+
+bool cpu_multicorrelator_16sc::init(
+        int max_signal_length_samples,
+        int n_correlators,
+        int n_pilot_correlators)
 {
     // ALLOCATE MEMORY FOR INTERNAL vectors
     size_t size = max_signal_length_samples * sizeof(lv_16sc_t);
+    // the pilot replicas follow the data ones
+    int n_replicas = n_correlators + n_pilot_correlators;
 
     d_n_correlators = n_correlators;
-    d_tmp_code_phases_chips = static_cast<float*>(volk_gnsssdr_malloc(n_correlators * sizeof(float), volk_gnsssdr_get_alignment()));
+    d_n_pilot_correlators = n_pilot_correlators;
+    d_tmp_code_phases_chips = static_cast<float*>(gnss_sdr_volk_gnsssdr_malloc(n_replicas * sizeof(float), volk_gnsssdr_get_alignment()));
 
-    d_local_codes_resampled = static_cast<lv_16sc_t**>(volk_gnsssdr_malloc(n_correlators * sizeof(lv_16sc_t*), volk_gnsssdr_get_alignment()));
-    for (int n = 0; n < n_correlators; n++)
+    d_local_codes_resampled = static_cast<lv_16sc_t**>(gnss_sdr_volk_gnsssdr_malloc(n_replicas * sizeof(lv_16sc_t*), volk_gnsssdr_get_alignment()));
+    for (int n = 0; n < n_replicas; n++)
         {
-            d_local_codes_resampled[n] = static_cast<lv_16sc_t*>(volk_gnsssdr_malloc(size, volk_gnsssdr_get_alignment()));
+            d_local_codes_resampled[n] = static_cast<lv_16sc_t*>(gnss_sdr_volk_gnsssdr_malloc(size, volk_gnsssdr_get_alignment()));
         }
     return true;
 }
@@ -69,29 +83,63 @@ bool cpu_multicorrelator_16sc::set_local_code_and_taps(
 }
 
 
+bool cpu_multicorrelator_16sc::set_pilot_code_and_taps(
+        const lv_16sc_t* pilot_code_in,
+        float *pilot_shifts_chips)
+{
+    d_pilot_code_in = pilot_code_in;
+    d_pilot_shifts_chips = pilot_shifts_chips;
+    return true;
+}
+
+
 bool cpu_multicorrelator_16sc::set_input_output_vectors(lv_16sc_t* corr_out, const lv_16sc_t* sig_in)
 {
     // Save CPU pointers
     d_sig_in = sig_in;
     d_corr_out = corr_out;
+    d_corr_out_32fc = nullptr;
+    return true;
+}
+
+
+bool cpu_multicorrelator_16sc::set_input_output_vectors(lv_32fc_t* corr_out, const lv_16sc_t* sig_in)
+{
+    // Save CPU pointers
+    d_sig_in = sig_in;
+    d_corr_out = nullptr;
+    d_corr_out_32fc = corr_out;
     return true;
 }
 
 
 void cpu_multicorrelator_16sc::update_local_code(int correlator_length_samples, float rem_code_phase_chips, float code_phase_step_chips)
 {
-    for (int n = 0; n < d_n_correlators; n++)
+    resample(d_local_codes_resampled, d_local_code_in, d_shifts_chips, d_n_correlators,
+            correlator_length_samples, rem_code_phase_chips, code_phase_step_chips);
+    if (d_n_pilot_correlators > 0)
         {
-            d_tmp_code_phases_chips[n] = d_shifts_chips[n] - rem_code_phase_chips;
+            resample(d_local_codes_resampled + d_n_correlators, d_pilot_code_in, d_pilot_shifts_chips, d_n_pilot_correlators,
+                    correlator_length_samples, rem_code_phase_chips, code_phase_step_chips);
         }
+}
 
-    volk_gnsssdr_16ic_xn_resampler_fast_16ic_xn(d_local_codes_resampled,
-            d_local_code_in,
+
+void cpu_multicorrelator_16sc::resample(lv_16sc_t** replicas, const lv_16sc_t* code, const float* shifts_chips, int n_replicas,
+        int correlator_length_samples, float rem_code_phase_chips, float code_phase_step_chips)
+{
+    for (int n = 0; n < n_replicas; n++)
+        {
+            d_tmp_code_phases_chips[n] = shifts_chips[n] - rem_code_phase_chips;
+        }
+
+    volk_gnsssdr_16ic_xn_resampler_fast_16ic_xn(replicas,
+            code,
             d_tmp_code_phases_chips,
             code_phase_step_chips,
-            correlator_length_samples,
-            d_n_correlators,
-            d_code_length_chips);
+            d_code_length_chips,
+            n_replicas,
+            correlator_length_samples);
 }
 
 
@@ -102,12 +150,41 @@ bool cpu_multicorrelator_16sc::Carrier_wipeoff_multicorrelator_resampler(
         float code_phase_step_chips,
         int signal_length_samples)
 {
+    GNSS_SDR_TRACE_SCOPE("cpu_multicorrelator_16sc::Carrier_wipeoff_multicorrelator_resampler");
     update_local_code(signal_length_samples, rem_code_phase_chips, code_phase_step_chips);
     // Regenerate phase at each call in order to avoid numerical issues
     lv_32fc_t phase_offset_as_complex[1];
     phase_offset_as_complex[0] = lv_cmake(std::cos(rem_carrier_phase_in_rad), -std::sin(rem_carrier_phase_in_rad));
     // call VOLK_GNSSSDR kernel
-    volk_gnsssdr_16ic_x2_rotator_dot_prod_16ic_xn(d_corr_out, d_sig_in, std::exp(lv_32fc_t(0, -phase_step_rad)), phase_offset_as_complex, (const lv_16sc_t**)d_local_codes_resampled, d_n_correlators, signal_length_samples);
+    if (d_corr_out_32fc != nullptr)
+        {
+            volk_gnsssdr_16ic_x2_rotator_dot_prod_32fc_xn(d_corr_out_32fc, d_sig_in, std::exp(lv_32fc_t(0, -phase_step_rad)), phase_offset_as_complex, (const lv_16sc_t**)d_local_codes_resampled, d_n_correlators + d_n_pilot_correlators, signal_length_samples);
+        }
+    else
+        {
+            volk_gnsssdr_16ic_x2_rotator_dot_prod_16ic_xn(d_corr_out, d_sig_in, std::exp(lv_32fc_t(0, -phase_step_rad)), phase_offset_as_complex, (const lv_16sc_t**)d_local_codes_resampled, d_n_correlators + d_n_pilot_correlators, signal_length_samples);
+        }
+    return true;
+}
+
+
+bool cpu_multicorrelator_16sc::Carrier_wipeoff_multicorrelator_resampler(
+        Carrier_Rotator& rotator,
+        float rem_code_phase_chips,
+        float code_phase_step_chips,
+        int signal_length_samples)
+{
+    GNSS_SDR_TRACE_SCOPE("cpu_multicorrelator_16sc::Carrier_wipeoff_multicorrelator_resampler");
+    update_local_code(signal_length_samples, rem_code_phase_chips, code_phase_step_chips);
+    if (d_corr_out_32fc != nullptr)
+        {
+            volk_gnsssdr_16ic_x2_rotator_dot_prod_32fc_xn(d_corr_out_32fc, d_sig_in, rotator.phase_inc(), rotator.phase(), (const lv_16sc_t**)d_local_codes_resampled, d_n_correlators + d_n_pilot_correlators, signal_length_samples);
+        }
+    else
+        {
+            volk_gnsssdr_16ic_x2_rotator_dot_prod_16ic_xn(d_corr_out, d_sig_in, rotator.phase_inc(), rotator.phase(), (const lv_16sc_t**)d_local_codes_resampled, d_n_correlators + d_n_pilot_correlators, signal_length_samples);
+        }
+    rotator.advance(signal_length_samples);
     return true;
 }
 
@@ -116,12 +193,16 @@ cpu_multicorrelator_16sc::cpu_multicorrelator_16sc()
 {
     d_sig_in = nullptr;
     d_local_code_in = nullptr;
+    d_pilot_code_in = nullptr;
     d_shifts_chips = nullptr;
+    d_pilot_shifts_chips = nullptr;
     d_corr_out = nullptr;
+    d_corr_out_32fc = nullptr;
     d_local_codes_resampled = nullptr;
     d_tmp_code_phases_chips = nullptr;
     d_code_length_chips = 0;
     d_n_correlators = 0;
+    d_n_pilot_correlators = 0;
 }
 
 
@@ -139,16 +220,16 @@ bool cpu_multicorrelator_16sc::free()
     // Free memory
     if (d_tmp_code_phases_chips != nullptr)
         {
-            volk_gnsssdr_free(d_tmp_code_phases_chips);
+            gnss_sdr_volk_gnsssdr_free(d_tmp_code_phases_chips);
             d_tmp_code_phases_chips = nullptr;
         }
     if (d_local_codes_resampled != nullptr)
         {
-            for (int n = 0; n < d_n_correlators; n++)
+            for (int n = 0; n < d_n_correlators + d_n_pilot_correlators; n++)
                 {
-                    volk_gnsssdr_free(d_local_codes_resampled[n]);
+                    gnss_sdr_volk_gnsssdr_free(d_local_codes_resampled[n]);
                 }
-            volk_gnsssdr_free(d_local_codes_resampled);
+            gnss_sdr_volk_gnsssdr_free(d_local_codes_resampled);
             d_local_codes_resampled = nullptr;
         }
     return true;
@@ -36,10 +36,15 @@
 #define GNSS_SDR_CPU_MULTICORRELATOR_16SC_H_
 
 #include <volk_gnsssdr/volk_gnsssdr.h>
+#include "carrier_rotator.h"
 
 
 /*!
  * \brief Class that implements carrier wipe-off and correlators.
+ *
+ * As in cpu_multicorrelator, the replicas of a pilot code can be
+ * correlated in the same pass as the data ones, their outputs following
+ * the data outputs in corr_out.
  */
 class cpu_multicorrelator_16sc
 {
@@ -47,22 +52,46 @@ public:
     cpu_multicorrelator_16sc();
     ~cpu_multicorrelator_16sc();
     bool init(int max_signal_length_samples, int n_correlators);
+    /*!
+     * \brief Same as above, with \p n_pilot_correlators correlators of a
+     * pilot code set by set_pilot_code_and_taps()
+     */
+    bool init(int max_signal_length_samples, int n_correlators, int n_pilot_correlators);
     bool set_local_code_and_taps(int code_length_chips, const lv_16sc_t* local_code_in, float *shifts_chips);
+    /*!
+     * \brief Sets the pilot code, of the same length and code phase as the
+     * data code, and the shifts of its correlators [chips]
+     */
+    bool set_pilot_code_and_taps(const lv_16sc_t* pilot_code_in, float *pilot_shifts_chips);
     bool set_input_output_vectors(lv_16sc_t* corr_out, const lv_16sc_t* sig_in);
+    //! Correlator outputs accumulated without saturation, for long coherent integrations
+    bool set_input_output_vectors(lv_32fc_t* corr_out, const lv_16sc_t* sig_in);
     void update_local_code(int correlator_length_samples, float rem_code_phase_chips, float code_phase_step_chips);
     bool Carrier_wipeoff_multicorrelator_resampler(float rem_carrier_phase_in_rad, float phase_step_rad, float rem_code_phase_chips, float code_phase_step_chips, int signal_length_samples);
+    /*!
+     * \brief Same as above, with the carrier wipe-off done by \p rotator,
+     * which is then advanced by \p signal_length_samples
+     */
+    bool Carrier_wipeoff_multicorrelator_resampler(Carrier_Rotator& rotator, float rem_code_phase_chips, float code_phase_step_chips, int signal_length_samples);
     bool free();
 
 private:
+    void resample(lv_16sc_t** replicas, const lv_16sc_t* code, const float* shifts_chips, int n_replicas,
+            int correlator_length_samples, float rem_code_phase_chips, float code_phase_step_chips);
+
     // Allocate the device input vectors
     const lv_16sc_t *d_sig_in;
     float *d_tmp_code_phases_chips;
     lv_16sc_t **d_local_codes_resampled;
     const lv_16sc_t *d_local_code_in;
+    const lv_16sc_t *d_pilot_code_in;
     lv_16sc_t *d_corr_out;
+    lv_32fc_t *d_corr_out_32fc;
     float *d_shifts_chips;
+    float *d_pilot_shifts_chips;
     int d_code_length_chips;
     int d_n_correlators;
+    int d_n_pilot_correlators;
 };
 
 
@@ -0,0 +1,68 @@
+/*!
+ * \file cpu_multicorrelator_8sc.h
+ * \brief High optimized CPU vector multiTAP correlator class for lv_8sc_t (8-bit integer complex) samples
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Class that implements a high optimized vector multiTAP correlator class for CPUs,
+ * for the samples of an 8-bit front-end. The samples are read as they come and are
+ * widened to floats in the registers of the kernel only; the local code replicas and
+ * the correlator outputs are floats.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CPU_MULTICORRELATOR_8SC_H_
+#define GNSS_SDR_CPU_MULTICORRELATOR_8SC_H_
+
+#include <volk_gnsssdr/volk_gnsssdr.h>
+
+
+/*!
+ * \brief Class that implements carrier wipe-off and correlators of 8-bit samples.
+ */
+class cpu_multicorrelator_8sc
+{
+public:
+    cpu_multicorrelator_8sc();
+    ~cpu_multicorrelator_8sc();
+    bool init(int max_signal_length_samples, int n_correlators);
+    bool set_local_code_and_taps(int code_length_chips, const lv_32fc_t* local_code_in, float *shifts_chips);
+    bool set_input_output_vectors(lv_32fc_t* corr_out, const lv_8sc_t* sig_in);
+    void update_local_code(int correlator_length_samples, float rem_code_phase_chips, float code_phase_step_chips);
+    bool Carrier_wipeoff_multicorrelator_resampler(float rem_carrier_phase_in_rad, float phase_step_rad, float rem_code_phase_chips, float code_phase_step_chips, int signal_length_samples);
+    bool free();
+
+private:
+    const lv_8sc_t *d_sig_in;
+    lv_32fc_t **d_local_codes_resampled;
+    const lv_32fc_t *d_local_code_in;
+    lv_32fc_t *d_corr_out;
+    float *d_shifts_chips;
+    int d_code_length_chips;
+    int d_n_correlators;
+};
+
+
+#endif /* GNSS_SDR_CPU_MULTICORRELATOR_8SC_H_ */
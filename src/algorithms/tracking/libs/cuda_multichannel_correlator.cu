@@ -0,0 +1,418 @@
+/*!
+ * \file cuda_multichannel_correlator.cu
+ * \brief Carrier wipe-off, code resampling and correlation of many channels
+ *  in a single CUDA kernel launch, over a device-resident input buffer.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "cuda_multichannel_correlator.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cuda_runtime.h>
+
+#define MULTICHANNEL_THREADS_PER_BLOCK 256
+#define TWO_PI_F 6.28318530717958647692f
+
+#define mcErrchk(ans) mcAssert((ans), __FILE__, __LINE__)
+inline bool mcAssert(cudaError_t code, const char *file, int line)
+{
+    if (code != cudaSuccess)
+        {
+            fprintf(stderr, "GPUassert: %s %s %d\n", cudaGetErrorString(code), file, line);
+            return false;
+        }
+    return true;
+}
+
+
+/*
+ * One thread block per submitted channel. Every thread walks the samples of
+ * the channel with a stride of blockDim.x, wipes off the carrier once per
+ * sample and accumulates all the taps in registers, so the input is read
+ * once per channel instead of once per tap. The partial sums are then
+ * reduced in shared memory, one tap at a time.
+ */
+__global__ void multichannel_carrier_wipeoff_multicorrelator(
+        GPU_Complex *d_corr_out,
+        const cuda_channel_params *d_params,
+        const GPU_Complex *d_ring,
+        int ring_length,
+        const GPU_Complex *d_local_codes,
+        int code_stride,
+        const float *d_shifts_chips)
+{
+    extern __shared__ GPU_Complex partial_sums[];
+
+    const cuda_channel_params p = d_params[blockIdx.x];
+    const GPU_Complex *code = d_local_codes + p.channel * code_stride;
+    const float *shifts = d_shifts_chips + p.channel * CUDA_MULTICHANNEL_MAX_TAPS;
+
+    GPU_Complex sum[CUDA_MULTICHANNEL_MAX_TAPS];
+    for (int tap = 0; tap < CUDA_MULTICHANNEL_MAX_TAPS; tap++)
+        {
+            sum[tap] = GPU_Complex(0, 0);
+        }
+
+    float sin;
+    float cos;
+    for (int n = threadIdx.x; n < p.length_samples; n += blockDim.x)
+        {
+            int ring_index = p.ring_offset + n;
+            if (ring_index >= ring_length) ring_index -= ring_length;
+
+            // The carrier phase is computed from the sample index rather than
+            // rotated sample by sample, so it does not accumulate rounding errors.
+            // __sincosf is only accurate in [-pi, pi], hence the range reduction.
+            float phase = p.rem_carrier_phase_in_rad + __int2float_rn(n) * p.phase_step_rad;
+            phase -= TWO_PI_F * rintf(phase * (1.0f / TWO_PI_F));
+            __sincosf(phase, &sin, &cos);
+            GPU_Complex wiped = d_ring[ring_index] * GPU_Complex(cos, -sin);
+
+            const float code_phase = p.code_phase_step_chips * __int2float_rn(n) - p.rem_code_phase_chips;
+#pragma unroll
+            for (int tap = 0; tap < CUDA_MULTICHANNEL_MAX_TAPS; tap++)
+                {
+                    if (tap < p.n_correlators)
+                        {
+                            // same indexing as the volk_gnsssdr resampler: floor, then wrap
+                            // in both directions, since the shifts can be negative
+                            int chip = __float2int_rd(code_phase + shifts[tap]) % p.code_length_chips;
+                            if (chip < 0) chip += p.code_length_chips;
+                            sum[tap].multiply_acc(wiped, code[chip]);
+                        }
+                }
+        }
+
+    for (int tap = 0; tap < p.n_correlators; tap++)
+        {
+            partial_sums[threadIdx.x] = sum[tap];
+            __syncthreads();
+            // blockDim.x has to be a power of two
+            for (int stride = blockDim.x / 2; stride > 0; stride >>= 1)
+                {
+                    if (threadIdx.x < stride)
+                        {
+                            partial_sums[threadIdx.x] += partial_sums[threadIdx.x + stride];
+                        }
+                    __syncthreads();
+                }
+            if (threadIdx.x == 0)
+                {
+                    d_corr_out[blockIdx.x * CUDA_MULTICHANNEL_MAX_TAPS + tap] = partial_sums[0];
+                }
+            __syncthreads();
+        }
+}
+
+
+cuda_multichannel_correlator::cuda_multichannel_correlator()
+{
+    d_device = -1;
+    d_max_channels = 0;
+    d_max_code_length_chips = 0;
+    d_ring = 0;
+    d_staging_cpu = 0;
+    d_ring_length = 0;
+    d_samples_pushed = 0;
+    d_local_codes = 0;
+    d_shifts_chips = 0;
+    for (int b = 0; b < 2; b++)
+        {
+            d_params_cpu[b] = 0;
+            d_params_gpu[b] = 0;
+            d_corr_out_cpu[b] = 0;
+            d_corr_out_gpu[b] = 0;
+            d_n_submitted[b] = 0;
+        }
+    d_current = 0;
+    d_in_flight = -1;
+    d_upload_stream = 0;
+    d_compute_stream = 0;
+    d_upload_done = 0;
+    d_epoch_done[0] = 0;
+    d_epoch_done[1] = 0;
+    d_threads_per_block = MULTICHANNEL_THREADS_PER_BLOCK;
+}
+
+
+cuda_multichannel_correlator::~cuda_multichannel_correlator()
+{
+    free_cuda();
+}
+
+
+bool cuda_multichannel_correlator::init(int ring_buffer_samples, int max_channels, int max_code_length_chips, int device)
+{
+    if (d_ring != 0) free_cuda();
+
+    int num_devices = 0;
+    if (cudaGetDeviceCount(&num_devices) != cudaSuccess || num_devices == 0)
+        {
+            fprintf(stderr, "cuda_multichannel_correlator: no CUDA device found\n");
+            return false;
+        }
+    if (device < 0 || device >= num_devices)
+        {
+            int max_multiprocessors = 0;
+            device = 0;
+            for (int dev = 0; dev < num_devices; dev++)
+                {
+                    cudaDeviceProp properties;
+                    cudaGetDeviceProperties(&properties, dev);
+                    if (max_multiprocessors < properties.multiProcessorCount)
+                        {
+                            max_multiprocessors = properties.multiProcessorCount;
+                            device = dev;
+                        }
+                }
+        }
+    d_device = device;
+    if (!mcErrchk(cudaSetDevice(d_device))) return false;
+
+    d_ring_length = ring_buffer_samples;
+    d_max_channels = max_channels;
+    d_max_code_length_chips = max_code_length_chips;
+    d_samples_pushed = 0;
+    d_current = 0;
+    d_in_flight = -1;
+
+    bool ok = true;
+    ok = ok && mcErrchk(cudaMalloc((void**)&d_ring, sizeof(GPU_Complex) * d_ring_length));
+    ok = ok && mcErrchk(cudaHostAlloc((void**)&d_staging_cpu, sizeof(std::complex<float>) * d_ring_length, cudaHostAllocWriteCombined));
+    ok = ok && mcErrchk(cudaMalloc((void**)&d_local_codes, sizeof(GPU_Complex) * d_max_code_length_chips * d_max_channels));
+    ok = ok && mcErrchk(cudaMalloc((void**)&d_shifts_chips, sizeof(float) * CUDA_MULTICHANNEL_MAX_TAPS * d_max_channels));
+    for (int b = 0; b < 2; b++)
+        {
+            ok = ok && mcErrchk(cudaHostAlloc((void**)&d_params_cpu[b], sizeof(cuda_channel_params) * d_max_channels, cudaHostAllocDefault));
+            ok = ok && mcErrchk(cudaMalloc((void**)&d_params_gpu[b], sizeof(cuda_channel_params) * d_max_channels));
+            ok = ok && mcErrchk(cudaHostAlloc((void**)&d_corr_out_cpu[b], sizeof(GPU_Complex) * CUDA_MULTICHANNEL_MAX_TAPS * d_max_channels, cudaHostAllocDefault));
+            ok = ok && mcErrchk(cudaMalloc((void**)&d_corr_out_gpu[b], sizeof(GPU_Complex) * CUDA_MULTICHANNEL_MAX_TAPS * d_max_channels));
+            ok = ok && mcErrchk(cudaEventCreateWithFlags(&d_epoch_done[b], cudaEventDisableTiming));
+            d_n_submitted[b] = 0;
+        }
+    ok = ok && mcErrchk(cudaStreamCreateWithFlags(&d_upload_stream, cudaStreamNonBlocking));
+    ok = ok && mcErrchk(cudaStreamCreateWithFlags(&d_compute_stream, cudaStreamNonBlocking));
+    ok = ok && mcErrchk(cudaEventCreateWithFlags(&d_upload_done, cudaEventDisableTiming));
+    if (!ok)
+        {
+            free_cuda();
+        }
+    return ok;
+}
+
+
+int cuda_multichannel_correlator::add_channel(int code_length_chips, const std::complex<float>* local_code_in,
+        const float* shifts_chips, int n_correlators, std::complex<float>* corr_out)
+{
+    if (static_cast<int>(d_channels.size()) >= d_max_channels) return -1;
+    channel_state ch;
+    ch.corr_out = corr_out;
+    ch.code_length_chips = 0;
+    ch.n_correlators = 0;
+    d_channels.push_back(ch);
+    int channel = static_cast<int>(d_channels.size()) - 1;
+    if (!set_local_code_and_taps(channel, code_length_chips, local_code_in, shifts_chips, n_correlators))
+        {
+            d_channels.pop_back();
+            return -1;
+        }
+    return channel;
+}
+
+
+bool cuda_multichannel_correlator::set_local_code_and_taps(int channel, int code_length_chips,
+        const std::complex<float>* local_code_in, const float* shifts_chips, int n_correlators)
+{
+    if (channel < 0 || channel >= static_cast<int>(d_channels.size())) return false;
+    if (code_length_chips > d_max_code_length_chips || n_correlators > CUDA_MULTICHANNEL_MAX_TAPS) return false;
+    cudaSetDevice(d_device);
+    // The codes are only replaced between epochs, so a synchronous copy is fine
+    bool ok = mcErrchk(cudaMemcpy(d_local_codes + channel * d_max_code_length_chips, local_code_in,
+            sizeof(GPU_Complex) * code_length_chips, cudaMemcpyHostToDevice));
+    ok = ok && mcErrchk(cudaMemcpy(d_shifts_chips + channel * CUDA_MULTICHANNEL_MAX_TAPS, shifts_chips,
+            sizeof(float) * n_correlators, cudaMemcpyHostToDevice));
+    if (ok)
+        {
+            d_channels.at(channel).code_length_chips = code_length_chips;
+            d_channels.at(channel).n_correlators = n_correlators;
+        }
+    return ok;
+}
+
+
+unsigned long long cuda_multichannel_correlator::push_samples(const std::complex<float>* in, int n_samples)
+{
+    unsigned long long first_sample = d_samples_pushed;
+    if (n_samples <= 0) return first_sample;
+    cudaSetDevice(d_device);
+    // Only the last ring_length samples can be kept
+    if (n_samples > d_ring_length)
+        {
+            in += n_samples - d_ring_length;
+            d_samples_pushed += n_samples - d_ring_length;
+            n_samples = d_ring_length;
+        }
+    // The samples go through a pinned staging buffer, laid out as the ring
+    // itself, so that the copies are truly asynchronous. The previous upload
+    // of these positions has to be finished before they are overwritten.
+    cudaEventSynchronize(d_upload_done);
+    int start = static_cast<int>(d_samples_pushed % d_ring_length);
+    int first_part = std::min(n_samples, d_ring_length - start);
+    memcpy(d_staging_cpu + start, in, sizeof(std::complex<float>) * first_part);
+    mcErrchk(cudaMemcpyAsync(d_ring + start, d_staging_cpu + start, sizeof(GPU_Complex) * first_part,
+            cudaMemcpyHostToDevice, d_upload_stream));
+    if (first_part < n_samples)
+        {
+            memcpy(d_staging_cpu, in + first_part, sizeof(std::complex<float>) * (n_samples - first_part));
+            mcErrchk(cudaMemcpyAsync(d_ring, d_staging_cpu, sizeof(GPU_Complex) * (n_samples - first_part),
+                    cudaMemcpyHostToDevice, d_upload_stream));
+        }
+    cudaEventRecord(d_upload_done, d_upload_stream);
+    d_samples_pushed += n_samples;
+    return first_sample;
+}
+
+
+bool cuda_multichannel_correlator::submit(int channel, unsigned long long first_sample,
+        float rem_carrier_phase_in_rad, float phase_step_rad,
+        float rem_code_phase_chips, float code_phase_step_chips,
+        int signal_length_samples)
+{
+    if (channel < 0 || channel >= static_cast<int>(d_channels.size())) return false;
+    if (d_n_submitted[d_current] >= d_max_channels) return false;
+    // the whole integration has to be in the ring buffer
+    if (first_sample + signal_length_samples > d_samples_pushed) return false;
+    if (d_samples_pushed - first_sample > static_cast<unsigned long long>(d_ring_length)) return false;
+
+    cuda_channel_params& p = d_params_cpu[d_current][d_n_submitted[d_current]];
+    p.channel = channel;
+    p.ring_offset = static_cast<int>(first_sample % d_ring_length);
+    p.length_samples = signal_length_samples;
+    p.code_length_chips = d_channels.at(channel).code_length_chips;
+    p.n_correlators = d_channels.at(channel).n_correlators;
+    p.rem_carrier_phase_in_rad = rem_carrier_phase_in_rad;
+    p.phase_step_rad = phase_step_rad;
+    p.rem_code_phase_chips = rem_code_phase_chips;
+    p.code_phase_step_chips = code_phase_step_chips;
+    d_n_submitted[d_current]++;
+    return true;
+}
+
+
+bool cuda_multichannel_correlator::execute_async()
+{
+    const int b = d_current;
+    const int n_channels = d_n_submitted[b];
+    if (n_channels == 0) return true;
+    cudaSetDevice(d_device);
+    // Only one epoch can be in flight, since its results live in the other buffer
+    if (d_in_flight >= 0) wait();
+
+    bool ok = mcErrchk(cudaMemcpyAsync(d_params_gpu[b], d_params_cpu[b], sizeof(cuda_channel_params) * n_channels,
+            cudaMemcpyHostToDevice, d_compute_stream));
+    // the kernel must see all the samples pushed so far
+    ok = ok && mcErrchk(cudaStreamWaitEvent(d_compute_stream, d_upload_done, 0));
+    multichannel_carrier_wipeoff_multicorrelator<<<n_channels, d_threads_per_block,
+            d_threads_per_block * sizeof(GPU_Complex), d_compute_stream>>>(
+            d_corr_out_gpu[b], d_params_gpu[b], d_ring, d_ring_length,
+            d_local_codes, d_max_code_length_chips, d_shifts_chips);
+    ok = ok && mcErrchk(cudaGetLastError());
+    ok = ok && mcErrchk(cudaMemcpyAsync(d_corr_out_cpu[b], d_corr_out_gpu[b], sizeof(GPU_Complex) * CUDA_MULTICHANNEL_MAX_TAPS * n_channels,
+            cudaMemcpyDeviceToHost, d_compute_stream));
+    ok = ok && mcErrchk(cudaEventRecord(d_epoch_done[b], d_compute_stream));
+
+    // the next submissions go to the other buffer while this one is computed
+    d_in_flight = b;
+    d_current = 1 - b;
+    d_n_submitted[d_current] = 0;
+    return ok;
+}
+
+
+void cuda_multichannel_correlator::wait()
+{
+    if (d_in_flight < 0) return;
+    const int b = d_in_flight;
+    cudaSetDevice(d_device);
+    mcErrchk(cudaEventSynchronize(d_epoch_done[b]));
+    for (int i = 0; i < d_n_submitted[b]; i++)
+        {
+            const cuda_channel_params& p = d_params_cpu[b][i];
+            memcpy(d_channels.at(p.channel).corr_out, d_corr_out_cpu[b] + i * CUDA_MULTICHANNEL_MAX_TAPS,
+                    sizeof(std::complex<float>) * p.n_correlators);
+        }
+    d_n_submitted[b] = 0;
+    d_in_flight = -1;
+}
+
+
+void cuda_multichannel_correlator::execute()
+{
+    execute_async();
+    wait();
+}
+
+
+bool cuda_multichannel_correlator::free_cuda()
+{
+    if (d_ring == 0 && d_upload_stream == 0) return true;
+    cudaSetDevice(d_device);
+    if (d_upload_stream != 0) cudaStreamSynchronize(d_upload_stream);
+    if (d_compute_stream != 0) cudaStreamSynchronize(d_compute_stream);
+    if (d_ring != 0) cudaFree(d_ring);
+    if (d_staging_cpu != 0) cudaFreeHost(d_staging_cpu);
+    if (d_local_codes != 0) cudaFree(d_local_codes);
+    if (d_shifts_chips != 0) cudaFree(d_shifts_chips);
+    for (int b = 0; b < 2; b++)
+        {
+            if (d_params_cpu[b] != 0) cudaFreeHost(d_params_cpu[b]);
+            if (d_params_gpu[b] != 0) cudaFree(d_params_gpu[b]);
+            if (d_corr_out_cpu[b] != 0) cudaFreeHost(d_corr_out_cpu[b]);
+            if (d_corr_out_gpu[b] != 0) cudaFree(d_corr_out_gpu[b]);
+            if (d_epoch_done[b] != 0) cudaEventDestroy(d_epoch_done[b]);
+            d_params_cpu[b] = 0;
+            d_params_gpu[b] = 0;
+            d_corr_out_cpu[b] = 0;
+            d_corr_out_gpu[b] = 0;
+            d_epoch_done[b] = 0;
+            d_n_submitted[b] = 0;
+        }
+    if (d_upload_done != 0) cudaEventDestroy(d_upload_done);
+    if (d_upload_stream != 0) cudaStreamDestroy(d_upload_stream);
+    if (d_compute_stream != 0) cudaStreamDestroy(d_compute_stream);
+    d_ring = 0;
+    d_staging_cpu = 0;
+    d_local_codes = 0;
+    d_shifts_chips = 0;
+    d_upload_done = 0;
+    d_upload_stream = 0;
+    d_compute_stream = 0;
+    d_in_flight = -1;
+    d_channels.clear();
+    return true;
+}
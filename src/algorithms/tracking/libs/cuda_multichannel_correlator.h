@@ -0,0 +1,195 @@
+/*!
+ * \file cuda_multichannel_correlator.h
+ * \brief Carrier wipe-off, code resampling and correlation of many channels
+ *  in a single CUDA kernel launch, over a device-resident input buffer.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * cuda_multicorrelator serves one channel: every epoch it maps the host
+ * input buffer, launches a kernel for a single set of taps and waits for it.
+ * With tens of channels the GPU spends most of the time idle between those
+ * tiny launches, and each channel reads the same input across the bus again.
+ *
+ * This class keeps the input samples in a ring buffer in device memory,
+ * which is filled once with push_samples() regardless of the number of
+ * channels. The channels submit their NCO state against absolute sample
+ * indices of that buffer, and execute_async() correlates all of them in one
+ * kernel launch, with one thread block per channel. Input uploads run on
+ * their own stream, and the channel parameters and results are double
+ * buffered, so the next epoch can be uploaded and prepared while the
+ * current one is being computed.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CUDA_MULTICHANNEL_CORRELATOR_H_
+#define GNSS_SDR_CUDA_MULTICHANNEL_CORRELATOR_H_
+
+#include <complex>
+#include <vector>
+#include <cuda.h>
+#include <cuda_runtime.h>
+#include "cuda_multicorrelator.h"
+
+//! Largest number of correlator taps per channel (Galileo E1 VEML uses 5)
+#define CUDA_MULTICHANNEL_MAX_TAPS 8
+
+//! NCO state of one channel for one epoch, as read by the kernel
+struct cuda_channel_params
+{
+    int channel;
+    int ring_offset;        // position of the first sample in the ring buffer
+    int length_samples;
+    int code_length_chips;
+    int n_correlators;
+    float rem_carrier_phase_in_rad;
+    float phase_step_rad;
+    float rem_code_phase_chips;
+    float code_phase_step_chips;
+};
+
+
+/*!
+ * \brief Batched carrier wipe-off and correlators for many channels on a GPU.
+ *
+ * Usage: init(), add_channel() once per channel, then push_samples() as the
+ * input arrives and, for each epoch, submit() every channel that has a full
+ * integration available and call execute() (or execute_async() followed by
+ * wait()). The results are written to the output vectors given in
+ * add_channel(). The class is not thread-safe.
+ */
+class cuda_multichannel_correlator
+{
+public:
+    cuda_multichannel_correlator();
+    ~cuda_multichannel_correlator();
+
+    /*!
+     * \brief Selects the device and allocates all the device buffers.
+     * \param ring_buffer_samples - input samples kept on the device. Must hold
+     *  the longest integration plus the samples pushed while an epoch runs.
+     * \param max_channels - largest number of channels.
+     * \param max_code_length_chips - longest local code of any channel.
+     * \param device - CUDA device to use, or -1 for the one with most
+     *  multiprocessors.
+     */
+    bool init(int ring_buffer_samples, int max_channels, int max_code_length_chips, int device = -1);
+
+    /*!
+     * \brief Uploads the code and taps of a new channel and returns its
+     * identifier, or -1 if the channel does not fit in the sizes given to init().
+     */
+    int add_channel(int code_length_chips, const std::complex<float>* local_code_in,
+            const float* shifts_chips, int n_correlators, std::complex<float>* corr_out);
+
+    //! Uploads a new local code for a channel, e.g. when a new satellite is assigned
+    bool set_local_code_and_taps(int channel, int code_length_chips,
+            const std::complex<float>* local_code_in, const float* shifts_chips, int n_correlators);
+
+    /*!
+     * \brief Appends samples to the device ring buffer and returns the absolute
+     * index of the first one. The copy runs asynchronously on the upload stream.
+     */
+    unsigned long long push_samples(const std::complex<float>* in, int n_samples);
+
+    //! Leaves n_samples in the ring unwritten, for input that is not available
+    void skip_samples(unsigned long long n_samples)
+    {
+        d_samples_pushed += n_samples;
+    }
+
+    //! Absolute index of the next sample to be pushed
+    unsigned long long samples_pushed() const
+    {
+        return d_samples_pushed;
+    }
+
+    /*!
+     * \brief Queues the correlation of a channel for the next execute(). The
+     * integration starts at absolute sample index first_sample, which must
+     * still be in the ring buffer. The NCO arguments are the same as in
+     * cpu_multicorrelator.
+     */
+    bool submit(int channel, unsigned long long first_sample,
+            float rem_carrier_phase_in_rad, float phase_step_rad,
+            float rem_code_phase_chips, float code_phase_step_chips,
+            int signal_length_samples);
+
+    //! Launches the correlation of all the submitted channels and returns immediately
+    bool execute_async();
+
+    //! Waits for the last execute_async() and copies its results to the channel outputs
+    void wait();
+
+    //! execute_async() followed by wait()
+    void execute();
+
+    //! Number of registered channels
+    int num_channels() const
+    {
+        return static_cast<int>(d_channels.size());
+    }
+
+    bool free_cuda();
+
+private:
+    struct channel_state
+    {
+        std::complex<float>* corr_out;
+        int code_length_chips;
+        int n_correlators;
+    };
+
+    std::vector<channel_state> d_channels;
+    int d_device;
+    int d_max_channels;
+    int d_max_code_length_chips;
+
+    // input ring buffer
+    GPU_Complex* d_ring;
+    std::complex<float>* d_staging_cpu;
+    int d_ring_length;
+    unsigned long long d_samples_pushed;
+
+    // local codes and taps of every channel, at fixed strides
+    GPU_Complex* d_local_codes;
+    float* d_shifts_chips;
+
+    // double-buffered epoch parameters and results
+    cuda_channel_params* d_params_cpu[2];
+    cuda_channel_params* d_params_gpu[2];
+    GPU_Complex* d_corr_out_cpu[2];
+    GPU_Complex* d_corr_out_gpu[2];
+    int d_n_submitted[2];
+    int d_current;          // buffer being filled by submit()
+    int d_in_flight;        // buffer being computed, or -1
+
+    cudaStream_t d_upload_stream;
+    cudaStream_t d_compute_stream;
+    cudaEvent_t d_upload_done;
+    cudaEvent_t d_epoch_done[2];
+    int d_threads_per_block;
+};
+
+#endif /* GNSS_SDR_CUDA_MULTICHANNEL_CORRELATOR_H_ */
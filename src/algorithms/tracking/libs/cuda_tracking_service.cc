@@ -0,0 +1,204 @@
+/*!
+ * \file cuda_tracking_service.cc
+ * \brief Batched GPU correlators shared by all the tracking channels of the
+ *  same input.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "cuda_tracking_service.h"
+#include <glog/logging.h>
+#include <boost/thread/thread_time.hpp>
+
+using google::LogMessage;
+
+
+Cuda_Tracking_Service::Cuda_Tracking_Service(unsigned int ring_samples, unsigned int max_channels,
+        unsigned int max_code_length_chips, unsigned int batch_wait_us) :
+        d_ready(false),
+        d_batch_wait_us(batch_wait_us),
+        d_n_active(0),
+        d_batch(0),
+        d_valid_from(0)
+{
+    if (!d_correlator.init(ring_samples, max_channels, max_code_length_chips))
+        {
+            LOG(ERROR) << "No CUDA device available for the tracking";
+            return;
+        }
+    d_ready = true;
+}
+
+
+int Cuda_Tracking_Service::add_channel(int code_length_chips, const std::complex<float>* code,
+        const float* shifts_chips, int n_correlators, std::complex<float>* corr_out)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    if (!d_ready) return -1;
+    int channel = d_correlator.add_channel(code_length_chips, code, shifts_chips, n_correlators, corr_out);
+    if (channel < 0)
+        {
+            LOG(WARNING) << "No channel left in the CUDA tracking, or the code does not fit";
+            return -1;
+        }
+    d_active.push_back(false);
+    d_result.push_back(false);
+    return channel;
+}
+
+
+bool Cuda_Tracking_Service::set_local_code(int channel, int code_length_chips, const std::complex<float>* code,
+        const float* shifts_chips, int n_correlators)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    if (!d_ready) return false;
+    return d_correlator.set_local_code_and_taps(channel, code_length_chips, code, shifts_chips, n_correlators);
+}
+
+
+void Cuda_Tracking_Service::set_active(int channel, bool active)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    if (channel < 0 || channel >= static_cast<int>(d_active.size()) || d_active[channel] == active) return;
+    d_active[channel] = active;
+    if (active)
+        {
+            d_n_active++;
+        }
+    else
+        {
+            d_n_active--;
+            // the channels already waiting may be all that is left
+            if (!d_submitted.empty() && d_submitted.size() >= d_n_active) run_batch();
+        }
+}
+
+
+void Cuda_Tracking_Service::push(unsigned long long first_sample, const std::complex<float>* in, int n_samples)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    if (!d_ready) return;
+    const unsigned long long pushed = d_correlator.samples_pushed();
+    const unsigned long long last_sample = first_sample + n_samples;
+    if (last_sample <= pushed) return;
+    if (first_sample > pushed)
+        {
+            // the samples in between were consumed before any block pushed
+            // them, e.g. before the first channel started tracking
+            DLOG(INFO) << "CUDA tracking input skipped from sample " << pushed << " to " << first_sample;
+            d_correlator.skip_samples(first_sample - pushed);
+            d_valid_from = first_sample;
+            d_correlator.push_samples(in, n_samples);
+            return;
+        }
+    d_correlator.push_samples(in + (pushed - first_sample), static_cast<int>(last_sample - pushed));
+}
+
+
+bool Cuda_Tracking_Service::correlate(int channel, unsigned long long first_sample,
+        float rem_carrier_phase_in_rad, float phase_step_rad,
+        float rem_code_phase_chips, float code_phase_step_chips,
+        int length_samples)
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    if (!d_ready || channel < 0 || channel >= static_cast<int>(d_result.size())) return false;
+    if (first_sample < d_valid_from) return false;
+    if (!d_correlator.submit(channel, first_sample, rem_carrier_phase_in_rad, phase_step_rad,
+            rem_code_phase_chips, code_phase_step_chips, length_samples))
+        {
+            return false;
+        }
+    d_submitted.push_back(channel);
+    const unsigned long int batch = d_batch;
+    if (d_submitted.size() >= d_n_active)
+        {
+            run_batch();
+        }
+    else
+        {
+            // the last channel to submit, or the first one after the wait, runs the batch
+            const boost::system_time deadline = boost::get_system_time() + boost::posix_time::microseconds(d_batch_wait_us);
+            while (d_batch == batch)
+                {
+                    if (!d_batch_done.timed_wait(lock, deadline))
+                        {
+                            if (d_batch == batch) run_batch();
+                            break;
+                        }
+                }
+        }
+    return d_result[channel];
+}
+
+
+void Cuda_Tracking_Service::run_batch()
+{
+    const bool ok = d_correlator.execute_async();
+    d_correlator.wait();
+    for (unsigned int i = 0; i < d_submitted.size(); i++)
+        {
+            d_result[d_submitted[i]] = ok;
+        }
+    d_submitted.clear();
+    d_batch++;
+    d_batch_done.notify_all();
+}
+
+
+unsigned long int Cuda_Tracking_Service::batches()
+{
+    boost::mutex::scoped_lock lock(d_mutex);
+    return d_batch;
+}
+
+
+const unsigned int Cuda_Tracking_Service_Store::ring_ms;
+const unsigned int Cuda_Tracking_Service_Store::max_channels;
+const unsigned int Cuda_Tracking_Service_Store::max_code_length_chips;
+const unsigned int Cuda_Tracking_Service_Store::batch_wait_us;
+
+
+Cuda_Tracking_Service_Store& Cuda_Tracking_Service_Store::instance()
+{
+    static Cuda_Tracking_Service_Store store;
+    return store;
+}
+
+
+std::shared_ptr<Cuda_Tracking_Service> Cuda_Tracking_Service_Store::get(unsigned int rf_channel, long fs_in)
+{
+    key_type key = std::make_tuple(rf_channel, fs_in);
+    boost::mutex::scoped_lock lock(d_mutex);
+    std::shared_ptr<Cuda_Tracking_Service> service = d_services[key].lock();
+    if (!service)
+        {
+            const unsigned int ring_samples = static_cast<unsigned int>(fs_in / 1000) * ring_ms;
+            service = std::make_shared<Cuda_Tracking_Service>(ring_samples, max_channels,
+                    max_code_length_chips, batch_wait_us);
+            d_services[key] = service;
+        }
+    return service;
+}
@@ -0,0 +1,164 @@
+/*!
+ * \file cuda_tracking_service.h
+ * \brief Batched GPU correlators shared by all the tracking channels of the
+ *  same input.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * As Cuda_Acquisition_Service does for the acquisition, each channel keeps
+ * its own tracking block and loops, and the batching happens underneath.
+ * The channels of an RF channel read the same samples, so each sample is
+ * uploaded once to the ring of a cuda_multichannel_correlator, by the first
+ * channel that reads it. The code periods of the channels do not start at
+ * the same sample, so a batch runs when every active channel has submitted
+ * its period, or when the first one has waited for batch_wait_us.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CUDA_TRACKING_SERVICE_H_
+#define GNSS_SDR_CUDA_TRACKING_SERVICE_H_
+
+#include <complex>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include "cuda_multichannel_correlator.h"
+
+/*!
+ * \brief Thread-safe front end of a cuda_multichannel_correlator for the
+ * tracking blocks of many channels.
+ *
+ * A channel that asks for samples that have already left the ring, or that
+ * cannot be batched, gets false and correlates that period on the CPU.
+ */
+class Cuda_Tracking_Service
+{
+public:
+    Cuda_Tracking_Service(unsigned int ring_samples, unsigned int max_channels,
+            unsigned int max_code_length_chips, unsigned int batch_wait_us);
+
+    //! False if there is no usable CUDA device
+    bool ready() const
+    {
+        return d_ready;
+    }
+
+    /*!
+     * \brief Takes a channel of the correlator for the lifetime of the caller,
+     * and returns it, or -1 if there is none left. The correlator outputs of
+     * every batch are written to corr_out.
+     */
+    int add_channel(int code_length_chips, const std::complex<float>* code,
+            const float* shifts_chips, int n_correlators, std::complex<float>* corr_out);
+
+    //! Replaces the code of a channel, e.g. when a new satellite is assigned
+    bool set_local_code(int channel, int code_length_chips, const std::complex<float>* code,
+            const float* shifts_chips, int n_correlators);
+
+    //! Active channels are waited for by every batch
+    void set_active(int channel, bool active);
+
+    /*!
+     * \brief Uploads the samples of in, that starts at absolute sample
+     * first_sample, that are not in the ring yet. Every block calls it with
+     * all its input before consuming it. If the ring is behind first_sample,
+     * it jumps ahead, and the samples in between can not be correlated.
+     */
+    void push(unsigned long long first_sample, const std::complex<float>* in, int n_samples);
+
+    /*!
+     * \brief Correlates length_samples samples from absolute sample
+     * first_sample in the next batch, and waits for it. The NCO arguments
+     * are the same as in cpu_multicorrelator.
+     */
+    bool correlate(int channel, unsigned long long first_sample,
+            float rem_carrier_phase_in_rad, float phase_step_rad,
+            float rem_code_phase_chips, float code_phase_step_chips,
+            int length_samples);
+
+    //! Number of batches run on the GPU so far
+    unsigned long int batches();
+
+private:
+    Cuda_Tracking_Service(const Cuda_Tracking_Service&);
+    Cuda_Tracking_Service& operator=(const Cuda_Tracking_Service&);
+
+    void run_batch();
+
+    cuda_multichannel_correlator d_correlator;
+    bool d_ready;
+    unsigned int d_batch_wait_us;
+    std::vector<bool> d_active;
+    unsigned int d_n_active;
+    std::vector<int> d_submitted;   // channels of the next batch
+    std::vector<bool> d_result;     // of the last batch of each channel
+    unsigned long int d_batch;      // batches run so far
+    unsigned long long d_valid_from; // first sample after the last gap in the ring
+    boost::mutex d_mutex;
+    boost::condition_variable d_batch_done;
+};
+
+
+/*!
+ * \brief Process-wide store of tracking services keyed by (RF channel, fs).
+ *
+ * As in Cuda_Acquisition_Service_Store, a service is released as soon as
+ * the last tracking block using it is destroyed.
+ */
+class Cuda_Tracking_Service_Store
+{
+public:
+    //! Returns the store shared by the whole process
+    static Cuda_Tracking_Service_Store& instance();
+
+    //! Returns the service for the given input, creating it if no block holds it yet
+    std::shared_ptr<Cuda_Tracking_Service> get(unsigned int rf_channel, long fs_in);
+
+    //! Samples of the ring of every service, in milliseconds of input
+    static const unsigned int ring_ms = 100;
+
+    //! Channels of every service
+    static const unsigned int max_channels = 256;
+
+    //! Longest code of every service, that of Galileo E5a
+    static const unsigned int max_code_length_chips = 10230;
+
+    //! Longest wait of a channel for the others to join its batch
+    static const unsigned int batch_wait_us = 500;
+
+private:
+    Cuda_Tracking_Service_Store() {}
+    Cuda_Tracking_Service_Store(const Cuda_Tracking_Service_Store&);
+    Cuda_Tracking_Service_Store& operator=(const Cuda_Tracking_Service_Store&);
+
+    typedef std::tuple<unsigned int, long> key_type;
+    std::map<key_type, std::weak_ptr<Cuda_Tracking_Service> > d_services;
+    boost::mutex d_mutex;
+};
+
+#endif /* GNSS_SDR_CUDA_TRACKING_SERVICE_H_ */
@@ -0,0 +1,133 @@
+/*!
+ * \file fft_correlation_window.cc
+ * \brief Dense correlation window around the prompt computed with FFTs
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "fft_correlation_window.h"
+#include <algorithm>
+#include <cmath>
+#include <volk/volk.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+#include "fft_planner.h"
+#include "gnss_sdr_memory_accounting.h"
+
+
+Fft_Correlation_Window::Fft_Correlation_Window()
+{
+    d_fft_size = 0;
+    d_signal_length = 0;
+    d_max_lag = 0;
+    d_spectrum = nullptr;
+    d_window = nullptr;
+    d_capacity = 0;
+}
+
+
+Fft_Correlation_Window::~Fft_Correlation_Window()
+{
+    gnss_sdr_volk_gnsssdr_free(d_spectrum);
+    gnss_sdr_volk_gnsssdr_free(d_window);
+}
+
+
+int Fft_Correlation_Window::max_lag_samples(const float* shifts_chips, int n_correlators, float code_phase_step_chips)
+{
+    float max_shift_chips = 0.0;
+    for (int n = 0; n < n_correlators; n++)
+        {
+            max_shift_chips = std::max(max_shift_chips, std::fabs(shifts_chips[n]));
+        }
+    // one more lag for the interpolation
+    return static_cast<int>(std::ceil(max_shift_chips / code_phase_step_chips)) + 1;
+}
+
+
+void Fft_Correlation_Window::reserve(int fft_size)
+{
+    if (fft_size != d_fft_size)
+        {
+            // the planner keeps the plans, so a length seen before is not planned again
+            d_fft = Fft_Planner::instance().acquire(fft_size, true);
+            d_ifft = Fft_Planner::instance().acquire(fft_size, false);
+            d_fft_size = fft_size;
+        }
+    if (fft_size > d_capacity)
+        {
+            gnss_sdr_volk_gnsssdr_free(d_spectrum);
+            gnss_sdr_volk_gnsssdr_free(d_window);
+            d_spectrum = static_cast<std::complex<float>*>(gnss_sdr_volk_gnsssdr_malloc(fft_size * sizeof(std::complex<float>), volk_gnsssdr_get_alignment()));
+            d_window = static_cast<std::complex<float>*>(gnss_sdr_volk_gnsssdr_malloc(fft_size * sizeof(std::complex<float>), volk_gnsssdr_get_alignment()));
+            d_capacity = fft_size;
+        }
+}
+
+
+void Fft_Correlation_Window::set_signal(const std::complex<float>* sig_in, std::complex<float>* phase, std::complex<float> phase_inc,
+        int signal_length_samples, int max_lag_samples)
+{
+    d_signal_length = signal_length_samples;
+    d_max_lag = max_lag_samples;
+    // the replica is 2 max_lag longer than the epoch, zero-padding the epoch
+    // to its length leaves no circular wrap-around in the window
+    reserve(static_cast<int>(Fft_Planner::fast_size(signal_length_samples + 2 * max_lag_samples)));
+
+    std::complex<float>* buf = d_ifft->get_inbuf();
+    volk_32fc_s32fc_x2_rotator_32fc(buf, sig_in, phase_inc, phase, signal_length_samples);
+    std::fill(buf + signal_length_samples, buf + d_fft_size, std::complex<float>(0.0, 0.0));
+    // the backward transform of x is the conjugate of the forward one of conj(x)
+    d_ifft->execute();
+    std::copy(d_ifft->get_outbuf(), d_ifft->get_outbuf() + d_fft_size, d_spectrum);
+}
+
+
+void Fft_Correlation_Window::correlate(std::complex<float>* corr_out, const std::complex<float>* local_code, int code_length_chips,
+        float rem_code_phase_chips, float code_phase_step_chips, const float* shifts_chips, int n_correlators)
+{
+    // replica from max_lag samples before the epoch to max_lag samples after it
+    std::complex<float>* replica = d_fft->get_inbuf();
+    float first_shift_chips = - d_max_lag * code_phase_step_chips;
+    volk_gnsssdr_32fc_xn_resampler_32fc_xn(&replica, local_code, rem_code_phase_chips, code_phase_step_chips,
+            &first_shift_chips, code_length_chips, 1, d_signal_length + 2 * d_max_lag);
+    std::fill(replica + d_signal_length + 2 * d_max_lag, replica + d_fft_size, std::complex<float>(0.0, 0.0));
+    d_fft->execute();
+
+    // sum_n x[n] c[n + m] at index m, the lag m - max_lag
+    volk_32fc_x2_multiply_32fc(d_ifft->get_inbuf(), d_spectrum, d_fft->get_outbuf(), d_fft_size);
+    d_ifft->execute();
+    const float scale = 1.0 / static_cast<float>(d_fft_size);
+    volk_32fc_s32fc_multiply_32fc(d_window, d_ifft->get_outbuf(), std::complex<float>(scale, 0.0), 2 * d_max_lag + 1);
+
+    for (int n = 0; n < n_correlators; n++)
+        {
+            float lag = shifts_chips[n] / code_phase_step_chips + static_cast<float>(d_max_lag);
+            lag = std::min(std::max(lag, 0.0f), static_cast<float>(2 * d_max_lag));
+            int below = std::min(static_cast<int>(std::floor(lag)), 2 * d_max_lag - 1);
+            float fraction = lag - static_cast<float>(below);
+            corr_out[n] = d_window[below] * (1.0f - fraction) + d_window[below + 1] * fraction;
+        }
+}
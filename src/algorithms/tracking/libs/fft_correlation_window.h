@@ -0,0 +1,100 @@
+/*!
+ * \file fft_correlation_window.h
+ * \brief Dense correlation window around the prompt computed with FFTs
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Signal quality monitoring (multipath, spoofing) looks at the shape of
+ * the correlation peak with tens of taps. Resampling a replica and taking
+ * a dot product per tap costs N x taps per epoch, while the correlation at
+ * every sample lag of the window costs three FFTs of about N points: the
+ * carrier wiped-off epoch, the replica extended by the window on both
+ * sides, and the inverse transform of their product.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_FFT_CORRELATION_WINDOW_H_
+#define GNSS_SDR_FFT_CORRELATION_WINDOW_H_
+
+#include <complex>
+#include <memory>
+#include <gnuradio/fft/fft.h>
+
+/*!
+ * \brief Correlates one epoch with code replicas at every sample lag of
+ * [-max_lag, max_lag] around the prompt.
+ *
+ * The taps asked for are interpolated linearly between the two nearest
+ * sample lags, which is exact for taps on the sample grid.
+ */
+class Fft_Correlation_Window
+{
+public:
+    Fft_Correlation_Window();
+    ~Fft_Correlation_Window();
+
+    //! Sample lags that hold the taps at \p shifts_chips
+    static int max_lag_samples(const float* shifts_chips, int n_correlators, float code_phase_step_chips);
+
+    /*!
+     * \brief Wipes off the carrier of \p signal_length_samples samples, with
+     * \p phase at the first one and \p phase_inc per sample, and transforms
+     * them for the lags up to \p max_lag_samples. \p phase is advanced.
+     */
+    void set_signal(const std::complex<float>* sig_in, std::complex<float>* phase, std::complex<float> phase_inc,
+            int signal_length_samples, int max_lag_samples);
+
+    /*!
+     * \brief Correlations of the signal with \p local_code shifted by
+     * \p shifts_chips, same arguments as the resampler kernels
+     */
+    void correlate(std::complex<float>* corr_out, const std::complex<float>* local_code, int code_length_chips,
+            float rem_code_phase_chips, float code_phase_step_chips, const float* shifts_chips, int n_correlators);
+
+    //! Correlation at the sample lags -max_lag()..max_lag() of the last correlate()
+    const std::complex<float>* window() const
+    {
+        return d_window;
+    }
+
+    int max_lag() const
+    {
+        return d_max_lag;
+    }
+
+private:
+    void reserve(int fft_size);
+
+    std::shared_ptr<gr::fft::fft_complex> d_fft;
+    std::shared_ptr<gr::fft::fft_complex> d_ifft;
+    int d_fft_size;
+    int d_signal_length;
+    int d_max_lag;
+    std::complex<float>* d_spectrum;  // backward transform of the wiped-off epoch
+    std::complex<float>* d_window;
+    int d_capacity;
+};
+
+#endif /* GNSS_SDR_FFT_CORRELATION_WINDOW_H_ */
@@ -110,3 +110,151 @@ float carrier_lock_detector(gr_complex* Prompt_buffer, int length)
     NBD = tmp_sum_I*tmp_sum_I - tmp_sum_Q*tmp_sum_Q;
     return NBD/NBP;
 }
+
+
+
+Sliding_Lock_Detector::Sliding_Lock_Detector(int length)
+{
+    set_length(length);
+}
+
+
+
+Sliding_Lock_Detector::Sliding_Lock_Detector()
+{
+    set_length(1);
+}
+
+
+
+Sliding_Lock_Detector::~Sliding_Lock_Detector()
+{}
+
+
+
+void Sliding_Lock_Detector::set_length(int length)
+{
+    d_length = (length > 0) ? length : 1;
+    d_window.assign(d_length, gr_complex(0.0, 0.0));
+    reset();
+}
+
+
+
+void Sliding_Lock_Detector::reset()
+{
+    d_index = 0;
+    d_count = 0;
+    d_sum_abs_I = 0;
+    d_sum_power = 0;
+    d_sum_I = 0;
+    d_sum_Q = 0;
+}
+
+
+
+void Sliding_Lock_Detector::recompute_sums()
+{
+    double sum_abs_I = 0;
+    double sum_power = 0;
+    double sum_I = 0;
+    double sum_Q = 0;
+    for (int i = 0; i < d_count; i++)
+        {
+            double I = static_cast<double>(d_window[i].real());
+            double Q = static_cast<double>(d_window[i].imag());
+            sum_abs_I += std::abs(I);
+            sum_power += I * I + Q * Q;
+            sum_I += I;
+            sum_Q += Q;
+        }
+    d_sum_abs_I = sum_abs_I;
+    d_sum_power = sum_power;
+    d_sum_I = sum_I;
+    d_sum_Q = sum_Q;
+}
+
+
+
+void Sliding_Lock_Detector::update(const gr_complex& prompt)
+{
+    double I = static_cast<double>(prompt.real());
+    double Q = static_cast<double>(prompt.imag());
+    if (d_count == d_length)
+        {
+            double old_I = static_cast<double>(d_window[d_index].real());
+            double old_Q = static_cast<double>(d_window[d_index].imag());
+            d_sum_abs_I -= std::abs(old_I);
+            d_sum_power -= old_I * old_I + old_Q * old_Q;
+            d_sum_I -= old_I;
+            d_sum_Q -= old_Q;
+        }
+    else
+        {
+            d_count++;
+        }
+    d_window[d_index] = prompt;
+    d_sum_abs_I += std::abs(I);
+    d_sum_power += I * I + Q * Q;
+    d_sum_I += I;
+    d_sum_Q += Q;
+    d_index++;
+    if (d_index == d_length)
+        {
+            d_index = 0;
+            // bound the accumulated rounding error of the running sums
+            recompute_sums();
+        }
+}
+
+
+
+void Sliding_Lock_Detector::update(const gr_complex* prompts, int n)
+{
+    if (n >= d_length)
+        {
+            // only the last d_length values stay in the window
+            for (int i = 0; i < d_length; i++)
+                {
+                    d_window[i] = prompts[n - d_length + i];
+                }
+            d_index = 0;
+            d_count = d_length;
+            recompute_sums();
+        }
+    else
+        {
+            for (int i = 0; i < n; i++)
+                {
+                    update(prompts[i]);
+                }
+        }
+}
+
+
+
+bool Sliding_Lock_Detector::is_full() const
+{
+    return d_count == d_length;
+}
+
+
+
+float Sliding_Lock_Detector::cn0_svn_estimator(long fs_in, double code_length) const
+{
+    double Psig = d_sum_abs_I / static_cast<double>(d_count);
+    Psig = Psig * Psig;
+    double Ptot = d_sum_power / static_cast<double>(d_count);
+    double SNR = Psig / (Ptot - Psig);
+    double SNR_dB_Hz = 10 * log10(SNR) + 10 * log10(static_cast<double>(fs_in)/2) - 10 * log10(code_length);
+    return static_cast<float>(SNR_dB_Hz);
+}
+
+
+
+float Sliding_Lock_Detector::carrier_lock_detector() const
+{
+    double NBP = d_sum_I * d_sum_I + d_sum_Q * d_sum_Q;
+    double NBD = d_sum_I * d_sum_I - d_sum_Q * d_sum_Q;
+    return static_cast<float>(NBD / NBP);
+}
@@ -48,6 +48,7 @@
 #ifndef GNSS_SDR_LOCK_DETECTORS_H_
 #define GNSS_SDR_LOCK_DETECTORS_H_
 
+#include <vector>
 #include <gnuradio/gr_complex.h>
 
 
@@ -92,4 +93,44 @@ float cn0_svn_estimator(gr_complex* Prompt_buffer, int length, long fs_in, doubl
  */
 float carrier_lock_detector(gr_complex* Prompt_buffer, int length);
 
+
+
+/*! \brief Sliding-window version of cn0_svn_estimator and carrier_lock_detector
+ *
+ * Keeps the last N prompt correlator outputs in a ring buffer together with the
+ * running sums used by both estimators, so that pushing a new prompt value costs
+ * O(1) and both detectors can be evaluated at every integration period instead of
+ * once every N periods. The sums are recomputed from the window each time the ring
+ * wraps around, so the rounding error of the add/subtract updates does not grow
+ * with the tracking time. Once the window is full, the outputs are the same as
+ * the batch functions applied to the last N prompt values.
+ */
+class Sliding_Lock_Detector
+{
+private:
+    std::vector<gr_complex> d_window;
+    int d_length;
+    int d_index;    // position of the next (and oldest) value
+    int d_count;    // values in the window, up to d_length
+
+    double d_sum_abs_I;
+    double d_sum_power;
+    double d_sum_I;
+    double d_sum_Q;
+
+    void recompute_sums();
+
+public:
+    void set_length(int length); //! Set the window length N and reset the detector
+    void reset();                //! Discard all the stored prompt values
+    void update(const gr_complex& prompt);              //! Push one prompt value
+    void update(const gr_complex* prompts, int n);      //! Push n prompt values
+    bool is_full() const;        //! True once N values have been pushed since the last reset
+    float cn0_svn_estimator(long fs_in, double code_length) const;
+    float carrier_lock_detector() const;
+    Sliding_Lock_Detector(int length);
+    Sliding_Lock_Detector();
+    ~Sliding_Lock_Detector();
+};
+
 #endif
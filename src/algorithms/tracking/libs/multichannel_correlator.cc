@@ -0,0 +1,218 @@
+/*!
+ * \file multichannel_correlator.cc
+ * \brief Carrier wipe-off, code resampling and correlation of several
+ *  channels in a single, cache-blocked sweep.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "multichannel_correlator.h"
+#include "gnss_sdr_trace.h"
+#include "gnss_sdr_memory_accounting.h"
+#include <algorithm>
+#include <cmath>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+
+
+multichannel_correlator::multichannel_correlator()
+{
+    d_local_codes_resampled = nullptr;
+    d_block_corr = nullptr;
+    d_max_correlators = 0;
+    d_block_length = 0;
+}
+
+
+multichannel_correlator::~multichannel_correlator()
+{
+    if(d_local_codes_resampled != nullptr)
+        {
+            multichannel_correlator::free();
+        }
+}
+
+
+bool multichannel_correlator::init(int max_correlators, int block_length_samples)
+{
+    if (max_correlators <= 0 || block_length_samples <= 0)
+        {
+            return false;
+        }
+    if(d_local_codes_resampled != nullptr)
+        {
+            free();
+        }
+    size_t size = block_length_samples * sizeof(std::complex<float>);
+    d_local_codes_resampled = static_cast<std::complex<float>**>(gnss_sdr_volk_gnsssdr_malloc(max_correlators * sizeof(std::complex<float>*), volk_gnsssdr_get_alignment()));
+    for (int n = 0; n < max_correlators; n++)
+        {
+            d_local_codes_resampled[n] = static_cast<std::complex<float>*>(gnss_sdr_volk_gnsssdr_malloc(size, volk_gnsssdr_get_alignment()));
+        }
+    d_block_corr = static_cast<std::complex<float>*>(gnss_sdr_volk_gnsssdr_malloc(max_correlators * sizeof(std::complex<float>), volk_gnsssdr_get_alignment()));
+    d_max_correlators = max_correlators;
+    d_block_length = block_length_samples;
+    return true;
+}
+
+
+int multichannel_correlator::add_channel(int code_length_chips,
+        const std::complex<float>* local_code_in,
+        const float* shifts_chips,
+        int n_correlators,
+        std::complex<float>* corr_out)
+{
+    if (n_correlators <= 0 || n_correlators > d_max_correlators)
+        {
+            return -1;
+        }
+    channel_state ch;
+    ch.local_code_in = local_code_in;
+    ch.shifts_chips = shifts_chips;
+    ch.corr_out = corr_out;
+    ch.code_length_chips = code_length_chips;
+    ch.n_correlators = n_correlators;
+    ch.sig_in = nullptr;
+    ch.phase = std::complex<float>(1.0, 0.0);
+    ch.phase_inc = std::complex<float>(1.0, 0.0);
+    ch.rem_code_phase_chips = 0.0;
+    ch.code_phase_step_chips = 0.0;
+    ch.signal_length_samples = 0;
+    ch.pending = false;
+    d_channels.push_back(ch);
+    return static_cast<int>(d_channels.size()) - 1;
+}
+
+
+bool multichannel_correlator::set_local_code_and_taps(int channel,
+        int code_length_chips,
+        const std::complex<float>* local_code_in,
+        const float* shifts_chips)
+{
+    if (channel < 0 || channel >= num_channels())
+        {
+            return false;
+        }
+    d_channels[channel].local_code_in = local_code_in;
+    d_channels[channel].shifts_chips = shifts_chips;
+    d_channels[channel].code_length_chips = code_length_chips;
+    return true;
+}
+
+
+bool multichannel_correlator::submit(int channel,
+        const std::complex<float>* sig_in,
+        float rem_carrier_phase_in_rad,
+        float phase_step_rad,
+        float rem_code_phase_chips,
+        float code_phase_step_chips,
+        int signal_length_samples)
+{
+    if (channel < 0 || channel >= num_channels() || signal_length_samples <= 0)
+        {
+            return false;
+        }
+    channel_state& ch = d_channels[channel];
+    ch.sig_in = sig_in;
+    // Regenerate phase at each integration in order to avoid numerical issues
+    ch.phase = lv_cmake(std::cos(rem_carrier_phase_in_rad), -std::sin(rem_carrier_phase_in_rad));
+    ch.phase_inc = std::exp(lv_32fc_t(0, - phase_step_rad));
+    ch.rem_code_phase_chips = rem_code_phase_chips;
+    ch.code_phase_step_chips = code_phase_step_chips;
+    ch.signal_length_samples = signal_length_samples;
+    ch.pending = true;
+    for (int n = 0; n < ch.n_correlators; n++)
+        {
+            ch.corr_out[n] = std::complex<float>(0.0, 0.0);
+        }
+    return true;
+}
+
+
+void multichannel_correlator::execute()
+{
+    GNSS_SDR_TRACE_SCOPE("multichannel_correlator::execute");
+    int max_length = 0;
+    for (const channel_state& ch : d_channels)
+        {
+            if (ch.pending) max_length = std::max(max_length, ch.signal_length_samples);
+        }
+
+    for (int start = 0; start < max_length; start += d_block_length)
+        {
+            for (channel_state& ch : d_channels)
+                {
+                    if (!ch.pending || start >= ch.signal_length_samples) continue;
+                    int length = std::min(d_block_length, ch.signal_length_samples - start);
+
+                    // The resampler subtracts the remnant code phase: a block
+                    // starting start samples later is that many steps behind it
+                    float rem_code_phase_chips = static_cast<float>(static_cast<double>(ch.rem_code_phase_chips)
+                            - static_cast<double>(start) * static_cast<double>(ch.code_phase_step_chips));
+                    volk_gnsssdr_32fc_xn_resampler_32fc_xn(d_local_codes_resampled,
+                            ch.local_code_in,
+                            rem_code_phase_chips,
+                            ch.code_phase_step_chips,
+                            const_cast<float*>(ch.shifts_chips),
+                            ch.code_length_chips,
+                            ch.n_correlators,
+                            length);
+
+                    // The kernel advances ch.phase, so the next block continues the carrier
+                    volk_gnsssdr_32fc_x2_rotator_dot_prod_32fc_xn(d_block_corr, ch.sig_in + start,
+                            ch.phase_inc, &ch.phase,
+                            (const lv_32fc_t**)d_local_codes_resampled, ch.n_correlators, length);
+                    for (int n = 0; n < ch.n_correlators; n++)
+                        {
+                            ch.corr_out[n] += d_block_corr[n];
+                        }
+                }
+        }
+
+    for (channel_state& ch : d_channels)
+        {
+            ch.pending = false;
+        }
+}
+
+
+bool multichannel_correlator::free()
+{
+    if (d_local_codes_resampled != nullptr)
+        {
+            for (int n = 0; n < d_max_correlators; n++)
+                {
+                    gnss_sdr_volk_gnsssdr_free(d_local_codes_resampled[n]);
+                }
+            gnss_sdr_volk_gnsssdr_free(d_local_codes_resampled);
+            d_local_codes_resampled = nullptr;
+        }
+    if (d_block_corr != nullptr)
+        {
+            gnss_sdr_volk_gnsssdr_free(d_block_corr);
+            d_block_corr = nullptr;
+        }
+    return true;
+}
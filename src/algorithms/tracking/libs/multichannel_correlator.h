@@ -0,0 +1,127 @@
+/*!
+ * \file multichannel_correlator.h
+ * \brief Carrier wipe-off, code resampling and correlation of several
+ *  channels in a single, cache-blocked sweep.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * A cpu_multicorrelator processes one channel at a time: it resamples the
+ * whole local code into buffers of signal length and then streams those
+ * buffers and the input through the dot products. With many channels, each
+ * of them brings its own replicas and its own copy of the input through the
+ * cache. This class registers the channels once and, on each execute(),
+ * walks the input in short blocks, running all the pending channels on each
+ * block before moving to the next one, so that the replicas never outgrow
+ * the block and the input samples are reused while they are still cached.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MULTICHANNEL_CORRELATOR_H_
+#define GNSS_SDR_MULTICHANNEL_CORRELATOR_H_
+
+#include <complex>
+#include <vector>
+
+/*!
+ * \brief Batched carrier wipe-off and correlators for several channels.
+ *
+ * Usage: init(), add_channel() once per channel, then, for each integration,
+ * submit() the NCO state of every channel that has data and call execute().
+ * The results are written to the output vectors given in add_channel(), as
+ * cpu_multicorrelator::Carrier_wipeoff_multicorrelator_resampler would do.
+ * The class is not thread-safe: all channels must be driven by the same thread.
+ */
+class multichannel_correlator
+{
+public:
+    multichannel_correlator();
+    ~multichannel_correlator();
+
+    /*!
+     * \brief Allocates the internal replica buffers.
+     * \param max_correlators - largest number of correlators of any channel.
+     * \param block_length_samples - samples processed per channel before
+     *  switching to the next one. Should keep max_correlators replicas of this
+     *  length, plus the input block, within the L1/L2 cache.
+     */
+    bool init(int max_correlators, int block_length_samples = 1024);
+
+    /*!
+     * \brief Registers a channel and returns its identifier, or -1 if
+     * n_correlators exceeds the value given to init().
+     */
+    int add_channel(int code_length_chips, const std::complex<float>* local_code_in,
+            const float* shifts_chips, int n_correlators, std::complex<float>* corr_out);
+
+    //! Updates the local code of a channel, e.g. when a new satellite is assigned
+    bool set_local_code_and_taps(int channel, int code_length_chips,
+            const std::complex<float>* local_code_in, const float* shifts_chips);
+
+    /*!
+     * \brief Queues the correlation of a channel for the next execute(). The
+     * arguments are the same as in cpu_multicorrelator.
+     */
+    bool submit(int channel, const std::complex<float>* sig_in,
+            float rem_carrier_phase_in_rad, float phase_step_rad,
+            float rem_code_phase_chips, float code_phase_step_chips,
+            int signal_length_samples);
+
+    //! Correlates all the submitted channels and clears the queue
+    void execute();
+
+    //! Number of registered channels
+    int num_channels() const
+    {
+        return static_cast<int>(d_channels.size());
+    }
+
+    bool free();
+
+private:
+    struct channel_state
+    {
+        const std::complex<float>* local_code_in;
+        const float* shifts_chips;
+        std::complex<float>* corr_out;
+        int code_length_chips;
+        int n_correlators;
+        // NCO state of the pending integration
+        const std::complex<float>* sig_in;
+        std::complex<float> phase;
+        std::complex<float> phase_inc;
+        float rem_code_phase_chips;
+        float code_phase_step_chips;
+        int signal_length_samples;
+        bool pending;
+    };
+
+    std::vector<channel_state> d_channels;
+    std::complex<float>** d_local_codes_resampled;
+    std::complex<float>* d_block_corr;
+    int d_max_correlators;
+    int d_block_length;
+};
+
+#endif /* GNSS_SDR_MULTICHANNEL_CORRELATOR_H_ */
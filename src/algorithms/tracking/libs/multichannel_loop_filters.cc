@@ -0,0 +1,295 @@
+/*!
+ * \file multichannel_loop_filters.cc
+ * \brief Discriminators and 2nd order DLL/PLL filters of several channels,
+ *  evaluated in a single vectorized pass.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "multichannel_loop_filters.h"
+#include "gnss_sdr_memory_accounting.h"
+#include <cmath>
+#include <volk/volk.h>
+
+namespace
+{
+const float TWO_PI_F = 6.283185307179586f;
+const float PI_F = 3.141592653589793f;
+const float HALF_PI_F = 1.570796326794897f;
+
+// Same design as Tracking_2nd_DLL_filter and Tracking_2nd_PLL_filter
+void calculate_loop_coef(float* tau1, float* tau2, float lbw, float zeta, float k)
+{
+    // Solve natural frequency
+    float Wn;
+    Wn = lbw * 8 * zeta / (4 * zeta * zeta + 1);
+    // solve for t1 & t2
+    *tau1 = k / (Wn * Wn);
+    *tau2 = (2.0 * zeta) / Wn;
+}
+
+template<typename T>
+T* alloc_array(int n)
+{
+    return static_cast<T*>(gnss_sdr_volk_malloc(n * sizeof(T), volk_get_alignment()));
+}
+}
+
+
+multichannel_loop_filters::multichannel_loop_filters()
+{
+    d_max_channels = 0;
+    d_n_channels = 0;
+    d_corr_in = nullptr;
+    d_early_idx = nullptr;
+    d_prompt_idx = nullptr;
+    d_late_idx = nullptr;
+    d_early = nullptr;
+    d_prompt = nullptr;
+    d_late = nullptr;
+    d_early_mag = nullptr;
+    d_late_mag = nullptr;
+    d_pdi = nullptr;
+    d_pll_bw = nullptr;
+    d_dll_bw = nullptr;
+    d_carr_k1 = nullptr;
+    d_carr_k2 = nullptr;
+    d_code_k1 = nullptr;
+    d_code_k2 = nullptr;
+    d_carr_error = nullptr;
+    d_carr_nco = nullptr;
+    d_code_error = nullptr;
+    d_code_nco = nullptr;
+    d_old_carr_error = nullptr;
+    d_old_code_error = nullptr;
+}
+
+
+multichannel_loop_filters::~multichannel_loop_filters()
+{
+    if(d_corr_in != nullptr)
+        {
+            multichannel_loop_filters::free();
+        }
+}
+
+
+bool multichannel_loop_filters::init(int max_channels)
+{
+    if (max_channels <= 0)
+        {
+            return false;
+        }
+    if(d_corr_in != nullptr)
+        {
+            free();
+        }
+    d_corr_in = alloc_array<const std::complex<float>*>(max_channels);
+    d_early_idx = alloc_array<int>(max_channels);
+    d_prompt_idx = alloc_array<int>(max_channels);
+    d_late_idx = alloc_array<int>(max_channels);
+    d_early = alloc_array<std::complex<float>>(max_channels);
+    d_prompt = alloc_array<std::complex<float>>(max_channels);
+    d_late = alloc_array<std::complex<float>>(max_channels);
+    d_early_mag = alloc_array<float>(max_channels);
+    d_late_mag = alloc_array<float>(max_channels);
+    d_pdi = alloc_array<float>(max_channels);
+    d_pll_bw = alloc_array<float>(max_channels);
+    d_dll_bw = alloc_array<float>(max_channels);
+    d_carr_k1 = alloc_array<float>(max_channels);
+    d_carr_k2 = alloc_array<float>(max_channels);
+    d_code_k1 = alloc_array<float>(max_channels);
+    d_code_k2 = alloc_array<float>(max_channels);
+    d_carr_error = alloc_array<float>(max_channels);
+    d_carr_nco = alloc_array<float>(max_channels);
+    d_code_error = alloc_array<float>(max_channels);
+    d_code_nco = alloc_array<float>(max_channels);
+    d_old_carr_error = alloc_array<float>(max_channels);
+    d_old_code_error = alloc_array<float>(max_channels);
+    d_max_channels = max_channels;
+    d_n_channels = 0;
+    return true;
+}
+
+
+int multichannel_loop_filters::add_channel(const std::complex<float>* corr_in, int early, int prompt, int late, float pdi)
+{
+    if (d_n_channels >= d_max_channels)
+        {
+            return -1;
+        }
+    int channel = d_n_channels++;
+    d_corr_in[channel] = corr_in;
+    d_early_idx[channel] = early;
+    d_prompt_idx[channel] = prompt;
+    d_late_idx[channel] = late;
+    d_pdi[channel] = pdi;
+    d_pll_bw[channel] = 50.0;
+    d_dll_bw[channel] = 2.0;
+    d_carr_error[channel] = 0.0;
+    d_code_error[channel] = 0.0;
+    update_coefficients(channel);
+    initialize(channel);
+    return channel;
+}
+
+
+void multichannel_loop_filters::update_coefficients(int channel)
+{
+    // Both scalar filters use a damping ratio of 0.7, and gains of 0.25 (PLL) and 1.0 (DLL)
+    float tau1, tau2;
+    calculate_loop_coef(&tau1, &tau2, d_pll_bw[channel], 0.7, 0.25);
+    d_carr_k1[channel] = tau2 / tau1;
+    d_carr_k2[channel] = d_pdi[channel] / (2 * tau1);
+    calculate_loop_coef(&tau1, &tau2, d_dll_bw[channel], 0.7, 1.0);
+    d_code_k1[channel] = tau2 / tau1;
+    d_code_k2[channel] = d_pdi[channel] / (2 * tau1);
+}
+
+
+void multichannel_loop_filters::set_pll_bw(int channel, float pll_bw_hz)
+{
+    if (channel < 0 || channel >= d_n_channels) return;
+    d_pll_bw[channel] = pll_bw_hz;
+    update_coefficients(channel);
+}
+
+
+void multichannel_loop_filters::set_dll_bw(int channel, float dll_bw_hz)
+{
+    if (channel < 0 || channel >= d_n_channels) return;
+    d_dll_bw[channel] = dll_bw_hz;
+    update_coefficients(channel);
+}
+
+
+void multichannel_loop_filters::set_pdi(int channel, float pdi)
+{
+    if (channel < 0 || channel >= d_n_channels) return;
+    d_pdi[channel] = pdi;
+    update_coefficients(channel);
+}
+
+
+void multichannel_loop_filters::initialize(int channel)
+{
+    if (channel < 0 || channel >= d_n_channels) return;
+    d_carr_nco[channel] = 0.0;
+    d_old_carr_error[channel] = 0.0;
+    d_code_nco[channel] = 0.0;
+    d_old_code_error[channel] = 0.0;
+}
+
+
+void multichannel_loop_filters::execute(const unsigned char* active)
+{
+    const int n = d_n_channels;
+    if (n == 0) return;
+
+    for (int i = 0; i < n; i++)
+        {
+            d_early[i] = d_corr_in[i][d_early_idx[i]];
+            d_prompt[i] = d_corr_in[i][d_prompt_idx[i]];
+            d_late[i] = d_corr_in[i][d_late_idx[i]];
+        }
+
+    // Four quadrant arctangent and envelopes of all the channels at once
+    volk_32fc_s32f_atan2_32f(d_carr_error, d_prompt, 1.0, n);
+    volk_32fc_magnitude_32f(d_early_mag, d_early, n);
+    volk_32fc_magnitude_32f(d_late_mag, d_late, n);
+
+    for (int i = 0; i < n; i++)
+        {
+            // Fold ATAN2(Q, I) into ATAN(Q / I), and convert it to cycles
+            float phi = d_carr_error[i];
+            phi = phi > HALF_PI_F ? phi - PI_F : phi;
+            phi = phi < -HALF_PI_F ? phi + PI_F : phi;
+            d_carr_error[i] = d_prompt[i].real() != 0.0f ? phi / TWO_PI_F : 0.0f;
+
+            float sum = d_early_mag[i] + d_late_mag[i];
+            d_code_error[i] = sum != 0.0f ? 0.5f * (d_early_mag[i] - d_late_mag[i]) / sum : 0.0f;
+        }
+
+    if (active == nullptr)
+        {
+            for (int i = 0; i < n; i++)
+                {
+                    d_carr_nco[i] += d_carr_k1[i] * (d_carr_error[i] - d_old_carr_error[i]) + d_carr_k2[i] * (d_carr_error[i] + d_old_carr_error[i]);
+                    d_old_carr_error[i] = d_carr_error[i];
+                    d_code_nco[i] += d_code_k1[i] * (d_code_error[i] - d_old_code_error[i]) + d_code_k2[i] * (d_code_error[i] + d_old_code_error[i]);
+                    d_old_code_error[i] = d_code_error[i];
+                }
+        }
+    else
+        {
+            // Inactive channels keep their state; selects instead of branches keep the loop vectorizable
+            for (int i = 0; i < n; i++)
+                {
+                    float carr_nco = d_carr_nco[i] + d_carr_k1[i] * (d_carr_error[i] - d_old_carr_error[i]) + d_carr_k2[i] * (d_carr_error[i] + d_old_carr_error[i]);
+                    float code_nco = d_code_nco[i] + d_code_k1[i] * (d_code_error[i] - d_old_code_error[i]) + d_code_k2[i] * (d_code_error[i] + d_old_code_error[i]);
+                    bool on = active[i] != 0;
+                    d_carr_nco[i] = on ? carr_nco : d_carr_nco[i];
+                    d_old_carr_error[i] = on ? d_carr_error[i] : d_old_carr_error[i];
+                    d_code_nco[i] = on ? code_nco : d_code_nco[i];
+                    d_old_code_error[i] = on ? d_code_error[i] : d_old_code_error[i];
+                }
+        }
+}
+
+
+bool multichannel_loop_filters::free()
+{
+    if (d_corr_in == nullptr)
+        {
+            return true;
+        }
+    gnss_sdr_volk_free(d_corr_in);
+    gnss_sdr_volk_free(d_early_idx);
+    gnss_sdr_volk_free(d_prompt_idx);
+    gnss_sdr_volk_free(d_late_idx);
+    gnss_sdr_volk_free(d_early);
+    gnss_sdr_volk_free(d_prompt);
+    gnss_sdr_volk_free(d_late);
+    gnss_sdr_volk_free(d_early_mag);
+    gnss_sdr_volk_free(d_late_mag);
+    gnss_sdr_volk_free(d_pdi);
+    gnss_sdr_volk_free(d_pll_bw);
+    gnss_sdr_volk_free(d_dll_bw);
+    gnss_sdr_volk_free(d_carr_k1);
+    gnss_sdr_volk_free(d_carr_k2);
+    gnss_sdr_volk_free(d_code_k1);
+    gnss_sdr_volk_free(d_code_k2);
+    gnss_sdr_volk_free(d_carr_error);
+    gnss_sdr_volk_free(d_carr_nco);
+    gnss_sdr_volk_free(d_code_error);
+    gnss_sdr_volk_free(d_code_nco);
+    gnss_sdr_volk_free(d_old_carr_error);
+    gnss_sdr_volk_free(d_old_code_error);
+    d_corr_in = nullptr;
+    d_max_channels = 0;
+    d_n_channels = 0;
+    return true;
+}
@@ -0,0 +1,144 @@
+/*!
+ * \file multichannel_loop_filters.h
+ * \brief Discriminators and 2nd order DLL/PLL filters of several channels,
+ *  evaluated in a single vectorized pass.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Each tracking block calls dll_nc_e_minus_l_normalized,
+ * pll_cloop_two_quadrant_atan and its own Tracking_2nd_DLL_filter and
+ * Tracking_2nd_PLL_filter objects once per integration, with the loop state
+ * scattered across the channel objects. This class keeps the state of all
+ * the channels of a multichannel_correlator in contiguous arrays
+ * (structure of arrays), and on each execute() computes the arctangents and
+ * the envelopes of all the channels with VOLK kernels, then runs the filter
+ * recursions over those arrays in plain loops that the compiler vectorizes.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MULTICHANNEL_LOOP_FILTERS_H_
+#define GNSS_SDR_MULTICHANNEL_LOOP_FILTERS_H_
+
+#include <complex>
+
+/*!
+ * \brief Batched Costas PLL and noncoherent DLL of several channels.
+ *
+ * Usage: init(), add_channel() once per channel with the correlator outputs
+ * of that channel (e.g. the vector given to multichannel_correlator::add_channel),
+ * set_pll_bw(), set_dll_bw() and initialize() it, then call execute() after
+ * every multichannel_correlator::execute(). For each channel flagged in
+ * execute(), the discriminators and the filters give the same results as
+ * pll_cloop_two_quadrant_atan() / GPS_TWO_PI, Tracking_2nd_PLL_filter,
+ * dll_nc_e_minus_l_normalized() and Tracking_2nd_DLL_filter.
+ * The class is not thread-safe: all channels must be driven by the same thread.
+ */
+class multichannel_loop_filters
+{
+public:
+    multichannel_loop_filters();
+    ~multichannel_loop_filters();
+
+    //! Allocates the state arrays for up to max_channels channels
+    bool init(int max_channels);
+
+    /*!
+     * \brief Registers a channel and returns its identifier, or -1 if there is
+     * no room left.
+     * \param corr_in - correlator outputs of the channel.
+     * \param early, prompt, late - positions of the Early, Prompt and Late
+     *  outputs in corr_in.
+     * \param pdi - integration time of both loops [s].
+     */
+    int add_channel(const std::complex<float>* corr_in, int early, int prompt, int late, float pdi = 0.001);
+
+    void set_pll_bw(int channel, float pll_bw_hz);  //! Set PLL loop bandwidth [Hz]
+    void set_dll_bw(int channel, float dll_bw_hz);  //! Set DLL loop bandwidth [Hz]
+    void set_pdi(int channel, float pdi);           //! Set summation interval of both loops [s]
+    void initialize(int channel);                   //! Clear the filter memories, e.g. on a new satellite
+
+    /*!
+     * \brief Runs the discriminators and the filters of the channels with
+     * active[channel] != 0, or of all of them if active is null.
+     */
+    void execute(const unsigned char* active = nullptr);
+
+    //! PLL discriminator output of the last execute() [cycles]
+    float carrier_error_hz(int channel) const { return d_carr_error[channel]; }
+    //! PLL filter output of the last execute() [Hz]
+    float carrier_error_filt_hz(int channel) const { return d_carr_nco[channel]; }
+    //! DLL discriminator output of the last execute() [chips]
+    float code_error_chips(int channel) const { return d_code_error[channel]; }
+    //! DLL filter output of the last execute() [chips/s]
+    float code_error_filt_chips(int channel) const { return d_code_nco[channel]; }
+
+    //! Number of registered channels
+    int num_channels() const
+    {
+        return d_n_channels;
+    }
+
+    bool free();
+
+private:
+    void update_coefficients(int channel);
+
+    int d_max_channels;
+    int d_n_channels;
+
+    // Correlator outputs of each channel
+    const std::complex<float>** d_corr_in;
+    int* d_early_idx;
+    int* d_prompt_idx;
+    int* d_late_idx;
+
+    // Gathered correlator outputs and discriminator intermediates
+    std::complex<float>* d_early;
+    std::complex<float>* d_prompt;
+    std::complex<float>* d_late;
+    float* d_early_mag;
+    float* d_late_mag;
+
+    // Loop configuration
+    float* d_pdi;
+    float* d_pll_bw;
+    float* d_dll_bw;
+
+    // Filter coefficients: nco += k1 * (e - e_old) + k2 * (e + e_old)
+    float* d_carr_k1;
+    float* d_carr_k2;
+    float* d_code_k1;
+    float* d_code_k2;
+
+    // Filter state and outputs
+    float* d_carr_error;
+    float* d_carr_nco;
+    float* d_code_error;
+    float* d_code_nco;
+    float* d_old_carr_error;
+    float* d_old_code_error;
+};
+
+#endif /* GNSS_SDR_MULTICHANNEL_LOOP_FILTERS_H_ */
@@ -0,0 +1,258 @@
+/*!
+ * \file shm_loop_connector.cc
+ * \brief Shared-memory mailboxes between the tracking channels and an
+ *  external loop filter process
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "shm_loop_connector.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace
+{
+size_t slot_offset()
+{
+    return (sizeof(shm_loop_header) + alignof(shm_loop_slot) - 1) / alignof(shm_loop_slot) * alignof(shm_loop_slot);
+}
+}
+
+
+shm_loop_connector::shm_loop_connector()
+{
+    d_header = nullptr;
+    d_size = 0;
+    d_slot = -1;
+    d_seq = 0;
+    d_timeout_ms = 1000;
+}
+
+
+shm_loop_connector::~shm_loop_connector()
+{
+    close();
+}
+
+
+bool shm_loop_connector::open(const std::string& name, int slot, int n_slots, int timeout_ms)
+{
+    close();
+    if (n_slots <= 0 || slot >= n_slots)
+        {
+            return false;
+        }
+    size_t size = slot_offset() + n_slots * sizeof(shm_loop_slot);
+
+    bool creator = false;
+    int fd = -1;
+    if (slot >= 0)
+        {
+            fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+            creator = fd >= 0;
+        }
+    if (fd < 0)
+        {
+            fd = shm_open(name.c_str(), O_RDWR, 0600);
+        }
+    if (fd < 0)
+        {
+            std::cerr << "Cannot open shared memory " << name << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    if (creator)
+        {
+            if (ftruncate(fd, size) != 0)
+                {
+                    std::cerr << "Cannot size shared memory " << name << ": " << std::strerror(errno) << std::endl;
+                    ::close(fd);
+                    shm_unlink(name.c_str());
+                    return false;
+                }
+        }
+    else
+        {
+            // The creator may not have sized it yet
+            struct stat st;
+            while (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) < sizeof(shm_loop_header))
+                {
+                    if (std::chrono::steady_clock::now() > deadline)
+                        {
+                            ::close(fd);
+                            return false;
+                        }
+                    std::this_thread::yield();
+                }
+            size = st.st_size;
+        }
+
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED)
+        {
+            std::cerr << "Cannot map shared memory " << name << ": " << std::strerror(errno) << std::endl;
+            if (creator) shm_unlink(name.c_str());
+            return false;
+        }
+    shm_loop_header* header = static_cast<shm_loop_header*>(base);
+
+    if (creator)
+        {
+            // ftruncate zero-fills the slots. The magic number is written last.
+            header->version = SHM_LOOP_VERSION;
+            header->n_slots = n_slots;
+            header->slot_size = sizeof(shm_loop_slot);
+            header->slot_offset = slot_offset();
+            header->attached.store(0);
+            std::atomic_thread_fence(std::memory_order_release);
+            reinterpret_cast<std::atomic<uint32_t>*>(&header->magic)->store(SHM_LOOP_MAGIC, std::memory_order_release);
+        }
+    else
+        {
+            while (reinterpret_cast<std::atomic<uint32_t>*>(&header->magic)->load(std::memory_order_acquire) != SHM_LOOP_MAGIC)
+                {
+                    if (std::chrono::steady_clock::now() > deadline)
+                        {
+                            munmap(base, size);
+                            return false;
+                        }
+                    std::this_thread::yield();
+                }
+            if (header->version != SHM_LOOP_VERSION || header->slot_size != sizeof(shm_loop_slot)
+                    || header->n_slots < static_cast<uint32_t>(n_slots)
+                    || size < header->slot_offset + header->n_slots * sizeof(shm_loop_slot))
+                {
+                    std::cerr << "Shared memory " << name << " has an incompatible layout" << std::endl;
+                    munmap(base, size);
+                    return false;
+                }
+        }
+
+    d_name = name;
+    d_header = header;
+    d_size = size;
+    d_slot = slot;
+    d_timeout_ms = timeout_ms;
+    if (slot >= 0)
+        {
+            d_header->attached.fetch_add(1);
+            d_seq = slot_at(slot)->request_seq.load(std::memory_order_relaxed);
+        }
+    return true;
+}
+
+
+shm_loop_slot* shm_loop_connector::slot_at(int slot) const
+{
+    return reinterpret_cast<shm_loop_slot*>(reinterpret_cast<char*>(d_header) + d_header->slot_offset
+            + static_cast<size_t>(slot) * d_header->slot_size);
+}
+
+
+bool shm_loop_connector::send_receive(const float* tx, int n_tx, float* rx, int n_rx)
+{
+    if (d_header == nullptr || d_slot < 0 || n_tx > SHM_LOOP_MAX_TX_VARIABLES || n_rx > SHM_LOOP_MAX_RX_VARIABLES)
+        {
+            return false;
+        }
+    shm_loop_slot* s = slot_at(d_slot);
+    std::memcpy(s->tx, tx, n_tx * sizeof(float));
+    s->n_tx = n_tx;
+    d_seq++;
+    s->request_seq.store(d_seq, std::memory_order_release);
+
+    // Spin first: the loop process normally answers within microseconds
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(d_timeout_ms);
+    unsigned int spins = 0;
+    while (s->response_seq.load(std::memory_order_acquire) != d_seq)
+        {
+            if (++spins > 1024)
+                {
+                    if (std::chrono::steady_clock::now() > deadline)
+                        {
+                            std::cerr << "No answer from the loop process on shared memory slot " << d_slot << std::endl;
+                            return false;
+                        }
+                    std::this_thread::yield();
+                }
+        }
+    std::memcpy(rx, s->rx, n_rx * sizeof(float));
+    return rx[0] == tx[0];
+}
+
+
+int shm_loop_connector::poll(const std::function<void(int, const float*, int, float*)>& process)
+{
+    if (d_header == nullptr)
+        {
+            return 0;
+        }
+    int answered = 0;
+    for (uint32_t n = 0; n < d_header->n_slots; n++)
+        {
+            shm_loop_slot* s = slot_at(n);
+            uint32_t seq = s->request_seq.load(std::memory_order_acquire);
+            if (seq == s->response_seq.load(std::memory_order_relaxed))
+                {
+                    continue;
+                }
+            int n_tx = std::min<int>(s->n_tx, SHM_LOOP_MAX_TX_VARIABLES);
+            s->rx[0] = s->tx[0];
+            process(n, s->tx, n_tx, s->rx);
+            s->response_seq.store(seq, std::memory_order_release);
+            answered++;
+        }
+    return answered;
+}
+
+
+void shm_loop_connector::close()
+{
+    if (d_header == nullptr)
+        {
+            return;
+        }
+    // The last channel removes the name; the mappings stay valid until unmapped
+    if (d_slot >= 0 && d_header->attached.fetch_sub(1) == 1)
+        {
+            shm_unlink(d_name.c_str());
+        }
+    munmap(d_header, d_size);
+    d_header = nullptr;
+    d_size = 0;
+    d_slot = -1;
+}
@@ -0,0 +1,137 @@
+/*!
+ * \file shm_loop_connector.h
+ * \brief Shared-memory mailboxes between the tracking channels and an
+ *  external loop filter process
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The TCP connector tracking blocks send their correlator outputs to an
+ * external process once per integration, and block until it answers. With
+ * one socket per channel and two system calls per epoch, the round trip
+ * limits the number of channels. This class places one mailbox per channel
+ * in a POSIX shared memory segment: the channel writes its request and
+ * bumps a sequence number, and the external process scans all the mailboxes
+ * in a single sweep, answering every pending request in one batch.
+ *
+ * Segment layout (all fields in host byte order):
+ *  - shm_loop_header, at offset 0.
+ *  - header.n_slots times shm_loop_slot, starting at offset header.slot_offset,
+ *    header.slot_size bytes apart. Slot i belongs to channel i.
+ * A request is pending when request_seq != response_seq. The loop process
+ * reads tx[0 .. n_tx-1], writes rx[0 .. NUM_RX_VARIABLES-1] (rx[0] echoes
+ * tx[0], as in the TCP packets) and then stores response_seq = request_seq.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_SHM_LOOP_CONNECTOR_H_
+#define GNSS_SDR_SHM_LOOP_CONNECTOR_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#define SHM_LOOP_MAGIC 0x474E5353
+#define SHM_LOOP_VERSION 1
+#define SHM_LOOP_MAX_TX_VARIABLES 16
+#define SHM_LOOP_MAX_RX_VARIABLES 4
+
+struct shm_loop_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t n_slots;
+    uint32_t slot_size;
+    uint32_t slot_offset;
+    std::atomic<uint32_t> attached;  //!< channels currently using the segment
+};
+
+/*!
+ * \brief Mailbox of one channel. The request and the response live in
+ * different cache lines, so that each side only writes its own line.
+ */
+struct alignas(64) shm_loop_slot
+{
+    std::atomic<uint32_t> request_seq;
+    uint32_t n_tx;
+    float tx[SHM_LOOP_MAX_TX_VARIABLES];
+    alignas(64) std::atomic<uint32_t> response_seq;
+    float rx[SHM_LOOP_MAX_RX_VARIABLES];
+};
+
+/*!
+ * \brief Maps the shared segment and exchanges requests and responses through it.
+ *
+ * The receiver side calls open() with its channel number and then
+ * send_receive() once per integration. The loop process side calls open()
+ * with slot = -1 and then poll() in a loop.
+ */
+class shm_loop_connector
+{
+public:
+    shm_loop_connector();
+    ~shm_loop_connector();
+
+    /*!
+     * \brief Creates the segment, or attaches to it if another channel
+     * already did. Returns false if it cannot be mapped or if it has fewer
+     * than n_slots mailboxes.
+     * \param name - POSIX shared memory name, e.g. "/gnss_sdr_trk".
+     * \param slot - mailbox of this channel, or -1 for the loop process side.
+     * \param timeout_ms - longest wait for a response in send_receive().
+     */
+    bool open(const std::string& name, int slot, int n_slots = 64, int timeout_ms = 1000);
+
+    /*!
+     * \brief Posts the n_tx variables of tx and waits for the n_rx answers.
+     * Returns false on timeout, or if rx[0] does not echo tx[0].
+     */
+    bool send_receive(const float* tx, int n_tx, float* rx, int n_rx);
+
+    /*!
+     * \brief Answers every pending request. process(slot, tx, n_tx, rx) fills
+     * rx[1 .. SHM_LOOP_MAX_RX_VARIABLES-1]. Returns the number of answered requests.
+     */
+    int poll(const std::function<void(int, const float*, int, float*)>& process);
+
+    void close();
+
+    bool is_open() const
+    {
+        return d_header != nullptr;
+    }
+
+private:
+    shm_loop_slot* slot_at(int slot) const;
+
+    std::string d_name;
+    shm_loop_header* d_header;
+    size_t d_size;
+    int d_slot;
+    uint32_t d_seq;
+    int d_timeout_ms;
+};
+
+#endif
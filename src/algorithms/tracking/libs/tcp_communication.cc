@@ -76,12 +76,35 @@ int tcp_communication::listen_tcp_connection(size_t d_port_, size_t d_port_ch0_)
 }
 
 
+bool tcp_communication::open_shm_connection(const std::string& shm_name, int channel)
+{
+    if (!shm_.open(shm_name, channel))
+        {
+            std::cerr << "Shared memory " << shm_name << " unavailable. Falling back to TCP." << std::endl;
+            return false;
+        }
+    std::cout << "Channel " << channel << " attached to shared memory " << shm_name << std::endl;
+    return true;
+}
+
+
 void tcp_communication::send_receive_tcp_packet_galileo_e1(boost::array<float, NUM_TX_VARIABLES_GALILEO_E1> buf, tcp_packet_data *tcp_data_)
 {
     int controlc = 0;
     boost::array<float, NUM_RX_VARIABLES> readbuf;
     float d_control_id_ = buf.data()[0];
 
+    if (shm_.is_open())
+        {
+            if (shm_.send_receive(buf.data(), NUM_TX_VARIABLES_GALILEO_E1, readbuf.data(), NUM_RX_VARIABLES))
+                {
+                    tcp_data_->proc_pack_code_error = readbuf.data()[1];
+                    tcp_data_->proc_pack_carr_error = readbuf.data()[2];
+                    tcp_data_->proc_pack_carrier_doppler_hz = readbuf.data()[3];
+                }
+            return;
+        }
+
     try
     {
             // Send a TCP packet
@@ -117,6 +140,17 @@ void tcp_communication::send_receive_tcp_packet_gps_l1_ca(boost::array<float, NU
     boost::array<float, NUM_RX_VARIABLES> readbuf;
     float d_control_id_ = buf.data()[0];
 
+    if (shm_.is_open())
+        {
+            if (shm_.send_receive(buf.data(), NUM_TX_VARIABLES_GPS_L1_CA, readbuf.data(), NUM_RX_VARIABLES))
+                {
+                    tcp_data_->proc_pack_code_error = readbuf.data()[1];
+                    tcp_data_->proc_pack_carr_error = readbuf.data()[2];
+                    tcp_data_->proc_pack_carrier_doppler_hz = readbuf.data()[3];
+                }
+            return;
+        }
+
     try
     {
             // Send a TCP packet
@@ -148,6 +182,8 @@ void tcp_communication::send_receive_tcp_packet_gps_l1_ca(boost::array<float, NU
 
 void tcp_communication::close_tcp_connection(size_t d_port_)
 {
+    shm_.close();
+
     // Close the TCP connection
     tcp_socket_.close();
     std::cout << "Socket closed on port " << d_port_ << std::endl;
@@ -34,6 +34,8 @@
 
 #include <boost/asio.hpp>
 #include <boost/array.hpp>
+#include <string>
+#include "shm_loop_connector.h"
 #include "tcp_packet_data.h"
 
 #define NUM_TX_VARIABLES_GALILEO_E1 13
@@ -42,6 +44,9 @@
 
 /*!
  * \brief TCP communication class
+ *
+ * If open_shm_connection() succeeds, the packets go through a
+ * shm_loop_connector mailbox instead of the TCP socket.
  */
 class tcp_communication
 {
@@ -50,6 +55,7 @@ public:
     ~tcp_communication();
 
     int listen_tcp_connection(size_t d_port_, size_t d_port_ch0_);
+    bool open_shm_connection(const std::string& shm_name, int channel);
     void send_receive_tcp_packet_galileo_e1(boost::array<float, NUM_TX_VARIABLES_GALILEO_E1> buf, tcp_packet_data *tcp_data_);
     void send_receive_tcp_packet_gps_l1_ca(boost::array<float, NUM_TX_VARIABLES_GPS_L1_CA> buf, tcp_packet_data *tcp_data_);
     void close_tcp_connection(size_t d_port_);
@@ -57,6 +63,7 @@ public:
 private:
     boost::asio::io_service io_service_;
     boost::asio::ip::tcp::socket tcp_socket_;
+    shm_loop_connector shm_;
 };
 
 #endif
@@ -134,3 +134,40 @@ double dll_nc_vemlp_normalized(gr_complex very_early_s1, gr_complex early_s1, gr
             return (P_early - P_late) / ((P_early + P_late));
         }
 }
+
+
+float pll_cloop_two_quadrant_atan_32f(gr_complex prompt_s1)
+{
+    if (prompt_s1.real() != 0.0f)
+        {
+            return std::atan(prompt_s1.imag() / prompt_s1.real());
+        }
+    else
+        {
+            return 0.0f;
+        }
+}
+
+
+float dll_nc_e_minus_l_normalized_32f(gr_complex early_s1, gr_complex late_s1)
+{
+    const float P_early = std::abs(early_s1);
+    const float P_late = std::abs(late_s1);
+    if (P_early + P_late == 0.0f)
+        {
+            return 0.0f;
+        }
+    return 0.5f * (P_early - P_late) / (P_early + P_late);
+}
+
+
+float dll_nc_vemlp_normalized_32f(gr_complex very_early_s1, gr_complex early_s1, gr_complex late_s1, gr_complex very_late_s1)
+{
+    const float P_early = std::sqrt(std::norm(very_early_s1) + std::norm(early_s1));
+    const float P_late = std::sqrt(std::norm(very_late_s1) + std::norm(late_s1));
+    if (P_early + P_late == 0.0f)
+        {
+            return 0.0f;
+        }
+    return (P_early - P_late) / (P_early + P_late);
+}
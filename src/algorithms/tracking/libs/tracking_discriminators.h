@@ -100,4 +100,18 @@ double dll_nc_e_minus_l_normalized(gr_complex early_s1, gr_complex late_s1);
 double dll_nc_vemlp_normalized(gr_complex very_early_s1, gr_complex early_s1, gr_complex late_s1, gr_complex very_late_s1);
 
 
+/*! \brief Same as pll_cloop_two_quadrant_atan(), in single precision, for
+ * targets where double precision arithmetic is slow. The output is in [radians].
+ */
+float pll_cloop_two_quadrant_atan_32f(gr_complex prompt_s1);
+
+
+//! \brief Same as dll_nc_e_minus_l_normalized(), in single precision. The output is in [chips].
+float dll_nc_e_minus_l_normalized_32f(gr_complex early_s1, gr_complex late_s1);
+
+
+//! \brief Same as dll_nc_vemlp_normalized(), in single precision. The output is in [chips].
+float dll_nc_vemlp_normalized_32f(gr_complex very_early_s1, gr_complex early_s1, gr_complex late_s1, gr_complex very_late_s1);
+
+
 #endif
@@ -0,0 +1,145 @@
+/*!
+ * \file tracking_dump_replay.cc
+ * \brief Outputs of a tracking channel read back from its dump
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "tracking_dump_replay.h"
+
+namespace
+{
+struct Tracking_Dump_Type
+{
+    const char * block_type;
+    char system;
+    const char * signal;
+};
+
+const Tracking_Dump_Type DUMP_TYPES[] = {
+        { "gps_l1_ca_dll_pll_tracking", 'G', "1C" },
+        { "galileo_e1_veml_tracking", 'E', "1B" } };
+
+// In the order of Replayed_Field
+const char * const FIELD_NAMES[] = { "prompt_I", "prompt_Q", "acc_carrier_phase_rad",
+        "carrier_doppler_hz", "CN0_SNV_dB_Hz", "PRN", "tracking_timestamp_secs",
+        "valid_symbol", "correlation_length_ms" };
+}
+
+
+Tracking_Dump_Replay::Tracking_Dump_Replay()
+{
+    for (unsigned int f = 0; f < REPLAYED_FIELDS; f++)
+        {
+            d_fields[f] = -1;
+        }
+    d_system = 0;
+    d_prn = 0;
+    d_next = 0;
+    d_replayed = 0;
+}
+
+
+bool Tracking_Dump_Replay::open(const std::string & filename)
+{
+    d_error.clear();
+    d_next = 0;
+    d_replayed = 0;
+    d_prn = 0;
+    if (!d_reader.open(filename))
+        {
+            d_error = filename + " is not a dump file";
+            return false;
+        }
+    d_system = 0;
+    for (unsigned int t = 0; t < sizeof(DUMP_TYPES) / sizeof(DUMP_TYPES[0]); t++)
+        {
+            if (d_reader.block_type() == DUMP_TYPES[t].block_type)
+                {
+                    d_system = DUMP_TYPES[t].system;
+                    d_signal = DUMP_TYPES[t].signal;
+                }
+        }
+    if (d_system == 0)
+        {
+            d_error = filename + " is a dump of " + d_reader.block_type() + ", not of a tracking block that can be replayed";
+            d_reader.close();
+            return false;
+        }
+    for (unsigned int f = 0; f < REPLAYED_FIELDS; f++)
+        {
+            d_fields[f] = d_reader.field_index(FIELD_NAMES[f]);
+            if (d_fields[f] < 0)
+                {
+                    d_error = filename + " has no field " + FIELD_NAMES[f] + ", it was made by an older receiver";
+                    d_reader.close();
+                    return false;
+                }
+        }
+    for (unsigned long long r = 0; r < d_reader.num_records() && d_prn == 0; r++)
+        {
+            d_prn = static_cast<unsigned int>(d_reader.value(r, d_fields[PRN]));
+        }
+    return true;
+}
+
+
+bool Tracking_Dump_Replay::next(Gnss_Synchro & synchro, int channel_id)
+{
+    if (!d_reader.is_open())
+        {
+            return false;
+        }
+    while (d_next < d_reader.num_records())
+        {
+            const unsigned long long r = d_next++;
+            const unsigned int prn = static_cast<unsigned int>(d_reader.value(r, d_fields[PRN]));
+            if (prn == 0)
+                {
+                    continue;
+                }
+            synchro = Gnss_Synchro();
+            synchro.System = d_system;
+            synchro.Signal[0] = d_signal[0];
+            synchro.Signal[1] = d_signal[1];
+            synchro.Signal[2] = '\0';
+            synchro.PRN = prn;
+            synchro.Channel_ID = channel_id;
+            synchro.correlation_length_ms = static_cast<int>(d_reader.value(r, d_fields[CORRELATION_LENGTH]));
+            synchro.Flag_valid_symbol_output = d_reader.value(r, d_fields[VALID_SYMBOL]) != 0.0;
+            synchro.Prompt_I = d_reader.value(r, d_fields[PROMPT_I]);
+            synchro.Prompt_Q = d_reader.value(r, d_fields[PROMPT_Q]);
+            synchro.CN0_dB_hz = d_reader.value(r, d_fields[CN0]);
+            synchro.Carrier_Doppler_hz = d_reader.value(r, d_fields[CARRIER_DOPPLER]);
+            synchro.Carrier_phase_rads = d_reader.value(r, d_fields[CARRIER_PHASE]);
+            // the tracking blocks align the timestamp with the start of the code
+            synchro.Code_phase_secs = 0.0;
+            synchro.Tracking_timestamp_secs = d_reader.value(r, d_fields[TIMESTAMP]);
+            d_replayed++;
+            return true;
+        }
+    return false;
+}
@@ -0,0 +1,128 @@
+/*!
+ * \file tracking_dump_replay.h
+ * \brief Outputs of a tracking channel read back from its dump
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The dumps of gps_l1_ca_dll_pll_tracking_cc and
+ * galileo_e1_dll_pll_veml_tracking_cc keep, besides the loop variables,
+ * the fields of the Gnss_Synchro given to the telemetry decoder, so that
+ * the back end can be run on them without the signal.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_TRACKING_DUMP_REPLAY_H_
+#define GNSS_SDR_TRACKING_DUMP_REPLAY_H_
+
+#include <string>
+#include "binary_dump_reader.h"
+#include "gnss_synchro.h"
+
+class Tracking_Dump_Replay
+{
+public:
+    Tracking_Dump_Replay();
+
+    /*!
+     * \brief Maps a tracking dump. Returns false if the file is not a dump
+     * of a known tracking block, or was made before the dumps had the
+     * outputs to the telemetry decoder.
+     */
+    bool open(const std::string & filename);
+
+    //! 'G' or 'E'
+    char system() const
+    {
+        return d_system;
+    }
+
+    //! "1C" or "1B"
+    const std::string & signal() const
+    {
+        return d_signal;
+    }
+
+    //! First satellite tracked in the dump, 0 if the channel never tracked
+    unsigned int prn() const
+    {
+        return d_prn;
+    }
+
+    unsigned long long records() const
+    {
+        return d_reader.num_records();
+    }
+
+    /*!
+     * \brief Fills \p synchro with the next output of the channel while it
+     * was tracking; the records of an idle channel are skipped. Returns
+     * false at the end of the dump.
+     */
+    bool next(Gnss_Synchro & synchro, int channel_id);
+
+    //! Starts again from the first record
+    void rewind()
+    {
+        d_next = 0;
+    }
+
+    //! Outputs given by next()
+    unsigned long long replayed() const
+    {
+        return d_replayed;
+    }
+
+    //! Last error, empty if none
+    const std::string & error() const
+    {
+        return d_error;
+    }
+
+private:
+    enum Replayed_Field
+    {
+        PROMPT_I,
+        PROMPT_Q,
+        CARRIER_PHASE,
+        CARRIER_DOPPLER,
+        CN0,
+        PRN,
+        TIMESTAMP,
+        VALID_SYMBOL,
+        CORRELATION_LENGTH,
+        REPLAYED_FIELDS
+    };
+
+    Binary_Dump_Reader d_reader;
+    int d_fields[REPLAYED_FIELDS];
+    char d_system;
+    std::string d_signal;
+    unsigned int d_prn;
+    unsigned long long d_next;
+    unsigned long long d_replayed;
+    std::string d_error;
+};
+
+#endif /* GNSS_SDR_TRACKING_DUMP_REPLAY_H_ */
@@ -0,0 +1,834 @@
+/*!
+ * \file tracking_engine.h
+ * \brief Correlators and code/carrier NCOs of the DLL + PLL tracking blocks,
+ *  specialized at compile time for each signal and sample type
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The DLL + PLL blocks differ in a handful of constants (code length and
+ * rate, carrier frequency, integration time and the layout of the
+ * correlator taps) and in the correlator of their sample type. The signal
+ * traits below hold those constants as constant expressions, and
+ * Tracking_Engine takes them, and the sample type, as template parameters,
+ * so the loops over the taps have a fixed trip count and the code period
+ * arithmetic folds into constants. Work done here reaches every block
+ * built on it. The NCOs and discriminators are a third parameter, in
+ * double precision or, for embedded targets, in fixed point and float.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_TRACKING_ENGINE_H_
+#define GNSS_SDR_TRACKING_ENGINE_H_
+
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+#include "cpu_multicorrelator.h"
+#include "cpu_multicorrelator_16sc.h"
+#include "gnss_sdr_memory_accounting.h"
+#include "tracking_discriminators.h"
+
+/*!
+ * \brief GPS L1 C/A, Early, Prompt and Late correlators, 1 ms
+ *
+ * The values are the ones of GPS_L1_CA.h, which are not constant
+ * expressions. Tap i is shifted by tap_offset[i] times the early-late
+ * spacing plus tap_offset_very[i] times the very early-late spacing, in
+ * chips.
+ */
+struct Gps_L1_Ca_Tracking_Traits
+{
+    static constexpr int code_length_chips = 1023;
+    static constexpr int samples_per_chip = 1;
+    static constexpr double code_rate_hz = 1.023e6;
+    static constexpr double carrier_freq_hz = 1.57542e9;
+    static constexpr double integration_time_s = 0.001;
+    static constexpr int n_taps = 3;
+    static constexpr int prompt = 1;
+    static constexpr int early = 0;
+    static constexpr int late = 2;
+    static constexpr float tap_offset(int i) { return static_cast<float>(i - 1); }
+    static constexpr float tap_offset_very(int) { return 0.0; }
+};
+
+//! GPS L2C(M), Early, Prompt and Late correlators, 20 ms
+struct Gps_L2_M_Tracking_Traits
+{
+    static constexpr int code_length_chips = 10230;
+    static constexpr int samples_per_chip = 1;
+    static constexpr double code_rate_hz = 0.5115e6;
+    static constexpr double carrier_freq_hz = 1.2276e9;
+    static constexpr double integration_time_s = 0.02;
+    static constexpr int n_taps = 3;
+    static constexpr int prompt = 1;
+    static constexpr int early = 0;
+    static constexpr int late = 2;
+    static constexpr float tap_offset(int i) { return static_cast<float>(i - 1); }
+    static constexpr float tap_offset_very(int) { return 0.0; }
+};
+
+/*!
+ * \brief Galileo E1, Very Early, Early, Prompt, Late and Very Late
+ * correlators, 4 ms. The local code is the BOC(1,1) replica sampled twice
+ * per chip, so the code NCO and the taps run in half chips. The taps are
+ * the ones the E1 block has always used: the very early and very late
+ * ones two very early-late spacings from the prompt one, in half chips,
+ * and the early and late ones one spacing from it.
+ */
+struct Galileo_E1_Tracking_Traits
+{
+    static constexpr int code_length_chips = 4092;
+    static constexpr int samples_per_chip = 2;
+    static constexpr double code_rate_hz = 1.023e6;
+    static constexpr double carrier_freq_hz = 1.57542e9;
+    static constexpr double integration_time_s = 0.004;
+    static constexpr int n_taps = 5;
+    static constexpr int prompt = 2;
+    static constexpr int early = 1;
+    static constexpr int late = 3;
+    static constexpr float tap_offset(int) { return 0.0; }
+    static constexpr float tap_offset_very(int i) { return 0.5 * static_cast<float>(i - 2); }
+};
+
+
+/*!
+ * \brief Correlator of each sample type. The correlator outputs are always
+ * std::complex<float>, which is what the discriminators take.
+ *
+ * set_code() and set_pilot_code() take the local code in
+ * std::complex<float> and a buffer of the same length where it is
+ * converted to the sample type, if needed.
+ */
+template <class Sample>
+struct Tracking_Correlator;
+
+template <>
+struct Tracking_Correlator<std::complex<float> >
+{
+    typedef cpu_multicorrelator type;
+
+    static void set_code(type & correlator, int length, const std::complex<float>* code, std::complex<float>*, float* shifts)
+    {
+        correlator.set_local_code_and_taps(length, code, shifts);
+    }
+
+    static void set_pilot_code(type & correlator, int, const std::complex<float>* code, std::complex<float>*, float* shifts)
+    {
+        correlator.set_pilot_code_and_taps(code, shifts);
+    }
+
+    static void set_fast_resampler(type & correlator, bool fast_resampler)
+    {
+        correlator.set_fast_resampler(fast_resampler);
+    }
+
+    //! The samples as std::complex<float>, for the monitor taps of Tracking_Engine
+    static const std::complex<float>* float_samples(const std::complex<float>* in, std::complex<float>*, int)
+    {
+        return in;
+    }
+};
+
+template <>
+struct Tracking_Correlator<lv_16sc_t>
+{
+    typedef cpu_multicorrelator_16sc type;
+
+    static void set_code(type & correlator, int length, const std::complex<float>* code, lv_16sc_t* code_16sc, float* shifts)
+    {
+        volk_gnsssdr_32fc_convert_16ic(code_16sc, code, length);
+        correlator.set_local_code_and_taps(length, code_16sc, shifts);
+    }
+
+    static void set_pilot_code(type & correlator, int length, const std::complex<float>* code, lv_16sc_t* code_16sc, float* shifts)
+    {
+        volk_gnsssdr_32fc_convert_16ic(code_16sc, code, length);
+        correlator.set_pilot_code_and_taps(code_16sc, shifts);
+    }
+
+    // The 16-bit correlator always resamples the replicas before the dot products
+    static void set_fast_resampler(type &, bool) {}
+
+    static const std::complex<float>* float_samples(const lv_16sc_t* in, std::complex<float>* buffer, int length)
+    {
+        volk_gnsssdr_16ic_convert_32fc(buffer, in, length);
+        return buffer;
+    }
+};
+
+
+
+/*!
+ * \brief Code and carrier NCOs of a tracking loop for \p Signal, and the
+ * discriminators of the loop, in double precision
+ *
+ * update() closes a code period with the filtered carrier Doppler and code
+ * error, and sets the length of the next period and the phases and steps
+ * that the correlator takes for it.
+ */
+template <class Signal>
+class Tracking_Double_Loop
+{
+public:
+    typedef double real;
+
+    //! Costas PLL discriminator [cycles]
+    static real carrier_error_cycles(const std::complex<float> & prompt)
+    {
+        return pll_cloop_two_quadrant_atan(prompt) / 6.283185307179586;
+    }
+
+    //! Noncoherent Early minus Late DLL discriminator [chips]
+    static real code_error_chips(const std::complex<float> & early, const std::complex<float> & late)
+    {
+        return dll_nc_e_minus_l_normalized(early, late);
+    }
+
+    void reset(double fs_in, double doppler_hz, double code_phase_samples)
+    {
+        const double two_pi = 6.283185307179586;
+        d_fs_in = fs_in;
+        d_carrier_doppler_hz = doppler_hz;
+        d_code_freq_chips = Signal::code_rate_hz * (Signal::carrier_freq_hz + doppler_hz) / Signal::carrier_freq_hz;
+        d_code_phase_step_chips = static_cast<double>(Signal::samples_per_chip) * d_code_freq_chips / d_fs_in;
+        d_carrier_phase_step_rad = two_pi * doppler_hz / d_fs_in;
+        d_current_prn_length_samples = static_cast<int>(std::round(static_cast<double>(Signal::code_length_chips) / d_code_freq_chips * d_fs_in));
+        d_rem_code_phase_samples = 0.0;
+        d_period_start_rem_samples = 0.0;
+        d_rem_code_phase_chips = 0.0;
+        d_rem_carr_phase_rad = 0.0;
+        d_acc_carrier_phase_rad = 0.0;
+        d_acc_code_phase_secs = 0.0;
+        d_code_phase_samples = code_phase_samples;
+    }
+
+    void update(real carrier_doppler_hz, real code_error_filt_chips)
+    {
+        const double two_pi = 6.283185307179586;
+        d_carrier_doppler_hz = carrier_doppler_hz;
+        d_code_freq_chips = Signal::code_rate_hz + carrier_doppler_hz * (Signal::code_rate_hz / Signal::carrier_freq_hz);
+
+        // carrier phase accumulator and remnant carrier phase of the NCO
+        const double carrier_phase_period_rad = two_pi * carrier_doppler_hz * Signal::integration_time_s;
+        d_acc_carrier_phase_rad -= carrier_phase_period_rad;
+        d_rem_carr_phase_rad = std::fmod(d_rem_carr_phase_rad + carrier_phase_period_rad, two_pi);
+
+        // code phase accumulator
+        const double code_error_filt_secs = code_error_filt_chips * (Signal::integration_time_s / Signal::code_rate_hz);
+        d_acc_code_phase_secs += code_error_filt_secs;
+
+        // length of the next period, from the code frequency and the code phase error
+        const double T_prn_samples = static_cast<double>(Signal::code_length_chips) / d_code_freq_chips * d_fs_in;
+        d_period_start_rem_samples = d_rem_code_phase_samples;
+        const double K_blk_samples = T_prn_samples + d_rem_code_phase_samples + code_error_filt_secs * d_fs_in;
+        d_current_prn_length_samples = static_cast<int>(std::round(K_blk_samples));
+
+        // NCO commands: carrier phase step [rad/sample], code phase step and remnant [local code samples]
+        d_carrier_phase_step_rad = two_pi * carrier_doppler_hz / d_fs_in;
+        d_code_phase_step_chips = static_cast<double>(Signal::samples_per_chip) * d_code_freq_chips / d_fs_in;
+        d_rem_code_phase_samples = K_blk_samples - d_current_prn_length_samples; // rounding error < 1 sample
+        // the remnant of this period, so that the code NCO does not lag one period behind when a sample slips
+        d_rem_code_phase_chips = d_rem_code_phase_samples * d_code_phase_step_chips;
+    }
+
+    real rem_carr_phase_rad() const { return d_rem_carr_phase_rad; }
+    real carrier_phase_step_rad() const { return d_carrier_phase_step_rad; }
+    real rem_code_phase_chips() const { return d_rem_code_phase_chips; }
+    real code_phase_step_chips() const { return d_code_phase_step_chips; }
+    int current_prn_length_samples() const { return d_current_prn_length_samples; }
+
+    double period_start_rem_samples() const { return d_period_start_rem_samples; }
+    double rem_code_phase_samples() const { return d_rem_code_phase_samples; }
+    double carrier_doppler_hz() const { return d_carrier_doppler_hz; }
+    double code_freq_chips() const { return d_code_freq_chips; }
+    double acc_carrier_phase_rad() const { return d_acc_carrier_phase_rad; }
+    double acc_code_phase_secs() const { return d_acc_code_phase_secs; }
+    double code_phase_samples() const { return d_code_phase_samples; }
+
+private:
+    double d_fs_in;
+    double d_carrier_doppler_hz;
+    double d_code_freq_chips;
+    double d_code_phase_step_chips;
+    double d_carrier_phase_step_rad;
+    double d_rem_code_phase_samples;
+    double d_period_start_rem_samples;
+    double d_rem_code_phase_chips;
+    double d_rem_carr_phase_rad;
+    double d_acc_carrier_phase_rad;
+    double d_acc_code_phase_secs;
+    double d_code_phase_samples;
+    int d_current_prn_length_samples;
+};
+
+
+/*!
+ * \brief Same as Tracking_Double_Loop, with no double precision arithmetic
+ * per code period, for targets where it is slow (e.g., Cortex-A7)
+ *
+ * The carrier phase, the code phase error and the remnant code phase are
+ * accumulated in 64-bit fixed point, with 32 fractional bits: the low word
+ * of the carrier phase [cycles] is the remnant phase of the NCO, so it
+ * wraps around without a fmod, and the accumulators do not lose resolution
+ * as they grow. The carrier phase wraps around after 2^31 cycles (days of
+ * tracking at the largest Doppler shifts). The Doppler, the discriminators
+ * and the NCO steps are float; the length of a period is the nominal one,
+ * computed in double precision at reset(), plus float corrections that
+ * are small enough for their rounding errors to stay far below a sample.
+ */
+template <class Signal>
+class Tracking_Fixed_Point_Loop
+{
+public:
+    typedef float real;
+
+    static real carrier_error_cycles(const std::complex<float> & prompt)
+    {
+        return pll_cloop_two_quadrant_atan_32f(prompt) * static_cast<float>(1.0 / 6.283185307179586);
+    }
+
+    static real code_error_chips(const std::complex<float> & early, const std::complex<float> & late)
+    {
+        return dll_nc_e_minus_l_normalized_32f(early, late);
+    }
+
+    void reset(double fs_in, double doppler_hz, double code_phase_samples)
+    {
+        const double two_pi = 6.283185307179586;
+        const double nominal_prn_samples = static_cast<double>(Signal::code_length_chips) / Signal::code_rate_hz * fs_in;
+        d_nominal_prn_samples = static_cast<int64_t>(std::llround(nominal_prn_samples * static_cast<double>(FIXED_ONE)));
+        d_nominal_prn_samples_f = static_cast<float>(nominal_prn_samples);
+        d_nominal_code_step_chips = static_cast<float>(static_cast<double>(Signal::samples_per_chip) * Signal::code_rate_hz / fs_in);
+        d_code_step_per_hz = static_cast<float>(static_cast<double>(Signal::samples_per_chip) * Signal::code_rate_hz / Signal::carrier_freq_hz / fs_in);
+        d_carrier_step_per_hz = static_cast<float>(two_pi / fs_in);
+        d_code_error_chips_to_samples = static_cast<float>(fs_in / Signal::code_rate_hz);
+        const double period_fixed = Signal::integration_time_s * static_cast<double>(FIXED_ONE);
+        d_period_hi = static_cast<float>(period_fixed);
+        d_period_lo = static_cast<float>(period_fixed - static_cast<double>(d_period_hi));
+
+        const double code_freq_chips = Signal::code_rate_hz * (Signal::carrier_freq_hz + doppler_hz) / Signal::carrier_freq_hz;
+        d_current_prn_length_samples = static_cast<int>(std::round(static_cast<double>(Signal::code_length_chips) / code_freq_chips * fs_in));
+        d_carrier_doppler_hz = static_cast<float>(doppler_hz);
+        d_carrier_phase_step_rad = d_carrier_step_per_hz * d_carrier_doppler_hz;
+        d_code_phase_step_chips = d_nominal_code_step_chips + d_code_step_per_hz * d_carrier_doppler_hz;
+        d_rem_code_phase_chips = 0.0;
+        d_carrier_phase = 0;
+        d_code_phase_chips = 0;
+        d_rem_code_phase = 0;
+        d_period_start_rem = 0;
+        d_code_phase_samples = code_phase_samples;
+    }
+
+    void update(real carrier_doppler_hz, real code_error_filt_chips)
+    {
+        const float integration_time_s = static_cast<float>(Signal::integration_time_s);
+        d_carrier_doppler_hz = carrier_doppler_hz;
+
+        // carrier phase accumulator [cycles], whose low word is the remnant phase of the NCO
+        d_carrier_phase += static_cast<uint64_t>(carrier_phase_period(carrier_doppler_hz));
+
+        // code phase accumulator [chips]
+        const float code_error_filt = code_error_filt_chips * integration_time_s;
+        d_code_phase_chips += to_fixed(code_error_filt);
+
+        // length of the next period: the nominal one, shortened by the
+        // relative Doppler x as 1 / (1 + x), plus the code phase error
+        const float x = carrier_doppler_hz * static_cast<float>(1.0 / Signal::carrier_freq_hz);
+        const int64_t K_blk = d_nominal_prn_samples - to_fixed(d_nominal_prn_samples_f * x / (1.0f + x))
+                + d_rem_code_phase + to_fixed(code_error_filt * d_code_error_chips_to_samples);
+        d_period_start_rem = d_rem_code_phase;
+        d_current_prn_length_samples = static_cast<int>((K_blk + FIXED_ONE / 2) >> FIXED_BITS);
+
+        // NCO commands: carrier phase step [rad/sample], code phase step and remnant [local code samples]
+        d_carrier_phase_step_rad = d_carrier_step_per_hz * carrier_doppler_hz;
+        d_code_phase_step_chips = d_nominal_code_step_chips + d_code_step_per_hz * carrier_doppler_hz;
+        d_rem_code_phase = K_blk - (static_cast<int64_t>(d_current_prn_length_samples) << FIXED_BITS); // rounding error < 1 sample
+        d_rem_code_phase_chips = static_cast<float>(d_rem_code_phase) * (1.0f / static_cast<float>(FIXED_ONE)) * d_code_phase_step_chips;
+    }
+
+    real rem_carr_phase_rad() const
+    {
+        return static_cast<float>(static_cast<uint32_t>(d_carrier_phase)) * static_cast<float>(6.283185307179586 / static_cast<double>(FIXED_ONE));
+    }
+    real carrier_phase_step_rad() const { return d_carrier_phase_step_rad; }
+    real rem_code_phase_chips() const { return d_rem_code_phase_chips; }
+    real code_phase_step_chips() const { return d_code_phase_step_chips; }
+    int current_prn_length_samples() const { return d_current_prn_length_samples; }
+
+    // Once per period at most, to fill the outputs of the block
+    double period_start_rem_samples() const { return static_cast<double>(d_period_start_rem) / static_cast<double>(FIXED_ONE); }
+    double rem_code_phase_samples() const { return static_cast<double>(d_rem_code_phase) / static_cast<double>(FIXED_ONE); }
+    double carrier_doppler_hz() const { return d_carrier_doppler_hz; }
+    double code_freq_chips() const { return Signal::code_rate_hz + d_carrier_doppler_hz * (Signal::code_rate_hz / Signal::carrier_freq_hz); }
+    double acc_carrier_phase_rad() const { return -static_cast<double>(static_cast<int64_t>(d_carrier_phase)) * (6.283185307179586 / static_cast<double>(FIXED_ONE)); }
+    double acc_code_phase_secs() const { return static_cast<double>(d_code_phase_chips) / static_cast<double>(FIXED_ONE) / Signal::code_rate_hz; }
+    double code_phase_samples() const { return d_code_phase_samples; }
+
+private:
+    static constexpr int FIXED_BITS = 32;
+    static constexpr int64_t FIXED_ONE = static_cast<int64_t>(1) << FIXED_BITS;
+
+    static int64_t to_fixed(float value)
+    {
+        return static_cast<int64_t>(std::llrint(value * static_cast<float>(FIXED_ONE)));
+    }
+
+    /*
+     * Carrier phase of a period [fixed point cycles]. A float product would
+     * be off by up to 2^-24 of the phase, every period; the rounding error
+     * of the product, given exactly by the fma, and the low part of the
+     * period keep it within a few units of the last fixed point bit.
+     */
+    int64_t carrier_phase_period(float carrier_doppler_hz) const
+    {
+        const float product = carrier_doppler_hz * d_period_hi;
+        const float product_error = std::fma(carrier_doppler_hz, d_period_hi, -product);
+        return static_cast<int64_t>(std::llrint(product)) + static_cast<int64_t>(std::llrint(product_error + carrier_doppler_hz * d_period_lo));
+    }
+
+    // constants of the sample rate
+    int64_t d_nominal_prn_samples;  // code period without Doppler [fixed point samples]
+    float d_nominal_prn_samples_f;
+    float d_nominal_code_step_chips;
+    float d_code_step_per_hz;
+    float d_carrier_step_per_hz;
+    float d_code_error_chips_to_samples;
+    float d_period_hi;              // integration time [fixed point s], as the sum of two floats
+    float d_period_lo;
+
+    float d_carrier_doppler_hz;
+    float d_carrier_phase_step_rad;
+    float d_code_phase_step_chips;
+    float d_rem_code_phase_chips;
+    uint64_t d_carrier_phase;       // fixed point cycles, wraps around
+    int64_t d_code_phase_chips;     // fixed point
+    int64_t d_rem_code_phase;       // fixed point samples
+    int64_t d_period_start_rem;     // fixed point samples
+    double d_code_phase_samples;
+    int d_current_prn_length_samples;
+};
+
+
+/*!
+ * \brief Arithmetic of the NCOs and discriminators of a tracking loop, given
+ * by the loop_arithmetic property of the tracking blocks
+ */
+enum Tracking_Loop_Arithmetic
+{
+    TRACKING_LOOP_FLOAT = 0,  //!< Tracking_Double_Loop
+    TRACKING_LOOP_FIXED = 1   //!< Tracking_Fixed_Point_Loop
+};
+
+/*!
+ * \brief Parses "float" or "fixed". Returns false, and leaves \p arithmetic
+ * unchanged, for any other string.
+ */
+inline bool parse_tracking_loop_arithmetic(const std::string & name, Tracking_Loop_Arithmetic & arithmetic)
+{
+    if (name == "float")
+        {
+            arithmetic = TRACKING_LOOP_FLOAT;
+        }
+    else if (name == "fixed")
+        {
+            arithmetic = TRACKING_LOOP_FIXED;
+        }
+    else
+        {
+            return false;
+        }
+    return true;
+}
+
+
+/*!
+ * \brief Carrier wipe-off, correlators and code and carrier NCOs of a DLL +
+ * PLL tracking loop for \p Signal, taking samples of type \p Sample
+ * (std::complex<float> or lv_16sc_t). The NCOs and discriminators are the
+ * ones of the loop of the Tracking_Engine, chosen at run time by
+ * make_tracking_engine().
+ *
+ * For each code period, the block calls correlate(), runs the
+ * discriminators and loop filters on the correlator outputs, and passes
+ * the filtered carrier Doppler and code error to update(), which sets the
+ * length and the phases of the next period.
+ *
+ * With a pilot, the taps correlate the pilot code, and a prompt correlator
+ * on the data code comes first in the outputs, for the navigation symbols.
+ *
+ * set_monitor_taps() adds taps that sample the correlation peak, for the
+ * dumps. They are computed from the FFT correlation window of each period
+ * (cpu_multicorrelator::set_fft_correlation) and do not feed the loops.
+ */
+template <class Signal, class Sample>
+class Tracking_Engine_Base
+{
+public:
+    static constexpr int n_taps = Signal::n_taps;
+    static constexpr int code_samples = Signal::code_length_chips * Signal::samples_per_chip;
+
+    virtual ~Tracking_Engine_Base()
+    {
+        free_monitor();
+        d_correlator.free();
+        gnss_sdr_volk_gnsssdr_free(d_outs);
+        if (d_pilot_code != 0) gnss_sdr_volk_gnsssdr_free(d_pilot_code);
+        if (d_pilot_code_sample != 0) gnss_sdr_volk_gnsssdr_free(d_pilot_code_sample);
+        gnss_sdr_volk_gnsssdr_free(d_code_sample);
+        gnss_sdr_volk_gnsssdr_free(d_code);
+    }
+
+    //! See cpu_multicorrelator::set_fast_resampler. Ignored for 16-bit samples.
+    void set_fast_resampler(bool fast_resampler)
+    {
+        Tracking_Correlator<Sample>::set_fast_resampler(d_correlator, fast_resampler);
+    }
+
+    /*!
+     * \brief Adds \p n_monitor_taps taps, \p spacing_chips apart and centred
+     * on the prompt one, to correlate() from the next start(). Zero removes them.
+     */
+    void set_monitor_taps(int n_monitor_taps, float spacing_chips)
+    {
+        free_monitor();
+        if (n_monitor_taps <= 0) return;
+        d_n_monitor_taps = n_monitor_taps;
+        d_monitor_shifts.resize(n_monitor_taps);
+        for (int n = 0; n < n_monitor_taps; n++)
+            {
+                d_monitor_shifts[n] = static_cast<float>(Signal::samples_per_chip) * spacing_chips
+                        * (static_cast<float>(n) - 0.5f * static_cast<float>(n_monitor_taps - 1));
+            }
+        d_monitor_outs = static_cast<std::complex<float>*>(gnss_sdr_volk_gnsssdr_malloc(n_monitor_taps * sizeof(std::complex<float>), volk_gnsssdr_get_alignment()));
+        for (int n = 0; n < n_monitor_taps; n++)
+            {
+                d_monitor_outs[n] = std::complex<float>(0.0, 0.0);
+            }
+        if (not std::is_same<Sample, std::complex<float> >::value)
+            {
+                d_monitor_in = static_cast<std::complex<float>*>(gnss_sdr_volk_gnsssdr_malloc(d_max_length_samples * sizeof(std::complex<float>), volk_gnsssdr_get_alignment()));
+            }
+        d_monitor.init(d_max_length_samples, n_monitor_taps);
+        d_monitor.set_fft_correlation(true);
+    }
+
+    //! Buffer of code_samples samples where the block writes the local code before start()
+    std::complex<float>* local_code() { return d_code; }
+
+    //! Same as local_code(), for the pilot code. Null without a pilot.
+    std::complex<float>* pilot_code() { return d_pilot_code; }
+
+    //! Shifts of the taps [local code samples], e.g. for a multichannel_correlator
+    const float* shifts() const { return d_shifts; }
+
+    /*!
+     * \brief Starts tracking the local code with a carrier Doppler of
+     * \p doppler_hz, from the code phase \p code_phase_samples
+     */
+    void start(double doppler_hz, double code_phase_samples)
+    {
+        if (d_pilot)
+            {
+                Tracking_Correlator<Sample>::set_code(d_correlator, code_samples, d_code, d_code_sample, &d_data_shift);
+                Tracking_Correlator<Sample>::set_pilot_code(d_correlator, code_samples, d_pilot_code, d_pilot_code_sample, d_shifts);
+            }
+        else
+            {
+                Tracking_Correlator<Sample>::set_code(d_correlator, code_samples, d_code, d_code_sample, d_shifts);
+            }
+        if (d_n_monitor_taps > 0)
+            {
+                d_monitor.set_local_code_and_taps(code_samples, d_pilot ? d_pilot_code : d_code, d_monitor_shifts.data());
+            }
+        clear_outputs();
+        reset_loop(d_fs_in, doppler_hz, code_phase_samples);
+    }
+
+    //! Correlates the current_prn_length_samples() samples of \p in
+    void correlate(const Sample* in)
+    {
+        d_correlator.set_input_output_vectors(d_outs, in);
+        d_correlator.Carrier_wipeoff_multicorrelator_resampler(rem_carr_phase_rad(),
+                carrier_phase_step_rad(),
+                rem_code_phase_chips(),
+                code_phase_step_chips(),
+                current_prn_length_samples());
+        correlate_monitor(in);
+    }
+
+    /*!
+     * \brief Computes the monitor taps of the period in \p in, if any. Only
+     * for blocks whose taps are correlated elsewhere, e.g. by a
+     * multichannel_correlator; correlate() already does it.
+     */
+    void correlate_monitor(const Sample* in)
+    {
+        if (d_n_monitor_taps == 0) return;
+        d_monitor.set_input_output_vectors(d_monitor_outs,
+                Tracking_Correlator<Sample>::float_samples(in, d_monitor_in, current_prn_length_samples()));
+        d_monitor.Carrier_wipeoff_multicorrelator_resampler(rem_carr_phase_rad(),
+                carrier_phase_step_rad(),
+                rem_code_phase_chips(),
+                code_phase_step_chips(),
+                current_prn_length_samples());
+    }
+
+    //! PLL discriminator on the prompt output of the last correlate() [cycles]
+    virtual double carrier_error_cycles() const = 0;
+
+    //! DLL discriminator on the early and late outputs of the last correlate() [chips]
+    virtual double code_error_chips() const = 0;
+
+    /*!
+     * \brief Closes the period with the filtered carrier Doppler
+     * \p carrier_doppler_hz and the filtered code error \p code_error_filt_chips
+     * [chips/s], and sets the length and phases of the next one. The loop
+     * rounds them to its own precision.
+     */
+    virtual void update(double carrier_doppler_hz, double code_error_filt_chips) = 0;
+
+    //! Sets all the correlator outputs, and the monitor taps, to zero
+    void clear_outputs()
+    {
+        for (int n = 0; n < d_n_outs; n++)
+            {
+                d_outs[n] = std::complex<float>(0.0, 0.0);
+            }
+        for (int n = 0; n < d_n_monitor_taps; n++)
+            {
+                d_monitor_outs[n] = std::complex<float>(0.0, 0.0);
+            }
+    }
+
+    /*!
+     * \brief Correlator outputs: the data prompt, with a pilot, and the taps.
+     * The block may overwrite them, e.g. with correlations integrated over
+     * several periods, before running the discriminators.
+     */
+    std::complex<float>* outputs() { return d_outs; }
+    const std::complex<float>* outputs() const { return d_outs; }
+    int n_outputs() const { return d_n_outs; }
+    const std::complex<float>* taps() const { return d_taps; }
+    const std::complex<float> & prompt() const { return d_taps[Signal::prompt]; }
+    const std::complex<float> & early() const { return d_taps[Signal::early]; }
+    const std::complex<float> & late() const { return d_taps[Signal::late]; }
+
+    //! Prompt of the data code, for the navigation symbols
+    const std::complex<float> & data_prompt() const { return *d_data_prompt; }
+
+    //! Monitor taps of the last correlate(), from the earliest one (pilot code with a pilot)
+    int n_monitor_taps() const { return d_n_monitor_taps; }
+    const std::complex<float>* monitor_outputs() const { return d_monitor_outs; }
+
+    //! Correlation at every sample lag that the monitor taps were taken from
+    const Fft_Correlation_Window & monitor_window() const { return d_monitor.fft_correlation_window(); }
+
+    // Phases and steps that the next correlate() takes, e.g. for a multichannel_correlator
+    virtual double rem_carr_phase_rad() const = 0;
+    virtual double carrier_phase_step_rad() const = 0;
+    virtual double rem_code_phase_chips() const = 0;
+    virtual double code_phase_step_chips() const = 0;
+
+    virtual int current_prn_length_samples() const = 0;
+
+    /*!
+     * \brief Fraction of sample between the first sample of the period that
+     * update() closed and the start of its code period
+     */
+    virtual double period_start_rem_samples() const = 0;
+
+    //! Same as period_start_rem_samples(), for the next period
+    virtual double rem_code_phase_samples() const = 0;
+
+    virtual double carrier_doppler_hz() const = 0;
+    virtual double code_freq_chips() const = 0;
+    virtual double acc_carrier_phase_rad() const = 0;
+    virtual double acc_code_phase_secs() const = 0;
+    virtual double code_phase_samples() const = 0;
+
+protected:
+    /*!
+     * \brief Correlators for periods of up to \p max_length_samples samples,
+     * with the early and late taps \p early_late_space_chips from the prompt
+     * one, and the very early and very late ones \p very_early_late_space_chips.
+     * With \p pilot, the taps correlate the code in pilot_code().
+     */
+    Tracking_Engine_Base(long fs_in, unsigned int max_length_samples, float early_late_space_chips,
+            float very_early_late_space_chips, bool pilot)
+    {
+        d_fs_in = static_cast<double>(fs_in);
+        d_pilot = pilot;
+        d_n_outs = n_taps + (d_pilot ? 1 : 0);
+        d_code = static_cast<std::complex<float>*>(gnss_sdr_volk_gnsssdr_malloc(code_samples * sizeof(std::complex<float>), volk_gnsssdr_get_alignment()));
+        d_code_sample = static_cast<Sample*>(gnss_sdr_volk_gnsssdr_malloc(code_samples * sizeof(Sample), volk_gnsssdr_get_alignment()));
+        d_pilot_code = 0;
+        d_pilot_code_sample = 0;
+        if (d_pilot)
+            {
+                d_pilot_code = static_cast<std::complex<float>*>(gnss_sdr_volk_gnsssdr_malloc(code_samples * sizeof(std::complex<float>), volk_gnsssdr_get_alignment()));
+                d_pilot_code_sample = static_cast<Sample*>(gnss_sdr_volk_gnsssdr_malloc(code_samples * sizeof(Sample), volk_gnsssdr_get_alignment()));
+            }
+        d_outs = static_cast<std::complex<float>*>(gnss_sdr_volk_gnsssdr_malloc(d_n_outs * sizeof(std::complex<float>), volk_gnsssdr_get_alignment()));
+        d_taps = d_outs + (d_pilot ? 1 : 0);
+        d_data_prompt = d_pilot ? d_outs : d_taps + Signal::prompt;
+        for (int n = 0; n < n_taps; n++)
+            {
+                d_shifts[n] = static_cast<float>(Signal::samples_per_chip) * (Signal::tap_offset(n) * early_late_space_chips
+                        + Signal::tap_offset_very(n) * very_early_late_space_chips);
+            }
+        d_data_shift = 0.0;
+        d_max_length_samples = max_length_samples;
+        d_n_monitor_taps = 0;
+        d_monitor_outs = 0;
+        d_monitor_in = 0;
+        if (d_pilot)
+            {
+                d_correlator.init(max_length_samples, 1, n_taps);
+            }
+        else
+            {
+                d_correlator.init(max_length_samples, n_taps);
+            }
+        clear_outputs();
+    }
+
+    //! Resets the NCOs of the loop, at start()
+    virtual void reset_loop(double fs_in, double doppler_hz, double code_phase_samples) = 0;
+
+    double d_fs_in;
+
+private:
+    Tracking_Engine_Base(const Tracking_Engine_Base &) = delete;
+    Tracking_Engine_Base & operator=(const Tracking_Engine_Base &) = delete;
+
+    void free_monitor()
+    {
+        if (d_n_monitor_taps == 0) return;
+        d_monitor.free();
+        gnss_sdr_volk_gnsssdr_free(d_monitor_outs);
+        if (d_monitor_in != 0) gnss_sdr_volk_gnsssdr_free(d_monitor_in);
+        d_monitor_outs = 0;
+        d_monitor_in = 0;
+        d_n_monitor_taps = 0;
+    }
+
+    bool d_pilot;
+    typename Tracking_Correlator<Sample>::type d_correlator;
+    std::complex<float>* d_code;
+    Sample* d_code_sample;      // local code converted to the sample type
+    std::complex<float>* d_pilot_code;
+    Sample* d_pilot_code_sample;
+    std::complex<float>* d_outs;
+    std::complex<float>* d_taps;
+    std::complex<float>* d_data_prompt;
+    int d_n_outs;
+    float d_shifts[n_taps];     // the correlator keeps a pointer to them
+    float d_data_shift;
+    unsigned int d_max_length_samples;
+
+    // monitor taps, see set_monitor_taps()
+    cpu_multicorrelator d_monitor;
+    int d_n_monitor_taps;
+    std::vector<float> d_monitor_shifts;
+    std::complex<float>* d_monitor_outs;
+    std::complex<float>* d_monitor_in;  // 16-bit samples converted for d_monitor
+};
+
+
+/*!
+ * \brief Tracking_Engine_Base with the NCOs and discriminators of \p Loop
+ * (Tracking_Double_Loop or Tracking_Fixed_Point_Loop)
+ */
+template <class Signal, class Sample, class Loop = Tracking_Double_Loop<Signal> >
+class Tracking_Engine final : public Tracking_Engine_Base<Signal, Sample>
+{
+public:
+    //! Precision of the discriminators and of the arguments of update() in the loop
+    typedef typename Loop::real real;
+
+    //! See Tracking_Engine_Base
+    Tracking_Engine(long fs_in, unsigned int max_length_samples, float early_late_space_chips,
+            float very_early_late_space_chips = 0.0, bool pilot = false) :
+                Tracking_Engine_Base<Signal, Sample>(fs_in, max_length_samples, early_late_space_chips,
+                        very_early_late_space_chips, pilot)
+    {
+        d_loop.reset(this->d_fs_in, 0.0, 0.0);
+    }
+
+    double carrier_error_cycles() const override { return Loop::carrier_error_cycles(this->prompt()); }
+    double code_error_chips() const override { return Loop::code_error_chips(this->early(), this->late()); }
+
+    void update(double carrier_doppler_hz, double code_error_filt_chips) override
+    {
+        d_loop.update(static_cast<real>(carrier_doppler_hz), static_cast<real>(code_error_filt_chips));
+    }
+
+    double rem_carr_phase_rad() const override { return d_loop.rem_carr_phase_rad(); }
+    double carrier_phase_step_rad() const override { return d_loop.carrier_phase_step_rad(); }
+    double rem_code_phase_chips() const override { return d_loop.rem_code_phase_chips(); }
+    double code_phase_step_chips() const override { return d_loop.code_phase_step_chips(); }
+    int current_prn_length_samples() const override { return d_loop.current_prn_length_samples(); }
+    double period_start_rem_samples() const override { return d_loop.period_start_rem_samples(); }
+    double rem_code_phase_samples() const override { return d_loop.rem_code_phase_samples(); }
+    double carrier_doppler_hz() const override { return d_loop.carrier_doppler_hz(); }
+    double code_freq_chips() const override { return d_loop.code_freq_chips(); }
+    double acc_carrier_phase_rad() const override { return d_loop.acc_carrier_phase_rad(); }
+    double acc_code_phase_secs() const override { return d_loop.acc_code_phase_secs(); }
+    double code_phase_samples() const override { return d_loop.code_phase_samples(); }
+
+private:
+    void reset_loop(double fs_in, double doppler_hz, double code_phase_samples) override
+    {
+        d_loop.reset(fs_in, doppler_hz, code_phase_samples);
+    }
+
+    // code and carrier NCOs
+    Loop d_loop;
+};
+
+
+/*!
+ * \brief Tracking_Engine of \p Signal for \p Sample samples with the loop of
+ * \p arithmetic; same arguments as the Tracking_Engine constructor
+ */
+template <class Signal, class Sample>
+Tracking_Engine_Base<Signal, Sample>* make_tracking_engine(Tracking_Loop_Arithmetic arithmetic,
+        long fs_in, unsigned int max_length_samples, float early_late_space_chips,
+        float very_early_late_space_chips = 0.0, bool pilot = false)
+{
+    if (arithmetic == TRACKING_LOOP_FIXED)
+        {
+            return new Tracking_Engine<Signal, Sample, Tracking_Fixed_Point_Loop<Signal> >(fs_in, max_length_samples,
+                    early_late_space_chips, very_early_late_space_chips, pilot);
+        }
+    return new Tracking_Engine<Signal, Sample, Tracking_Double_Loop<Signal> >(fs_in, max_length_samples,
+            early_late_space_chips, very_early_late_space_chips, pilot);
+}
+
+#endif /* GNSS_SDR_TRACKING_ENGINE_H_ */
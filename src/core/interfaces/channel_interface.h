@@ -54,6 +54,8 @@ public:
     virtual Gnss_Signal get_signal() const = 0;
     virtual void start_acquisition() = 0;
     virtual void set_signal(const Gnss_Signal&) = 0;
+    //! Stops the tracking, as a loss of lock. Returns false if the channel is not tracking or cannot be stopped
+    virtual bool stop_tracking() = 0;
 };
 
 #endif /* GNSS_SDR_CHANNEL_INTERFACE_H_ */
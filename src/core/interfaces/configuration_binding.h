@@ -0,0 +1,97 @@
+/*!
+ * \file configuration_binding.h
+ * \brief Loads a whole struct of block parameters from the configuration
+ *  in one call.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * An adapter describes its parameters once, as a static binding of property
+ * names to the members of a struct and their defaults, and then loads them
+ * all with load(configuration, role, params). The role prefix is built once
+ * per call instead of once per property.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CONFIGURATION_BINDING_H_
+#define GNSS_SDR_CONFIGURATION_BINDING_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "configuration_interface.h"
+
+/*!
+ * \brief Binding of the properties of a role to the members of \p Params.
+ *
+ * The members must have one of the types of ConfigurationInterface::property().
+ * The fields are loaded in the order they were added, so the default of a
+ * field can be another field added before it.
+ */
+template<typename Params>
+class Configuration_Binding
+{
+public:
+    //! Binds role.name to \p member, with a fixed default
+    template<typename T>
+    Configuration_Binding& field(const std::string& name, T Params::* member, T default_value)
+    {
+        d_fields.push_back([name, member, default_value](ConfigurationInterface* configuration,
+                std::string& property_name, size_t prefix_length, Params& params)
+                {
+                    property_name.replace(prefix_length, std::string::npos, name);
+                    params.*member = configuration->property(property_name, default_value);
+                });
+        return *this;
+    }
+
+    //! Binds role.name to \p member, defaulting to the value already loaded in \p default_member
+    template<typename T>
+    Configuration_Binding& field(const std::string& name, T Params::* member, T Params::* default_member)
+    {
+        d_fields.push_back([name, member, default_member](ConfigurationInterface* configuration,
+                std::string& property_name, size_t prefix_length, Params& params)
+                {
+                    property_name.replace(prefix_length, std::string::npos, name);
+                    params.*member = configuration->property(property_name, params.*default_member);
+                });
+        return *this;
+    }
+
+    //! Reads every bound property of \p role into \p params
+    void load(ConfigurationInterface* configuration, const std::string& role, Params& params) const
+    {
+        std::string property_name = role + ".";
+        size_t prefix_length = property_name.size();
+        for (size_t i = 0; i < d_fields.size(); i++)
+            {
+                d_fields[i](configuration, property_name, prefix_length, params);
+            }
+    }
+
+private:
+    std::vector<std::function<void(ConfigurationInterface*, std::string&, size_t, Params&)> > d_fields;
+};
+
+#endif /* GNSS_SDR_CONFIGURATION_BINDING_H_ */
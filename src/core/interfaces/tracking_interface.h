@@ -37,6 +37,7 @@
 #ifndef GNSS_SDR_TRACKING_INTERFACE_H_
 #define GNSS_SDR_TRACKING_INTERFACE_H_
 
+#include <string>
 #include "gnss_block_interface.h"
 #include "gnss_synchro.h"
 
@@ -57,6 +58,27 @@ public:
     virtual void start_tracking() = 0;
     virtual void set_gnss_synchro(Gnss_Synchro* gnss_synchro) = 0;
     virtual void set_channel(unsigned int channel) = 0;
+
+    /*!
+     * \brief Stops the tracking of the channel, which is reported as a loss
+     * of lock. Returns false if the implementation cannot be stopped.
+     */
+    virtual bool stop_tracking()
+    {
+        return false;
+    }
+
+    //! Stream port of this channel in the blocks, which may be shared by several channels
+    virtual int port()
+    {
+        return 0;
+    }
+
+    //! Name of the message port \p name of this channel in the blocks
+    virtual std::string message_port(const std::string & name)
+    {
+        return name;
+    }
 };
 
 #endif /* GNSS_SDR_TRACKING_INTERFACE_H_ */
@@ -583,3 +583,33 @@ bool gnss_sdr_supl_client::save_ref_location_map_xml(const std::string file_name
             return false;
         }
 }
+
+bool gnss_sdr_supl_client::save_assistance_binary(const std::string file_name)
+{
+    if (gps_ephemeris_map.empty())
+        {
+            LOG(WARNING) << "Failed to save the assistance, the ephemeris map is empty";
+            return false;
+        }
+    if (!Gnss_Binary_Archive::save(file_name, "supl_assistance", *this))
+        {
+            return false;
+        }
+    LOG(INFO) << "Saved the assistance with " << gps_ephemeris_map.size() << " ephemeris";
+    return true;
+}
+
+bool gnss_sdr_supl_client::load_assistance_binary(const std::string file_name)
+{
+    gps_ephemeris_map.clear();
+    gps_almanac_map.clear();
+    if (!Gnss_Binary_Archive::load(file_name, "supl_assistance", *this))
+        {
+            gps_ephemeris_map.clear();
+            gps_almanac_map.clear();
+            return false;
+        }
+    LOG(INFO) << "Loaded the assistance with " << gps_ephemeris_map.size() << " ephemeris and "
+              << gps_almanac_map.size() << " almanacs";
+    return true;
+}
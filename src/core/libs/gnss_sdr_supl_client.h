@@ -41,6 +41,7 @@
 #include <boost/archive/xml_oarchive.hpp>
 #include <boost/archive/xml_iarchive.hpp>
 #include <boost/serialization/map.hpp>
+#include <boost/serialization/access.hpp>
 #include <glog/logging.h>
 extern "C" {
 #include "supl.h"
@@ -53,6 +54,7 @@ extern "C" {
 #include "gps_acq_assist.h"
 #include "gps_ref_time.h"
 #include "gps_ref_location.h"
+#include "gnss_binary_archive.h"
 
 /*!
  * \brief class that implements a C++ interface to external Secure User Location Protocol (SUPL) client library..
@@ -69,6 +71,20 @@ private:
     supl_ctx_t ctx;
     // assistance data
     supl_assist_t assist;
+
+    // the assistance stored in the binary files
+    friend class boost::serialization::access;
+    template<class Archive>
+    void serialize(Archive& archive, const unsigned int version)
+    {
+        if(version){};
+        archive & gps_ephemeris_map;
+        archive & gps_almanac_map;
+        archive & gps_iono;
+        archive & gps_time;
+        archive & gps_utc;
+        archive & gps_ref_loc;
+    }
 public:
     // SUPL SERVER INFO
     std::string server_name;
@@ -161,6 +177,18 @@ public:
     bool save_ref_location_map_xml(std::string file_name,
                                    std::map<int, Gps_Ref_Location> ref_location_map);
 
+    /*!
+     * \brief Save the ephemeris and almanac maps, iono, utc model, ref time and
+     * ref location to one binary file, much faster to load than the XML files.
+     * The XML files are still the ones to exchange data between machines.
+     */
+    bool save_assistance_binary(const std::string file_name);
+
+    /*!
+     * \brief Read the assistance saved by save_assistance_binary()
+     */
+    bool load_assistance_binary(const std::string file_name);
+
     /*
      * Prints SUPL data to std::cout. Use it for debug purposes only.
      */
@@ -0,0 +1,372 @@
+/*!
+ * \file batch_processor.cc
+ * \brief Faster than real time post-processing of a capture file, split in
+ * time segments processed in parallel.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "batch_processor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <boost/filesystem.hpp>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include "control_thread.h"
+#include "file_configuration.h"
+#include "rinex_stitcher.h"
+
+using google::LogMessage;
+
+DEFINE_int32(batch_segments, 0, "If greater than 1, the capture file is split in this number of time segments, processed in parallel by independent receivers");
+DEFINE_int32(batch_jobs, 0, "Maximum number of segments processed at the same time in batch mode (0: one per processor core)");
+DEFINE_double(batch_overlap, 60.0, "Time processed before the start of each segment in batch mode, to acquire the satellites and decode their ephemeris [s]");
+DEFINE_string(batch_dir, "./batch", "Folder of the outputs of each segment in batch mode");
+
+DECLARE_string(config_file);
+DECLARE_string(signal_source);
+
+
+bool BatchProcessor::enabled()
+{
+    return FLAGS_batch_segments > 1;
+}
+
+
+BatchProcessor::BatchProcessor()
+    : BatchProcessor(FLAGS_config_file, std::max(FLAGS_batch_segments, 1),
+            FLAGS_batch_jobs > 0 ? FLAGS_batch_jobs : std::max(std::thread::hardware_concurrency(), 1u),
+            std::max(FLAGS_batch_overlap, 0.0), FLAGS_batch_dir)
+{}
+
+
+BatchProcessor::BatchProcessor(const std::string & config_file, unsigned int segments, unsigned int jobs,
+        double overlap_s, const std::string & batch_dir)
+{
+    config_file_ = config_file;
+    segments_ = std::max(segments, 1u);
+    jobs_ = std::max(jobs, 1u);
+    overlap_s_ = overlap_s;
+    batch_dir_ = batch_dir;
+    items_per_second_ = 0.0;
+    items_per_sample_ = 1;
+    seconds_to_skip_ = 0.0;
+}
+
+
+BatchProcessor::~BatchProcessor()
+{}
+
+
+std::vector<BatchProcessor::Segment> BatchProcessor::plan(unsigned long long items, unsigned int segments,
+        unsigned long long overlap_items, unsigned int items_per_sample)
+{
+    std::vector<Segment> result;
+    const unsigned long long samples = items / items_per_sample;
+    if (segments == 0 || samples < segments)
+        {
+            return result;
+        }
+    for (unsigned int k = 0; k < segments; k++)
+        {
+            // nominal limits, in whole samples
+            const unsigned long long begin = samples * k / segments * items_per_sample;
+            const unsigned long long end = samples * (k + 1) / segments * items_per_sample;
+            Segment segment;
+            segment.start = begin > overlap_items ? (begin - overlap_items) / items_per_sample * items_per_sample : 0;
+            segment.items = end - segment.start;
+            result.push_back(segment);
+        }
+    return result;
+}
+
+
+bool BatchProcessor::read_capture()
+{
+    const std::string implementation = configuration_->property("SignalSource.implementation", std::string("File_Signal_Source"));
+    if (implementation.compare("File_Signal_Source") != 0 && implementation.compare("Mmap_File_Signal_Source") != 0)
+        {
+            std::cout << "Batch mode needs a File_Signal_Source or a Mmap_File_Signal_Source, not a "
+                      << implementation << std::endl;
+            return false;
+        }
+    filename_ = configuration_->property("SignalSource.filename", std::string("./example_capture.dat"));
+    if (FLAGS_signal_source.compare("-") != 0) filename_ = FLAGS_signal_source;
+
+    const std::string item_type = configuration_->property("SignalSource.item_type", std::string("short"));
+    unsigned int item_size = 8;  // gr_complex, also for unknown types as in the file signal sources
+    items_per_sample_ = 1;
+    if (item_type.compare("float") == 0)
+        {
+            item_size = 4;
+        }
+    else if (item_type.compare("short") == 0 || item_type.compare("ishort") == 0)
+        {
+            item_size = 2;
+        }
+    else if (item_type.compare("byte") == 0 || item_type.compare("ibyte") == 0)
+        {
+            item_size = 1;
+        }
+    if (item_type.compare("ishort") == 0 || item_type.compare("ibyte") == 0)
+        {
+            items_per_sample_ = 2;
+        }
+    const double sampling_frequency = configuration_->property("SignalSource.sampling_frequency", 0.0);
+    if (sampling_frequency <= 0.0)
+        {
+            std::cout << "Batch mode needs the SignalSource.sampling_frequency of the capture" << std::endl;
+            return false;
+        }
+    items_per_second_ = sampling_frequency * items_per_sample_;
+    seconds_to_skip_ = std::max(configuration_->property("SignalSource.seconds_to_skip", 0.0), 0.0);
+    const unsigned long long header_size = configuration_->property("SignalSource.header_size", 0);
+    const unsigned long long samples = std::strtoull(configuration_->property("SignalSource.samples", std::string("0")).c_str(), nullptr, 10);
+
+    boost::system::error_code ec;
+    const unsigned long long size = boost::filesystem::file_size(filename_, ec);
+    if (ec)
+        {
+            std::cout << "Batch mode cannot read the capture file " << filename_ << std::endl;
+            return false;
+        }
+    filename_ = boost::filesystem::absolute(filename_).string();
+    // same items skipped than the file signal sources
+    const unsigned long long skipped_items = static_cast<long>(seconds_to_skip_ * sampling_frequency) * items_per_sample_ + header_size;
+    unsigned long long items = size / item_size > skipped_items ? size / item_size - skipped_items : 0;
+    if (samples > 0)
+        {
+            items = std::min(items, samples);
+        }
+    else
+        {
+            // as the file signal sources, do not process the last ms
+            const unsigned long long margin = std::ceil(0.002 * sampling_frequency);
+            items = items > margin ? items - margin : 0;
+        }
+    const unsigned long long overlap_items = std::llround(overlap_s_ * sampling_frequency) * items_per_sample_;
+    plan_ = plan(items, segments_, overlap_items, items_per_sample_);
+    if (plan_.empty())
+        {
+            std::cout << "The capture file " << filename_ << " is too short to be split in "
+                      << segments_ << " segments" << std::endl;
+            return false;
+        }
+    return true;
+}
+
+
+std::string BatchProcessor::segment_dir(unsigned int index) const
+{
+    std::ostringstream dir;
+    dir << batch_dir_ << "/segment_" << std::setw(3) << std::setfill('0') << index;
+    return dir.str();
+}
+
+
+bool BatchProcessor::run()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    const long long int begin = tv.tv_sec * 1000000 + tv.tv_usec;
+
+    configuration_ = std::make_shared<FileConfiguration>(config_file_);
+    if (!read_capture())
+        {
+            return false;
+        }
+    std::cout << std::setprecision(16);
+    for (unsigned int k = 0; k < plan_.size(); k++)
+        {
+            boost::system::error_code ec;
+            boost::filesystem::create_directories(segment_dir(k), ec);
+            if (ec)
+                {
+                    std::cout << "Could not create the " << segment_dir(k) << " folder" << std::endl;
+                    return false;
+                }
+            std::cout << "Segment " << k << ": from " << seconds_to_skip_ + plan_[k].start / items_per_second_
+                      << " [s], " << plan_[k].items / items_per_second_ << " [s], outputs in " << segment_dir(k) << std::endl;
+        }
+
+    // the receivers run in child processes: the blocks of a receiver share process-wide state
+    std::map<pid_t, unsigned int> running;
+    unsigned int next = 0;
+    unsigned int failed = 0;
+    while (next < plan_.size() || !running.empty())
+        {
+            while (next < plan_.size() && running.size() < jobs_)
+                {
+                    std::cout.flush();
+                    pid_t pid = fork();
+                    if (pid == 0)
+                        {
+                            run_segment(next);
+                        }
+                    if (pid < 0)
+                        {
+                            LOG(ERROR) << "Cannot start the receiver of segment " << next;
+                            failed++;
+                        }
+                    else
+                        {
+                            running[pid] = next;
+                        }
+                    next++;
+                }
+            if (running.empty())
+                {
+                    break;
+                }
+            int status = 0;
+            const pid_t pid = waitpid(-1, &status, 0);
+            if (pid < 0)
+                {
+                    LOG(ERROR) << "waitpid failed, " << running.size() << " receivers left";
+                    return false;
+                }
+            std::map<pid_t, unsigned int>::iterator it = running.find(pid);
+            if (it == running.end())
+                {
+                    continue;
+                }
+            if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+                {
+                    std::cout << "Segment " << it->second << " processed" << std::endl;
+                }
+            else
+                {
+                    std::cout << "The receiver of segment " << it->second << " failed, see "
+                              << segment_dir(it->second) << "/gnss-sdr.log" << std::endl;
+                    failed++;
+                }
+            running.erase(it);
+        }
+
+    const bool stitched = failed == 0 && stitch();
+    gettimeofday(&tv, NULL);
+    const long long int end = tv.tv_sec * 1000000 + tv.tv_usec;
+    std::cout << "Total batch processing time "
+              << (static_cast<double>(end - begin)) / 1000000.0
+              << " [seconds]" << std::endl;
+    return stitched;
+}
+
+
+void BatchProcessor::run_segment(unsigned int index)
+{
+    int result = 0;
+    const std::string dir = segment_dir(index);
+    if (chdir(dir.c_str()) != 0 || std::freopen("gnss-sdr.log", "w", stdout) == nullptr)
+        {
+            _exit(1);
+        }
+    dup2(fileno(stdout), fileno(stderr));
+
+    std::ostringstream seconds_to_skip;
+    seconds_to_skip << std::setprecision(17) << seconds_to_skip_ + plan_[index].start / items_per_second_;
+    configuration_->set_property("SignalSource.filename", filename_);
+    configuration_->set_property("SignalSource.seconds_to_skip", seconds_to_skip.str());
+    configuration_->set_property("SignalSource.samples", std::to_string(plan_[index].items));
+    configuration_->set_property("SignalSource.repeat", "false");
+    FLAGS_signal_source = filename_;
+    try
+    {
+            ControlThread control_thread(configuration_);
+            control_thread.run();
+    }
+    catch (const std::exception & e)
+    {
+            std::cout << "Exception in the receiver of segment " << index << ": " << e.what() << std::endl;
+            result = 1;
+    }
+    std::cout.flush();
+    std::fflush(stdout);
+    _exit(result);
+}
+
+
+bool BatchProcessor::stitch()
+{
+    // RINEX file types, as named by Rinex_Printer::createFilename()
+    const std::string types = "ONLP";
+    bool ok = true;
+    for (unsigned int t = 0; t < types.size(); t++)
+        {
+            std::vector<std::string> inputs;
+            for (unsigned int k = 0; k < plan_.size(); k++)
+                {
+                    // the files of a segment in the order they were written (there can be more than one with rotation)
+                    std::vector<std::pair<std::time_t, std::string> > files;
+                    boost::system::error_code ec;
+                    for (boost::filesystem::directory_iterator it(segment_dir(k), ec), end; !ec && it != end; it.increment(ec))
+                        {
+                            const std::string name = it->path().filename().string();
+                            const std::string extension = it->path().extension().string();
+                            if (name.compare(0, 4, "GSDR") == 0 && extension.size() == 4 && extension[3] == types[t]
+                                    && boost::filesystem::file_size(it->path(), ec) > 0)
+                                {
+                                    files.push_back(std::make_pair(boost::filesystem::last_write_time(it->path(), ec), it->path().string()));
+                                }
+                        }
+                    std::stable_sort(files.begin(), files.end());
+                    for (unsigned int f = 0; f < files.size(); f++)
+                        {
+                            inputs.push_back(files[f].second);
+                        }
+                }
+            if (inputs.empty())
+                {
+                    continue;
+                }
+            const std::string output = boost::filesystem::path(inputs[0]).filename().string();
+            const bool stitched = types[t] == 'O' ? Rinex_Stitcher::stitch_observations(inputs, output)
+                    : Rinex_Stitcher::stitch_navigation(inputs, output);
+            if (stitched)
+                {
+                    std::cout << "RINEX file " << output << " joined from " << inputs.size() << " files" << std::endl;
+                }
+            else
+                {
+                    std::cout << "The RINEX files of type " << types[t] << " could not be joined" << std::endl;
+                    ok = false;
+                }
+        }
+    std::cout << "The other outputs of each segment are in " << batch_dir_ << std::endl;
+    return ok;
+}
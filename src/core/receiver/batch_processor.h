@@ -0,0 +1,110 @@
+/*!
+ * \file batch_processor.h
+ * \brief Faster than real time post-processing of a capture file, split in
+ * time segments processed in parallel.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * A single receiver processes a recorded file at whatever speed its
+ * slowest channel allows, and each of its blocks runs in a single thread.
+ * With --batch_segments=N (N > 1), the capture given in the configuration
+ * of a File_Signal_Source or Mmap_File_Signal_Source is split in N time
+ * segments, and each segment is processed by an independent receiver in a
+ * child process, --batch_jobs of them at the same time. Each segment starts
+ * --batch_overlap seconds before its nominal start, so that the satellites
+ * are acquired and their ephemeris decoded by the time the epochs of the
+ * segment are reached. Each receiver writes its outputs in its own folder,
+ * <batch_dir>/segment_NNN, where the relative paths of the configuration
+ * file are also resolved. The RINEX files of the segments are then joined
+ * (see rinex_stitcher.h) in the current folder.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_BATCH_PROCESSOR_H_
+#define GNSS_SDR_BATCH_PROCESSOR_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class FileConfiguration;
+
+class BatchProcessor
+{
+public:
+    // Items of the file processed by one receiver
+    struct Segment
+    {
+        unsigned long long start;  // first item, from the first item to be processed
+        unsigned long long items;
+    };
+
+    //! True when the --batch_segments flag asks for batch processing
+    static bool enabled();
+
+    //! Takes the configuration file and the parameters from the command line flags
+    BatchProcessor();
+
+    BatchProcessor(const std::string & config_file, unsigned int segments, unsigned int jobs,
+            double overlap_s, const std::string & batch_dir);
+
+    ~BatchProcessor();
+
+    /*!
+     * \brief Processes all the segments and joins their RINEX files.
+     * Returns false if the capture cannot be split or a receiver failed.
+     */
+    bool run();
+
+    /*!
+     * \brief Splits items in segments of whole samples (groups of
+     * items_per_sample items), each one starting overlap_items before its
+     * nominal start, except the first one.
+     */
+    static std::vector<Segment> plan(unsigned long long items, unsigned int segments,
+            unsigned long long overlap_items, unsigned int items_per_sample);
+
+private:
+    bool read_capture();
+    void run_segment(unsigned int index);  // in the child process, does not return
+    std::string segment_dir(unsigned int index) const;
+    bool stitch();
+
+    std::string config_file_;
+    unsigned int segments_;
+    unsigned int jobs_;
+    double overlap_s_;
+    std::string batch_dir_;
+    std::shared_ptr<FileConfiguration> configuration_;
+
+    // the capture, read at run()
+    std::string filename_;
+    double items_per_second_;
+    unsigned int items_per_sample_;
+    double seconds_to_skip_;
+    std::vector<Segment> plan_;
+};
+
+#endif
@@ -1,11 +1,11 @@
 /*!
  * \file concurrent_map.h
- * \brief Interface of a thread-safe std::map
+ * \brief Interface of a lock-free map of integer keys
  * \author Javier Arribas, 2011. jarribas(at)cttc.es
  *
  * -------------------------------------------------------------------------
  *
- * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
  *
  * GNSS-SDR is a software defined Global Navigation
  *          Satellite Systems receiver
@@ -31,72 +31,139 @@
 #ifndef GNSS_SDR_CONCURRENT_MAP_H
 #define GNSS_SDR_CONCURRENT_MAP_H
 
+#include <atomic>
+#include <climits>
+#include <cstddef>
 #include <map>
+#include <memory>
 #include <utility>
-#include <boost/thread/mutex.hpp>
 
 template<typename Data>
 
 
 /*!
- * \brief This class implements a thread-safe std::map
+ * \brief This class implements a thread-safe map of integer keys
+ * (typically PRNs) for any number of writers and readers
  *
+ * The keys live in a bounded open addressing table: a writer claims the
+ * slot of a new key with a compare-and-swap, and keys are never removed.
+ * Each value is published as a std::shared_ptr<const Data> with the atomic
+ * shared_ptr operations, so a write replaces the value of its key without
+ * blocking the readers of the others, and a reader gets a consistent copy.
  */
 class concurrent_map
 {
-    typedef typename std::map<int,Data>::iterator Data_iterator; // iterator is scope dependent
 private:
-    std::map<int,Data> the_map;
-    boost::mutex the_mutex;
+    struct Slot
+    {
+        std::atomic<int> key;
+        std::shared_ptr<const Data> data;
+    };
+
+    static const int empty_key = INT_MIN;
+
+    size_t the_mask;
+    std::unique_ptr<Slot[]> the_slots;
+    std::atomic<size_t> the_size;
+
+    // The slot of key, claimed for it if insert is true, or 0
+    Slot* find_slot(int key, bool insert)
+    {
+        size_t index = static_cast<size_t>(static_cast<unsigned int>(key)) & the_mask;
+        for(size_t probe = 0; probe <= the_mask; probe++, index = (index + 1) & the_mask)
+            {
+                int slot_key = the_slots[index].key.load(std::memory_order_acquire);
+                if(slot_key == key)
+                    {
+                        return &the_slots[index];
+                    }
+                if(slot_key == empty_key)
+                    {
+                        if(!insert) return 0;
+                        if(the_slots[index].key.compare_exchange_strong(slot_key, key, std::memory_order_acq_rel)
+                                or slot_key == key)
+                            {
+                                return &the_slots[index];
+                            }
+                    }
+            }
+        return 0;
+    }
+
+    bool store(int key, std::shared_ptr<const Data> value)
+    {
+        Slot* slot = find_slot(key, true);
+        if(slot == 0) return false; // the table is full
+        if(!std::atomic_exchange(&slot->data, value))
+            {
+                the_size.fetch_add(1);
+            }
+        return true;
+    }
+
 public:
-    void write(int key, Data const& data)
+    //! The capacity, in keys, is rounded up to a power of two
+    explicit concurrent_map(size_t capacity = 128) : the_size(0)
     {
-        boost::mutex::scoped_lock lock(the_mutex);
-        Data_iterator data_iter;
-        data_iter = the_map.find(key);
-        if (data_iter != the_map.end())
+        size_t size = 2;
+        while(size < capacity)
             {
-                data_iter->second = data; // update
+                size <<= 1;
             }
-        else
+        the_mask = size - 1;
+        the_slots.reset(new Slot[size]);
+        for(size_t i = 0; i < size; i++)
             {
-                the_map.insert(std::pair<int, Data>(key, data)); // insert SILENTLY fails if the item already exists in the map!
+                the_slots[i].key.store(empty_key, std::memory_order_relaxed);
             }
-        lock.unlock();
+    }
+
+    //! Inserts or updates the value of \p key. Returns false if the table is full.
+    bool write(int key, Data const& data)
+    {
+        return store(key, std::make_shared<const Data>(data));
+    }
+
+    bool write(int key, Data&& data)
+    {
+        return store(key, std::make_shared<const Data>(std::move(data)));
     }
 
     std::map<int,Data> get_map_copy()
     {
-        boost::mutex::scoped_lock lock(the_mutex);
-        std::map<int,Data> map_aux = the_map;
-        lock.unlock();
+        std::map<int,Data> map_aux;
+        for(size_t i = 0; i <= the_mask; i++)
+            {
+                const int key = the_slots[i].key.load(std::memory_order_acquire);
+                if(key == empty_key) continue;
+                std::shared_ptr<const Data> value = std::atomic_load(&the_slots[i].data);
+                if(value)
+                    {
+                        map_aux.insert(std::pair<int, Data>(key, *value));
+                    }
+            }
         return map_aux;
     }
 
     size_t size()
     {
-        boost::mutex::scoped_lock lock(the_mutex);
-        size_t size_ = the_map.size();
-        lock.unlock();
-        return size_;
+        return the_size.load();
     }
 
     bool read(int key, Data& p_data)
     {
-        boost::mutex::scoped_lock lock(the_mutex);
-        Data_iterator data_iter;
-        data_iter = the_map.find(key);
-        if (data_iter != the_map.end())
-            {
-                p_data = data_iter->second;
-                lock.unlock();
-                return true;
-            }
-        else
-            {
-                lock.unlock();
-                return false;
-            }
+        std::shared_ptr<const Data> value = read(key);
+        if(!value) return false;
+        p_data = *value;
+        return true;
+    }
+
+    //! The current value of \p key without copying it, or null
+    std::shared_ptr<const Data> read(int key)
+    {
+        Slot* slot = find_slot(key, false);
+        if(slot == 0) return std::shared_ptr<const Data>();
+        return std::atomic_load(&slot->data);
     }
 };
 
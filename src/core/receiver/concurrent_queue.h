@@ -1,11 +1,11 @@
 /*!
  * \file concurrent_queue.h
- * \brief Interface of a thread-safe std::queue
+ * \brief Interface of a bounded lock-free multi-producer, multi-consumer queue
  * \author Javier Arribas, 2011. jarribas(at)cttc.es
  *
  * -------------------------------------------------------------------------
  *
- * Copyright (C) 2010-2015  (see AUTHORS file for a list of contributors)
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
  *
  * GNSS-SDR is a software defined Global Navigation
  *          Satellite Systems receiver
@@ -31,60 +31,236 @@
 #ifndef GNSS_SDR_CONCURRENT_QUEUE_H
 #define GNSS_SDR_CONCURRENT_QUEUE_H
 
-#include <queue>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
 #include <boost/thread.hpp>
 
 template<typename Data>
 
 /*!
- * \brief This class implements a thread-safe std::queue
+ * \brief This class implements a thread-safe queue for any number of
+ * producers and consumers
  *
- * Thread-safe object queue which uses the library
- * boost_thread to perform MUTEX based on the code available at
- * http://www.justsoftwaresolutions.co.uk/threading/implementing-a-thread-safe-queue-using-condition-variables.html
+ * The queue is a bounded ring of cells, each one with a sequence number
+ * that tells whether it holds an item or free space for the current lap
+ * (D. Vyukov's bounded MPMC queue). Producers and consumers claim cells
+ * with a compare-and-swap of the write or read position, and move the
+ * items in and out of them, without any lock. The mutex and condition
+ * variable are only used to sleep in wait_and_pop(), or in push() when the
+ * queue is full, and are not touched while there is no thread sleeping.
  */
 class concurrent_queue
 {
 private:
-    std::queue<Data> the_queue;
-    mutable boost::mutex the_mutex;
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        Data data;
+    };
+
+    size_t the_mask;
+    std::unique_ptr<Cell[]> the_cells;
+    char pad0[64]; // the positions are written by different threads
+    std::atomic<size_t> the_enqueue_pos;
+    char pad1[64];
+    std::atomic<size_t> the_dequeue_pos;
+    char pad2[64];
+    std::atomic<unsigned int> the_waiters;
+    boost::mutex the_mutex;
     boost::condition_variable the_condition_variable;
+
+    template<typename T>
+    bool enqueue(T&& data)
+    {
+        size_t pos = the_enqueue_pos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while(true)
+            {
+                cell = &the_cells[pos & the_mask];
+                const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                const long dif = static_cast<long>(sequence) - static_cast<long>(pos);
+                if(dif == 0)
+                    {
+                        if(the_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                            {
+                                break;
+                            }
+                    }
+                else if(dif < 0)
+                    {
+                        return false; // full
+                    }
+                else
+                    {
+                        pos = the_enqueue_pos.load(std::memory_order_relaxed);
+                    }
+            }
+        cell->data = std::forward<T>(data);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool dequeue(Data& popped_value)
+    {
+        size_t pos = the_dequeue_pos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while(true)
+            {
+                cell = &the_cells[pos & the_mask];
+                const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                const long dif = static_cast<long>(sequence) - static_cast<long>(pos + 1);
+                if(dif == 0)
+                    {
+                        if(the_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                            {
+                                break;
+                            }
+                    }
+                else if(dif < 0)
+                    {
+                        return false; // empty
+                    }
+                else
+                    {
+                        pos = the_dequeue_pos.load(std::memory_order_relaxed);
+                    }
+            }
+        popped_value = std::move(cell->data);
+        cell->sequence.store(pos + the_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Wakes up the threads sleeping for an item or for free space, if any
+    void notify()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(the_waiters.load(std::memory_order_relaxed) > 0)
+            {
+                boost::mutex::scoped_lock lock(the_mutex);
+                the_condition_variable.notify_all();
+            }
+    }
+
+    template<typename T>
+    void push_or_wait(T&& data)
+    {
+        if(!enqueue(std::forward<T>(data)))
+            {
+                boost::mutex::scoped_lock lock(the_mutex);
+                the_waiters.fetch_add(1);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                while(!enqueue(std::forward<T>(data)))
+                    {
+                        the_condition_variable.wait(lock);
+                    }
+                the_waiters.fetch_sub(1);
+            }
+        notify();
+    }
+
 public:
+    //! The capacity is rounded up to a power of two
+    explicit concurrent_queue(size_t capacity = 1024) : the_enqueue_pos(0), the_dequeue_pos(0), the_waiters(0)
+    {
+        size_t size = 2;
+        while(size < capacity)
+            {
+                size <<= 1;
+            }
+        the_mask = size - 1;
+        the_cells.reset(new Cell[size]);
+        for(size_t i = 0; i < size; i++)
+            {
+                the_cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+    }
+
+    size_t capacity() const
+    {
+        return the_mask + 1;
+    }
+
+    //! Adds an item, waiting for free space if the queue is full
     void push(Data const& data)
     {
-        boost::mutex::scoped_lock lock(the_mutex);
-        the_queue.push(data);
-        lock.unlock();
-        the_condition_variable.notify_one();
+        push_or_wait(data);
+    }
+
+    void push(Data&& data)
+    {
+        push_or_wait(std::move(data));
     }
 
+    //! Adds an item if there is free space, and returns whether it did
+    bool try_push(Data const& data)
+    {
+        if(!enqueue(data)) return false;
+        notify();
+        return true;
+    }
+
+    bool try_push(Data&& data)
+    {
+        if(!enqueue(std::move(data))) return false;
+        notify();
+        return true;
+    }
+
+    //! Whether the queue was empty at the time of the call
     bool empty() const
     {
-        boost::mutex::scoped_lock lock(the_mutex);
-        return the_queue.empty();
+        const size_t pos = the_dequeue_pos.load(std::memory_order_acquire);
+        return the_cells[pos & the_mask].sequence.load(std::memory_order_acquire) != pos + 1;
     }
 
     bool try_pop(Data& popped_value)
     {
-        boost::mutex::scoped_lock lock(the_mutex);
-        if(the_queue.empty())
-            {
-                return false;
-            }
-        popped_value = the_queue.front();
-        the_queue.pop();
+        if(!dequeue(popped_value)) return false;
+        notify();
         return true;
     }
 
     void wait_and_pop(Data& popped_value)
     {
-        boost::mutex::scoped_lock lock(the_mutex);
-        while(the_queue.empty())
+        if(!dequeue(popped_value))
             {
-                the_condition_variable.wait(lock);
+                boost::mutex::scoped_lock lock(the_mutex);
+                the_waiters.fetch_add(1);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                while(!dequeue(popped_value))
+                    {
+                        the_condition_variable.wait(lock);
+                    }
+                the_waiters.fetch_sub(1);
             }
-        popped_value = the_queue.front();
-        the_queue.pop();
+        notify();
+    }
+
+    //! As wait_and_pop(), for at most \p timeout_ms milliseconds. Returns whether it got an item.
+    bool timed_wait_and_pop(Data& popped_value, unsigned int timeout_ms)
+    {
+        if(!dequeue(popped_value))
+            {
+                const boost::system_time deadline = boost::get_system_time() + boost::posix_time::milliseconds(timeout_ms);
+                boost::mutex::scoped_lock lock(the_mutex);
+                the_waiters.fetch_add(1);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                bool popped;
+                while(!(popped = dequeue(popped_value)))
+                    {
+                        if(!the_condition_variable.timed_wait(lock, deadline))
+                            {
+                                popped = dequeue(popped_value);
+                                break;
+                            }
+                    }
+                the_waiters.fetch_sub(1);
+                if(!popped) return false;
+            }
+        notify();
+        return true;
     }
 };
 #endif
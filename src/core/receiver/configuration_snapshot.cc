@@ -0,0 +1,84 @@
+/*!
+ * \file configuration_snapshot.cc
+ * \brief Values of a configuration file, converted to every type once.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "configuration_snapshot.h"
+#include <cctype>
+#include <sstream>
+
+
+// The same parse as StringConverter::convert()
+template<typename T>
+static bool parse(const std::string& text, T& result)
+{
+    std::stringstream stream(text);
+    stream >> result;
+    return !stream.fail();
+}
+
+
+Configuration_Value::Configuration_Value(const std::string& text) : d_text(text)
+{
+    d_valid = 0;
+    d_bool = (text.compare("true") == 0);
+    if (d_bool || text.compare("false") == 0) d_valid |= BOOL_VALID;
+    if (parse(text, d_long)) d_valid |= LONG_VALID;
+    if (parse(text, d_int)) d_valid |= INT_VALID;
+    if (parse(text, d_uint)) d_valid |= UINT_VALID;
+    if (parse(text, d_ushort)) d_valid |= USHORT_VALID;
+    if (parse(text, d_float)) d_valid |= FLOAT_VALID;
+    if (parse(text, d_double)) d_valid |= DOUBLE_VALID;
+}
+
+
+Configuration_Snapshot::Configuration_Snapshot(const std::map<std::string, std::string>& values, const std::string& section)
+{
+    const std::string prefix = section + ".";
+    d_values.reserve(values.size());
+    for (std::map<std::string, std::string>::const_iterator it = values.begin(); it != values.end(); ++it)
+        {
+            if (it->first.compare(0, prefix.size(), prefix) == 0)
+                {
+                    d_values.insert(std::make_pair(it->first.substr(prefix.size()), Configuration_Value(it->second)));
+                }
+        }
+}
+
+
+const Configuration_Value* Configuration_Snapshot::find(const std::string& property_name) const
+{
+    // the keys of INIReader are lower case
+    std::string key(property_name);
+    for (unsigned int i = 0; i < key.length(); i++)
+        {
+            key[i] = std::tolower(key[i]);
+        }
+    std::unordered_map<std::string, Configuration_Value>::const_iterator it = d_values.find(key);
+    return it == d_values.end() ? 0 : &it->second;
+}
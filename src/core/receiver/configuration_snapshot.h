@@ -0,0 +1,113 @@
+/*!
+ * \file configuration_snapshot.h
+ * \brief Values of a configuration file, converted to every type once.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * FileConfiguration used to run every typed lookup through INIReader::Get,
+ * which builds and lower-cases "section.name" and searches an ordered map,
+ * and then through a std::stringstream of StringConverter. The block factory
+ * and the adapters issue thousands of lookups at startup. A snapshot is built
+ * once per parse of the file, with the conversions of StringConverter already
+ * done, and searched by hash.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CONFIGURATION_SNAPSHOT_H_
+#define GNSS_SDR_CONFIGURATION_SNAPSHOT_H_
+
+#include <map>
+#include <string>
+#include <unordered_map>
+
+/*!
+ * \brief A value of the configuration and its conversions. Each get()
+ * returns what StringConverter::convert() returns for the same text.
+ */
+class Configuration_Value
+{
+public:
+    explicit Configuration_Value(const std::string& text);
+
+    const std::string& get(const std::string& /*default_value*/) const { return d_text; }
+    bool get(bool default_value) const { return (d_valid & BOOL_VALID) ? d_bool : default_value; }
+    long get(long default_value) const { return (d_valid & LONG_VALID) ? d_long : default_value; }
+    int get(int default_value) const { return (d_valid & INT_VALID) ? d_int : default_value; }
+    unsigned int get(unsigned int default_value) const { return (d_valid & UINT_VALID) ? d_uint : default_value; }
+    unsigned short get(unsigned short default_value) const { return (d_valid & USHORT_VALID) ? d_ushort : default_value; }
+    float get(float default_value) const { return (d_valid & FLOAT_VALID) ? d_float : default_value; }
+    double get(double default_value) const { return (d_valid & DOUBLE_VALID) ? d_double : default_value; }
+
+private:
+    enum
+    {
+        BOOL_VALID = 1, LONG_VALID = 2, INT_VALID = 4, UINT_VALID = 8,
+        USHORT_VALID = 16, FLOAT_VALID = 32, DOUBLE_VALID = 64
+    };
+    std::string d_text;
+    unsigned int d_valid;
+    bool d_bool;
+    long d_long;
+    int d_int;
+    unsigned int d_uint;
+    unsigned short d_ushort;
+    float d_float;
+    double d_double;
+};
+
+
+/*!
+ * \brief The properties of one section of a configuration file, by case-insensitive name
+ */
+class Configuration_Snapshot
+{
+public:
+    /*!
+     * \param values  - values by lower case "section.name", as INIReader::Values()
+     * \param section - lower case section of the properties ("gnss-sdr")
+     */
+    Configuration_Snapshot(const std::map<std::string, std::string>& values, const std::string& section);
+
+    //! Returns the value of the property, or null if it is not in the file
+    const Configuration_Value* find(const std::string& property_name) const;
+
+    //! Returns the value of the property, or \p default_value if it is not in the file
+    template<typename T>
+    T get(const std::string& property_name, T default_value) const
+    {
+        const Configuration_Value* value = find(property_name);
+        return value ? T(value->get(default_value)) : default_value;
+    }
+
+    size_t size() const
+    {
+        return d_values.size();
+    }
+
+private:
+    std::unordered_map<std::string, Configuration_Value> d_values;
+};
+
+#endif /* GNSS_SDR_CONFIGURATION_SNAPSHOT_H_ */
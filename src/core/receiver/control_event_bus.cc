@@ -0,0 +1,107 @@
+/*!
+ * \file control_event_bus.cc
+ * \brief Typed, lock-free path of the control events to the control thread.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "control_event_bus.h"
+#include <memory>
+#include <vector>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+const unsigned int Control_Event_Bus::receiver;
+const unsigned int Control_Event_Bus::acquisition_failed;
+const unsigned int Control_Event_Bus::acquisition_success;
+const unsigned int Control_Event_Bus::loss_of_lock;
+const unsigned int Control_Event_Bus::stop;
+const unsigned int Control_Event_Bus::signal_source_overflow;
+const unsigned int Control_Event_Bus::reload_configuration;
+const unsigned int Control_Event_Bus::realtime_margin_low;
+
+
+boost::shared_ptr<Control_Event_Bus> Control_Event_Bus::make(size_t capacity)
+{
+    return boost::shared_ptr<Control_Event_Bus>(new Control_Event_Bus(capacity));
+}
+
+
+Control_Event_Bus::Control_Event_Bus(size_t capacity) : gr::msg_queue(0), d_events(capacity)
+{}
+
+
+void Control_Event_Bus::send(const gr::msg_queue::sptr & queue, unsigned int who, unsigned int what)
+{
+    if (!queue) return;
+    Control_Event_Bus * bus = dynamic_cast<Control_Event_Bus *>(queue.get());
+    if (bus)
+        {
+            bus->post(who, what);
+        }
+    else
+        {
+            ControlMessageFactory cmf;
+            queue->handle(cmf.GetQueueMessage(who, what));
+        }
+}
+
+
+void Control_Event_Bus::post(unsigned int who, unsigned int what)
+{
+    ControlMessage event;
+    event.who = who;
+    event.what = what;
+    // never blocks a sender: with the control thread stopped, nobody frees the space
+    if (!d_events.try_push(event))
+        {
+            LOG(ERROR) << "Control event bus full, event " << what << " from " << who << " lost";
+        }
+}
+
+
+void Control_Event_Bus::handle(gr::message::sptr msg)
+{
+    ControlMessageFactory cmf;
+    std::shared_ptr<std::vector<std::shared_ptr<ControlMessage>>> messages = cmf.GetControlMessages(msg);
+    for (unsigned int i = 0; i < messages->size(); i++)
+        {
+            post(messages->at(i)->who, messages->at(i)->what);
+        }
+}
+
+
+bool Control_Event_Bus::wait_event(ControlMessage & event, unsigned int timeout_ms)
+{
+    return d_events.timed_wait_and_pop(event, timeout_ms);
+}
+
+
+bool Control_Event_Bus::try_event(ControlMessage & event)
+{
+    return d_events.try_pop(event);
+}
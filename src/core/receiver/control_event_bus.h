@@ -0,0 +1,100 @@
+/*!
+ * \file control_event_bus.h
+ * \brief Typed, lock-free path of the control events to the control thread.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The channels, the valve and the signal source monitors report their
+ * events (acquisition results, loss of lock, end of the samples...) to the
+ * control thread, which applies them to the flowgraph. Through a plain
+ * gr::msg_queue, each event is a gr::message allocated by the sender and
+ * parsed into a vector of shared pointers by the receiver. The bus is the
+ * queue that the control thread gives to the flowgraph: the events sent
+ * with Control_Event_Bus::send() go by value through a lock-free ring, and
+ * the control thread wakes up and dispatches each one as it arrives. The
+ * senders keep their gr::msg_queue::sptr, so they also work with a plain
+ * queue, as in the tests.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_CONTROL_EVENT_BUS_H_
+#define GNSS_SDR_CONTROL_EVENT_BUS_H_
+
+#include <cstddef>
+#include <boost/shared_ptr.hpp>
+#include <gnuradio/msg_queue.h>
+#include "concurrent_queue.h"
+#include "control_message_factory.h"
+
+/*!
+ * \brief Queue of control events for a single consumer, the control thread
+ *
+ * An event is who sent it, a channel or Control_Event_Bus::receiver, and
+ * what it says, one of the constants below for each kind of sender.
+ */
+class Control_Event_Bus : public gr::msg_queue
+{
+public:
+    //! Sender of the events that are not from a channel
+    static const unsigned int receiver = 200;
+
+    // events of a channel
+    static const unsigned int acquisition_failed = 0;
+    static const unsigned int acquisition_success = 1;
+    static const unsigned int loss_of_lock = 2;
+
+    // events of the receiver
+    static const unsigned int stop = 0;
+    static const unsigned int signal_source_overflow = 1;
+    static const unsigned int reload_configuration = 2;
+    static const unsigned int realtime_margin_low = 3;
+    static const unsigned int realtime_overload = 4;   // the margin is low, a channel may be shed
+    static const unsigned int realtime_headroom = 5;   // the margin is back, a shed channel may be restored
+
+    static boost::shared_ptr<Control_Event_Bus> make(size_t capacity = 1024);
+
+    /*!
+     * \brief Sends an event to \p queue: directly if it is a bus, and as a
+     * gr::message if it is a plain queue. Nothing is sent to a null queue.
+     */
+    static void send(const gr::msg_queue::sptr & queue, unsigned int who, unsigned int what);
+
+    void post(unsigned int who, unsigned int what);
+
+    //! From the senders of gr::message: each ControlMessage in it is posted as an event
+    void handle(gr::message::sptr msg);
+
+    //! Waits up to \p timeout_ms milliseconds for the next event
+    bool wait_event(ControlMessage & event, unsigned int timeout_ms);
+
+    bool try_event(ControlMessage & event);
+
+private:
+    explicit Control_Event_Bus(size_t capacity);
+
+    concurrent_queue<ControlMessage> d_events;
+};
+
+#endif /*GNSS_SDR_CONTROL_EVENT_BUS_H_*/
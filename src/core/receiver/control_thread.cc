@@ -33,12 +33,17 @@
  */
 
 #include "control_thread.h"
-#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <iomanip>
 #include <iostream>
 #include <map>
+#include <sstream>
 #include <string>
 #include <boost/lexical_cast.hpp>
 #include <boost/chrono.hpp>
+#include <boost/filesystem.hpp>
 #include <gnuradio/message.h>
 #include <gflags/gflags.h>
 #include <glog/logging.h>
@@ -53,8 +58,19 @@
 #include "concurrent_queue.h"
 #include "concurrent_map.h"
 #include "gnss_flowgraph.h"
+#include "gnss_assistance_cache.h"
 #include "file_configuration.h"
 #include "control_message_factory.h"
+#include "gnss_sdr_allocation_tracker.h"
+#include "gnss_sdr_event_log.h"
+#include "gnss_sdr_interference_monitor.h"
+#include "gnss_sdr_latency_tracer.h"
+#include "gnss_sdr_hw_counters.h"
+#include "gnss_sdr_memory_accounting.h"
+#include "gnss_sdr_numa.h"
+#include "gnss_sdr_realtime_monitor.h"
+#include "gnss_sdr_task_pool.h"
+#include "gnss_sdr_volk_calibration.h"
 
 extern concurrent_map<Gps_Acq_Assist> global_gps_acq_assist_map;
 extern concurrent_queue<Gps_Acq_Assist> global_gps_acq_assist_queue;
@@ -99,6 +115,20 @@ ControlThread::~ControlThread()
  */
 void ControlThread::run()
 {
+    // Select the VOLK_GNSSSDR implementations before any tracking block uses them
+    Gnss_Sdr_Volk_Calibration::run(configuration_);
+
+    // the pages of the blocks are locked as they are allocated
+    if (no_allocation_)
+        {
+            const unsigned int reserve_mb = configuration_->property("GNSS-SDR.realtime_heap_reserve_mb", 256);
+            if (!Gnss_Sdr_Allocation_Tracker::lock_memory(static_cast<size_t>(reserve_mb) * 1024 * 1024))
+                {
+                    LOG(WARNING) << "Unable to lock the memory of the receiver, the pages of the blocks may still fault";
+                    std::cout << "Unable to lock the memory of the receiver (see ulimit -l)" << std::endl;
+                }
+        }
+
     // Connect the flowgraph
     flowgraph_->connect();
     if (flowgraph_->connected())
@@ -110,6 +140,44 @@ void ControlThread::run()
             LOG(ERROR) << "Unable to connect flowgraph";
             return;
         }
+    const bool memory_report = Gnss_Sdr_Memory_Accounting::enabled();
+    if (memory_report)
+        {
+            std::vector<std::string> lines = Gnss_Sdr_Memory_Accounting::summary();
+            for (unsigned int i = 0; i < lines.size(); i++)
+                {
+                    std::cout << "Memory of " << lines.at(i) << std::endl;
+                    LOG(INFO) << "Memory of " << lines.at(i);
+                }
+        }
+    // resume: connect() has cleared the navigation data store, and the
+    // acquisitions have not started yet
+    if (checkpoint_loaded_)
+        {
+            unsigned int restored = checkpoint_.restore_checkpoint(Gnss_Nav_Data_Store::instance());
+            std::vector<Acquisition_Assistance::Tracked_Satellite> satellites;
+            for (unsigned int i = 0; i < checkpoint_.satellites.size(); i++)
+                {
+                    Acquisition_Assistance::Tracked_Satellite satellite;
+                    satellite.system = checkpoint_.satellites[i].system;
+                    satellite.prn = checkpoint_.satellites[i].prn;
+                    satellite.doppler_hz = checkpoint_.satellites[i].doppler_hz;
+                    satellite.doppler_rate_hz_s = checkpoint_.satellites[i].doppler_rate_hz_s;
+                    satellite.time_s = checkpoint_.satellites[i].time_s;
+                    satellites.push_back(satellite);
+                }
+            // the sample counters of this run start at the checkpoint
+            Acquisition_Assistance::restore_tracking(satellites, checkpoint_.signal_time_s);
+            std::cout << "Resuming the capture at " << checkpoint_.signal_time_s << " s: "
+                      << restored << " ephemeris and " << satellites.size() << " tracked satellites restored" << std::endl;
+        }
+    if (metrics_period_ms_ > 0)
+        {
+            // the counters of GNU Radio are read when the blocks start
+            Gnss_Block_Metrics::enable_performance_counters();
+            metrics_ = std::make_shared<Gnss_Block_Metrics>();
+            flowgraph_->register_metrics(*metrics_);
+        }
     // Start the flowgraph
     flowgraph_->start();
     if (flowgraph_->running())
@@ -121,31 +189,208 @@ void ControlThread::run()
             LOG(ERROR) << "Unable to start flowgraph";
             return;
         }
+    if (memory_report)
+        {
+            // with the stream buffers, allocated by GNU Radio at the start
+            std::vector<std::string> lines = Gnss_Sdr_Memory_Accounting::summary();
+            std::cout << "Memory of " << lines.back() << std::endl;
+            LOG(INFO) << "Memory of " << lines.back();
+        }
 
+    // warm start: connect() has cleared the navigation data store
+    if (receiver_state_loaded_ && !checkpoint_loaded_)
+        {
+            double max_age_s = configuration_->property("GNSS-SDR.receiver_state_max_age_s", 4.0 * 3600.0);
+            unsigned int restored = receiver_state_.restore(Gnss_Nav_Data_Store::instance(), max_age_s);
+            std::cout << "Receiver state loaded from " << receiver_state_file_ << ": "
+                      << restored << " ephemeris restored" << std::endl;
+        }
     //launch GNSS assistance process AFTER the flowgraph is running because the GNURadio asynchronous queues must be already running to transport msgs
     assist_GNSS();
+    if (!receiver_state_file_.empty())
+        {
+            receiver_state_thread_ = boost::thread(&ControlThread::receiver_state_saver, this);
+        }
+    if (checkpoint_period_s_ > 0.0)
+        {
+            checkpoint_thread_ = boost::thread(&ControlThread::checkpoint_writer, this);
+        }
+    if (configuration_reload_period_ms_ > 0)
+        {
+            configuration_watcher_thread_ = boost::thread(&ControlThread::configuration_watcher, this);
+        }
+    if (metrics_)
+        {
+            metrics_thread_ = boost::thread(&ControlThread::metrics_collector, this);
+        }
+    if (realtime_monitor_period_ms_ > 0)
+        {
+            realtime_monitor_thread_ = boost::thread(&ControlThread::realtime_monitor, this);
+        }
+    const bool latency_tracing = Gnss_Sdr_Latency_Tracer::enabled();
+    if (latency_tracing && latency_log_period_ms_ > 0)
+        {
+            latency_thread_ = boost::thread(&ControlThread::latency_logger, this);
+        }
+    const bool hw_counters = Gnss_Sdr_Hw_Counter_Registry::enabled();
+    if (hw_counters && hw_counters_log_period_ms_ > 0)
+        {
+            hw_counters_thread_ = boost::thread(&ControlThread::hw_counters_logger, this);
+        }
+    unsigned short port = configuration_->property("GNSS-SDR.metrics_port", static_cast<unsigned short>(0));
+    const bool mitigation = configuration_->property("InterferenceMitigation.implementation", std::string("Pass_Through")).compare("Pass_Through") != 0;
+    if (port > 0 && (metrics_ || realtime_monitor_period_ms_ > 0 || latency_tracing || hw_counters || memory_report || mitigation))
+        {
+            std::shared_ptr<Gnss_Block_Metrics> metrics = metrics_;
+            const unsigned int cores = realtime_monitor_period_ms_ > 0 ? realtime_cores_ : 0;
+            metrics_server_.reset(new Gnss_Metrics_Server(port, [metrics, cores, latency_tracing, hw_counters, memory_report]() {
+                    return (metrics ? metrics->prometheus_text() : std::string(""))
+                            + (cores > 0 ? Gnss_Sdr_Realtime_Monitor::prometheus_text(cores) : std::string(""))
+                            + (latency_tracing ? Gnss_Sdr_Latency_Tracer::prometheus_text() : std::string(""))
+                            + (hw_counters ? Gnss_Sdr_Hw_Counter_Registry::prometheus_text() : std::string(""))
+                            + (memory_report ? Gnss_Sdr_Memory_Accounting::prometheus_text() : std::string(""))
+                            + Gnss_Sdr_Interference_Monitor::prometheus_text()
+                            + Gnss_Sdr_Task_Pool::prometheus_text();
+                }));
+            if (metrics_server_->start())
+                {
+                    std::cout << "Performance counters served on http://localhost:" << metrics_server_->port() << "/metrics" << std::endl;
+                }
+        }
     // start the keyboard_listener thread
-    keyboard_thread_ = boost::thread(&ControlThread::keyboard_listener, this);
+    if (keyboard_listener_)
+        {
+            keyboard_thread_ = boost::thread(&ControlThread::keyboard_listener, this);
+        }
 
     // Main loop to read and process the control messages
+    const boost::posix_time::ptime started = boost::posix_time::microsec_clock::universal_time();
     while (flowgraph_->running() && !stop_)
         {
-            //TODO re-enable the blocking read messages functions and fork the process
-            read_control_messages();
-            if (control_messages_ != 0) process_control_messages();
+            if (no_allocation_ && !Gnss_Sdr_Allocation_Tracker::armed()
+                    && (boost::posix_time::microsec_clock::universal_time() - started).total_milliseconds() >= no_allocation_after_s_ * 1000.0)
+                {
+                    Gnss_Sdr_Allocation_Tracker::arm(no_allocation_abort_);
+                    LOG(INFO) << "Heap allocations of the block threads are "
+                              << (no_allocation_abort_ ? "forbidden" : "counted") << " from now on";
+                }
+            if (control_bus_)
+                {
+                    // each event is applied as soon as it arrives
+                    ControlMessage event;
+                    if (control_bus_->wait_event(event, 100)) process_control_message(event);
+                }
+            else
+                {
+                    read_control_messages();
+                    if (control_messages_ != 0) process_control_messages();
+                }
         }
     std::cout << "Stopping GNSS-SDR, please wait!" << std::endl;
+    // stopping the blocks frees memory, and may allocate
+    Gnss_Sdr_Allocation_Tracker::disarm();
     flowgraph_->stop();
     stop_ = true;
+    if (supl_assistance_running_)
+        {
+            // it is waiting for the server at most
+            supl_assistance_thread_.join();
+            supl_assistance_running_ = false;
+        }
+    // messages of the blocks still queued are written before the summaries
+    Gnss_Sdr_Event_Log::flush();
 
     //Join keyboard thread
+    if (keyboard_listener_)
+        {
 #ifdef OLD_BOOST
-    keyboard_thread_.timed_join(boost::posix_time::seconds(1));
+            keyboard_thread_.timed_join(boost::posix_time::seconds(1));
 #endif
 #ifndef OLD_BOOST
-    keyboard_thread_.try_join_until(boost::chrono::steady_clock::now() + boost::chrono::milliseconds(1000));
+            keyboard_thread_.try_join_until(boost::chrono::steady_clock::now() + boost::chrono::milliseconds(1000));
 #endif
+        }
+    if (!receiver_state_file_.empty())
+        {
+            receiver_state_thread_.join();
+            save_receiver_state();
+        }
+    if (checkpoint_period_s_ > 0.0)
+        {
+            checkpoint_thread_.join();
+        }
+    if (configuration_reload_period_ms_ > 0)
+        {
+            configuration_watcher_thread_.join();
+        }
+    if (metrics_)
+        {
+            metrics_thread_.join();
+        }
+    if (realtime_monitor_period_ms_ > 0)
+        {
+            realtime_monitor_thread_.join();
+        }
+    if (latency_tracing && latency_log_period_ms_ > 0)
+        {
+            latency_thread_.join();
+        }
+    if (hw_counters && hw_counters_log_period_ms_ > 0)
+        {
+            hw_counters_thread_.join();
+        }
+    if (metrics_server_) metrics_server_->stop();
 
+    if (signal_source_overflows_ > 0)
+        {
+            std::cout << "The signal source reported " << signal_source_overflows_ << " overflows" << std::endl;
+            LOG(WARNING) << "The signal source reported " << signal_source_overflows_ << " overflows";
+        }
+    if (latency_tracing)
+        {
+            std::vector<std::string> lines = Gnss_Sdr_Latency_Tracer::summary();
+            for (unsigned int i = 0; i < lines.size(); i++)
+                {
+                    std::cout << "Latency of " << lines.at(i) << std::endl;
+                    LOG(INFO) << "Latency of " << lines.at(i);
+                }
+        }
+    if (hw_counters)
+        {
+            std::vector<std::string> lines = Gnss_Sdr_Hw_Counter_Registry::summary();
+            for (unsigned int i = 0; i < lines.size(); i++)
+                {
+                    std::cout << "Hardware counters of " << lines.at(i) << std::endl;
+                    LOG(INFO) << "Hardware counters of " << lines.at(i);
+                }
+        }
+    std::vector<std::string> task_lines = Gnss_Sdr_Task_Pool::summary();
+    for (unsigned int i = 0; i < task_lines.size(); i++)
+        {
+            LOG(INFO) << "Task pool, " << task_lines.at(i);
+        }
+    if (realtime_margin_warnings_ > 0)
+        {
+            std::cout << "The real-time margin dropped below " << realtime_margin_threshold_ << " "
+                      << realtime_margin_warnings_ << " times" << std::endl;
+        }
+    if (overload_sheds_ > 0)
+        {
+            std::cout << "Channels shed to keep up with real time: " << overload_sheds_
+                      << ", " << overload_shed_channels_ << " still shed at the end" << std::endl;
+            LOG(WARNING) << "Channels shed to keep up with real time: " << overload_sheds_;
+        }
+    if (no_allocation_)
+        {
+            std::cout << "Heap allocations in the block threads while running: "
+                      << Gnss_Sdr_Allocation_Tracker::allocations() << std::endl;
+            std::vector<std::string> lines = Gnss_Sdr_Allocation_Tracker::summary();
+            for (unsigned int i = 0; i < lines.size(); i++)
+                {
+                    std::cout << lines.at(i) << std::endl;
+                    LOG(WARNING) << lines.at(i);
+                }
+        }
     LOG(INFO) << "Flowgraph stopped";
 }
 
@@ -158,6 +403,7 @@ void ControlThread::set_control_queue(boost::shared_ptr<gr::msg_queue> control_q
             return;
         }
     control_queue_ = control_queue;
+    control_bus_ = boost::dynamic_pointer_cast<Control_Event_Bus>(control_queue);
 }
 
 
@@ -175,6 +421,34 @@ bool ControlThread::read_assistance_from_XML()
     std::string ref_time_xml_filename = configuration_->property("GNSS-SDR.SUPL_gps_ref_time_xml", ref_time_default_xml_filename);
     std::string ref_location_xml_filename = configuration_->property("GNSS-SDR.SUPL_gps_ref_location_xml", ref_location_default_xml_filename);
 
+    // the binary file has it all, and is much faster to read
+    std::string assistance_binary_filename = configuration_->property("GNSS-SDR.SUPL_gps_assistance_binary", std::string(""));
+    if (!assistance_binary_filename.empty() && supl_client_ephemeris_.load_assistance_binary(assistance_binary_filename))
+        {
+            std::cout << "SUPL: Read GPS assistance from binary file " << assistance_binary_filename << std::endl;
+            std::map<int,Gps_Ephemeris>::iterator gps_eph_iter;
+            for(gps_eph_iter = supl_client_ephemeris_.gps_ephemeris_map.begin();
+                    gps_eph_iter != supl_client_ephemeris_.gps_ephemeris_map.end();
+                    gps_eph_iter++)
+                {
+                    std::shared_ptr<Gps_Ephemeris> tmp_obj = std::make_shared<Gps_Ephemeris>(gps_eph_iter->second);
+                    flowgraph_->send_telemetry_msg(pmt::make_any(tmp_obj));
+                }
+            std::map<int,Gps_Almanac>::iterator gps_alm_iter;
+            for(gps_alm_iter = supl_client_ephemeris_.gps_almanac_map.begin();
+                    gps_alm_iter != supl_client_ephemeris_.gps_almanac_map.end();
+                    gps_alm_iter++)
+                {
+                    std::shared_ptr<Gps_Almanac> tmp_obj = std::make_shared<Gps_Almanac>(gps_alm_iter->second);
+                    flowgraph_->send_telemetry_msg(pmt::make_any(tmp_obj));
+                }
+            flowgraph_->send_telemetry_msg(pmt::make_any(std::make_shared<Gps_Utc_Model>(supl_client_ephemeris_.gps_utc)));
+            flowgraph_->send_telemetry_msg(pmt::make_any(std::make_shared<Gps_Iono>(supl_client_ephemeris_.gps_iono)));
+            flowgraph_->send_telemetry_msg(pmt::make_any(std::make_shared<Gps_Ref_Time>(supl_client_ephemeris_.gps_time)));
+            flowgraph_->send_telemetry_msg(pmt::make_any(std::make_shared<Gps_Ref_Location>(supl_client_ephemeris_.gps_ref_loc)));
+            return true;
+        }
+
     std::cout << "SUPL: Try read GPS ephemeris from XML file " << eph_xml_filename << std::endl;
     if (supl_client_ephemeris_.load_ephemeris_xml(eph_xml_filename) == true)
         {
@@ -288,141 +562,284 @@ void ControlThread::assist_GNSS()
                     supl_ci = 0x31b0;
             }
 
-            bool SUPL_read_gps_assistance_xml = configuration_->property("GNSS-SDR.SUPL_read_gps_assistance_xml", false);
-            if (SUPL_read_gps_assistance_xml == true)
+            // the files and the server are read while the receiver runs
+            supl_assistance_running_ = true;
+            supl_assistance_thread_ = boost::thread(&ControlThread::supl_assistance_fetcher, this);
+        }
+}
+
+
+void ControlThread::supl_assistance_fetcher()
+{
+    bool SUPL_read_gps_assistance_xml = configuration_->property("GNSS-SDR.SUPL_read_gps_assistance_xml", false);
+    if (SUPL_read_gps_assistance_xml == true)
+        {
+            // read assistance from file
+            if (read_assistance_from_XML())
                 {
-                    // read assistance from file
-                    if (read_assistance_from_XML())
-                        {
-                            std::cout << "GPS assistance data loaded from local XML file." << std::endl;
-                        }
+                    std::cout << "GPS assistance data loaded from local XML file." << std::endl;
+                }
+            return;
+        }
+
+    // GPS ephemeris are valid two hours around their reference time
+    std::string eph_xml_filename = configuration_->property("GNSS-SDR.SUPL_gps_ephemeris_xml", eph_default_xml_filename);
+    std::string cache_filename = configuration_->property("GNSS-SDR.SUPL_gps_assistance_binary", eph_xml_filename);
+    Gnss_Assistance_Cache cache(cache_filename,
+            configuration_->property("GNSS-SDR.SUPL_cache_ttl_s", 7200.0),
+            configuration_->property("GNSS-SDR.SUPL_refresh_margin_s", 600.0));
+    double retry_period_s = std::max(configuration_->property("GNSS-SDR.SUPL_retry_period_s", 60.0), 1.0);
+
+    bool first = true;
+    while (!stop_)
+        {
+            if (first && cache.fresh(std::time(0)))
+                {
+                    std::cout << "SUPL: Using the assistance cached " << static_cast<long>(cache.age_s(std::time(0)))
+                              << " s ago in " << cache.filename() << std::endl;
+                    read_assistance_from_XML();
                 }
             else
                 {
-                    // Request ephemeris from SUPL server
-                    int error;
-                    supl_client_ephemeris_.request = 1;
-                    std::cout << "SUPL: Try to read GPS ephemeris from SUPL server..." << std::endl;
-                    error = supl_client_ephemeris_.get_assistance(supl_mcc, supl_mns, supl_lac, supl_ci);
-                    if (error == 0)
-                        {
-                            std::map<int,Gps_Ephemeris>::iterator gps_eph_iter;
-                            for(gps_eph_iter = supl_client_ephemeris_.gps_ephemeris_map.begin();
-                                    gps_eph_iter != supl_client_ephemeris_.gps_ephemeris_map.end();
-                                    gps_eph_iter++)
-                                {
-                                    std::cout << "SUPL: Received Ephemeris for GPS SV " << gps_eph_iter->first << std::endl;
-                                    std::shared_ptr<Gps_Ephemeris> tmp_obj = std::make_shared<Gps_Ephemeris>(gps_eph_iter->second);
-                                    flowgraph_->send_telemetry_msg(pmt::make_any(tmp_obj));
-                                }
-                            //Save ephemeris to XML file
-                            std::string eph_xml_filename = configuration_->property("GNSS-SDR.SUPL_gps_ephemeris_xml", eph_default_xml_filename);
-                            if (supl_client_ephemeris_.save_ephemeris_map_xml(eph_xml_filename, supl_client_ephemeris_.gps_ephemeris_map) == true)
-                                {
-                                    std::cout << "SUPL: XML Ephemeris file created" << std::endl;
-                                }
-                            else
-                                {
-                                    std::cout << "SUPL: Failed to create XML Ephemeris file" << std::endl;
-                                }
-                        }
-                    else
-                        {
-                            std::cout << "ERROR: SUPL client for Ephemeris returned " << error << std::endl;
-                            std::cout << "Please check internet connection and SUPL server configuration" << error << std::endl;
-                            std::cout << "Trying to read ephemeris from XML file" << std::endl;
-                            if (read_assistance_from_XML() == false)
-                                {
-                                    std::cout << "ERROR: Could not read Ephemeris file: Disabling SUPL assistance." << std::endl;
-                                }
-                        }
+                    request_supl_assistance();
+                }
+            first = false;
 
-                    // Request almanac , IONO and UTC Model
-                    supl_client_ephemeris_.request = 0;
-                    std::cout << "SUPL: Try read Almanac, Iono, Utc Model, Ref Time and Ref Location from SUPL server..." << std::endl;
-                    error = supl_client_ephemeris_.get_assistance(supl_mcc, supl_mns, supl_lac, supl_ci);
-                    if (error == 0)
-                        {
-                            std::map<int,Gps_Almanac>::iterator gps_alm_iter;
-                            for(gps_alm_iter = supl_client_ephemeris_.gps_almanac_map.begin();
-                                    gps_alm_iter != supl_client_ephemeris_.gps_almanac_map.end();
-                                    gps_alm_iter++)
-                                {
-                                    std::cout << "SUPL: Received Almanac for GPS SV " << gps_alm_iter->first << std::endl;
-                                    std::shared_ptr<Gps_Almanac> tmp_obj = std::make_shared<Gps_Almanac>(gps_alm_iter->second);
-                                    flowgraph_->send_telemetry_msg(pmt::make_any(tmp_obj));
-                                }
-                            if (supl_client_ephemeris_.gps_iono.valid == true)
-                                {
-                                    std::cout << "SUPL: Received GPS Iono" << std::endl;
-                                    std::shared_ptr<Gps_Iono> tmp_obj = std::make_shared<Gps_Iono>(supl_client_ephemeris_.gps_iono);
-                                    flowgraph_->send_telemetry_msg(pmt::make_any(tmp_obj));
-                                }
-                            if (supl_client_ephemeris_.gps_utc.valid == true)
-                                {
-                                    std::cout << "SUPL: Received GPS UTC Model" << std::endl;
-                                    std::shared_ptr<Gps_Utc_Model> tmp_obj = std::make_shared<Gps_Utc_Model>(supl_client_ephemeris_.gps_utc);
-                                    flowgraph_->send_telemetry_msg(pmt::make_any(tmp_obj));
-                                }
-                        }
-                    else
-                        {
-                            std::cout << "ERROR: SUPL client for Almanac returned " << error << std::endl;
-                            std::cout << "Please check internet connection and SUPL server configuration" << error << std::endl;
-                            std::cout << "Disabling SUPL assistance." << std::endl;
-                        }
+            // a failed request leaves the cache stale, and is retried later
+            double wait_s = std::max(cache.refresh_in_s(std::time(0)), retry_period_s);
+            LOG(INFO) << "SUPL: next assistance request in " << wait_s << " s";
+            boost::posix_time::ptime next = boost::posix_time::microsec_clock::universal_time()
+                    + boost::posix_time::milliseconds(static_cast<long>(wait_s * 1000.0));
+            while (!stop_ && boost::posix_time::microsec_clock::universal_time() < next)
+                {
+                    boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+                }
+        }
+}
 
-                    // Request acquisition assistance
-                    supl_client_acquisition_.request = 2;
-                    std::cout << "SUPL: Try read Acquisition assistance from SUPL server..." << std::endl;
-                    error = supl_client_acquisition_.get_assistance(supl_mcc, supl_mns, supl_lac, supl_ci);
-                    if (error == 0)
-                        {
-                            std::map<int, Gps_Acq_Assist>::iterator gps_acq_iter;
-                            for(gps_acq_iter = supl_client_acquisition_.gps_acq_map.begin();
-                                    gps_acq_iter != supl_client_acquisition_.gps_acq_map.end();
-                                    gps_acq_iter++)
-                                {
-                                    std::cout << "SUPL: Received Acquisition assistance for GPS SV " << gps_acq_iter->first << std::endl;
-                                    global_gps_acq_assist_map.write(gps_acq_iter->second.i_satellite_PRN, gps_acq_iter->second);
-                                }
-                            if (supl_client_acquisition_.gps_ref_loc.valid == true)
-                                {
-                                    std::cout << "SUPL: Received Ref Location (Acquisition Assistance)" << std::endl;
-                                    std::shared_ptr<Gps_Ref_Location> tmp_obj = std::make_shared<Gps_Ref_Location>(supl_client_acquisition_.gps_ref_loc);
-                                    flowgraph_->send_telemetry_msg(pmt::make_any(tmp_obj));
-                                }
-                            if (supl_client_acquisition_.gps_time.valid == true)
-                                {
-                                    std::cout << "SUPL: Received Ref Time (Acquisition Assistance)" << std::endl;
-                                    std::shared_ptr<Gps_Ref_Time> tmp_obj = std::make_shared<Gps_Ref_Time>(supl_client_acquisition_.gps_time);
-                                    flowgraph_->send_telemetry_msg(pmt::make_any(tmp_obj));
-                                }
-                        }
-                    else
-                        {
-                            std::cout << "ERROR: SUPL client for Acquisition assistance returned " << error << std::endl;
-                            std::cout << "Please check internet connection and SUPL server configuration" << error << std::endl;
-                            std::cout << "Disabling SUPL assistance.." << std::endl;
-                        }
+
+bool ControlThread::request_supl_assistance()
+{
+    bool ephemeris_received = false;
+    // Request ephemeris from SUPL server
+    int error;
+    supl_client_ephemeris_.request = 1;
+    std::cout << "SUPL: Try to read GPS ephemeris from SUPL server..." << std::endl;
+    error = supl_client_ephemeris_.get_assistance(supl_mcc, supl_mns, supl_lac, supl_ci);
+    if (error == 0)
+        {
+            std::map<int,Gps_Ephemeris>::iterator gps_eph_iter;
+            for(gps_eph_iter = supl_client_ephemeris_.gps_ephemeris_map.begin();
+                    gps_eph_iter != supl_client_ephemeris_.gps_ephemeris_map.end();
+                    gps_eph_iter++)
+                {
+                    std::cout << "SUPL: Received Ephemeris for GPS SV " << gps_eph_iter->first << std::endl;
+                    std::shared_ptr<Gps_Ephemeris> tmp_obj = std::make_shared<Gps_Ephemeris>(gps_eph_iter->second);
+                    flowgraph_->send_telemetry_msg(pmt::make_any(tmp_obj));
+                }
+            ephemeris_received = true;
+            //Save ephemeris to XML file
+            std::string eph_xml_filename = configuration_->property("GNSS-SDR.SUPL_gps_ephemeris_xml", eph_default_xml_filename);
+            if (supl_client_ephemeris_.save_ephemeris_map_xml(eph_xml_filename, supl_client_ephemeris_.gps_ephemeris_map) == true)
+                {
+                    std::cout << "SUPL: XML Ephemeris file created" << std::endl;
+                }
+            else
+                {
+                    std::cout << "SUPL: Failed to create XML Ephemeris file" << std::endl;
+                }
+        }
+    else
+        {
+            std::cout << "ERROR: SUPL client for Ephemeris returned " << error << std::endl;
+            std::cout << "Please check internet connection and SUPL server configuration" << error << std::endl;
+            std::cout << "Trying to read ephemeris from XML file" << std::endl;
+            if (read_assistance_from_XML() == false)
+                {
+                    std::cout << "ERROR: Could not read Ephemeris file: Disabling SUPL assistance." << std::endl;
+                }
+        }
+
+    // Request almanac , IONO and UTC Model
+    supl_client_ephemeris_.request = 0;
+    std::cout << "SUPL: Try read Almanac, Iono, Utc Model, Ref Time and Ref Location from SUPL server..." << std::endl;
+    error = supl_client_ephemeris_.get_assistance(supl_mcc, supl_mns, supl_lac, supl_ci);
+    if (error == 0)
+        {
+            std::map<int,Gps_Almanac>::iterator gps_alm_iter;
+            for(gps_alm_iter = supl_client_ephemeris_.gps_almanac_map.begin();
+                    gps_alm_iter != supl_client_ephemeris_.gps_almanac_map.end();
+                    gps_alm_iter++)
+                {
+                    std::cout << "SUPL: Received Almanac for GPS SV " << gps_alm_iter->first << std::endl;
+                    std::shared_ptr<Gps_Almanac> tmp_obj = std::make_shared<Gps_Almanac>(gps_alm_iter->second);
+                    flowgraph_->send_telemetry_msg(pmt::make_any(tmp_obj));
+                }
+            if (supl_client_ephemeris_.gps_iono.valid == true)
+                {
+                    std::cout << "SUPL: Received GPS Iono" << std::endl;
+                    std::shared_ptr<Gps_Iono> tmp_obj = std::make_shared<Gps_Iono>(supl_client_ephemeris_.gps_iono);
+                    flowgraph_->send_telemetry_msg(pmt::make_any(tmp_obj));
+                }
+            if (supl_client_ephemeris_.gps_utc.valid == true)
+                {
+                    std::cout << "SUPL: Received GPS UTC Model" << std::endl;
+                    std::shared_ptr<Gps_Utc_Model> tmp_obj = std::make_shared<Gps_Utc_Model>(supl_client_ephemeris_.gps_utc);
+                    flowgraph_->send_telemetry_msg(pmt::make_any(tmp_obj));
+                }
+        }
+    else
+        {
+            std::cout << "ERROR: SUPL client for Almanac returned " << error << std::endl;
+            std::cout << "Please check internet connection and SUPL server configuration" << error << std::endl;
+            std::cout << "Disabling SUPL assistance." << std::endl;
+        }
+
+    // Request acquisition assistance
+    supl_client_acquisition_.request = 2;
+    std::cout << "SUPL: Try read Acquisition assistance from SUPL server..." << std::endl;
+    error = supl_client_acquisition_.get_assistance(supl_mcc, supl_mns, supl_lac, supl_ci);
+    if (error == 0)
+        {
+            std::map<int, Gps_Acq_Assist>::iterator gps_acq_iter;
+            for(gps_acq_iter = supl_client_acquisition_.gps_acq_map.begin();
+                    gps_acq_iter != supl_client_acquisition_.gps_acq_map.end();
+                    gps_acq_iter++)
+                {
+                    std::cout << "SUPL: Received Acquisition assistance for GPS SV " << gps_acq_iter->first << std::endl;
+                    global_gps_acq_assist_map.write(gps_acq_iter->second.i_satellite_PRN, gps_acq_iter->second);
+                }
+            if (supl_client_acquisition_.gps_ref_loc.valid == true)
+                {
+                    std::cout << "SUPL: Received Ref Location (Acquisition Assistance)" << std::endl;
+                    std::shared_ptr<Gps_Ref_Location> tmp_obj = std::make_shared<Gps_Ref_Location>(supl_client_acquisition_.gps_ref_loc);
+                    flowgraph_->send_telemetry_msg(pmt::make_any(tmp_obj));
+                }
+            if (supl_client_acquisition_.gps_time.valid == true)
+                {
+                    std::cout << "SUPL: Received Ref Time (Acquisition Assistance)" << std::endl;
+                    std::shared_ptr<Gps_Ref_Time> tmp_obj = std::make_shared<Gps_Ref_Time>(supl_client_acquisition_.gps_time);
+                    flowgraph_->send_telemetry_msg(pmt::make_any(tmp_obj));
+                }
+        }
+    else
+        {
+            std::cout << "ERROR: SUPL client for Acquisition assistance returned " << error << std::endl;
+            std::cout << "Please check internet connection and SUPL server configuration" << error << std::endl;
+            std::cout << "Disabling SUPL assistance.." << std::endl;
+        }
+
+    std::string assistance_binary_filename = configuration_->property("GNSS-SDR.SUPL_gps_assistance_binary", std::string(""));
+    if (ephemeris_received && !assistance_binary_filename.empty())
+        {
+            supl_client_ephemeris_.gps_ref_loc = supl_client_acquisition_.gps_ref_loc;
+            supl_client_ephemeris_.gps_time = supl_client_acquisition_.gps_time;
+            if (supl_client_ephemeris_.save_assistance_binary(assistance_binary_filename) == false)
+                {
+                    std::cout << "SUPL: Failed to create the binary assistance file" << std::endl;
                 }
         }
+
+    return ephemeris_received;
 }
 
 
 void ControlThread::init()
 {
+    // the tracking blocks take their cost counters when the flowgraph creates the channels
+    realtime_monitor_period_ms_ = configuration_->property("GNSS-SDR.realtime_monitor_period_ms", 0);
+    realtime_cores_ = configuration_->property("GNSS-SDR.realtime_cores", 0);
+    if (realtime_cores_ == 0) realtime_cores_ = std::max(boost::thread::hardware_concurrency(), 1u);
+    realtime_margin_threshold_ = configuration_->property("GNSS-SDR.realtime_margin_threshold", 0.2);
+    realtime_margin_warnings_ = 0;
+    Gnss_Sdr_Realtime_Monitor::enable(realtime_monitor_period_ms_ > 0);
+    // the overload protection acts on the samples of the monitor
+    overload_shedding_ = configuration_->property("GNSS-SDR.overload_shedding", false);
+    overload_restore_margin_ = std::max(configuration_->property("GNSS-SDR.overload_restore_margin", 0.4), realtime_margin_threshold_);
+    overload_restore_delay_ms_ = configuration_->property("GNSS-SDR.overload_restore_delay_ms", 10000);
+    overload_min_channels_ = configuration_->property("GNSS-SDR.overload_min_channels", 4);
+    overload_sheds_ = 0;
+    overload_shed_channels_ = 0;
+    if (overload_shedding_ && realtime_monitor_period_ms_ == 0)
+        {
+            LOG(WARNING) << "GNSS-SDR.overload_shedding needs GNSS-SDR.realtime_monitor_period_ms";
+        }
+
+    no_allocation_ = configuration_->property("GNSS-SDR.realtime_no_allocation", false);
+    no_allocation_abort_ = configuration_->property("GNSS-SDR.realtime_no_allocation_abort", false);
+    no_allocation_after_s_ = std::max(configuration_->property("GNSS-SDR.realtime_no_allocation_after_s", 0.0), 0.0);
+
+    // and the flowgraph connects the latency probes if the tracer is enabled
+    latency_log_period_ms_ = configuration_->property("GNSS-SDR.latency_log_period_ms", 0);
+    Gnss_Sdr_Latency_Tracer::reset();
+    Gnss_Sdr_Latency_Tracer::enable(configuration_->property("GNSS-SDR.latency_tracing", false));
+
+    // read by the profiles of the tracking blocks, which are created with the flowgraph
+    hw_counters_log_period_ms_ = configuration_->property("GNSS-SDR.hw_counters_log_period_ms", 0);
+    Gnss_Sdr_Hw_Counter_Registry::reset();
+    Gnss_Sdr_Hw_Counter_Registry::enable(configuration_->property("GNSS-SDR.hw_counters", false));
+
+    // and the memory of the blocks, accounted as the flowgraph creates and connects them
+    Gnss_Sdr_Memory_Accounting::reset();
+    Gnss_Sdr_Memory_Accounting::enable(configuration_->property("GNSS-SDR.memory_report", false));
+
+    // the shared task pool, before the blocks submit their first tasks
+    Gnss_Sdr_Task_Pool::configure(configuration_->property("GNSS-SDR.task_pool_threads", 0),
+            configuration_->property("GNSS-SDR.task_pool_background_threads", 1),
+            Gnss_Sdr_Numa::parse_cpu_list(configuration_->property("GNSS-SDR.task_pool_cpu_affinity", std::string(""))));
+    Gnss_Sdr_Task_Pool::reset_metrics();
+
+    // checkpoints of a post-processing run, and the one to resume from, which
+    // sets the seconds to skip of the signal source before it is created
+    checkpoint_period_s_ = std::max(configuration_->property("GNSS-SDR.checkpoint_period_s", 0.0), 0.0);
+    checkpoint_dir_ = configuration_->property("GNSS-SDR.checkpoint_dir", std::string("./checkpoints"));
+    resume_at_s_ = configuration_->property("GNSS-SDR.resume_at_s", -1.0);
+    checkpoint_loaded_ = resume_at_s_ >= 0.0 && load_checkpoint();
+    seconds_skipped_ = std::max(configuration_->property("SignalSource.seconds_to_skip", 0.0), 0.0);
+    Acquisition_Assistance::set_tracking_record(checkpoint_period_s_ > 0.0);
+    if (checkpoint_period_s_ > 0.0)
+        {
+            boost::system::error_code ec;
+            boost::filesystem::create_directories(checkpoint_dir_, ec);
+        }
+
     // Instantiates a control queue, a GNSS flowgraph, and a control message factory
-    control_queue_ = gr::msg_queue::make(0);
+    control_bus_ = Control_Event_Bus::make();
+    control_queue_ = control_bus_;
     flowgraph_ = std::make_shared<GNSSFlowgraph>(configuration_, control_queue_);
     control_message_factory_ = std::make_shared<ControlMessageFactory>();
     stop_ = false;
     processed_control_messages_ = 0;
     applied_actions_ = 0;
+    signal_source_overflows_ = 0;
     supl_mcc = 0;
     supl_mns = 0;
     supl_lac = 0;
     supl_ci = 0;
+    supl_assistance_running_ = false;
+
+    // state saved by a previous run, for a warm start
+    receiver_state_file_ = configuration_->property("GNSS-SDR.receiver_state_xml", std::string(""));
+    receiver_state_period_s_ = configuration_->property("GNSS-SDR.receiver_state_period_s", 60.0);
+    receiver_state_loaded_ = false;
+    receiver_state_binary_ = configuration_->property("GNSS-SDR.receiver_state_binary", false);
+    if (!receiver_state_file_.empty())
+        {
+            receiver_state_loaded_ = receiver_state_.load(receiver_state_file_);
+        }
+
+    // parameters changed in the configuration file while running
+    configuration_reload_period_ms_ = 0;
+    if (std::dynamic_pointer_cast<FileConfiguration>(configuration_))
+        {
+            configuration_reload_period_ms_ = configuration_->property("GNSS-SDR.configuration_reload_period_ms", 0);
+        }
+
+    // performance counters of the blocks, with no cost if disabled
+    metrics_period_ms_ = configuration_->property("GNSS-SDR.metrics_period_ms", 0);
+    metrics_log_ = configuration_->property("GNSS-SDR.metrics_log", true);
+
+    keyboard_listener_ = configuration_->property("GNSS-SDR.keyboard_listener", true);
 }
 
 
@@ -448,30 +865,58 @@ void ControlThread::process_control_messages()
     for (unsigned int i = 0; i < control_messages_->size(); i++)
         {
             if (stop_) break;
-            if (control_messages_->at(i)->who == 200)
-                {
-                    apply_action(control_messages_->at(i)->what);
-                }
-            else
-                {
-                    flowgraph_->apply_action(control_messages_->at(i)->who, control_messages_->at(i)->what);
-                }
-            processed_control_messages_++;
+            process_control_message(*control_messages_->at(i));
         }
     control_messages_->clear();
     DLOG(INFO) << "Processed all control messages";
 }
 
 
+void ControlThread::process_control_message(const ControlMessage & message)
+{
+    if (message.who == Control_Event_Bus::receiver)
+        {
+            apply_action(message.what);
+        }
+    else
+        {
+            flowgraph_->apply_action(message.who, message.what);
+        }
+    processed_control_messages_++;
+}
+
+
 void ControlThread::apply_action(unsigned int what)
 {
     switch (what)
     {
-    case 0:
+    case Control_Event_Bus::stop:
         DLOG(INFO) << "Received action STOP";
         stop_ = true;
         applied_actions_++;
         break;
+    case Control_Event_Bus::signal_source_overflow:
+        // the signal source lost samples, the details are in its own log
+        signal_source_overflows_++;
+        applied_actions_++;
+        break;
+    case Control_Event_Bus::reload_configuration:
+        DLOG(INFO) << "Received action RELOAD CONFIGURATION";
+        reload_configuration();
+        applied_actions_++;
+        break;
+    case Control_Event_Bus::realtime_margin_low:
+        realtime_margin_low();
+        applied_actions_++;
+        break;
+    case Control_Event_Bus::realtime_overload:
+        realtime_overload();
+        applied_actions_++;
+        break;
+    case Control_Event_Bus::realtime_headroom:
+        realtime_headroom();
+        applied_actions_++;
+        break;
     default:
         DLOG(INFO) << "Unrecognized action.";
         break;
@@ -511,23 +956,324 @@ void ControlThread::gps_acq_assist_data_collector()
 }
 
 
+void ControlThread::receiver_state_saver()
+{
+    boost::posix_time::ptime last_save = boost::posix_time::microsec_clock::universal_time();
+    while (!stop_)
+        {
+            boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+            boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+            if ((now - last_save).total_milliseconds() >= receiver_state_period_s_ * 1000.0)
+                {
+                    save_receiver_state();
+                    last_save = now;
+                }
+        }
+}
+
+
+void ControlThread::save_receiver_state()
+{
+    Gnss_Receiver_State state;
+    state.capture(Gnss_Nav_Data_Store::instance());
+    if (state.gps_ephemeris_map.empty() && state.galileo_ephemeris_map.empty() && !state.has_position)
+        {
+            // nothing learned yet, keeps the state of the previous run
+            return;
+        }
+    if (!(receiver_state_binary_ ? state.save_binary(receiver_state_file_) : state.save_xml(receiver_state_file_)))
+        {
+            LOG(WARNING) << "Unable to save the receiver state to " << receiver_state_file_;
+        }
+}
+
+
+void ControlThread::checkpoint_writer()
+{
+    // on multiples of the period in the capture, also after a resume
+    double next_s = (std::floor(seconds_skipped_ / checkpoint_period_s_) + 1.0) * checkpoint_period_s_;
+    while (!stop_)
+        {
+            boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+            std::vector<Acquisition_Assistance::Tracked_Satellite> tracked = Acquisition_Assistance::tracked_satellites();
+            double time_s = -1.0;
+            for (unsigned int i = 0; i < tracked.size(); i++)
+                {
+                    time_s = std::max(time_s, tracked[i].time_s);
+                }
+            if (time_s < 0.0 || seconds_skipped_ + time_s < next_s)
+                {
+                    continue;
+                }
+            // a satellite whose channel stopped without a loss of lock is not tracked any more
+            std::vector<Acquisition_Assistance::Tracked_Satellite> satellites;
+            for (unsigned int i = 0; i < tracked.size(); i++)
+                {
+                    if (tracked[i].time_s > time_s - 1.0)
+                        {
+                            satellites.push_back(tracked[i]);
+                        }
+                }
+            save_checkpoint(seconds_skipped_ + time_s, satellites);
+            next_s = (std::floor((seconds_skipped_ + time_s) / checkpoint_period_s_) + 1.0) * checkpoint_period_s_;
+        }
+}
+
+
+void ControlThread::save_checkpoint(double signal_time_s, const std::vector<Acquisition_Assistance::Tracked_Satellite> & satellites)
+{
+    Gnss_Receiver_State state;
+    state.capture(Gnss_Nav_Data_Store::instance());
+    state.signal_time_s = signal_time_s;
+    for (unsigned int i = 0; i < satellites.size(); i++)
+        {
+            Gnss_Receiver_State_Satellite satellite;
+            satellite.system = satellites[i].system;
+            satellite.prn = satellites[i].prn;
+            satellite.doppler_hz = satellites[i].doppler_hz;
+            satellite.doppler_rate_hz_s = satellites[i].doppler_rate_hz_s;
+            satellite.time_s = seconds_skipped_ + satellites[i].time_s;
+            state.satellites.push_back(satellite);
+        }
+    std::ostringstream file_name;
+    file_name << checkpoint_dir_ << "/checkpoint_" << std::setw(6) << std::setfill('0')
+              << static_cast<unsigned long>(signal_time_s) << (receiver_state_binary_ ? ".bin" : ".xml");
+    if (!(receiver_state_binary_ ? state.save_binary(file_name.str()) : state.save_xml(file_name.str()))
+            || !Gnss_Receiver_State::add_checkpoint(checkpoint_dir_ + "/checkpoints.txt", signal_time_s, file_name.str()))
+        {
+            LOG(WARNING) << "Unable to save the checkpoint " << file_name.str();
+            return;
+        }
+    LOG(INFO) << "Checkpoint at " << signal_time_s << " s of the capture, with "
+              << satellites.size() << " tracked satellites, saved to " << file_name.str();
+}
+
+
+bool ControlThread::load_checkpoint()
+{
+    std::string file_name;
+    if (!Gnss_Receiver_State::find_checkpoint(checkpoint_dir_ + "/checkpoints.txt", resume_at_s_, file_name)
+            || !checkpoint_.load(file_name) || checkpoint_.signal_time_s < 0.0)
+        {
+            std::cout << "No checkpoint at or before " << resume_at_s_ << " s in " << checkpoint_dir_
+                      << ", processing the capture from its start" << std::endl;
+            LOG(WARNING) << "No checkpoint at or before " << resume_at_s_ << " s in " << checkpoint_dir_;
+            return false;
+        }
+    // the signal source seeks the checkpoint, and the acquisitions search
+    // around the Doppler shifts of the satellites tracked there
+    std::ostringstream seconds_to_skip;
+    seconds_to_skip << std::setprecision(17) << checkpoint_.signal_time_s;
+    configuration_->set_property("SignalSource.seconds_to_skip", seconds_to_skip.str());
+    configuration_->set_property("GNSS-SDR.reacquisition_memory", "true");
+    LOG(INFO) << "Resuming from the checkpoint " << file_name;
+    return true;
+}
+
+
+void ControlThread::configuration_watcher()
+{
+    std::shared_ptr<FileConfiguration> configuration = std::dynamic_pointer_cast<FileConfiguration>(configuration_);
+    boost::posix_time::ptime last_check = boost::posix_time::microsec_clock::universal_time();
+    while (!stop_)
+        {
+            boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+            boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+            if ((now - last_check).total_milliseconds() >= configuration_reload_period_ms_)
+                {
+                    // the control thread reloads it, as it does the other actions on the flowgraph
+                    if (configuration->modified())
+                        {
+                            Control_Event_Bus::send(control_queue_, Control_Event_Bus::receiver, Control_Event_Bus::reload_configuration);
+                        }
+                    last_check = now;
+                }
+        }
+}
+
+
+void ControlThread::reload_configuration()
+{
+    std::shared_ptr<FileConfiguration> configuration = std::dynamic_pointer_cast<FileConfiguration>(configuration_);
+    if (!configuration)
+        {
+            LOG(WARNING) << "The configuration is not read from a file, it cannot be reloaded";
+            return;
+        }
+    std::map<std::string, std::string> changed = configuration->reload();
+    if (!changed.empty())
+        {
+            flowgraph_->update_parameters(changed);
+        }
+}
+
+
+void ControlThread::metrics_collector()
+{
+    boost::posix_time::ptime last_sample = boost::posix_time::microsec_clock::universal_time();
+    metrics_->sample();
+    while (!stop_)
+        {
+            boost::this_thread::sleep(boost::posix_time::milliseconds(std::min(metrics_period_ms_, 100u)));
+            boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+            if ((now - last_sample).total_milliseconds() >= metrics_period_ms_)
+                {
+                    metrics_->sample();
+                    if (metrics_log_)
+                        {
+                            std::vector<std::string> lines = metrics_->summary();
+                            for (unsigned int i = 0; i < lines.size(); i++)
+                                {
+                                    LOG(INFO) << "Metrics: " << lines.at(i);
+                                }
+                        }
+                    last_sample = now;
+                }
+        }
+}
+
+
+void ControlThread::realtime_monitor()
+{
+    boost::posix_time::ptime last_sample = boost::posix_time::microsec_clock::universal_time();
+    Gnss_Sdr_Realtime_Monitor::sample();
+    bool margin_low = false;
+    boost::posix_time::ptime last_change = last_sample;  // of the channels shed
+    while (!stop_)
+        {
+            boost::this_thread::sleep(boost::posix_time::milliseconds(std::min(realtime_monitor_period_ms_, 100u)));
+            boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+            if ((now - last_sample).total_milliseconds() >= realtime_monitor_period_ms_)
+                {
+                    std::vector<Gnss_Sdr_Realtime_Monitor::Channel_Load> loads = Gnss_Sdr_Realtime_Monitor::sample();
+                    const double load = Gnss_Sdr_Realtime_Monitor::receiver_load(loads, realtime_cores_);
+                    DLOG(INFO) << "Real-time factor of the receiver " << load << " over " << realtime_cores_
+                               << " cores, " << loads.size() << " channels";
+                    // one event each time the margin drops, not one per sample
+                    if (!margin_low && 1.0 - load < realtime_margin_threshold_)
+                        {
+                            Control_Event_Bus::send(control_queue_, Control_Event_Bus::receiver, Control_Event_Bus::realtime_margin_low);
+                        }
+                    margin_low = 1.0 - load < realtime_margin_threshold_;
+                    // one channel shed per sample while the margin is low, so that the
+                    // next sample sees the effect, and one restored once it has held
+                    if (overload_shedding_ && margin_low)
+                        {
+                            Control_Event_Bus::send(control_queue_, Control_Event_Bus::receiver, Control_Event_Bus::realtime_overload);
+                            last_change = now;
+                        }
+                    else if (overload_shedding_ && overload_shed_channels_ > 0 && 1.0 - load > overload_restore_margin_
+                            && (now - last_change).total_milliseconds() >= overload_restore_delay_ms_)
+                        {
+                            Control_Event_Bus::send(control_queue_, Control_Event_Bus::receiver, Control_Event_Bus::realtime_headroom);
+                            last_change = now;
+                        }
+                    last_sample = now;
+                }
+        }
+}
+
+
+void ControlThread::realtime_margin_low()
+{
+    std::vector<Gnss_Sdr_Realtime_Monitor::Channel_Load> loads = Gnss_Sdr_Realtime_Monitor::loads();
+    const double load = Gnss_Sdr_Realtime_Monitor::receiver_load(loads, realtime_cores_);
+    std::sort(loads.begin(), loads.end(),
+            [](const Gnss_Sdr_Realtime_Monitor::Channel_Load & a, const Gnss_Sdr_Realtime_Monitor::Channel_Load & b) { return a.realtime_factor > b.realtime_factor; });
+    std::ostringstream costliest;
+    for (unsigned int i = 0; i < std::min(loads.size(), static_cast<size_t>(3)); i++)
+        {
+            costliest << " CH " << loads[i].channel << ": " << loads[i].realtime_factor;
+        }
+    realtime_margin_warnings_++;
+    LOG(WARNING) << "Real-time margin " << 1.0 - load << " below " << realtime_margin_threshold_
+                 << ", the signal source may overflow. Costliest channels:" << costliest.str();
+}
+
+
+void ControlThread::realtime_overload()
+{
+    if (flowgraph_->shed_channel(overload_min_channels_))
+        {
+            overload_sheds_++;
+        }
+    else
+        {
+            DLOG(INFO) << "No channel left to shed, " << overload_min_channels_ << " channels kept at least";
+        }
+    overload_shed_channels_ = flowgraph_->shed_channels();
+}
+
+
+void ControlThread::realtime_headroom()
+{
+    if (flowgraph_->restore_channel())
+        {
+            LOG(INFO) << "Real-time margin above " << overload_restore_margin_ << ", one shed channel restored";
+        }
+    overload_shed_channels_ = flowgraph_->shed_channels();
+}
+
+
+void ControlThread::latency_logger()
+{
+    boost::posix_time::ptime last_log = boost::posix_time::microsec_clock::universal_time();
+    while (!stop_)
+        {
+            boost::this_thread::sleep(boost::posix_time::milliseconds(std::min(latency_log_period_ms_, 100u)));
+            boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+            if ((now - last_log).total_milliseconds() >= latency_log_period_ms_)
+                {
+                    std::vector<std::string> lines = Gnss_Sdr_Latency_Tracer::summary();
+                    for (unsigned int i = 0; i < lines.size(); i++)
+                        {
+                            LOG(INFO) << "Latency of " << lines.at(i);
+                        }
+                    last_log = now;
+                }
+        }
+}
+
+
+void ControlThread::hw_counters_logger()
+{
+    boost::posix_time::ptime last_log = boost::posix_time::microsec_clock::universal_time();
+    while (!stop_)
+        {
+            boost::this_thread::sleep(boost::posix_time::milliseconds(std::min(hw_counters_log_period_ms_, 100u)));
+            boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+            if ((now - last_log).total_milliseconds() >= hw_counters_log_period_ms_)
+                {
+                    std::vector<std::string> lines = Gnss_Sdr_Hw_Counter_Registry::summary();
+                    for (unsigned int i = 0; i < lines.size(); i++)
+                        {
+                            LOG(INFO) << "Hardware counters of " << lines.at(i);
+                        }
+                    last_log = now;
+                }
+        }
+}
+
+
+void ControlThread::request_stop()
+{
+    Control_Event_Bus::send(control_queue_, Control_Event_Bus::receiver, Control_Event_Bus::stop);
+}
+
+
 void ControlThread::keyboard_listener()
 {
     bool read_keys = true;
     char c = '0';
     while(read_keys && !stop_)
         {
-            std::cin.get(c);
+            // blocks until a key, so there is no need to poll; stops at the end of the input
+            if (!std::cin.get(c)) break;
             if (c == 'q')
                 {
                     std::cout << "Quit keystroke order received, stopping GNSS-SDR !!" << std::endl;
-                    std::unique_ptr<ControlMessageFactory> cmf(new ControlMessageFactory());
-                    if (control_queue_ != gr::msg_queue::sptr())
-                        {
-                            control_queue_->handle(cmf->GetQueueMessage(200, 0));
-                        }
+                    Control_Event_Bus::send(control_queue_, Control_Event_Bus::receiver, Control_Event_Bus::stop);
                     read_keys = false;
                 }
-            usleep(500000);
         }
 }
@@ -35,12 +35,18 @@
 #ifndef GNSS_SDR_CONTROL_THREAD_H_
 #define GNSS_SDR_CONTROL_THREAD_H_
 
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <boost/thread.hpp>
 #include <gnuradio/msg_queue.h>
+#include "control_event_bus.h"
 #include "control_message_factory.h"
 #include "gnss_sdr_supl_client.h"
+#include "gnss_receiver_state.h"
+#include "acquisition_assistance.h"
+#include "gnss_block_metrics.h"
+#include "gnss_metrics_server.h"
 
 class GNSSFlowgraph;
 class ConfigurationInterface;
@@ -91,6 +97,9 @@ public:
      */
     void set_control_queue(boost::shared_ptr<gr::msg_queue> control_queue);
 
+    //! Asks the main loop of run() to stop the receiver, as the 'q' keystroke
+    void request_stop();
+
 
     unsigned int processed_control_messages()
     {
@@ -102,6 +111,30 @@ public:
         return applied_actions_;
     }
 
+    //! Overflows of the signal source reported so far (action 1 of who 200)
+    unsigned int signal_source_overflows()
+    {
+        return signal_source_overflows_;
+    }
+
+    //! Times the real-time margin dropped below GNSS-SDR.realtime_margin_threshold (action 3 of who 200)
+    unsigned int realtime_margin_warnings()
+    {
+        return realtime_margin_warnings_;
+    }
+
+    //! Channels shed by the overload protection, GNSS-SDR.overload_shedding (action 4 of who 200)
+    unsigned int overload_sheds()
+    {
+        return overload_sheds_;
+    }
+
+    //! Performance counters of the blocks, null unless GNSS-SDR.metrics_period_ms is set
+    std::shared_ptr<Gnss_Block_Metrics> metrics()
+    {
+        return metrics_;
+    }
+
     /*!
      * \brief Instantiates a flowgraph
      *
@@ -133,31 +166,148 @@ private:
 
     void process_control_messages();
 
+    // Applies a control event, from the bus or from a plain control queue
+    void process_control_message(const ControlMessage & message);
+
     /*
      * Blocking function that reads the GPS assistance queue
      */
     void gps_acq_assist_data_collector();
     
     /*
-     * Read initial GNSS assistance from SUPL server or local XML files
+     * Read initial GNSS assistance from SUPL server or local XML files.
+     * The requests run in supl_assistance_fetcher(), so the receiver does
+     * not wait for them, and the acquisition uses the assistance as soon as
+     * it arrives.
      */
     void assist_GNSS();
+
+    /*
+     * Loads the assistance cached in the XML files while they are valid,
+     * requests it from the SUPL server otherwise, and requests it again
+     * before it expires
+     */
+    void supl_assistance_fetcher();
+
+    // Requests ephemeris, almanac and acquisition assistance. Returns true if ephemeris arrived.
+    bool request_supl_assistance();
     
     
+    /*
+     * Saves the receiver state for the next start every receiver_state_period_s_
+     */
+    void receiver_state_saver();
+    void save_receiver_state();
+
+    /*
+     * Writes a checkpoint every checkpoint_period_s_ seconds of the capture,
+     * timed by the tracked epochs, and sets the signal source and the
+     * reacquisition memory to resume from one
+     */
+    void checkpoint_writer();
+    void save_checkpoint(double signal_time_s, const std::vector<Acquisition_Assistance::Tracked_Satellite> & satellites);
+    bool load_checkpoint();
+
+    /*
+     * Sends a reload_configuration event when the configuration file has
+     * changed, checked every configuration_reload_period_ms_
+     */
+    void configuration_watcher();
+
+    // Reads the configuration file again and sends the changes to the flowgraph
+    void reload_configuration();
+
+    // Samples the performance counters of the blocks every metrics_period_ms_
+    void metrics_collector();
+
+    // Samples the cost of the channels every realtime_monitor_period_ms_, and
+    // sends realtime_margin_low when the margin drops below the threshold,
+    // and with overload_shedding_, realtime_overload and realtime_headroom
+    void realtime_monitor();
+    void realtime_margin_low();
+    void realtime_overload();
+    void realtime_headroom();
+
+    // Logs the latency percentiles of the stages every latency_log_period_ms_
+    void latency_logger();
+
+    // Logs the hardware counters of the blocks every hw_counters_log_period_ms_
+    void hw_counters_logger();
+
     void apply_action(unsigned int what);
     std::shared_ptr<GNSSFlowgraph> flowgraph_;
     std::shared_ptr<ConfigurationInterface> configuration_;
     boost::shared_ptr<gr::msg_queue> control_queue_;
+    boost::shared_ptr<Control_Event_Bus> control_bus_;  // null if control_queue_ is a plain queue
     std::shared_ptr<ControlMessageFactory> control_message_factory_;
     std::shared_ptr<std::vector<std::shared_ptr<ControlMessage>>> control_messages_;
     bool stop_;
     bool delete_configuration_;
     unsigned int processed_control_messages_;
     unsigned int applied_actions_;
+    unsigned int signal_source_overflows_;
     boost::thread keyboard_thread_;
     boost::thread gps_acq_assist_data_collector_thread_;
+    boost::thread supl_assistance_thread_;
+    bool supl_assistance_running_;
+    boost::thread receiver_state_thread_;
+    boost::thread checkpoint_thread_;
+    boost::thread configuration_watcher_thread_;
+    unsigned int configuration_reload_period_ms_;  // 0 if disabled
+
+    // performance counters of the blocks
+    unsigned int metrics_period_ms_;  // 0 if disabled
+    bool metrics_log_;
+    std::shared_ptr<Gnss_Block_Metrics> metrics_;
+    std::unique_ptr<Gnss_Metrics_Server> metrics_server_;
+    boost::thread metrics_thread_;
+
+    // real-time factor of the tracking channels
+    unsigned int realtime_monitor_period_ms_;  // 0 if disabled
+    unsigned int realtime_cores_;
+    double realtime_margin_threshold_;
+    unsigned int realtime_margin_warnings_;
+    boost::thread realtime_monitor_thread_;
+
+    // overload protection: channels shed below the margin threshold, and
+    // restored one by one once the margin stays above overload_restore_margin_
+    bool overload_shedding_;
+    double overload_restore_margin_;
+    unsigned int overload_restore_delay_ms_;
+    unsigned int overload_min_channels_;
+    unsigned int overload_sheds_;
+    std::atomic<unsigned int> overload_shed_channels_;  // shed now, read by the monitor thread
+
+    // no heap allocation in the block threads after the start, see Gnss_Sdr_Allocation_Tracker
+    bool no_allocation_;
+    bool no_allocation_abort_;
+    double no_allocation_after_s_;  // of running, so that the channels settle first
+
+    // end-to-end latency, see Gnss_Sdr_Latency_Tracer
+    unsigned int latency_log_period_ms_;  // 0 if only reported at the end
+    boost::thread latency_thread_;
+
+    // cycles, instructions and misses of the tracking blocks, see Gnss_Sdr_Hw_Counter_Registry
+    unsigned int hw_counters_log_period_ms_;  // 0 if only reported at the end
+    boost::thread hw_counters_thread_;
+
+    // warm start
+    std::string receiver_state_file_;  // empty if disabled
+    double receiver_state_period_s_;
+    bool receiver_state_loaded_;
+    bool receiver_state_binary_;       // saved in the binary format, loaded in either
+    Gnss_Receiver_State receiver_state_;  // loaded at init()
+
+    // checkpoints of a post-processing run
+    double checkpoint_period_s_;  // 0 if disabled
+    std::string checkpoint_dir_;
+    double resume_at_s_;          // negative if not resuming
+    double seconds_skipped_;      // start of this run in the capture
+    bool checkpoint_loaded_;
+    Gnss_Receiver_State checkpoint_;  // loaded at init()
     
     void keyboard_listener();
+    bool keyboard_listener_;  // false if the keys are read by the host of several receivers
 
     // default filename for assistance data
     const std::string eph_default_xml_filename = "./gps_ephemeris.xml";
@@ -35,9 +35,10 @@
 
 #include "file_configuration.h"
 #include <string>
+#include <boost/filesystem.hpp>
 #include <glog/logging.h>
 #include "INIReader.h"
-#include "string_converter.h"
+#include "configuration_snapshot.h"
 #include "in_memory_configuration.h"
 
 using google::LogMessage;
@@ -70,7 +71,7 @@ std::string FileConfiguration::property(std::string property_name, std::string d
         }
     else
         {
-            return ini_reader_->Get("GNSS-SDR", property_name, default_value);
+            return std::atomic_load(&snapshot_)->get(property_name, default_value);
         }
 }
 
@@ -83,8 +84,7 @@ bool FileConfiguration::property(std::string property_name, bool default_value)
         }
     else
         {
-            std::string empty = "";
-            return converter_->convert(property(property_name, empty), default_value);
+            return std::atomic_load(&snapshot_)->get(property_name, default_value);
         }
 }
 
@@ -97,8 +97,7 @@ long FileConfiguration::property(std::string property_name, long default_value)
         }
     else
         {
-            std::string empty = "";
-            return converter_->convert(property(property_name, empty), default_value);
+            return std::atomic_load(&snapshot_)->get(property_name, default_value);
         }
 }
 
@@ -112,8 +111,7 @@ int FileConfiguration::property(std::string property_name, int default_value)
         }
     else
         {
-            std::string empty = "";
-            return converter_->convert(property(property_name, empty), default_value);
+            return std::atomic_load(&snapshot_)->get(property_name, default_value);
         }
 }
 
@@ -127,8 +125,7 @@ unsigned int FileConfiguration::property(std::string property_name, unsigned int
         }
     else
         {
-            std::string empty = "";
-            return converter_->convert(property(property_name, empty), default_value);
+            return std::atomic_load(&snapshot_)->get(property_name, default_value);
         }
 }
 
@@ -142,8 +139,7 @@ unsigned short FileConfiguration::property(std::string property_name, unsigned s
         }
     else
         {
-            std::string empty = "";
-            return converter_->convert(property(property_name, empty), default_value);
+            return std::atomic_load(&snapshot_)->get(property_name, default_value);
         }
 }
 
@@ -157,8 +153,7 @@ float FileConfiguration::property(std::string property_name, float default_value
         }
     else
         {
-            std::string empty = "";
-            return converter_->convert(property(property_name, empty), default_value);
+            return std::atomic_load(&snapshot_)->get(property_name, default_value);
         }
 }
 
@@ -171,8 +166,7 @@ double FileConfiguration::property(std::string property_name, double default_val
         }
     else
         {
-            std::string empty = "";
-            return converter_->convert(property(property_name, empty), default_value);
+            return std::atomic_load(&snapshot_)->get(property_name, default_value);
         }
 }
 
@@ -187,9 +181,10 @@ void FileConfiguration::set_property(std::string property_name, std::string valu
 
 void FileConfiguration::init()
 {
-    std::unique_ptr<StringConverter> converter_(new StringConverter);
     overrided_ = std::make_shared<InMemoryConfiguration>();
+    last_write_time_ = last_write_time();
     ini_reader_ = std::make_shared<INIReader>(filename_);
+    snapshot_ = std::make_shared<const Configuration_Snapshot>(ini_reader_->Values(), "gnss-sdr");
     error_ = ini_reader_->ParseError();
     if(error_ == 0)
         {
@@ -206,3 +201,51 @@ void FileConfiguration::init()
 }
 
 
+
+
+
+std::time_t FileConfiguration::last_write_time()
+{
+    boost::system::error_code ec;
+    std::time_t time = boost::filesystem::last_write_time(filename_, ec);
+    return ec ? 0 : time;
+}
+
+
+bool FileConfiguration::modified()
+{
+    return last_write_time() != last_write_time_;
+}
+
+
+std::map<std::string, std::string> FileConfiguration::reload()
+{
+    std::map<std::string, std::string> changed;
+    last_write_time_ = last_write_time();
+    std::shared_ptr<INIReader> ini_reader = std::make_shared<INIReader>(filename_);
+    if (ini_reader->ParseError() != 0)
+        {
+            LOG(WARNING) << "Configuration file " << filename_ << " not reloaded, error in line " << ini_reader->ParseError();
+            return changed;
+        }
+    const std::string section = "gnss-sdr.";
+    std::shared_ptr<INIReader> old_ini_reader = std::atomic_load(&ini_reader_);
+    const std::map<std::string, std::string>& old_values = old_ini_reader->Values();
+    const std::map<std::string, std::string>& new_values = ini_reader->Values();
+    for (std::map<std::string, std::string>::const_iterator it = new_values.begin(); it != new_values.end(); ++it)
+        {
+            if (it->first.compare(0, section.size(), section) != 0)
+                {
+                    continue;
+                }
+            std::map<std::string, std::string>::const_iterator old = old_values.find(it->first);
+            if (old == old_values.end() || old->second != it->second)
+                {
+                    changed[it->first.substr(section.size())] = it->second;
+                }
+        }
+    std::atomic_store(&snapshot_, std::make_shared<const Configuration_Snapshot>(new_values, "gnss-sdr"));
+    std::atomic_store(&ini_reader_, ini_reader);
+    LOG(INFO) << "Configuration file " << filename_ << " reloaded, " << changed.size() << " properties changed";
+    return changed;
+}
@@ -38,11 +38,14 @@
 #define GNSS_SDR_FILE_CONFIGURATION_H_
 
 #include "configuration_interface.h"
+#include <atomic>
+#include <ctime>
+#include <map>
 #include <memory>
 #include <string>
 
 class INIReader;
-class StringConverter;
+class Configuration_Snapshot;
 class InMemoryConfiguration;
 
 /*!
@@ -70,12 +73,26 @@ public:
     float property(std::string property_name, float default_value);
     double property(std::string property_name, double default_value);
     void set_property(std::string property_name, std::string value);
+
+    //! True if the file has been written since it was last read
+    bool modified();
+
+    /*!
+     * \brief Reads the file again, and returns the properties whose value is
+     * new or has changed, by lower case name. A file with errors is not
+     * taken, and nothing changes.
+     *
+     * The properties can be read from other threads meanwhile.
+     */
+    std::map<std::string, std::string> reload();
 private:
     void init();
+    std::time_t last_write_time();
+    std::atomic<std::time_t> last_write_time_;  // read by the thread that watches the file
     std::string filename_;
     std::shared_ptr<INIReader> ini_reader_;
     std::shared_ptr<InMemoryConfiguration> overrided_;
-    std::unique_ptr<StringConverter> converter_;
+    std::shared_ptr<const Configuration_Snapshot> snapshot_;  // the values of ini_reader_, converted
     int error_;
 };
 
@@ -0,0 +1,73 @@
+/*!
+ * \file gnss_assistance_cache.cc
+ * \brief Validity of the assistance data cached on disk
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_assistance_cache.h"
+#include <algorithm>
+#include <boost/filesystem.hpp>
+
+
+Gnss_Assistance_Cache::Gnss_Assistance_Cache(const std::string & filename, double ttl_s, double refresh_margin_s)
+{
+    d_filename = filename;
+    d_ttl_s = std::max(ttl_s, 0.0);
+    // the data are used for some time before each refresh
+    d_refresh_margin_s = std::min(std::max(refresh_margin_s, 0.0), d_ttl_s / 2.0);
+}
+
+
+double Gnss_Assistance_Cache::age_s(std::time_t now) const
+{
+    boost::system::error_code ec;
+    std::time_t written = boost::filesystem::last_write_time(d_filename, ec);
+    if (ec || written == static_cast<std::time_t>(-1))
+        {
+            return -1.0;
+        }
+    // a file written in the future, after a clock change, is as old as possible
+    return written > now ? d_ttl_s : std::difftime(now, written);
+}
+
+
+bool Gnss_Assistance_Cache::fresh(std::time_t now) const
+{
+    const double age = age_s(now);
+    return age >= 0.0 && age < d_ttl_s;
+}
+
+
+double Gnss_Assistance_Cache::refresh_in_s(std::time_t now) const
+{
+    const double age = age_s(now);
+    if (age < 0.0)
+        {
+            return 0.0;
+        }
+    return std::max(d_ttl_s - d_refresh_margin_s - age, 0.0);
+}
@@ -0,0 +1,73 @@
+/*!
+ * \file gnss_assistance_cache.h
+ * \brief Validity of the assistance data cached on disk
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The assistance received from the SUPL server is saved to an XML file. The
+ * modification time of that file is the time of the download, so a restart
+ * within the time to live of the data loads the file instead of going to
+ * the network again, and the data are downloaded again a margin before they
+ * expire.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_ASSISTANCE_CACHE_H_
+#define GNSS_SDR_GNSS_ASSISTANCE_CACHE_H_
+
+#include <ctime>
+#include <string>
+
+class Gnss_Assistance_Cache
+{
+public:
+    /*!
+     * \param filename         XML file of the cached data
+     * \param ttl_s            Time the data are valid after their download [s]
+     * \param refresh_margin_s Time before the expiry to download them again [s]
+     */
+    Gnss_Assistance_Cache(const std::string & filename, double ttl_s, double refresh_margin_s);
+
+    //! Age of the cached data at now [s], negative if there are none
+    double age_s(std::time_t now) const;
+
+    //! True if the file exists and its data have not expired at now
+    bool fresh(std::time_t now) const;
+
+    //! Time from now to the next download [s], 0 if it is due
+    double refresh_in_s(std::time_t now) const;
+
+    const std::string & filename() const
+    {
+        return d_filename;
+    }
+
+private:
+    std::string d_filename;
+    double d_ttl_s;
+    double d_refresh_margin_s;
+};
+
+#endif /* GNSS_SDR_GNSS_ASSISTANCE_CACHE_H_ */
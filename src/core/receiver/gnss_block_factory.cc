@@ -37,39 +37,59 @@
 #include "gnss_block_factory.h"
 #include <string>
 #include <sstream>
+#include <unordered_map>
 #include <iostream>
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/lexical_cast.hpp>
 #include <glog/logging.h>
 #include "configuration_interface.h"
 #include "gnss_block_interface.h"
+#include "gnss_sdr_memory_accounting.h"
+#include "gnss_sdr_numa.h"
 #include "pass_through.h"
 #include "file_signal_source.h"
+#include "mmap_file_signal_source.h"
+#include "memory_signal_source.h"
+#include "capture_replay_signal_source.h"
+#include "compressed_file_signal_source.h"
 #include "nsr_file_signal_source.h"
 #include "two_bit_cpx_file_signal_source.h"
 #include "spir_file_signal_source.h"
 #include "rtl_tcp_signal_source.h"
+#include "udp_signal_source.h"
 #include "two_bit_packed_file_signal_source.h"
 #include "channel.h"
 
 #include "signal_conditioner.h"
 #include "array_signal_conditioner.h"
+#include "fused_signal_conditioner.h"
+#include "channelizer_signal_conditioner.h"
 #include "byte_to_short.h"
 #include "ibyte_to_cbyte.h"
 #include "ibyte_to_cshort.h"
 #include "ibyte_to_complex.h"
 #include "ishort_to_cshort.h"
+#include "agc_requantizer_adapter.h"
 #include "ishort_to_complex.h"
 #include "direct_resampler_conditioner.h"
+#include "fractional_resampler_conditioner.h"
 #include "fir_filter.h"
+#include "fft_fir_filter_adapter.h"
+#include "pulse_blanking_filter.h"
 #include "freq_xlating_fir_filter.h"
 #include "beamformer_filter.h"
+#include "beam_steering_filter.h"
 #include "gps_l1_ca_pcps_acquisition.h"
 #include "gps_l2_m_pcps_acquisition.h"
+#include "gps_l2_m_pcps_segmented_acquisition.h"
 #include "gps_l1_ca_pcps_multithread_acquisition.h"
 #include "gps_l1_ca_pcps_tong_acquisition.h"
 #include "gps_l1_ca_pcps_assisted_acquisition.h"
 #include "gps_l1_ca_pcps_acquisition_fine_doppler.h"
 #include "gps_l1_ca_pcps_quicksync_acquisition.h"
+#include "gps_l1_ca_pcps_shifted_spectrum_acquisition.h"
+#include "gps_l1_ca_pcps_fixed_point_acquisition.h"
+#include "gps_l1_ca_pcps_remote_acquisition.h"
 #include "galileo_e1_pcps_ambiguous_acquisition.h"
 #include "galileo_e1_pcps_8ms_ambiguous_acquisition.h"
 #include "galileo_e1_pcps_tong_ambiguous_acquisition.h"
@@ -91,6 +111,9 @@
 #include "gps_l1_ca_observables.h"
 #include "galileo_e1_observables.h"
 #include "hybrid_observables.h"
+#include "observables_stream_sink_adapter.h"
+#include "observables_stream_source_adapter.h"
+#include "rinex_observables_source_adapter.h"
 #include "gps_l1_ca_pvt.h"
 #include "galileo_e1_pvt.h"
 #include "hybrid_pvt.h"
@@ -121,6 +144,7 @@
 
 #if CUDA_GPU_ACCEL
 #include "gps_l1_ca_dll_pll_tracking_gpu.h"
+#include "gps_l1_ca_pcps_cuda_acquisition.h"
 #endif
 
 
@@ -160,6 +184,7 @@ std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetSignalConditioner(
     std::string role_datatypeadapter = "DataTypeAdapter";
     std::string role_inputfilter = "InputFilter";
     std::string role_resampler = "Resampler";
+    std::string role_mitigation = "InterferenceMitigation";
 
     if (ID != -1)
         {
@@ -167,6 +192,7 @@ std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetSignalConditioner(
             role_datatypeadapter = "DataTypeAdapter" + boost::lexical_cast<std::string>(ID);
             role_inputfilter = "InputFilter" + boost::lexical_cast<std::string>(ID);
             role_resampler = "Resampler" + boost::lexical_cast<std::string>(ID);
+            role_mitigation = "InterferenceMitigation" + boost::lexical_cast<std::string>(ID);
         }
 
     std::string signal_conditioner = configuration->property(role_conditioner + ".implementation", default_implementation);
@@ -174,17 +200,20 @@ std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetSignalConditioner(
     std::string data_type_adapter;
     std::string input_filter;
     std::string resampler;
+    std::string mitigation;
     if(signal_conditioner.compare("Pass_Through") == 0)
         {
             data_type_adapter = "Pass_Through";
             input_filter = "Pass_Through";
             resampler = "Pass_Through";
+            mitigation = "Pass_Through";
         }
     else
         {
             data_type_adapter = configuration->property(role_datatypeadapter + ".implementation", default_implementation);
             input_filter = configuration->property(role_inputfilter + ".implementation", default_implementation);
             resampler = configuration->property(role_resampler + ".implementation", default_implementation);
+            mitigation = configuration->property(role_mitigation + ".implementation", default_implementation);
         }
 
     LOG(INFO) << "Getting SignalConditioner with DataTypeAdapter implementation: "
@@ -192,6 +221,20 @@ std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetSignalConditioner(
             << input_filter << ", and Resampler implementation: "
             << resampler;
 
+    if(signal_conditioner.compare("Fused_Signal_Conditioner") == 0)
+        {
+            // a single block instead of the data type adapter, input filter and resampler
+            std::unique_ptr<GNSSBlockInterface> conditioner_(new FusedSignalConditioner(configuration.get(),
+                role_conditioner, role_inputfilter, 1, 1));
+            return conditioner_;
+        }
+    if(signal_conditioner.compare("Channelizer_Signal_Conditioner") == 0)
+        {
+            // a single block with one output per sub-band
+            std::unique_ptr<GNSSBlockInterface> conditioner_(new ChannelizerSignalConditioner(configuration.get(),
+                role_conditioner, 1, 1));
+            return conditioner_;
+        }
     if(signal_conditioner.compare("Array_Signal_Conditioner") == 0)
         {
             //instantiate the array version
@@ -204,19 +247,25 @@ std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetSignalConditioner(
         }
     else
         {
-            //single-antenna version
+            //single-antenna version, the interference mitigation stage only exists if configured
+            std::shared_ptr<GNSSBlockInterface> mitigation_block;
+            if(mitigation.compare("Pass_Through") != 0)
+                {
+                    mitigation_block = std::move(GetBlock(configuration, role_mitigation, mitigation, 1, 1));
+                }
             std::unique_ptr<GNSSBlockInterface> conditioner_(new SignalConditioner(configuration.get(),
                 std::move(GetBlock(configuration, role_datatypeadapter, data_type_adapter, 1, 1)),
                 std::move(GetBlock(configuration, role_inputfilter, input_filter, 1, 1)),
                 std::move(GetBlock(configuration, role_resampler, resampler, 1, 1)),
-                role_conditioner, "Signal_Conditioner"));
+                role_conditioner, "Signal_Conditioner", mitigation_block));
             return conditioner_;
         }
 }
 
 
 
-std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetObservables(std::shared_ptr<ConfigurationInterface> configuration)
+std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetObservables(std::shared_ptr<ConfigurationInterface> configuration,
+        boost::shared_ptr<gr::msg_queue> queue)
 {
     std::string default_implementation = "GPS_L1_CA_Observables";
     std::string implementation = configuration->property("Observables.implementation", default_implementation);
@@ -225,7 +274,7 @@ std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetObservables(std::shared
     Galileo_channels += configuration->property("Channels_5X.count", 0);
     unsigned int GPS_channels = configuration->property("Channels_1C.count", 0);
     GPS_channels += configuration->property("Channels_2S.count", 0);
-    return GetBlock(configuration, "Observables", implementation, Galileo_channels + GPS_channels, Galileo_channels + GPS_channels);
+    return GetBlock(configuration, "Observables", implementation, Galileo_channels + GPS_channels, Galileo_channels + GPS_channels, queue);
 }
 
 
@@ -286,12 +335,13 @@ std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetChannel_1C(
             appendix3 = ""; 
         }
 
-    std::unique_ptr<GNSSBlockInterface> pass_through_ = GetBlock(configuration, "Channel", "Pass_Through", 1, 1, queue);
+    // memory of the blocks of the channel, and of the channel
+    Gnss_Sdr_Memory_Accounting::Scope memory_scope("Channel" + boost::lexical_cast<std::string>(channel));
     std::unique_ptr<AcquisitionInterface> acq_ = GetAcqBlock(configuration, "Acquisition_1C" + appendix1, acq, 1, 0);
     std::unique_ptr<TrackingInterface> trk_ = GetTrkBlock(configuration, "Tracking_1C"+ appendix2, trk, 1, 1);
     std::unique_ptr<TelemetryDecoderInterface> tlm_ = GetTlmBlock(configuration, "TelemetryDecoder_1C" + appendix3, tlm, 1, 1);
 
-    std::unique_ptr<GNSSBlockInterface> channel_(new Channel(configuration.get(), channel, std::move(pass_through_),
+    std::unique_ptr<GNSSBlockInterface> channel_(new Channel(configuration.get(), channel,
             std::move(acq_),
             std::move(trk_),
             std::move(tlm_),
@@ -340,12 +390,12 @@ std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetChannel_2S(
             appendix3 = ""; 
         }
 
-    std::unique_ptr<GNSSBlockInterface> pass_through_ = GetBlock(configuration, "Channel", "Pass_Through", 1, 1, queue);
+    Gnss_Sdr_Memory_Accounting::Scope memory_scope("Channel" + boost::lexical_cast<std::string>(channel));
     std::unique_ptr<AcquisitionInterface> acq_ = GetAcqBlock(configuration, "Acquisition_2S" + appendix1 , acq, 1, 0);
     std::unique_ptr<TrackingInterface> trk_ = GetTrkBlock(configuration, "Tracking_2S" + appendix2, trk, 1, 1);
     std::unique_ptr<TelemetryDecoderInterface> tlm_ = GetTlmBlock(configuration, "TelemetryDecoder_2S" + appendix3, tlm, 1, 1);
 
-    std::unique_ptr<GNSSBlockInterface> channel_(new Channel(configuration.get(), channel, std::move(pass_through_),
+    std::unique_ptr<GNSSBlockInterface> channel_(new Channel(configuration.get(), channel,
             std::move(acq_),
             std::move(trk_),
             std::move(tlm_),
@@ -396,12 +446,12 @@ std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetChannel_1B(
             appendix3 = ""; 
         }
 
-    std::unique_ptr<GNSSBlockInterface> pass_through_ = GetBlock(configuration, "Channel", "Pass_Through", 1, 1, queue);
+    Gnss_Sdr_Memory_Accounting::Scope memory_scope("Channel" + boost::lexical_cast<std::string>(channel));
     std::unique_ptr<AcquisitionInterface> acq_ = GetAcqBlock(configuration, "Acquisition_1B" + appendix1, acq, 1, 0);
     std::unique_ptr<TrackingInterface> trk_ = GetTrkBlock(configuration, "Tracking_1B" + appendix2, trk, 1, 1);
     std::unique_ptr<TelemetryDecoderInterface> tlm_ = GetTlmBlock(configuration, "TelemetryDecoder_1B" + appendix3, tlm, 1, 1);
 
-    std::unique_ptr<GNSSBlockInterface> channel_(new Channel(configuration.get(), channel, std::move(pass_through_),
+    std::unique_ptr<GNSSBlockInterface> channel_(new Channel(configuration.get(), channel,
             std::move(acq_),
             std::move(trk_),
             std::move(tlm_),
@@ -452,12 +502,12 @@ std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetChannel_5X(
             appendix3 = ""; 
         }
 
-    std::unique_ptr<GNSSBlockInterface> pass_through_ = GetBlock(configuration, "Channel", "Pass_Through", 1, 1, queue);
+    Gnss_Sdr_Memory_Accounting::Scope memory_scope("Channel" + boost::lexical_cast<std::string>(channel));
     std::unique_ptr<AcquisitionInterface> acq_ = GetAcqBlock(configuration, "Acquisition_5X" + appendix1, acq, 1, 0);
     std::unique_ptr<TrackingInterface> trk_ = GetTrkBlock(configuration, "Tracking_5X" + appendix2, trk, 1, 1);
     std::unique_ptr<TelemetryDecoderInterface> tlm_ = GetTlmBlock(configuration, "TelemetryDecoder_5X" + appendix3, tlm, 1, 1);
 
-    std::unique_ptr<GNSSBlockInterface> channel_(new Channel(configuration.get(), channel, std::move(pass_through_),
+    std::unique_ptr<GNSSBlockInterface> channel_(new Channel(configuration.get(), channel,
             std::move(acq_),
             std::move(trk_),
             std::move(tlm_),
@@ -511,12 +561,19 @@ std::unique_ptr<std::vector<std::unique_ptr<GNSSBlockInterface>>> GNSSBlockFacto
                             telemetry_decoder_implementation);
 
             // Push back the channel to the vector of channels
-             channels->at(channel_absolute_id) = std::move(GetChannel_1C(configuration,
-                     acquisition_implementation_specific,
-                     tracking_implementation_specific,
-                     telemetry_decoder_implementation_specific,
-                     channel_absolute_id,
-                     queue));
+            boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+            // on the NUMA node of the channel, where its buffers are first touched
+            Gnss_Sdr_Numa::run_on_node(Gnss_Sdr_Numa::channel_node(configuration, channel_absolute_id), [&]()
+                    {
+                        channels->at(channel_absolute_id) = std::move(GetChannel_1C(configuration,
+                                acquisition_implementation_specific,
+                                tracking_implementation_specific,
+                                telemetry_decoder_implementation_specific,
+                                channel_absolute_id,
+                                queue));
+                    });
+            LOG(INFO) << "Startup: channel " << channel_absolute_id << " (1C) created in "
+                      << (boost::posix_time::microsec_clock::universal_time() - start).total_milliseconds() << " ms";
              channel_absolute_id++;
         }
 
@@ -540,12 +597,19 @@ std::unique_ptr<std::vector<std::unique_ptr<GNSSBlockInterface>>> GNSSBlockFacto
                             telemetry_decoder_implementation);
 
             // Push back the channel to the vector of channels
-             channels->at(channel_absolute_id) = std::move(GetChannel_2S(configuration,
-                     acquisition_implementation_specific,
-                     tracking_implementation_specific,
-                     telemetry_decoder_implementation_specific,
-                     channel_absolute_id,
-                     queue));
+            boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+            // on the NUMA node of the channel, where its buffers are first touched
+            Gnss_Sdr_Numa::run_on_node(Gnss_Sdr_Numa::channel_node(configuration, channel_absolute_id), [&]()
+                    {
+                        channels->at(channel_absolute_id) = std::move(GetChannel_2S(configuration,
+                                acquisition_implementation_specific,
+                                tracking_implementation_specific,
+                                telemetry_decoder_implementation_specific,
+                                channel_absolute_id,
+                                queue));
+                    });
+            LOG(INFO) << "Startup: channel " << channel_absolute_id << " (2S) created in "
+                      << (boost::posix_time::microsec_clock::universal_time() - start).total_milliseconds() << " ms";
              channel_absolute_id++;
         }
 
@@ -570,12 +634,19 @@ std::unique_ptr<std::vector<std::unique_ptr<GNSSBlockInterface>>> GNSSBlockFacto
                                telemetry_decoder_implementation);
 
                // Push back the channel to the vector of channels
-                channels->at(channel_absolute_id) = std::move(GetChannel_1B(configuration,
-                        acquisition_implementation_specific,
-                        tracking_implementation_specific,
-                        telemetry_decoder_implementation_specific,
-                        channel_absolute_id,
-                        queue));
+               boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+                // on the NUMA node of the channel, where its buffers are first touched
+                Gnss_Sdr_Numa::run_on_node(Gnss_Sdr_Numa::channel_node(configuration, channel_absolute_id), [&]()
+                        {
+                            channels->at(channel_absolute_id) = std::move(GetChannel_1B(configuration,
+                                    acquisition_implementation_specific,
+                                    tracking_implementation_specific,
+                                    telemetry_decoder_implementation_specific,
+                                    channel_absolute_id,
+                                    queue));
+                        });
+               LOG(INFO) << "Startup: channel " << channel_absolute_id << " (1B) created in "
+                         << (boost::posix_time::microsec_clock::universal_time() - start).total_milliseconds() << " ms";
                 channel_absolute_id++;
            }
 
@@ -600,12 +671,19 @@ std::unique_ptr<std::vector<std::unique_ptr<GNSSBlockInterface>>> GNSSBlockFacto
                                telemetry_decoder_implementation);
 
                // Push back the channel to the vector of channels
-                channels->at(channel_absolute_id) = std::move(GetChannel_5X(configuration,
-                        acquisition_implementation_specific,
-                        tracking_implementation_specific,
-                        telemetry_decoder_implementation_specific,
-                        channel_absolute_id,
-                        queue));
+               boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+                // on the NUMA node of the channel, where its buffers are first touched
+                Gnss_Sdr_Numa::run_on_node(Gnss_Sdr_Numa::channel_node(configuration, channel_absolute_id), [&]()
+                        {
+                            channels->at(channel_absolute_id) = std::move(GetChannel_5X(configuration,
+                                    acquisition_implementation_specific,
+                                    tracking_implementation_specific,
+                                    telemetry_decoder_implementation_specific,
+                                    channel_absolute_id,
+                                    queue));
+                        });
+               LOG(INFO) << "Startup: channel " << channel_absolute_id << " (5X) created in "
+                         << (boost::posix_time::microsec_clock::universal_time() - start).total_milliseconds() << " ms";
                 channel_absolute_id++;
            }
 
@@ -613,555 +691,307 @@ std::unique_ptr<std::vector<std::unique_ptr<GNSSBlockInterface>>> GNSSBlockFacto
 }
 
 /*
- * Returns the block with the required configuration and implementation
+ * Creators of the blocks, one per kind of constructor
+ */
+namespace
+{
+template <class T>
+std::unique_ptr<GNSSBlockInterface> make_block(ConfigurationInterface* configuration,
+        const std::string& role, const std::string& implementation __attribute__((unused)),
+        unsigned int in_streams, unsigned int out_streams,
+        boost::shared_ptr<gr::msg_queue> queue __attribute__((unused)))
+{
+    return std::unique_ptr<GNSSBlockInterface>(new T(configuration, role, in_streams, out_streams));
+}
+
+
+template <class T>
+std::unique_ptr<GNSSBlockInterface> make_source(ConfigurationInterface* configuration,
+        const std::string& role, const std::string& implementation __attribute__((unused)),
+        unsigned int in_streams, unsigned int out_streams,
+        boost::shared_ptr<gr::msg_queue> queue)
+{
+    return std::unique_ptr<GNSSBlockInterface>(new T(configuration, role, in_streams, out_streams, queue));
+}
+
+
+// File sources end the program if the file cannot be opened
+template <class T>
+std::unique_ptr<GNSSBlockInterface> make_file_source(ConfigurationInterface* configuration,
+        const std::string& role, const std::string& implementation,
+        unsigned int in_streams, unsigned int out_streams,
+        boost::shared_ptr<gr::msg_queue> queue)
+{
+    try
+    {
+            return make_source<T>(configuration, role, implementation, in_streams, out_streams, queue);
+    }
+    catch (const std::exception &e)
+    {
+            std::cout << "GNSS-SDR program ended." << std::endl;
+            exit(1);
+    }
+}
+
+
+std::unique_ptr<GNSSBlockInterface> make_fractional_resampler(ConfigurationInterface* configuration,
+        const std::string& role, const std::string& implementation,
+        unsigned int in_streams, unsigned int out_streams,
+        boost::shared_ptr<gr::msg_queue> queue __attribute__((unused)))
+{
+    return std::unique_ptr<GNSSBlockInterface>(new FractionalResamplerConditioner(configuration, role,
+            implementation, in_streams, out_streams));
+}
+
+
+template <class Interface, class T>
+std::unique_ptr<Interface> make_channel_block(ConfigurationInterface* configuration,
+        const std::string& role, unsigned int in_streams, unsigned int out_streams)
+{
+    return std::unique_ptr<Interface>(new T(configuration, role, in_streams, out_streams));
+}
+
+
+/*
+ * The implementations known to the factory, by name. The tables are built
+ * the first time they are used, so that the registrations made by other
+ * translation units during static initialization find them.
  *
  * PLEASE ADD YOUR NEW BLOCK HERE!!
  *
- * IMPORTANT NOTE: Acquisition, Tracking and telemetry blocks are only included here for testing purposes.
- * To be included in a channel they must be also be included in GetAcqBlock(), GetTrkBlock() and GetTlmBlock()
- * (see below)
+ * Acquisition, tracking and telemetry blocks go only to their own table,
+ * which GetBlock() also looks up.
  */
-std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetBlock(
-        std::shared_ptr<ConfigurationInterface> configuration,
-        std::string role,
-        std::string implementation, unsigned int in_streams,
-        unsigned int out_streams, boost::shared_ptr<gr::msg_queue> queue)
+std::unordered_map<std::string, GNSSBlockFactory::BlockCreator>& block_table()
 {
-    std::unique_ptr<GNSSBlockInterface> block;
-
-    //PASS THROUGH ----------------------------------------------------------------
-    if (implementation.compare("Pass_Through") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new Pass_Through(configuration.get(), role, in_streams, out_streams));
-            block = std::move(block_);
-        }
-
-    // SIGNAL SOURCES -------------------------------------------------------------
-    else if (implementation.compare("File_Signal_Source") == 0)
-        {
-            try
-            {
-                    std::unique_ptr<GNSSBlockInterface> block_(new FileSignalSource(configuration.get(), role, in_streams,
-                            out_streams, queue));
-                    block = std::move(block_);
-            }
-
-            catch (const std::exception &e)
-            {
-                    std::cout << "GNSS-SDR program ended." << std::endl;
-                    exit(1);
-            }
-        }
-    else if (implementation.compare("Nsr_File_Signal_Source") == 0)
-        {
-            try
-            {
-                    std::unique_ptr<GNSSBlockInterface> block_(new NsrFileSignalSource(configuration.get(), role, in_streams,
-                            out_streams, queue));
-                    block = std::move(block_);
-
-            }
-            catch (const std::exception &e)
-            {
-                    std::cout << "GNSS-SDR program ended." << std::endl;
-                    exit(1);
-            }
-        }
+    static std::unordered_map<std::string, GNSSBlockFactory::BlockCreator> table = {
+            // PASS THROUGH ------------------------------------------------------------
+            { "Pass_Through", &make_block<Pass_Through> },
+
+            // SIGNAL SOURCES ----------------------------------------------------------
+            { "File_Signal_Source", &make_file_source<FileSignalSource> },
+            { "Mmap_File_Signal_Source", &make_file_source<MmapFileSignalSource> },
+            { "Capture_Replay_Signal_Source", &make_file_source<CaptureReplaySignalSource> },
+            { "Compressed_File_Signal_Source", &make_file_source<CompressedFileSignalSource> },
+            { "Memory_Signal_Source", &make_source<MemorySignalSource> },
+            { "Nsr_File_Signal_Source", &make_file_source<NsrFileSignalSource> },
 #if MODERN_GNURADIO
-    else if (implementation.compare("Two_Bit_Cpx_File_Signal_Source") == 0)
-        {
-            try
-            {
-                    std::unique_ptr<GNSSBlockInterface> block_(new TwoBitCpxFileSignalSource(configuration.get(), role, in_streams,
-                            out_streams, queue));
-                    block = std::move(block_);
-
-            }
-            catch (const std::exception &e)
-            {
-                    std::cout << "GNSS-SDR program ended." << std::endl;
-                    exit(1);
-            }
-        }
-    else if(implementation.compare("Two_Bit_Packed_File_Signal_Source") == 0 )
-        {
-            try
-            {
-                std::unique_ptr<GNSSBlockInterface> block_(new TwoBitPackedFileSignalSource(configuration.get(), role, in_streams,
-                            out_streams, queue));
-                block = std::move(block_);
-            }
-            catch(const std::exception &e)
-            {
-                std::cout << "GNSS-SDR program ended." << std::endl;
-                exit(1);
-            }
-        }
+            { "Two_Bit_Cpx_File_Signal_Source", &make_file_source<TwoBitCpxFileSignalSource> },
+            { "Two_Bit_Packed_File_Signal_Source", &make_file_source<TwoBitPackedFileSignalSource> },
 #endif
-    else if (implementation.compare("Spir_File_Signal_Source") == 0)
-        {
-            try
-            {
-                    std::unique_ptr<GNSSBlockInterface> block_(new SpirFileSignalSource(configuration.get(), role, in_streams,
-                            out_streams, queue));
-                    block = std::move(block_);
-
-            }
-            catch (const std::exception &e)
-            {
-                    std::cout << "GNSS-SDR program ended." << std::endl;
-                    exit(1);
-            }
-        }
-    else if (implementation.compare("RtlTcp_Signal_Source") == 0)
-        {
-            try
-            {
-                    std::unique_ptr<GNSSBlockInterface> block_(new RtlTcpSignalSource(configuration.get(), role, in_streams,
-                            out_streams, queue));
-                    block = std::move(block_);
-
-            }
-            catch (const std::exception &e)
-            {
-                    std::cout << "GNSS-SDR program ended." << std::endl;
-                    exit(1);
-            }
-        }
+            { "Spir_File_Signal_Source", &make_file_source<SpirFileSignalSource> },
+            { "RtlTcp_Signal_Source", &make_file_source<RtlTcpSignalSource> },
+            { "UDP_Signal_Source", &make_source<UdpSignalSource> },
 #if UHD_DRIVER
-    else if (implementation.compare("UHD_Signal_Source") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new UhdSignalSource(configuration.get(), role, in_streams,
-                    out_streams, queue));
-            block = std::move(block_);
-        }
+            { "UHD_Signal_Source", &make_source<UhdSignalSource> },
 #endif
 #if GN3S_DRIVER
-    else if (implementation.compare("GN3S_Signal_Source") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new Gn3sSignalSource(configuration.get(), role, in_streams,
-                    out_streams, queue));
-            block = std::move(block_);
-        }
+            { "GN3S_Signal_Source", &make_source<Gn3sSignalSource> },
 #endif
-
 #if RAW_ARRAY_DRIVER
-    else if (implementation.compare("Raw_Array_Signal_Source") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new RawArraySignalSource(configuration.get(), role, in_streams,
-                    out_streams, queue));
-            block = std::move(block_);
-        }
+            { "Raw_Array_Signal_Source", &make_source<RawArraySignalSource> },
 #endif
-
 #if OSMOSDR_DRIVER
-    else if (implementation.compare("Osmosdr_Signal_Source") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new OsmosdrSignalSource(configuration.get(), role, in_streams,
-                    out_streams, queue));
-            block = std::move(block_);
-        }
+            { "Osmosdr_Signal_Source", &make_source<OsmosdrSignalSource> },
 #endif
-
 #if FLEXIBAND_DRIVER
-    else if (implementation.compare("Flexiband_Signal_Source") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new FlexibandSignalSource(configuration.get(), role, in_streams,
-                    out_streams, queue));
-            block = std::move(block_);
-        }
+            { "Flexiband_Signal_Source", &make_source<FlexibandSignalSource> },
 #endif
 
-    // DATA TYPE ADAPTER -----------------------------------------------------------
-    else if (implementation.compare("Byte_To_Short") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface>block_(new ByteToShort(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Ibyte_To_Cbyte") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface>block_(new IbyteToCbyte(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Ibyte_To_Cshort") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface>block_(new IbyteToCshort(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Ibyte_To_Complex") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface>block_(new IbyteToComplex(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Ishort_To_Cshort") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface>block_(new IshortToCshort(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Ishort_To_Complex") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface>block_(new IshortToComplex(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
+            // DATA TYPE ADAPTER -------------------------------------------------------
+            { "Byte_To_Short", &make_block<ByteToShort> },
+            { "Ibyte_To_Cbyte", &make_block<IbyteToCbyte> },
+            { "Ibyte_To_Cshort", &make_block<IbyteToCshort> },
+            { "Ibyte_To_Complex", &make_block<IbyteToComplex> },
+            { "Ishort_To_Cshort", &make_block<IshortToCshort> },
+            { "Agc_Requantizer", &make_block<AgcRequantizer> },
+            { "Ishort_To_Complex", &make_block<IshortToComplex> },
+
+            // INPUT FILTER ------------------------------------------------------------
+            { "Fir_Filter", &make_block<FirFilter> },
+            { "Fft_Fir_Filter", &make_block<FftFirFilter> },
+            { "Pulse_Blanking_Filter", &make_block<PulseBlankingFilter> },
+            { "Freq_Xlating_Fir_Filter", &make_block<FreqXlatingFirFilter> },
+            { "Beamformer_Filter", &make_block<BeamformerFilter> },
+            { "Beam_Steering_Filter", &make_block<BeamSteeringFilter> },
+
+            // RESAMPLER ---------------------------------------------------------------
+            { "Direct_Resampler", &make_block<DirectResamplerConditioner> },
+            { "Polyphase_Resampler", &make_fractional_resampler },
+            { "Farrow_Resampler", &make_fractional_resampler },
+
+            // OBSERVABLES -------------------------------------------------------------
+            { "GPS_L1_CA_Observables", &make_block<GpsL1CaObservables> },
+            { "Galileo_E1B_Observables", &make_block<GalileoE1Observables> },
+            { "Hybrid_Observables", &make_block<HybridObservables> },
+            { "Observables_Stream_Source", &make_block<ObservablesStreamSourceAdapter> },
+            { "RINEX_Observables_Source", &make_source<RinexObservablesSourceAdapter> },
+
+            // PVT ---------------------------------------------------------------------
+            { "GPS_L1_CA_PVT", &make_block<GpsL1CaPvt> },
+            { "GALILEO_E1_PVT", &make_block<GalileoE1Pvt> },
+            { "Hybrid_PVT", &make_block<HybridPvt> },
+            { "Observables_Stream_Sink", &make_block<ObservablesStreamSinkAdapter> }
+    };
+    return table;
+}
 
-    // INPUT FILTER ----------------------------------------------------------------
-    else if (implementation.compare("Fir_Filter") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new FirFilter(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Freq_Xlating_Fir_Filter") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new FreqXlatingFirFilter(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Beamformer_Filter") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new BeamformerFilter(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
 
-    // RESAMPLER -------------------------------------------------------------------
-    else if (implementation.compare("Direct_Resampler") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new DirectResamplerConditioner(configuration.get(), role,
-                    in_streams, out_streams));
-            block = std::move(block_);
-        }
+std::unordered_map<std::string, GNSSBlockFactory::AcqBlockCreator>& acq_block_table()
+{
+    static std::unordered_map<std::string, GNSSBlockFactory::AcqBlockCreator> table = {
+            { "GPS_L1_CA_PCPS_Acquisition", &make_channel_block<AcquisitionInterface, GpsL1CaPcpsAcquisition> },
+            { "GPS_L1_CA_PCPS_Assisted_Acquisition", &make_channel_block<AcquisitionInterface, GpsL1CaPcpsAssistedAcquisition> },
+            { "GPS_L1_CA_PCPS_Tong_Acquisition", &make_channel_block<AcquisitionInterface, GpsL1CaPcpsTongAcquisition> },
+            { "GPS_L1_CA_PCPS_Multithread_Acquisition", &make_channel_block<AcquisitionInterface, GpsL1CaPcpsMultithreadAcquisition> },
+#if OPENCL_BLOCKS
+            { "GPS_L1_CA_PCPS_OpenCl_Acquisition", &make_channel_block<AcquisitionInterface, GpsL1CaPcpsOpenClAcquisition> },
+#endif
+#if CUDA_GPU_ACCEL
+            { "GPS_L1_CA_PCPS_CUDA_Acquisition", &make_channel_block<AcquisitionInterface, GpsL1CaPcpsCudaAcquisition> },
+#endif
+            { "GPS_L1_CA_PCPS_Acquisition_Fine_Doppler", &make_channel_block<AcquisitionInterface, GpsL1CaPcpsAcquisitionFineDoppler> },
+            { "GPS_L1_CA_PCPS_QuickSync_Acquisition", &make_channel_block<AcquisitionInterface, GpsL1CaPcpsQuickSyncAcquisition> },
+            { "GPS_L1_CA_PCPS_Shifted_Spectrum_Acquisition", &make_channel_block<AcquisitionInterface, GpsL1CaPcpsShiftedSpectrumAcquisition> },
+            { "GPS_L1_CA_PCPS_Fixed_Point_Acquisition", &make_channel_block<AcquisitionInterface, GpsL1CaPcpsFixedPointAcquisition> },
+            { "GPS_L1_CA_PCPS_Remote_Acquisition", &make_channel_block<AcquisitionInterface, GpsL1CaPcpsRemoteAcquisition> },
+            { "GPS_L2_M_PCPS_Acquisition", &make_channel_block<AcquisitionInterface, GpsL2MPcpsAcquisition> },
+            { "GPS_L2_M_PCPS_Segmented_Acquisition", &make_channel_block<AcquisitionInterface, GpsL2MPcpsSegmentedAcquisition> },
+            { "Galileo_E1_PCPS_Ambiguous_Acquisition", &make_channel_block<AcquisitionInterface, GalileoE1PcpsAmbiguousAcquisition> },
+            { "Galileo_E1_PCPS_8ms_Ambiguous_Acquisition", &make_channel_block<AcquisitionInterface, GalileoE1Pcps8msAmbiguousAcquisition> },
+            { "Galileo_E1_PCPS_Tong_Ambiguous_Acquisition", &make_channel_block<AcquisitionInterface, GalileoE1PcpsTongAmbiguousAcquisition> },
+            { "Galileo_E1_PCPS_CCCWSR_Ambiguous_Acquisition", &make_channel_block<AcquisitionInterface, GalileoE1PcpsCccwsrAmbiguousAcquisition> },
+            { "Galileo_E1_PCPS_QuickSync_Ambiguous_Acquisition", &make_channel_block<AcquisitionInterface, GalileoE1PcpsQuickSyncAmbiguousAcquisition> },
+            { "Galileo_E5a_Noncoherent_IQ_Acquisition_CAF", &make_channel_block<AcquisitionInterface, GalileoE5aNoncoherentIQAcquisitionCaf> }
+    };
+    return table;
+}
 
-    // ACQUISITION BLOCKS ---------------------------------------------------------
-    else if (implementation.compare("GPS_L1_CA_PCPS_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaPcpsAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_PCPS_Assisted_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaPcpsAssistedAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_PCPS_Tong_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaPcpsTongAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_PCPS_Multithread_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaPcpsMultithreadAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
 
-#if OPENCL_BLOCKS
-    else if (implementation.compare("GPS_L1_CA_PCPS_OpenCl_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaPcpsOpenClAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
+std::unordered_map<std::string, GNSSBlockFactory::TrkBlockCreator>& trk_block_table()
+{
+    static std::unordered_map<std::string, GNSSBlockFactory::TrkBlockCreator> table = {
+            { "GPS_L1_CA_DLL_PLL_Tracking", &make_channel_block<TrackingInterface, GpsL1CaDllPllTracking> },
+            { "GPS_L1_CA_DLL_PLL_C_Aid_Tracking", &make_channel_block<TrackingInterface, GpsL1CaDllPllCAidTracking> },
+            { "GPS_L1_CA_TCP_CONNECTOR_Tracking", &make_channel_block<TrackingInterface, GpsL1CaTcpConnectorTracking> },
+            { "Galileo_E1_DLL_PLL_VEML_Tracking", &make_channel_block<TrackingInterface, GalileoE1DllPllVemlTracking> },
+            { "Galileo_E1_TCP_CONNECTOR_Tracking", &make_channel_block<TrackingInterface, GalileoE1TcpConnectorTracking> },
+            { "Galileo_E5a_DLL_PLL_Tracking", &make_channel_block<TrackingInterface, GalileoE5aDllPllTracking> },
+            { "GPS_L2_M_DLL_PLL_Tracking", &make_channel_block<TrackingInterface, GpsL2MDllPllTracking> },
+#if CUDA_GPU_ACCEL
+            { "GPS_L1_CA_DLL_PLL_Tracking_GPU", &make_channel_block<TrackingInterface, GpsL1CaDllPllTrackingGPU> },
 #endif
+    };
+    return table;
+}
 
-    else if (implementation.compare("GPS_L1_CA_PCPS_Acquisition_Fine_Doppler") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaPcpsAcquisitionFineDoppler(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_PCPS_QuickSync_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_( new GpsL1CaPcpsQuickSyncAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_PCPS_Ambiguous_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE1PcpsAmbiguousAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_PCPS_8ms_Ambiguous_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE1Pcps8msAmbiguousAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_PCPS_Tong_Ambiguous_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE1PcpsTongAmbiguousAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_PCPS_CCCWSR_Ambiguous_Acquisition") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE1PcpsCccwsrAmbiguousAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E5a_Noncoherent_IQ_Acquisition_CAF") == 0)
+
+std::unordered_map<std::string, GNSSBlockFactory::TlmBlockCreator>& tlm_block_table()
+{
+    static std::unordered_map<std::string, GNSSBlockFactory::TlmBlockCreator> table = {
+            { "GPS_L1_CA_Telemetry_Decoder", &make_channel_block<TelemetryDecoderInterface, GpsL1CaTelemetryDecoder> },
+            { "Galileo_E1B_Telemetry_Decoder", &make_channel_block<TelemetryDecoderInterface, GalileoE1BTelemetryDecoder> },
+            { "SBAS_L1_Telemetry_Decoder", &make_channel_block<TelemetryDecoderInterface, SbasL1TelemetryDecoder> },
+            { "Galileo_E5a_Telemetry_Decoder", &make_channel_block<TelemetryDecoderInterface, GalileoE5aTelemetryDecoder> },
+            { "GPS_L2_M_Telemetry_Decoder", &make_channel_block<TelemetryDecoderInterface, GpsL2MTelemetryDecoder> }
+    };
+    return table;
+}
+
+
+template <class Creator>
+bool register_creator(std::unordered_map<std::string, Creator>& table,
+        const std::string& implementation, Creator creator)
+{
+    if (creator == nullptr)
         {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE5aNoncoherentIQAcquisitionCaf(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
+            return false;
         }
-    else if (implementation.compare("Galileo_E1_PCPS_QuickSync_Ambiguous_Acquisition") == 0)
+    bool inserted = table.insert(std::make_pair(implementation, creator)).second;
+    if (!inserted)
         {
-            std::unique_ptr<GNSSBlockInterface> block_( new GalileoE1PcpsQuickSyncAmbiguousAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
+            LOG(WARNING) << implementation << ": implementation already registered";
         }
+    return inserted;
+}
+}
 
 
+bool GNSSBlockFactory::RegisterBlock(const std::string& implementation, BlockCreator creator)
+{
+    return register_creator(block_table(), implementation, creator);
+}
 
 
-    // TRACKING BLOCKS -------------------------------------------------------------
-    else if (implementation.compare("GPS_L1_CA_DLL_PLL_Tracking") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaDllPllTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_DLL_PLL_C_Aid_Tracking") == 0)
-        {
-            std::unique_ptr<TrackingInterface> block_(new GpsL1CaDllPllCAidTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_TCP_CONNECTOR_Tracking") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaTcpConnectorTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L2_M_DLL_PLL_Tracking") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL2MDllPllTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-#if CUDA_GPU_ACCEL
-    else if (implementation.compare("GPS_L1_CA_DLL_PLL_Tracking_GPU") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaDllPllTrackingGPU(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-#endif
-    else if (implementation.compare("Galileo_E1_DLL_PLL_VEML_Tracking") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE1DllPllVemlTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_TCP_CONNECTOR_Tracking") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE1TcpConnectorTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E5a_DLL_PLL_Tracking") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE5aDllPllTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
+bool GNSSBlockFactory::RegisterAcqBlock(const std::string& implementation, AcqBlockCreator creator)
+{
+    return register_creator(acq_block_table(), implementation, creator);
+}
 
-    // TELEMETRY DECODERS ----------------------------------------------------------
-    else if (implementation.compare("GPS_L1_CA_Telemetry_Decoder") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaTelemetryDecoder(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1B_Telemetry_Decoder") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE1BTelemetryDecoder(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("SBAS_L1_Telemetry_Decoder") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new SbasL1TelemetryDecoder(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E5a_Telemetry_Decoder") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE5aTelemetryDecoder(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
 
-    // OBSERVABLES -----------------------------------------------------------------
-    else if (implementation.compare("GPS_L1_CA_Observables") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaObservables(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
+bool GNSSBlockFactory::RegisterTrkBlock(const std::string& implementation, TrkBlockCreator creator)
+{
+    return register_creator(trk_block_table(), implementation, creator);
+}
 
-    else if (implementation.compare("Galileo_E1B_Observables") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE1Observables(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Hybrid_Observables") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new HybridObservables(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    // PVT -------------------------------------------------------------------------
-    else if (implementation.compare("GPS_L1_CA_PVT") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GpsL1CaPvt(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GALILEO_E1_PVT") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new GalileoE1Pvt(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Hybrid_PVT") == 0)
-        {
-            std::unique_ptr<GNSSBlockInterface> block_(new HybridPvt(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else
-        {
-            // Log fatal. This causes execution to stop.
-            LOG(ERROR) << role << "." << implementation << ": Undefined implementation for block";
-        }
-    return std::move(block);
+
+bool GNSSBlockFactory::RegisterTlmBlock(const std::string& implementation, TlmBlockCreator creator)
+{
+    return register_creator(tlm_block_table(), implementation, creator);
 }
 
 
 /*
- *
- * PLEASE ADD YOUR NEW BLOCK HERE!!
- *
- * Not very elegant, Acq, Trk and Tlm blocks must be added here, too.
- * To be improved!
+ * Returns the block with the required configuration and implementation
  */
-
-std::unique_ptr<AcquisitionInterface> GNSSBlockFactory::GetAcqBlock(
+std::unique_ptr<GNSSBlockInterface> GNSSBlockFactory::GetBlock(
         std::shared_ptr<ConfigurationInterface> configuration,
         std::string role,
         std::string implementation, unsigned int in_streams,
-        unsigned int out_streams)
+        unsigned int out_streams, boost::shared_ptr<gr::msg_queue> queue)
 {
-    std::unique_ptr<AcquisitionInterface> block;
-    // ACQUISITION BLOCKS ---------------------------------------------------------
-    if (implementation.compare("GPS_L1_CA_PCPS_Acquisition") == 0)
+    Gnss_Sdr_Memory_Accounting::Scope memory_scope(role);
+    std::unordered_map<std::string, BlockCreator>::const_iterator block = block_table().find(implementation);
+    if (block != block_table().end())
         {
-            std::unique_ptr<AcquisitionInterface> block_(new GpsL1CaPcpsAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
+            return block->second(configuration.get(), role, implementation, in_streams, out_streams, queue);
         }
-    else if (implementation.compare("GPS_L1_CA_PCPS_Assisted_Acquisition") == 0)
+    std::unordered_map<std::string, AcqBlockCreator>::const_iterator acq = acq_block_table().find(implementation);
+    if (acq != acq_block_table().end())
         {
-            std::unique_ptr<AcquisitionInterface> block_(new GpsL1CaPcpsAssistedAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
+            return acq->second(configuration.get(), role, in_streams, out_streams);
         }
-    else if (implementation.compare("GPS_L1_CA_PCPS_Tong_Acquisition") == 0)
+    std::unordered_map<std::string, TrkBlockCreator>::const_iterator trk = trk_block_table().find(implementation);
+    if (trk != trk_block_table().end())
         {
-            std::unique_ptr<AcquisitionInterface> block_(new GpsL1CaPcpsTongAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
+            return trk->second(configuration.get(), role, in_streams, out_streams);
         }
-    else if (implementation.compare("GPS_L1_CA_PCPS_Multithread_Acquisition") == 0)
+    std::unordered_map<std::string, TlmBlockCreator>::const_iterator tlm = tlm_block_table().find(implementation);
+    if (tlm != tlm_block_table().end())
         {
-            std::unique_ptr<AcquisitionInterface> block_(new GpsL1CaPcpsMultithreadAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
+            return tlm->second(configuration.get(), role, in_streams, out_streams);
         }
+    // Log fatal. This causes execution to stop.
+    LOG(ERROR) << role << "." << implementation << ": Undefined implementation for block";
+    return nullptr;
+}
 
-#if OPENCL_BLOCKS
-    else if (implementation.compare("GPS_L1_CA_PCPS_OpenCl_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GpsL1CaPcpsOpenClAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-#endif
-
-    else if (implementation.compare("GPS_L1_CA_PCPS_Acquisition_Fine_Doppler") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GpsL1CaPcpsAcquisitionFineDoppler(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_PCPS_QuickSync_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_( new GpsL1CaPcpsQuickSyncAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L2_M_PCPS_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GpsL2MPcpsAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_PCPS_Ambiguous_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GalileoE1PcpsAmbiguousAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_PCPS_8ms_Ambiguous_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GalileoE1Pcps8msAmbiguousAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_PCPS_Tong_Ambiguous_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GalileoE1PcpsTongAmbiguousAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_PCPS_CCCWSR_Ambiguous_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GalileoE1PcpsCccwsrAmbiguousAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
 
-    else if (implementation.compare("Galileo_E1_PCPS_QuickSync_Ambiguous_Acquisition") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_( new GalileoE1PcpsQuickSyncAmbiguousAcquisition(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E5a_Noncoherent_IQ_Acquisition_CAF") == 0)
-        {
-            std::unique_ptr<AcquisitionInterface> block_(new GalileoE5aNoncoherentIQAcquisitionCaf(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else
+std::unique_ptr<AcquisitionInterface> GNSSBlockFactory::GetAcqBlock(
+        std::shared_ptr<ConfigurationInterface> configuration,
+        std::string role,
+        std::string implementation, unsigned int in_streams,
+        unsigned int out_streams)
+{
+    Gnss_Sdr_Memory_Accounting::Scope memory_scope(role);
+    std::unordered_map<std::string, AcqBlockCreator>::const_iterator acq = acq_block_table().find(implementation);
+    if (acq == acq_block_table().end())
         {
             // Log fatal. This causes execution to stop.
             LOG(ERROR) << role << "." << implementation << ": Undefined implementation for block";
+            return nullptr;
         }
-    return std::move(block);
+    return acq->second(configuration.get(), role, in_streams, out_streams);
 }
 
 
@@ -1171,65 +1001,15 @@ std::unique_ptr<TrackingInterface> GNSSBlockFactory::GetTrkBlock(
         std::string implementation, unsigned int in_streams,
         unsigned int out_streams)
 {
-    std::unique_ptr<TrackingInterface> block;
-
-    // TRACKING BLOCKS -------------------------------------------------------------
-    if (implementation.compare("GPS_L1_CA_DLL_PLL_Tracking") == 0)
-        {
-            std::unique_ptr<TrackingInterface> block_(new GpsL1CaDllPllTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_DLL_PLL_C_Aid_Tracking") == 0)
-        {
-            std::unique_ptr<TrackingInterface> block_(new GpsL1CaDllPllCAidTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L1_CA_TCP_CONNECTOR_Tracking") == 0)
-        {
-            std::unique_ptr<TrackingInterface> block_(new GpsL1CaTcpConnectorTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_DLL_PLL_VEML_Tracking") == 0)
-        {
-            std::unique_ptr<TrackingInterface> block_(new GalileoE1DllPllVemlTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1_TCP_CONNECTOR_Tracking") == 0)
-        {
-            std::unique_ptr<TrackingInterface> block_(new GalileoE1TcpConnectorTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E5a_DLL_PLL_Tracking") == 0)
-        {
-            std::unique_ptr<TrackingInterface> block_(new GalileoE5aDllPllTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L2_M_DLL_PLL_Tracking") == 0)
-        {
-            std::unique_ptr<TrackingInterface> block_(new GpsL2MDllPllTracking(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-#if CUDA_GPU_ACCEL
-    else if (implementation.compare("GPS_L1_CA_DLL_PLL_Tracking_GPU") == 0)
-        {
-            std::unique_ptr<TrackingInterface> block_(new GpsL1CaDllPllTrackingGPU(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-#endif
-    else
+    Gnss_Sdr_Memory_Accounting::Scope memory_scope(role);
+    std::unordered_map<std::string, TrkBlockCreator>::const_iterator trk = trk_block_table().find(implementation);
+    if (trk == trk_block_table().end())
         {
             // Log fatal. This causes execution to stop.
             LOG(ERROR) << role << "." << implementation << ": Undefined implementation for block";
+            return nullptr;
         }
-    return std::move(block);
+    return trk->second(configuration.get(), role, in_streams, out_streams);
 }
 
 
@@ -1239,43 +1019,13 @@ std::unique_ptr<TelemetryDecoderInterface> GNSSBlockFactory::GetTlmBlock(
         std::string implementation, unsigned int in_streams,
         unsigned int out_streams)
 {
-    std::unique_ptr<TelemetryDecoderInterface> block;
-
-    // TELEMETRY DECODERS ----------------------------------------------------------
-    if (implementation.compare("GPS_L1_CA_Telemetry_Decoder") == 0)
-        {
-            std::unique_ptr<TelemetryDecoderInterface> block_(new GpsL1CaTelemetryDecoder(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E1B_Telemetry_Decoder") == 0)
-        {
-            std::unique_ptr<TelemetryDecoderInterface> block_(new GalileoE1BTelemetryDecoder(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("SBAS_L1_Telemetry_Decoder") == 0)
-        {
-            std::unique_ptr<TelemetryDecoderInterface> block_(new SbasL1TelemetryDecoder(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("Galileo_E5a_Telemetry_Decoder") == 0)
-        {
-            std::unique_ptr<TelemetryDecoderInterface> block_(new GalileoE5aTelemetryDecoder(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else if (implementation.compare("GPS_L2_M_Telemetry_Decoder") == 0)
-        {
-            std::unique_ptr<TelemetryDecoderInterface> block_(new GpsL2MTelemetryDecoder(configuration.get(), role, in_streams,
-                    out_streams));
-            block = std::move(block_);
-        }
-    else
+    Gnss_Sdr_Memory_Accounting::Scope memory_scope(role);
+    std::unordered_map<std::string, TlmBlockCreator>::const_iterator tlm = tlm_block_table().find(implementation);
+    if (tlm == tlm_block_table().end())
         {
             // Log fatal. This causes execution to stop.
             LOG(ERROR) << role << "." << implementation << ": Undefined implementation for block";
+            return nullptr;
         }
-    return std::move(block);
+    return tlm->second(configuration.get(), role, in_streams, out_streams);
 }
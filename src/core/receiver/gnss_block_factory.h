@@ -54,8 +54,34 @@ class TelemetryDecoderInterface;
 class GNSSBlockFactory
 {
 public:
+    //! Makes a block from its configuration, role, implementation name, streams and queue
+    typedef std::unique_ptr<GNSSBlockInterface> (*BlockCreator)(ConfigurationInterface* configuration,
+            const std::string& role, const std::string& implementation,
+            unsigned int in_streams, unsigned int out_streams,
+            boost::shared_ptr<gr::msg_queue> queue);
+    typedef std::unique_ptr<AcquisitionInterface> (*AcqBlockCreator)(ConfigurationInterface* configuration,
+            const std::string& role, unsigned int in_streams, unsigned int out_streams);
+    typedef std::unique_ptr<TrackingInterface> (*TrkBlockCreator)(ConfigurationInterface* configuration,
+            const std::string& role, unsigned int in_streams, unsigned int out_streams);
+    typedef std::unique_ptr<TelemetryDecoderInterface> (*TlmBlockCreator)(ConfigurationInterface* configuration,
+            const std::string& role, unsigned int in_streams, unsigned int out_streams);
+
     GNSSBlockFactory();
     virtual ~GNSSBlockFactory();
+
+    /*!
+     * \brief Adds an implementation to the factory, without touching it.
+     *
+     * Returns false, keeping the registered one, if the name is taken.
+     * The result can initialize a static variable of the translation unit
+     * of the block, so that it registers itself when that unit is linked:
+     *
+     * static bool registered = GNSSBlockFactory::RegisterAcqBlock("My_Acquisition", &make_my_acquisition);
+     */
+    static bool RegisterBlock(const std::string& implementation, BlockCreator creator);
+    static bool RegisterAcqBlock(const std::string& implementation, AcqBlockCreator creator);
+    static bool RegisterTrkBlock(const std::string& implementation, TrkBlockCreator creator);
+    static bool RegisterTlmBlock(const std::string& implementation, TlmBlockCreator creator);
     std::unique_ptr<GNSSBlockInterface> GetSignalSource(std::shared_ptr<ConfigurationInterface> configuration,
             boost::shared_ptr<gr::msg_queue> queue, int ID = -1);
 
@@ -63,7 +89,8 @@ public:
 
     std::unique_ptr<GNSSBlockInterface> GetPVT(std::shared_ptr<ConfigurationInterface> configuration);
 
-    std::unique_ptr<GNSSBlockInterface> GetObservables(std::shared_ptr<ConfigurationInterface> configuration);
+    std::unique_ptr<GNSSBlockInterface> GetObservables(std::shared_ptr<ConfigurationInterface> configuration,
+            boost::shared_ptr<gr::msg_queue> queue = nullptr);
 
     std::unique_ptr<std::vector<std::unique_ptr<GNSSBlockInterface>>> GetChannels(std::shared_ptr<ConfigurationInterface> configuration,
             boost::shared_ptr<gr::msg_queue> queue);
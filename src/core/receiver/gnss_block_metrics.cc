@@ -0,0 +1,221 @@
+/*!
+ * \file gnss_block_metrics.cc
+ * \brief Real-time performance counters of the blocks of the flowgraph
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_block_metrics.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <gnuradio/block_detail.h>
+#include <gnuradio/high_res_timer.h>
+#include <gnuradio/prefs.h>
+
+
+const std::vector<double> & Gnss_Block_Metrics::work_time_buckets_s()
+{
+    static const double bounds[] = { 1e-5, 1e-4, 1e-3, 1e-2, 1e-1, 1.0 };
+    static const std::vector<double> buckets(bounds, bounds + sizeof(bounds) / sizeof(bounds[0]));
+    return buckets;
+}
+
+
+void Gnss_Block_Metrics::enable_performance_counters()
+{
+    gr::prefs::singleton()->set_bool("PerfCounters", "on", true);
+}
+
+
+void Gnss_Block_Metrics::add_block(const std::string & role, gr::basic_block_sptr block)
+{
+    gr::block_sptr gr_block = boost::dynamic_pointer_cast<gr::block>(block);
+    if (!gr_block)
+        {
+            return;
+        }
+    std::lock_guard<std::mutex> lock(d_mutex);
+    for (unsigned int i = 0; i < d_blocks.size(); i++)
+        {
+            if (d_blocks[i].block == gr_block) return;
+        }
+    Block_Entry entry;
+    entry.block = gr_block;
+    entry.counters = Counters();
+    entry.time_s = -1.0;
+    entry.stats = Block_Stats();
+    entry.stats.role = role;
+    entry.stats.name = gr_block->alias();
+    // one more bucket for the longer calls
+    entry.stats.work_time_histogram.assign(work_time_buckets_s().size() + 1, 0);
+    d_blocks.push_back(entry);
+}
+
+
+void Gnss_Block_Metrics::sample()
+{
+    const double time_s = static_cast<double>((boost::posix_time::microsec_clock::universal_time()
+            - boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1))).total_microseconds()) * 1e-6;
+    const double tps = static_cast<double>(gr::high_res_timer_tps());
+    const unsigned int n = blocks();
+    for (unsigned int i = 0; i < n; i++)
+        {
+            gr::block_sptr block;
+            {
+                std::lock_guard<std::mutex> lock(d_mutex);
+                block = d_blocks[i].block;
+            }
+            gr::block_detail_sptr detail = block->detail();
+            if (!detail)
+                {
+                    // not started yet
+                    continue;
+                }
+            Counters counters = Counters();
+            if (detail->noutputs() > 0)
+                {
+                    counters.items = block->nitems_written(0);
+                }
+            else if (detail->ninputs() > 0)
+                {
+                    counters.items = block->nitems_read(0);
+                }
+            if (detail->ninputs() > 0)
+                {
+                    counters.input_buffer_full = block->pc_input_buffers_full_avg(0);
+                }
+#if MODERN_GNURADIO
+            counters.work_time_s = block->pc_work_time_total() / tps;
+#endif
+            counters.last_work_time_s = block->pc_work_time() / tps;
+            update(i, counters, time_s);
+        }
+}
+
+
+void Gnss_Block_Metrics::update(unsigned int index, const Counters & counters, double time_s)
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    Block_Entry & entry = d_blocks.at(index);
+    Block_Stats & stats = entry.stats;
+    if (entry.time_s >= 0.0 && time_s > entry.time_s)
+        {
+            const double elapsed_s = time_s - entry.time_s;
+            const unsigned long long items = counters.items - entry.counters.items;
+            const double work_time_s = std::max(counters.work_time_s - entry.counters.work_time_s, 0.0);
+            stats.items_per_s = static_cast<double>(items) / elapsed_s;
+            stats.load = work_time_s / elapsed_s;
+            stats.time_per_item_us = items > 0 ? work_time_s / static_cast<double>(items) * 1e6 : 0.0;
+        }
+    stats.input_buffer_full = counters.input_buffer_full;
+    if (counters.last_work_time_s > 0.0)
+        {
+            const std::vector<double> & buckets = work_time_buckets_s();
+            const unsigned int bucket = std::lower_bound(buckets.begin(), buckets.end(), counters.last_work_time_s) - buckets.begin();
+            stats.work_time_histogram[bucket]++;
+            stats.work_time_sum_s += counters.last_work_time_s;
+        }
+    entry.counters = counters;
+    entry.time_s = time_s;
+}
+
+
+unsigned int Gnss_Block_Metrics::blocks() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_blocks.size();
+}
+
+
+std::vector<Gnss_Block_Metrics::Block_Stats> Gnss_Block_Metrics::stats() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    std::vector<Block_Stats> result;
+    for (unsigned int i = 0; i < d_blocks.size(); i++)
+        {
+            result.push_back(d_blocks[i].stats);
+        }
+    return result;
+}
+
+
+std::string Gnss_Block_Metrics::prometheus_text() const
+{
+    const std::vector<Block_Stats> all = stats();
+    const std::vector<double> & buckets = work_time_buckets_s();
+    std::ostringstream text;
+    const char * gauges[][2] = {
+            { "gnss_sdr_block_items_per_second", "Items produced, or consumed by a sink, per second" },
+            { "gnss_sdr_block_load", "Share of a core spent in general_work" },
+            { "gnss_sdr_block_time_per_item_seconds", "Time spent in general_work per item" },
+            { "gnss_sdr_block_input_buffer_full", "Average fill level of the first input buffer" } };
+    for (unsigned int g = 0; g < 4; g++)
+        {
+            text << "# HELP " << gauges[g][0] << " " << gauges[g][1] << "\n";
+            text << "# TYPE " << gauges[g][0] << " gauge\n";
+            for (unsigned int i = 0; i < all.size(); i++)
+                {
+                    const double values[] = { all[i].items_per_s, all[i].load, all[i].time_per_item_us * 1e-6, all[i].input_buffer_full };
+                    text << gauges[g][0] << "{role=\"" << all[i].role << "\",block=\"" << all[i].name << "\"} "
+                         << values[g] << "\n";
+                }
+        }
+    text << "# HELP gnss_sdr_block_work_time_seconds Duration of the calls to general_work, one per sample\n";
+    text << "# TYPE gnss_sdr_block_work_time_seconds histogram\n";
+    for (unsigned int i = 0; i < all.size(); i++)
+        {
+            const std::string labels = "role=\"" + all[i].role + "\",block=\"" + all[i].name + "\"";
+            unsigned long long count = 0;
+            for (unsigned int b = 0; b < all[i].work_time_histogram.size(); b++)
+                {
+                    count += all[i].work_time_histogram[b];
+                    text << "gnss_sdr_block_work_time_seconds_bucket{" << labels << ",le=\"";
+                    if (b < buckets.size()) text << buckets[b]; else text << "+Inf";
+                    text << "\"} " << count << "\n";
+                }
+            text << "gnss_sdr_block_work_time_seconds_sum{" << labels << "} " << all[i].work_time_sum_s << "\n";
+            text << "gnss_sdr_block_work_time_seconds_count{" << labels << "} " << count << "\n";
+        }
+    return text.str();
+}
+
+
+std::vector<std::string> Gnss_Block_Metrics::summary() const
+{
+    const std::vector<Block_Stats> all = stats();
+    std::vector<std::string> lines;
+    for (unsigned int i = 0; i < all.size(); i++)
+        {
+            std::ostringstream line;
+            line << std::fixed << std::setprecision(1) << all[i].role << " " << all[i].name << ": "
+                 << all[i].items_per_s << " items/s, load " << all[i].load * 100.0 << " %, "
+                 << all[i].time_per_item_us << " us/item, input buffer " << all[i].input_buffer_full * 100.0 << " % full";
+            lines.push_back(line.str());
+        }
+    return lines;
+}
@@ -0,0 +1,115 @@
+/*!
+ * \file gnss_block_metrics.h
+ * \brief Real-time performance counters of the blocks of the flowgraph
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The control thread samples the blocks every GNSS-SDR.metrics_period_ms:
+ * the items they have produced (or consumed, for sinks), and the GNU Radio
+ * performance counters, which the receiver turns on only in that case:
+ * time spent in general_work, and fill level of the first input buffer.
+ * From them come the rate of items, the share of a core the block takes,
+ * the time per item (per epoch, for the blocks of a channel), and a
+ * histogram of the duration of the calls to general_work, one per sample.
+ * A block that takes more than a core, or whose input buffer stays full,
+ * is the one that is about to miss real time.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_BLOCK_METRICS_H_
+#define GNSS_SDR_GNSS_BLOCK_METRICS_H_
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <gnuradio/basic_block.h>
+#include <gnuradio/block.h>
+
+class Gnss_Block_Metrics
+{
+public:
+    //! Counters of a block, as they are read at a sample
+    struct Counters
+    {
+        unsigned long long items;  //!< Items produced, or consumed by a sink
+        double work_time_s;        //!< Total time spent in general_work [s]
+        double last_work_time_s;   //!< Duration of the last call to general_work [s]
+        double input_buffer_full;  //!< Average fill level of the first input buffer [0-1]
+    };
+
+    //! Rates of a block, between its last two samples
+    struct Block_Stats
+    {
+        std::string role;
+        std::string name;
+        double items_per_s;
+        double load;               //!< Share of a core spent in general_work
+        double time_per_item_us;   //!< Time spent in general_work per item [us]
+        double input_buffer_full;
+        std::vector<unsigned long long> work_time_histogram;  //!< Samples per bucket of work_time_buckets_s()
+        double work_time_sum_s;    //!< Sum of the sampled durations [s]
+    };
+
+    //! Upper bounds of the buckets of the work time histogram, the last one is unbounded [s]
+    static const std::vector<double> & work_time_buckets_s();
+
+    /*!
+     * \brief Turns on the GNU Radio performance counters of the blocks
+     * started from now on. Without them, only the rates of items are known.
+     */
+    static void enable_performance_counters();
+
+    //! Adds a block, once, and its stream and hierarchical blocks are ignored
+    void add_block(const std::string & role, gr::basic_block_sptr block);
+
+    //! Reads the counters of all the blocks
+    void sample();
+
+    //! Takes the \p counters of block \p index, read at \p time_s
+    void update(unsigned int index, const Counters & counters, double time_s);
+
+    unsigned int blocks() const;
+    std::vector<Block_Stats> stats() const;
+
+    //! The stats in the Prometheus text exposition format
+    std::string prometheus_text() const;
+
+    //! One line of text per block
+    std::vector<std::string> summary() const;
+
+private:
+    struct Block_Entry
+    {
+        gr::block_sptr block;
+        Counters counters;
+        double time_s;  // of the last sample, negative if there is none
+        Block_Stats stats;
+    };
+
+    mutable std::mutex d_mutex;
+    std::vector<Block_Entry> d_blocks;
+};
+
+#endif /*GNSS_SDR_GNSS_BLOCK_METRICS_H_*/
@@ -0,0 +1,77 @@
+/*!
+ * \file gnss_channel_shedding.cc
+ * \brief Choice of the tracking channel to stop when the receiver falls behind real time
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_channel_shedding.h"
+#include <map>
+
+namespace
+{
+// True if a is worth less than b, both of systems with as many channels
+bool worth_less(const Gnss_Channel_Value & a, const Gnss_Channel_Value & b)
+{
+    // a satellite known to be low goes before one that is not predicted
+    if (a.has_elevation != b.has_elevation)
+        {
+            return a.has_elevation;
+        }
+    if (a.has_elevation && a.elevation_d != b.elevation_d)
+        {
+            return a.elevation_d < b.elevation_d;
+        }
+    if (a.cn0_db_hz != b.cn0_db_hz)
+        {
+            return a.cn0_db_hz < b.cn0_db_hz;
+        }
+    return a.channel > b.channel;
+}
+}
+
+
+bool gnss_channel_to_shed(const std::vector<Gnss_Channel_Value> & channels, unsigned int & channel)
+{
+    if (channels.empty()) return false;
+    std::map<char, unsigned int> per_system;
+    for (unsigned int i = 0; i < channels.size(); i++)
+        {
+            per_system[channels[i].system]++;
+        }
+    unsigned int chosen = 0;
+    for (unsigned int i = 1; i < channels.size(); i++)
+        {
+            const unsigned int count = per_system[channels[i].system];
+            const unsigned int chosen_count = per_system[channels[chosen].system];
+            if (count > chosen_count || (count == chosen_count && worth_less(channels[i], channels[chosen])))
+                {
+                    chosen = i;
+                }
+        }
+    channel = channels[chosen].channel;
+    return true;
+}
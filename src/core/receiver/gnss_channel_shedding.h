@@ -0,0 +1,60 @@
+/*!
+ * \file gnss_channel_shedding.h
+ * \brief Choice of the tracking channel to stop when the receiver falls behind real time
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * When the tracking load leaves too little real-time margin, stopping a
+ * channel is better than letting the signal source overflow, which breaks
+ * all of them. The channel stopped is the one whose measurement the
+ * solution misses least.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_CHANNEL_SHEDDING_H_
+#define GNSS_SDR_GNSS_CHANNEL_SHEDDING_H_
+
+#include <vector>
+
+//! A tracking channel, with what its measurement is worth
+struct Gnss_Channel_Value
+{
+    unsigned int channel;
+    char system;          // 'G', 'E', ... as Gnss_Satellite::get_system_short()
+    bool has_elevation;   // the satellite is predicted by Gnss_Satellite_Scheduler
+    double elevation_d;   // [deg]
+    double cn0_db_hz;     // 0 if unknown
+};
+
+/*!
+ * \brief Chooses the channel to stop among \p channels. It is one of the
+ * system with the most channels, since the others are left with theirs.
+ * Within it, the lowest of the predicted satellites, or without
+ * predictions the one of lowest C/N0, and the last channel on a tie.
+ * Returns false if there are no channels.
+ */
+bool gnss_channel_to_shed(const std::vector<Gnss_Channel_Value> & channels, unsigned int & channel);
+
+#endif /*GNSS_SDR_GNSS_CHANNEL_SHEDDING_H_*/
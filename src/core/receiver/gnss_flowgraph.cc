@@ -35,21 +35,55 @@
 #include "gnss_flowgraph.h"
 #include "unistd.h"
 
+#include <cmath>
 #include <memory>
 #include <algorithm>
+#include <atomic>
 #include <exception>
 #include <iostream>
 #include <set>
+#include <sstream>
+#include <boost/algorithm/string.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/function.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
 #include <boost/tokenizer.hpp>
 #include <glog/logging.h>
+#include <gnuradio/block.h>
+#include <gnuradio/blocks/copy.h>
+#include <gnuradio/blocks/skiphead.h>
+#include <gnuradio/hier_block2.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
 #include "configuration_interface.h"
 #include "gnss_block_interface.h"
 #include "channel_interface.h"
+#include "channel.h"
+#include "signal_conditioner.h"
 #include "gnss_block_factory.h"
+#include "gnss_block_metrics.h"
+#include "gnss_channel_shedding.h"
+#include "gnss_source_alignment.h"
+#include "gnss_sdr_capture_sink.h"
+#include "gnss_sdr_latency_probe.h"
+#include "gnss_sdr_sample_ring_sink.h"
+#include "gnss_sdr_latency_tracer.h"
+#include "gnss_sdr_buffer_tuning.h"
+#include "gnss_sdr_memory_accounting.h"
+#include "gnss_sdr_numa.h"
+#include "gnss_sdr_realtime_monitor.h"
+#include "gnss_sdr_task_pool.h"
+#include "fft_planner.h"
+#include "gnss_nav_data_store.h"
+#include "concurrent_map.h"
+#include "control_event_bus.h"
+#include "gps_acq_assist.h"
+#include "acquisition_assistance.h"
 
 #define GNSS_SDR_ARRAY_SIGNAL_CONDITIONER_CHANNELS 8
 
+extern concurrent_map<Gps_Acq_Assist> global_gps_acq_assist_map;
+
 using google::LogMessage;
 
 GNSSFlowgraph::GNSSFlowgraph(std::shared_ptr<ConfigurationInterface> configuration,
@@ -85,6 +119,8 @@ void GNSSFlowgraph::start()
             LOG(ERROR) << e.what();
             return;
     }
+    // GNU Radio allocates the buffers of the streams when it starts
+    if (Gnss_Sdr_Memory_Accounting::enabled()) account_buffers();
 
     running_ = true;
 }
@@ -116,10 +152,18 @@ void GNSSFlowgraph::connect()
             return;
         }
 
+    // a new receiver starts without the navigation data of a previous one,
+    // but the receivers hosted in the same process share them
+    if (!configuration_->property("GNSS-SDR.shared_navigation_data", false))
+        {
+            Gnss_Nav_Data_Store::instance().clear();
+        }
+
     for (int i = 0; i < sources_count_; i++)
         {
             try
             {
+                    Gnss_Sdr_Memory_Accounting::Scope memory_scope(sig_source_.at(i)->role());
                     sig_source_.at(i)->connect(top_block_);
             }
             catch (std::exception& e)
@@ -136,6 +180,7 @@ void GNSSFlowgraph::connect()
         {
             try
             {
+                    Gnss_Sdr_Memory_Accounting::Scope memory_scope(sig_conditioner_.at(i)->role());
                     sig_conditioner_.at(i)->connect(top_block_);
             }
             catch (std::exception& e)
@@ -151,6 +196,7 @@ void GNSSFlowgraph::connect()
         {
             try
             {
+                    Gnss_Sdr_Memory_Accounting::Scope memory_scope("Channel" + boost::lexical_cast<std::string>(i));
                     channels_.at(i)->connect(top_block_);
             }
             catch (std::exception& e)
@@ -164,6 +210,7 @@ void GNSSFlowgraph::connect()
 
     try
     {
+            Gnss_Sdr_Memory_Accounting::Scope memory_scope(observables_->role());
             observables_->connect(top_block_);
     }
     catch (std::exception& e)
@@ -177,6 +224,7 @@ void GNSSFlowgraph::connect()
     // Signal Source > Signal conditioner >> Channels >> Observables > PVT
     try
     {
+            Gnss_Sdr_Memory_Accounting::Scope memory_scope(pvt_->role());
             pvt_->connect(top_block_);
     }
     catch (std::exception& e)
@@ -189,6 +237,7 @@ void GNSSFlowgraph::connect()
 
     DLOG(INFO) << "blocks connected internally";
     // Signal Source (i) >  Signal conditioner (i) >
+    align_sources();
     int RF_Channels = 0;
     int signal_conditioner_ID = 0;
 
@@ -205,7 +254,7 @@ void GNSSFlowgraph::connect()
                             for (int j = 0; j < GNSS_SDR_ARRAY_SIGNAL_CONDITIONER_CHANNELS; j++)
                                 {
                                     std::cout << "connecting ch " << j << std::endl;
-                                    top_block_->connect(sig_source_.at(i)->get_right_block(), j, sig_conditioner_.at(i)->get_left_block(), j);
+                                    connect_source(i, sig_source_.at(i)->get_right_block(), j, sig_conditioner_.at(i)->get_left_block(), j);
                                 }
                         }
                     else
@@ -226,7 +275,7 @@ void GNSSFlowgraph::connect()
                                         {
 
                                             LOG(INFO) << "connecting sig_source_ " << i << " stream " << j << " to conditioner " << j;
-                                            top_block_->connect(sig_source_.at(i)->get_right_block(), j, sig_conditioner_.at(signal_conditioner_ID)->get_left_block(), 0);
+                                            connect_source(i, sig_source_.at(i)->get_right_block(), j, sig_conditioner_.at(signal_conditioner_ID)->get_left_block(), 0);
 
                                         }
                                     else
@@ -235,13 +284,13 @@ void GNSSFlowgraph::connect()
                                                 {
                                                     // RF_channel 0 backward compatibility with single channel sources
                                                     LOG(INFO)  <<  "connecting sig_source_ " << i << " stream " << 0 << " to conditioner " << j;
-                                                    top_block_->connect(sig_source_.at(i)->get_right_block(), 0, sig_conditioner_.at(signal_conditioner_ID)->get_left_block(), 0);
+                                                    connect_source(i, sig_source_.at(i)->get_right_block(), 0, sig_conditioner_.at(signal_conditioner_ID)->get_left_block(), 0);
                                                 }
                                             else
                                                 {
                                                     // Multiple channel sources using multiple output blocks of single channel (requires RF_channel selector in call)
                                                     LOG(INFO) << "connecting sig_source_ " << i << " stream " << j << " to conditioner " << j;
-                                                    top_block_->connect(sig_source_.at(i)->get_right_block(j), 0, sig_conditioner_.at(signal_conditioner_ID)->get_left_block(), 0);
+                                                    connect_source(i, sig_source_.at(i)->get_right_block(j), 0, sig_conditioner_.at(signal_conditioner_ID)->get_left_block(), 0);
                                                 }
                                         }
 
@@ -258,16 +307,71 @@ void GNSSFlowgraph::connect()
             }
         }
     DLOG(INFO) << "Signal source connected to signal conditioner";
+    if (Gnss_Sdr_Latency_Tracer::enabled() and !sig_source_.empty()) connect_latency_probes();
+    connect_sample_rings();
+    connect_capture_taps();
 
     // Signal conditioner (selected_signal_source) >> channels (i) (dependent of their associated SignalSource_ID)
     int selected_signal_conditioner_ID;
+    std::vector<unsigned int> acquiring_channels;
+    // the channels of a NUMA node may read a copy of the conditioner output
+    // made on the node, so that only the copy crosses the interconnect
+    const bool numa_replicas = configuration_->property("GNSS-SDR.numa_replicate_conditioner", false);
+    std::map<std::string, gr::basic_block_sptr> replicas;  // by conditioner, beam and node
     for (unsigned int i = 0; i < channels_count_; i++)
         {
             selected_signal_conditioner_ID = configuration_->property("Channel" + boost::lexical_cast<std::string>(i) + ".RF_channel_ID", 0);
             try
             {
-                    top_block_->connect(sig_conditioner_.at(selected_signal_conditioner_ID)->get_right_block(), 0,
-                            channels_.at(i)->get_left_block(), 0);
+                    // conditioners with several outputs: the sub-band chosen by the
+                    // channel (channelizer), or one beam per channel (beam steering)
+                    gr::basic_block_sptr conditioner_block = sig_conditioner_.at(selected_signal_conditioner_ID)->get_right_block();
+                    unsigned int beam = 0;
+                    if (conditioner_block and conditioner_block->output_signature()->min_streams() > 1)
+                        {
+                            const int sub_band = configuration_->property("Channel" + boost::lexical_cast<std::string>(i) + ".sub_band", -1);
+                            if (sub_band >= 0 && sub_band < conditioner_block->output_signature()->min_streams())
+                                {
+                                    beam = sub_band;
+                                }
+                            else if (i < static_cast<unsigned int>(conditioner_block->output_signature()->min_streams()))
+                                {
+                                    beam = i;
+                                }
+                            else
+                                {
+                                    LOG(WARNING) << "No beam for channel " << i << ", it shares the beam of channel 0";
+                                }
+                        }
+                    const int numa_node = Gnss_Sdr_Numa::channel_node(configuration_, i);
+                    if (numa_replicas && numa_node >= 0 && conditioner_block)
+                        {
+                            std::ostringstream key;
+                            key << selected_signal_conditioner_ID << "." << beam << "." << numa_node;
+                            gr::basic_block_sptr & replica = replicas[key.str()];
+                            if (!replica)
+                                {
+                                    gr::blocks::copy::sptr copy = gr::blocks::copy::make(conditioner_block->output_signature()->sizeof_stream_item(beam));
+                                    const std::vector<int> cores = Gnss_Sdr_Numa::node_cores(numa_node);
+                                    if (!cores.empty()) copy->set_processor_affinity(cores);
+                                    top_block_->connect(conditioner_block, beam, copy, 0);
+                                    replica = copy;
+                                    LOG(INFO) << "Output " << beam << " of signal conditioner " << selected_signal_conditioner_ID
+                                              << " copied to NUMA node " << numa_node;
+                                }
+                            conditioner_block = replica;
+                            beam = 0;
+                        }
+                    std::shared_ptr<Channel> channel = std::dynamic_pointer_cast<Channel>(channels_.at(i));
+                    if (channel)
+                        {
+                            channel->connect_input(top_block_, conditioner_block, beam);
+                        }
+                    else
+                        {
+                            top_block_->connect(conditioner_block, beam,
+                                    channels_.at(i)->get_left_block(), 0);
+                        }
             }
             catch (std::exception& e)
             {
@@ -303,7 +407,7 @@ void GNSSFlowgraph::connect()
 
             if (channels_state_[i] == 1)
                 {
-                    channels_.at(i)->start_acquisition();
+                    acquiring_channels.push_back(i);
                     available_GNSS_signals_.pop_front();
                     LOG(INFO) << "Channel " << i << " assigned to " << available_GNSS_signals_.front();
                     LOG(INFO) << "Channel " << i << " connected to observables and ready for acquisition";
@@ -313,16 +417,45 @@ void GNSSFlowgraph::connect()
                     LOG(INFO) << "Channel " << i << " connected to observables in standby mode";
                 }
         }
+    start_acquisitions(acquiring_channels);
 
     /*
      * Connect the observables output of each channel to the PVT block
      */
     try
     {
+            if (remote_observables_)
+                {
+                    // one stream per channel of the edge receiver, and its navigation data
+                    gr::basic_block_sptr source = observables_->get_right_block();
+                    for (int i = 0; i < source->output_signature()->max_streams(); i++)
+                        {
+                            top_block_->connect(source, i, pvt_->get_left_block(), i);
+                        }
+                    top_block_->msg_connect(source, pmt::mp("telemetry"), pvt_->get_left_block(), pmt::mp("telemetry"));
+                }
             for (unsigned int i = 0; i < channels_count_; i++)
                 {
                     top_block_->connect(observables_->get_right_block(), i, pvt_->get_left_block(), i);
                     top_block_->msg_connect(channels_.at(i)->get_right_block(), pmt::mp("telemetry"), pvt_->get_left_block(), pmt::mp("telemetry"));
+                    // Vector tracking feedback, for the PVT and tracking blocks that implement it
+                    std::shared_ptr<Channel> channel = std::dynamic_pointer_cast<Channel>(channels_.at(i));
+                    if (channel and pvt_->get_left_block()->has_msg_port(pmt::mp("vector_tracking"))
+                            and channel->tracking()->get_right_block()->has_msg_port(pmt::mp("vector_tracking")))
+                        {
+                            top_block_->msg_connect(pvt_->get_left_block(), pmt::mp("vector_tracking"), channel->tracking()->get_right_block(), pmt::mp("vector_tracking"));
+                            DLOG(INFO) << "MSG FEEDBACK CHANNEL PVT -> tracking of channel " << i;
+                        }
+                }
+            // Line of sight of each channel to the beam steering of antenna arrays
+            for (unsigned int i = 0; i < sig_conditioner_.size(); i++)
+                {
+                    if (pvt_->get_left_block()->has_msg_port(pmt::mp("beam_steering"))
+                            and sig_conditioner_.at(i)->get_right_block()->has_msg_port(pmt::mp("beam_steering")))
+                        {
+                            top_block_->msg_connect(pvt_->get_left_block(), pmt::mp("beam_steering"), sig_conditioner_.at(i)->get_right_block(), pmt::mp("beam_steering"));
+                            DLOG(INFO) << "MSG FEEDBACK PVT -> beam steering of signal conditioner " << i;
+                        }
                 }
     }
     catch (std::exception& e)
@@ -333,6 +466,9 @@ void GNSSFlowgraph::connect()
             return;
     }
 
+    set_thread_options();
+    set_buffer_options();
+
     connected_ = true;
     LOG(INFO) << "Flowgraph connected";
     top_block_->dump();
@@ -352,9 +488,333 @@ void GNSSFlowgraph::wait()
 }
 
 
+void GNSSFlowgraph::align_sources()
+{
+    source_skip_.assign(sig_source_.size(), 0);
+    source_skipheads_.clear();
+    if (sig_source_.size() < 2)
+        {
+            return;
+        }
+    // the sources of independent front-ends start at different instants
+    std::vector<Gnss_Source_Start> starts(sig_source_.size());
+    bool aligned = false;
+    for (unsigned int i = 0; i < sig_source_.size(); i++)
+        {
+            const std::string role = sig_source_.at(i)->role();
+            starts[i].sampling_frequency_hz = configuration_->property(role + ".sampling_frequency", 0.0);
+            starts[i].start_time_s = configuration_->property(role + ".start_time_s", 0.0);
+            aligned = aligned or starts[i].start_time_s != 0.0;
+        }
+    if (!aligned)
+        {
+            return;
+        }
+    std::vector<Gnss_Source_Skip> skips = gnss_source_alignment(starts);
+    for (unsigned int i = 0; i < skips.size(); i++)
+        {
+            source_skip_[i] = skips[i].samples;
+            if (starts[i].sampling_frequency_hz <= 0.0)
+                {
+                    LOG(WARNING) << "No sampling_frequency for " << sig_source_.at(i)->role() << ", it is not aligned to the other sources";
+                    continue;
+                }
+            LOG(INFO) << sig_source_.at(i)->role() << " drops its first " << skips[i].samples
+                      << " samples, its first sample is " << skips[i].residual_s << " s after the common start";
+        }
+}
+
+
+void GNSSFlowgraph::connect_source(int source, gr::basic_block_sptr block, int port,
+        gr::basic_block_sptr conditioner, int conditioner_port)
+{
+    if (source_skip_.at(source) == 0)
+        {
+            top_block_->connect(block, port, conditioner, conditioner_port);
+            return;
+        }
+    // one per output, which may feed several conditioners
+    const std::pair<gr::basic_block*, int> key(block.get(), port);
+    std::map<std::pair<gr::basic_block*, int>, gr::basic_block_sptr>::iterator it = source_skipheads_.find(key);
+    if (it == source_skipheads_.end())
+        {
+            gr::basic_block_sptr skiphead = gr::blocks::skiphead::make(block->output_signature()->sizeof_stream_item(port), source_skip_.at(source));
+            top_block_->connect(block, port, skiphead, 0);
+            it = source_skipheads_.insert(std::make_pair(key, skiphead)).first;
+        }
+    top_block_->connect(it->second, 0, conditioner, conditioner_port);
+}
+
+
+void GNSSFlowgraph::connect_latency_probes()
+{
+    // the signal times of the first source, which the channels of RF channel 0 track
+    const double source_fs = configuration_->property(sig_source_.at(0)->role() + ".sampling_frequency", 0.0);
+    const double internal_fs = configuration_->property("GNSS-SDR.internal_fs_hz", 2048000.0);
+    gr::basic_block_sptr source = sig_source_.at(0)->get_right_block();
+    gr::basic_block_sptr conditioner = sig_conditioner_.at(0)->get_right_block();
+    std::map<std::pair<gr::basic_block*, int>, gr::basic_block_sptr>::const_iterator skiphead = source_skipheads_.find(std::make_pair(source.get(), 0));
+    if (skiphead != source_skipheads_.end())
+        {
+            source = skiphead->second;  // the conditioner sees the samples after the common start
+        }
+    if (source_fs <= 0.0 or !source or !conditioner)
+        {
+            LOG(WARNING) << "No sampling_frequency for " << sig_source_.at(0)->role() << ", the latencies are not traced";
+            return;
+        }
+    try
+    {
+            top_block_->connect(source, 0, gnss_sdr_make_latency_probe(source->output_signature()->sizeof_stream_item(0), source_fs, ""), 0);
+            top_block_->connect(conditioner, 0, gnss_sdr_make_latency_probe(conditioner->output_signature()->sizeof_stream_item(0), internal_fs, "conditioner"), 0);
+    }
+    catch (std::exception& e)
+    {
+            LOG(WARNING) << "Can't connect the latency probes: " << e.what();
+            return;
+    }
+    LOG(INFO) << "Latency probes connected";
+}
+
+
+void GNSSFlowgraph::connect_sample_rings()
+{
+    // the rings of the other receivers of the process have other keys
+    const unsigned int rf_channel_offset = configuration_->property("GNSS-SDR.rf_channel_offset", 0u);
+    for (unsigned int i = 0; i < sig_conditioner_.size(); i++)
+        {
+            Gnss_Sample_Ring_Store::instance().erase(rf_channel_offset + i);
+        }
+    const double ring_ms = configuration_->property("GNSS-SDR.sample_ring_ms", 0.0);
+    if (ring_ms <= 0.0)
+        {
+            return;
+        }
+    const double internal_fs = configuration_->property("GNSS-SDR.internal_fs_hz", 2048000.0);
+    const unsigned int capacity = static_cast<unsigned int>(std::ceil(internal_fs * ring_ms / 1000.0));
+    for (unsigned int i = 0; i < sig_conditioner_.size(); i++)
+        {
+            gr::basic_block_sptr conditioner = sig_conditioner_.at(i)->get_right_block();
+            // only single-beam conditioners of gr_complex samples
+            if (!conditioner or conditioner->output_signature()->min_streams() > 1
+                    or conditioner->output_signature()->sizeof_stream_item(0) != sizeof(gr_complex))
+                {
+                    LOG(WARNING) << "No sample ring for signal conditioner " << i;
+                    continue;
+                }
+            try
+            {
+                    std::shared_ptr<Gnss_Sample_Ring> ring = Gnss_Sample_Ring_Store::instance().create(rf_channel_offset + i, capacity);
+                    top_block_->connect(conditioner, 0, gnss_sdr_make_sample_ring_sink(ring), 0);
+            }
+            catch (std::exception& e)
+            {
+                    LOG(WARNING) << "Can't connect the sample ring of signal conditioner " << i << ": " << e.what();
+                    continue;
+            }
+            LOG(INFO) << "Sample ring of " << capacity << " samples for signal conditioner " << i;
+        }
+}
+
+
+void GNSSFlowgraph::connect_capture_taps()
+{
+    for (int i = 0; i < sources_count_; i++)
+        {
+            const std::string role = sig_source_.at(i)->role();
+            const std::string filename = configuration_->property(role + ".capture_filename", std::string(""));
+            if (filename.empty() or sig_source_.at(i)->implementation().compare("Raw_Array_Signal_Source") == 0)
+                {
+                    continue;
+                }
+            const unsigned int bits = configuration_->property(role + ".capture_bits", 0u);
+            const unsigned int buffer_kb = configuration_->property(role + ".capture_buffer_kb", 4096u);
+            const unsigned int buffers = configuration_->property(role + ".capture_buffers", 4u);
+            const double sample_rate = configuration_->property(role + ".sampling_frequency", 0.0);
+            const int rf_channels = configuration_->property(role + ".RF_channels", 1);
+            for (int j = 0; j < rf_channels; j++)
+                {
+                    // the same outputs that feed the signal conditioners, after the valve
+                    gr::basic_block_sptr block = sig_source_.at(i)->get_right_block();
+                    int port = j;
+                    if (block->output_signature()->max_streams() <= 1)
+                        {
+                            if (j > 0) block = sig_source_.at(i)->get_right_block(j);
+                            port = 0;
+                        }
+                    const std::string capture = rf_channels > 1 ? filename + "_" + boost::lexical_cast<std::string>(j) : filename;
+                    try
+                    {
+                            top_block_->connect(block, port, gnss_sdr_make_capture_sink(block->output_signature()->sizeof_stream_item(port),
+                                    capture, bits, sample_rate, static_cast<size_t>(buffer_kb) * 1024, buffers), 0);
+                    }
+                    catch (std::exception& e)
+                    {
+                            LOG(WARNING) << "Can't capture the samples of " << role << " in " << capture << ": " << e.what();
+                            continue;
+                    }
+                    LOG(INFO) << "Capturing the samples of " << role << " in " << capture;
+                }
+        }
+}
+
+
+std::vector<std::shared_ptr<GNSSBlockInterface>> GNSSFlowgraph::adapters()
+{
+    std::vector<std::shared_ptr<GNSSBlockInterface>> blocks(sig_source_.begin(), sig_source_.end());
+    for (unsigned int i = 0; i < sig_conditioner_.size(); i++)
+        {
+            std::shared_ptr<SignalConditioner> conditioner = std::dynamic_pointer_cast<SignalConditioner>(sig_conditioner_.at(i));
+            if (conditioner)
+                {
+                    blocks.push_back(conditioner->data_type_adapter());
+                    if (conditioner->interference_mitigation()) blocks.push_back(conditioner->interference_mitigation());
+                    blocks.push_back(conditioner->input_filter());
+                    blocks.push_back(conditioner->resampler());
+                }
+            else
+                {
+                    blocks.push_back(sig_conditioner_.at(i));
+                }
+        }
+    for (unsigned int i = 0; i < channels_.size(); i++)
+        {
+            std::shared_ptr<Channel> channel = std::dynamic_pointer_cast<Channel>(channels_.at(i));
+            if (channel)
+                {
+                    blocks.push_back(channel->acquisition());
+                    blocks.push_back(channel->tracking());
+                    blocks.push_back(channel->telemetry());
+                }
+        }
+    blocks.push_back(observables_);
+    blocks.push_back(pvt_);
+    return blocks;
+}
+
+
+void GNSSFlowgraph::register_metrics(Gnss_Block_Metrics & metrics)
+{
+    std::vector<std::shared_ptr<GNSSBlockInterface>> blocks = adapters();
+    for (unsigned int i = 0; i < blocks.size(); i++)
+        {
+            if (!blocks.at(i)) continue;
+            // the signal sources have no left block
+            if (i >= sig_source_.size()) metrics.add_block(blocks.at(i)->role(), blocks.at(i)->get_left_block());
+            metrics.add_block(blocks.at(i)->role(), blocks.at(i)->get_right_block());
+        }
+}
+
+
+void GNSSFlowgraph::account_buffers()
+{
+    // the blocks of a channel are accounted to it, as when they were created
+    std::map<GNSSBlockInterface*, std::string> owners;
+    for (unsigned int i = 0; i < channels_.size(); i++)
+        {
+            std::shared_ptr<Channel> channel = std::dynamic_pointer_cast<Channel>(channels_.at(i));
+            if (!channel) continue;
+            const std::string prefix = "Channel" + boost::lexical_cast<std::string>(i) + "/";
+            owners[channel->acquisition().get()] = prefix + channel->acquisition()->role();
+            owners[channel->tracking().get()] = prefix + channel->tracking()->role();
+            owners[channel->telemetry().get()] = prefix + channel->telemetry()->role();
+        }
+    std::vector<std::shared_ptr<GNSSBlockInterface>> blocks = adapters();
+    for (unsigned int i = 0; i < blocks.size(); i++)
+        {
+            if (!blocks.at(i)) continue;
+            std::set<gr::basic_block*> counted;
+            unsigned long long bytes = 0;
+            gr::basic_block_sptr ends[2] = {i >= sig_source_.size() ? blocks.at(i)->get_left_block() : gr::basic_block_sptr(),
+                    blocks.at(i)->get_right_block()};
+            for (unsigned int e = 0; e < 2; e++)
+                {
+                    // hierarchical blocks have no buffers of their own
+                    gr::block_sptr block = boost::dynamic_pointer_cast<gr::block>(ends[e]);
+                    if (!block || !block->detail() || !counted.insert(block.get()).second) continue;
+                    for (int out = 0; out < block->detail()->noutputs(); out++)
+                        {
+                            bytes += static_cast<unsigned long long>(block->detail()->output(out)->bufsize())
+                                    * block->output_signature()->sizeof_stream_item(out);
+                        }
+                }
+            std::map<GNSSBlockInterface*, std::string>::const_iterator owner = owners.find(blocks.at(i).get());
+            Gnss_Sdr_Memory_Accounting::set_buffers(owner != owners.end() ? owner->second : blocks.at(i)->role(), bytes);
+        }
+}
+
+
+void GNSSFlowgraph::update_parameters(const std::map<std::string, std::string> & properties)
+{
+    std::vector<std::shared_ptr<GNSSBlockInterface>> blocks = adapters();
+
+    // the channels of a role may share a block, which is updated only once
+    std::set<std::string> applied;
+    std::set<gr::basic_block*> posted;
+    for (unsigned int i = 0; i < blocks.size(); i++)
+        {
+            if (blocks.at(i)) post_parameters(blocks.at(i), i >= sig_source_.size(), properties, applied, posted);
+        }
+    for (std::map<std::string, std::string>::const_iterator it = properties.begin(); it != properties.end(); ++it)
+        {
+            if (applied.count(it->first) == 0)
+                {
+                    LOG(WARNING) << "Configuration property " << it->first << " changed to " << it->second
+                                 << ", it takes effect at the next start of the receiver";
+                }
+        }
+}
+
+
+bool GNSSFlowgraph::post_parameters(std::shared_ptr<GNSSBlockInterface> block, bool has_left_block,
+        const std::map<std::string, std::string> & properties,
+        std::set<std::string> & applied, std::set<gr::basic_block*> & posted)
+{
+    const std::string prefix = boost::algorithm::to_lower_copy(block->role()) + ".";
+    pmt::pmt_t parameters = pmt::make_dict();
+    std::vector<std::string> names;
+    for (std::map<std::string, std::string>::const_iterator it = properties.lower_bound(prefix);
+            it != properties.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+        {
+            parameters = pmt::dict_add(parameters, pmt::mp(it->first.substr(prefix.size())), pmt::mp(it->second));
+            names.push_back(it->first);
+        }
+    if (names.empty())
+        {
+            return false;
+        }
+    bool accepted = false;
+    gr::basic_block_sptr ends[2] = { has_left_block ? block->get_left_block() : gr::basic_block_sptr(), block->get_right_block() };
+    for (unsigned int j = 0; j < 2; j++)
+        {
+            if (!ends[j] || !ends[j]->has_msg_port(pmt::mp("parameters")))
+                {
+                    continue;
+                }
+            accepted = true;
+            // the message is handled in the thread of the block, between two calls to its work
+            if (posted.insert(ends[j].get()).second)
+                {
+                    ends[j]->_post(pmt::mp("parameters"), parameters);
+                }
+            break;
+        }
+    if (accepted)
+        {
+            applied.insert(names.begin(), names.end());
+        }
+    return accepted;
+}
+
+
 bool GNSSFlowgraph::send_telemetry_msg(pmt::pmt_t msg)
 {
-    //push ephemeris to PVT telemetry msg in port using a channel out port
+    // navigation data (e.g., assistance ephemeris) goes to the store read by the PVT
+    if (pmt::is_any(msg) && Gnss_Nav_Data_Store::instance().update(pmt::any_ref(msg)))
+        {
+            return true;
+        }
+    //push other data to PVT telemetry msg in port using a channel out port
     // it uses the first channel as a message produces (it is already connected to PVT)
     channels_.at(0)->get_right_block()->message_port_pub(pmt::mp("telemetry"), msg);
     return true;
@@ -372,21 +832,27 @@ void GNSSFlowgraph::apply_action(unsigned int who, unsigned int what)
 
     switch (what)
     {
-    case 0:
+    case Control_Event_Bus::acquisition_failed:
         LOG(INFO) << "Channel " << who << " ACQ FAILED satellite " << channels_.at(who)->get_signal().get_satellite() << ", Signal " << channels_.at(who)->get_signal().get_signal_str();
-        available_GNSS_signals_.push_back(channels_.at(who)->get_signal());
-        //TODO: Optimize the channel and signal matching!
-        while ( channels_.at(who)->get_signal().get_signal_str().compare(available_GNSS_signals_.front().get_signal_str()) != 0 )
+        if (!channel_wanted(who))
             {
-                available_GNSS_signals_.push_back(available_GNSS_signals_.front());
-                available_GNSS_signals_.pop_front();
+                park_channel(who);
+                break;
             }
-        channels_.at(who)->set_signal(available_GNSS_signals_.front());
-        available_GNSS_signals_.pop_front();
+        {
+            // the failed satellite goes back to the list after the choice of the next one
+            Gnss_Signal failed_signal = channels_.at(who)->get_signal();
+            Gnss_Signal signal;
+            if (next_signal(failed_signal.get_signal_str(), signal))
+                {
+                    available_GNSS_signals_.push_back(failed_signal);
+                    channels_.at(who)->set_signal(signal);
+                }
+        }
         usleep(100);
         channels_.at(who)->start_acquisition();
         break;
-    case 1:
+    case Control_Event_Bus::acquisition_success:
         LOG(INFO) << "Channel " << who << " ACQ SUCCESS satellite " << channels_.at(who)->get_signal().get_satellite();
         channels_state_[who] = 2;
         acq_channels_count_--;
@@ -394,16 +860,16 @@ void GNSSFlowgraph::apply_action(unsigned int who, unsigned int what)
             {
                 for (unsigned int i = 0; i < channels_count_; i++)
                     {
-                        if (channels_state_[i] == 0)
+                        if (channels_state_[i] == 0 && channel_wanted(i))
                             {
-                                channels_state_[i] = 1;
-                                while (channels_.at(i)->get_signal().get_signal_str().compare(available_GNSS_signals_.front().get_signal_str()) != 0 )
+                                Gnss_Signal signal;
+                                if (!next_signal(channels_.at(i)->get_signal().get_signal_str(), signal))
                                     {
-                                        available_GNSS_signals_.push_back(available_GNSS_signals_.front());
-                                        available_GNSS_signals_.pop_front();
+                                        // no satellite left for the signal of this channel
+                                        continue;
                                     }
-                                channels_.at(i)->set_signal(available_GNSS_signals_.front());
-                                available_GNSS_signals_.pop_front();
+                                channels_state_[i] = 1;
+                                channels_.at(i)->set_signal(signal);
                                 acq_channels_count_++;
                                 channels_.at(i)->start_acquisition();
                                 break;
@@ -414,12 +880,24 @@ void GNSSFlowgraph::apply_action(unsigned int who, unsigned int what)
 
         break;
 
-    case 2:
+    case Control_Event_Bus::loss_of_lock:
         LOG(INFO) << "Channel " << who << " TRK FAILED satellite " << channels_.at(who)->get_signal().get_satellite();
-        if (acq_channels_count_ < max_acq_channels_)
+        if (shedding_.erase(who) > 0)
+            {
+                // stopped by shed_channel(), the satellite waits for a channel
+                channels_state_[who] = 0;
+                available_GNSS_signals_.push_back(channels_.at(who)->get_signal());
+            }
+        else if (!channel_wanted(who))
+            {
+                park_channel(who);
+            }
+        else if (acq_channels_count_ < max_acq_channels_)
             {
                 channels_state_[who] = 1;
                 acq_channels_count_++;
+                // the satellite was tracked a moment ago, so the reacquisition searches around its prediction
+                update_assistance(channels_.at(who)->get_signal());
                 channels_.at(who)->start_acquisition();
             }
         else
@@ -437,10 +915,563 @@ void GNSSFlowgraph::apply_action(unsigned int who, unsigned int what)
     default:
         break;
     }
+    if (dynamic_channels_)
+        {
+            wake_parked_channels();
+        }
     DLOG(INFO) << "Number of available signals: " << available_GNSS_signals_.size();
 }
 
 
+unsigned int GNSSFlowgraph::active_channels(const std::string & signal_str)
+{
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < channels_count_; i++)
+        {
+            if (channels_state_[i] != 0 && channels_.at(i)->get_signal().get_signal_str().compare(signal_str) == 0)
+                {
+                    count++;
+                }
+        }
+    return count;
+}
+
+
+unsigned int GNSSFlowgraph::satellites_maybe_in_view(const std::string & signal_str)
+{
+    unsigned int count = 0;
+    for (std::list<Gnss_Signal>::const_iterator it = available_GNSS_signals_.begin(); it != available_GNSS_signals_.end(); ++it)
+        {
+            if (it->get_signal_str().compare(signal_str) == 0 && scheduler_->may_be_in_view(*it))
+                {
+                    count++;
+                }
+        }
+    for (unsigned int i = 0; i < channels_count_; i++)
+        {
+            if (channels_state_[i] != 0 && channels_.at(i)->get_signal().get_signal_str().compare(signal_str) == 0
+                    && scheduler_->may_be_in_view(channels_.at(i)->get_signal()))
+                {
+                    count++;
+                }
+        }
+    return count;
+}
+
+
+unsigned int GNSSFlowgraph::active_channels()
+{
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < channels_count_; i++)
+        {
+            if (channels_state_[i] != 0)
+                {
+                    count++;
+                }
+        }
+    return count;
+}
+
+
+bool GNSSFlowgraph::channel_wanted(unsigned int channel)
+{
+    // an idle channel waits while the overload protection keeps it shed
+    if (shed_count_ > 0 && channels_state_[channel] == 0 && active_channels() >= channel_budget_)
+        {
+            return false;
+        }
+    if (!dynamic_channels_)
+        {
+            return true;
+        }
+    const std::string signal_str = channels_.at(channel)->get_signal().get_signal_str();
+    const unsigned int active = active_channels(signal_str);
+    const unsigned int in_view = satellites_maybe_in_view(signal_str);
+    // an active channel is counted, a parked one is not
+    return channels_state_[channel] != 0 ? active <= in_view : active < in_view;
+}
+
+
+void GNSSFlowgraph::park_channel(unsigned int channel)
+{
+    if (channels_state_[channel] == 1)
+        {
+            acq_channels_count_--;
+        }
+    channels_state_[channel] = 0;
+    available_GNSS_signals_.push_back(channels_.at(channel)->get_signal());
+    LOG(INFO) << "Channel " << channel << " parked, more channels than satellites of signal "
+              << channels_.at(channel)->get_signal().get_signal_str() << " that may be in view";
+}
+
+
+void GNSSFlowgraph::wake_parked_channels()
+{
+    for (unsigned int i = 0; i < channels_count_ && acq_channels_count_ < max_acq_channels_; i++)
+        {
+            if (channels_state_[i] != 0 || !channel_wanted(i))
+                {
+                    continue;
+                }
+            Gnss_Signal signal;
+            if (!next_signal(channels_.at(i)->get_signal().get_signal_str(), signal))
+                {
+                    continue;
+                }
+            channels_state_[i] = 1;
+            channels_.at(i)->set_signal(signal);
+            acq_channels_count_++;
+            channels_.at(i)->start_acquisition();
+            LOG(INFO) << "Channel " << i << " woken up for " << signal;
+        }
+}
+
+
+
+bool GNSSFlowgraph::shed_channel(unsigned int min_channels)
+{
+    const unsigned int active = active_channels();
+    if (active <= min_channels)
+        {
+            return false;
+        }
+    std::map<unsigned int, double> cn0;
+    std::vector<Gnss_Sdr_Realtime_Monitor::Channel_Load> loads = Gnss_Sdr_Realtime_Monitor::loads();
+    for (unsigned int i = 0; i < loads.size(); i++)
+        {
+            cn0[loads[i].channel] = loads[i].cn0_db_hz;
+        }
+    std::vector<Gnss_Channel_Value> candidates;
+    for (unsigned int i = 0; i < channels_count_; i++)
+        {
+            if (channels_state_[i] != 2 || shedding_.count(i) > 0)
+                {
+                    continue;
+                }
+            const Gnss_Signal signal = channels_.at(i)->get_signal();
+            Gnss_Channel_Value value;
+            value.channel = i;
+            value.system = signal.get_satellite().get_system_short()[0];
+            Gnss_Satellite_Prediction prediction;
+            value.has_elevation = scheduler_->prediction(signal, prediction);
+            value.elevation_d = value.has_elevation ? prediction.elevation_d : 0.0;
+            value.cn0_db_hz = cn0.count(i) > 0 ? cn0[i] : 0.0;
+            candidates.push_back(value);
+        }
+
+    // a channel whose tracking cannot be stopped is left out of the choice
+    unsigned int channel;
+    while (gnss_channel_to_shed(candidates, channel))
+        {
+            if (channels_.at(channel)->stop_tracking())
+                {
+                    shedding_.insert(channel);
+                    shed_count_++;
+                    channel_budget_ = active - 1;
+                    LOG(WARNING) << "Channel " << channel << " shed, tracking " << channels_.at(channel)->get_signal()
+                                 << ", " << channel_budget_ << " channels left active";
+                    return true;
+                }
+            for (std::vector<Gnss_Channel_Value>::iterator it = candidates.begin(); it != candidates.end(); ++it)
+                {
+                    if (it->channel == channel)
+                        {
+                            candidates.erase(it);
+                            break;
+                        }
+                }
+        }
+    return false;
+}
+
+
+bool GNSSFlowgraph::restore_channel()
+{
+    if (shed_count_ == 0)
+        {
+            return false;
+        }
+    shed_count_--;
+    channel_budget_++;
+    LOG(INFO) << "Channel restored, " << shed_count_ << " channels still shed";
+    // the idle channels take the satellites left, as in the dynamic pool
+    wake_parked_channels();
+    return true;
+}
+
+
+void GNSSFlowgraph::start_acquisitions(const std::vector<unsigned int> & channels)
+{
+    // The first acquisition of a channel sets it up (search grid, local code),
+    // which only involves the channel itself and the shared, thread-safe
+    // code and Doppler grid stores, so the channels are started in parallel
+    unsigned int threads = configuration_->property("GNSS-SDR.startup_threads", 0);
+    if (threads == 0)
+        {
+            threads = std::max(boost::thread::hardware_concurrency(), 1u);
+        }
+    threads = std::min(threads, static_cast<unsigned int>(channels.size()));
+
+    boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+    std::atomic<unsigned int> next(0);
+    boost::function<void()> starter = [this, &channels, &next]()
+            {
+        unsigned int n;
+        while ((n = next.fetch_add(1)) < channels.size())
+            {
+                channels_.at(channels.at(n))->start_acquisition();
+            }
+            };
+    Gnss_Sdr_Task_Group pool(Gnss_Sdr_Task_Pool::task_id("channel_startup"));
+    for (unsigned int i = 1; i < threads; i++)
+        {
+            pool.run(starter);
+        }
+    starter();
+    pool.wait();
+    LOG(INFO) << "Startup: acquisition of " << channels.size() << " channels started in "
+              << (boost::posix_time::microsec_clock::universal_time() - start).total_milliseconds()
+              << " ms with " << std::max(threads, 1u) << " threads";
+}
+
+
+void GNSSFlowgraph::set_thread_options(const std::vector<gr::basic_block_sptr> & blocks,
+        const std::string & role, const std::string & fallback_role, int numa_node)
+{
+    std::string affinity = configuration_->property(role + ".cpu_affinity", std::string(""));
+    int priority = configuration_->property(role + ".thread_priority", -1);
+    int node = configuration_->property(role + ".numa_node", -1);
+    if (!fallback_role.empty())
+        {
+            if (affinity.empty()) affinity = configuration_->property(fallback_role + ".cpu_affinity", std::string(""));
+            if (priority < 0) priority = configuration_->property(fallback_role + ".thread_priority", -1);
+            if (node < 0) node = configuration_->property(fallback_role + ".numa_node", -1);
+        }
+    if (node < 0) node = numa_node;
+    if (affinity.empty() && node >= 0)
+        {
+            // all the cores of the node, where the memory of the block is
+            affinity = Gnss_Sdr_Numa::cpu_affinity(node);
+        }
+    if (affinity.empty() && priority < 0)
+        {
+            return;
+        }
+
+    std::vector<int> cores;
+    try
+    {
+            boost::tokenizer<> tok(affinity);
+            for (boost::tokenizer<>::iterator it = tok.begin(); it != tok.end(); ++it)
+                {
+                    cores.push_back(boost::lexical_cast<int>(*it));
+                }
+    }
+    catch (boost::bad_lexical_cast &)
+    {
+            LOG(WARNING) << "Wrong list of cores for " << role << ": " << affinity;
+            cores.clear();
+    }
+
+    for (std::vector<gr::basic_block_sptr>::const_iterator it = blocks.begin(); it != blocks.end(); ++it)
+        {
+            if (!*it || (it != blocks.begin() && *it == *(it - 1)))
+                {
+                    continue;
+                }
+            gr::block_sptr block = boost::dynamic_pointer_cast<gr::block>(*it);
+            gr::hier_block2_sptr hier_block = boost::dynamic_pointer_cast<gr::hier_block2>(*it);
+            if (block)
+                {
+                    if (!cores.empty()) block->set_processor_affinity(cores);
+                    if (priority >= 0) block->set_thread_priority(priority);
+                }
+            else if (hier_block && !cores.empty())
+                {
+                    // to all the blocks inside, which have no common thread priority
+                    hier_block->set_processor_affinity(cores);
+                }
+            LOG(INFO) << role << ": block " << (*it)->alias() << " on cores [" << affinity << "], thread priority " << priority;
+        }
+}
+
+
+void GNSSFlowgraph::set_thread_options()
+{
+    /*
+     * Thread options of each block, set by role + ".cpu_affinity" (a list of
+     * cores) or role + ".numa_node" (all the cores of the node), and role +
+     * ".thread_priority". Signal conditioners give theirs to the blocks
+     * inside, and Channel<i> or the numa_node of its group of channels to
+     * the blocks of channel i.
+     */
+    for (unsigned int i = 0; i < sig_source_.size(); i++)
+        {
+            std::vector<gr::basic_block_sptr> blocks(1, sig_source_.at(i)->get_right_block());
+            set_thread_options(blocks, sig_source_.at(i)->role(), "");
+        }
+    for (unsigned int i = 0; i < sig_conditioner_.size(); i++)
+        {
+            std::shared_ptr<SignalConditioner> conditioner = std::dynamic_pointer_cast<SignalConditioner>(sig_conditioner_.at(i));
+            if (conditioner)
+                {
+                    std::shared_ptr<GNSSBlockInterface> parts[4] = { conditioner->data_type_adapter(), conditioner->input_filter(), conditioner->resampler(), conditioner->interference_mitigation() };
+                    for (unsigned int j = 0; j < 4; j++)
+                        {
+                            if (!parts[j]) continue;
+                            std::vector<gr::basic_block_sptr> blocks;
+                            blocks.push_back(parts[j]->get_left_block());
+                            blocks.push_back(parts[j]->get_right_block());
+                            set_thread_options(blocks, parts[j]->role(), conditioner->role());
+                        }
+                }
+            else
+                {
+                    std::vector<gr::basic_block_sptr> blocks;
+                    blocks.push_back(sig_conditioner_.at(i)->get_left_block());
+                    blocks.push_back(sig_conditioner_.at(i)->get_right_block());
+                    set_thread_options(blocks, sig_conditioner_.at(i)->role(), "");
+                }
+        }
+    for (unsigned int i = 0; i < channels_count_; i++)
+        {
+            const std::string channel_role = "Channel" + boost::lexical_cast<std::string>(i);
+            std::shared_ptr<Channel> channel = std::dynamic_pointer_cast<Channel>(channels_.at(i));
+            const int numa_node = Gnss_Sdr_Numa::channel_node(configuration_, i);
+            std::vector<gr::basic_block_sptr> blocks(1, channels_.at(i)->get_left_block());
+            set_thread_options(blocks, channel_role, "", numa_node);
+            if (!channel)
+                {
+                    continue;
+                }
+            std::shared_ptr<GNSSBlockInterface> parts[3] = { channel->acquisition(), channel->tracking(), channel->telemetry() };
+            for (unsigned int j = 0; j < 3; j++)
+                {
+                    blocks.clear();
+                    blocks.push_back(parts[j]->get_left_block());
+                    blocks.push_back(parts[j]->get_right_block());
+                    set_thread_options(blocks, parts[j]->role(), channel_role, numa_node);
+                }
+        }
+    std::shared_ptr<GNSSBlockInterface> others[2] = { observables_, pvt_ };
+    for (unsigned int j = 0; j < 2; j++)
+        {
+            std::vector<gr::basic_block_sptr> blocks;
+            blocks.push_back(others[j]->get_left_block());
+            blocks.push_back(others[j]->get_right_block());
+            set_thread_options(blocks, others[j]->role(), "");
+        }
+}
+
+
+void GNSSFlowgraph::set_buffer_options(const std::vector<gr::basic_block_sptr> & blocks,
+        const std::string & role, const std::string & fallback_role, double item_rate_hz)
+{
+    long min_buffer = configuration_->property(role + ".min_output_buffer", 0L);
+    long max_buffer = configuration_->property(role + ".max_output_buffer", 0L);
+    int max_items = configuration_->property(role + ".max_noutput_items", 0);
+    if (!fallback_role.empty())
+        {
+            if (min_buffer <= 0) min_buffer = configuration_->property(fallback_role + ".min_output_buffer", 0L);
+            if (max_buffer <= 0) max_buffer = configuration_->property(fallback_role + ".max_output_buffer", 0L);
+            if (max_items <= 0) max_items = configuration_->property(fallback_role + ".max_noutput_items", 0);
+        }
+
+    for (std::vector<gr::basic_block_sptr>::const_iterator it = blocks.begin(); it != blocks.end(); ++it)
+        {
+            // hierarchical blocks have no buffers of their own, nor do the sinks
+            gr::block_sptr block = boost::dynamic_pointer_cast<gr::block>(*it);
+            if (!block || (it != blocks.begin() && *it == *(it - 1))
+                    || block->output_signature()->max_streams() == 0)
+                {
+                    continue;
+                }
+            Gnss_Sdr_Buffer_Settings settings = { min_buffer, max_buffer, max_items };
+            if (item_rate_hz > 0.0)
+                {
+                    Gnss_Sdr_Buffer_Settings tuned = Gnss_Sdr_Buffer_Tuning::autotune(item_rate_hz,
+                            block->output_signature()->sizeof_stream_item(0), buffer_work_period_, buffer_period_);
+                    if (settings.min_output_buffer <= 0) settings.min_output_buffer = tuned.min_output_buffer;
+                    if (settings.max_output_buffer <= 0) settings.max_output_buffer = tuned.max_output_buffer;
+                    if (settings.max_noutput_items <= 0) settings.max_noutput_items = tuned.max_noutput_items;
+                }
+            if (settings.min_output_buffer > 0) block->set_min_output_buffer(settings.min_output_buffer);
+            if (settings.max_output_buffer > 0) block->set_max_output_buffer(std::max(settings.max_output_buffer, settings.min_output_buffer));
+            if (settings.max_noutput_items > 0) block->set_max_noutput_items(settings.max_noutput_items);
+            if (settings.min_output_buffer > 0 || settings.max_output_buffer > 0 || settings.max_noutput_items > 0)
+                {
+                    LOG(INFO) << role << ": block " << block->alias() << " output buffer of " << settings.min_output_buffer
+                              << " to " << settings.max_output_buffer << " items, at most " << settings.max_noutput_items
+                              << " items per work call";
+                }
+        }
+}
+
+
+double GNSSFlowgraph::integration_time(unsigned int channel)
+{
+    std::shared_ptr<Channel> channel_block = std::dynamic_pointer_cast<Channel>(channels_.at(channel));
+    const std::string signal_str = channels_.at(channel)->get_signal().get_signal_str();
+    int extend = 1;
+    if (channel_block)
+        {
+            extend = std::max(configuration_->property(channel_block->tracking()->role() + ".extend_correlation_ms", 1), 1);
+        }
+    return Gnss_Sdr_Buffer_Tuning::code_period(signal_str) * extend;
+}
+
+
+void GNSSFlowgraph::set_buffer_options()
+{
+    /*
+     * Buffer options of each block, set by role + ".min_output_buffer" and
+     * role + ".max_output_buffer" (in items) and role + ".max_noutput_items",
+     * with the same fallbacks as the thread options. With
+     * GNSS-SDR.buffer_autotune, the blocks that have none get a work call per
+     * integration period of the fastest channel and a buffer of
+     * GNSS-SDR.buffer_autotune_periods integration periods of the slowest
+     * one: the sample streams at their sampling rate, and the tracking and
+     * telemetry outputs at an item per integration period of their channel.
+     */
+    const bool autotune = configuration_->property("GNSS-SDR.buffer_autotune", false);
+    const double internal_fs = configuration_->property("GNSS-SDR.internal_fs_hz", 2048000.0);
+    buffer_work_period_ = 0.0;
+    buffer_period_ = 0.0;
+    if (autotune)
+        {
+            double shortest = 0.0;
+            double longest = 0.0;
+            for (unsigned int i = 0; i < channels_count_; i++)
+                {
+                    const double period = integration_time(i);
+                    shortest = (i == 0) ? period : std::min(shortest, period);
+                    longest = std::max(longest, period);
+                }
+            if (channels_count_ == 0)
+                {
+                    shortest = longest = 0.001;
+                }
+            const unsigned int periods = std::max(configuration_->property("GNSS-SDR.buffer_autotune_periods", 4u), 2u);
+            buffer_work_period_ = shortest;
+            buffer_period_ = periods * longest;
+        }
+
+    for (unsigned int i = 0; i < sig_source_.size(); i++)
+        {
+            const std::string role = sig_source_.at(i)->role();
+            const double fs = autotune ? configuration_->property(role + ".sampling_frequency", internal_fs) : 0.0;
+            std::vector<gr::basic_block_sptr> blocks(1, sig_source_.at(i)->get_right_block());
+            set_buffer_options(blocks, role, "", fs);
+        }
+    for (unsigned int i = 0; i < sig_conditioner_.size(); i++)
+        {
+            const double fs = autotune ? internal_fs : 0.0;
+            std::shared_ptr<SignalConditioner> conditioner = std::dynamic_pointer_cast<SignalConditioner>(sig_conditioner_.at(i));
+            if (conditioner)
+                {
+                    std::shared_ptr<GNSSBlockInterface> parts[4] = { conditioner->data_type_adapter(), conditioner->input_filter(), conditioner->resampler(), conditioner->interference_mitigation() };
+                    for (unsigned int j = 0; j < 4; j++)
+                        {
+                            if (!parts[j]) continue;
+                            std::vector<gr::basic_block_sptr> blocks;
+                            blocks.push_back(parts[j]->get_left_block());
+                            blocks.push_back(parts[j]->get_right_block());
+                            set_buffer_options(blocks, parts[j]->role(), conditioner->role(), fs);
+                        }
+                }
+            else
+                {
+                    std::vector<gr::basic_block_sptr> blocks;
+                    blocks.push_back(sig_conditioner_.at(i)->get_left_block());
+                    blocks.push_back(sig_conditioner_.at(i)->get_right_block());
+                    set_buffer_options(blocks, sig_conditioner_.at(i)->role(), "", fs);
+                }
+        }
+    for (unsigned int i = 0; i < channels_count_; i++)
+        {
+            std::shared_ptr<Channel> channel = std::dynamic_pointer_cast<Channel>(channels_.at(i));
+            if (!channel)
+                {
+                    continue;
+                }
+            const std::string channel_role = "Channel" + boost::lexical_cast<std::string>(i);
+            const double rate = autotune ? 1.0 / integration_time(i) : 0.0;
+            // the acquisition gets no tuning: it has no outputs, or a copy of its input
+            std::shared_ptr<GNSSBlockInterface> parts[3] = { channel->acquisition(), channel->tracking(), channel->telemetry() };
+            for (unsigned int j = 0; j < 3; j++)
+                {
+                    std::vector<gr::basic_block_sptr> blocks;
+                    blocks.push_back(parts[j]->get_left_block());
+                    blocks.push_back(parts[j]->get_right_block());
+                    set_buffer_options(blocks, parts[j]->role(), channel_role, j == 0 ? 0.0 : rate);
+                }
+        }
+    std::shared_ptr<GNSSBlockInterface> others[2] = { observables_, pvt_ };
+    for (unsigned int j = 0; j < 2; j++)
+        {
+            std::vector<gr::basic_block_sptr> blocks;
+            blocks.push_back(others[j]->get_left_block());
+            blocks.push_back(others[j]->get_right_block());
+            set_buffer_options(blocks, others[j]->role(), "", 0.0);
+        }
+}
+
+
+bool GNSSFlowgraph::next_signal(const std::string & signal_str, Gnss_Signal & signal)
+{
+    // The L2C and E5a channels, of this or another source, search first the
+    // satellites found on L1 C/A and E1, around the Doppler shift tracked there
+    if (Acquisition_Assistance::cross_band() and (signal_str.compare("2S") == 0 or signal_str.compare("5X") == 0))
+        {
+            for (std::list<Gnss_Signal>::iterator it = available_GNSS_signals_.begin(); it != available_GNSS_signals_.end(); ++it)
+                {
+                    if (it->get_signal_str().compare(signal_str) == 0
+                            and Acquisition_Assistance::cross_band_tracked(it->get_satellite().get_system_short().at(0), it->get_satellite().get_PRN()))
+                        {
+                            signal = *it;
+                            available_GNSS_signals_.erase(it);
+                            update_assistance(signal);
+                            return true;
+                        }
+                }
+        }
+    if (!scheduler_->next_signal(available_GNSS_signals_, signal_str, signal))
+        {
+            return false;
+        }
+    update_assistance(signal);
+    return true;
+}
+
+
+void GNSSFlowgraph::update_assistance(const Gnss_Signal & signal)
+{
+    const std::string signal_str = signal.get_signal_str();
+    if (signal.get_satellite().get_system_short().compare("G") != 0
+            || (signal_str.compare("1C") != 0 && signal_str.compare("2S") != 0))
+        {
+            return;
+        }
+    Gnss_Satellite_Prediction prediction;
+    if (!scheduler_->prediction(signal, prediction))
+        {
+            return;
+        }
+    // narrows the Doppler search of the acquisitions. The map holds the Doppler of L1, as SUPL does
+    Gps_Acq_Assist gps_acq;
+    const unsigned int prn = signal.get_satellite().get_PRN();
+    global_gps_acq_assist_map.read(prn, gps_acq);
+    gps_acq.i_satellite_PRN = prn;
+    gps_acq.d_Doppler0 = prediction.doppler_hz("1C");
+    gps_acq.d_Doppler1 = 0.0;
+    gps_acq.dopplerUncertainty = doppler_uncertainty_hz_;
+    gps_acq.Elevation = prediction.elevation_d;
+    gps_acq.Azimuth = prediction.azimuth_d;
+    global_gps_acq_assist_map.write(prn, gps_acq);
+    DLOG(INFO) << "GPS PRN " << prn << " predicted at elevation " << prediction.elevation_d
+               << " [deg], L1 Doppler " << gps_acq.d_Doppler0 << " [Hz]";
+}
+
 
 void GNSSFlowgraph::set_configuration(std::shared_ptr<ConfigurationInterface> configuration)
 {
@@ -466,9 +1497,45 @@ void GNSSFlowgraph::init()
      */
     std::unique_ptr<GNSSBlockFactory> block_factory_(new GNSSBlockFactory());
 
+    // Reuse the FFT plans computed in previous runs, if any
+    std::string wisdom_file = configuration_->property("GNSS-SDR.fftw_wisdom_file", std::string(""));
+    if (!wisdom_file.empty())
+        {
+            Fft_Planner::instance().load_wisdom(wisdom_file);
+        }
+
+    // Long-code searches (E5a, L2CM) split their FFTs over several threads
+    Fft_Planner::instance().set_threading(configuration_->property("GNSS-SDR.fft_threads", 1),
+            configuration_->property("GNSS-SDR.fft_threads_min_size", 65536));
+
+    // Large buffers are allocated on huge pages, unless disabled
+    volk_gnsssdr_set_huge_pages(configuration_->property("GNSS-SDR.huge_pages", true) ? 1 : 0);
+
+    // startup time of each kind of block, for the log
+    boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+    boost::posix_time::ptime step_start = start;
+    std::ostringstream breakdown;
+    auto log_step = [&step_start, &breakdown](const std::string & blocks)
+            {
+        boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+        breakdown << ", " << blocks << " " << (now - step_start).total_milliseconds() << " ms";
+        step_start = now;
+            };
+
     // 1. read the number of RF front-ends available (one file_source per RF front-end)
     sources_count_ = configuration_->property("Receiver.sources_count", 1);
 
+    // A central receiver gets the observables of an edge receiver from the
+    // network, and a replay reads them from RINEX files; both only run the PVT
+    const std::string observables_implementation = configuration_->property("Observables.implementation", std::string(""));
+    remote_observables_ = observables_implementation.compare("Observables_Stream_Source") == 0
+            || observables_implementation.compare("RINEX_Observables_Source") == 0;
+    if (remote_observables_)
+        {
+            sources_count_ = 0;
+            LOG(INFO) << "Observables from " << observables_implementation << ", no signal source nor channels";
+        }
+
     int RF_Channels = 0;
     int signal_conditioner_ID = 0;
 
@@ -490,7 +1557,7 @@ void GNSSFlowgraph::init()
                         }
                 }
         }
-    else
+    else if (!remote_observables_)
         {
             //backwards compatibility for old config files
             sig_source_.push_back(block_factory_->GetSignalSource(configuration_, queue_, -1));
@@ -513,10 +1580,25 @@ void GNSSFlowgraph::init()
                 }
         }
 
-    observables_ = block_factory_->GetObservables(configuration_);
+    log_step("signal sources and conditioners");
+
+    observables_ = block_factory_->GetObservables(configuration_, queue_);
+    log_step("observables");
     pvt_ = block_factory_->GetPVT(configuration_);
+    log_step("PVT");
 
-    std::shared_ptr<std::vector<std::unique_ptr<GNSSBlockInterface>>> channels = block_factory_->GetChannels(configuration_, queue_);
+    std::shared_ptr<std::vector<std::unique_ptr<GNSSBlockInterface>>> channels;
+    if (remote_observables_)
+        {
+            channels = std::make_shared<std::vector<std::unique_ptr<GNSSBlockInterface>>>();
+        }
+    else
+        {
+            channels = block_factory_->GetChannels(configuration_, queue_);
+        }
+    log_step(boost::lexical_cast<std::string>(channels->size()) + " channels");
+    LOG(INFO) << "Startup: blocks created in "
+              << (step_start - start).total_milliseconds() << " ms" << breakdown.str();
 
     //todo:check smart pointer coherence...
     channels_count_ = channels->size();
@@ -530,8 +1612,37 @@ void GNSSFlowgraph::init()
 
     // fill the available_GNSS_signals_ queue with the satellites ID's to be searched by the acquisition
     set_signals_list();
+    // and choose among them by elevation once the position and the ephemeris are known
+    scheduler_ = std::make_shared<Gnss_Satellite_Scheduler>(
+            configuration_->property("GNSS-SDR.satellite_scheduler", true),
+            configuration_->property("GNSS-SDR.elevation_mask_deg", 5.0),
+            configuration_->property("GNSS-SDR.satellite_scheduler_period_s", 30.0));
+    doppler_uncertainty_hz_ = configuration_->property("GNSS-SDR.satellite_scheduler_doppler_uncertainty_hz", 500.0);
+    // the acquisitions only search around the predicted Doppler shifts
+    Acquisition_Assistance::set_enabled(configuration_->property("GNSS-SDR.acquisition_assistance", false));
+    // and the L2C and E5a acquisitions around the Doppler shifts tracked on L1 C/A and E1
+    Acquisition_Assistance::set_cross_band(configuration_->property("GNSS-SDR.cross_band_aiding", false),
+            configuration_->property("GNSS-SDR.cross_band_doppler_uncertainty_hz", 10.0));
+    // and the L1 C/A and E1 acquisitions around the Doppler shift of a recent loss of lock
+    Acquisition_Assistance::set_reacquisition(configuration_->property("GNSS-SDR.reacquisition_memory", false),
+            configuration_->property("GNSS-SDR.reacquisition_window_s", 10.0),
+            configuration_->property("GNSS-SDR.reacquisition_doppler_uncertainty_hz", 50.0),
+            configuration_->property("GNSS-SDR.reacquisition_doppler_rate_uncertainty_hz_s", 10.0));
+    // channels beyond the satellites that may be in view are parked
+    dynamic_channels_ = configuration_->property("Channels.dynamic_pool", false);
+    channel_budget_ = 0;
+    shed_count_ = 0;
+    shedding_.clear();
     set_channels_state();
     applied_actions_ = 0;
+    buffer_work_period_ = 0.0;
+    buffer_period_ = 0.0;
+
+    // All the blocks have planned their FFTs by now
+    if (!wisdom_file.empty())
+        {
+            Fft_Planner::instance().save_wisdom();
+        }
 
     DLOG(INFO) << "Blocks instantiated. " << channels_count_ << " channels.";
 }
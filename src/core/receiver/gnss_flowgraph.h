@@ -37,19 +37,24 @@
 #define GNSS_SDR_GNSS_FLOWGRAPH_H_
 
 #include <list>
+#include <map>
 #include <memory>
 #include <queue>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 #include <gnuradio/top_block.h>
 #include <gnuradio/msg_queue.h>
 #include "GPS_L1_CA.h"
 #include "gnss_signal.h"
+#include "gnss_satellite_scheduler.h"
 
 class GNSSBlockInterface;
 class ChannelInterface;
 class ConfigurationInterface;
 class GNSSBlockFactory;
+class Gnss_Block_Metrics;
 
 /*! \brief This class represents a GNSS flowgraph.
  *
@@ -95,6 +100,33 @@ public:
 
     void set_configuration(std::shared_ptr<ConfigurationInterface> configuration);
 
+    /*!
+     * \brief Sends the properties changed in the configuration, by lower case
+     * name, to the blocks of their role that accept updates on a "parameters"
+     * message port. Those of the other blocks take effect at the next start.
+     */
+    void update_parameters(const std::map<std::string, std::string> & properties);
+
+    //! Adds the blocks of the receiver to \p metrics, once they are connected
+    void register_metrics(Gnss_Block_Metrics & metrics);
+
+    /*!
+     * \brief Overload protection: stops the tracking channel whose measurement
+     * is worth least (see gnss_channel_to_shed), unless no more than
+     * \p min_channels channels are active, and keeps the idle channels from
+     * taking its place. Returns false if no channel is stopped.
+     */
+    bool shed_channel(unsigned int min_channels);
+
+    //! Lets one more channel acquire, undoing the last shed_channel(). Returns false if none is shed.
+    bool restore_channel();
+
+    //! Channels stopped by shed_channel() and not restored yet
+    unsigned int shed_channels()
+    {
+        return shed_count_;
+    }
+
     unsigned int applied_actions()
     {
         return applied_actions_;
@@ -116,10 +148,49 @@ public:
 private:
     void init(); // Populates the SV PRN list available for acquisition and tracking
     void set_signals_list();
+    // CPU affinity and real-time priority of the block threads, from the configuration
+    void set_thread_options();
+    void set_thread_options(const std::vector<gr::basic_block_sptr> & blocks,
+            const std::string & role, const std::string & fallback_role, int numa_node = -1);
+    // Output buffers and work call sizes of the blocks, from the configuration or GNSS-SDR.buffer_autotune
+    void set_buffer_options();
+    void set_buffer_options(const std::vector<gr::basic_block_sptr> & blocks,
+            const std::string & role, const std::string & fallback_role, double item_rate_hz);
+    double integration_time(unsigned int channel); // of the tracking of the channel, in seconds
+    // Samples dropped from the start of each source, from SignalSource<N>.start_time_s, see gnss_source_alignment()
+    void align_sources();
+    // Connects an output of a source to a conditioner, through the block that drops its samples before the common start
+    void connect_source(int source, gr::basic_block_sptr block, int port, gr::basic_block_sptr conditioner, int conditioner_port);
+    // Probes of the arrival of the samples and of the output of the conditioner, see Gnss_Sdr_Latency_Tracer
+    void connect_latency_probes();
+    // Rings of the conditioned samples read by the acquisitions, see Gnss_Sample_Ring
+    void connect_sample_rings();
+    // Captures of the samples delivered by the signal sources, see Gnss_Sample_Capture_Writer
+    void connect_capture_taps();
+    // The adapters of the receiver, those of the signal conditioners and channels included
+    std::vector<std::shared_ptr<GNSSBlockInterface>> adapters();
+    // Accounts the stream buffers of the blocks, once GNU Radio has allocated them
+    void account_buffers();
+    // Posts to the blocks of \p block the properties of its role, returns false if none is accepted
+    bool post_parameters(std::shared_ptr<GNSSBlockInterface> block, bool has_left_block,
+            const std::map<std::string, std::string> & properties,
+            std::set<std::string> & applied, std::set<gr::basic_block*> & posted);
+    bool next_signal(const std::string & signal_str, Gnss_Signal & signal); // Takes the next signal to acquire out of the list
+    void update_assistance(const Gnss_Signal & signal); // Publishes the predicted Doppler of a GPS signal in global_gps_acq_assist_map
+    // Dynamic channel pool: an idle channel is parked, without acquisition,
+    // while there are more active channels than satellites that may be in view
+    unsigned int active_channels(const std::string & signal_str);
+    unsigned int satellites_maybe_in_view(const std::string & signal_str);
+    bool channel_wanted(unsigned int channel);
+    unsigned int active_channels(); // acquiring or tracking, of any signal
+    void park_channel(unsigned int channel);
+    void wake_parked_channels();
+    void start_acquisitions(const std::vector<unsigned int> & channels); // in parallel, GNSS-SDR.startup_threads
     void set_channels_state(); // Initializes the channels state (start acquisition or keep standby)
                                // using the configuration parameters (number of channels and max channels in acquisition)
     bool connected_;
     bool running_;
+    bool remote_observables_; // the observables come from an edge receiver or RINEX files, there is no signal processing
     int sources_count_;
 
     unsigned int channels_count_;
@@ -131,6 +202,8 @@ private:
 
     std::vector<std::shared_ptr<GNSSBlockInterface>> sig_source_;
     std::vector<std::shared_ptr<GNSSBlockInterface>> sig_conditioner_;
+    std::vector<unsigned long long> source_skip_;  // samples dropped from the start of each source
+    std::map<std::pair<gr::basic_block*, int>, gr::basic_block_sptr> source_skipheads_;
 
     std::shared_ptr<GNSSBlockInterface> observables_;
     std::shared_ptr<GNSSBlockInterface> pvt_;
@@ -140,6 +213,16 @@ private:
     boost::shared_ptr<gr::msg_queue> queue_;
     std::list<Gnss_Signal> available_GNSS_signals_;
     std::vector<unsigned int> channels_state_;
+    std::shared_ptr<Gnss_Satellite_Scheduler> scheduler_;
+    double doppler_uncertainty_hz_;
+    double buffer_work_period_; // seconds of samples per work call with GNSS-SDR.buffer_autotune
+    double buffer_period_;      // seconds of samples in a buffer with GNSS-SDR.buffer_autotune
+    bool dynamic_channels_;
+    // Overload protection: at most channel_budget_ active channels while
+    // shed_count_ > 0, and the channels whose stop is not reported yet
+    unsigned int channel_budget_;
+    unsigned int shed_count_;
+    std::set<unsigned int> shedding_;
 };
 
 #endif /*GNSS_SDR_GNSS_FLOWGRAPH_H_*/
@@ -0,0 +1,157 @@
+/*!
+ * \file gnss_metrics_server.cc
+ * \brief Minimal HTTP server of the performance counters of the receiver
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_metrics_server.h"
+#include <sstream>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+//! Longest request that is read, headers included
+#define METRICS_SERVER_MAX_REQUEST 8192
+
+
+/*!
+ * \brief A connection, alive while it has an operation pending
+ */
+class Gnss_Metrics_Server::Connection : public std::enable_shared_from_this<Gnss_Metrics_Server::Connection>
+{
+public:
+    Connection(boost::asio::ip::tcp::socket socket, const std::string & body)
+        : d_socket(std::move(socket)), d_request(METRICS_SERVER_MAX_REQUEST), d_body(body)
+    {}
+
+    void start()
+    {
+        // the answer is the same whatever the request, which is only read to its end
+        auto self(shared_from_this());
+        boost::asio::async_read_until(d_socket, d_request, "\r\n\r\n",
+                [this, self](boost::system::error_code ec, std::size_t)
+                {
+            if (ec && ec != boost::asio::error::not_found)
+                {
+                    return;
+                }
+            std::ostringstream response;
+            response << "HTTP/1.0 200 OK\r\n"
+                     << "Content-Type: text/plain; version=0.0.4\r\n"
+                     << "Content-Length: " << d_body.size() << "\r\n"
+                     << "Connection: close\r\n\r\n"
+                     << d_body;
+            d_response = response.str();
+            boost::asio::async_write(d_socket, boost::asio::buffer(d_response),
+                    [this, self](boost::system::error_code, std::size_t)
+                    {
+                boost::system::error_code ignored;
+                d_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored);
+                    });
+                });
+    }
+
+private:
+    boost::asio::ip::tcp::socket d_socket;
+    boost::asio::streambuf d_request;
+    std::string d_body;
+    std::string d_response;
+};
+
+
+Gnss_Metrics_Server::Gnss_Metrics_Server(unsigned short port, std::function<std::string()> content)
+    : d_port(port), d_content(content), d_running(false),
+      d_acceptor(d_io_service), d_socket(d_io_service)
+{}
+
+
+Gnss_Metrics_Server::~Gnss_Metrics_Server()
+{
+    stop();
+}
+
+
+bool Gnss_Metrics_Server::start()
+{
+    if (d_running)
+        {
+            return true;
+        }
+    try
+    {
+            boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::tcp::v4(), d_port);
+            d_acceptor.open(endpoint.protocol());
+            d_acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+            d_acceptor.bind(endpoint);
+            d_acceptor.listen();
+            d_port = d_acceptor.local_endpoint().port();
+    }
+    catch (const boost::system::system_error & e)
+    {
+            LOG(WARNING) << "The metrics server cannot listen on port " << d_port << ": " << e.what();
+            boost::system::error_code ec;
+            d_acceptor.close(ec);
+            return false;
+    }
+    do_accept();
+    d_thread = std::thread([this]() { d_io_service.run(); });
+    d_running = true;
+    LOG(INFO) << "The metrics server is accepting connections on port " << d_port;
+    return true;
+}
+
+
+void Gnss_Metrics_Server::stop()
+{
+    if (!d_running)
+        {
+            return;
+        }
+    // the connections in progress are dropped
+    d_io_service.stop();
+    d_thread.join();
+    boost::system::error_code ec;
+    d_acceptor.close(ec);
+    d_running = false;
+}
+
+
+void Gnss_Metrics_Server::do_accept()
+{
+    d_acceptor.async_accept(d_socket, [this](boost::system::error_code ec)
+            {
+        if (!d_acceptor.is_open())
+            {
+                return;
+            }
+        if (!ec)
+            {
+                std::make_shared<Connection>(std::move(d_socket), d_content())->start();
+            }
+        do_accept();
+            });
+}
@@ -0,0 +1,82 @@
+/*!
+ * \file gnss_metrics_server.h
+ * \brief Minimal HTTP server of the performance counters of the receiver
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Answers any request with the text returned by a function, for instance
+ * the counters of the blocks in the Prometheus text format. It runs in
+ * its own thread, one connection at a time, and closes each of them after
+ * the answer, as HTTP/1.0 does.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_METRICS_SERVER_H_
+#define GNSS_SDR_GNSS_METRICS_SERVER_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <boost/asio.hpp>
+
+class Gnss_Metrics_Server
+{
+public:
+    /*!
+     * \brief Serves \p port (0 picks a free one) with the text of \p content,
+     * which is called from the thread of the server.
+     */
+    Gnss_Metrics_Server(unsigned short port, std::function<std::string()> content);
+    ~Gnss_Metrics_Server();
+
+    //! Starts accepting connections. Returns false if the port cannot be bound.
+    bool start();
+
+    //! Closes the connections and joins the thread
+    void stop();
+
+    //! Port the server is listening on
+    unsigned short port() const
+    {
+        return d_port;
+    }
+
+private:
+    class Connection;
+
+    void do_accept();
+
+    unsigned short d_port;
+    std::function<std::string()> d_content;
+    bool d_running;
+
+    boost::asio::io_service d_io_service;
+    boost::asio::ip::tcp::acceptor d_acceptor;
+    boost::asio::ip::tcp::socket d_socket;
+    std::thread d_thread;
+};
+
+#endif /*GNSS_SDR_GNSS_METRICS_SERVER_H_*/
@@ -0,0 +1,257 @@
+/*!
+ * \file gnss_satellite_scheduler.cc
+ * \brief Orders the satellites to acquire by their predicted elevation
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_satellite_scheduler.h"
+#include <cmath>
+#include <glog/logging.h>
+#include "GPS_L1_CA.h"
+#include "GPS_L2C.h"
+#include "Galileo_E5a.h"
+
+using google::LogMessage;
+
+namespace
+{
+// WGS84 ellipsoid
+const double WGS84_A = 6378137.0;
+const double WGS84_E2 = 6.69437999014e-3;
+
+// the ephemeris are used up to this time from their reference epoch
+const double MAX_EPHEMERIS_AGE_S = 4.0 * 3600.0;
+
+// travel time of the signal, enough for a prediction
+const double TRAVEL_TIME_S = 0.075;
+
+void geodetic_to_ecef(double lat_rad, double lon_rad, double height_m, double * ecef)
+{
+    const double sin_lat = std::sin(lat_rad);
+    const double N = WGS84_A / std::sqrt(1.0 - WGS84_E2 * sin_lat * sin_lat);
+    ecef[0] = (N + height_m) * std::cos(lat_rad) * std::cos(lon_rad);
+    ecef[1] = (N + height_m) * std::cos(lat_rad) * std::sin(lon_rad);
+    ecef[2] = (N * (1.0 - WGS84_E2) + height_m) * sin_lat;
+}
+
+
+double distance(const double * a, const double * b)
+{
+    return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]) + (a[2] - b[2]) * (a[2] - b[2]));
+}
+
+
+// the ephemeris is a copy, satellitePosition() modifies it
+template<typename Ephemeris>
+bool predict_satellite(Ephemeris ephemeris, double toe, double gps_tow_s,
+        double lat_rad, double lon_rad, const double * rx, Gnss_Satellite_Prediction & prediction)
+{
+    double age = gps_tow_s - toe;
+    if (age > 302400.0) age -= 604800.0;
+    if (age < -302400.0) age += 604800.0;
+    if (std::fabs(age) > MAX_EPHEMERIS_AGE_S)
+        {
+            return false;
+        }
+
+    // positions one second apart for the range rate, which is seen from the
+    // rotating Earth as the satellite positions are in ECEF
+    ephemeris.satellitePosition(gps_tow_s - TRAVEL_TIME_S);
+    const double sat0[3] = { ephemeris.d_satpos_X, ephemeris.d_satpos_Y, ephemeris.d_satpos_Z };
+    ephemeris.satellitePosition(gps_tow_s + 1.0 - TRAVEL_TIME_S);
+    const double sat1[3] = { ephemeris.d_satpos_X, ephemeris.d_satpos_Y, ephemeris.d_satpos_Z };
+
+    // line of sight in the local East, North, Up frame
+    const double dx = sat0[0] - rx[0];
+    const double dy = sat0[1] - rx[1];
+    const double dz = sat0[2] - rx[2];
+    const double sin_lat = std::sin(lat_rad);
+    const double cos_lat = std::cos(lat_rad);
+    const double sin_lon = std::sin(lon_rad);
+    const double cos_lon = std::cos(lon_rad);
+    const double east = -sin_lon * dx + cos_lon * dy;
+    const double north = -sin_lat * cos_lon * dx - sin_lat * sin_lon * dy + cos_lat * dz;
+    const double up = cos_lat * cos_lon * dx + cos_lat * sin_lon * dy + sin_lat * dz;
+
+    prediction.elevation_d = std::atan2(up, std::sqrt(east * east + north * north)) * 180.0 / GPS_PI;
+    prediction.azimuth_d = std::atan2(east, north) * 180.0 / GPS_PI;
+    if (prediction.azimuth_d < 0.0) prediction.azimuth_d += 360.0;
+    prediction.range_rate_m_s = distance(sat1, rx) - distance(sat0, rx);
+    return true;
+}
+
+
+// GPS time of week now: from the time of the PVT solution or, for a
+// reference location, from the system clock
+double gps_tow_now(const Gnss_Rx_Position & position, const Gnss_Nav_Data & nav)
+{
+    if (position.has_time)
+        {
+            const double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - position.stamp).count();
+            return std::fmod(position.gps_tow_s + elapsed_s, 604800.0);
+        }
+    const double leap_s = nav.gps_utc_model.valid ? nav.gps_utc_model.d_DeltaT_LS : 17.0;
+    const double unix_s = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+    // the GPS epoch is 6 January 1980
+    return std::fmod(unix_s - 315964800.0 + leap_s, 604800.0);
+}
+}
+
+
+double Gnss_Satellite_Prediction::doppler_hz(const std::string & signal_str) const
+{
+    double carrier_hz = GPS_L1_FREQ_HZ;  // also Galileo E1
+    if (signal_str.compare("2S") == 0)
+        {
+            carrier_hz = GPS_L2_FREQ_HZ;
+        }
+    else if (signal_str.compare("5X") == 0)
+        {
+            carrier_hz = Galileo_E5a_FREQ_HZ;
+        }
+    return - range_rate_m_s * carrier_hz / GPS_C_m_s;
+}
+
+
+Gnss_Satellite_Scheduler::Gnss_Satellite_Scheduler(bool enabled, double elevation_mask_deg, double update_period_s) :
+        d_enabled(enabled), d_elevation_mask_deg(elevation_mask_deg), d_update_period_s(update_period_s),
+        d_nav_version(0), d_position_version(0)
+{}
+
+
+void Gnss_Satellite_Scheduler::update()
+{
+    if (!d_enabled)
+        {
+            return;
+        }
+    Gnss_Nav_Data_Store & store = Gnss_Nav_Data_Store::instance();
+    const Gnss_Rx_Position position = store.rx_position();
+    if (position.version == 0)
+        {
+            return;
+        }
+    const double age_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - d_predicted_at).count();
+    if (store.version() == d_nav_version && position.version == d_position_version && age_s < d_update_period_s)
+        {
+            return;
+        }
+    std::shared_ptr<const Gnss_Nav_Data> nav = store.snapshot();
+    predict(*nav, position, gps_tow_now(position, *nav));
+    d_nav_version = nav->version;
+    d_position_version = position.version;
+}
+
+
+unsigned int Gnss_Satellite_Scheduler::predict(const Gnss_Nav_Data & nav, const Gnss_Rx_Position & position, double gps_tow_s)
+{
+    d_predictions.clear();
+    d_predicted_at = std::chrono::steady_clock::now();
+    const double lat_rad = position.latitude_d * GPS_PI / 180.0;
+    const double lon_rad = position.longitude_d * GPS_PI / 180.0;
+    double rx[3];
+    geodetic_to_ecef(lat_rad, lon_rad, position.height_m, rx);
+
+    Gnss_Satellite_Prediction prediction;
+    for (std::map<int,Gps_Ephemeris>::const_iterator it = nav.gps_ephemeris_map.begin(); it != nav.gps_ephemeris_map.end(); ++it)
+        {
+            if (predict_satellite(it->second, it->second.d_Toe, gps_tow_s, lat_rad, lon_rad, rx, prediction))
+                {
+                    d_predictions[std::make_pair(std::string("G"), static_cast<unsigned int>(it->first))] = prediction;
+                }
+        }
+    for (std::map<int,Galileo_Ephemeris>::const_iterator it = nav.galileo_ephemeris_map.begin(); it != nav.galileo_ephemeris_map.end(); ++it)
+        {
+            if (predict_satellite(it->second, it->second.t0e_1, gps_tow_s, lat_rad, lon_rad, rx, prediction))
+                {
+                    d_predictions[std::make_pair(std::string("E"), static_cast<unsigned int>(it->first))] = prediction;
+                }
+        }
+    DLOG(INFO) << d_predictions.size() << " satellites predicted at TOW " << gps_tow_s
+               << " from Lat = " << position.latitude_d << " [deg], Long = " << position.longitude_d << " [deg]";
+    return d_predictions.size();
+}
+
+
+bool Gnss_Satellite_Scheduler::prediction(const Gnss_Signal & signal, Gnss_Satellite_Prediction & prediction) const
+{
+    std::map<std::pair<std::string, unsigned int>, Gnss_Satellite_Prediction>::const_iterator it =
+            d_predictions.find(std::make_pair(signal.get_satellite().get_system_short(), signal.get_satellite().get_PRN()));
+    if (it == d_predictions.end())
+        {
+            return false;
+        }
+    prediction = it->second;
+    return true;
+}
+
+
+bool Gnss_Satellite_Scheduler::may_be_in_view(const Gnss_Signal & signal) const
+{
+    Gnss_Satellite_Prediction predicted;
+    return !prediction(signal, predicted) || predicted.elevation_d >= d_elevation_mask_deg;
+}
+
+
+bool Gnss_Satellite_Scheduler::next_signal(std::list<Gnss_Signal> & signals, const std::string & signal_str, Gnss_Signal & signal)
+{
+    update();
+
+    // first the satellites in view, highest first, then the ones without
+    // prediction, in the order of the list, and then the ones below the mask
+    std::list<Gnss_Signal>::iterator best = signals.end();
+    int best_rank = 0;
+    double best_elevation_d = 0.0;
+    for (std::list<Gnss_Signal>::iterator it = signals.begin(); it != signals.end(); ++it)
+        {
+            if (it->get_signal_str().compare(signal_str) != 0)
+                {
+                    continue;
+                }
+            int rank = 1;
+            double elevation_d = 0.0;
+            Gnss_Satellite_Prediction predicted;
+            if (prediction(*it, predicted))
+                {
+                    elevation_d = predicted.elevation_d;
+                    rank = (elevation_d >= d_elevation_mask_deg) ? 0 : 2;
+                }
+            if (best == signals.end() || rank < best_rank || (rank == best_rank && rank != 1 && elevation_d > best_elevation_d))
+                {
+                    best = it;
+                    best_rank = rank;
+                    best_elevation_d = elevation_d;
+                }
+        }
+    if (best == signals.end())
+        {
+            return false;
+        }
+    signal = *best;
+    signals.erase(best);
+    return true;
+}
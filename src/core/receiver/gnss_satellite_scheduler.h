@@ -0,0 +1,113 @@
+/*!
+ * \file gnss_satellite_scheduler.h
+ * \brief Orders the satellites to acquire by their predicted elevation
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Once the receiver knows its position (from the PVT, or from the SUPL
+ * reference location) and the ephemeris of some satellites (from the
+ * telemetry or the SUPL assistance), the satellites are predicted: the
+ * channels then acquire first the ones in view, highest first, and the
+ * ones below the elevation mask last. The predicted Doppler shift narrows
+ * the search of the assisted acquisition.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SATELLITE_SCHEDULER_H_
+#define GNSS_SDR_GNSS_SATELLITE_SCHEDULER_H_
+
+#include <chrono>
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+#include "gnss_nav_data_store.h"
+#include "gnss_signal.h"
+
+/*!
+ * \brief Predicted line of sight of a satellite from the receiver
+ */
+class Gnss_Satellite_Prediction
+{
+public:
+    double elevation_d;     //!< Elevation over the horizon [deg]
+    double azimuth_d;       //!< Azimuth, clockwise from the North [deg]
+    double range_rate_m_s;  //!< Rate of change of the distance to the receiver [m/s]
+
+    //! Predicted Doppler shift of the carrier of \p signal_str ("1C", "2S", "1B" or "5X") [Hz]
+    double doppler_hz(const std::string & signal_str) const;
+};
+
+
+class Gnss_Satellite_Scheduler
+{
+public:
+    /*!
+     * \brief Makes a scheduler. If it is not \p enabled, or until there
+     * are predictions, signals are taken in the order of the list.
+     */
+    Gnss_Satellite_Scheduler(bool enabled, double elevation_mask_deg, double update_period_s);
+
+    /*!
+     * \brief Takes out of \p signals the next one with signal string
+     * \p signal_str to be acquired, into \p signal. The predictions are
+     * updated first from Gnss_Nav_Data_Store if it has changed, or if they are
+     * older than the update period. Returns false if there is no such signal.
+     */
+    bool next_signal(std::list<Gnss_Signal> & signals, const std::string & signal_str, Gnss_Signal & signal);
+
+    //! Prediction of the satellite of \p signal, if there is one
+    bool prediction(const Gnss_Signal & signal, Gnss_Satellite_Prediction & prediction) const;
+
+    //! False only for a satellite predicted below the elevation mask
+    bool may_be_in_view(const Gnss_Signal & signal) const;
+
+    /*!
+     * \brief Predicts the satellites with ephemeris in \p nav, seen from
+     * \p position at the GPS time of week \p gps_tow_s, replacing the
+     * previous predictions. Returns the number of predicted satellites.
+     */
+    unsigned int predict(const Gnss_Nav_Data & nav, const Gnss_Rx_Position & position, double gps_tow_s);
+
+    double elevation_mask_deg() const
+    {
+        return d_elevation_mask_deg;
+    }
+
+private:
+    void update();
+
+    bool d_enabled;
+    double d_elevation_mask_deg;
+    double d_update_period_s;
+
+    // by ("G" or "E", PRN)
+    std::map<std::pair<std::string, unsigned int>, Gnss_Satellite_Prediction> d_predictions;
+    unsigned long long d_nav_version;       // of the data of the predictions
+    unsigned long long d_position_version;
+    std::chrono::steady_clock::time_point d_predicted_at;
+};
+
+#endif
@@ -0,0 +1,201 @@
+/*!
+ * \file gnss_sdr_receiver.cc
+ * \brief Receiver that processes one capture after the other in the same
+ * process, for applications that embed GNSS-SDR
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_receiver.h"
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <sstream>
+#include <boost/exception/diagnostic_information.hpp>
+#include <boost/filesystem.hpp>
+#include <glog/logging.h>
+#include "configuration_interface.h"
+#include "control_thread.h"
+#include "file_configuration.h"
+#include "gnss_nav_data_store.h"
+#include "in_memory_configuration.h"
+#include "memory_signal_buffers.h"
+
+using google::LogMessage;
+
+namespace
+{
+// The properties of a job over those of the receiver, so that nothing
+// of a job is left for the next one
+class Job_Configuration : public ConfigurationInterface
+{
+public:
+    Job_Configuration(std::shared_ptr<ConfigurationInterface> configuration)
+        : configuration_(configuration), job_(new InMemoryConfiguration())
+    {}
+    std::string property(std::string property_name, std::string default_value)
+    {
+        return job_->is_present(property_name) ? job_->property(property_name, default_value) : configuration_->property(property_name, default_value);
+    }
+    bool property(std::string property_name, bool default_value)
+    {
+        return job_->is_present(property_name) ? job_->property(property_name, default_value) : configuration_->property(property_name, default_value);
+    }
+    long property(std::string property_name, long default_value)
+    {
+        return job_->is_present(property_name) ? job_->property(property_name, default_value) : configuration_->property(property_name, default_value);
+    }
+    int property(std::string property_name, int default_value)
+    {
+        return job_->is_present(property_name) ? job_->property(property_name, default_value) : configuration_->property(property_name, default_value);
+    }
+    unsigned int property(std::string property_name, unsigned int default_value)
+    {
+        return job_->is_present(property_name) ? job_->property(property_name, default_value) : configuration_->property(property_name, default_value);
+    }
+    unsigned short property(std::string property_name, unsigned short default_value)
+    {
+        return job_->is_present(property_name) ? job_->property(property_name, default_value) : configuration_->property(property_name, default_value);
+    }
+    float property(std::string property_name, float default_value)
+    {
+        return job_->is_present(property_name) ? job_->property(property_name, default_value) : configuration_->property(property_name, default_value);
+    }
+    double property(std::string property_name, double default_value)
+    {
+        return job_->is_present(property_name) ? job_->property(property_name, default_value) : configuration_->property(property_name, default_value);
+    }
+    void set_property(std::string property_name, std::string value)
+    {
+        job_->set_property(property_name, value);
+    }
+
+private:
+    std::shared_ptr<ConfigurationInterface> configuration_;
+    std::unique_ptr<InMemoryConfiguration> job_;
+};
+
+std::mutex & job_mutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+}
+
+
+GnssSdrReceiver::GnssSdrReceiver(const std::string & config_file)
+    : GnssSdrReceiver(std::make_shared<FileConfiguration>(config_file))
+{}
+
+
+GnssSdrReceiver::GnssSdrReceiver(std::shared_ptr<ConfigurationInterface> configuration)
+{
+    configuration_ = configuration;
+    jobs_ = 0;
+    last_job_s_ = 0.0;
+}
+
+
+GnssSdrReceiver::~GnssSdrReceiver()
+{}
+
+
+void GnssSdrReceiver::set_property(const std::string & name, const std::string & value)
+{
+    configuration_->set_property(name, value);
+}
+
+
+void GnssSdrReceiver::clear_navigation_data()
+{
+    std::lock_guard<std::mutex> lock(job_mutex());
+    Gnss_Nav_Data_Store::instance().clear();
+}
+
+
+bool GnssSdrReceiver::process_file(const std::string & filename)
+{
+    // the file signal sources end the process when they cannot read the file
+    boost::system::error_code ec;
+    if (!boost::filesystem::is_regular_file(filename, ec))
+        {
+            LOG(WARNING) << "The capture file " << filename << " does not exist";
+            return false;
+        }
+    std::shared_ptr<ConfigurationInterface> job = std::make_shared<Job_Configuration>(configuration_);
+    job->set_property("SignalSource.filename", filename);
+    job->set_property("SignalSource.repeat", "false");
+    return run(job);
+}
+
+
+bool GnssSdrReceiver::process_buffer(const void * samples, size_t bytes)
+{
+    std::ostringstream name;
+    name << "GnssSdrReceiver_" << static_cast<const void *>(this);
+    std::shared_ptr<ConfigurationInterface> job = std::make_shared<Job_Configuration>(configuration_);
+    job->set_property("SignalSource.implementation", "Memory_Signal_Source");
+    job->set_property("SignalSource.buffer", name.str());
+    job->set_property("SignalSource.repeat", "false");
+    Memory_Signal_Buffers::add(name.str(), samples, bytes);
+    const bool processed = run(job);
+    Memory_Signal_Buffers::remove(name.str());
+    return processed;
+}
+
+
+bool GnssSdrReceiver::run(std::shared_ptr<ConfigurationInterface> job)
+{
+    std::lock_guard<std::mutex> lock(job_mutex());
+    job->set_property("GNSS-SDR.keyboard_listener", "false");
+    if (jobs_ > 0)
+        {
+            // the kernels were selected by the first job
+            job->set_property("GNSS-SDR.volk_calibration", "false");
+        }
+    jobs_++;
+
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    bool processed = true;
+    try
+    {
+            ControlThread control_thread(job);
+            control_thread.run();
+    }
+    catch(boost::exception & e)
+    {
+            LOG(ERROR) << "Job " << jobs_ << ": Boost exception: " << boost::diagnostic_information(e);
+            processed = false;
+    }
+    catch(std::exception const & ex)
+    {
+            LOG(ERROR) << "Job " << jobs_ << ": STD exception: " << ex.what();
+            processed = false;
+    }
+    last_job_s_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    DLOG(INFO) << "Job " << jobs_ << " processed in " << last_job_s_ << " [s]";
+    return processed;
+}
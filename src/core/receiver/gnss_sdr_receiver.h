@@ -0,0 +1,104 @@
+/*!
+ * \file gnss_sdr_receiver.h
+ * \brief Receiver that processes one capture after the other in the same
+ * process, for applications that embed GNSS-SDR
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SDR_RECEIVER_H_
+#define GNSS_SDR_GNSS_SDR_RECEIVER_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+class ConfigurationInterface;
+
+/*!
+ * \brief Runs the receiver of a configuration on a sequence of jobs, each
+ * one a capture file or a buffer of samples.
+ *
+ * The configuration is read once. Each job builds and runs a flowgraph
+ * as ControlThread does, until its samples end, and finds the local codes,
+ * FFT plans and kernel selections made by the previous jobs of the process.
+ * The navigation data of a job are kept for the next ones, as a hot start,
+ * unless clear_navigation_data() is called.
+ *
+ * The jobs of all the receivers of a process run one at a time, since the
+ * blocks share process-wide state (see MultiReceiver to run receivers at
+ * the same time). The outputs go where the configuration says, which
+ * set_property() can change between jobs.
+ */
+class GnssSdrReceiver
+{
+public:
+    GnssSdrReceiver(const std::string & config_file);
+
+    GnssSdrReceiver(std::shared_ptr<ConfigurationInterface> configuration);
+
+    ~GnssSdrReceiver();
+
+    //! Sets a property of the configuration for the next jobs
+    void set_property(const std::string & name, const std::string & value);
+
+    /*!
+     * \brief Processes a capture file with the SignalSource of the
+     * configuration, which must be a file signal source. Returns false if
+     * the file does not exist or the receiver failed.
+     */
+    bool process_file(const std::string & filename);
+
+    /*!
+     * \brief Processes \p bytes bytes of samples of the SignalSource.item_type
+     * and SignalSource.sampling_frequency of the configuration, with a
+     * Memory_Signal_Source. The samples are not copied.
+     */
+    bool process_buffer(const void * samples, size_t bytes);
+
+    //! Forgets the ephemeris and the other navigation data of the previous jobs
+    void clear_navigation_data();
+
+    unsigned int jobs() const
+    {
+        return jobs_;
+    }
+
+    //! Wall time of the last job [s]
+    double last_job_s() const
+    {
+        return last_job_s_;
+    }
+
+private:
+    bool run(std::shared_ptr<ConfigurationInterface> job);
+
+    std::shared_ptr<ConfigurationInterface> configuration_;
+    unsigned int jobs_;
+    double last_job_s_;
+};
+
+#endif
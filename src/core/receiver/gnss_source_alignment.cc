@@ -0,0 +1,62 @@
+/*!
+ * \file gnss_source_alignment.cc
+ * \brief Alignment of the signal sources of a receiver to a common start
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include "gnss_source_alignment.h"
+#include <cmath>
+
+
+std::vector<Gnss_Source_Skip> gnss_source_alignment(const std::vector<Gnss_Source_Start> & sources)
+{
+    std::vector<Gnss_Source_Skip> skips(sources.size());
+    double common_start_s = 0.0;
+    bool started = false;
+    for (unsigned int i = 0; i < sources.size(); i++)
+        {
+            if (sources[i].sampling_frequency_hz <= 0.0) continue;
+            if (!started || sources[i].start_time_s > common_start_s)
+                {
+                    common_start_s = sources[i].start_time_s;
+                    started = true;
+                }
+        }
+    for (unsigned int i = 0; i < sources.size(); i++)
+        {
+            skips[i].samples = 0;
+            skips[i].residual_s = 0.0;
+            const double fs = sources[i].sampling_frequency_hz;
+            if (fs <= 0.0) continue;
+            const double ahead_s = common_start_s - sources[i].start_time_s;
+            const double samples = std::round(ahead_s * fs);
+            skips[i].samples = static_cast<unsigned long long>(samples);
+            skips[i].residual_s = samples / fs - ahead_s;
+        }
+    return skips;
+}
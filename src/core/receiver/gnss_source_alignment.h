@@ -0,0 +1,58 @@
+/*!
+ * \file gnss_source_alignment.h
+ * \brief Alignment of the signal sources of a receiver to a common start
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_SOURCE_ALIGNMENT_H_
+#define GNSS_SDR_GNSS_SOURCE_ALIGNMENT_H_
+
+#include <vector>
+
+//! A signal source, with the time of its first sample on the common clock
+struct Gnss_Source_Start
+{
+    double sampling_frequency_hz;
+    double start_time_s;   // e.g. from the time stamps of the front-end or of the capture [s]
+};
+
+//! Samples to drop from the start of a source
+struct Gnss_Source_Skip
+{
+    unsigned long long samples;
+    double residual_s;     // first kept sample minus the common start, within half a sample [s]
+};
+
+/*!
+ * \brief Drops from each source the samples taken before the latest start,
+ * so that the sample counters of all of them, over their sampling rates,
+ * measure the time since the same instant. The sources without a sampling
+ * rate keep all their samples.
+ */
+std::vector<Gnss_Source_Skip> gnss_source_alignment(const std::vector<Gnss_Source_Start> & sources);
+
+#endif /*GNSS_SDR_GNSS_SOURCE_ALIGNMENT_H_*/
@@ -0,0 +1,182 @@
+/*!
+ * \file multi_receiver.cc
+ * \brief Runs several independent receivers in the same process.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "multi_receiver.h"
+#include <iostream>
+#include <boost/bind.hpp>
+#include <boost/chrono.hpp>
+#include <boost/exception/diagnostic_information.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include "control_thread.h"
+#include "file_configuration.h"
+#include "gnss_nav_data_store.h"
+#include "gnss_sdr_volk_calibration.h"
+#include "namespaced_configuration.h"
+
+using google::LogMessage;
+
+DECLARE_string(config_file);
+
+
+MultiReceiver::MultiReceiver()
+    : MultiReceiver(std::make_shared<FileConfiguration>(FLAGS_config_file))
+{}
+
+
+MultiReceiver::MultiReceiver(std::shared_ptr<ConfigurationInterface> configuration)
+{
+    configuration_ = configuration;
+    receivers_ = configuration_->property("GNSS-SDR.receivers", 1u);
+    stop_ = false;
+}
+
+
+MultiReceiver::~MultiReceiver()
+{}
+
+
+std::string MultiReceiver::name_space(unsigned int index)
+{
+    return "Receiver" + boost::lexical_cast<std::string>(index);
+}
+
+
+std::shared_ptr<NamespacedConfiguration> MultiReceiver::receiver_configuration(unsigned int index)
+{
+    std::shared_ptr<NamespacedConfiguration> configuration = std::make_shared<NamespacedConfiguration>(configuration_, name_space(index));
+    configuration->set_property("GNSS-SDR.receiver_index", boost::lexical_cast<std::string>(index));
+    configuration->set_property("GNSS-SDR.rf_channel_offset", boost::lexical_cast<std::string>(index * rf_channels_per_receiver));
+
+    // the ephemerides of a satellite are the same for all the receivers, and
+    // they are kept from the first one that decodes them
+    configuration->set_property("GNSS-SDR.shared_navigation_data", "true");
+    // the host reads the keys and calibrates the kernels for all of them
+    configuration->set_property("GNSS-SDR.keyboard_listener", "false");
+    configuration->set_property("GNSS-SDR.volk_calibration", "false");
+
+    // the tracked Doppler shifts are process-wide, and depend on the antenna
+    if (configuration->property("GNSS-SDR.cross_band_aiding", false))
+        {
+            LOG(WARNING) << name_space(index) << ": GNSS-SDR.cross_band_aiding is not available with several receivers";
+            configuration->set_property("GNSS-SDR.cross_band_aiding", "false");
+        }
+    // and so is the acquisition assistance, which all of them take from the shared section
+    configuration->set_property("GNSS-SDR.acquisition_assistance",
+            configuration_->property("GNSS-SDR.acquisition_assistance", false) ? "true" : "false");
+    return configuration;
+}
+
+
+void MultiReceiver::run_receiver(unsigned int index)
+{
+    try
+    {
+            control_threads_.at(index)->run();
+    }
+    catch(boost::exception & e)
+    {
+            LOG(ERROR) << name_space(index) << ": Boost exception: " << boost::diagnostic_information(e);
+    }
+    catch(std::exception const & ex)
+    {
+            LOG(ERROR) << name_space(index) << ": STD exception: " << ex.what();
+    }
+    std::cout << name_space(index) << " stopped" << std::endl;
+}
+
+
+void MultiReceiver::keyboard_listener()
+{
+    char c = '0';
+    while (!stop_)
+        {
+            if (!std::cin.get(c)) break;
+            if (c == 'q')
+                {
+                    std::cout << "Quit keystroke order received, stopping all the receivers !!" << std::endl;
+                    for (unsigned int i = 0; i < control_threads_.size(); i++)
+                        {
+                            control_threads_.at(i)->request_stop();
+                        }
+                    break;
+                }
+        }
+}
+
+
+bool MultiReceiver::run()
+{
+    // one selection of the kernels for the whole process, with the signals of the first receiver
+    Gnss_Sdr_Volk_Calibration::run(std::make_shared<NamespacedConfiguration>(configuration_, name_space(0)));
+
+    // and one start without the navigation data of a previous run
+    Gnss_Nav_Data_Store::instance().clear();
+
+    // the flowgraphs are created one after the other, so the receivers
+    // that come after the first one find the codes and plans already made
+    control_threads_.clear();
+    for (unsigned int i = 0; i < receivers_; i++)
+        {
+            try
+            {
+                    control_threads_.push_back(std::make_shared<ControlThread>(receiver_configuration(i)));
+            }
+            catch(std::exception const & ex)
+            {
+                    LOG(ERROR) << "Unable to create " << name_space(i) << ": " << ex.what();
+                    std::cout << "Unable to create " << name_space(i) << ": " << ex.what() << std::endl;
+                    control_threads_.clear();
+                    return false;
+            }
+        }
+    std::cout << "Running " << receivers_ << " receivers" << std::endl;
+
+    stop_ = false;
+    boost::thread keyboard_thread(&MultiReceiver::keyboard_listener, this);
+    boost::thread_group threads;
+    for (unsigned int i = 0; i < receivers_; i++)
+        {
+            threads.create_thread(boost::bind(&MultiReceiver::run_receiver, this, i));
+        }
+    threads.join_all();
+    stop_ = true;
+
+    // the listener may still be waiting for a key
+#ifdef OLD_BOOST
+    keyboard_thread.timed_join(boost::posix_time::seconds(1));
+#endif
+#ifndef OLD_BOOST
+    keyboard_thread.try_join_until(boost::chrono::steady_clock::now() + boost::chrono::milliseconds(1000));
+#endif
+    return true;
+}
@@ -0,0 +1,101 @@
+/*!
+ * \file multi_receiver.h
+ * \brief Runs several independent receivers in the same process.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * With GNSS-SDR.receivers=N in the configuration file, the process hosts N
+ * receivers, each one with its own flowgraph and ControlThread, that read
+ * their properties in the namespaces Receiver0 ... Receiver<N-1> (see
+ * NamespacedConfiguration). They share everything that is process-wide:
+ * the code bank, the FFT plans and codes of the acquisitions, the Doppler
+ * grids, the OpenCL programs, the selection of the VOLK_GNSSSDR kernels,
+ * which is calibrated once, and the navigation data of the satellites.
+ * The stores keyed by RF channel (sample rings, shared input spectra, CUDA
+ * services) and the tracking groups get different keys for each receiver.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_MULTI_RECEIVER_H_
+#define GNSS_SDR_MULTI_RECEIVER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class ConfigurationInterface;
+class ControlThread;
+class NamespacedConfiguration;
+
+class MultiReceiver
+{
+public:
+    //! Spacing of the RF channel keys of the receivers in the process-wide stores
+    static const unsigned int rf_channels_per_receiver = 64;
+
+    //! Takes the configuration file of the --config_file flag
+    MultiReceiver();
+
+    MultiReceiver(std::shared_ptr<ConfigurationInterface> configuration);
+
+    ~MultiReceiver();
+
+    //! True when GNSS-SDR.receivers asks for more than one receiver
+    bool enabled() const
+    {
+        return receivers_ > 1;
+    }
+
+    unsigned int receivers() const
+    {
+        return receivers_;
+    }
+
+    //! Namespace of the properties of the receiver \p index
+    static std::string name_space(unsigned int index);
+
+    /*!
+     * \brief Configuration of the receiver \p index, with the properties
+     * that keep it apart from the other receivers of the process.
+     */
+    std::shared_ptr<NamespacedConfiguration> receiver_configuration(unsigned int index);
+
+    /*!
+     * \brief Runs all the receivers until they stop, by themselves or with
+     * the 'q' keystroke. Returns false if a receiver could not be created.
+     */
+    bool run();
+
+private:
+    void run_receiver(unsigned int index);
+    void keyboard_listener();
+
+    std::shared_ptr<ConfigurationInterface> configuration_;
+    unsigned int receivers_;
+    std::vector<std::shared_ptr<ControlThread>> control_threads_;
+    bool stop_;
+};
+
+#endif
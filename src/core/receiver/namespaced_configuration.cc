@@ -0,0 +1,116 @@
+/*!
+ * \file namespaced_configuration.cc
+ * \brief Configuration of one of the receivers hosted by MultiReceiver:
+ *  the properties of its namespace override the shared ones.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "namespaced_configuration.h"
+
+namespace
+{
+// returned by the shared configuration for the properties that are not there
+const std::string not_present("\x01not present\x01");
+}
+
+
+NamespacedConfiguration::NamespacedConfiguration(std::shared_ptr<ConfigurationInterface> configuration,
+        const std::string& name_space)
+{
+    configuration_ = configuration;
+    name_space_ = name_space;
+    prefix_ = name_space + ".";
+}
+
+
+NamespacedConfiguration::~NamespacedConfiguration()
+{}
+
+
+std::string NamespacedConfiguration::resolve(const std::string& property_name)
+{
+    const std::string name = prefix_ + property_name;
+    if (configuration_->property(name, not_present) != not_present)
+        {
+            return name;
+        }
+    return property_name;
+}
+
+
+std::string NamespacedConfiguration::property(std::string property_name, std::string default_value)
+{
+    return configuration_->property(resolve(property_name), default_value);
+}
+
+
+bool NamespacedConfiguration::property(std::string property_name, bool default_value)
+{
+    return configuration_->property(resolve(property_name), default_value);
+}
+
+
+long NamespacedConfiguration::property(std::string property_name, long default_value)
+{
+    return configuration_->property(resolve(property_name), default_value);
+}
+
+
+int NamespacedConfiguration::property(std::string property_name, int default_value)
+{
+    return configuration_->property(resolve(property_name), default_value);
+}
+
+
+unsigned int NamespacedConfiguration::property(std::string property_name, unsigned int default_value)
+{
+    return configuration_->property(resolve(property_name), default_value);
+}
+
+
+unsigned short NamespacedConfiguration::property(std::string property_name, unsigned short default_value)
+{
+    return configuration_->property(resolve(property_name), default_value);
+}
+
+
+float NamespacedConfiguration::property(std::string property_name, float default_value)
+{
+    return configuration_->property(resolve(property_name), default_value);
+}
+
+
+double NamespacedConfiguration::property(std::string property_name, double default_value)
+{
+    return configuration_->property(resolve(property_name), default_value);
+}
+
+
+void NamespacedConfiguration::set_property(std::string property_name, std::string value)
+{
+    configuration_->set_property(prefix_ + property_name, value);
+}
@@ -0,0 +1,73 @@
+/*!
+ * \file namespaced_configuration.h
+ * \brief Configuration of one of the receivers hosted by MultiReceiver:
+ *  the properties of its namespace override the shared ones.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * A property "Name" of the receiver of namespace "Receiver1" is read from
+ * "Receiver1.Name" if that is in the configuration, and from "Name"
+ * otherwise, so that the receivers only list what makes them different.
+ * The properties set through this configuration only go to its namespace.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_NAMESPACED_CONFIGURATION_H_
+#define GNSS_SDR_NAMESPACED_CONFIGURATION_H_
+
+#include <memory>
+#include <string>
+#include "configuration_interface.h"
+
+class NamespacedConfiguration : public ConfigurationInterface
+{
+public:
+    NamespacedConfiguration(std::shared_ptr<ConfigurationInterface> configuration, const std::string& name_space);
+    virtual ~NamespacedConfiguration();
+    std::string property(std::string property_name, std::string default_value);
+    bool property(std::string property_name, bool default_value);
+    long property(std::string property_name, long default_value);
+    int property(std::string property_name, int default_value);
+    unsigned int property(std::string property_name, unsigned int default_value);
+    unsigned short property(std::string property_name, unsigned short default_value);
+    float property(std::string property_name, float default_value);
+    double property(std::string property_name, double default_value);
+    void set_property(std::string property_name, std::string value);
+
+    const std::string& name_space() const
+    {
+        return name_space_;
+    }
+
+private:
+    // the name of the property in the shared configuration
+    std::string resolve(const std::string& property_name);
+
+    std::shared_ptr<ConfigurationInterface> configuration_;
+    std::string name_space_;
+    std::string prefix_;
+};
+
+#endif /*GNSS_SDR_NAMESPACED_CONFIGURATION_H_*/
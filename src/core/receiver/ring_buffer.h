@@ -0,0 +1,188 @@
+/*!
+ * \file ring_buffer.h
+ * \brief Fixed-capacity circular buffer for the per-epoch histories of the
+ *  processing blocks.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * std::deque allocates and frees chunks as elements are pushed and popped,
+ * and spreads the elements over those chunks. The symbol and observable
+ * histories have a known maximum length, so this buffer allocates its
+ * storage once, aligned to a cache line, and then only moves two indices.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_RING_BUFFER_H_
+#define GNSS_SDR_RING_BUFFER_H_
+
+#include <cstdlib>
+#include <new>
+
+#define RING_BUFFER_ALIGNMENT 64
+
+template<typename T>
+
+/*!
+ * \brief This class implements a fixed-capacity circular buffer
+ *
+ * push_back() on a full buffer overwrites the oldest element, so a buffer of
+ * capacity N always holds the last N elements pushed. Element 0 is the
+ * oldest one. The class is not thread-safe.
+ */
+class ring_buffer
+{
+public:
+    explicit ring_buffer(unsigned int capacity = 0) :
+        d_data(0), d_capacity(0), d_mask(0), d_first(0), d_size(0)
+    {
+        set_capacity(capacity);
+    }
+
+    ring_buffer(const ring_buffer& other) :
+        d_data(0), d_capacity(0), d_mask(0), d_first(0), d_size(0)
+    {
+        copy_from(other);
+    }
+
+    ring_buffer& operator=(const ring_buffer& other)
+    {
+        if (this != &other)
+            {
+                copy_from(other);
+            }
+        return *this;
+    }
+
+    ~ring_buffer()
+    {
+        release();
+    }
+
+    //! Allocates room for capacity elements. The buffer is emptied.
+    void set_capacity(unsigned int capacity)
+    {
+        release();
+        d_capacity = capacity;
+        if (capacity == 0) return;
+        // a power of two number of slots turns the index wrap into a mask
+        unsigned int slots = 1;
+        while (slots < capacity)
+            {
+                slots <<= 1;
+            }
+        void* storage = 0;
+        if (posix_memalign(&storage, RING_BUFFER_ALIGNMENT, slots * sizeof(T)) != 0)
+            {
+                throw std::bad_alloc();
+            }
+        d_data = static_cast<T*>(storage);
+        for (unsigned int i = 0; i < slots; i++)
+            {
+                new (d_data + i) T();
+            }
+        d_mask = slots - 1;
+    }
+
+    void push_back(const T& value)
+    {
+        if (d_capacity == 0) return;
+        if (d_size == d_capacity)
+            {
+                d_first = (d_first + 1) & d_mask;
+                d_size--;
+            }
+        d_data[(d_first + d_size) & d_mask] = value;
+        d_size++;
+    }
+
+    void pop_front()
+    {
+        if (d_size == 0) return;
+        d_first = (d_first + 1) & d_mask;
+        d_size--;
+    }
+
+    void clear()
+    {
+        d_first = 0;
+        d_size = 0;
+    }
+
+    T& operator[](unsigned int i) { return d_data[(d_first + i) & d_mask]; }
+    const T& operator[](unsigned int i) const { return d_data[(d_first + i) & d_mask]; }
+    T& front() { return d_data[d_first]; }
+    const T& front() const { return d_data[d_first]; }
+    T& back() { return d_data[(d_first + d_size - 1) & d_mask]; }
+    const T& back() const { return d_data[(d_first + d_size - 1) & d_mask]; }
+
+    unsigned int size() const { return d_size; }
+    unsigned int capacity() const { return d_capacity; }
+    bool empty() const { return d_size == 0; }
+    bool full() const { return d_size == d_capacity; }
+
+    //! Copies the elements, oldest first, to out, which must hold size() elements
+    void copy_to(T* out) const
+    {
+        for (unsigned int i = 0; i < d_size; i++)
+            {
+                out[i] = (*this)[i];
+            }
+    }
+
+private:
+    void release()
+    {
+        if (d_data != 0)
+            {
+                for (unsigned int i = 0; i <= d_mask; i++)
+                    {
+                        d_data[i].~T();
+                    }
+                free(d_data);
+            }
+        d_data = 0;
+        d_capacity = 0;
+        d_mask = 0;
+        d_first = 0;
+        d_size = 0;
+    }
+
+    void copy_from(const ring_buffer& other)
+    {
+        set_capacity(other.d_capacity);
+        for (unsigned int i = 0; i < other.d_size; i++)
+            {
+                push_back(other[i]);
+            }
+    }
+
+    T* d_data;
+    unsigned int d_capacity;
+    unsigned int d_mask;
+    unsigned int d_first;
+    unsigned int d_size;
+};
+
+#endif
@@ -35,6 +35,7 @@
 #include <vector>
 #include <utility> // std::pair
 #include "MATH_CONSTANTS.h"
+#include "gnss_packed_bits.h"
 
 // Physical constants
 const double GPS_C_m_s       = 299792458.0;      //!< The speed of light, [m/s]
@@ -90,153 +91,153 @@ const int GPS_WORD_BITS = 30;                       //!< Number of bits per word
 
 // SUBFRAME 1-5 (TLM and HOW)
 
-const std::vector<std::pair<int,int> > TOW( { {31,17} } );
-const std::vector<std::pair<int,int> > INTEGRITY_STATUS_FLAG({{23,1}});
-const std::vector<std::pair<int,int> > ALERT_FLAG({{48,1}});
-const std::vector<std::pair<int,int> > ANTI_SPOOFING_FLAG({{49,1}});
-const std::vector<std::pair<int,int> > SUBFRAME_ID({{50,3}});
+constexpr Gnss_Bit_Field TOW = {{ {31,17} }};
+constexpr Gnss_Bit_Field INTEGRITY_STATUS_FLAG = {{ {23,1} }};
+constexpr Gnss_Bit_Field ALERT_FLAG = {{ {48,1} }};
+constexpr Gnss_Bit_Field ANTI_SPOOFING_FLAG = {{ {49,1} }};
+constexpr Gnss_Bit_Field SUBFRAME_ID = {{ {50,3} }};
 
 // SUBFRAME 1
-const std::vector<std::pair<int,int>> GPS_WEEK({{61,10}});
-const std::vector<std::pair<int,int>> CA_OR_P_ON_L2({{71,2}}); //*
-const std::vector<std::pair<int,int>> SV_ACCURACY({{73,4}});
-const std::vector<std::pair<int,int>> SV_HEALTH ({{77,6}});
-const std::vector<std::pair<int,int>> L2_P_DATA_FLAG ({{91,1}});
-const std::vector<std::pair<int,int>> T_GD({{197,8}});
+constexpr Gnss_Bit_Field GPS_WEEK = {{ {61,10} }};
+constexpr Gnss_Bit_Field CA_OR_P_ON_L2 = {{ {71,2} }}; //*
+constexpr Gnss_Bit_Field SV_ACCURACY = {{ {73,4} }};
+constexpr Gnss_Bit_Field SV_HEALTH = {{ {77,6} }};
+constexpr Gnss_Bit_Field L2_P_DATA_FLAG = {{ {91,1} }};
+constexpr Gnss_Bit_Field T_GD = {{ {197,8} }};
 const double T_GD_LSB = TWO_N31;
-const std::vector<std::pair<int,int>> IODC({{83,2},{211,8}});
-const std::vector<std::pair<int,int>> T_OC({{219,16}});
+constexpr Gnss_Bit_Field IODC = {{ {83,2}, {211,8} }};
+constexpr Gnss_Bit_Field T_OC = {{ {219,16} }};
 const double T_OC_LSB = TWO_P4;
-const std::vector<std::pair<int,int>> A_F2({{241,8}});
+constexpr Gnss_Bit_Field A_F2 = {{ {241,8} }};
 const double A_F2_LSB = TWO_N55;
-const std::vector<std::pair<int,int>> A_F1({{249,16}});
+constexpr Gnss_Bit_Field A_F1 = {{ {249,16} }};
 const double A_F1_LSB = TWO_N43;
-const std::vector<std::pair<int,int>> A_F0({{271,22}});
+constexpr Gnss_Bit_Field A_F0 = {{ {271,22} }};
 const double A_F0_LSB = TWO_N31;
 
 // SUBFRAME 2
-const std::vector<std::pair<int,int>> IODE_SF2({{61,8}});
-const std::vector<std::pair<int,int>> C_RS({{69,16}});
+constexpr Gnss_Bit_Field IODE_SF2 = {{ {61,8} }};
+constexpr Gnss_Bit_Field C_RS = {{ {69,16} }};
 const double C_RS_LSB = TWO_N5;
-const std::vector<std::pair<int,int>> DELTA_N({{91,16}});
+constexpr Gnss_Bit_Field DELTA_N = {{ {91,16} }};
 const double DELTA_N_LSB = PI_TWO_N43;
-const std::vector<std::pair<int,int>> M_0({{107,8},{121,24}});
+constexpr Gnss_Bit_Field M_0 = {{ {107,8}, {121,24} }};
 const double M_0_LSB = PI_TWO_N31;
-const std::vector<std::pair<int,int>> C_UC({{151,16}});
+constexpr Gnss_Bit_Field C_UC = {{ {151,16} }};
 const double C_UC_LSB = TWO_N29;
-const std::vector<std::pair<int,int>> E({{167,8},{181,24}});
+constexpr Gnss_Bit_Field E = {{ {167,8}, {181,24} }};
 const double E_LSB = TWO_N33;
-const std::vector<std::pair<int,int>> C_US({{211,16}});
+constexpr Gnss_Bit_Field C_US = {{ {211,16} }};
 const double C_US_LSB = TWO_N29;
-const std::vector<std::pair<int,int>> SQRT_A({{227,8},{241,24}});
+constexpr Gnss_Bit_Field SQRT_A = {{ {227,8}, {241,24} }};
 const double SQRT_A_LSB = TWO_N19;
-const std::vector<std::pair<int,int>> T_OE({{271,16}});
+constexpr Gnss_Bit_Field T_OE = {{ {271,16} }};
 const double T_OE_LSB = TWO_P4;
-const std::vector<std::pair<int,int>> FIT_INTERVAL_FLAG({{271,1}});
-const std::vector<std::pair<int,int>> AODO({{272,5}});
+constexpr Gnss_Bit_Field FIT_INTERVAL_FLAG = {{ {271,1} }};
+constexpr Gnss_Bit_Field AODO = {{ {272,5} }};
 const int AODO_LSB = 900;
 
 // SUBFRAME 3
-const std::vector<std::pair<int,int>> C_IC({{61,16}});
+constexpr Gnss_Bit_Field C_IC = {{ {61,16} }};
 const double C_IC_LSB = TWO_N29;
-const std::vector<std::pair<int,int>> OMEGA_0({{77,8},{91,24}});
+constexpr Gnss_Bit_Field OMEGA_0 = {{ {77,8}, {91,24} }};
 const double OMEGA_0_LSB = PI_TWO_N31;
-const std::vector<std::pair<int,int>> C_IS({{121,16}});
+constexpr Gnss_Bit_Field C_IS = {{ {121,16} }};
 const double C_IS_LSB = TWO_N29;
-const std::vector<std::pair<int,int>> I_0({{137,8},{151,24}});
+constexpr Gnss_Bit_Field I_0 = {{ {137,8}, {151,24} }};
 const double I_0_LSB = PI_TWO_N31;
-const std::vector<std::pair<int,int>> C_RC({{181,16}});
+constexpr Gnss_Bit_Field C_RC = {{ {181,16} }};
 const double C_RC_LSB = TWO_N5;
-const std::vector<std::pair<int,int>> OMEGA({{197,8},{211,24}});
+constexpr Gnss_Bit_Field OMEGA = {{ {197,8}, {211,24} }};
 const double OMEGA_LSB = PI_TWO_N31;
-const std::vector<std::pair<int,int>> OMEGA_DOT({{241,24}});
+constexpr Gnss_Bit_Field OMEGA_DOT = {{ {241,24} }};
 const double OMEGA_DOT_LSB = PI_TWO_N43;
-const std::vector<std::pair<int,int>> IODE_SF3({{271,8}});
-const std::vector<std::pair<int,int>> I_DOT({{279,14}});
+constexpr Gnss_Bit_Field IODE_SF3 = {{ {271,8} }};
+constexpr Gnss_Bit_Field I_DOT = {{ {279,14} }};
 const double I_DOT_LSB = PI_TWO_N43;
 
 
 // SUBFRAME 4-5
-const std::vector<std::pair<int,int>> SV_DATA_ID({{61,2}});
-const std::vector<std::pair<int,int>> SV_PAGE({{63,6}});
+constexpr Gnss_Bit_Field SV_DATA_ID = {{ {61,2} }};
+constexpr Gnss_Bit_Field SV_PAGE = {{ {63,6} }};
 
 // SUBFRAME 4
 //! \todo read all pages of subframe 4
 // Page 18 - Ionospheric and UTC data
-const std::vector<std::pair<int,int>> ALPHA_0({{69,8}});
+constexpr Gnss_Bit_Field ALPHA_0 = {{ {69,8} }};
 const double ALPHA_0_LSB = TWO_N30;
-const std::vector<std::pair<int,int>> ALPHA_1({{77,8}});
+constexpr Gnss_Bit_Field ALPHA_1 = {{ {77,8} }};
 const double ALPHA_1_LSB = TWO_N27;
-const std::vector<std::pair<int,int>> ALPHA_2({{91,8}});
+constexpr Gnss_Bit_Field ALPHA_2 = {{ {91,8} }};
 const double ALPHA_2_LSB = TWO_N24;
-const std::vector<std::pair<int,int>> ALPHA_3({{99,8}});
+constexpr Gnss_Bit_Field ALPHA_3 = {{ {99,8} }};
 const double ALPHA_3_LSB = TWO_N24;
-const std::vector<std::pair<int,int>> BETA_0({{107,8}});
+constexpr Gnss_Bit_Field BETA_0 = {{ {107,8} }};
 const double BETA_0_LSB = TWO_P11;
-const std::vector<std::pair<int,int>> BETA_1({{121,8}});
+constexpr Gnss_Bit_Field BETA_1 = {{ {121,8} }};
 const double BETA_1_LSB = TWO_P14;
-const std::vector<std::pair<int,int>> BETA_2({{129,8}});
+constexpr Gnss_Bit_Field BETA_2 = {{ {129,8} }};
 const double BETA_2_LSB = TWO_P16;
-const std::vector<std::pair<int,int>> BETA_3({{137,8}});
+constexpr Gnss_Bit_Field BETA_3 = {{ {137,8} }};
 const double BETA_3_LSB = TWO_P16;
-const std::vector<std::pair<int,int>> A_1({{151,24}});
+constexpr Gnss_Bit_Field A_1 = {{ {151,24} }};
 const double A_1_LSB = TWO_N50;
-const std::vector<std::pair<int,int>> A_0({{181,24},{211,8}});
+constexpr Gnss_Bit_Field A_0 = {{ {181,24}, {211,8} }};
 const double A_0_LSB = TWO_N30;
-const std::vector<std::pair<int,int>> T_OT({{219,8}});
+constexpr Gnss_Bit_Field T_OT = {{ {219,8} }};
 const double T_OT_LSB = TWO_P12;
-const std::vector<std::pair<int,int>> WN_T({{227,8}});
+constexpr Gnss_Bit_Field WN_T = {{ {227,8} }};
 const double WN_T_LSB = 1;
-const std::vector<std::pair<int,int>> DELTAT_LS({{241,8}});
+constexpr Gnss_Bit_Field DELTAT_LS = {{ {241,8} }};
 const double DELTAT_LS_LSB = 1;
-const std::vector<std::pair<int,int>> WN_LSF({{249,8}});
+constexpr Gnss_Bit_Field WN_LSF = {{ {249,8} }};
 const double WN_LSF_LSB = 1;
-const std::vector<std::pair<int,int>> DN({{257,8}});
+constexpr Gnss_Bit_Field DN = {{ {257,8} }};
 const double DN_LSB = 1;
-const std::vector<std::pair<int,int>> DELTAT_LSF({{271,8}});
+constexpr Gnss_Bit_Field DELTAT_LSF = {{ {271,8} }};
 const double DELTAT_LSF_LSB = 1;
 
 // Page 25 - Antispoofing, SV config and SV health (PRN 25 -32)
-const std::vector<std::pair<int,int>> HEALTH_SV25({{229,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV26({{241,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV27({{247,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV28({{253,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV29({{259,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV30({{271,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV31({{277,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV32({{283,6}});
+constexpr Gnss_Bit_Field HEALTH_SV25 = {{ {229,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV26 = {{ {241,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV27 = {{ {247,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV28 = {{ {253,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV29 = {{ {259,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV30 = {{ {271,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV31 = {{ {277,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV32 = {{ {283,6} }};
 
 
 // SUBFRAME 5
 //! \todo read all pages of subframe 5
 
 // page 25 - Health (PRN 1 - 24)
-const std::vector<std::pair<int,int>> T_OA({{69,8}});
+constexpr Gnss_Bit_Field T_OA = {{ {69,8} }};
 const double T_OA_LSB = TWO_P12;
-const std::vector<std::pair<int,int>> WN_A({{77,8}});
-const std::vector<std::pair<int,int>> HEALTH_SV1({{91,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV2({{97,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV3({{103,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV4({{109,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV5({{121,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV6({{127,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV7({{133,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV8({{139,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV9({{151,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV10({{157,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV11({{163,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV12({{169,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV13({{181,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV14({{187,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV15({{193,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV16({{199,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV17({{211,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV18({{217,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV19({{223,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV20({{229,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV21({{241,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV22({{247,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV23({{253,6}});
-const std::vector<std::pair<int,int>> HEALTH_SV24({{259,6}});
+constexpr Gnss_Bit_Field WN_A = {{ {77,8} }};
+constexpr Gnss_Bit_Field HEALTH_SV1 = {{ {91,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV2 = {{ {97,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV3 = {{ {103,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV4 = {{ {109,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV5 = {{ {121,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV6 = {{ {127,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV7 = {{ {133,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV8 = {{ {139,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV9 = {{ {151,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV10 = {{ {157,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV11 = {{ {163,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV12 = {{ {169,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV13 = {{ {181,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV14 = {{ {187,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV15 = {{ {193,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV16 = {{ {199,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV17 = {{ {211,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV18 = {{ {217,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV19 = {{ {223,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV20 = {{ {229,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV21 = {{ {241,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV22 = {{ {247,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV23 = {{ {253,6} }};
+constexpr Gnss_Bit_Field HEALTH_SV24 = {{ {259,6} }};
 
 #endif /* GNSS_SDR_GPS_L1_CA_H_ */
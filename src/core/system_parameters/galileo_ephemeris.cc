@@ -90,7 +90,7 @@ Galileo_Ephemeris::Galileo_Ephemeris()
 }
 
 
-double Galileo_Ephemeris::Galileo_System_Time(double WN, double TOW)
+double Galileo_Ephemeris::Galileo_System_Time(double WN, double TOW) const
 {
     /* GALIELO SYSTEM TIME, ICD 5.1.2
      * input parameter:
@@ -141,47 +141,23 @@ double Galileo_Ephemeris::sv_clock_drift(double transmitTime)
 double Galileo_Ephemeris::sv_clock_relativistic_term(double transmitTime) // Satellite Time Correction Algorithm, ICD 5.1.4
 {
     double tk;
-    double a;
-    double n;
-    double n0;
     double E;
-    double E_old;
-    double dE;
     double M;
 
-    // Restore semi-major axis
-    a = A_1*A_1;
-
-    n0 = sqrt(GALILEO_GM / (a*a*a));
+    d_orbit.set_parameters(A_1, delta_n_3, e_1, GALILEO_GM);
 
     // Time from ephemeris reference epoch
     //t = WN_5*86400*7 + TOW_5; //WN_5*86400*7 are the second from the origin of the Galileo time
     tk = transmitTime - t0e_1;
 
-    // Corrected mean motion
-    n = n0 + delta_n_3;
-
     // Mean anomaly
-    M = M0_1 + n * tk;
+    M = M0_1 + d_orbit.mean_motion() * tk;
 
     // Reduce mean anomaly to between 0 and 2pi
     M = fmod((M + 2*GALILEO_PI), (2*GALILEO_PI));
 
-    // Initial guess of eccentric anomaly
-    E = M;
-
-    // --- Iteratively compute eccentric anomaly ----------------------------
-    for (int ii = 1; ii < 20; ii++)
-        {
-            E_old   = E;
-            E       = M + e_1 * sin(E);
-            dE      = fmod(E - E_old, 2*GALILEO_PI);
-            if (fabs(dE) < 1e-12)
-                {
-                    //Necessary precision is reached, exit from the loop
-                    break;
-                }
-        }
+    // Eccentric anomaly
+    E = d_orbit.eccentric_anomaly(M);
 
     // Compute relativistic correction term
     Galileo_dtr = GALILEO_F * e_1* A_1 * sin(E);
@@ -195,12 +171,8 @@ void Galileo_Ephemeris::satellitePosition(double transmitTime)
     // when this function in used, the input must be the transmitted time (t) in second computed by Galileo_System_Time (above function)
     double tk;   // Time from ephemeris reference epoch
     double a;    // Semi-major axis
-    double n;    // Corrected mean motion
-    double n0;   // Computed mean motion
     double M;    // Mean anomaly
     double E;    // Eccentric Anomaly (to be solved by iteration)
-    double E_old;
-    double dE;
     double nu;   // True anomaly
     double phi;  // Argument of Latitude
     double u;    // Correct argument of latitude
@@ -210,43 +182,25 @@ void Galileo_Ephemeris::satellitePosition(double transmitTime)
 
     // Find Galileo satellite's position ----------------------------------------------
 
-    // Restore semi-major axis
-    a = A_1*A_1;
-
-    // Computed mean motion
-    n0 = sqrt(GALILEO_GM / (a*a*a));
+    // Semi-major axis and corrected mean motion, computed once per ephemeris set
+    d_orbit.set_parameters(A_1, delta_n_3, e_1, GALILEO_GM);
+    a = d_orbit.semi_major_axis();
 
     // Time from ephemeris reference epoch
     tk = transmitTime - t0e_1;
 
-    // Corrected mean motion
-    n = n0 + delta_n_3;
-
     // Mean anomaly
-    M = M0_1 + n * tk;
+    M = M0_1 + d_orbit.mean_motion() * tk;
 
     // Reduce mean anomaly to between 0 and 2pi
     M = fmod((M + 2* GALILEO_PI), (2* GALILEO_PI));
 
-    // Initial guess of eccentric anomaly
-    E = M;
-
-    // --- Iteratively compute eccentric anomaly ----------------------------
-    for (int ii = 1; ii<20; ii++)
-        {
-            E_old   = E;
-            E       = M + e_1 * sin(E);
-            dE      = fmod(E - E_old, 2*GALILEO_PI);
-            if (fabs(dE) < 1e-12)
-                {
-                    //Necessary precision is reached, exit from the loop
-                    break;
-                }
-        }
+    // Eccentric anomaly, starting from the previous solution
+    E = d_orbit.eccentric_anomaly(M);
 
     // Compute the true anomaly
 
-    double tmp_Y = sqrt(1.0 - e_1 * e_1) * sin(E);
+    double tmp_Y = d_orbit.sqrt_one_minus_e2() * sin(E);
     double tmp_X = cos(E) - e_1;
     nu = atan2(tmp_Y, tmp_X);
 
@@ -256,14 +210,18 @@ void Galileo_Ephemeris::satellitePosition(double transmitTime)
     // Reduce phi to between 0 and 2*pi rad
     phi = fmod((phi), (2*GALILEO_PI));
 
+    // Harmonic corrections
+    const double cos_2phi = cos(2*phi);
+    const double sin_2phi = sin(2*phi);
+
     // Correct argument of latitude
-    u = phi + C_uc_3 * cos(2*phi) +  C_us_3 * sin(2*phi);
+    u = phi + C_uc_3 * cos_2phi +  C_us_3 * sin_2phi;
 
     // Correct radius
-    r = a * (1 - e_1*cos(E)) +  C_rc_3 * cos(2*phi) +  C_rs_3 * sin(2*phi);
+    r = a * (1 - e_1*cos(E)) +  C_rc_3 * cos_2phi +  C_rs_3 * sin_2phi;
 
     // Correct inclination
-    i = i_0_2 + iDot_2 * tk + C_ic_4 * cos(2*phi) + C_is_4 * sin(2*phi);
+    i = i_0_2 + iDot_2 * tk + C_ic_4 * cos_2phi + C_is_4 * sin_2phi;
 
     // Compute the angle between the ascending node and the Greenwich meridian
     Omega = OMEGA_0_2 + (OMEGA_dot_3 - GALILEO_OMEGA_EARTH_DOT)*tk - GALILEO_OMEGA_EARTH_DOT * t0e_1;
@@ -271,15 +229,22 @@ void Galileo_Ephemeris::satellitePosition(double transmitTime)
     // Reduce to between 0 and 2*pi rad
     Omega = fmod((Omega + 2*GALILEO_PI), (2*GALILEO_PI));
 
+    const double cos_u = cos(u);
+    const double sin_u = sin(u);
+    const double cos_i = cos(i);
+    const double sin_i = sin(i);
+    const double cos_Omega = cos(Omega);
+    const double sin_Omega = sin(Omega);
+
     // --- Compute satellite coordinates in Earth-fixed coordinates
-    d_satpos_X = cos(u) * r * cos(Omega) - sin(u) * r * cos(i) * sin(Omega);
-    d_satpos_Y = cos(u) * r * sin(Omega) + sin(u) * r * cos(i) * cos(Omega); // ********NOTE: in GALILEO ICD this expression is not correct because it has minus (- sin(u) * r * cos(i) * cos(Omega)) instead of plus
-    d_satpos_Z = sin(u) * r * sin(i);
+    d_satpos_X = cos_u * r * cos_Omega - sin_u * r * cos_i * sin_Omega;
+    d_satpos_Y = cos_u * r * sin_Omega + sin_u * r * cos_i * cos_Omega; // ********NOTE: in GALILEO ICD this expression is not correct because it has minus (- sin(u) * r * cos(i) * cos(Omega)) instead of plus
+    d_satpos_Z = sin_u * r * sin_i;
 
     // Satellite's velocity. Can be useful for Vector Tracking loops
     double Omega_dot = OMEGA_dot_3 - GALILEO_OMEGA_EARTH_DOT;
-    d_satvel_X = - Omega_dot * (cos(u) * r + sin(u) * r * cos(i)) + d_satpos_X * cos(Omega) - d_satpos_Y * cos(i) * sin(Omega);
-    d_satvel_Y = Omega_dot * (cos(u) * r * cos(Omega) - sin(u) * r * cos(i) * sin(Omega)) + d_satpos_X * sin(Omega) + d_satpos_Y * cos(i) * cos(Omega);
-    d_satvel_Z = d_satpos_Y * sin(i);
+    d_satvel_X = - Omega_dot * (cos_u * r + sin_u * r * cos_i) + d_satpos_X * cos_Omega - d_satpos_Y * cos_i * sin_Omega;
+    d_satvel_Y = Omega_dot * (cos_u * r * cos_Omega - sin_u * r * cos_i * sin_Omega) + d_satpos_X * sin_Omega + d_satpos_Y * cos_i * cos_Omega;
+    d_satvel_Z = d_satpos_Y * sin_i;
 }
 
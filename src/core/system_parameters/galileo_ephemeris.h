@@ -35,6 +35,8 @@
 
 #include <boost/assign.hpp>
 #include <boost/serialization/nvp.hpp>
+#include <boost/serialization/version.hpp>
+#include "kepler_orbit.h"
 
 
 /*!
@@ -106,7 +108,7 @@ public:
     unsigned int i_satellite_PRN; //!< SV PRN NUMBER
 
     void satellitePosition(double transmitTime);            //!< Computes the ECEF SV coordinates and ECEF velocity
-    double Galileo_System_Time(double WN, double TOW);      //!< Galileo System Time (GST), ICD paragraph 5.1.2
+    double Galileo_System_Time(double WN, double TOW) const; //!< Galileo System Time (GST), ICD paragraph 5.1.2
     double sv_clock_drift(double transmitTime);             //!< Satellite Time Correction Algorithm, ICD 5.1.4
     double sv_clock_relativistic_term(double transmitTime); //!< Satellite Time Correction Algorithm, ICD 5.1.4
     Galileo_Ephemeris();
@@ -140,7 +142,17 @@ public:
         archive & make_nvp("af0_4", af0_4);
         archive & make_nvp("af1_4", af1_4);
         archive & make_nvp("af2_4", af2_4);
+        if (version > 0)
+            {
+                archive & make_nvp("WN_5", WN_5);
+            }
     }
+
+private:
+    Kepler_Orbit d_orbit;  // orbit constants and last Kepler solution, not serialized
 };
 
+// version 1 adds the week number
+BOOST_CLASS_VERSION(Galileo_Ephemeris, 1)
+
 #endif
@@ -36,7 +36,6 @@
 
 #include "galileo_fnav_message.h"
 #include <boost/crc.hpp>      // for boost::crc_basic, boost::crc_optimal
-#include <boost/dynamic_bitset.hpp>
 #include <glog/logging.h>
 #include <iostream>
 
@@ -46,6 +45,7 @@ typedef boost::crc_optimal<24, 0x1864CFBu, 0x0, 0x0, false, false> CRC_Galileo_F
 void Galileo_Fnav_Message::reset()
 {
     flag_CRC_test = false;
+    omega0_1 = 0;
     flag_all_ephemeris = false;  //!< Flag indicating that all words containing ephemeris have been received
     flag_ephemeris_1 = false;    //!< Flag indicating that ephemeris 1/3 (word 2) have been received
     flag_ephemeris_2 = false;    //!< Flag indicating that ephemeris 2/3 (word 3) have been received
@@ -194,15 +194,16 @@ Galileo_Fnav_Message::Galileo_Fnav_Message()
 
 void Galileo_Fnav_Message::split_page(std::string page_string)
 {
-    std::string message_word = page_string.substr(0, 214);
-    std::string CRC_data = page_string.substr(214, 24);
-    std::bitset<GALILEO_FNAV_DATA_FRAME_BITS> Word_for_CRC_bits(message_word);
-    std::bitset<24> checksum(CRC_data);
-    if (_CRC_test(Word_for_CRC_bits, checksum.to_ulong()) == true)
+    // the message word is followed by its 24 bits CRC
+    Gnss_Packed_Bits<GALILEO_FNAV_DATA_FRAME_BITS> data_bits;
+    Gnss_Packed_Bits<24> checksum;
+    data_bits.set_bits(1, page_string.c_str(), GALILEO_FNAV_DATA_FRAME_BITS);
+    checksum.set_bits(1, page_string.c_str() + GALILEO_FNAV_DATA_FRAME_BITS, 24);
+    if (_CRC_test(data_bits, static_cast<boost::uint32_t>(checksum.read_bits(1, 24))) == true)
         {
             flag_CRC_test = true;
             // CRC correct: Decode word
-            decode_page(message_word);
+            decode_page(data_bits);
         }
     else
         {
@@ -211,24 +212,17 @@ void Galileo_Fnav_Message::split_page(std::string page_string)
 }
 
 
-bool Galileo_Fnav_Message::_CRC_test(std::bitset<GALILEO_FNAV_DATA_FRAME_BITS> bits, boost::uint32_t checksum)
+bool Galileo_Fnav_Message::_CRC_test(const Gnss_Packed_Bits<GALILEO_FNAV_DATA_FRAME_BITS>& bits, boost::uint32_t checksum)
 {
     CRC_Galileo_FNAV_type CRC_Galileo;
 
     boost::uint32_t crc_computed;
     // Galileo FNAV frame for CRC is not an integer multiple of bytes
     // it needs to be filled with zeroes at the start of the frame.
-    // This operation is done in the transformation from bits to bytes
-    // using boost::dynamic_bitset.
-    // ToDo: Use boost::dynamic_bitset for all the bitset operations in this class
+    unsigned char bytes[GALILEO_FNAV_DATA_FRAME_BYTES];
+    bits.to_bytes(bytes);
 
-    boost::dynamic_bitset<unsigned char> frame_bits(std::string(bits.to_string()));
-
-    std::vector<unsigned char> bytes;
-    boost::to_block_range(frame_bits, std::back_inserter(bytes));
-    std::reverse(bytes.begin(), bytes.end());
-
-    CRC_Galileo.process_bytes( bytes.data(), GALILEO_FNAV_DATA_FRAME_BYTES );
+    CRC_Galileo.process_bytes( bytes, GALILEO_FNAV_DATA_FRAME_BYTES );
 
     crc_computed = CRC_Galileo.checksum();
     if (checksum == crc_computed)
@@ -242,9 +236,8 @@ bool Galileo_Fnav_Message::_CRC_test(std::bitset<GALILEO_FNAV_DATA_FRAME_BITS> b
 }
 
 
-void Galileo_Fnav_Message::decode_page(std::string data)
+void Galileo_Fnav_Message::decode_page(const Gnss_Packed_Bits<GALILEO_FNAV_DATA_FRAME_BITS>& data_bits)
 {
-    std::bitset<GALILEO_FNAV_DATA_FRAME_BITS> data_bits(data);
     page_type = read_navigation_unsigned(data_bits, FNAV_PAGE_TYPE_bit);
     switch(page_type)
     {
@@ -395,7 +388,7 @@ void Galileo_Fnav_Message::decode_page(std::string data)
         FNAV_deltai_2_5 *= FNAV_deltai_5_LSB;
         //TODO check this
         // Omega0_2 must be decoded when the two pieces are joined
-        omega0_1 = data.substr(210, 4);
+        omega0_1 = static_cast<unsigned int>(data_bits.read_bits(211, 4));
         //omega_flag=true;
         //
         //FNAV_Omega012_2_5=static_cast<double>(read_navigation_signed(data_bits, FNAV_Omega012_2_5_bit);
@@ -407,11 +400,14 @@ void Galileo_Fnav_Message::decode_page(std::string data)
 
         /* Don't worry about omega pieces. If page 5 has not been received, all_ephemeris
          * flag will be set to false and the data won't be recorded.*/
-        std::string omega0_2 = data.substr(10, 12);
-        std::string Omega0 = omega0_1 + omega0_2;
-        std::bitset<GALILEO_FNAV_DATA_FRAME_BITS> omega_bits(Omega0);
-        const std::vector<std::pair<int, int>> om_bit({{0, 12}});
-        FNAV_Omega0_2_6 = static_cast<double>(read_navigation_signed(omega_bits, om_bit));
+        {
+            // the 4 MSBs of page 5 and the 12 LSBs of this page form a 16 bits signed value
+            Gnss_Packed_Bits<16> omega_bits;
+            const Gnss_Bit_Field omega_bit = {{ {1,16} }};
+            omega_bits.set_bits(1, 4, omega0_1);
+            omega_bits.set_bits(5, 12, static_cast<uint32_t>(data_bits.read_bits(11, 12)));
+            FNAV_Omega0_2_6 = static_cast<double>(omega_bits.read_signed(omega_bit));
+        }
         FNAV_Omega0_2_6 *= FNAV_Omega0_5_LSB;
         //
         FNAV_Omegadot_2_6 = static_cast<double>(read_navigation_signed(data_bits, FNAV_Omegadot_2_6_bit));
@@ -450,85 +446,18 @@ void Galileo_Fnav_Message::decode_page(std::string data)
 }
 
 
-unsigned long int Galileo_Fnav_Message::read_navigation_unsigned(std::bitset<GALILEO_FNAV_DATA_FRAME_BITS> bits, const std::vector<std::pair<int,int>> parameter)
+unsigned long int Galileo_Fnav_Message::read_navigation_unsigned(const Gnss_Packed_Bits<GALILEO_FNAV_DATA_FRAME_BITS>& bits, const Gnss_Bit_Field& parameter)
 {
-    unsigned long int value = 0;
-    int num_of_slices = parameter.size();
-    for (int i=0; i<num_of_slices; i++)
-        {
-            for (int j=0; j<parameter[i].second; j++)
-                {
-                    value <<= 1; //shift left
-                    if (bits[GALILEO_FNAV_DATA_FRAME_BITS - parameter[i].first - j] == 1)
-                        {
-                            value += 1; // insert the bit
-                        }
-                }
-        }
-    return value;
+    return bits.read_unsigned(parameter);
 }
 
 
 
 
 
-signed long int Galileo_Fnav_Message::read_navigation_signed(std::bitset<GALILEO_FNAV_DATA_FRAME_BITS> bits, const std::vector<std::pair<int,int>> parameter)
+signed long int Galileo_Fnav_Message::read_navigation_signed(const Gnss_Packed_Bits<GALILEO_FNAV_DATA_FRAME_BITS>& bits, const Gnss_Bit_Field& parameter)
 {
-    signed long int value = 0;
-    int num_of_slices = parameter.size();
-    // Discriminate between 64 bits and 32 bits compiler
-    int long_int_size_bytes = sizeof(signed long int);
-    if (long_int_size_bytes == 8) // if a long int takes 8 bytes, we are in a 64 bits system
-        {
-            // read the MSB and perform the sign extension
-            if (bits[GALILEO_FNAV_DATA_FRAME_BITS - parameter[0].first] == 1)
-                {
-                    value ^= 0xFFFFFFFFFFFFFFFF; //64 bits variable
-                }
-            else
-                {
-                    value &= 0;
-                }
-
-            for (int i=0; i<num_of_slices; i++)
-                {
-                    for (int j=0; j<parameter[i].second; j++)
-                        {
-                            value <<= 1; //shift left
-                            value &= 0xFFFFFFFFFFFFFFFE; //reset the corresponding bit (for the 64 bits variable)
-                            if (bits[GALILEO_FNAV_DATA_FRAME_BITS - parameter[i].first - j] == 1)
-                                {
-                                    value += 1; // insert the bit
-                                }
-                        }
-                }
-        }
-    else  // we assume we are in a 32 bits system
-        {
-            // read the MSB and perform the sign extension
-            if (bits[GALILEO_FNAV_DATA_FRAME_BITS - parameter[0].first] == 1)
-                {
-                    value ^= 0xFFFFFFFF;
-                }
-            else
-                {
-                    value &= 0;
-                }
-
-            for (int i=0; i<num_of_slices; i++)
-                {
-                    for (int j=0; j<parameter[i].second; j++)
-                        {
-                            value <<= 1; //shift left
-                            value &= 0xFFFFFFFE; //reset the corresponding bit
-                            if (bits[GALILEO_FNAV_DATA_FRAME_BITS - parameter[i].first - j] == 1)
-                                {
-                                    value += 1; // insert the bit
-                                }
-                        }
-                }
-        }
-    return value;
+    return bits.read_signed(parameter);
 }
 
 
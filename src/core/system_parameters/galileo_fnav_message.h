@@ -212,12 +212,12 @@ public:
 
 
 private:
-    bool _CRC_test(std::bitset<GALILEO_FNAV_DATA_FRAME_BITS> bits,boost::uint32_t checksum);
-    void decode_page(std::string data);
-    unsigned long int read_navigation_unsigned(std::bitset<GALILEO_FNAV_DATA_FRAME_BITS> bits, const std::vector<std::pair<int,int>> parameter);
-    signed long int read_navigation_signed(std::bitset<GALILEO_FNAV_DATA_FRAME_BITS> bits, const std::vector<std::pair<int,int>> parameter);
+    bool _CRC_test(const Gnss_Packed_Bits<GALILEO_FNAV_DATA_FRAME_BITS>& bits, boost::uint32_t checksum);
+    void decode_page(const Gnss_Packed_Bits<GALILEO_FNAV_DATA_FRAME_BITS>& data_bits);
+    unsigned long int read_navigation_unsigned(const Gnss_Packed_Bits<GALILEO_FNAV_DATA_FRAME_BITS>& bits, const Gnss_Bit_Field& parameter);
+    signed long int read_navigation_signed(const Gnss_Packed_Bits<GALILEO_FNAV_DATA_FRAME_BITS>& bits, const Gnss_Bit_Field& parameter);
 
-    std::string omega0_1;
+    unsigned int omega0_1;  // 4 MSBs of Omega0 of SVID2, sent in page 5
     //std::string omega0_2;
     //bool omega_flag;
 };
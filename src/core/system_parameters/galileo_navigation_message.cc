@@ -32,7 +32,6 @@
 
 #include "galileo_navigation_message.h"
 #include <boost/crc.hpp>      // for boost::crc_basic, boost::crc_optimal
-#include <boost/dynamic_bitset.hpp>
 #include <glog/logging.h>
 #include <iostream>
 
@@ -228,24 +227,17 @@ Galileo_Navigation_Message::Galileo_Navigation_Message()
 }
 
 
-bool Galileo_Navigation_Message::CRC_test(std::bitset<GALILEO_DATA_FRAME_BITS> bits,boost::uint32_t checksum)
+bool Galileo_Navigation_Message::CRC_test(const Gnss_Packed_Bits<GALILEO_DATA_FRAME_BITS>& bits, boost::uint32_t checksum)
 {
     CRC_Galileo_INAV_type CRC_Galileo;
 
     boost::uint32_t crc_computed;
     // Galileo INAV frame for CRC is not an integer multiple of bytes
     // it needs to be filled with zeroes at the start of the frame.
-    // This operation is done in the transformation from bits to bytes
-    // using boost::dynamic_bitset.
-    // ToDo: Use boost::dynamic_bitset for all the bitset operations in this class
+    unsigned char bytes[GALILEO_DATA_FRAME_BYTES];
+    bits.to_bytes(bytes);
 
-    boost::dynamic_bitset<unsigned char> frame_bits(std::string(bits.to_string()));
-
-    std::vector<unsigned char> bytes;
-    boost::to_block_range(frame_bits, std::back_inserter(bytes));
-    std::reverse(bytes.begin(),bytes.end());
-
-    CRC_Galileo.process_bytes( bytes.data(), GALILEO_DATA_FRAME_BYTES );
+    CRC_Galileo.process_bytes( bytes, GALILEO_DATA_FRAME_BYTES );
 
     crc_computed = CRC_Galileo.checksum();
     if (checksum == crc_computed)
@@ -259,118 +251,29 @@ bool Galileo_Navigation_Message::CRC_test(std::bitset<GALILEO_DATA_FRAME_BITS> b
 }
 
 
-unsigned long int Galileo_Navigation_Message::read_navigation_unsigned(std::bitset<GALILEO_DATA_JK_BITS> bits, const std::vector<std::pair<int,int> > parameter)
+unsigned long int Galileo_Navigation_Message::read_navigation_unsigned(const Gnss_Packed_Bits<GALILEO_DATA_JK_BITS>& bits, const Gnss_Bit_Field& parameter)
 {
-    unsigned long int value = 0;
-    int num_of_slices = parameter.size();
-    for (int i = 0; i < num_of_slices; i++)
-        {
-            for (int j = 0; j < parameter[i].second; j++)
-                {
-                    value <<= 1; //shift left
-                    if (bits[GALILEO_DATA_JK_BITS - parameter[i].first - j] == 1)
-                        {
-                            value += 1; // insert the bit
-                        }
-                }
-        }
-    return value;
+    return bits.read_unsigned(parameter);
 }
 
 
 
-unsigned long int Galileo_Navigation_Message::read_page_type_unsigned(std::bitset<GALILEO_PAGE_TYPE_BITS> bits, const std::vector<std::pair<int,int> > parameter)
+unsigned long int Galileo_Navigation_Message::read_page_type_unsigned(const Gnss_Packed_Bits<GALILEO_PAGE_TYPE_BITS>& bits, const Gnss_Bit_Field& parameter)
 {
-    unsigned long int value = 0;
-    int num_of_slices = parameter.size();
-    for (int i = 0; i < num_of_slices; i++)
-        {
-            for (int j = 0; j < parameter[i].second; j++)
-                {
-                    value <<= 1; //shift left
-                    if (bits[GALILEO_PAGE_TYPE_BITS - parameter[i].first - j] == 1)
-                        {
-                            value += 1; // insert the bit
-                        }
-                }
-        }
-    return value;
+    return bits.read_unsigned(parameter);
 }
 
 
 
-signed long int Galileo_Navigation_Message::read_navigation_signed(std::bitset<GALILEO_DATA_JK_BITS> bits, const std::vector<std::pair<int,int> > parameter)
+signed long int Galileo_Navigation_Message::read_navigation_signed(const Gnss_Packed_Bits<GALILEO_DATA_JK_BITS>& bits, const Gnss_Bit_Field& parameter)
 {
-    signed long int value = 0;
-    int num_of_slices = parameter.size();
-    // Discriminate between 64 bits and 32 bits compiler
-    int long_int_size_bytes = sizeof(signed long int);
-    if (long_int_size_bytes == 8) // if a long int takes 8 bytes, we are in a 64 bits system
-        {
-            // read the MSB and perform the sign extension
-            if (bits[GALILEO_DATA_JK_BITS - parameter[0].first] == 1)
-                {
-                    value ^= 0xFFFFFFFFFFFFFFFF; //64 bits variable
-                }
-            else
-                {
-                    value &= 0;
-                }
-
-            for (int i = 0; i < num_of_slices; i++)
-                {
-                    for (int j = 0; j < parameter[i].second; j++)
-                        {
-                            value <<= 1; //shift left
-                            value &= 0xFFFFFFFFFFFFFFFE; //reset the corresponding bit (for the 64 bits variable)
-                            if (bits[GALILEO_DATA_JK_BITS - parameter[i].first - j] == 1)
-                                {
-                                    value += 1; // insert the bit
-                                }
-                        }
-                }
-        }
-    else  // we assume we are in a 32 bits system
-        {
-            // read the MSB and perform the sign extension
-            if (bits[GALILEO_DATA_JK_BITS - parameter[0].first] == 1)
-                {
-                    value ^= 0xFFFFFFFF;
-                }
-            else
-                {
-                    value &= 0;
-                }
-
-            for (int i = 0; i < num_of_slices; i++)
-                {
-                    for (int j = 0; j < parameter[i].second; j++)
-                        {
-                            value <<= 1; //shift left
-                            value &= 0xFFFFFFFE; //reset the corresponding bit
-                            if (bits[GALILEO_DATA_JK_BITS - parameter[i].first - j] == 1)
-                                {
-                                    value += 1; // insert the bit
-                                }
-                        }
-                }
-        }
-    return value;
+    return bits.read_signed(parameter);
 }
 
 
-bool Galileo_Navigation_Message::read_navigation_bool(std::bitset<GALILEO_DATA_JK_BITS> bits, const std::vector<std::pair<int,int> > parameter)
+bool Galileo_Navigation_Message::read_navigation_bool(const Gnss_Packed_Bits<GALILEO_DATA_JK_BITS>& bits, const Gnss_Bit_Field& parameter)
 {
-    bool value;
-    if (bits[GALILEO_DATA_JK_BITS - parameter[0].first] == 1)
-        {
-            value = true;
-        }
-    else
-        {
-            value = false;
-        }
-    return value;
+    return bits.read_bool(parameter);
 }
 
 
@@ -379,64 +282,38 @@ bool Galileo_Navigation_Message::read_navigation_bool(std::bitset<GALILEO_DATA_J
 void Galileo_Navigation_Message::split_page(std::string page_string, int flag_even_word)
 {
     // ToDo: Clean all the tests and create an independent google test code for the telemetry decoder.
-    //char correct_tail[7]="011110"; //the viterbi decoder output change the tail to this value (why?)
-    //char correct_tail[7]="000000";
-
+    // INAV page (ICD 4.3.2.3): the even page part without its tail (114 bits)
+    // followed by the odd page part. Even bit, page type and Data_k (112 bits)
+    // come from the even part, and odd bit, page type, Data_j (16 bits),
+    // reserved 1 (40 bits), SAR (22 bits) and spare (2 bits) from the odd one,
+    // followed by the CRC (24 bits), reserved 2 (8 bits) and tail (6 bits).
+    const int even_part_bits = 114;
     int Page_type = 0;
-    //std::cout << "Start decoding Galileo I/NAV " << std::endl;
 
     if(page_string.at(0) == '1')// if page is odd
         {
-            //std::cout<< "page_string.at(0) split page="<<page_string.at(0) << std::endl;
-            std::string page_Odd = page_string;
-            //std::cout<<"Page odd string in split page"<< std::endl << page_Odd << std::endl;
-
             if (flag_even_word == 1) // An odd page has been received but the previous even page is kept in memory and it is considered to join pages
                 {
-                    std::string page_INAV_even = page_Even;
-                    std::string page_INAV = page_INAV_even + page_Odd; // Join pages: Even + Odd = INAV page
-                    std::string Even_bit = page_INAV.substr (0,1);
-                    std::string Page_type_even = page_INAV.substr (1,1);
-                    std::string nominal = "0";
-
-                    //if (Page_type_even.compare(nominal) != 0)
-                    //        std::cout << "Alert frame "<< std::endl;
-                    //else std::cout << "Nominal Page" << std::endl;
-
-                    std::string Data_k = page_INAV.substr (2,112);
-                    std::string Odd_bit = page_INAV.substr (114,1);
-                    std::string Page_type_Odd = page_INAV.substr (115,1);
-                    std::string Data_j = page_INAV.substr (116,16);
-
-                    std::string Reserved_1 = page_INAV.substr (132,40);
-                    std::string SAR = page_INAV.substr (172,22);
-                    std::string Spare = page_INAV.substr (194,2);
-                    std::string CRC_data = page_INAV.substr (196,24);
-                    std::string Reserved_2 = page_INAV.substr (220,8);
-                    std::string Tail_odd = page_INAV.substr (228,6);
-
                     //************ CRC checksum control *******/
-                    std::stringstream TLM_word_for_CRC_stream;
-                    TLM_word_for_CRC_stream << page_INAV;
-                    std::string TLM_word_for_CRC;
-                    TLM_word_for_CRC = TLM_word_for_CRC_stream.str().substr(0, GALILEO_DATA_FRAME_BITS);
-                    std::bitset<GALILEO_DATA_FRAME_BITS> TLM_word_for_CRC_bits(TLM_word_for_CRC);
-                    std::bitset<24> checksum(CRC_data);
-
-                    //if (Tail_odd.compare(correct_tail) != 0)
-                    //        std::cout << "Tail odd is not correct!" << std::endl;
-                    //else std::cout<<"Tail odd is correct!"<<std::endl;
-
-                    if (CRC_test(TLM_word_for_CRC_bits, checksum.to_ulong()) == true)
+                    Gnss_Packed_Bits<24> checksum;
+                    page_INAV.set_bits(even_part_bits + 1, page_string.c_str(), GALILEO_DATA_FRAME_BITS - even_part_bits);
+                    checksum.set_bits(1, page_string.c_str() + GALILEO_DATA_FRAME_BITS - even_part_bits, 24);
+
+                    if (CRC_test(page_INAV, static_cast<boost::uint32_t>(checksum.read_bits(1, 24))) == true)
                         {
                             flag_CRC_test = true;
-                            // CRC correct: Decode word
-                            std::string page_number_bits = Data_k.substr (0,6);
-                            std::bitset<GALILEO_PAGE_TYPE_BITS> page_type_bits (page_number_bits); // from string to bitset
+                            // CRC correct: Decode word. Data_jk = Data_k + Data_j
+                            Gnss_Packed_Bits<GALILEO_DATA_JK_BITS> data_jk_bits;
+                            for (int j = 0; j < 112; j += 28)
+                                {
+                                    data_jk_bits.set_bits(j + 1, 28, static_cast<uint32_t>(page_INAV.read_bits(j + 3, 28)));
+                                }
+                            data_jk_bits.set_bits(113, 16, static_cast<uint32_t>(page_INAV.read_bits(even_part_bits + 3, 16)));
+                            Gnss_Packed_Bits<GALILEO_PAGE_TYPE_BITS> page_type_bits;
+                            page_type_bits.set_bits(1, GALILEO_PAGE_TYPE_BITS, static_cast<uint32_t>(page_INAV.read_bits(3, GALILEO_PAGE_TYPE_BITS)));
                             Page_type = static_cast<int>(read_page_type_unsigned(page_type_bits, type));
                             Page_type_time_stamp = Page_type;
-                            std::string Data_jk_ephemeris = Data_k + Data_j;
-                            page_jk_decoder(Data_jk_ephemeris.c_str());
+                            page_jk_decoder(data_jk_bits);
                         }
                     else
                         {
@@ -447,12 +324,7 @@ void Galileo_Navigation_Message::split_page(std::string page_string, int flag_ev
         } // end if (page_string.at(0)=='1')
     else
         {
-            page_Even = page_string.substr (0,114);
-            std::string tail_Even =  page_string.substr (114,6);
-            //std::cout << "tail_even_string: " << tail_Even <<std::endl;
-            //if (tail_Even.compare(correct_tail) != 0)
-            //     std::cout << "Tail even is not correct!" << std::endl;
-            //else std::cout<<"Tail even is correct!"<< std::endl;
+            page_INAV.set_bits(1, page_string.c_str(), even_part_bits);
         }
 }
 
@@ -686,11 +558,15 @@ Galileo_Almanac Galileo_Navigation_Message::get_almanac()
 
 int Galileo_Navigation_Message::page_jk_decoder(const char *data_jk)
 {
-    int page_number = 0;
+    Gnss_Packed_Bits<GALILEO_DATA_JK_BITS> data_jk_bits;
+    data_jk_bits.set_bits(1, data_jk, GALILEO_DATA_JK_BITS);
+    return page_jk_decoder(data_jk_bits);
+}
 
-    std::string data_jk_string = data_jk;
-    std::bitset<GALILEO_DATA_JK_BITS> data_jk_bits (data_jk_string);
-    //DLOG(INFO) << "Data_jk_bits (bitset)  "<< endl << data_jk_bits << endl;
+
+int Galileo_Navigation_Message::page_jk_decoder(const Gnss_Packed_Bits<GALILEO_DATA_JK_BITS>& data_jk_bits)
+{
+    int page_number = 0;
 
     page_number = static_cast<int>(read_navigation_unsigned(data_jk_bits, PAGE_TYPE_bit));
     LOG(INFO) << "Page number = " << page_number;
@@ -53,16 +53,16 @@
 class Galileo_Navigation_Message
 {
 private:
-    bool CRC_test(std::bitset<GALILEO_DATA_FRAME_BITS> bits, boost::uint32_t checksum);
-    bool read_navigation_bool(std::bitset<GALILEO_DATA_JK_BITS> bits, const std::vector<std::pair<int,int> > parameter);
+    bool CRC_test(const Gnss_Packed_Bits<GALILEO_DATA_FRAME_BITS>& bits, boost::uint32_t checksum);
+    bool read_navigation_bool(const Gnss_Packed_Bits<GALILEO_DATA_JK_BITS>& bits, const Gnss_Bit_Field& parameter);
     //void print_galileo_word_bytes(unsigned int GPS_word);
-    unsigned long int read_navigation_unsigned(std::bitset<GALILEO_DATA_JK_BITS> bits, const std::vector< std::pair<int,int> > parameter);
-    unsigned long int read_page_type_unsigned(std::bitset<GALILEO_PAGE_TYPE_BITS> bits, const std::vector< std::pair<int,int> > parameter);
-    signed long int read_navigation_signed(std::bitset<GALILEO_DATA_JK_BITS> bits, const std::vector<std::pair<int,int> > parameter);
+    unsigned long int read_navigation_unsigned(const Gnss_Packed_Bits<GALILEO_DATA_JK_BITS>& bits, const Gnss_Bit_Field& parameter);
+    unsigned long int read_page_type_unsigned(const Gnss_Packed_Bits<GALILEO_PAGE_TYPE_BITS>& bits, const Gnss_Bit_Field& parameter);
+    signed long int read_navigation_signed(const Gnss_Packed_Bits<GALILEO_DATA_JK_BITS>& bits, const Gnss_Bit_Field& parameter);
 public:
     int Page_type_time_stamp;
     int flag_even_word;
-    std::string page_Even;
+    Gnss_Packed_Bits<GALILEO_DATA_FRAME_BITS> page_INAV;  //!< Even page part, followed by the odd page part covered by the CRC
     bool flag_CRC_test;
     bool flag_all_ephemeris;  //!< Flag indicating that all words containing ephemeris have been received
     bool flag_ephemeris_1;    //!< Flag indicating that ephemeris 1/4 (word 1) have been received
@@ -245,6 +245,7 @@ public:
      * Takes in input Data_jk (128 bit) and split it in ephemeris parameters according ICD 4.3.5
      */
     int page_jk_decoder(const char *data_jk);
+    int page_jk_decoder(const Gnss_Packed_Bits<GALILEO_DATA_JK_BITS>& data_jk_bits);
 
     void reset();
 
@@ -0,0 +1,102 @@
+/*!
+ * \file gnss_binary_archive.cc
+ * \brief Compact binary files of the navigation data, next to the XML ones
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_binary_archive.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+const char MAGIC[8] = {'G', 'N', 'S', 'S', 'S', 'D', 'R', 'B'};
+// read back in another byte order if the file comes from another machine
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+const uint32_t MAX_CONTENT_LENGTH = 64;
+
+void write_u32(std::ostream & out, uint32_t value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+bool read_u32(std::istream & in, uint32_t & value)
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+}
+
+
+bool Gnss_Binary_Archive::is_binary(const std::string & file_name)
+{
+    std::ifstream ifs(file_name.c_str(), std::ifstream::in | std::ifstream::binary);
+    char magic[sizeof(MAGIC)];
+    return ifs.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+
+void Gnss_Binary_Archive::write_header(std::ostream & out, const std::string & content)
+{
+    out.write(MAGIC, sizeof(MAGIC));
+    write_u32(out, BYTE_ORDER_MARK);
+    write_u32(out, FORMAT_VERSION);
+    write_u32(out, static_cast<uint32_t>(content.size()));
+    out.write(content.data(), content.size());
+}
+
+
+bool Gnss_Binary_Archive::read_header(std::istream & in, const std::string & content)
+{
+    char magic[sizeof(MAGIC)];
+    uint32_t byte_order = 0;
+    uint32_t version = 0;
+    uint32_t length = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0
+            || !read_u32(in, byte_order) || !read_u32(in, version) || !read_u32(in, length))
+        {
+            LOG(WARNING) << "Not a GNSS-SDR binary file";
+            return false;
+        }
+    if (byte_order != BYTE_ORDER_MARK)
+        {
+            LOG(WARNING) << "Binary file written with another byte order, use the XML files to move data between machines";
+            return false;
+        }
+    if (version != FORMAT_VERSION)
+        {
+            LOG(WARNING) << "Binary file of format version " << version << ", expected " << static_cast<unsigned int>(FORMAT_VERSION);
+            return false;
+        }
+    std::string stored(std::min(length, MAX_CONTENT_LENGTH), '\0');
+    if (length > MAX_CONTENT_LENGTH || !in.read(&stored[0], length) || stored != content)
+        {
+            LOG(WARNING) << "Binary file of " << stored << ", expected " << content;
+            return false;
+        }
+    return true;
+}
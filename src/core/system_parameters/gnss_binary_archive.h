@@ -0,0 +1,129 @@
+/*!
+ * \file gnss_binary_archive.h
+ * \brief Compact binary files of the navigation data, next to the XML ones
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The XML archives are portable and readable, and remain the format to
+ * exchange data with other receivers and tools. Parsing them is slow when
+ * the assistance of many receivers is loaded at startup, so the same
+ * objects can also be written with a Boost binary archive, after a header
+ * that identifies the file, its content and the byte order of the machine
+ * that wrote it. A file written by a machine of another byte order, or of
+ * another format version, is rejected instead of misread.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_BINARY_ARCHIVE_H_
+#define GNSS_SDR_GNSS_BINARY_ARCHIVE_H_
+
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <string>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <glog/logging.h>
+
+/*!
+ * \brief Saves and loads serializable objects to binary files.
+ *
+ * \p content names what the file holds, for instance "receiver_state";
+ * loading a file of another content fails. The versions of the classes
+ * are kept by the Boost archive, as in the XML files.
+ */
+class Gnss_Binary_Archive
+{
+public:
+    //! Format version of the header, increased when the layout changes
+    static const unsigned int FORMAT_VERSION = 1;
+
+    //! True if \p file_name starts with the header of a binary archive
+    static bool is_binary(const std::string & file_name);
+
+    /*!
+     * \brief Writes \p object to \p file_name. It is written to a temporary
+     * file first and then renamed, so that a crash does not leave half a file.
+     */
+    template<class T>
+    static bool save(const std::string & file_name, const std::string & content, const T & object)
+    {
+        const std::string tmp_file_name = file_name + ".tmp";
+        try
+        {
+                std::ofstream ofs(tmp_file_name.c_str(), std::ofstream::trunc | std::ofstream::out | std::ofstream::binary);
+                write_header(ofs, content);
+                {
+                    boost::archive::binary_oarchive archive(ofs);
+                    archive << object;
+                }
+                ofs.close();
+                if (!ofs)
+                    {
+                        LOG(WARNING) << "Failed to write " << tmp_file_name;
+                        return false;
+                    }
+        }
+        catch (std::exception& e)
+        {
+                LOG(WARNING) << e.what() << " File: " << tmp_file_name;
+                return false;
+        }
+        if (std::rename(tmp_file_name.c_str(), file_name.c_str()) != 0)
+            {
+                LOG(WARNING) << "Failed to rename " << tmp_file_name << " to " << file_name;
+                return false;
+            }
+        return true;
+    }
+
+    //! Reads \p object from \p file_name. \p object is undefined if it fails.
+    template<class T>
+    static bool load(const std::string & file_name, const std::string & content, T & object)
+    {
+        try
+        {
+                std::ifstream ifs(file_name.c_str(), std::ifstream::in | std::ifstream::binary);
+                if (!ifs.is_open() || !read_header(ifs, content))
+                    {
+                        return false;
+                    }
+                boost::archive::binary_iarchive archive(ifs);
+                archive >> object;
+        }
+        catch (std::exception& e)
+        {
+                LOG(WARNING) << e.what() << " File: " << file_name;
+                return false;
+        }
+        return true;
+    }
+
+private:
+    static void write_header(std::ostream & out, const std::string & content);
+    static bool read_header(std::istream & in, const std::string & content);
+};
+
+#endif
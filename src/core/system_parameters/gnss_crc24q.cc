@@ -0,0 +1,116 @@
+/*!
+ * \file gnss_crc24q.cc
+ * \brief Qualcomm CRC-24Q, as used by the RTCM 3 transport layer.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_crc24q.h"
+
+
+namespace
+{
+/*
+ * The 24-bit register is kept in the 24 MSBs of a 32-bit word, so that the
+ * usual MSB first CRC-32 slicing applies unchanged. entry[k][i] is the
+ * remainder of byte i followed by k zero bytes.
+ */
+struct Crc24q_Tables
+{
+    uint32_t entry[8][256];
+
+    Crc24q_Tables()
+    {
+        const uint32_t polynomial = 0x864CFBu << 8;
+        for (uint32_t i = 0; i < 256; i++)
+            {
+                uint32_t crc = i << 24;
+                for (int j = 0; j < 8; j++)
+                    {
+                        crc = (crc & 0x80000000u) ? (crc << 1) ^ polynomial : crc << 1;
+                    }
+                entry[0][i] = crc;
+            }
+        for (int k = 1; k < 8; k++)
+            {
+                for (uint32_t i = 0; i < 256; i++)
+                    {
+                        entry[k][i] = (entry[k - 1][i] << 8) ^ entry[0][entry[k - 1][i] >> 24];
+                    }
+            }
+    }
+};
+
+
+const Crc24q_Tables & crc24q_tables()
+{
+    static const Crc24q_Tables tables;
+    return tables;
+}
+}
+
+
+uint32_t Gnss_Crc24q::checksum(const unsigned char * data, size_t length)
+{
+    const Crc24q_Tables & t = crc24q_tables();
+    uint32_t crc = 0;
+    while (length >= 8)
+        {
+            const uint32_t one = crc ^ ((static_cast<uint32_t>(data[0]) << 24) |
+                    (static_cast<uint32_t>(data[1]) << 16) |
+                    (static_cast<uint32_t>(data[2]) << 8) |
+                    static_cast<uint32_t>(data[3]));
+            const uint32_t two = (static_cast<uint32_t>(data[4]) << 24) |
+                    (static_cast<uint32_t>(data[5]) << 16) |
+                    (static_cast<uint32_t>(data[6]) << 8) |
+                    static_cast<uint32_t>(data[7]);
+            crc = t.entry[7][one >> 24] ^ t.entry[6][(one >> 16) & 0xFF] ^
+                    t.entry[5][(one >> 8) & 0xFF] ^ t.entry[4][one & 0xFF] ^
+                    t.entry[3][two >> 24] ^ t.entry[2][(two >> 16) & 0xFF] ^
+                    t.entry[1][(two >> 8) & 0xFF] ^ t.entry[0][two & 0xFF];
+            data += 8;
+            length -= 8;
+        }
+    while (length > 0)
+        {
+            crc = (crc << 8) ^ t.entry[0][(crc >> 24) ^ *data];
+            data++;
+            length--;
+        }
+    return crc >> 8;
+}
+
+
+uint32_t Gnss_Crc24q::checksum_bytewise(const unsigned char * data, size_t length)
+{
+    const Crc24q_Tables & t = crc24q_tables();
+    uint32_t crc = 0;
+    for (size_t i = 0; i < length; i++)
+        {
+            crc = (crc << 8) ^ t.entry[0][(crc >> 24) ^ data[i]];
+        }
+    return crc >> 8;
+}
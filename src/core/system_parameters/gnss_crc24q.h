@@ -0,0 +1,55 @@
+/*!
+ * \file gnss_crc24q.h
+ * \brief Qualcomm CRC-24Q, as used by the RTCM 3 transport layer.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The checksum is the remainder of the message, MSB first, divided by the
+ * polynomial 0x1864CFB, with a zero initial value and no final XOR, so it is
+ * the same as the one of boost::crc_optimal<24, 0x1864CFBu, 0x0, 0x0, false,
+ * false>. checksum() processes eight bytes per step with eight lookup tables
+ * (slicing-by-8), built on first use, which matters for the long MSM frames
+ * sent by the RTCM server. checksum_bytewise() is the one table version,
+ * kept as a reference.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_CRC24Q_H_
+#define GNSS_SDR_GNSS_CRC24Q_H_
+
+#include <cstddef>
+#include <cstdint>
+
+class Gnss_Crc24q
+{
+public:
+    //! CRC-24Q of length bytes, slicing-by-8
+    static uint32_t checksum(const unsigned char * data, size_t length);
+
+    //! CRC-24Q of length bytes, one byte per step
+    static uint32_t checksum_bytewise(const unsigned char * data, size_t length);
+};
+
+#endif
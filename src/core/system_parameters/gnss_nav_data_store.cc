@@ -0,0 +1,339 @@
+/*!
+ * \file gnss_nav_data_store.cc
+ * \brief Process-wide store of the decoded navigation data.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_nav_data_store.h"
+
+namespace
+{
+// Issues of the data, compared before a new snapshot is published
+
+bool same_issue(const Gps_Ephemeris & a, const Gps_Ephemeris & b)
+{
+    return a.d_IODC == b.d_IODC && a.d_IODE_SF2 == b.d_IODE_SF2 && a.d_IODE_SF3 == b.d_IODE_SF3
+            && a.d_Toe == b.d_Toe && a.d_Toc == b.d_Toc && a.i_GPS_week == b.i_GPS_week
+            && a.i_SV_health == b.i_SV_health;
+}
+
+
+bool same_issue(const Gps_Iono & a, const Gps_Iono & b)
+{
+    return a.valid == b.valid
+            && a.d_alpha0 == b.d_alpha0 && a.d_alpha1 == b.d_alpha1 && a.d_alpha2 == b.d_alpha2 && a.d_alpha3 == b.d_alpha3
+            && a.d_beta0 == b.d_beta0 && a.d_beta1 == b.d_beta1 && a.d_beta2 == b.d_beta2 && a.d_beta3 == b.d_beta3;
+}
+
+
+bool same_issue(const Gps_Utc_Model & a, const Gps_Utc_Model & b)
+{
+    return a.valid == b.valid && a.d_A0 == b.d_A0 && a.d_A1 == b.d_A1 && a.d_t_OT == b.d_t_OT
+            && a.i_WN_T == b.i_WN_T && a.d_DeltaT_LS == b.d_DeltaT_LS && a.i_WN_LSF == b.i_WN_LSF
+            && a.i_DN == b.i_DN && a.d_DeltaT_LSF == b.d_DeltaT_LSF;
+}
+
+
+bool same_issue(const Galileo_Ephemeris & a, const Galileo_Ephemeris & b)
+{
+    return a.IOD_ephemeris == b.IOD_ephemeris && a.IOD_nav_1 == b.IOD_nav_1
+            && a.t0e_1 == b.t0e_1 && a.t0c_4 == b.t0c_4 && a.SISA_3 == b.SISA_3
+            && a.E1B_HS_5 == b.E1B_HS_5 && a.E5a_HS == b.E5a_HS;
+}
+
+
+// The time of reception (TOW_5, WN_5) is not part of the issue
+bool same_issue(const Galileo_Iono & a, const Galileo_Iono & b)
+{
+    return a.ai0_5 == b.ai0_5 && a.ai1_5 == b.ai1_5 && a.ai2_5 == b.ai2_5
+            && a.Region1_flag_5 == b.Region1_flag_5 && a.Region2_flag_5 == b.Region2_flag_5
+            && a.Region3_flag_5 == b.Region3_flag_5 && a.Region4_flag_5 == b.Region4_flag_5
+            && a.Region5_flag_5 == b.Region5_flag_5;
+}
+
+
+bool same_issue(const Galileo_Utc_Model & a, const Galileo_Utc_Model & b)
+{
+    return a.flag_utc_model == b.flag_utc_model && a.A0_6 == b.A0_6 && a.A1_6 == b.A1_6
+            && a.Delta_tLS_6 == b.Delta_tLS_6 && a.t0t_6 == b.t0t_6 && a.WNot_6 == b.WNot_6
+            && a.WN_LSF_6 == b.WN_LSF_6 && a.DN_6 == b.DN_6 && a.Delta_tLSF_6 == b.Delta_tLSF_6;
+}
+
+
+bool same_issue(const Galileo_Almanac & a, const Galileo_Almanac & b)
+{
+    return a.IOD_a_7 == b.IOD_a_7 && a.IOD_a_8 == b.IOD_a_8 && a.IOD_a_9 == b.IOD_a_9
+            && a.IOD_a_10 == b.IOD_a_10 && a.WN_a_7 == b.WN_a_7 && a.t0a_7 == b.t0a_7
+            && a.A_0G_10 == b.A_0G_10 && a.A_1G_10 == b.A_1G_10 && a.t_0G_10 == b.t_0G_10
+            && a.WN_0G_10 == b.WN_0G_10;
+}
+}
+
+
+Gnss_Nav_Data::Gnss_Nav_Data()
+{
+    version = 0;
+}
+
+
+Gnss_Rx_Position::Gnss_Rx_Position()
+{
+    latitude_d = 0.0;
+    longitude_d = 0.0;
+    height_m = 0.0;
+    has_time = false;
+    gps_tow_s = 0.0;
+    version = 0;
+}
+
+
+Gnss_Nav_Data_Store & Gnss_Nav_Data_Store::instance()
+{
+    static Gnss_Nav_Data_Store store;
+    return store;
+}
+
+
+Gnss_Nav_Data_Store::Gnss_Nav_Data_Store() : d_current(std::make_shared<Gnss_Nav_Data>()), d_version(0), d_unchanged(0)
+{}
+
+
+std::shared_ptr<const Gnss_Nav_Data> Gnss_Nav_Data_Store::snapshot() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_current;
+}
+
+
+template<typename U, typename F>
+bool Gnss_Nav_Data_Store::modify(U unchanged, F change)
+{
+    std::lock_guard<std::mutex> update_lock(d_update_mutex);
+    std::shared_ptr<const Gnss_Nav_Data> current = snapshot();
+    if (unchanged(*current))
+        {
+            d_unchanged++;
+            return false;
+        }
+    // the readers keep using the current snapshot while the copy is modified
+    std::shared_ptr<Gnss_Nav_Data> next = std::make_shared<Gnss_Nav_Data>(*current);
+    next->version++;
+    change(*next);
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_current = next;
+    }
+    d_version.store(next->version);
+    return true;
+}
+
+
+bool Gnss_Nav_Data_Store::update(const Gps_Ephemeris & ephemeris)
+{
+    return modify([&ephemeris](const Gnss_Nav_Data & data)
+            {
+                auto it = data.gps_ephemeris_map.find(ephemeris.i_satellite_PRN);
+                return it != data.gps_ephemeris_map.end() && same_issue(it->second, ephemeris);
+            },
+            [&ephemeris](Gnss_Nav_Data & data)
+            {
+                data.gps_ephemeris_map[ephemeris.i_satellite_PRN] = ephemeris;
+                data.gps_ephemeris_version[ephemeris.i_satellite_PRN] = data.version;
+            });
+}
+
+
+bool Gnss_Nav_Data_Store::update(const Gps_Iono & iono)
+{
+    return modify([&iono](const Gnss_Nav_Data & data) { return same_issue(data.gps_iono, iono); },
+            [&iono](Gnss_Nav_Data & data) { data.gps_iono = iono; });
+}
+
+
+bool Gnss_Nav_Data_Store::update(const Gps_Utc_Model & utc_model)
+{
+    return modify([&utc_model](const Gnss_Nav_Data & data) { return same_issue(data.gps_utc_model, utc_model); },
+            [&utc_model](Gnss_Nav_Data & data) { data.gps_utc_model = utc_model; });
+}
+
+
+bool Gnss_Nav_Data_Store::update(const Galileo_Ephemeris & ephemeris)
+{
+    return modify([&ephemeris](const Gnss_Nav_Data & data)
+            {
+                auto it = data.galileo_ephemeris_map.find(ephemeris.i_satellite_PRN);
+                return it != data.galileo_ephemeris_map.end() && same_issue(it->second, ephemeris);
+            },
+            [&ephemeris](Gnss_Nav_Data & data)
+            {
+                data.galileo_ephemeris_map[ephemeris.i_satellite_PRN] = ephemeris;
+                data.galileo_ephemeris_version[ephemeris.i_satellite_PRN] = data.version;
+            });
+}
+
+
+bool Gnss_Nav_Data_Store::update(const Galileo_Iono & iono)
+{
+    return modify([&iono](const Gnss_Nav_Data & data) { return same_issue(data.galileo_iono, iono); },
+            [&iono](Gnss_Nav_Data & data) { data.galileo_iono = iono; });
+}
+
+
+bool Gnss_Nav_Data_Store::update(const Galileo_Utc_Model & utc_model)
+{
+    return modify([&utc_model](const Gnss_Nav_Data & data) { return same_issue(data.galileo_utc_model, utc_model); },
+            [&utc_model](Gnss_Nav_Data & data) { data.galileo_utc_model = utc_model; });
+}
+
+
+bool Gnss_Nav_Data_Store::update(const Galileo_Almanac & almanac)
+{
+    return modify([&almanac](const Gnss_Nav_Data & data) { return same_issue(data.galileo_almanac, almanac); },
+            [&almanac](Gnss_Nav_Data & data) { data.galileo_almanac = almanac; });
+}
+
+
+bool Gnss_Nav_Data_Store::update(const Gnss_Telemetry_Payload & payload)
+{
+    switch (payload.type())
+    {
+    case Gnss_Telemetry_Payload::GPS_EPHEMERIS:
+        update(payload.data<Gps_Ephemeris>());
+        return true;
+    case Gnss_Telemetry_Payload::GPS_IONO:
+        update(payload.data<Gps_Iono>());
+        return true;
+    case Gnss_Telemetry_Payload::GPS_UTC_MODEL:
+        update(payload.data<Gps_Utc_Model>());
+        return true;
+    case Gnss_Telemetry_Payload::GALILEO_EPHEMERIS:
+        update(payload.data<Galileo_Ephemeris>());
+        return true;
+    case Gnss_Telemetry_Payload::GALILEO_IONO:
+        update(payload.data<Galileo_Iono>());
+        return true;
+    case Gnss_Telemetry_Payload::GALILEO_UTC_MODEL:
+        update(payload.data<Galileo_Utc_Model>());
+        return true;
+    case Gnss_Telemetry_Payload::GALILEO_ALMANAC:
+        update(payload.data<Galileo_Almanac>());
+        return true;
+    default:
+        return false;
+    }
+}
+
+
+bool Gnss_Nav_Data_Store::update(const boost::any & object)
+{
+    // the pooled payloads first, which most messages are
+    if (object.type() == typeid(std::shared_ptr<const Gnss_Telemetry_Payload>))
+        {
+            return update(*boost::any_cast<std::shared_ptr<const Gnss_Telemetry_Payload>>(object));
+        }
+    if (object.type() == typeid(std::shared_ptr<Gps_Ephemeris>))
+        {
+            update(*boost::any_cast<std::shared_ptr<Gps_Ephemeris>>(object));
+        }
+    else if (object.type() == typeid(std::shared_ptr<Gps_Iono>))
+        {
+            update(*boost::any_cast<std::shared_ptr<Gps_Iono>>(object));
+        }
+    else if (object.type() == typeid(std::shared_ptr<Gps_Utc_Model>))
+        {
+            update(*boost::any_cast<std::shared_ptr<Gps_Utc_Model>>(object));
+        }
+    else if (object.type() == typeid(std::shared_ptr<Galileo_Ephemeris>))
+        {
+            update(*boost::any_cast<std::shared_ptr<Galileo_Ephemeris>>(object));
+        }
+    else if (object.type() == typeid(std::shared_ptr<Galileo_Iono>))
+        {
+            update(*boost::any_cast<std::shared_ptr<Galileo_Iono>>(object));
+        }
+    else if (object.type() == typeid(std::shared_ptr<Galileo_Utc_Model>))
+        {
+            update(*boost::any_cast<std::shared_ptr<Galileo_Utc_Model>>(object));
+        }
+    else if (object.type() == typeid(std::shared_ptr<Galileo_Almanac>))
+        {
+            update(*boost::any_cast<std::shared_ptr<Galileo_Almanac>>(object));
+        }
+    else if (object.type() == typeid(std::shared_ptr<Gps_Ref_Location>))
+        {
+            // a coarse a priori position, never better than the one of the PVT
+            const Gps_Ref_Location & location = *boost::any_cast<std::shared_ptr<Gps_Ref_Location>>(object);
+            if (rx_position().version == 0)
+                {
+                    set_rx_position(location.lat, location.lon, 0.0, false, 0.0);
+                }
+        }
+    else
+        {
+            return false;
+        }
+    return true;
+}
+
+
+void Gnss_Nav_Data_Store::set_rx_position(double latitude_d, double longitude_d, double height_m,
+        bool has_time, double gps_tow_s)
+{
+    std::lock_guard<std::mutex> lock(d_position_mutex);
+    d_rx_position.latitude_d = latitude_d;
+    d_rx_position.longitude_d = longitude_d;
+    d_rx_position.height_m = height_m;
+    d_rx_position.has_time = has_time;
+    d_rx_position.gps_tow_s = gps_tow_s;
+    d_rx_position.stamp = std::chrono::steady_clock::now();
+    d_rx_position.version++;
+}
+
+
+Gnss_Rx_Position Gnss_Nav_Data_Store::rx_position() const
+{
+    std::lock_guard<std::mutex> lock(d_position_mutex);
+    return d_rx_position;
+}
+
+
+void Gnss_Nav_Data_Store::clear()
+{
+    {
+        std::lock_guard<std::mutex> lock(d_position_mutex);
+        d_rx_position = Gnss_Rx_Position();
+    }
+    std::lock_guard<std::mutex> update_lock(d_update_mutex);
+    std::shared_ptr<Gnss_Nav_Data> empty = std::make_shared<Gnss_Nav_Data>();
+    // keep the versions increasing, so that readers notice the change
+    empty->version = d_version.load() + 1;
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        d_current = empty;
+    }
+    d_version.store(empty->version);
+}
@@ -0,0 +1,187 @@
+/*!
+ * \file gnss_nav_data_store.h
+ * \brief Process-wide store of the decoded navigation data.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The telemetry decoders used to send every ephemeris, ionospheric and UTC
+ * model to the PVT block as an asynchronous message. The PVT block copied
+ * them into its own maps, and then copied the maps again for the output
+ * printers at every epoch. Now the decoders (and the assistance data)
+ * update this store, which keeps an immutable snapshot of all the
+ * navigation data. An update builds a new snapshot from the previous one
+ * and publishes it; readers take the current snapshot, a reference-counted
+ * pointer, and keep using it for as long as they need without locking or
+ * copying. Each snapshot has a version, incremented at every update, and
+ * the version at which the ephemeris of each satellite was last updated.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_NAV_DATA_STORE_H_
+#define GNSS_SDR_GNSS_NAV_DATA_STORE_H_
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <boost/any.hpp>
+#include "gps_ephemeris.h"
+#include "gps_iono.h"
+#include "gps_utc_model.h"
+#include "galileo_ephemeris.h"
+#include "galileo_iono.h"
+#include "galileo_utc_model.h"
+#include "galileo_almanac.h"
+#include "gps_ref_location.h"
+#include "gnss_telemetry_payload.h"
+
+/*!
+ * \brief Navigation data known by the receiver at a given version. Never
+ * modified once published by Gnss_Nav_Data_Store.
+ */
+class Gnss_Nav_Data
+{
+public:
+    std::map<int,Gps_Ephemeris> gps_ephemeris_map;                   //!< GPS ephemeris, by PRN
+    std::map<int,unsigned long long> gps_ephemeris_version;          //!< Version of the last update of each GPS ephemeris
+    Gps_Iono gps_iono;
+    Gps_Utc_Model gps_utc_model;
+
+    std::map<int,Galileo_Ephemeris> galileo_ephemeris_map;           //!< Galileo ephemeris, by PRN
+    std::map<int,unsigned long long> galileo_ephemeris_version;      //!< Version of the last update of each Galileo ephemeris
+    Galileo_Iono galileo_iono;
+    Galileo_Utc_Model galileo_utc_model;
+    Galileo_Almanac galileo_almanac;
+
+    unsigned long long version; //!< 0 for the empty store, incremented by each update
+
+    Gnss_Nav_Data();
+};
+
+
+/*!
+ * \brief Last known position of the receiver, from the PVT or from an
+ * assistance reference location, for the predictions of visibility.
+ */
+class Gnss_Rx_Position
+{
+public:
+    double latitude_d;   //!< WGS84 latitude [deg]
+    double longitude_d;  //!< WGS84 longitude [deg]
+    double height_m;     //!< WGS84 height [m]
+    bool has_time;       //!< A PVT solution gives the GPS time of the position
+    double gps_tow_s;    //!< GPS time of week of the position [s], if has_time
+    std::chrono::steady_clock::time_point stamp; //!< When it was set
+    unsigned long long version; //!< 0 if unknown, incremented by each update
+
+    Gnss_Rx_Position();
+};
+
+
+class Gnss_Nav_Data_Store
+{
+public:
+    //! The store shared by all the blocks of the receiver
+    static Gnss_Nav_Data_Store & instance();
+
+    Gnss_Nav_Data_Store();
+
+    //! Current navigation data. Thread safe, does not copy the data.
+    std::shared_ptr<const Gnss_Nav_Data> snapshot() const;
+
+    //! Version of the current snapshot, to check for changes without taking it
+    unsigned long long version() const
+    {
+        return d_version.load();
+    }
+
+    /*
+     * Thread safe updates. Each one publishes a new snapshot, unless the
+     * store already has the same issue of the data: same IODE, IODC and
+     * reference times for an ephemeris, same parameters for the others, as
+     * every channel decodes them each time they are broadcast. Return true
+     * if a new snapshot was published.
+     */
+    bool update(const Gps_Ephemeris & ephemeris);
+    bool update(const Gps_Iono & iono);
+    bool update(const Gps_Utc_Model & utc_model);
+    bool update(const Galileo_Ephemeris & ephemeris);
+    bool update(const Galileo_Iono & iono);
+    bool update(const Galileo_Utc_Model & utc_model);
+    bool update(const Galileo_Almanac & almanac);
+
+    //! Updates that had the data of the store already, and were not published
+    unsigned long long unchanged_updates() const
+    {
+        return d_unchanged.load();
+    }
+
+    /*!
+     * \brief Updates the store with a pooled payload of a telemetry message.
+     * Returns false (and does not update anything) for the types not kept
+     * here, such as GPS CNAV.
+     */
+    bool update(const Gnss_Telemetry_Payload & payload);
+
+    /*!
+     * \brief Updates the store with a std::shared_ptr to any of the above
+     * types or to a Gnss_Telemetry_Payload, as sent in the telemetry
+     * messages, or to a Gps_Ref_Location, which sets the position of the
+     * receiver if it had none. Returns false (and does not update anything)
+     * for other types.
+     */
+    bool update(const boost::any & object);
+
+    /*!
+     * \brief Sets the position of the receiver. It is not part of the
+     * navigation data snapshots, so it does not change their version.
+     */
+    void set_rx_position(double latitude_d, double longitude_d, double height_m,
+            bool has_time, double gps_tow_s);
+
+    //! Last position of the receiver, with version 0 if there is none
+    Gnss_Rx_Position rx_position() const;
+
+    //! Forgets all the navigation data and the position, e.g., before starting a new receiver
+    void clear();
+
+private:
+    // Unless the current snapshot is unchanged() already, copies it, applies
+    // change to the copy and publishes it
+    template<typename U, typename F>
+    bool modify(U unchanged, F change);
+
+    mutable std::mutex d_mutex;  // guards the d_current pointer only
+    std::shared_ptr<const Gnss_Nav_Data> d_current;
+    std::mutex d_update_mutex;   // serializes the updates
+    std::atomic<unsigned long long> d_version;
+    std::atomic<unsigned long long> d_unchanged;
+
+    mutable std::mutex d_position_mutex;
+    Gnss_Rx_Position d_rx_position;
+};
+
+#endif
@@ -0,0 +1,217 @@
+/*!
+ * \file gnss_packed_bits.h
+ * \brief Navigation message bits packed in 32-bit words, and the field
+ *  descriptors used to extract the message parameters from them.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The bits of a navigation message are numbered as in the ICDs: bit 1 is the
+ * first one transmitted. A parameter is described by a Gnss_Bit_Field, a
+ * constant aggregate made of up to GNSS_BIT_FIELD_MAX_SLICES slices that are
+ * concatenated MSB first, so the field tables of the system parameter
+ * headers are built at compile time. Gnss_Packed_Bits stores the message in
+ * a fixed array of words, MSB first, and reads each slice with a couple of
+ * shifts instead of bit by bit, without allocating or copying the message.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_PACKED_BITS_H_
+#define GNSS_SDR_GNSS_PACKED_BITS_H_
+
+#include <cstdint>
+
+//! Largest number of slices of a navigation message field
+#define GNSS_BIT_FIELD_MAX_SLICES 2
+
+//! Consecutive bits of a navigation message field
+struct Gnss_Bit_Slice
+{
+    int first;   //!< Position of the MSB, the first message bit being 1
+    int length;  //!< Number of bits
+};
+
+/*!
+ * \brief Navigation message field. Unused slices have zero length, e.g.
+ * constexpr Gnss_Bit_Field TOW = {{ {31,17} }};
+ */
+struct Gnss_Bit_Field
+{
+    Gnss_Bit_Slice slices[GNSS_BIT_FIELD_MAX_SLICES];
+};
+
+
+/*!
+ * \brief Navigation message of N_BITS bits packed in 32-bit words
+ */
+template<int N_BITS>
+class Gnss_Packed_Bits
+{
+public:
+    Gnss_Packed_Bits()
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        for (int i = 0; i < d_n_words; i++)
+            {
+                d_words[i] = 0;
+            }
+    }
+
+    void set_bit(int position, bool value)
+    {
+        const uint32_t mask = 0x80000000u >> ((position - 1) & 31);
+        if (value)
+            {
+                d_words[(position - 1) >> 5] |= mask;
+            }
+        else
+            {
+                d_words[(position - 1) >> 5] &= ~mask;
+            }
+    }
+
+    //! Writes the length LSBs of value from position first on, MSB first
+    void set_bits(int first, int length, uint32_t value)
+    {
+        for (int j = 0; j < length; j++)
+            {
+                set_bit(first + j, (value >> (length - j - 1)) & 1);
+            }
+    }
+
+    //! Writes n_bits characters '0' / '1' from position first on
+    void set_bits(int first, const char* bits, int n_bits)
+    {
+        for (int j = 0; j < n_bits; j++)
+            {
+                set_bit(first + j, bits[j] == '1');
+            }
+    }
+
+    //! Writes the LSBs of value into the slices of field, MSB first
+    void set_field(const Gnss_Bit_Field& field, uint64_t value)
+    {
+        int length = 0;
+        for (int i = 0; i < GNSS_BIT_FIELD_MAX_SLICES && field.slices[i].length > 0; i++)
+            {
+                length += field.slices[i].length;
+            }
+        for (int i = 0; i < GNSS_BIT_FIELD_MAX_SLICES && field.slices[i].length > 0; i++)
+            {
+                length -= field.slices[i].length;
+                set_bits(field.slices[i].first, field.slices[i].length, static_cast<uint32_t>(value >> length));
+            }
+    }
+
+    bool read_bit(int position) const
+    {
+        return (d_words[(position - 1) >> 5] >> (31 - ((position - 1) & 31))) & 1;
+    }
+
+    //! Reads up to 64 bits from position first on, MSB first
+    uint64_t read_bits(int first, int length) const
+    {
+        uint64_t value = 0;
+        while (length > 0)
+            {
+                const int chunk = length < 32 ? length : 32;
+                value = (value << chunk) | read_chunk(first, chunk);
+                first += chunk;
+                length -= chunk;
+            }
+        return value;
+    }
+
+    unsigned long int read_unsigned(const Gnss_Bit_Field& field) const
+    {
+        uint64_t value = 0;
+        for (int i = 0; i < GNSS_BIT_FIELD_MAX_SLICES && field.slices[i].length > 0; i++)
+            {
+                value = (value << field.slices[i].length) | read_bits(field.slices[i].first, field.slices[i].length);
+            }
+        return static_cast<unsigned long int>(value);
+    }
+
+    //! Two's complement field, sign extended from its first bit
+    signed long int read_signed(const Gnss_Bit_Field& field) const
+    {
+        uint64_t value = 0;
+        int length = 0;
+        for (int i = 0; i < GNSS_BIT_FIELD_MAX_SLICES && field.slices[i].length > 0; i++)
+            {
+                value = (value << field.slices[i].length) | read_bits(field.slices[i].first, field.slices[i].length);
+                length += field.slices[i].length;
+            }
+        if (length < 64 && read_bit(field.slices[0].first))
+            {
+                value |= ~static_cast<uint64_t>(0) << length;
+            }
+        return static_cast<signed long int>(static_cast<int64_t>(value));
+    }
+
+    bool read_bool(const Gnss_Bit_Field& field) const
+    {
+        return read_bit(field.slices[0].first);
+    }
+
+    /*!
+     * \brief Writes the message as a big-endian number of (N_BITS + 7) / 8
+     * bytes, zero padded at the start, as needed by the CRC computation of
+     * messages that are not a whole number of bytes.
+     */
+    void to_bytes(unsigned char* bytes) const
+    {
+        const int pad = 8 * ((N_BITS + 7) / 8) - N_BITS;
+        int first = 1;
+        for (int k = 0; k < (N_BITS + 7) / 8; k++)
+            {
+                const int length = (k == 0) ? 8 - pad : 8;
+                bytes[k] = static_cast<unsigned char>(read_chunk(first, length));
+                first += length;
+            }
+    }
+
+private:
+    static const int d_n_words = (N_BITS + 31) / 32;
+    uint32_t d_words[(N_BITS + 31) / 32];
+
+    // 1 to 32 bits, possibly across two words
+    uint32_t read_chunk(int first, int length) const
+    {
+        const int word = (first - 1) >> 5;
+        const int shift = (first - 1) & 31;
+        uint64_t window = static_cast<uint64_t>(d_words[word]) << 32;
+        if (shift + length > 32)
+            {
+                window |= d_words[word + 1];
+            }
+        return static_cast<uint32_t>((window << shift) >> (64 - length));
+    }
+};
+
+#endif /* GNSS_SDR_GNSS_PACKED_BITS_H_ */
@@ -0,0 +1,296 @@
+/*!
+ * \file gnss_receiver_state.cc
+ * \brief State of the receiver kept from one run to the next, for warm starts
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_receiver_state.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <boost/archive/xml_iarchive.hpp>
+#include <boost/archive/xml_oarchive.hpp>
+#include <glog/logging.h>
+#include "gnss_binary_archive.h"
+
+using google::LogMessage;
+
+namespace
+{
+double system_time_s()
+{
+    return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+
+// from the reference time of an ephemeris to gps_time_s, with the week of
+// the navigation message, known modulo 1024 weeks [s]
+double ephemeris_age_s(double week, double toe, double gps_time_s)
+{
+    const double cycle_s = 1024.0 * 604800.0;
+    double age = std::fmod(gps_time_s - (std::fmod(week, 1024.0) * 604800.0 + toe), cycle_s);
+    if (age > cycle_s / 2.0) age -= cycle_s;
+    if (age < -cycle_s / 2.0) age += cycle_s;
+    return age;
+}
+}
+
+
+Gnss_Receiver_State::Gnss_Receiver_State() :
+        has_position(false), latitude_d(0.0), longitude_d(0.0), height_m(0.0),
+        has_time(false), gps_tow_s(0.0), saved_at_s(0.0), signal_time_s(-1.0)
+{}
+
+
+void Gnss_Receiver_State::capture(const Gnss_Nav_Data_Store & store)
+{
+    std::shared_ptr<const Gnss_Nav_Data> nav = store.snapshot();
+    gps_ephemeris_map = nav->gps_ephemeris_map;
+    gps_iono = nav->gps_iono;
+    gps_utc_model = nav->gps_utc_model;
+    galileo_ephemeris_map = nav->galileo_ephemeris_map;
+
+    const Gnss_Rx_Position position = store.rx_position();
+    has_position = position.version != 0;
+    latitude_d = position.latitude_d;
+    longitude_d = position.longitude_d;
+    height_m = position.height_m;
+    has_time = position.has_time;
+    gps_tow_s = position.gps_tow_s;
+    saved_at_s = system_time_s();
+}
+
+
+double Gnss_Receiver_State::age_s() const
+{
+    return system_time_s() - saved_at_s;
+}
+
+
+unsigned int Gnss_Receiver_State::restore(Gnss_Nav_Data_Store & store, double max_age_s) const
+{
+    if (has_position)
+        {
+            // without the time of the PVT, the predictions take the system clock
+            store.set_rx_position(latitude_d, longitude_d, height_m, false, 0.0);
+        }
+    if (gps_iono.valid)
+        {
+            store.update(gps_iono);
+        }
+    if (gps_utc_model.valid)
+        {
+            store.update(gps_utc_model);
+        }
+
+    // the ephemeris by their own age, as a state saved by a warm started
+    // receiver may hold the ones it restored at its start
+    const double leap_s = gps_utc_model.valid ? gps_utc_model.d_DeltaT_LS : 17.0;
+    const double gps_time_s = system_time_s() - 315964800.0 + leap_s;  // the GPS epoch is 6 January 1980
+    unsigned int restored = 0;
+    for (std::map<int,Gps_Ephemeris>::const_iterator it = gps_ephemeris_map.begin(); it != gps_ephemeris_map.end(); ++it)
+        {
+            if (std::fabs(ephemeris_age_s(it->second.i_GPS_week, it->second.d_Toe, gps_time_s)) <= max_age_s)
+                {
+                    store.update(it->second);
+                    restored++;
+                }
+        }
+    for (std::map<int,Galileo_Ephemeris>::const_iterator it = galileo_ephemeris_map.begin(); it != galileo_ephemeris_map.end(); ++it)
+        {
+            // the Galileo week starts 1024 GPS weeks later
+            if (std::fabs(ephemeris_age_s(it->second.WN_5, it->second.t0e_1, gps_time_s)) <= max_age_s)
+                {
+                    store.update(it->second);
+                    restored++;
+                }
+        }
+    LOG(INFO) << restored << " of the " << gps_ephemeris_map.size() + galileo_ephemeris_map.size()
+              << " ephemeris of the receiver state restored";
+    return restored;
+}
+
+
+unsigned int Gnss_Receiver_State::restore_checkpoint(Gnss_Nav_Data_Store & store) const
+{
+    if (has_position)
+        {
+            store.set_rx_position(latitude_d, longitude_d, height_m, has_time, gps_tow_s);
+        }
+    if (gps_iono.valid)
+        {
+            store.update(gps_iono);
+        }
+    if (gps_utc_model.valid)
+        {
+            store.update(gps_utc_model);
+        }
+    for (std::map<int,Gps_Ephemeris>::const_iterator it = gps_ephemeris_map.begin(); it != gps_ephemeris_map.end(); ++it)
+        {
+            store.update(it->second);
+        }
+    for (std::map<int,Galileo_Ephemeris>::const_iterator it = galileo_ephemeris_map.begin(); it != galileo_ephemeris_map.end(); ++it)
+        {
+            store.update(it->second);
+        }
+    return gps_ephemeris_map.size() + galileo_ephemeris_map.size();
+}
+
+
+bool Gnss_Receiver_State::save_xml(const std::string & file_name) const
+{
+    const std::string tmp_file_name = file_name + ".tmp";
+    try
+    {
+            std::ofstream ofs(tmp_file_name.c_str(), std::ofstream::trunc | std::ofstream::out);
+            {
+                // the archive is complete when it is destroyed
+                boost::archive::xml_oarchive xml(ofs);
+                xml << boost::serialization::make_nvp("GNSS-SDR_receiver_state", *this);
+            }
+            ofs.close();
+            if (!ofs)
+                {
+                    LOG(WARNING) << "Failed to write the receiver state to " << tmp_file_name;
+                    return false;
+                }
+    }
+    catch (std::exception& e)
+    {
+            LOG(WARNING) << e.what() << " File: " << tmp_file_name;
+            return false;
+    }
+    if (std::rename(tmp_file_name.c_str(), file_name.c_str()) != 0)
+        {
+            LOG(WARNING) << "Failed to rename " << tmp_file_name << " to " << file_name;
+            return false;
+        }
+    DLOG(INFO) << "Saved the receiver state with " << gps_ephemeris_map.size() << " GPS and "
+               << galileo_ephemeris_map.size() << " Galileo ephemeris";
+    return true;
+}
+
+
+bool Gnss_Receiver_State::load_xml(const std::string & file_name)
+{
+    try
+    {
+            std::ifstream ifs(file_name.c_str(), std::ifstream::binary | std::ifstream::in);
+            if (!ifs.is_open())
+                {
+                    return false;
+                }
+            {
+                // the archive reads its end when it is destroyed, before closing the file
+                boost::archive::xml_iarchive xml(ifs);
+                xml >> boost::serialization::make_nvp("GNSS-SDR_receiver_state", *this);
+            }
+            ifs.close();
+    }
+    catch (std::exception& e)
+    {
+            LOG(WARNING) << e.what() << " File: " << file_name;
+            *this = Gnss_Receiver_State();
+            return false;
+    }
+    LOG(INFO) << "Loaded the receiver state with " << gps_ephemeris_map.size() << " GPS and "
+              << galileo_ephemeris_map.size() << " Galileo ephemeris, " << age_s() << " s old";
+    return true;
+}
+
+
+bool Gnss_Receiver_State::save_binary(const std::string & file_name) const
+{
+    if (!Gnss_Binary_Archive::save(file_name, "receiver_state", *this))
+        {
+            return false;
+        }
+    DLOG(INFO) << "Saved the receiver state with " << gps_ephemeris_map.size() << " GPS and "
+               << galileo_ephemeris_map.size() << " Galileo ephemeris";
+    return true;
+}
+
+
+bool Gnss_Receiver_State::load_binary(const std::string & file_name)
+{
+    if (!Gnss_Binary_Archive::load(file_name, "receiver_state", *this))
+        {
+            *this = Gnss_Receiver_State();
+            return false;
+        }
+    LOG(INFO) << "Loaded the receiver state with " << gps_ephemeris_map.size() << " GPS and "
+              << galileo_ephemeris_map.size() << " Galileo ephemeris, " << age_s() << " s old";
+    return true;
+}
+
+
+bool Gnss_Receiver_State::load(const std::string & file_name)
+{
+    if (Gnss_Binary_Archive::is_binary(file_name))
+        {
+            return load_binary(file_name);
+        }
+    return load_xml(file_name);
+}
+
+
+bool Gnss_Receiver_State::add_checkpoint(const std::string & index_file_name, double signal_time_s, const std::string & file_name)
+{
+    std::ofstream index(index_file_name.c_str(), std::ofstream::app | std::ofstream::out);
+    index << std::setprecision(17) << signal_time_s << " " << file_name << std::endl;
+    return static_cast<bool>(index);
+}
+
+
+bool Gnss_Receiver_State::find_checkpoint(const std::string & index_file_name, double signal_time_s, std::string & file_name)
+{
+    std::ifstream index(index_file_name.c_str());
+    double best_s = -1.0;
+    std::string line;
+    // a run that resumed an earlier checkpoint appends the later ones again
+    while (std::getline(index, line))
+        {
+            std::istringstream fields(line);
+            double time_s;
+            if (!(fields >> time_s) || fields.get() != ' ')
+                {
+                    continue;
+                }
+            std::string name;
+            std::getline(fields, name);
+            if (!name.empty() && time_s <= signal_time_s && time_s >= best_s)
+                {
+                    best_s = time_s;
+                    file_name = name;
+                }
+        }
+    return best_s >= 0.0;
+}
@@ -0,0 +1,183 @@
+/*!
+ * \file gnss_receiver_state.h
+ * \brief State of the receiver kept from one run to the next, for warm starts
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The control thread captures the navigation data and the position of
+ * Gnss_Nav_Data_Store periodically and at the end of the run, and saves them
+ * to an XML file with the boost serialization of the SUPL assistance files.
+ * At the next start they are put back into the store, where the satellite
+ * scheduler and the PVT find them as if they had just been decoded.
+ *
+ * The same state, with the position in the capture and the satellites
+ * tracked at that point, makes the checkpoints of a post-processing run,
+ * from which a later run resumes the capture.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_RECEIVER_STATE_H_
+#define GNSS_SDR_GNSS_RECEIVER_STATE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/version.hpp>
+#include "gnss_nav_data_store.h"
+
+/*!
+ * \brief An L1 C/A or E1 satellite tracked at a checkpoint
+ */
+class Gnss_Receiver_State_Satellite
+{
+public:
+    char system;               //!< 'G' or 'E'
+    unsigned int prn;
+    double doppler_hz;
+    double doppler_rate_hz_s;
+    double time_s;             //!< Last tracked epoch, from the start of the capture [s]
+
+    Gnss_Receiver_State_Satellite() :
+            system('G'), prn(0), doppler_hz(0.0), doppler_rate_hz_s(0.0), time_s(0.0)
+    {}
+
+    template<class Archive>
+    void serialize(Archive& archive, const unsigned int version)
+    {
+        using boost::serialization::make_nvp;
+        if(version){};
+        archive & make_nvp("system", system);
+        archive & make_nvp("prn", prn);
+        archive & make_nvp("doppler_hz", doppler_hz);
+        archive & make_nvp("doppler_rate_hz_s", doppler_rate_hz_s);
+        archive & make_nvp("time_s", time_s);
+    }
+};
+
+
+class Gnss_Receiver_State
+{
+public:
+    std::map<int,Gps_Ephemeris> gps_ephemeris_map;
+    Gps_Iono gps_iono;
+    Gps_Utc_Model gps_utc_model;
+    std::map<int,Galileo_Ephemeris> galileo_ephemeris_map;
+
+    bool has_position;   //!< The store had a position of the receiver
+    double latitude_d;   //!< WGS84 latitude [deg]
+    double longitude_d;  //!< WGS84 longitude [deg]
+    double height_m;     //!< WGS84 height [m]
+
+    bool has_time;       //!< A PVT solution gave the GPS time of the position
+    double gps_tow_s;    //!< GPS time of week of the position [s], if has_time
+
+    double saved_at_s;   //!< System time of the capture, seconds since 1 January 1970
+
+    double signal_time_s;  //!< Checkpoints: samples of the capture processed, in [s]; negative otherwise
+    std::vector<Gnss_Receiver_State_Satellite> satellites;  //!< Checkpoints: satellites tracked
+
+    Gnss_Receiver_State();
+
+    //! Takes the current navigation data and position of \p store
+    void capture(const Gnss_Nav_Data_Store & store);
+
+    /*!
+     * \brief Puts the state back into \p store: the position, the iono and
+     * UTC models and the ephemeris with a reference time less than
+     * \p max_age_s seconds away from the time of the system clock. Returns
+     * the number of ephemeris restored.
+     */
+    unsigned int restore(Gnss_Nav_Data_Store & store, double max_age_s) const;
+
+    /*!
+     * \brief Puts a checkpoint back into \p store: all its ephemeris, which
+     * were in use at that point of the capture whatever the system clock
+     * says, and the position with its time. Returns the number of ephemeris.
+     */
+    unsigned int restore_checkpoint(Gnss_Nav_Data_Store & store) const;
+
+    //! Age of the state [s]
+    double age_s() const;
+
+    /*!
+     * \brief Writes the state to \p file_name. It is written to a temporary
+     * file first and then renamed, so that a crash does not leave half a state.
+     */
+    bool save_xml(const std::string & file_name) const;
+
+    bool load_xml(const std::string & file_name);
+
+    //! Same as save_xml(), in the binary format of Gnss_Binary_Archive, faster to load
+    bool save_binary(const std::string & file_name) const;
+
+    bool load_binary(const std::string & file_name);
+
+    //! Loads \p file_name, in either format
+    bool load(const std::string & file_name);
+
+    /*!
+     * \brief Appends a checkpoint at \p signal_time_s in the capture, saved
+     * to \p file_name, to the index \p index_file_name, a text file with one
+     * line per checkpoint.
+     */
+    static bool add_checkpoint(const std::string & index_file_name, double signal_time_s, const std::string & file_name);
+
+    /*!
+     * \brief Finds in \p index_file_name the last checkpoint at or before
+     * \p signal_time_s in the capture. Returns false if there is none.
+     */
+    static bool find_checkpoint(const std::string & index_file_name, double signal_time_s, std::string & file_name);
+
+    template<class Archive>
+    void serialize(Archive& archive, const unsigned int version)
+    {
+        using boost::serialization::make_nvp;
+        if(version){};
+        archive & make_nvp("saved_at_s", saved_at_s);
+        archive & make_nvp("has_position", has_position);
+        archive & make_nvp("latitude_d", latitude_d);
+        archive & make_nvp("longitude_d", longitude_d);
+        archive & make_nvp("height_m", height_m);
+        archive & make_nvp("gps_ephemeris_map", gps_ephemeris_map);
+        archive & make_nvp("gps_iono", gps_iono);
+        archive & make_nvp("gps_utc_model", gps_utc_model);
+        archive & make_nvp("galileo_ephemeris_map", galileo_ephemeris_map);
+        if (version > 0)
+            {
+                archive & make_nvp("has_time", has_time);
+                archive & make_nvp("gps_tow_s", gps_tow_s);
+                archive & make_nvp("signal_time_s", signal_time_s);
+                archive & make_nvp("satellites", satellites);
+            }
+    }
+};
+
+// version 1 adds the time of the position and the checkpoint fields
+BOOST_CLASS_VERSION(Gnss_Receiver_State, 1)
+
+#endif
@@ -31,12 +31,31 @@
 #ifndef GNSS_SDR_GNSS_SYNCHRO_H_
 #define GNSS_SDR_GNSS_SYNCHRO_H_
 
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include "gnss_signal.h"
 
+//! Fixed-point units of the sample stamp per sample
+#define GNSS_SYNCHRO_STAMP_ONE 65536
+
 
 /*!
  * \brief This is the class that contains the information that is shared
  * by the processing blocks.
+ *
+ * It is the item type of the streams from tracking to PVT, copied at every
+ * stage, so the fields are grouped by use and ordered to avoid padding: the
+ * satellite info, the flags and the tracking, telemetry and pseudorange
+ * measurements fill the first two cache lines. The acquisition results go
+ * last; they reach tracking through the Gnss_Synchro object shared by the
+ * channel blocks, and the stream path downstream of tracking never reads them.
+ *
+ * The canonical time of a measurement is its sample stamp: the sample
+ * counter of the PRN start plus a fraction of a sample in 1 /
+ * GNSS_SYNCHRO_STAMP_ONE units. Stamps of different channels are compared
+ * and subtracted exactly, at any time since the start of the run, and
+ * Tracking_timestamp_secs is derived from them.
  */
 class  Gnss_Synchro
 {
@@ -46,11 +65,16 @@ public:
     char Signal[3];   //!< Set by Channel::set_signal(Gnss_Signal gnss_signal)
     unsigned int PRN; //!< Set by Channel::set_signal(Gnss_Signal gnss_signal)
     int Channel_ID;   //!< Set by Channel constructor
-    // Acquisition
-    double Acq_delay_samples;                  //!< Set by Acquisition processing block
-    double Acq_doppler_hz;                     //!< Set by Acquisition processing block
-    unsigned long int Acq_samplestamp_samples; //!< Set by Acquisition processing block
-    bool Flag_valid_acquisition; //!< Set by Acquisition processing block
+    int correlation_length_ms; //!< Set by Tracking processing block
+
+    // Flags
+    bool Flag_valid_symbol_output; //!< Set by Tracking processing block
+    bool Flag_valid_word;          //!< Set by Telemetry Decoder processing block
+    bool Flag_preamble;            //!< Set by Telemetry Decoder processing block
+    bool Flag_valid_pseudorange;   //!< Set by Observables processing block
+    bool Flag_valid_acquisition;   //!< Set by Acquisition processing block
+    uint16_t Tracking_sample_fraction; //!< Set by Tracking processing block, fraction of Tracking_sample_counter
+
     //Tracking
     double Prompt_I;                //!< Set by Tracking processing block
     double Prompt_Q;                //!< Set by Tracking processing block
@@ -59,24 +83,64 @@ public:
     double Carrier_phase_rads;      //!< Set by Tracking processing block
     double Code_phase_secs;         //!< Set by Tracking processing block
     double Tracking_timestamp_secs; //!< Set by Tracking processing block
-
-    bool Flag_valid_symbol_output; //!< Set by Tracking processing block
-    int correlation_length_ms; //!< Set by Tracking processing block
+    uint64_t Tracking_sample_counter; //!< Set by Tracking processing block, integer part of the sample stamp
 
     //Telemetry Decoder
     double Prn_timestamp_ms;             //!< Set by Telemetry Decoder processing block
-    double Prn_timestamp_at_preamble_ms; //!< Set by Telemetry Decoder processing block
-
-    bool Flag_valid_word;   //!< Set by Telemetry Decoder processing block
-    bool Flag_preamble;     //!< Set by Telemetry Decoder processing block
     double d_TOW;           //!< Set by Telemetry Decoder processing block
     double d_TOW_at_current_symbol;
     double d_TOW_hybrid_at_current_symbol; //Galileo TOW is expressed in the GPS time scale (it will be the same for any other constellation)
 
     // Pseudorange
     double Pseudorange_m;
-    bool Flag_valid_pseudorange;
+
+    // Acquisition
+    double Acq_delay_samples;                  //!< Set by Acquisition processing block
+    double Acq_doppler_hz;                     //!< Set by Acquisition processing block
+    unsigned long int Acq_samplestamp_samples; //!< Set by Acquisition processing block
+
+    /*!
+     * \brief Sets the sample stamp to sample_counter + offset_samples, and
+     * Tracking_timestamp_secs to the stamp over the sample rate fs_hz
+     */
+    void set_sample_stamp(uint64_t sample_counter, double offset_samples, double fs_hz)
+    {
+        const double whole = std::floor(offset_samples);
+        double fraction = std::round((offset_samples - whole) * GNSS_SYNCHRO_STAMP_ONE);
+        uint64_t counter = sample_counter + static_cast<int64_t>(whole);
+        if (fraction >= GNSS_SYNCHRO_STAMP_ONE)
+            {
+                fraction -= GNSS_SYNCHRO_STAMP_ONE;
+                counter++;
+            }
+        Tracking_sample_counter = counter;
+        Tracking_sample_fraction = static_cast<uint16_t>(fraction);
+        Tracking_timestamp_secs = (static_cast<double>(counter) + fraction / GNSS_SYNCHRO_STAMP_ONE) / fs_hz;
+    }
+
+    //! False if the tracking block did not set the sample stamp
+    bool has_sample_stamp() const
+    {
+        return Tracking_sample_counter != 0 || Tracking_sample_fraction != 0;
+    }
+
+    //! Sample stamp of this measurement minus that of other [1 / GNSS_SYNCHRO_STAMP_ONE samples]
+    int64_t sample_stamp_difference(const Gnss_Synchro & other) const
+    {
+        return sample_stamp_difference(Tracking_sample_counter, Tracking_sample_fraction,
+                other.Tracking_sample_counter, other.Tracking_sample_fraction);
+    }
+
+    //! Sample stamp a minus sample stamp b [1 / GNSS_SYNCHRO_STAMP_ONE samples]
+    static int64_t sample_stamp_difference(uint64_t counter_a, uint16_t fraction_a, uint64_t counter_b, uint16_t fraction_b)
+    {
+        return static_cast<int64_t>(counter_a - counter_b) * GNSS_SYNCHRO_STAMP_ONE
+                + (static_cast<int64_t>(fraction_a) - static_cast<int64_t>(fraction_b));
+    }
 };
 
-#endif
+// the fields used downstream of tracking span two 64-byte cache lines
+static_assert(offsetof(Gnss_Synchro, Pseudorange_m) + sizeof(double) <= 128,
+        "The stream fields of Gnss_Synchro do not fit in two cache lines");
 
+#endif
@@ -0,0 +1,156 @@
+/*!
+ * \file gnss_telemetry_payload.h
+ * \brief Reusable payloads of the telemetry messages, tagged with their type
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * A telemetry message used to carry a std::shared_ptr to a new copy of the
+ * navigation data, which the receivers told apart by comparing the
+ * type_info of the message with every type they know. A payload of a pool
+ * is reused as soon as the receivers released it, and its tag selects the
+ * type with a single switch.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GNSS_TELEMETRY_PAYLOAD_H_
+#define GNSS_SDR_GNSS_TELEMETRY_PAYLOAD_H_
+
+#include <memory>
+#include <vector>
+
+class Gps_Ephemeris;
+class Gps_Iono;
+class Gps_Utc_Model;
+class Gps_CNAV_Ephemeris;
+class Gps_CNAV_Iono;
+class Galileo_Ephemeris;
+class Galileo_Iono;
+class Galileo_Utc_Model;
+class Galileo_Almanac;
+
+/*!
+ * \brief Navigation data sent in a telemetry message, as
+ * pmt::make_any(std::shared_ptr<const Gnss_Telemetry_Payload>)
+ */
+class Gnss_Telemetry_Payload
+{
+public:
+    enum Type
+    {
+        GPS_EPHEMERIS,
+        GPS_IONO,
+        GPS_UTC_MODEL,
+        GPS_CNAV_EPHEMERIS,
+        GPS_CNAV_IONO,
+        GALILEO_EPHEMERIS,
+        GALILEO_IONO,
+        GALILEO_UTC_MODEL,
+        GALILEO_ALMANAC
+    };
+
+    explicit Gnss_Telemetry_Payload(Type type) : d_type(type) {}
+    virtual ~Gnss_Telemetry_Payload() {}
+
+    Type type() const
+    {
+        return d_type;
+    }
+
+    //! The data, whose type T must be the one of type()
+    template<typename T>
+    const T & data() const;
+
+private:
+    Type d_type;
+};
+
+
+//! Tag of each type of navigation data
+template<typename T> struct Gnss_Telemetry_Type;
+template<> struct Gnss_Telemetry_Type<Gps_Ephemeris> { static const Gnss_Telemetry_Payload::Type value = Gnss_Telemetry_Payload::GPS_EPHEMERIS; };
+template<> struct Gnss_Telemetry_Type<Gps_Iono> { static const Gnss_Telemetry_Payload::Type value = Gnss_Telemetry_Payload::GPS_IONO; };
+template<> struct Gnss_Telemetry_Type<Gps_Utc_Model> { static const Gnss_Telemetry_Payload::Type value = Gnss_Telemetry_Payload::GPS_UTC_MODEL; };
+template<> struct Gnss_Telemetry_Type<Gps_CNAV_Ephemeris> { static const Gnss_Telemetry_Payload::Type value = Gnss_Telemetry_Payload::GPS_CNAV_EPHEMERIS; };
+template<> struct Gnss_Telemetry_Type<Gps_CNAV_Iono> { static const Gnss_Telemetry_Payload::Type value = Gnss_Telemetry_Payload::GPS_CNAV_IONO; };
+template<> struct Gnss_Telemetry_Type<Galileo_Ephemeris> { static const Gnss_Telemetry_Payload::Type value = Gnss_Telemetry_Payload::GALILEO_EPHEMERIS; };
+template<> struct Gnss_Telemetry_Type<Galileo_Iono> { static const Gnss_Telemetry_Payload::Type value = Gnss_Telemetry_Payload::GALILEO_IONO; };
+template<> struct Gnss_Telemetry_Type<Galileo_Utc_Model> { static const Gnss_Telemetry_Payload::Type value = Gnss_Telemetry_Payload::GALILEO_UTC_MODEL; };
+template<> struct Gnss_Telemetry_Type<Galileo_Almanac> { static const Gnss_Telemetry_Payload::Type value = Gnss_Telemetry_Payload::GALILEO_ALMANAC; };
+
+
+template<typename T>
+class Gnss_Telemetry_Payload_Of : public Gnss_Telemetry_Payload
+{
+public:
+    Gnss_Telemetry_Payload_Of() : Gnss_Telemetry_Payload(Gnss_Telemetry_Type<T>::value) {}
+    T data;
+};
+
+
+template<typename T>
+const T & Gnss_Telemetry_Payload::data() const
+{
+    return static_cast<const Gnss_Telemetry_Payload_Of<T> &>(*this).data;
+}
+
+
+/*!
+ * \brief Payloads of one type, owned by a single sender.
+ *
+ * A payload is reused once the pool holds its only reference, i.e. when
+ * every message that carried it has been handled, so a sender that is not
+ * outpaced by its receivers allocates none after the first messages.
+ */
+template<typename T>
+class Gnss_Telemetry_Pool
+{
+public:
+    //! A payload holding a copy of \p data
+    std::shared_ptr<const Gnss_Telemetry_Payload> make(const T & data)
+    {
+        for (unsigned int i = 0; i < d_payloads.size(); i++)
+            {
+                if (d_payloads[i].use_count() == 1)
+                    {
+                        d_payloads[i]->data = data;
+                        return d_payloads[i];
+                    }
+            }
+        d_payloads.push_back(std::make_shared<Gnss_Telemetry_Payload_Of<T>>());
+        d_payloads.back()->data = data;
+        return d_payloads.back();
+    }
+
+    //! Payloads allocated so far
+    unsigned int size() const
+    {
+        return d_payloads.size();
+    }
+
+private:
+    std::vector<std::shared_ptr<Gnss_Telemetry_Payload_Of<T>>> d_payloads;
+};
+
+#endif /*GNSS_SDR_GNSS_TELEMETRY_PAYLOAD_H_*/
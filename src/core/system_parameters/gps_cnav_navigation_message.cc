@@ -79,118 +79,31 @@ void Gps_CNAV_Navigation_Message::print_gps_word_bytes(unsigned int GPS_word)
 }
 
 
-bool Gps_CNAV_Navigation_Message::read_navigation_bool(std::bitset<GPS_L2_CNAV_DATA_PAGE_BITS> bits, const std::vector<std::pair<int,int>> parameter)
+bool Gps_CNAV_Navigation_Message::read_navigation_bool(const Gnss_Packed_Bits<GPS_L2_CNAV_DATA_PAGE_BITS>& bits, const Gnss_Bit_Field& parameter)
 {
-    bool value;
-
-    if (bits[GPS_L2_CNAV_DATA_PAGE_BITS - parameter[0].first] == 1)
-        {
-            value = true;
-        }
-    else
-        {
-            value = false;
-        }
-    return value;
+    return bits.read_bool(parameter);
 }
 
 
-unsigned long int Gps_CNAV_Navigation_Message::read_navigation_unsigned(std::bitset<GPS_L2_CNAV_DATA_PAGE_BITS> bits, const std::vector<std::pair<int,int>> parameter)
+unsigned long int Gps_CNAV_Navigation_Message::read_navigation_unsigned(const Gnss_Packed_Bits<GPS_L2_CNAV_DATA_PAGE_BITS>& bits, const Gnss_Bit_Field& parameter)
 {
-    unsigned long int value = 0;
-    int num_of_slices = parameter.size();
-    for (int i = 0; i < num_of_slices; i++)
-        {
-            for (int j = 0; j < parameter[i].second; j++)
-                {
-                    value <<= 1; //shift left
-                    if (bits[GPS_L2_CNAV_DATA_PAGE_BITS - parameter[i].first - j] == 1)
-                        {
-                            value += 1; // insert the bit
-                        }
-                }
-        }
-    return value;
+    return bits.read_unsigned(parameter);
 }
 
 
-signed long int Gps_CNAV_Navigation_Message::read_navigation_signed(std::bitset<GPS_L2_CNAV_DATA_PAGE_BITS> bits, const std::vector<std::pair<int,int>> parameter)
+signed long int Gps_CNAV_Navigation_Message::read_navigation_signed(const Gnss_Packed_Bits<GPS_L2_CNAV_DATA_PAGE_BITS>& bits, const Gnss_Bit_Field& parameter)
 {
-    signed long int value = 0;
-    int num_of_slices = parameter.size();
-    // Discriminate between 64 bits and 32 bits compiler
-    int long_int_size_bytes = sizeof(signed long int);
-    if (long_int_size_bytes == 8) // if a long int takes 8 bytes, we are in a 64 bits system
-        {
-            // read the MSB and perform the sign extension
-            if (bits[GPS_L2_CNAV_DATA_PAGE_BITS - parameter[0].first] == 1)
-                {
-                    value ^= 0xFFFFFFFFFFFFFFFF; //64 bits variable
-                }
-            else
-                {
-                    value &= 0;
-                }
-
-            for (int i = 0; i < num_of_slices; i++)
-                {
-                    for (int j = 0; j < parameter[i].second; j++)
-                        {
-                            value <<= 1; //shift left
-                            value &= 0xFFFFFFFFFFFFFFFE; //reset the corresponding bit (for the 64 bits variable)
-                            if (bits[GPS_L2_CNAV_DATA_PAGE_BITS - parameter[i].first - j] == 1)
-                                {
-                                    value += 1; // insert the bit
-                                }
-                        }
-                }
-        }
-    else  // we assume we are in a 32 bits system
-        {
-            // read the MSB and perform the sign extension
-            if (bits[GPS_L2_CNAV_DATA_PAGE_BITS - parameter[0].first] == 1)
-                {
-                    value ^= 0xFFFFFFFF;
-                }
-            else
-                {
-                    value &= 0;
-                }
-
-            for (int i = 0; i < num_of_slices; i++)
-                {
-                    for (int j = 0; j < parameter[i].second; j++)
-                        {
-                            value <<= 1; //shift left
-                            value &= 0xFFFFFFFE; //reset the corresponding bit
-                            if (bits[GPS_L2_CNAV_DATA_PAGE_BITS - parameter[i].first - j] == 1)
-                                {
-                                    value += 1; // insert the bit
-                                }
-                        }
-                }
-        }
-    return value;
+    return bits.read_signed(parameter);
 }
 
 
-void Gps_CNAV_Navigation_Message::decode_page(std::vector<int> data)
+void Gps_CNAV_Navigation_Message::decode_page(const std::vector<int> & data)
 {
-    std::bitset<GPS_L2_CNAV_DATA_PAGE_BITS> data_bits;
-
-    try
-    {
-            for(int i = 0; i < GPS_L2_CNAV_DATA_PAGE_BITS; i++)
-                {
-                    data_bits[i] = static_cast<uint8_t>(data[GPS_L2_CNAV_DATA_PAGE_BITS - i - 1]);
-                }
-
-    }
-    catch(std::exception &e)
-    {
-            std::cout << "Exception converting to bitset " << e.what() << std::endl;
-            return;
-    }
+    Gnss_Packed_Bits<GPS_L2_CNAV_DATA_PAGE_BITS> data_bits;
+    for(int i = 0; i < GPS_L2_CNAV_DATA_PAGE_BITS; i++)
+        {
+            data_bits.set_bit(i + 1, data[i]);
+        }
 
     int PRN;
     int page_type;
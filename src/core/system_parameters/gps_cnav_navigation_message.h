@@ -55,9 +55,9 @@
 class Gps_CNAV_Navigation_Message
 {
 private:
-    unsigned long int read_navigation_unsigned(std::bitset<GPS_L2_CNAV_DATA_PAGE_BITS> bits, const std::vector<std::pair<int,int>> parameter);
-    signed long int read_navigation_signed(std::bitset<GPS_L2_CNAV_DATA_PAGE_BITS> bits, const std::vector<std::pair<int,int>> parameter);
-    bool read_navigation_bool(std::bitset<GPS_L2_CNAV_DATA_PAGE_BITS> bits, const std::vector<std::pair<int,int>> parameter);
+    unsigned long int read_navigation_unsigned(const Gnss_Packed_Bits<GPS_L2_CNAV_DATA_PAGE_BITS>& bits, const Gnss_Bit_Field& parameter);
+    signed long int read_navigation_signed(const Gnss_Packed_Bits<GPS_L2_CNAV_DATA_PAGE_BITS>& bits, const Gnss_Bit_Field& parameter);
+    bool read_navigation_bool(const Gnss_Packed_Bits<GPS_L2_CNAV_DATA_PAGE_BITS>& bits, const Gnss_Bit_Field& parameter);
     void print_gps_word_bytes(unsigned int GPS_word);
 
     Gps_CNAV_Ephemeris ephemeris_record;
@@ -89,7 +89,7 @@ public:
     // public functions
     void reset();
 
-    void decode_page(std::vector<int> data);
+    void decode_page(const std::vector<int> & data);
     /*!
      * \brief Obtain a GPS SV Ephemeris class filled with current SV data
      */
@@ -128,45 +128,22 @@ double Gps_Ephemeris::sv_clock_drift(double transmitTime)
 double Gps_Ephemeris::sv_clock_relativistic_term(double transmitTime)
 {
     double tk;
-    double a;
-    double n;
-    double n0;
     double E;
-    double E_old;
-    double dE;
     double M;
 
-    // Restore semi-major axis
-    a = d_sqrt_A * d_sqrt_A;
+    d_orbit.set_parameters(d_sqrt_A, d_Delta_n, d_e_eccentricity, GM);
 
     // Time from ephemeris reference epoch
     tk = check_t(transmitTime - d_Toe);
 
-    // Computed mean motion
-    n0 = sqrt(GM / (a * a * a));
-    // Corrected mean motion
-    n = n0 + d_Delta_n;
     // Mean anomaly
-    M = d_M_0 + n * tk;
+    M = d_M_0 + d_orbit.mean_motion() * tk;
 
     // Reduce mean anomaly to between 0 and 2pi
     M = fmod((M + 2.0 * GPS_PI), (2.0 * GPS_PI));
 
-    // Initial guess of eccentric anomaly
-    E = M;
-
-    // --- Iteratively compute eccentric anomaly ----------------------------
-    for (int ii = 1; ii < 20; ii++)
-        {
-            E_old   = E;
-            E       = M + d_e_eccentricity * sin(E);
-            dE      = fmod(E - E_old, 2.0 * GPS_PI);
-            if (fabs(dE) < 1e-12)
-                {
-                    //Necessary precision is reached, exit from the loop
-                    break;
-                }
-        }
+    // Eccentric anomaly
+    E = d_orbit.eccentric_anomaly(M);
 
     // Compute relativistic correction term
     d_dtr = F * d_e_eccentricity * d_sqrt_A * sin(E);
@@ -178,12 +155,8 @@ void Gps_Ephemeris::satellitePosition(double transmitTime)
 {
     double tk;
     double a;
-    double n;
-    double n0;
     double M;
     double E;
-    double E_old;
-    double dE;
     double nu;
     double phi;
     double u;
@@ -193,42 +166,24 @@ void Gps_Ephemeris::satellitePosition(double transmitTime)
 
     // Find satellite's position ----------------------------------------------
 
-    // Restore semi-major axis
-    a = d_sqrt_A*d_sqrt_A;
+    // Semi-major axis and corrected mean motion, computed once per ephemeris set
+    d_orbit.set_parameters(d_sqrt_A, d_Delta_n, d_e_eccentricity, GM);
+    a = d_orbit.semi_major_axis();
 
     // Time from ephemeris reference epoch
     tk = check_t(transmitTime - d_Toe);
 
-    // Computed mean motion
-    n0 = sqrt(GM / (a*a*a));
-
-    // Corrected mean motion
-    n = n0 + d_Delta_n;
-
     // Mean anomaly
-    M = d_M_0 + n * tk;
+    M = d_M_0 + d_orbit.mean_motion() * tk;
 
     // Reduce mean anomaly to between 0 and 2pi
     M = fmod((M + 2*GPS_PI), (2*GPS_PI));
 
-    // Initial guess of eccentric anomaly
-    E = M;
-
-    // --- Iteratively compute eccentric anomaly ----------------------------
-    for (int ii = 1; ii<20; ii++)
-        {
-            E_old   = E;
-            E       = M + d_e_eccentricity * sin(E);
-            dE      = fmod(E - E_old, 2*GPS_PI);
-            if (fabs(dE) < 1e-12)
-                {
-                    //Necessary precision is reached, exit from the loop
-                    break;
-                }
-        }
+    // Eccentric anomaly, starting from the previous solution
+    E = d_orbit.eccentric_anomaly(M);
 
     // Compute the true anomaly
-    double tmp_Y = sqrt(1.0 - d_e_eccentricity * d_e_eccentricity) * sin(E);
+    double tmp_Y = d_orbit.sqrt_one_minus_e2() * sin(E);
     double tmp_X = cos(E) - d_e_eccentricity;
     nu = atan2(tmp_Y, tmp_X);
 
@@ -238,14 +193,18 @@ void Gps_Ephemeris::satellitePosition(double transmitTime)
     // Reduce phi to between 0 and 2*pi rad
     phi = fmod((phi), (2*GPS_PI));
 
+    // Harmonic corrections
+    const double cos_2phi = cos(2*phi);
+    const double sin_2phi = sin(2*phi);
+
     // Correct argument of latitude
-    u = phi + d_Cuc * cos(2*phi) +  d_Cus * sin(2*phi);
+    u = phi + d_Cuc * cos_2phi +  d_Cus * sin_2phi;
 
     // Correct radius
-    r = a * (1 - d_e_eccentricity*cos(E)) +  d_Crc * cos(2*phi) +  d_Crs * sin(2*phi);
+    r = a * (1 - d_e_eccentricity*cos(E)) +  d_Crc * cos_2phi +  d_Crs * sin_2phi;
 
     // Correct inclination
-    i = d_i_0 + d_IDOT * tk + d_Cic * cos(2*phi) + d_Cis * sin(2*phi);
+    i = d_i_0 + d_IDOT * tk + d_Cic * cos_2phi + d_Cis * sin_2phi;
 
     // Compute the angle between the ascending node and the Greenwich meridian
     Omega = d_OMEGA0 + (d_OMEGA_DOT - OMEGA_EARTH_DOT)*tk - OMEGA_EARTH_DOT * d_Toe;
@@ -253,14 +212,21 @@ void Gps_Ephemeris::satellitePosition(double transmitTime)
     // Reduce to between 0 and 2*pi rad
     Omega = fmod((Omega + 2*GPS_PI), (2*GPS_PI));
 
+    const double cos_u = cos(u);
+    const double sin_u = sin(u);
+    const double cos_i = cos(i);
+    const double sin_i = sin(i);
+    const double cos_Omega = cos(Omega);
+    const double sin_Omega = sin(Omega);
+
     // --- Compute satellite coordinates in Earth-fixed coordinates
-    d_satpos_X = cos(u) * r * cos(Omega) - sin(u) * r * cos(i) * sin(Omega);
-    d_satpos_Y = cos(u) * r * sin(Omega) + sin(u) * r * cos(i) * cos(Omega);
-    d_satpos_Z = sin(u) * r * sin(i);
+    d_satpos_X = cos_u * r * cos_Omega - sin_u * r * cos_i * sin_Omega;
+    d_satpos_Y = cos_u * r * sin_Omega + sin_u * r * cos_i * cos_Omega;
+    d_satpos_Z = sin_u * r * sin_i;
 
     // Satellite's velocity. Can be useful for Vector Tracking loops
     double Omega_dot = d_OMEGA_DOT - OMEGA_EARTH_DOT;
-    d_satvel_X = - Omega_dot * (cos(u) * r + sin(u) * r * cos(i)) + d_satpos_X * cos(Omega) - d_satpos_Y * cos(i) * sin(Omega);
-    d_satvel_Y = Omega_dot * (cos(u) * r * cos(Omega) - sin(u) * r * cos(i) * sin(Omega)) + d_satpos_X * sin(Omega) + d_satpos_Y * cos(i) * cos(Omega);
-    d_satvel_Z = d_satpos_Y * sin(i);
+    d_satvel_X = - Omega_dot * (cos_u * r + sin_u * r * cos_i) + d_satpos_X * cos_Omega - d_satpos_Y * cos_i * sin_Omega;
+    d_satvel_Y = Omega_dot * (cos_u * r * cos_Omega - sin_u * r * cos_i * sin_Omega) + d_satpos_X * sin_Omega + d_satpos_Y * cos_i * cos_Omega;
+    d_satvel_Z = d_satpos_Y * sin_i;
 }
@@ -37,6 +37,7 @@
 #include <string>
 #include "boost/assign.hpp"
 #include <boost/serialization/nvp.hpp>
+#include "kepler_orbit.h"
 
 
 
@@ -56,6 +57,8 @@ private:
      * \param[out] -  corrected time, in seconds
      */
     double check_t(double time);
+
+    Kepler_Orbit d_orbit;  // orbit constants and last Kepler solution, not serialized
 public:
     unsigned int i_satellite_PRN; // SV PRN NUMBER
     double d_TOW;            //!< Time of GPS Week of the ephemeris set (taken from subframes TOW) [s]
@@ -149,7 +152,7 @@ public:
         archive & make_nvp("d_Cus", d_Cus);          //!< Amplitude of the Sine Harmonic Correction Term to the Argument of Latitude [rad]
         archive & make_nvp("d_sqrt_A", d_sqrt_A);    //!< Square Root of the Semi-Major Axis [sqrt(m)]
         archive & make_nvp("d_Toe", d_Toe);          //!< Ephemeris data reference time of week (Ref. 20.3.3.4.3 IS-GPS-200E) [s]
-        archive & make_nvp("d_Toc", d_Toe);          //!< clock data reference time (Ref. 20.3.3.3.3.1 IS-GPS-200E) [s]
+        archive & make_nvp("d_Toc", d_Toc);          //!< clock data reference time (Ref. 20.3.3.3.3.1 IS-GPS-200E) [s]
         archive & make_nvp("d_Cic", d_Cic);          //!< Amplitude of the Cosine Harmonic Correction Term to the Angle of Inclination [rad]
         archive & make_nvp("d_OMEGA0", d_OMEGA0);    //!< Longitude of Ascending Node of Orbit Plane at Weekly Epoch [semi-circles]
         archive & make_nvp("d_Cis", d_Cis);          //!< Amplitude of the Sine Harmonic Correction Term to the Angle of Inclination [rad]
@@ -39,6 +39,8 @@ m * \file gps_navigation_message.cc
 void Gps_Navigation_Message::reset()
 {
     b_valid_ephemeris_set_flag = false;
+    b_subframe_repeated = false;
+    d_subframe_data.clear();
     d_TOW = 0;
     d_TOW_SF1 = 0;
     d_TOW_SF2 = 0;
@@ -163,103 +165,26 @@ void Gps_Navigation_Message::print_gps_word_bytes(unsigned int GPS_word)
 
 
 
-bool Gps_Navigation_Message::read_navigation_bool(std::bitset<GPS_SUBFRAME_BITS> bits, const std::vector<std::pair<int,int>> parameter)
+bool Gps_Navigation_Message::read_navigation_bool(const Gnss_Packed_Bits<GPS_SUBFRAME_BITS>& bits, const Gnss_Bit_Field& parameter)
 {
-    bool value;
-
-    if (bits[GPS_SUBFRAME_BITS - parameter[0].first] == 1)
-        {
-            value = true;
-        }
-    else
-        {
-            value = false;
-        }
-    return value;
+    return bits.read_bool(parameter);
 }
 
 
 
 
-unsigned long int Gps_Navigation_Message::read_navigation_unsigned(std::bitset<GPS_SUBFRAME_BITS> bits, const std::vector<std::pair<int,int>> parameter)
+unsigned long int Gps_Navigation_Message::read_navigation_unsigned(const Gnss_Packed_Bits<GPS_SUBFRAME_BITS>& bits, const Gnss_Bit_Field& parameter)
 {
-    unsigned long int value = 0;
-    int num_of_slices = parameter.size();
-    for (int i = 0; i < num_of_slices; i++)
-        {
-            for (int j = 0; j < parameter[i].second; j++)
-                {
-                    value <<= 1; //shift left
-                    if (bits[GPS_SUBFRAME_BITS - parameter[i].first - j] == 1)
-                        {
-                            value += 1; // insert the bit
-                        }
-                }
-        }
-    return value;
+    return bits.read_unsigned(parameter);
 }
 
 
 
 
 
-signed long int Gps_Navigation_Message::read_navigation_signed(std::bitset<GPS_SUBFRAME_BITS> bits, const std::vector<std::pair<int,int>> parameter)
+signed long int Gps_Navigation_Message::read_navigation_signed(const Gnss_Packed_Bits<GPS_SUBFRAME_BITS>& bits, const Gnss_Bit_Field& parameter)
 {
-    signed long int value = 0;
-    int num_of_slices = parameter.size();
-    // Discriminate between 64 bits and 32 bits compiler
-    int long_int_size_bytes = sizeof(signed long int);
-    if (long_int_size_bytes == 8) // if a long int takes 8 bytes, we are in a 64 bits system
-        {
-            // read the MSB and perform the sign extension
-            if (bits[GPS_SUBFRAME_BITS - parameter[0].first] == 1)
-                {
-                    value ^= 0xFFFFFFFFFFFFFFFF; //64 bits variable
-                }
-            else
-                {
-                    value &= 0;
-                }
-
-            for (int i = 0; i < num_of_slices; i++)
-                {
-                    for (int j = 0; j < parameter[i].second; j++)
-                        {
-                            value <<= 1; //shift left
-                            value &= 0xFFFFFFFFFFFFFFFE; //reset the corresponding bit (for the 64 bits variable)
-                            if (bits[GPS_SUBFRAME_BITS - parameter[i].first - j] == 1)
-                                {
-                                    value += 1; // insert the bit
-                                }
-                        }
-                }
-        }
-    else  // we assume we are in a 32 bits system
-        {
-            // read the MSB and perform the sign extension
-            if (bits[GPS_SUBFRAME_BITS - parameter[0].first] == 1)
-                {
-                    value ^= 0xFFFFFFFF;
-                }
-            else
-                {
-                    value &= 0;
-                }
-
-            for (int i = 0; i < num_of_slices; i++)
-                {
-                    for (int j = 0; j < parameter[i].second; j++)
-                        {
-                            value <<= 1; //shift left
-                            value &= 0xFFFFFFFE; //reset the corresponding bit
-                            if (bits[GPS_SUBFRAME_BITS - parameter[i].first - j] == 1)
-                                {
-                                    value += 1; // insert the bit
-                                }
-                        }
-                }
-        }
-    return value;
+    return bits.read_signed(parameter);
 }
 
 
@@ -406,20 +331,46 @@ int Gps_Navigation_Message::subframe_decoder(char *subframe)
     unsigned int gps_word;
 
     // UNPACK BYTES TO BITS AND REMOVE THE CRC REDUNDANCE
-    std::bitset<GPS_SUBFRAME_BITS> subframe_bits;
-    std::bitset<GPS_WORD_BITS + 2> word_bits;
+    Gnss_Packed_Bits<GPS_SUBFRAME_BITS> subframe_bits;
     for (int i = 0; i < 10; i++)
         {
             memcpy(&gps_word, &subframe[i * 4], sizeof(char) * 4);
-            word_bits = std::bitset<(GPS_WORD_BITS + 2) > (gps_word);
-            for (int j = 0; j < GPS_WORD_BITS; j++)
-                {
-                    subframe_bits[GPS_WORD_BITS * (9 - i) + j] = word_bits[j];
-                }
+            subframe_bits.set_bits(GPS_WORD_BITS * i + 1, GPS_WORD_BITS, gps_word);
         }
 
     subframe_ID = static_cast<int>(read_navigation_unsigned(subframe_bits, SUBFRAME_ID));
 
+    b_subframe_repeated = false;
+    if (subframe_ID >= 1 && subframe_ID <= 5)
+        {
+            int key = subframe_ID;
+            if (subframe_ID > 3)
+                {
+                    key += 8 * static_cast<int>(read_navigation_unsigned(subframe_bits, SV_PAGE));
+                }
+            std::vector<unsigned int> data(8);
+            for (int i = 0; i < 8; i++)
+                {
+                    memcpy(&gps_word, &subframe[(i + 2) * 4], sizeof(char) * 4);
+                    data[i] = gps_word & 0x3FFFFFC0;  // bits D1 to D24
+                }
+            std::vector<unsigned int> & last = d_subframe_data[key];
+            b_subframe_repeated = (last == data);
+            last.swap(data);
+        }
+    if (b_subframe_repeated)
+        {
+            // The TOW is the start time of the next subframe
+            double tow = static_cast<double>(read_navigation_unsigned(subframe_bits, TOW)) * 6;
+            double * tow_sf[5] = { &d_TOW_SF1, &d_TOW_SF2, &d_TOW_SF3, &d_TOW_SF4, &d_TOW_SF5 };
+            *tow_sf[subframe_ID - 1] = tow;
+            d_TOW = tow - 6; // Set transmission time
+            b_integrity_status_flag = read_navigation_bool(subframe_bits, INTEGRITY_STATUS_FLAG);
+            b_alert_flag = read_navigation_bool(subframe_bits, ALERT_FLAG);
+            b_antispoofing_flag = read_navigation_bool(subframe_bits, ANTI_SPOOFING_FLAG);
+            return subframe_ID;
+        }
+
     // Decode all 5 sub-frames
     switch (subframe_ID)
     {
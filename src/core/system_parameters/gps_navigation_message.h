@@ -54,9 +54,9 @@
 class Gps_Navigation_Message
 {
 private:
-    unsigned long int read_navigation_unsigned(std::bitset<GPS_SUBFRAME_BITS> bits, const std::vector<std::pair<int,int>> parameter);
-    signed long int read_navigation_signed(std::bitset<GPS_SUBFRAME_BITS> bits, const std::vector<std::pair<int,int>> parameter);
-    bool read_navigation_bool(std::bitset<GPS_SUBFRAME_BITS> bits, const std::vector<std::pair<int,int>> parameter);
+    unsigned long int read_navigation_unsigned(const Gnss_Packed_Bits<GPS_SUBFRAME_BITS>& bits, const Gnss_Bit_Field& parameter);
+    signed long int read_navigation_signed(const Gnss_Packed_Bits<GPS_SUBFRAME_BITS>& bits, const Gnss_Bit_Field& parameter);
+    bool read_navigation_bool(const Gnss_Packed_Bits<GPS_SUBFRAME_BITS>& bits, const Gnss_Bit_Field& parameter);
     void print_gps_word_bytes(unsigned int GPS_word);
     /*
      * Accounts for the beginning or end of week crossover
@@ -67,8 +67,13 @@ private:
      */
     double check_t(double time);
 
+    // Data words 3 to 10 of the last subframe of each ID (and page, for
+    // subframes 4 and 5), with the parity bits cleared
+    std::map<int, std::vector<unsigned int> > d_subframe_data;
+
 public:
     bool b_valid_ephemeris_set_flag; // flag indicating that this ephemeris set have passed the validation check
+    bool b_subframe_repeated; //!< The last subframe had the data of the previous one with its ID and page: only its HOW was decoded
     //broadcast orbit 1
     double d_TOW; //!< Time of GPS Week of the ephemeris set (taken from subframes TOW) [s]
     double d_TOW_SF1;            //!< Time of GPS Week from HOW word of Subframe 1 [s]
@@ -209,6 +214,11 @@ public:
 
     /*!
      * \brief Decodes the GPS NAV message
+     *
+     * Subframes 1 to 3 repeat every frame and the pages of subframes 4 and 5
+     * every 25 frames until the next upload. When the data words of a
+     * subframe are the ones already decoded, only its HOW (the TOW and the
+     * flags) is, and \a b_subframe_repeated is set.
      */
     int subframe_decoder(char *subframe);
 
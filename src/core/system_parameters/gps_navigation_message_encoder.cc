@@ -0,0 +1,155 @@
+/*!
+ * \file gps_navigation_message_encoder.cc
+ * \brief Encoder of the GPS L1 C/A NAV message subframes
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gps_navigation_message_encoder.h"
+#include <bitset>
+#include <cmath>
+#include "GPS_L1_CA.h"
+#include "gnss_packed_bits.h"
+
+
+// Number of subframes in a week
+static const long int GPS_SUBFRAMES_PER_WEEK = 604800 / GPS_SUBFRAME_SECONDS;
+
+
+// Field value of a parameter, in two's complement if it is negative
+static uint64_t gps_scaled(double value, double lsb)
+{
+    return static_cast<uint64_t>(static_cast<int64_t>(std::round(value / lsb)));
+}
+
+
+Gps_Navigation_Message_Encoder::Gps_Navigation_Message_Encoder(const Gps_Ephemeris& ephemeris) :
+        d_ephemeris(ephemeris)
+{}
+
+
+unsigned int Gps_Navigation_Message_Encoder::parity(unsigned int data, unsigned int previous_d29, unsigned int previous_d30)
+{
+    // Data bits d1 (the MSB) to d24 that go into each of D25 to D30
+    static const unsigned int masks[6] = {0xEC7CD2, 0x763E69, 0xBB1F34, 0x5D8F9A, 0xAEC7CD, 0x2DEA27};
+    const unsigned int previous[6] = {previous_d29, previous_d30, previous_d29, previous_d30, previous_d30, previous_d29};
+    unsigned int bits = 0;
+    for (int i = 0; i < 6; i++)
+        {
+            const unsigned int bit = (std::bitset<24>(data & masks[i]).count() & 1) ^ (previous[i] & 1);
+            bits = (bits << 1) | bit;
+        }
+    return bits;
+}
+
+
+void Gps_Navigation_Message_Encoder::subframe(long int subframe_count, unsigned int words[10]) const
+{
+    const Gps_Ephemeris& eph = d_ephemeris;
+    const int subframe_ID = static_cast<int>(subframe_count % 5) + 1;
+    Gnss_Packed_Bits<GPS_SUBFRAME_BITS> bits;
+
+    // TLM and HOW. The TOW is the one of the next subframe
+    const int preamble[GPS_CA_PREAMBLE_LENGTH_BITS] = GPS_PREAMBLE;
+    for (int i = 0; i < GPS_CA_PREAMBLE_LENGTH_BITS; i++)
+        {
+            bits.set_bit(i + 1, preamble[i] == 1);
+        }
+    bits.set_field(INTEGRITY_STATUS_FLAG, eph.b_integrity_status_flag);
+    bits.set_field(TOW, (subframe_count + 1) % GPS_SUBFRAMES_PER_WEEK);
+    bits.set_field(ALERT_FLAG, eph.b_alert_flag);
+    bits.set_field(ANTI_SPOOFING_FLAG, eph.b_antispoofing_flag);
+    bits.set_field(SUBFRAME_ID, subframe_ID);
+
+    switch (subframe_ID)
+    {
+    case 1:
+        bits.set_field(GPS_WEEK, eph.i_GPS_week % 1024);
+        bits.set_field(CA_OR_P_ON_L2, eph.i_code_on_L2);
+        bits.set_field(SV_ACCURACY, eph.i_SV_accuracy);
+        bits.set_field(SV_HEALTH, eph.i_SV_health);
+        bits.set_field(L2_P_DATA_FLAG, eph.b_L2_P_data_flag);
+        bits.set_field(T_GD, gps_scaled(eph.d_TGD, T_GD_LSB));
+        bits.set_field(IODC, static_cast<uint64_t>(eph.d_IODC));
+        bits.set_field(T_OC, gps_scaled(eph.d_Toc, T_OC_LSB));
+        bits.set_field(A_F2, gps_scaled(eph.d_A_f2, A_F2_LSB));
+        bits.set_field(A_F1, gps_scaled(eph.d_A_f1, A_F1_LSB));
+        bits.set_field(A_F0, gps_scaled(eph.d_A_f0, A_F0_LSB));
+        break;
+
+    case 2:
+        // The fit interval flag and the AODO are left out, since their
+        // positions in GPS_L1_CA.h overlap the toe
+        bits.set_field(IODE_SF2, static_cast<uint64_t>(eph.d_IODE_SF2));
+        bits.set_field(C_RS, gps_scaled(eph.d_Crs, C_RS_LSB));
+        bits.set_field(DELTA_N, gps_scaled(eph.d_Delta_n, DELTA_N_LSB));
+        bits.set_field(M_0, gps_scaled(eph.d_M_0, M_0_LSB));
+        bits.set_field(C_UC, gps_scaled(eph.d_Cuc, C_UC_LSB));
+        bits.set_field(E, gps_scaled(eph.d_e_eccentricity, E_LSB));
+        bits.set_field(C_US, gps_scaled(eph.d_Cus, C_US_LSB));
+        bits.set_field(SQRT_A, gps_scaled(eph.d_sqrt_A, SQRT_A_LSB));
+        bits.set_field(T_OE, gps_scaled(eph.d_Toe, T_OE_LSB));
+        break;
+
+    case 3:
+        bits.set_field(C_IC, gps_scaled(eph.d_Cic, C_IC_LSB));
+        bits.set_field(OMEGA_0, gps_scaled(eph.d_OMEGA0, OMEGA_0_LSB));
+        bits.set_field(C_IS, gps_scaled(eph.d_Cis, C_IS_LSB));
+        bits.set_field(I_0, gps_scaled(eph.d_i_0, I_0_LSB));
+        bits.set_field(C_RC, gps_scaled(eph.d_Crc, C_RC_LSB));
+        bits.set_field(OMEGA, gps_scaled(eph.d_OMEGA, OMEGA_LSB));
+        bits.set_field(OMEGA_DOT, gps_scaled(eph.d_OMEGA_DOT, OMEGA_DOT_LSB));
+        bits.set_field(IODE_SF3, static_cast<uint64_t>(eph.d_IODE_SF3));
+        bits.set_field(I_DOT, gps_scaled(eph.d_IDOT, I_DOT_LSB));
+        break;
+
+    default:
+        // Subframes 4 and 5: pages of the dummy SV 0, with no almanac
+        bits.set_field(SV_DATA_ID, 1);
+        bits.set_field(SV_PAGE, 0);
+        break;
+    }
+
+    // D29 and D30 of the last word of the previous subframe are 0, as in any
+    // word 10
+    unsigned int d29 = 0;
+    unsigned int d30 = 0;
+    for (int w = 0; w < 10; w++)
+        {
+            unsigned int data = static_cast<unsigned int>(bits.read_bits(GPS_WORD_BITS * w + 1, 24));
+            if (w == 1 || w == 9)
+                {
+                    // Non-information bearing bits 23 and 24, chosen to have D29 = D30 = 0
+                    unsigned int t = 0;
+                    while (t < 3 && (parity((data & ~3u) | t, d29, d30) & 3) != 0) t++;
+                    data = (data & ~3u) | t;
+                }
+            const unsigned int p = parity(data, d29, d30);
+            words[w] = ((d30 ? data ^ 0xFFFFFF : data) << 6) | p;
+            d29 = (p >> 1) & 1;
+            d30 = p & 1;
+        }
+}
@@ -0,0 +1,67 @@
+/*!
+ * \file gps_navigation_message_encoder.h
+ * \brief Encoder of the GPS L1 C/A NAV message subframes
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Builds the subframes transmitted by a satellite from its ephemeris, as
+ * read back by Gps_Navigation_Message::subframe_decoder: the TLM and HOW
+ * words, subframes 1 to 3 and dummy pages in subframes 4 and 5. Each word
+ * gets its parity, and its data bits are inverted if the last parity bit
+ * of the previous word is set (IS-GPS-200E 20.3.5).
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_GPS_NAVIGATION_MESSAGE_ENCODER_H_
+#define GNSS_SDR_GPS_NAVIGATION_MESSAGE_ENCODER_H_
+
+#include "gps_ephemeris.h"
+
+/*!
+ * \brief Builds the GPS NAV message subframes of a satellite
+ */
+class Gps_Navigation_Message_Encoder
+{
+public:
+    explicit Gps_Navigation_Message_Encoder(const Gps_Ephemeris& ephemeris);
+
+    /*!
+     * \brief Words of the subframe that starts at \p subframe_count * 6 s
+     * of the GPS week, as transmitted. Each word is in the 30 LSBs, its first
+     * bit being the MSB.
+     */
+    void subframe(long int subframe_count, unsigned int words[10]) const;
+
+    /*!
+     * \brief Parity bits D25 to D30 of the 24 data bits of a word (Table
+     * 20-XIV of IS-GPS-200E), given D29 and D30 of the previous word
+     */
+    static unsigned int parity(unsigned int data, unsigned int previous_d29, unsigned int previous_d30);
+
+private:
+    Gps_Ephemeris d_ephemeris;
+};
+
+#endif /* GNSS_SDR_GPS_NAVIGATION_MESSAGE_ENCODER_H_ */
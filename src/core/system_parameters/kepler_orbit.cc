@@ -0,0 +1,89 @@
+/*!
+ * \file kepler_orbit.cc
+ * \brief Cached orbit constants and eccentric anomaly solver shared by the
+ *  GPS and Galileo broadcast ephemeris models.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "kepler_orbit.h"
+#include <cmath>
+
+
+Kepler_Orbit::Kepler_Orbit()
+{
+    d_sqrt_A = 0.0;
+    d_delta_n = 0.0;
+    d_e = 0.0;
+    d_gm = 0.0;
+    d_a = 0.0;
+    d_n = 0.0;
+    d_sqrt_one_minus_e2 = 1.0;
+    d_warm = false;
+    d_E_minus_M = 0.0;
+}
+
+
+void Kepler_Orbit::set_parameters(double sqrt_A, double delta_n, double e, double gm)
+{
+    if (sqrt_A == d_sqrt_A && delta_n == d_delta_n && e == d_e && gm == d_gm)
+        {
+            return;
+        }
+    d_sqrt_A = sqrt_A;
+    d_delta_n = delta_n;
+    d_e = e;
+    d_gm = gm;
+
+    // Restore semi-major axis
+    d_a = sqrt_A * sqrt_A;
+    // Computed mean motion, plus the correction
+    d_n = (d_a > 0.0) ? sqrt(gm / (d_a * d_a * d_a)) + delta_n : delta_n;
+    d_sqrt_one_minus_e2 = sqrt(1.0 - e * e);
+    d_warm = false;
+}
+
+
+double Kepler_Orbit::eccentric_anomaly(double M)
+{
+    // Initial guess: previous solution, or the mean anomaly
+    double E = d_warm ? M + d_E_minus_M : M;
+
+    // Newton iterations on E - e sin(E) - M = 0
+    for (int ii = 1; ii < 20; ii++)
+        {
+            const double dE = (E - d_e * sin(E) - M) / (1.0 - d_e * cos(E));
+            E -= dE;
+            if (fabs(dE) < 1e-12)
+                {
+                    //Necessary precision is reached, exit from the loop
+                    break;
+                }
+        }
+    d_E_minus_M = E - M;
+    d_warm = true;
+    return E;
+}
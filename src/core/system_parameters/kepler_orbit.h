@@ -0,0 +1,101 @@
+/*!
+ * \file kepler_orbit.h
+ * \brief Cached orbit constants and eccentric anomaly solver shared by the
+ *  GPS and Galileo broadcast ephemeris models.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The ephemeris classes used to restore the semi-major axis, the mean motion
+ * and the other derived constants, and to solve Kepler's equation from the
+ * mean anomaly, on every call of satellitePosition() and of the clock
+ * relativistic term, which PVT makes several times per satellite and epoch.
+ * This class computes the constants once per set of orbit parameters and
+ * solves the equation with Newton iterations starting from the previous
+ * solution, so that consecutive epochs converge in one or two iterations.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_KEPLER_ORBIT_H_
+#define GNSS_SDR_KEPLER_ORBIT_H_
+
+/*!
+ * \brief Derived constants of a Keplerian orbit and warm-started solution of
+ * Kepler's equation. The parameters are checked on every call, so a new
+ * ephemeris set (IODE change) is picked up without explicit invalidation.
+ */
+class Kepler_Orbit
+{
+public:
+    Kepler_Orbit();
+
+    /*!
+     * \brief Recomputes the derived constants if any orbit parameter changed.
+     * \param sqrt_A - square root of the semi-major axis [sqrt(m)].
+     * \param delta_n - mean motion difference from computed value [rad/s].
+     * \param e - eccentricity.
+     * \param gm - geocentric gravitational constant of the system [m^3/s^2].
+     */
+    void set_parameters(double sqrt_A, double delta_n, double e, double gm);
+
+    //! Semi-major axis [m]
+    double semi_major_axis() const
+    {
+        return d_a;
+    }
+
+    //! Corrected mean motion [rad/s]
+    double mean_motion() const
+    {
+        return d_n;
+    }
+
+    //! sqrt(1 - e^2)
+    double sqrt_one_minus_e2() const
+    {
+        return d_sqrt_one_minus_e2;
+    }
+
+    /*!
+     * \brief Eccentric anomaly [rad] for the mean anomaly M [rad], to 1e-12 rad
+     */
+    double eccentric_anomaly(double M);
+
+private:
+    // orbit parameters the constants were computed from
+    double d_sqrt_A;
+    double d_delta_n;
+    double d_e;
+    double d_gm;
+
+    double d_a;
+    double d_n;
+    double d_sqrt_one_minus_e2;
+
+    // last solution, as E - M, which changes slowly along the orbit
+    bool d_warm;
+    double d_E_minus_M;
+};
+
+#endif /* GNSS_SDR_KEPLER_ORBIT_H_ */
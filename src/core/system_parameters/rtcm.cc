@@ -36,11 +36,11 @@
 #include <sstream>    // for std::stringstream
 #include <thread>
 #include <boost/algorithm/string.hpp>  // for to_upper_copy
-#include <boost/crc.hpp>
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <boost/dynamic_bitset.hpp>
 #include <glog/logging.h>
 #include "Galileo_E1.h"
+#include "gnss_crc24q.h"
 
 using google::LogMessage;
 
@@ -51,8 +51,6 @@ Rtcm::Rtcm(unsigned short port)
     preamble = std::bitset<8>("11010011");
     reserved_field = std::bitset<6>("000000");
     rtcm_message_queue = std::make_shared< concurrent_queue<std::string> >();
-    boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::tcp::v4(), RTCM_port);
-    servers.emplace_back(io_service, endpoint);
     server_is_running = false;
 }
 
@@ -77,6 +75,10 @@ void Rtcm::run_server()
     std::cout << "Starting a TCP Server on port " << RTCM_port << std::endl;
     try
     {
+            // the port is bound here, so that an unused Rtcm object does not take it
+            boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::tcp::v4(), RTCM_port);
+            servers.emplace_back(io_service, endpoint);
+
             std::thread tq([&]{ std::make_shared<Queue_Reader>(io_service, rtcm_message_queue, RTCM_port)->do_read_queue(); });
             tq.detach();
 
@@ -91,6 +93,42 @@ void Rtcm::run_server()
 }
 
 
+void Rtcm::run_caster(unsigned int n_threads, unsigned int max_queued_messages)
+{
+    caster = std::unique_ptr<Rtcm_Caster>(new Rtcm_Caster(RTCM_port, n_threads, max_queued_messages));
+    if (!caster->start())
+        {
+            std::cerr << "The RTCM caster cannot be started on port " << RTCM_port << std::endl;
+            caster.reset();
+            return;
+        }
+    server_is_running = true;
+    tq = std::thread([this]()
+            {
+        std::string message;
+        while (true)
+            {
+                rtcm_message_queue->wait_and_pop(message);
+                if (message.compare("Goodbye") == 0)
+                    {
+                        break;
+                    }
+                caster->deliver(message);
+            }
+            });
+}
+
+
+std::vector<Rtcm_Caster::Client_Stats> Rtcm::caster_client_stats() const
+{
+    if (caster)
+        {
+            return caster->client_stats();
+        }
+    return std::vector<Rtcm_Caster::Client_Stats>();
+}
+
+
 void Rtcm::stop_service()
 {
     io_service.stop();
@@ -101,8 +139,19 @@ void Rtcm::stop_server()
 {
     std::cout << "Stopping TCP Server on port " << RTCM_port << std::endl;
     rtcm_message_queue->push("Goodbye"); // this terminates tq
+    if (caster)
+        {
+            tq.join();
+            caster->stop();
+            caster.reset();
+            server_is_running = false;
+            return;
+        }
     Rtcm::stop_service();
-    servers.front().close_server();
+    if (!servers.empty())
+        {
+            servers.back().close_server();
+        }
     std::this_thread::sleep_for(std::chrono::seconds(1));
     server_is_running = false;
 }
@@ -126,44 +175,19 @@ bool Rtcm::is_server_running() const
 //
 // *****************************************************************************************************
 
-std::string Rtcm::add_CRC (const std::string & message_without_crc) const
-{
-    // ******  Computes Qualcomm CRC-24Q ******
-    boost::crc_optimal<24, 0x1864CFBu, 0x0, 0x0, false, false> CRC_RTCM;
-    // 1) Converts the string to a vector of unsigned char:
-    boost::dynamic_bitset<unsigned char> frame_bits(message_without_crc);
-    std::vector<unsigned char> bytes;
-    boost::to_block_range(frame_bits, std::back_inserter(bytes));
-    std::reverse(bytes.begin(), bytes.end());
-
-    // 2) Computes CRC
-    CRC_RTCM.process_bytes(bytes.data(), bytes.size());
-    std::bitset<24> crc_frame = std::bitset<24>(CRC_RTCM.checksum());
-
-    // 3) Builds the complete message
-    std::string complete_message = message_without_crc + crc_frame.to_string();
-    return bin_to_binary_data(complete_message);
-}
-
-
 bool Rtcm::check_CRC(const std::string & message) const
 {
-    boost::crc_optimal<24, 0x1864CFBu, 0x0, 0x0, false, false> CRC_RTCM_CHECK;
-    // Convert message to binary
-    std::string message_bin = Rtcm::binary_data_to_bin(message);
-    // Check CRC
-    std::string crc = message_bin.substr(message_bin.length() - 24, 24);
-    std::bitset<24> read_crc =  std::bitset<24>(crc);
-    std::string msg_without_crc = message_bin.substr(0, message_bin.length() - 24);
-
-    boost::dynamic_bitset<unsigned char> frame_bits(msg_without_crc);
-    std::vector<unsigned char> bytes;
-    boost::to_block_range(frame_bits, std::back_inserter(bytes));
-    std::reverse(bytes.begin(), bytes.end());
-
-    CRC_RTCM_CHECK.process_bytes(bytes.data(), bytes.size());
-    std::bitset<24> computed_crc = std::bitset<24>(CRC_RTCM_CHECK.checksum());
-    if(read_crc == computed_crc)
+    // ******  Computes Qualcomm CRC-24Q ******
+    if(message.length() < 3)
+        {
+            return false;
+        }
+    const unsigned char * bytes = reinterpret_cast<const unsigned char *>(message.data());
+    unsigned int length = message.length() - 3;
+    unsigned int read_crc = (static_cast<unsigned int>(bytes[length]) << 16) |
+            (static_cast<unsigned int>(bytes[length + 1]) << 8) |
+            static_cast<unsigned int>(bytes[length + 2]);
+    if(read_crc == Gnss_Crc24q::checksum(bytes, length))
         {
             return true;
         }
@@ -362,17 +386,9 @@ long int Rtcm::hex_to_int(const std::string& s) const
 
 std::string Rtcm::build_message(const std::string & data) const
 {
-    unsigned int msg_length_bits = data.length();
-    unsigned int msg_length_bytes = std::ceil(static_cast<float>(msg_length_bits) / 8.0);
-    std::bitset<10> message_length = std::bitset<10>(msg_length_bytes);
-    unsigned int zeros_to_fill = 8 * msg_length_bytes -  msg_length_bits;
-    std::string b(zeros_to_fill, '0');
-    std::string msg_content = data + b;
-    std::string msg_without_crc = preamble.to_string() +
-            reserved_field.to_string() +
-            message_length.to_string() +
-            msg_content;
-    return Rtcm::add_CRC(msg_without_crc);
+    Rtcm_Bit_Writer writer;
+    writer.append(data);
+    return writer.frame();
 }
 
 
@@ -1111,46 +1127,45 @@ std::string Rtcm::print_MT1019(const Gps_Ephemeris & gps_eph)
     Rtcm::set_DF103(gps_eph);
     Rtcm::set_DF137(gps_eph);
 
-    std::string data;
-    data.clear();
-    data = DF002.to_string() +
-            DF009.to_string() +
-            DF076.to_string() +
-            DF077.to_string() +
-            DF078.to_string() +
-            DF079.to_string() +
-            DF071.to_string() +
-            DF081.to_string() +
-            DF082.to_string() +
-            DF083.to_string() +
-            DF084.to_string() +
-            DF085.to_string() +
-            DF086.to_string() +
-            DF087.to_string() +
-            DF088.to_string() +
-            DF089.to_string() +
-            DF090.to_string() +
-            DF091.to_string() +
-            DF092.to_string() +
-            DF093.to_string() +
-            DF094.to_string() +
-            DF095.to_string() +
-            DF096.to_string() +
-            DF097.to_string() +
-            DF098.to_string() +
-            DF099.to_string() +
-            DF100.to_string() +
-            DF101.to_string() +
-            DF102.to_string() +
-            DF103.to_string() +
-            DF137.to_string();
-
-    if (data.length() != 488)
-        {
-            LOG(WARNING) << "Bad-formatted RTCM MT1019 (488 bits expected, found " <<  data.length() << ")";
-        }
-
-    std::string msg = build_message(data);
+    msg_writer.clear();
+    msg_writer.append(DF002);
+    msg_writer.append(DF009);
+    msg_writer.append(DF076);
+    msg_writer.append(DF077);
+    msg_writer.append(DF078);
+    msg_writer.append(DF079);
+    msg_writer.append(DF071);
+    msg_writer.append(DF081);
+    msg_writer.append(DF082);
+    msg_writer.append(DF083);
+    msg_writer.append(DF084);
+    msg_writer.append(DF085);
+    msg_writer.append(DF086);
+    msg_writer.append(DF087);
+    msg_writer.append(DF088);
+    msg_writer.append(DF089);
+    msg_writer.append(DF090);
+    msg_writer.append(DF091);
+    msg_writer.append(DF092);
+    msg_writer.append(DF093);
+    msg_writer.append(DF094);
+    msg_writer.append(DF095);
+    msg_writer.append(DF096);
+    msg_writer.append(DF097);
+    msg_writer.append(DF098);
+    msg_writer.append(DF099);
+    msg_writer.append(DF100);
+    msg_writer.append(DF101);
+    msg_writer.append(DF102);
+    msg_writer.append(DF103);
+    msg_writer.append(DF137);
+
+    if (msg_writer.size() != 488)
+        {
+            LOG(WARNING) << "Bad-formatted RTCM MT1019 (488 bits expected, found " <<  msg_writer.size() << ")";
+        }
+
+    std::string msg = msg_writer.frame();
     if(server_is_running)
         {
             rtcm_message_queue->push(msg);
@@ -1395,44 +1410,43 @@ std::string Rtcm::print_MT1045(const Galileo_Ephemeris & gal_eph)
     unsigned int seven_zero = 0;
     std::bitset<7> DF001_ = std::bitset<7>(seven_zero);
 
-    std::string data;
-    data.clear();
-    data = DF002.to_string() +
-            DF252.to_string() +
-            DF289.to_string() +
-            DF290.to_string() +
-            DF291.to_string() +
-            DF292.to_string() +
-            DF293.to_string() +
-            DF294.to_string() +
-            DF295.to_string() +
-            DF296.to_string() +
-            DF297.to_string() +
-            DF298.to_string() +
-            DF299.to_string() +
-            DF300.to_string() +
-            DF301.to_string() +
-            DF302.to_string() +
-            DF303.to_string() +
-            DF304.to_string() +
-            DF305.to_string() +
-            DF306.to_string() +
-            DF307.to_string() +
-            DF308.to_string() +
-            DF309.to_string() +
-            DF310.to_string() +
-            DF311.to_string() +
-            DF312.to_string() +
-            DF314.to_string() +
-            DF315.to_string() +
-            DF001_.to_string();
-
-    if (data.length() != 496)
-        {
-            LOG(WARNING) << "Bad-formatted RTCM MT1045 (496 bits expected, found " <<  data.length() << ")";
-        }
-
-    std::string msg = build_message(data);
+    msg_writer.clear();
+    msg_writer.append(DF002);
+    msg_writer.append(DF252);
+    msg_writer.append(DF289);
+    msg_writer.append(DF290);
+    msg_writer.append(DF291);
+    msg_writer.append(DF292);
+    msg_writer.append(DF293);
+    msg_writer.append(DF294);
+    msg_writer.append(DF295);
+    msg_writer.append(DF296);
+    msg_writer.append(DF297);
+    msg_writer.append(DF298);
+    msg_writer.append(DF299);
+    msg_writer.append(DF300);
+    msg_writer.append(DF301);
+    msg_writer.append(DF302);
+    msg_writer.append(DF303);
+    msg_writer.append(DF304);
+    msg_writer.append(DF305);
+    msg_writer.append(DF306);
+    msg_writer.append(DF307);
+    msg_writer.append(DF308);
+    msg_writer.append(DF309);
+    msg_writer.append(DF310);
+    msg_writer.append(DF311);
+    msg_writer.append(DF312);
+    msg_writer.append(DF314);
+    msg_writer.append(DF315);
+    msg_writer.append(DF001_);
+
+    if (msg_writer.size() != 496)
+        {
+            LOG(WARNING) << "Bad-formatted RTCM MT1045 (496 bits expected, found " <<  msg_writer.size() << ")";
+        }
+
+    std::string msg = msg_writer.frame();
     if(server_is_running)
         {
             rtcm_message_queue->push(msg);
@@ -1594,7 +1608,8 @@ std::string Rtcm::print_MSM_1( const Gps_Ephemeris & gps_eph,
             msg_number = 1071;
         }
 
-    std::string header = Rtcm::get_MSM_header(msg_number,
+    msg_writer.clear();
+    Rtcm::write_MSM_header(msg_writer, msg_number,
              obs_time,
              pseudoranges,
              ref_id,
@@ -1604,11 +1619,11 @@ std::string Rtcm::print_MSM_1( const Gps_Ephemeris & gps_eph,
              divergence_free,
              more_messages);
 
-    std::string sat_data = Rtcm::get_MSM_1_content_sat_data(pseudoranges);
+    Rtcm::write_MSM_1_content_sat_data(msg_writer, pseudoranges);
 
-    std::string signal_data = Rtcm::get_MSM_1_content_signal_data(pseudoranges);
+    Rtcm::write_MSM_1_content_signal_data(msg_writer, pseudoranges);
 
-    std::string message = build_message(header + sat_data + signal_data);
+    std::string message = msg_writer.frame();
 
     if(server_is_running)
         {
@@ -1619,7 +1634,7 @@ std::string Rtcm::print_MSM_1( const Gps_Ephemeris & gps_eph,
 }
 
 
-std::string Rtcm::get_MSM_header(unsigned int msg_number,
+void Rtcm::write_MSM_header(Rtcm_Bit_Writer & writer, unsigned int msg_number,
         double obs_time,
         const std::map<int, Gnss_Synchro> & pseudoranges,
         unsigned int ref_id,
@@ -1628,6 +1643,33 @@ std::string Rtcm::get_MSM_header(unsigned int msg_number,
         int smooth_int,
         bool divergence_free,
         bool more_messages)
+{
+    Rtcm::write_MSM_header_fields(writer, msg_number,
+             obs_time,
+             ref_id,
+             clock_steering_indicator,
+             external_clock_indicator,
+             smooth_int,
+             divergence_free,
+             more_messages);
+
+    Rtcm::set_DF394(pseudoranges);
+    Rtcm::set_DF395(pseudoranges);
+
+    writer.append(DF394);
+    writer.append(DF395);
+    writer.append(Rtcm::set_DF396(pseudoranges));
+}
+
+
+void Rtcm::write_MSM_header_fields(Rtcm_Bit_Writer & writer, unsigned int msg_number,
+        double obs_time,
+        unsigned int ref_id,
+        unsigned int clock_steering_indicator,
+        unsigned int external_clock_indicator,
+        int smooth_int,
+        bool divergence_free,
+        bool more_messages)
 {
     Rtcm::set_DF002(msg_number);
     Rtcm::set_DF003(ref_id);
@@ -1640,31 +1682,21 @@ std::string Rtcm::get_MSM_header(unsigned int msg_number,
     Rtcm::set_DF417(divergence_free);
     Rtcm::set_DF418(smooth_int);
 
-    Rtcm::set_DF394(pseudoranges);
-    Rtcm::set_DF395(pseudoranges);
-
-    std::string header = DF002.to_string() + DF003.to_string();
-    header += DF004.to_string();
-    header = header + DF393.to_string() +
-            DF409.to_string() +
-            DF001_.to_string() +
-            DF411.to_string() +
-            DF417.to_string() +
-            DF412.to_string() +
-            DF418.to_string() +
-            DF394.to_string() +
-            DF395.to_string() +
-            Rtcm::set_DF396(pseudoranges);
-
-    return header;
+    writer.append(DF002);
+    writer.append(DF003);
+    writer.append(DF004);
+    writer.append(DF393);
+    writer.append(DF409);
+    writer.append(DF001_);
+    writer.append(DF411);
+    writer.append(DF417);
+    writer.append(DF412);
+    writer.append(DF418);
 }
 
 
-std::string Rtcm::get_MSM_1_content_sat_data(const std::map<int, Gnss_Synchro> & pseudoranges)
+void Rtcm::write_MSM_1_content_sat_data(Rtcm_Bit_Writer & writer, const std::map<int, Gnss_Synchro> & pseudoranges)
 {
-    std::string sat_data;
-    sat_data.clear();
-
     Rtcm::set_DF394(pseudoranges);
     unsigned int num_satellites = DF394.count();
 
@@ -1690,17 +1722,13 @@ std::string Rtcm::get_MSM_1_content_sat_data(const std::map<int, Gnss_Synchro> &
     for(unsigned int nsat = 0; nsat < num_satellites; nsat++)
         {
             Rtcm::set_DF398( ordered_by_PRN_pos.at(nsat).second );
-            sat_data += DF398.to_string();
+            writer.append(DF398);
         }
-
-    return sat_data;
 }
 
 
-std::string Rtcm::get_MSM_1_content_signal_data(const std::map<int, Gnss_Synchro> & pseudoranges)
+void Rtcm::write_MSM_1_content_signal_data(Rtcm_Bit_Writer & writer, const std::map<int, Gnss_Synchro> & pseudoranges)
 {
-    std::string signal_data;
-    signal_data.clear();
     unsigned int Ncells = pseudoranges.size();
 
     std::vector<std::pair<int, Gnss_Synchro> > pseudoranges_vector;
@@ -1717,13 +1745,11 @@ std::string Rtcm::get_MSM_1_content_signal_data(const std::map<int, Gnss_Synchro
     std::reverse(ordered_by_signal.begin(), ordered_by_signal.end());
     std::vector<std::pair<int, Gnss_Synchro> > ordered_by_PRN_pos = Rtcm::sort_by_PRN_mask(ordered_by_signal);
 
-    for(unsigned int cell = 0; cell < Ncells ; cell++)
-           {
-               Rtcm::set_DF400(ordered_by_PRN_pos.at( cell ).second);
-               signal_data += DF400.to_string();
-           }
-
-    return signal_data;
+    for(unsigned int cell = 0; cell < Ncells; cell++)
+        {
+            Rtcm::set_DF400(ordered_by_PRN_pos.at( cell ).second);
+            writer.append(DF400);
+        }
 }
 
 
@@ -1759,7 +1785,8 @@ std::string Rtcm::print_MSM_2( const Gps_Ephemeris & gps_eph,
             msg_number = 1072;
         }
 
-    std::string header = Rtcm::get_MSM_header(msg_number,
+    msg_writer.clear();
+    Rtcm::write_MSM_header(msg_writer, msg_number,
              obs_time,
              pseudoranges,
              ref_id,
@@ -1769,11 +1796,11 @@ std::string Rtcm::print_MSM_2( const Gps_Ephemeris & gps_eph,
              divergence_free,
              more_messages);
 
-    std::string sat_data = Rtcm::get_MSM_1_content_sat_data(pseudoranges);
+    Rtcm::write_MSM_1_content_sat_data(msg_writer, pseudoranges);
 
-    std::string signal_data = Rtcm::get_MSM_2_content_signal_data(gps_eph, gps_cnav_eph, gal_eph, obs_time, pseudoranges);
+    Rtcm::write_MSM_2_content_signal_data(msg_writer, gps_eph, gps_cnav_eph, gal_eph, obs_time, pseudoranges);
 
-    std::string message = build_message(header + sat_data + signal_data);
+    std::string message = msg_writer.frame();
     if(server_is_running)
         {
             rtcm_message_queue->push(message);
@@ -1783,13 +1810,8 @@ std::string Rtcm::print_MSM_2( const Gps_Ephemeris & gps_eph,
 }
 
 
-std::string Rtcm::get_MSM_2_content_signal_data(const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const std::map<int, Gnss_Synchro> & pseudoranges)
+void Rtcm::write_MSM_2_content_signal_data(Rtcm_Bit_Writer & writer, const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const std::map<int, Gnss_Synchro> & pseudoranges)
 {
-    std::string signal_data;
-    std::string first_data_type;
-    std::string second_data_type;
-    std::string third_data_type;
-
     unsigned int Ncells = pseudoranges.size();
 
     std::vector<std::pair<int, Gnss_Synchro> > pseudoranges_vector;
@@ -1806,18 +1828,23 @@ std::string Rtcm::get_MSM_2_content_signal_data(const Gps_Ephemeris & ephNAV, co
     std::reverse(ordered_by_signal.begin(), ordered_by_signal.end());
     std::vector<std::pair<int, Gnss_Synchro> > ordered_by_PRN_pos = Rtcm::sort_by_PRN_mask(ordered_by_signal);
 
-    for(unsigned int cell = 0; cell < Ncells ; cell++)
+    for(unsigned int cell = 0; cell < Ncells; cell++)
         {
             Rtcm::set_DF401(ordered_by_PRN_pos.at( cell ).second);
+            writer.append(DF401);
+        }
+
+    for(unsigned int cell = 0; cell < Ncells; cell++)
+        {
             Rtcm::set_DF402(ephNAV, ephCNAV, ephFNAV, obs_time, ordered_by_PRN_pos.at( cell ).second);
-            Rtcm::set_DF420(ordered_by_PRN_pos.at( cell ).second);
-            first_data_type += DF401.to_string();
-            second_data_type += DF402.to_string();
-            third_data_type += DF420.to_string();
+            writer.append(DF402);
         }
 
-    signal_data = first_data_type + second_data_type + third_data_type;
-    return signal_data;
+    for(unsigned int cell = 0; cell < Ncells; cell++)
+        {
+            Rtcm::set_DF420(ordered_by_PRN_pos.at( cell ).second);
+            writer.append(DF420);
+        }
 }
 
 
@@ -1854,7 +1881,8 @@ std::string Rtcm::print_MSM_3( const Gps_Ephemeris & gps_eph,
             msg_number = 1073;
         }
 
-    std::string header = Rtcm::get_MSM_header(msg_number,
+    msg_writer.clear();
+    Rtcm::write_MSM_header(msg_writer, msg_number,
              obs_time,
              pseudoranges,
              ref_id,
@@ -1864,11 +1892,11 @@ std::string Rtcm::print_MSM_3( const Gps_Ephemeris & gps_eph,
              divergence_free,
              more_messages);
 
-    std::string sat_data = Rtcm::get_MSM_1_content_sat_data(pseudoranges);
+    Rtcm::write_MSM_1_content_sat_data(msg_writer, pseudoranges);
 
-    std::string signal_data = Rtcm::get_MSM_3_content_signal_data(gps_eph, gps_cnav_eph, gal_eph, obs_time, pseudoranges);
+    Rtcm::write_MSM_3_content_signal_data(msg_writer, gps_eph, gps_cnav_eph, gal_eph, obs_time, pseudoranges);
 
-    std::string message = build_message(header + sat_data + signal_data);
+    std::string message = msg_writer.frame();
     if(server_is_running)
         {
             rtcm_message_queue->push(message);
@@ -1878,14 +1906,8 @@ std::string Rtcm::print_MSM_3( const Gps_Ephemeris & gps_eph,
 }
 
 
-std::string Rtcm::get_MSM_3_content_signal_data(const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const std::map<int, Gnss_Synchro> & pseudoranges)
+void Rtcm::write_MSM_3_content_signal_data(Rtcm_Bit_Writer & writer, const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const std::map<int, Gnss_Synchro> & pseudoranges)
 {
-    std::string signal_data;
-    std::string first_data_type;
-    std::string second_data_type;
-    std::string third_data_type;
-    std::string fourth_data_type;
-
     unsigned int Ncells = pseudoranges.size();
 
     std::vector<std::pair<int, Gnss_Synchro> > pseudoranges_vector;
@@ -1902,20 +1924,29 @@ std::string Rtcm::get_MSM_3_content_signal_data(const Gps_Ephemeris & ephNAV, co
     std::reverse(ordered_by_signal.begin(), ordered_by_signal.end());
     std::vector<std::pair<int, Gnss_Synchro> > ordered_by_PRN_pos = Rtcm::sort_by_PRN_mask(ordered_by_signal);
 
-    for(unsigned int cell = 0; cell < Ncells ; cell++)
+    for(unsigned int cell = 0; cell < Ncells; cell++)
         {
             Rtcm::set_DF400(ordered_by_PRN_pos.at( cell ).second);
+            writer.append(DF400);
+        }
+
+    for(unsigned int cell = 0; cell < Ncells; cell++)
+        {
             Rtcm::set_DF401(ordered_by_PRN_pos.at( cell ).second);
+            writer.append(DF401);
+        }
+
+    for(unsigned int cell = 0; cell < Ncells; cell++)
+        {
             Rtcm::set_DF402(ephNAV, ephCNAV, ephFNAV, obs_time, ordered_by_PRN_pos.at( cell ).second);
-            Rtcm::set_DF420(ordered_by_PRN_pos.at( cell ).second);
-            first_data_type += DF400.to_string();
-            second_data_type += DF401.to_string();
-            third_data_type += DF402.to_string();
-            fourth_data_type += DF420.to_string();
+            writer.append(DF402);
         }
 
-    signal_data = first_data_type + second_data_type + third_data_type + fourth_data_type;
-    return signal_data;
+    for(unsigned int cell = 0; cell < Ncells; cell++)
+        {
+            Rtcm::set_DF420(ordered_by_PRN_pos.at( cell ).second);
+            writer.append(DF420);
+        }
 }
 
 
@@ -1951,9 +1982,11 @@ std::string Rtcm::print_MSM_4( const Gps_Ephemeris & gps_eph,
             msg_number = 1074;
         }
 
-    std::string header = Rtcm::get_MSM_header(msg_number,
+    Rtcm::compute_MSM_epoch(gps_eph, gps_cnav_eph, gal_eph, obs_time, pseudoranges);
+
+    msg_writer.clear();
+    Rtcm::write_MSM_header_fields(msg_writer, msg_number,
              obs_time,
-             pseudoranges,
              ref_id,
              clock_steering_indicator,
              external_clock_indicator,
@@ -1961,11 +1994,9 @@ std::string Rtcm::print_MSM_4( const Gps_Ephemeris & gps_eph,
              divergence_free,
              more_messages);
 
-    std::string sat_data = Rtcm::get_MSM_4_content_sat_data(pseudoranges);
+    Rtcm::write_MSM_full_content(msg_writer, 4);
 
-    std::string signal_data = Rtcm::get_MSM_4_content_signal_data(gps_eph, gps_cnav_eph, gal_eph, obs_time, pseudoranges);
-
-    std::string message = build_message(header + sat_data + signal_data);
+    std::string message = msg_writer.frame();
     if(server_is_running)
         {
             rtcm_message_queue->push(message);
@@ -1975,90 +2006,6 @@ std::string Rtcm::print_MSM_4( const Gps_Ephemeris & gps_eph,
 }
 
 
-std::string Rtcm::get_MSM_4_content_sat_data(const std::map<int, Gnss_Synchro> & pseudoranges)
-{
-    std::string sat_data;
-    std::string first_data_type;
-    std::string second_data_type;
-
-    Rtcm::set_DF394(pseudoranges);
-    unsigned int num_satellites = DF394.count();
-
-    std::vector<std::pair<int, Gnss_Synchro> > pseudoranges_vector;
-    std::map<int, Gnss_Synchro>::const_iterator gnss_synchro_iter;
-    std::vector<unsigned int> pos;
-    std::vector<unsigned int>::iterator it;
-
-    for(gnss_synchro_iter = pseudoranges.begin();
-            gnss_synchro_iter != pseudoranges.end();
-            gnss_synchro_iter++)
-        {
-            it = std::find(pos.begin(), pos.end(), 65 - gnss_synchro_iter->second.PRN);
-            if(it == pos.end())
-                {
-                    pos.push_back(65 - gnss_synchro_iter->second.PRN);
-                    pseudoranges_vector.push_back(*gnss_synchro_iter);
-                }
-        }
-
-    std::vector<std::pair<int, Gnss_Synchro> > ordered_by_PRN_pos = Rtcm::sort_by_PRN_mask(pseudoranges_vector);
-
-    for(unsigned int nsat = 0; nsat < num_satellites; nsat++)
-        {
-            Rtcm::set_DF397( ordered_by_PRN_pos.at(nsat).second );
-            Rtcm::set_DF398( ordered_by_PRN_pos.at(nsat).second );
-            first_data_type += DF397.to_string();
-            second_data_type += DF398.to_string();
-        }
-    sat_data = first_data_type + second_data_type;
-    return sat_data;
-}
-
-
-std::string Rtcm::get_MSM_4_content_signal_data(const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const std::map<int, Gnss_Synchro> & pseudoranges)
-{
-    std::string signal_data;
-    std::string first_data_type;
-    std::string second_data_type;
-    std::string third_data_type;
-    std::string fourth_data_type;
-    std::string fifth_data_type;
-
-    unsigned int Ncells = pseudoranges.size();
-
-    std::vector<std::pair<int, Gnss_Synchro> > pseudoranges_vector;
-    std::map<int, Gnss_Synchro>::const_iterator map_iter;
-
-    for(map_iter = pseudoranges.begin();
-            map_iter != pseudoranges.end();
-            map_iter++)
-        {
-            pseudoranges_vector.push_back(*map_iter);
-        }
-
-    std::vector<std::pair<int, Gnss_Synchro> > ordered_by_signal = Rtcm::sort_by_signal(pseudoranges_vector);
-    std::reverse(ordered_by_signal.begin(), ordered_by_signal.end());
-    std::vector<std::pair<int, Gnss_Synchro> > ordered_by_PRN_pos = Rtcm::sort_by_PRN_mask(ordered_by_signal);
-
-    for(unsigned int cell = 0; cell < Ncells ; cell++)
-        {
-            Rtcm::set_DF400(ordered_by_PRN_pos.at( cell ).second);
-            Rtcm::set_DF401(ordered_by_PRN_pos.at( cell ).second);
-            Rtcm::set_DF402(ephNAV, ephCNAV, ephFNAV, obs_time, ordered_by_PRN_pos.at( cell ).second);
-            Rtcm::set_DF420(ordered_by_PRN_pos.at( cell ).second);
-            Rtcm::set_DF403(ordered_by_PRN_pos.at( cell ).second);
-            first_data_type += DF400.to_string();
-            second_data_type += DF401.to_string();
-            third_data_type += DF402.to_string();
-            fourth_data_type += DF420.to_string();
-            fifth_data_type += DF403.to_string();
-        }
-
-    signal_data = first_data_type + second_data_type + third_data_type + fourth_data_type + fifth_data_type;
-    return signal_data;
-}
-
-
 // **********************************************************************************************
 //
 //   MESSAGE TYPE MSM5 (FULL PSEUDORANGES, PHASERANGES, PHASERANGERATE PLUS CNR)
@@ -2091,9 +2038,11 @@ std::string Rtcm::print_MSM_5( const Gps_Ephemeris & gps_eph,
             msg_number = 1075;
         }
 
-    std::string header = Rtcm::get_MSM_header(msg_number,
+    Rtcm::compute_MSM_epoch(gps_eph, gps_cnav_eph, gal_eph, obs_time, pseudoranges);
+
+    msg_writer.clear();
+    Rtcm::write_MSM_header_fields(msg_writer, msg_number,
              obs_time,
-             pseudoranges,
              ref_id,
              clock_steering_indicator,
              external_clock_indicator,
@@ -2101,11 +2050,9 @@ std::string Rtcm::print_MSM_5( const Gps_Ephemeris & gps_eph,
              divergence_free,
              more_messages);
 
-    std::string sat_data = Rtcm::get_MSM_5_content_sat_data(pseudoranges);
+    Rtcm::write_MSM_full_content(msg_writer, 5);
 
-    std::string signal_data = Rtcm::get_MSM_5_content_signal_data(gps_eph, gps_cnav_eph, gal_eph, obs_time, pseudoranges);
-
-    std::string message = build_message(header + sat_data + signal_data);
+    std::string message = msg_writer.frame();
     if(server_is_running)
         {
             rtcm_message_queue->push(message);
@@ -2115,100 +2062,6 @@ std::string Rtcm::print_MSM_5( const Gps_Ephemeris & gps_eph,
 }
 
 
-std::string Rtcm::get_MSM_5_content_sat_data(const std::map<int, Gnss_Synchro> & pseudoranges)
-{
-    std::string sat_data;
-    std::string first_data_type;
-    std::string second_data_type;
-    std::string third_data_type;
-    std::string fourth_data_type;
-
-    Rtcm::set_DF394(pseudoranges);
-    unsigned int num_satellites = DF394.count();
-
-    std::vector<std::pair<int, Gnss_Synchro> > pseudoranges_vector;
-    std::map<int, Gnss_Synchro>::const_iterator gnss_synchro_iter;
-    std::vector<unsigned int> pos;
-    std::vector<unsigned int>::iterator it;
-
-    for(gnss_synchro_iter = pseudoranges.begin();
-            gnss_synchro_iter != pseudoranges.end();
-            gnss_synchro_iter++)
-        {
-            it = std::find(pos.begin(), pos.end(), 65 - gnss_synchro_iter->second.PRN);
-            if(it == pos.end())
-                {
-                    pos.push_back(65 - gnss_synchro_iter->second.PRN);
-                    pseudoranges_vector.push_back(*gnss_synchro_iter);
-                }
-        }
-
-    std::vector<std::pair<int, Gnss_Synchro> > ordered_by_PRN_pos = Rtcm::sort_by_PRN_mask(pseudoranges_vector);
-
-    for(unsigned int nsat = 0; nsat < num_satellites; nsat++)
-        {
-            Rtcm::set_DF397( ordered_by_PRN_pos.at(nsat).second );
-            Rtcm::set_DF398( ordered_by_PRN_pos.at(nsat).second );
-            Rtcm::set_DF399( ordered_by_PRN_pos.at(nsat).second );
-            std::bitset<4> reserved = std::bitset<4>("0000");
-            first_data_type += DF397.to_string();
-            second_data_type += reserved.to_string();
-            third_data_type += DF398.to_string();
-            fourth_data_type += DF399.to_string();
-        }
-    sat_data = first_data_type + second_data_type + third_data_type + fourth_data_type;
-    return sat_data;
-}
-
-
-std::string Rtcm::get_MSM_5_content_signal_data(const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const std::map<int, Gnss_Synchro> & pseudoranges)
-{
-    std::string signal_data;
-    std::string first_data_type;
-    std::string second_data_type;
-    std::string third_data_type;
-    std::string fourth_data_type;
-    std::string fifth_data_type;
-    std::string sixth_data_type;
-
-    unsigned int Ncells = pseudoranges.size();
-
-    std::vector<std::pair<int, Gnss_Synchro> > pseudoranges_vector;
-    std::map<int, Gnss_Synchro>::const_iterator map_iter;
-
-    for(map_iter = pseudoranges.begin();
-            map_iter != pseudoranges.end();
-            map_iter++)
-        {
-            pseudoranges_vector.push_back(*map_iter);
-        }
-
-    std::vector<std::pair<int, Gnss_Synchro> > ordered_by_signal = Rtcm::sort_by_signal(pseudoranges_vector);
-    std::reverse(ordered_by_signal.begin(), ordered_by_signal.end());
-    std::vector<std::pair<int, Gnss_Synchro> > ordered_by_PRN_pos = Rtcm::sort_by_PRN_mask(ordered_by_signal);
-
-    for(unsigned int cell = 0; cell < Ncells ; cell++)
-        {
-            Rtcm::set_DF400(ordered_by_PRN_pos.at( cell ).second);
-            Rtcm::set_DF401(ordered_by_PRN_pos.at( cell ).second);
-            Rtcm::set_DF402(ephNAV, ephCNAV, ephFNAV, obs_time, ordered_by_PRN_pos.at( cell ).second);
-            Rtcm::set_DF420(ordered_by_PRN_pos.at( cell ).second);
-            Rtcm::set_DF403(ordered_by_PRN_pos.at( cell ).second);
-            Rtcm::set_DF404(ordered_by_PRN_pos.at( cell ).second);
-            first_data_type += DF400.to_string();
-            second_data_type += DF401.to_string();
-            third_data_type += DF402.to_string();
-            fourth_data_type += DF420.to_string();
-            fifth_data_type += DF403.to_string();
-            sixth_data_type += DF404.to_string();
-        }
-
-    signal_data = first_data_type + second_data_type + third_data_type + fourth_data_type + fifth_data_type + sixth_data_type;
-    return signal_data;
-}
-
-
-
 // **********************************************************************************************
 //
 //   MESSAGE TYPE MSM6 (FULL PSEUDORANGES AND PHASERANGES PLUS CNR, HIGH RESOLUTION)
@@ -2241,9 +2094,11 @@ std::string Rtcm::print_MSM_6( const Gps_Ephemeris & gps_eph,
             msg_number = 1076;
         }
 
-    std::string header = Rtcm::get_MSM_header(msg_number,
+    Rtcm::compute_MSM_epoch(gps_eph, gps_cnav_eph, gal_eph, obs_time, pseudoranges);
+
+    msg_writer.clear();
+    Rtcm::write_MSM_header_fields(msg_writer, msg_number,
              obs_time,
-             pseudoranges,
              ref_id,
              clock_steering_indicator,
              external_clock_indicator,
@@ -2251,11 +2106,9 @@ std::string Rtcm::print_MSM_6( const Gps_Ephemeris & gps_eph,
              divergence_free,
              more_messages);
 
-    std::string sat_data = Rtcm::get_MSM_4_content_sat_data(pseudoranges);
-
-    std::string signal_data = Rtcm::get_MSM_6_content_signal_data(gps_eph, gps_cnav_eph, gal_eph, obs_time, pseudoranges);
+    Rtcm::write_MSM_full_content(msg_writer, 6);
 
-    std::string message = build_message(header + sat_data + signal_data);
+    std::string message = msg_writer.frame();
     if(server_is_running)
         {
             rtcm_message_queue->push(message);
@@ -2265,51 +2118,6 @@ std::string Rtcm::print_MSM_6( const Gps_Ephemeris & gps_eph,
 }
 
 
-std::string Rtcm::get_MSM_6_content_signal_data(const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const std::map<int, Gnss_Synchro> & pseudoranges)
-{
-    std::string signal_data;
-    std::string first_data_type;
-    std::string second_data_type;
-    std::string third_data_type;
-    std::string fourth_data_type;
-    std::string fifth_data_type;
-
-    unsigned int Ncells = pseudoranges.size();
-
-    std::vector<std::pair<int, Gnss_Synchro> > pseudoranges_vector;
-    std::map<int, Gnss_Synchro>::const_iterator map_iter;
-
-    for(map_iter = pseudoranges.begin();
-            map_iter != pseudoranges.end();
-            map_iter++)
-        {
-            pseudoranges_vector.push_back(*map_iter);
-        }
-
-    std::vector<std::pair<int, Gnss_Synchro> > ordered_by_signal = Rtcm::sort_by_signal(pseudoranges_vector);
-    std::reverse(ordered_by_signal.begin(), ordered_by_signal.end());
-    std::vector<std::pair<int, Gnss_Synchro> > ordered_by_PRN_pos = Rtcm::sort_by_PRN_mask(ordered_by_signal);
-
-    for(unsigned int cell = 0; cell < Ncells ; cell++)
-        {
-            Rtcm::set_DF405(ordered_by_PRN_pos.at( cell ).second);
-            Rtcm::set_DF406(ordered_by_PRN_pos.at( cell ).second);
-            Rtcm::set_DF407(ephNAV, ephCNAV, ephFNAV, obs_time, ordered_by_PRN_pos.at( cell ).second);
-            Rtcm::set_DF420(ordered_by_PRN_pos.at( cell ).second);
-            Rtcm::set_DF408(ordered_by_PRN_pos.at( cell ).second);
-            first_data_type += DF405.to_string();
-            second_data_type += DF406.to_string();
-            third_data_type += DF407.to_string();
-            fourth_data_type += DF420.to_string();
-            fifth_data_type += DF408.to_string();
-        }
-
-    signal_data = first_data_type + second_data_type + third_data_type + fourth_data_type + fifth_data_type;
-    return signal_data;
-}
-
-
-
 // **********************************************************************************************
 //
 //   MESSAGE TYPE MSM7 (FULL PSEUDORANGES, PHASERANGES, PHASERANGERATE AND CNR, HIGH RESOLUTION)
@@ -2342,9 +2150,11 @@ std::string Rtcm::print_MSM_7( const Gps_Ephemeris & gps_eph,
             msg_number = 1076;
         }
 
-    std::string header = Rtcm::get_MSM_header(msg_number,
+    Rtcm::compute_MSM_epoch(gps_eph, gps_cnav_eph, gal_eph, obs_time, pseudoranges);
+
+    msg_writer.clear();
+    Rtcm::write_MSM_header_fields(msg_writer, msg_number,
              obs_time,
-             pseudoranges,
              ref_id,
              clock_steering_indicator,
              external_clock_indicator,
@@ -2352,11 +2162,9 @@ std::string Rtcm::print_MSM_7( const Gps_Ephemeris & gps_eph,
              divergence_free,
              more_messages);
 
-    std::string sat_data = Rtcm::get_MSM_5_content_sat_data(pseudoranges);
+    Rtcm::write_MSM_full_content(msg_writer, 7);
 
-    std::string signal_data = Rtcm::get_MSM_7_content_signal_data(gps_eph, gps_cnav_eph, gal_eph, obs_time, pseudoranges);
-
-    std::string message = build_message(header + sat_data + signal_data);
+    std::string message = msg_writer.frame();
     if(server_is_running)
         {
             rtcm_message_queue->push(message);
@@ -2366,53 +2174,272 @@ std::string Rtcm::print_MSM_7( const Gps_Ephemeris & gps_eph,
 }
 
 
-std::string Rtcm::get_MSM_7_content_signal_data(const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const std::map<int, Gnss_Synchro> & pseudoranges)
+// **********************************************************************************************
+//
+//   CONTENT OF MSM4, MSM5, MSM6 AND MSM7
+//
+// **********************************************************************************************
+
+namespace
+{
+// Signal ID of the observable (Tables 3.5-91 and 3.5-99), 0 if it has none
+unsigned int msm_signal_id(const Gnss_Synchro & gnss_synchro)
 {
-    std::string signal_data;
-    std::string first_data_type;
-    std::string second_data_type;
-    std::string third_data_type;
-    std::string fourth_data_type;
-    std::string fifth_data_type;
-    std::string sixth_data_type;
+    const char s0 = gnss_synchro.Signal[0];
+    const char s1 = s0 == '\0' ? '\0' : gnss_synchro.Signal[1];
+    if (gnss_synchro.System == 'G')
+        {
+            if (s0 == '1' && s1 == 'C') return 2;
+            if (s0 == '2' && s1 == 'S') return 15;
+            if (s0 == '5' && s1 == 'X') return 24;
+        }
+    if (gnss_synchro.System == 'E')
+        {
+            if (s0 == '1' && s1 == 'B') return 4;
+            if (s0 == '5' && s1 == 'X') return 24;
+            if (s0 == '7' && s1 == 'X') return 16;
+        }
+    return 0;
+}
 
-    unsigned int Ncells = pseudoranges.size();
 
-    std::vector<std::pair<int, Gnss_Synchro> > pseudoranges_vector;
-    std::map<int, Gnss_Synchro>::const_iterator map_iter;
+double msm_wavelength(unsigned int signal_id)
+{
+    switch (signal_id)
+    {
+    case 2:
+        return GPS_C_m_s / GPS_L1_FREQ_HZ;
+    case 15:
+        return GPS_C_m_s / GPS_L2_FREQ_HZ;
+    case 24:
+        return GPS_C_m_s / Galileo_E5a_FREQ_HZ;
+    case 4:
+        return GPS_C_m_s / Galileo_E1_FREQ_HZ;
+    case 16:
+        return GPS_C_m_s / 1.207140e9; // Galileo E5b
+    default:
+        return 0.0;
+    }
+}
+}
 
-    for(map_iter = pseudoranges.begin();
-            map_iter != pseudoranges.end();
-            map_iter++)
+
+void Rtcm::compute_MSM_epoch(const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const std::map<int, Gnss_Synchro> & pseudoranges)
+{
+    Msm_Epoch & e = msm_epoch;
+    e.satellite_mask = 0;
+    e.signal_mask = 0;
+    e.observation.clear();
+
+    // Masks, and the observables that fit in them
+    std::map<int, Gnss_Synchro>::const_iterator iter;
+    for(iter = pseudoranges.begin(); iter != pseudoranges.end(); iter++)
         {
-            pseudoranges_vector.push_back(*map_iter);
+            const Gnss_Synchro & obs = iter->second;
+            const unsigned int id = msm_signal_id(obs);
+            if ((id == 0) || (obs.PRN < 1) || (obs.PRN > 64))
+                {
+                    continue;
+                }
+            e.satellite_mask |= uint64_t(1) << (64 - obs.PRN);
+            e.signal_mask |= uint32_t(1) << (32 - id);
+            e.observation.push_back(&obs);
         }
 
-    std::vector<std::pair<int, Gnss_Synchro> > ordered_by_signal = Rtcm::sort_by_signal(pseudoranges_vector);
-    std::reverse(ordered_by_signal.begin(), ordered_by_signal.end());
-    std::vector<std::pair<int, Gnss_Synchro> > ordered_by_PRN_pos = Rtcm::sort_by_PRN_mask(ordered_by_signal);
+    // Position of each PRN and signal ID in the masks
+    unsigned int satellite_index[65];
+    unsigned int signal_index[33];
+    e.num_satellites = 0;
+    e.num_signals = 0;
+    for(unsigned int prn = 1; prn <= 64; prn++)
+        {
+            satellite_index[prn] = e.num_satellites;
+            if ((e.satellite_mask >> (64 - prn)) & 1) e.num_satellites++;
+        }
+    for(unsigned int id = 1; id <= 32; id++)
+        {
+            signal_index[id] = e.num_signals;
+            if ((e.signal_mask >> (32 - id)) & 1) e.num_signals++;
+        }
 
-    for(unsigned int cell = 0; cell < Ncells ; cell++)
+    // Each cell takes the first observable of its satellite and signal, and
+    // the satellite data come from the first observable of the satellite
+    e.slot.assign(e.num_satellites * e.num_signals, -1);
+    e.first.assign(e.num_satellites, -1);
+    for(unsigned int k = 0; k < e.observation.size(); k++)
         {
-            Rtcm::set_DF405(ordered_by_PRN_pos.at( cell ).second);
-            Rtcm::set_DF406(ordered_by_PRN_pos.at( cell ).second);
-            Rtcm::set_DF407(ephNAV, ephCNAV, ephFNAV, obs_time, ordered_by_PRN_pos.at( cell ).second);
-            Rtcm::set_DF420(ordered_by_PRN_pos.at( cell ).second);
-            Rtcm::set_DF408(ordered_by_PRN_pos.at( cell ).second);
-            Rtcm::set_DF404(ordered_by_PRN_pos.at( cell ).second);
-            first_data_type += DF405.to_string();
-            second_data_type += DF406.to_string();
-            third_data_type += DF407.to_string();
-            fourth_data_type += DF420.to_string();
-            fifth_data_type += DF408.to_string();
-            sixth_data_type += DF404.to_string();
+            const Gnss_Synchro & obs = *e.observation[k];
+            const unsigned int sat = satellite_index[obs.PRN];
+            const unsigned int cell = sat * e.num_signals + signal_index[msm_signal_id(obs)];
+            if (e.first[sat] < 0) e.first[sat] = k;
+            if (e.slot[cell] < 0) e.slot[cell] = k;
+        }
+
+    const double meters_to_miliseconds = GPS_C_m_s * 0.001;
+    e.rough_range.resize(e.num_satellites);
+    e.rough_rate.resize(e.num_satellites);
+    for(unsigned int sat = 0; sat < e.num_satellites; sat++)
+        {
+            const Gnss_Synchro & obs = *e.observation[e.first[sat]];
+            const double rough_range = std::round(obs.Pseudorange_m / meters_to_miliseconds / TWO_N10);
+            // 0 marks an invalid rough range
+            e.rough_range[sat] = ((rough_range <= 0.0) || (rough_range > 255.0 * 1024.0)) ? 0 : static_cast<unsigned int>(rough_range);
+            e.rough_rate[sat] = std::round(- obs.Carrier_Doppler_hz * msm_wavelength(msm_signal_id(obs)));
         }
 
-    signal_data = first_data_type + second_data_type + third_data_type + fourth_data_type + fifth_data_type + sixth_data_type;
-    return signal_data;
+    e.fine_range.clear();
+    e.fine_phase.clear();
+    e.fine_rate.clear();
+    e.lock_time_s.clear();
+    e.cnr.clear();
+    for(unsigned int cell = 0; cell < e.slot.size(); cell++)
+        {
+            if (e.slot[cell] < 0) continue;
+            const Gnss_Synchro & obs = *e.observation[e.slot[cell]];
+            const unsigned int sat = cell / e.num_signals;
+            const double lambda = msm_wavelength(msm_signal_id(obs));
+            const double rough_range_m = e.rough_range[sat] * meters_to_miliseconds * TWO_N10;
+
+            e.fine_range.push_back(obs.Pseudorange_m - rough_range_m);
+
+            double phrng_m = (obs.Carrier_phase_rads / GPS_TWO_PI) * lambda - rough_range_m;
+            /* Substract phase - pseudorange integer cycle offset */
+            double cp = obs.Carrier_phase_rads / GPS_TWO_PI;
+            if(std::fabs(phrng_m - cp) > 1171.0)
+                {
+                    cp = std::round(phrng_m / lambda) * lambda;
+                }
+            e.fine_phase.push_back(phrng_m - cp);
+
+            e.fine_rate.push_back(- obs.Carrier_Doppler_hz * lambda - e.rough_rate[sat]);
+            e.lock_time_s.push_back(Rtcm::msm_lock_time(ephNAV, ephCNAV, ephFNAV, obs_time, obs));
+            e.cnr.push_back(obs.CN0_dB_hz);
+        }
 }
 
 
+void Rtcm::write_MSM_full_content(Rtcm_Bit_Writer & writer, unsigned int msm)
+{
+    const Msm_Epoch & e = msm_epoch;
+    const double meters_to_miliseconds = GPS_C_m_s * 0.001;
+    const bool high_resolution = (msm == 6) || (msm == 7);
+    const bool phaserange_rate = (msm == 5) || (msm == 7);
+    const unsigned int num_satellites = e.num_satellites;
+    const unsigned int num_cells = e.fine_range.size();
+
+    // DF394, DF395 and the cell mask DF396, in words of up to 64 bits
+    writer.append(e.satellite_mask, 64);
+    writer.append(e.signal_mask, 32);
+    for(unsigned int first = 0; first < e.slot.size(); first += 64)
+        {
+            const unsigned int n = std::min(static_cast<unsigned int>(e.slot.size()) - first, 64u);
+            uint64_t word = 0;
+            for(unsigned int i = 0; i < n; i++)
+                {
+                    word = (word << 1) | (e.slot[first + i] >= 0 ? 1 : 0);
+                }
+            writer.append(word, n);
+        }
+
+    // Satellite data: DF397, extended info (MSM5 and MSM7), DF398, DF399 (MSM5 and MSM7)
+    for(unsigned int sat = 0; sat < num_satellites; sat++)
+        {
+            writer.append(e.rough_range[sat] == 0 ? 255 : e.rough_range[sat] >> 10, 8);
+        }
+    if (phaserange_rate)
+        {
+            for(unsigned int sat = 0; sat < num_satellites; sat++)
+                {
+                    writer.append(0, 4);
+                }
+        }
+    for(unsigned int sat = 0; sat < num_satellites; sat++)
+        {
+            writer.append(e.rough_range[sat] & 0x3FFu, 10);
+        }
+    if (phaserange_rate)
+        {
+            for(unsigned int sat = 0; sat < num_satellites; sat++)
+                {
+                    double rate = e.rough_rate[sat];
+                    if((rate < -8191) || (rate > 8191)) rate = -8192;
+                    writer.append(static_cast<int64_t>(rate), 14);
+                }
+        }
+
+    // Signal data: fine pseudorange (DF400 or DF405), fine phaserange (DF401
+    // or DF406), lock time (DF402 or DF407), half-cycle ambiguity (DF420), CNR
+    // (DF403 or DF408) and fine phaserange rate (DF404, MSM5 and MSM7)
+    const unsigned int range_bits = high_resolution ? 20 : 15;
+    const double range_unit = meters_to_miliseconds * (high_resolution ? TWO_N29 : TWO_N24);
+    for(unsigned int cell = 0; cell < num_cells; cell++)
+        {
+            const double psrng_m = e.fine_range[cell];
+            int64_t fine_pseudorange = - (int64_t(1) << (range_bits - 1));
+            if((psrng_m != 0.0) && (std::fabs(psrng_m) <= 292.7))
+                {
+                    fine_pseudorange = static_cast<int64_t>(std::round(psrng_m / range_unit));
+                }
+            writer.append(fine_pseudorange, range_bits);
+        }
+
+    const unsigned int phase_bits = high_resolution ? 24 : 22;
+    const double phase_unit = meters_to_miliseconds * (high_resolution ? TWO_N31 : TWO_N29);
+    for(unsigned int cell = 0; cell < num_cells; cell++)
+        {
+            const double phrng_m = e.fine_phase[cell];
+            int64_t fine_phaserange = - (int64_t(1) << (phase_bits - 1));
+            if((phrng_m != 0.0) && (std::fabs(phrng_m) <= 1171.0))
+                {
+                    fine_phaserange = static_cast<int64_t>(std::round(phrng_m / phase_unit));
+                }
+            writer.append(fine_phaserange, phase_bits);
+        }
+
+    for(unsigned int cell = 0; cell < num_cells; cell++)
+        {
+            if (high_resolution)
+                {
+                    writer.append(Rtcm::msm_extended_lock_time_indicator(e.lock_time_s[cell]), 10);
+                }
+            else
+                {
+                    writer.append(Rtcm::msm_lock_time_indicator(e.lock_time_s[cell]), 4);
+                }
+        }
+
+    for(unsigned int cell = 0; cell < num_cells; cell++)
+        {
+            writer.append(1, 1); // todo: read the half-cycle ambiguity from gnss_synchro
+        }
+
+    for(unsigned int cell = 0; cell < num_cells; cell++)
+        {
+            if (high_resolution)
+                {
+                    writer.append(static_cast<unsigned int>(std::round(e.cnr[cell] / 0.0625)), 10);
+                }
+            else
+                {
+                    writer.append(static_cast<unsigned int>(std::round(e.cnr[cell])), 6);
+                }
+        }
+
+    if (phaserange_rate)
+        {
+            for(unsigned int cell = 0; cell < num_cells; cell++)
+                {
+                    const double phrr = e.fine_rate[cell];
+                    int64_t fine_phaserange_rate = -16384;
+                    if((phrr != 0.0) && (std::fabs(phrr) <= 1.6384))
+                        {
+                            fine_phaserange_rate = static_cast<int64_t>(std::round(phrr / 0.0001));
+                        }
+                    writer.append(fine_phaserange_rate, 15);
+                }
+        }
+}
+
 
 // *****************************************************************************************************
 // Some utilities
@@ -2651,6 +2678,26 @@ unsigned int Rtcm::lock_time(const Galileo_Ephemeris & eph, double obs_time, con
 }
 
 
+unsigned int Rtcm::msm_lock_time(const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const Gnss_Synchro & gnss_synchro)
+{
+    unsigned int lock_time_period_s = 0;
+    std::string sig_(gnss_synchro.Signal);
+    if(sig_.compare("1C"))
+        {
+            lock_time_period_s = Rtcm::lock_time(ephNAV, obs_time, gnss_synchro);
+        }
+    if(sig_.compare("2S"))
+        {
+            lock_time_period_s = Rtcm::lock_time(ephCNAV, obs_time, gnss_synchro);
+        }
+    if(sig_.compare("1B") || sig_.compare("5X") || sig_.compare("7X") || sig_.compare("8X"))
+        {
+            lock_time_period_s = Rtcm::lock_time(ephFNAV, obs_time, gnss_synchro);
+        }
+    return lock_time_period_s;
+}
+
+
 unsigned int Rtcm::lock_time_indicator(unsigned int lock_time_period_s)
 {
     // Table 3.4-2
@@ -3637,11 +3684,12 @@ std::string Rtcm::set_DF396(const std::map<int, Gnss_Synchro> & pseudoranges)
             std::string s("");
             return s;
         }
-    std::vector<std::vector<bool> > matrix(num_signals, std::vector<bool>());
 
     std::string sig;
     std::vector<unsigned int> list_of_sats;
     std::vector<int> list_of_signals;
+    // signal mask position of each observable, or -1
+    std::vector<int> signal_position;
 
     for(pseudoranges_iter = pseudoranges.begin();
             pseudoranges_iter != pseudoranges.end();
@@ -3654,31 +3702,37 @@ std::string Rtcm::set_DF396(const std::map<int, Gnss_Synchro> & pseudoranges)
 
             std::string sys(&pseudoranges_iter->second.System, 1);
 
+            int position = -1;
             if ((sig.compare("1C") == 0) && (sys.compare("G") == 0 ) )
                 {
-                    list_of_signals.push_back(32 - 2);
+                    position = 32 - 2;
                 }
             if ((sig.compare("2S") == 0) && (sys.compare("G") == 0 ) )
                 {
-                    list_of_signals.push_back(32 - 15);
+                    position = 32 - 15;
                 }
 
             if ((sig.compare("5X") == 0) && (sys.compare("G") == 0 ) )
                 {
-                    list_of_signals.push_back(32 - 24);
+                    position = 32 - 24;
                 }
             if ((sig.compare("1B") == 0) && (sys.compare("E") == 0 ) )
                 {
-                    list_of_signals.push_back(32 - 4);
+                    position = 32 - 4;
                 }
 
             if ((sig.compare("5X") == 0) && (sys.compare("E") == 0 ) )
                 {
-                    list_of_signals.push_back(32 - 24);
+                    position = 32 - 24;
                 }
             if ((sig.compare("7X") == 0) && (sys.compare("E") == 0 ) )
                 {
-                    list_of_signals.push_back(32 - 16);
+                    position = 32 - 16;
+                }
+            signal_position.push_back(position);
+            if (position >= 0)
+                {
+                    list_of_signals.push_back(position);
                 }
         }
 
@@ -3689,72 +3743,23 @@ std::string Rtcm::set_DF396(const std::map<int, Gnss_Synchro> & pseudoranges)
     std::reverse(list_of_signals.begin(), list_of_signals.end());
     list_of_signals.erase( std::unique( list_of_signals.begin(), list_of_signals.end() ), list_of_signals.end() );
 
-    // fill the matrix
-    bool value;
-
-    for(unsigned int row = 0; row < num_signals; row++)
-        {
-            for(unsigned int sat = 0; sat < num_satellites; sat++)
-                {
-                    value = false;
-                    for(pseudoranges_iter = pseudoranges.begin();
-                            pseudoranges_iter != pseudoranges.end();
-                            pseudoranges_iter++)
-                        {
-                            std::string sig_(pseudoranges_iter->second.Signal);
-                            sig = sig_.substr(0,2);
-                            std::string sys(&pseudoranges_iter->second.System, 1);
-
-                            if ((sig.compare("1C") == 0) && (sys.compare("G") == 0 ) && (list_of_signals.at(row) == 32 - 2) && (pseudoranges_iter->second.PRN == list_of_sats.at(sat) ) )
-                                {
-                                    value = true;
-                                }
-
-                            if ((sig.compare("2S") == 0) && (sys.compare("G") == 0 ) && (list_of_signals.at(row) == 32 - 15) && (pseudoranges_iter->second.PRN == list_of_sats.at(sat) ) )
-                                {
-                                    value = true;
-                                }
-
-                            if ((sig.compare("5X") == 0) && (sys.compare("G") == 0 ) && (list_of_signals.at(row) == 32 - 24) && (pseudoranges_iter->second.PRN == list_of_sats.at(sat) ) )
-                                {
-                                    value = true;
-                                }
-
-                            if ((sig.compare("1B") == 0) && (sys.compare("E") == 0 ) && (list_of_signals.at(row) == 32 - 4) && (pseudoranges_iter->second.PRN == list_of_sats.at(sat) ) )
-                                {
-                                    value = true;
-                                }
-
-                            if ((sig.compare("5X") == 0) && (sys.compare("E") == 0 ) && (list_of_signals.at(row) == 32 - 24) && (pseudoranges_iter->second.PRN == list_of_sats.at(sat) ) )
-                                {
-                                    value = true;
-                                }
-
-                            if ((sig.compare("7X") == 0) && (sys.compare("E") == 0 ) && (list_of_signals.at(row) == 32 - 16) && (pseudoranges_iter->second.PRN == list_of_sats.at(sat) ) )
-                                {
-                                    value = true;
-                                }
-                        }
-                    matrix[row].push_back(value);
-                }
-        }
-
-    // write the matrix column-wise
-    DF396.clear();
-    for(unsigned int col = 0; col < num_satellites; col++)
+    // fill the matrix, written column-wise: one bit per signal of each satellite
+    DF396.assign(num_satellites * num_signals, '0');
+    unsigned int n = 0;
+    for(pseudoranges_iter = pseudoranges.begin();
+            pseudoranges_iter != pseudoranges.end();
+            pseudoranges_iter++, n++)
         {
-            for(unsigned int row = 0; row < num_signals; row++)
+            std::vector<int>::const_iterator row = std::find(list_of_signals.begin(), list_of_signals.end(), signal_position.at(n));
+            std::vector<unsigned int>::const_iterator col = std::find(list_of_sats.begin(), list_of_sats.end(), pseudoranges_iter->second.PRN);
+            if ((row != list_of_signals.end()) && (col != list_of_sats.end()))
                 {
-                    std::string ss;
-                    if(matrix[row].at(col))
+                    unsigned int r = row - list_of_signals.begin();
+                    unsigned int c = col - list_of_sats.begin();
+                    if ((r < num_signals) && (c < num_satellites))
                         {
-                            ss = "1";
+                            DF396[c * num_signals + r] = '1';
                         }
-                    else
-                        {
-                            ss = "0";
-                        }
-                    DF396 += ss;
                 }
         }
     return DF396;
@@ -3930,22 +3935,8 @@ int Rtcm::set_DF401(const Gnss_Synchro & gnss_synchro)
 
 int Rtcm::set_DF402(const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const Gnss_Synchro & gnss_synchro)
 {
-    unsigned int lock_time_period_s = 0;
-    unsigned int lock_time_indicator;
-    std::string sig_(gnss_synchro.Signal);
-    if(sig_.compare("1C"))
-        {
-            lock_time_period_s = Rtcm::lock_time(ephNAV, obs_time, gnss_synchro);
-        }
-    if(sig_.compare("2S"))
-        {
-            lock_time_period_s = Rtcm::lock_time(ephCNAV, obs_time, gnss_synchro);
-        }
-    if(sig_.compare("1B") || sig_.compare("5X") || sig_.compare("7X") || sig_.compare("8X"))
-        {
-            lock_time_period_s = Rtcm::lock_time(ephFNAV, obs_time, gnss_synchro);
-        }
-    lock_time_indicator = Rtcm::msm_lock_time_indicator(lock_time_period_s);
+    unsigned int lock_time_period_s = Rtcm::msm_lock_time(ephNAV, ephCNAV, ephFNAV, obs_time, gnss_synchro);
+    unsigned int lock_time_indicator = Rtcm::msm_lock_time_indicator(lock_time_period_s);
     DF402 = std::bitset<4>(lock_time_indicator);
     return 0;
 }
@@ -4098,23 +4089,8 @@ int Rtcm::set_DF406(const Gnss_Synchro & gnss_synchro)
 
 int Rtcm::set_DF407(const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const Gnss_Synchro & gnss_synchro)
 {
-    unsigned int lock_time_indicator;
-    unsigned int lock_time_period_s = 0;
-
-    std::string sig_(gnss_synchro.Signal);
-    if(sig_.compare("1C"))
-        {
-            lock_time_period_s = Rtcm::lock_time(ephNAV, obs_time, gnss_synchro);
-        }
-    if(sig_.compare("2S"))
-        {
-            lock_time_period_s = Rtcm::lock_time(ephCNAV, obs_time, gnss_synchro);
-        }
-    if(sig_.compare("1B") || sig_.compare("5X") || sig_.compare("7X") || sig_.compare("8X"))
-        {
-            lock_time_period_s = Rtcm::lock_time(ephFNAV, obs_time, gnss_synchro);
-        }
-    lock_time_indicator = Rtcm::msm_extended_lock_time_indicator(lock_time_period_s);
+    unsigned int lock_time_period_s = Rtcm::msm_lock_time(ephNAV, ephCNAV, ephFNAV, obs_time, gnss_synchro);
+    unsigned int lock_time_indicator = Rtcm::msm_extended_lock_time_indicator(lock_time_period_s);
     DF407 = std::bitset<10>(lock_time_indicator);
     return 0;
 }
@@ -34,6 +34,7 @@
 
 
 #include <bitset>
+#include <cstdint>
 #include <deque>
 #include <map>
 #include <memory>
@@ -49,6 +50,8 @@
 #include "galileo_fnav_message.h"
 #include "gps_navigation_message.h"
 #include "gps_cnav_navigation_message.h"
+#include "rtcm_bit_writer.h"
+#include "rtcm_caster.h"
 
 
 /*!
@@ -279,7 +282,10 @@ public:
     bool check_CRC(const std::string & message) const;          //<! Checks that the CRC of a RTCM package is correct
 
     void run_server();                                   //<! Starts running the server
-    void stop_server();                                  //<! Stops the server
+    void stop_server();                                  //<! Stops the server or the caster
+    void run_caster(unsigned int n_threads, unsigned int max_queued_messages); //<! Starts running the multi-threaded caster instead of the server
+
+    std::vector<Rtcm_Caster::Client_Stats> caster_client_stats() const; //<! Throughput counters of the clients of the caster
 
     void send_message(const std::string & message);      //<! Sends a message through the server to all connected clients
     bool is_server_running() const;                      //<! Returns true if the server is running, false otherwise
@@ -303,7 +309,7 @@ private:
 
     std::bitset<152> get_MT1005_test();
 
-    std::string get_MSM_header(unsigned int msg_number,
+    void write_MSM_header(Rtcm_Bit_Writer & writer, unsigned int msg_number,
             double obs_time,
             const std::map<int, Gnss_Synchro> & pseudoranges,
             unsigned int ref_id,
@@ -313,17 +319,46 @@ private:
             bool divergence_free,
             bool more_messages);
 
-    std::string get_MSM_1_content_sat_data(const std::map<int, Gnss_Synchro> & pseudoranges);
-    std::string get_MSM_4_content_sat_data(const std::map<int, Gnss_Synchro> & pseudoranges);
-    std::string get_MSM_5_content_sat_data(const std::map<int, Gnss_Synchro> & pseudoranges);
+    void write_MSM_header_fields(Rtcm_Bit_Writer & writer, unsigned int msg_number,
+            double obs_time,
+            unsigned int ref_id,
+            unsigned int clock_steering_indicator,
+            unsigned int external_clock_indicator,
+            int smooth_int,
+            bool divergence_free,
+            bool more_messages);
+
+    void write_MSM_1_content_sat_data(Rtcm_Bit_Writer & writer, const std::map<int, Gnss_Synchro> & pseudoranges);
+
+    void write_MSM_1_content_signal_data(Rtcm_Bit_Writer & writer, const std::map<int, Gnss_Synchro> & pseudoranges);
+    void write_MSM_2_content_signal_data(Rtcm_Bit_Writer & writer, const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const std::map<int, Gnss_Synchro> & pseudoranges);
+    void write_MSM_3_content_signal_data(Rtcm_Bit_Writer & writer, const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const std::map<int, Gnss_Synchro> & pseudoranges);
 
-    std::string get_MSM_1_content_signal_data(const std::map<int, Gnss_Synchro> & pseudoranges);
-    std::string get_MSM_2_content_signal_data(const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const std::map<int, Gnss_Synchro> & pseudoranges);
-    std::string get_MSM_3_content_signal_data(const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const std::map<int, Gnss_Synchro> & pseudoranges);
-    std::string get_MSM_4_content_signal_data(const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const std::map<int, Gnss_Synchro> & pseudoranges);
-    std::string get_MSM_5_content_signal_data(const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const std::map<int, Gnss_Synchro> & pseudoranges);
-    std::string get_MSM_6_content_signal_data(const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const std::map<int, Gnss_Synchro> & pseudoranges);
-    std::string get_MSM_7_content_signal_data(const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const std::map<int, Gnss_Synchro> & pseudoranges);
+    /*
+     * Observables of an epoch for MSM4 to MSM7, as flat arrays in the order
+     * of the satellite and cell masks. Gathered in one pass over the map and
+     * reused from message to message.
+     */
+    struct Msm_Epoch
+    {
+        uint64_t satellite_mask;                         // DF394, PRN 1 is the MSB
+        uint32_t signal_mask;                            // DF395, signal ID 1 is the MSB
+        unsigned int num_satellites;
+        unsigned int num_signals;
+        std::vector<const Gnss_Synchro *> observation;   // observables with a known signal
+        std::vector<int> slot;                           // observation of each satellite and signal, or -1
+        std::vector<int> first;                          // first observation of each satellite
+        std::vector<unsigned int> rough_range;           // of each satellite [2^-10 ms]
+        std::vector<double> rough_rate;                  // of each satellite [m/s]
+        std::vector<double> fine_range;                  // of each cell [m]
+        std::vector<double> fine_phase;                  // of each cell [m]
+        std::vector<double> fine_rate;                   // of each cell [m/s]
+        std::vector<unsigned int> lock_time_s;           // of each cell
+        std::vector<double> cnr;                         // of each cell [dB-Hz]
+    };
+    Msm_Epoch msm_epoch;
+    void compute_MSM_epoch(const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const std::map<int, Gnss_Synchro> & pseudoranges);
+    void write_MSM_full_content(Rtcm_Bit_Writer & writer, unsigned int msm); //<! Masks, satellite and signal data of MSM4 to MSM7 from msm_epoch
 
     //
     // Utilities
@@ -342,6 +377,7 @@ private:
     unsigned int lock_time_indicator(unsigned int lock_time_period_s);
     unsigned int msm_lock_time_indicator(unsigned int lock_time_period_s);
     unsigned int msm_extended_lock_time_indicator(unsigned int lock_time_period_s);
+    unsigned int msm_lock_time(const Gps_Ephemeris & ephNAV, const Gps_CNAV_Ephemeris & ephCNAV, const Galileo_Ephemeris & ephFNAV, double obs_time, const Gnss_Synchro & gnss_synchro);
 
     //
     // Classes for TCP communication
@@ -772,6 +808,7 @@ private:
     std::thread t;
     std::thread tq;
     std::list<Rtcm::Tcp_Server> servers;
+    std::unique_ptr<Rtcm_Caster> caster;
     bool server_is_running;
     void stop_service();
 
@@ -780,8 +817,8 @@ private:
     //
     std::bitset<8> preamble;
     std::bitset<6> reserved_field;
-    std::string add_CRC(const std::string & m) const;
     std::string build_message(const std::string & data) const; // adds 0s to complete a byte and adds the CRC
+    Rtcm_Bit_Writer msg_writer; // content of the MSM and ephemeris messages, reused to avoid allocations
 
     //
     // Data Fields
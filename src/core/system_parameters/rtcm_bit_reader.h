@@ -0,0 +1,140 @@
+/*!
+ * \file rtcm_bit_reader.h
+ * \brief Bit reader used to decode the RTCM 3 messages.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_RTCM_BIT_READER_H_
+#define GNSS_SDR_RTCM_BIT_READER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/*!
+ * \brief Reads the data fields of a message content, MSB first, straight
+ * from the received bytes. Reading past the end returns zeros and sets
+ * overflow(), so that a decoder checks it once at the end.
+ */
+class Rtcm_Bit_Reader
+{
+public:
+    Rtcm_Bit_Reader(const unsigned char * data, size_t length)
+    {
+        d_data = data;
+        d_n_bits = 8 * length;
+        d_position = 0;
+        d_overflow = false;
+    }
+
+    //! Reads an unsigned field of n_bits (1 to 64)
+    uint64_t read_unsigned(unsigned int n_bits)
+    {
+        if (d_position + n_bits > d_n_bits)
+            {
+                d_overflow = true;
+                d_position = d_n_bits;
+                return 0;
+            }
+        const size_t byte = d_position >> 3;
+        if (n_bits <= 56 && byte + 8 <= d_n_bits / 8)
+            {
+                // the 8 bytes from the current one hold the whole field
+                uint64_t window;
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+                std::memcpy(&window, d_data + byte, 8);
+                window = __builtin_bswap64(window);
+#else
+                window = 0;
+                for (unsigned int i = 0; i < 8; i++)
+                    {
+                        window = (window << 8) | d_data[byte + i];
+                    }
+#endif
+                const uint64_t value = (window << (d_position & 7)) >> (64 - n_bits);
+                d_position += n_bits;
+                return value;
+            }
+        uint64_t value = 0;
+        while (n_bits > 0)
+            {
+                const unsigned int left = 8 - (d_position & 7);
+                const unsigned int chunk = n_bits < left ? n_bits : left;
+                const unsigned int bits = (d_data[d_position >> 3] >> (left - chunk)) & ((1u << chunk) - 1);
+                value = (value << chunk) | bits;
+                d_position += chunk;
+                n_bits -= chunk;
+            }
+        return value;
+    }
+
+    //! Reads a two's complement field of n_bits (1 to 64)
+    int64_t read_signed(unsigned int n_bits)
+    {
+        const uint64_t value = read_unsigned(n_bits);
+        if (n_bits < 64 && ((value >> (n_bits - 1)) & 1))
+            {
+                return static_cast<int64_t>(value | (~static_cast<uint64_t>(0) << n_bits));
+            }
+        return static_cast<int64_t>(value);
+    }
+
+    bool read_bool()
+    {
+        return read_unsigned(1) != 0;
+    }
+
+    void skip(unsigned int n_bits)
+    {
+        if (d_position + n_bits > d_n_bits)
+            {
+                d_overflow = true;
+                d_position = d_n_bits;
+                return;
+            }
+        d_position += n_bits;
+    }
+
+    //! Bits read so far
+    size_t position() const
+    {
+        return d_position;
+    }
+
+    bool overflow() const
+    {
+        return d_overflow;
+    }
+
+private:
+    const unsigned char * d_data;
+    size_t d_n_bits;
+    size_t d_position;
+    bool d_overflow;
+};
+
+#endif
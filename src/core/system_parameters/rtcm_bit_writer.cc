@@ -0,0 +1,101 @@
+/*!
+ * \file rtcm_bit_writer.cc
+ * \brief Bit writer and CRC-24Q used to encode the RTCM 3 messages.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "rtcm_bit_writer.h"
+#include <cstring>
+#include <glog/logging.h>
+#include "gnss_crc24q.h"
+
+
+Rtcm_Bit_Writer::Rtcm_Bit_Writer()
+{
+    std::memset(d_buffer, 0, sizeof(d_buffer));
+    d_n_bits = 0;
+    d_overflow = false;
+}
+
+
+void Rtcm_Bit_Writer::clear()
+{
+    // only the bytes written so far are dirty
+    std::memset(d_buffer + 3, 0, (d_n_bits + 7) / 8);
+    d_n_bits = 0;
+    d_overflow = false;
+}
+
+
+void Rtcm_Bit_Writer::append(uint64_t value, unsigned int n_bits)
+{
+    if (d_n_bits + n_bits > 8 * RTCM_MAX_MESSAGE_LENGTH)
+        {
+            d_overflow = true;
+            return;
+        }
+    while (n_bits > 0)
+        {
+            const unsigned int free_bits = 8 - (d_n_bits & 7);
+            const unsigned int chunk = n_bits < free_bits ? n_bits : free_bits;
+            const unsigned int bits = static_cast<unsigned int>(value >> (n_bits - chunk)) & ((1u << chunk) - 1);
+            d_buffer[3 + (d_n_bits >> 3)] |= static_cast<unsigned char>(bits << (free_bits - chunk));
+            d_n_bits += chunk;
+            n_bits -= chunk;
+        }
+}
+
+
+void Rtcm_Bit_Writer::append(const std::string & bits)
+{
+    for (std::string::const_iterator it = bits.begin(); it != bits.end(); ++it)
+        {
+            append(*it == '1' ? 1 : 0, 1);
+        }
+}
+
+
+std::string Rtcm_Bit_Writer::frame()
+{
+    if (d_overflow)
+        {
+            LOG(WARNING) << "RTCM message longer than " << RTCM_MAX_MESSAGE_LENGTH << " bytes, truncated";
+        }
+    const unsigned int length = (d_n_bits + 7) / 8;
+    d_buffer[0] = 0xD3;
+    d_buffer[1] = static_cast<unsigned char>((length >> 8) & 0x03);  // 6 reserved bits set to 0
+    d_buffer[2] = static_cast<unsigned char>(length & 0xFF);
+    const uint32_t crc = Gnss_Crc24q::checksum(d_buffer, 3 + length);
+    d_buffer[3 + length] = static_cast<unsigned char>(crc >> 16);
+    d_buffer[4 + length] = static_cast<unsigned char>(crc >> 8);
+    d_buffer[5 + length] = static_cast<unsigned char>(crc);
+    std::string frame(reinterpret_cast<const char *>(d_buffer), 6 + length);
+    // the CRC bytes are not part of the next message
+    std::memset(d_buffer + 3 + length, 0, 3);
+    return frame;
+}
+
@@ -0,0 +1,104 @@
+/*!
+ * \file rtcm_bit_writer.h
+ * \brief Bit writer and CRC-24Q used to encode the RTCM 3 messages.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The RTCM messages used to be assembled as strings of '0' and '1'
+ * characters, one per data field, that were concatenated, packed into bytes
+ * and converted once more to compute the CRC. This class appends the data
+ * fields straight to a fixed buffer large enough for the longest frame
+ * allowed by the transport layer, and frames the message in place.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_RTCM_BIT_WRITER_H_
+#define GNSS_SDR_RTCM_BIT_WRITER_H_
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+//! Largest message length of the RTCM 3 transport layer [bytes]
+#define RTCM_MAX_MESSAGE_LENGTH 1023
+
+/*!
+ * \brief Message content written MSB first, then framed as defined at RTCM
+ * STANDARD 10403.2: preamble, 6 reserved bits, 10-bit message length,
+ * message zero padded to a whole number of bytes, and CRC-24Q (see
+ * Gnss_Crc24q).
+ */
+class Rtcm_Bit_Writer
+{
+public:
+    Rtcm_Bit_Writer();
+
+    //! Discards the message content
+    void clear();
+
+    //! Appends the n_bits (up to 64) LSBs of value, MSB first
+    void append(uint64_t value, unsigned int n_bits);
+
+    //! Appends a data field
+    template<size_t N>
+    void append(const std::bitset<N> & field)
+    {
+        if (N <= 64)
+            {
+                append(static_cast<uint64_t>(field.to_ullong()), N);
+            }
+        else
+            {
+                for (size_t i = N; i > 0; i--)
+                    {
+                        append(field[i - 1] ? 1 : 0, 1);
+                    }
+            }
+    }
+
+    //! Appends a string of '0' and '1' characters
+    void append(const std::string & bits);
+
+    //! Message content length [bits]
+    unsigned int size() const
+    {
+        return d_n_bits;
+    }
+
+    /*!
+     * \brief Returns the complete frame as binary data. Bits appended past
+     * RTCM_MAX_MESSAGE_LENGTH bytes are discarded.
+     */
+    std::string frame();
+
+private:
+    // header, message and CRC
+    unsigned char d_buffer[3 + RTCM_MAX_MESSAGE_LENGTH + 3];
+    unsigned int d_n_bits;
+    bool d_overflow;
+};
+
+#endif
@@ -0,0 +1,355 @@
+/*!
+ * \file rtcm_caster.cc
+ * \brief TCP caster that sends the RTCM messages to many clients.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "rtcm_caster.h"
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <sstream>
+#include <glog/logging.h>
+
+using google::LogMessage;
+
+//! Largest number of queued messages sent by a single write
+#define RTCM_CASTER_MAX_GATHER 32
+
+
+/*!
+ * \brief Connection with a client. All the members but the counters are
+ * only used from the strand.
+ */
+class Rtcm_Caster::Session : public std::enable_shared_from_this<Rtcm_Caster::Session>
+{
+public:
+    Session(Rtcm_Caster & caster, boost::asio::ip::tcp::socket socket)
+        : d_caster(caster), d_socket(std::move(socket)), d_strand(caster.d_io_service)
+    {
+        d_closed = false;
+        d_messages_sent = 0;
+        d_bytes_sent = 0;
+        d_queued = 0;
+        d_connected = std::chrono::steady_clock::now();
+        boost::system::error_code ec;
+        boost::asio::ip::tcp::endpoint remote = d_socket.remote_endpoint(ec);
+        std::stringstream ss;
+        ss << remote.address().to_string() << ":" << remote.port();
+        d_endpoint = ss.str();
+    }
+
+    void start()
+    {
+        d_strand.post(std::bind(&Session::do_read, shared_from_this()));
+    }
+
+    void deliver(const std::shared_ptr<const std::string> & message)
+    {
+        auto self(shared_from_this());
+        d_strand.post([this, self, message]()
+                {
+            if (d_closed)
+                {
+                    return;
+                }
+            if (d_queue.size() >= d_caster.d_max_queued_messages)
+                {
+                    LOG(WARNING) << "RTCM client " << d_endpoint << " is too slow, "
+                                 << d_queue.size() << " messages queued. Disconnecting it";
+                    d_caster.d_dropped_clients++;
+                    close();
+                    return;
+                }
+            d_queue.push_back(message);
+            d_queued = d_queue.size();
+            if (d_in_flight.empty())
+                {
+                    do_write();
+                }
+                });
+    }
+
+    void shutdown()
+    {
+        d_strand.post(std::bind(&Session::close, shared_from_this()));
+    }
+
+    Client_Stats stats() const
+    {
+        Client_Stats s;
+        s.endpoint = d_endpoint;
+        s.messages_sent = d_messages_sent.load();
+        s.bytes_sent = d_bytes_sent.load();
+        s.queued_messages = d_queued.load();
+        s.connected_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - d_connected).count();
+        s.throughput_Bps = (s.connected_s > 0.0) ? static_cast<double>(s.bytes_sent) / s.connected_s : 0.0;
+        return s;
+    }
+
+    const std::string & endpoint() const
+    {
+        return d_endpoint;
+    }
+
+private:
+    // The clients are not expected to send anything; reading only detects
+    // when they disconnect
+    void do_read()
+    {
+        auto self(shared_from_this());
+        d_socket.async_read_some(boost::asio::buffer(d_read_buffer, sizeof(d_read_buffer)),
+                d_strand.wrap([this, self](boost::system::error_code ec, std::size_t /*length*/)
+                        {
+            if (!ec)
+                {
+                    do_read();
+                }
+            else
+                {
+                    close();
+                }
+                        }));
+    }
+
+    void do_write()
+    {
+        d_buffers.clear();
+        while (!d_queue.empty() && d_in_flight.size() < RTCM_CASTER_MAX_GATHER)
+            {
+                d_in_flight.push_back(d_queue.front());
+                d_buffers.push_back(boost::asio::buffer(*d_queue.front()));
+                d_queue.pop_front();
+            }
+        d_queued = d_queue.size();
+        auto self(shared_from_this());
+        boost::asio::async_write(d_socket, d_buffers,
+                d_strand.wrap([this, self](boost::system::error_code ec, std::size_t length)
+                        {
+            if (ec)
+                {
+                    close();
+                    return;
+                }
+            d_bytes_sent += length;
+            d_messages_sent += d_in_flight.size();
+            d_in_flight.clear();
+            if (!d_closed && !d_queue.empty())
+                {
+                    do_write();
+                }
+                        }));
+    }
+
+    void close()
+    {
+        if (d_closed)
+            {
+                return;
+            }
+        d_closed = true;
+        boost::system::error_code ec;
+        d_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+        d_socket.close(ec);
+        d_queue.clear();
+        d_queued = 0;
+        d_caster.leave(shared_from_this());
+    }
+
+    Rtcm_Caster & d_caster;
+    boost::asio::ip::tcp::socket d_socket;
+    boost::asio::io_service::strand d_strand;
+    bool d_closed;
+    std::deque<std::shared_ptr<const std::string> > d_queue;
+    std::vector<std::shared_ptr<const std::string> > d_in_flight;  // keeps the buffers of the ongoing write alive
+    std::vector<boost::asio::const_buffer> d_buffers;
+    char d_read_buffer[256];
+    std::string d_endpoint;
+    std::chrono::steady_clock::time_point d_connected;
+    std::atomic<unsigned long long> d_messages_sent;
+    std::atomic<unsigned long long> d_bytes_sent;
+    std::atomic<unsigned int> d_queued;
+};
+
+
+Rtcm_Caster::Rtcm_Caster(unsigned short port, unsigned int n_threads, unsigned int max_queued_messages)
+    : d_acceptor(d_io_service), d_socket(d_io_service)
+{
+    d_port = port;
+    d_n_threads = (n_threads > 0) ? n_threads : 1;
+    d_max_queued_messages = (max_queued_messages > 0) ? max_queued_messages : 1;
+    d_running = false;
+    d_dropped_clients = 0;
+}
+
+
+Rtcm_Caster::~Rtcm_Caster()
+{
+    stop();
+}
+
+
+bool Rtcm_Caster::start()
+{
+    if (d_running)
+        {
+            return true;
+        }
+    try
+    {
+            boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::tcp::v4(), d_port);
+            d_acceptor.open(endpoint.protocol());
+            d_acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+            d_acceptor.bind(endpoint);
+            d_acceptor.listen();
+            d_port = d_acceptor.local_endpoint().port();
+    }
+    catch (const boost::system::system_error & e)
+    {
+            LOG(WARNING) << "The RTCM caster cannot listen on port " << d_port << ": " << e.what();
+            boost::system::error_code ec;
+            d_acceptor.close(ec);
+            return false;
+    }
+    d_work.reset(new boost::asio::io_service::work(d_io_service));
+    do_accept();
+    for (unsigned int i = 0; i < d_n_threads; i++)
+        {
+            d_threads.emplace_back([this]() { d_io_service.run(); });
+        }
+    d_running = true;
+    std::cout << "The RTCM caster is accepting connections on port " << d_port
+              << " (" << d_n_threads << " threads)" << std::endl;
+    return true;
+}
+
+
+void Rtcm_Caster::stop()
+{
+    if (!d_running)
+        {
+            return;
+        }
+    d_io_service.post([this]()
+            {
+        boost::system::error_code ec;
+        d_acceptor.close(ec);
+            });
+    std::vector<Client_Stats> stats = client_stats();
+    for (std::vector<Client_Stats>::const_iterator it = stats.begin(); it != stats.end(); ++it)
+        {
+            LOG(INFO) << "RTCM client " << it->endpoint << ": " << it->messages_sent << " messages, "
+                      << it->bytes_sent << " bytes in " << it->connected_s << " s";
+        }
+    {
+        std::lock_guard<std::mutex> lock(d_mutex);
+        for (std::set<std::shared_ptr<Session> >::const_iterator it = d_sessions.begin(); it != d_sessions.end(); ++it)
+            {
+                (*it)->shutdown();
+            }
+    }
+    // run() returns once the pending operations have been cancelled
+    d_work.reset();
+    for (std::vector<std::thread>::iterator it = d_threads.begin(); it != d_threads.end(); ++it)
+        {
+            it->join();
+        }
+    d_threads.clear();
+    d_running = false;
+}
+
+
+void Rtcm_Caster::deliver(const std::string & message)
+{
+    // one copy, shared by all the sessions
+    std::shared_ptr<const std::string> buffer = std::make_shared<const std::string>(message);
+    std::lock_guard<std::mutex> lock(d_mutex);
+    for (std::set<std::shared_ptr<Session> >::const_iterator it = d_sessions.begin(); it != d_sessions.end(); ++it)
+        {
+            (*it)->deliver(buffer);
+        }
+}
+
+
+unsigned short Rtcm_Caster::port() const
+{
+    return d_port;
+}
+
+
+std::vector<Rtcm_Caster::Client_Stats> Rtcm_Caster::client_stats() const
+{
+    std::vector<Client_Stats> stats;
+    std::lock_guard<std::mutex> lock(d_mutex);
+    for (std::set<std::shared_ptr<Session> >::const_iterator it = d_sessions.begin(); it != d_sessions.end(); ++it)
+        {
+            stats.push_back((*it)->stats());
+        }
+    return stats;
+}
+
+
+unsigned int Rtcm_Caster::clients() const
+{
+    std::lock_guard<std::mutex> lock(d_mutex);
+    return d_sessions.size();
+}
+
+
+void Rtcm_Caster::do_accept()
+{
+    d_acceptor.async_accept(d_socket, [this](boost::system::error_code ec)
+            {
+        if (!d_acceptor.is_open())
+            {
+                return;
+            }
+        if (!ec)
+            {
+                std::shared_ptr<Session> session = std::make_shared<Session>(*this, std::move(d_socket));
+                LOG(INFO) << "RTCM caster serving client from " << session->endpoint();
+                {
+                    std::lock_guard<std::mutex> lock(d_mutex);
+                    d_sessions.insert(session);
+                }
+                session->start();
+            }
+        else
+            {
+                LOG(WARNING) << "Error when accepting a RTCM client: " << ec.message();
+            }
+        do_accept();
+            });
+}
+
+
+void Rtcm_Caster::leave(const std::shared_ptr<Session> & session)
+{
+    LOG(INFO) << "Closing connection with RTCM client from " << session->endpoint();
+    std::lock_guard<std::mutex> lock(d_mutex);
+    d_sessions.erase(session);
+}
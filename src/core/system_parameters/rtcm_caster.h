@@ -0,0 +1,116 @@
+/*!
+ * \file rtcm_caster.h
+ * \brief TCP caster that sends the RTCM messages to many clients.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The default RTCM server copies each message into the queue of every
+ * session and runs on a single thread. The caster serializes each message
+ * once into a reference-counted buffer that all the sessions share, and
+ * sends the buffers queued for a client with a single scatter-gather write.
+ * The sessions run on a pool of threads, each one serialized by its own
+ * strand. A client that does not keep up, so that its queue reaches the
+ * maximum depth, is disconnected instead of delaying the others.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_RTCM_CASTER_H_
+#define GNSS_SDR_RTCM_CASTER_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/asio.hpp>
+
+class Rtcm_Caster
+{
+public:
+    //! Throughput counters of a connected client
+    struct Client_Stats
+    {
+        std::string endpoint;            //!< Address and port of the client
+        unsigned long long messages_sent;
+        unsigned long long bytes_sent;
+        unsigned int queued_messages;    //!< Messages waiting to be sent
+        double connected_s;              //!< Time since the client connected [s]
+        double throughput_Bps;           //!< Average throughput [bytes/s]
+    };
+
+    /*!
+     * \brief Serves port (0 picks a free one) with n_threads threads.
+     * Clients with more than max_queued_messages waiting are disconnected.
+     */
+    Rtcm_Caster(unsigned short port, unsigned int n_threads, unsigned int max_queued_messages);
+    ~Rtcm_Caster();
+
+    //! Starts accepting clients. Returns false if the port cannot be bound.
+    bool start();
+
+    //! Disconnects all the clients and joins the threads
+    void stop();
+
+    //! Sends a message to all the connected clients. Thread safe.
+    void deliver(const std::string & message);
+
+    //! Port the caster is listening on
+    unsigned short port() const;
+
+    std::vector<Client_Stats> client_stats() const;
+
+    unsigned int clients() const;
+
+    //! Clients disconnected because their queue was full
+    unsigned long long dropped_clients() const
+    {
+        return d_dropped_clients.load();
+    }
+
+private:
+    class Session;
+
+    void do_accept();
+    void leave(const std::shared_ptr<Session> & session);
+
+    unsigned short d_port;
+    unsigned int d_n_threads;
+    unsigned int d_max_queued_messages;
+    bool d_running;
+
+    boost::asio::io_service d_io_service;
+    std::unique_ptr<boost::asio::io_service::work> d_work;
+    boost::asio::ip::tcp::acceptor d_acceptor;
+    boost::asio::ip::tcp::socket d_socket;
+    std::vector<std::thread> d_threads;
+
+    mutable std::mutex d_mutex;
+    std::set<std::shared_ptr<Session> > d_sessions;
+    std::atomic<unsigned long long> d_dropped_clients;
+};
+
+#endif
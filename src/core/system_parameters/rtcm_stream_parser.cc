@@ -0,0 +1,441 @@
+/*!
+ * \file rtcm_stream_parser.cc
+ * \brief Parser of RTCM 3 streams, such as the ones received from NTRIP casters
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "rtcm_stream_parser.h"
+#include <algorithm>
+#include <cstring>
+#include "GPS_L1_CA.h"
+#include "Galileo_E1.h"
+#include "gnss_crc24q.h"
+#include "rtcm_bit_reader.h"
+
+namespace
+{
+const unsigned char RTCM_PREAMBLE = 0xD3;
+
+// Size of the frame whose first 3 bytes are header
+size_t frame_size_of(const unsigned char * header)
+{
+    return 3 + ((static_cast<size_t>(header[1] & 0x03) << 8) | header[2]) + 3;
+}
+}
+
+
+Rtcm_Stream_Parser::Rtcm_Stream_Parser()
+{
+    d_data = nullptr;
+    d_size = 0;
+    d_position = 0;
+    d_pending_size = 0;
+    d_frame = nullptr;
+    d_frame_size = 0;
+    d_frames = 0;
+    d_crc_errors = 0;
+    d_skipped = 0;
+}
+
+
+void Rtcm_Stream_Parser::push(const unsigned char * data, size_t length)
+{
+    d_data = data;
+    d_size = length;
+    d_position = 0;
+}
+
+
+bool Rtcm_Stream_Parser::header_ok(const unsigned char * header) const
+{
+    // the 6 reserved bits are 0
+    return header[0] == RTCM_PREAMBLE && (header[1] & 0xFC) == 0;
+}
+
+
+bool Rtcm_Stream_Parser::crc_ok(const unsigned char * frame, size_t size) const
+{
+    const uint32_t crc = (static_cast<uint32_t>(frame[size - 3]) << 16) | (static_cast<uint32_t>(frame[size - 2]) << 8) | frame[size - 1];
+    return Gnss_Crc24q::checksum(frame, size - 3) == crc;
+}
+
+
+bool Rtcm_Stream_Parser::next_pending()
+{
+    while (d_pending_size > 0)
+        {
+            const bool have_header = d_pending_size >= 3;
+            if (!have_header || header_ok(d_pending))
+                {
+                    const size_t wanted = have_header ? frame_size_of(d_pending) : 3;
+                    if (d_pending_size < wanted)
+                        {
+                            const size_t n = std::min(wanted - d_pending_size, d_size - d_position);
+                            std::memcpy(d_pending + d_pending_size, d_data + d_position, n);
+                            d_pending_size += n;
+                            d_position += n;
+                            if (d_pending_size < wanted)
+                                {
+                                    return false;
+                                }
+                            continue;
+                        }
+                    if (crc_ok(d_pending, d_pending_size))
+                        {
+                            d_frame = d_pending;
+                            d_frame_size = d_pending_size;
+                            d_pending_size = 0;
+                            d_frames++;
+                            return true;
+                        }
+                    d_crc_errors++;
+                }
+            // resynchronize on the next preamble of the copied bytes
+            const unsigned char * p = static_cast<const unsigned char *>(std::memchr(d_pending + 1, RTCM_PREAMBLE, d_pending_size - 1));
+            const size_t dropped = p ? static_cast<size_t>(p - d_pending) : d_pending_size;
+            std::memmove(d_pending, d_pending + dropped, d_pending_size - dropped);
+            d_pending_size -= dropped;
+            d_skipped += dropped;
+        }
+    return false;
+}
+
+
+bool Rtcm_Stream_Parser::next()
+{
+    d_frame = nullptr;
+    d_frame_size = 0;
+    if (d_pending_size > 0)
+        {
+            if (next_pending()) return true;
+            if (d_pending_size > 0) return false;  // input exhausted
+        }
+
+    while (d_position < d_size)
+        {
+            const unsigned char * start = d_data + d_position;
+            const unsigned char * p = static_cast<const unsigned char *>(std::memchr(start, RTCM_PREAMBLE, d_size - d_position));
+            if (p == nullptr)
+                {
+                    d_skipped += d_size - d_position;
+                    d_position = d_size;
+                    return false;
+                }
+            d_skipped += p - start;
+            d_position = p - d_data;
+
+            const size_t available = d_size - d_position;
+            if (available >= 3 && !header_ok(p))
+                {
+                    d_skipped++;
+                    d_position++;
+                    continue;
+                }
+            if (available < 3 || available < frame_size_of(p))
+                {
+                    // kept for the next buffer
+                    std::memcpy(d_pending, p, available);
+                    d_pending_size = available;
+                    d_position = d_size;
+                    return false;
+                }
+            const size_t size = frame_size_of(p);
+            if (crc_ok(p, size))
+                {
+                    d_frame = p;
+                    d_frame_size = size;
+                    d_position += size;
+                    d_frames++;
+                    return true;
+                }
+            d_crc_errors++;
+            d_skipped++;
+            d_position++;
+        }
+    return false;
+}
+
+
+unsigned int Rtcm_Stream_Parser::message_type() const
+{
+    if (d_frame == nullptr || d_frame_size < 8)
+        {
+            return 0;
+        }
+    return (static_cast<unsigned int>(d_frame[3]) << 4) | (d_frame[4] >> 4);
+}
+
+
+bool Rtcm_Stream_Parser::decode(Rtcm_Reference_Station & station) const
+{
+    if (message_type() != 1005) return false;
+    Rtcm_Bit_Reader reader(payload(), payload_length());
+    reader.skip(12);
+    station.ref_id = reader.read_unsigned(12);
+    reader.skip(6); // ITRF year
+    station.gps = reader.read_bool();
+    station.glonass = reader.read_bool();
+    station.galileo = reader.read_bool();
+    reader.skip(1); // reference station indicator
+    station.ecef_x = static_cast<double>(reader.read_signed(38)) / 10000.0;
+    reader.skip(2); // single receiver oscillator, reserved
+    station.ecef_y = static_cast<double>(reader.read_signed(38)) / 10000.0;
+    reader.skip(2); // quarter cycle indicator
+    station.ecef_z = static_cast<double>(reader.read_signed(38)) / 10000.0;
+    return !reader.overflow();
+}
+
+
+bool Rtcm_Stream_Parser::decode(Gps_Ephemeris & gps_eph) const
+{
+    if (message_type() != 1019) return false;
+    Rtcm_Bit_Reader reader(payload(), payload_length());
+    reader.skip(12);
+    gps_eph.i_satellite_PRN = static_cast<unsigned int>(reader.read_unsigned(6));
+    gps_eph.i_GPS_week = static_cast<int>(reader.read_unsigned(10));
+    gps_eph.i_SV_accuracy = static_cast<int>(reader.read_unsigned(4));
+    gps_eph.i_code_on_L2 = static_cast<int>(reader.read_unsigned(2));
+    gps_eph.d_IDOT = static_cast<double>(reader.read_signed(14)) * I_DOT_LSB;
+    gps_eph.d_IODE_SF2 = static_cast<double>(reader.read_unsigned(8));
+    gps_eph.d_IODE_SF3 = gps_eph.d_IODE_SF2;
+    gps_eph.d_Toc = static_cast<double>(reader.read_unsigned(16)) * T_OC_LSB;
+    gps_eph.d_A_f2 = static_cast<double>(reader.read_signed(8)) * A_F2_LSB;
+    gps_eph.d_A_f1 = static_cast<double>(reader.read_signed(16)) * A_F1_LSB;
+    gps_eph.d_A_f0 = static_cast<double>(reader.read_signed(22)) * A_F0_LSB;
+    gps_eph.d_IODC = static_cast<double>(reader.read_unsigned(10));
+    gps_eph.d_Crs = static_cast<double>(reader.read_signed(16)) * C_RS_LSB;
+    gps_eph.d_Delta_n = static_cast<double>(reader.read_signed(16)) * DELTA_N_LSB;
+    gps_eph.d_M_0 = static_cast<double>(reader.read_signed(32)) * M_0_LSB;
+    gps_eph.d_Cuc = static_cast<double>(reader.read_signed(16)) * C_UC_LSB;
+    gps_eph.d_e_eccentricity = static_cast<double>(reader.read_unsigned(32)) * E_LSB;
+    gps_eph.d_Cus = static_cast<double>(reader.read_signed(16)) * C_US_LSB;
+    gps_eph.d_sqrt_A = static_cast<double>(reader.read_unsigned(32)) * SQRT_A_LSB;
+    gps_eph.d_Toe = static_cast<double>(reader.read_unsigned(16)) * T_OE_LSB;
+    gps_eph.d_Cic = static_cast<double>(reader.read_signed(16)) * C_IC_LSB;
+    gps_eph.d_OMEGA0 = static_cast<double>(reader.read_signed(32)) * OMEGA_0_LSB;
+    gps_eph.d_Cis = static_cast<double>(reader.read_signed(16)) * C_IS_LSB;
+    gps_eph.d_i_0 = static_cast<double>(reader.read_signed(32)) * I_0_LSB;
+    gps_eph.d_Crc = static_cast<double>(reader.read_signed(16)) * C_RC_LSB;
+    gps_eph.d_OMEGA = static_cast<double>(reader.read_signed(32)) * OMEGA_LSB;
+    gps_eph.d_OMEGA_DOT = static_cast<double>(reader.read_signed(24)) * OMEGA_DOT_LSB;
+    gps_eph.d_TGD = static_cast<double>(reader.read_signed(8)) * T_GD_LSB;
+    gps_eph.i_SV_health = static_cast<int>(reader.read_unsigned(6));
+    gps_eph.b_L2_P_data_flag = reader.read_bool();
+    gps_eph.b_fit_interval_flag = reader.read_bool();
+    return !reader.overflow();
+}
+
+
+bool Rtcm_Stream_Parser::decode(Galileo_Ephemeris & gal_eph) const
+{
+    if (message_type() != 1045) return false;
+    Rtcm_Bit_Reader reader(payload(), payload_length());
+    reader.skip(12);
+    gal_eph.i_satellite_PRN = static_cast<unsigned int>(reader.read_unsigned(6));
+    gal_eph.WN_5 = static_cast<double>(reader.read_unsigned(12));
+    gal_eph.IOD_nav_1 = static_cast<int>(reader.read_unsigned(10));
+    gal_eph.SISA_3 = static_cast<double>(reader.read_unsigned(8));
+    gal_eph.iDot_2 = static_cast<double>(reader.read_signed(14)) * iDot_2_LSB;
+    gal_eph.t0c_4 = static_cast<double>(reader.read_unsigned(14)) * t0c_4_LSB;
+    gal_eph.af2_4 = static_cast<double>(reader.read_signed(6)) * af2_4_LSB;
+    gal_eph.af1_4 = static_cast<double>(reader.read_signed(21)) * af1_4_LSB;
+    gal_eph.af0_4 = static_cast<double>(reader.read_signed(31)) * af0_4_LSB;
+    gal_eph.C_rs_3 = static_cast<double>(reader.read_signed(16)) * C_rs_3_LSB;
+    gal_eph.delta_n_3 = static_cast<double>(reader.read_signed(16)) * delta_n_3_LSB;
+    gal_eph.M0_1 = static_cast<double>(reader.read_signed(32)) * M0_1_LSB;
+    gal_eph.C_uc_3 = static_cast<double>(reader.read_signed(16)) * C_uc_3_LSB;
+    gal_eph.e_1 = static_cast<double>(reader.read_unsigned(32)) * e_1_LSB;
+    gal_eph.C_us_3 = static_cast<double>(reader.read_signed(16)) * C_us_3_LSB;
+    gal_eph.A_1 = static_cast<double>(reader.read_unsigned(32)) * A_1_LSB_gal;
+    gal_eph.t0e_1 = static_cast<double>(reader.read_unsigned(14)) * t0e_1_LSB;
+    gal_eph.C_ic_4 = static_cast<double>(reader.read_signed(16)) * C_ic_4_LSB;
+    gal_eph.OMEGA_0_2 = static_cast<double>(reader.read_signed(32)) * OMEGA_0_2_LSB;
+    gal_eph.C_is_4 = static_cast<double>(reader.read_signed(16)) * C_is_4_LSB;
+    gal_eph.i_0_2 = static_cast<double>(reader.read_signed(32)) * i_0_2_LSB;
+    gal_eph.C_rc_3 = static_cast<double>(reader.read_signed(16)) * C_rc_3_LSB;
+    gal_eph.omega_2 = static_cast<double>(reader.read_signed(32)) * omega_2_LSB;
+    gal_eph.OMEGA_dot_3 = static_cast<double>(reader.read_signed(24)) * OMEGA_dot_3_LSB;
+    gal_eph.BGD_E1E5a_5 = static_cast<double>(reader.read_signed(10));
+    gal_eph.E5a_HS = static_cast<unsigned int>(reader.read_unsigned(2));
+    gal_eph.E5a_DVS = reader.read_bool();
+    return !reader.overflow();
+}
+
+
+bool Rtcm_Stream_Parser::decode(Rtcm_Msm & msm) const
+{
+    const unsigned int type = message_type();
+    if (type < 1071 || type > 1127 || type % 10 < 1 || type % 10 > 7) return false;
+    Rtcm_Bit_Reader reader(payload(), payload_length());
+    reader.skip(12);
+    msm.message_type = type;
+    msm.msm = type % 10;
+    msm.ref_id = reader.read_unsigned(12);
+    msm.epoch_time = static_cast<uint32_t>(reader.read_unsigned(30));
+    msm.more_messages = reader.read_bool();
+    msm.iods = reader.read_unsigned(3);
+    reader.skip(7); // reserved
+    msm.clock_steering_indicator = reader.read_unsigned(2);
+    msm.external_clock_indicator = reader.read_unsigned(2);
+    msm.divergence_free = reader.read_bool();
+    msm.smoothing_interval = reader.read_unsigned(3);
+
+    // PRNs and signal IDs in the order of the masks
+    unsigned int prn[64];
+    unsigned int signal_id[32];
+    const uint64_t satellite_mask = reader.read_unsigned(64);
+    const uint32_t signal_mask = static_cast<uint32_t>(reader.read_unsigned(32));
+    msm.num_satellites = 0;
+    msm.num_signals = 0;
+    for (unsigned int i = 1; i <= 64; i++)
+        {
+            if ((satellite_mask >> (64 - i)) & 1) prn[msm.num_satellites++] = i;
+        }
+    for (unsigned int i = 1; i <= 32; i++)
+        {
+            if ((signal_mask >> (32 - i)) & 1) signal_id[msm.num_signals++] = i;
+        }
+
+    // Satellite of each cell, to reach its satellite data
+    unsigned char cell_satellite[64 * 32];
+    msm.cells.clear();
+    for (unsigned int sat = 0; sat < msm.num_satellites; sat++)
+        {
+            for (unsigned int sig = 0; sig < msm.num_signals; sig++)
+                {
+                    if (!reader.read_bool()) continue;
+                    Rtcm_Msm_Cell cell = Rtcm_Msm_Cell();
+                    cell.prn = prn[sat];
+                    cell.signal_id = signal_id[sig];
+                    cell_satellite[msm.cells.size()] = static_cast<unsigned char>(sat);
+                    msm.cells.push_back(cell);
+                }
+        }
+    if (reader.overflow()) return false;
+    const unsigned int num_cells = msm.cells.size();
+
+    const bool integer_ms = msm.msm >= 4;
+    const bool rate = (msm.msm == 5) || (msm.msm == 7);
+    const bool high_resolution = msm.msm >= 6;
+    const bool range = msm.msm != 2;
+    const bool phase = msm.msm >= 2;
+
+    // Satellite data: rough range [ms] and rough phaserange rate [m/s]
+    double rough_range[64];
+    bool rough_range_valid[64];
+    double rough_rate[64];
+    bool rough_rate_valid[64];
+    for (unsigned int sat = 0; sat < msm.num_satellites; sat++)
+        {
+            rough_range[sat] = 0.0;
+            rough_range_valid[sat] = true;
+            rough_rate[sat] = 0.0;
+            rough_rate_valid[sat] = rate;
+        }
+    if (integer_ms)
+        {
+            for (unsigned int sat = 0; sat < msm.num_satellites; sat++)
+                {
+                    const unsigned int int_ms = reader.read_unsigned(8);
+                    rough_range_valid[sat] = int_ms != 255;
+                    rough_range[sat] = int_ms;
+                }
+        }
+    if (rate)
+        {
+            reader.skip(4 * msm.num_satellites); // extended satellite information
+        }
+    for (unsigned int sat = 0; sat < msm.num_satellites; sat++)
+        {
+            rough_range[sat] += static_cast<double>(reader.read_unsigned(10)) * TWO_N10;
+        }
+    if (rate)
+        {
+            for (unsigned int sat = 0; sat < msm.num_satellites; sat++)
+                {
+                    const int64_t value = reader.read_signed(14);
+                    rough_rate_valid[sat] = value != -8192;
+                    rough_rate[sat] = static_cast<double>(value);
+                }
+        }
+
+    // Signal data
+    const double ms_to_m = GPS_C_m_s * 0.001;
+    if (range)
+        {
+            const unsigned int bits = high_resolution ? 20 : 15;
+            const double lsb = high_resolution ? TWO_N29 : TWO_N24;
+            const int64_t invalid = - (static_cast<int64_t>(1) << (bits - 1));
+            for (unsigned int c = 0; c < num_cells; c++)
+                {
+                    const int64_t value = reader.read_signed(bits);
+                    const unsigned int sat = cell_satellite[c];
+                    msm.cells[c].pseudorange_valid = rough_range_valid[sat] && value != invalid;
+                    msm.cells[c].pseudorange_m = (rough_range[sat] + static_cast<double>(value) * lsb) * ms_to_m;
+                }
+        }
+    if (phase)
+        {
+            const unsigned int bits = high_resolution ? 24 : 22;
+            const double lsb = high_resolution ? TWO_N31 : TWO_N29;
+            const int64_t invalid = - (static_cast<int64_t>(1) << (bits - 1));
+            for (unsigned int c = 0; c < num_cells; c++)
+                {
+                    const int64_t value = reader.read_signed(bits);
+                    const unsigned int sat = cell_satellite[c];
+                    msm.cells[c].phaserange_valid = rough_range_valid[sat] && value != invalid;
+                    msm.cells[c].phaserange_m = (rough_range[sat] + static_cast<double>(value) * lsb) * ms_to_m;
+                }
+            for (unsigned int c = 0; c < num_cells; c++)
+                {
+                    msm.cells[c].lock_time_indicator = reader.read_unsigned(high_resolution ? 10 : 4);
+                }
+            for (unsigned int c = 0; c < num_cells; c++)
+                {
+                    msm.cells[c].half_cycle_ambiguity = reader.read_bool();
+                }
+        }
+    if (integer_ms)
+        {
+            for (unsigned int c = 0; c < num_cells; c++)
+                {
+                    msm.cells[c].cnr_dB_Hz = high_resolution ? static_cast<double>(reader.read_unsigned(10)) * 0.0625
+                            : static_cast<double>(reader.read_unsigned(6));
+                }
+        }
+    if (rate)
+        {
+            for (unsigned int c = 0; c < num_cells; c++)
+                {
+                    const int64_t value = reader.read_signed(15);
+                    const unsigned int sat = cell_satellite[c];
+                    msm.cells[c].phaserange_rate_valid = rough_rate_valid[sat] && value != -16384;
+                    msm.cells[c].phaserange_rate_m_s = rough_rate[sat] + static_cast<double>(value) * 0.0001;
+                }
+        }
+    return !reader.overflow();
+}
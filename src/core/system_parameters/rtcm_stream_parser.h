@@ -0,0 +1,198 @@
+/*!
+ * \file rtcm_stream_parser.h
+ * \brief Parser of RTCM 3 streams, such as the ones received from NTRIP casters
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Rtcm::read_MT1005, read_MT1019 and read_MT1045 take a single frame and go
+ * through strings of '0' and '1' characters. This parser finds the frames
+ * in the bytes as received, checks their CRC-24Q and decodes the messages
+ * of ephemeris, station coordinates and observables from the received bytes,
+ * with the bit reader of rtcm_bit_reader.h.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_RTCM_STREAM_PARSER_H_
+#define GNSS_SDR_RTCM_STREAM_PARSER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "galileo_ephemeris.h"
+#include "gps_ephemeris.h"
+#include "rtcm_bit_writer.h"
+
+//! Antenna reference point of a reference station (message type 1005)
+struct Rtcm_Reference_Station
+{
+    unsigned int ref_id;
+    bool gps;
+    bool glonass;
+    bool galileo;
+    double ecef_x;  //!< [m]
+    double ecef_y;  //!< [m]
+    double ecef_z;  //!< [m]
+};
+
+
+//! Observables of a satellite and signal of an MSM
+struct Rtcm_Msm_Cell
+{
+    unsigned int prn;
+    unsigned int signal_id;          //!< Table 3.5-91 (GPS), 3.5-99 (Galileo)...
+    bool pseudorange_valid;
+    double pseudorange_m;            //!< Modulo 1 ms for MSM1 to MSM3, which have no integer milliseconds
+    bool phaserange_valid;
+    double phaserange_m;             //!< Same ambiguity as the pseudorange
+    bool phaserange_rate_valid;
+    double phaserange_rate_m_s;      //!< MSM5 and MSM7 only
+    unsigned int lock_time_indicator; //!< DF402, or DF407 for MSM6 and MSM7
+    bool half_cycle_ambiguity;
+    double cnr_dB_Hz;                //!< 0 if not available
+};
+
+
+//! Multiple Signal Message, types 1071 to 1127
+struct Rtcm_Msm
+{
+    unsigned int message_type;
+    unsigned int msm;                //!< 1 to 7
+    unsigned int ref_id;
+    uint32_t epoch_time;             //!< DF004 for GPS and Galileo [ms of the week]
+    bool more_messages;
+    unsigned int iods;
+    unsigned int clock_steering_indicator;
+    unsigned int external_clock_indicator;
+    bool divergence_free;
+    unsigned int smoothing_interval;
+    unsigned int num_satellites;
+    unsigned int num_signals;
+    std::vector<Rtcm_Msm_Cell> cells; //!< In the order of the cell mask, kept from message to message
+};
+
+
+/*!
+ * \brief Finds the frames of an RTCM 3 stream and decodes their messages.
+ *
+ * push() gives the parser a buffer of received bytes, and next() moves to
+ * each frame with a valid CRC found in it. Frames entirely inside the buffer
+ * are read in place, so the buffer must stay valid until next() returns
+ * false; only a frame split between two buffers is copied. Bytes that do
+ * not belong to a valid frame are skipped, resynchronizing on the next
+ * preamble.
+ *
+ *   parser.push(data, length);
+ *   while (parser.next())
+ *       {
+ *           if (parser.message_type() == 1019 && parser.decode(gps_eph)) ...
+ *       }
+ */
+class Rtcm_Stream_Parser
+{
+public:
+    Rtcm_Stream_Parser();
+
+    //! Parses length bytes of data from now on
+    void push(const unsigned char * data, size_t length);
+
+    //! Moves to the next valid frame. Returns false when the buffer is exhausted.
+    bool next();
+
+    //! Message type of the current frame, 0 if it has none
+    unsigned int message_type() const;
+
+    //! Whole current frame: preamble, length, message and CRC
+    const unsigned char * frame() const
+    {
+        return d_frame;
+    }
+
+    size_t frame_size() const
+    {
+        return d_frame_size;
+    }
+
+    //! Message of the current frame
+    const unsigned char * payload() const
+    {
+        return d_frame + 3;
+    }
+
+    size_t payload_length() const
+    {
+        return d_frame_size - 6;
+    }
+
+    //! Decodes the current frame if it is a message type 1005. Returns false otherwise.
+    bool decode(Rtcm_Reference_Station & station) const;
+
+    //! Decodes the current frame if it is a message type 1019. Returns false otherwise.
+    bool decode(Gps_Ephemeris & gps_eph) const;
+
+    //! Decodes the current frame if it is a message type 1045. Returns false otherwise.
+    bool decode(Galileo_Ephemeris & gal_eph) const;
+
+    //! Decodes the current frame if it is an MSM. Returns false otherwise.
+    bool decode(Rtcm_Msm & msm) const;
+
+    unsigned long long frames() const
+    {
+        return d_frames;
+    }
+
+    //! Frames whose preamble and length were found, but not the CRC
+    unsigned long long crc_errors() const
+    {
+        return d_crc_errors;
+    }
+
+    //! Bytes out of valid frames
+    unsigned long long skipped_bytes() const
+    {
+        return d_skipped;
+    }
+
+private:
+    bool header_ok(const unsigned char * header) const;
+    bool crc_ok(const unsigned char * frame, size_t size) const;
+    bool next_pending();
+
+    const unsigned char * d_data;
+    size_t d_size;
+    size_t d_position;
+
+    // start of a frame that was split between two buffers
+    unsigned char d_pending[3 + RTCM_MAX_MESSAGE_LENGTH + 3];
+    size_t d_pending_size;
+
+    const unsigned char * d_frame;
+    size_t d_frame_size;
+
+    unsigned long long d_frames;
+    unsigned long long d_crc_errors;
+    unsigned long long d_skipped;
+};
+
+#endif
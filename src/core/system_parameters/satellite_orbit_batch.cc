@@ -0,0 +1,267 @@
+/*!
+ * \file satellite_orbit_batch.cc
+ * \brief Positions, velocities and clock corrections of all the satellites
+ *  of one epoch, computed together from the broadcast ephemerides.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "satellite_orbit_batch.h"
+#include <cmath>
+#include "Galileo_E1.h"
+#include "GPS_L1_CA.h"
+
+namespace
+{
+const double HALF_WEEK = 302400.0;  // [s]
+const double TWO_PI = 2.0 * GPS_PI;
+
+// Newton iterations on Kepler's equation from E = M, enough for e < 0.3,
+// and from the solution at the uncorrected transmit time
+const int KEPLER_ITERATIONS = 5;
+const int KEPLER_REFINEMENTS = 2;
+
+// pi/2 split so that q * PIO2_1 and q * PIO2_2 are exact (fdlibm)
+const double TWO_OVER_PI = 6.36619772367581382433e-01;
+const double PIO2_1 = 1.57079632673412561417e+00;
+const double PIO2_2 = 6.07710050630396597660e-11;
+const double PIO2_3 = 2.02226624871116645580e-21;
+
+// 1.5 * 2^52: adding and subtracting it rounds to the nearest integer. Unlike
+// floor(), this vectorizes without -fno-trapping-math
+const double ROUNDING_SHIFT = 6755399441055744.0;
+
+inline double round_nearest(double x)
+{
+    return (x + ROUNDING_SHIFT) - ROUNDING_SHIFT;
+}
+
+/*
+ * Sines and cosines of n angles of moderate size, to a few ulp. The angle is
+ * reduced to [-pi/4, pi/4] and the fdlibm kernel polynomials are evaluated
+ * for both functions, then swapped and negated as the quadrant says, with
+ * arithmetic instead of branches so that the loop is vectorized.
+ */
+void sincos_batch(const double * x, double * s, double * c, unsigned int n)
+{
+    for (unsigned int k = 0; k < n; k++)
+        {
+            const double q = round_nearest(x[k] * TWO_OVER_PI);
+            const double r = ((x[k] - q * PIO2_1) - q * PIO2_2) - q * PIO2_3;
+            const double z = r * r;
+            const double sr = r + r * z * (-1.66666666666666324348e-01 + z * (8.33333333332248946124e-03
+                    + z * (-1.98412698298579493134e-04 + z * (2.75573137070700676789e-06
+                    + z * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10)))));
+            const double cr = 1.0 - 0.5 * z + z * z * (4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03
+                    + z * (2.48015872894767294178e-05 + z * (-2.75573143513906633035e-07
+                    + z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11)))));
+            // bits 0 and 1 of the quadrant q, as 0.0 or 1.0
+            const double half = round_nearest(0.5 * q - 0.25);
+            const double odd = q - 2.0 * half;
+            const double high = half - 2.0 * round_nearest(0.5 * half - 0.25);
+            const double sin_r = sr + odd * (cr - sr);
+            const double cos_r = cr + odd * (sr - cr);
+            s[k] = sin_r * (1.0 - 2.0 * high);
+            c[k] = cos_r * (1.0 - 2.0 * (odd + high - 2.0 * odd * high));
+        }
+}
+}
+
+
+Satellite_Orbit_Batch::Satellite_Orbit_Batch()
+{
+    d_size = 0;
+}
+
+
+void Satellite_Orbit_Batch::clear()
+{
+    d_size = 0;
+}
+
+
+bool Satellite_Orbit_Batch::add(const Gps_Ephemeris & eph, double transmit_time)
+{
+    return add(eph.d_sqrt_A, eph.d_Delta_n, eph.d_e_eccentricity, GM, eph.d_M_0, eph.d_OMEGA,
+            eph.d_Cuc, eph.d_Cus, eph.d_Crc, eph.d_Crs, eph.d_Cic, eph.d_Cis,
+            eph.d_i_0, eph.d_IDOT, eph.d_OMEGA0, eph.d_OMEGA_DOT, OMEGA_EARTH_DOT,
+            eph.d_Toe, eph.d_Toc, eph.d_A_f0, eph.d_A_f1, eph.d_A_f2, F,
+            true, transmit_time);
+}
+
+
+bool Satellite_Orbit_Batch::add(const Galileo_Ephemeris & eph, double transmit_time)
+{
+    return add(eph.A_1, eph.delta_n_3, eph.e_1, GALILEO_GM, eph.M0_1, eph.omega_2,
+            eph.C_uc_3, eph.C_us_3, eph.C_rc_3, eph.C_rs_3, eph.C_ic_4, eph.C_is_4,
+            eph.i_0_2, eph.iDot_2, eph.OMEGA_0_2, eph.OMEGA_dot_3, GALILEO_OMEGA_EARTH_DOT,
+            eph.t0e_1, eph.t0c_4, eph.af0_4, eph.af1_4, eph.af2_4, GALILEO_F,
+            false, transmit_time);
+}
+
+
+bool Satellite_Orbit_Batch::add(double sqrt_A, double delta_n, double e, double gm, double M0, double omega,
+        double Cuc, double Cus, double Crc, double Crs, double Cic, double Cis,
+        double i0, double IDOT, double OMEGA0, double OMEGA_DOT, double omega_earth_dot,
+        double toe, double toc, double af0, double af1, double af2, double f,
+        bool week_crossover, double transmit_time)
+{
+    if (d_size == SATELLITE_ORBIT_BATCH_SIZE)
+        {
+            return false;
+        }
+    const unsigned int k = d_size++;
+    const double a = sqrt_A * sqrt_A;
+    d_tx[k] = transmit_time;
+    d_toe[k] = toe;
+    d_toc[k] = toc;
+    d_week_wrap[k] = week_crossover ? 1.0 : 0.0;
+    d_a[k] = a;
+    d_n[k] = (a > 0.0) ? std::sqrt(gm / (a * a * a)) + delta_n : delta_n;
+    d_e[k] = e;
+    d_sqrt_one_minus_e2[k] = std::sqrt(1.0 - e * e);
+    d_M0[k] = M0;
+    d_cos_omega[k] = std::cos(omega);
+    d_sin_omega[k] = std::sin(omega);
+    d_Cuc[k] = Cuc;
+    d_Cus[k] = Cus;
+    d_Crc[k] = Crc;
+    d_Crs[k] = Crs;
+    d_Cic[k] = Cic;
+    d_Cis[k] = Cis;
+    d_i0[k] = i0;
+    d_IDOT[k] = IDOT;
+    d_Omega_at_toe[k] = OMEGA0 - omega_earth_dot * toe;
+    d_Omega_rate[k] = OMEGA_DOT - omega_earth_dot;
+    d_af0[k] = af0;
+    d_af1[k] = af1;
+    d_af2[k] = af2;
+    d_f_e_sqrt_A[k] = f * e * sqrt_A;
+    return true;
+}
+
+
+void Satellite_Orbit_Batch::compute()
+{
+    const unsigned int num = d_size;
+
+    // Mean anomaly at the first estimate of the transmit time, reduced to [-pi, pi]
+    for (unsigned int k = 0; k < num; k++)
+        {
+            const double t = d_tx[k] - d_toe[k];
+            d_tk[k] = t - d_week_wrap[k] * 2.0 * HALF_WEEK * round_nearest(t / (2.0 * HALF_WEEK));
+            const double m = d_M0[k] + d_n[k] * d_tk[k];
+            d_M[k] = m - TWO_PI * round_nearest(m / TWO_PI);
+            d_E[k] = d_M[k];
+        }
+    for (int it = 0; it < KEPLER_ITERATIONS; it++)
+        {
+            sincos_batch(d_E, d_sin_E, d_cos_E, num);
+            for (unsigned int k = 0; k < num; k++)
+                {
+                    d_E[k] -= (d_E[k] - d_e[k] * d_sin_E[k] - d_M[k]) / (1.0 - d_e[k] * d_cos_E[k]);
+                }
+        }
+    sincos_batch(d_E, d_sin_E, d_cos_E, num);
+
+    // Clock correction at that time (20.3.3.3.3.1 IS-GPS-200E, ICD 5.1.4),
+    // then the anomalies at the corrected transmit time, from the solution above
+    for (unsigned int k = 0; k < num; k++)
+        {
+            const double t = d_tx[k] - d_toc[k];
+            const double dt = t - d_week_wrap[k] * 2.0 * HALF_WEEK * round_nearest(t / (2.0 * HALF_WEEK));
+            const double bias = d_af0[k] + d_af1[k] * dt + d_af2[k] * (dt * dt) + d_f_e_sqrt_A[k] * d_sin_E[k];
+            d_clock_bias[k] = bias;
+            d_tx_corrected[k] = d_tx[k] - bias;
+            d_tk[k] -= bias;
+            d_M[k] -= d_n[k] * bias;
+            d_E[k] -= d_n[k] * bias / (1.0 - d_e[k] * d_cos_E[k]);
+        }
+    for (int it = 0; it < KEPLER_REFINEMENTS; it++)
+        {
+            sincos_batch(d_E, d_sin_E, d_cos_E, num);
+            for (unsigned int k = 0; k < num; k++)
+                {
+                    d_E[k] -= (d_E[k] - d_e[k] * d_sin_E[k] - d_M[k]) / (1.0 - d_e[k] * d_cos_E[k]);
+                }
+        }
+    sincos_batch(d_E, d_sin_E, d_cos_E, num);
+
+    // Argument of latitude correction, inclination and longitude of the
+    // ascending node
+    for (unsigned int k = 0; k < num; k++)
+        {
+            const double den = 1.0 - d_e[k] * d_cos_E[k];
+            const double sin_nu = d_sqrt_one_minus_e2[k] * d_sin_E[k] / den;
+            const double cos_nu = (d_cos_E[k] - d_e[k]) / den;
+            const double sin_phi = sin_nu * d_cos_omega[k] + cos_nu * d_sin_omega[k];
+            const double cos_phi = cos_nu * d_cos_omega[k] - sin_nu * d_sin_omega[k];
+            const double cos_2phi = cos_phi * cos_phi - sin_phi * sin_phi;
+            const double sin_2phi = 2.0 * sin_phi * cos_phi;
+            d_du[k] = d_Cuc[k] * cos_2phi + d_Cus[k] * sin_2phi;
+            d_i[k] = d_i0[k] + d_IDOT[k] * d_tk[k] + d_Cic[k] * cos_2phi + d_Cis[k] * sin_2phi;
+            d_Omega[k] = d_Omega_at_toe[k] + d_Omega_rate[k] * d_tk[k];
+        }
+    sincos_batch(d_du, d_sin_du, d_cos_du, num);
+    sincos_batch(d_i, d_sin_i, d_cos_i, num);
+    sincos_batch(d_Omega, d_sin_Omega, d_cos_Omega, num);
+
+    // Position in the orbital plane and its rotation to ECEF, with the
+    // time derivatives of every angle for the velocity
+    for (unsigned int k = 0; k < num; k++)
+        {
+            const double den = 1.0 - d_e[k] * d_cos_E[k];
+            const double sin_nu = d_sqrt_one_minus_e2[k] * d_sin_E[k] / den;
+            const double cos_nu = (d_cos_E[k] - d_e[k]) / den;
+            const double sin_phi = sin_nu * d_cos_omega[k] + cos_nu * d_sin_omega[k];
+            const double cos_phi = cos_nu * d_cos_omega[k] - sin_nu * d_sin_omega[k];
+            const double cos_2phi = cos_phi * cos_phi - sin_phi * sin_phi;
+            const double sin_2phi = 2.0 * sin_phi * cos_phi;
+            const double sin_u = sin_phi * d_cos_du[k] + cos_phi * d_sin_du[k];
+            const double cos_u = cos_phi * d_cos_du[k] - sin_phi * d_sin_du[k];
+            const double r = d_a[k] * den + d_Crc[k] * cos_2phi + d_Crs[k] * sin_2phi;
+
+            const double E_dot = d_n[k] / den;
+            const double phi_dot = d_sqrt_one_minus_e2[k] * E_dot / den;
+            const double u_dot = phi_dot * (1.0 + 2.0 * (d_Cus[k] * cos_2phi - d_Cuc[k] * sin_2phi));
+            const double r_dot = d_a[k] * d_e[k] * d_sin_E[k] * E_dot + 2.0 * phi_dot * (d_Crs[k] * cos_2phi - d_Crc[k] * sin_2phi);
+            const double i_dot = d_IDOT[k] + 2.0 * phi_dot * (d_Cis[k] * cos_2phi - d_Cic[k] * sin_2phi);
+
+            const double xp = r * cos_u;
+            const double yp = r * sin_u;
+            const double xp_dot = r_dot * cos_u - yp * u_dot;
+            const double yp_dot = r_dot * sin_u + xp * u_dot;
+
+            const double x = xp * d_cos_Omega[k] - yp * d_cos_i[k] * d_sin_Omega[k];
+            const double y = xp * d_sin_Omega[k] + yp * d_cos_i[k] * d_cos_Omega[k];
+            d_x[k] = x;
+            d_y[k] = y;
+            d_z[k] = yp * d_sin_i[k];
+            d_vx[k] = xp_dot * d_cos_Omega[k] - yp_dot * d_cos_i[k] * d_sin_Omega[k] + yp * d_sin_i[k] * d_sin_Omega[k] * i_dot - y * d_Omega_rate[k];
+            d_vy[k] = xp_dot * d_sin_Omega[k] + yp_dot * d_cos_i[k] * d_cos_Omega[k] - yp * d_sin_i[k] * d_cos_Omega[k] * i_dot + x * d_Omega_rate[k];
+            d_vz[k] = yp_dot * d_sin_i[k] + yp * d_cos_i[k] * i_dot;
+        }
+}
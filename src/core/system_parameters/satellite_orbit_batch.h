@@ -0,0 +1,177 @@
+/*!
+ * \file satellite_orbit_batch.h
+ * \brief Positions, velocities and clock corrections of all the satellites
+ *  of one epoch, computed together from the broadcast ephemerides.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * satellitePosition() and sv_clock_drift() of the ephemeris classes evaluate
+ * one satellite at a time, with calls to the scalar libm trigonometric
+ * functions, an iterative Kepler solution that ends at a data dependent
+ * iteration, and, for the velocity, two more positions. Here the orbit
+ * parameters of the satellites are stored as one array per parameter, and
+ * every step of the algorithm runs as a loop over the satellites without
+ * branches: a fixed number of Newton iterations, sines and cosines from
+ * polynomials after a Cody-Waite reduction, the true anomaly from its sine
+ * and cosine instead of atan2, so the compiler vectorizes the loops.
+ * The velocity is the analytic derivative of the position.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_SATELLITE_ORBIT_BATCH_H_
+#define GNSS_SDR_SATELLITE_ORBIT_BATCH_H_
+
+#include "galileo_ephemeris.h"
+#include "gps_ephemeris.h"
+
+#define SATELLITE_ORBIT_BATCH_SIZE 64
+
+/*!
+ * \brief Evaluates the broadcast orbits and clocks of a set of satellites at
+ * their transmission times.
+ *
+ * Each add() appends a satellite with the first estimate of its transmit
+ * time, the receive time minus the pseudorange over the speed of light.
+ * compute() evaluates the clock correction at that time, relativistic term
+ * included, and the position and velocity at the transmit time corrected by
+ * the clock, as satellitePosition(Tx_time - sv_clock_drift(Tx_time)) does.
+ * The arrays have a fixed size, which also lets the compiler see that they do
+ * not overlap, so the loops are vectorized without runtime alias checks.
+ */
+class Satellite_Orbit_Batch
+{
+public:
+    Satellite_Orbit_Batch();
+
+    //! Removes the satellites of the previous epoch
+    void clear();
+
+    //! Appends a GPS satellite with index size(), false if the batch is full
+    bool add(const Gps_Ephemeris & eph, double transmit_time);
+
+    //! Appends a Galileo satellite with index size(), false if the batch is full
+    bool add(const Galileo_Ephemeris & eph, double transmit_time);
+
+    //! Evaluates all the satellites added since clear()
+    void compute();
+
+    unsigned int size() const
+    {
+        return d_size;
+    }
+
+    //! Satellite clock correction, relativistic term included [s]
+    double clock_bias_s(unsigned int k) const
+    {
+        return d_clock_bias[k];
+    }
+
+    //! Transmit time corrected by the satellite clock [s]
+    double corrected_transmit_time_s(unsigned int k) const
+    {
+        return d_tx_corrected[k];
+    }
+
+    //! Copies the ECEF position [m] into pos[0..2]
+    void position(unsigned int k, double * pos) const
+    {
+        pos[0] = d_x[k];
+        pos[1] = d_y[k];
+        pos[2] = d_z[k];
+    }
+
+    //! Copies the ECEF velocity [m/s] into vel[0..2]
+    void velocity(unsigned int k, double * vel) const
+    {
+        vel[0] = d_vx[k];
+        vel[1] = d_vy[k];
+        vel[2] = d_vz[k];
+    }
+
+private:
+    bool add(double sqrt_A, double delta_n, double e, double gm, double M0, double omega,
+            double Cuc, double Cus, double Crc, double Crs, double Cic, double Cis,
+            double i0, double IDOT, double OMEGA0, double OMEGA_DOT, double omega_earth_dot,
+            double toe, double toc, double af0, double af1, double af2, double f,
+            bool week_crossover, double transmit_time);
+
+    unsigned int d_size;
+
+    // orbit and clock parameters, one element per satellite. The derived
+    // constants are computed in add()
+    double d_tx[SATELLITE_ORBIT_BATCH_SIZE];            // first estimate of the transmit time [s]
+    double d_toe[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_toc[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_week_wrap[SATELLITE_ORBIT_BATCH_SIZE];     // 1 if times are reduced to +-half a week (GPS), 0 otherwise
+    double d_a[SATELLITE_ORBIT_BATCH_SIZE];             // semi-major axis [m]
+    double d_n[SATELLITE_ORBIT_BATCH_SIZE];             // corrected mean motion [rad/s]
+    double d_e[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_sqrt_one_minus_e2[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_M0[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_cos_omega[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_sin_omega[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_Cuc[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_Cus[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_Crc[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_Crs[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_Cic[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_Cis[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_i0[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_IDOT[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_Omega_at_toe[SATELLITE_ORBIT_BATCH_SIZE];  // OMEGA0 - earth rotation rate times toe [rad]
+    double d_Omega_rate[SATELLITE_ORBIT_BATCH_SIZE];    // OMEGA_DOT - earth rotation rate [rad/s]
+    double d_af0[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_af1[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_af2[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_f_e_sqrt_A[SATELLITE_ORBIT_BATCH_SIZE];    // relativistic term over sin(E) [s]
+
+    // intermediate values
+    double d_tk[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_M[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_E[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_sin_E[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_cos_E[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_du[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_sin_du[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_cos_du[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_i[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_sin_i[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_cos_i[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_Omega[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_sin_Omega[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_cos_Omega[SATELLITE_ORBIT_BATCH_SIZE];
+
+    // results
+    double d_clock_bias[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_tx_corrected[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_x[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_y[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_z[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_vx[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_vy[SATELLITE_ORBIT_BATCH_SIZE];
+    double d_vz[SATELLITE_ORBIT_BATCH_SIZE];
+};
+
+#endif /* GNSS_SDR_SATELLITE_ORBIT_BATCH_H_ */
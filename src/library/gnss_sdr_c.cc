@@ -0,0 +1,116 @@
+/*!
+ * \file gnss_sdr_c.cc
+ * \brief C interface of the GNSS-SDR receiver library
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_c.h"
+#include <exception>
+#include <glog/logging.h>
+#include "concurrent_map.h"
+#include "concurrent_queue.h"
+#include "gps_acq_assist.h"
+#include "gnss_sdr_receiver.h"
+
+using google::LogMessage;
+
+// The library takes the place of main(), which defines these
+// For GPS NAVIGATION (L1)
+concurrent_queue<Gps_Acq_Assist> global_gps_acq_assist_queue;
+concurrent_map<Gps_Acq_Assist> global_gps_acq_assist_map;
+
+struct gnss_sdr_receiver
+{
+    GnssSdrReceiver receiver;
+
+    gnss_sdr_receiver(const char* config_file) : receiver(config_file)
+    {}
+};
+
+
+gnss_sdr_receiver* gnss_sdr_receiver_create(const char* config_file)
+{
+    if (config_file == nullptr)
+        {
+            return nullptr;
+        }
+    try
+    {
+            return new gnss_sdr_receiver(config_file);
+    }
+    catch(std::exception const & ex)
+    {
+            LOG(ERROR) << "Unable to create a receiver with " << config_file << ": " << ex.what();
+            return nullptr;
+    }
+}
+
+
+void gnss_sdr_receiver_destroy(gnss_sdr_receiver* receiver)
+{
+    delete receiver;
+}
+
+
+int gnss_sdr_receiver_set_property(gnss_sdr_receiver* receiver, const char* name, const char* value)
+{
+    if (receiver == nullptr || name == nullptr || value == nullptr)
+        {
+            return -1;
+        }
+    receiver->receiver.set_property(name, value);
+    return 0;
+}
+
+
+int gnss_sdr_receiver_process_file(gnss_sdr_receiver* receiver, const char* filename)
+{
+    if (receiver == nullptr || filename == nullptr)
+        {
+            return -1;
+        }
+    return receiver->receiver.process_file(filename) ? 0 : -1;
+}
+
+
+int gnss_sdr_receiver_process_buffer(gnss_sdr_receiver* receiver, const void* samples, size_t bytes)
+{
+    if (receiver == nullptr || samples == nullptr)
+        {
+            return -1;
+        }
+    return receiver->receiver.process_buffer(samples, bytes) ? 0 : -1;
+}
+
+
+void gnss_sdr_receiver_clear_navigation_data(gnss_sdr_receiver* receiver)
+{
+    if (receiver != nullptr)
+        {
+            receiver->receiver.clear_navigation_data();
+        }
+}
@@ -0,0 +1,72 @@
+/*!
+ * \file gnss_sdr_c.h
+ * \brief C interface of the GNSS-SDR receiver library
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * A receiver is created once from a configuration file, and then processes
+ * capture files or sample buffers one after the other, reusing the codes,
+ * FFT plans and navigation data of the previous jobs (see GnssSdrReceiver).
+ * The functions that return int return 0 on success and -1 on failure.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_C_H_
+#define GNSS_SDR_C_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct gnss_sdr_receiver gnss_sdr_receiver;
+
+/*! \brief Reads the configuration file. Returns NULL on failure. */
+gnss_sdr_receiver* gnss_sdr_receiver_create(const char* config_file);
+
+void gnss_sdr_receiver_destroy(gnss_sdr_receiver* receiver);
+
+/*! \brief Sets a property of the configuration for the next jobs */
+int gnss_sdr_receiver_set_property(gnss_sdr_receiver* receiver, const char* name, const char* value);
+
+/*! \brief Processes a capture file with the SignalSource of the configuration */
+int gnss_sdr_receiver_process_file(gnss_sdr_receiver* receiver, const char* filename);
+
+/*!
+ * \brief Processes bytes bytes of samples of the SignalSource.item_type and
+ * SignalSource.sampling_frequency of the configuration. The samples are
+ * not copied, and must not change until the function returns.
+ */
+int gnss_sdr_receiver_process_buffer(gnss_sdr_receiver* receiver, const void* samples, size_t bytes);
+
+/*! \brief Forgets the navigation data of the previous jobs */
+void gnss_sdr_receiver_clear_navigation_data(gnss_sdr_receiver* receiver);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
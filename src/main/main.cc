@@ -49,6 +49,8 @@
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <gnuradio/msg_queue.h>
+#include "batch_processor.h"
+#include "multi_receiver.h"
 #include "control_thread.h"
 #include "concurrent_queue.h"
 #include "concurrent_map.h"
@@ -148,6 +150,26 @@ int main(int argc, char** argv)
                 }
         }
 
+    if (BatchProcessor::enabled())
+        {
+            // split the capture file and process its segments in parallel
+            BatchProcessor batch_processor;
+            const bool processed = batch_processor.run();
+            google::ShutDownCommandLineFlags();
+            std::cout << "GNSS-SDR program ended." << std::endl;
+            return processed ? 0 : 1;
+        }
+
+    MultiReceiver multi_receiver;
+    if (multi_receiver.enabled())
+        {
+            // several receivers in this process, sharing the codes, plans and kernels
+            const bool hosted = multi_receiver.run();
+            google::ShutDownCommandLineFlags();
+            std::cout << "GNSS-SDR program ended." << std::endl;
+            return hosted ? 0 : 1;
+        }
+
     std::unique_ptr<ControlThread> control_thread(new ControlThread());
 
     // record startup time
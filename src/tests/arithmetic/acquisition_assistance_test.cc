@@ -0,0 +1,221 @@
+/*!
+ * \file acquisition_assistance_test.cc
+ * \brief This file implements tests for the Doppler window of Acquisition_Assistance
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstring>
+#include "acquisition_assistance.h"
+#include "concurrent_map.h"
+#include "gps_acq_assist.h"
+
+extern concurrent_map<Gps_Acq_Assist> global_gps_acq_assist_map;
+
+
+TEST(AcquisitionAssistanceTest, DopplerWindow)
+{
+    Gnss_Synchro synchro = Gnss_Synchro();
+    synchro.System = 'G';
+    std::memcpy(synchro.Signal, "1C", 3);
+    synchro.PRN = 32;
+
+    Gps_Acq_Assist assistance;
+    assistance.i_satellite_PRN = 32;
+    assistance.d_Doppler0 = 1234.0;
+    assistance.dopplerUncertainty = 500.0;
+    global_gps_acq_assist_map.write(32, assistance);
+
+    int center = 1;
+    unsigned int half_width = 0;
+
+    // Full search unless the assistance is enabled
+    EXPECT_FALSE(Acquisition_Assistance::doppler_window(synchro, 10000, 500, center, half_width));
+    EXPECT_EQ(0, center);
+    EXPECT_EQ(10000u, half_width);
+
+    Acquisition_Assistance::set_enabled(true);
+    EXPECT_TRUE(Acquisition_Assistance::doppler_window(synchro, 10000, 500, center, half_width));
+    EXPECT_EQ(1000, center);
+    EXPECT_EQ(1000u, half_width);
+
+    // L2C scales the Doppler of L1 by the ratio of the carriers
+    std::memcpy(synchro.Signal, "2S", 3);
+    EXPECT_TRUE(Acquisition_Assistance::doppler_window(synchro, 10000, 500, center, half_width));
+    EXPECT_EQ(1000, center);
+    EXPECT_EQ(1000u, half_width);
+
+    // No gain if the uncertainty covers the full search, and no assistance for other systems
+    EXPECT_FALSE(Acquisition_Assistance::doppler_window(synchro, 1000, 500, center, half_width));
+    EXPECT_EQ(0, center);
+    EXPECT_EQ(1000u, half_width);
+    synchro.System = 'E';
+    std::memcpy(synchro.Signal, "1B", 3);
+    EXPECT_FALSE(Acquisition_Assistance::doppler_window(synchro, 10000, 500, center, half_width));
+
+    Acquisition_Assistance::set_enabled(false);
+}
+
+
+TEST(AcquisitionAssistanceTest, CrossBandDopplerWindow)
+{
+    Gnss_Synchro l1 = Gnss_Synchro();
+    l1.System = 'G';
+    std::memcpy(l1.Signal, "1C", 3);
+    l1.PRN = 7;
+    l1.Carrier_Doppler_hz = 2566.0;
+    Gnss_Synchro l2 = l1;
+    std::memcpy(l2.Signal, "2S", 3);
+
+    int center = 1;
+    unsigned int half_width = 0;
+    Acquisition_Assistance::set_cross_band(true, 10.0);
+
+    // Full search until L1 C/A tracks the satellite
+    EXPECT_FALSE(Acquisition_Assistance::doppler_window(l2, 5000, 100, center, half_width));
+    EXPECT_FALSE(Acquisition_Assistance::cross_band_tracked('G', 7));
+    Acquisition_Assistance::publish_tracking(l1);
+    EXPECT_TRUE(Acquisition_Assistance::cross_band_tracked('G', 7));
+    EXPECT_FALSE(Acquisition_Assistance::cross_band_tracked('E', 7));
+
+    // 2566 Hz on L1 is 2000 Hz on L2, searched over one bin on each side
+    EXPECT_TRUE(Acquisition_Assistance::doppler_window(l2, 5000, 100, center, half_width));
+    EXPECT_EQ(2000, center);
+    EXPECT_EQ(200u, half_width);
+
+    // L1 C/A itself is not aided
+    EXPECT_FALSE(Acquisition_Assistance::doppler_window(l1, 5000, 100, center, half_width));
+
+    // Galileo E5a from E1
+    Gnss_Synchro e1 = l1;
+    e1.System = 'E';
+    std::memcpy(e1.Signal, "1B", 3);
+    e1.Carrier_Doppler_hz = -2680.0;
+    Gnss_Synchro e5a = e1;
+    std::memcpy(e5a.Signal, "5X", 3);
+    Acquisition_Assistance::publish_tracking(e1);
+    EXPECT_TRUE(Acquisition_Assistance::doppler_window(e5a, 5000, 250, center, half_width));
+    EXPECT_EQ(-2000, center);
+    EXPECT_EQ(500u, half_width);
+
+    // The window is withdrawn when L1 C/A loses the lock
+    Acquisition_Assistance::withdraw_tracking(l1);
+    EXPECT_FALSE(Acquisition_Assistance::cross_band_tracked('G', 7));
+    EXPECT_FALSE(Acquisition_Assistance::doppler_window(l2, 5000, 100, center, half_width));
+    EXPECT_EQ(0, center);
+    EXPECT_EQ(5000u, half_width);
+
+    Acquisition_Assistance::set_cross_band(false, 10.0);
+    EXPECT_FALSE(Acquisition_Assistance::doppler_window(e5a, 5000, 250, center, half_width));
+}
+
+
+TEST(AcquisitionAssistanceTest, ReacquisitionDopplerWindow)
+{
+    Gnss_Synchro l1 = Gnss_Synchro();
+    l1.System = 'G';
+    std::memcpy(l1.Signal, "1C", 3);
+    l1.PRN = 9;
+
+    int center = 1;
+    unsigned int half_width = 0;
+    Acquisition_Assistance::set_reacquisition(true, 10.0, 50.0, 10.0);
+
+    // Tracked from 100 to 102 s with a Doppler rate of -2 Hz/s
+    for (int epoch = 0; epoch <= 2000; epoch++)
+        {
+            l1.Tracking_timestamp_secs = 100.0 + 0.001 * epoch;
+            l1.Carrier_Doppler_hz = 1000.0 - 0.002 * epoch;
+            Acquisition_Assistance::publish_tracking(l1);
+        }
+    // Full search while the satellite is tracked
+    EXPECT_FALSE(Acquisition_Assistance::doppler_window(l1, 5000, 250, center, half_width, 103.0));
+    Acquisition_Assistance::withdraw_tracking(l1);
+
+    // 5 s later: 986 Hz, uncertainty 50 + 5 * 10 Hz plus one bin
+    EXPECT_TRUE(Acquisition_Assistance::doppler_window(l1, 5000, 250, center, half_width, 107.0));
+    EXPECT_EQ(1000, center);
+    EXPECT_EQ(500u, half_width);
+    // Not without the time of the acquisition, nor after the window
+    EXPECT_FALSE(Acquisition_Assistance::doppler_window(l1, 5000, 250, center, half_width));
+    EXPECT_FALSE(Acquisition_Assistance::doppler_window(l1, 5000, 250, center, half_width, 112.5));
+    EXPECT_EQ(0, center);
+    EXPECT_EQ(5000u, half_width);
+
+    // Forgotten as soon as the satellite is tracked again
+    Acquisition_Assistance::publish_tracking(l1);
+    EXPECT_FALSE(Acquisition_Assistance::doppler_window(l1, 5000, 250, center, half_width, 103.0));
+
+    Acquisition_Assistance::set_reacquisition(false, 10.0, 50.0, 10.0);
+}
+
+
+TEST(AcquisitionAssistanceTest, TrackingRecordAndRestore)
+{
+    Gnss_Synchro e1 = Gnss_Synchro();
+    e1.System = 'E';
+    std::memcpy(e1.Signal, "1B", 3);
+    e1.PRN = 12;
+    e1.Tracking_timestamp_secs = 50.0;
+    e1.Carrier_Doppler_hz = -1500.0;
+
+    // Recorded without the reacquisition memory
+    Acquisition_Assistance::set_tracking_record(true);
+    Acquisition_Assistance::publish_tracking(e1);
+    std::vector<Acquisition_Assistance::Tracked_Satellite> satellites = Acquisition_Assistance::tracked_satellites();
+    int found = -1;
+    for (unsigned int i = 0; i < satellites.size(); i++)
+        {
+            if (satellites[i].system == 'E' && satellites[i].prn == 12) found = i;
+        }
+    ASSERT_GE(found, 0);
+    EXPECT_DOUBLE_EQ(-1500.0, satellites[found].doppler_hz);
+    EXPECT_DOUBLE_EQ(50.0, satellites[found].time_s);
+    int center = 1;
+    unsigned int half_width = 0;
+    Acquisition_Assistance::withdraw_tracking(e1);
+    EXPECT_FALSE(Acquisition_Assistance::doppler_window(e1, 5000, 250, center, half_width, 51.0));
+    satellites = Acquisition_Assistance::tracked_satellites();
+    for (unsigned int i = 0; i < satellites.size(); i++)
+        {
+            EXPECT_FALSE(satellites[i].system == 'E' && satellites[i].prn == 12);
+        }
+    Acquisition_Assistance::set_tracking_record(false);
+
+    // A run that resumes the capture at 3600 s, where the satellite was tracked
+    Acquisition_Assistance::Tracked_Satellite checkpoint;
+    checkpoint.system = 'E';
+    checkpoint.prn = 12;
+    checkpoint.doppler_hz = 2000.0;
+    checkpoint.doppler_rate_hz_s = 0.0;
+    checkpoint.time_s = 3599.8;
+    Acquisition_Assistance::set_reacquisition(true, 10.0, 50.0, 10.0);
+    Acquisition_Assistance::restore_tracking(std::vector<Acquisition_Assistance::Tracked_Satellite>(1, checkpoint), 3600.0);
+    EXPECT_TRUE(Acquisition_Assistance::doppler_window(e1, 5000, 250, center, half_width, 0.8));
+    EXPECT_EQ(2000, center);
+    EXPECT_EQ(500u, half_width);
+    Acquisition_Assistance::set_reacquisition(false, 10.0, 50.0, 10.0);
+}
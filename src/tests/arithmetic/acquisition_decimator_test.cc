@@ -0,0 +1,121 @@
+/*!
+ * \file acquisition_decimator_test.cc
+ * \brief Tests of the decimation and the delay refinement of the reduced-rate acquisition
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <cmath>
+#include <complex>
+#include <vector>
+#include "acquisition_decimator.h"
+#include "gps_sdr_signal_processing.h"
+
+
+TEST(Acquisition_Decimator_test, PassesTheMainLobeAndStopsAliases)
+{
+    const unsigned int decimation = 4;
+    const unsigned int n = 4000;
+    Acquisition_Decimator decimator(decimation, n);
+    EXPECT_EQ(n / decimation, decimator.decimated_samples());
+    EXPECT_EQ(8 * decimation + 1, decimator.taps().size());
+
+    // A tone of a whole number of cycles per dwell, well inside and well
+    // outside the decimated band
+    const double pi = 3.1415926535897932384626433832795;
+    std::vector<std::complex<float>> in(n);
+    std::vector<std::complex<float>> out(n / decimation);
+    const unsigned int cycles[2] = { 100, 700 };
+    float power[2];
+    for (unsigned int c = 0; c < 2; c++)
+        {
+            for (unsigned int i = 0; i < n; i++)
+                {
+                    const double phase = 2.0 * pi * cycles[c] * i / n;
+                    in[i] = std::complex<float>(std::cos(phase), std::sin(phase));
+                }
+            decimator.decimate(in.data(), out.data());
+            power[c] = 0.0;
+            for (unsigned int m = 0; m < n / decimation; m++)
+                {
+                    power[c] += std::norm(out[m]);
+                }
+            power[c] /= static_cast<float>(n / decimation);
+        }
+    EXPECT_NEAR(1.0, power[0], 0.05);
+    EXPECT_LT(power[1], 1e-3);
+}
+
+
+TEST(Acquisition_Decimator_test, RefinesTheDelayAtTheInputRate)
+{
+    const unsigned int decimation = 4;
+    const signed int fs_in = 8184000;
+    const unsigned int code_length = fs_in / 1000;
+    const unsigned int periods = 2;
+    const unsigned int n = periods * code_length;
+    const unsigned int delay = 3001;          // not a multiple of the decimation
+    const double carrier_hz = 1750.0;
+    const double pi = 3.1415926535897932384626433832795;
+
+    std::vector<std::complex<float>> code(code_length);
+    gps_l1_ca_code_gen_complex_sampled(code.data(), 7, fs_in, 0);
+    std::vector<std::complex<float>> in(n);
+    for (unsigned int i = 0; i < n; i++)
+        {
+            const double phase = 2.0 * pi * carrier_hz * i / fs_in;
+            in[i] = code[(i + code_length - delay) % code_length] * std::complex<float>(std::cos(phase), std::sin(phase));
+        }
+
+    Acquisition_Decimator decimator(decimation, n);
+    std::vector<std::complex<float>> out(decimator.decimated_samples());
+    decimator.decimate(in.data(), out.data());
+
+    // Coarse delay in the decimated dwell, against the code at the decimated rate
+    const unsigned int acq_length = code_length / decimation;
+    std::vector<std::complex<float>> acq_code(acq_length);
+    gps_l1_ca_code_gen_complex_sampled(acq_code.data(), 7, fs_in / decimation, 0);
+    unsigned int coarse = 0;
+    float best = -1.0;
+    for (unsigned int k = 0; k < acq_length; k++)
+        {
+            std::complex<float> corr(0.0, 0.0);
+            for (unsigned int i = 0; i < acq_length; i++)
+                {
+                    const double phase = -2.0 * pi * carrier_hz * i * decimation / fs_in;
+                    corr += out[(i + k) % acq_length] * std::complex<float>(std::cos(phase), std::sin(phase)) * std::conj(acq_code[i]);
+                }
+            if (std::norm(corr) > best)
+                {
+                    best = std::norm(corr);
+                    coarse = k;
+                }
+        }
+    EXPECT_LE(std::abs(static_cast<int>(coarse * decimation) - static_cast<int>(delay)), static_cast<int>(decimation));
+
+    EXPECT_EQ(delay, decimator.refine(in.data(), code.data(), code_length, coarse * decimation, carrier_hz, fs_in));
+}
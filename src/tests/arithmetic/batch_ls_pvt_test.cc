@@ -0,0 +1,319 @@
+/*!
+ * \file batch_ls_pvt_test.cc
+ * \brief Tests of the Least Squares solution of a window of epochs
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <vector>
+#include <sys/time.h>
+#include <gtest/gtest.h>
+#include "batch_ls_pvt.h"
+#include "ls_pvt.h"
+#include "GPS_L1_CA.h"
+
+DEFINE_int32(batch_ls_pvt_epochs_test, 2000, "Number of epochs in the batch Least Squares timing test");
+
+#define BATCH_TEST_SATELLITES 9
+#define BATCH_TEST_CLOCK_M 1000.0
+#define BATCH_TEST_DRIFT_M_S 30.0
+
+
+/*
+ * Receiver near Castelldefels and satellites at the GPS orbit radius. range
+ * gets the pseudoranges without receiver clock, with the Earth rotation
+ * during the travel time and the troposphere delay
+ */
+static void batch_test_geometry(double * rx, double * satpos, double * range)
+{
+    const double lat = 41.275 * GPS_PI / 180.0;
+    const double lon = 1.987 * GPS_PI / 180.0;
+    const double height = 80.0;
+    const double a = 6378137.0;
+    const double e2 = 6.69437999014e-3;
+    const double nu = a / sqrt(1.0 - e2 * sin(lat) * sin(lat));
+    rx[0] = (nu + height) * cos(lat) * cos(lon);
+    rx[1] = (nu + height) * cos(lat) * sin(lon);
+    rx[2] = (nu * (1.0 - e2) + height) * sin(lat);
+
+    const double az_deg[BATCH_TEST_SATELLITES] = {10.0, 55.0, 95.0, 140.0, 185.0, 220.0, 265.0, 300.0, 340.0};
+    const double el_deg[BATCH_TEST_SATELLITES] = {75.0, 20.0, 45.0, 30.0, 60.0, 15.0, 40.0, 25.0, 50.0};
+    Ls_Pvt model(BATCH_TEST_SATELLITES);
+    for (int i = 0; i < BATCH_TEST_SATELLITES; i++)
+        {
+            const double az = az_deg[i] * GPS_PI / 180.0;
+            const double el = el_deg[i] * GPS_PI / 180.0;
+            const double e = cos(el) * sin(az);
+            const double n = cos(el) * cos(az);
+            const double u = sin(el);
+            double dir[3];
+            dir[0] = -sin(lon) * e - sin(lat) * cos(lon) * n + cos(lat) * cos(lon) * u;
+            dir[1] = cos(lon) * e - sin(lat) * sin(lon) * n + cos(lat) * sin(lon) * u;
+            dir[2] = cos(lat) * n + sin(lat) * u;
+            const double b = rx[0] * dir[0] + rx[1] * dir[1] + rx[2] * dir[2];
+            const double c = rx[0] * rx[0] + rx[1] * rx[1] + rx[2] * rx[2] - 26560e3 * 26560e3;
+            const double r = -b + sqrt(b * b - c);
+            const double omegatau = OMEGA_EARTH_DOT * r / GPS_C_m_s;
+            double rot[3];
+            for (int j = 0; j < 3; j++)
+                {
+                    rot[j] = rx[j] + r * dir[j];
+                }
+            double * X = &satpos[3 * i];
+            X[0] = cos(omegatau) * rot[0] - sin(omegatau) * rot[1];
+            X[1] = sin(omegatau) * rot[0] + cos(omegatau) * rot[1];
+            X[2] = rot[2];
+            double trop = 0.0;
+            model.tropo(&trop, sin(el), height / 1000.0, 1013.0, 293.0, 50.0, 0.0, 0.0, 0.0);
+            range[i] = r + trop;
+        }
+}
+
+
+// Uniform noise in [-amplitude, amplitude]
+static double batch_test_noise(unsigned int & state, double amplitude)
+{
+    state = state * 1103515245 + 12345;
+    return amplitude * (static_cast<double>((state >> 8) & 0xFFFF) / 32767.5 - 1.0);
+}
+
+
+// Stores an epoch of the first nsat satellites at time t
+static void batch_test_epoch(Batch_Ls_Pvt & batch, const double * satpos, const double * range,
+        double t, int nsat, unsigned int & state, double noise, const double * initial)
+{
+    batch.begin_epoch(t);
+    for (int i = 0; i < nsat; i++)
+        {
+            const double obs = range[i] + BATCH_TEST_CLOCK_M + BATCH_TEST_DRIFT_M_S * t + batch_test_noise(state, noise);
+            batch.add_observation(&satpos[3 * i], obs, 1.0, 0);
+        }
+    batch.end_epoch(initial);
+}
+
+
+TEST(BatchLsPvtTest, WindowWithCommonClock)
+{
+    double rx[3];
+    double satpos[3 * BATCH_TEST_SATELLITES];
+    double range[BATCH_TEST_SATELLITES];
+    batch_test_geometry(rx, satpos, range);
+    std::vector<Batch_Ls_Pvt_Solution> solutions;
+    Batch_Ls_Pvt batch(10, 1, [&solutions](const Batch_Ls_Pvt_Solution & s) { solutions.push_back(s); });
+
+    // Per-epoch solutions some 30 m away, and epochs of only three
+    // satellites without a solution of their own
+    unsigned int state = 1;
+    for (int k = 0; k < 10; k++)
+        {
+            const double initial[4] = {rx[0] + 20.0, rx[1] - 15.0, rx[2] + 10.0, BATCH_TEST_CLOCK_M + 5.0};
+            const bool three = (k == 4 || k == 7);
+            batch_test_epoch(batch, satpos, range, 0.5 * k, three ? 3 : BATCH_TEST_SATELLITES, state, 0.0, three ? 0 : initial);
+        }
+    EXPECT_EQ(1u, batch.windows());
+    ASSERT_EQ(10u, solutions.size());
+    for (int k = 0; k < 10; k++)
+        {
+            const Batch_Ls_Pvt_Solution & s = solutions[k];
+            EXPECT_TRUE(s.valid) << "epoch " << k;
+            EXPECT_DOUBLE_EQ(0.5 * k, s.rx_time);
+            EXPECT_EQ((k == 4 || k == 7) ? 3 : BATCH_TEST_SATELLITES, s.observations);
+            for (int j = 0; j < 3; j++)
+                {
+                    EXPECT_NEAR(rx[j], s.pos[j], 0.05) << "epoch " << k;
+                }
+            EXPECT_NEAR(BATCH_TEST_CLOCK_M + BATCH_TEST_DRIFT_M_S * 0.5 * k, s.clock_m, 0.05);
+            EXPECT_NEAR(BATCH_TEST_DRIFT_M_S, s.clock_drift_m_s, 0.01);
+            EXPECT_EQ(0.0, s.isb_m);
+        }
+}
+
+
+TEST(BatchLsPvtTest, WindowsAndThreads)
+{
+    double rx[3];
+    double satpos[3 * BATCH_TEST_SATELLITES];
+    double range[BATCH_TEST_SATELLITES];
+    batch_test_geometry(rx, satpos, range);
+    std::vector<Batch_Ls_Pvt_Solution> solutions;
+    Batch_Ls_Pvt batch(10, 3, [&solutions](const Batch_Ls_Pvt_Solution & s) { solutions.push_back(s); });
+    const double initial[4] = {rx[0], rx[1], rx[2], BATCH_TEST_CLOCK_M};
+
+    // 25 epochs, then a gap: windows of 10, 10, 5 and 2 epochs
+    unsigned int state = 1;
+    for (int k = 0; k < 25; k++)
+        {
+            batch_test_epoch(batch, satpos, range, k, BATCH_TEST_SATELLITES, state, 0.5, initial);
+        }
+    // Not ended, then discarded: neither is stored
+    batch.begin_epoch(25.0);
+    batch.begin_epoch(26.0);
+    batch.discard_epoch();
+    EXPECT_EQ(0u, solutions.size());
+    for (int k = 0; k < 2; k++)
+        {
+            batch_test_epoch(batch, satpos, range, 40.0 + k, BATCH_TEST_SATELLITES, state, 0.5, initial);
+        }
+    EXPECT_EQ(25u, solutions.size());
+    EXPECT_EQ(3u, batch.windows());
+    batch.finish();
+    EXPECT_EQ(4u, batch.windows());
+    ASSERT_EQ(27u, solutions.size());
+    for (unsigned int k = 0; k < solutions.size(); k++)
+        {
+            EXPECT_DOUBLE_EQ(k < 25 ? k : 15.0 + k, solutions[k].rx_time);
+            EXPECT_TRUE(solutions[k].valid);
+            for (int j = 0; j < 3; j++)
+                {
+                    EXPECT_NEAR(rx[j], solutions[k].pos[j], 3.0);
+                }
+        }
+}
+
+
+TEST(BatchLsPvtTest, SecondSystemAndExclusions)
+{
+    double rx[3];
+    double satpos[3 * BATCH_TEST_SATELLITES];
+    double range[BATCH_TEST_SATELLITES];
+    batch_test_geometry(rx, satpos, range);
+    std::vector<Batch_Ls_Pvt_Solution> solutions;
+    Batch_Ls_Pvt batch(5, 1, [&solutions](const Batch_Ls_Pvt_Solution & s) { solutions.push_back(s); });
+    const double initial[4] = {rx[0], rx[1], rx[2], BATCH_TEST_CLOCK_M};
+
+    // The last three satellites have a clock 40 m ahead; a fault is excluded
+    for (int k = 0; k < 5; k++)
+        {
+            batch.begin_epoch(k);
+            for (int i = 0; i < BATCH_TEST_SATELLITES; i++)
+                {
+                    const bool second = i >= 6;
+                    const double obs = range[i] + BATCH_TEST_CLOCK_M + BATCH_TEST_DRIFT_M_S * k + (second ? 40.0 : 0.0) + (i == 2 ? 150.0 : 0.0);
+                    batch.add_observation(&satpos[3 * i], obs, 1.0, second ? 1 : 0);
+                }
+            batch.exclude_observation(2);
+            batch.end_epoch(initial);
+        }
+    ASSERT_EQ(5u, solutions.size());
+    for (int k = 0; k < 5; k++)
+        {
+            EXPECT_TRUE(solutions[k].valid);
+            EXPECT_EQ(BATCH_TEST_SATELLITES - 1, solutions[k].observations);
+            EXPECT_NEAR(40.0, solutions[k].isb_m, 0.05);
+            for (int j = 0; j < 3; j++)
+                {
+                    EXPECT_NEAR(rx[j], solutions[k].pos[j], 0.05);
+                }
+        }
+}
+
+
+TEST(BatchLsPvtTest, AccuracyAndTiming)
+{
+    double rx[3];
+    double satpos[3 * BATCH_TEST_SATELLITES];
+    double range[BATCH_TEST_SATELLITES];
+    batch_test_geometry(rx, satpos, range);
+    const int epochs = FLAGS_batch_ls_pvt_epochs_test;
+    std::vector<double> obs(epochs * BATCH_TEST_SATELLITES);
+    unsigned int state = 7;
+    for (int k = 0; k < epochs; k++)
+        {
+            for (int i = 0; i < BATCH_TEST_SATELLITES; i++)
+                {
+                    obs[k * BATCH_TEST_SATELLITES + i] = range[i] + BATCH_TEST_CLOCK_M + BATCH_TEST_DRIFT_M_S * 0.1 * k + batch_test_noise(state, 2.0);
+                }
+        }
+
+    // One fix per epoch
+    struct timeval tv;
+    Ls_Pvt pvt(BATCH_TEST_SATELLITES);
+    std::vector<double> initial(4 * epochs);
+    double epoch_error2 = 0.0;
+    gettimeofday(&tv, NULL);
+    long long int begin = tv.tv_sec * 1000000 + tv.tv_usec;
+    for (int k = 0; k < epochs; k++)
+        {
+            pvt.clear_observations();
+            for (int i = 0; i < BATCH_TEST_SATELLITES; i++)
+                {
+                    pvt.add_observation(&satpos[3 * i], 0, obs[k * BATCH_TEST_SATELLITES + i], 0.0, 1.0, 0);
+                }
+            arma::vec::fixed<LS_PVT_MAX_UNKNOWNS> pos = pvt.leastSquarePos();
+            for (int j = 0; j < 4; j++)
+                {
+                    initial[4 * k + j] = pos(j);
+                }
+        }
+    gettimeofday(&tv, NULL);
+    long long int end = tv.tv_sec * 1000000 + tv.tv_usec;
+    const double epoch_us = static_cast<double>(end - begin) / epochs;
+    for (int k = 0; k < epochs; k++)
+        {
+            for (int j = 0; j < 3; j++)
+                {
+                    epoch_error2 += (initial[4 * k + j] - rx[j]) * (initial[4 * k + j] - rx[j]);
+                }
+        }
+
+    // Windows of 10 epochs, from the per-epoch fixes
+    double batch_error2 = 0.0;
+    unsigned int valid = 0;
+    Batch_Ls_Pvt batch(10, 4, [&](const Batch_Ls_Pvt_Solution & s)
+        {
+            if (!s.valid) return;
+            valid++;
+            for (int j = 0; j < 3; j++)
+                {
+                    batch_error2 += (s.pos[j] - rx[j]) * (s.pos[j] - rx[j]);
+                }
+        });
+    gettimeofday(&tv, NULL);
+    begin = tv.tv_sec * 1000000 + tv.tv_usec;
+    for (int k = 0; k < epochs; k++)
+        {
+            batch.begin_epoch(0.1 * k);
+            for (int i = 0; i < BATCH_TEST_SATELLITES; i++)
+                {
+                    batch.add_observation(&satpos[3 * i], obs[k * BATCH_TEST_SATELLITES + i], 1.0, 0);
+                }
+            batch.end_epoch(&initial[4 * k]);
+        }
+    batch.finish();
+    gettimeofday(&tv, NULL);
+    end = tv.tv_sec * 1000000 + tv.tv_usec;
+    const double batch_us = static_cast<double>(end - begin) / epochs;
+
+    ASSERT_EQ(static_cast<unsigned int>(epochs), valid);
+    const double epoch_rms = sqrt(epoch_error2 / epochs);
+    const double batch_rms = sqrt(batch_error2 / epochs);
+    EXPECT_LT(batch_rms, epoch_rms);
+
+    std::cout << "Position error of " << epochs << " epochs: " << epoch_rms << " m RMS with a fix per epoch ("
+              << epoch_us << " us per epoch), " << batch_rms << " m RMS in windows of 10 epochs ("
+              << batch_us << " us per epoch, after the fixes)" << std::endl;
+}
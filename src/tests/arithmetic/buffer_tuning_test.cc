@@ -0,0 +1,71 @@
+/*!
+ * \file buffer_tuning_test.cc
+ * \brief Tests of the sizes of the buffers and work calls given to the blocks
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "gnss_sdr_buffer_tuning.h"
+
+
+TEST(Buffer_Tuning_test, SampleStream)
+{
+    // 4 Msps of gr_complex, a work call per ms and a buffer of 4 periods of 20 ms
+    Gnss_Sdr_Buffer_Settings settings = Gnss_Sdr_Buffer_Tuning::autotune(4e6, 8, 0.001, 0.08);
+    EXPECT_EQ(4000, settings.max_noutput_items);
+    EXPECT_EQ(320000, settings.min_output_buffer);
+    EXPECT_EQ(settings.min_output_buffer, settings.max_output_buffer);
+}
+
+
+TEST(Buffer_Tuning_test, TwoWorkCallsAtLeast)
+{
+    // an item per ms of tracking, buffered for less than a work call
+    Gnss_Sdr_Buffer_Settings settings = Gnss_Sdr_Buffer_Tuning::autotune(1000.0, 200, 0.004, 0.001);
+    EXPECT_EQ(4, settings.max_noutput_items);
+    EXPECT_EQ(8, settings.min_output_buffer);
+}
+
+
+TEST(Buffer_Tuning_test, CappedBuffer)
+{
+    Gnss_Sdr_Buffer_Settings settings = Gnss_Sdr_Buffer_Tuning::autotune(100e6, 8, 1.0, 10.0);
+    const long max_items = Gnss_Sdr_Buffer_Tuning::MAX_BUFFER_BYTES / 8;
+    EXPECT_EQ(max_items, settings.max_output_buffer);
+    EXPECT_EQ(max_items / 2, settings.max_noutput_items);
+}
+
+
+TEST(Buffer_Tuning_test, DefaultsWhenUnknown)
+{
+    Gnss_Sdr_Buffer_Settings settings = Gnss_Sdr_Buffer_Tuning::autotune(0.0, 8, 0.001, 0.08);
+    EXPECT_EQ(0, settings.min_output_buffer);
+    EXPECT_EQ(0, settings.max_output_buffer);
+    EXPECT_EQ(0, settings.max_noutput_items);
+    EXPECT_DOUBLE_EQ(0.004, Gnss_Sdr_Buffer_Tuning::code_period("1B"));
+    EXPECT_DOUBLE_EQ(0.02, Gnss_Sdr_Buffer_Tuning::code_period("2S"));
+    EXPECT_DOUBLE_EQ(0.001, Gnss_Sdr_Buffer_Tuning::code_period("XX"));
+}
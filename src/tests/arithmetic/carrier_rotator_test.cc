@@ -0,0 +1,95 @@
+/*!
+ * \file carrier_rotator_test.cc
+ * \brief  This file implements tests for the phase-continuous carrier rotator
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <complex>
+#include <gtest/gtest.h>
+#include "carrier_rotator.h"
+
+// What the rotator kernels do to the phase
+static void rotate(Carrier_Rotator & rotator, int samples)
+{
+    std::complex<float> * phase = rotator.phase();
+    const std::complex<float> phase_inc = rotator.phase_inc();
+    for (int n = 0; n < samples; n++)
+        {
+            *phase *= phase_inc;
+        }
+    rotator.advance(samples);
+}
+
+TEST(CarrierRotatorTest, IncrementFollowsSmallStepChanges)
+{
+    Carrier_Rotator rotator;
+    double step = 0.01;
+    rotator.set_phase_step(step);
+    for (int i = 0; i < 10000; i++)
+        {
+            step += 1e-6 * std::sin(0.01 * i);
+            rotator.set_phase_step(step);
+        }
+    EXPECT_DOUBLE_EQ(step, rotator.phase_step_rad());
+    EXPECT_NEAR(std::cos(step), rotator.phase_inc().real(), 1e-6);
+    EXPECT_NEAR(-std::sin(step), rotator.phase_inc().imag(), 1e-6);
+    EXPECT_NEAR(1.0, std::abs(rotator.phase_inc()), 1e-6);
+}
+
+TEST(CarrierRotatorTest, PhaseIsContinuousAcrossCalls)
+{
+    Carrier_Rotator rotator;
+    rotator.set_resync_period(50);
+    rotator.set_phase(1.0);
+    double step = 2.0 * M_PI * 1000.0 / 4e6;
+    for (int i = 0; i < 500; i++)
+        {
+            step += 1e-8;
+            rotator.set_phase_step(step);
+            rotate(rotator, 4000);
+            const std::complex<float> expected(std::cos(rotator.phase_rad()), -std::sin(rotator.phase_rad()));
+            ASSERT_NEAR(0.0, std::abs(*rotator.phase() - expected), 1e-3) << "after " << i + 1 << " calls";
+            ASSERT_NEAR(1.0, std::abs(*rotator.phase()), 1e-6);
+        }
+}
+
+TEST(CarrierRotatorTest, ResyncRebuildsThePhase)
+{
+    Carrier_Rotator rotator;
+    rotator.set_resync_period(3);
+    rotator.set_phase_step(0.1);
+    rotate(rotator, 100);
+    // pretend the kernels drifted
+    *rotator.phase() = std::complex<float>(0.0, 1.0);
+    rotate(rotator, 0);
+    EXPECT_NEAR(1.0, rotator.phase()->imag(), 1e-6);
+    rotate(rotator, 0);
+    const std::complex<float> expected(std::cos(rotator.phase_rad()), -std::sin(rotator.phase_rad()));
+    EXPECT_NEAR(0.0, std::abs(*rotator.phase() - expected), 1e-6);
+}
@@ -0,0 +1,98 @@
+/*!
+ * \file channel_shedding_test.cc
+ * \brief Tests of the choice of the channel shed by the overload protection.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <vector>
+#include <gtest/gtest.h>
+#include "gnss_channel_shedding.h"
+
+
+namespace
+{
+Gnss_Channel_Value channel_value(unsigned int channel, char system, double cn0_db_hz)
+{
+    Gnss_Channel_Value value;
+    value.channel = channel;
+    value.system = system;
+    value.has_elevation = false;
+    value.elevation_d = 0.0;
+    value.cn0_db_hz = cn0_db_hz;
+    return value;
+}
+}
+
+
+TEST(ChannelSheddingTest, NoChannel)
+{
+    std::vector<Gnss_Channel_Value> channels;
+    unsigned int channel = 7;
+    EXPECT_FALSE(gnss_channel_to_shed(channels, channel));
+    EXPECT_EQ(7u, channel);
+}
+
+
+TEST(ChannelSheddingTest, LowestCn0OfTheLargestSystem)
+{
+    std::vector<Gnss_Channel_Value> channels;
+    channels.push_back(channel_value(0, 'G', 45.0));
+    channels.push_back(channel_value(1, 'G', 38.0));
+    channels.push_back(channel_value(2, 'G', 41.0));
+    channels.push_back(channel_value(3, 'E', 30.0));
+    channels.push_back(channel_value(4, 'E', 44.0));
+    unsigned int channel = 0;
+    ASSERT_TRUE(gnss_channel_to_shed(channels, channel));
+    EXPECT_EQ(1u, channel);
+
+    // with as many channels in each system, the weakest of all
+    channels.erase(channels.begin() + 1);
+    ASSERT_TRUE(gnss_channel_to_shed(channels, channel));
+    EXPECT_EQ(3u, channel);
+}
+
+
+TEST(ChannelSheddingTest, LowestSatelliteFirst)
+{
+    std::vector<Gnss_Channel_Value> channels;
+    channels.push_back(channel_value(0, 'G', 35.0));
+    channels.push_back(channel_value(1, 'G', 48.0));
+    channels.push_back(channel_value(2, 'G', 40.0));
+    channels[0].has_elevation = true;
+    channels[0].elevation_d = 70.0;
+    channels[1].has_elevation = true;
+    channels[1].elevation_d = 8.0;
+    unsigned int channel = 0;
+    ASSERT_TRUE(gnss_channel_to_shed(channels, channel));
+    EXPECT_EQ(1u, channel);
+
+    // without predictions, the weakest, and the last channel on a tie
+    channels[0] = channel_value(0, 'G', 40.0);
+    channels[1] = channel_value(1, 'G', 40.0);
+    ASSERT_TRUE(gnss_channel_to_shed(channels, channel));
+    EXPECT_EQ(2u, channel);
+}
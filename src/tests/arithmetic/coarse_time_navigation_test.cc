@@ -0,0 +1,135 @@
+/*!
+ * \file coarse_time_navigation_test.cc
+ * \brief Tests the coarse-time navigation solution of synthetic code phases
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include "coarse_time_navigation.h"
+#include "GPS_L1_CA.h"
+
+namespace
+{
+Gps_Ephemeris coarse_time_satellite(unsigned int prn, double omega0_sc, double m0_sc, double af0_s)
+{
+    Gps_Ephemeris eph;
+    eph.i_satellite_PRN = prn;
+    eph.d_sqrt_A = 5153.7;
+    eph.d_e_eccentricity = 0.01;
+    eph.d_i_0 = 0.3056;
+    eph.d_OMEGA0 = omega0_sc;
+    eph.d_M_0 = m0_sc;
+    eph.d_OMEGA = 0.2;
+    eph.d_OMEGA_DOT = -2.6e-9;
+    eph.d_Toe = 345600.0;
+    eph.d_Toc = 345600.0;
+    eph.d_A_f0 = af0_s;
+    return eph;
+}
+
+
+// Fraction of a code period after first_sample_s at which a code period
+// transmitted by the satellite reaches the receiver at pos
+double coarse_time_code_phase(Gps_Ephemeris & eph, const double * pos, double first_sample_s)
+{
+    const double period = GPS_L1_CA_CODE_PERIOD;
+    double tau = 0.0;
+    double target = -1.0;
+    for (int k = 0; k < 4; k++)
+        {
+            // satellite time of the signal received at first_sample_s + tau
+            const double t = first_sample_s + tau;
+            double travel = 0.07;
+            for (int j = 0; j < 6; j++)
+                {
+                    eph.satellitePosition(t - travel);
+                    const double rot = OMEGA_EARTH_DOT * travel;
+                    const double x = std::cos(rot) * eph.d_satpos_X + std::sin(rot) * eph.d_satpos_Y - pos[0];
+                    const double y = -std::sin(rot) * eph.d_satpos_X + std::cos(rot) * eph.d_satpos_Y - pos[1];
+                    const double z = eph.d_satpos_Z - pos[2];
+                    travel = std::sqrt(x * x + y * y + z * z) / GPS_C_m_s;
+                }
+            const double sv_time = t - travel + eph.sv_clock_drift(t - travel);
+            if (target < 0.0)
+                {
+                    target = std::ceil(sv_time / period) * period;
+                }
+            tau += target - sv_time;
+        }
+    return tau;
+}
+}
+
+
+TEST(CoarseTimeNavigationTest, SolvesPositionAndTime)
+{
+    // Receiver near Barcelona, with a priori values 20 km and 2 s off
+    const double truth[3] = {4797900.0, 166600.0, 4185400.0};
+    const double approx[3] = {truth[0] + 12000.0, truth[1] - 9000.0, truth[2] + 13000.0};
+    const double first_sample_s = 345600.0 + 1800.25;
+
+    std::vector<Gps_Ephemeris> satellites;
+    const double omega0[6] = {0.0, 0.05, -0.1, 0.33, -0.3, 0.2};
+    const double m0[6] = {0.1, 0.3, -0.05, 0.25, 0.0, -0.2};
+    for (int i = 0; i < 6; i++)
+        {
+            satellites.push_back(coarse_time_satellite(i + 1, omega0[i], m0[i], 1e-5 * (i - 3)));
+        }
+
+    Coarse_Time_Navigation navigation;
+    for (int i = 0; i < 6; i++)
+        {
+            navigation.add_observation(satellites[i], coarse_time_code_phase(satellites[i], truth, first_sample_s));
+        }
+    ASSERT_EQ(6, navigation.num_observations());
+    ASSERT_TRUE(navigation.solve(approx, first_sample_s + 2.0));
+    EXPECT_NEAR(truth[0], navigation.d_rx_pos_m[0], 1.0);
+    EXPECT_NEAR(truth[1], navigation.d_rx_pos_m[1], 1.0);
+    EXPECT_NEAR(truth[2], navigation.d_rx_pos_m[2], 1.0);
+    EXPECT_NEAR(first_sample_s, navigation.tow_s(), 1e-3);
+    EXPECT_NEAR(-2.0, navigation.time_offset_s(), 1e-3);
+    EXPECT_LT(navigation.residual_rms_m(), 1.0);
+
+    // With four satellites the time is held at the given one
+    navigation.clear_observations();
+    for (int i = 0; i < 4; i++)
+        {
+            navigation.add_observation(satellites[i], coarse_time_code_phase(satellites[i], truth, first_sample_s));
+        }
+    ASSERT_TRUE(navigation.solve(approx, first_sample_s));
+    EXPECT_NEAR(truth[0], navigation.d_rx_pos_m[0], 1.0);
+    EXPECT_EQ(0.0, navigation.time_offset_s());
+
+    navigation.clear_observations();
+    for (int i = 0; i < 3; i++)
+        {
+            navigation.add_observation(satellites[i], 1e-4 * i);
+        }
+    EXPECT_FALSE(navigation.solve(approx, first_sample_s));
+}
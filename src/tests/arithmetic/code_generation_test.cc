@@ -34,6 +34,7 @@
 #include <ctime>
 #include "gps_sdr_signal_processing.h"
 #include "gnss_signal_processing.h"
+#include "galileo_e1_signal_processing.h"
 
 
 
@@ -132,6 +133,44 @@ TEST(CodeGenGPSL1Sampled_Test, CodeGeneration)
 }
 
 
+TEST(CodeGenGalileoE1Sampled_Test, MatchesResampledReplica)
+{
+    // The sampled code is the sinboc(1,1) replica at 2 samples per chip,
+    // resampled to _fs
+    char _signal[3] = "1B";
+    signed int _prn = 11;
+    signed int _fs = 5000000;
+    const unsigned int _replicaLength = 2 * 4092;
+    unsigned int _samplesPerCode = static_cast<unsigned int>(static_cast<double>(_fs) / (1023000.0 / 4092.0));
+    int* _chips = new int[4092];
+    std::complex<float>* _replica = new std::complex<float>[_replicaLength];
+    std::complex<float>* _expected = new std::complex<float>[_samplesPerCode];
+    std::complex<float>* _dest = new std::complex<float>[_samplesPerCode];
+
+    galileo_e1_code_gen_int(_chips, _signal, _prn);
+    galileo_e1_sinboc_11_gen(_replica, _chips, _replicaLength);
+    resampler(_replica, _expected, 2 * 1023000, _fs, _replicaLength, _samplesPerCode);
+
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    long long int begin = tv.tv_sec * 1000000 + tv.tv_usec;
+    galileo_e1_code_gen_complex_sampled(_dest, _signal, false, _prn, _fs, 0);
+    gettimeofday(&tv, NULL);
+    long long int end = tv.tv_sec * 1000000 + tv.tv_usec;
+    std::cout << "Generation completed in " << (end - begin) << " microseconds" << std::endl;
+
+    for (unsigned int i = 0; i < _samplesPerCode; i++)
+        {
+            ASSERT_EQ(_expected[i], _dest[i]) << "at sample " << i;
+        }
+
+    delete[] _chips;
+    delete[] _replica;
+    delete[] _expected;
+    delete[] _dest;
+}
+
+
 TEST(ComplexCarrier_Test, CodeGeneration)
 {
     double _fs = 8000000;
@@ -0,0 +1,179 @@
+/*!
+ * \file concurrent_queue_test.cc
+ * \brief  This file implements tests for the lock-free concurrent_queue and
+ *  concurrent_map shared by the threads of the receiver.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/thread.hpp>
+#include <gtest/gtest.h>
+#include "concurrent_queue.h"
+#include "concurrent_map.h"
+
+
+TEST(ConcurrentQueueTest, KeepsOrderAndCapacity)
+{
+    concurrent_queue<std::string> queue(3); // rounded up to 4
+    EXPECT_EQ(4u, queue.capacity());
+    EXPECT_TRUE(queue.empty());
+    for (int n = 0; n < 4; n++)
+        {
+            EXPECT_TRUE(queue.try_push(std::to_string(n)));
+        }
+    EXPECT_FALSE(queue.try_push("full"));
+    EXPECT_FALSE(queue.empty());
+
+    std::string value;
+    for (int lap = 0; lap < 3; lap++)
+        {
+            for (int n = 0; n < 4; n++)
+                {
+                    ASSERT_TRUE(queue.try_pop(value));
+                    EXPECT_EQ(std::to_string(n), value);
+                    queue.push(std::to_string(n));
+                }
+        }
+    for (int n = 0; n < 4; n++)
+        {
+            queue.wait_and_pop(value);
+            EXPECT_EQ(std::to_string(n), value);
+        }
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.try_pop(value));
+    EXPECT_FALSE(queue.timed_wait_and_pop(value, 10));
+}
+
+
+TEST(ConcurrentQueueTest, ManyProducersAndConsumers)
+{
+    // a small queue, so that the producers wait for free space too
+    concurrent_queue<int> queue(8);
+    const int n_producers = 4;
+    const int n_consumers = 3;
+    const int items = 20000;
+    std::vector<long long> sums(n_consumers, 0);
+    std::vector<int> counts(n_consumers, 0);
+    boost::thread_group threads;
+    for (int c = 0; c < n_consumers; c++)
+        {
+            threads.create_thread([&queue, &sums, &counts, c]()
+                    {
+                int value;
+                while (true)
+                    {
+                        queue.wait_and_pop(value);
+                        if (value < 0) break;
+                        sums[c] += value;
+                        counts[c]++;
+                    }
+                    });
+        }
+    boost::thread_group producers;
+    for (int p = 0; p < n_producers; p++)
+        {
+            producers.create_thread([&queue, p]()
+                    {
+                for (int n = 0; n < items; n++)
+                    {
+                        queue.push(p * items + n);
+                    }
+                    });
+        }
+    producers.join_all();
+    for (int c = 0; c < n_consumers; c++)
+        {
+            queue.push(-1);
+        }
+    threads.join_all();
+
+    long long sum = 0;
+    int count = 0;
+    for (int c = 0; c < n_consumers; c++)
+        {
+            sum += sums[c];
+            count += counts[c];
+        }
+    const long long total = static_cast<long long>(n_producers) * items;
+    EXPECT_EQ(total, count);
+    EXPECT_EQ(total * (total - 1) / 2, sum);
+    EXPECT_TRUE(queue.empty());
+}
+
+
+TEST(ConcurrentMapTest, WritesAndReads)
+{
+    concurrent_map<std::string> map(4);
+    std::string value;
+    EXPECT_FALSE(map.read(1, value));
+    EXPECT_FALSE(map.read(1));
+    EXPECT_TRUE(map.write(1, "one"));
+    EXPECT_TRUE(map.write(5, "five")); // same first slot as 1
+    EXPECT_TRUE(map.write(-3, "minus three"));
+    EXPECT_TRUE(map.write(1, "uno"));
+    EXPECT_EQ(3u, map.size());
+    ASSERT_TRUE(map.read(1, value));
+    EXPECT_EQ("uno", value);
+    EXPECT_EQ("five", *map.read(5));
+    EXPECT_TRUE(map.write(2, "two"));
+    EXPECT_FALSE(map.write(3, "three")); // full
+    EXPECT_FALSE(map.read(3, value));
+
+    std::map<int, std::string> copy = map.get_map_copy();
+    ASSERT_EQ(4u, copy.size());
+    EXPECT_EQ("minus three", copy.at(-3));
+    EXPECT_EQ("two", copy.at(2));
+}
+
+
+TEST(ConcurrentMapTest, ConcurrentWriters)
+{
+    concurrent_map<std::vector<int> > map(64);
+    const int n_writers = 4;
+    boost::thread_group writers;
+    for (int w = 0; w < n_writers; w++)
+        {
+            writers.create_thread([&map, w]()
+                    {
+                for (int n = 0; n < 2000; n++)
+                    {
+                        // all the writers race for the same keys
+                        map.write(n % 40, std::vector<int>(100, w));
+                        std::shared_ptr<const std::vector<int> > value = map.read((n + 7) % 40);
+                        if (value)
+                            {
+                                EXPECT_EQ(value->front(), value->back());
+                            }
+                    }
+                    });
+        }
+    writers.join_all();
+    EXPECT_EQ(40u, map.size());
+    EXPECT_EQ(40u, map.get_map_copy().size());
+}
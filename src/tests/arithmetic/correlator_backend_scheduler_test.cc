@@ -0,0 +1,121 @@
+/*!
+ * \file correlator_backend_scheduler_test.cc
+ * \brief Tests of the assignment of tracking channels to the CPU or GPU correlators
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "correlator_backend_scheduler.h"
+
+
+TEST(Correlator_Backend_Scheduler_test, DisabledKeepsTheGpu)
+{
+    Correlator_Backend_Scheduler scheduler;
+    scheduler.configure(false, 2, 0, 1, 0.5);
+    for (unsigned int ch = 0; ch < 4; ch++)
+        {
+            EXPECT_EQ(CORRELATOR_BACKEND_GPU, scheduler.assign(ch));
+            scheduler.report(ch, 5000.0, 1000.0);
+        }
+    EXPECT_EQ(4u, scheduler.channels(CORRELATOR_BACKEND_GPU));
+    EXPECT_EQ(0u, scheduler.migrations());
+}
+
+
+TEST(Correlator_Backend_Scheduler_test, GpuCapacity)
+{
+    Correlator_Backend_Scheduler scheduler;
+    scheduler.configure(true, 2, 0, 1000, 0.5);
+    EXPECT_EQ(CORRELATOR_BACKEND_GPU, scheduler.assign(0));
+    EXPECT_EQ(CORRELATOR_BACKEND_GPU, scheduler.assign(1));
+    EXPECT_EQ(CORRELATOR_BACKEND_CPU, scheduler.assign(2));
+    scheduler.release(1);
+    EXPECT_EQ(CORRELATOR_BACKEND_GPU, scheduler.assign(3));
+    EXPECT_EQ(CORRELATOR_BACKEND_GPU, scheduler.backend(3));
+}
+
+
+TEST(Correlator_Backend_Scheduler_test, SaturatedGpuSheddingChannels)
+{
+    // a GPU whose latency grows with its channels, a CPU of constant latency
+    Correlator_Backend_Scheduler scheduler;
+    const unsigned int n_channels = 8;
+    const unsigned int rebalance = 50;
+    scheduler.configure(true, 0, 0, rebalance, 0.5);
+    for (unsigned int ch = 0; ch < n_channels; ch++)
+        {
+            EXPECT_EQ(CORRELATOR_BACKEND_GPU, scheduler.assign(ch));
+        }
+    for (int epoch = 0; epoch < 2000; epoch++)
+        {
+            unsigned int gpu_channels = scheduler.channels(CORRELATOR_BACKEND_GPU);
+            for (unsigned int ch = 0; ch < n_channels; ch++)
+                {
+                    double latency = scheduler.backend(ch) == CORRELATOR_BACKEND_GPU ? 100.0 * gpu_channels : 200.0;
+                    scheduler.report(ch, latency, 1000.0);
+                }
+        }
+    // past 2 channels the GPU is slower than the CPU by more than the margin
+    unsigned int gpu_channels = scheduler.channels(CORRELATOR_BACKEND_GPU);
+    EXPECT_GE(gpu_channels, 2u);
+    EXPECT_LE(gpu_channels, 3u);
+    EXPECT_EQ(n_channels - gpu_channels, scheduler.channels(CORRELATOR_BACKEND_CPU));
+    EXPECT_LT(scheduler.latency_us(CORRELATOR_BACKEND_GPU), 500.0);
+    // the channels settle instead of going back and forth
+    EXPECT_LE(scheduler.migrations(), 2u * n_channels);
+    unsigned long long migrations = scheduler.migrations();
+    for (int epoch = 0; epoch < 1000; epoch++)
+        {
+            gpu_channels = scheduler.channels(CORRELATOR_BACKEND_GPU);
+            for (unsigned int ch = 0; ch < n_channels; ch++)
+                {
+                    double latency = scheduler.backend(ch) == CORRELATOR_BACKEND_GPU ? 100.0 * gpu_channels : 200.0;
+                    scheduler.report(ch, latency, 1000.0);
+                }
+        }
+    EXPECT_EQ(migrations, scheduler.migrations());
+}
+
+
+TEST(Correlator_Backend_Scheduler_test, CpuCapacityLimitsMoves)
+{
+    Correlator_Backend_Scheduler scheduler;
+    scheduler.configure(true, 0, 1, 10, 0.5);
+    for (unsigned int ch = 0; ch < 4; ch++)
+        {
+            scheduler.assign(ch);
+        }
+    // the GPU misses its deadline, but the CPU takes a single channel
+    for (int epoch = 0; epoch < 100; epoch++)
+        {
+            for (unsigned int ch = 0; ch < 4; ch++)
+                {
+                    scheduler.report(ch, 900.0, 1000.0);
+                }
+        }
+    EXPECT_EQ(1u, scheduler.channels(CORRELATOR_BACKEND_CPU));
+    EXPECT_EQ(3u, scheduler.channels(CORRELATOR_BACKEND_GPU));
+}
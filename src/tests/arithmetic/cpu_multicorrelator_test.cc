@@ -34,8 +34,11 @@
 #include <thread>
 #include <volk/volk.h>
 #include "cpu_multicorrelator.h"
+#include "cpu_multicorrelator_16sc.h"
 #include "gps_sdr_signal_processing.h"
+#include "gps_l2c_signal.h"
 #include "GPS_L1_CA.h"
+#include "GPS_L2C.h"
 
 
 DEFINE_int32(cpu_multicorrelator_iterations_test, 1000, "Number of averaged iterations in CPU multicorrelator test timing test");
@@ -162,3 +165,270 @@ TEST(CPU_multicorrelator_test, MeasureExecutionTime)
         correlator_pool[n]->free();
     }
 }
+
+
+TEST(CPU_multicorrelator_test, FastResamplerMatchesDefault)
+{
+    // one 20 ms GPS L2CM integration at 2 Msps
+    const int code_length = static_cast<int>(GPS_L2_M_CODE_LENGTH_CHIPS);
+    const int signal_length = 40000;
+    const int n_taps = 3;
+    float shifts[n_taps] = { -0.5, 0.0, 0.5 };
+
+    gr_complex* code = static_cast<gr_complex*>(volk_malloc(code_length * sizeof(gr_complex), volk_get_alignment()));
+    gps_l2c_m_code_gen_complex(code, 1);
+    gr_complex* in = static_cast<gr_complex*>(volk_malloc(signal_length * sizeof(gr_complex), volk_get_alignment()));
+    for (int n = 0; n < signal_length; n++)
+        {
+            in[n] = gr_complex(static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5,
+                               static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5);
+        }
+    gr_complex* default_out = static_cast<gr_complex*>(volk_malloc(n_taps * sizeof(gr_complex), volk_get_alignment()));
+    gr_complex* fast_out = static_cast<gr_complex*>(volk_malloc(n_taps * sizeof(gr_complex), volk_get_alignment()));
+
+    // code phases that are multiples of 1/8 chip, so that both resamplers pick
+    // the same chips regardless of the float rounding
+    const float code_phase_step_chips = 0.25;
+    const float rem_code_phase_chips = 0.375;
+
+    cpu_multicorrelator correlator;
+    correlator.init(signal_length, n_taps);
+    correlator.set_local_code_and_taps(code_length, code, shifts);
+    correlator.set_input_output_vectors(default_out, in);
+    correlator.Carrier_wipeoff_multicorrelator_resampler(0.2, 0.05, rem_code_phase_chips, code_phase_step_chips, signal_length);
+    correlator.set_fast_resampler(true);
+    correlator.set_input_output_vectors(fast_out, in);
+    correlator.Carrier_wipeoff_multicorrelator_resampler(0.2, 0.05, rem_code_phase_chips, code_phase_step_chips, signal_length);
+    correlator.free();
+
+    for (int n = 0; n < n_taps; n++)
+        {
+            EXPECT_NEAR(default_out[n].real(), fast_out[n].real(), 1e-2);
+            EXPECT_NEAR(default_out[n].imag(), fast_out[n].imag(), 1e-2);
+        }
+
+    volk_free(code);
+    volk_free(in);
+    volk_free(default_out);
+    volk_free(fast_out);
+}
+
+
+TEST(CPU_multicorrelator_test, DataAndPilotInOnePass)
+{
+    // two C/A codes stand for the data and pilot codes, 2 ms at 2 Msps
+    const int code_length = static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS);
+    const int signal_length = 4000;
+    const int n_pilot_taps = 3;
+    float shifts[n_pilot_taps] = { -0.5, 0.0, 0.5 };
+
+    gr_complex* data_code = static_cast<gr_complex*>(volk_malloc(code_length * sizeof(gr_complex), volk_get_alignment()));
+    gr_complex* pilot_code = static_cast<gr_complex*>(volk_malloc(code_length * sizeof(gr_complex), volk_get_alignment()));
+    gps_l1_ca_code_gen_complex(data_code, 1, 0);
+    gps_l1_ca_code_gen_complex(pilot_code, 2, 0);
+    gr_complex* in = static_cast<gr_complex*>(volk_malloc(signal_length * sizeof(gr_complex), volk_get_alignment()));
+    for (int n = 0; n < signal_length; n++)
+        {
+            in[n] = gr_complex(static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5,
+                               static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5);
+        }
+    gr_complex* data_out = static_cast<gr_complex*>(volk_malloc(sizeof(gr_complex), volk_get_alignment()));
+    gr_complex* pilot_out = static_cast<gr_complex*>(volk_malloc(n_pilot_taps * sizeof(gr_complex), volk_get_alignment()));
+    gr_complex* joint_out = static_cast<gr_complex*>(volk_malloc((1 + n_pilot_taps) * sizeof(gr_complex), volk_get_alignment()));
+
+    const float code_phase_step_chips = 0.5;
+    const float rem_code_phase_chips = 0.25;
+    const int iterations = 100;
+    struct timeval tv;
+
+    cpu_multicorrelator data;
+    cpu_multicorrelator pilot;
+    data.init(signal_length, 1);
+    pilot.init(signal_length, n_pilot_taps);
+    data.set_local_code_and_taps(code_length, data_code, &shifts[1]);
+    pilot.set_local_code_and_taps(code_length, pilot_code, shifts);
+    data.set_input_output_vectors(data_out, in);
+    pilot.set_input_output_vectors(pilot_out, in);
+    gettimeofday(&tv, NULL);
+    long long int begin = tv.tv_sec * 1000000 + tv.tv_usec;
+    for (int k = 0; k < iterations; k++)
+        {
+            data.Carrier_wipeoff_multicorrelator_resampler(0.2, 0.05, rem_code_phase_chips, code_phase_step_chips, signal_length);
+            pilot.Carrier_wipeoff_multicorrelator_resampler(0.2, 0.05, rem_code_phase_chips, code_phase_step_chips, signal_length);
+        }
+    gettimeofday(&tv, NULL);
+    long long int end = tv.tv_sec * 1000000 + tv.tv_usec;
+    std::cout << "Data and pilot in two passes: " << (end - begin) / iterations << " microseconds" << std::endl;
+
+    cpu_multicorrelator joint;
+    joint.init(signal_length, 1, n_pilot_taps);
+    joint.set_local_code_and_taps(code_length, data_code, &shifts[1]);
+    joint.set_pilot_code_and_taps(pilot_code, shifts);
+    joint.set_input_output_vectors(joint_out, in);
+    gettimeofday(&tv, NULL);
+    begin = tv.tv_sec * 1000000 + tv.tv_usec;
+    for (int k = 0; k < iterations; k++)
+        {
+            joint.Carrier_wipeoff_multicorrelator_resampler(0.2, 0.05, rem_code_phase_chips, code_phase_step_chips, signal_length);
+        }
+    gettimeofday(&tv, NULL);
+    end = tv.tv_sec * 1000000 + tv.tv_usec;
+    std::cout << "Data and pilot in one pass: " << (end - begin) / iterations << " microseconds" << std::endl;
+
+    EXPECT_NEAR(data_out[0].real(), joint_out[0].real(), 1e-2);
+    EXPECT_NEAR(data_out[0].imag(), joint_out[0].imag(), 1e-2);
+    for (int n = 0; n < n_pilot_taps; n++)
+        {
+            EXPECT_NEAR(pilot_out[n].real(), joint_out[1 + n].real(), 1e-2);
+            EXPECT_NEAR(pilot_out[n].imag(), joint_out[1 + n].imag(), 1e-2);
+        }
+    data.free();
+    pilot.free();
+    joint.free();
+
+    volk_free(data_code);
+    volk_free(pilot_code);
+    volk_free(in);
+    volk_free(data_out);
+    volk_free(pilot_out);
+    volk_free(joint_out);
+}
+
+
+TEST(CPU_multicorrelator_test, DataAndPilotInOnePass16sc)
+{
+    // same as above, with 16-bit integer samples and codes
+    const int code_length = static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS);
+    const int signal_length = 4000;
+    const int n_pilot_taps = 3;
+    float shifts[n_pilot_taps] = { -0.5, 0.0, 0.5 };
+
+    gr_complex* code = static_cast<gr_complex*>(volk_malloc(code_length * sizeof(gr_complex), volk_get_alignment()));
+    lv_16sc_t* data_code = static_cast<lv_16sc_t*>(volk_malloc(code_length * sizeof(lv_16sc_t), volk_get_alignment()));
+    lv_16sc_t* pilot_code = static_cast<lv_16sc_t*>(volk_malloc(code_length * sizeof(lv_16sc_t), volk_get_alignment()));
+    gps_l1_ca_code_gen_complex(code, 1, 0);
+    volk_gnsssdr_32fc_convert_16ic(data_code, code, code_length);
+    gps_l1_ca_code_gen_complex(code, 2, 0);
+    volk_gnsssdr_32fc_convert_16ic(pilot_code, code, code_length);
+    lv_16sc_t* in = static_cast<lv_16sc_t*>(volk_malloc(signal_length * sizeof(lv_16sc_t), volk_get_alignment()));
+    for (int n = 0; n < signal_length; n++)
+        {
+            in[n] = lv_16sc_t(rand() % 201 - 100, rand() % 201 - 100);
+        }
+    gr_complex* data_out = static_cast<gr_complex*>(volk_malloc(sizeof(gr_complex), volk_get_alignment()));
+    gr_complex* pilot_out = static_cast<gr_complex*>(volk_malloc(n_pilot_taps * sizeof(gr_complex), volk_get_alignment()));
+    gr_complex* joint_out = static_cast<gr_complex*>(volk_malloc((1 + n_pilot_taps) * sizeof(gr_complex), volk_get_alignment()));
+
+    const float code_phase_step_chips = 0.5;
+    const float rem_code_phase_chips = 0.25;
+
+    cpu_multicorrelator_16sc data;
+    cpu_multicorrelator_16sc pilot;
+    data.init(signal_length, 1);
+    pilot.init(signal_length, n_pilot_taps);
+    data.set_local_code_and_taps(code_length, data_code, &shifts[1]);
+    pilot.set_local_code_and_taps(code_length, pilot_code, shifts);
+    data.set_input_output_vectors(data_out, in);
+    pilot.set_input_output_vectors(pilot_out, in);
+    data.Carrier_wipeoff_multicorrelator_resampler(0.2, 0.05, rem_code_phase_chips, code_phase_step_chips, signal_length);
+    pilot.Carrier_wipeoff_multicorrelator_resampler(0.2, 0.05, rem_code_phase_chips, code_phase_step_chips, signal_length);
+
+    cpu_multicorrelator_16sc joint;
+    joint.init(signal_length, 1, n_pilot_taps);
+    joint.set_local_code_and_taps(code_length, data_code, &shifts[1]);
+    joint.set_pilot_code_and_taps(pilot_code, shifts);
+    joint.set_input_output_vectors(joint_out, in);
+    joint.Carrier_wipeoff_multicorrelator_resampler(0.2, 0.05, rem_code_phase_chips, code_phase_step_chips, signal_length);
+
+    EXPECT_NEAR(data_out[0].real(), joint_out[0].real(), 1.0);
+    EXPECT_NEAR(data_out[0].imag(), joint_out[0].imag(), 1.0);
+    for (int n = 0; n < n_pilot_taps; n++)
+        {
+            EXPECT_NEAR(pilot_out[n].real(), joint_out[1 + n].real(), 1.0);
+            EXPECT_NEAR(pilot_out[n].imag(), joint_out[1 + n].imag(), 1.0);
+        }
+    data.free();
+    pilot.free();
+    joint.free();
+
+    volk_free(code);
+    volk_free(data_code);
+    volk_free(pilot_code);
+    volk_free(in);
+    volk_free(data_out);
+    volk_free(pilot_out);
+    volk_free(joint_out);
+}
+
+
+TEST(CPU_multicorrelator_test, FftCorrelationMatchesDefault)
+{
+    // 64 correlators on the sample grid, as in signal quality monitoring
+    const int code_length = static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS);
+    const int signal_length = 4000;
+    const int n_taps = 64;
+    const float code_phase_step_chips = 0.5;
+    const float rem_code_phase_chips = 0.0;
+    float shifts[n_taps];
+    for (int n = 0; n < n_taps; n++)
+        {
+            shifts[n] = (n - n_taps / 2) * code_phase_step_chips;
+        }
+
+    gr_complex* code = static_cast<gr_complex*>(volk_malloc(code_length * sizeof(gr_complex), volk_get_alignment()));
+    gps_l1_ca_code_gen_complex(code, 1, 0);
+    gr_complex* in = static_cast<gr_complex*>(volk_malloc(signal_length * sizeof(gr_complex), volk_get_alignment()));
+    for (int n = 0; n < signal_length; n++)
+        {
+            // the code 1.5 chips late on a carrier of 0.05 rad per sample, plus noise
+            int chip = static_cast<int>(std::floor(n * code_phase_step_chips - 1.5 + code_length)) % code_length;
+            in[n] = code[chip] * std::exp(gr_complex(0.0, 0.05 * n + 0.2))
+                    + gr_complex(static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5,
+                                 static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5);
+        }
+    gr_complex* default_out = static_cast<gr_complex*>(volk_malloc(n_taps * sizeof(gr_complex), volk_get_alignment()));
+    gr_complex* fft_out = static_cast<gr_complex*>(volk_malloc(n_taps * sizeof(gr_complex), volk_get_alignment()));
+
+    const int iterations = 100;
+    struct timeval tv;
+    cpu_multicorrelator correlator;
+    correlator.init(signal_length, n_taps);
+    correlator.set_local_code_and_taps(code_length, code, shifts);
+
+    correlator.set_input_output_vectors(default_out, in);
+    gettimeofday(&tv, NULL);
+    long long int begin = tv.tv_sec * 1000000 + tv.tv_usec;
+    for (int k = 0; k < iterations; k++)
+        {
+            correlator.Carrier_wipeoff_multicorrelator_resampler(0.2, 0.05, rem_code_phase_chips, code_phase_step_chips, signal_length);
+        }
+    gettimeofday(&tv, NULL);
+    long long int end = tv.tv_sec * 1000000 + tv.tv_usec;
+    std::cout << n_taps << " correlators with dot products: " << (end - begin) / iterations << " microseconds" << std::endl;
+
+    correlator.set_fft_correlation(true);
+    correlator.set_input_output_vectors(fft_out, in);
+    gettimeofday(&tv, NULL);
+    begin = tv.tv_sec * 1000000 + tv.tv_usec;
+    for (int k = 0; k < iterations; k++)
+        {
+            correlator.Carrier_wipeoff_multicorrelator_resampler(0.2, 0.05, rem_code_phase_chips, code_phase_step_chips, signal_length);
+        }
+    gettimeofday(&tv, NULL);
+    end = tv.tv_sec * 1000000 + tv.tv_usec;
+    std::cout << n_taps << " correlators with FFTs: " << (end - begin) / iterations << " microseconds" << std::endl;
+
+    // the peak is at the tap of -1.5 chips, of magnitude about signal_length
+    EXPECT_GT(std::abs(default_out[n_taps / 2 - 3]), 0.9 * signal_length);
+    for (int n = 0; n < n_taps; n++)
+        {
+            EXPECT_NEAR(default_out[n].real(), fft_out[n].real(), 1e-3 * signal_length);
+            EXPECT_NEAR(default_out[n].imag(), fft_out[n].imag(), 1e-3 * signal_length);
+        }
+    correlator.free();
+
+    volk_free(code);
+    volk_free(in);
+    volk_free(default_out);
+    volk_free(fft_out);
+}
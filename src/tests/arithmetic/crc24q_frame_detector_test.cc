@@ -0,0 +1,151 @@
+/*!
+ * \file crc24q_frame_detector_test.cc
+ * \brief  Tests the CRC-24Q frame detector and the Viterbi symbol aligner
+ *  shared by the SBAS L1 and GPS L2C CNAV telemetry decoders.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include <gtest/gtest.h>
+#include "convolutional.h"
+#include "crc24q_frame_detector.h"
+#include "gnss_crc24q.h"
+#include "viterbi_symbol_aligner.h"
+
+
+namespace
+{
+const int frame_test_preamble[8] = { 1, 0, 0, 0, 1, 0, 1, 1 };  // GPS L2C CNAV
+const unsigned int frame_test_msg_length = 300;
+
+// random message starting with the preamble, its last 24 bits the CRC-24Q of the others
+std::vector<int> frame_test_message()
+{
+    const unsigned int n_data = frame_test_msg_length - 24;
+    const unsigned int pad = (8 - n_data % 8) % 8;
+    std::vector<int> msg(frame_test_msg_length);
+    for (unsigned int i = 0; i < n_data; i++)
+        {
+            msg[i] = i < 8 ? frame_test_preamble[i] : rand() % 2;
+        }
+    // leading zeros do not change the CRC
+    std::vector<int> padded(pad, 0);
+    padded.insert(padded.end(), msg.begin(), msg.begin() + n_data);
+    std::vector<unsigned char> bytes(padded.size() / 8);
+    Crc24q_Frame_Detector::pack_bits(padded.data(), padded.size(), bytes.data());
+    unsigned int crc = Gnss_Crc24q::checksum(bytes.data(), bytes.size());
+    for (unsigned int i = 0; i < 24; i++)
+        {
+            msg[n_data + i] = (crc >> (23 - i)) & 1;
+        }
+    return msg;
+}
+
+std::vector<int> frame_test_random_bits(int n)
+{
+    std::vector<int> bits(n);
+    for (int i = 0; i < n; i++)
+        {
+            bits[i] = rand() % 2;
+        }
+    return bits;
+}
+}
+
+
+TEST(Crc24qFrameDetectorTest, ValidAndInvertedFrames)
+{
+    Crc24q_Frame_Detector detector(frame_test_msg_length, frame_test_preamble, 1, 8);
+    std::vector<int> msg = frame_test_message();
+    std::vector<int> inverted(msg);
+    for (unsigned int i = 0; i < inverted.size(); i++) inverted[i] = 1 - inverted[i];
+    std::vector<int> corrupted(msg);
+    corrupted[100] = 1 - corrupted[100];
+
+    std::vector<int> bits = frame_test_random_bits(37);
+    bits.insert(bits.end(), msg.begin(), msg.end());
+    bits.insert(bits.end(), corrupted.begin(), corrupted.end());
+    bits.insert(bits.end(), inverted.begin(), inverted.end());
+    bits.push_back(0);
+
+    std::vector<Crc24q_Frame_Detector::frame_t> frames;
+    // in batches of one CNAV block
+    for (unsigned int n = 0; n < bits.size(); n += 150)
+        {
+            int n_bits = std::min<int>(150, bits.size() - n);
+            detector.push_bits(&bits[n], n_bits, frames);
+        }
+    ASSERT_EQ(2u, frames.size());
+    EXPECT_TRUE(frames[0].second == msg);
+    EXPECT_TRUE(frames[1].second == msg);
+}
+
+
+TEST(Crc24qFrameDetectorTest, DecodingChainWithShiftedSymbols)
+{
+    const int KK = 7;
+    const int nn = 2;
+    int g_encoder[2] = { 121, 91 };
+    const int batch = 120;  // symbols
+    std::vector<int> msg = frame_test_message();
+    std::vector<int> bits = frame_test_random_bits(61);
+    bits.insert(bits.end(), msg.begin(), msg.end());
+    std::vector<int> tail = frame_test_random_bits(200);
+    bits.insert(bits.end(), tail.begin(), tail.end());
+
+    // BPSK symbols of the encoded bits, one stray symbol in front
+    std::vector<double> symbols(1, 1.0);
+    int state = 0;
+    int next_state[1];
+    for (unsigned int t = 0; t < bits.size(); t++)
+        {
+            int out = nsc_enc_bit(next_state, bits[t], state, g_encoder, KK, nn);
+            state = next_state[0];
+            for (int i = 0; i < nn; i++)
+                {
+                    symbols.push_back(((out >> (nn - i - 1)) & 1) ? 1.0 : -1.0);
+                }
+        }
+
+    Viterbi_Symbol_Aligner aligner(g_encoder, KK, nn, batch);
+    Crc24q_Frame_Detector detector(frame_test_msg_length, frame_test_preamble, 1, 8);
+    std::vector<int> decoded;
+    decoded.reserve(batch / nn);
+    std::vector<Crc24q_Frame_Detector::frame_t> frames;
+    bool aligned = true;
+    for (unsigned int n = 0; n + batch <= symbols.size(); n += batch)
+        {
+            decoded.clear();
+            aligned = aligner.get_bits(&symbols[n], batch, decoded);
+            detector.push_bits(decoded.data(), decoded.size(), frames);
+        }
+    EXPECT_FALSE(aligned);
+    ASSERT_EQ(1u, frames.size());
+    EXPECT_TRUE(frames[0].second == msg);
+}
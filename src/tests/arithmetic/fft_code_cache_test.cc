@@ -0,0 +1,65 @@
+/*!
+ * \file fft_code_cache_test.cc
+ * \brief  This file implements tests for the shared cache of FFT'd local codes.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <complex>
+#include "fft_code_cache.h"
+#include "gps_sdr_signal_processing.h"
+
+
+TEST(FftCodeCacheTest, SharedAcrossRequests)
+{
+    unsigned int fft_size = 2048;
+    long fs_in = 2048000;
+    int generated = 0;
+    Fft_Code_Cache::code_generator generator = [&generated, fs_in](std::complex<float>* dest)
+        {
+            gps_l1_ca_code_gen_complex_sampled(dest, 1, fs_in, 0);
+            generated++;
+        };
+
+    Fft_Code_Cache::instance().clear();
+    std::shared_ptr<const std::complex<float>> first = Fft_Code_Cache::instance().get("1C", 1, fs_in, fft_size, 0, generator);
+    std::shared_ptr<const std::complex<float>> second = Fft_Code_Cache::instance().get("1C", 1, fs_in, fft_size, 0, generator);
+    EXPECT_EQ(1, generated);
+    EXPECT_EQ(first.get(), second.get());
+
+    // A different key must produce a different spectrum
+    std::shared_ptr<const std::complex<float>> padded = Fft_Code_Cache::instance().get("1C", 1, fs_in, 2 * fft_size, fft_size, generator);
+    EXPECT_EQ(2, generated);
+    EXPECT_NE(first.get(), padded.get());
+    EXPECT_EQ(2u, Fft_Code_Cache::instance().size());
+
+    // Spectra handed out survive a clear
+    Fft_Code_Cache::instance().clear();
+    EXPECT_EQ(0u, Fft_Code_Cache::instance().size());
+    EXPECT_EQ(2, first.use_count());
+    EXPECT_NE(0.0, std::abs(first.get()[0]) + std::abs(first.get()[1]));
+}
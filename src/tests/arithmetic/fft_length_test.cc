@@ -29,8 +29,10 @@
  * -------------------------------------------------------------------------
  */
 
+#include <cmath>
 #include <ctime>
 #include <gnuradio/fft/fft.h>
+#include "fft_planner.h"
 
 
 DEFINE_int32(fft_iterations_test, 1000, "Number of averaged iterations in FFT length timing test");
@@ -64,3 +66,85 @@ TEST(FFT_Length_Test, MeasureExecutionTime)
                 }
     );
 }
+
+
+TEST(FFT_Length_Test, FastLengthSelection)
+{
+    EXPECT_EQ(4000u, Fft_Planner::fast_size(4000));
+    EXPECT_EQ(8192u, Fft_Planner::fast_size(8184));   // 8184 = 2^3 * 3 * 11 * 31
+    EXPECT_EQ(16384u, Fft_Planner::fast_size(16368));
+    EXPECT_EQ(2048u, Fft_Planner::fast_size(2046));   // 2046 = 2 * 3 * 11 * 31
+    EXPECT_EQ(2058u, Fft_Planner::fast_size(2049));   // 2058 = 2 * 3 * 7^3
+    EXPECT_TRUE(Fft_Planner::is_fast_size(Fft_Planner::fast_size(10230)));
+    EXPECT_FALSE(Fft_Planner::is_fast_size(1023));
+
+    // Time the original lengths against their fast zero-padded counterparts
+    unsigned int odd_sizes [4] = { 2046, 8184, 10230, 16368 };
+    for(int i = 0; i < 4; i++)
+        {
+            unsigned int sizes [2] = { odd_sizes[i], Fft_Planner::fast_size(odd_sizes[i]) };
+            for(int j = 0; j < 2; j++)
+                {
+                    struct timeval tv;
+                    std::shared_ptr<gr::fft::fft_complex> d_fft = Fft_Planner::instance().acquire(sizes[j], true);
+                    std::fill_n( d_fft->get_inbuf(), sizes[j], gr_complex( 0.0, 0.0 ) );
+                    gettimeofday(&tv, NULL);
+                    long long int begin = tv.tv_sec * 1000000 + tv.tv_usec;
+                    for(int k = 0; k < FLAGS_fft_iterations_test; k++)
+                        {
+                            d_fft->execute();
+                        }
+                    gettimeofday(&tv, NULL);
+                    long long int end = tv.tv_sec * 1000000 + tv.tv_usec;
+                    std::cout << "FFT execution time for length=" << sizes[j] << " : "
+                              << static_cast<double>(end - begin) / (1000000.0 * static_cast<double>(FLAGS_fft_iterations_test))
+                              << " [s]" << std::endl;
+                }
+        }
+}
+
+
+TEST(FFT_Length_Test, PlanReuse)
+{
+    gr::fft::fft_complex* first_plan;
+    size_t pooled = Fft_Planner::instance().pooled();
+    {
+        std::shared_ptr<gr::fft::fft_complex> fft = Fft_Planner::instance().acquire(4000, true);
+        first_plan = fft.get();
+    }
+    EXPECT_EQ(pooled + 1, Fft_Planner::instance().pooled());
+
+    // The released object is handed out again instead of planning a new one
+    std::shared_ptr<gr::fft::fft_complex> fft = Fft_Planner::instance().acquire(4000, true);
+    EXPECT_EQ(first_plan, fft.get());
+    std::shared_ptr<gr::fft::fft_complex> other = Fft_Planner::instance().acquire(4000, true);
+    EXPECT_NE(first_plan, other.get());
+}
+
+
+TEST(FFT_Length_Test, MultiThreadedLargePlans)
+{
+    Fft_Planner::instance().set_threading(4, 65536);
+    EXPECT_EQ(1u, Fft_Planner::instance().threads(16368));
+    EXPECT_EQ(4u, Fft_Planner::instance().threads(204600));
+
+    // A threaded plan gives the same transform as a single-threaded one
+    const unsigned int n = 65536;
+    std::shared_ptr<gr::fft::fft_complex> threaded = Fft_Planner::instance().acquire(n, true);
+    gr::fft::fft_complex single(n, true, 1);
+    for (unsigned int i = 0; i < n; i++)
+        {
+            threaded->get_inbuf()[i] = gr_complex(std::cos(0.001 * i), std::sin(0.003 * i));
+            single.get_inbuf()[i] = threaded->get_inbuf()[i];
+        }
+    threaded->execute();
+    single.execute();
+    for (unsigned int i = 0; i < n; i += 97)
+        {
+            EXPECT_NEAR(single.get_outbuf()[i].real(), threaded->get_outbuf()[i].real(), 0.05);
+            EXPECT_NEAR(single.get_outbuf()[i].imag(), threaded->get_outbuf()[i].imag(), 0.05);
+        }
+
+    Fft_Planner::instance().set_threading(1, 0);
+    EXPECT_EQ(1u, Fft_Planner::instance().threads(204600));
+}
@@ -0,0 +1,177 @@
+/*!
+ * \file fixed_point_fft_test.cc
+ * \brief  This file implements tests for the 16-bit block floating point FFT
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <gnuradio/fft/fft.h>
+#include "fixed_point_fft.h"
+
+
+TEST(Fixed_Point_FFT_Test, MatchesFloatingPointFFT)
+{
+    unsigned int fft_size = 2048;
+    std::vector<std::complex<int16_t>> data(fft_size);
+    gr::fft::fft_complex* fft = new gr::fft::fft_complex(fft_size, true);
+
+    // Two tones plus a little deterministic noise, well inside 16 bits
+    for (unsigned int i = 0; i < fft_size; i++)
+        {
+            double phase1 = 2.0 * M_PI * 37.0 * i / fft_size;
+            double phase2 = 2.0 * M_PI * 411.3 * i / fft_size;
+            double re = 6000.0 * cos(phase1) + 2000.0 * cos(phase2) + static_cast<double>((i * 7919) % 201) - 100.0;
+            double im = 6000.0 * sin(phase1) - 2000.0 * sin(phase2);
+            data[i] = std::complex<int16_t>(static_cast<int16_t>(round(re)), static_cast<int16_t>(round(im)));
+            fft->get_inbuf()[i] = gr_complex(data[i].real(), data[i].imag());
+        }
+    fft->execute();
+
+    Fixed_Point_Fft fixed_fft(fft_size, true);
+    int exponent = fixed_fft.execute(data.data());
+
+    double error_power = 0.0;
+    double signal_power = 0.0;
+    for (unsigned int i = 0; i < fft_size; i++)
+        {
+            std::complex<double> expected(fft->get_outbuf()[i].real(), fft->get_outbuf()[i].imag());
+            std::complex<double> obtained(ldexp(data[i].real(), exponent), ldexp(data[i].imag(), exponent));
+            error_power += std::norm(expected - obtained);
+            signal_power += std::norm(expected);
+        }
+    delete fft;
+
+    // The 16-bit pipeline keeps well above the dynamic range needed by acquisition
+    EXPECT_GT(10.0 * log10(signal_power / error_power), 40.0);
+}
+
+
+TEST(Fixed_Point_FFT_Test, CircularCorrelationPeak)
+{
+    unsigned int fft_size = 1024;
+    unsigned int delay = 300;
+    std::vector<std::complex<int16_t>> code(fft_size);
+    std::vector<std::complex<int16_t>> signal(fft_size);
+    std::vector<uint32_t> magnitude(fft_size);
+
+    // Pseudo-random +-1 sequence and a delayed copy of it
+    unsigned int lfsr = 0xACE1u;
+    for (unsigned int i = 0; i < fft_size; i++)
+        {
+            lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+            code[i] = std::complex<int16_t>((lfsr & 1u) ? 8000 : -8000, 0);
+        }
+    for (unsigned int i = 0; i < fft_size; i++)
+        {
+            signal[(i + delay) % fft_size] = code[i];
+        }
+
+    Fixed_Point_Fft fft(fft_size, true);
+    Fixed_Point_Fft ifft(fft_size, false);
+    fft.execute(code.data());
+    fft.execute(signal.data());
+
+    // Normalize the conjugated code spectrum to Q15
+    int max_component = Fixed_Point_Fft::max_abs_component(code.data(), fft_size);
+    for (unsigned int i = 0; i < fft_size; i++)
+        {
+            code[i] = std::complex<int16_t>(code[i].real() * 16384 / max_component, -code[i].imag() * 16384 / max_component);
+        }
+
+    Fixed_Point_Fft::multiply_q15(signal.data(), signal.data(), code.data(), fft_size);
+    ifft.execute(signal.data());
+    Fixed_Point_Fft::magnitude_squared(magnitude.data(), signal.data(), fft_size);
+
+    EXPECT_EQ(delay, Fixed_Point_Fft::index_max(magnitude.data(), fft_size));
+}
+
+
+TEST(Fixed_Point_FFT_Test, PaddedCircularCorrelationPeak)
+{
+    // Circular correlation of a length that is not a power of two, as
+    // pcps_fixed_point_acquisition_sc computes it: the signal is repeated
+    // and the code zero-padded up to a power of two of at least 2 N - 1
+    unsigned int length = 1000;
+    unsigned int delay = 937;
+    unsigned int fft_size = Fixed_Point_Fft::next_power_of_two(2 * length - 1);
+    ASSERT_EQ(2048u, fft_size);
+    std::vector<std::complex<int16_t>> code(fft_size, std::complex<int16_t>(0, 0));
+    std::vector<std::complex<int16_t>> signal(fft_size);
+    std::vector<uint32_t> magnitude(fft_size);
+
+    unsigned int lfsr = 0xACE1u;
+    for (unsigned int i = 0; i < length; i++)
+        {
+            lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+            code[i] = std::complex<int16_t>((lfsr & 1u) ? 8000 : -8000, 0);
+        }
+    for (unsigned int i = 0; i < length; i++)
+        {
+            signal[(i + delay) % length] = code[i];
+        }
+    for (unsigned int i = length; i < fft_size; i++)
+        {
+            signal[i] = signal[i % length];
+        }
+
+    Fixed_Point_Fft fft(fft_size, true);
+    Fixed_Point_Fft ifft(fft_size, false);
+    fft.execute(code.data());
+    fft.execute(signal.data());
+    int max_component = Fixed_Point_Fft::max_abs_component(code.data(), fft_size);
+    for (unsigned int i = 0; i < fft_size; i++)
+        {
+            code[i] = std::complex<int16_t>(code[i].real() * 16384 / max_component, -code[i].imag() * 16384 / max_component);
+        }
+    Fixed_Point_Fft::multiply_q15(signal.data(), signal.data(), code.data(), fft_size);
+    ifft.execute(signal.data());
+    Fixed_Point_Fft::magnitude_squared(magnitude.data(), signal.data(), fft_size);
+
+    // Only the first length outputs are circular correlations
+    EXPECT_EQ(delay, Fixed_Point_Fft::index_max(magnitude.data(), length));
+}
+
+
+TEST(Fixed_Point_FFT_Test, Q15Multiply)
+{
+    std::complex<int16_t> a[3] = { std::complex<int16_t>(16384, 0), std::complex<int16_t>(-32768, -32768), std::complex<int16_t>(1000, -2000) };
+    std::complex<int16_t> b[3] = { std::complex<int16_t>(16384, 0), std::complex<int16_t>(32767, 32767), std::complex<int16_t>(0, 32767) };
+    std::complex<int16_t> result[3];
+    Fixed_Point_Fft::multiply_q15(result, a, b, 3);
+
+    EXPECT_EQ(std::complex<int16_t>(8192, 0), result[0]);
+    EXPECT_EQ(0, result[1].real());
+    EXPECT_EQ(-32768, result[1].imag());   // Saturated
+    EXPECT_EQ(std::complex<int16_t>(2000, 1000), result[2]);
+    EXPECT_TRUE(Fixed_Point_Fft::is_power_of_two(4096));
+    EXPECT_FALSE(Fixed_Point_Fft::is_power_of_two(4000));
+    EXPECT_EQ(4096u, Fixed_Point_Fft::next_power_of_two(4000));
+    EXPECT_EQ(4096u, Fixed_Point_Fft::next_power_of_two(4096));
+    EXPECT_EQ(8192u, Fixed_Point_Fft::next_power_of_two(7999));
+}
@@ -0,0 +1,225 @@
+/*!
+ * \file galileo_page_deinterleaver_test.cc
+ * \brief Tests of the deinterleaving and decoding of Galileo I/NAV and F/NAV pages
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <sys/time.h>
+#include <gtest/gtest.h>
+#include "convolutional.h"
+#include "galileo_page_deinterleaver.h"
+#include "viterbi_decoder.h"
+#include "Galileo_E1.h"
+#include "Galileo_E5a.h"
+
+
+namespace
+{
+int deinterleaver_test_g[2] = { 121, 91 };
+
+// Page symbols as received: the encoded data bits and the tail (+1 for a 1),
+// with the G2 symbols inverted, plus uniform noise, interleaved by rows
+std::vector<double> deinterleaver_test_page(int rows, int cols, double noise_amplitude, std::vector<int>& bits)
+{
+    const int n_symbols = rows * cols;
+    bits.assign(n_symbols / 2, 0);
+    for (int t = 0; t < n_symbols / 2 - 6; t++)
+        {
+            bits[t] = rand() % 2;
+        }
+    std::vector<double> symbols(n_symbols);
+    int state = 0;
+    int next_state[1];
+    for (int t = 0; t < n_symbols / 2; t++)
+        {
+            int out = nsc_enc_bit(next_state, bits[t], state, deinterleaver_test_g, 7, 2);
+            state = next_state[0];
+            symbols[2 * t] = (out & 2) ? 1.0 : -1.0;
+            symbols[2 * t + 1] = (out & 1) ? -1.0 : 1.0;
+        }
+    std::vector<double> page(n_symbols);
+    for (int r = 0; r < rows; r++)
+        {
+            for (int c = 0; c < cols; c++)
+                {
+                    double noise = noise_amplitude * (2.0 * static_cast<double>(rand()) / static_cast<double>(RAND_MAX) - 1.0);
+                    page[r * cols + c] = symbols[c * rows + r] + noise;
+                }
+        }
+    return page;
+}
+
+// Deinterleaving and sign correction as the telemetry decoders used to do them
+void deinterleaver_test_reference(int rows, int cols, const double* in, double* out)
+{
+    for (int r = 0; r < rows; r++)
+        {
+            for (int c = 0; c < cols; c++)
+                {
+                    out[c * rows + r] = in[r * cols + c];
+                }
+        }
+    for (int i = 0; i < rows * cols; i++)
+        {
+            if ((i + 1) % 2 == 0)
+                {
+                    out[i] = -out[i];
+                }
+        }
+}
+}
+
+
+TEST(GalileoPageDeinterleaverTest, MatchesTheScalarDeinterleaver)
+{
+    const int rows = GALILEO_FNAV_INTERLEAVER_ROWS;
+    const int cols = GALILEO_FNAV_INTERLEAVER_COLS;
+    Galileo_Page_Deinterleaver deinterleaver(rows, cols);
+    ASSERT_EQ(rows * cols, deinterleaver.size());
+
+    std::vector<double> page(rows * cols);
+    std::vector<float> page_float(rows * cols);
+    std::vector<int8_t> page_int8(rows * cols);
+    for (int k = 0; k < rows * cols; k++)
+        {
+            page[k] = static_cast<double>(k % 256 - 128);
+            page_float[k] = static_cast<float>(page[k]);
+            page_int8[k] = static_cast<int8_t>(k % 256 - 128);
+        }
+    std::vector<double> reference(rows * cols);
+    deinterleaver_test_reference(rows, cols, &page[0], &reference[0]);
+
+    std::vector<float> out(rows * cols);
+    std::vector<float> out_float(rows * cols);
+    std::vector<int8_t> out_int8(rows * cols);
+    deinterleaver.deinterleave(&page[0], &out[0]);
+    deinterleaver.deinterleave(&page_float[0], &out_float[0]);
+    deinterleaver.deinterleave(&page_int8[0], &out_int8[0]);
+    for (int k = 0; k < rows * cols; k++)
+        {
+            ASSERT_EQ(static_cast<float>(reference[k]), out[k]) << "symbol " << k;
+            ASSERT_EQ(static_cast<float>(reference[k]), out_float[k]) << "symbol " << k;
+            // -(-128) saturates
+            ASSERT_EQ(reference[k] > 127.0 ? 127 : static_cast<int>(reference[k]), out_int8[k]) << "symbol " << k;
+        }
+}
+
+
+TEST(GalileoPageDeinterleaverTest, SoftSymbolTypesDecodeTheSamePages)
+{
+    const int rows = GALILEO_INAV_INTERLEAVER_ROWS;
+    const int cols = GALILEO_INAV_INTERLEAVER_COLS;
+    const int n_data_bits = rows * cols / 2 - 6;
+    Galileo_Page_Deinterleaver deinterleaver(rows, cols);
+    Viterbi_Decoder decoder(deinterleaver_test_g, 7, 2);
+    std::vector<int> bits;
+    std::vector<double> reference(rows * cols);
+    std::vector<float> symbols(rows * cols);
+    std::vector<int8_t> symbols_int8(rows * cols);
+    std::vector<int8_t> page_int8(rows * cols);
+    std::vector<int> decoded_reference(n_data_bits);
+    std::vector<int> decoded(n_data_bits);
+    std::vector<int> decoded_int8(n_data_bits);
+    for (int p = 0; p < 100; p++)
+        {
+            std::vector<double> page = deinterleaver_test_page(rows, cols, 0.5 + 0.01 * p, bits);
+            deinterleaver_test_reference(rows, cols, &page[0], &reference[0]);
+            decoder.decode_block(&reference[0], &decoded_reference[0], n_data_bits);
+
+            deinterleaver.deinterleave(&page[0], &symbols[0]);
+            decoder.decode_block(&symbols[0], &decoded[0], n_data_bits);
+
+            // 8-bit soft symbols, with a full scale of twice the symbol amplitude
+            for (int k = 0; k < rows * cols; k++)
+                {
+                    page_int8[k] = static_cast<int8_t>(page[k] * 63.0);
+                }
+            deinterleaver.deinterleave(&page_int8[0], &symbols_int8[0]);
+            decoder.decode_block(&symbols_int8[0], &decoded_int8[0], n_data_bits);
+
+            for (int t = 0; t < n_data_bits; t++)
+                {
+                    ASSERT_EQ(decoded_reference[t], decoded[t]) << "page " << p << ", bit " << t;
+                    if (p < 50)
+                        {
+                            ASSERT_EQ(bits[t], decoded[t]) << "page " << p << ", bit " << t;
+                            ASSERT_EQ(bits[t], decoded_int8[t]) << "page " << p << ", bit " << t;
+                        }
+                }
+        }
+}
+
+
+TEST(GalileoPageDeinterleaverTest, PageDecodingTime)
+{
+    const int rows = GALILEO_FNAV_INTERLEAVER_ROWS;
+    const int cols = GALILEO_FNAV_INTERLEAVER_COLS;
+    const int n_data_bits = rows * cols / 2 - 6;
+    const int n_pages = 2000;
+    Galileo_Page_Deinterleaver deinterleaver(rows, cols);
+    Viterbi_Decoder decoder(deinterleaver_test_g, 7, 2);
+    std::vector<int> bits;
+    std::vector<double> page = deinterleaver_test_page(rows, cols, 0.8, bits);
+    std::vector<double> reference(rows * cols);
+    std::vector<float> symbols(rows * cols);
+    std::vector<int> decoded_reference(n_data_bits);
+    std::vector<int> decoded(n_data_bits);
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    long long int begin = tv.tv_sec * 1000000 + tv.tv_usec;
+    for (int p = 0; p < n_pages; p++)
+        {
+            deinterleaver_test_reference(rows, cols, &page[0], &reference[0]);
+            decoder.decode_block(&reference[0], &decoded_reference[0], n_data_bits);
+        }
+    gettimeofday(&tv, NULL);
+    long long int end = tv.tv_sec * 1000000 + tv.tv_usec;
+    std::cout << "Decoding of " << n_pages << " Galileo F/NAV pages of double symbols finished in "
+              << (end - begin) << " microseconds" << std::endl;
+
+    gettimeofday(&tv, NULL);
+    begin = tv.tv_sec * 1000000 + tv.tv_usec;
+    for (int p = 0; p < n_pages; p++)
+        {
+            deinterleaver.deinterleave(&page[0], &symbols[0]);
+            decoder.decode_block(&symbols[0], &decoded[0], n_data_bits);
+        }
+    gettimeofday(&tv, NULL);
+    end = tv.tv_sec * 1000000 + tv.tv_usec;
+    std::cout << "Decoding of " << n_pages << " Galileo F/NAV pages through Galileo_Page_Deinterleaver finished in "
+              << (end - begin) << " microseconds" << std::endl;
+
+    for (int t = 0; t < n_data_bits; t++)
+        {
+            ASSERT_EQ(decoded_reference[t], decoded[t]);
+        }
+}
@@ -0,0 +1,100 @@
+/*!
+ * \file gnss_code_bank_test.cc
+ * \brief  Tests for the primary code tables and the sampled code bank
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <complex>
+#include "gnss_code_bank.h"
+#include "gnss_primary_codes.h"
+#include "gps_sdr_signal_processing.h"
+
+
+TEST(GnssPrimaryCodesTest, FirstChips)
+{
+    // The first 10 chips of PRN 1 are 1440 (octal) in IS-GPS-200
+    const int gps_prn1[10] = {1, 1, -1, -1, 1, -1, -1, -1, -1, -1};
+    const Gnss_Primary_Code& gps_code = gnss_primary_code(GPS_L1_CA_PRIMARY_CODE, 1);
+    ASSERT_EQ(1023u, gps_code.length());
+    for (unsigned int i = 0; i < 10; i++)
+        {
+            EXPECT_EQ(gps_prn1[i], gps_code.chip(i));
+        }
+
+    // E1-B PRN 1 starts with F5 (hexadecimal)
+    const int galileo_prn1[8] = {-1, -1, -1, -1, 1, -1, 1, -1};
+    const Gnss_Primary_Code& galileo_code = gnss_primary_code(GALILEO_E1_B_PRIMARY_CODE, 1);
+    ASSERT_EQ(4092u, galileo_code.length());
+    for (unsigned int i = 0; i < 8; i++)
+        {
+            EXPECT_EQ(galileo_prn1[i], galileo_code.chip(i));
+        }
+
+    EXPECT_EQ(1023u, gnss_primary_code(GPS_L1_CA_PRIMARY_CODE, 138).length());
+    EXPECT_EQ(0u, gnss_primary_code(GPS_L1_CA_PRIMARY_CODE, 0).length());
+    EXPECT_EQ(0u, gnss_primary_code(GALILEO_E5A_Q_PRIMARY_CODE, 51).length());
+}
+
+
+TEST(GnssCodeBankTest, SharedAcrossRequests)
+{
+    long fs_in = 4000000;
+    unsigned int samples = 4000;
+    int generated = 0;
+    Gnss_Code_Bank::code_generator generator = [&generated, fs_in](std::complex<float>* dest)
+        {
+            gps_l1_ca_code_gen_complex_sampled(dest, 1, fs_in, 0);
+            generated++;
+        };
+
+    Gnss_Code_Bank::instance().clear();
+    std::shared_ptr<const std::complex<float>> first = Gnss_Code_Bank::instance().get("1C", 1, fs_in, 0, samples, generator);
+    std::complex<float> copied[4000];
+    Gnss_Code_Bank::instance().copy(copied, "1C", 1, fs_in, 0, samples, generator);
+    EXPECT_EQ(1, generated);
+    EXPECT_EQ(1u, Gnss_Code_Bank::instance().size());
+
+    std::complex<float> expected[4000];
+    gps_l1_ca_code_gen_complex_sampled(expected, 1, fs_in, 0);
+    for (unsigned int i = 0; i < samples; i++)
+        {
+            ASSERT_EQ(expected[i], first.get()[i]);
+            ASSERT_EQ(expected[i], copied[i]);
+        }
+
+    // Another PRN is another code
+    Gnss_Code_Bank::instance().get("1C", 2, fs_in, 0, samples, generator);
+    EXPECT_EQ(2, generated);
+    EXPECT_EQ(2u, Gnss_Code_Bank::instance().size());
+
+    // Codes handed out survive a clear
+    Gnss_Code_Bank::instance().clear();
+    EXPECT_EQ(0u, Gnss_Code_Bank::instance().size());
+    EXPECT_EQ(1, first.use_count());
+    EXPECT_EQ(expected[0], first.get()[0]);
+}
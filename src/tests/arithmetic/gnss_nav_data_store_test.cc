@@ -0,0 +1,199 @@
+/*!
+ * \file gnss_nav_data_store_test.cc
+ * \brief Tests of the snapshots of the navigation data store.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <memory>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "gnss_nav_data_store.h"
+
+
+TEST(GnssNavDataStoreTest, SnapshotsAreNotModified)
+{
+    Gnss_Nav_Data_Store store;
+    std::shared_ptr<const Gnss_Nav_Data> empty = store.snapshot();
+    EXPECT_EQ(0u, empty->version);
+    EXPECT_TRUE(empty->gps_ephemeris_map.empty());
+
+    Gps_Ephemeris eph;
+    eph.i_satellite_PRN = 5;
+    eph.d_Toe = 7200.0;
+    store.update(eph);
+    Galileo_Ephemeris gal_eph;
+    gal_eph.i_satellite_PRN = 11;
+    store.update(gal_eph);
+    Gps_Utc_Model utc;
+    utc.d_A0 = 1e-9;
+    store.update(utc);
+
+    std::shared_ptr<const Gnss_Nav_Data> nav = store.snapshot();
+    EXPECT_EQ(3u, nav->version);
+    EXPECT_EQ(3u, store.version());
+    ASSERT_EQ(1u, nav->gps_ephemeris_map.size());
+    EXPECT_DOUBLE_EQ(7200.0, nav->gps_ephemeris_map.at(5).d_Toe);
+    EXPECT_EQ(1u, nav->gps_ephemeris_version.at(5));
+    EXPECT_EQ(2u, nav->galileo_ephemeris_version.at(11));
+    EXPECT_DOUBLE_EQ(1e-9, nav->gps_utc_model.d_A0);
+
+    // readers keep the data of their own snapshot
+    eph.d_Toe = 14400.0;
+    store.update(eph);
+    EXPECT_DOUBLE_EQ(7200.0, nav->gps_ephemeris_map.at(5).d_Toe);
+    EXPECT_DOUBLE_EQ(14400.0, store.snapshot()->gps_ephemeris_map.at(5).d_Toe);
+    EXPECT_EQ(4u, store.snapshot()->gps_ephemeris_version.at(5));
+    EXPECT_TRUE(empty->gps_ephemeris_map.empty());
+
+    store.clear();
+    EXPECT_TRUE(store.snapshot()->gps_ephemeris_map.empty());
+    EXPECT_GT(store.version(), 4u);
+}
+
+
+TEST(GnssNavDataStoreTest, UpdateFromTelemetryMessage)
+{
+    Gnss_Nav_Data_Store store;
+    std::shared_ptr<Galileo_Iono> iono = std::make_shared<Galileo_Iono>();
+    iono->ai0_5 = 42.0;
+    EXPECT_TRUE(store.update(boost::any(iono)));
+    EXPECT_DOUBLE_EQ(42.0, store.snapshot()->galileo_iono.ai0_5);
+    EXPECT_FALSE(store.update(boost::any(std::make_shared<int>(1))));
+    EXPECT_EQ(1u, store.version());
+}
+
+
+TEST(GnssNavDataStoreTest, PooledTelemetryPayloads)
+{
+    Gnss_Nav_Data_Store store;
+    Gnss_Telemetry_Pool<Gps_Ephemeris> pool;
+    Gps_Ephemeris eph;
+    eph.i_satellite_PRN = 3;
+    std::shared_ptr<const Gnss_Telemetry_Payload> payload = pool.make(eph);
+    EXPECT_EQ(Gnss_Telemetry_Payload::GPS_EPHEMERIS, payload->type());
+    EXPECT_TRUE(store.update(boost::any(payload)));
+    EXPECT_EQ(1u, store.snapshot()->gps_ephemeris_map.count(3));
+
+    // still held by a message: a second payload is made
+    eph.i_satellite_PRN = 4;
+    std::shared_ptr<const Gnss_Telemetry_Payload> second = pool.make(eph);
+    EXPECT_NE(payload.get(), second.get());
+    EXPECT_EQ(3, payload->data<Gps_Ephemeris>().i_satellite_PRN);
+
+    // released: the first one is reused
+    const Gnss_Telemetry_Payload * first = payload.get();
+    payload.reset();
+    eph.i_satellite_PRN = 5;
+    payload = pool.make(eph);
+    EXPECT_EQ(first, payload.get());
+    EXPECT_EQ(5, payload->data<Gps_Ephemeris>().i_satellite_PRN);
+    EXPECT_EQ(2u, pool.size());
+    EXPECT_TRUE(store.update(*payload));
+    EXPECT_EQ(2u, store.version());
+}
+
+
+TEST(GnssNavDataStoreTest, UnchangedIssuesAreNotPublished)
+{
+    Gnss_Nav_Data_Store store;
+    Gps_Ephemeris eph;
+    eph.i_satellite_PRN = 5;
+    eph.d_IODC = 12.0;
+    eph.d_IODE_SF2 = 12.0;
+    eph.d_IODE_SF3 = 12.0;
+    eph.d_Toe = 7200.0;
+    eph.d_TOW = 6000.0;
+    EXPECT_TRUE(store.update(eph));
+
+    // broadcast again, and decoded by a second channel: same issue
+    eph.d_TOW = 6030.0;
+    EXPECT_FALSE(store.update(eph));
+    EXPECT_FALSE(store.update(eph));
+    EXPECT_EQ(1u, store.version());
+    EXPECT_EQ(2u, store.unchanged_updates());
+    EXPECT_DOUBLE_EQ(6000.0, store.snapshot()->gps_ephemeris_map.at(5).d_TOW);
+
+    // a new upload changes the IODE
+    eph.d_IODE_SF2 = 13.0;
+    eph.d_IODE_SF3 = 13.0;
+    EXPECT_TRUE(store.update(eph));
+    EXPECT_EQ(2u, store.version());
+
+    Gps_Iono iono;
+    iono.valid = true;
+    iono.d_alpha0 = 1e-8;
+    EXPECT_TRUE(store.update(iono));
+    EXPECT_FALSE(store.update(iono));
+
+    // the time of reception is not part of a Galileo iono issue
+    Galileo_Iono gal_iono;
+    gal_iono.ai0_5 = 42.0;
+    gal_iono.TOW_5 = 100.0;
+    EXPECT_TRUE(store.update(gal_iono));
+    gal_iono.TOW_5 = 130.0;
+    EXPECT_FALSE(store.update(gal_iono));
+    EXPECT_TRUE(store.update(boost::any(std::make_shared<Galileo_Iono>(gal_iono))));
+    EXPECT_EQ(4u, store.version());
+}
+
+
+TEST(GnssNavDataStoreTest, ConcurrentUpdatesAndReads)
+{
+    Gnss_Nav_Data_Store store;
+    const int n_decoders = 4;
+    const int n_updates = 200;
+    std::vector<std::thread> decoders;
+    for (int d = 0; d < n_decoders; d++)
+        {
+            decoders.push_back(std::thread([&store, d]()
+                    {
+                        Gps_Ephemeris eph;
+                        for (int i = 0; i < n_updates; i++)
+                            {
+                                eph.i_satellite_PRN = d * 8 + i % 8 + 1;
+                                eph.d_Toe = 16.0 * i;  // a new issue each time
+                                store.update(eph);
+                            }
+                    }));
+        }
+    unsigned long long last_version = 0;
+    for (int i = 0; i < 1000; i++)
+        {
+            std::shared_ptr<const Gnss_Nav_Data> nav = store.snapshot();
+            EXPECT_GE(nav->version, last_version);
+            EXPECT_LE(nav->gps_ephemeris_map.size(), nav->version);
+            last_version = nav->version;
+        }
+    for (unsigned int d = 0; d < decoders.size(); d++)
+        {
+            decoders[d].join();
+        }
+    std::shared_ptr<const Gnss_Nav_Data> nav = store.snapshot();
+    EXPECT_EQ(static_cast<unsigned long long>(n_decoders * n_updates), nav->version);
+    EXPECT_EQ(static_cast<unsigned int>(n_decoders * 8), nav->gps_ephemeris_map.size());
+}
@@ -0,0 +1,202 @@
+/*!
+ * \file gnss_receiver_state_test.cc
+ * \brief Tests of the receiver state saved for the warm starts.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <sys/time.h>
+#include <gtest/gtest.h>
+#include "gnss_receiver_state.h"
+
+
+TEST(GnssReceiverStateTest, SaveAndRestore)
+{
+    // an ephemeris of now and one of two weeks ago
+    const double gps_time_s = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count() - 315964800.0 + 17.0;
+    const int week = static_cast<int>(gps_time_s / 604800.0);
+    Gps_Ephemeris current;
+    current.i_satellite_PRN = 3;
+    current.i_GPS_week = week % 1024;
+    current.d_Toe = gps_time_s - week * 604800.0;
+    Gps_Ephemeris old = current;
+    old.i_satellite_PRN = 9;
+    old.i_GPS_week = (week - 2) % 1024;
+
+    // the Galileo week starts 1024 GPS weeks later
+    Galileo_Ephemeris galileo;
+    galileo.i_satellite_PRN = 11;
+    galileo.WN_5 = week - 1024;
+    galileo.t0e_1 = current.d_Toe;
+
+    Gnss_Nav_Data_Store store;
+    store.update(current);
+    store.update(old);
+    store.update(galileo);
+    store.set_rx_position(41.27, 1.99, 100.0, true, 1000.0);
+
+    Gnss_Receiver_State state;
+    state.capture(store);
+    EXPECT_EQ(2, state.gps_ephemeris_map.size());
+    EXPECT_TRUE(state.has_position);
+
+    const std::string file_name = "./gnss_receiver_state_test.xml";
+    ASSERT_TRUE(state.save_xml(file_name));
+    Gnss_Receiver_State loaded;
+    ASSERT_TRUE(loaded.load_xml(file_name));
+    std::remove(file_name.c_str());
+    EXPECT_EQ(2, loaded.gps_ephemeris_map.size());
+    EXPECT_DOUBLE_EQ(state.saved_at_s, loaded.saved_at_s);
+
+    Gnss_Nav_Data_Store restored;
+    EXPECT_EQ(2, loaded.restore(restored, 4.0 * 3600.0));
+    EXPECT_EQ(1, restored.snapshot()->gps_ephemeris_map.count(3));
+    EXPECT_EQ(0, restored.snapshot()->gps_ephemeris_map.count(9));
+    EXPECT_EQ(1, restored.snapshot()->galileo_ephemeris_map.count(11));
+    Gnss_Rx_Position position = restored.rx_position();
+    EXPECT_NE(0, position.version);
+    EXPECT_FALSE(position.has_time);
+    EXPECT_DOUBLE_EQ(41.27, position.latitude_d);
+}
+
+
+TEST(GnssReceiverStateTest, MissingFile)
+{
+    Gnss_Receiver_State state;
+    EXPECT_FALSE(state.load_xml("./no_such_receiver_state.xml"));
+    EXPECT_FALSE(state.has_position);
+}
+
+
+TEST(GnssReceiverStateTest, Checkpoint)
+{
+    // an ephemeris of two weeks ago is restored from a checkpoint of that time
+    Gps_Ephemeris old;
+    old.i_satellite_PRN = 9;
+    old.i_GPS_week = 900;
+    old.d_Toe = 7200.0;
+    Gnss_Nav_Data_Store store;
+    store.update(old);
+    store.set_rx_position(41.27, 1.99, 100.0, true, 7300.0);
+
+    Gnss_Receiver_State state;
+    state.capture(store);
+    state.signal_time_s = 600.25;
+    Gnss_Receiver_State_Satellite satellite;
+    satellite.system = 'E';
+    satellite.prn = 12;
+    satellite.doppler_hz = -1500.0;
+    satellite.time_s = 600.0;
+    state.satellites.push_back(satellite);
+
+    const std::string file_name = "./gnss_receiver_checkpoint_test.xml";
+    const std::string index_file_name = "./gnss_receiver_checkpoint_test.txt";
+    std::remove(index_file_name.c_str());
+    ASSERT_TRUE(state.save_xml(file_name));
+    ASSERT_TRUE(Gnss_Receiver_State::add_checkpoint(index_file_name, 300.0, "./earlier checkpoint.xml"));
+    ASSERT_TRUE(Gnss_Receiver_State::add_checkpoint(index_file_name, state.signal_time_s, file_name));
+    std::string found;
+    EXPECT_FALSE(Gnss_Receiver_State::find_checkpoint(index_file_name, 100.0, found));
+    ASSERT_TRUE(Gnss_Receiver_State::find_checkpoint(index_file_name, 450.0, found));
+    EXPECT_EQ("./earlier checkpoint.xml", found);
+    ASSERT_TRUE(Gnss_Receiver_State::find_checkpoint(index_file_name, 1e9, found));
+    EXPECT_EQ(file_name, found);
+    std::remove(index_file_name.c_str());
+
+    Gnss_Receiver_State loaded;
+    ASSERT_TRUE(loaded.load_xml(found));
+    std::remove(file_name.c_str());
+    EXPECT_DOUBLE_EQ(600.25, loaded.signal_time_s);
+    ASSERT_EQ(1u, loaded.satellites.size());
+    EXPECT_EQ('E', loaded.satellites[0].system);
+    EXPECT_EQ(12u, loaded.satellites[0].prn);
+    EXPECT_DOUBLE_EQ(-1500.0, loaded.satellites[0].doppler_hz);
+
+    Gnss_Nav_Data_Store restored;
+    EXPECT_EQ(1u, loaded.restore_checkpoint(restored));
+    EXPECT_EQ(1, restored.snapshot()->gps_ephemeris_map.count(9));
+    Gnss_Rx_Position position = restored.rx_position();
+    EXPECT_TRUE(position.has_time);
+    EXPECT_DOUBLE_EQ(7300.0, position.gps_tow_s);
+}
+
+
+TEST(GnssReceiverStateTest, BinaryFormat)
+{
+    Gnss_Nav_Data_Store store;
+    for (int prn = 1; prn <= 32; prn++)
+        {
+            Gps_Ephemeris eph;
+            eph.i_satellite_PRN = prn;
+            eph.i_GPS_week = 900;
+            eph.d_Toe = 7200.0;
+            eph.d_sqrt_A = 5153.7 + prn;
+            store.update(eph);
+        }
+    store.set_rx_position(41.27, 1.99, 100.0, true, 7300.0);
+    Gnss_Receiver_State state;
+    state.capture(store);
+    state.signal_time_s = 12.5;
+
+    const std::string xml_file_name = "./gnss_receiver_state_test_format.xml";
+    const std::string binary_file_name = "./gnss_receiver_state_test_format.bin";
+    ASSERT_TRUE(state.save_xml(xml_file_name));
+    ASSERT_TRUE(state.save_binary(binary_file_name));
+
+    // both formats are loaded by load()
+    Gnss_Receiver_State from_xml;
+    Gnss_Receiver_State from_binary;
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    long long int begin = tv.tv_sec * 1000000 + tv.tv_usec;
+    ASSERT_TRUE(from_xml.load(xml_file_name));
+    gettimeofday(&tv, NULL);
+    long long int middle = tv.tv_sec * 1000000 + tv.tv_usec;
+    ASSERT_TRUE(from_binary.load(binary_file_name));
+    gettimeofday(&tv, NULL);
+    long long int end = tv.tv_sec * 1000000 + tv.tv_usec;
+    std::cout << "Loaded 32 ephemeris in " << (middle - begin) << " microseconds from XML and in "
+              << (end - middle) << " microseconds from the binary file" << std::endl;
+
+    ASSERT_EQ(32u, from_binary.gps_ephemeris_map.size());
+    EXPECT_DOUBLE_EQ(5153.7 + 7, from_binary.gps_ephemeris_map[7].d_sqrt_A);
+    EXPECT_DOUBLE_EQ(from_xml.gps_ephemeris_map[7].d_sqrt_A, from_binary.gps_ephemeris_map[7].d_sqrt_A);
+    EXPECT_DOUBLE_EQ(state.saved_at_s, from_binary.saved_at_s);
+    EXPECT_DOUBLE_EQ(12.5, from_binary.signal_time_s);
+    EXPECT_TRUE(from_binary.has_position);
+    EXPECT_DOUBLE_EQ(41.27, from_binary.latitude_d);
+
+    // an XML file is not read as binary, and the reverse
+    Gnss_Receiver_State wrong;
+    EXPECT_FALSE(wrong.load_binary(xml_file_name));
+    EXPECT_FALSE(wrong.load_xml(binary_file_name));
+    std::remove(xml_file_name.c_str());
+    std::remove(binary_file_name.c_str());
+}
@@ -0,0 +1,160 @@
+/*!
+ * \file gnss_sample_capture_test.cc
+ * \brief Tests of the capture and replay of the samples of a signal source.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "gnss_sample_capture.h"
+
+
+namespace
+{
+void remove_capture(const std::string & filename)
+{
+    std::remove(filename.c_str());
+    std::remove((filename + ".annotations").c_str());
+}
+
+
+// correlation coefficient of the replayed samples with the captured ones
+double capture_round_trip(unsigned int bits, unsigned int chunk, unsigned int read_chunk)
+{
+    const std::string filename = "./gnss_sample_capture_test.dat";
+    std::mt19937 generator(bits);
+    std::normal_distribution<float> noise(0.0, 100.0);
+    std::vector<std::complex<float>> input(20001);
+    for (unsigned int i = 0; i < input.size(); i++)
+        {
+            input[i] = std::complex<float>(noise(generator), noise(generator));
+        }
+    Gnss_Sample_Capture_Writer writer(1 << 20, 2);
+    EXPECT_TRUE(writer.open(filename, sizeof(std::complex<float>), bits, 4e6));
+    for (unsigned int i = 0; i < input.size(); i += chunk)
+        {
+            writer.write(&input[i], std::min(chunk, static_cast<unsigned int>(input.size() - i)));
+        }
+    writer.close();
+    EXPECT_EQ(0u, writer.dropped_samples());
+
+    Gnss_Sample_Capture_Reader reader;
+    EXPECT_TRUE(reader.open(filename));
+    EXPECT_EQ(bits, reader.bits());
+    EXPECT_EQ(input.size(), reader.samples());
+    std::vector<std::complex<float>> output(input.size() + read_chunk);
+    unsigned int n = 0;
+    unsigned int r = 0;
+    while ((r = reader.read(&output[n], read_chunk)) > 0) n += r;
+    EXPECT_EQ(input.size(), n);
+    remove_capture(filename);
+
+    double cross = 0.0;
+    double power_in = 0.0;
+    double power_out = 0.0;
+    for (unsigned int i = 0; i < input.size(); i++)
+        {
+            cross += std::real(input[i] * std::conj(output[i]));
+            power_in += std::norm(input[i]);
+            power_out += std::norm(output[i]);
+        }
+    return cross / std::sqrt(power_in * power_out);
+}
+}
+
+
+TEST(GnssSampleCaptureTest, RawSamplesAndAnnotations)
+{
+    const std::string filename = "./gnss_sample_capture_raw_test.dat";
+    const double fs = 1e6;
+    std::vector<std::complex<float>> input(3000);
+    for (unsigned int i = 0; i < input.size(); i++)
+        {
+            input[i] = std::complex<float>(static_cast<float>(i + 1), -static_cast<float>(i));
+        }
+    // small buffers, so the disk may not keep up: the samples are either replayed where they were or zeros
+    Gnss_Sample_Capture_Writer writer(4096, 2);
+    ASSERT_TRUE(writer.open(filename, sizeof(std::complex<float>), 0, fs));
+    writer.time_tag(0, 10, 0.0);
+    writer.write(&input[0], 1000);
+    writer.time_tag(1000, 10, 1000.0 / fs);
+    writer.write(&input[1000], 1000);
+    // 50 samples lost by the front end before this one
+    writer.time_tag(2000, 10, 2050.0 / fs);
+    for (unsigned int i = 2000; i < input.size(); i += 100)
+        {
+            writer.write(&input[i], 100);
+        }
+    writer.close();
+    EXPECT_EQ(1u, writer.overflows());
+    EXPECT_EQ(50u, writer.lost_samples());
+    EXPECT_EQ(input.size(), writer.samples());
+    EXPECT_EQ(input.size(), writer.written_samples() + writer.dropped_samples());
+
+    Gnss_Sample_Capture_Reader reader;
+    ASSERT_TRUE(reader.open(filename));
+    EXPECT_EQ(sizeof(std::complex<float>), reader.output_item_size());
+    EXPECT_DOUBLE_EQ(fs, reader.sample_rate());
+    EXPECT_EQ(input.size(), reader.samples());
+    EXPECT_EQ(50u, reader.lost_samples());
+    ASSERT_EQ(3u, reader.time_tags().size());
+    EXPECT_EQ(2000u, reader.time_tags()[2].sample);
+    EXPECT_EQ(10u, reader.time_tags()[2].seconds);
+    EXPECT_DOUBLE_EQ(2050.0 / fs, reader.time_tags()[2].fraction);
+
+    std::vector<std::complex<float>> output(input.size());
+    unsigned int n = 0;
+    unsigned int r = 0;
+    while ((r = reader.read(&output[n], 700)) > 0) n += r;
+    ASSERT_EQ(input.size(), n);
+    unsigned int zeros = 0;
+    for (unsigned int i = 0; i < input.size(); i++)
+        {
+            if (output[i] == std::complex<float>(0.0, 0.0))
+                {
+                    zeros++;
+                }
+            else
+                {
+                    EXPECT_EQ(input[i], output[i]);
+                }
+        }
+    EXPECT_EQ(writer.dropped_samples(), zeros);
+    remove_capture(filename);
+}
+
+
+TEST(GnssSampleCaptureTest, RequantizedSamples)
+{
+    // odd chunks, so that the 2-bit samples are split across the bytes
+    EXPECT_GT(capture_round_trip(4, 333, 101), 0.98);
+    EXPECT_GT(capture_round_trip(2, 333, 101), 0.85);
+}
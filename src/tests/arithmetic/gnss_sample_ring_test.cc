@@ -0,0 +1,74 @@
+/*!
+ * \file gnss_sample_ring_test.cc
+ * \brief This file implements tests for the Gnss_Sample_Ring
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <complex>
+#include <vector>
+#include "gnss_sample_ring.h"
+
+
+TEST(GnssSampleRingTest, ReadsBySampleStamp)
+{
+    Gnss_Sample_Ring ring(1000);
+    EXPECT_EQ(1024u, ring.capacity());
+
+    std::vector<std::complex<float>> input(700);
+    std::vector<std::complex<float>> output(100);
+    unsigned long int stamp = 0;
+    for (unsigned int block = 0; block < 3; block++)
+        {
+            for (unsigned int i = 0; i < input.size(); i++)
+                {
+                    input[i] = std::complex<float>(static_cast<float>(stamp + i), 0.0);
+                }
+            ring.write(input.data(), input.size());
+            stamp += input.size();
+        }
+    EXPECT_EQ(2100u, ring.newest());
+
+    // A window across the end of the buffer
+    ASSERT_TRUE(ring.read(1500, output.data(), output.size()));
+    for (unsigned int i = 0; i < output.size(); i++)
+        {
+            EXPECT_EQ(static_cast<float>(1500 + i), output[i].real());
+        }
+
+    // The freshest window, one not written yet and one overwritten
+    EXPECT_TRUE(ring.read(2000, output.data(), output.size()));
+    EXPECT_EQ(2000.0, output[0].real());
+    EXPECT_FALSE(ring.read(2001, output.data(), output.size()));
+    EXPECT_TRUE(ring.read(2100 - 1024, output.data(), output.size()));
+    EXPECT_FALSE(ring.read(2100 - 1025, output.data(), output.size()));
+
+    std::shared_ptr<Gnss_Sample_Ring> shared = Gnss_Sample_Ring_Store::instance().create(3, 100);
+    EXPECT_EQ(shared, Gnss_Sample_Ring_Store::instance().get(3));
+    EXPECT_FALSE(Gnss_Sample_Ring_Store::instance().get(4));
+    Gnss_Sample_Ring_Store::instance().clear();
+    EXPECT_FALSE(Gnss_Sample_Ring_Store::instance().get(3));
+}
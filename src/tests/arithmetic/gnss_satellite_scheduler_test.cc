@@ -0,0 +1,114 @@
+/*!
+ * \file gnss_satellite_scheduler_test.cc
+ * \brief Tests of the order of acquisition of the predicted satellites.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <list>
+#include <gtest/gtest.h>
+#include "GPS_L1_CA.h"
+#include "gnss_satellite_scheduler.h"
+
+
+namespace
+{
+// GPS satellite in a circular orbit, at mean anomaly M_0 at the reference time
+Gps_Ephemeris circular_orbit(unsigned int prn, double M_0, double toe)
+{
+    Gps_Ephemeris eph;
+    eph.i_satellite_PRN = prn;
+    eph.d_sqrt_A = 5153.7;
+    eph.d_e_eccentricity = 0.0;
+    eph.d_i_0 = 55.0 * GPS_PI / 180.0;
+    eph.d_OMEGA0 = 1.0;
+    eph.d_OMEGA = 0.0;
+    eph.d_M_0 = M_0;
+    eph.d_Toe = toe;
+    return eph;
+}
+}
+
+
+TEST(GnssSatelliteSchedulerTest, HighestSatelliteFirst)
+{
+    Gnss_Nav_Data_Store::instance().clear();
+    const double tow = 100000.0;
+    Gnss_Nav_Data nav;
+    nav.gps_ephemeris_map[5] = circular_orbit(5, 0.3, tow);
+    nav.gps_ephemeris_map[7] = circular_orbit(7, 0.3 + GPS_PI, tow);  // on the other side of the Earth
+
+    // the receiver under satellite 5
+    Gps_Ephemeris sat5 = nav.gps_ephemeris_map[5];
+    sat5.satellitePosition(tow);
+    Gnss_Rx_Position position;
+    position.latitude_d = std::atan2(sat5.d_satpos_Z, std::hypot(sat5.d_satpos_X, sat5.d_satpos_Y)) * 180.0 / GPS_PI;
+    position.longitude_d = std::atan2(sat5.d_satpos_Y, sat5.d_satpos_X) * 180.0 / GPS_PI;
+    position.height_m = 0.0;
+    position.version = 1;
+
+    Gnss_Satellite_Scheduler scheduler(true, 5.0, 30.0);
+    EXPECT_EQ(2, scheduler.predict(nav, position, tow));
+
+    std::list<Gnss_Signal> signals;
+    signals.push_back(Gnss_Signal(Gnss_Satellite("GPS", 7), "1C"));
+    signals.push_back(Gnss_Signal(Gnss_Satellite("GPS", 12), "1C"));
+    signals.push_back(Gnss_Signal(Gnss_Satellite("Galileo", 11), "1B"));
+    signals.push_back(Gnss_Signal(Gnss_Satellite("GPS", 5), "1C"));
+
+    Gnss_Satellite_Prediction prediction;
+    ASSERT_TRUE(scheduler.prediction(signals.back(), prediction));
+    EXPECT_GT(prediction.elevation_d, 85.0);
+    // a satellite overhead is not moving away from the receiver
+    EXPECT_LT(std::abs(prediction.doppler_hz("1C")), 1000.0);
+    ASSERT_TRUE(scheduler.prediction(signals.front(), prediction));
+    EXPECT_LT(prediction.elevation_d, 0.0);
+
+    // in view, without prediction, below the mask
+    Gnss_Signal signal;
+    ASSERT_TRUE(scheduler.next_signal(signals, "1C", signal));
+    EXPECT_EQ(5, signal.get_satellite().get_PRN());
+    ASSERT_TRUE(scheduler.next_signal(signals, "1C", signal));
+    EXPECT_EQ(12, signal.get_satellite().get_PRN());
+    ASSERT_TRUE(scheduler.next_signal(signals, "1C", signal));
+    EXPECT_EQ(7, signal.get_satellite().get_PRN());
+    EXPECT_FALSE(scheduler.next_signal(signals, "1C", signal));
+    EXPECT_EQ(1, signals.size());
+}
+
+
+TEST(GnssSatelliteSchedulerTest, ListOrderWhenDisabled)
+{
+    Gnss_Nav_Data_Store::instance().clear();
+    Gnss_Satellite_Scheduler scheduler(false, 5.0, 30.0);
+    std::list<Gnss_Signal> signals;
+    signals.push_back(Gnss_Signal(Gnss_Satellite("GPS", 3), "1C"));
+    signals.push_back(Gnss_Signal(Gnss_Satellite("GPS", 1), "1C"));
+    Gnss_Signal signal;
+    ASSERT_TRUE(scheduler.next_signal(signals, "1C", signal));
+    EXPECT_EQ(3, signal.get_satellite().get_PRN());
+}
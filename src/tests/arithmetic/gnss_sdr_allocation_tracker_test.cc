@@ -0,0 +1,75 @@
+/*!
+ * \file gnss_sdr_allocation_tracker_test.cc
+ * \brief  This file implements tests for the counting of the heap
+ *  allocations of the block threads.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "gnss_sdr_allocation_tracker.h"
+
+
+TEST(GnssSdrAllocationTrackerTest, CountsTheTrackedThreads)
+{
+    const unsigned long long before = Gnss_Sdr_Allocation_Tracker::allocations();
+    Gnss_Sdr_Allocation_Tracker::arm(false);
+    std::thread tracked([]() {
+        Gnss_Sdr_Allocation_Tracker::track_current_thread(true);
+        // the vector and its elements
+        std::vector<int>* v = new std::vector<int>(10);
+        delete v;
+    });
+    tracked.join();
+    std::thread untracked([]() {
+        Gnss_Sdr_Allocation_Tracker::track_current_thread(false);
+        std::vector<int> v(10);
+    });
+    untracked.join();
+    Gnss_Sdr_Allocation_Tracker::disarm();
+    EXPECT_EQ(before + 2, Gnss_Sdr_Allocation_Tracker::allocations());
+
+    std::vector<Gnss_Sdr_Allocation_Tracker::Thread_Allocations> threads = Gnss_Sdr_Allocation_Tracker::threads();
+    ASSERT_FALSE(threads.empty());
+    EXPECT_EQ(2u, threads.back().allocations);
+    EXPECT_FALSE(threads.back().first_stack.empty());
+    EXPECT_FALSE(Gnss_Sdr_Allocation_Tracker::summary().empty());
+}
+
+
+TEST(GnssSdrAllocationTrackerTest, NothingCountedUnlessArmed)
+{
+    const unsigned long long before = Gnss_Sdr_Allocation_Tracker::allocations();
+    std::thread tracked([]() {
+        Gnss_Sdr_Allocation_Tracker::track_current_thread(true);
+        std::vector<int> v(10);
+    });
+    tracked.join();
+    EXPECT_FALSE(Gnss_Sdr_Allocation_Tracker::armed());
+    EXPECT_EQ(before, Gnss_Sdr_Allocation_Tracker::allocations());
+}
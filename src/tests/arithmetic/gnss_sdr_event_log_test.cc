@@ -0,0 +1,95 @@
+/*!
+ * \file gnss_sdr_event_log_test.cc
+ * \brief Tests of the non-blocking console and log output
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <string>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include "gnss_sdr_event_log.h"
+
+
+TEST(Gnss_Sdr_Event_Log_test, FormatsEvents)
+{
+    Gnss_Sdr_Event event = Gnss_Sdr_Event();
+    event.type = EVENT_TRACKING_START;
+    event.channel = 3;
+    event.system = 'G';
+    event.prn = 1;
+    EXPECT_EQ(0u, Gnss_Sdr_Event_Log::format(event).find("Tracking start on channel 3 for satellite GPS PRN 01 (Block"));
+
+    event.system = 'E';
+    event.prn = 11;
+    event.type = EVENT_GALILEO_CRC_ERROR;
+    EXPECT_EQ(0u, Gnss_Sdr_Event_Log::format(event).find("Galileo CRC error on channel 3 from satellite Galileo PRN E11"));
+
+    event.type = EVENT_LOSS_OF_LOCK;
+    EXPECT_EQ("Loss of lock in channel 3!", Gnss_Sdr_Event_Log::format(event));
+
+    event.type = EVENT_SBAS_MESSAGE;
+    event.prn = 120;
+    event.count = 9;
+    EXPECT_EQ("SBAS message type 9 from PRN120 received", Gnss_Sdr_Event_Log::format(event));
+
+    event.type = EVENT_RX_TIME;
+    event.count = 42;
+    EXPECT_EQ("Current input signal time = 42 [s]", Gnss_Sdr_Event_Log::format(event));
+}
+
+
+TEST(Gnss_Sdr_Event_Log_test, FormatsPositionTime)
+{
+    Gnss_Sdr_Event event = Gnss_Sdr_Event();
+    event.type = EVENT_POSITION;
+    event.system = 'E';
+    event.utc_us = (boost::posix_time::time_from_string("2016-02-03 04:05:06.5")
+            - boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1))).total_microseconds();
+    event.values[0] = 41.5;
+    event.values[1] = 2.25;
+    event.values[2] = 100;
+    EXPECT_EQ("Galileo Position at 2016-Feb-03 04:05:06.500000 UTC is Lat = 41.5 [deg], Long = 2.25 [deg], Height= 100 [m]",
+            Gnss_Sdr_Event_Log::format(event));
+
+    event.system = 0;
+    event.count = 7;
+    EXPECT_EQ("Position at 2016-Feb-03 04:05:06.500000 UTC using 7 observations is Lat = 41.5 [deg], Long = 2.25 [deg], Height= 100 [m]",
+            Gnss_Sdr_Event_Log::format(event));
+}
+
+
+TEST(Gnss_Sdr_Event_Log_test, PostAndFlush)
+{
+    for (int i = 0; i < 10; i++)
+        {
+            Gnss_Sdr_Event event = Gnss_Sdr_Event();
+            event.type = EVENT_LOSS_OF_LOCK;
+            event.channel = i;
+            EXPECT_TRUE(Gnss_Sdr_Event_Log::post(event));
+        }
+    Gnss_Sdr_Event_Log::flush();
+    EXPECT_EQ(0u, Gnss_Sdr_Event_Log::dropped());
+}
@@ -0,0 +1,76 @@
+/*!
+ * \file gnss_sdr_numa_test.cc
+ * \brief  This file implements tests for the placement of the channels
+ *  on the NUMA nodes.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "gnss_sdr_numa.h"
+#include "in_memory_configuration.h"
+
+
+TEST(GnssSdrNumaTest, ParsesCpuLists)
+{
+    std::vector<int> cores = Gnss_Sdr_Numa::parse_cpu_list("0-3,8,10-11");
+    ASSERT_EQ(7u, cores.size());
+    EXPECT_EQ(0, cores[0]);
+    EXPECT_EQ(3, cores[3]);
+    EXPECT_EQ(8, cores[4]);
+    EXPECT_EQ(11, cores[6]);
+    EXPECT_TRUE(Gnss_Sdr_Numa::parse_cpu_list("").empty());
+    EXPECT_GE(Gnss_Sdr_Numa::nodes(), 1u);
+}
+
+
+TEST(GnssSdrNumaTest, NodesOfTheChannels)
+{
+    std::shared_ptr<InMemoryConfiguration> configuration = std::make_shared<InMemoryConfiguration>();
+    configuration->set_property("Channels_1C.count", "2");
+    configuration->set_property("Channels_1B.count", "2");
+    configuration->set_property("Channels_1B.numa_node", "1");
+    configuration->set_property("Channel3.numa_node", "0");
+    EXPECT_EQ(-1, Gnss_Sdr_Numa::channel_node(configuration, 0));
+    EXPECT_EQ(1, Gnss_Sdr_Numa::channel_node(configuration, 2));
+    EXPECT_EQ(0, Gnss_Sdr_Numa::channel_node(configuration, 3));
+}
+
+
+TEST(GnssSdrNumaTest, RunsOnTheNode)
+{
+    // on node 0 if the machine reports one, else on the calling thread
+    std::thread::id id;
+    Gnss_Sdr_Numa::run_on_node(0, [&id]() { id = std::this_thread::get_id(); });
+    EXPECT_EQ(Gnss_Sdr_Numa::node_cores(0).empty(), id == std::this_thread::get_id());
+    Gnss_Sdr_Numa::run_on_node(-1, [&id]() { id = std::this_thread::get_id(); });
+    EXPECT_EQ(std::this_thread::get_id(), id);
+    EXPECT_THROW(Gnss_Sdr_Numa::run_on_node(0, []() { throw std::runtime_error("in the task"); }), std::runtime_error);
+}
@@ -0,0 +1,69 @@
+/*!
+ * \file gnss_source_alignment_test.cc
+ * \brief Tests of the alignment of the signal sources to a common start
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <vector>
+#include <gtest/gtest.h>
+#include "gnss_source_alignment.h"
+
+
+TEST(GnssSourceAlignmentTest, SourcesStartAtTheLatestStart)
+{
+    std::vector<Gnss_Source_Start> sources(3);
+    sources[0].sampling_frequency_hz = 4e6;
+    sources[0].start_time_s = 10.0;
+    sources[1].sampling_frequency_hz = 20e6;
+    sources[1].start_time_s = 10.00125;      // the latest
+    sources[2].sampling_frequency_hz = 4e6;
+    sources[2].start_time_s = 9.9999999;     // 0.4 samples before the first one
+
+    std::vector<Gnss_Source_Skip> skips = gnss_source_alignment(sources);
+    ASSERT_EQ(3u, skips.size());
+    EXPECT_EQ(5000u, skips[0].samples);
+    EXPECT_NEAR(0.0, skips[0].residual_s, 1e-12);
+    EXPECT_EQ(0u, skips[1].samples);
+    EXPECT_DOUBLE_EQ(0.0, skips[1].residual_s);
+    EXPECT_EQ(5000u, skips[2].samples);
+    EXPECT_NEAR(-1e-7, skips[2].residual_s, 1e-12);
+}
+
+
+TEST(GnssSourceAlignmentTest, SourcesWithoutRateAreNotAligned)
+{
+    std::vector<Gnss_Source_Start> sources(2);
+    sources[0].sampling_frequency_hz = 2e6;
+    sources[0].start_time_s = 1.0;
+    sources[1].sampling_frequency_hz = 0.0;
+    sources[1].start_time_s = 5.0;
+
+    std::vector<Gnss_Source_Skip> skips = gnss_source_alignment(sources);
+    EXPECT_EQ(0u, skips[0].samples);
+    EXPECT_EQ(0u, skips[1].samples);
+    EXPECT_TRUE(gnss_source_alignment(std::vector<Gnss_Source_Start>()).empty());
+}
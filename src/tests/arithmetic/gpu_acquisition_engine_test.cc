@@ -0,0 +1,133 @@
+/*!
+ * \file gpu_acquisition_engine_test.cc
+ * \brief  This file implements tests for the CUDA acquisition engine,
+ *  checking its peaks against the same search done with FFTW.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <vector>
+#include <gnuradio/fft/fft.h>
+#include <volk/volk.h>
+#include "cuda_acquisition_engine.h"
+#include "gps_sdr_signal_processing.h"
+#include "GPS_L1_CA.h"
+
+
+TEST(GPU_acquisition_engine_test, MatchesCpuSearch)
+{
+    const long fs_in = 2048000;
+    const int fft_size = 2048;          // one code period
+    const int doppler_max = 5000;
+    const int doppler_step = 500;
+    const int num_bins = 2 * doppler_max / doppler_step;
+    const unsigned int prns[3] = { 1, 7, 22 };
+    const int n_codes = 3;
+    const int delay = 613;              // samples
+    const float true_doppler = 1500.0;
+
+    // The signal of PRN 7 in noise
+    std::vector<gr_complex> code(fft_size);
+    std::vector<gr_complex> in(fft_size);
+    gps_l1_ca_code_gen_complex_sampled(code.data(), prns[1], fs_in, 0);
+    srand(1);
+    for (int n = 0; n < fft_size; n++)
+        {
+            float phase = GPS_TWO_PI * true_doppler * static_cast<float>(n) / static_cast<float>(fs_in);
+            float noise_i = static_cast<float>(rand()) / RAND_MAX - 0.5;
+            float noise_q = static_cast<float>(rand()) / RAND_MAX - 0.5;
+            in[n] = code[(n + fft_size - delay) % fft_size] * gr_complex(cos(phase), sin(phase)) + gr_complex(noise_i, noise_q);
+        }
+
+    std::vector<float> phase_steps(num_bins);
+    for (int i = 0; i < num_bins; i++)
+        {
+            phase_steps[i] = GPS_TWO_PI * (-doppler_max + doppler_step * i) / static_cast<double>(fs_in);
+        }
+
+    cuda_acquisition_engine engine;
+    ASSERT_TRUE(engine.init(fft_size, num_bins, n_codes));
+    ASSERT_TRUE(engine.set_doppler_grid(phase_steps.data()));
+
+    gr::fft::fft_complex fft(fft_size, true);
+    gr::fft::fft_complex ifft(fft_size, false);
+    std::vector<std::vector<gr_complex> > code_spectra(n_codes, std::vector<gr_complex>(fft_size));
+    for (int c = 0; c < n_codes; c++)
+        {
+            gps_l1_ca_code_gen_complex_sampled(code.data(), prns[c], fs_in, 0);
+            ASSERT_TRUE(engine.set_local_code(c, code.data()));
+            memcpy(fft.get_inbuf(), code.data(), sizeof(gr_complex) * fft_size);
+            fft.execute();
+            volk_32fc_conjugate_32fc(code_spectra[c].data(), fft.get_outbuf(), fft_size);
+        }
+
+    // Slots in reverse order, to check that peaks(i) follows the given slots
+    const int slots[3] = { 2, 1, 0 };
+    ASSERT_TRUE(engine.search_async(in.data(), slots, n_codes));
+    ASSERT_TRUE(engine.wait());
+
+    std::vector<float> magnitude(fft_size);
+    for (int i = 0; i < n_codes; i++)
+        {
+            const cuda_acquisition_peak* peaks = engine.peaks(i);
+            for (int bin = 0; bin < num_bins; bin++)
+                {
+                    for (int n = 0; n < fft_size; n++)
+                        {
+                            double phase = phase_steps[bin] * static_cast<double>(n);
+                            fft.get_inbuf()[n] = in[n] * gr_complex(cos(phase), -sin(phase));
+                        }
+                    fft.execute();
+                    volk_32fc_x2_multiply_32fc(ifft.get_inbuf(), fft.get_outbuf(), code_spectra[slots[i]].data(), fft_size);
+                    ifft.execute();
+                    volk_32fc_magnitude_squared_32f(magnitude.data(), ifft.get_outbuf(), fft_size);
+                    int index = 0;
+                    for (int n = 1; n < fft_size; n++)
+                        {
+                            if (magnitude[n] > magnitude[index]) index = n;
+                        }
+                    EXPECT_NEAR(magnitude[index], peaks[bin].magnitude, 1e-3 * magnitude[index]) << "slot " << slots[i] << " bin " << bin;
+                    if (slots[i] == 1)
+                        {
+                            EXPECT_EQ(index, peaks[bin].index) << "bin " << bin;
+                        }
+                }
+        }
+
+    // And the search finds the satellite
+    const cuda_acquisition_peak* peaks = engine.peaks(1);
+    int best = 0;
+    for (int bin = 1; bin < num_bins; bin++)
+        {
+            if (peaks[bin].magnitude > peaks[best].magnitude) best = bin;
+        }
+    EXPECT_EQ(static_cast<int>(true_doppler), -doppler_max + doppler_step * best);
+    EXPECT_EQ(delay, peaks[best].index);
+    EXPECT_TRUE(engine.free_cuda());
+}
@@ -0,0 +1,138 @@
+/*!
+ * \file gpu_multichannel_correlator_test.cc
+ * \brief  This file implements tests for the batched CUDA multi-channel
+ *  correlator, checking its outputs against cpu_multicorrelator.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <complex>
+#include <cstdlib>
+#include <vector>
+#include <volk/volk.h>
+#include "cpu_multicorrelator.h"
+#include "cuda_multichannel_correlator.h"
+#include "gps_sdr_signal_processing.h"
+#include "GPS_L1_CA.h"
+
+
+TEST(GPU_multichannel_correlator_test, MatchesSingleChannelCorrelator)
+{
+    // GPS L1 C/A channels with three taps, and one channel shaped as Galileo E1
+    // VEML tracking (5 taps over a 4092-chip code sampled at two samples per chip)
+    const int n_gps_channels = 3;
+    const int n_channels = n_gps_channels + 1;
+    const int signal_length = 4000;
+    const int ring_length = 6000;  // so that the second push wraps around
+    const int gps_code_length = static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS);
+    const int galileo_code_length = 2 * 4092;
+    const int max_taps = 5;
+
+    std::vector<int> code_length(n_channels, gps_code_length);
+    std::vector<int> n_taps(n_channels, 3);
+    code_length[n_gps_channels] = galileo_code_length;
+    n_taps[n_gps_channels] = 5;
+    float gps_shifts[5] = { -0.5, 0.0, 0.5, 0.0, 0.0 };  // padded, the reference always runs max_taps
+    float galileo_shifts[5] = { -1.25, -0.25, 0.0, 0.25, 1.25 };  // multiples of 1/8 chip, as the code phases
+
+    std::vector<gr_complex*> codes(n_channels);
+    for (int ch = 0; ch < n_channels; ch++)
+        {
+            codes[ch] = static_cast<gr_complex*>(volk_malloc(code_length[ch] * sizeof(gr_complex), volk_get_alignment()));
+            if (ch < n_gps_channels)
+                {
+                    gps_l1_ca_code_gen_complex(codes[ch], ch + 1, 0);
+                }
+            else
+                {
+                    for (int n = 0; n < code_length[ch]; n++)
+                        {
+                            codes[ch][n] = gr_complex((rand() % 2) ? 1.0 : -1.0, 0.0);
+                        }
+                }
+        }
+
+    const int n_samples = 2 * signal_length;
+    gr_complex* in = static_cast<gr_complex*>(volk_malloc(n_samples * sizeof(gr_complex), volk_get_alignment()));
+    for (int n = 0; n < n_samples; n++)
+        {
+            in[n] = gr_complex(static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5,
+                               static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5);
+        }
+
+    gr_complex* gpu_out = static_cast<gr_complex*>(volk_malloc(n_channels * max_taps * sizeof(gr_complex), volk_get_alignment()));
+    gr_complex* reference_out = static_cast<gr_complex*>(volk_malloc(max_taps * sizeof(gr_complex), volk_get_alignment()));
+
+    cuda_multichannel_correlator batched;
+    ASSERT_TRUE(batched.init(ring_length, n_channels, galileo_code_length));
+    for (int ch = 0; ch < n_channels; ch++)
+        {
+            float* shifts = (ch < n_gps_channels) ? gps_shifts : galileo_shifts;
+            EXPECT_EQ(ch, batched.add_channel(code_length[ch], codes[ch], shifts, n_taps[ch], gpu_out + ch * max_taps));
+        }
+
+    cpu_multicorrelator reference;
+    reference.init(signal_length, max_taps);
+
+    // Two epochs: the second one starts in the middle of the ring and wraps around
+    for (int epoch = 0; epoch < 2; epoch++)
+        {
+            unsigned long long first = batched.push_samples(in + epoch * signal_length, signal_length);
+            for (int ch = 0; ch < n_channels; ch++)
+                {
+                    ASSERT_TRUE(batched.submit(ch, first + 10 * ch, 0.3 * ch + epoch, 0.05 + 0.01 * ch,
+                            0.125 * ch, 0.25 + 0.125 * ch, signal_length - 10 * ch));
+                }
+            batched.execute();
+
+            for (int ch = 0; ch < n_channels; ch++)
+                {
+                    float* shifts = (ch < n_gps_channels) ? gps_shifts : galileo_shifts;
+                    reference.set_local_code_and_taps(code_length[ch], codes[ch], shifts);
+                    reference.set_input_output_vectors(reference_out, in + epoch * signal_length + 10 * ch);
+                    reference.Carrier_wipeoff_multicorrelator_resampler(0.3 * ch + epoch, 0.05 + 0.01 * ch,
+                            0.125 * ch, 0.25 + 0.125 * ch, signal_length - 10 * ch);
+                    for (int n = 0; n < n_taps[ch]; n++)
+                        {
+                            EXPECT_NEAR(reference_out[n].real(), gpu_out[ch * max_taps + n].real(), 1e-2);
+                            EXPECT_NEAR(reference_out[n].imag(), gpu_out[ch * max_taps + n].imag(), 1e-2);
+                        }
+                }
+        }
+
+    // samples that have already been overwritten in the ring cannot be submitted
+    EXPECT_FALSE(batched.submit(0, 0, 0.0, 0.1, 0.0, 0.25, signal_length));
+
+    reference.free();
+    batched.free_cuda();
+    for (int ch = 0; ch < n_channels; ch++)
+        {
+            volk_free(codes[ch]);
+        }
+    volk_free(gpu_out);
+    volk_free(reference_out);
+    volk_free(in);
+}
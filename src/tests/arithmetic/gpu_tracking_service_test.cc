@@ -0,0 +1,140 @@
+/*!
+ * \file gpu_tracking_service_test.cc
+ * \brief  This file implements tests for the service that batches the GPU
+ *  correlators of the tracking channels, checking its outputs against
+ *  cpu_multicorrelator.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <complex>
+#include <cstdlib>
+#include <vector>
+#include <boost/thread/thread.hpp>
+#include <volk/volk.h>
+#include "cpu_multicorrelator.h"
+#include "cuda_tracking_service.h"
+#include "gps_sdr_signal_processing.h"
+#include "GPS_L1_CA.h"
+
+
+TEST(GPU_tracking_service_test, BatchesTheChannelThreads)
+{
+    // two channels track the same input from their own threads, with code
+    // periods that start at different samples
+    const int n_channels = 2;
+    const int n_epochs = 10;
+    const int signal_length = 2046;
+    const int n_samples = (n_epochs + 1) * signal_length;
+    const int code_length = static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS);
+    float shifts[3] = { -0.5, 0.0, 0.5 };
+
+    std::vector<gr_complex> in(n_samples);
+    for (int n = 0; n < n_samples; n++)
+        {
+            in[n] = gr_complex(static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5,
+                               static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5);
+        }
+    std::vector<std::vector<gr_complex> > codes(n_channels, std::vector<gr_complex>(code_length));
+    for (int ch = 0; ch < n_channels; ch++)
+        {
+            gps_l1_ca_code_gen_complex(codes[ch].data(), ch + 1, 0);
+        }
+
+    // a long wait, so that every batch has both channels
+    Cuda_Tracking_Service service(4 * signal_length, n_channels, code_length, 1000000);
+    ASSERT_TRUE(service.ready());
+    std::vector<std::vector<gr_complex> > gpu_out(n_channels, std::vector<gr_complex>(3));
+    std::vector<int> channels(n_channels);
+    for (int ch = 0; ch < n_channels; ch++)
+        {
+            channels[ch] = service.add_channel(code_length, codes[ch].data(), shifts, 3, gpu_out[ch].data());
+            ASSERT_EQ(ch, channels[ch]);
+            service.set_active(channels[ch], true);
+        }
+
+    std::vector<std::vector<gr_complex> > outputs(n_channels, std::vector<gr_complex>(3 * n_epochs));
+    std::vector<int> failures(n_channels, 0);
+    boost::thread_group threads;
+    for (int ch = 0; ch < n_channels; ch++)
+        {
+            threads.create_thread([&, ch]()
+                {
+                    for (int epoch = 0; epoch < n_epochs; epoch++)
+                        {
+                            // as a block, that pushes all its input before consuming it
+                            service.push(epoch * signal_length, in.data() + epoch * signal_length, 2 * signal_length);
+                            const unsigned long long first_sample = epoch * signal_length + 100 * ch;
+                            if (!service.correlate(channels[ch], first_sample, 0.3 * ch + 0.1 * epoch, 0.05 + 0.01 * ch,
+                                    0.125 * ch, 0.5 + 0.01 * ch, signal_length))
+                                {
+                                    failures[ch]++;
+                                }
+                            std::copy(gpu_out[ch].begin(), gpu_out[ch].end(), outputs[ch].begin() + 3 * epoch);
+                        }
+                    service.set_active(channels[ch], false);
+                });
+        }
+    threads.join_all();
+    EXPECT_EQ(0, failures[0]);
+    EXPECT_EQ(0, failures[1]);
+    EXPECT_EQ(static_cast<unsigned long int>(n_epochs), service.batches());
+
+    cpu_multicorrelator reference;
+    reference.init(signal_length, 3);
+    std::vector<gr_complex> reference_out(3);
+    for (int ch = 0; ch < n_channels; ch++)
+        {
+            reference.set_local_code_and_taps(code_length, codes[ch].data(), shifts);
+            for (int epoch = 0; epoch < n_epochs; epoch++)
+                {
+                    reference.set_input_output_vectors(reference_out.data(), in.data() + epoch * signal_length + 100 * ch);
+                    reference.Carrier_wipeoff_multicorrelator_resampler(0.3 * ch + 0.1 * epoch, 0.05 + 0.01 * ch,
+                            0.125 * ch, 0.5 + 0.01 * ch, signal_length);
+                    for (int n = 0; n < 3; n++)
+                        {
+                            EXPECT_NEAR(reference_out[n].real(), outputs[ch][3 * epoch + n].real(), 1e-2);
+                            EXPECT_NEAR(reference_out[n].imag(), outputs[ch][3 * epoch + n].imag(), 1e-2);
+                        }
+                }
+        }
+
+    // the first samples have left the ring, and a channel alone does not wait
+    EXPECT_FALSE(service.correlate(channels[0], 0, 0.0, 0.1, 0.0, 0.5, signal_length));
+    EXPECT_TRUE(service.correlate(channels[0], (n_epochs - 1) * signal_length, 0.0, 0.1, 0.0, 0.5, signal_length));
+
+    // input that no block pushed leaves a gap in the ring, that cannot be correlated
+    const unsigned long long after_gap = n_samples + signal_length;
+    service.push(after_gap, in.data(), 2 * signal_length);
+    EXPECT_FALSE(service.correlate(channels[0], after_gap - signal_length / 2, 0.0, 0.1, 0.0, 0.5, signal_length));
+    EXPECT_TRUE(service.correlate(channels[0], after_gap, 0.0, 0.1, 0.0, 0.5, signal_length));
+    reference.set_local_code_and_taps(code_length, codes[0].data(), shifts);
+    reference.set_input_output_vectors(reference_out.data(), in.data());
+    reference.Carrier_wipeoff_multicorrelator_resampler(0.0, 0.1, 0.0, 0.5, signal_length);
+    EXPECT_NEAR(reference_out[1].real(), gpu_out[0][1].real(), 1e-2);
+    EXPECT_NEAR(reference_out[1].imag(), gpu_out[0][1].imag(), 1e-2);
+    reference.free();
+}
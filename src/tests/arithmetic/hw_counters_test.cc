@@ -0,0 +1,85 @@
+/*!
+ * \file hw_counters_test.cc
+ * \brief Tests of the hardware performance counters of the blocks
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <iostream>
+#include <vector>
+#include "gnss_sdr_hw_counters.h"
+#include "gnss_sdr_tracking_profiler.h"
+
+
+TEST(Hw_Counters_test, DisabledByDefault)
+{
+    Gnss_Sdr_Hw_Counter_Registry::enable(false);
+    EXPECT_FALSE(Gnss_Sdr_Hw_Counter_Registry::counters("block"));
+    EXPECT_FALSE(Gnss_Sdr_Tracking_Profiler::profile("block"));
+}
+
+
+TEST(Hw_Counters_test, CountsTheWork)
+{
+    Gnss_Sdr_Hw_Counter_Registry::reset();
+    Gnss_Sdr_Hw_Counter_Registry::enable(true);
+    // the profiles of the tracking blocks read the counters
+    std::shared_ptr<Gnss_Sdr_Tracking_Profile> profile = Gnss_Sdr_Tracking_Profiler::profile("Tracking_test");
+    Gnss_Sdr_Hw_Counter_Registry::enable(false);
+    ASSERT_TRUE(profile != nullptr);
+
+    std::vector<float> data(1 << 20, 1.0f);
+    volatile float sum = 0.0;
+    const int calls = 10;
+    for (int k = 0; k < calls; k++)
+        {
+            profile->start();
+            float partial = 0.0;
+            for (unsigned int i = 0; i < data.size(); i += 16) partial += data[i];
+            sum = sum + partial;
+            profile->end(Gnss_Sdr_Tracking_Profile::output);
+        }
+
+    std::vector<Gnss_Sdr_Hw_Counter_Registry::Block_Counters> totals = Gnss_Sdr_Hw_Counter_Registry::totals();
+    ASSERT_EQ(1u, totals.size());
+    EXPECT_EQ("Tracking_test", totals[0].block);
+    if (!totals[0].available)
+        {
+            // no PMU or perf_event_paranoid too high: nothing is counted, and nothing breaks
+            std::cout << "Hardware performance counters not available" << std::endl;
+            EXPECT_EQ(0u, totals[0].calls);
+            EXPECT_TRUE(Gnss_Sdr_Hw_Counter_Registry::summary().empty());
+            return;
+        }
+    EXPECT_EQ(static_cast<unsigned long long>(calls), totals[0].calls);
+    EXPECT_GT(totals[0].counts[Gnss_Sdr_Hw_Counters::instructions], static_cast<unsigned long long>(calls) * data.size() / 16);
+    EXPECT_GT(totals[0].counts[Gnss_Sdr_Hw_Counters::cycles], 0u);
+    std::vector<std::string> lines = Gnss_Sdr_Hw_Counter_Registry::summary();
+    ASSERT_EQ(1u, lines.size());
+    std::cout << lines[0] << std::endl;
+    EXPECT_NE(std::string::npos, Gnss_Sdr_Hw_Counter_Registry::prometheus_text().find("gnss_sdr_block_hw_events_total{block=\"Tracking_test\",event=\"instructions\"}"));
+    Gnss_Sdr_Hw_Counter_Registry::reset();
+}
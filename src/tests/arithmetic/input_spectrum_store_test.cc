@@ -0,0 +1,66 @@
+/*!
+ * \file input_spectrum_store_test.cc
+ * \brief This file implements tests for the Input_Spectrum_Store
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <complex>
+#include <vector>
+#include <gnuradio/fft/fft.h>
+#include "input_spectrum_store.h"
+
+
+TEST(InputSpectrumStoreTest, SharedAcrossChannels)
+{
+    unsigned int fft_size = 1024;
+    long fs_in = 1024000;
+    std::vector<std::complex<float>> input(fft_size, std::complex<float>(1.0, 0.0));
+    std::vector<std::complex<float>> other_input(fft_size, std::complex<float>(0.0, 1.0));
+    std::vector<std::complex<float>> unity(fft_size, std::complex<float>(1.0, 0.0));
+    std::vector<std::complex<float>> rotator(fft_size, std::complex<float>(0.0, -1.0));
+    std::vector<std::complex<float>*> rotators = { unity.data(), rotator.data() };
+    gr::fft::fft_complex fft(fft_size, true);
+
+    unsigned long int hits = Input_Spectrum_Store::instance().hits();
+    std::shared_ptr<const Input_Spectra> first = Input_Spectrum_Store::instance().get(0, fs_in, fft_size, 10, input.data(), rotators, &fft);
+    EXPECT_EQ(2u, first->num_residuals());
+    EXPECT_NEAR(static_cast<float>(fft_size), first->spectrum(0)[0].real(), 1e-3);
+    EXPECT_NEAR(-static_cast<float>(fft_size), first->spectrum(1)[0].imag(), 1e-3);
+
+    // Another channel on the same window gets the stored spectra, whatever its input buffer
+    std::shared_ptr<const Input_Spectra> second = Input_Spectrum_Store::instance().get(0, fs_in, fft_size, 10, other_input.data(), rotators, &fft);
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_EQ(hits + 1, Input_Spectrum_Store::instance().hits());
+
+    // Next window, or a different signal conditioner, is computed again
+    std::shared_ptr<const Input_Spectra> next = Input_Spectrum_Store::instance().get(0, fs_in, fft_size, 11, other_input.data(), rotators, &fft);
+    std::shared_ptr<const Input_Spectra> other_rf = Input_Spectrum_Store::instance().get(1, fs_in, fft_size, 10, other_input.data(), rotators, &fft);
+    EXPECT_NE(first.get(), next.get());
+    EXPECT_NE(first.get(), other_rf.get());
+    EXPECT_NEAR(static_cast<float>(fft_size), next->spectrum(0)[0].imag(), 1e-3);
+    EXPECT_EQ(hits + 1, Input_Spectrum_Store::instance().hits());
+}
@@ -0,0 +1,62 @@
+/*!
+ * \file kepler_orbit_test.cc
+ * \brief  This file implements tests for the cached orbit constants and
+ *  the warm-started Kepler equation solver of the ephemeris models.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include "kepler_orbit.h"
+#include "GPS_L1_CA.h"
+
+
+TEST(KeplerOrbitTest, SolvesKeplerEquation)
+{
+    Kepler_Orbit orbit;
+    const double sqrt_A = 5153.6;
+    const double delta_n = 4.5e-9;
+    const double e = 0.02;
+    orbit.set_parameters(sqrt_A, delta_n, e, GM);
+    EXPECT_DOUBLE_EQ(sqrt_A * sqrt_A, orbit.semi_major_axis());
+    EXPECT_DOUBLE_EQ(sqrt(GM / pow(sqrt_A, 6)) + delta_n, orbit.mean_motion());
+    EXPECT_DOUBLE_EQ(sqrt(1.0 - e * e), orbit.sqrt_one_minus_e2());
+
+    // consecutive epochs, as PVT does, and a jump that invalidates the warm start
+    for (int k = 0; k < 2000; k++)
+        {
+            double M = fmod(0.01 * k + (k == 1000 ? 3.0 : 0.0), 2.0 * GPS_PI);
+            double E = orbit.eccentric_anomaly(M);
+            EXPECT_NEAR(M, E - e * sin(E), 1e-12);
+        }
+
+    // a new ephemeris set recomputes the constants
+    orbit.set_parameters(sqrt_A + 1.0, delta_n, 0.5, GM);
+    EXPECT_DOUBLE_EQ((sqrt_A + 1.0) * (sqrt_A + 1.0), orbit.semi_major_axis());
+    double E = orbit.eccentric_anomaly(1.0);
+    EXPECT_NEAR(1.0, E - 0.5 * sin(E), 1e-12);
+}
@@ -0,0 +1,69 @@
+/*!
+ * \file latency_tracer_test.cc
+ * \brief  This file implements tests for the latencies of the stages
+ *  of the receiver.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "gnss_sdr_latency_tracer.h"
+
+
+TEST(LatencyTracerTest, MeasuresFromTheArrival)
+{
+    Gnss_Sdr_Latency_Tracer::reset();
+    Gnss_Sdr_Latency_Tracer::enable(false);
+    Gnss_Sdr_Latency_Tracer::arrival(0.001);
+    Gnss_Sdr_Latency_Tracer::record("tracking", 0.001);
+    EXPECT_TRUE(Gnss_Sdr_Latency_Tracer::latencies().empty());
+
+    Gnss_Sdr_Latency_Tracer::enable(true);
+    for (int ms = 1; ms <= 4; ms++)
+        {
+            Gnss_Sdr_Latency_Tracer::arrival(0.001 * ms);
+        }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    Gnss_Sdr_Latency_Tracer::record("tracking", 0.0025);  // in the third arrival
+    Gnss_Sdr_Latency_Tracer::record("pvt", 0.004);
+    Gnss_Sdr_Latency_Tracer::record("pvt", 0.005);        // not arrived yet
+
+    std::vector<Gnss_Sdr_Latency_Tracer::Stage_Latency> latencies = Gnss_Sdr_Latency_Tracer::latencies();
+    ASSERT_EQ(2u, latencies.size());
+    EXPECT_EQ("tracking", latencies[0].stage);
+    EXPECT_EQ("pvt", latencies[1].stage);
+    EXPECT_EQ(1u, latencies[1].count);
+    EXPECT_GE(latencies[0].p50_ms, 20.0);
+    EXPECT_LT(latencies[0].p50_ms, 1000.0);
+    EXPECT_DOUBLE_EQ(latencies[0].p50_ms, latencies[0].p99_ms);
+    EXPECT_EQ(2u, Gnss_Sdr_Latency_Tracer::summary().size());
+
+    Gnss_Sdr_Latency_Tracer::enable(false);
+    Gnss_Sdr_Latency_Tracer::reset();
+}
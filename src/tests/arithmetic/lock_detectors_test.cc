@@ -0,0 +1,81 @@
+/*!
+ * \file lock_detectors_test.cc
+ * \brief  This file implements tests for the sliding-window C/N0 and
+ *  carrier lock detectors, checking them against the batch functions.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <gtest/gtest.h>
+#include "lock_detectors.h"
+
+
+TEST(LockDetectorsTest, SlidingWindowMatchesBatch)
+{
+    const int window = 20;
+    const int n_epochs = 1000;
+    const long fs_in = 4000000;
+    const double code_length = 1023.0;
+
+    std::vector<gr_complex> prompt(n_epochs);
+    for (int n = 0; n < n_epochs; n++)
+        {
+            // constant in-phase signal with noise, and a phase error growing in the second half
+            float phase = (n < n_epochs / 2) ? 0.0 : 0.002 * static_cast<float>(n - n_epochs / 2);
+            float noise_I = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5;
+            float noise_Q = static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5;
+            prompt[n] = gr_complex(1000.0 * std::cos(phase) + 300.0 * noise_I, 1000.0 * std::sin(phase) + 300.0 * noise_Q);
+        }
+
+    Sliding_Lock_Detector detector(window);
+    for (int n = 0; n < n_epochs; n++)
+        {
+            detector.update(prompt[n]);
+            if (n < window - 1)
+                {
+                    EXPECT_FALSE(detector.is_full());
+                    continue;
+                }
+            ASSERT_TRUE(detector.is_full());
+            gr_complex* last = &prompt[n - window + 1];
+            EXPECT_NEAR(cn0_svn_estimator(last, window, fs_in, code_length), detector.cn0_svn_estimator(fs_in, code_length), 1e-3);
+            EXPECT_NEAR(carrier_lock_detector(last, window), detector.carrier_lock_detector(), 1e-4);
+        }
+
+    // pushing a whole block keeps only its last values
+    Sliding_Lock_Detector batch(window);
+    batch.update(&prompt[0], n_epochs);
+    EXPECT_TRUE(batch.is_full());
+    EXPECT_NEAR(detector.cn0_svn_estimator(fs_in, code_length), batch.cn0_svn_estimator(fs_in, code_length), 1e-3);
+    EXPECT_NEAR(detector.carrier_lock_detector(), batch.carrier_lock_detector(), 1e-4);
+
+    detector.reset();
+    EXPECT_FALSE(detector.is_full());
+}
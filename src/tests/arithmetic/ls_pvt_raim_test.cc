@@ -0,0 +1,284 @@
+/*!
+ * \file ls_pvt_raim_test.cc
+ * \brief  This file implements tests for the fault detection and exclusion
+ *  of the Least Squares PVT solution.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <sys/time.h>
+#include <gtest/gtest.h>
+#include "ls_pvt.h"
+#include "GPS_L1_CA.h"
+
+DEFINE_int32(ls_pvt_raim_iterations_test, 2000, "Number of fixes in the RAIM timing test");
+
+#define RAIM_TEST_SATELLITES 9
+#define RAIM_TEST_CLOCK_M 1000.0
+
+
+/*
+ * Receiver near Castelldefels and satellites at the GPS orbit radius, with
+ * pseudoranges that include the Earth rotation during the travel time and
+ * the troposphere delay, as modelled by leastSquarePos()
+ */
+static void raim_test_geometry(double * rx, double * satpos, double * obs)
+{
+    const double lat = 41.275 * GPS_PI / 180.0;
+    const double lon = 1.987 * GPS_PI / 180.0;
+    const double height = 80.0;
+    const double a = 6378137.0;
+    const double e2 = 6.69437999014e-3;
+    const double nu = a / sqrt(1.0 - e2 * sin(lat) * sin(lat));
+    rx[0] = (nu + height) * cos(lat) * cos(lon);
+    rx[1] = (nu + height) * cos(lat) * sin(lon);
+    rx[2] = (nu * (1.0 - e2) + height) * sin(lat);
+
+    const double az_deg[RAIM_TEST_SATELLITES] = {10.0, 55.0, 95.0, 140.0, 185.0, 220.0, 265.0, 300.0, 340.0};
+    const double el_deg[RAIM_TEST_SATELLITES] = {75.0, 20.0, 45.0, 30.0, 60.0, 15.0, 40.0, 25.0, 50.0};
+    // small errors of a few decimetres
+    const double noise[RAIM_TEST_SATELLITES] = {0.3, -0.2, 0.1, -0.4, 0.25, 0.05, -0.15, 0.35, -0.3};
+    Ls_Pvt model(RAIM_TEST_SATELLITES);
+    for (int i = 0; i < RAIM_TEST_SATELLITES; i++)
+        {
+            const double az = az_deg[i] * GPS_PI / 180.0;
+            const double el = el_deg[i] * GPS_PI / 180.0;
+            const double e = cos(el) * sin(az);
+            const double n = cos(el) * cos(az);
+            const double u = sin(el);
+            double dir[3];
+            dir[0] = -sin(lon) * e - sin(lat) * cos(lon) * n + cos(lat) * cos(lon) * u;
+            dir[1] = cos(lon) * e - sin(lat) * sin(lon) * n + cos(lat) * sin(lon) * u;
+            dir[2] = cos(lat) * n + sin(lat) * u;
+            const double b = rx[0] * dir[0] + rx[1] * dir[1] + rx[2] * dir[2];
+            const double c = rx[0] * rx[0] + rx[1] * rx[1] + rx[2] * rx[2] - 26560e3 * 26560e3;
+            const double range = -b + sqrt(b * b - c);
+            // the satellite position at transmission, rotated back with the Earth
+            const double omegatau = OMEGA_EARTH_DOT * range / GPS_C_m_s;
+            double rot[3];
+            for (int j = 0; j < 3; j++)
+                {
+                    rot[j] = rx[j] + range * dir[j];
+                }
+            double * X = &satpos[3 * i];
+            X[0] = cos(omegatau) * rot[0] - sin(omegatau) * rot[1];
+            X[1] = sin(omegatau) * rot[0] + cos(omegatau) * rot[1];
+            X[2] = rot[2];
+            double trop = 0.0;
+            model.tropo(&trop, sin(el), height / 1000.0, 1013.0, 293.0, 50.0, 0.0, 0.0, 0.0);
+            obs[i] = range + RAIM_TEST_CLOCK_M + trop + noise[i];
+        }
+}
+
+
+static void raim_test_load(Ls_Pvt & pvt, const double * satpos, const double * obs, int skip)
+{
+    pvt.clear_observations();
+    for (int i = 0; i < RAIM_TEST_SATELLITES; i++)
+        {
+            if (i != skip)
+                {
+                    pvt.add_observation(&satpos[3 * i], 0, obs[i], 0.0, 1.0, 0);
+                }
+        }
+}
+
+
+TEST(LsPvtRaimTest, CholeskyDowndate)
+{
+    const int n = 4;
+    const double A[n * n] = {9.0, 1.0, 2.0, 0.5,
+                             1.0, 8.0, 1.5, 1.0,
+                             2.0, 1.5, 7.0, 0.3,
+                             0.5, 1.0, 0.3, 6.0};
+    const double v[n] = {1.0, 0.5, -1.2, 0.8};
+    double L[n * n];
+    double D[n * n];
+    double w[n];
+    for (int j = 0; j < n * n; j++)
+        {
+            L[j] = A[j];
+            D[j] = A[j] - v[j / n] * v[j % n];
+        }
+    for (int j = 0; j < n; j++)
+        {
+            w[j] = v[j];
+        }
+    ASSERT_TRUE(Ls_Pvt::cholesky_decompose(L, n));
+    ASSERT_TRUE(Ls_Pvt::cholesky_downdate(L, w, n));
+    ASSERT_TRUE(Ls_Pvt::cholesky_decompose(D, n));
+    for (int i = 0; i < n; i++)
+        {
+            for (int k = 0; k <= i; k++)
+                {
+                    EXPECT_NEAR(D[i * n + k], L[i * n + k], 1e-12);
+                }
+        }
+
+    // removing more than the matrix holds
+    for (int j = 0; j < n * n; j++)
+        {
+            L[j] = A[j];
+        }
+    for (int j = 0; j < n; j++)
+        {
+            w[j] = 4.0 * v[j];
+        }
+    ASSERT_TRUE(Ls_Pvt::cholesky_decompose(L, n));
+    EXPECT_FALSE(Ls_Pvt::cholesky_downdate(L, w, n));
+}
+
+
+TEST(LsPvtRaimTest, ChiSquareThreshold)
+{
+    // tabulated quantiles
+    EXPECT_NEAR(19.5114, Ls_Pvt::chi_square_threshold(1e-5, 1), 1e-3);
+    EXPECT_NEAR(13.8155, Ls_Pvt::chi_square_threshold(1e-3, 2), 1e-3);
+    EXPECT_NEAR(16.2662, Ls_Pvt::chi_square_threshold(1e-3, 3), 1e-3);
+    EXPECT_NEAR(28.4733, Ls_Pvt::chi_square_threshold(1e-5, 4), 1e-3);
+    EXPECT_NEAR(37.3316, Ls_Pvt::chi_square_threshold(1e-5, 8), 1e-3);
+    EXPECT_NEAR(29.5883, Ls_Pvt::chi_square_threshold(1e-3, 10), 1e-3);
+    EXPECT_NEAR(7.2832, Ls_Pvt::chi_square_threshold(0.4, 7), 1e-3);
+}
+
+
+TEST(LsPvtRaimTest, DetectionAndExclusion)
+{
+    double rx[3];
+    double satpos[3 * RAIM_TEST_SATELLITES];
+    double obs[RAIM_TEST_SATELLITES];
+    raim_test_geometry(rx, satpos, obs);
+    Ls_Pvt pvt(RAIM_TEST_SATELLITES);
+    pvt.set_raim(true, 1e-5, 1.0, 1);
+
+    // consistent pseudoranges
+    raim_test_load(pvt, satpos, obs, -1);
+    arma::vec::fixed<LS_PVT_MAX_UNKNOWNS> pos = pvt.leastSquarePos();
+    EXPECT_EQ(RAIM_PASSED, pvt.raim_status());
+    EXPECT_LT(pvt.raim_test_statistic(), pvt.raim_threshold());
+    for (int j = 0; j < 3; j++)
+        {
+            EXPECT_NEAR(rx[j], pos(j), 2.0);
+        }
+    EXPECT_NEAR(RAIM_TEST_CLOCK_M, pos(3), 2.0);
+
+    // a fault on each satellite in turn is excluded, and the fix is the one
+    // computed without it, but for the troposphere delays, evaluated at the
+    // height of the faulty fix
+    for (int k = 0; k < RAIM_TEST_SATELLITES; k++)
+        {
+            obs[k] += 150.0;
+            raim_test_load(pvt, satpos, obs, -1);
+            pos = pvt.leastSquarePos();
+            ASSERT_EQ(RAIM_EXCLUDED, pvt.raim_status()) << "fault on satellite " << k;
+            EXPECT_LT(pvt.raim_test_statistic(), pvt.raim_threshold());
+            for (int i = 0; i < RAIM_TEST_SATELLITES; i++)
+                {
+                    EXPECT_EQ(i == k, pvt.raim_excluded(i)) << "fault on satellite " << k;
+                }
+
+            Ls_Pvt reference(RAIM_TEST_SATELLITES);
+            raim_test_load(reference, satpos, obs, k);
+            arma::vec::fixed<LS_PVT_MAX_UNKNOWNS> expected = reference.leastSquarePos();
+            for (int j = 0; j < 4; j++)
+                {
+                    EXPECT_NEAR(expected(j), pos(j), 0.25) << "fault on satellite " << k;
+                }
+            // the DOP follows the exclusion
+            for (int j = 0; j < 4; j++)
+                {
+                    EXPECT_NEAR(reference.d_Q(j, j), pvt.d_Q(j, j), 1e-3 * reference.d_Q(j, j));
+                }
+            obs[k] -= 150.0;
+        }
+
+    // two faults and a single exclusion allowed
+    obs[2] += 150.0;
+    obs[6] -= 120.0;
+    raim_test_load(pvt, satpos, obs, -1);
+    pvt.leastSquarePos();
+    EXPECT_EQ(RAIM_FAILED, pvt.raim_status());
+    pvt.set_raim(true, 1e-5, 1.0, 2);
+    raim_test_load(pvt, satpos, obs, -1);
+    pvt.leastSquarePos();
+    EXPECT_EQ(RAIM_EXCLUDED, pvt.raim_status());
+    EXPECT_TRUE(pvt.raim_excluded(2));
+    EXPECT_TRUE(pvt.raim_excluded(6));
+
+    // no redundancy
+    Ls_Pvt minimal(4);
+    minimal.set_raim(true, 1e-5, 1.0, 1);
+    raim_test_load(minimal, satpos, obs, -1);
+    minimal.leastSquarePos();
+    EXPECT_EQ(RAIM_UNAVAILABLE, minimal.raim_status());
+}
+
+
+TEST(LsPvtRaimTest, Timing)
+{
+    double rx[3];
+    double satpos[3 * RAIM_TEST_SATELLITES];
+    double obs[RAIM_TEST_SATELLITES];
+    raim_test_geometry(rx, satpos, obs);
+    obs[4] += 150.0;
+    Ls_Pvt pvt(RAIM_TEST_SATELLITES);
+    double checksum = 0.0;
+    struct timeval tv;
+
+    // a fix, then one fix per subset without a satellite
+    gettimeofday(&tv, NULL);
+    long long int begin = tv.tv_sec * 1000000 + tv.tv_usec;
+    for (int iter = 0; iter < FLAGS_ls_pvt_raim_iterations_test; iter++)
+        {
+            for (int k = -1; k < RAIM_TEST_SATELLITES; k++)
+                {
+                    raim_test_load(pvt, satpos, obs, k);
+                    checksum += pvt.leastSquarePos()(0);
+                }
+        }
+    gettimeofday(&tv, NULL);
+    long long int end = tv.tv_sec * 1000000 + tv.tv_usec;
+    const double subsets_us = static_cast<double>(end - begin) / FLAGS_ls_pvt_raim_iterations_test;
+
+    pvt.set_raim(true, 1e-5, 1.0, 1);
+    gettimeofday(&tv, NULL);
+    begin = tv.tv_sec * 1000000 + tv.tv_usec;
+    for (int iter = 0; iter < FLAGS_ls_pvt_raim_iterations_test; iter++)
+        {
+            raim_test_load(pvt, satpos, obs, -1);
+            checksum += pvt.leastSquarePos()(0);
+        }
+    gettimeofday(&tv, NULL);
+    end = tv.tv_sec * 1000000 + tv.tv_usec;
+    const double raim_us = static_cast<double>(end - begin) / FLAGS_ls_pvt_raim_iterations_test;
+    EXPECT_EQ(RAIM_EXCLUDED, pvt.raim_status());
+    EXPECT_TRUE(pvt.raim_excluded(4));
+
+    std::cout << "Fault detection and exclusion of " << RAIM_TEST_SATELLITES << " satellites: "
+              << subsets_us << " us re-solving every subset, " << raim_us
+              << " us with downdates (checksum " << checksum << ")" << std::endl;
+}
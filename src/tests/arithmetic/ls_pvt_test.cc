@@ -0,0 +1,477 @@
+/*!
+ * \file ls_pvt_test.cc
+ * \brief  This file implements tests for the Least Squares PVT solution
+ *  against a dense solution of the same observations.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <random>
+#include <gtest/gtest.h>
+#include "ls_pvt.h"
+#include "GPS_L1_CA.h"
+
+#define LS_PVT_TEST_MAX_SATELLITES 9
+#define LS_PVT_TEST_CLOCK_M 1000.0
+#define LS_PVT_TEST_DRIFT_M_S 30.0
+
+
+/*
+ * Receiver near Castelldefels and satellites 32000 km away at the given
+ * azimuths and elevations [deg]. At more than 0.1 s of travel time
+ * leastSquarePos() does not apply the troposphere delay, so the pseudoranges
+ * only model the Earth rotation during the travel time.
+ */
+static void ls_pvt_test_geometry(const double * az_deg, const double * el_deg, const double * noise, int m,
+        double * rx, double * satpos, double * obs)
+{
+    const double lat = 41.275 * GPS_PI / 180.0;
+    const double lon = 1.987 * GPS_PI / 180.0;
+    const double height = 80.0;
+    const double a = 6378137.0;
+    const double e2 = 6.69437999014e-3;
+    const double nu = a / sqrt(1.0 - e2 * sin(lat) * sin(lat));
+    rx[0] = (nu + height) * cos(lat) * cos(lon);
+    rx[1] = (nu + height) * cos(lat) * sin(lon);
+    rx[2] = (nu * (1.0 - e2) + height) * sin(lat);
+    const double range = 32000e3;
+    for (int i = 0; i < m; i++)
+        {
+            const double az = az_deg[i] * GPS_PI / 180.0;
+            const double el = el_deg[i] * GPS_PI / 180.0;
+            const double e = cos(el) * sin(az);
+            const double n = cos(el) * cos(az);
+            const double u = sin(el);
+            double rot[3];
+            rot[0] = rx[0] + range * (-sin(lon) * e - sin(lat) * cos(lon) * n + cos(lat) * cos(lon) * u);
+            rot[1] = rx[1] + range * (cos(lon) * e - sin(lat) * sin(lon) * n + cos(lat) * sin(lon) * u);
+            rot[2] = rx[2] + range * (cos(lat) * n + sin(lat) * u);
+            const double omegatau = OMEGA_EARTH_DOT * range / GPS_C_m_s;
+            double * X = &satpos[3 * i];
+            X[0] = cos(omegatau) * rot[0] - sin(omegatau) * rot[1];
+            X[1] = sin(omegatau) * rot[0] + cos(omegatau) * rot[1];
+            X[2] = rot[2];
+            obs[i] = range + LS_PVT_TEST_CLOCK_M + noise[i];
+        }
+}
+
+
+/*
+ * Gauss-Newton iterations of the same model with the dense m x 4 design
+ * matrix, each step solved with arma::solve(W A, W omc), and the DOP matrix
+ * as inv(A' A) of the last iteration
+ */
+static arma::vec ls_pvt_test_dense_solution(Ls_Pvt & model, const double * satpos, const double * obs,
+        const double * w, int m, arma::mat & Q)
+{
+    arma::vec pos(4);
+    pos.zeros();
+    arma::mat A = arma::zeros(m, 4);
+    arma::mat W = arma::zeros(m, m);
+    arma::vec omc(m);
+    for (int i = 0; i < m; i++)
+        {
+            W(i, i) = w[i];
+        }
+    for (int iter = 0; iter < 10; iter++)
+        {
+            for (int i = 0; i < m; i++)
+                {
+                    arma::vec X(3);
+                    for (int j = 0; j < 3; j++)
+                        {
+                            X(j) = satpos[3 * i + j];
+                        }
+                    arma::vec rot_X = X;
+                    if (iter > 0)
+                        {
+                            const double traveltime = arma::norm(X - pos.subvec(0, 2), 2) / GPS_C_m_s;
+                            rot_X = model.rotateSatellite(traveltime, X);
+                        }
+                    omc(i) = obs[i] - arma::norm(rot_X - pos.subvec(0, 2), 2) - pos(3);
+                    for (int j = 0; j < 3; j++)
+                        {
+                            A(i, j) = -(rot_X(j) - pos(j)) / obs[i];
+                        }
+                    A(i, 3) = 1.0;
+                }
+            arma::vec x = arma::solve(W * A, W * omc);
+            pos = pos + x;
+            if (arma::norm(x, 2) < 1e-4)
+                {
+                    break;
+                }
+        }
+    Q = arma::inv(A.t() * A);
+    return pos;
+}
+
+
+static void ls_pvt_test_check_fix(const double * az_deg, const double * el_deg, const double * noise,
+        const double * w, int m, double tolerance_m)
+{
+    double rx[3];
+    double satpos[3 * LS_PVT_TEST_MAX_SATELLITES];
+    double obs[LS_PVT_TEST_MAX_SATELLITES];
+    ls_pvt_test_geometry(az_deg, el_deg, noise, m, rx, satpos, obs);
+
+    Ls_Pvt pvt(m);
+    for (int i = 0; i < m; i++)
+        {
+            ASSERT_TRUE(pvt.add_observation(&satpos[3 * i], 0, obs[i], 0.0, w[i], 0));
+        }
+    arma::vec::fixed<LS_PVT_MAX_UNKNOWNS> pos = pvt.leastSquarePos();
+
+    arma::mat Q;
+    arma::vec expected = ls_pvt_test_dense_solution(pvt, satpos, obs, w, m, Q);
+    for (int j = 0; j < 4; j++)
+        {
+            EXPECT_NEAR(expected(j), pos(j), tolerance_m);
+        }
+    for (int j = 0; j < 4; j++)
+        {
+            for (int k = 0; k < 4; k++)
+                {
+                    EXPECT_NEAR(Q(j, k), pvt.d_Q(j, k), 1e-6 * std::fabs(Q(j, j)) + 1e-9);
+                }
+        }
+}
+
+
+TEST(LsPvtTest, CholeskySolveMatchesDenseSolve)
+{
+    // 5 x 5 Hilbert matrix, condition number about 5e5
+    const int n = 5;
+    double L[n * n];
+    arma::mat N(n, n);
+    arma::vec b(n);
+    double x[n];
+    for (int i = 0; i < n; i++)
+        {
+            for (int k = 0; k < n; k++)
+                {
+                    N(i, k) = 1.0 / (i + k + 1.0);
+                    L[i * n + k] = N(i, k);
+                }
+            b(i) = 1.0 - 0.3 * i;
+            x[i] = b(i);
+        }
+    ASSERT_TRUE(Ls_Pvt::cholesky_decompose(L, n));
+    Ls_Pvt::cholesky_solve(L, x, n);
+    arma::vec expected = arma::solve(N, b);
+    for (int i = 0; i < n; i++)
+        {
+            EXPECT_NEAR(expected(i), x[i], 1e-8 * arma::norm(expected, 2));
+        }
+
+    // indefinite and singular matrices are rejected
+    double S[4] = {1.0, 2.0,
+                   2.0, 1.0};
+    EXPECT_FALSE(Ls_Pvt::cholesky_decompose(S, 2));
+    double Z[4] = {1.0, 1.0,
+                   1.0, 1.0};
+    EXPECT_FALSE(Ls_Pvt::cholesky_decompose(Z, 2));
+}
+
+
+TEST(LsPvtTest, FixMatchesDenseSolution)
+{
+    const double az_deg[LS_PVT_TEST_MAX_SATELLITES] = {10.0, 55.0, 95.0, 140.0, 185.0, 220.0, 265.0, 300.0, 340.0};
+    const double el_deg[LS_PVT_TEST_MAX_SATELLITES] = {75.0, 20.0, 45.0, 30.0, 60.0, 15.0, 40.0, 25.0, 50.0};
+    const double noise[LS_PVT_TEST_MAX_SATELLITES] = {0.3, -0.2, 0.1, -0.4, 0.25, 0.05, -0.15, 0.35, -0.3};
+    const double ones[LS_PVT_TEST_MAX_SATELLITES] = {1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+    const double weights[LS_PVT_TEST_MAX_SATELLITES] = {1.0, 0.3, 0.8, 0.5, 1.0, 0.2, 0.7, 0.4, 0.9};
+    ls_pvt_test_check_fix(az_deg, el_deg, noise, ones, LS_PVT_TEST_MAX_SATELLITES, 1e-4);
+    ls_pvt_test_check_fix(az_deg, el_deg, noise, weights, LS_PVT_TEST_MAX_SATELLITES, 1e-4);
+    // a satellite with zero weight has no influence
+    double excluded[LS_PVT_TEST_MAX_SATELLITES];
+    for (int i = 0; i < LS_PVT_TEST_MAX_SATELLITES; i++)
+        {
+            excluded[i] = (i == 3) ? 0.0 : 1.0;
+        }
+    ls_pvt_test_check_fix(az_deg, el_deg, noise, excluded, LS_PVT_TEST_MAX_SATELLITES, 1e-4);
+}
+
+
+TEST(LsPvtTest, IllConditionedGeometry)
+{
+    // all the satellites in a cone of 8 degrees around the zenith: the
+    // vertical position and the clock are almost interchangeable
+    const double az_deg[6] = {0.0, 72.0, 144.0, 216.0, 288.0, 30.0};
+    const double el_deg[6] = {82.0, 83.0, 84.0, 85.0, 86.0, 89.0};
+    const double noise[6] = {0.3, -0.2, 0.1, -0.4, 0.25, 0.05};
+    const double weights[6] = {1.0, 0.6, 0.9, 0.7, 1.0, 0.8};
+    ls_pvt_test_check_fix(az_deg, el_deg, noise, weights, 6, 1e-3);
+
+    // four satellites, no redundancy
+    const double zero_noise[4] = {0.0, 0.0, 0.0, 0.0};
+    ls_pvt_test_check_fix(az_deg, el_deg, zero_noise, weights, 4, 1e-3);
+}
+
+
+TEST(LsPvtTest, SingularGeometry)
+{
+    // a second system clock without any of its observations
+    const double az_deg[5] = {10.0, 95.0, 185.0, 265.0, 340.0};
+    const double el_deg[5] = {75.0, 45.0, 60.0, 40.0, 50.0};
+    const double noise[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+    double rx[3];
+    double satpos[15];
+    double obs[5];
+    ls_pvt_test_geometry(az_deg, el_deg, noise, 5, rx, satpos, obs);
+    Ls_Pvt pvt(5);
+    for (int i = 0; i < 5; i++)
+        {
+            pvt.add_observation(&satpos[3 * i], 0, obs[i], 0.0, 1.0, 0);
+        }
+    arma::vec::fixed<LS_PVT_MAX_UNKNOWNS> pos = pvt.leastSquarePos(2);
+    for (int j = 0; j < LS_PVT_MAX_UNKNOWNS; j++)
+        {
+            EXPECT_EQ(0.0, pos(j));
+        }
+    for (int j = 0; j < 4; j++)
+        {
+            EXPECT_EQ(0.0, pvt.d_Q(j, j));
+        }
+
+    // with a common clock the same observations are solved
+    pos = pvt.leastSquarePos(1);
+    for (int j = 0; j < 3; j++)
+        {
+            EXPECT_NEAR(rx[j], pos(j), 1e-3);
+        }
+    EXPECT_NEAR(LS_PVT_TEST_CLOCK_M, pos(3), 1e-3);
+}
+
+
+/*
+ * Observations of a receiver at rx moving at vel [m/s] with the clock
+ * LS_PVT_TEST_CLOCK_M + LS_PVT_TEST_DRIFT_M_S t, from nine satellites at the
+ * GPS orbit radius, fixed in ECEF. The pseudoranges include the Earth
+ * rotation during the travel time and the troposphere delay.
+ */
+static void ls_pvt_test_moving_epoch(Ls_Pvt & pvt, const double * rx, const double * vel, double t,
+        std::mt19937 & generator, double sigma_m, double sigma_m_s)
+{
+    const double az_deg[LS_PVT_TEST_MAX_SATELLITES] = {10.0, 55.0, 95.0, 140.0, 185.0, 220.0, 265.0, 300.0, 340.0};
+    const double el_deg[LS_PVT_TEST_MAX_SATELLITES] = {75.0, 20.0, 45.0, 30.0, 60.0, 15.0, 40.0, 25.0, 50.0};
+    const double lat = 41.275 * GPS_PI / 180.0;
+    const double lon = 1.987 * GPS_PI / 180.0;
+    const double zero[3] = {0.0, 0.0, 0.0};
+    std::normal_distribution<double> noise(0.0, 1.0);
+    pvt.clear_observations();
+    for (int i = 0; i < LS_PVT_TEST_MAX_SATELLITES; i++)
+        {
+            const double az = az_deg[i] * GPS_PI / 180.0;
+            const double el = el_deg[i] * GPS_PI / 180.0;
+            const double e = cos(el) * sin(az);
+            const double n = cos(el) * cos(az);
+            const double u = sin(el);
+            double dir[3];
+            dir[0] = -sin(lon) * e - sin(lat) * cos(lon) * n + cos(lat) * cos(lon) * u;
+            dir[1] = cos(lon) * e - sin(lat) * sin(lon) * n + cos(lat) * sin(lon) * u;
+            dir[2] = cos(lat) * n + sin(lat) * u;
+            // the direction is that of the initial position, the satellite does not move
+            double sat[3];
+            double r0[3] = {rx[0] - vel[0] * t, rx[1] - vel[1] * t, rx[2] - vel[2] * t};
+            const double b0 = r0[0] * dir[0] + r0[1] * dir[1] + r0[2] * dir[2];
+            const double c0 = r0[0] * r0[0] + r0[1] * r0[1] + r0[2] * r0[2] - 26560e3 * 26560e3;
+            const double range0 = -b0 + sqrt(b0 * b0 - c0);
+            double los[3];
+            double range = 0.0;
+            for (int j = 0; j < 3; j++)
+                {
+                    sat[j] = r0[j] + range0 * dir[j];
+                    los[j] = sat[j] - rx[j];
+                    range += los[j] * los[j];
+                }
+            range = sqrt(range);
+            const double omegatau = OMEGA_EARTH_DOT * range / GPS_C_m_s;
+            double X[3];
+            X[0] = cos(omegatau) * sat[0] - sin(omegatau) * sat[1];
+            X[1] = sin(omegatau) * sat[0] + cos(omegatau) * sat[1];
+            X[2] = sat[2];
+            double trop = 0.0;
+            pvt.tropo(&trop, (rx[0] * los[0] + rx[1] * los[1] + rx[2] * los[2]) / (range * sqrt(rx[0] * rx[0] + rx[1] * rx[1] + rx[2] * rx[2])),
+                    0.08, 1013.0, 293.0, 50.0, 0.0, 0.0, 0.0);
+            const double obs = range + LS_PVT_TEST_CLOCK_M + LS_PVT_TEST_DRIFT_M_S * t + trop + sigma_m * noise(generator);
+            const double range_rate = -(vel[0] * los[0] + vel[1] * los[1] + vel[2] * los[2]) / range
+                    + LS_PVT_TEST_DRIFT_M_S + sigma_m_s * noise(generator);
+            pvt.add_observation(X, zero, obs, range_rate, 1.0, 0);
+        }
+}
+
+
+static double ls_pvt_test_error(const arma::vec::fixed<LS_PVT_MAX_UNKNOWNS> & pos, const double * rx)
+{
+    return sqrt((pos(0) - rx[0]) * (pos(0) - rx[0]) + (pos(1) - rx[1]) * (pos(1) - rx[1]) + (pos(2) - rx[2]) * (pos(2) - rx[2]));
+}
+
+
+TEST(LsPvtTest, KalmanFilterConvergesOnAMovingReceiver)
+{
+    double rx[3];
+    double satpos[3 * LS_PVT_TEST_MAX_SATELLITES];
+    double obs[LS_PVT_TEST_MAX_SATELLITES];
+    const double az_deg[1] = {0.0};
+    const double el_deg[1] = {90.0};
+    const double noise[1] = {0.0};
+    ls_pvt_test_geometry(az_deg, el_deg, noise, 1, rx, satpos, obs);
+    const double vel[3] = {-12.0, 15.0, 4.0};
+    const double rx0[3] = {rx[0], rx[1], rx[2]};
+
+    Ls_Pvt kf(LS_PVT_TEST_MAX_SATELLITES);
+    Ls_Pvt ls(LS_PVT_TEST_MAX_SATELLITES);
+    kf.set_kalman_filter(true);
+    ASSERT_TRUE(kf.kalman_filter());
+    std::mt19937 kf_generator(2016);
+    std::mt19937 ls_generator(2016);
+    double kf_error2 = 0.0;
+    double ls_error2 = 0.0;
+    int n = 0;
+    for (int epoch = 0; epoch < 120; epoch++)
+        {
+            const double t = epoch;
+            for (int j = 0; j < 3; j++)
+                {
+                    rx[j] = rx0[j] + vel[j] * t;
+                }
+            ls_pvt_test_moving_epoch(kf, rx, vel, t, kf_generator, 3.0, 0.1);
+            ls_pvt_test_moving_epoch(ls, rx, vel, t, ls_generator, 3.0, 0.1);
+            arma::vec::fixed<LS_PVT_MAX_UNKNOWNS> kf_pos = kf.solvePosition(t);
+            arma::vec::fixed<LS_PVT_MAX_UNKNOWNS> ls_pos = ls.leastSquarePos();
+            if (epoch == 0)
+                {
+                    // the filter starts from the Least Squares fix
+                    for (int j = 0; j < 4; j++)
+                        {
+                            EXPECT_NEAR(ls_pos(j), kf_pos(j), 1e-6);
+                        }
+                }
+            if (epoch >= 60)
+                {
+                    kf_error2 += ls_pvt_test_error(kf_pos, rx) * ls_pvt_test_error(kf_pos, rx);
+                    ls_error2 += ls_pvt_test_error(ls_pos, rx) * ls_pvt_test_error(ls_pos, rx);
+                    n++;
+                    EXPECT_NEAR(LS_PVT_TEST_CLOCK_M + LS_PVT_TEST_DRIFT_M_S * t, kf_pos(3), 5.0);
+                }
+        }
+    // the filter averages the noise of the pseudoranges over several epochs
+    const double kf_rms = sqrt(kf_error2 / n);
+    const double ls_rms = sqrt(ls_error2 / n);
+    EXPECT_LT(kf_rms, 0.5 * ls_rms);
+    EXPECT_LT(kf_rms, 3.0);
+
+    arma::vec::fixed<4> kf_vel = kf.kalmanVel();
+    for (int j = 0; j < 3; j++)
+        {
+            EXPECT_NEAR(vel[j], kf_vel(j), 0.2);
+        }
+    EXPECT_NEAR(LS_PVT_TEST_DRIFT_M_S, kf_vel(3), 0.2);
+}
+
+
+TEST(LsPvtTest, KalmanFilterRestarts)
+{
+    double rx[3];
+    double satpos[3 * LS_PVT_TEST_MAX_SATELLITES];
+    double obs[LS_PVT_TEST_MAX_SATELLITES];
+    const double az_deg[1] = {0.0};
+    const double el_deg[1] = {90.0};
+    const double noise[1] = {0.0};
+    ls_pvt_test_geometry(az_deg, el_deg, noise, 1, rx, satpos, obs);
+    const double vel[3] = {-12.0, 15.0, 4.0};
+    const double rx0[3] = {rx[0], rx[1], rx[2]};
+
+    Ls_Pvt kf(LS_PVT_TEST_MAX_SATELLITES);
+    Ls_Pvt ls(LS_PVT_TEST_MAX_SATELLITES);
+    kf.set_kalman_filter(true);
+    std::mt19937 kf_generator(2016);
+    std::mt19937 ls_generator(2016);
+    double t = 0.0;
+    arma::vec::fixed<LS_PVT_MAX_UNKNOWNS> kf_pos;
+    arma::vec::fixed<LS_PVT_MAX_UNKNOWNS> ls_pos;
+    for (int epoch = 0; epoch < 20; epoch++)
+        {
+            t = epoch;
+            for (int j = 0; j < 3; j++)
+                {
+                    rx[j] = rx0[j] + vel[j] * t;
+                }
+            ls_pvt_test_moving_epoch(kf, rx, vel, t, kf_generator, 3.0, 0.1);
+            ls_pvt_test_moving_epoch(ls, rx, vel, t, ls_generator, 3.0, 0.1);
+            kf_pos = kf.solvePosition(t);
+            ls_pos = ls.leastSquarePos();
+        }
+    // filtered, not the fix of the epoch
+    EXPECT_GT(ls_pvt_test_error(kf_pos, ls_pos.memptr()), 0.01);
+
+    // a gap longer than LS_PVT_KF_MAX_GAP_S, in which the receiver stopped
+    // 200 m away: the filter restarts from the Least Squares fix
+    t += LS_PVT_KF_MAX_GAP_S + 5.0;
+    const double still[3] = {0.0, 0.0, 0.0};
+    rx[0] += 200.0;
+    ls_pvt_test_moving_epoch(kf, rx, still, t, kf_generator, 3.0, 0.1);
+    ls_pvt_test_moving_epoch(ls, rx, still, t, ls_generator, 3.0, 0.1);
+    kf_pos = kf.solvePosition(t);
+    ls_pos = ls.leastSquarePos();
+    for (int j = 0; j < 4; j++)
+        {
+            EXPECT_NEAR(ls_pos(j), kf_pos(j), 1e-3);
+        }
+    arma::vec::fixed<4> kf_vel = kf.kalmanVel();
+    for (int j = 0; j < 3; j++)
+        {
+            EXPECT_NEAR(0.0, kf_vel(j), 0.5);
+        }
+
+    // a jump of the receiver between two epochs fails the innovation test of
+    // most observations, and the filter also restarts
+    t += 1.0;
+    rx[1] += 500.0;
+    ls_pvt_test_moving_epoch(kf, rx, still, t, kf_generator, 3.0, 0.1);
+    ls_pvt_test_moving_epoch(ls, rx, still, t, ls_generator, 3.0, 0.1);
+    kf_pos = kf.solvePosition(t);
+    ls_pos = ls.leastSquarePos();
+    for (int j = 0; j < 4; j++)
+        {
+            EXPECT_NEAR(ls_pos(j), kf_pos(j), 1e-3);
+        }
+
+    // and so does it after reset_kalman_filter(), or when the time goes back
+    t += 1.0;
+    ls_pvt_test_moving_epoch(kf, rx, still, t, kf_generator, 3.0, 0.1);
+    ls_pvt_test_moving_epoch(ls, rx, still, t, ls_generator, 3.0, 0.1);
+    EXPECT_GT(ls_pvt_test_error(kf.solvePosition(t), ls.leastSquarePos().memptr()), 0.01);
+    kf.reset_kalman_filter();
+    ls_pvt_test_moving_epoch(kf, rx, still, t + 1.0, kf_generator, 3.0, 0.1);
+    ls_pvt_test_moving_epoch(ls, rx, still, t + 1.0, ls_generator, 3.0, 0.1);
+    EXPECT_LT(ls_pvt_test_error(kf.solvePosition(t + 1.0), ls.leastSquarePos().memptr()), 1e-3);
+    ls_pvt_test_moving_epoch(kf, rx, still, t, kf_generator, 3.0, 0.1);
+    ls_pvt_test_moving_epoch(ls, rx, still, t, ls_generator, 3.0, 0.1);
+    EXPECT_LT(ls_pvt_test_error(kf.solvePosition(t), ls.leastSquarePos().memptr()), 1e-3);
+}
@@ -0,0 +1,93 @@
+/*!
+ * \file memory_accounting_test.cc
+ * \brief Tests of the memory accounted to the blocks
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <string>
+#include <vector>
+#include "gnss_sdr_memory_accounting.h"
+
+
+TEST(Memory_Accounting_test, NothingWhenDisabled)
+{
+    Gnss_Sdr_Memory_Accounting::reset();
+    Gnss_Sdr_Memory_Accounting::enable(false);
+    void * buffer = gnss_sdr_volk_malloc(4096, 32);
+    ASSERT_TRUE(buffer != nullptr);
+    Gnss_Sdr_Memory_Accounting::add_fft(1024);
+    gnss_sdr_volk_free(buffer);
+    EXPECT_TRUE(Gnss_Sdr_Memory_Accounting::owners().empty());
+}
+
+
+TEST(Memory_Accounting_test, AccountsToTheScopes)
+{
+    Gnss_Sdr_Memory_Accounting::reset();
+    Gnss_Sdr_Memory_Accounting::enable(true);
+    void * grid = nullptr;
+    void * replica = nullptr;
+    {
+        Gnss_Sdr_Memory_Accounting::Scope channel("Channel3");
+        {
+            Gnss_Sdr_Memory_Accounting::Scope acquisition("Acquisition_1C");
+            EXPECT_EQ("Channel3/Acquisition_1C", Gnss_Sdr_Memory_Accounting::current_owner());
+            grid = gnss_sdr_volk_gnsssdr_malloc(1 << 20, 32);
+            Gnss_Sdr_Memory_Accounting::add_fft(4096, 2);
+        }
+        Gnss_Sdr_Memory_Accounting::Scope tracking("Tracking_1C");
+        replica = gnss_sdr_volk_malloc(8192, 32);
+    }
+    Gnss_Sdr_Memory_Accounting::set_buffers("Channel3/Tracking_1C", 65536);
+
+    std::vector<Gnss_Sdr_Memory_Accounting::Owner_Memory> owners = Gnss_Sdr_Memory_Accounting::owners();
+    ASSERT_EQ(2u, owners.size());
+    // the most memory first
+    EXPECT_EQ("Channel3/Acquisition_1C", owners[0].owner);
+    EXPECT_EQ(1u << 20, owners[0].bytes[Gnss_Sdr_Memory_Accounting::volk]);
+    EXPECT_EQ(1u, owners[0].allocations);
+    EXPECT_EQ(2u * 2u * 4096u * 8u, owners[0].bytes[Gnss_Sdr_Memory_Accounting::fft]);
+    EXPECT_EQ("Channel3/Tracking_1C", owners[1].owner);
+    EXPECT_EQ(8192u, owners[1].bytes[Gnss_Sdr_Memory_Accounting::volk]);
+    EXPECT_EQ(65536u, owners[1].bytes[Gnss_Sdr_Memory_Accounting::buffer]);
+
+    std::vector<std::string> lines = Gnss_Sdr_Memory_Accounting::summary();
+    ASSERT_EQ(3u, lines.size());
+    EXPECT_EQ(0u, lines[0].find("Channel3/Acquisition_1C: 1.1 MiB"));
+    EXPECT_EQ(0u, lines[2].find("all the blocks: "));
+    std::string text = Gnss_Sdr_Memory_Accounting::prometheus_text();
+    EXPECT_NE(std::string::npos, text.find("gnss_sdr_block_memory_bytes{block=\"Channel3/Tracking_1C\",kind=\"buffer\"} 65536\n"));
+
+    // freed buffers are no longer accounted
+    gnss_sdr_volk_gnsssdr_free(grid);
+    gnss_sdr_volk_free(replica);
+    owners = Gnss_Sdr_Memory_Accounting::owners();
+    EXPECT_EQ(0u, Gnss_Sdr_Memory_Accounting::total_bytes(Gnss_Sdr_Memory_Accounting::volk));
+    for (unsigned int i = 0; i < owners.size(); i++) EXPECT_EQ(0u, owners[i].allocations);
+    Gnss_Sdr_Memory_Accounting::enable(false);
+    Gnss_Sdr_Memory_Accounting::reset();
+}
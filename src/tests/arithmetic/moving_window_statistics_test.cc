@@ -0,0 +1,97 @@
+/*!
+ * \file moving_window_statistics_test.cc
+ * \brief Tests of the constant-time window mean and covariance
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <deque>
+#include <random>
+#include "moving_window_statistics.h"
+
+
+TEST(Moving_Window_Statistics_test, MatchesDirectSums)
+{
+    const unsigned int depth = 50;
+    Moving_Window_Statistics window(2, depth);
+    std::deque<double> x;
+    std::deque<double> y;
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> value(-10.0, 10.0);
+    for (unsigned int n = 0; n < 500; n++)
+        {
+            const double sample[2] = {value(gen), 2.0 * value(gen) + 1.0};
+            window.push(sample);
+            x.push_back(sample[0]);
+            y.push_back(sample[1]);
+            if (x.size() > depth)
+                {
+                    x.pop_front();
+                    y.pop_front();
+                }
+            ASSERT_EQ(x.size(), window.size());
+        }
+    EXPECT_TRUE(window.full());
+    double mean_x = 0.0;
+    double mean_y = 0.0;
+    for (unsigned int i = 0; i < depth; i++)
+        {
+            mean_x += x[i] / depth;
+            mean_y += y[i] / depth;
+        }
+    double cov_xx = 0.0;
+    double cov_xy = 0.0;
+    for (unsigned int i = 0; i < depth; i++)
+        {
+            cov_xx += (x[i] - mean_x) * (x[i] - mean_x) / (depth - 1);
+            cov_xy += (x[i] - mean_x) * (y[i] - mean_y) / (depth - 1);
+        }
+    EXPECT_NEAR(mean_x, window.mean(0), 1e-12);
+    EXPECT_NEAR(mean_y, window.mean(1), 1e-12);
+    EXPECT_NEAR(cov_xx, window.covariance(0, 0), 1e-10);
+    EXPECT_NEAR(cov_xy, window.covariance(1, 0), 1e-10);
+}
+
+
+TEST(Moving_Window_Statistics_test, EcefCentimeterNoiseOverLongRun)
+{
+    // ECEF coordinates of some 10^6 m with 1 cm of noise, one million epochs
+    const double position[3] = {4789031.0, 176612.0, 4195018.0};
+    Moving_Window_Statistics window(3, 100);
+    std::mt19937 gen(5);
+    std::normal_distribution<double> noise(0.0, 0.01);
+    for (unsigned int n = 0; n < 1000000; n++)
+        {
+            const double sample[3] = {position[0] + noise(gen), position[1] + noise(gen), position[2] + noise(gen)};
+            window.push(sample);
+        }
+    for (unsigned int i = 0; i < 3; i++)
+        {
+            EXPECT_NEAR(position[i], window.mean(i), 0.005);
+            EXPECT_NEAR(1e-4, window.covariance(i, i), 0.5e-4);
+        }
+    EXPECT_NEAR(0.0, window.covariance(0, 2), 0.5e-4);
+}
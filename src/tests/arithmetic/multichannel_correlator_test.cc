@@ -0,0 +1,104 @@
+/*!
+ * \file multichannel_correlator_test.cc
+ * \brief  This file implements tests for the batched multi-channel correlator,
+ *  checking its outputs against cpu_multicorrelator.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <complex>
+#include <cstdlib>
+#include <volk/volk.h>
+#include "cpu_multicorrelator.h"
+#include "multichannel_correlator.h"
+#include "gps_sdr_signal_processing.h"
+#include "GPS_L1_CA.h"
+
+
+TEST(Multichannel_correlator_test, MatchesSingleChannelCorrelator)
+{
+    const int n_channels = 4;
+    const int n_taps = 3;
+    const int signal_length = 4000; // not a multiple of the block length
+    const int code_length = static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS);
+
+    gr_complex* in = static_cast<gr_complex*>(volk_malloc(signal_length * sizeof(gr_complex), volk_get_alignment()));
+    for (int n = 0; n < signal_length; n++)
+        {
+            in[n] = gr_complex(static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5,
+                               static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5);
+        }
+    float shifts[n_taps] = { -0.5, 0.0, 0.5 };
+
+    std::vector<gr_complex*> codes(n_channels);
+    gr_complex* batched_out = static_cast<gr_complex*>(volk_malloc(n_channels * n_taps * sizeof(gr_complex), volk_get_alignment()));
+    gr_complex* reference_out = static_cast<gr_complex*>(volk_malloc(n_taps * sizeof(gr_complex), volk_get_alignment()));
+
+    multichannel_correlator batched;
+    ASSERT_TRUE(batched.init(n_taps, 1024));
+    for (int ch = 0; ch < n_channels; ch++)
+        {
+            codes[ch] = static_cast<gr_complex*>(volk_malloc(code_length * sizeof(gr_complex), volk_get_alignment()));
+            gps_l1_ca_code_gen_complex(codes[ch], ch + 1, 0);
+            EXPECT_EQ(ch, batched.add_channel(code_length, codes[ch], shifts, n_taps, batched_out + ch * n_taps));
+        }
+    EXPECT_EQ(-1, batched.add_channel(code_length, codes[0], shifts, n_taps + 1, batched_out));
+
+    for (int ch = 0; ch < n_channels; ch++)
+        {
+            // Each channel starts at a different sample with its own NCO state.
+            // Code phases are multiples of 1/8 chip, so that the code indices do
+            // not depend on the rounding of the chip counts.
+            ASSERT_TRUE(batched.submit(ch, in + 10 * ch, 0.3 * ch, 0.05 + 0.01 * ch,
+                    0.125 * ch, 0.25 + 0.125 * ch, signal_length - 10 * ch));
+        }
+    batched.execute();
+
+    cpu_multicorrelator reference;
+    reference.init(signal_length, n_taps);
+    for (int ch = 0; ch < n_channels; ch++)
+        {
+            reference.set_local_code_and_taps(code_length, codes[ch], shifts);
+            reference.set_input_output_vectors(reference_out, in + 10 * ch);
+            reference.Carrier_wipeoff_multicorrelator_resampler(0.3 * ch, 0.05 + 0.01 * ch,
+                    0.125 * ch, 0.25 + 0.125 * ch, signal_length - 10 * ch);
+            for (int n = 0; n < n_taps; n++)
+                {
+                    EXPECT_NEAR(reference_out[n].real(), batched_out[ch * n_taps + n].real(), 1e-3);
+                    EXPECT_NEAR(reference_out[n].imag(), batched_out[ch * n_taps + n].imag(), 1e-3);
+                }
+        }
+    reference.free();
+    batched.free();
+
+    for (int ch = 0; ch < n_channels; ch++)
+        {
+            volk_free(codes[ch]);
+        }
+    volk_free(batched_out);
+    volk_free(reference_out);
+    volk_free(in);
+}
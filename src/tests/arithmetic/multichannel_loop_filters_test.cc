@@ -0,0 +1,97 @@
+/*!
+ * \file multichannel_loop_filters_test.cc
+ * \brief  This file implements tests for the batched multi-channel loop filters,
+ *  checking them against the scalar discriminators and filters.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <complex>
+#include <cstdlib>
+#include <vector>
+#include "multichannel_loop_filters.h"
+#include "tracking_2nd_DLL_filter.h"
+#include "tracking_2nd_PLL_filter.h"
+#include "tracking_discriminators.h"
+#include "GPS_L1_CA.h"
+
+
+TEST(Multichannel_loop_filters_test, MatchesScalarLoops)
+{
+    const int n_channels = 13; // not a multiple of the SIMD width
+    const int n_taps = 3;
+    const int n_epochs = 50;
+
+    std::vector<gr_complex> corr(n_channels * n_taps);
+    std::vector<Tracking_2nd_PLL_filter> pll(n_channels, Tracking_2nd_PLL_filter(0.001));
+    std::vector<Tracking_2nd_DLL_filter> dll(n_channels, Tracking_2nd_DLL_filter(0.001));
+
+    multichannel_loop_filters batched;
+    ASSERT_TRUE(batched.init(n_channels));
+    for (int ch = 0; ch < n_channels; ch++)
+        {
+            EXPECT_EQ(ch, batched.add_channel(corr.data() + ch * n_taps, 0, 1, 2, 0.001));
+            batched.set_pll_bw(ch, 10.0 + ch);
+            batched.set_dll_bw(ch, 1.0 + 0.5 * ch);
+            pll[ch].set_PLL_BW(10.0 + ch);
+            pll[ch].initialize();
+            dll[ch].set_DLL_BW(1.0 + 0.5 * ch);
+            dll[ch].initialize();
+        }
+    EXPECT_EQ(-1, batched.add_channel(corr.data(), 0, 1, 2));
+
+    std::vector<unsigned char> active(n_channels);
+    for (int epoch = 0; epoch < n_epochs; epoch++)
+        {
+            for (int n = 0; n < n_channels * n_taps; n++)
+                {
+                    // Prompts in all four quadrants, including a zero in-phase component
+                    corr[n] = gr_complex(static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5,
+                                         static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5);
+                }
+            corr[1] = gr_complex(0.0, 0.3);
+            for (int ch = 0; ch < n_channels; ch++)
+                {
+                    active[ch] = (epoch + ch) % 3 != 0;
+                }
+            batched.execute(active.data());
+
+            for (int ch = 0; ch < n_channels; ch++)
+                {
+                    if (!active[ch]) continue;
+                    const gr_complex* c = corr.data() + ch * n_taps;
+                    float carr_error_hz = pll_cloop_two_quadrant_atan(c[1]) / GPS_TWO_PI;
+                    float code_error_chips = dll_nc_e_minus_l_normalized(c[0], c[2]);
+                    float carr_error_filt_hz = pll[ch].get_carrier_nco(carr_error_hz);
+                    float code_error_filt_chips = dll[ch].get_code_nco(code_error_chips);
+                    EXPECT_NEAR(carr_error_hz, batched.carrier_error_hz(ch), 1e-4);
+                    EXPECT_NEAR(code_error_chips, batched.code_error_chips(ch), 1e-5);
+                    EXPECT_NEAR(carr_error_filt_hz, batched.carrier_error_filt_hz(ch), 1e-2);
+                    EXPECT_NEAR(code_error_filt_chips, batched.code_error_filt_chips(ch), 1e-3);
+                }
+        }
+    batched.free();
+}
@@ -0,0 +1,69 @@
+/*!
+ * \file nmea_buffer_test.cc
+ * \brief Tests of the fixed-size NMEA sentence buffer
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <string>
+#include "nmea_printer.h"
+
+
+TEST(Nmea_Buffer_test, Checksum)
+{
+    Nmea_Buffer sentence;
+    sentence.begin("$GPGGA,");
+    sentence.append("123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,");
+    sentence.end();
+    EXPECT_EQ("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n",
+            std::string(sentence.data(), sentence.size()));
+}
+
+
+TEST(Nmea_Buffer_test, Fields)
+{
+    Nmea_Buffer sentence;
+    sentence.begin("$GPXXX,");
+    sentence.append_int(7, 2);
+    sentence.append(',');
+    sentence.append_int(-5, 3);
+    sentence.append(',');
+    sentence.append_int(1234, 2);
+    sentence.append(',');
+    sentence.append_fixed(5.12344, 4, 7);
+    sentence.append(',');
+    sentence.append_fixed(1.25, 1, 2);
+    EXPECT_EQ("$GPXXX,07,0-5,1234,05.1234,1.2", std::string(sentence.data(), sentence.size()));
+
+    // What does not fit is dropped
+    sentence.clear();
+    for (unsigned int i = 0; i < NMEA_BUFFER_SIZE + 10; i++)
+        {
+            sentence.append('A');
+        }
+    EXPECT_EQ(static_cast<size_t>(NMEA_BUFFER_SIZE), sentence.size());
+}
@@ -0,0 +1,275 @@
+/*!
+ * \file observables_sync_test.cc
+ * \brief  This file implements tests for the common reception time
+ *  alignment of the observables blocks.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <vector>
+#include <gtest/gtest.h>
+#include "observables_sync.h"
+#include "ring_buffer.h"
+#include "GPS_L1_CA.h"
+
+
+TEST(ObservablesSyncTest, MatchesMapBasedAlignment)
+{
+    const unsigned int nchannels = 70;  // more than one word of the validity mask
+    std::vector<Gnss_Synchro> channels(nchannels);
+    std::vector<Gnss_Synchro*> in(nchannels);
+    observables_sync sync(nchannels, &Gnss_Synchro::d_TOW_at_current_symbol, GPS_STARTOFFSET_ms, GPS_C_m_ms);
+
+    for (int epoch = 0; epoch < 50; epoch++)
+        {
+            std::map<int, Gnss_Synchro> reference;
+            for (unsigned int i = 0; i < nchannels; i++)
+                {
+                    channels[i] = Gnss_Synchro();
+                    channels[i].Channel_ID = i;
+                    channels[i].Flag_valid_word = (rand() % 3) != 0 || i == 69;
+                    channels[i].Flag_valid_pseudorange = true;
+                    channels[i].d_TOW_at_current_symbol = 345600.0 + epoch + 0.001 * (rand() % 20);
+                    channels[i].Prn_timestamp_ms = 1.0e6 + epoch + static_cast<double>(rand()) / static_cast<double>(RAND_MAX);
+                    in[i] = &channels[i];
+                    if (channels[i].Flag_valid_word)
+                        {
+                            reference.insert(std::make_pair(static_cast<int>(i), channels[i]));
+                        }
+                }
+            EXPECT_EQ(reference.size(), sync.load(&in[0]));
+            ASSERT_TRUE(sync.compute_pseudoranges());
+
+            double TOW_reference = 0.0;
+            double ref_PRN_rx_time_ms = 0.0;
+            int reference_channel = -1;
+            for (std::map<int, Gnss_Synchro>::iterator it = reference.begin(); it != reference.end(); it++)
+                {
+                    if (reference_channel < 0 || it->second.d_TOW_at_current_symbol > TOW_reference)
+                        {
+                            reference_channel = it->first;
+                            TOW_reference = it->second.d_TOW_at_current_symbol;
+                            ref_PRN_rx_time_ms = it->second.Prn_timestamp_ms;
+                        }
+                }
+            EXPECT_EQ(reference_channel, sync.reference_channel());
+
+            for (unsigned int i = 0; i < nchannels; i++)
+                {
+                    EXPECT_EQ(channels[i].Flag_valid_word, sync.valid(i));
+                    EXPECT_EQ(channels[i].Flag_valid_word, sync.synchro(i).Flag_valid_pseudorange);
+                    if (!channels[i].Flag_valid_word)
+                        {
+                            EXPECT_EQ(0.0, sync.synchro(i).Pseudorange_m);
+                            continue;
+                        }
+                    double delta_rx_time_ms = channels[i].Prn_timestamp_ms - ref_PRN_rx_time_ms;
+                    double traveltime_ms = (TOW_reference - channels[i].d_TOW_at_current_symbol) * 1000.0 + delta_rx_time_ms + GPS_STARTOFFSET_ms;
+                    EXPECT_DOUBLE_EQ(traveltime_ms * GPS_C_m_ms, sync.synchro(i).Pseudorange_m);
+                    EXPECT_DOUBLE_EQ(round(TOW_reference * 1000.0) / 1000.0 + GPS_STARTOFFSET_ms / 1000.0, sync.synchro(i).d_TOW_at_current_symbol);
+                }
+
+            // the iteration visits exactly the valid channels, in order
+            std::map<int, Gnss_Synchro>::iterator it = reference.begin();
+            for (int ch = sync.first_valid(); ch >= 0; ch = sync.next_valid(ch))
+                {
+                    ASSERT_TRUE(it != reference.end());
+                    EXPECT_EQ(it->first, ch);
+                    it++;
+                }
+            EXPECT_TRUE(it == reference.end());
+        }
+
+    for (unsigned int i = 0; i < nchannels; i++)
+        {
+            channels[i].Flag_valid_word = false;
+        }
+    EXPECT_EQ(0u, sync.load(&in[0]));
+    EXPECT_FALSE(sync.compute_pseudoranges());
+    EXPECT_EQ(-1, sync.first_valid());
+}
+
+
+TEST(ObservablesSyncTest, LinearFit)
+{
+    ring_buffer<double> x(10);
+    ring_buffer<double> y(10);
+    for (int n = 0; n < 15; n++)
+        {
+            x.push_back(345600.0 + 0.02 * n);
+            y.push_back(3.0 - 2.0 * 0.02 * n);
+        }
+    EXPECT_NEAR(3.0 - 2.0 * 0.4, observables_sync::linear_fit(x, y, 345600.4), 1e-6);
+}
+
+
+TEST(ObservablesSyncTest, InterpolatesToReceiverEpochs)
+{
+    // two satellites with different travel times, tracked with unaligned
+    // 1 ms symbols, and one channel without valid word
+    const unsigned int nchannels = 3;
+    const double travel_time_ms[2] = { 72.25, 80.5 };
+    const double phase_ms[2] = { 0.3, 0.85 };
+    const double TOW_0 = 345600.0;
+    std::vector<Gnss_Synchro> channels(nchannels);
+    std::vector<Gnss_Synchro*> in(nchannels);
+    observables_sync sync(nchannels, &Gnss_Synchro::d_TOW_at_current_symbol, GPS_STARTOFFSET_ms, GPS_C_m_ms);
+    sync.set_epoch_rate(10);
+    EXPECT_EQ(10u, sync.epoch_rate());
+
+    int n_epochs = 0;
+    double last_epoch_ms = 0.0;
+    for (int n = 1000; n < 2000; n++)
+        {
+            for (unsigned int i = 0; i < nchannels; i++)
+                {
+                    channels[i] = Gnss_Synchro();
+                    channels[i].Channel_ID = i;
+                    in[i] = &channels[i];
+                    if (i < 2)
+                        {
+                            double rx_time_ms = n + phase_ms[i];
+                            channels[i].Flag_valid_word = true;
+                            channels[i].Prn_timestamp_ms = rx_time_ms;
+                            channels[i].d_TOW_at_current_symbol = TOW_0 + (rx_time_ms - travel_time_ms[i]) / 1000.0;
+                            channels[i].Carrier_phase_rads = 2.0 * rx_time_ms;
+                            channels[i].Carrier_Doppler_hz = 1000.0 + i;
+                        }
+                    else
+                        {
+                            channels[i].Flag_valid_word = false;
+                            channels[i].Prn_timestamp_ms = n;
+                        }
+                }
+            if (sync.load_epoch(&in[0]) == false)
+                {
+                    continue;
+                }
+            double epoch_ms = sync.synchro(0).Prn_timestamp_ms;
+            EXPECT_DOUBLE_EQ(100.0 * round(epoch_ms / 100.0), epoch_ms);
+            if (n_epochs > 0)
+                {
+                    EXPECT_DOUBLE_EQ(100.0, epoch_ms - last_epoch_ms);
+                }
+            last_epoch_ms = epoch_ms;
+            n_epochs++;
+
+            ASSERT_EQ(2u, sync.num_valid());
+            EXPECT_FALSE(sync.valid(2));
+            EXPECT_EQ(0, sync.reference_channel());
+            for (unsigned int i = 0; i < 2; i++)
+                {
+                    double expected_m = (travel_time_ms[i] - travel_time_ms[0] + GPS_STARTOFFSET_ms) * GPS_C_m_ms;
+                    EXPECT_NEAR(expected_m, sync.synchro(i).Pseudorange_m, 0.1);
+                    EXPECT_NEAR(2.0 * epoch_ms, sync.synchro(i).Carrier_phase_rads, 1e-6);
+                    EXPECT_NEAR(1000.0 + i, sync.synchro(i).Carrier_Doppler_hz, 1e-9);
+                    EXPECT_NEAR(TOW_0 + (epoch_ms - travel_time_ms[0] + GPS_STARTOFFSET_ms) / 1000.0,
+                            sync.synchro(i).d_TOW_at_current_symbol, 1e-9);
+                }
+        }
+    EXPECT_EQ(9, n_epochs);  // from 1100 to 1900 ms, the first symbols arrive after 1000 ms
+}
+
+
+TEST(ObservablesSyncTest, SampleStamps)
+{
+    Gnss_Synchro a = Gnss_Synchro();
+    Gnss_Synchro b = Gnss_Synchro();
+    EXPECT_FALSE(a.has_sample_stamp());
+    a.set_sample_stamp(1000, -0.25, 4.0e6);
+    EXPECT_TRUE(a.has_sample_stamp());
+    EXPECT_EQ(999u, a.Tracking_sample_counter);
+    EXPECT_EQ(3 * GNSS_SYNCHRO_STAMP_ONE / 4, a.Tracking_sample_fraction);
+    EXPECT_DOUBLE_EQ(999.75 / 4.0e6, a.Tracking_timestamp_secs);
+    b.set_sample_stamp(998, 1.5, 4.0e6);
+    EXPECT_EQ(GNSS_SYNCHRO_STAMP_ONE / 4, a.sample_stamp_difference(b));
+    EXPECT_EQ(-GNSS_SYNCHRO_STAMP_ONE / 4, b.sample_stamp_difference(a));
+    // a fraction that rounds to a whole sample
+    a.set_sample_stamp(1000, 0.9999999, 4.0e6);
+    EXPECT_EQ(1001u, a.Tracking_sample_counter);
+    EXPECT_EQ(0u, a.Tracking_sample_fraction);
+}
+
+
+TEST(ObservablesSyncTest, InterpolatesWithSampleStamps)
+{
+    // as InterpolatesToReceiverEpochs, three days after the start of the
+    // run, with the PRN starts given as sample stamps
+    const unsigned int nchannels = 2;
+    const uint64_t fs_hz = 4000000;
+    const uint64_t samples_per_ms = fs_hz / 1000;
+    const uint64_t start_ms = 3ULL * 86400000ULL;
+    const double travel_time_ms[2] = { 72.25, 80.5 };
+    const double phase_samples[2] = { 1200.0, 3400.37 };
+    const double TOW_0 = 345600.0;
+    std::vector<Gnss_Synchro> channels(nchannels);
+    std::vector<Gnss_Synchro*> in(nchannels);
+    observables_sync sync(nchannels, &Gnss_Synchro::d_TOW_at_current_symbol, GPS_STARTOFFSET_ms, GPS_C_m_ms);
+    sync.set_epoch_rate(10);
+    sync.set_sample_rate(fs_hz);
+
+    int n_epochs = 0;
+    for (uint64_t n = 1000; n < 2000; n++)
+        {
+            for (unsigned int i = 0; i < nchannels; i++)
+                {
+                    channels[i] = Gnss_Synchro();
+                    channels[i].Channel_ID = i;
+                    channels[i].Flag_valid_word = true;
+                    channels[i].set_sample_stamp((start_ms + n) * samples_per_ms, phase_samples[i], static_cast<double>(fs_hz));
+                    channels[i].Prn_timestamp_ms = channels[i].Tracking_timestamp_secs * 1000.0;
+                    // time since the start of the run, without the rounding of Prn_timestamp_ms
+                    const double rx_time_ms = static_cast<double>(n) + phase_samples[i] / static_cast<double>(samples_per_ms);
+                    channels[i].d_TOW_at_current_symbol = TOW_0 + (rx_time_ms - travel_time_ms[i]) / 1000.0;
+                    channels[i].Carrier_phase_rads = 2.0 * rx_time_ms;
+                    channels[i].Carrier_Doppler_hz = 1000.0 + i;
+                    in[i] = &channels[i];
+                }
+            if (sync.load_epoch(&in[0]) == false)
+                {
+                    continue;
+                }
+            const double epoch_ms = sync.synchro(0).Prn_timestamp_ms - static_cast<double>(start_ms);
+            EXPECT_DOUBLE_EQ(100.0 * round(epoch_ms / 100.0), epoch_ms);
+            n_epochs++;
+
+            ASSERT_EQ(2u, sync.num_valid());
+            EXPECT_EQ(0, sync.reference_channel());
+            for (unsigned int i = 0; i < 2; i++)
+                {
+                    const double expected_m = (travel_time_ms[i] - travel_time_ms[0] + GPS_STARTOFFSET_ms) * GPS_C_m_ms;
+                    EXPECT_NEAR(expected_m, sync.synchro(i).Pseudorange_m, 0.05);
+                    EXPECT_NEAR(2.0 * epoch_ms, sync.synchro(i).Carrier_phase_rads, 1e-6);
+                    EXPECT_NEAR(TOW_0 + (epoch_ms - travel_time_ms[0] + GPS_STARTOFFSET_ms) / 1000.0,
+                            sync.synchro(i).d_TOW_at_current_symbol, 1e-9);
+                }
+        }
+    EXPECT_EQ(9, n_epochs);
+}
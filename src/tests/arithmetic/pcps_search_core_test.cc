@@ -0,0 +1,217 @@
+/*!
+ * \file pcps_search_core_test.cc
+ * \brief Tests of the PCPS search shared by the acquisition blocks
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <vector>
+#include "pcps_search_core.h"
+#include "doppler_grid_store.h"
+
+namespace
+{
+const unsigned int SEARCH_CORE_TEST_CODE = 64;
+const long SEARCH_CORE_TEST_FS = 64000;
+
+// Random +/-1 chips, one sample per chip
+std::vector<std::complex<float>> search_core_test_code()
+{
+    std::vector<std::complex<float>> code(SEARCH_CORE_TEST_CODE);
+    unsigned int state = 12345;
+    for (unsigned int i = 0; i < code.size(); i++)
+        {
+            state = state * 1103515245 + 12345;
+            code[i] = std::complex<float>((state >> 16) & 1 ? 1.0 : -1.0, 0.0);
+        }
+    return code;
+}
+
+// length samples of the code delayed by delay samples, on a carrier of
+// doppler_hz, with the sign of the data flipping at sample flip
+std::vector<std::complex<int8_t>> search_core_test_signal(unsigned int length, unsigned int delay,
+        double doppler_hz, float amplitude, float noise, unsigned int flip)
+{
+    const std::vector<std::complex<float>> code = search_core_test_code();
+    std::vector<std::complex<int8_t>> signal(length);
+    unsigned int state = 777;
+    for (unsigned int i = 0; i < length; i++)
+        {
+            const double phase = 2.0 * M_PI * doppler_hz * i / static_cast<double>(SEARCH_CORE_TEST_FS);
+            const float sign = i < flip ? 1.0 : -1.0;
+            std::complex<float> s = sign * amplitude * code[(i + SEARCH_CORE_TEST_CODE - delay) % SEARCH_CORE_TEST_CODE]
+                    * std::complex<float>(std::cos(phase), std::sin(phase));
+            state = state * 1103515245 + 12345;
+            s += std::complex<float>(noise * (static_cast<int>((state >> 16) % 7) - 3), 0.0);
+            signal[i] = std::complex<int8_t>(static_cast<int8_t>(std::round(s.real())), static_cast<int8_t>(std::round(s.imag())));
+        }
+    return signal;
+}
+}
+
+
+TEST(PcpsSearchCoreTest, SampleTypesFindTheSamePeak)
+{
+    const std::vector<std::complex<float>> code = search_core_test_code();
+    const std::vector<std::complex<int8_t>> in_8 = search_core_test_signal(SEARCH_CORE_TEST_CODE, 13, 1000.0, 20.0, 2.0, SEARCH_CORE_TEST_CODE);
+    std::vector<std::complex<int16_t>> in_16;
+    std::vector<std::complex<float>> in_32;
+    for (unsigned int i = 0; i < in_8.size(); i++)
+        {
+            in_16.push_back(std::complex<int16_t>(in_8[i].real(), in_8[i].imag()));
+            in_32.push_back(std::complex<float>(in_8[i].real(), in_8[i].imag()));
+        }
+
+    // Bins of 500 Hz from -2000 Hz: 1000 Hz is bin 6
+    Doppler_Grid grid(SEARCH_CORE_TEST_FS, 0, SEARCH_CORE_TEST_CODE, 2000, 500, 9);
+    Pcps_Search_Core core(SEARCH_CORE_TEST_CODE, SEARCH_CORE_TEST_CODE, false);
+    core.set_local_code(code.data());
+
+    const Pcps_Search_Result r_8 = core.search<Pcps_Peak_To_Floor_Detector>(in_8.data(), grid);
+    const Pcps_Search_Result r_16 = core.search<Pcps_Peak_To_Floor_Detector>(in_16.data(), grid);
+    const Pcps_Search_Result r_32 = core.search<Pcps_Peak_To_Floor_Detector>(in_32.data(), grid);
+
+    EXPECT_EQ(6u, r_32.doppler_index);
+    EXPECT_EQ(13u, r_32.delay_samples);
+    EXPECT_GT(r_32.test_statistic, 10.0);
+    EXPECT_EQ(r_32.doppler_index, r_8.doppler_index);
+    EXPECT_EQ(r_32.delay_samples, r_8.delay_samples);
+    EXPECT_FLOAT_EQ(r_32.test_statistic, r_8.test_statistic);
+    EXPECT_EQ(r_32.doppler_index, r_16.doppler_index);
+    EXPECT_EQ(r_32.delay_samples, r_16.delay_samples);
+    EXPECT_FLOAT_EQ(r_32.test_statistic, r_16.test_statistic);
+}
+
+
+TEST(PcpsSearchCoreTest, DetectorStatistics)
+{
+    const std::vector<std::complex<float>> code = search_core_test_code();
+    const std::vector<std::complex<int8_t>> in = search_core_test_signal(SEARCH_CORE_TEST_CODE, 0, 0.0, 10.0, 0.0, SEARCH_CORE_TEST_CODE);
+    Doppler_Grid grid(SEARCH_CORE_TEST_FS, 0, SEARCH_CORE_TEST_CODE, 1000, 500, 5);
+    Pcps_Search_Core core(SEARCH_CORE_TEST_CODE, SEARCH_CORE_TEST_CODE, false);
+    core.set_local_code(code.data());
+
+    // Without noise, the normalized peak of the Doppler bin is the input power
+    const Pcps_Search_Result cfar = core.search<Pcps_Cfar_Detector>(in.data(), grid);
+    EXPECT_EQ(2u, cfar.doppler_index);
+    EXPECT_EQ(0u, cfar.delay_samples);
+    EXPECT_NEAR(100.0, core.input_power(), 1e-3);
+    EXPECT_NEAR(100.0, cfar.magnitude, 1e-2);
+    EXPECT_NEAR(1.0, cfar.test_statistic, 1e-4);
+
+    // The floor is the mean of the other delays of the peak bin
+    std::vector<float> magnitude;
+    struct Recorder
+    {
+        std::vector<float>* magnitude;
+        void operator()(unsigned int doppler_index, const std::complex<float>* correlation)
+        {
+            if (doppler_index != 2) return;
+            for (unsigned int i = 0; i < SEARCH_CORE_TEST_CODE; i++) magnitude->push_back(std::norm(correlation[i]));
+        }
+    } recorder = { &magnitude };
+    const Pcps_Search_Result floor = core.search<Pcps_Peak_To_Floor_Detector>(in.data(), grid, recorder);
+    ASSERT_EQ(SEARCH_CORE_TEST_CODE, magnitude.size());
+    double sum = 0.0;
+    for (unsigned int i = 1; i < magnitude.size(); i++) sum += magnitude[i];
+    EXPECT_FLOAT_EQ(magnitude[0], floor.magnitude);
+    EXPECT_NEAR(sum / (SEARCH_CORE_TEST_CODE - 1), floor.noise_power, 1e-3 * floor.noise_power);
+}
+
+
+TEST(PcpsSearchCoreTest, BitTransitionSearchesTheLinearCorrelation)
+{
+    // Two code periods with a data bit transition inside the first one
+    const std::vector<std::complex<float>> code = search_core_test_code();
+    const std::vector<std::complex<int8_t>> in = search_core_test_signal(2 * SEARCH_CORE_TEST_CODE, 40, -500.0, 20.0, 1.0, 40);
+    Doppler_Grid grid(SEARCH_CORE_TEST_FS, 0, 2 * SEARCH_CORE_TEST_CODE, 1000, 500, 5);
+    Pcps_Search_Core core(SEARCH_CORE_TEST_CODE, 2 * SEARCH_CORE_TEST_CODE, true);
+    core.set_local_code(code.data());
+    EXPECT_EQ(SEARCH_CORE_TEST_CODE, core.window());
+
+    const Pcps_Search_Result r = core.search<Pcps_Peak_To_Floor_Detector>(in.data(), grid);
+    EXPECT_EQ(1u, r.doppler_index);
+    EXPECT_EQ(40u, r.delay_samples % SEARCH_CORE_TEST_CODE);
+    EXPECT_GT(r.test_statistic, 10.0);
+}
+
+
+TEST(PcpsSearchCoreTest, PilotCombinesWhateverTheDataSign)
+{
+    // Data code on the in-phase component and pilot code, orthogonal to it,
+    // on the quadrature one, each of amplitude 10
+    const std::vector<std::complex<float>> code = search_core_test_code();
+    std::vector<std::complex<float>> pilot(SEARCH_CORE_TEST_CODE);
+    for (unsigned int i = 0; i < SEARCH_CORE_TEST_CODE; i++)
+        {
+            pilot[i] = (i % 2 == 0) ? code[i] : -code[i];
+        }
+    Doppler_Grid grid(SEARCH_CORE_TEST_FS, 0, SEARCH_CORE_TEST_CODE, 1000, 500, 5);
+    Pcps_Search_Core core(SEARCH_CORE_TEST_CODE, SEARCH_CORE_TEST_CODE, false);
+    core.set_local_code(code.data());
+    core.set_pilot_code(pilot.data());
+    Pcps_Search_Core data_only(SEARCH_CORE_TEST_CODE, SEARCH_CORE_TEST_CODE, false);
+    data_only.set_local_code(code.data());
+
+    // The observers see the magnitudes of the combined correlations
+    struct Recorder
+    {
+        const Pcps_Search_Core* core;
+        float peak;
+        void operator()(unsigned int doppler_index, const std::complex<float>* /*correlation*/)
+        {
+            if (doppler_index == 3) peak = core->magnitude()[21];
+        }
+    };
+
+    for (int sign = -1; sign <= 1; sign += 2)
+        {
+            std::vector<std::complex<float>> in(SEARCH_CORE_TEST_CODE);
+            for (unsigned int i = 0; i < SEARCH_CORE_TEST_CODE; i++)
+                {
+                    const unsigned int k = (i + SEARCH_CORE_TEST_CODE - 21) % SEARCH_CORE_TEST_CODE;
+                    const double phase = 2.0 * M_PI * 500.0 * i / static_cast<double>(SEARCH_CORE_TEST_FS);
+                    in[i] = 10.0f * (static_cast<float>(sign) * code[k] + std::complex<float>(0.0, 1.0) * pilot[k])
+                            * std::complex<float>(std::cos(phase), std::sin(phase));
+                }
+
+            // Both components add up: 4 times the power of one, over twice its power
+            Recorder recorder = { &core, 0.0 };
+            const Pcps_Search_Result r = core.search<Pcps_Cfar_Detector>(in.data(), grid, recorder);
+            EXPECT_EQ(3u, r.doppler_index);
+            EXPECT_EQ(21u, r.delay_samples);
+            EXPECT_NEAR(200.0, core.input_power(), 1e-2);
+            EXPECT_NEAR(2.0, r.test_statistic, 1e-3);
+            EXPECT_FLOAT_EQ(r.magnitude, Pcps_Cfar_Detector::peak(recorder.peak, SEARCH_CORE_TEST_CODE));
+
+            const Pcps_Search_Result d = data_only.search<Pcps_Cfar_Detector>(in.data(), grid);
+            EXPECT_EQ(21u, d.delay_samples);
+            EXPECT_NEAR(0.5, d.test_statistic, 1e-3);
+        }
+}
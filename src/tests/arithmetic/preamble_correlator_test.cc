@@ -0,0 +1,89 @@
+/*!
+ * \file preamble_correlator_test.cc
+ * \brief  This file implements tests for the sliding preamble correlator
+ *  of the telemetry decoders.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstdlib>
+#include <vector>
+#include <gtest/gtest.h>
+#include "preamble_correlator.h"
+#include "GPS_L1_CA.h"
+
+
+TEST(PreambleCorrelatorTest, MatchesDirectCorrelation)
+{
+    const int symbols_per_bit = GPS_CA_TELEMETRY_SYMBOLS_PER_BIT;
+    const int length = GPS_CA_PREAMBLE_LENGTH_BITS * symbols_per_bit;
+    unsigned short int preamble_bits[GPS_CA_PREAMBLE_LENGTH_BITS] = GPS_PREAMBLE;
+    Preamble_Correlator correlator(preamble_bits, GPS_CA_PREAMBLE_LENGTH_BITS, symbols_per_bit);
+    EXPECT_EQ(length, correlator.length());
+
+    // random symbols with the preamble, inverted, in the middle of the stream
+    const int n_symbols = 10 * length;
+    const int preamble_start = 4 * length + 7;
+    std::vector<double> symbols(n_symbols);
+    for (int n = 0; n < n_symbols; n++)
+        {
+            symbols[n] = static_cast<double>(rand()) / static_cast<double>(RAND_MAX) - 0.5;
+        }
+    for (int n = 0; n < length; n++)
+        {
+            symbols[preamble_start + n] = (preamble_bits[n / symbols_per_bit] == 1) ? -0.3 : 0.3;
+        }
+
+    for (int n = 0; n < n_symbols; n++)
+        {
+            correlator.push_symbol(symbols[n]);
+            if (n < length - 1) continue;
+            int corr_value = 0;
+            for (int i = 0; i < length; i++)
+                {
+                    int preamble_symbol = (preamble_bits[i / symbols_per_bit] == 1) ? 1 : -1;
+                    corr_value += (symbols[n - length + 1 + i] < 0) ? -preamble_symbol : preamble_symbol;
+                }
+            ASSERT_EQ(corr_value, correlator.correlation());
+            if (n == preamble_start + length - 1)
+                {
+                    EXPECT_EQ(-length, correlator.correlation());
+                }
+        }
+    EXPECT_EQ(static_cast<unsigned long int>(n_symbols), correlator.symbols_pushed());
+
+    // a symbol spanning a whole bit counts as the 20 symbols of a 1 ms integration
+    correlator.reset();
+    for (int i = 0; i < GPS_CA_PREAMBLE_LENGTH_BITS; i++)
+        {
+            for (int j = 0; j < symbols_per_bit - 1; j++)
+                {
+                    correlator.push_erasure();
+                }
+            correlator.push_symbol((preamble_bits[i] == 1) ? 1.0 : -1.0, symbols_per_bit);
+        }
+    EXPECT_EQ(length, correlator.correlation());
+}
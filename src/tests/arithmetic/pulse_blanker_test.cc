@@ -0,0 +1,136 @@
+/*!
+ * \file pulse_blanker_test.cc
+ * \brief Tests of the pulse blanker and the adaptive notch filter
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <vector>
+#include "pulse_blanker.h"
+
+
+namespace
+{
+std::complex<float> noise_sample()
+{
+    return std::complex<float>(static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5,
+                               static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5);
+}
+}
+
+
+TEST(Pulse_Blanker_test, BlanksPulsesAndGuards)
+{
+    const unsigned int n = 10000;
+    const unsigned int guard = 4;
+    const unsigned int pulse_length = 10;
+    std::vector<std::complex<float>> in(n);
+    for (unsigned int i = 0; i < n; i++)
+        {
+            in[i] = noise_sample();
+        }
+    // Three pulses, the last one across the boundary of the two calls
+    const unsigned int starts[3] = { 1000, 4000, 4995 };
+    for (unsigned int p = 0; p < 3; p++)
+        {
+            for (unsigned int i = starts[p]; i < starts[p] + pulse_length; i++)
+                {
+                    in[i] = std::complex<float>(20.0, 0.0);
+                }
+        }
+
+    Pulse_Blanker blanker(true, 10.0, guard, false, 0.0, 0.9);
+    std::vector<std::complex<float>> out(n);
+    blanker.process(in.data(), out.data(), n / 2);
+    blanker.process(in.data() + n / 2, out.data() + n / 2, n / 2);
+
+    EXPECT_EQ(n, blanker.samples());
+    EXPECT_EQ(3u, blanker.pulses());
+    // The guard before the last pulse is in the same call as the pulse
+    EXPECT_EQ(3u * (pulse_length + 2 * guard), blanker.blanked_samples());
+    for (unsigned int p = 0; p < 3; p++)
+        {
+            for (unsigned int i = starts[p] - guard; i < starts[p] + pulse_length + guard; i++)
+                {
+                    EXPECT_EQ(std::complex<float>(0.0, 0.0), out[i]);
+                }
+        }
+    EXPECT_EQ(in[starts[0] - guard - 1], out[starts[0] - guard - 1]);
+    EXPECT_EQ(in[starts[0] + pulse_length + guard], out[starts[0] + pulse_length + guard]);
+    // Uniform I and Q in [-0.5, 0.5] have a power of 1/6
+    EXPECT_NEAR(1.0 / 6.0, blanker.noise_power(), 0.02);
+}
+
+
+TEST(Pulse_Blanker_test, NotchFollowsTone)
+{
+    const unsigned int n = 20000;
+    const float f = 0.1;  // tone frequency over the sample rate
+    std::vector<std::complex<float>> in(n);
+    for (unsigned int i = 0; i < n; i++)
+        {
+            in[i] = 0.1f * noise_sample() + std::polar(1.0f, static_cast<float>(2.0 * M_PI * f * i));
+        }
+    Pulse_Blanker blanker(false, 10.0, 0, true, 0.005, 0.9);
+    std::vector<std::complex<float>> out(n);
+    for (unsigned int i = 0; i < n; i += 1000)
+        {
+            blanker.process(in.data() + i, out.data() + i, 1000);
+        }
+    EXPECT_EQ(0u, blanker.blanked_samples());
+    EXPECT_NEAR(2.0 * M_PI * f, std::arg(blanker.notch_zero()), 0.01);
+    EXPECT_GT(std::abs(blanker.notch_zero()), 0.95);
+
+    // Once converged, the output power is that of the noise
+    float power = 0.0;
+    for (unsigned int i = n - 1000; i < n; i++)
+        {
+            power += std::norm(out[i]);
+        }
+    EXPECT_LT(power / 1000.0, 0.01);
+}
+
+
+TEST(Pulse_Blanker_test, ShortSamples)
+{
+    const unsigned int n = 2000;
+    std::vector<std::complex<int16_t>> in(n);
+    for (unsigned int i = 0; i < n; i++)
+        {
+            in[i] = std::complex<int16_t>(rand() % 201 - 100, rand() % 201 - 100);
+        }
+    in[1000] = std::complex<int16_t>(3000, -3000);
+    Pulse_Blanker blanker(true, 10.0, 2, false, 0.0, 0.9);
+    std::vector<std::complex<int16_t>> out(n);
+    blanker.process(in.data(), out.data(), n);
+    EXPECT_EQ(1u, blanker.pulses());
+    EXPECT_EQ(5u, blanker.blanked_samples());
+    EXPECT_EQ(std::complex<int16_t>(0, 0), out[1000]);
+    EXPECT_EQ(in[10], out[10]);
+}
@@ -0,0 +1,132 @@
+/*!
+ * \file pvt_corrections_cache_test.cc
+ * \brief  This file implements tests for the per-epoch cache of the
+ *  geometry and troposphere delay of the satellites.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include "pvt_corrections_cache.h"
+#include "pvt_solution.h"
+#include "GPS_L1_CA.h"
+
+#define CORRECTIONS_TEST_SATELLITES 8
+
+
+/*
+ * Receiver near Castelldefels and satellites all around, one of them below
+ * the horizon
+ */
+static void corrections_test_geometry(double * rx, double * los)
+{
+    const double lat = 41.275 * GPS_PI / 180.0;
+    const double lon = 1.987 * GPS_PI / 180.0;
+    const double height = 80.0;
+    const double a = 6378137.0;
+    const double e2 = 6.69437999014e-3;
+    const double nu = a / sqrt(1.0 - e2 * sin(lat) * sin(lat));
+    rx[0] = (nu + height) * cos(lat) * cos(lon);
+    rx[1] = (nu + height) * cos(lat) * sin(lon);
+    rx[2] = (nu * (1.0 - e2) + height) * sin(lat);
+
+    const double az_deg[CORRECTIONS_TEST_SATELLITES] = {10.0, 55.0, 95.0, 140.0, 185.0, 220.0, 300.0, 340.0};
+    const double el_deg[CORRECTIONS_TEST_SATELLITES] = {88.0, 20.0, 45.0, 5.0, 60.0, 15.0, 25.0, -3.0};
+    for (int i = 0; i < CORRECTIONS_TEST_SATELLITES; i++)
+        {
+            const double az = az_deg[i] * GPS_PI / 180.0;
+            const double el = el_deg[i] * GPS_PI / 180.0;
+            const double e = cos(el) * sin(az);
+            const double n = cos(el) * cos(az);
+            const double u = sin(el);
+            const double range = 2.2e7;
+            los[3 * i] = range * (-sin(lon) * e - sin(lat) * cos(lon) * n + cos(lat) * cos(lon) * u);
+            los[3 * i + 1] = range * (cos(lon) * e - sin(lat) * sin(lon) * n + cos(lat) * sin(lon) * u);
+            los[3 * i + 2] = range * (cos(lat) * n + sin(lat) * u);
+        }
+}
+
+
+TEST(PvtCorrectionsCacheTest, MatchesTopocentAndTropo)
+{
+    double rx[3];
+    double los[3 * CORRECTIONS_TEST_SATELLITES];
+    corrections_test_geometry(rx, los);
+
+    Pvt_Solution reference;
+    double phi;
+    double lambda;
+    double h;
+    reference.togeod(&phi, &lambda, &h, 6378137.0, 298.257223563, rx[0], rx[1], rx[2]);
+
+    Pvt_Corrections_Cache cache;
+    EXPECT_TRUE(cache.stale(rx));
+    cache.set_receiver(rx, phi, lambda, h);
+    EXPECT_FALSE(cache.stale(rx));
+
+    double az[CORRECTIONS_TEST_SATELLITES];
+    double el[CORRECTIONS_TEST_SATELLITES];
+    double range[CORRECTIONS_TEST_SATELLITES];
+    double trop[CORRECTIONS_TEST_SATELLITES];
+    cache.evaluate(los, CORRECTIONS_TEST_SATELLITES, az, el, range, trop);
+
+    arma::vec rx_vec = {rx[0], rx[1], rx[2]};
+    for (int i = 0; i < CORRECTIONS_TEST_SATELLITES; i++)
+        {
+            arma::vec los_vec = {los[3 * i], los[3 * i + 1], los[3 * i + 2]};
+            double ref_az;
+            double ref_el;
+            double ref_range;
+            double ref_trop;
+            reference.topocent(&ref_az, &ref_el, &ref_range, rx_vec, los_vec);
+            reference.tropo(&ref_trop, sin(ref_el * GPS_PI / 180.0), h / 1000.0, 1013.0, 293.0, 50.0, 0.0, 0.0, 0.0);
+            EXPECT_NEAR(ref_az, az[i], 1e-9) << "satellite " << i;
+            EXPECT_NEAR(ref_el, el[i], 1e-9) << "satellite " << i;
+            EXPECT_NEAR(ref_range, range[i], 1e-6) << "satellite " << i;
+            EXPECT_NEAR(ref_trop, trop[i], 1e-6) << "satellite " << i;
+        }
+}
+
+
+TEST(PvtCorrectionsCacheTest, RefreshesWhenTheReceiverMoves)
+{
+    double rx[3];
+    double los[3 * CORRECTIONS_TEST_SATELLITES];
+    corrections_test_geometry(rx, los);
+
+    Pvt_Corrections_Cache cache(10.0);
+    cache.set_receiver(rx, 41.275, 1.987, 80.0);
+    EXPECT_EQ(1u, cache.refreshes());
+
+    double moved[3] = {rx[0] + 5.0, rx[1] - 5.0, rx[2] + 5.0};
+    EXPECT_FALSE(cache.stale(moved));
+    moved[2] = rx[2] + 10.0;
+    EXPECT_TRUE(cache.stale(moved));
+
+    cache.invalidate();
+    EXPECT_TRUE(cache.stale(rx));
+}
@@ -0,0 +1,123 @@
+/*!
+ * \file pvt_file_rotation_test.cc
+ * \brief Tests of the rotation and compression of the PVT output files
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <zlib.h>
+#include <gtest/gtest.h>
+#include "pvt_file_rotation.h"
+
+
+static std::time_t local_time(int year, int month, int day, int hour, int minute)
+{
+    struct tm t = {};
+    t.tm_year = year - 1900;
+    t.tm_mon = month - 1;
+    t.tm_mday = day;
+    t.tm_hour = hour;
+    t.tm_min = minute;
+    t.tm_isdst = -1;
+    return mktime(&t);
+}
+
+
+TEST(PvtFileRotationTest, HourlyAndDailyPeriods)
+{
+    Pvt_File_Rotation none(Pvt_File_Rotation::NONE, false);
+    EXPECT_FALSE(none.due(local_time(2016, 5, 1, 10, 0)));
+    EXPECT_FALSE(none.due(local_time(2016, 5, 2, 10, 0)));
+
+    Pvt_File_Rotation hourly(Pvt_File_Rotation::HOURLY, false);
+    EXPECT_FALSE(hourly.due(local_time(2016, 5, 1, 10, 30)));       // starts the period
+    EXPECT_FALSE(hourly.due(local_time(2016, 5, 1, 10, 59)));
+    EXPECT_TRUE(hourly.due(local_time(2016, 5, 1, 11, 0)));
+    EXPECT_FALSE(hourly.due(local_time(2016, 5, 1, 11, 1)));
+    EXPECT_TRUE(hourly.due(local_time(2016, 5, 2, 11, 1)));         // same hour, next day
+
+    Pvt_File_Rotation daily(Pvt_File_Rotation::DAILY, false);
+    EXPECT_FALSE(daily.due(local_time(2016, 12, 31, 10, 0)));
+    EXPECT_FALSE(daily.due(local_time(2016, 12, 31, 23, 59)));
+    EXPECT_TRUE(daily.due(local_time(2017, 1, 1, 0, 0)));
+    EXPECT_FALSE(daily.due(local_time(2017, 1, 1, 12, 0)));
+
+    Pvt_File_Rotation::Period period = Pvt_File_Rotation::NONE;
+    EXPECT_TRUE(Pvt_File_Rotation::period_from_name("daily", period));
+    EXPECT_EQ(Pvt_File_Rotation::DAILY, period);
+    EXPECT_FALSE(Pvt_File_Rotation::period_from_name("weekly", period));
+    EXPECT_EQ(Pvt_File_Rotation::DAILY, period);
+}
+
+
+TEST(PvtFileRotationTest, TaggedFilename)
+{
+    const std::time_t t = local_time(2016, 5, 1, 9, 5);
+    EXPECT_EQ("gnss_sdr_pvt_160501_090500.nmea", Pvt_File_Rotation::tagged_filename("gnss_sdr_pvt.nmea", t));
+    EXPECT_EQ("pvt_160501_090500", Pvt_File_Rotation::tagged_filename("pvt", t));
+    EXPECT_EQ("./out.d/pvt_160501_090500", Pvt_File_Rotation::tagged_filename("./out.d/pvt", t));
+}
+
+
+TEST(PvtFileRotationTest, CompressesClosedFiles)
+{
+    const std::string filename = "pvt_file_rotation_test.txt";
+    std::string content;
+    for (int i = 0; i < 5000; i++)
+        {
+            content += "$GPGGA,101530.00,4124.8963,N,00209.6090,E,1,08,1.0,100.0,M,0.0,M,,*4B\n";
+        }
+    {
+        std::ofstream out(filename.c_str());
+        out << content;
+    }
+    {
+        Pvt_File_Rotation rotation(Pvt_File_Rotation::HOURLY, true);
+        rotation.archive(filename);
+        rotation.flush();
+    }
+
+    // the original is replaced by the compressed file
+    EXPECT_EQ(nullptr, fopen(filename.c_str(), "r"));
+    gzFile in = gzopen((filename + ".gz").c_str(), "rb");
+    ASSERT_NE(nullptr, in);
+    std::string decompressed;
+    char buffer[4096];
+    int n;
+    while ((n = gzread(in, buffer, sizeof(buffer))) > 0)
+        {
+            decompressed.append(buffer, n);
+        }
+    gzclose(in);
+    EXPECT_EQ(content, decompressed);
+    remove((filename + ".gz").c_str());
+
+    EXPECT_FALSE(Pvt_File_Rotation::gzip_file("pvt_file_rotation_test_missing.txt"));
+}
@@ -0,0 +1,92 @@
+/*!
+ * \file pvt_output_writer_test.cc
+ * \brief  This file implements tests for the queue and writer thread of
+ *  the PVT outputs.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <vector>
+#include <boost/thread.hpp>
+#include <gtest/gtest.h>
+#include "pvt_output_writer.h"
+
+
+TEST(PvtOutputWriterTest, RunsJobsInOrder)
+{
+    std::vector<int> out;
+    {
+        Pvt_Output_Writer writer(8, Pvt_Output_Writer::BLOCK);
+        for (int i = 0; i < 1000; i++)
+            {
+                EXPECT_TRUE(writer.push([&out, i]() { out.push_back(i); }));
+            }
+        writer.flush();
+        EXPECT_EQ(1000u, writer.written());
+        EXPECT_EQ(0u, writer.dropped());
+    }
+    ASSERT_EQ(1000u, out.size());
+    for (int i = 0; i < 1000; i++)
+        {
+            EXPECT_EQ(i, out[i]);
+        }
+}
+
+
+TEST(PvtOutputWriterTest, DropsWhenFull)
+{
+    boost::mutex stall;
+    int runs = 0;
+    Pvt_Output_Writer writer(4, Pvt_Output_Writer::DROP);
+    {
+        // a stalled output: the first job waits for the lock
+        boost::unique_lock<boost::mutex> lock(stall);
+        writer.push([&stall, &runs]() { boost::unique_lock<boost::mutex> l(stall); runs++; });
+        boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+        int accepted = 0;
+        for (int i = 0; i < 10; i++)
+            {
+                if (writer.push([&runs]() { runs++; })) accepted++;
+            }
+        EXPECT_EQ(4, accepted);
+        EXPECT_EQ(6u, writer.dropped());
+    }
+    writer.flush();
+    EXPECT_EQ(5, runs);
+}
+
+
+TEST(PvtOutputWriterTest, InlineWithoutQueue)
+{
+    int runs = 0;
+    Pvt_Output_Writer writer(0, Pvt_Output_Writer::DROP);
+    writer.push([&runs]() { runs++; });
+    EXPECT_EQ(1, runs);
+    Pvt_Output_Writer::Overflow_Policy policy = Pvt_Output_Writer::DROP;
+    EXPECT_TRUE(Pvt_Output_Writer::policy_from_name("block", policy));
+    EXPECT_EQ(Pvt_Output_Writer::BLOCK, policy);
+    EXPECT_FALSE(Pvt_Output_Writer::policy_from_name("wait", policy));
+}
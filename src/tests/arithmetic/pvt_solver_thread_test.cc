@@ -0,0 +1,91 @@
+/*!
+ * \file pvt_solver_thread_test.cc
+ * \brief  This file implements tests for the latest epoch handoff to the
+ *  PVT solver thread.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <vector>
+#include <boost/thread.hpp>
+#include <gtest/gtest.h>
+#include "pvt_solver_thread.h"
+
+
+TEST(PvtSolverThreadTest, KeepsTheLatestEpoch)
+{
+    boost::mutex stall;
+    std::vector<int> solved;
+    Pvt_Solver_Thread solver(true);
+    {
+        // a slow epoch: the first job waits for the lock
+        boost::unique_lock<boost::mutex> lock(stall);
+        EXPECT_TRUE(solver.submit([&stall, &solved]() { boost::unique_lock<boost::mutex> l(stall); solved.push_back(0); }));
+        boost::this_thread::sleep(boost::posix_time::milliseconds(50));
+        // submit() does not wait for it, and only the last epoch is kept
+        EXPECT_TRUE(solver.submit([&solved]() { solved.push_back(1); }));
+        for (int i = 2; i < 10; i++)
+            {
+                EXPECT_FALSE(solver.submit([&solved, i]() { solved.push_back(i); }));
+            }
+        EXPECT_EQ(8u, solver.dropped());
+    }
+    solver.flush();
+    ASSERT_EQ(2u, solved.size());
+    EXPECT_EQ(0, solved[0]);
+    EXPECT_EQ(9, solved[1]);
+    EXPECT_EQ(2u, solver.solved());
+}
+
+
+TEST(PvtSolverThreadTest, RunsThePendingEpochAtDestruction)
+{
+    int runs = 0;
+    {
+        Pvt_Solver_Thread solver(true);
+        for (int i = 0; i < 100; i++)
+            {
+                solver.submit([&runs]() { runs++; });
+            }
+    }
+    // at least the last epoch is solved, none twice
+    EXPECT_GE(runs, 1);
+    EXPECT_LE(runs, 100);
+}
+
+
+TEST(PvtSolverThreadTest, InlineWhenDisabled)
+{
+    int runs = 0;
+    Pvt_Solver_Thread solver(false);
+    for (int i = 0; i < 3; i++)
+        {
+            EXPECT_TRUE(solver.submit([&runs]() { runs++; }));
+        }
+    EXPECT_EQ(3, runs);
+    EXPECT_EQ(3u, solver.solved());
+    EXPECT_EQ(0u, solver.dropped());
+}
@@ -0,0 +1,67 @@
+/*!
+ * \file realtime_monitor_test.cc
+ * \brief  This file implements tests for the real-time factor of the
+ *  tracking channels.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "gnss_sdr_realtime_monitor.h"
+
+
+TEST(RealtimeMonitorTest, MeasuresTheRealtimeFactor)
+{
+    Gnss_Sdr_Realtime_Monitor::enable(false);
+    EXPECT_FALSE(Gnss_Sdr_Realtime_Monitor::channel(0, 4e6));
+
+    Gnss_Sdr_Realtime_Monitor::enable(true);
+    std::shared_ptr<Gnss_Sdr_Channel_Cost> cost = Gnss_Sdr_Realtime_Monitor::channel(0, 4e6);
+    ASSERT_TRUE(cost);
+    EXPECT_EQ(cost, Gnss_Sdr_Realtime_Monitor::channel(0, 4e6));
+    Gnss_Sdr_Realtime_Monitor::sample();
+
+    // 10 ms of processing for 4000 samples, 1 ms of signal
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    cost->add(start, 4000);
+    cost->set_cn0_db_hz(42.0);
+
+    std::vector<Gnss_Sdr_Realtime_Monitor::Channel_Load> loads = Gnss_Sdr_Realtime_Monitor::sample();
+    ASSERT_EQ(1u, loads.size());
+    EXPECT_EQ(0u, loads[0].channel);
+    EXPECT_GE(loads[0].realtime_factor, 10.0);
+    EXPECT_LT(loads[0].realtime_factor, 100.0);
+    EXPECT_DOUBLE_EQ(42.0, loads[0].cn0_db_hz);
+    EXPECT_DOUBLE_EQ(loads[0].realtime_factor / 4.0, Gnss_Sdr_Realtime_Monitor::receiver_load(loads, 4));
+
+    // no signal since the previous sample
+    EXPECT_TRUE(Gnss_Sdr_Realtime_Monitor::sample().empty());
+    Gnss_Sdr_Realtime_Monitor::enable(false);
+}
@@ -0,0 +1,80 @@
+/*!
+ * \file ring_buffer_test.cc
+ * \brief  This file implements tests for the fixed-capacity ring buffer
+ *  used by the telemetry decoders and observables histories.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include <gtest/gtest.h>
+#include "ring_buffer.h"
+
+
+TEST(RingBufferTest, KeepsLastElements)
+{
+    const unsigned int capacity = 11;  // not a power of two
+    ring_buffer<double> buffer(capacity);
+    std::deque<double> reference;
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_EQ(capacity, buffer.capacity());
+
+    for (int n = 0; n < 100; n++)
+        {
+            buffer.push_back(static_cast<double>(n));
+            reference.push_back(static_cast<double>(n));
+            if (reference.size() > capacity) reference.pop_front();
+            if (n % 7 == 6)
+                {
+                    buffer.pop_front();
+                    reference.pop_front();
+                }
+            ASSERT_EQ(reference.size(), buffer.size());
+            EXPECT_EQ(reference.front(), buffer.front());
+            EXPECT_EQ(reference.back(), buffer.back());
+            for (unsigned int i = 0; i < buffer.size(); i++)
+                {
+                    EXPECT_EQ(reference[i], buffer[i]);
+                }
+        }
+
+    std::vector<double> linear(buffer.size());
+    buffer.copy_to(&linear[0]);
+    EXPECT_TRUE(std::equal(reference.begin(), reference.end(), linear.begin()));
+
+    // copies are independent from the original buffer
+    std::vector<ring_buffer<double>> histories(2, buffer);
+    histories[0].push_back(-1.0);
+    EXPECT_EQ(reference.back(), buffer.back());
+    EXPECT_EQ(-1.0, histories[0].back());
+    EXPECT_EQ(reference.back(), histories[1].back());
+
+    buffer.clear();
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_FALSE(buffer.full());
+}
@@ -0,0 +1,123 @@
+/*!
+ * \file sample_requantizer_test.cc
+ * \brief Tests of the AGC and requantization to narrow integer samples
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <complex>
+#include <random>
+#include <set>
+#include <vector>
+#include "sample_requantizer.h"
+
+
+TEST(Sample_Requantizer_test, TwoBitLevelsAndLoss)
+{
+    const unsigned int n = 100000;
+    std::mt19937 gen(1);
+    std::normal_distribution<float> noise(0.0, 1000.0);
+    std::vector<std::complex<float>> in(n);
+    for (unsigned int i = 0; i < n; i++)
+        {
+            in[i] = std::complex<float>(noise(gen), noise(gen));
+        }
+    Sample_Requantizer requantizer(2, 0.25, 1000.0);
+    std::vector<std::complex<int8_t>> out(n);
+    for (unsigned int i = 0; i < n; i += 10000)
+        {
+            requantizer.process(in.data() + i, out.data() + i, 10000);
+        }
+    std::set<int> levels;
+    for (unsigned int i = 0; i < n; i++)
+        {
+            levels.insert(out[i].real());
+            levels.insert(out[i].imag());
+        }
+    EXPECT_EQ(std::set<int>({ -3, -1, 1, 3 }), levels);
+    // 0.55 dB for a Gaussian signal with the optimum thresholds
+    EXPECT_NEAR(0.55, requantizer.implementation_loss_db(), 0.05);
+    EXPECT_NEAR(2.0 / 0.9957 / 1000.0, requantizer.gain(), 1e-4);
+}
+
+
+TEST(Sample_Requantizer_test, AgcFollowsLevelStep)
+{
+    const unsigned int n = 40000;
+    const unsigned int block = 1000;
+    std::mt19937 gen(2);
+    std::normal_distribution<float> noise(0.0, 1.0);
+    std::vector<std::complex<float>> in(n);
+    for (unsigned int i = 0; i < n; i++)
+        {
+            // the front end gain goes up by 20 dB halfway
+            const float sigma = i < n / 2 ? 10.0 : 100.0;
+            in[i] = sigma * std::complex<float>(noise(gen), noise(gen));
+        }
+    Sample_Requantizer requantizer(8, 0.25, 2000.0);
+    std::vector<std::complex<int8_t>> out(n);
+    float gain_before = 0.0;
+    for (unsigned int i = 0; i < n; i += block)
+        {
+            requantizer.process(in.data() + i, out.data() + i, block);
+            if (i + block == n / 2) gain_before = requantizer.gain();
+        }
+    EXPECT_NEAR(0.25 * 127.0 / 10.0, gain_before, 0.2);
+    EXPECT_NEAR(0.25 * 127.0 / 100.0, requantizer.gain(), 0.02);
+    // The step saturates the samples for a few time constants
+    EXPECT_GT(requantizer.clipped_components(), 0u);
+    EXPECT_LT(requantizer.clipped_components(), 2u * n / 4);
+
+    double sum = 0.0;
+    for (unsigned int i = n - 5000; i < n; i++)
+        {
+            sum += std::norm(std::complex<double>(out[i].real(), out[i].imag()));
+        }
+    EXPECT_NEAR(0.25 * 127.0, std::sqrt(sum / 10000.0), 2.0);
+}
+
+
+TEST(Sample_Requantizer_test, ShortInputFixedGain)
+{
+    const unsigned int n = 4096;
+    std::vector<std::complex<int16_t>> in(n);
+    for (unsigned int i = 0; i < n; i++)
+        {
+            in[i] = std::complex<int16_t>(static_cast<int16_t>(i) - 2048, 2047 - static_cast<int16_t>(i));
+        }
+    Sample_Requantizer requantizer(12, 0.25, 1000.0, 0.5);
+    std::vector<std::complex<int16_t>> out(n);
+    requantizer.process(in.data(), out.data(), n);
+    EXPECT_FLOAT_EQ(0.5, requantizer.gain());
+    for (unsigned int i = 0; i < n; i++)
+        {
+            EXPECT_EQ(std::nearbyint(0.5 * in[i].real()), out[i].real());
+            EXPECT_EQ(std::nearbyint(0.5 * in[i].imag()), out[i].imag());
+        }
+    EXPECT_EQ(0u, requantizer.clipped_components());
+    EXPECT_LT(requantizer.implementation_loss_db(), 0.01);
+}
@@ -0,0 +1,244 @@
+/*!
+ * \file satellite_orbit_batch_test.cc
+ * \brief  This file implements tests for the evaluation of the broadcast
+ *  orbits and clocks of all the satellites of an epoch together.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <vector>
+#include <sys/time.h>
+#include <gtest/gtest.h>
+#include "satellite_orbit_batch.h"
+#include "GPS_L1_CA.h"
+
+DEFINE_int32(satellite_orbit_batch_iterations_test, 2000, "Number of epochs in the satellite orbit batch timing test");
+
+
+static Gps_Ephemeris orbit_batch_gps_ephemeris(int k)
+{
+    Gps_Ephemeris eph;
+    eph.i_satellite_PRN = k + 1;
+    eph.d_sqrt_A = 5153.6 + 0.7 * k;
+    eph.d_Delta_n = 4.5e-9 + 1e-10 * k;
+    eph.d_e_eccentricity = 0.001 + 0.0021 * k;
+    eph.d_M_0 = -3.0 + 0.53 * k;
+    eph.d_OMEGA = 2.9 - 0.47 * k;
+    eph.d_Cuc = -1.2e-6 + 2e-7 * k;
+    eph.d_Cus = 8.1e-6 - 5e-7 * k;
+    eph.d_Crc = 230.0 - 11.0 * k;
+    eph.d_Crs = -20.0 + 7.5 * k;
+    eph.d_Cic = 1.1e-7 * (k % 3);
+    eph.d_Cis = -3.7e-8 * (k % 4);
+    eph.d_i_0 = 0.95 + 0.004 * k;
+    eph.d_IDOT = 2.0e-10 * (k - 5);
+    eph.d_OMEGA0 = -3.1 + 0.61 * k;
+    eph.d_OMEGA_DOT = -8.1e-9;
+    eph.d_Toe = 7200.0 * (k % 4);
+    eph.d_Toc = eph.d_Toe;
+    eph.d_A_f0 = 1e-4 * (k - 6);
+    eph.d_A_f1 = 3e-12 * (k - 6);
+    eph.d_A_f2 = 0.0;
+    return eph;
+}
+
+
+static Galileo_Ephemeris orbit_batch_galileo_ephemeris(int k)
+{
+    Galileo_Ephemeris eph;
+    eph.i_satellite_PRN = k + 1;
+    eph.A_1 = 5440.6 + 0.3 * k;
+    eph.delta_n_3 = 3.1e-9;
+    // the two satellites in eccentric orbits
+    eph.e_1 = (k < 2) ? 0.16 : 0.0003 * k;
+    eph.M0_1 = 1.0 - 0.4 * k;
+    eph.omega_2 = -1.2 + 0.3 * k;
+    eph.C_uc_3 = 2.0e-6;
+    eph.C_us_3 = 6.0e-6;
+    eph.C_rc_3 = 180.0;
+    eph.C_rs_3 = 40.0;
+    eph.C_ic_4 = 5e-8;
+    eph.C_is_4 = -2e-8;
+    eph.i_0_2 = 0.97 + 0.002 * k;
+    eph.iDot_2 = -3e-10;
+    eph.OMEGA_0_2 = 0.5 + 0.9 * k;
+    eph.OMEGA_dot_3 = -5.6e-9;
+    eph.t0e_1 = 3600.0 * k;
+    eph.t0c_4 = eph.t0e_1;
+    eph.af0_4 = -2e-4 * k;
+    eph.af1_4 = 1e-12;
+    eph.af2_4 = 0.0;
+    return eph;
+}
+
+
+// Clock correction, and positions at the corrected transmit time and half a second after and before
+template<class Ephemeris>
+static double orbit_batch_scalar(Ephemeris & eph, double tx, double * pos, double * later, double * earlier)
+{
+    const double bias = eph.sv_clock_drift(tx);
+    eph.satellitePosition(tx - bias + 0.5);
+    later[0] = eph.d_satpos_X;
+    later[1] = eph.d_satpos_Y;
+    later[2] = eph.d_satpos_Z;
+    eph.satellitePosition(tx - bias - 0.5);
+    earlier[0] = eph.d_satpos_X;
+    earlier[1] = eph.d_satpos_Y;
+    earlier[2] = eph.d_satpos_Z;
+    eph.satellitePosition(tx - bias);
+    pos[0] = eph.d_satpos_X;
+    pos[1] = eph.d_satpos_Y;
+    pos[2] = eph.d_satpos_Z;
+    return bias;
+}
+
+
+TEST(SatelliteOrbitBatchTest, MatchesEphemerisModels)
+{
+    std::vector<Gps_Ephemeris> gps;
+    std::vector<Galileo_Ephemeris> galileo;
+    std::vector<double> tx;
+    Satellite_Orbit_Batch batch;
+    // two epochs, the second one across the GPS week crossover
+    for (int epoch = 0; epoch < 2; epoch++)
+        {
+            gps.clear();
+            galileo.clear();
+            tx.clear();
+            batch.clear();
+            const double rx_time = (epoch == 0) ? 5000.0 : 604790.0;
+            for (int k = 0; k < 13; k++)
+                {
+                    gps.push_back(orbit_batch_gps_ephemeris(k));
+                    tx.push_back(rx_time - (0.067 + 0.001 * k));
+                    EXPECT_TRUE(batch.add(gps.back(), tx.back()));
+                }
+            for (int k = 0; k < 7; k++)
+                {
+                    galileo.push_back(orbit_batch_galileo_ephemeris(k));
+                    tx.push_back(rx_time - (0.08 + 0.002 * k));
+                    batch.add(galileo.back(), tx.back());
+                }
+            batch.compute();
+            ASSERT_EQ(20u, batch.size());
+
+            for (unsigned int k = 0; k < batch.size(); k++)
+                {
+                    double expected_pos[3];
+                    double later_pos[3];
+                    double earlier_pos[3];
+                    double bias;
+                    if (k < gps.size())
+                        {
+                            bias = orbit_batch_scalar(gps[k], tx[k], expected_pos, later_pos, earlier_pos);
+                        }
+                    else
+                        {
+                            bias = orbit_batch_scalar(galileo[k - gps.size()], tx[k], expected_pos, later_pos, earlier_pos);
+                        }
+                    double pos[3];
+                    double vel[3];
+                    batch.position(k, pos);
+                    batch.velocity(k, vel);
+                    EXPECT_NEAR(bias, batch.clock_bias_s(k), 1e-15);
+                    EXPECT_DOUBLE_EQ(tx[k] - bias, batch.corrected_transmit_time_s(k));
+                    for (int j = 0; j < 3; j++)
+                        {
+                            EXPECT_NEAR(expected_pos[j], pos[j], 1e-5) << "satellite " << k << ", epoch " << epoch;
+                            // central differences over one second are good to some um/s
+                            EXPECT_NEAR(later_pos[j] - earlier_pos[j], vel[j], 1e-4) << "satellite " << k << ", epoch " << epoch;
+                        }
+                }
+        }
+
+    // a full batch refuses more satellites
+    for (unsigned int k = batch.size(); k < SATELLITE_ORBIT_BATCH_SIZE; k++)
+        {
+            EXPECT_TRUE(batch.add(gps[0], 1000.0));
+        }
+    EXPECT_FALSE(batch.add(galileo[0], 1000.0));
+    EXPECT_EQ(static_cast<unsigned int>(SATELLITE_ORBIT_BATCH_SIZE), batch.size());
+}
+
+
+TEST(SatelliteOrbitBatchTest, Timing)
+{
+    std::vector<Gps_Ephemeris> gps;
+    for (int k = 0; k < 12; k++)
+        {
+            gps.push_back(orbit_batch_gps_ephemeris(k));
+        }
+    Satellite_Orbit_Batch batch;
+    double checksum_scalar = 0.0;
+    double checksum_batch = 0.0;
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    long long int begin = tv.tv_sec * 1000000 + tv.tv_usec;
+    for (int epoch = 0; epoch < FLAGS_satellite_orbit_batch_iterations_test; epoch++)
+        {
+            const double tx = 1000.0 + 0.1 * epoch;
+            for (unsigned int k = 0; k < gps.size(); k++)
+                {
+                    const double bias = gps[k].sv_clock_drift(tx);
+                    gps[k].satellitePosition(tx - bias + 0.5);
+                    checksum_scalar += gps[k].d_satpos_X;
+                    gps[k].satellitePosition(tx - bias - 0.5);
+                    checksum_scalar -= gps[k].d_satpos_X;
+                    gps[k].satellitePosition(tx - bias);
+                }
+        }
+    gettimeofday(&tv, NULL);
+    long long int end = tv.tv_sec * 1000000 + tv.tv_usec;
+    std::cout << "Orbits of " << gps.size() << " satellites in " << FLAGS_satellite_orbit_batch_iterations_test
+              << " epochs, one at a time, finished in " << (end - begin) << " microseconds" << std::endl;
+
+    gettimeofday(&tv, NULL);
+    begin = tv.tv_sec * 1000000 + tv.tv_usec;
+    for (int epoch = 0; epoch < FLAGS_satellite_orbit_batch_iterations_test; epoch++)
+        {
+            const double tx = 1000.0 + 0.1 * epoch;
+            batch.clear();
+            for (unsigned int k = 0; k < gps.size(); k++)
+                {
+                    batch.add(gps[k], tx);
+                }
+            batch.compute();
+            for (unsigned int k = 0; k < gps.size(); k++)
+                {
+                    double vel[3];
+                    batch.velocity(k, vel);
+                    checksum_batch += vel[0];
+                }
+        }
+    gettimeofday(&tv, NULL);
+    end = tv.tv_sec * 1000000 + tv.tv_usec;
+    std::cout << "Orbits of " << gps.size() << " satellites in " << FLAGS_satellite_orbit_batch_iterations_test
+              << " epochs, in a batch, finished in " << (end - begin) << " microseconds" << std::endl;
+
+    EXPECT_NEAR(checksum_scalar, checksum_batch, 1e-4 * FLAGS_satellite_orbit_batch_iterations_test * gps.size());
+}
@@ -0,0 +1,105 @@
+/*!
+ * \file shm_loop_connector_test.cc
+ * \brief  This file implements tests for the shared-memory mailboxes of the
+ *   TCP connector tracking loops.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "shm_loop_connector.h"
+
+
+TEST(Shm_loop_connector_test, RoundTripAllChannels)
+{
+    const int n_channels = 4;
+    const int n_epochs = 200;
+    const std::string name = "/gnss_sdr_shm_test_" + std::to_string(getpid());
+
+    std::vector<shm_loop_connector> channels(n_channels);
+    for (int ch = 0; ch < n_channels; ch++)
+        {
+            ASSERT_TRUE(channels[ch].open(name, ch, 16));
+        }
+    // A channel beyond the segment falls back to TCP
+    shm_loop_connector outside;
+    EXPECT_FALSE(outside.open(name, 20, 32));
+
+    shm_loop_connector loop_process;
+    ASSERT_TRUE(loop_process.open(name, -1, 16));
+    std::atomic<bool> stop(false);
+    std::thread server([&]()
+        {
+            while (!stop.load())
+                {
+                    // Answers code error = tx[1] + slot, carrier error = 2 * tx[2]
+                    loop_process.poll([](int slot, const float* tx, int n_tx, float* rx)
+                        {
+                            rx[1] = tx[1] + slot;
+                            rx[2] = 2.0 * tx[2];
+                            rx[3] = static_cast<float>(n_tx);
+                        });
+                }
+        });
+
+    std::vector<std::thread> clients;
+    std::atomic<int> failures(0);
+    for (int ch = 0; ch < n_channels; ch++)
+        {
+            clients.push_back(std::thread([&, ch]()
+                {
+                    for (int epoch = 0; epoch < n_epochs; epoch++)
+                        {
+                            float tx[9] = { static_cast<float>(epoch), 0.5f * ch, static_cast<float>(epoch) };
+                            float rx[4] = { -1, 0, 0, 0 };
+                            if (!channels[ch].send_receive(tx, 9, rx, 4)
+                                    || rx[1] != 0.5f * ch + ch || rx[2] != 2.0f * epoch || rx[3] != 9.0f)
+                                {
+                                    failures++;
+                                }
+                        }
+                }));
+        }
+    for (auto& t : clients)
+        {
+            t.join();
+        }
+    stop.store(true);
+    server.join();
+    EXPECT_EQ(0, failures.load());
+
+    loop_process.close();
+    for (int ch = 0; ch < n_channels; ch++)
+        {
+            channels[ch].close();
+        }
+    // The last channel removed the segment
+    EXPECT_FALSE(loop_process.open(name, -1, 16, 10));
+}
@@ -0,0 +1,142 @@
+/*!
+ * \file task_pool_test.cc
+ * \brief Tests of the shared work-stealing task pool
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "gnss_sdr_task_pool.h"
+
+
+TEST(Task_Pool_Test, GroupRunsAllTheTasks)
+{
+    Gnss_Sdr_Task_Pool::configure(4, 1, std::vector<int>());
+    const unsigned int id = Gnss_Sdr_Task_Pool::task_id("test_sum");
+    EXPECT_EQ(id, Gnss_Sdr_Task_Pool::task_id("test_sum"));
+    std::vector<unsigned int> results(1000, 0);
+    Gnss_Sdr_Task_Group group(id);
+    for (unsigned int i = 0; i < results.size(); i++)
+        {
+            group.run([&results, i]() { results[i] = 2 * i; });
+        }
+    group.wait();
+    for (unsigned int i = 0; i < results.size(); i++)
+        {
+            ASSERT_EQ(2 * i, results[i]);
+        }
+    EXPECT_EQ(4u, Gnss_Sdr_Task_Pool::threads());
+
+    bool found = false;
+    std::vector<Gnss_Sdr_Task_Pool::Task_Metrics> metrics = Gnss_Sdr_Task_Pool::metrics();
+    for (unsigned int i = 0; i < metrics.size(); i++)
+        {
+            if (metrics[i].name != "test_sum") continue;
+            found = true;
+            EXPECT_EQ(results.size(), metrics[i].completed);
+        }
+    EXPECT_TRUE(found);
+}
+
+
+TEST(Task_Pool_Test, WaitThrowsTheExceptionOfATask)
+{
+    Gnss_Sdr_Task_Group group(Gnss_Sdr_Task_Pool::task_id("test_throw"));
+    std::atomic<unsigned int> done(0);
+    for (unsigned int i = 0; i < 10; i++)
+        {
+            group.run([&done, i]()
+                    {
+                if (i == 3) throw std::runtime_error("task 3");
+                done++;
+                    });
+        }
+    EXPECT_THROW(group.wait(), std::runtime_error);
+    // the other tasks still ran
+    EXPECT_EQ(9u, done.load());
+}
+
+
+TEST(Task_Pool_Test, NestedGroupsDoNotTakeAllTheWorkers)
+{
+    Gnss_Sdr_Task_Pool::configure(2, 1, std::vector<int>());
+    const unsigned int id = Gnss_Sdr_Task_Pool::task_id("test_nested");
+    std::atomic<unsigned int> leaves(0);
+    Gnss_Sdr_Task_Group outer(id);
+    for (unsigned int i = 0; i < 8; i++)
+        {
+            outer.run([&leaves, id]()
+                    {
+                Gnss_Sdr_Task_Group inner(id);
+                for (unsigned int j = 0; j < 8; j++)
+                    {
+                        inner.run([&leaves]() { leaves++; });
+                    }
+                inner.wait();
+                    });
+        }
+    outer.wait();
+    EXPECT_EQ(64u, leaves.load());
+}
+
+
+TEST(Task_Pool_Test, BackgroundTasksAreLimited)
+{
+    Gnss_Sdr_Task_Pool::configure(4, 1, std::vector<int>());
+    std::atomic<int> running(0);
+    std::atomic<int> max_running(0);
+    std::atomic<unsigned int> realtime(0);
+    {
+        Gnss_Sdr_Task_Group background(Gnss_Sdr_Task_Pool::task_id("test_background"), TASK_PRIORITY_BACKGROUND);
+        for (unsigned int i = 0; i < 6; i++)
+            {
+                background.run([&running, &max_running]()
+                        {
+                    int now = ++running;
+                    int seen = max_running;
+                    while (now > seen && !max_running.compare_exchange_weak(seen, now)) {}
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                    running--;
+                        });
+            }
+        // the other workers are free for signal processing meanwhile
+        Gnss_Sdr_Task_Group group(Gnss_Sdr_Task_Pool::task_id("test_realtime"));
+        for (unsigned int i = 0; i < 100; i++)
+            {
+                group.run([&realtime]() { realtime++; });
+            }
+        group.wait();
+        EXPECT_EQ(100u, realtime.load());
+        background.wait();
+    }
+    EXPECT_EQ(1, max_running.load());
+    Gnss_Sdr_Task_Pool::configure(0, 1, std::vector<int>());
+}
@@ -0,0 +1,91 @@
+/*!
+ * \file telemetry_output_decimator_test.cc
+ * \brief  Tests the selection of the telemetry decoder epochs sent to the
+ *  observables.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include "telemetry_output_decimator.h"
+
+
+TEST(TelemetryOutputDecimatorTest, AllEpochsAndDecimation)
+{
+    Telemetry_Output_Decimator decimator;
+    EXPECT_TRUE(decimator.output(0.0, false, false));
+    EXPECT_TRUE(decimator.output(1.0, false, false));
+    decimator.set_decimation(4);
+    int outputs = 0;
+    for (int ms = 0; ms < 100; ms++)
+        {
+            if (decimator.output(ms, false, false)) outputs++;
+        }
+    EXPECT_EQ(25, outputs);
+}
+
+
+TEST(TelemetryOutputDecimatorTest, OneItemPerCellForEveryChannel)
+{
+    // two channels with different code phases, one of them synchronized
+    // with a preamble that drifts forward over a cell boundary
+    Telemetry_Output_Decimator rate;
+    Telemetry_Output_Decimator preamble;
+    Telemetry_Output_Decimator::output_mode mode = Telemetry_Output_Decimator::all_epochs;
+    ASSERT_TRUE(Telemetry_Output_Decimator::parse_mode("rate", mode));
+    rate.set_mode(mode, 6000.0);
+    ASSERT_TRUE(Telemetry_Output_Decimator::parse_mode("preamble", mode));
+    preamble.set_mode(mode, 6000.0);
+    EXPECT_FALSE(Telemetry_Output_Decimator::parse_mode("sometimes", mode));
+    EXPECT_EQ(Telemetry_Output_Decimator::preambles, mode);
+
+    int rate_outputs = 0;
+    int preamble_outputs = 0;
+    double preamble_ms = 5990.0;
+    for (int epoch = 0; epoch < 60000; epoch++)
+        {
+            double rx_time_ms = 1000.3 + epoch;
+            if (rate.output(rx_time_ms, false, false))
+                {
+                    // the first epoch of every cell after the first one
+                    if (rate_outputs > 0) EXPECT_LT(rx_time_ms - 6000.0 * std::floor(rx_time_ms / 6000.0), 1.0);
+                    rate_outputs++;
+                }
+            bool sync = rx_time_ms > 3000.0;
+            bool is_preamble = sync && rx_time_ms >= preamble_ms;
+            if (is_preamble) preamble_ms += 6005.0;
+            if (preamble.output(rx_time_ms, sync, is_preamble))
+                {
+                    preamble_outputs++;
+                }
+            // never more than one item apart
+            ASSERT_LE(std::abs(rate_outputs - preamble_outputs), 1) << "epoch " << epoch;
+        }
+    EXPECT_EQ(11, rate_outputs);
+    EXPECT_EQ(rate_outputs, preamble_outputs);
+}
@@ -0,0 +1,94 @@
+/*!
+ * \file trace_test.cc
+ * \brief Tests of the markers of the work of the blocks for tracing profilers
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "gnss_sdr_trace.h"
+
+namespace
+{
+int trace_test_evaluations = 0;
+
+int trace_test_channel() __attribute__((unused));
+int trace_test_channel()
+{
+    trace_test_evaluations++;
+    return 3;
+}
+}
+
+
+TEST(Trace_test, MarkersOfEveryBuild)
+{
+    trace_test_evaluations = 0;
+    {
+        GNSS_SDR_TRACE_SCOPE("Trace_test::scope");
+        GNSS_SDR_TRACE_SCOPE_CHANNEL("Trace_test::channel", trace_test_channel(), 12);
+    }
+#if !defined(GNSS_SDR_TRACING) || GNSS_SDR_TRACING == 0
+    // compiled out, arguments included
+    EXPECT_EQ(0, trace_test_evaluations);
+#else
+    EXPECT_EQ(1, trace_test_evaluations);
+#endif
+}
+
+
+#if defined(GNSS_SDR_TRACING) && GNSS_SDR_TRACING == 1
+TEST(Trace_test, ChromeTraceOfTheThreads)
+{
+    {
+        GNSS_SDR_TRACE_SCOPE_CHANNEL("Trace_test::main_thread", 5, 17);
+    }
+    std::thread worker([]()
+    {
+        GNSS_SDR_TRACE_SCOPE("Trace_test::worker_thread");
+    });
+    worker.join();
+
+    // the events of a finished thread are kept
+    const std::string filename = "./trace_test.json";
+    ASSERT_TRUE(Gnss_Sdr_Trace::instance().write(filename.c_str()));
+    std::ifstream file(filename.c_str());
+    std::stringstream contents;
+    contents << file.rdbuf();
+    const std::string trace = contents.str();
+    EXPECT_EQ(0u, trace.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+    const size_t main_event = trace.find("\"name\":\"Trace_test::main_thread\"");
+    ASSERT_NE(std::string::npos, main_event);
+    EXPECT_NE(std::string::npos, trace.find("\"args\":{\"channel\":5,\"prn\":17}", main_event));
+    EXPECT_NE(std::string::npos, trace.find("\"name\":\"Trace_test::worker_thread\""));
+    EXPECT_EQ(std::string::npos, trace.find("\"ts\":-"));
+    std::remove(filename.c_str());
+}
+#endif
@@ -0,0 +1,117 @@
+/*!
+ * \file track_file_writer_test.cc
+ * \brief Tests of the buffered writer of the KML and GeoJSON tracks
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <gtest/gtest.h>
+#include "track_file_writer.h"
+
+
+static std::string track_test_read(const std::string & filename)
+{
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+
+TEST(TrackFileWriterTest, ValidAfterEveryFlush)
+{
+    const std::string filename = "./track_file_writer_test.kml";
+    Track_File_Writer writer(0.0);
+    ASSERT_TRUE(writer.open(filename, "<head>\n", "</tail>\n"));
+    EXPECT_EQ("<head>\n</tail>\n", track_test_read(filename));
+
+    std::string body;
+    for (int i = 0; i < 5; i++)
+        {
+            const std::string line = "position " + std::to_string(i) + "\n";
+            writer.append(line);
+            body += line;
+            EXPECT_EQ("<head>\n" + body + "</tail>\n", track_test_read(filename));
+        }
+    EXPECT_TRUE(writer.close());
+    EXPECT_FALSE(writer.is_open());
+    EXPECT_EQ("<head>\n" + body + "</tail>\n", track_test_read(filename));
+    std::remove(filename.c_str());
+}
+
+
+TEST(TrackFileWriterTest, BuffersUntilTheInterval)
+{
+    const std::string filename = "./track_file_writer_test.geojson";
+    Track_File_Writer writer(3600.0);
+    ASSERT_TRUE(writer.open(filename, "[\n", "\n]\n"));
+    const unsigned long long flushes = writer.flushes();
+    for (int i = 0; i < 100; i++)
+        {
+            writer.append(i == 0 ? "1" : ",1");
+        }
+    // nothing written, and the file is still complete
+    EXPECT_EQ(flushes, writer.flushes());
+    EXPECT_EQ("[\n\n]\n", track_test_read(filename));
+
+    EXPECT_TRUE(writer.flush());
+    std::string expected = "[\n1";
+    for (int i = 1; i < 100; i++) expected += ",1";
+    EXPECT_EQ(expected + "\n]\n", track_test_read(filename));
+    writer.close();
+    std::remove(filename.c_str());
+}
+
+
+TEST(TrackFileWriterTest, FormatsLikePrintf)
+{
+    const double values[] = {0.0, -0.0, 1.5, -1.5, 41.27508312345678, 1.98765432101234, -122.08423456789012,
+            80.12345678901234, 0.99999999999999999, 9.999999999999995, 123456789.123456789, -7.5e-15, 1e16, NAN};
+    char fast[64];
+    char reference[64];
+    for (double value : values)
+        {
+            for (int decimals = 0; decimals <= 14; decimals += 7)
+                {
+                    char * end = Track_File_Writer::format_fixed(fast, value, decimals);
+                    std::snprintf(reference, sizeof(reference), "%.*f", decimals, value);
+                    EXPECT_EQ(std::string(fast), std::string(fast, end));
+                    if (std::string(fast) != std::string(reference))
+                        {
+                            // only the rounding of the last digit may differ
+                            ASSERT_EQ(std::strlen(reference), std::strlen(fast)) << reference << " " << fast;
+                            EXPECT_NEAR(std::atof(reference), std::atof(fast), 1.01 * std::pow(10.0, -decimals)) << reference << " " << fast;
+                        }
+                }
+        }
+}
@@ -0,0 +1,484 @@
+/*!
+ * \file tracking_engine_test.cc
+ * \brief Tests of the compile-time specialized tracking engine
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+#include "tracking_engine.h"
+#include "tracking_2nd_DLL_filter.h"
+#include "tracking_2nd_PLL_filter.h"
+#include "cpu_multicorrelator.h"
+#include "gps_l2c_signal.h"
+#include "gps_sdr_signal_processing.h"
+#include "GPS_L1_CA.h"
+#include "GPS_L2C.h"
+#include "Galileo_E1.h"
+
+
+TEST(Tracking_Engine_Test, TraitsMatchTheSystemParameters)
+{
+    // the traits have no out-of-class definition, so they are passed by value
+    EXPECT_EQ(static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS), static_cast<int>(Gps_L1_Ca_Tracking_Traits::code_length_chips));
+    EXPECT_DOUBLE_EQ(GPS_L1_CA_CODE_RATE_HZ, static_cast<double>(Gps_L1_Ca_Tracking_Traits::code_rate_hz));
+    EXPECT_DOUBLE_EQ(GPS_L1_FREQ_HZ, static_cast<double>(Gps_L1_Ca_Tracking_Traits::carrier_freq_hz));
+    EXPECT_DOUBLE_EQ(GPS_L1_CA_CODE_PERIOD, static_cast<double>(Gps_L1_Ca_Tracking_Traits::integration_time_s));
+
+    EXPECT_EQ(GPS_L2_M_CODE_LENGTH_CHIPS, static_cast<int>(Gps_L2_M_Tracking_Traits::code_length_chips));
+    EXPECT_DOUBLE_EQ(GPS_L2_M_CODE_RATE_HZ, static_cast<double>(Gps_L2_M_Tracking_Traits::code_rate_hz));
+    EXPECT_DOUBLE_EQ(GPS_L2_FREQ_HZ, static_cast<double>(Gps_L2_M_Tracking_Traits::carrier_freq_hz));
+    EXPECT_DOUBLE_EQ(GPS_L2_M_PERIOD, static_cast<double>(Gps_L2_M_Tracking_Traits::integration_time_s));
+
+    EXPECT_EQ(static_cast<int>(Galileo_E1_B_CODE_LENGTH_CHIPS), static_cast<int>(Galileo_E1_Tracking_Traits::code_length_chips));
+    EXPECT_DOUBLE_EQ(Galileo_E1_CODE_CHIP_RATE_HZ, static_cast<double>(Galileo_E1_Tracking_Traits::code_rate_hz));
+    EXPECT_DOUBLE_EQ(Galileo_E1_FREQ_HZ, static_cast<double>(Galileo_E1_Tracking_Traits::carrier_freq_hz));
+    EXPECT_DOUBLE_EQ(Galileo_E1_CODE_PERIOD, static_cast<double>(Galileo_E1_Tracking_Traits::integration_time_s));
+
+    // the taps of Galileo E1 are in half chips of the local code, at
+    // multiples of the very early-late spacing
+    const float el = 0.15;
+    const float vel = 0.6;
+    const float expected[5] = { -2 * vel, -vel, 0.0, vel, 2 * vel };
+    for (int n = 0; n < Galileo_E1_Tracking_Traits::n_taps; n++)
+        {
+            EXPECT_FLOAT_EQ(expected[n], Galileo_E1_Tracking_Traits::samples_per_chip
+                    * (Galileo_E1_Tracking_Traits::tap_offset(n) * el + Galileo_E1_Tracking_Traits::tap_offset_very(n) * vel));
+        }
+}
+
+
+TEST(Tracking_Engine_Test, MatchesTheMulticorrelator)
+{
+    // one 20 ms GPS L2CM integration at 2 Msps
+    const long fs_in = 2000000;
+    const int signal_length = 40000;
+    const int code_length = GPS_L2_M_CODE_LENGTH_CHIPS;
+    const double doppler_hz = 1234.5;
+
+    Tracking_Engine<Gps_L2_M_Tracking_Traits, gr_complex, Tracking_Double_Loop<Gps_L2_M_Tracking_Traits> > engine(fs_in, 2 * signal_length, 0.5);
+    gps_l2c_m_code_gen_complex(engine.local_code(), 1);
+    engine.start(doppler_hz, 0.0);
+
+    gr_complex* in = static_cast<gr_complex*>(volk_gnsssdr_malloc(2 * signal_length * sizeof(gr_complex), volk_gnsssdr_get_alignment()));
+    for (int n = 0; n < 2 * signal_length; n++)
+        {
+            in[n] = gr_complex(static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5,
+                               static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5);
+        }
+
+    // the loops of the tracking blocks, written out
+    const double code_freq_chips = GPS_L2_M_CODE_RATE_HZ * (GPS_L2_FREQ_HZ + doppler_hz) / GPS_L2_FREQ_HZ;
+    const double code_phase_step_chips = code_freq_chips / static_cast<double>(fs_in);
+    const double carrier_phase_step_rad = GPS_L2_TWO_PI * doppler_hz / static_cast<double>(fs_in);
+    const int prn_length_samples = round(GPS_L2_M_CODE_LENGTH_CHIPS / code_freq_chips * static_cast<double>(fs_in));
+    ASSERT_EQ(prn_length_samples, engine.current_prn_length_samples());
+
+    float shifts[3] = { -0.5, 0.0, 0.5 };
+    gr_complex* code = static_cast<gr_complex*>(volk_gnsssdr_malloc(code_length * sizeof(gr_complex), volk_gnsssdr_get_alignment()));
+    gps_l2c_m_code_gen_complex(code, 1);
+    gr_complex* out = static_cast<gr_complex*>(volk_gnsssdr_malloc(3 * sizeof(gr_complex), volk_gnsssdr_get_alignment()));
+    cpu_multicorrelator correlator;
+    correlator.init(2 * signal_length, 3);
+    correlator.set_local_code_and_taps(code_length, code, shifts);
+    correlator.set_input_output_vectors(out, in);
+    correlator.Carrier_wipeoff_multicorrelator_resampler(0.0, carrier_phase_step_rad, 0.0, code_phase_step_chips, prn_length_samples);
+
+    engine.correlate(in);
+    for (int n = 0; n < 3; n++)
+        {
+            EXPECT_EQ(out[n], engine.outputs()[n]);
+        }
+    EXPECT_EQ(out[0], engine.early());
+    EXPECT_EQ(out[1], engine.prompt());
+    EXPECT_EQ(out[2], engine.late());
+
+    // next period, with the filtered Doppler and code error of the loop filters
+    const double filt_doppler_hz = doppler_hz + 3.0;
+    const double code_error_filt_chips = 0.7;
+    engine.update(filt_doppler_hz, code_error_filt_chips);
+    const double new_code_freq_chips = GPS_L2_M_CODE_RATE_HZ + ((filt_doppler_hz * GPS_L2_M_CODE_RATE_HZ) / GPS_L2_FREQ_HZ);
+    const double code_error_filt_secs = (GPS_L2_M_PERIOD * code_error_filt_chips) / GPS_L2_M_CODE_RATE_HZ;
+    const double K_blk_samples = GPS_L2_M_CODE_LENGTH_CHIPS / new_code_freq_chips * static_cast<double>(fs_in) + code_error_filt_secs * static_cast<double>(fs_in);
+    EXPECT_DOUBLE_EQ(new_code_freq_chips, engine.code_freq_chips());
+    EXPECT_EQ(static_cast<int>(round(K_blk_samples)), engine.current_prn_length_samples());
+    EXPECT_DOUBLE_EQ(0.0, engine.period_start_rem_samples());
+    EXPECT_NEAR(K_blk_samples - round(K_blk_samples), engine.rem_code_phase_samples(), 1e-9);
+    EXPECT_NEAR(-GPS_L2_TWO_PI * filt_doppler_hz * GPS_L2_M_PERIOD, engine.acc_carrier_phase_rad(), 1e-9);
+    EXPECT_NEAR(code_error_filt_secs, engine.acc_code_phase_secs(), 1e-15);
+
+    correlator.set_input_output_vectors(out, in + prn_length_samples);
+    correlator.Carrier_wipeoff_multicorrelator_resampler(fmod(GPS_L2_TWO_PI * filt_doppler_hz * GPS_L2_M_PERIOD, GPS_L2_TWO_PI),
+            GPS_L2_TWO_PI * filt_doppler_hz / static_cast<double>(fs_in),
+            (K_blk_samples - round(K_blk_samples)) * new_code_freq_chips / static_cast<double>(fs_in),
+            new_code_freq_chips / static_cast<double>(fs_in), engine.current_prn_length_samples());
+    engine.correlate(in + prn_length_samples);
+    for (int n = 0; n < 3; n++)
+        {
+            EXPECT_EQ(out[n], engine.outputs()[n]);
+        }
+
+    correlator.free();
+    volk_gnsssdr_free(code);
+    volk_gnsssdr_free(out);
+    volk_gnsssdr_free(in);
+}
+
+
+TEST(Tracking_Engine_Test, ShortSamplesMatchFloatSamples)
+{
+    const long fs_in = 2000000;
+    const int signal_length = 40000;
+    const double doppler_hz = -700.0;
+
+    Tracking_Engine<Gps_L2_M_Tracking_Traits, gr_complex> engine(fs_in, signal_length, 0.5);
+    Tracking_Engine<Gps_L2_M_Tracking_Traits, lv_16sc_t> engine_16sc(fs_in, signal_length, 0.5);
+    gps_l2c_m_code_gen_complex(engine.local_code(), 3);
+    gps_l2c_m_code_gen_complex(engine_16sc.local_code(), 3);
+    engine.start(doppler_hz, 0.0);
+    engine_16sc.start(doppler_hz, 0.0);
+
+    // the satellite signal, with the code and carrier of the NCOs, plus noise
+    gr_complex* in = static_cast<gr_complex*>(volk_gnsssdr_malloc(signal_length * sizeof(gr_complex), volk_gnsssdr_get_alignment()));
+    lv_16sc_t* in_16sc = static_cast<lv_16sc_t*>(volk_gnsssdr_malloc(signal_length * sizeof(lv_16sc_t), volk_gnsssdr_get_alignment()));
+    const double code_freq_chips = GPS_L2_M_CODE_RATE_HZ * (GPS_L2_FREQ_HZ + doppler_hz) / GPS_L2_FREQ_HZ;
+    for (int n = 0; n < signal_length; n++)
+        {
+            const int chip = static_cast<int>(std::floor(n * code_freq_chips / static_cast<double>(fs_in))) % GPS_L2_M_CODE_LENGTH_CHIPS;
+            const double phase = GPS_L2_TWO_PI * doppler_hz * n / static_cast<double>(fs_in);
+            const gr_complex sample = engine.local_code()[chip] * gr_complex(200.0 * std::cos(phase), 200.0 * std::sin(phase));
+            in_16sc[n] = lv_16sc_t(std::round(sample.real()) + rand() % 41 - 20, std::round(sample.imag()) + rand() % 41 - 20);
+            in[n] = gr_complex(in_16sc[n].real(), in_16sc[n].imag());
+        }
+    engine.correlate(in);
+    engine_16sc.correlate(in_16sc);
+
+    // the 16-bit rotator rounds the wiped-off samples, which costs a small fraction of the prompt
+    const float prompt = std::abs(engine.prompt());
+    EXPECT_GT(prompt, 0.9 * 200.0 * signal_length);
+    for (int n = 0; n < Gps_L2_M_Tracking_Traits::n_taps; n++)
+        {
+            EXPECT_LT(std::abs(engine.outputs()[n] - engine_16sc.outputs()[n]), 0.01 * prompt);
+        }
+
+    volk_gnsssdr_free(in);
+    volk_gnsssdr_free(in_16sc);
+}
+
+
+TEST(Tracking_Engine_Test, MonitorTapsSampleThePeak)
+{
+    const long fs_in = 2000000;
+    const int signal_length = 40000;
+    const double doppler_hz = 300.0;
+
+    // three monitor taps on the early, prompt and late ones, and a wider set around them
+    Tracking_Engine<Gps_L2_M_Tracking_Traits, gr_complex> engine(fs_in, signal_length, 0.5);
+    Tracking_Engine<Gps_L2_M_Tracking_Traits, lv_16sc_t> engine_16sc(fs_in, signal_length, 0.5);
+    engine.set_monitor_taps(3, 0.5);
+    engine_16sc.set_monitor_taps(21, 0.1);
+    EXPECT_EQ(3, engine.n_monitor_taps());
+    EXPECT_EQ(21, engine_16sc.n_monitor_taps());
+    gps_l2c_m_code_gen_complex(engine.local_code(), 7);
+    gps_l2c_m_code_gen_complex(engine_16sc.local_code(), 7);
+    engine.start(doppler_hz, 0.0);
+    engine_16sc.start(doppler_hz, 0.0);
+
+    gr_complex* in = static_cast<gr_complex*>(volk_gnsssdr_malloc(signal_length * sizeof(gr_complex), volk_gnsssdr_get_alignment()));
+    lv_16sc_t* in_16sc = static_cast<lv_16sc_t*>(volk_gnsssdr_malloc(signal_length * sizeof(lv_16sc_t), volk_gnsssdr_get_alignment()));
+    const double code_freq_chips = GPS_L2_M_CODE_RATE_HZ * (GPS_L2_FREQ_HZ + doppler_hz) / GPS_L2_FREQ_HZ;
+    for (int n = 0; n < signal_length; n++)
+        {
+            const int chip = static_cast<int>(std::floor(n * code_freq_chips / static_cast<double>(fs_in))) % GPS_L2_M_CODE_LENGTH_CHIPS;
+            const double phase = GPS_L2_TWO_PI * doppler_hz * n / static_cast<double>(fs_in);
+            const gr_complex sample = engine.local_code()[chip] * gr_complex(200.0 * std::cos(phase), 200.0 * std::sin(phase));
+            in_16sc[n] = lv_16sc_t(std::round(sample.real()), std::round(sample.imag()));
+            in[n] = gr_complex(in_16sc[n].real(), in_16sc[n].imag());
+        }
+    engine.correlate(in);
+    engine_16sc.correlate(in_16sc);
+
+    // the taps between two sample lags are interpolated, which rounds the top of the peak
+    const float prompt = std::abs(engine.prompt());
+    EXPECT_GT(prompt, 0.9 * 200.0 * signal_length);
+    for (int n = 0; n < 3; n++)
+        {
+            EXPECT_LT(std::abs(engine.monitor_outputs()[n] - engine.outputs()[n]), 0.05 * prompt);
+        }
+    EXPECT_LT(std::abs(engine_16sc.monitor_outputs()[10] - engine.prompt()), 0.05 * prompt);
+    for (int n = 0; n < 10; n++)
+        {
+            EXPECT_LE(std::abs(engine_16sc.monitor_outputs()[n]), std::abs(engine_16sc.monitor_outputs()[n + 1]) + 0.01 * prompt);
+            EXPECT_LE(std::abs(engine_16sc.monitor_outputs()[20 - n]), std::abs(engine_16sc.monitor_outputs()[19 - n]) + 0.01 * prompt);
+        }
+    EXPECT_LT(std::abs(engine_16sc.monitor_outputs()[0]), 0.5 * prompt);
+
+    volk_gnsssdr_free(in);
+    volk_gnsssdr_free(in_16sc);
+}
+
+
+TEST(Tracking_Engine_Test, FixedPointLoopMatchesTheDoubleLoop)
+{
+    // the same Doppler and code errors, open loop, for 10 minutes of GPS L2CM at 4 Msps
+    const double fs_in = 4e6;
+    const int periods = 30000;
+    Tracking_Double_Loop<Gps_L2_M_Tracking_Traits> double_loop;
+    Tracking_Fixed_Point_Loop<Gps_L2_M_Tracking_Traits> fixed_loop;
+    double_loop.reset(fs_in, -2345.6, 100.0);
+    fixed_loop.reset(fs_in, -2345.6, 100.0);
+    EXPECT_EQ(double_loop.current_prn_length_samples(), fixed_loop.current_prn_length_samples());
+    EXPECT_FLOAT_EQ(static_cast<float>(double_loop.code_phase_step_chips()), fixed_loop.code_phase_step_chips());
+
+    // start of the code periods [samples]
+    long double_start = 0;
+    long fixed_start = 0;
+    int different_lengths = 0;
+    double max_code_error = 0.0;
+    for (int p = 0; p < periods; p++)
+        {
+            // the values a float loop filter gives, so that both loops get the same ones
+            const float doppler_hz = -2345.6f + 0.3f * std::sin(0.001f * p);
+            const float code_error_filt_chips = 0.02f * std::cos(0.0007f * p);
+            double_start += double_loop.current_prn_length_samples();
+            fixed_start += fixed_loop.current_prn_length_samples();
+            double_loop.update(doppler_hz, code_error_filt_chips);
+            fixed_loop.update(doppler_hz, code_error_filt_chips);
+            if (double_loop.current_prn_length_samples() != fixed_loop.current_prn_length_samples()) different_lengths++;
+            max_code_error = std::max(max_code_error, std::abs(static_cast<double>(double_start - fixed_start)
+                    + double_loop.period_start_rem_samples() - fixed_loop.period_start_rem_samples()));
+            ASSERT_NEAR(double_loop.code_phase_step_chips(), fixed_loop.code_phase_step_chips(), 2e-8);
+            ASSERT_NEAR(double_loop.carrier_phase_step_rad(), fixed_loop.carrier_phase_step_rad(), 1e-9);
+            ASSERT_NEAR(std::cos(double_loop.rem_carr_phase_rad()), std::cos(fixed_loop.rem_carr_phase_rad()), 1e-4);
+        }
+    // the code NCOs stay within a thousandth of a sample, so the lengths of
+    // the periods only differ when one is a half sample away from rounding up
+    EXPECT_LT(max_code_error, 1e-3);
+    EXPECT_LT(different_lengths, periods / 1000);
+    EXPECT_NEAR(double_loop.code_freq_chips(), fixed_loop.code_freq_chips(), 1e-6);
+    EXPECT_NEAR(double_loop.acc_code_phase_secs(), fixed_loop.acc_code_phase_secs(), 1e-12);
+    // the carrier phase of the float Doppler shifts, over 10 minutes, within a hundredth of a cycle
+    EXPECT_NEAR(double_loop.acc_carrier_phase_rad(), fixed_loop.acc_carrier_phase_rad(), GPS_L2_TWO_PI * 0.01);
+    std::cout << "Double and fixed point NCOs after " << periods << " periods: "
+              << max_code_error << " samples of code phase, "
+              << std::abs(double_loop.acc_carrier_phase_rad() - fixed_loop.acc_carrier_phase_rad()) / GPS_L2_TWO_PI
+              << " cycles of carrier phase apart" << std::endl;
+}
+
+
+namespace
+{
+// Tracks the satellite signal in, period by period, with the discriminators
+// and loop filters of the blocks, and stores the Doppler, the carrier phase
+// and the sample where each code period starts
+template <class Engine>
+void track_gps_l2cm(Engine & engine, const gr_complex* in, int periods, double acq_doppler_hz,
+        std::vector<double> & doppler_hz, std::vector<double> & carrier_phase_cycles, std::vector<double> & code_start_samples)
+{
+    Tracking_2nd_PLL_filter carrier_loop_filter(GPS_L2_M_PERIOD);
+    Tracking_2nd_DLL_filter code_loop_filter(GPS_L2_M_PERIOD);
+    carrier_loop_filter.set_PLL_BW(2.0);
+    code_loop_filter.set_DLL_BW(0.5);
+    carrier_loop_filter.initialize();
+    code_loop_filter.initialize();
+    engine.start(acq_doppler_hz, 0.0);
+    long sample = 0;
+    for (int p = 0; p < periods; p++)
+        {
+            engine.correlate(in + sample);
+            const typename Engine::real carr_error_filt_hz = carrier_loop_filter.get_carrier_nco(engine.carrier_error_cycles());
+            const typename Engine::real code_error_filt_chips = code_loop_filter.get_code_nco(engine.code_error_chips());
+            const long period_start = sample;
+            sample += engine.current_prn_length_samples();
+            engine.update(acq_doppler_hz + carr_error_filt_hz, code_error_filt_chips);
+            doppler_hz.push_back(engine.carrier_doppler_hz());
+            carrier_phase_cycles.push_back(engine.acc_carrier_phase_rad() / GPS_L2_TWO_PI);
+            code_start_samples.push_back(static_cast<double>(period_start) + engine.period_start_rem_samples());
+        }
+}
+}
+
+
+TEST(Tracking_Engine_Test, FixedPointLoopTracksLikeTheDoubleLoop)
+{
+    // 2 s of GPS L2CM at 2 Msps, 0.7 Hz away from the acquired Doppler shift
+    const long fs_in = 2000000;
+    const int periods = 100;
+    const double acq_doppler_hz = 1500.0;
+    const double doppler_hz = 1500.7;
+    const int signal_length = static_cast<int>(periods * GPS_L2_M_PERIOD * fs_in) + 1000;
+
+    std::vector<gr_complex> code(GPS_L2_M_CODE_LENGTH_CHIPS);
+    gps_l2c_m_code_gen_complex(code.data(), 5);
+    gr_complex* in = static_cast<gr_complex*>(volk_gnsssdr_malloc(signal_length * sizeof(gr_complex), volk_gnsssdr_get_alignment()));
+    const double code_freq_chips = GPS_L2_M_CODE_RATE_HZ * (GPS_L2_FREQ_HZ + doppler_hz) / GPS_L2_FREQ_HZ;
+    srand(7);
+    for (int n = 0; n < signal_length; n++)
+        {
+            const int chip = static_cast<int>(std::floor(n * code_freq_chips / static_cast<double>(fs_in))) % GPS_L2_M_CODE_LENGTH_CHIPS;
+            const double phase = GPS_L2_TWO_PI * doppler_hz * n / static_cast<double>(fs_in);
+            in[n] = code[chip] * gr_complex(std::cos(phase), std::sin(phase))
+                    + gr_complex(static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5,
+                                 static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5);
+        }
+
+    Tracking_Engine<Gps_L2_M_Tracking_Traits, gr_complex, Tracking_Double_Loop<Gps_L2_M_Tracking_Traits> > double_engine(fs_in, signal_length, 0.5);
+    Tracking_Engine<Gps_L2_M_Tracking_Traits, gr_complex, Tracking_Fixed_Point_Loop<Gps_L2_M_Tracking_Traits> > fixed_engine(fs_in, signal_length, 0.5);
+    gps_l2c_m_code_gen_complex(double_engine.local_code(), 5);
+    gps_l2c_m_code_gen_complex(fixed_engine.local_code(), 5);
+    std::vector<double> double_doppler, double_phase, double_start;
+    std::vector<double> fixed_doppler, fixed_phase, fixed_start;
+    track_gps_l2cm(double_engine, in, periods, acq_doppler_hz, double_doppler, double_phase, double_start);
+    track_gps_l2cm(fixed_engine, in, periods, acq_doppler_hz, fixed_doppler, fixed_phase, fixed_start);
+
+    // both lock, and stay together period by period
+    EXPECT_NEAR(doppler_hz, double_doppler.back(), 0.5);
+    EXPECT_NEAR(doppler_hz, fixed_doppler.back(), 0.5);
+    EXPECT_GT(std::abs(fixed_engine.prompt()), 0.9 * std::abs(double_engine.prompt()));
+    double max_doppler = 0.0;
+    double max_phase = 0.0;
+    double max_start = 0.0;
+    for (int p = 0; p < periods; p++)
+        {
+            max_doppler = std::max(max_doppler, std::abs(double_doppler[p] - fixed_doppler[p]));
+            max_phase = std::max(max_phase, std::abs(double_phase[p] - fixed_phase[p]));
+            max_start = std::max(max_start, std::abs(double_start[p] - fixed_start[p]));
+        }
+    EXPECT_LT(max_doppler, 0.01);
+    EXPECT_LT(max_phase, 0.001);
+    EXPECT_LT(max_start, 0.001);
+    std::cout << "Double and fixed point tracking, largest differences: " << max_doppler << " Hz, "
+              << max_phase << " cycles, " << max_start << " samples" << std::endl;
+
+    volk_gnsssdr_free(in);
+}
+
+
+namespace
+{
+// Same as track_gps_l2cm, for GPS L1 C/A with an engine of make_tracking_engine(),
+// as the GPS_L1_CA_DLL_PLL_Tracking block runs it
+void track_gps_l1_ca(Tracking_Engine_Base<Gps_L1_Ca_Tracking_Traits, gr_complex> & engine, const gr_complex* in, int periods,
+        double acq_doppler_hz, std::vector<double> & doppler_hz, std::vector<double> & carrier_phase_cycles,
+        std::vector<double> & code_start_samples)
+{
+    Tracking_2nd_PLL_filter carrier_loop_filter(GPS_L1_CA_CODE_PERIOD);
+    Tracking_2nd_DLL_filter code_loop_filter(GPS_L1_CA_CODE_PERIOD);
+    carrier_loop_filter.set_PLL_BW(15.0);
+    code_loop_filter.set_DLL_BW(2.0);
+    carrier_loop_filter.initialize();
+    code_loop_filter.initialize();
+    engine.start(acq_doppler_hz, 0.0);
+    long sample = 0;
+    for (int p = 0; p < periods; p++)
+        {
+            engine.correlate(in + sample);
+            const double carr_error_filt_hz = carrier_loop_filter.get_carrier_nco(engine.carrier_error_cycles());
+            const double code_error_filt_chips = code_loop_filter.get_code_nco(engine.code_error_chips());
+            const long period_start = sample;
+            sample += engine.current_prn_length_samples();
+            engine.update(acq_doppler_hz + carr_error_filt_hz, code_error_filt_chips);
+            doppler_hz.push_back(engine.carrier_doppler_hz());
+            carrier_phase_cycles.push_back(engine.acc_carrier_phase_rad() / GPS_TWO_PI);
+            code_start_samples.push_back(static_cast<double>(period_start) + engine.period_start_rem_samples());
+        }
+}
+}
+
+
+TEST(Tracking_Engine_Test, LoopArithmeticIsChosenAtRunTime)
+{
+    // the loop_arithmetic property of the tracking blocks
+    Tracking_Loop_Arithmetic float_arithmetic = TRACKING_LOOP_FIXED;
+    Tracking_Loop_Arithmetic fixed_arithmetic = TRACKING_LOOP_FLOAT;
+    ASSERT_TRUE(parse_tracking_loop_arithmetic("float", float_arithmetic));
+    ASSERT_TRUE(parse_tracking_loop_arithmetic("fixed", fixed_arithmetic));
+    EXPECT_EQ(TRACKING_LOOP_FLOAT, float_arithmetic);
+    EXPECT_EQ(TRACKING_LOOP_FIXED, fixed_arithmetic);
+    EXPECT_FALSE(parse_tracking_loop_arithmetic("double", fixed_arithmetic));
+    EXPECT_EQ(TRACKING_LOOP_FIXED, fixed_arithmetic);
+
+    // 0.5 s of GPS L1 C/A at 2.048 Msps, 0.4 Hz away from the acquired Doppler shift
+    const long fs_in = 2048000;
+    const int periods = 500;
+    const double acq_doppler_hz = -2300.0;
+    const double doppler_hz = -2300.4;
+    const int signal_length = static_cast<int>(periods * GPS_L1_CA_CODE_PERIOD * fs_in) + 4096;
+
+    std::vector<gr_complex> code(GPS_L1_CA_CODE_LENGTH_CHIPS);
+    gps_l1_ca_code_gen_complex(code.data(), 12, 0);
+    gr_complex* in = static_cast<gr_complex*>(volk_gnsssdr_malloc(signal_length * sizeof(gr_complex), volk_gnsssdr_get_alignment()));
+    const double code_freq_chips = GPS_L1_CA_CODE_RATE_HZ * (GPS_L1_FREQ_HZ + doppler_hz) / GPS_L1_FREQ_HZ;
+    srand(11);
+    for (int n = 0; n < signal_length; n++)
+        {
+            const int chip = static_cast<int>(std::floor(n * code_freq_chips / static_cast<double>(fs_in))) % static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS);
+            const double phase = GPS_TWO_PI * doppler_hz * n / static_cast<double>(fs_in);
+            in[n] = code[chip] * gr_complex(std::cos(phase), std::sin(phase))
+                    + gr_complex(static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5,
+                                 static_cast<float>(rand()) / static_cast<float>(RAND_MAX) - 0.5);
+        }
+
+    std::unique_ptr<Tracking_Engine_Base<Gps_L1_Ca_Tracking_Traits, gr_complex> > float_engine(
+            make_tracking_engine<Gps_L1_Ca_Tracking_Traits, gr_complex>(float_arithmetic, fs_in, 2 * 2048, 0.5));
+    std::unique_ptr<Tracking_Engine_Base<Gps_L1_Ca_Tracking_Traits, gr_complex> > fixed_engine(
+            make_tracking_engine<Gps_L1_Ca_Tracking_Traits, gr_complex>(fixed_arithmetic, fs_in, 2 * 2048, 0.5));
+    EXPECT_TRUE((dynamic_cast<Tracking_Engine<Gps_L1_Ca_Tracking_Traits, gr_complex, Tracking_Double_Loop<Gps_L1_Ca_Tracking_Traits> >*>(float_engine.get()) != 0));
+    EXPECT_TRUE((dynamic_cast<Tracking_Engine<Gps_L1_Ca_Tracking_Traits, gr_complex, Tracking_Fixed_Point_Loop<Gps_L1_Ca_Tracking_Traits> >*>(fixed_engine.get()) != 0));
+    gps_l1_ca_code_gen_complex(float_engine->local_code(), 12, 0);
+    gps_l1_ca_code_gen_complex(fixed_engine->local_code(), 12, 0);
+    std::vector<double> float_doppler, float_phase, float_start;
+    std::vector<double> fixed_doppler, fixed_phase, fixed_start;
+    track_gps_l1_ca(*float_engine, in, periods, acq_doppler_hz, float_doppler, float_phase, float_start);
+    track_gps_l1_ca(*fixed_engine, in, periods, acq_doppler_hz, fixed_doppler, fixed_phase, fixed_start);
+
+    // both lock, and stay together epoch by epoch
+    EXPECT_NEAR(doppler_hz, float_doppler.back(), 0.5);
+    EXPECT_NEAR(doppler_hz, fixed_doppler.back(), 0.5);
+    EXPECT_GT(std::abs(fixed_engine->prompt()), 0.9 * std::abs(float_engine->prompt()));
+    double max_doppler = 0.0;
+    double max_phase = 0.0;
+    double max_start = 0.0;
+    for (int p = 0; p < periods; p++)
+        {
+            max_doppler = std::max(max_doppler, std::abs(float_doppler[p] - fixed_doppler[p]));
+            max_phase = std::max(max_phase, std::abs(float_phase[p] - fixed_phase[p]));
+            max_start = std::max(max_start, std::abs(float_start[p] - fixed_start[p]));
+        }
+    EXPECT_LT(max_doppler, 0.01);
+    EXPECT_LT(max_phase, 0.001);
+    EXPECT_LT(max_start, 0.001);
+    std::cout << "GPS L1 C/A, float and fixed loop arithmetic, largest differences: " << max_doppler << " Hz, "
+              << max_phase << " cycles, " << max_start << " samples" << std::endl;
+
+    volk_gnsssdr_free(in);
+}
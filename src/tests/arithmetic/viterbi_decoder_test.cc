@@ -0,0 +1,184 @@
+/*!
+ * \file viterbi_decoder_test.cc
+ * \brief  This file implements tests for the Viterbi decoder, checking it
+ *  against the reference implementation of convolutional.h
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <sys/time.h>
+#include <gtest/gtest.h>
+#include "convolutional.h"
+#include "viterbi_decoder.h"
+
+
+namespace
+{
+// Galileo E1B / E5a convolutional code
+const int viterbi_test_KK = 7;
+const int viterbi_test_nn = 2;
+int viterbi_test_g[2] = { 121, 91 };
+
+// BPSK symbols (+1 for a 1) of bits encoded from the all-zeros state, plus uniform noise
+void viterbi_test_encode(const std::vector<int>& bits, double noise_amplitude, std::vector<double>& symbols)
+{
+    int state = 0;
+    int next_state[1];
+    symbols.resize(viterbi_test_nn * bits.size());
+    for (unsigned int t = 0; t < bits.size(); t++)
+        {
+            int out = nsc_enc_bit(next_state, bits[t], state, viterbi_test_g, viterbi_test_KK, viterbi_test_nn);
+            state = next_state[0];
+            for (int i = 0; i < viterbi_test_nn; i++)
+                {
+                    double noise = noise_amplitude * (2.0 * static_cast<double>(rand()) / static_cast<double>(RAND_MAX) - 1.0);
+                    symbols[viterbi_test_nn * t + i] = (((out >> (viterbi_test_nn - i - 1)) & 1) ? 1.0 : -1.0) + noise;
+                }
+        }
+}
+
+// random data bits followed by the mm zero tail bits
+std::vector<int> viterbi_test_bits(int n_data_bits)
+{
+    std::vector<int> bits(n_data_bits + viterbi_test_KK - 1, 0);
+    for (int t = 0; t < n_data_bits; t++)
+        {
+            bits[t] = rand() % 2;
+        }
+    return bits;
+}
+
+void viterbi_test_reference(std::vector<double>& symbols, int* bits, int n_data_bits)
+{
+    const int states = 1 << (viterbi_test_KK - 1);
+    std::vector<int> out0(states), out1(states), state0(states), state1(states);
+    nsc_transit(&out0[0], &state0[0], 0, viterbi_test_g, viterbi_test_KK, viterbi_test_nn);
+    nsc_transit(&out1[0], &state1[0], 1, viterbi_test_g, viterbi_test_KK, viterbi_test_nn);
+    Viterbi(bits, &out0[0], &state0[0], &out1[0], &state1[0], &symbols[0], viterbi_test_KK, viterbi_test_nn, n_data_bits);
+}
+}
+
+
+TEST(ViterbiDecoderTest, BlockDecodingMatchesReference)
+{
+    const int n_data_bits = 114;  // Galileo E1B page part
+    Viterbi_Decoder decoder(viterbi_test_g, viterbi_test_KK, viterbi_test_nn);
+    std::vector<int> decoded(n_data_bits);
+    std::vector<int> reference(n_data_bits);
+    std::vector<double> symbols;
+    for (int page = 0; page < 200; page++)
+        {
+            std::vector<int> bits = viterbi_test_bits(n_data_bits);
+            // from error free decoding to pages with errors
+            viterbi_test_encode(bits, 0.5 + 0.01 * page, symbols);
+            decoder.decode_block(&symbols[0], &decoded[0], n_data_bits);
+            viterbi_test_reference(symbols, &reference[0], n_data_bits);
+            for (int t = 0; t < n_data_bits; t++)
+                {
+                    ASSERT_EQ(reference[t], decoded[t]) << "page " << page << ", bit " << t;
+                    if (page < 50)
+                        {
+                            ASSERT_EQ(bits[t], decoded[t]) << "page " << page << ", bit " << t;
+                        }
+                }
+        }
+}
+
+
+TEST(ViterbiDecoderTest, ContinuousDecoding)
+{
+    const int n_bits = 3000;
+    const int chunk = 37;
+    const int traceback_depth = 5 * viterbi_test_KK;
+    Viterbi_Decoder decoder(viterbi_test_g, viterbi_test_KK, viterbi_test_nn);
+    std::vector<int> bits = viterbi_test_bits(n_bits);
+    std::vector<double> symbols;
+    viterbi_test_encode(bits, 0.5, symbols);
+
+    std::vector<int> decoded;
+    std::vector<int> chunk_bits(chunk);
+    float indicator_metric = 0;
+    for (int t = 0; t + chunk <= n_bits; t += chunk)
+        {
+            int nbits_decoded = 0;
+            indicator_metric = decoder.decode_continuous(&symbols[viterbi_test_nn * t], traceback_depth,
+                    &chunk_bits[0], chunk, nbits_decoded);
+            ASSERT_LE(nbits_decoded, chunk);
+            decoded.insert(decoded.end(), chunk_bits.begin(), chunk_bits.begin() + nbits_decoded);
+        }
+    // everything but the last traceback depth has been decoded
+    ASSERT_EQ((n_bits / chunk) * chunk - traceback_depth, static_cast<int>(decoded.size()));
+    for (unsigned int t = 0; t < decoded.size(); t++)
+        {
+            ASSERT_EQ(bits[t], decoded[t]) << "bit " << t;
+        }
+    // the survivor branch metric of an error free path is the sum of the symbol magnitudes
+    EXPECT_NEAR(2.0, indicator_metric, 0.5);
+}
+
+
+TEST(ViterbiDecoderTest, DecodingTime)
+{
+    const int n_data_bits = 244;  // Galileo E5a page
+    const int n_pages = 2000;
+    Viterbi_Decoder decoder(viterbi_test_g, viterbi_test_KK, viterbi_test_nn);
+    std::vector<int> bits = viterbi_test_bits(n_data_bits);
+    std::vector<double> symbols;
+    viterbi_test_encode(bits, 0.8, symbols);
+    std::vector<int> decoded(n_data_bits);
+    std::vector<int> reference(n_data_bits);
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    long long int begin = tv.tv_sec * 1000000 + tv.tv_usec;
+    for (int page = 0; page < n_pages; page++)
+        {
+            viterbi_test_reference(symbols, &reference[0], n_data_bits);
+        }
+    gettimeofday(&tv, NULL);
+    long long int end = tv.tv_sec * 1000000 + tv.tv_usec;
+    std::cout << "Reference Viterbi decoding of " << n_pages << " Galileo E5a pages finished in "
+              << (end - begin) << " microseconds" << std::endl;
+
+    gettimeofday(&tv, NULL);
+    begin = tv.tv_sec * 1000000 + tv.tv_usec;
+    for (int page = 0; page < n_pages; page++)
+        {
+            decoder.decode_block(&symbols[0], &decoded[0], n_data_bits);
+        }
+    gettimeofday(&tv, NULL);
+    end = tv.tv_sec * 1000000 + tv.tv_usec;
+    std::cout << "Viterbi_Decoder decoding of " << n_pages << " Galileo E5a pages finished in "
+              << (end - begin) << " microseconds" << std::endl;
+
+    for (int t = 0; t < n_data_bits; t++)
+        {
+            ASSERT_EQ(reference[t], decoded[t]);
+        }
+}
@@ -31,7 +31,10 @@
 
 
 #include <string>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <map>
 #include "file_configuration.h"
 
 
@@ -71,3 +74,54 @@ TEST(File_Configuration_Test, PropertyDoesNotExist)
     std::string value = configuration->property("whatever.whatever", default_value);
     EXPECT_STREQ("default_value", value.c_str());
 }
+
+
+
+TEST(File_Configuration_Test, ReloadReturnsChangedProperties)
+{
+    std::string filename = "./file_configuration_reload_test.conf";
+    std::ofstream file(filename.c_str());
+    file << "[GNSS-SDR]" << std::endl << "Tracking_1C.pll_bw_hz=50" << std::endl << "Tracking_1C.dll_bw_hz=2" << std::endl;
+    file.close();
+    FileConfiguration configuration(filename);
+    EXPECT_DOUBLE_EQ(50.0, configuration.property("Tracking_1C.pll_bw_hz", 0.0));
+
+    file.open(filename.c_str());
+    file << "[GNSS-SDR]" << std::endl << "Tracking_1C.pll_bw_hz=30" << std::endl << "Tracking_1C.dll_bw_hz=2" << std::endl
+         << "PVT.output_rate_ms=100" << std::endl;
+    file.close();
+    std::map<std::string, std::string> changed = configuration.reload();
+    EXPECT_EQ(2u, changed.size());
+    EXPECT_EQ("30", changed["tracking_1c.pll_bw_hz"]);
+    EXPECT_EQ("100", changed["pvt.output_rate_ms"]);
+    EXPECT_DOUBLE_EQ(30.0, configuration.property("Tracking_1C.pll_bw_hz", 0.0));
+    EXPECT_TRUE(configuration.reload().empty());
+    std::remove(filename.c_str());
+}
+
+
+
+TEST(File_Configuration_Test, TypedProperties)
+{
+    std::string filename = "./file_configuration_typed_test.conf";
+    std::ofstream file(filename.c_str());
+    file << "[GNSS-SDR]" << std::endl << "Acquisition_1C.dump=true" << std::endl
+         << "Acquisition_1C.doppler_max=10000" << std::endl << "Acquisition_1C.threshold=0.005" << std::endl
+         << "Acquisition_1C.item_type=gr_complex" << std::endl << "Acquisition_1C.if=not_a_number" << std::endl;
+    file.close();
+    FileConfiguration configuration(filename);
+    // the names are case-insensitive, and the values are converted as by StringConverter
+    EXPECT_TRUE(configuration.property("acquisition_1c.DUMP", false));
+    EXPECT_EQ(10000u, configuration.property("Acquisition_1C.doppler_max", 0u));
+    EXPECT_EQ(10000, configuration.property("Acquisition_1C.doppler_max", 0));
+    EXPECT_EQ(10000L, configuration.property("Acquisition_1C.doppler_max", 0L));
+    EXPECT_EQ(10000, configuration.property("Acquisition_1C.doppler_max", static_cast<unsigned short>(0)));
+    EXPECT_FLOAT_EQ(0.005, configuration.property("Acquisition_1C.threshold", 0.0f));
+    EXPECT_DOUBLE_EQ(0.005, configuration.property("Acquisition_1C.threshold", 0.0));
+    EXPECT_EQ(0, configuration.property("Acquisition_1C.threshold", 1));
+    EXPECT_EQ("gr_complex", configuration.property("Acquisition_1C.item_type", std::string("cshort")));
+    EXPECT_EQ(-1, configuration.property("Acquisition_1C.if", -1));
+    EXPECT_FALSE(configuration.property("Acquisition_1C.item_type", false));
+    EXPECT_EQ(7, configuration.property("Acquisition_1C.not_there", 7));
+    std::remove(filename.c_str());
+}
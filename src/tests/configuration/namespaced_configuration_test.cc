@@ -0,0 +1,62 @@
+/*!
+ * \file namespaced_configuration_test.cc
+ * \brief Tests of the configuration of the receivers hosted by MultiReceiver.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <memory>
+#include "in_memory_configuration.h"
+#include "namespaced_configuration.h"
+
+TEST(NamespacedConfiguration, NamespaceOverridesShared)
+{
+    std::shared_ptr<InMemoryConfiguration> shared = std::make_shared<InMemoryConfiguration>();
+    shared->set_property("SignalSource.filename", "antenna1.dat");
+    shared->set_property("Receiver1.SignalSource.filename", "antenna2.dat");
+    shared->set_property("GNSS-SDR.internal_fs_hz", "4000000");
+    NamespacedConfiguration receiver0(shared, "Receiver0");
+    NamespacedConfiguration receiver1(shared, "Receiver1");
+    EXPECT_EQ("antenna1.dat", receiver0.property("SignalSource.filename", std::string("")));
+    EXPECT_EQ("antenna2.dat", receiver1.property("SignalSource.filename", std::string("")));
+    EXPECT_DOUBLE_EQ(4000000.0, receiver1.property("GNSS-SDR.internal_fs_hz", 2048000.0));
+    EXPECT_EQ(7, receiver1.property("Channels_1C.count", 7));
+}
+
+TEST(NamespacedConfiguration, SetOnlyInNamespace)
+{
+    std::shared_ptr<InMemoryConfiguration> shared = std::make_shared<InMemoryConfiguration>();
+    shared->set_property("GNSS-SDR.receiver_index", "0");
+    NamespacedConfiguration receiver0(shared, "Receiver0");
+    NamespacedConfiguration receiver1(shared, "Receiver1");
+    receiver1.set_property("GNSS-SDR.receiver_index", "1");
+    receiver1.set_property("GNSS-SDR.shared_navigation_data", "true");
+    EXPECT_EQ(0u, receiver0.property("GNSS-SDR.receiver_index", 5u));
+    EXPECT_EQ(1u, receiver1.property("GNSS-SDR.receiver_index", 5u));
+    EXPECT_FALSE(receiver0.property("GNSS-SDR.shared_navigation_data", false));
+    EXPECT_TRUE(receiver1.property("GNSS-SDR.shared_navigation_data", false));
+    EXPECT_EQ("1", shared->property("Receiver1.GNSS-SDR.receiver_index", std::string("")));
+}
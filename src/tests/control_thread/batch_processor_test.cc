@@ -0,0 +1,78 @@
+/*!
+ * \file batch_processor_test.cc
+ * \brief Tests of the split of a capture file in the batch mode.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <vector>
+#include <gtest/gtest.h>
+#include "batch_processor.h"
+
+
+TEST(Batch_Processor_Test, SegmentsCoverTheCapture)
+{
+    const unsigned long long items = 1000003;
+    std::vector<BatchProcessor::Segment> plan = BatchProcessor::plan(items, 4, 0, 1);
+    ASSERT_EQ(4u, plan.size());
+    unsigned long long next = 0;
+    for (unsigned int k = 0; k < plan.size(); k++)
+        {
+            EXPECT_EQ(next, plan[k].start);
+            next = plan[k].start + plan[k].items;
+        }
+    EXPECT_EQ(items, next);
+}
+
+
+TEST(Batch_Processor_Test, SegmentsOverlap)
+{
+    // complex samples: 2 items each, the segments start at whole samples
+    const unsigned long long items = 8000000;
+    const unsigned long long overlap = 100001;
+    std::vector<BatchProcessor::Segment> plan = BatchProcessor::plan(items, 3, overlap, 2);
+    ASSERT_EQ(3u, plan.size());
+    EXPECT_EQ(0u, plan[0].start);
+    for (unsigned int k = 0; k < plan.size(); k++)
+        {
+            EXPECT_EQ(0u, plan[k].start % 2);
+            EXPECT_EQ(0u, plan[k].items % 2);
+            if (k > 0)
+                {
+                    const unsigned long long previous_end = plan[k - 1].start + plan[k - 1].items;
+                    EXPECT_LE(plan[k].start + overlap, previous_end);
+                    EXPECT_GT(plan[k].start + overlap + 2, previous_end);
+                }
+        }
+    EXPECT_EQ(items, plan[2].start + plan[2].items);
+}
+
+
+TEST(Batch_Processor_Test, TooShort)
+{
+    EXPECT_TRUE(BatchProcessor::plan(3, 4, 0, 1).empty());
+    EXPECT_TRUE(BatchProcessor::plan(1000, 0, 0, 1).empty());
+}
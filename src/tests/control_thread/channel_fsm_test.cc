@@ -0,0 +1,175 @@
+/*!
+ * \file channel_fsm_test.cc
+ * \brief Tests of the channel state machine
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "channel_fsm.h"
+#include "control_event_bus.h"
+
+
+namespace
+{
+class Counting_Acquisition : public AcquisitionInterface
+{
+public:
+    Counting_Acquisition() : resets(0) {}
+    std::string role() { return "Acquisition"; }
+    std::string implementation() { return "Counting_Acquisition"; }
+    size_t item_size() { return 0; }
+    void connect(gr::top_block_sptr top_block __attribute__((unused))) {}
+    void disconnect(gr::top_block_sptr top_block __attribute__((unused))) {}
+    gr::basic_block_sptr get_left_block() { return nullptr; }
+    gr::basic_block_sptr get_right_block() { return nullptr; }
+    void set_gnss_synchro(Gnss_Synchro* gnss_synchro __attribute__((unused))) {}
+    void set_channel(unsigned int channel __attribute__((unused))) {}
+    void set_threshold(float threshold __attribute__((unused))) {}
+    void set_doppler_max(unsigned int doppler_max __attribute__((unused))) {}
+    void set_doppler_step(unsigned int doppler_step __attribute__((unused))) {}
+    void init() {}
+    void set_local_code() {}
+    signed int mag() { return 0; }
+    void reset() { resets++; }
+    std::atomic<int> resets;
+};
+
+
+class Counting_Tracking : public TrackingInterface
+{
+public:
+    Counting_Tracking() : starts(0) {}
+    std::string role() { return "Tracking"; }
+    std::string implementation() { return "Counting_Tracking"; }
+    size_t item_size() { return 0; }
+    void connect(gr::top_block_sptr top_block __attribute__((unused))) {}
+    void disconnect(gr::top_block_sptr top_block __attribute__((unused))) {}
+    gr::basic_block_sptr get_left_block() { return nullptr; }
+    gr::basic_block_sptr get_right_block() { return nullptr; }
+    void start_tracking() { starts++; }
+    void set_gnss_synchro(Gnss_Synchro* gnss_synchro __attribute__((unused))) {}
+    void set_channel(unsigned int channel __attribute__((unused))) {}
+    std::atomic<int> starts;
+};
+
+
+std::vector<unsigned int> channel_events(const boost::shared_ptr<Control_Event_Bus> & bus)
+{
+    std::vector<unsigned int> events;
+    ControlMessage event;
+    while (bus->try_event(event))
+        {
+            EXPECT_EQ(4u, event.who);
+            events.push_back(event.what);
+        }
+    return events;
+}
+}
+
+
+TEST(Channel_Fsm_Test, Transitions)
+{
+    std::shared_ptr<Counting_Acquisition> acq = std::make_shared<Counting_Acquisition>();
+    std::shared_ptr<Counting_Tracking> trk = std::make_shared<Counting_Tracking>();
+    boost::shared_ptr<Control_Event_Bus> bus = Control_Event_Bus::make();
+    ChannelFsm fsm(acq);
+    fsm.set_tracking(trk);
+    fsm.set_queue(bus);
+    fsm.set_channel(4);
+    EXPECT_EQ(channel_idle_fsm_S0, fsm.state());
+
+    // Only the start of the acquisition leaves the idle state
+    EXPECT_FALSE(fsm.process_event(Ev_channel_valid_acquisition));
+    fsm.Event_start_acquisition();
+    EXPECT_EQ(channel_acquiring_fsm_S1, fsm.state());
+    EXPECT_EQ(1, acq->resets);
+
+    // Repeating the acquisition enters S1 again
+    fsm.Event_failed_acquisition_repeat();
+    EXPECT_EQ(channel_acquiring_fsm_S1, fsm.state());
+    EXPECT_EQ(2, acq->resets);
+
+    fsm.Event_valid_acquisition();
+    EXPECT_EQ(channel_tracking_fsm_S2, fsm.state());
+    EXPECT_EQ(1, trk->starts);
+    fsm.Event_failed_tracking_standby();
+    EXPECT_EQ(channel_idle_fsm_S0, fsm.state());
+
+    fsm.Event_start_acquisition();
+    fsm.Event_failed_acquisition_no_repeat();
+    EXPECT_EQ(channel_waiting_fsm_S3, fsm.state());
+    EXPECT_FALSE(fsm.process_event(Ev_channel_failed_tracking_standby));
+    fsm.Event_start_acquisition();
+    fsm.Event_valid_acquisition();
+
+    // Leaving the tracking state on termination reports the loss of lock
+    fsm.terminate();
+    EXPECT_EQ(channel_terminated_fsm, fsm.state());
+    EXPECT_FALSE(fsm.process_event(Ev_channel_start_acquisition));
+    EXPECT_EQ(4, acq->resets);
+
+    std::vector<unsigned int> expected = {Control_Event_Bus::acquisition_success, Control_Event_Bus::loss_of_lock,
+            Control_Event_Bus::acquisition_failed, Control_Event_Bus::acquisition_success, Control_Event_Bus::loss_of_lock};
+    EXPECT_EQ(expected, channel_events(bus));
+}
+
+
+TEST(Channel_Fsm_Test, ConcurrentEvents)
+{
+    std::shared_ptr<Counting_Acquisition> acq = std::make_shared<Counting_Acquisition>();
+    std::shared_ptr<Counting_Tracking> trk = std::make_shared<Counting_Tracking>();
+    ChannelFsm fsm(acq);
+    fsm.set_tracking(trk);
+
+    // Each cycle is S0 -> S1 -> S2 -> S0, and only this thread leaves S0
+    const int cycles = 1000;
+    std::thread acquisition([&]()
+        {
+            for (int i = 0; i < cycles; i++)
+                {
+                    while (fsm.state() != channel_idle_fsm_S0) std::this_thread::yield();
+                    EXPECT_TRUE(fsm.process_event(Ev_channel_start_acquisition));
+                    EXPECT_TRUE(fsm.process_event(Ev_channel_valid_acquisition));
+                }
+        });
+    std::thread tracking([&]()
+        {
+            for (int i = 0; i < cycles; i++)
+                {
+                    while (!fsm.process_event(Ev_channel_failed_tracking_standby)) std::this_thread::yield();
+                }
+        });
+    acquisition.join();
+    tracking.join();
+    EXPECT_EQ(channel_idle_fsm_S0, fsm.state());
+    EXPECT_EQ(cycles, acq->resets);
+    EXPECT_EQ(cycles, trk->starts);
+}
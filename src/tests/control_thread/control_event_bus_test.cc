@@ -0,0 +1,72 @@
+/*!
+ * \file control_event_bus_test.cc
+ * \brief  This file implements tests for the Control_Event_Bus.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <gtest/gtest.h>
+#include "control_event_bus.h"
+#include "control_message_factory.h"
+
+
+TEST(Control_Event_Bus_Test, TypedAndQueueMessages)
+{
+    boost::shared_ptr<Control_Event_Bus> bus = Control_Event_Bus::make();
+    gr::msg_queue::sptr queue = bus;
+    ControlMessage event;
+    EXPECT_FALSE(bus->try_event(event));
+
+    Control_Event_Bus::send(queue, 3, Control_Event_Bus::loss_of_lock);
+    ControlMessageFactory factory;
+    queue->handle(factory.GetQueueMessage(Control_Event_Bus::receiver, Control_Event_Bus::stop));
+
+    ASSERT_TRUE(bus->wait_event(event, 100));
+    EXPECT_EQ(3u, event.who);
+    EXPECT_EQ(Control_Event_Bus::loss_of_lock, event.what);
+    ASSERT_TRUE(bus->try_event(event));
+    EXPECT_EQ(Control_Event_Bus::receiver, event.who);
+    EXPECT_EQ(Control_Event_Bus::stop, event.what);
+    EXPECT_FALSE(bus->wait_event(event, 10));
+    // nothing goes through the gr::msg_queue itself
+    EXPECT_EQ(0u, queue->count());
+}
+
+
+TEST(Control_Event_Bus_Test, SendToPlainQueue)
+{
+    gr::msg_queue::sptr queue = gr::msg_queue::make(0);
+    Control_Event_Bus::send(queue, 5, Control_Event_Bus::acquisition_success);
+    Control_Event_Bus::send(gr::msg_queue::sptr(), 5, Control_Event_Bus::acquisition_failed);
+    ASSERT_EQ(1u, queue->count());
+
+    ControlMessageFactory factory;
+    auto control_messages = factory.GetControlMessages(queue->delete_head());
+    ASSERT_EQ(1u, control_messages->size());
+    EXPECT_EQ(5u, control_messages->at(0)->who);
+    EXPECT_EQ(Control_Event_Bus::acquisition_success, control_messages->at(0)->what);
+}
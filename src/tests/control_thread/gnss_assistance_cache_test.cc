@@ -0,0 +1,82 @@
+/*!
+ * \file gnss_assistance_cache_test.cc
+ * \brief  This file implements tests for the Gnss_Assistance_Cache.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <gtest/gtest.h>
+#include "gnss_assistance_cache.h"
+
+
+TEST(Gnss_Assistance_Cache_Test, AgeOfTheFile)
+{
+    const std::string filename = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    Gnss_Assistance_Cache cache(filename, 7200.0, 600.0);
+    const std::time_t now = std::time(0);
+    EXPECT_LT(cache.age_s(now), 0.0);
+    EXPECT_FALSE(cache.fresh(now));
+    EXPECT_DOUBLE_EQ(0.0, cache.refresh_in_s(now));
+
+    std::ofstream(filename.c_str()) << "<ephemeris/>";
+    boost::filesystem::last_write_time(filename, now - 1000);
+    EXPECT_DOUBLE_EQ(1000.0, cache.age_s(now));
+    EXPECT_TRUE(cache.fresh(now));
+    EXPECT_DOUBLE_EQ(7200.0 - 600.0 - 1000.0, cache.refresh_in_s(now));
+
+    // due, but still used until a request succeeds
+    boost::filesystem::last_write_time(filename, now - 7000);
+    EXPECT_TRUE(cache.fresh(now));
+    EXPECT_DOUBLE_EQ(0.0, cache.refresh_in_s(now));
+
+    boost::filesystem::last_write_time(filename, now - 7200);
+    EXPECT_FALSE(cache.fresh(now));
+
+    // written after now, by a clock that went backwards
+    boost::filesystem::last_write_time(filename, now + 100);
+    EXPECT_FALSE(cache.fresh(now));
+    boost::filesystem::remove(filename);
+}
+
+
+TEST(Gnss_Assistance_Cache_Test, MarginIsClamped)
+{
+    const std::string filename = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    std::ofstream(filename.c_str()) << "<ephemeris/>";
+    const std::time_t now = std::time(0);
+    boost::filesystem::last_write_time(filename, now);
+
+    Gnss_Assistance_Cache cache(filename, 100.0, 1000.0);
+    EXPECT_DOUBLE_EQ(50.0, cache.refresh_in_s(now));
+    Gnss_Assistance_Cache no_margin(filename, 100.0, -5.0);
+    EXPECT_DOUBLE_EQ(100.0, no_margin.refresh_in_s(now));
+    boost::filesystem::remove(filename);
+}
@@ -0,0 +1,62 @@
+/*!
+ * \file gnss_metrics_server_test.cc
+ * \brief  This file implements tests for the Gnss_Metrics_Server.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <string>
+#include <boost/asio.hpp>
+#include <gtest/gtest.h>
+#include "gnss_metrics_server.h"
+
+
+TEST(Gnss_Metrics_Server_Test, AnswersWithTheContent)
+{
+    unsigned int requests = 0;
+    Gnss_Metrics_Server server(0, [&requests]() { requests++; return std::string("gnss_sdr_block_load 0.5\n"); });
+    ASSERT_TRUE(server.start());
+    ASSERT_NE(0, server.port());
+
+    for (unsigned int i = 0; i < 2; i++)
+        {
+            boost::asio::io_service io_service;
+            boost::asio::ip::tcp::socket socket(io_service);
+            socket.connect(boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), server.port()));
+            std::string request = "GET /metrics HTTP/1.0\r\n\r\n";
+            boost::asio::write(socket, boost::asio::buffer(request));
+            boost::asio::streambuf response;
+            boost::system::error_code ec;
+            boost::asio::read(socket, response, ec);
+            EXPECT_EQ(boost::asio::error::eof, ec);
+            std::string text((std::istreambuf_iterator<char>(&response)), std::istreambuf_iterator<char>());
+            EXPECT_EQ(0u, text.find("HTTP/1.0 200 OK\r\n"));
+            EXPECT_NE(std::string::npos, text.find("\r\n\r\ngnss_sdr_block_load 0.5\n"));
+        }
+    server.stop();
+    EXPECT_EQ(2u, requests);
+}
@@ -0,0 +1,257 @@
+/*!
+ * \file binary_dump_test.cc
+ * \brief  This file implements tests for the self-describing binary dump
+ *  files and their memory-mapped reader
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include "acquisition_grid_dump.h"
+#include "binary_dump_reader.h"
+#include "binary_dump_writer.h"
+
+
+namespace
+{
+void write_test_records(const std::string & filename, unsigned int n_records, unsigned int buffer_records, bool async_flush)
+{
+    Binary_Dump_Writer writer("test_block", buffer_records, async_flush);
+    writer.add_field("time_s", BINARY_DUMP_FLOAT64);
+    writer.add_field("sample_counter", BINARY_DUMP_UINT64);
+    writer.add_field("prompt_I", BINARY_DUMP_FLOAT32);
+    writer.add_field("valid", BINARY_DUMP_UINT8);
+    writer.add_field("prn", BINARY_DUMP_INT32);
+    ASSERT_TRUE(writer.open(filename));
+    EXPECT_EQ(25u, writer.record_size());
+    for (unsigned int i = 0; i < n_records; i++)
+        {
+            writer.write(0.001 * i);
+            writer.write(static_cast<unsigned long int>(4000000000ull + 4000 * i));
+            writer.write(static_cast<float>(i) - 0.5f);
+            writer.write(i % 2 == 0);
+            writer.write(i % 32 + 1);
+        }
+    EXPECT_EQ(n_records, writer.records());
+    writer.close();
+}
+
+
+void check_test_records(const std::string & filename, unsigned int n_records)
+{
+    Binary_Dump_Reader reader;
+    ASSERT_TRUE(reader.open(filename));
+    EXPECT_EQ(0, reader.block_type().compare("test_block"));
+    EXPECT_EQ(static_cast<unsigned int>(BINARY_DUMP_VERSION), reader.version());
+    ASSERT_EQ(5u, reader.num_fields());
+    EXPECT_EQ(0, reader.field_name(2).compare("prompt_I"));
+    EXPECT_EQ(BINARY_DUMP_UINT64, reader.field_type(1));
+    EXPECT_EQ(4, reader.field_index("prn"));
+    EXPECT_EQ(-1, reader.field_index("unknown"));
+    ASSERT_EQ(n_records, reader.num_records());
+    for (unsigned int i = 0; i < n_records; i++)
+        {
+            EXPECT_DOUBLE_EQ(0.001 * i, reader.value(i, 0));
+            EXPECT_DOUBLE_EQ(4000000000.0 + 4000.0 * i, reader.value(i, 1));
+            EXPECT_FLOAT_EQ(static_cast<float>(i) - 0.5f, reader.value(i, 2));
+            EXPECT_DOUBLE_EQ(i % 2 == 0 ? 1.0 : 0.0, reader.value(i, 3));
+            EXPECT_DOUBLE_EQ(i % 32 + 1, reader.value(i, 4));
+        }
+    std::vector<double> prn = reader.column(reader.field_index("prn"));
+    ASSERT_EQ(n_records, prn.size());
+    EXPECT_DOUBLE_EQ(2.0, prn[1]);
+    EXPECT_EQ(nullptr, reader.record(n_records));
+}
+}
+
+
+TEST(Binary_Dump_Test, WriteAndReadBack)
+{
+    const std::string filename = "./binary_dump_test.dat";
+    // the last buffer is written partially full
+    write_test_records(filename, 1000, 64, false);
+    check_test_records(filename, 1000);
+    std::remove(filename.c_str());
+}
+
+
+TEST(Binary_Dump_Test, AsyncFlush)
+{
+    const std::string filename = "./binary_dump_test_async.dat";
+    write_test_records(filename, 5000, 16, true);
+    check_test_records(filename, 5000);
+    std::remove(filename.c_str());
+}
+
+
+TEST(Binary_Dump_Test, SharedIoThread)
+{
+    // like one dump per tracking channel: several files share the I/O thread
+    const unsigned int n_writers = 4;
+    const unsigned int n_records = 20000;
+    boost::thread_group writers;
+    for (unsigned int w = 0; w < n_writers; w++)
+        {
+            const std::string filename = "./binary_dump_test_shared" + std::to_string(w) + ".dat";
+            writers.create_thread(boost::bind(&write_test_records, filename, n_records, 1024, true));
+        }
+    writers.join_all();
+    for (unsigned int w = 0; w < n_writers; w++)
+        {
+            const std::string filename = "./binary_dump_test_shared" + std::to_string(w) + ".dat";
+            check_test_records(filename, n_records);
+            std::remove(filename.c_str());
+        }
+}
+
+
+TEST(Binary_Dump_Test, TruncatedRecordIgnored)
+{
+    const std::string filename = "./binary_dump_test_truncated.dat";
+    write_test_records(filename, 10, 1024, false);
+    {
+        std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary | std::ios::app);
+        file.write("partial", 7);
+    }
+    check_test_records(filename, 10);
+    std::remove(filename.c_str());
+}
+
+
+TEST(Binary_Dump_Test, RejectsOtherFiles)
+{
+    const std::string filename = "./binary_dump_test_raw.dat";
+    {
+        std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary);
+        const double values[16] = {};
+        file.write(reinterpret_cast<const char *>(values), sizeof(values));
+    }
+    Binary_Dump_Reader reader;
+    EXPECT_FALSE(reader.open(filename));
+    EXPECT_FALSE(reader.is_open());
+    EXPECT_FALSE(reader.open("./nonexistent_binary_dump.dat"));
+    std::remove(filename.c_str());
+}
+
+
+TEST(Binary_Dump_Test, ArrayFields)
+{
+    const std::string filename = "./binary_dump_test_array.dat";
+    {
+        Binary_Dump_Writer writer("test_block", 4, true);
+        writer.add_field("epoch", BINARY_DUMP_UINT32);
+        writer.add_field("grid", BINARY_DUMP_FLOAT32, 6);
+        writer.add_field("counts", BINARY_DUMP_INT16, 3);
+        ASSERT_TRUE(writer.open(filename));
+        EXPECT_EQ(34u, writer.record_size());
+        float grid[6];
+        short counts[3];
+        for (unsigned int i = 0; i < 10; i++)
+            {
+                for (unsigned int k = 0; k < 6; k++) grid[k] = 10.0f * i + k;
+                for (unsigned int k = 0; k < 3; k++) counts[k] = -static_cast<short>(i + k);
+                writer.write(i);
+                writer.write_array(grid, 6);
+                writer.write_array(counts, 3);
+            }
+        EXPECT_EQ(10u, writer.records());
+    }
+    Binary_Dump_Reader reader;
+    ASSERT_TRUE(reader.open(filename));
+    EXPECT_EQ(static_cast<unsigned int>(BINARY_DUMP_VERSION_ARRAYS), reader.version());
+    ASSERT_EQ(3u, reader.num_fields());
+    EXPECT_EQ(1u, reader.field_count(0));
+    EXPECT_EQ(6u, reader.field_count(1));
+    EXPECT_EQ(BINARY_DUMP_INT16, reader.field_type(2));
+    ASSERT_EQ(10u, reader.num_records());
+    for (unsigned int i = 0; i < 10; i++)
+        {
+            EXPECT_DOUBLE_EQ(i, reader.value(i, 0));
+            EXPECT_DOUBLE_EQ(10.0 * i + 5, reader.value(i, 1, 5));
+            EXPECT_DOUBLE_EQ(-static_cast<double>(i + 2), reader.value(i, 2, 2));
+        }
+    std::vector<double> column = reader.column(1, 3);
+    ASSERT_EQ(10u, column.size());
+    EXPECT_DOUBLE_EQ(93.0, column[9]);
+    std::remove(filename.c_str());
+}
+
+
+TEST(Binary_Dump_Test, AcquisitionGridRegionOfInterest)
+{
+    const std::string filename = "./binary_dump_test_acq_grid.dat";
+    const unsigned int bins = 9;
+    const unsigned int delays = 100;
+    {
+        // Delays decimated by 4 into 25 cells; 2 cells and 1 bin kept on each side of the peak
+        Acquisition_Grid_Dump dump(4, 8, 1);
+        for (unsigned int search = 0; search < 2; search++)
+            {
+                dump.begin(bins, delays);
+                for (unsigned int b = 0; b < bins; b++)
+                    {
+                        float * row = dump.row(b);
+                        for (unsigned int d = 0; d < delays; d++) row[d] = static_cast<float>(b * 1000 + d);
+                    }
+                // Peak at the last bin and near the end of the code: the delays wrap, the bins do not
+                Acquisition_Grid_Search s;
+                s.samplestamp = 4000 * search;
+                s.prn = 7;
+                s.well_count = search + 1;
+                s.first_doppler_hz = -2000.0;
+                s.doppler_step_hz = 500.0;
+                s.peak_doppler_bin = bins - 1;
+                s.peak_delay = 98;
+                s.test_statistic = 3.0;
+                s.threshold = 2.5;
+                dump.end(filename, s);
+            }
+        EXPECT_EQ(2u, dump.records());
+    }
+    Binary_Dump_Reader reader;
+    ASSERT_TRUE(reader.open(filename));
+    ASSERT_EQ(2u, reader.num_records());
+    const int grid = reader.field_index("grid");
+    ASSERT_GE(grid, 0);
+    ASSERT_EQ(15u, reader.field_count(grid));
+    EXPECT_DOUBLE_EQ(3.0, reader.value(1, reader.field_index("doppler_bins")));
+    EXPECT_DOUBLE_EQ(1000.0, reader.value(1, reader.field_index("first_doppler_hz")));
+    EXPECT_DOUBLE_EQ(2000.0, reader.value(1, reader.field_index("peak_doppler_hz")));
+    EXPECT_DOUBLE_EQ(88.0, reader.value(1, reader.field_index("first_delay_samples")));
+    EXPECT_DOUBLE_EQ(4.0, reader.value(1, reader.field_index("delay_step_samples")));
+    // Row 0 is bin 6; cells 22, 23, 24, 0, 1 hold the maximum of their 4 delays
+    const double expected[5] = {91.0, 95.0, 99.0, 3.0, 7.0};
+    for (unsigned int c = 0; c < 5; c++)
+        {
+            EXPECT_DOUBLE_EQ(6000.0 + expected[c], reader.value(1, grid, c));
+            EXPECT_DOUBLE_EQ(8000.0 + expected[c], reader.value(1, grid, 10 + c));
+        }
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,137 @@
+/*!
+ * \file compressed_capture_test.cc
+ * \brief Tests of the lossless compression of sample files
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "compressed_capture.h"
+
+
+TEST(Compressed_Capture_Test, RoundTrip)
+{
+    // Quantized noise: 16-bit samples of a few bits, and 2-bit samples packed four per byte
+    std::mt19937 generator(1);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::vector<int16_t> ishort(300001);
+    for (unsigned int i = 0; i < ishort.size(); i++)
+        {
+            ishort[i] = static_cast<int16_t>(std::lround(40.0 * noise(generator)));
+        }
+    ishort[10] = -32768;
+    ishort[11] = 32767;
+    std::vector<unsigned char> packed(200000);
+    for (unsigned int i = 0; i < packed.size(); i++)
+        {
+            for (unsigned int k = 0; k < 4; k++)
+                {
+                    const double x = 0.5 * noise(generator);
+                    packed[i] |= (x < -1.0 ? 0 : (x < 0.0 ? 1 : (x < 1.0 ? 2 : 3))) << (2 * k);
+                }
+        }
+
+    const std::string filename = "./compressed_capture_test.gsc";
+    const struct { const char * item_type; const unsigned char * data; size_t bytes; double min_ratio; } cases[] = {
+            { "ishort", reinterpret_cast<const unsigned char *>(ishort.data()), ishort.size() * sizeof(int16_t), 2.0 },
+            { "byte", packed.data(), packed.size(), 1.2 } };
+    for (unsigned int c = 0; c < 2; c++)
+        {
+            Compressed_Capture_Writer writer;
+            ASSERT_TRUE(writer.open(filename, cases[c].item_type, 4e6, 65536, 3));
+            // writes of any size, not aligned to the chunks
+            size_t written = 0;
+            for (size_t n = 1; written < cases[c].bytes; n = n * 3 + 7)
+                {
+                    const size_t size = std::min(n, cases[c].bytes - written);
+                    ASSERT_TRUE(writer.write(cases[c].data + written, size));
+                    written += size;
+                }
+            ASSERT_TRUE(writer.close());
+            EXPECT_GT(static_cast<double>(writer.raw_bytes()) / writer.compressed_bytes(), cases[c].min_ratio) << cases[c].item_type;
+
+            Compressed_Capture_Reader reader;
+            ASSERT_TRUE(reader.open(filename));
+            EXPECT_EQ(std::string(cases[c].item_type), reader.item_type());
+            EXPECT_EQ(4e6, reader.sample_rate());
+            ASSERT_EQ(cases[c].bytes, reader.raw_bytes());
+            EXPECT_EQ((cases[c].bytes + 65535) / 65536, reader.chunks());
+
+            // backwards, to read the chunks at random
+            std::vector<unsigned char> raw(reader.chunks() * reader.chunk_bytes());
+            std::vector<unsigned char> scratch;
+            for (size_t i = reader.chunks(); i-- > 0; )
+                {
+                    ASSERT_TRUE(reader.read_chunk(i, &raw[i * reader.chunk_bytes()], scratch)) << i;
+                }
+            EXPECT_EQ(0, std::memcmp(raw.data(), cases[c].data, cases[c].bytes)) << cases[c].item_type;
+        }
+    std::remove(filename.c_str());
+}
+
+
+TEST(Compressed_Capture_Test, Chunks)
+{
+    // a single symbol, data that does not compress, and an odd number of 16-bit bytes
+    std::vector<unsigned char> zeros(1000, 0);
+    std::vector<unsigned char> random(1000);
+    std::mt19937 generator(2);
+    for (unsigned int i = 0; i < random.size(); i++) random[i] = static_cast<unsigned char>(generator());
+    const std::vector<unsigned char> * inputs[2] = { &zeros, &random };
+    for (unsigned int i = 0; i < 2; i++)
+        {
+            for (unsigned int model = 0; model < 2; model++)
+                {
+                    const size_t bytes = inputs[i]->size() - model;
+                    std::vector<unsigned char> chunk;
+                    compressed_capture_encode_chunk(inputs[i]->data(), bytes, static_cast<Compressed_Capture_Model>(model), chunk);
+                    EXPECT_LE(chunk.size(), bytes + COMPRESSED_CAPTURE_CHUNK_HEADER_SIZE);
+                    std::vector<unsigned char> decoded(bytes);
+                    ASSERT_TRUE(compressed_capture_decode_chunk(chunk.data(), chunk.size(), static_cast<Compressed_Capture_Model>(model), decoded.data(), bytes));
+                    EXPECT_EQ(0, std::memcmp(decoded.data(), inputs[i]->data(), bytes));
+                }
+        }
+    std::vector<unsigned char> chunk;
+    compressed_capture_encode_chunk(zeros.data(), zeros.size(), COMPRESSED_CAPTURE_BYTES, chunk);
+    EXPECT_LT(chunk.size(), 300u);  // one bit per byte
+
+    // corrupt chunks are rejected
+    std::vector<unsigned char> decoded(zeros.size());
+    EXPECT_FALSE(compressed_capture_decode_chunk(chunk.data(), chunk.size() - 1, COMPRESSED_CAPTURE_BYTES, decoded.data(), decoded.size()));
+    EXPECT_FALSE(compressed_capture_decode_chunk(chunk.data(), chunk.size(), COMPRESSED_CAPTURE_BYTES, decoded.data(), decoded.size() - 1));
+    chunk[COMPRESSED_CAPTURE_CHUNK_HEADER_SIZE] = 0xFF;
+    EXPECT_FALSE(compressed_capture_decode_chunk(chunk.data(), chunk.size(), COMPRESSED_CAPTURE_BYTES, decoded.data(), decoded.size()));
+
+    Compressed_Capture_Reader reader;
+    EXPECT_FALSE(reader.open("./compressed_capture_test_missing.gsc"));
+}
@@ -0,0 +1,124 @@
+/*!
+ * \file crc24q_test.cc
+ * \brief  This file implements tests and a timing benchmark for the CRC-24Q
+ *  of the RTCM messages
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstdlib>
+#include <vector>
+#include <sys/time.h>
+#include <boost/crc.hpp>
+#include "gnss_crc24q.h"
+
+DEFINE_int32(crc24q_iterations_test, 20000, "Number of frames in the CRC-24Q timing test");
+
+
+TEST(Crc24q_Test, KnownFrame)
+{
+    auto rtcm = std::make_shared<Rtcm>();
+    std::string frame = rtcm->bin_to_binary_data(rtcm->hex_to_bin("D300133ED7D30202980EDEEF34B4BD62AC0941986F33360B98"));
+    const unsigned char * bytes = reinterpret_cast<const unsigned char *>(frame.data());
+    EXPECT_EQ(static_cast<uint32_t>(0x360B98), Gnss_Crc24q::checksum(bytes, frame.length() - 3));
+    EXPECT_EQ(static_cast<uint32_t>(0x360B98), Gnss_Crc24q::checksum_bytewise(bytes, frame.length() - 3));
+    EXPECT_EQ(static_cast<uint32_t>(0), Gnss_Crc24q::checksum(bytes, 0));
+}
+
+
+TEST(Crc24q_Test, MatchesBoostCrc)
+{
+    std::vector<unsigned char> data(3 + 1023 + 3);
+    std::srand(1234);
+    for (unsigned int i = 0; i < data.size(); i++)
+        {
+            data[i] = static_cast<unsigned char>(std::rand() & 0xFF);
+        }
+    // every tail length of the slicing loop, and the longest RTCM frame
+    for (unsigned int length = 0; length <= data.size(); length++)
+        {
+            boost::crc_optimal<24, 0x1864CFBu, 0x0, 0x0, false, false> crc_boost;
+            crc_boost.process_bytes(data.data(), length);
+            ASSERT_EQ(crc_boost.checksum(), Gnss_Crc24q::checksum(data.data(), length)) << "length " << length;
+            ASSERT_EQ(crc_boost.checksum(), Gnss_Crc24q::checksum_bytewise(data.data(), length)) << "length " << length;
+        }
+}
+
+
+TEST(Crc24q_Test, LongMsmFramesTiming)
+{
+    // MSM7 of 32 satellites, with two signals each
+    auto rtcm = std::make_shared<Rtcm>();
+    Gps_Ephemeris gps_eph = Gps_Ephemeris();
+    Gps_CNAV_Ephemeris gps_cnav_eph = Gps_CNAV_Ephemeris();
+    gps_eph.i_satellite_PRN = 1;
+    std::map<int, Gnss_Synchro> pseudoranges;
+    for (int i = 0; i < 64; i++)
+        {
+            Gnss_Synchro gnss_synchro;
+            gnss_synchro.PRN = 1 + i / 2;
+            gnss_synchro.System = 'G';
+            std::memcpy(static_cast<void*>(gnss_synchro.Signal), (i % 2) ? "2S" : "1C", 3);
+            gnss_synchro.Pseudorange_m = 20000000.0 + 10123.4 * i;
+            gnss_synchro.Carrier_phase_rads = 1.0e6 + 345.6 * i;
+            gnss_synchro.Carrier_Doppler_hz = -2500.0 + 80.0 * i;
+            gnss_synchro.CN0_dB_hz = 40.0;
+            pseudoranges.insert(std::pair<int, Gnss_Synchro>(i, gnss_synchro));
+        }
+    std::string msm7 = rtcm->print_MSM_7(gps_eph, gps_cnav_eph, Galileo_Ephemeris(), 100.0, pseudoranges, 1234, 0, 0, 0, false, false);
+    ASSERT_LT(static_cast<unsigned int>(800), msm7.length());
+    EXPECT_EQ(true, rtcm->check_CRC(msm7));
+
+    const unsigned char * bytes = reinterpret_cast<const unsigned char *>(msm7.data());
+    const size_t length = msm7.length() - 3;
+    uint32_t crc_bytewise = 0;
+    uint32_t crc_slicing = 0;
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    long long int begin = tv.tv_sec * 1000000 + tv.tv_usec;
+    for (int k = 0; k < FLAGS_crc24q_iterations_test; k++)
+        {
+            crc_bytewise ^= Gnss_Crc24q::checksum_bytewise(bytes, length - (k & 1));
+        }
+    gettimeofday(&tv, NULL);
+    long long int end = tv.tv_sec * 1000000 + tv.tv_usec;
+    std::cout << "CRC-24Q of " << FLAGS_crc24q_iterations_test << " MSM7 frames of " << msm7.length()
+              << " bytes, one byte per step, finished in " << (end - begin) << " microseconds" << std::endl;
+
+    gettimeofday(&tv, NULL);
+    begin = tv.tv_sec * 1000000 + tv.tv_usec;
+    for (int k = 0; k < FLAGS_crc24q_iterations_test; k++)
+        {
+            crc_slicing ^= Gnss_Crc24q::checksum(bytes, length - (k & 1));
+        }
+    gettimeofday(&tv, NULL);
+    end = tv.tv_sec * 1000000 + tv.tv_usec;
+    std::cout << "CRC-24Q of " << FLAGS_crc24q_iterations_test << " MSM7 frames of " << msm7.length()
+              << " bytes, slicing-by-8, finished in " << (end - begin) << " microseconds" << std::endl;
+
+    EXPECT_EQ(crc_bytewise, crc_slicing);
+}
@@ -0,0 +1,200 @@
+/*!
+ * \file gps_navigation_message_encoder_test.cc
+ * \brief  This file implements tests for the encoder of the GPS NAV message
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstring>
+#include <gtest/gtest.h>
+#include "gps_navigation_message.h"
+#include "gps_navigation_message_encoder.h"
+
+#define _rotl(X,N)  ((X << N) ^ (X >> (32-N)))
+
+// Parity check of gps_l1_ca_telemetry_decoder_cc, on the word with D29* and D30* on top
+static bool gps_encoder_test_parity(unsigned int gpsword)
+{
+    unsigned int d1, d2, d3, d4, d5, d6, d7, t, parity;
+    d1 = gpsword & 0xFBFFBF00;
+    d2 = _rotl(gpsword,1) & 0x07FFBF01;
+    d3 = _rotl(gpsword,2) & 0xFC0F8100;
+    d4 = _rotl(gpsword,3) & 0xF81FFE02;
+    d5 = _rotl(gpsword,4) & 0xFC00000E;
+    d6 = _rotl(gpsword,5) & 0x07F00001;
+    d7 = _rotl(gpsword,6) & 0x00003000;
+    t = d1 ^ d2 ^ d3 ^ d4 ^ d5 ^ d6 ^ d7;
+    parity = t ^ _rotl(t,6) ^ _rotl(t,12) ^ _rotl(t,18) ^ _rotl(t,24);
+    parity = parity & 0x3F;
+    return parity == (gpsword & 0x3F);
+}
+
+
+// Subframe count, as received by the telemetry decoder
+static void gps_encoder_test_subframe(const Gps_Navigation_Message_Encoder & encoder, long int count,
+        unsigned int & previous_word, char subframe[GPS_SUBFRAME_LENGTH])
+{
+    unsigned int words[10];
+    encoder.subframe(count, words);
+    for (int w = 0; w < 10; w++)
+        {
+            unsigned int word = words[w] | ((previous_word & 3) << 30);
+            if (word & 0x40000000)
+                {
+                    word ^= 0x3FFFFFC0;
+                }
+            EXPECT_TRUE(gps_encoder_test_parity(word)) << "subframe " << count << " word " << w;
+            std::memcpy(&subframe[w * GPS_WORD_LENGTH], &word, GPS_WORD_LENGTH);
+            previous_word = words[w];
+        }
+}
+
+
+TEST(GpsNavigationMessageEncoderTest, SubframesDecodeToTheEphemeris)
+{
+    Gps_Ephemeris eph;
+    eph.i_satellite_PRN = 7;
+    eph.i_GPS_week = 1885;
+    eph.i_SV_accuracy = 2;
+    eph.i_SV_health = 0;
+    eph.i_code_on_L2 = 1;
+    eph.d_TGD = -1.1641532182693481e-08;
+    eph.d_IODC = 37;
+    eph.d_Toc = 388800;
+    eph.d_A_f0 = 8.354848250746727e-05;
+    eph.d_A_f1 = -1.7053025658242404e-12;
+    eph.d_A_f2 = 0;
+    eph.d_IODE_SF2 = 37;
+    eph.d_IODE_SF3 = 37;
+    eph.d_Crs = -112.875;
+    eph.d_Delta_n = 1.4262e-09;
+    eph.d_M_0 = -0.4875;
+    eph.d_Cuc = -5.8766454458236694e-06;
+    eph.d_e_eccentricity = 0.011418885062448680;
+    eph.d_Cus = 7.1860849857330322e-06;
+    eph.d_sqrt_A = 5153.6532917022705;
+    eph.d_Toe = 388800;
+    eph.d_Cic = 1.3038516044616699e-07;
+    eph.d_OMEGA0 = 0.3567;
+    eph.d_Cis = -7.4505805969238281e-08;
+    eph.d_i_0 = 0.3060;
+    eph.d_Crc = 245.34375;
+    eph.d_OMEGA = -0.7451;
+    eph.d_OMEGA_DOT = -2.604e-09;
+    eph.d_IDOT = 1.93e-11;
+
+    Gps_Navigation_Message_Encoder encoder(eph);
+    Gps_Navigation_Message nav;
+    const long int first_subframe = 390000 / GPS_SUBFRAME_SECONDS;  // subframe 1
+    unsigned int previous_word = 0;
+    for (long int count = first_subframe; count < first_subframe + 5; count++)
+        {
+            char subframe[GPS_SUBFRAME_LENGTH];
+            gps_encoder_test_subframe(encoder, count, previous_word, subframe);
+            EXPECT_EQ(0u, previous_word & 3);
+            EXPECT_EQ(static_cast<int>(count - first_subframe) + 1, nav.subframe_decoder(subframe));
+            EXPECT_DOUBLE_EQ(static_cast<double>(count * GPS_SUBFRAME_SECONDS), nav.d_TOW);
+        }
+
+    Gps_Ephemeris decoded = nav.get_ephemeris();
+    EXPECT_EQ(eph.i_GPS_week % 1024, decoded.i_GPS_week);  // 10 bits, with no rollover
+    EXPECT_EQ(eph.i_SV_accuracy, decoded.i_SV_accuracy);
+    EXPECT_EQ(eph.i_code_on_L2, decoded.i_code_on_L2);
+    EXPECT_DOUBLE_EQ(eph.d_IODC, decoded.d_IODC);
+    EXPECT_DOUBLE_EQ(eph.d_IODE_SF2, decoded.d_IODE_SF2);
+    EXPECT_DOUBLE_EQ(eph.d_IODE_SF3, decoded.d_IODE_SF3);
+    EXPECT_DOUBLE_EQ(eph.d_Toc, decoded.d_Toc);
+    EXPECT_DOUBLE_EQ(eph.d_Toe, decoded.d_Toe);
+    EXPECT_NEAR(eph.d_TGD, decoded.d_TGD, T_GD_LSB / 2);
+    EXPECT_NEAR(eph.d_A_f0, decoded.d_A_f0, A_F0_LSB / 2);
+    EXPECT_NEAR(eph.d_A_f1, decoded.d_A_f1, A_F1_LSB / 2);
+    EXPECT_NEAR(eph.d_Crs, decoded.d_Crs, C_RS_LSB / 2);
+    EXPECT_NEAR(eph.d_Delta_n, decoded.d_Delta_n, DELTA_N_LSB / 2);
+    EXPECT_NEAR(eph.d_M_0, decoded.d_M_0, M_0_LSB / 2);
+    EXPECT_NEAR(eph.d_Cuc, decoded.d_Cuc, C_UC_LSB / 2);
+    EXPECT_NEAR(eph.d_e_eccentricity, decoded.d_e_eccentricity, E_LSB / 2);
+    EXPECT_NEAR(eph.d_Cus, decoded.d_Cus, C_US_LSB / 2);
+    EXPECT_NEAR(eph.d_sqrt_A, decoded.d_sqrt_A, SQRT_A_LSB / 2);
+    EXPECT_NEAR(eph.d_Cic, decoded.d_Cic, C_IC_LSB / 2);
+    EXPECT_NEAR(eph.d_OMEGA0, decoded.d_OMEGA0, OMEGA_0_LSB / 2);
+    EXPECT_NEAR(eph.d_Cis, decoded.d_Cis, C_IS_LSB / 2);
+    EXPECT_NEAR(eph.d_i_0, decoded.d_i_0, I_0_LSB / 2);
+    EXPECT_NEAR(eph.d_Crc, decoded.d_Crc, C_RC_LSB / 2);
+    EXPECT_NEAR(eph.d_OMEGA, decoded.d_OMEGA, OMEGA_LSB / 2);
+    EXPECT_NEAR(eph.d_OMEGA_DOT, decoded.d_OMEGA_DOT, OMEGA_DOT_LSB / 2);
+    EXPECT_NEAR(eph.d_IDOT, decoded.d_IDOT, I_DOT_LSB / 2);
+}
+
+
+TEST(GpsNavigationMessageEncoderTest, RepeatedSubframesDecodeOnlyTheTow)
+{
+    Gps_Ephemeris eph;
+    eph.i_satellite_PRN = 7;
+    eph.i_GPS_week = 1885;
+    eph.d_IODC = 37;
+    eph.d_IODE_SF2 = 37;
+    eph.d_IODE_SF3 = 37;
+    eph.d_Toc = 388800;
+    eph.d_Toe = 388800;
+    eph.d_sqrt_A = 5153.6532917022705;
+    eph.d_e_eccentricity = 0.011418885062448680;
+
+    Gps_Navigation_Message nav;
+    const long int first_subframe = 390000 / GPS_SUBFRAME_SECONDS;
+    unsigned int previous_word = 0;
+    char subframe[GPS_SUBFRAME_LENGTH];
+    Gps_Navigation_Message_Encoder encoder(eph);
+    for (long int count = first_subframe; count < first_subframe + 10; count++)
+        {
+            gps_encoder_test_subframe(encoder, count, previous_word, subframe);
+            EXPECT_EQ(static_cast<int>((count - first_subframe) % 5) + 1, nav.subframe_decoder(subframe));
+            EXPECT_EQ(count >= first_subframe + 5, nav.b_subframe_repeated) << "subframe " << count;
+            EXPECT_DOUBLE_EQ(static_cast<double>(count * GPS_SUBFRAME_SECONDS), nav.d_TOW);
+        }
+    EXPECT_DOUBLE_EQ(static_cast<double>((first_subframe + 8) * GPS_SUBFRAME_SECONDS + 6), nav.d_TOW_SF4);
+    EXPECT_TRUE(nav.satellite_validation());
+
+    // A new issue of the ephemeris is decoded
+    eph.d_IODC = 38;
+    eph.d_IODE_SF2 = 38;
+    eph.d_IODE_SF3 = 38;
+    eph.d_Toe = 396000;
+    Gps_Navigation_Message_Encoder upload(eph);
+    for (long int count = first_subframe + 10; count < first_subframe + 13; count++)
+        {
+            gps_encoder_test_subframe(upload, count, previous_word, subframe);
+            nav.subframe_decoder(subframe);
+            EXPECT_FALSE(nav.b_subframe_repeated) << "subframe " << count;
+        }
+    Gps_Ephemeris decoded = nav.get_ephemeris();
+    EXPECT_DOUBLE_EQ(38, decoded.d_IODE_SF3);
+    EXPECT_DOUBLE_EQ(396000, decoded.d_Toe);
+
+    nav.reset();
+    gps_encoder_test_subframe(upload, first_subframe + 10, previous_word, subframe);
+    nav.subframe_decoder(subframe);
+    EXPECT_FALSE(nav.b_subframe_repeated);
+}
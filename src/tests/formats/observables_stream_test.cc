@@ -0,0 +1,210 @@
+/*!
+ * \file observables_stream_test.cc
+ * \brief Tests of the observables stream from the edge receivers to a central PVT
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "observables_stream.h"
+
+
+namespace
+{
+// Measurements of channel c at epoch e, 1 ms apart, with a satellite change
+// on channel 1 at epoch 30 and no valid outputs on channel 2 for a while
+Gnss_Synchro observables_stream_item(unsigned int c, unsigned int e)
+{
+    Gnss_Synchro s = Gnss_Synchro();
+    s.System = (c == 3) ? 'E' : 'G';
+    std::memcpy(s.Signal, (c == 3) ? "1B" : "1C", 3);
+    s.PRN = (c == 1 and e >= 30) ? 17 : 3 + c;
+    s.Channel_ID = c;
+    s.correlation_length_ms = 1;
+    const bool valid = !(c == 2 and e >= 10 and e < 20);
+    s.Flag_valid_symbol_output = valid;
+    s.Flag_valid_word = valid;
+    s.Flag_valid_pseudorange = valid;
+    s.Flag_preamble = (e % 20 == 0);
+    const double t = e * 1e-3;
+    s.Pseudorange_m = 2.1e7 + 1000.0 * c + 650.3 * t + 0.2 * t * t;
+    s.Carrier_phase_rads = 1.0e5 * c - 2.0 * M_PI * 3412.7 * t;
+    s.Carrier_Doppler_hz = -3412.7 + 0.8 * t;
+    s.CN0_dB_hz = 44.0 + 0.1 * std::sin(e);
+    s.d_TOW_at_current_symbol = 345600.0 + t;
+    s.d_TOW_hybrid_at_current_symbol = 345600.0 + t;
+    s.Tracking_timestamp_secs = 12.0 + t + 1e-7 * c;
+    s.Prn_timestamp_ms = 12000.0 + e + 1e-4 * c;
+    s.Code_phase_secs = 1e-7 * std::cos(e);
+    s.Prompt_I = 1234.5 + e;
+    s.Prompt_Q = -12.25;
+    return s;
+}
+
+
+void observables_stream_expect_near(const Gnss_Synchro & a, const Gnss_Synchro & b, bool tracking)
+{
+    EXPECT_EQ(a.System, b.System);
+    EXPECT_STREQ(a.Signal, b.Signal);
+    EXPECT_EQ(a.PRN, b.PRN);
+    EXPECT_EQ(a.Channel_ID, b.Channel_ID);
+    EXPECT_EQ(a.Flag_valid_pseudorange, b.Flag_valid_pseudorange);
+    EXPECT_EQ(a.Flag_valid_word, b.Flag_valid_word);
+    EXPECT_EQ(a.Flag_preamble, b.Flag_preamble);
+    if (!a.Flag_valid_pseudorange) return;
+    EXPECT_NEAR(a.Pseudorange_m, b.Pseudorange_m, 0.5e-4);
+    EXPECT_NEAR(a.Carrier_phase_rads, b.Carrier_phase_rads, 0.5e-4);
+    EXPECT_NEAR(a.Carrier_Doppler_hz, b.Carrier_Doppler_hz, 0.5e-3);
+    EXPECT_NEAR(a.CN0_dB_hz, b.CN0_dB_hz, 0.5e-2);
+    EXPECT_NEAR(a.d_TOW_at_current_symbol, b.d_TOW_at_current_symbol, 1e-9);
+    EXPECT_NEAR(a.d_TOW_hybrid_at_current_symbol, b.d_TOW_hybrid_at_current_symbol, 1e-9);
+    EXPECT_NEAR(a.Tracking_timestamp_secs, b.Tracking_timestamp_secs, 1e-9);
+    EXPECT_NEAR(a.Prn_timestamp_ms, b.Prn_timestamp_ms, 1e-6);
+    if (tracking)
+        {
+            EXPECT_NEAR(a.Code_phase_secs, b.Code_phase_secs, 1e-12);
+            EXPECT_FLOAT_EQ(a.Prompt_I, b.Prompt_I);
+            EXPECT_FLOAT_EQ(a.Prompt_Q, b.Prompt_Q);
+        }
+}
+}
+
+
+TEST(Observables_Stream_Test, RoundTrip)
+{
+    const unsigned int channels = 4;
+    for (int tracking = 0; tracking < 2; tracking++)
+        {
+            Observables_Stream_Encoder encoder(channels, tracking);
+            std::string stream = encoder.hello("station-1");
+            std::vector<Gnss_Synchro> items(channels);
+            std::vector<const Gnss_Synchro*> in(channels);
+            for (unsigned int e = 0; e < 50; e++)
+                {
+                    for (unsigned int c = 0; c < channels; c++)
+                        {
+                            items[c] = observables_stream_item(c, e);
+                            in[c] = &items[c];
+                        }
+                    encoder.add_epoch(in.data());
+                    if (encoder.epochs() == 16) stream += encoder.batch();
+                }
+            stream += encoder.batch();
+            Gps_Ephemeris eph = Gps_Ephemeris();
+            eph.i_satellite_PRN = 17;
+            eph.d_Toe = 345600.0;
+            eph.d_sqrt_A = 5153.6;
+            stream += Observables_Stream_Encoder::nav(OBSERVABLES_STREAM_GPS_EPHEMERIS, observables_stream_save(eph));
+
+            // received in pieces of any size
+            Observables_Stream_Decoder decoder;
+            for (std::size_t pos = 0; pos < stream.size(); pos += 7)
+                {
+                    decoder.push(stream.data() + pos, std::min<std::size_t>(7, stream.size() - pos));
+                }
+            ASSERT_FALSE(decoder.error());
+            ASSERT_TRUE(decoder.has_station());
+            EXPECT_EQ("station-1", decoder.station());
+            EXPECT_EQ(channels, decoder.channels());
+            EXPECT_EQ(tracking == 1, decoder.tracking_outputs());
+            ASSERT_EQ(50u, decoder.pending_epochs());
+            std::vector<Gnss_Synchro> epoch;
+            for (unsigned int e = 0; e < 50; e++)
+                {
+                    ASSERT_TRUE(decoder.next_epoch(epoch));
+                    ASSERT_EQ(channels, epoch.size());
+                    for (unsigned int c = 0; c < channels; c++)
+                        {
+                            observables_stream_expect_near(observables_stream_item(c, e), epoch[c], tracking);
+                        }
+                }
+            EXPECT_FALSE(decoder.next_epoch(epoch));
+
+            unsigned char record = 0;
+            std::string archive;
+            ASSERT_TRUE(decoder.next_nav(record, archive));
+            boost::any object;
+            ASSERT_TRUE(observables_stream_load(record, archive, object));
+            ASSERT_TRUE(object.type() == typeid(std::shared_ptr<Gps_Ephemeris>));
+            std::shared_ptr<Gps_Ephemeris> loaded = boost::any_cast<std::shared_ptr<Gps_Ephemeris> >(object);
+            EXPECT_EQ(17u, loaded->i_satellite_PRN);
+            EXPECT_DOUBLE_EQ(345600.0, loaded->d_Toe);
+            EXPECT_DOUBLE_EQ(5153.6, loaded->d_sqrt_A);
+        }
+}
+
+
+TEST(Observables_Stream_Test, Compactness)
+{
+    // one second of 12 channels tracking smoothly, in batches of 100 epochs
+    const unsigned int channels = 12;
+    Observables_Stream_Encoder encoder(channels, false);
+    std::vector<Gnss_Synchro> items(channels);
+    std::vector<const Gnss_Synchro*> in(channels);
+    std::size_t bytes = 0;
+    for (unsigned int e = 0; e < 1000; e++)
+        {
+            for (unsigned int c = 0; c < channels; c++)
+                {
+                    items[c] = observables_stream_item(c % 2, e);
+                    items[c].Channel_ID = c;
+                    items[c].Flag_valid_pseudorange = true;
+                    in[c] = &items[c];
+                }
+            encoder.add_epoch(in.data());
+            if (encoder.epochs() == 100) bytes += encoder.batch().size();
+        }
+    const double bytes_per_item = static_cast<double>(bytes) / (1000.0 * channels);
+    std::cout << "Observables stream: " << bytes_per_item << " bytes per channel and epoch, "
+              << sizeof(Gnss_Synchro) << " bytes per Gnss_Synchro" << std::endl;
+    EXPECT_LT(bytes_per_item, 16.0);
+}
+
+
+TEST(Observables_Stream_Test, MalformedStream)
+{
+    Observables_Stream_Decoder decoder;
+    Observables_Stream_Encoder encoder(1, false);
+    std::string hello = encoder.hello("x");
+    hello[0] = 'X';
+    decoder.push(hello.data(), hello.size());
+    EXPECT_TRUE(decoder.error());
+    EXPECT_FALSE(decoder.has_station());
+
+    // a new connection starts over
+    decoder.reset();
+    std::string batch = encoder.hello("x") + encoder.batch();
+    batch[batch.size() - 1] = static_cast<char>(0x05); // one epoch announced, none sent
+    decoder.push(batch.data(), batch.size());
+    EXPECT_TRUE(decoder.error());
+    EXPECT_EQ(0u, decoder.pending_epochs());
+}
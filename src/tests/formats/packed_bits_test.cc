@@ -0,0 +1,97 @@
+/*!
+ * \file packed_bits_test.cc
+ * \brief  This file implements tests for the packed navigation message bits
+ *  and the field extraction of the navigation message parsers
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <bitset>
+#include <cstdlib>
+#include <string>
+#include <gtest/gtest.h>
+#include "gnss_packed_bits.h"
+
+
+TEST(PackedBitsTest, ReadsFieldsAsBitset)
+{
+    const int n_bits = 300;
+    std::string message;
+    for (int i = 0; i < n_bits; i++)
+        {
+            message.push_back((rand() % 2) ? '1' : '0');
+        }
+    Gnss_Packed_Bits<n_bits> bits;
+    bits.set_bits(1, message.c_str(), n_bits);
+    std::bitset<n_bits> reference(message);  // bit 1 of the message is the MSB of the bitset
+
+    for (int trial = 0; trial < 1000; trial++)
+        {
+            const int length_1 = 1 + rand() % 32;
+            const int length_2 = rand() % 2 ? 1 + rand() % 16 : 0;
+            const Gnss_Bit_Field field = {{ {1 + rand() % (n_bits - length_1), length_1}, {1 + rand() % (n_bits - 16), length_2} }};
+
+            unsigned long int expected = 0;
+            for (int s = 0; s < GNSS_BIT_FIELD_MAX_SLICES; s++)
+                {
+                    for (int j = 0; j < field.slices[s].length; j++)
+                        {
+                            expected = (expected << 1) | reference[n_bits - field.slices[s].first - j];
+                        }
+                }
+            const int length = length_1 + length_2;
+            signed long int expected_signed = static_cast<signed long int>(expected);
+            if (reference[n_bits - field.slices[0].first])
+                {
+                    expected_signed -= static_cast<signed long int>(1L << length);
+                }
+
+            ASSERT_EQ(expected, bits.read_unsigned(field));
+            ASSERT_EQ(expected_signed, bits.read_signed(field));
+            ASSERT_EQ(reference[n_bits - field.slices[0].first] == 1, bits.read_bool(field));
+        }
+}
+
+
+TEST(PackedBitsTest, WritesWordsAndBytes)
+{
+    // two 30-bit words, as in a GPS subframe
+    Gnss_Packed_Bits<60> words;
+    words.set_bits(1, 30, 0x2AAAAAAAu);
+    words.set_bits(31, 30, 0x00000001u);
+    EXPECT_EQ(0x2AAAAAAAu, words.read_bits(1, 30));
+    EXPECT_EQ((0x2AAAAAAAULL << 30) | 1, words.read_bits(1, 60));
+    EXPECT_TRUE(words.read_bit(60));
+    EXPECT_FALSE(words.read_bit(59));
+
+    // 12 bits as bytes, zero padded at the start
+    Gnss_Packed_Bits<12> message;
+    message.set_bits(1, "101101110001", 12);
+    unsigned char bytes[2];
+    message.to_bytes(bytes);
+    EXPECT_EQ(0x0B, bytes[0]);
+    EXPECT_EQ(0x71, bytes[1]);
+}
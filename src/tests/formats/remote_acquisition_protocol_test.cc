@@ -0,0 +1,156 @@
+/*!
+ * \file remote_acquisition_protocol_test.cc
+ * \brief Tests of the messages between the acquisition blocks and a remote acquisition server
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <complex>
+#include <string>
+#include <vector>
+#include "remote_acquisition_protocol.h"
+
+
+TEST(Remote_Acquisition_Protocol_Test, RoundTrip)
+{
+    // Every level on both components, and an odd number of samples
+    std::vector<std::complex<int8_t> > quantized;
+    const int8_t levels[4] = {-3, -1, 1, 3};
+    for (unsigned int i = 0; i < 33; i++)
+        {
+            quantized.push_back(std::complex<int8_t>(levels[i % 4], levels[(i / 4) % 4]));
+        }
+
+    Remote_Acquisition_Request request;
+    request.id = 123456;
+    request.system = 'G';
+    request.signal = "1C";
+    request.prns.push_back(7);
+    request.prns.push_back(31);
+    request.fs_in = 4000000;
+    request.if_hz = -12500.5;
+    request.doppler_min = -5000;
+    request.doppler_max = 4750;
+    request.doppler_step = 250;
+    request.threshold = 0.0125;
+    request.samples = quantized.size();
+    remote_acquisition_pack(quantized.data(), quantized.size(), request.packed);
+    EXPECT_EQ(17u, request.packed.size());
+
+    Remote_Acquisition_Reply reply;
+    reply.id = 123456;
+    Remote_Acquisition_Peak peak;
+    peak.prn = 31;
+    peak.test_statistics = 0.5;
+    peak.code_phase_samples = 1234.25;
+    peak.doppler_hz = -2718.75;
+    reply.peaks.push_back(peak);
+
+    // Both frames, delivered one byte at a time
+    const std::string stream = remote_acquisition_encode(request) + remote_acquisition_encode(reply);
+    Remote_Acquisition_Decoder decoder;
+    for (unsigned int i = 0; i < stream.size(); i++)
+        {
+            decoder.push(stream.data() + i, 1);
+        }
+    ASSERT_FALSE(decoder.error());
+
+    Remote_Acquisition_Request decoded;
+    ASSERT_TRUE(decoder.next_request(decoded));
+    EXPECT_FALSE(decoder.next_request(decoded));
+    EXPECT_EQ(request.id, decoded.id);
+    EXPECT_EQ('G', decoded.system);
+    EXPECT_EQ("1C", decoded.signal);
+    EXPECT_EQ(request.prns, decoded.prns);
+    EXPECT_EQ(request.fs_in, decoded.fs_in);
+    EXPECT_DOUBLE_EQ(request.if_hz, decoded.if_hz);
+    EXPECT_EQ(request.doppler_min, decoded.doppler_min);
+    EXPECT_EQ(request.doppler_max, decoded.doppler_max);
+    EXPECT_EQ(request.doppler_step, decoded.doppler_step);
+    EXPECT_FLOAT_EQ(request.threshold, decoded.threshold);
+    EXPECT_EQ(request.samples, decoded.samples);
+
+    std::vector<std::complex<float> > samples;
+    remote_acquisition_unpack(decoded.packed, decoded.samples, samples);
+    ASSERT_EQ(quantized.size(), samples.size());
+    for (unsigned int i = 0; i < samples.size(); i++)
+        {
+            EXPECT_FLOAT_EQ(quantized[i].real(), samples[i].real());
+            EXPECT_FLOAT_EQ(quantized[i].imag(), samples[i].imag());
+        }
+
+    Remote_Acquisition_Reply decoded_reply;
+    ASSERT_TRUE(decoder.next_reply(decoded_reply));
+    EXPECT_EQ(reply.id, decoded_reply.id);
+    ASSERT_EQ(1u, decoded_reply.peaks.size());
+    EXPECT_EQ(31u, decoded_reply.peaks[0].prn);
+    EXPECT_FLOAT_EQ(0.5, decoded_reply.peaks[0].test_statistics);
+    EXPECT_DOUBLE_EQ(1234.25, decoded_reply.peaks[0].code_phase_samples);
+    EXPECT_DOUBLE_EQ(-2718.75, decoded_reply.peaks[0].doppler_hz);
+}
+
+
+TEST(Remote_Acquisition_Protocol_Test, MalformedStream)
+{
+    Remote_Acquisition_Reply reply;
+    reply.id = 1;
+    std::string frame = remote_acquisition_encode(reply);
+
+    // A payload longer than its peaks
+    std::string longer = frame;
+    longer[3] = static_cast<char>(longer[3] + 1);
+    longer.push_back('x');
+    Remote_Acquisition_Decoder decoder;
+    decoder.push(longer.data(), longer.size());
+    EXPECT_TRUE(decoder.error());
+
+    // Bad magic, and nothing decoded after it
+    decoder.reset();
+    std::string bad = frame;
+    bad[0] = 'X';
+    bad += frame;
+    decoder.push(bad.data(), bad.size());
+    EXPECT_TRUE(decoder.error());
+    EXPECT_FALSE(decoder.next_reply(reply));
+
+    // A request whose samples do not match their number
+    decoder.reset();
+    Remote_Acquisition_Request request;
+    request.id = 2;
+    request.system = 'G';
+    request.signal = "1C";
+    request.fs_in = 2000000;
+    request.if_hz = 0.0;
+    request.doppler_min = 0;
+    request.doppler_max = 0;
+    request.doppler_step = 500;
+    request.threshold = 0.01;
+    request.samples = 10;
+    request.packed.assign(4, 0);
+    const std::string truncated = remote_acquisition_encode(request);
+    decoder.push(truncated.data(), truncated.size());
+    EXPECT_TRUE(decoder.error());
+}
@@ -0,0 +1,254 @@
+/*!
+ * \file rinex_observables_reader_test.cc
+ * \brief Tests of the reader of RINEX 3 observation and navigation files
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <gtest/gtest.h>
+#include "rinex_observables_reader.h"
+#include "gps_ephemeris.h"
+#include "gps_iono.h"
+#include "gps_utc_model.h"
+#include "galileo_ephemeris.h"
+
+namespace
+{
+// A header line, its label in columns 61 to 80
+std::string rinex_reader_header(const std::string & content, const std::string & label)
+{
+    std::string line = content;
+    line.resize(60, ' ');
+    return line + label + "\n";
+}
+
+// An observation record, blank where the value is 0
+std::string rinex_reader_observations(const std::string & satellite, const std::vector<double> & values)
+{
+    std::string line = satellite;
+    char buffer[32];
+    for (unsigned int i = 0; i < values.size(); i++)
+        {
+            if (values[i] == 0.0)
+                {
+                    line += std::string(16, ' ');
+                    continue;
+                }
+            std::snprintf(buffer, sizeof(buffer), "%14.3f  ", values[i]);
+            line += buffer;
+        }
+    return line + "\n";
+}
+
+// A navigation record line, 4X,4D19.12, or the first one if \p first is not empty
+std::string rinex_reader_orbit(const std::string & first, const std::vector<double> & values)
+{
+    std::string line = first.empty() ? std::string(4, ' ') : first;
+    char buffer[32];
+    for (unsigned int i = 0; i < values.size(); i++)
+        {
+            std::snprintf(buffer, sizeof(buffer), "%19.12E", values[i]);
+            std::string value(buffer);
+            value[value.find('E')] = 'D';
+            line += value;
+        }
+    return line + "\n";
+}
+
+void write_rinex_reader_file(const std::string & filename, const std::string & content)
+{
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::trunc);
+    file << content;
+}
+}
+
+
+TEST(Rinex_Observables_Reader_test, GpsTime)
+{
+    EXPECT_DOUBLE_EQ(0.0, Rinex_Observables_Reader::gps_time(1980, 1, 6, 0, 0, 0.0));
+    // GPS week 1878 started on 3 January 2016
+    EXPECT_DOUBLE_EQ(1878.0 * 604800.0 + 3723.5, Rinex_Observables_Reader::gps_time(2016, 1, 3, 1, 2, 3.5));
+    EXPECT_DOUBLE_EQ(-1.5E-9, Rinex_Observables_Reader::field("  -1.500000000000D-09", 0, 21));
+    EXPECT_DOUBLE_EQ(0.0, Rinex_Observables_Reader::field("      ", 0, 19));
+}
+
+
+TEST(Rinex_Observables_Reader_test, ReadsTheObservations)
+{
+    const std::string filename = "rinex_observables_reader_test.16o";
+    std::string content = rinex_reader_header("     3.02           OBSERVATION DATA    M (MIXED)", "RINEX VERSION / TYPE");
+    content += rinex_reader_header("G    5 C1C L1C D1C S1C C2L", "SYS / # / OBS TYPES");
+    content += rinex_reader_header("E    3 C1X L1X C5Q", "SYS / # / OBS TYPES");
+    content += rinex_reader_header("", "END OF HEADER");
+    content += "> 2016 01 03 00 00  1.0000000  0  3\n";
+    content += rinex_reader_observations("G01", { 21000000.125, 110000000.5, -1500.25, 45.5, 21000004.0 });
+    content += rinex_reader_observations("G02", { 0.0, 0.0, 0.0, 0.0, 22000004.0 });
+    content += rinex_reader_observations("E11", { 23000000.0, 0.0, 23000001.5 });
+    content += "> 2016 01 03 00 00  1.5000000  4  1\n";
+    content += "                            A COMMENT                       COMMENT\n";
+    content += "> 2016 01 03 00 00  2.0000000  0  1\n";
+    content += rinex_reader_observations("R05", { 19000000.0 });
+    write_rinex_reader_file(filename, content);
+
+    Rinex_Observables_Reader reader;
+    ASSERT_TRUE(reader.open_observations(filename)) << reader.error();
+    Rinex_Epoch epoch;
+    ASSERT_TRUE(reader.next_epoch(epoch));
+    EXPECT_DOUBLE_EQ(1878.0 * 604800.0 + 1.0, epoch.gps_time_s);
+    ASSERT_EQ(5u, epoch.observations.size());
+
+    const Gnss_Synchro & l1 = epoch.observations[0];
+    EXPECT_EQ('G', l1.System);
+    EXPECT_EQ(std::string("1C"), std::string(l1.Signal));
+    EXPECT_EQ(1u, l1.PRN);
+    EXPECT_TRUE(l1.Flag_valid_pseudorange);
+    EXPECT_DOUBLE_EQ(21000000.125, l1.Pseudorange_m);
+    EXPECT_NEAR(110000000.5 * 2.0 * M_PI, l1.Carrier_phase_rads, 1e-3);
+    EXPECT_DOUBLE_EQ(-1500.25, l1.Carrier_Doppler_hz);
+    EXPECT_DOUBLE_EQ(45.5, l1.CN0_dB_hz);
+    EXPECT_DOUBLE_EQ(1.0, l1.d_TOW_hybrid_at_current_symbol);
+
+    EXPECT_EQ(std::string("2S"), std::string(epoch.observations[1].Signal));
+    EXPECT_DOUBLE_EQ(21000004.0, epoch.observations[1].Pseudorange_m);
+    // G02 has no L1 pseudorange
+    EXPECT_EQ(2u, epoch.observations[2].PRN);
+    EXPECT_EQ(std::string("2S"), std::string(epoch.observations[2].Signal));
+    EXPECT_EQ('E', epoch.observations[3].System);
+    EXPECT_EQ(std::string("1B"), std::string(epoch.observations[3].Signal));
+    EXPECT_EQ(11u, epoch.observations[3].PRN);
+    EXPECT_EQ(std::string("5X"), std::string(epoch.observations[4].Signal));
+    EXPECT_DOUBLE_EQ(23000001.5, epoch.observations[4].Pseudorange_m);
+
+    // the event is skipped, GLONASS is not read
+    ASSERT_TRUE(reader.next_epoch(epoch));
+    EXPECT_DOUBLE_EQ(1878.0 * 604800.0 + 2.0, epoch.gps_time_s);
+    EXPECT_TRUE(epoch.observations.empty());
+    EXPECT_FALSE(reader.next_epoch(epoch));
+    EXPECT_TRUE(reader.error().empty());
+    EXPECT_EQ(2u, reader.epochs());
+    std::remove(filename.c_str());
+}
+
+
+TEST(Rinex_Observables_Reader_test, ReadsTheNavigation)
+{
+    const std::string filename = "rinex_observables_reader_test.16p";
+    std::string content = rinex_reader_header("     3.02           N: GNSS NAV DATA    M: MIXED", "RINEX VERSION / TYPE");
+    content += rinex_reader_header("GPSA   1.1176D-08  0.0000D+00 -5.9605D-08  0.0000D+00", "IONOSPHERIC CORR");
+    content += rinex_reader_header("GPSB   9.0112D+04  0.0000D+00 -1.9661D+05  0.0000D+00", "IONOSPHERIC CORR");
+    content += rinex_reader_header("GPUT  1.8626451492D-09 3.996802889D-15 405504 1878", "TIME SYSTEM CORR");
+    content += rinex_reader_header("    17", "LEAP SECONDS");
+    content += rinex_reader_header("", "END OF HEADER");
+    // a Galileo record before a GPS one two hours earlier
+    content += rinex_reader_orbit("E12 2016 01 03 02 00 00", { 1e-4, 2e-11, 0.0 });
+    content += rinex_reader_orbit("", { 55.0, 10.0, 3e-9, 1.0 });
+    content += rinex_reader_orbit("", { 1e-6, 2e-4, 3e-6, 5440.6 });
+    content += rinex_reader_orbit("", { 7200.0, 1e-8, 2.0, 2e-8 });
+    content += rinex_reader_orbit("", { 0.97, 150.0, 0.5, -5e-9 });
+    content += rinex_reader_orbit("", { 1e-10, 517.0, 1878.0, 0.0 });
+    content += rinex_reader_orbit("", { 3.12, 0.0, 1e-9, 2e-9 });
+    content += rinex_reader_orbit("", { 7000.0 });
+    content += rinex_reader_orbit("R05 2016 01 03 00 15 00", { 1e-5, 0.0, 0.0 });
+    content += rinex_reader_orbit("", { 1.0, 2.0, 3.0, 4.0 });
+    content += rinex_reader_orbit("", { 1.0, 2.0, 3.0, 4.0 });
+    content += rinex_reader_orbit("", { 1.0, 2.0, 3.0, 4.0 });
+    content += rinex_reader_orbit("G07 2016 01 03 00 00 00", { -2e-4, -1e-12, 0.0 });
+    content += rinex_reader_orbit("", { 31.0, -20.0, 4e-9, 0.5 });
+    content += rinex_reader_orbit("", { -1e-6, 5e-3, 8e-6, 5153.6 });
+    content += rinex_reader_orbit("", { 0.0, 1e-7, -1.0, -2e-8 });
+    content += rinex_reader_orbit("", { 0.95, 200.0, 1.5, -8e-9 });
+    content += rinex_reader_orbit("", { 2e-10, 1.0, 1878.0, 0.0 });
+    content += rinex_reader_orbit("", { 2.0, 0.0, -1e-8, 31.0 });
+    content += rinex_reader_orbit("", { -18.0, 4.0 });
+    write_rinex_reader_file(filename, content);
+
+    Rinex_Observables_Reader reader;
+    ASSERT_TRUE(reader.read_navigation(filename)) << reader.error();
+    EXPECT_EQ(4u, reader.pending_navigation());
+    const double week = 1878.0 * 604800.0;
+    boost::any record;
+
+    // the models of the header first, from any time
+    ASSERT_TRUE(reader.next_navigation(week - 86400.0, record));
+    ASSERT_TRUE(record.type() == typeid(std::shared_ptr<Gps_Iono>));
+    std::shared_ptr<Gps_Iono> iono = boost::any_cast<std::shared_ptr<Gps_Iono>>(record);
+    EXPECT_TRUE(iono->valid);
+    EXPECT_DOUBLE_EQ(1.1176e-8, iono->d_alpha0);
+    EXPECT_DOUBLE_EQ(-1.9661e5, iono->d_beta2);
+    ASSERT_TRUE(reader.next_navigation(week - 86400.0, record));
+    ASSERT_TRUE(record.type() == typeid(std::shared_ptr<Gps_Utc_Model>));
+    std::shared_ptr<Gps_Utc_Model> utc = boost::any_cast<std::shared_ptr<Gps_Utc_Model>>(record);
+    EXPECT_DOUBLE_EQ(1.8626451492e-9, utc->d_A0);
+    EXPECT_DOUBLE_EQ(405504.0, utc->d_t_OT);
+    EXPECT_EQ(1878 % 1024, utc->i_WN_T);
+    EXPECT_DOUBLE_EQ(17.0, utc->d_DeltaT_LS);
+    EXPECT_FALSE(reader.next_navigation(week - 86400.0, record));
+
+    // then the ephemeris by clock reference time
+    ASSERT_TRUE(reader.next_navigation(week, record));
+    ASSERT_TRUE(record.type() == typeid(std::shared_ptr<Gps_Ephemeris>));
+    std::shared_ptr<Gps_Ephemeris> gps = boost::any_cast<std::shared_ptr<Gps_Ephemeris>>(record);
+    EXPECT_EQ(7u, gps->i_satellite_PRN);
+    EXPECT_DOUBLE_EQ(0.0, gps->d_Toc);
+    EXPECT_DOUBLE_EQ(-2e-4, gps->d_A_f0);
+    EXPECT_DOUBLE_EQ(31.0, gps->d_IODE_SF2);
+    EXPECT_DOUBLE_EQ(5153.6, gps->d_sqrt_A);
+    EXPECT_DOUBLE_EQ(-8e-9, gps->d_OMEGA_DOT);
+    EXPECT_EQ(1878 % 1024, gps->i_GPS_week);
+    EXPECT_EQ(0, gps->i_SV_accuracy);
+    EXPECT_DOUBLE_EQ(31.0, gps->d_IODC);
+    EXPECT_FALSE(reader.next_navigation(week + 7199.0, record));
+
+    ASSERT_TRUE(reader.next_navigation(week + 7200.0, record));
+    ASSERT_TRUE(record.type() == typeid(std::shared_ptr<Galileo_Ephemeris>));
+    std::shared_ptr<Galileo_Ephemeris> galileo = boost::any_cast<std::shared_ptr<Galileo_Ephemeris>>(record);
+    EXPECT_EQ(12u, galileo->i_satellite_PRN);
+    EXPECT_EQ(55, galileo->IOD_ephemeris);
+    EXPECT_DOUBLE_EQ(7200.0, galileo->t0e_1);
+    EXPECT_DOUBLE_EQ(5440.6, galileo->A_1);
+    EXPECT_DOUBLE_EQ(1878.0 - 1024.0, galileo->WN_5);
+    EXPECT_DOUBLE_EQ(2e-9, galileo->BGD_E1E5b_5);
+    EXPECT_EQ(0u, reader.pending_navigation());
+    std::remove(filename.c_str());
+}
+
+
+TEST(Rinex_Observables_Reader_test, RejectsOtherFiles)
+{
+    const std::string filename = "rinex_observables_reader_test.16n";
+    write_rinex_reader_file(filename, rinex_reader_header("     2.11           N: GPS NAV DATA", "RINEX VERSION / TYPE"));
+    Rinex_Observables_Reader reader;
+    EXPECT_FALSE(reader.read_navigation(filename));
+    EXPECT_FALSE(reader.error().empty());
+    EXPECT_FALSE(reader.open_observations(filename));
+    EXPECT_FALSE(reader.open_observations("rinex_observables_reader_test.missing"));
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,165 @@
+/*!
+ * \file rinex_printer_formatting_test.cc
+ * \brief Tests of the fixed-width number formatting of the RINEX printer
+ * against the stream based implementation it replaces.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <gtest/gtest.h>
+#include "rinex_printer.h"
+
+
+class Rinex_Printer_Formatting_Test: public ::testing::Test
+{
+protected:
+    static std::string put_fixed(double x, int width, int decimals)
+    {
+        char buf[64];
+        return std::string(buf, Rinex_Printer::putFixed(buf, x, width, decimals) - buf);
+    }
+
+    static std::string put_for(double d, int length, int exp_len)
+    {
+        char buf[64];
+        return std::string(buf, Rinex_Printer::putFor(buf, d, length, exp_len) - buf);
+    }
+
+    static std::string as_string(double x, int decimals)
+    {
+        return Rinex_Printer::asString(x, decimals);
+    }
+
+    static std::string doub2for(double d, int length, int exp_len)
+    {
+        return Rinex_Printer::doub2for(d, length, exp_len);
+    }
+
+    // rightJustify(asString(x, decimals), width) before the character buffers
+    static std::string stream_fixed(double x, int width, int decimals)
+    {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(decimals) << x;
+        return Rinex_Printer::rightJustify(ss.str(), width);
+    }
+
+    // doub2for(d, length, exp_len) before the character buffers
+    static std::string stream_for(double d, int length, int exp_len)
+    {
+        std::string s = Rinex_Printer::doub2sci(d, length, exp_len, true, true);
+        return Rinex_Printer::sci2for(s, 0, length, exp_len, true);
+    }
+};
+
+
+TEST_F(Rinex_Printer_Formatting_Test, FixedNotation)
+{
+    EXPECT_EQ("  21345678.123", put_fixed(21345678.123456, 14, 3));
+    EXPECT_EQ(" -1234.568", put_fixed(-1234.5678, 10, 3));
+    EXPECT_EQ("        45.000", put_fixed(45.0, 14, 3));
+    EXPECT_EQ("    0.5", put_fixed(0.45, 7, 1));
+    EXPECT_EQ("12", put_fixed(11.6, 2, 0));
+    // wider than the field: truncated from the left
+    EXPECT_EQ("45678.123", put_fixed(12345678.123, 9, 3));
+    EXPECT_EQ("1000.000", as_string(999.9996, 3));
+    EXPECT_EQ("0.10000000000000001", as_string(0.1, 17));
+}
+
+
+TEST_F(Rinex_Printer_Formatting_Test, RoundingTies)
+{
+    // exact binary ties round half to even in the library
+    EXPECT_EQ("0.12", as_string(0.125, 2));
+    EXPECT_EQ("0.38", as_string(0.375, 2));
+    EXPECT_EQ("2", as_string(2.5, 0));
+    EXPECT_EQ("4", as_string(3.5, 0));
+    EXPECT_EQ("   -0.62", put_fixed(-0.625, 8, 2));
+    // not exact ties, the nearest doubles are slightly below the decimal literals
+    EXPECT_EQ("1.000", as_string(1.0005, 3));
+    EXPECT_EQ("2.67", as_string(2.675, 2));
+    EXPECT_EQ("1.00", as_string(1.005, 2));
+    for (double x : {0.125, 0.375, 2.5, 3.5, -0.625, 1.0005, 2.675, 1.005, 1234567.8905, 0.0000005})
+        {
+            for (int decimals = 0; decimals < 10; decimals++)
+                {
+                    EXPECT_EQ(stream_fixed(x, 20, decimals), put_fixed(x, 20, decimals));
+                }
+        }
+}
+
+
+TEST_F(Rinex_Printer_Formatting_Test, NegativeZero)
+{
+    EXPECT_EQ("-0.000", as_string(-0.0, 3));
+    EXPECT_EQ("    -0.000", put_fixed(-0.0, 10, 3));
+    EXPECT_EQ("-0.000", as_string(-0.0001, 3));
+    EXPECT_EQ("-0", as_string(-0.4, 0));
+    EXPECT_EQ("0.000", as_string(0.0, 3));
+    EXPECT_EQ(stream_fixed(-0.0, 10, 3), put_fixed(-0.0, 10, 3));
+    EXPECT_EQ(stream_fixed(-0.0001, 10, 3), put_fixed(-0.0001, 10, 3));
+}
+
+
+TEST_F(Rinex_Printer_Formatting_Test, FortranNotation)
+{
+    EXPECT_EQ(" .156360000000D+06", doub2for(156360.0, 18, 2));
+    EXPECT_EQ("-.123450000000D-09", doub2for(-1.2345e-10, 18, 2));
+    EXPECT_EQ(" .000000000000D+00", doub2for(0.0, 18, 2));
+    EXPECT_EQ(" .100000000000D+01", doub2for(1.0, 18, 2));
+    // rounding of the mantissa carries into the exponent
+    EXPECT_EQ(" .100000000000D+07", doub2for(999999.9999999999, 18, 2));
+    EXPECT_EQ("-.100000000000D+00", doub2for(-0.09999999999999999, 18, 2));
+    EXPECT_EQ(" .100000000000D-02", doub2for(9.9999999999999e-4, 18, 2));
+    EXPECT_EQ(" .100000000D+001", doub2for(0.99999999999, 16, 3));
+    for (double d : {156360.0, -1.2345e-10, 0.0, -0.0, 1.0, 999999.9999999999,
+            -0.09999999999999999, 9.9999999999999e-4, 0.99999999999, 1.5e-100, -2.5e+100, 4.0e-311})
+        {
+            EXPECT_EQ(stream_for(d, 18, 2), put_for(d, 18, 2));
+            EXPECT_EQ(stream_for(d, 19, 2), put_for(d, 19, 2));
+            EXPECT_EQ(stream_for(d, 16, 3), put_for(d, 16, 3));
+        }
+}
+
+
+TEST_F(Rinex_Printer_Formatting_Test, SameCharactersAsTheStreams)
+{
+    std::mt19937_64 generator(20160322);
+    std::uniform_real_distribution<double> mantissa(-1.0, 1.0);
+    std::uniform_int_distribution<int> exponent(-12, 9);
+    std::uniform_int_distribution<int> decimals(0, 9);
+    for (int i = 0; i < 200000; i++)
+        {
+            const double x = mantissa(generator) * std::pow(10.0, exponent(generator));
+            const int d = decimals(generator);
+            ASSERT_EQ(stream_fixed(x, 14, d), put_fixed(x, 14, d)) << "x = " << std::setprecision(17) << x;
+            ASSERT_EQ(stream_for(x, 19, 2), put_for(x, 19, 2)) << "x = " << std::setprecision(17) << x;
+        }
+}
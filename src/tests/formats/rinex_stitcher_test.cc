@@ -0,0 +1,141 @@
+/*!
+ * \file rinex_stitcher_test.cc
+ * \brief Tests of the join of the RINEX files of the batch mode segments.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "rinex_stitcher.h"
+
+namespace
+{
+const char * rinex_stitcher_obs_header =
+        "     3.02           OBSERVATION DATA    G (GPS)             RINEX VERSION / TYPE\n"
+        "                                                            END OF HEADER\n";
+
+const char * rinex_stitcher_nav_header =
+        "     3.02           N: GNSS NAV DATA    G: GPS              RINEX VERSION / TYPE\n"
+        "                                                            END OF HEADER\n";
+
+void write_rinex_stitcher_file(const std::string & filename, const std::string & content)
+{
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::trunc);
+    file << content;
+}
+
+std::vector<std::string> read_rinex_stitcher_file(const std::string & filename)
+{
+    std::vector<std::string> lines;
+    std::ifstream file(filename.c_str());
+    std::string line;
+    while (std::getline(file, line))
+        {
+            lines.push_back(line);
+        }
+    return lines;
+}
+
+std::string rinex_stitcher_epoch(int minute, int second, int n)
+{
+    char line[64];
+    std::snprintf(line, sizeof(line), "> 2016 03 22 10 %02d %02d.0000000  0%3d", minute, second, n);
+    std::string epoch(line);
+    for (int i = 0; i < n; i++)
+        {
+            epoch += "\nG0" + std::to_string(i + 1) + "  20000000.000";
+        }
+    return epoch + "\n";
+}
+}
+
+
+TEST(Rinex_Stitcher_Test, ObservationsOfTheOverlapAreNotRepeated)
+{
+    write_rinex_stitcher_file("./stitcher_segment_0.16O", std::string(rinex_stitcher_obs_header)
+            + rinex_stitcher_epoch(0, 0, 1) + rinex_stitcher_epoch(0, 30, 2) + rinex_stitcher_epoch(1, 0, 2));
+    // starts before the end of the first segment
+    write_rinex_stitcher_file("./stitcher_segment_1.16O", std::string(rinex_stitcher_obs_header)
+            + rinex_stitcher_epoch(0, 30, 1) + rinex_stitcher_epoch(1, 0, 1) + rinex_stitcher_epoch(1, 30, 3));
+    std::vector<std::string> inputs = { "./stitcher_segment_0.16O", "./stitcher_segment_1.16O" };
+
+    ASSERT_TRUE(Rinex_Stitcher::stitch_observations(inputs, "./stitcher_joined.16O"));
+    std::vector<std::string> lines = read_rinex_stitcher_file("./stitcher_joined.16O");
+    // header, then 4 epochs with 1, 2, 2 and 3 satellites
+    ASSERT_EQ(2u + 4u + 8u, lines.size());
+    EXPECT_NE(std::string::npos, lines[1].find("END OF HEADER"));
+    EXPECT_EQ(0u, lines[2].find("> 2016 03 22 10 00 00"));
+    EXPECT_EQ(0u, lines[4].find("> 2016 03 22 10 00 30"));
+    EXPECT_EQ(0u, lines[7].find("> 2016 03 22 10 01 00"));
+    EXPECT_EQ(0u, lines[10].find("> 2016 03 22 10 01 30"));
+    EXPECT_EQ(0u, lines[13].find("G03"));
+
+    for (unsigned int i = 0; i < inputs.size(); i++)
+        {
+            std::remove(inputs[i].c_str());
+        }
+    std::remove("./stitcher_joined.16O");
+}
+
+
+TEST(Rinex_Stitcher_Test, NavigationRecordsAreNotRepeated)
+{
+    const std::string record_1 = "G01 2016 03 22 10 00 00 1.0\n     2.0\n     3.0\n";
+    const std::string record_2 = "G02 2016 03 22 10 00 00 4.0\n     5.0\n     6.0\n";
+    const std::string record_3 = "G01 2016 03 22 12 00 00 7.0\n     8.0\n     9.0\n";
+    write_rinex_stitcher_file("./stitcher_segment_0.16N", std::string(rinex_stitcher_nav_header) + record_1 + record_2);
+    write_rinex_stitcher_file("./stitcher_segment_1.16N", std::string(rinex_stitcher_nav_header) + record_2 + record_3);
+    std::vector<std::string> inputs = { "./stitcher_segment_0.16N", "./stitcher_segment_1.16N" };
+
+    ASSERT_TRUE(Rinex_Stitcher::stitch_navigation(inputs, "./stitcher_joined.16N"));
+    std::vector<std::string> lines = read_rinex_stitcher_file("./stitcher_joined.16N");
+    ASSERT_EQ(2u + 9u, lines.size());
+    EXPECT_EQ(0u, lines[2].find("G01 2016 03 22 10"));
+    EXPECT_EQ(0u, lines[5].find("G02 2016 03 22 10"));
+    EXPECT_EQ(0u, lines[8].find("G01 2016 03 22 12"));
+
+    for (unsigned int i = 0; i < inputs.size(); i++)
+        {
+            std::remove(inputs[i].c_str());
+        }
+    std::remove("./stitcher_joined.16N");
+}
+
+
+TEST(Rinex_Stitcher_Test, Rinex2IsNotSupported)
+{
+    write_rinex_stitcher_file("./stitcher_rinex_2.16O",
+            "     2.11           OBSERVATION DATA    G (GPS)             RINEX VERSION / TYPE\n"
+            "                                                            END OF HEADER\n");
+    std::vector<std::string> inputs = { "./stitcher_rinex_2.16O" };
+    EXPECT_FALSE(Rinex_Stitcher::stitch_observations(inputs, "./stitcher_joined.16O"));
+    std::remove("./stitcher_rinex_2.16O");
+    std::remove("./stitcher_joined.16O");
+}
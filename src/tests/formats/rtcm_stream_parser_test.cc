@@ -0,0 +1,238 @@
+/*!
+ * \file rtcm_stream_parser_test.cc
+ * \brief  This file implements tests and a timing benchmark for the parser
+ *  of RTCM 3 streams
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <sys/time.h>
+#include "rtcm_stream_parser.h"
+
+DEFINE_int32(rtcm_stream_parser_iterations_test, 2000, "Number of times the stream is parsed in the RTCM stream parser timing test");
+
+
+namespace
+{
+// MSM7 of 16 GPS satellites with L1 C/A and L2C
+std::string rtcm_stream_test_msm7(Rtcm & rtcm, std::map<int, Gnss_Synchro> & pseudoranges)
+{
+    Gps_Ephemeris gps_eph = Gps_Ephemeris();
+    gps_eph.i_satellite_PRN = 1;
+    for (int i = 0; i < 32; i++)
+        {
+            Gnss_Synchro gnss_synchro;
+            gnss_synchro.PRN = 1 + i / 2;
+            gnss_synchro.System = 'G';
+            std::memcpy(static_cast<void*>(gnss_synchro.Signal), (i % 2) ? "2S" : "1C", 3);
+            gnss_synchro.Pseudorange_m = 20000000.0 + 10123.4 * (i / 2) + 1.7 * (i % 2);
+            gnss_synchro.Carrier_phase_rads = 1.0e6 + 345.6 * i;
+            gnss_synchro.Carrier_Doppler_hz = (-2500.0 + 160.3 * (i / 2)) * ((i % 2) ? GPS_L2_FREQ_HZ / GPS_L1_FREQ_HZ : 1.0);
+            gnss_synchro.CN0_dB_hz = 40.0 + 0.5 * (i % 8);
+            pseudoranges.insert(std::pair<int, Gnss_Synchro>(i, gnss_synchro));
+        }
+    return rtcm.print_MSM_7(gps_eph, {}, {}, 100.0, pseudoranges, 1234, 0, 0, 0, false, false);
+}
+}
+
+
+TEST(Rtcm_Stream_Parser_Test, DecodesFramesSplitAnywhere)
+{
+    auto rtcm = std::make_shared<Rtcm>();
+    Gps_Ephemeris gps_eph = Gps_Ephemeris();
+    gps_eph.i_satellite_PRN = 3;
+    gps_eph.d_IODC = 4;
+    gps_eph.d_A_f0 = -123.0 * A_F0_LSB;
+    gps_eph.d_e_eccentricity = 2.0 * E_LSB;
+    gps_eph.b_fit_interval_flag = true;
+    Galileo_Ephemeris gal_eph = Galileo_Ephemeris();
+    gal_eph.i_satellite_PRN = 5;
+    gal_eph.OMEGA_dot_3 = -53.0 * OMEGA_dot_3_LSB;
+    gal_eph.E5a_DVS = true;
+    std::map<int, Gnss_Synchro> pseudoranges;
+
+    // Frames with a few bytes of noise, including a preamble, between them
+    std::string stream = std::string("\x01\xD3\x7F", 3) + rtcm->print_MT1019(gps_eph)
+            + rtcm->print_MT1005(2003, 1114104.5999, -4850729.7108, 3975521.4643, true, false, true, false, false, 0)
+            + std::string("\xD3", 1) + rtcm->print_MT1045(gal_eph)
+            + rtcm_stream_test_msm7(*rtcm, pseudoranges) + std::string("\x00\x00", 2);
+    const unsigned char * bytes = reinterpret_cast<const unsigned char *>(stream.data());
+
+    for (size_t chunk : {stream.size(), static_cast<size_t>(1), static_cast<size_t>(2), static_cast<size_t>(7), static_cast<size_t>(100)})
+        {
+            Rtcm_Stream_Parser parser;
+            std::vector<unsigned int> types;
+            Gps_Ephemeris gps_eph_read = Gps_Ephemeris();
+            Galileo_Ephemeris gal_eph_read = Galileo_Ephemeris();
+            Rtcm_Reference_Station station = Rtcm_Reference_Station();
+            Rtcm_Msm msm = Rtcm_Msm();
+            for (size_t first = 0; first < stream.size(); first += chunk)
+                {
+                    parser.push(bytes + first, std::min(chunk, stream.size() - first));
+                    while (parser.next())
+                        {
+                            types.push_back(parser.message_type());
+                            switch (parser.message_type())
+                            {
+                            case 1005:
+                                EXPECT_TRUE(parser.decode(station));
+                                break;
+                            case 1019:
+                                EXPECT_TRUE(parser.decode(gps_eph_read));
+                                EXPECT_FALSE(parser.decode(msm));
+                                break;
+                            case 1045:
+                                EXPECT_TRUE(parser.decode(gal_eph_read));
+                                break;
+                            default:
+                                EXPECT_TRUE(parser.decode(msm));
+                            }
+                        }
+                }
+            ASSERT_EQ(4u, types.size()) << "chunks of " << chunk << " bytes";
+            EXPECT_EQ(1019u, types[0]);
+            EXPECT_EQ(1005u, types[1]);
+            EXPECT_EQ(1045u, types[2]);
+            EXPECT_EQ(1077u, types[3]);
+            EXPECT_EQ(4u, parser.frames());
+            EXPECT_EQ(0u, parser.crc_errors());
+            EXPECT_EQ(6u, parser.skipped_bytes());
+
+            EXPECT_EQ(3, gps_eph_read.i_satellite_PRN);
+            EXPECT_DOUBLE_EQ(4, gps_eph_read.d_IODC);
+            EXPECT_DOUBLE_EQ(-123.0 * A_F0_LSB, gps_eph_read.d_A_f0);
+            EXPECT_DOUBLE_EQ(2.0 * E_LSB, gps_eph_read.d_e_eccentricity);
+            EXPECT_TRUE(gps_eph_read.b_fit_interval_flag);
+
+            EXPECT_EQ(5, gal_eph_read.i_satellite_PRN);
+            EXPECT_DOUBLE_EQ(-53.0 * OMEGA_dot_3_LSB, gal_eph_read.OMEGA_dot_3);
+            EXPECT_TRUE(gal_eph_read.E5a_DVS);
+
+            EXPECT_EQ(2003u, station.ref_id);
+            EXPECT_TRUE(station.gps);
+            EXPECT_FALSE(station.glonass);
+            EXPECT_TRUE(station.galileo);
+            EXPECT_NEAR(1114104.5999, station.ecef_x, 1e-4);
+            EXPECT_NEAR(-4850729.7108, station.ecef_y, 1e-4);
+            EXPECT_NEAR(3975521.4643, station.ecef_z, 1e-4);
+
+            EXPECT_EQ(7u, msm.msm);
+            EXPECT_EQ(1234u, msm.ref_id);
+            EXPECT_EQ(100000u, msm.epoch_time);
+            EXPECT_EQ(16u, msm.num_satellites);
+            EXPECT_EQ(2u, msm.num_signals);
+            ASSERT_EQ(32u, msm.cells.size());
+            for (unsigned int c = 0; c < msm.cells.size(); c++)
+                {
+                    // cells and channels are both ordered by PRN, then L1 before L2
+                    const Gnss_Synchro & gnss_synchro = pseudoranges.at(c);
+                    const double lambda = GPS_C_m_s / ((c % 2) ? GPS_L2_FREQ_HZ : GPS_L1_FREQ_HZ);
+                    EXPECT_EQ(static_cast<unsigned int>(gnss_synchro.PRN), msm.cells[c].prn);
+                    EXPECT_EQ((c % 2) ? 15u : 2u, msm.cells[c].signal_id);
+                    EXPECT_TRUE(msm.cells[c].pseudorange_valid);
+                    EXPECT_NEAR(gnss_synchro.Pseudorange_m, msm.cells[c].pseudorange_m, 0.001);
+                    EXPECT_TRUE(msm.cells[c].phaserange_rate_valid);
+                    EXPECT_NEAR(- gnss_synchro.Carrier_Doppler_hz * lambda, msm.cells[c].phaserange_rate_m_s, 0.0001);
+                    EXPECT_DOUBLE_EQ(gnss_synchro.CN0_dB_hz, msm.cells[c].cnr_dB_Hz);
+                }
+        }
+}
+
+
+TEST(Rtcm_Stream_Parser_Test, ResynchronizesAfterBadCrc)
+{
+    auto rtcm = std::make_shared<Rtcm>();
+    Gps_Ephemeris gps_eph = Gps_Ephemeris();
+    gps_eph.i_satellite_PRN = 7;
+    std::string bad = rtcm->print_MT1019(gps_eph);
+    bad[20] ^= 0x10;
+    std::string good = rtcm->print_MT1019(gps_eph);
+    std::string stream = bad + good;
+
+    Rtcm_Stream_Parser parser;
+    parser.push(reinterpret_cast<const unsigned char *>(stream.data()), stream.size());
+    Gps_Ephemeris gps_eph_read = Gps_Ephemeris();
+    ASSERT_TRUE(parser.next());
+    EXPECT_TRUE(parser.decode(gps_eph_read));
+    EXPECT_EQ(7, gps_eph_read.i_satellite_PRN);
+    EXPECT_EQ(parser.frame_size(), good.size());
+    EXPECT_EQ(0, std::memcmp(parser.frame(), good.data(), good.size()));
+    EXPECT_FALSE(parser.next());
+    EXPECT_EQ(1u, parser.crc_errors());
+    EXPECT_EQ(bad.size(), parser.skipped_bytes());
+}
+
+
+TEST(Rtcm_Stream_Parser_Test, StreamTiming)
+{
+    auto rtcm = std::make_shared<Rtcm>();
+    Gps_Ephemeris gps_eph = Gps_Ephemeris();
+    gps_eph.i_satellite_PRN = 3;
+    Galileo_Ephemeris gal_eph = Galileo_Ephemeris();
+    gal_eph.i_satellite_PRN = 5;
+    std::map<int, Gnss_Synchro> pseudoranges;
+    std::string frames = rtcm_stream_test_msm7(*rtcm, pseudoranges) + rtcm->print_MT1019(gps_eph) + rtcm->print_MT1045(gal_eph)
+            + rtcm->print_MT1005(2003, 1114104.5999, -4850729.7108, 3975521.4643, true, false, true, false, false, 0);
+    std::string stream;
+    for (int i = 0; i < 64; i++)
+        {
+            stream += frames;
+        }
+    const unsigned char * bytes = reinterpret_cast<const unsigned char *>(stream.data());
+
+    Rtcm_Stream_Parser parser;
+    Gps_Ephemeris gps_eph_read;
+    Galileo_Ephemeris gal_eph_read;
+    Rtcm_Reference_Station station;
+    Rtcm_Msm msm;
+    unsigned long long decoded = 0;
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    long long int begin = tv.tv_sec * 1000000 + tv.tv_usec;
+    for (int k = 0; k < FLAGS_rtcm_stream_parser_iterations_test; k++)
+        {
+            // buffers of a TCP stream, not aligned to the frames
+            for (size_t first = 0; first < stream.size(); first += 1500)
+                {
+                    parser.push(bytes + first, std::min(static_cast<size_t>(1500), stream.size() - first));
+                    while (parser.next())
+                        {
+                            decoded += parser.decode(msm) || parser.decode(gps_eph_read) || parser.decode(gal_eph_read) || parser.decode(station);
+                        }
+                }
+        }
+    gettimeofday(&tv, NULL);
+    long long int end = tv.tv_sec * 1000000 + tv.tv_usec;
+    const double megabytes = static_cast<double>(stream.size()) * FLAGS_rtcm_stream_parser_iterations_test / 1.0e6;
+    std::cout << "RTCM stream of " << megabytes << " MB parsed and decoded in " << (end - begin) << " microseconds ("
+              << megabytes / (static_cast<double>(end - begin + 1) / 1.0e6) << " MB/s)" << std::endl;
+    EXPECT_EQ(static_cast<unsigned long long>(4 * 64) * FLAGS_rtcm_stream_parser_iterations_test, decoded);
+    EXPECT_EQ(0u, parser.crc_errors());
+    EXPECT_EQ(0u, parser.skipped_bytes());
+}
@@ -29,6 +29,7 @@
  * -------------------------------------------------------------------------
  */
 
+#include <chrono>
 #include <memory>
 #include <thread>
 #include "rtcm.h"
@@ -186,6 +187,30 @@ TEST(Rtcm_Test, Check_CRC)
 }
 
 
+TEST(Rtcm_Test, Bit_Writer)
+{
+    auto rtcm = std::make_shared<Rtcm>();
+    Rtcm_Bit_Writer writer;
+    // Same content as the MT1005 frame of the Check_CRC test, written across byte boundaries
+    std::string content = rtcm->hex_to_bin("3ED7D30202980EDEEF34B4BD62AC0941986F33360");
+    writer.append(std::bitset<12>(content.substr(0, 12)));
+    writer.append(rtcm->bin_to_uint(content.substr(12, 5)), 5);
+    writer.append(content.substr(17, 100));
+    writer.append(std::bitset<35>(content.substr(117, 35)));
+    EXPECT_EQ(static_cast<unsigned int>(152), writer.size());
+    std::string frame = writer.frame();
+    EXPECT_EQ(0, rtcm->bin_to_hex(rtcm->binary_data_to_bin(frame)).compare("D300133ED7D30202980EDEEF34B4BD62AC0941986F33360B98"));
+
+    // The writer can be reused, and pads the content with zeros
+    writer.clear();
+    writer.append(0x5, 3);
+    frame = writer.frame();
+    EXPECT_EQ(static_cast<unsigned int>(7), frame.length());
+    EXPECT_EQ(0xA0, static_cast<unsigned char>(frame.at(3)));
+    EXPECT_EQ(true, rtcm->check_CRC(frame));
+}
+
+
 TEST(Rtcm_Test, MT1001)
 {
     auto rtcm = std::make_shared<Rtcm>();
@@ -561,6 +586,68 @@ TEST(Rtcm_Test, MSM1)
 }
 
 
+TEST(Rtcm_Test, MSM4ManySignals)
+{
+    auto rtcm = std::make_shared<Rtcm>();
+    Gps_Ephemeris gps_eph = Gps_Ephemeris();
+    gps_eph.i_satellite_PRN = 1;
+    std::map<int, Gnss_Synchro> pseudoranges;
+
+    // 20 satellites with three signals each, plus an observable without MSM signal ID
+    std::string signals[3] = {"1C", "2S", "5X"};
+    unsigned int Nsat = 20;
+    unsigned int Nsig = 3;
+    int channel = 0;
+    for(unsigned int prn = 1; prn <= Nsat; prn++)
+        {
+            for(unsigned int s = 0; s < Nsig; s++)
+                {
+                    Gnss_Synchro gnss_synchro;
+                    gnss_synchro.System = 'G';
+                    gnss_synchro.PRN = prn;
+                    std::memcpy((void*)gnss_synchro.Signal, signals[s].c_str(), 3);
+                    gnss_synchro.Pseudorange_m = 20000000.0 + prn * 12345.6 + s * 1.5;
+                    gnss_synchro.CN0_dB_hz = 40.0;
+                    pseudoranges.insert(std::pair<int, Gnss_Synchro>(channel++, gnss_synchro));
+                }
+        }
+    Gnss_Synchro gnss_synchro_e1;
+    gnss_synchro_e1.System = 'G';
+    gnss_synchro_e1.PRN = 30;
+    std::memcpy((void*)gnss_synchro_e1.Signal, "1B", 3);
+    gnss_synchro_e1.Pseudorange_m = 21000000.0;
+    pseudoranges.insert(std::pair<int, Gnss_Synchro>(channel++, gnss_synchro_e1));
+
+    std::string MSM4 = rtcm->print_MSM_4(gps_eph, {}, {}, 25.0, pseudoranges, 1234, 0, 0, 0, false, false);
+    EXPECT_TRUE(rtcm->check_CRC(MSM4));
+
+    std::string MSM4_bin = rtcm->binary_data_to_bin(MSM4);
+    unsigned int size_header = 14;
+    unsigned int size_msg_length = 10;
+    unsigned int Ncells = Nsat * Nsig;
+    unsigned int data_bits = 169 + Ncells + Nsat * 18 + Ncells * 48;
+    EXPECT_EQ((data_bits + 7) / 8, rtcm->bin_to_uint(MSM4_bin.substr(size_header, size_msg_length)));
+
+    unsigned int start = size_header + size_msg_length;
+    EXPECT_EQ(0, MSM4_bin.substr(start + 73, 64).compare(std::string(Nsat, '1') + std::string(64 - Nsat, '0'))); // satellite mask
+    EXPECT_EQ(std::string(Ncells, '1'), MSM4_bin.substr(start + 169, Ncells)); // cell mask
+
+    // Cells follow the masks, and the fine pseudoranges refer to the rough range of the satellite
+    double meters_to_miliseconds = GPS_C_m_s * 0.001;
+    unsigned int fine_start = start + 169 + Ncells + Nsat * 18;
+    for(unsigned int sat = 0; sat < Nsat; sat++)
+        {
+            double pseudorange = 20000000.0 + (sat + 1) * 12345.6;
+            double rough_range_m = std::round(pseudorange / meters_to_miliseconds / TWO_N10) * meters_to_miliseconds * TWO_N10;
+            for(unsigned int s = 0; s < Nsig; s++)
+                {
+                    int fine = static_cast<int>(std::round((pseudorange + s * 1.5 - rough_range_m) / meters_to_miliseconds / TWO_N24));
+                    EXPECT_EQ(fine, rtcm->bin_to_int(MSM4_bin.substr(fine_start + (sat * Nsig + s) * 15, 15)));
+                }
+        }
+}
+
+
 TEST(Rtcm_Test, InstantiateServer)
 {
     auto rtcm = std::make_shared<Rtcm>();
@@ -597,5 +684,79 @@ TEST(Rtcm_Test, InstantiateServerWithoutClosing)
 }
 
 
+TEST(Rtcm_Test, CasterFanOut)
+{
+    Rtcm_Caster caster(0, 2, 64);
+    ASSERT_TRUE(caster.start());
+    boost::asio::io_service io_service;
+    boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::address_v4::loopback(), caster.port());
+    boost::asio::ip::tcp::socket client1(io_service);
+    boost::asio::ip::tcp::socket client2(io_service);
+    client1.connect(endpoint);
+    client2.connect(endpoint);
+    for (int i = 0; i < 100 && caster.clients() < 2; i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    ASSERT_EQ(2u, caster.clients());
+
+    std::string expected;
+    for (int i = 0; i < 10; i++)
+        {
+            std::string message = "RTCM message " + std::to_string(i) + "\n";
+            caster.deliver(message);
+            expected += message;
+        }
+    std::string received1(expected.size(), 0);
+    std::string received2(expected.size(), 0);
+    boost::asio::read(client1, boost::asio::buffer(&received1[0], received1.size()));
+    boost::asio::read(client2, boost::asio::buffer(&received2[0], received2.size()));
+    EXPECT_EQ(0, expected.compare(received1));
+    EXPECT_EQ(0, expected.compare(received2));
+
+    // the counters are updated when the write completes, which can be after the data arrives
+    std::vector<Rtcm_Caster::Client_Stats> stats = caster.client_stats();
+    for (int i = 0; i < 100 && (stats.size() != 2 || stats[0].messages_sent < 10 || stats[1].messages_sent < 10); i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            stats = caster.client_stats();
+        }
+    ASSERT_EQ(2u, stats.size());
+    for (unsigned int i = 0; i < stats.size(); i++)
+        {
+            EXPECT_EQ(10u, stats[i].messages_sent);
+            EXPECT_EQ(expected.size(), stats[i].bytes_sent);
+        }
+    caster.stop();
+    EXPECT_EQ(0u, caster.clients());
+}
 
 
+TEST(Rtcm_Test, CasterDropsSlowClient)
+{
+    Rtcm_Caster caster(0, 2, 4);
+    ASSERT_TRUE(caster.start());
+    boost::asio::io_service io_service;
+    boost::asio::ip::tcp::socket client(io_service);
+    client.connect(boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), caster.port()));
+    for (int i = 0; i < 100 && caster.clients() < 1; i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    ASSERT_EQ(1u, caster.clients());
+
+    // the client never reads, so the socket buffers fill up and then the queue
+    const std::string message(65536, 'x');
+    for (int i = 0; i < 2000 && caster.dropped_clients() == 0; i++)
+        {
+            caster.deliver(message);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    EXPECT_EQ(1u, caster.dropped_clients());
+    for (int i = 0; i < 100 && caster.clients() > 0; i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    EXPECT_EQ(0u, caster.clients());
+    caster.stop();
+}
@@ -0,0 +1,136 @@
+/*!
+ * \file tracking_dump_replay_test.cc
+ * \brief  Tests of the replay of the tracking dumps
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstdio>
+#include <string>
+#include "binary_dump_writer.h"
+#include "tracking_dump_replay.h"
+
+
+namespace
+{
+// A GPS L1 C/A channel idle for two records, then tracking PRN 7
+void write_tracking_dump(const std::string & filename, const std::string & block_type, bool with_outputs)
+{
+    Binary_Dump_Writer writer(block_type, 16, false);
+    writer.add_field("prompt_I", BINARY_DUMP_FLOAT32);
+    writer.add_field("prompt_Q", BINARY_DUMP_FLOAT32);
+    writer.add_field("acc_carrier_phase_rad", BINARY_DUMP_FLOAT64);
+    writer.add_field("carrier_doppler_hz", BINARY_DUMP_FLOAT64);
+    writer.add_field("CN0_SNV_dB_Hz", BINARY_DUMP_FLOAT64);
+    if (with_outputs)
+        {
+            writer.add_field("PRN", BINARY_DUMP_UINT32);
+            writer.add_field("tracking_timestamp_secs", BINARY_DUMP_FLOAT64);
+            writer.add_field("valid_symbol", BINARY_DUMP_UINT8);
+            writer.add_field("correlation_length_ms", BINARY_DUMP_UINT32);
+        }
+    ASSERT_TRUE(writer.open(filename));
+    for (unsigned int i = 0; i < 10; i++)
+        {
+            writer.write(1000.0f + i);
+            writer.write(-2.0f);
+            writer.write(-0.5 * i);
+            writer.write(1500.0);
+            writer.write(i < 2 ? 0.0 : 44.0);
+            if (with_outputs)
+                {
+                    writer.write(i < 2 ? 0u : 7u);
+                    writer.write(0.25 + 0.001 * i);
+                    writer.write(i % 2 == 0);
+                    writer.write(1);
+                }
+        }
+    writer.close();
+}
+}
+
+
+TEST(TrackingDumpReplayTest, SkipsTheIdleRecords)
+{
+    const std::string filename = "./tracking_dump_replay_test.dat";
+    write_tracking_dump(filename, "gps_l1_ca_dll_pll_tracking", true);
+
+    Tracking_Dump_Replay replay;
+    ASSERT_TRUE(replay.open(filename)) << replay.error();
+    EXPECT_EQ('G', replay.system());
+    EXPECT_EQ(0, replay.signal().compare("1C"));
+    EXPECT_EQ(7u, replay.prn());
+    EXPECT_EQ(10u, replay.records());
+
+    Gnss_Synchro synchro;
+    ASSERT_TRUE(replay.next(synchro, 3));
+    EXPECT_EQ('G', synchro.System);
+    EXPECT_EQ(0, std::string(synchro.Signal).compare("1C"));
+    EXPECT_EQ(7u, synchro.PRN);
+    EXPECT_EQ(3, synchro.Channel_ID);
+    EXPECT_DOUBLE_EQ(1002.0, synchro.Prompt_I);
+    EXPECT_DOUBLE_EQ(-2.0, synchro.Prompt_Q);
+    EXPECT_DOUBLE_EQ(-1.0, synchro.Carrier_phase_rads);
+    EXPECT_DOUBLE_EQ(1500.0, synchro.Carrier_Doppler_hz);
+    EXPECT_DOUBLE_EQ(44.0, synchro.CN0_dB_hz);
+    EXPECT_DOUBLE_EQ(0.252, synchro.Tracking_timestamp_secs);
+    EXPECT_TRUE(synchro.Flag_valid_symbol_output);
+    EXPECT_EQ(1, synchro.correlation_length_ms);
+
+    unsigned int outputs = 1;
+    while (replay.next(synchro, 3))
+        {
+            outputs++;
+        }
+    EXPECT_EQ(8u, outputs);
+    EXPECT_EQ(8u, replay.replayed());
+    EXPECT_FALSE(synchro.Flag_valid_symbol_output);
+
+    replay.rewind();
+    ASSERT_TRUE(replay.next(synchro, 0));
+    EXPECT_DOUBLE_EQ(0.252, synchro.Tracking_timestamp_secs);
+    std::remove(filename.c_str());
+}
+
+
+TEST(TrackingDumpReplayTest, RejectsOtherDumps)
+{
+    const std::string filename = "./tracking_dump_replay_test.dat";
+    Tracking_Dump_Replay replay;
+    write_tracking_dump(filename, "hybrid_observables", true);
+    EXPECT_FALSE(replay.open(filename));
+    EXPECT_FALSE(replay.error().empty());
+
+    // made before the dumps had the outputs to the telemetry decoders
+    write_tracking_dump(filename, "galileo_e1_veml_tracking", false);
+    EXPECT_FALSE(replay.open(filename));
+    EXPECT_NE(std::string::npos, replay.error().find("PRN")) << replay.error();
+
+    Gnss_Synchro synchro;
+    EXPECT_FALSE(replay.next(synchro, 0));
+    EXPECT_FALSE(replay.open("./no_such_tracking_dump.dat"));
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,430 @@
+/*!
+ * \file acquisition_benchmark_test.cc
+ * \brief  Measures the throughput of every acquisition implementation over
+ *  a sweep of sampling frequencies, Doppler ranges and number of dwells.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The benchmark is built as its own target (acq_benchmark) and is not part
+ * of the regular test suite. Every configuration is run with a threshold that
+ * no search can reach, so that all the searches go through max_dwells dwells
+ * of the full grid and the timings of different implementations are comparable.
+ * Example:
+ *
+ *   ./acq_benchmark --acq_benchmark_fs=2000000,4000000 --acq_benchmark_dwells=1,4
+ *                   --acq_benchmark_report=./acq_benchmark.csv
+ *
+ * QuickSync against the standard PCPS at high sampling rates, with a given
+ * folding factor:
+ *
+ *   ./acq_benchmark --acq_benchmark_implementations=GPS_L1_CA_PCPS_Acquisition,GPS_L1_CA_PCPS_QuickSync_Acquisition
+ *                   --acq_benchmark_fs=4000000,8000000,16000000 --acq_benchmark_folding_factor=4
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <boost/thread.hpp>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/file_source.h>
+#include <gnuradio/msg_queue.h>
+#include <gtest/gtest.h>
+#include "acquisition_interface.h"
+#include "concurrent_queue.h"
+#include "fir_filter.h"
+#include "gen_signal_source.h"
+#include "gnss_block_factory.h"
+#include "gnss_synchro.h"
+#include "in_memory_configuration.h"
+#include "signal_generator.h"
+
+
+DEFINE_string(acq_benchmark_implementations, "GPS_L1_CA_PCPS_Acquisition,GPS_L1_CA_PCPS_Multithread_Acquisition,"
+        "GPS_L1_CA_PCPS_Tong_Acquisition,GPS_L1_CA_PCPS_QuickSync_Acquisition,GPS_L1_CA_PCPS_Shifted_Spectrum_Acquisition,"
+        "GPS_L1_CA_PCPS_Acquisition_Fine_Doppler,Galileo_E1_PCPS_Ambiguous_Acquisition,Galileo_E1_PCPS_CCCWSR_Ambiguous_Acquisition,"
+        "Galileo_E1_PCPS_Tong_Ambiguous_Acquisition,Galileo_E1_PCPS_QuickSync_Ambiguous_Acquisition,"
+        "Galileo_E1_PCPS_8ms_Ambiguous_Acquisition,Galileo_E5a_Noncoherent_IQ_Acquisition_CAF",
+        "Comma-separated list of acquisition implementations to benchmark");
+DEFINE_string(acq_benchmark_fs, "4000000", "Comma-separated list of sampling frequencies [Hz]");
+DEFINE_string(acq_benchmark_doppler_max, "5000,10000", "Comma-separated list of maximum Doppler shifts [Hz]");
+DEFINE_string(acq_benchmark_dwells, "1,2", "Comma-separated list of max_dwells values");
+DEFINE_int32(acq_benchmark_doppler_step, 250, "Doppler step of the search grid [Hz]");
+DEFINE_int32(acq_benchmark_folding_factor, 0, "Folding factor of the QuickSync implementations. If 0, their default is used");
+DEFINE_int32(acq_benchmark_searches, 5, "Number of timed searches per configuration");
+DEFINE_int32(acq_benchmark_timeout_s, 60, "Maximum time allowed for a single search [s]");
+DEFINE_bool(acq_benchmark_generator, false, "Always use the signal generator instead of the signal_samples captures");
+DEFINE_string(acq_benchmark_report, "", "If not empty, CSV file where the results are written");
+
+
+// ######## GNURADIO BLOCK MESSAGE RECEVER #########
+class AcquisitionBenchmark_msg_rx;
+
+typedef boost::shared_ptr<AcquisitionBenchmark_msg_rx> AcquisitionBenchmark_msg_rx_sptr;
+
+AcquisitionBenchmark_msg_rx_sptr AcquisitionBenchmark_msg_rx_make(concurrent_queue<int>& queue);
+
+
+class AcquisitionBenchmark_msg_rx : public gr::block
+{
+private:
+    friend AcquisitionBenchmark_msg_rx_sptr AcquisitionBenchmark_msg_rx_make(concurrent_queue<int>& queue);
+    void msg_handler_events(pmt::pmt_t msg);
+    AcquisitionBenchmark_msg_rx(concurrent_queue<int>& queue);
+    concurrent_queue<int>& channel_internal_queue;
+public:
+    ~AcquisitionBenchmark_msg_rx(); //!< Default destructor
+};
+
+
+AcquisitionBenchmark_msg_rx_sptr AcquisitionBenchmark_msg_rx_make(concurrent_queue<int>& queue)
+{
+    return AcquisitionBenchmark_msg_rx_sptr(new AcquisitionBenchmark_msg_rx(queue));
+}
+
+
+void AcquisitionBenchmark_msg_rx::msg_handler_events(pmt::pmt_t msg)
+{
+    try
+    {
+            long int message = pmt::to_long(msg);
+            channel_internal_queue.push(message);
+    }
+    catch(boost::bad_any_cast& e)
+    {
+            LOG(WARNING) << "msg_handler_telemetry Bad any cast!";
+    }
+}
+
+
+AcquisitionBenchmark_msg_rx::AcquisitionBenchmark_msg_rx(concurrent_queue<int>& queue) :
+    gr::block("AcquisitionBenchmark_msg_rx", gr::io_signature::make(0, 0, 0), gr::io_signature::make(0, 0, 0)), channel_internal_queue(queue)
+{
+    this->message_port_register_in(pmt::mp("events"));
+    this->set_msg_handler(pmt::mp("events"), boost::bind(&AcquisitionBenchmark_msg_rx::msg_handler_events, this, _1));
+}
+
+
+AcquisitionBenchmark_msg_rx::~AcquisitionBenchmark_msg_rx()
+{}
+
+
+// ###########################################################
+
+/*!
+ * \brief Signal searched by an implementation, and capture that contains it
+ */
+struct Acquisition_Benchmark_Signal
+{
+    char system;
+    std::string signal;
+    unsigned int prn;
+    unsigned int coherent_integration_time_ms;
+    std::string capture;         // Captured at 4 Msps. Empty if there is none
+};
+
+
+struct Acquisition_Benchmark_Result
+{
+    std::string implementation;
+    unsigned int fs;
+    unsigned int doppler_max;
+    unsigned int dwells;
+    unsigned int searches;
+    double us_per_search;
+    double bins_per_second;
+    long peak_rss_kb;
+};
+
+
+template <typename T>
+std::vector<T> acq_benchmark_split(const std::string& list)
+{
+    std::vector<T> values;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        {
+            if (item.empty())
+                {
+                    continue;
+                }
+            std::stringstream item_ss(item);
+            T value;
+            item_ss >> value;
+            values.push_back(value);
+        }
+    return values;
+}
+
+
+Acquisition_Benchmark_Signal acq_benchmark_signal(const std::string& implementation)
+{
+    Acquisition_Benchmark_Signal s;
+    if (implementation.find("Galileo_E5a") == 0)
+        {
+            s.system = 'E'; s.signal = "5X"; s.prn = 11; s.coherent_integration_time_ms = 1; s.capture = "";
+        }
+    else if (implementation.find("Galileo_E1") == 0)
+        {
+            s.system = 'E'; s.signal = "1B"; s.prn = 1; s.coherent_integration_time_ms = 4;
+            s.capture = "signal_samples/Galileo_E1_ID_1_Fs_4Msps_8ms.dat";
+        }
+    else
+        {
+            s.system = 'G'; s.signal = "1C"; s.prn = 1; s.coherent_integration_time_ms = 1;
+            s.capture = "signal_samples/GPS_L1_CA_ID_1_Fs_4Msps_2ms.dat";
+        }
+    return s;
+}
+
+
+long acq_benchmark_peak_rss_kb()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; // kilobytes in Linux
+}
+
+
+bool acq_benchmark_run(const std::string& implementation, unsigned int fs, unsigned int doppler_max,
+        unsigned int dwells, Acquisition_Benchmark_Result& result)
+{
+    Acquisition_Benchmark_Signal s = acq_benchmark_signal(implementation);
+    bool use_capture = !FLAGS_acq_benchmark_generator && !s.capture.empty() && fs == 4000000;
+
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+    config->set_property("GNSS-SDR.internal_fs_hz", std::to_string(fs));
+
+    config->set_property("SignalSource.fs_hz", std::to_string(fs));
+    config->set_property("SignalSource.item_type", "gr_complex");
+    config->set_property("SignalSource.num_satellites", "1");
+    config->set_property("SignalSource.system_0", std::string(1, s.system));
+    config->set_property("SignalSource.signal_0", s.signal);
+    config->set_property("SignalSource.PRN_0", std::to_string(s.prn));
+    config->set_property("SignalSource.CN0_dB_0", "44");
+    config->set_property("SignalSource.doppler_Hz_0", "750");
+    config->set_property("SignalSource.delay_chips_0", "600");
+    config->set_property("SignalSource.noise_flag", "true");
+    config->set_property("SignalSource.data_flag", "false");
+    config->set_property("SignalSource.BW_BB", "0.97");
+
+    config->set_property("InputFilter.implementation", "Fir_Filter");
+    config->set_property("InputFilter.input_item_type", "gr_complex");
+    config->set_property("InputFilter.output_item_type", "gr_complex");
+    config->set_property("InputFilter.taps_item_type", "float");
+    config->set_property("InputFilter.number_of_taps", "11");
+    config->set_property("InputFilter.number_of_bands", "2");
+    config->set_property("InputFilter.band1_begin", "0.0");
+    config->set_property("InputFilter.band1_end", "0.97");
+    config->set_property("InputFilter.band2_begin", "0.98");
+    config->set_property("InputFilter.band2_end", "1.0");
+    config->set_property("InputFilter.ampl1_begin", "1.0");
+    config->set_property("InputFilter.ampl1_end", "1.0");
+    config->set_property("InputFilter.ampl2_begin", "0.0");
+    config->set_property("InputFilter.ampl2_end", "0.0");
+    config->set_property("InputFilter.band1_error", "1.0");
+    config->set_property("InputFilter.band2_error", "1.0");
+    config->set_property("InputFilter.filter_type", "bandpass");
+    config->set_property("InputFilter.grid_density", "16");
+
+    config->set_property("Acquisition.item_type", "gr_complex");
+    config->set_property("Acquisition.if", "0");
+    config->set_property("Acquisition.coherent_integration_time_ms", std::to_string(s.coherent_integration_time_ms));
+    config->set_property("Acquisition.max_dwells", std::to_string(dwells));
+    config->set_property("Acquisition.implementation", implementation);
+    config->set_property("Acquisition.doppler_max", std::to_string(doppler_max));
+    config->set_property("Acquisition.doppler_min", std::to_string(-static_cast<int>(doppler_max)));
+    config->set_property("Acquisition.doppler_step", std::to_string(FLAGS_acq_benchmark_doppler_step));
+    if (FLAGS_acq_benchmark_folding_factor > 0)
+        {
+            config->set_property("Acquisition.folding_factor", std::to_string(FLAGS_acq_benchmark_folding_factor));
+        }
+    config->set_property("Acquisition.bit_transition_flag", "false");
+    config->set_property("Acquisition.dump", "false");
+
+    GNSSBlockFactory factory;
+    std::shared_ptr<GNSSBlockInterface> acq_ = factory.GetBlock(config, "Acquisition", implementation, 1, 1);
+    std::shared_ptr<AcquisitionInterface> acquisition = std::dynamic_pointer_cast<AcquisitionInterface>(acq_);
+    if (!acquisition)
+        {
+            std::cout << "Unknown acquisition implementation " << implementation << std::endl;
+            return false;
+        }
+
+    Gnss_Synchro gnss_synchro = Gnss_Synchro();
+    gnss_synchro.Channel_ID = 0;
+    gnss_synchro.System = s.system;
+    s.signal.copy(gnss_synchro.Signal, 2, 0);
+    gnss_synchro.PRN = s.prn;
+
+    concurrent_queue<int> channel_internal_queue;
+    gr::msg_queue::sptr queue = gr::msg_queue::make(0);
+    gr::top_block_sptr top_block = gr::make_top_block("Acquisition benchmark");
+    boost::shared_ptr<AcquisitionBenchmark_msg_rx> msg_rx = AcquisitionBenchmark_msg_rx_make(channel_internal_queue);
+
+    acquisition->set_channel(0);
+    acquisition->set_gnss_synchro(&gnss_synchro);
+    acquisition->set_doppler_max(doppler_max);
+    acquisition->set_doppler_step(FLAGS_acq_benchmark_doppler_step);
+    acquisition->set_threshold(1e9); // Never reached: every search uses all its dwells
+    acquisition->connect(top_block);
+    top_block->msg_connect(acquisition->get_right_block(), pmt::mp("events"), msg_rx, pmt::mp("events"));
+    acquisition->init();
+
+    boost::shared_ptr<GenSignalSource> signal_source;
+    if (use_capture)
+        {
+            std::string file = std::string(TEST_PATH) + s.capture;
+            gr::blocks::file_source::sptr file_source = gr::blocks::file_source::make(sizeof(gr_complex), file.c_str(), true);
+            top_block->connect(file_source, 0, acquisition->get_left_block(), 0);
+        }
+    else
+        {
+            SignalGenerator* signal_generator = new SignalGenerator(config.get(), "SignalSource", 0, 1, queue);
+            FirFilter* filter = new FirFilter(config.get(), "InputFilter", 1, 1);
+            signal_source.reset(new GenSignalSource(signal_generator, filter, "SignalSource", queue));
+            signal_source->connect(top_block);
+            top_block->connect(signal_source->get_right_block(), 0, acquisition->get_left_block(), 0);
+        }
+
+    top_block->start();
+
+    // The first search warms up the FFT plans and caches, and is not timed
+    bool timed_out = false;
+    long long int total_us = 0;
+    for (int search = 0; search <= FLAGS_acq_benchmark_searches && !timed_out; search++)
+        {
+            struct timeval tv;
+            gettimeofday(&tv, NULL);
+            long long int begin = tv.tv_sec * 1000000 + tv.tv_usec;
+            long long int end = begin;
+
+            acquisition->reset();
+
+            int message = 0;
+            while (!channel_internal_queue.try_pop(message))
+                {
+                    boost::this_thread::sleep(boost::posix_time::microseconds(100));
+                    gettimeofday(&tv, NULL);
+                    end = tv.tv_sec * 1000000 + tv.tv_usec;
+                    if (end - begin > static_cast<long long int>(FLAGS_acq_benchmark_timeout_s) * 1000000)
+                        {
+                            timed_out = true;
+                            break;
+                        }
+                }
+            gettimeofday(&tv, NULL);
+            end = tv.tv_sec * 1000000 + tv.tv_usec;
+            if (search > 0)
+                {
+                    total_us += end - begin;
+                }
+        }
+
+    top_block->stop();
+    top_block->wait();
+
+    if (timed_out)
+        {
+            std::cout << implementation << " did not finish a search in " << FLAGS_acq_benchmark_timeout_s << " s" << std::endl;
+            return false;
+        }
+
+    unsigned int doppler_bins = 2 * doppler_max / FLAGS_acq_benchmark_doppler_step + 1;
+    result.implementation = implementation;
+    result.fs = fs;
+    result.doppler_max = doppler_max;
+    result.dwells = dwells;
+    result.searches = FLAGS_acq_benchmark_searches;
+    result.us_per_search = static_cast<double>(total_us) / static_cast<double>(std::max(FLAGS_acq_benchmark_searches, 1));
+    result.bins_per_second = (result.us_per_search > 0.0 ? static_cast<double>(doppler_bins * dwells) * 1e6 / result.us_per_search : 0.0);
+    result.peak_rss_kb = acq_benchmark_peak_rss_kb();
+    return true;
+}
+
+
+TEST(AcquisitionBenchmark, ThroughputReport)
+{
+    std::vector<std::string> implementations = acq_benchmark_split<std::string>(FLAGS_acq_benchmark_implementations);
+    std::vector<unsigned int> fs_list = acq_benchmark_split<unsigned int>(FLAGS_acq_benchmark_fs);
+    std::vector<unsigned int> doppler_list = acq_benchmark_split<unsigned int>(FLAGS_acq_benchmark_doppler_max);
+    std::vector<unsigned int> dwells_list = acq_benchmark_split<unsigned int>(FLAGS_acq_benchmark_dwells);
+    std::vector<Acquisition_Benchmark_Result> results;
+
+    for (unsigned int i = 0; i < implementations.size(); i++)
+        {
+            for (unsigned int f = 0; f < fs_list.size(); f++)
+                {
+                    for (unsigned int d = 0; d < doppler_list.size(); d++)
+                        {
+                            for (unsigned int w = 0; w < dwells_list.size(); w++)
+                                {
+                                    Acquisition_Benchmark_Result result;
+                                    EXPECT_NO_THROW(
+                                            if (acq_benchmark_run(implementations[i], fs_list[f], doppler_list[d], dwells_list[w], result))
+                                                {
+                                                    results.push_back(result);
+                                                }
+                                    ) << "Exception running " << implementations[i];
+                                }
+                        }
+                }
+        }
+
+    // Peak RSS is the maximum of the whole process so far, so it never decreases along the report
+    std::cout << std::left << std::setw(48) << "implementation" << std::right
+              << std::setw(10) << "fs [Hz]" << std::setw(14) << "doppler [Hz]" << std::setw(8) << "dwells"
+              << std::setw(16) << "us/search" << std::setw(16) << "bins/s" << std::setw(16) << "peak RSS [kB]" << std::endl;
+    for (unsigned int i = 0; i < results.size(); i++)
+        {
+            std::cout << std::left << std::setw(48) << results[i].implementation << std::right
+                      << std::setw(10) << results[i].fs << std::setw(14) << results[i].doppler_max << std::setw(8) << results[i].dwells
+                      << std::setw(16) << std::fixed << std::setprecision(1) << results[i].us_per_search
+                      << std::setw(16) << results[i].bins_per_second << std::setw(16) << results[i].peak_rss_kb << std::endl;
+        }
+
+    if (!FLAGS_acq_benchmark_report.empty())
+        {
+            std::ofstream report(FLAGS_acq_benchmark_report.c_str());
+            report << "implementation,fs_hz,doppler_max_hz,dwells,searches,us_per_search,doppler_bins_per_s,peak_rss_kb" << std::endl;
+            for (unsigned int i = 0; i < results.size(); i++)
+                {
+                    report << results[i].implementation << "," << results[i].fs << "," << results[i].doppler_max << ","
+                           << results[i].dwells << "," << results[i].searches << "," << results[i].us_per_search << ","
+                           << results[i].bins_per_second << "," << results[i].peak_rss_kb << std::endl;
+                }
+        }
+
+    EXPECT_FALSE(results.empty());
+}
@@ -0,0 +1,258 @@
+/*!
+ * \file backend_benchmark_test.cc
+ * \brief  Measures the epochs per second of each stage of the back end
+ *  (telemetry decoders, observables and PVT), replayed from tracking dumps.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The benchmark is built as its own target (backend_benchmark) and is not
+ * part of the regular test suite. The dumps of the GPS L1 C/A and Galileo
+ * E1 tracking blocks of a receiver run with Tracking_1C.dump=true and
+ * Tracking_1B.dump=true are replayed by tracking_dump_source, one channel
+ * per dump, into the telemetry decoders, Hybrid_Observables and the PVT,
+ * with no throttle. The epochs per second of a stage are the outputs of
+ * its blocks over the time they spent in their work, as read from the
+ * GNU Radio performance counters, so the stages are measured separately
+ * even though they run together. The heap allocations of the threads of
+ * each stage are counted and given per epoch. Example:
+ *
+ *   ./backend_benchmark --backend_benchmark_dumps=./epl_tracking_ch_0.dat,./epl_tracking_ch_1.dat,...
+ *                       --backend_benchmark_report=./backend_benchmark.csv
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/lexical_cast.hpp>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <gnuradio/top_block.h>
+#include <gtest/gtest.h>
+#include "gnss_block_factory.h"
+#include "gnss_block_interface.h"
+#include "gnss_block_metrics.h"
+#include "gnss_sdr_allocation_tracker.h"
+#include "in_memory_configuration.h"
+#include "telemetry_decoder_interface.h"
+#include "tracking_dump_source.h"
+
+
+DEFINE_string(backend_benchmark_dumps, "", "Comma-separated list of GPS L1 C/A and Galileo E1 tracking dumps, one per channel");
+DEFINE_string(backend_benchmark_pvt, "Hybrid_PVT", "PVT implementation");
+DEFINE_string(backend_benchmark_report, "", "If not empty, CSV file where the results are written");
+
+
+struct Backend_Benchmark_Stage
+{
+    std::string name;
+    std::vector<gr::basic_block_sptr> blocks;
+    unsigned long long items;          // outputs, or inputs of a sink, in the measured interval
+    double epochs_per_s;               // items over the work time of the blocks
+    unsigned long long allocations;
+};
+
+
+std::vector<std::string> backend_benchmark_split(const std::string& list)
+{
+    std::vector<std::string> values;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        {
+            if (!item.empty())
+                {
+                    values.push_back(item);
+                }
+        }
+    return values;
+}
+
+
+// GNU Radio names the thread of a block after its name and unique id,
+// cut to the 15 characters of a thread name
+bool backend_benchmark_runs_block(const std::string& thread_name, const gr::basic_block_sptr& block)
+{
+    const std::string name = block->name() + boost::lexical_cast<std::string>(block->unique_id());
+    return !thread_name.empty() && name.compare(0, thread_name.size(), thread_name) == 0;
+}
+
+
+TEST(BackendBenchmark, EpochsPerStageReport)
+{
+    std::vector<std::string> dumps = backend_benchmark_split(FLAGS_backend_benchmark_dumps);
+    if (dumps.empty())
+        {
+            std::cout << "No tracking dumps given, set --backend_benchmark_dumps" << std::endl;
+            return;
+        }
+    const unsigned int nchannels = dumps.size();
+
+    tracking_dump_source_sptr source = make_tracking_dump_source(dumps);
+    ASSERT_TRUE(source->error().empty()) << source->error();
+
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+    config->set_property("TelemetryDecoder_1C.dump", "false");
+    config->set_property("TelemetryDecoder_1B.dump", "false");
+    config->set_property("Observables.dump", "false");
+    config->set_property("PVT.dump", "false");
+    config->set_property("PVT.flag_rtcm_server", "false");
+    config->set_property("PVT.flag_rtcm_tty_port", "false");
+    config->set_property("PVT.flag_nmea_tty_port", "false");
+    // the solutions are computed in the work of the PVT block, where they are measured
+    config->set_property("PVT.solver_thread", "false");
+
+    GNSSBlockFactory factory;
+    gr::top_block_sptr top_block = gr::make_top_block("Back end benchmark");
+    std::vector<std::shared_ptr<GNSSBlockInterface>> decoders;
+    for (unsigned int i = 0; i < nchannels; i++)
+        {
+            const bool galileo = source->signal(i) == "1B";
+            std::shared_ptr<GNSSBlockInterface> block = factory.GetBlock(config,
+                    galileo ? "TelemetryDecoder_1B" : "TelemetryDecoder_1C",
+                    galileo ? "Galileo_E1B_Telemetry_Decoder" : "GPS_L1_CA_Telemetry_Decoder", 1, 1);
+            std::shared_ptr<TelemetryDecoderInterface> decoder = std::dynamic_pointer_cast<TelemetryDecoderInterface>(block);
+            ASSERT_TRUE(decoder != nullptr);
+            decoder->set_channel(i);
+            decoder->set_satellite(source->satellite(i));
+            decoder->connect(top_block);
+            decoders.push_back(block);
+        }
+    std::shared_ptr<GNSSBlockInterface> observables = factory.GetBlock(config, "Observables", "Hybrid_Observables", nchannels, nchannels);
+    std::shared_ptr<GNSSBlockInterface> pvt = factory.GetBlock(config, "PVT", FLAGS_backend_benchmark_pvt, nchannels, 1);
+    ASSERT_TRUE(observables != nullptr);
+    ASSERT_TRUE(pvt != nullptr) << "Unknown PVT implementation " << FLAGS_backend_benchmark_pvt;
+    observables->connect(top_block);
+    pvt->connect(top_block);
+
+    for (unsigned int i = 0; i < nchannels; i++)
+        {
+            top_block->connect(source, i, decoders[i]->get_left_block(), 0);
+            top_block->connect(decoders[i]->get_right_block(), 0, observables->get_left_block(), i);
+            top_block->connect(observables->get_right_block(), i, pvt->get_left_block(), i);
+            top_block->msg_connect(decoders[i]->get_right_block(), pmt::mp("telemetry"), pvt->get_left_block(), pmt::mp("telemetry"));
+        }
+
+    std::vector<Backend_Benchmark_Stage> stages(3);
+    stages[0].name = "TelemetryDecoder";
+    for (unsigned int i = 0; i < nchannels; i++)
+        {
+            stages[0].blocks.push_back(decoders[i]->get_right_block());
+        }
+    stages[1].name = "Observables";
+    stages[1].blocks.push_back(observables->get_right_block());
+    stages[2].name = "PVT";
+    stages[2].blocks.push_back(pvt->get_left_block());
+
+    Gnss_Block_Metrics::enable_performance_counters();
+    Gnss_Block_Metrics metrics;
+    for (unsigned int s = 0; s < stages.size(); s++)
+        {
+            for (unsigned int b = 0; b < stages[s].blocks.size(); b++)
+                {
+                    metrics.add_block(stages[s].name, stages[s].blocks[b]);
+                }
+        }
+
+    // The counters of a block exist once it is started
+    Gnss_Sdr_Allocation_Tracker::arm(false);
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    top_block->start();
+    metrics.sample();
+    const std::chrono::steady_clock::time_point sampled = std::chrono::steady_clock::now();
+    top_block->wait();
+    metrics.sample();
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    Gnss_Sdr_Allocation_Tracker::disarm();
+    const double wall_s = std::chrono::duration<double>(end - begin).count();
+    const double measured_s = std::chrono::duration<double>(end - sampled).count();
+
+    // the stats are in the order of the blocks added
+    std::vector<Gnss_Block_Metrics::Block_Stats> stats = metrics.stats();
+    std::vector<Gnss_Sdr_Allocation_Tracker::Thread_Allocations> threads = Gnss_Sdr_Allocation_Tracker::threads();
+    unsigned int index = 0;
+    for (unsigned int s = 0; s < stages.size(); s++)
+        {
+            double items_per_s = 0.0;
+            double load = 0.0;
+            for (unsigned int b = 0; b < stages[s].blocks.size(); b++, index++)
+                {
+                    items_per_s += stats.at(index).items_per_s;
+                    load += stats.at(index).load;
+                }
+            stages[s].items = static_cast<unsigned long long>(items_per_s * measured_s + 0.5);
+            stages[s].epochs_per_s = load > 0.0 ? items_per_s / load : 0.0;
+            stages[s].allocations = 0;
+        }
+    for (unsigned int t = 0; t < threads.size(); t++)
+        {
+            bool counted = false;
+            for (unsigned int s = 0; s < stages.size() && !counted; s++)
+                {
+                    for (unsigned int b = 0; b < stages[s].blocks.size() && !counted; b++)
+                        {
+                            if (backend_benchmark_runs_block(threads[t].name, stages[s].blocks[b]))
+                                {
+                                    stages[s].allocations += threads[t].allocations;
+                                    counted = true;
+                                }
+                        }
+                }
+        }
+
+    std::cout << nchannels << " channels, " << source->replayed() << " tracking outputs replayed in "
+              << std::fixed << std::setprecision(3) << wall_s << " s, "
+              << std::setprecision(0) << static_cast<double>(stages[2].items) / measured_s << " PVT epochs/s end to end" << std::endl;
+    std::cout << std::left << std::setw(18) << "stage" << std::right << std::setw(8) << "blocks" << std::setw(12) << "epochs"
+              << std::setw(14) << "epochs/s" << std::setw(18) << "allocs/epoch" << std::endl;
+    for (unsigned int s = 0; s < stages.size(); s++)
+        {
+            const double per_epoch = stages[s].items > 0 ? static_cast<double>(stages[s].allocations) / static_cast<double>(stages[s].items) : 0.0;
+            std::cout << std::left << std::setw(18) << stages[s].name << std::right << std::setw(8) << stages[s].blocks.size()
+                      << std::setw(12) << stages[s].items << std::setprecision(0) << std::setw(14) << stages[s].epochs_per_s
+                      << std::setprecision(3) << std::setw(18) << per_epoch << std::endl;
+        }
+
+    if (!FLAGS_backend_benchmark_report.empty())
+        {
+            std::ofstream report(FLAGS_backend_benchmark_report.c_str());
+            report << "stage,blocks,epochs,epochs_per_s,allocations_per_epoch" << std::endl;
+            for (unsigned int s = 0; s < stages.size(); s++)
+                {
+                    report << stages[s].name << "," << stages[s].blocks.size() << "," << stages[s].items << ","
+                           << stages[s].epochs_per_s << ","
+                           << (stages[s].items > 0 ? static_cast<double>(stages[s].allocations) / static_cast<double>(stages[s].items) : 0.0)
+                           << std::endl;
+                }
+        }
+
+    EXPECT_GT(source->replayed(), 0u);
+    EXPECT_GT(stages[1].items, 0u);
+}
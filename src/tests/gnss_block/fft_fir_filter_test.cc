@@ -0,0 +1,81 @@
+/*!
+ * \file fft_fir_filter_test.cc
+ * \brief Checks the overlap-save FIR filter against fir_filter_ccf.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/vector_source_c.h>
+#include <gnuradio/blocks/vector_sink_c.h>
+#include <gnuradio/filter/fir_filter_ccf.h>
+#include <gtest/gtest.h>
+#include "fft_fir_filter.h"
+
+
+TEST(Fft_Fir_Filter_Test, MatchesDirectForm)
+{
+    std::vector<float> taps;
+    for (int k = 0; k < 211; k++)
+        {
+            taps.push_back(std::sin(0.05 * k) / (1.0 + k));
+        }
+    std::vector<gr_complex> in(20000);
+    for (unsigned int n = 0; n < in.size(); n++)
+        {
+            in[n] = gr_complex(std::cos(0.001 * n * n), std::sin(0.3 * n));
+        }
+
+    unsigned int decimations[2] = { 1, 4 };
+    for (unsigned int d = 0; d < 2; d++)
+        {
+            gr::top_block_sptr top_block = gr::make_top_block("Fft_Fir_Filter test");
+            gr::blocks::vector_source_c::sptr source = gr::blocks::vector_source_c::make(in);
+            gr::filter::fir_filter_ccf::sptr direct = gr::filter::fir_filter_ccf::make(decimations[d], taps);
+            fft_fir_filter_sptr fft_filter = make_fft_fir_filter(taps, decimations[d], false, false);
+            gr::blocks::vector_sink_c::sptr direct_sink = gr::blocks::vector_sink_c::make();
+            gr::blocks::vector_sink_c::sptr fft_sink = gr::blocks::vector_sink_c::make();
+            top_block->connect(source, 0, direct, 0);
+            top_block->connect(source, 0, fft_filter, 0);
+            top_block->connect(direct, 0, direct_sink, 0);
+            top_block->connect(fft_filter, 0, fft_sink, 0);
+            top_block->run();
+
+            // The FFT filter only outputs whole blocks
+            std::vector<gr_complex> expected = direct_sink->data();
+            std::vector<gr_complex> filtered = fft_sink->data();
+            ASSERT_GT(filtered.size(), 0u);
+            ASSERT_LE(filtered.size(), expected.size());
+            for (unsigned int n = 0; n < filtered.size(); n++)
+                {
+                    ASSERT_NEAR(expected[n].real(), filtered[n].real(), 1e-4);
+                    ASSERT_NEAR(expected[n].imag(), filtered[n].imag(), 1e-4);
+                }
+        }
+}
@@ -0,0 +1,500 @@
+/*!
+ * \file gps_l1_ca_dll_pll_tracking_group_test.cc
+ * \brief Tests of the tracking of a group of GPS L1 C/A channels in one
+ * gps_l1_ca_dll_pll_tracking_group_cc block, with generated signals
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <boost/weak_ptr.hpp>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/blocks/vector_sink_b.h>
+#include <gnuradio/blocks/vector_source_c.h>
+#include <gtest/gtest.h>
+#include "channel.h"
+#include "control_event_bus.h"
+#include "gnss_signal.h"
+#include "gnss_synchro.h"
+#include "gps_l1_ca_dll_pll_tracking.h"
+#include "gps_l1_ca_dll_pll_tracking_group_cc.h"
+#include "gps_l1_ca_pcps_acquisition.h"
+#include "gps_l1_ca_telemetry_decoder.h"
+#include "gps_sdr_signal_processing.h"
+#include "in_memory_configuration.h"
+#include "GPS_L1_CA.h"
+
+
+class GpsL1CaDllPllTrackingGroupTest: public ::testing::Test
+{
+protected:
+    GpsL1CaDllPllTrackingGroupTest()
+    {
+        config = std::make_shared<InMemoryConfiguration>();
+        fs_in = 2048000;
+        prn = { 1, 2 };
+        doppler_hz = { 1250.0, -2100.0 };
+        delay_samples = { 500, 1500 };
+    }
+
+    ~GpsL1CaDllPllTrackingGroupTest()
+    {}
+
+    void init(unsigned int group_size, unsigned int group_threads);
+
+    //! The satellites in prn, with unit amplitude, plus white noise of the given power
+    std::vector<gr_complex> generate_signal(unsigned int nsamples, float noise_power);
+
+    //! The acquisition results of satellite \p satellite for channel \p channel
+    void set_acquisition(Gnss_Synchro& gnss_synchro, unsigned int channel, unsigned int satellite);
+
+    //! The tracking outputs collected by \p sink
+    std::vector<Gnss_Synchro> outputs(gr::blocks::vector_sink_b::sptr sink);
+
+    /*!
+     * The outputs of each satellite in a group of role Tracking_1C and in a block per channel.
+     * With \p idle_member, a channel that is not tracking sits between the two satellites in the group.
+     */
+    void track(std::vector<std::vector<Gnss_Synchro> >& grouped_epochs,
+            std::vector<std::vector<Gnss_Synchro> >& single_epochs,
+            bool idle_member = false);
+
+    std::shared_ptr<InMemoryConfiguration> config;
+    int fs_in;
+    std::vector<unsigned int> prn;
+    std::vector<double> doppler_hz;
+    std::vector<unsigned int> delay_samples;
+};
+
+
+void GpsL1CaDllPllTrackingGroupTest::init(unsigned int group_size, unsigned int group_threads)
+{
+    config->set_property("GNSS-SDR.internal_fs_hz", std::to_string(fs_in));
+    config->set_property("GNSS-SDR.receiver_index", "0");
+    config->set_property("Tracking_1C.implementation", "GPS_L1_CA_DLL_PLL_Tracking");
+    config->set_property("Tracking_1C.item_type", "gr_complex");
+    config->set_property("Tracking_1C.dump", "false");
+    config->set_property("Tracking_1C.pll_bw_hz", "45");
+    config->set_property("Tracking_1C.dll_bw_hz", "2");
+    config->set_property("Tracking_1C.early_late_space_chips", "0.5");
+    config->set_property("Tracking_1C.channel_group_size", std::to_string(group_size));
+    config->set_property("Tracking_1C.channel_group_threads", std::to_string(group_threads));
+    // the same loops in a block per channel
+    config->set_property("Tracking_1C_single.implementation", "GPS_L1_CA_DLL_PLL_Tracking");
+    config->set_property("Tracking_1C_single.item_type", "gr_complex");
+    config->set_property("Tracking_1C_single.dump", "false");
+    config->set_property("Tracking_1C_single.pll_bw_hz", "45");
+    config->set_property("Tracking_1C_single.dll_bw_hz", "2");
+    config->set_property("Tracking_1C_single.early_late_space_chips", "0.5");
+}
+
+
+std::vector<gr_complex> GpsL1CaDllPllTrackingGroupTest::generate_signal(unsigned int nsamples, float noise_power)
+{
+    std::vector<gr_complex> samples(nsamples);
+    std::mt19937 generator(2016);
+    std::normal_distribution<float> noise(0.0, std::sqrt(noise_power / 2.0));
+    for (unsigned int n = 0; n < nsamples; n++)
+        {
+            samples[n] = gr_complex(noise(generator), noise(generator));
+        }
+    std::vector<gr_complex> code(static_cast<int>(GPS_L1_CA_CODE_LENGTH_CHIPS));
+    for (unsigned int i = 0; i < prn.size(); i++)
+        {
+            gps_l1_ca_code_gen_complex(code.data(), prn.at(i), 0);
+            // the code is stretched by the Doppler effect too
+            const double code_rate_chips = GPS_L1_CA_CODE_RATE_HZ * (1.0 + doppler_hz.at(i) / GPS_L1_FREQ_HZ);
+            for (unsigned int n = 0; n < nsamples; n++)
+                {
+                    const double t = (static_cast<double>(n) - static_cast<double>(delay_samples.at(i))) / static_cast<double>(fs_in);
+                    double chip = std::fmod(t * code_rate_chips, GPS_L1_CA_CODE_LENGTH_CHIPS);
+                    if (chip < 0) chip += GPS_L1_CA_CODE_LENGTH_CHIPS;
+                    const double phase = GPS_TWO_PI * doppler_hz.at(i) * static_cast<double>(n) / static_cast<double>(fs_in);
+                    samples[n] += code.at(static_cast<unsigned int>(chip) % code.size())
+                            * gr_complex(static_cast<float>(cos(phase)), static_cast<float>(sin(phase)));
+                }
+        }
+    return samples;
+}
+
+
+void GpsL1CaDllPllTrackingGroupTest::set_acquisition(Gnss_Synchro& gnss_synchro, unsigned int channel, unsigned int satellite)
+{
+    gnss_synchro = Gnss_Synchro();
+    gnss_synchro.Channel_ID = channel;
+    gnss_synchro.System = 'G';
+    std::string signal = "1C";
+    signal.copy(gnss_synchro.Signal, 2, 0);
+    gnss_synchro.PRN = prn.at(satellite);
+    gnss_synchro.Acq_delay_samples = delay_samples.at(satellite);
+    gnss_synchro.Acq_doppler_hz = doppler_hz.at(satellite);
+    gnss_synchro.Acq_samplestamp_samples = 0;
+}
+
+
+std::vector<Gnss_Synchro> GpsL1CaDllPllTrackingGroupTest::outputs(gr::blocks::vector_sink_b::sptr sink)
+{
+    std::vector<unsigned char> bytes = sink->data();
+    std::vector<Gnss_Synchro> items(bytes.size() / sizeof(Gnss_Synchro));
+    if (items.empty() == false)
+        {
+            std::memcpy(&items[0], &bytes[0], items.size() * sizeof(Gnss_Synchro));
+        }
+    return items;
+}
+
+
+TEST_F(GpsL1CaDllPllTrackingGroupTest, GroupsOfARole)
+{
+    init(2, 1);
+    std::vector<std::shared_ptr<TrackingInterface> > tracking;
+    for (unsigned int channel = 0; channel < 3; channel++)
+        {
+            tracking.push_back(std::make_shared<GpsL1CaDllPllTracking>(config.get(), "Tracking_1C", 1, 1));
+            tracking.back()->set_channel(channel);
+        }
+
+    // the first two channels fill a group, the third one starts another
+    gps_l1_ca_dll_pll_tracking_group_cc_sptr group =
+            boost::dynamic_pointer_cast<gps_l1_ca_dll_pll_tracking_group_cc>(tracking.at(0)->get_left_block());
+    ASSERT_TRUE(group.get() != 0);
+    EXPECT_EQ(2u, group->members());
+    EXPECT_EQ(group, tracking.at(0)->get_right_block());
+    EXPECT_EQ(group, tracking.at(1)->get_left_block());
+    EXPECT_EQ(group, tracking.at(1)->get_right_block());
+    EXPECT_NE(group, tracking.at(2)->get_left_block());
+    EXPECT_EQ(0, tracking.at(0)->port());
+    EXPECT_EQ(1, tracking.at(1)->port());
+    EXPECT_EQ(0, tracking.at(2)->port());
+
+    // the message ports of each channel, and the shared ones
+    EXPECT_EQ("events_0", tracking.at(0)->message_port("events"));
+    EXPECT_EQ("events_1", tracking.at(1)->message_port("events"));
+    EXPECT_EQ("preamble_timestamp_s_1", tracking.at(1)->message_port("preamble_timestamp_s"));
+    EXPECT_EQ("stop_tracking_1", tracking.at(1)->message_port("stop_tracking"));
+    EXPECT_EQ("vector_tracking", tracking.at(1)->message_port("vector_tracking"));
+    EXPECT_EQ("parameters", tracking.at(1)->message_port("parameters"));
+    for (unsigned int channel = 0; channel < 2; channel++)
+        {
+            EXPECT_TRUE(group->has_msg_port(pmt::mp(tracking.at(channel)->message_port("events"))));
+            EXPECT_TRUE(group->has_msg_port(pmt::mp(tracking.at(channel)->message_port("preamble_timestamp_s"))));
+            EXPECT_TRUE(group->has_msg_port(pmt::mp(tracking.at(channel)->message_port("stop_tracking"))));
+        }
+    EXPECT_TRUE(group->has_msg_port(pmt::mp("vector_tracking")));
+
+    // the channels of another receiver of the process have their own groups
+    config->set_property("GNSS-SDR.receiver_index", "1");
+    tracking.push_back(std::make_shared<GpsL1CaDllPllTracking>(config.get(), "Tracking_1C", 1, 1));
+    tracking.back()->set_channel(0);
+    EXPECT_NE(tracking.at(2)->get_left_block(), tracking.at(3)->get_left_block());
+    EXPECT_EQ(0, tracking.at(3)->port());
+    config->set_property("GNSS-SDR.receiver_index", "0");
+    tracking.push_back(std::make_shared<GpsL1CaDllPllTracking>(config.get(), "Tracking_1C", 1, 1));
+    tracking.back()->set_channel(3);
+    EXPECT_EQ(tracking.at(2)->get_left_block(), tracking.at(4)->get_left_block());
+    EXPECT_EQ(1, tracking.at(4)->port());
+
+    // a role without groups keeps a block per channel and the plain ports
+    std::shared_ptr<TrackingInterface> single = std::make_shared<GpsL1CaDllPllTracking>(config.get(), "Tracking_1C_single", 1, 1);
+    single->set_channel(5);
+    EXPECT_TRUE(boost::dynamic_pointer_cast<gps_l1_ca_dll_pll_tracking_group_cc>(single->get_left_block()).get() == 0);
+    EXPECT_EQ(0, single->port());
+    EXPECT_EQ("events", single->message_port("events"));
+    EXPECT_EQ("preamble_timestamp_s", single->message_port("preamble_timestamp_s"));
+
+    // the groups being filled are only weakly referenced, and go away with their channels
+    boost::weak_ptr<gr::basic_block> unfilled = tracking.at(3)->get_left_block();
+    tracking.at(3).reset();
+    EXPECT_TRUE(unfilled.expired());
+    config->set_property("GNSS-SDR.receiver_index", "1");
+    std::shared_ptr<TrackingInterface> rejoined = std::make_shared<GpsL1CaDllPllTracking>(config.get(), "Tracking_1C", 1, 1);
+    rejoined->set_channel(1);
+    group = boost::dynamic_pointer_cast<gps_l1_ca_dll_pll_tracking_group_cc>(rejoined->get_left_block());
+    ASSERT_TRUE(group.get() != 0);
+    EXPECT_EQ(1u, group->members());
+    EXPECT_EQ(0, rejoined->port());
+}
+
+
+void GpsL1CaDllPllTrackingGroupTest::track(std::vector<std::vector<Gnss_Synchro> >& grouped_epochs,
+        std::vector<std::vector<Gnss_Synchro> >& single_epochs,
+        bool idle_member)
+{
+    const unsigned int nsamples = fs_in;  // one second
+    std::vector<gr_complex> samples = generate_signal(nsamples, 2.0);
+    gr::top_block_sptr top_block = gr::make_top_block("Tracking group test");
+
+    // satellite i is tracked in port i of the group and by block i of the reference
+    std::vector<Gnss_Synchro> gnss_synchro(5);
+    std::vector<std::shared_ptr<TrackingInterface> > grouped;
+    std::vector<std::shared_ptr<TrackingInterface> > single;
+    std::shared_ptr<TrackingInterface> idle;
+    for (unsigned int satellite = 0; satellite < 2; satellite++)
+        {
+            if (idle_member and satellite == 1)
+                {
+                    idle = std::make_shared<GpsL1CaDllPllTracking>(config.get(), "Tracking_1C", 1, 1);
+                    set_acquisition(gnss_synchro.at(4), 4, satellite);
+                    idle->set_channel(4);
+                    idle->set_gnss_synchro(&gnss_synchro.at(4));
+                }
+            grouped.push_back(std::make_shared<GpsL1CaDllPllTracking>(config.get(), "Tracking_1C", 1, 1));
+            set_acquisition(gnss_synchro.at(satellite), satellite, satellite);
+            grouped.back()->set_channel(satellite);
+            grouped.back()->set_gnss_synchro(&gnss_synchro.at(satellite));
+            single.push_back(std::make_shared<GpsL1CaDllPllTracking>(config.get(), "Tracking_1C_single", 1, 1));
+            set_acquisition(gnss_synchro.at(2 + satellite), 2 + satellite, satellite);
+            single.back()->set_channel(2 + satellite);
+            single.back()->set_gnss_synchro(&gnss_synchro.at(2 + satellite));
+        }
+    ASSERT_EQ(grouped.at(0)->get_left_block(), grouped.at(1)->get_left_block());
+
+    std::vector<gr::blocks::vector_sink_b::sptr> grouped_sinks;
+    std::vector<gr::blocks::vector_sink_b::sptr> single_sinks;
+    ASSERT_NO_THROW( {
+        gr::blocks::vector_source_c::sptr source = gr::blocks::vector_source_c::make(samples, false);
+        for (unsigned int satellite = 0; satellite < 2; satellite++)
+            {
+                grouped_sinks.push_back(gr::blocks::vector_sink_b::make(sizeof(Gnss_Synchro)));
+                top_block->connect(source, 0, grouped.at(satellite)->get_left_block(), grouped.at(satellite)->port());
+                top_block->connect(grouped.at(satellite)->get_right_block(), grouped.at(satellite)->port(), grouped_sinks.back(), 0);
+                single_sinks.push_back(gr::blocks::vector_sink_b::make(sizeof(Gnss_Synchro)));
+                top_block->connect(source, 0, single.at(satellite)->get_left_block(), 0);
+                top_block->connect(single.at(satellite)->get_right_block(), 0, single_sinks.back(), 0);
+            }
+        if (idle)
+            {
+                top_block->connect(source, 0, idle->get_left_block(), idle->port());
+                top_block->connect(idle->get_right_block(), idle->port(), gr::blocks::null_sink::make(sizeof(Gnss_Synchro)), 0);
+            }
+    }) << "Failure connecting the blocks of tracking group test." << std::endl;
+
+    for (unsigned int satellite = 0; satellite < 2; satellite++)
+        {
+            grouped.at(satellite)->start_tracking();
+            single.at(satellite)->start_tracking();
+        }
+
+    EXPECT_NO_THROW( {
+        top_block->run(); // Start threads and wait
+    }) << "Failure running the top_block." << std::endl;
+
+    for (unsigned int satellite = 0; satellite < 2; satellite++)
+        {
+            grouped_epochs.push_back(outputs(grouped_sinks.at(satellite)));
+            single_epochs.push_back(outputs(single_sinks.at(satellite)));
+        }
+}
+
+
+TEST_F(GpsL1CaDllPllTrackingGroupTest, PortsMatchSingleChannelBlocks)
+{
+    init(2, 2);
+    std::vector<std::vector<Gnss_Synchro> > grouped;
+    std::vector<std::vector<Gnss_Synchro> > single;
+    track(grouped, single);
+
+    // each port carries the epochs of its own channel, as a block per channel would
+    for (unsigned int satellite = 0; satellite < 2; satellite++)
+        {
+            const std::vector<Gnss_Synchro>& grouped_epochs = grouped.at(satellite);
+            const std::vector<Gnss_Synchro>& single_epochs = single.at(satellite);
+            // the blocks may stop a few code periods apart at the end of the samples
+            const unsigned int epochs = std::min(grouped_epochs.size(), single_epochs.size());
+            ASSERT_GT(epochs, 990u) << "satellite " << satellite;
+            EXPECT_LE(std::max(grouped_epochs.size(), single_epochs.size()) - epochs, 2u);
+            for (unsigned int epoch = 0; epoch < epochs; epoch++)
+                {
+                    const Gnss_Synchro& g = grouped_epochs.at(epoch);
+                    const Gnss_Synchro& s = single_epochs.at(epoch);
+                    ASSERT_EQ(s.PRN, g.PRN) << "satellite " << satellite << ", epoch " << epoch;
+                    ASSERT_EQ(s.Flag_valid_symbol_output, g.Flag_valid_symbol_output) << "satellite " << satellite << ", epoch " << epoch;
+                    ASSERT_EQ(s.Tracking_sample_counter, g.Tracking_sample_counter) << "satellite " << satellite << ", epoch " << epoch;
+                    ASSERT_EQ(s.Tracking_sample_fraction, g.Tracking_sample_fraction) << "satellite " << satellite << ", epoch " << epoch;
+                    ASSERT_EQ(s.Prompt_I, g.Prompt_I) << "satellite " << satellite << ", epoch " << epoch;
+                    ASSERT_EQ(s.Prompt_Q, g.Prompt_Q) << "satellite " << satellite << ", epoch " << epoch;
+                    ASSERT_EQ(s.CN0_dB_hz, g.CN0_dB_hz) << "satellite " << satellite << ", epoch " << epoch;
+                    ASSERT_EQ(s.Carrier_Doppler_hz, g.Carrier_Doppler_hz) << "satellite " << satellite << ", epoch " << epoch;
+                    ASSERT_EQ(s.Carrier_phase_rads, g.Carrier_phase_rads) << "satellite " << satellite << ", epoch " << epoch;
+                    ASSERT_EQ(s.Code_phase_secs, g.Code_phase_secs) << "satellite " << satellite << ", epoch " << epoch;
+                }
+            EXPECT_EQ(prn.at(satellite), grouped_epochs.at(epochs - 1).PRN);
+            EXPECT_NEAR(doppler_hz.at(satellite), grouped_epochs.at(epochs - 1).Carrier_Doppler_hz, 10.0) << "satellite " << satellite;
+            EXPECT_GT(grouped_epochs.at(epochs - 1).CN0_dB_hz, 45.0) << "satellite " << satellite;
+        }
+}
+
+
+TEST_F(GpsL1CaDllPllTrackingGroupTest, SharedCorrelatorMatchesSingleChannelBlocks)
+{
+    // with one thread both members share a correlator, with two each one has its own
+    for (unsigned int threads = 1; threads <= 2; threads++)
+        {
+            init(2, threads);
+            config->set_property("Tracking_1C.channel_group_shared_correlator", "true");
+            std::vector<std::vector<Gnss_Synchro> > grouped;
+            std::vector<std::vector<Gnss_Synchro> > single;
+            track(grouped, single);
+
+            // the shared correlator resamples the code in blocks, so the loops
+            // follow the same signal but are not bit exact
+            for (unsigned int satellite = 0; satellite < 2; satellite++)
+                {
+                    const std::vector<Gnss_Synchro>& grouped_epochs = grouped.at(satellite);
+                    const std::vector<Gnss_Synchro>& single_epochs = single.at(satellite);
+                    const unsigned int epochs = std::min(grouped_epochs.size(), single_epochs.size());
+                    ASSERT_GT(epochs, 990u) << "threads " << threads << ", satellite " << satellite;
+                    for (unsigned int epoch = 0; epoch < epochs; epoch++)
+                        {
+                            const Gnss_Synchro& g = grouped_epochs.at(epoch);
+                            const Gnss_Synchro& s = single_epochs.at(epoch);
+                            ASSERT_EQ(s.PRN, g.PRN) << "threads " << threads << ", satellite " << satellite << ", epoch " << epoch;
+                            ASSERT_EQ(s.Prompt_I > 0, g.Prompt_I > 0) << "threads " << threads << ", satellite " << satellite << ", epoch " << epoch;
+                            ASSERT_NEAR(s.Carrier_Doppler_hz, g.Carrier_Doppler_hz, 1.0) << "threads " << threads << ", satellite " << satellite << ", epoch " << epoch;
+                            ASSERT_NEAR(s.Tracking_timestamp_secs, g.Tracking_timestamp_secs, 1e-7) << "threads " << threads << ", satellite " << satellite << ", epoch " << epoch;
+                            ASSERT_NEAR(s.CN0_dB_hz, g.CN0_dB_hz, 1.0) << "threads " << threads << ", satellite " << satellite << ", epoch " << epoch;
+                        }
+                    EXPECT_NEAR(doppler_hz.at(satellite), grouped_epochs.at(epochs - 1).Carrier_Doppler_hz, 10.0) << "threads " << threads << ", satellite " << satellite;
+                }
+        }
+}
+
+
+TEST_F(GpsL1CaDllPllTrackingGroupTest, SharedLoopFiltersMatchSingleChannelBlocks)
+{
+    // the three members share the loop filters of the thread, and the idle one
+    // keeps its filter state while the others close their loops
+    init(3, 1);
+    config->set_property("Tracking_1C.channel_group_shared_correlator", "true");
+    std::vector<std::vector<Gnss_Synchro> > grouped;
+    std::vector<std::vector<Gnss_Synchro> > single;
+    track(grouped, single, true);
+
+    for (unsigned int satellite = 0; satellite < 2; satellite++)
+        {
+            const std::vector<Gnss_Synchro>& grouped_epochs = grouped.at(satellite);
+            const std::vector<Gnss_Synchro>& single_epochs = single.at(satellite);
+            const unsigned int epochs = std::min(grouped_epochs.size(), single_epochs.size());
+            ASSERT_GT(epochs, 990u) << "satellite " << satellite;
+            for (unsigned int epoch = 0; epoch < epochs; epoch++)
+                {
+                    const Gnss_Synchro& g = grouped_epochs.at(epoch);
+                    const Gnss_Synchro& s = single_epochs.at(epoch);
+                    ASSERT_EQ(s.PRN, g.PRN) << "satellite " << satellite << ", epoch " << epoch;
+                    ASSERT_EQ(s.Flag_valid_symbol_output, g.Flag_valid_symbol_output) << "satellite " << satellite << ", epoch " << epoch;
+                    ASSERT_EQ(s.Prompt_I > 0, g.Prompt_I > 0) << "satellite " << satellite << ", epoch " << epoch;
+                    ASSERT_NEAR(s.Carrier_Doppler_hz, g.Carrier_Doppler_hz, 1.0) << "satellite " << satellite << ", epoch " << epoch;
+                    ASSERT_NEAR(s.Carrier_phase_rads, g.Carrier_phase_rads, 0.1) << "satellite " << satellite << ", epoch " << epoch;
+                    ASSERT_NEAR(s.Tracking_timestamp_secs, g.Tracking_timestamp_secs, 1e-7) << "satellite " << satellite << ", epoch " << epoch;
+                    ASSERT_NEAR(s.CN0_dB_hz, g.CN0_dB_hz, 1.0) << "satellite " << satellite << ", epoch " << epoch;
+                }
+            EXPECT_NEAR(doppler_hz.at(satellite), grouped_epochs.at(epochs - 1).Carrier_Doppler_hz, 10.0) << "satellite " << satellite;
+            EXPECT_GT(grouped_epochs.at(epochs - 1).CN0_dB_hz, 45.0) << "satellite " << satellite;
+        }
+}
+
+
+TEST_F(GpsL1CaDllPllTrackingGroupTest, ChannelsRouteTheirMessages)
+{
+    init(2, 1);
+    config->set_property("Acquisition_1C.implementation", "GPS_L1_CA_PCPS_Acquisition");
+    config->set_property("Acquisition_1C.item_type", "gr_complex");
+    config->set_property("Acquisition_1C.if", "0");
+    config->set_property("Acquisition_1C.coherent_integration_time_ms", "1");
+    config->set_property("Acquisition_1C.dump", "false");
+    config->set_property("Acquisition_1C.threshold", "0.05");
+    config->set_property("Acquisition_1C.doppler_max", "5000");
+    config->set_property("Acquisition_1C.doppler_step", "250");
+    config->set_property("Acquisition_1C.repeat_satellite", "false");
+    config->set_property("TelemetryDecoder_1C.implementation", "GPS_L1_CA_Telemetry_Decoder");
+    config->set_property("TelemetryDecoder_1C.dump", "false");
+
+    // 20 ms hold a whole number of carrier cycles of both satellites, so they repeat seamlessly
+    std::vector<gr_complex> samples = generate_signal(fs_in / 50, 2.0);
+    gr::top_block_sptr top_block = gr::make_top_block("Tracking group channels test");
+    boost::shared_ptr<Control_Event_Bus> queue = Control_Event_Bus::make();
+
+    std::vector<std::shared_ptr<Channel> > channels;
+    for (unsigned int satellite = 0; satellite < 2; satellite++)
+        {
+            channels.push_back(std::make_shared<Channel>(config.get(), satellite,
+                    std::make_shared<GpsL1CaPcpsAcquisition>(config.get(), "Acquisition_1C", 1, 0),
+                    std::make_shared<GpsL1CaDllPllTracking>(config.get(), "Tracking_1C", 1, 1),
+                    std::make_shared<GpsL1CaTelemetryDecoder>(config.get(), "TelemetryDecoder_1C", 1, 1),
+                    "Channel", "1C", queue));
+        }
+    ASSERT_EQ(channels.at(0)->tracking()->get_left_block(), channels.at(1)->tracking()->get_left_block());
+    ASSERT_EQ(1, channels.at(1)->tracking()->port());
+
+    // a wrong stream or message port of the group makes these connections throw
+    ASSERT_NO_THROW( {
+        gr::blocks::vector_source_c::sptr source = gr::blocks::vector_source_c::make(samples, true);
+        for (unsigned int satellite = 0; satellite < 2; satellite++)
+            {
+                channels.at(satellite)->connect(top_block);
+                channels.at(satellite)->connect_input(top_block, source, 0);
+                top_block->connect(channels.at(satellite)->get_right_block(), 0, gr::blocks::null_sink::make(sizeof(Gnss_Synchro)), 0);
+            }
+    }) << "Failure connecting the channels of tracking group test." << std::endl;
+
+    top_block->start();
+    for (unsigned int satellite = 0; satellite < 2; satellite++)
+        {
+            channels.at(satellite)->set_signal(Gnss_Signal(Gnss_Satellite("GPS", prn.at(satellite)), "1C"));
+            channels.at(satellite)->start_acquisition();
+        }
+
+    // both channels acquire and start tracking in their ports of the group
+    std::vector<bool> tracking(2, false);
+    ControlMessage event;
+    while (!(tracking.at(0) and tracking.at(1)) and queue->wait_event(event, 10000))
+        {
+            ASSERT_LT(event.who, 2u);
+            ASSERT_EQ(Control_Event_Bus::acquisition_success, event.what) << "channel " << event.who;
+            tracking.at(event.who) = true;
+        }
+    EXPECT_TRUE(tracking.at(0));
+    EXPECT_TRUE(tracking.at(1));
+
+    // the stop request and the loss of lock go through the ports of channel 1 only
+    if (tracking.at(1))
+        {
+            EXPECT_TRUE(channels.at(1)->stop_tracking());
+            ASSERT_TRUE(queue->wait_event(event, 10000));
+            EXPECT_EQ(1u, event.who);
+            EXPECT_EQ(Control_Event_Bus::loss_of_lock, event.what);
+        }
+    EXPECT_FALSE(queue->wait_event(event, 500)) << "event " << event.what << " of channel " << event.who;
+
+    top_block->stop();
+    top_block->wait();
+}
@@ -268,3 +268,52 @@ TEST_F(GpsL1CaPcpsAcquisitionTest, ValidationOfResults)
     EXPECT_LT(delay_error_chips, 0.5) << "Delay error exceeds the expected value: 0.5 chips";
 
 }
+
+
+TEST_F(GpsL1CaPcpsAcquisitionTest, ValidationOfResultsNonCoherentDwells)
+{
+    top_block = gr::make_top_block("Acquisition test");
+
+    double expected_delay_samples = 524;
+    double expected_doppler_hz = 1680;
+    init();
+    config->set_property("Acquisition.max_dwells", "2");
+    config->set_property("Acquisition.dwell_accumulation", "noncoherent");
+    std::shared_ptr<GpsL1CaPcpsAcquisition> acquisition = std::make_shared<GpsL1CaPcpsAcquisition>(config.get(), "Acquisition", 1, 1);
+
+    boost::shared_ptr<GpsL1CaPcpsAcquisitionTest_msg_rx> msg_rx = GpsL1CaPcpsAcquisitionTest_msg_rx_make();
+
+    ASSERT_NO_THROW( {
+        acquisition->set_channel(1);
+        acquisition->set_gnss_synchro(&gnss_synchro);
+        acquisition->set_threshold(0.1);
+        acquisition->set_doppler_max(10000);
+        acquisition->set_doppler_step(250);
+        acquisition->connect(top_block);
+    }) << "Failure configuring the acquisition." << std::endl;
+
+    ASSERT_NO_THROW( {
+        std::string path = std::string(TEST_PATH);
+        std::string file = path + "signal_samples/GPS_L1_CA_ID_1_Fs_4Msps_2ms.dat";
+        const char * file_name = file.c_str();
+        gr::blocks::file_source::sptr file_source = gr::blocks::file_source::make(sizeof(gr_complex), file_name, false);
+        top_block->connect(file_source, 0, acquisition->get_left_block(), 0);
+        top_block->msg_connect(acquisition->get_right_block(), pmt::mp("events"), msg_rx, pmt::mp("events"));
+    }) << "Failure connecting the blocks of acquisition test." << std::endl;
+
+    acquisition->set_state(1); // Ensure that acquisition starts at the first sample
+    acquisition->init();
+
+    EXPECT_NO_THROW( {
+        top_block->run(); // Start threads and wait
+    }) << "Failure running the top_block." << std::endl;
+
+    ASSERT_EQ(1, msg_rx->rx_message) << "Acquisition failure. Expected message: 1=ACQ SUCCESS.";
+
+    double delay_error_samples = std::abs(expected_delay_samples - gnss_synchro.Acq_delay_samples);
+    float delay_error_chips = (float)(delay_error_samples * 1023 / 4000);
+    double doppler_error_hz = std::abs(expected_doppler_hz - gnss_synchro.Acq_doppler_hz);
+
+    EXPECT_LE(doppler_error_hz, 666) << "Doppler error exceeds the expected value: 666 Hz = 2/(3*integration period)";
+    EXPECT_LT(delay_error_chips, 0.5) << "Delay error exceeds the expected value: 0.5 chips";
+}
@@ -0,0 +1,223 @@
+/*!
+ * \file gps_l1_ca_pcps_fixed_point_acquisition_test.cc
+ * \brief Tests of GpsL1CaPcpsFixedPointAcquisition with 16-bit samples
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/make_shared.hpp>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/file_source.h>
+#include <gtest/gtest.h>
+#include "gnss_synchro.h"
+#include "gps_l1_ca_pcps_fixed_point_acquisition.h"
+#include "in_memory_configuration.h"
+
+
+// ######## GNURADIO BLOCK MESSAGE RECEVER #########
+class GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx;
+
+typedef boost::shared_ptr<GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx> GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx_sptr;
+
+GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx_sptr GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx_make();
+
+class GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx : public gr::block
+{
+private:
+    friend GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx_sptr GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx_make();
+    void msg_handler_events(pmt::pmt_t msg);
+    GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx();
+public:
+    int rx_message;
+    ~GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx(); //!< Default destructor
+};
+
+
+GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx_sptr GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx_make()
+{
+    return GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx_sptr(new GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx());
+}
+
+
+void GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx::msg_handler_events(pmt::pmt_t msg)
+{
+    try
+    {
+            long int message = pmt::to_long(msg);
+            rx_message = message;
+    }
+    catch(boost::bad_any_cast& e)
+    {
+            LOG(WARNING) << "msg_handler_telemetry Bad any cast!";
+            rx_message = 0;
+    }
+}
+
+
+GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx::GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx() :
+    gr::block("GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx", gr::io_signature::make(0, 0, 0), gr::io_signature::make(0, 0, 0))
+{
+    this->message_port_register_in(pmt::mp("events"));
+    this->set_msg_handler(pmt::mp("events"), boost::bind(&GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx::msg_handler_events, this, _1));
+    rx_message = 0;
+}
+
+
+GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx::~GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx()
+{}
+
+
+// ###########################################################
+
+class GpsL1CaPcpsFixedPointAcquisitionTest: public ::testing::Test
+{
+protected:
+    GpsL1CaPcpsFixedPointAcquisitionTest()
+    {
+        config = std::make_shared<InMemoryConfiguration>();
+        gnss_synchro = Gnss_Synchro();
+    }
+
+    ~GpsL1CaPcpsFixedPointAcquisitionTest()
+    {}
+
+    void init(unsigned int fs_hz);
+
+    //! Writes the gr_complex capture as 16-bit samples, scaled to use 12 bits
+    std::string write_cshort_capture(const std::string& capture);
+
+    gr::top_block_sptr top_block;
+    std::shared_ptr<InMemoryConfiguration> config;
+    Gnss_Synchro gnss_synchro;
+};
+
+
+void GpsL1CaPcpsFixedPointAcquisitionTest::init(unsigned int fs_hz)
+{
+    gnss_synchro.Channel_ID = 0;
+    gnss_synchro.System = 'G';
+    std::string signal = "1C";
+    signal.copy(gnss_synchro.Signal, 2, 0);
+    gnss_synchro.PRN = 1;
+    config->set_property("GNSS-SDR.internal_fs_hz", std::to_string(fs_hz));
+    config->set_property("Acquisition.item_type", "cshort");
+    config->set_property("Acquisition.if", "0");
+    config->set_property("Acquisition.coherent_integration_time_ms", "1");
+    config->set_property("Acquisition.dump", "false");
+    config->set_property("Acquisition.implementation", "GPS_L1_CA_PCPS_Fixed_Point_Acquisition");
+    config->set_property("Acquisition.max_dwells", "1");
+}
+
+
+std::string GpsL1CaPcpsFixedPointAcquisitionTest::write_cshort_capture(const std::string& capture)
+{
+    std::ifstream in(capture.c_str(), std::ios::binary);
+    std::vector<gr_complex> samples;
+    gr_complex sample;
+    while (in.read(reinterpret_cast<char*>(&sample), sizeof(gr_complex)))
+        {
+            samples.push_back(sample);
+        }
+    float max_component = 0.0;
+    for (unsigned int i = 0; i < samples.size(); i++)
+        {
+            max_component = std::max(max_component, std::max(std::abs(samples[i].real()), std::abs(samples[i].imag())));
+        }
+    const float scale = max_component > 0.0 ? 2047.0 / max_component : 0.0;
+    const std::string filename = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    std::ofstream out(filename.c_str(), std::ios::binary);
+    for (unsigned int i = 0; i < samples.size(); i++)
+        {
+            lv_16sc_t converted(static_cast<int16_t>(std::lround(samples[i].real() * scale)),
+                    static_cast<int16_t>(std::lround(samples[i].imag() * scale)));
+            out.write(reinterpret_cast<const char*>(&converted), sizeof(lv_16sc_t));
+        }
+    return filename;
+}
+
+
+TEST_F(GpsL1CaPcpsFixedPointAcquisitionTest, FftIsPaddedToAPowerOfTwo)
+{
+    // 4 Msps gives 4000 samples per code period, which the radix-2 FFT
+    // cannot transform directly
+    pcps_fixed_point_acquisition_sc_sptr block = pcps_make_fixed_point_acquisition_sc(1, 1, 5000, 0, 4000000, 4000, 4000, false, "");
+    EXPECT_EQ(8192u, block->fft_size());
+
+    block = pcps_make_fixed_point_acquisition_sc(1, 1, 5000, 0, 4096000, 4096, 4096, false, "");
+    EXPECT_EQ(4096u, block->fft_size());
+}
+
+
+TEST_F(GpsL1CaPcpsFixedPointAcquisitionTest, ValidationOfResultsWithPaddedFft)
+{
+    top_block = gr::make_top_block("Acquisition test");
+
+    double expected_delay_samples = 524;
+    double expected_doppler_hz = 1680;
+    init(4000000);
+    std::shared_ptr<GpsL1CaPcpsFixedPointAcquisition> acquisition = std::make_shared<GpsL1CaPcpsFixedPointAcquisition>(config.get(), "Acquisition", 1, 1);
+    boost::shared_ptr<GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx> msg_rx = GpsL1CaPcpsFixedPointAcquisitionTest_msg_rx_make();
+
+    ASSERT_NO_THROW( {
+        acquisition->set_channel(1);
+        acquisition->set_gnss_synchro(&gnss_synchro);
+        acquisition->set_threshold(0.1);
+        acquisition->set_doppler_max(10000);
+        acquisition->set_doppler_step(250);
+        acquisition->connect(top_block);
+    }) << "Failure configuring the acquisition." << std::endl;
+
+    std::string file = write_cshort_capture(std::string(TEST_PATH) + "signal_samples/GPS_L1_CA_ID_1_Fs_4Msps_2ms.dat");
+    ASSERT_NO_THROW( {
+        gr::blocks::file_source::sptr file_source = gr::blocks::file_source::make(sizeof(lv_16sc_t), file.c_str(), false);
+        top_block->connect(file_source, 0, acquisition->get_left_block(), 0);
+        top_block->msg_connect(acquisition->get_right_block(), pmt::mp("events"), msg_rx, pmt::mp("events"));
+    }) << "Failure connecting the blocks of acquisition test." << std::endl;
+
+    acquisition->set_state(1); // Ensure that acquisition starts at the first sample
+    acquisition->init();
+
+    EXPECT_NO_THROW( {
+        top_block->run(); // Start threads and wait
+    }) << "Failure running the top_block." << std::endl;
+    boost::filesystem::remove(file);
+
+    ASSERT_EQ(1, msg_rx->rx_message) << "Acquisition failure. Expected message: 1=ACQ SUCCESS.";
+
+    double delay_error_samples = std::abs(expected_delay_samples - gnss_synchro.Acq_delay_samples);
+    float delay_error_chips = static_cast<float>(delay_error_samples * 1023 / 4000);
+    double doppler_error_hz = std::abs(expected_doppler_hz - gnss_synchro.Acq_doppler_hz);
+
+    EXPECT_LE(doppler_error_hz, 666) << "Doppler error exceeds the expected value: 666 Hz = 2/(3*integration period)";
+    EXPECT_LT(delay_error_chips, 0.5) << "Delay error exceeds the expected value: 0.5 chips";
+}
@@ -0,0 +1,293 @@
+/*!
+ * \file gps_l1_ca_pcps_shifted_spectrum_acquisition_test.cc
+ * \brief Tests of GpsL1CaPcpsShiftedSpectrumAcquisition, with a capture and
+ * with generated signals of known Doppler and code phase
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <vector>
+#include <boost/make_shared.hpp>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/file_source.h>
+#include <gnuradio/blocks/vector_source_c.h>
+#include <gtest/gtest.h>
+#include "gnss_synchro.h"
+#include "gps_l1_ca_pcps_shifted_spectrum_acquisition.h"
+#include "gps_sdr_signal_processing.h"
+#include "in_memory_configuration.h"
+#include "input_spectrum_store.h"
+#include "GPS_L1_CA.h"
+
+
+// ######## GNURADIO BLOCK MESSAGE RECEVER #########
+class GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx;
+
+typedef boost::shared_ptr<GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx> GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx_sptr;
+
+GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx_sptr GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx_make();
+
+class GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx : public gr::block
+{
+private:
+    friend GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx_sptr GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx_make();
+    void msg_handler_events(pmt::pmt_t msg);
+    GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx();
+public:
+    int rx_message;
+    ~GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx(); //!< Default destructor
+};
+
+
+GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx_sptr GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx_make()
+{
+    return GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx_sptr(new GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx());
+}
+
+
+void GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx::msg_handler_events(pmt::pmt_t msg)
+{
+    try
+    {
+            long int message = pmt::to_long(msg);
+            rx_message = message;
+    }
+    catch(boost::bad_any_cast& e)
+    {
+            LOG(WARNING) << "msg_handler_telemetry Bad any cast!";
+            rx_message = 0;
+    }
+}
+
+
+GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx::GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx() :
+    gr::block("GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx", gr::io_signature::make(0, 0, 0), gr::io_signature::make(0, 0, 0))
+{
+    this->message_port_register_in(pmt::mp("events"));
+    this->set_msg_handler(pmt::mp("events"), boost::bind(&GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx::msg_handler_events, this, _1));
+    rx_message = 0;
+}
+
+
+GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx::~GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx()
+{}
+
+
+// ###########################################################
+
+class GpsL1CaPcpsShiftedSpectrumAcquisitionTest: public ::testing::Test
+{
+protected:
+    GpsL1CaPcpsShiftedSpectrumAcquisitionTest()
+    {
+        config = std::make_shared<InMemoryConfiguration>();
+        fs_in = 4000000;
+    }
+
+    ~GpsL1CaPcpsShiftedSpectrumAcquisitionTest()
+    {}
+
+    void init(Gnss_Synchro& gnss_synchro, unsigned int rf_channel_offset, bool share_input_spectrum);
+
+    //! Two code periods of PRN 1 delayed by delay_samples, on a carrier of doppler_hz
+    std::vector<gr_complex> generate_signal(double doppler_hz, unsigned int delay_samples);
+
+    //! Acquires PRN 1 in the given samples
+    void acquire(const std::vector<gr_complex>& samples, Gnss_Synchro& gnss_synchro, int& message);
+
+    gr::top_block_sptr top_block;
+    std::shared_ptr<InMemoryConfiguration> config;
+    int fs_in;
+};
+
+
+void GpsL1CaPcpsShiftedSpectrumAcquisitionTest::init(Gnss_Synchro& gnss_synchro, unsigned int rf_channel_offset, bool share_input_spectrum)
+{
+    gnss_synchro = Gnss_Synchro();
+    gnss_synchro.Channel_ID = 0;
+    gnss_synchro.System = 'G';
+    std::string signal = "1C";
+    signal.copy(gnss_synchro.Signal, 2, 0);
+    gnss_synchro.PRN = 1;
+    config->set_property("GNSS-SDR.internal_fs_hz", std::to_string(fs_in));
+    // The shared input spectra are keyed by the index of the input window,
+    // which restarts with each flowgraph, so each test uses its own RF channel
+    config->set_property("GNSS-SDR.rf_channel_offset", std::to_string(rf_channel_offset));
+    config->set_property("Acquisition.item_type", "gr_complex");
+    config->set_property("Acquisition.if", "0");
+    config->set_property("Acquisition.coherent_integration_time_ms", "1");
+    config->set_property("Acquisition.dump", "false");
+    config->set_property("Acquisition.implementation", "GPS_L1_CA_PCPS_Shifted_Spectrum_Acquisition");
+    config->set_property("Acquisition.max_dwells", "1");
+    config->set_property("Acquisition.share_input_spectrum", share_input_spectrum ? "true" : "false");
+}
+
+
+std::vector<gr_complex> GpsL1CaPcpsShiftedSpectrumAcquisitionTest::generate_signal(double doppler_hz, unsigned int delay_samples)
+{
+    const unsigned int code_length = fs_in / 1000;
+    std::vector<gr_complex> code(code_length);
+    gps_l1_ca_code_gen_complex_sampled(code.data(), 1, fs_in, 0);
+    std::vector<gr_complex> samples(2 * code_length);
+    for (unsigned int n = 0; n < samples.size(); n++)
+        {
+            const double phase = GPS_TWO_PI * doppler_hz * static_cast<double>(n) / static_cast<double>(fs_in);
+            samples[n] = code[(n + code_length - delay_samples) % code_length]
+                    * gr_complex(static_cast<float>(cos(phase)), static_cast<float>(sin(phase)));
+        }
+    return samples;
+}
+
+
+void GpsL1CaPcpsShiftedSpectrumAcquisitionTest::acquire(const std::vector<gr_complex>& samples, Gnss_Synchro& gnss_synchro, int& message)
+{
+    top_block = gr::make_top_block("Acquisition test");
+    std::shared_ptr<GpsL1CaPcpsShiftedSpectrumAcquisition> acquisition = std::make_shared<GpsL1CaPcpsShiftedSpectrumAcquisition>(config.get(), "Acquisition", 1, 1);
+    boost::shared_ptr<GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx> msg_rx = GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx_make();
+
+    ASSERT_NO_THROW( {
+        acquisition->set_channel(0);
+        acquisition->set_gnss_synchro(&gnss_synchro);
+        acquisition->set_threshold(0.1);
+        acquisition->set_doppler_max(10000);
+        acquisition->set_doppler_step(250);
+        acquisition->connect(top_block);
+        gr::blocks::vector_source_c::sptr source = gr::blocks::vector_source_c::make(samples, false);
+        top_block->connect(source, 0, acquisition->get_left_block(), 0);
+        top_block->msg_connect(acquisition->get_right_block(), pmt::mp("events"), msg_rx, pmt::mp("events"));
+    }) << "Failure connecting the blocks of acquisition test." << std::endl;
+
+    acquisition->set_state(1); // Ensure that acquisition starts at the first sample
+    acquisition->init();
+
+    EXPECT_NO_THROW( {
+        top_block->run(); // Start threads and wait
+    }) << "Failure running the top_block." << std::endl;
+    message = msg_rx->rx_message;
+}
+
+
+TEST_F(GpsL1CaPcpsShiftedSpectrumAcquisitionTest, Instantiate)
+{
+    Gnss_Synchro gnss_synchro;
+    init(gnss_synchro, 40, false);
+    std::shared_ptr<GpsL1CaPcpsShiftedSpectrumAcquisition> acquisition = std::make_shared<GpsL1CaPcpsShiftedSpectrumAcquisition>(config.get(), "Acquisition", 1, 1);
+    EXPECT_EQ("GPS_L1_CA_PCPS_Shifted_Spectrum_Acquisition", acquisition->implementation());
+}
+
+
+TEST_F(GpsL1CaPcpsShiftedSpectrumAcquisitionTest, ValidationOfResults)
+{
+    double expected_delay_samples = 524;
+    double expected_doppler_hz = 1680;
+    Gnss_Synchro gnss_synchro;
+    init(gnss_synchro, 41, false);
+    top_block = gr::make_top_block("Acquisition test");
+    std::shared_ptr<GpsL1CaPcpsShiftedSpectrumAcquisition> acquisition = std::make_shared<GpsL1CaPcpsShiftedSpectrumAcquisition>(config.get(), "Acquisition", 1, 1);
+    boost::shared_ptr<GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx> msg_rx = GpsL1CaPcpsShiftedSpectrumAcquisitionTest_msg_rx_make();
+
+    ASSERT_NO_THROW( {
+        acquisition->set_channel(1);
+        acquisition->set_gnss_synchro(&gnss_synchro);
+        acquisition->set_threshold(0.1);
+        acquisition->set_doppler_max(10000);
+        acquisition->set_doppler_step(250);
+        acquisition->connect(top_block);
+    }) << "Failure configuring the acquisition." << std::endl;
+
+    ASSERT_NO_THROW( {
+        std::string path = std::string(TEST_PATH);
+        std::string file = path + "signal_samples/GPS_L1_CA_ID_1_Fs_4Msps_2ms.dat";
+        const char * file_name = file.c_str();
+        gr::blocks::file_source::sptr file_source = gr::blocks::file_source::make(sizeof(gr_complex), file_name, false);
+        top_block->connect(file_source, 0, acquisition->get_left_block(), 0);
+        top_block->msg_connect(acquisition->get_right_block(), pmt::mp("events"), msg_rx, pmt::mp("events"));
+    }) << "Failure connecting the blocks of acquisition test." << std::endl;
+
+    acquisition->set_state(1); // Ensure that acquisition starts at the first sample
+    acquisition->init();
+
+    EXPECT_NO_THROW( {
+        top_block->run(); // Start threads and wait
+    }) << "Failure running the top_block." << std::endl;
+
+    ASSERT_EQ(1, msg_rx->rx_message) << "Acquisition failure. Expected message: 1=ACQ SUCCESS.";
+
+    double delay_error_samples = std::abs(expected_delay_samples - gnss_synchro.Acq_delay_samples);
+    float delay_error_chips = static_cast<float>(delay_error_samples * 1023 / 4000);
+    double doppler_error_hz = std::abs(expected_doppler_hz - gnss_synchro.Acq_doppler_hz);
+
+    EXPECT_LE(doppler_error_hz, 666) << "Doppler error exceeds the expected value: 666 Hz = 2/(3*integration period)";
+    EXPECT_LT(delay_error_chips, 0.5) << "Delay error exceeds the expected value: 0.5 chips";
+}
+
+
+TEST_F(GpsL1CaPcpsShiftedSpectrumAcquisitionTest, KnownDopplerAndCodePhase)
+{
+    // With 4000-sample FFTs the bins are 1 kHz wide, and a 250 Hz step needs
+    // four residual offsets: 3250 Hz is three bins and one residual, -4750 Hz
+    // wraps to minus five bins and one residual
+    const double doppler_hz[] = {3250.0, -4750.0, 0.0, 9750.0};
+    const unsigned int delay_samples[] = {1234, 3210, 0, 3999};
+    for (unsigned int i = 0; i < 4; i++)
+        {
+            Gnss_Synchro gnss_synchro;
+            int message = 0;
+            init(gnss_synchro, 42, false);
+            acquire(generate_signal(doppler_hz[i], delay_samples[i]), gnss_synchro, message);
+            ASSERT_EQ(1, message) << "Acquisition failure at " << doppler_hz[i] << " Hz.";
+            EXPECT_EQ(static_cast<double>(delay_samples[i]), gnss_synchro.Acq_delay_samples) << doppler_hz[i] << " Hz";
+            EXPECT_EQ(doppler_hz[i], gnss_synchro.Acq_doppler_hz);
+        }
+}
+
+
+TEST_F(GpsL1CaPcpsShiftedSpectrumAcquisitionTest, SharedInputSpectrum)
+{
+    // two channels on the same signal conditioner: the second one reuses the
+    // spectra of the first and obtains the same result
+    std::vector<gr_complex> samples = generate_signal(-2250.0, 2718);
+    Gnss_Synchro first;
+    Gnss_Synchro second;
+    int first_message = 0;
+    int second_message = 0;
+    init(first, 43, true);
+    acquire(samples, first, first_message);
+    unsigned long int hits = Input_Spectrum_Store::instance().hits();
+    init(second, 43, true);
+    acquire(samples, second, second_message);
+    EXPECT_GT(Input_Spectrum_Store::instance().hits(), hits);
+
+    ASSERT_EQ(1, first_message);
+    ASSERT_EQ(1, second_message);
+    EXPECT_EQ(2718.0, first.Acq_delay_samples);
+    EXPECT_EQ(-2250.0, first.Acq_doppler_hz);
+    EXPECT_EQ(first.Acq_delay_samples, second.Acq_delay_samples);
+    EXPECT_EQ(first.Acq_doppler_hz, second.Acq_doppler_hz);
+}
@@ -0,0 +1,194 @@
+/*!
+ * \file gps_l2_m_pcps_segmented_acquisition_test.cc
+ * \brief  Tests the GpsL2MPcpsSegmentedAcquisition class on the GPS L2 CM
+ *  capture of gps_l2_m_pcps_acquisition_test.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstring>
+#include <iostream>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/file_source.h>
+#include <gnuradio/msg_queue.h>
+#include <gtest/gtest.h>
+#include "in_memory_configuration.h"
+#include "gnss_sdr_valve.h"
+#include "gnss_synchro.h"
+#include "gps_l2_m_pcps_segmented_acquisition.h"
+#include "GPS_L2C.h"
+
+
+// ######## GNURADIO BLOCK MESSAGE RECEVER #########
+class GpsL2MPcpsSegmentedAcquisitionTest_msg_rx;
+
+typedef boost::shared_ptr<GpsL2MPcpsSegmentedAcquisitionTest_msg_rx> GpsL2MPcpsSegmentedAcquisitionTest_msg_rx_sptr;
+
+GpsL2MPcpsSegmentedAcquisitionTest_msg_rx_sptr GpsL2MPcpsSegmentedAcquisitionTest_msg_rx_make();
+
+class GpsL2MPcpsSegmentedAcquisitionTest_msg_rx : public gr::block
+{
+private:
+    friend GpsL2MPcpsSegmentedAcquisitionTest_msg_rx_sptr GpsL2MPcpsSegmentedAcquisitionTest_msg_rx_make();
+    void msg_handler_events(pmt::pmt_t msg);
+    GpsL2MPcpsSegmentedAcquisitionTest_msg_rx();
+
+public:
+    int rx_message;
+    ~GpsL2MPcpsSegmentedAcquisitionTest_msg_rx(); //!< Default destructor
+};
+
+GpsL2MPcpsSegmentedAcquisitionTest_msg_rx_sptr GpsL2MPcpsSegmentedAcquisitionTest_msg_rx_make()
+{
+    return GpsL2MPcpsSegmentedAcquisitionTest_msg_rx_sptr(new GpsL2MPcpsSegmentedAcquisitionTest_msg_rx());
+}
+
+void GpsL2MPcpsSegmentedAcquisitionTest_msg_rx::msg_handler_events(pmt::pmt_t msg)
+{
+    try
+    {
+            long int message = pmt::to_long(msg);
+            rx_message = message;
+    }
+    catch(boost::bad_any_cast& e)
+    {
+            LOG(WARNING) << "msg_handler_telemetry Bad any cast!";
+            rx_message = 0;
+    }
+}
+
+GpsL2MPcpsSegmentedAcquisitionTest_msg_rx::GpsL2MPcpsSegmentedAcquisitionTest_msg_rx() :
+            gr::block("GpsL2MPcpsSegmentedAcquisitionTest_msg_rx", gr::io_signature::make(0, 0, 0), gr::io_signature::make(0, 0, 0))
+{
+    this->message_port_register_in(pmt::mp("events"));
+    this->set_msg_handler(pmt::mp("events"), boost::bind(&GpsL2MPcpsSegmentedAcquisitionTest_msg_rx::msg_handler_events, this, _1));
+    rx_message = 0;
+}
+
+GpsL2MPcpsSegmentedAcquisitionTest_msg_rx::~GpsL2MPcpsSegmentedAcquisitionTest_msg_rx()
+{}
+
+
+// ###########################################################
+
+class GpsL2MPcpsSegmentedAcquisitionTest: public ::testing::Test
+{
+protected:
+    GpsL2MPcpsSegmentedAcquisitionTest()
+    {
+        config = std::make_shared<InMemoryConfiguration>();
+        sampling_freqeuncy_hz = 0;
+        nsamples = 0;
+        gnss_synchro = Gnss_Synchro();
+    }
+
+    ~GpsL2MPcpsSegmentedAcquisitionTest()
+    {}
+
+    void init();
+
+    gr::msg_queue::sptr queue;
+    gr::top_block_sptr top_block;
+    std::shared_ptr<InMemoryConfiguration> config;
+    Gnss_Synchro gnss_synchro;
+    int sampling_freqeuncy_hz;
+    int nsamples;
+};
+
+
+void GpsL2MPcpsSegmentedAcquisitionTest::init()
+{
+    gnss_synchro.Channel_ID = 0;
+    gnss_synchro.System = 'G';
+    std::memcpy(gnss_synchro.Signal, "2S", 3);
+    gnss_synchro.PRN = 7;
+
+    sampling_freqeuncy_hz  = 5000000;
+    nsamples = round((double)sampling_freqeuncy_hz*GPS_L2_M_PERIOD)*2;
+    config->set_property("GNSS-SDR.internal_fs_hz", std::to_string(sampling_freqeuncy_hz));
+    config->set_property("Acquisition.item_type", "gr_complex");
+    config->set_property("Acquisition.if", "0");
+    config->set_property("Acquisition.dump", "false");
+    config->set_property("Acquisition.implementation", "GPS_L2_M_PCPS_Segmented_Acquisition");
+    config->set_property("Acquisition.segments", "5");
+    config->set_property("Acquisition.doppler_max", "5000");
+}
+
+
+TEST_F(GpsL2MPcpsSegmentedAcquisitionTest, Instantiate)
+{
+    init();
+    std::shared_ptr<GpsL2MPcpsSegmentedAcquisition> acquisition = std::make_shared<GpsL2MPcpsSegmentedAcquisition>(config.get(), "Acquisition", 1, 1);
+    EXPECT_STREQ("GPS_L2_M_PCPS_Segmented_Acquisition", acquisition->implementation().c_str());
+}
+
+
+TEST_F(GpsL2MPcpsSegmentedAcquisitionTest, ValidationOfResults)
+{
+    top_block = gr::make_top_block("Acquisition test");
+    queue = gr::msg_queue::make(0);
+    double expected_delay_samples = 1;
+    double expected_doppler_hz = 1200;
+    init();
+    std::shared_ptr<GpsL2MPcpsSegmentedAcquisition> acquisition = std::make_shared<GpsL2MPcpsSegmentedAcquisition>(config.get(), "Acquisition", 1, 1);
+    boost::shared_ptr<GpsL2MPcpsSegmentedAcquisitionTest_msg_rx> msg_rx = GpsL2MPcpsSegmentedAcquisitionTest_msg_rx_make();
+
+    ASSERT_NO_THROW( {
+        acquisition->set_channel(1);
+        acquisition->set_gnss_synchro(&gnss_synchro);
+        acquisition->set_threshold(0.001);
+        acquisition->set_doppler_max(5000);
+        acquisition->set_doppler_step(100);
+        acquisition->connect(top_block);
+    }) << "Failure setting up the acquisition." << std::endl;
+
+    ASSERT_NO_THROW( {
+        std::string file = std::string(TEST_PATH) + "/data/gps_l2c_m_prn7_5msps.dat";
+        gr::blocks::file_source::sptr file_source = gr::blocks::file_source::make(sizeof(gr_complex), file.c_str(), false);
+        boost::shared_ptr<gr::block> valve = gnss_sdr_make_valve(sizeof(gr_complex), nsamples, queue);
+        top_block->connect(file_source, 0, valve , 0);
+        top_block->connect(valve, 0, acquisition->get_left_block(), 0);
+        top_block->msg_connect(acquisition->get_right_block(), pmt::mp("events"), msg_rx, pmt::mp("events"));
+    }) << "Failure connecting the blocks of acquisition test." << std::endl;
+
+    ASSERT_NO_THROW( {
+        acquisition->set_state(1); // Ensure that acquisition starts at the first sample
+        acquisition->init();
+    }) << "Failure set_state and init acquisition test" << std::endl;
+
+    EXPECT_NO_THROW( {
+        top_block->run(); // Start threads and wait
+    }) << "Failure running the top_block." << std::endl;
+
+    std::cout <<  "gnss_synchro.Acq_doppler_hz = " << gnss_synchro.Acq_doppler_hz << " Hz" << std::endl;
+    std::cout <<  "gnss_synchro.Acq_delay_samples = " << gnss_synchro.Acq_delay_samples << " Samples" << std::endl;
+
+    ASSERT_EQ(1, msg_rx->rx_message) << "Acquisition failure. Expected message: 1=ACQ SUCCESS.";
+
+    // The same code phase and Doppler shift as the full 20 ms search
+    EXPECT_LE(std::abs(expected_doppler_hz - gnss_synchro.Acq_doppler_hz), 200);
+    EXPECT_LE(std::abs(expected_delay_samples - gnss_synchro.Acq_delay_samples), 2);
+}
@@ -28,7 +28,9 @@
  * -------------------------------------------------------------------------
  */
 
-//#include <fstream>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
 //#include <map>
 #include <string>
 //#include <boost/archive/xml_iarchive.hpp>
@@ -98,3 +100,33 @@ TEST(Rtcm_Printer_Test, Run)
 
 
 
+
+
+TEST(Rtcm_Printer_Test, EphemerisMessagesOnlyEncodedOnChange)
+{
+    std::string filename = "test_ephemeris";
+    std::unique_ptr<Rtcm_Printer> RTCM_printer(new Rtcm_Printer(filename, false, false, 2101, 1234, "/dev/pts/4", false));
+    Rtcm rtcm;
+
+    Gps_Ephemeris gps_eph = Gps_Ephemeris();
+    gps_eph.i_satellite_PRN = 3;
+    gps_eph.d_IODE_SF2 = 10;
+    gps_eph.d_IODC = 10;
+    gps_eph.d_Toe = 7200;
+    const std::string first = rtcm.print_MT1019(gps_eph);
+    RTCM_printer->Print_Rtcm_MT1019(gps_eph);
+    RTCM_printer->Print_Rtcm_MT1019(gps_eph);
+
+    // a new issue of data is encoded again
+    gps_eph.d_IODE_SF2 = 11;
+    gps_eph.d_Toe = 14400;
+    const std::string second = rtcm.print_MT1019(gps_eph);
+    EXPECT_NE(first, second);
+    RTCM_printer->Print_Rtcm_MT1019(gps_eph);
+    RTCM_printer.reset();
+
+    std::ifstream file(filename + ".rtcm", std::ios::binary);
+    std::string written((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(first + "\n" + first + "\n" + second + "\n", written);
+    std::remove((filename + ".rtcm").c_str());
+}
@@ -0,0 +1,352 @@
+/*!
+ * \file tracking_benchmark_test.cc
+ * \brief  Measures the time per epoch of every tracking implementation, by
+ *  phase of the epoch, over a sweep of sampling frequencies.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The benchmark is built as its own target (trk_benchmark) and is not part
+ * of the regular test suite. Each tracking block runs alone, fed by the
+ * signal generator with one satellite at the Doppler and code phase given to
+ * the block as acquisition results, and its time is read from the tracking
+ * profiler. The number of correlators is fixed by each implementation, and
+ * is reported with it. GPS L2CM is not produced by the generator, so it is
+ * tracked on the 5 Msps recording in the data folder, whatever the sweep.
+ * An implementation can be given with its item type, as in
+ * GPS_L1_CA_DLL_PLL_C_Aid_Tracking:cshort. Example:
+ *
+ *   ./trk_benchmark --trk_benchmark_fs=4000000,8000000 --trk_benchmark_seconds=5
+ *                   --trk_benchmark_report=./trk_benchmark.csv
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/complex_to_interleaved_short.h>
+#include <gnuradio/blocks/file_source.h>
+#include <gnuradio/blocks/multiply_const_cc.h>
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/msg_queue.h>
+#include <gtest/gtest.h>
+#include "gnss_block_factory.h"
+#include "gnss_sdr_tracking_profiler.h"
+#include "gnss_sdr_valve.h"
+#include "gnss_synchro.h"
+#include "in_memory_configuration.h"
+#include "interleaved_short_to_complex_short.h"
+#include "signal_generator.h"
+#include "tracking_interface.h"
+
+
+#if CUDA_BLOCKS_TEST
+#define TRK_BENCHMARK_GPU_IMPLEMENTATION ",GPS_L1_CA_DLL_PLL_Tracking_GPU"
+#else
+#define TRK_BENCHMARK_GPU_IMPLEMENTATION ""
+#endif
+
+DEFINE_string(trk_benchmark_implementations, "GPS_L1_CA_DLL_PLL_Tracking,GPS_L1_CA_DLL_PLL_C_Aid_Tracking,"
+        "GPS_L1_CA_DLL_PLL_C_Aid_Tracking:cshort,Galileo_E1_DLL_PLL_VEML_Tracking,Galileo_E5a_DLL_PLL_Tracking,"
+        "GPS_L2_M_DLL_PLL_Tracking" TRK_BENCHMARK_GPU_IMPLEMENTATION,
+        "Comma-separated list of tracking implementations to benchmark, with an optional :item_type");
+DEFINE_string(trk_benchmark_fs, "4000000,8000000,25000000", "Comma-separated list of sampling frequencies [Hz]");
+DEFINE_double(trk_benchmark_seconds, 2.0, "Seconds of signal tracked per configuration");
+DEFINE_string(trk_benchmark_report, "", "If not empty, CSV file where the results are written");
+
+
+/*!
+ * \brief Signal tracked by an implementation
+ */
+struct Tracking_Benchmark_Signal
+{
+    char system;
+    std::string signal;            // of the signal generator
+    std::string tracked_signal;    // of the Gnss_Synchro given to the block
+    unsigned int prn;
+    unsigned int correlators;
+    unsigned int min_fs;           // twice the chip rate, rounded up
+    std::string recording;         // Used instead of the generator if not empty, at recording_fs
+    unsigned int recording_fs;
+};
+
+
+struct Tracking_Benchmark_Result
+{
+    std::string implementation;
+    std::string item_type;
+    unsigned int fs;
+    unsigned int correlators;
+    Gnss_Sdr_Tracking_Profiler::Breakdown breakdown;
+};
+
+
+template <typename T>
+std::vector<T> trk_benchmark_split(const std::string& list, char separator = ',')
+{
+    std::vector<T> values;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, separator))
+        {
+            if (item.empty())
+                {
+                    continue;
+                }
+            std::stringstream item_ss(item);
+            T value;
+            item_ss >> value;
+            values.push_back(value);
+        }
+    return values;
+}
+
+
+Tracking_Benchmark_Signal trk_benchmark_signal(const std::string& implementation)
+{
+    Tracking_Benchmark_Signal s;
+    s.recording = "";
+    s.recording_fs = 0;
+    if (implementation.find("Galileo_E5a") == 0)
+        {
+            s.system = 'E'; s.signal = "5X"; s.tracked_signal = "5Q"; s.prn = 11; s.correlators = 3; s.min_fs = 20460000;
+        }
+    else if (implementation.find("Galileo_E1") == 0)
+        {
+            s.system = 'E'; s.signal = "1B"; s.tracked_signal = "1B"; s.prn = 1; s.correlators = 5; s.min_fs = 4092000;
+        }
+    else if (implementation.find("GPS_L2_M") == 0)
+        {
+            s.system = 'G'; s.signal = "2S"; s.tracked_signal = "2S"; s.prn = 7; s.correlators = 3; s.min_fs = 0;
+            s.recording = "/data/gps_l2c_m_prn7_5msps.dat"; s.recording_fs = 5000000;
+        }
+    else
+        {
+            s.system = 'G'; s.signal = "1C"; s.tracked_signal = "1C"; s.prn = 1; s.correlators = 3; s.min_fs = 2046000;
+        }
+    return s;
+}
+
+
+bool trk_benchmark_run(const std::string& implementation, const std::string& item_type, unsigned int fs,
+        Tracking_Benchmark_Result& result)
+{
+    Tracking_Benchmark_Signal s = trk_benchmark_signal(implementation);
+    bool use_recording = !s.recording.empty();
+    if (use_recording)
+        {
+            fs = s.recording_fs;
+        }
+    unsigned long long nsamples = static_cast<unsigned long long>(FLAGS_trk_benchmark_seconds * static_cast<double>(fs));
+
+    std::shared_ptr<InMemoryConfiguration> config = std::make_shared<InMemoryConfiguration>();
+    config->set_property("GNSS-SDR.internal_fs_hz", std::to_string(fs));
+
+    config->set_property("SignalSource.fs_hz", std::to_string(fs));
+    config->set_property("SignalSource.item_type", "gr_complex");
+    config->set_property("SignalSource.num_satellites", "1");
+    config->set_property("SignalSource.system_0", std::string(1, s.system));
+    config->set_property("SignalSource.signal_0", s.signal);
+    config->set_property("SignalSource.PRN_0", std::to_string(s.prn));
+    config->set_property("SignalSource.CN0_dB_0", "50");
+    config->set_property("SignalSource.doppler_Hz_0", "1000");
+    config->set_property("SignalSource.delay_chips_0", "0");
+    config->set_property("SignalSource.noise_flag", "true");
+    config->set_property("SignalSource.data_flag", "false");
+    config->set_property("SignalSource.BW_BB", "0.97");
+
+    config->set_property("Tracking.implementation", implementation);
+    config->set_property("Tracking.item_type", item_type);
+    config->set_property("Tracking.if", "0");
+    config->set_property("Tracking.dump", "false");
+    config->set_property("Tracking.early_late_space_chips", "0.5");
+    config->set_property("Tracking.very_early_late_space_chips", "0.6");
+    config->set_property("Tracking.order", "2");
+    config->set_property("Tracking.pll_bw_hz", "20");
+    config->set_property("Tracking.dll_bw_hz", "2");
+    config->set_property("Tracking.ti_ms", "1");
+
+    Gnss_Sdr_Tracking_Profiler::reset();
+
+    GNSSBlockFactory factory;
+    std::shared_ptr<GNSSBlockInterface> trk_ = factory.GetBlock(config, "Tracking", implementation, 1, 1);
+    std::shared_ptr<TrackingInterface> tracking = std::dynamic_pointer_cast<TrackingInterface>(trk_);
+    if (!tracking)
+        {
+            std::cout << "Unknown tracking implementation " << implementation << std::endl;
+            return false;
+        }
+
+    Gnss_Synchro gnss_synchro = Gnss_Synchro();
+    gnss_synchro.Channel_ID = 0;
+    gnss_synchro.System = s.system;
+    s.tracked_signal.copy(gnss_synchro.Signal, 2, 0);
+    gnss_synchro.PRN = s.prn;
+    gnss_synchro.Acq_delay_samples = use_recording ? 1 : 0;
+    gnss_synchro.Acq_doppler_hz = use_recording ? 1200 : 1000;
+    gnss_synchro.Acq_samplestamp_samples = 0;
+
+    gr::msg_queue::sptr queue = gr::msg_queue::make(0);
+    gr::top_block_sptr top_block = gr::make_top_block("Tracking benchmark");
+
+    tracking->set_channel(gnss_synchro.Channel_ID);
+    tracking->set_gnss_synchro(&gnss_synchro);
+    tracking->connect(top_block);
+
+    std::shared_ptr<SignalGenerator> signal_generator;
+    gr::basic_block_sptr source;
+    if (use_recording)
+        {
+            std::string file = std::string(TEST_PATH) + s.recording;
+            source = gr::blocks::file_source::make(sizeof(gr_complex), file.c_str(), true);
+        }
+    else
+        {
+            signal_generator = std::make_shared<SignalGenerator>(config.get(), "SignalSource", 0, 1, queue);
+            signal_generator->connect(top_block);
+            source = signal_generator->get_right_block();
+        }
+    boost::shared_ptr<gr::block> valve = gnss_sdr_make_valve(sizeof(gr_complex), nsamples, queue);
+    gr::blocks::null_sink::sptr sink = gr::blocks::null_sink::make(sizeof(Gnss_Synchro));
+    top_block->connect(source, 0, valve, 0);
+    if (item_type.compare("cshort") == 0)
+        {
+            // The generated samples have unit noise power, scaled to use the 16 bits
+            gr::blocks::multiply_const_cc::sptr gain = gr::blocks::multiply_const_cc::make(gr_complex(4096.0, 0.0));
+            gr::blocks::complex_to_interleaved_short::sptr to_short = gr::blocks::complex_to_interleaved_short::make();
+            interleaved_short_to_complex_short_sptr to_cshort = make_interleaved_short_to_complex_short();
+            top_block->connect(valve, 0, gain, 0);
+            top_block->connect(gain, 0, to_short, 0);
+            top_block->connect(to_short, 0, to_cshort, 0);
+            top_block->connect(to_cshort, 0, tracking->get_left_block(), 0);
+        }
+    else
+        {
+            top_block->connect(valve, 0, tracking->get_left_block(), 0);
+        }
+    top_block->connect(tracking->get_right_block(), 0, sink, 0);
+
+    tracking->start_tracking();
+    top_block->run(); // Start threads and wait
+
+    result.implementation = implementation;
+    result.item_type = item_type;
+    result.fs = fs;
+    result.correlators = s.correlators;
+    result.breakdown = Gnss_Sdr_Tracking_Profiler::breakdown(tracking->get_right_block()->name());
+    if (result.breakdown.epochs == 0)
+        {
+            std::cout << implementation << " did not track any epoch" << std::endl;
+            return false;
+        }
+    return true;
+}
+
+
+TEST(TrackingBenchmark, EpochBreakdownReport)
+{
+    std::vector<std::string> implementations = trk_benchmark_split<std::string>(FLAGS_trk_benchmark_implementations);
+    std::vector<unsigned int> fs_list = trk_benchmark_split<unsigned int>(FLAGS_trk_benchmark_fs);
+    std::vector<Tracking_Benchmark_Result> results;
+
+    // The profiles are only created by the blocks made after this
+    Gnss_Sdr_Tracking_Profiler::enable(true);
+
+    for (unsigned int i = 0; i < implementations.size(); i++)
+        {
+            std::vector<std::string> name = trk_benchmark_split<std::string>(implementations[i], ':');
+            std::string implementation = name.at(0);
+            std::string item_type = name.size() > 1 ? name.at(1) : "gr_complex";
+            Tracking_Benchmark_Signal s = trk_benchmark_signal(implementation);
+            for (unsigned int f = 0; f < fs_list.size(); f++)
+                {
+                    if (!s.recording.empty() && f > 0)
+                        {
+                            break;  // the recording has a single sampling frequency
+                        }
+                    if (s.recording.empty() && fs_list[f] < s.min_fs)
+                        {
+                            std::cout << implementation << " skipped at " << fs_list[f] << " Hz, below " << s.min_fs << " Hz" << std::endl;
+                            continue;
+                        }
+                    Tracking_Benchmark_Result result;
+                    EXPECT_NO_THROW(
+                            if (trk_benchmark_run(implementation, item_type, fs_list[f], result))
+                                {
+                                    results.push_back(result);
+                                }
+                    ) << "Exception running " << implementations[i];
+                }
+        }
+
+    Gnss_Sdr_Tracking_Profiler::enable(false);
+
+    std::cout << std::left << std::setw(34) << "implementation" << std::setw(12) << "item_type" << std::right
+              << std::setw(10) << "fs [Hz]" << std::setw(6) << "corr" << std::setw(9) << "epochs";
+    for (unsigned int phase = 0; phase < Gnss_Sdr_Tracking_Profile::phases; phase++)
+        {
+            std::cout << std::setw(16) << Gnss_Sdr_Tracking_Profile::phase_name(phase);
+        }
+    std::cout << std::setw(12) << "ns/epoch" << std::endl;
+    for (unsigned int i = 0; i < results.size(); i++)
+        {
+            std::cout << std::left << std::setw(34) << results[i].implementation << std::setw(12) << results[i].item_type << std::right
+                      << std::setw(10) << results[i].fs << std::setw(6) << results[i].correlators
+                      << std::setw(9) << results[i].breakdown.epochs << std::fixed << std::setprecision(0);
+            for (unsigned int phase = 0; phase < Gnss_Sdr_Tracking_Profile::phases; phase++)
+                {
+                    std::cout << std::setw(16) << results[i].breakdown.ns_per_epoch[phase];
+                }
+            std::cout << std::setw(12) << results[i].breakdown.total_ns_per_epoch << std::endl;
+        }
+
+    if (!FLAGS_trk_benchmark_report.empty())
+        {
+            std::ofstream report(FLAGS_trk_benchmark_report.c_str());
+            report << "implementation,item_type,fs_hz,correlators,epochs";
+            for (unsigned int phase = 0; phase < Gnss_Sdr_Tracking_Profile::phases; phase++)
+                {
+                    report << ",ns_" << Gnss_Sdr_Tracking_Profile::phase_name(phase);
+                }
+            report << ",ns_per_epoch" << std::endl;
+            for (unsigned int i = 0; i < results.size(); i++)
+                {
+                    report << results[i].implementation << "," << results[i].item_type << "," << results[i].fs << ","
+                           << results[i].correlators << "," << results[i].breakdown.epochs;
+                    for (unsigned int phase = 0; phase < Gnss_Sdr_Tracking_Profile::phases; phase++)
+                        {
+                            report << "," << results[i].breakdown.ns_per_epoch[phase];
+                        }
+                    report << "," << results[i].breakdown.total_ns_per_epoch << std::endl;
+                }
+        }
+
+    EXPECT_FALSE(results.empty());
+}
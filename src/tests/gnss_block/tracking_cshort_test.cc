@@ -0,0 +1,335 @@
+/*!
+ * \file tracking_cshort_test.cc
+ * \brief Tests of the tracking blocks fed with 16-bit complex samples
+ *  (item_type cshort) against the same blocks fed with gr_complex.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/vector_sink_b.h>
+#include <gnuradio/blocks/vector_source_c.h>
+#include <gnuradio/blocks/vector_source_s.h>
+#include <gtest/gtest.h>
+#include "galileo_e1_dll_pll_veml_tracking.h"
+#include "galileo_e1_dll_pll_veml_tracking_cc.h"
+#include "galileo_e1_signal_processing.h"
+#include "galileo_e5_signal_processing.h"
+#include "galileo_e5a_dll_pll_tracking.h"
+#include "galileo_e5a_dll_pll_tracking_cc.h"
+#include "gnss_synchro.h"
+#include "gps_l2_m_dll_pll_tracking.h"
+#include "gps_l2_m_dll_pll_tracking_cc.h"
+#include "in_memory_configuration.h"
+#include "Galileo_E1.h"
+#include "Galileo_E5a.h"
+
+
+class TrackingCshortTest: public ::testing::Test
+{
+protected:
+    TrackingCshortTest()
+    {
+        config = std::make_shared<InMemoryConfiguration>();
+        fs_in = 4000000;
+        prn = 11;
+        doppler_hz = 1250.0;
+        delay_samples = 1234;
+        gnss_synchro = Gnss_Synchro();
+    }
+
+    ~TrackingCshortTest()
+    {}
+
+    void init_e1(const std::string& role, const std::string& item_type, bool track_pilot);
+    void init_e5a(const std::string& role, const std::string& item_type);
+
+    //! E1-B and E1-C of satellite prn, plus white noise, in 16-bit integers
+    std::vector<short> generate_e1_signal(unsigned int nsamples, float noise_power, float scale);
+
+    //! E5a-I and E5a-Q of satellite prn with their secondary codes, plus white noise, in 16-bit integers
+    std::vector<short> generate_e5a_signal(unsigned int nsamples, float noise_power, float scale);
+
+    //! Tracks the samples of signal, fed as gr_complex or as cshort after the item size of tracking
+    std::vector<Gnss_Synchro> track(TrackingInterface& tracking, const std::string& signal, const std::vector<short>& samples);
+
+    //! One sample of the code values, with the carrier and white noise, scaled to 16 bits
+    std::complex<short> sample(gr_complex code, unsigned int n, float scale);
+
+    std::shared_ptr<InMemoryConfiguration> config;
+    Gnss_Synchro gnss_synchro;
+    int fs_in;
+    unsigned int prn;
+    double doppler_hz;
+    unsigned int delay_samples;
+    std::mt19937 generator;
+    std::normal_distribution<float> noise;
+};
+
+
+void TrackingCshortTest::init_e1(const std::string& role, const std::string& item_type, bool track_pilot)
+{
+    config->set_property("GNSS-SDR.internal_fs_hz", std::to_string(fs_in));
+    config->set_property(role + ".implementation", "Galileo_E1_DLL_PLL_VEML_Tracking");
+    config->set_property(role + ".item_type", item_type);
+    config->set_property(role + ".dump", "false");
+    config->set_property(role + ".pll_bw_hz", "15.0");
+    config->set_property(role + ".dll_bw_hz", "2.0");
+    config->set_property(role + ".early_late_space_chips", "0.15");
+    config->set_property(role + ".very_early_late_space_chips", "0.6");
+    config->set_property(role + ".track_pilot", track_pilot ? "true" : "false");
+}
+
+
+void TrackingCshortTest::init_e5a(const std::string& role, const std::string& item_type)
+{
+    config->set_property("GNSS-SDR.internal_fs_hz", std::to_string(fs_in));
+    config->set_property(role + ".implementation", "Galileo_E5a_DLL_PLL_Tracking");
+    config->set_property(role + ".item_type", item_type);
+    config->set_property(role + ".dump", "false");
+    config->set_property(role + ".pll_bw_hz", "20.0");
+    config->set_property(role + ".dll_bw_hz", "2.0");
+    config->set_property(role + ".pll_bw_init_hz", "5.0");
+    config->set_property(role + ".dll_bw_init_hz", "2.0");
+    config->set_property(role + ".ti_ms", "1");
+    config->set_property(role + ".early_late_space_chips", "0.5");
+}
+
+
+std::complex<short> TrackingCshortTest::sample(gr_complex code, unsigned int n, float scale)
+{
+    const double phase = GALILEO_TWO_PI * doppler_hz * static_cast<double>(n) / static_cast<double>(fs_in);
+    const gr_complex value = code * gr_complex(static_cast<float>(cos(phase)), static_cast<float>(sin(phase)))
+            + gr_complex(noise(generator), noise(generator));
+    return std::complex<short>(static_cast<short>(std::round(scale * value.real())),
+            static_cast<short>(std::round(scale * value.imag())));
+}
+
+
+std::vector<short> TrackingCshortTest::generate_e1_signal(unsigned int nsamples, float noise_power, float scale)
+{
+    // the BOC(1,1) replicas, two samples per chip
+    const unsigned int code_length = static_cast<unsigned int>(2 * Galileo_E1_B_CODE_LENGTH_CHIPS);
+    std::vector<gr_complex> data_code(code_length);
+    std::vector<gr_complex> pilot_code(code_length);
+    char data_signal[3] = "1B";
+    char pilot_signal[3] = "1C";
+    galileo_e1_code_gen_complex_sampled(data_code.data(), data_signal, false, prn, 2 * Galileo_E1_CODE_CHIP_RATE_HZ, 0);
+    galileo_e1_code_gen_complex_sampled(pilot_code.data(), pilot_signal, false, prn, 2 * Galileo_E1_CODE_CHIP_RATE_HZ, 0);
+
+    std::vector<short> samples(2 * nsamples);
+    generator.seed(2016);
+    noise = std::normal_distribution<float>(0.0, std::sqrt(noise_power / 2.0));
+    // the code is stretched by the Doppler effect too
+    const double code_rate = 2.0 * Galileo_E1_CODE_CHIP_RATE_HZ * (1.0 + doppler_hz / Galileo_E1_FREQ_HZ);
+    for (unsigned int n = 0; n < nsamples; n++)
+        {
+            const double t = (static_cast<double>(n) - static_cast<double>(delay_samples)) / static_cast<double>(fs_in);
+            double half_chip = std::fmod(t * code_rate, static_cast<double>(code_length));
+            if (half_chip < 0) half_chip += code_length;
+            const unsigned int index = static_cast<unsigned int>(half_chip) % code_length;
+            const std::complex<short> value = sample(data_code.at(index) + pilot_code.at(index), n, scale);
+            samples[2 * n] = value.real();
+            samples[2 * n + 1] = value.imag();
+        }
+    return samples;
+}
+
+
+std::vector<short> TrackingCshortTest::generate_e5a_signal(unsigned int nsamples, float noise_power, float scale)
+{
+    // the data on the real part and the pilot on the imaginary one, one sample per chip
+    const unsigned int code_length = static_cast<unsigned int>(Galileo_E5a_CODE_LENGTH_CHIPS);
+    std::vector<gr_complex> data_code(code_length);
+    std::vector<gr_complex> pilot_code(code_length);
+    char data_signal[3] = "5I";
+    char pilot_signal[3] = "5Q";
+    galileo_e5_a_code_gen_complex_primary(data_code.data(), prn, data_signal);
+    galileo_e5_a_code_gen_complex_primary(pilot_code.data(), prn, pilot_signal);
+
+    std::vector<short> samples(2 * nsamples);
+    generator.seed(2016);
+    noise = std::normal_distribution<float>(0.0, std::sqrt(noise_power / 2.0));
+    const double code_rate = Galileo_E5a_CODE_CHIP_RATE_HZ * (1.0 + doppler_hz / Galileo_E5a_FREQ_HZ);
+    for (unsigned int n = 0; n < nsamples; n++)
+        {
+            const double t = (static_cast<double>(n) - static_cast<double>(delay_samples)) / static_cast<double>(fs_in);
+            const double chips = t * code_rate;
+            const long period = static_cast<long>(std::floor(chips / code_length));
+            double chip = std::fmod(chips, static_cast<double>(code_length));
+            if (chip < 0) chip += code_length;
+            const unsigned int index = static_cast<unsigned int>(chip) % code_length;
+            // a secondary code chip '0' keeps the sign of the primary code
+            const long data_chip = ((period % Galileo_E5a_I_SECONDARY_CODE_LENGTH) + Galileo_E5a_I_SECONDARY_CODE_LENGTH) % Galileo_E5a_I_SECONDARY_CODE_LENGTH;
+            const long pilot_chip = ((period % Galileo_E5a_Q_SECONDARY_CODE_LENGTH) + Galileo_E5a_Q_SECONDARY_CODE_LENGTH) % Galileo_E5a_Q_SECONDARY_CODE_LENGTH;
+            const float data_sign = Galileo_E5a_I_SECONDARY_CODE.at(data_chip) == '0' ? 1.0 : -1.0;
+            const float pilot_sign = Galileo_E5a_Q_SECONDARY_CODE[prn - 1].at(pilot_chip) == '0' ? 1.0 : -1.0;
+            const std::complex<short> value = sample(data_sign * data_code.at(index) + pilot_sign * pilot_code.at(index), n, scale);
+            samples[2 * n] = value.real();
+            samples[2 * n + 1] = value.imag();
+        }
+    return samples;
+}
+
+
+std::vector<Gnss_Synchro> TrackingCshortTest::track(TrackingInterface& tracking, const std::string& signal, const std::vector<short>& samples)
+{
+    gnss_synchro = Gnss_Synchro();
+    gnss_synchro.Channel_ID = 0;
+    gnss_synchro.System = 'E';
+    signal.copy(gnss_synchro.Signal, 2, 0);
+    gnss_synchro.PRN = prn;
+    gnss_synchro.Acq_delay_samples = delay_samples;
+    gnss_synchro.Acq_doppler_hz = doppler_hz;
+    gnss_synchro.Acq_samplestamp_samples = 0;
+    tracking.set_channel(0);
+    tracking.set_gnss_synchro(&gnss_synchro);
+
+    gr::top_block_sptr top_block = gr::make_top_block("Tracking cshort test");
+    gr::blocks::vector_sink_b::sptr sink = gr::blocks::vector_sink_b::make(sizeof(Gnss_Synchro));
+    if (tracking.item_size() == sizeof(lv_16sc_t))
+        {
+            // two shorts per complex sample
+            gr::blocks::vector_source_s::sptr source = gr::blocks::vector_source_s::make(samples, false, 2);
+            top_block->connect(source, 0, tracking.get_left_block(), 0);
+        }
+    else
+        {
+            std::vector<gr_complex> complex_samples(samples.size() / 2);
+            for (unsigned int n = 0; n < complex_samples.size(); n++)
+                {
+                    complex_samples[n] = gr_complex(samples[2 * n], samples[2 * n + 1]);
+                }
+            gr::blocks::vector_source_c::sptr source = gr::blocks::vector_source_c::make(complex_samples, false);
+            top_block->connect(source, 0, tracking.get_left_block(), 0);
+        }
+    top_block->connect(tracking.get_right_block(), 0, sink, 0);
+    tracking.start_tracking();
+    top_block->run(); // Start threads and wait
+
+    std::vector<unsigned char> bytes = sink->data();
+    std::vector<Gnss_Synchro> items(bytes.size() / sizeof(Gnss_Synchro));
+    if (items.empty() == false)
+        {
+            std::memcpy(&items[0], &bytes[0], items.size() * sizeof(Gnss_Synchro));
+        }
+    return items;
+}
+
+
+TEST_F(TrackingCshortTest, InstantiateCshortBlocks)
+{
+    const std::string roles[] = { "Tracking_1B", "Tracking_5X", "Tracking_2S" };
+    for (unsigned int i = 0; i < 3; i++)
+        {
+            config->set_property(roles[i] + ".item_type", "cshort");
+            config->set_property(roles[i] + ".dump", "false");
+        }
+    config->set_property("Tracking_1B.track_pilot", "true");
+
+    GalileoE1DllPllVemlTracking e1(config.get(), "Tracking_1B", 1, 1);
+    EXPECT_EQ(sizeof(lv_16sc_t), e1.item_size());
+    EXPECT_TRUE(boost::dynamic_pointer_cast<galileo_e1_dll_pll_veml_tracking_sc>(e1.get_left_block()).get() != 0);
+
+    GalileoE5aDllPllTracking e5a(config.get(), "Tracking_5X", 1, 1);
+    EXPECT_EQ(sizeof(lv_16sc_t), e5a.item_size());
+    EXPECT_TRUE(boost::dynamic_pointer_cast<Galileo_E5a_Dll_Pll_Tracking_sc>(e5a.get_left_block()).get() != 0);
+
+    GpsL2MDllPllTracking l2(config.get(), "Tracking_2S", 1, 1);
+    EXPECT_EQ(sizeof(lv_16sc_t), l2.item_size());
+    EXPECT_TRUE(boost::dynamic_pointer_cast<gps_l2_m_dll_pll_tracking_sc>(l2.get_left_block()).get() != 0);
+}
+
+
+TEST_F(TrackingCshortTest, GalileoE1CshortMatchesGrComplex)
+{
+    // the same integer samples, in 16 bits and in float
+    std::vector<short> samples = generate_e1_signal(fs_in, 2.0, 64.0);
+
+    for (int track_pilot = 0; track_pilot < 2; track_pilot++)
+        {
+            init_e1("Tracking_cc", "gr_complex", track_pilot);
+            init_e1("Tracking_sc", "cshort", track_pilot);
+            GalileoE1DllPllVemlTracking tracking_cc(config.get(), "Tracking_cc", 1, 1);
+            GalileoE1DllPllVemlTracking tracking_sc(config.get(), "Tracking_sc", 1, 1);
+            std::vector<Gnss_Synchro> cc = track(tracking_cc, "1B", samples);
+            std::vector<Gnss_Synchro> sc = track(tracking_sc, "1B", samples);
+
+            // one epoch per code period
+            ASSERT_GT(cc.size(), 200u);
+            ASSERT_EQ(cc.size(), sc.size());
+            unsigned int same_sign = 0;
+            unsigned int compared = 0;
+            for (unsigned int epoch = 50; epoch < cc.size(); epoch++)
+                {
+                    if (!cc.at(epoch).Flag_valid_symbol_output) continue;
+                    ASSERT_TRUE(sc.at(epoch).Flag_valid_symbol_output);
+                    EXPECT_NEAR(cc.at(epoch).Tracking_timestamp_secs, sc.at(epoch).Tracking_timestamp_secs, 1e-7);
+                    EXPECT_NEAR(doppler_hz, cc.at(epoch).Carrier_Doppler_hz, 5.0);
+                    EXPECT_NEAR(cc.at(epoch).Carrier_Doppler_hz, sc.at(epoch).Carrier_Doppler_hz, 2.0);
+                    if ((cc.at(epoch).Prompt_I > 0) == (sc.at(epoch).Prompt_I > 0)) same_sign++;
+                    compared++;
+                }
+            // the data symbols, with the same phase ambiguity
+            ASSERT_GT(compared, 100u);
+            EXPECT_EQ(compared, same_sign) << "track_pilot = " << track_pilot;
+        }
+}
+
+
+TEST_F(TrackingCshortTest, GalileoE5aCshortMatchesGrComplex)
+{
+    // the data and the pilot are correlated in one pass in both sample types
+    fs_in = 12000000;
+    doppler_hz = -850.0;
+    delay_samples = 4321;
+    std::vector<short> samples = generate_e5a_signal(fs_in / 2, 18.0, 64.0);
+    init_e5a("Tracking_cc", "gr_complex");
+    init_e5a("Tracking_sc", "cshort");
+    GalileoE5aDllPllTracking tracking_cc(config.get(), "Tracking_cc", 1, 1);
+    GalileoE5aDllPllTracking tracking_sc(config.get(), "Tracking_sc", 1, 1);
+    std::vector<Gnss_Synchro> cc = track(tracking_cc, "5X", samples);
+    std::vector<Gnss_Synchro> sc = track(tracking_sc, "5X", samples);
+
+    ASSERT_GT(cc.size(), 400u);
+    ASSERT_EQ(cc.size(), sc.size());
+    for (unsigned int epoch = 100; epoch < cc.size(); epoch++)
+        {
+            // the prompt is only output after the secondary code lock
+            ASSERT_NE(0.0, cc.at(epoch).Prompt_I);
+            ASSERT_NE(0.0, sc.at(epoch).Prompt_I);
+            EXPECT_NEAR(cc.at(epoch).Tracking_timestamp_secs, sc.at(epoch).Tracking_timestamp_secs, 1e-7);
+            EXPECT_NEAR(doppler_hz, cc.at(epoch).Carrier_Doppler_hz, 40.0);
+            EXPECT_NEAR(cc.at(epoch).Carrier_Doppler_hz, sc.at(epoch).Carrier_Doppler_hz, 2.0);
+            EXPECT_EQ(cc.at(epoch).Prompt_I > 0, sc.at(epoch).Prompt_I > 0);
+        }
+}
@@ -0,0 +1,129 @@
+/*!
+ * \file beam_steering_test.cc
+ * \brief Tests the per-channel beam steering of an antenna array
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/vector_source_c.h>
+#include <gnuradio/blocks/vector_sink_c.h>
+#include "beam_steering.h"
+
+
+namespace
+{
+const double WAVELENGTH_M = 0.19;
+
+// line of elements separated by half a wavelength to the east
+std::vector<double> line_array(unsigned int elements)
+{
+    std::vector<double> positions;
+    for (unsigned int k = 0; k < elements; k++)
+        {
+            positions.push_back(k * WAVELENGTH_M / 2.0);
+            positions.push_back(0.0);
+            positions.push_back(0.0);
+        }
+    return positions;
+}
+
+// plane wave from the direction, as received by each element
+std::vector<gr_complex> plane_wave(const std::vector<double> & positions, double azimuth_deg, double elevation_deg)
+{
+    const double azimuth = azimuth_deg * M_PI / 180.0;
+    const double elevation = elevation_deg * M_PI / 180.0;
+    std::vector<gr_complex> phases;
+    for (unsigned int k = 0; k < positions.size() / 3; k++)
+        {
+            const double path = positions[3 * k] * std::sin(azimuth) * std::cos(elevation)
+                    + positions[3 * k + 1] * std::cos(azimuth) * std::cos(elevation)
+                    + positions[3 * k + 2] * std::sin(elevation);
+            phases.push_back(std::polar(1.0f, static_cast<float>(2.0 * M_PI * path / WAVELENGTH_M)));
+        }
+    return phases;
+}
+}
+
+
+TEST(Beam_Steering_Test, PointsEachBeamToItsDirection)
+{
+    const unsigned int elements = 4;
+    const unsigned int beams = 3;
+    const unsigned int n_samples = 1001;
+    std::vector<double> positions = line_array(elements);
+    beam_steering_sptr steering = make_beam_steering(elements, beams, positions, WAVELENGTH_M, 0);
+    EXPECT_TRUE(steering->set_direction(0, 90.0, 60.0));
+    EXPECT_TRUE(steering->set_direction(2, 270.0, 60.0));
+    EXPECT_FALSE(steering->set_direction(beams, 0.0, 0.0));
+
+    // the signal comes from the east, 60 degrees above the horizon
+    std::vector<gr_complex> phases = plane_wave(positions, 90.0, 60.0);
+    gr::top_block_sptr top_block = gr::make_top_block("beam_steering_test");
+    for (unsigned int k = 0; k < elements; k++)
+        {
+            std::vector<gr_complex> samples(n_samples, phases[k]);
+            top_block->connect(gr::blocks::vector_source_c::make(samples), 0, steering, k);
+        }
+    std::vector<gr::blocks::vector_sink_c::sptr> sinks;
+    for (unsigned int beam = 0; beam < beams; beam++)
+        {
+            sinks.push_back(gr::blocks::vector_sink_c::make());
+            top_block->connect(steering, beam, sinks.back(), 0);
+        }
+    top_block->run();
+
+    for (unsigned int beam = 0; beam < beams; beam++)
+        {
+            ASSERT_EQ(n_samples, sinks[beam]->data().size());
+        }
+    // steered beam, zenith beam (not steered) and the beam to the west
+    EXPECT_NEAR(1.0, std::abs(sinks[0]->data().back()), 1e-4);
+    EXPECT_LT(std::abs(sinks[1]->data().back()), 0.5);
+    EXPECT_LT(std::abs(sinks[2]->data().back()), 0.5);
+}
+
+
+TEST(Beam_Steering_Test, StartsAtTheZenith)
+{
+    const unsigned int elements = 3;
+    std::vector<double> positions = line_array(elements);
+    positions[5] = 0.25 * WAVELENGTH_M;
+    beam_steering_sptr steering = make_beam_steering(elements, 2, positions, WAVELENGTH_M, 0);
+
+    // only the height of the elements matters at the zenith
+    std::vector<gr_complex> weights = steering->weights(1);
+    ASSERT_EQ(elements, weights.size());
+    EXPECT_NEAR(1.0 / 3.0, weights[0].real(), 1e-6);
+    EXPECT_NEAR(1.0 / 3.0, weights[2].real(), 1e-6);
+    EXPECT_NEAR(0.0, weights[1].real(), 1e-6);
+    EXPECT_NEAR(-1.0 / 3.0, weights[1].imag(), 1e-6);
+    EXPECT_TRUE(steering->weights(2).empty());
+}
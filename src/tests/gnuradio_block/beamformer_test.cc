@@ -0,0 +1,93 @@
+/*!
+ * \file beamformer_test.cc
+ * \brief Tests the beamformer of an antenna array
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <complex>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/vector_source_c.h>
+#include <gnuradio/blocks/vector_sink_c.h>
+#include "beamformer.h"
+
+
+namespace
+{
+// runs n_samples of the constant signal k + 1 in channel k through the beamformer
+std::vector<gr_complex> run_beamformer(beamformer_sptr combiner, unsigned int channels, unsigned int n_samples)
+{
+    gr::top_block_sptr top_block = gr::make_top_block("beamformer_test");
+    gr::blocks::vector_sink_c::sptr sink = gr::blocks::vector_sink_c::make();
+    for (unsigned int k = 0; k < channels; k++)
+        {
+            std::vector<gr_complex> samples(n_samples, gr_complex(k + 1, 0));
+            top_block->connect(gr::blocks::vector_source_c::make(samples), 0, combiner, k);
+        }
+    top_block->connect(combiner, 0, sink, 0);
+    top_block->run();
+    return sink->data();
+}
+}
+
+
+TEST(Beamformer_Test, WeightsTheChannels)
+{
+    const unsigned int channels = 5;
+    std::vector<gr_complex> weights;
+    for (unsigned int k = 0; k < channels; k++)
+        {
+            weights.push_back(gr_complex(0.5, 0.25 * k));
+        }
+    std::vector<gr_complex> data = run_beamformer(make_beamformer(channels, BEAMFORMER_ITEM_GR_COMPLEX, weights),
+            channels, 1001);
+
+    // sum of (k + 1) * (0.5 + 0.25 k j)
+    ASSERT_EQ(1001u, data.size());
+    for (unsigned int n = 0; n < data.size(); n++)
+        {
+            EXPECT_NEAR(7.5, data[n].real(), 1e-4);
+            EXPECT_NEAR(10.0, data[n].imag(), 1e-4);
+        }
+}
+
+
+TEST(Beamformer_Test, ReplacesTheWeights)
+{
+    const unsigned int channels = 8;
+    beamformer_sptr combiner = make_beamformer(channels, BEAMFORMER_ITEM_GR_COMPLEX, std::vector<gr_complex>());
+    std::vector<gr_complex> weights(channels, gr_complex(0.0, 0.0));
+    weights[2] = gr_complex(0.0, 1.0);
+    EXPECT_FALSE(combiner->set_weights(std::vector<gr_complex>(channels - 1, gr_complex(1.0, 0.0))));
+    EXPECT_TRUE(combiner->set_weights(weights));
+
+    std::vector<gr_complex> data = run_beamformer(combiner, channels, 100);
+    ASSERT_EQ(100u, data.size());
+    EXPECT_NEAR(0.0, data.back().real(), 1e-4);
+    EXPECT_NEAR(3.0, data.back().imag(), 1e-4);
+}
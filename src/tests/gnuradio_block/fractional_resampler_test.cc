@@ -0,0 +1,106 @@
+/*!
+ * \file fractional_resampler_test.cc
+ * \brief Tests the polyphase and Farrow resamplers
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/vector_source_c.h>
+#include <gnuradio/blocks/vector_sink_c.h>
+#include "fractional_resampler.h"
+
+
+namespace
+{
+// resamples a complex tone of unit amplitude, returns the output
+std::vector<gr_complex> resample_tone(Fractional_Resampler_Method method, double fs_in,
+        double fs_out, double tone_freq, unsigned int n_samples)
+{
+    std::vector<gr_complex> tone;
+    for (unsigned int n = 0; n < n_samples; n++)
+        {
+            tone.push_back(std::polar(1.0f, static_cast<float>(2.0 * M_PI * tone_freq * n / fs_in)));
+        }
+    gr::top_block_sptr top_block = gr::make_top_block("fractional_resampler_test");
+    gr::blocks::vector_source_c::sptr source = gr::blocks::vector_source_c::make(tone);
+    fractional_resampler_sptr resampler = make_fractional_resampler(method, RESAMPLER_ITEM_GR_COMPLEX,
+            fs_in, fs_out, 16, 0.8);
+    gr::blocks::vector_sink_c::sptr sink = gr::blocks::vector_sink_c::make();
+
+    top_block->connect(source, 0, resampler, 0);
+    top_block->connect(resampler, 0, sink, 0);
+    top_block->run();
+    return sink->data();
+}
+
+// mean amplitude of the second half of the output, after the transient
+double mean_amplitude(const std::vector<gr_complex> & data)
+{
+    double sum = 0.0;
+    for (unsigned int k = data.size() / 2; k < data.size(); k++)
+        {
+            sum += std::abs(data[k]);
+        }
+    return sum / (data.size() - data.size() / 2);
+}
+}
+
+
+TEST(Fractional_Resampler_Test, PolyphasePassesTheSignal)
+{
+    std::vector<gr_complex> data = resample_tone(RESAMPLER_POLYPHASE, 4000000.0, 2500000.0, 300000.0, 40000);
+    EXPECT_EQ(25000u, data.size());
+    EXPECT_NEAR(1.0, mean_amplitude(data), 0.01);
+}
+
+
+TEST(Fractional_Resampler_Test, PolyphaseRejectsTheAliases)
+{
+    // -1.8 MHz would fold onto 0.7 MHz at 2.5 Msps
+    std::vector<gr_complex> data = resample_tone(RESAMPLER_POLYPHASE, 4000000.0, 2500000.0, 2200000.0, 40000);
+    EXPECT_LT(mean_amplitude(data), 0.01);
+}
+
+
+TEST(Fractional_Resampler_Test, FarrowResamplesAnyRatio)
+{
+    std::vector<gr_complex> data = resample_tone(RESAMPLER_FARROW, 4000000.0, 2600000.0 + 1.0 / 3.0, 300000.0, 40000);
+    EXPECT_NEAR(26000.0, data.size(), 16.0);
+    EXPECT_NEAR(1.0, mean_amplitude(data), 0.01);
+}
+
+
+TEST(Fractional_Resampler_Test, PolyphaseNeedsASmallInterpolation)
+{
+    EXPECT_THROW(make_fractional_resampler(RESAMPLER_POLYPHASE, RESAMPLER_ITEM_GR_COMPLEX,
+            4000000.0, 2047999.0, 16, 0.8), std::invalid_argument);
+}
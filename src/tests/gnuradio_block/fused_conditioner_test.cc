@@ -0,0 +1,97 @@
+/*!
+ * \file fused_conditioner_test.cc
+ * \brief Tests of the fused_conditioner block
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/vector_source_b.h>
+#include <gnuradio/blocks/vector_source_s.h>
+#include <gnuradio/blocks/vector_sink_c.h>
+#include "fused_conditioner.h"
+
+
+TEST(Fused_Conditioner_Test, TranslatesToBasebandAndDecimates)
+{
+    const double fs = 4000000.0;
+    const double intermediate_freq = 1000000.0;
+    const double offset = 10000.0;
+    const unsigned int decimation = 4;
+    const unsigned int n_samples = 100000;
+    std::vector<short> interleaved;
+    for (unsigned int n = 0; n < n_samples; n++)
+        {
+            double phase = 2.0 * M_PI * (intermediate_freq + offset) * n / fs;
+            interleaved.push_back(static_cast<short>(std::round(1000.0 * std::cos(phase))));
+            interleaved.push_back(static_cast<short>(std::round(1000.0 * std::sin(phase))));
+        }
+    gr::top_block_sptr top_block = gr::make_top_block("fused_conditioner_test");
+    gr::blocks::vector_source_s::sptr source = gr::blocks::vector_source_s::make(interleaved);
+    fused_conditioner_sptr conditioner = make_fused_conditioner(FUSED_INPUT_ISHORT, FUSED_OUTPUT_GR_COMPLEX,
+            std::vector<float>(1, 1.0), intermediate_freq, fs, decimation, false, 0.0);
+    gr::blocks::vector_sink_c::sptr sink = gr::blocks::vector_sink_c::make();
+
+    top_block->connect(source, 0, conditioner, 0);
+    top_block->connect(conditioner, 0, sink, 0);
+    top_block->run();
+
+    std::vector<gr_complex> data = sink->data();
+    ASSERT_EQ(n_samples / decimation, data.size());
+    double max_error = 0.0;
+    for (unsigned int m = 0; m < data.size(); m++)
+        {
+            std::complex<double> expected = std::polar(1000.0, 2.0 * M_PI * offset * m * decimation / fs);
+            max_error = std::max(max_error, std::abs(std::complex<double>(data[m]) - expected));
+        }
+    EXPECT_LT(max_error, 2.0);
+}
+
+
+TEST(Fused_Conditioner_Test, RemovesTheDc)
+{
+    const unsigned int n_samples = 10000;
+    std::vector<unsigned char> bytes(n_samples, 20);
+    gr::top_block_sptr top_block = gr::make_top_block("fused_conditioner_test");
+    gr::blocks::vector_source_b::sptr source = gr::blocks::vector_source_b::make(bytes);
+    fused_conditioner_sptr conditioner = make_fused_conditioner(FUSED_INPUT_BYTE, FUSED_OUTPUT_GR_COMPLEX,
+            std::vector<float>(1, 1.0), 0.0, 4000000.0, 1, true, 0.01);
+    gr::blocks::vector_sink_c::sptr sink = gr::blocks::vector_sink_c::make();
+
+    top_block->connect(source, 0, conditioner, 0);
+    top_block->connect(conditioner, 0, sink, 0);
+    top_block->run();
+
+    std::vector<gr_complex> data = sink->data();
+    ASSERT_EQ(n_samples, data.size());
+    EXPECT_GT(std::abs(data[0]), 10.0);
+    EXPECT_LT(std::abs(data[n_samples - 1]), 0.01);
+}
@@ -0,0 +1,70 @@
+/*!
+ * \file gnss_sdr_overflow_monitor_test.cc
+ * \brief  This file implements tests for the overflow monitor of the signal sources
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <vector>
+#include <gtest/gtest.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/vector_source_c.h>
+#include <pmt/pmt.h>
+#include "gnss_sdr_overflow_monitor.h"
+
+
+namespace
+{
+gr::tag_t rx_time_tag(unsigned long long offset, unsigned long long seconds, double fraction)
+{
+    gr::tag_t tag;
+    tag.offset = offset;
+    tag.key = pmt::mp("rx_time");
+    tag.value = pmt::make_tuple(pmt::from_uint64(seconds), pmt::from_double(fraction));
+    return tag;
+}
+}
+
+
+TEST(Gnss_Sdr_Overflow_Monitor_Test, CountsTheGapsOfTheTimeTags)
+{
+    const double sample_rate = 1e6;
+    std::vector<gr_complex> samples(5000);
+    std::vector<gr::tag_t> tags;
+    tags.push_back(rx_time_tag(0, 100, 0.9995));     // start of the stream
+    tags.push_back(rx_time_tag(1000, 101, 0.0005));  // the expected time, no overflow
+    tags.push_back(rx_time_tag(2000, 101, 0.0020));  // 500 samples lost
+    tags.push_back(rx_time_tag(3000, 101, 0.0035));  // 500 more
+    tags.push_back(rx_time_tag(4000, 101, 0.0045));  // continuous again
+
+    gnss_sdr_overflow_monitor_sptr monitor = gnss_sdr_make_overflow_monitor(sizeof(gr_complex), sample_rate, 0, gr::msg_queue::sptr());
+    gr::top_block_sptr top_block = gr::make_top_block("overflow_monitor_test");
+    top_block->connect(gr::blocks::vector_source_c::make(samples, false, 1, tags), 0, monitor, 0);
+    top_block->run();
+
+    EXPECT_EQ(2u, monitor->overflows());
+    EXPECT_EQ(1000u, monitor->lost_samples());
+}
@@ -0,0 +1,110 @@
+/*!
+ * \file memory_source_test.cc
+ * \brief Tests the memory source and the table of sample buffers
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/head.h>
+#include <gnuradio/blocks/vector_sink_s.h>
+#include "memory_signal_buffers.h"
+#include "memory_source.h"
+
+
+TEST(Memory_Source_Test, ReadsTheBufferAfterTheOffset)
+{
+    std::vector<int16_t> samples(100000);
+    for (unsigned int i = 0; i < samples.size(); i++)
+        {
+            samples[i] = static_cast<int16_t>(i);
+        }
+    // the last byte is half an item, which is not output
+    gr::top_block_sptr top_block = gr::make_top_block("memory_source_test");
+    memory_source_sptr source = make_memory_source(sizeof(int16_t), samples.data(), samples.size() * sizeof(int16_t) - 1, 10, false);
+    gr::blocks::vector_sink_s::sptr sink = gr::blocks::vector_sink_s::make();
+    EXPECT_EQ(samples.size() - 6, source->items());
+
+    top_block->connect(source, 0, sink, 0);
+    top_block->run();
+
+    std::vector<short> data = sink->data();
+    ASSERT_EQ(samples.size() - 6, data.size());
+    bool all_equal = true;
+    for (unsigned int i = 0; i < data.size(); i++)
+        {
+            all_equal = all_equal && data[i] == samples[i + 5];
+        }
+    EXPECT_TRUE(all_equal);
+}
+
+
+TEST(Memory_Source_Test, Repeat)
+{
+    std::vector<int16_t> samples(1000);
+    for (unsigned int i = 0; i < samples.size(); i++)
+        {
+            samples[i] = static_cast<int16_t>(i);
+        }
+    gr::top_block_sptr top_block = gr::make_top_block("memory_source_test");
+    memory_source_sptr source = make_memory_source(sizeof(int16_t), samples.data(), samples.size() * sizeof(int16_t), 0, true);
+    gr::blocks::head::sptr head = gr::blocks::head::make(sizeof(int16_t), 3 * samples.size() + 10);
+    gr::blocks::vector_sink_s::sptr sink = gr::blocks::vector_sink_s::make();
+
+    top_block->connect(source, 0, head, 0);
+    top_block->connect(head, 0, sink, 0);
+    top_block->run();
+
+    std::vector<short> data = sink->data();
+    ASSERT_EQ(3 * samples.size() + 10, data.size());
+    bool all_equal = true;
+    for (unsigned int i = 0; i < data.size(); i++)
+        {
+            all_equal = all_equal && data[i] == samples[i % samples.size()];
+        }
+    EXPECT_TRUE(all_equal);
+}
+
+
+TEST(Memory_Source_Test, Buffers)
+{
+    const int16_t samples[4] = {1, 2, 3, 4};
+    const void* data = nullptr;
+    size_t bytes = 0;
+    EXPECT_FALSE(Memory_Signal_Buffers::find("memory_source_test", &data, &bytes));
+    Memory_Signal_Buffers::add("memory_source_test", samples, sizeof(samples));
+    ASSERT_TRUE(Memory_Signal_Buffers::find("memory_source_test", &data, &bytes));
+    EXPECT_EQ(static_cast<const void*>(samples), data);
+    EXPECT_EQ(sizeof(samples), bytes);
+    Memory_Signal_Buffers::remove("memory_source_test");
+    EXPECT_FALSE(Memory_Signal_Buffers::find("memory_source_test", &data, &bytes));
+
+    EXPECT_THROW({make_memory_source(sizeof(int16_t), samples, 1, 0, false);}, std::runtime_error);
+}
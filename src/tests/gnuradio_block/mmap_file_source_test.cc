@@ -0,0 +1,117 @@
+/*!
+ * \file mmap_file_source_test.cc
+ * \brief Tests of the memory mapped file source.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/head.h>
+#include <gnuradio/blocks/vector_sink_s.h>
+#include "mmap_file_source.h"
+
+namespace
+{
+// Writes n_samples shorts, sample i with value i, after a header of header_bytes
+std::string write_mmap_test_file(unsigned int header_bytes, unsigned int n_samples)
+{
+    std::string filename = "./mmap_file_source_test.dat";
+    std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary);
+    std::vector<char> header(header_bytes, 0x7f);
+    file.write(header.data(), header.size());
+    for (unsigned int i = 0; i < n_samples; i++)
+        {
+            int16_t sample = static_cast<int16_t>(i);
+            file.write(reinterpret_cast<const char *>(&sample), sizeof(int16_t));
+        }
+    // a last incomplete sample, which is not output
+    file.write("\x01", 1);
+    return filename;
+}
+}
+
+
+TEST(Mmap_File_Source_Test, ReadsTheWholeFileAfterTheOffset)
+{
+    // 3 windows of 2 MB, the smallest size
+    const unsigned int n_samples = 2500000;
+    std::string filename = write_mmap_test_file(6, n_samples);
+    gr::top_block_sptr top_block = gr::make_top_block("mmap_file_source_test");
+    mmap_file_source_sptr source = make_mmap_file_source(sizeof(int16_t), filename, 6, false, 1);
+    gr::blocks::vector_sink_s::sptr sink = gr::blocks::vector_sink_s::make();
+    EXPECT_EQ(n_samples, source->items());
+
+    top_block->connect(source, 0, sink, 0);
+    top_block->run();
+
+    std::vector<short> data = sink->data();
+    ASSERT_EQ(n_samples, data.size());
+    bool all_equal = true;
+    for (unsigned int i = 0; i < n_samples; i++)
+        {
+            all_equal = all_equal && data[i] == static_cast<int16_t>(i);
+        }
+    EXPECT_TRUE(all_equal);
+    std::remove(filename.c_str());
+}
+
+
+TEST(Mmap_File_Source_Test, Repeat)
+{
+    const unsigned int n_samples = 1000;
+    std::string filename = write_mmap_test_file(0, n_samples);
+    gr::top_block_sptr top_block = gr::make_top_block("mmap_file_source_test");
+    mmap_file_source_sptr source = make_mmap_file_source(sizeof(int16_t), filename, 0, true);
+    gr::blocks::head::sptr head = gr::blocks::head::make(sizeof(int16_t), 3 * n_samples + 10);
+    gr::blocks::vector_sink_s::sptr sink = gr::blocks::vector_sink_s::make();
+
+    top_block->connect(source, 0, head, 0);
+    top_block->connect(head, 0, sink, 0);
+    top_block->run();
+
+    std::vector<short> data = sink->data();
+    ASSERT_EQ(3 * n_samples + 10, data.size());
+    bool all_equal = true;
+    for (unsigned int i = 0; i < data.size(); i++)
+        {
+            all_equal = all_equal && data[i] == static_cast<int16_t>(i % n_samples);
+        }
+    EXPECT_TRUE(all_equal);
+    std::remove(filename.c_str());
+}
+
+
+TEST(Mmap_File_Source_Test, FileNotExists)
+{
+    EXPECT_THROW({make_mmap_file_source(sizeof(int16_t), "./i_dont_exist.dat", 0, false);}, std::runtime_error);
+}
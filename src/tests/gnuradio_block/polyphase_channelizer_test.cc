@@ -0,0 +1,150 @@
+/*!
+ * \file polyphase_channelizer_test.cc
+ * \brief Tests of the polyphase_channelizer block
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/vector_source_c.h>
+#include <gnuradio/blocks/vector_source_s.h>
+#include <gnuradio/blocks/vector_sink_c.h>
+#include <gnuradio/filter/firdes.h>
+#include "polyphase_channelizer.h"
+
+
+namespace
+{
+// Tone at each of the given frequencies, amplitude 1000
+std::vector<gr_complex> tones(const std::vector<double> & freqs, double fs, unsigned int n_samples)
+{
+    std::vector<gr_complex> samples(n_samples, gr_complex(0.0, 0.0));
+    for (unsigned int n = 0; n < n_samples; n++)
+        {
+            for (unsigned int i = 0; i < freqs.size(); i++)
+                {
+                    samples[n] += std::polar(1000.0f, static_cast<float>(2.0 * M_PI * std::fmod(freqs[i] * n / fs, 1.0)));
+                }
+        }
+    return samples;
+}
+
+// Largest distance to a tone of the given frequency at the output rate, after the transient
+double tone_error(const std::vector<gr_complex> & data, double freq, double fs_out, unsigned int first)
+{
+    const gr_complex phase = data.at(first) / std::polar(1.0f, static_cast<float>(2.0 * M_PI * std::fmod(freq * first / fs_out, 1.0)));
+    double max_error = 0.0;
+    for (unsigned int m = first; m < data.size(); m++)
+        {
+            const gr_complex expected = 1000.0f * phase / std::abs(phase)
+                    * std::polar(1.0f, static_cast<float>(2.0 * M_PI * std::fmod(freq * m / fs_out, 1.0)));
+            max_error = std::max(max_error, static_cast<double>(std::abs(data[m] - expected)));
+        }
+    return max_error;
+}
+}
+
+
+TEST(Polyphase_Channelizer_Test, TranslatesEachSubBandToBaseband)
+{
+    const double fs = 16000000.0;
+    const unsigned int channels = 8;
+    const unsigned int decimation = 4;
+    const double fs_out = fs / decimation;
+    const unsigned int n_samples = 80000;
+    // the second band falls between two channels
+    std::vector<double> sub_bands = { 4000000.0, -5100000.0 };
+    const double offset = 50000.0;
+    std::vector<double> freqs = { sub_bands[0] + offset, sub_bands[1] - offset };
+
+    std::vector<float> taps = gr::filter::firdes::low_pass(1.0, fs, 0.4 * fs_out, 0.1 * fs_out, gr::filter::firdes::WIN_BLACKMAN);
+    gr::top_block_sptr top_block = gr::make_top_block("polyphase_channelizer_test");
+    gr::blocks::vector_source_c::sptr source = gr::blocks::vector_source_c::make(tones(freqs, fs, n_samples));
+    polyphase_channelizer_sptr channelizer = make_polyphase_channelizer(false, channels, decimation, taps, sub_bands, fs);
+    gr::blocks::vector_sink_c::sptr sink0 = gr::blocks::vector_sink_c::make();
+    gr::blocks::vector_sink_c::sptr sink1 = gr::blocks::vector_sink_c::make();
+
+    top_block->connect(source, 0, channelizer, 0);
+    top_block->connect(channelizer, 0, sink0, 0);
+    top_block->connect(channelizer, 1, sink1, 0);
+    top_block->run();
+
+    EXPECT_EQ(2u, channelizer->bin(0));
+    EXPECT_EQ(5u, channelizer->bin(1));
+    std::vector<gr_complex> data0 = sink0->data();
+    std::vector<gr_complex> data1 = sink1->data();
+    ASSERT_EQ(n_samples / decimation, data0.size());
+    ASSERT_EQ(n_samples / decimation, data1.size());
+    // each output holds its own tone, and the other one is rejected by the prototype
+    EXPECT_LT(tone_error(data0, offset, fs_out, 1000), 5.0);
+    EXPECT_LT(tone_error(data1, -offset, fs_out, 1000), 5.0);
+}
+
+
+TEST(Polyphase_Channelizer_Test, ShortInputGivesTheSameOutput)
+{
+    const double fs = 8000000.0;
+    const unsigned int n_samples = 20000;
+    std::vector<double> sub_bands = { 1000000.0 };
+    std::vector<gr_complex> samples = tones(std::vector<double>(1, 1020000.0), fs, n_samples);
+    std::vector<short> interleaved;
+    for (unsigned int n = 0; n < n_samples; n++)
+        {
+            samples[n] = gr_complex(std::round(samples[n].real()), std::round(samples[n].imag()));
+            interleaved.push_back(static_cast<short>(samples[n].real()));
+            interleaved.push_back(static_cast<short>(samples[n].imag()));
+        }
+    std::vector<float> taps = gr::filter::firdes::low_pass(1.0, fs, 400000.0, 200000.0, gr::filter::firdes::WIN_BLACKMAN);
+
+    gr::top_block_sptr top_block = gr::make_top_block("polyphase_channelizer_test");
+    gr::blocks::vector_source_c::sptr source_c = gr::blocks::vector_source_c::make(samples);
+    gr::blocks::vector_source_s::sptr source_s = gr::blocks::vector_source_s::make(interleaved, false, 2);
+    polyphase_channelizer_sptr channelizer_c = make_polyphase_channelizer(false, 8, 8, taps, sub_bands, fs);
+    polyphase_channelizer_sptr channelizer_s = make_polyphase_channelizer(true, 8, 8, taps, sub_bands, fs);
+    gr::blocks::vector_sink_c::sptr sink_c = gr::blocks::vector_sink_c::make();
+    gr::blocks::vector_sink_c::sptr sink_s = gr::blocks::vector_sink_c::make();
+
+    top_block->connect(source_c, 0, channelizer_c, 0);
+    top_block->connect(channelizer_c, 0, sink_c, 0);
+    top_block->connect(source_s, 0, channelizer_s, 0);
+    top_block->connect(channelizer_s, 0, sink_s, 0);
+    top_block->run();
+
+    std::vector<gr_complex> data_c = sink_c->data();
+    std::vector<gr_complex> data_s = sink_s->data();
+    ASSERT_EQ(n_samples / 8, data_c.size());
+    ASSERT_EQ(data_c.size(), data_s.size());
+    for (unsigned int m = 0; m < data_c.size(); m++)
+        {
+            ASSERT_LT(std::abs(data_c[m] - data_s[m]), 0.01);
+        }
+    EXPECT_LT(tone_error(data_c, 20000.0, fs / 8, 500), 5.0);
+}
@@ -0,0 +1,174 @@
+/*!
+ * \file udp_sample_source_test.cc
+ * \brief Tests of the UDP packet parser and of the UDP sample source
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <boost/asio.hpp>
+#include <gtest/gtest.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/head.h>
+#include <gnuradio/blocks/vector_sink_s.h>
+#include "udp_packet_parser.h"
+#include "udp_sample_source.h"
+
+namespace
+{
+void put_be32(std::vector<unsigned char> & packet, uint32_t word)
+{
+    packet.push_back(word >> 24);
+    packet.push_back(word >> 16);
+    packet.push_back(word >> 8);
+    packet.push_back(word);
+}
+
+// IF data packet with a stream id, an integer timestamp and a trailer, of
+// big-endian 16-bit samples, the ones of each packet from first to first + n
+std::vector<unsigned char> vita49_packet(unsigned int count, uint32_t stream_id, int16_t first, unsigned int n)
+{
+    const unsigned int words = 1 + 1 + 1 + n + 1;
+    std::vector<unsigned char> packet;
+    put_be32(packet, (1u << 28) | (1u << 26) | (1u << 22) | ((count & 0xF) << 16) | words);
+    put_be32(packet, stream_id);
+    put_be32(packet, 1234567);
+    for (unsigned int i = 0; i < n; i++)
+        {
+            put_be32(packet, (static_cast<uint32_t>(static_cast<uint16_t>(first + i)) << 16)
+                    | static_cast<uint16_t>(-(first + i)));
+        }
+    put_be32(packet, 0);
+    return packet;
+}
+}
+
+
+TEST(Udp_Sample_Source_Test, Vita49Packets)
+{
+    const std::vector<unsigned char> data = vita49_packet(5, 0xCAFE, 0, 10);
+    Udp_Packet packet;
+    ASSERT_TRUE(udp_parse_packet(data.data(), data.size(), UDP_PAYLOAD_VITA49, packet));
+    EXPECT_EQ(12u, packet.payload_offset);
+    EXPECT_EQ(40u, packet.payload_bytes);
+    EXPECT_TRUE(packet.has_stream_id);
+    EXPECT_EQ(0xCAFEu, packet.stream_id);
+    EXPECT_TRUE(packet.has_sequence);
+    EXPECT_EQ(5u, packet.sequence);
+
+    // padded datagrams are fine, truncated ones and context packets are not
+    std::vector<unsigned char> padded = data;
+    padded.resize(data.size() + 8);
+    EXPECT_TRUE(udp_parse_packet(padded.data(), padded.size(), UDP_PAYLOAD_VITA49, packet));
+    EXPECT_FALSE(udp_parse_packet(data.data(), data.size() - 4, UDP_PAYLOAD_VITA49, packet));
+    std::vector<unsigned char> context = data;
+    context[0] = 0x40;
+    EXPECT_FALSE(udp_parse_packet(context.data(), context.size(), UDP_PAYLOAD_VITA49, packet));
+
+    ASSERT_TRUE(udp_parse_packet(data.data(), data.size(), UDP_PAYLOAD_RAW, packet));
+    EXPECT_EQ(0u, packet.payload_offset);
+    EXPECT_EQ(data.size(), packet.payload_bytes);
+    EXPECT_FALSE(packet.has_sequence);
+
+    Udp_Payload_Format format;
+    EXPECT_TRUE(udp_payload_format("vita49", format));
+    EXPECT_EQ(UDP_PAYLOAD_VITA49, format);
+    EXPECT_FALSE(udp_payload_format("vrt", format));
+}
+
+
+TEST(Udp_Sample_Source_Test, SequenceGaps)
+{
+    Udp_Sequence_Tracker tracker;
+    Udp_Packet packet;
+    packet.has_sequence = true;
+    packet.sequence_modulo = 16;
+    // 14, 15, 0 in order, 3 after two lost, 2 late, 4, then 9 after four lost
+    const unsigned int sequence[] = {14, 15, 0, 3, 2, 4, 9};
+    const unsigned int expected_lost[] = {0, 0, 0, 2, 0, 0, 4};
+    for (unsigned int i = 0; i < 7; i++)
+        {
+            packet.sequence = sequence[i];
+            EXPECT_EQ(expected_lost[i], tracker.next(packet)) << "packet " << i;
+        }
+    EXPECT_EQ(7u, tracker.packets());
+    EXPECT_EQ(6u, tracker.lost_packets());
+    EXPECT_EQ(2u, tracker.gaps());
+}
+
+
+TEST(Udp_Sample_Source_Test, ReceivesVita49)
+{
+    const unsigned int samples_per_packet = 100;
+    const unsigned int packets = 20;
+    gr::top_block_sptr top_block = gr::make_top_block("udp_sample_source_test");
+    udp_sample_source_sptr source = make_udp_sample_source("127.0.0.1", 0, UDP_PAYLOAD_VITA49, 16,
+            true, false, 8, 9000, 1024 * 1024, 1024 * 1024, gr::msg_queue::sptr());
+    // cshort items, as pairs of shorts
+    gr::blocks::head::sptr head = gr::blocks::head::make(sizeof(int16_t), 2 * (packets - 1) * samples_per_packet);
+    gr::blocks::vector_sink_s::sptr sink = gr::blocks::vector_sink_s::make();
+    top_block->connect(source, 0, head, 0);
+    top_block->connect(head, 0, sink, 0);
+    top_block->start();
+    ASSERT_NE(0, source->port());
+
+    // packet 7 is lost, and the packets of another stream are dropped
+    boost::asio::io_service io_service;
+    boost::asio::ip::udp::socket socket(io_service, boost::asio::ip::udp::endpoint(boost::asio::ip::udp::v4(), 0));
+    const boost::asio::ip::udp::endpoint destination(boost::asio::ip::address::from_string("127.0.0.1"), source->port());
+    for (unsigned int p = 0; p < packets; p++)
+        {
+            if (p == 7) continue;
+            const std::vector<unsigned char> data = vita49_packet(p, 0x1234, p * samples_per_packet, samples_per_packet);
+            socket.send_to(boost::asio::buffer(data), destination);
+            const std::vector<unsigned char> other = vita49_packet(p, 0x4321, 0, samples_per_packet);
+            socket.send_to(boost::asio::buffer(other), destination);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    top_block->wait();
+    top_block->stop();
+
+    EXPECT_EQ(1u, source->lost_packets());
+    EXPECT_EQ(0u, source->overflows());
+    EXPECT_EQ(0u, source->invalid_packets());
+    const std::vector<short> data = sink->data();
+    ASSERT_EQ(2 * (packets - 1) * samples_per_packet, data.size());
+    bool all_equal = true;
+    unsigned int i = 0;
+    for (unsigned int p = 0; p < packets; p++)
+        {
+            if (p == 7) continue;
+            for (unsigned int k = 0; k < samples_per_packet; k++, i++)
+                {
+                    const short value = static_cast<short>(p * samples_per_packet + k);
+                    all_equal = all_equal && data[2 * i] == value && data[2 * i + 1] == -value;
+                }
+        }
+    EXPECT_TRUE(all_equal);
+}
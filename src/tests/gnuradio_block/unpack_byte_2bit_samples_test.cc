@@ -0,0 +1,324 @@
+/*!
+ * \file unpack_byte_2bit_samples_test.cc
+ * \brief  This file implements unit tests for the 2-bit sample unpackers
+ *  against the bitfield implementation they replaced
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/vector_source_b.h>
+#include <gnuradio/blocks/vector_source_s.h>
+#include <gnuradio/blocks/vector_sink_b.h>
+#include <gnuradio/blocks/vector_sink_s.h>
+#include <gnuradio/blocks/vector_sink_f.h>
+#include <volk_gnsssdr/volk_gnsssdr.h>
+#include "unpack_2bit_samples.h"
+#include "unpack_byte_2bit_samples.h"
+#include "unpack_byte_2bit_cpx_samples.h"
+
+
+namespace
+{
+/*
+ * Reference outputs: the per-sample bitfield unpacking used by the blocks
+ * before the VOLK_GNSSSDR kernels
+ */
+struct bitfield_2bit_sample
+{
+    signed two_bit_sample:2;  // <- 2 bits wide only
+};
+
+struct bitfield_byte_2bit_struct
+{
+    signed sample_0:2;  // <- 2 bits wide only
+    signed sample_1:2;  // <- 2 bits wide only
+    signed sample_2:2;  // <- 2 bits wide only
+    signed sample_3:2;  // <- 2 bits wide only
+};
+
+union bitfield_byte_and_samples
+{
+    int8_t byte;
+    bitfield_byte_2bit_struct samples;
+};
+
+
+std::vector<float> bitfield_unpack_byte_2bit_samples(const std::vector<unsigned char> & in)
+{
+    std::vector<float> out;
+    bitfield_2bit_sample sample;
+    for(unsigned int i = 0; i < in.size(); i++)
+        {
+            signed char c = static_cast<signed char>(in[i]);
+            sample.two_bit_sample = c & 3;
+            out.push_back(static_cast<float>(sample.two_bit_sample));
+            sample.two_bit_sample = (c >> 2) & 3;
+            out.push_back(static_cast<float>(sample.two_bit_sample));
+            sample.two_bit_sample = (c >> 4) & 3;
+            out.push_back(static_cast<float>(sample.two_bit_sample));
+            sample.two_bit_sample = (c >> 6) & 3;
+            out.push_back(static_cast<float>(sample.two_bit_sample));
+        }
+    return out;
+}
+
+
+std::vector<short> bitfield_unpack_byte_2bit_cpx_samples(const std::vector<unsigned char> & in)
+{
+    std::vector<short> out;
+    bitfield_2bit_sample sample;
+    for(unsigned int i = 0; i < in.size(); i++)
+        {
+            // I/Q swap: I[n], Q[n], I[n+1], Q[n+1]
+            signed char c = static_cast<signed char>(in[i]);
+            sample.two_bit_sample = (c >> 4) & 3;
+            out.push_back(2 * static_cast<short>(sample.two_bit_sample) + 1);
+            sample.two_bit_sample = (c >> 6) & 3;
+            out.push_back(2 * static_cast<short>(sample.two_bit_sample) + 1);
+            sample.two_bit_sample = c & 3;
+            out.push_back(2 * static_cast<short>(sample.two_bit_sample) + 1);
+            sample.two_bit_sample = (c >> 2) & 3;
+            out.push_back(2 * static_cast<short>(sample.two_bit_sample) + 1);
+        }
+    return out;
+}
+
+
+bool bitfield_system_is_big_endian()
+{
+    union
+    {
+        uint32_t i;
+        char c[4];
+    } test_int = {0x01020304};
+    return test_int.c[0] == 1;
+}
+
+
+bool bitfield_system_bytes_are_big_endian()
+{
+    bitfield_byte_and_samples b;
+    b.byte = static_cast<int8_t>(0x1B);
+    return b.samples.sample_0 == 0x3;
+}
+
+
+std::vector<int8_t> bitfield_unpack_2bit_samples(const std::vector<unsigned char> & in,
+                                                 bool big_endian_bytes,
+                                                 size_t item_size,
+                                                 bool big_endian_items,
+                                                 bool reverse_interleaving)
+{
+    std::vector<unsigned char> bytes(in);
+    if((item_size > 1) && (bitfield_system_is_big_endian() != big_endian_items))
+        {
+            for(unsigned int i = 0; i + item_size <= bytes.size(); i += item_size)
+                {
+                    std::reverse(bytes.begin() + i, bytes.begin() + i + item_size);
+                }
+        }
+    bool swap_endian_bytes = (bitfield_system_bytes_are_big_endian() != big_endian_bytes);
+
+    std::vector<int8_t> out;
+    bitfield_byte_and_samples raw_byte;
+    for(unsigned int i = 0; i < bytes.size(); i++)
+        {
+            raw_byte.byte = static_cast<int8_t>(bytes[i]);
+            int s[4] = { raw_byte.samples.sample_0, raw_byte.samples.sample_1,
+                         raw_byte.samples.sample_2, raw_byte.samples.sample_3 };
+            int order[4] = { 0, 1, 2, 3 };
+            if(!reverse_interleaving && swap_endian_bytes)
+                {
+                    order[0] = 3; order[1] = 2; order[2] = 1; order[3] = 0;
+                }
+            else if(reverse_interleaving && swap_endian_bytes)
+                {
+                    order[0] = 2; order[1] = 3; order[2] = 0; order[3] = 1;
+                }
+            else if(reverse_interleaving)
+                {
+                    order[0] = 1; order[1] = 0; order[2] = 3; order[3] = 2;
+                }
+            for(int k = 0; k < 4; k++)
+                {
+                    out.push_back(static_cast<int8_t>(2 * s[order[k]] + 1));
+                }
+        }
+    return out;
+}
+
+
+/*
+ * Every byte value, then random bytes up to an odd length, so that the
+ * kernels run through their SIMD loops and their scalar tails
+ */
+std::vector<unsigned char> unpack_2bit_test_bytes()
+{
+    std::vector<unsigned char> bytes;
+    for(int i = 0; i < 256; i++)
+        {
+            bytes.push_back(static_cast<unsigned char>(i));
+        }
+    std::mt19937 generator(2016);
+    std::uniform_int_distribution<int> byte_value(0, 255);
+    for(int i = 0; i < 4093; i++)
+        {
+            bytes.push_back(static_cast<unsigned char>(byte_value(generator)));
+        }
+    return bytes;
+}
+}
+
+
+TEST(Unpack_Byte_2bit_Samples_Test, KernelsMatchBitfieldSamples)
+{
+    std::vector<unsigned char> bytes = unpack_2bit_test_bytes();
+    std::vector<int8_t> lsb_first = bitfield_unpack_2bit_samples(bytes, false, 1, false, false);
+    std::vector<int8_t> msb_first = bitfield_unpack_2bit_samples(bytes, true, 1, false, false);
+
+    for(unsigned int num_points = 0; num_points <= 200; num_points++)
+        {
+            std::vector<char> out(num_points + 1, 0);
+            volk_gnsssdr_8u_unpack2bit_8i(&out[0], &bytes[0], num_points);
+            for(unsigned int n = 0; n < num_points; n++)
+                {
+                    ASSERT_EQ(lsb_first[n], static_cast<int8_t>(out[n])) << "lsb first, " << num_points << " points, sample " << n;
+                }
+
+            volk_gnsssdr_8u_unpack2bitmsb_8i(&out[0], &bytes[0], num_points);
+            for(unsigned int n = 0; n < num_points; n++)
+                {
+                    ASSERT_EQ(msb_first[n], static_cast<int8_t>(out[n])) << "msb first, " << num_points << " points, sample " << n;
+                }
+        }
+}
+
+
+TEST(Unpack_Byte_2bit_Samples_Test, ByteSamplesMatchBitfieldSamples)
+{
+    std::vector<unsigned char> bytes = unpack_2bit_test_bytes();
+    std::vector<float> expected = bitfield_unpack_byte_2bit_samples(bytes);
+
+    gr::top_block_sptr top_block = gr::make_top_block("unpack_byte_2bit_samples_test");
+    gr::blocks::vector_source_b::sptr source = gr::blocks::vector_source_b::make(bytes);
+    unpack_byte_2bit_samples_sptr unpacker = make_unpack_byte_2bit_samples();
+    gr::blocks::vector_sink_f::sptr sink = gr::blocks::vector_sink_f::make();
+
+    top_block->connect(source, 0, unpacker, 0);
+    top_block->connect(unpacker, 0, sink, 0);
+    top_block->run();
+    top_block->stop();
+
+    std::vector<float> unpacked = sink->data();
+    ASSERT_EQ(expected.size(), unpacked.size());
+    for(unsigned int n = 0; n < expected.size(); n++)
+        {
+            ASSERT_EQ(expected[n], unpacked[n]) << "sample " << n;
+        }
+}
+
+
+TEST(Unpack_Byte_2bit_Samples_Test, CpxSamplesMatchBitfieldSamples)
+{
+    std::vector<unsigned char> bytes = unpack_2bit_test_bytes();
+    std::vector<short> expected = bitfield_unpack_byte_2bit_cpx_samples(bytes);
+
+    gr::top_block_sptr top_block = gr::make_top_block("unpack_byte_2bit_cpx_samples_test");
+    gr::blocks::vector_source_b::sptr source = gr::blocks::vector_source_b::make(bytes);
+    unpack_byte_2bit_cpx_samples_sptr unpacker = make_unpack_byte_2bit_cpx_samples();
+    gr::blocks::vector_sink_s::sptr sink = gr::blocks::vector_sink_s::make();
+
+    top_block->connect(source, 0, unpacker, 0);
+    top_block->connect(unpacker, 0, sink, 0);
+    top_block->run();
+    top_block->stop();
+
+    std::vector<short> unpacked = sink->data();
+    ASSERT_EQ(expected.size(), unpacked.size());
+    for(unsigned int n = 0; n < expected.size(); n++)
+        {
+            ASSERT_EQ(expected[n], unpacked[n]) << "sample " << n;
+        }
+}
+
+
+TEST(Unpack_Byte_2bit_Samples_Test, PackedSamplesMatchBitfieldSamples)
+{
+    std::vector<unsigned char> bytes = unpack_2bit_test_bytes();
+    bytes.pop_back();  // whole shorts for item_size = 2
+
+    for(size_t item_size = 1; item_size <= 2; item_size++)
+        {
+            for(int options = 0; options < 8; options++)
+                {
+                    bool big_endian_bytes = options & 1;
+                    bool big_endian_items = options & 2;
+                    bool reverse_interleaving = options & 4;
+                    std::vector<int8_t> expected = bitfield_unpack_2bit_samples(bytes, big_endian_bytes, item_size, big_endian_items, reverse_interleaving);
+
+                    gr::top_block_sptr top_block = gr::make_top_block("unpack_2bit_samples_test");
+                    boost::shared_ptr<gr::block> unpacker = make_unpack_2bit_samples(big_endian_bytes,
+                            item_size,
+                            big_endian_items,
+                            reverse_interleaving);
+                    gr::blocks::vector_sink_b::sptr sink = gr::blocks::vector_sink_b::make();
+                    if(item_size == 1)
+                        {
+                            gr::blocks::vector_source_b::sptr source = gr::blocks::vector_source_b::make(bytes);
+                            top_block->connect(source, 0, unpacker, 0);
+                        }
+                    else
+                        {
+                            std::vector<short> items(bytes.size() / 2);
+                            std::memcpy(&items[0], &bytes[0], bytes.size());
+                            gr::blocks::vector_source_s::sptr source = gr::blocks::vector_source_s::make(items);
+                            top_block->connect(source, 0, unpacker, 0);
+                        }
+                    top_block->connect(unpacker, 0, sink, 0);
+                    top_block->run();
+                    top_block->stop();
+
+                    std::vector<unsigned char> unpacked = sink->data();
+                    ASSERT_EQ(expected.size(), unpacked.size());
+                    for(unsigned int n = 0; n < expected.size(); n++)
+                        {
+                            ASSERT_EQ(expected[n], static_cast<int8_t>(unpacked[n])) << "item_size " << item_size
+                                    << ", big_endian_bytes " << big_endian_bytes
+                                    << ", big_endian_items " << big_endian_items
+                                    << ", reverse_interleaving " << reverse_interleaving
+                                    << ", sample " << n;
+                        }
+                }
+        }
+}
@@ -75,30 +75,109 @@ DECLARE_string(log_dir);
 #include "arithmetic/multiply_test.cc"
 #include "arithmetic/code_generation_test.cc"
 #include "arithmetic/tracking_loop_filter_test.cc"
+#include "arithmetic/carrier_rotator_test.cc"
+#include "arithmetic/lock_detectors_test.cc"
+#include "arithmetic/preamble_correlator_test.cc"
+#include "arithmetic/ring_buffer_test.cc"
+#include "arithmetic/realtime_monitor_test.cc"
+#include "arithmetic/gnss_sdr_numa_test.cc"
+#include "arithmetic/gnss_sdr_allocation_tracker_test.cc"
+#include "arithmetic/latency_tracer_test.cc"
+#include "arithmetic/hw_counters_test.cc"
+#include "arithmetic/memory_accounting_test.cc"
+#include "arithmetic/trace_test.cc"
+#include "arithmetic/buffer_tuning_test.cc"
+#include "arithmetic/viterbi_decoder_test.cc"
+#include "arithmetic/galileo_page_deinterleaver_test.cc"
+#include "arithmetic/crc24q_frame_detector_test.cc"
+#include "arithmetic/telemetry_output_decimator_test.cc"
+#include "arithmetic/observables_sync_test.cc"
+#include "arithmetic/kepler_orbit_test.cc"
+#include "arithmetic/satellite_orbit_batch_test.cc"
+#include "arithmetic/ls_pvt_test.cc"
+#include "arithmetic/ls_pvt_raim_test.cc"
+#include "arithmetic/pvt_corrections_cache_test.cc"
+#include "arithmetic/batch_ls_pvt_test.cc"
+#include "arithmetic/track_file_writer_test.cc"
+#include "arithmetic/gnss_nav_data_store_test.cc"
+#include "arithmetic/gnss_satellite_scheduler_test.cc"
+#include "arithmetic/channel_shedding_test.cc"
+#include "arithmetic/gnss_source_alignment_test.cc"
+#include "arithmetic/gnss_receiver_state_test.cc"
+#include "arithmetic/concurrent_queue_test.cc"
+#include "arithmetic/pvt_output_writer_test.cc"
+#include "arithmetic/pvt_solver_thread_test.cc"
+#include "arithmetic/pvt_file_rotation_test.cc"
 #include "arithmetic/fft_length_test.cc"
+#include "arithmetic/fft_code_cache_test.cc"
+#include "arithmetic/gnss_code_bank_test.cc"
+#include "arithmetic/input_spectrum_store_test.cc"
+#include "arithmetic/fixed_point_fft_test.cc"
+#include "arithmetic/pcps_search_core_test.cc"
+#include "arithmetic/acquisition_assistance_test.cc"
+#include "arithmetic/gnss_sample_ring_test.cc"
+#include "arithmetic/gnss_sample_capture_test.cc"
+#include "arithmetic/coarse_time_navigation_test.cc"
 #include "configuration/file_configuration_test.cc"
 #include "configuration/in_memory_configuration_test.cc"
+#include "configuration/namespaced_configuration_test.cc"
 #include "control_thread/control_message_factory_test.cc"
+#include "control_thread/control_event_bus_test.cc"
+#include "control_thread/channel_fsm_test.cc"
+#include "control_thread/gnss_metrics_server_test.cc"
+#include "control_thread/gnss_assistance_cache_test.cc"
 #include "control_thread/control_thread_test.cc"
+#include "control_thread/batch_processor_test.cc"
 #include "flowgraph/pass_through_test.cc"
 #include "flowgraph/gnss_flowgraph_test.cc"
 #include "formats/string_converter_test.cc"
 #include "formats/rtcm_test.cc"
+#include "formats/crc24q_test.cc"
+#include "formats/rtcm_stream_parser_test.cc"
+#include "formats/binary_dump_test.cc"
+#include "formats/packed_bits_test.cc"
+#include "formats/gps_navigation_message_encoder_test.cc"
+#include "formats/rinex_stitcher_test.cc"
+#include "formats/rinex_printer_formatting_test.cc"
+#include "formats/observables_stream_test.cc"
+#include "formats/rinex_observables_reader_test.cc"
+#include "formats/tracking_dump_replay_test.cc"
+#include "formats/remote_acquisition_protocol_test.cc"
+#include "formats/compressed_capture_test.cc"
 #include "gnss_block/gnss_block_factory_test.cc"
 #include "gnss_block/rtcm_printer_test.cc"
 #include "gnss_block/file_signal_source_test.cc"
 #include "gnss_block/fir_filter_test.cc"
+#include "gnss_block/fft_fir_filter_test.cc"
 #include "gnss_block/gps_l1_ca_pcps_acquisition_test.cc"
+#include "gnss_block/gps_l1_ca_pcps_fixed_point_acquisition_test.cc"
+#include "gnss_block/gps_l1_ca_pcps_shifted_spectrum_acquisition_test.cc"
 #include "gnss_block/gps_l2_m_pcps_acquisition_test.cc"
+#include "gnss_block/gps_l2_m_pcps_segmented_acquisition_test.cc"
 #include "gnss_block/gps_l1_ca_pcps_acquisition_gsoc2013_test.cc"
 //#include "gnss_block/gps_l1_ca_pcps_multithread_acquisition_gsoc2013_test.cc"
 #include "arithmetic/cpu_multicorrelator_test.cc"
+#include "arithmetic/tracking_engine_test.cc"
+#include "arithmetic/multichannel_correlator_test.cc"
+#include "arithmetic/multichannel_loop_filters_test.cc"
+#include "arithmetic/shm_loop_connector_test.cc"
+#include "arithmetic/pulse_blanker_test.cc"
+#include "arithmetic/acquisition_decimator_test.cc"
+#include "arithmetic/sample_requantizer_test.cc"
+#include "arithmetic/gnss_sdr_event_log_test.cc"
+#include "arithmetic/moving_window_statistics_test.cc"
+#include "arithmetic/nmea_buffer_test.cc"
+#include "arithmetic/correlator_backend_scheduler_test.cc"
+#include "arithmetic/task_pool_test.cc"
 #if OPENCL_BLOCKS_TEST
 #include "gnss_block/gps_l1_ca_pcps_opencl_acquisition_gsoc2013_test.cc"
 #endif
 
 #if CUDA_BLOCKS_TEST
 	#include "arithmetic/gpu_multicorrelator_test.cc"
+	#include "arithmetic/gpu_multichannel_correlator_test.cc"
+	#include "arithmetic/gpu_acquisition_engine_test.cc"
+	#include "arithmetic/gpu_tracking_service_test.cc"
 #endif
 
 #include "gnss_block/gps_l1_ca_pcps_quicksync_acquisition_gsoc2014_test.cc"
@@ -113,9 +192,21 @@ DECLARE_string(log_dir);
 #include "gnss_block/galileo_e1_dll_pll_veml_tracking_test.cc"
 #include "gnuradio_block/gnss_sdr_valve_test.cc"
 #include "gnuradio_block/direct_resampler_conditioner_cc_test.cc"
+#include "gnuradio_block/mmap_file_source_test.cc"
+#include "gnuradio_block/memory_source_test.cc"
+#include "gnuradio_block/udp_sample_source_test.cc"
+#include "gnuradio_block/fused_conditioner_test.cc"
+#include "gnuradio_block/polyphase_channelizer_test.cc"
+#include "gnuradio_block/fractional_resampler_test.cc"
+#include "gnuradio_block/beamformer_test.cc"
+#include "gnuradio_block/beam_steering_test.cc"
+#include "gnuradio_block/gnss_sdr_overflow_monitor_test.cc"
+#include "gnuradio_block/unpack_byte_2bit_samples_test.cc"
 #include "gnss_block/galileo_e5a_pcps_acquisition_gsoc2014_gensource_test.cc"
 #include "gnss_block/galileo_e5a_tracking_test.cc"
 #include "gnss_block/gps_l2_m_dll_pll_tracking_test.cc"
+#include "gnss_block/gps_l1_ca_dll_pll_tracking_group_test.cc"
+#include "gnss_block/tracking_cshort_test.cc"
 
 
 // For GPS NAVIGATION (L1)
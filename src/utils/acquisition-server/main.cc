@@ -0,0 +1,281 @@
+/*!
+ * \file main.cc
+ * \brief Acquisition server for the GPS_L1_CA_PCPS_Remote_Acquisition blocks
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Accepts the connections of any number of receivers and searches the
+ * snapshots they send (see remote_acquisition_protocol.h) on a pool of
+ * worker threads, so that the cold starts of many edge receivers share one
+ * large machine. Each snapshot is searched by a FrontEndCalSearch, whose
+ * Doppler grid is kept for the next snapshots with the same parameters.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include <boost/asio.hpp>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include "front_end_cal_search.h"
+#include "remote_acquisition_protocol.h"
+
+using google::LogMessage;
+
+DEFINE_int32(port, 2103, "TCP port of the server");
+DEFINE_int32(threads, 0, "Worker threads (0: one per hardware thread)");
+
+
+// Connection of one receiver. The workers send the replies in any order.
+class Session
+{
+public:
+    explicit Session(boost::asio::io_service & io_service) : socket(io_service), open(true) {}
+
+    void send(const std::string & frame)
+    {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        if (!open) return;
+        boost::system::error_code ec;
+        boost::asio::write(socket, boost::asio::buffer(frame), ec);
+        if (ec) open = false;
+    }
+
+    boost::asio::ip::tcp::socket socket;
+    std::mutex write_mutex;
+    bool open;
+};
+
+
+struct Job
+{
+    std::shared_ptr<Session> session;
+    Remote_Acquisition_Request request;
+};
+
+
+class Search_Server
+{
+public:
+    explicit Search_Server(unsigned int threads) : d_stop(false)
+    {
+        for (unsigned int t = 0; t < threads; t++)
+            {
+                d_workers.push_back(std::thread([this]() { work(); }));
+            }
+    }
+
+    ~Search_Server()
+    {
+        {
+            std::lock_guard<std::mutex> lock(d_mutex);
+            d_stop = true;
+        }
+        d_ready.notify_all();
+        for (auto & t : d_workers)
+            {
+                t.join();
+            }
+    }
+
+    void push(const std::shared_ptr<Session> & session, Remote_Acquisition_Request & request)
+    {
+        {
+            std::lock_guard<std::mutex> lock(d_mutex);
+            d_jobs.push_back(Job());
+            d_jobs.back().session = session;
+            std::swap(d_jobs.back().request, request);
+        }
+        d_ready.notify_one();
+    }
+
+private:
+    typedef std::tuple<long, double, int, int, unsigned int, float> key_type;
+
+    void work()
+    {
+        while (true)
+            {
+                Job job;
+                {
+                    std::unique_lock<std::mutex> lock(d_mutex);
+                    d_ready.wait(lock, [this]() { return d_stop or !d_jobs.empty(); });
+                    if (d_stop) return;
+                    std::swap(job, d_jobs.front());
+                    d_jobs.pop_front();
+                }
+                job.session->send(remote_acquisition_encode(search(job.request)));
+            }
+    }
+
+    Remote_Acquisition_Reply search(const Remote_Acquisition_Request & request)
+    {
+        Remote_Acquisition_Reply reply;
+        reply.id = request.id;
+        if (request.system != 'G' or request.signal != "1C" or request.fs_in <= 0)
+            {
+                LOG(WARNING) << "Unsupported signal " << request.system << " " << request.signal;
+                return reply;
+            }
+        std::shared_ptr<const FrontEndCalSearch> engine = get(request);
+        if (request.samples < engine->samples_per_code())
+            {
+                return reply;
+            }
+        std::vector<std::complex<float>> samples;
+        remote_acquisition_unpack(request.packed, request.samples, samples);
+        const std::vector<FrontEndCalDetection> detections = engine->search(samples, request.prns, 1);
+        for (unsigned int i = 0; i < detections.size(); i++)
+            {
+                Remote_Acquisition_Peak peak;
+                peak.prn = detections[i].PRN;
+                peak.test_statistics = detections[i].test_statistics;
+                peak.code_phase_samples = detections[i].code_phase_samples;
+                peak.doppler_hz = detections[i].doppler_hz;
+                reply.peaks.push_back(peak);
+            }
+        return reply;
+    }
+
+    // The Doppler grid of each set of parameters is built once
+    std::shared_ptr<const FrontEndCalSearch> get(const Remote_Acquisition_Request & request)
+    {
+        const key_type key = std::make_tuple(request.fs_in, request.if_hz, request.doppler_min,
+                request.doppler_max, request.doppler_step, request.threshold);
+        std::lock_guard<std::mutex> lock(d_engines_mutex);
+        std::map<key_type, std::shared_ptr<const FrontEndCalSearch>>::const_iterator it = d_engines.find(key);
+        if (it != d_engines.end())
+            {
+                return it->second;
+            }
+        if (d_engines.size() >= 64)
+            {
+                // Parameters of receivers gone long ago
+                d_engines.clear();
+            }
+        // All the code periods of each snapshot are added
+        std::shared_ptr<const FrontEndCalSearch> engine = std::make_shared<const FrontEndCalSearch>(request.fs_in,
+                request.if_hz, request.doppler_min, request.doppler_max, request.doppler_step, request.threshold,
+                std::numeric_limits<unsigned int>::max());
+        d_engines[key] = engine;
+        return engine;
+    }
+
+    std::mutex d_mutex;
+    std::condition_variable d_ready;
+    std::deque<Job> d_jobs;
+    std::mutex d_engines_mutex;
+    std::map<key_type, std::shared_ptr<const FrontEndCalSearch>> d_engines;
+    std::vector<std::thread> d_workers;
+    bool d_stop;
+};
+
+
+// Reads the requests of a receiver until it disconnects
+static void serve(std::shared_ptr<Session> session, Search_Server & server)
+{
+    boost::system::error_code ec;
+    const std::string peer = session->socket.remote_endpoint(ec).address().to_string();
+    std::cout << "Receiver " << peer << " connected" << std::endl;
+    Remote_Acquisition_Decoder decoder;
+    std::vector<char> buffer(64 * 1024);
+    unsigned long long requests = 0;
+    while (true)
+        {
+            const std::size_t length = session->socket.read_some(boost::asio::buffer(buffer), ec);
+            if (ec) break;
+            decoder.push(buffer.data(), length);
+            if (decoder.error())
+                {
+                    LOG(WARNING) << "Malformed request from " << peer;
+                    break;
+                }
+            Remote_Acquisition_Request request;
+            while (decoder.next_request(request))
+                {
+                    server.push(session, request);
+                    requests++;
+                }
+        }
+    {
+        std::lock_guard<std::mutex> lock(session->write_mutex);
+        session->open = false;
+        session->socket.close(ec);
+    }
+    std::cout << "Receiver " << peer << " disconnected after " << requests << " requests" << std::endl;
+}
+
+
+int main(int argc, char** argv)
+{
+    google::SetUsageMessage("Searches the acquisition snapshots of remote GNSS-SDR receivers");
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    unsigned int threads = FLAGS_threads > 0 ? FLAGS_threads : std::max(std::thread::hardware_concurrency(), 1u);
+    Search_Server server(threads);
+
+    boost::asio::io_service io_service;
+    boost::system::error_code ec;
+    boost::asio::ip::tcp::acceptor acceptor(io_service);
+    const boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::tcp::v4(), static_cast<unsigned short>(FLAGS_port));
+    acceptor.open(endpoint.protocol(), ec);
+    if (!ec) acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true), ec);
+    if (!ec) acceptor.bind(endpoint, ec);
+    if (!ec) acceptor.listen(boost::asio::socket_base::max_connections, ec);
+    if (ec)
+        {
+            std::cout << "Cannot listen on port " << FLAGS_port << ": " << ec.message() << std::endl;
+            google::ShutDownCommandLineFlags();
+            return 1;
+        }
+    std::cout << "Acquisition server listening on port " << FLAGS_port << " with " << threads << " workers" << std::endl;
+
+    while (true)
+        {
+            std::shared_ptr<Session> session = std::make_shared<Session>(io_service);
+            acceptor.accept(session->socket, ec);
+            if (ec)
+                {
+                    LOG(WARNING) << "Accept failed: " << ec.message();
+                    continue;
+                }
+            session->socket.set_option(boost::asio::ip::tcp::no_delay(true), ec);
+            std::thread(serve, session, std::ref(server)).detach();
+        }
+
+    google::ShutDownCommandLineFlags();
+    return 0;
+}
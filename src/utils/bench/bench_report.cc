@@ -0,0 +1,140 @@
+/*!
+ * \file bench_report.cc
+ * \brief Throughput of the receiver over a benchmark scene.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "bench_report.h"
+#include <cmath>
+#include <cstdio>
+
+
+BenchReport::BenchReport(const BenchScene & scene, double wall_s,
+        const std::vector<Gnss_Block_Metrics::Block_Stats> & stats, unsigned int cores) :
+        scene_(scene), wall_s_(wall_s), cores_(cores), channel_load_(0.0), fixed_load_(0.0)
+{
+    for (unsigned int i = 0; i < stats.size(); i++)
+        {
+            stage_loads_[stage(stats.at(i).role)] += stats.at(i).load;
+            if (stats.at(i).role.find('_') != std::string::npos)
+                {
+                    channel_load_ += stats.at(i).load;
+                }
+            else
+                {
+                    fixed_load_ += stats.at(i).load;
+                }
+        }
+}
+
+
+std::string BenchReport::stage(const std::string & role)
+{
+    return role.substr(0, role.find('_'));
+}
+
+
+double BenchReport::samples_per_s() const
+{
+    return wall_s_ > 0.0 ? static_cast<double>(scene_.samples()) / wall_s_ : 0.0;
+}
+
+
+double BenchReport::speed_factor() const
+{
+    return wall_s_ > 0.0 ? scene_.duration_s / wall_s_ : 0.0;
+}
+
+
+std::map<std::string, double> BenchReport::stage_shares() const
+{
+    std::map<std::string, double> shares;
+    const double total = channel_load_ + fixed_load_;
+    for (std::map<std::string, double>::const_iterator it = stage_loads_.begin(); it != stage_loads_.end(); ++it)
+        {
+            shares[it->first] = total > 0.0 ? it->second / total : 0.0;
+        }
+    return shares;
+}
+
+
+double BenchReport::channel_cost() const
+{
+    // the loads are over the wall time, the costs over the signal time
+    const double speed = speed_factor();
+    if (speed <= 0.0 || scene_.satellites() == 0) return 0.0;
+    return channel_load_ / speed / static_cast<double>(scene_.satellites());
+}
+
+
+double BenchReport::fixed_cost() const
+{
+    const double speed = speed_factor();
+    return speed > 0.0 ? fixed_load_ / speed : 0.0;
+}
+
+
+unsigned int BenchReport::channels_sustained() const
+{
+    const double left = static_cast<double>(cores_) - fixed_cost();
+    if (channel_cost() <= 0.0 || left <= 0.0) return 0;
+    return static_cast<unsigned int>(std::floor(left / channel_cost()));
+}
+
+
+std::vector<std::string> BenchReport::lines() const
+{
+    std::vector<std::string> lines;
+    char line[256];
+    snprintf(line, sizeof(line), "scene=gps:%u,galileo_e1:%u,galileo_e5a:%u,cn0_db:%.1f,doppler_spread_hz:%.0f,doppler_rate_hz_s:%.2f,fs_hz:%u,item_type:%s",
+            scene_.gps_satellites, scene_.galileo_satellites, scene_.e5a_satellites, scene_.cn0_db,
+            scene_.doppler_spread_hz, scene_.doppler_rate_hz_s, scene_.fs_hz, scene_.item_type.c_str());
+    lines.push_back(line);
+    snprintf(line, sizeof(line), "signal_s=%.3f", scene_.duration_s);
+    lines.push_back(line);
+    snprintf(line, sizeof(line), "wall_s=%.3f", wall_s_);
+    lines.push_back(line);
+    snprintf(line, sizeof(line), "samples_per_s=%.0f", samples_per_s());
+    lines.push_back(line);
+    snprintf(line, sizeof(line), "speed_factor=%.3f", speed_factor());
+    lines.push_back(line);
+    const std::map<std::string, double> shares = stage_shares();
+    for (std::map<std::string, double>::const_iterator it = shares.begin(); it != shares.end(); ++it)
+        {
+            snprintf(line, sizeof(line), "cpu_share.%s=%.4f", it->first.c_str(), it->second);
+            lines.push_back(line);
+        }
+    snprintf(line, sizeof(line), "channel_cost=%.5f", channel_cost());
+    lines.push_back(line);
+    snprintf(line, sizeof(line), "fixed_cost=%.5f", fixed_cost());
+    lines.push_back(line);
+    snprintf(line, sizeof(line), "cores=%u", cores_);
+    lines.push_back(line);
+    snprintf(line, sizeof(line), "channels_sustained=%u", channels_sustained());
+    lines.push_back(line);
+    return lines;
+}
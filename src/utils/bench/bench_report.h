@@ -0,0 +1,77 @@
+/*!
+ * \file bench_report.h
+ * \brief Throughput of the receiver over a benchmark scene.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The costs come from the performance counters of the blocks, sampled when
+ * the receiver starts and when it stops. A stage is a role without its
+ * signal: Acquisition_1C and Acquisition_1B are both in Acquisition. The
+ * stages with a signal in their role run once per channel, and their cost
+ * per second of signal, divided by the channels, is the cost of a channel;
+ * the others make the fixed cost of the receiver. The channels sustained
+ * are those that fit in the cores left by the fixed cost, in real time.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_BENCH_REPORT_H_
+#define GNSS_SDR_BENCH_REPORT_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include "bench_scene.h"
+#include "gnss_block_metrics.h"
+
+
+class BenchReport
+{
+public:
+    BenchReport(const BenchScene & scene, double wall_s,
+            const std::vector<Gnss_Block_Metrics::Block_Stats> & stats, unsigned int cores);
+
+    //! Acquisition_1C -> Acquisition
+    static std::string stage(const std::string & role);
+
+    double samples_per_s() const;
+    double speed_factor() const;                         //!< Seconds of signal per second
+    std::map<std::string, double> stage_shares() const;  //!< Of the CPU time of all the blocks
+    double channel_cost() const;                         //!< Core seconds per second of signal
+    double fixed_cost() const;                           //!< Core seconds per second of signal
+    unsigned int channels_sustained() const;
+
+    //! One key=value line per figure, for the comparison of runs
+    std::vector<std::string> lines() const;
+
+private:
+    BenchScene scene_;
+    double wall_s_;
+    unsigned int cores_;
+    std::map<std::string, double> stage_loads_;  // cores busy during the run
+    double channel_load_;
+    double fixed_load_;
+};
+
+#endif /*GNSS_SDR_BENCH_REPORT_H_*/
@@ -0,0 +1,321 @@
+/*!
+ * \file bench_scene.cc
+ * \brief Synthetic scene of the receiver benchmark, and the receiver that
+ * processes it.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "bench_scene.h"
+#include <cmath>
+#include <boost/lexical_cast.hpp>
+#include <gnuradio/msg_queue.h>
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/complex_to_interleaved_short.h>
+#include <gnuradio/blocks/file_sink.h>
+#include <gnuradio/blocks/head.h>
+#include <gnuradio/blocks/multiply_const_cc.h>
+#include <gnuradio/blocks/short_to_char.h>
+#include <glog/logging.h>
+#include "signal_generator.h"
+#include "GPS_L1_CA.h"
+#include "Galileo_E1.h"
+#include "Galileo_E5a.h"
+
+
+using google::LogMessage;
+
+namespace
+{
+// the noise has a unit deviation per component, and short_to_char keeps the high byte
+const float integer_scale = 4096.0;
+
+std::string str(unsigned int value)
+{
+    return boost::lexical_cast<std::string>(value);
+}
+
+std::string str(double value)
+{
+    return boost::lexical_cast<std::string>(value);
+}
+}
+
+
+BenchScene::BenchScene() :
+        gps_satellites(8), galileo_satellites(4), e5a_satellites(0),
+        cn0_db(45.0), doppler_spread_hz(4000.0), doppler_rate_hz_s(0.5),
+        fs_hz(4000000), duration_s(40.0), item_type("gr_complex")
+{}
+
+
+std::string BenchScene::check() const
+{
+    if (satellites() == 0) return "the scene has no satellites";
+    if (e5a_satellites > 0 && (gps_satellites > 0 || galileo_satellites > 0))
+        {
+            // signal_generator_c makes a single band
+            return "the E5a satellites can not share a scene with the GPS or Galileo E1 ones";
+        }
+    if (gps_satellites > 32) return "there are 32 GPS PRNs";
+    if (galileo_satellites > 36 || e5a_satellites > 36) return "there are 36 Galileo PRNs";
+    if (item_type != "gr_complex" && item_type != "ishort" && item_type != "ibyte")
+        {
+            return "the item type must be gr_complex, ishort or ibyte";
+        }
+    if (fs_hz == 0 || duration_s <= 0.0) return "the sampling frequency and the duration must be positive";
+    return "";
+}
+
+
+unsigned int BenchScene::satellites() const
+{
+    return gps_satellites + galileo_satellites + e5a_satellites;
+}
+
+
+unsigned long long BenchScene::samples() const
+{
+    return static_cast<unsigned long long>(std::ceil(duration_s * static_cast<double>(fs_hz)));
+}
+
+
+float BenchScene::doppler_hz(unsigned int sat, unsigned int sats) const
+{
+    if (sats < 2) return 0.0;
+    return -doppler_spread_hz + 2.0 * doppler_spread_hz * static_cast<float>(sat) / static_cast<float>(sats - 1);
+}
+
+
+std::shared_ptr<InMemoryConfiguration> BenchScene::generator_configuration() const
+{
+    std::shared_ptr<InMemoryConfiguration> configuration = std::make_shared<InMemoryConfiguration>();
+    configuration->set_property("SignalSource.item_type", "gr_complex");
+    configuration->set_property("SignalSource.fs_hz", str(fs_hz));
+    configuration->set_property("SignalSource.num_satellites", str(satellites()));
+    configuration->set_property("SignalSource.data_flag", "true");
+    configuration->set_property("SignalSource.noise_flag", "true");
+    configuration->set_property("SignalSource.BW_BB", "0.97");
+
+    for (unsigned int sat = 0; sat < satellites(); sat++)
+        {
+            const std::string suffix = "_" + str(sat);
+            unsigned int prn;
+            unsigned int delay_chips;
+            if (sat < gps_satellites)
+                {
+                    prn = sat + 1;
+                    configuration->set_property("SignalSource.system" + suffix, "G");
+                    configuration->set_property("SignalSource.signal" + suffix, "1C");
+                    delay_chips = (prn * 97) % static_cast<unsigned int>(GPS_L1_CA_CODE_LENGTH_CHIPS);
+                }
+            else if (sat < gps_satellites + galileo_satellites)
+                {
+                    prn = sat - gps_satellites + 1;
+                    configuration->set_property("SignalSource.system" + suffix, "E");
+                    configuration->set_property("SignalSource.signal" + suffix, "1B");
+                    delay_chips = (prn * 389) % static_cast<unsigned int>(Galileo_E1_B_CODE_LENGTH_CHIPS);
+                }
+            else
+                {
+                    prn = sat - gps_satellites - galileo_satellites + 1;
+                    configuration->set_property("SignalSource.system" + suffix, "E");
+                    configuration->set_property("SignalSource.signal" + suffix, "5X");
+                    delay_chips = (prn * 977) % static_cast<unsigned int>(Galileo_E5a_CODE_LENGTH_CHIPS);
+                }
+            configuration->set_property("SignalSource.PRN" + suffix, str(prn));
+            configuration->set_property("SignalSource.CN0_dB" + suffix, str(static_cast<double>(cn0_db)));
+            configuration->set_property("SignalSource.doppler_Hz" + suffix, str(static_cast<double>(doppler_hz(sat, satellites()))));
+            configuration->set_property("SignalSource.doppler_rate_Hz_s" + suffix,
+                    str(static_cast<double>(sat % 2 == 0 ? doppler_rate_hz_s : -doppler_rate_hz_s)));
+            configuration->set_property("SignalSource.delay_chips" + suffix, str(delay_chips));
+            configuration->set_property("SignalSource.delay_sec" + suffix, "0");
+        }
+    return configuration;
+}
+
+
+std::shared_ptr<InMemoryConfiguration> BenchScene::receiver_configuration(const std::string & filename) const
+{
+    std::shared_ptr<InMemoryConfiguration> configuration = std::make_shared<InMemoryConfiguration>();
+    configuration->set_property("GNSS-SDR.internal_fs_hz", str(fs_hz));
+
+    configuration->set_property("SignalSource.implementation", "File_Signal_Source");
+    configuration->set_property("SignalSource.filename", filename);
+    configuration->set_property("SignalSource.item_type", item_type);
+    configuration->set_property("SignalSource.sampling_frequency", str(fs_hz));
+    configuration->set_property("SignalSource.freq", e5a_satellites > 0 ? "1176450000" : "1575420000");
+    configuration->set_property("SignalSource.samples", "0");
+    configuration->set_property("SignalSource.repeat", "false");
+    configuration->set_property("SignalSource.enable_throttle_control", "false");
+
+    if (item_type == "gr_complex")
+        {
+            configuration->set_property("SignalConditioner.implementation", "Pass_Through");
+            configuration->set_property("SignalConditioner.item_type", "gr_complex");
+        }
+    else
+        {
+            configuration->set_property("SignalConditioner.implementation", "Signal_Conditioner");
+            configuration->set_property("DataTypeAdapter.implementation", item_type == "ishort" ? "Ishort_To_Complex" : "Ibyte_To_Complex");
+            configuration->set_property("InputFilter.implementation", "Pass_Through");
+            configuration->set_property("InputFilter.item_type", "gr_complex");
+            configuration->set_property("Resampler.implementation", "Pass_Through");
+            configuration->set_property("Resampler.item_type", "gr_complex");
+        }
+
+    // the channels are created in this order, 1C before 1B and 5X
+    configuration->set_property("Channels_1C.count", str(gps_satellites));
+    configuration->set_property("Channels_1B.count", str(galileo_satellites));
+    configuration->set_property("Channels_5X.count", str(e5a_satellites));
+    configuration->set_property("Channels.in_acquisition", "1");
+    configuration->set_property("Channel.item_type", "gr_complex");
+    for (unsigned int channel = 0; channel < satellites(); channel++)
+        {
+            const std::string prefix = "Channel" + str(channel);
+            if (channel < gps_satellites)
+                {
+                    configuration->set_property(prefix + ".signal", "1C");
+                    configuration->set_property(prefix + ".satellite", str(channel + 1));
+                }
+            else if (channel < gps_satellites + galileo_satellites)
+                {
+                    configuration->set_property(prefix + ".signal", "1B");
+                    configuration->set_property(prefix + ".satellite", str(channel - gps_satellites + 1));
+                }
+            else
+                {
+                    configuration->set_property(prefix + ".signal", "5X");
+                    configuration->set_property(prefix + ".satellite", str(channel - gps_satellites - galileo_satellites + 1));
+                }
+        }
+    const std::string doppler_max = str(static_cast<unsigned int>(std::ceil(doppler_spread_hz + doppler_rate_hz_s * duration_s)) + 1000);
+
+    configuration->set_property("Acquisition_1C.implementation", "GPS_L1_CA_PCPS_Acquisition");
+    configuration->set_property("Acquisition_1C.item_type", "gr_complex");
+    configuration->set_property("Acquisition_1C.threshold", "0.01");
+    configuration->set_property("Acquisition_1C.doppler_max", doppler_max);
+    configuration->set_property("Acquisition_1C.doppler_step", "250");
+    configuration->set_property("Tracking_1C.implementation", "GPS_L1_CA_DLL_PLL_Tracking");
+    configuration->set_property("Tracking_1C.item_type", "gr_complex");
+    configuration->set_property("Tracking_1C.pll_bw_hz", "45.0");
+    configuration->set_property("Tracking_1C.dll_bw_hz", "3.0");
+    configuration->set_property("TelemetryDecoder_1C.implementation", "GPS_L1_CA_Telemetry_Decoder");
+
+    configuration->set_property("Acquisition_1B.implementation", "Galileo_E1_PCPS_Ambiguous_Acquisition");
+    configuration->set_property("Acquisition_1B.item_type", "gr_complex");
+    configuration->set_property("Acquisition_1B.sampled_ms", "4");
+    configuration->set_property("Acquisition_1B.pfa", "0.0000008");
+    configuration->set_property("Acquisition_1B.doppler_max", doppler_max);
+    configuration->set_property("Acquisition_1B.doppler_step", "125");
+    configuration->set_property("Tracking_1B.implementation", "Galileo_E1_DLL_PLL_VEML_Tracking");
+    configuration->set_property("Tracking_1B.item_type", "gr_complex");
+    configuration->set_property("Tracking_1B.pll_bw_hz", "15.0");
+    configuration->set_property("Tracking_1B.dll_bw_hz", "2.0");
+    configuration->set_property("Tracking_1B.early_late_space_chips", "0.15");
+    configuration->set_property("Tracking_1B.very_early_late_space_chips", "0.6");
+    configuration->set_property("TelemetryDecoder_1B.implementation", "Galileo_E1B_Telemetry_Decoder");
+
+    configuration->set_property("Acquisition_5X.implementation", "Galileo_E5a_Noncoherent_IQ_Acquisition_CAF");
+    configuration->set_property("Acquisition_5X.item_type", "gr_complex");
+    configuration->set_property("Acquisition_5X.coherent_integration_time_ms", "1");
+    configuration->set_property("Acquisition_5X.threshold", "0.001");
+    configuration->set_property("Acquisition_5X.doppler_max", doppler_max);
+    configuration->set_property("Acquisition_5X.doppler_step", "250");
+    configuration->set_property("Tracking_5X.implementation", "Galileo_E5a_DLL_PLL_Tracking");
+    configuration->set_property("Tracking_5X.item_type", "gr_complex");
+    configuration->set_property("Tracking_5X.pll_bw_hz", "20.0");
+    configuration->set_property("Tracking_5X.dll_bw_hz", "20.0");
+    configuration->set_property("TelemetryDecoder_5X.implementation", "Galileo_E5a_Telemetry_Decoder");
+
+    if (gps_satellites > 0 && galileo_satellites > 0)
+        {
+            configuration->set_property("Observables.implementation", "Hybrid_Observables");
+            configuration->set_property("PVT.implementation", "Hybrid_PVT");
+        }
+    else if (gps_satellites > 0)
+        {
+            configuration->set_property("Observables.implementation", "GPS_L1_CA_Observables");
+            configuration->set_property("PVT.implementation", "GPS_L1_CA_PVT");
+        }
+    else
+        {
+            configuration->set_property("Observables.implementation", "Galileo_E1B_Observables");
+            configuration->set_property("PVT.implementation", "GALILEO_E1_PVT");
+        }
+    configuration->set_property("PVT.output_rate_ms", "100");
+    configuration->set_property("PVT.display_rate_ms", "500");
+    configuration->set_property("PVT.flag_nmea_tty_port", "false");
+    configuration->set_property("PVT.flag_rtcm_server", "false");
+    configuration->set_property("PVT.flag_rtcm_tty_port", "false");
+    return configuration;
+}
+
+
+bool BenchScene::write(const std::string & filename) const
+{
+    std::shared_ptr<InMemoryConfiguration> configuration = generator_configuration();
+    gr::msg_queue::sptr queue = gr::msg_queue::make(0);
+    SignalGenerator generator(configuration.get(), "SignalSource", 0, 1, queue);
+    gr::top_block_sptr top_block = gr::make_top_block("Bench scene");
+    try
+    {
+            generator.connect(top_block);
+            gr::block_sptr head = gr::blocks::head::make(sizeof(gr_complex), samples());
+            top_block->connect(generator.get_right_block(), 0, head, 0);
+            if (item_type == "gr_complex")
+                {
+                    gr::block_sptr sink = gr::blocks::file_sink::make(sizeof(gr_complex), filename.c_str());
+                    top_block->connect(head, 0, sink, 0);
+                }
+            else
+                {
+                    gr::block_sptr scale = gr::blocks::multiply_const_cc::make(gr_complex(integer_scale, 0.0));
+                    gr::block_sptr to_short = gr::blocks::complex_to_interleaved_short::make();
+                    top_block->connect(head, 0, scale, 0);
+                    top_block->connect(scale, 0, to_short, 0);
+                    if (item_type == "ishort")
+                        {
+                            gr::block_sptr sink = gr::blocks::file_sink::make(sizeof(int16_t), filename.c_str());
+                            top_block->connect(to_short, 0, sink, 0);
+                        }
+                    else
+                        {
+                            gr::block_sptr to_char = gr::blocks::short_to_char::make();
+                            gr::block_sptr sink = gr::blocks::file_sink::make(sizeof(int8_t), filename.c_str());
+                            top_block->connect(to_short, 0, to_char, 0);
+                            top_block->connect(to_char, 0, sink, 0);
+                        }
+                }
+            top_block->run();
+    }
+    catch (std::exception const & e)
+    {
+            LOG(WARNING) << "The scene could not be written to " << filename << ": " << e.what();
+            return false;
+    }
+    return true;
+}
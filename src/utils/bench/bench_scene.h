@@ -0,0 +1,80 @@
+/*!
+ * \file bench_scene.h
+ * \brief Synthetic scene of the receiver benchmark, and the receiver that
+ * processes it.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The scene is generated once by signal_generator_c into a file, which is
+ * then read by a File_Signal_Source without throttle, so that the receiver
+ * runs as fast as it can and the cost of the generator is not measured.
+ * The satellites are spread evenly over the Doppler range, with a Doppler
+ * rate of alternate sign, and each channel is assigned one of them.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_BENCH_SCENE_H_
+#define GNSS_SDR_BENCH_SCENE_H_
+
+#include <memory>
+#include <string>
+#include "in_memory_configuration.h"
+
+
+class BenchScene
+{
+public:
+    BenchScene();
+
+    unsigned int gps_satellites;      // GPS L1 C/A
+    unsigned int galileo_satellites;  // Galileo E1 B/C
+    unsigned int e5a_satellites;      // Galileo E5a, in a scene of its own
+    float cn0_db;
+    float doppler_spread_hz;          // the Doppler goes from -spread to +spread
+    float doppler_rate_hz_s;
+    unsigned int fs_hz;
+    double duration_s;
+    std::string item_type;            // gr_complex, ishort or ibyte
+
+    //! Why the scene can not be generated, or an empty string
+    std::string check() const;
+
+    unsigned int satellites() const;
+    unsigned long long samples() const;
+
+    //! Properties of the SignalGenerator that makes the scene
+    std::shared_ptr<InMemoryConfiguration> generator_configuration() const;
+
+    //! Properties of a receiver with one channel per satellite, that reads the scene from \p filename
+    std::shared_ptr<InMemoryConfiguration> receiver_configuration(const std::string & filename) const;
+
+    //! Writes the samples of the scene to \p filename
+    bool write(const std::string & filename) const;
+
+private:
+    float doppler_hz(unsigned int sat, unsigned int sats) const;
+};
+
+#endif /*GNSS_SDR_BENCH_SCENE_H_*/
@@ -0,0 +1,149 @@
+/*!
+ * \file main.cc
+ * \brief Throughput benchmark of the whole receiver over synthetic scenes
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Generates a scene with signal_generator_c, or reuses the one of a
+ * previous run, then processes it with the receiver as fast as possible
+ * and prints its throughput, the share of each stage in the CPU time and
+ * the channels it could track in real time, as key=value lines.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/exception/diagnostic_information.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <gnuradio/msg_queue.h>
+#include "bench_report.h"
+#include "bench_scene.h"
+#include "concurrent_map.h"
+#include "concurrent_queue.h"
+#include "control_thread.h"
+#include "gps_acq_assist.h"
+
+
+using google::LogMessage;
+
+DEFINE_int32(gps, 8, "GPS L1 C/A satellites in the scene");
+DEFINE_int32(galileo, 4, "Galileo E1 satellites in the scene");
+DEFINE_int32(e5a, 0, "Galileo E5a satellites, in a scene without GPS or Galileo E1");
+DEFINE_double(cn0_db, 45.0, "C/N0 of all the satellites [dB-Hz]");
+DEFINE_double(doppler_spread_hz, 4000.0, "The Doppler of the satellites goes from -spread to +spread [Hz]");
+DEFINE_double(doppler_rate_hz_s, 0.5, "Doppler rate of the satellites, of alternate sign [Hz/s]");
+DEFINE_int32(fs_hz, 4000000, "Sampling frequency [Hz]");
+DEFINE_double(duration_s, 40.0, "Duration of the scene [s]");
+DEFINE_string(item_type, "gr_complex", "Samples of the scene: gr_complex, ishort or ibyte");
+DEFINE_string(scene_file, "./bench_scene.dat", "File of the scene, made at each run unless reuse_scene is set");
+DEFINE_bool(reuse_scene, false, "Reads the scene file of a previous run with the same scene");
+DEFINE_int32(cores, 0, "Cores available to the receiver, 0 for all of them");
+
+// For GPS NAVIGATION (L1)
+concurrent_queue<Gps_Acq_Assist> global_gps_acq_assist_queue;
+concurrent_map<Gps_Acq_Assist> global_gps_acq_assist_map;
+
+
+int main(int argc, char** argv)
+{
+    google::SetUsageMessage("Throughput benchmark of GNSS-SDR over synthetic scenes");
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    BenchScene scene;
+    scene.gps_satellites = std::max(FLAGS_gps, 0);
+    scene.galileo_satellites = std::max(FLAGS_galileo, 0);
+    scene.e5a_satellites = std::max(FLAGS_e5a, 0);
+    scene.cn0_db = FLAGS_cn0_db;
+    scene.doppler_spread_hz = FLAGS_doppler_spread_hz;
+    scene.doppler_rate_hz_s = FLAGS_doppler_rate_hz_s;
+    scene.fs_hz = std::max(FLAGS_fs_hz, 0);
+    scene.duration_s = FLAGS_duration_s;
+    scene.item_type = FLAGS_item_type;
+    const std::string invalid = scene.check();
+    if (!invalid.empty())
+        {
+            std::cout << "Invalid scene: " << invalid << std::endl;
+            google::ShutDownCommandLineFlags();
+            return 1;
+        }
+
+    if (!FLAGS_reuse_scene || !boost::filesystem::exists(FLAGS_scene_file))
+        {
+            std::cout << "Generating " << scene.duration_s << " s of signal of " << scene.satellites()
+                      << " satellites into " << FLAGS_scene_file << " ..." << std::endl;
+            if (!scene.write(FLAGS_scene_file))
+                {
+                    std::cout << "The scene could not be generated" << std::endl;
+                    google::ShutDownCommandLineFlags();
+                    return 1;
+                }
+        }
+
+    // sampled once at the start and once at the end, in full
+    const unsigned int cores = FLAGS_cores > 0 ? FLAGS_cores : std::max(boost::thread::hardware_concurrency(), 1u);
+    std::shared_ptr<InMemoryConfiguration> configuration = scene.receiver_configuration(FLAGS_scene_file);
+    configuration->set_property("GNSS-SDR.metrics_period_ms", "1000000000");
+    configuration->set_property("GNSS-SDR.metrics_log", "false");
+
+    std::unique_ptr<ControlThread> control_thread(new ControlThread(configuration));
+    control_thread->set_control_queue(gr::msg_queue::make(0));
+
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    try
+    {
+            control_thread->run();
+    }
+    catch(boost::exception & e)
+    {
+            LOG(FATAL) << "Boost exception: " << boost::diagnostic_information(e);
+    }
+    catch(std::exception const & ex)
+    {
+            LOG(FATAL) << "STD exception: " << ex.what();
+    }
+    const double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::shared_ptr<Gnss_Block_Metrics> metrics = control_thread->metrics();
+    metrics->sample();
+    BenchReport report(scene, wall_s, metrics->stats(), cores);
+    std::vector<std::string> lines = report.lines();
+    for (unsigned int i = 0; i < lines.size(); i++)
+        {
+            std::cout << lines.at(i) << std::endl;
+            LOG(INFO) << "Bench: " << lines.at(i);
+        }
+
+    google::ShutDownCommandLineFlags();
+    return 0;
+}
@@ -0,0 +1,187 @@
+/*!
+ * \file main.cc
+ * \brief Compresses raw sample files for Compressed_File_Signal_Source, and back
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The chunks are compressed on --threads threads. With --decompress, the
+ * raw file is written back, bit for bit; with --verify, a compressed
+ * capture is decompressed and compared with the raw file.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include "compressed_capture.h"
+
+using google::LogMessage;
+
+DEFINE_string(input, "", "File to read: the raw samples, or the compressed capture with --decompress or --verify");
+DEFINE_string(output, "", "File to write: the compressed capture, or the raw samples with --decompress");
+DEFINE_string(item_type, "ishort", "Item type of the raw file, as in File_Signal_Source: ishort, short, ibyte, byte, float or gr_complex");
+DEFINE_double(sample_rate, 0.0, "Sample rate of the raw file [Hz], stored in the capture");
+DEFINE_int32(chunk_kb, 1024, "Raw bytes of each chunk [KB]: the unit of random access and of parallel work");
+DEFINE_int32(threads, 0, "Compression or decompression threads, 0 for one per core");
+DEFINE_bool(decompress, false, "Decompress --input into --output");
+DEFINE_bool(verify, false, "Check that --input decompresses into the raw file --output");
+
+
+// Decompresses the chunks on threads, in batches, and hands them to consumer in order
+template <class Consumer>
+static bool decompress_all(const Compressed_Capture_Reader & reader, unsigned int threads, Consumer consumer)
+{
+    std::vector<std::vector<unsigned char> > chunks(threads, std::vector<unsigned char>(reader.chunk_bytes()));
+    std::vector<std::vector<unsigned char> > scratch(threads);
+    std::vector<char> ok(threads);
+    for (size_t first = 0; first < reader.chunks(); first += threads)
+        {
+            const size_t n = std::min<size_t>(threads, reader.chunks() - first);
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < n; t++)
+                {
+                    workers.push_back(std::thread([&, t]()
+                            {
+                        ok[t] = reader.read_chunk(first + t, chunks[t].data(), scratch[t]);
+                            }));
+                }
+            for (size_t t = 0; t < n; t++) workers[t].join();
+            for (size_t t = 0; t < n; t++)
+                {
+                    if (!ok[t])
+                        {
+                            std::cout << "Chunk " << first + t << " is corrupt" << std::endl;
+                            return false;
+                        }
+                    if (!consumer(chunks[t].data(), reader.chunk_size(first + t))) return false;
+                }
+        }
+    return true;
+}
+
+
+static int compress(unsigned int threads)
+{
+    std::ifstream in(FLAGS_input.c_str(), std::ios::in | std::ios::binary);
+    if (!in.is_open())
+        {
+            std::cout << "Cannot open " << FLAGS_input << std::endl;
+            return 1;
+        }
+    Compressed_Capture_Writer writer;
+    if (!writer.open(FLAGS_output, FLAGS_item_type, FLAGS_sample_rate, static_cast<size_t>(FLAGS_chunk_kb) * 1024, threads))
+        {
+            std::cout << "Cannot create " << FLAGS_output << std::endl;
+            return 1;
+        }
+    std::vector<char> buffer(16 * 1024 * 1024);
+    while (in)
+        {
+            in.read(buffer.data(), buffer.size());
+            if (in.gcount() > 0 && !writer.write(buffer.data(), static_cast<size_t>(in.gcount())))
+                {
+                    std::cout << "Cannot write " << FLAGS_output << std::endl;
+                    return 1;
+                }
+        }
+    if (!writer.close())
+        {
+            std::cout << "Cannot write " << FLAGS_output << std::endl;
+            return 1;
+        }
+    std::cout << FLAGS_input << ": " << writer.raw_bytes() << " bytes compressed to " << writer.compressed_bytes()
+              << " (ratio " << static_cast<double>(writer.raw_bytes()) / std::max(writer.compressed_bytes(), 1ULL) << ")" << std::endl;
+    return 0;
+}
+
+
+int main(int argc, char** argv)
+{
+    google::SetUsageMessage("Compresses raw GNSS sample files for Compressed_File_Signal_Source, and back");
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    if (FLAGS_input.empty() || FLAGS_output.empty())
+        {
+            std::cout << "Give the --input and --output files" << std::endl;
+            google::ShutDownCommandLineFlags();
+            return 1;
+        }
+    const unsigned int threads = FLAGS_threads > 0 ? FLAGS_threads : std::max(std::thread::hardware_concurrency(), 1u);
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    int result = 0;
+    if (!FLAGS_decompress && !FLAGS_verify)
+        {
+            result = compress(threads);
+        }
+    else
+        {
+            Compressed_Capture_Reader reader;
+            if (!reader.open(FLAGS_input))
+                {
+                    std::cout << FLAGS_input << " is not a valid compressed capture" << std::endl;
+                    google::ShutDownCommandLineFlags();
+                    return 1;
+                }
+            std::cout << FLAGS_input << ": " << reader.raw_bytes() << " bytes of " << reader.item_type()
+                      << " items at " << reader.sample_rate() << " Hz, in " << reader.chunks() << " chunks" << std::endl;
+            bool ok = true;
+            if (FLAGS_decompress)
+                {
+                    std::ofstream out(FLAGS_output.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+                    ok = out.is_open() && decompress_all(reader, threads, [&out](const unsigned char * data, size_t size)
+                            {
+                        out.write(reinterpret_cast<const char *>(data), size);
+                        return out.good();
+                            });
+                }
+            else
+                {
+                    std::ifstream raw(FLAGS_output.c_str(), std::ios::in | std::ios::binary);
+                    std::vector<char> expected(reader.chunk_bytes());
+                    ok = raw.is_open() && decompress_all(reader, threads, [&raw, &expected](const unsigned char * data, size_t size)
+                            {
+                        raw.read(expected.data(), size);
+                        return raw.gcount() == static_cast<std::streamsize>(size) && std::memcmp(expected.data(), data, size) == 0;
+                            });
+                    ok = ok && raw.peek() == std::char_traits<char>::eof();
+                }
+            std::cout << (ok ? "Done" : (FLAGS_verify ? "The files differ" : "Decompression failed")) << std::endl;
+            result = ok ? 0 : 1;
+        }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Elapsed time: " << seconds << " s" << std::endl;
+    google::ShutDownCommandLineFlags();
+    return result;
+}
@@ -48,6 +48,7 @@
 #include "gps_cnav_iono.h"
 #include "gps_utc_model.h"
 #include "gnss_sdr_supl_client.h"
+#include "gnss_receiver_state.h"
 
 extern concurrent_map<Gps_Ephemeris> global_gps_ephemeris_map;
 extern concurrent_map<Gps_Iono> global_gps_iono_map;
@@ -55,8 +56,23 @@ extern concurrent_map<Gps_Utc_Model> global_gps_utc_model_map;
 extern concurrent_map<Gps_Almanac> global_gps_almanac_map;
 extern concurrent_map<Gps_Acq_Assist> global_gps_acq_assist_map;
 
+namespace
+{
+// GPS time of 1 January 1970, 00:00:00 UTC, without the leap seconds [s]
+const double GPS_EPOCH_UNIX_S = 315964800.0;
+// Leap seconds if the receiver state has no UTC model
+const double DEFAULT_LEAP_SECONDS = 17.0;
+}
+
 FrontEndCal::FrontEndCal()
-{}
+{
+    offline_ = false;
+    has_position_ = false;
+    latitude_deg_ = 0.0;
+    longitude_deg_ = 0.0;
+    height_m_ = 0.0;
+    leap_seconds_ = DEFAULT_LEAP_SECONDS;
+}
 
 FrontEndCal::~FrontEndCal()
 {}
@@ -89,6 +105,60 @@ bool FrontEndCal::read_assistance_from_XML()
         }
 }
 
+bool FrontEndCal::read_assistance_from_receiver_state(const std::string & file_name)
+{
+    Gnss_Receiver_State state;
+    std::cout << "Trying to read GPS ephemeris from the receiver state " << file_name << std::endl;
+    LOG(INFO) << "Trying to read GPS ephemeris from the receiver state " << file_name;
+    if (state.load(file_name) == false || state.gps_ephemeris_map.empty())
+        {
+            std::cout << "ERROR: No GPS ephemeris in the receiver state " << file_name << std::endl;
+            LOG(WARNING) << "ERROR: No GPS ephemeris in the receiver state " << file_name;
+            return false;
+        }
+    for (std::map<int,Gps_Ephemeris>::const_iterator it = state.gps_ephemeris_map.begin(); it != state.gps_ephemeris_map.end(); ++it)
+        {
+            LOG(INFO) << "Receiver state: ephemeris for GPS SV " << it->first << " with Toe=" << it->second.d_Toe;
+            global_gps_ephemeris_map.write(it->second.i_satellite_PRN, it->second);
+        }
+    if (state.gps_utc_model.valid == true)
+        {
+            global_gps_utc_model_map.write(0, state.gps_utc_model);
+            leap_seconds_ = state.gps_utc_model.d_DeltaT_LS;
+        }
+    has_position_ = state.has_position;
+    latitude_deg_ = state.latitude_d;
+    longitude_deg_ = state.longitude_d;
+    height_m_ = state.height_m;
+    offline_ = true;
+    std::cout << "Read " << state.gps_ephemeris_map.size() << " GPS ephemeris, "
+              << static_cast<long>(state.age_s()) << " s old" << std::endl;
+    return true;
+}
+
+
+bool FrontEndCal::receiver_position(double & lat, double & lon, double & height) const
+{
+    if (has_position_ == false)
+        {
+            return false;
+        }
+    lat = latitude_deg_;
+    lon = longitude_deg_;
+    height = height_m_;
+    return true;
+}
+
+
+void FrontEndCal::gps_time_from_clock(int & week, double & tow) const
+{
+    const double gps_s = static_cast<double>(std::time(nullptr)) - GPS_EPOCH_UNIX_S + leap_seconds_;
+    const long full_week = static_cast<long>(gps_s / 604800.0);
+    week = static_cast<int>(full_week % 1024);
+    tow = gps_s - static_cast<double>(full_week) * 604800.0;
+}
+
+
 int FrontEndCal::Get_SUPL_Assist()
 {
     //######### GNSS Assistance #################################
@@ -245,6 +315,13 @@ void FrontEndCal::set_configuration(std::shared_ptr<ConfigurationInterface> conf
 bool FrontEndCal::get_ephemeris()
 {
     bool read_ephemeris_from_xml = configuration_->property("GNSS-SDR.read_eph_from_xml", false);
+    bool enable_gps_supl_assistance = configuration_->property("GNSS-SDR.SUPL_gps_enabled", false);
+    std::string receiver_state_file = configuration_->property("GNSS-SDR.receiver_state_xml", std::string(""));
+
+    if (read_ephemeris_from_xml == false && enable_gps_supl_assistance == false && !receiver_state_file.empty())
+        {
+            return read_assistance_from_receiver_state(receiver_state_file);
+        }
 
     if (read_ephemeris_from_xml == true)
         {
@@ -92,9 +92,22 @@ private:
      *
      */
     int Get_SUPL_Assist();
+    /*!
+     * \brief Reads the GPS ephemeris, the UTC model and the position saved
+     * by the receiver (GNSS-SDR.receiver_state_xml), so that no SUPL
+     * server is needed
+     */
+    bool read_assistance_from_receiver_state(const std::string & file_name);
 
     const std::string eph_default_xml_filename = "./gps_ephemeris.xml";
 
+    bool offline_;
+    bool has_position_;
+    double latitude_deg_;
+    double longitude_deg_;
+    double height_m_;
+    double leap_seconds_;
+
 public:
     /*!
      * \brief Sets the configuration data required by get_ephemeris function
@@ -110,6 +123,24 @@ public:
      */
     bool get_ephemeris();
 
+    /*!
+     * \brief True if the ephemeris were read from the receiver state. The
+     * reference time is then that of the system clock, see gps_time_from_clock().
+     */
+    bool offline() const
+    {
+        return offline_;
+    }
+
+    //! Gives the position saved in the receiver state, if it had one
+    bool receiver_position(double & lat, double & lon, double & height) const;
+
+    /*!
+     * \brief GPS week (modulo 1024, as broadcast) and time of week of the
+     * system clock, with the leap seconds of the receiver state UTC model
+     */
+    void gps_time_from_clock(int & week, double & tow) const;
+
     /*!
      * \brief This function estimates the GPS L1 satellite Doppler frequency [Hz] using the following data:
      * 1- Orbital model from the ephemeris
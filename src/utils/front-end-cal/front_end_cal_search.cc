@@ -0,0 +1,271 @@
+/*!
+ * \file front_end_cal_search.cc
+ * \brief Parallel GPS L1 C/A search of all the PRNs in a captured buffer
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "front_end_cal_search.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <thread>
+#include <volk/volk.h>
+#include "fft_planner.h"
+#include "GPS_L1_CA.h"
+#include "gps_sdr_signal_processing.h"
+
+namespace
+{
+// Grid of the residual Doppler search [Hz]
+const double FINE_DOPPLER_RESOLUTION = 0.25;
+}
+
+
+FrontEndCalSearch::FrontEndCalSearch(long fs_in, double if_hz, int doppler_min, int doppler_max,
+        unsigned int doppler_step, float threshold, unsigned int dwells)
+{
+    d_fs_in = fs_in;
+    d_if_hz = if_hz;
+    d_doppler_min = doppler_min;
+    d_doppler_step = std::max(doppler_step, 1u);
+    d_num_doppler_bins = doppler_max >= doppler_min ? (doppler_max - doppler_min) / d_doppler_step + 1 : 1;
+    d_threshold = threshold;
+    d_dwells = std::max(dwells, 1u);
+    d_samples_per_code = static_cast<unsigned int>(std::round(static_cast<double>(fs_in) / (GPS_L1_CA_CODE_RATE_HZ / GPS_L1_CA_CODE_LENGTH_CHIPS)));
+
+    d_wipeoffs.resize(d_num_doppler_bins);
+    for (unsigned int b = 0; b < d_num_doppler_bins; b++)
+        {
+            const double doppler = d_doppler_min + static_cast<double>(b * d_doppler_step);
+            const double phase_step_rad = 2.0 * GPS_PI * (d_if_hz + doppler) / static_cast<double>(d_fs_in);
+            d_wipeoffs[b].resize(d_samples_per_code);
+            for (unsigned int n = 0; n < d_samples_per_code; n++)
+                {
+                    d_wipeoffs[b][n] = std::polar(1.0f, static_cast<float>(-std::fmod(phase_step_rad * n, 2.0 * GPS_PI)));
+                }
+        }
+}
+
+
+std::vector<FrontEndCalDetection> FrontEndCalSearch::search(const std::vector<std::complex<float>> & samples,
+        const std::vector<unsigned int> & prns, unsigned int threads) const
+{
+    std::vector<FrontEndCalDetection> results(prns.size());
+    if (samples.size() < d_samples_per_code || prns.empty())
+        {
+            for (unsigned int i = 0; i < prns.size(); i++)
+                {
+                    results[i] = FrontEndCalDetection();
+                    results[i].PRN = prns[i];
+                    results[i].detected = false;
+                }
+            return results;
+        }
+    if (threads == 0)
+        {
+            threads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+    threads = std::min(threads, static_cast<unsigned int>(prns.size()));
+
+    // Each worker takes the next PRN; the results do not depend on the order
+    std::atomic<size_t> next(0);
+    auto worker = [&]()
+        {
+            size_t i;
+            while ((i = next.fetch_add(1)) < prns.size())
+                {
+                    results[i] = search_prn(samples, prns[i]);
+                }
+        };
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; t++)
+        {
+            pool.push_back(std::thread(worker));
+        }
+    worker();
+    for (auto & t : pool)
+        {
+            t.join();
+        }
+    return results;
+}
+
+
+FrontEndCalDetection FrontEndCalSearch::search_prn(const std::vector<std::complex<float>> & samples, unsigned int prn) const
+{
+    const unsigned int N = d_samples_per_code;
+    const unsigned int dwells = std::min(d_dwells, static_cast<unsigned int>(samples.size() / N));
+    std::shared_ptr<gr::fft::fft_complex> fft = Fft_Planner::instance().acquire(N, true);
+    std::shared_ptr<gr::fft::fft_complex> ifft = Fft_Planner::instance().acquire(N, false);
+
+    FrontEndCalDetection result = FrontEndCalDetection();
+    result.PRN = prn;
+    result.detected = false;
+
+    // Conjugate of the transform of the local code
+    std::vector<std::complex<float>> code(N);
+    gps_l1_ca_code_gen_complex_sampled(code.data(), prn, d_fs_in, 0);
+    std::copy(code.begin(), code.end(), fft->get_inbuf());
+    fft->execute();
+    std::vector<std::complex<float>> code_fft(N);
+    volk_32fc_conjugate_32fc(code_fft.data(), fft->get_outbuf(), N);
+
+    std::vector<float> magnitude(N);
+    std::vector<float> grid(N);
+    float input_power = 0.0;
+    for (unsigned int k = 0; k < dwells; k++)
+        {
+            float power = 0.0;
+            volk_32fc_magnitude_squared_32f(magnitude.data(), samples.data() + k * N, N);
+            volk_32f_accumulator_s32f(&power, magnitude.data(), N);
+            input_power += power;
+        }
+    input_power /= static_cast<float>(dwells * N);
+    if (input_power <= 0.0)
+        {
+            return result;
+        }
+
+    float peak = 0.0;
+    unsigned int peak_bin = 0;
+    unsigned int peak_index = 0;
+    float peak_early = 0.0;
+    float peak_late = 0.0;
+    for (unsigned int b = 0; b < d_num_doppler_bins; b++)
+        {
+            std::fill(grid.begin(), grid.end(), 0.0);
+            for (unsigned int k = 0; k < dwells; k++)
+                {
+                    volk_32fc_x2_multiply_32fc(fft->get_inbuf(), samples.data() + k * N, d_wipeoffs[b].data(), N);
+                    fft->execute();
+                    volk_32fc_x2_multiply_32fc(ifft->get_inbuf(), fft->get_outbuf(), code_fft.data(), N);
+                    ifft->execute();
+                    volk_32fc_magnitude_squared_32f(magnitude.data(), ifft->get_outbuf(), N);
+                    volk_32f_x2_add_32f(grid.data(), grid.data(), magnitude.data(), N);
+                }
+            unsigned int index = std::max_element(grid.begin(), grid.end()) - grid.begin();
+            if (grid[index] > peak)
+                {
+                    peak = grid[index];
+                    peak_bin = b;
+                    peak_index = index;
+                    peak_early = grid[(index + N - 1) % N];
+                    peak_late = grid[(index + 1) % N];
+                }
+        }
+
+    // Same normalization as the fine Doppler acquisition
+    const double n2 = static_cast<double>(N) * static_cast<double>(N);
+    result.test_statistics = peak / (n2 * n2) / (input_power * std::sqrt(static_cast<double>(dwells)));
+    // Vertex of the parabola through the peak and its neighbours
+    result.code_phase_samples = peak_index;
+    const double curvature = peak_early - 2.0 * peak + peak_late;
+    if (curvature < 0.0)
+        {
+            result.code_phase_samples += 0.5 * (peak_early - peak_late) / curvature;
+        }
+    result.coarse_doppler_hz = d_doppler_min + static_cast<double>(peak_bin * d_doppler_step);
+    result.doppler_hz = result.coarse_doppler_hz;
+    if (result.test_statistics > d_threshold)
+        {
+            result.detected = true;
+            result.doppler_hz += refine_doppler(samples, code, peak_index, result.coarse_doppler_hz);
+        }
+    return result;
+}
+
+
+double FrontEndCalSearch::refine_doppler(const std::vector<std::complex<float>> & samples, const std::vector<std::complex<float>> & code,
+        unsigned int code_phase, double coarse_doppler_hz) const
+{
+    const unsigned int N = d_samples_per_code;
+    const unsigned int periods = (samples.size() - code_phase) / N;
+    if (periods < 2)
+        {
+            return 0.0;
+        }
+
+    // Squared prompt correlations, one per code period: the squaring removes
+    // the navigation bits and doubles the residual frequency
+    const double phase_step_rad = 2.0 * GPS_PI * (d_if_hz + coarse_doppler_hz) / static_cast<double>(d_fs_in);
+    std::vector<std::complex<double>> prompt(periods);
+    for (unsigned int k = 0; k < periods; k++)
+        {
+            std::complex<double> acc(0.0, 0.0);
+            const unsigned long first = code_phase + static_cast<unsigned long>(k) * N;
+            for (unsigned int n = 0; n < N; n++)
+                {
+                    const double phase = std::fmod(phase_step_rad * static_cast<double>(first + n), 2.0 * GPS_PI);
+                    acc += std::complex<double>(samples[first + n]) * std::conj(std::complex<double>(code[n]))
+                            * std::polar(1.0, -phase);
+                }
+            prompt[k] = acc * acc;
+        }
+
+    // The residual is within half a Doppler bin
+    const double period_s = static_cast<double>(N) / static_cast<double>(d_fs_in);
+    const double half_range = d_doppler_step / 2.0;
+    double best_power = -1.0;
+    double best = 0.0;
+    for (double f = -half_range; f <= half_range; f += FINE_DOPPLER_RESOLUTION)
+        {
+            const std::complex<double> rotation = std::polar(1.0, -2.0 * GPS_PI * 2.0 * f * period_s);
+            std::complex<double> phasor(1.0, 0.0);
+            std::complex<double> acc(0.0, 0.0);
+            for (unsigned int k = 0; k < periods; k++)
+                {
+                    acc += prompt[k] * phasor;
+                    phasor *= rotation;
+                }
+            if (std::norm(acc) > best_power)
+                {
+                    best_power = std::norm(acc);
+                    best = f;
+                }
+        }
+    return best;
+}
+
+
+std::vector<std::complex<float>> FrontEndCalSearch::read_capture(const std::string & filename)
+{
+    std::vector<std::complex<float>> samples;
+    std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+        {
+            return samples;
+        }
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    samples.resize(size / sizeof(std::complex<float>));
+    if (!file.read(reinterpret_cast<char*>(samples.data()), samples.size() * sizeof(std::complex<float>)))
+        {
+            samples.clear();
+        }
+    return samples;
+}
@@ -0,0 +1,106 @@
+/*!
+ * \file front_end_cal_search.h
+ * \brief Parallel GPS L1 C/A search of all the PRNs in a captured buffer
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_FRONT_END_CAL_SEARCH_H_
+#define GNSS_SDR_FRONT_END_CAL_SEARCH_H_
+
+#include <complex>
+#include <string>
+#include <vector>
+
+/*!
+ * \brief Result of the search of one PRN
+ */
+struct FrontEndCalDetection
+{
+    unsigned int PRN;
+    bool detected;
+    double test_statistics;
+    double code_phase_samples;  //!< Start of a code period, interpolated between samples
+    double coarse_doppler_hz;   //!< Doppler bin of the peak [Hz]
+    double doppler_hz;          //!< Refined over the whole buffer [Hz]
+};
+
+/*!
+ * \brief Searches GPS L1 C/A satellites in samples held in memory, all the
+ * PRNs at the same time.
+ *
+ * Each PRN is a parallel code phase search over the Doppler grid, the
+ * correlation grids of \p dwells consecutive code periods added
+ * non-coherently. The test statistics is that of the fine Doppler
+ * acquisition, so Acquisition.threshold keeps its meaning. The Doppler of
+ * a detection is then refined to a fraction of a hertz: the code and the
+ * Doppler bin are wiped off the whole buffer, and the residual frequency is
+ * that of the squared prompt correlations of each code period, which the
+ * navigation bits do not affect.
+ *
+ * The Doppler wipe-off replicas are computed once and shared read-only by
+ * the worker threads; each worker takes the next PRN to search and its own
+ * FFT objects from Fft_Planner.
+ */
+class FrontEndCalSearch
+{
+public:
+    FrontEndCalSearch(long fs_in, double if_hz, int doppler_min, int doppler_max,
+            unsigned int doppler_step, float threshold, unsigned int dwells);
+
+    /*!
+     * \brief Searches \p prns in \p samples, which must hold at least one
+     * code period, with \p threads workers (0: one per hardware thread).
+     * The results are in the order of \p prns.
+     */
+    std::vector<FrontEndCalDetection> search(const std::vector<std::complex<float>> & samples,
+            const std::vector<unsigned int> & prns, unsigned int threads = 0) const;
+
+    //! Reads a capture of gr_complex samples. Returns an empty vector on error.
+    static std::vector<std::complex<float>> read_capture(const std::string & filename);
+
+    unsigned int samples_per_code() const
+    {
+        return d_samples_per_code;
+    }
+
+private:
+    FrontEndCalDetection search_prn(const std::vector<std::complex<float>> & samples, unsigned int prn) const;
+    double refine_doppler(const std::vector<std::complex<float>> & samples, const std::vector<std::complex<float>> & code,
+            unsigned int code_phase, double coarse_doppler_hz) const;
+
+    long d_fs_in;
+    double d_if_hz;
+    int d_doppler_min;
+    unsigned int d_doppler_step;
+    unsigned int d_num_doppler_bins;
+    float d_threshold;
+    unsigned int d_dwells;
+    unsigned int d_samples_per_code;
+    std::vector<std::vector<std::complex<float>>> d_wipeoffs;  // one code period per Doppler bin
+};
+
+#endif /* GNSS_SDR_FRONT_END_CAL_SEARCH_H_ */
@@ -52,7 +52,6 @@
 #include <gnuradio/blocks/file_sink.h>
 #include "concurrent_map.h"
 #include "file_configuration.h"
-#include "gps_l1_ca_pcps_acquisition_fine_doppler.h"
 #include "gnss_signal.h"
 #include "gnss_synchro.h"
 #include "gnss_block_factory.h"
@@ -76,6 +75,7 @@
 
 
 #include "front_end_cal.h"
+#include "front_end_cal_search.h"
 
 using google::LogMessage;
 
@@ -94,95 +94,6 @@ concurrent_map<Gps_Utc_Model> global_gps_utc_model_map;
 concurrent_map<Gps_Almanac> global_gps_almanac_map;
 concurrent_map<Gps_Acq_Assist> global_gps_acq_assist_map;
 
-bool stop;
-concurrent_queue<int> channel_internal_queue;
-GpsL1CaPcpsAcquisitionFineDoppler *acquisition;
-Gnss_Synchro *gnss_synchro;
-std::vector<Gnss_Synchro> gnss_sync_vector;
-
-
-// ######## GNURADIO BLOCK MESSAGE RECEVER #########
-class FrontEndCal_msg_rx;
-
-typedef boost::shared_ptr<FrontEndCal_msg_rx> FrontEndCal_msg_rx_sptr;
-
-FrontEndCal_msg_rx_sptr FrontEndCal_msg_rx_make();
-
-
-class FrontEndCal_msg_rx : public gr::block
-{
-private:
-    friend FrontEndCal_msg_rx_sptr FrontEndCal_msg_rx_make();
-    void msg_handler_events(pmt::pmt_t msg);
-    FrontEndCal_msg_rx();
-
-public:
-    int rx_message;
-    ~FrontEndCal_msg_rx(); //!< Default destructor
-};
-
-
-FrontEndCal_msg_rx_sptr FrontEndCal_msg_rx_make()
-{
-    return FrontEndCal_msg_rx_sptr(new FrontEndCal_msg_rx());
-}
-
-
-void FrontEndCal_msg_rx::msg_handler_events(pmt::pmt_t msg)
-{
-    try
-    {
-            long int message = pmt::to_long(msg);
-            rx_message = message;
-            channel_internal_queue.push(rx_message);
-    }
-    catch(boost::bad_any_cast& e)
-    {
-            LOG(WARNING) << "msg_handler_telemetry Bad any cast!\n";
-            rx_message = 0;
-    }
-}
-
-
-FrontEndCal_msg_rx::FrontEndCal_msg_rx() :
-    gr::block("FrontEndCal_msg_rx", gr::io_signature::make(0, 0, 0), gr::io_signature::make(0, 0, 0))
-{
-    this->message_port_register_in(pmt::mp("events"));
-    this->set_msg_handler(pmt::mp("events"), boost::bind(&FrontEndCal_msg_rx::msg_handler_events, this, _1));
-    rx_message = 0;
-}
-
-FrontEndCal_msg_rx::~FrontEndCal_msg_rx()
-{}
-
-// ###########################################################
-
-void wait_message()
-{
-    while (!stop)
-        {
-            int message;
-            channel_internal_queue.wait_and_pop(message);
-            //std::cout<<"Acq mesage rx="<<message<<std::endl;
-            switch (message)
-            {
-            case 1: // Positive acq
-                gnss_sync_vector.push_back(*gnss_synchro);
-                //acquisition->reset();
-                break;
-            case 2: // negative acq
-                //acquisition->reset();
-                break;
-            case 3:
-                stop = true;
-                break;
-            default:
-                break;
-            }
-        }
-}
-
-
 bool front_end_capture(std::shared_ptr<ConfigurationInterface> configuration)
 {
     gr::top_block_sptr top_block;
@@ -350,116 +261,53 @@ int main(int argc, char** argv)
             std::cout << "Exception caught while capturing samples (too few args)" << std::endl;
     }
 
-    // 4. Setup GNU Radio flowgraph (file_source -> Acquisition_10m)
-    gr::top_block_sptr top_block;
-    top_block = gr::make_top_block("Acquisition test");
-
-    // Satellite signal definition
-    gnss_synchro = new Gnss_Synchro();
-    gnss_synchro->Channel_ID = 0;
-    gnss_synchro->System = 'G';
-    std::string signal = "1C";
-    signal.copy(gnss_synchro->Signal, 2, 0);
-    gnss_synchro->PRN = 1;
-
+    // 4. Load the capture and set up the search of all the GPS satellites
     long fs_in_ = configuration->property("GNSS-SDR.internal_fs_hz", 2048000);
+    std::vector<gr_complex> capture = FrontEndCalSearch::read_capture("tmp_capture.dat");
+    FrontEndCalSearch search(fs_in_,
+            configuration->property("Acquisition.if", 0.0),
+            configuration->property("Acquisition.doppler_min", -configuration->property("Acquisition.doppler_max", 10000)),
+            configuration->property("Acquisition.doppler_max", 10000),
+            configuration->property("Acquisition.doppler_step", 250),
+            configuration->property("Acquisition.threshold", 0.0),
+            configuration->property("Acquisition.max_dwells", 1));
+    unsigned int threads = configuration->property("FrontEndCal.threads", 0);
+    std::vector<unsigned int> prns;
+    for (unsigned int PRN = 1; PRN < 33; PRN++)
+        {
+            prns.push_back(PRN);
+        }
 
-    GNSSBlockFactory block_factory;
-    acquisition = new GpsL1CaPcpsAcquisitionFineDoppler(configuration.get(), "Acquisition", 1, 1);
-
-    acquisition->set_channel(1);
-    acquisition->set_gnss_synchro(gnss_synchro);
-    acquisition->set_threshold(configuration->property("Acquisition.threshold", 0.0));
-    acquisition->set_doppler_max(configuration->property("Acquisition.doppler_max", 10000));
-    acquisition->set_doppler_step(configuration->property("Acquisition.doppler_step", 250));
-
-    gr::block_sptr source;
-    source = gr::blocks::file_source::make(sizeof(gr_complex), "tmp_capture.dat");
-
-    boost::shared_ptr<FrontEndCal_msg_rx> msg_rx = FrontEndCal_msg_rx_make();
-
-    //gr_basic_block_sptr head = gr_make_head(sizeof(gr_complex), nsamples);
-    //gr_head_sptr head_sptr = boost::dynamic_pointer_cast<gr_head>(head);
-    //head_sptr->set_length(nsamples);
-    //head_sptr->reset();
-
-    try
-    {
-            acquisition->connect(top_block);
-            top_block->connect(source, 0, acquisition->get_left_block(), 0);
-            top_block->msg_connect(acquisition->get_right_block(), pmt::mp("events"), msg_rx,pmt::mp("events"));
-    }
-    catch(const std::exception & e)
-    {
-            std::cout << "Failure connecting the GNU Radio blocks: " << e.what() << std::endl;
-    }
-
-    // 5. Run the flowgraph
+    // 5. Search all the PRNs in parallel on the captured samples
     // Get visible GPS satellites (positive acquisitions with Doppler measurements)
-    // Compute Doppler estimations
-
-    //todo: Fix the front-end cal to support new channel internal message system (no more external queues)
     std::map<int,double> doppler_measurements_map;
-    std::map<int,double> cn0_measurements_map;
-
-    boost::thread ch_thread;
 
     // record startup time
     struct timeval tv;
     gettimeofday(&tv, NULL);
     long long int begin = tv.tv_sec * 1000000 + tv.tv_usec;
 
-    bool start_msg = true;
-
-    for (unsigned int PRN=1; PRN<33; PRN++)
+    std::cout << "Searching for GPS Satellites in L1 band..." << std::endl;
+    if (capture.size() < search.samples_per_code())
         {
-            gnss_synchro->PRN = PRN;
-            acquisition->set_gnss_synchro(gnss_synchro);
-            acquisition->init();
-            acquisition->reset();
-            stop = false;
-            try
-            {
-                    ch_thread = boost::thread(wait_message);
-            }
-            catch(const boost::thread_resource_error & e)
-            {
-                    LOG(INFO) << "Exception caught (thread resource error)";
-            }
-            top_block->run();
-            if (start_msg == true)
-                {
-                    std::cout << "Searching for GPS Satellites in L1 band..." << std::endl;
-                    std::cout << "[";
-                    start_msg = false;
-                }
-            if (gnss_sync_vector.size()>0)
+            std::cout << "Not enough front-end samples in tmp_capture.dat" << std::endl;
+        }
+    std::vector<FrontEndCalDetection> detections = search.search(capture, prns, threads);
+    std::cout << "[";
+    for (std::vector<FrontEndCalDetection>::iterator it = detections.begin(); it != detections.end(); ++it)
+        {
+            if (it->detected)
                 {
-                    std::cout << " " << PRN << " ";
-                    double doppler_measurement_hz = 0;
-                    for (std::vector<Gnss_Synchro>::iterator it = gnss_sync_vector.begin() ; it != gnss_sync_vector.end(); ++it)
-                        {
-                            doppler_measurement_hz += (*it).Acq_doppler_hz;
-                        }
-                    doppler_measurement_hz = doppler_measurement_hz/gnss_sync_vector.size();
-                    doppler_measurements_map.insert(std::pair<int,double>(PRN, doppler_measurement_hz));
+                    std::cout << " " << it->PRN << " ";
+                    doppler_measurements_map.insert(std::pair<int,double>(it->PRN, it->doppler_hz));
+                    LOG(INFO) << "PRN " << it->PRN << " detected, test statistics " << it->test_statistics
+                              << ", code phase " << it->code_phase_samples << " samples, Doppler "
+                              << it->coarse_doppler_hz << " Hz refined to " << it->doppler_hz << " Hz";
                 }
             else
                 {
                     std::cout << " . ";
                 }
-            channel_internal_queue.push(3);
-            try
-            {
-                    ch_thread.join();
-            }
-            catch(const boost::thread_resource_error & e)
-            {
-                    LOG(INFO) << "Exception caught while joining threads.";
-            }
-            gnss_sync_vector.clear();
-            boost::dynamic_pointer_cast<gr::blocks::file_source>(source)->seek(0, 0);
-            std::cout.flush();
         }
     std::cout << "]" << std::endl;
 
@@ -470,10 +318,22 @@ int main(int argc, char** argv)
               << ((double)(end - begin))/1000000.0
               << " [seconds]" << std::endl;
 
-    //6. find TOW from SUPL assistance
+    //6. find TOW from SUPL assistance, or from the system clock if the
+    // ephemeris come from the receiver state
 
     double current_TOW = 0;
-    if (global_gps_ephemeris_map.size() > 0)
+    if (global_gps_ephemeris_map.size() > 0 && front_end_cal.offline())
+        {
+            int week;
+            front_end_cal.gps_time_from_clock(week, current_TOW);
+            time_t t = utc_time(week, (long int)current_TOW);
+
+            fprintf(stdout, "Reference Time (system clock):\n");
+            fprintf(stdout, "  GPS Week: %d\n", week);
+            fprintf(stdout, "  GPS TOW:  %ld\n", (long int)current_TOW);
+            fprintf(stdout, "  ~ UTC:    %s", ctime(&t));
+        }
+    else if (global_gps_ephemeris_map.size() > 0)
         {
             std::map<int,Gps_Ephemeris> Eph_map;
             Eph_map = global_gps_ephemeris_map.get_map_copy();
@@ -490,8 +350,6 @@ int main(int argc, char** argv)
     else
         {
             std::cout << "Unable to get Ephemeris SUPL assistance. TOW is unknown!" << std::endl;
-            delete acquisition;
-            delete gnss_synchro;
             google::ShutDownCommandLineFlags();
             std::cout << "GNSS-SDR Front-end calibration program ended." << std::endl;
             return 0;
@@ -502,7 +360,14 @@ int main(int argc, char** argv)
     double lon_deg = configuration->property("GNSS-SDR.init_longitude_deg", 2.0);
     double altitude_m = configuration->property("GNSS-SDR.init_altitude_m", 100);
 
-    std::cout << "Reference location (defined in config file):" << std::endl;
+    if (front_end_cal.receiver_position(lat_deg, lon_deg, altitude_m))
+        {
+            std::cout << "Reference location (saved in the receiver state):" << std::endl;
+        }
+    else
+        {
+            std::cout << "Reference location (defined in config file):" << std::endl;
+        }
 
     std::cout << "Latitude=" << lat_deg << " [�]" << std::endl;
     std::cout << "Longitude=" << lon_deg << " [�]" << std::endl;
@@ -511,8 +376,6 @@ int main(int argc, char** argv)
     if (doppler_measurements_map.size() == 0)
         {
             std::cout << "Sorry, no GPS satellites detected in the front-end capture, please check the antenna setup..." << std::endl;
-            delete acquisition;
-            delete gnss_synchro;
             google::ShutDownCommandLineFlags();
             std::cout << "GNSS-SDR Front-end calibration program ended." << std::endl;
             return 0;
@@ -608,10 +471,6 @@ int main(int argc, char** argv)
 
     // 8. Generate GNSS-SDR config file.
 
-
-    delete acquisition;
-    delete gnss_synchro;
-
     google::ShutDownCommandLineFlags();
     std::cout << "GNSS-SDR Front-end calibration program ended." << std::endl;
 }
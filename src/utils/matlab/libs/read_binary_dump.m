@@ -0,0 +1,52 @@
+% GNSS-SDR developers 2016
+function [dump] = read_binary_dump (filename, count)
+
+  %% usage: read_binary_dump (filename, [count])
+  %%
+  %% open a GNSS-SDR self-describing binary dump file (see
+  %% src/algorithms/libs/binary_dump_format.h) and return a struct with
+  %% one field per dumped variable, plus block_type. Array fields have
+  %% one column per record
+  %%
+
+  if (nargin < 2)
+    count = Inf;
+  end
+  types = {'int8', 'uint8', 'int16', 'uint16', 'int32', 'uint32', 'int64', 'uint64', 'float32', 'float64'};
+  sizes = [1 1 2 2 4 4 8 8 4 8];
+
+  dump = [];
+  f = fopen (filename, 'rb');
+  if (f < 0)
+    return;
+  end
+  magic = fread (f, 8, 'char=>char')';
+  if (~strcmp (magic, 'GNSSDUMP'))
+    fclose (f);
+    error ('%s is not a binary dump file', filename);
+  end
+  header = fread (f, 6, 'uint32');
+  header_size = header(3);
+  record_size = header(4);
+  n_fields = header(5);
+  block_type = fread (f, 32, 'char=>char')';
+  dump.block_type = deblank (strtok (block_type, char (0)));
+  for N=1:1:n_fields
+    name = fread (f, 32, 'char=>char')';
+    name = strtok (name, char (0));
+    type_and_offset = fread (f, 2, 'uint32');
+    field_type = bitand (type_and_offset(1), 255) + 1;
+    n_values = bitshift (type_and_offset(1), -8) + 1;
+    % read the column, skipping the rest of each record. The values of an
+    % array field end up in one column per record
+    fseek (f, header_size + type_and_offset(2), 'bof');
+    if (n_values == 1)
+      dump.(name) = fread (f, count, types{field_type}, record_size - sizes(field_type))';
+    else
+      dump.(name) = fread (f, [n_values, count], sprintf ('%d*%s', n_values, types{field_type}), ...
+                           record_size - n_values * sizes(field_type));
+    end
+    fseek (f, 64 + N * 40, 'bof'); % move to the next field descriptor
+  end
+  fclose (f);
+end
@@ -0,0 +1,333 @@
+/*!
+ * \file main.cc
+ * \brief Performance regression runner of the benchmarks of GNSS-SDR
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Runs the benchmarks of GNSS-SDR several times with fixed inputs: the
+ * kernel timings of volk_gnsssdr_profile, acq_benchmark over the captures
+ * of src/tests/signal_samples, trk_benchmark over generated signals,
+ * backend_benchmark over given tracking dumps and gnss-sdr-bench over a
+ * synthetic scene. The results are stored in a JSON file, keyed by the
+ * commit and the CPU model, and compared with a previous run on the same
+ * CPU model. The exit status is 2 if there are significant slowdowns.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include "perf_compare.h"
+#include "perf_reports.h"
+#include "perf_store.h"
+
+
+using google::LogMessage;
+
+DEFINE_string(benchmarks, "volk,acq,trk,bench", "Comma-separated list of benchmarks: volk, acq, trk, backend and bench");
+DEFINE_int32(repetitions, 5, "Runs of each benchmark. The significance test needs at least 2");
+DEFINE_string(store, "./gnss_sdr_perf.json", "JSON file of the stored runs");
+DEFINE_bool(save, true, "Adds this run to the store");
+DEFINE_string(commit, "", "Commit of this run. If empty, the HEAD of the source tree");
+DEFINE_string(cpu_model, "", "CPU model of this run. If empty, the one of /proc/cpuinfo");
+DEFINE_string(baseline_commit, "", "Commit compared with. If empty, the last stored run of another commit on the same CPU model");
+DEFINE_double(significance, 0.01, "Maximum p-value of a significant change");
+DEFINE_double(threshold_percent, 3.0, "Minimum slowdown of a regression [%]");
+DEFINE_string(work_dir, "./perf_work", "Directory of the reports, logs and scene of the benchmarks");
+DEFINE_string(tests_bin_dir, GNSS_SDR_PERF_TESTS_BIN_DIR, "Directory of acq_benchmark, trk_benchmark and backend_benchmark");
+DEFINE_string(bench, GNSS_SDR_PERF_SOURCE_DIR "/install/gnss-sdr-bench", "gnss-sdr-bench executable");
+DEFINE_string(volk_profile, "volk_gnsssdr_profile", "volk_gnsssdr_profile executable");
+DEFINE_string(volk_regex, "", "If not empty, only the kernels that match it are timed");
+DEFINE_string(backend_dumps, "", "Tracking dumps of backend_benchmark, required by the backend benchmark");
+DEFINE_double(scene_duration_s, 20.0, "Duration of the scene of gnss-sdr-bench [s]");
+
+namespace
+{
+// Inputs of the benchmarks that do not depend on their defaults, so that
+// changing those does not invalidate the stored runs
+const char * BENCH_SCENE = "--gps=8 --galileo=4 --e5a=0 --cn0_db=45 --fs_hz=4000000 --item_type=gr_complex";
+
+std::string quoted(const std::string & s)
+{
+    return "'" + s + "'";
+}
+
+
+std::string command_output(const std::string & command)
+{
+    std::string output;
+    FILE * pipe = popen(command.c_str(), "r");
+    if (pipe == nullptr)
+        {
+            return output;
+        }
+    char buffer[256];
+    while (fgets(buffer, sizeof(buffer), pipe) != nullptr)
+        {
+            output += buffer;
+        }
+    pclose(pipe);
+    while (!output.empty() && (output[output.size() - 1] == '\n' || output[output.size() - 1] == '\r'))
+        {
+            output.erase(output.size() - 1);
+        }
+    return output;
+}
+
+
+std::string cpu_model()
+{
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line))
+        {
+            if (line.compare(0, 10, "model name") != 0) continue;
+            const std::string::size_type colon = line.find(':');
+            if (colon != std::string::npos)
+                {
+                    return line.substr(line.find_first_not_of(' ', colon + 1));
+                }
+        }
+    const std::string machine = command_output("uname -m");
+    return machine.empty() ? "unknown" : machine;
+}
+
+
+std::string utc_date()
+{
+    char date[32];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return date;
+}
+
+
+//! Runs the benchmark and adds its results to run
+bool run_benchmark(const std::string & benchmark, const std::string & work_dir, PerfRun & run)
+{
+    const std::string log = quoted(work_dir + "/" + benchmark + ".log");
+    const std::string report = work_dir + "/" + benchmark + (benchmark == "volk" ? ".json" : benchmark == "bench" ? ".txt" : ".csv");
+    boost::filesystem::remove(report);
+
+    std::string command;
+    if (benchmark == "volk")
+        {
+            command = quoted(FLAGS_volk_profile) + " --dry-run --timings --json " + quoted(report);
+            if (!FLAGS_volk_regex.empty())
+                {
+                    command += " --tests-regex " + quoted(FLAGS_volk_regex);
+                }
+            command += " > " + log + " 2>&1";
+        }
+    else if (benchmark == "acq")
+        {
+            // The captures are read from the directory of the tests
+            command = "cd " + quoted(GNSS_SDR_PERF_SOURCE_DIR "/src/tests") + " && "
+                    + quoted(FLAGS_tests_bin_dir + "/acq_benchmark") + " --acq_benchmark_report=" + quoted(report)
+                    + " > " + log + " 2>&1";
+        }
+    else if (benchmark == "trk")
+        {
+            command = quoted(FLAGS_tests_bin_dir + "/trk_benchmark") + " --trk_benchmark_report=" + quoted(report)
+                    + " > " + log + " 2>&1";
+        }
+    else if (benchmark == "backend")
+        {
+            if (FLAGS_backend_dumps.empty())
+                {
+                    std::cerr << "The backend benchmark needs --backend_dumps" << std::endl;
+                    return false;
+                }
+            command = quoted(FLAGS_tests_bin_dir + "/backend_benchmark") + " --backend_benchmark_dumps=" + quoted(FLAGS_backend_dumps)
+                    + " --backend_benchmark_report=" + quoted(report) + " > " + log + " 2>&1";
+        }
+    else if (benchmark == "bench")
+        {
+            // The scene is generated in the first repetition only
+            std::ostringstream duration;
+            duration << FLAGS_scene_duration_s;
+            command = quoted(FLAGS_bench) + " " + BENCH_SCENE + " --duration_s=" + duration.str()
+                    + " --scene_file=" + quoted(work_dir + "/perf_scene.dat") + " --reuse_scene"
+                    + " > " + quoted(report) + " 2> " + log;
+        }
+    else
+        {
+            std::cerr << "Unknown benchmark " << benchmark << std::endl;
+            return false;
+        }
+
+    LOG(INFO) << "Running " << command;
+    if (std::system(command.c_str()) != 0)
+        {
+            std::cerr << "The " << benchmark << " benchmark failed, see " << log << std::endl;
+            return false;
+        }
+
+    std::set<std::string> ignored;
+    if (benchmark == "volk")
+        {
+            return perf_read_volk_timings(report, "median", run);
+        }
+    if (benchmark == "acq")
+        {
+            ignored.insert("searches");
+            return perf_read_csv(report, benchmark, 4, ignored, run);
+        }
+    if (benchmark == "trk")
+        {
+            ignored.insert("epochs");
+            return perf_read_csv(report, benchmark, 4, ignored, run);
+        }
+    if (benchmark == "backend")
+        {
+            ignored.insert("blocks");
+            ignored.insert("epochs");
+            return perf_read_csv(report, benchmark, 1, ignored, run);
+        }
+    // The CPU shares add up to one and are not compared
+    std::set<std::string> keys;
+    keys.insert("wall_s");
+    keys.insert("speed_factor");
+    keys.insert("channel_cost");
+    keys.insert("fixed_cost");
+    return perf_read_key_values(report, benchmark, keys, run);
+}
+}
+
+
+int main(int argc, char** argv)
+{
+    google::SetUsageMessage("Runs the benchmarks of GNSS-SDR, stores the results and reports the significant slowdowns");
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    PerfRun run;
+    run.commit = FLAGS_commit.empty() ? command_output("git -C " + quoted(GNSS_SDR_PERF_SOURCE_DIR) + " rev-parse HEAD") : FLAGS_commit;
+    run.cpu_model = FLAGS_cpu_model.empty() ? cpu_model() : FLAGS_cpu_model;
+    run.date = utc_date();
+    if (run.commit.empty())
+        {
+            std::cerr << "The commit is unknown: set --commit" << std::endl;
+            google::ShutDownCommandLineFlags();
+            return 1;
+        }
+
+    PerfStore store;
+    if (!store.load(FLAGS_store))
+        {
+            google::ShutDownCommandLineFlags();
+            return 1;
+        }
+
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(FLAGS_work_dir, ec);
+    const std::string work_dir = boost::filesystem::canonical(FLAGS_work_dir, ec).string();
+    if (ec)
+        {
+            std::cerr << "Cannot create " << FLAGS_work_dir << std::endl;
+            google::ShutDownCommandLineFlags();
+            return 1;
+        }
+
+    std::vector<std::string> benchmarks;
+    std::stringstream list(FLAGS_benchmarks);
+    std::string benchmark;
+    while (std::getline(list, benchmark, ','))
+        {
+            if (!benchmark.empty()) benchmarks.push_back(benchmark);
+        }
+
+    std::cout << "Commit " << run.commit << " on " << run.cpu_model << std::endl;
+    const int repetitions = std::max(FLAGS_repetitions, 1);
+    for (int r = 0; r < repetitions; r++)
+        {
+            for (unsigned int b = 0; b < benchmarks.size(); b++)
+                {
+                    std::cout << "Repetition " << r + 1 << "/" << repetitions << ": " << benchmarks.at(b) << " ..." << std::endl;
+                    if (!run_benchmark(benchmarks.at(b), work_dir, run))
+                        {
+                            google::ShutDownCommandLineFlags();
+                            return 1;
+                        }
+                }
+        }
+
+    int status = 0;
+    const PerfRun * baseline = store.baseline(run.cpu_model, run.commit, FLAGS_baseline_commit);
+    if (baseline == nullptr)
+        {
+            std::cout << "No stored run to compare with on this CPU model" << std::endl;
+        }
+    else
+        {
+            std::vector<PerfChange> changes = perf_compare(*baseline, run, FLAGS_significance, FLAGS_threshold_percent);
+            unsigned int regressions = 0;
+            unsigned int improvements = 0;
+            std::cout << "Compared with " << baseline->commit << " (" << baseline->date << "), "
+                      << changes.size() << " metrics:" << std::endl;
+            for (unsigned int i = 0; i < changes.size(); i++)
+                {
+                    const PerfChange & c = changes.at(i);
+                    if (!c.regression && !c.improvement) continue;
+                    char line[64];
+                    snprintf(line, sizeof(line), "%+7.2f%% p=%.2g", c.slowdown_percent, c.p_value);
+                    std::cout << (c.regression ? "SLOWER  " : "FASTER  ") << line << "  " << c.name
+                              << " (" << c.baseline_mean << " -> " << c.current_mean << ")" << std::endl;
+                    if (c.regression)
+                        {
+                            regressions++;
+                        }
+                    else
+                        {
+                            improvements++;
+                        }
+                }
+            std::cout << regressions << " significant slowdowns, " << improvements << " significant speedups" << std::endl;
+            status = regressions > 0 ? 2 : 0;
+        }
+
+    if (FLAGS_save)
+        {
+            store.add(run);
+            if (!store.save(FLAGS_store))
+                {
+                    std::cerr << "Cannot write " << FLAGS_store << std::endl;
+                    status = 1;
+                }
+        }
+
+    google::ShutDownCommandLineFlags();
+    return status;
+}
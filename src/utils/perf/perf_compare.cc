@@ -0,0 +1,106 @@
+/*!
+ * \file perf_compare.cc
+ * \brief Significant changes of the metrics between two runs of the benchmarks
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "perf_compare.h"
+#include <cmath>
+#include <boost/math/distributions/students_t.hpp>
+
+namespace
+{
+void mean_variance(const std::vector<double> & x, double & mean, double & variance)
+{
+    mean = 0.0;
+    for (unsigned int i = 0; i < x.size(); i++)
+        {
+            mean += x.at(i);
+        }
+    mean /= x.size();
+    variance = 0.0;
+    for (unsigned int i = 0; i < x.size(); i++)
+        {
+            variance += (x.at(i) - mean) * (x.at(i) - mean);
+        }
+    variance = x.size() > 1 ? variance / (x.size() - 1) : 0.0;
+}
+}
+
+
+double perf_welch_p_value(const std::vector<double> & a, const std::vector<double> & b)
+{
+    if (a.size() < 2 || b.size() < 2)
+        {
+            return 1.0;
+        }
+    double mean_a, var_a, mean_b, var_b;
+    mean_variance(a, mean_a, var_a);
+    mean_variance(b, mean_b, var_b);
+    const double se2_a = var_a / a.size();
+    const double se2_b = var_b / b.size();
+    const double se2 = se2_a + se2_b;
+    if (se2 <= 0.0)
+        {
+            // Repetitions without noise: any difference is significant
+            return mean_a == mean_b ? 1.0 : 0.0;
+        }
+    const double t = (mean_a - mean_b) / std::sqrt(se2);
+    // Welch-Satterthwaite degrees of freedom
+    const double df = se2 * se2 / (se2_a * se2_a / (a.size() - 1) + se2_b * se2_b / (b.size() - 1));
+    boost::math::students_t dist(df);
+    return 2.0 * boost::math::cdf(boost::math::complement(dist, std::fabs(t)));
+}
+
+
+std::vector<PerfChange> perf_compare(const PerfRun & baseline, const PerfRun & current,
+        double significance, double threshold_percent)
+{
+    std::vector<PerfChange> changes;
+    for (std::map<std::string, PerfMetric>::const_iterator it = current.metrics.begin(); it != current.metrics.end(); ++it)
+        {
+            std::map<std::string, PerfMetric>::const_iterator base = baseline.metrics.find(it->first);
+            if (base == baseline.metrics.end() || base->second.values.empty() || it->second.values.empty()) continue;
+            PerfChange change;
+            change.name = it->first;
+            change.baseline_n = base->second.values.size();
+            change.current_n = it->second.values.size();
+            double variance;
+            mean_variance(base->second.values, change.baseline_mean, variance);
+            mean_variance(it->second.values, change.current_mean, variance);
+            // A throughput is turned into the time it takes to process the same work
+            const double before = it->second.higher_is_better ? change.current_mean : change.baseline_mean;
+            const double after = it->second.higher_is_better ? change.baseline_mean : change.current_mean;
+            change.slowdown_percent = before > 0.0 ? 100.0 * (after - before) / before : 0.0;
+            change.p_value = perf_welch_p_value(base->second.values, it->second.values);
+            const bool significant = change.p_value < significance;
+            change.regression = significant && change.slowdown_percent > threshold_percent;
+            change.improvement = significant && change.slowdown_percent < -threshold_percent;
+            changes.push_back(change);
+        }
+    return changes;
+}
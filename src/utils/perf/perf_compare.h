@@ -0,0 +1,72 @@
+/*!
+ * \file perf_compare.h
+ * \brief Significant changes of the metrics between two runs of the benchmarks
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * A change of a metric is significant when Welch's t-test rejects equal
+ * means of the repetitions of the two runs, which does not assume that
+ * both runs are equally noisy. It is reported as a regression or an
+ * improvement only if it is also larger than a threshold, so that tiny
+ * but consistent changes do not fail a release.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PERF_COMPARE_H_
+#define GNSS_SDR_PERF_COMPARE_H_
+
+#include <string>
+#include <vector>
+#include "perf_store.h"
+
+
+struct PerfChange
+{
+    std::string name;
+    unsigned int baseline_n;
+    unsigned int current_n;
+    double baseline_mean;
+    double current_mean;
+    double slowdown_percent;   //!< Increase of the time, or of the inverse of the throughput
+    double p_value;            //!< 1 if there are less than two values in a run
+    bool regression;
+    bool improvement;
+};
+
+
+//! Two-sided p-value of Welch's t-test of equal means
+double perf_welch_p_value(const std::vector<double> & a, const std::vector<double> & b);
+
+/*!
+ * \brief Changes of the metrics of current that are also in baseline.
+ *
+ * A change is a regression (an improvement) if its p-value is below
+ * significance and the slowdown is above threshold_percent (below
+ * -threshold_percent).
+ */
+std::vector<PerfChange> perf_compare(const PerfRun & baseline, const PerfRun & current,
+        double significance, double threshold_percent);
+
+#endif /*GNSS_SDR_PERF_COMPARE_H_*/
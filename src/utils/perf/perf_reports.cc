@@ -0,0 +1,165 @@
+/*!
+ * \file perf_reports.cc
+ * \brief Readers of the outputs of the benchmarks of GNSS-SDR
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "perf_reports.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <boost/foreach.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+namespace pt = boost::property_tree;
+
+namespace
+{
+std::vector<std::string> split(const std::string & line, char separator)
+{
+    std::vector<std::string> fields;
+    std::stringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, separator))
+        {
+            fields.push_back(field);
+        }
+    return fields;
+}
+
+bool parse_number(const std::string & text, double & value)
+{
+    if (text.empty()) return false;
+    char * end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return *end == '\0' || *end == '\r';
+}
+
+bool ends_with(const std::string & s, const std::string & suffix)
+{
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+}
+
+
+bool perf_higher_is_better(const std::string & column)
+{
+    return ends_with(column, "_per_s") || column == "speed_factor" || column == "channels_sustained";
+}
+
+
+bool perf_read_csv(const std::string & filename, const std::string & benchmark,
+        unsigned int key_columns, const std::set<std::string> & ignored, PerfRun & run)
+{
+    std::ifstream file(filename.c_str());
+    std::string line;
+    if (!std::getline(file, line))
+        {
+            return false;
+        }
+    const std::vector<std::string> header = split(line, ',');
+    if (header.size() <= key_columns)
+        {
+            return false;
+        }
+    while (std::getline(file, line))
+        {
+            const std::vector<std::string> fields = split(line, ',');
+            if (fields.size() < header.size()) continue;
+            std::string row;
+            for (unsigned int i = 0; i < key_columns; i++)
+                {
+                    row += (i ? "/" : "") + fields.at(i);
+                }
+            for (unsigned int i = key_columns; i < header.size(); i++)
+                {
+                    double value;
+                    if (ignored.count(header.at(i)) || !parse_number(fields.at(i), value)) continue;
+                    run.add_value(benchmark + ":" + row + ":" + header.at(i), perf_higher_is_better(header.at(i)), value);
+                }
+        }
+    return true;
+}
+
+
+bool perf_read_key_values(const std::string & filename, const std::string & benchmark,
+        const std::set<std::string> & keys, PerfRun & run)
+{
+    std::ifstream file(filename.c_str());
+    if (!file.is_open())
+        {
+            return false;
+        }
+    std::string line;
+    unsigned int found = 0;
+    while (std::getline(file, line))
+        {
+            const std::string::size_type equal = line.find('=');
+            if (equal == std::string::npos) continue;
+            const std::string key = line.substr(0, equal);
+            double value;
+            if (!keys.count(key) || !parse_number(line.substr(equal + 1), value)) continue;
+            run.add_value(benchmark + "::" + key, perf_higher_is_better(key), value);
+            found++;
+        }
+    return found > 0;
+}
+
+
+bool perf_read_volk_timings(const std::string & filename, const std::string & statistic, PerfRun & run)
+{
+    pt::ptree root;
+    try
+    {
+            pt::read_json(filename, root);
+            if (root.get<int>("schema_version", 1) < 2)
+                {
+                    std::cerr << filename << " has no timings: run volk_gnsssdr_profile with --timings" << std::endl;
+                    return false;
+                }
+            BOOST_FOREACH(const pt::ptree::value_type & test, root.get_child("volk_gnsssdr_tests"))
+            {
+                const std::string kernel = test.second.get<std::string>("name");
+                BOOST_FOREACH(const pt::ptree::value_type & timing, test.second.get_child("timings"))
+                {
+                    const std::string row = timing.second.get<std::string>("arch")
+                        + "/" + timing.second.get<std::string>("vlen")
+                        + "/" + timing.second.get<std::string>("data")
+                        + "/" + timing.second.get<std::string>("cache");
+                    run.add_value("volk:" + kernel + "/" + row + ":ns_" + statistic, false, timing.second.get<double>(statistic));
+                }
+            }
+    }
+    catch (const pt::ptree_error & error)
+    {
+            std::cerr << "Error reading " << filename << ": " << error.what() << std::endl;
+            return false;
+    }
+    return true;
+}
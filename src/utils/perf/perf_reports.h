@@ -0,0 +1,67 @@
+/*!
+ * \file perf_reports.h
+ * \brief Readers of the outputs of the benchmarks of GNSS-SDR
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The benchmarks of GNSS-SDR write their results in three formats: the
+ * CSV reports of acq_benchmark, trk_benchmark and backend_benchmark, the
+ * key=value lines of gnss-sdr-bench and the JSON timings of
+ * volk_gnsssdr_profile. Each figure becomes a metric of a PerfRun named
+ * benchmark:row:column, where the row is made of the fields that identify
+ * a configuration (implementation, sampling frequency, ...).
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PERF_REPORTS_H_
+#define GNSS_SDR_PERF_REPORTS_H_
+
+#include <set>
+#include <string>
+#include <vector>
+#include "perf_store.h"
+
+
+//! True for throughputs (..._per_s, speed_factor, channels_sustained), false for times and costs
+bool perf_higher_is_better(const std::string & column);
+
+/*!
+ * \brief Adds the rows of a CSV report with a header line to run.
+ *
+ * The first key_columns columns identify the row. The columns in ignored
+ * (counts, such as the number of epochs) and the non numeric values are
+ * skipped.
+ */
+bool perf_read_csv(const std::string & filename, const std::string & benchmark,
+        unsigned int key_columns, const std::set<std::string> & ignored, PerfRun & run);
+
+//! Adds the key=value lines of filename whose key is in keys
+bool perf_read_key_values(const std::string & filename, const std::string & benchmark,
+        const std::set<std::string> & keys, PerfRun & run);
+
+//! Adds the statistic (median, mean, ...) of the timings of volk_gnsssdr_profile --json -T
+bool perf_read_volk_timings(const std::string & filename, const std::string & statistic, PerfRun & run);
+
+#endif /*GNSS_SDR_PERF_REPORTS_H_*/
@@ -0,0 +1,177 @@
+/*!
+ * \file perf_store.cc
+ * \brief Runs of the benchmarks, keyed by commit and CPU model, in a JSON file
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "perf_store.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <boost/filesystem.hpp>
+#include <boost/foreach.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+namespace pt = boost::property_tree;
+
+namespace
+{
+const int SCHEMA_VERSION = 1;
+
+std::string json_string(const std::string & s)
+{
+    std::string quoted = "\"";
+    for (unsigned int i = 0; i < s.size(); i++)
+        {
+            if (s[i] == '"' || s[i] == '\\')
+                {
+                    quoted += '\\';
+                }
+            quoted += s[i];
+        }
+    return quoted + "\"";
+}
+}
+
+
+void PerfRun::add_value(const std::string & name, bool higher_is_better, double value)
+{
+    PerfMetric & metric = metrics[name];
+    metric.higher_is_better = higher_is_better;
+    metric.values.push_back(value);
+}
+
+
+bool PerfStore::load(const std::string & filename)
+{
+    runs_.clear();
+    if (!boost::filesystem::exists(filename))
+        {
+            return true;
+        }
+    pt::ptree root;
+    try
+    {
+            pt::read_json(filename, root);
+            // Metric names may have dots, so they are values and not keys
+            BOOST_FOREACH(const pt::ptree::value_type & r, root.get_child("runs"))
+            {
+                PerfRun run;
+                run.commit = r.second.get<std::string>("commit");
+                run.cpu_model = r.second.get<std::string>("cpu_model");
+                run.date = r.second.get<std::string>("date", "");
+                BOOST_FOREACH(const pt::ptree::value_type & m, r.second.get_child("metrics"))
+                {
+                    const std::string name = m.second.get<std::string>("name");
+                    const bool higher_is_better = m.second.get<bool>("higher_is_better", false);
+                    BOOST_FOREACH(const pt::ptree::value_type & v, m.second.get_child("values"))
+                    {
+                        run.add_value(name, higher_is_better, v.second.get_value<double>());
+                    }
+                }
+                runs_.push_back(run);
+            }
+    }
+    catch (const pt::ptree_error & error)
+    {
+            std::cerr << "Error reading " << filename << ": " << error.what() << std::endl;
+            runs_.clear();
+            return false;
+    }
+    return true;
+}
+
+
+bool PerfStore::save(const std::string & filename) const
+{
+    std::ofstream file(filename.c_str());
+    if (!file.is_open())
+        {
+            return false;
+        }
+    file << std::setprecision(std::numeric_limits<double>::digits10);
+    file << "{" << std::endl;
+    file << " \"schema_version\": " << SCHEMA_VERSION << "," << std::endl;
+    file << " \"runs\": [" << std::endl;
+    for (unsigned int i = 0; i < runs_.size(); i++)
+        {
+            const PerfRun & run = runs_.at(i);
+            file << "  {" << std::endl;
+            file << "   \"commit\": " << json_string(run.commit) << "," << std::endl;
+            file << "   \"cpu_model\": " << json_string(run.cpu_model) << "," << std::endl;
+            file << "   \"date\": " << json_string(run.date) << "," << std::endl;
+            file << "   \"metrics\": [" << std::endl;
+            for (std::map<std::string, PerfMetric>::const_iterator it = run.metrics.begin(); it != run.metrics.end(); ++it)
+                {
+                    file << "    {\"name\": " << json_string(it->first)
+                         << ", \"higher_is_better\": " << (it->second.higher_is_better ? "true" : "false")
+                         << ", \"values\": [";
+                    for (unsigned int k = 0; k < it->second.values.size(); k++)
+                        {
+                            file << (k ? ", " : "") << it->second.values.at(k);
+                        }
+                    file << "]}" << (std::next(it) != run.metrics.end() ? "," : "") << std::endl;
+                }
+            file << "   ]" << std::endl;
+            file << "  }" << (i + 1 < runs_.size() ? "," : "") << std::endl;
+        }
+    file << " ]" << std::endl;
+    file << "}" << std::endl;
+    return file.good();
+}
+
+
+void PerfStore::add(const PerfRun & run)
+{
+    for (std::vector<PerfRun>::iterator it = runs_.begin(); it != runs_.end(); ++it)
+        {
+            if (it->commit == run.commit && it->cpu_model == run.cpu_model)
+                {
+                    runs_.erase(it);
+                    break;
+                }
+        }
+    runs_.push_back(run);
+}
+
+
+const PerfRun * PerfStore::baseline(const std::string & cpu_model, const std::string & commit,
+        const std::string & baseline_commit) const
+{
+    for (std::vector<PerfRun>::const_reverse_iterator it = runs_.rbegin(); it != runs_.rend(); ++it)
+        {
+            if (it->cpu_model != cpu_model) continue;
+            if (baseline_commit.empty() ? it->commit != commit : it->commit == baseline_commit)
+                {
+                    return &(*it);
+                }
+        }
+    return nullptr;
+}
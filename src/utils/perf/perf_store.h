@@ -0,0 +1,94 @@
+/*!
+ * \file perf_store.h
+ * \brief Runs of the benchmarks, keyed by commit and CPU model, in a JSON file
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Each run of gnss-sdr-perf is stored with the commit it measured and the
+ * CPU model it ran on, so that a run is only compared with the runs of
+ * another commit on the same kind of machine. Every metric keeps the
+ * values of all the repetitions, which the significance test needs.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef GNSS_SDR_PERF_STORE_H_
+#define GNSS_SDR_PERF_STORE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+
+struct PerfMetric
+{
+    bool higher_is_better;        //!< Throughputs, as opposed to times
+    std::vector<double> values;   //!< One per repetition
+};
+
+
+struct PerfRun
+{
+    std::string commit;
+    std::string cpu_model;
+    std::string date;             //!< UTC, ISO 8601
+    std::map<std::string, PerfMetric> metrics;
+
+    void add_value(const std::string & name, bool higher_is_better, double value);
+};
+
+
+/*!
+ * \brief Runs of gnss-sdr-perf, saved in a JSON file.
+ *
+ * The runs are kept in the order they were added. A new run of a commit
+ * on a CPU model replaces the previous one.
+ */
+class PerfStore
+{
+public:
+    //! A missing file is an empty store
+    bool load(const std::string & filename);
+    bool save(const std::string & filename) const;
+
+    void add(const PerfRun & run);
+
+    /*!
+     * The run of baseline_commit on cpu_model or, if baseline_commit is
+     * empty, the last one added on cpu_model for a commit other than
+     * commit. Null if there is none.
+     */
+    const PerfRun * baseline(const std::string & cpu_model, const std::string & commit,
+            const std::string & baseline_commit) const;
+
+    const std::vector<PerfRun> & runs() const
+    {
+        return runs_;
+    }
+
+private:
+    std::vector<PerfRun> runs_;
+};
+
+#endif /*GNSS_SDR_PERF_STORE_H_*/
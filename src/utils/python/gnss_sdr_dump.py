@@ -0,0 +1,127 @@
+"""
+ \file gnss_sdr_dump.py
+ \brief Reader of the self-describing binary dump files (see
+  src/algorithms/libs/binary_dump_format.h) for analysis with numpy.
+ \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+
+ The records are memory-mapped as a numpy structured array, so that
+ opening a dump file does not read it:
+
+   import gnss_sdr_dump
+   dump = gnss_sdr_dump.load('tracking_ch_0.dat')
+   print(dump.block_type, dump.records.dtype.names)
+   cn0 = dump.records['CN0_SNV_dB_Hz']
+
+ Array fields are numpy subarrays: dump.records['grid'] has one row per
+ record.
+
+ -------------------------------------------------------------------------
+
+ Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+
+ GNSS-SDR is a software defined Global Navigation
+          Satellite Systems receiver
+
+ This file is part of GNSS-SDR.
+
+ GNSS-SDR is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ GNSS-SDR is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+
+ -------------------------------------------------------------------------
+"""
+
+import struct
+import numpy
+
+MAGIC = b'GNSSDUMP'
+VERSIONS = (1, 2)
+BYTE_ORDER_MARK = 0x01020304
+HEADER_FIXED_SIZE = 64
+FIELD_DESCRIPTOR_SIZE = 40
+NAME_LENGTH = 32
+TYPE_MASK = 0xFF
+COUNT_SHIFT = 8
+
+# Binary_Dump_Field_Type
+FIELD_TYPES = ['i1', 'u1', 'i2', 'u2', 'i4', 'u4', 'i8', 'u8', 'f4', 'f8']
+
+
+class Dump(object):
+    """Header and memory-mapped records of a dump file"""
+
+    def __init__(self, block_type, version, fields, records):
+        self.block_type = block_type
+        self.version = version
+        self.fields = fields      # list of (name, numpy type, offset, count)
+        self.records = records    # numpy structured array, one row per record
+
+    def __len__(self):
+        return len(self.records)
+
+
+def _name(raw):
+    return raw.split(b'\0', 1)[0].decode('ascii')
+
+
+def load(filename):
+    """Maps a dump file. Raises ValueError if it is not a valid one."""
+    with open(filename, 'rb') as f:
+        fixed = f.read(HEADER_FIXED_SIZE)
+        if len(fixed) < HEADER_FIXED_SIZE or fixed[0:8] != MAGIC:
+            raise ValueError(filename + ' is not a binary dump file')
+        # the byte order mark tells the byte order of the writer
+        if struct.unpack('<I', fixed[12:16])[0] == BYTE_ORDER_MARK:
+            order = '<'
+        elif struct.unpack('>I', fixed[12:16])[0] == BYTE_ORDER_MARK:
+            order = '>'
+        else:
+            raise ValueError(filename + ': unknown byte order')
+        version, _, header_size, record_size, n_fields, _ = struct.unpack(order + '6I', fixed[8:32])
+        if version not in VERSIONS:
+            raise ValueError(filename + ': format version %d is not supported' % version)
+        block_type = _name(fixed[32:64])
+        descriptors = f.read(n_fields * FIELD_DESCRIPTOR_SIZE)
+        if len(descriptors) < n_fields * FIELD_DESCRIPTOR_SIZE:
+            raise ValueError(filename + ': truncated header')
+
+    fields = []
+    for i in range(n_fields):
+        d = descriptors[i * FIELD_DESCRIPTOR_SIZE:(i + 1) * FIELD_DESCRIPTOR_SIZE]
+        type_word, offset = struct.unpack(order + '2I', d[NAME_LENGTH:NAME_LENGTH + 8])
+        field_type = type_word & TYPE_MASK
+        count = (type_word >> COUNT_SHIFT) + 1
+        if field_type >= len(FIELD_TYPES):
+            raise ValueError(filename + ': unknown field type %d' % field_type)
+        fields.append((_name(d[0:NAME_LENGTH]), order + FIELD_TYPES[field_type], offset, count))
+
+    dtype = numpy.dtype({'names': [f[0] for f in fields],
+                         'formats': [f[1] if f[3] == 1 else (f[1], (f[3],)) for f in fields],
+                         'offsets': [f[2] for f in fields],
+                         'itemsize': record_size})
+    size = numpy.memmap(filename, dtype='u1', mode='r').size
+    # a record cut by the end of the file is not counted
+    n_records = (size - header_size) // record_size
+    if n_records > 0:
+        records = numpy.memmap(filename, dtype=dtype, mode='r', offset=header_size, shape=(n_records,))
+    else:
+        records = numpy.zeros(0, dtype=dtype)
+    return Dump(block_type, version, fields, records)
+
+
+if __name__ == '__main__':
+    import sys
+    for name in sys.argv[1:]:
+        dump = load(name)
+        print('%s: %s, %d records' % (name, dump.block_type, len(dump)))
+        for field in dump.fields:
+            print('    %-32s %s x %d' % (field[0], field[1], field[3]))
@@ -0,0 +1,411 @@
+/*!
+ * \file gnss_sdr_python.cc
+ * \brief Python bindings of the correlators, the PCPS search and the code
+ *  generators, working in place on NumPy arrays.
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * The arrays are never copied: they must have the exact dtype (complex64,
+ * float32, int16 or int8) and be C-contiguous, otherwise a TypeError is
+ * raised. The correlators keep the arrays given to set_local_code_and_taps()
+ * and set_input_output_vectors(), as the C++ classes keep their pointers, so
+ * filling the input array again and calling the correlator costs no copy.
+ * Integer complex samples are interleaved I/Q int16 or int8 arrays. The
+ * computations release the GIL, so Monte Carlo runs can use Python threads.
+ *
+ *   import numpy as np, gnss_sdr_python as g
+ *   code = g.gps_l1_ca_code_gen_complex(1, 1023000)
+ *   corr = g.CpuMulticorrelator(4092, 3)
+ *   corr.set_local_code_and_taps(code, np.array([-0.5, 0, 0.5], np.float32))
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include "cpu_multicorrelator.h"
+#include "cpu_multicorrelator_16sc.h"
+#include "doppler_grid_store.h"
+#include "galileo_e1_signal_processing.h"
+#include "gps_sdr_signal_processing.h"
+#include "pcps_search_core.h"
+#include "GPS_L1_CA.h"
+#include "Galileo_E1.h"
+
+namespace py = pybind11;
+
+typedef py::array_t<std::complex<float>, py::array::c_style> complex_array;
+typedef py::array_t<float, py::array::c_style> float_array;
+typedef py::array_t<int16_t, py::array::c_style> int16_array;
+typedef py::array_t<int8_t, py::array::c_style> int8_array;
+
+namespace
+{
+template<class T>
+void check_size(const py::array_t<T, py::array::c_style>& array, size_t items, const char* name)
+{
+    if (static_cast<size_t>(array.size()) < items)
+        {
+            throw std::invalid_argument(std::string(name) + " has " + std::to_string(array.size())
+                    + " items, " + std::to_string(items) + " are needed");
+        }
+}
+
+
+unsigned int gps_l1_ca_samples_per_code(int fs)
+{
+    return static_cast<unsigned int>(static_cast<double>(fs) / (GPS_L1_CA_CODE_RATE_HZ / GPS_L1_CA_CODE_LENGTH_CHIPS));
+}
+
+
+unsigned int galileo_e1_samples_per_code(const std::string& signal, int fs, bool secondary)
+{
+    const unsigned int samples = static_cast<unsigned int>(static_cast<double>(fs) / (Galileo_E1_CODE_CHIP_RATE_HZ / Galileo_E1_B_CODE_LENGTH_CHIPS));
+    const bool e1c = signal.rfind("1C") != std::string::npos;
+    return (e1c && secondary) ? samples * static_cast<unsigned int>(Galileo_E1_C_SECONDARY_CODE_LENGTH) : samples;
+}
+
+
+void galileo_e1_code_into(std::complex<float>* dest, const std::string& signal, bool cboc,
+        unsigned int prn, int fs, unsigned int chip_shift, bool secondary)
+{
+    if (signal.size() != 2) throw std::invalid_argument("signal must be \"1B\" or \"1C\"");
+    char name[3] = {signal[0], signal[1], '\0'};
+    galileo_e1_code_gen_complex_sampled(dest, name, cboc, prn, fs, chip_shift, secondary);
+}
+
+
+// Copies the correlation of every Doppler bin into a (bins, fft_size) array
+struct Correlation_Copy
+{
+    std::complex<float>* out;
+    unsigned int fft_size;
+
+    void operator()(unsigned int doppler_index, const std::complex<float>* correlation)
+    {
+        if (out != nullptr)
+            {
+                std::memcpy(out + static_cast<size_t>(doppler_index) * fft_size, correlation, sizeof(std::complex<float>) * fft_size);
+            }
+    }
+};
+}
+
+
+/*!
+ * \brief cpu_multicorrelator over NumPy arrays
+ */
+class Python_Multicorrelator
+{
+public:
+    Python_Multicorrelator(int max_signal_length_samples, int n_correlators)
+    {
+        if (max_signal_length_samples <= 0 || n_correlators <= 0) throw std::invalid_argument("sizes must be positive");
+        d_max_length = max_signal_length_samples;
+        d_n_correlators = n_correlators;
+        d_correlator.init(d_max_length, d_n_correlators);
+    }
+
+    ~Python_Multicorrelator()
+    {
+        d_correlator.free();
+    }
+
+    void set_local_code_and_taps(complex_array code, float_array shifts_chips)
+    {
+        check_size(shifts_chips, d_n_correlators, "shifts_chips");
+        d_code = code;
+        d_shifts = shifts_chips;
+        d_correlator.set_local_code_and_taps(d_code.size(), d_code.data(), d_shifts.mutable_data());
+    }
+
+    void set_input_output_vectors(complex_array corr_out, complex_array sig_in)
+    {
+        check_size(corr_out, d_n_correlators, "corr_out");
+        d_out = corr_out;
+        d_in = sig_in;
+        d_correlator.set_input_output_vectors(d_out.mutable_data(), d_in.data());
+    }
+
+    bool carrier_wipeoff_multicorrelator_resampler(float rem_carrier_phase_in_rad, float phase_step_rad,
+            float rem_code_phase_chips, float code_phase_step_chips, int signal_length_samples)
+    {
+        if (d_code.size() == 0 || d_in.size() < signal_length_samples || signal_length_samples > d_max_length)
+            {
+                throw std::invalid_argument("set the code and the vectors first, with at least signal_length_samples inputs");
+            }
+        py::gil_scoped_release release;
+        return d_correlator.Carrier_wipeoff_multicorrelator_resampler(rem_carrier_phase_in_rad, phase_step_rad,
+                rem_code_phase_chips, code_phase_step_chips, signal_length_samples);
+    }
+
+private:
+    cpu_multicorrelator d_correlator;
+    int d_max_length;
+    int d_n_correlators;
+    // the correlator works on the memory of these arrays
+    complex_array d_code;
+    float_array d_shifts;
+    complex_array d_in;
+    complex_array d_out;
+};
+
+
+/*!
+ * \brief cpu_multicorrelator_16sc over interleaved int16 NumPy arrays. The
+ * outputs are int16 (saturating) or complex64 (accumulated in float).
+ */
+class Python_Multicorrelator_16sc
+{
+public:
+    Python_Multicorrelator_16sc(int max_signal_length_samples, int n_correlators)
+    {
+        if (max_signal_length_samples <= 0 || n_correlators <= 0) throw std::invalid_argument("sizes must be positive");
+        d_max_length = max_signal_length_samples;
+        d_n_correlators = n_correlators;
+        d_correlator.init(d_max_length, d_n_correlators);
+    }
+
+    ~Python_Multicorrelator_16sc()
+    {
+        d_correlator.free();
+    }
+
+    void set_local_code_and_taps(int16_array code, float_array shifts_chips)
+    {
+        check_size(shifts_chips, d_n_correlators, "shifts_chips");
+        d_code = code;
+        d_shifts = shifts_chips;
+        d_correlator.set_local_code_and_taps(d_code.size() / 2, reinterpret_cast<const lv_16sc_t*>(d_code.data()), d_shifts.mutable_data());
+    }
+
+    void set_input_output_vectors_16sc(int16_array corr_out, int16_array sig_in)
+    {
+        check_size(corr_out, 2 * d_n_correlators, "corr_out");
+        d_out_16sc = corr_out;
+        d_out_32fc = complex_array();
+        d_in = sig_in;
+        d_correlator.set_input_output_vectors(reinterpret_cast<lv_16sc_t*>(d_out_16sc.mutable_data()), reinterpret_cast<const lv_16sc_t*>(d_in.data()));
+    }
+
+    void set_input_output_vectors_32fc(complex_array corr_out, int16_array sig_in)
+    {
+        check_size(corr_out, d_n_correlators, "corr_out");
+        d_out_32fc = corr_out;
+        d_out_16sc = int16_array();
+        d_in = sig_in;
+        d_correlator.set_input_output_vectors(d_out_32fc.mutable_data(), reinterpret_cast<const lv_16sc_t*>(d_in.data()));
+    }
+
+    bool carrier_wipeoff_multicorrelator_resampler(float rem_carrier_phase_in_rad, float phase_step_rad,
+            float rem_code_phase_chips, float code_phase_step_chips, int signal_length_samples)
+    {
+        if (d_code.size() == 0 || d_in.size() < 2 * signal_length_samples || signal_length_samples > d_max_length)
+            {
+                throw std::invalid_argument("set the code and the vectors first, with at least signal_length_samples inputs");
+            }
+        py::gil_scoped_release release;
+        return d_correlator.Carrier_wipeoff_multicorrelator_resampler(rem_carrier_phase_in_rad, phase_step_rad,
+                rem_code_phase_chips, code_phase_step_chips, signal_length_samples);
+    }
+
+private:
+    cpu_multicorrelator_16sc d_correlator;
+    int d_max_length;
+    int d_n_correlators;
+    int16_array d_code;
+    float_array d_shifts;
+    int16_array d_in;
+    int16_array d_out_16sc;
+    complex_array d_out_32fc;
+};
+
+
+/*!
+ * \brief Pcps_Search_Core with the detector chosen by name ("cfar" or
+ * "peak_to_floor"). The correlations of every bin can be written to a
+ * (bins, fft_size) complex64 array.
+ */
+class Python_Pcps_Search
+{
+public:
+    Python_Pcps_Search(unsigned int samples_per_code, unsigned int fft_size, bool bit_transition)
+        : d_core(samples_per_code, fft_size, bit_transition)
+    {
+        d_samples_per_code = samples_per_code;
+    }
+
+    void set_local_code(complex_array code)
+    {
+        check_size(code, d_samples_per_code, "code");
+        d_core.set_local_code(code.data());
+    }
+
+    Pcps_Search_Result search_32fc(complex_array in, const Doppler_Grid& grid, const std::string& detector, py::object correlations)
+    {
+        check_size(in, d_core.fft_size(), "in");
+        return search(in.data(), grid, detector, correlations);
+    }
+
+    Pcps_Search_Result search_16sc(int16_array in, const Doppler_Grid& grid, const std::string& detector, py::object correlations)
+    {
+        check_size(in, 2 * d_core.fft_size(), "in");
+        return search(reinterpret_cast<const std::complex<int16_t>*>(in.data()), grid, detector, correlations);
+    }
+
+    Pcps_Search_Result search_8sc(int8_array in, const Doppler_Grid& grid, const std::string& detector, py::object correlations)
+    {
+        check_size(in, 2 * d_core.fft_size(), "in");
+        return search(reinterpret_cast<const std::complex<int8_t>*>(in.data()), grid, detector, correlations);
+    }
+
+    unsigned int fft_size() const
+    {
+        return d_core.fft_size();
+    }
+
+    unsigned int window() const
+    {
+        return d_core.window();
+    }
+
+private:
+    template<class Sample>
+    Pcps_Search_Result search(const Sample* in, const Doppler_Grid& grid, const std::string& detector, py::object correlations)
+    {
+        if (grid.length() != d_core.fft_size()) throw std::invalid_argument("the grid must have fft_size samples per bin");
+        if (detector != "cfar" && detector != "peak_to_floor") throw std::invalid_argument("detector must be \"cfar\" or \"peak_to_floor\"");
+        Correlation_Copy observer = {nullptr, d_core.fft_size()};
+        complex_array out;
+        if (!correlations.is_none())
+            {
+                // a converted copy would not be seen by the caller
+                if (!py::isinstance<complex_array>(correlations)) throw py::type_error("correlations must be a C-contiguous complex64 array");
+                out = py::reinterpret_borrow<complex_array>(correlations);
+                check_size(out, static_cast<size_t>(grid.num_bins()) * d_core.fft_size(), "correlations");
+                observer.out = out.mutable_data();
+            }
+        py::gil_scoped_release release;
+        if (detector == "cfar")
+            {
+                return d_core.search<Pcps_Cfar_Detector>(in, grid, observer);
+            }
+        return d_core.search<Pcps_Peak_To_Floor_Detector>(in, grid, observer);
+    }
+
+    Pcps_Search_Core d_core;
+    unsigned int d_samples_per_code;
+};
+
+
+PYBIND11_MODULE(gnss_sdr_python, m)
+{
+    m.doc() = "GNSS-SDR correlators, PCPS search and code generators on NumPy arrays";
+
+    m.def("gps_l1_ca_code_gen_complex", [](unsigned int prn, int fs, unsigned int chip_shift) {
+                complex_array code(gps_l1_ca_samples_per_code(fs));
+                gps_l1_ca_code_gen_complex_sampled(code.mutable_data(), prn, fs, chip_shift);
+                return code;
+            },
+            "One period of the GPS L1 C/A code of prn sampled at fs",
+            py::arg("prn"), py::arg("fs"), py::arg("chip_shift") = 0);
+    m.def("gps_l1_ca_code_gen_complex_sampled", [](complex_array dest, unsigned int prn, int fs, unsigned int chip_shift) {
+                check_size(dest, gps_l1_ca_samples_per_code(fs), "dest");
+                gps_l1_ca_code_gen_complex_sampled(dest.mutable_data(), prn, fs, chip_shift);
+            },
+            "Writes one period of the GPS L1 C/A code into dest",
+            py::arg("dest").noconvert(), py::arg("prn"), py::arg("fs"), py::arg("chip_shift") = 0);
+    m.def("galileo_e1_code_gen_complex", [](const std::string& signal, bool cboc, unsigned int prn, int fs,
+                  unsigned int chip_shift, bool secondary) {
+                complex_array code(galileo_e1_samples_per_code(signal, fs, secondary));
+                galileo_e1_code_into(code.mutable_data(), signal, cboc, prn, fs, chip_shift, secondary);
+                return code;
+            },
+            "One period of the Galileo E1 code (signal \"1B\" or \"1C\") of prn sampled at fs",
+            py::arg("signal"), py::arg("cboc"), py::arg("prn"), py::arg("fs"),
+            py::arg("chip_shift") = 0, py::arg("secondary") = false);
+    m.def("galileo_e1_code_gen_complex_sampled", [](complex_array dest, const std::string& signal, bool cboc,
+                  unsigned int prn, int fs, unsigned int chip_shift, bool secondary) {
+                check_size(dest, galileo_e1_samples_per_code(signal, fs, secondary), "dest");
+                galileo_e1_code_into(dest.mutable_data(), signal, cboc, prn, fs, chip_shift, secondary);
+            },
+            "Writes one period of the Galileo E1 code into dest",
+            py::arg("dest").noconvert(), py::arg("signal"), py::arg("cboc"), py::arg("prn"), py::arg("fs"),
+            py::arg("chip_shift") = 0, py::arg("secondary") = false);
+
+    py::class_<Python_Multicorrelator>(m, "CpuMulticorrelator")
+            .def(py::init<int, int>(), py::arg("max_signal_length_samples"), py::arg("n_correlators"))
+            .def("set_local_code_and_taps", &Python_Multicorrelator::set_local_code_and_taps,
+                    py::arg("code").noconvert(), py::arg("shifts_chips").noconvert())
+            .def("set_input_output_vectors", &Python_Multicorrelator::set_input_output_vectors,
+                    py::arg("corr_out").noconvert(), py::arg("sig_in").noconvert())
+            .def("carrier_wipeoff_multicorrelator_resampler", &Python_Multicorrelator::carrier_wipeoff_multicorrelator_resampler,
+                    py::arg("rem_carrier_phase_in_rad"), py::arg("phase_step_rad"), py::arg("rem_code_phase_chips"),
+                    py::arg("code_phase_step_chips"), py::arg("signal_length_samples"));
+
+    py::class_<Python_Multicorrelator_16sc>(m, "CpuMulticorrelator16sc")
+            .def(py::init<int, int>(), py::arg("max_signal_length_samples"), py::arg("n_correlators"))
+            .def("set_local_code_and_taps", &Python_Multicorrelator_16sc::set_local_code_and_taps,
+                    py::arg("code").noconvert(), py::arg("shifts_chips").noconvert())
+            .def("set_input_output_vectors", &Python_Multicorrelator_16sc::set_input_output_vectors_32fc,
+                    py::arg("corr_out").noconvert(), py::arg("sig_in").noconvert())
+            .def("set_input_output_vectors", &Python_Multicorrelator_16sc::set_input_output_vectors_16sc,
+                    py::arg("corr_out").noconvert(), py::arg("sig_in").noconvert())
+            .def("carrier_wipeoff_multicorrelator_resampler", &Python_Multicorrelator_16sc::carrier_wipeoff_multicorrelator_resampler,
+                    py::arg("rem_carrier_phase_in_rad"), py::arg("phase_step_rad"), py::arg("rem_code_phase_chips"),
+                    py::arg("code_phase_step_chips"), py::arg("signal_length_samples"));
+
+    py::class_<Doppler_Grid, std::shared_ptr<Doppler_Grid> >(m, "DopplerGrid")
+            .def(py::init<long, long, unsigned int, unsigned int, unsigned int, unsigned int>(),
+                    py::arg("fs_in"), py::arg("freq"), py::arg("length"), py::arg("doppler_max"),
+                    py::arg("doppler_step"), py::arg("num_bins"))
+            .def("doppler", &Doppler_Grid::doppler)
+            .def_property_readonly("num_bins", &Doppler_Grid::num_bins)
+            .def_property_readonly("length", &Doppler_Grid::length);
+
+    py::class_<Pcps_Search_Result>(m, "PcpsSearchResult")
+            .def_readonly("doppler_index", &Pcps_Search_Result::doppler_index)
+            .def_readonly("delay_samples", &Pcps_Search_Result::delay_samples)
+            .def_readonly("magnitude", &Pcps_Search_Result::magnitude)
+            .def_readonly("noise_power", &Pcps_Search_Result::noise_power)
+            .def_readonly("test_statistic", &Pcps_Search_Result::test_statistic);
+
+    py::class_<Python_Pcps_Search>(m, "PcpsSearchCore")
+            .def(py::init<unsigned int, unsigned int, bool>(), py::arg("samples_per_code"), py::arg("fft_size"), py::arg("bit_transition") = false)
+            .def("set_local_code", &Python_Pcps_Search::set_local_code, py::arg("code").noconvert())
+            .def("search", &Python_Pcps_Search::search_32fc, py::arg("in").noconvert(), py::arg("grid"),
+                    py::arg("detector") = "cfar", py::arg("correlations") = py::none())
+            .def("search", &Python_Pcps_Search::search_16sc, py::arg("in").noconvert(), py::arg("grid"),
+                    py::arg("detector") = "cfar", py::arg("correlations") = py::none())
+            .def("search", &Python_Pcps_Search::search_8sc, py::arg("in").noconvert(), py::arg("grid"),
+                    py::arg("detector") = "cfar", py::arg("correlations") = py::none())
+            .def_property_readonly("fft_size", &Python_Pcps_Search::fft_size)
+            .def_property_readonly("window", &Python_Pcps_Search::window);
+}
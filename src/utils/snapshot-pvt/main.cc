@@ -0,0 +1,179 @@
+/*!
+ * \file main.cc
+ * \brief Position and time from a snapshot of a few tens of milliseconds
+ * \author GNSS-SDR developers, 2016. gnss-sdr-developers(at)lists.sourceforge.net
+ *
+ * Searches all the GPS L1 C/A satellites in a short capture, takes the
+ * ephemeris from a SUPL server, an XML file or the receiver state (see
+ * FrontEndCal), and solves the position and the time of the capture from
+ * the code phases alone (Coarse_Time_Navigation). Neither the time of week
+ * nor the ephemeris are decoded from the signal, so that a capture of one
+ * code period per dwell is enough.
+ *
+ * -------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2016  (see AUTHORS file for a list of contributors)
+ *
+ * GNSS-SDR is a software defined Global Navigation
+ *          Satellite Systems receiver
+ *
+ * This file is part of GNSS-SDR.
+ *
+ * GNSS-SDR is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GNSS-SDR is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GNSS-SDR. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <complex>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include "coarse_time_navigation.h"
+#include "concurrent_map.h"
+#include "file_configuration.h"
+#include "gps_acq_assist.h"
+#include "gps_almanac.h"
+#include "gps_ephemeris.h"
+#include "gps_iono.h"
+#include "gps_utc_model.h"
+#include "front_end_cal.h"
+#include "front_end_cal_search.h"
+
+using google::LogMessage;
+
+DEFINE_string(config_file, std::string(GNSSSDR_INSTALL_DIR) + "/share/gnss-sdr/conf/snapshot-pvt.conf",
+        "Path to the file containing the configuration parameters");
+DEFINE_string(capture_file, "./snapshot.dat", "Snapshot of gr_complex samples at GNSS-SDR.internal_fs_hz");
+DEFINE_double(tow_s, -1.0, "Approximate GPS time of week of the first sample, if not that of the assistance or the system clock [s]");
+
+concurrent_map<Gps_Ephemeris> global_gps_ephemeris_map;
+concurrent_map<Gps_Iono> global_gps_iono_map;
+concurrent_map<Gps_Utc_Model> global_gps_utc_model_map;
+concurrent_map<Gps_Almanac> global_gps_almanac_map;
+concurrent_map<Gps_Acq_Assist> global_gps_acq_assist_map;
+
+
+static void geodetic_to_ecef(double lat_deg, double lon_deg, double height_m, double * pos)
+{
+    const double a = 6378137.0;
+    const double e2 = 6.69437999014e-3;
+    const double lat = lat_deg * GPS_PI / 180.0;
+    const double lon = lon_deg * GPS_PI / 180.0;
+    const double n = a / std::sqrt(1.0 - e2 * std::sin(lat) * std::sin(lat));
+    pos[0] = (n + height_m) * std::cos(lat) * std::cos(lon);
+    pos[1] = (n + height_m) * std::cos(lat) * std::sin(lon);
+    pos[2] = (n * (1.0 - e2) + height_m) * std::sin(lat);
+}
+
+
+int main(int argc, char** argv)
+{
+    google::SetUsageMessage("Position and time of a snapshot of GPS L1 C/A signal, with assisted ephemeris");
+    google::ParseCommandLineFlags(&argc, &argv, true);
+    google::InitGoogleLogging(argv[0]);
+
+    std::shared_ptr<ConfigurationInterface> configuration = std::make_shared<FileConfiguration>(FLAGS_config_file);
+    FrontEndCal assistance;
+    assistance.set_configuration(configuration);
+    if (!assistance.get_ephemeris() || global_gps_ephemeris_map.size() == 0)
+        {
+            std::cout << "No GPS ephemeris available" << std::endl;
+            google::ShutDownCommandLineFlags();
+            return 1;
+        }
+
+    // A priori time and position
+    double tow_s = FLAGS_tow_s;
+    if (tow_s < 0.0)
+        {
+            int week;
+            if (assistance.offline())
+                {
+                    assistance.gps_time_from_clock(week, tow_s);
+                }
+            else
+                {
+                    tow_s = global_gps_ephemeris_map.get_map_copy().begin()->second.d_TOW;
+                }
+        }
+    double lat_deg = configuration->property("GNSS-SDR.init_latitude_deg", 41.0);
+    double lon_deg = configuration->property("GNSS-SDR.init_longitude_deg", 2.0);
+    double height_m = configuration->property("GNSS-SDR.init_altitude_m", 100.0);
+    assistance.receiver_position(lat_deg, lon_deg, height_m);
+    double approx_pos_m[3];
+    geodetic_to_ecef(lat_deg, lon_deg, height_m, approx_pos_m);
+
+    // Search the satellites with ephemeris over the whole snapshot
+    const long fs_in = configuration->property("GNSS-SDR.internal_fs_hz", 2048000);
+    std::vector<std::complex<float>> capture = FrontEndCalSearch::read_capture(FLAGS_capture_file);
+    const unsigned int samples_per_code = static_cast<unsigned int>(std::round(fs_in * GPS_L1_CA_CODE_PERIOD));
+    if (capture.size() < samples_per_code)
+        {
+            std::cout << "Not enough samples in " << FLAGS_capture_file << std::endl;
+            google::ShutDownCommandLineFlags();
+            return 1;
+        }
+    FrontEndCalSearch search(fs_in,
+            configuration->property("Acquisition.if", 0.0),
+            configuration->property("Acquisition.doppler_min", -configuration->property("Acquisition.doppler_max", 5000)),
+            configuration->property("Acquisition.doppler_max", 5000),
+            configuration->property("Acquisition.doppler_step", 250),
+            configuration->property("Acquisition.threshold", 0.0),
+            configuration->property("Acquisition.max_dwells", static_cast<unsigned int>(capture.size() / samples_per_code)));
+    std::map<int, Gps_Ephemeris> ephemeris = global_gps_ephemeris_map.get_map_copy();
+    std::vector<unsigned int> prns;
+    for (std::map<int, Gps_Ephemeris>::const_iterator it = ephemeris.begin(); it != ephemeris.end(); ++it)
+        {
+            prns.push_back(it->first);
+        }
+    std::vector<FrontEndCalDetection> detections = search.search(capture, prns, configuration->property("SnapshotPvt.threads", 0));
+
+    Coarse_Time_Navigation navigation;
+    for (std::vector<FrontEndCalDetection>::const_iterator it = detections.begin(); it != detections.end(); ++it)
+        {
+            if (it->detected)
+                {
+                    LOG(INFO) << "PRN " << it->PRN << " detected, code phase " << it->code_phase_samples
+                              << " samples, Doppler " << it->doppler_hz << " Hz";
+                    navigation.add_observation(ephemeris[it->PRN], it->code_phase_samples / static_cast<double>(fs_in));
+                }
+        }
+    std::cout << "satellites=" << navigation.num_observations() << std::endl;
+    if (!navigation.solve(approx_pos_m, tow_s))
+        {
+            std::cout << "No position: at least 4 satellites with consistent code phases are needed" << std::endl;
+            google::ShutDownCommandLineFlags();
+            return 1;
+        }
+
+    std::cout << std::setprecision(10)
+              << "latitude_deg=" << navigation.d_latitude_d << std::endl
+              << "longitude_deg=" << navigation.d_longitude_d << std::endl
+              << std::setprecision(6)
+              << "height_m=" << navigation.d_height_m << std::endl
+              << std::setprecision(12)
+              << "tow_s=" << navigation.tow_s() << std::endl
+              << std::setprecision(6)
+              << "time_offset_s=" << navigation.time_offset_s() << std::endl
+              << "residual_rms_m=" << navigation.residual_rms_m() << std::endl;
+
+    google::ShutDownCommandLineFlags();
+    return 0;
+}